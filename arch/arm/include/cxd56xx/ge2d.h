@@ -42,6 +42,13 @@
 
 #ifndef __ASSEMBLY__
 
+/* Completion callback of an asynchronous descriptor list.  It is called from
+ * the GE2D interrupt handler with zero on success or -EIO if the engine
+ * reported a bus error, and must not submit another list itself.
+ */
+
+typedef void (*cxd56_ge2d_callback_t)(FAR void *arg, int result);
+
 #undef EXTERN
 #if defined(__cplusplus)
 #define EXTERN extern "C"
@@ -58,6 +65,24 @@ extern "C"
 int cxd56_ge2dinitialize(FAR const char *devname);
 void cxd56_ge2duninitialize(FAR const char *devname);
 
+/****************************************************************************
+ * Name: cxd56_ge2d_submit
+ *
+ * Description:
+ *   Execute a descriptor list on the graphics engine.  The list must be 16
+ *   byte aligned and terminated by a halt descriptor.  If callback is NULL
+ *   this waits for completion, otherwise it returns as soon as the engine
+ *   has been started and callback is invoked when the list is finished.
+ *   The list must not be modified until then.
+ *
+ * Returned Value:
+ *   Zero (OK) on success; a negated errno value on failure.
+ *
+ ****************************************************************************/
+
+int cxd56_ge2d_submit(FAR const void *cmd, cxd56_ge2d_callback_t callback,
+                      FAR void *arg);
+
 #undef EXTERN
 #if defined(__cplusplus)
 }
@@ -560,10 +560,30 @@ extern "C"
 
 #define CXD56_GNSS_IOCTL_GET_1PPS_OUTPUT 53
 
+/* Start recording into the record ring (CONFIG_CXD56_GNSS_RING)
+ * The ring is allocated on first use and stays mapped until the last
+ * close.  Map it with mmap() or FIOC_MMAP to get its
+ * struct #cxd56_gnss_ring_s.
+ *
+ * param[in] arg
+ * Address pointing to struct #cxd56_gnss_ring_param_s object.
+ */
+
+#define CXD56_GNSS_IOCTL_START_RING 54
+
+/* Stop recording into the record ring
+ * Records already in the ring remain readable.
+ *
+ * param[in] arg
+ * Not used
+ */
+
+#define CXD56_GNSS_IOCTL_STOP_RING 55
+
 /* check macros for GNSS commands */
 
 #define CXD56_GNSS_IOCTL_INVAL 0
-#define CXD56_GNSS_IOCTL_MAX   54
+#define CXD56_GNSS_IOCTL_MAX   56
 
 /* Same value to GD Start mode CXD56_GNSS_STMOD_XXXX for fw_gd_start */
 
@@ -684,6 +704,17 @@ extern "C"
 
 #define CXD56_GNSS_SIG_SARRLM       16
 
+/* Record types of the record ring */
+
+#define CXD56_GNSS_RING_POSITION    (1 << 0) /* cxd56_gnss_positiondata_s */
+#define CXD56_GNSS_RING_RAW         (1 << 1) /* cxd56_supl_mesurementdata_s */
+
+/* Address of record n, n being any running record number */
+
+#define CXD56_GNSS_RING_RECORD(ring, n) \
+  ((FAR struct cxd56_gnss_ringrec_s *)((FAR uint8_t *)((ring) + 1) + \
+   ((n) % (ring)->nrecords) * (ring)->recsize))
+
 /****************************************************************************
  * Public Types
  ****************************************************************************/
@@ -708,6 +739,44 @@ struct cxd56_gnss_ope_mode_param_s
   uint32_t cycle;
 };
 
+/* Parameters of CXD56_GNSS_IOCTL_START_RING */
+
+struct cxd56_gnss_ring_param_s
+{
+  uint32_t types;     /* CXD56_GNSS_RING_* bits of the records to keep */
+  uint32_t watermark; /* Pending records before poll reports POLLIN */
+};
+
+/* Record ring, followed by nrecords records of recsize bytes each.
+ *
+ * The driver writes record head and then advances head; the application
+ * reads record tail and then advances tail.  Both are running counts.
+ * A record that arrives while the ring is full is dropped and counted,
+ * so records buffered while the application sleeps are not overwritten.
+ */
+
+struct cxd56_gnss_ring_s
+{
+  volatile uint32_t head;    /* Records written, advanced by the driver */
+  volatile uint32_t tail;    /* Records read, advanced by the application */
+  uint32_t          nrecords;
+  uint32_t          recsize; /* Bytes from one record to the next */
+  volatile uint32_t dropped; /* Records lost to a full ring */
+  uint32_t          reserved[3];
+};
+
+/* One record of the record ring */
+
+struct cxd56_gnss_ringrec_s
+{
+  uint32_t seq;       /* Running record number */
+  uint32_t timestamp; /* System time of the notification [ms] */
+  uint16_t type;      /* One of CXD56_GNSS_RING_* */
+  uint16_t len;       /* Length of data[] */
+  uint32_t reserved;
+  uint64_t data[1];   /* The record as it would be read() */
+};
+
 /* Satellite almanac, ephemeris data */
 
 struct cxd56_gnss_orbital_param_s
@@ -196,6 +196,25 @@
 
 #define SCUIOC_DELFIFODATA _SCUIOC(0x0013)
 
+/*
+ * Attach (or detach) a sample ring to the FIFO. Once the sequencer is
+ * started, the FIFO is drained into the ring on every FIFO watermark.
+ *
+ * param: Pointer of struct scufifo_ringcfg_s
+ * return: ioctl return value provides success/failure indication
+ */
+
+#define SCUIOC_SETRING     _SCUIOC(0x0014)
+
+/*
+ * Get the sample ring attached by SCUIOC_SETRING
+ *
+ * param: Pointer to FAR struct scufifo_ring_s * receiving the ring address
+ * return: ioctl return value provides success/failure indication
+ */
+
+#define SCUIOC_GETRING     _SCUIOC(0x0015)
+
 #define SCU_BUS_SPI     1         /*< SPI bus */
 #define SCU_BUS_I2C0    2         /*< I2C0 bus */
 #define SCU_BUS_I2C1    3         /*< I2C1 bus */
@@ -405,6 +424,33 @@ struct scufifo_wm_s
   uint16_t               watermark;
 };
 
+/* Sample ring configuration (SCUIOC_SETRING) */
+
+struct scufifo_ringcfg_s
+{
+  uint32_t nsamples;            /*< Ring capacity in samples, 0 to detach */
+  uint32_t watermark;           /*< Samples in ring to notify, 0 = no notify */
+  int      signo;               /*< Signal number sent at watermark */
+};
+
+/*
+ * Sample ring shared with the application (SCUIOC_GETRING / mmap()).
+ * The driver only advances head, the application only advances tail.
+ * Both are sample indexes in 0 - (nsamples - 1), and one slot is always
+ * kept free, so the ring is empty when head == tail.
+ */
+
+struct scufifo_ring_s
+{
+  volatile uint32_t head;       /*< Producer index (driver) */
+  volatile uint32_t tail;       /*< Consumer index (application) */
+  uint32_t          nsamples;   /*< Number of sample slots */
+  uint16_t          sample;     /*< Bytes per sample */
+  uint16_t          reserved;
+  volatile uint32_t overrun;    /*< Samples dropped because ring was full */
+  uint8_t           data[];     /*< Sample slots */
+};
+
 struct seq_s;     /* The sequencer object */
 
 /*
@@ -43,6 +43,7 @@
 #include <nuttx/config.h>
 #include <assert.h>
 #include <nuttx/arch.h>
+#include <nuttx/irq.h>
 #include <nuttx/tls.h>
 
 #ifdef CONFIG_TLS
@@ -86,6 +87,10 @@ static inline uint32_t up_getsp(void)
  *
  *   The stack memory is fully accessible to user mode threads.
  *
+ *   With CONFIG_TLS_CURRENT, the structure is instead found through the
+ *   per-CPU pointer maintained by the scheduler and stacks need not be
+ *   aligned.
+ *
  * Input Parameters:
  *   None
  *
@@ -99,8 +104,26 @@ static inline uint32_t up_getsp(void)
 
 static inline FAR struct tls_info_s *up_tls_info(void)
 {
+#if defined(CONFIG_TLS_CURRENT) && defined(CONFIG_SMP)
+  FAR struct tls_info_s *info;
+  irqstate_t flags;
+#endif
+
   DEBUGASSERT(!up_interrupt_context());
+#if defined(CONFIG_TLS_CURRENT) && defined(CONFIG_SMP)
+  /* Keep the thread from migrating between reading the CPU index and
+   * reading that CPU's pointer.
+   */
+
+  flags = up_irq_save();
+  info  = g_tls_current[up_cpu_index()];
+  up_irq_restore(flags);
+  return info;
+#elif defined(CONFIG_TLS_CURRENT)
+  return g_tls_current[0];
+#else
   return TLS_INFO((uintptr_t)up_getsp());
+#endif
 }
 
 #endif /* CONFIG_TLS */
@@ -0,0 +1,123 @@
+/****************************************************************************
+ * arch/arm/src/armv7-m/dmaheap.h
+ *
+ *   Copyright (C) 2020 Gregory Nutt. All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in
+ *    the documentation and/or other materials provided with the
+ *    distribution.
+ * 3. Neither the name NuttX nor the names of its contributors may be
+ *    used to endorse or promote products derived from this software
+ *    without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+ * FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE
+ * COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+ * INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,
+ * BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS
+ * OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED
+ * AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ * LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN
+ * ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ *
+ ****************************************************************************/
+
+#ifndef __ARCH_ARM_SRC_ARMV7M_DMAHEAP_H
+#define __ARCH_ARM_SRC_ARMV7M_DMAHEAP_H
+
+/****************************************************************************
+ * Included Files
+ ****************************************************************************/
+
+#include <nuttx/config.h>
+
+#include <sys/types.h>
+#include <stdint.h>
+#include <stdbool.h>
+
+#ifdef CONFIG_ARMV7M_DMAHEAP
+
+/****************************************************************************
+ * Public Function Prototypes
+ ****************************************************************************/
+
+#ifndef __ASSEMBLY__
+
+#ifdef __cplusplus
+#define EXTERN extern "C"
+extern "C"
+{
+#else
+#define EXTERN extern
+#endif
+
+/****************************************************************************
+ * Name: up_dma_initialize
+ *
+ * Description:
+ *   Set up the DMA heap.  With CONFIG_ARMV7M_DMAHEAP_NOCACHE the heap is
+ *   made non-cacheable with an MPU region, so this must be called once
+ *   during chip or board initialization, after the MPU has been set up.
+ *
+ * Returned Value:
+ *   Zero on success; a negated errno value on failure.
+ *
+ ****************************************************************************/
+
+int up_dma_initialize(void);
+
+/****************************************************************************
+ * Name: up_dma_alloc
+ *
+ * Description:
+ *   Allocate a DMA buffer.  The buffer starts on a cache line boundary and
+ *   is padded to whole cache lines, so cache maintenance on it never
+ *   touches other data.  In the non-cacheable heap it needs no cache
+ *   maintenance at all.
+ *
+ ****************************************************************************/
+
+FAR void *up_dma_alloc(size_t size);
+
+/****************************************************************************
+ * Name: up_dma_free
+ *
+ * Description:
+ *   Free a buffer allocated by up_dma_alloc().  'size' must be the size
+ *   that was allocated.
+ *
+ ****************************************************************************/
+
+void up_dma_free(FAR void *mem, size_t size);
+
+/****************************************************************************
+ * Name: up_dma_uncached
+ *
+ * Description:
+ *   Return true if the address range lies within the non-cacheable DMA
+ *   heap.  The D-Cache maintenance functions skip such ranges.
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_ARMV7M_DMAHEAP_NOCACHE
+bool up_dma_uncached(uintptr_t start, uintptr_t end);
+#endif
+
+#undef EXTERN
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* __ASSEMBLY__ */
+#endif /* CONFIG_ARMV7M_DMAHEAP */
+#endif /* __ARCH_ARM_SRC_ARMV7M_DMAHEAP_H */
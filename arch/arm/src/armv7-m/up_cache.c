@@ -49,6 +49,7 @@
 #include "up_arch.h"
 #include "barriers.h"
 #include "nvic.h"
+#include "dmaheap.h"
 
 /****************************************************************************
  * Pre-processor Definitions
@@ -98,6 +99,30 @@ static inline uint32_t arm_clz(unsigned int value)
   return ret;
 }
 
+/****************************************************************************
+ * Name: arm_dcache_large
+ *
+ * Description:
+ *   Return true if maintaining the range line by line would take more
+ *   operations than maintaining the whole D-Cache by set and way.
+ *
+ * Input Parameters:
+ *   ccsidr - The value of the CCSIDR register
+ *   start  - virtual start address of region
+ *   end    - virtual end address of region + 1
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_ARMV7M_DCACHE_LARGE_RANGES
+static inline bool arm_dcache_large(uint32_t ccsidr, uintptr_t start,
+                                    uintptr_t end)
+{
+  size_t size = (CCSIDR_SETS(ccsidr) + 1) * (CCSIDR_WAYS(ccsidr) + 1);
+
+  return end - start >= (size << (CCSIDR_LSSHIFT(ccsidr) + 4));
+}
+#endif
+
 /****************************************************************************
  * Public Functions
  ****************************************************************************/
@@ -389,11 +414,32 @@ void up_invalidate_dcache(uintptr_t start, uintptr_t end)
   uint32_t sshift;
   uint32_t ssize;
 
+#ifdef CONFIG_ARMV7M_DMAHEAP_NOCACHE
+  if (up_dma_uncached(start, end))
+    {
+      return;
+    }
+#endif
+
   /* Get the characteristics of the D-Cache */
 
   ccsidr = getreg32(NVIC_CCSIDR);
   sshift = CCSIDR_LSSHIFT(ccsidr) + 4;   /* log2(cache-line-size-in-bytes) */
 
+#if defined(CONFIG_ARMV7M_DCACHE_LARGE_RANGES) && \
+    defined(CONFIG_ARMV7M_DCACHE_WRITETHROUGH)
+  /* A write-through cache holds no dirty lines, so invalidating all of it
+   * loses nothing.  A write-back cache may hold dirty lines of other data
+   * and must always be invalidated line by line.
+   */
+
+  if (arm_dcache_large(ccsidr, start, end))
+    {
+      up_invalidate_dcache_all();
+      return;
+    }
+#endif
+
   /* Invalidate the D-Cache containing this range of addresses */
 
   ssize  = (1 << sshift);
@@ -527,11 +573,26 @@ void up_clean_dcache(uintptr_t start, uintptr_t end)
   uint32_t sshift;
   uint32_t ssize;
 
+#ifdef CONFIG_ARMV7M_DMAHEAP_NOCACHE
+  if (up_dma_uncached(start, end))
+    {
+      return;
+    }
+#endif
+
   /* Get the characteristics of the D-Cache */
 
   ccsidr = getreg32(NVIC_CCSIDR);
   sshift = CCSIDR_LSSHIFT(ccsidr) + 4;   /* log2(cache-line-size-in-bytes) */
 
+#ifdef CONFIG_ARMV7M_DCACHE_LARGE_RANGES
+  if (arm_dcache_large(ccsidr, start, end))
+    {
+      up_clean_dcache_all();
+      return;
+    }
+#endif
+
   /* Clean the D-Cache over the range of addresses */
 
   ssize  = (1 << sshift);
@@ -670,11 +731,26 @@ void up_flush_dcache(uintptr_t start, uintptr_t end)
   uint32_t sshift;
   uint32_t ssize;
 
+#ifdef CONFIG_ARMV7M_DMAHEAP_NOCACHE
+  if (up_dma_uncached(start, end))
+    {
+      return;
+    }
+#endif
+
   /* Get the characteristics of the D-Cache */
 
   ccsidr = getreg32(NVIC_CCSIDR);
   sshift = CCSIDR_LSSHIFT(ccsidr) + 4;   /* log2(cache-line-size-in-bytes) */
 
+#ifdef CONFIG_ARMV7M_DCACHE_LARGE_RANGES
+  if (arm_dcache_large(ccsidr, start, end))
+    {
+      up_flush_dcache_all();
+      return;
+    }
+#endif
+
   /* Clean and invalidate the D-Cache over the range of addresses */
 
   ssize  = (1 << sshift);
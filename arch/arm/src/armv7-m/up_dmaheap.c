@@ -0,0 +1,220 @@
+/****************************************************************************
+ * arch/arm/src/armv7-m/up_dmaheap.c
+ *
+ *   Copyright (C) 2020 Gregory Nutt. All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in
+ *    the documentation and/or other materials provided with the
+ *    distribution.
+ * 3. Neither the name NuttX nor the names of its contributors may be
+ *    used to endorse or promote products derived from this software
+ *    without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+ * FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE
+ * COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+ * INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,
+ * BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS
+ * OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED
+ * AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ * LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN
+ * ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ *
+ ****************************************************************************/
+
+/****************************************************************************
+ * Included Files
+ ****************************************************************************/
+
+#include <nuttx/config.h>
+
+#include <stdint.h>
+#include <stdbool.h>
+#include <errno.h>
+#include <debug.h>
+
+#include <nuttx/cache.h>
+#include <nuttx/mm/gran.h>
+
+#include "up_arch.h"
+#include "barriers.h"
+#include "dmaheap.h"
+
+#ifdef CONFIG_ARMV7M_DMAHEAP_NOCACHE
+#  include "mpu.h"
+#endif
+
+#ifdef CONFIG_ARMV7M_DMAHEAP
+
+/****************************************************************************
+ * Pre-processor Definitions
+ ****************************************************************************/
+
+/* Allocations are made in units of one 32-byte Cortex-M7 cache line */
+
+#define DMAHEAP_LOG2LINE 5
+
+/* An MPU region must be a power of two in size and aligned to its size */
+
+#if (CONFIG_ARMV7M_DMAHEAP_SIZE & (CONFIG_ARMV7M_DMAHEAP_SIZE - 1)) != 0 || \
+    CONFIG_ARMV7M_DMAHEAP_SIZE < 32
+#  error CONFIG_ARMV7M_DMAHEAP_SIZE must be a power of two
+#endif
+
+/****************************************************************************
+ * Private Data
+ ****************************************************************************/
+
+static uint8_t g_dmaheap[CONFIG_ARMV7M_DMAHEAP_SIZE]
+  aligned_data(CONFIG_ARMV7M_DMAHEAP_SIZE);
+
+static GRAN_HANDLE g_dmagran;
+
+#ifdef CONFIG_ARMV7M_DMAHEAP_NOCACHE
+static bool g_dmauncached;
+#endif
+
+/****************************************************************************
+ * Private Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: mpu_priv_noncache
+ *
+ * Description:
+ *   Configure a region as privileged, normal, non-cacheable memory
+ *   (TEX=1 C=0 B=0).
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_ARMV7M_DMAHEAP_NOCACHE
+static void mpu_priv_noncache(uintptr_t base, size_t size)
+{
+  unsigned int region = mpu_allocregion();
+  uint32_t     regval;
+  uint8_t      l2size;
+  uint8_t      subregions;
+
+  /* Select the region */
+
+  putreg32(region, MPU_RNR);
+
+  /* Select the region base address */
+
+  putreg32((base & MPU_RBAR_ADDR_MASK) | region, MPU_RBAR);
+
+  /* Select the region size and the sub-region map */
+
+  l2size     = mpu_log2regionceil(size);
+  subregions = mpu_subregion(base, size, l2size);
+
+  /* Then configure the region */
+
+  regval = MPU_RASR_ENABLE                              | /* Enable region */
+           MPU_RASR_SIZE_LOG2((uint32_t)l2size)         | /* Region size   */
+           ((uint32_t)subregions << MPU_RASR_SRD_SHIFT) | /* Sub-regions   */
+           (1 << MPU_RASR_TEX_SHIFT)                    | /* Normal        */
+           MPU_RASR_S                                   | /* Shareable     */
+           MPU_RASR_AP_RWNO                             | /* P:RW   U:None */
+           MPU_RASR_XN;                                   /* No execution  */
+  putreg32(regval, MPU_RASR);
+
+  ARM_DSB();
+  ARM_ISB();
+}
+#endif
+
+/****************************************************************************
+ * Public Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: up_dma_initialize
+ *
+ * Description:
+ *   Set up the DMA heap.
+ *
+ ****************************************************************************/
+
+int up_dma_initialize(void)
+{
+  g_dmagran = gran_initialize(g_dmaheap, CONFIG_ARMV7M_DMAHEAP_SIZE,
+                              DMAHEAP_LOG2LINE, DMAHEAP_LOG2LINE);
+  if (g_dmagran == NULL)
+    {
+      return -ENOMEM;
+    }
+
+#ifdef CONFIG_ARMV7M_DMAHEAP_NOCACHE
+  /* Write back and drop any lines of the heap that are already cached;
+   * they could otherwise be evicted over DMA data later.
+   */
+
+  up_flush_dcache((uintptr_t)g_dmaheap,
+                  (uintptr_t)g_dmaheap + CONFIG_ARMV7M_DMAHEAP_SIZE);
+
+  mpu_priv_noncache((uintptr_t)g_dmaheap, CONFIG_ARMV7M_DMAHEAP_SIZE);
+  g_dmauncached = true;
+#endif
+
+  minfo("DMA heap at %p, %u bytes\n", g_dmaheap,
+        CONFIG_ARMV7M_DMAHEAP_SIZE);
+  return OK;
+}
+
+/****************************************************************************
+ * Name: up_dma_alloc
+ *
+ * Description:
+ *   Allocate a cache line aligned DMA buffer.
+ *
+ ****************************************************************************/
+
+FAR void *up_dma_alloc(size_t size)
+{
+  DEBUGASSERT(g_dmagran != NULL);
+  return gran_alloc(g_dmagran, size);
+}
+
+/****************************************************************************
+ * Name: up_dma_free
+ *
+ * Description:
+ *   Free a DMA buffer.
+ *
+ ****************************************************************************/
+
+void up_dma_free(FAR void *mem, size_t size)
+{
+  DEBUGASSERT(g_dmagran != NULL);
+  gran_free(g_dmagran, mem, size);
+}
+
+/****************************************************************************
+ * Name: up_dma_uncached
+ *
+ * Description:
+ *   Return true if the address range lies within the non-cacheable DMA
+ *   heap.
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_ARMV7M_DMAHEAP_NOCACHE
+bool up_dma_uncached(uintptr_t start, uintptr_t end)
+{
+  return g_dmauncached && start >= (uintptr_t)g_dmaheap &&
+         end <= (uintptr_t)g_dmaheap + CONFIG_ARMV7M_DMAHEAP_SIZE;
+}
+#endif
+
+#endif /* CONFIG_ARMV7M_DMAHEAP */
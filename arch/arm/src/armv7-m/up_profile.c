@@ -0,0 +1,97 @@
+/****************************************************************************
+ * arch/arm/src/armv7-m/up_profile.c
+ *
+ *   Copyright (C) 2020 Gregory Nutt. All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in
+ *    the documentation and/or other materials provided with the
+ *    distribution.
+ * 3. Neither the name NuttX nor the names of its contributors may be
+ *    used to endorse or promote products derived from this software
+ *    without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+ * FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE
+ * COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+ * INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,
+ * BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS
+ * OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED
+ * AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ * LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN
+ * ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ *
+ ****************************************************************************/
+
+/****************************************************************************
+ * Included Files
+ ****************************************************************************/
+
+#include <nuttx/config.h>
+
+#include <stdint.h>
+
+#include <nuttx/irq.h>
+#include <nuttx/arch.h>
+
+#include "up_internal.h"
+
+#ifdef CONFIG_SCHED_PROFILE
+
+/****************************************************************************
+ * Public Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: up_profile_pc
+ *
+ * Description:
+ *   Return the program counter and the link register of the context that
+ *   was preempted by the current interrupt, taken from the register save
+ *   area of the interrupt.
+ *
+ ****************************************************************************/
+
+uintptr_t up_profile_pc(FAR uintptr_t *caller)
+{
+  FAR uint32_t *regs = (FAR uint32_t *)CURRENT_REGS;
+
+  if (regs == NULL)
+    {
+      /* Not in an interrupt handler */
+
+      return 0;
+    }
+
+  if (caller != NULL)
+    {
+      *caller = regs[REG_LR];
+    }
+
+  return regs[REG_PC];
+}
+
+/****************************************************************************
+ * Name: up_profile_text
+ *
+ * Description:
+ *   Return the address range of the code section.
+ *
+ ****************************************************************************/
+
+void up_profile_text(FAR uintptr_t *start, FAR uintptr_t *end)
+{
+  *start = (uintptr_t)_START_TEXT;
+  *end   = (uintptr_t)_END_TEXT;
+}
+
+#endif /* CONFIG_SCHED_PROFILE */
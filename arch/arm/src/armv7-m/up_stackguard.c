@@ -0,0 +1,134 @@
+/****************************************************************************
+ * arch/arm/src/armv7-m/up_stackguard.c
+ *
+ *   Copyright (C) 2020 Gregory Nutt. All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in
+ *    the documentation and/or other materials provided with the
+ *    distribution.
+ * 3. Neither the name NuttX nor the names of its contributors may be
+ *    used to endorse or promote products derived from this software
+ *    without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+ * FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE
+ * COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+ * INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,
+ * BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS
+ * OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED
+ * AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ * LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN
+ * ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ *
+ ****************************************************************************/
+
+/****************************************************************************
+ * Included Files
+ ****************************************************************************/
+
+#include <nuttx/config.h>
+
+#include <stdint.h>
+
+#include <nuttx/arch.h>
+#include <nuttx/sched.h>
+#include <nuttx/tls.h>
+
+#include "mpu.h"
+#include "up_arch.h"
+#include "up_internal.h"
+
+#ifdef CONFIG_ARMV7M_STACKGUARD
+
+/****************************************************************************
+ * Private Data
+ ****************************************************************************/
+
+/* The MPU region used for the guard.  Allocated on first use so that it
+ * has a higher number, and thus takes precedence over, the regions
+ * configured at boot time.
+ */
+
+static int g_stackguard_region = -1;
+
+/****************************************************************************
+ * Public Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: up_stackguard
+ *
+ * Description:
+ *   Move the stack overflow guard to the bottom of the stack of the thread
+ *   that is about to run.  Called by sched_resume_scheduler() on every
+ *   context switch.
+ *
+ * Input Parameters:
+ *   tcb - The TCB of the thread that is about to run.
+ *
+ * Returned Value:
+ *   None
+ *
+ * Assumptions:
+ *   Called from within a critical section.
+ *
+ ****************************************************************************/
+
+void up_stackguard(FAR struct tcb_s *tcb)
+{
+  uintptr_t bottom;
+  uintptr_t base;
+
+  if (g_stackguard_region < 0)
+    {
+      g_stackguard_region = mpu_allocregion();
+
+      /* In the FLAT build, the MPU is not enabled at boot time.  Enable it
+       * with the default memory map for privileged accesses so that only
+       * the guard is enforced.
+       */
+
+      if ((getreg32(MPU_CTRL) & MPU_CTRL_ENABLE) == 0)
+        {
+          mpu_control(true, false, true);
+        }
+    }
+
+  putreg32(g_stackguard_region, MPU_RNR);
+
+  /* Disable the guard if there is no stack to protect */
+
+  if (tcb->stack_alloc_ptr == NULL ||
+      tcb->adj_stack_size < 4 * STACKGUARD_SIZE)
+    {
+      putreg32(0, MPU_RASR);
+      return;
+    }
+
+  bottom = (uintptr_t)tcb->stack_alloc_ptr;
+#ifdef CONFIG_TLS
+  bottom += sizeof(struct tls_info_s);
+#endif
+  base = STACKGUARD_BASE(bottom);
+
+  /* No access at all, not even for privileged code */
+
+  putreg32((base & MPU_RBAR_ADDR_MASK) | g_stackguard_region, MPU_RBAR);
+  putreg32(MPU_RASR_ENABLE                   | /* Enable region */
+           MPU_RASR_SIZE_LOG2(5)             | /* 32 bytes      */
+           MPU_RASR_AP_NONO                  | /* P:None U:None */
+           MPU_RASR_XN,                        /* No execution  */
+           MPU_RASR);
+}
+
+#endif /* CONFIG_ARMV7M_STACKGUARD */
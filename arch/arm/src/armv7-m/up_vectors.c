@@ -39,6 +39,7 @@
 #include <nuttx/config.h>
 
 #include "chip.h"
+#include "nvic.h"
 #include "up_internal.h"
 
 /************************************************************************************
@@ -63,6 +64,12 @@ extern void __start(void);
 
 extern void exception_common(void);
 
+#ifdef CONFIG_SYSCALL_FASTPATH
+/* SVCall entrypoint with the system call fast path */
+
+extern void exception_svcall(void);
+#endif
+
 /************************************************************************************
  * Public data
  ************************************************************************************/
@@ -88,6 +95,17 @@ unsigned _vectors[] __attribute__((section(".vectors"))) =
 
   /* Vectors 2 - n point directly at the generic handler */
 
+#ifdef CONFIG_SYSCALL_FASTPATH
+  [2 ... (NVIC_IRQ_SVCALL - 1)] = (unsigned)&exception_common,
+
+  /* Except for SVCall which first checks for a fast system call */
+
+  [NVIC_IRQ_SVCALL] = (unsigned)&exception_svcall,
+
+  [(NVIC_IRQ_SVCALL + 1) ... (15 + ARMV7M_PERIPHERAL_INTERRUPTS)] =
+    (unsigned)&exception_common
+#else
   [2 ... (15 + ARMV7M_PERIPHERAL_INTERRUPTS)] = (unsigned)&exception_common
+#endif
 };
 
@@ -58,7 +58,8 @@
  * Private Function Prototypes
  ****************************************************************************/
 
-static size_t do_stackcheck(uintptr_t alloc, size_t size, bool int_stack);
+static size_t do_stackcheck(uintptr_t alloc, size_t size, bool int_stack,
+                            FAR uintptr_t *hwm);
 
 /****************************************************************************
  * Name: do_stackcheck
@@ -68,21 +69,31 @@ static size_t do_stackcheck(uintptr_t alloc, size_t size, bool int_stack);
  *   stack memory for a high water mark.  That is, the deepest level of the
  *   stack that clobbered some recognizable marker in the stack memory.
  *
+ *   With CONFIG_STACK_COLORATION_INCREMENTAL, the high water mark found
+ *   by the previous check is remembered and only the memory below it is
+ *   searched.  That search stops at the first CONFIG_STACK_COLORATION_GAP
+ *   bytes of untouched stack.
+ *
  * Input Parameters:
  *   alloc - Allocation base address of the stack
  *   size - The size of the stack in bytes
+ *   hwm - The remembered high water mark.  NULL if there is none.
  *
  * Returned Value:
  *   The estimated amount of stack space used.
  *
  ****************************************************************************/
 
-static size_t do_stackcheck(uintptr_t alloc, size_t size, bool int_stack)
+static size_t do_stackcheck(uintptr_t alloc, size_t size, bool int_stack,
+                            FAR uintptr_t *hwm)
 {
   FAR uintptr_t start;
   FAR uintptr_t end;
   FAR uint32_t *ptr;
   size_t mark;
+#ifdef CONFIG_STACK_COLORATION_INCREMENTAL
+  unsigned int gap;
+#endif
 
   if (size == 0)
     {
@@ -96,7 +107,9 @@ static size_t do_stackcheck(uintptr_t alloc, size_t size, bool int_stack)
     {
       /* Skip over the TLS data structure at the bottom of the stack */
 
+#ifdef CONFIG_TLS_ALIGNED
       DEBUGASSERT((alloc & TLS_STACK_MASK) == 0);
+#endif
       start = alloc + sizeof(struct tls_info_s);
     }
   else
@@ -109,6 +122,49 @@ static size_t do_stackcheck(uintptr_t alloc, size_t size, bool int_stack)
 #endif
   end   = (alloc + size + 3) & ~3;
 
+#ifdef CONFIG_ARMV7M_STACKGUARD
+  if (!int_stack)
+    {
+      /* Reading the stack guard of the running thread would fault */
+
+      start = STACKGUARD_BASE(start) + STACKGUARD_SIZE;
+      if (start > end)
+        {
+          start = end;
+        }
+    }
+#endif
+
+#ifdef CONFIG_STACK_COLORATION_INCREMENTAL
+  if (hwm != NULL && *hwm > start && *hwm <= end)
+    {
+      /* The stack only grows deeper.  Search down from the remembered high
+       * water mark until a large enough untouched gap is found.
+       */
+
+      ptr = (FAR uint32_t *)*hwm;
+      gap = 0;
+
+      while ((uintptr_t)ptr > start &&
+             gap < (CONFIG_STACK_COLORATION_GAP >> 2))
+        {
+          if (*--ptr != STACK_COLOR)
+            {
+              *hwm = (uintptr_t)ptr;
+              gap  = 0;
+            }
+          else
+            {
+              gap++;
+            }
+        }
+
+      return end - *hwm;
+    }
+#else
+  UNUSED(hwm);
+#endif
+
   /* Get the adjusted size based on the top and bottom of the stack */
 
   size  = end - start;
@@ -162,6 +218,15 @@ static size_t do_stackcheck(uintptr_t alloc, size_t size, bool int_stack)
     }
 #endif
 
+#ifdef CONFIG_STACK_COLORATION_INCREMENTAL
+  /* Remember the high water mark for the next check */
+
+  if (hwm != NULL)
+    {
+      *hwm = end - (mark << 2);
+    }
+#endif
+
   /* Return our guess about how much stack space was used */
 
   return mark << 2;
@@ -189,8 +254,13 @@ static size_t do_stackcheck(uintptr_t alloc, size_t size, bool int_stack)
 
 size_t up_check_tcbstack(FAR struct tcb_s *tcb)
 {
+#ifdef CONFIG_STACK_COLORATION_INCREMENTAL
+  return do_stackcheck((uintptr_t)tcb->stack_alloc_ptr, tcb->adj_stack_size,
+                       false, &tcb->stack_hwm);
+#else
   return do_stackcheck((uintptr_t)tcb->stack_alloc_ptr, tcb->adj_stack_size,
-                       false);
+                       false, NULL);
+#endif
 }
 
 ssize_t up_check_tcbstack_remain(FAR struct tcb_s *tcb)
@@ -213,7 +283,7 @@ size_t up_check_intstack(void)
 {
   return do_stackcheck((uintptr_t)&g_intstackalloc,
                        (CONFIG_ARCH_INTERRUPTSTACK & ~3),
-                       true);
+                       true, NULL);
 }
 
 size_t up_check_intstack_remain(void)
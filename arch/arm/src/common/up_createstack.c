@@ -127,6 +127,7 @@ int up_create_stack(FAR struct tcb_s *tcb, size_t stack_size, uint8_t ttype)
 
    stack_size += sizeof(struct tls_info_s);
 
+#ifdef CONFIG_TLS_ALIGNED
    /* The allocated stack size must not exceed the maximum possible for the
     * TLS feature.
     */
@@ -136,6 +137,7 @@ int up_create_stack(FAR struct tcb_s *tcb, size_t stack_size, uint8_t ttype)
      {
        stack_size = TLS_MAXSTACK;
      }
+#endif
 #endif
 
   /* Is there already a stack allocated of a different size?  Because of
@@ -156,10 +158,11 @@ int up_create_stack(FAR struct tcb_s *tcb, size_t stack_size, uint8_t ttype)
     {
       /* Allocate the stack.  If DEBUG is enabled (but not stack debug),
        * then create a zeroed stack to make stack dumps easier to trace.
-       * If TLS is enabled, then we must allocate aligned stacks.
+       * If TLS is located from the stack pointer, then we must allocate
+       * aligned stacks.
        */
 
-#ifdef CONFIG_TLS
+#ifdef CONFIG_TLS_ALIGNED
 #ifdef HAVE_KERNEL_HEAP
       /* Use the kernel allocator if this is a kernel thread */
 
@@ -177,7 +180,7 @@ int up_create_stack(FAR struct tcb_s *tcb, size_t stack_size, uint8_t ttype)
             (uint32_t *)kumm_memalign(TLS_STACK_ALIGN, stack_size);
         }
 
-#else /* CONFIG_TLS */
+#else /* CONFIG_TLS_ALIGNED */
 #ifdef HAVE_KERNEL_HEAP
       /* Use the kernel allocator if this is a kernel thread */
 
@@ -192,7 +195,7 @@ int up_create_stack(FAR struct tcb_s *tcb, size_t stack_size, uint8_t ttype)
 
           tcb->stack_alloc_ptr = (uint32_t *)kumm_malloc(stack_size);
         }
-#endif /* CONFIG_TLS */
+#endif /* CONFIG_TLS_ALIGNED */
 
 #ifdef CONFIG_DEBUG_FEATURES
       /* Was the allocation successful? */
@@ -270,6 +273,12 @@ int up_create_stack(FAR struct tcb_s *tcb, size_t stack_size, uint8_t ttype)
 #endif /* CONFIG_STACK_COLORATION */
 #endif /* CONFIG_TLS */
 
+#ifdef CONFIG_STACK_COLORATION_INCREMENTAL
+      /* The stack was just colored.  Forget any old high-water mark. */
+
+      tcb->stack_hwm = 0;
+#endif
+
       board_autoled_on(LED_STACKCREATED);
       return OK;
     }
@@ -183,6 +183,17 @@
 #define INTSTACK_COLOR 0xdeadbeef
 #define HEAP_COLOR     'h'
 
+/* The stack overflow guard is the first naturally aligned block of
+ * STACKGUARD_SIZE bytes at or above the bottom of the stack (after the TLS
+ * data).  STACKGUARD_SIZE is the smallest MPU region size.
+ */
+
+#ifdef CONFIG_ARMV7M_STACKGUARD
+#  define STACKGUARD_SIZE 32
+#  define STACKGUARD_BASE(bottom) \
+     (((uintptr_t)(bottom) + STACKGUARD_SIZE - 1) & ~(STACKGUARD_SIZE - 1))
+#endif
+
 /****************************************************************************
  * Public Types
  ****************************************************************************/
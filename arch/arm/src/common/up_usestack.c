@@ -105,7 +105,7 @@ int up_use_stack(struct tcb_s *tcb, void *stack, size_t stack_size)
   size_t top_of_stack;
   size_t size_of_stack;
 
-#ifdef CONFIG_TLS
+#ifdef CONFIG_TLS_ALIGNED
   /* Make certain that the user provided stack is properly aligned */
 
   DEBUGASSERT(((uintptr_t)stack & TLS_STACK_MASK) == 0);
@@ -172,5 +172,11 @@ int up_use_stack(struct tcb_s *tcb, void *stack, size_t stack_size)
 #endif
 #endif
 
+#ifdef CONFIG_STACK_COLORATION_INCREMENTAL
+  /* The stack was just colored.  Forget any old high-water mark. */
+
+  tcb->stack_hwm = 0;
+#endif
+
   return OK;
 }
@@ -49,6 +49,7 @@
 #include <nuttx/arch.h>
 #include <nuttx/kmalloc.h>
 #include <nuttx/fs/fs.h>
+#include <nuttx/fs/ioctl.h>
 #include <nuttx/irq.h>
 #include <arch/chip/scu.h>
 #include <arch/chip/adc.h>
@@ -187,6 +188,7 @@ struct cxd56adc_dev_s
   struct scufifo_wm_s *wm;        /* water mark */
   struct math_filter_s *filter;   /* math filter */
   struct scuev_notify_s * notify; /* notify */
+  struct scufifo_ringcfg_s *ring; /* sample ring */
 };
 
 /****************************************************************************
@@ -377,7 +379,8 @@ static int adc_start(adc_ch_t ch, uint8_t freq, FAR struct seq_s *seq,
         int fsize, int fifomode,
         struct scufifo_wm_s *wm,
         struct math_filter_s *filter,
-        struct scuev_notify_s *notify)
+        struct scuev_notify_s *notify,
+        struct scufifo_ringcfg_s *ring)
 {
   uint32_t *addr;
   uint32_t val;
@@ -429,6 +432,17 @@ static int adc_start(adc_ch_t ch, uint8_t freq, FAR struct seq_s *seq,
             return ret;
           }
       }
+#ifdef CONFIG_CXD56_SCU_RING
+    if (ring)
+      {
+        ret = seq_ioctl(seq, 0, SCUIOC_SETRING, (unsigned long)ring);
+        if (ret < 0)
+          {
+            aerr("SETRING failed. %d\n", ret);
+            return ret;
+          }
+      }
+#endif
   if (ch <= CH3)
     {
       /* LPADC.A1 LPADC_CH : todo: GPS ch */
@@ -692,6 +706,71 @@ static bool adc_validcheck(int cmd)
   return false;
 }
 
+/****************************************************************************
+ * Name: adc_ringread
+ *
+ * Description:
+ *   Copy as many whole samples from the sample ring as fit in the buffer
+ *   and release their slots.
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_CXD56_SCU_RING
+static ssize_t adc_ringread(FAR struct cxd56adc_dev_s *priv,
+                            FAR char *buffer, size_t len)
+{
+  FAR struct scufifo_ring_s *ring;
+  uint32_t tail;
+  uint32_t avail;
+  uint32_t chunk;
+  size_t nsamples;
+  size_t nread = 0;
+  int ret;
+
+  ret = seq_ioctl(priv->seq, 0, SCUIOC_GETRING,
+                  (unsigned long)(uintptr_t)&ring);
+  if (ret < 0)
+    {
+      return ret;
+    }
+
+  tail     = ring->tail;
+  avail    = (ring->head + ring->nsamples - tail) % ring->nsamples;
+  nsamples = len / ring->sample;
+  if (nsamples > avail)
+    {
+      nsamples = avail;
+    }
+
+  /* Copy in at most two chunks, up to the end of the ring and from the
+   * start of the ring.
+   */
+
+  while (nsamples > 0)
+    {
+      chunk = ring->nsamples - tail;
+      if (chunk > nsamples)
+        {
+          chunk = nsamples;
+        }
+
+      memcpy(&buffer[nread], &ring->data[tail * ring->sample],
+             chunk * ring->sample);
+
+      nread    += chunk * ring->sample;
+      nsamples -= chunk;
+      tail     += chunk;
+      if (tail >= ring->nsamples)
+        {
+          tail = 0;
+        }
+    }
+
+  ring->tail = tail;
+  return nread;
+}
+#endif
+
 /****************************************************************************
  * Name: cxd56_adc_open
  *
@@ -774,6 +853,11 @@ static int cxd56_adc_close(FAR struct file *filep)
       kmm_free(priv->notify);
       priv->notify = NULL;
     }
+  if (priv->ring)
+    {
+      kmm_free(priv->ring);
+      priv->ring = NULL;
+    }
 
   return OK;
 }
@@ -797,6 +881,17 @@ static ssize_t cxd56_adc_read(FAR struct file *filep, FAR char *buffer,
   DEBUGASSERT(priv->seq != NULL);
   DEBUGASSERT(priv->ch < CH_MAX);
 
+#ifdef CONFIG_CXD56_SCU_RING
+  /* While a sample ring is attached, the FIFO is drained into the ring by
+   * uDMA, so return the samples from the ring.
+   */
+
+  if (priv->ring != NULL && priv->ring->nsamples > 0 && adc_active[priv->ch])
+    {
+      return adc_ringread(priv, buffer, len);
+    }
+#endif
+
   len = len / ADC_BYTESPERSAMPLE * ADC_BYTESPERSAMPLE;
   ret = seq_read(priv->seq, 0, buffer, len);
 
@@ -827,7 +922,7 @@ static int cxd56_adc_ioctl(FAR struct file *filep, int cmd,
       case ANIOC_CXD56_START:
         ret = adc_start(priv->ch, priv->freq, priv->seq,
                 priv->fsize, priv->fifomode,
-                priv->wm, priv->filter, priv->notify);
+                priv->wm, priv->filter, priv->notify, priv->ring);
         break;
 
       case ANIOC_CXD56_STOP:
@@ -888,6 +983,38 @@ static int cxd56_adc_ioctl(FAR struct file *filep, int cmd,
           }
         break;
 
+#ifdef CONFIG_CXD56_SCU_RING
+      case SCUIOC_SETRING:
+        if (adc_active[priv->ch] == false) /* before start */
+          {
+            struct scufifo_ringcfg_s *ring =
+              (struct scufifo_ringcfg_s *)arg;
+            if (priv->ring == NULL)
+              {
+                priv->ring = (struct scufifo_ringcfg_s *)
+                  kmm_malloc(sizeof(struct scufifo_ringcfg_s));
+                if (priv->ring == NULL)
+                  {
+                    ret = -ENOMEM;
+                    break;
+                  }
+              }
+            *(priv->ring) = *ring;
+          }
+        else
+          {
+            ret = -EBUSY;
+          }
+        break;
+
+      /* mmap() the sample ring filled while ADC running */
+
+      case FIOC_MMAP:
+      case SCUIOC_GETRING:
+        ret = seq_ioctl(priv->seq, 0, SCUIOC_GETRING, arg);
+        break;
+#endif
+
       default:
         {
           if (adc_validcheck(cmd))
@@ -43,12 +43,14 @@
 
 #include <sys/types.h>
 #include <stdint.h>
+#include <stdio.h>
 #include <string.h>
 #include <assert.h>
 #include <debug.h>
 
 #include <nuttx/arch.h>
 #include <nuttx/board.h>
+#include <nuttx/mm/heap.h>
 #include <arch/board/board.h>
 
 #include "chip.h"
@@ -87,6 +89,25 @@ const uint32_t g_idle_topstack = (uint32_t)&_ebss +
 
 extern char __stack[];
 
+/* The number of per-CPU tile heaps */
+
+#ifdef CONFIG_CXD56_TILEHEAP
+#  ifdef CONFIG_SMP
+#    define CXD56_NTILEHEAPS CONFIG_SMP_NCPUS
+#  else
+#    define CXD56_NTILEHEAPS 1
+#  endif
+#endif
+
+/****************************************************************************
+ * Private Data
+ ****************************************************************************/
+
+#ifdef CONFIG_CXD56_TILEHEAP
+static struct mm_heap_s g_tileheap[CXD56_NTILEHEAPS];
+static char g_tileheapname[CXD56_NTILEHEAPS][8];
+#endif
+
 /****************************************************************************
  * Private Functions
  ****************************************************************************/
@@ -108,6 +129,54 @@ static inline void up_heap_color(FAR void *start, size_t size)
 #  define up_heap_color(start,size)
 #endif
 
+/****************************************************************************
+ * Name: cxd56_tileheap_initialize
+ *
+ * Description:
+ *   Set aside CONFIG_CXD56_TILEHEAP_SIZE bytes of tile aligned memory for
+ *   each CPU below 'end' and register them as named heaps.
+ *
+ * Returned Value:
+ *   The new end of the memory available for the user heap.
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_CXD56_TILEHEAP
+static uintptr_t cxd56_tileheap_initialize(uintptr_t end)
+{
+  uintptr_t start;
+  cpu_set_t affinity;
+  int ret;
+  int cpu;
+
+  /* Heaps start on a tile boundary.  CPU 0 gets the highest tiles. */
+
+  end &= ~(uintptr_t)(CXD56_RAM_TILESIZE - 1);
+
+  for (cpu = 0; cpu < CXD56_NTILEHEAPS; cpu++)
+    {
+      start = end - CONFIG_CXD56_TILEHEAP_SIZE;
+      DEBUGASSERT(start > g_idle_topstack);
+
+      snprintf(g_tileheapname[cpu], sizeof(g_tileheapname[cpu]),
+               "tile%d", cpu);
+
+      affinity = (cpu_set_t)(1 << cpu);
+
+      up_heap_color((FAR void *)start, CONFIG_CXD56_TILEHEAP_SIZE);
+      ret = heap_register(g_tileheapname[cpu], &g_tileheap[cpu],
+                          (FAR void *)start, CONFIG_CXD56_TILEHEAP_SIZE,
+                          affinity);
+      DEBUGASSERT(ret >= 0);
+      UNUSED(ret);
+
+      end = start;
+    }
+
+  return end;
+}
+#endif
+
 /****************************************************************************
  * Public Functions
  ****************************************************************************/
@@ -131,9 +200,18 @@ void up_allocate_heap(FAR void **heap_start, size_t *heap_size)
 {
   /* Start with the first SRAM region */
 
+  uintptr_t heap_end = (uintptr_t)&__stack;
+
   board_autoled_on(LED_HEAPALLOCATE);
+
+#ifdef CONFIG_CXD56_TILEHEAP
+  /* Take the per-CPU heaps from the top of RAM */
+
+  heap_end = cxd56_tileheap_initialize(heap_end);
+#endif
+
   *heap_start = (FAR void *)g_idle_topstack;
-  *heap_size = (uint32_t)&__stack - g_idle_topstack;
+  *heap_size = heap_end - g_idle_topstack;
 
   /* Colorize the heap for debug */
 
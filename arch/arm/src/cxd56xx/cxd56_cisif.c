@@ -341,10 +341,12 @@ static void cisif_vs_int(uint8_t code)
 
       case STATE_READY:
         g_errint_receive = false;
+        video_common_notify_vsync(g_cisif_video_private);
         break;
 
       case STATE_CAPTURE:
         g_errint_receive = false;
+        video_common_notify_vsync(g_cisif_video_private);
         break;
 
       default:
@@ -982,7 +984,12 @@ static int cxd56_cisif_cancel_dma(void)
 {
   g_state = STATE_READY;
   cisif_reg_write(CISIF_DIN_ENABLE, 0);
-  cisif_reg_write(CISIF_INTR_DISABLE, ALL_CLEAR_INT);
+
+  /* Keep the vertical sync interrupt so that frames that pass while no
+   * buffer is available are still counted.
+   */
+
+  cisif_reg_write(CISIF_INTR_DISABLE, ALL_CLEAR_INT & ~VS_INT);
   cisif_reg_write(CISIF_EXE_CMD, 1);
 
   return OK;
@@ -41,6 +41,7 @@
 
 #include <stdint.h>
 #include <assert.h>
+#include <errno.h>
 #include <debug.h>
 #include <string.h>
 #include <stdio.h>
@@ -53,6 +54,7 @@
 #include "sched/sched.h"
 #include "up_internal.h"
 #include "hardware/cxd5602_memorymap.h"
+#include "cxd56_cpupause.h"
 
 #ifdef CONFIG_SMP
 
@@ -68,6 +70,29 @@
 
 #define CXD56_CPU_P2_INT        (CXD56_SWINT_BASE + 0x8)  /* for APP_DSP0 */
 
+/* Number of cxd56_smp_call() requests that may be queued per CPU */
+
+#define SMP_NCALLS              8
+
+/****************************************************************************
+ * Private Types
+ ****************************************************************************/
+
+struct smp_call_s
+{
+  cxd56_smpcall_t func;         /* Function to run on the target CPU */
+  FAR void *arg;                /* Its argument */
+  FAR volatile bool *done;      /* Set when func returns, may be NULL */
+};
+
+struct smp_callq_s
+{
+  spinlock_t lock;              /* Protects head, tail and the slots */
+  volatile uint8_t head;        /* Next slot to fill */
+  volatile uint8_t tail;        /* Next slot to run */
+  struct smp_call_s calls[SMP_NCALLS];
+};
+
 /****************************************************************************
  * Private Data
  ****************************************************************************/
@@ -89,70 +114,78 @@
 static volatile spinlock_t g_cpu_wait[CONFIG_SMP_NCPUS];
 static volatile spinlock_t g_cpu_paused[CONFIG_SMP_NCPUS];
 
-static volatile int g_irq_to_handle[CONFIG_SMP_NCPUS][2];
+/* Functions queued for each CPU by cxd56_smp_call() */
+
+static struct smp_callq_s g_cpu_callq[CONFIG_SMP_NCPUS];
 
 /****************************************************************************
  * Private Functions
  ****************************************************************************/
 
 /****************************************************************************
- * Name: handle_irqreq
+ * Name: handle_calls
  *
  * Description:
- *   If an irq handling request is found on cpu, call up_enable_irq() or
- *   up_disable_irq(), then return true.
+ *   Run the functions queued for cpu by cxd56_smp_call().
  *
  * Input Parameters:
- *   cpu - The index of the CPU to be queried
- *
- * Returned Value:
- *   true  = an irq handling request is found
- *   false = no irq handling request is found
+ *   cpu - The index of the current CPU
  *
  ****************************************************************************/
 
-static bool handle_irqreq(int cpu)
+static void handle_calls(int cpu)
 {
-  int i;
-  bool handled = false;
+  FAR struct smp_callq_s *q = &g_cpu_callq[cpu];
+  struct smp_call_s call;
+  irqstate_t flags;
+
+  /* Interrupts stay disabled so that the handler cannot nest on top of a
+   * caller that is running the queue while it waits.
+   */
 
-  /* Check both cases */
+  flags = up_irq_save();
 
-  for (i = 0; i < 2; i++)
+  for (; ; )
     {
-      int irqreq = g_irq_to_handle[cpu][i];
-
-      if (irqreq)
+      spin_lock(&q->lock);
+      if (q->tail == q->head)
         {
-          /* Unlock the spinlock first */
-
-          spin_unlock(&g_cpu_paused[cpu]);
-
-          /* Then wait for the spinlock to be released */
+          spin_unlock(&q->lock);
+          break;
+        }
 
-          spin_lock(&g_cpu_wait[cpu]);
+      call = q->calls[q->tail % SMP_NCALLS];
+      q->tail++;
+      spin_unlock(&q->lock);
 
-          /* Clear g_irq_to_handle[cpu][i] */
+      call.func(call.arg);
 
-          g_irq_to_handle[cpu][i] = 0;
+      if (call.done != NULL)
+        {
+          SP_DMB();
+          *call.done = true;
+        }
+    }
 
-          if (0 == i)
-            {
-              up_enable_irq(irqreq);
-            }
-          else
-            {
-              up_disable_irq(irqreq);
-            }
+  up_irq_restore(flags);
+}
 
-          /* Finally unlock the spinlock */
+/****************************************************************************
+ * Name: irqreq_enable / irqreq_disable
+ *
+ * Description:
+ *   cxd56_smp_call() targets used by up_send_irqreq().
+ *
+ ****************************************************************************/
 
-          spin_unlock(&g_cpu_wait[cpu]);
-          handled = true;
-        }
-    }
+static void irqreq_enable(FAR void *arg)
+{
+  up_enable_irq((int)(uintptr_t)arg);
+}
 
-  return handled;
+static void irqreq_disable(FAR void *arg)
+{
+  up_disable_irq((int)(uintptr_t)arg);
 }
 
 /****************************************************************************
@@ -281,12 +314,9 @@ int arm_pause_handler(int irq, void *c, FAR void *arg)
 
   putreg32(0, CXD56_CPU_P2_INT + (4 * cpu));
 
-  /* Check if this IPI is to enable/disable IRQ */
+  /* Run any functions queued by cxd56_smp_call() */
 
-  if (handle_irqreq(cpu))
-    {
-      return OK;
-    }
+  handle_calls(cpu);
 
   /* Check for false alarms.  Such false could occur as a consequence of
    * some deadlock breaking logic that might have already serviced the SG2
@@ -408,48 +438,93 @@ int up_cpu_resume(int cpu)
 }
 
 /****************************************************************************
- * Name: up_send_irqreq()
+ * Name: cxd56_smp_call
  *
  * Description:
- *   Send up_enable_irq() / up_disable_irq() request to the specified cpu
- *
- *   This function is called from up_enable_irq() or up_disable_irq()
- *   to be handled on specified CPU. Locking protocol in the sequence is
- *   the same as up_pause_cpu() plus up_resume_cpu().
- *
- * Input Parameters:
- *   idx - The request index (0: enable, 1: disable)
- *   irq - The IRQ number to be handled
- *   cpu - The index of the CPU which will handle the request
+ *   Run func(arg) on another CPU without pausing it.  See
+ *   cxd56_cpupause.h.
  *
  ****************************************************************************/
 
-void up_send_irqreq(int idx, int irq, int cpu)
+int cxd56_smp_call(int cpu, cxd56_smpcall_t func, FAR void *arg,
+                   bool wait)
 {
-  DEBUGASSERT(cpu >= 0 && cpu < CONFIG_SMP_NCPUS && cpu != this_cpu());
+  FAR struct smp_callq_s *q;
+  volatile bool done = false;
+  irqstate_t flags;
+  int me = up_cpu_index();
 
-  /* Wait for the spinlocks to be released */
+  if (cpu < 0 || cpu >= CONFIG_SMP_NCPUS || func == NULL)
+    {
+      return -EINVAL;
+    }
 
-  spin_lock(&g_cpu_wait[cpu]);
-  spin_lock(&g_cpu_paused[cpu]);
+  if (cpu == me)
+    {
+      func(arg);
+      return OK;
+    }
 
-  /* Set irq for the cpu */
+  q = &g_cpu_callq[cpu];
 
-  g_irq_to_handle[cpu][idx] = irq;
+  /* Queue the call, running our own queue while the target's is full */
+
+  for (; ; )
+    {
+      flags = up_irq_save();
+      spin_lock(&q->lock);
+      if ((uint8_t)(q->head - q->tail) < SMP_NCALLS)
+        {
+          break;
+        }
+
+      spin_unlock(&q->lock);
+      up_irq_restore(flags);
+      handle_calls(me);
+    }
+
+  q->calls[q->head % SMP_NCALLS].func = func;
+  q->calls[q->head % SMP_NCALLS].arg  = arg;
+  q->calls[q->head % SMP_NCALLS].done = wait ? &done : NULL;
+  q->head++;
+  spin_unlock(&q->lock);
+  up_irq_restore(flags);
 
   /* Generate IRQ for CPU(cpu) */
 
   putreg32(1, CXD56_CPU_P2_INT + (4 * cpu));
 
-  /* Wait for the handler is executed on cpu */
+  while (wait && !done)
+    {
+      handle_calls(me);
+    }
 
-  spin_lock(&g_cpu_paused[cpu]);
-  spin_unlock(&g_cpu_paused[cpu]);
+  return OK;
+}
 
-  /* Finally unlock the spinlock to proceed the handler */
+/****************************************************************************
+ * Name: up_send_irqreq()
+ *
+ * Description:
+ *   Send up_enable_irq() / up_disable_irq() request to the specified cpu
+ *
+ *   This function is called from up_enable_irq() or up_disable_irq()
+ *   to be handled on specified CPU.  The request is run by
+ *   cxd56_smp_call(), so the other CPU is not paused.
+ *
+ * Input Parameters:
+ *   idx - The request index (0: enable, 1: disable)
+ *   irq - The IRQ number to be handled
+ *   cpu - The index of the CPU which will handle the request
+ *
+ ****************************************************************************/
 
-  spin_unlock(&g_cpu_wait[cpu]);
-  return;
+void up_send_irqreq(int idx, int irq, int cpu)
+{
+  DEBUGASSERT(cpu >= 0 && cpu < CONFIG_SMP_NCPUS && cpu != this_cpu());
+
+  cxd56_smp_call(cpu, idx == 0 ? irqreq_enable : irqreq_disable,
+                 (FAR void *)(uintptr_t)irq, true);
 }
 
 #endif /* CONFIG_SMP */
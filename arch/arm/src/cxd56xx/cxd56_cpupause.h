@@ -0,0 +1,115 @@
+/****************************************************************************
+ * arch/arm/src/cxd56xx/cxd56_cpupause.h
+ *
+ *   Copyright 2018 Sony Semiconductor Solutions Corporation
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in
+ *    the documentation and/or other materials provided with the
+ *    distribution.
+ * 3. Neither the name of Sony Semiconductor Solutions Corporation nor
+ *    the names of its contributors may be used to endorse or promote
+ *    products derived from this software without specific prior written
+ *    permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+ * FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE
+ * COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+ * INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,
+ * BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS
+ * OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED
+ * AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ * LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN
+ * ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ *
+ ****************************************************************************/
+
+#ifndef __ARCH_ARM_SRC_CXD56XX_CXD56_CPUPAUSE_H
+#define __ARCH_ARM_SRC_CXD56XX_CXD56_CPUPAUSE_H
+
+/****************************************************************************
+ * Included Files
+ ****************************************************************************/
+
+#include <nuttx/config.h>
+
+#include <stdbool.h>
+
+#ifdef CONFIG_SMP
+
+/****************************************************************************
+ * Public Types
+ ****************************************************************************/
+
+typedef CODE void (*cxd56_smpcall_t)(FAR void *arg);
+
+/****************************************************************************
+ * Public Function Prototypes
+ ****************************************************************************/
+
+#ifndef __ASSEMBLY__
+#ifdef __cplusplus
+#define EXTERN extern "C"
+extern "C"
+{
+#else
+#define EXTERN extern
+#endif
+
+/****************************************************************************
+ * Name: cxd56_smp_call
+ *
+ * Description:
+ *   Run func(arg) on another CPU from its inter-CPU interrupt handler.
+ *   The target CPU only takes an interrupt; unlike up_cpu_pause(), it is
+ *   not held until the caller is done.  Calls to one CPU run in the order
+ *   they were made.
+ *
+ *   func runs in interrupt context on the target CPU and must not block.
+ *   When wait is true the caller spins until func has returned, running
+ *   calls queued for its own CPU meanwhile so that two CPUs calling each
+ *   other cannot deadlock.
+ *
+ * Input Parameters:
+ *   cpu  - The index of the target CPU.  The call is made directly if this
+ *          is the current CPU.
+ *   func - The function to run
+ *   arg  - The argument passed to func
+ *   wait - True: return only after func has completed
+ *
+ * Returned Value:
+ *   Zero on success; a negated errno value on failure.
+ *
+ ****************************************************************************/
+
+int cxd56_smp_call(int cpu, cxd56_smpcall_t func, FAR void *arg,
+                   bool wait);
+
+/****************************************************************************
+ * Name: up_send_irqreq
+ *
+ * Description:
+ *   Have up_enable_irq() (idx 0) or up_disable_irq() (idx 1) run on the
+ *   given CPU and wait until it has.
+ *
+ ****************************************************************************/
+
+void up_send_irqreq(int idx, int irq, int cpu);
+
+#undef EXTERN
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* __ASSEMBLY__ */
+#endif /* CONFIG_SMP */
+#endif /* __ARCH_ARM_SRC_CXD56XX_CXD56_CPUPAUSE_H */
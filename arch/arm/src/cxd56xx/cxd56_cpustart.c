@@ -57,6 +57,7 @@
 #include "up_internal.h"
 #include "hardware/cxd56_crg.h"
 #include "hardware/cxd5602_memorymap.h"
+#include "cxd56_critmon.h"
 
 #ifdef CONFIG_SMP
 
@@ -118,6 +119,10 @@ static void appdsp_boot(void)
 
   fpuconfig();
 
+  /* Start the cycle counter of this CPU */
+
+  cxd56_critmon_initialize();
+
   /* Clear SW_INT for APP_DSP(cpu) */
 
   putreg32(0, CXD56_CPU_P2_INT + (4 * cpu));
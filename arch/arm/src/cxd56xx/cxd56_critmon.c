@@ -0,0 +1,111 @@
+/****************************************************************************
+ * arch/arm/src/cxd56xx/cxd56_critmon.c
+ *
+ *   Copyright 2020 Sony Semiconductor Solutions Corporation
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in
+ *    the documentation and/or other materials provided with the
+ *    distribution.
+ * 3. Neither the name of Sony Semiconductor Solutions Corporation nor
+ *    the names of its contributors may be used to endorse or promote
+ *    products derived from this software without specific prior written
+ *    permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+ * FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE
+ * COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+ * INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,
+ * BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS
+ * OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED
+ * AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ * LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN
+ * ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ *
+ ****************************************************************************/
+
+/****************************************************************************
+ * Included Files
+ ****************************************************************************/
+
+#include <nuttx/config.h>
+
+#include <stdint.h>
+#include <time.h>
+#include <fixedmath.h>
+
+#include <nuttx/arch.h>
+#include <nuttx/clock.h>
+
+#include "up_arch.h"
+#include "nvic.h"
+#include "dwt.h"
+#include "cxd56_clock.h"
+#include "cxd56_critmon.h"
+
+#ifdef HAVE_CXD56_CRITMON
+
+/****************************************************************************
+ * Public Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: cxd56_critmon_initialize
+ ****************************************************************************/
+
+void cxd56_critmon_initialize(void)
+{
+  /* This is called before the OS is started, so modifyreg32() cannot be
+   * used.
+   */
+
+  putreg32(getreg32(NVIC_DEMCR) | NVIC_DEMCR_TRCENA, NVIC_DEMCR);
+  putreg32(getreg32(DWT_CTRL) | DWT_CTRL_CYCCNTENA_MASK, DWT_CTRL);
+}
+
+/****************************************************************************
+ * Name: up_critmon_gettime
+ ****************************************************************************/
+
+uint32_t up_critmon_gettime(void)
+{
+  return getreg32(DWT_CYCCNT);
+}
+
+/****************************************************************************
+ * Name: up_critmon_convert
+ *
+ * Description:
+ *   Convert a number of CPU cycles into a time.  The current CPU clock is
+ *   used, so the result is approximate if the clock was changed while the
+ *   cycles were counted.
+ *
+ ****************************************************************************/
+
+void up_critmon_convert(uint32_t elapsed, FAR struct timespec *ts)
+{
+  uint32_t freq = cxd56_get_cpu_baseclk();
+  b32_t b32elapsed;
+
+  if (freq == 0)
+    {
+      ts->tv_sec  = 0;
+      ts->tv_nsec = 0;
+      return;
+    }
+
+  b32elapsed  = itob32(elapsed) / freq;
+  ts->tv_sec  = b32toi(b32elapsed);
+  ts->tv_nsec = NSEC_PER_SEC * b32frac(b32elapsed) / b32ONE;
+}
+
+#endif /* HAVE_CXD56_CRITMON */
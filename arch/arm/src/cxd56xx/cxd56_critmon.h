@@ -0,0 +1,79 @@
+/****************************************************************************
+ * arch/arm/src/cxd56xx/cxd56_critmon.h
+ *
+ *   Copyright 2020 Sony Semiconductor Solutions Corporation
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in
+ *    the documentation and/or other materials provided with the
+ *    distribution.
+ * 3. Neither the name of Sony Semiconductor Solutions Corporation nor
+ *    the names of its contributors may be used to endorse or promote
+ *    products derived from this software without specific prior written
+ *    permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+ * FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE
+ * COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+ * INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,
+ * BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS
+ * OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED
+ * AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ * LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN
+ * ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ *
+ ****************************************************************************/
+
+#ifndef __ARCH_ARM_SRC_CXD56XX_CXD56_CRITMON_H
+#define __ARCH_ARM_SRC_CXD56XX_CXD56_CRITMON_H
+
+/****************************************************************************
+ * Included Files
+ ****************************************************************************/
+
+#include <nuttx/config.h>
+
+/****************************************************************************
+ * Pre-processor Definitions
+ ****************************************************************************/
+
+/* up_critmon_gettime() and up_critmon_convert() are needed by these
+ * features.  They are based on the DWT cycle counter of each CPU.
+ */
+
+#if defined(CONFIG_SCHED_CRITMONITOR) || \
+    defined(CONFIG_SCHED_IRQMONITOR_TIMING) || \
+    defined(CONFIG_SCHED_LATENCY) || \
+    defined(CONFIG_SCHED_CPULOAD_CYCLES)
+#  define HAVE_CXD56_CRITMON 1
+#endif
+
+/****************************************************************************
+ * Public Function Prototypes
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: cxd56_critmon_initialize
+ *
+ * Description:
+ *   Start the DWT cycle counter of the calling CPU.  Each CPU has its own
+ *   counter, so this must be called on every CPU as it starts.
+ *
+ ****************************************************************************/
+
+#ifdef HAVE_CXD56_CRITMON
+void cxd56_critmon_initialize(void);
+#else
+#  define cxd56_critmon_initialize()
+#endif
+
+#endif /* __ARCH_ARM_SRC_CXD56XX_CXD56_CRITMON_H */
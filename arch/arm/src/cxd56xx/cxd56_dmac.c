@@ -172,10 +172,6 @@ typedef struct {
 #define CXD56_DMAC_MASTER1 0 /**< AHB master 1 */
 #define CXD56_DMAC_MASTER2 1 /**< AHB master 2 */
 
-/* max transfer size at a time */
-
-#define CXD56_DMAC_MAX_SIZE 0xfff
-
 /**
  * Helper macro for construct transfer control parameter.
  * Each parameters are the same with PD_DmacSetControl().
@@ -280,6 +276,7 @@ struct dma_channel_s
   bool inuse;                    /* TRUE: The DMA channel is in use */
   dma_config_t config;           /* Current configuration */
   dmac_lli_t * list;             /* Link list */
+  int nlist;                     /* Number of entries in the link list */
   dma_callback_t callback;       /* Callback invoked when the DMA completes */
   void *arg;                     /* Argument passed to callback function */
   unsigned int dummy;            /* Dummy buffer */
@@ -294,6 +291,15 @@ struct dma_channel_s
 static struct dma_channel_s g_dmach[NCHANNELS];
 static sem_t g_dmaexc;
 
+#ifdef CONFIG_CXD56_DMAC_MEMCPY
+/* Channel for cxd56_dmamemcpy(), opened on first use */
+
+static DMA_HANDLE g_memcpy_handle;
+static sem_t g_memcpy_lock;
+static sem_t g_memcpy_done;
+static int g_memcpy_status;
+#endif
+
 static int dma_init(int ch);
 static int dma_uninit(int ch);
 static int dma_open(int ch);
@@ -676,6 +682,12 @@ void weak_function up_dma_initialize(void)
     }
 
   nxsem_init(&g_dmaexc, 0, 1);
+
+#ifdef CONFIG_CXD56_DMAC_MEMCPY
+  nxsem_init(&g_memcpy_lock, 0, 1);
+  nxsem_init(&g_memcpy_done, 0, 0);
+  nxsem_setprotocol(&g_memcpy_done, SEM_PRIO_NONE);
+#endif
 }
 
 /****************************************************************************
@@ -745,6 +757,8 @@ DMA_HANDLE cxd56_dmachannel(int ch, ssize_t maxsize)
       goto err;
     }
 
+  dmach->nlist = n;
+
   /* Initialize hardware */
 
   dma_init(dmach->chan);
@@ -881,6 +895,383 @@ void cxd56_rxdmasetup(DMA_HANDLE handle, uintptr_t paddr, uintptr_t maddr,
   dma_setconfig(dmach->chan, 1, 1, CXD56_DMAC_P2M, 0, peri);
 }
 
+/****************************************************************************
+ * Name: cxd56_rxdmasetup_circular
+ *
+ * Description:
+ *   Configure an RX (peripheral-to-memory) DMA that runs until stopped,
+ *   wrapping back to the start of 'maddr' after 'nbytes'.  The buffer is
+ *   split into at least two link list items and the callback is invoked
+ *   (with CXD56_DMA_INTR_ITC) as each one completes, so the half-transfer
+ *   and full-transfer points of a two-item ring both interrupt.
+ *
+ * Input Parameters:
+ *   paddr  - Peripheral address (source)
+ *   maddr  - Memory address (destination)
+ *   nbytes - Size of the circular buffer in bytes.  Must be even.
+ *   config - Channel configuration selections
+ *
+ * Returned Value:
+ *   Zero on success; -ENOMEM if the link list could not be grown.
+ *
+ ****************************************************************************/
+
+int cxd56_rxdmasetup_circular(DMA_HANDLE handle, uintptr_t paddr,
+                              uintptr_t maddr, size_t nbytes,
+                              dma_config_t config)
+{
+  struct dma_channel_s *dmach = (struct dma_channel_s *)handle;
+  size_t chunk;
+  size_t rest;
+  uintptr_t dst;
+  int list_num;
+  int peri;
+  int i;
+
+  DEBUGASSERT(dmach != NULL && dmach->inuse && maddr != 0);
+  DEBUGASSERT(nbytes >= 2 && (nbytes & 1) == 0);
+
+  list_num = (nbytes + CXD56_DMAC_MAX_SIZE - 1) / CXD56_DMAC_MAX_SIZE;
+  if (list_num < 2)
+    {
+      list_num = 2;
+    }
+
+  if (cxd56_dmareserve(handle, list_num) < 0)
+    {
+      return -ENOMEM;
+    }
+
+  /* Equal sized items, so that two items split the buffer in half */
+
+  chunk = (nbytes + list_num - 1) / list_num;
+  dst   = maddr;
+  rest  = nbytes;
+
+  for (i = 0; i < list_num; i++)
+    {
+      if (chunk > rest)
+        {
+          chunk = rest;
+        }
+
+      dmach->list[i].src_addr = paddr;
+      dmach->list[i].dest_addr = dst;
+      dmach->list[i].nextlli = (uint32_t)&dmach->list[(i + 1) % list_num];
+      dmach->list[i].control = DMAC_EX_CTRL_HELPER(1, 1, 0,            /* interrupt / Dest inc / Src inc */
+                               CXD56_DMAC_MASTER1, CXD56_DMAC_MASTER2, /* AHB dst master / AHB src master (fixed) */
+                               config.dest_width, config.src_width,    /* Dest / Src transfer width */
+                               CXD56_DMAC_BSIZE1, CXD56_DMAC_BSIZE1,   /* Single transfers, nothing left in FIFO */
+                               chunk);
+
+      dst  += chunk;
+      rest -= chunk;
+    }
+
+  peri = config.channel_cfg & CXD56_DMA_PERIPHERAL_MASK;
+  dma_setconfig(dmach->chan, 1, 1, CXD56_DMAC_P2M, 0, peri);
+  return OK;
+}
+
+/****************************************************************************
+ * Name: cxd56_dmareserve
+ *
+ * Description:
+ *   Make room for 'nitems' link list items.
+ *
+ ****************************************************************************/
+
+int cxd56_dmareserve(DMA_HANDLE handle, int nitems)
+{
+  struct dma_channel_s *dmach = (struct dma_channel_s *)handle;
+  dmac_lli_t *list;
+
+  DEBUGASSERT(dmach != NULL && dmach->inuse);
+
+  if (nitems > dmach->nlist)
+    {
+      list = (dmac_lli_t *)kmm_realloc(dmach->list,
+                                       nitems * sizeof(dmac_lli_t));
+      if (list == NULL)
+        {
+          return -ENOMEM;
+        }
+
+      dmach->list  = list;
+      dmach->nlist = nitems;
+    }
+
+  return OK;
+}
+
+/****************************************************************************
+ * Name: dma_setup_sg
+ *
+ * Description:
+ *   Build one link list over a list of memory buffers.  Only the last item
+ *   interrupts.
+ *
+ ****************************************************************************/
+
+static int dma_setup_sg(struct dma_channel_s *dmach, uintptr_t paddr,
+                        const struct cxd56_dmasg_s *sg, int nsg,
+                        dma_config_t config, bool rx)
+{
+  dmac_lli_t *lli = NULL;
+  uintptr_t maddr;
+  size_t rest;
+  size_t size;
+  int n = 0;
+  int inc;
+  int i;
+  int peri;
+
+  DEBUGASSERT(dmach != NULL && dmach->inuse && nsg > 0);
+
+  for (i = 0; i < nsg; i++)
+    {
+      n += CXD56_DMAC_NITEMS(sg[i].nbytes);
+    }
+
+  if (n > dmach->nlist)
+    {
+      return -ENOMEM;
+    }
+
+  n = 0;
+  for (i = 0; i < nsg; i++)
+    {
+      maddr = sg[i].maddr ? sg[i].maddr : (uintptr_t)&dmach->dummy;
+      inc   = sg[i].maddr ? 1 : 0;
+      rest  = sg[i].nbytes;
+
+      while (rest > 0)
+        {
+          size = rest > CXD56_DMAC_MAX_SIZE ? CXD56_DMAC_MAX_SIZE : rest;
+          lli  = &dmach->list[n++];
+
+          if (rx)
+            {
+              lli->src_addr  = paddr;
+              lli->dest_addr = maddr;
+              lli->control   = DMAC_EX_CTRL_HELPER(0, inc, 0,
+                                 CXD56_DMAC_MASTER1, CXD56_DMAC_MASTER2,
+                                 config.dest_width, config.src_width,
+                                 CXD56_DMAC_BSIZE4, CXD56_DMAC_BSIZE4,
+                                 size);
+            }
+          else
+            {
+              lli->src_addr  = maddr;
+              lli->dest_addr = paddr;
+              lli->control   = DMAC_EX_CTRL_HELPER(0, 0, inc,
+                                 CXD56_DMAC_MASTER2, CXD56_DMAC_MASTER1,
+                                 config.dest_width, config.src_width,
+                                 CXD56_DMAC_BSIZE1, CXD56_DMAC_BSIZE1,
+                                 size);
+            }
+
+          lli->nextlli = (uint32_t)&dmach->list[n];
+
+          if (inc)
+            {
+              maddr += size << (rx ? config.dest_width : config.src_width);
+            }
+
+          rest -= size;
+        }
+    }
+
+  /* Terminate the list and interrupt when its last item completes */
+
+  DEBUGASSERT(lli != NULL);
+  lli->nextlli  = 0;
+  lli->control |= 1u << 31;
+
+  peri = config.channel_cfg & CXD56_DMA_PERIPHERAL_MASK;
+  if (rx)
+    {
+      dma_setconfig(dmach->chan, 1, 1, CXD56_DMAC_P2M, 0, peri);
+    }
+  else
+    {
+      dma_setconfig(dmach->chan, 1, 1, CXD56_DMAC_M2P, peri, 0);
+    }
+
+  return OK;
+}
+
+/****************************************************************************
+ * Name: cxd56_rxdmasetup_sg
+ *
+ * Description:
+ *   Configure a scatter/gather RX (peripheral-to-memory) DMA.
+ *
+ ****************************************************************************/
+
+int cxd56_rxdmasetup_sg(DMA_HANDLE handle, uintptr_t paddr,
+                        const struct cxd56_dmasg_s *sg, int nsg,
+                        dma_config_t config)
+{
+  return dma_setup_sg((struct dma_channel_s *)handle, paddr, sg, nsg,
+                      config, true);
+}
+
+/****************************************************************************
+ * Name: cxd56_txdmasetup_sg
+ *
+ * Description:
+ *   Configure a scatter/gather TX (memory-to-peripheral) DMA.
+ *
+ ****************************************************************************/
+
+int cxd56_txdmasetup_sg(DMA_HANDLE handle, uintptr_t paddr,
+                        const struct cxd56_dmasg_s *sg, int nsg,
+                        dma_config_t config)
+{
+  return dma_setup_sg((struct dma_channel_s *)handle, paddr, sg, nsg,
+                      config, false);
+}
+
+/****************************************************************************
+ * Name: cxd56_m2mdmasetup
+ *
+ * Description:
+ *   Configure a memory-to-memory DMA.
+ *
+ ****************************************************************************/
+
+int cxd56_m2mdmasetup(DMA_HANDLE handle, uintptr_t dest, uintptr_t src,
+                      size_t nbytes)
+{
+  struct dma_channel_s *dmach = (struct dma_channel_s *)handle;
+  dmac_lli_t *lli = NULL;
+  size_t count;
+  size_t size;
+  int width;
+  int n;
+
+  DEBUGASSERT(dmach != NULL && dmach->inuse && nbytes > 0);
+
+  if (ch2dmac(dmach->chan) != 3)
+    {
+      return -EINVAL;
+    }
+
+  if (((dest | src | nbytes) & 3) == 0)
+    {
+      width = CXD56_DMAC_WIDTH32;
+      count = nbytes >> 2;
+    }
+  else
+    {
+      width = CXD56_DMAC_WIDTH8;
+      count = nbytes;
+    }
+
+  if (cxd56_dmareserve(handle, CXD56_DMAC_NITEMS(count)) < 0)
+    {
+      return -ENOMEM;
+    }
+
+  for (n = 0; count > 0; n++)
+    {
+      size = count > CXD56_DMAC_MAX_SIZE ? CXD56_DMAC_MAX_SIZE : count;
+      lli  = &dmach->list[n];
+
+      lli->src_addr  = src;
+      lli->dest_addr = dest;
+      lli->nextlli   = (uint32_t)&dmach->list[n + 1];
+      lli->control   = DMAC_EX_CTRL_HELPER(0, 1, 1,
+                         CXD56_DMAC_MASTER1, CXD56_DMAC_MASTER1,
+                         width, width,
+                         CXD56_DMAC_BSIZE4, CXD56_DMAC_BSIZE4,
+                         size);
+
+      src   += size << width;
+      dest  += size << width;
+      count -= size;
+    }
+
+  /* Terminate the list and interrupt when its last item completes */
+
+  lli->nextlli  = 0;
+  lli->control |= 1u << 31;
+
+  dma_setconfig(dmach->chan, 1, 1, CXD56_DMAC_M2M, 0, 0);
+  return OK;
+}
+
+#ifdef CONFIG_CXD56_DMAC_MEMCPY
+static void dma_memcpy_done(DMA_HANDLE handle, uint8_t status, void *arg)
+{
+  g_memcpy_status = (status & CXD56_DMA_INTR_ERR) ? -EIO : OK;
+  nxsem_post(&g_memcpy_done);
+}
+
+/****************************************************************************
+ * Name: cxd56_dmamemcpy
+ *
+ * Description:
+ *   Copy memory with DMA and wait for completion.
+ *
+ ****************************************************************************/
+
+int cxd56_dmamemcpy(FAR void *dest, FAR const void *src, size_t nbytes)
+{
+  int ret;
+
+  if (nbytes < CONFIG_CXD56_DMAC_MEMCPY_THRESHOLD)
+    {
+      memcpy(dest, src, nbytes);
+      return OK;
+    }
+
+  nxsem_wait_uninterruptible(&g_memcpy_lock);
+
+  if (g_memcpy_handle == NULL)
+    {
+      g_memcpy_handle = cxd56_dmachannel(CONFIG_CXD56_DMAC_MEMCPY_CH,
+                                         nbytes);
+    }
+
+  if (g_memcpy_handle == NULL ||
+      cxd56_m2mdmasetup(g_memcpy_handle, (uintptr_t)dest, (uintptr_t)src,
+                        nbytes) < 0)
+    {
+      memcpy(dest, src, nbytes);
+      nxsem_post(&g_memcpy_lock);
+      return OK;
+    }
+
+  cxd56_dmastart(g_memcpy_handle, dma_memcpy_done, NULL);
+  nxsem_wait_uninterruptible(&g_memcpy_done);
+  ret = g_memcpy_status;
+
+  nxsem_post(&g_memcpy_lock);
+  return ret;
+}
+#endif
+
+/****************************************************************************
+ * Name: cxd56_dmadstaddr
+ *
+ * Description:
+ *   Return the memory address that a running DMA will write next.
+ *
+ ****************************************************************************/
+
+uintptr_t cxd56_dmadstaddr(DMA_HANDLE handle)
+{
+  struct dma_channel_s *dmach = (struct dma_channel_s *)handle;
+  struct dmac_ch_register_map *channel;
+
+  DEBUGASSERT(dmach && dmach->inuse);
+
+  channel = get_channel(dmach->chan);
+  return channel ? channel->destaddr : 0;
+}
+
 /****************************************************************************
  * Name: cxd56_txdmasetup
  *
@@ -60,10 +60,24 @@
 #define CXD56_DMAC_WIDTH16  1      /**< 16 bit width */
 #define CXD56_DMAC_WIDTH32  2      /**< 32 bit width */
 
+/* Max transfers per link list item, and items needed for n transfers */
+
+#define CXD56_DMAC_MAX_SIZE 0xfff
+#define CXD56_DMAC_NITEMS(n) \
+  (((n) + CXD56_DMAC_MAX_SIZE - 1) / CXD56_DMAC_MAX_SIZE)
+
 /****************************************************************************
  * Public Types
  ****************************************************************************/
 
+/* One buffer of a scatter/gather transfer */
+
+struct cxd56_dmasg_s
+{
+  uintptr_t maddr;  /* Memory address, or 0 for a dummy (non-incrementing) */
+  size_t nbytes;    /* Number of transfers for this buffer */
+};
+
 /****************************************************************************
  * Public Data
  ****************************************************************************/
@@ -149,6 +163,122 @@ void cxd56_dmafree(DMA_HANDLE handle);
 void cxd56_rxdmasetup(DMA_HANDLE handle, uintptr_t paddr, uintptr_t maddr,
                       size_t nbytes, dma_config_t config);
 
+/****************************************************************************
+ * Name: cxd56_rxdmasetup_circular
+ *
+ * Description:
+ *   Configure an RX (peripheral-to-memory) DMA that wraps around 'maddr'
+ *   until it is stopped.  The callback is invoked at each half of the
+ *   buffer (more often for buffers larger than two link list items).
+ *
+ * Input Parameters:
+ *   paddr  - Peripheral address (source)
+ *   maddr  - Memory address of the circular buffer
+ *   nbytes - Size of the circular buffer in bytes.  Must be even.
+ *   config - Channel configuration selections
+ *
+ * Returned Value:
+ *   Zero on success; a negated errno value on failure.
+ *
+ ****************************************************************************/
+
+int cxd56_rxdmasetup_circular(DMA_HANDLE handle, uintptr_t paddr,
+                              uintptr_t maddr, size_t nbytes,
+                              dma_config_t config);
+
+/****************************************************************************
+ * Name: cxd56_dmareserve
+ *
+ * Description:
+ *   Make room for 'nitems' link list items so that a following
+ *   scatter/gather setup does not need to allocate memory.  This must be
+ *   called from task context.
+ *
+ * Returned Value:
+ *   Zero on success; -ENOMEM if the link list could not be grown.
+ *
+ ****************************************************************************/
+
+int cxd56_dmareserve(DMA_HANDLE handle, int nitems);
+
+/****************************************************************************
+ * Name: cxd56_rxdmasetup_sg / cxd56_txdmasetup_sg
+ *
+ * Description:
+ *   Configure an RX (peripheral-to-memory) or TX (memory-to-peripheral) DMA
+ *   that moves a list of buffers in one link list, interrupting only when
+ *   the last one completes.  The link list must already hold
+ *   CXD56_DMAC_NITEMS() of every buffer (see cxd56_dmareserve()), so these
+ *   may be called from interrupt handlers.
+ *
+ * Input Parameters:
+ *   paddr  - Peripheral address
+ *   sg     - The memory buffers, in order
+ *   nsg    - Number of entries in 'sg'
+ *   config - Channel configuration selections
+ *
+ * Returned Value:
+ *   Zero on success; -ENOMEM if the link list is too short.
+ *
+ ****************************************************************************/
+
+int cxd56_rxdmasetup_sg(DMA_HANDLE handle, uintptr_t paddr,
+                        const struct cxd56_dmasg_s *sg, int nsg,
+                        dma_config_t config);
+int cxd56_txdmasetup_sg(DMA_HANDLE handle, uintptr_t paddr,
+                        const struct cxd56_dmasg_s *sg, int nsg,
+                        dma_config_t config);
+
+/****************************************************************************
+ * Name: cxd56_m2mdmasetup
+ *
+ * Description:
+ *   Configure a memory-to-memory DMA.  32-bit transfers are used when
+ *   'dest', 'src' and 'nbytes' are all word aligned, byte transfers
+ *   otherwise.  The link list is grown as needed, so this must be called
+ *   from task context.  Only channels 2-6 support memory-to-memory.
+ *
+ * Input Parameters:
+ *   dest   - Destination memory address
+ *   src    - Source memory address
+ *   nbytes - Number of bytes to copy
+ *
+ * Returned Value:
+ *   Zero on success; a negated errno value on failure.
+ *
+ ****************************************************************************/
+
+int cxd56_m2mdmasetup(DMA_HANDLE handle, uintptr_t dest, uintptr_t src,
+                      size_t nbytes);
+
+/****************************************************************************
+ * Name: cxd56_dmamemcpy
+ *
+ * Description:
+ *   Copy memory with the DMA channel CONFIG_CXD56_DMAC_MEMCPY_CH and wait
+ *   for completion.  Copies shorter than CONFIG_CXD56_DMAC_MEMCPY_THRESHOLD
+ *   bytes, or copies requested while the channel cannot be opened, use
+ *   memcpy() instead.  Must be called from task context.
+ *
+ * Returned Value:
+ *   Zero on success; a negated errno value on failure.
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_CXD56_DMAC_MEMCPY
+int cxd56_dmamemcpy(FAR void *dest, FAR const void *src, size_t nbytes);
+#endif
+
+/****************************************************************************
+ * Name: cxd56_dmadstaddr
+ *
+ * Description:
+ *   Return the memory address that a running DMA will write next.
+ *
+ ****************************************************************************/
+
+uintptr_t cxd56_dmadstaddr(DMA_HANDLE handle);
+
 /****************************************************************************
  * Name: cxd56_txdmasetup
  *
@@ -0,0 +1,332 @@
+/****************************************************************************
+ * arch/arm/src/cxd56xx/cxd56_dvfs.c
+ *
+ *   Copyright 2018 Sony Semiconductor Solutions Corporation
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in
+ *    the documentation and/or other materials provided with the
+ *    distribution.
+ * 3. Neither the name of Sony Semiconductor Solutions Corporation nor
+ *    the names of its contributors may be used to endorse or promote
+ *    products derived from this software without specific prior written
+ *    permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+ * FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE
+ * COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+ * INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,
+ * BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS
+ * OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED
+ * AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ * LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN
+ * ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ *
+ ****************************************************************************/
+
+/****************************************************************************
+ * Included Files
+ ****************************************************************************/
+
+#include <nuttx/config.h>
+
+#include <stdint.h>
+#include <stdbool.h>
+#include <errno.h>
+#include <debug.h>
+
+#include <nuttx/arch.h>
+#include <nuttx/clock.h>
+#include <nuttx/irq.h>
+#include <nuttx/kthread.h>
+#include <nuttx/semaphore.h>
+
+#include <arch/chip/pm.h>
+
+#include "cxd56_dvfs.h"
+
+#ifdef CONFIG_CXD56_DVFS
+
+/****************************************************************************
+ * Pre-processor Definitions
+ ****************************************************************************/
+
+#ifdef CONFIG_SMP
+#  define DVFS_NCPUS CONFIG_SMP_NCPUS
+#else
+#  define DVFS_NCPUS 1
+#endif
+
+#if CONFIG_CXD56_DVFS_DOWN_THRESHOLD >= CONFIG_CXD56_DVFS_UP_THRESHOLD
+#  error "CXD56_DVFS_DOWN_THRESHOLD must be below CXD56_DVFS_UP_THRESHOLD"
+#endif
+
+/****************************************************************************
+ * Private Data
+ ****************************************************************************/
+
+static struct pm_cpu_freqlock_s g_dvfs_lvlock =
+  PM_CPUFREQLOCK_INIT(PM_CPUFREQLOCK_TAG('D', 'V', 0),
+                      PM_CPUFREQLOCK_FLAG_LV);
+static struct pm_cpu_freqlock_s g_dvfs_hvlock =
+  PM_CPUFREQLOCK_INIT(PM_CPUFREQLOCK_TAG('D', 'V', 1),
+                      PM_CPUFREQLOCK_FLAG_HV);
+
+static sem_t g_dvfs_wakeup;
+static volatile int g_dvfs_level;
+static volatile clock_t g_dvfs_boostend;
+static volatile bool g_dvfs_boosted;
+
+/* Idle thread load at the previous sample, per CPU */
+
+static struct cpuload_s g_dvfs_idle[DVFS_NCPUS];
+
+/****************************************************************************
+ * Private Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: dvfs_busy
+ *
+ * Description:
+ *   Return the busy percentage of a CPU since the previous sample, from the
+ *   load of its IDLE thread.  The load counters are halved periodically by
+ *   the scheduler; across such a step the decayed ratio is used instead.
+ *
+ ****************************************************************************/
+
+static int dvfs_busy(int cpu)
+{
+  FAR struct cpuload_s *prev = &g_dvfs_idle[cpu];
+  struct cpuload_s load;
+  uint32_t total;
+  uint32_t idle;
+
+  /* The IDLE thread of CPU n has PID n */
+
+  if (clock_cpuload(cpu, &load) < 0)
+    {
+      return 0;
+    }
+
+  if (load.total > prev->total && load.active >= prev->active)
+    {
+      total = load.total - prev->total;
+      idle  = load.active - prev->active;
+    }
+  else
+    {
+      total = load.total;
+      idle  = load.active;
+    }
+
+  *prev = load;
+
+  if (total == 0 || idle >= total)
+    {
+      return 0;
+    }
+
+  return (int)(100 - (idle * 100) / total);
+}
+
+/****************************************************************************
+ * Name: dvfs_setlevel
+ *
+ * Description:
+ *   Hold the frequency lock for the new level.  The new lock is taken
+ *   before the old one is dropped, so the clock never dips in between.
+ *
+ ****************************************************************************/
+
+static void dvfs_setlevel(int level)
+{
+  int old = g_dvfs_level;
+
+  if (level == old)
+    {
+      return;
+    }
+
+  if (level == CXD56_DVFS_LEVEL_HV)
+    {
+      up_pm_acquire_freqlock(&g_dvfs_hvlock);
+    }
+  else if (level == CXD56_DVFS_LEVEL_LV)
+    {
+      up_pm_acquire_freqlock(&g_dvfs_lvlock);
+    }
+
+  if (old == CXD56_DVFS_LEVEL_HV)
+    {
+      up_pm_release_freqlock(&g_dvfs_hvlock);
+    }
+  else if (old == CXD56_DVFS_LEVEL_LV)
+    {
+      up_pm_release_freqlock(&g_dvfs_lvlock);
+    }
+
+  g_dvfs_level = level;
+  pwrinfo("DVFS level %d -> %d\n", old, level);
+}
+
+/****************************************************************************
+ * Name: dvfs_thread
+ *
+ * Description:
+ *   Sample the load every CONFIG_CXD56_DVFS_PERIOD milliseconds.  The
+ *   busiest CPU decides.  At or above the up threshold the governor jumps
+ *   straight to the highest level, so bursts finish quickly and the CPUs
+ *   can return to idle.  It steps down one level at a time, and only after
+ *   the load has stayed below the down threshold for
+ *   CONFIG_CXD56_DVFS_DOWN_HOLD consecutive samples.
+ *
+ ****************************************************************************/
+
+static int dvfs_thread(int argc, FAR char *argv[])
+{
+  irqstate_t flags;
+  bool boosted;
+  int below = 0;
+  int level;
+  int busy;
+  int cpu;
+  int i;
+
+  for (; ; )
+    {
+      nxsem_tickwait_uninterruptible(&g_dvfs_wakeup, clock_systimer(),
+                                     MSEC2TICK(CONFIG_CXD56_DVFS_PERIOD));
+
+      flags = enter_critical_section();
+      if (g_dvfs_boosted &&
+          (sclock_t)(g_dvfs_boostend - clock_systimer()) <= 0)
+        {
+          g_dvfs_boosted = false;
+        }
+
+      boosted = g_dvfs_boosted;
+      leave_critical_section(flags);
+
+      busy = 0;
+      for (i = 0; i < DVFS_NCPUS; i++)
+        {
+          cpu = dvfs_busy(i);
+          if (cpu > busy)
+            {
+              busy = cpu;
+            }
+        }
+
+      level = g_dvfs_level;
+
+      if (boosted || busy >= CONFIG_CXD56_DVFS_UP_THRESHOLD)
+        {
+          level = CXD56_DVFS_LEVEL_HV;
+          below = 0;
+        }
+      else if (busy < CONFIG_CXD56_DVFS_DOWN_THRESHOLD)
+        {
+          if (++below >= CONFIG_CXD56_DVFS_DOWN_HOLD &&
+              level > CXD56_DVFS_LEVEL_LOW)
+            {
+              level--;
+              below = 0;
+            }
+        }
+      else
+        {
+          below = 0;
+        }
+
+      dvfs_setlevel(level);
+    }
+
+  return OK;
+}
+
+/****************************************************************************
+ * Public Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: cxd56_dvfs_initialize
+ ****************************************************************************/
+
+int cxd56_dvfs_initialize(void)
+{
+  int ret;
+
+  nxsem_init(&g_dvfs_wakeup, 0, 0);
+  nxsem_setprotocol(&g_dvfs_wakeup, SEM_PRIO_NONE);
+
+  /* Start at the top; the governor comes down once the load allows */
+
+  g_dvfs_level = CXD56_DVFS_LEVEL_LOW;
+  dvfs_setlevel(CXD56_DVFS_LEVEL_HV);
+
+  ret = kthread_create("cxd56_dvfs", CONFIG_CXD56_DVFS_PRIORITY,
+                       CONFIG_CXD56_DVFS_STACKSIZE,
+                       (main_t)dvfs_thread, NULL);
+  if (ret < 0)
+    {
+      pwrerr("ERROR: Failed to start the DVFS governor: %d\n", ret);
+      dvfs_setlevel(CXD56_DVFS_LEVEL_LOW);
+      nxsem_destroy(&g_dvfs_wakeup);
+      return ret;
+    }
+
+  return OK;
+}
+
+/****************************************************************************
+ * Name: cxd56_dvfs_boost
+ ****************************************************************************/
+
+void cxd56_dvfs_boost(uint32_t ms)
+{
+  irqstate_t flags;
+  clock_t end;
+  bool wakeup;
+
+  end = clock_systimer() + MSEC2TICK(ms);
+
+  flags = enter_critical_section();
+
+  if (!g_dvfs_boosted || (sclock_t)(end - g_dvfs_boostend) > 0)
+    {
+      g_dvfs_boostend = end;
+    }
+
+  wakeup = !g_dvfs_boosted && g_dvfs_level != CXD56_DVFS_LEVEL_HV;
+  g_dvfs_boosted = true;
+
+  leave_critical_section(flags);
+
+  /* Raise the clock now rather than at the next sample */
+
+  if (wakeup)
+    {
+      nxsem_post(&g_dvfs_wakeup);
+    }
+}
+
+/****************************************************************************
+ * Name: cxd56_dvfs_getlevel
+ ****************************************************************************/
+
+int cxd56_dvfs_getlevel(void)
+{
+  return g_dvfs_level;
+}
+
+#endif /* CONFIG_CXD56_DVFS */
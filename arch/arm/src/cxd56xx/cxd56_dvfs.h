@@ -0,0 +1,122 @@
+/****************************************************************************
+ * arch/arm/src/cxd56xx/cxd56_dvfs.h
+ *
+ *   Copyright 2018 Sony Semiconductor Solutions Corporation
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in
+ *    the documentation and/or other materials provided with the
+ *    distribution.
+ * 3. Neither the name of Sony Semiconductor Solutions Corporation nor
+ *    the names of its contributors may be used to endorse or promote
+ *    products derived from this software without specific prior written
+ *    permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+ * FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE
+ * COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+ * INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,
+ * BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS
+ * OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED
+ * AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ * LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN
+ * ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ *
+ ****************************************************************************/
+
+#ifndef __ARCH_ARM_SRC_CXD56XX_CXD56_DVFS_H
+#define __ARCH_ARM_SRC_CXD56XX_CXD56_DVFS_H
+
+/****************************************************************************
+ * Included Files
+ ****************************************************************************/
+
+#include <nuttx/config.h>
+
+#include <stdint.h>
+
+#ifdef CONFIG_CXD56_DVFS
+
+/****************************************************************************
+ * Pre-processor Definitions
+ ****************************************************************************/
+
+/* Governor levels, lowest clock first */
+
+#define CXD56_DVFS_LEVEL_LOW   0  /* No frequency lock held */
+#define CXD56_DVFS_LEVEL_LV    1  /* Low voltage frequency lock held */
+#define CXD56_DVFS_LEVEL_HV    2  /* High voltage frequency lock held */
+
+/****************************************************************************
+ * Public Function Prototypes
+ ****************************************************************************/
+
+#ifndef __ASSEMBLY__
+
+#undef EXTERN
+#if defined(__cplusplus)
+#define EXTERN extern "C"
+extern "C"
+{
+#else
+#define EXTERN extern
+#endif
+
+/****************************************************************************
+ * Name: cxd56_dvfs_initialize
+ *
+ * Description:
+ *   Start the governor thread.  The clock is raised and lowered by holding
+ *   the HV or LV frequency lock according to the load of the CPUs, so the
+ *   board must not pin the frequency itself (CONFIG_CPUFREQ_RELEASE_LOCK).
+ *
+ * Returned Value:
+ *   Zero (OK) is returned on success.  Otherwise, a negated errno value is
+ *   returned.
+ *
+ ****************************************************************************/
+
+int cxd56_dvfs_initialize(void);
+
+/****************************************************************************
+ * Name: cxd56_dvfs_boost
+ *
+ * Description:
+ *   Run at the highest level for at least the next ms milliseconds without
+ *   waiting for the load to show it.  This is the latency cap for work
+ *   whose deadline is shorter than the governor's reaction time, e.g. a
+ *   driver about to service a burst or a task woken for a real-time job.
+ *   Boosts do not nest; the latest deadline wins.  Callable from interrupt
+ *   handlers.
+ *
+ ****************************************************************************/
+
+void cxd56_dvfs_boost(uint32_t ms);
+
+/****************************************************************************
+ * Name: cxd56_dvfs_getlevel
+ *
+ * Description:
+ *   Return the current governor level, CXD56_DVFS_LEVEL_*.
+ *
+ ****************************************************************************/
+
+int cxd56_dvfs_getlevel(void);
+
+#undef EXTERN
+#if defined(__cplusplus)
+}
+#endif
+
+#endif /* __ASSEMBLY__ */
+#endif /* CONFIG_CXD56_DVFS */
+#endif /* __ARCH_ARM_SRC_CXD56XX_CXD56_DVFS_H */
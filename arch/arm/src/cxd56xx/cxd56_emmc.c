@@ -86,6 +86,15 @@
 #define EMMC_MSIZE                (6)         /* Burst size is 512B */
 #define EMMC_FIFO_DEPTH           (0x100)     /* FIFO size is 1KB */
 
+/* Each DMA descriptor covers up to one 4KB buffer.  Longer transfers are
+ * split into commands of at most EMMC_MAX_SECTORS sectors.
+ */
+
+#define EMMC_DESC_BYTES           (4096)
+#define EMMC_MAX_DESCS            CONFIG_CXD56_EMMC_DMA_NDESCS
+#define EMMC_MAX_SECTORS          (EMMC_MAX_DESCS * EMMC_DESC_BYTES / \
+                                   SECTOR_SIZE)
+
 #ifndef MIN
 #define MIN(a, b) ((a) < (b) ? (a) : (b))
 #endif
@@ -151,6 +160,10 @@ static const struct block_operations g_bops =
 static sem_t g_waitsem;
 struct cxd56_emmc_state_s g_emmcdev;
 
+/* DMA descriptor chain, used under excsem */
+
+static struct emmc_dma_desc_s g_descs[EMMC_MAX_DESCS];
+
 /****************************************************************************
  * Private Functions
  ****************************************************************************/
@@ -288,7 +301,7 @@ static struct emmc_dma_desc_s *emmc_setupdma(void *buf, unsigned int nbytes)
 {
   int i;
   int ndescs;
-  struct emmc_dma_desc_s *descs;
+  struct emmc_dma_desc_s *descs = g_descs;
   struct emmc_dma_desc_s  *d;
   uint32_t addr;
   uint32_t size;
@@ -299,15 +312,13 @@ static struct emmc_dma_desc_s *emmc_setupdma(void *buf, unsigned int nbytes)
       return NULL;
     }
 
-  ndescs = nbytes / 4096;
-  if ((nbytes & (4096 - 1)) != 0)
+  ndescs = nbytes / EMMC_DESC_BYTES;
+  if ((nbytes & (EMMC_DESC_BYTES - 1)) != 0)
     {
       ndescs++;
     }
 
-  descs = (struct emmc_dma_desc_s *)
-    kmm_malloc(ndescs * sizeof(struct emmc_dma_desc_s));
-  if (!descs)
+  if (ndescs > EMMC_MAX_DESCS)
     {
       return NULL;
     }
@@ -320,7 +331,7 @@ static struct emmc_dma_desc_s *emmc_setupdma(void *buf, unsigned int nbytes)
       d->ctrl = EMMC_IDMAC_DES0_OWN | EMMC_IDMAC_DES0_CH |
                 EMMC_IDMAC_DES0_DIC;
 
-      size = MIN(remain, 4096);
+      size = MIN(remain, EMMC_DESC_BYTES);
       d->size = size;
       d->addr = addr;
       d->next = (uint32_t)(uintptr_t)(d + 1);
@@ -370,13 +381,42 @@ static int emmc_checkresponse(void)
   return OK;
 }
 
+/****************************************************************************
+ * Name: emmc_waitready
+ *
+ * Description:
+ *   Wait while the card holds DAT0 busy, e.g. programming written data or
+ *   executing an R1b command.
+ *
+ ****************************************************************************/
+
+static void emmc_waitready(void)
+{
+  uint32_t status;
+
+  do
+    {
+      status = getreg32(EMMC_STATUS);
+    }
+  while (status & EMMC_STATUS_DATA_BUSY);
+}
+
 static void emmc_send(int datatype, uint32_t opcode, uint32_t arg,
                       int resptype)
 {
   uint32_t prev;
   uint32_t mask;
   uint32_t cmd;
-  uint32_t status;
+
+  /* The card is not waited for after a command but before the next one,
+   * so a write returns while the card is still programming.  SEND_STATUS
+   * is accepted by a busy card.
+   */
+
+  if (opcode != SEND_STATUS)
+    {
+      emmc_waitready();
+    }
 
   /* Get current interrupt mask, leave SDIO relative bits. */
 
@@ -445,14 +485,6 @@ static void emmc_send(int datatype, uint32_t opcode, uint32_t arg,
   /* Restore interrupt mask */
 
   putreg32(prev, EMMC_INTMASK);
-
-  /* Waiting for device ready */
-
-  do
-    {
-      status = getreg32(EMMC_STATUS);
-    }
-  while (status & EMMC_STATUS_DATA_BUSY);
 }
 
 static int emmc_is_powerup(void)
@@ -701,15 +733,16 @@ static int cxd56_emmc_readsectors(FAR struct cxd56_emmc_state_s *priv,
   uint32_t idsts;
   int ret = OK;
 
+  emmc_takesem(&priv->excsem);
+
   descs = emmc_setupdma(buf, nsectors * SECTOR_SIZE);
   if (!descs)
     {
       ferr("Building descriptor failed.\n");
-      return -ENOMEM;
+      ret = -EINVAL;
+      goto finish;
     }
 
-  emmc_takesem(&priv->excsem);
-
   putreg32(nsectors * SECTOR_SIZE, EMMC_BYTCNT);
   emmc_send(EMMC_NON_DATA, SET_BLOCK_COUNT, nsectors, EMMC_RESP_R1);
 
@@ -745,7 +778,6 @@ static int cxd56_emmc_readsectors(FAR struct cxd56_emmc_state_s *priv,
 
 finish:
   emmc_givesem(&priv->excsem);
-  kmm_free(descs);
 
   return ret;
 }
@@ -759,14 +791,15 @@ static int cxd56_emmc_writesectors(FAR struct cxd56_emmc_state_s *priv,
   uint32_t idsts;
   int ret = OK;
 
+  emmc_takesem(&priv->excsem);
+
   descs = emmc_setupdma((void *)buf, nsectors * SECTOR_SIZE);
   if (!descs)
     {
-      return -ENOMEM;
+      ret = -EINVAL;
+      goto finish;
     }
 
-  emmc_takesem(&priv->excsem);
-
   putreg32(nsectors * SECTOR_SIZE, EMMC_BYTCNT);
   emmc_send(EMMC_NON_DATA, SET_BLOCK_COUNT, nsectors, EMMC_RESP_R1);
 
@@ -816,7 +849,6 @@ static int cxd56_emmc_writesectors(FAR struct cxd56_emmc_state_s *priv,
 
 finish:
   emmc_givesem(&priv->excsem);
-  kmm_free(descs);
 
   return ret;
 }
@@ -858,6 +890,8 @@ static ssize_t cxd56_emmc_read(FAR struct inode *inode,
                                unsigned int nsectors)
 {
   FAR struct cxd56_emmc_state_s *priv;
+  unsigned int remain;
+  unsigned int n;
   int ret;
 
   DEBUGASSERT(inode && inode->i_private);
@@ -866,11 +900,19 @@ static ssize_t cxd56_emmc_read(FAR struct inode *inode,
   finfo("Read sector %d (%d sectors) to %p\n",
         start_sector, nsectors, buffer);
 
-  ret = cxd56_emmc_readsectors(priv, buffer, start_sector, nsectors);
-  if (ret)
+  for (remain = nsectors; remain > 0; remain -= n)
     {
-      ferr("Read sector failed. %d\n", ret);
-      return 0;
+      n = MIN(remain, EMMC_MAX_SECTORS);
+
+      ret = cxd56_emmc_readsectors(priv, buffer, start_sector, n);
+      if (ret)
+        {
+          ferr("Read sector failed. %d\n", ret);
+          return nsectors - remain;
+        }
+
+      buffer       += n * SECTOR_SIZE;
+      start_sector += n;
     }
 
   return nsectors;
@@ -883,6 +925,8 @@ static ssize_t cxd56_emmc_write(FAR struct inode *inode,
                                 unsigned int nsectors)
 {
   FAR struct cxd56_emmc_state_s *priv;
+  unsigned int remain;
+  unsigned int n;
   int ret;
 
   DEBUGASSERT(inode && inode->i_private);
@@ -891,11 +935,19 @@ static ssize_t cxd56_emmc_write(FAR struct inode *inode,
   finfo("Write %p to sector %d (%d sectors)\n", buffer,
         start_sector, nsectors);
 
-  ret = cxd56_emmc_writesectors(priv, buffer, start_sector, nsectors);
-  if (ret)
+  for (remain = nsectors; remain > 0; remain -= n)
     {
-      ferr("Write sector failed. %d\n", ret);
-      return 0;
+      n = MIN(remain, EMMC_MAX_SECTORS);
+
+      ret = cxd56_emmc_writesectors(priv, buffer, start_sector, n);
+      if (ret)
+        {
+          ferr("Write sector failed. %d\n", ret);
+          return nsectors - remain;
+        }
+
+      buffer       += n * SECTOR_SIZE;
+      start_sector += n;
     }
 
   return nsectors;
@@ -962,7 +1014,6 @@ int cxd56_emmcinitialize(void)
             }
 
           priv->total_sectors = *(FAR uint32_t *)&buf[EXTCSD_SEC_COUNT];
-          kmm_free(descs);
         }
 
       kmm_free(buf);
@@ -983,6 +1034,7 @@ int emmc_uninitialize(void)
   /* Send power off command */
 
   emmc_switchcmd(EXTCSD_PON, EXTCSD_PON_POWERED_OFF_LONG);
+  emmc_waitready();
 
   up_disable_irq(CXD56_IRQ_EMMC);
 
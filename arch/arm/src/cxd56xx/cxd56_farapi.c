@@ -42,6 +42,9 @@
 #include <nuttx/arch.h>
 #include <nuttx/sched.h>
 #include <nuttx/irq.h>
+#include <nuttx/semaphore.h>
+#include <queue.h>
+#include <string.h>
 #include <debug.h>
 #include <errno.h>
 
@@ -52,6 +55,7 @@
 #include "chip.h"
 #include "cxd56_icc.h"
 #include "cxd56_config.h"
+#include "cxd56_farapi.h"
 #include "cxd56_farapistub.h"
 #include "hardware/cxd5602_backupmem.h"
 
@@ -69,12 +73,18 @@ int fw_pm_wakeupcpu(int cpuid);
 
 #define CPU_ID (CXD56_CPU_BASE + 0x40)
 
+#define NCPUS  8
+
+#ifdef CONFIG_SCHED_LPWORK
+#  define FARAPI_WORK LPWORK
+#else
+#  define FARAPI_WORK HPWORK
+#endif
+
 /****************************************************************************
  * Private Type
  ****************************************************************************/
 
-typedef int farapicallback(void *data);
-
 struct modulelist_s
 {
   void   *mod;
@@ -83,39 +93,6 @@ struct modulelist_s
   int16_t mbxid;
 };
 
-struct apimsg_s
-{
-  int     id;
-  void   *arg;
-  int16_t mbxid;
-  int16_t flagid;
-  int     flagbitno;
-};
-
-struct farcallback_s
-{
-  int (*cbfunc)(void *);        /* pointer to callback function */
-  void *data;                   /* callback data */
-  int   flagbitno;              /* callback eventflag bitno */
-};
-
-struct farmsghead_s
-{
-  struct farmsghead_s *next;
-};
-
-struct farmsg_s
-{
-  struct farmsghead_s head;     /* message head */
-  int cpuid;                    /* CPU ID of API caller */
-  int modid;                    /* module table offset */
-  union
-  {
-    struct apimsg_s api;
-    struct farcallback_s cb;
-  } u;
-};
-
 /****************************************************************************
  * Public Data
  ****************************************************************************/
@@ -126,8 +103,21 @@ extern char Image$$MODLIST$$Base[];
  * Private Data
  ****************************************************************************/
 
-static sem_t g_farwait;
+/* The call in progress on each target CPU and the calls waiting for it */
+
+static FAR struct cxd56_farreq_s *g_farbusy[NCPUS];
+static sq_queue_t g_farqueue[NCPUS];
+static uint32_t g_farid;
+
+#ifdef CONFIG_CXD56_FARAPI_ASYNC
+/* Serializes cxd56_farapi_async() and marks the request it is submitting */
+
 static sem_t g_farlock;
+static FAR struct cxd56_farreq_s *g_farasync;
+static pid_t g_farowner;
+static int g_farasyncid;
+#endif
+
 static struct pm_cpu_wakelock_s g_wlock = {
   .count = 0,
   .info  = PM_CPUWAKELOCK_TAG('R', 'M', 0),
@@ -143,7 +133,7 @@ static int farapi_semtake(sem_t *id)
 }
 
 #ifdef CONFIG_CXD56_FARAPI_DEBUG
-static void dump_farapi_message(struct farmsg_s *msg)
+static void dump_farapi_message(struct farapi_msg_s *msg)
 {
   _info("cpuid : %d\n",    msg->cpuid);
   _info("modid : %d\n",    msg->modid);
@@ -171,10 +161,138 @@ static int cxd56_sendmsg(int cpuid, int protoid, int msgtype, uint16_t pdata,
   return cxd56_iccsend(protoid, &msg, 0);
 }
 
+/****************************************************************************
+ * Name: farapi_complete
+ *
+ * Description:
+ *   Finish a call.  Must be called with interrupts disabled.
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_CXD56_FARAPI_ASYNC
+static void farapi_worker(FAR void *arg)
+{
+  FAR struct cxd56_farreq_s *req = (FAR struct cxd56_farreq_s *)arg;
+
+  req->callback(req);
+}
+#endif
+
+static void farapi_complete(FAR struct cxd56_farreq_s *req, int ret)
+{
+  FAR int *regs = (FAR int *)req->msg.u.api.arg;
+
+  /* The firmware leaves the return value in the first argument word */
+
+  if (ret < 0)
+    {
+      regs[0] = ret;
+    }
+
+  req->result = regs[0];
+
+#ifdef CONFIG_CXD56_FARAPI_ASYNC
+  if (req->callback != NULL)
+    {
+      work_queue(FARAPI_WORK, &req->work, farapi_worker, req, 0);
+      return;
+    }
+#endif
+
+  nxsem_post(&req->done);
+}
+
+/****************************************************************************
+ * Name: farapi_dispatch
+ *
+ * Description:
+ *   Send the next queued call to an idle target CPU.  Must be called with
+ *   interrupts disabled.
+ *
+ ****************************************************************************/
+
+static void farapi_dispatch(int cpuno)
+{
+  FAR struct cxd56_farreq_s *req;
+  int ret;
+
+  while (g_farbusy[cpuno] == NULL)
+    {
+      req = (FAR struct cxd56_farreq_s *)sq_remfirst(&g_farqueue[cpuno]);
+      if (req == NULL)
+        {
+          break;
+        }
+
+      dump_farapi_message(&req->msg);
+
+      /* Send request by mailbox protocol */
+
+      ret = cxd56_sendmsg(cpuno, CXD56_PROTO_MBX, 4, 1 << 8 | 1,
+                          (uint32_t)(uintptr_t)&req->msg);
+      if (ret)
+        {
+          _err("Failed far api push\n");
+          farapi_complete(req, ret < 0 ? ret : -EIO);
+          continue;
+        }
+
+      /* Suppress hot sleep until Far API done */
+
+      up_pm_acquire_wakelock(&g_wlock);
+      g_farbusy[cpuno] = req;
+    }
+}
+
+/****************************************************************************
+ * Name: farapi_submit
+ *
+ * Description:
+ *   Build the mailbox message of a call and queue it for the target CPU.
+ *   arg points to the four argument words, which the firmware reads and
+ *   updates while the call is in progress.
+ *
+ ****************************************************************************/
+
+static int farapi_submit(FAR struct cxd56_farreq_s *req, int id,
+                         FAR void *arg, FAR struct modulelist_s *mlist)
+{
+  FAR struct farapi_apimsg_s *api = &req->msg.u.api;
+  irqstate_t flags;
+  int reqid;
+
+  DEBUGASSERT(mlist->cpuno >= 0 && mlist->cpuno < NCPUS);
+
+  req->cpuno     = mlist->cpuno;
+  req->msg.cpuid = getreg32(CPU_ID);
+  req->msg.modid = mlist - (struct modulelist_s *)&Image$$MODLIST$$Base;
+
+  api->id        = id;
+  api->arg       = arg;
+  api->mbxid     = mlist->mbxid;
+  api->flagid    = (req->msg.cpuid + 1) << 8 | 7; /* 7 is a magic. not zero */
+  api->flagbitno = 0;                            /* ignore */
+
+  flags = enter_critical_section();
+
+  reqid   = g_farid;
+  g_farid = (g_farid + 1) & INT32_MAX;
+  req->id = reqid;
+
+  sq_addlast((FAR sq_entry_t *)req, &g_farqueue[req->cpuno]);
+  farapi_dispatch(req->cpuno);
+
+  leave_critical_section(flags);
+  return reqid;
+}
+
 static int cxd56_farapidonehandler(int cpuid, int protoid,
                                    uint32_t pdata, uint32_t data,
                                    FAR void *userdata)
 {
+  FAR struct cxd56_farreq_s *req;
+  irqstate_t flags;
+
   /* Receive event flag message as Far API done.
    * We need only far API done event.
    */
@@ -184,7 +302,36 @@ static int cxd56_farapidonehandler(int cpuid, int protoid,
       /* Send event flag response */
 
       cxd56_sendmsg(cpuid, CXD56_PROTO_FLG, 5, pdata & 0xff00, 0);
-      nxsem_post(&g_farwait);
+
+      /* Only one call is in progress per target CPU, so the sender tells
+       * which call has completed.
+       */
+
+      if (cpuid < 0 || cpuid >= NCPUS)
+        {
+          return OK;
+        }
+
+      flags = enter_critical_section();
+
+      req = g_farbusy[cpuid];
+      if (req != NULL)
+        {
+          g_farbusy[cpuid] = NULL;
+
+          /* Permit hot sleep with Far API done */
+
+          up_pm_release_wakelock(&g_wlock);
+
+          farapi_complete(req, OK);
+          farapi_dispatch(cpuid);
+        }
+      else
+        {
+          _err("Unexpected far api done from CPU %d\n", cpuid);
+        }
+
+      leave_critical_section(flags);
     }
 
   return OK;
@@ -197,9 +344,7 @@ static int cxd56_farapidonehandler(int cpuid, int protoid,
 __attribute__((used))
 void farapi_main(int id, void *arg, struct modulelist_s *mlist)
 {
-  struct farmsg_s msg;
-  struct apimsg_s *api;
-  int ret;
+  struct cxd56_farreq_s req;
 #ifdef CONFIG_CXD56_GNSS_HOT_SLEEP
   uint32_t gnscken;
 
@@ -214,48 +359,69 @@ void farapi_main(int id, void *arg, struct modulelist_s *mlist)
     }
 #endif
 
-  farapi_semtake(&g_farlock);
+#ifdef CONFIG_CXD56_FARAPI_ASYNC
+  if (g_farasync != NULL && g_farowner == getpid())
+    {
+      /* Called through cxd56_farapi_async(): queue the call and return to
+       * the stub at once.  The arguments live in the request.
+       */
 
-  api = &msg.u.api;
+      FAR struct cxd56_farreq_s *areq = g_farasync;
 
-  msg.cpuid      = getreg32(CPU_ID);
-  msg.modid      = mlist - (struct modulelist_s *)&Image$$MODLIST$$Base;
+      g_farasync   = NULL;
+      g_farasyncid = farapi_submit(areq, id, areq->args, mlist);
+      return;
+    }
+#endif
 
-  api->id        = id;
-  api->arg       = arg;
-  api->mbxid     = mlist->mbxid;
-  api->flagid    = (msg.cpuid + 1) << 8 | 7; /* 7 is a magic. not zero */
-  api->flagbitno = 0;                        /* ignore */
+  memset(&req, 0, sizeof(struct cxd56_farreq_s));
+  nxsem_init(&req.done, 0, 0);
+  nxsem_setprotocol(&req.done, SEM_PRIO_NONE);
+
+  farapi_submit(&req, id, arg, mlist);
+
+  /* Wait event flag message as Far API done */
 
-  dump_farapi_message(&msg);
+  farapi_semtake(&req.done);
+  nxsem_destroy(&req.done);
 
-  /* Send request by mailbox protocol */
+  dump_farapi_message(&req.msg);
+}
 
-  ret = cxd56_sendmsg(mlist->cpuno, CXD56_PROTO_MBX, 4, 1 << 8 | 1,
-                      (uint32_t)(uintptr_t)&msg);
-  if (ret)
+#ifdef CONFIG_CXD56_FARAPI_ASYNC
+int cxd56_farapi_async(FAR struct cxd56_farreq_s *req, FAR void *api,
+                       uint32_t arg0, uint32_t arg1, uint32_t arg2,
+                       uint32_t arg3)
+{
+  typedef CODE int (*farapi_t)(uint32_t, uint32_t, uint32_t, uint32_t);
+  int ret;
+
+  if (req == NULL || req->callback == NULL || api == NULL)
     {
-      _err("Failed far api push\n");
-      goto err;
+      return -EINVAL;
     }
 
-  /* Suppress hot sleep until Far API done */
-
-  up_pm_acquire_wakelock(&g_wlock);
+  req->args[0] = arg0;
+  req->args[1] = arg1;
+  req->args[2] = arg2;
+  req->args[3] = arg3;
 
-  /* Wait event flag message as Far API done */
+  farapi_semtake(&g_farlock);
 
-  farapi_semtake(&g_farwait);
+  /* The stub ends up in farapi_main(), which picks the request up */
 
-  /* Permit hot sleep with Far API done */
+  g_farowner = getpid();
+  g_farasync = req;
 
-  up_pm_release_wakelock(&g_wlock);
+  ((farapi_t)api)(arg0, arg1, arg2, arg3);
 
-  dump_farapi_message(&msg);
+  ret = g_farasync == NULL ? g_farasyncid : -EINVAL;
+  g_farasync = NULL;
 
-err:
   nxsem_post(&g_farlock);
+  return ret;
 }
+#endif
 
 void cxd56_farapiinitialize(void)
 {
@@ -270,9 +436,10 @@ void cxd56_farapiinitialize(void)
 #  endif
     }
 #endif
+
+#ifdef CONFIG_CXD56_FARAPI_ASYNC
   nxsem_init(&g_farlock, 0, 1);
-  nxsem_init(&g_farwait, 0, 0);
-  nxsem_setprotocol(&g_farwait, SEM_PRIO_NONE);
+#endif
 
   cxd56_iccinit(CXD56_PROTO_MBX);
   cxd56_iccinit(CXD56_PROTO_FLG);
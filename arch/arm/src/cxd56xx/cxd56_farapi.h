@@ -36,7 +36,84 @@
 #ifndef __ARCH_ARM_SRC_CXD56XX_CXD56_FARAPI_H
 #define __ARCH_ARM_SRC_CXD56XX_CXD56_FARAPI_H
 
+/****************************************************************************
+ * Included Files
+ ****************************************************************************/
+
+#include <nuttx/config.h>
+
+#include <stdint.h>
+#include <queue.h>
+#include <semaphore.h>
+
+#ifdef CONFIG_CXD56_FARAPI_ASYNC
+#  include <nuttx/wqueue.h>
+#endif
+
 #ifndef __ASSEMBLY__
+
+/****************************************************************************
+ * Public Types
+ ****************************************************************************/
+
+/* Mailbox message read by the firmware while the call is in progress */
+
+struct farapi_apimsg_s
+{
+  int     id;
+  void   *arg;
+  int16_t mbxid;
+  int16_t flagid;
+  int     flagbitno;
+};
+
+struct farapi_callback_s
+{
+  int (*cbfunc)(void *);        /* pointer to callback function */
+  void *data;                   /* callback data */
+  int   flagbitno;              /* callback eventflag bitno */
+};
+
+struct farapi_msghead_s
+{
+  struct farapi_msghead_s *next;
+};
+
+struct farapi_msg_s
+{
+  struct farapi_msghead_s head; /* message head */
+  int cpuid;                    /* CPU ID of API caller */
+  int modid;                    /* module table offset */
+  union
+  {
+    struct farapi_apimsg_s api;
+    struct farapi_callback_s cb;
+  } u;
+};
+
+/* One far API call.  The firmware runs one call per target CPU at a time,
+ * further calls to the same CPU wait in a queue.  Only callback, priv, id
+ * and result are meant for the caller.
+ */
+
+struct cxd56_farreq_s;
+typedef CODE void (*cxd56_farcb_t)(FAR struct cxd56_farreq_s *req);
+
+struct cxd56_farreq_s
+{
+  sq_entry_t entry;             /* Link in the per-CPU queue */
+  cxd56_farcb_t callback;       /* Completion callback, NULL if blocking */
+  FAR void *priv;               /* Callback data */
+  uint32_t id;                  /* Request ID, set on submission */
+  int result;                   /* Return value of the far API */
+  int cpuno;                    /* Target CPU */
+  struct farapi_msg_s msg;      /* Message passed to the target CPU */
+  uint32_t args[4];             /* Arguments of an asynchronous call */
+  sem_t done;                   /* Posted when a blocking call completes */
+#ifdef CONFIG_CXD56_FARAPI_ASYNC
+  struct work_s work;           /* Runs the callback */
+#endif
+};
 #ifdef __cplusplus
 #define EXTERN extern "C"
 extern "C"
@@ -47,6 +124,27 @@ extern "C"
 
 void cxd56_farapiinitialize(void);
 
+#ifdef CONFIG_CXD56_FARAPI_ASYNC
+/****************************************************************************
+ * Name: cxd56_farapi_async
+ *
+ * Description:
+ *   Start a far API call without waiting for it to complete.  api is one of
+ *   the fw_* stubs, called with up to four word sized arguments.  When the
+ *   firmware is done, req->result holds the return value and
+ *   req->callback is run on the work queue.  req and any
+ *   buffers passed to the API must stay valid until then.
+ *
+ * Returned Value:
+ *   The request ID (>= 0) on success; a negated errno value on failure.
+ *
+ ****************************************************************************/
+
+int cxd56_farapi_async(FAR struct cxd56_farreq_s *req, FAR void *api,
+                       uint32_t arg0, uint32_t arg1, uint32_t arg2,
+                       uint32_t arg3);
+#endif
+
 #undef EXTERN
 #ifdef __cplusplus
 }
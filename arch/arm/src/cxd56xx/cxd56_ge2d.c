@@ -43,10 +43,12 @@
 #include <nuttx/fs/fs.h>
 #include <nuttx/irq.h>
 #include <nuttx/semaphore.h>
+#include <nuttx/video/fb.h>
 
 #include <queue.h>
 #include <stdio.h>
 #include <stdint.h>
+#include <stdbool.h>
 #include <string.h>
 #include <debug.h>
 #include <errno.h>
@@ -57,6 +59,27 @@
 
 #include "hardware/cxd56_ge2d.h"
 
+#include <arch/chip/ge2d.h>
+
+/****************************************************************************
+ * Pre-processor Definitions
+ ****************************************************************************/
+
+/* Error and completion interrupts */
+
+#define GE2D_INTR_DONE (GE2D_INTR_WR_ERR | GE2D_INTR_RD_ERR | \
+                        GE2D_INTR_NDE | GE2D_INTR_DSD | GE2D_INTR_NDF)
+
+/* Bus errors reported in the interrupt status */
+
+#define GE2D_INTR_ERRORS (GE2D_INTR_WR_ERR | GE2D_INTR_RD_ERR)
+
+/* Framebuffer acceleration for the LCD framebuffer front end */
+
+#ifdef CONFIG_FB_ACCEL
+#  define GE2D_FBACCEL 1
+#endif
+
 /****************************************************************************
  * Private Function Prototypes
  ****************************************************************************/
@@ -71,6 +94,12 @@ static int ge2d_ioctl(FAR struct file *filep, int cmd, unsigned long arg);
 static int ge2d_semtake(sem_t *id);
 static void ge2d_semgive(sem_t *id);
 static int ge2d_irqhandler(int irq, FAR void *context, FAR void *arg);
+#ifdef GE2D_FBACCEL
+static int ge2d_fbrop(FAR const struct fb_planeinfo_s *pinfo,
+                      fb_coord_t x, fb_coord_t y, fb_coord_t w,
+                      fb_coord_t h, FAR const void *src,
+                      fb_coord_t srcstride, uint8_t rop, uint32_t color);
+#endif
 
 /****************************************************************************
  * Private Data
@@ -88,6 +117,20 @@ static const struct file_operations g_ge2dfops =
 
 static sem_t g_wait;
 static sem_t g_lock;
+static bool g_initialized;
+
+/* Completion of the descriptor list that is being executed */
+
+static cxd56_ge2d_callback_t g_callback;
+static FAR void *g_cbarg;
+static volatile int g_result;
+
+#ifdef GE2D_FBACCEL
+/* Descriptor list for framebuffer operations: one ROP and a halt */
+
+static sem_t g_fblock;
+static struct ge2d_ropcmd_s g_fbcmd[2] aligned_data(16);
+#endif
 
 /****************************************************************************
  * Private Functions
@@ -146,7 +189,7 @@ static ssize_t ge2d_write(FAR struct file *filep,
                           FAR const char *buffer,
                           size_t len)
 {
-  uint32_t bits;
+  int ret;
 
   /* GE2D wants 16 byte aligned address for operation buffer. */
 
@@ -156,33 +199,11 @@ static ssize_t ge2d_write(FAR struct file *filep,
       return 0;
     }
 
-  /* Get exclusive access */
-
-  ge2d_semtake(&g_lock);
-
-  /* Set operation buffer and start processing.
-   * Descriptor start address bit 0 is select to bus, always 1 (memory),
-   * can't set except 1 in this chip.
-   */
-
-  putreg32((uint32_t)(uintptr_t)buffer | 1, GE2D_ADDRESS_DESCRIPTOR_START);
-  putreg32(GE2D_EXEC, GE2D_CMD_DESCRIPTOR);
-
-  /* Enable error and completion interrupts. */
-
-  bits = GE2D_INTR_WR_ERR | GE2D_INTR_RD_ERR | GE2D_INTR_NDE | GE2D_INTR_DSD |
-    GE2D_INTR_NDF;
-  putreg32(bits, GE2D_INTR_ENABLE);
-
-  /* Wait for interrupts for processing done. */
-
-  ge2d_semtake(&g_wait);
-
-  /* Disable interrupts */
-
-  putreg32(0, GE2D_INTR_ENABLE);
-
-  ge2d_semgive(&g_lock);
+  ret = cxd56_ge2d_submit(buffer, NULL, NULL);
+  if (ret < 0)
+    {
+      return ret;
+    }
 
   return len;
 }
@@ -223,15 +244,204 @@ static int ge2d_irqhandler(int irq, FAR void *context, FAR void *arg)
   stat = getreg32(GE2D_INTR_STAT);
   putreg32(stat, GE2D_INTR_STAT);
 
-  /* TODO: output status to syslog */
+  g_result = (stat & GE2D_INTR_ERRORS) != 0 ? -EIO : OK;
+
+  if (g_callback != NULL)
+    {
+      cxd56_ge2d_callback_t callback = g_callback;
 
-  /* Release semaphore anyway */
+      /* Asynchronous list: nobody waits for it, so finish it here and let
+       * the next user have the engine.
+       */
 
-  ge2d_semgive(&g_wait);
+      g_callback = NULL;
+      putreg32(0, GE2D_INTR_ENABLE);
+
+      callback(g_cbarg, g_result);
+      ge2d_semgive(&g_lock);
+    }
+  else
+    {
+      /* Release semaphore anyway */
+
+      ge2d_semgive(&g_wait);
+    }
 
   return OK;
 }
 
+/****************************************************************************
+ * Name: ge2d_fbrop
+ *
+ * Description:
+ *   Run one raster operation on a rectangle of framebuffer memory.  The
+ *   engine works on 8 or 16 bpp pixels, needs even widths and halfword
+ *   aligned addresses and expresses pitches in pixels; anything else is
+ *   left to software.
+ *
+ ****************************************************************************/
+
+#ifdef GE2D_FBACCEL
+static int ge2d_fbrop(FAR const struct fb_planeinfo_s *pinfo,
+                      fb_coord_t x, fb_coord_t y, fb_coord_t w,
+                      fb_coord_t h, FAR const void *src,
+                      fb_coord_t srcstride, uint8_t rop, uint32_t color)
+{
+  FAR struct ge2d_ropcmd_s *rc = &g_fbcmd[0];
+  unsigned int bytespp;
+  uintptr_t daddr;
+  int ret;
+
+  if (!g_initialized)
+    {
+      return -ENODEV;
+    }
+
+  if (pinfo->bpp != 8 && pinfo->bpp != 16)
+    {
+      return -ENOSYS;
+    }
+
+  bytespp = pinfo->bpp >> 3;
+  daddr   = (uintptr_t)pinfo->fbmem + y * pinfo->stride + x * bytespp;
+
+  if (src == NULL)
+    {
+      /* Fill: the pattern is a fixed color and the source is unused */
+
+      src       = (FAR const void *)daddr;
+      srcstride = pinfo->stride;
+    }
+
+  if ((w & 1) != 0 || (daddr & 1) != 0 || ((uintptr_t)src & 1) != 0 ||
+      (pinfo->stride % bytespp) != 0 || (srcstride % bytespp) != 0)
+    {
+      return -EINVAL;
+    }
+
+  ret = ge2d_semtake(&g_fblock);
+  if (ret < 0)
+    {
+      return ret;
+    }
+
+  memset(g_fbcmd, 0, sizeof(g_fbcmd));
+
+  rc->cmd        = GE2D_CMD_ROP;
+  if (pinfo->bpp == 16)
+    {
+      rc->cmd   |= GE2D_ROP_SRC16BPP;
+    }
+
+  rc->rop        = rop;
+  rc->options    = GE2D_ROP_FIXEDCOLOR;
+  rc->fixedcolor = color;
+  rc->srch       = w - 1;
+  rc->srcv       = h - 1;
+  rc->saddr      = (uint32_t)(uintptr_t)src | GE2D_MSEL;
+  rc->daddr      = (uint32_t)daddr | GE2D_MSEL;
+  rc->spitch     = srcstride / bytespp - 1;
+  rc->dpitch     = pinfo->stride / bytespp - 1;
+
+  /* g_fbcmd[1] is left zeroed as the halt descriptor */
+
+  ret = cxd56_ge2d_submit(g_fbcmd, NULL, NULL);
+
+  ge2d_semgive(&g_fblock);
+  return ret;
+}
+#endif
+
+/****************************************************************************
+ * Public Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: cxd56_ge2d_submit
+ ****************************************************************************/
+
+int cxd56_ge2d_submit(FAR const void *cmd, cxd56_ge2d_callback_t callback,
+                      FAR void *arg)
+{
+  int ret;
+
+  if (((uintptr_t)cmd & 0xf) != 0)
+    {
+      return -EINVAL;
+    }
+
+  /* Get exclusive access.  An asynchronous list keeps it until the
+   * interrupt handler has finished the list.
+   */
+
+  ret = ge2d_semtake(&g_lock);
+  if (ret < 0)
+    {
+      return ret;
+    }
+
+  g_callback = callback;
+  g_cbarg    = arg;
+  g_result   = OK;
+
+  /* Set operation buffer and start processing.
+   * Descriptor start address bit 0 is select to bus, always 1 (memory),
+   * can't set except 1 in this chip.
+   */
+
+  putreg32((uint32_t)(uintptr_t)cmd | GE2D_MSEL,
+           GE2D_ADDRESS_DESCRIPTOR_START);
+  putreg32(GE2D_EXEC, GE2D_CMD_DESCRIPTOR);
+
+  /* Enable error and completion interrupts. */
+
+  putreg32(GE2D_INTR_DONE, GE2D_INTR_ENABLE);
+
+  if (callback != NULL)
+    {
+      return OK;
+    }
+
+  /* Wait for interrupts for processing done. */
+
+  ge2d_semtake(&g_wait);
+
+  /* Disable interrupts */
+
+  putreg32(0, GE2D_INTR_ENABLE);
+
+  ret = g_result;
+  ge2d_semgive(&g_lock);
+
+  return ret;
+}
+
+/****************************************************************************
+ * Name: up_fbaccel_fillrect
+ ****************************************************************************/
+
+#ifdef GE2D_FBACCEL
+int up_fbaccel_fillrect(FAR const struct fb_planeinfo_s *pinfo,
+                        FAR const struct fb_fillrect_s *fill)
+{
+  return ge2d_fbrop(pinfo, fill->x, fill->y, fill->w, fill->h, NULL, 0,
+                    GE2D_ROP_PATCOPY, fill->color);
+}
+#endif
+
+/****************************************************************************
+ * Name: up_fbaccel_copyrect
+ ****************************************************************************/
+
+#ifdef GE2D_FBACCEL
+int up_fbaccel_copyrect(FAR const struct fb_planeinfo_s *pinfo,
+                        FAR const struct fb_copyrect_s *copy)
+{
+  return ge2d_fbrop(pinfo, copy->x, copy->y, copy->w, copy->h, copy->src,
+                    copy->srcstride, GE2D_ROP_SRCCOPY, 0);
+}
+#endif
+
 /****************************************************************************
  * Name: cxd56_ge2dinitialize
  ****************************************************************************/
@@ -243,6 +453,9 @@ int cxd56_ge2dinitialize(FAR const char *devname)
   nxsem_init(&g_lock, 0, 1);
   nxsem_init(&g_wait, 0, 0);
   nxsem_setprotocol(&g_wait, SEM_PRIO_NONE);
+#ifdef GE2D_FBACCEL
+  nxsem_init(&g_fblock, 0, 1);
+#endif
 
   ret = register_driver(devname, &g_ge2dfops, 0666, NULL);
   if (ret != 0)
@@ -259,6 +472,8 @@ int cxd56_ge2dinitialize(FAR const char *devname)
   irq_attach(CXD56_IRQ_GE2D, ge2d_irqhandler, NULL);
   up_enable_irq(CXD56_IRQ_GE2D);
 
+  g_initialized = true;
+
   return OK;
 }
 
@@ -268,6 +483,8 @@ int cxd56_ge2dinitialize(FAR const char *devname)
 
 void cxd56_ge2duninitialize(FAR const char *devname)
 {
+  g_initialized = false;
+
   up_disable_irq(CXD56_IRQ_GE2D);
   irq_detach(CXD56_IRQ_GE2D);
 
@@ -275,6 +492,9 @@ void cxd56_ge2duninitialize(FAR const char *devname)
 
   nxsem_destroy(&g_lock);
   nxsem_destroy(&g_wait);
+#ifdef GE2D_FBACCEL
+  nxsem_destroy(&g_fblock);
+#endif
 
   unregister_driver(devname);
 }
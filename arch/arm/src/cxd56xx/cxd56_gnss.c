@@ -39,6 +39,7 @@
 
 #include <nuttx/config.h>
 
+#include <stddef.h>
 #include <stdio.h>
 #include <stdlib.h>
 #include <string.h>
@@ -47,8 +48,10 @@
 #include <errno.h>
 #include <debug.h>
 
+#include <nuttx/clock.h>
 #include <nuttx/kmalloc.h>
 #include <nuttx/fs/fs.h>
+#include <nuttx/fs/ioctl.h>
 #include <nuttx/board.h>
 #include <nuttx/spi/spi.h>
 #include <arch/chip/gnss.h>
@@ -59,6 +62,10 @@
 #include "cxd56_gnss.h"
 #include "cxd56_pinconfig.h"
 
+#ifdef CONFIG_CXD56_GNSS_RING
+#  include "barriers.h"
+#endif
+
 #if defined(CONFIG_CXD56_GNSS)
 
 /****************************************************************************
@@ -139,6 +146,17 @@ extern int fw_pm_sleepcpu(int cpuid, int mode);
 #define GNSS_ARGS_FILE_BUF                    1
 #define GNSS_ARGS_FILE_LENGTH                 2
 
+/* Record ring payload: large enough for either record type */
+
+#define GNSS_RING_DATASIZE \
+  (sizeof(struct cxd56_gnss_positiondata_s) > \
+   sizeof(struct cxd56_supl_mesurementdata_s) ? \
+   sizeof(struct cxd56_gnss_positiondata_s) : \
+   sizeof(struct cxd56_supl_mesurementdata_s))
+#define GNSS_RING_RECSIZE \
+  ((offsetof(struct cxd56_gnss_ringrec_s, data) + GNSS_RING_DATASIZE + 7) & \
+   ~7)
+
 /****************************************************************************
  * Private Types
  ****************************************************************************/
@@ -176,6 +194,11 @@ struct cxd56_gnss_dev_s
   sem_t                           ioctllock;
   sem_t                           apiwait;
   int                             apiret;
+#ifdef CONFIG_CXD56_GNSS_RING
+  FAR struct cxd56_gnss_ring_s   *ring;
+  uint32_t                        ringtypes;
+  uint32_t                        watermark;
+#endif
 };
 
 /****************************************************************************
@@ -276,6 +299,10 @@ static int cxd56_gnss_set_1pps_output(FAR struct file *filep,
                                       unsigned long arg);
 static int cxd56_gnss_get_1pps_output(FAR struct file *filep,
                                       unsigned long arg);
+#ifdef CONFIG_CXD56_GNSS_RING
+static int cxd56_gnss_start_ring(FAR struct file *filep, unsigned long arg);
+static int cxd56_gnss_stop_ring(FAR struct file *filep, unsigned long arg);
+#endif
 
 /* file operation functions */
 
@@ -374,6 +401,13 @@ static int (*g_cmdlist[CXD56_GNSS_IOCTL_MAX])(FAR struct file *filep,
   cxd56_gnss_get_usecase,
   cxd56_gnss_set_1pps_output,
   cxd56_gnss_get_1pps_output,
+#ifdef CONFIG_CXD56_GNSS_RING
+  cxd56_gnss_start_ring,
+  cxd56_gnss_stop_ring,
+#else
+  NULL,
+  NULL,
+#endif
   /* max                       CXD56_GNSS_IOCTL_MAX */
 };
 
@@ -2062,6 +2096,248 @@ static int cxd56_gnss_get_1pps_output(FAR struct file *filep,
   return ret;
 }
 
+#ifdef CONFIG_CXD56_GNSS_RING
+
+/****************************************************************************
+ * Name: cxd56_gnss_start_ring
+ *
+ * Description:
+ *   Process CXD56_GNSS_IOCTL_START_RING command.
+ *   Allocate the record ring if needed and start recording the selected
+ *   record types into it.
+ *
+ * Input Parameters:
+ *   filep - File structure pointer
+ *   arg   - Data for command
+ *
+ * Returned Value:
+ *   Zero (OK) on success; a negated errno value on failure.
+ *
+ ****************************************************************************/
+
+static int cxd56_gnss_start_ring(FAR struct file *filep, unsigned long arg)
+{
+  FAR struct inode                      *inode;
+  FAR struct cxd56_gnss_dev_s           *priv;
+  FAR struct cxd56_gnss_ring_param_s    *param;
+  FAR struct cxd56_gnss_ring_s          *ring;
+  int                                    ret;
+
+  if (!arg)
+    {
+      return -EINVAL;
+    }
+
+  inode = filep->f_inode;
+  priv  = (FAR struct cxd56_gnss_dev_s *)inode->i_private;
+  param = (FAR struct cxd56_gnss_ring_param_s *)arg;
+
+  if ((param->types & ~(CXD56_GNSS_RING_POSITION | CXD56_GNSS_RING_RAW)) ||
+      param->types == 0)
+    {
+      return -EINVAL;
+    }
+
+  ret = nxsem_wait(&priv->devsem);
+  if (ret < 0)
+    {
+      return ret;
+    }
+
+  if (priv->ring == NULL)
+    {
+      ring = (FAR struct cxd56_gnss_ring_s *)kmm_zalloc(
+        sizeof(struct cxd56_gnss_ring_s) +
+        CONFIG_CXD56_GNSS_RING_NRECORDS * GNSS_RING_RECSIZE);
+      if (ring == NULL)
+        {
+          ret = -ENOMEM;
+          goto errout;
+        }
+
+      ring->nrecords = CONFIG_CXD56_GNSS_RING_NRECORDS;
+      ring->recsize  = GNSS_RING_RECSIZE;
+      priv->ring     = ring;
+    }
+
+  priv->watermark = param->watermark;
+  if (priv->watermark == 0)
+    {
+      priv->watermark = 1;
+    }
+  else if (priv->watermark > CONFIG_CXD56_GNSS_RING_NRECORDS)
+    {
+      priv->watermark = CONFIG_CXD56_GNSS_RING_NRECORDS;
+    }
+
+  priv->ringtypes = param->types;
+
+  /* The ring is fed from the notifications, whoever else listens */
+
+  if (param->types & CXD56_GNSS_RING_POSITION)
+    {
+      fw_gd_setnotifymask(CXD56_CPU1_DEV_GNSS, FALSE);
+    }
+
+  if (param->types & CXD56_GNSS_RING_RAW)
+    {
+      fw_gd_setnotifymask(CXD56_CPU1_DATA_TYPE_AGPS, FALSE);
+    }
+
+errout:
+  nxsem_post(&priv->devsem);
+  return ret;
+}
+
+/****************************************************************************
+ * Name: cxd56_gnss_stop_ring
+ *
+ * Description:
+ *   Process CXD56_GNSS_IOCTL_STOP_RING command.
+ *   Stop recording.  The ring and its records stay in place.
+ *
+ * Input Parameters:
+ *   filep - File structure pointer
+ *   arg   - Data for command
+ *
+ * Returned Value:
+ *   Zero (OK) on success; a negated errno value on failure.
+ *
+ ****************************************************************************/
+
+static int cxd56_gnss_stop_ring(FAR struct file *filep, unsigned long arg)
+{
+  FAR struct inode            *inode;
+  FAR struct cxd56_gnss_dev_s *priv;
+  int                          ret;
+
+  inode = filep->f_inode;
+  priv  = (FAR struct cxd56_gnss_dev_s *)inode->i_private;
+
+  ret = nxsem_wait(&priv->devsem);
+  if (ret < 0)
+    {
+      return ret;
+    }
+
+  priv->ringtypes = 0;
+
+  nxsem_post(&priv->devsem);
+  return OK;
+}
+
+/****************************************************************************
+ * Name: cxd56_gnss_ring_type
+ *
+ * Description:
+ *   Return the ring record type kept for a notification type, or 0 if the
+ *   ring does not keep it.
+ *
+ ****************************************************************************/
+
+static uint32_t cxd56_gnss_ring_type(FAR struct cxd56_gnss_dev_s *priv,
+                                     uint8_t sigtype)
+{
+  uint32_t type;
+
+  switch (sigtype)
+    {
+    case CXD56_CPU1_DATA_TYPE_GNSS:
+      type = CXD56_GNSS_RING_POSITION;
+      break;
+
+    case CXD56_CPU1_DATA_TYPE_AGPS:
+      type = CXD56_GNSS_RING_RAW;
+      break;
+
+    default:
+      return 0;
+    }
+
+  return priv->ringtypes & type;
+}
+
+/****************************************************************************
+ * Name: cxd56_gnss_ring_push
+ *
+ * Description:
+ *   Copy the data of a notification from the GNSS CPU into the next free
+ *   record.  Called with devsem held.
+ *
+ * Returned Value:
+ *   true if the ring keeps this notification type, even if the ring was
+ *   full and the record was dropped.
+ *
+ ****************************************************************************/
+
+static bool cxd56_gnss_ring_push(FAR struct cxd56_gnss_dev_s *priv,
+                                 uint8_t sigtype)
+{
+  FAR struct cxd56_gnss_ring_s    *ring = priv->ring;
+  FAR struct cxd56_gnss_ringrec_s *rec;
+  uint32_t                         type;
+  size_t                           len;
+  int                              ret;
+
+  type = cxd56_gnss_ring_type(priv, sigtype);
+  if (type == 0)
+    {
+      return false;
+    }
+
+  if (ring->head - ring->tail >= ring->nrecords)
+    {
+      ring->dropped++;
+      return true;
+    }
+
+  if (type == CXD56_GNSS_RING_POSITION)
+    {
+      len = sizeof(struct cxd56_gnss_positiondata_s);
+    }
+  else
+    {
+      len = sizeof(struct cxd56_supl_mesurementdata_s);
+    }
+
+  rec = CXD56_GNSS_RING_RECORD(ring, ring->head);
+  ret = fw_gd_readbuffer(sigtype, 0, rec->data, len);
+  if (ret < 0)
+    {
+      gnsswarn("Failed to read ring record: %d\n", ret);
+      return true;
+    }
+
+  rec->seq       = ring->head;
+  rec->timestamp = TICK2MSEC(clock_systimer());
+  rec->type      = type;
+  rec->len       = ret;
+
+  /* Publish the record only after its contents */
+
+  ARM_DMB();
+  ring->head++;
+
+  return true;
+}
+
+/****************************************************************************
+ * Name: cxd56_gnss_ring_ready
+ *
+ * Description:
+ *   Return true if at least the watermark number of records is pending.
+ *
+ ****************************************************************************/
+
+static bool cxd56_gnss_ring_ready(FAR struct cxd56_gnss_dev_s *priv)
+{
+  FAR struct cxd56_gnss_ring_s *ring = priv->ring;
+
+  return ring != NULL && priv->ringtypes != 0 &&
+         ring->head - ring->tail >= priv->watermark;
+}
+#endif /* CONFIG_CXD56_GNSS_RING */
+
 /* Synchronized with processes and CPUs
  *  CXD56_GNSS signal handler and utils
  */
@@ -2277,6 +2553,15 @@ static void cxd56_gnss_common_signalhandler(uint32_t data, FAR void *userdata)
         }
     }
 
+#ifdef CONFIG_CXD56_GNSS_RING
+  /* Keep the notifications coming while the ring records them */
+
+  if (cxd56_gnss_ring_type(priv, sigtype) != 0)
+    {
+      issetmask = 0;
+    }
+#endif
+
   if (issetmask)
     {
       fw_gd_setnotifymask(sigtype, FALSE);
@@ -2288,6 +2573,30 @@ static void cxd56_gnss_common_signalhandler(uint32_t data, FAR void *userdata)
 #endif /* if !defined(CONFIG_DISABLE_SIGNAL) && \
           (CONFIG_CXD56_GNSS_NSIGNALRECEIVERS != 0) */
 
+/****************************************************************************
+ * Name: cxd56_gnss_pollnotify
+ *
+ * Description:
+ *   Report POLLIN to all poll waiters.  Called with devsem held.
+ *
+ ****************************************************************************/
+
+static void cxd56_gnss_pollnotify(FAR struct cxd56_gnss_dev_s *priv)
+{
+  int i;
+
+  for (i = 0; i < CONFIG_CXD56_GNSS_NPOLLWAITERS; i++)
+    {
+      struct pollfd *fds = priv->fds[i];
+      if (fds)
+        {
+          fds->revents |= POLLIN;
+          gnssinfo("Report events: %02x\n", fds->revents);
+          nxsem_post(fds->sem);
+        }
+    }
+}
+
 /****************************************************************************
  * Name: cxd56_gnss_default_sighandler
  *
@@ -2307,7 +2616,6 @@ static void cxd56_gnss_common_signalhandler(uint32_t data, FAR void *userdata)
 static void cxd56_gnss_default_sighandler(uint32_t data, FAR void *userdata)
 {
   FAR struct cxd56_gnss_dev_s *priv = (FAR struct cxd56_gnss_dev_s *)userdata;
-  int                          i;
   int                          ret;
   int                          dtype = CXD56_CPU1_GET_DATA(data);
 
@@ -2371,15 +2679,59 @@ static void cxd56_gnss_default_sighandler(uint32_t data, FAR void *userdata)
       return;
     }
 
-  for (i = 0; i < CONFIG_CXD56_GNSS_NPOLLWAITERS; i++)
+#ifdef CONFIG_CXD56_GNSS_RING
+  /* With the ring, wake the pollers once enough records are pending */
+
+  if (!cxd56_gnss_ring_push(priv, CXD56_CPU1_DATA_TYPE_GNSS) ||
+      cxd56_gnss_ring_ready(priv))
     {
-      struct pollfd *fds = priv->fds[i];
-      if (fds)
-        {
-          fds->revents |= POLLIN;
-          gnssinfo("Report events: %02x\n", fds->revents);
-          nxsem_post(fds->sem);
-        }
+      cxd56_gnss_pollnotify(priv);
+    }
+#else
+  cxd56_gnss_pollnotify(priv);
+#endif
+
+  nxsem_post(&priv->devsem);
+
+#if !defined(CONFIG_DISABLE_SIGNAL) && \
+  (CONFIG_CXD56_GNSS_NSIGNALRECEIVERS != 0)
+  cxd56_gnss_common_signalhandler(data, userdata);
+#endif
+}
+
+/****************************************************************************
+ * Name: cxd56_gnss_ring_sighandler
+ *
+ * Description:
+ *   Handler for AGPS type notification from GNSS CPU.  Record the raw
+ *   measurement into the ring before the signal receivers are notified.
+ *
+ * Input Parameters:
+ *   data     - Received data from GNSS CPU
+ *   userdata - User data, this is the device information specified by the
+ *              second argument of the function cxd56_cpu1siginit.
+ *
+ * Returned Value:
+ *   None
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_CXD56_GNSS_RING
+static void cxd56_gnss_ring_sighandler(uint32_t data, FAR void *userdata)
+{
+  FAR struct cxd56_gnss_dev_s *priv = (FAR struct cxd56_gnss_dev_s *)userdata;
+  int                          ret;
+
+  ret = nxsem_wait(&priv->devsem);
+  if (ret < 0)
+    {
+      return;
+    }
+
+  if (cxd56_gnss_ring_push(priv, CXD56_CPU1_GET_DEV(data)) &&
+      cxd56_gnss_ring_ready(priv))
+    {
+      cxd56_gnss_pollnotify(priv);
     }
 
   nxsem_post(&priv->devsem);
@@ -2389,6 +2741,7 @@ static void cxd56_gnss_default_sighandler(uint32_t data, FAR void *userdata)
   cxd56_gnss_common_signalhandler(data, userdata);
 #endif
 }
+#endif
 
 /****************************************************************************
  * Name: cxd56_gnss_cpufifoapi_signalhandler
@@ -2695,6 +3048,17 @@ static int cxd56_gnss_close(FAR struct file *filep)
   priv->num_open--;
   if (priv->num_open == 0)
     {
+#ifdef CONFIG_CXD56_GNSS_RING
+      /* No descriptor is left that could have mapped the ring */
+
+      if (priv->ring != NULL)
+        {
+          kmm_free(priv->ring);
+          priv->ring      = NULL;
+          priv->ringtypes = 0;
+        }
+#endif
+
 #ifndef CONFIG_CXD56_GNSS_HOT_SLEEP
       fw_pm_sleepcpu(CXD56_GNSS_GPS_CPUID, PM_SLEEP_MODE_HOT_ENABLE);
 #endif
@@ -2828,7 +3192,23 @@ static int cxd56_gnss_ioctl(FAR struct file *filep, int cmd,
   inode = filep->f_inode;
   priv  = (FAR struct cxd56_gnss_dev_s *)inode->i_private;
 
-  if (cmd <= CXD56_GNSS_IOCTL_INVAL || cmd >= CXD56_GNSS_IOCTL_MAX)
+#ifdef CONFIG_CXD56_GNSS_RING
+  if (cmd == FIOC_MMAP)
+    {
+      /* Map the record ring, which must have been started once */
+
+      if (priv->ring == NULL)
+        {
+          return -ENOMEM;
+        }
+
+      *(FAR void **)arg = priv->ring;
+      return OK;
+    }
+#endif
+
+  if (cmd <= CXD56_GNSS_IOCTL_INVAL || cmd >= CXD56_GNSS_IOCTL_MAX ||
+      g_cmdlist[cmd] == NULL)
     {
       return -EINVAL;
     }
@@ -2899,6 +3279,16 @@ static int cxd56_gnss_poll(FAR struct file *filep, FAR struct pollfd *fds,
               priv->fds[i] = fds;
               fds->priv    = &priv->fds[i];
               fw_gd_setnotifymask(CXD56_CPU1_DEV_GNSS, FALSE);
+
+#ifdef CONFIG_CXD56_GNSS_RING
+              /* Records may have piled up before this poll */
+
+              if (cxd56_gnss_ring_ready(priv))
+                {
+                  fds->revents |= POLLIN;
+                  nxsem_post(fds->sem);
+                }
+#endif
               break;
             }
         }
@@ -2961,7 +3351,11 @@ static int cxd56_gnss_register(FAR const char *devpath)
     },
     {
       CXD56_CPU1_DATA_TYPE_AGPS,
+#ifdef CONFIG_CXD56_GNSS_RING
+      cxd56_gnss_ring_sighandler
+#else
       cxd56_gnss_common_signalhandler
+#endif
     },
     {
       CXD56_CPU1_DATA_TYPE_RTK,
@@ -107,6 +107,18 @@ struct cxd56_i2cdev_s
 
   int              error;      /* Error status of each transfers */
   int              refs;       /* Reference count */
+
+#ifdef CONFIG_I2C_BATCH
+  /* Batch operations to one device, run from the interrupt handler */
+
+  FAR const struct i2c_batchop_s *bops;
+  int              bcount;     /* Number of operations in bops */
+  int              btxop;      /* Next command to queue: operation */
+  int              btxpos;     /*   and byte within it */
+  int              brxop;      /* Next byte to receive: operation */
+  int              brxpos;     /*   and byte within it */
+  int              bpending;   /* Reads queued but not yet received */
+#endif
 };
 
 /* Channel 0 as SCU_I2C0
@@ -168,6 +180,11 @@ static int  cxd56_i2c_transfer(FAR struct i2c_master_s *dev,
 #ifdef CONFIG_I2C_RESET
 static int cxd56_i2c_reset(FAR struct i2c_master_s * dev);
 #endif
+#ifdef CONFIG_I2C_BATCH
+static bool cxd56_i2c_batchirq(struct cxd56_i2cdev_s *priv);
+static int  cxd56_i2c_batch(FAR struct i2c_master_s *dev,
+                            FAR const struct i2c_batchop_s *ops, int count);
+#endif
 #if defined(CONFIG_CXD56_I2C0_SCUSEQ) || defined(CONFIG_CXD56_I2C1_SCUSEQ)
 static int  cxd56_i2c_transfer_scu(FAR struct i2c_master_s *dev,
                                    FAR struct i2c_msg_s *msgs, int count);
@@ -260,6 +277,9 @@ struct i2c_ops_s cxd56_i2c_ops =
 #ifdef CONFIG_I2C_RESET
   .reset = cxd56_i2c_reset,
 #endif
+#ifdef CONFIG_I2C_BATCH
+  .batch = cxd56_i2c_batch,
+#endif
 };
 
 #if defined(CONFIG_CXD56_I2C0_SCUSEQ) || defined(CONFIG_CXD56_I2C1_SCUSEQ)
@@ -460,6 +480,30 @@ static int cxd56_i2c_interrupt(int irq, FAR void *context, FAR void *arg)
       priv->error = -EIO;
     }
 
+#ifdef CONFIG_I2C_BATCH
+  if (priv->bops != NULL)
+    {
+      if (state & INTR_STOP_DET)
+        {
+          i2c_reg_read(priv, CXD56_IC_CLR_STOP_DET);
+        }
+
+      if (priv->error == OK && !cxd56_i2c_batchirq(priv))
+        {
+          return OK;
+        }
+
+      i2c_reg_write(priv, CXD56_IC_INTR_MASK, I2C_INTR_ENABLE);
+      ret = wd_cancel(priv->timeout);
+      if (ret == OK)
+        {
+          i2c_givesem(&priv->wait);
+        }
+
+      return OK;
+    }
+#endif
+
   if (state & INTR_TX_EMPTY)
     {
       /* TX_EMPTY is automatically cleared by hardware
@@ -714,6 +758,224 @@ static int cxd56_i2c_transfer(FAR struct i2c_master_s *dev,
   return ret;
 }
 
+#ifdef CONFIG_I2C_BATCH
+
+/****************************************************************************
+ * Name: cxd56_i2c_batchirq
+ *
+ * Description:
+ *   Move the running batch along: store the received bytes, then queue as
+ *   many commands as the FIFOs allow.  Reads are only queued while there is
+ *   room for their data in the RX FIFO.  Called with interrupts disabled.
+ *
+ * Returned Value:
+ *   true if every operation of the batch has completed.
+ *
+ ****************************************************************************/
+
+static bool cxd56_i2c_batchirq(struct cxd56_i2cdev_s *priv)
+{
+  FAR const struct i2c_batchop_s *op;
+  uint32_t status;
+  uint32_t cmd;
+  int total;
+
+  /* Receive */
+
+  status = i2c_reg_read(priv, CXD56_IC_STATUS);
+  while (status & STATUS_RFNE)
+    {
+      while (priv->brxop < priv->bcount &&
+             priv->brxpos >= priv->bops[priv->brxop].rlength)
+        {
+          priv->brxop++;
+          priv->brxpos = 0;
+        }
+
+      if (priv->brxop >= priv->bcount)
+        {
+          priv->error = -EIO;
+          return true;
+        }
+
+      op = &priv->bops[priv->brxop];
+      op->rbuffer[priv->brxpos++] =
+        i2c_reg_read(priv, CXD56_IC_DATA_CMD) & CMD_DAT;
+      priv->bpending--;
+      status = i2c_reg_read(priv, CXD56_IC_STATUS);
+    }
+
+  while (priv->brxop < priv->bcount &&
+         priv->brxpos >= priv->bops[priv->brxop].rlength)
+    {
+      priv->brxop++;
+      priv->brxpos = 0;
+    }
+
+  /* Queue commands.  Every operation ends with a STOP; its read, if any,
+   * begins with a repeated START.
+   */
+
+  while (priv->btxop < priv->bcount && (status & STATUS_TFNF))
+    {
+      op    = &priv->bops[priv->btxop];
+      total = op->wlength + op->rlength;
+
+      if (priv->btxpos < op->wlength)
+        {
+          cmd = op->wbuffer[priv->btxpos];
+        }
+      else if (priv->bpending < I2C_FIFO_MAX_SIZE)
+        {
+          cmd = CMD_READ;
+          if (priv->btxpos == op->wlength)
+            {
+              cmd |= CMD_RESTART;
+            }
+
+          priv->bpending++;
+        }
+      else
+        {
+          break;
+        }
+
+      if (++priv->btxpos == total)
+        {
+          cmd |= CMD_STOP;
+          priv->btxop++;
+          priv->btxpos = 0;
+        }
+
+      i2c_reg_write(priv, CXD56_IC_DATA_CMD, cmd);
+      status = i2c_reg_read(priv, CXD56_IC_STATUS);
+    }
+
+  /* Done once everything is queued, received and the bus is idle.  The
+   * STOP_DET of the last operation always comes after that.
+   */
+
+  if (priv->btxop == priv->bcount && priv->brxop == priv->bcount &&
+      (status & STATUS_TFE) && !(status & STATUS_MST_ACTIVITY))
+    {
+      return true;
+    }
+
+  /* Wake up again when the RX FIFO holds every pending read or the TX FIFO
+   * runs low.
+   */
+
+  if (priv->bpending > 0)
+    {
+      i2c_reg_write(priv, CXD56_IC_RX_TL, priv->bpending - 1);
+      i2c_reg_rmw(priv, CXD56_IC_INTR_MASK, INTR_RX_FULL, INTR_RX_FULL);
+    }
+  else
+    {
+      i2c_reg_rmw(priv, CXD56_IC_INTR_MASK, 0, INTR_RX_FULL);
+    }
+
+  i2c_reg_rmw(priv, CXD56_IC_INTR_MASK,
+              priv->btxop < priv->bcount ? INTR_TX_EMPTY : 0,
+              INTR_TX_EMPTY);
+
+  return false;
+}
+
+/****************************************************************************
+ * Name: cxd56_i2c_batch
+ *
+ * Description:
+ *   Perform a list of register operations.  Consecutive operations on the
+ *   same device and frequency are run entirely by the interrupt handler,
+ *   so the caller only wakes once per device.
+ *
+ ****************************************************************************/
+
+static int cxd56_i2c_batch(FAR struct i2c_master_s *dev,
+                           FAR const struct i2c_batchop_s *ops, int count)
+{
+  struct cxd56_i2cdev_s *priv = (struct cxd56_i2cdev_s *)dev;
+  irqstate_t flags;
+  int done = 0;
+  int ret  = OK;
+  int n;
+
+  DEBUGASSERT(dev != NULL && ops != NULL);
+
+  i2c_takesem(&priv->mutex);
+  cxd56_i2c_clock_gate_disable(priv->port);
+
+  while (done < count)
+    {
+      for (n = 0; done + n < count; n++)
+        {
+          if (ops[done + n].addr != ops[done].addr ||
+              ops[done + n].frequency != ops[done].frequency)
+            {
+              break;
+            }
+
+          if (ops[done + n].wlength == 0)
+            {
+              ret = -EINVAL;
+              break;
+            }
+        }
+
+      if (ret < 0)
+        {
+          break;
+        }
+
+      cxd56_i2c_disable(priv);
+      cxd56_i2c_setfrequency(priv, ops[done].frequency);
+      i2c_reg_rmw(priv, CXD56_IC_CON, IC_RESTART_EN, IC_RESTART_EN);
+      i2c_reg_write(priv, CXD56_IC_TAR, ops[done].addr & 0x7f);
+      i2c_reg_write(priv, CXD56_IC_TX_TL, I2C_FIFO_MAX_SIZE / 2);
+      cxd56_i2c_enable(priv);
+
+      priv->error    = OK;
+      priv->bcount   = n;
+      priv->btxop    = 0;
+      priv->btxpos   = 0;
+      priv->brxop    = 0;
+      priv->brxpos   = 0;
+      priv->bpending = 0;
+
+      flags = enter_critical_section();
+      wd_start(priv->timeout, I2C_TIMEOUT * n, cxd56_i2c_timeout, 1,
+               (uint32_t)priv);
+      priv->bops = &ops[done];
+      cxd56_i2c_batchirq(priv);
+      leave_critical_section(flags);
+
+      i2c_takesem(&priv->wait);
+
+      flags      = enter_critical_section();
+      priv->bops = NULL;
+      leave_critical_section(flags);
+
+      if (priv->error != OK)
+        {
+          ret = priv->error;
+          break;
+        }
+
+      done += n;
+    }
+
+  cxd56_i2c_disable(priv);
+  i2c_reg_write(priv, CXD56_IC_TX_TL, 0);
+
+  cxd56_i2c_clock_gate_enable(priv->port);
+  i2c_givesem(&priv->mutex);
+
+  return done > 0 ? done : ret;
+}
+
+#endif /* CONFIG_I2C_BATCH */
+
 /****************************************************************************
  * Name: cxd56_i2c_reset
  *
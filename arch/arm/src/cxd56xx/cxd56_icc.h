@@ -49,6 +49,7 @@
 #define CXD56_PROTO_PM       10 /* Power manager */
 #define CXD56_PROTO_SYSCTL   12
 #define CXD56_PROTO_GNSS     13
+#define CXD56_PROTO_RING     14 /* Shared memory ring doorbell */
 #define CXD56_PROTO_SIG      15 /* Inter-CPU Comm signal */
 
 typedef int (*cxd56_icchandler_t)(int cpuid, int protoid, uint32_t pdata,
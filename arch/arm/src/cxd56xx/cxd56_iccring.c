@@ -0,0 +1,543 @@
+/****************************************************************************
+ * arch/arm/src/cxd56xx/cxd56_iccring.c
+ *
+ *   Copyright 2018 Sony Semiconductor Solutions Corporation
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in
+ *    the documentation and/or other materials provided with the
+ *    distribution.
+ * 3. Neither the name of Sony Semiconductor Solutions Corporation nor
+ *    the names of its contributors may be used to endorse or promote
+ *    products derived from this software without specific prior written
+ *    permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+ * FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE
+ * COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+ * INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,
+ * BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS
+ * OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED
+ * AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ * LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN
+ * ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ *
+ ****************************************************************************/
+
+/****************************************************************************
+ * Included Files
+ ****************************************************************************/
+
+#include <nuttx/config.h>
+
+#include <nuttx/arch.h>
+#include <nuttx/cache.h>
+#include <nuttx/clock.h>
+#include <nuttx/irq.h>
+#include <nuttx/semaphore.h>
+
+#include <stdint.h>
+#include <string.h>
+#include <errno.h>
+#include <debug.h>
+
+#include "barriers.h"
+#include "cxd56_icc.h"
+#include "cxd56_iccring.h"
+
+#ifdef CONFIG_CXD56_ICCRING
+
+/****************************************************************************
+ * Pre-processor Definitions
+ ****************************************************************************/
+
+#define ICCRING_MAGIC     0x49524e47 /* "IRNG" */
+#define NCHANNELS         CONFIG_CXD56_ICCRING_NCHANNELS
+
+/****************************************************************************
+ * Private Types
+ ****************************************************************************/
+
+/* The state of one end of the ring.  It fills a cache line of its own and
+ * is only ever written by the CPU that owns that end.
+ */
+
+struct iccring_end_s
+{
+  volatile uint32_t index;      /* Head (producer) or tail (consumer) */
+  volatile uint32_t waitreq;    /* Bumped before the owner goes to sleep */
+  uint32_t reserved[CXD56_ICCRING_ALIGN / 4 - 2];
+};
+
+struct iccring_hdr_s
+{
+  struct iccring_end_s prod;
+  struct iccring_end_s cons;
+
+  uint32_t magic;
+  uint32_t nslots;
+  uint32_t slotsize;
+  uint32_t stride;
+  uint32_t reserved[CXD56_ICCRING_ALIGN / 4 - 4];
+};
+
+/****************************************************************************
+ * Private Data
+ ****************************************************************************/
+
+static FAR struct cxd56_iccring_s *g_iccring[NCHANNELS];
+static bool g_iccring_initialized;
+
+/****************************************************************************
+ * Private Functions
+ ****************************************************************************/
+
+static inline FAR struct iccring_hdr_s *
+iccring_hdr(FAR struct cxd56_iccring_s *ring)
+{
+  return (FAR struct iccring_hdr_s *)ring->base;
+}
+
+static inline FAR struct iccring_end_s *
+iccring_self(FAR struct cxd56_iccring_s *ring)
+{
+  FAR struct iccring_hdr_s *hdr = iccring_hdr(ring);
+  return ring->producer ? &hdr->prod : &hdr->cons;
+}
+
+static inline FAR struct iccring_end_s *
+iccring_peer(FAR struct cxd56_iccring_s *ring)
+{
+  FAR struct iccring_hdr_s *hdr = iccring_hdr(ring);
+  return ring->producer ? &hdr->cons : &hdr->prod;
+}
+
+static inline FAR uint8_t *iccring_slot(FAR struct cxd56_iccring_s *ring,
+                                        uint32_t index)
+{
+  return ring->base + CXD56_ICCRING_HDRSIZE +
+         (index & (ring->nslots - 1)) * ring->stride;
+}
+
+static inline FAR volatile uint32_t *
+iccring_slotlen(FAR struct cxd56_iccring_s *ring, FAR uint8_t *slot)
+{
+  return (FAR volatile uint32_t *)(slot + ((ring->slotsize + 3) & ~3));
+}
+
+/* Cache maintenance for the shared block.  These compile to nothing on
+ * parts without a data cache.
+ */
+
+static inline void iccring_clean(FAR const void *addr, size_t size)
+{
+  up_clean_dcache((uintptr_t)addr, (uintptr_t)addr + size);
+}
+
+static inline void iccring_invalidate(FAR const void *addr, size_t size)
+{
+  up_invalidate_dcache((uintptr_t)addr, (uintptr_t)addr + size);
+}
+
+/****************************************************************************
+ * Name: iccring_ready
+ *
+ * Description:
+ *   Return true if the producer has a free slot or the consumer has a
+ *   filled slot.
+ *
+ ****************************************************************************/
+
+static bool iccring_ready(FAR struct cxd56_iccring_s *ring)
+{
+  FAR struct iccring_end_s *peer = iccring_peer(ring);
+  uint32_t index;
+
+  iccring_invalidate(peer, sizeof(struct iccring_end_s));
+  index = peer->index;
+
+  if (ring->producer)
+    {
+      return ring->index - index < ring->nslots;
+    }
+
+  return index != ring->index;
+}
+
+/****************************************************************************
+ * Name: iccring_kick
+ *
+ * Description:
+ *   Called after this end has published a new index.  Ring the doorbell
+ *   only if the peer asked for one since the last doorbell; a peer that is
+ *   still running will see the new index by itself.
+ *
+ ****************************************************************************/
+
+static int iccring_kick(FAR struct cxd56_iccring_s *ring)
+{
+  FAR struct iccring_end_s *peer = iccring_peer(ring);
+  iccmsg_t msg;
+  uint32_t req;
+
+  /* Order the index store before the load of the peer's request.  The peer
+   * does the same in the other direction, so at least one of us sees the
+   * other's update.
+   */
+
+  ARM_DMB();
+
+  iccring_invalidate(peer, sizeof(struct iccring_end_s));
+  req = peer->waitreq;
+  if (req == ring->ack)
+    {
+      return OK;
+    }
+
+  ring->ack = req;
+
+  msg.cpuid     = ring->cpuid;
+  msg.msgid     = 0;
+  msg.protodata = 0;
+  msg.data      = ring->chanid;
+
+  return cxd56_iccsend(CXD56_PROTO_RING, &msg, 0);
+}
+
+/****************************************************************************
+ * Name: iccring_publish
+ *
+ * Description:
+ *   Make the local index visible to the peer and wake it if it sleeps.
+ *
+ ****************************************************************************/
+
+static int iccring_publish(FAR struct cxd56_iccring_s *ring)
+{
+  FAR struct iccring_end_s *self = iccring_self(ring);
+
+  /* Slot contents must be visible before the index that covers them */
+
+  ARM_DMB();
+
+  self->index = ring->index;
+  iccring_clean(self, sizeof(struct iccring_end_s));
+
+  return iccring_kick(ring);
+}
+
+/****************************************************************************
+ * Name: iccring_wait
+ *
+ * Description:
+ *   Wait until iccring_ready() is true.
+ *
+ ****************************************************************************/
+
+static int iccring_wait(FAR struct cxd56_iccring_s *ring, int32_t ms)
+{
+  FAR struct iccring_end_s *self = iccring_self(ring);
+  clock_t start = clock_systimer();
+  int ret;
+
+  while (!iccring_ready(ring))
+    {
+      if (ms < 0)
+        {
+          return -EAGAIN;
+        }
+
+      /* Ask the peer for a doorbell, then look once more in case it moved
+       * before it could see the request.
+       */
+
+      self->waitreq++;
+      iccring_clean(self, sizeof(struct iccring_end_s));
+      ARM_DMB();
+
+      if (iccring_ready(ring))
+        {
+          break;
+        }
+
+      if (ms == 0)
+        {
+          ret = nxsem_wait_uninterruptible(&ring->wait);
+        }
+      else
+        {
+          ret = nxsem_tickwait_uninterruptible(&ring->wait, start,
+                                               MSEC2TICK(ms));
+        }
+
+      if (ret < 0)
+        {
+          return ret;
+        }
+    }
+
+  return OK;
+}
+
+/****************************************************************************
+ * Name: iccring_rxhandler
+ *
+ * Description:
+ *   Doorbell from the peer, called from the CPU FIFO interrupt.
+ *
+ ****************************************************************************/
+
+static int iccring_rxhandler(int cpuid, int protoid, uint32_t pdata,
+                             uint32_t data, FAR void *userdata)
+{
+  FAR struct cxd56_iccring_s *ring;
+
+  if (data < NCHANNELS)
+    {
+      ring = g_iccring[data];
+      if (ring != NULL && ring->cpuid == cpuid)
+        {
+          nxsem_post(&ring->wait);
+        }
+    }
+
+  return OK;
+}
+
+/****************************************************************************
+ * Public Functions
+ ****************************************************************************/
+
+int cxd56_iccring_format(FAR void *mem, size_t memsize, size_t slotsize)
+{
+  FAR struct iccring_hdr_s *hdr = (FAR struct iccring_hdr_s *)mem;
+  uint32_t stride;
+  uint32_t nslots;
+
+  if (mem == NULL || ((uintptr_t)mem & (CXD56_ICCRING_ALIGN - 1)) != 0 ||
+      slotsize == 0 || memsize < CXD56_ICCRING_HDRSIZE)
+    {
+      return -EINVAL;
+    }
+
+  /* Use the largest power of two number of slots that fits */
+
+  stride = CXD56_ICCRING_STRIDE(slotsize);
+  nslots = (memsize - CXD56_ICCRING_HDRSIZE) / stride;
+  if (nslots < 2)
+    {
+      return -ENOMEM;
+    }
+
+  while ((nslots & (nslots - 1)) != 0)
+    {
+      nslots &= nslots - 1;
+    }
+
+  memset(hdr, 0, sizeof(struct iccring_hdr_s));
+  hdr->nslots   = nslots;
+  hdr->slotsize = slotsize;
+  hdr->stride   = stride;
+  hdr->magic    = ICCRING_MAGIC;
+  iccring_clean(hdr, sizeof(struct iccring_hdr_s));
+
+  return nslots;
+}
+
+int cxd56_iccring_open(FAR struct cxd56_iccring_s *ring, FAR void *mem,
+                       int cpuid, int chanid, bool producer)
+{
+  FAR struct iccring_hdr_s *hdr = (FAR struct iccring_hdr_s *)mem;
+  irqstate_t flags;
+  int ret;
+
+  if (ring == NULL || mem == NULL || chanid < 0 || chanid >= NCHANNELS)
+    {
+      return -EINVAL;
+    }
+
+  iccring_invalidate(hdr, sizeof(struct iccring_hdr_s));
+  if (hdr->magic != ICCRING_MAGIC)
+    {
+      return -EINVAL;
+    }
+
+  if (!g_iccring_initialized)
+    {
+      ret = cxd56_iccinit(CXD56_PROTO_RING);
+      if (ret < 0)
+        {
+          return ret;
+        }
+
+      cxd56_iccregisterhandler(CXD56_PROTO_RING, iccring_rxhandler, NULL);
+      g_iccring_initialized = true;
+    }
+
+  memset(ring, 0, sizeof(struct cxd56_iccring_s));
+  ring->base     = (FAR uint8_t *)mem;
+  ring->nslots   = hdr->nslots;
+  ring->slotsize = hdr->slotsize;
+  ring->stride   = hdr->stride;
+  ring->cpuid    = cpuid;
+  ring->chanid   = chanid;
+  ring->producer = producer;
+  ring->index    = iccring_self(ring)->index;
+  ring->ack      = iccring_peer(ring)->waitreq;
+
+  nxsem_init(&ring->wait, 0, 0);
+  nxsem_setprotocol(&ring->wait, SEM_PRIO_NONE);
+
+  flags = enter_critical_section();
+  if (g_iccring[chanid] != NULL)
+    {
+      leave_critical_section(flags);
+      nxsem_destroy(&ring->wait);
+      return -EBUSY;
+    }
+
+  g_iccring[chanid] = ring;
+  leave_critical_section(flags);
+
+  return OK;
+}
+
+void cxd56_iccring_close(FAR struct cxd56_iccring_s *ring)
+{
+  irqstate_t flags;
+
+  flags = enter_critical_section();
+  if (g_iccring[ring->chanid] == ring)
+    {
+      g_iccring[ring->chanid] = NULL;
+    }
+
+  leave_critical_section(flags);
+  nxsem_destroy(&ring->wait);
+}
+
+int cxd56_iccring_lease(FAR struct cxd56_iccring_s *ring, FAR void **buf,
+                        int32_t ms)
+{
+  int ret;
+
+  DEBUGASSERT(ring != NULL && ring->producer && buf != NULL);
+
+  if (!ring->leased)
+    {
+      /* Hand over anything still held back for batching before waiting for
+       * the consumer to make room.
+       */
+
+      if (!iccring_ready(ring))
+        {
+          ret = cxd56_iccring_flush(ring);
+          if (ret < 0)
+            {
+              return ret;
+            }
+
+          ret = iccring_wait(ring, ms);
+          if (ret < 0)
+            {
+              return ret;
+            }
+        }
+
+      ring->leased = true;
+    }
+
+  *buf = iccring_slot(ring, ring->index);
+  return OK;
+}
+
+int cxd56_iccring_commit(FAR struct cxd56_iccring_s *ring, size_t len,
+                         bool flush)
+{
+  FAR uint8_t *slot;
+
+  DEBUGASSERT(ring != NULL && ring->producer);
+
+  if (!ring->leased || len > ring->slotsize)
+    {
+      return -EINVAL;
+    }
+
+  slot = iccring_slot(ring, ring->index);
+  *iccring_slotlen(ring, slot) = len;
+  iccring_clean(slot, ring->stride);
+
+  ring->index++;
+  ring->leased = false;
+
+  return flush ? cxd56_iccring_flush(ring) : OK;
+}
+
+int cxd56_iccring_flush(FAR struct cxd56_iccring_s *ring)
+{
+  DEBUGASSERT(ring != NULL && ring->producer);
+
+  if (iccring_self(ring)->index == ring->index)
+    {
+      return OK;
+    }
+
+  return iccring_publish(ring);
+}
+
+int cxd56_iccring_peek(FAR struct cxd56_iccring_s *ring, FAR void **buf,
+                       FAR size_t *len, int32_t ms)
+{
+  FAR uint8_t *slot;
+  int ret;
+
+  DEBUGASSERT(ring != NULL && !ring->producer && buf != NULL);
+
+  ret = iccring_wait(ring, ms);
+  if (ret < 0)
+    {
+      return ret;
+    }
+
+  /* Read the slot only after the head that covers it */
+
+  ARM_DMB();
+
+  slot = iccring_slot(ring, ring->index);
+  iccring_invalidate(slot, ring->stride);
+
+  *buf = slot;
+  if (len != NULL)
+    {
+      *len = *iccring_slotlen(ring, slot);
+    }
+
+  ring->leased = true;
+  return OK;
+}
+
+int cxd56_iccring_release(FAR struct cxd56_iccring_s *ring)
+{
+  DEBUGASSERT(ring != NULL && !ring->producer);
+
+  if (!ring->leased)
+    {
+      return -EINVAL;
+    }
+
+  ring->index++;
+  ring->leased = false;
+
+  return iccring_publish(ring);
+}
+
+#endif /* CONFIG_CXD56_ICCRING */
@@ -0,0 +1,196 @@
+/****************************************************************************
+ * arch/arm/src/cxd56xx/cxd56_iccring.h
+ *
+ *   Copyright 2018 Sony Semiconductor Solutions Corporation
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in
+ *    the documentation and/or other materials provided with the
+ *    distribution.
+ * 3. Neither the name of Sony Semiconductor Solutions Corporation nor
+ *    the names of its contributors may be used to endorse or promote
+ *    products derived from this software without specific prior written
+ *    permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+ * FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE
+ * COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+ * INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,
+ * BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS
+ * OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED
+ * AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ * LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN
+ * ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ *
+ ****************************************************************************/
+
+#ifndef __ARCH_ARM_SRC_CXD56XX_CXD56_ICCRING_H
+#define __ARCH_ARM_SRC_CXD56XX_CXD56_ICCRING_H
+
+/****************************************************************************
+ * Included Files
+ ****************************************************************************/
+
+#include <nuttx/config.h>
+
+#include <sys/types.h>
+#include <stdint.h>
+#include <stdbool.h>
+#include <semaphore.h>
+
+#ifdef CONFIG_CXD56_ICCRING
+
+/****************************************************************************
+ * Pre-processor Definitions
+ ****************************************************************************/
+
+/* A ring occupies one block of memory visible to both CPUs:
+ *
+ *   +--------------------+  Line written by the producer only
+ *   | head, wait request |
+ *   +--------------------+  Line written by the consumer only
+ *   | tail, wait request |
+ *   +--------------------+  Geometry, written once by cxd56_iccring_format
+ *   | magic, nslots ...  |
+ *   +--------------------+
+ *   | slot 0 | len       |  Each slot is CXD56_ICCRING_STRIDE(slotsize)
+ *   | slot 1 | len       |  bytes.  Payloads start on a cache line.
+ *   | ...                |
+ *   +--------------------+
+ *
+ * Only offsets are stored in the shared header, so the two CPUs may map
+ * the block at different addresses.
+ */
+
+#define CXD56_ICCRING_ALIGN       32
+#define CXD56_ICCRING_HDRSIZE     (3 * CXD56_ICCRING_ALIGN)
+#define CXD56_ICCRING_STRIDE(s) \
+  ((((((s) + 3) & ~3) + 4) + CXD56_ICCRING_ALIGN - 1) & \
+   ~(CXD56_ICCRING_ALIGN - 1))
+#define CXD56_ICCRING_MEMSIZE(n, s) \
+  (CXD56_ICCRING_HDRSIZE + (n) * CXD56_ICCRING_STRIDE(s))
+
+/****************************************************************************
+ * Public Types
+ ****************************************************************************/
+
+/* Per-CPU view of one end of a ring.  The fields are private to
+ * cxd56_iccring.c.
+ */
+
+struct cxd56_iccring_s
+{
+  FAR uint8_t *base;      /* The shared block as mapped on this CPU */
+  uint32_t nslots;        /* Number of slots (a power of two) */
+  uint32_t slotsize;      /* Usable bytes per slot */
+  uint32_t stride;        /* Distance between slots */
+  uint32_t index;         /* Local head (producer) or tail (consumer) */
+  uint32_t ack;           /* Last peer wait request answered */
+  uint8_t cpuid;          /* Peer CPU */
+  uint8_t chanid;         /* Channel number, shared by both ends */
+  bool producer;          /* True: this end writes the ring */
+  bool leased;            /* True: a slot is lent to the caller */
+  sem_t wait;             /* Posted by doorbells from the peer */
+};
+
+/****************************************************************************
+ * Public Function Prototypes
+ ****************************************************************************/
+
+#ifndef __ASSEMBLY__
+#ifdef __cplusplus
+#define EXTERN extern "C"
+extern "C"
+{
+#else
+#define EXTERN extern
+#endif
+
+/****************************************************************************
+ * Name: cxd56_iccring_format
+ *
+ * Description:
+ *   Lay out a ring in a block of shared memory.  This is done once, by
+ *   either CPU, before both ends call cxd56_iccring_open().  The address
+ *   of the block is then passed to the peer by the usual ICC messages.
+ *
+ * Input Parameters:
+ *   mem      - Shared memory, aligned to CXD56_ICCRING_ALIGN
+ *   memsize  - Size of the block
+ *   slotsize - Largest payload carried in one slot
+ *
+ * Returned Value:
+ *   The number of slots on success; a negated errno value on failure.
+ *
+ ****************************************************************************/
+
+int cxd56_iccring_format(FAR void *mem, size_t memsize, size_t slotsize);
+
+/****************************************************************************
+ * Name: cxd56_iccring_open
+ *
+ * Description:
+ *   Attach to one end of a formatted ring.  Each CPU opens the ring once;
+ *   exactly one of them as producer.  Both ends use the same chanid, which
+ *   must be unique among the rings opened on each CPU.
+ *
+ ****************************************************************************/
+
+int cxd56_iccring_open(FAR struct cxd56_iccring_s *ring, FAR void *mem,
+                       int cpuid, int chanid, bool producer);
+void cxd56_iccring_close(FAR struct cxd56_iccring_s *ring);
+
+/****************************************************************************
+ * Name: cxd56_iccring_lease / cxd56_iccring_commit / cxd56_iccring_flush
+ *
+ * Description:
+ *   Producer side.  cxd56_iccring_lease() lends the next free slot to the
+ *   caller, who fills it in place and hands it over with
+ *   cxd56_iccring_commit().  Committed slots become visible to the
+ *   consumer, and the consumer is woken, only when flush is true, when
+ *   cxd56_iccring_flush() is called or when lease finds the ring full, so
+ *   a burst of slots costs a single doorbell.  No doorbell is sent at all
+ *   while the consumer is running.
+ *
+ *   ms is -1 to fail with -EAGAIN when the ring is full, 0 to wait
+ *   forever, or a timeout in milliseconds (-ETIMEDOUT).
+ *
+ ****************************************************************************/
+
+int cxd56_iccring_lease(FAR struct cxd56_iccring_s *ring, FAR void **buf,
+                        int32_t ms);
+int cxd56_iccring_commit(FAR struct cxd56_iccring_s *ring, size_t len,
+                         bool flush);
+int cxd56_iccring_flush(FAR struct cxd56_iccring_s *ring);
+
+/****************************************************************************
+ * Name: cxd56_iccring_peek / cxd56_iccring_release
+ *
+ * Description:
+ *   Consumer side.  cxd56_iccring_peek() returns the oldest slot in place;
+ *   cxd56_iccring_release() gives it back to the producer.  ms is as for
+ *   cxd56_iccring_lease().
+ *
+ ****************************************************************************/
+
+int cxd56_iccring_peek(FAR struct cxd56_iccring_s *ring, FAR void **buf,
+                       FAR size_t *len, int32_t ms);
+int cxd56_iccring_release(FAR struct cxd56_iccring_s *ring);
+
+#undef EXTERN
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* __ASSEMBLY__ */
+#endif /* CONFIG_CXD56_ICCRING */
+#endif /* __ARCH_ARM_SRC_CXD56XX_CXD56_ICCRING_H */
@@ -55,6 +55,7 @@
 #include "up_internal.h"
 
 #include "cxd56_irq.h"
+#include "cxd56_cpupause.h"
 
 #ifdef CONFIG_SMP
 #  include "init/init.h"
@@ -94,7 +95,6 @@ volatile uint32_t *g_current_regs[1];
 
 #ifdef CONFIG_SMP
 static volatile int8_t g_cpu_for_irq[CXD56_IRQ_NIRQS];
-extern void up_send_irqreq(int idx, int irq, int cpu);
 #endif
 
 /* This is the address of the  exception vector table (determined by the
@@ -459,14 +459,14 @@ void up_disable_irq(int irq)
       g_cpu_for_irq[irq] = -1;
 #endif
 
-      irqstate_t flags = spin_lock_irqsave();
+      irqstate_t flags = spin_lock_irqsave(NULL);
       irq -= CXD56_IRQ_EXTINT;
       bit  = 1 << (irq & 0x1f);
 
       regval  = getreg32(INTC_EN(irq));
       regval &= ~bit;
       putreg32(regval, INTC_EN(irq));
-      spin_unlock_irqrestore(flags);
+      spin_unlock_irqrestore(NULL, flags);
       putreg32(bit, NVIC_IRQ_CLEAR(irq));
     }
   else
@@ -514,14 +514,14 @@ void up_enable_irq(int irq)
         }
 #endif
 
-      irqstate_t flags = spin_lock_irqsave();
+      irqstate_t flags = spin_lock_irqsave(NULL);
       irq -= CXD56_IRQ_EXTINT;
       bit  = 1 << (irq & 0x1f);
 
       regval  = getreg32(INTC_EN(irq));
       regval |= bit;
       putreg32(regval, INTC_EN(irq));
-      spin_unlock_irqrestore(flags);
+      spin_unlock_irqrestore(NULL, flags);
       putreg32(bit, NVIC_IRQ_ENABLE(irq));
     }
   else
@@ -42,11 +42,14 @@
 
 #include <sys/types.h>
 #include <stdint.h>
+#include <stdbool.h>
 #include <stdio.h>
 #include <errno.h>
 #include <assert.h>
 #include <debug.h>
 
+#include <nuttx/irq.h>
+
 #include "chip.h"
 #include "up_arch.h"
 
@@ -75,6 +78,34 @@
 #define PWM_PARAM_OFFPERIOD_SHIFT   (16)
 #define PWM_PHASE_PRESCALE_SHIFT    (16)
 
+#define PWM_NCHANNELS               (4)
+
+/* The channels that the multi-channel device drives */
+
+#ifdef CONFIG_CXD56_PWM0
+#  define PWM_MASK_CH0              (1 << CXD56_PWM_CH0)
+#else
+#  define PWM_MASK_CH0              (0)
+#endif
+#ifdef CONFIG_CXD56_PWM1
+#  define PWM_MASK_CH1              (1 << CXD56_PWM_CH1)
+#else
+#  define PWM_MASK_CH1              (0)
+#endif
+#ifdef CONFIG_CXD56_PWM2
+#  define PWM_MASK_CH2              (1 << CXD56_PWM_CH2)
+#else
+#  define PWM_MASK_CH2              (0)
+#endif
+#ifdef CONFIG_CXD56_PWM3
+#  define PWM_MASK_CH3              (1 << CXD56_PWM_CH3)
+#else
+#  define PWM_MASK_CH3              (0)
+#endif
+
+#define PWM_MASK_ALL \
+  (PWM_MASK_CH0 | PWM_MASK_CH1 | PWM_MASK_CH2 | PWM_MASK_CH3)
+
 #ifndef itemsof
 #  define itemsof(array) (sizeof(array)/sizeof(array[0]))
 #endif
@@ -88,8 +119,21 @@
 struct cxd56_pwm_chan_s
 {
   const struct pwm_ops_s *ops;     /* PWM operations */
-  uint8_t ch;                      /* PWM channel: {0..3} */
+  uint8_t ch;                      /* PWM channel: {0..3} or CHMULTI */
   uint8_t prescale;                /* prescale (reserved) */
+#ifdef CONFIG_PWM_MULTICHAN
+  uint8_t chmask;                  /* Channels driven by this device */
+  uint8_t enabled;                 /* Channels started by this device */
+#endif
+};
+
+/* The register values computed for one channel */
+
+struct cxd56_pwm_param_s
+{
+  uint32_t param;                  /* PWM_PARAM register */
+  uint32_t phase;                  /* PWM_PHASE register */
+  bool     enable;                 /* false: Output low level */
 };
 
 typedef struct
@@ -141,6 +185,9 @@ static struct cxd56_pwm_chan_s g_pwm_ch0 =
   .ops        = &g_pwmops,
   .ch         = CXD56_PWM_CH0,
   .prescale   = 0,
+#ifdef CONFIG_PWM_MULTICHAN
+  .chmask     = 1 << CXD56_PWM_CH0,
+#endif
 };
 #endif
 
@@ -150,6 +197,9 @@ static struct cxd56_pwm_chan_s g_pwm_ch1 =
   .ops        = &g_pwmops,
   .ch         = CXD56_PWM_CH1,
   .prescale   = 0,
+#ifdef CONFIG_PWM_MULTICHAN
+  .chmask     = 1 << CXD56_PWM_CH1,
+#endif
 };
 #endif
 
@@ -159,6 +209,9 @@ static struct cxd56_pwm_chan_s g_pwm_ch2 =
   .ops        = &g_pwmops,
   .ch         = CXD56_PWM_CH2,
   .prescale   = 0,
+#ifdef CONFIG_PWM_MULTICHAN
+  .chmask     = 1 << CXD56_PWM_CH2,
+#endif
 };
 #endif
 
@@ -168,6 +221,19 @@ static struct cxd56_pwm_chan_s g_pwm_ch3 =
   .ops        = &g_pwmops,
   .ch         = CXD56_PWM_CH3,
   .prescale   = 0,
+#ifdef CONFIG_PWM_MULTICHAN
+  .chmask     = 1 << CXD56_PWM_CH3,
+#endif
+};
+#endif
+
+#ifdef CONFIG_PWM_MULTICHAN
+static struct cxd56_pwm_chan_s g_pwm_multi =
+{
+  .ops        = &g_pwmops,
+  .ch         = CXD56_PWM_CHMULTI,
+  .prescale   = 0,
+  .chmask     = PWM_MASK_ALL,
 };
 #endif
 
@@ -326,6 +392,99 @@ static int convert_freq2period(uint32_t freq, ub16_t duty, uint32_t *param,
   return OK;
 }
 
+/****************************************************************************
+ * Name: pwm_prepare
+ *
+ * Description:
+ *   Compute the register values of one channel without touching the
+ *   hardware.
+ *
+ * Input Parameters:
+ *   freq   - pwm frequency [Hz]
+ *   duty   - duty
+ *
+ * Output Parameters:
+ *   chparam - The register values
+ *
+ * Returned Value:
+ *   OK on success; A negated errno value on failure.
+ *
+ ****************************************************************************/
+
+static int pwm_prepare(uint32_t freq, ub16_t duty,
+                       FAR struct cxd56_pwm_param_s *chparam)
+{
+  int ret;
+
+  if (duty <= 0)
+    {
+      /* Output low level if duty cycle is almost 0% */
+
+      chparam->enable = false;
+    }
+  else if (duty >= 65536)
+    {
+      /* Output high level if duty cycle is almost 100% */
+
+      chparam->param  = 1;
+      chparam->phase  = 0;
+      chparam->enable = true;
+    }
+  else
+    {
+      ret = convert_freq2period(freq, duty, &chparam->param,
+                                &chparam->phase);
+      if (ret < 0)
+        {
+          return -EINVAL;
+        }
+
+      chparam->enable = true;
+    }
+
+  return OK;
+}
+
+/****************************************************************************
+ * Name: pwm_program
+ *
+ * Description:
+ *   Program the registers of one channel.  The duty cycle of a running
+ *   channel is changed on the fly.  A stopped channel is left disabled so
+ *   that the caller can enable several channels back to back.
+ *
+ * Input Parameters:
+ *   ch      - PWM channel: {0..3}
+ *   chparam - The register values
+ *
+ * Returned Value:
+ *   True if the caller must enable the channel.
+ *
+ ****************************************************************************/
+
+static bool pwm_program(uint8_t ch,
+                        FAR const struct cxd56_pwm_param_s *chparam)
+{
+  if (!chparam->enable)
+    {
+      PWM_REG(ch)->EN = 0x0;
+      return false;
+    }
+
+  if (PWM_REG(ch)->EN & 1)
+    {
+      /* Change duty cycle dynamically if already running */
+
+      PWM_REG(ch)->PARAM = chparam->param;
+      return false;
+    }
+
+  PWM_REG(ch)->EN = 0x0;
+  PWM_REG(ch)->PARAM = chparam->param;
+  PWM_PHASE_REG(ch)->PHASE = chparam->phase;
+  return true;
+}
+
 /****************************************************************************
  * Name: pwm_setup
  *
@@ -345,9 +504,24 @@ static int convert_freq2period(uint32_t freq, ub16_t duty, uint32_t *param,
 static int pwm_setup(FAR struct pwm_lowerhalf_s *dev)
 {
   FAR struct cxd56_pwm_chan_s *priv = (FAR struct cxd56_pwm_chan_s *)dev;
-  int ret;
+  int ret = OK;
+
+#ifdef CONFIG_PWM_MULTICHAN
+  /* PWM0/1 and PWM2/3 share a pin group each */
+
+  if ((priv->chmask & 0x3) != 0)
+    {
+      ret = pwm_pin_config(CXD56_PWM_CH0);
+    }
 
+  if (ret >= 0 && (priv->chmask & 0xc) != 0)
+    {
+      ret = pwm_pin_config(CXD56_PWM_CH2);
+    }
+#else
   ret = pwm_pin_config(priv->ch);
+#endif
+
   if (ret < 0)
     {
       pwmerr("Failed to pinconf() channel: %d\n", priv->ch);
@@ -393,52 +567,100 @@ static int pwm_shutdown(FAR struct pwm_lowerhalf_s *dev)
  *
  ****************************************************************************/
 
+#ifdef CONFIG_PWM_MULTICHAN
 static int pwm_start(FAR struct pwm_lowerhalf_s *dev,
                      FAR const struct pwm_info_s *info)
 {
   FAR struct cxd56_pwm_chan_s *priv = (FAR struct cxd56_pwm_chan_s *)dev;
-  uint32_t param;
-  uint32_t phase;
+  struct cxd56_pwm_param_s chparam[PWM_NCHANNELS];
+  irqstate_t flags;
+  uint8_t chmask = 0;
+  uint8_t start = 0;
+  int ch;
+  int i;
   int ret;
 
-  if (info->duty <= 0)
-    {
-      /* Output low level if duty cycle is almost 0% */
+  /* Validate every channel before touching any of them so that a bad
+   * entry leaves the output unchanged.
+   */
 
-      PWM_REG(priv->ch)->EN = 0x0;
-    }
-  else if (info->duty >= 65536)
+  for (i = 0; i < CONFIG_PWM_NCHANNELS; i++)
     {
-      /* Output high level if duty cycle is almost 100% */
+      ch = (int)info->channels[i].channel - 1;
+      if (ch < 0 || ch >= PWM_NCHANNELS || (priv->chmask & (1 << ch)) == 0)
+        {
+          continue;
+        }
 
-      PWM_REG(priv->ch)->PARAM = 1;
-      PWM_REG(priv->ch)->EN = 0x1;
-    }
-  else
-    {
-      ret = convert_freq2period(info->frequency, info->duty, &param, &phase);
+      ret = pwm_prepare(info->frequency, info->channels[i].duty,
+                        &chparam[ch]);
       if (ret < 0)
         {
-          return -EINVAL;
+          return ret;
         }
 
-      if (PWM_REG(priv->ch)->EN & 1)
+      chmask |= 1 << ch;
+    }
+
+  /* Program all of the channels first and then enable the stopped ones
+   * back to back, so that the new duty cycles take effect together.
+   */
+
+  flags = enter_critical_section();
+
+  for (ch = 0; ch < PWM_NCHANNELS; ch++)
+    {
+      if ((chmask & (1 << ch)) != 0)
         {
-          /* Change duty cycle dynamically if already running */
+          if (pwm_program(ch, &chparam[ch]))
+            {
+              start |= 1 << ch;
+            }
+
+          if (chparam[ch].enable)
+            {
+              priv->enabled |= 1 << ch;
+            }
+          else
+            {
+              priv->enabled &= ~(1 << ch);
+            }
+        }
+    }
 
-          PWM_REG(priv->ch)->PARAM = param;
-          return OK;
+  for (ch = 0; ch < PWM_NCHANNELS; ch++)
+    {
+      if ((start & (1 << ch)) != 0)
+        {
+          PWM_REG(ch)->EN = 0x1;
         }
+    }
+
+  leave_critical_section(flags);
+  return OK;
+}
+#else
+static int pwm_start(FAR struct pwm_lowerhalf_s *dev,
+                     FAR const struct pwm_info_s *info)
+{
+  FAR struct cxd56_pwm_chan_s *priv = (FAR struct cxd56_pwm_chan_s *)dev;
+  struct cxd56_pwm_param_s chparam;
+  int ret;
 
-      PWM_REG(priv->ch)->EN = 0x0;
-      PWM_REG(priv->ch)->PARAM = param;
-      PWM_PHASE_REG(priv->ch)->PHASE = phase;
+  ret = pwm_prepare(info->frequency, info->duty, &chparam);
+  if (ret < 0)
+    {
+      return ret;
+    }
 
+  if (pwm_program(priv->ch, &chparam))
+    {
       PWM_REG(priv->ch)->EN = 0x1;
     }
 
   return OK;
 }
+#endif
 
 /****************************************************************************
  * Name: pwm_stop
@@ -457,8 +679,25 @@ static int pwm_start(FAR struct pwm_lowerhalf_s *dev,
 static int pwm_stop(FAR struct pwm_lowerhalf_s *dev)
 {
   FAR struct cxd56_pwm_chan_s *priv = (FAR struct cxd56_pwm_chan_s *)dev;
+#ifdef CONFIG_PWM_MULTICHAN
+  irqstate_t flags;
+  int ch;
 
+  flags = enter_critical_section();
+
+  for (ch = 0; ch < PWM_NCHANNELS; ch++)
+    {
+      if ((priv->enabled & (1 << ch)) != 0)
+        {
+          PWM_REG(ch)->EN = 0x0;
+        }
+    }
+
+  priv->enabled = 0;
+  leave_critical_section(flags);
+#else
   PWM_REG(priv->ch)->EN = 0x0;
+#endif
 
   return OK;
 }
@@ -531,6 +770,11 @@ FAR struct pwm_lowerhalf_s *cxd56_pwminitialize(uint32_t channel)
       case CXD56_PWM_CH3:
         pwmch = &g_pwm_ch3;
         break;
+#endif
+#ifdef CONFIG_PWM_MULTICHAN
+      case CXD56_PWM_CHMULTI:
+        pwmch = &g_pwm_multi;
+        break;
 #endif
       default:
         pwmerr("Illeagal channel number:%d\n", channel);
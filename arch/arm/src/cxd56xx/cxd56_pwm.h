@@ -56,6 +56,13 @@
 #define CXD56_PWM_CH2    2
 #define CXD56_PWM_CH3    3
 
+/* All of the enabled channels as one device (CONFIG_PWM_MULTICHAN only).
+ * The channels[] entries of struct pwm_info_s select PWM0-3 with the
+ * channel numbers 1-4; zero marks an unused entry.
+ */
+
+#define CXD56_PWM_CHMULTI 0xff
+
 /****************************************************************************
  * Public Types
  ****************************************************************************/
@@ -41,6 +41,9 @@
 #include <nuttx/kmalloc.h>
 #include <nuttx/irq.h>
 #include <nuttx/semaphore.h>
+#ifdef CONFIG_CXD56_SCU_RING
+#include <nuttx/wqueue.h>
+#endif
 
 #include <stdio.h>
 #include <stdint.h>
@@ -139,6 +142,21 @@ struct wm_notify_s
   struct scufifo_s *fifo;    /* Reverse reference to FIFO */
 };
 
+#ifdef CONFIG_CXD56_SCU_RING
+/* Sample ring attached to a FIFO */
+
+struct scuring_s
+{
+  FAR struct scufifo_ring_s *ring; /* Ring shared with application */
+  FAR struct seq_s *seq;           /* Owner sequencer */
+  int fifoid;                      /* FIFO ID in the owner sequencer */
+  uint32_t watermark;              /* Samples in ring to notify */
+  int signo;                       /* Signal number */
+  int pid;                         /* Target PID */
+  struct work_s work;              /* FIFO drain work */
+};
+#endif
+
 /* SCU FIFO management structure */
 
 struct scufifo_s
@@ -159,6 +177,10 @@ struct scufifo_s
   sem_t dmawait;  /* Wait semaphore for DMA complete */
   int dmaresult;  /* DMA result */
 #endif
+
+#ifdef CONFIG_CXD56_SCU_RING
+  FAR struct scuring_s *ring; /* Attached sample ring */
+#endif
 };
 
 /* Sequencer */
@@ -214,6 +236,9 @@ struct cxd56_scudev_s
 #ifndef CONFIG_DISABLE_SIGNAL
   struct ev_notify_s event[3]; /* MATHFUNC event notify */
   struct wm_notify_s wm[14];   /* Watermark notify */
+#endif
+#ifdef CONFIG_CXD56_SCU_RING
+  FAR struct scuring_s *ring[14]; /* Sample rings, indexed by read FIFO ID */
 #endif
   int currentreq;
 };
@@ -288,6 +313,12 @@ static void seq_setdecimation(int wid, uint8_t ratio, uint8_t leveladj,
                               uint8_t forcethrough);
 static int seq_setwatermark(FAR struct seq_s *seq, int fifoid,
                             FAR struct scufifo_wm_s *wm);
+#ifdef CONFIG_CXD56_SCU_RING
+static void seq_ringworker(FAR void *arg);
+static int seq_setring(FAR struct seq_s *seq, int fifoid,
+                       FAR struct scufifo_ringcfg_s *cfg);
+static void seq_ringfree(FAR struct scufifo_s *fifo);
+#endif
 #ifndef CONFIG_DISABLE_SIGNAL
 static void convert_firsttimestamp(struct scutimestamp_s *tm,
                                    uint16_t interval, uint16_t sample,
@@ -1514,6 +1545,23 @@ static void seq_handlefifointr(FAR struct cxd56_scudev_s *priv, uint32_t intr)
 
           putreg32(bit, SCU_INT_CLEAR_MAIN);
 
+#ifdef CONFIG_CXD56_SCU_RING
+          /* FIFOs with a sample ring are drained by the worker, which
+           * notifies the application by the ring watermark instead.
+           */
+
+          if (priv->ring[i])
+            {
+              if (work_available(&priv->ring[i]->work))
+                {
+                  work_queue(LPWORK, &priv->ring[i]->work, seq_ringworker,
+                             priv->ring[i], 0);
+                }
+
+              continue;
+            }
+#endif
+
 #ifndef CONFIG_DISABLE_SIGNAL
           notify = &priv->wm[i];
 
@@ -2115,6 +2163,10 @@ static void seq_fifofree(FAR struct scufifo_s *fifo)
 
   putreg32(1 << (rid + 9), SCU_INT_DISABLE_MAIN);
 
+#ifdef CONFIG_CXD56_SCU_RING
+  seq_ringfree(fifo);
+#endif
+
   /* Make sure want to be FIFO disabled */
 
   putreg32(0, SCUFIFO_R_CTRL1(rid));
@@ -2344,6 +2396,209 @@ static int seq_seteventnotifier(FAR struct scufifo_s *fifo,
   return OK;
 }
 
+#ifdef CONFIG_CXD56_SCU_RING
+
+/****************************************************************************
+ * Name: seq_ringworker
+ *
+ * Description:
+ *   Drain the FIFO into its sample ring. Runs on the low priority work
+ *   queue, queued from the FIFO almost full interrupt.
+ *
+ ****************************************************************************/
+
+static void seq_ringworker(FAR void *arg)
+{
+  FAR struct scuring_s *r = (FAR struct scuring_s *)arg;
+  FAR struct scufifo_ring_s *ring = r->ring;
+  FAR struct scufifo_s *fifo = seq_getfifo(r->seq, r->fifoid);
+  uint32_t nsamples = ring->nsamples;
+  uint32_t head = ring->head;
+  uint32_t avail;
+  uint32_t space;
+  uint32_t chunk;
+  uint32_t used;
+  int len;
+#ifdef CONFIG_CAN_PASS_STRUCTS
+  union sigval value;
+#endif
+
+  DEBUGASSERT(fifo);
+
+  avail = getreg32(SCUFIFO_R_STATUS0(fifo->rid));
+  space = (ring->tail + nsamples - head - 1) % nsamples;
+
+  /* Drop the oldest samples which do not fit, so the ring always holds
+   * the latest data.
+   */
+
+  if (avail > space)
+    {
+      seq_read(r->seq, r->fifoid, NULL, (avail - space) * ring->sample);
+      ring->overrun += avail - space;
+      avail = space;
+    }
+
+  while (avail > 0)
+    {
+      chunk = MIN(avail, nsamples - head);
+      len = chunk * ring->sample;
+
+      if (seq_read(r->seq, r->fifoid,
+                   (FAR char *)&ring->data[head * ring->sample], len) < len)
+        {
+          break;
+        }
+
+      head = (head + chunk) % nsamples;
+      avail -= chunk;
+    }
+
+  ring->head = head;
+
+  used = (head + nsamples - ring->tail) % nsamples;
+  if (r->watermark && used >= r->watermark)
+    {
+#ifdef CONFIG_CAN_PASS_STRUCTS
+      value.sival_ptr = ring;
+      sigqueue(r->pid, r->signo, value);
+#else
+      sigqueue(r->pid, r->signo, (FAR void *)ring);
+#endif
+    }
+}
+
+/****************************************************************************
+ * Name: seq_setring
+ *
+ * Description:
+ *   Attach a sample ring to specified FIFO, or detach it when the ring size
+ *   is zero.
+ *
+ ****************************************************************************/
+
+static int seq_setring(FAR struct seq_s *seq, int fifoid,
+                       FAR struct scufifo_ringcfg_s *cfg)
+{
+  FAR struct cxd56_scudev_s *priv = &g_scudev;
+  FAR struct scufifo_s *fifo = seq_getfifo(seq, fifoid);
+  FAR struct scuring_s *r;
+  uint32_t watermark;
+  irqstate_t flags;
+
+  DEBUGASSERT(cfg);
+
+  if (!fifo)
+    {
+      return -EPERM;
+    }
+
+  if (seq_fifoisactive(seq, fifoid))
+    {
+      return -EBUSY;
+    }
+
+  seq_ringfree(fifo);
+
+  if (cfg->nsamples == 0)
+    {
+      return OK;
+    }
+
+  if (cfg->nsamples < 2 || cfg->watermark >= cfg->nsamples)
+    {
+      return -EINVAL;
+    }
+
+  r = (FAR struct scuring_s *)kmm_zalloc(sizeof(struct scuring_s));
+  if (!r)
+    {
+      return -ENOMEM;
+    }
+
+  /* Sample ring is accessed by application directly, so it must be
+   * allocated from user memory.
+   */
+
+  r->ring = (FAR struct scufifo_ring_s *)
+    kumm_zalloc(sizeof(struct scufifo_ring_s) +
+                cfg->nsamples * seq->sample);
+  if (!r->ring)
+    {
+      kmm_free(r);
+      return -ENOMEM;
+    }
+
+  r->ring->nsamples = cfg->nsamples;
+  r->ring->sample = seq->sample;
+  r->seq = seq;
+  r->fifoid = fifoid;
+  r->watermark = cfg->watermark;
+  r->signo = cfg->signo;
+  r->pid = getpid();
+
+  /* Drain the FIFO at half full, or earlier when ring watermark is
+   * smaller than that.
+   */
+
+  watermark = fifo->size / seq->sample / 2;
+  if (cfg->watermark)
+    {
+      watermark = MIN(watermark, cfg->watermark);
+    }
+
+  watermark = MAX(watermark, 1);
+
+  flags = enter_critical_section();
+  fifo->ring = r;
+  priv->ring[fifo->rid] = r;
+
+  putreg32(watermark, SCUFIFO_R_CTRL0(fifo->rid));
+
+  /* Enable FIFO almost full interrupt */
+
+  putreg32(1 << (fifo->rid + 9), SCU_INT_ENABLE_MAIN);
+
+  leave_critical_section(flags);
+
+  scuinfo("ring = %p, samples = %d, watermark = %d\n", r->ring,
+          cfg->nsamples, watermark);
+
+  return OK;
+}
+
+/****************************************************************************
+ * Name: seq_ringfree
+ *
+ * Description:
+ *   Detach and free the sample ring of specified FIFO
+ *
+ ****************************************************************************/
+
+static void seq_ringfree(FAR struct scufifo_s *fifo)
+{
+  FAR struct cxd56_scudev_s *priv = &g_scudev;
+  FAR struct scuring_s *r = fifo->ring;
+  irqstate_t flags;
+
+  if (!r)
+    {
+      return;
+    }
+
+  flags = enter_critical_section();
+  putreg32(1 << (fifo->rid + 9), SCU_INT_DISABLE_MAIN);
+  priv->ring[fifo->rid] = NULL;
+  fifo->ring = NULL;
+  leave_critical_section(flags);
+
+  work_cancel(LPWORK, &r->work);
+
+  kumm_free(r->ring);
+  kmm_free(r);
+}
+#endif /* CONFIG_CXD56_SCU_RING */
+
 #ifndef CONFIG_DISABLE_SIGNAL
 
 /****************************************************************************
@@ -3388,6 +3643,43 @@ int seq_ioctl(FAR struct seq_s *seq, int fifoid, int cmd, unsigned long arg)
         }
         break;
 
+#ifdef CONFIG_CXD56_SCU_RING
+      /**
+       * Attach or detach FIFO sample ring
+       * Arg: Pointer of struct scufifo_ringcfg_s
+       */
+
+      case SCUIOC_SETRING:
+        {
+          FAR struct scufifo_ringcfg_s *cfg =
+            (FAR struct scufifo_ringcfg_s *)(uintptr_t)arg;
+
+          ret = seq_setring(seq, fifoid, cfg);
+        }
+        break;
+
+      /**
+       * Get FIFO sample ring
+       * Arg: Pointer of FAR struct scufifo_ring_s *
+       */
+
+      case SCUIOC_GETRING:
+        {
+          FAR struct scufifo_ring_s **ppring =
+            (FAR struct scufifo_ring_s **)(uintptr_t)arg;
+          FAR struct scufifo_s *fifo = seq_getfifo(seq, fifoid);
+
+          if (!fifo || !fifo->ring)
+            {
+              ret = -ENODEV;
+              break;
+            }
+
+          *ppring = fifo->ring->ring;
+        }
+        break;
+#endif
+
       /* Sequencer start */
 
       case SCUIOC_START:
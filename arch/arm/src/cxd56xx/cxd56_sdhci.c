@@ -2908,7 +2908,13 @@ static int cxd56_sdio_dmarecvsetup(FAR struct sdio_dev_s *dev,
 
   /* Configure the RX DMA */
 
-  cxd56_sdio_admasetup(buffer,  buflen);
+  ret = cxd56_sdio_admasetup(buffer, buflen);
+  if (ret != OK)
+    {
+      mcerr("ERROR: Too long for ADMA descriptors: %d\n", buflen);
+      goto error;
+    }
+
   priv->usedma = true;
 
   cxd56_configxfrints(priv, SDHCI_DMADONE_INTS);
@@ -3019,7 +3025,13 @@ static int cxd56_sdio_dmasendsetup(FAR struct sdio_dev_s *dev,
 
   /* Configure the TX DMA */
 
-  cxd56_sdio_admasetup(buffer, buflen);
+  ret = cxd56_sdio_admasetup(buffer, buflen);
+  if (ret != OK)
+    {
+      mcerr("ERROR: Too long for ADMA descriptors: %d\n", buflen);
+      goto error;
+    }
+
   priv->usedma = true;
   if (priv->dmasend_prepare)
     {
@@ -55,6 +55,8 @@
 
 #include <nuttx/irq.h>
 #include <nuttx/arch.h>
+#include <nuttx/clock.h>
+#include <nuttx/wdog.h>
 #include <nuttx/serial/serial.h>
 
 #include <arch/board/board.h>
@@ -66,6 +68,7 @@
 #include "cxd56_config.h"
 #include "cxd56_serial.h"
 #include "cxd56_powermgr.h"
+#include "cxd56_dmac.h"
 
 /****************************************************************************
  * Pre-processor definitions
@@ -77,6 +80,20 @@
 
 #if defined(USE_SERIALDRIVER) && defined(HAVE_UART)
 
+/* UART2 can receive with a circular DMA */
+
+#if defined(CONFIG_CXD56_UART2) && defined(CONFIG_CXD56_DMAC_UART2_RX)
+#  define HAVE_RXDMA 1
+
+#  if CONFIG_UART2_RXBUFSIZE & 1
+#    error "CONFIG_UART2_RXBUFSIZE must be even for RX DMA"
+#  endif
+
+#  define RXDMA_IDLE_TICKS \
+     (MSEC2TICK(CONFIG_CXD56_DMAC_UART2_RX_IDLE) > 0 ? \
+      MSEC2TICK(CONFIG_CXD56_DMAC_UART2_RX_IDLE) : 1)
+#endif
+
 /****************************************************************************
  * Private Types
  ****************************************************************************/
@@ -102,6 +119,11 @@ struct up_dev_s
   bool dtrdir;        /* DTR pin is the direction bit */
 #endif
   void *pmhandle;
+#ifdef HAVE_RXDMA
+  DMA_HANDLE rxdma;   /* Circular RX DMA channel (NULL: interrupt driven) */
+  WDOG_ID rxidle;     /* Idle-line poll timer */
+  size_t rxpos;       /* DMA position at the last idle poll */
+#endif
 };
 
 /****************************************************************************
@@ -128,6 +150,13 @@ static void up_send(FAR struct uart_dev_s *dev, int ch);
 static void up_txint(FAR struct uart_dev_s *dev, bool enable);
 static bool up_txready(FAR struct uart_dev_s *dev);
 static bool up_txempty(FAR struct uart_dev_s *dev);
+#ifdef HAVE_RXDMA
+static size_t up_dma_rxpos(FAR struct uart_dev_s *dev);
+static void up_dma_rxcallback(DMA_HANDLE handle, uint8_t status, void *arg);
+static void up_dma_rxpoll(int argc, uint32_t arg, ...);
+static int up_dma_rxstart(FAR struct uart_dev_s *dev);
+static void up_dma_rxstop(FAR struct uart_dev_s *dev);
+#endif
 
 /****************************************************************************
  * Private Data
@@ -592,6 +621,19 @@ static int up_attach(FAR struct uart_dev_s *dev)
        */
 
       up_enable_irq(priv->irq);
+
+#ifdef HAVE_RXDMA
+      /* Start the circular RX DMA on UART2 */
+
+      if (priv->id == 2)
+        {
+          ret = up_dma_rxstart(dev);
+          if (ret < 0)
+            {
+              up_detach(dev);
+            }
+        }
+#endif
     }
 
   return ret;
@@ -610,6 +652,11 @@ static int up_attach(FAR struct uart_dev_s *dev)
 static void up_detach(FAR struct uart_dev_s *dev)
 {
   FAR struct up_dev_s *priv = (FAR struct up_dev_s *)dev->priv;
+
+#ifdef HAVE_RXDMA
+  up_dma_rxstop(dev);
+#endif
+
   up_disable_irq(priv->irq);
   irq_detach(priv->irq);
 }
@@ -700,6 +747,21 @@ static int up_interrupt(int irq, FAR void *context, FAR void *arg)
         {
         }
 
+#ifdef HAVE_RXDMA
+      if (priv->rxdma != NULL)
+        {
+          /* The DMA moves the data; a receive timeout, if one fires,
+           * means that the line has gone idle.
+           */
+
+          if (status & UART_INTR_RT)
+            {
+              uart_recvchars_circular(dev, up_dma_rxpos(dev),
+                                      UART_RXDMA_IDLE);
+            }
+        }
+      else
+#endif
       if (status & (UART_INTR_RX | UART_INTR_RT))
         {
           uart_recvchars(dev);
@@ -942,7 +1004,18 @@ static void up_rxint(FAR struct uart_dev_s *dev, bool enable)
   if (enable)
     {
 #ifndef CONFIG_SUPPRESS_SERIAL_INTS
-      priv->ier |= (UART_INTR_RX | UART_INTR_RT);
+#ifdef HAVE_RXDMA
+      /* With RX DMA only the receive timeout is needed */
+
+      if (priv->rxdma != NULL)
+        {
+          priv->ier |= UART_INTR_RT;
+        }
+      else
+#endif
+        {
+          priv->ier |= (UART_INTR_RX | UART_INTR_RT);
+        }
 #endif
     }
   else
@@ -1048,6 +1121,161 @@ static bool up_txempty(FAR struct uart_dev_s *dev)
   return (((rbr & UART_FLAG_TXFE) != 0) && ((rbr & UART_FLAG_BUSY) == 0));
 }
 
+/****************************************************************************
+ * Name: up_dma_rxpos
+ *
+ * Description:
+ *   Return the RX buffer index that the circular DMA will write next.
+ *
+ ****************************************************************************/
+
+#ifdef HAVE_RXDMA
+static size_t up_dma_rxpos(FAR struct uart_dev_s *dev)
+{
+  FAR struct up_dev_s *priv = (FAR struct up_dev_s *)dev->priv;
+  size_t pos;
+
+  pos = cxd56_dmadstaddr(priv->rxdma) - (uintptr_t)dev->recv.buffer;
+  return pos < dev->recv.size ? pos : 0;
+}
+
+/****************************************************************************
+ * Name: up_dma_rxcallback
+ *
+ * Description:
+ *   Called when the DMA finishes each half of the RX buffer.
+ *
+ ****************************************************************************/
+
+static void up_dma_rxcallback(DMA_HANDLE handle, uint8_t status, void *arg)
+{
+  FAR struct uart_dev_s *dev = (FAR struct uart_dev_s *)arg;
+  size_t pos;
+
+  if (status & CXD56_DMA_INTR_ERR)
+    {
+      _err("ERROR: UART RX DMA error\n");
+    }
+
+  /* The DMA may already have moved a little past the boundary */
+
+  pos = up_dma_rxpos(dev);
+  uart_recvchars_circular(dev, pos,
+                          pos < dev->recv.size / 2 ? UART_RXDMA_FULL :
+                                                     UART_RXDMA_HALF);
+}
+
+/****************************************************************************
+ * Name: up_dma_rxpoll
+ *
+ * Description:
+ *   Idle-line poll.  Between half-transfer interrupts, newly received data
+ *   is only visible in the DMA position, so report it once that position
+ *   has stopped moving.  The UART receive timeout rarely fires because the
+ *   DMA keeps the RX FIFO empty.
+ *
+ ****************************************************************************/
+
+static void up_dma_rxpoll(int argc, uint32_t arg, ...)
+{
+  FAR struct uart_dev_s *dev = (FAR struct uart_dev_s *)arg;
+  FAR struct up_dev_s *priv = (FAR struct up_dev_s *)dev->priv;
+  size_t pos;
+
+  pos = up_dma_rxpos(dev);
+  if (pos == priv->rxpos && pos != dev->recv.head)
+    {
+      uart_recvchars_circular(dev, pos, UART_RXDMA_IDLE);
+    }
+
+  priv->rxpos = pos;
+  wd_start(priv->rxidle, RXDMA_IDLE_TICKS, up_dma_rxpoll, 1, arg);
+}
+
+/****************************************************************************
+ * Name: up_dma_rxstart
+ *
+ * Description:
+ *   Start the circular RX DMA over the whole RX buffer.
+ *
+ ****************************************************************************/
+
+static int up_dma_rxstart(FAR struct uart_dev_s *dev)
+{
+  FAR struct up_dev_s *priv = (FAR struct up_dev_s *)dev->priv;
+  dma_config_t config;
+  irqstate_t flags;
+  int ret;
+
+  if (priv->rxidle == NULL)
+    {
+      priv->rxidle = wd_create();
+      if (priv->rxidle == NULL)
+        {
+          return -ENOMEM;
+        }
+    }
+
+  priv->rxdma = cxd56_dmachannel(CONFIG_CXD56_DMAC_UART2_RX_CH,
+                                 dev->recv.size);
+  if (priv->rxdma == NULL)
+    {
+      return -EBUSY;
+    }
+
+  config.channel_cfg = CXD56_DMA_PERIPHERAL_UART2_RX;
+  config.dest_width  = CXD56_DMAC_WIDTH8;
+  config.src_width   = CXD56_DMAC_WIDTH8;
+
+  ret = cxd56_rxdmasetup_circular(priv->rxdma,
+                                  priv->uartbase + CXD56_UART_DR,
+                                  (uintptr_t)dev->recv.buffer,
+                                  dev->recv.size, config);
+  if (ret < 0)
+    {
+      cxd56_dmafree(priv->rxdma);
+      priv->rxdma = NULL;
+      return ret;
+    }
+
+  /* The DMA starts writing at the beginning of the buffer */
+
+  flags = enter_critical_section();
+  dev->recv.head = 0;
+  dev->recv.tail = 0;
+  priv->rxpos    = 0;
+
+  cxd56_dmastart(priv->rxdma, up_dma_rxcallback, dev);
+  up_serialout(priv, CXD56_UART_DMACR, UART_DMACR_RXDMAE);
+  leave_critical_section(flags);
+
+  wd_start(priv->rxidle, RXDMA_IDLE_TICKS, up_dma_rxpoll, 1, (uint32_t)dev);
+  return OK;
+}
+
+/****************************************************************************
+ * Name: up_dma_rxstop
+ *
+ * Description:
+ *   Stop the circular RX DMA and release the channel.
+ *
+ ****************************************************************************/
+
+static void up_dma_rxstop(FAR struct uart_dev_s *dev)
+{
+  FAR struct up_dev_s *priv = (FAR struct up_dev_s *)dev->priv;
+
+  if (priv->rxdma != NULL)
+    {
+      wd_cancel(priv->rxidle);
+      up_serialout(priv, CXD56_UART_DMACR, 0);
+      cxd56_dmastop(priv->rxdma);
+      cxd56_dmafree(priv->rxdma);
+      priv->rxdma = NULL;
+    }
+}
+#endif
+
 /****************************************************************************
  * Public Funtions
  ****************************************************************************/
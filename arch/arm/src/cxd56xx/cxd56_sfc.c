@@ -36,12 +36,15 @@
 #include <nuttx/config.h>
 
 #include <nuttx/arch.h>
+#include <nuttx/cache.h>
 #include <nuttx/mtd/mtd.h>
 
 #include <stdint.h>
 #include <string.h>
 #include <errno.h>
 
+#include "cxd56_sfc.h"
+
 /* Prototypes for Remote API */
 
 int fw_fm_rawwrite(uint32_t offset, const void *buf, uint32_t size);
@@ -63,6 +66,13 @@ int fw_fm_rawerasesector(uint32_t sector);
 #endif
 #define PAGE_SIZE (1 << PAGE_SHIFT)
 
+#ifdef CONFIG_CXD56_SFC_XIP
+#  if CONFIG_CXD56_SFC_XIPBASE == 0
+#    error "CONFIG_CXD56_SFC_XIPBASE must be set"
+#  endif
+#  define XIPBASE ((uintptr_t)CONFIG_CXD56_SFC_XIPBASE)
+#endif
+
 /**
  * Flash device information
  */
@@ -74,6 +84,45 @@ struct flash_controller_s
 
 static struct flash_controller_s g_sfc;
 
+#ifdef CONFIG_CXD56_SFC_XIP
+/****************************************************************************
+ * Name: cxd56_xipinvalidate
+ *
+ * Description:
+ *   Discard cached copies of a flash range that the firmware has
+ *   reprogrammed, or may have reprogrammed, behind our back.
+ *
+ ****************************************************************************/
+
+static void cxd56_xipinvalidate(off_t offset, size_t nbytes)
+{
+  up_invalidate_dcache(XIPBASE + offset, XIPBASE + offset + nbytes);
+}
+
+/****************************************************************************
+ * Name: cxd56_xipread
+ *
+ * Description:
+ *   Copy from the memory mapped flash window instead of asking the system
+ *   CPU to read on our behalf.
+ *
+ ****************************************************************************/
+
+static int cxd56_xipread(off_t offset, FAR uint8_t *buffer, size_t nbytes)
+{
+  if (offset < 0 || offset + nbytes > g_sfc.density)
+    {
+      return -EINVAL;
+    }
+
+  cxd56_xipinvalidate(offset, nbytes);
+  memcpy(buffer, (FAR const void *)(XIPBASE + offset), nbytes);
+  return OK;
+}
+#else
+#  define cxd56_xipinvalidate(offset, nbytes)
+#endif
+
 /****************************************************************************
  * Name: cxd56_erase
  ****************************************************************************/
@@ -88,6 +137,7 @@ static int cxd56_erase(FAR struct mtd_dev_s *dev, off_t startblock,
   for (i = 0; i < nblocks; i++)
     {
       ret = fw_fm_rawerasesector(startblock + i);
+      cxd56_xipinvalidate((startblock + i) << SECTOR_SHIFT, SECTOR_SIZE);
       if (ret < 0)
         {
           set_errno(-ret);
@@ -104,7 +154,12 @@ static ssize_t cxd56_bread(FAR struct mtd_dev_s *dev, off_t startblock,
 
   finfo("bread: %08lx (%u blocks)\n", startblock << PAGE_SHIFT, nblocks);
 
+#ifdef CONFIG_CXD56_SFC_XIP
+  ret = cxd56_xipread(startblock << PAGE_SHIFT, buffer,
+                      nblocks << PAGE_SHIFT);
+#else
   ret = fw_fm_rawread(startblock << PAGE_SHIFT, buffer, nblocks << PAGE_SHIFT);
+#endif
   if (ret < 0)
     {
       set_errno(-ret);
@@ -128,6 +183,7 @@ static ssize_t cxd56_bwrite(FAR struct mtd_dev_s *dev, off_t startblock,
   ret = fw_fm_rawwrite(startblock << PAGE_SHIFT, buffer,
                     nblocks << PAGE_SHIFT);
 #endif
+  cxd56_xipinvalidate(startblock << PAGE_SHIFT, nblocks << PAGE_SHIFT);
   if (ret < 0)
     {
       set_errno(-ret);
@@ -144,7 +200,11 @@ static ssize_t cxd56_read(FAR struct mtd_dev_s *dev, off_t offset,
 
   finfo("read: %08lx (%u bytes)\n", offset, nbytes);
 
+#ifdef CONFIG_CXD56_SFC_XIP
+  ret = cxd56_xipread(offset, buffer, nbytes);
+#else
   ret = fw_fm_rawread(offset, buffer, nbytes);
+#endif
   if (ret < 0)
     {
       set_errno(-ret);
@@ -167,6 +227,7 @@ static ssize_t cxd56_write(FAR struct mtd_dev_s *dev, off_t offset,
 #else
   ret = fw_fm_rawwrite(offset, buffer, nbytes);
 #endif
+  cxd56_xipinvalidate(offset, nbytes);
   if (ret < 0)
     {
       set_errno(-ret);
@@ -225,10 +286,32 @@ static int cxd56_ioctl(FAR struct mtd_dev_s *dev, int cmd, unsigned long arg)
               fw_fm_rawerasesector(sec);
               sec++;
             }
+
+          cxd56_xipinvalidate(0, priv->density);
         }
         break;
 
+#ifdef CONFIG_CXD56_SFC_XIP
       case MTDIOC_XIPBASE:
+        {
+          FAR void **ppv = (FAR void **)arg;
+
+          finfo("cmd: XIPBASE\n");
+          if (ppv)
+            {
+              /* Return (void*) base address of the flash window */
+
+              *ppv = (FAR void *)XIPBASE;
+              ret  = OK;
+            }
+          else
+            {
+              ret = -EINVAL;
+            }
+        }
+        break;
+#endif
+
       default:
         ret = -ENOTTY; /* Bad command */
         break;
@@ -237,6 +320,22 @@ static int cxd56_ioctl(FAR struct mtd_dev_s *dev, int cmd, unsigned long arg)
   return ret;
 }
 
+#ifdef CONFIG_CXD56_FARAPI_ASYNC
+/****************************************************************************
+ * Name: cxd56_sfc_readasync
+ ****************************************************************************/
+
+int cxd56_sfc_readasync(off_t offset, size_t nbytes, FAR uint8_t *buffer,
+                        FAR struct cxd56_farreq_s *req)
+{
+  finfo("readasync: %08lx (%u bytes)\n", offset, nbytes);
+
+  return cxd56_farapi_async(req, (FAR void *)fw_fm_rawread,
+                            (uint32_t)offset, (uint32_t)(uintptr_t)buffer,
+                            (uint32_t)nbytes, 0);
+}
+#endif
+
 FAR struct mtd_dev_s *cxd56_sfc_initialize(void)
 {
   struct flash_controller_s *priv = &g_sfc;
@@ -270,5 +369,11 @@ FAR struct mtd_dev_s *cxd56_sfc_initialize(void)
     }
 #endif
 
+#ifdef CONFIG_CXD56_SFC_WRBUFFER
+  /* Merge consecutive block writes into larger Far API calls */
+
+  return mtd_rwb_initialize(&priv->mtd);
+#else
   return &priv->mtd;
+#endif
 }
@@ -43,6 +43,10 @@
 #include <nuttx/config.h>
 #include <nuttx/mtd/mtd.h>
 
+#ifdef CONFIG_CXD56_FARAPI_ASYNC
+#  include "cxd56_farapi.h"
+#endif
+
 #ifndef __ASSEMBLY__
 
 #undef EXTERN
@@ -56,6 +60,25 @@ extern "C"
 
 FAR struct mtd_dev_s *cxd56_sfc_initialize(void);
 
+#ifdef CONFIG_CXD56_FARAPI_ASYNC
+/****************************************************************************
+ * Name: cxd56_sfc_readasync
+ *
+ * Description:
+ *   Start reading nbytes of SPI flash at offset into buffer and return
+ *   at once.  req->callback runs when the data is in place, with the
+ *   firmware status in req->result.
+ *
+ * Returned Value:
+ *   The far API request ID (>= 0) on success; a negated errno value on
+ *   failure.
+ *
+ ****************************************************************************/
+
+int cxd56_sfc_readasync(off_t offset, size_t nbytes, FAR uint8_t *buffer,
+                        FAR struct cxd56_farreq_s *req);
+#endif
+
 #undef EXTERN
 #ifdef __cplusplus
 }
@@ -66,6 +66,21 @@
 
 #define NR_HSEMS 16
 
+/* The semaphores this driver may use.  No. 0-2 and 15 are reserved by
+ * other system.
+ */
+
+#define HSEM_FIRST 3
+#define HSEM_LAST  14
+
+#ifndef CONFIG_CXD56_SPH_SPINCOUNT
+#  define CONFIG_CXD56_SPH_SPINCOUNT 100
+#endif
+
+/* Each core of an SMP configuration has its own ID */
+
+#define sph_cpuid() getreg32(CPU_ID)
+
 #define sph_state_unlocked(sts) (STS_STATE(sts) == STATE_IDLE)
 #define sph_state_locked(sts)   (STS_STATE(sts) == STATE_LOCKED)
 #define sph_state_busy(sts)     (STS_STATE(sts) == STATE_LOCKEDANDRESERVED)
@@ -83,7 +98,9 @@
 struct sph_dev_s
 {
   int id;
-  sem_t wait;
+  sem_t wait;                   /* Posted by the unlock interrupt */
+  sem_t exclsem;                /* Orders the threads of this CPU */
+  struct sph_stats_s stats;     /* Updated while the lock is held */
 };
 
 /****************************************************************************
@@ -94,7 +111,7 @@ static int sph_open(FAR struct file *filep);
 static int sph_ioctl(FAR struct file *filep, int cmd, unsigned long arg);
 static int sph_semtake(sem_t *id);
 static void sph_semgive(sem_t *id);
-static int sph_lock(FAR struct sph_dev_s *priv);
+static int sph_lock(FAR struct sph_dev_s *priv, int nspin);
 static int sph_trylock(FAR struct sph_dev_s *priv);
 static inline int sph_unlock(FAR struct sph_dev_s *priv);
 static int cxd56_sphirqhandler(int irq, FAR void *context, FAR void *arg);
@@ -114,7 +131,6 @@ static const struct file_operations sph_fops =
 };
 
 static struct sph_dev_s g_sphdev[NR_HSEMS];
-static int g_cpuid;
 
 /****************************************************************************
  * Private Functions
@@ -148,7 +164,7 @@ static int sph_ioctl(FAR struct file *filep, int cmd, unsigned long arg)
   switch (cmd)
     {
       case HSLOCK:
-        ret = sph_lock(priv);
+        ret = sph_lock(priv, 0);
         break;
 
       case HSUNLOCK:
@@ -159,6 +175,22 @@ static int sph_ioctl(FAR struct file *filep, int cmd, unsigned long arg)
         ret = sph_trylock(priv);
         break;
 
+      case HSGETSTATS:
+        {
+          FAR struct sph_stats_s *stats =
+            (FAR struct sph_stats_s *)((uintptr_t)arg);
+
+          if (stats == NULL)
+            {
+              ret = -EINVAL;
+              break;
+            }
+
+          memcpy(stats, &priv->stats, sizeof(struct sph_stats_s));
+          ret = OK;
+        }
+        break;
+
       default:
         break;
     }
@@ -176,24 +208,65 @@ static void sph_semgive(sem_t *id)
   nxsem_post(id);
 }
 
-static int sph_lock(FAR struct sph_dev_s *priv)
+/****************************************************************************
+ * Name: sph_account
+ *
+ * Description:
+ *   Update the contention statistics.  Called with the semaphore held, so
+ *   no other CPU updates them at the same time.
+ *
+ ****************************************************************************/
+
+static void sph_account(FAR struct sph_dev_s *priv, bool contended,
+                        uint32_t spins, uint32_t sleeps)
 {
+  priv->stats.locks++;
+  if (contended)
+    {
+      priv->stats.contended++;
+    }
+
+  priv->stats.spins  += spins;
+  priv->stats.sleeps += sleeps;
+}
+
+/****************************************************************************
+ * Name: sph_lock
+ *
+ * Description:
+ *   Lock the semaphore, retrying up to nspin times before reserving it and
+ *   sleeping until the unlock interrupt.
+ *
+ ****************************************************************************/
+
+static int sph_lock(FAR struct sph_dev_s *priv, int nspin)
+{
+  uint32_t cpuid = sph_cpuid();
+  uint32_t spins = 0;
+  uint32_t sleeps = 0;
   uint32_t sts;
-  int ret;
 
-  ret = sph_trylock(priv);
-  if (ret == OK)
+  while (sph_trylock(priv) != OK)
     {
-      return OK;
+      if (spins >= (uint32_t)nspin)
+        {
+          goto reserve;
+        }
+
+      spins++;
     }
 
+  sph_account(priv, spins > 0, spins, 0);
+  return OK;
+
+reserve:
   for (; ; )
     {
       putreg32(REQ_RESERVE, CXD56_SPH_REQ(priv->id));
       hsinfo("hsem%d is locked.\n", priv->id);
 
       sts = getreg32(CXD56_SPH_STS(priv->id));
-      if (sph_state_busy(sts) && RESV_OWNER(sts) == g_cpuid)
+      if (sph_state_busy(sts) && RESV_OWNER(sts) == cpuid)
         {
           /* If successfully reserved, wait for semaphore unlocked. */
 
@@ -201,6 +274,7 @@ static int sph_lock(FAR struct sph_dev_s *priv)
           if (sph_state_busy(sts))
             {
               sph_semtake(&priv->wait);
+              sleeps++;
             }
 
           /* Get latest status for determining locked owner. */
@@ -210,12 +284,13 @@ static int sph_lock(FAR struct sph_dev_s *priv)
 
       /* Confirm locked CPU is me. */
 
-      if (sph_state_locked(sts) && LOCK_OWNER(sts) == g_cpuid)
+      if (sph_state_locked(sts) && LOCK_OWNER(sts) == cpuid)
         {
           break;
         }
     }
 
+  sph_account(priv, true, spins, sleeps);
   return OK;
 }
 
@@ -230,7 +305,7 @@ static int sph_trylock(FAR struct sph_dev_s *priv)
       hsinfo("hsem%d is locked.\n", priv->id);
 
       sts = getreg32(CXD56_SPH_STS(priv->id));
-      if (sph_state_locked(sts) && LOCK_OWNER(sts) == g_cpuid)
+      if (sph_state_locked(sts) && LOCK_OWNER(sts) == sph_cpuid())
         {
           return OK;
         }
@@ -262,6 +337,7 @@ static inline int cxd56_sphdevinit(FAR const char *devname, int num)
 
   nxsem_init(&priv->wait, 0, 0);
   nxsem_setprotocol(&priv->wait, SEM_PRIO_NONE);
+  nxsem_init(&priv->exclsem, 0, 1);
   priv->id = num;
 
   irq_attach(CXD56_IRQ_SPH0 + num, cxd56_sphirqhandler, NULL);
@@ -300,9 +376,7 @@ int cxd56_sphinitialize(FAR const char *devname)
   int ret;
   int i;
 
-  /* No. 0-2 and 15 semaphores are reserved by other system. */
-
-  for (i = 3; i < 15; i++)
+  for (i = HSEM_FIRST; i <= HSEM_LAST; i++)
     {
       ret = cxd56_sphdevinit(devname, i);
       if (ret != OK)
@@ -311,8 +385,124 @@ int cxd56_sphinitialize(FAR const char *devname)
         }
     }
 
-  g_cpuid = getreg32(CPU_ID);
+  return OK;
+}
+
+/****************************************************************************
+ * Name: cxd56_sph_spinlock / cxd56_sph_spinunlock
+ *
+ * Description:
+ *   Take hardware semaphore id with local interrupts disabled, spinning
+ *   until it is free.  The hardware arbitrates between CPUs, so this does
+ *   not rely on exclusive monitors being coherent across cores.  Hold it
+ *   only for short sections.
+ *
+ ****************************************************************************/
+
+irqstate_t cxd56_sph_spinlock(int id)
+{
+  FAR struct sph_dev_s *priv = &g_sphdev[id];
+  irqstate_t flags;
+  uint32_t spins = 0;
+
+  DEBUGASSERT(id >= HSEM_FIRST && id <= HSEM_LAST);
+
+  flags = up_irq_save();
+  while (sph_trylock(priv) != OK)
+    {
+      spins++;
+    }
+
+  sph_account(priv, spins > 0, spins, 0);
+  return flags;
+}
+
+void cxd56_sph_spinunlock(int id, irqstate_t flags)
+{
+  DEBUGASSERT(id >= HSEM_FIRST && id <= HSEM_LAST);
+
+  sph_unlock(&g_sphdev[id]);
+  up_irq_restore(flags);
+}
+
+/****************************************************************************
+ * Name: cxd56_sph_mutexlock / cxd56_sph_mutexunlock
+ *
+ * Description:
+ *   Sleeping lock on hardware semaphore id.  Threads of this CPU queue on
+ *   a local semaphore first, since the hardware only tells CPUs apart.
+ *   The winner retries the hardware semaphore CONFIG_CXD56_SPH_SPINCOUNT
+ *   times and then sleeps until its unlock interrupt.
+ *
+ ****************************************************************************/
+
+int cxd56_sph_mutexlock(int id)
+{
+  FAR struct sph_dev_s *priv = &g_sphdev[id];
+  int ret;
+
+  DEBUGASSERT(id >= HSEM_FIRST && id <= HSEM_LAST);
+
+  ret = nxsem_wait_uninterruptible(&priv->exclsem);
+  if (ret < 0)
+    {
+      return ret;
+    }
+
+  return sph_lock(priv, CONFIG_CXD56_SPH_SPINCOUNT);
+}
+
+int cxd56_sph_mutextrylock(int id)
+{
+  FAR struct sph_dev_s *priv = &g_sphdev[id];
+  int ret;
+
+  DEBUGASSERT(id >= HSEM_FIRST && id <= HSEM_LAST);
+
+  ret = nxsem_trywait(&priv->exclsem);
+  if (ret < 0)
+    {
+      return -EBUSY;
+    }
+
+  ret = sph_trylock(priv);
+  if (ret < 0)
+    {
+      nxsem_post(&priv->exclsem);
+      return ret;
+    }
+
+  sph_account(priv, false, 0, 0);
+  return OK;
+}
+
+void cxd56_sph_mutexunlock(int id)
+{
+  FAR struct sph_dev_s *priv = &g_sphdev[id];
+
+  DEBUGASSERT(id >= HSEM_FIRST && id <= HSEM_LAST);
+
+  sph_unlock(priv);
+  nxsem_post(&priv->exclsem);
+}
+
+/****************************************************************************
+ * Name: cxd56_sph_getstats
+ *
+ * Description:
+ *   Return the contention statistics of hardware semaphore id.  These are
+ *   also available through the HSGETSTATS ioctl.
+ *
+ ****************************************************************************/
+
+int cxd56_sph_getstats(int id, FAR struct sph_stats_s *stats)
+{
+  if (id < HSEM_FIRST || id > HSEM_LAST || stats == NULL)
+    {
+      return -EINVAL;
+    }
 
+  memcpy(stats, &g_sphdev[id].stats, sizeof(struct sph_stats_s));
   return OK;
 }
 
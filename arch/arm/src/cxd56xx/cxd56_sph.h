@@ -36,7 +36,15 @@
 #ifndef __ARCH_ARM_SRC_CXD56XX_CXD56_SPH_H
 #define __ARCH_ARM_SRC_CXD56XX_CXD56_SPH_H
 
+/****************************************************************************
+ * Included Files
+ ****************************************************************************/
+
+#include <nuttx/config.h>
+#include <nuttx/irq.h>
+
 #include <sys/ioctl.h>
+#include <stdint.h>
 
 #define _HSIOCVALID(c) (_IOC_TYPE(c)==0x7f00)
 #define _HSIOC(nr)     _IOC(0x7f00,nr)
@@ -44,6 +52,21 @@
 #define HSLOCK         _HSIOC(0x01)
 #define HSTRYLOCK      _HSIOC(0x02)
 #define HSUNLOCK       _HSIOC(0x03)
+#define HSGETSTATS     _HSIOC(0x04) /* arg: struct sph_stats_s * */
+
+#ifndef __ASSEMBLY__
+
+/* Contention statistics of one hardware semaphore */
+
+struct sph_stats_s
+{
+  uint32_t locks;               /* Successful lock operations */
+  uint32_t contended;           /* Locks that found the semaphore taken */
+  uint32_t spins;               /* Failed attempts while spinning */
+  uint32_t sleeps;              /* Waits for the unlock interrupt */
+};
+
+#endif
 
 #ifndef __ASSEMBLY__
 #ifdef __cplusplus
@@ -56,6 +79,18 @@ extern "C"
 
 int cxd56_sphinitialize(FAR const char *devname);
 
+/* In-kernel use of hardware semaphores 3 to 14.  cxd56_sphinitialize()
+ * must have been called, and a semaphore used here must not also be
+ * opened through its character device.
+ */
+
+irqstate_t cxd56_sph_spinlock(int id);
+void cxd56_sph_spinunlock(int id, irqstate_t flags);
+int cxd56_sph_mutexlock(int id);
+int cxd56_sph_mutextrylock(int id);
+void cxd56_sph_mutexunlock(int id);
+int cxd56_sph_getstats(int id, FAR struct sph_stats_s *stats);
+
 #undef EXTERN
 #ifdef __cplusplus
 }
@@ -53,6 +53,9 @@
 #include <nuttx/arch.h>
 #include <nuttx/semaphore.h>
 #include <nuttx/spi/spi.h>
+#ifdef CONFIG_SPI_ASYNC
+#  include <nuttx/wqueue.h>
+#endif
 
 #include "up_internal.h"
 #include "up_arch.h"
@@ -79,6 +82,22 @@
 #define __unused __attribute__((unused))
 #endif
 
+#ifdef CONFIG_SPI_ASYNC
+/* Asynchronous transactions complete on the low priority work queue if
+ * there is one.
+ */
+
+#  ifdef CONFIG_SCHED_LPWORK
+#    define SPI_ASYNC_WORK LPWORK
+#  else
+#    define SPI_ASYNC_WORK HPWORK
+#  endif
+
+/* Most segments that are chained in one DMA link list */
+
+#  define SPI_ASYNC_MAXSG 8
+#endif
+
 /****************************************************************************
  * Private Types
  ****************************************************************************/
@@ -108,6 +127,24 @@ struct cxd56_spidev_s
   dma_config_t     rxconfig;   /* RX DMA configuration */
   dma_config_t     txconfig;   /* TX DMA configuration */
 #endif
+#ifdef CONFIG_SPI_ASYNC
+  FAR struct spi_transaction_s *xhead; /* Queued transactions */
+  FAR struct spi_transaction_s *xtail;
+  FAR struct spi_transaction_s *xcur;  /* Transaction in progress */
+  unsigned int     xseg;       /* First segment of the running DMA chain */
+  unsigned int     xend;       /* One past its last segment */
+  int              xresult;    /* Result of the transaction in progress */
+  uint8_t          xpending;   /* DMA completions still expected */
+  bool             xdone;      /* xcur has finished */
+  bool             xbusy;      /* The bus lock is held for async work */
+  bool             xwaiting;   /* Waiting for spi_lock() to free the bus */
+  bool             xselected;  /* The current device is selected */
+  struct work_s    xwork;      /* Starts and completes transactions */
+#ifdef CONFIG_CXD56_DMAC
+  struct cxd56_dmasg_s txsg[SPI_ASYNC_MAXSG];
+  struct cxd56_dmasg_s rxsg[SPI_ASYNC_MAXSG];
+#endif
+#endif
 };
 
 /****************************************************************************
@@ -158,6 +195,17 @@ static void spi_sndblock(FAR struct spi_dev_s *dev, FAR const void *buffer,
 static void spi_recvblock(FAR struct spi_dev_s *dev, FAR void *buffer,
                           size_t nwords);
 #endif
+#ifdef CONFIG_SPI_ASYNC
+static int spi_submit(FAR struct spi_dev_s *dev,
+                      FAR struct spi_transaction_s *xact);
+static void spi_async_worker(FAR void *arg);
+static void spi_async_start(FAR struct cxd56_spidev_s *priv);
+#ifdef CONFIG_CXD56_DMAC
+static void spi_async_chain(FAR struct cxd56_spidev_s *priv);
+static void spi_async_dmacallback(DMA_HANDLE handle, uint8_t status,
+                                  void *data);
+#endif
+#endif
 
 /****************************************************************************
  * Private Data
@@ -198,6 +246,9 @@ static const struct spi_ops_s g_spi4ops =
 #else
   .registercallback  = 0,                  /* Not implemented */
 #endif
+#ifdef CONFIG_SPI_ASYNC
+  .submit            = spi_submit,
+#endif
 };
 
 static struct cxd56_spidev_s g_spi4dev =
@@ -241,6 +292,9 @@ static const struct spi_ops_s g_spi5ops =
 #else
   .registercallback  = 0,                  /* Not implemented */
 #endif
+#ifdef CONFIG_SPI_ASYNC
+  .submit            = spi_submit,
+#endif
 };
 
 static struct cxd56_spidev_s g_spi5dev =
@@ -283,6 +337,9 @@ static const struct spi_ops_s g_spi0ops =
 #else
   .registercallback  = 0,                  /* Not implemented */
 #endif
+#ifdef CONFIG_SPI_ASYNC
+  .submit            = spi_submit,
+#endif
 };
 
 static struct cxd56_spidev_s g_spi0dev =
@@ -325,6 +382,9 @@ static const struct spi_ops_s g_spi3ops =
 #else
   .registercallback  = 0,                  /* Not implemented */
 #endif
+#ifdef CONFIG_SPI_ASYNC
+  .submit            = spi_submit,
+#endif
 };
 
 static struct cxd56_spidev_s g_spi3dev =
@@ -432,7 +492,26 @@ static int spi_lock(FAR struct spi_dev_s *dev, bool lock)
     }
   else
     {
+#ifdef CONFIG_SPI_ASYNC
+      irqstate_t flags;
+      int ret;
+
+      /* Hand the bus to queued asynchronous transactions */
+
+      ret   = nxsem_post(&priv->exclsem);
+      flags = enter_critical_section();
+      if (priv->xwaiting)
+        {
+          priv->xwaiting = false;
+          work_queue(SPI_ASYNC_WORK, &priv->xwork, spi_async_worker,
+                     priv, 0);
+        }
+
+      leave_critical_section(flags);
+      return ret;
+#else
       return nxsem_post(&priv->exclsem);
+#endif
     }
 }
 
@@ -1664,4 +1743,388 @@ static void spi_dmatrxwait(FAR struct cxd56_spidev_s *priv)
 
 #endif
 
+#ifdef CONFIG_SPI_ASYNC
+
+/****************************************************************************
+ * Name: spi_submit
+ *
+ * Description:
+ *   Queue an asynchronous transaction.  See SPI_SUBMIT().
+ *
+ ****************************************************************************/
+
+static int spi_submit(FAR struct spi_dev_s *dev,
+                      FAR struct spi_transaction_s *xact)
+{
+  FAR struct cxd56_spidev_s *priv = (FAR struct cxd56_spidev_s *)dev;
+  irqstate_t flags;
+  unsigned int i;
+
+  if (xact == NULL || xact->segs == NULL || xact->nsegs == 0)
+    {
+      return -EINVAL;
+    }
+
+  for (i = 0; i < xact->nsegs; i++)
+    {
+      if (xact->segs[i].nwords == 0)
+        {
+          return -EINVAL;
+        }
+    }
+
+  xact->flink = NULL;
+
+  flags = enter_critical_section();
+  if (priv->xtail != NULL)
+    {
+      priv->xtail->flink = xact;
+    }
+  else
+    {
+      priv->xhead = xact;
+    }
+
+  priv->xtail = xact;
+
+  if (!priv->xbusy && !priv->xwaiting && work_available(&priv->xwork))
+    {
+      work_queue(SPI_ASYNC_WORK, &priv->xwork, spi_async_worker, priv, 0);
+    }
+
+  leave_critical_section(flags);
+  return OK;
+}
+
+/****************************************************************************
+ * Name: spi_async_worker
+ *
+ * Description:
+ *   Complete the finished transaction, then start the next queued one.  The
+ *   bus lock is kept across back-to-back transactions, but it is released
+ *   whenever the queue drains or a synchronous user is waiting for it.
+ *
+ ****************************************************************************/
+
+static void spi_async_worker(FAR void *arg)
+{
+  FAR struct cxd56_spidev_s *priv = (FAR struct cxd56_spidev_s *)arg;
+  FAR struct spi_transaction_s *xact;
+  irqstate_t flags;
+  int semcount;
+
+  for (; ; )
+    {
+      if (priv->xdone)
+        {
+          xact        = priv->xcur;
+          priv->xcur  = NULL;
+          priv->xdone = false;
+
+#ifdef CONFIG_CXD56_DMAC
+          if (priv->dmaenable && priv->txdmach && priv->rxdmach)
+            {
+              uint32_t val;
+
+              val = spi_getreg(priv, CXD56_SPI_DMACR_OFFSET);
+              val &= ~(SPI_DMACR_RXDMAE | SPI_DMACR_TXDMAE);
+              spi_putreg(priv, CXD56_SPI_DMACR_OFFSET, val);
+
+              if (priv->port == 3)
+                {
+                  val = spi_getreg(priv, CXD56_SPI_CR1_OFFSET);
+                  spi_putreg(priv, CXD56_SPI_CR1_OFFSET, val & ~SPI_CR1_SSE);
+                }
+
+              cxd56_spi_clock_gate_enable(priv->port);
+              up_pm_release_freqlock(&g_hold_lock);
+            }
+#endif
+
+          if (xact->callback != NULL)
+            {
+              xact->callback(xact, priv->xresult);
+            }
+        }
+
+      if (priv->xcur != NULL)
+        {
+          /* Still running; the DMA callback will queue us again */
+
+          return;
+        }
+
+      /* Release the bus if there is nothing to do or somebody else wants
+       * it.  spi_lock() requeues this work once it is freed again.
+       */
+
+      flags = enter_critical_section();
+      nxsem_getvalue(&priv->exclsem, &semcount);
+      if (priv->xbusy && (priv->xhead == NULL || semcount < 0))
+        {
+          priv->xbusy    = false;
+          priv->xwaiting = priv->xhead != NULL;
+          nxsem_post(&priv->exclsem);
+        }
+
+      if (priv->xhead == NULL || priv->xwaiting)
+        {
+          leave_critical_section(flags);
+          return;
+        }
+
+      if (!priv->xbusy)
+        {
+          if (nxsem_trywait(&priv->exclsem) < 0)
+            {
+              priv->xwaiting = true;
+              leave_critical_section(flags);
+              return;
+            }
+
+          priv->xbusy = true;
+        }
+
+      xact        = priv->xhead;
+      priv->xhead = xact->flink;
+      if (priv->xhead == NULL)
+        {
+          priv->xtail = NULL;
+        }
+
+      priv->xcur    = xact;
+      priv->xresult = OK;
+      leave_critical_section(flags);
+
+      spi_async_start(priv);
+    }
+}
+
+/****************************************************************************
+ * Name: spi_async_start
+ *
+ * Description:
+ *   Apply the bus settings of the current transaction and start it.  With
+ *   DMA it runs on from the DMA interrupt; otherwise it completes here.
+ *
+ ****************************************************************************/
+
+static void spi_async_start(FAR struct cxd56_spidev_s *priv)
+{
+  FAR struct spi_dev_s *dev = &priv->spidev;
+  FAR struct spi_transaction_s *xact = priv->xcur;
+  FAR const struct spi_segment_s *seg;
+  unsigned int i;
+
+  spi_setfrequency(dev, xact->frequency);
+  spi_setmode(dev, xact->mode);
+  spi_setbits(dev, xact->nbits);
+
+#ifdef CONFIG_CXD56_DMAC
+  if (priv->dmaenable && priv->txdmach && priv->rxdmach)
+    {
+      int nitems = 0;
+      int ret;
+
+      /* Held until the worker completes the transaction */
+
+      up_pm_acquire_freqlock(&g_hold_lock);
+      cxd56_spi_clock_gate_disable(priv->port);
+
+      /* Grow the link lists now so that the interrupt handler can chain
+       * every segment without allocating.
+       */
+
+      for (i = 0; i < xact->nsegs; i++)
+        {
+          nitems += CXD56_DMAC_NITEMS(xact->segs[i].nwords);
+        }
+
+      ret = cxd56_dmareserve(priv->txdmach, nitems);
+      if (ret >= 0)
+        {
+          ret = cxd56_dmareserve(priv->rxdmach, nitems);
+        }
+
+      if (ret < 0)
+        {
+          priv->xresult = ret;
+          priv->xdone   = true;
+          return;
+        }
+
+      if (priv->port == 3)
+        {
+          uint32_t val = spi_getreg(priv, CXD56_SPI_CR1_OFFSET);
+          spi_putreg(priv, CXD56_SPI_CR1_OFFSET, val | SPI_CR1_SSE);
+        }
+
+      priv->xselected = false;
+      priv->xseg      = 0;
+      spi_async_chain(priv);
+      return;
+    }
+#endif
+
+  for (i = 0; i < xact->nsegs; i++)
+    {
+      seg = &xact->segs[i];
+
+      if (i == 0 || xact->segs[i - 1].devid != seg->devid ||
+          (xact->segs[i - 1].flags & SPI_SEG_CSCHANGE) != 0)
+        {
+          SPI_SELECT(dev, seg->devid, true);
+        }
+
+#ifdef CONFIG_SPI_CMDDATA
+      SPI_CMDDATA(dev, seg->devid, (seg->flags & SPI_SEG_CMD) != 0);
+#endif
+
+      spi_do_exchange(dev, seg->txbuffer, seg->rxbuffer, seg->nwords);
+
+      if (i + 1 == xact->nsegs || seg[1].devid != seg->devid ||
+          (seg->flags & SPI_SEG_CSCHANGE) != 0)
+        {
+          SPI_SELECT(dev, seg->devid, false);
+        }
+    }
+
+  priv->xdone = true;
+}
+
+#ifdef CONFIG_CXD56_DMAC
+
+/****************************************************************************
+ * Name: spi_async_chain
+ *
+ * Description:
+ *   Start one DMA link list covering the segments from xseg on that share
+ *   the chip select and command/data state.  Called from the worker for the
+ *   first chain and from the DMA interrupt for the rest.
+ *
+ ****************************************************************************/
+
+static void spi_async_chain(FAR struct cxd56_spidev_s *priv)
+{
+  FAR struct spi_dev_s *dev = &priv->spidev;
+  FAR struct spi_transaction_s *xact = priv->xcur;
+  FAR const struct spi_segment_s *seg = &xact->segs[priv->xseg];
+  uintptr_t dr;
+  uint32_t val;
+  int nsg;
+  int ret;
+
+  for (nsg = 0; nsg < SPI_ASYNC_MAXSG &&
+       priv->xseg + nsg < xact->nsegs; nsg++)
+    {
+      if (nsg > 0 && (seg[nsg].devid != seg->devid ||
+          (seg[nsg].flags & SPI_SEG_CMD) != (seg->flags & SPI_SEG_CMD) ||
+          (seg[nsg - 1].flags & SPI_SEG_CSCHANGE) != 0))
+        {
+          break;
+        }
+
+      priv->txsg[nsg].maddr  = (uintptr_t)seg[nsg].txbuffer;
+      priv->txsg[nsg].nbytes = seg[nsg].nwords;
+      priv->rxsg[nsg].maddr  = (uintptr_t)seg[nsg].rxbuffer;
+      priv->rxsg[nsg].nbytes = seg[nsg].nwords;
+    }
+
+  priv->xend = priv->xseg + nsg;
+
+  if (!priv->xselected)
+    {
+      SPI_SELECT(dev, seg->devid, true);
+      priv->xselected = true;
+    }
+
+#ifdef CONFIG_SPI_CMDDATA
+  SPI_CMDDATA(dev, seg->devid, (seg->flags & SPI_SEG_CMD) != 0);
+#endif
+
+  val = spi_getreg(priv, CXD56_SPI_DMACR_OFFSET);
+  val |= SPI_DMACR_TXDMAE | SPI_DMACR_RXDMAE;
+  spi_putreg(priv, CXD56_SPI_DMACR_OFFSET, val);
+
+  dr  = (priv->spibase + CXD56_SPI_DR_OFFSET) & 0x03ffffffu;
+  ret = cxd56_txdmasetup_sg(priv->txdmach, dr, priv->txsg, nsg,
+                            priv->txconfig);
+  if (ret >= 0)
+    {
+      ret = cxd56_rxdmasetup_sg(priv->rxdmach, dr, priv->rxsg, nsg,
+                                priv->rxconfig);
+    }
+
+  if (ret < 0)
+    {
+      SPI_SELECT(dev, seg->devid, false);
+      priv->xselected = false;
+      priv->xresult   = ret;
+      priv->xdone     = true;
+      work_queue(SPI_ASYNC_WORK, &priv->xwork, spi_async_worker, priv, 0);
+      return;
+    }
+
+  priv->xpending = 2;
+  cxd56_dmastart(priv->rxdmach, spi_async_dmacallback, priv);
+  cxd56_dmastart(priv->txdmach, spi_async_dmacallback, priv);
+}
+
+/****************************************************************************
+ * Name: spi_async_dmacallback
+ *
+ * Description:
+ *   Called when the TX or RX link list of a chain completes.  Once both
+ *   are done, start the next chain or hand the transaction to the worker.
+ *
+ ****************************************************************************/
+
+static void spi_async_dmacallback(DMA_HANDLE handle, uint8_t status,
+                                  void *data)
+{
+  FAR struct cxd56_spidev_s *priv = (FAR struct cxd56_spidev_s *)data;
+  FAR struct spi_transaction_s *xact = priv->xcur;
+  FAR const struct spi_segment_s *last;
+
+  if ((status & CXD56_DMA_INTR_ERR) != 0)
+    {
+      spierr("dma error\n");
+      priv->xresult = -EIO;
+    }
+
+  if (--priv->xpending > 0)
+    {
+      return;
+    }
+
+  cxd56_dmastop(priv->txdmach);
+  cxd56_dmastop(priv->rxdmach);
+
+  last = &xact->segs[priv->xend - 1];
+  if (priv->xend == xact->nsegs || (last->flags & SPI_SEG_CSCHANGE) != 0 ||
+      last[1].devid != last->devid)
+    {
+      SPI_SELECT(&priv->spidev, last->devid, false);
+      priv->xselected = false;
+    }
+
+  if (priv->xend < xact->nsegs && priv->xresult == OK)
+    {
+      priv->xseg = priv->xend;
+      spi_async_chain(priv);
+      return;
+    }
+
+  if (priv->xselected)
+    {
+      SPI_SELECT(&priv->spidev, last->devid, false);
+      priv->xselected = false;
+    }
+
+  priv->xdone = true;
+  work_queue(SPI_ASYNC_WORK, &priv->xwork, spi_async_worker, priv, 0);
+}
+#endif /* CONFIG_CXD56_DMAC */
+#endif /* CONFIG_SPI_ASYNC */
+
 #endif
@@ -80,6 +80,7 @@
 #include "init/init.h"
 
 #include "cxd56_uart.h"
+#include "cxd56_critmon.h"
 
 /****************************************************************************
  * Pre-processor Definitions
@@ -333,8 +334,28 @@ void __start(void)
 
   /* Initialize the FPU (if configured) */
 
+#ifdef CONFIG_ARCH_RAMFUNCS
+  /* Copy any necessary code sections from their load address to RAM.
+   * Nothing needs to be copied if the image was loaded into RAM.
+   */
+
+  if (&_framfuncs != &_sramfuncs)
+    {
+      const uint32_t *src;
+
+      for (src = &_framfuncs, dest = &_sramfuncs; dest < &_eramfuncs; )
+        {
+          *dest++ = *src++;
+        }
+    }
+#endif
+
   fpuconfig();
 
+  /* Start the cycle counter used to measure execution times */
+
+  cxd56_critmon_initialize();
+
 #ifdef CONFIG_ARMV7M_ITMSYSLOG
   /* Perform ARMv7-M ITM SYSLOG initialization */
 
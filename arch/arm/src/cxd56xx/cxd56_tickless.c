@@ -0,0 +1,342 @@
+/****************************************************************************
+ * arch/arm/src/cxd56xx/cxd56_tickless.c
+ *
+ *   Copyright 2018 Sony Semiconductor Solutions Corporation
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in
+ *    the documentation and/or other materials provided with the
+ *    distribution.
+ * 3. Neither the name of Sony Semiconductor Solutions Corporation nor
+ *    the names of its contributors may be used to endorse or promote
+ *    products derived from this software without specific prior written
+ *    permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+ * FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE
+ * COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+ * INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,
+ * BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS
+ * OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED
+ * AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ * LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN
+ * ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ *
+ ****************************************************************************/
+
+/****************************************************************************
+ * Tickless OS Support.
+ *
+ * The time base is the always-on 32.768 kHz RTC counter, which keeps its
+ * rate when the application CPU clock is changed.  Alarms are timed with
+ * the SysTick of the CPU that sets them, programmed in one-shot fashion
+ * for no longer than its 24-bit range allows.  Every SysTick interrupt
+ * compares the RTC counter against the shared deadline and either reports
+ * the expiration or re-arms for the remainder, so a SysTick period that
+ * is stale after a clock change can only cause an extra early interrupt.
+ *
+ ****************************************************************************/
+
+/****************************************************************************
+ * Included Files
+ ****************************************************************************/
+
+#include <nuttx/config.h>
+
+#include <stdint.h>
+#include <stdbool.h>
+#include <time.h>
+#include <debug.h>
+
+#include <nuttx/arch.h>
+#include <nuttx/clock.h>
+#include <nuttx/irq.h>
+
+#include "nvic.h"
+#include "up_internal.h"
+#include "up_arch.h"
+#include "cxd56_clock.h"
+#include "cxd56_powermgr.h"
+#include "cxd56_rtc.h"
+#include "cxd56_timerisr.h"
+
+#include "chip.h"
+
+#ifdef CONFIG_SCHED_TICKLESS
+
+#ifndef CONFIG_CXD56_RTC
+#  error "CONFIG_SCHED_TICKLESS needs CONFIG_CXD56_RTC for its time base"
+#endif
+
+/****************************************************************************
+ * Pre-processor Definitions
+ ****************************************************************************/
+
+#define RTC_FREQ      32768
+#define SYSTICK_MAX   0x00ffffff
+
+#define SYSTICK_RUN   (NVIC_SYSTICK_CTRL_CLKSOURCE | \
+                       NVIC_SYSTICK_CTRL_TICKINT | \
+                       NVIC_SYSTICK_CTRL_ENABLE)
+
+/****************************************************************************
+ * Private Data
+ ****************************************************************************/
+
+static uint64_t g_base;         /* RTC count at initialization */
+static uint64_t g_deadline;     /* RTC count at which the alarm expires */
+static bool g_armed;            /* True: g_deadline is pending */
+
+/****************************************************************************
+ * Private Functions
+ ****************************************************************************/
+
+static inline uint64_t cxd56_tl_now(void)
+{
+  return cxd56_rtc_count() - g_base;
+}
+
+static void cxd56_tl_count2ts(uint64_t count, FAR struct timespec *ts)
+{
+  ts->tv_sec  = count / RTC_FREQ;
+  ts->tv_nsec = ((count % RTC_FREQ) * NSEC_PER_SEC) / RTC_FREQ;
+}
+
+/* Round up, so that an alarm never expires early */
+
+static uint64_t cxd56_tl_ts2count(FAR const struct timespec *ts)
+{
+  return (uint64_t)ts->tv_sec * RTC_FREQ +
+         ((uint64_t)ts->tv_nsec * RTC_FREQ + NSEC_PER_SEC - 1) /
+         NSEC_PER_SEC;
+}
+
+static inline void cxd56_tl_stop(void)
+{
+  putreg32(NVIC_SYSTICK_CTRL_CLKSOURCE, NVIC_SYSTICK_CTRL);
+}
+
+/****************************************************************************
+ * Name: cxd56_tl_arm
+ *
+ * Description:
+ *   Program this CPU's SysTick to interrupt when g_deadline is due, or
+ *   after its longest period if that comes first.  Called with interrupts
+ *   disabled.
+ *
+ ****************************************************************************/
+
+static void cxd56_tl_arm(uint64_t now)
+{
+  uint64_t delta = g_deadline > now ? g_deadline - now : 0;
+  uint64_t clocks;
+
+  /* Anything beyond one second is far past the SysTick range anyway */
+
+  if (delta > RTC_FREQ)
+    {
+      delta = RTC_FREQ;
+    }
+
+  clocks = (delta * cxd56_get_cpu_baseclk()) / RTC_FREQ;
+  if (clocks > SYSTICK_MAX)
+    {
+      clocks = SYSTICK_MAX;
+    }
+  else if (clocks < 1)
+    {
+      clocks = 1;
+    }
+
+  putreg32(NVIC_SYSTICK_CTRL_CLKSOURCE, NVIC_SYSTICK_CTRL);
+  putreg32((uint32_t)clocks, NVIC_SYSTICK_RELOAD);
+  putreg32(0, NVIC_SYSTICK_CURRENT);
+  putreg32(SYSTICK_RUN, NVIC_SYSTICK_CTRL);
+}
+
+static int cxd56_changeclock(uint8_t id)
+{
+  irqstate_t flags;
+
+  flags = enter_critical_section();
+
+  if (id == CXD56_PM_CALLBACK_ID_CLK_CHG_START)
+    {
+      cxd56_tl_stop();
+    }
+  else if ((id == CXD56_PM_CALLBACK_ID_CLK_CHG_END) ||
+           (id == CXD56_PM_CALLBACK_ID_HOT_BOOT))
+    {
+      /* Re-arm at the new clock rate; the deadline itself is unchanged */
+
+      if (g_armed)
+        {
+          cxd56_tl_arm(cxd56_tl_now());
+        }
+    }
+
+  leave_critical_section(flags);
+  return 0;
+}
+
+static int cxd56_tl_isr(int irq, uint32_t *regs, FAR void *arg)
+{
+  irqstate_t flags;
+  uint64_t now;
+#ifdef CONFIG_SCHED_TICKLESS_ALARM
+  struct timespec ts;
+#endif
+
+  flags = enter_critical_section();
+
+  now = cxd56_tl_now();
+  if (!g_armed)
+    {
+      /* Cancelled, or already handled by another CPU */
+
+      cxd56_tl_stop();
+      leave_critical_section(flags);
+      return OK;
+    }
+
+  if (now < g_deadline)
+    {
+      cxd56_tl_arm(now);
+      leave_critical_section(flags);
+      return OK;
+    }
+
+  g_armed = false;
+  cxd56_tl_stop();
+  leave_critical_section(flags);
+
+#ifdef CONFIG_SCHED_TICKLESS_ALARM
+  cxd56_tl_count2ts(now, &ts);
+  nxsched_alarm_expiration(&ts);
+#else
+  nxsched_timer_expiration();
+#endif
+
+  return OK;
+}
+
+/****************************************************************************
+ * Public Functions
+ ****************************************************************************/
+
+void arm_timer_initialize(void)
+{
+  uint32_t regval;
+
+  /* Set the SysTick interrupt to the default priority */
+
+  regval = getreg32(NVIC_SYSH12_15_PRIORITY);
+  regval &= ~NVIC_SYSH_PRIORITY_PR15_MASK;
+  regval |= (CXD56M4_SYSH_PRIORITY_DEFAULT << NVIC_SYSH_PRIORITY_PR15_SHIFT);
+  putreg32(regval, NVIC_SYSH12_15_PRIORITY);
+
+  cxd56_tl_stop();
+
+  g_base  = cxd56_rtc_count();
+  g_armed = false;
+
+  /* SysTick is enabled by cxd56_tl_arm() through its control register,
+   * not through up_enable_irq().
+   */
+
+  irq_attach(CXD56_IRQ_SYSTICK, (xcpt_t)cxd56_tl_isr, NULL);
+}
+
+int cxd56_timerisr_initialize(void)
+{
+  cxd56_pm_register_callback(PM_CLOCK_APP_CPU, cxd56_changeclock);
+
+  return 0;
+}
+
+int up_timer_gettime(FAR struct timespec *ts)
+{
+  cxd56_tl_count2ts(cxd56_tl_now(), ts);
+  return OK;
+}
+
+int up_alarm_start(FAR const struct timespec *ts)
+{
+  irqstate_t flags;
+
+  flags = enter_critical_section();
+
+  g_deadline = cxd56_tl_ts2count(ts);
+  g_armed    = true;
+  cxd56_tl_arm(cxd56_tl_now());
+
+  leave_critical_section(flags);
+  return OK;
+}
+
+int up_alarm_cancel(FAR struct timespec *ts)
+{
+  irqstate_t flags;
+
+  flags = enter_critical_section();
+
+  g_armed = false;
+  cxd56_tl_stop();
+
+  if (ts != NULL)
+    {
+      up_timer_gettime(ts);
+    }
+
+  leave_critical_section(flags);
+  return OK;
+}
+
+#ifndef CONFIG_SCHED_TICKLESS_ALARM
+int up_timer_start(FAR const struct timespec *ts)
+{
+  irqstate_t flags;
+  uint64_t now;
+
+  flags = enter_critical_section();
+
+  now        = cxd56_tl_now();
+  g_deadline = now + cxd56_tl_ts2count(ts);
+  g_armed    = true;
+  cxd56_tl_arm(now);
+
+  leave_critical_section(flags);
+  return OK;
+}
+
+int up_timer_cancel(FAR struct timespec *ts)
+{
+  irqstate_t flags;
+  uint64_t now;
+
+  flags = enter_critical_section();
+
+  now = cxd56_tl_now();
+  if (ts != NULL)
+    {
+      cxd56_tl_count2ts(g_armed && g_deadline > now ? g_deadline - now : 0,
+                        ts);
+    }
+
+  g_armed = false;
+  cxd56_tl_stop();
+
+  leave_critical_section(flags);
+  return OK;
+}
+#endif /* CONFIG_SCHED_TICKLESS_ALARM */
+#endif /* CONFIG_SCHED_TICKLESS */
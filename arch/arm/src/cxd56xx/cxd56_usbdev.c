@@ -103,6 +103,12 @@
 #  define CONFIG_USBDEV_EP0_MAXSIZE 64
 #endif
 
+/* Number of DMA descriptors (packets) chained per IN transfer */
+
+#ifndef CONFIG_CXD56_USBDEV_NTXDESC
+#  define CONFIG_CXD56_USBDEV_NTXDESC 1
+#endif
+
 #ifndef CONFIG_USBDEV_SETUP_MAXDATASIZE
 #  define CONFIG_USBDEV_SETUP_MAXDATASIZE (CONFIG_USBDEV_EP0_MAXSIZE * 4)
 #endif
@@ -758,6 +764,8 @@ static int cxd56_epwrite(FAR struct cxd56_ep_s *privep, FAR uint8_t *buf,
   FAR struct cxd56_data_desc_s *desc;
   uint32_t ctrl;
   uint8_t epphy = privep->epphy;
+  uint16_t maxpacket = privep->ep.maxpacket;
+  uint16_t len;
 
   /* Setup IN descriptor */
 
@@ -768,8 +776,22 @@ static int cxd56_epwrite(FAR struct cxd56_ep_s *privep, FAR uint8_t *buf,
       return 0;
     }
 
+  /* Split into a chain of one packet per descriptor, so the DMA sends all
+   * of them without an interrupt per packet (EP0 always sends one packet).
+   */
+
+  for (len = nbytes; len > maxpacket; len -= maxpacket)
+    {
+      desc->buf    = (uint32_t)(uintptr_t)buf;
+      desc->status = maxpacket;
+      desc->next   = (uint32_t)(uintptr_t)(desc + 1);
+
+      buf += maxpacket;
+      desc++;
+    }
+
   desc->buf    = (uint32_t)(uintptr_t)buf;
-  desc->status = nbytes | DESC_LAST; /* always last descriptor */
+  desc->status = len | DESC_LAST;
 
   /* Set Poll bit to ready to send */
 
@@ -870,6 +892,8 @@ static void cxd56_txdmacomplete(FAR struct cxd56_ep_s *privep)
 {
   FAR struct cxd56_data_desc_s *desc;
   FAR struct cxd56_req_s *privreq;
+  uint32_t nbytes = 0;
+  int i;
 
   desc = privep->epphy == CXD56_EP0 ? &g_ep0in : privep->desc;
 
@@ -877,6 +901,17 @@ static void cxd56_txdmacomplete(FAR struct cxd56_ep_s *privep)
 
   DEBUGASSERT(IS_BS_DMA_DONE(desc));
 
+  /* Sum up the bytes sent by the whole descriptor chain */
+
+  for (i = 0; i < CONFIG_CXD56_USBDEV_NTXDESC; i++)
+    {
+      nbytes += desc[i].status & DESC_SIZE_MASK;
+      if (desc[i].status & DESC_LAST)
+        {
+          break;
+        }
+    }
+
   desc->status |= DESC_BS_HOST_BUSY;
 
   privreq = cxd56_rqpeek(privep);
@@ -886,7 +921,7 @@ static void cxd56_txdmacomplete(FAR struct cxd56_ep_s *privep)
     }
   else
     {
-      privreq->req.xfrd += desc->status & DESC_SIZE_MASK;
+      privreq->req.xfrd += nbytes;
 
       if (privreq->req.xfrd >= privreq->req.len && !privep->txnullpkt)
         {
@@ -914,6 +949,7 @@ static int cxd56_wrrequest(FAR struct cxd56_ep_s *privep)
   FAR uint8_t *buf;
   int nbytes;
   int bytesleft;
+  int maxbytes;
 
   /* Check the request from the head of the endpoint request queue */
 
@@ -950,21 +986,28 @@ static int cxd56_wrrequest(FAR struct cxd56_ep_s *privep)
   usbtrace(TRACE_WRITE(privep->epphy), (uint16_t)bytesleft);
   if (bytesleft > 0 || privep->txnullpkt)
     {
-      /* Try to send maxpacketsize -- unless we don't have that many
-       * bytes to send.
+      /* Try to send as many maxpacketsize packets as the descriptor chain
+       * holds -- unless we don't have that many bytes to send.
        */
 
+      maxbytes = privep->ep.maxpacket;
+      if (privep->epphy != CXD56_EP0)
+        {
+          maxbytes *= CONFIG_CXD56_USBDEV_NTXDESC;
+        }
+
       privep->txnullpkt = 0;
-      if (bytesleft > privep->ep.maxpacket)
+      if (bytesleft > maxbytes)
         {
-          nbytes = privep->ep.maxpacket;
+          nbytes = maxbytes;
         }
       else
         {
           nbytes = bytesleft;
           if ((privreq->req.flags & USBDEV_REQFLAGS_NULLPKT) != 0)
             {
-              privep->txnullpkt = (bytesleft == privep->ep.maxpacket);
+              privep->txnullpkt = bytesleft > 0 &&
+                (bytesleft % privep->ep.maxpacket) == 0;
             }
         }
 
@@ -2577,11 +2620,13 @@ static int cxd56_epstall(FAR struct usbdev_ep_s *ep, bool resume)
 
 static int cxd56_allocepbuffer(FAR struct cxd56_ep_s *privep)
 {
+  int ndesc = privep->in ? CONFIG_CXD56_USBDEV_NTXDESC : 1;
+
   DEBUGASSERT(!privep->desc && !privep->buffer);
   DEBUGASSERT(privep->epphy); /* Do not use for EP0 */
 
-  privep->desc =
-    (struct cxd56_data_desc_s *)kmm_malloc(sizeof(struct cxd56_data_desc_s));
+  privep->desc = (struct cxd56_data_desc_s *)
+    kmm_malloc(sizeof(struct cxd56_data_desc_s) * ndesc);
   if (!privep->desc)
     {
       return -1;
@@ -54,6 +54,7 @@
 #define CXD56_ADSP_RAM_BASE       0x0d000000
 #define CXD56_RAM_BASE            0x0d000000
 #define CXD56_RAM_SIZE            0x00180000
+#define CXD56_RAM_TILESIZE        0x00020000
 #define CXD56_ARM_BASE            0xe0000000
 #define CXD56_TIMER_BASE          0xe0043000
 #define CXD56_WDOG_BASE           0xe0044000
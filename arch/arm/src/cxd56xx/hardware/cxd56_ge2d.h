@@ -36,6 +36,12 @@
 #ifndef __ARCH_ARM_SRC_CXD56XX_CXD56_GE2D_H
 #define __ARCH_ARM_SRC_CXD56XX_CXD56_GE2D_H
 
+/****************************************************************************
+ * Included Files
+ ****************************************************************************/
+
+#include <stdint.h>
+
 #include "hardware/cxd5602_memorymap.h"
 
 /****************************************************************************
@@ -79,4 +85,58 @@
 #define GE2D_EXEC  1
 #define GE2D_STOP  3
 
+/* Descriptor address bit 0 selects the memory bus, always 1 in this chip */
+
+#define GE2D_MSEL  1
+
+/* Descriptor commands */
+
+#define GE2D_CMD_COPY      0x4
+#define GE2D_CMD_ROP       0x8
+#define GE2D_CMD_AB        0xa
+
+/* Raster operation command options */
+
+#define GE2D_ROP_SRC16BPP  (1 << 10)
+#define GE2D_ROP_SCALING   (1 << 12)
+#define GE2D_ROP_PATMONO   (1 << 15)
+
+#define GE2D_ROP_CONV8BPP    (1 << 7)
+#define GE2D_ROP_FIXEDCOLOR  (1 << 3)
+
+/* Raster operation codes */
+
+#define GE2D_ROP_SRCCOPY   0xcc
+#define GE2D_ROP_PATCOPY   0xf0
+
+/****************************************************************************
+ * Public Types
+ ****************************************************************************/
+
+#ifndef __ASSEMBLY__
+
+/* Raster operation (ROP) descriptor without scaling (32 bytes).  Descriptor
+ * lists must be 16 byte aligned.
+ */
+
+struct ge2d_ropcmd_s
+{
+  uint16_t cmd;               /* 0x00 */
+  uint8_t  rop;               /* 0x02 */
+  uint8_t  options;           /* 0x03 */
+  uint16_t srch;              /* 0x04: Source width - 1 */
+  uint16_t srcv;              /* 0x06: Source height - 1 */
+  uint32_t saddr;             /* 0x08 */
+  uint32_t daddr;             /* 0x0c */
+  uint16_t spitch;            /* 0x10: Source pitch in pixels - 1 */
+  uint16_t dpitch;            /* 0x12: Destination pitch in pixels - 1 */
+  uint32_t fixedcolor;        /* 0x14 */
+  uint32_t pataddr;           /* 0x18 */
+  uint16_t patpitch;          /* 0x1c */
+  uint8_t  pathoffset;        /* 0x1e */
+  uint8_t  patvoffset;        /* 0x1f */
+};
+
+#endif /* __ASSEMBLY__ */
+
 #endif /* __ARCH_ARM_SRC_CXD56XX_CXD56_GE2D_H */
@@ -96,6 +96,10 @@
 #define UART_CR_SIREN       (1u << 1)
 #define UART_CR_EN          (1u << 0)
 
+#define UART_DMACR_RXDMAE   (1u << 0)  /* Receive DMA enable */
+#define UART_DMACR_TXDMAE   (1u << 1)  /* Transmit DMA enable */
+#define UART_DMACR_DMAONERR (1u << 2)  /* Disable RX DMA on error */
+
 #define UART_INTR_RI        (1u << 0)  /* nUARTRI modem interrupt */
 #define UART_INTR_CTS       (1u << 1)  /* nUARTCTS modem interrupt */
 #define UART_INTR_DCD       (1u << 2)  /* nUARTDCD modem interrupt */
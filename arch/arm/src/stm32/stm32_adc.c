@@ -2282,16 +2282,30 @@ static void adc_dmaconvcallback(DMA_HANDLE handle, uint8_t isr, FAR void *arg)
     {
       DEBUGASSERT(priv->cb->au_receive != NULL);
 
-      for (i = 0; i < priv->rnchannels; i++)
+#ifdef CONFIG_ADC_SAMPLERING
+      /* Pass the whole DMA buffer at once.  The buffer always holds one
+       * complete conversion sequence, so priv->current is unchanged.
+       */
+
+      if (priv->cb->au_receive_block != NULL)
         {
-          priv->cb->au_receive(dev, priv->r_chanlist[priv->current],
-                               priv->r_dmabuffer[priv->current]);
-          priv->current++;
-          if (priv->current >= priv->rnchannels)
+          priv->cb->au_receive_block(dev, priv->r_chanlist, priv->rnchannels,
+                                     priv->r_dmabuffer, priv->rnchannels);
+        }
+      else
+#endif
+        {
+          for (i = 0; i < priv->rnchannels; i++)
             {
-              /* Restart the conversion sequence from the beginning */
-
-              priv->current = 0;
+              priv->cb->au_receive(dev, priv->r_chanlist[priv->current],
+                                   priv->r_dmabuffer[priv->current]);
+              priv->current++;
+              if (priv->current >= priv->rnchannels)
+                {
+                  /* Restart the conversion sequence from the beginning */
+
+                  priv->current = 0;
+                }
             }
         }
     }
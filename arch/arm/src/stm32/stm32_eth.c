@@ -4045,6 +4045,9 @@ int stm32_ethinitialize(int intf)
   priv->dev.d_ifup    = stm32_ifup;     /* I/F up (new IP address) callback */
   priv->dev.d_ifdown  = stm32_ifdown;   /* I/F down callback */
   priv->dev.d_txavail = stm32_txavail;  /* New TX data callback */
+#if defined(CONFIG_NETDEV_OFFLOAD) && defined(CHECKSUM_BY_HARDWARE)
+  priv->dev.d_features = NETDEV_FEATURE_TXCSUM | NETDEV_FEATURE_RXCSUM;
+#endif
 #ifdef CONFIG_NET_MCASTGROUP
   priv->dev.d_addmac  = stm32_addmac;   /* Add multicast MAC address */
   priv->dev.d_rmmac   = stm32_rmmac;    /* Remove multicast MAC address */
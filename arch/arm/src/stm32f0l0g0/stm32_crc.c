@@ -0,0 +1,136 @@
+/****************************************************************************
+ * arch/arm/src/stm32f0l0g0/stm32_crc.c
+ *
+ *   Copyright (C) 2020 Gregory Nutt. All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in
+ *    the documentation and/or other materials provided with the
+ *    distribution.
+ * 3. Neither the name NuttX nor the names of its contributors may be
+ *    used to endorse or promote products derived from this software
+ *    without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+ * FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE
+ * COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+ * INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,
+ * BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS
+ * OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED
+ * AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ * LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN
+ * ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ *
+ ****************************************************************************/
+
+/****************************************************************************
+ * Included Files
+ ****************************************************************************/
+
+#include <nuttx/config.h>
+
+#include <sys/types.h>
+#include <stdint.h>
+#include <crc32.h>
+
+#include <nuttx/irq.h>
+
+#include "up_arch.h"
+#include "hardware/stm32_crc.h"
+
+#ifdef CONFIG_STM32F0L0G0_CRC_LIBC
+
+/****************************************************************************
+ * Pre-processor Definitions
+ ****************************************************************************/
+
+/* Bytes fed to the unit per critical section */
+
+#define CRC_CHUNK 64
+
+/****************************************************************************
+ * Private Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: crc_bitrev32
+ *
+ * Description:
+ *   Reverse the bit order of a 32-bit word (Cortex-M0 has no RBIT).
+ *
+ ****************************************************************************/
+
+static uint32_t crc_bitrev32(uint32_t x)
+{
+  x = ((x >> 1) & 0x55555555) | ((x & 0x55555555) << 1);
+  x = ((x >> 2) & 0x33333333) | ((x & 0x33333333) << 2);
+  x = ((x >> 4) & 0x0f0f0f0f) | ((x & 0x0f0f0f0f) << 4);
+  return __builtin_bswap32(x);
+}
+
+/****************************************************************************
+ * Public Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: crc32part
+ *
+ * Description:
+ *   Continue CRC calculation on a part of the buffer using the CRC unit.
+ *   The unit implements the same 0x04c11db7 polynomial as the libc
+ *   tables; the reflected form is obtained by reversing the bits of every
+ *   input byte and of the result.  The running CRC is reloaded through
+ *   CRC_INIT, which holds the unreflected register value.
+ *
+ ****************************************************************************/
+
+uint32_t crc32part(FAR const uint8_t *src, size_t len, uint32_t crc32val)
+{
+  irqstate_t flags;
+  size_t chunk;
+  uint32_t w;
+
+  while (len > 0)
+    {
+      chunk = len < CRC_CHUNK ? len : CRC_CHUNK;
+      len  -= chunk;
+
+      flags = enter_critical_section();
+
+      putreg32(crc_bitrev32(crc32val), STM32_CRC_INIT);
+      putreg32(CRC_CR_REVIN_BYTE | CRC_CR_REVOUT | CRC_CR_RESET,
+               STM32_CRC_CR);
+
+      /* A word is consumed from its most significant byte down, so place
+       * the first byte of each group there.
+       */
+
+      for (; chunk >= 4; chunk -= 4, src += 4)
+        {
+          w = (uint32_t)src[0] << 24 | (uint32_t)src[1] << 16 |
+              (uint32_t)src[2] << 8 | (uint32_t)src[3];
+          putreg32(w, STM32_CRC_DR);
+        }
+
+      for (; chunk > 0; chunk--)
+        {
+          putreg8(*src++, STM32_CRC_DR);
+        }
+
+      crc32val = getreg32(STM32_CRC_DR);
+      leave_critical_section(flags);
+    }
+
+  return crc32val;
+}
+
+#endif /* CONFIG_STM32F0L0G0_CRC_LIBC */
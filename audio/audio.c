@@ -48,6 +48,7 @@
 #include <string.h>
 #include <mqueue.h>
 #include <fcntl.h>
+#include <poll.h>
 #include <assert.h>
 #include <errno.h>
 #include <debug.h>
@@ -55,6 +56,7 @@
 #include <nuttx/kmalloc.h>
 #include <nuttx/mqueue.h>
 #include <nuttx/arch.h>
+#include <nuttx/irq.h>
 #include <nuttx/fs/fs.h>
 #include <nuttx/audio/audio.h>
 #include <nuttx/semaphore.h>
@@ -91,6 +93,15 @@ struct audio_upperhalf_s
   sem_t             exclsem;  /* Supports mutual exclusion */
   FAR struct audio_lowerhalf_s *dev;  /* lower-half state */
   mqd_t             usermq;   /* User mode app's message queue */
+#ifdef CONFIG_AUDIO_LOWLATENCY
+  FAR uint8_t      *ring;     /* Period ring shared with the application */
+  FAR struct ap_buffer_s *periods; /* One AP buffer for each period */
+  uint16_t          nperiods; /* Number of periods in the ring */
+  uint16_t          head;     /* Next period to hand to the lower half */
+  volatile uint16_t nqueued;  /* Periods owned by the lower half */
+  volatile uint32_t ncompleted; /* Periods completed by the lower half */
+  FAR struct pollfd *fds[CONFIG_AUDIO_NPOLLWAITERS];
+#endif
 };
 
 /****************************************************************************
@@ -102,6 +113,11 @@ static int      audio_close(FAR struct file *filep);
 static ssize_t  audio_read(FAR struct file *filep, FAR char *buffer, size_t buflen);
 static ssize_t  audio_write(FAR struct file *filep, FAR const char *buffer, size_t buflen);
 static int      audio_ioctl(FAR struct file *filep, int cmd, unsigned long arg);
+#ifdef CONFIG_AUDIO_LOWLATENCY
+static int      audio_freering(FAR struct audio_upperhalf_s *upper);
+static int      audio_poll(FAR struct file *filep, FAR struct pollfd *fds,
+                           bool setup);
+#endif
 #ifdef CONFIG_AUDIO_MULTI_SESSION
 static int      audio_start(FAR struct audio_upperhalf_s *upper, FAR void *session);
 static void     audio_callback(FAR void *priv, uint16_t reason,
@@ -124,7 +140,11 @@ static const struct file_operations g_audioops =
   audio_write, /* write */
   NULL,        /* seek */
   audio_ioctl, /* ioctl */
+#ifdef CONFIG_AUDIO_LOWLATENCY
+  audio_poll   /* poll */
+#else
   NULL         /* poll */
+#endif
 };
 
 /****************************************************************************
@@ -231,6 +251,13 @@ static int audio_close(FAR struct file *filep)
       audinfo("calling shutdown: %d\n");
 
       lower->ops->shutdown(lower);
+
+#ifdef CONFIG_AUDIO_LOWLATENCY
+      /* The lower half no longer holds any period of the ring */
+
+      upper->nqueued = 0;
+      audio_freering(upper);
+#endif
     }
 
   ret = OK;
@@ -339,6 +366,325 @@ static int audio_start(FAR struct audio_upperhalf_s *upper)
   return ret;
 }
 
+/*******************************************************************************
+ * Name: audio_pollnotify
+ *
+ * Description:
+ *   Wake up any thread waiting in poll().  Called whenever the application
+ *   may own a period of the ring.
+ *
+ ******************************************************************************/
+
+#ifdef CONFIG_AUDIO_LOWLATENCY
+static void audio_pollnotify(FAR struct audio_upperhalf_s *upper)
+{
+  FAR struct pollfd *fds;
+  int i;
+
+  for (i = 0; i < CONFIG_AUDIO_NPOLLWAITERS; i++)
+    {
+      fds = upper->fds[i];
+      if (fds != NULL)
+        {
+          fds->revents |= (fds->events & (POLLIN | POLLOUT));
+          if (fds->revents != 0)
+            {
+              audinfo("Report events: %02x\n", fds->revents);
+              nxsem_post(fds->sem);
+            }
+        }
+    }
+}
+#endif
+
+/*******************************************************************************
+ * Name: audio_allocring
+ *
+ * Description:
+ *   Handle the AUDIOIOC_ALLOCRING ioctl command.  The samples live in one
+ *   user accessible allocation so that the ring can be mapped by the
+ *   application; each period is described to the lower half by an ordinary
+ *   AP buffer.
+ *
+ ******************************************************************************/
+
+#ifdef CONFIG_AUDIO_LOWLATENCY
+static int audio_allocring(FAR struct audio_upperhalf_s *upper,
+                           FAR struct audio_ring_desc_s *desc)
+{
+  FAR struct ap_buffer_s *apb;
+  int i;
+
+  DEBUGASSERT(desc != NULL);
+
+  if (upper->ring != NULL)
+    {
+      return -EBUSY;
+    }
+
+  if (desc->nperiods == 0 || desc->periodbytes == 0)
+    {
+      return -EINVAL;
+    }
+
+  upper->ring    = kumm_malloc((size_t)desc->nperiods * desc->periodbytes);
+  upper->periods = kmm_zalloc(desc->nperiods * sizeof(struct ap_buffer_s));
+
+  if (upper->ring == NULL || upper->periods == NULL)
+    {
+      if (upper->ring != NULL)
+        {
+          kumm_free(upper->ring);
+          upper->ring = NULL;
+        }
+
+      if (upper->periods != NULL)
+        {
+          kmm_free(upper->periods);
+          upper->periods = NULL;
+        }
+
+      return -ENOMEM;
+    }
+
+  for (i = 0; i < desc->nperiods; i++)
+    {
+      apb             = &upper->periods[i];
+      apb->i.channels = 1;
+      apb->crefs      = 1;
+      apb->nmaxbytes  = desc->periodbytes;
+      apb->samp       = upper->ring + (size_t)i * desc->periodbytes;
+#ifdef CONFIG_AUDIO_MULTI_SESSION
+      apb->session    = desc->session;
+#endif
+
+      nxsem_init(&apb->sem, 0, 1);
+    }
+
+  upper->nperiods   = desc->nperiods;
+  upper->head       = 0;
+  upper->nqueued    = 0;
+  upper->ncompleted = 0;
+
+  desc->base        = upper->ring;
+  return OK;
+}
+#endif
+
+/*******************************************************************************
+ * Name: audio_freering
+ *
+ * Description:
+ *   Handle the AUDIOIOC_FREERING ioctl command.
+ *
+ ******************************************************************************/
+
+#ifdef CONFIG_AUDIO_LOWLATENCY
+static int audio_freering(FAR struct audio_upperhalf_s *upper)
+{
+  int i;
+
+  if (upper->ring == NULL)
+    {
+      return OK;
+    }
+
+  if (upper->nqueued > 0)
+    {
+      return -EBUSY;
+    }
+
+  for (i = 0; i < upper->nperiods; i++)
+    {
+      nxsem_destroy(&upper->periods[i].sem);
+    }
+
+  kmm_free(upper->periods);
+  kumm_free(upper->ring);
+
+  upper->periods  = NULL;
+  upper->ring     = NULL;
+  upper->nperiods = 0;
+  return OK;
+}
+#endif
+
+/*******************************************************************************
+ * Name: audio_commitring
+ *
+ * Description:
+ *   Handle the AUDIOIOC_COMMITRING ioctl command:  Hand the next 'count'
+ *   periods of the ring to the lower half.
+ *
+ ******************************************************************************/
+
+#ifdef CONFIG_AUDIO_LOWLATENCY
+static int audio_commitring(FAR struct audio_upperhalf_s *upper,
+                            unsigned int count)
+{
+  FAR struct audio_lowerhalf_s *lower = upper->dev;
+  FAR struct ap_buffer_s *apb;
+  irqstate_t flags;
+  int ret;
+
+  DEBUGASSERT(lower->ops->enqueuebuffer != NULL);
+
+  /* nqueued can only decrease asynchronously, so this check is safe */
+
+  if (upper->ring == NULL || count > upper->nperiods - upper->nqueued)
+    {
+      return -EINVAL;
+    }
+
+  while (count-- > 0)
+    {
+      apb          = &upper->periods[upper->head];
+      apb->nbytes  = apb->nmaxbytes;
+      apb->curbyte = 0;
+      apb->flags   = 0;
+
+      /* Count the period before enqueuing it: it may complete at once */
+
+      flags = enter_critical_section();
+      upper->nqueued++;
+      leave_critical_section(flags);
+
+      ret = lower->ops->enqueuebuffer(lower, apb);
+      if (ret < 0)
+        {
+          flags = enter_critical_section();
+          upper->nqueued--;
+          leave_critical_section(flags);
+          return ret;
+        }
+
+      if (++upper->head >= upper->nperiods)
+        {
+          upper->head = 0;
+        }
+    }
+
+  return OK;
+}
+#endif
+
+/*******************************************************************************
+ * Name: audio_getposition
+ *
+ * Description:
+ *   Handle the AUDIOIOC_GETPOSITION ioctl command.  The position is the
+ *   number of completed periods plus, if the lower half can report it, the
+ *   progress of the hardware within the oldest enqueued period.
+ *
+ ******************************************************************************/
+
+#ifdef CONFIG_AUDIO_LOWLATENCY
+static int audio_getposition(FAR struct audio_upperhalf_s *upper,
+                             FAR struct audio_position_s *pos)
+{
+  FAR struct audio_lowerhalf_s *lower = upper->dev;
+  apb_samp_t partial;
+  uint32_t ncompleted;
+
+  DEBUGASSERT(pos != NULL);
+
+  if (upper->ring == NULL)
+    {
+      return -EINVAL;
+    }
+
+  /* Retry if a period completes while the lower half is being queried */
+
+  do
+    {
+      ncompleted   = upper->ncompleted;
+      pos->nqueued = upper->nqueued;
+      partial      = 0;
+
+      if (pos->nqueued > 0 && lower->ops->ioctl != NULL &&
+          lower->ops->ioctl(lower, AUDIOIOC_GETPOSITION,
+                            (unsigned long)((uintptr_t)&partial)) < 0)
+        {
+          partial = 0;
+        }
+    }
+  while (ncompleted != upper->ncompleted);
+
+  pos->nperiods = ncompleted;
+  pos->nbytes   = ncompleted * upper->periods[0].nmaxbytes + partial;
+  return OK;
+}
+#endif
+
+/*******************************************************************************
+ * Name: audio_poll
+ *
+ * Description:
+ *   The standard poll method.  POLLIN and POLLOUT are reported while the
+ *   application owns at least one period of the ring.
+ *
+ ******************************************************************************/
+
+#ifdef CONFIG_AUDIO_LOWLATENCY
+static int audio_poll(FAR struct file *filep, FAR struct pollfd *fds,
+                      bool setup)
+{
+  FAR struct inode *inode = filep->f_inode;
+  FAR struct audio_upperhalf_s *upper = inode->i_private;
+  FAR struct pollfd **slot;
+  int ret;
+  int i;
+
+  ret = nxsem_wait(&upper->exclsem);
+  if (ret < 0)
+    {
+      return ret;
+    }
+
+  if (setup)
+    {
+      /* Find an available slot for the poll structure reference */
+
+      for (i = 0; i < CONFIG_AUDIO_NPOLLWAITERS; i++)
+        {
+          if (upper->fds[i] == NULL)
+            {
+              upper->fds[i] = fds;
+              fds->priv     = &upper->fds[i];
+              break;
+            }
+        }
+
+      if (i >= CONFIG_AUDIO_NPOLLWAITERS)
+        {
+          auderr("ERROR: Too many poll waiters\n");
+          fds->priv = NULL;
+          ret       = -EBUSY;
+          goto errout;
+        }
+
+      /* Report at once if the application already owns a period */
+
+      if (upper->ring != NULL && upper->nqueued < upper->nperiods)
+        {
+          audio_pollnotify(upper);
+        }
+    }
+  else if (fds->priv != NULL)
+    {
+      /* This is a request to tear down the poll. */
+
+      slot      = (FAR struct pollfd **)fds->priv;
+      *slot     = NULL;
+      fds->priv = NULL;
+    }
+
+errout:
+  nxsem_post(&upper->exclsem);
+  return ret;
+}
+#endif
+
 /************************************************************************************
  * Name: audio_ioctl
  *
@@ -647,6 +993,84 @@ static int audio_ioctl(FAR struct file *filep, int cmd, unsigned long arg)
         }
         break;
 
+#ifdef CONFIG_AUDIO_LOWLATENCY
+      /* AUDIOIOC_ALLOCRING - Allocate the low-latency period ring
+       *
+       *   ioctl argument:  pointer to an audio_ring_desc_s structure
+       */
+
+      case AUDIOIOC_ALLOCRING:
+        {
+          audinfo("AUDIOIOC_ALLOCRING\n");
+
+          ret = audio_allocring(upper,
+                  (FAR struct audio_ring_desc_s *)((uintptr_t)arg));
+        }
+        break;
+
+      /* AUDIOIOC_FREERING - Free the low-latency period ring
+       *
+       *   ioctl argument:  None
+       */
+
+      case AUDIOIOC_FREERING:
+        {
+          audinfo("AUDIOIOC_FREERING\n");
+
+          ret = audio_freering(upper);
+        }
+        break;
+
+      /* AUDIOIOC_COMMITRING - Hand periods of the ring to the lower half
+       *
+       *   ioctl argument:  The number of periods
+       */
+
+      case AUDIOIOC_COMMITRING:
+        {
+          audinfo("AUDIOIOC_COMMITRING\n");
+
+          ret = audio_commitring(upper, (unsigned int)arg);
+        }
+        break;
+
+      /* AUDIOIOC_GETPOSITION - Get the hardware position in the ring
+       *
+       *   ioctl argument:  pointer to an audio_position_s structure
+       */
+
+      case AUDIOIOC_GETPOSITION:
+        {
+          ret = audio_getposition(upper,
+                  (FAR struct audio_position_s *)((uintptr_t)arg));
+        }
+        break;
+
+      /* FIOC_MMAP - Map the period ring into the application
+       *
+       *   ioctl argument:  location to return the address of the ring
+       */
+
+      case FIOC_MMAP:
+        {
+          FAR void **addr = (FAR void **)((uintptr_t)arg);
+
+          audinfo("FIOC_MMAP\n");
+
+          DEBUGASSERT(addr != NULL);
+          if (upper->ring != NULL)
+            {
+              *addr = upper->ring;
+              ret   = OK;
+            }
+          else
+            {
+              ret   = -EINVAL;
+            }
+        }
+        break;
+#endif
+
       /* Any unrecognized IOCTL commands might be platform-specific ioctl commands */
 
       default:
@@ -707,6 +1131,22 @@ static inline void audio_dequeuebuffer(FAR struct audio_upperhalf_s *upper,
 
   audinfo("Entry\n");
 
+#ifdef CONFIG_AUDIO_LOWLATENCY
+  /* Periods of the ring go back to the application without a message */
+
+  if (upper->ring != NULL && apb >= upper->periods &&
+      apb < &upper->periods[upper->nperiods])
+    {
+      irqstate_t flags = enter_critical_section();
+      upper->nqueued--;
+      upper->ncompleted++;
+      leave_critical_section(flags);
+
+      audio_pollnotify(upper);
+      return;
+    }
+#endif
+
   /* Send a dequeue message to the user if a message queue is registered */
 
   if (upper->usermq != NULL)
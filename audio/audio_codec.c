@@ -0,0 +1,1415 @@
+/****************************************************************************
+ * audio/audio_codec.c
+ *
+ *   Copyright (C) 2020 Gregory Nutt. All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in
+ *    the documentation and/or other materials provided with the
+ *    distribution.
+ * 3. Neither the name NuttX nor the names of its contributors may be
+ *    used to endorse or promote products derived from this software
+ *    without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+ * FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE
+ * COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+ * INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,
+ * BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS
+ * OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED
+ * AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ * LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN
+ * ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ *
+ ****************************************************************************/
+
+/****************************************************************************
+ * Included Files
+ ****************************************************************************/
+
+#include <nuttx/config.h>
+
+#include <sys/types.h>
+#include <stdint.h>
+#include <stdbool.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <sched.h>
+#include <queue.h>
+#include <assert.h>
+#include <errno.h>
+#include <debug.h>
+
+#include <nuttx/irq.h>
+#include <nuttx/kmalloc.h>
+#include <nuttx/kthread.h>
+#include <nuttx/semaphore.h>
+#include <nuttx/audio/audio.h>
+#include <nuttx/audio/audio_codec.h>
+
+#ifdef CONFIG_AUDIO_CODEC
+
+/****************************************************************************
+ * Private Types
+ ****************************************************************************/
+
+/* This structure describes the internal state of a codec stage.
+ *
+ * The stage moves buffers from a source queue through the codec into a
+ * destination queue.  For a decoder the sources are the compressed buffers
+ * of the upper half and the destinations are our own PCM buffers, which go
+ * on to the lower half.  For an encoder the sources are our own buffers,
+ * recorded by the lower half, and the destinations are the buffers of the
+ * upper half.
+ */
+
+struct codec_stage_s
+{
+  /* This is is our appearance to the outside world. This *MUST* be the
+   * first element of the structure so that we can freely cast between
+   * types struct audio_lowerhalf and struct codec_stage_s.
+   */
+
+  struct audio_lowerhalf_s export;
+
+  FAR struct audio_lowerhalf_s *lower; /* The device that plays or records */
+  FAR struct audio_codec_s *codec;     /* The codec that converts */
+#ifdef CONFIG_AUDIO_MULTI_SESSION
+  FAR void *session;                   /* Our session with the lower half */
+#endif
+  sem_t exclsem;                       /* Serializes the stage state */
+  sem_t wakesem;                       /* Wakes up the stage thread */
+  struct dq_queue_s srcq;              /* Buffers waiting to be converted */
+  struct dq_queue_s dstq;              /* Buffers waiting to be filled */
+  struct dq_queue_s idleq;             /* Encoders: unused record buffers */
+  FAR struct ap_buffer_s *src;         /* The buffer being converted */
+  FAR struct ap_buffer_s *dst;         /* The buffer being filled */
+  struct audio_codec_pcm_s pcm;        /* The format of the lower half */
+  uint8_t noutstanding;                /* Our buffers in the lower half */
+  bool reserved;                       /* True: The stage is reserved */
+  bool allocated;                      /* True: Our buffers are allocated */
+  bool configured;                     /* True: The lower half has 'pcm' */
+  bool started;                        /* True: The lower half is started */
+  bool paused;                         /* True: The stream is paused */
+  bool running;                        /* True: A stream is being converted */
+  bool eos;                            /* True: No more input will arrive */
+  bool draining;                       /* True: All input was converted */
+  bool drained;                        /* True: The codec is drained */
+};
+
+/****************************************************************************
+ * Private Function Prototypes
+ ****************************************************************************/
+
+static int codec_getcaps(FAR struct audio_lowerhalf_s *dev, int type,
+                         FAR struct audio_caps_s *caps);
+#ifdef CONFIG_AUDIO_MULTI_SESSION
+static int codec_configure(FAR struct audio_lowerhalf_s *dev,
+                           FAR void *session,
+                           FAR const struct audio_caps_s *caps);
+#else
+static int codec_configure(FAR struct audio_lowerhalf_s *dev,
+                           FAR const struct audio_caps_s *caps);
+#endif
+static int codec_shutdown(FAR struct audio_lowerhalf_s *dev);
+#ifdef CONFIG_AUDIO_MULTI_SESSION
+static int codec_start(FAR struct audio_lowerhalf_s *dev,
+                       FAR void *session);
+#else
+static int codec_start(FAR struct audio_lowerhalf_s *dev);
+#endif
+#ifndef CONFIG_AUDIO_EXCLUDE_STOP
+#ifdef CONFIG_AUDIO_MULTI_SESSION
+static int codec_stop(FAR struct audio_lowerhalf_s *dev,
+                      FAR void *session);
+#else
+static int codec_stop(FAR struct audio_lowerhalf_s *dev);
+#endif
+#endif
+#ifndef CONFIG_AUDIO_EXCLUDE_PAUSE_RESUME
+#ifdef CONFIG_AUDIO_MULTI_SESSION
+static int codec_pause(FAR struct audio_lowerhalf_s *dev,
+                       FAR void *session);
+static int codec_resume(FAR struct audio_lowerhalf_s *dev,
+                        FAR void *session);
+#else
+static int codec_pause(FAR struct audio_lowerhalf_s *dev);
+static int codec_resume(FAR struct audio_lowerhalf_s *dev);
+#endif
+#endif
+static int codec_enqueuebuffer(FAR struct audio_lowerhalf_s *dev,
+                               FAR struct ap_buffer_s *apb);
+static int codec_ioctl(FAR struct audio_lowerhalf_s *dev, int cmd,
+                       unsigned long arg);
+#ifdef CONFIG_AUDIO_MULTI_SESSION
+static int codec_reserve(FAR struct audio_lowerhalf_s *dev,
+                         FAR void **session);
+static int codec_release(FAR struct audio_lowerhalf_s *dev,
+                         FAR void *session);
+#else
+static int codec_reserve(FAR struct audio_lowerhalf_s *dev);
+static int codec_release(FAR struct audio_lowerhalf_s *dev);
+#endif
+
+#ifdef CONFIG_AUDIO_MULTI_SESSION
+static void codec_callback(FAR void *arg, uint16_t reason,
+                           FAR struct ap_buffer_s *apb, uint16_t status,
+                           FAR void *session);
+#else
+static void codec_callback(FAR void *arg, uint16_t reason,
+                           FAR struct ap_buffer_s *apb, uint16_t status);
+#endif
+
+/****************************************************************************
+ * Private Data
+ ****************************************************************************/
+
+static const struct audio_ops_s g_codec_ops =
+{
+  codec_getcaps,       /* getcaps        */
+  codec_configure,     /* configure      */
+  codec_shutdown,      /* shutdown       */
+  codec_start,         /* start          */
+#ifndef CONFIG_AUDIO_EXCLUDE_STOP
+  codec_stop,          /* stop           */
+#endif
+#ifndef CONFIG_AUDIO_EXCLUDE_PAUSE_RESUME
+  codec_pause,         /* pause          */
+  codec_resume,        /* resume         */
+#endif
+  NULL,                /* allocbuffer    */
+  NULL,                /* freebuffer     */
+  codec_enqueuebuffer, /* enqueue_buffer */
+  NULL,                /* cancel_buffer  */
+  codec_ioctl,         /* ioctl          */
+  NULL,                /* read           */
+  NULL,                /* write          */
+  codec_reserve,       /* reserve        */
+  codec_release        /* release        */
+};
+
+/****************************************************************************
+ * Private Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: codec_notify
+ *
+ * Description:
+ *   Report an event to the upper half.
+ *
+ ****************************************************************************/
+
+static void codec_notify(FAR struct codec_stage_s *stage, uint16_t reason,
+                         FAR struct ap_buffer_s *apb, uint16_t status)
+{
+#ifdef CONFIG_AUDIO_MULTI_SESSION
+  stage->export.upper(stage->export.priv, reason, apb, status, stage);
+#else
+  stage->export.upper(stage->export.priv, reason, apb, status);
+#endif
+}
+
+/****************************************************************************
+ * Name: codec_wake
+ *
+ * Description:
+ *   Wake up the stage thread.  May be called from interrupt handlers.
+ *
+ ****************************************************************************/
+
+static void codec_wake(FAR struct codec_stage_s *stage)
+{
+  int value;
+
+  /* One pending wake-up is enough: the thread converts all it can */
+
+  if (nxsem_getvalue(&stage->wakesem, &value) >= 0 && value <= 0)
+    {
+      nxsem_post(&stage->wakesem);
+    }
+}
+
+/****************************************************************************
+ * Name: codec_startlower
+ *
+ * Description:
+ *   Start the lower half.  Called with exclsem held.
+ *
+ ****************************************************************************/
+
+static void codec_startlower(FAR struct codec_stage_s *stage)
+{
+  FAR struct audio_lowerhalf_s *lower = stage->lower;
+  int ret;
+
+#ifdef CONFIG_AUDIO_MULTI_SESSION
+  ret = lower->ops->start(lower, stage->session);
+#else
+  ret = lower->ops->start(lower);
+#endif
+  if (ret < 0)
+    {
+      auderr("ERROR: Failed to start the lower half: %d\n", ret);
+      return;
+    }
+
+  stage->started = true;
+}
+
+/****************************************************************************
+ * Name: codec_stoplower
+ *
+ * Description:
+ *   Stop the lower half.  Called with exclsem held.
+ *
+ ****************************************************************************/
+
+static void codec_stoplower(FAR struct codec_stage_s *stage)
+{
+#ifndef CONFIG_AUDIO_EXCLUDE_STOP
+  FAR struct audio_lowerhalf_s *lower = stage->lower;
+
+  if (stage->started)
+    {
+#ifdef CONFIG_AUDIO_MULTI_SESSION
+      lower->ops->stop(lower, stage->session);
+#else
+      lower->ops->stop(lower);
+#endif
+    }
+#endif
+
+  stage->started = false;
+}
+
+/****************************************************************************
+ * Name: codec_configlower
+ *
+ * Description:
+ *   Configure the lower half for the PCM format in 'pcm'.
+ *
+ ****************************************************************************/
+
+static int codec_configlower(FAR struct codec_stage_s *stage, uint8_t type)
+{
+  FAR struct audio_lowerhalf_s *lower = stage->lower;
+  struct audio_caps_s caps;
+  int ret;
+
+  memset(&caps, 0, sizeof(struct audio_caps_s));
+  caps.ac_len            = sizeof(struct audio_caps_s);
+  caps.ac_type           = type;
+  caps.ac_channels       = stage->pcm.channels;
+  caps.ac_controls.hw[0] = stage->pcm.samplerate;
+  caps.ac_controls.b[2]  = stage->pcm.bpsamp;
+
+#ifdef CONFIG_AUDIO_MULTI_SESSION
+  ret = lower->ops->configure(lower, stage->session, &caps);
+#else
+  ret = lower->ops->configure(lower, &caps);
+#endif
+  if (ret < 0)
+    {
+      auderr("ERROR: Failed to configure %u ch %u bits %lu Hz: %d\n",
+             stage->pcm.channels, stage->pcm.bpsamp,
+             (unsigned long)stage->pcm.samplerate, ret);
+      return ret;
+    }
+
+  stage->configured = true;
+  return OK;
+}
+
+/****************************************************************************
+ * Name: codec_record
+ *
+ * Description:
+ *   Give one of our buffers to the lower half to record into.  Called with
+ *   exclsem held.
+ *
+ ****************************************************************************/
+
+static int codec_record(FAR struct codec_stage_s *stage,
+                        FAR struct ap_buffer_s *apb)
+{
+  FAR struct audio_lowerhalf_s *lower = stage->lower;
+  irqstate_t flags;
+  int ret;
+
+  apb->nbytes  = 0;
+  apb->curbyte = 0;
+  apb->flags   = 0;
+#ifdef CONFIG_AUDIO_MULTI_SESSION
+  apb->session = stage->session;
+#endif
+
+  flags = enter_critical_section();
+  stage->noutstanding++;
+  leave_critical_section(flags);
+
+  ret = lower->ops->enqueuebuffer(lower, apb);
+  if (ret < 0)
+    {
+      auderr("ERROR: Failed to enqueue a record buffer: %d\n", ret);
+
+      flags = enter_critical_section();
+      stage->noutstanding--;
+      dq_addlast(&apb->dq_entry, &stage->idleq);
+      leave_critical_section(flags);
+    }
+
+  return ret;
+}
+
+/****************************************************************************
+ * Name: codec_emit
+ *
+ * Description:
+ *   Pass on a filled destination buffer: decoded PCM goes to the lower
+ *   half, encoded data back to the upper half.  The lower half is started
+ *   once all of our buffers are queued to it, or when the stream ends
+ *   before that.  Called with exclsem held.
+ *
+ ****************************************************************************/
+
+static void codec_emit(FAR struct codec_stage_s *stage,
+                       FAR struct ap_buffer_s *apb)
+{
+  FAR struct audio_lowerhalf_s *lower = stage->lower;
+  irqstate_t flags;
+  int ret;
+
+  if (stage->codec->encoder)
+    {
+      codec_notify(stage, AUDIO_CALLBACK_DEQUEUE, apb, OK);
+      return;
+    }
+
+  if (!stage->configured)
+    {
+      ret = codec_configlower(stage, AUDIO_TYPE_OUTPUT);
+      if (ret < 0)
+        {
+          goto errout;
+        }
+    }
+
+  apb->curbyte = 0;
+#ifdef CONFIG_AUDIO_MULTI_SESSION
+  apb->session = stage->session;
+#endif
+
+  flags = enter_critical_section();
+  stage->noutstanding++;
+  leave_critical_section(flags);
+
+  ret = lower->ops->enqueuebuffer(lower, apb);
+  if (ret < 0)
+    {
+      auderr("ERROR: Failed to enqueue decoded data: %d\n", ret);
+
+      flags = enter_critical_section();
+      stage->noutstanding--;
+      leave_critical_section(flags);
+      goto errout;
+    }
+
+  if (!stage->started && !stage->paused &&
+      (dq_empty(&stage->dstq) || stage->draining))
+    {
+      codec_startlower(stage);
+    }
+
+  return;
+
+errout:
+
+  /* The data is lost, but the buffer remains ours */
+
+  flags = enter_critical_section();
+  dq_addlast(&apb->dq_entry, &stage->dstq);
+  leave_critical_section(flags);
+}
+
+/****************************************************************************
+ * Name: codec_retire
+ *
+ * Description:
+ *   Dispose of a source buffer whose data has all been converted.  Called
+ *   with exclsem held.
+ *
+ ****************************************************************************/
+
+static void codec_retire(FAR struct codec_stage_s *stage,
+                         FAR struct ap_buffer_s *apb)
+{
+  irqstate_t flags;
+
+  if (!stage->codec->encoder)
+    {
+      codec_notify(stage, AUDIO_CALLBACK_DEQUEUE, apb, OK);
+    }
+  else if (!stage->eos)
+    {
+      codec_record(stage, apb);
+    }
+  else
+    {
+      flags = enter_critical_section();
+      dq_addlast(&apb->dq_entry, &stage->idleq);
+      leave_critical_section(flags);
+    }
+}
+
+/****************************************************************************
+ * Name: codec_halt
+ *
+ * Description:
+ *   End the stream: stop the lower half, return the buffers of the upper
+ *   half, close the codec and report completion.  Called with exclsem
+ *   held.
+ *
+ ****************************************************************************/
+
+static void codec_halt(FAR struct codec_stage_s *stage)
+{
+  FAR struct audio_codec_s *codec = stage->codec;
+  FAR struct dq_queue_s *upperq;
+  FAR struct ap_buffer_s *upper;
+  FAR struct ap_buffer_s *ours;
+  FAR struct ap_buffer_s *apb;
+  irqstate_t flags;
+
+  codec_stoplower(stage);
+
+  if (codec->encoder)
+    {
+      upperq = &stage->dstq;
+      upper  = stage->dst;
+      ours   = stage->src;
+    }
+  else
+    {
+      upperq = &stage->srcq;
+      upper  = stage->src;
+      ours   = stage->dst;
+    }
+
+  stage->src = NULL;
+  stage->dst = NULL;
+
+  if (ours != NULL)
+    {
+      flags = enter_critical_section();
+      dq_addlast(&ours->dq_entry,
+                 codec->encoder ? &stage->idleq : &stage->dstq);
+      leave_critical_section(flags);
+    }
+
+  apb = upper;
+  for (; ; )
+    {
+      if (apb == NULL)
+        {
+          flags = enter_critical_section();
+          apb = (FAR struct ap_buffer_s *)dq_remfirst(upperq);
+          leave_critical_section(flags);
+
+          if (apb == NULL)
+            {
+              break;
+            }
+        }
+
+      codec_notify(stage, AUDIO_CALLBACK_DEQUEUE, apb, OK);
+      apb = NULL;
+    }
+
+  if (codec->encoder)
+    {
+      /* Recorded data that was not converted is dropped */
+
+      flags = enter_critical_section();
+      while ((apb = (FAR struct ap_buffer_s *)
+                    dq_remfirst(&stage->srcq)) != NULL)
+        {
+          dq_addlast(&apb->dq_entry, &stage->idleq);
+        }
+
+      leave_critical_section(flags);
+    }
+
+  if (!stage->drained && codec->ops->close != NULL)
+    {
+      codec->ops->close(codec);
+    }
+
+  stage->running  = false;
+  stage->eos      = false;
+  stage->draining = false;
+  stage->drained  = false;
+
+  codec_notify(stage, AUDIO_CALLBACK_COMPLETE, NULL, OK);
+}
+
+/****************************************************************************
+ * Name: codec_abort
+ *
+ * Description:
+ *   End the stream after a codec failure.  Called with exclsem held.
+ *
+ ****************************************************************************/
+
+static void codec_abort(FAR struct codec_stage_s *stage, int errcode)
+{
+  auderr("ERROR: Codec failed: %d\n", errcode);
+
+  codec_notify(stage, AUDIO_CALLBACK_IOERR, NULL, (uint16_t)-errcode);
+  codec_halt(stage);
+}
+
+/****************************************************************************
+ * Name: codec_step
+ *
+ * Description:
+ *   Run the codec once on the current source and destination buffers and
+ *   move the buffers along.  Called by the stage thread with exclsem held.
+ *   Returns true if anything changed, false if the stage has to wait for
+ *   buffers.
+ *
+ ****************************************************************************/
+
+static bool codec_step(FAR struct codec_stage_s *stage)
+{
+  FAR struct audio_codec_s *codec = stage->codec;
+  struct audio_codec_xfer_s xfer;
+  FAR struct ap_buffer_s *src;
+  FAR struct ap_buffer_s *dst;
+  irqstate_t flags;
+  int ret;
+
+  if (!stage->running)
+    {
+      return false;
+    }
+
+  /* A drained decoder completes when all of its output has been played */
+
+  if (stage->drained)
+    {
+      if (codec->encoder || stage->noutstanding == 0)
+        {
+          codec_halt(stage);
+        }
+
+      return false;
+    }
+
+  flags = enter_critical_section();
+  if (stage->src == NULL && !stage->draining)
+    {
+      stage->src = (FAR struct ap_buffer_s *)dq_remfirst(&stage->srcq);
+
+      /* A stopped encoder drains after the last recording came back */
+
+      if (stage->src == NULL && stage->eos && stage->noutstanding == 0)
+        {
+          stage->draining = true;
+        }
+    }
+
+  if (stage->dst == NULL)
+    {
+      stage->dst = (FAR struct ap_buffer_s *)dq_remfirst(&stage->dstq);
+      if (stage->dst != NULL)
+        {
+          stage->dst->nbytes  = 0;
+          stage->dst->curbyte = 0;
+          stage->dst->flags   = 0;
+        }
+    }
+
+  leave_critical_section(flags);
+
+  src = stage->src;
+  dst = stage->dst;
+
+  if (dst == NULL)
+    {
+      return false;
+    }
+
+  if (src == NULL && !stage->draining)
+    {
+      /* Out of input.  Play what a decoder has so far rather than let the
+       * lower half run dry.
+       */
+
+      if (!codec->encoder && dst->nbytes > 0)
+        {
+          stage->dst = NULL;
+          codec_emit(stage, dst);
+          return true;
+        }
+
+      return false;
+    }
+
+  /* Convert straight from the source into the destination buffer */
+
+  memset(&xfer, 0, sizeof(struct audio_codec_xfer_s));
+  if (src != NULL)
+    {
+      xfer.in    = &src->samp[src->curbyte];
+      xfer.inlen = src->nbytes - src->curbyte;
+      xfer.final = (src->flags & AUDIO_APB_FINAL) != 0;
+    }
+  else
+    {
+      xfer.final = true;
+    }
+
+  xfer.out    = &dst->samp[dst->nbytes];
+  xfer.outlen = dst->nmaxbytes - dst->nbytes;
+  xfer.pcm    = stage->pcm;
+
+  ret = codec->ops->process(codec, &xfer);
+  if (ret < 0)
+    {
+      codec_abort(stage, ret);
+      return false;
+    }
+
+  DEBUGASSERT(xfer.consumed <= xfer.inlen && xfer.produced <= xfer.outlen);
+
+  if (src != NULL)
+    {
+      src->curbyte += xfer.consumed;
+    }
+
+  dst->nbytes += xfer.produced;
+
+  /* The lower half is reconfigured if a decoder reports a new format */
+
+  if (!codec->encoder && xfer.produced > 0 &&
+      memcmp(&xfer.pcm, &stage->pcm, sizeof(struct audio_codec_pcm_s)) != 0)
+    {
+      stage->pcm        = xfer.pcm;
+      stage->configured = false;
+    }
+
+  if (src != NULL && src->curbyte >= src->nbytes)
+    {
+      if ((src->flags & AUDIO_APB_FINAL) != 0)
+        {
+          stage->draining = true;
+        }
+
+      stage->src = NULL;
+      codec_retire(stage, src);
+      return true;
+    }
+
+  if (xfer.consumed > 0 || xfer.produced > 0)
+    {
+      return true;
+    }
+
+  /* No progress: the destination is full, or the codec is drained */
+
+  if (dst->nbytes > 0)
+    {
+      stage->dst = NULL;
+      codec_emit(stage, dst);
+      return true;
+    }
+
+  if (src != NULL)
+    {
+      /* Not even an empty buffer holds one unit of output */
+
+      codec_abort(stage, -ENOSPC);
+      return false;
+    }
+
+  if (codec->ops->close != NULL)
+    {
+      codec->ops->close(codec);
+    }
+
+  stage->drained = true;
+  stage->dst     = NULL;
+
+  if (codec->encoder)
+    {
+      dst->flags |= AUDIO_APB_FINAL;
+      codec_emit(stage, dst);
+    }
+  else
+    {
+      flags = enter_critical_section();
+      dq_addlast(&dst->dq_entry, &stage->dstq);
+      leave_critical_section(flags);
+
+      /* Play out a short stream that did not fill all of our buffers */
+
+      if (!stage->started && !stage->paused && stage->noutstanding > 0)
+        {
+          codec_startlower(stage);
+        }
+    }
+
+  return true;
+}
+
+/****************************************************************************
+ * Name: codec_thread
+ *
+ * Description:
+ *   The stage thread.  Codecs can take a long time per frame or wait for
+ *   another core, so they do not run on a work queue.
+ *
+ * Input Parameters:
+ *   argc, argv - argv[1] holds the address of the codec stage
+ *
+ ****************************************************************************/
+
+static int codec_thread(int argc, FAR char *argv[])
+{
+  FAR struct codec_stage_s *stage;
+
+  DEBUGASSERT(argc > 1);
+  stage = (FAR struct codec_stage_s *)
+    ((uintptr_t)strtoul(argv[1], NULL, 0));
+
+  for (; ; )
+    {
+      nxsem_wait_uninterruptible(&stage->wakesem);
+      nxsem_wait_uninterruptible(&stage->exclsem);
+
+      while (codec_step(stage))
+        {
+        }
+
+      nxsem_post(&stage->exclsem);
+    }
+
+  return OK;
+}
+
+/****************************************************************************
+ * Name: codec_allocbuffers
+ *
+ * Description:
+ *   Allocate the buffers that we exchange with the lower half.  They are
+ *   allocated on first use and kept.  Called with exclsem held.
+ *
+ ****************************************************************************/
+
+static int codec_allocbuffers(FAR struct codec_stage_s *stage)
+{
+  FAR struct audio_lowerhalf_s *lower = stage->lower;
+  struct audio_buf_desc_s bufdesc;
+  FAR struct ap_buffer_s *apb;
+  int ret;
+  int i;
+
+  if (stage->allocated)
+    {
+      return OK;
+    }
+
+  for (i = 0; i < CONFIG_AUDIO_CODEC_NBUFFERS; i++)
+    {
+#ifdef CONFIG_AUDIO_MULTI_SESSION
+      bufdesc.session    = stage->session;
+#endif
+      bufdesc.numbytes   = CONFIG_AUDIO_CODEC_BUFSIZE;
+      bufdesc.u.ppBuffer = &apb;
+
+      if (lower->ops->allocbuffer != NULL)
+        {
+          ret = lower->ops->allocbuffer(lower, &bufdesc);
+        }
+      else
+        {
+          ret = apb_alloc(&bufdesc);
+        }
+
+      if (ret < 0)
+        {
+          auderr("ERROR: Failed to allocate the stage buffers: %d\n", ret);
+          return ret;
+        }
+
+      dq_addlast(&apb->dq_entry,
+                 stage->codec->encoder ? &stage->idleq : &stage->dstq);
+    }
+
+  stage->allocated = true;
+  return OK;
+}
+
+/****************************************************************************
+ * Name: codec_getcaps
+ *
+ * Description:
+ *   Get the capabilities of the lower half, with the format of the codec
+ *   in place of PCM.
+ *
+ ****************************************************************************/
+
+static int codec_getcaps(FAR struct audio_lowerhalf_s *dev, int type,
+                         FAR struct audio_caps_s *caps)
+{
+  FAR struct codec_stage_s *stage = (FAR struct codec_stage_s *)dev;
+  FAR struct audio_lowerhalf_s *lower = stage->lower;
+  int ret;
+
+  ret = lower->ops->getcaps(lower, type, caps);
+  if (ret >= 0 && caps->ac_type == AUDIO_TYPE_QUERY &&
+      caps->ac_subtype == AUDIO_TYPE_QUERY)
+    {
+      caps->ac_format.hw = 1 << (stage->codec->format - 1);
+    }
+
+  return ret;
+}
+
+/****************************************************************************
+ * Name: codec_configure
+ *
+ * Description:
+ *   Configure the stage.  A decoder takes its output format from the
+ *   stream; an encoder records in the format given here.  Everything else
+ *   is passed to the lower half.
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_AUDIO_MULTI_SESSION
+static int codec_configure(FAR struct audio_lowerhalf_s *dev,
+                           FAR void *session,
+                           FAR const struct audio_caps_s *caps)
+#else
+static int codec_configure(FAR struct audio_lowerhalf_s *dev,
+                           FAR const struct audio_caps_s *caps)
+#endif
+{
+  FAR struct codec_stage_s *stage = (FAR struct codec_stage_s *)dev;
+  FAR struct audio_lowerhalf_s *lower = stage->lower;
+  int ret;
+
+  switch (caps->ac_type)
+    {
+      case AUDIO_TYPE_OUTPUT:
+        return stage->codec->encoder ? -EINVAL : OK;
+
+      case AUDIO_TYPE_INPUT:
+        if (!stage->codec->encoder)
+          {
+            return -EINVAL;
+          }
+
+        nxsem_wait_uninterruptible(&stage->exclsem);
+
+        stage->pcm.samplerate = caps->ac_controls.hw[0];
+        stage->pcm.channels   = caps->ac_channels;
+        stage->pcm.bpsamp     = caps->ac_controls.b[2];
+
+        ret = codec_configlower(stage, AUDIO_TYPE_INPUT);
+        nxsem_post(&stage->exclsem);
+        return ret;
+
+      default:
+#ifdef CONFIG_AUDIO_MULTI_SESSION
+        return lower->ops->configure(lower, stage->session, caps);
+#else
+        return lower->ops->configure(lower, caps);
+#endif
+    }
+}
+
+/****************************************************************************
+ * Name: codec_shutdown
+ *
+ * Description: Shutdown the lower half
+ *
+ ****************************************************************************/
+
+static int codec_shutdown(FAR struct audio_lowerhalf_s *dev)
+{
+  FAR struct codec_stage_s *stage = (FAR struct codec_stage_s *)dev;
+  FAR struct audio_lowerhalf_s *lower = stage->lower;
+
+  return lower->ops->shutdown(lower);
+}
+
+/****************************************************************************
+ * Name: codec_start
+ *
+ * Description:
+ *   Start converting a stream.  A decoder starts the lower half once it
+ *   has decoded enough to fill our buffers; an encoder starts recording
+ *   right away.
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_AUDIO_MULTI_SESSION
+static int codec_start(FAR struct audio_lowerhalf_s *dev, FAR void *session)
+#else
+static int codec_start(FAR struct audio_lowerhalf_s *dev)
+#endif
+{
+  FAR struct codec_stage_s *stage = (FAR struct codec_stage_s *)dev;
+  FAR struct audio_codec_s *codec = stage->codec;
+  FAR struct ap_buffer_s *apb;
+  irqstate_t flags;
+  int ret;
+
+  nxsem_wait_uninterruptible(&stage->exclsem);
+
+  if (stage->running)
+    {
+      ret = -EBUSY;
+      goto errout;
+    }
+
+  if (codec->encoder && !stage->configured)
+    {
+      ret = -EINVAL;
+      goto errout;
+    }
+
+  ret = codec_allocbuffers(stage);
+  if (ret < 0)
+    {
+      goto errout;
+    }
+
+  if (!codec->encoder)
+    {
+      /* The decoder reports the format with its first output */
+
+      memset(&stage->pcm, 0, sizeof(struct audio_codec_pcm_s));
+      stage->configured = false;
+    }
+
+  if (codec->ops->open != NULL)
+    {
+      ret = codec->ops->open(codec, &stage->pcm);
+      if (ret < 0)
+        {
+          auderr("ERROR: Failed to open the codec: %d\n", ret);
+          goto errout;
+        }
+    }
+
+  stage->paused  = false;
+  stage->running = true;
+
+  if (codec->encoder)
+    {
+      for (; ; )
+        {
+          flags = enter_critical_section();
+          apb = (FAR struct ap_buffer_s *)dq_remfirst(&stage->idleq);
+          leave_critical_section(flags);
+
+          if (apb == NULL || codec_record(stage, apb) < 0)
+            {
+              break;
+            }
+        }
+
+      codec_startlower(stage);
+    }
+
+  nxsem_post(&stage->exclsem);
+  codec_wake(stage);
+  return OK;
+
+errout:
+  nxsem_post(&stage->exclsem);
+  return ret;
+}
+
+/****************************************************************************
+ * Name: codec_stop
+ *
+ * Description:
+ *   Stop the stream.  A decoder drops its input at once; an encoder stops
+ *   recording and completes when what was recorded has been encoded.
+ *
+ ****************************************************************************/
+
+#ifndef CONFIG_AUDIO_EXCLUDE_STOP
+#ifdef CONFIG_AUDIO_MULTI_SESSION
+static int codec_stop(FAR struct audio_lowerhalf_s *dev, FAR void *session)
+#else
+static int codec_stop(FAR struct audio_lowerhalf_s *dev)
+#endif
+{
+  FAR struct codec_stage_s *stage = (FAR struct codec_stage_s *)dev;
+
+  nxsem_wait_uninterruptible(&stage->exclsem);
+
+  if (stage->running)
+    {
+      if (stage->codec->encoder)
+        {
+          stage->eos = true;
+          codec_stoplower(stage);
+        }
+      else
+        {
+          codec_halt(stage);
+        }
+    }
+
+  nxsem_post(&stage->exclsem);
+  codec_wake(stage);
+  return OK;
+}
+#endif
+
+/****************************************************************************
+ * Name: codec_pause
+ *
+ * Description: Pause the stream
+ *
+ ****************************************************************************/
+
+#ifndef CONFIG_AUDIO_EXCLUDE_PAUSE_RESUME
+#ifdef CONFIG_AUDIO_MULTI_SESSION
+static int codec_pause(FAR struct audio_lowerhalf_s *dev, FAR void *session)
+#else
+static int codec_pause(FAR struct audio_lowerhalf_s *dev)
+#endif
+{
+  FAR struct codec_stage_s *stage = (FAR struct codec_stage_s *)dev;
+  FAR struct audio_lowerhalf_s *lower = stage->lower;
+  int ret = OK;
+
+  nxsem_wait_uninterruptible(&stage->exclsem);
+
+  stage->paused = true;
+  if (stage->started)
+    {
+#ifdef CONFIG_AUDIO_MULTI_SESSION
+      ret = lower->ops->pause(lower, stage->session);
+#else
+      ret = lower->ops->pause(lower);
+#endif
+    }
+
+  nxsem_post(&stage->exclsem);
+  return ret;
+}
+
+/****************************************************************************
+ * Name: codec_resume
+ *
+ * Description:
+ *   Resume the stream.  A decoder that was paused before its output
+ *   started starts it now.
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_AUDIO_MULTI_SESSION
+static int codec_resume(FAR struct audio_lowerhalf_s *dev, FAR void *session)
+#else
+static int codec_resume(FAR struct audio_lowerhalf_s *dev)
+#endif
+{
+  FAR struct codec_stage_s *stage = (FAR struct codec_stage_s *)dev;
+  FAR struct audio_lowerhalf_s *lower = stage->lower;
+  int ret = OK;
+
+  nxsem_wait_uninterruptible(&stage->exclsem);
+
+  stage->paused = false;
+  if (stage->started)
+    {
+#ifdef CONFIG_AUDIO_MULTI_SESSION
+      ret = lower->ops->resume(lower, stage->session);
+#else
+      ret = lower->ops->resume(lower);
+#endif
+    }
+  else if (stage->running && stage->noutstanding > 0)
+    {
+      codec_startlower(stage);
+    }
+
+  nxsem_post(&stage->exclsem);
+  return ret;
+}
+#endif
+
+/****************************************************************************
+ * Name: codec_enqueuebuffer
+ *
+ * Description:
+ *   Queue a buffer of the upper half: compressed data for a decoder, or
+ *   space for an encoder to fill.
+ *
+ ****************************************************************************/
+
+static int codec_enqueuebuffer(FAR struct audio_lowerhalf_s *dev,
+                               FAR struct ap_buffer_s *apb)
+{
+  FAR struct codec_stage_s *stage = (FAR struct codec_stage_s *)dev;
+  irqstate_t flags;
+
+  apb->curbyte = 0;
+
+  flags = enter_critical_section();
+  dq_addlast(&apb->dq_entry,
+             stage->codec->encoder ? &stage->dstq : &stage->srcq);
+  leave_critical_section(flags);
+
+  codec_wake(stage);
+  return OK;
+}
+
+/****************************************************************************
+ * Name: codec_ioctl
+ *
+ * Description: Pass ioctl commands to the lower half
+ *
+ ****************************************************************************/
+
+static int codec_ioctl(FAR struct audio_lowerhalf_s *dev, int cmd,
+                       unsigned long arg)
+{
+  FAR struct codec_stage_s *stage = (FAR struct codec_stage_s *)dev;
+  FAR struct audio_lowerhalf_s *lower = stage->lower;
+
+  if (lower->ops->ioctl == NULL)
+    {
+      return -ENOTTY;
+    }
+
+  return lower->ops->ioctl(lower, cmd, arg);
+}
+
+/****************************************************************************
+ * Name: codec_reserve
+ *
+ * Description: Reserve the stage and the lower half
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_AUDIO_MULTI_SESSION
+static int codec_reserve(FAR struct audio_lowerhalf_s *dev,
+                         FAR void **session)
+#else
+static int codec_reserve(FAR struct audio_lowerhalf_s *dev)
+#endif
+{
+  FAR struct codec_stage_s *stage = (FAR struct codec_stage_s *)dev;
+  FAR struct audio_lowerhalf_s *lower = stage->lower;
+  int ret;
+
+  nxsem_wait_uninterruptible(&stage->exclsem);
+
+  if (stage->reserved)
+    {
+      ret = -EBUSY;
+      goto out;
+    }
+
+#ifdef CONFIG_AUDIO_MULTI_SESSION
+  ret = lower->ops->reserve(lower, &stage->session);
+#else
+  ret = lower->ops->reserve(lower);
+#endif
+  if (ret < 0)
+    {
+      goto out;
+    }
+
+  stage->reserved   = true;
+  stage->configured = false;
+#ifdef CONFIG_AUDIO_MULTI_SESSION
+  *session = stage;
+#endif
+
+out:
+  nxsem_post(&stage->exclsem);
+  return ret;
+}
+
+/****************************************************************************
+ * Name: codec_release
+ *
+ * Description: Release the stage and the lower half
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_AUDIO_MULTI_SESSION
+static int codec_release(FAR struct audio_lowerhalf_s *dev,
+                         FAR void *session)
+#else
+static int codec_release(FAR struct audio_lowerhalf_s *dev)
+#endif
+{
+  FAR struct codec_stage_s *stage = (FAR struct codec_stage_s *)dev;
+  FAR struct audio_lowerhalf_s *lower = stage->lower;
+  int ret = OK;
+
+  nxsem_wait_uninterruptible(&stage->exclsem);
+
+  if (stage->reserved)
+    {
+#ifdef CONFIG_AUDIO_MULTI_SESSION
+      ret = lower->ops->release(lower, stage->session);
+#else
+      ret = lower->ops->release(lower);
+#endif
+      stage->reserved = false;
+    }
+
+  nxsem_post(&stage->exclsem);
+  return ret;
+}
+
+/****************************************************************************
+ * Name: codec_callback
+ *
+ * Description:
+ *   Lower half callback.  Our buffers come back here: played buffers of a
+ *   decoder can be filled again, recorded buffers of an encoder are ready
+ *   to be encoded.
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_AUDIO_MULTI_SESSION
+static void codec_callback(FAR void *arg, uint16_t reason,
+                           FAR struct ap_buffer_s *apb, uint16_t status,
+                           FAR void *session)
+#else
+static void codec_callback(FAR void *arg, uint16_t reason,
+                           FAR struct ap_buffer_s *apb, uint16_t status)
+#endif
+{
+  FAR struct codec_stage_s *stage = (FAR struct codec_stage_s *)arg;
+  FAR struct dq_queue_s *queue;
+  irqstate_t flags;
+
+  switch (reason)
+    {
+      case AUDIO_CALLBACK_DEQUEUE:
+        if (!stage->codec->encoder)
+          {
+            queue = &stage->dstq;
+          }
+        else
+          {
+            apb->curbyte = 0;
+            queue = stage->running ? &stage->srcq : &stage->idleq;
+          }
+
+        flags = enter_critical_section();
+        dq_addlast(&apb->dq_entry, queue);
+        stage->noutstanding--;
+        leave_critical_section(flags);
+
+        codec_wake(stage);
+        break;
+
+      case AUDIO_CALLBACK_IOERR:
+        codec_notify(stage, AUDIO_CALLBACK_IOERR, NULL, status);
+        break;
+
+      default:
+
+        /* Completion is reported when the codec is done, not here */
+
+        break;
+    }
+}
+
+/****************************************************************************
+ * Public Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: audio_codec_initialize
+ *
+ * Description:
+ *   Put a codec stage in front of a lower half audio device.
+ *
+ * Input Parameters:
+ *   lower - The lower half that plays or records PCM
+ *   codec - The codec to run
+ *
+ * Returned Value:
+ *   The new lower half on success; NULL on failure.
+ *
+ ****************************************************************************/
+
+FAR struct audio_lowerhalf_s *
+  audio_codec_initialize(FAR struct audio_lowerhalf_s *lower,
+                         FAR struct audio_codec_s *codec)
+{
+  FAR struct codec_stage_s *stage;
+  FAR char *argv[2];
+  char arg1[16];
+  pid_t pid;
+
+  DEBUGASSERT(lower != NULL && codec != NULL && codec->ops != NULL &&
+              codec->ops->process != NULL);
+
+  stage = kmm_zalloc(sizeof(struct codec_stage_s));
+  if (stage == NULL)
+    {
+      return NULL;
+    }
+
+  stage->export.ops = &g_codec_ops;
+  stage->lower      = lower;
+  stage->codec      = codec;
+
+  nxsem_init(&stage->exclsem, 0, 1);
+
+  /* The wake-up semaphore is used for signaling */
+
+  nxsem_init(&stage->wakesem, 0, 0);
+  nxsem_setprotocol(&stage->wakesem, SEM_PRIO_NONE);
+
+  lower->upper = codec_callback;
+  lower->priv  = stage;
+
+  snprintf(arg1, sizeof(arg1), "0x%lx", (unsigned long)(uintptr_t)stage);
+  argv[0] = arg1;
+  argv[1] = NULL;
+
+  pid = kthread_create("audio_codec", CONFIG_AUDIO_CODEC_PRIORITY,
+                       CONFIG_AUDIO_CODEC_STACKSIZE,
+                       (main_t)codec_thread, (FAR char * const *)argv);
+  if (pid < 0)
+    {
+      auderr("ERROR: Failed to start the codec thread: %d\n", (int)pid);
+
+      nxsem_destroy(&stage->wakesem);
+      nxsem_destroy(&stage->exclsem);
+      kmm_free(stage);
+      return NULL;
+    }
+
+  return &stage->export;
+}
+
+#endif /* CONFIG_AUDIO_CODEC */
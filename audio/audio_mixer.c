@@ -0,0 +1,1295 @@
+/****************************************************************************
+ * audio/audio_mixer.c
+ *
+ *   Copyright (C) 2020 Gregory Nutt. All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in
+ *    the documentation and/or other materials provided with the
+ *    distribution.
+ * 3. Neither the name NuttX nor the names of its contributors may be
+ *    used to endorse or promote products derived from this software
+ *    without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+ * FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE
+ * COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+ * INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,
+ * BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS
+ * OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED
+ * AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ * LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN
+ * ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ *
+ ****************************************************************************/
+
+/****************************************************************************
+ * Included Files
+ ****************************************************************************/
+
+#include <nuttx/config.h>
+
+#include <sys/types.h>
+#include <stdint.h>
+#include <stdbool.h>
+#include <stdio.h>
+#include <string.h>
+#include <queue.h>
+#include <assert.h>
+#include <errno.h>
+#include <debug.h>
+
+#include <nuttx/irq.h>
+#include <nuttx/kmalloc.h>
+#include <nuttx/semaphore.h>
+#include <nuttx/wqueue.h>
+#include <nuttx/audio/audio.h>
+#include <nuttx/audio/audio_mixer.h>
+
+#ifdef CONFIG_AUDIO_MIXER
+
+/****************************************************************************
+ * Pre-processor Definitions
+ ****************************************************************************/
+
+/* Mixing runs on the high priority work queue if there is one */
+
+#ifdef CONFIG_SCHED_HPWORK
+#  define MIXER_WORK          HPWORK
+#else
+#  define MIXER_WORK          LPWORK
+#endif
+
+/* The output is always 16-bit stereo at CONFIG_AUDIO_MIXER_SAMPLERATE */
+
+#define MIXER_FRAMEBYTES      4
+#define MIXER_NFRAMES         (CONFIG_AUDIO_MIXER_BUFSIZE / MIXER_FRAMEBYTES)
+
+/* Resampling positions and gains are Q16 fixed point */
+
+#define MIXER_ONE             0x10000
+
+/* The polyphase interpolation filter: MIXER_NTAPS taps for each of the
+ * (1 << MIXER_PHASESHIFT) fractional positions between two input samples.
+ */
+
+#define MIXER_NTAPS           8
+#define MIXER_PHASESHIFT      5
+#define MIXER_NPHASES         (1 << MIXER_PHASESHIFT)
+
+/* Volume changes are ramped over 10 milliseconds to avoid clicks */
+
+#define MIXER_RAMPFRAMES      (CONFIG_AUDIO_MIXER_SAMPLERATE / 100)
+
+/****************************************************************************
+ * Private Types
+ ****************************************************************************/
+
+struct audio_mixer_s;
+
+/* This structure describes one input stream of the mixer */
+
+struct mixer_input_s
+{
+  /* This is is our appearance to the outside world. This *MUST* be the
+   * first element of the structure so that we can freely cast between
+   * types struct audio_lowerhalf and struct mixer_input_s.
+   */
+
+  struct audio_lowerhalf_s export;
+
+  FAR struct audio_mixer_s *mixer; /* The mixer that we belong to */
+  struct dq_queue_s pending;       /* Buffers enqueued by the upper half */
+  FAR struct ap_buffer_s *apb;     /* The buffer being consumed */
+  bool reserved;                   /* True: The input is reserved */
+  bool running;                    /* True: The input is being mixed */
+  bool paused;                     /* True: The input is paused */
+  bool final;                      /* True: The final buffer was consumed */
+  uint8_t nchannels;               /* 1 = mono, 2 = stereo */
+  uint8_t hidx;                    /* Oldest sample in the history */
+  uint32_t step;                   /* Input samples per output frame (Q16) */
+  uint32_t frac;                   /* Position in the history (Q16) */
+  int32_t gain;                    /* Current gain (Q16) */
+  int32_t target;                  /* Gain that we are ramping to (Q16) */
+  int32_t ramp;                    /* Gain change per output frame */
+
+  /* The last MIXER_NTAPS samples of each channel.  Every sample is stored
+   * twice so that the filter window is always contiguous.
+   */
+
+  int16_t hist[2][2 * MIXER_NTAPS];
+};
+
+/* This structure describes the internal state of the mixer */
+
+struct audio_mixer_s
+{
+  FAR struct audio_lowerhalf_s *lower; /* The device that plays the mix */
+#ifdef CONFIG_AUDIO_MULTI_SESSION
+  FAR void *session;                   /* Our session with the lower half */
+#endif
+  FAR struct mixer_input_s *inputs;    /* The array of inputs */
+  int ninputs;                         /* The number of inputs */
+  sem_t exclsem;                       /* Serializes the mixer state */
+  struct work_s work;                  /* Mixing work */
+  struct dq_queue_s freeq;             /* Output buffers that we own */
+  uint8_t noutstanding;                /* Output buffers in the lower half */
+  bool allocated;                      /* True: Output buffers allocated */
+  bool started;                        /* True: The lower half is started */
+
+  /* The mix accumulator for one output buffer */
+
+  int32_t acc[2 * MIXER_NFRAMES];
+};
+
+/****************************************************************************
+ * Private Function Prototypes
+ ****************************************************************************/
+
+static int mixer_getcaps(FAR struct audio_lowerhalf_s *dev, int type,
+                         FAR struct audio_caps_s *caps);
+#ifdef CONFIG_AUDIO_MULTI_SESSION
+static int mixer_configure(FAR struct audio_lowerhalf_s *dev,
+                           FAR void *session,
+                           FAR const struct audio_caps_s *caps);
+#else
+static int mixer_configure(FAR struct audio_lowerhalf_s *dev,
+                           FAR const struct audio_caps_s *caps);
+#endif
+static int mixer_shutdown(FAR struct audio_lowerhalf_s *dev);
+#ifdef CONFIG_AUDIO_MULTI_SESSION
+static int mixer_start(FAR struct audio_lowerhalf_s *dev,
+                       FAR void *session);
+#else
+static int mixer_start(FAR struct audio_lowerhalf_s *dev);
+#endif
+#ifndef CONFIG_AUDIO_EXCLUDE_STOP
+#ifdef CONFIG_AUDIO_MULTI_SESSION
+static int mixer_stop(FAR struct audio_lowerhalf_s *dev,
+                      FAR void *session);
+#else
+static int mixer_stop(FAR struct audio_lowerhalf_s *dev);
+#endif
+#endif
+#ifndef CONFIG_AUDIO_EXCLUDE_PAUSE_RESUME
+#ifdef CONFIG_AUDIO_MULTI_SESSION
+static int mixer_pause(FAR struct audio_lowerhalf_s *dev,
+                       FAR void *session);
+static int mixer_resume(FAR struct audio_lowerhalf_s *dev,
+                        FAR void *session);
+#else
+static int mixer_pause(FAR struct audio_lowerhalf_s *dev);
+static int mixer_resume(FAR struct audio_lowerhalf_s *dev);
+#endif
+#endif
+static int mixer_enqueuebuffer(FAR struct audio_lowerhalf_s *dev,
+                               FAR struct ap_buffer_s *apb);
+static int mixer_ioctl(FAR struct audio_lowerhalf_s *dev, int cmd,
+                       unsigned long arg);
+#ifdef CONFIG_AUDIO_MULTI_SESSION
+static int mixer_reserve(FAR struct audio_lowerhalf_s *dev,
+                         FAR void **session);
+static int mixer_release(FAR struct audio_lowerhalf_s *dev,
+                         FAR void *session);
+#else
+static int mixer_reserve(FAR struct audio_lowerhalf_s *dev);
+static int mixer_release(FAR struct audio_lowerhalf_s *dev);
+#endif
+
+#ifdef CONFIG_AUDIO_MULTI_SESSION
+static void mixer_callback(FAR void *arg, uint16_t reason,
+                           FAR struct ap_buffer_s *apb, uint16_t status,
+                           FAR void *session);
+#else
+static void mixer_callback(FAR void *arg, uint16_t reason,
+                           FAR struct ap_buffer_s *apb, uint16_t status);
+#endif
+
+/****************************************************************************
+ * Private Data
+ ****************************************************************************/
+
+static const struct audio_ops_s g_mixer_ops =
+{
+  mixer_getcaps,       /* getcaps        */
+  mixer_configure,     /* configure      */
+  mixer_shutdown,      /* shutdown       */
+  mixer_start,         /* start          */
+#ifndef CONFIG_AUDIO_EXCLUDE_STOP
+  mixer_stop,          /* stop           */
+#endif
+#ifndef CONFIG_AUDIO_EXCLUDE_PAUSE_RESUME
+  mixer_pause,         /* pause          */
+  mixer_resume,        /* resume         */
+#endif
+  NULL,                /* allocbuffer    */
+  NULL,                /* freebuffer     */
+  mixer_enqueuebuffer, /* enqueue_buffer */
+  NULL,                /* cancel_buffer  */
+  mixer_ioctl,         /* ioctl          */
+  NULL,                /* read           */
+  NULL,                /* write          */
+  mixer_reserve,       /* reserve        */
+  mixer_release        /* release        */
+};
+
+/* Q15 interpolation filter: a Kaiser windowed sinc (beta 4) with its cutoff
+ * at 0.9 of the input Nyquist frequency.  Row p interpolates the point p/32
+ * of the way between taps 3 and 4; every row sums to exactly 32768.
+ */
+
+static const int16_t g_mixer_coef[MIXER_NPHASES][MIXER_NTAPS] =
+{
+  {    910,  -1928,   2869,  29284,   2869,  -1928,    910,   -218 },
+  {    817,  -1636,   2003,  29262,   3782,  -2224,   1003,   -239 },
+  {    723,  -1348,   1182,  29158,   4738,  -2518,   1093,   -260 },
+  {    629,  -1065,    408,  28974,   5731,  -2808,   1179,   -280 },
+  {    536,   -789,   -315,  28707,   6760,  -3092,   1260,   -299 },
+  {    445,   -523,   -988,  28363,   7818,  -3366,   1335,   -316 },
+  {    357,   -268,  -1607,  27937,   8904,  -3627,   1402,   -330 },
+  {    272,    -26,  -2172,  27437,  10010,  -3872,   1461,   -342 },
+  {    192,    202,  -2683,  26863,  11134,  -4098,   1509,   -351 },
+  {    116,    414,  -3139,  26219,  12268,  -4301,   1547,   -356 },
+  {     44,    610,  -3539,  25508,  13409,  -4479,   1572,   -357 },
+  {    -21,    789,  -3885,  24732,  14550,  -4627,   1584,   -354 },
+  {    -81,    949,  -4176,  23898,  15686,  -4743,   1581,   -346 },
+  {   -135,   1092,  -4415,  23009,  16811,  -4824,   1563,   -333 },
+  {   -183,   1216,  -4601,  22068,  17920,  -4866,   1529,   -315 },
+  {   -225,   1321,  -4738,  21087,  19005,  -4868,   1477,   -291 },
+  {   -261,   1408,  -4826,  20063,  20063,  -4826,   1408,   -261 },
+  {   -291,   1477,  -4868,  19005,  21087,  -4738,   1321,   -225 },
+  {   -315,   1529,  -4866,  17920,  22068,  -4601,   1216,   -183 },
+  {   -333,   1563,  -4824,  16811,  23009,  -4415,   1092,   -135 },
+  {   -346,   1581,  -4743,  15686,  23898,  -4176,    949,    -81 },
+  {   -354,   1584,  -4627,  14550,  24732,  -3885,    789,    -21 },
+  {   -357,   1572,  -4479,  13409,  25508,  -3539,    610,     44 },
+  {   -356,   1547,  -4301,  12268,  26219,  -3139,    414,    116 },
+  {   -351,   1509,  -4098,  11134,  26863,  -2683,    202,    192 },
+  {   -342,   1461,  -3872,  10010,  27437,  -2172,    -26,    272 },
+  {   -330,   1402,  -3627,   8904,  27937,  -1607,   -268,    357 },
+  {   -316,   1335,  -3366,   7818,  28363,   -988,   -523,    445 },
+  {   -299,   1260,  -3092,   6760,  28707,   -315,   -789,    536 },
+  {   -280,   1179,  -2808,   5731,  28974,    408,  -1065,    629 },
+  {   -260,   1093,  -2518,   4738,  29158,   1182,  -1348,    723 },
+  {   -239,   1003,  -2224,   3782,  29262,   2003,  -1636,    817 }
+};
+
+/****************************************************************************
+ * Private Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: mixer_fir
+ *
+ * Description:
+ *   Return the Q15 dot product of MIXER_NTAPS history samples with one
+ *   row of filter coefficients.  With the ARMv7E-M DSP extension the
+ *   taps are processed in pairs with SMLAD.
+ *
+ ****************************************************************************/
+
+static inline int32_t mixer_fir(FAR const int16_t *x, FAR const int16_t *h)
+{
+  int32_t acc = 0;
+  int i;
+
+#ifdef __ARM_FEATURE_DSP
+  uint32_t xv;
+  uint32_t hv;
+
+  for (i = 0; i < MIXER_NTAPS; i += 2)
+    {
+      memcpy(&xv, &x[i], sizeof(uint32_t));
+      memcpy(&hv, &h[i], sizeof(uint32_t));
+      __asm__ ("smlad %0, %1, %2, %0" : "+r"(acc) : "r"(xv), "r"(hv));
+    }
+#else
+  for (i = 0; i < MIXER_NTAPS; i++)
+    {
+      acc += (int32_t)x[i] * h[i];
+    }
+#endif
+
+  return acc;
+}
+
+/****************************************************************************
+ * Name: mixer_notify
+ *
+ * Description:
+ *   Report an event on one input to its upper half.
+ *
+ ****************************************************************************/
+
+static void mixer_notify(FAR struct mixer_input_s *input, uint16_t reason,
+                         FAR struct ap_buffer_s *apb, uint16_t status)
+{
+#ifdef CONFIG_AUDIO_MULTI_SESSION
+  input->export.upper(input->export.priv, reason, apb, status, input);
+#else
+  input->export.upper(input->export.priv, reason, apb, status);
+#endif
+}
+
+/****************************************************************************
+ * Name: mixer_getframe
+ *
+ * Description:
+ *   Fetch the next input frame, returning consumed buffers to the upper
+ *   half as we go.  Mono input is duplicated to both channels.  Returns
+ *   false if no data is queued.
+ *
+ ****************************************************************************/
+
+static bool mixer_getframe(FAR struct mixer_input_s *input,
+                           FAR int16_t *frame)
+{
+  FAR struct ap_buffer_s *apb = input->apb;
+  unsigned int framebytes = 2 * input->nchannels;
+  FAR const uint8_t *src;
+  irqstate_t flags;
+
+  while (apb == NULL || apb->curbyte + framebytes > apb->nbytes)
+    {
+      if (apb != NULL)
+        {
+          /* This buffer is exhausted: give it back */
+
+          if ((apb->flags & AUDIO_APB_FINAL) != 0)
+            {
+              input->final = true;
+            }
+
+          mixer_notify(input, AUDIO_CALLBACK_DEQUEUE, apb, OK);
+        }
+
+      flags = enter_critical_section();
+      apb = (FAR struct ap_buffer_s *)dq_remfirst(&input->pending);
+      leave_critical_section(flags);
+
+      input->apb = apb;
+      if (apb == NULL)
+        {
+          return false;
+        }
+    }
+
+  /* The samples are little endian 16-bit PCM */
+
+  src      = &apb->samp[apb->curbyte];
+  frame[0] = (int16_t)(src[0] | (src[1] << 8));
+  frame[1] = input->nchannels > 1 ? (int16_t)(src[2] | (src[3] << 8)) :
+             frame[0];
+
+  apb->curbyte += framebytes;
+  return true;
+}
+
+/****************************************************************************
+ * Name: mixer_resample
+ *
+ * Description:
+ *   Produce the next output frame of one input at the mixer sample rate.
+ *   Returns false if the input has run out of data.
+ *
+ ****************************************************************************/
+
+static bool mixer_resample(FAR struct mixer_input_s *input,
+                           FAR int32_t *left, FAR int32_t *right)
+{
+  FAR const int16_t *coef;
+  int16_t frame[2];
+
+  if (input->step == MIXER_ONE)
+    {
+      /* Same rate: no filtering needed */
+
+      if (!mixer_getframe(input, frame))
+        {
+          return false;
+        }
+
+      *left  = frame[0];
+      *right = frame[1];
+      return true;
+    }
+
+  /* Shift input samples into the history until the output position lies
+   * between the two middle taps.
+   */
+
+  while (input->frac >= MIXER_ONE)
+    {
+      if (!mixer_getframe(input, frame))
+        {
+          return false;
+        }
+
+      input->hist[0][input->hidx]               = frame[0];
+      input->hist[0][input->hidx + MIXER_NTAPS] = frame[0];
+      input->hist[1][input->hidx]               = frame[1];
+      input->hist[1][input->hidx + MIXER_NTAPS] = frame[1];
+      input->hidx = (input->hidx + 1) & (MIXER_NTAPS - 1);
+      input->frac -= MIXER_ONE;
+    }
+
+  coef   = g_mixer_coef[input->frac >> (16 - MIXER_PHASESHIFT)];
+  *left  = mixer_fir(&input->hist[0][input->hidx], coef) >> 15;
+  *right = mixer_fir(&input->hist[1][input->hidx], coef) >> 15;
+
+  input->frac += input->step;
+  return true;
+}
+
+/****************************************************************************
+ * Name: mixer_mixinput
+ *
+ * Description:
+ *   Add up to 'nframes' frames of one input, scaled by its (ramping) gain,
+ *   into the accumulator.  An input that runs dry contributes silence.
+ *
+ ****************************************************************************/
+
+static void mixer_mixinput(FAR struct mixer_input_s *input,
+                           FAR int32_t *acc, unsigned int nframes)
+{
+  int32_t left;
+  int32_t right;
+
+  while (nframes-- > 0 && mixer_resample(input, &left, &right))
+    {
+      if (input->gain != input->target)
+        {
+          input->gain += input->ramp;
+          if ((input->ramp > 0 && input->gain > input->target) ||
+              (input->ramp < 0 && input->gain < input->target))
+            {
+              input->gain = input->target;
+            }
+        }
+
+      *acc++ += (left * input->gain) >> 16;
+      *acc++ += (right * input->gain) >> 16;
+    }
+}
+
+/****************************************************************************
+ * Name: mixer_mix
+ *
+ * Description:
+ *   Mix one output buffer from all running inputs.  Inputs whose final
+ *   buffer has drained are completed.  Called with exclsem held.
+ *
+ ****************************************************************************/
+
+static void mixer_mix(FAR struct audio_mixer_s *mixer,
+                      FAR struct ap_buffer_s *apb)
+{
+  FAR struct mixer_input_s *input;
+  FAR int16_t *dest = (FAR int16_t *)apb->samp;
+  int32_t sample;
+  int i;
+
+  memset(mixer->acc, 0, sizeof(mixer->acc));
+
+  for (i = 0; i < mixer->ninputs; i++)
+    {
+      input = &mixer->inputs[i];
+      if (!input->running || input->paused)
+        {
+          continue;
+        }
+
+      mixer_mixinput(input, mixer->acc, MIXER_NFRAMES);
+
+      if (input->final && input->apb == NULL)
+        {
+          input->running = false;
+          input->final   = false;
+          mixer_notify(input, AUDIO_CALLBACK_COMPLETE, NULL, OK);
+        }
+    }
+
+  /* Saturate the mix to 16 bits */
+
+  for (i = 0; i < 2 * MIXER_NFRAMES; i++)
+    {
+      sample = mixer->acc[i];
+      if (sample > INT16_MAX)
+        {
+          sample = INT16_MAX;
+        }
+      else if (sample < INT16_MIN)
+        {
+          sample = INT16_MIN;
+        }
+
+      dest[i] = (int16_t)sample;
+    }
+
+  apb->nbytes  = MIXER_NFRAMES * MIXER_FRAMEBYTES;
+  apb->curbyte = 0;
+  apb->flags   = 0;
+}
+
+/****************************************************************************
+ * Name: mixer_active
+ *
+ * Description:
+ *   Return true if any input is running.
+ *
+ ****************************************************************************/
+
+static bool mixer_active(FAR struct audio_mixer_s *mixer)
+{
+  int i;
+
+  for (i = 0; i < mixer->ninputs; i++)
+    {
+      if (mixer->inputs[i].running)
+        {
+          return true;
+        }
+    }
+
+  return false;
+}
+
+/****************************************************************************
+ * Name: mixer_fill
+ *
+ * Description:
+ *   Mix into every free output buffer and hand it to the lower half.
+ *   Called with exclsem held.
+ *
+ ****************************************************************************/
+
+static void mixer_fill(FAR struct audio_mixer_s *mixer)
+{
+  FAR struct audio_lowerhalf_s *lower = mixer->lower;
+  FAR struct ap_buffer_s *apb;
+  irqstate_t flags;
+  int ret;
+
+  while (mixer_active(mixer))
+    {
+      flags = enter_critical_section();
+      apb = (FAR struct ap_buffer_s *)dq_remfirst(&mixer->freeq);
+      if (apb != NULL)
+        {
+          mixer->noutstanding++;
+        }
+
+      leave_critical_section(flags);
+
+      if (apb == NULL)
+        {
+          break;
+        }
+
+      mixer_mix(mixer, apb);
+
+#ifdef CONFIG_AUDIO_MULTI_SESSION
+      apb->session = mixer->session;
+#endif
+      ret = lower->ops->enqueuebuffer(lower, apb);
+      if (ret < 0)
+        {
+          auderr("ERROR: Failed to enqueue the mix: %d\n", ret);
+
+          flags = enter_critical_section();
+          dq_addlast(&apb->dq_entry, &mixer->freeq);
+          mixer->noutstanding--;
+          leave_critical_section(flags);
+          break;
+        }
+    }
+}
+
+/****************************************************************************
+ * Name: mixer_startoutput
+ *
+ * Description:
+ *   Reserve and configure the lower half, prime it with mixed buffers and
+ *   start it.  Called with exclsem held.
+ *
+ ****************************************************************************/
+
+static int mixer_startoutput(FAR struct audio_mixer_s *mixer)
+{
+  FAR struct audio_lowerhalf_s *lower = mixer->lower;
+  struct audio_buf_desc_s bufdesc;
+  struct audio_caps_s caps;
+  FAR struct ap_buffer_s *apb;
+  int ret;
+  int i;
+
+#ifdef CONFIG_AUDIO_MULTI_SESSION
+  ret = lower->ops->reserve(lower, &mixer->session);
+#else
+  ret = lower->ops->reserve(lower);
+#endif
+  if (ret < 0)
+    {
+      auderr("ERROR: Failed to reserve the output: %d\n", ret);
+      return ret;
+    }
+
+  memset(&caps, 0, sizeof(struct audio_caps_s));
+  caps.ac_len            = sizeof(struct audio_caps_s);
+  caps.ac_type           = AUDIO_TYPE_OUTPUT;
+  caps.ac_channels       = 2;
+  caps.ac_controls.hw[0] = CONFIG_AUDIO_MIXER_SAMPLERATE;
+  caps.ac_controls.b[2]  = 16;
+
+#ifdef CONFIG_AUDIO_MULTI_SESSION
+  ret = lower->ops->configure(lower, mixer->session, &caps);
+#else
+  ret = lower->ops->configure(lower, &caps);
+#endif
+  if (ret < 0)
+    {
+      auderr("ERROR: Failed to configure the output: %d\n", ret);
+      goto errout_with_reserve;
+    }
+
+  /* The output buffers are allocated on first use and kept */
+
+  if (!mixer->allocated)
+    {
+      for (i = 0; i < CONFIG_AUDIO_MIXER_NBUFFERS; i++)
+        {
+#ifdef CONFIG_AUDIO_MULTI_SESSION
+          bufdesc.session    = mixer->session;
+#endif
+          bufdesc.numbytes   = MIXER_NFRAMES * MIXER_FRAMEBYTES;
+          bufdesc.u.ppBuffer = &apb;
+
+          if (lower->ops->allocbuffer != NULL)
+            {
+              ret = lower->ops->allocbuffer(lower, &bufdesc);
+            }
+          else
+            {
+              ret = apb_alloc(&bufdesc);
+            }
+
+          if (ret < 0)
+            {
+              auderr("ERROR: Failed to allocate the mix buffers: %d\n",
+                     ret);
+              goto errout_with_reserve;
+            }
+
+          dq_addlast(&apb->dq_entry, &mixer->freeq);
+        }
+
+      mixer->allocated = true;
+    }
+
+  mixer_fill(mixer);
+
+#ifdef CONFIG_AUDIO_MULTI_SESSION
+  ret = lower->ops->start(lower, mixer->session);
+#else
+  ret = lower->ops->start(lower);
+#endif
+  if (ret < 0)
+    {
+      auderr("ERROR: Failed to start the output: %d\n", ret);
+      goto errout_with_reserve;
+    }
+
+  mixer->started = true;
+  return OK;
+
+errout_with_reserve:
+#ifdef CONFIG_AUDIO_MULTI_SESSION
+  lower->ops->release(lower, mixer->session);
+#else
+  lower->ops->release(lower);
+#endif
+  return ret;
+}
+
+/****************************************************************************
+ * Name: mixer_stopoutput
+ *
+ * Description:
+ *   Stop and release the lower half.  Called with exclsem held once no
+ *   input is running and all output buffers have come back.
+ *
+ ****************************************************************************/
+
+static void mixer_stopoutput(FAR struct audio_mixer_s *mixer)
+{
+  FAR struct audio_lowerhalf_s *lower = mixer->lower;
+
+#ifndef CONFIG_AUDIO_EXCLUDE_STOP
+#ifdef CONFIG_AUDIO_MULTI_SESSION
+  lower->ops->stop(lower, mixer->session);
+#else
+  lower->ops->stop(lower);
+#endif
+#endif
+
+#ifdef CONFIG_AUDIO_MULTI_SESSION
+  lower->ops->release(lower, mixer->session);
+#else
+  lower->ops->release(lower);
+#endif
+
+  mixer->started = false;
+}
+
+/****************************************************************************
+ * Name: mixer_worker
+ *
+ * Description:
+ *   Refill the output buffers returned by the lower half, and stop the
+ *   lower half once every input has finished.
+ *
+ ****************************************************************************/
+
+static void mixer_worker(FAR void *arg)
+{
+  FAR struct audio_mixer_s *mixer = (FAR struct audio_mixer_s *)arg;
+
+  nxsem_wait_uninterruptible(&mixer->exclsem);
+
+  if (mixer->started)
+    {
+      mixer_fill(mixer);
+
+      if (!mixer_active(mixer) && mixer->noutstanding == 0)
+        {
+          mixer_stopoutput(mixer);
+        }
+    }
+
+  nxsem_post(&mixer->exclsem);
+}
+
+/****************************************************************************
+ * Name: mixer_kick
+ *
+ * Description:
+ *   Schedule the mixing work if it is not already pending.
+ *
+ ****************************************************************************/
+
+static void mixer_kick(FAR struct audio_mixer_s *mixer)
+{
+  if (work_available(&mixer->work))
+    {
+      work_queue(MIXER_WORK, &mixer->work, mixer_worker, mixer, 0);
+    }
+}
+
+/****************************************************************************
+ * Name: mixer_getcaps
+ *
+ * Description: Get the capabilities of a mixer input
+ *
+ ****************************************************************************/
+
+static int mixer_getcaps(FAR struct audio_lowerhalf_s *dev, int type,
+                         FAR struct audio_caps_s *caps)
+{
+  DEBUGASSERT(caps != NULL && caps->ac_len >= sizeof(struct audio_caps_s));
+
+  caps->ac_format.hw  = 0;
+  caps->ac_controls.w = 0;
+
+  switch (caps->ac_type)
+    {
+      case AUDIO_TYPE_QUERY:
+        caps->ac_channels = 2;
+        if (caps->ac_subtype == AUDIO_TYPE_QUERY)
+          {
+            caps->ac_format.hw     = 1 << (AUDIO_FMT_PCM - 1);
+            caps->ac_controls.b[0] = AUDIO_TYPE_OUTPUT | AUDIO_TYPE_FEATURE;
+          }
+
+        break;
+
+      case AUDIO_TYPE_OUTPUT:
+        caps->ac_channels = 2;
+        if (caps->ac_subtype == AUDIO_TYPE_QUERY)
+          {
+            /* Any rate is resampled; report the common ones */
+
+            caps->ac_controls.b[0] = AUDIO_SAMP_RATE_8K |
+                                     AUDIO_SAMP_RATE_11K |
+                                     AUDIO_SAMP_RATE_16K |
+                                     AUDIO_SAMP_RATE_22K |
+                                     AUDIO_SAMP_RATE_32K |
+                                     AUDIO_SAMP_RATE_44K |
+                                     AUDIO_SAMP_RATE_48K;
+          }
+
+        break;
+
+      case AUDIO_TYPE_FEATURE:
+        if (caps->ac_subtype == AUDIO_FU_UNDEF)
+          {
+            caps->ac_controls.b[0] = AUDIO_FU_VOLUME;
+          }
+
+        break;
+
+      default:
+        caps->ac_subtype  = 0;
+        caps->ac_channels = 0;
+        break;
+    }
+
+  return caps->ac_len;
+}
+
+/****************************************************************************
+ * Name: mixer_configure
+ *
+ * Description:
+ *   Configure the format or the volume of a mixer input.
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_AUDIO_MULTI_SESSION
+static int mixer_configure(FAR struct audio_lowerhalf_s *dev,
+                           FAR void *session,
+                           FAR const struct audio_caps_s *caps)
+#else
+static int mixer_configure(FAR struct audio_lowerhalf_s *dev,
+                           FAR const struct audio_caps_s *caps)
+#endif
+{
+  FAR struct mixer_input_s *input = (FAR struct mixer_input_s *)dev;
+  uint32_t samprate;
+  int32_t ramp;
+
+  switch (caps->ac_type)
+    {
+      case AUDIO_TYPE_OUTPUT:
+        samprate = caps->ac_controls.hw[0];
+        if (caps->ac_controls.b[2] != 16 || samprate == 0 ||
+            caps->ac_channels < 1 || caps->ac_channels > 2)
+          {
+            auderr("ERROR: Unsupported format: %u ch %u bits %lu Hz\n",
+                   caps->ac_channels, caps->ac_controls.b[2],
+                   (unsigned long)samprate);
+            return -EINVAL;
+          }
+
+        input->nchannels = caps->ac_channels;
+        input->step      = (samprate << 16) /
+                           CONFIG_AUDIO_MIXER_SAMPLERATE;
+        break;
+
+      case AUDIO_TYPE_FEATURE:
+        if (caps->ac_format.hw != AUDIO_FU_VOLUME)
+          {
+            return -ENOTTY;
+          }
+
+        if (caps->ac_controls.hw[0] > 1000)
+          {
+            return -EINVAL;
+          }
+
+        input->target = ((int32_t)caps->ac_controls.hw[0] << 16) / 1000;
+
+        ramp = (input->target - input->gain) / MIXER_RAMPFRAMES;
+        if (ramp == 0)
+          {
+            ramp = input->target > input->gain ? 1 : -1;
+          }
+
+        input->ramp = ramp;
+        break;
+
+      default:
+        return -ENOTTY;
+    }
+
+  return OK;
+}
+
+/****************************************************************************
+ * Name: mixer_shutdown
+ *
+ * Description: Shutdown a mixer input
+ *
+ ****************************************************************************/
+
+static int mixer_shutdown(FAR struct audio_lowerhalf_s *dev)
+{
+  return OK;
+}
+
+/****************************************************************************
+ * Name: mixer_start
+ *
+ * Description:
+ *   Start mixing one input.  The lower half is started with the first
+ *   input.
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_AUDIO_MULTI_SESSION
+static int mixer_start(FAR struct audio_lowerhalf_s *dev, FAR void *session)
+#else
+static int mixer_start(FAR struct audio_lowerhalf_s *dev)
+#endif
+{
+  FAR struct mixer_input_s *input = (FAR struct mixer_input_s *)dev;
+  FAR struct audio_mixer_s *mixer = input->mixer;
+  int ret = OK;
+
+  if (input->nchannels == 0)
+    {
+      return -EINVAL;
+    }
+
+  nxsem_wait_uninterruptible(&mixer->exclsem);
+
+  /* Start from an empty filter history and fade in */
+
+  memset(input->hist, 0, sizeof(input->hist));
+  input->hidx  = 0;
+  input->frac  = MIXER_ONE;
+  input->final = false;
+  input->gain  = 0;
+  input->ramp  = input->target / MIXER_RAMPFRAMES;
+  if (input->ramp == 0)
+    {
+      input->ramp = 1;
+    }
+
+  input->paused  = false;
+  input->running = true;
+
+  if (!mixer->started)
+    {
+      ret = mixer_startoutput(mixer);
+      if (ret < 0)
+        {
+          input->running = false;
+        }
+    }
+
+  nxsem_post(&mixer->exclsem);
+  return ret;
+}
+
+/****************************************************************************
+ * Name: mixer_stop
+ *
+ * Description:
+ *   Stop one input and return all of its buffers.
+ *
+ ****************************************************************************/
+
+#ifndef CONFIG_AUDIO_EXCLUDE_STOP
+#ifdef CONFIG_AUDIO_MULTI_SESSION
+static int mixer_stop(FAR struct audio_lowerhalf_s *dev, FAR void *session)
+#else
+static int mixer_stop(FAR struct audio_lowerhalf_s *dev)
+#endif
+{
+  FAR struct mixer_input_s *input = (FAR struct mixer_input_s *)dev;
+  FAR struct audio_mixer_s *mixer = input->mixer;
+  FAR struct ap_buffer_s *apb;
+  irqstate_t flags;
+
+  nxsem_wait_uninterruptible(&mixer->exclsem);
+
+  input->running = false;
+  input->final   = false;
+
+  apb = input->apb;
+  input->apb = NULL;
+
+  while (apb != NULL)
+    {
+      mixer_notify(input, AUDIO_CALLBACK_DEQUEUE, apb, OK);
+
+      flags = enter_critical_section();
+      apb = (FAR struct ap_buffer_s *)dq_remfirst(&input->pending);
+      leave_critical_section(flags);
+    }
+
+  mixer_notify(input, AUDIO_CALLBACK_COMPLETE, NULL, OK);
+  nxsem_post(&mixer->exclsem);
+
+  /* Let the worker stop the lower half if this was the last input */
+
+  mixer_kick(mixer);
+  return OK;
+}
+#endif
+
+/****************************************************************************
+ * Name: mixer_pause
+ *
+ * Description: Pause one input
+ *
+ ****************************************************************************/
+
+#ifndef CONFIG_AUDIO_EXCLUDE_PAUSE_RESUME
+#ifdef CONFIG_AUDIO_MULTI_SESSION
+static int mixer_pause(FAR struct audio_lowerhalf_s *dev, FAR void *session)
+#else
+static int mixer_pause(FAR struct audio_lowerhalf_s *dev)
+#endif
+{
+  FAR struct mixer_input_s *input = (FAR struct mixer_input_s *)dev;
+
+  input->paused = true;
+  return OK;
+}
+
+/****************************************************************************
+ * Name: mixer_resume
+ *
+ * Description: Resume one input
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_AUDIO_MULTI_SESSION
+static int mixer_resume(FAR struct audio_lowerhalf_s *dev, FAR void *session)
+#else
+static int mixer_resume(FAR struct audio_lowerhalf_s *dev)
+#endif
+{
+  FAR struct mixer_input_s *input = (FAR struct mixer_input_s *)dev;
+
+  input->paused = false;
+  return OK;
+}
+#endif
+
+/****************************************************************************
+ * Name: mixer_enqueuebuffer
+ *
+ * Description: Queue a buffer of input samples
+ *
+ ****************************************************************************/
+
+static int mixer_enqueuebuffer(FAR struct audio_lowerhalf_s *dev,
+                               FAR struct ap_buffer_s *apb)
+{
+  FAR struct mixer_input_s *input = (FAR struct mixer_input_s *)dev;
+  irqstate_t flags;
+
+  apb->curbyte = 0;
+
+  flags = enter_critical_section();
+  dq_addlast(&apb->dq_entry, &input->pending);
+  leave_critical_section(flags);
+
+  return OK;
+}
+
+/****************************************************************************
+ * Name: mixer_ioctl
+ *
+ * Description: Mixer inputs have no private ioctl commands
+ *
+ ****************************************************************************/
+
+static int mixer_ioctl(FAR struct audio_lowerhalf_s *dev, int cmd,
+                       unsigned long arg)
+{
+  return -ENOTTY;
+}
+
+/****************************************************************************
+ * Name: mixer_reserve
+ *
+ * Description: Reserve a mixer input
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_AUDIO_MULTI_SESSION
+static int mixer_reserve(FAR struct audio_lowerhalf_s *dev,
+                         FAR void **session)
+#else
+static int mixer_reserve(FAR struct audio_lowerhalf_s *dev)
+#endif
+{
+  FAR struct mixer_input_s *input = (FAR struct mixer_input_s *)dev;
+  FAR struct audio_mixer_s *mixer = input->mixer;
+  int ret = OK;
+
+  nxsem_wait_uninterruptible(&mixer->exclsem);
+
+  if (input->reserved)
+    {
+      ret = -EBUSY;
+    }
+  else
+    {
+      input->reserved  = true;
+      input->nchannels = 0;
+#ifdef CONFIG_AUDIO_MULTI_SESSION
+      *session = input;
+#endif
+    }
+
+  nxsem_post(&mixer->exclsem);
+  return ret;
+}
+
+/****************************************************************************
+ * Name: mixer_release
+ *
+ * Description: Release a mixer input
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_AUDIO_MULTI_SESSION
+static int mixer_release(FAR struct audio_lowerhalf_s *dev,
+                         FAR void *session)
+#else
+static int mixer_release(FAR struct audio_lowerhalf_s *dev)
+#endif
+{
+  FAR struct mixer_input_s *input = (FAR struct mixer_input_s *)dev;
+
+  input->reserved = false;
+  return OK;
+}
+
+/****************************************************************************
+ * Name: mixer_callback
+ *
+ * Description:
+ *   Lower half callback.  Returned output buffers go back on the free
+ *   list and the worker is scheduled to refill them.
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_AUDIO_MULTI_SESSION
+static void mixer_callback(FAR void *arg, uint16_t reason,
+                           FAR struct ap_buffer_s *apb, uint16_t status,
+                           FAR void *session)
+#else
+static void mixer_callback(FAR void *arg, uint16_t reason,
+                           FAR struct ap_buffer_s *apb, uint16_t status)
+#endif
+{
+  FAR struct audio_mixer_s *mixer = (FAR struct audio_mixer_s *)arg;
+  irqstate_t flags;
+
+  switch (reason)
+    {
+      case AUDIO_CALLBACK_DEQUEUE:
+        flags = enter_critical_section();
+        dq_addlast(&apb->dq_entry, &mixer->freeq);
+        mixer->noutstanding--;
+        leave_critical_section(flags);
+
+        mixer_kick(mixer);
+        break;
+
+      case AUDIO_CALLBACK_IOERR:
+        auderr("ERROR: Output I/O error: %u\n", status);
+        break;
+
+      default:
+        break;
+    }
+}
+
+/****************************************************************************
+ * Public Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: audio_mixer_initialize
+ *
+ * Description:
+ *   Create a software mixer in front of one lower half audio device.
+ *
+ * Input Parameters:
+ *   name    - The base name of the audio devices.
+ *   ninputs - The number of mixer inputs to register.
+ *   lower   - The lower half audio device that plays the mix.
+ *
+ * Returned Value:
+ *   Zero on success; a negated errno value on failure.
+ *
+ ****************************************************************************/
+
+int audio_mixer_initialize(FAR const char *name, int ninputs,
+                           FAR struct audio_lowerhalf_s *lower)
+{
+  FAR struct audio_mixer_s *mixer;
+  char devname[32];
+  int ret;
+  int i;
+
+  DEBUGASSERT(name != NULL && ninputs > 0 && lower != NULL);
+
+  mixer = kmm_zalloc(sizeof(struct audio_mixer_s));
+  if (mixer == NULL)
+    {
+      return -ENOMEM;
+    }
+
+  mixer->inputs = kmm_zalloc(ninputs * sizeof(struct mixer_input_s));
+  if (mixer->inputs == NULL)
+    {
+      kmm_free(mixer);
+      return -ENOMEM;
+    }
+
+  mixer->lower   = lower;
+  mixer->ninputs = ninputs;
+  nxsem_init(&mixer->exclsem, 0, 1);
+
+  lower->upper = mixer_callback;
+  lower->priv  = mixer;
+
+  for (i = 0; i < ninputs; i++)
+    {
+      FAR struct mixer_input_s *input = &mixer->inputs[i];
+
+      input->export.ops = &g_mixer_ops;
+      input->mixer      = mixer;
+      input->gain       = MIXER_ONE;
+      input->target     = MIXER_ONE;
+
+      snprintf(devname, sizeof(devname), "%s%d", name, i);
+      ret = audio_register(devname, &input->export);
+      if (ret < 0)
+        {
+          auderr("ERROR: Failed to register %s: %d\n", devname, ret);
+
+          /* Inputs that are already registered stay in use */
+
+          if (i == 0)
+            {
+              nxsem_destroy(&mixer->exclsem);
+              kmm_free(mixer->inputs);
+              kmm_free(mixer);
+            }
+
+          return ret;
+        }
+    }
+
+  return OK;
+}
+
+#endif /* CONFIG_AUDIO_MIXER */
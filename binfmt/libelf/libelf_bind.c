@@ -74,15 +74,18 @@
  * Private Types
  ****************************************************************************/
 
-struct elf32_symcache_s
+/* A cache of symbol table entries with their resolved values.  The cache
+ * is direct-mapped on the symbol table index and is shared by all of the
+ * relocation sections of a module, so each symbol is normally read and
+ * looked up in the exported symbol table only once.
+ */
+
+struct elf_symcache_s
 {
-  dq_entry_t    entry;
-  Elf32_Sym     sym;
-  int           idx;
+  int           idx;             /* Symbol table index, -1 if empty */
+  Elf32_Sym     sym;             /* Symbol with the resolved st_value */
 };
 
-typedef struct elf32_symcache_s elf32_symcache_t;
-
 /****************************************************************************
  * Private Data
  ****************************************************************************/
@@ -143,22 +146,20 @@ static inline int elf_readrels(FAR struct elf_loadinfo_s *loadinfo,
  ****************************************************************************/
 
 static int elf_relocate(FAR struct elf_loadinfo_s *loadinfo, int relidx,
-                        FAR const struct symtab_s *exports, int nexports)
+                        FAR const struct symtab_s *exports, int nexports,
+                        FAR struct elf_symcache_s *symcache)
 
 {
-  FAR Elf32_Shdr       *relsec = &loadinfo->shdr[relidx];
-  FAR Elf32_Shdr       *dstsec = &loadinfo->shdr[relsec->sh_info];
-  FAR Elf32_Rel        *rels;
-  FAR Elf32_Rel        *rel;
-  FAR elf32_symcache_t *cache;
-  FAR Elf32_Sym        *sym;
-  FAR dq_entry_t       *e;
-  dq_queue_t            q;
-  uintptr_t             addr;
-  int                   symidx;
-  int                   ret;
-  int                   i;
-  int                   j;
+  FAR Elf32_Shdr            *relsec = &loadinfo->shdr[relidx];
+  FAR Elf32_Shdr            *dstsec = &loadinfo->shdr[relsec->sh_info];
+  FAR Elf32_Rel             *rels;
+  FAR Elf32_Rel             *rel;
+  FAR struct elf_symcache_s *cache;
+  FAR Elf32_Sym             *sym;
+  uintptr_t                  addr;
+  int                        symidx;
+  int                        ret;
+  int                        i;
 
   rels = kmm_malloc(CONFIG_ELF_RELOCATION_BUFFERCOUNT * sizeof(Elf32_Rel));
   if (rels == NULL)
@@ -167,8 +168,6 @@ static int elf_relocate(FAR struct elf_loadinfo_s *loadinfo, int relidx,
       return -ENOMEM;
     }
 
-  dq_init(&q);
-
   /* Examine each relocation in the section.  'relsec' is the section
    * containing the relations.  'dstsec' is the section containing the data
    * to be relocated.
@@ -176,7 +175,7 @@ static int elf_relocate(FAR struct elf_loadinfo_s *loadinfo, int relidx,
 
   ret = OK;
 
-  for (i = j = 0; i < relsec->sh_size / sizeof(Elf32_Rel); i++)
+  for (i = 0; i < relsec->sh_size / sizeof(Elf32_Rel); i++)
     {
       /* Read the relocation entry into memory */
 
@@ -200,45 +199,16 @@ static int elf_relocate(FAR struct elf_loadinfo_s *loadinfo, int relidx,
 
       symidx = ELF32_R_SYM(rel->r_info);
 
-      /* First try the cache */
-
-      sym = NULL;
-      for (e = dq_peek(&q); e; e = dq_next(e))
-        {
-          cache = (FAR elf32_symcache_t *)e;
-          if (cache->idx == symidx)
-            {
-              dq_rem(&cache->entry, &q);
-              dq_addfirst(&cache->entry, &q);
-              sym = &cache->sym;
-              break;
-            }
-        }
-
-      /* If the symbol was not found in the cache, we will need to read the
-       * symbol from the file.
+      /* First try the cache.  If the symbol is not there, we will need to
+       * read the symbol from the file and resolve its value.
        */
 
-      if (sym == NULL)
-        {
-          if (j < CONFIG_ELF_SYMBOL_CACHECOUNT)
-            {
-              cache = kmm_malloc(sizeof(elf32_symcache_t));
-              if (!cache)
-                {
-                  berr("Failed to allocate memory for elf symbols\n");
-                  ret = -ENOMEM;
-                  break;
-                }
+      cache = &symcache[symidx % CONFIG_ELF_SYMBOL_CACHECOUNT];
+      sym   = &cache->sym;
 
-              j++;
-            }
-          else
-            {
-              cache = (FAR elf32_symcache_t *)dq_remlast(&q);
-            }
-
-          sym = &cache->sym;
+      if (cache->idx != symidx)
+        {
+          cache->idx = -1;
 
           /* Read the symbol table entry into memory */
 
@@ -247,7 +217,6 @@ static int elf_relocate(FAR struct elf_loadinfo_s *loadinfo, int relidx,
             {
               berr("Section %d reloc %d: Failed to read symbol[%d]: %d\n",
                    relidx, i, symidx, ret);
-              kmm_free(cache);
               break;
             }
 
@@ -275,13 +244,11 @@ static int elf_relocate(FAR struct elf_loadinfo_s *loadinfo, int relidx,
                 {
                   berr("Section %d reloc %d: Failed to get value of symbol[%d]: %d\n",
                        relidx, i, symidx, ret);
-                  kmm_free(cache);
                   break;
                 }
             }
 
           cache->idx = symidx;
-          dq_addfirst(&cache->entry, &q);
         }
 
       if (sym->st_shndx == SHN_UNDEF && sym->st_name == 0)
@@ -312,17 +279,12 @@ static int elf_relocate(FAR struct elf_loadinfo_s *loadinfo, int relidx,
     }
 
   kmm_free(rels);
-  while ((e = dq_peek(&q)))
-    {
-      dq_rem(e, &q);
-      kmm_free(e);
-    }
-
   return ret;
 }
 
 static int elf_relocateadd(FAR struct elf_loadinfo_s *loadinfo, int relidx,
-                           FAR const struct symtab_s *exports, int nexports)
+                           FAR const struct symtab_s *exports, int nexports,
+                           FAR struct elf_symcache_s *symcache)
 {
   berr("Not implemented\n");
   return -ENOSYS;
@@ -348,6 +310,7 @@ static int elf_relocateadd(FAR struct elf_loadinfo_s *loadinfo, int relidx,
 int elf_bind(FAR struct elf_loadinfo_s *loadinfo,
              FAR const struct symtab_s *exports, int nexports)
 {
+  FAR struct elf_symcache_s *symcache;
 #ifdef CONFIG_ARCH_ADDRENV
   int status;
 #endif
@@ -373,6 +336,21 @@ int elf_bind(FAR struct elf_loadinfo_s *loadinfo,
       return ret;
     }
 
+  /* Allocate the symbol cache shared by all relocation sections */
+
+  symcache = (FAR struct elf_symcache_s *)
+    kmm_malloc(CONFIG_ELF_SYMBOL_CACHECOUNT * sizeof(struct elf_symcache_s));
+  if (symcache == NULL)
+    {
+      berr("Failed to allocate memory for elf symbols\n");
+      return -ENOMEM;
+    }
+
+  for (i = 0; i < CONFIG_ELF_SYMBOL_CACHECOUNT; i++)
+    {
+      symcache[i].idx = -1;
+    }
+
 #ifdef CONFIG_ARCH_ADDRENV
   /* If CONFIG_ARCH_ADDRENV=y, then the loaded ELF lies in a virtual address
    * space that may not be in place now.  elf_addrenv_select() will
@@ -383,6 +361,7 @@ int elf_bind(FAR struct elf_loadinfo_s *loadinfo,
   if (ret < 0)
     {
       berr("ERROR: elf_addrenv_select() failed: %d\n", ret);
+      kmm_free(symcache);
       return ret;
     }
 #endif
@@ -412,11 +391,11 @@ int elf_bind(FAR struct elf_loadinfo_s *loadinfo,
 
       if (loadinfo->shdr[i].sh_type == SHT_REL)
         {
-          ret = elf_relocate(loadinfo, i, exports, nexports);
+          ret = elf_relocate(loadinfo, i, exports, nexports, symcache);
         }
       else if (loadinfo->shdr[i].sh_type == SHT_RELA)
         {
-          ret = elf_relocateadd(loadinfo, i, exports, nexports);
+          ret = elf_relocateadd(loadinfo, i, exports, nexports, symcache);
         }
 
       if (ret < 0)
@@ -425,6 +404,8 @@ int elf_bind(FAR struct elf_loadinfo_s *loadinfo,
         }
     }
 
+  kmm_free(symcache);
+
 #if defined(CONFIG_ARCH_ADDRENV)
   /* Ensure that the I and D caches are coherent before starting the newly
    * loaded module by cleaning the D cache (i.e., flushing the D cache
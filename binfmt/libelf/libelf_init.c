@@ -40,6 +40,7 @@
 #include <nuttx/config.h>
 
 #include <sys/stat.h>
+#include <sys/ioctl.h>
 
 #include <stdint.h>
 #include <string.h>
@@ -170,6 +171,24 @@ int elf_init(FAR const char *filename, FAR struct elf_loadinfo_s *loadinfo)
       return ret;
     }
 
+#ifdef CONFIG_ELF_XIP
+  /* If the file system can map the file into memory, then the ELF file can
+   * be read and its read-only sections used in place.  Failure is not an
+   * error; the file will then be read normally.
+   */
+
+  ret = ioctl(loadinfo->filfd, FIOC_MMAP,
+              (unsigned long)((uintptr_t)&loadinfo->xipbase));
+  if (ret < 0)
+    {
+      loadinfo->xipbase = NULL;
+    }
+  else
+    {
+      binfo("ELF file mapped at %p\n", loadinfo->xipbase);
+    }
+#endif
+
   /* Read the ELF ehdr from offset 0 */
 
   ret = elf_read(loadinfo, (FAR uint8_t *)&loadinfo->ehdr,
@@ -42,6 +42,7 @@
 #include <sys/types.h>
 
 #include <stdint.h>
+#include <stdbool.h>
 #include <stdlib.h>
 #include <string.h>
 #include <unistd.h>
@@ -80,6 +81,57 @@
  * Private Functions
  ****************************************************************************/
 
+/****************************************************************************
+ * Name: elf_xipsection
+ *
+ * Description:
+ *   Return true if section 'shndx' can be used in place in the memory
+ *   mapped ELF file:  The section must be read-only, have data in the file,
+ *   be suitably aligned in the mapping, and need no relocations.
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_ELF_XIP
+static bool elf_xipsection(FAR struct elf_loadinfo_s *loadinfo, int shndx)
+{
+  FAR Elf32_Shdr *shdr = &loadinfo->shdr[shndx];
+  uintptr_t addr;
+  int i;
+
+  if (loadinfo->xipbase == NULL ||
+      (shdr->sh_flags & (SHF_ALLOC | SHF_WRITE)) != SHF_ALLOC ||
+      shdr->sh_type == SHT_NOBITS)
+    {
+      return false;
+    }
+
+  addr = (uintptr_t)loadinfo->xipbase + shdr->sh_offset;
+  if (shdr->sh_addralign > 1 && (addr & (shdr->sh_addralign - 1)) != 0)
+    {
+      return false;
+    }
+
+  /* A section that is the target of relocations must be copied so that the
+   * relocations can be applied.
+   */
+
+  for (i = 0; i < loadinfo->ehdr.e_shnum; i++)
+    {
+      FAR Elf32_Shdr *relsec = &loadinfo->shdr[i];
+
+      if ((relsec->sh_type == SHT_REL || relsec->sh_type == SHT_RELA) &&
+          relsec->sh_info == shndx)
+        {
+          return false;
+        }
+    }
+
+  return true;
+}
+#else
+#  define elf_xipsection(l,i) false
+#endif
+
 /****************************************************************************
  * Name: elf_elfsize
  *
@@ -114,10 +166,15 @@ static void elf_elfsize(struct elf_loadinfo_s *loadinfo)
       if ((shdr->sh_flags & SHF_ALLOC) != 0)
         {
           /* SHF_WRITE indicates that the section address space is write-
-           * able
+           * able.  Read-only sections that are executed in place need no
+           * memory at all.
            */
 
-          if ((shdr->sh_flags & SHF_WRITE) != 0)
+          if (elf_xipsection(loadinfo, i))
+            {
+              continue;
+            }
+          else if ((shdr->sh_flags & SHF_WRITE) != 0)
             {
               datasize += ELF_ALIGNUP(shdr->sh_size);
             }
@@ -186,6 +243,20 @@ static inline int elf_loadfile(FAR struct elf_loadinfo_s *loadinfo)
           pptr = &text;
         }
 
+#ifdef CONFIG_ELF_XIP
+      /* Sections that are executed in place are just pointed at */
+
+      if (elf_xipsection(loadinfo, i))
+        {
+          binfo("%d. %08lx->%08lx (XIP)\n", i,
+                (unsigned long)shdr->sh_addr,
+                (unsigned long)(loadinfo->xipbase + shdr->sh_offset));
+
+          shdr->sh_addr = (uintptr_t)(loadinfo->xipbase + shdr->sh_offset);
+          continue;
+        }
+#endif
+
       /* SHT_NOBITS indicates that there is no data in the file for the
        * section.
        */
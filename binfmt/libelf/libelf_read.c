@@ -46,6 +46,7 @@
 #include <debug.h>
 #include <errno.h>
 
+#include <nuttx/kmalloc.h>
 #include <nuttx/fs/fs.h>
 #include <nuttx/binfmt/elf.h>
 
@@ -90,33 +91,19 @@ static inline void elf_dumpreaddata(FAR char *buffer, int buflen)
 #endif
 
 /****************************************************************************
- * Public Functions
- ****************************************************************************/
-
-/****************************************************************************
- * Name: elf_read
+ * Name: elf_fileread
  *
  * Description:
- *   Read 'readsize' bytes from the object file at 'offset'.  The data is
- *   read into 'buffer.' If 'buffer' is part of the ELF address environment,
- *   then the caller is responsibile for assuring that that address
- *   environment is in place before calling this function (i.e., that
- *   elf_addrenv_select() has been called if CONFIG_ARCH_ADDRENV=y).
- *
- * Returned Value:
- *   0 (OK) is returned on success and a negated errno is returned on
- *   failure.
+ *   Read 'readsize' bytes from the object file at 'offset' into 'buffer'.
  *
  ****************************************************************************/
 
-int elf_read(FAR struct elf_loadinfo_s *loadinfo, FAR uint8_t *buffer,
-             size_t readsize, off_t offset)
+static int elf_fileread(FAR struct elf_loadinfo_s *loadinfo,
+                        FAR uint8_t *buffer, size_t readsize, off_t offset)
 {
   ssize_t nbytes;      /* Number of bytes read */
   off_t   rpos;        /* Position returned by lseek */
 
-  binfo("Read %ld bytes from offset %ld\n", (long)readsize, (long)offset);
-
   /* Loop until all of the requested data has been read. */
 
   while (readsize > 0)
@@ -159,6 +146,135 @@ int elf_read(FAR struct elf_loadinfo_s *loadinfo, FAR uint8_t *buffer,
         }
     }
 
-  elf_dumpreaddata(buffer, readsize);
   return OK;
 }
+
+/****************************************************************************
+ * Name: elf_cacheread
+ *
+ * Description:
+ *   Serve a small read from the read cache, refilling the cache from the
+ *   file at 'offset' if the requested data is not already cached.
+ *
+ ****************************************************************************/
+
+#if CONFIG_ELF_READCACHE_SIZE > 0
+static int elf_cacheread(FAR struct elf_loadinfo_s *loadinfo,
+                         FAR uint8_t *buffer, size_t readsize, off_t offset)
+{
+  size_t cachelen;
+  int ret;
+
+  if (offset < loadinfo->rdcachepos ||
+      offset + readsize > loadinfo->rdcachepos + loadinfo->rdcachelen)
+    {
+      /* Allocate the cache on first use */
+
+      if (loadinfo->rdcache == NULL)
+        {
+          loadinfo->rdcache = (FAR uint8_t *)
+            kmm_malloc(CONFIG_ELF_READCACHE_SIZE);
+          if (loadinfo->rdcache == NULL)
+            {
+              return elf_fileread(loadinfo, buffer, readsize, offset);
+            }
+        }
+
+      /* Refill the cache with as much of the file as fits */
+
+      if (offset + readsize > loadinfo->filelen)
+        {
+          berr("Unexpected end of file\n");
+          return -ENODATA;
+        }
+
+      cachelen = loadinfo->filelen - offset;
+      if (cachelen > CONFIG_ELF_READCACHE_SIZE)
+        {
+          cachelen = CONFIG_ELF_READCACHE_SIZE;
+        }
+
+      loadinfo->rdcachelen = 0;
+      ret = elf_fileread(loadinfo, loadinfo->rdcache, cachelen, offset);
+      if (ret < 0)
+        {
+          return ret;
+        }
+
+      loadinfo->rdcachepos = offset;
+      loadinfo->rdcachelen = cachelen;
+    }
+
+  memcpy(buffer, &loadinfo->rdcache[offset - loadinfo->rdcachepos],
+         readsize);
+  return OK;
+}
+#endif
+
+/****************************************************************************
+ * Public Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: elf_read
+ *
+ * Description:
+ *   Read 'readsize' bytes from the object file at 'offset'.  The data is
+ *   read into 'buffer.' If 'buffer' is part of the ELF address environment,
+ *   then the caller is responsibile for assuring that that address
+ *   environment is in place before calling this function (i.e., that
+ *   elf_addrenv_select() has been called if CONFIG_ARCH_ADDRENV=y).
+ *
+ *   Small reads are served from a read cache and, if the file is mapped
+ *   into memory, all reads are simple copies from the mapping.
+ *
+ * Returned Value:
+ *   0 (OK) is returned on success and a negated errno is returned on
+ *   failure.
+ *
+ ****************************************************************************/
+
+int elf_read(FAR struct elf_loadinfo_s *loadinfo, FAR uint8_t *buffer,
+             size_t readsize, off_t offset)
+{
+  int ret;
+
+  binfo("Read %ld bytes from offset %ld\n", (long)readsize, (long)offset);
+
+#ifdef CONFIG_ELF_XIP
+  /* If the file is mapped into memory, just copy the data */
+
+  if (loadinfo->xipbase != NULL)
+    {
+      if (offset < 0 || offset + readsize > loadinfo->filelen)
+        {
+          berr("Unexpected end of file\n");
+          return -ENODATA;
+        }
+
+      memcpy(buffer, loadinfo->xipbase + offset, readsize);
+      elf_dumpreaddata(buffer, readsize);
+      return OK;
+    }
+#endif
+
+#if CONFIG_ELF_READCACHE_SIZE > 0
+  /* Small reads go through the read cache */
+
+  if (readsize < CONFIG_ELF_READCACHE_SIZE)
+    {
+      ret = elf_cacheread(loadinfo, buffer, readsize, offset);
+    }
+  else
+#endif
+    {
+      ret = elf_fileread(loadinfo, buffer, readsize, offset);
+    }
+
+  if (ret >= 0)
+    {
+      elf_dumpreaddata(buffer, readsize);
+    }
+
+  return ret;
+}
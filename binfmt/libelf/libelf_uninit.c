@@ -122,5 +122,14 @@ int elf_freebuffers(struct elf_loadinfo_s *loadinfo)
       loadinfo->buflen    = 0;
     }
 
+#if CONFIG_ELF_READCACHE_SIZE > 0
+  if (loadinfo->rdcache)
+    {
+      kmm_free((FAR void *)loadinfo->rdcache);
+      loadinfo->rdcache    = NULL;
+      loadinfo->rdcachelen = 0;
+    }
+#endif
+
   return OK;
 }
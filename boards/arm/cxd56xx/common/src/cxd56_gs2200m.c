@@ -126,7 +126,7 @@ static int gs2200m_irq_attach(xcpt_t handler, FAR void *arg)
 
 static void gs2200m_irq_enable(void)
 {
-  irqstate_t flags = spin_lock_irqsave();
+  irqstate_t flags = spin_lock_irqsave(NULL);
 
   wlinfo("== ec:%d called=%d \n", _enable_count, _n_called++);
 
@@ -144,7 +144,7 @@ static void gs2200m_irq_enable(void)
       cxd56_gpioint_enable(GS2200M_GPIO_37);
     }
 
-  spin_unlock_irqrestore(flags);
+  spin_unlock_irqrestore(NULL, flags);
 }
 
 /****************************************************************************
@@ -153,7 +153,7 @@ static void gs2200m_irq_enable(void)
 
 static void gs2200m_irq_disable(void)
 {
-  irqstate_t flags = spin_lock_irqsave();
+  irqstate_t flags = spin_lock_irqsave(NULL);
 
   wlinfo("== ec:%d called=%d \n", _enable_count, _n_called++);
 
@@ -164,7 +164,7 @@ static void gs2200m_irq_disable(void)
       cxd56_gpioint_disable(GS2200M_GPIO_37);
     }
 
-  spin_unlock_irqrestore(flags);
+  spin_unlock_irqrestore(NULL, flags);
 }
 
 /****************************************************************************
@@ -173,7 +173,7 @@ static void gs2200m_irq_disable(void)
 
 static uint32_t gs2200m_dready(int *ec)
 {
-  irqstate_t flags = spin_lock_irqsave();
+  irqstate_t flags = spin_lock_irqsave(NULL);
 
   uint32_t r = cxd56_gpio_read(GS2200M_GPIO_37);
 
@@ -184,7 +184,7 @@ static uint32_t gs2200m_dready(int *ec)
       *ec = _enable_count;
     }
 
-  spin_unlock_irqrestore(flags);
+  spin_unlock_irqrestore(NULL, flags);
   return r;
 }
 
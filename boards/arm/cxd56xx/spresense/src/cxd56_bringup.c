@@ -48,6 +48,7 @@
 #include <nuttx/arch.h>
 #include <nuttx/board.h>
 #include <nuttx/board.h>
+#include <nuttx/init.h>
 #include <arch/board/board.h>
 
 #ifdef CONFIG_RNDIS
@@ -72,6 +73,10 @@
 #  include "cxd56_powermgr_procfs.h"
 #endif
 
+#ifdef CONFIG_CXD56_DVFS
+#  include "cxd56_dvfs.h"
+#endif
+
 #ifdef CONFIG_TIMER
 #  include "cxd56_timer.h"
 #endif
@@ -151,6 +156,110 @@
  #endif
 #endif
 
+/* Initializers that wait for firmware downloads or device probing and do
+ * not depend on each other are run with boot_initcalls(), in parallel if
+ * CONFIG_BOOT_INIT_NTHREADS > 0.
+ */
+
+#if defined(CONFIG_WL_GS2200M) || defined(CONFIG_NET_WIZNET) || \
+    defined(CONFIG_CXD56_GNSS) || defined(CONFIG_CXD56_GEOFENCE) || \
+    defined(CONFIG_SENSORS)
+#  define HAVE_INITCALLS 1
+#endif
+
+/****************************************************************************
+ * Private Types
+ ****************************************************************************/
+
+#ifdef HAVE_INITCALLS
+enum cxd56_initcall_e
+{
+#ifdef CONFIG_WL_GS2200M
+  CXD56_INITCALL_GS2200M,
+#endif
+#ifdef CONFIG_NET_WIZNET
+  CXD56_INITCALL_WIZNET,
+#endif
+#ifdef CONFIG_CXD56_GNSS
+  CXD56_INITCALL_GNSS,
+#endif
+#ifdef CONFIG_CXD56_GEOFENCE
+  CXD56_INITCALL_GEOFENCE,
+#endif
+#ifdef CONFIG_SENSORS
+  CXD56_INITCALL_SENSORS,
+#endif
+  CXD56_NINITCALLS
+};
+#endif
+
+/****************************************************************************
+ * Private Function Prototypes
+ ****************************************************************************/
+
+#ifdef CONFIG_WL_GS2200M
+static int spresense_gs2200m_init(void);
+#endif
+#ifdef CONFIG_NET_WIZNET
+static int spresense_wiznet_init(void);
+#endif
+#ifdef CONFIG_CXD56_GNSS
+static int spresense_gnss_init(void);
+#endif
+#ifdef CONFIG_CXD56_GEOFENCE
+static int spresense_geofence_init(void);
+#endif
+#ifdef CONFIG_SENSORS
+static int spresense_sensors_init(void);
+#endif
+
+/****************************************************************************
+ * Private Data
+ ****************************************************************************/
+
+#ifdef HAVE_INITCALLS
+static const struct boot_initcall_s g_initcalls[CXD56_NINITCALLS] =
+{
+#ifdef CONFIG_WL_GS2200M
+  [CXD56_INITCALL_GS2200M] =
+  {
+    "gs2200m", spresense_gs2200m_init, 0
+  },
+#endif
+#ifdef CONFIG_NET_WIZNET
+  [CXD56_INITCALL_WIZNET] =
+  {
+    "wiznet", spresense_wiznet_init, 0
+  },
+#endif
+#ifdef CONFIG_CXD56_GNSS
+  [CXD56_INITCALL_GNSS] =
+  {
+    "gnss", spresense_gnss_init, 0
+  },
+#endif
+#ifdef CONFIG_CXD56_GEOFENCE
+  /* The geofence runs on the GNSS core */
+
+  [CXD56_INITCALL_GEOFENCE] =
+  {
+    "geofence", spresense_geofence_init,
+#ifdef CONFIG_CXD56_GNSS
+    BOOT_INITCALL_DEP(CXD56_INITCALL_GNSS)
+#else
+    0
+#endif
+  },
+#endif
+#ifdef CONFIG_SENSORS
+  [CXD56_INITCALL_SENSORS] =
+  {
+    "sensors", spresense_sensors_init, 0
+  },
+#endif
+};
+#endif
+
 /****************************************************************************
  * Private Functions
  ****************************************************************************/
@@ -177,6 +286,81 @@ static int nsh_cpucom_initialize(void)
 #  define nsh_cpucom_initialize() (OK)
 #endif
 
+#ifdef CONFIG_WL_GS2200M
+static int spresense_gs2200m_init(void)
+{
+  int ret;
+
+  ret = board_gs2200m_initialize("/dev/gs2200m", 5);
+  if (ret < 0)
+    {
+      _err("ERROR: Failed to initialize GS2200M. \n");
+    }
+
+  return ret;
+}
+#endif
+
+#ifdef CONFIG_NET_WIZNET
+static int spresense_wiznet_init(void)
+{
+  int ret;
+
+  ret = board_wiznet_initialize("/dev/wiznet");
+  if (ret < 0)
+    {
+      _err("ERROR: Failed to initialize W5x00. \n");
+    }
+
+  return ret;
+}
+#endif
+
+#ifdef CONFIG_CXD56_GNSS
+static int spresense_gnss_init(void)
+{
+  int ret;
+
+  ret = cxd56_gnssinitialize("/dev/gps");
+  if (ret < 0)
+    {
+      _err("ERROR: Failed to initialize gnss. \n");
+    }
+
+  return ret;
+}
+#endif
+
+#ifdef CONFIG_CXD56_GEOFENCE
+static int spresense_geofence_init(void)
+{
+  int ret;
+
+  ret = cxd56_geofenceinitialize("/dev/geofence");
+  if (ret < 0)
+    {
+      _err("ERROR: Failed to initialize geofence. \n");
+    }
+
+  return ret;
+}
+#endif
+
+#ifdef CONFIG_SENSORS
+static int spresense_sensors_init(void)
+{
+  int ret;
+
+  ret = board_sensors_initialize();
+  if (ret < 0)
+    {
+      _err("ERROR: Failed to initialize sensors.\n");
+    }
+
+  return ret;
+}
+#endif
+
 #ifdef CONFIG_TIMER
 static void timer_initialize(void)
 {
@@ -442,6 +626,14 @@ int cxd56_bringup(void)
   board_clock_enable();
 #endif
 
+#ifdef CONFIG_CXD56_DVFS
+  ret = cxd56_dvfs_initialize();
+  if (ret < 0)
+    {
+      _err("ERROR: Failed to start DVFS governor.\n");
+    }
+#endif
+
   up_pm_release_wakelock(&wlock);
 
 #if defined(CONFIG_RNDIS)
@@ -455,44 +647,10 @@ int cxd56_bringup(void)
   usbdev_rndis_initialize(mac);
 #endif
 
-#ifdef CONFIG_WL_GS2200M
-  ret = board_gs2200m_initialize("/dev/gs2200m", 5);
-  if (ret < 0)
-    {
-      _err("ERROR: Failed to initialize GS2200M. \n");
-    }
-#endif
+#ifdef HAVE_INITCALLS
+  /* Network interfaces, GNSS firmware and sensor probing */
 
-#ifdef CONFIG_NET_WIZNET
-  ret = board_wiznet_initialize("/dev/wiznet");
-  if (ret < 0)
-    {
-      _err("ERROR: Failed to initialize W5x00. \n");
-    }
-#endif
-
-#ifdef CONFIG_CXD56_GNSS
-  ret = cxd56_gnssinitialize("/dev/gps");
-  if (ret < 0)
-    {
-      _err("ERROR: Failed to initialize gnss. \n");
-    }
-#endif
-
-#ifdef CONFIG_CXD56_GEOFENCE
-  ret = cxd56_geofenceinitialize("/dev/geofence");
-  if (ret < 0)
-    {
-      _err("ERROR: Failed to initialize geofence. \n");
-    }
-#endif
-
-#ifdef CONFIG_SENSORS
-  ret = board_sensors_initialize();
-  if (ret < 0)
-    {
-      _err("ERROR: Failed to initialize sensors.\n");
-    }
+  boot_initcalls(g_initcalls, CXD56_NINITCALLS);
 #endif
 
 #ifdef CONFIG_VIDEO_FB
@@ -79,9 +79,21 @@ static int pwm_initialize(uint32_t channel)
       return -ENODEV;
     }
 
-  /* Register the PWM driver at "/dev/pwmX" */
+  /* Register the PWM driver at "/dev/pwmX", or at "/dev/pwm" for the
+   * device that drives all of the channels together.
+   */
+
+#ifdef CONFIG_PWM_MULTICHAN
+  if (channel == CXD56_PWM_CHMULTI)
+    {
+      snprintf(devname, sizeof(devname), "/dev/pwm");
+    }
+  else
+#endif
+    {
+      snprintf(devname, sizeof(devname), "/dev/pwm%d", channel);
+    }
 
-  snprintf(devname, sizeof(devname), "/dev/pwm%d", channel);
   ret = pwm_register(devname, pwm);
   if (ret < 0)
     {
@@ -130,6 +142,10 @@ int board_pwm_setup(void)
       pwm_initialize(CXD56_PWM_CH3);
 #endif
 
+#ifdef CONFIG_PWM_MULTICHAN
+      pwm_initialize(CXD56_PWM_CHMULTI);
+#endif
+
       /* Now we are initialized */
 
       initialized = true;
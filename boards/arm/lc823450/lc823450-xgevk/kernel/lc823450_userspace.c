@@ -44,6 +44,7 @@
 #include <stdlib.h>
 
 #include <nuttx/arch.h>
+#include <nuttx/clock.h>
 #include <nuttx/mm/mm.h>
 #include <nuttx/wqueue.h>
 #include <nuttx/userspace.h>
@@ -125,6 +126,12 @@ const struct userspace_s userspace __attribute__ ((section (".userspace"))) =
 #ifdef CONFIG_LIB_USRWORK
   .work_usrstart    = work_usrstart,
 #endif
+
+  /* Time page read by clock_gettime() (declared in include/nuttx/clock.h) */
+
+#ifdef CONFIG_CLOCK_TIMEPAGE
+  .us_timepage      = &g_clock_timepage,
+#endif
 };
 
 /****************************************************************************
@@ -43,6 +43,7 @@
 
 #include <nuttx/userspace.h>
 #include <nuttx/wqueue.h>
+#include <nuttx/clock.h>
 #include <nuttx/mm/mm.h>
 
 #if defined(CONFIG_BUILD_PROTECTED) && !defined(__KERNEL__)
@@ -124,6 +125,12 @@ const struct userspace_s userspace __attribute__ ((section (".userspace"))) =
 #ifdef CONFIG_LIB_USRWORK
   .work_usrstart    = work_usrstart,
 #endif
+
+  /* Time page read by clock_gettime() (declared in include/nuttx/clock.h) */
+
+#ifdef CONFIG_CLOCK_TIMEPAGE
+  .us_timepage      = &g_clock_timepage,
+#endif
 };
 
 /****************************************************************************
@@ -119,7 +119,7 @@ int board_button_irq(int id, xcpt_t irqhandler, FAR void *arg)
        * following operations are atomic.
        */
 
-      flags = spin_lock_irqsave();
+      flags = spin_lock_irqsave(NULL);
 
       /* Are we attaching or detaching? */
 
@@ -138,7 +138,7 @@ int board_button_irq(int id, xcpt_t irqhandler, FAR void *arg)
           irq_detach(BUTTON_IRQ);
         }
 
-      spin_unlock_irqrestore(flags);
+      spin_unlock_irqrestore(NULL, flags);
       ret = OK;
     }
 
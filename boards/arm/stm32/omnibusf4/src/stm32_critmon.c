@@ -49,7 +49,8 @@
 
 #include <arch/board/board.h>
 
-#ifdef CONFIG_SCHED_CRITMONITOR
+#if defined(CONFIG_SCHED_CRITMONITOR) || \
+    defined(CONFIG_SCHED_IRQMONITOR_TIMING)
 
 /****************************************************************************
  * Public Functions
@@ -77,4 +78,4 @@ void up_critmon_convert(uint32_t elapsed, FAR struct timespec *ts)
   ts->tv_nsec = NSEC_PER_SEC * b32frac(b32elapsed) / b32ONE;
 }
 
-#endif /* CONFIG_SCHED_CRITMONITOR */
+#endif /* CONFIG_SCHED_CRITMONITOR || CONFIG_SCHED_IRQMONITOR_TIMING */
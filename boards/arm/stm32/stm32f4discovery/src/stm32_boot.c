@@ -68,7 +68,8 @@
 
 void stm32_boardinitialize(void)
 {
-#ifdef CONFIG_SCHED_CRITMONITOR
+#if defined(CONFIG_SCHED_CRITMONITOR) || \
+    defined(CONFIG_SCHED_IRQMONITOR_TIMING)
   /* Enable ITM and DWT resources, if not left enabled by debugger. */
 
   modifyreg32(NVIC_DEMCR, 0, NVIC_DEMCR_TRCENA);
@@ -51,6 +51,7 @@
 #include <nuttx/fs/nxffs.h>
 #include <nuttx/video/fb.h>
 #include <nuttx/timers/oneshot.h>
+#include <nuttx/timers/hrtimer.h>
 #include <nuttx/wireless/pktradio.h>
 #include <nuttx/wireless/bluetooth/bt_driver.h>
 #include <nuttx/wireless/bluetooth/bt_null.h>
@@ -220,6 +221,15 @@ int sim_bringup(void)
 
       sched_oneshot_extclk(oneshot);
 
+#elif defined(CONFIG_HRTIMER)
+      /* Multiplex the high resolution timers over the oneshot timer */
+
+      ret = hrtimer_initialize(oneshot);
+      if (ret < 0)
+        {
+          syslog(LOG_ERR, "ERROR: hrtimer_initialize failed: %d\n", ret);
+        }
+
 #else
       /* Initialize the simulated oneshot driver */
 
@@ -41,500 +41,844 @@
 #include <nuttx/config.h>
 
 #include <stdint.h>
+#include <string.h>
 #include <errno.h>
 
+#include <nuttx/compiler.h>
+#include <nuttx/semaphore.h>
+#include <nuttx/crypto/crypto.h>
 #include <nuttx/crypto/aes.h>
 
+/****************************************************************************
+ * Pre-processor Definitions
+ ****************************************************************************/
+
+/* The state and the round keys are handled as 32-bit little-endian column
+ * words:  Byte 0 of a word is row 0 of the column.
+ */
+
+#define ROTL8(x)  (((x) << 8)  | ((x) >> 24))
+#define ROTL16(x) (((x) << 16) | ((x) >> 16))
+#define ROTL24(x) (((x) << 24) | ((x) >> 8))
+
+#define GETU32(p) \
+  ((uint32_t)(p)[0] | ((uint32_t)(p)[1] << 8) | \
+   ((uint32_t)(p)[2] << 16) | ((uint32_t)(p)[3] << 24))
+
+#define PUTU32(p, v) \
+  do \
+    { \
+      (p)[0] = (uint8_t)(v); \
+      (p)[1] = (uint8_t)((v) >> 8); \
+      (p)[2] = (uint8_t)((v) >> 16); \
+      (p)[3] = (uint8_t)((v) >> 24); \
+    } \
+  while (0)
+
+#ifndef CONFIG_CRYPTO_SW_AES_CONSTTIME
+/* One round of the table driven cipher for one output column */
+
+#  define TE_ROUND(a, b, c, d, k) \
+  (g_te[(a) & 0xff] ^ ROTL8(g_te[((b) >> 8) & 0xff]) ^ \
+   ROTL16(g_te[((c) >> 16) & 0xff]) ^ ROTL24(g_te[(d) >> 24]) ^ (k))
+
+#  define TD_ROUND(a, b, c, d, k) \
+  (g_td[(a) & 0xff] ^ ROTL8(g_td[((b) >> 8) & 0xff]) ^ \
+   ROTL16(g_td[((c) >> 16) & 0xff]) ^ ROTL24(g_td[(d) >> 24]) ^ (k))
+
+/* The last round (no MixColumns) for one output column */
+
+#  define TE_FINAL(a, b, c, d, k) \
+  ((uint32_t)g_sbox[(a) & 0xff] ^ \
+   ((uint32_t)g_sbox[((b) >> 8) & 0xff] << 8) ^ \
+   ((uint32_t)g_sbox[((c) >> 16) & 0xff] << 16) ^ \
+   ((uint32_t)g_sbox[(d) >> 24] << 24) ^ (k))
+
+#  define TD_FINAL(a, b, c, d, k) \
+  ((uint32_t)g_rsbox[(a) & 0xff] ^ \
+   ((uint32_t)g_rsbox[((b) >> 8) & 0xff] << 8) ^ \
+   ((uint32_t)g_rsbox[((c) >> 16) & 0xff] << 16) ^ \
+   ((uint32_t)g_rsbox[(d) >> 24] << 24) ^ (k))
+#endif
+
 /****************************************************************************
  * Private Data
  ****************************************************************************/
 
+/* Round constants of the key expansion */
+
+static const uint8_t g_rcon[10] =
+{
+  0x01, 0x02, 0x04, 0x08, 0x10, 0x20, 0x40, 0x80, 0x1b, 0x36
+};
+
+#ifndef CONFIG_CRYPTO_SW_AES_CONSTTIME
 /* Forward sbox */
 
 static const uint8_t g_sbox[256] =
 {
-/*  0     1    2      3     4    5     6     7      8    9     A      B    C     D     E     F */
-  0x63, 0x7c, 0x77, 0x7b, 0xf2, 0x6b, 0x6f, 0xc5, 0x30, 0x01, 0x67, 0x2b, 0xfe, 0xd7, 0xab, 0x76, /* 0 */
-  0xca, 0x82, 0xc9, 0x7d, 0xfa, 0x59, 0x47, 0xf0, 0xad, 0xd4, 0xa2, 0xaf, 0x9c, 0xa4, 0x72, 0xc0, /* 1 */
-  0xb7, 0xfd, 0x93, 0x26, 0x36, 0x3f, 0xf7, 0xcc, 0x34, 0xa5, 0xe5, 0xf1, 0x71, 0xd8, 0x31, 0x15, /* 2 */
-  0x04, 0xc7, 0x23, 0xc3, 0x18, 0x96, 0x05, 0x9a, 0x07, 0x12, 0x80, 0xe2, 0xeb, 0x27, 0xb2, 0x75, /* 3 */
-  0x09, 0x83, 0x2c, 0x1a, 0x1b, 0x6e, 0x5a, 0xa0, 0x52, 0x3b, 0xd6, 0xb3, 0x29, 0xe3, 0x2f, 0x84, /* 4 */
-  0x53, 0xd1, 0x00, 0xed, 0x20, 0xfc, 0xb1, 0x5b, 0x6a, 0xcb, 0xbe, 0x39, 0x4a, 0x4c, 0x58, 0xcf, /* 5 */
-  0xd0, 0xef, 0xaa, 0xfb, 0x43, 0x4d, 0x33, 0x85, 0x45, 0xf9, 0x02, 0x7f, 0x50, 0x3c, 0x9f, 0xa8, /* 6 */
-  0x51, 0xa3, 0x40, 0x8f, 0x92, 0x9d, 0x38, 0xf5, 0xbc, 0xb6, 0xda, 0x21, 0x10, 0xff, 0xf3, 0xd2, /* 7 */
-  0xcd, 0x0c, 0x13, 0xec, 0x5f, 0x97, 0x44, 0x17, 0xc4, 0xa7, 0x7e, 0x3d, 0x64, 0x5d, 0x19, 0x73, /* 8 */
-  0x60, 0x81, 0x4f, 0xdc, 0x22, 0x2a, 0x90, 0x88, 0x46, 0xee, 0xb8, 0x14, 0xde, 0x5e, 0x0b, 0xdb, /* 9 */
-  0xe0, 0x32, 0x3a, 0x0a, 0x49, 0x06, 0x24, 0x5c, 0xc2, 0xd3, 0xac, 0x62, 0x91, 0x95, 0xe4, 0x79, /* A */
-  0xe7, 0xc8, 0x37, 0x6d, 0x8d, 0xd5, 0x4e, 0xa9, 0x6c, 0x56, 0xf4, 0xea, 0x65, 0x7a, 0xae, 0x08, /* B */
-  0xba, 0x78, 0x25, 0x2e, 0x1c, 0xa6, 0xb4, 0xc6, 0xe8, 0xdd, 0x74, 0x1f, 0x4b, 0xbd, 0x8b, 0x8a, /* C */
-  0x70, 0x3e, 0xb5, 0x66, 0x48, 0x03, 0xf6, 0x0e, 0x61, 0x35, 0x57, 0xb9, 0x86, 0xc1, 0x1d, 0x9e, /* D */
-  0xe1, 0xf8, 0x98, 0x11, 0x69, 0xd9, 0x8e, 0x94, 0x9b, 0x1e, 0x87, 0xe9, 0xce, 0x55, 0x28, 0xdf, /* E */
-  0x8c, 0xa1, 0x89, 0x0d, 0xbf, 0xe6, 0x42, 0x68, 0x41, 0x99, 0x2d, 0x0f, 0xb0, 0x54, 0xbb, 0x16  /* F */
+  0x63, 0x7c, 0x77, 0x7b, 0xf2, 0x6b, 0x6f, 0xc5, 0x30, 0x01, 0x67, 0x2b,
+  0xfe, 0xd7, 0xab, 0x76, 0xca, 0x82, 0xc9, 0x7d, 0xfa, 0x59, 0x47, 0xf0,
+  0xad, 0xd4, 0xa2, 0xaf, 0x9c, 0xa4, 0x72, 0xc0, 0xb7, 0xfd, 0x93, 0x26,
+  0x36, 0x3f, 0xf7, 0xcc, 0x34, 0xa5, 0xe5, 0xf1, 0x71, 0xd8, 0x31, 0x15,
+  0x04, 0xc7, 0x23, 0xc3, 0x18, 0x96, 0x05, 0x9a, 0x07, 0x12, 0x80, 0xe2,
+  0xeb, 0x27, 0xb2, 0x75, 0x09, 0x83, 0x2c, 0x1a, 0x1b, 0x6e, 0x5a, 0xa0,
+  0x52, 0x3b, 0xd6, 0xb3, 0x29, 0xe3, 0x2f, 0x84, 0x53, 0xd1, 0x00, 0xed,
+  0x20, 0xfc, 0xb1, 0x5b, 0x6a, 0xcb, 0xbe, 0x39, 0x4a, 0x4c, 0x58, 0xcf,
+  0xd0, 0xef, 0xaa, 0xfb, 0x43, 0x4d, 0x33, 0x85, 0x45, 0xf9, 0x02, 0x7f,
+  0x50, 0x3c, 0x9f, 0xa8, 0x51, 0xa3, 0x40, 0x8f, 0x92, 0x9d, 0x38, 0xf5,
+  0xbc, 0xb6, 0xda, 0x21, 0x10, 0xff, 0xf3, 0xd2, 0xcd, 0x0c, 0x13, 0xec,
+  0x5f, 0x97, 0x44, 0x17, 0xc4, 0xa7, 0x7e, 0x3d, 0x64, 0x5d, 0x19, 0x73,
+  0x60, 0x81, 0x4f, 0xdc, 0x22, 0x2a, 0x90, 0x88, 0x46, 0xee, 0xb8, 0x14,
+  0xde, 0x5e, 0x0b, 0xdb, 0xe0, 0x32, 0x3a, 0x0a, 0x49, 0x06, 0x24, 0x5c,
+  0xc2, 0xd3, 0xac, 0x62, 0x91, 0x95, 0xe4, 0x79, 0xe7, 0xc8, 0x37, 0x6d,
+  0x8d, 0xd5, 0x4e, 0xa9, 0x6c, 0x56, 0xf4, 0xea, 0x65, 0x7a, 0xae, 0x08,
+  0xba, 0x78, 0x25, 0x2e, 0x1c, 0xa6, 0xb4, 0xc6, 0xe8, 0xdd, 0x74, 0x1f,
+  0x4b, 0xbd, 0x8b, 0x8a, 0x70, 0x3e, 0xb5, 0x66, 0x48, 0x03, 0xf6, 0x0e,
+  0x61, 0x35, 0x57, 0xb9, 0x86, 0xc1, 0x1d, 0x9e, 0xe1, 0xf8, 0x98, 0x11,
+  0x69, 0xd9, 0x8e, 0x94, 0x9b, 0x1e, 0x87, 0xe9, 0xce, 0x55, 0x28, 0xdf,
+  0x8c, 0xa1, 0x89, 0x0d, 0xbf, 0xe6, 0x42, 0x68, 0x41, 0x99, 0x2d, 0x0f,
+  0xb0, 0x54, 0xbb, 0x16
 };
 
 /* Inverse sbox */
 
 static const uint8_t g_rsbox[256] =
 {
-  0x52, 0x09, 0x6a, 0xd5, 0x30, 0x36, 0xa5, 0x38, 0xbf, 0x40, 0xa3, 0x9e, 0x81, 0xf3, 0xd7, 0xfb,
-  0x7c, 0xe3, 0x39, 0x82, 0x9b, 0x2f, 0xff, 0x87, 0x34, 0x8e, 0x43, 0x44, 0xc4, 0xde, 0xe9, 0xcb,
-  0x54, 0x7b, 0x94, 0x32, 0xa6, 0xc2, 0x23, 0x3d, 0xee, 0x4c, 0x95, 0x0b, 0x42, 0xfa, 0xc3, 0x4e,
-  0x08, 0x2e, 0xa1, 0x66, 0x28, 0xd9, 0x24, 0xb2, 0x76, 0x5b, 0xa2, 0x49, 0x6d, 0x8b, 0xd1, 0x25,
-  0x72, 0xf8, 0xf6, 0x64, 0x86, 0x68, 0x98, 0x16, 0xd4, 0xa4, 0x5c, 0xcc, 0x5d, 0x65, 0xb6, 0x92,
-  0x6c, 0x70, 0x48, 0x50, 0xfd, 0xed, 0xb9, 0xda, 0x5e, 0x15, 0x46, 0x57, 0xa7, 0x8d, 0x9d, 0x84,
-  0x90, 0xd8, 0xab, 0x00, 0x8c, 0xbc, 0xd3, 0x0a, 0xf7, 0xe4, 0x58, 0x05, 0xb8, 0xb3, 0x45, 0x06,
-  0xd0, 0x2c, 0x1e, 0x8f, 0xca, 0x3f, 0x0f, 0x02, 0xc1, 0xaf, 0xbd, 0x03, 0x01, 0x13, 0x8a, 0x6b,
-  0x3a, 0x91, 0x11, 0x41, 0x4f, 0x67, 0xdc, 0xea, 0x97, 0xf2, 0xcf, 0xce, 0xf0, 0xb4, 0xe6, 0x73,
-  0x96, 0xac, 0x74, 0x22, 0xe7, 0xad, 0x35, 0x85, 0xe2, 0xf9, 0x37, 0xe8, 0x1c, 0x75, 0xdf, 0x6e,
-  0x47, 0xf1, 0x1a, 0x71, 0x1d, 0x29, 0xc5, 0x89, 0x6f, 0xb7, 0x62, 0x0e, 0xaa, 0x18, 0xbe, 0x1b,
-  0xfc, 0x56, 0x3e, 0x4b, 0xc6, 0xd2, 0x79, 0x20, 0x9a, 0xdb, 0xc0, 0xfe, 0x78, 0xcd, 0x5a, 0xf4,
-  0x1f, 0xdd, 0xa8, 0x33, 0x88, 0x07, 0xc7, 0x31, 0xb1, 0x12, 0x10, 0x59, 0x27, 0x80, 0xec, 0x5f,
-  0x60, 0x51, 0x7f, 0xa9, 0x19, 0xb5, 0x4a, 0x0d, 0x2d, 0xe5, 0x7a, 0x9f, 0x93, 0xc9, 0x9c, 0xef,
-  0xa0, 0xe0, 0x3b, 0x4d, 0xae, 0x2a, 0xf5, 0xb0, 0xc8, 0xeb, 0xbb, 0x3c, 0x83, 0x53, 0x99, 0x61,
-  0x17, 0x2b, 0x04, 0x7e, 0xba, 0x77, 0xd6, 0x26, 0xe1, 0x69, 0x14, 0x63, 0x55, 0x21, 0x0c, 0x7d
+  0x52, 0x09, 0x6a, 0xd5, 0x30, 0x36, 0xa5, 0x38, 0xbf, 0x40, 0xa3, 0x9e,
+  0x81, 0xf3, 0xd7, 0xfb, 0x7c, 0xe3, 0x39, 0x82, 0x9b, 0x2f, 0xff, 0x87,
+  0x34, 0x8e, 0x43, 0x44, 0xc4, 0xde, 0xe9, 0xcb, 0x54, 0x7b, 0x94, 0x32,
+  0xa6, 0xc2, 0x23, 0x3d, 0xee, 0x4c, 0x95, 0x0b, 0x42, 0xfa, 0xc3, 0x4e,
+  0x08, 0x2e, 0xa1, 0x66, 0x28, 0xd9, 0x24, 0xb2, 0x76, 0x5b, 0xa2, 0x49,
+  0x6d, 0x8b, 0xd1, 0x25, 0x72, 0xf8, 0xf6, 0x64, 0x86, 0x68, 0x98, 0x16,
+  0xd4, 0xa4, 0x5c, 0xcc, 0x5d, 0x65, 0xb6, 0x92, 0x6c, 0x70, 0x48, 0x50,
+  0xfd, 0xed, 0xb9, 0xda, 0x5e, 0x15, 0x46, 0x57, 0xa7, 0x8d, 0x9d, 0x84,
+  0x90, 0xd8, 0xab, 0x00, 0x8c, 0xbc, 0xd3, 0x0a, 0xf7, 0xe4, 0x58, 0x05,
+  0xb8, 0xb3, 0x45, 0x06, 0xd0, 0x2c, 0x1e, 0x8f, 0xca, 0x3f, 0x0f, 0x02,
+  0xc1, 0xaf, 0xbd, 0x03, 0x01, 0x13, 0x8a, 0x6b, 0x3a, 0x91, 0x11, 0x41,
+  0x4f, 0x67, 0xdc, 0xea, 0x97, 0xf2, 0xcf, 0xce, 0xf0, 0xb4, 0xe6, 0x73,
+  0x96, 0xac, 0x74, 0x22, 0xe7, 0xad, 0x35, 0x85, 0xe2, 0xf9, 0x37, 0xe8,
+  0x1c, 0x75, 0xdf, 0x6e, 0x47, 0xf1, 0x1a, 0x71, 0x1d, 0x29, 0xc5, 0x89,
+  0x6f, 0xb7, 0x62, 0x0e, 0xaa, 0x18, 0xbe, 0x1b, 0xfc, 0x56, 0x3e, 0x4b,
+  0xc6, 0xd2, 0x79, 0x20, 0x9a, 0xdb, 0xc0, 0xfe, 0x78, 0xcd, 0x5a, 0xf4,
+  0x1f, 0xdd, 0xa8, 0x33, 0x88, 0x07, 0xc7, 0x31, 0xb1, 0x12, 0x10, 0x59,
+  0x27, 0x80, 0xec, 0x5f, 0x60, 0x51, 0x7f, 0xa9, 0x19, 0xb5, 0x4a, 0x0d,
+  0x2d, 0xe5, 0x7a, 0x9f, 0x93, 0xc9, 0x9c, 0xef, 0xa0, 0xe0, 0x3b, 0x4d,
+  0xae, 0x2a, 0xf5, 0xb0, 0xc8, 0xeb, 0xbb, 0x3c, 0x83, 0x53, 0x99, 0x61,
+  0x17, 0x2b, 0x04, 0x7e, 0xba, 0x77, 0xd6, 0x26, 0xe1, 0x69, 0x14, 0x63,
+  0x55, 0x21, 0x0c, 0x7d
 };
 
-/* Round constant */
+/* Encryption table:  SubBytes and MixColumns of one byte, i.e.
+ * (2.S[x], S[x], S[x], 3.S[x]).  The tables for the other rows are byte
+ * rotations of this one.
+ */
 
-static const uint8_t g_rcon[11] =
+static const uint32_t g_te[256] =
 {
-  0x8d, 0x01, 0x02, 0x04, 0x08, 0x10, 0x20, 0x40, 0x80, 0x1b, 0x36
+  0xa56363c6, 0x847c7cf8, 0x997777ee, 0x8d7b7bf6, 0x0df2f2ff, 0xbd6b6bd6,
+  0xb16f6fde, 0x54c5c591, 0x50303060, 0x03010102, 0xa96767ce, 0x7d2b2b56,
+  0x19fefee7, 0x62d7d7b5, 0xe6abab4d, 0x9a7676ec, 0x45caca8f, 0x9d82821f,
+  0x40c9c989, 0x877d7dfa, 0x15fafaef, 0xeb5959b2, 0xc947478e, 0x0bf0f0fb,
+  0xecadad41, 0x67d4d4b3, 0xfda2a25f, 0xeaafaf45, 0xbf9c9c23, 0xf7a4a453,
+  0x967272e4, 0x5bc0c09b, 0xc2b7b775, 0x1cfdfde1, 0xae93933d, 0x6a26264c,
+  0x5a36366c, 0x413f3f7e, 0x02f7f7f5, 0x4fcccc83, 0x5c343468, 0xf4a5a551,
+  0x34e5e5d1, 0x08f1f1f9, 0x937171e2, 0x73d8d8ab, 0x53313162, 0x3f15152a,
+  0x0c040408, 0x52c7c795, 0x65232346, 0x5ec3c39d, 0x28181830, 0xa1969637,
+  0x0f05050a, 0xb59a9a2f, 0x0907070e, 0x36121224, 0x9b80801b, 0x3de2e2df,
+  0x26ebebcd, 0x6927274e, 0xcdb2b27f, 0x9f7575ea, 0x1b090912, 0x9e83831d,
+  0x742c2c58, 0x2e1a1a34, 0x2d1b1b36, 0xb26e6edc, 0xee5a5ab4, 0xfba0a05b,
+  0xf65252a4, 0x4d3b3b76, 0x61d6d6b7, 0xceb3b37d, 0x7b292952, 0x3ee3e3dd,
+  0x712f2f5e, 0x97848413, 0xf55353a6, 0x68d1d1b9, 0x00000000, 0x2cededc1,
+  0x60202040, 0x1ffcfce3, 0xc8b1b179, 0xed5b5bb6, 0xbe6a6ad4, 0x46cbcb8d,
+  0xd9bebe67, 0x4b393972, 0xde4a4a94, 0xd44c4c98, 0xe85858b0, 0x4acfcf85,
+  0x6bd0d0bb, 0x2aefefc5, 0xe5aaaa4f, 0x16fbfbed, 0xc5434386, 0xd74d4d9a,
+  0x55333366, 0x94858511, 0xcf45458a, 0x10f9f9e9, 0x06020204, 0x817f7ffe,
+  0xf05050a0, 0x443c3c78, 0xba9f9f25, 0xe3a8a84b, 0xf35151a2, 0xfea3a35d,
+  0xc0404080, 0x8a8f8f05, 0xad92923f, 0xbc9d9d21, 0x48383870, 0x04f5f5f1,
+  0xdfbcbc63, 0xc1b6b677, 0x75dadaaf, 0x63212142, 0x30101020, 0x1affffe5,
+  0x0ef3f3fd, 0x6dd2d2bf, 0x4ccdcd81, 0x140c0c18, 0x35131326, 0x2fececc3,
+  0xe15f5fbe, 0xa2979735, 0xcc444488, 0x3917172e, 0x57c4c493, 0xf2a7a755,
+  0x827e7efc, 0x473d3d7a, 0xac6464c8, 0xe75d5dba, 0x2b191932, 0x957373e6,
+  0xa06060c0, 0x98818119, 0xd14f4f9e, 0x7fdcdca3, 0x66222244, 0x7e2a2a54,
+  0xab90903b, 0x8388880b, 0xca46468c, 0x29eeeec7, 0xd3b8b86b, 0x3c141428,
+  0x79dedea7, 0xe25e5ebc, 0x1d0b0b16, 0x76dbdbad, 0x3be0e0db, 0x56323264,
+  0x4e3a3a74, 0x1e0a0a14, 0xdb494992, 0x0a06060c, 0x6c242448, 0xe45c5cb8,
+  0x5dc2c29f, 0x6ed3d3bd, 0xefacac43, 0xa66262c4, 0xa8919139, 0xa4959531,
+  0x37e4e4d3, 0x8b7979f2, 0x32e7e7d5, 0x43c8c88b, 0x5937376e, 0xb76d6dda,
+  0x8c8d8d01, 0x64d5d5b1, 0xd24e4e9c, 0xe0a9a949, 0xb46c6cd8, 0xfa5656ac,
+  0x07f4f4f3, 0x25eaeacf, 0xaf6565ca, 0x8e7a7af4, 0xe9aeae47, 0x18080810,
+  0xd5baba6f, 0x887878f0, 0x6f25254a, 0x722e2e5c, 0x241c1c38, 0xf1a6a657,
+  0xc7b4b473, 0x51c6c697, 0x23e8e8cb, 0x7cdddda1, 0x9c7474e8, 0x211f1f3e,
+  0xdd4b4b96, 0xdcbdbd61, 0x868b8b0d, 0x858a8a0f, 0x907070e0, 0x423e3e7c,
+  0xc4b5b571, 0xaa6666cc, 0xd8484890, 0x05030306, 0x01f6f6f7, 0x120e0e1c,
+  0xa36161c2, 0x5f35356a, 0xf95757ae, 0xd0b9b969, 0x91868617, 0x58c1c199,
+  0x271d1d3a, 0xb99e9e27, 0x38e1e1d9, 0x13f8f8eb, 0xb398982b, 0x33111122,
+  0xbb6969d2, 0x70d9d9a9, 0x898e8e07, 0xa7949433, 0xb69b9b2d, 0x221e1e3c,
+  0x92878715, 0x20e9e9c9, 0x49cece87, 0xff5555aa, 0x78282850, 0x7adfdfa5,
+  0x8f8c8c03, 0xf8a1a159, 0x80898909, 0x170d0d1a, 0xdabfbf65, 0x31e6e6d7,
+  0xc6424284, 0xb86868d0, 0xc3414182, 0xb0999929, 0x772d2d5a, 0x110f0f1e,
+  0xcbb0b07b, 0xfc5454a8, 0xd6bbbb6d, 0x3a16162c
 };
 
+/* Decryption table:  InvSubBytes and InvMixColumns of one byte, i.e.
+ * (14.Si[x], 9.Si[x], 13.Si[x], 11.Si[x]).
+ */
+
+static const uint32_t g_td[256] =
+{
+  0x50a7f451, 0x5365417e, 0xc3a4171a, 0x965e273a, 0xcb6bab3b, 0xf1459d1f,
+  0xab58faac, 0x9303e34b, 0x55fa3020, 0xf66d76ad, 0x9176cc88, 0x254c02f5,
+  0xfcd7e54f, 0xd7cb2ac5, 0x80443526, 0x8fa362b5, 0x495ab1de, 0x671bba25,
+  0x980eea45, 0xe1c0fe5d, 0x02752fc3, 0x12f04c81, 0xa397468d, 0xc6f9d36b,
+  0xe75f8f03, 0x959c9215, 0xeb7a6dbf, 0xda595295, 0x2d83bed4, 0xd3217458,
+  0x2969e049, 0x44c8c98e, 0x6a89c275, 0x78798ef4, 0x6b3e5899, 0xdd71b927,
+  0xb64fe1be, 0x17ad88f0, 0x66ac20c9, 0xb43ace7d, 0x184adf63, 0x82311ae5,
+  0x60335197, 0x457f5362, 0xe07764b1, 0x84ae6bbb, 0x1ca081fe, 0x942b08f9,
+  0x58684870, 0x19fd458f, 0x876cde94, 0xb7f87b52, 0x23d373ab, 0xe2024b72,
+  0x578f1fe3, 0x2aab5566, 0x0728ebb2, 0x03c2b52f, 0x9a7bc586, 0xa50837d3,
+  0xf2872830, 0xb2a5bf23, 0xba6a0302, 0x5c8216ed, 0x2b1ccf8a, 0x92b479a7,
+  0xf0f207f3, 0xa1e2694e, 0xcdf4da65, 0xd5be0506, 0x1f6234d1, 0x8afea6c4,
+  0x9d532e34, 0xa055f3a2, 0x32e18a05, 0x75ebf6a4, 0x39ec830b, 0xaaef6040,
+  0x069f715e, 0x51106ebd, 0xf98a213e, 0x3d06dd96, 0xae053edd, 0x46bde64d,
+  0xb58d5491, 0x055dc471, 0x6fd40604, 0xff155060, 0x24fb9819, 0x97e9bdd6,
+  0xcc434089, 0x779ed967, 0xbd42e8b0, 0x888b8907, 0x385b19e7, 0xdbeec879,
+  0x470a7ca1, 0xe90f427c, 0xc91e84f8, 0x00000000, 0x83868009, 0x48ed2b32,
+  0xac70111e, 0x4e725a6c, 0xfbff0efd, 0x5638850f, 0x1ed5ae3d, 0x27392d36,
+  0x64d90f0a, 0x21a65c68, 0xd1545b9b, 0x3a2e3624, 0xb1670a0c, 0x0fe75793,
+  0xd296eeb4, 0x9e919b1b, 0x4fc5c080, 0xa220dc61, 0x694b775a, 0x161a121c,
+  0x0aba93e2, 0xe52aa0c0, 0x43e0223c, 0x1d171b12, 0x0b0d090e, 0xadc78bf2,
+  0xb9a8b62d, 0xc8a91e14, 0x8519f157, 0x4c0775af, 0xbbdd99ee, 0xfd607fa3,
+  0x9f2601f7, 0xbcf5725c, 0xc53b6644, 0x347efb5b, 0x7629438b, 0xdcc623cb,
+  0x68fcedb6, 0x63f1e4b8, 0xcadc31d7, 0x10856342, 0x40229713, 0x2011c684,
+  0x7d244a85, 0xf83dbbd2, 0x1132f9ae, 0x6da129c7, 0x4b2f9e1d, 0xf330b2dc,
+  0xec52860d, 0xd0e3c177, 0x6c16b32b, 0x99b970a9, 0xfa489411, 0x2264e947,
+  0xc48cfca8, 0x1a3ff0a0, 0xd82c7d56, 0xef903322, 0xc74e4987, 0xc1d138d9,
+  0xfea2ca8c, 0x360bd498, 0xcf81f5a6, 0x28de7aa5, 0x268eb7da, 0xa4bfad3f,
+  0xe49d3a2c, 0x0d927850, 0x9bcc5f6a, 0x62467e54, 0xc2138df6, 0xe8b8d890,
+  0x5ef7392e, 0xf5afc382, 0xbe805d9f, 0x7c93d069, 0xa92dd56f, 0xb31225cf,
+  0x3b99acc8, 0xa77d1810, 0x6e639ce8, 0x7bbb3bdb, 0x097826cd, 0xf418596e,
+  0x01b79aec, 0xa89a4f83, 0x656e95e6, 0x7ee6ffaa, 0x08cfbc21, 0xe6e815ef,
+  0xd99be7ba, 0xce366f4a, 0xd4099fea, 0xd67cb029, 0xafb2a431, 0x31233f2a,
+  0x3094a5c6, 0xc066a235, 0x37bc4e74, 0xa6ca82fc, 0xb0d090e0, 0x15d8a733,
+  0x4a9804f1, 0xf7daec41, 0x0e50cd7f, 0x2ff69117, 0x8dd64d76, 0x4db0ef43,
+  0x544daacc, 0xdf0496e4, 0xe3b5d19e, 0x1b886a4c, 0xb81f2cc1, 0x7f516546,
+  0x04ea5e9d, 0x5d358c01, 0x737487fa, 0x2e410bfb, 0x5a1d67b3, 0x52d2db92,
+  0x335610e9, 0x1347d66d, 0x8c61d79a, 0x7a0ca137, 0x8e14f859, 0x893c13eb,
+  0xee27a9ce, 0x35c961b7, 0xede51ce1, 0x3cb1477a, 0x59dfd29c, 0x3f73f255,
+  0x79ce1418, 0xbf37c773, 0xeacdf753, 0x5baafd5f, 0x146f3ddf, 0x86db4478,
+  0x81f3afca, 0x3ec468b9, 0x2c342438, 0x5f40a3c2, 0x72c31d16, 0x0c25e2bc,
+  0x8b493c28, 0x41950dff, 0x7101a839, 0xdeb30c08, 0x9ce4b4d8, 0x90c15664,
+  0x6184cb7b, 0x70b632d5, 0x745c6c48, 0x4257b8d0
+};
+#endif /* CONFIG_CRYPTO_SW_AES_CONSTTIME */
+
+/* Context of aes_encrypt() and aes_decrypt() */
+
 static struct aes_state_s g_aes_state;
 
+#ifdef CONFIG_CRYPTO_AES
+/* aes_cypher() keeps the schedule of the last key, so that the repeated
+ * calls with the same key made by cryptodev and BCH do not have to expand
+ * it again.
+ */
+
+static sem_t g_cypher_sem = SEM_INITIALIZER(1);
+static struct aes_state_s g_cypher_state;
+static uint8_t g_cypher_key[AES256_KEY_SIZE];
+static uint32_t g_cypher_keysize;
+#endif
+
 /****************************************************************************
  * Private Functions
  ****************************************************************************/
 
+#ifdef CONFIG_CRYPTO_SW_AES_CONSTTIME
+
 /****************************************************************************
- * Name: expand_key
+ * Name: aes_ct_sbox
  *
  * Description:
- *   Expend a 16 bytes key for AES128 implementation
+ *   Constant-time SubBytes of 16 bytes.  The bytes are transposed into
+ *   eight bit planes and the S-box is evaluated as a boolean circuit
+ *   (Boyar and Peralta) on all of them at once, so that no memory access
+ *   depends on secret data.
  *
- * Input Parameters:
- *  key          AES128 key - 16 bytes
- *  expanded_key expanded AES128 key
+ ****************************************************************************/
+
+static void aes_ct_sbox(FAR uint8_t *b)
+{
+  uint32_t q[8];
+  uint32_t x[8];
+  uint32_t y[22];
+  uint32_t z[18];
+  uint32_t t[68];
+  uint32_t s[8];
+  int i;
+  int j;
+
+  /* Transpose:  Bit i of q[j] is bit j of b[i] */
+
+  for (j = 0; j < 8; j++)
+    {
+      q[j] = 0;
+      for (i = 0; i < 16; i++)
+        {
+          q[j] |= (uint32_t)((b[i] >> j) & 1) << i;
+        }
+    }
+
+  x[0] = q[7];
+  x[1] = q[6];
+  x[2] = q[5];
+  x[3] = q[4];
+  x[4] = q[3];
+  x[5] = q[2];
+  x[6] = q[1];
+  x[7] = q[0];
+
+  /* Top linear transformation */
+
+  y[14] = x[3] ^ x[5];
+  y[13] = x[0] ^ x[6];
+  y[9] = x[0] ^ x[3];
+  y[8] = x[0] ^ x[5];
+  t[0] = x[1] ^ x[2];
+  y[1] = t[0] ^ x[7];
+  y[4] = y[1] ^ x[3];
+  y[12] = y[13] ^ y[14];
+  y[2] = y[1] ^ x[0];
+  y[5] = y[1] ^ x[6];
+  y[3] = y[5] ^ y[8];
+  t[1] = x[4] ^ y[12];
+  y[15] = t[1] ^ x[5];
+  y[20] = t[1] ^ x[1];
+  y[6] = y[15] ^ x[7];
+  y[10] = y[15] ^ t[0];
+  y[11] = y[20] ^ y[9];
+  y[7] = x[7] ^ y[11];
+  y[17] = y[10] ^ y[11];
+  y[19] = y[10] ^ y[8];
+  y[16] = t[0] ^ y[11];
+  y[21] = y[13] ^ y[16];
+  y[18] = x[0] ^ y[16];
+
+  /* Non-linear section */
+
+  t[2] = y[12] & y[15];
+  t[3] = y[3] & y[6];
+  t[4] = t[3] ^ t[2];
+  t[5] = y[4] & x[7];
+  t[6] = t[5] ^ t[2];
+  t[7] = y[13] & y[16];
+  t[8] = y[5] & y[1];
+  t[9] = t[8] ^ t[7];
+  t[10] = y[2] & y[7];
+  t[11] = t[10] ^ t[7];
+  t[12] = y[9] & y[11];
+  t[13] = y[14] & y[17];
+  t[14] = t[13] ^ t[12];
+  t[15] = y[8] & y[10];
+  t[16] = t[15] ^ t[12];
+  t[17] = t[4] ^ t[14];
+  t[18] = t[6] ^ t[16];
+  t[19] = t[9] ^ t[14];
+  t[20] = t[11] ^ t[16];
+  t[21] = t[17] ^ y[20];
+  t[22] = t[18] ^ y[19];
+  t[23] = t[19] ^ y[21];
+  t[24] = t[20] ^ y[18];
+
+  t[25] = t[21] ^ t[22];
+  t[26] = t[21] & t[23];
+  t[27] = t[24] ^ t[26];
+  t[28] = t[25] & t[27];
+  t[29] = t[28] ^ t[22];
+  t[30] = t[23] ^ t[24];
+  t[31] = t[22] ^ t[26];
+  t[32] = t[31] & t[30];
+  t[33] = t[32] ^ t[24];
+  t[34] = t[23] ^ t[33];
+  t[35] = t[27] ^ t[33];
+  t[36] = t[24] & t[35];
+  t[37] = t[36] ^ t[34];
+  t[38] = t[27] ^ t[36];
+  t[39] = t[29] & t[38];
+  t[40] = t[25] ^ t[39];
+
+  t[41] = t[40] ^ t[37];
+  t[42] = t[29] ^ t[33];
+  t[43] = t[29] ^ t[40];
+  t[44] = t[33] ^ t[37];
+  t[45] = t[42] ^ t[41];
+  z[0] = t[44] & y[15];
+  z[1] = t[37] & y[6];
+  z[2] = t[33] & x[7];
+  z[3] = t[43] & y[16];
+  z[4] = t[40] & y[1];
+  z[5] = t[29] & y[7];
+  z[6] = t[42] & y[11];
+  z[7] = t[45] & y[17];
+  z[8] = t[41] & y[10];
+  z[9] = t[44] & y[12];
+  z[10] = t[37] & y[3];
+  z[11] = t[33] & y[4];
+  z[12] = t[43] & y[13];
+  z[13] = t[40] & y[5];
+  z[14] = t[29] & y[2];
+  z[15] = t[42] & y[9];
+  z[16] = t[45] & y[14];
+  z[17] = t[41] & y[8];
+
+  /* Bottom linear transformation */
+
+  t[46] = z[15] ^ z[16];
+  t[47] = z[10] ^ z[11];
+  t[48] = z[5] ^ z[13];
+  t[49] = z[9] ^ z[10];
+  t[50] = z[2] ^ z[12];
+  t[51] = z[2] ^ z[5];
+  t[52] = z[7] ^ z[8];
+  t[53] = z[0] ^ z[3];
+  t[54] = z[6] ^ z[7];
+  t[55] = z[16] ^ z[17];
+  t[56] = z[12] ^ t[48];
+  t[57] = t[50] ^ t[53];
+  t[58] = z[4] ^ t[46];
+  t[59] = z[3] ^ t[54];
+  t[60] = t[46] ^ t[57];
+  t[61] = z[14] ^ t[57];
+  t[62] = t[52] ^ t[58];
+  t[63] = t[49] ^ t[58];
+  t[64] = z[4] ^ t[59];
+  t[65] = t[61] ^ t[62];
+  t[66] = z[1] ^ t[63];
+  s[0] = t[59] ^ t[63];
+  s[6] = t[56] ^ ~t[62];
+  s[7] = t[48] ^ ~t[60];
+  t[67] = t[64] ^ t[65];
+  s[3] = t[53] ^ t[66];
+  s[4] = t[51] ^ t[66];
+  s[5] = t[47] ^ t[65];
+  s[1] = t[64] ^ ~s[3];
+  s[2] = t[55] ^ ~t[67];
+
+  q[7] = s[0];
+  q[6] = s[1];
+  q[5] = s[2];
+  q[4] = s[3];
+  q[3] = s[4];
+  q[2] = s[5];
+  q[1] = s[6];
+  q[0] = s[7];
+
+  /* Transpose back */
+
+  for (i = 0; i < 16; i++)
+    {
+      b[i] = 0;
+      for (j = 0; j < 8; j++)
+        {
+          b[i] |= (uint8_t)(((q[j] >> i) & 1) << j);
+        }
+    }
+}
+
+/****************************************************************************
+ * Name: aes_ct_invaffine
  *
- * Returned Value:
- *  None
+ * Description:
+ *   The inverse of the affine transformation of the S-box.  The inverse
+ *   S-box is computed as InvAffine(S(InvAffine(x))).
+ *
+ ****************************************************************************/
+
+static uint8_t aes_ct_invaffine(uint8_t x)
+{
+  return (uint8_t)(((x << 1) | (x >> 7)) ^ ((x << 3) | (x >> 5)) ^
+                   ((x << 6) | (x >> 2)) ^ 0x05);
+}
+
+/****************************************************************************
+ * Name: aes_ct_invsbox
+ *
+ * Description:
+ *   Constant-time InvSubBytes of 16 bytes
  *
  ****************************************************************************/
 
-static void expand_key(FAR uint8_t *expanded_key, FAR const uint8_t *key)
+static void aes_ct_invsbox(FAR uint8_t *b)
 {
-  uint16_t buf1;
-  uint16_t ii;
+  int i;
 
-  for (ii = 0; ii < 16; ii++)
+  for (i = 0; i < 16; i++)
     {
-      expanded_key[ii] = key[ii];
+      b[i] = aes_ct_invaffine(b[i]);
     }
 
-  for (ii = 1; ii < 11; ii++)
+  aes_ct_sbox(b);
+
+  for (i = 0; i < 16; i++)
     {
-      buf1 = expanded_key[ii*16 - 4];
-      expanded_key[ii * 16 + 0] = g_sbox[expanded_key[ii *16 - 3]] ^ expanded_key[(ii - 1) * 16 + 0] ^ g_rcon[ii];
-      expanded_key[ii * 16 + 1] = g_sbox[expanded_key[ii *16 - 2]] ^ expanded_key[(ii - 1) * 16 + 1];
-      expanded_key[ii * 16 + 2] = g_sbox[expanded_key[ii *16 - 1]] ^ expanded_key[(ii - 1) * 16 + 2];
-      expanded_key[ii * 16 + 3] = g_sbox[buf1] ^ expanded_key[(ii - 1) * 16 + 3];
-      expanded_key[ii * 16 + 4] = expanded_key[(ii - 1) * 16 + 4] ^ expanded_key[ii * 16 + 0];
-      expanded_key[ii * 16 + 5] = expanded_key[(ii - 1) * 16 + 5] ^ expanded_key[ii * 16 + 1];
-      expanded_key[ii * 16 + 6] = expanded_key[(ii - 1) * 16 + 6] ^ expanded_key[ii * 16 + 2];
-      expanded_key[ii * 16 + 7] = expanded_key[(ii - 1) * 16 + 7] ^ expanded_key[ii * 16 + 3];
-      expanded_key[ii * 16 + 8] = expanded_key[(ii - 1) * 16 + 8] ^ expanded_key[ii * 16 + 4];
-      expanded_key[ii * 16 + 9] = expanded_key[(ii - 1) * 16 + 9] ^ expanded_key[ii * 16 + 5];
-      expanded_key[ii * 16 +10] = expanded_key[(ii - 1) * 16 +10] ^ expanded_key[ii * 16 + 6];
-      expanded_key[ii * 16 +11] = expanded_key[(ii - 1) * 16 +11] ^ expanded_key[ii * 16 + 7];
-      expanded_key[ii * 16 +12] = expanded_key[(ii - 1) * 16 +12] ^ expanded_key[ii * 16 + 8];
-      expanded_key[ii * 16 +13] = expanded_key[(ii - 1) * 16 +13] ^ expanded_key[ii * 16 + 9];
-      expanded_key[ii * 16 +14] = expanded_key[(ii - 1) * 16 +14] ^ expanded_key[ii * 16 +10];
-      expanded_key[ii * 16 +15] = expanded_key[(ii - 1) * 16 +15] ^ expanded_key[ii * 16 +11];
+      b[i] = aes_ct_invaffine(b[i]);
     }
 }
 
-/******************************************************************************
- * Name: galois_mul2
+/****************************************************************************
+ * Name: aes_ct_xtime
  *
  * Description:
- *    Multiply by 2 in the galois field
+ *   Multiply by 2 in the galois field without a data dependent branch
  *
- * Input Parameters:
- *  value    argument to multiply
+ ****************************************************************************/
+
+static inline uint8_t aes_ct_xtime(uint8_t x)
+{
+  return (uint8_t)((x << 1) ^ (0x1b & -(x >> 7)));
+}
+
+/****************************************************************************
+ * Name: aes_ct_addroundkey
  *
- * Returned Value:
- *  Multiplied argument
+ * Description:
+ *   Add (xor) a round key to the byte-wise state
+ *
+ ****************************************************************************/
+
+static void aes_ct_addroundkey(FAR uint8_t *st, FAR const uint32_t *rk)
+{
+  int i;
+
+  for (i = 0; i < 16; i++)
+    {
+      st[i] ^= (uint8_t)(rk[i >> 2] >> (8 * (i & 3)));
+    }
+}
+
+/****************************************************************************
+ * Name: aes_ct_shiftrows
  *
- ******************************************************************************/
+ * Description:
+ *   ShiftRows, or InvShiftRows if inverse is nonzero
+ *
+ ****************************************************************************/
 
-static uint8_t galois_mul2(uint8_t value)
+static void aes_ct_shiftrows(FAR uint8_t *st, int inverse)
 {
-  if (value >> 7)
+  uint8_t tmp[16];
+  int c;
+  int r;
+
+  memcpy(tmp, st, 16);
+  for (c = 0; c < 4; c++)
     {
-      value = value << 1;
-      return (value ^ 0x1b);
+      for (r = 1; r < 4; r++)
+        {
+          st[4 * c + r] = inverse ? tmp[4 * ((c - r + 4) & 3) + r] :
+                                    tmp[4 * ((c + r) & 3) + r];
+        }
     }
-  else
+}
+
+/****************************************************************************
+ * Name: aes_ct_mixcolumns
+ *
+ * Description:
+ *   MixColumns of the byte-wise state
+ *
+ ****************************************************************************/
+
+static void aes_ct_mixcolumns(FAR uint8_t *st)
+{
+  uint8_t t;
+  uint8_t u;
+  int c;
+
+  for (c = 0; c < 16; c += 4)
     {
-      return value << 1;
+      t = st[c] ^ st[c + 1] ^ st[c + 2] ^ st[c + 3];
+      u = st[c];
+      st[c]     ^= t ^ aes_ct_xtime(st[c] ^ st[c + 1]);
+      st[c + 1] ^= t ^ aes_ct_xtime(st[c + 1] ^ st[c + 2]);
+      st[c + 2] ^= t ^ aes_ct_xtime(st[c + 2] ^ st[c + 3]);
+      st[c + 3] ^= t ^ aes_ct_xtime(st[c + 3] ^ u);
     }
 }
 
-/******************************************************************************
- * Name: aes_encr
+/****************************************************************************
+ * Name: aes_ct_invmixcolumns
  *
  * Description:
- *  Internal implementation of AES128 encryption.
- *  Straight forward aes encryption implementation. First the group of
- *  operations:
+ *   InvMixColumns of the byte-wise state
  *
- *    - addRoundKey
- *    - subbytes
- *    - shiftrows
- *    - mixcolums
+ ****************************************************************************/
+
+static void aes_ct_invmixcolumns(FAR uint8_t *st)
+{
+  uint8_t u;
+  uint8_t v;
+  int c;
+
+  /* InvMixColumns = MixColumns after a (4.x^2 + 4) preprocessing step */
+
+  for (c = 0; c < 16; c += 4)
+    {
+      u = aes_ct_xtime(aes_ct_xtime(st[c] ^ st[c + 2]));
+      v = aes_ct_xtime(aes_ct_xtime(st[c + 1] ^ st[c + 3]));
+      st[c]     ^= u;
+      st[c + 1] ^= v;
+      st[c + 2] ^= u;
+      st[c + 3] ^= v;
+    }
+
+  aes_ct_mixcolumns(st);
+}
+
+/****************************************************************************
+ * Name: aes_subword
  *
- *  is executed 9 times, after this addroundkey to finish the 9th round, after
- *  that the 10th round without mixcolums no further subfunctions to save
- *  cycles for function calls no structuring with "for (....)" to save cycles.
+ * Description:
+ *   SubWord of the key expansion
  *
- * Input Parameters:
- *  expanded_key expanded AES128 key
- *  state        16 bytes of plain text and cipher text
+ ****************************************************************************/
+
+static uint32_t aes_subword(uint32_t w)
+{
+  uint8_t b[16];
+
+  memset(b, 0, sizeof(b));
+  PUTU32(b, w);
+  aes_ct_sbox(b);
+  return GETU32(b);
+}
+
+/****************************************************************************
+ * Name: aes_encr
  *
- * Returned Value:
- *  None
+ * Description:
+ *   Encrypt one block with the constant-time implementation
  *
- ******************************************************************************/
+ ****************************************************************************/
 
-static void aes_encr(FAR uint8_t *state, FAR const uint8_t *expanded_key)
+static void aes_encr(FAR const struct aes_state_s *state,
+                     FAR uint8_t *out, FAR const uint8_t *in)
 {
-  uint8_t buf1;
-  uint8_t buf2;
-  uint8_t buf3;
-  uint8_t round;
+  FAR const uint32_t *rk = state->erk;
+  uint8_t st[16];
+  int round;
+
+  memcpy(st, in, 16);
+  aes_ct_addroundkey(st, rk);
 
-  for (round = 0; round < 9; round ++)
+  for (round = 1; round < state->nrounds; round++)
     {
-      /* addroundkey, sbox and shiftrows */
-      /* Row 0 */
-
-      state[0]   = g_sbox[(state[0]  ^ expanded_key[(round * 16)])];
-      state[4]   = g_sbox[(state[4]  ^ expanded_key[(round * 16) +  4])];
-      state[8]   = g_sbox[(state[8]  ^ expanded_key[(round * 16) +  8])];
-      state[12]  = g_sbox[(state[12] ^ expanded_key[(round * 16) + 12])];
-
-      /* Row 1 */
-
-      buf1       = state[1] ^ expanded_key[(round * 16) + 1];
-      state[1]   = g_sbox[(state[5]  ^ expanded_key[(round * 16) +  5])];
-      state[5]   = g_sbox[(state[9]  ^ expanded_key[(round * 16) +  9])];
-      state[9]   = g_sbox[(state[13] ^ expanded_key[(round * 16) + 13])];
-      state[13]  = g_sbox[buf1];
-
-      /* Row 2 */
-
-      buf1       = state[2] ^ expanded_key[(round * 16) + 2];
-      buf2       = state[6] ^ expanded_key[(round * 16) + 6];
-      state[2]   = g_sbox[(state[10] ^ expanded_key[(round * 16) + 10])];
-      state[6]   = g_sbox[(state[14] ^ expanded_key[(round * 16) + 14])];
-      state[10]  = g_sbox[buf1];
-      state[14]  = g_sbox[buf2];
-
-      /* Row 3 */
-
-      buf1       = state[15] ^ expanded_key[(round * 16) + 15];
-      state[15]  = g_sbox[(state[11] ^ expanded_key[(round * 16) + 11])];
-      state[11]  = g_sbox[(state[7]  ^ expanded_key[(round * 16) +  7])];
-      state[7]   = g_sbox[(state[3]  ^ expanded_key[(round * 16) +  3])];
-      state[3]   = g_sbox[buf1];
-
-      /* mixcolums */
-      /* Col1 */
-
-      buf1 = state[0] ^ state[1] ^ state[2] ^ state[3];
-      buf2 = state[0];
-      buf3 = state[0] ^ state[1]; buf3 = galois_mul2(buf3); state[0] = state[0] ^ buf3 ^ buf1;
-      buf3 = state[1] ^ state[2]; buf3 = galois_mul2(buf3); state[1] = state[1] ^ buf3 ^ buf1;
-      buf3 = state[2] ^ state[3]; buf3 = galois_mul2(buf3); state[2] = state[2] ^ buf3 ^ buf1;
-      buf3 = state[3] ^ buf2;     buf3 = galois_mul2(buf3); state[3] = state[3] ^ buf3 ^ buf1;
-
-      /* Col2 */
-
-      buf1 = state[4] ^ state[5] ^ state[6] ^ state[7];
-      buf2 = state[4];
-      buf3 = state[4] ^ state[5]; buf3 = galois_mul2(buf3); state[4] = state[4] ^ buf3 ^ buf1;
-      buf3 = state[5] ^ state[6]; buf3 = galois_mul2(buf3); state[5] = state[5] ^ buf3 ^ buf1;
-      buf3 = state[6] ^ state[7]; buf3 = galois_mul2(buf3); state[6] = state[6] ^ buf3 ^ buf1;
-      buf3 = state[7] ^ buf2;     buf3 = galois_mul2(buf3); state[7] = state[7] ^ buf3 ^ buf1;
-
-      /* Col3 */
-
-      buf1 = state[8] ^ state[9] ^ state[10] ^ state[11];
-      buf2 = state[8];
-      buf3 = state[8] ^ state[9];   buf3 = galois_mul2(buf3); state[8] = state[8] ^ buf3 ^ buf1;
-      buf3 = state[9] ^ state[10];  buf3 = galois_mul2(buf3); state[9] = state[9] ^ buf3 ^ buf1;
-      buf3 = state[10] ^ state[11]; buf3 = galois_mul2(buf3); state[10] = state[10] ^ buf3 ^ buf1;
-      buf3 = state[11] ^ buf2;      buf3 = galois_mul2(buf3); state[11] = state[11] ^ buf3 ^ buf1;
-
-      /* Col4 */
-
-      buf1 = state[12] ^ state[13] ^ state[14] ^ state[15];
-      buf2 = state[12];
-      buf3 = state[12] ^ state[13]; buf3 = galois_mul2(buf3); state[12] = state[12] ^ buf3 ^ buf1;
-      buf3 = state[13] ^ state[14]; buf3 = galois_mul2(buf3); state[13] = state[13] ^ buf3 ^ buf1;
-      buf3 = state[14] ^ state[15]; buf3 = galois_mul2(buf3); state[14] = state[14] ^ buf3 ^ buf1;
-      buf3 = state[15] ^ buf2;      buf3 = galois_mul2(buf3); state[15] = state[15] ^ buf3 ^ buf1;
+      aes_ct_sbox(st);
+      aes_ct_shiftrows(st, 0);
+      aes_ct_mixcolumns(st);
+      aes_ct_addroundkey(st, rk + 4 * round);
     }
 
-  /* 10th round without mixcols */
-
-  state[0]   = g_sbox[(state[0]  ^ expanded_key[(round * 16)])];
-  state[4]   = g_sbox[(state[4]  ^ expanded_key[(round * 16) +  4])];
-  state[8]   = g_sbox[(state[8]  ^ expanded_key[(round * 16) +  8])];
-  state[12]  = g_sbox[(state[12] ^ expanded_key[(round * 16) + 12])];
-
-  /* Row 1 */
-
-  buf1       = state[1] ^ expanded_key[(round * 16) + 1];
-  state[1]   = g_sbox[(state[5]  ^ expanded_key[(round * 16) +  5])];
-  state[5]   = g_sbox[(state[9]  ^ expanded_key[(round * 16) +  9])];
-  state[9]   = g_sbox[(state[13] ^ expanded_key[(round * 16) + 13])];
-  state[13]  = g_sbox[buf1];
-
-  /* Row 2 */
-
-  buf1       = state[2] ^ expanded_key[(round * 16) + 2];
-  buf2       = state[6] ^ expanded_key[(round * 16) + 6];
-  state[2]   = g_sbox[(state[10] ^ expanded_key[(round * 16) + 10])];
-  state[6]   = g_sbox[(state[14] ^ expanded_key[(round * 16) + 14])];
-  state[10]  = g_sbox[buf1];
-  state[14]  = g_sbox[buf2];
-
-  /* Row 3 */
-
-  buf1       = state[15] ^ expanded_key[(round * 16) + 15];
-  state[15]  = g_sbox[(state[11] ^ expanded_key[(round * 16) + 11])];
-  state[11]  = g_sbox[(state[7]  ^ expanded_key[(round * 16) +  7])];
-  state[7]   = g_sbox[(state[3]  ^ expanded_key[(round * 16) +  3])];
-  state[3]   = g_sbox[buf1];
-
-  /* Last addroundkey */
-
-  state[0]  ^= expanded_key[160];
-  state[1]  ^= expanded_key[161];
-  state[2]  ^= expanded_key[162];
-  state[3]  ^= expanded_key[163];
-  state[4]  ^= expanded_key[164];
-  state[5]  ^= expanded_key[165];
-  state[6]  ^= expanded_key[166];
-  state[7]  ^= expanded_key[167];
-  state[8]  ^= expanded_key[168];
-  state[9]  ^= expanded_key[169];
-  state[10] ^= expanded_key[170];
-  state[11] ^= expanded_key[171];
-  state[12] ^= expanded_key[172];
-  state[13] ^= expanded_key[173];
-  state[14] ^= expanded_key[174];
-  state[15] ^= expanded_key[175];
+  aes_ct_sbox(st);
+  aes_ct_shiftrows(st, 0);
+  aes_ct_addroundkey(st, rk + 4 * round);
+  memcpy(out, st, 16);
 }
 
-/******************************************************************************
+/****************************************************************************
  * Name: aes_decr
  *
  * Description:
- *  Internal implementation of AES128 decryption.
- *  Straight forward aes decryption implementation.  The order of substeps is
- *  the exact reverse of decryption inverse functions:
+ *   Decrypt one block with the constant-time implementation
  *
- *     - addRoundKey is its own inverse
- *     - rsbox is inverse of sbox
- *     - rightshift instead of leftshift
- *     - invMixColumns = barreto + mixColumns
+ ****************************************************************************/
+
+static void aes_decr(FAR const struct aes_state_s *state,
+                     FAR uint8_t *out, FAR const uint8_t *in)
+{
+  FAR const uint32_t *rk = state->erk;
+  uint8_t st[16];
+  int round;
+
+  memcpy(st, in, 16);
+  aes_ct_addroundkey(st, rk + 4 * state->nrounds);
+
+  for (round = state->nrounds - 1; round > 0; round--)
+    {
+      aes_ct_shiftrows(st, 1);
+      aes_ct_invsbox(st);
+      aes_ct_addroundkey(st, rk + 4 * round);
+      aes_ct_invmixcolumns(st);
+    }
+
+  aes_ct_shiftrows(st, 1);
+  aes_ct_invsbox(st);
+  aes_ct_addroundkey(st, rk);
+  memcpy(out, st, 16);
+}
+
+#else /* CONFIG_CRYPTO_SW_AES_CONSTTIME */
+
+/****************************************************************************
+ * Name: aes_subword
  *
- *  No further subfunctions to save cycles for function calls no structuring
- *  with "for (....)" to save cycles
+ * Description:
+ *   SubWord of the key expansion
  *
- * Input Parameters:
- *  expanded_key expanded AES128 key
- *  state        16 bytes of cipher text and plain text
+ ****************************************************************************/
+
+static uint32_t aes_subword(uint32_t w)
+{
+  return (uint32_t)g_sbox[w & 0xff] |
+         ((uint32_t)g_sbox[(w >> 8) & 0xff] << 8) |
+         ((uint32_t)g_sbox[(w >> 16) & 0xff] << 16) |
+         ((uint32_t)g_sbox[w >> 24] << 24);
+}
+
+/****************************************************************************
+ * Name: aes_invkeys
  *
- * Returned Value:
- *  None
+ * Description:
+ *   Derive the round keys of the equivalent inverse cipher:  The
+ *   encryption round keys in reverse order, with InvMixColumns applied to
+ *   all but the first and the last.
  *
- ******************************************************************************/
+ ****************************************************************************/
 
-static void aes_decr(FAR uint8_t *state, FAR const uint8_t *expanded_key)
+static void aes_invkeys(FAR struct aes_state_s *state)
 {
-  uint8_t buf1;
-  uint8_t buf2;
-  uint8_t buf3;
-  int8_t round;
-
-  round = 9;
-
-  /* Initial addroundkey */
-
-  state[0]  ^= expanded_key[160];
-  state[1]  ^= expanded_key[161];
-  state[2]  ^= expanded_key[162];
-  state[3]  ^= expanded_key[163];
-  state[4]  ^= expanded_key[164];
-  state[5]  ^= expanded_key[165];
-  state[6]  ^= expanded_key[166];
-  state[7]  ^= expanded_key[167];
-  state[8]  ^= expanded_key[168];
-  state[9]  ^= expanded_key[169];
-  state[10] ^= expanded_key[170];
-  state[11] ^= expanded_key[171];
-  state[12] ^= expanded_key[172];
-  state[13] ^= expanded_key[173];
-  state[14] ^= expanded_key[174];
-  state[15] ^= expanded_key[175];
-
-  /* 10th round without mixcols */
-
-  state[0]   = g_rsbox[state[0]]  ^ expanded_key[(round * 16)];
-  state[4]   = g_rsbox[state[4]]  ^ expanded_key[(round * 16) +  4];
-  state[8]   = g_rsbox[state[8]]  ^ expanded_key[(round * 16) +  8];
-  state[12]  = g_rsbox[state[12]] ^ expanded_key[(round * 16) + 12];
-
-  /* Row 1 */
-
-  buf1       = g_rsbox[state[13]] ^ expanded_key[(round * 16) +  1];
-  state[13]  = g_rsbox[state[9]]  ^ expanded_key[(round * 16) + 13];
-  state[9]   = g_rsbox[state[5]]  ^ expanded_key[(round * 16) +  9];
-  state[5]   = g_rsbox[state[1]]  ^ expanded_key[(round * 16) +  5];
-  state[1]   = buf1;
-
-  /* Row 2 */
-
-  buf1       = g_rsbox[state[2]]  ^ expanded_key[(round * 16) + 10];
-  buf2       = g_rsbox[state[6]]  ^ expanded_key[(round * 16) + 14];
-  state[2]   = g_rsbox[state[10]] ^ expanded_key[(round * 16) +  2];
-  state[6]   = g_rsbox[state[14]] ^ expanded_key[(round * 16) +  6];
-  state[10]  = buf1;
-  state[14]  = buf2;
-
-  /* Row 3 */
-
-  buf1       = g_rsbox[state[3]]  ^ expanded_key[(round * 16) + 15];
-  state[3]   = g_rsbox[state[7]]  ^ expanded_key[(round * 16) +  3];
-  state[7]   = g_rsbox[state[11]] ^ expanded_key[(round * 16) +  7];
-  state[11]  = g_rsbox[state[15]] ^ expanded_key[(round * 16) + 11];
-  state[15]  = buf1;
-
-  for (round = 8; round >= 0; round--)
+  FAR const uint32_t *erk = state->erk;
+  FAR uint32_t *drk = state->drk;
+  int nr = state->nrounds;
+  uint32_t w;
+  int round;
+  int i;
+
+  for (i = 0; i < 4; i++)
     {
-      /* barreto */
-      /* Col1 */
-
-      buf1       = galois_mul2(galois_mul2(state[0] ^ state[2]));
-      buf2       = galois_mul2(galois_mul2(state[1] ^ state[3]));
-      state[0]  ^= buf1;
-      state[1]  ^= buf2;
-      state[2]  ^= buf1;
-      state[3]  ^= buf2;
-
-      /* Col2 */
-
-      buf1       = galois_mul2(galois_mul2(state[4] ^ state[6]));
-      buf2       = galois_mul2(galois_mul2(state[5] ^ state[7]));
-      state[4]  ^= buf1;
-      state[5]  ^= buf2;
-      state[6]  ^= buf1;
-      state[7]  ^= buf2;
-
-      /* Col3 */
-
-      buf1       = galois_mul2(galois_mul2(state[8] ^ state[10]));
-      buf2       = galois_mul2(galois_mul2(state[9] ^ state[11]));
-      state[8]  ^= buf1;
-      state[9]  ^= buf2;
-      state[10] ^= buf1;
-      state[11] ^= buf2;
-
-      /* Col4 */
-
-      buf1       = galois_mul2(galois_mul2(state[12] ^ state[14]));
-      buf2       = galois_mul2(galois_mul2(state[13] ^ state[15]));
-      state[12] ^= buf1;
-      state[13] ^= buf2;
-      state[14] ^= buf1;
-      state[15] ^= buf2;
-
-      /* mixcolums */
-      /* Col1 */
-
-      buf1 = state[0]  ^ state[1] ^ state[2] ^ state[3];
-      buf2 = state[0];
-      buf3 = state[0]  ^ state[1]; buf3 = galois_mul2(buf3); state[0] = state[0] ^ buf3 ^ buf1;
-      buf3 = state[1]  ^ state[2]; buf3 = galois_mul2(buf3); state[1] = state[1] ^ buf3 ^ buf1;
-      buf3 = state[2]  ^ state[3]; buf3 = galois_mul2(buf3); state[2] = state[2] ^ buf3 ^ buf1;
-      buf3 = state[3]  ^ buf2;     buf3 = galois_mul2(buf3); state[3] = state[3] ^ buf3 ^ buf1;
-
-      /* Col2 */
-
-      buf1 = state[4]  ^ state[5] ^ state[6] ^ state[7];
-      buf2 = state[4];
-      buf3 = state[4]  ^ state[5]; buf3 = galois_mul2(buf3); state[4] = state[4] ^ buf3 ^ buf1;
-      buf3 = state[5]  ^ state[6]; buf3 = galois_mul2(buf3); state[5] = state[5] ^ buf3 ^ buf1;
-      buf3 = state[6]  ^ state[7]; buf3 = galois_mul2(buf3); state[6] = state[6] ^ buf3 ^ buf1;
-      buf3 = state[7]  ^ buf2;     buf3 = galois_mul2(buf3); state[7] = state[7] ^ buf3 ^ buf1;
-
-      /* Col3 */
-
-      buf1 = state[8]  ^ state[9] ^ state[10] ^ state[11];
-      buf2 = state[8];
-      buf3 = state[8]  ^ state[9];  buf3 = galois_mul2(buf3); state[8] = state[8] ^ buf3 ^ buf1;
-      buf3 = state[9]  ^ state[10]; buf3 = galois_mul2(buf3); state[9] = state[9] ^ buf3 ^ buf1;
-      buf3 = state[10] ^ state[11]; buf3 = galois_mul2(buf3); state[10] = state[10] ^ buf3 ^ buf1;
-      buf3 = state[11] ^ buf2;      buf3 = galois_mul2(buf3); state[11] = state[11] ^ buf3 ^ buf1;
-
-      /* Col4 */
-
-      buf1 = state[12] ^ state[13] ^ state[14] ^ state[15];
-      buf2 = state[12];
-      buf3 = state[12] ^ state[13]; buf3 = galois_mul2(buf3); state[12] = state[12] ^ buf3 ^ buf1;
-      buf3 = state[13] ^ state[14]; buf3 = galois_mul2(buf3); state[13] = state[13] ^ buf3 ^ buf1;
-      buf3 = state[14] ^ state[15]; buf3 = galois_mul2(buf3); state[14] = state[14] ^ buf3 ^ buf1;
-      buf3 = state[15] ^ buf2;      buf3 = galois_mul2(buf3); state[15] = state[15] ^ buf3 ^ buf1;
-
-      /* addroundkey, rsbox and shiftrows */
-      /* Row 0 */
-
-      state[0]   = g_rsbox[state[0]]  ^ expanded_key[(round * 16)];
-      state[4]   = g_rsbox[state[4]]  ^ expanded_key[(round * 16) +  4];
-      state[8]   = g_rsbox[state[8]]  ^ expanded_key[(round * 16) +  8];
-      state[12]  = g_rsbox[state[12]] ^ expanded_key[(round * 16) + 12];
-
-      /* Row 1 */
-
-      buf1       = g_rsbox[state[13]] ^ expanded_key[(round * 16) +  1];
-      state[13]  = g_rsbox[state[9]]  ^ expanded_key[(round * 16) + 13];
-      state[9]   = g_rsbox[state[5]]  ^ expanded_key[(round * 16) +  9];
-      state[5]   = g_rsbox[state[1]]  ^ expanded_key[(round * 16) +  5];
-      state[1]   = buf1;
-
-      /* Row 2 */
-
-      buf1       = g_rsbox[state[2]]  ^ expanded_key[(round * 16) + 10];
-      buf2       = g_rsbox[state[6]]  ^ expanded_key[(round * 16) + 14];
-      state[2]   = g_rsbox[state[10]] ^ expanded_key[(round * 16) +  2];
-      state[6]   = g_rsbox[state[14]] ^ expanded_key[(round * 16) +  6];
-      state[10]  = buf1;
-      state[14]  = buf2;
-
-      /* Row 3 */
-
-      buf1       = g_rsbox[state[3]]  ^ expanded_key[(round * 16) + 15];
-      state[3]   = g_rsbox[state[7]]  ^ expanded_key[(round * 16) +  3];
-      state[7]   = g_rsbox[state[11]] ^ expanded_key[(round * 16) +  7];
-      state[11]  = g_rsbox[state[15]] ^ expanded_key[(round * 16) + 11];
-      state[15]  = buf1;
+      drk[i]          = erk[4 * nr + i];
+      drk[4 * nr + i] = erk[i];
+    }
+
+  for (round = 1; round < nr; round++)
+    {
+      for (i = 0; i < 4; i++)
+        {
+          w = erk[4 * (nr - round) + i];
+          drk[4 * round + i] = g_td[g_sbox[w & 0xff]] ^
+                               ROTL8(g_td[g_sbox[(w >> 8) & 0xff]]) ^
+                               ROTL16(g_td[g_sbox[(w >> 16) & 0xff]]) ^
+                               ROTL24(g_td[g_sbox[w >> 24]]);
+        }
     }
 }
 
+/****************************************************************************
+ * Name: aes_encr
+ *
+ * Description:
+ *   Encrypt one block.  Each round computes SubBytes, ShiftRows and
+ *   MixColumns of a column with four table lookups.
+ *
+ ****************************************************************************/
+
+static void aes_encr(FAR const struct aes_state_s *state,
+                     FAR uint8_t *out, FAR const uint8_t *in)
+{
+  FAR const uint32_t *rk = state->erk;
+  uint32_t s0;
+  uint32_t s1;
+  uint32_t s2;
+  uint32_t s3;
+  uint32_t t0;
+  uint32_t t1;
+  uint32_t t2;
+  uint32_t t3;
+  int round;
+
+  s0 = GETU32(in)      ^ rk[0];
+  s1 = GETU32(in + 4)  ^ rk[1];
+  s2 = GETU32(in + 8)  ^ rk[2];
+  s3 = GETU32(in + 12) ^ rk[3];
+
+  for (round = 1; round < state->nrounds; round++)
+    {
+      rk += 4;
+      t0 = TE_ROUND(s0, s1, s2, s3, rk[0]);
+      t1 = TE_ROUND(s1, s2, s3, s0, rk[1]);
+      t2 = TE_ROUND(s2, s3, s0, s1, rk[2]);
+      t3 = TE_ROUND(s3, s0, s1, s2, rk[3]);
+      s0 = t0;
+      s1 = t1;
+      s2 = t2;
+      s3 = t3;
+    }
+
+  rk += 4;
+  t0 = TE_FINAL(s0, s1, s2, s3, rk[0]);
+  t1 = TE_FINAL(s1, s2, s3, s0, rk[1]);
+  t2 = TE_FINAL(s2, s3, s0, s1, rk[2]);
+  t3 = TE_FINAL(s3, s0, s1, s2, rk[3]);
+
+  PUTU32(out, t0);
+  PUTU32(out + 4, t1);
+  PUTU32(out + 8, t2);
+  PUTU32(out + 12, t3);
+}
+
+/****************************************************************************
+ * Name: aes_decr
+ *
+ * Description:
+ *   Decrypt one block with the equivalent inverse cipher
+ *
+ ****************************************************************************/
+
+static void aes_decr(FAR const struct aes_state_s *state,
+                     FAR uint8_t *out, FAR const uint8_t *in)
+{
+  FAR const uint32_t *rk = state->drk;
+  uint32_t s0;
+  uint32_t s1;
+  uint32_t s2;
+  uint32_t s3;
+  uint32_t t0;
+  uint32_t t1;
+  uint32_t t2;
+  uint32_t t3;
+  int round;
+
+  s0 = GETU32(in)      ^ rk[0];
+  s1 = GETU32(in + 4)  ^ rk[1];
+  s2 = GETU32(in + 8)  ^ rk[2];
+  s3 = GETU32(in + 12) ^ rk[3];
+
+  for (round = 1; round < state->nrounds; round++)
+    {
+      rk += 4;
+      t0 = TD_ROUND(s0, s3, s2, s1, rk[0]);
+      t1 = TD_ROUND(s1, s0, s3, s2, rk[1]);
+      t2 = TD_ROUND(s2, s1, s0, s3, rk[2]);
+      t3 = TD_ROUND(s3, s2, s1, s0, rk[3]);
+      s0 = t0;
+      s1 = t1;
+      s2 = t2;
+      s3 = t3;
+    }
+
+  rk += 4;
+  t0 = TD_FINAL(s0, s3, s2, s1, rk[0]);
+  t1 = TD_FINAL(s1, s0, s3, s2, rk[1]);
+  t2 = TD_FINAL(s2, s1, s0, s3, rk[2]);
+  t3 = TD_FINAL(s3, s2, s1, s0, rk[3]);
+
+  PUTU32(out, t0);
+  PUTU32(out + 4, t1);
+  PUTU32(out + 8, t2);
+  PUTU32(out + 12, t3);
+}
+
+#endif /* CONFIG_CRYPTO_SW_AES_CONSTTIME */
+
 /****************************************************************************
  * Public Functions
  ****************************************************************************/
@@ -547,25 +891,57 @@ static void aes_decr(FAR uint8_t *state, FAR const uint8_t *expanded_key)
  *
  * Input Parameters:
  *  state  an AES context that can be used for AES operations
- *  key    a pointer to a 16-byte buffer holding the AES-128 key
- *  len    length of the key, must be 16
- *
- * TODO: Support other key lengths of 24 (AES-192) and 32 (AES-256)
+ *  key    a pointer to a buffer holding the AES key
+ *  len    length of the key: 16 (AES-128), 24 (AES-192) or 32 (AES-256)
  *
  * Returned Value:
  *   0 if OK
- *   -EINVAL if len is not 16
+ *   -EINVAL if len is not a valid AES key length
  *
  ****************************************************************************/
 
-int aes_setupkey(FAR struct aes_state_s *state, FAR const uint8_t *key, int len)
+int aes_setupkey(FAR struct aes_state_s *state, FAR const uint8_t *key,
+                 int len)
 {
-  if (len != 16)
+  FAR uint32_t *w = state->erk;
+  uint32_t temp;
+  int nwords;
+  int nk;
+  int i;
+
+  if (len != AES128_KEY_SIZE && len != AES192_KEY_SIZE &&
+      len != AES256_KEY_SIZE)
     {
       return -EINVAL;
     }
 
-  expand_key(state->expanded_key, key);
+  nk             = len / 4;
+  state->nrounds = nk + 6;
+  nwords         = 4 * (state->nrounds + 1);
+
+  for (i = 0; i < nk; i++)
+    {
+      w[i] = GETU32(key + 4 * i);
+    }
+
+  for (i = nk; i < nwords; i++)
+    {
+      temp = w[i - 1];
+      if (i % nk == 0)
+        {
+          temp = aes_subword(ROTL24(temp)) ^ g_rcon[i / nk - 1];
+        }
+      else if (nk > 6 && i % nk == 4)
+        {
+          temp = aes_subword(temp);
+        }
+
+      w[i] = w[i - nk] ^ temp;
+    }
+
+#ifndef CONFIG_CRYPTO_SW_AES_CONSTTIME
+  aes_invkeys(state);
+#endif
   return 0;
 }
 
@@ -586,12 +962,10 @@ void aes_encipher(FAR struct aes_state_s *state, FAR uint8_t *blocks,
                   int nblk)
 {
   int i;
-  uint32_t off = 0;
 
-  for (i = 0; i < nblk; i++)
+  for (i = 0; i < nblk; i++, blocks += AES_BLOCKSIZE)
     {
-      aes_encr(blocks + off, state->expanded_key);
-      off += 16;
+      aes_encr(state, blocks, blocks);
     }
 }
 
@@ -612,12 +986,102 @@ void aes_decipher(FAR struct aes_state_s *state, FAR uint8_t *blocks,
                   int nblk)
 {
   int i;
-  uint32_t off = 0;
 
-  for (i = 0; i < nblk; i++)
+  for (i = 0; i < nblk; i++, blocks += AES_BLOCKSIZE)
+    {
+      aes_decr(state, blocks, blocks);
+    }
+}
+
+/****************************************************************************
+ * Name: aes_cbc
+ *
+ * Description:
+ *   Encrypt or decrypt len bytes in CBC mode.  len must be a multiple of
+ *   16.  iv holds the 16-byte initialization vector on entry and the
+ *   chaining value for a following call on return.  out and in may be the
+ *   same buffer.
+ *
+ ****************************************************************************/
+
+void aes_cbc(FAR struct aes_state_s *state, FAR uint8_t *out,
+             FAR const uint8_t *in, size_t len, FAR uint8_t *iv,
+             int encrypt)
+{
+  uint8_t block[AES_BLOCKSIZE];
+  int i;
+
+  for (; len >= AES_BLOCKSIZE; len -= AES_BLOCKSIZE)
+    {
+      if (encrypt)
+        {
+          for (i = 0; i < AES_BLOCKSIZE; i++)
+            {
+              block[i] = in[i] ^ iv[i];
+            }
+
+          aes_encr(state, out, block);
+          memcpy(iv, out, AES_BLOCKSIZE);
+        }
+      else
+        {
+          /* Keep the cipher text:  out may overwrite it */
+
+          memcpy(block, in, AES_BLOCKSIZE);
+          aes_decr(state, out, in);
+          for (i = 0; i < AES_BLOCKSIZE; i++)
+            {
+              out[i] ^= iv[i];
+            }
+
+          memcpy(iv, block, AES_BLOCKSIZE);
+        }
+
+      in  += AES_BLOCKSIZE;
+      out += AES_BLOCKSIZE;
+    }
+}
+
+/****************************************************************************
+ * Name: aes_ctr
+ *
+ * Description:
+ *   Encrypt or decrypt len bytes in CTR mode.  ctr holds the 16-byte
+ *   initial counter block on entry; it is incremented as a 128-bit
+ *   big-endian number for each block.  Only the last call in a sequence
+ *   may use a length that is not a multiple of 16.  out and in may be the
+ *   same buffer.
+ *
+ ****************************************************************************/
+
+void aes_ctr(FAR struct aes_state_s *state, FAR uint8_t *out,
+             FAR const uint8_t *in, size_t len, FAR uint8_t *ctr)
+{
+  uint8_t stream[AES_BLOCKSIZE];
+  size_t n;
+  size_t i;
+
+  while (len > 0)
     {
-      aes_decr(blocks + off, state->expanded_key);
-      off += 16;
+      aes_encr(state, stream, ctr);
+
+      for (i = AES_BLOCKSIZE; i > 0; i--)
+        {
+          if (++ctr[i - 1] != 0)
+            {
+              break;
+            }
+        }
+
+      n = len < AES_BLOCKSIZE ? len : AES_BLOCKSIZE;
+      for (i = 0; i < n; i++)
+        {
+          out[i] = in[i] ^ stream[i];
+        }
+
+      in  += n;
+      out += n;
+      len -= n;
     }
 }
 
@@ -640,10 +1104,8 @@ void aes_decipher(FAR struct aes_state_s *state, FAR uint8_t *blocks,
 
 void aes_encrypt(FAR uint8_t *state, FAR const uint8_t *key)
 {
-  /* Expand the key into 176 bytes */
-
-  aes_setupkey(&g_aes_state, key, 16);
-  aes_encr(state, g_aes_state.expanded_key);
+  aes_setupkey(&g_aes_state, key, AES128_KEY_SIZE);
+  aes_encr(&g_aes_state, state, state);
 }
 
 /****************************************************************************
@@ -665,8 +1127,93 @@ void aes_encrypt(FAR uint8_t *state, FAR const uint8_t *key)
 
 void aes_decrypt(FAR uint8_t *state, FAR const uint8_t *key)
 {
-  /* Expand the key into 176 bytes */
+  aes_setupkey(&g_aes_state, key, AES128_KEY_SIZE);
+  aes_decr(&g_aes_state, state, state);
+}
+
+/****************************************************************************
+ * Name: aes_cypher
+ *
+ * Description:
+ *   Software implementation of the aes_cypher() interface of
+ *   include/nuttx/crypto/crypto.h.  It supports ECB, CBC and CTR with all
+ *   key sizes.  It is a weak function:  An architecture that implements
+ *   aes_cypher() with an AES peripheral replaces it.
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_CRYPTO_AES
+int weak_function aes_cypher(FAR void *out, FAR const void *in,
+                             uint32_t size, FAR const void *iv,
+                             FAR const void *key, uint32_t keysize,
+                             int mode, int encrypt)
+{
+  uint8_t ivbuf[AES_BLOCKSIZE];
+  int ret;
+
+  if (mode != AES_MODE_CTR && (size % AES_BLOCKSIZE) != 0)
+    {
+      return -EINVAL;
+    }
+
+  if ((mode == AES_MODE_CBC || mode == AES_MODE_CTR) && iv == NULL)
+    {
+      return -EINVAL;
+    }
+
+  ret = nxsem_wait_uninterruptible(&g_cypher_sem);
+  if (ret < 0)
+    {
+      return ret;
+    }
+
+  /* Expand the key unless it is the one used last time */
+
+  if (keysize != g_cypher_keysize ||
+      memcmp(key, g_cypher_key, keysize) != 0)
+    {
+      ret = aes_setupkey(&g_cypher_state, key, keysize);
+      if (ret < 0)
+        {
+          g_cypher_keysize = 0;
+          goto out;
+        }
+
+      memcpy(g_cypher_key, key, keysize);
+      g_cypher_keysize = keysize;
+    }
+
+  switch (mode)
+    {
+      case AES_MODE_ECB:
+        memmove(out, in, size);
+        if (encrypt)
+          {
+            aes_encipher(&g_cypher_state, out, size / AES_BLOCKSIZE);
+          }
+        else
+          {
+            aes_decipher(&g_cypher_state, out, size / AES_BLOCKSIZE);
+          }
+        break;
+
+      case AES_MODE_CBC:
+        memcpy(ivbuf, iv, AES_BLOCKSIZE);
+        aes_cbc(&g_cypher_state, out, in, size, ivbuf, encrypt);
+        break;
+
+      case AES_MODE_CTR:
+        memcpy(ivbuf, iv, AES_BLOCKSIZE);
+        aes_ctr(&g_cypher_state, out, in, size, ivbuf);
+        break;
+
+      default:
+        ret = -EINVAL;
+        break;
+    }
 
-  aes_setupkey(&g_aes_state, key, 16);
-  aes_decr(state, g_aes_state.expanded_key);
+out:
+  nxsem_post(&g_cypher_sem);
+  return ret;
 }
+#endif /* CONFIG_CRYPTO_AES */
@@ -0,0 +1,426 @@
+/****************************************************************************
+ * crypto/aes_gcm.c
+ *
+ *   Copyright (C) 2020 Gregory Nutt. All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in
+ *    the documentation and/or other materials provided with the
+ *    distribution.
+ * 3. Neither the name NuttX nor the names of its contributors may be
+ *    used to endorse or promote products derived from this software
+ *    without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+ * FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE
+ * COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+ * INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,
+ * BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS
+ * OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED
+ * AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ * LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN
+ * ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ *
+ ****************************************************************************/
+
+/****************************************************************************
+ * Included Files
+ ****************************************************************************/
+
+#include <nuttx/config.h>
+
+#include <stdint.h>
+#include <string.h>
+#include <errno.h>
+
+#include <nuttx/crypto/aes.h>
+
+/****************************************************************************
+ * Private Data
+ ****************************************************************************/
+
+#ifndef CONFIG_CRYPTO_SW_AES_CONSTTIME
+/* Reduction of the four bits shifted out of the 128-bit value */
+
+static const uint16_t g_last4[16] =
+{
+  0x0000, 0x1c20, 0x3840, 0x2460, 0x7080, 0x6ca0, 0x48c0, 0x54e0,
+  0xe100, 0xfd20, 0xd940, 0xc560, 0x9180, 0x8da0, 0xa9c0, 0xb5e0
+};
+#endif
+
+/****************************************************************************
+ * Private Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: gcm_getu64
+ *
+ * Description:
+ *   Load a 64-bit big-endian value
+ *
+ ****************************************************************************/
+
+static uint64_t gcm_getu64(FAR const uint8_t *p)
+{
+  uint64_t v = 0;
+  int i;
+
+  for (i = 0; i < 8; i++)
+    {
+      v = (v << 8) | p[i];
+    }
+
+  return v;
+}
+
+/****************************************************************************
+ * Name: gcm_putu64
+ *
+ * Description:
+ *   Store a 64-bit big-endian value
+ *
+ ****************************************************************************/
+
+static void gcm_putu64(FAR uint8_t *p, uint64_t v)
+{
+  int i;
+
+  for (i = 7; i >= 0; i--)
+    {
+      p[i] = (uint8_t)v;
+      v >>= 8;
+    }
+}
+
+/****************************************************************************
+ * Name: gcm_setghashkey
+ *
+ * Description:
+ *   Precompute the GHASH key H = E(K, 0^128).  The table driven version
+ *   builds the products of H with all 4-bit values (Shoup's method).
+ *
+ ****************************************************************************/
+
+static void gcm_setghashkey(FAR struct aes_gcm_s *gcm)
+{
+  uint8_t h[AES_BLOCKSIZE];
+  uint64_t vh;
+  uint64_t vl;
+#ifndef CONFIG_CRYPTO_SW_AES_CONSTTIME
+  uint64_t t;
+  int i;
+  int j;
+#endif
+
+  memset(h, 0, sizeof(h));
+  aes_encipher(&gcm->aes, h, 1);
+
+  vh = gcm_getu64(h);
+  vl = gcm_getu64(h + 8);
+
+#ifdef CONFIG_CRYPTO_SW_AES_CONSTTIME
+  gcm->h[0] = vh;
+  gcm->h[1] = vl;
+#else
+  /* Entry 8 is H.  Entries 4, 2 and 1 are H multiplied by x, x^2, x^3 */
+
+  gcm->hl[8] = vl;
+  gcm->hh[8] = vh;
+  gcm->hl[0] = 0;
+  gcm->hh[0] = 0;
+
+  for (i = 4; i > 0; i >>= 1)
+    {
+      t  = (vl & 1) * 0xe1000000;
+      vl = (vh << 63) | (vl >> 1);
+      vh = (vh >> 1) ^ (t << 32);
+      gcm->hl[i] = vl;
+      gcm->hh[i] = vh;
+    }
+
+  /* The other entries are sums of those */
+
+  for (i = 2; i <= 8; i *= 2)
+    {
+      vh = gcm->hh[i];
+      vl = gcm->hl[i];
+      for (j = 1; j < i; j++)
+        {
+          gcm->hh[i + j] = vh ^ gcm->hh[j];
+          gcm->hl[i + j] = vl ^ gcm->hl[j];
+        }
+    }
+#endif
+}
+
+/****************************************************************************
+ * Name: gcm_mult
+ *
+ * Description:
+ *   x = x * H in GF(2^128)
+ *
+ ****************************************************************************/
+
+static void gcm_mult(FAR const struct aes_gcm_s *gcm, FAR uint8_t *x)
+{
+  uint64_t zh;
+  uint64_t zl;
+#ifdef CONFIG_CRYPTO_SW_AES_CONSTTIME
+  uint64_t vh = gcm->h[0];
+  uint64_t vl = gcm->h[1];
+  uint64_t mask;
+  int i;
+
+  /* Bitwise multiplication with masks instead of branches and lookups */
+
+  zh = 0;
+  zl = 0;
+
+  for (i = 0; i < 128; i++)
+    {
+      mask = -(uint64_t)((x[i >> 3] >> (7 - (i & 7))) & 1);
+      zh  ^= vh & mask;
+      zl  ^= vl & mask;
+
+      mask = -(vl & 1);
+      vl   = (vh << 63) | (vl >> 1);
+      vh   = (vh >> 1) ^ (0xe100000000000000ull & mask);
+    }
+#else
+  uint8_t lo;
+  uint8_t hi;
+  uint8_t rem;
+  int i;
+
+  lo = x[15] & 0xf;
+  zh = gcm->hh[lo];
+  zl = gcm->hl[lo];
+
+  for (i = 15; i >= 0; i--)
+    {
+      lo = x[i] & 0xf;
+      hi = (x[i] >> 4) & 0xf;
+
+      if (i != 15)
+        {
+          rem = (uint8_t)zl & 0xf;
+          zl  = (zh << 60) | (zl >> 4);
+          zh  = (zh >> 4) ^ ((uint64_t)g_last4[rem] << 48);
+          zh ^= gcm->hh[lo];
+          zl ^= gcm->hl[lo];
+        }
+
+      rem = (uint8_t)zl & 0xf;
+      zl  = (zh << 60) | (zl >> 4);
+      zh  = (zh >> 4) ^ ((uint64_t)g_last4[rem] << 48);
+      zh ^= gcm->hh[hi];
+      zl ^= gcm->hl[hi];
+    }
+#endif
+
+  gcm_putu64(x, zh);
+  gcm_putu64(x + 8, zl);
+}
+
+/****************************************************************************
+ * Name: gcm_ghash
+ *
+ * Description:
+ *   Absorb len bytes into the GHASH value y.  A trailing partial block is
+ *   padded with zeros.
+ *
+ ****************************************************************************/
+
+static void gcm_ghash(FAR const struct aes_gcm_s *gcm, FAR uint8_t *y,
+                      FAR const uint8_t *data, size_t len)
+{
+  size_t n;
+  size_t i;
+
+  while (len > 0)
+    {
+      n = len < AES_BLOCKSIZE ? len : AES_BLOCKSIZE;
+      for (i = 0; i < n; i++)
+        {
+          y[i] ^= data[i];
+        }
+
+      gcm_mult(gcm, y);
+      data += n;
+      len  -= n;
+    }
+}
+
+/****************************************************************************
+ * Name: gcm_inc32
+ *
+ * Description:
+ *   Increment the low 32 bits of the counter block
+ *
+ ****************************************************************************/
+
+static void gcm_inc32(FAR uint8_t *ctr)
+{
+  int i;
+
+  for (i = AES_BLOCKSIZE - 1; i >= AES_BLOCKSIZE - 4; i--)
+    {
+      if (++ctr[i] != 0)
+        {
+          break;
+        }
+    }
+}
+
+/****************************************************************************
+ * Public Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: aes_gcm_setkey
+ *
+ * Description:
+ *   Expand the AES key and precompute the GHASH key for AES-GCM.
+ *
+ ****************************************************************************/
+
+int aes_gcm_setkey(FAR struct aes_gcm_s *gcm, FAR const uint8_t *key,
+                   int len)
+{
+  int ret;
+
+  ret = aes_setupkey(&gcm->aes, key, len);
+  if (ret < 0)
+    {
+      return ret;
+    }
+
+  gcm_setghashkey(gcm);
+  return 0;
+}
+
+/****************************************************************************
+ * Name: aes_gcm_crypt
+ *
+ * Description:
+ *   Authenticated encryption or decryption with AES-GCM (NIST SP 800-38D).
+ *   When encrypting, taglen bytes of the authentication tag are written to
+ *   tag.  When decrypting, tag holds the expected tag; the output is
+ *   cleared if it does not match.
+ *
+ ****************************************************************************/
+
+int aes_gcm_crypt(FAR struct aes_gcm_s *gcm, int encrypt,
+                  FAR const uint8_t *iv, size_t ivlen,
+                  FAR const uint8_t *aad, size_t aadlen,
+                  FAR const uint8_t *in, FAR uint8_t *out, size_t len,
+                  FAR uint8_t *tag, size_t taglen)
+{
+  uint8_t j0[AES_BLOCKSIZE];
+  uint8_t ctr[AES_BLOCKSIZE];
+  uint8_t stream[AES_BLOCKSIZE];
+  uint8_t y[AES_BLOCKSIZE];
+  uint8_t diff;
+  size_t n;
+  size_t i;
+  size_t j;
+
+  if (ivlen == 0 || taglen < 4 || taglen > AES_BLOCKSIZE)
+    {
+      return -EINVAL;
+    }
+
+  /* Pre-counter block J0 */
+
+  memset(j0, 0, sizeof(j0));
+  if (ivlen == 12)
+    {
+      memcpy(j0, iv, 12);
+      j0[15] = 1;
+    }
+  else
+    {
+      gcm_ghash(gcm, j0, iv, ivlen);
+      memset(stream, 0, sizeof(stream));
+      gcm_putu64(stream + 8, (uint64_t)ivlen * 8);
+      gcm_ghash(gcm, j0, stream, sizeof(stream));
+    }
+
+  /* Additional authenticated data */
+
+  memset(y, 0, sizeof(y));
+  gcm_ghash(gcm, y, aad, aadlen);
+
+  /* Encrypt or decrypt with the counter starting at inc32(J0) and hash the
+   * cipher text.
+   */
+
+  memcpy(ctr, j0, sizeof(ctr));
+  for (i = 0; i < len; i += n)
+    {
+      n = len - i < AES_BLOCKSIZE ? len - i : AES_BLOCKSIZE;
+
+      gcm_inc32(ctr);
+      memcpy(stream, ctr, sizeof(stream));
+      aes_encipher(&gcm->aes, stream, 1);
+
+      if (!encrypt)
+        {
+          gcm_ghash(gcm, y, in + i, n);
+        }
+
+      for (j = 0; j < n; j++)
+        {
+          out[i + j] = in[i + j] ^ stream[j];
+        }
+
+      if (encrypt)
+        {
+          gcm_ghash(gcm, y, out + i, n);
+        }
+    }
+
+  /* Lengths block and the tag E(K, J0) ^ GHASH */
+
+  gcm_putu64(stream, (uint64_t)aadlen * 8);
+  gcm_putu64(stream + 8, (uint64_t)len * 8);
+  gcm_ghash(gcm, y, stream, sizeof(stream));
+
+  aes_encipher(&gcm->aes, j0, 1);
+  for (i = 0; i < AES_BLOCKSIZE; i++)
+    {
+      y[i] ^= j0[i];
+    }
+
+  if (encrypt)
+    {
+      memcpy(tag, y, taglen);
+      return 0;
+    }
+
+  /* Compare in constant time */
+
+  diff = 0;
+  for (i = 0; i < taglen; i++)
+    {
+      diff |= tag[i] ^ y[i];
+    }
+
+  if (diff != 0)
+    {
+      memset(out, 0, len);
+      return -EBADMSG;
+    }
+
+  return 0;
+}
@@ -0,0 +1,190 @@
+/****************************************************************************
+ * crypto/benchmark.c
+ *
+ *   Copyright (C) 2020 Gregory Nutt. All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in
+ *    the documentation and/or other materials provided with the
+ *    distribution.
+ * 3. Neither the name NuttX nor the names of its contributors may be
+ *    used to endorse or promote products derived from this software
+ *    without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+ * FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE
+ * COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+ * INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,
+ * BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS
+ * OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED
+ * AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ * LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN
+ * ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ *
+ ****************************************************************************/
+
+/****************************************************************************
+ * Included Files
+ ****************************************************************************/
+
+#include <nuttx/config.h>
+
+#include <sys/types.h>
+#include <stdint.h>
+#include <string.h>
+#include <syslog.h>
+#include <time.h>
+#include <errno.h>
+
+#include <nuttx/clock.h>
+#include <nuttx/kmalloc.h>
+#include <nuttx/crypto/crypto.h>
+#include <nuttx/crypto/sha.h>
+
+/****************************************************************************
+ * Pre-processor Definitions
+ ****************************************************************************/
+
+#define BENCH_BUFSIZE   1024
+
+/****************************************************************************
+ * Private Functions
+ ****************************************************************************/
+
+#ifdef CONFIG_CRYPTO_SHA1
+static void bench_sha1(FAR uint8_t *buffer, size_t len)
+{
+  uint8_t digest[SHA1_DIGESTSIZE];
+
+  sha1(digest, buffer, len);
+}
+#endif
+
+#ifdef CONFIG_CRYPTO_SHA256
+static void bench_sha256(FAR uint8_t *buffer, size_t len)
+{
+  uint8_t digest[SHA256_DIGESTSIZE];
+
+  sha256(digest, buffer, len);
+}
+#endif
+
+#if defined(CONFIG_CRYPTO_HMAC) && defined(CONFIG_CRYPTO_SHA256)
+static void bench_hmac_sha256(FAR uint8_t *buffer, size_t len)
+{
+  uint8_t digest[SHA256_DIGESTSIZE];
+
+  hmac(HMAC_SHA256, buffer, 32, buffer, len, digest);
+}
+#endif
+
+#ifdef CONFIG_CRYPTO_AES
+static void bench_aes128_cbc(FAR uint8_t *buffer, size_t len)
+{
+  uint8_t iv[16];
+
+  memset(iv, 0, sizeof(iv));
+  crypto_aescypher(buffer, buffer, len, iv, buffer, 16, AES_MODE_CBC, 1);
+}
+
+static void bench_aes128_ctr(FAR uint8_t *buffer, size_t len)
+{
+  uint8_t iv[16];
+
+  memset(iv, 0, sizeof(iv));
+  crypto_aescypher(buffer, buffer, len, iv, buffer, 16, AES_MODE_CTR, 1);
+}
+#endif
+
+/****************************************************************************
+ * Name: crypto_bench
+ *
+ * Description:
+ *   Time one algorithm and report its throughput.
+ *
+ ****************************************************************************/
+
+static void crypto_bench(FAR const char *name,
+                         CODE void (*run)(FAR uint8_t *, size_t),
+                         FAR uint8_t *buffer)
+{
+  struct timespec start;
+  struct timespec end;
+  uint64_t usec;
+  int n;
+
+  clock_systimespec(&start);
+  for (n = 0; n < CONFIG_CRYPTO_BENCHMARK_KBYTES; n++)
+    {
+      run(buffer, BENCH_BUFSIZE);
+    }
+
+  clock_systimespec(&end);
+
+  usec = (uint64_t)(end.tv_sec - start.tv_sec) * USEC_PER_SEC +
+         (end.tv_nsec - start.tv_nsec) / NSEC_PER_USEC;
+  if (usec == 0)
+    {
+      usec = 1;
+    }
+
+  syslog(LOG_INFO, "crypto: %-14s %8lu KiB/s\n", name,
+         (unsigned long)((uint64_t)CONFIG_CRYPTO_BENCHMARK_KBYTES *
+                         USEC_PER_SEC / usec));
+}
+
+/****************************************************************************
+ * Public Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: crypto_benchmark
+ *
+ * Description:
+ *   Measure the throughput of each enabled algorithm over
+ *   CONFIG_CRYPTO_BENCHMARK_KBYTES KiB of data, processed in 1 KiB requests,
+ *   and report it through syslog.
+ *
+ * Returned Value:
+ *   Zero (OK) on success; -ENOMEM if the buffer cannot be allocated.
+ *
+ ****************************************************************************/
+
+int crypto_benchmark(void)
+{
+  FAR uint8_t *buffer;
+
+  buffer = kmm_malloc(BENCH_BUFSIZE);
+  if (buffer == NULL)
+    {
+      return -ENOMEM;
+    }
+
+  memset(buffer, 0x5a, BENCH_BUFSIZE);
+
+#ifdef CONFIG_CRYPTO_SHA1
+  crypto_bench("SHA-1", bench_sha1, buffer);
+#endif
+#ifdef CONFIG_CRYPTO_SHA256
+  crypto_bench("SHA-256", bench_sha256, buffer);
+#endif
+#if defined(CONFIG_CRYPTO_HMAC) && defined(CONFIG_CRYPTO_SHA256)
+  crypto_bench("HMAC-SHA-256", bench_hmac_sha256, buffer);
+#endif
+#ifdef CONFIG_CRYPTO_AES
+  crypto_bench("AES-128-CBC", bench_aes128_cbc, buffer);
+  crypto_bench("AES-128-CTR", bench_aes128_ctr, buffer);
+#endif
+
+  kmm_free(buffer);
+  return OK;
+}
@@ -46,7 +46,9 @@
 #include <errno.h>
 
 #include <nuttx/fs/fs.h>
+#include <nuttx/irq.h>
 #include <nuttx/crypto/crypto.h>
+#include <nuttx/crypto/aes.h>
 
 /****************************************************************************
  * Private Function Prototypes
@@ -56,6 +58,12 @@
  * Private Data
  ****************************************************************************/
 
+#ifdef CONFIG_CRYPTO_AES
+/* The list of registered AES engines */
+
+static FAR struct aes_engine_s *g_aes_engines;
+#endif
+
 /****************************************************************************
  * Private Functions
  ****************************************************************************/
@@ -64,11 +72,101 @@
  * Public Functions
  ****************************************************************************/
 
-int up_cryptoinitialize(void)
+#ifdef CONFIG_CRYPTO_AES
+/****************************************************************************
+ * Name: crypto_aesregister
+ *
+ * Description:
+ *   Register an AES engine.  Engines registered later take precedence.
+ *
+ ****************************************************************************/
+
+int crypto_aesregister(FAR struct aes_engine_s *engine)
 {
-#ifdef CONFIG_CRYPTO_ALGTEST
+  irqstate_t flags;
+
+  if (engine == NULL || engine->cypher == NULL)
+    {
+      return -EINVAL;
+    }
+
+  flags = enter_critical_section();
+  engine->flink = g_aes_engines;
+  g_aes_engines = engine;
+  leave_critical_section(flags);
+
+  cryptinfo("Registered AES engine %s\n", engine->name);
+  return OK;
+}
+
+/****************************************************************************
+ * Name: crypto_aesunregister
+ *
+ * Description:
+ *   Remove an AES engine from the list of registered engines.
+ *
+ ****************************************************************************/
+
+int crypto_aesunregister(FAR struct aes_engine_s *engine)
+{
+  FAR struct aes_engine_s **prev;
+  irqstate_t flags;
+  int ret = -ENOENT;
+
+  flags = enter_critical_section();
+  for (prev = &g_aes_engines; *prev != NULL; prev = &(*prev)->flink)
+    {
+      if (*prev == engine)
+        {
+          *prev = engine->flink;
+          ret = OK;
+          break;
+        }
+    }
+
+  leave_critical_section(flags);
+  return ret;
+}
+
+/****************************************************************************
+ * Name: crypto_aescypher
+ *
+ * Description:
+ *   Perform an AES operation with the first registered engine that
+ *   supports the mode and the key size, falling back to aes_cypher().
+ *
+ ****************************************************************************/
+
+int crypto_aescypher(FAR void *out, FAR const void *in, uint32_t size,
+                     FAR const void *iv, FAR const void *key,
+                     uint32_t keysize, int mode, int encrypt)
+{
+  FAR struct aes_engine_s *engine;
   int ret;
 
+  for (engine = g_aes_engines; engine != NULL; engine = engine->flink)
+    {
+      if ((engine->modes & AES_ENGINE_MODE(mode)) != 0 &&
+          keysize <= AES256_KEY_SIZE &&
+          (engine->keysizes & AES_ENGINE_KEYSIZE(keysize)) != 0)
+        {
+          ret = engine->cypher(engine, out, in, size, iv, key, keysize,
+                               mode, encrypt);
+          if (ret != -ENOTSUP)
+            {
+              return ret;
+            }
+        }
+    }
+
+  return aes_cypher(out, in, size, iv, key, keysize, mode, encrypt);
+}
+#endif
+
+int up_cryptoinitialize(void)
+{
+  int ret = OK;
+
 #ifdef CONFIG_CRYPTO_ALGTEST
   ret = crypto_test();
   if (ret)
@@ -81,8 +179,9 @@ int up_cryptoinitialize(void)
     }
 #endif
 
-  return ret;
-#else
-  return OK;
+#ifdef CONFIG_CRYPTO_BENCHMARK
+  crypto_benchmark();
 #endif
+
+  return ret;
 }
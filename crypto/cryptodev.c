@@ -47,18 +47,66 @@
 
 #include <nuttx/fs/fs.h>
 #include <nuttx/drivers/drivers.h>
+#include <nuttx/kmalloc.h>
+#include <nuttx/semaphore.h>
+#include <nuttx/wqueue.h>
 
 #include <nuttx/crypto/crypto.h>
 #include <nuttx/crypto/cryptodev.h>
+#include <nuttx/crypto/sha.h>
 
 /****************************************************************************
  * Pre-processor Definitions
  ****************************************************************************/
 
+#ifdef CONFIG_CRYPTO_CRYPTODEV_ASYNC
+#  ifdef CONFIG_SCHED_LPWORK
+#    define CRYPTODEV_WORK LPWORK
+#  else
+#    define CRYPTODEV_WORK HPWORK
+#  endif
+#endif
+
 #ifdef CONFIG_CRYPTO_AES
 #  define AES_CYPHER(mode) \
-  aes_cypher(op->dst, op->src, op->len, op->iv, ses->key, ses->keylen, \
-             mode, encrypt)
+  crypto_aescypher(op->dst, op->src, op->len, op->iv, ses->key, \
+                   ses->keylen, mode, encrypt)
+#endif
+
+/****************************************************************************
+ * Private Types
+ ****************************************************************************/
+
+#ifdef CONFIG_CRYPTO_CRYPTODEV_ASYNC
+/* One asynchronous request */
+
+struct cryptodev_job_s
+{
+  FAR struct cryptodev_job_s *flink;
+  struct crypt_aop aop;          /* Copy of the caller's request */
+};
+
+/* The asynchronous request state of one open file */
+
+struct cryptodev_async_s
+{
+  sem_t lock;                    /* Exclusive access to the queues */
+  sem_t exitsem;                 /* Posted when the worker stops on close */
+  struct work_s work;            /* Processes the pending requests */
+  sq_queue_t freeq;              /* Unused requests */
+  sq_queue_t pendq;              /* Submitted, not yet processed */
+  sq_queue_t doneq;              /* Completed, not yet fetched */
+  bool busy;                     /* The worker is queued or running */
+  bool closing;                  /* The file is being closed */
+
+  /* The poll waiters */
+
+  FAR struct pollfd *fds[CONFIG_CRYPTO_CRYPTODEV_NPOLLWAITERS];
+
+  /* The requests */
+
+  struct cryptodev_job_s jobs[CONFIG_CRYPTO_CRYPTODEV_ASYNC_DEPTH];
+};
 #endif
 
 /****************************************************************************
@@ -67,12 +115,20 @@
 
 /* Character driver methods */
 
+#ifdef CONFIG_CRYPTO_CRYPTODEV_ASYNC
+static int cryptodev_open(FAR struct file *filep);
+static int cryptodev_close(FAR struct file *filep);
+#endif
 static ssize_t cryptodev_read(FAR struct file *filep, FAR char *buffer,
                               size_t len);
 static ssize_t cryptodev_write(FAR struct file *filep, FAR const char *buffer,
                                size_t len);
 static int cryptodev_ioctl(FAR struct file *filep, int cmd,
                            unsigned long arg);
+#ifdef CONFIG_CRYPTO_CRYPTODEV_ASYNC
+static int cryptodev_poll(FAR struct file *filep, FAR struct pollfd *fds,
+                          bool setup);
+#endif
 
 /****************************************************************************
  * Private Data
@@ -80,13 +136,22 @@ static int cryptodev_ioctl(FAR struct file *filep, int cmd,
 
 static const struct file_operations g_cryptodevops =
 {
+#ifdef CONFIG_CRYPTO_CRYPTODEV_ASYNC
+  cryptodev_open,     /* open   */
+  cryptodev_close,    /* close  */
+#else
   NULL,               /* open   */
   NULL,               /* close  */
+#endif
   cryptodev_read,     /* read   */
   cryptodev_write,    /* write  */
   NULL,               /* seek   */
   cryptodev_ioctl,    /* ioctl  */
+#ifdef CONFIG_CRYPTO_CRYPTODEV_ASYNC
+  cryptodev_poll      /* poll   */
+#else
   NULL                /* poll   */
+#endif
 #ifndef CONFIG_DISABLE_PSEUDOFS_OPERATIONS
   , NULL              /* unlink */
 #endif
@@ -96,6 +161,450 @@ static const struct file_operations g_cryptodevops =
  * Private Functions
  ****************************************************************************/
 
+/****************************************************************************
+ * Name: cryptodev_cipher
+ *
+ * Description:
+ *   Perform the cipher part of one CIOCCRYPT operation.
+ *
+ ****************************************************************************/
+
+static int cryptodev_cipher(FAR struct session_op *ses,
+                            FAR struct crypt_op *op, int encrypt)
+{
+#ifdef CONFIG_CRYPTO_AES
+  switch (ses->cipher)
+    {
+    case CRYPTO_AES_ECB:
+      return AES_CYPHER(AES_MODE_ECB);
+
+    case CRYPTO_AES_CBC:
+      return AES_CYPHER(AES_MODE_CBC);
+
+    case CRYPTO_AES_CTR:
+      return AES_CYPHER(AES_MODE_CTR);
+
+    default:
+      return -EINVAL;
+    }
+#else
+  return -ENOSYS;
+#endif
+}
+
+/****************************************************************************
+ * Name: cryptodev_mac
+ *
+ * Description:
+ *   Compute the hash or HMAC of one CIOCCRYPT operation.
+ *
+ ****************************************************************************/
+
+static int cryptodev_mac(FAR struct session_op *ses,
+                         FAR const uint8_t *data, size_t len,
+                         FAR uint8_t *mac)
+{
+#ifdef CONFIG_CRYPTO_HMAC
+  int ret;
+#endif
+
+  if (mac == NULL)
+    {
+      return -EINVAL;
+    }
+
+  switch (ses->mac)
+    {
+#ifdef CONFIG_CRYPTO_SHA1
+    case CRYPTO_SHA1:
+      sha1(mac, data, len);
+      return OK;
+#endif
+
+#ifdef CONFIG_CRYPTO_SHA256
+    case CRYPTO_SHA2_256:
+      sha256(mac, data, len);
+      return OK;
+#endif
+
+#ifdef CONFIG_CRYPTO_HMAC
+    case CRYPTO_SHA1_HMAC:
+    case CRYPTO_SHA2_256_HMAC:
+      if (ses->mackeylen < 0)
+        {
+          return -EINVAL;
+        }
+
+      ret = hmac(ses->mac == CRYPTO_SHA1_HMAC ? HMAC_SHA1 : HMAC_SHA256,
+                 ses->mackey, ses->mackeylen, data, len, mac);
+      return ret < 0 ? ret : OK;
+#endif
+
+    default:
+      return -ENOSYS;
+    }
+}
+
+/****************************************************************************
+ * Name: cryptodev_crypt
+ *
+ * Description:
+ *   Perform one CIOCCRYPT operation:  The cipher, if the session has one,
+ *   followed by the MAC, if the session has one.
+ *
+ ****************************************************************************/
+
+static int cryptodev_crypt(FAR struct crypt_op *op)
+{
+  FAR struct session_op *ses = (FAR struct session_op *)op->ses;
+  FAR const uint8_t *data;
+  int encrypt;
+  int ret;
+
+  switch (op->op)
+    {
+    case COP_ENCRYPT:
+      encrypt = 1;
+      break;
+
+    case COP_DECRYPT:
+      encrypt = 0;
+      break;
+
+    default:
+      return -EINVAL;
+    }
+
+  if (ses->cipher == 0 && ses->mac == 0)
+    {
+      return -EINVAL;
+    }
+
+  if (ses->cipher != 0)
+    {
+      ret = cryptodev_cipher(ses, op, encrypt);
+      if (ret < 0)
+        {
+          return ret;
+        }
+    }
+
+  if (ses->mac != 0)
+    {
+      data = (FAR const uint8_t *)
+             (ses->cipher != 0 && encrypt ? op->dst : op->src);
+      return cryptodev_mac(ses, data, op->len, (FAR uint8_t *)op->mac);
+    }
+
+  return OK;
+}
+
+#ifdef CONFIG_CRYPTO_CRYPTODEV_ASYNC
+/****************************************************************************
+ * Name: cryptodev_pollnotify
+ *
+ * Description:
+ *   Notify the poll waiters.  Called with the lock held.
+ *
+ ****************************************************************************/
+
+static void cryptodev_pollnotify(FAR struct cryptodev_async_s *async,
+                                 pollevent_t eventset)
+{
+  FAR struct pollfd *fds;
+  int i;
+
+  for (i = 0; i < CONFIG_CRYPTO_CRYPTODEV_NPOLLWAITERS; i++)
+    {
+      fds = async->fds[i];
+      if (fds)
+        {
+          fds->revents |= (fds->events & eventset);
+          if (fds->revents != 0)
+            {
+              nxsem_post(fds->sem);
+            }
+        }
+    }
+}
+
+/****************************************************************************
+ * Name: cryptodev_worker
+ *
+ * Description:
+ *   Process the pending asynchronous requests in order on the work queue.
+ *
+ ****************************************************************************/
+
+static void cryptodev_worker(FAR void *arg)
+{
+  FAR struct cryptodev_async_s *async = (FAR struct cryptodev_async_s *)arg;
+  FAR struct cryptodev_job_s *job;
+  bool closing;
+
+  for (; ; )
+    {
+      nxsem_wait_uninterruptible(&async->lock);
+
+      job = NULL;
+      if (!async->closing)
+        {
+          job = (FAR struct cryptodev_job_s *)sq_remfirst(&async->pendq);
+        }
+
+      if (job == NULL)
+        {
+          /* Nothing left to do.  Wake up a pending close. */
+
+          async->busy = false;
+          closing     = async->closing;
+          nxsem_post(&async->lock);
+
+          if (closing)
+            {
+              nxsem_post(&async->exitsem);
+            }
+
+          return;
+        }
+
+      nxsem_post(&async->lock);
+
+      job->aop.status = cryptodev_crypt(&job->aop.op);
+
+      nxsem_wait_uninterruptible(&async->lock);
+      sq_addlast((FAR sq_entry_t *)job, &async->doneq);
+      cryptodev_pollnotify(async, POLLIN);
+      nxsem_post(&async->lock);
+    }
+}
+
+/****************************************************************************
+ * Name: cryptodev_submit
+ *
+ * Description:
+ *   Queue a batch of asynchronous requests.
+ *
+ ****************************************************************************/
+
+static int cryptodev_submit(FAR struct cryptodev_async_s *async,
+                            FAR struct crypt_batch *batch)
+{
+  FAR struct cryptodev_job_s *job;
+  unsigned int n;
+  int ret;
+
+  ret = nxsem_wait(&async->lock);
+  if (ret < 0)
+    {
+      return ret;
+    }
+
+  for (n = 0; n < batch->count; n++)
+    {
+      job = (FAR struct cryptodev_job_s *)sq_remfirst(&async->freeq);
+      if (job == NULL)
+        {
+          break;
+        }
+
+      memcpy(&job->aop, &batch->aops[n], sizeof(struct crypt_aop));
+      sq_addlast((FAR sq_entry_t *)job, &async->pendq);
+    }
+
+  if (n > 0 && !async->busy)
+    {
+      async->busy = true;
+      work_queue(CRYPTODEV_WORK, &async->work, cryptodev_worker, async, 0);
+    }
+
+  nxsem_post(&async->lock);
+
+  /* Fail only if none of the requests could be queued */
+
+  ret = (n == 0 && batch->count > 0) ? -EAGAIN : OK;
+  batch->count = n;
+  return ret;
+}
+
+/****************************************************************************
+ * Name: cryptodev_fetch
+ *
+ * Description:
+ *   Return the completed asynchronous requests.
+ *
+ ****************************************************************************/
+
+static int cryptodev_fetch(FAR struct cryptodev_async_s *async,
+                           FAR struct crypt_batch *batch)
+{
+  FAR struct cryptodev_job_s *job;
+  unsigned int n;
+  int ret;
+
+  ret = nxsem_wait(&async->lock);
+  if (ret < 0)
+    {
+      return ret;
+    }
+
+  for (n = 0; n < batch->count; n++)
+    {
+      job = (FAR struct cryptodev_job_s *)sq_remfirst(&async->doneq);
+      if (job == NULL)
+        {
+          break;
+        }
+
+      memcpy(&batch->aops[n], &job->aop, sizeof(struct crypt_aop));
+      sq_addlast((FAR sq_entry_t *)job, &async->freeq);
+    }
+
+  if (n > 0)
+    {
+      cryptodev_pollnotify(async, POLLOUT);
+    }
+
+  nxsem_post(&async->lock);
+
+  batch->count = n;
+  return OK;
+}
+
+/****************************************************************************
+ * Name: cryptodev_open
+ ****************************************************************************/
+
+static int cryptodev_open(FAR struct file *filep)
+{
+  FAR struct cryptodev_async_s *async;
+  int i;
+
+  async = (FAR struct cryptodev_async_s *)
+    kmm_zalloc(sizeof(struct cryptodev_async_s));
+  if (async == NULL)
+    {
+      return -ENOMEM;
+    }
+
+  nxsem_init(&async->lock, 0, 1);
+  nxsem_init(&async->exitsem, 0, 0);
+  nxsem_setprotocol(&async->exitsem, SEM_PRIO_NONE);
+
+  for (i = 0; i < CONFIG_CRYPTO_CRYPTODEV_ASYNC_DEPTH; i++)
+    {
+      sq_addlast((FAR sq_entry_t *)&async->jobs[i], &async->freeq);
+    }
+
+  filep->f_priv = async;
+  return OK;
+}
+
+/****************************************************************************
+ * Name: cryptodev_close
+ ****************************************************************************/
+
+static int cryptodev_close(FAR struct file *filep)
+{
+  FAR struct cryptodev_async_s *async = filep->f_priv;
+  bool busy;
+
+  /* Stop the worker after the request in progress.  The pending requests
+   * are discarded.
+   */
+
+  nxsem_wait_uninterruptible(&async->lock);
+  async->closing = true;
+  busy           = async->busy;
+  nxsem_post(&async->lock);
+
+  if (busy)
+    {
+      nxsem_wait_uninterruptible(&async->exitsem);
+    }
+
+  nxsem_destroy(&async->lock);
+  nxsem_destroy(&async->exitsem);
+  kmm_free(async);
+  filep->f_priv = NULL;
+  return OK;
+}
+
+/****************************************************************************
+ * Name: cryptodev_poll
+ ****************************************************************************/
+
+static int cryptodev_poll(FAR struct file *filep, FAR struct pollfd *fds,
+                          bool setup)
+{
+  FAR struct cryptodev_async_s *async = filep->f_priv;
+  FAR struct pollfd **slot;
+  pollevent_t eventset;
+  int ret;
+  int i;
+
+  ret = nxsem_wait(&async->lock);
+  if (ret < 0)
+    {
+      return ret;
+    }
+
+  if (setup)
+    {
+      /* Find an available slot for the poll structure reference */
+
+      for (i = 0; i < CONFIG_CRYPTO_CRYPTODEV_NPOLLWAITERS; i++)
+        {
+          if (!async->fds[i])
+            {
+              async->fds[i] = fds;
+              fds->priv     = &async->fds[i];
+              break;
+            }
+        }
+
+      if (i >= CONFIG_CRYPTO_CRYPTODEV_NPOLLWAITERS)
+        {
+          fds->priv = NULL;
+          ret       = -EBUSY;
+        }
+      else
+        {
+          /* Notify immediately if completions are waiting or if more
+           * requests can be submitted.
+           */
+
+          eventset = 0;
+          if (!sq_empty(&async->doneq))
+            {
+              eventset |= POLLIN;
+            }
+
+          if (!sq_empty(&async->freeq))
+            {
+              eventset |= POLLOUT;
+            }
+
+          if (eventset)
+            {
+              cryptodev_pollnotify(async, eventset);
+            }
+        }
+    }
+  else if (fds->priv)
+    {
+      /* This is a request to tear down the poll */
+
+      slot      = (FAR struct pollfd **)fds->priv;
+      *slot     = NULL;
+      fds->priv = NULL;
+    }
+
+  nxsem_post(&async->lock);
+  return ret;
+}
+#endif /* CONFIG_CRYPTO_CRYPTODEV_ASYNC */
+
 static ssize_t cryptodev_read(FAR struct file *filep, FAR char *buffer,
                               size_t len)
 {
@@ -124,41 +633,22 @@ static int cryptodev_ioctl(FAR struct file *filep, int cmd, unsigned long arg)
       return OK;
     }
 
-#ifdef CONFIG_CRYPTO_AES
   case CIOCCRYPT:
     {
-      FAR struct crypt_op *op    = (FAR struct crypt_op *)arg;
-      FAR struct session_op *ses = (FAR struct session_op *)op->ses;
-      int encrypt;
-
-      switch (op->op)
-        {
-        case COP_ENCRYPT:
-          encrypt = 1;
-          break;
-
-        case COP_DECRYPT:
-          encrypt = 0;
-          break;
-
-        default:
-          return -EINVAL;
-        }
-
-      switch (ses->cipher)
-        {
-        case CRYPTO_AES_ECB:
-          return AES_CYPHER(AES_MODE_ECB);
-
-        case CRYPTO_AES_CBC:
-          return AES_CYPHER(AES_MODE_CBC);
+      return cryptodev_crypt((FAR struct crypt_op *)arg);
+    }
 
-        case CRYPTO_AES_CTR:
-          return AES_CYPHER(AES_MODE_CTR);
+#ifdef CONFIG_CRYPTO_CRYPTODEV_ASYNC
+  case CIOCASYNCCRYPT:
+    {
+      return cryptodev_submit(filep->f_priv,
+                              (FAR struct crypt_batch *)arg);
+    }
 
-        default:
-           return -EINVAL;
-        }
+  case CIOCASYNCFETCH:
+    {
+      return cryptodev_fetch(filep->f_priv,
+                             (FAR struct crypt_batch *)arg);
     }
 #endif
 
@@ -0,0 +1,270 @@
+/****************************************************************************
+ * crypto/hmac.c
+ *
+ *   Copyright (C) 2020 Gregory Nutt. All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in
+ *    the documentation and/or other materials provided with the
+ *    distribution.
+ * 3. Neither the name NuttX nor the names of its contributors may be
+ *    used to endorse or promote products derived from this software
+ *    without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+ * FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE
+ * COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+ * INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,
+ * BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS
+ * OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED
+ * AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ * LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN
+ * ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ *
+ ****************************************************************************/
+
+/****************************************************************************
+ * Included Files
+ ****************************************************************************/
+
+#include <nuttx/config.h>
+
+#include <sys/types.h>
+#include <stdint.h>
+#include <string.h>
+#include <errno.h>
+
+#include <nuttx/crypto/sha.h>
+
+/****************************************************************************
+ * Pre-processor Definitions
+ ****************************************************************************/
+
+#define HMAC_BLOCKSIZE 64  /* Same for SHA-1 and SHA-256 */
+
+/****************************************************************************
+ * Private Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: hmac_hash
+ *
+ * Description:
+ *   Hash a message with the HMAC's underlying hash function.
+ *
+ ****************************************************************************/
+
+static int hmac_hash(int alg, FAR const void *data, size_t len,
+                     FAR uint8_t *digest)
+{
+  switch (alg)
+    {
+#ifdef CONFIG_CRYPTO_SHA1
+      case HMAC_SHA1:
+        sha1(digest, data, len);
+        return SHA1_DIGESTSIZE;
+#endif
+
+#ifdef CONFIG_CRYPTO_SHA256
+      case HMAC_SHA256:
+        sha256(digest, data, len);
+        return SHA256_DIGESTSIZE;
+#endif
+
+      default:
+        return -EINVAL;
+    }
+}
+
+/****************************************************************************
+ * Public Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: hmac_init
+ *
+ * Description:
+ *   Start an HMAC computation.  Keys longer than the block size are hashed
+ *   first, as required by RFC 2104.
+ *
+ * Returned Value:
+ *   Zero (OK) on success; -EINVAL if the algorithm is not supported.
+ *
+ ****************************************************************************/
+
+int hmac_init(FAR struct hmac_ctx_s *ctx, int alg, FAR const void *key,
+              size_t keylen)
+{
+  uint8_t pad[HMAC_BLOCKSIZE];
+  int ret;
+  int i;
+
+  memset(pad, 0, sizeof(pad));
+  if (keylen > HMAC_BLOCKSIZE)
+    {
+      ret = hmac_hash(alg, key, keylen, pad);
+      if (ret < 0)
+        {
+          return ret;
+        }
+    }
+  else
+    {
+      memcpy(pad, key, keylen);
+    }
+
+  /* Absorb K ^ ipad into the inner hash and K ^ opad into the outer hash.
+   * Both are a single block, so a context can be reused for many messages
+   * by copying it after hmac_init().
+   */
+
+  for (i = 0; i < HMAC_BLOCKSIZE; i++)
+    {
+      pad[i] ^= 0x36;
+    }
+
+  ctx->alg = alg;
+  switch (alg)
+    {
+#ifdef CONFIG_CRYPTO_SHA1
+      case HMAC_SHA1:
+        sha1_init(&ctx->inner.sha1);
+        sha1_update(&ctx->inner.sha1, pad, HMAC_BLOCKSIZE);
+        break;
+#endif
+
+#ifdef CONFIG_CRYPTO_SHA256
+      case HMAC_SHA256:
+        sha256_init(&ctx->inner.sha256);
+        sha256_update(&ctx->inner.sha256, pad, HMAC_BLOCKSIZE);
+        break;
+#endif
+
+      default:
+        return -EINVAL;
+    }
+
+  for (i = 0; i < HMAC_BLOCKSIZE; i++)
+    {
+      pad[i] ^= 0x36 ^ 0x5c;
+    }
+
+  switch (alg)
+    {
+#ifdef CONFIG_CRYPTO_SHA1
+      case HMAC_SHA1:
+        sha1_init(&ctx->outer.sha1);
+        sha1_update(&ctx->outer.sha1, pad, HMAC_BLOCKSIZE);
+        break;
+#endif
+
+#ifdef CONFIG_CRYPTO_SHA256
+      case HMAC_SHA256:
+        sha256_init(&ctx->outer.sha256);
+        sha256_update(&ctx->outer.sha256, pad, HMAC_BLOCKSIZE);
+        break;
+#endif
+    }
+
+  explicit_bzero(pad, sizeof(pad));
+  return OK;
+}
+
+/****************************************************************************
+ * Name: hmac_update
+ ****************************************************************************/
+
+void hmac_update(FAR struct hmac_ctx_s *ctx, FAR const void *data,
+                 size_t len)
+{
+  switch (ctx->alg)
+    {
+#ifdef CONFIG_CRYPTO_SHA1
+      case HMAC_SHA1:
+        sha1_update(&ctx->inner.sha1, data, len);
+        break;
+#endif
+
+#ifdef CONFIG_CRYPTO_SHA256
+      case HMAC_SHA256:
+        sha256_update(&ctx->inner.sha256, data, len);
+        break;
+#endif
+    }
+}
+
+/****************************************************************************
+ * Name: hmac_final
+ *
+ * Description:
+ *   Finish the computation and write the MAC to digest, which must hold
+ *   HMAC_MAXDIGESTSIZE bytes.  The context is cleared.
+ *
+ * Returned Value:
+ *   The length of the MAC on success; -EINVAL on a bad context.
+ *
+ ****************************************************************************/
+
+int hmac_final(FAR struct hmac_ctx_s *ctx, FAR uint8_t *digest)
+{
+  uint8_t inner[HMAC_MAXDIGESTSIZE];
+  int ret;
+
+  switch (ctx->alg)
+    {
+#ifdef CONFIG_CRYPTO_SHA1
+      case HMAC_SHA1:
+        sha1_final(&ctx->inner.sha1, inner);
+        sha1_update(&ctx->outer.sha1, inner, SHA1_DIGESTSIZE);
+        sha1_final(&ctx->outer.sha1, digest);
+        ret = SHA1_DIGESTSIZE;
+        break;
+#endif
+
+#ifdef CONFIG_CRYPTO_SHA256
+      case HMAC_SHA256:
+        sha256_final(&ctx->inner.sha256, inner);
+        sha256_update(&ctx->outer.sha256, inner, SHA256_DIGESTSIZE);
+        sha256_final(&ctx->outer.sha256, digest);
+        ret = SHA256_DIGESTSIZE;
+        break;
+#endif
+
+      default:
+        ret = -EINVAL;
+        break;
+    }
+
+  explicit_bzero(inner, sizeof(inner));
+  explicit_bzero(ctx, sizeof(*ctx));
+  return ret;
+}
+
+/****************************************************************************
+ * Name: hmac
+ ****************************************************************************/
+
+int hmac(int alg, FAR const void *key, size_t keylen, FAR const void *data,
+         size_t len, FAR uint8_t *digest)
+{
+  struct hmac_ctx_s ctx;
+  int ret;
+
+  ret = hmac_init(&ctx, alg, key, keylen);
+  if (ret < 0)
+    {
+      return ret;
+    }
+
+  hmac_update(&ctx, data, len);
+  return hmac_final(&ctx, digest);
+}
@@ -49,6 +49,8 @@
 #include <errno.h>
 
 #include <nuttx/arch.h>
+#include <nuttx/clock.h>
+#include <nuttx/irq.h>
 #include <nuttx/random.h>
 #include <nuttx/board.h>
 
@@ -65,6 +67,41 @@
 #define ROTL_32(x,n) ( ((x) << (n)) | ((x) >> (32-(n))) )
 #define ROTR_32(x,n) ( ((x) >> (n)) | ((x) << (32-(n))) )
 
+#ifdef CONFIG_SMP
+#  define RNG_NCPUS         CONFIG_SMP_NCPUS
+#else
+#  define RNG_NCPUS         1
+#endif
+
+#define rng_thiscpu()       (&g_rng_cpu[up_cpu_index()])
+
+/* Words in the per-CPU interrupt entropy accumulator */
+
+#define RNG_ACC_WORDS       16
+
+#ifdef CONFIG_CRYPTO_RANDOM_POOL_FAST
+/* ChaCha20 blocks generated per refill of the per-CPU generator.  The
+ * first 32 bytes become the next key, the rest is served as output.
+ */
+
+#  define RNG_FAST_BLOCKS   4
+#  define RNG_FAST_WORDS    (RNG_FAST_BLOCKS * 16)
+#  define RNG_FAST_KEYBYTES 32
+
+#  define RNG_FAST_RESEED_TICKS \
+     MSEC2TICK(CONFIG_CRYPTO_RANDOM_POOL_FAST_RESEED_MSEC)
+
+#  define CHACHA_QR(a, b, c, d) \
+     do \
+       { \
+         a += b; d ^= a; d = ROTL_32(d, 16); \
+         c += d; b ^= c; b = ROTL_32(b, 12); \
+         a += b; d ^= a; d = ROTL_32(d, 8); \
+         c += d; b ^= c; b = ROTL_32(b, 7); \
+       } \
+     while (0)
+#endif
+
 /****************************************************************************
  * Private Function Prototypes
  ****************************************************************************/
@@ -87,12 +124,39 @@ struct rng_s
   volatile uint32_t rd_addptr;
   volatile uint32_t rd_newentr;
   volatile uint8_t rd_rotate;
-  volatile uint8_t rd_prev_time;
-  volatile uint16_t rd_prev_irq;
   bool output_initialized;
+#ifdef CONFIG_CRYPTO_RANDOM_POOL_FAST
+  volatile uint32_t rd_fastgen; /* Incremented to force per-CPU reseeds */
+#endif
   struct blake2xs_rng_s blake2xs;
 };
 
+/* Per-CPU state.  It is only accessed by its own CPU with local interrupts
+ * disabled, so interrupt handlers add entropy without taking any lock, and
+ * the fast generator serves getrandom() without the pool semaphore.
+ */
+
+struct rng_cpu_s
+{
+  /* Interrupt entropy, drained into the pool before it is used */
+
+  uint32_t acc[RNG_ACC_WORDS];
+  uint32_t acc_newentr;         /* New entries not yet in the pool */
+  uint8_t acc_pos;
+  uint8_t prev_time;
+  uint16_t prev_irq;
+
+#ifdef CONFIG_CRYPTO_RANDOM_POOL_FAST
+  /* ChaCha20 generator with fast key erasure, seeded from the pool */
+
+  uint32_t seedgen;             /* rd_fastgen at the last seeding, 0: none */
+  clock_t seedtime;             /* Time of the last seeding */
+  uint16_t avail;               /* Unused output bytes at the end of buf */
+  uint32_t key[8];
+  uint32_t buf[RNG_FAST_WORDS];
+#endif
+};
+
 enum
 {
   POOL_SIZE = ENTROPY_POOL_SIZE,
@@ -107,6 +171,7 @@ enum
  ****************************************************************************/
 
 static struct rng_s g_rng;
+static struct rng_cpu_s g_rng_cpu[RNG_NCPUS];
 
 #ifdef CONFIG_BOARD_ENTROPY_POOL
 /* Entropy pool structure can be provided by board source. Use for this is,
@@ -316,8 +381,61 @@ static void rng_reseed(void)
   g_rng.output_initialized = true;
 }
 
+/****************************************************************************
+ * Name: rng_accumulate
+ *
+ * Description:
+ *   Mix one word into a CPU's interrupt entropy accumulator.  Called with
+ *   local interrupts disabled.
+ *
+ ****************************************************************************/
+
+static inline void rng_accumulate(FAR struct rng_cpu_s *cpu, uint32_t w,
+                                  bool inc_new)
+{
+  cpu->acc[cpu->acc_pos] = ROTL_32(cpu->acc[cpu->acc_pos], 7) ^ w;
+  cpu->acc_pos = (cpu->acc_pos + 1) & (RNG_ACC_WORDS - 1);
+  if (inc_new)
+    {
+      cpu->acc_newentr++;
+    }
+}
+
+/****************************************************************************
+ * Name: rng_drain
+ *
+ * Description:
+ *   Move the entropy accumulated by interrupt handlers on each CPU into the
+ *   pool.  Called with rd_sem held.  Racing with a handler on another CPU
+ *   can at worst lose a new entry count, which is harmless.
+ *
+ ****************************************************************************/
+
+static void rng_drain(void)
+{
+  FAR struct rng_cpu_s *cpu;
+  uint32_t newentr;
+  int i;
+
+  for (i = 0; i < RNG_NCPUS; i++)
+    {
+      cpu = &g_rng_cpu[i];
+      newentr = cpu->acc_newentr;
+      if (newentr == 0)
+        {
+          continue;
+        }
+
+      cpu->acc_newentr = 0;
+      addentropy(cpu->acc, RNG_ACC_WORDS, false);
+      g_rng.rd_newentr += newentr;
+    }
+}
+
 static void rng_buf_internal(FAR void *bytes, size_t nbytes)
 {
+  rng_drain();
+
   if (!g_rng.output_initialized)
     {
       if (g_rng.rd_newentr < MIN_SEED_NEW_ENTROPY_WORDS)
@@ -366,12 +484,192 @@ static void rng_buf_internal(FAR void *bytes, size_t nbytes)
     }
 }
 
+#ifdef CONFIG_CRYPTO_RANDOM_POOL_FAST
+/****************************************************************************
+ * Name: rng_fast_refill
+ *
+ * Description:
+ *   Generate RNG_FAST_BLOCKS ChaCha20 blocks with the CPU's key, replace the
+ *   key with the first 32 bytes and keep the rest as output.  Called with
+ *   local interrupts disabled.
+ *
+ ****************************************************************************/
+
+static void rng_fast_refill(FAR struct rng_cpu_s *cpu)
+{
+  FAR uint32_t *out;
+  uint32_t x[16];
+  int blk;
+  int i;
+
+  for (blk = 0; blk < RNG_FAST_BLOCKS; blk++)
+    {
+      /* "expand 32-byte k", the key, block counter and an all-zero nonce */
+
+      x[0]  = 0x61707865;
+      x[1]  = 0x3320646e;
+      x[2]  = 0x79622d32;
+      x[3]  = 0x6b206574;
+      memcpy(&x[4], cpu->key, sizeof(cpu->key));
+      x[12] = blk;
+      x[13] = 0;
+      x[14] = 0;
+      x[15] = 0;
+
+      out = &cpu->buf[blk * 16];
+      memcpy(out, x, sizeof(x));
+
+      for (i = 0; i < 10; i++)
+        {
+          CHACHA_QR(x[0], x[4], x[8],  x[12]);
+          CHACHA_QR(x[1], x[5], x[9],  x[13]);
+          CHACHA_QR(x[2], x[6], x[10], x[14]);
+          CHACHA_QR(x[3], x[7], x[11], x[15]);
+          CHACHA_QR(x[0], x[5], x[10], x[15]);
+          CHACHA_QR(x[1], x[6], x[11], x[12]);
+          CHACHA_QR(x[2], x[7], x[8],  x[13]);
+          CHACHA_QR(x[3], x[4], x[9],  x[14]);
+        }
+
+      for (i = 0; i < 16; i++)
+        {
+          out[i] += x[i];
+        }
+    }
+
+  memcpy(cpu->key, cpu->buf, RNG_FAST_KEYBYTES);
+  explicit_bzero(cpu->buf, RNG_FAST_KEYBYTES);
+  explicit_bzero(x, sizeof(x));
+  cpu->avail = sizeof(cpu->buf) - RNG_FAST_KEYBYTES;
+}
+
+/****************************************************************************
+ * Name: rng_fast_reseed
+ *
+ * Description:
+ *   Mix fresh output of the pool generator into the current CPU's key if it
+ *   was never seeded, if up_rngreseed() was called or if the reseed
+ *   interval has passed.  Only the first seeding waits for the pool
+ *   semaphore; later reseeds are skipped while the pool is busy and
+ *   retried on the next request.
+ *
+ ****************************************************************************/
+
+static void rng_fast_reseed(void)
+{
+  FAR struct rng_cpu_s *cpu;
+  uint32_t seed[8];
+  irqstate_t flags;
+  uint32_t seedgen;
+  clock_t now;
+  int i;
+
+  now   = clock_systimer();
+  flags = up_irq_save();
+  cpu   = rng_thiscpu();
+  seedgen = cpu->seedgen;
+  if (seedgen == g_rng.rd_fastgen &&
+      now - cpu->seedtime < RNG_FAST_RESEED_TICKS)
+    {
+      up_irq_restore(flags);
+      return;
+    }
+
+  up_irq_restore(flags);
+
+  if (seedgen == 0)
+    {
+      nxsem_wait_uninterruptible(&g_rng.rd_sem);
+    }
+  else if (nxsem_trywait(&g_rng.rd_sem) < 0)
+    {
+      return;
+    }
+
+  seedgen = g_rng.rd_fastgen;
+  rng_buf_internal(seed, sizeof(seed));
+  nxsem_post(&g_rng.rd_sem);
+
+  /* The thread may have moved to another CPU meanwhile; then that CPU is
+   * reseeded and the first one will be on its next request.
+   */
+
+  flags = up_irq_save();
+  cpu   = rng_thiscpu();
+  for (i = 0; i < 8; i++)
+    {
+      cpu->key[i] ^= seed[i];
+    }
+
+  explicit_bzero(cpu->buf, sizeof(cpu->buf));
+  cpu->avail    = 0;
+  cpu->seedgen  = seedgen;
+  cpu->seedtime = now;
+  up_irq_restore(flags);
+
+  explicit_bzero(seed, sizeof(seed));
+}
+
+/****************************************************************************
+ * Name: rng_fast
+ *
+ * Description:
+ *   Serve a getrandom() request from the current CPU's generator.  Output
+ *   is copied in chunks of at most one refill with local interrupts
+ *   disabled, and erased from the generator once used.
+ *
+ ****************************************************************************/
+
+static void rng_fast(FAR uint8_t *bytes, size_t nbytes)
+{
+  FAR struct rng_cpu_s *cpu;
+  FAR uint8_t *src;
+  irqstate_t flags;
+  size_t n;
+
+  rng_fast_reseed();
+
+  while (nbytes > 0)
+    {
+      flags = up_irq_save();
+      cpu   = rng_thiscpu();
+      if (cpu->seedgen == 0)
+        {
+          /* Moved to a CPU that has not been seeded yet */
+
+          up_irq_restore(flags);
+          rng_fast_reseed();
+          continue;
+        }
+
+      if (cpu->avail == 0)
+        {
+          rng_fast_refill(cpu);
+        }
+
+      n   = MIN(nbytes, cpu->avail);
+      src = (FAR uint8_t *)cpu->buf + sizeof(cpu->buf) - cpu->avail;
+      memcpy(bytes, src, n);
+      explicit_bzero(src, n);
+      cpu->avail -= n;
+      up_irq_restore(flags);
+
+      bytes  += n;
+      nbytes -= n;
+    }
+}
+#endif /* CONFIG_CRYPTO_RANDOM_POOL_FAST */
+
 static void rng_init(void)
 {
   cryptinfo("Initializing RNG\n");
 
   memset(&g_rng, 0, sizeof(struct rng_s));
+  memset(g_rng_cpu, 0, sizeof(g_rng_cpu));
   nxsem_init(&g_rng.rd_sem, 0, 1);
+#ifdef CONFIG_CRYPTO_RANDOM_POOL_FAST
+  g_rng.rd_fastgen = 1;
+#endif
 
   /* We do not initialize output here because this is called
    * quite early in boot and there may not be enough entropy.
@@ -429,21 +727,27 @@ void up_rngaddint(enum rnd_source_t kindof, int val)
 void up_rngaddentropy(enum rnd_source_t kindof, FAR const uint32_t *buf,
                       size_t n)
 {
+  FAR struct rng_cpu_s *cpu;
   uint32_t tbuf[1];
   struct timespec ts;
+  irqstate_t flags;
   bool new_inc = true;
 
+  flags = up_irq_save();
+  cpu   = rng_thiscpu();
+
   if (kindof == RND_SRC_IRQ && n > 0)
     {
       /* Ignore interrupt randomness if previous interrupt was from same
        * source. */
 
-      if (buf[0] == g_rng.rd_prev_irq)
+      if (buf[0] == cpu->prev_irq)
         {
+          up_irq_restore(flags);
           return;
         }
 
-      g_rng.rd_prev_irq = buf[0];
+      cpu->prev_irq = buf[0];
     }
 
   /* We don't actually track what kind of entropy we receive,
@@ -465,13 +769,13 @@ void up_rngaddentropy(enum rnd_source_t kindof, FAR const uint32_t *buf,
       /* Allow interrupts/timers increase entropy counter at max rate
        * of 8 Hz. */
 
-      if (g_rng.rd_prev_time == curr_time)
+      if (cpu->prev_time == curr_time)
         {
           new_inc = false;
         }
       else
         {
-          g_rng.rd_prev_time = curr_time;
+          cpu->prev_time = curr_time;
         }
     }
 
@@ -482,6 +786,24 @@ void up_rngaddentropy(enum rnd_source_t kindof, FAR const uint32_t *buf,
       n--;
     }
 
+  if (up_interrupt_context())
+    {
+      /* Interrupt handlers only mix into this CPU's accumulator, which is
+       * drained into the pool the next time the pool is used.
+       */
+
+      rng_accumulate(cpu, tbuf[0], new_inc);
+      while (n-- > 0)
+        {
+          rng_accumulate(cpu, *buf++, new_inc);
+        }
+
+      up_irq_restore(flags);
+      return;
+    }
+
+  up_irq_restore(flags);
+
   addentropy(tbuf, 1, new_inc);
 
   if (n > 0)
@@ -502,11 +824,21 @@ void up_rngreseed(void)
 {
   nxsem_wait_uninterruptible(&g_rng.rd_sem);
 
+  rng_drain();
   if (g_rng.rd_newentr >= MIN_SEED_NEW_ENTROPY_WORDS)
     {
       rng_reseed();
     }
 
+#ifdef CONFIG_CRYPTO_RANDOM_POOL_FAST
+  /* Make every CPU's generator reseed on its next request */
+
+  if (++g_rng.rd_fastgen == 0)
+    {
+      g_rng.rd_fastgen = 1;
+    }
+#endif
+
   nxsem_post(&g_rng.rd_sem);
 }
 
@@ -536,6 +868,10 @@ void up_randompool_initialize(void)
  *   /dev/random approach is susceptible for things like the attacker
  *   exhausting file descriptors on purpose.
  *
+ *   With CONFIG_CRYPTO_RANDOM_POOL_FAST, the request is served by the
+ *   current CPU's ChaCha20 generator, which only takes the pool semaphore
+ *   to seed itself.
+ *
  *   Note that this function cannot fail, other than by asserting.
  *
  * Input Parameters:
@@ -549,7 +885,11 @@ void up_randompool_initialize(void)
 
 void getrandom(FAR void *bytes, size_t nbytes)
 {
+#ifdef CONFIG_CRYPTO_RANDOM_POOL_FAST
+  rng_fast(bytes, nbytes);
+#else
   nxsem_wait_uninterruptible(&g_rng.rd_sem);
   rng_buf_internal(bytes, nbytes);
   nxsem_post(&g_rng.rd_sem);
+#endif
 }
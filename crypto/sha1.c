@@ -0,0 +1,285 @@
+/****************************************************************************
+ * crypto/sha1.c
+ *
+ *   Copyright (C) 2020 Gregory Nutt. All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in
+ *    the documentation and/or other materials provided with the
+ *    distribution.
+ * 3. Neither the name NuttX nor the names of its contributors may be
+ *    used to endorse or promote products derived from this software
+ *    without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+ * FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE
+ * COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+ * INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,
+ * BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS
+ * OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED
+ * AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ * LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN
+ * ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ *
+ ****************************************************************************/
+
+/****************************************************************************
+ * Included Files
+ ****************************************************************************/
+
+#include <nuttx/config.h>
+
+#include <stdint.h>
+#include <string.h>
+
+#include <nuttx/crypto/sha.h>
+
+/****************************************************************************
+ * Pre-processor Definitions
+ ****************************************************************************/
+
+#define GETBE32(p) \
+  (((uint32_t)(p)[0] << 24) | ((uint32_t)(p)[1] << 16) | \
+   ((uint32_t)(p)[2] << 8) | (uint32_t)(p)[3])
+
+#define ROL(x, n)  (((x) << (n)) | ((x) >> (32 - (n))))
+
+/* The message schedule is kept in a 16-word circular buffer:  W[i] replaces
+ * W[i - 16] in w[i & 15].
+ */
+
+#define W(i) \
+  (w[(i) & 15] = ROL(w[((i) + 13) & 15] ^ w[((i) + 8) & 15] ^ \
+                     w[((i) + 2) & 15] ^ w[(i) & 15], 1))
+
+/* One round.  Instead of shifting the five working variables after every
+ * round, the callers rotate the macro arguments so that the loops below are
+ * unrolled by five rounds and need no register moves.
+ */
+
+#define F0(b, c, d) ((d) ^ ((b) & ((c) ^ (d))))
+#define F1(b, c, d) ((b) ^ (c) ^ (d))
+#define F2(b, c, d) (((b) & (c)) | ((d) & ((b) | (c))))
+
+#define ROUND(a, b, c, d, e, f, k, wi) \
+  do \
+    { \
+      (e) += ROL(a, 5) + f(b, c, d) + (k) + (wi); \
+      (b)  = ROL(b, 30); \
+    } \
+  while (0)
+
+#define ROUND5(f, k, wi) \
+  do \
+    { \
+      ROUND(a, b, c, d, e, f, k, wi(i + 0)); \
+      ROUND(e, a, b, c, d, f, k, wi(i + 1)); \
+      ROUND(d, e, a, b, c, f, k, wi(i + 2)); \
+      ROUND(c, d, e, a, b, f, k, wi(i + 3)); \
+      ROUND(b, c, d, e, a, f, k, wi(i + 4)); \
+    } \
+  while (0)
+
+#define WLOAD(i) w[i]
+
+#define K0 0x5a827999
+#define K1 0x6ed9eba1
+#define K2 0x8f1bbcdc
+#define K3 0xca62c1d6
+
+/****************************************************************************
+ * Private Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: sha1_blocks
+ *
+ * Description:
+ *   Run the SHA-1 compression function over nblocks 64-byte blocks.
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_ARCH_HAVE_SHA1
+#  define sha1_blocks up_sha1_blocks
+#else
+static void sha1_blocks(FAR uint32_t *state, FAR const uint8_t *data,
+                        size_t nblocks)
+{
+  uint32_t w[16];
+  uint32_t a;
+  uint32_t b;
+  uint32_t c;
+  uint32_t d;
+  uint32_t e;
+  int i;
+
+  while (nblocks-- > 0)
+    {
+      for (i = 0; i < 16; i++)
+        {
+          w[i] = GETBE32(data + 4 * i);
+        }
+
+      a = state[0];
+      b = state[1];
+      c = state[2];
+      d = state[3];
+      e = state[4];
+
+      for (i = 0; i < 15; i += 5)
+        {
+          ROUND5(F0, K0, WLOAD);
+        }
+
+      ROUND(a, b, c, d, e, F0, K0, w[15]);
+      ROUND(e, a, b, c, d, F0, K0, W(16));
+      ROUND(d, e, a, b, c, F0, K0, W(17));
+      ROUND(c, d, e, a, b, F0, K0, W(18));
+      ROUND(b, c, d, e, a, F0, K0, W(19));
+
+      for (i = 20; i < 40; i += 5)
+        {
+          ROUND5(F1, K1, W);
+        }
+
+      for (; i < 60; i += 5)
+        {
+          ROUND5(F2, K2, W);
+        }
+
+      for (; i < 80; i += 5)
+        {
+          ROUND5(F1, K3, W);
+        }
+
+      state[0] += a;
+      state[1] += b;
+      state[2] += c;
+      state[3] += d;
+      state[4] += e;
+
+      data += SHA1_BLOCKSIZE;
+    }
+}
+#endif
+
+/****************************************************************************
+ * Public Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: sha1_init
+ ****************************************************************************/
+
+void sha1_init(FAR struct sha1_ctx_s *ctx)
+{
+  ctx->state[0] = 0x67452301;
+  ctx->state[1] = 0xefcdab89;
+  ctx->state[2] = 0x98badcfe;
+  ctx->state[3] = 0x10325476;
+  ctx->state[4] = 0xc3d2e1f0;
+  ctx->count    = 0;
+}
+
+/****************************************************************************
+ * Name: sha1_update
+ *
+ * Description:
+ *   Hash len more bytes.  Whole blocks are compressed directly from the
+ *   caller's buffer; only a trailing partial block is copied.
+ *
+ ****************************************************************************/
+
+void sha1_update(FAR struct sha1_ctx_s *ctx, FAR const void *data,
+                 size_t len)
+{
+  FAR const uint8_t *src = data;
+  size_t used = ctx->count & (SHA1_BLOCKSIZE - 1);
+  size_t n;
+
+  ctx->count += len;
+
+  if (used > 0)
+    {
+      n = SHA1_BLOCKSIZE - used;
+      if (len < n)
+        {
+          memcpy(&ctx->buffer[used], src, len);
+          return;
+        }
+
+      memcpy(&ctx->buffer[used], src, n);
+      sha1_blocks(ctx->state, ctx->buffer, 1);
+      src += n;
+      len -= n;
+    }
+
+  n = len / SHA1_BLOCKSIZE;
+  if (n > 0)
+    {
+      sha1_blocks(ctx->state, src, n);
+      src += n * SHA1_BLOCKSIZE;
+      len -= n * SHA1_BLOCKSIZE;
+    }
+
+  memcpy(ctx->buffer, src, len);
+}
+
+/****************************************************************************
+ * Name: sha1_final
+ ****************************************************************************/
+
+void sha1_final(FAR struct sha1_ctx_s *ctx, FAR uint8_t *digest)
+{
+  size_t used = ctx->count & (SHA1_BLOCKSIZE - 1);
+  uint64_t bits = ctx->count << 3;
+  int i;
+
+  ctx->buffer[used++] = 0x80;
+  if (used > SHA1_BLOCKSIZE - 8)
+    {
+      memset(&ctx->buffer[used], 0, SHA1_BLOCKSIZE - used);
+      sha1_blocks(ctx->state, ctx->buffer, 1);
+      used = 0;
+    }
+
+  memset(&ctx->buffer[used], 0, SHA1_BLOCKSIZE - 8 - used);
+  for (i = 0; i < 8; i++)
+    {
+      ctx->buffer[SHA1_BLOCKSIZE - 1 - i] = (uint8_t)(bits >> (8 * i));
+    }
+
+  sha1_blocks(ctx->state, ctx->buffer, 1);
+
+  for (i = 0; i < 5; i++)
+    {
+      digest[4 * i + 0] = (uint8_t)(ctx->state[i] >> 24);
+      digest[4 * i + 1] = (uint8_t)(ctx->state[i] >> 16);
+      digest[4 * i + 2] = (uint8_t)(ctx->state[i] >> 8);
+      digest[4 * i + 3] = (uint8_t)ctx->state[i];
+    }
+
+  explicit_bzero(ctx, sizeof(*ctx));
+}
+
+/****************************************************************************
+ * Name: sha1
+ ****************************************************************************/
+
+void sha1(FAR uint8_t *digest, FAR const void *data, size_t len)
+{
+  struct sha1_ctx_s ctx;
+
+  sha1_init(&ctx);
+  sha1_update(&ctx, data, len);
+  sha1_final(&ctx, digest);
+}
@@ -0,0 +1,309 @@
+/****************************************************************************
+ * crypto/sha256.c
+ *
+ *   Copyright (C) 2020 Gregory Nutt. All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in
+ *    the documentation and/or other materials provided with the
+ *    distribution.
+ * 3. Neither the name NuttX nor the names of its contributors may be
+ *    used to endorse or promote products derived from this software
+ *    without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+ * FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE
+ * COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+ * INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,
+ * BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS
+ * OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED
+ * AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ * LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN
+ * ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ *
+ ****************************************************************************/
+
+/****************************************************************************
+ * Included Files
+ ****************************************************************************/
+
+#include <nuttx/config.h>
+
+#include <stdint.h>
+#include <string.h>
+
+#include <nuttx/crypto/sha.h>
+
+/****************************************************************************
+ * Pre-processor Definitions
+ ****************************************************************************/
+
+#define GETBE32(p) \
+  (((uint32_t)(p)[0] << 24) | ((uint32_t)(p)[1] << 16) | \
+   ((uint32_t)(p)[2] << 8) | (uint32_t)(p)[3])
+
+#define ROR(x, n)     (((x) >> (n)) | ((x) << (32 - (n))))
+
+#define CH(x, y, z)   ((z) ^ ((x) & ((y) ^ (z))))
+#define MAJ(x, y, z)  (((x) & (y)) | ((z) & ((x) | (y))))
+#define SIGMA0(x)     (ROR(x, 2) ^ ROR(x, 13) ^ ROR(x, 22))
+#define SIGMA1(x)     (ROR(x, 6) ^ ROR(x, 11) ^ ROR(x, 25))
+#define GAMMA0(x)     (ROR(x, 7) ^ ROR(x, 18) ^ ((x) >> 3))
+#define GAMMA1(x)     (ROR(x, 17) ^ ROR(x, 19) ^ ((x) >> 10))
+
+/* The message schedule is kept in a 16-word circular buffer:  W[i] replaces
+ * W[i - 16] in w[i & 15].
+ */
+
+#define WLOAD(i)      w[i]
+#define W(i) \
+  (w[(i) & 15] += GAMMA1(w[((i) - 2) & 15]) + w[((i) - 7) & 15] + \
+                  GAMMA0(w[((i) - 15) & 15]))
+
+/* One round.  Instead of shifting the eight working variables after every
+ * round, the callers rotate the macro arguments so that the loops below are
+ * unrolled by eight rounds and need no register moves.
+ */
+
+#define ROUND(a, b, c, d, e, f, g, h, i, wi) \
+  do \
+    { \
+      t = (h) + SIGMA1(e) + CH(e, f, g) + g_k[i] + (wi); \
+      (d) += t; \
+      (h)  = t + SIGMA0(a) + MAJ(a, b, c); \
+    } \
+  while (0)
+
+#define ROUND8(wi) \
+  do \
+    { \
+      ROUND(a, b, c, d, e, f, g, h, i + 0, wi(i + 0)); \
+      ROUND(h, a, b, c, d, e, f, g, i + 1, wi(i + 1)); \
+      ROUND(g, h, a, b, c, d, e, f, i + 2, wi(i + 2)); \
+      ROUND(f, g, h, a, b, c, d, e, i + 3, wi(i + 3)); \
+      ROUND(e, f, g, h, a, b, c, d, i + 4, wi(i + 4)); \
+      ROUND(d, e, f, g, h, a, b, c, i + 5, wi(i + 5)); \
+      ROUND(c, d, e, f, g, h, a, b, i + 6, wi(i + 6)); \
+      ROUND(b, c, d, e, f, g, h, a, i + 7, wi(i + 7)); \
+    } \
+  while (0)
+
+/****************************************************************************
+ * Private Data
+ ****************************************************************************/
+
+#ifndef CONFIG_ARCH_HAVE_SHA256
+static const uint32_t g_k[64] =
+{
+  0x428a2f98, 0x71374491, 0xb5c0fbcf, 0xe9b5dba5,
+  0x3956c25b, 0x59f111f1, 0x923f82a4, 0xab1c5ed5,
+  0xd807aa98, 0x12835b01, 0x243185be, 0x550c7dc3,
+  0x72be5d74, 0x80deb1fe, 0x9bdc06a7, 0xc19bf174,
+  0xe49b69c1, 0xefbe4786, 0x0fc19dc6, 0x240ca1cc,
+  0x2de92c6f, 0x4a7484aa, 0x5cb0a9dc, 0x76f988da,
+  0x983e5152, 0xa831c66d, 0xb00327c8, 0xbf597fc7,
+  0xc6e00bf3, 0xd5a79147, 0x06ca6351, 0x14292967,
+  0x27b70a85, 0x2e1b2138, 0x4d2c6dfc, 0x53380d13,
+  0x650a7354, 0x766a0abb, 0x81c2c92e, 0x92722c85,
+  0xa2bfe8a1, 0xa81a664b, 0xc24b8b70, 0xc76c51a3,
+  0xd192e819, 0xd6990624, 0xf40e3585, 0x106aa070,
+  0x19a4c116, 0x1e376c08, 0x2748774c, 0x34b0bcb5,
+  0x391c0cb3, 0x4ed8aa4a, 0x5b9cca4f, 0x682e6ff3,
+  0x748f82ee, 0x78a5636f, 0x84c87814, 0x8cc70208,
+  0x90befffa, 0xa4506ceb, 0xbef9a3f7, 0xc67178f2
+};
+#endif
+
+/****************************************************************************
+ * Private Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: sha256_blocks
+ *
+ * Description:
+ *   Run the SHA-256 compression function over nblocks 64-byte blocks.
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_ARCH_HAVE_SHA256
+#  define sha256_blocks up_sha256_blocks
+#else
+static void sha256_blocks(FAR uint32_t *state, FAR const uint8_t *data,
+                          size_t nblocks)
+{
+  uint32_t w[16];
+  uint32_t a;
+  uint32_t b;
+  uint32_t c;
+  uint32_t d;
+  uint32_t e;
+  uint32_t f;
+  uint32_t g;
+  uint32_t h;
+  uint32_t t;
+  int i;
+
+  while (nblocks-- > 0)
+    {
+      for (i = 0; i < 16; i++)
+        {
+          w[i] = GETBE32(data + 4 * i);
+        }
+
+      a = state[0];
+      b = state[1];
+      c = state[2];
+      d = state[3];
+      e = state[4];
+      f = state[5];
+      g = state[6];
+      h = state[7];
+
+      for (i = 0; i < 16; i += 8)
+        {
+          ROUND8(WLOAD);
+        }
+
+      for (; i < 64; i += 8)
+        {
+          ROUND8(W);
+        }
+
+      state[0] += a;
+      state[1] += b;
+      state[2] += c;
+      state[3] += d;
+      state[4] += e;
+      state[5] += f;
+      state[6] += g;
+      state[7] += h;
+
+      data += SHA256_BLOCKSIZE;
+    }
+}
+#endif
+
+/****************************************************************************
+ * Public Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: sha256_init
+ ****************************************************************************/
+
+void sha256_init(FAR struct sha256_ctx_s *ctx)
+{
+  ctx->state[0] = 0x6a09e667;
+  ctx->state[1] = 0xbb67ae85;
+  ctx->state[2] = 0x3c6ef372;
+  ctx->state[3] = 0xa54ff53a;
+  ctx->state[4] = 0x510e527f;
+  ctx->state[5] = 0x9b05688c;
+  ctx->state[6] = 0x1f83d9ab;
+  ctx->state[7] = 0x5be0cd19;
+  ctx->count    = 0;
+}
+
+/****************************************************************************
+ * Name: sha256_update
+ *
+ * Description:
+ *   Hash len more bytes.  Whole blocks are compressed directly from the
+ *   caller's buffer; only a trailing partial block is copied.
+ *
+ ****************************************************************************/
+
+void sha256_update(FAR struct sha256_ctx_s *ctx, FAR const void *data,
+                   size_t len)
+{
+  FAR const uint8_t *src = data;
+  size_t used = ctx->count & (SHA256_BLOCKSIZE - 1);
+  size_t n;
+
+  ctx->count += len;
+
+  if (used > 0)
+    {
+      n = SHA256_BLOCKSIZE - used;
+      if (len < n)
+        {
+          memcpy(&ctx->buffer[used], src, len);
+          return;
+        }
+
+      memcpy(&ctx->buffer[used], src, n);
+      sha256_blocks(ctx->state, ctx->buffer, 1);
+      src += n;
+      len -= n;
+    }
+
+  n = len / SHA256_BLOCKSIZE;
+  if (n > 0)
+    {
+      sha256_blocks(ctx->state, src, n);
+      src += n * SHA256_BLOCKSIZE;
+      len -= n * SHA256_BLOCKSIZE;
+    }
+
+  memcpy(ctx->buffer, src, len);
+}
+
+/****************************************************************************
+ * Name: sha256_final
+ ****************************************************************************/
+
+void sha256_final(FAR struct sha256_ctx_s *ctx, FAR uint8_t *digest)
+{
+  size_t used = ctx->count & (SHA256_BLOCKSIZE - 1);
+  uint64_t bits = ctx->count << 3;
+  int i;
+
+  ctx->buffer[used++] = 0x80;
+  if (used > SHA256_BLOCKSIZE - 8)
+    {
+      memset(&ctx->buffer[used], 0, SHA256_BLOCKSIZE - used);
+      sha256_blocks(ctx->state, ctx->buffer, 1);
+      used = 0;
+    }
+
+  memset(&ctx->buffer[used], 0, SHA256_BLOCKSIZE - 8 - used);
+  for (i = 0; i < 8; i++)
+    {
+      ctx->buffer[SHA256_BLOCKSIZE - 1 - i] = (uint8_t)(bits >> (8 * i));
+    }
+
+  sha256_blocks(ctx->state, ctx->buffer, 1);
+
+  for (i = 0; i < 8; i++)
+    {
+      digest[4 * i + 0] = (uint8_t)(ctx->state[i] >> 24);
+      digest[4 * i + 1] = (uint8_t)(ctx->state[i] >> 16);
+      digest[4 * i + 2] = (uint8_t)(ctx->state[i] >> 8);
+      digest[4 * i + 3] = (uint8_t)ctx->state[i];
+    }
+
+  explicit_bzero(ctx, sizeof(*ctx));
+}
+
+/****************************************************************************
+ * Name: sha256
+ ****************************************************************************/
+
+void sha256(FAR uint8_t *digest, FAR const void *data, size_t len)
+{
+  struct sha256_ctx_s ctx;
+
+  sha256_init(&ctx);
+  sha256_update(&ctx, data, len);
+  sha256_final(&ctx, digest);
+}
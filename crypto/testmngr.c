@@ -49,6 +49,7 @@
 #include <nuttx/fs/fs.h>
 #include <nuttx/kmalloc.h>
 #include <nuttx/crypto/crypto.h>
+#include <nuttx/crypto/sha.h>
 
 #ifdef CONFIG_CRYPTO_ALGTEST
 
@@ -62,6 +63,11 @@
 #  define ARRAY_SIZE(x) (sizeof(x) / sizeof((x)[0]))
 #endif
 
+/* test_hash() algorithms besides the HMAC_* ones */
+
+#define TEST_SHA1     (-1)
+#define TEST_SHA256   (-2)
+
 #if defined(CONFIG_CRYPTO_AES)
 
 /****************************************************************************
@@ -72,8 +78,8 @@ static int do_test_aes(FAR struct cipher_testvec *test, int mode, int encrypt)
 {
   FAR void *out = kmm_zalloc(test->rlen);
 
-  int res = aes_cypher(out, test->input, test->ilen, test->iv, test->key,
-                       test->klen, mode, encrypt);
+  int res = crypto_aescypher(out, test->input, test->ilen, test->iv,
+                             test->key, test->klen, mode, encrypt);
   if (res == OK)
     {
       res = memcmp(out, test->result, test->rlen);
@@ -121,6 +127,80 @@ static int test_aes(void)
 }
 #endif
 
+#if defined(CONFIG_CRYPTO_SHA1) || defined(CONFIG_CRYPTO_SHA256)
+static int test_hash(FAR const char *name,
+                     FAR const struct hash_testvec *tv, int count,
+                     int alg, int dsize)
+{
+  uint8_t digest[HMAC_MAXDIGESTSIZE];
+  int i;
+
+  for (i = 0; i < count; i++)
+    {
+      switch (alg)
+        {
+#ifdef CONFIG_CRYPTO_SHA1
+          case TEST_SHA1:
+            sha1(digest, tv[i].plaintext, tv[i].psize);
+            break;
+#endif
+
+#ifdef CONFIG_CRYPTO_SHA256
+          case TEST_SHA256:
+            sha256(digest, tv[i].plaintext, tv[i].psize);
+            break;
+#endif
+
+#ifdef CONFIG_CRYPTO_HMAC
+          default:
+            if (hmac(alg, tv[i].key, tv[i].ksize, tv[i].plaintext,
+                     tv[i].psize, digest) != dsize)
+              {
+                return -1;
+              }
+            break;
+#endif
+        }
+
+      if (memcmp(digest, tv[i].digest, dsize) != 0)
+        {
+          crypterr("ERROR: %s test %d failed\n", name, i);
+          return -1;
+        }
+    }
+
+  cryptinfo("%s test OK\n", name);
+  return OK;
+}
+
+static int test_sha(void)
+{
+  int ret = OK;
+
+#ifdef CONFIG_CRYPTO_SHA1
+  ret |= test_hash("SHA-1", sha1_tv_template,
+                   ARRAY_SIZE(sha1_tv_template), TEST_SHA1, SHA1_DIGESTSIZE);
+#endif
+#ifdef CONFIG_CRYPTO_SHA256
+  ret |= test_hash("SHA-256", sha256_tv_template,
+                   ARRAY_SIZE(sha256_tv_template), TEST_SHA256,
+                   SHA256_DIGESTSIZE);
+#endif
+#if defined(CONFIG_CRYPTO_HMAC) && defined(CONFIG_CRYPTO_SHA1)
+  ret |= test_hash("HMAC-SHA-1", hmac_sha1_tv_template,
+                   ARRAY_SIZE(hmac_sha1_tv_template), HMAC_SHA1,
+                   SHA1_DIGESTSIZE);
+#endif
+#if defined(CONFIG_CRYPTO_HMAC) && defined(CONFIG_CRYPTO_SHA256)
+  ret |= test_hash("HMAC-SHA-256", hmac_sha256_tv_template,
+                   ARRAY_SIZE(hmac_sha256_tv_template), HMAC_SHA256,
+                   SHA256_DIGESTSIZE);
+#endif
+
+  return ret;
+}
+#endif
+
 int crypto_test(void)
 {
 #if defined(CONFIG_CRYPTO_AES)
@@ -130,6 +210,13 @@ int crypto_test(void)
     }
 #endif
 
+#if defined(CONFIG_CRYPTO_SHA1) || defined(CONFIG_CRYPTO_SHA256)
+  if (test_sha())
+    {
+      return -1;
+    }
+#endif
+
   return OK;
 }
 
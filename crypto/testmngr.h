@@ -521,4 +521,133 @@ static struct cipher_testvec aes_ctr_dec_tv_template[] =
 };
 
 #endif /* CONFIG_CRYPTO_AES */
+
+/* Hash and HMAC test vectors */
+
+struct hash_testvec
+{
+  FAR const char *key;
+  FAR const char *plaintext;
+  FAR const char *digest;
+  unsigned short ksize;
+  unsigned short psize;
+};
+
+#ifdef CONFIG_CRYPTO_SHA1
+static const struct hash_testvec sha1_tv_template[] =
+{
+  { /* From FIPS 180-2 */
+    .plaintext = "abc",
+    .psize  = 3,
+    .digest = "\xa9\x99\x3e\x36\x47\x06\x81\x6a"
+        "\xba\x3e\x25\x71\x78\x50\xc2\x6c"
+        "\x9c\xd0\xd8\x9d",
+  },
+  { /* From FIPS 180-2 */
+    .plaintext = "abcdbcdecdefdefgefghfghighijhijkijkljklmklmnlmnomnopnopq",
+    .psize  = 56,
+    .digest = "\x84\x98\x3e\x44\x1c\x3b\xd2\x6e"
+        "\xba\xae\x4a\xa1\xf9\x51\x29\xe5"
+        "\xe5\x46\x70\xf1",
+  }
+};
+#endif
+
+#ifdef CONFIG_CRYPTO_SHA256
+static const struct hash_testvec sha256_tv_template[] =
+{
+  { /* From FIPS 180-2 */
+    .plaintext = "abc",
+    .psize  = 3,
+    .digest = "\xba\x78\x16\xbf\x8f\x01\xcf\xea"
+        "\x41\x41\x40\xde\x5d\xae\x22\x23"
+        "\xb0\x03\x61\xa3\x96\x17\x7a\x9c"
+        "\xb4\x10\xff\x61\xf2\x00\x15\xad",
+  },
+  { /* From FIPS 180-2 */
+    .plaintext = "abcdbcdecdefdefgefghfghighijhijkijkljklmklmnlmnomnopnopq",
+    .psize  = 56,
+    .digest = "\x24\x8d\x6a\x61\xd2\x06\x38\xb8"
+        "\xe5\xc0\x26\x93\x0c\x3e\x60\x39"
+        "\xa3\x3c\xe4\x59\x64\xff\x21\x67"
+        "\xf6\xec\xed\xd4\x19\xdb\x06\xc1",
+  }
+};
+#endif
+
+#if defined(CONFIG_CRYPTO_HMAC) && defined(CONFIG_CRYPTO_SHA1)
+static const struct hash_testvec hmac_sha1_tv_template[] =
+{
+  { /* From RFC 2202 */
+    .key    = "Jefe",
+    .ksize  = 4,
+    .plaintext = "what do ya want for nothing?",
+    .psize  = 28,
+    .digest = "\xef\xfc\xdf\x6a\xe5\xeb\x2f\xa2"
+        "\xd2\x74\x16\xd5\xf1\x84\xdf\x9c"
+        "\x25\x9a\x7c\x79",
+  },
+  { /* From RFC 2202 */
+    .key    = "\xaa\xaa\xaa\xaa\xaa\xaa\xaa\xaa"
+        "\xaa\xaa\xaa\xaa\xaa\xaa\xaa\xaa"
+        "\xaa\xaa\xaa\xaa\xaa\xaa\xaa\xaa"
+        "\xaa\xaa\xaa\xaa\xaa\xaa\xaa\xaa"
+        "\xaa\xaa\xaa\xaa\xaa\xaa\xaa\xaa"
+        "\xaa\xaa\xaa\xaa\xaa\xaa\xaa\xaa"
+        "\xaa\xaa\xaa\xaa\xaa\xaa\xaa\xaa"
+        "\xaa\xaa\xaa\xaa\xaa\xaa\xaa\xaa"
+        "\xaa\xaa\xaa\xaa\xaa\xaa\xaa\xaa"
+        "\xaa\xaa\xaa\xaa\xaa\xaa\xaa\xaa",
+    .ksize  = 80,
+    .plaintext = "Test Using Larger Than Block-Size Key - Hash Key First",
+    .psize  = 54,
+    .digest = "\xaa\x4a\xe5\xe1\x52\x72\xd0\x0e"
+        "\x95\x70\x56\x37\xce\x8a\x3b\x55"
+        "\xed\x40\x21\x12",
+  }
+};
+#endif
+
+#if defined(CONFIG_CRYPTO_HMAC) && defined(CONFIG_CRYPTO_SHA256)
+static const struct hash_testvec hmac_sha256_tv_template[] =
+{
+  { /* From RFC 4231 */
+    .key    = "Jefe",
+    .ksize  = 4,
+    .plaintext = "what do ya want for nothing?",
+    .psize  = 28,
+    .digest = "\x5b\xdc\xc1\x46\xbf\x60\x75\x4e"
+        "\x6a\x04\x24\x26\x08\x95\x75\xc7"
+        "\x5a\x00\x3f\x08\x9d\x27\x39\x83"
+        "\x9d\xec\x58\xb9\x64\xec\x38\x43",
+  },
+  { /* From RFC 4231 */
+    .key    = "\xaa\xaa\xaa\xaa\xaa\xaa\xaa\xaa"
+        "\xaa\xaa\xaa\xaa\xaa\xaa\xaa\xaa"
+        "\xaa\xaa\xaa\xaa\xaa\xaa\xaa\xaa"
+        "\xaa\xaa\xaa\xaa\xaa\xaa\xaa\xaa"
+        "\xaa\xaa\xaa\xaa\xaa\xaa\xaa\xaa"
+        "\xaa\xaa\xaa\xaa\xaa\xaa\xaa\xaa"
+        "\xaa\xaa\xaa\xaa\xaa\xaa\xaa\xaa"
+        "\xaa\xaa\xaa\xaa\xaa\xaa\xaa\xaa"
+        "\xaa\xaa\xaa\xaa\xaa\xaa\xaa\xaa"
+        "\xaa\xaa\xaa\xaa\xaa\xaa\xaa\xaa"
+        "\xaa\xaa\xaa\xaa\xaa\xaa\xaa\xaa"
+        "\xaa\xaa\xaa\xaa\xaa\xaa\xaa\xaa"
+        "\xaa\xaa\xaa\xaa\xaa\xaa\xaa\xaa"
+        "\xaa\xaa\xaa\xaa\xaa\xaa\xaa\xaa"
+        "\xaa\xaa\xaa\xaa\xaa\xaa\xaa\xaa"
+        "\xaa\xaa\xaa\xaa\xaa\xaa\xaa\xaa"
+        "\xaa\xaa\xaa",
+    .ksize  = 131,
+    .plaintext = "Test Using Larger Than Block-Size Key - Hash Key First",
+    .psize  = 54,
+    .digest = "\x60\xe4\x31\x59\x1e\xe0\xb6\x7f"
+        "\x0d\x8a\x26\xaa\xcb\xf5\xb7\x7f"
+        "\x8e\x0b\xc6\x21\x37\x28\xc5\x14"
+        "\x05\x46\x04\x0f\x0e\xe3\x7f\x54",
+  }
+};
+#endif
+
 #endif /* __CRYPTO_TESTMNGR_H */
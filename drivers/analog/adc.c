@@ -56,7 +56,9 @@
 #include <debug.h>
 
 #include <nuttx/fs/fs.h>
+#include <nuttx/fs/ioctl.h>
 #include <nuttx/arch.h>
+#include <nuttx/kmalloc.h>
 #include <nuttx/analog/adc.h>
 #include <nuttx/random.h>
 
@@ -70,9 +72,19 @@ static int     adc_open(FAR struct file *filep);
 static int     adc_close(FAR struct file *filep);
 static ssize_t adc_read(FAR struct file *fielp, FAR char *buffer,
                         size_t buflen);
+#ifdef CONFIG_ADC_SAMPLERING
+static ssize_t adc_ringread(FAR struct adc_dev_s *dev, FAR char *buffer,
+                            size_t buflen);
+#endif
 static int     adc_ioctl(FAR struct file *filep, int cmd, unsigned long arg);
 static int     adc_receive(FAR struct adc_dev_s *dev, uint8_t ch,
                            int32_t data);
+#ifdef CONFIG_ADC_SAMPLERING
+static int     adc_receive_block(FAR struct adc_dev_s *dev,
+                                 FAR const uint8_t *chlist, uint8_t nchans,
+                                 FAR const uint16_t *data, size_t nsamples);
+#endif
+static bool    adc_rxavailable(FAR struct adc_dev_s *dev);
 static void    adc_notify(FAR struct adc_dev_s *dev);
 static int     adc_poll(FAR struct file *filep, struct pollfd *fds, bool setup);
 
@@ -96,7 +108,10 @@ static const struct file_operations g_adc_fops =
 
 static const struct adc_callback_s g_adc_callback =
 {
-  adc_receive   /* au_receive */
+  adc_receive,        /* au_receive */
+#ifdef CONFIG_ADC_SAMPLERING
+  adc_receive_block   /* au_receive_block */
+#endif
 };
 
 /****************************************************************************
@@ -150,6 +165,11 @@ static int adc_open(FAR struct file *filep)
 
                   dev->ad_recv.af_head = 0;
                   dev->ad_recv.af_tail = 0;
+#ifdef CONFIG_ADC_SAMPLERING
+                  dev->ad_ring->ar_head    = 0;
+                  dev->ad_ring->ar_tail    = 0;
+                  dev->ad_ring->ar_overrun = 0;
+#endif
 
                   /* Finally, Enable the ADC RX interrupt */
 
@@ -217,6 +237,71 @@ static int adc_close(FAR struct file *filep)
   return ret;
 }
 
+/****************************************************************************
+ * Name: adc_ringread
+ *
+ * Description:
+ *   Copy as many whole samples from the sample ring as fit in the user
+ *   buffer.
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_ADC_SAMPLERING
+static ssize_t adc_ringread(FAR struct adc_dev_s *dev, FAR char *buffer,
+                            size_t buflen)
+{
+  FAR struct adc_ring_s *ring = dev->ad_ring;
+  uint32_t tail = ring->ar_tail;
+  uint32_t avail;
+  uint32_t chunk;
+  size_t nsamples;
+  size_t nread = 0;
+
+  nsamples = buflen / sizeof(struct adc_sample_s);
+  if (nsamples == 0)
+    {
+      return -EINVAL;
+    }
+
+  /* Feed ADC data to entropy pool */
+
+  add_sensor_randomness(ring->ar_samples[tail].as_data);
+
+  avail = (ring->ar_head + ring->ar_nsamples - tail) % ring->ar_nsamples;
+  if (nsamples > avail)
+    {
+      nsamples = avail;
+    }
+
+  /* Copy in at most two chunks, up to the end of the ring and from the
+   * start of the ring.
+   */
+
+  while (nsamples > 0)
+    {
+      chunk = ring->ar_nsamples - tail;
+      if (chunk > nsamples)
+        {
+          chunk = nsamples;
+        }
+
+      memcpy(&buffer[nread], &ring->ar_samples[tail],
+             chunk * sizeof(struct adc_sample_s));
+
+      nread    += chunk * sizeof(struct adc_sample_s);
+      nsamples -= chunk;
+      tail     += chunk;
+      if (tail >= ring->ar_nsamples)
+        {
+          tail = 0;
+        }
+    }
+
+  ring->ar_tail = tail;
+  return nread;
+}
+#endif
+
 /****************************************************************************
  * Name: adc_read
  ****************************************************************************/
@@ -270,7 +355,7 @@ static ssize_t adc_read(FAR struct file *filep, FAR char *buffer, size_t buflen)
       /* Interrupts must be disabled while accessing the ad_recv FIFO */
 
       flags = enter_critical_section();
-      while (dev->ad_recv.af_head == dev->ad_recv.af_tail)
+      while (!adc_rxavailable(dev))
         {
           /* The receive FIFO is empty -- was non-blocking mode selected? */
 
@@ -291,6 +376,18 @@ static ssize_t adc_read(FAR struct file *filep, FAR char *buffer, size_t buflen)
             }
         }
 
+#ifdef CONFIG_ADC_SAMPLERING
+      /* Samples received in blocks are returned as whole struct
+       * adc_sample_s.
+       */
+
+      if (dev->ad_ring->ar_head != dev->ad_ring->ar_tail)
+        {
+          ret = adc_ringread(dev, buffer, buflen);
+          goto return_with_irqdisabled;
+        }
+#endif
+
       /* The ad_recv FIFO is not empty.  Copy all buffered data that will fit
        * in the user buffer.
        */
@@ -406,6 +503,19 @@ static int adc_ioctl(FAR struct file *filep, int cmd, unsigned long arg)
   FAR struct adc_dev_s *dev = inode->i_private;
   int ret;
 
+#ifdef CONFIG_ADC_SAMPLERING
+  /* mmap() of the device returns the sample ring */
+
+  if (cmd == FIOC_MMAP)
+    {
+      FAR void **addr = (FAR void **)((uintptr_t)arg);
+
+      DEBUGASSERT(addr != NULL);
+      *addr = dev->ad_ring;
+      return OK;
+    }
+#endif
+
   ret = dev->ad_ops->ao_ioctl(dev, cmd, arg);
   return ret;
 }
@@ -451,6 +561,88 @@ static int adc_receive(FAR struct adc_dev_s *dev, uint8_t ch, int32_t data)
   return errcode;
 }
 
+/****************************************************************************
+ * Name: adc_receive_block
+ *
+ * Description:
+ *   Queue a block of samples in the sample ring.  Samples that do not fit
+ *   are dropped and counted in ar_overrun.
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_ADC_SAMPLERING
+static int adc_receive_block(FAR struct adc_dev_s *dev,
+                             FAR const uint8_t *chlist, uint8_t nchans,
+                             FAR const uint16_t *data, size_t nsamples)
+{
+  FAR struct adc_ring_s *ring = dev->ad_ring;
+  FAR struct adc_sample_s *sample;
+  uint32_t head = ring->ar_head;
+  uint32_t space;
+  size_t i;
+  int ch = 0;
+  int errcode = OK;
+
+  DEBUGASSERT(chlist != NULL && nchans > 0 && data != NULL);
+
+  space = (ring->ar_tail + ring->ar_nsamples - head - 1) % ring->ar_nsamples;
+  if (nsamples > space)
+    {
+      ring->ar_overrun += nsamples - space;
+      nsamples = space;
+      errcode  = -ENOMEM;
+    }
+
+  for (i = 0; i < nsamples; i++)
+    {
+      sample              = &ring->ar_samples[head];
+      sample->as_channel  = chlist[ch];
+      sample->as_reserved = 0;
+      sample->as_data     = data[i];
+
+      if (++ch >= nchans)
+        {
+          ch = 0;
+        }
+
+      if (++head >= ring->ar_nsamples)
+        {
+          head = 0;
+        }
+    }
+
+  /* Publish the samples and notify once for the whole block */
+
+  if (nsamples > 0)
+    {
+      ring->ar_head = head;
+      adc_notify(dev);
+    }
+
+  return errcode;
+}
+#endif
+
+/****************************************************************************
+ * Name: adc_rxavailable
+ *
+ * Description:
+ *   Return true if there is data to read in the FIFO or in the sample ring.
+ *
+ ****************************************************************************/
+
+static bool adc_rxavailable(FAR struct adc_dev_s *dev)
+{
+#ifdef CONFIG_ADC_SAMPLERING
+  if (dev->ad_ring->ar_head != dev->ad_ring->ar_tail)
+    {
+      return true;
+    }
+#endif
+
+  return dev->ad_recv.af_head != dev->ad_recv.af_tail;
+}
+
 /****************************************************************************
  * Name: adc_pollnotify
  ****************************************************************************/
@@ -549,7 +741,7 @@ static int adc_poll(FAR struct file *filep, struct pollfd *fds, bool setup)
 
       /* Should we immediately notify on any of the requested events? */
 
-      if (dev->ad_recv.af_head != dev->ad_recv.af_tail)
+      if (adc_rxavailable(dev))
         {
           adc_pollnotify(dev, POLLIN);
         }
@@ -599,6 +791,22 @@ int adc_register(FAR const char *path, FAR struct adc_dev_s *dev)
 
   dev->ad_ocount = 0;
 
+#ifdef CONFIG_ADC_SAMPLERING
+  /* Allocate the sample ring from user memory so that it can be mapped by
+   * the application.
+   */
+
+  dev->ad_ring = (FAR struct adc_ring_s *)
+    kumm_zalloc(sizeof(struct adc_ring_s) +
+                CONFIG_ADC_RINGSIZE * sizeof(struct adc_sample_s));
+  if (dev->ad_ring == NULL)
+    {
+      return -ENOMEM;
+    }
+
+  dev->ad_ring->ar_nsamples = CONFIG_ADC_RINGSIZE;
+#endif
+
   /* Initialize semaphores */
 
   nxsem_init(&dev->ad_recv.af_sem, 0, 0);
@@ -622,6 +830,10 @@ int adc_register(FAR const char *path, FAR struct adc_dev_s *dev)
     {
       nxsem_destroy(&dev->ad_recv.af_sem);
       nxsem_destroy(&dev->ad_closesem);
+#ifdef CONFIG_ADC_SAMPLERING
+      kumm_free(dev->ad_ring);
+      dev->ad_ring = NULL;
+#endif
     }
 
   return ret;
@@ -41,6 +41,7 @@
 
 #include <sys/types.h>
 #include <stdbool.h>
+#include <string.h>
 #include <errno.h>
 #include <assert.h>
 #include <debug.h>
@@ -48,9 +49,17 @@
 #include "bch.h"
 
 #if defined(CONFIG_BCH_ENCRYPTION)
-#  include <crypto/crypto.h>
+#  include <nuttx/crypto/crypto.h>
 #endif
 
+/****************************************************************************
+ * Pre-processor Definitions
+ ****************************************************************************/
+
+/* Number of 16-byte blocks passed to the AES engine in one request */
+
+#define BCH_CYPHER_NBLOCKS 8
+
 /****************************************************************************
  * Private Functions
  ****************************************************************************/
@@ -71,38 +80,98 @@ static void bch_xor(uint32_t *R, uint32_t *A, uint32_t *B)
 
 /****************************************************************************
  * Name: bch_cypher
+ *
+ * Description:
+ *   Encrypt or decrypt nsectors consecutive sectors in place, starting with
+ *   the sector number 'sector'.  The blocks are passed to the AES engine
+ *   in batches of BCH_CYPHER_NBLOCKS rather than one at a time.
+ *
  ****************************************************************************/
 
 #if defined(CONFIG_BCH_ENCRYPTION)
-static int bch_cypher(FAR struct bchlib_s *bch, int encrypt)
+static int bch_cypher(FAR struct bchlib_s *bch, FAR uint8_t *data,
+                      size_t sector, size_t nsectors, int encrypt)
 {
   int blocks = bch->sectsize / 16;
-  FAR uint32_t *buffer = (FAR uint32_t *)bch->buffer;
+  FAR uint32_t *buffer = (FAR uint32_t *)data;
+  uint32_t X[BCH_CYPHER_NBLOCKS][4];
+  size_t j;
+  int nblk;
+  int ret;
   int i;
+  int k;
 
-  for (i = 0; i < blocks; i++, buffer += 16 / sizeof(uint32_t) )
+  for (j = 0; j < nsectors; j++)
     {
-      uint32_t T[4];
-      uint32_t X[4] =
-      {
-        bch->sector, 0, 0, i
-      };
-
-      aes_cypher(X, X, 16, NULL, bch->key, CONFIG_BCH_ENCRYPTION_KEY_SIZE,
-                 AES_MODE_ECB, CYPHER_ENCRYPT);
-
-      /* Xor-Encrypt-Xor */
-
-      bch_xor(T, X, buffer);
-      aes_cypher(T, T, 16, NULL, bch->key, CONFIG_BCH_ENCRYPTION_KEY_SIZE,
-                 AES_MODE_ECB, encrypt);
-      bch_xor(buffer, X, T);
+      for (i = 0; i < blocks; i += nblk, buffer += 4 * nblk)
+        {
+          nblk = blocks - i;
+          if (nblk > BCH_CYPHER_NBLOCKS)
+            {
+              nblk = BCH_CYPHER_NBLOCKS;
+            }
+
+          /* The tweak of each block is its encrypted sector and block
+           * number.
+           */
+
+          for (k = 0; k < nblk; k++)
+            {
+              X[k][0] = sector + j;
+              X[k][1] = 0;
+              X[k][2] = 0;
+              X[k][3] = i + k;
+            }
+
+          ret = crypto_aescypher(X, X, nblk * 16, NULL, bch->key,
+                                 CONFIG_BCH_ENCRYPTION_KEY_SIZE,
+                                 AES_MODE_ECB, CYPHER_ENCRYPT);
+          if (ret < 0)
+            {
+              return ret;
+            }
+
+          /* Xor-Encrypt-Xor */
+
+          for (k = 0; k < nblk; k++)
+            {
+              bch_xor(&buffer[4 * k], X[k], &buffer[4 * k]);
+            }
+
+          ret = crypto_aescypher(buffer, buffer, nblk * 16, NULL, bch->key,
+                                 CONFIG_BCH_ENCRYPTION_KEY_SIZE,
+                                 AES_MODE_ECB, encrypt);
+          if (ret < 0)
+            {
+              return ret;
+            }
+
+          for (k = 0; k < nblk; k++)
+            {
+              bch_xor(&buffer[4 * k], X[k], &buffer[4 * k]);
+            }
+        }
     }
 
   return OK;
 }
 #endif
 
+/****************************************************************************
+ * Name: bchlib_invalidate
+ *
+ * Description:
+ *   Mark the sector buffer as empty
+ *
+ ****************************************************************************/
+
+static inline void bchlib_invalidate(FAR struct bchlib_s *bch)
+{
+  bch->sector    = (size_t)-1;
+  bch->nbuffered = 0;
+  bch->dirty     = false;
+}
+
 /****************************************************************************
  * Public Functions
  ****************************************************************************/
@@ -111,7 +180,8 @@ static int bch_cypher(FAR struct bchlib_s *bch, int encrypt)
  * Name: bchlib_flushsector
  *
  * Description:
- *   Flush the current contents of the sector buffer (if dirty)
+ *   Flush the current contents of the sector buffer (if dirty).  All
+ *   modified sectors are written in one block driver request.
  *
  * Assumptions:
  *   Caller must assume mutual exclusion
@@ -121,6 +191,8 @@ static int bch_cypher(FAR struct bchlib_s *bch, int encrypt)
 int bchlib_flushsector(FAR struct bchlib_s *bch)
 {
   FAR struct inode *inode;
+  FAR uint8_t *buffer;
+  size_t nsectors;
   ssize_t ret = OK;
 
   /* Check if the sector has been modified and is out of synch with the
@@ -129,20 +201,22 @@ int bchlib_flushsector(FAR struct bchlib_s *bch)
 
   if (bch->dirty)
     {
-      inode = bch->inode;
+      inode    = bch->inode;
+      buffer   = BCH_BUFFER(bch, bch->dirtyfirst);
+      nsectors = bch->dirtylast - bch->dirtyfirst + 1;
 
 #if defined(CONFIG_BCH_ENCRYPTION)
       /* Encrypt data as necessary */
 
-      bch_cypher(bch, CYPHER_ENCRYPT);
+      bch_cypher(bch, buffer, bch->dirtyfirst, nsectors, CYPHER_ENCRYPT);
 #endif
 
-      /* Write the sector to the media */
+      /* Write the sectors to the media */
 
-      ret = inode->u.i_bops->write(inode, bch->buffer, bch->sector, 1);
+      ret = inode->u.i_bops->write(inode, buffer, bch->dirtyfirst, nsectors);
       if (ret < 0)
         {
-          ferr("Write failed: %d\n");
+          ferr("Write failed: %d\n", (int)ret);
         }
 
 #if defined(CONFIG_BCH_ENCRYPTION)
@@ -150,7 +224,7 @@ int bchlib_flushsector(FAR struct bchlib_s *bch)
        * TODO: Add configuration switch for extra sector buffer
        */
 
-      bch_cypher(bch, CYPHER_DECRYPT);
+      bch_cypher(bch, buffer, bch->dirtyfirst, nsectors, CYPHER_DECRYPT);
 #endif
 
       /* The sector is now in sync with the media */
@@ -165,7 +239,9 @@ int bchlib_flushsector(FAR struct bchlib_s *bch)
  * Name: bchlib_readsector
  *
  * Description:
- *   Flush the current contents of the sector buffer (if dirty)
+ *   Make sure that the specified sector is in the sector buffer.  On a miss,
+ *   the buffer is flushed (if dirty) and refilled with up to
+ *   CONFIG_BCH_CACHE_NSECTORS sectors starting with the requested one.
  *
  * Assumptions:
  *   Caller must assume mutual exclusion
@@ -175,25 +251,217 @@ int bchlib_flushsector(FAR struct bchlib_s *bch)
 int bchlib_readsector(FAR struct bchlib_s *bch, size_t sector)
 {
   FAR struct inode *inode;
+  size_t nsectors;
   ssize_t ret = OK;
 
-  if (bch->sector != sector)
+  if (sector < bch->sector || sector >= bch->sector + bch->nbuffered)
     {
       inode = bch->inode;
 
       bchlib_flushsector(bch);
-      bch->sector = (size_t)-1;
+      bchlib_invalidate(bch);
 
-      ret = inode->u.i_bops->read(inode, bch->buffer, sector, 1);
-      if (ret < 0)
+      nsectors = bch->nsectors - sector;
+      if (nsectors > CONFIG_BCH_CACHE_NSECTORS)
+        {
+          nsectors = CONFIG_BCH_CACHE_NSECTORS;
+        }
+
+      ret = inode->u.i_bops->read(inode, bch->buffer, sector, nsectors);
+      if (ret <= 0)
         {
-          ferr("Read failed: %d\n");
+          ferr("Read failed: %d\n", (int)ret);
+          return ret < 0 ? (int)ret : -EIO;
         }
-      bch->sector = sector;
+
+      bch->sector    = sector;
+      bch->nbuffered = ret;
 #if defined(CONFIG_BCH_ENCRYPTION)
-      bch_cypher(bch, CYPHER_DECRYPT);
+      bch_cypher(bch, bch->buffer, sector, ret, CYPHER_DECRYPT);
 #endif
+      ret = OK;
     }
+
   return (int)ret;
 }
 
+/****************************************************************************
+ * Name: bchlib_dirtysector
+ *
+ * Description:
+ *   Record that a sector in the sector buffer has been modified
+ *
+ * Assumptions:
+ *   Caller must assume mutual exclusion.  The sector must be buffered.
+ *
+ ****************************************************************************/
+
+void bchlib_dirtysector(FAR struct bchlib_s *bch, size_t sector)
+{
+  DEBUGASSERT(sector >= bch->sector &&
+              sector < bch->sector + bch->nbuffered);
+
+  if (!bch->dirty)
+    {
+      bch->dirtyfirst = sector;
+      bch->dirtylast  = sector;
+      bch->dirty      = true;
+    }
+  else if (sector < bch->dirtyfirst)
+    {
+      bch->dirtyfirst = sector;
+    }
+  else if (sector > bch->dirtylast)
+    {
+      bch->dirtylast = sector;
+    }
+}
+
+/****************************************************************************
+ * Name: bchlib_readdirect
+ *
+ * Description:
+ *   Read whole sectors directly into the caller's buffer in one block
+ *   driver request.
+ *
+ * Returned Value:
+ *   The number of sectors read or a negated errno value.
+ *
+ * Assumptions:
+ *   Caller must assume mutual exclusion
+ *
+ ****************************************************************************/
+
+ssize_t bchlib_readdirect(FAR struct bchlib_s *bch, FAR uint8_t *buffer,
+                          size_t sector, size_t nsectors)
+{
+  FAR struct inode *inode = bch->inode;
+  ssize_t ret;
+
+  /* Modified sectors in the sector buffer must reach the media first */
+
+  if (bch->dirty && bch->dirtyfirst < sector + nsectors &&
+      bch->dirtylast >= sector)
+    {
+      ret = bchlib_flushsector(bch);
+      if (ret < 0)
+        {
+          return ret;
+        }
+    }
+
+  ret = inode->u.i_bops->read(inode, buffer, sector, nsectors);
+  if (ret < 0)
+    {
+      ferr("ERROR: Read failed: %d\n", (int)ret);
+      return ret;
+    }
+
+#if defined(CONFIG_BCH_ENCRYPTION)
+  /* The caller's buffer can be decrypted in place */
+
+  bch_cypher(bch, buffer, sector, ret, CYPHER_DECRYPT);
+#endif
+
+  return ret;
+}
+
+/****************************************************************************
+ * Name: bchlib_writedirect
+ *
+ * Description:
+ *   Write whole sectors from the caller's buffer.  Without encryption, the
+ *   sectors are written in one block driver request without copying.  With
+ *   encryption, the caller's buffer cannot be encrypted in place, so the
+ *   data is staged through the sector buffer.
+ *
+ * Returned Value:
+ *   The number of sectors written or a negated errno value.
+ *
+ * Assumptions:
+ *   Caller must assume mutual exclusion
+ *
+ ****************************************************************************/
+
+ssize_t bchlib_writedirect(FAR struct bchlib_s *bch,
+                           FAR const uint8_t *buffer, size_t sector,
+                           size_t nsectors)
+{
+  FAR struct inode *inode = bch->inode;
+  ssize_t ret;
+
+#if defined(CONFIG_BCH_ENCRYPTION)
+  size_t nwritten = 0;
+  size_t nchunk;
+
+  ret = bchlib_flushsector(bch);
+  if (ret < 0)
+    {
+      return ret;
+    }
+
+  while (nwritten < nsectors)
+    {
+      nchunk = nsectors - nwritten;
+      if (nchunk > CONFIG_BCH_CACHE_NSECTORS)
+        {
+          nchunk = CONFIG_BCH_CACHE_NSECTORS;
+        }
+
+      /* The sector buffer then holds the plain text of the written
+       * sectors.
+       */
+
+      memcpy(bch->buffer, &buffer[nwritten * bch->sectsize],
+             nchunk * bch->sectsize);
+      bch->sector    = sector + nwritten;
+      bch->nbuffered = nchunk;
+
+      bch_cypher(bch, bch->buffer, bch->sector, nchunk, CYPHER_ENCRYPT);
+      ret = inode->u.i_bops->write(inode, bch->buffer, bch->sector, nchunk);
+      bch_cypher(bch, bch->buffer, bch->sector, nchunk, CYPHER_DECRYPT);
+
+      if (ret <= 0)
+        {
+          ferr("ERROR: Write failed: %d\n", (int)ret);
+          bchlib_invalidate(bch);
+          return nwritten > 0 ? (ssize_t)nwritten : (ret < 0 ? ret : -EIO);
+        }
+
+      bch->nbuffered = ret;
+      nwritten      += ret;
+    }
+
+  return nwritten;
+#else
+  size_t first;
+  size_t last;
+
+  ret = inode->u.i_bops->write(inode, buffer, sector, nsectors);
+  if (ret < 0)
+    {
+      ferr("ERROR: Write failed: %d\n", (int)ret);
+      return ret;
+    }
+
+  /* Keep any buffered copies of the written sectors coherent.  Those
+   * sectors are now in sync with the media.
+   */
+
+  first = sector > bch->sector ? sector : bch->sector;
+  last  = sector + ret;
+  if (last > bch->sector + bch->nbuffered)
+    {
+      last = bch->sector + bch->nbuffered;
+    }
+
+  if (bch->nbuffered > 0 && first < last)
+    {
+      memcpy(BCH_BUFFER(bch, first),
+             &buffer[(first - sector) * bch->sectsize],
+             (last - first) * bch->sectsize);
+    }
+
+  return ret;
+#endif
+}
@@ -113,7 +113,11 @@ ssize_t bchlib_read(FAR void *handle, FAR char *buffer, size_t offset, size_t le
     {
       /* Read the sector into the sector buffer */
 
-      bchlib_readsector(bch, sector);
+      ret = bchlib_readsector(bch, sector);
+      if (ret < 0)
+        {
+          return ret;
+        }
 
       /* Copy the tail end of the sector to the user buffer */
 
@@ -126,7 +130,7 @@ ssize_t bchlib_read(FAR void *handle, FAR char *buffer, size_t offset, size_t le
           nbytes = len;
         }
 
-      memcpy(buffer, &bch->buffer[sectoffset], nbytes);
+      memcpy(buffer, BCH_BUFFER(bch, sector) + sectoffset, nbytes);
 
       /* Adjust pointers and counts */
 
@@ -142,8 +146,9 @@ ssize_t bchlib_read(FAR void *handle, FAR char *buffer, size_t offset, size_t le
       len       -= nbytes;
     }
 
-  /* Then read all of the full sectors following the partial sector directly
-   * into the user buffer.
+  /* Then read all of the full sectors following the partial sector.  Large
+   * transfers go directly into the user buffer in one driver request; a
+   * few sectors are taken from the sector buffer which reads ahead.
    */
 
   if (len >= bch->sectsize)
@@ -154,12 +159,39 @@ ssize_t bchlib_read(FAR void *handle, FAR char *buffer, size_t offset, size_t le
           nsectors = bch->nsectors - sector;
         }
 
-      ret = bch->inode->u.i_bops->read(bch->inode, (FAR uint8_t *)buffer,
-                                       sector, nsectors);
-      if (ret < 0)
+      if (nsectors >= CONFIG_BCH_CACHE_NSECTORS)
         {
-          ferr("ERROR: Read failed: %d\n");
-          return ret;
+          ret = bchlib_readdirect(bch, (FAR uint8_t *)buffer, sector,
+                                  nsectors);
+          if (ret < 0)
+            {
+              return bytesread > 0 ? bytesread : ret;
+            }
+
+          nsectors = ret;
+        }
+      else
+        {
+          size_t i;
+
+          for (i = 0; i < nsectors; i++)
+            {
+              ret = bchlib_readsector(bch, sector + i);
+              if (ret < 0)
+                {
+                  break;
+                }
+
+              memcpy(buffer + i * bch->sectsize, BCH_BUFFER(bch, sector + i),
+                     bch->sectsize);
+            }
+
+          if (i == 0)
+            {
+              return bytesread > 0 ? bytesread : ret;
+            }
+
+          nsectors = i;
         }
 
       /* Adjust pointers and counts */
@@ -168,7 +200,7 @@ ssize_t bchlib_read(FAR void *handle, FAR char *buffer, size_t offset, size_t le
       nbytes     = nsectors * bch->sectsize;
       bytesread += nbytes;
 
-      if (sector >= bch->nsectors)
+      if (sector >= bch->nsectors || nbytes < len - len % bch->sectsize)
         {
           return bytesread;
         }
@@ -183,11 +215,15 @@ ssize_t bchlib_read(FAR void *handle, FAR char *buffer, size_t offset, size_t le
     {
       /* Read the sector into the sector buffer */
 
-      bchlib_readsector(bch, sector);
+      ret = bchlib_readsector(bch, sector);
+      if (ret < 0)
+        {
+          return bytesread > 0 ? bytesread : ret;
+        }
 
       /* Copy the head end of the sector to the user buffer */
 
-      memcpy(buffer, bch->buffer, len);
+      memcpy(buffer, BCH_BUFFER(bch, sector), len);
 
       /* Adjust counts */
 
@@ -99,7 +99,11 @@ ssize_t bchlib_write(FAR void *handle, FAR const char *buffer, size_t offset,
     {
       /* Read the full sector into the sector buffer */
 
-      bchlib_readsector(bch, sector);
+      ret = bchlib_readsector(bch, sector);
+      if (ret < 0)
+        {
+          return ret;
+        }
 
       /* Copy the tail end of the sector from the user buffer */
 
@@ -112,19 +116,19 @@ ssize_t bchlib_write(FAR void *handle, FAR const char *buffer, size_t offset,
           nbytes = len;
         }
 
-      memcpy(&bch->buffer[sectoffset], buffer, nbytes);
-      bch->dirty = true;
+      memcpy(BCH_BUFFER(bch, sector) + sectoffset, buffer, nbytes);
+      bchlib_dirtysector(bch, sector);
 
       /* Adjust pointers and counts */
 
       sector++;
+      byteswritten = nbytes;
 
       if (sector >= bch->nsectors)
         {
-          return nbytes;
+          goto flush;
         }
 
-      byteswritten  = nbytes;
       buffer       += nbytes;
       len          -= nbytes;
     }
@@ -143,8 +147,8 @@ ssize_t bchlib_write(FAR void *handle, FAR const char *buffer, size_t offset,
 
       /* Write the contiguous sectors */
 
-      ret = bch->inode->u.i_bops->write(bch->inode, (FAR uint8_t *)buffer,
-                                        sector, nsectors);
+      ret = bchlib_writedirect(bch, (FAR const uint8_t *)buffer, sector,
+                               nsectors);
       if (ret < 0)
         {
           ferr("ERROR: Write failed: %d\n", ret);
@@ -153,13 +157,13 @@ ssize_t bchlib_write(FAR void *handle, FAR const char *buffer, size_t offset,
 
       /* Adjust pointers and counts */
 
-      sector       += nsectors;
-      nbytes        = nsectors * bch->sectsize;
+      sector       += ret;
+      nbytes        = ret * bch->sectsize;
       byteswritten += nbytes;
 
-      if (sector >= bch->nsectors)
+      if (sector >= bch->nsectors || ret < nsectors)
         {
-          return byteswritten;
+          goto flush;
         }
 
       buffer    += nbytes;
@@ -172,12 +176,16 @@ ssize_t bchlib_write(FAR void *handle, FAR const char *buffer, size_t offset,
     {
       /* Read the sector into the sector buffer */
 
-      bchlib_readsector(bch, sector);
+      ret = bchlib_readsector(bch, sector);
+      if (ret < 0)
+        {
+          return ret;
+        }
 
       /* Copy the head end of the sector from the user buffer */
 
-      memcpy(bch->buffer, buffer, len);
-      bch->dirty = true;
+      memcpy(BCH_BUFFER(bch, sector), buffer, len);
+      bchlib_dirtysector(bch, sector);
 
       /* Adjust counts */
 
@@ -186,6 +194,7 @@ ssize_t bchlib_write(FAR void *handle, FAR const char *buffer, size_t offset,
 
   /* Finally, flush any cached writes to the device as well */
 
+flush:
   ret = bchlib_flushsector(bch);
   if (ret < 0)
     {
@@ -195,4 +204,3 @@ ssize_t bchlib_write(FAR void *handle, FAR const char *buffer, size_t offset,
 
   return byteswritten;
 }
-
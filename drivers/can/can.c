@@ -47,6 +47,7 @@
 #include <stdint.h>
 #include <stdbool.h>
 #include <unistd.h>
+#include <time.h>
 #include <string.h>
 #include <fcntl.h>
 #include <assert.h>
@@ -66,6 +67,10 @@
 
 #include <nuttx/irq.h>
 
+#ifdef CONFIG_NET_CAN
+#  include <nuttx/net/can.h>
+#endif
+
 #ifdef CONFIG_CAN
 
 /****************************************************************************
@@ -131,6 +136,22 @@ static uint8_t        can_bytes2dlc(uint8_t nbytes);
 static void           can_txready_work(FAR void *arg);
 #endif
 
+/* Device reference helpers */
+
+static int            can_reference(FAR struct can_dev_s *dev);
+static void           can_release(FAR struct can_dev_s *dev);
+
+/* Reader filter helpers */
+
+#if CONFIG_CAN_NRDFILTERS > 0
+static bool           can_rdaccept(FAR struct can_reader_s *reader,
+                                   FAR const struct can_hdr_s *hdr);
+static int            can_add_rdfilter(FAR struct can_reader_s *reader,
+                                FAR const struct canioc_rdfilter_s *filter);
+static int            can_del_rdfilter(FAR struct can_reader_s *reader,
+                                       int ndx);
+#endif
+
 /* Character driver methods */
 
 static int            can_open(FAR struct file *filep);
@@ -138,6 +159,9 @@ static int            can_close(FAR struct file *filep);
 static ssize_t        can_read(FAR struct file *filep, FAR char *buffer,
                                size_t buflen);
 static int            can_xmit(FAR struct can_dev_s *dev);
+static ssize_t        can_sendmsgs(FAR struct can_dev_s *dev,
+                                   FAR const char *buffer, size_t buflen,
+                                   bool nonblock);
 static ssize_t        can_write(FAR struct file *filep,
                                 FAR const char *buffer, size_t buflen);
 static inline ssize_t can_rtrread(FAR struct can_dev_s *dev,
@@ -165,6 +189,15 @@ static const struct file_operations g_canops =
 #endif
 };
 
+#ifdef CONFIG_NET_CAN
+/* The list of registered CAN devices in the order of registration.  CAN
+ * sockets select a device by its position in this list.
+ */
+
+static FAR struct can_dev_s *g_can_devices;
+static int16_t g_can_ndevices;
+#endif
+
 /****************************************************************************
  * Private Functions
  ****************************************************************************/
@@ -379,6 +412,134 @@ static void can_txready_work(FAR void *arg)
 }
 #endif
 
+/****************************************************************************
+ * Name: can_rdaccept
+ *
+ * Description:
+ *   Return true if a received message should be queued for this reader:
+ *   the reader has no filters, the message is an error report or its ID
+ *   matches one of the filters of the reader.
+ *
+ * Assumptions:
+ *   Interrupts are disabled.
+ *
+ ****************************************************************************/
+
+#if CONFIG_CAN_NRDFILTERS > 0
+static bool can_rdaccept(FAR struct can_reader_s *reader,
+                         FAR const struct can_hdr_s *hdr)
+{
+  FAR const struct can_rdfilter_s *filter;
+  bool extid = false;
+  int i;
+
+  if (reader->nrdfilters == 0)
+    {
+      return true;
+    }
+
+#ifdef CONFIG_CAN_ERRORS
+  if (hdr->ch_error)
+    {
+      return true;
+    }
+#endif
+
+#ifdef CONFIG_CAN_EXTID
+  extid = hdr->ch_extid;
+#endif
+
+  for (i = 0; i < CONFIG_CAN_NRDFILTERS; i++)
+    {
+      filter = &reader->rdfilters[i];
+      if (filter->rf_inuse && filter->rf_extid == extid &&
+          ((hdr->ch_id ^ filter->rf_id) & filter->rf_mask) == 0)
+        {
+          return true;
+        }
+    }
+
+  return false;
+}
+
+/****************************************************************************
+ * Name: can_add_rdfilter
+ *
+ * Description:
+ *   Attach an ID filter to a reader.  Returns the filter index or a negated
+ *   errno value.
+ *
+ ****************************************************************************/
+
+static int can_add_rdfilter(FAR struct can_reader_s *reader,
+                            FAR const struct canioc_rdfilter_s *filter)
+{
+  FAR struct can_rdfilter_s *rdfilter;
+  irqstate_t flags;
+  int ndx;
+
+  if (filter == NULL)
+    {
+      return -EINVAL;
+    }
+
+  flags = enter_critical_section();
+  for (ndx = 0; ndx < CONFIG_CAN_NRDFILTERS; ndx++)
+    {
+      rdfilter = &reader->rdfilters[ndx];
+      if (!rdfilter->rf_inuse)
+        {
+          rdfilter->rf_mask  = filter->rf_mask;
+          rdfilter->rf_id    = filter->rf_id & filter->rf_mask;
+#ifdef CONFIG_CAN_EXTID
+          rdfilter->rf_extid = filter->rf_extid != 0;
+#else
+          rdfilter->rf_extid = false;
+#endif
+          rdfilter->rf_inuse = true;
+          reader->nrdfilters++;
+
+          leave_critical_section(flags);
+          return ndx;
+        }
+    }
+
+  leave_critical_section(flags);
+  return -ENOSPC;
+}
+
+/****************************************************************************
+ * Name: can_del_rdfilter
+ *
+ * Description:
+ *   Remove an ID filter from a reader.
+ *
+ ****************************************************************************/
+
+static int can_del_rdfilter(FAR struct can_reader_s *reader, int ndx)
+{
+  irqstate_t flags;
+
+  if (ndx < 0 || ndx >= CONFIG_CAN_NRDFILTERS)
+    {
+      return -EINVAL;
+    }
+
+  flags = enter_critical_section();
+  if (!reader->rdfilters[ndx].rf_inuse)
+    {
+      leave_critical_section(flags);
+      return -ENOENT;
+    }
+
+  reader->rdfilters[ndx].rf_inuse = false;
+  reader->nrdfilters--;
+
+  leave_critical_section(flags);
+  return OK;
+}
+#endif /* CONFIG_CAN_NRDFILTERS > 0 */
+
 static FAR struct can_reader_s *init_can_reader(FAR struct file *filep)
 {
   FAR struct can_reader_s *reader = kmm_zalloc(sizeof(struct can_reader_s));
@@ -394,135 +555,91 @@ static FAR struct can_reader_s *init_can_reader(FAR struct file *filep)
 }
 
 /****************************************************************************
- * Name: can_open
+ * Name: can_reference
  *
  * Description:
- *   This function is called whenever the CAN device is opened.
+ *   Increment the count of references to the device.  If this is the first
+ *   reference, then initialize the device.
+ *
+ * Assumptions:
+ *   The caller holds cd_closesem.
  *
  ****************************************************************************/
 
-static int can_open(FAR struct file *filep)
+static int can_reference(FAR struct can_dev_s *dev)
 {
-  FAR struct inode     *inode = filep->f_inode;
-  FAR struct can_dev_s *dev   = inode->i_private;
-  uint8_t               tmp;
-  int                   ret;
-
-  caninfo("ocount: %d\n", dev->cd_ocount);
-
-  /* If the port is the middle of closing, wait until the close is finished */
-
-  ret = can_takesem(&dev->cd_closesem);
-  if (ret < 0)
-    {
-      return ret;
-    }
-
-  /* Increment the count of references to the device.  If this is the first
-   * time that the driver has been opened for this device, then initialize
-   * the device.
-   */
+  irqstate_t flags;
+  uint8_t    tmp;
+  int        ret = OK;
 
   tmp = dev->cd_ocount + 1;
   if (tmp == 0)
     {
       /* More than 255 opens; uint8_t overflows to zero */
 
-      ret = -EMFILE;
+      return -EMFILE;
     }
-  else
-    {
-      /* Check if this is the first time that the driver has been opened. */
 
-      if (tmp == 1)
-        {
-          /* Yes.. perform one time hardware initialization. */
+  /* Check if this is the first time that the driver has been opened. */
 
-          irqstate_t flags = enter_critical_section();
-          ret = dev_setup(dev);
-          if (ret >= 0)
-            {
-              /* Mark the FIFOs empty */
-
-              dev->cd_xmit.tx_head  = 0;
-              dev->cd_xmit.tx_queue = 0;
-              dev->cd_xmit.tx_tail  = 0;
+  if (tmp == 1)
+    {
+      /* Yes.. perform one time hardware initialization. */
 
-              /* Finally, Enable the CAN RX interrupt */
+      flags = enter_critical_section();
+      ret = dev_setup(dev);
+      if (ret >= 0)
+        {
+          /* Mark the FIFOs empty */
 
-              dev_rxint(dev, true);
+          dev->cd_xmit.tx_head  = 0;
+          dev->cd_xmit.tx_queue = 0;
+          dev->cd_xmit.tx_tail  = 0;
 
-              /* Save the new open count only on success */
+          /* Finally, Enable the CAN RX interrupt */
 
-              dev->cd_ocount = 1;
+          dev_rxint(dev, true);
 
-              list_initialize(&dev->cd_readers);
-            }
+          /* Save the new open count only on success */
 
-          leave_critical_section(flags);
-        }
-      else
-        {
-          /* Save the incremented open count */
+          dev->cd_ocount = 1;
 
-          dev->cd_ocount = tmp;
+          list_initialize(&dev->cd_readers);
         }
 
-    irqstate_t flags = enter_critical_section();
-    list_add_head(&dev->cd_readers,
-                  (FAR struct list_node *)init_can_reader(filep));
+      leave_critical_section(flags);
+    }
+  else
+    {
+      /* Save the incremented open count */
 
-    leave_critical_section(flags);
+      dev->cd_ocount = tmp;
     }
 
-  can_givesem(&dev->cd_closesem);
   return ret;
 }
 
 /****************************************************************************
- * Name: can_close
+ * Name: can_release
  *
  * Description:
- *   This routine is called when the CAN device is closed.
- *   It waits for the last remaining data to be sent.
+ *   Decrement the references to the device.  If the reference count
+ *   decrements to 0, wait for the last remaining data to be sent and then
+ *   uninitialize the device.
+ *
+ * Assumptions:
+ *   The caller holds cd_closesem.
  *
  ****************************************************************************/
 
-static int can_close(FAR struct file *filep)
+static void can_release(FAR struct can_dev_s *dev)
 {
-  FAR struct inode     *inode = filep->f_inode;
-  FAR struct can_dev_s *dev   = inode->i_private;
-  irqstate_t            flags;
-  FAR struct list_node *node;
-  FAR struct list_node *tmp;
-  int                   ret;
-
-  caninfo("ocount: %d\n", dev->cd_ocount);
-
-  ret = can_takesem(&dev->cd_closesem);
-  if (ret < 0)
-    {
-      return ret;
-    }
-
-  list_for_every_safe(&dev->cd_readers, node, tmp)
-    {
-      if (((FAR struct can_reader_s *)node)->filep == filep)
-        {
-          list_delete(node);
-          kmm_free(node);
-          break;
-        }
-    }
-
-  /* Decrement the references to the driver.  If the reference count will
-   * decrement to 0, then uninitialize the driver.
-   */
+  irqstate_t flags;
 
   if (dev->cd_ocount > 1)
     {
       dev->cd_ocount--;
-      goto errout;
+      return;
     }
 
   /* There are no more references to the port */
@@ -552,8 +669,90 @@ static int can_close(FAR struct file *filep)
   flags = enter_critical_section(); /* Disable interrupts */
   dev_shutdown(dev);                /* Disable the CAN */
   leave_critical_section(flags);
+}
+
+/****************************************************************************
+ * Name: can_open
+ *
+ * Description:
+ *   This function is called whenever the CAN device is opened.
+ *
+ ****************************************************************************/
+
+static int can_open(FAR struct file *filep)
+{
+  FAR struct inode        *inode = filep->f_inode;
+  FAR struct can_dev_s    *dev   = inode->i_private;
+  FAR struct can_reader_s *reader;
+  irqstate_t               flags;
+  int                      ret;
+
+  caninfo("ocount: %d\n", dev->cd_ocount);
+
+  /* If the port is the middle of closing, wait until the close is finished */
+
+  ret = can_takesem(&dev->cd_closesem);
+  if (ret < 0)
+    {
+      return ret;
+    }
+
+  ret = can_reference(dev);
+  if (ret >= 0)
+    {
+      /* Each open file has its own receive FIFO.  Remember it in the file
+       * structure so that it need not be looked up on each read.
+       */
+
+      reader = init_can_reader(filep);
+      filep->f_priv = reader;
+
+      flags = enter_critical_section();
+      list_add_head(&dev->cd_readers, &reader->list);
+      leave_critical_section(flags);
+    }
+
+  can_givesem(&dev->cd_closesem);
+  return ret;
+}
+
+/****************************************************************************
+ * Name: can_close
+ *
+ * Description:
+ *   This routine is called when the CAN device is closed.
+ *   It waits for the last remaining data to be sent.
+ *
+ ****************************************************************************/
+
+static int can_close(FAR struct file *filep)
+{
+  FAR struct inode        *inode  = filep->f_inode;
+  FAR struct can_dev_s    *dev    = inode->i_private;
+  FAR struct can_reader_s *reader = filep->f_priv;
+  irqstate_t               flags;
+  int                      ret;
+
+  caninfo("ocount: %d\n", dev->cd_ocount);
+
+  ret = can_takesem(&dev->cd_closesem);
+  if (ret < 0)
+    {
+      return ret;
+    }
+
+  DEBUGASSERT(reader != NULL);
+
+  flags = enter_critical_section();
+  list_delete(&reader->list);
+  leave_critical_section(flags);
+
+  nxsem_destroy(&reader->fifo.rx_sem);
+  kmm_free(reader);
+  filep->f_priv = NULL;
+
+  can_release(dev);
 
-errout:
   can_givesem(&dev->cd_closesem);
   return ret;
 }
@@ -571,8 +770,7 @@ static ssize_t can_read(FAR struct file *filep, FAR char *buffer,
 {
   FAR struct inode         *inode = filep->f_inode;
   FAR struct can_dev_s     *dev = inode->i_private;
-  FAR struct can_reader_s  *reader = NULL;
-  FAR struct list_node     *node;
+  FAR struct can_reader_s  *reader = filep->f_priv;
   FAR struct can_rxfifo_s  *fifo;
   size_t                    nread;
   irqstate_t                flags;
@@ -628,17 +826,7 @@ static ssize_t can_read(FAR struct file *filep, FAR char *buffer,
         }
 #endif /* CONFIG_CAN_ERRORS */
 
-      list_for_every(&dev->cd_readers, node)
-        {
-          if (((FAR struct can_reader_s *) node)->filep == filep)
-            {
-              reader = (FAR struct can_reader_s *)node;
-              break;
-            }
-        }
-
       DEBUGASSERT(reader != NULL);
-
       fifo = &reader->fifo;
 
       while (fifo->rx_head == fifo->rx_tail)
@@ -791,14 +979,18 @@ static int can_xmit(FAR struct can_dev_s *dev)
 }
 
 /****************************************************************************
- * Name: can_write
+ * Name: can_sendmsgs
+ *
+ * Description:
+ *   Add the CAN messages in the buffer to the TX FIFO and start the
+ *   transmission.  Used by both can_write() and CAN sockets.
+ *
  ****************************************************************************/
 
-static ssize_t can_write(FAR struct file *filep, FAR const char *buffer,
-                         size_t buflen)
+static ssize_t can_sendmsgs(FAR struct can_dev_s *dev,
+                            FAR const char *buffer, size_t buflen,
+                            bool nonblock)
 {
-  FAR struct inode        *inode = filep->f_inode;
-  FAR struct can_dev_s    *dev   = inode->i_private;
   FAR struct can_txfifo_s *fifo  = &dev->cd_xmit;
   FAR struct can_msg_s    *msg;
   bool                     inactive;
@@ -845,7 +1037,7 @@ static ssize_t can_write(FAR struct file *filep, FAR const char *buffer,
         {
           /* The transmit FIFO is full  -- was non-blocking mode selected? */
 
-          if ((filep->f_oflags & O_NONBLOCK) != 0)
+          if (nonblock)
             {
               if (nsent == 0)
                 {
@@ -921,6 +1113,20 @@ return_with_irqdisabled:
   return ret;
 }
 
+/****************************************************************************
+ * Name: can_write
+ ****************************************************************************/
+
+static ssize_t can_write(FAR struct file *filep, FAR const char *buffer,
+                         size_t buflen)
+{
+  FAR struct inode     *inode = filep->f_inode;
+  FAR struct can_dev_s *dev   = inode->i_private;
+
+  return can_sendmsgs(dev, buffer, buflen,
+                      (filep->f_oflags & O_NONBLOCK) != 0);
+}
+
 /****************************************************************************
  * Name: can_rtrread
  *
@@ -1003,6 +1209,25 @@ static int can_ioctl(FAR struct file *filep, int cmd, unsigned long arg)
         ret = can_rtrread(dev, (FAR struct canioc_rtr_s *)((uintptr_t)arg));
         break;
 
+#if CONFIG_CAN_NRDFILTERS > 0
+      /* CANIOC_ADD_RDFILTER: Attach an ID filter to this open file.
+       * Argument is a reference to struct canioc_rdfilter_s.
+       */
+
+      case CANIOC_ADD_RDFILTER:
+        ret = can_add_rdfilter(filep->f_priv,
+                  (FAR const struct canioc_rdfilter_s *)((uintptr_t)arg));
+        break;
+
+      /* CANIOC_DEL_RDFILTER: Remove an ID filter from this open file.
+       * Argument is the filter index returned by CANIOC_ADD_RDFILTER.
+       */
+
+      case CANIOC_DEL_RDFILTER:
+        ret = can_del_rdfilter(filep->f_priv, (int)arg);
+        break;
+#endif
+
       /* Not a "built-in" ioctl command.. perhaps it is unique to this
        * lower-half, device driver.
        */
@@ -1024,8 +1249,7 @@ static int can_poll(FAR struct file *filep, FAR struct pollfd *fds,
 {
   FAR struct inode *inode = (FAR struct inode *)filep->f_inode;
   FAR struct can_dev_s *dev = (FAR struct can_dev_s *)inode->i_private;
-  FAR struct can_reader_s *reader = NULL;
-  FAR struct list_node *node;
+  FAR struct can_reader_s *reader = filep->f_priv;
   pollevent_t eventset;
   int ndx;
   int ret;
@@ -1040,15 +1264,6 @@ static int can_poll(FAR struct file *filep, FAR struct pollfd *fds,
     }
 #endif
 
-  list_for_every(&dev->cd_readers, node)
-    {
-      if (((FAR struct can_reader_s *)node)->filep == filep)
-        {
-          reader = (FAR struct can_reader_s *)node;
-          break;
-        }
-    }
-
   DEBUGASSERT(reader != NULL);
 
   /* Get exclusive access to the poll structures */
@@ -1224,12 +1439,122 @@ int can_register(FAR const char *path, FAR struct can_dev_s *dev)
 
   dev_reset(dev);
 
+#ifdef CONFIG_NET_CAN
+  /* Add the device to the end of the list of devices visible to CAN
+   * sockets.
+   */
+
+    {
+      FAR struct can_dev_s **next = &g_can_devices;
+
+      while (*next != NULL)
+        {
+          next = &(*next)->cd_next;
+        }
+
+      dev->cd_next    = NULL;
+      dev->cd_ifindex = ++g_can_ndevices;
+      *next           = dev;
+    }
+#endif
+
   /* Register the CAN device */
 
   caninfo("Registering %s\n", path);
   return register_driver(path, &g_canops, 0666, dev);
 }
 
+/****************************************************************************
+ * Name: can_lookup
+ *
+ * Description:
+ *   Return the CAN device with the given CAN socket device index.
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_NET_CAN
+FAR struct can_dev_s *can_lookup(int ifindex)
+{
+  FAR struct can_dev_s *dev;
+
+  for (dev = g_can_devices; dev != NULL; dev = dev->cd_next)
+    {
+      if (dev->cd_ifindex == ifindex)
+        {
+          return dev;
+        }
+    }
+
+  return NULL;
+}
+#endif
+
+/****************************************************************************
+ * Name: can_devopen
+ *
+ * Description:
+ *   Take a reference to the device on behalf of a CAN socket.
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_NET_CAN
+int can_devopen(FAR struct can_dev_s *dev)
+{
+  int ret;
+
+  ret = can_takesem(&dev->cd_closesem);
+  if (ret < 0)
+    {
+      return ret;
+    }
+
+  ret = can_reference(dev);
+  can_givesem(&dev->cd_closesem);
+  return ret;
+}
+#endif
+
+/****************************************************************************
+ * Name: can_devclose
+ *
+ * Description:
+ *   Release a reference taken by can_devopen().
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_NET_CAN
+int can_devclose(FAR struct can_dev_s *dev)
+{
+  int ret;
+
+  ret = nxsem_wait_uninterruptible(&dev->cd_closesem);
+  if (ret < 0)
+    {
+      return ret;
+    }
+
+  can_release(dev);
+  can_givesem(&dev->cd_closesem);
+  return OK;
+}
+#endif
+
+/****************************************************************************
+ * Name: can_devwrite
+ *
+ * Description:
+ *   Queue CAN messages for transmission on behalf of a CAN socket.
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_NET_CAN
+ssize_t can_devwrite(FAR struct can_dev_s *dev, FAR const char *buffer,
+                     size_t buflen, bool nonblock)
+{
+  return can_sendmsgs(dev, buffer, buflen, nonblock);
+}
+#endif
+
 /****************************************************************************
  * Name: can_receive
  *
@@ -1256,12 +1581,28 @@ int can_receive(FAR struct can_dev_s *dev, FAR struct can_hdr_s *hdr,
   FAR uint8_t             *dest;
   FAR struct list_node    *node;
   FAR struct list_node    *tmp;
+  bool                     queued = false;
   int                      nexttail;
   int                      errcode = -ENOMEM;
   int                      i;
+#ifdef CONFIG_CAN_TIMESTAMP
+  struct timespec          ts;
+#endif
 
   caninfo("ID: %d DLC: %d\n", hdr->ch_id, hdr->ch_dlc);
 
+#ifdef CONFIG_CAN_TIMESTAMP
+  /* Stamp the message with the time of reception */
+
+#ifdef CONFIG_CLOCK_MONOTONIC
+  clock_gettime(CLOCK_MONOTONIC, &ts);
+#else
+  clock_gettime(CLOCK_REALTIME, &ts);
+#endif
+  hdr->ch_ts.tv_sec  = ts.tv_sec;
+  hdr->ch_ts.tv_usec = ts.tv_nsec / 1000;
+#endif
+
   /* Check if adding this new message would over-run the drivers ability to
    * enqueue read data.
    */
@@ -1311,11 +1652,30 @@ int can_receive(FAR struct can_dev_s *dev, FAR struct can_hdr_s *hdr,
         }
     }
 
+#ifdef CONFIG_NET_CAN
+  /* Pass the message to any CAN sockets bound to this device */
+
+  if (can_input(dev, hdr, data) >= 0)
+    {
+      errcode = OK;
+    }
+#endif
+
   list_for_every_safe(&dev->cd_readers, node, tmp)
     {
       FAR struct can_reader_s *reader = (FAR struct can_reader_s *)node;
       fifo = &reader->fifo;
 
+#if CONFIG_CAN_NRDFILTERS > 0
+      /* Skip readers that are not interested in this ID */
+
+      if (!can_rdaccept(reader, hdr))
+        {
+          errcode = OK;
+          continue;
+        }
+#endif
+
       nexttail = fifo->rx_tail + 1;
       if (nexttail >= CONFIG_CAN_FIFOSIZE)
         {
@@ -1361,12 +1721,7 @@ int can_receive(FAR struct can_dev_s *dev, FAR struct can_hdr_s *hdr,
             }
 
           errcode = OK;
-
-          /* Notify all poll/select waiters that they can read from the
-           * cd_recv buffer
-           */
-
-          can_pollnotify(dev, POLLIN);
+          queued  = true;
         }
 #ifdef CONFIG_CAN_ERRORS
       else
@@ -1378,6 +1733,15 @@ int can_receive(FAR struct can_dev_s *dev, FAR struct can_hdr_s *hdr,
 #endif
     }
 
+  /* Notify all poll/select waiters that they can read from the cd_recv
+   * buffer.
+   */
+
+  if (queued)
+    {
+      can_pollnotify(dev, POLLIN);
+    }
+
   return errcode;
 }
 
@@ -137,6 +137,23 @@
    MCP2515_ALIGN_UP(CONFIG_MCP2515_NEXTFILTERS << 3)
 #define MCP2515_EXTFILTER_WORDS (MCP2515_EXTFILTER_BYTES >> 2)
 
+/* Registers of acceptance filter n.  RXF0-RXF2 start at 0x00 and RXF3-RXF5
+ * at 0x10.  RXF0-RXF1 are masked by RXM0 (buffer RXB0) and RXF2-RXF5 by
+ * RXM1 (buffer RXB1).
+ */
+
+#define MCP2515_RXFSIDH(n) \
+   ((n) < 3 ? MCP2515_RXF0SIDH + ((n) << 2) : \
+              MCP2515_RXF3SIDH + (((n) - 3) << 2))
+#define MCP2515_RXFSIDL(n)      (MCP2515_RXFSIDH(n) + 1)
+#define MCP2515_RXFEID8(n)      (MCP2515_RXFSIDH(n) + 2)
+#define MCP2515_RXFEID0(n)      (MCP2515_RXFSIDH(n) + 3)
+
+#define MCP2515_RXMSIDH(n)      ((n) < 2 ? MCP2515_RXM0SIDH : MCP2515_RXM1SIDH)
+#define MCP2515_RXMSIDL(n)      (MCP2515_RXMSIDH(n) + 1)
+#define MCP2515_RXMEID8(n)      (MCP2515_RXMSIDH(n) + 2)
+#define MCP2515_RXMEID0(n)      (MCP2515_RXMSIDH(n) + 3)
+
 /* MCP25150 TX buffer element size */
 
 /* MCP25150 TX FIFOs */
@@ -570,7 +587,6 @@ static int mcp2515_add_extfilter(FAR struct mcp2515_can_s *priv,
 {
   FAR struct mcp2515_config_s *config;
   uint8_t regval;
-  uint8_t offset;
   uint8_t mode = CAN_FILTER_MASK;
   int ndx;
 
@@ -597,25 +613,9 @@ static int mcp2515_add_extfilter(FAR struct mcp2515_can_s *priv,
 
           /* Format and write filter */
 
-          DEBUGASSERT(extconfig->xf_id1 <= CAN_MAX_STDMSGID);
+          DEBUGASSERT(extconfig->xf_id1 <= CAN_MAX_EXTMSGID);
 
-          DEBUGASSERT(extconfig->xf_id2 <= CAN_MAX_STDMSGID);
-
-          /* We can reach all RXFn registers (RXFnSIDH, RXFnSIDL,
-           * RXFnEID8 and RXFnEID0) using this formula:
-           *
-           * filterN = RXF0reg + offset + ((priv->nalloc - 1) * 4) ;
-           * maskN   = RXM0reg + offset
-           */
-
-          if (priv->nalloc <= 3)
-            {
-              offset = 0;
-            }
-          else
-            {
-              offset = 4;
-            }
+          DEBUGASSERT(extconfig->xf_id2 <= CAN_MAX_EXTMSGID);
 
 #if 0
           /* N.B. Buffer 0 is higher priority than Buffer 1
@@ -668,14 +668,12 @@ static int mcp2515_add_extfilter(FAR struct mcp2515_can_s *priv,
               /* EID0 - EID7 */
 
               regval = (uint8_t)(extconfig->xf_id1 & 0xff);
-              mcp2515_writeregs(priv, MCP2515_RXF0EID0 + offset +
-                                ((priv->nalloc - 1) * 4), &regval, 1);
+              mcp2515_writeregs(priv, MCP2515_RXFEID0(ndx), &regval, 1);
 
               /* EID8 - EID15 */
 
               regval = (uint8_t)((extconfig->xf_id1 & 0xff00) >> 8);
-              mcp2515_writeregs(priv, MCP2515_RXF0EID8 + offset +
-                                ((priv->nalloc - 1) * 4), &regval, 1);
+              mcp2515_writeregs(priv, MCP2515_RXFEID8(ndx), &regval, 1);
 
               /* EID16 - EID17 */
 
@@ -685,27 +683,25 @@ static int mcp2515_add_extfilter(FAR struct mcp2515_can_s *priv,
 
               regval = (regval) |
                        (uint8_t)(((extconfig->xf_id1 & 0x1c0000) >> 16) << 3);
-              mcp2515_writeregs(priv, MCP2515_RXF0SIDL + offset +
-                                ((priv->nalloc - 1) * 4), &regval, 1);
+              regval |= RXFSIDL_EXIDE;
+              mcp2515_writeregs(priv, MCP2515_RXFSIDL(ndx), &regval, 1);
 
               /* STD3 - STD10 */
 
               regval = (uint8_t)((extconfig->xf_id1 & 0x1fe00000) >> 21);
-              regval |= RXFSIDL_EXIDE;
-              mcp2515_writeregs(priv, MCP2515_RXF0SIDL + offset +
-                                ((priv->nalloc - 1) * 4), &regval, 1);
+              mcp2515_writeregs(priv, MCP2515_RXFSIDH(ndx), &regval, 1);
 
               /* Setup the Mask */
 
               /* EID0 - EID7 */
 
               regval = (uint8_t)(extconfig->xf_id2 & 0xff);
-              mcp2515_writeregs(priv, MCP2515_RXM0EID0 + offset, &regval, 1);
+              mcp2515_writeregs(priv, MCP2515_RXMEID0(ndx), &regval, 1);
 
               /* EID8 - EID15 */
 
               regval = (uint8_t)((extconfig->xf_id2 & 0xff00) >> 8);
-              mcp2515_writeregs(priv, MCP2515_RXM0EID8 + offset, &regval, 1);
+              mcp2515_writeregs(priv, MCP2515_RXMEID8(ndx), &regval, 1);
 
               /* EID16 - EID17 */
 
@@ -715,12 +711,12 @@ static int mcp2515_add_extfilter(FAR struct mcp2515_can_s *priv,
 
               regval = (regval) |
                        (uint8_t)(((extconfig->xf_id2 & 0x1c0000) >> 16) << 3);
-              mcp2515_writeregs(priv, MCP2515_RXM0SIDL + offset, &regval, 1);
+              mcp2515_writeregs(priv, MCP2515_RXMSIDL(ndx), &regval, 1);
 
               /* STD3 - STD10 */
 
               regval = (uint8_t)((extconfig->xf_id2 & 0x1fe00000) >> 21);
-              mcp2515_writeregs(priv, MCP2515_RXM0SIDL + offset, &regval, 1);
+              mcp2515_writeregs(priv, MCP2515_RXMSIDH(ndx), &regval, 1);
             }
           else
             {
@@ -731,16 +727,14 @@ static int mcp2515_add_extfilter(FAR struct mcp2515_can_s *priv,
               /* EID0 - EID7 */
 
               regval = (uint8_t)(extconfig->xf_id1 & 0xff);
-              mcp2515_writeregs(priv, MCP2515_RXF0EID0 + offset +
-                                ((priv->nalloc - 1) * 4), &regval, 1);
-              mcp2515_writeregs(priv, MCP2515_RXM0EID0 + offset, &regval, 1);
+              mcp2515_writeregs(priv, MCP2515_RXFEID0(ndx), &regval, 1);
+              mcp2515_writeregs(priv, MCP2515_RXMEID0(ndx), &regval, 1);
 
               /* EID8 - EID15 */
 
               regval = (uint8_t)((extconfig->xf_id1 & 0xff00) >> 8);
-              mcp2515_writeregs(priv, MCP2515_RXF0EID8 + offset +
-                                ((priv->nalloc - 1) * 4), &regval, 1);
-              mcp2515_writeregs(priv, MCP2515_RXM0EID8 + offset, &regval, 1);
+              mcp2515_writeregs(priv, MCP2515_RXFEID8(ndx), &regval, 1);
+              mcp2515_writeregs(priv, MCP2515_RXMEID8(ndx), &regval, 1);
 
               /* EID16 - EID17 */
 
@@ -750,16 +744,14 @@ static int mcp2515_add_extfilter(FAR struct mcp2515_can_s *priv,
 
               regval = (regval) | (uint8_t)(((extconfig->xf_id1 &
                                 0x1c0000) >> 16) << 3) | RXFSIDL_EXIDE;
-              mcp2515_writeregs(priv, MCP2515_RXF0SIDL + offset +
-                                ((priv->nalloc - 1) * 4), &regval, 1);
-              mcp2515_writeregs(priv, MCP2515_RXM0SIDL + offset, &regval, 1);
+              mcp2515_writeregs(priv, MCP2515_RXFSIDL(ndx), &regval, 1);
+              mcp2515_writeregs(priv, MCP2515_RXMSIDL(ndx), &regval, 1);
 
               /* STD3 - STD10 */
 
               regval = (uint8_t)((extconfig->xf_id1 & 0x1fe00000) >> 21);
-              mcp2515_writeregs(priv, MCP2515_RXF0SIDL + offset +
-                                ((priv->nalloc - 1) * 4), &regval, 1);
-              mcp2515_writeregs(priv, MCP2515_RXF0SIDL + offset, &regval, 1);
+              mcp2515_writeregs(priv, MCP2515_RXFSIDH(ndx), &regval, 1);
+              mcp2515_writeregs(priv, MCP2515_RXMSIDH(ndx), &regval, 1);
             }
 
           /* Leave the Configuration mode, Move to Normal mode */
@@ -800,7 +792,6 @@ static int mcp2515_del_extfilter(FAR struct mcp2515_can_s *priv, int ndx)
 {
   FAR struct mcp2515_config_s *config;
   uint8_t regval;
-  uint8_t offset;
 
   DEBUGASSERT(priv != NULL && priv->config != NULL);
   config = priv->config;
@@ -837,22 +828,6 @@ static int mcp2515_del_extfilter(FAR struct mcp2515_can_s *priv, int ndx)
   DEBUGASSERT(priv->nalloc > 0);
   priv->nalloc--;
 
-  /* We can reach all RXFn registers (RXFnSIDH, RXFnSIDL,
-   * RXFnEID8 and RXFnEID0) using this formula:
-   *
-   * filterN = RXF0reg + offset + ((priv->nalloc - 1) * 4) ;
-   * maskN   = RXM0reg + offset
-   */
-
-  if (ndx < 3)
-    {
-      offset = 0;
-    }
-  else
-    {
-      offset = 4;
-    }
-
   /* Setup the CONFIG Mode */
 
   mcp2515_readregs(priv, MCP2515_CANCTRL, &regval, 1);
@@ -862,10 +837,10 @@ static int mcp2515_del_extfilter(FAR struct mcp2515_can_s *priv, int ndx)
   /* Invalidate this filter, set its ID to 0 */
 
   regval = 0;
-  mcp2515_writeregs(priv, MCP2515_RXF0SIDH + offset + (ndx * 4), &regval, 1);
-  mcp2515_writeregs(priv, MCP2515_RXF0SIDL + offset + (ndx * 4), &regval, 1);
-  mcp2515_writeregs(priv, MCP2515_RXF0EID8 + offset + (ndx * 4), &regval, 1);
-  mcp2515_writeregs(priv, MCP2515_RXF0EID0 + offset + (ndx * 4), &regval, 1);
+  mcp2515_writeregs(priv, MCP2515_RXFSIDH(ndx), &regval, 1);
+  mcp2515_writeregs(priv, MCP2515_RXFSIDL(ndx), &regval, 1);
+  mcp2515_writeregs(priv, MCP2515_RXFEID8(ndx), &regval, 1);
+  mcp2515_writeregs(priv, MCP2515_RXFEID0(ndx), &regval, 1);
 
   /* Leave the Configuration mode, Move to Normal mode */
 
@@ -899,7 +874,6 @@ static int mcp2515_add_stdfilter(FAR struct mcp2515_can_s *priv,
 {
   FAR struct mcp2515_config_s *config;
   uint8_t regval;
-  uint8_t offset;
   uint8_t mode = CAN_FILTER_MASK;
   int ndx;
 
@@ -930,22 +904,6 @@ static int mcp2515_add_stdfilter(FAR struct mcp2515_can_s *priv,
 
           DEBUGASSERT(stdconfig->sf_id2 <= CAN_MAX_STDMSGID);
 
-          /* We can reach all RXFn registers (RXFnSIDH, RXFnSIDL,
-           * RXFnEID8 and RXFnEID0) using this formula:
-           *
-           * filterN = RXF0reg + offset + ((priv->nalloc - 1) * 4) ;
-           * maskN   = RXM0reg + offset
-           */
-
-          if (priv->nalloc <= 3)
-            {
-              offset = 0;
-            }
-          else
-            {
-              offset = 4;
-            }
-
 #if 0
           /* N.B. Buffer 0 is higher priority than Buffer 1
            * but to separate these messages we will make this
@@ -995,20 +953,18 @@ static int mcp2515_add_stdfilter(FAR struct mcp2515_can_s *priv,
               /* Setup the Filter */
 
               regval = (uint8_t)(((stdconfig->sf_id1) & 0x7f8) >> 3);
-              mcp2515_writeregs(priv, MCP2515_RXF0SIDH + offset +
-                                ((priv->nalloc - 1) * 4), &regval, 1);
+              mcp2515_writeregs(priv, MCP2515_RXFSIDH(ndx), &regval, 1);
 
               regval = (uint8_t)((stdconfig->sf_id1 & 0x07) << 5);
-              mcp2515_writeregs(priv, MCP2515_RXF0SIDL + offset +
-                                ((priv->nalloc - 1) * 4), &regval, 1);
+              mcp2515_writeregs(priv, MCP2515_RXFSIDL(ndx), &regval, 1);
 
               /* Setup the Mask */
 
               regval = (uint8_t)(((stdconfig->sf_id2) & 0x7f8) >> 3);
-              mcp2515_writeregs(priv, MCP2515_RXM0SIDH + offset, &regval, 1);
+              mcp2515_writeregs(priv, MCP2515_RXMSIDH(ndx), &regval, 1);
 
               regval = (uint8_t)((stdconfig->sf_id2 & 0x07) << 5);
-              mcp2515_writeregs(priv, MCP2515_RXM0SIDL + offset, &regval, 1);
+              mcp2515_writeregs(priv, MCP2515_RXMSIDL(ndx), &regval, 1);
             }
           else
             {
@@ -1017,25 +973,21 @@ static int mcp2515_add_stdfilter(FAR struct mcp2515_can_s *priv,
               /* Setup the Filter */
 
               regval = (uint8_t) (((stdconfig->sf_id1) & 0x7f8) >> 3);
-              mcp2515_writeregs(priv, MCP2515_RXF0SIDH + offset +
-                                ((priv->nalloc - 1) * 4), &regval, 1);
-              mcp2515_writeregs(priv, MCP2515_RXM0SIDH + offset, &regval, 1);
+              mcp2515_writeregs(priv, MCP2515_RXFSIDH(ndx), &regval, 1);
+              mcp2515_writeregs(priv, MCP2515_RXMSIDH(ndx), &regval, 1);
 
               regval = (uint8_t)((stdconfig->sf_id1 & 0x07) << 5);
-              mcp2515_writeregs(priv, MCP2515_RXF0SIDL + offset +
-                                ((priv->nalloc - 1) * 4), &regval, 1);
-              mcp2515_writeregs(priv, MCP2515_RXM0SIDL + offset, &regval, 1);
+              mcp2515_writeregs(priv, MCP2515_RXFSIDL(ndx), &regval, 1);
+              mcp2515_writeregs(priv, MCP2515_RXMSIDL(ndx), &regval, 1);
             }
 
           /* We need to clear the extended ID bits */
 
           regval = 0;
-          mcp2515_writeregs(priv, MCP2515_RXF0EID0 + offset +
-                            ((priv->nalloc - 1) * 4), &regval, 1);
-          mcp2515_writeregs(priv, MCP2515_RXF0EID8 + offset +
-                            ((priv->nalloc - 1) * 4), &regval, 1);
-          mcp2515_writeregs(priv, MCP2515_RXM0EID0 + offset, &regval, 1);
-          mcp2515_writeregs(priv, MCP2515_RXM0EID8 + offset, &regval, 1);
+          mcp2515_writeregs(priv, MCP2515_RXFEID0(ndx), &regval, 1);
+          mcp2515_writeregs(priv, MCP2515_RXFEID8(ndx), &regval, 1);
+          mcp2515_writeregs(priv, MCP2515_RXMEID0(ndx), &regval, 1);
+          mcp2515_writeregs(priv, MCP2515_RXMEID8(ndx), &regval, 1);
 
           /* Leave the Configuration mode, Move to Normal mode */
 
@@ -1073,7 +1025,6 @@ static int mcp2515_del_stdfilter(FAR struct mcp2515_can_s *priv, int ndx)
 {
   FAR struct mcp2515_config_s *config;
   uint8_t regval;
-  uint8_t offset;
 
   DEBUGASSERT(priv != NULL && priv->config != NULL);
   config = priv->config;
@@ -1110,22 +1061,6 @@ static int mcp2515_del_stdfilter(FAR struct mcp2515_can_s *priv, int ndx)
   DEBUGASSERT(priv->nalloc > 0);
   priv->nalloc--;
 
-  /* We can reach all RXFn registers (RXFnSIDH, RXFnSIDL,
-   * RXFnEID8 and RXFnEID0) using this formula:
-   *
-   * filterN = RXF0reg + offset + ((priv->nalloc - 1) * 4) ;
-   * maskN   = RXM0reg + offset
-   */
-
-  if (ndx < 3)
-    {
-      offset = 0;
-    }
-  else
-    {
-      offset = 4;
-    }
-
   /* Setup the CONFIG Mode */
 
   mcp2515_readregs(priv, MCP2515_CANCTRL, &regval, 1);
@@ -1135,8 +1070,8 @@ static int mcp2515_del_stdfilter(FAR struct mcp2515_can_s *priv, int ndx)
   /* Invalidade this filter, set its ID to 0 */
 
   regval = 0;
-  mcp2515_writeregs(priv, MCP2515_RXF0SIDH + offset + (ndx * 4), &regval, 1);
-  mcp2515_writeregs(priv, MCP2515_RXF0SIDL + offset + (ndx * 4), &regval, 1);
+  mcp2515_writeregs(priv, MCP2515_RXFSIDH(ndx), &regval, 1);
+  mcp2515_writeregs(priv, MCP2515_RXFSIDL(ndx), &regval, 1);
 
   /* Leave the Configuration mode, Move to Normal mode */
 
@@ -0,0 +1,119 @@
+/****************************************************************************
+ * drivers/i2c/i2c_batch.c
+ *
+ *   Copyright (C) 2020 Gregory Nutt. All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in
+ *    the documentation and/or other materials provided with the
+ *    distribution.
+ * 3. Neither the name NuttX nor the names of its contributors may be
+ *    used to endorse or promote products derived from this software
+ *    without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+ * FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE
+ * COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+ * INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,
+ * BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS
+ * OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED
+ * AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ * LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN
+ * ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ *
+ ****************************************************************************/
+
+/****************************************************************************
+ * Included Files
+ ****************************************************************************/
+
+#include <nuttx/config.h>
+
+#include <errno.h>
+
+#include <nuttx/i2c/i2c_master.h>
+
+#ifdef CONFIG_I2C_BATCH
+
+/****************************************************************************
+ * Public Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: i2c_batch
+ *
+ * Description:
+ *   Perform a list of write-then-read register operations.  The lower half
+ *   batch method is used if there is one; otherwise each operation is a
+ *   separate I2C_TRANSFER().
+ *
+ * Input Parameters:
+ *   dev   - Device-specific state data
+ *   ops   - The operations, run in order
+ *   count - The number of operations
+ *
+ * Returned Value:
+ *   The number of operations completed, or a negated errno value if the
+ *   first one failed.
+ *
+ ****************************************************************************/
+
+int i2c_batch(FAR struct i2c_master_s *dev,
+              FAR const struct i2c_batchop_s *ops, int count)
+{
+  struct i2c_msg_s msg[2];
+  int nmsgs;
+  int ret;
+  int i;
+
+  if (count <= 0)
+    {
+      return -EINVAL;
+    }
+
+  if (dev->ops->batch != NULL)
+    {
+      return dev->ops->batch(dev, ops, count);
+    }
+
+  for (i = 0; i < count; i++, ops++)
+    {
+      msg[0].frequency = ops->frequency;
+      msg[0].addr      = ops->addr;
+      msg[0].flags     = ops->flags & I2C_M_TEN;
+      msg[0].buffer    = (FAR uint8_t *)ops->wbuffer; /* Override const */
+      msg[0].length    = ops->wlength;
+      nmsgs            = 1;
+
+      if (ops->rlength > 0)
+        {
+          msg[0].flags    |= I2C_M_NOSTOP;
+
+          msg[1].frequency = ops->frequency;
+          msg[1].addr      = ops->addr;
+          msg[1].flags     = (ops->flags & I2C_M_TEN) | I2C_M_READ;
+          msg[1].buffer    = ops->rbuffer;
+          msg[1].length    = ops->rlength;
+          nmsgs            = 2;
+        }
+
+      ret = I2C_TRANSFER(dev, msg, nmsgs);
+      if (ret < 0)
+        {
+          return i > 0 ? i : ret;
+        }
+    }
+
+  return count;
+}
+
+#endif /* CONFIG_I2C_BATCH */
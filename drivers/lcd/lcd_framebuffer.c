@@ -46,7 +46,9 @@
 #include <debug.h>
 
 #include <nuttx/board.h>
+#include <nuttx/irq.h>
 #include <nuttx/kmalloc.h>
+#include <nuttx/wqueue.h>
 #include <nuttx/nx/nx.h>
 #include <nuttx/nx/nxglib.h>
 #include <nuttx/lcd/lcd.h>
@@ -62,6 +64,33 @@
 
 #define VIDEO_PLANE 0
 
+/* 2D operations are accelerated if the architecture provides them */
+
+#if defined(CONFIG_FB_ACCEL) && defined(CONFIG_ARCH_HAVE_FBACCEL)
+#  define LCDFB_ACCEL 1
+#endif
+
+/* Deferred flushing of the dirty region */
+
+#ifdef CONFIG_LCD_FRAMEBUFFER_DEFERRED
+#  ifdef CONFIG_SCHED_LPWORK
+#    define LCDFB_WORK LPWORK
+#  else
+#    define LCDFB_WORK HPWORK
+#  endif
+
+#  define LCDFB_FLUSH_DELAY MSEC2TICK(CONFIG_LCD_FRAMEBUFFER_FLUSHMS)
+#  define LCDFB_NDIRTY      CONFIG_LCD_FRAMEBUFFER_NDIRTY
+
+#  ifndef MIN
+#    define MIN(a,b) (((a) < (b)) ? (a) : (b))
+#  endif
+
+#  ifndef MAX
+#    define MAX(a,b) (((a) > (b)) ? (a) : (b))
+#  endif
+#endif
+
 /****************************************************************************
  * Private Types
  ****************************************************************************/
@@ -80,6 +109,16 @@ struct lcdfb_dev_s
   fb_coord_t yres;                  /* Vertical resolution in pixel rows */
   fb_coord_t stride;                /* Width of a row in bytes */
   uint8_t display;                  /* Display number */
+
+#ifdef CONFIG_LCD_FRAMEBUFFER_DEFERRED
+  /* Regions of the framebuffer not yet written to the LCD.  Overlapping or
+   * adjacent updates are merged; they are flushed on the next frame tick.
+   */
+
+  struct work_s work;               /* Deferred flush */
+  uint8_t ndirty;                   /* Number of entries in dirty[] */
+  struct nxgl_rect_s dirty[LCDFB_NDIRTY];
+#endif
 };
 
 /****************************************************************************
@@ -122,6 +161,17 @@ static int lcdfb_setcursor(FAR struct fb_vtable_s *vtable,
              FAR struct fb_setcursor_s *settings);
 #endif
 
+/* The following are provided only if the architecture can accelerate 2D
+ * operations on framebuffer memory
+ */
+
+#ifdef LCDFB_ACCEL
+static int lcdfb_fillrect(FAR struct fb_vtable_s *vtable,
+             FAR const struct fb_fillrect_s *fill);
+static int lcdfb_copyrect(FAR struct fb_vtable_s *vtable,
+             FAR const struct fb_copyrect_s *copy);
+#endif
+
 /****************************************************************************
  * Private Data
  ****************************************************************************/
@@ -230,6 +280,13 @@ static int lcdfb_update(FAR struct lcdfb_dev_s *priv,
   run  = priv->fbmem + starty * priv->stride;
   run += (startx * pinfo->bpp + 7) >> 3;
 
+  /* Write the whole area at once if the LCD can do that */
+
+  if (pinfo->putarea != NULL)
+    {
+      return pinfo->putarea(starty, endy, startx, endx, run, priv->stride);
+    }
+
   for (row = starty; row <= endy; row++)
     {
       /* REVISIT: Some LCD hardware certain aligment requirements on DMA
@@ -248,6 +305,129 @@ static int lcdfb_update(FAR struct lcdfb_dev_s *priv,
   return OK;
 }
 
+/****************************************************************************
+ * Name: lcdfb_flushworker
+ *
+ * Description:
+ *   Write the dirty regions of the framebuffer to the LCD.
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_LCD_FRAMEBUFFER_DEFERRED
+static void lcdfb_flushworker(FAR void *arg)
+{
+  FAR struct lcdfb_dev_s *priv = (FAR struct lcdfb_dev_s *)arg;
+  struct nxgl_rect_s dirty[LCDFB_NDIRTY];
+  irqstate_t flags;
+  int ndirty;
+  int ret;
+  int i;
+
+  /* Take the dirty list; updates arriving from now on schedule another
+   * flush.
+   */
+
+  flags  = enter_critical_section();
+  ndirty = priv->ndirty;
+  memcpy(dirty, priv->dirty, ndirty * sizeof(struct nxgl_rect_s));
+  priv->ndirty = 0;
+  leave_critical_section(flags);
+
+  for (i = 0; i < ndirty; i++)
+    {
+      ret = lcdfb_update(priv, &dirty[i]);
+      if (ret < 0)
+        {
+          lcderr("FB update failed: %d\n", ret);
+        }
+    }
+}
+#endif
+
+/****************************************************************************
+ * Name: lcdfb_adddirty
+ *
+ * Description:
+ *   Add a rectangle to the dirty region and make sure that a flush is
+ *   scheduled.  A rectangle that overlaps or touches a dirty rectangle is
+ *   merged into it.  If the list is full, the rectangle is merged into the
+ *   entry whose bounding box grows least.
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_LCD_FRAMEBUFFER_DEFERRED
+static void lcdfb_adddirty(FAR struct lcdfb_dev_s *priv,
+                           FAR const struct nxgl_rect_s *rect)
+{
+  FAR struct nxgl_rect_s *dirty;
+  irqstate_t flags;
+  uint32_t growth;
+  uint32_t best;
+  int merge;
+  int i;
+
+  flags = enter_critical_section();
+
+  merge = -1;
+  best  = UINT32_MAX;
+
+  for (i = 0; i < priv->ndirty; i++)
+    {
+      dirty = &priv->dirty[i];
+
+      if (rect->pt1.x <= dirty->pt2.x + 1 &&
+          dirty->pt1.x <= rect->pt2.x + 1 &&
+          rect->pt1.y <= dirty->pt2.y + 1 &&
+          dirty->pt1.y <= rect->pt2.y + 1)
+        {
+          merge = i;
+          break;
+        }
+
+      if (priv->ndirty >= LCDFB_NDIRTY)
+        {
+          /* Area added to this entry if the rectangle is merged into it */
+
+          growth = (uint32_t)(MAX(dirty->pt2.x, rect->pt2.x) -
+                              MIN(dirty->pt1.x, rect->pt1.x) + 1) *
+                   (uint32_t)(MAX(dirty->pt2.y, rect->pt2.y) -
+                              MIN(dirty->pt1.y, rect->pt1.y) + 1) -
+                   (uint32_t)(dirty->pt2.x - dirty->pt1.x + 1) *
+                   (uint32_t)(dirty->pt2.y - dirty->pt1.y + 1);
+
+          if (growth < best)
+            {
+              best  = growth;
+              merge = i;
+            }
+        }
+    }
+
+  if (merge >= 0)
+    {
+      dirty        = &priv->dirty[merge];
+      dirty->pt1.x = MIN(dirty->pt1.x, rect->pt1.x);
+      dirty->pt1.y = MIN(dirty->pt1.y, rect->pt1.y);
+      dirty->pt2.x = MAX(dirty->pt2.x, rect->pt2.x);
+      dirty->pt2.y = MAX(dirty->pt2.y, rect->pt2.y);
+    }
+  else
+    {
+      priv->dirty[priv->ndirty++] = *rect;
+    }
+
+  /* Flush on the next frame tick unless a flush is already pending */
+
+  if (work_available(&priv->work))
+    {
+      work_queue(LCDFB_WORK, &priv->work, lcdfb_flushworker, priv,
+                 LCDFB_FLUSH_DELAY);
+    }
+
+  leave_critical_section(flags);
+}
+#endif
+
 /****************************************************************************
  * Name: lcdfb_getvideoinfo
  ****************************************************************************/
@@ -448,6 +628,66 @@ static int lcdfb_setcursor(FAR struct fb_vtable_s *vtable,
 }
 #endif
 
+/****************************************************************************
+ * Name: lcdfb_fillrect
+ ****************************************************************************/
+
+#ifdef LCDFB_ACCEL
+static int lcdfb_fillrect(FAR struct fb_vtable_s *vtable,
+                          FAR const struct fb_fillrect_s *fill)
+{
+  FAR struct lcdfb_dev_s *priv = (FAR struct lcdfb_dev_s *)vtable;
+  struct fb_planeinfo_s pinfo;
+  int ret;
+
+  DEBUGASSERT(priv != NULL && fill != NULL);
+
+  if (fill->w == 0 || fill->h == 0 ||
+      fill->x + fill->w > priv->xres || fill->y + fill->h > priv->yres)
+    {
+      return -EINVAL;
+    }
+
+  ret = lcdfb_getplaneinfo(vtable, fill->planeno, &pinfo);
+  if (ret < 0)
+    {
+      return ret;
+    }
+
+  return up_fbaccel_fillrect(&pinfo, fill);
+}
+#endif
+
+/****************************************************************************
+ * Name: lcdfb_copyrect
+ ****************************************************************************/
+
+#ifdef LCDFB_ACCEL
+static int lcdfb_copyrect(FAR struct fb_vtable_s *vtable,
+                          FAR const struct fb_copyrect_s *copy)
+{
+  FAR struct lcdfb_dev_s *priv = (FAR struct lcdfb_dev_s *)vtable;
+  struct fb_planeinfo_s pinfo;
+  int ret;
+
+  DEBUGASSERT(priv != NULL && copy != NULL);
+
+  if (copy->src == NULL || copy->w == 0 || copy->h == 0 ||
+      copy->x + copy->w > priv->xres || copy->y + copy->h > priv->yres)
+    {
+      return -EINVAL;
+    }
+
+  ret = lcdfb_getplaneinfo(vtable, copy->planeno, &pinfo);
+  if (ret < 0)
+    {
+      return ret;
+    }
+
+  return up_fbaccel_copyrect(&pinfo, copy);
+}
+#endif
+
 /****************************************************************************
  * Public Functions
  ****************************************************************************/
@@ -502,6 +742,10 @@ int up_fbinitialize(int display)
   priv->vtable.getcursor    = lcdfb_getcursor,
   priv->vtable.setcursor    = lcdfb_setcursor,
 #endif
+#ifdef LCDFB_ACCEL
+  priv->vtable.fillrect     = lcdfb_fillrect,
+  priv->vtable.copyrect     = lcdfb_copyrect,
+#endif
 
 #ifdef  CONFIG_LCD_EXTERNINIT
   /* Use external graphics driver initialization */
@@ -680,6 +924,12 @@ void up_fbuninitialize(int display)
               g_lcdfb = priv->flink;
             }
 
+#ifdef CONFIG_LCD_FRAMEBUFFER_DEFERRED
+          /* Drop any pending flush */
+
+          work_cancel(LCDFB_WORK, &priv->work);
+#endif
+
 #ifndef  CONFIG_LCD_EXTERNINIT
           /* Uninitialize the LCD */
 
@@ -729,7 +979,9 @@ void nx_notify_rectangle(FAR NX_PLANEINFOTYPE *pinfo,
 {
   FAR struct fb_planeinfo_s *fpinfo = (FAR struct fb_planeinfo_s *)pinfo;
   FAR struct lcdfb_dev_s *priv;
+#ifndef CONFIG_LCD_FRAMEBUFFER_DEFERRED
   int ret;
+#endif
 
   DEBUGASSERT(fpinfo != NULL && rect != NULL);
 
@@ -742,11 +994,17 @@ void nx_notify_rectangle(FAR NX_PLANEINFOTYPE *pinfo,
   priv = lcdfb_find(fpinfo->display);
   if (priv != NULL)
     {
+#ifdef CONFIG_LCD_FRAMEBUFFER_DEFERRED
+      /* Coalesce with other updates and write them on the next frame tick */
+
+      lcdfb_adddirty(priv, rect);
+#else
       ret = lcdfb_update(priv, rect);
       if (ret < 0)
         {
           lcderr("FB update failed: %d\n", ret);
         }
+#endif
     }
 }
 #endif
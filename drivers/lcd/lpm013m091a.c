@@ -102,6 +102,10 @@ static int lpm013m091a_hwinitialize(FAR struct lpm013m091a_dev_s *dev);
 
 static int lpm013m091a_putrun(fb_coord_t row, fb_coord_t col,
                               FAR const uint8_t *buffer, size_t npixels);
+static int lpm013m091a_putarea(fb_coord_t row_start, fb_coord_t row_end,
+                               fb_coord_t col_start, fb_coord_t col_end,
+                               FAR const uint8_t *buffer,
+                               fb_coord_t stride);
 #ifndef CONFIG_LCD_NOGETRUN
 static int lpm013m091a_getrun(fb_coord_t row, fb_coord_t col,
                               FAR uint8_t *buffer,
@@ -145,6 +149,7 @@ static const struct fb_videoinfo_s g_videoinfo =
 static const struct lcd_planeinfo_s g_planeinfo =
 {
   .putrun = lpm013m091a_putrun,           /* Put a run into lcd memory */
+  .putarea = lpm013m091a_putarea,         /* Put an area into lcd memory */
 #ifndef CONFIG_LCD_NOGETRUN
   .getrun = lpm013m091a_getrun,           /* Get a run from lcd memory */
 #endif
@@ -348,6 +353,89 @@ static int lpm013m091a_putrun(fb_coord_t row, fb_coord_t col,
   return OK;
 }
 
+/****************************************************************************
+ * Name:  lpm013m091a_putarea
+ *
+ * Description:
+ *   Write a rectangular area to the LCD.  The area is selected and the
+ *   memory write command is sent once.  When the rows are contiguous, the
+ *   pixel data goes out in a single sendgram(), i.e. one DMA transfer if
+ *   the SPI driver uses DMA.
+ *
+ * Parameters:
+ *   row_start - Starting row to write to (range: 0 <= row_start < yres)
+ *   row_end   - Ending row to write to (range: row_start <= row_end < yres)
+ *   col_start - Starting column (range: 0 <= col_start < xres)
+ *   col_end   - Ending column (range: col_start <= col_end < xres)
+ *   buffer    - The first pixel of the area to be written to the LCD
+ *   stride    - The distance between rows in the buffer in bytes
+ *
+ * Returned Value:
+ *
+ *   On success - OK
+ *   On error   - -EINVAL
+ *
+ ****************************************************************************/
+
+static int lpm013m091a_putarea(fb_coord_t row_start, fb_coord_t row_end,
+                               fb_coord_t col_start, fb_coord_t col_end,
+                               FAR const uint8_t *buffer,
+                               fb_coord_t stride)
+{
+  FAR struct lpm013m091a_dev_s *dev = (FAR struct lpm013m091a_dev_s *)
+                                       &g_lpm013m091a_dev;
+  FAR struct lpm013m091a_lcd_s *lcd = dev->lcd;
+  FAR const uint8_t *src = buffer;
+  size_t npixels;
+  fb_coord_t row;
+
+  DEBUGASSERT(buffer && ((uintptr_t)buffer & 1) == 0 && (stride & 1) == 0);
+
+  /* Check if position outside of area */
+
+  if (row_end < row_start || col_end < col_start ||
+      col_end >= LPM013M091A_XRES || row_end >= LPM013M091A_YRES)
+    {
+      return -EINVAL;
+    }
+
+  npixels = col_end - col_start + 1;
+
+  /* Select lcd driver */
+
+  lcd->select(lcd);
+
+  /* Select the whole area; the controller wraps to the next row by itself */
+
+  lpm013m091a_selectarea(lcd, col_start, row_start, col_end, row_end);
+
+  /* Send memory write cmd */
+
+  lcd->sendcmd(lcd, LPM013M091A_RAMWR);
+
+  /* Send pixel to gram, in one transfer if the rows are contiguous */
+
+  if (stride == npixels * sizeof(uint16_t))
+    {
+      lcd->sendgram(lcd, (FAR const uint16_t *)src,
+                    npixels * (row_end - row_start + 1));
+    }
+  else
+    {
+      for (row = row_start; row <= row_end; row++)
+        {
+          lcd->sendgram(lcd, (FAR const uint16_t *)src, npixels);
+          src += stride;
+        }
+    }
+
+  /* Deselect the lcd driver */
+
+  lcd->deselect(lcd);
+
+  return OK;
+}
+
 /****************************************************************************
  * Name:  lpm013m091a_getrun
  *
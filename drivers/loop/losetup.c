@@ -58,6 +58,7 @@
 
 #include <nuttx/kmalloc.h>
 #include <nuttx/fs/fs.h>
+#include <nuttx/fs/ioctl.h>
 #include <nuttx/fs/loop.h>
 #include <nuttx/semaphore.h>
 
@@ -68,10 +69,34 @@
 #define loop_semgive(d) nxsem_post(&(d)->sem)  /* To match loop_semtake */
 #define MAX_OPENCNT     (255)                  /* Limit of uint8_t */
 
+#ifndef CONFIG_LOOP_MAXEXTENTS
+#  define CONFIG_LOOP_MAXEXTENTS 0
+#endif
+
+#ifndef CONFIG_LOOP_READAHEAD
+#  define CONFIG_LOOP_READAHEAD 0
+#endif
+
 /****************************************************************************
  * Private Types
  ****************************************************************************/
 
+/* A run of loop device sectors that the file system stores contiguously,
+ * either in consecutive sectors of a block driver or in memory.
+ */
+
+#if CONFIG_LOOP_MAXEXTENTS > 0
+struct loop_extent_s
+{
+  uint32_t     sector;       /* First loop device sector of the extent */
+  uint32_t     nsectors;     /* Number of loop device sectors */
+  FAR struct inode *blkdrv;  /* Block driver holding them, or NULL */
+  size_t       bsector;      /* First sector on blkdrv */
+  uint16_t     ratio;        /* blkdrv sectors per loop device sector */
+  FAR uint8_t *mem;          /* Memory holding them if blkdrv is NULL */
+};
+#endif
+
 struct loop_struct_s
 {
   sem_t        sem;          /* For safe read-modify-write operations */
@@ -83,6 +108,16 @@ struct loop_struct_s
   bool         writeenabled; /* true: can write to device */
 #endif
   struct file  devfile;      /* File struct of char device/file */
+#if CONFIG_LOOP_MAXEXTENTS > 0
+  uint8_t      nextents;     /* Number of extents, 0 if not mapped */
+  struct loop_extent_s extents[CONFIG_LOOP_MAXEXTENTS];
+#endif
+#if CONFIG_LOOP_READAHEAD > 0
+  uint32_t     rastart;      /* First sector in the read-ahead buffer */
+  uint32_t     racount;      /* Sectors in the read-ahead buffer */
+  uint32_t     lastend;      /* Sector following the last read */
+  FAR uint8_t *rabuf;        /* The read-ahead buffer */
+#endif
 };
 
 /****************************************************************************
@@ -211,29 +246,20 @@ static int loop_close(FAR struct inode *inode)
 }
 
 /****************************************************************************
- * Name: loop_read
+ * Name: loop_fileread
  *
- * Description:  Read the specified number of sectors
+ * Description:  Read sectors through the file system
  *
  ****************************************************************************/
 
-static ssize_t loop_read(FAR struct inode *inode, FAR unsigned char *buffer,
-                         size_t start_sector, unsigned int nsectors)
+static ssize_t loop_fileread(FAR struct loop_struct_s *dev,
+                             FAR unsigned char *buffer,
+                             size_t start_sector, unsigned int nsectors)
 {
-  FAR struct loop_struct_s *dev;
   ssize_t nbytesread;
   off_t offset;
   off_t ret;
 
-  DEBUGASSERT(inode && inode->i_private);
-  dev = (FAR struct loop_struct_s *)inode->i_private;
-
-  if (start_sector + nsectors > dev->nsectors)
-    {
-      ferr("ERROR: Read past end of file\n");
-      return -EIO;
-    }
-
   /* Calculate the offset to read the sectors and seek to the position */
 
   offset = start_sector * dev->sectsize + dev->offset;
@@ -264,25 +290,21 @@ static ssize_t loop_read(FAR struct inode *inode, FAR unsigned char *buffer,
 }
 
 /****************************************************************************
- * Name: loop_write
+ * Name: loop_filewrite
  *
- * Description: Write the specified number of sectors
+ * Description: Write sectors through the file system
  *
  ****************************************************************************/
 
 #ifdef CONFIG_FS_WRITABLE
-static ssize_t loop_write(FAR struct inode *inode,
-                          FAR const unsigned char *buffer,
-                          size_t start_sector, unsigned int nsectors)
+static ssize_t loop_filewrite(FAR struct loop_struct_s *dev,
+                              FAR const unsigned char *buffer,
+                              size_t start_sector, unsigned int nsectors)
 {
-  FAR struct loop_struct_s *dev;
   ssize_t nbyteswritten;
   off_t offset;
   off_t ret;
 
-  DEBUGASSERT(inode && inode->i_private);
-  dev = (FAR struct loop_struct_s *)inode->i_private;
-
   /* Calculate the offset to write the sectors and seek to the position */
 
   offset = start_sector * dev->sectsize + dev->offset;
@@ -312,6 +334,349 @@ static ssize_t loop_write(FAR struct inode *inode,
 }
 #endif
 
+/****************************************************************************
+ * Name: loop_mapextents
+ *
+ * Description:
+ *   Ask the file system where the data of the backing file is stored.  If
+ *   it fits in CONFIG_LOOP_MAXEXTENTS runs of whole sectors, the loop
+ *   device accesses the data directly instead of seeking and reading
+ *   through the file system.  Otherwise nothing is mapped.
+ *
+ ****************************************************************************/
+
+#if CONFIG_LOOP_MAXEXTENTS > 0
+static void loop_mapextents(FAR struct loop_struct_s *dev)
+{
+  FAR struct loop_extent_s *extent;
+  struct file_extent_s fe;
+  uint32_t sector = 0;
+  off_t end;
+  off_t pos;
+  int ret;
+
+  end = dev->offset + (off_t)dev->nsectors * dev->sectsize;
+  pos = dev->offset;
+
+  dev->nextents = 0;
+  while (pos < end)
+    {
+      if (dev->nextents >= CONFIG_LOOP_MAXEXTENTS)
+        {
+          goto errout;
+        }
+
+      memset(&fe, 0, sizeof(struct file_extent_s));
+      fe.fe_offset = pos;
+      fe.fe_length = end - pos;
+
+      ret = file_ioctl(&dev->devfile, FIOC_EXTENT, (unsigned long)&fe);
+      if (ret < 0 || fe.fe_length <= 0)
+        {
+          goto errout;
+        }
+
+      /* Every extent must hold whole loop sectors, each made up of whole
+       * block driver sectors.
+       */
+
+      if (fe.fe_length % dev->sectsize != 0 ||
+          (fe.fe_blkdrv != NULL &&
+           (fe.fe_blkdrv->u.i_bops == NULL ||
+            fe.fe_blkdrv->u.i_bops->read == NULL ||
+            fe.fe_sectsize == 0 || dev->sectsize % fe.fe_sectsize != 0)))
+        {
+          goto errout;
+        }
+
+      extent           = &dev->extents[dev->nextents++];
+      extent->sector   = sector;
+      extent->nsectors = fe.fe_length / dev->sectsize;
+      extent->blkdrv   = fe.fe_blkdrv;
+      extent->bsector  = fe.fe_sector;
+      extent->ratio    = fe.fe_blkdrv != NULL ?
+                         dev->sectsize / fe.fe_sectsize : 0;
+      extent->mem      = fe.fe_mem;
+
+      sector += extent->nsectors;
+      pos    += fe.fe_length;
+    }
+
+  finfo("Mapped %u sectors in %u extents\n",
+        (unsigned int)dev->nsectors, dev->nextents);
+  return;
+
+errout:
+  finfo("Not mapped, using file I/O\n");
+  dev->nextents = 0;
+}
+
+/****************************************************************************
+ * Name: loop_mapio
+ *
+ * Description:
+ *   Transfer sectors directly to or from the storage of the backing file.
+ *   Requests spanning several extents are split at the extent boundaries;
+ *   each piece is a single multi-sector transfer.
+ *
+ ****************************************************************************/
+
+static ssize_t loop_mapio(FAR struct loop_struct_s *dev,
+                          FAR unsigned char *buffer, size_t start_sector,
+                          unsigned int nsectors, bool write)
+{
+  FAR struct loop_extent_s *extent;
+  FAR const struct block_operations *bops;
+  unsigned int nxfer;
+  size_t nbytes;
+  size_t offset;
+  ssize_t ret;
+  ssize_t ndone = 0;
+  int i;
+
+  for (i = 0; i < dev->nextents && nsectors > 0; i++)
+    {
+      extent = &dev->extents[i];
+      if (start_sector >= extent->sector + extent->nsectors)
+        {
+          continue;
+        }
+
+      offset = start_sector - extent->sector;
+      nxfer  = extent->nsectors - offset;
+      if (nxfer > nsectors)
+        {
+          nxfer = nsectors;
+        }
+
+      nbytes = nxfer * dev->sectsize;
+
+      if (extent->blkdrv == NULL)
+        {
+          if (write)
+            {
+              memcpy(extent->mem + offset * dev->sectsize, buffer, nbytes);
+            }
+          else
+            {
+              memcpy(buffer, extent->mem + offset * dev->sectsize, nbytes);
+            }
+        }
+      else
+        {
+          bops = extent->blkdrv->u.i_bops;
+          if (write)
+            {
+              ret = bops->write == NULL ? -EACCES :
+                    bops->write(extent->blkdrv, buffer,
+                                extent->bsector + offset * extent->ratio,
+                                nxfer * extent->ratio);
+            }
+          else
+            {
+              ret = bops->read(extent->blkdrv, buffer,
+                               extent->bsector + offset * extent->ratio,
+                               nxfer * extent->ratio);
+            }
+
+          if (ret < 0)
+            {
+              ferr("ERROR: Transfer failed: %d\n", (int)ret);
+              return ret;
+            }
+
+          if (ret != nxfer * extent->ratio)
+            {
+              return ndone + ret / extent->ratio;
+            }
+        }
+
+      buffer       += nbytes;
+      start_sector += nxfer;
+      nsectors     -= nxfer;
+      ndone        += nxfer;
+    }
+
+  return ndone;
+}
+#endif
+
+/****************************************************************************
+ * Name: loop_readsectors
+ *
+ * Description:  Read sectors from the backing file
+ *
+ ****************************************************************************/
+
+static ssize_t loop_readsectors(FAR struct loop_struct_s *dev,
+                                FAR unsigned char *buffer,
+                                size_t start_sector, unsigned int nsectors)
+{
+#if CONFIG_LOOP_MAXEXTENTS > 0
+  if (dev->nextents > 0)
+    {
+      return loop_mapio(dev, buffer, start_sector, nsectors, false);
+    }
+#endif
+
+  return loop_fileread(dev, buffer, start_sector, nsectors);
+}
+
+/****************************************************************************
+ * Name: loop_readahead
+ *
+ * Description:
+ *   Read through the read-ahead buffer.  A small read that continues where
+ *   the previous one ended fills the whole buffer, and the reads that
+ *   follow are then served from memory.
+ *
+ ****************************************************************************/
+
+#if CONFIG_LOOP_READAHEAD > 0
+static ssize_t loop_readahead(FAR struct loop_struct_s *dev,
+                              FAR unsigned char *buffer,
+                              size_t start_sector, unsigned int nsectors)
+{
+  uint32_t count;
+  ssize_t ret;
+
+  if (dev->racount > 0 && start_sector >= dev->rastart &&
+      start_sector + nsectors <= dev->rastart + dev->racount)
+    {
+      memcpy(buffer,
+             dev->rabuf + (start_sector - dev->rastart) * dev->sectsize,
+             nsectors * dev->sectsize);
+      dev->lastend = start_sector + nsectors;
+      return nsectors;
+    }
+
+  if (start_sector == dev->lastend && nsectors < CONFIG_LOOP_READAHEAD)
+    {
+      count = dev->nsectors - start_sector;
+      if (count > CONFIG_LOOP_READAHEAD)
+        {
+          count = CONFIG_LOOP_READAHEAD;
+        }
+
+      ret = loop_readsectors(dev, dev->rabuf, start_sector, count);
+      if (ret >= (ssize_t)nsectors)
+        {
+          dev->rastart = start_sector;
+          dev->racount = ret;
+
+          memcpy(buffer, dev->rabuf, nsectors * dev->sectsize);
+          dev->lastend = start_sector + nsectors;
+          return nsectors;
+        }
+
+      dev->racount = 0;
+    }
+
+  ret = loop_readsectors(dev, buffer, start_sector, nsectors);
+  if (ret > 0)
+    {
+      dev->lastend = start_sector + ret;
+    }
+
+  return ret;
+}
+#endif
+
+/****************************************************************************
+ * Name: loop_read
+ *
+ * Description:  Read the specified number of sectors
+ *
+ ****************************************************************************/
+
+static ssize_t loop_read(FAR struct inode *inode, FAR unsigned char *buffer,
+                         size_t start_sector, unsigned int nsectors)
+{
+  FAR struct loop_struct_s *dev;
+  ssize_t ret;
+
+  DEBUGASSERT(inode && inode->i_private);
+  dev = (FAR struct loop_struct_s *)inode->i_private;
+
+  if (start_sector + nsectors > dev->nsectors)
+    {
+      ferr("ERROR: Read past end of file\n");
+      return -EIO;
+    }
+
+  ret = loop_semtake(dev);
+  if (ret < 0)
+    {
+      return ret;
+    }
+
+#if CONFIG_LOOP_READAHEAD > 0
+  ret = loop_readahead(dev, buffer, start_sector, nsectors);
+#else
+  ret = loop_readsectors(dev, buffer, start_sector, nsectors);
+#endif
+
+  loop_semgive(dev);
+  return ret;
+}
+
+/****************************************************************************
+ * Name: loop_write
+ *
+ * Description: Write the specified number of sectors
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_FS_WRITABLE
+static ssize_t loop_write(FAR struct inode *inode,
+                          FAR const unsigned char *buffer,
+                          size_t start_sector, unsigned int nsectors)
+{
+  FAR struct loop_struct_s *dev;
+  ssize_t ret;
+
+  DEBUGASSERT(inode && inode->i_private);
+  dev = (FAR struct loop_struct_s *)inode->i_private;
+
+  if (start_sector + nsectors > dev->nsectors)
+    {
+      ferr("ERROR: Write past end of file\n");
+      return -EIO;
+    }
+
+  ret = loop_semtake(dev);
+  if (ret < 0)
+    {
+      return ret;
+    }
+
+#if CONFIG_LOOP_READAHEAD > 0
+  /* Drop read-ahead data that is overwritten */
+
+  if (dev->racount > 0 && start_sector < dev->rastart + dev->racount &&
+      start_sector + nsectors > dev->rastart)
+    {
+      dev->racount = 0;
+    }
+#endif
+
+#if CONFIG_LOOP_MAXEXTENTS > 0
+  if (dev->nextents > 0)
+    {
+      ret = loop_mapio(dev, (FAR unsigned char *)buffer, start_sector,
+                       nsectors, true);
+    }
+  else
+#endif
+    {
+      ret = loop_filewrite(dev, buffer, start_sector, nsectors);
+    }
+
+  loop_semgive(dev);
+  return ret;
+}
+#endif
+
 /****************************************************************************
  * Name: loop_geometry
  *
@@ -435,6 +800,19 @@ int losetup(FAR const char *devname, FAR const char *filename,
         }
     }
 
+#if CONFIG_LOOP_MAXEXTENTS > 0
+  loop_mapextents(dev);
+#endif
+
+#if CONFIG_LOOP_READAHEAD > 0
+  dev->rabuf = (FAR uint8_t *)kmm_malloc(CONFIG_LOOP_READAHEAD * sectsize);
+  if (dev->rabuf == NULL)
+    {
+      ret = -ENOMEM;
+      goto errout_with_file;
+    }
+#endif
+
   /* Inode private data will be reference to the loop device structure */
 
   ret = register_blockdriver(devname, &g_bops, 0, dev);
@@ -447,6 +825,13 @@ int losetup(FAR const char *devname, FAR const char *filename,
   return OK;
 
 errout_with_file:
+#if CONFIG_LOOP_READAHEAD > 0
+  if (dev->rabuf != NULL)
+    {
+      kmm_free(dev->rabuf);
+    }
+
+#endif
   file_close(&dev->devfile);
 
 errout_with_dev:
@@ -513,6 +898,9 @@ int loteardown(FAR const char *devname)
       file_close(&dev->devfile);
     }
 
+#if CONFIG_LOOP_READAHEAD > 0
+  kmm_free(dev->rabuf);
+#endif
   kmm_free(dev);
   return ret;
 }
@@ -123,6 +123,9 @@ struct mmcsd_state_s
   uint8_t wrprotect:1;             /* true: Card is write protected (from CSD) */
   uint8_t locked:1;                /* true: Media is locked (from R1) */
   uint8_t dsrimp:1;                /* true: card supports CMD4/DSR setting (from CSD) */
+#ifdef CONFIG_MMCSD_SETBLOCKCOUNT
+  uint8_t blkcount:1;              /* true: card supports CMD23 (from SCR/CSD) */
+#endif
 #ifdef CONFIG_SDIO_DMA
   uint8_t dma:1;                   /* true: hardware supports DMA */
 #endif
@@ -199,6 +202,10 @@ static int     mmcsd_transferready(FAR struct mmcsd_state_s *priv);
 #ifndef CONFIG_MMCSD_MULTIBLOCK_DISABLE
 static int     mmcsd_stoptransmission(FAR struct mmcsd_state_s *priv);
 #endif
+#ifdef CONFIG_MMCSD_SETBLOCKCOUNT
+static int     mmcsd_setblockcount(FAR struct mmcsd_state_s *priv,
+                 uint32_t nblocks);
+#endif
 static int     mmcsd_setblocklen(FAR struct mmcsd_state_s *priv,
                  uint32_t blocklen);
 static ssize_t mmcsd_readsingle(FAR struct mmcsd_state_s *priv,
@@ -587,6 +594,15 @@ static void mmcsd_decodeCSD(FAR struct mmcsd_state_s *priv, uint32_t csd[4])
   decoded.transpeed.transferrateunit =  csd[0]        & 7;
 #endif
 
+#ifdef CONFIG_MMCSD_SETBLOCKCOUNT
+  /* CMD23 is supported by MMC version 3.1 and later */
+
+  if (IS_MMC(priv->type))
+    {
+      priv->blkcount = ((csd[0] >> 26) & 0x0f) >= 3;
+    }
+#endif
+
   /* Word 2: Bits 64:95
    *   CCC                95:84 Card command classes
    *   READ_BL_LEN        83:80 Max. read data block length
@@ -994,6 +1010,16 @@ static void mmcsd_decodeSCR(FAR struct mmcsd_state_s *priv, uint32_t scr[2])
   priv->buswidth     = (scr[0] >> 8) & 15;
 #endif
 
+  /*   CMD_SUPPORT            33:32 bit 33: CMD23 supported (SD 3.0) */
+
+#ifdef CONFIG_MMCSD_SETBLOCKCOUNT
+#ifdef CONFIG_ENDIAN_BIG
+  priv->blkcount     = (scr[0] >> 1) & 1;
+#else
+  priv->blkcount     = (scr[0] >> 25) & 1;
+#endif
+#endif
+
 #ifdef CONFIG_DEBUG_FS_INFO
 #ifdef CONFIG_ENDIAN_BIG    /* Card SCR is big-endian order / CPU also big-endian
                              *   60   56   52   48   44   40   36   32
@@ -1315,6 +1341,34 @@ static int mmcsd_stoptransmission(FAR struct mmcsd_state_s *priv)
 }
 #endif
 
+/****************************************************************************
+ * Name: mmcsd_setblockcount
+ *
+ * Description:
+ *   Send SET_BLOCK_COUNT so that the following CMD18/CMD25 transfers
+ *   exactly nblocks and no STOP_TRANSMISSION is needed.
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_MMCSD_SETBLOCKCOUNT
+static int mmcsd_setblockcount(FAR struct mmcsd_state_s *priv,
+                               uint32_t nblocks)
+{
+  int ret;
+
+  /* Send CMD23, SET_BLOCK_COUNT, and verify good R1 return status */
+
+  mmcsd_sendcmdpoll(priv, MMC_CMD23, nblocks);
+  ret = mmcsd_recvR1(priv, MMC_CMD23);
+  if (ret != OK)
+    {
+      ferr("ERROR: mmcsd_recvR1 for CMD23 failed: %d\n", ret);
+    }
+
+  return ret;
+}
+#endif
+
 /****************************************************************************
  * Name: mmcsd_setblocklen
  *
@@ -1568,6 +1622,19 @@ static ssize_t mmcsd_readmultiple(FAR struct mmcsd_state_s *priv,
       return ret;
     }
 
+#ifdef CONFIG_MMCSD_SETBLOCKCOUNT
+  /* Let the card stop by itself after nblocks */
+
+  if (priv->blkcount)
+    {
+      ret = mmcsd_setblockcount(priv, nblocks);
+      if (ret != OK)
+        {
+          return ret;
+        }
+    }
+#endif
+
   /* Configure SDIO controller hardware for the read transfer */
 
   SDIO_BLOCKSETUP(priv->dev, priv->blocksize, nblocks);
@@ -1613,9 +1680,15 @@ static ssize_t mmcsd_readmultiple(FAR struct mmcsd_state_s *priv,
       return ret;
     }
 
-  /* Send STOP_TRANSMISSION */
+  /* Send STOP_TRANSMISSION, unless the transfer was sized by CMD23 */
+
+#ifdef CONFIG_MMCSD_SETBLOCKCOUNT
+  if (!priv->blkcount)
+#endif
+    {
+      ret = mmcsd_stoptransmission(priv);
+    }
 
-  ret = mmcsd_stoptransmission(priv);
 #ifdef CONFIG_SDIO_DMA
   SDIO_DMADELYDINVLDT(priv->dev, buffer, priv->blocksize * nblocks);
 #endif
@@ -1979,6 +2052,22 @@ static ssize_t mmcsd_writemultiple(FAR struct mmcsd_state_s *priv,
         }
     }
 
+#ifdef CONFIG_MMCSD_SETBLOCKCOUNT
+  /* Let the card stop by itself after nblocks.  Nothing is sent to the card
+   * between this and CMD25, even if the controller needs the DMA set up
+   * first.
+   */
+
+  if (priv->blkcount)
+    {
+      ret = mmcsd_setblockcount(priv, nblocks);
+      if (ret != OK)
+        {
+          return ret;
+        }
+    }
+#endif
+
   /* If Controller does not need DMA setup before the write then send CMD25
    * now.
    */
@@ -2053,9 +2142,21 @@ static ssize_t mmcsd_writemultiple(FAR struct mmcsd_state_s *priv,
        */
     }
 
-  /* Send STOP_TRANSMISSION */
+  /* Send STOP_TRANSMISSION.  A transfer sized by CMD23 needs it only to
+   * recover from an error.
+   */
+
+#ifdef CONFIG_MMCSD_SETBLOCKCOUNT
+  if (priv->blkcount && evret == OK)
+    {
+      ret = OK;
+    }
+  else
+#endif
+    {
+      ret = mmcsd_stoptransmission(priv);
+    }
 
-  ret = mmcsd_stoptransmission(priv);
   if (evret != OK)
     {
       return evret;
@@ -3492,6 +3593,9 @@ static int mmcsd_removed(FAR struct mmcsd_state_s *priv)
   priv->probed       = false;
   priv->mediachanged = false;
   priv->wrbusy       = false;
+#ifdef CONFIG_MMCSD_SETBLOCKCOUNT
+  priv->blkcount     = false;
+#endif
   priv->type         = MMCSD_CARDTYPE_UNKNOWN;
   priv->rca          = 0;
   priv->selblocklen  = 0;
@@ -0,0 +1,615 @@
+/****************************************************************************
+ * drivers/mtd/bchecc.c
+ *
+ *   Copyright (C) 2020 Gregory Nutt. All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in
+ *    the documentation and/or other materials provided with the
+ *    distribution.
+ * 3. Neither the name NuttX nor the names of its contributors may be
+ *    used to endorse or promote products derived from this software
+ *    without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+ * FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE
+ * COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+ * INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,
+ * BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS
+ * OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED
+ * AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ * LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN
+ * ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ *
+ ****************************************************************************/
+
+/****************************************************************************
+ * Included Files
+ ****************************************************************************/
+
+#include <nuttx/config.h>
+
+#include <sys/types.h>
+#include <stdint.h>
+#include <stdbool.h>
+#include <string.h>
+#include <errno.h>
+#include <assert.h>
+#include <debug.h>
+
+#include <nuttx/mtd/bchecc.h>
+
+#ifdef CONFIG_MTD_NAND_SWECC_BCH
+
+/****************************************************************************
+ * Pre-processor Definitions
+ ****************************************************************************/
+
+/* GF(2^13) is generated by the primitive polynomial x^13+x^4+x^3+x+1 */
+
+#define BCH_POLY           0x201b
+#define BCH_N              ((1 << BCHECC_M) - 1)
+
+/* The sector is 4096 data bits followed by at most 13*T ECC bits.  The
+ * remainder is kept left aligned in a register of 32-bit words.
+ */
+
+#define BCH_DATABITS       (8 * BCHECC_SECTORSIZE)
+#define BCH_MAXECCBITS     (BCHECC_M * BCHECC_T)
+#define BCH_ECCWORDS       ((BCH_MAXECCBITS + 31) / 32)
+
+/****************************************************************************
+ * Private Data
+ ****************************************************************************/
+
+/* Encoder table: the remainder contributed by each possible leading byte */
+
+static uint32_t g_bch_table[256][BCH_ECCWORDS];
+
+/* XOR'ed into every code so that an erased sector has an all 0xff code */
+
+static uint8_t g_bch_erased[BCHECC_ECCBYTES];
+
+/* The number of ECC bits, i.e. the degree of the generator polynomial */
+
+static uint16_t g_bch_eccbits;
+static bool g_bch_initialized;
+
+/****************************************************************************
+ * Private Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: bch_gfmul
+ *
+ * Description:
+ *   Multiply two elements of GF(2^13).
+ *
+ ****************************************************************************/
+
+static uint16_t bch_gfmul(uint16_t a, uint16_t b)
+{
+  uint16_t result = 0;
+
+  while (b != 0)
+    {
+      if ((b & 1) != 0)
+        {
+          result ^= a;
+        }
+
+      b >>= 1;
+      a <<= 1;
+
+      if ((a & (1 << BCHECC_M)) != 0)
+        {
+          a ^= BCH_POLY;
+        }
+    }
+
+  return result;
+}
+
+/****************************************************************************
+ * Name: bch_gfpow
+ *
+ * Description:
+ *   Raise an element of GF(2^13) to a power.
+ *
+ ****************************************************************************/
+
+static uint16_t bch_gfpow(uint16_t a, unsigned int exp)
+{
+  uint16_t result = 1;
+
+  exp %= BCH_N;
+  while (exp != 0)
+    {
+      if ((exp & 1) != 0)
+        {
+          result = bch_gfmul(result, a);
+        }
+
+      a     = bch_gfmul(a, a);
+      exp >>= 1;
+    }
+
+  return result;
+}
+
+/****************************************************************************
+ * Name: bch_gfinv
+ ****************************************************************************/
+
+static inline uint16_t bch_gfinv(uint16_t a)
+{
+  return bch_gfpow(a, BCH_N - 1);
+}
+
+/****************************************************************************
+ * Name: bch_encode
+ *
+ * Description:
+ *   Compute the ECC bytes of one sector, including the erased page mask.
+ *
+ ****************************************************************************/
+
+static void bch_encode(FAR const uint8_t *data, FAR uint8_t *ecc)
+{
+  uint32_t reg[BCH_ECCWORDS];
+  FAR const uint32_t *entry;
+  int i;
+  int w;
+
+  memset(reg, 0, sizeof(reg));
+
+  /* Divide the data by the generator polynomial a byte at a time */
+
+  for (i = 0; i < BCHECC_SECTORSIZE; i++)
+    {
+      entry = g_bch_table[(reg[0] >> 24) ^ data[i]];
+
+      for (w = 0; w < BCH_ECCWORDS - 1; w++)
+        {
+          reg[w] = ((reg[w] << 8) | (reg[w + 1] >> 24)) ^ entry[w];
+        }
+
+      reg[w] = (reg[w] << 8) ^ entry[w];
+    }
+
+  for (i = 0; i < BCHECC_ECCBYTES; i++)
+    {
+      ecc[i] = (uint8_t)(reg[i >> 2] >> (24 - 8 * (i & 3))) ^
+               g_bch_erased[i];
+    }
+}
+
+/****************************************************************************
+ * Name: bch_decode
+ *
+ * Description:
+ *   Locate and correct the bit errors in one sector given the difference
+ *   between the computed and the stored ECC.  That difference is the
+ *   remainder of the error polynomial, so its values at alpha^1 ..
+ *   alpha^2T are the syndromes.
+ *
+ * Returned Value:
+ *   The number of bit errors corrected, or -EBADMSG.
+ *
+ ****************************************************************************/
+
+static int bch_decode(FAR uint8_t *data, FAR const uint8_t *diff)
+{
+  uint16_t syn[2 * BCHECC_T + 1];
+  uint16_t sigma[BCHECC_T + 2];
+  uint16_t prev[BCHECC_T + 2];
+  uint16_t tmp[BCHECC_T + 2];
+  uint16_t term[BCHECC_T + 1];
+  uint16_t step[BCHECC_T + 1];
+  uint16_t errpos[BCHECC_T];
+  uint16_t alpha;
+  uint16_t delta;
+  uint16_t pdelta;
+  uint16_t sum;
+  unsigned int nerr;
+  unsigned int bit;
+  int shift;
+  int len;
+  int i;
+  int j;
+  int n;
+
+  /* Evaluate the remainder at alpha^j, highest degree first.  Bit q of the
+   * ECC is the coefficient of x^(eccbits - 1 - q).
+   */
+
+  for (j = 1; j <= 2 * BCHECC_T; j++)
+    {
+      alpha  = bch_gfpow(2, j);
+      syn[j] = 0;
+
+      for (i = 0; i < g_bch_eccbits; i++)
+        {
+          syn[j] = bch_gfmul(syn[j], alpha) ^
+                   ((diff[i >> 3] >> (7 - (i & 7))) & 1);
+        }
+    }
+
+  /* Berlekamp-Massey: find the error locator polynomial sigma */
+
+  memset(sigma, 0, sizeof(sigma));
+  memset(prev, 0, sizeof(prev));
+  sigma[0] = 1;
+  prev[0]  = 1;
+  pdelta   = 1;
+  shift    = 1;
+  len      = 0;
+
+  for (n = 0; n < 2 * BCHECC_T; n++)
+    {
+      delta = syn[n + 1];
+      for (i = 1; i <= len; i++)
+        {
+          delta ^= bch_gfmul(sigma[i], syn[n + 1 - i]);
+        }
+
+      if (delta == 0)
+        {
+          shift++;
+          continue;
+        }
+
+      memcpy(tmp, sigma, sizeof(sigma));
+      alpha = bch_gfmul(delta, bch_gfinv(pdelta));
+
+      for (i = 0; i + shift <= BCHECC_T + 1; i++)
+        {
+          sigma[i + shift] ^= bch_gfmul(alpha, prev[i]);
+        }
+
+      if (2 * len <= n)
+        {
+          len    = n + 1 - len;
+          memcpy(prev, tmp, sizeof(prev));
+          pdelta = delta;
+          shift  = 1;
+        }
+      else
+        {
+          shift++;
+        }
+    }
+
+  if (len > BCHECC_T)
+    {
+      return -EBADMSG;
+    }
+
+  /* Chien search: an error at degree p is a root alpha^-p of sigma */
+
+  for (i = 1; i <= len; i++)
+    {
+      term[i] = sigma[i];
+      step[i] = bch_gfpow(2, BCH_N - i);
+    }
+
+  nerr = 0;
+  for (n = 0; n < g_bch_eccbits + BCH_DATABITS; n++)
+    {
+      sum = 1;
+      for (i = 1; i <= len; i++)
+        {
+          sum     ^= term[i];
+          term[i]  = bch_gfmul(term[i], step[i]);
+        }
+
+      if (sum == 0)
+        {
+          if (nerr >= len)
+            {
+              return -EBADMSG;
+            }
+
+          errpos[nerr++] = n;
+        }
+    }
+
+  /* There must be exactly one root for each error */
+
+  if (nerr != len)
+    {
+      return -EBADMSG;
+    }
+
+  /* Correct the data bits.  Errors below degree eccbits are in the stored
+   * ECC itself and need no correction.  Data bit b is at degree
+   * eccbits + 4095 - b.
+   */
+
+  for (i = 0; i < nerr; i++)
+    {
+      if (errpos[i] >= g_bch_eccbits)
+        {
+          bit = BCH_DATABITS - 1 - (errpos[i] - g_bch_eccbits);
+
+          finfo("Correcting byte %u at bit %u\n", bit >> 3, 7 - (bit & 7));
+          data[bit >> 3] ^= 0x80 >> (bit & 7);
+        }
+    }
+
+  return nerr;
+}
+
+/****************************************************************************
+ * Public Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: bchecc_initialize
+ *
+ * Description:
+ *   Build the generator polynomial and the encoder tables.  This must be
+ *   called once before any other BCH function.
+ *
+ ****************************************************************************/
+
+void bchecc_initialize(void)
+{
+  uint8_t gen[BCH_MAXECCBITS + 1];
+  uint8_t prod[BCH_MAXECCBITS + 1];
+  uint16_t minpoly[BCHECC_M + 1];
+  uint32_t reg[BCH_ECCWORDS];
+  uint32_t poly[BCH_ECCWORDS];
+  uint8_t ecc[BCHECC_ECCBYTES];
+  uint8_t erased[BCHECC_SECTORSIZE];
+  unsigned int exp;
+  uint16_t beta;
+  bool dup;
+  int deg;
+  int mdeg;
+  int bit;
+  int i;
+  int j;
+  int k;
+  int w;
+
+  if (g_bch_initialized)
+    {
+      return;
+    }
+
+  /* The generator polynomial is the product of the minimal polynomials of
+   * alpha^1 .. alpha^2T.  The even powers share the minimal polynomial of
+   * an odd power, so only the odd ones that are the smallest member of
+   * their cyclotomic coset contribute.
+   */
+
+  memset(gen, 0, sizeof(gen));
+  gen[0] = 1;
+  deg    = 0;
+
+  for (j = 1; j < 2 * BCHECC_T; j += 2)
+    {
+      dup = false;
+      exp = j;
+
+      do
+        {
+          exp = (exp * 2) % BCH_N;
+          if (exp < j)
+            {
+              dup = true;
+            }
+        }
+      while (exp != j);
+
+      if (dup)
+        {
+          continue;
+        }
+
+      /* The minimal polynomial is the product of (x + alpha^e) over the
+       * coset.  Its coefficients are all 0 or 1.
+       */
+
+      memset(minpoly, 0, sizeof(minpoly));
+      minpoly[0] = 1;
+      mdeg       = 0;
+      exp        = j;
+
+      do
+        {
+          beta = bch_gfpow(2, exp);
+
+          minpoly[mdeg + 1] = minpoly[mdeg];
+          for (i = mdeg; i > 0; i--)
+            {
+              minpoly[i] = minpoly[i - 1] ^ bch_gfmul(minpoly[i], beta);
+            }
+
+          minpoly[0] = bch_gfmul(minpoly[0], beta);
+          mdeg++;
+          exp = (exp * 2) % BCH_N;
+        }
+      while (exp != j);
+
+      /* gen = gen * minpoly */
+
+      memset(prod, 0, sizeof(prod));
+      for (i = 0; i <= mdeg; i++)
+        {
+          DEBUGASSERT(minpoly[i] <= 1);
+          if (minpoly[i] != 0)
+            {
+              for (k = 0; k <= deg; k++)
+                {
+                  prod[i + k] ^= gen[k];
+                }
+            }
+        }
+
+      memcpy(gen, prod, sizeof(gen));
+      deg += mdeg;
+    }
+
+  DEBUGASSERT(deg <= BCH_MAXECCBITS);
+  g_bch_eccbits = deg;
+
+  /* The generator polynomial without its x^deg term, left aligned: the
+   * coefficient of x^(deg - 1) is the most significant bit.
+   */
+
+  memset(poly, 0, sizeof(poly));
+  for (i = 0; i < deg; i++)
+    {
+      if (gen[i] != 0)
+        {
+          bit = deg - 1 - i;
+          poly[bit >> 5] |= 0x80000000 >> (bit & 31);
+        }
+    }
+
+  /* Build the byte-at-a-time encoder table */
+
+  for (i = 0; i < 256; i++)
+    {
+      memset(reg, 0, sizeof(reg));
+      reg[0] = (uint32_t)i << 24;
+
+      for (k = 0; k < 8; k++)
+        {
+          bool carry = (reg[0] & 0x80000000) != 0;
+
+          for (w = 0; w < BCH_ECCWORDS - 1; w++)
+            {
+              reg[w] = (reg[w] << 1) | (reg[w + 1] >> 31);
+            }
+
+          reg[w] <<= 1;
+
+          if (carry)
+            {
+              for (w = 0; w < BCH_ECCWORDS; w++)
+                {
+                  reg[w] ^= poly[w];
+                }
+            }
+        }
+
+      memcpy(g_bch_table[i], reg, sizeof(reg));
+    }
+
+  /* Compute the mask that makes the code of an erased sector all 0xff.
+   * The unused bits at the end of the last byte are set as well.
+   */
+
+  memset(g_bch_erased, 0, sizeof(g_bch_erased));
+  memset(erased, 0xff, sizeof(erased));
+  bch_encode(erased, ecc);
+
+  for (i = 0; i < BCHECC_ECCBYTES; i++)
+    {
+      g_bch_erased[i] = ecc[i] ^ 0xff;
+    }
+
+  g_bch_initialized = true;
+}
+
+/****************************************************************************
+ * Name: bchecc_compute512x
+ *
+ * Description:
+ *   Computes BCHECC_ECCBYTES bytes of BCH code for each 512 byte sector of
+ *   a data block whose size is a multiple of 512 bytes.
+ *
+ ****************************************************************************/
+
+void bchecc_compute512x(FAR const uint8_t *data, size_t size,
+                        FAR uint8_t *code)
+{
+  ssize_t remaining = (ssize_t)size;
+
+  DEBUGASSERT(g_bch_initialized && (size & 0x1ff) == 0);
+
+  while (remaining > 0)
+    {
+      bch_encode(data, code);
+
+      data      += BCHECC_SECTORSIZE;
+      code      += BCHECC_ECCBYTES;
+      remaining -= BCHECC_SECTORSIZE;
+    }
+}
+
+/****************************************************************************
+ * Name: bchecc_verify512x
+ *
+ * Description:
+ *   Verifies and corrects a data block whose size is a multiple of 512
+ *   bytes using the BCH codes computed by bchecc_compute512x().
+ *
+ ****************************************************************************/
+
+int bchecc_verify512x(FAR uint8_t *data, size_t size,
+                      FAR const uint8_t *code)
+{
+  ssize_t remaining = (ssize_t)size;
+  uint8_t diff[BCHECC_ECCBYTES];
+  uint8_t errors;
+  int corrected = 0;
+  int ret;
+  int i;
+
+  DEBUGASSERT(g_bch_initialized && (size & 0x1ff) == 0);
+
+  while (remaining > 0)
+    {
+      /* Compare the stored code with the code of the data as read.  The
+       * unused bits at the end of the code are ignored.
+       */
+
+      bch_encode(data, diff);
+
+      errors = 0;
+      for (i = 0; i < BCHECC_ECCBYTES; i++)
+        {
+          diff[i] ^= code[i];
+          errors  |= diff[i];
+        }
+
+      if ((g_bch_eccbits & 7) != 0)
+        {
+          diff[BCHECC_ECCBYTES - 1] &= 0xff << (8 - (g_bch_eccbits & 7));
+          errors |= diff[BCHECC_ECCBYTES - 1];
+        }
+
+      if (errors != 0)
+        {
+          ret = bch_decode(data, diff);
+          if (ret < 0)
+            {
+              ferr("ERROR: Uncorrectable bit errors\n");
+              return ret;
+            }
+
+          corrected += ret;
+        }
+
+      data      += BCHECC_SECTORSIZE;
+      code      += BCHECC_ECCBYTES;
+      remaining -= BCHECC_SECTORSIZE;
+    }
+
+  return corrected;
+}
+
+#endif /* CONFIG_MTD_NAND_SWECC_BCH */
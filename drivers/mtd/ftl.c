@@ -51,7 +51,10 @@
 #include <debug.h>
 #include <errno.h>
 
+#include <nuttx/clock.h>
 #include <nuttx/kmalloc.h>
+#include <nuttx/semaphore.h>
+#include <nuttx/wqueue.h>
 #include <nuttx/fs/fs.h>
 #include <nuttx/fs/ioctl.h>
 #include <nuttx/mtd/mtd.h>
@@ -67,6 +70,21 @@
 #  define FTL_HAVE_RWBUFFER 1
 #endif
 
+/* The erase block cache replaces the direct MTD read and flush logic and is
+ * optionally written back from the low priority work queue.
+ */
+
+#ifdef CONFIG_FTL_EBCACHE
+#  define FTL_RELOAD ftl_cacheread
+#  define FTL_FLUSH  ftl_cachewrite
+#  if defined(CONFIG_SCHED_LPWORK) && CONFIG_FTL_EBCACHE_WRDELAY > 0
+#    define FTL_HAVE_EBFLUSHER 1
+#  endif
+#else
+#  define FTL_RELOAD ftl_reload
+#  define FTL_FLUSH  ftl_flush
+#endif
+
 /* The maximum length of the device name paths is the maximum length of a
  * name plus 5 for the the length of "/dev/" and a NUL terminator.
  */
@@ -77,6 +95,16 @@
  * Private Types
  ****************************************************************************/
 
+#ifdef CONFIG_FTL_EBCACHE
+struct ftl_ebcache_s
+{
+  FAR uint8_t          *buffer;  /* Erase block data (allocated on first use) */
+  off_t                 eblock;  /* Cached erase block number, -1 if none */
+  uint32_t              age;     /* Last use stamp for LRU eviction */
+  bool                  dirty;   /* The cached data has not been written back */
+};
+#endif
+
 struct ftl_struct_s
 {
   FAR struct mtd_dev_s *mtd;     /* Contained MTD interface */
@@ -90,6 +118,14 @@ struct ftl_struct_s
 #ifdef CONFIG_FS_WRITABLE
   FAR uint8_t          *eblock;  /* One, in-memory erase block */
 #endif
+#ifdef CONFIG_FTL_EBCACHE
+  sem_t                 ebsem;   /* Protects the erase block cache */
+  uint32_t              ebage;   /* Next LRU stamp */
+  struct ftl_ebcache_s  ebcache[CONFIG_FTL_EBCACHE_NBLOCKS];
+#ifdef FTL_HAVE_EBFLUSHER
+  struct work_s         ebwork;  /* Delayed write-back work */
+#endif
+#endif
 };
 
 /****************************************************************************
@@ -98,13 +134,24 @@ struct ftl_struct_s
 
 static int     ftl_open(FAR struct inode *inode);
 static int     ftl_close(FAR struct inode *inode);
+#ifdef CONFIG_FTL_EBCACHE
+static ssize_t ftl_cacheread(FAR void *priv, FAR uint8_t *buffer,
+                 off_t startblock, size_t nblocks);
+static ssize_t ftl_cachewrite(FAR void *priv, FAR const uint8_t *buffer,
+                 off_t startblock, size_t nblocks);
+static int     ftl_cacheflush(FAR struct ftl_struct_s *dev);
+static void    ftl_cacheuninitialize(FAR struct ftl_struct_s *dev);
+#else
 static ssize_t ftl_reload(FAR void *priv, FAR uint8_t *buffer,
                  off_t startblock, size_t nblocks);
+#endif
 static ssize_t ftl_read(FAR struct inode *inode, unsigned char *buffer,
                  size_t start_sector, unsigned int nsectors);
 #ifdef CONFIG_FS_WRITABLE
+#ifndef CONFIG_FTL_EBCACHE
 static ssize_t ftl_flush(FAR void *priv, FAR const uint8_t *buffer,
                  off_t startblock, size_t nblocks);
+#endif
 static ssize_t ftl_write(FAR struct inode *inode, const unsigned char *buffer,
                  size_t start_sector, unsigned int nsectors);
 #endif
@@ -174,12 +221,18 @@ static int ftl_close(FAR struct inode *inode)
 #ifdef CONFIG_FTL_WRITEBUFFER
   rwb_flush(&dev->rwb);
 #endif
+#ifdef CONFIG_FTL_EBCACHE
+  ftl_cacheflush(dev);
+#endif
 
   if (--dev->refs == 0 && dev->unlinked)
     {
 #ifdef FTL_HAVE_RWBUFFER
       rwb_uninitialize(&dev->rwb);
 #endif
+#ifdef CONFIG_FTL_EBCACHE
+      ftl_cacheuninitialize(dev);
+#endif
 #ifdef CONFIG_FS_WRITABLE
       if (dev->eblock)
         {
@@ -199,6 +252,7 @@ static int ftl_close(FAR struct inode *inode)
  *
  ****************************************************************************/
 
+#ifndef CONFIG_FTL_EBCACHE
 static ssize_t ftl_reload(FAR void *priv, FAR uint8_t *buffer,
                           off_t startblock, size_t nblocks)
 {
@@ -216,6 +270,83 @@ static ssize_t ftl_reload(FAR void *priv, FAR uint8_t *buffer,
 
   return nread;
 }
+#endif
+
+/****************************************************************************
+ * Name: ftl_cacheread
+ *
+ * Description:  Read the specified number of sectors, taking any that are
+ *               held in the erase block cache from there.
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_FTL_EBCACHE
+static FAR struct ftl_ebcache_s *ftl_cachefind(FAR struct ftl_struct_s *dev,
+                                              off_t eblock)
+{
+  int i;
+
+  for (i = 0; i < CONFIG_FTL_EBCACHE_NBLOCKS; i++)
+    {
+      if (dev->ebcache[i].eblock == eblock)
+        {
+          dev->ebcache[i].age = ++dev->ebage;
+          return &dev->ebcache[i];
+        }
+    }
+
+  return NULL;
+}
+
+static ssize_t ftl_cacheread(FAR void *priv, FAR uint8_t *buffer,
+                             off_t startblock, size_t nblocks)
+{
+  FAR struct ftl_struct_s *dev = (FAR struct ftl_struct_s *)priv;
+  FAR struct ftl_ebcache_s *ebc;
+  size_t remaining = nblocks;
+  off_t  block = startblock;
+  off_t  offset;
+  size_t count;
+  ssize_t nread;
+
+  nxsem_wait_uninterruptible(&dev->ebsem);
+
+  while (remaining > 0)
+    {
+      offset = block % dev->blkper;
+      count  = dev->blkper - offset;
+      if (count > remaining)
+        {
+          count = remaining;
+        }
+
+      ebc = ftl_cachefind(dev, block / dev->blkper);
+      if (ebc != NULL)
+        {
+          memcpy(buffer, ebc->buffer + offset * dev->geo.blocksize,
+                 count * dev->geo.blocksize);
+        }
+      else
+        {
+          nread = MTD_BREAD(dev->mtd, block, count, buffer);
+          if (nread != count)
+            {
+              ferr("ERROR: Read %d blocks starting at block %d failed: %d\n",
+                   count, block, nread);
+              nxsem_post(&dev->ebsem);
+              return nread < 0 ? nread : -EIO;
+            }
+        }
+
+      block     += count;
+      remaining -= count;
+      buffer    += count * dev->geo.blocksize;
+    }
+
+  nxsem_post(&dev->ebsem);
+  return nblocks;
+}
+#endif
 
 /****************************************************************************
  * Name: ftl_read
@@ -237,7 +368,7 @@ static ssize_t ftl_read(FAR struct inode *inode, unsigned char *buffer,
 #ifdef FTL_HAVE_RWBUFFER
   return rwb_read(&dev->rwb, start_sector, nsectors, buffer);
 #else
-  return ftl_reload(dev, buffer, start_sector, nsectors);
+  return FTL_RELOAD(dev, buffer, start_sector, nsectors);
 #endif
 }
 
@@ -248,7 +379,7 @@ static ssize_t ftl_read(FAR struct inode *inode, unsigned char *buffer,
  *
  ****************************************************************************/
 
-#ifdef CONFIG_FS_WRITABLE
+#if defined(CONFIG_FS_WRITABLE) && !defined(CONFIG_FTL_EBCACHE)
 static int ftl_alloc_eblock(FAR struct ftl_struct_s *dev)
 {
   if (dev->eblock == NULL)
@@ -444,6 +575,260 @@ static ssize_t ftl_flush(FAR void *priv, FAR const uint8_t *buffer,
 }
 #endif
 
+/****************************************************************************
+ * Name: ftl_cachewrite
+ *
+ * Description: Merge the specified sectors into the erase block cache.
+ *   Erase blocks that are completely rewritten and not cached are written
+ *   straight through; all others cost one erase cycle when written back.
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_FTL_EBCACHE
+static int ftl_cachewriteback(FAR struct ftl_struct_s *dev,
+                              FAR struct ftl_ebcache_s *ebc)
+{
+  off_t rwblock;
+  ssize_t nxfrd;
+  int ret;
+
+  if (!ebc->dirty)
+    {
+      return OK;
+    }
+
+  ret = MTD_ERASE(dev->mtd, ebc->eblock, 1);
+  if (ret < 0)
+    {
+      ferr("ERROR: Erase block=%d failed: %d\n", ebc->eblock, ret);
+      return ret;
+    }
+
+  rwblock = ebc->eblock * dev->blkper;
+  nxfrd   = MTD_BWRITE(dev->mtd, rwblock, dev->blkper, ebc->buffer);
+  if (nxfrd != dev->blkper)
+    {
+      ferr("ERROR: Write erase block %d failed: %d\n", rwblock, nxfrd);
+      return -EIO;
+    }
+
+  ebc->dirty = false;
+  return OK;
+}
+
+static int ftl_cacheget(FAR struct ftl_struct_s *dev, off_t eblock,
+                        FAR struct ftl_ebcache_s **ebcp)
+{
+  FAR struct ftl_ebcache_s *ebc;
+  ssize_t nxfrd;
+  int ret;
+  int i;
+
+  ebc = ftl_cachefind(dev, eblock);
+  if (ebc != NULL)
+    {
+      *ebcp = ebc;
+      return OK;
+    }
+
+  /* Use an empty entry if there is one, otherwise evict the least recently
+   * used entry.
+   */
+
+  ebc = &dev->ebcache[0];
+  for (i = 0; i < CONFIG_FTL_EBCACHE_NBLOCKS; i++)
+    {
+      if (dev->ebcache[i].eblock < 0)
+        {
+          ebc = &dev->ebcache[i];
+          break;
+        }
+
+      if ((int32_t)(dev->ebcache[i].age - ebc->age) < 0)
+        {
+          ebc = &dev->ebcache[i];
+        }
+    }
+
+  ret = ftl_cachewriteback(dev, ebc);
+  if (ret < 0)
+    {
+      return ret;
+    }
+
+  if (ebc->buffer == NULL)
+    {
+      ebc->buffer = (FAR uint8_t *)kmm_malloc(dev->geo.erasesize);
+      if (ebc->buffer == NULL)
+        {
+          ferr("ERROR: Failed to allocate an erase block buffer\n");
+          return -ENOMEM;
+        }
+    }
+
+  /* Read the full erase block into the cache */
+
+  ebc->eblock = -1;
+  nxfrd = MTD_BREAD(dev->mtd, eblock * dev->blkper, dev->blkper,
+                    ebc->buffer);
+  if (nxfrd != dev->blkper)
+    {
+      ferr("ERROR: Read erase block %d failed: %d\n", eblock, nxfrd);
+      return -EIO;
+    }
+
+  ebc->eblock = eblock;
+  ebc->age    = ++dev->ebage;
+  *ebcp       = ebc;
+  return OK;
+}
+
+#ifdef FTL_HAVE_EBFLUSHER
+static void ftl_cacheworker(FAR void *arg)
+{
+  ftl_cacheflush((FAR struct ftl_struct_s *)arg);
+}
+#endif
+
+static ssize_t ftl_cachewrite(FAR void *priv, FAR const uint8_t *buffer,
+                              off_t startblock, size_t nblocks)
+{
+  FAR struct ftl_struct_s *dev = (FAR struct ftl_struct_s *)priv;
+  FAR struct ftl_ebcache_s *ebc;
+  size_t remaining = nblocks;
+  off_t  block = startblock;
+  off_t  eblock;
+  off_t  offset;
+  size_t count;
+  ssize_t nxfrd;
+  int    ret = OK;
+
+  nxsem_wait_uninterruptible(&dev->ebsem);
+
+  while (remaining > 0)
+    {
+      eblock = block / dev->blkper;
+      offset = block % dev->blkper;
+      count  = dev->blkper - offset;
+      if (count > remaining)
+        {
+          count = remaining;
+        }
+
+      ebc = ftl_cachefind(dev, eblock);
+      if (ebc == NULL && count == dev->blkper)
+        {
+          /* A whole erase block that is not cached:  Write it through */
+
+          ret = MTD_ERASE(dev->mtd, eblock, 1);
+          if (ret < 0)
+            {
+              ferr("ERROR: Erase block=%d failed: %d\n", eblock, ret);
+              break;
+            }
+
+          nxfrd = MTD_BWRITE(dev->mtd, block, count, buffer);
+          if (nxfrd != count)
+            {
+              ferr("ERROR: Write erase block %d failed: %d\n", block, nxfrd);
+              ret = -EIO;
+              break;
+            }
+        }
+      else
+        {
+          ret = ftl_cacheget(dev, eblock, &ebc);
+          if (ret < 0)
+            {
+              break;
+            }
+
+          memcpy(ebc->buffer + offset * dev->geo.blocksize, buffer,
+                 count * dev->geo.blocksize);
+          ebc->dirty = true;
+        }
+
+      block     += count;
+      remaining -= count;
+      buffer    += count * dev->geo.blocksize;
+    }
+
+#ifdef FTL_HAVE_EBFLUSHER
+  if (work_available(&dev->ebwork))
+    {
+      work_queue(LPWORK, &dev->ebwork, ftl_cacheworker, dev,
+                 MSEC2TICK(CONFIG_FTL_EBCACHE_WRDELAY));
+    }
+#endif
+
+  nxsem_post(&dev->ebsem);
+  return ret < 0 ? ret : nblocks;
+}
+
+/****************************************************************************
+ * Name: ftl_cacheflush
+ *
+ * Description: Write back all dirty erase blocks in the cache
+ *
+ ****************************************************************************/
+
+static int ftl_cacheflush(FAR struct ftl_struct_s *dev)
+{
+  int ret = OK;
+  int err;
+  int i;
+
+  nxsem_wait_uninterruptible(&dev->ebsem);
+
+  for (i = 0; i < CONFIG_FTL_EBCACHE_NBLOCKS; i++)
+    {
+      err = ftl_cachewriteback(dev, &dev->ebcache[i]);
+      if (err < 0)
+        {
+          ret = err;
+        }
+    }
+
+  nxsem_post(&dev->ebsem);
+  return ret;
+}
+
+/****************************************************************************
+ * Name: ftl_cacheinitialize and ftl_cacheuninitialize
+ ****************************************************************************/
+
+static void ftl_cacheinitialize(FAR struct ftl_struct_s *dev)
+{
+  int i;
+
+  nxsem_init(&dev->ebsem, 0, 1);
+  for (i = 0; i < CONFIG_FTL_EBCACHE_NBLOCKS; i++)
+    {
+      dev->ebcache[i].eblock = -1;
+    }
+}
+
+static void ftl_cacheuninitialize(FAR struct ftl_struct_s *dev)
+{
+  int i;
+
+#ifdef FTL_HAVE_EBFLUSHER
+  work_cancel(LPWORK, &dev->ebwork);
+#endif
+  ftl_cacheflush(dev);
+
+  for (i = 0; i < CONFIG_FTL_EBCACHE_NBLOCKS; i++)
+    {
+      if (dev->ebcache[i].buffer != NULL)
+        {
+          kmm_free(dev->ebcache[i].buffer);
+        }
+    }
+
+  nxsem_destroy(&dev->ebsem);
+}
+#endif /* CONFIG_FTL_EBCACHE */
+
 /****************************************************************************
  * Name: ftl_write
  *
@@ -464,7 +849,7 @@ static ssize_t ftl_write(FAR struct inode *inode, const unsigned char *buffer,
 #ifdef FTL_HAVE_RWBUFFER
   return rwb_write(&dev->rwb, start_sector, nsectors, buffer);
 #else
-  return ftl_flush(dev, buffer, start_sector, nsectors);
+  return FTL_FLUSH(dev, buffer, start_sector, nsectors);
 #endif
 }
 #endif
@@ -548,10 +933,21 @@ static int ftl_ioctl(FAR struct inode *inode, int cmd, unsigned long arg)
 
       cmd = MTDIOC_XIPBASE;
     }
-#ifdef CONFIG_FTL_WRITEBUFFER
+#if defined(CONFIG_FTL_WRITEBUFFER) || defined(CONFIG_FTL_EBCACHE)
   else if (cmd == BIOC_FLUSH)
     {
-      return rwb_flush(&dev->rwb);
+      ret = OK;
+#ifdef CONFIG_FTL_WRITEBUFFER
+      ret = rwb_flush(&dev->rwb);
+#endif
+#ifdef CONFIG_FTL_EBCACHE
+      if (ret >= 0)
+        {
+          ret = ftl_cacheflush(dev);
+        }
+#endif
+
+      return ret;
     }
 #endif
 
@@ -590,6 +986,9 @@ static int ftl_unlink(FAR struct inode *inode)
 #ifdef FTL_HAVE_RWBUFFER
       rwb_uninitialize(&dev->rwb);
 #endif
+#ifdef CONFIG_FTL_EBCACHE
+      ftl_cacheuninitialize(dev);
+#endif
 #ifdef CONFIG_FS_WRITABLE
       if (dev->eblock)
         {
@@ -658,14 +1057,18 @@ int ftl_initialize_by_path(FAR const char *path, FAR struct mtd_dev_s *mtd)
       dev->blkper = dev->geo.erasesize / dev->geo.blocksize;
       DEBUGASSERT(dev->blkper * dev->geo.blocksize == dev->geo.erasesize);
 
+#ifdef CONFIG_FTL_EBCACHE
+      ftl_cacheinitialize(dev);
+#endif
+
       /* Configure read-ahead/write buffering */
 
 #ifdef FTL_HAVE_RWBUFFER
       dev->rwb.blocksize   = dev->geo.blocksize;
       dev->rwb.nblocks     = dev->geo.neraseblocks * dev->blkper;
       dev->rwb.dev         = (FAR void *)dev;
-      dev->rwb.wrflush     = ftl_flush;
-      dev->rwb.rhreload    = ftl_reload;
+      dev->rwb.wrflush     = FTL_FLUSH;
+      dev->rwb.rhreload    = FTL_RELOAD;
 
 #if defined(CONFIG_FS_WRITABLE) && defined(CONFIG_FTL_WRITEBUFFER)
       dev->rwb.wrmaxblocks = dev->blkper;
@@ -679,6 +1082,9 @@ int ftl_initialize_by_path(FAR const char *path, FAR struct mtd_dev_s *mtd)
       if (ret < 0)
         {
           ferr("ERROR: rwb_initialize failed: %d\n", ret);
+#ifdef CONFIG_FTL_EBCACHE
+          ftl_cacheuninitialize(dev);
+#endif
           kmm_free(dev);
           return ret;
         }
@@ -692,6 +1098,9 @@ int ftl_initialize_by_path(FAR const char *path, FAR struct mtd_dev_s *mtd)
           ferr("ERROR: register_blockdriver failed: %d\n", -ret);
 #ifdef FTL_HAVE_RWBUFFER
           rwb_uninitialize(&dev->rwb);
+#endif
+#ifdef CONFIG_FTL_EBCACHE
+          ftl_cacheuninitialize(dev);
 #endif
           kmm_free(dev);
         }
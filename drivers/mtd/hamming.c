@@ -47,6 +47,7 @@
 #include <nuttx/mtd/nand_config.h>
 
 #include <stdint.h>
+#include <string.h>
 #include <assert.h>
 #include <debug.h>
 
@@ -72,18 +73,38 @@
 
 static unsigned int hamming_bitsinbyte(uint8_t byte)
 {
-  unsigned int count = 0;
+  byte = byte - ((byte >> 1) & 0x55);
+  byte = (byte & 0x33) + ((byte >> 2) & 0x33);
+  return (byte + (byte >> 4)) & 0x0f;
+}
 
-  while (byte != 0)
-    {
-      if ((byte & 1) != 0)
-        {
-          count++;
-        }
-      byte >>= 1;
-    }
+/****************************************************************************
+ * Name: hamming_parity8
+ *
+ * Description:
+ *   Returns 1 if an odd number of bits is set in the given byte.
+ *
+ ****************************************************************************/
 
-  return count;
+static inline uint8_t hamming_parity8(uint8_t byte)
+{
+  byte ^= byte >> 4;
+  return (0x6996 >> (byte & 0x0f)) & 1;
+}
+
+/****************************************************************************
+ * Name: hamming_parity32
+ *
+ * Description:
+ *   Returns 1 if an odd number of bits is set in the given word.
+ *
+ ****************************************************************************/
+
+static inline uint8_t hamming_parity32(uint32_t word)
+{
+  word ^= word >> 16;
+  word ^= word >> 8;
+  return hamming_parity8((uint8_t)word);
 }
 
 /****************************************************************************
@@ -125,75 +146,117 @@ static uint8_t hamming_bitsincode256(FAR uint8_t *code)
 static void hamming_compute256(FAR const uint8_t *data, FAR uint8_t *code)
 {
   uint8_t colsum = 0;
-  uint8_t evenline = 0;
+  uint8_t evenline;
   uint8_t oddline = 0;
-  uint8_t evencol = 0;
-  uint8_t oddcol = 0;
+  uint8_t evencol;
+  uint8_t oddcol;
+  uint8_t parity;
   int i;
 
   /* Xor all bytes together to get the column sum;
-   * At the same time, calculate the even and odd line codes
+   * At the same time, calculate the odd line code.
+   *
+   * A byte has an incidence on the computed code only if the xor sum of its
+   * bits is 1.
+   *
+   * Parity groups are formed by forcing a particular index bit to 0
+   * (even) or 1 (odd).
+   * Example on one byte:
+   *
+   * bits (dec)  7   6   5   4   3   2   1   0
+   *      (bin) 111 110 101 100 011 010 001 000
+   *                            '---'---'---'----------.
+   *                                                   |
+   * groups P4' ooooooooooooooo eeeeeeeeeeeeeee P4     |
+   *        P2' ooooooo eeeeeee ooooooo eeeeeee P2     |
+   *        P1' ooo eee ooo eee ooo eee ooo eee P1     |
+   *                                                   |
+   * We can see that:                                  |
+   *  - P4  -> bit 2 of index is 0 --------------------'
+   *  - P4' -> bit 2 of index is 1.
+   *  - P2  -> bit 1 of index if 0.
+   *  - etc...
+   * We deduce that a bit position has an impact on all even Px if
+   * the log2(x)nth bit of its index is 0
+   *     ex: log2(4) = 2, bit2 of the index must be 0 (-> 0 1 2 3)
+   * and on all odd Px' if the log2(x)nth bit of its index is 1
+   *     ex: log2(2) = 1, bit1 of the index must be 1 (-> 0 1 4 5)
+   *
+   * As such, we calculate all the possible Px and Px' values at the
+   * same time in two variables, evenline and oddline, such as
+   *     evenline bits: P128  P64  P32  P16  P8  P4  P2  P1
+   *     oddline  bits: P128' P64' P32' P16' P8' P4' P2' P1'
+   *
+   * oddline is the xor of the indices of all bytes with odd parity.
    */
 
-  for (i = 0; i < 256; i++)
+  if (((uintptr_t)data & 3) == 0)
     {
-      colsum ^= data[i];
-
-      /* If the xor sum of the byte is 0, then this byte has no incidence on
-       * the computed code; so check if the sum is 1.
+      FAR const uint32_t *words = (FAR const uint32_t *)data;
+      uint32_t wordsum = 0;
+      uint32_t word;
+      uint8_t lanes[4];
+      uint8_t oddword = 0;
+
+      /* Process a word at a time.  Bits 2-7 of the index of a byte are the
+       * index of its word, so they go into oddline if the word has odd
+       * parity.
        */
 
-      if ((hamming_bitsinbyte(data[i]) & 1) == 1)
+      for (i = 0; i < 64; i++)
         {
-          /* Parity groups are formed by forcing a particular index bit to 0
-           * (even) or 1 (odd).
-           * Example on one byte:
-           *
-           * bits (dec)  7   6   5   4   3   2   1   0
-           *      (bin) 111 110 101 100 011 010 001 000
-           *                            '---'---'---'----------.
-           *                                                   |
-           * groups P4' ooooooooooooooo eeeeeeeeeeeeeee P4     |
-           *        P2' ooooooo eeeeeee ooooooo eeeeeee P2     |
-           *        P1' ooo eee ooo eee ooo eee ooo eee P1     |
-           *                                                   |
-           * We can see that:                                  |
-           *  - P4  -> bit 2 of index is 0 --------------------'
-           *  - P4' -> bit 2 of index is 1.
-           *  - P2  -> bit 1 of index if 0.
-           *  - etc...
-           * We deduce that a bit position has an impact on all even Px if
-           * the log2(x)nth bit of its index is 0
-           *     ex: log2(4) = 2, bit2 of the index must be 0 (-> 0 1 2 3)
-           * and on all odd Px' if the log2(x)nth bit of its index is 1
-           *     ex: log2(2) = 1, bit1 of the index must be 1 (-> 0 1 4 5)
-           *
-           * As such, we calculate all the possible Px and Px' values at the
-           * same time in two variables, evenline and oddline, such as
-           *     evenline bits: P128  P64  P32  P16  P8  P4  P2  P1
-           *     oddline  bits: P128' P64' P32' P16' P8' P4' P2' P1'
-           */
-
-          evenline ^= (255 - i);
-          oddline ^= i;
+          word     = words[i];
+          wordsum ^= word;
+
+          if (hamming_parity32(word))
+            {
+              oddword ^= i;
+            }
         }
-    }
 
-  /* At this point, we have the line parities, and the column sum. First, We
-   * must caculate the parity group values on the column sum.
-   */
+      /* Byte lane k of wordsum is the xor of all bytes whose index modulo
+       * 4 is k.  Bits 0 and 1 of oddline are the parities of the odd
+       * lanes (1 and 3) and of the upper lanes (2 and 3).
+       */
 
-  for (i = 0; i < 8; i++)
+      memcpy(lanes, &wordsum, 4);
+      colsum  = lanes[0] ^ lanes[1] ^ lanes[2] ^ lanes[3];
+      oddline = (oddword << 2) |
+                (hamming_parity8(lanes[2] ^ lanes[3]) << 1) |
+                hamming_parity8(lanes[1] ^ lanes[3]);
+    }
+  else
     {
-      if (colsum & 1)
+      for (i = 0; i < 256; i++)
         {
-          evencol ^= (7 - i);
-          oddcol ^= i;
-        }
+          colsum ^= data[i];
 
-      colsum >>= 1;
+          if (hamming_parity8(data[i]))
+            {
+              oddline ^= i;
+            }
+        }
     }
 
+  /* Each byte with odd parity goes into exactly one of Px and Px'.  So the
+   * even line code is the odd line code inverted if the number of such
+   * bytes, i.e. the parity of the whole block, is odd.
+   */
+
+  parity   = hamming_parity8(colsum);
+  evenline = parity ? ~oddline : oddline;
+
+  /* At this point, we have the line parities, and the column sum. Next, we
+   * must caculate the parity group values on the column sum in the same way:
+   * bit x of oddcol is the parity of the column bits whose index has bit x
+   * set.
+   */
+
+  oddcol   = (hamming_parity8(colsum & 0xf0) << 2) |
+             (hamming_parity8(colsum & 0xcc) << 1) |
+             hamming_parity8(colsum & 0xaa);
+  evencol  = parity ? oddcol ^ 7 : oddcol;
+
   /* Now, we must interleave the parity values, to obtain the following layout:
    * Code[0] = Line1
    * Code[1] = Line2
@@ -419,7 +482,7 @@ int hamming_verify256x(FAR uint8_t *data, size_t size, FAR const uint8_t *code)
 {
   ssize_t remaining = (ssize_t)size;
   int result = HAMMING_SUCCESS;
-  int ret;
+  int ret = HAMMING_SUCCESS;
 
   DEBUGASSERT((size & 0xff) == 0);
 
@@ -62,6 +62,7 @@
 #include <nuttx/mtd/nand_scheme.h>
 #include <nuttx/mtd/nand_model.h>
 #include <nuttx/mtd/nand_ecc.h>
+#include <nuttx/mtd/bchecc.h>
 
 /****************************************************************************
  * Pre-processor Definitions
@@ -854,6 +855,12 @@ FAR struct mtd_dev_s *nand_initialize(FAR struct nand_raw_s *raw)
         (FAR void *)raw->cmdaddr, (FAR void *)raw->addraddr,
         (FAR void *)raw->dataaddr);
 
+#ifdef CONFIG_MTD_NAND_SWECC_BCH
+  /* Build the BCH tables used by the software ECC */
+
+  bchecc_initialize();
+#endif
+
   /* Check if there is NAND connected on the EBI */
 
   if (!onfi_ebidetect(raw->cmdaddr, raw->addraddr, raw->dataaddr))
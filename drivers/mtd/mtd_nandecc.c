@@ -55,6 +55,7 @@
 
 #include <nuttx/mtd/nand.h>
 #include <nuttx/mtd/hamming.h>
+#include <nuttx/mtd/bchecc.h>
 #include <nuttx/mtd/nand_scheme.h>
 #include <nuttx/mtd/nand_ecc.h>
 
@@ -62,6 +63,39 @@
  * Pre-processor Definitions
  ****************************************************************************/
 
+/****************************************************************************
+ * Private Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: nandecc_bchoffset
+ *
+ * Description:
+ *   The BCH code does not fit the ECC positions of the spare schemes, which
+ *   are sized for the Hamming code.  It is instead stored at the end of the
+ *   spare area, one code for each 512 bytes of data.  Return the offset of
+ *   the code in the spare area.
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_MTD_NAND_SWECC_BCH
+static int nandecc_bchoffset(FAR const struct nand_scheme_s *scheme,
+                             unsigned int pagesize, unsigned int sparesize)
+{
+  unsigned int eccsize = (pagesize / BCHECC_SECTORSIZE) * BCHECC_ECCBYTES;
+
+  if ((pagesize % BCHECC_SECTORSIZE) != 0 || eccsize >= sparesize ||
+      sparesize - eccsize <= scheme->bbpos)
+    {
+      ferr("ERROR: No room for %u BCH ECC bytes in the spare area\n",
+           eccsize);
+      return -EINVAL;
+    }
+
+  return sparesize - eccsize;
+}
+#endif
+
 /****************************************************************************
  * Public Functions
  ****************************************************************************/
@@ -141,6 +175,24 @@ int nandecc_readpage(FAR struct nand_dev_s *nand, off_t block,
   /* Retrieve ECC information from page */
 
   scheme = nandmodel_getscheme(model);
+
+#ifdef CONFIG_MTD_NAND_SWECC_BCH
+  ret = nandecc_bchoffset(scheme, pagesize, sparesize);
+  if (ret < 0)
+    {
+      return ret;
+    }
+
+  /* Use the ECC data to verify and correct the page */
+
+  ret = bchecc_verify512x(data, pagesize, (FAR uint8_t *)spare + ret);
+  if (ret < 0)
+    {
+      ferr("ERROR: Block=%d page=%d Unrecoverable error: %d\n",
+           block, page, ret);
+      return -EIO;
+    }
+#else
   nandscheme_readecc(scheme, spare, raw->ecc);
 
   /* Use the ECC data to verify the page */
@@ -152,6 +204,7 @@ int nandecc_readpage(FAR struct nand_dev_s *nand, off_t block,
            block, page, ret);
       return -EIO;
     }
+#endif
 
   return OK;
 }
@@ -201,7 +254,9 @@ int nandecc_writepage(FAR struct nand_dev_s *nand, off_t block,
 
   pagesize  = nandmodel_getpagesize(model);
   sparesize = nandmodel_getsparesize(model);
+  scheme    = nandmodel_getscheme(model);
 
+#ifndef CONFIG_MTD_NAND_SWECC_BCH
   /* Set hamming code set to 0xffff.. to keep existing bytes */
 
   memset(raw->ecc, 0xff, CONFIG_MTD_NAND_MAXSPAREECCBYTES);
@@ -215,6 +270,8 @@ int nandecc_writepage(FAR struct nand_dev_s *nand, off_t block,
       hamming_compute256x(data, pagesize, raw->ecc);
     }
 
+#endif
+
   /* Store code in spare buffer, either the buffer provided by the caller or
    * the scatch buffer in the raw NAND structure.
    */
@@ -227,8 +284,28 @@ int nandecc_writepage(FAR struct nand_dev_s *nand, off_t block,
 
   /* Write the ECC */
 
-  scheme = nandmodel_getscheme(model);
+#ifdef CONFIG_MTD_NAND_SWECC_BCH
+  ret = nandecc_bchoffset(scheme, pagesize, sparesize);
+  if (ret < 0)
+    {
+      return ret;
+    }
+
+  /* Compute the BCH code on the data.  Without data the code is left
+   * erased to keep the existing bytes.
+   */
+
+  if (data)
+    {
+      bchecc_compute512x(data, pagesize, (FAR uint8_t *)spare + ret);
+    }
+  else
+    {
+      memset((FAR uint8_t *)spare + ret, 0xff, sparesize - ret);
+    }
+#else
   nandscheme_writeecc(scheme, spare, raw->ecc);
+#endif
 
   /* Perform page write operation */
 
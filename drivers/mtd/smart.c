@@ -58,7 +58,10 @@
 #include <crc32.h>
 #include <debug.h>
 
+#include <nuttx/clock.h>
 #include <nuttx/kmalloc.h>
+#include <nuttx/semaphore.h>
+#include <nuttx/wqueue.h>
 #include <nuttx/fs/fs.h>
 #include <nuttx/fs/ioctl.h>
 #include <nuttx/mtd/mtd.h>
@@ -289,6 +292,10 @@ struct smart_struct_s
   size_t                bytesalloc;
   struct smart_alloc_s  alloc[SMART_MAX_ALLOCS];   /* Array of memory allocations */
 #endif
+#ifdef CONFIG_MTD_SMART_BGGC
+  sem_t                 exclsem;          /* Device access lock */
+  struct work_s         gcwork;           /* Background GC work */
+#endif
 };
 
 #ifdef CONFIG_SMARTFS_MULTI_ROOT_DIRS
@@ -414,6 +421,15 @@ static ssize_t smart_write(FAR struct inode *inode, const unsigned char *buffer,
 #endif
 static int     smart_geometry(FAR struct inode *inode, struct geometry *geometry);
 static int     smart_ioctl(FAR struct inode *inode, int cmd, unsigned long arg);
+#ifdef CONFIG_MTD_SMART_BGGC
+static ssize_t smart_lockread(FAR struct inode *inode, unsigned char *buffer,
+                 size_t start_sector, unsigned int nsectors);
+static ssize_t smart_lockwrite(FAR struct inode *inode,
+                 const unsigned char *buffer, size_t start_sector,
+                 unsigned int nsectors);
+static int     smart_lockioctl(FAR struct inode *inode, int cmd,
+                 unsigned long arg);
+#endif
 
 static int     smart_findfreephyssector(FAR struct smart_struct_s *dev,
                                         uint8_t canrelocate);
@@ -454,16 +470,23 @@ static int     smart_loop_ioctl(FAR struct file *filep, int cmd, unsigned long a
 
 static const struct block_operations g_bops =
 {
-  smart_open,     /* open     */
-  smart_close,    /* close    */
-  smart_read,     /* read     */
+  smart_open,      /* open     */
+  smart_close,     /* close    */
+#ifdef CONFIG_MTD_SMART_BGGC
+  smart_lockread,  /* read     */
+  smart_lockwrite, /* write    */
+  smart_geometry,  /* geometry */
+  smart_lockioctl  /* ioctl    */
+#else
+  smart_read,      /* read     */
 #ifdef CONFIG_FS_WRITABLE
-  smart_write,    /* write    */
+  smart_write,     /* write    */
 #else
-  NULL,           /* write    */
+  NULL,            /* write    */
+#endif
+  smart_geometry,  /* geometry */
+  smart_ioctl      /* ioctl    */
 #endif
-  smart_geometry, /* geometry */
-  smart_ioctl     /* ioctl    */
 };
 
 #ifdef CONFIG_SMART_DEV_LOOP
@@ -3915,26 +3938,114 @@ retry:
 }
 
 /****************************************************************************
- * Name: smart_garbagecollect
+ * Name: smart_collectblock
  *
- * Description:  Performs garbage collection if needed.  This is determined
- *               by the count of released sectors relative to free and
- *               total sectors.
+ * Description:  Relocates the active sectors of the erase block with the
+ *               most released sectors and erases it.  Only blocks with at
+ *               least minrelease released sectors are considered.
  *
  ****************************************************************************/
 
 #ifdef CONFIG_FS_WRITABLE
-static int smart_garbagecollect(FAR struct smart_struct_s *dev)
+static int smart_collectblock(FAR struct smart_struct_s *dev,
+                              uint16_t minrelease)
 {
   uint16_t  collectblock;
   uint16_t  releasemax;
-  bool      collect = TRUE;
   int       x;
   int       ret;
 #ifdef CONFIG_MTD_SMART_PACK_COUNTS
   uint8_t   count;
 #endif
 
+  /* Find the block with the most released sectors */
+
+  collectblock = 0xffff;
+  releasemax = minrelease - 1;
+  for (x = 0; x < dev->neraseblocks; x++)
+    {
+#ifdef CONFIG_MTD_SMART_WEAR_LEVEL
+      /* Don't collect blocks that have been worn completely */
+
+      if (smart_get_wear_level(dev, x) >= SMART_WEAR_REORG_THRESHOLD)
+        {
+          continue;
+        }
+#endif
+
+#ifdef CONFIG_MTD_SMART_PACK_COUNTS
+      count = smart_get_count(dev, dev->releasecount, x);
+      if (count > releasemax)
+        {
+          releasemax = count;
+          collectblock = x;
+        }
+#else
+      if (dev->releasecount[x] > releasemax)
+        {
+          releasemax = dev->releasecount[x];
+          collectblock = x;
+        }
+#endif
+    }
+
+  if (collectblock == 0xffff)
+    {
+      /* Need to collect, but no sectors with released blocks! */
+
+      return -ENOSPC;
+    }
+
+#ifdef CONFIG_SMART_LOCAL_CHECKFREE
+  if (smart_checkfree(dev, __LINE__) != OK)
+    {
+      fwarn("   ...before collecting block %d\n", collectblock);
+    }
+#endif
+
+#ifdef CONFIG_MTD_SMART_PACK_COUNTS
+  finfo("Collecting block %d, free=%d released=%d, "
+        "totalfree=%d, totalrelease=%d\n",
+        collectblock,
+        smart_get_count(dev, dev->freecount, collectblock),
+        smart_get_count(dev, dev->releasecount, collectblock),
+        dev->freesectors, dev->releasesectors);
+#else
+  finfo("Collecting block %d, free=%d released=%d\n",
+        collectblock, dev->freecount[collectblock],
+        dev->releasecount[collectblock]);
+#endif
+
+  /* Relocate the active data in the collection block */
+
+  ret = smart_relocate_block(dev, collectblock);
+
+#ifdef CONFIG_SMART_LOCAL_CHECKFREE
+  if (smart_checkfree(dev, __LINE__) != OK)
+    {
+      fwarn("   ...while collecting block %d\n", collectblock);
+    }
+#endif
+
+  return ret;
+}
+#endif /* CONFIG_FS_WRITABLE */
+
+/****************************************************************************
+ * Name: smart_garbagecollect
+ *
+ * Description:  Performs garbage collection if needed.  This is determined
+ *               by the count of released sectors relative to free and
+ *               total sectors.
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_FS_WRITABLE
+static int smart_garbagecollect(FAR struct smart_struct_s *dev)
+{
+  bool      collect = TRUE;
+  int       ret;
+
   while (collect)
     {
       collect = FALSE;
@@ -3960,93 +4071,107 @@ static int smart_garbagecollect(FAR struct smart_struct_s *dev)
 
       if (collect)
         {
-          /* Find the block with the most released sectors */
-
-          collectblock = 0xffff;
-          releasemax = 0;
-          for (x = 0; x < dev->neraseblocks; x++)
+          ret = smart_collectblock(dev, 1);
+          if (ret != OK)
             {
-#ifdef CONFIG_MTD_SMART_WEAR_LEVEL
-              /* Don't collect blocks that have been worn completely */
+              return ret;
+            }
+        }
+    }
 
-              if (smart_get_wear_level(dev, x) >= SMART_WEAR_REORG_THRESHOLD)
-                {
-                  continue;
-                }
-#endif
+  return OK;
+}
+#endif /* CONFIG_FS_WRITABLE */
 
-#ifdef CONFIG_MTD_SMART_PACK_COUNTS
-              count = smart_get_count(dev, dev->releasecount, x);
-              if (count > releasemax)
-                {
-                  releasemax = count;
-                  collectblock = x;
-                }
-#else
-              if (dev->releasecount[x] > releasemax)
-                {
-                  releasemax = dev->releasecount[x];
-                  collectblock = x;
-                }
-#endif
-            }
+/****************************************************************************
+ * Name: smart_bggc_needed
+ *
+ * Description:  Returns true if the free sector pool is below the background
+ *               garbage collection reserve and at least one erase block has
+ *               enough released sectors to make collecting it worthwhile.
+ *
+ ****************************************************************************/
 
-#if 0
-          releasemax = smart_get_count(dev, dev->releasecount, collectblock);
-#endif
+#ifdef CONFIG_MTD_SMART_BGGC
+static bool smart_bggc_needed(FAR struct smart_struct_s *dev)
+{
+  uint32_t reserve;
 
-          if (collectblock == 0xffff)
-            {
-              /* Need to collect, but no sectors with released blocks! */
+  if (dev->formatstatus != SMART_FMT_STAT_FORMATTED ||
+      dev->releasecount == NULL)
+    {
+      return false;
+    }
 
-              ret = -ENOSPC;
-              goto errout;
-            }
+  reserve = (uint32_t)CONFIG_MTD_SMART_BGGC_RESERVE * dev->availsectperblk +
+            dev->sectorsperblk + 4;
 
-#ifdef CONFIG_SMART_LOCAL_CHECKFREE
-          if (smart_checkfree(dev, __LINE__) != OK)
-            {
-              fwarn("   ...before collecting block %d\n", collectblock);
-            }
-#endif
+  return dev->freesectors < reserve &&
+         dev->releasesectors >= (dev->availsectperblk >> 1);
+}
 
-#ifdef CONFIG_MTD_SMART_PACK_COUNTS
-          finfo("Collecting block %d, free=%d released=%d, "
-                "totalfree=%d, totalrelease=%d\n",
-                collectblock,
-                smart_get_count(dev, dev->freecount, collectblock),
-                smart_get_count(dev, dev->releasecount, collectblock),
-                dev->freesectors, dev->releasesectors);
-#else
-          finfo("Collecting block %d, free=%d released=%d\n",
-                collectblock, dev->freecount[collectblock],
-                dev->releasecount[collectblock]);
-#endif
+/****************************************************************************
+ * Name: smart_bggc_worker
+ *
+ * Description:  Low priority work queue worker that collects one erase
+ *               block per invocation, rescheduling itself until the reserve
+ *               of free sectors has been restored.  The device is released
+ *               between blocks so foreground accesses are delayed by at most
+ *               one block relocation.
+ *
+ ****************************************************************************/
 
-          /* Relocate the active data in the collection block */
+static void smart_bggc_worker(FAR void *arg)
+{
+  FAR struct smart_struct_s *dev = (FAR struct smart_struct_s *)arg;
+  uint16_t minrelease;
+  int ret;
 
-          ret = smart_relocate_block(dev, collectblock);
+  ret = nxsem_wait_uninterruptible(&dev->exclsem);
+  if (ret < 0)
+    {
+      return;
+    }
 
-#ifdef CONFIG_SMART_LOCAL_CHECKFREE
-          if (smart_checkfree(dev, __LINE__) != OK)
-            {
-              fwarn("   ...while collecting block %d\n", collectblock);
-            }
-#endif
+  if (smart_bggc_needed(dev))
+    {
+      /* Only collect blocks that will yield at least half a block of free
+       * sectors; anything less is left to the foreground collector.
+       */
 
-          if (ret != OK)
-            {
-              goto errout;
-            }
+      minrelease = dev->availsectperblk >> 1;
+      if (minrelease == 0)
+        {
+          minrelease = 1;
+        }
+
+      ret = smart_collectblock(dev, minrelease);
+      if (ret == OK && smart_bggc_needed(dev))
+        {
+          work_queue(LPWORK, &dev->gcwork, smart_bggc_worker, dev, 0);
         }
     }
 
-  return OK;
+  nxsem_post(&dev->exclsem);
+}
 
-errout:
-  return ret;
+/****************************************************************************
+ * Name: smart_bggc_schedule
+ *
+ * Description:  Schedules background garbage collection if it is needed and
+ *               not already pending.  Called with the device locked.
+ *
+ ****************************************************************************/
+
+static void smart_bggc_schedule(FAR struct smart_struct_s *dev)
+{
+  if (work_available(&dev->gcwork) && smart_bggc_needed(dev))
+    {
+      work_queue(LPWORK, &dev->gcwork, smart_bggc_worker, dev,
+                 MSEC2TICK(CONFIG_MTD_SMART_BGGC_DELAY));
+    }
 }
-#endif /* CONFIG_FS_WRITABLE */
+#endif /* CONFIG_MTD_SMART_BGGC */
 
 /****************************************************************************
  * Name: smart_write_wearstatus
@@ -5554,6 +5679,81 @@ ok_out:
   return ret;
 }
 
+/****************************************************************************
+ * Name: smart_lockread, smart_lockwrite and smart_lockioctl
+ *
+ * Description: Serialize block driver accesses against background garbage
+ *              collection, and schedule collection once the access
+ *              completes.
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_MTD_SMART_BGGC
+static FAR struct smart_struct_s *smart_inodedev(FAR struct inode *inode)
+{
+  DEBUGASSERT(inode && inode->i_private);
+#ifdef CONFIG_SMARTFS_MULTI_ROOT_DIRS
+  return ((FAR struct smart_multiroot_device_s *)inode->i_private)->dev;
+#else
+  return (FAR struct smart_struct_s *)inode->i_private;
+#endif
+}
+
+static ssize_t smart_lockread(FAR struct inode *inode, unsigned char *buffer,
+                              size_t start_sector, unsigned int nsectors)
+{
+  FAR struct smart_struct_s *dev = smart_inodedev(inode);
+  ssize_t ret;
+
+  ret = nxsem_wait(&dev->exclsem);
+  if (ret < 0)
+    {
+      return ret;
+    }
+
+  ret = smart_read(inode, buffer, start_sector, nsectors);
+  nxsem_post(&dev->exclsem);
+  return ret;
+}
+
+static ssize_t smart_lockwrite(FAR struct inode *inode,
+                               const unsigned char *buffer,
+                               size_t start_sector, unsigned int nsectors)
+{
+  FAR struct smart_struct_s *dev = smart_inodedev(inode);
+  ssize_t ret;
+
+  ret = nxsem_wait(&dev->exclsem);
+  if (ret < 0)
+    {
+      return ret;
+    }
+
+  ret = smart_write(inode, buffer, start_sector, nsectors);
+  smart_bggc_schedule(dev);
+  nxsem_post(&dev->exclsem);
+  return ret;
+}
+
+static int smart_lockioctl(FAR struct inode *inode, int cmd,
+                           unsigned long arg)
+{
+  FAR struct smart_struct_s *dev = smart_inodedev(inode);
+  int ret;
+
+  ret = nxsem_wait(&dev->exclsem);
+  if (ret < 0)
+    {
+      return ret;
+    }
+
+  ret = smart_ioctl(inode, cmd, arg);
+  smart_bggc_schedule(dev);
+  nxsem_post(&dev->exclsem);
+  return ret;
+}
+#endif /* CONFIG_MTD_SMART_BGGC */
+
 #ifdef CONFIG_MTD_SMART_FSCK
 
 /****************************************************************************
@@ -6076,6 +6276,9 @@ int smart_initialize(int minor, FAR struct mtd_dev_s *mtd, FAR const char *partn
       /* Initialize the SMART device structure */
 
       dev->mtd = mtd;
+#ifdef CONFIG_MTD_SMART_BGGC
+      nxsem_init(&dev->exclsem, 0, 1);
+#endif
 
       /* Get the device geometry. (casting to uintptr_t first eliminates
        * complaints on some architectures where the sizeof long is different
@@ -6225,6 +6428,9 @@ errout:
     }
 #endif
 
+#ifdef CONFIG_MTD_SMART_BGGC
+  nxsem_destroy(&dev->exclsem);
+#endif
   kmm_free(dev);
   return ret;
 }
@@ -6339,6 +6545,14 @@ static int smart_loteardown(FAR const char *devname)
 
   close_blockdriver(inode);
 
+#ifdef CONFIG_MTD_SMART_BGGC
+  /* Wait for any background collection in progress and cancel the next */
+
+  nxsem_wait_uninterruptible(&dev->exclsem);
+  work_cancel(LPWORK, &dev->gcwork);
+  nxsem_destroy(&dev->exclsem);
+#endif
+
   /* Now teardown the filemtd */
 
   filemtd_teardown(dev->mtd);
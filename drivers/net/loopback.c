@@ -515,6 +515,13 @@ int localhost_initialize(void)
   priv->lo_dev.d_ifup    = lo_ifup;      /* I/F up (new IP address) callback */
   priv->lo_dev.d_ifdown  = lo_ifdown;    /* I/F down callback */
   priv->lo_dev.d_txavail = lo_txavail;   /* New TX data callback */
+#ifdef CONFIG_NETDEV_OFFLOAD
+  /* Looped back packets cannot be corrupted, so there is no need to
+   * calculate or check their checksums.
+   */
+
+  priv->lo_dev.d_features = NETDEV_FEATURE_TXCSUM | NETDEV_FEATURE_RXCSUM;
+#endif
 #ifdef CONFIG_NET_MCASTGROUP
   priv->lo_dev.d_addmac  = lo_addmac;    /* Add multicast MAC address */
   priv->lo_dev.d_rmmac   = lo_rmmac;     /* Remove multicast MAC address */
@@ -56,6 +56,10 @@
 #include <nuttx/net/arp.h>
 #include <nuttx/net/netdev.h>
 
+#ifdef CONFIG_NETDEV_RXQUEUE
+#  include <nuttx/mm/iob.h>
+#endif
+
 #ifdef CONFIG_NET_PKT
 #  include <nuttx/net/pkt.h>
 #endif
@@ -162,6 +166,7 @@ static int  skel_txpoll(FAR struct net_driver_s *dev);
 /* Interrupt handling */
 
 static void skel_reply(struct skel_driver_s *priv)
+static void skel_dispatch(FAR struct net_driver_s *dev);
 static void skel_receive(FAR struct skel_driver_s *priv);
 static void skel_txdone(FAR struct skel_driver_s *priv);
 
@@ -381,13 +386,13 @@ static void skel_reply(struct skel_driver_s *priv)
 }
 
 /****************************************************************************
- * Name: skel_receive
+ * Name: skel_dispatch
  *
  * Description:
- *   An interrupt was received indicating the availability of a new RX packet
+ *   Pass the received packet in d_buf to the network and send any reply.
  *
  * Input Parameters:
- *   priv - Reference to the driver state structure
+ *   dev - Reference to the NuttX driver state structure
  *
  * Returned Value:
  *   None
@@ -397,90 +402,141 @@ static void skel_reply(struct skel_driver_s *priv)
  *
  ****************************************************************************/
 
-static void skel_receive(FAR struct skel_driver_s *priv)
+static void skel_dispatch(FAR struct net_driver_s *dev)
 {
-  do
-    {
-      /* Check for errors and update statistics */
-
-      /* Check if the packet is a valid size for the network buffer
-       * configuration.
-       */
-
-      /* Copy the data data from the hardware to priv->sk_dev.d_buf.  Set
-       * amount of data in priv->sk_dev.d_len
-       */
+  FAR struct skel_driver_s *priv =
+    (FAR struct skel_driver_s *)dev->d_private;
 
 #ifdef CONFIG_NET_PKT
-      /* When packet sockets are enabled, feed the frame into the packet tap */
+  /* When packet sockets are enabled, feed the frame into the packet tap */
 
-       pkt_input(&priv->sk_dev);
+  pkt_input(&priv->sk_dev);
 #endif
 
 #ifdef CONFIG_NET_IPv4
-      /* Check for an IPv4 packet */
+  /* Check for an IPv4 packet */
 
-      if (BUF->type == HTONS(ETHTYPE_IP))
-        {
-          ninfo("IPv4 frame\n");
-          NETDEV_RXIPV4(&priv->sk_dev);
+  if (BUF->type == HTONS(ETHTYPE_IP))
+    {
+      ninfo("IPv4 frame\n");
+      NETDEV_RXIPV4(&priv->sk_dev);
 
-          /* Handle ARP on input, then dispatch IPv4 packet to the network
-           * layer.
-           */
+      /* Handle ARP on input, then dispatch IPv4 packet to the network
+       * layer.
+       */
 
-          arp_ipin(&priv->sk_dev);
-          ipv4_input(&priv->sk_dev);
+      arp_ipin(&priv->sk_dev);
+      ipv4_input(&priv->sk_dev);
 
-          /* Check for a reply to the IPv4 packet */
+      /* Check for a reply to the IPv4 packet */
 
-          skel_reply(priv);
-        }
-      else
+      skel_reply(priv);
+    }
+  else
 #endif
 #ifdef CONFIG_NET_IPv6
-      /* Check for an IPv6 packet */
+  /* Check for an IPv6 packet */
 
-      if (BUF->type == HTONS(ETHTYPE_IP6))
-        {
-          ninfo("Iv6 frame\n");
-          NETDEV_RXIPV6(&priv->sk_dev);
+  if (BUF->type == HTONS(ETHTYPE_IP6))
+    {
+      ninfo("Iv6 frame\n");
+      NETDEV_RXIPV6(&priv->sk_dev);
 
-          /* Dispatch IPv6 packet to the network layer */
+      /* Dispatch IPv6 packet to the network layer */
 
-          ipv6_input(&priv->sk_dev);
+      ipv6_input(&priv->sk_dev);
 
-          /* Check for a reply to the IPv6 packet */
+      /* Check for a reply to the IPv6 packet */
 
-          skel_reply(priv);
-        }
-      else
+      skel_reply(priv);
+    }
+  else
 #endif
 #ifdef CONFIG_NET_ARP
-      /* Check for an ARP packet */
+  /* Check for an ARP packet */
 
-      if (BUF->type == htons(ETHTYPE_ARP))
-        {
-          /* Dispatch ARP packet to the network layer */
+  if (BUF->type == htons(ETHTYPE_ARP))
+    {
+      /* Dispatch ARP packet to the network layer */
 
-          arp_arpin(&priv->sk_dev);
-          NETDEV_RXARP(&priv->sk_dev);
+      arp_arpin(&priv->sk_dev);
+      NETDEV_RXARP(&priv->sk_dev);
 
-          /* If the above function invocation resulted in data that should be
-           * sent out on the network, the field  d_len will set to a value
-           * > 0.
-           */
+      /* If the above function invocation resulted in data that should be
+       * sent out on the network, the field  d_len will set to a value
+       * > 0.
+       */
 
-          if (priv->sk_dev.d_len > 0)
-            {
-              skel_transmit(priv);
-            }
+      if (priv->sk_dev.d_len > 0)
+        {
+          skel_transmit(priv);
         }
-      else
+    }
+  else
 #endif
+    {
+      NETDEV_RXDROPPED(&priv->sk_dev);
+    }
+}
+
+/****************************************************************************
+ * Name: skel_receive
+ *
+ * Description:
+ *   An interrupt was received indicating the availability of a new RX packet
+ *
+ * Input Parameters:
+ *   priv - Reference to the driver state structure
+ *
+ * Returned Value:
+ *   None
+ *
+ * Assumptions:
+ *   The device is locked (see netdev_lock()).  The network is locked here
+ *   only while calling into the network stack.
+ *
+ ****************************************************************************/
+
+static void skel_receive(FAR struct skel_driver_s *priv)
+{
+#ifdef CONFIG_NETDEV_RXQUEUE
+  FAR struct iob_s *iob;
+#endif
+
+  do
+    {
+      /* Check for errors and update statistics */
+
+      /* Check if the packet is a valid size for the network buffer
+       * configuration.
+       */
+
+#ifdef CONFIG_NETDEV_RXQUEUE
+      /* Copy the data from the hardware into an I/O buffer chain with
+       * iob_trycopyin() and queue it.  The network picks it up in a batch
+       * with the other queued packets and calls skel_dispatch() for it.
+       */
+
+      iob = iob_tryalloc(false, IOBUSER_NET_RXQUEUE);
+      if (iob == NULL)
         {
           NETDEV_RXDROPPED(&priv->sk_dev);
         }
+      else
+        {
+          netdev_rxqueue(&priv->sk_dev, iob);
+        }
+#else
+      /* Copy the data data from the hardware to priv->sk_dev.d_buf.  Set
+       * amount of data in priv->sk_dev.d_len
+       */
+
+      /* Lock the network while the packet is dispatched */
+
+      net_lock();
+      skel_dispatch(&priv->sk_dev);
+      net_unlock();
+#endif
     }
   while (); /* While there are more packets to be processed */
 }
@@ -498,7 +554,8 @@ static void skel_receive(FAR struct skel_driver_s *priv)
  *   None
  *
  * Assumptions:
- *   The network is locked.
+ *   The device is locked (see netdev_lock()).  The network is locked here
+ *   only while calling into the network stack.
  *
  ****************************************************************************/
 
@@ -522,7 +579,9 @@ static void skel_txdone(FAR struct skel_driver_s *priv)
 
   /* In any event, poll the network for new TX data */
 
+  net_lock();
   devif_poll(&priv->sk_dev, skel_txpoll);
+  net_unlock();
 }
 
 /****************************************************************************
@@ -546,13 +605,14 @@ static void skel_interrupt_work(FAR void *arg)
 {
   FAR struct skel_driver_s *priv = (FAR struct skel_driver_s *)arg;
 
-  /* Lock the network and serialize driver operations if necessary.
+  /* Lock the device and serialize driver operations if necessary.
    * NOTE: Serialization is only required in the case where the driver work
    * is performed on an LP worker thread and where more than one LP worker
-   * thread has been configured.
+   * thread has been configured.  The network itself is only locked while
+   * calling into the network stack.
    */
 
-  net_lock();
+  netdev_lock(&priv->sk_dev);
 
   /* Process pending Ethernet interrupts */
 
@@ -570,7 +630,7 @@ static void skel_interrupt_work(FAR void *arg)
    */
 
   skel_txdone(priv);
-  net_unlock();
+  netdev_unlock(&priv->sk_dev);
 
   /* Re-enable Ethernet interrupts */
 
@@ -644,13 +704,14 @@ static void skel_txtimeout_work(FAR void *arg)
 {
   FAR struct skel_driver_s *priv = (FAR struct skel_driver_s *)arg;
 
-  /* Lock the network and serialize driver operations if necessary.
+  /* Lock the device and serialize driver operations if necessary.
    * NOTE: Serialization is only required in the case where the driver work
    * is performed on an LP worker thread and where more than one LP worker
-   * thread has been configured.
+   * thread has been configured.  The network itself is only locked while
+   * calling into the network stack.
    */
 
-  net_lock();
+  netdev_lock(&priv->sk_dev);
 
   /* Increment statistics and dump debug info */
 
@@ -660,8 +721,10 @@ static void skel_txtimeout_work(FAR void *arg)
 
   /* Then poll the network for new XMIT data */
 
+  net_lock();
   devif_poll(&priv->sk_dev, skel_txpoll);
   net_unlock();
+  netdev_unlock(&priv->sk_dev);
 }
 
 /****************************************************************************
@@ -721,13 +784,14 @@ static void skel_poll_work(FAR void *arg)
 {
   FAR struct skel_driver_s *priv = (FAR struct skel_driver_s *)arg;
 
-  /* Lock the network and serialize driver operations if necessary.
+  /* Lock the device and serialize driver operations if necessary.
    * NOTE: Serialization is only required in the case where the driver work
    * is performed on an LP worker thread and where more than one LP worker
-   * thread has been configured.
+   * thread has been configured.  The network itself is only locked while
+   * calling into the network stack.
    */
 
-  net_lock();
+  netdev_lock(&priv->sk_dev);
 
   /* Perform the poll */
 
@@ -740,13 +804,15 @@ static void skel_poll_work(FAR void *arg)
    * progress, we will missing TCP time state updates?
    */
 
+  net_lock();
   devif_timer(&priv->sk_dev, skeleton_WDDELAY, skel_txpoll);
+  net_unlock();
 
   /* Setup the watchdog poll timer again */
 
   wd_start(priv->sk_txpoll, skeleton_WDDELAY, skel_poll_expiry, 1,
            (wdparm_t)priv);
-  net_unlock();
+  netdev_unlock(&priv->sk_dev);
 }
 
 /****************************************************************************
@@ -865,6 +931,12 @@ static int skel_ifdown(FAR struct net_driver_s *dev)
   wd_cancel(priv->sk_txpoll);
   wd_cancel(priv->sk_txtimeout);
 
+#ifdef CONFIG_NETDEV_RXQUEUE
+  /* Discard received packets that the network has not picked up yet */
+
+  netdev_rxqueue_flush(&priv->sk_dev);
+#endif
+
   /* Put the EMAC in its reset, non-operational state.  This should be
    * a known configuration that will guarantee the skel_ifup() always
    * successfully brings the interface back up.
@@ -898,13 +970,14 @@ static void skel_txavail_work(FAR void *arg)
 {
   FAR struct skel_driver_s *priv = (FAR struct skel_driver_s *)arg;
 
-  /* Lock the network and serialize driver operations if necessary.
+  /* Lock the device and serialize driver operations if necessary.
    * NOTE: Serialization is only required in the case where the driver work
    * is performed on an LP worker thread and where more than one LP worker
-   * thread has been configured.
+   * thread has been configured.  The network itself is only locked while
+   * calling into the network stack.
    */
 
-  net_lock();
+  netdev_lock(&priv->sk_dev);
 
   /* Ignore the notification if the interface is not yet up */
 
@@ -914,10 +987,12 @@ static void skel_txavail_work(FAR void *arg)
 
       /* If so, then poll the network for new XMIT data */
 
+      net_lock();
       devif_poll(&priv->sk_dev, skel_txpoll);
+      net_unlock();
     }
 
-  net_unlock();
+  netdev_unlock(&priv->sk_dev);
 }
 
 /****************************************************************************
@@ -1183,6 +1258,12 @@ int skel_initialize(int intf)
 #endif
   priv->sk_dev.d_private = (FAR void *)g_skel; /* Used to recover private state from dev */
 
+#ifdef CONFIG_NETDEV_RXQUEUE
+  /* Received packets are queued and passed to skel_dispatch() in batches */
+
+  netdev_rxqueue_init(&priv->sk_dev, skel_dispatch);
+#endif
+
   /* Create a watchdog for timing polling for and timing of transmissions */
 
   priv->sk_txpoll        = wd_create();   /* Create periodic poll timer */
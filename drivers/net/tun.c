@@ -99,6 +99,14 @@
 #  define CONFIG_TUN_NINTERFACES 1
 #endif
 
+/* CONFIG_TUN_NQUEUE determines the number of outgoing packets that may be
+ * queued for the application.
+ */
+
+#ifndef CONFIG_TUN_NQUEUE
+#  define CONFIG_TUN_NQUEUE 1
+#endif
+
 /* Make sure that packet buffers include in configured guard size and are an
  * even multiple of 16-bits in length.
  */
@@ -140,14 +148,17 @@ struct tun_device_s
   FAR struct pollfd *poll_fds;
   sem_t             waitsem;
   sem_t             read_wait_sem;
-  size_t            read_d_len;
+  uint8_t           offload;   /* TUN_F_* read/write format */
+  uint8_t           read_head; /* Oldest packet queued in read_buf[] */
+  uint8_t           read_nq;   /* Number of packets queued in read_buf[] */
+  size_t            read_d_len[CONFIG_TUN_NQUEUE];
   size_t            write_d_len;
 
   /* These packet buffer arrays required 16-bit alignment.  That alignment
    * is assured only by the preceding wide data types.
    */
 
-  uint8_t           read_buf[NET_TUN_PKTSIZE];
+  uint8_t           read_buf[CONFIG_TUN_NQUEUE][NET_TUN_PKTSIZE];
   uint8_t           write_buf[NET_TUN_PKTSIZE];
 
   /* This holds the information visible to the NuttX network */
@@ -171,6 +182,9 @@ static void tun_unlock(FAR struct tun_device_s *priv);
 /* Common TX logic */
 
 static int  tun_fd_transmit(FAR struct tun_device_s *priv);
+static FAR uint8_t *tun_read_slot(FAR struct tun_device_s *priv);
+static void tun_read_enqueue(FAR struct tun_device_s *priv, size_t len);
+static int  tun_read_queue(FAR struct tun_device_s *priv);
 static int  tun_txpoll(FAR struct net_driver_s *dev);
 #ifdef CONFIG_NET_ETHERNET
 static int  tun_txpoll_tap(FAR struct net_driver_s *dev);
@@ -180,6 +194,8 @@ static int  tun_txpoll_tun(FAR struct net_driver_s *dev);
 /* Interrupt handling */
 
 static void tun_net_receive(FAR struct tun_device_s *priv);
+static int  tun_vnet_input(FAR struct tun_device_s *priv,
+                           FAR const struct tun_vnet_hdr_s *vnet);
 #ifdef CONFIG_NET_ETHERNET
 static void tun_net_receive_tap(FAR struct tun_device_s *priv);
 #endif
@@ -213,6 +229,9 @@ static int tun_dev_uninit(FAR struct tun_device_s *priv);
 
 static int tun_open(FAR struct file *filep);
 static int tun_close(FAR struct file *filep);
+static ssize_t tun_read_frame(FAR struct tun_device_s *priv,
+                              FAR char *buffer, size_t buflen,
+                              FAR const uint8_t *frame, size_t framelen);
 static ssize_t tun_read(FAR struct file *filep, FAR char *buffer,
                         size_t buflen);
 static ssize_t tun_write(FAR struct file *filep, FAR const char *buffer,
@@ -340,10 +359,82 @@ static int tun_fd_transmit(FAR struct tun_device_s *priv)
       nxsem_post(&priv->read_wait_sem);
     }
 
-  tun_pollnotify(priv, POLLIN);
+  /* poll() only needs to be woken up for the first packet that becomes
+   * readable.  It sees any packets that follow when it is set up again.
+   */
+
+  if (priv->read_nq + (priv->write_d_len > 0 ? 1 : 0) == 1)
+    {
+      tun_pollnotify(priv, POLLIN);
+    }
+
   return OK;
 }
 
+/****************************************************************************
+ * Name: tun_read_slot
+ *
+ * Description:
+ *   Return the first free packet buffer of the read queue.  The caller must
+ *   assure that the queue is not full.
+ *
+ ****************************************************************************/
+
+static FAR uint8_t *tun_read_slot(FAR struct tun_device_s *priv)
+{
+  int slot = (priv->read_head + priv->read_nq) % CONFIG_TUN_NQUEUE;
+  return priv->read_buf[slot];
+}
+
+/****************************************************************************
+ * Name: tun_read_enqueue
+ *
+ * Description:
+ *   Add the packet of length len held in the first free packet buffer of
+ *   the read queue to the queue.
+ *
+ ****************************************************************************/
+
+static void tun_read_enqueue(FAR struct tun_device_s *priv, size_t len)
+{
+  int slot = (priv->read_head + priv->read_nq) % CONFIG_TUN_NQUEUE;
+
+  DEBUGASSERT(priv->read_nq < CONFIG_TUN_NQUEUE);
+  priv->read_d_len[slot] = len;
+  priv->read_nq++;
+}
+
+/****************************************************************************
+ * Name: tun_read_queue
+ *
+ * Description:
+ *   Queue the packet that the network has placed in d_buf for the
+ *   application and point d_buf at the next free packet buffer, if any.
+ *
+ * Input Parameters:
+ *   priv - Reference to the driver state structure
+ *
+ * Returned Value:
+ *   Zero if the network may be polled for more packets; one if the read
+ *   queue is full.  This is the return value expected from the
+ *   devif_poll() callback.
+ *
+ ****************************************************************************/
+
+static int tun_read_queue(FAR struct tun_device_s *priv)
+{
+  tun_read_enqueue(priv, priv->dev.d_len);
+  tun_fd_transmit(priv);
+
+  if (priv->read_nq >= CONFIG_TUN_NQUEUE)
+    {
+      return 1;
+    }
+
+  priv->dev.d_buf = tun_read_slot(priv);
+  return 0;
+}
+
 /****************************************************************************
  * Name: tun_txpoll
  *
@@ -443,12 +534,9 @@ static int tun_txpoll_tap(FAR struct net_driver_s *dev)
 
       if (!devif_loopback(dev))
         {
-          /* Send the packet */
+          /* Queue the packet and continue polling while there is room */
 
-          priv->read_d_len = priv->dev.d_len;
-          tun_fd_transmit(priv);
-
-          return 1;
+          return tun_read_queue(priv);
         }
     }
 
@@ -497,12 +585,9 @@ static int tun_txpoll_tun(FAR struct net_driver_s *dev)
     {
       if (!devif_loopback(dev))
         {
-          /* Send the packet */
-
-          priv->read_d_len = priv->dev.d_len;
-          tun_fd_transmit(priv);
+          /* Queue the packet and continue polling while there is room */
 
-          return 1;
+          return tun_read_queue(priv);
         }
     }
 
@@ -754,6 +839,67 @@ static void tun_net_receive_tun(FAR struct tun_device_s *priv)
     }
 }
 
+/****************************************************************************
+ * Name: tun_vnet_input
+ *
+ * Description:
+ *   Apply the offload header of a frame written by the application to the
+ *   frame in d_buf before it is given to the network.
+ *
+ * Input Parameters:
+ *   priv - Reference to the driver state structure
+ *   vnet - The offload header of the frame
+ *
+ * Returned Value:
+ *   OK on success; -EINVAL if the checksum offsets are invalid.
+ *
+ ****************************************************************************/
+
+static int tun_vnet_input(FAR struct tun_device_s *priv,
+                          FAR const struct tun_vnet_hdr_s *vnet)
+{
+  if ((vnet->flags & TUN_VNET_HDR_F_NEEDS_CSUM) != 0)
+    {
+      FAR uint16_t *sum;
+      size_t start = vnet->csum_start;
+      size_t offset = start + vnet->csum_offset;
+
+      if (((start | offset) & 1) != 0 || offset + 2 > priv->dev.d_len)
+        {
+          return -EINVAL;
+        }
+
+      /* The checksum field holds the pseudo-header checksum, so the
+       * complement of the sum from csum_start on is the final checksum.
+       * One's complement zero is sent as 0xffff, which is also what UDP
+       * requires.
+       */
+
+      sum  = (FAR uint16_t *)&priv->dev.d_buf[offset];
+      *sum = ~net_chksum((FAR uint16_t *)&priv->dev.d_buf[start],
+                         priv->dev.d_len - start);
+      if (*sum == 0)
+        {
+          *sum = 0xffff;
+        }
+    }
+
+#ifdef CONFIG_NETDEV_OFFLOAD
+  /* The checksums of the frame are now known to be good, so the network
+   * need not verify them.  tun_write() clears the feature again once the
+   * frame has been processed.
+   */
+
+  if ((vnet->flags & (TUN_VNET_HDR_F_NEEDS_CSUM |
+                      TUN_VNET_HDR_F_DATA_VALID)) != 0)
+    {
+      priv->dev.d_features |= NETDEV_FEATURE_RXCSUM;
+    }
+#endif
+
+  return OK;
+}
+
 /****************************************************************************
  * Name: tun_txdone
  *
@@ -779,7 +925,7 @@ static void tun_txdone(FAR struct tun_device_s *priv)
 
   /* Then poll the network for new XMIT data */
 
-  priv->dev.d_buf = priv->read_buf;
+  priv->dev.d_buf = tun_read_slot(priv);
   devif_poll(&priv->dev, tun_txpoll);
 }
 
@@ -813,11 +959,11 @@ static void tun_poll_work(FAR void *arg)
    * the TX poll if he are unable to accept another packet for transmission.
    */
 
-  if (priv->read_d_len == 0)
+  if (priv->read_nq < CONFIG_TUN_NQUEUE)
     {
       /* If so, poll the network for new XMIT data. */
 
-      priv->dev.d_buf = priv->read_buf;
+      priv->dev.d_buf = tun_read_slot(priv);
       devif_timer(&priv->dev, TUN_WDDELAY, tun_txpoll);
     }
 
@@ -970,7 +1116,7 @@ static void tun_txavail_work(FAR void *arg)
 
   /* Check if there is room to hold another network packet. */
 
-  if (priv->read_d_len != 0)
+  if (priv->read_nq >= CONFIG_TUN_NQUEUE)
     {
       tun_unlock(priv);
       return;
@@ -981,7 +1127,7 @@ static void tun_txavail_work(FAR void *arg)
     {
       /* Poll the network for new XMIT data */
 
-      priv->dev.d_buf = priv->read_buf;
+      priv->dev.d_buf = tun_read_slot(priv);
       devif_poll(&priv->dev, tun_txpoll);
     }
 
@@ -1234,7 +1380,10 @@ static ssize_t tun_write(FAR struct file *filep, FAR const char *buffer,
                          size_t buflen)
 {
   FAR struct tun_device_s *priv = filep->f_priv;
-  ssize_t ret;
+  struct tun_vnet_hdr_s vnet;
+  size_t nwritten = 0;
+  size_t hdrlen = 0;
+  ssize_t ret = OK;
 
   if (priv == NULL)
     {
@@ -1249,28 +1398,189 @@ static ssize_t tun_write(FAR struct file *filep, FAR const char *buffer,
       return -EBUSY;
     }
 
-  net_lock();
-
-  if (buflen > CONFIG_NET_TUN_PKTSIZE)
+  if ((priv->offload & TUN_F_VNET_HDR) != 0)
     {
-      ret = -EINVAL;
+      hdrlen = sizeof(struct tun_vnet_hdr_s);
     }
-  else
+
+  net_lock();
+
+  /* Give each frame in the buffer to the network in turn */
+
+  while (nwritten < buflen)
     {
-      memcpy(priv->write_buf, buffer, buflen);
+      FAR const char *frame = buffer + nwritten;
+      size_t remaining = buflen - nwritten;
+      size_t framelen;
+      size_t reclen;
+
+      if ((priv->offload & TUN_F_MULTIPKT) != 0)
+        {
+          uint16_t len;
+
+          if (remaining < sizeof(uint16_t) + hdrlen)
+            {
+              ret = -EINVAL;
+              break;
+            }
+
+          memcpy(&len, frame, sizeof(uint16_t));
+          frame   += sizeof(uint16_t);
+          framelen = len;
+          reclen   = sizeof(uint16_t) + hdrlen + framelen;
+
+          if (reclen > remaining)
+            {
+              ret = -EINVAL;
+              break;
+            }
+
+          /* The padding of the last frame may be omitted */
+
+          reclen = TUN_PKTALIGN(reclen);
+          if (reclen > remaining)
+            {
+              reclen = remaining;
+            }
+        }
+      else
+        {
+          if (remaining < hdrlen)
+            {
+              ret = -EINVAL;
+              break;
+            }
+
+          framelen = remaining - hdrlen;
+          reclen   = remaining;
+        }
+
+      if (framelen > CONFIG_NET_TUN_PKTSIZE)
+        {
+          ret = -EINVAL;
+          break;
+        }
+
+      memcpy(&vnet, frame, hdrlen);
+      memcpy(priv->write_buf, frame + hdrlen, framelen);
 
       priv->dev.d_buf = priv->write_buf;
-      priv->dev.d_len = buflen;
+      priv->dev.d_len = framelen;
+
+      if (hdrlen > 0)
+        {
+          ret = tun_vnet_input(priv, &vnet);
+          if (ret < 0)
+            {
+              break;
+            }
+        }
 
       tun_net_receive(priv);
 
-      ret = (ssize_t)buflen;
+#ifdef CONFIG_NETDEV_OFFLOAD
+      priv->dev.d_features &= ~NETDEV_FEATURE_RXCSUM;
+#endif
+
+      nwritten += reclen;
+
+      /* Any response of the network to the frame is left in write_buf.  Move
+       * it to the read queue so that write_buf is free for the next frame.
+       * If the read queue is full, the next frame must wait until the
+       * application has read the response.
+       */
+
+      if (priv->write_d_len > 0)
+        {
+          if (priv->read_nq >= CONFIG_TUN_NQUEUE)
+            {
+              break;
+            }
+
+          memcpy(tun_read_slot(priv), priv->write_buf, priv->write_d_len);
+          tun_read_enqueue(priv, priv->write_d_len);
+          priv->write_d_len = 0;
+        }
     }
 
   net_unlock();
   tun_unlock(priv);
 
-  return ret;
+  /* Report an error only if not even the first frame could be written */
+
+  return nwritten > 0 ? (ssize_t)nwritten : ret;
+}
+
+/****************************************************************************
+ * Name: tun_read_frame
+ *
+ * Description:
+ *   Copy a frame to the application buffer in the format selected with
+ *   TUNSETOFFLOAD.
+ *
+ * Returned Value:
+ *   The number of bytes used in the buffer; -EINVAL if the frame does not
+ *   fit.
+ *
+ ****************************************************************************/
+
+static ssize_t tun_read_frame(FAR struct tun_device_s *priv,
+                              FAR char *buffer, size_t buflen,
+                              FAR const uint8_t *frame, size_t framelen)
+{
+  size_t reclen = framelen;
+
+  if ((priv->offload & TUN_F_VNET_HDR) != 0)
+    {
+      reclen += sizeof(struct tun_vnet_hdr_s);
+    }
+
+  if ((priv->offload & TUN_F_MULTIPKT) != 0)
+    {
+      reclen += sizeof(uint16_t);
+    }
+
+  if (reclen > buflen)
+    {
+      return -EINVAL;
+    }
+
+  if ((priv->offload & TUN_F_MULTIPKT) != 0)
+    {
+      uint16_t len = (uint16_t)framelen;
+
+      memcpy(buffer, &len, sizeof(uint16_t));
+      buffer += sizeof(uint16_t);
+    }
+
+  if ((priv->offload & TUN_F_VNET_HDR) != 0)
+    {
+      struct tun_vnet_hdr_s vnet;
+
+      /* The network computed all checksums of the frame */
+
+      memset(&vnet, 0, sizeof(struct tun_vnet_hdr_s));
+      vnet.flags    = TUN_VNET_HDR_F_DATA_VALID;
+      vnet.gso_type = TUN_VNET_HDR_GSO_NONE;
+
+      memcpy(buffer, &vnet, sizeof(struct tun_vnet_hdr_s));
+      buffer += sizeof(struct tun_vnet_hdr_s);
+    }
+
+  memcpy(buffer, frame, framelen);
+
+  /* The padding of the last frame may be omitted */
+
+  if ((priv->offload & TUN_F_MULTIPKT) != 0)
+    {
+      reclen = TUN_PKTALIGN(reclen);
+      if (reclen > buflen)
+        {
+          reclen = buflen;
+        }
+    }
+
+  return (ssize_t)reclen;
 }
 
 /****************************************************************************
@@ -1281,9 +1591,10 @@ static ssize_t tun_read(FAR struct file *filep, FAR char *buffer,
                         size_t buflen)
 {
   FAR struct tun_device_s *priv = filep->f_priv;
-  ssize_t ret;
-  size_t write_d_len;
-  size_t read_d_len;
+  bool multipkt;
+  bool polled;
+  size_t nread = 0;
+  ssize_t ret = OK;
 
   if (priv == NULL)
     {
@@ -1292,63 +1603,108 @@ static ssize_t tun_read(FAR struct file *filep, FAR char *buffer,
 
   tun_lock(priv);
 
+  multipkt = (priv->offload & TUN_F_MULTIPKT) != 0;
+
+  /* Wait until there is something to read */
+
+  while (priv->write_d_len == 0 && priv->read_nq == 0)
+    {
+      if ((filep->f_oflags & O_NONBLOCK) != 0)
+        {
+          ret = -EAGAIN;
+          goto out;
+        }
+
+      priv->read_wait = true;
+      tun_unlock(priv);
+      ret = nxsem_wait(&priv->read_wait_sem);
+      tun_lock(priv);
+
+      if (ret < 0)
+        {
+          goto out;
+        }
+    }
+
   /* Check if there are data to read in write buffer */
 
-  write_d_len = priv->write_d_len;
-  if (write_d_len > 0)
+  if (priv->write_d_len > 0)
     {
-      if (buflen < write_d_len)
+      ret = tun_read_frame(priv, buffer, buflen, priv->write_buf,
+                           priv->write_d_len);
+      if (ret < 0)
         {
-          ret = -EINVAL;
           goto out;
         }
 
-      memcpy(buffer, priv->write_buf, write_d_len);
-      ret = (ssize_t)write_d_len;
+      nread = (size_t)ret;
 
       priv->write_d_len = 0;
       NETDEV_TXDONE(&priv->dev);
       tun_pollnotify(priv, POLLOUT);
 
-      goto out;
-    }
-
-  if (priv->read_d_len == 0)
-    {
-      if ((filep->f_oflags & O_NONBLOCK) != 0)
+      if (!multipkt)
         {
-          ret = -EAGAIN;
           goto out;
         }
-
-      priv->read_wait = true;
-      tun_unlock(priv);
-      nxsem_wait(&priv->read_wait_sem);
-      tun_lock(priv);
     }
 
   net_lock();
 
-  read_d_len = priv->read_d_len;
-  if (buflen < read_d_len)
+  /* Copy out the queued packets.  In the TUN_F_MULTIPKT format, the network
+   * is polled for more packets each time that the queue runs empty until
+   * the buffer is full or the network has nothing more to send.
+   */
+
+  polled = false;
+  while (priv->read_nq > 0)
     {
-      ret = -EINVAL;
+      int head = priv->read_head;
+
+      ret = tun_read_frame(priv, buffer + nread, buflen - nread,
+                           priv->read_buf[head], priv->read_d_len[head]);
+      if (ret < 0 && nread > 0)
+        {
+          break;
+        }
+
+      /* A packet that does not fit in an empty buffer is dropped */
+
+      priv->read_head = (head + 1) % CONFIG_TUN_NQUEUE;
+      priv->read_nq--;
+      polled = false;
+
+      if (ret < 0)
+        {
+          break;
+        }
+
+      nread += (size_t)ret;
+      if (!multipkt)
+        {
+          break;
+        }
+
+      if (priv->read_nq == 0)
+        {
+          tun_txdone(priv);
+          polled = true;
+        }
     }
-  else
+
+  /* Refill the queue */
+
+  if (!polled && priv->read_nq < CONFIG_TUN_NQUEUE)
     {
-      memcpy(buffer, priv->read_buf, read_d_len);
-      ret = (ssize_t)read_d_len;
+      tun_txdone(priv);
     }
 
-  priv->read_d_len = 0;
-  tun_txdone(priv);
-
   net_unlock();
 
 out:
   tun_unlock(priv);
 
-  return ret;
+  return nread > 0 ? (ssize_t)nread : ret;
 }
 
 /****************************************************************************
@@ -1393,7 +1749,7 @@ int tun_poll(FAR struct file *filep, FAR struct pollfd *fds, bool setup)
        * So check it too.
        */
 
-      if (priv->read_d_len != 0 || priv->write_d_len != 0)
+      if (priv->read_nq != 0 || priv->write_d_len != 0)
         {
           eventset |= (fds->events & POLLIN);
         }
@@ -1467,6 +1823,19 @@ static int tun_ioctl(FAR struct file *filep, int cmd, unsigned long arg)
       strncpy(ifr->ifr_name, priv->dev.d_ifname, IFNAMSIZ);
       tundev_unlock(tun);
 
+      return OK;
+    }
+  else if (cmd == TUNSETOFFLOAD && priv != NULL)
+    {
+      if ((arg & ~(unsigned long)(TUN_F_MULTIPKT | TUN_F_VNET_HDR)) != 0)
+        {
+          return -EINVAL;
+        }
+
+      tun_lock(priv);
+      priv->offload = (uint8_t)arg;
+      tun_unlock(priv);
+
       return OK;
     }
 
@@ -60,6 +60,9 @@
 #include <nuttx/semaphore.h>
 #include <nuttx/fs/fs.h>
 #include <nuttx/fs/ioctl.h>
+#ifdef CONFIG_DEV_PIPE_SPLICE
+#  include <nuttx/drivers/drivers.h>
+#endif
 
 #include "pipe_common.h"
 
@@ -136,6 +139,355 @@ static void pipecommon_pollnotify(FAR struct pipe_dev_s *dev,
     }
 }
 
+/****************************************************************************
+ * Name: pipecommon_wakeall
+ ****************************************************************************/
+
+static void pipecommon_wakeall(FAR sem_t *sem)
+{
+  int sval;
+
+  while (nxsem_getvalue(sem, &sval) == 0 && sval < 0)
+    {
+      nxsem_post(sem);
+    }
+}
+
+/****************************************************************************
+ * Name: pipecommon_rdnotify
+ *
+ * Description:
+ *   Data was added to the buffer.  Wake up readers, but only once the read
+ *   low watermark has been reached.  Waking a reader for every small write
+ *   just to have it consume a few bytes costs a context switch each time.
+ *
+ ****************************************************************************/
+
+static void pipecommon_rdnotify(FAR struct pipe_dev_s *dev)
+{
+  if (ringbuf_used(&dev->d_ring) >= dev->d_rdlowat)
+    {
+      /* Notify all of the waiting readers that more data is available */
+
+      pipecommon_wakeall(&dev->d_rdsem);
+
+      /* Notify all poll/select waiters that they can read from the FIFO */
+
+      pipecommon_pollnotify(dev, POLLIN);
+    }
+}
+
+/****************************************************************************
+ * Name: pipecommon_wrnotify
+ *
+ * Description:
+ *   Data was removed from the buffer.  Wake up writers once the write low
+ *   watermark of free space is available.
+ *
+ ****************************************************************************/
+
+static void pipecommon_wrnotify(FAR struct pipe_dev_s *dev)
+{
+  if (ringbuf_space(&dev->d_ring) >= dev->d_wrlowat)
+    {
+      /* Notify all waiting writers that bytes have been removed from the
+       * buffer.
+       */
+
+      pipecommon_wakeall(&dev->d_wrsem);
+
+      /* Notify all poll/select waiters that they can write to the FIFO */
+
+      pipecommon_pollnotify(dev, POLLOUT);
+    }
+}
+
+/****************************************************************************
+ * Name: pipecommon_resize
+ *
+ * Description:
+ *   Change the size of the ring buffer.  Buffered data is preserved and
+ *   must fit in the new buffer.
+ *
+ ****************************************************************************/
+
+static int pipecommon_resize(FAR struct pipe_dev_s *dev, size_t bufsize)
+{
+  FAR uint8_t *buffer;
+  size_t nbytes;
+
+  if (bufsize < 2 || bufsize > CONFIG_DEV_PIPE_MAXSIZE)
+    {
+      return -EINVAL;
+    }
+
+  /* If the buffer has not been allocated yet, then just change the size
+   * that will be used when it is.
+   */
+
+  if (dev->d_ring.rb_buffer != NULL)
+    {
+      nbytes = ringbuf_used(&dev->d_ring);
+      if (nbytes >= bufsize)
+        {
+          return -EBUSY;
+        }
+
+      buffer = (FAR uint8_t *)kmm_malloc(bufsize);
+      if (buffer == NULL)
+        {
+          return -ENOMEM;
+        }
+
+      /* Move the buffered data to the start of the new buffer */
+
+      ringbuf_read(&dev->d_ring, buffer, nbytes);
+      kmm_free(dev->d_ring.rb_buffer);
+
+      dev->d_ring.rb_buffer = buffer;
+      dev->d_ring.rb_tail   = 0;
+      dev->d_ring.rb_head   = nbytes;
+    }
+
+  dev->d_ring.rb_size = bufsize;
+
+  /* The watermarks can never exceed the usable size of the buffer, else
+   * the readers or writers would never be woken.
+   */
+
+  if (dev->d_rdlowat > bufsize - 1)
+    {
+      dev->d_rdlowat = bufsize - 1;
+    }
+
+  if (dev->d_wrlowat > bufsize - 1)
+    {
+      dev->d_wrlowat = bufsize - 1;
+    }
+
+  if (dev->d_ring.rb_buffer != NULL)
+    {
+      pipecommon_wrnotify(dev);
+    }
+
+  return OK;
+}
+
+/****************************************************************************
+ * Name: pipecommon_splicein
+ *
+ * Description:
+ *   Read up to 'len' bytes from 'src' directly into the ring buffer.
+ *   Called with d_bfsem held; it is released while waiting for space.
+ *
+ *   NOTE: d_bfsem stays held while the source is read.  A source that can
+ *   block indefinitely will also block other users of this pipe.
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_DEV_PIPE_SPLICE
+static ssize_t pipecommon_splicein(FAR struct file *filep,
+                                   FAR struct pipe_dev_s *dev,
+                                   FAR struct file *src, size_t len)
+{
+  FAR uint8_t *ptr;
+  ssize_t nwritten = 0;
+  ssize_t nread;
+  size_t n;
+
+  if ((filep->f_oflags & O_WROK) == 0)
+    {
+      return -EBADF;
+    }
+
+  if (dev->d_nreaders <= 0)
+    {
+      return -EPIPE;
+    }
+
+  /* Wait for space in the buffer */
+
+  while (ringbuf_space(&dev->d_ring) == 0)
+    {
+      if (filep->f_oflags & O_NONBLOCK)
+        {
+          return -EAGAIN;
+        }
+
+      sched_lock();
+      nxsem_post(&dev->d_bfsem);
+      pipecommon_semtake(&dev->d_wrsem);
+      sched_unlock();
+      pipecommon_semtake(&dev->d_bfsem);
+    }
+
+  /* Fill at most the two free segments of the ring */
+
+  while ((size_t)nwritten < len &&
+         (n = ringbuf_wrseg(&dev->d_ring, &ptr)) > 0)
+    {
+      if (n > len - nwritten)
+        {
+          n = len - nwritten;
+        }
+
+      nread = file_read(src, ptr, n);
+      if (nread <= 0)
+        {
+          if (nwritten == 0)
+            {
+              nwritten = nread;
+            }
+
+          break;
+        }
+
+      ringbuf_wrcommit(&dev->d_ring, nread);
+      nwritten += nread;
+
+      if ((size_t)nread < n)
+        {
+          break;
+        }
+    }
+
+  if (nwritten > 0)
+    {
+      pipecommon_rdnotify(dev);
+    }
+
+  return nwritten;
+}
+
+/****************************************************************************
+ * Name: pipecommon_spliceout
+ *
+ * Description:
+ *   Write up to 'len' bytes from the ring buffer directly to 'dest'.
+ *   Called with d_bfsem held; it is released while waiting for data.
+ *
+ ****************************************************************************/
+
+static ssize_t pipecommon_spliceout(FAR struct file *filep,
+                                    FAR struct pipe_dev_s *dev,
+                                    FAR struct file *dest, size_t len)
+{
+  FAR uint8_t *ptr;
+  ssize_t nread = 0;
+  ssize_t nwritten;
+  size_t n;
+  int ret;
+
+  if ((filep->f_oflags & O_RDOK) == 0)
+    {
+      return -EBADF;
+    }
+
+  /* Wait for data, exactly as pipecommon_read() does */
+
+  while (ringbuf_is_empty(&dev->d_ring))
+    {
+      if (filep->f_oflags & O_NONBLOCK)
+        {
+          return -EAGAIN;
+        }
+
+      if (dev->d_nwriters <= 0)
+        {
+          return 0;
+        }
+
+      sched_lock();
+      nxsem_post(&dev->d_bfsem);
+      ret = nxsem_wait(&dev->d_rdsem);
+      sched_unlock();
+
+      pipecommon_semtake(&dev->d_bfsem);
+      if (ret < 0)
+        {
+          return ret;
+        }
+    }
+
+  while ((size_t)nread < len &&
+         (n = ringbuf_rdseg(&dev->d_ring, &ptr)) > 0)
+    {
+      if (n > len - nread)
+        {
+          n = len - nread;
+        }
+
+      nwritten = file_write(dest, ptr, n);
+      if (nwritten <= 0)
+        {
+          if (nread == 0)
+            {
+              nread = nwritten;
+            }
+
+          break;
+        }
+
+      ringbuf_rdcommit(&dev->d_ring, nwritten);
+      nread += nwritten;
+
+      if ((size_t)nwritten < n)
+        {
+          break;
+        }
+    }
+
+  if (nread > 0)
+    {
+      pipecommon_wrnotify(dev);
+    }
+
+  return nread;
+}
+
+/****************************************************************************
+ * Name: pipecommon_splice
+ ****************************************************************************/
+
+static ssize_t pipecommon_splice(FAR struct file *filep,
+                                 FAR struct pipe_dev_s *dev, int cmd,
+                                 FAR const struct pipe_splice_s *splice)
+{
+  FAR struct file *other;
+  int ret;
+
+  if (splice == NULL)
+    {
+      return -EINVAL;
+    }
+
+  ret = fs_getfilep(splice->ps_fd, &other);
+  if (ret < 0)
+    {
+      return ret;
+    }
+
+  /* Splicing a pipe to itself would deadlock on d_bfsem */
+
+  if (other->f_inode == filep->f_inode)
+    {
+      return -EINVAL;
+    }
+
+  if (splice->ps_len == 0)
+    {
+      return 0;
+    }
+
+  if (cmd == PIPEIOC_SPLICEIN)
+    {
+      return pipecommon_splicein(filep, dev, other, splice->ps_len);
+    }
+
+  return pipecommon_spliceout(filep, dev, other, splice->ps_len);
+}
+#endif
+
 /****************************************************************************
  * Public Functions
  ****************************************************************************/
@@ -169,7 +521,9 @@ FAR struct pipe_dev_s *pipecommon_allocdev(size_t bufsize)
      nxsem_setprotocol(&dev->d_rdsem, SEM_PRIO_NONE);
      nxsem_setprotocol(&dev->d_wrsem, SEM_PRIO_NONE);
 
-      dev->d_bufsize = bufsize;
+      dev->d_ring.rb_size = bufsize;
+      dev->d_rdlowat = 1;
+      dev->d_wrlowat = 1;
     }
 
   return dev;
@@ -216,10 +570,10 @@ int pipecommon_open(FAR struct file *filep)
    * is first opened.
    */
 
-  if (inode->i_crefs == 1 && dev->d_buffer == NULL)
+  if (inode->i_crefs == 1 && dev->d_ring.rb_buffer == NULL)
     {
-      dev->d_buffer = (FAR uint8_t *)kmm_malloc(dev->d_bufsize);
-      if (!dev->d_buffer)
+      dev->d_ring.rb_buffer = (FAR uint8_t *)kmm_malloc(dev->d_ring.rb_size);
+      if (!dev->d_ring.rb_buffer)
         {
           nxsem_post(&dev->d_bfsem);
           return -ENOMEM;
@@ -263,7 +617,7 @@ int pipecommon_open(FAR struct file *filep)
 
   if ((filep->f_oflags & O_RDWR) == O_RDONLY &&  /* Read-only */
       dev->d_nwriters < 1 &&                     /* No writers on the pipe */
-      dev->d_wrndx == dev->d_rdndx)              /* Buffer is empty */
+      ringbuf_is_empty(&dev->d_ring))            /* Buffer is empty */
     {
       /* NOTE: d_rdsem is normally used when the read logic waits for more
        * data to be written.  But until the first writer has opened the
@@ -367,17 +721,16 @@ int pipecommon_close(FAR struct file *filep)
    * obtained when the pipe is re-opened.
    */
 
-  else if (PIPE_IS_POLICY_0(dev->d_flags) || dev->d_wrndx == dev->d_rdndx)
+  else if (PIPE_IS_POLICY_0(dev->d_flags) || ringbuf_is_empty(&dev->d_ring))
     {
       /* Policy 0 or the buffer is empty ... deallocate the buffer now. */
 
-      kmm_free(dev->d_buffer);
-      dev->d_buffer = NULL;
+      kmm_free(dev->d_ring.rb_buffer);
+      dev->d_ring.rb_buffer = NULL;
 
       /* And reset all counts and indices */
 
-      dev->d_wrndx    = 0;
-      dev->d_rdndx    = 0;
+      ringbuf_reset(&dev->d_ring);
       dev->d_nwriters = 0;
       dev->d_nreaders = 0;
 
@@ -410,7 +763,8 @@ ssize_t pipecommon_read(FAR struct file *filep, FAR char *buffer, size_t len)
   FAR uint8_t           *start  = (FAR uint8_t *)buffer;
 #endif
   ssize_t                nread  = 0;
-  int                    sval;
+  size_t                 nbytes;
+  size_t                 minread;
   int                    ret;
 
   DEBUGASSERT(dev);
@@ -428,10 +782,22 @@ ssize_t pipecommon_read(FAR struct file *filep, FAR char *buffer, size_t len)
       return ret;
     }
 
-  /* If the pipe is empty, then wait for something to be written to it */
+  /* Wait until there is something to read.  With a read low watermark,
+   * wait until either the watermark or the requested amount is buffered.
+   */
+
+  minread = len < dev->d_rdlowat ? len : dev->d_rdlowat;
 
-  while (dev->d_wrndx == dev->d_rdndx)
+  while ((nbytes = ringbuf_used(&dev->d_ring)) < minread)
     {
+      /* Return what there is if we cannot or will never get more */
+
+      if (nbytes > 0 &&
+          ((filep->f_oflags & O_NONBLOCK) != 0 || dev->d_nwriters <= 0))
+        {
+          break;
+        }
+
       /* If O_NONBLOCK was set, then return EGAIN */
 
       if (filep->f_oflags & O_NONBLOCK)
@@ -459,32 +825,19 @@ ssize_t pipecommon_read(FAR struct file *filep, FAR char *buffer, size_t len)
         {
           return ret;
         }
-    }
-
-  /* Then return whatever is available in the pipe (which is at least one byte) */
-
-  nread = 0;
-  while ((size_t)nread < len && dev->d_wrndx != dev->d_rdndx)
-    {
-      *buffer++ = dev->d_buffer[dev->d_rdndx];
-      if (++dev->d_rdndx >= dev->d_bufsize)
-        {
-          dev->d_rdndx = 0;
-        }
 
-      nread++;
+      minread = len < dev->d_rdlowat ? len : dev->d_rdlowat;
     }
 
-  /* Notify all waiting writers that bytes have been removed from the buffer */
+  /* Then return whatever is available in the pipe (which is at least one
+   * byte).
+   */
 
-  while (nxsem_getvalue(&dev->d_wrsem, &sval) == 0 && sval < 0)
-    {
-      nxsem_post(&dev->d_wrsem);
-    }
+  nread = ringbuf_read(&dev->d_ring, buffer, len);
 
-  /* Notify all poll/select waiters that they can write to the FIFO */
+  /* Notify waiting writers that bytes have been removed from the buffer */
 
-  pipecommon_pollnotify(dev, POLLOUT);
+  pipecommon_wrnotify(dev);
 
   nxsem_post(&dev->d_bfsem);
   pipe_dumpbuffer("From PIPE:", start, nread);
@@ -500,10 +853,8 @@ ssize_t pipecommon_write(FAR struct file *filep, FAR const char *buffer,
 {
   FAR struct inode      *inode    = filep->f_inode;
   FAR struct pipe_dev_s *dev      = inode->i_private;
-  ssize_t                nwritten = 0;
-  ssize_t                last;
-  int                    nxtwrndx;
-  int                    sval;
+  size_t                 nwritten = 0;
+  size_t                 last;
   int                    ret;
 
   DEBUGASSERT(dev);
@@ -555,86 +906,57 @@ ssize_t pipecommon_write(FAR struct file *filep, FAR const char *buffer,
   last = 0;
   for (; ; )
     {
-      /* Calculate the write index AFTER the next byte is written */
+      /* Copy as much as will fit into the circular buffer */
 
-      nxtwrndx = dev->d_wrndx + 1;
-      if (nxtwrndx >= dev->d_bufsize)
-        {
-          nxtwrndx = 0;
-        }
+      nwritten += ringbuf_write(&dev->d_ring, &buffer[nwritten],
+                                len - nwritten);
 
-      /* Would the next write overflow the circular buffer? */
+      /* Is the write complete? */
 
-      if (nxtwrndx != dev->d_rdndx)
+      if (nwritten >= len)
         {
-          /* No... copy the byte */
-
-          dev->d_buffer[dev->d_wrndx] = *buffer++;
-          dev->d_wrndx = nxtwrndx;
-
-          /* Is the write complete? */
-
-          nwritten++;
-          if ((size_t)nwritten >= len)
-            {
-              /* Yes.. Notify all of the waiting readers that more data is available */
-
-              while (nxsem_getvalue(&dev->d_rdsem, &sval) == 0 && sval < 0)
-                {
-                  nxsem_post(&dev->d_rdsem);
-                }
-
-              /* Notify all poll/select waiters that they can read from the FIFO */
+          /* Yes.. Notify the waiting readers that more data is available */
 
-              pipecommon_pollnotify(dev, POLLIN);
+          pipecommon_rdnotify(dev);
 
-              /* Return the number of bytes written */
+          /* Return the number of bytes written */
 
-              nxsem_post(&dev->d_bfsem);
-              return len;
-            }
+          nxsem_post(&dev->d_bfsem);
+          return len;
         }
-      else
-        {
-          /* There is not enough room for the next byte.  Was anything written in this pass? */
-
-          if (last < nwritten)
-            {
-              /* Yes.. Notify all of the waiting readers that more data is available */
-
-              while (nxsem_getvalue(&dev->d_rdsem, &sval) == 0 && sval < 0)
-                {
-                  nxsem_post(&dev->d_rdsem);
-                }
-
-              /* Notify all poll/select waiters that they can read from the FIFO */
-
-              pipecommon_pollnotify(dev, POLLIN);
-            }
 
-          last = nwritten;
+      /* There is not enough room for the next byte.  Was anything written
+       * in this pass?
+       */
 
-          /* If O_NONBLOCK was set, then return partial bytes written or EGAIN */
+      if (last < nwritten)
+        {
+          /* Yes.. Notify the waiting readers that more data is available.
+           * The buffer is full, so the read low watermark has been reached.
+           */
 
-          if (filep->f_oflags & O_NONBLOCK)
-            {
-              if (nwritten == 0)
-                {
-                  nwritten = -EAGAIN;
-                }
+          pipecommon_rdnotify(dev);
+        }
 
-              nxsem_post(&dev->d_bfsem);
-              return nwritten;
-            }
+      last = nwritten;
 
-          /* There is more to be written.. wait for data to be removed from the pipe */
+      /* If O_NONBLOCK was set, then return partial bytes written or EGAIN */
 
-          sched_lock();
+      if (filep->f_oflags & O_NONBLOCK)
+        {
           nxsem_post(&dev->d_bfsem);
-          pipecommon_semtake(&dev->d_wrsem);
-          sched_unlock();
-          pipecommon_semtake(&dev->d_bfsem);
+          return nwritten == 0 ? -EAGAIN : (ssize_t)nwritten;
         }
+
+      /* There is more to be written.. wait for data to be removed from the
+       * pipe.
+       */
+
+      sched_lock();
+      nxsem_post(&dev->d_bfsem);
+      pipecommon_semtake(&dev->d_wrsem);
+      sched_unlock();
+      pipecommon_semtake(&dev->d_bfsem);
     }
 }
 
@@ -648,7 +970,7 @@ int pipecommon_poll(FAR struct file *filep, FAR struct pollfd *fds,
   FAR struct inode      *inode    = filep->f_inode;
   FAR struct pipe_dev_s *dev      = inode->i_private;
   pollevent_t            eventset;
-  pipe_ndx_t             nbytes;
+  size_t                 nbytes;
   int                    ret      = OK;
   int                    i;
 
@@ -688,28 +1010,25 @@ int pipecommon_poll(FAR struct file *filep, FAR struct pollfd *fds,
        * First, determine how many bytes are in the buffer
        */
 
-      if (dev->d_wrndx >= dev->d_rdndx)
-        {
-          nbytes = dev->d_wrndx - dev->d_rdndx;
-        }
-      else
-        {
-          nbytes = dev->d_bufsize + dev->d_wrndx - dev->d_rdndx;
-        }
+      nbytes = ringbuf_used(&dev->d_ring);
 
-      /* Notify the POLLOUT event if the pipe is not full, but only if
-       * there is readers.
+      /* Notify the POLLOUT event if the pipe has at least the write low
+       * watermark of free space.
        */
 
       eventset = 0;
-      if ((filep->f_oflags & O_WROK) && (nbytes < (dev->d_bufsize - 1)))
+      if ((filep->f_oflags & O_WROK) &&
+          (ringbuf_space(&dev->d_ring) >= dev->d_wrlowat))
         {
           eventset |= POLLOUT;
         }
 
-      /* Notify the POLLIN event if the pipe is not empty */
+      /* Notify the POLLIN event if the pipe holds at least the read low
+       * watermark, or holds anything at all when there are no writers.
+       */
 
-      if ((filep->f_oflags & O_RDOK) && (nbytes > 0))
+      if ((filep->f_oflags & O_RDOK) &&
+          (nbytes >= dev->d_rdlowat || (nbytes > 0 && dev->d_nwriters <= 0)))
         {
           eventset |= POLLIN;
         }
@@ -801,26 +1120,12 @@ int pipecommon_ioctl(FAR struct file *filep, int cmd, unsigned long arg)
       case FIONWRITE:  /* Number of bytes waiting in send queue */
       case FIONREAD:   /* Number of bytes available for reading */
         {
-          int count;
-
           /* Determine the number of bytes written to the buffer.  This is,
            * of course, also the number of bytes that may be read from the
            * buffer.
-           *
-           *   d_rdndx - index to remove next byte from the buffer
-           *   d_wrndx - Index to next location to add a byte to the buffer.
            */
 
-          if (dev->d_wrndx < dev->d_rdndx)
-            {
-              count = (dev->d_bufsize - dev->d_rdndx) + dev->d_wrndx;
-            }
-          else
-            {
-              count = dev->d_wrndx - dev->d_rdndx;
-            }
-
-          *(FAR int *)((uintptr_t)arg) = count;
+          *(FAR int *)((uintptr_t)arg) = ringbuf_used(&dev->d_ring);
           ret = 0;
         }
         break;
@@ -829,28 +1134,66 @@ int pipecommon_ioctl(FAR struct file *filep, int cmd, unsigned long arg)
 
       case FIONSPACE:
         {
-          int count;
+          /* Determine the number of bytes free in the buffer */
+
+          *(FAR int *)((uintptr_t)arg) = ringbuf_space(&dev->d_ring);
+          ret = 0;
+        }
+        break;
+
+      case PIPEIOC_SETSIZE:
+        {
+          ret = pipecommon_resize(dev, (size_t)arg);
+        }
+        break;
+
+      case PIPEIOC_GETSIZE:
+        {
+          *(FAR int *)((uintptr_t)arg) = dev->d_ring.rb_size;
+          ret = OK;
+        }
+        break;
 
-          /* Determine the number of bytes free in the buffer.
-           *
-           *   d_rdndx - index to remove next byte from the buffer
-           *   d_wrndx - Index to next location to add a byte to the buffer.
+      case PIPEIOC_RDLOWAT:
+      case PIPEIOC_WRLOWAT:
+        {
+          /* A watermark larger than the usable buffer would never be
+           * reached.  Zero behaves like the default of one byte.
            */
 
-          if (dev->d_wrndx < dev->d_rdndx)
+          if (arg >= dev->d_ring.rb_size)
             {
-              count = (dev->d_rdndx - dev->d_wrndx) - 1;
+              break;
+            }
+
+          if (arg == 0)
+            {
+              arg = 1;
+            }
+
+          if (cmd == PIPEIOC_RDLOWAT)
+            {
+              dev->d_rdlowat = arg;
             }
           else
             {
-              count = ((dev->d_bufsize - dev->d_wrndx) + dev->d_rdndx) - 1;
+              dev->d_wrlowat = arg;
             }
 
-          *(FAR int *)((uintptr_t)arg) = count;
-          ret = 0;
+          ret = OK;
         }
         break;
 
+#ifdef CONFIG_DEV_PIPE_SPLICE
+      case PIPEIOC_SPLICEIN:
+      case PIPEIOC_SPLICEOUT:
+        {
+          ret = pipecommon_splice(filep, dev, cmd,
+                   (FAR const struct pipe_splice_s *)((uintptr_t)arg));
+        }
+        break;
+#endif
+
       default:
         break;
     }
@@ -881,9 +1224,9 @@ int pipecommon_unlink(FAR struct inode *inode)
     {
       /* No.. free the buffer (if there is one) */
 
-      if (dev->d_buffer)
+      if (dev->d_ring.rb_buffer)
         {
-          kmm_free(dev->d_buffer);
+          kmm_free(dev->d_ring.rb_buffer);
         }
 
       /* And free the device structure. */
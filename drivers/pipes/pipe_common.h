@@ -47,6 +47,8 @@
 #include <stdbool.h>
 #include <poll.h>
 
+#include <nuttx/ringbuf.h>
+
 /****************************************************************************
  * Pre-processor Definitions
  ****************************************************************************/
@@ -112,7 +114,7 @@
  * Public Types
  ****************************************************************************/
 
-/* Make the buffer index as small as possible for the configured pipe size */
+/* Make the watermarks as small as possible for the configured pipe size */
 
 #if CONFIG_DEV_PIPE_MAXSIZE > 65535
 typedef uint32_t pipe_ndx_t;  /* 32-bit index */
@@ -129,17 +131,16 @@ typedef uint8_t pipe_ndx_t;   /*  8-bit index */
 
 struct pipe_dev_s
 {
-  sem_t      d_bfsem;       /* Used to serialize access to d_buffer and indices */
+  sem_t      d_bfsem;       /* Used to serialize access to d_ring */
   sem_t      d_rdsem;       /* Empty buffer - Reader waits for data write */
   sem_t      d_wrsem;       /* Full buffer - Writer waits for data read */
-  pipe_ndx_t d_wrndx;       /* Index in d_buffer to save next byte written */
-  pipe_ndx_t d_rdndx;       /* Index in d_buffer to return the next byte read */
-  pipe_ndx_t d_bufsize;     /* allocated size of d_buffer in bytes */
+  pipe_ndx_t d_rdlowat;     /* Bytes buffered before readers are woken */
+  pipe_ndx_t d_wrlowat;     /* Bytes free before writers are woken */
   uint8_t    d_nwriters;    /* Number of reference counts for write access */
   uint8_t    d_nreaders;    /* Number of reference counts for read access */
   uint8_t    d_pipeno;      /* Pipe minor number */
   uint8_t    d_flags;       /* See PIPE_FLAG_* definitions */
-  uint8_t   *d_buffer;      /* Buffer allocated when device opened */
+  struct ringbuf_s d_ring;  /* Buffer allocated when device opened */
 
   /* The following is a list if poll structures of threads waiting for
    * driver events. The 'struct pollfd' reference for each open is also
@@ -94,6 +94,13 @@ struct pm_domain_s
   /* The power state lock count */
 
   uint16_t stay[PM_COUNT];
+
+#ifdef CONFIG_PM_QOS
+  /* The QoS constraints and what each power state allows */
+
+  FAR struct pm_qos_request_s *qos;
+  FAR const struct pm_qos_state_s *qosstates;
+#endif
 };
 
 /* This structure encapsulates all of the global data used by the PM system */
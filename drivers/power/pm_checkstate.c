@@ -61,9 +61,9 @@
  *   This function is called from the MCU-specific IDLE loop to monitor the
  *   the power management conditions.  This function returns the "recommended"
  *   power management state based on the PM policy applied by the currently
- *   chosen governor. The IDLE loop must call pm_changestate() in order to
- *   make the state change, which will interact with all drivers registered
- *   with the PM system.
+ *   chosen governor, limited by the PM QoS constraints in effect.  The IDLE
+ *   loop must call pm_changestate() in order to make the state change,
+ *   which will interact with all drivers registered with the PM system.
  *
  *   These two steps are separated because the plaform-specific IDLE loop may
  *   have additional situational information that is not available to the
@@ -87,10 +87,29 @@
 
 enum pm_state_e pm_checkstate(int domain)
 {
+  enum pm_state_e state;
+#ifdef CONFIG_PM_QOS
+  enum pm_state_e limit;
+#endif
+
   DEBUGASSERT(domain >= 0 && domain < CONFIG_PM_NDOMAINS &&
               g_pmglobals.governor->checkstate);
 
-  return g_pmglobals.governor->checkstate(domain);
+  state = g_pmglobals.governor->checkstate(domain);
+
+#ifdef CONFIG_PM_QOS
+  /* Whatever the governor suggests, do not go below the power state that
+   * the QoS constraints allow.
+   */
+
+  limit = pm_qos_limit(domain);
+  if (state > limit)
+    {
+      state = limit;
+    }
+#endif
+
+  return state;
 }
 
 #endif /* CONFIG_PM */
@@ -0,0 +1,318 @@
+/****************************************************************************
+ * drivers/power/pm_qos.c
+ *
+ *   Copyright (C) 2020 Gregory Nutt. All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in
+ *    the documentation and/or other materials provided with the
+ *    distribution.
+ * 3. Neither the name NuttX nor the names of its contributors may be
+ *    used to endorse or promote products derived from this software
+ *    without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+ * FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE
+ * COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+ * INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,
+ * BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS
+ * OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED
+ * AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ * LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN
+ * ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ *
+ ****************************************************************************/
+
+/****************************************************************************
+ * Included Files
+ ****************************************************************************/
+
+#include <nuttx/config.h>
+
+#include <stdint.h>
+#include <stdbool.h>
+#include <assert.h>
+
+#include <nuttx/power/pm.h>
+#include <nuttx/clock.h>
+#include <nuttx/irq.h>
+
+#include "pm.h"
+
+#ifdef CONFIG_PM_QOS
+
+/****************************************************************************
+ * Private Data
+ ****************************************************************************/
+
+/* The power states of domains not described by pm_qos_setstates(), indexed
+ * by enum pm_state_e.  No transfers are possible in PM_SLEEP.
+ */
+
+static const struct pm_qos_state_s g_pmqos_states[PM_COUNT] =
+{
+  { 0,                             UINT32_MAX },
+  { CONFIG_PM_QOS_IDLE_LATENCY,    UINT32_MAX },
+  { CONFIG_PM_QOS_STANDBY_LATENCY, UINT32_MAX },
+  { CONFIG_PM_QOS_SLEEP_LATENCY,   0          }
+};
+
+/****************************************************************************
+ * Private Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: pm_qos_unlink
+ *
+ * Description:
+ *   Remove a request from the list of its domain.
+ *
+ * Assumptions:
+ *   Interrupts are disabled.
+ *
+ ****************************************************************************/
+
+static void pm_qos_unlink(FAR struct pm_qos_request_s *req,
+                          FAR struct pm_qos_request_s *prev)
+{
+  if (prev == NULL)
+    {
+      g_pmglobals.domain[req->domain].qos = req->flink;
+    }
+  else
+    {
+      prev->flink = req->flink;
+    }
+
+  req->flink  = NULL;
+  req->active = false;
+}
+
+/****************************************************************************
+ * Public Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: pm_qos_add
+ *
+ * Description:
+ *   Add a quality of service constraint to a PM domain.
+ *
+ * Input Parameters:
+ *   req     - The request structure, provided by the caller
+ *   domain  - The domain of the constraint
+ *   qclass  - PM_QOS_LATENCY or PM_QOS_THROUGHPUT
+ *   value   - The maximum latency (us) or minimum throughput (KiB/s)
+ *   timeout - The constraint lapses after this many milliseconds.  Zero
+ *             means that it stays in effect until pm_qos_remove().
+ *
+ * Returned Value:
+ *   None.
+ *
+ * Assumptions:
+ *   This function may be called from an interrupt handler.
+ *
+ ****************************************************************************/
+
+void pm_qos_add(FAR struct pm_qos_request_s *req, int domain,
+                enum pm_qos_class_e qclass, uint32_t value,
+                uint32_t timeout)
+{
+  DEBUGASSERT(req != NULL && domain >= 0 && domain < CONFIG_PM_NDOMAINS);
+  DEBUGASSERT(qclass == PM_QOS_LATENCY || qclass == PM_QOS_THROUGHPUT);
+
+  req->flink  = NULL;
+  req->domain = domain;
+  req->qclass = qclass;
+  req->active = false;
+
+  pm_qos_update(req, value, timeout);
+}
+
+/****************************************************************************
+ * Name: pm_qos_update
+ *
+ * Description:
+ *   Change the value and the timeout of a constraint.  A constraint that
+ *   has lapsed is put in effect again.
+ *
+ * Assumptions:
+ *   This function may be called from an interrupt handler.
+ *
+ ****************************************************************************/
+
+void pm_qos_update(FAR struct pm_qos_request_s *req, uint32_t value,
+                   uint32_t timeout)
+{
+  FAR struct pm_domain_s *pdom;
+  irqstate_t flags;
+
+  DEBUGASSERT(req != NULL && req->domain < CONFIG_PM_NDOMAINS);
+  pdom = &g_pmglobals.domain[req->domain];
+
+  flags = enter_critical_section();
+
+  req->value  = value;
+  req->expiry = 0;
+
+  if (timeout > 0)
+    {
+      /* Zero means never, so a constraint expiring at time zero lapses one
+       * tick later.
+       */
+
+      req->expiry = clock_systimer() + MSEC2TICK(timeout);
+      if (req->expiry == 0)
+        {
+          req->expiry = 1;
+        }
+    }
+
+  if (!req->active)
+    {
+      req->flink  = pdom->qos;
+      pdom->qos   = req;
+      req->active = true;
+    }
+
+  leave_critical_section(flags);
+}
+
+/****************************************************************************
+ * Name: pm_qos_remove
+ *
+ * Description:
+ *   Remove a constraint.  The request structure may then be reused.
+ *
+ * Assumptions:
+ *   This function may be called from an interrupt handler.
+ *
+ ****************************************************************************/
+
+void pm_qos_remove(FAR struct pm_qos_request_s *req)
+{
+  FAR struct pm_qos_request_s *curr;
+  FAR struct pm_qos_request_s *prev;
+  irqstate_t flags;
+
+  DEBUGASSERT(req != NULL && req->domain < CONFIG_PM_NDOMAINS);
+
+  flags = enter_critical_section();
+
+  /* A lapsed constraint has already been removed from the list */
+
+  if (req->active)
+    {
+      for (prev = NULL, curr = g_pmglobals.domain[req->domain].qos;
+           curr != NULL && curr != req;
+           prev = curr, curr = curr->flink);
+
+      DEBUGASSERT(curr == req);
+      pm_qos_unlink(req, prev);
+    }
+
+  leave_critical_section(flags);
+}
+
+/****************************************************************************
+ * Name: pm_qos_setstates
+ *
+ * Description:
+ *   Describe the wakeup latency and the sustainable throughput of each
+ *   power state of a domain.
+ *
+ ****************************************************************************/
+
+void pm_qos_setstates(int domain, FAR const struct pm_qos_state_s *states)
+{
+  DEBUGASSERT(domain >= 0 && domain < CONFIG_PM_NDOMAINS);
+  g_pmglobals.domain[domain].qosstates = states;
+}
+
+/****************************************************************************
+ * Name: pm_qos_limit
+ *
+ * Description:
+ *   Return the lowest power state that satisfies all constraints in effect
+ *   in the domain.  Constraints that have lapsed are removed.
+ *
+ ****************************************************************************/
+
+enum pm_state_e pm_qos_limit(int domain)
+{
+  FAR const struct pm_qos_state_s *states;
+  FAR struct pm_qos_request_s *req;
+  FAR struct pm_qos_request_s *prev;
+  FAR struct pm_qos_request_s *next;
+  FAR struct pm_domain_s *pdom;
+  uint32_t latency = UINT32_MAX;
+  uint32_t throughput = 0;
+  irqstate_t flags;
+  clock_t now;
+  int state;
+
+  DEBUGASSERT(domain >= 0 && domain < CONFIG_PM_NDOMAINS);
+  pdom = &g_pmglobals.domain[domain];
+
+  /* Nothing to do in the common case that there are no constraints */
+
+  if (pdom->qos == NULL)
+    {
+      return PM_SLEEP;
+    }
+
+  now   = clock_systimer();
+  flags = enter_critical_section();
+
+  for (prev = NULL, req = pdom->qos; req != NULL; req = next)
+    {
+      next = req->flink;
+
+      if (req->expiry != 0 && (sclock_t)(now - req->expiry) >= 0)
+        {
+          pm_qos_unlink(req, prev);
+          continue;
+        }
+
+      if (req->qclass == PM_QOS_LATENCY && req->value < latency)
+        {
+          latency = req->value;
+        }
+      else if (req->qclass == PM_QOS_THROUGHPUT && req->value > throughput)
+        {
+          throughput = req->value;
+        }
+
+      prev = req;
+    }
+
+  leave_critical_section(flags);
+
+  /* The power states are ordered by increasing latency and decreasing
+   * throughput.  Find the last one that is still good enough.
+   */
+
+  states = pdom->qosstates != NULL ? pdom->qosstates : g_pmqos_states;
+
+  for (state = PM_NORMAL; state < PM_COUNT - 1; state++)
+    {
+      if (states[state + 1].latency > latency ||
+          states[state + 1].throughput < throughput)
+        {
+          break;
+        }
+    }
+
+  return state;
+}
+
+#endif /* CONFIG_PM_QOS */
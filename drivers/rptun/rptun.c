@@ -40,15 +40,19 @@
 #include <nuttx/config.h>
 
 #include <inttypes.h>
+#include <stdbool.h>
 #include <stdio.h>
 #include <fcntl.h>
+#include <unistd.h>
 
 #include <nuttx/arch.h>
+#include <nuttx/clock.h>
 #include <nuttx/kmalloc.h>
 #include <nuttx/kthread.h>
 #include <nuttx/rptun/openamp.h>
 #include <nuttx/rptun/rptun.h>
-#include <nuttx/signal.h>
+#include <nuttx/semaphore.h>
+#include <nuttx/wqueue.h>
 #include <metal/utilities.h>
 
 /****************************************************************************
@@ -75,6 +79,12 @@ struct rptun_priv_s
   struct rpmsg_virtio_shm_pool shm_pool;
   struct metal_list            bind;
   struct metal_list            node;
+  sem_t                        sem;       /* Wakes up rptun_thread */
+  volatile bool                rxpending; /* Notification from the remote */
+  uint16_t                     txpending; /* Kicks deferred to end of batch */
+#if defined(CONFIG_RPTUN_NOTIFY_DELAY) && CONFIG_RPTUN_NOTIFY_DELAY > 0
+  struct work_s                kickwork;  /* Delayed kick of the remote */
+#endif
   int                          pid;
 };
 
@@ -177,22 +187,32 @@ static METAL_DECLARE_LIST(g_rptun_priv);
 static int rptun_thread(int argc, FAR char *argv[])
 {
   FAR struct rptun_priv_s *priv;
-  sigset_t set;
-  int ret;
 
   priv = (FAR struct rptun_priv_s *)((uintptr_t)strtoul(argv[2], NULL, 0));
 
-  sigemptyset(&set);
-  sigaddset(&set, SIGUSR1);
-  nxsig_procmask(SIG_BLOCK, &set, NULL);
-
   while (1)
     {
-      ret = nxsig_timedwait(&set, NULL, NULL);
-      if (ret == SIGUSR1)
+      nxsem_wait_uninterruptible(&priv->sem);
+
+      /* Clear the flag first:  A notification arriving while the vrings
+       * are processed wakes the thread up again.
+       */
+
+      if (priv->rxpending)
         {
+          priv->rxpending = false;
           remoteproc_get_notification(&priv->rproc, RPTUN_NOTIFY_ALL);
         }
+
+      /* Kick the remote once for all the buffers that the callbacks sent
+       * or released in this batch.
+       */
+
+      if (priv->txpending)
+        {
+          priv->txpending = 0;
+          RPTUN_NOTIFY(priv->dev, RPTUN_NOTIFY_ALL);
+        }
     }
 
   return 0;
@@ -202,9 +222,26 @@ static int rptun_callback(FAR void *arg, uint32_t vqid)
 {
   FAR struct rptun_priv_s *priv = arg;
 
-  return nxsig_kill(priv->pid, SIGUSR1);
+  /* Coalesce notifications that arrive before the thread runs */
+
+  if (!priv->rxpending)
+    {
+      priv->rxpending = true;
+      nxsem_post(&priv->sem);
+    }
+
+  return 0;
 }
 
+#if defined(CONFIG_RPTUN_NOTIFY_DELAY) && CONFIG_RPTUN_NOTIFY_DELAY > 0
+static void rptun_kick_worker(FAR void *arg)
+{
+  FAR struct rptun_priv_s *priv = arg;
+
+  RPTUN_NOTIFY(priv->dev, RPTUN_NOTIFY_ALL);
+}
+#endif
+
 static FAR struct remoteproc *rptun_init(FAR struct remoteproc *rproc,
                                          FAR struct remoteproc_ops *ops,
                                          FAR void *arg)
@@ -297,7 +334,36 @@ static int rptun_notify(FAR struct remoteproc *rproc, uint32_t id)
 {
   FAR struct rptun_priv_s *priv = rproc->priv;
 
+  if (getpid() == priv->pid)
+    {
+      /* Called from an endpoint callback in rptun_thread:  kick the remote
+       * once at the end of the batch.  But never leave half of the send
+       * buffers unannounced:  A callback that waits for a free send buffer
+       * would otherwise wait for a remote that was never told to consume
+       * them.
+       */
+
+      if (++priv->txpending < priv->vdev.svq->vq_nentries / 2)
+        {
+          return 0;
+        }
+
+      priv->txpending = 0;
+    }
+
+#if defined(CONFIG_RPTUN_NOTIFY_DELAY) && CONFIG_RPTUN_NOTIFY_DELAY > 0
+  /* Interrupt moderation:  One kick covers all the buffers sent within
+   * CONFIG_RPTUN_NOTIFY_DELAY microseconds of the first one.
+   */
+
+  if (work_available(&priv->kickwork))
+    {
+      work_queue(HPWORK, &priv->kickwork, rptun_kick_worker, priv,
+                 USEC2TICK(CONFIG_RPTUN_NOTIFY_DELAY));
+    }
+#else
   RPTUN_NOTIFY(priv->dev, RPTUN_NOTIFY_ALL);
+#endif
 
   return 0;
 }
@@ -510,6 +576,10 @@ static int rptun_dev_stop(FAR struct remoteproc *rproc)
 
   RPTUN_UNREGISTER_CALLBACK(priv->dev);
 
+#if defined(CONFIG_RPTUN_NOTIFY_DELAY) && CONFIG_RPTUN_NOTIFY_DELAY > 0
+  work_cancel(HPWORK, &priv->kickwork);
+#endif
+
   nxsem_wait(&g_rptun_sem);
 
   /* Remove priv from list */
@@ -811,6 +881,9 @@ int rptun_initialize(FAR struct rptun_dev_s *dev)
       return -ENOMEM;
     }
 
+  nxsem_init(&priv->sem, 0, 0);
+  nxsem_setprotocol(&priv->sem, SEM_PRIO_NONE);
+
   snprintf(arg1, 16, "0x%" PRIxPTR, (uintptr_t)priv);
 
   argv[0] = (void *)RPTUN_GET_CPUNAME(dev);
@@ -824,6 +897,7 @@ int rptun_initialize(FAR struct rptun_dev_s *dev)
                        argv);
   if (ret < 0)
     {
+      nxsem_destroy(&priv->sem);
       kmm_free(priv);
       return ret;
     }
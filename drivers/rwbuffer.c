@@ -130,72 +130,271 @@ static inline bool rwb_overlap(off_t blockstart1, size_t nblocks1,
  ****************************************************************************/
 
 #ifdef CONFIG_DRVR_WRITEBUFFER
-static inline void rwb_resetwrbuffer(struct rwbuffer_s *rwb)
+static inline void rwb_resetwrbuffer(FAR struct rwb_wrbuffer_s *wrbuf)
 {
-  /* We assume that the caller holds the wrsem */
+  wrbuf->nblocks = 0;
+  wrbuf->nsegs   = 0;
+}
+#endif
+
+/****************************************************************************
+ * Name: rwb_wroffset
+ *
+ * Description:
+ *   Return the offset in blocks of the data of segment 'seg' in the write
+ *   buffer memory.
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_DRVR_WRITEBUFFER
+static size_t rwb_wroffset(FAR struct rwb_wrbuffer_s *wrbuf, int seg)
+{
+  size_t offset = 0;
+  int i;
+
+  for (i = 0; i < seg; i++)
+    {
+      offset += wrbuf->segs[i].nblocks;
+    }
 
-  rwb->wrnblocks       = 0;
-  rwb->wrblockstart    = (off_t)-1;
-  rwb->wrexpectedblock = (off_t)-1;
+  return offset;
 }
 #endif
 
 /****************************************************************************
- * Name: rwb_wrflush
+ * Name: rwb_wrlookup
+ *
+ * Description:
+ *   Find a block in a write buffer.  On entry, *count holds the maximum
+ *   number of blocks of interest.  If the block is buffered, a pointer to
+ *   its data is returned and *count is reduced to the number of blocks
+ *   that follow it contiguously in the buffer.  Otherwise, NULL is returned
+ *   and *count is reduced to the number of blocks before the next buffered
+ *   block.
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_DRVR_WRITEBUFFER
+static FAR uint8_t *rwb_wrlookup(FAR struct rwbuffer_s *rwb,
+                                 FAR struct rwb_wrbuffer_s *wrbuf,
+                                 off_t block, FAR size_t *count)
+{
+  FAR struct rwb_wrseg_s *seg;
+  size_t offset = 0;
+  size_t navail;
+  int i;
+
+  for (i = 0; i < wrbuf->nsegs; i++)
+    {
+      seg = &wrbuf->segs[i];
+      if (block < seg->blockstart)
+        {
+          navail = seg->blockstart - block;
+          if (navail < *count)
+            {
+              *count = navail;
+            }
+
+          return NULL;
+        }
+
+      if (block < seg->blockstart + seg->nblocks)
+        {
+          navail = seg->blockstart + seg->nblocks - block;
+          if (navail < *count)
+            {
+              *count = navail;
+            }
+
+          offset += block - seg->blockstart;
+          return wrbuf->buffer + offset * rwb->blocksize;
+        }
+
+      offset += seg->nblocks;
+    }
+
+  return NULL;
+}
+#endif
+
+/****************************************************************************
+ * Name: rwb_rhupdate
+ *
+ * Description:
+ *   Copy blocks that were just written to the media into any read-ahead
+ *   buffer that holds them.  A read-ahead buffer may have been loaded from
+ *   the media while newer data for the same blocks was still in the write
+ *   buffer.
+ *
+ ****************************************************************************/
+
+#if defined(CONFIG_DRVR_WRITEBUFFER) && defined(CONFIG_DRVR_READAHEAD)
+static void rwb_rhupdate(FAR struct rwbuffer_s *rwb,
+                         FAR const uint8_t *buffer,
+                         off_t startblock, size_t nblocks)
+{
+  FAR struct rwb_rhbuffer_s *rhbuf;
+  off_t first;
+  off_t end;
+  int i;
+
+  if (rwb->rhmaxblocks == 0)
+    {
+      return;
+    }
+
+  rwb_semtake(&rwb->rhsem);
+  for (i = 0; i < CONFIG_DRVR_RHENTRIES; i++)
+    {
+      rhbuf = &rwb->rhbuf[i];
+      first = rhbuf->blockstart > startblock ?
+              rhbuf->blockstart : startblock;
+      end   = rhbuf->blockstart + rhbuf->nblocks < startblock + nblocks ?
+              rhbuf->blockstart + rhbuf->nblocks : startblock + nblocks;
+
+      if (rhbuf->nblocks > 0 && first < end)
+        {
+          memcpy(rhbuf->buffer + (first - rhbuf->blockstart) *
+                 rwb->blocksize,
+                 buffer + (first - startblock) * rwb->blocksize,
+                 (end - first) * rwb->blocksize);
+        }
+    }
+
+  rwb_semgive(&rwb->rhsem);
+}
+#else
+#  define rwb_rhupdate(rwb,buffer,startblock,nblocks)
+#endif
+
+/****************************************************************************
+ * Name: rwb_wrdrain
+ *
+ * Description:
+ *   Write every segment of a write buffer to the media and empty the
+ *   buffer.
  *
  * Assumptions:
- *   The caller holds the wrsem semaphore.
+ *   The caller holds the wrflushsem semaphore.
  *
  ****************************************************************************/
 
 #ifdef CONFIG_DRVR_WRITEBUFFER
-static void rwb_wrflush(struct rwbuffer_s *rwb)
+static int rwb_wrdrain(FAR struct rwbuffer_s *rwb,
+                       FAR struct rwb_wrbuffer_s *wrbuf)
 {
-  int ret;
+  FAR struct rwb_wrseg_s *seg;
+  FAR uint8_t *src = wrbuf->buffer;
+  ssize_t nwritten;
+  int ret = OK;
+  int i;
 
-  if (rwb->wrnblocks > 0)
+  for (i = 0; i < wrbuf->nsegs; i++)
     {
+      seg = &wrbuf->segs[i];
+
       finfo("Flushing: blockstart=0x%08lx nblocks=%d from buffer=%p\n",
-      (long)rwb->wrblockstart, rwb->wrnblocks, rwb->wrbuffer);
+            (long)seg->blockstart, seg->nblocks, src);
 
-      /* Flush cache.  On success, the flush method will return the number
-       * of blocks written.  Anything other than the number requested is
-       * an error.
+      /* On success, the flush method will return the number of blocks
+       * written.  Anything other than the number requested is an error.
        */
 
-      ret = rwb->wrflush(rwb->dev, rwb->wrbuffer, rwb->wrblockstart, rwb->wrnblocks);
-      if (ret != rwb->wrnblocks)
+      nwritten = rwb->wrflush(rwb->dev, src, seg->blockstart, seg->nblocks);
+      if (nwritten != seg->nblocks)
         {
-          ferr("ERROR: Error flushing write buffer: %d\n", ret);
+          ferr("ERROR: Error flushing write buffer: %d\n", (int)nwritten);
+          if (ret == OK)
+            {
+              ret = nwritten < 0 ? (int)nwritten : -EIO;
+            }
+        }
+      else
+        {
+          rwb_rhupdate(rwb, src, seg->blockstart, seg->nblocks);
         }
 
-      rwb_resetwrbuffer(rwb);
+      src += seg->nblocks * rwb->blocksize;
     }
+
+  rwb_resetwrbuffer(wrbuf);
+  return ret;
 }
 #endif
 
 /****************************************************************************
- * Name: rwb_wrtimeout
+ * Name: rwb_wrflush
+ *
+ * Description:
+ *   Write all buffered data to the media and wait for it to complete.
+ *
+ * Assumptions:
+ *   The caller holds the wrsem semaphore.
+ *
  ****************************************************************************/
 
-#if defined(CONFIG_DRVR_WRITEBUFFER) && CONFIG_DRVR_WRDELAY != 0
-static void rwb_wrtimeout(FAR void *arg)
+#ifdef CONFIG_DRVR_WRITEBUFFER
+static int rwb_wrflush(FAR struct rwbuffer_s *rwb)
 {
-  /* The following assumes that the size of a pointer is 4-bytes or less */
+  int ret;
 
-  FAR struct rwbuffer_s *rwb = (struct rwbuffer_s *)arg;
+  /* Wait for any buffer that is being drained, then drain the buffer that
+   * is being filled.
+   */
+
+  rwb_semtake(&rwb->wrflushsem);
+  ret = rwb_wrdrain(rwb, &rwb->wrbuf[rwb->wrcur]);
+  rwb_semgive(&rwb->wrflushsem);
+  return ret;
+}
+#endif
+
+/****************************************************************************
+ * Name: rwb_wrdrainworker
+ *
+ * Description:
+ *   Drain the write buffer that was handed off by rwb_wrswap().  This runs
+ *   on the low priority work queue while writers fill the other buffer.
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_DRVR_WRDOUBLEBUFFER
+static void rwb_wrdrainworker(FAR void *arg)
+{
+  FAR struct rwbuffer_s *rwb = (FAR struct rwbuffer_s *)arg;
   DEBUGASSERT(rwb != NULL);
 
-  finfo("Timeout!\n");
+  /* wrflushsem was taken on our behalf, so wrcur cannot change until we
+   * release it.
+   */
 
-  /* If a timeout elapses with with write buffer activity, this watchdog
-   * handler function will be evoked on the thread of execution of the
-   * worker thread.
+  rwb_wrdrain(rwb, &rwb->wrbuf[rwb->wrcur ^ 1]);
+  rwb_semgive(&rwb->wrflushsem);
+}
+#endif
+
+/****************************************************************************
+ * Name: rwb_wrswap
+ *
+ * Description:
+ *   Hand the buffer being filled off to the work queue to be written to
+ *   the media and start filling the other buffer.
+ *
+ * Assumptions:
+ *   The caller holds the wrsem semaphore.
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_DRVR_WRDOUBLEBUFFER
+static void rwb_wrswap(FAR struct rwbuffer_s *rwb)
+{
+  /* Wait until the other buffer has been written out.  The worker does not
+   * need wrsem, so this cannot deadlock.
    */
 
-  rwb_semtake(&rwb->wrsem);
-  rwb_wrflush(rwb);
-  rwb_semgive(&rwb->wrsem);
+  rwb_semtake(&rwb->wrflushsem);
+  rwb->wrcur ^= 1;
+  work_queue(LPWORK, &rwb->flushwork, rwb_wrdrainworker, rwb, 0);
 }
 #endif
 
@@ -203,6 +402,10 @@ static void rwb_wrtimeout(FAR void *arg)
  * Name: rwb_wrstarttimeout
  ****************************************************************************/
 
+#if defined(CONFIG_DRVR_WRITEBUFFER) && CONFIG_DRVR_WRDELAY != 0
+static void rwb_wrtimeout(FAR void *arg);
+#endif
+
 #ifdef CONFIG_DRVR_WRITEBUFFER
 static void rwb_wrstarttimeout(FAR struct rwbuffer_s *rwb)
 {
@@ -217,6 +420,63 @@ static void rwb_wrstarttimeout(FAR struct rwbuffer_s *rwb)
 }
 #endif
 
+/****************************************************************************
+ * Name: rwb_wrtimeout
+ ****************************************************************************/
+
+#if defined(CONFIG_DRVR_WRITEBUFFER) && CONFIG_DRVR_WRDELAY != 0
+static void rwb_wrtimeout(FAR void *arg)
+{
+  /* The following assumes that the size of a pointer is 4-bytes or less */
+
+  FAR struct rwbuffer_s *rwb = (struct rwbuffer_s *)arg;
+#ifdef CONFIG_DRVR_WRDOUBLEBUFFER
+  FAR struct rwb_wrbuffer_s *wrbuf;
+#endif
+
+  DEBUGASSERT(rwb != NULL);
+
+  finfo("Timeout!\n");
+
+  /* If a timeout elapses with with write buffer activity, this watchdog
+   * handler function will be evoked on the thread of execution of the
+   * worker thread.
+   */
+
+#ifdef CONFIG_DRVR_WRDOUBLEBUFFER
+  /* The thread holding either semaphore may be waiting for a drain that is
+   * queued behind us on the work queue.  Don't block; try again later.
+   */
+
+  if (nxsem_trywait(&rwb->wrsem) < 0)
+    {
+      rwb_wrstarttimeout(rwb);
+      return;
+    }
+
+  if (nxsem_trywait(&rwb->wrflushsem) < 0)
+    {
+      rwb_wrstarttimeout(rwb);
+      rwb_semgive(&rwb->wrsem);
+      return;
+    }
+
+  /* Swap the buffers so that writers are not blocked while we drain */
+
+  wrbuf       = &rwb->wrbuf[rwb->wrcur];
+  rwb->wrcur ^= 1;
+  rwb_semgive(&rwb->wrsem);
+
+  rwb_wrdrain(rwb, wrbuf);
+  rwb_semgive(&rwb->wrflushsem);
+#else
+  rwb_semtake(&rwb->wrsem);
+  rwb_wrflush(rwb);
+  rwb_semgive(&rwb->wrsem);
+#endif
+}
+#endif
+
 /****************************************************************************
  * Name: rwb_wrcanceltimeout
  ****************************************************************************/
@@ -232,6 +492,16 @@ static inline void rwb_wrcanceltimeout(struct rwbuffer_s *rwb)
 
 /****************************************************************************
  * Name: rwb_writebuffer
+ *
+ * Description:
+ *   Add blocks to the write buffer.  The new blocks are merged with any
+ *   segments that they overlap or abut, so the segments stay sorted,
+ *   disjoint and non-adjacent.  The buffer is flushed only if there is no
+ *   room for the new blocks or no free segment.
+ *
+ * Assumptions:
+ *   The caller holds the wrsem semaphore.
+ *
  ****************************************************************************/
 
 #ifdef CONFIG_DRVR_WRITEBUFFER
@@ -239,53 +509,160 @@ static ssize_t rwb_writebuffer(FAR struct rwbuffer_s *rwb,
                                off_t startblock, uint32_t nblocks,
                                FAR const uint8_t *wrbuffer)
 {
+  FAR struct rwb_wrbuffer_s *wrbuf;
+  FAR struct rwb_wrseg_s *seg;
+  FAR uint8_t *base;
+  off_t endblock = startblock + nblocks;
+  off_t newstart;
+  off_t newend;
+  size_t blocksize = rwb->blocksize;
+  size_t oldblocks;
+  size_t growth;
+  size_t offset;
+  size_t pos;
+  int first;
+  int last;
+  int i;
+#ifndef CONFIG_DRVR_WRDOUBLEBUFFER
   int ret;
+#endif
 
   /* Write writebuffer Logic */
 
   rwb_wrcanceltimeout(rwb);
 
-  /* First: Should we flush out our cache? We would do that if (1) we already
-   * buffering blocks and the next block writing is not in the same sequence,
-   * or (2) the number of blocks would exceed our allocated buffer capacity
-   */
-
-  if (((startblock != rwb->wrexpectedblock) && (rwb->wrnblocks)) ||
-      ((rwb->wrnblocks + nblocks) > rwb->wrmaxblocks))
+  for (; ; )
     {
-      finfo("writebuffer miss, expected: %08x, given: %08x\n",
-            rwb->wrexpectedblock, startblock);
+      wrbuf = &rwb->wrbuf[rwb->wrcur];
+
+      /* Find the range of segments that the new blocks overlap or abut:
+       * 'first' is the first segment that ends at or after startblock and
+       * 'last' is the last segment that begins at or before endblock.
+       */
 
-      /* Flush the write buffer */
+      first = 0;
+      while (first < wrbuf->nsegs &&
+             wrbuf->segs[first].blockstart + wrbuf->segs[first].nblocks <
+             startblock)
+        {
+          first++;
+        }
 
-      ret = rwb->wrflush(rwb->dev, rwb->wrbuffer, rwb->wrblockstart, rwb->wrnblocks);
+      last = first - 1;
+      while (last + 1 < wrbuf->nsegs &&
+             wrbuf->segs[last + 1].blockstart <= endblock)
+        {
+          last++;
+        }
+
+      /* Those segments and the new blocks become one segment */
+
+      newstart  = startblock;
+      newend    = endblock;
+      oldblocks = 0;
+
+      for (i = first; i <= last; i++)
+        {
+          seg = &wrbuf->segs[i];
+          if (seg->blockstart < newstart)
+            {
+              newstart = seg->blockstart;
+            }
+
+          if (seg->blockstart + seg->nblocks > newend)
+            {
+              newend = seg->blockstart + seg->nblocks;
+            }
+
+          oldblocks += seg->nblocks;
+        }
+
+      growth = (newend - newstart) - oldblocks;
+
+      /* Is there room for the new blocks and, if nothing is merged, for a
+       * new segment?
+       */
+
+      if (wrbuf->nblocks + growth <= rwb->wrmaxblocks &&
+          (first <= last || wrbuf->nsegs < CONFIG_DRVR_WRSEGMENTS))
+        {
+          break;
+        }
+
+      /* No.. flush the write buffer and try again.  The blocks always fit
+       * in an empty buffer.
+       */
+
+      finfo("writebuffer full: nblocks=%d nsegs=%d\n",
+            wrbuf->nblocks, wrbuf->nsegs);
+
+#ifdef CONFIG_DRVR_WRDOUBLEBUFFER
+      rwb_wrswap(rwb);
+#else
+      ret = rwb_wrflush(rwb);
       if (ret < 0)
         {
           ferr("ERROR: Error writing multiple from cache: %d\n", -ret);
           return ret;
         }
+#endif
+    }
+
+  finfo("writebuffer: merging blocks %ld-%ld into segment %d\n",
+        (long)startblock, (long)endblock - 1, first);
+
+  /* Make room for the new blocks by moving the data of all following
+   * segments up.
+   */
 
-      rwb_resetwrbuffer(rwb);
+  offset = rwb_wroffset(wrbuf, first);
+  base   = wrbuf->buffer + offset * blocksize;
+
+  if (growth > 0)
+    {
+      memmove(base + (oldblocks + growth) * blocksize,
+              base + oldblocks * blocksize,
+              (wrbuf->nblocks - offset - oldblocks) * blocksize);
     }
 
-  /* writebuffer is empty? Then initialize it */
+  /* Spread the merged segments out to their final places in the new
+   * segment.  The data only moves up, so work backward.  The gaps between
+   * them all lie within the new blocks.
+   */
 
-  if (rwb->wrnblocks == 0)
+  pos = oldblocks;
+  for (i = last; i >= first; i--)
     {
-      finfo("Fresh cache starting at block: 0x%08x\n", startblock);
-      rwb->wrblockstart = startblock;
+      seg  = &wrbuf->segs[i];
+      pos -= seg->nblocks;
+      memmove(base + (seg->blockstart - newstart) * blocksize,
+              base + pos * blocksize, seg->nblocks * blocksize);
     }
 
-  /* Add data to cache */
+  /* Add the new data */
+
+  memcpy(base + (startblock - newstart) * blocksize, wrbuffer,
+         nblocks * blocksize);
+
+  /* And update the segment list */
+
+  if (first > last)
+    {
+      memmove(&wrbuf->segs[first + 1], &wrbuf->segs[first],
+              (wrbuf->nsegs - first) * sizeof(struct rwb_wrseg_s));
+      wrbuf->nsegs++;
+    }
+  else if (last > first)
+    {
+      memmove(&wrbuf->segs[first + 1], &wrbuf->segs[last + 1],
+              (wrbuf->nsegs - last - 1) * sizeof(struct rwb_wrseg_s));
+      wrbuf->nsegs -= last - first;
+    }
 
-  finfo("writebuffer: copying %d bytes from %p to %p\n",
-        nblocks * rwb->blocksize, wrbuffer,
-        &rwb->wrbuffer[rwb->wrnblocks * rwb->blocksize]);
-  memcpy(&rwb->wrbuffer[rwb->wrnblocks * rwb->blocksize],
-         wrbuffer, nblocks * rwb->blocksize);
+  wrbuf->segs[first].blockstart = newstart;
+  wrbuf->segs[first].nblocks    = newend - newstart;
+  wrbuf->nblocks               += growth;
 
-  rwb->wrnblocks      += nblocks;
-  rwb->wrexpectedblock = rwb->wrblockstart + rwb->wrnblocks;
   rwb_wrstarttimeout(rwb);
   return nblocks;
 }
@@ -298,10 +675,38 @@ static ssize_t rwb_writebuffer(FAR struct rwbuffer_s *rwb,
 #ifdef CONFIG_DRVR_READAHEAD
 static inline void rwb_resetrhbuffer(struct rwbuffer_s *rwb)
 {
+  int i;
+
   /* We assume that the caller holds the readAheadBufferSemphore */
 
-  rwb->rhnblocks    = 0;
-  rwb->rhblockstart = (off_t)-1;
+  for (i = 0; i < CONFIG_DRVR_RHENTRIES; i++)
+    {
+      rwb->rhbuf[i].nblocks    = 0;
+      rwb->rhbuf[i].blockstart = (off_t)-1;
+    }
+}
+#endif
+
+/****************************************************************************
+ * Name: rwb_rhtouch
+ *
+ * Description:
+ *   Make read-ahead buffer 'index' the most recently used one.
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_DRVR_READAHEAD
+static inline void rwb_rhtouch(FAR struct rwbuffer_s *rwb, int index)
+{
+  struct rwb_rhbuffer_s rhbuf;
+
+  if (index > 0)
+    {
+      rhbuf = rwb->rhbuf[index];
+      memmove(&rwb->rhbuf[1], &rwb->rhbuf[0],
+              index * sizeof(struct rwb_rhbuffer_s));
+      rwb->rhbuf[0] = rhbuf;
+    }
 }
 #endif
 
@@ -311,8 +716,8 @@ static inline void rwb_resetrhbuffer(struct rwbuffer_s *rwb)
 
 #ifdef CONFIG_DRVR_READAHEAD
 static inline void
-rwb_bufferread(struct rwbuffer_s *rwb,  off_t startblock,
-               size_t nblocks, uint8_t **rdbuffer)
+rwb_bufferread(struct rwbuffer_s *rwb, struct rwb_rhbuffer_s *rhbuf,
+               off_t startblock, size_t nblocks, uint8_t **rdbuffer)
 {
   /* We assume that (1) the caller holds the readAheadBufferSemphore, and (2)
    * that the caller already knows that all of the blocks are in the
@@ -321,13 +726,13 @@ rwb_bufferread(struct rwbuffer_s *rwb,  off_t startblock,
 
   /* Convert the units from blocks to bytes */
 
-  off_t  blockoffset = startblock - rwb->rhblockstart;
+  off_t  blockoffset = startblock - rhbuf->blockstart;
   off_t  byteoffset  = rwb->blocksize * blockoffset;
   size_t nbytes      = rwb->blocksize * nblocks;
 
   /* Get the byte address in the read-ahead buffer */
 
-  uint8_t *rhbuffer    = rwb->rhbuffer + byteoffset;
+  uint8_t *rhbuffer    = rhbuf->buffer + byteoffset;
 
   /* Copy the data from the read-ahead buffer into the IO buffer */
 
@@ -341,11 +746,17 @@ rwb_bufferread(struct rwbuffer_s *rwb,  off_t startblock,
 
 /****************************************************************************
  * Name: rwb_rhreload
+ *
+ * Description:
+ *   Reload the least recently used read-ahead buffer, starting at
+ *   startblock.  On success, it becomes the most recently used buffer.
+ *
  ****************************************************************************/
 
 #ifdef CONFIG_DRVR_READAHEAD
 static int rwb_rhreload(struct rwbuffer_s *rwb, off_t startblock)
 {
+  FAR struct rwb_rhbuffer_s *rhbuf;
   off_t  endblock;
   size_t nblocks;
   int    ret;
@@ -372,19 +783,22 @@ static int rwb_rhreload(struct rwbuffer_s *rwb, off_t startblock)
 
   nblocks = endblock - startblock;
 
-  /* Reset the read buffer */
+  /* Reuse the least recently used read buffer */
 
-  rwb_resetrhbuffer(rwb);
+  rwb_rhtouch(rwb, CONFIG_DRVR_RHENTRIES - 1);
+  rhbuf             = &rwb->rhbuf[0];
+  rhbuf->nblocks    = 0;
+  rhbuf->blockstart = (off_t)-1;
 
   /* Now perform the read */
 
-  ret = rwb->rhreload(rwb->dev, rwb->rhbuffer, startblock, nblocks);
+  ret = rwb->rhreload(rwb->dev, rhbuf->buffer, startblock, nblocks);
   if (ret == nblocks)
     {
       /* Update information about what is in the read-ahead buffer */
 
-      rwb->rhnblocks    = nblocks;
-      rwb->rhblockstart = startblock;
+      rhbuf->nblocks    = nblocks;
+      rhbuf->blockstart = startblock;
 
       /* The return value is not the number of blocks we asked to be loaded. */
 
@@ -404,128 +818,137 @@ static int rwb_rhreload(struct rwbuffer_s *rwb, off_t startblock)
  ****************************************************************************/
 
 #if defined(CONFIG_DRVR_WRITEBUFFER) && defined(CONFIG_DRVR_INVALIDATE)
-int rwb_invalidate_writebuffer(FAR struct rwbuffer_s *rwb,
-                               off_t startblock, size_t blockcount)
+static int rwb_invalidate_writebuffer(FAR struct rwbuffer_s *rwb,
+                                      off_t startblock, size_t blockcount)
 {
-  int ret = OK;
-
-  /* Is there a write buffer?  Is data saved in the write buffer? */
+  FAR struct rwb_wrbuffer_s *wrbuf;
+  FAR struct rwb_wrseg_s *seg;
+  FAR uint8_t *dest;
+  off_t    invend;
+  off_t    segend;
+  size_t   offset;
+  size_t   nhead;
+  size_t   ntail;
+  size_t   ninval;
+  int      ret = OK;
+  int      i;
+
+  /* Is there a write buffer? */
 
-  if (rwb->wrmaxblocks > 0 && rwb->wrnblocks > 0)
+  if (rwb->wrmaxblocks > 0)
     {
-      off_t wrbend;
-      off_t invend;
-
       finfo("startblock=%d blockcount=%p\n", startblock, blockcount);
 
-      rwb_semtake(&rwb->wrsem);
-
-      /* Now there are five cases:
-       *
-       * 1. We invalidate nothing
+      /* Wait for any buffer that is being drained.  Then all buffered data
+       * is in the buffer being filled.
        */
 
-      wrbend = rwb->wrblockstart + rwb->wrnblocks;
-      invend = startblock + blockcount;
-
-      if (rwb->wrblockstart > invend || wrbend < startblock)
-        {
-          ret = OK;
-        }
-
-      /* 2. We invalidate the entire write buffer. */
-
-      else if (rwb->wrblockstart >= startblock && wrbend <= invend)
-        {
-          rwb->wrnblocks = 0;
-          ret = OK;
-        }
+      rwb_semtake(&rwb->wrsem);
+      rwb_semtake(&rwb->wrflushsem);
 
-      /* We are going to invalidate a subset of the write buffer.  Three
-       * more cases to consider:
-       *
-       * 2. We invalidate a portion in the middle of the write buffer
-       */
+      wrbuf  = &rwb->wrbuf[rwb->wrcur];
+      invend = startblock + blockcount;
+      offset = 0;
 
-      else if (rwb->wrblockstart < startblock && wrbend > invend)
+      for (i = 0; i < wrbuf->nsegs; )
         {
-          uint8_t *src;
-          off_t    block;
-          off_t    offset;
-          size_t   nblocks;
-
-          /* Write the blocks at the end of the media to hardware */
+          seg    = &wrbuf->segs[i];
+          segend = seg->blockstart + seg->nblocks;
 
-          nblocks = wrbend - invend;
-          block   = invend;
-          offset  = block - rwb->wrblockstart;
-          src     = rwb->wrbuffer + offset * rwb->blocksize;
+          /* Skip segments that we invalidate nothing of */
 
-          ret = rwb->wrflush(rwb->dev, src, block, nblocks);
-          if (ret < 0)
+          if (segend <= startblock)
             {
-              ferr("ERROR: wrflush failed: %d\n", ret);
+              offset += seg->nblocks;
+              i++;
+              continue;
             }
-
-          /* Keep the blocks at the beginning of the buffer up the
-           * start of the invalidated region.
-           */
-          else
+          else if (seg->blockstart >= invend)
             {
-              rwb->wrnblocks = startblock - rwb->wrblockstart;
-              ret = OK;
+              break;
             }
-        }
 
-      /* 3. We invalidate a portion at the end of the write buffer */
+          /* Get the number of blocks kept before and after the invalidated
+           * region.
+           */
 
-      else if (wrbend > startblock && wrbend <= invend)
-        {
-          rwb->wrnblocks = wrbend - startblock;
-          ret = OK;
-        }
+          nhead  = startblock > seg->blockstart ?
+                   startblock - seg->blockstart : 0;
+          ntail  = segend > invend ? segend - invend : 0;
+          ninval = seg->nblocks - nhead - ntail;
 
-      /* 4. We invalidate a portion at the beginning of the write buffer */
+          /* Invalidating a portion in the middle of the segment splits it
+           * in two.  If there is no free segment, write the blocks at the
+           * end to hardware instead.
+           */
 
-      else /* if (rwb->wrblockstart >= startblock && wrbend > invend) */
-        {
-          uint8_t *src;
-          size_t   ninval;
-          size_t   nkeep;
+          if (nhead > 0 && ntail > 0 &&
+              wrbuf->nsegs >= CONFIG_DRVR_WRSEGMENTS)
+            {
+              dest = wrbuf->buffer +
+                     (offset + nhead + ninval) * rwb->blocksize;
 
-          DEBUGASSERT(rwb->wrblockstart >= startblock && wrbend > invend);
+              ret = rwb->wrflush(rwb->dev, dest, invend, ntail);
+              if (ret < 0)
+                {
+                  ferr("ERROR: wrflush failed: %d\n", ret);
+                  break;
+                }
 
-          /* Copy the data from the uninvalidated region to the beginning
-           * of the write buffer.
-           *
-           * First calculate the source and destination of the transfer.
-           */
+              rwb_rhupdate(rwb, dest, invend, ntail);
+              ret     = OK;
+              ninval += ntail;
+              ntail   = 0;
+            }
 
-          ninval = invend - rwb->wrblockstart;
-          src    = rwb->wrbuffer + ninval * rwb->blocksize;
+          /* Remove the invalidated blocks from the buffer memory */
 
-          /* Calculate the number of blocks we are keeping.  We keep
-           * the ones that we don't invalidate.
-           */
+          dest = wrbuf->buffer + (offset + nhead) * rwb->blocksize;
+          memmove(dest, dest + ninval * rwb->blocksize,
+                  (wrbuf->nblocks - offset - nhead - ninval) *
+                  rwb->blocksize);
+          wrbuf->nblocks -= ninval;
 
-          nkeep  = rwb->wrnblocks - ninval;
+          if (nhead > 0 && ntail > 0)
+            {
+              /* Split the segment */
 
-          /* Then move the data that we are keeping to the beginning
-           * the write buffer.
-           */
+              memmove(&wrbuf->segs[i + 2], &wrbuf->segs[i + 1],
+                      (wrbuf->nsegs - i - 1) * sizeof(struct rwb_wrseg_s));
+              wrbuf->nsegs++;
 
-          memcpy(rwb->wrbuffer, src, nkeep * rwb->blocksize);
+              wrbuf->segs[i + 1].blockstart = invend;
+              wrbuf->segs[i + 1].nblocks    = ntail;
+              seg->nblocks                  = nhead;
+              break;
+            }
+          else if (nhead > 0)
+            {
+              /* Keep the blocks at the beginning of the segment */
 
-          /* Update the block info.  The first block is now the one just
-           * after the invalidation region and the number buffered blocks
-           * is the number that we kept.
-           */
+              seg->nblocks = nhead;
+              offset      += nhead;
+              i++;
+            }
+          else if (ntail > 0)
+            {
+              /* Keep the blocks at the end of the segment */
 
-          rwb->wrblockstart = invend;
-          rwb->wrnblocks    = nkeep;
-          ret = OK;
+              seg->blockstart = invend;
+              seg->nblocks    = ntail;
+              break;
+            }
+          else
+            {
+              /* We invalidate the entire segment */
+
+              memmove(&wrbuf->segs[i], &wrbuf->segs[i + 1],
+                      (wrbuf->nsegs - i - 1) * sizeof(struct rwb_wrseg_s));
+              wrbuf->nsegs--;
+            }
         }
 
+      rwb_semgive(&rwb->wrflushsem);
       rwb_semgive(&rwb->wrsem);
     }
 
@@ -534,116 +957,134 @@ int rwb_invalidate_writebuffer(FAR struct rwbuffer_s *rwb,
 #endif
 
 /****************************************************************************
- * Name: rwb_invalidate_readahead
+ * Name: rwb_rhinvalidate
  *
  * Description:
- *   Invalidate a region of the read-ahead buffer
+ *   Invalidate a region of one read-ahead buffer
  *
  ****************************************************************************/
 
 #if defined(CONFIG_DRVR_READAHEAD)  && defined(CONFIG_DRVR_INVALIDATE)
-int rwb_invalidate_readahead(FAR struct rwbuffer_s *rwb,
-                               off_t startblock, size_t blockcount)
+static void rwb_rhinvalidate(FAR struct rwbuffer_s *rwb,
+                             FAR struct rwb_rhbuffer_s *rhbuf,
+                             off_t startblock, size_t blockcount)
 {
-  int ret;
+  off_t rhbend;
+  off_t invend;
 
-  if (rwb->rhmaxblocks > 0 && rwb->rhnblocks > 0)
+  /* Now there are five cases:
+   *
+   * 1. We invalidate nothing
+   */
+
+  rhbend = rhbuf->blockstart + rhbuf->nblocks;
+  invend = startblock + blockcount;
+
+  if (rhbuf->nblocks == 0 || rhbend <= startblock ||
+      rhbuf->blockstart >= invend)
     {
-      off_t rhbend;
-      off_t invend;
+      return;
+    }
 
-      finfo("startblock=%d blockcount=%p\n", startblock, blockcount);
+  /* 2. We invalidate the entire read-ahead buffer. */
 
-      rwb_semtake(&rwb->rhsem);
+  if (rhbuf->blockstart >= startblock && rhbend <= invend)
+    {
+      rhbuf->nblocks = 0;
+    }
 
-      /* Now there are five cases:
-       *
-       * 1. We invalidate nothing
+  /* We are going to invalidate a subset of the read-ahead buffer.
+   * Three more cases to consider:
+   *
+   * 2. We invalidate a portion in the middle of the read-ahead buffer
+   */
+
+  else if (rhbuf->blockstart < startblock && rhbend > invend)
+    {
+      /* Keep the blocks at the beginning of the buffer up the
+       * start of the invalidated region.
        */
 
-      rhbend = rwb->rhblockstart + rwb->rhnblocks;
-      invend = startblock + blockcount;
+      rhbuf->nblocks = startblock - rhbuf->blockstart;
+    }
 
-      if (rhbend <= startblock || rwb->rhblockstart >= invend)
-        {
-          ret = OK;
-        }
+  /* 3. We invalidate a portion at the end of the read-ahead buffer */
 
-      /* 2. We invalidate the entire read-ahead buffer. */
+  else if (rhbend > startblock && rhbend <= invend)
+    {
+      rhbuf->nblocks = startblock - rhbuf->blockstart;
+    }
 
-      else if (rwb->rhblockstart >= startblock && rhbend <= invend)
-        {
-          rwb->rhnblocks = 0;
-          ret = OK;
-        }
+  /* 4. We invalidate a portion at the beginning of the write buffer */
 
-      /* We are going to invalidate a subset of the read-ahead buffer.
-       * Three more cases to consider:
-       *
-       * 2. We invalidate a portion in the middle of the read-ahead buffer
-       */
+  else /* if (rhbuf->blockstart >= startblock && rhbend > invend) */
+    {
+      uint8_t *src;
+      size_t   ninval;
+      size_t   nkeep;
 
-      else if (rwb->rhblockstart < startblock && rhbend > invend)
-        {
-          /* Keep the blocks at the beginning of the buffer up the
-           * start of the invalidated region.
-           */
+      DEBUGASSERT(rhbuf->blockstart >= startblock && rhbend > invend);
 
-          rwb->rhnblocks = startblock - rwb->rhblockstart;
-          ret = OK;
-        }
+      /* Copy the data from the uninvalidated region to the beginning
+       * of the read buffer.
+       *
+       * First calculate the source and destination of the transfer.
+       */
 
-      /* 3. We invalidate a portion at the end of the read-ahead buffer */
+      ninval = invend - rhbuf->blockstart;
+      src    = rhbuf->buffer + ninval * rwb->blocksize;
 
-      else if (rhbend > startblock && rhbend <= invend)
-        {
-          rwb->rhnblocks = rhbend - startblock;
-          ret = OK;
-        }
+      /* Calculate the number of blocks we are keeping.  We keep
+       * the ones that we don't invalidate.
+       */
 
-      /* 4. We invalidate a portion at the beginning of the write buffer */
+      nkeep  = rhbuf->nblocks - ninval;
 
-      else /* if (rwb->rhblockstart >= startblock && rhbend > invend) */
-        {
-          uint8_t *src;
-          size_t   ninval;
-          size_t   nkeep;
-
-          DEBUGASSERT(rwb->rhblockstart >= startblock && rhbend > invend);
-          /* Copy the data from the uninvalidated region to the beginning
-           * of the read buffer.
-           *
-           * First calculate the source and destination of the transfer.
-           */
+      /* Then move the data that we are keeping to the beginning
+       * the read buffer.
+       */
 
-          ninval = invend - rwb->rhblockstart;
-          src    = rwb->rhbuffer + ninval * rwb->blocksize;
+      memmove(rhbuf->buffer, src, nkeep * rwb->blocksize);
 
-          /* Calculate the number of blocks we are keeping.  We keep
-           * the ones that we don't invalidate.
-           */
+      /* Update the block info.  The first block is now the one just
+       * after the invalidation region and the number buffered blocks
+       * is the number that we kept.
+       */
 
-          nkeep  = rwb->rhnblocks - ninval;
+      rhbuf->blockstart = invend;
+      rhbuf->nblocks    = nkeep;
+    }
+}
+#endif
 
-          /* Then move the data that we are keeping to the beginning
-           * the read buffer.
-           */
+/****************************************************************************
+ * Name: rwb_invalidate_readahead
+ *
+ * Description:
+ *   Invalidate a region of the read-ahead buffers
+ *
+ ****************************************************************************/
 
-          memmove(rwb->rhbuffer, src, nkeep * rwb->blocksize);
+#if defined(CONFIG_DRVR_READAHEAD)  && defined(CONFIG_DRVR_INVALIDATE)
+static int rwb_invalidate_readahead(FAR struct rwbuffer_s *rwb,
+                                    off_t startblock, size_t blockcount)
+{
+  int i;
 
-          /* Update the block info.  The first block is now the one just
-           * after the invalidation region and the number buffered blocks
-           * is the number that we kept.
-           */
+  if (rwb->rhmaxblocks > 0)
+    {
+      finfo("startblock=%d blockcount=%p\n", startblock, blockcount);
 
-          rwb->rhblockstart = invend;
-          rwb->rhnblocks    = nkeep;
+      rwb_semtake(&rwb->rhsem);
+      for (i = 0; i < CONFIG_DRVR_RHENTRIES; i++)
+        {
+          rwb_rhinvalidate(rwb, &rwb->rhbuf[i], startblock, blockcount);
         }
 
       rwb_semgive(&rwb->rhsem);
     }
 
-  return ret;
+  return OK;
 }
 #endif
 
@@ -657,6 +1098,7 @@ int rwb_invalidate_readahead(FAR struct rwbuffer_s *rwb,
 int rwb_initialize(FAR struct rwbuffer_s *rwb)
 {
   uint32_t allocsize;
+  int i;
 
   /* Sanity checking */
 
@@ -669,7 +1111,10 @@ int rwb_initialize(FAR struct rwbuffer_s *rwb)
 
 #ifdef CONFIG_DRVR_WRITEBUFFER
   DEBUGASSERT(rwb->wrflush != NULL);
-  rwb->wrbuffer = NULL;
+  for (i = 0; i < RWB_NWRBUFFERS; i++)
+    {
+      rwb->wrbuf[i].buffer = NULL;
+    }
 #endif
 #ifdef CONFIG_DRVR_READAHEAD
   DEBUGASSERT(rwb->rhreload != NULL);
@@ -681,29 +1126,33 @@ int rwb_initialize(FAR struct rwbuffer_s *rwb)
     {
       finfo("Initialize the write buffer\n");
 
-      /* Initialize the write buffer access semaphore */
+      /* Initialize the write buffer access semaphores.  wrflushsem may be
+       * released by the worker thread, so it must not use priority
+       * inheritance.
+       */
 
       nxsem_init(&rwb->wrsem, 0, 1);
+      nxsem_init(&rwb->wrflushsem, 0, 1);
+      nxsem_setprotocol(&rwb->wrflushsem, SEM_PRIO_NONE);
 
-      /* Initialize write buffer parameters */
-
-      rwb_resetwrbuffer(rwb);
+      /* Initialize and allocate the write buffers */
 
-      /* Allocate the write buffer */
+      rwb->wrcur = 0;
+      allocsize  = rwb->wrmaxblocks * rwb->blocksize;
 
-      rwb->wrbuffer = NULL;
-      if (rwb->wrmaxblocks > 0)
+      for (i = 0; i < RWB_NWRBUFFERS; i++)
         {
-          allocsize     = rwb->wrmaxblocks * rwb->blocksize;
-          rwb->wrbuffer = kmm_malloc(allocsize);
-          if (!rwb->wrbuffer)
+          rwb_resetwrbuffer(&rwb->wrbuf[i]);
+
+          rwb->wrbuf[i].buffer = kmm_malloc(allocsize);
+          if (!rwb->wrbuf[i].buffer)
             {
               ferr("Write buffer kmm_malloc(%d) failed\n", allocsize);
               return -ENOMEM;
             }
         }
 
-      finfo("Write buffer size: %d bytes\n", allocsize);
+      finfo("Write buffer size: %d bytes x %d\n", allocsize, RWB_NWRBUFFERS);
     }
 #endif /* CONFIG_DRVR_WRITEBUFFER */
 
@@ -720,21 +1169,24 @@ int rwb_initialize(FAR struct rwbuffer_s *rwb)
 
       rwb_resetrhbuffer(rwb);
 
-      /* Allocate the read-ahead buffer */
+      /* Allocate the read-ahead buffers */
 
-      rwb->rhbuffer = NULL;
-      if (rwb->rhmaxblocks > 0)
+      allocsize     = rwb->rhmaxblocks * rwb->blocksize;
+      rwb->rhbuffer = kmm_malloc(allocsize * CONFIG_DRVR_RHENTRIES);
+      if (!rwb->rhbuffer)
         {
-          allocsize     = rwb->rhmaxblocks * rwb->blocksize;
-          rwb->rhbuffer = kmm_malloc(allocsize);
-          if (!rwb->rhbuffer)
-            {
-              ferr("Read-ahead buffer kmm_malloc(%d) failed\n", allocsize);
-              return -ENOMEM;
-            }
+          ferr("Read-ahead buffer kmm_malloc(%d) failed\n",
+               allocsize * CONFIG_DRVR_RHENTRIES);
+          return -ENOMEM;
         }
 
-      finfo("Read-ahead buffer size: %d bytes\n", allocsize);
+      for (i = 0; i < CONFIG_DRVR_RHENTRIES; i++)
+        {
+          rwb->rhbuf[i].buffer = rwb->rhbuffer + i * allocsize;
+        }
+
+      finfo("Read-ahead buffer size: %d bytes x %d\n",
+            allocsize, CONFIG_DRVR_RHENTRIES);
     }
 #endif /* CONFIG_DRVR_READAHEAD */
 
@@ -748,13 +1200,24 @@ int rwb_initialize(FAR struct rwbuffer_s *rwb)
 void rwb_uninitialize(FAR struct rwbuffer_s *rwb)
 {
 #ifdef CONFIG_DRVR_WRITEBUFFER
+  int i;
+
   if (rwb->wrmaxblocks > 0)
     {
+      /* Wait for any buffer that is being drained */
+
       rwb_wrcanceltimeout(rwb);
+      rwb_semtake(&rwb->wrflushsem);
+
       nxsem_destroy(&rwb->wrsem);
-      if (rwb->wrbuffer)
+      nxsem_destroy(&rwb->wrflushsem);
+
+      for (i = 0; i < RWB_NWRBUFFERS; i++)
         {
-          kmm_free(rwb->wrbuffer);
+          if (rwb->wrbuf[i].buffer)
+            {
+              kmm_free(rwb->wrbuf[i].buffer);
+            }
         }
     }
 #endif
@@ -783,43 +1246,35 @@ static ssize_t rwb_read_(FAR struct rwbuffer_s *rwb, off_t startblock,
 #ifdef CONFIG_DRVR_READAHEAD
   if (rwb->rhmaxblocks > 0)
     {
+      FAR struct rwb_rhbuffer_s *rhbuf;
       size_t remaining;
+      size_t rdblocks;
+      int i;
 
       /* Loop until we have read all of the requested blocks */
 
       rwb_semtake(&rwb->rhsem);
       for (remaining = nblocks; remaining > 0; )
         {
-          /* Is there anything in the read-ahead buffer? */
+          /* Is the block in one of the read-ahead buffers? */
 
-          if (rwb->rhnblocks > 0)
+          rhbuf = NULL;
+          for (i = 0; i < CONFIG_DRVR_RHENTRIES; i++)
             {
-              off_t  bufferend;
-
-              /* How many blocks are available in this buffer? */
-
-              bufferend = rwb->rhblockstart + rwb->rhnblocks;
-              if (startblock >= rwb->rhblockstart && startblock < bufferend)
+              if (rwb->rhbuf[i].nblocks > 0 &&
+                  startblock >= rwb->rhbuf[i].blockstart &&
+                  startblock < rwb->rhbuf[i].blockstart +
+                               rwb->rhbuf[i].nblocks)
                 {
-                  size_t rdblocks = bufferend - startblock;
-                  if (rdblocks > remaining)
-                    {
-                      rdblocks = remaining;
-                    }
-
-                  /* Then read the data from the read-ahead buffer */
-
-                  rwb_bufferread(rwb, startblock, rdblocks, &rdbuffer);
-                  startblock += rdblocks;
-                  remaining  -= rdblocks;
+                  rwb_rhtouch(rwb, i);
+                  rhbuf = &rwb->rhbuf[0];
+                  break;
                 }
             }
 
-          /* If we did not get all of the data from the buffer, then we have
-           * to refill the buffer and try again.
-           */
+          /* If not, we have to refill the least recently used buffer */
 
-          if (remaining > 0)
+          if (rhbuf == NULL)
             {
               ret = rwb_rhreload(rwb, startblock);
               if (ret < 0)
@@ -828,7 +1283,23 @@ static ssize_t rwb_read_(FAR struct rwbuffer_s *rwb, off_t startblock,
                   rwb_semgive(&rwb->rhsem);
                   return (ssize_t)ret;
                 }
+
+              rhbuf = &rwb->rhbuf[0];
+            }
+
+          /* How many blocks are available in this buffer? */
+
+          rdblocks = rhbuf->blockstart + rhbuf->nblocks - startblock;
+          if (rdblocks > remaining)
+            {
+              rdblocks = remaining;
             }
+
+          /* Then read the data from the read-ahead buffer */
+
+          rwb_bufferread(rwb, rhbuf, startblock, rdblocks, &rdbuffer);
+          startblock += rdblocks;
+          remaining  -= rdblocks;
         }
 
       /* On success, return the number of blocks that we were requested to
@@ -866,53 +1337,66 @@ ssize_t rwb_read(FAR struct rwbuffer_s *rwb, off_t startblock,
         (long)startblock, (long)nblocks, rdbuffer);
 
 #ifdef CONFIG_DRVR_WRITEBUFFER
-  /* If the new read data overlaps any part of the write buffer, we
+  /* If the new read data overlaps any part of the write buffers, we
    * directly copy write buffer to read buffer. This boost performance.
    */
 
   if (rwb->wrmaxblocks > 0)
     {
-      /* If the write buffer overlaps the block(s) requested */
+      FAR uint8_t *src;
+      size_t count;
+      int i;
 
       rwb_semtake(&rwb->wrsem);
-      if (rwb_overlap(rwb->wrblockstart, rwb->wrnblocks, startblock, nblocks))
+      while (nblocks > 0)
         {
-          size_t rdblocks = 0;
-          size_t wrnpass  = 0;
+          /* The buffer being filled holds the newest data, then the buffer
+           * being drained, if any, then the media.
+           */
+
+          count = nblocks;
+          src   = NULL;
+
+          for (i = 0; i < RWB_NWRBUFFERS && src == NULL; i++)
+            {
+              src = rwb_wrlookup(rwb,
+                                 &rwb->wrbuf[(rwb->wrcur + i) %
+                                             RWB_NWRBUFFERS],
+                                 startblock, &count);
+            }
 
-          if (rwb->wrblockstart > startblock)
+          if (src != NULL)
+            {
+              memcpy(rdbuffer, src, count * rwb->blocksize);
+            }
+          else if (count == nblocks)
+            {
+              /* Nothing more in the write buffers */
+
+              break;
+            }
+          else
             {
-              rdblocks = rwb->wrblockstart - startblock;
-              ret = rwb_read_(rwb, startblock, rdblocks, rdbuffer);
+              ret = rwb_read_(rwb, startblock, count, rdbuffer);
               if (ret < 0)
                 {
                   rwb_semgive(&rwb->wrsem);
                   return (ssize_t)ret;
                 }
-
-              startblock += ret;
-              nblocks    -= ret;
-              rdbuffer   += ret * rwb->blocksize;
-              readblocks += ret;
-            }
-
-          if (rwb->wrblockstart < startblock)
-            {
-              wrnpass = startblock - rwb->wrblockstart;
             }
 
-          rdblocks = nblocks > (rwb->wrnblocks - wrnpass) ?
-                    (rwb->wrnblocks - wrnpass) : nblocks;
-          memcpy(rdbuffer, &rwb->wrbuffer[wrnpass * rwb->blocksize],
-                rdblocks * rwb->blocksize);
-
-          startblock += rdblocks;
-          nblocks    -= rdblocks;
-          rdbuffer   += rdblocks * rwb->blocksize;
-          readblocks += rdblocks;
+          startblock += count;
+          nblocks    -= count;
+          rdbuffer   += count * rwb->blocksize;
+          readblocks += count;
         }
 
       rwb_semgive(&rwb->wrsem);
+
+      if (nblocks == 0)
+        {
+          return readblocks;
+        }
     }
 #endif
 
@@ -937,28 +1421,32 @@ ssize_t rwb_write(FAR struct rwbuffer_s *rwb, off_t startblock,
 #ifdef CONFIG_DRVR_READAHEAD
   if (rwb->rhmaxblocks > 0)
     {
-      /* If the new write data overlaps any part of the read buffer, then
+      FAR struct rwb_rhbuffer_s *rhbuf;
+      int i;
+
+      /* If the new write data overlaps any part of a read buffer, then
        * flush the data from the read buffer.  We could attempt some more
        * exotic handling -- but this simple logic is well-suited for simple
        * streaming applications.
        */
 
       rwb_semtake(&rwb->rhsem);
-      if (rwb_overlap(rwb->rhblockstart, rwb->rhnblocks, startblock, nblocks))
+      for (i = 0; i < CONFIG_DRVR_RHENTRIES; i++)
         {
+          rhbuf = &rwb->rhbuf[i];
+          if (rhbuf->nblocks > 0 &&
+              rwb_overlap(rhbuf->blockstart, rhbuf->nblocks,
+                          startblock, nblocks))
+            {
 #ifdef CONFIG_DRVR_INVALIDATE
-          /* Just invalidate the read buffer startblock + nblocks data */
+              /* Just invalidate the read buffer startblock + nblocks data */
 
-          ret = rwb_invalidate_readahead(rwb, startblock, nblocks);
-          if (ret < 0)
-            {
-              ferr("ERROR: rwb_invalidate_readahead failed: %d\n", ret);
-              rwb_semgive(&rwb->rhsem);
-              return (ssize_t)ret;
-            }
+              rwb_rhinvalidate(rwb, rhbuf, startblock, nblocks);
 #else
-          rwb_resetrhbuffer(rwb);
+              rhbuf->nblocks    = 0;
+              rhbuf->blockstart = (off_t)-1;
 #endif
+            }
         }
 
       rwb_semgive(&rwb->rhsem);
@@ -1052,10 +1540,19 @@ ssize_t rwb_readbytes(FAR struct rwbuffer_s *dev, off_t offset,
 int rwb_mediaremoved(FAR struct rwbuffer_s *rwb)
 {
 #ifdef CONFIG_DRVR_WRITEBUFFER
+  int i;
+
   if (rwb->wrmaxblocks > 0)
     {
       rwb_semtake(&rwb->wrsem);
-      rwb_resetwrbuffer(rwb);
+      rwb_semtake(&rwb->wrflushsem);
+
+      for (i = 0; i < RWB_NWRBUFFERS; i++)
+        {
+          rwb_resetwrbuffer(&rwb->wrbuf[i]);
+        }
+
+      rwb_semgive(&rwb->wrflushsem);
       rwb_semgive(&rwb->wrsem);
     }
 #endif
@@ -1120,14 +1617,15 @@ int rwb_invalidate(FAR struct rwbuffer_s *rwb,
 #ifdef CONFIG_DRVR_WRITEBUFFER
 int rwb_flush(FAR struct rwbuffer_s *rwb)
 {
+  int ret;
+
   rwb_semtake(&rwb->wrsem);
   rwb_wrcanceltimeout(rwb);
-  rwb_wrflush(rwb);
+  ret = rwb_wrflush(rwb);
   rwb_semgive(&rwb->wrsem);
 
-  return OK;
+  return ret;
 }
 #endif
 
 #endif /* CONFIG_DRVR_WRITEBUFFER || CONFIG_DRVR_READAHEAD */
-
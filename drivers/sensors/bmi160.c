@@ -49,6 +49,11 @@
 #include <nuttx/spi/spi.h>
 #include <nuttx/i2c/i2c_master.h>
 #include <nuttx/sensors/bmi160.h>
+#ifdef CONFIG_SENSORS_BMI160_UPPER
+#  include <nuttx/semaphore.h>
+#  include <nuttx/wqueue.h>
+#  include <nuttx/sensors/sensor.h>
+#endif
 
 #if defined(CONFIG_SENSORS_BMI160)
 
@@ -207,6 +212,11 @@
 #define GYRO_ODR_1600HZ       (0x0C)
 #define GYRO_ODR_3200HZ       (0x0D)
 
+/* Register 0x47 - FIFO_CONFIG_1 */
+
+#define FIFO_GYR_EN           (1 << 7)
+#define FIFO_ACC_EN           (1 << 6)
+
 /* Register 0x7b STEP_CONFIG_1 */
 
 #define STEP_CNT_EN           (1 << 3)
@@ -222,11 +232,53 @@
 #define MAG_PM_SUSPEND        (0x18)
 #define MAG_PM_NORMAL         (0x19)
 #define MAG_PM_LOWPOWER       (0x1A)
+#define FIFO_FLUSH            (0xB0)
+
+#ifdef CONFIG_SENSORS_BMI160_UPPER
+
+/* FIFO of headerless frames: gyro X/Y/Z then accel X/Y/Z, 16 bits each */
+
+#define BMI160_FIFO_SIZE      1024
+#define BMI160_FRAME_SIZE     12
+#define BMI160_FIFO_FRAMES    (BMI160_FIFO_SIZE / BMI160_FRAME_SIZE)
+
+/* Leave some room so that the FIFO never overflows between drains */
+
+#define BMI160_BATCH_FRAMES   (BMI160_FIFO_FRAMES - 5)
+
+/* Samples converted per push_event() call */
+
+#define BMI160_PUSH_CHUNK     8
+
+/* Scale of the default ranges: +-2g and +-2000 dps */
+
+#define BMI160_ACCEL_SCALE    (9.80665f / 16384.0f)         /* m/s^2 per LSB */
+#define BMI160_GYRO_SCALE     (3.14159265f / 180.0f / 16.4f) /* rad/s per LSB */
+
+#ifdef CONFIG_SCHED_LPWORK
+#  define BMI160_WORK         LPWORK
+#else
+#  define BMI160_WORK         HPWORK
+#endif
+#endif
 
 /****************************************************************************
  * Private Types
  ****************************************************************************/
 
+#ifdef CONFIG_SENSORS_BMI160_UPPER
+struct bmi160_dev_s;
+
+/* One of the two sensors as seen by the sensor upper half */
+
+struct bmi160_sensor_s
+{
+  struct sensor_lowerhalf_s lower; /* Must be first */
+  FAR struct bmi160_dev_s *dev;
+  bool enabled;
+};
+#endif
+
 struct bmi160_dev_s
 {
 #ifdef CONFIG_SENSORS_BMI160_I2C
@@ -238,6 +290,17 @@ struct bmi160_dev_s
   FAR struct spi_dev_s *spi;    /* SPI interface */
 
 #endif
+
+#ifdef CONFIG_SENSORS_BMI160_UPPER
+  struct bmi160_sensor_s accel; /* Accelerometer lower half */
+  struct bmi160_sensor_s gyro;  /* Gyroscope lower half */
+  sem_t exclsem;                /* Serializes configuration and draining */
+  struct work_s work;           /* Drains the FIFO */
+  unsigned long interval;       /* Sampling period in microseconds */
+  unsigned long latency;        /* Batch latency in microseconds */
+  uint8_t odr;                  /* ACCEL/GYRO_ODR_* shared by both */
+  uint8_t fifo[BMI160_FIFO_SIZE];
+#endif
 };
 
 /****************************************************************************
@@ -263,6 +326,19 @@ static int     bmi160_ioctl(FAR struct file *filep, int cmd,
                             unsigned long arg);
 
 static int bmi160_checkid(FAR struct bmi160_dev_s *priv);
+static int bmi160_probe(FAR struct bmi160_dev_s *priv);
+
+#ifdef CONFIG_SENSORS_BMI160_UPPER
+/* Sensor upper half methods */
+
+static int bmi160_sensor_activate(FAR struct sensor_lowerhalf_s *lower,
+                                  bool enable);
+static int bmi160_sensor_set_interval(FAR struct sensor_lowerhalf_s *lower,
+                                      FAR unsigned long *period_us);
+static int bmi160_sensor_batch(FAR struct sensor_lowerhalf_s *lower,
+                               FAR unsigned long *latency_us);
+static int bmi160_sensor_flush(FAR struct sensor_lowerhalf_s *lower);
+#endif
 
 /****************************************************************************
  * Private Data
@@ -280,6 +356,17 @@ static const struct file_operations g_bmi160fops =
   bmi160_ioctl,    /* ioctl */
 };
 
+#ifdef CONFIG_SENSORS_BMI160_UPPER
+static const struct sensor_ops_s g_bmi160_sensor_ops =
+{
+  bmi160_sensor_activate,     /* activate */
+  bmi160_sensor_set_interval, /* set_interval */
+  bmi160_sensor_batch,        /* batch */
+  bmi160_sensor_flush,        /* flush */
+  NULL,                       /* control */
+};
+#endif
+
 /****************************************************************************
  * Name: bmi160_configspi
  *
@@ -697,6 +784,276 @@ static int bmi160_ioctl(FAR struct file *filep, int cmd, unsigned long arg)
   return ret;
 }
 
+#ifdef CONFIG_SENSORS_BMI160_UPPER
+
+/****************************************************************************
+ * Name: bmi160_sensor_drain
+ *
+ * Description:
+ *   Read every complete frame waiting in the FIFO with one burst and push
+ *   the samples to the upper halves.  The frames were taken 'interval'
+ *   apart, the newest one just now.  Called with exclsem held.
+ *
+ ****************************************************************************/
+
+static void bmi160_sensor_drain(FAR struct bmi160_dev_s *priv)
+{
+  struct sensor_event_accel accel[BMI160_PUSH_CHUNK];
+  struct sensor_event_gyro gyro[BMI160_PUSH_CHUNK];
+  FAR const int16_t *frame;
+  uint64_t now;
+  float temp;
+  int fsize;
+  int nframes;
+  int n;
+  int i;
+
+  fsize = (priv->accel.enabled + priv->gyro.enabled) * 6;
+  if (fsize == 0)
+    {
+      return;
+    }
+
+  nframes = (bmi160_getreg16(priv, BMI160_FIFO_LENGTH_0) & 0x7ff) / fsize;
+  if (nframes == 0)
+    {
+      return;
+    }
+
+  bmi160_getregs(priv, BMI160_FIFO_DATA, priv->fifo, nframes * fsize);
+
+  now  = sensor_get_timestamp();
+  temp = 23.0f +
+         (int16_t)bmi160_getreg16(priv, BMI160_TEMPERATURE_0) / 512.0f;
+
+  for (i = 0, n = 0; i < nframes; i++)
+    {
+      frame = (FAR const int16_t *)&priv->fifo[i * fsize];
+
+      if (priv->gyro.enabled)
+        {
+          gyro[n].timestamp   = now - (uint64_t)(nframes - 1 - i) *
+                                priv->interval;
+          gyro[n].x           = frame[0] * BMI160_GYRO_SCALE;
+          gyro[n].y           = frame[1] * BMI160_GYRO_SCALE;
+          gyro[n].z           = frame[2] * BMI160_GYRO_SCALE;
+          gyro[n].temperature = temp;
+          frame += 3;
+        }
+
+      if (priv->accel.enabled)
+        {
+          accel[n].timestamp   = now - (uint64_t)(nframes - 1 - i) *
+                                 priv->interval;
+          accel[n].x           = frame[0] * BMI160_ACCEL_SCALE;
+          accel[n].y           = frame[1] * BMI160_ACCEL_SCALE;
+          accel[n].z           = frame[2] * BMI160_ACCEL_SCALE;
+          accel[n].temperature = temp;
+        }
+
+      if (++n == BMI160_PUSH_CHUNK || i + 1 == nframes)
+        {
+          if (priv->gyro.enabled)
+            {
+              priv->gyro.lower.push_event(priv->gyro.lower.priv, gyro,
+                                          n * sizeof(gyro[0]));
+            }
+
+          if (priv->accel.enabled)
+            {
+              priv->accel.lower.push_event(priv->accel.lower.priv, accel,
+                                           n * sizeof(accel[0]));
+            }
+
+          n = 0;
+        }
+    }
+}
+
+/****************************************************************************
+ * Name: bmi160_sensor_worker
+ *
+ * Description:
+ *   Drain the FIFO once per batch latency (or per sample if there is no
+ *   latency).
+ *
+ ****************************************************************************/
+
+static void bmi160_sensor_worker(FAR void *arg)
+{
+  FAR struct bmi160_dev_s *priv = arg;
+  unsigned long period;
+
+  nxsem_wait_uninterruptible(&priv->exclsem);
+
+  bmi160_sensor_drain(priv);
+
+  if (priv->accel.enabled || priv->gyro.enabled)
+    {
+      period = priv->latency > priv->interval ? priv->latency :
+                                                priv->interval;
+      work_queue(BMI160_WORK, &priv->work, bmi160_sensor_worker, priv,
+                 USEC2TICK(period) > 0 ? USEC2TICK(period) : 1);
+    }
+
+  nxsem_post(&priv->exclsem);
+}
+
+/****************************************************************************
+ * Name: bmi160_sensor_config
+ *
+ * Description:
+ *   Apply the rate and the set of enabled sensors to the FIFO, discard
+ *   what it holds and restart the drain job.  Called with exclsem held.
+ *
+ ****************************************************************************/
+
+static void bmi160_sensor_config(FAR struct bmi160_dev_s *priv)
+{
+  uint8_t fifocfg = 0;
+
+  work_cancel(BMI160_WORK, &priv->work);
+
+  bmi160_putreg8(priv, BMI160_ACCEL_CONFIG, ACCEL_NORMAL_AVG4 | priv->odr);
+  bmi160_putreg8(priv, BMI160_GYRO_CONFIG, GYRO_NORMAL_MODE | priv->odr);
+
+  if (priv->gyro.enabled)
+    {
+      fifocfg |= FIFO_GYR_EN;
+    }
+
+  if (priv->accel.enabled)
+    {
+      fifocfg |= FIFO_ACC_EN;
+    }
+
+  bmi160_putreg8(priv, BMI160_FIFO_CONFIG_1, fifocfg);
+  bmi160_putreg8(priv, BMI160_CMD, FIFO_FLUSH);
+
+  if (fifocfg != 0)
+    {
+      work_queue(BMI160_WORK, &priv->work, bmi160_sensor_worker, priv,
+                 USEC2TICK(priv->interval) > 0 ?
+                 USEC2TICK(priv->interval) : 1);
+    }
+}
+
+/****************************************************************************
+ * Name: bmi160_sensor_activate
+ ****************************************************************************/
+
+static int bmi160_sensor_activate(FAR struct sensor_lowerhalf_s *lower,
+                                  bool enable)
+{
+  FAR struct bmi160_sensor_s *sensor = (FAR struct bmi160_sensor_s *)lower;
+  FAR struct bmi160_dev_s *priv = sensor->dev;
+  bool isaccel = sensor == &priv->accel;
+
+  nxsem_wait_uninterruptible(&priv->exclsem);
+
+  if (sensor->enabled != enable)
+    {
+      if (isaccel)
+        {
+          bmi160_putreg8(priv, BMI160_CMD,
+                         enable ? ACCEL_PM_NORMAL : ACCEL_PM_SUSPEND);
+        }
+      else
+        {
+          bmi160_putreg8(priv, BMI160_CMD,
+                         enable ? GYRO_PM_NORMAL : GYRO_PM_SUSPEND);
+        }
+
+      up_mdelay(30);
+
+      sensor->enabled = enable;
+      bmi160_sensor_config(priv);
+    }
+
+  nxsem_post(&priv->exclsem);
+  return OK;
+}
+
+/****************************************************************************
+ * Name: bmi160_sensor_set_interval
+ *
+ * Description:
+ *   Select the slowest rate from 25 Hz to 1600 Hz that is at least as fast
+ *   as asked.  Both sensors share it, since FIFO frames hold one sample of
+ *   each.
+ *
+ ****************************************************************************/
+
+static int bmi160_sensor_set_interval(FAR struct sensor_lowerhalf_s *lower,
+                                      FAR unsigned long *period_us)
+{
+  FAR struct bmi160_sensor_s *sensor = (FAR struct bmi160_sensor_s *)lower;
+  FAR struct bmi160_dev_s *priv = sensor->dev;
+  unsigned long interval = 40000;  /* 25 Hz */
+  uint8_t odr = ACCEL_ODR_25HZ;
+
+  while (odr < ACCEL_ODR_1600HZ && interval > *period_us)
+    {
+      odr++;
+      interval >>= 1;
+    }
+
+  *period_us = interval;
+
+  nxsem_wait_uninterruptible(&priv->exclsem);
+  if (priv->odr != odr)
+    {
+      priv->odr      = odr;
+      priv->interval = interval;
+      bmi160_sensor_config(priv);
+    }
+
+  nxsem_post(&priv->exclsem);
+  return OK;
+}
+
+/****************************************************************************
+ * Name: bmi160_sensor_batch
+ ****************************************************************************/
+
+static int bmi160_sensor_batch(FAR struct sensor_lowerhalf_s *lower,
+                               FAR unsigned long *latency_us)
+{
+  FAR struct bmi160_sensor_s *sensor = (FAR struct bmi160_sensor_s *)lower;
+  FAR struct bmi160_dev_s *priv = sensor->dev;
+  unsigned long max;
+
+  nxsem_wait_uninterruptible(&priv->exclsem);
+
+  max = priv->interval * BMI160_BATCH_FRAMES;
+  if (*latency_us > max)
+    {
+      *latency_us = max;
+    }
+
+  priv->latency = *latency_us;
+
+  nxsem_post(&priv->exclsem);
+  return OK;
+}
+
+/****************************************************************************
+ * Name: bmi160_sensor_flush
+ ****************************************************************************/
+
+static int bmi160_sensor_flush(FAR struct sensor_lowerhalf_s *lower)
+{
+  FAR struct bmi160_sensor_s *sensor = (FAR struct bmi160_sensor_s *)lower;
+  FAR struct bmi160_dev_s *priv = sensor->dev;
+
+  nxsem_wait_uninterruptible(&priv->exclsem);
+  bmi160_sensor_drain(priv);
+  nxsem_post(&priv->exclsem);
+  return OK;
+}
+
+#endif /* CONFIG_SENSORS_BMI160_UPPER */
+
 /****************************************************************************
  * Name: bmi160_checkid
  *
@@ -724,6 +1081,44 @@ static int bmi160_checkid(FAR struct bmi160_dev_s *priv)
   return OK;
 }
 
+/****************************************************************************
+ * Name: bmi160_probe
+ *
+ * Description:
+ *   Wake up the bus interface set in 'priv', check the chip ID and put the
+ *   gyroscope in a known state.
+ *
+ ****************************************************************************/
+
+static int bmi160_probe(FAR struct bmi160_dev_s *priv)
+{
+  int ret;
+
+#ifdef CONFIG_SENSORS_BMI160_SPI
+  /* BMI160 detects communication bus is SPI by rising edge of CS. */
+
+  bmi160_getreg8(priv, 0x7f);
+  bmi160_getreg8(priv, 0x7f); /* workaround: fail to switch SPI, run twice */
+  up_udelay(200);
+#endif
+
+  ret = bmi160_checkid(priv);
+  if (ret < 0)
+    {
+      snerr("Wrong Device ID!\n");
+      return ret;
+    }
+
+  /* To avoid gyro wakeup it is required to write 0x00 to 0x6C */
+
+  bmi160_putreg8(priv, BMI160_PMU_TRIGGER, 0);
+  return OK;
+}
+
+/****************************************************************************
+ * Public Functions
+ ****************************************************************************/
+
 /****************************************************************************
  * Name: bmi160_register
  *
@@ -763,26 +1158,15 @@ int bmi160_register(FAR const char *devpath, FAR struct spi_dev_s *dev)
 #else /* CONFIG_SENSORS_BMI160_SPI */
   priv->spi = dev;
 
-  /* BMI160 detects communication bus is SPI by rising edge of CS. */
-
-  bmi160_getreg8(priv, 0x7f);
-  bmi160_getreg8(priv, 0x7f); /* workaround: fail to switch SPI, run twice */
-  up_udelay(200);
-
 #endif
 
-  ret = bmi160_checkid(priv);
+  ret = bmi160_probe(priv);
   if (ret < 0)
     {
-      snerr("Wrong Device ID!\n");
       kmm_free(priv);
       return ret;
     }
 
-  /* To avoid gyro wakeup it is required to write 0x00 to 0x6C */
-
-  bmi160_putreg8(priv, BMI160_PMU_TRIGGER, 0);
-
   ret = register_driver(devpath, &g_bmi160fops, 0666, priv);
   if (ret < 0)
     {
@@ -794,4 +1178,90 @@ int bmi160_register(FAR const char *devpath, FAR struct spi_dev_s *dev)
   return OK;
 }
 
+/****************************************************************************
+ * Name: bmi160_register_sensor
+ *
+ * Description:
+ *   Register the BMI160 with the common sensor upper half as
+ *   /dev/sensor/accel<devno> and /dev/sensor/gyro<devno>.
+ *
+ * Input Parameters:
+ *   devno - The number appended to the device names
+ *   dev   - An instance of the SPI or I2C interface to use to communicate
+ *           with BMI160
+ *
+ * Returned Value:
+ *   Zero (OK) on success; a negated errno value on failure.
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_SENSORS_BMI160_UPPER
+#ifdef CONFIG_SENSORS_BMI160_I2C
+int bmi160_register_sensor(int devno, FAR struct i2c_master_s *dev)
+#else /* CONFIG_SENSORS_BMI160_SPI */
+int bmi160_register_sensor(int devno, FAR struct spi_dev_s *dev)
+#endif
+{
+  FAR struct bmi160_dev_s *priv;
+  int ret;
+
+  priv = (FAR struct bmi160_dev_s *)kmm_zalloc(sizeof(struct bmi160_dev_s));
+  if (!priv)
+    {
+      snerr("Failed to allocate instance\n");
+      return -ENOMEM;
+    }
+
+#ifdef CONFIG_SENSORS_BMI160_I2C
+  priv->i2c = dev;
+  priv->addr = BMI160_I2C_ADDR;
+  priv->freq = BMI160_I2C_FREQ;
+#else /* CONFIG_SENSORS_BMI160_SPI */
+  priv->spi = dev;
+#endif
+
+  ret = bmi160_probe(priv);
+  if (ret < 0)
+    {
+      kmm_free(priv);
+      return ret;
+    }
+
+  nxsem_init(&priv->exclsem, 0, 1);
+  priv->odr      = ACCEL_ODR_100HZ;
+  priv->interval = 10000;
+
+  priv->accel.dev                = priv;
+  priv->accel.lower.type         = SENSOR_TYPE_ACCELEROMETER;
+  priv->accel.lower.batch_number = BMI160_BATCH_FRAMES;
+  priv->accel.lower.ops          = &g_bmi160_sensor_ops;
+
+  priv->gyro.dev                 = priv;
+  priv->gyro.lower.type          = SENSOR_TYPE_GYROSCOPE;
+  priv->gyro.lower.batch_number  = BMI160_BATCH_FRAMES;
+  priv->gyro.lower.ops           = &g_bmi160_sensor_ops;
+
+  ret = sensor_register(&priv->accel.lower, devno);
+  if (ret < 0)
+    {
+      goto errout;
+    }
+
+  ret = sensor_register(&priv->gyro.lower, devno);
+  if (ret < 0)
+    {
+      sensor_unregister(&priv->accel.lower, devno);
+      goto errout;
+    }
+
+  return OK;
+
+errout:
+  snerr("Failed to register sensors: %d\n", ret);
+  nxsem_destroy(&priv->exclsem);
+  kmm_free(priv);
+  return ret;
+}
+#endif /* CONFIG_SENSORS_BMI160_UPPER */
+
 #endif /* CONFIG_SENSORS_BMI160 */
@@ -0,0 +1,747 @@
+/****************************************************************************
+ * drivers/sensors/sensor.c
+ *
+ *   Copyright (C) 2020 Gregory Nutt. All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in
+ *    the documentation and/or other materials provided with the
+ *    distribution.
+ * 3. Neither the name NuttX nor the names of its contributors may be
+ *    used to endorse or promote products derived from this software
+ *    without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+ * FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE
+ * COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+ * INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,
+ * BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS
+ * OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED
+ * AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ * LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN
+ * ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ *
+ ****************************************************************************/
+
+/****************************************************************************
+ * Included Files
+ ****************************************************************************/
+
+#include <nuttx/config.h>
+
+#include <sys/types.h>
+#include <stdbool.h>
+#include <stdio.h>
+#include <string.h>
+#include <fcntl.h>
+#include <poll.h>
+#include <errno.h>
+#include <assert.h>
+#include <debug.h>
+
+#include <nuttx/irq.h>
+#include <nuttx/fs/fs.h>
+#include <nuttx/kmalloc.h>
+#include <nuttx/semaphore.h>
+#include <nuttx/sensors/sensor.h>
+
+#ifdef CONFIG_SENSORS_UPPER
+
+/****************************************************************************
+ * Pre-processor Definitions
+ ****************************************************************************/
+
+#define DEVNAME_FMT    "/dev/sensor/%s%d"
+#define DEVNAME_MAX    32
+
+/****************************************************************************
+ * Private Types
+ ****************************************************************************/
+
+/* Name and sample size of each sensor type */
+
+struct sensor_meta_s
+{
+  FAR const char *name;
+  size_t          esize;
+};
+
+/* The upper half state of one sensor */
+
+struct sensor_upperhalf_s
+{
+  FAR struct sensor_lowerhalf_s *lower; /* The lower half */
+  sem_t          exclsem;      /* Serializes file operations */
+  sem_t          readsem;      /* Readers wait here for samples */
+  uint8_t        crefs;        /* Number of opens */
+  uint8_t        nwaiters;     /* Readers waiting on readsem */
+  bool           enabled;      /* The lower half is sampling */
+  size_t         esize;        /* Size of one sample */
+  unsigned long  interval;     /* Sampling period in microseconds */
+  unsigned long  latency;      /* Batch latency in microseconds */
+  unsigned long  watermark;    /* Samples that wake up a reader */
+  unsigned long  lost;         /* Samples overwritten before being read */
+
+  /* The ring buffer of samples, protected by a critical section since
+   * samples may be pushed from interrupt handlers.
+   */
+
+  FAR uint8_t   *buffer;
+  unsigned long  nbuffer;      /* Capacity in samples */
+  unsigned long  head;         /* Index of the oldest sample */
+  unsigned long  count;        /* Number of samples held */
+
+  FAR struct pollfd *fds[CONFIG_SENSORS_NPOLLWAITERS];
+};
+
+/****************************************************************************
+ * Private Function Prototypes
+ ****************************************************************************/
+
+static void    sensor_push_event(FAR void *priv, FAR const void *data,
+                                 size_t bytes);
+
+/* Character driver methods */
+
+static int     sensor_open(FAR struct file *filep);
+static int     sensor_close(FAR struct file *filep);
+static ssize_t sensor_read(FAR struct file *filep, FAR char *buffer,
+                           size_t buflen);
+static int     sensor_ioctl(FAR struct file *filep, int cmd,
+                            unsigned long arg);
+static int     sensor_poll(FAR struct file *filep, FAR struct pollfd *fds,
+                           bool setup);
+
+/****************************************************************************
+ * Private Data
+ ****************************************************************************/
+
+static const struct sensor_meta_s g_sensor_meta[SENSOR_TYPE_COUNT] =
+{
+  { NULL,    0 },
+  { "accel", sizeof(struct sensor_event_accel) },
+  { "mag",   sizeof(struct sensor_event_mag) },
+  { "gyro",  sizeof(struct sensor_event_gyro) },
+  { "light", sizeof(struct sensor_event_light) },
+  { "baro",  sizeof(struct sensor_event_baro) },
+  { "prox",  sizeof(struct sensor_event_prox) },
+  { "humi",  sizeof(struct sensor_event_humi) },
+  { "temp",  sizeof(struct sensor_event_temp) },
+};
+
+static const struct file_operations g_sensor_fops =
+{
+  sensor_open,   /* open */
+  sensor_close,  /* close */
+  sensor_read,   /* read */
+  NULL,          /* write */
+  NULL,          /* seek */
+  sensor_ioctl,  /* ioctl */
+  sensor_poll    /* poll */
+#ifndef CONFIG_DISABLE_PSEUDOFS_OPERATIONS
+  , NULL         /* unlink */
+#endif
+};
+
+/****************************************************************************
+ * Private Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: sensor_notify
+ *
+ * Description:
+ *   Wake up readers and pollers once the watermark is reached.  Called
+ *   within a critical section.
+ *
+ ****************************************************************************/
+
+static void sensor_notify(FAR struct sensor_upperhalf_s *upper)
+{
+  int i;
+
+  if (upper->count < upper->watermark)
+    {
+      return;
+    }
+
+  while (upper->nwaiters > 0)
+    {
+      upper->nwaiters--;
+      nxsem_post(&upper->readsem);
+    }
+
+  for (i = 0; i < CONFIG_SENSORS_NPOLLWAITERS; i++)
+    {
+      FAR struct pollfd *fds = upper->fds[i];
+      if (fds != NULL && (fds->events & POLLIN) != 0)
+        {
+          fds->revents |= POLLIN;
+          nxsem_post(fds->sem);
+        }
+    }
+}
+
+/****************************************************************************
+ * Name: sensor_push_event
+ *
+ * Description:
+ *   Append whole samples to the ring buffer, dropping the oldest ones if it
+ *   is full.
+ *
+ ****************************************************************************/
+
+static void sensor_push_event(FAR void *priv, FAR const void *data,
+                              size_t bytes)
+{
+  FAR struct sensor_upperhalf_s *upper = priv;
+  FAR const uint8_t *src = data;
+  unsigned long nevents = bytes / upper->esize;
+  unsigned long tail;
+  irqstate_t flags;
+
+  flags = enter_critical_section();
+
+  if (upper->buffer == NULL)
+    {
+      leave_critical_section(flags);
+      return;
+    }
+
+  /* Only the newest samples fit */
+
+  if (nevents > upper->nbuffer)
+    {
+      upper->lost += nevents - upper->nbuffer;
+      src         += (nevents - upper->nbuffer) * upper->esize;
+      nevents      = upper->nbuffer;
+    }
+
+  while (nevents-- > 0)
+    {
+      if (upper->count == upper->nbuffer)
+        {
+          upper->head = (upper->head + 1) % upper->nbuffer;
+          upper->count--;
+          upper->lost++;
+        }
+
+      tail = (upper->head + upper->count) % upper->nbuffer;
+      memcpy(upper->buffer + tail * upper->esize, src, upper->esize);
+      src += upper->esize;
+      upper->count++;
+    }
+
+  sensor_notify(upper);
+  leave_critical_section(flags);
+}
+
+/****************************************************************************
+ * Name: sensor_resize
+ *
+ * Description:
+ *   Replace the ring buffer with an empty one holding 'nbuffer' samples.
+ *
+ ****************************************************************************/
+
+static int sensor_resize(FAR struct sensor_upperhalf_s *upper,
+                         unsigned long nbuffer)
+{
+  FAR uint8_t *buffer;
+  FAR uint8_t *old;
+  irqstate_t flags;
+
+  if (nbuffer == 0)
+    {
+      return -EINVAL;
+    }
+
+  buffer = kmm_malloc(nbuffer * upper->esize);
+  if (buffer == NULL)
+    {
+      return -ENOMEM;
+    }
+
+  flags          = enter_critical_section();
+  old            = upper->buffer;
+  upper->buffer  = buffer;
+  upper->nbuffer = nbuffer;
+  upper->head    = 0;
+  upper->count   = 0;
+  if (upper->watermark > nbuffer)
+    {
+      upper->watermark = nbuffer;
+    }
+
+  leave_critical_section(flags);
+
+  kmm_free(old);
+  return OK;
+}
+
+/****************************************************************************
+ * Name: sensor_open
+ ****************************************************************************/
+
+static int sensor_open(FAR struct file *filep)
+{
+  FAR struct inode *inode = filep->f_inode;
+  FAR struct sensor_upperhalf_s *upper = inode->i_private;
+  int ret;
+
+  ret = nxsem_wait(&upper->exclsem);
+  if (ret < 0)
+    {
+      return ret;
+    }
+
+  if (upper->crefs == UINT8_MAX)
+    {
+      ret = -EMFILE;
+    }
+  else
+    {
+      upper->crefs++;
+    }
+
+  nxsem_post(&upper->exclsem);
+  return ret;
+}
+
+/****************************************************************************
+ * Name: sensor_close
+ *
+ * Description:
+ *   Stop the sensor when the last user closes it.
+ *
+ ****************************************************************************/
+
+static int sensor_close(FAR struct file *filep)
+{
+  FAR struct inode *inode = filep->f_inode;
+  FAR struct sensor_upperhalf_s *upper = inode->i_private;
+  FAR struct sensor_lowerhalf_s *lower = upper->lower;
+  irqstate_t flags;
+
+  nxsem_wait_uninterruptible(&upper->exclsem);
+
+  if (--upper->crefs == 0 && upper->enabled)
+    {
+      lower->ops->activate(lower, false);
+      upper->enabled = false;
+
+      flags        = enter_critical_section();
+      upper->head  = 0;
+      upper->count = 0;
+      leave_critical_section(flags);
+    }
+
+  nxsem_post(&upper->exclsem);
+  return OK;
+}
+
+/****************************************************************************
+ * Name: sensor_read
+ *
+ * Description:
+ *   Return as many whole samples as fit in the buffer, oldest first.
+ *   Unless O_NONBLOCK is set, wait until at least 'watermark' samples are
+ *   buffered.
+ *
+ ****************************************************************************/
+
+static ssize_t sensor_read(FAR struct file *filep, FAR char *buffer,
+                           size_t buflen)
+{
+  FAR struct inode *inode = filep->f_inode;
+  FAR struct sensor_upperhalf_s *upper = inode->i_private;
+  unsigned long nread = 0;
+  unsigned long want;
+  unsigned long n;
+  irqstate_t flags;
+  int ret;
+
+  want = buflen / upper->esize;
+  if (want == 0)
+    {
+      return -EINVAL;
+    }
+
+  ret = nxsem_wait(&upper->exclsem);
+  if (ret < 0)
+    {
+      return ret;
+    }
+
+  flags = enter_critical_section();
+
+  while (upper->count == 0 ||
+         ((filep->f_oflags & O_NONBLOCK) == 0 &&
+          upper->count < upper->watermark && upper->count < want))
+    {
+      if ((filep->f_oflags & O_NONBLOCK) != 0)
+        {
+          ret = -EAGAIN;
+          goto out;
+        }
+
+      if (!upper->enabled)
+        {
+          ret = -EIO;
+          goto out;
+        }
+
+      /* Wait for the lower half to push enough samples */
+
+      upper->nwaiters++;
+      nxsem_post(&upper->exclsem);
+      ret = nxsem_wait(&upper->readsem);
+      if (ret < 0)
+        {
+          if (upper->nwaiters > 0)
+            {
+              upper->nwaiters--;
+            }
+
+          leave_critical_section(flags);
+          return ret;
+        }
+
+      ret = nxsem_wait(&upper->exclsem);
+      if (ret < 0)
+        {
+          leave_critical_section(flags);
+          return ret;
+        }
+    }
+
+  /* Copy in at most two pieces around the end of the ring */
+
+  if (want > upper->count)
+    {
+      want = upper->count;
+    }
+
+  while (nread < want)
+    {
+      n = upper->nbuffer - upper->head;
+      if (n > want - nread)
+        {
+          n = want - nread;
+        }
+
+      memcpy(buffer + nread * upper->esize,
+             upper->buffer + upper->head * upper->esize, n * upper->esize);
+
+      upper->head   = (upper->head + n) % upper->nbuffer;
+      upper->count -= n;
+      nread        += n;
+    }
+
+  ret = nread * upper->esize;
+
+out:
+  leave_critical_section(flags);
+  nxsem_post(&upper->exclsem);
+  return ret;
+}
+
+/****************************************************************************
+ * Name: sensor_ioctl
+ ****************************************************************************/
+
+static int sensor_ioctl(FAR struct file *filep, int cmd, unsigned long arg)
+{
+  FAR struct inode *inode = filep->f_inode;
+  FAR struct sensor_upperhalf_s *upper = inode->i_private;
+  FAR struct sensor_lowerhalf_s *lower = upper->lower;
+  unsigned long val;
+  irqstate_t flags;
+  int ret;
+
+  ret = nxsem_wait(&upper->exclsem);
+  if (ret < 0)
+    {
+      return ret;
+    }
+
+  switch (cmd)
+    {
+      case SNIOC_ACTIVATE:
+        if ((bool)arg != upper->enabled)
+          {
+            ret = lower->ops->activate(lower, (bool)arg);
+            if (ret >= 0)
+              {
+                upper->enabled = (bool)arg;
+              }
+          }
+        break;
+
+      case SNIOC_SET_INTERVAL:
+        val = arg;
+        ret = lower->ops->set_interval(lower, &val);
+        if (ret >= 0)
+          {
+            upper->interval = val;
+          }
+        break;
+
+      case SNIOC_BATCH:
+        if (lower->ops->batch == NULL || lower->batch_number == 0)
+          {
+            ret = arg == 0 ? OK : -ENOTSUP;
+            break;
+          }
+
+        val = arg;
+        ret = lower->ops->batch(lower, &val);
+        if (ret >= 0)
+          {
+            upper->latency = val;
+          }
+        break;
+
+      case SNIOC_SET_WATERMARK:
+        if (arg == 0 || arg > upper->nbuffer)
+          {
+            ret = -EINVAL;
+            break;
+          }
+
+        flags = enter_critical_section();
+        upper->watermark = arg;
+        sensor_notify(upper);
+        leave_critical_section(flags);
+        break;
+
+      case SNIOC_SET_BUFFER_NUMBER:
+        ret = sensor_resize(upper, arg);
+        break;
+
+      case SNIOC_GET_INFO:
+        {
+          FAR struct sensor_info_s *info =
+            (FAR struct sensor_info_s *)((uintptr_t)arg);
+
+          if (info == NULL)
+            {
+              ret = -EINVAL;
+              break;
+            }
+
+          info->type          = lower->type;
+          info->esize         = upper->esize;
+          info->interval      = upper->interval;
+          info->latency       = upper->latency;
+          info->watermark     = upper->watermark;
+          info->buffer_number = upper->nbuffer;
+          info->batch_number  = lower->batch_number;
+          info->lost          = upper->lost;
+        }
+        break;
+
+      case SNIOC_FLUSH:
+        if (lower->ops->flush != NULL)
+          {
+            ret = lower->ops->flush(lower);
+          }
+        break;
+
+      default:
+        if (lower->ops->control != NULL)
+          {
+            ret = lower->ops->control(lower, cmd, arg);
+          }
+        else
+          {
+            ret = -ENOTTY;
+          }
+        break;
+    }
+
+  nxsem_post(&upper->exclsem);
+  return ret;
+}
+
+/****************************************************************************
+ * Name: sensor_poll
+ ****************************************************************************/
+
+static int sensor_poll(FAR struct file *filep, FAR struct pollfd *fds,
+                       bool setup)
+{
+  FAR struct inode *inode = filep->f_inode;
+  FAR struct sensor_upperhalf_s *upper = inode->i_private;
+  irqstate_t flags;
+  int ret;
+  int i;
+
+  ret = nxsem_wait(&upper->exclsem);
+  if (ret < 0)
+    {
+      return ret;
+    }
+
+  if (setup)
+    {
+      for (i = 0; i < CONFIG_SENSORS_NPOLLWAITERS; i++)
+        {
+          if (upper->fds[i] == NULL)
+            {
+              upper->fds[i] = fds;
+              fds->priv     = &upper->fds[i];
+              break;
+            }
+        }
+
+      if (i >= CONFIG_SENSORS_NPOLLWAITERS)
+        {
+          fds->priv = NULL;
+          ret       = -EBUSY;
+          goto out;
+        }
+
+      /* Report now if the watermark has already been reached */
+
+      flags = enter_critical_section();
+      if (upper->count >= upper->watermark && (fds->events & POLLIN) != 0)
+        {
+          fds->revents |= POLLIN;
+          nxsem_post(fds->sem);
+        }
+
+      leave_critical_section(flags);
+    }
+  else if (fds->priv != NULL)
+    {
+      FAR struct pollfd **slot = (FAR struct pollfd **)fds->priv;
+
+      *slot     = NULL;
+      fds->priv = NULL;
+    }
+
+out:
+  nxsem_post(&upper->exclsem);
+  return ret;
+}
+
+/****************************************************************************
+ * Public Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: sensor_register
+ *
+ * Description:
+ *   Register a sensor lower half with the common upper half as
+ *   /dev/sensor/<type name><devno>.
+ *
+ * Input Parameters:
+ *   lower - The lower half instance
+ *   devno - The number appended to the device name
+ *
+ * Returned Value:
+ *   Zero (OK) on success; a negated errno value on failure.
+ *
+ ****************************************************************************/
+
+int sensor_register(FAR struct sensor_lowerhalf_s *lower, int devno)
+{
+  FAR struct sensor_upperhalf_s *upper;
+  char path[DEVNAME_MAX];
+  int ret;
+
+  DEBUGASSERT(lower != NULL && lower->ops != NULL &&
+              lower->ops->activate != NULL &&
+              lower->ops->set_interval != NULL);
+
+  if (lower->type <= 0 || lower->type >= SENSOR_TYPE_COUNT)
+    {
+      return -EINVAL;
+    }
+
+  upper = kmm_zalloc(sizeof(struct sensor_upperhalf_s));
+  if (upper == NULL)
+    {
+      return -ENOMEM;
+    }
+
+  upper->lower     = lower;
+  upper->esize     = g_sensor_meta[lower->type].esize;
+  upper->watermark = 1;
+
+  ret = sensor_resize(upper, lower->buffer_number != 0 ?
+                      lower->buffer_number : CONFIG_SENSORS_UPPER_NBUFFER);
+  if (ret < 0)
+    {
+      kmm_free(upper);
+      return ret;
+    }
+
+  nxsem_init(&upper->exclsem, 0, 1);
+  nxsem_init(&upper->readsem, 0, 0);
+  nxsem_setprotocol(&upper->readsem, SEM_PRIO_NONE);
+
+  lower->push_event = sensor_push_event;
+  lower->priv       = upper;
+
+  snprintf(path, DEVNAME_MAX, DEVNAME_FMT,
+           g_sensor_meta[lower->type].name, devno);
+
+  ret = register_driver(path, &g_sensor_fops, 0666, upper);
+  if (ret < 0)
+    {
+      snerr("ERROR: Failed to register %s: %d\n", path, ret);
+      nxsem_destroy(&upper->exclsem);
+      nxsem_destroy(&upper->readsem);
+      kmm_free(upper->buffer);
+      kmm_free(upper);
+      lower->push_event = NULL;
+      lower->priv       = NULL;
+    }
+
+  return ret;
+}
+
+/****************************************************************************
+ * Name: sensor_unregister
+ *
+ * Description:
+ *   Undo sensor_register().
+ *
+ ****************************************************************************/
+
+void sensor_unregister(FAR struct sensor_lowerhalf_s *lower, int devno)
+{
+  FAR struct sensor_upperhalf_s *upper = lower->priv;
+  char path[DEVNAME_MAX];
+
+  if (upper == NULL)
+    {
+      return;
+    }
+
+  snprintf(path, DEVNAME_MAX, DEVNAME_FMT,
+           g_sensor_meta[lower->type].name, devno);
+  unregister_driver(path);
+
+  nxsem_destroy(&upper->exclsem);
+  nxsem_destroy(&upper->readsem);
+  kmm_free(upper->buffer);
+  kmm_free(upper);
+
+  lower->push_event = NULL;
+  lower->priv       = NULL;
+}
+
+#endif /* CONFIG_SENSORS_UPPER */
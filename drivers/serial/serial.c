@@ -98,10 +98,17 @@ static void    uart_pollnotify(FAR uart_dev_t *dev, pollevent_t eventset);
 /* Write support */
 
 static int     uart_putxmitchar(FAR uart_dev_t *dev, int ch, bool oktoblock);
+static size_t  uart_putxmitblock(FAR uart_dev_t *dev, FAR const char *buffer,
+                                 size_t buflen);
 static inline ssize_t uart_irqwrite(FAR uart_dev_t *dev, FAR const char *buffer,
                                     size_t buflen);
 static int     uart_tcdrain(FAR uart_dev_t *dev, clock_t timeout);
 
+/* Read support */
+
+static size_t  uart_getrecvblock(FAR uart_dev_t *dev, FAR char *buffer,
+                                 size_t buflen);
+
 /* Character driver methods */
 
 static int     uart_open(FAR struct file *filep);
@@ -352,6 +359,146 @@ err_out:
   return ret;
 }
 
+/************************************************************************************
+ * Name: uart_putxmitblock
+ *
+ * Description:
+ *   Copy as much of 'buffer' into the TX buffer as fits without waiting,
+ *   with at most two memcpy's.  No output processing is done.  Returns the
+ *   number of bytes copied.
+ *
+ ************************************************************************************/
+
+static size_t uart_putxmitblock(FAR uart_dev_t *dev, FAR const char *buffer,
+                                size_t buflen)
+{
+  FAR struct uart_buffer_s *txbuf = &dev->xmit;
+  size_t nwritten = 0;
+  size_t nfree;
+  size_t chunk;
+  int16_t head;
+  int16_t tail;
+
+#ifdef CONFIG_SMP
+  irqstate_t flags = enter_critical_section();
+#endif
+
+  /* Only uart_xmitchars() moves the tail, and only to free more space */
+
+  head = txbuf->head;
+  tail = txbuf->tail;
+
+  /* One slot always stays empty to tell a full buffer from an empty one */
+
+  if (head >= tail)
+    {
+      nfree = txbuf->size - head + tail - 1;
+    }
+  else
+    {
+      nfree = tail - head - 1;
+    }
+
+  if (buflen > nfree)
+    {
+      buflen = nfree;
+    }
+
+  while (buflen > 0)
+    {
+      /* Copy up to the end of the buffer, then wrap */
+
+      chunk = txbuf->size - head;
+      if (chunk > buflen)
+        {
+          chunk = buflen;
+        }
+
+      memcpy(&txbuf->buffer[head], buffer, chunk);
+      buffer   += chunk;
+      buflen   -= chunk;
+      nwritten += chunk;
+
+      head += chunk;
+      if (head >= txbuf->size)
+        {
+          head = 0;
+        }
+    }
+
+  txbuf->head = head;
+
+#ifdef CONFIG_SMP
+  leave_critical_section(flags);
+#endif
+
+  return nwritten;
+}
+
+/************************************************************************************
+ * Name: uart_getrecvblock
+ *
+ * Description:
+ *   Copy up to 'buflen' bytes from the RX buffer, with at most two memcpy's.
+ *   No input processing is done.  Returns the number of bytes copied.
+ *
+ ************************************************************************************/
+
+static size_t uart_getrecvblock(FAR uart_dev_t *dev, FAR char *buffer,
+                                size_t buflen)
+{
+  FAR struct uart_buffer_s *rxbuf = &dev->recv;
+  size_t nread = 0;
+  size_t navail;
+  size_t chunk;
+  int16_t head;
+  int16_t tail;
+
+  /* Only the RX interrupt moves the head, and only to add more data */
+
+  head = rxbuf->head;
+  tail = rxbuf->tail;
+
+  if (head >= tail)
+    {
+      navail = head - tail;
+    }
+  else
+    {
+      navail = rxbuf->size - tail + head;
+    }
+
+  if (buflen > navail)
+    {
+      buflen = navail;
+    }
+
+  while (buflen > 0)
+    {
+      chunk = rxbuf->size - tail;
+      if (chunk > buflen)
+        {
+          chunk = buflen;
+        }
+
+      memcpy(buffer, &rxbuf->buffer[tail], chunk);
+      buffer += chunk;
+      buflen -= chunk;
+      nread  += chunk;
+
+      tail += chunk;
+      if (tail >= rxbuf->size)
+        {
+          tail = 0;
+        }
+    }
+
+  /* A single store, so that the RX interrupt sees the new tail atomically */
+
+  rxbuf->tail = tail;
+  return nread;
+}
+
 /************************************************************************************
  * Name: uart_putc
  ************************************************************************************/
@@ -724,10 +871,29 @@ static ssize_t uart_read(FAR struct file *filep, FAR char *buffer, size_t buflen
 #endif
   irqstate_t flags;
   ssize_t recvd = 0;
+#ifdef CONFIG_SERIAL_THRESHOLDS
+  size_t want;
+  int16_t head;
+#endif
   int16_t tail;
+  bool raw;
   char ch;
   int ret;
 
+  /* Without input processing, data can be block copied from the RX buffer */
+
+#ifdef CONFIG_SERIAL_TERMIOS
+  raw = (dev->tc_iflag & (INLCR | IGNCR | ICRNL)) == 0;
+#else
+  raw = true;
+#endif
+
+#ifdef CONFIG_SERIAL_THRESHOLDS
+  /* A blocking read returns once this many bytes are available (VMIN) */
+
+  want = dev->rxmin < buflen ? dev->rxmin : buflen;
+#endif
+
   /* Only one user can access rxbuf->tail at a time */
 
   ret = uart_takesem(&rxbuf->sem, true);
@@ -776,7 +942,15 @@ static ssize_t uart_read(FAR struct file *filep, FAR char *buffer, size_t buflen
        */
 
       tail = rxbuf->tail;
-      if (rxbuf->head != tail)
+      if (rxbuf->head != tail && raw)
+        {
+          /* Copy everything buffered in one pass */
+
+          ret     = uart_getrecvblock(dev, buffer, buflen - recvd);
+          buffer += ret;
+          recvd  += ret;
+        }
+      else if (rxbuf->head != tail)
         {
           /* Take the next character from the tail of the buffer */
 
@@ -853,6 +1027,28 @@ static ssize_t uart_read(FAR struct file *filep, FAR char *buffer, size_t buflen
 
           break;
        }
+#elif defined(CONFIG_SERIAL_THRESHOLDS)
+      /* No... the circular buffer is empty.  Has the minimum been read?  With
+       * an inter-character timeout, at least one byte must have been read
+       * (or the timeout expired below) unless VMIN and VTIME are both zero.
+       */
+
+      else if ((size_t)recvd >= want && (recvd > 0 || dev->rxtimeout == 0))
+        {
+          break;
+        }
+
+      /* Do not wait if the user has specified the O_NONBLOCK option */
+
+      else if ((filep->f_oflags & O_NONBLOCK) != 0)
+        {
+          if (recvd < 1)
+            {
+              recvd = -EAGAIN;
+            }
+
+          break;
+        }
 #else
       /* No... the circular buffer is empty.  Have we returned anything
        * to the caller?
@@ -942,8 +1138,49 @@ static ssize_t uart_read(FAR struct file *filep, FAR char *buffer, size_t buflen
                    * thread goes to sleep.
                    */
 
+#ifdef CONFIG_SERIAL_THRESHOLDS
+                  /* Wake up once the rest of the minimum has arrived, or on
+                   * every byte when the inter-character timer is running.
+                   */
+
+                  if (dev->rxtimeout > 0 && (recvd > 0 || want == 0))
+                    {
+                      dev->rxwant      = 1;
+                      dev->recvwaiting = true;
+                      head             = rxbuf->head;
+                      ret = nxsem_tickwait(&dev->recvsem, clock_systimer(),
+                                           dev->rxtimeout);
+                      if (ret == -ETIMEDOUT)
+                        {
+                          /* Return what has been read unless a byte slipped
+                           * in just as the timer expired.
+                           */
+
+                          dev->recvwaiting = false;
+                          if (rxbuf->head == head)
+                            {
+                              leave_critical_section(flags);
+                              break;
+                            }
+
+                          ret = OK;
+                        }
+                    }
+                  else
+                    {
+                      dev->rxwant = want - recvd;
+                      if (dev->rxwant > rxbuf->size - 1)
+                        {
+                          dev->rxwant = rxbuf->size - 1;
+                        }
+
+                      dev->recvwaiting = true;
+                      ret = uart_takesem(&dev->recvsem, true);
+                    }
+#else
                   dev->recvwaiting = true;
                   ret = uart_takesem(&dev->recvsem, true);
+#endif
                 }
 
               leave_critical_section(flags);
@@ -1062,7 +1299,9 @@ static ssize_t uart_write(FAR struct file *filep, FAR const char *buffer,
   FAR struct inode *inode    = filep->f_inode;
   FAR uart_dev_t   *dev      = inode->i_private;
   ssize_t           nwritten = buflen;
+  size_t            nblock;
   bool              oktoblock;
+  bool              raw;
   int               ret;
   char              ch;
 
@@ -1126,6 +1365,15 @@ static ssize_t uart_write(FAR struct file *filep, FAR const char *buffer,
 
   oktoblock = ((filep->f_oflags & O_NONBLOCK) == 0);
 
+  /* Without output processing, data can be block copied to the TX buffer */
+
+#ifdef CONFIG_SERIAL_TERMIOS
+  raw = (dev->tc_oflag & OPOST) == 0 ||
+        (dev->tc_oflag & (OCRNL | ONLCR | ONLRET)) == 0;
+#else
+  raw = !dev->isconsole;
+#endif
+
   /* Loop while we still have data to copy to the transmit buffer.
    * we add data to the head of the buffer; uart_xmitchars takes the
    * data from the end of the buffer.
@@ -1134,6 +1382,21 @@ static ssize_t uart_write(FAR struct file *filep, FAR const char *buffer,
   uart_disabletxint(dev);
   for (; buflen; buflen--)
     {
+      if (raw)
+        {
+          /* Copy as much as fits now.  If the buffer is full, fall through
+           * and let uart_putxmitchar() wait for space.
+           */
+
+          nblock  = uart_putxmitblock(dev, buffer, buflen);
+          buffer += nblock;
+          buflen -= nblock;
+          if (buflen == 0)
+            {
+              break;
+            }
+        }
+
       ch  = *buffer++;
       ret = OK;
 
@@ -1389,6 +1652,86 @@ static int uart_ioctl(FAR struct file *filep, int cmd, unsigned long arg)
             }
             break;
 #endif
+
+#ifdef CONFIG_SERIAL_THRESHOLDS
+          /* Set the read inter-character timeout in microseconds.  Zero
+           * disables the timeout.
+           */
+
+          case TIOCSRXTIMEOUT:
+            {
+              int usec = (int)arg;
+
+              if (usec < 0)
+                {
+                  ret = -EINVAL;
+                  break;
+                }
+
+              /* Round up so that a short timeout does not become zero */
+
+              dev->rxtimeout = USEC2TICK(usec);
+              if (usec > 0 && TICK2USEC(dev->rxtimeout) < usec)
+                {
+                  dev->rxtimeout++;
+                }
+
+              ret = 0;
+            }
+            break;
+
+          case TIOCGRXTIMEOUT:
+            {
+              FAR int *usec = (FAR int *)((uintptr_t)arg);
+
+              if (usec == NULL)
+                {
+                  ret = -EINVAL;
+                  break;
+                }
+
+              *usec = TICK2USEC(dev->rxtimeout);
+              ret = 0;
+            }
+            break;
+
+          /* Set the number of free TX bytes that wakes a blocked writer */
+
+          case TIOCSTXLOWAT:
+            {
+              int lowat = (int)arg;
+
+              if (lowat < 0)
+                {
+                  ret = -EINVAL;
+                  break;
+                }
+
+              if (lowat > dev->xmit.size - 1)
+                {
+                  lowat = dev->xmit.size - 1;
+                }
+
+              dev->txlowat = lowat;
+              ret = 0;
+            }
+            break;
+
+          case TIOCGTXLOWAT:
+            {
+              FAR int *lowat = (FAR int *)((uintptr_t)arg);
+
+              if (lowat == NULL)
+                {
+                  ret = -EINVAL;
+                  break;
+                }
+
+              *lowat = dev->txlowat;
+              ret = 0;
+            }
+            break;
+#endif
         }
     }
 
@@ -1414,6 +1757,11 @@ static int uart_ioctl(FAR struct file *filep, int cmd, unsigned long arg)
               termiosp->c_iflag = dev->tc_iflag;
               termiosp->c_oflag = dev->tc_oflag;
               termiosp->c_lflag = dev->tc_lflag;
+
+#ifdef CONFIG_SERIAL_THRESHOLDS
+              termiosp->c_cc[VMIN]  = dev->rxmin;
+              termiosp->c_cc[VTIME] = TICK2DSEC(dev->rxtimeout);
+#endif
             }
             break;
 
@@ -1433,6 +1781,13 @@ static int uart_ioctl(FAR struct file *filep, int cmd, unsigned long arg)
               dev->tc_oflag = termiosp->c_oflag;
               dev->tc_lflag = termiosp->c_lflag;
 
+#ifdef CONFIG_SERIAL_THRESHOLDS
+              /* Non-canonical read thresholds.  VTIME is in deciseconds. */
+
+              dev->rxmin     = termiosp->c_cc[VMIN];
+              dev->rxtimeout = DSEC2TICK(termiosp->c_cc[VTIME]);
+#endif
+
 #if defined(CONFIG_TTY_SIGINT) || defined(CONFIG_TTY_SIGSTP)
               /* If the ISIG flag has been cleared in c_lflag, then un-
                * register the controlling terminal.
@@ -1627,6 +1982,16 @@ int uart_register(FAR const char *path, FAR uart_dev_t *dev)
     }
 #endif
 
+#ifdef CONFIG_SERIAL_THRESHOLDS
+  /* By default a read returns as soon as one byte is available and a writer
+   * is woken as soon as any space is free.
+   */
+
+  dev->rxmin   = 1;
+  dev->rxwant  = 1;
+  dev->txlowat = 0;
+#endif
+
   /* Initialize semaphores */
 
   nxsem_init(&dev->xmit.sem, 0, 1);
@@ -1661,9 +2026,24 @@ int uart_register(FAR const char *path, FAR uart_dev_t *dev)
 
 void uart_datareceived(FAR uart_dev_t *dev)
 {
+#ifdef CONFIG_SERIAL_THRESHOLDS
+  FAR struct uart_buffer_s *rxbuf = &dev->recv;
+  int16_t nbuffered;
+
+  nbuffered = rxbuf->head - rxbuf->tail;
+  if (nbuffered < 0)
+    {
+      nbuffered += rxbuf->size;
+    }
+
+  /* Is there a thread waiting for this much read data?  */
+
+  if (dev->recvwaiting && nbuffered >= dev->rxwant)
+#else
   /* Is there a thread waiting for read data?  */
 
   if (dev->recvwaiting)
+#endif
     {
       /* Yes... wake it up */
 
@@ -1699,6 +2079,24 @@ void uart_datareceived(FAR uart_dev_t *dev)
 
 void uart_datasent(FAR uart_dev_t *dev)
 {
+#ifdef CONFIG_SERIAL_THRESHOLDS
+  FAR struct uart_buffer_s *txbuf = &dev->xmit;
+  int16_t nfree;
+
+  /* Stay asleep until the low-water amount of space is free */
+
+  nfree = txbuf->tail - txbuf->head - 1;
+  if (nfree < 0)
+    {
+      nfree += txbuf->size;
+    }
+
+  if (nfree < dev->txlowat && txbuf->head != txbuf->tail)
+    {
+      return;
+    }
+#endif
+
   /* Is there a thread waiting for space in xmit.buffer?  */
 
   if (dev->xmitwaiting)
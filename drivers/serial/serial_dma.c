@@ -41,6 +41,7 @@
 
 #include <sys/types.h>
 #include <stdint.h>
+#include <assert.h>
 #include <debug.h>
 
 #include <nuttx/serial/serial.h>
@@ -408,4 +409,104 @@ void uart_recvchars_done(FAR uart_dev_t *dev)
 }
 #endif
 
+/****************************************************************************
+ * Name: uart_recvchars_circular
+ *
+ * Description:
+ *   Account for data written by an RX DMA that runs continuously over the
+ *   whole RX circular buffer.  'pos' is the buffer index that the DMA will
+ *   write next.  Called from the lower half's DMA half/full-transfer and
+ *   idle-line interrupts.
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_SERIAL_RXDMA_CIRCULAR
+void uart_recvchars_circular(FAR uart_dev_t *dev, size_t pos, int event)
+{
+  FAR struct uart_dmaxfer_s *xfer = &dev->dmarx;
+  FAR struct uart_buffer_s *rxbuf = &dev->recv;
+  size_t size = rxbuf->size;
+  size_t nbytes;
+  size_t nfree;
+#ifdef CONFIG_SERIAL_IFLOWCONTROL_WATERMARKS
+  unsigned int nbuffered;
+  unsigned int watermark;
+#endif
+#if defined(CONFIG_TTY_SIGINT) || defined(CONFIG_TTY_SIGSTP)
+  int signo = 0;
+#endif
+
+  DEBUGASSERT(pos < size);
+
+  /* How far has the DMA moved since the last event?  Landing on the old
+   * head at a half or full-transfer boundary means a complete lap.
+   */
+
+  nbytes = (pos + size - rxbuf->head) % size;
+  if (nbytes == 0)
+    {
+      if (event == UART_RXDMA_IDLE)
+        {
+          return;
+        }
+
+      nbytes = size;
+    }
+
+  nfree = (rxbuf->tail + size - rxbuf->head - 1) % size;
+
+#if defined(CONFIG_TTY_SIGINT) || defined(CONFIG_TTY_SIGSTP)
+  /* Describe the new data so that it can be checked for signal characters */
+
+  xfer->buffer  = &rxbuf->buffer[rxbuf->head];
+  xfer->length  = size - rxbuf->head;
+  xfer->nbuffer = rxbuf->buffer;
+  xfer->nlength = rxbuf->head;
+  xfer->nbytes  = nbytes;
+
+  if (dev->pid >= 0)
+    {
+      signo = uart_recvchars_signo(dev);
+    }
+#endif
+
+  rxbuf->head = pos;
+  xfer->nbytes = 0;
+
+  if (nbytes > nfree)
+    {
+      /* The DMA overran unread data, which is already lost.  Keep the
+       * newest size - 1 bytes.
+       */
+
+      rxbuf->tail = (pos + 1) % size;
+    }
+
+#ifdef CONFIG_SERIAL_IFLOWCONTROL_WATERMARKS
+  /* The DMA cannot be paused here, but the lower half may still assert RTS
+   * when the buffer passes the upper watermark.
+   */
+
+  nbuffered = (rxbuf->head + size - rxbuf->tail) % size;
+  watermark = (CONFIG_SERIAL_IFLOWCONTROL_UPPER_WATERMARK * size) / 100;
+  if (nbuffered >= watermark)
+    {
+      uart_rxflowcontrol(dev, nbuffered, true);
+    }
+#endif
+
+  uart_datareceived(dev);
+
+#if defined(CONFIG_TTY_SIGINT) || defined(CONFIG_TTY_SIGSTP)
+  /* Send the signal if necessary */
+
+  if (signo != 0)
+    {
+      kill(dev->pid, signo);
+      uart_reset_sem(dev);
+    }
+#endif
+}
+#endif
+
 #endif /* CONFIG_SERIAL_TXDMA || CONFIG_SERIAL_RXDMA */
@@ -0,0 +1,259 @@
+/****************************************************************************
+ * drivers/syslog/note_stream.c
+ *
+ *   Copyright (C) 2020 Gregory Nutt. All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in
+ *    the documentation and/or other materials provided with the
+ *    distribution.
+ * 3. Neither the name NuttX nor the names of its contributors may be
+ *    used to endorse or promote products derived from this software
+ *    without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+ * FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE
+ * COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+ * INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,
+ * BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS
+ * OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED
+ * AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ * LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN
+ * ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ *
+ ****************************************************************************/
+
+/****************************************************************************
+ * Included Files
+ ****************************************************************************/
+
+#include <nuttx/config.h>
+
+#include <sys/types.h>
+#include <stdint.h>
+#include <stdbool.h>
+#include <fcntl.h>
+#include <assert.h>
+#include <errno.h>
+#include <debug.h>
+
+#include <nuttx/clock.h>
+#include <nuttx/kthread.h>
+#include <nuttx/sched_note.h>
+#include <nuttx/signal.h>
+#include <nuttx/fs/fs.h>
+
+#if defined(CONFIG_SCHED_INSTRUMENTATION_BUFFER) && \
+    defined(CONFIG_DRIVER_NOTE_STREAM)
+
+/****************************************************************************
+ * Private Types
+ ****************************************************************************/
+
+struct note_stream_s
+{
+  bool started;                 /* True: The stream thread was started */
+  struct file file;             /* The destination device */
+
+  /* The batch of notes being written */
+
+  uint8_t buffer[CONFIG_DRIVER_NOTE_STREAM_BUFSIZE];
+};
+
+/****************************************************************************
+ * Private Data
+ ****************************************************************************/
+
+static struct note_stream_s g_note_stream;
+
+/****************************************************************************
+ * Private Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: note_stream_write
+ *
+ * Description:
+ *   Write all of the data to the stream device.  Data is discarded if the
+ *   device reports an error, e.g. if the USB host is not connected.
+ *
+ ****************************************************************************/
+
+static void note_stream_write(FAR const uint8_t *buffer, size_t buflen)
+{
+  ssize_t nwritten;
+
+  while (buflen > 0)
+    {
+      nwritten = file_write(&g_note_stream.file, buffer, buflen);
+      if (nwritten < 0)
+        {
+          if (nwritten == -EINTR)
+            {
+              continue;
+            }
+
+          break;
+        }
+
+      buffer += nwritten;
+      buflen -= nwritten;
+    }
+}
+
+/****************************************************************************
+ * Name: note_stream_header
+ *
+ * Description:
+ *   Write the stream header.
+ *
+ ****************************************************************************/
+
+static void note_stream_header(void)
+{
+  struct note_streamhdr_s hdr;
+  uint32_t usec = USEC_PER_TICK;
+
+  hdr.nsh_magic[0]       = NOTE_STREAM_MAGIC0;
+  hdr.nsh_magic[1]       = NOTE_STREAM_MAGIC1;
+  hdr.nsh_magic[2]       = NOTE_STREAM_MAGIC2;
+  hdr.nsh_magic[3]       = NOTE_STREAM_MAGIC3;
+  hdr.nsh_version        = NOTE_STREAM_VERSION;
+#ifdef CONFIG_SMP
+  hdr.nsh_flags          = NOTE_STREAM_FLAG_SMP;
+  hdr.nsh_ncpus          = CONFIG_SMP_NCPUS;
+#else
+  hdr.nsh_flags          = 0;
+  hdr.nsh_ncpus          = 1;
+#endif
+  hdr.nsh_namesize       = CONFIG_TASK_NAME_SIZE;
+  hdr.nsh_usecpertick[0] = (uint8_t)(usec & 0xff);
+  hdr.nsh_usecpertick[1] = (uint8_t)((usec >> 8) & 0xff);
+  hdr.nsh_usecpertick[2] = (uint8_t)((usec >> 16) & 0xff);
+  hdr.nsh_usecpertick[3] = (uint8_t)((usec >> 24) & 0xff);
+
+  note_stream_write((FAR const uint8_t *)&hdr,
+                    sizeof(struct note_streamhdr_s));
+}
+
+/****************************************************************************
+ * Name: note_stream_thread
+ *
+ * Description:
+ *   Drain the note buffers in batches and write each batch to the device.
+ *   Sleep when there are no notes.
+ *
+ ****************************************************************************/
+
+static int note_stream_thread(int argc, FAR char *argv[])
+{
+  FAR uint8_t *buffer = g_note_stream.buffer;
+  ssize_t notelen;
+  size_t len;
+
+  note_stream_header();
+
+  for (; ; )
+    {
+      /* Collect as many notes as will fit into the batch buffer */
+
+      len = 0;
+      while ((notelen = sched_note_size()) > 0)
+        {
+          /* A note that does not fit is left for the next batch, unless it
+           * is larger than the whole buffer: sched_note_get() will then
+           * discard it.
+           */
+
+          if (notelen > CONFIG_DRIVER_NOTE_STREAM_BUFSIZE - len && len > 0)
+            {
+              break;
+            }
+
+          notelen = sched_note_get(&buffer[len],
+                                   CONFIG_DRIVER_NOTE_STREAM_BUFSIZE - len);
+          if (notelen == 0)
+            {
+              break;
+            }
+          else if (notelen > 0)
+            {
+              len += notelen;
+            }
+        }
+
+      if (len > 0)
+        {
+          note_stream_write(buffer, len);
+        }
+      else
+        {
+          nxsig_usleep(CONFIG_DRIVER_NOTE_STREAM_PERIOD * USEC_PER_MSEC);
+        }
+    }
+
+  return OK;
+}
+
+/****************************************************************************
+ * Public Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: note_stream_start
+ *
+ * Description:
+ *   Start a kernel thread that continuously drains the note buffers and
+ *   writes the notes as a binary stream to a character device.
+ *
+ * Input Parameters:
+ *   devpath - The path to the character device
+ *
+ * Returned Value:
+ *   Zero (OK) is returned on success.  Otherwise, a negated errno value is
+ *   returned.
+ *
+ ****************************************************************************/
+
+int note_stream_start(FAR const char *devpath)
+{
+  int ret;
+
+  DEBUGASSERT(devpath != NULL);
+
+  if (g_note_stream.started)
+    {
+      return -EBUSY;
+    }
+
+  ret = file_open(&g_note_stream.file, devpath, O_WRONLY);
+  if (ret < 0)
+    {
+      serr("ERROR: Failed to open %s: %d\n", devpath, ret);
+      return ret;
+    }
+
+  ret = kthread_create("note_stream", CONFIG_DRIVER_NOTE_STREAM_PRIORITY,
+                       CONFIG_DRIVER_NOTE_STREAM_STACKSIZE,
+                       (main_t)note_stream_thread, NULL);
+  if (ret < 0)
+    {
+      serr("ERROR: Failed to start the note stream thread: %d\n", ret);
+      file_close(&g_note_stream.file);
+      return ret;
+    }
+
+  g_note_stream.started = true;
+  return OK;
+}
+
+#endif /* CONFIG_SCHED_INSTRUMENTATION_BUFFER && CONFIG_DRIVER_NOTE_STREAM */
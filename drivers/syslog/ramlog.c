@@ -55,6 +55,7 @@
 
 #include <nuttx/arch.h>
 #include <nuttx/kmalloc.h>
+#include <nuttx/ringbuf.h>
 #include <nuttx/semaphore.h>
 #include <nuttx/fs/fs.h>
 #include <nuttx/syslog/ramlog.h>
@@ -72,14 +73,11 @@ struct ramlog_dev_s
 #ifndef CONFIG_RAMLOG_NONBLOCKING
   volatile uint8_t  rl_nwaiters;     /* Number of threads waiting for data */
 #endif
-  volatile uint16_t rl_head;         /* The head index (where data is added) */
-  volatile uint16_t rl_tail;         /* The tail index (where data is removed) */
+  struct ringbuf_s  rl_ring;         /* Circular RAM buffer */
   sem_t             rl_exclsem;      /* Enforces mutually exclusive access */
 #ifndef CONFIG_RAMLOG_NONBLOCKING
   sem_t             rl_waitsem;      /* Used to wait for data */
 #endif
-  size_t            rl_bufsize;      /* Size of the RAM buffer */
-  FAR char         *rl_buffer;       /* Circular RAM buffer */
 
   /* The following is a list if poll structures of threads waiting for
    * driver events. The 'struct pollfd' reference for each open is also
@@ -165,14 +163,11 @@ static struct ramlog_dev_s g_sysdev =
 #ifndef CONFIG_RAMLOG_NONBLOCKING
   0,                             /* rl_nwaiters */
 #endif
-  0,                             /* rl_head */
-  0,                             /* rl_tail */
+  RINGBUF_INITIALIZER(g_sysbuffer, CONFIG_RAMLOG_BUFSIZE), /* rl_ring */
   SEM_INITIALIZER(1),            /* rl_exclsem */
 #ifndef CONFIG_RAMLOG_NONBLOCKING
   SEM_INITIALIZER(0),            /* rl_waitsem */
 #endif
-  CONFIG_RAMLOG_BUFSIZE,         /* rl_bufsize */
-  g_sysbuffer                    /* rl_buffer */
 };
 #endif
 
@@ -253,30 +248,19 @@ static void ramlog_pollnotify(FAR struct ramlog_dev_s *priv,
 static ssize_t ramlog_addchar(FAR struct ramlog_dev_s *priv, char ch)
 {
   irqstate_t flags;
-  size_t nexthead;
 
   /* Disable interrupts (in case we are NOT called from interrupt handler) */
 
   flags = enter_critical_section();
 
-  /* Calculate the write index AFTER the next byte is written */
-
-  nexthead = priv->rl_head + 1;
-  if (nexthead >= priv->rl_bufsize)
-    {
-      nexthead = 0;
-    }
-
   /* Would the next write overflow the circular buffer? */
 
-  if (nexthead == priv->rl_tail)
+  if (ringbuf_is_full(&priv->rl_ring))
     {
 #ifdef CONFIG_RAMLOG_OVERWRITE
-      priv->rl_tail += 1;
-      if (priv->rl_tail >= priv->rl_bufsize)
-        {
-          priv->rl_tail = 0;
-        }
+      /* Yes... drop the oldest byte to make room */
+
+      ringbuf_rdcommit(&priv->rl_ring, 1);
 #else
       /* Yes... Return an indication that nothing was saved in the buffer. */
 
@@ -287,8 +271,7 @@ static ssize_t ramlog_addchar(FAR struct ramlog_dev_s *priv, char ch)
 
   /* No... copy the byte and re-enable interrupts */
 
-  priv->rl_buffer[priv->rl_head] = ch;
-  priv->rl_head = nexthead;
+  ringbuf_write(&priv->rl_ring, &ch, 1);
   leave_critical_section(flags);
   return OK;
 }
@@ -301,8 +284,10 @@ static ssize_t ramlog_read(FAR struct file *filep, FAR char *buffer, size_t len)
 {
   FAR struct inode *inode = filep->f_inode;
   FAR struct ramlog_dev_s *priv;
+#ifdef CONFIG_RAMLOG_OVERWRITE
+  irqstate_t flags;
+#endif
   ssize_t nread;
-  char ch;
   int ret;
 
   /* Some sanity checking */
@@ -316,7 +301,7 @@ static ssize_t ramlog_read(FAR struct file *filep, FAR char *buffer, size_t len)
 
   DEBUGASSERT(!up_interrupt_context());
 
-  /* Get exclusive access to the rl_tail index */
+  /* Get exclusive access to the tail of rl_ring */
 
   ret = nxsem_wait(&priv->rl_exclsem);
   if (ret < 0)
@@ -328,9 +313,9 @@ static ssize_t ramlog_read(FAR struct file *filep, FAR char *buffer, size_t len)
 
   for (nread = 0; (size_t)nread < len; )
     {
-      /* Get the next byte from the buffer */
+      /* Get the next bytes from the buffer */
 
-      if (priv->rl_head == priv->rl_tail)
+      if (ringbuf_is_empty(&priv->rl_ring))
         {
           /* The circular buffer is empty. */
 
@@ -413,23 +398,19 @@ static ssize_t ramlog_read(FAR struct file *filep, FAR char *buffer, size_t len)
         }
       else
         {
-          /* The circular buffer is not empty, get the next byte from the
-           * tail index.
+          /* The circular buffer is not empty, copy as much as fits into
+           * the user buffer.  With overwrite enabled the writer may also
+           * move the tail, so keep it out while copying.
            */
 
-          ch = priv->rl_buffer[priv->rl_tail];
-
-          /* Increment the tail index. */
-
-          if (++priv->rl_tail >= priv->rl_bufsize)
-            {
-              priv->rl_tail = 0;
-            }
-
-          /* Add the character to the user buffer. */
-
-          buffer[nread] = ch;
-          nread++;
+#ifdef CONFIG_RAMLOG_OVERWRITE
+          flags = enter_critical_section();
+#endif
+          nread += ringbuf_read(&priv->rl_ring, &buffer[nread],
+                                len - nread);
+#ifdef CONFIG_RAMLOG_OVERWRITE
+          leave_critical_section(flags);
+#endif
         }
     }
 
@@ -474,10 +455,10 @@ static ssize_t ramlog_write(FAR struct file *filep, FAR const char *buffer, size
   /* Loop until all of the bytes have been written.  This function may be
    * called from an interrupt handler!  Semaphores cannot be used!
    *
-   * The write logic only needs to modify the rl_head index.  Therefore,
-   * there is a difference in the way that rl_head and rl_tail are protected:
-   * rl_tail is protected with a semaphore; rl_head is protected by disabling
-   * interrupts.
+   * The write logic only needs to modify the head of rl_ring.  Therefore,
+   * there is a difference in the way that the head and tail are protected:
+   * the tail is protected with a semaphore; the head is protected by
+   * disabling interrupts.
    */
 
   for (nwritten = 0; (size_t)nwritten < len; nwritten++)
@@ -570,7 +551,6 @@ int ramlog_poll(FAR struct file *filep, FAR struct pollfd *fds, bool setup)
   FAR struct ramlog_dev_s *priv;
   pollevent_t eventset;
   irqstate_t flags;
-  size_t next_head;
   int ret;
   int i;
 
@@ -616,30 +596,12 @@ int ramlog_poll(FAR struct file *filep, FAR struct pollfd *fds, bool setup)
           goto errout;
         }
 
-      /* Should immediately notify on any of the requested events? */
-
-      eventset = 0;
+      /* Should immediately notify on any of the requested events?  Check
+       * if the receive buffer is not full and not empty.
+       */
 
       flags = enter_critical_section();
-      next_head = priv->rl_head + 1;
-      if (next_head >= priv->rl_bufsize)
-        {
-          next_head = 0;
-        }
-
-      /* First, check if the receive buffer is not full. */
-
-      if (next_head != priv->rl_tail)
-       {
-         eventset |= POLLOUT;
-       }
-
-      /* Check if the receive buffer is not empty. */
-
-      if (priv->rl_head != priv->rl_tail)
-       {
-         eventset |= POLLIN;
-       }
+      eventset = ringbuf_pollevents(&priv->rl_ring);
       leave_critical_section(flags);
 
       if (eventset)
@@ -713,8 +675,7 @@ int ramlog_register(FAR const char *devpath, FAR char *buffer, size_t buflen)
       nxsem_setprotocol(&priv->rl_waitsem, SEM_PRIO_NONE);
 #endif
 
-      priv->rl_bufsize = buflen;
-      priv->rl_buffer  = buffer;
+      ringbuf_init(&priv->rl_ring, buffer, buflen);
 
       /* Register the character driver */
 
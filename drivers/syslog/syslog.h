@@ -252,6 +252,58 @@ int syslog_flush_intbuffer(FAR const struct syslog_channel_s *channel,
                            bool force);
 #endif
 
+/****************************************************************************
+ * Name: syslog_async_start
+ *
+ * Description:
+ *   Start the low priority kernel thread that drains the per-CPU SYSLOG
+ *   buffers.  Until it runs, SYSLOG output is emitted synchronously.
+ *
+ * Returned Value:
+ *   Zero (OK) is returned on success; a negated errno value is returned on
+ *   any failure.
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_SYSLOG_ASYNC
+int syslog_async_start(void);
+#endif
+
+/****************************************************************************
+ * Name: syslog_async_write
+ *
+ * Description:
+ *   Add a message to the circular buffer of the current CPU.  The message
+ *   is dropped and counted if it does not fit.  May be called from any
+ *   context.
+ *
+ * Input Parameters:
+ *   buffer - The message to add
+ *   buflen - The length of the message
+ *
+ * Returned Value:
+ *   True if the message was accepted, false if the drain thread is not
+ *   running and the caller should emit the message synchronously.
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_SYSLOG_ASYNC
+bool syslog_async_write(FAR const char *buffer, size_t buflen);
+#endif
+
+/****************************************************************************
+ * Name: syslog_async_flush
+ *
+ * Description:
+ *   Move everything in the per-CPU buffers to the SYSLOG channel from the
+ *   caller's context, using the force() method of the channel.
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_SYSLOG_ASYNC
+void syslog_async_flush(void);
+#endif
+
 /****************************************************************************
  * Name: syslog_putc
  *
@@ -0,0 +1,447 @@
+/****************************************************************************
+ * drivers/syslog/syslog_async.c
+ *
+ *   Copyright (C) 2020 Gregory Nutt. All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in
+ *    the documentation and/or other materials provided with the
+ *    distribution.
+ * 3. Neither the name NuttX nor the names of its contributors may be
+ *    used to endorse or promote products derived from this software
+ *    without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+ * FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE
+ * COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+ * INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,
+ * BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS
+ * OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED
+ * AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ * LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN
+ * ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ *
+ ****************************************************************************/
+
+/****************************************************************************
+ * Included Files
+ ****************************************************************************/
+
+#include <nuttx/config.h>
+
+#include <sys/types.h>
+#include <stdint.h>
+#include <stdbool.h>
+#include <stdio.h>
+#include <string.h>
+#include <assert.h>
+#include <errno.h>
+
+#include <nuttx/arch.h>
+#include <nuttx/irq.h>
+#include <nuttx/kthread.h>
+#include <nuttx/semaphore.h>
+#include <nuttx/spinlock.h>
+#include <nuttx/syslog/syslog.h>
+
+#include "syslog.h"
+
+#ifdef CONFIG_SYSLOG_ASYNC
+
+/****************************************************************************
+ * Pre-processor Definitions
+ ****************************************************************************/
+
+#ifdef CONFIG_SMP
+#  define SYSLOG_NCPUS        CONFIG_SMP_NCPUS
+#  define syslog_this_cpu()   up_cpu_index()
+#else
+#  define SYSLOG_NCPUS        1
+#  define syslog_this_cpu()   (0)
+#endif
+
+/* Memory barriers are only needed if other CPUs consume the buffers */
+
+#ifndef SP_DMB
+#  define SP_DMB()
+#endif
+
+/* Size of the batches that are passed to the channel */
+
+#define SYSLOG_ASYNC_BATCH    64
+
+/****************************************************************************
+ * Private Types
+ ****************************************************************************/
+
+/* One circular buffer per CPU.  Each buffer has a single producer, the CPU
+ * that owns it, so messages are added with local interrupts disabled but
+ * without any lock.  ab_head is only modified by the producer and ab_tail
+ * is only modified by the consumers, which are serialized by a critical
+ * section.
+ */
+
+struct syslog_asyncbuf_s
+{
+  volatile unsigned int ab_head;
+  volatile unsigned int ab_tail;
+  volatile uint32_t ab_dropped;       /* Bytes discarded because full */
+  uint32_t ab_reported;               /* Dropped bytes already reported */
+  char ab_buffer[CONFIG_SYSLOG_ASYNC_BUFSIZE];
+};
+
+struct syslog_async_s
+{
+  volatile bool started;              /* True: The drain thread runs */
+  volatile bool waiting;              /* True: The drain thread sleeps */
+  sem_t sem;                          /* Wakes up the drain thread */
+  struct syslog_asyncbuf_s buf[SYSLOG_NCPUS];
+};
+
+/****************************************************************************
+ * Private Data
+ ****************************************************************************/
+
+static struct syslog_async_s g_syslog_async =
+{
+  false, false, SEM_INITIALIZER(0)
+};
+
+/****************************************************************************
+ * Private Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: syslog_async_length
+ *
+ * Description:
+ *   Return the number of bytes in the circular buffer.
+ *
+ ****************************************************************************/
+
+static unsigned int syslog_async_length(FAR struct syslog_asyncbuf_s *buf)
+{
+  unsigned int head = buf->ab_head;
+  unsigned int tail = buf->ab_tail;
+
+  if (tail > head)
+    {
+      head += CONFIG_SYSLOG_ASYNC_BUFSIZE;
+    }
+
+  return head - tail;
+}
+
+/****************************************************************************
+ * Name: syslog_async_remove
+ *
+ * Description:
+ *   Remove up to buflen bytes from the circular buffer of one CPU.  If
+ *   bytes were dropped since the last call, a drop notice is returned in
+ *   their place.
+ *
+ * Returned Value:
+ *   The number of bytes returned in buffer.
+ *
+ ****************************************************************************/
+
+static size_t syslog_async_remove(FAR struct syslog_asyncbuf_s *buf,
+                                  FAR char *buffer, size_t buflen)
+{
+  irqstate_t flags;
+  unsigned int tail;
+  uint32_t dropped;
+  size_t nread = 0;
+
+  /* Consumers may be the drain thread and syslog_flush() */
+
+  flags = enter_critical_section();
+
+  dropped = buf->ab_dropped;
+  if (dropped != buf->ab_reported)
+    {
+      nread = snprintf(buffer, buflen, "\n[syslog: %lu bytes dropped]\n",
+                       (unsigned long)(dropped - buf->ab_reported));
+      buf->ab_reported = dropped;
+
+      leave_critical_section(flags);
+      return nread < buflen ? nread : buflen - 1;
+    }
+
+  tail = buf->ab_tail;
+  while (nread < buflen && tail != buf->ab_head)
+    {
+      buffer[nread++] = buf->ab_buffer[tail];
+      if (++tail >= CONFIG_SYSLOG_ASYNC_BUFSIZE)
+        {
+          tail = 0;
+        }
+    }
+
+  /* Release the space only after the data was read */
+
+  SP_DMB();
+  buf->ab_tail = tail;
+
+  leave_critical_section(flags);
+  return nread;
+}
+
+/****************************************************************************
+ * Name: syslog_async_output
+ *
+ * Description:
+ *   Pass a batch of bytes to the current SYSLOG channel.
+ *
+ ****************************************************************************/
+
+static void syslog_async_output(FAR const char *buffer, size_t buflen,
+                                bool force)
+{
+  size_t i;
+
+  DEBUGASSERT(g_syslog_channel != NULL);
+
+#ifdef CONFIG_SYSLOG_WRITE
+  if (!force && g_syslog_channel->sc_write != NULL)
+    {
+      g_syslog_channel->sc_write(buffer, buflen);
+      return;
+    }
+#endif
+
+  for (i = 0; i < buflen; i++)
+    {
+      if (force)
+        {
+          g_syslog_channel->sc_force(buffer[i]);
+        }
+      else
+        {
+          g_syslog_channel->sc_putc(buffer[i]);
+        }
+    }
+}
+
+/****************************************************************************
+ * Name: syslog_async_drain
+ *
+ * Description:
+ *   Move everything in the per-CPU buffers to the current SYSLOG channel.
+ *
+ * Returned Value:
+ *   True if any data was moved.
+ *
+ ****************************************************************************/
+
+static bool syslog_async_drain(FAR char *buffer, size_t buflen, bool force)
+{
+  bool moved = false;
+  size_t nread;
+  int cpu;
+
+  for (cpu = 0; cpu < SYSLOG_NCPUS; cpu++)
+    {
+      while ((nread = syslog_async_remove(&g_syslog_async.buf[cpu],
+                                          buffer, buflen)) > 0)
+        {
+          syslog_async_output(buffer, nread, force);
+          moved = true;
+        }
+    }
+
+  return moved;
+}
+
+/****************************************************************************
+ * Name: syslog_async_thread
+ *
+ * Description:
+ *   Drain the per-CPU buffers to the SYSLOG channel.  Sleep until new data
+ *   is added when all of them are empty.
+ *
+ ****************************************************************************/
+
+static int syslog_async_thread(int argc, FAR char *argv[])
+{
+  static char buffer[SYSLOG_ASYNC_BATCH];
+  int cpu;
+
+  for (; ; )
+    {
+      if (syslog_async_drain(buffer, SYSLOG_ASYNC_BATCH, false))
+        {
+          continue;
+        }
+
+      /* Announce that we are about to sleep, then check once more so that
+       * data added by a producer that did not see the flag is not missed.
+       */
+
+      g_syslog_async.waiting = true;
+      SP_DMB();
+
+      for (cpu = 0; cpu < SYSLOG_NCPUS; cpu++)
+        {
+          if (syslog_async_length(&g_syslog_async.buf[cpu]) > 0 ||
+              g_syslog_async.buf[cpu].ab_dropped !=
+              g_syslog_async.buf[cpu].ab_reported)
+            {
+              break;
+            }
+        }
+
+      if (cpu < SYSLOG_NCPUS)
+        {
+          g_syslog_async.waiting = false;
+          continue;
+        }
+
+      nxsem_wait(&g_syslog_async.sem);
+    }
+
+  return OK;
+}
+
+/****************************************************************************
+ * Public Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: syslog_async_start
+ *
+ * Description:
+ *   Start the low priority kernel thread that drains the per-CPU SYSLOG
+ *   buffers.  Until it runs, SYSLOG output is emitted synchronously.
+ *
+ * Returned Value:
+ *   Zero (OK) is returned on success; a negated errno value is returned on
+ *   any failure.
+ *
+ ****************************************************************************/
+
+int syslog_async_start(void)
+{
+  int ret;
+
+  if (g_syslog_async.started)
+    {
+      return OK;
+    }
+
+  /* The semaphore is used for signaling and, hence, should not have
+   * priority inheritance enabled.
+   */
+
+  nxsem_setprotocol(&g_syslog_async.sem, SEM_PRIO_NONE);
+
+  ret = kthread_create("syslog", CONFIG_SYSLOG_ASYNC_PRIORITY,
+                       CONFIG_SYSLOG_ASYNC_STACKSIZE,
+                       (main_t)syslog_async_thread, NULL);
+  if (ret < 0)
+    {
+      return ret;
+    }
+
+  g_syslog_async.started = true;
+  return OK;
+}
+
+/****************************************************************************
+ * Name: syslog_async_write
+ *
+ * Description:
+ *   Add a message to the circular buffer of the current CPU and wake up the
+ *   drain thread.  The message is added as a whole or, if it does not fit,
+ *   dropped and counted.  This never blocks and may be called from any
+ *   context, including interrupt handlers.
+ *
+ * Input Parameters:
+ *   buffer - The message to add
+ *   buflen - The length of the message
+ *
+ * Returned Value:
+ *   True if the message was accepted, false if the drain thread is not
+ *   running and the caller should emit the message synchronously.
+ *
+ ****************************************************************************/
+
+bool syslog_async_write(FAR const char *buffer, size_t buflen)
+{
+  FAR struct syslog_asyncbuf_s *buf;
+  irqstate_t flags;
+  unsigned int head;
+
+  if (!g_syslog_async.started)
+    {
+      return false;
+    }
+
+  /* Disabling local interrupts is sufficient:  No other CPU adds data to
+   * this CPU's buffer.
+   */
+
+  flags = up_irq_save();
+  buf   = &g_syslog_async.buf[syslog_this_cpu()];
+
+  if (syslog_async_length(buf) + buflen >= CONFIG_SYSLOG_ASYNC_BUFSIZE)
+    {
+      buf->ab_dropped += buflen;
+      up_irq_restore(flags);
+      return true;
+    }
+
+  head = buf->ab_head;
+  while (buflen-- > 0)
+    {
+      buf->ab_buffer[head] = *buffer++;
+      if (++head >= CONFIG_SYSLOG_ASYNC_BUFSIZE)
+        {
+          head = 0;
+        }
+    }
+
+  /* Publish the data only after it was written */
+
+  SP_DMB();
+  buf->ab_head = head;
+  up_irq_restore(flags);
+
+  /* Wake up the drain thread if it is waiting for data */
+
+  SP_DMB();
+  if (g_syslog_async.waiting)
+    {
+      g_syslog_async.waiting = false;
+      nxsem_post(&g_syslog_async.sem);
+    }
+
+  return true;
+}
+
+/****************************************************************************
+ * Name: syslog_async_flush
+ *
+ * Description:
+ *   Move everything in the per-CPU buffers to the SYSLOG channel from the
+ *   caller's context, using the force() method of the channel.
+ *
+ ****************************************************************************/
+
+void syslog_async_flush(void)
+{
+  char buffer[SYSLOG_ASYNC_BATCH];
+
+  syslog_async_drain(buffer, SYSLOG_ASYNC_BATCH, true);
+}
+
+#endif /* CONFIG_SYSLOG_ASYNC */
@@ -81,6 +81,12 @@ int syslog_flush(void)
 {
   DEBUGASSERT(g_syslog_channel != NULL);
 
+#ifdef CONFIG_SYSLOG_ASYNC
+  /* Drain the per-CPU buffers of the asynchronous output */
+
+  syslog_async_flush();
+#endif
+
 #ifdef CONFIG_SYSLOG_INTBUFFER
   /* Flush any characters that may have been added to the interrupt
    * buffer.
@@ -116,6 +116,15 @@ int syslog_initialize(enum syslog_init_e phase)
     }
 #endif
 
+#ifdef CONFIG_SYSLOG_ASYNC
+  if (phase == SYSLOG_INIT_LATE && ret == OK)
+    {
+      /* Start draining the asynchronous output buffers */
+
+      ret = syslog_async_start();
+    }
+#endif
+
   return ret;
 }
 
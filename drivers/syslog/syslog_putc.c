@@ -70,6 +70,17 @@
 
 int syslog_putc(int ch)
 {
+#ifdef CONFIG_SYSLOG_ASYNC
+  char c = (char)ch;
+
+  /* Defer the output to the drain thread if it is running */
+
+  if (syslog_async_write(&c, 1))
+    {
+      return ch;
+    }
+#endif
+
   DEBUGASSERT(g_syslog_channel != NULL);
 
   /* Is this an attempt to do SYSLOG output from an interrupt handler? */
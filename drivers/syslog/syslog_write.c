@@ -130,6 +130,15 @@ static ssize_t syslog_default_write(FAR const char *buffer, size_t buflen)
 
 ssize_t syslog_write(FAR const char *buffer, size_t buflen)
 {
+#ifdef CONFIG_SYSLOG_ASYNC
+  /* Defer the output to the drain thread if it is running */
+
+  if (syslog_async_write(buffer, buflen))
+    {
+      return buflen;
+    }
+#endif
+
 #ifdef CONFIG_SYSLOG_INTBUFFER
   if (!up_interrupt_context() && !sched_idletask())
     {
@@ -0,0 +1,648 @@
+/****************************************************************************
+ * drivers/timers/hrtimer.c
+ *
+ *   Copyright (C) 2020 Gregory Nutt. All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in
+ *    the documentation and/or other materials provided with the
+ *    distribution.
+ * 3. Neither the name NuttX nor the names of its contributors may be
+ *    used to endorse or promote products derived from this software
+ *    without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+ * FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE
+ * COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+ * INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,
+ * BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS
+ * OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED
+ * AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ * LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN
+ * ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ *
+ ****************************************************************************/
+
+/****************************************************************************
+ * Included Files
+ ****************************************************************************/
+
+#include <nuttx/config.h>
+
+#include <sys/types.h>
+#include <stdint.h>
+#include <stdbool.h>
+#include <string.h>
+#include <time.h>
+#include <assert.h>
+#include <errno.h>
+#include <debug.h>
+
+#include <nuttx/irq.h>
+#include <nuttx/clock.h>
+#include <nuttx/kthread.h>
+#include <nuttx/semaphore.h>
+#include <nuttx/timers/oneshot.h>
+#include <nuttx/timers/hrtimer.h>
+
+#ifdef CONFIG_HRTIMER
+
+/****************************************************************************
+ * Pre-processor Definitions
+ ****************************************************************************/
+
+#ifdef CONFIG_HRTIMER_THREAD
+#  ifndef CONFIG_HRTIMER_THREAD_PRIORITY
+#    define CONFIG_HRTIMER_THREAD_PRIORITY 224
+#  endif
+#  ifndef CONFIG_HRTIMER_THREAD_STACKSIZE
+#    define CONFIG_HRTIMER_THREAD_STACKSIZE 2048
+#  endif
+#endif
+
+/* The shortest delay programmed into the oneshot timer.  Timers that are
+ * already due are handled after this delay.
+ */
+
+#define HRTIMER_MINDELAY_NSEC 1000
+
+/****************************************************************************
+ * Private Types
+ ****************************************************************************/
+
+struct hrtimer_dev_s
+{
+  FAR struct oneshot_lowerhalf_s *lower; /* The oneshot timer */
+  FAR struct hrtimer_s *head;            /* Active timers, earliest first */
+  struct timespec maxdelay;              /* Longest oneshot delay */
+#ifdef CONFIG_HRTIMER_THREAD
+  FAR struct hrtimer_s *qhead;           /* Queued thread callbacks */
+  FAR struct hrtimer_s *qtail;
+  sem_t qsem;                            /* Wakes up the hrtimer thread */
+#endif
+};
+
+/****************************************************************************
+ * Private Function Prototypes
+ ****************************************************************************/
+
+static void hrtimer_expire(FAR struct oneshot_lowerhalf_s *lower,
+                           FAR void *arg);
+
+/****************************************************************************
+ * Private Data
+ ****************************************************************************/
+
+static struct hrtimer_dev_s g_hrtimer;
+
+/****************************************************************************
+ * Private Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: hrtimer_compare
+ *
+ * Description:
+ *   Return a negative value, zero or a positive value if ts1 is before,
+ *   equal to or after ts2.
+ *
+ ****************************************************************************/
+
+static int hrtimer_compare(FAR const struct timespec *ts1,
+                           FAR const struct timespec *ts2)
+{
+  if (ts1->tv_sec != ts2->tv_sec)
+    {
+      return ts1->tv_sec < ts2->tv_sec ? -1 : 1;
+    }
+
+  if (ts1->tv_nsec != ts2->tv_nsec)
+    {
+      return ts1->tv_nsec < ts2->tv_nsec ? -1 : 1;
+    }
+
+  return 0;
+}
+
+/****************************************************************************
+ * Name: hrtimer_insert
+ *
+ * Description:
+ *   Insert a timer into the list of active timers.  The list is ordered by
+ *   expiration time; timers with the same expiration time keep the order in
+ *   which they were started.
+ *
+ * Assumptions:
+ *   Called in a critical section.
+ *
+ ****************************************************************************/
+
+static void hrtimer_insert(FAR struct hrtimer_s *timer)
+{
+  FAR struct hrtimer_s *prev = NULL;
+  FAR struct hrtimer_s *curr;
+
+  for (curr = g_hrtimer.head;
+       curr != NULL && hrtimer_compare(&curr->expiry, &timer->expiry) <= 0;
+       curr = curr->flink)
+    {
+      prev = curr;
+    }
+
+  timer->flink = curr;
+  if (prev == NULL)
+    {
+      g_hrtimer.head = timer;
+    }
+  else
+    {
+      prev->flink = timer;
+    }
+
+  timer->active = true;
+}
+
+/****************************************************************************
+ * Name: hrtimer_remove
+ *
+ * Description:
+ *   Remove a timer from the list of active timers.
+ *
+ * Assumptions:
+ *   Called in a critical section.
+ *
+ ****************************************************************************/
+
+static void hrtimer_remove(FAR struct hrtimer_s *timer)
+{
+  FAR struct hrtimer_s *prev = NULL;
+  FAR struct hrtimer_s *curr;
+
+  for (curr = g_hrtimer.head; curr != NULL; curr = curr->flink)
+    {
+      if (curr == timer)
+        {
+          if (prev == NULL)
+            {
+              g_hrtimer.head = curr->flink;
+            }
+          else
+            {
+              prev->flink = curr->flink;
+            }
+
+          break;
+        }
+
+      prev = curr;
+    }
+
+  timer->flink  = NULL;
+  timer->active = false;
+}
+
+/****************************************************************************
+ * Name: hrtimer_reprogram
+ *
+ * Description:
+ *   Program the oneshot timer for the earliest active timer.  A delay
+ *   longer than the oneshot timer supports is split into several steps.
+ *
+ * Assumptions:
+ *   Called in a critical section.
+ *
+ ****************************************************************************/
+
+static void hrtimer_reprogram(void)
+{
+  FAR struct oneshot_lowerhalf_s *lower = g_hrtimer.lower;
+  struct timespec delay;
+  struct timespec now;
+
+  ONESHOT_CANCEL(lower, &delay);
+
+  if (g_hrtimer.head == NULL)
+    {
+      return;
+    }
+
+  ONESHOT_CURRENT(lower, &now);
+  clock_timespec_subtract(&g_hrtimer.head->expiry, &now, &delay);
+
+  if (delay.tv_sec == 0 && delay.tv_nsec < HRTIMER_MINDELAY_NSEC)
+    {
+      delay.tv_nsec = HRTIMER_MINDELAY_NSEC;
+    }
+  else if (hrtimer_compare(&delay, &g_hrtimer.maxdelay) > 0)
+    {
+      delay = g_hrtimer.maxdelay;
+    }
+
+  ONESHOT_START(lower, hrtimer_expire, NULL, &delay);
+}
+
+/****************************************************************************
+ * Name: hrtimer_expire
+ *
+ * Description:
+ *   The oneshot timer expired.  Run or queue the callbacks of all timers
+ *   that are due, re-arm the periodic ones and program the next expiration.
+ *
+ * Assumptions:
+ *   Runs in the context of the oneshot timer interrupt.
+ *
+ ****************************************************************************/
+
+static void hrtimer_expire(FAR struct oneshot_lowerhalf_s *lower,
+                           FAR void *arg)
+{
+  FAR struct hrtimer_s *timer;
+  struct timespec now;
+  irqstate_t flags;
+#ifdef CONFIG_HRTIMER_THREAD
+  bool post = false;
+#endif
+
+  flags = enter_critical_section();
+  ONESHOT_CURRENT(lower, &now);
+
+  while ((timer = g_hrtimer.head) != NULL &&
+         hrtimer_compare(&timer->expiry, &now) <= 0)
+    {
+      g_hrtimer.head = timer->flink;
+      timer->flink   = NULL;
+      timer->active  = false;
+      timer->overrun = 0;
+
+      /* Re-arm a periodic timer first so that the callback may cancel it.
+       * Periods that were missed completely are counted, not replayed.
+       */
+
+      if (timer->period.tv_sec > 0 || timer->period.tv_nsec > 0)
+        {
+          do
+            {
+              clock_timespec_add(&timer->expiry, &timer->period,
+                                 &timer->expiry);
+              timer->overrun++;
+            }
+          while (hrtimer_compare(&timer->expiry, &now) <= 0);
+
+          timer->overrun--;
+          hrtimer_insert(timer);
+        }
+
+#ifdef CONFIG_HRTIMER_THREAD
+      if ((timer->flags & HRTIMER_FLAG_THREAD) != 0)
+        {
+          /* Queue the callback unless the previous one has not run yet */
+
+          if (!timer->queued)
+            {
+              timer->queued = true;
+              timer->qlink  = NULL;
+
+              if (g_hrtimer.qtail == NULL)
+                {
+                  g_hrtimer.qhead = timer;
+                }
+              else
+                {
+                  g_hrtimer.qtail->qlink = timer;
+                }
+
+              g_hrtimer.qtail = timer;
+              post = true;
+            }
+
+          continue;
+        }
+#endif
+
+      timer->callback(timer, timer->arg);
+    }
+
+  hrtimer_reprogram();
+
+#ifdef CONFIG_HRTIMER_THREAD
+  if (post)
+    {
+      nxsem_post(&g_hrtimer.qsem);
+    }
+#endif
+
+  leave_critical_section(flags);
+}
+
+/****************************************************************************
+ * Name: hrtimer_thread
+ *
+ * Description:
+ *   Run the callbacks of the timers created with HRTIMER_FLAG_THREAD.
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_HRTIMER_THREAD
+static int hrtimer_thread(int argc, FAR char *argv[])
+{
+  FAR struct hrtimer_s *timer;
+  hrtimer_callback_t callback;
+  FAR void *cbarg;
+  irqstate_t flags;
+
+  for (; ; )
+    {
+      nxsem_wait_uninterruptible(&g_hrtimer.qsem);
+
+      for (; ; )
+        {
+          flags = enter_critical_section();
+
+          timer = g_hrtimer.qhead;
+          if (timer == NULL)
+            {
+              leave_critical_section(flags);
+              break;
+            }
+
+          g_hrtimer.qhead = timer->qlink;
+          if (g_hrtimer.qhead == NULL)
+            {
+              g_hrtimer.qtail = NULL;
+            }
+
+          timer->qlink  = NULL;
+          timer->queued = false;
+          callback      = timer->callback;
+          cbarg         = timer->arg;
+
+          leave_critical_section(flags);
+
+          callback(timer, cbarg);
+        }
+    }
+
+  return OK;
+}
+#endif
+
+/****************************************************************************
+ * Public Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: hrtimer_initialize
+ *
+ * Description:
+ *   Bind the high resolution timers to a oneshot timer.  All high
+ *   resolution timers are multiplexed over this one timer.
+ *
+ ****************************************************************************/
+
+int hrtimer_initialize(FAR struct oneshot_lowerhalf_s *lower)
+{
+  struct timespec ts;
+  int ret;
+
+  DEBUGASSERT(lower != NULL && g_hrtimer.lower == NULL);
+
+  /* The time base of the timers is the current time of the oneshot */
+
+  ret = ONESHOT_CURRENT(lower, &ts);
+  if (ret < 0)
+    {
+      tmrerr("ERROR: The oneshot timer has no current time: %d\n", ret);
+      return ret;
+    }
+
+  ret = ONESHOT_MAX_DELAY(lower, &g_hrtimer.maxdelay);
+  if (ret < 0)
+    {
+      return ret;
+    }
+
+#ifdef CONFIG_HRTIMER_THREAD
+  nxsem_init(&g_hrtimer.qsem, 0, 0);
+  nxsem_setprotocol(&g_hrtimer.qsem, SEM_PRIO_NONE);
+
+  ret = kthread_create("hrtimer", CONFIG_HRTIMER_THREAD_PRIORITY,
+                       CONFIG_HRTIMER_THREAD_STACKSIZE,
+                       (main_t)hrtimer_thread, NULL);
+  if (ret < 0)
+    {
+      tmrerr("ERROR: Failed to start the hrtimer thread: %d\n", ret);
+      nxsem_destroy(&g_hrtimer.qsem);
+      return ret;
+    }
+#endif
+
+  g_hrtimer.lower = lower;
+  return OK;
+}
+
+/****************************************************************************
+ * Name: hrtimer_gettime
+ *
+ * Description:
+ *   Return the current time of the high resolution time base.
+ *
+ ****************************************************************************/
+
+int hrtimer_gettime(FAR struct timespec *ts)
+{
+  if (g_hrtimer.lower == NULL)
+    {
+      return -ENODEV;
+    }
+
+  return ONESHOT_CURRENT(g_hrtimer.lower, ts);
+}
+
+/****************************************************************************
+ * Name: hrtimer_init
+ *
+ * Description:
+ *   Initialize a high resolution timer.  The timer is not started.
+ *
+ ****************************************************************************/
+
+void hrtimer_init(FAR struct hrtimer_s *timer, hrtimer_callback_t callback,
+                  FAR void *arg, uint8_t flags)
+{
+  DEBUGASSERT(timer != NULL && callback != NULL);
+
+  memset(timer, 0, sizeof(struct hrtimer_s));
+  timer->callback = callback;
+  timer->arg      = arg;
+  timer->flags    = flags;
+}
+
+/****************************************************************************
+ * Name: hrtimer_start
+ *
+ * Description:
+ *   Start, or restart, a high resolution timer.
+ *
+ ****************************************************************************/
+
+int hrtimer_start(FAR struct hrtimer_s *timer,
+                  FAR const struct timespec *delay,
+                  FAR const struct timespec *period)
+{
+  struct timespec now;
+  irqstate_t flags;
+
+  DEBUGASSERT(timer != NULL && delay != NULL);
+
+  if (g_hrtimer.lower == NULL)
+    {
+      return -ENODEV;
+    }
+
+  if (delay->tv_nsec < 0 || delay->tv_nsec >= NSEC_PER_SEC ||
+      (period != NULL &&
+       (period->tv_nsec < 0 || period->tv_nsec >= NSEC_PER_SEC)))
+    {
+      return -EINVAL;
+    }
+
+  flags = enter_critical_section();
+
+  if (timer->active)
+    {
+      hrtimer_remove(timer);
+    }
+
+  ONESHOT_CURRENT(g_hrtimer.lower, &now);
+  clock_timespec_add(&now, delay, &timer->expiry);
+
+  if (period != NULL)
+    {
+      timer->period = *period;
+    }
+  else
+    {
+      timer->period.tv_sec  = 0;
+      timer->period.tv_nsec = 0;
+    }
+
+  timer->overrun = 0;
+  hrtimer_insert(timer);
+
+  /* Reprogram the oneshot only if the new timer is the earliest */
+
+  if (g_hrtimer.head == timer)
+    {
+      hrtimer_reprogram();
+    }
+
+  leave_critical_section(flags);
+  return OK;
+}
+
+/****************************************************************************
+ * Name: hrtimer_cancel
+ *
+ * Description:
+ *   Stop a high resolution timer and discard any queued callback.
+ *
+ ****************************************************************************/
+
+int hrtimer_cancel(FAR struct hrtimer_s *timer)
+{
+  irqstate_t flags;
+  bool first;
+
+  DEBUGASSERT(timer != NULL);
+
+  flags = enter_critical_section();
+
+  if (timer->active)
+    {
+      first = (g_hrtimer.head == timer);
+      hrtimer_remove(timer);
+
+      if (first)
+        {
+          hrtimer_reprogram();
+        }
+    }
+
+#ifdef CONFIG_HRTIMER_THREAD
+  if (timer->queued)
+    {
+      FAR struct hrtimer_s *prev = NULL;
+      FAR struct hrtimer_s *curr;
+
+      for (curr = g_hrtimer.qhead; curr != NULL; curr = curr->qlink)
+        {
+          if (curr == timer)
+            {
+              if (prev == NULL)
+                {
+                  g_hrtimer.qhead = curr->qlink;
+                }
+              else
+                {
+                  prev->qlink = curr->qlink;
+                }
+
+              if (g_hrtimer.qtail == curr)
+                {
+                  g_hrtimer.qtail = prev;
+                }
+
+              break;
+            }
+
+          prev = curr;
+        }
+
+      timer->qlink  = NULL;
+      timer->queued = false;
+    }
+#endif
+
+  leave_critical_section(flags);
+  return OK;
+}
+
+/****************************************************************************
+ * Name: hrtimer_remaining
+ *
+ * Description:
+ *   Return the time until the next expiration of a high resolution timer.
+ *
+ ****************************************************************************/
+
+int hrtimer_remaining(FAR struct hrtimer_s *timer, FAR struct timespec *ts)
+{
+  struct timespec now;
+  irqstate_t flags;
+  int ret = -EINVAL;
+
+  DEBUGASSERT(timer != NULL && ts != NULL);
+
+  flags = enter_critical_section();
+
+  if (timer->active)
+    {
+      ONESHOT_CURRENT(g_hrtimer.lower, &now);
+      clock_timespec_subtract(&timer->expiry, &now, ts);
+      ret = OK;
+    }
+
+  leave_critical_section(flags);
+  return ret;
+}
+
+#endif /* CONFIG_HRTIMER */
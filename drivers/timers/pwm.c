@@ -55,6 +55,10 @@
 #include <nuttx/semaphore.h>
 #include <nuttx/fs/fs.h>
 #include <nuttx/timers/pwm.h>
+#ifdef CONFIG_PWM_STREAM
+#  include <nuttx/clock.h>
+#  include <nuttx/timers/hrtimer.h>
+#endif
 
 #include <nuttx/irq.h>
 
@@ -79,6 +83,21 @@ struct pwm_upperhalf_s
 #endif
   struct pwm_info_s info;     /* Pulsed output characteristics */
   FAR struct pwm_lowerhalf_s *dev;  /* lower-half state */
+#ifdef CONFIG_PWM_STREAM
+  struct hrtimer_s  hrtimer;  /* Paces the streamed frames */
+  uint32_t          rate;     /* Frames per second (0: not streaming) */
+  volatile uint16_t head;     /* Index of the next frame to queue */
+  volatile uint16_t tail;     /* Index of the next frame to apply */
+  volatile bool     txwaiting; /* True: A writer waits for a free frame */
+  sem_t             txsem;    /* Used to wait for a free frame */
+
+  /* The queue of streamed frames.  One slot is always left empty so that
+   * a full queue can be told from an empty one.
+   */
+
+  ub16_t frames[CONFIG_PWM_STREAM_NFRAMES + 1]
+               [PWM_STREAM_FRAMESIZE / sizeof(ub16_t)];
+#endif
 };
 
 /****************************************************************************
@@ -96,6 +115,12 @@ static ssize_t pwm_write(FAR struct file *filep, FAR const char *buffer,
                          size_t buflen);
 static int     pwm_start(FAR struct pwm_upperhalf_s *upper,
                          unsigned int oflags);
+#ifdef CONFIG_PWM_STREAM
+static void    pwm_streamnext(FAR struct hrtimer_s *timer, FAR void *arg);
+static int     pwm_streamstart(FAR struct pwm_upperhalf_s *upper);
+static void    pwm_streamstop(FAR struct pwm_upperhalf_s *upper,
+                              bool flush);
+#endif
 static int     pwm_ioctl(FAR struct file *filep, int cmd, unsigned long arg);
 
 /****************************************************************************
@@ -258,6 +283,11 @@ static int pwm_close(FAR struct file *filep)
 
       /* Disable the PWM device */
 
+#ifdef CONFIG_PWM_STREAM
+      pwm_streamstop(upper, true);
+      upper->rate = 0;
+#endif
+
       DEBUGASSERT(lower->ops->shutdown != NULL);
       pwminfo("calling shutdown: %d\n");
 
@@ -291,14 +321,77 @@ static ssize_t pwm_read(FAR struct file *filep, FAR char *buffer,
  * Name: pwm_write
  *
  * Description:
- *   A dummy write method.  This is provided only to satisfy the VFS layer.
+ *   Queue frames of duty cycles to be streamed to the output (see
+ *   PWMIOC_SETSTREAMRATE).  Only whole frames are accepted.  Without
+ *   CONFIG_PWM_STREAM, this is a dummy method that only satisfies the VFS
+ *   layer.
  *
  ****************************************************************************/
 
 static ssize_t pwm_write(FAR struct file *filep, FAR const char *buffer,
                          size_t buflen)
 {
+#ifdef CONFIG_PWM_STREAM
+  FAR struct inode           *inode = filep->f_inode;
+  FAR struct pwm_upperhalf_s *upper = inode->i_private;
+  irqstate_t                  flags;
+  size_t                      nwritten = 0;
+  uint16_t                    next;
+  int                         ret;
+
+  if (buflen < PWM_STREAM_FRAMESIZE)
+    {
+      return -EINVAL;
+    }
+
+  while (buflen - nwritten >= PWM_STREAM_FRAMESIZE)
+    {
+      next = upper->head + 1;
+      if (next > CONFIG_PWM_STREAM_NFRAMES)
+        {
+          next = 0;
+        }
+
+      /* Wait for the timer to free a frame if the queue is full */
+
+      flags = enter_critical_section();
+      if (next == upper->tail)
+        {
+          if ((filep->f_oflags & O_NONBLOCK) != 0)
+            {
+              leave_critical_section(flags);
+              return nwritten > 0 ? (ssize_t)nwritten : -EAGAIN;
+            }
+
+          upper->txwaiting = true;
+          ret = nxsem_wait(&upper->txsem);
+          upper->txwaiting = false;
+          leave_critical_section(flags);
+
+          if (ret < 0)
+            {
+              return nwritten > 0 ? (ssize_t)nwritten : ret;
+            }
+
+          continue;
+        }
+
+      leave_critical_section(flags);
+
+      /* Only the timer reads the frame at the tail, so the new frame can
+       * be filled in before it is published by advancing the head.
+       */
+
+      memcpy(upper->frames[upper->head], &buffer[nwritten],
+             PWM_STREAM_FRAMESIZE);
+      upper->head = next;
+      nwritten   += PWM_STREAM_FRAMESIZE;
+    }
+
+  return nwritten;
+#else
   return 0;
+#endif
 }
 
 /****************************************************************************
@@ -411,6 +504,120 @@ static int pwm_start(FAR struct pwm_upperhalf_s *upper, unsigned int oflags)
 }
 #endif
 
+/****************************************************************************
+ * Name: pwm_streamnext
+ *
+ * Description:
+ *   Apply the next queued frame of duty cycles.  Called from the high
+ *   resolution timer at the stream rate, so the lower half start() method
+ *   must be able to change the duty cycle from interrupt context.
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_PWM_STREAM
+static void pwm_streamnext(FAR struct hrtimer_s *timer, FAR void *arg)
+{
+  FAR struct pwm_upperhalf_s *upper = (FAR struct pwm_upperhalf_s *)arg;
+  FAR struct pwm_lowerhalf_s *lower = upper->dev;
+  FAR const ub16_t           *frame;
+  uint16_t                    tail = upper->tail;
+#ifdef CONFIG_PWM_MULTICHAN
+  int                         i;
+#endif
+
+  /* Hold the last duty cycle if the writer has fallen behind */
+
+  if (!upper->started || tail == upper->head)
+    {
+      return;
+    }
+
+  frame = upper->frames[tail];
+#ifdef CONFIG_PWM_MULTICHAN
+  for (i = 0; i < CONFIG_PWM_NCHANNELS; i++)
+    {
+      upper->info.channels[i].duty = frame[i];
+    }
+#else
+  upper->info.duty = frame[0];
+#endif
+
+  if (++tail > CONFIG_PWM_STREAM_NFRAMES)
+    {
+      tail = 0;
+    }
+
+  upper->tail = tail;
+
+  /* All channels of the frame are passed to the lower half at once */
+
+  lower->ops->start(lower, &upper->info);
+
+  if (upper->txwaiting)
+    {
+      upper->txwaiting = false;
+      nxsem_post(&upper->txsem);
+    }
+}
+
+/****************************************************************************
+ * Name: pwm_streamstart
+ *
+ * Description:
+ *   (Re-)start the frame timer if the output is started and a stream rate
+ *   is set.
+ *
+ ****************************************************************************/
+
+static int pwm_streamstart(FAR struct pwm_upperhalf_s *upper)
+{
+  struct timespec period;
+
+  if (!upper->started || upper->rate == 0)
+    {
+      return OK;
+    }
+
+  period.tv_sec  = 0;
+  period.tv_nsec = NSEC_PER_SEC / upper->rate;
+  if (period.tv_nsec == 0)
+    {
+      period.tv_nsec = 1;
+    }
+
+  return hrtimer_start(&upper->hrtimer, &period, &period);
+}
+
+/****************************************************************************
+ * Name: pwm_streamstop
+ *
+ * Description:
+ *   Stop the frame timer and, optionally, discard the queued frames.  A
+ *   writer blocked on a full queue is woken up.
+ *
+ ****************************************************************************/
+
+static void pwm_streamstop(FAR struct pwm_upperhalf_s *upper, bool flush)
+{
+  irqstate_t flags;
+
+  hrtimer_cancel(&upper->hrtimer);
+
+  if (flush)
+    {
+      flags = enter_critical_section();
+      upper->tail = upper->head;
+      if (upper->txwaiting)
+        {
+          upper->txwaiting = false;
+          nxsem_post(&upper->txsem);
+        }
+
+      leave_critical_section(flags);
+    }
+}
+#endif
+
 /****************************************************************************
  * Name: pwm_ioctl
  *
@@ -506,6 +713,12 @@ static int pwm_ioctl(FAR struct file *filep, int cmd, unsigned long arg)
           /* Start the pulse train */
 
           ret = pwm_start(upper, filep->f_oflags);
+#ifdef CONFIG_PWM_STREAM
+          if (ret == OK)
+            {
+              ret = pwm_streamstart(upper);
+            }
+#endif
         }
         break;
 
@@ -521,6 +734,9 @@ static int pwm_ioctl(FAR struct file *filep, int cmd, unsigned long arg)
 
           if (upper->started)
             {
+#ifdef CONFIG_PWM_STREAM
+              pwm_streamstop(upper, false);
+#endif
               ret = lower->ops->stop(lower);
               upper->started = false;
 #ifdef CONFIG_PWM_PULSECOUNT
@@ -533,6 +749,36 @@ static int pwm_ioctl(FAR struct file *filep, int cmd, unsigned long arg)
         }
         break;
 
+#ifdef CONFIG_PWM_STREAM
+      /* PWMIOC_SETSTREAMRATE - Set the rate at which written frames are
+       *   applied to the output.  Zero stops streaming.
+       *
+       *   ioctl argument:  The number of frames per second.
+       */
+
+      case PWMIOC_SETSTREAMRATE:
+        {
+          pwminfo("PWMIOC_SETSTREAMRATE: %lu\n", arg);
+
+          if (arg > NSEC_PER_SEC)
+            {
+              ret = -EINVAL;
+              break;
+            }
+
+          upper->rate = (uint32_t)arg;
+          if (upper->rate == 0)
+            {
+              pwm_streamstop(upper, true);
+            }
+          else
+            {
+              ret = pwm_streamstart(upper);
+            }
+        }
+        break;
+#endif
+
       /* Any unrecognized IOCTL commands might be platform-specific ioctl commands */
 
       default:
@@ -602,6 +848,11 @@ int pwm_register(FAR const char *path, FAR struct pwm_lowerhalf_s *dev)
 
   nxsem_setprotocol(&upper->waitsem, SEM_PRIO_NONE);
 #endif
+#ifdef CONFIG_PWM_STREAM
+  nxsem_init(&upper->txsem, 0, 0);
+  nxsem_setprotocol(&upper->txsem, SEM_PRIO_NONE);
+  hrtimer_init(&upper->hrtimer, pwm_streamnext, upper, 0);
+#endif
 
   upper->dev = dev;
 
@@ -111,6 +111,16 @@
 #  define CONFIG_CDCECM_NINTERFACES 1
 #endif
 
+/* Number of bulk OUT and bulk IN requests */
+
+#ifndef CONFIG_CDCECM_NRDREQS
+#  define CONFIG_CDCECM_NRDREQS 4
+#endif
+
+#ifndef CONFIG_CDCECM_NWRREQS
+#  define CONFIG_CDCECM_NWRREQS 4
+#endif
+
 /* TX poll delay = 1 seconds. CLK_TCK is the number of clock ticks per second */
 
 #define CDCECM_WDDELAY   (1*CLK_TCK)
@@ -127,6 +137,14 @@
  * Private Types
  ****************************************************************************/
 
+/* Container to support a list of requests */
+
+struct cdcecm_req_s
+{
+  FAR struct cdcecm_req_s *flink;   /* Implements a singly linked list */
+  FAR struct usbdev_req_s *req;     /* The contained request */
+};
+
 /* The cdcecm_driver_s encapsulates all state information for a single hardware
  * interface
  */
@@ -145,11 +163,13 @@ struct cdcecm_driver_s
 
   uint8_t                      pktbuf[CONFIG_NET_ETH_PKTSIZE + CONFIG_NET_GUARDSIZE];
 
-  struct usbdev_req_s         *rdreq;       /* Single read request */
-  bool                         rxpending;   /* Packet available in rdreq */
+  struct cdcecm_req_s          rdreqs[CONFIG_CDCECM_NRDREQS];
+  sq_queue_t                   rxpending;   /* Completed read requests */
 
-  struct usbdev_req_s         *wrreq;       /* Single write request */
-  sem_t                        wrreq_idle;  /* Is the wrreq available? */
+  struct cdcecm_req_s          wrreqs[CONFIG_CDCECM_NWRREQS];
+  sq_queue_t                   txfree;      /* Available write requests */
+  sem_t                        wrreq_idle;  /* Counts the entries of txfree */
+  FAR struct cdcecm_req_s     *txreq;       /* Write request holding d_buf */
   bool                         txdone;      /* Did a write request complete? */
 
   /* Network device */
@@ -176,6 +196,8 @@ struct cdcecm_driver_s
 
 /* Common TX logic */
 
+static void cdcecm_txbuffer(FAR struct cdcecm_driver_s *self);
+static void cdcecm_txrelease(FAR struct cdcecm_driver_s *self);
 static int  cdcecm_transmit(FAR struct cdcecm_driver_s *priv);
 static int  cdcecm_txpoll(FAR struct net_driver_s *dev);
 
@@ -303,6 +325,84 @@ static const struct usb_devdesc_s g_devdesc =
  * Private Functions
  ****************************************************************************/
 
+/****************************************************************************
+ * Name: cdcecm_txbuffer
+ *
+ * Description:
+ *   Point d_buf at the buffer of a free write request so that the network
+ *   builds the next outgoing frame in place.  If all write requests are in
+ *   flight, d_buf falls back to pktbuf and cdcecm_transmit() will copy the
+ *   frame once a request has completed.
+ *
+ * Input Parameters:
+ *   self - Reference to the driver state structure
+ *
+ * Returned Value:
+ *   None
+ *
+ * Assumptions:
+ *   The network is locked.
+ *
+ ****************************************************************************/
+
+static void cdcecm_txbuffer(FAR struct cdcecm_driver_s *self)
+{
+  irqstate_t flags;
+
+  if (self->txreq == NULL && nxsem_trywait(&self->wrreq_idle) == OK)
+    {
+      flags = enter_critical_section();
+      self->txreq = (FAR struct cdcecm_req_s *)sq_remfirst(&self->txfree);
+      leave_critical_section(flags);
+
+      DEBUGASSERT(self->txreq != NULL);
+    }
+
+  if (self->txreq != NULL)
+    {
+      self->dev.d_buf = self->txreq->req->buf;
+    }
+  else
+    {
+      self->dev.d_buf = self->pktbuf;
+    }
+}
+
+/****************************************************************************
+ * Name: cdcecm_txrelease
+ *
+ * Description:
+ *   Return a write request obtained by cdcecm_txbuffer() that the poll
+ *   did not use, and point d_buf back at pktbuf.
+ *
+ * Input Parameters:
+ *   self - Reference to the driver state structure
+ *
+ * Returned Value:
+ *   None
+ *
+ * Assumptions:
+ *   The network is locked.
+ *
+ ****************************************************************************/
+
+static void cdcecm_txrelease(FAR struct cdcecm_driver_s *self)
+{
+  irqstate_t flags;
+
+  if (self->txreq != NULL)
+    {
+      flags = enter_critical_section();
+      sq_addlast((FAR sq_entry_t *)self->txreq, &self->txfree);
+      leave_critical_section(flags);
+
+      self->txreq = NULL;
+      nxsem_post(&self->wrreq_idle);
+    }
+
+  self->dev.d_buf = self->pktbuf;
+}
+
 /****************************************************************************
  * Name: cdcecm_transmit
  *
@@ -323,24 +423,55 @@ static const struct usb_devdesc_s g_devdesc =
 
 static int cdcecm_transmit(FAR struct cdcecm_driver_s *self)
 {
-  /* Wait until the USB device request for Ethernet frame transmissions becomes
-   * available.
-   */
+  FAR struct cdcecm_req_s *wrcontainer;
+  irqstate_t flags;
+  int ret;
+
+  /* Increment statistics */
+
+  NETDEV_TXPACKETS(self->dev);
 
-  while (nxsem_wait(&self->wrreq_idle) != OK)
+  if (self->txreq != NULL && self->dev.d_buf == self->txreq->req->buf)
     {
+      /* The frame was built in place in the buffer of a write request */
+
+      wrcontainer = self->txreq;
+      self->txreq = NULL;
     }
+  else
+    {
+      /* The frame is in pktbuf or in a read request buffer (a reply to a
+       * received frame).  Wait until a write request becomes available
+       * and copy it there.
+       */
 
-  /* Increment statistics */
+      while (nxsem_wait(&self->wrreq_idle) != OK)
+        {
+        }
 
-  NETDEV_TXPACKETS(self->dev);
+      flags = enter_critical_section();
+      wrcontainer = (FAR struct cdcecm_req_s *)sq_remfirst(&self->txfree);
+      leave_critical_section(flags);
+
+      DEBUGASSERT(wrcontainer != NULL);
+      memcpy(wrcontainer->req->buf, self->dev.d_buf, self->dev.d_len);
+    }
 
   /* Send the packet: address=priv->dev.d_buf, length=priv->dev.d_len */
 
-  memcpy(self->wrreq->buf, self->dev.d_buf, self->dev.d_len);
-  self->wrreq->len = self->dev.d_len;
+  wrcontainer->req->len = self->dev.d_len;
 
-  return EP_SUBMIT(self->epbulkin, self->wrreq);
+  ret = EP_SUBMIT(self->epbulkin, wrcontainer->req);
+  if (ret < 0)
+    {
+      flags = enter_critical_section();
+      sq_addlast((FAR sq_entry_t *)wrcontainer, &self->txfree);
+      leave_critical_section(flags);
+
+      nxsem_post(&self->wrreq_idle);
+    }
+
+  return ret;
 }
 
 /****************************************************************************
@@ -405,11 +536,13 @@ static int cdcecm_txpoll(FAR struct net_driver_s *dev)
 
           cdcecm_transmit(priv);
 
-          /* Check if there is room in the device to hold another packet. If
+          /* Check if there is room in the device to hold another packet,
+           * i.e. whether another write request is free to build it in.  If
            * not, return a non-zero value to terminate the poll.
            */
 
-          return 1;
+          cdcecm_txbuffer(priv);
+          return priv->txreq == NULL;
         }
     }
 
@@ -502,13 +635,10 @@ static void cdcecm_receive(FAR struct cdcecm_driver_s *self)
    * configuration.
    */
 
-  /* Copy the data data from the hardware to self->dev.d_buf.  Set
-   * amount of data in self->dev.d_len
+  /* d_buf and d_len already describe the frame in the read request
+   * buffer; the network operates on it in place.
    */
 
-  memcpy(self->dev.d_buf, self->rdreq->buf, self->rdreq->xfrd);
-  self->dev.d_len = self->rdreq->xfrd;
-
 #ifdef CONFIG_NET_PKT
   /* When packet sockets are enabled, feed the frame into the packet tap */
 
@@ -601,7 +731,9 @@ static void cdcecm_txdone(FAR struct cdcecm_driver_s *priv)
 
   /* In any event, poll the network for new TX data */
 
+  cdcecm_txbuffer(priv);
   devif_poll(&priv->dev, cdcecm_txpoll);
+  cdcecm_txrelease(priv);
 }
 
 /****************************************************************************
@@ -624,6 +756,7 @@ static void cdcecm_txdone(FAR struct cdcecm_driver_s *priv)
 static void cdcecm_interrupt_work(FAR void *arg)
 {
   FAR struct cdcecm_driver_s *self = (FAR struct cdcecm_driver_s *)arg;
+  FAR struct cdcecm_req_s *rdcontainer;
   irqstate_t flags;
 
   /* Lock the network and serialize driver operations if necessary.
@@ -634,15 +767,30 @@ static void cdcecm_interrupt_work(FAR void *arg)
 
   net_lock();
 
-  /* Check if we received an incoming packet, if so, call cdcecm_receive() */
+  /* Pass every frame received since the last wakeup to cdcecm_receive(),
+   * letting the network operate directly on the read request buffer.
+   */
 
-  if (self->rxpending)
+  for (; ; )
     {
+      flags = enter_critical_section();
+      rdcontainer = (FAR struct cdcecm_req_s *)sq_remfirst(&self->rxpending);
+      leave_critical_section(flags);
+
+      if (rdcontainer == NULL)
+        {
+          break;
+        }
+
+      self->dev.d_buf = rdcontainer->req->buf;
+      self->dev.d_len = rdcontainer->req->xfrd;
+
       cdcecm_receive(self);
 
+      self->dev.d_buf = self->pktbuf;
+
       flags = enter_critical_section();
-      self->rxpending = false;
-      EP_SUBMIT(self->epbulkout, self->rdreq);
+      EP_SUBMIT(self->epbulkout, rdcontainer->req);
       leave_critical_section(flags);
     }
 
@@ -684,7 +832,8 @@ static void cdcecm_poll_work(FAR void *arg)
 {
   FAR struct cdcecm_driver_s *self = (FAR struct cdcecm_driver_s *)arg;
 
-  ninfo("rxpending: %d, txdone: %d\n", self->rxpending, self->txdone);
+  ninfo("rxpending: %d, txdone: %d\n", !sq_empty(&self->rxpending),
+        self->txdone);
 
   /* Lock the network and serialize driver operations if necessary.
    * NOTE: Serialization is only required in the case where the driver work
@@ -695,11 +844,13 @@ static void cdcecm_poll_work(FAR void *arg)
   net_lock();
 
   /* Perform the poll.  We are always able to accept another packet, since
-   * cdcecm_transmit will just wait until the USB device write request will
+   * cdcecm_transmit will just wait until a USB device write request will
    * become available.
    */
 
+  cdcecm_txbuffer(self);
   devif_timer(&self->dev, CDCECM_WDDELAY, cdcecm_txpoll);
+  cdcecm_txrelease(self);
 
   /* Setup the watchdog poll timer again */
 
@@ -867,7 +1018,9 @@ static void cdcecm_txavail_work(FAR void *arg)
 
   if (self->bifup)
     {
+      cdcecm_txbuffer(self);
       devif_poll(&self->dev, cdcecm_txpoll);
+      cdcecm_txrelease(self);
     }
 
   net_unlock();
@@ -1121,8 +1274,7 @@ static void cdcecm_rdcomplete(FAR struct usbdev_ep_s *ep,
     {
       case 0:  /* Normal completion */
         {
-          DEBUGASSERT(!self->rxpending);
-          self->rxpending = true;
+          sq_addlast((FAR sq_entry_t *)req->priv, &self->rxpending);
           work_queue(ETHWORK, &self->irqwork, cdcecm_interrupt_work, self, 0);
         }
         break;
@@ -1133,7 +1285,7 @@ static void cdcecm_rdcomplete(FAR struct usbdev_ep_s *ep,
       default: /* Some other error occurred */
         {
           uerr("req->result: %hd\n", req->result);
-          EP_SUBMIT(self->epbulkout, self->rdreq);
+          EP_SUBMIT(self->epbulkout, req);
         }
         break;
     }
@@ -1152,15 +1304,20 @@ static void cdcecm_wrcomplete(FAR struct usbdev_ep_s *ep,
                               FAR struct usbdev_req_s *req)
 {
   FAR struct cdcecm_driver_s *self = (FAR struct cdcecm_driver_s *)ep->priv;
+  irqstate_t flags;
   int rc;
 
   uinfo("buf: %p, flags 0x%hhx, len %hu, xfrd %hu, result %hd\n",
         req->buf, req->flags, req->len, req->xfrd, req->result);
 
-  /* The single USB device write request is available for upcoming
-   * transmissions again.
+  /* The USB device write request is available for upcoming transmissions
+   * again.
    */
 
+  flags = enter_critical_section();
+  sq_addlast((FAR sq_entry_t *)req->priv, &self->txfree);
+  leave_critical_section(flags);
+
   rc = nxsem_post(&self->wrreq_idle);
 
   if (rc != OK)
@@ -1271,6 +1428,7 @@ static int cdcecm_setconfig(FAR struct cdcecm_driver_s *self, uint8_t config)
 {
   struct usb_epdesc_s epdesc;
   int ret = OK;
+  int i;
 
   if (config == self->config)
     {
@@ -1321,14 +1479,16 @@ static int cdcecm_setconfig(FAR struct cdcecm_driver_s *self, uint8_t config)
 
   /* Queue read requests in the bulk OUT endpoint */
 
-  DEBUGASSERT(!self->rxpending);
+  DEBUGASSERT(sq_empty(&self->rxpending));
 
-  self->rdreq->callback = cdcecm_rdcomplete,
-  ret = EP_SUBMIT(self->epbulkout, self->rdreq);
-  if (ret != OK)
+  for (i = 0; i < CONFIG_CDCECM_NRDREQS; i++)
     {
-      uerr("EP_SUBMIT failed. ret %d\n", ret);
-      goto error;
+      ret = EP_SUBMIT(self->epbulkout, self->rdreqs[i].req);
+      if (ret != OK)
+        {
+          uerr("EP_SUBMIT failed. ret %d\n", ret);
+          goto error;
+        }
     }
 
   /* We are successfully configured */
@@ -1800,6 +1960,7 @@ static int cdcecm_bind(FAR struct usbdevclass_driver_s *driver,
 {
   FAR struct cdcecm_driver_s *self = (FAR struct cdcecm_driver_s *)driver;
   int ret = OK;
+  int i;
 
   uinfo("\n");
 
@@ -1843,33 +2004,55 @@ static int cdcecm_bind(FAR struct usbdevclass_driver_s *driver,
 
   /* Pre-allocate read requests.  The buffer size is one full packet. */
 
-  self->rdreq = cdcecm_allocreq(self->epbulkout,
-                                CONFIG_NET_ETH_PKTSIZE + CONFIG_NET_GUARDSIZE);
-  if (self->rdreq == NULL)
+  sq_init(&self->rxpending);
+
+  for (i = 0; i < CONFIG_CDCECM_NRDREQS; i++)
     {
-      uerr("Out of memory\n");
-      ret = -ENOMEM;
-      goto error;
+      FAR struct cdcecm_req_s *rdcontainer = &self->rdreqs[i];
+
+      rdcontainer->req =
+        cdcecm_allocreq(self->epbulkout,
+                        CONFIG_NET_ETH_PKTSIZE + CONFIG_NET_GUARDSIZE);
+      if (rdcontainer->req == NULL)
+        {
+          uerr("Out of memory\n");
+          ret = -ENOMEM;
+          goto error;
+        }
+
+      rdcontainer->req->priv     = rdcontainer;
+      rdcontainer->req->callback = cdcecm_rdcomplete;
     }
 
-  self->rdreq->callback = cdcecm_rdcomplete;
+  /* Pre-allocate write requests and put them in the free list.  Buffer
+   * size is one full packet.
+   */
 
-  /* Pre-allocate a single write request.  Buffer size is one full packet. */
+  sq_init(&self->txfree);
 
-  self->wrreq = cdcecm_allocreq(self->epbulkin,
-                                CONFIG_NET_ETH_PKTSIZE + CONFIG_NET_GUARDSIZE);
-  if (self->wrreq == NULL)
+  for (i = 0; i < CONFIG_CDCECM_NWRREQS; i++)
     {
-      uerr("Out of memory\n");
-      ret = -ENOMEM;
-      goto error;
-    }
+      FAR struct cdcecm_req_s *wrcontainer = &self->wrreqs[i];
+
+      wrcontainer->req =
+        cdcecm_allocreq(self->epbulkin,
+                        CONFIG_NET_ETH_PKTSIZE + CONFIG_NET_GUARDSIZE);
+      if (wrcontainer->req == NULL)
+        {
+          uerr("Out of memory\n");
+          ret = -ENOMEM;
+          goto error;
+        }
 
-  self->wrreq->callback = cdcecm_wrcomplete;
+      wrcontainer->req->priv     = wrcontainer;
+      wrcontainer->req->callback = cdcecm_wrcomplete;
+      sq_addlast((FAR sq_entry_t *)wrcontainer, &self->txfree);
+    }
 
-  /* The single write request just allocated is available now. */
+  /* The write requests just allocated are available now. */
 
-  ret = nxsem_init(&self->wrreq_idle, 0, 1);
+  self->txreq = NULL;
+  ret = nxsem_init(&self->wrreq_idle, 0, CONFIG_CDCECM_NWRREQS);
 
   if (ret != OK)
     {
@@ -1903,6 +2086,7 @@ static void cdcecm_unbind(FAR struct usbdevclass_driver_s *driver,
                           FAR struct usbdev_s *dev)
 {
   FAR struct cdcecm_driver_s *self = (FAR struct cdcecm_driver_s *)driver;
+  int i;
 
 #ifdef CONFIG_DEBUG_FEATURES
   if (!driver || !dev)
@@ -1942,10 +2126,13 @@ static void cdcecm_unbind(FAR struct usbdevclass_driver_s *driver,
    * been returned to the free list at this time -- we don't check)
    */
 
-  if (self->rdreq != NULL)
+  for (i = 0; i < CONFIG_CDCECM_NRDREQS; i++)
     {
-      cdcecm_freereq(self->epbulkout, self->rdreq);
-      self->rdreq = NULL;
+      if (self->rdreqs[i].req != NULL)
+        {
+          cdcecm_freereq(self->epbulkout, self->rdreqs[i].req);
+          self->rdreqs[i].req = NULL;
+        }
     }
 
   /* Free the bulk OUT endpoint */
@@ -1960,10 +2147,13 @@ static void cdcecm_unbind(FAR struct usbdevclass_driver_s *driver,
    * of them)
    */
 
-  if (self->wrreq != NULL)
+  for (i = 0; i < CONFIG_CDCECM_NWRREQS; i++)
     {
-      cdcecm_freereq(self->epbulkin, self->wrreq);
-      self->wrreq = NULL;
+      if (self->wrreqs[i].req != NULL)
+        {
+          cdcecm_freereq(self->epbulkin, self->wrreqs[i].req);
+          self->wrreqs[i].req = NULL;
+        }
     }
 
   /* Free the bulk IN endpoint */
@@ -491,7 +491,9 @@ static const struct rndis_oid_value_s g_rndis_oid_values[] =
  *
  * Description:
  *   Submits the bulk OUT read request. Takes care not to submit the request
- *   when the RX packet buffer is already in use.
+ *   when the RX packet buffer is already in use.  The request covers as many
+ *   max size packets as fit in its buffer, so that a whole RNDIS message
+ *   normally completes as a single transfer.
  *
  * Input Parameters:
  *   priv: pointer to RNDIS device driver structure
@@ -508,7 +510,9 @@ static int rndis_submit_rdreq(FAR struct rndis_dev_s *priv)
 
   if (!priv->rdreq_submitted && !priv->rx_blocked)
     {
-      priv->rdreq->len = priv->epbulkout->maxpacket;
+      priv->rdreq->len = CONFIG_RNDIS_BULKOUT_REQLEN -
+                         CONFIG_RNDIS_BULKOUT_REQLEN %
+                         priv->epbulkout->maxpacket;
       ret = EP_SUBMIT(priv->epbulkout, priv->rdreq);
       if (ret != OK)
         {
@@ -1208,7 +1212,8 @@ static int rndis_txavail(FAR struct net_driver_s *dev)
  * Name: rndis_recvpacket
  *
  * Description:
- *   Handles a USB packet arriving on the data bulk out endpoint.
+ *   Handles a USB transfer arriving on the data bulk out endpoint.  The
+ *   transfer holds a whole RNDIS message or a part of one.
  *
  * Assumptions:
  *   Called from the USB interrupt handler with interrupts disabled.
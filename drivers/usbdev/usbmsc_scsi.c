@@ -176,6 +176,7 @@ static inline int usbmsc_setupcmd(FAR struct usbmsc_dev_s *priv,
 static int    usbmsc_idlestate(FAR struct usbmsc_dev_s *priv);
 static int    usbmsc_cmdparsestate(FAR struct usbmsc_dev_s *priv);
 static int    usbmsc_cmdreadstate(FAR struct usbmsc_dev_s *priv);
+static int    usbmsc_flushsectors(FAR struct usbmsc_dev_s *priv);
 static int    usbmsc_cmdwritestate(FAR struct usbmsc_dev_s *priv);
 static int    usbmsc_cmdfinishstate(FAR struct usbmsc_dev_s *priv);
 static int    usbmsc_cmdstatusstate(FAR struct usbmsc_dev_s *priv);
@@ -2144,7 +2145,8 @@ static int usbmsc_cmdparsestate(FAR struct usbmsc_dev_s *priv)
  * State variables:
  *   xfrlen     - holds the number of sectors read to be read.
  *   sector     - holds the sector number of the next sector to be read
- *   nsectbytes - holds the number of bytes buffered for the current sector
+ *   iolen      - holds the number of bytes loaded by the last block read
+ *   nsectbytes - holds the number of those bytes not yet sent
  *   nreqbytes  - holds the number of bytes currently buffered in the request
  *                at the head of the wrreqlist.
  *
@@ -2159,9 +2161,17 @@ static int usbmsc_cmdreadstate(FAR struct usbmsc_dev_s *priv)
   ssize_t nread;
   uint8_t *src;
   uint8_t *dest;
+  int reqlen;
   int nbytes;
   int ret;
 
+  /* Fill each request with as many whole packets as its buffer holds, so
+   * that only the final request of the transfer can be a short packet.
+   */
+
+  reqlen = CONFIG_USBMSC_BULKINREQLEN -
+           CONFIG_USBMSC_BULKINREQLEN % priv->epbulkin->maxpacket;
+
   /* Loop transferring data until either (1) all of the data has been
    * transferred, or (2) we have used up all of the write requests that we have
    * available.
@@ -2175,10 +2185,12 @@ static int usbmsc_cmdreadstate(FAR struct usbmsc_dev_s *priv)
 
       if (priv->nsectbytes <= 0)
         {
-          /* Yes.. read the next sector */
+          /* Yes.. read the next sectors, as many as the buffer holds */
 
-          nread = USBMSC_DRVR_READ(lun, priv->iobuffer, priv->sector, 1);
-          if (nread < 0)
+          nread = USBMSC_DRVR_READ(lun, priv->iobuffer, priv->sector,
+                                   MIN(priv->u.xfrlen,
+                                       priv->iosize / lun->sectorsize));
+          if (nread <= 0)
             {
               usbtrace(TRACE_CLSERROR(USBMSC_TRACEERR_CMDREADREADFAIL), -nread);
               lun->sd     = SCSI_KCQME_UNRRE1;
@@ -2186,9 +2198,10 @@ static int usbmsc_cmdreadstate(FAR struct usbmsc_dev_s *priv)
               break;
             }
 
-          priv->nsectbytes = lun->sectorsize;
-          priv->u.xfrlen--;
-          priv->sector++;
+          priv->iolen      = nread * lun->sectorsize;
+          priv->nsectbytes = priv->iolen;
+          priv->u.xfrlen  -= nread;
+          priv->sector    += nread;
         }
 
       /* Check if there is a request in the wrreqlist that we will be able to
@@ -2216,10 +2229,10 @@ static int usbmsc_cmdreadstate(FAR struct usbmsc_dev_s *priv)
        * all of the data available in the sector buffer.
        */
 
-      src    = &priv->iobuffer[lun->sectorsize - priv->nsectbytes];
+      src    = &priv->iobuffer[priv->iolen - priv->nsectbytes];
       dest   = &req->buf[priv->nreqbytes];
 
-      nbytes = MIN(priv->epbulkin->maxpacket - priv->nreqbytes, priv->nsectbytes);
+      nbytes = MIN(reqlen - priv->nreqbytes, priv->nsectbytes);
 
       /* Copy the data from the sector buffer to the USB request and update counts */
 
@@ -2232,7 +2245,7 @@ static int usbmsc_cmdreadstate(FAR struct usbmsc_dev_s *priv)
        * then submit the request
        */
 
-      if (priv->nreqbytes >= priv->epbulkin->maxpacket ||
+      if (priv->nreqbytes >= reqlen ||
           (priv->u.xfrlen <= 0 && priv->nsectbytes <= 0))
         {
           /* Remove the request that we just filled from wrreqlist (we've
@@ -2273,6 +2286,43 @@ static int usbmsc_cmdreadstate(FAR struct usbmsc_dev_s *priv)
   return OK;
 }
 
+/****************************************************************************
+ * Name: usbmsc_flushsectors
+ *
+ * Description:
+ *   Write the whole sectors buffered in iobuffer[] to the block driver with
+ *   a single request.  Called from usbmsc_cmdwritestate.
+ *
+ * Returned Value:
+ *   Zero on success; a negated errno value if the block driver write failed.
+ *   In the failure case, the sense data of the current LUN is set.
+ *
+ ****************************************************************************/
+
+static int usbmsc_flushsectors(FAR struct usbmsc_dev_s *priv)
+{
+  FAR struct usbmsc_lun_s *lun = priv->lun;
+  ssize_t nwritten;
+  uint32_t nsectors;
+
+  nsectors = priv->nsectbytes / lun->sectorsize;
+
+  nwritten = USBMSC_DRVR_WRITE(lun, priv->iobuffer, priv->sector, nsectors);
+  if (nwritten < 0)
+    {
+      usbtrace(TRACE_CLSERROR(USBMSC_TRACEERR_CMDWRITEWRITEFAIL), -nwritten);
+      lun->sd     = SCSI_KCQME_WRITEFAULTAUTOREALLOCFAILED;
+      lun->sdinfo = priv->sector;
+      return (int)nwritten;
+    }
+
+  priv->nsectbytes = 0;
+  priv->residue   -= nsectors * lun->sectorsize;
+  priv->u.xfrlen  -= nsectors;
+  priv->sector    += nsectors;
+  return OK;
+}
+
 /****************************************************************************
  * Name: usbmsc_cmdwritestate
  *
@@ -2292,7 +2342,7 @@ static int usbmsc_cmdreadstate(FAR struct usbmsc_dev_s *priv)
  * State variables:
  *   xfrlen     - holds the number of sectors read to be written.
  *   sector     - holds the sector number of the next sector to write
- *   nsectbytes - holds the number of bytes buffered for the current sector
+ *   nsectbytes - holds the number of bytes buffered for the next write
  *   nreqbytes  - holds the number of untransferred bytes currently in the
  *                request at the head of the rdreqlist.
  *
@@ -2303,7 +2353,7 @@ static int usbmsc_cmdwritestate(FAR struct usbmsc_dev_s *priv)
   FAR struct usbmsc_lun_s *lun = priv->lun;
   FAR struct usbmsc_req_s *privreq;
   FAR struct usbdev_req_s *req;
-  ssize_t nwritten;
+  uint32_t iolen;
   uint16_t xfrd;
   uint8_t *src;
   uint8_t *dest;
@@ -2350,12 +2400,18 @@ static int usbmsc_cmdwritestate(FAR struct usbmsc_dev_s *priv)
 
       while (priv->nreqbytes > 0 && priv->u.xfrlen > 0)
         {
-          /* Copy the data received in the read request into the sector I/O buffer */
+          /* Copy the data received in the read request into the sector I/O
+           * buffer, which is written once it holds as many of the remaining
+           * sectors as fit.
+           */
+
+          iolen = MIN(priv->u.xfrlen, priv->iosize / lun->sectorsize) *
+                  lun->sectorsize;
 
           src  = &req->buf[xfrd - priv->nreqbytes];
           dest = &priv->iobuffer[priv->nsectbytes];
 
-          nbytes = MIN(lun->sectorsize - priv->nsectbytes, priv->nreqbytes);
+          nbytes = MIN(iolen - priv->nsectbytes, priv->nreqbytes);
 
           /* Copy the data from the sector buffer to the USB request and update counts */
 
@@ -2365,24 +2421,14 @@ static int usbmsc_cmdwritestate(FAR struct usbmsc_dev_s *priv)
 
           /* Is the I/O buffer full? */
 
-          if (priv->nsectbytes >= lun->sectorsize)
+          if (priv->nsectbytes >= iolen)
             {
-              /* Yes.. Write the next sector */
+              /* Yes.. Write the buffered sectors */
 
-              nwritten = USBMSC_DRVR_WRITE(lun, priv->iobuffer, priv->sector, 1);
-              if (nwritten < 0)
+              if (usbmsc_flushsectors(priv) < 0)
                 {
-                  usbtrace(TRACE_CLSERROR(USBMSC_TRACEERR_CMDWRITEWRITEFAIL),
-                           -nwritten);
-                  lun->sd     = SCSI_KCQME_WRITEFAULTAUTOREALLOCFAILED;
-                  lun->sdinfo = priv->sector;
                   goto errout;
                 }
-
-              priv->nsectbytes = 0;
-              priv->residue   -= lun->sectorsize;
-              priv->u.xfrlen--;
-              priv->sector++;
             }
         }
 
@@ -2405,6 +2451,13 @@ static int usbmsc_cmdwritestate(FAR struct usbmsc_dev_s *priv)
 
       if (xfrd != priv->epbulkout->maxpacket)
         {
+          /* Write the whole sectors received so far */
+
+          if (priv->nsectbytes >= lun->sectorsize)
+            {
+              usbmsc_flushsectors(priv);
+            }
+
           priv->shortpacket = 1;
           goto errout;
         }
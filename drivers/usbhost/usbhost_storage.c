@@ -54,7 +54,9 @@
 #include <nuttx/wqueue.h>
 #include <nuttx/scsi.h>
 #include <nuttx/fs/fs.h>
+#include <nuttx/fs/ioctl.h>
 #include <nuttx/semaphore.h>
+#include <nuttx/drivers/rwbuffer.h>
 
 #include <nuttx/usb/usb.h>
 #include <nuttx/usb/usbhost.h>
@@ -90,6 +92,17 @@
 #  error "Currently limited to 26 devices /dev/sda-z"
 #endif
 
+/* Check if read/write buffer support is needed */
+
+#if defined(CONFIG_USBHOST_MSC_READAHEAD) || \
+    defined(CONFIG_USBHOST_MSC_WRITEBUFFER)
+#  define USBHOST_HAVE_RWBUFFER 1
+#endif
+
+#ifndef CONFIG_USBHOST_MSC_NBUFBLOCKS
+#  define CONFIG_USBHOST_MSC_NBUFBLOCKS 64
+#endif
+
 /* Driver support ***********************************************************/
 /* This format is used to construct the /dev/sd[n] device driver path.  It
  * defined here so that it will be used consistently in all places.
@@ -137,6 +150,9 @@ struct usbhost_state_s
   size_t                  tbuflen;      /* Size of the allocated transfer buffer */
   usbhost_ep_t            bulkin;       /* Bulk IN endpoint */
   usbhost_ep_t            bulkout;      /* Bulk OUT endpoint */
+#ifdef USBHOST_HAVE_RWBUFFER
+  struct rwbuffer_s       rwbuffer;     /* Read-ahead/write buffer support */
+#endif
 };
 
 /* This is how struct usbhost_state_s looks to the free list logic */
@@ -236,6 +252,15 @@ static int usbhost_connect(FAR struct usbhost_class_s *usbclass,
                            FAR const uint8_t *configdesc, int desclen);
 static int usbhost_disconnected(FAR struct usbhost_class_s *usbclass);
 
+/* Physical transfers (called directly or from the read/write buffers) */
+
+static ssize_t usbhost_reload(FAR void *dev, FAR uint8_t *buffer,
+                              off_t startsector, size_t nsectors);
+#ifdef CONFIG_FS_WRITABLE
+static ssize_t usbhost_flush(FAR void *dev, FAR const uint8_t *buffer,
+                             off_t startsector, size_t nsectors);
+#endif
+
 /* struct block_operations methods */
 
 static int usbhost_open(FAR struct inode *inode);
@@ -923,6 +948,15 @@ static void usbhost_destroy(FAR void *arg)
 
   usbhost_freedevno(priv);
 
+#ifdef USBHOST_HAVE_RWBUFFER
+  /* Release the read-ahead/write buffers.  Any unwritten data is lost. */
+
+  if (priv->rwbuffer.dev != NULL)
+    {
+      rwb_uninitialize(&priv->rwbuffer);
+    }
+#endif
+
   /* Free the bulk endpoints */
 
   if (priv->bulkout)
@@ -1326,6 +1360,36 @@ static inline int usbhost_initvolume(FAR struct usbhost_state_s *priv)
         }
     }
 
+#ifdef USBHOST_HAVE_RWBUFFER
+  /* Configure read-ahead/write buffering now that the geometry is known */
+
+  if (ret >= 0)
+    {
+      priv->rwbuffer.blocksize   = priv->blocksize;
+      priv->rwbuffer.nblocks     = priv->nblocks;
+      priv->rwbuffer.dev         = (FAR void *)priv;
+#ifdef CONFIG_FS_WRITABLE
+      priv->rwbuffer.wrflush     = usbhost_flush;
+#endif
+      priv->rwbuffer.rhreload    = usbhost_reload;
+
+#ifdef CONFIG_USBHOST_MSC_WRITEBUFFER
+      priv->rwbuffer.wrmaxblocks = CONFIG_USBHOST_MSC_NBUFBLOCKS;
+#endif
+
+#ifdef CONFIG_USBHOST_MSC_READAHEAD
+      priv->rwbuffer.rhmaxblocks = CONFIG_USBHOST_MSC_NBUFBLOCKS;
+#endif
+
+      ret = rwb_initialize(&priv->rwbuffer);
+      if (ret < 0)
+        {
+          uerr("ERROR: rwb_initialize failed: %d\n", ret);
+          priv->rwbuffer.dev = NULL;
+        }
+    }
+#endif
+
   /* Register the block driver */
 
   if (ret >= 0)
@@ -1851,129 +1915,27 @@ static int usbhost_disconnected(struct usbhost_class_s *usbclass)
 }
 
 /****************************************************************************
- * struct block_operations methods
+ * Physical transfers
  ****************************************************************************/
 /****************************************************************************
- * Name: usbhost_open
- *
- * Description: Open the block device
- *
- ****************************************************************************/
-
-static int usbhost_open(FAR struct inode *inode)
-{
-  FAR struct usbhost_state_s *priv;
-  irqstate_t flags;
-  int ret;
-
-  uinfo("Entry\n");
-  DEBUGASSERT(inode && inode->i_private);
-  priv = (FAR struct usbhost_state_s *)inode->i_private;
-
-  /* Make sure that we have exclusive access to the private data structure */
-
-  DEBUGASSERT(priv->crefs > 0 && priv->crefs < USBHOST_MAX_CREFS);
-  usbhost_takesem(&priv->exclsem);
-
-  /* Check if the mass storage device is still connected.  We need to disable
-   * interrupts momentarily to assure that there are no asynchronous disconnect
-   * events.
-   */
-
-  flags = enter_critical_section();
-  if (priv->disconnected)
-    {
-      /* No... the block driver is no longer bound to the class.  That means that
-       * the USB storage device is no longer connected.  Refuse any further
-       * attempts to open the driver.
-       */
-
-      ret = -ENODEV;
-    }
-  else
-    {
-      /* Otherwise, just increment the reference count on the driver */
-
-      priv->crefs++;
-      ret = OK;
-    }
-  leave_critical_section(flags);
-
-  usbhost_givesem(&priv->exclsem);
-  return ret;
-}
-
-/****************************************************************************
- * Name: usbhost_close
- *
- * Description: close the block device
- *
- ****************************************************************************/
-
-static int usbhost_close(FAR struct inode *inode)
-{
-  FAR struct usbhost_state_s *priv;
-  irqstate_t flags;
-
-  uinfo("Entry\n");
-  DEBUGASSERT(inode && inode->i_private);
-  priv = (FAR struct usbhost_state_s *)inode->i_private;
-
-  /* Decrement the reference count on the block driver */
-
-  DEBUGASSERT(priv->crefs > 1);
-  usbhost_takesem(&priv->exclsem);
-  priv->crefs--;
-
-  /* Release the semaphore.  The following operations when crefs == 1 are
-   * safe because we know that there is no outstanding open references to
-   * the block driver.
-   */
-
-  usbhost_givesem(&priv->exclsem);
-
-  /* We need to disable interrupts momentarily to assure that there are
-   * no asynchronous disconnect events.
-   */
-
-  flags = enter_critical_section();
-
-  /* Check if the USB mass storage device is still connected.  If the
-   * storage device is not connected and the reference count just
-   * decremented to one, then unregister the block driver and free
-   * the class instance.
-   */
-
-  if (priv->crefs <= 1 && priv->disconnected)
-    {
-      /* Destroy the class instance */
-
-      DEBUGASSERT(priv->crefs == 1);
-      usbhost_destroy(priv);
-    }
-
-  leave_critical_section(flags);
-  return OK;
-}
-
-/****************************************************************************
- * Name: usbhost_read
+ * Name: usbhost_reload
  *
  * Description:
- *   Read the specified numer of sectors from the read-ahead buffer or from
- *   the physical device.
+ *   Read the specified number of sectors from the physical device with a
+ *   single READ10 command.  This is also the reload callout of the
+ *   read-ahead buffer.
  *
  ****************************************************************************/
 
-static ssize_t usbhost_read(FAR struct inode *inode, unsigned char *buffer,
-                            size_t startsector, unsigned int nsectors)
+static ssize_t usbhost_reload(FAR void *dev, FAR uint8_t *buffer,
+                              off_t startsector, size_t nsectors)
 {
   FAR struct usbhost_state_s *priv;
   FAR struct usbhost_hubport_s *hport;
   ssize_t nbytes = 0;
 
-  DEBUGASSERT(inode && inode->i_private);
-  priv = (FAR struct usbhost_state_s *)inode->i_private;
+  priv = (FAR struct usbhost_state_s *)dev;
+  DEBUGASSERT(priv != NULL);
 
   DEBUGASSERT(priv->usbclass.hport);
   hport = priv->usbclass.hport;
@@ -2062,26 +2024,28 @@ static ssize_t usbhost_read(FAR struct inode *inode, unsigned char *buffer,
 }
 
 /****************************************************************************
- * Name: usbhost_write
+ * Name: usbhost_flush
  *
  * Description:
- *   Write the specified number of sectors to the write buffer or to the
- *   physical device.
+ *   Write the specified number of sectors to the physical device with a
+ *   single WRITE10 command.  This is also the flush callout of the write
+ *   buffer.
  *
  ****************************************************************************/
 
 #ifdef CONFIG_FS_WRITABLE
-static ssize_t usbhost_write(FAR struct inode *inode, const unsigned char *buffer,
-                           size_t startsector, unsigned int nsectors)
+static ssize_t usbhost_flush(FAR void *dev, FAR const uint8_t *buffer,
+                             off_t startsector, size_t nsectors)
 {
   FAR struct usbhost_state_s *priv;
   FAR struct usbhost_hubport_s *hport;
   ssize_t nbytes;
 
-  uinfo("sector: %d nsectors: %d sectorsize: %d\n");
+  priv = (FAR struct usbhost_state_s *)dev;
+  DEBUGASSERT(priv != NULL);
 
-  DEBUGASSERT(inode && inode->i_private);
-  priv = (FAR struct usbhost_state_s *)inode->i_private;
+  uinfo("startsector: %d nsectors: %d sectorsize: %d\n",
+        startsector, nsectors, priv->blocksize);
 
   DEBUGASSERT(priv->usbclass.hport);
   hport = priv->usbclass.hport;
@@ -2159,6 +2123,173 @@ static ssize_t usbhost_write(FAR struct inode *inode, const unsigned char *buffe
 }
 #endif
 
+/****************************************************************************
+ * struct block_operations methods
+ ****************************************************************************/
+/****************************************************************************
+ * Name: usbhost_open
+ *
+ * Description: Open the block device
+ *
+ ****************************************************************************/
+
+static int usbhost_open(FAR struct inode *inode)
+{
+  FAR struct usbhost_state_s *priv;
+  irqstate_t flags;
+  int ret;
+
+  uinfo("Entry\n");
+  DEBUGASSERT(inode && inode->i_private);
+  priv = (FAR struct usbhost_state_s *)inode->i_private;
+
+  /* Make sure that we have exclusive access to the private data structure */
+
+  DEBUGASSERT(priv->crefs > 0 && priv->crefs < USBHOST_MAX_CREFS);
+  usbhost_takesem(&priv->exclsem);
+
+  /* Check if the mass storage device is still connected.  We need to disable
+   * interrupts momentarily to assure that there are no asynchronous disconnect
+   * events.
+   */
+
+  flags = enter_critical_section();
+  if (priv->disconnected)
+    {
+      /* No... the block driver is no longer bound to the class.  That means that
+       * the USB storage device is no longer connected.  Refuse any further
+       * attempts to open the driver.
+       */
+
+      ret = -ENODEV;
+    }
+  else
+    {
+      /* Otherwise, just increment the reference count on the driver */
+
+      priv->crefs++;
+      ret = OK;
+    }
+  leave_critical_section(flags);
+
+  usbhost_givesem(&priv->exclsem);
+  return ret;
+}
+
+/****************************************************************************
+ * Name: usbhost_close
+ *
+ * Description: close the block device
+ *
+ ****************************************************************************/
+
+static int usbhost_close(FAR struct inode *inode)
+{
+  FAR struct usbhost_state_s *priv;
+  irqstate_t flags;
+
+  uinfo("Entry\n");
+  DEBUGASSERT(inode && inode->i_private);
+  priv = (FAR struct usbhost_state_s *)inode->i_private;
+
+#ifdef CONFIG_USBHOST_MSC_WRITEBUFFER
+  /* Write any buffered data to the device.  This must be done before
+   * taking the semaphore because the flush callout takes it too.
+   */
+
+  if (!priv->disconnected)
+    {
+      rwb_flush(&priv->rwbuffer);
+    }
+#endif
+
+  /* Decrement the reference count on the block driver */
+
+  DEBUGASSERT(priv->crefs > 1);
+  usbhost_takesem(&priv->exclsem);
+  priv->crefs--;
+
+  /* Release the semaphore.  The following operations when crefs == 1 are
+   * safe because we know that there is no outstanding open references to
+   * the block driver.
+   */
+
+  usbhost_givesem(&priv->exclsem);
+
+  /* We need to disable interrupts momentarily to assure that there are
+   * no asynchronous disconnect events.
+   */
+
+  flags = enter_critical_section();
+
+  /* Check if the USB mass storage device is still connected.  If the
+   * storage device is not connected and the reference count just
+   * decremented to one, then unregister the block driver and free
+   * the class instance.
+   */
+
+  if (priv->crefs <= 1 && priv->disconnected)
+    {
+      /* Destroy the class instance */
+
+      DEBUGASSERT(priv->crefs == 1);
+      usbhost_destroy(priv);
+    }
+
+  leave_critical_section(flags);
+  return OK;
+}
+
+/****************************************************************************
+ * Name: usbhost_read
+ *
+ * Description:
+ *   Read the specified numer of sectors from the read-ahead buffer or from
+ *   the physical device.
+ *
+ ****************************************************************************/
+
+static ssize_t usbhost_read(FAR struct inode *inode, unsigned char *buffer,
+                            size_t startsector, unsigned int nsectors)
+{
+  FAR struct usbhost_state_s *priv;
+
+  DEBUGASSERT(inode && inode->i_private);
+  priv = (FAR struct usbhost_state_s *)inode->i_private;
+
+#ifdef USBHOST_HAVE_RWBUFFER
+  return rwb_read(&priv->rwbuffer, startsector, nsectors, buffer);
+#else
+  return usbhost_reload(priv, buffer, startsector, nsectors);
+#endif
+}
+
+/****************************************************************************
+ * Name: usbhost_write
+ *
+ * Description:
+ *   Write the specified number of sectors to the write buffer or to the
+ *   physical device.
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_FS_WRITABLE
+static ssize_t usbhost_write(FAR struct inode *inode, const unsigned char *buffer,
+                           size_t startsector, unsigned int nsectors)
+{
+  FAR struct usbhost_state_s *priv;
+
+  DEBUGASSERT(inode && inode->i_private);
+  priv = (FAR struct usbhost_state_s *)inode->i_private;
+
+#ifdef USBHOST_HAVE_RWBUFFER
+  return rwb_write(&priv->rwbuffer, startsector, nsectors, buffer);
+#else
+  return usbhost_flush(priv, buffer, startsector, nsectors);
+#endif
+}
+#endif
+
 /****************************************************************************
  * Name: usbhost_geometry
  *
@@ -2239,6 +2370,16 @@ static int usbhost_ioctl(FAR struct inode *inode, int cmd, unsigned long arg)
 
       ret = -ENODEV;
     }
+#ifdef CONFIG_USBHOST_MSC_WRITEBUFFER
+  else if (cmd == BIOC_FLUSH)
+    {
+      /* Write any buffered data to the device.  The flush callout takes
+       * the semaphore itself.
+       */
+
+      ret = rwb_flush(&priv->rwbuffer);
+    }
+#endif
   else
     {
       /* Process the IOCTL by command */
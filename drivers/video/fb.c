@@ -83,6 +83,10 @@ static ssize_t fb_read(FAR struct file *filep, FAR char *buffer,
 static ssize_t fb_write(FAR struct file *filep, FAR const char *buffer,
                  size_t buflen);
 static off_t   fb_seek(FAR struct file *filep, off_t offset, int whence);
+#ifdef CONFIG_LCD_UPDATE
+static void    fb_notifywrite(FAR struct fb_chardev_s *fb, size_t start,
+                              size_t size);
+#endif
 static int     fb_ioctl(FAR struct file *filep, int cmd, unsigned long arg);
 
 /****************************************************************************
@@ -173,7 +177,7 @@ static ssize_t fb_read(FAR struct file *filep, FAR char *buffer, size_t len)
 
   /* And transfer the data from the frame buffer */
 
-  memcpy(buffer, fb->fbmem, size);
+  memcpy(buffer, (FAR uint8_t *)fb->fbmem + start, size);
   filep->f_pos += size;
   return size;
 }
@@ -217,11 +221,63 @@ static ssize_t fb_write(FAR struct file *filep, FAR const char *buffer,
 
   /* And transfer the data into the frame buffer */
 
-  memcpy(fb->fbmem, buffer, size);
+  memcpy((FAR uint8_t *)fb->fbmem + start, buffer, size);
   filep->f_pos += size;
+
+#ifdef CONFIG_LCD_UPDATE
+  /* Let the display know which part of the framebuffer has changed */
+
+  fb_notifywrite(fb, start, size);
+#endif
+
   return size;
 }
 
+/****************************************************************************
+ * Name: fb_notifywrite
+ *
+ * Description:
+ *   Report the region touched by a write() as updated.  A write within one
+ *   row updates only the columns written; a write spanning several rows
+ *   updates those rows completely.
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_LCD_UPDATE
+static void fb_notifywrite(FAR struct fb_chardev_s *fb, size_t start,
+                           size_t size)
+{
+  struct fb_planeinfo_s pinfo;
+  struct nxgl_rect_s rect;
+  size_t end;
+  int ret;
+
+  DEBUGASSERT(fb->vtable != NULL && fb->vtable->getplaneinfo != NULL);
+  ret = fb->vtable->getplaneinfo(fb->vtable, fb->plane, &pinfo);
+  if (ret < 0 || size == 0 || pinfo.stride == 0 || pinfo.bpp == 0)
+    {
+      return;
+    }
+
+  end        = start + size - 1;
+  rect.pt1.y = start / pinfo.stride;
+  rect.pt2.y = end / pinfo.stride;
+
+  if (rect.pt1.y == rect.pt2.y)
+    {
+      rect.pt1.x = ((start % pinfo.stride) << 3) / pinfo.bpp;
+      rect.pt2.x = ((end % pinfo.stride) << 3) / pinfo.bpp;
+    }
+  else
+    {
+      rect.pt1.x = 0;
+      rect.pt2.x = ((pinfo.stride << 3) / pinfo.bpp) - 1;
+    }
+
+  nx_notify_rectangle((FAR NX_PLANEINFOTYPE *)&pinfo, &rect);
+}
+#endif
+
 /****************************************************************************
  * Name: fb_seek
  *
@@ -534,6 +590,48 @@ static int fb_ioctl(FAR struct file *filep, int cmd, unsigned long arg)
 #endif
 #endif /* CONFIG_FB_OVERLAY */
 
+#ifdef CONFIG_FB_ACCEL
+      case FBIO_FILLRECT:  /* Fill a rectangle in hardware */
+        {
+          FAR const struct fb_fillrect_s *fill =
+            (FAR const struct fb_fillrect_s *)((uintptr_t)arg);
+          struct fb_fillrect_s planefill;
+
+          DEBUGASSERT(fill != NULL && fb->vtable != NULL);
+          if (fb->vtable->fillrect == NULL)
+            {
+              ret = -ENOSYS;
+              break;
+            }
+
+          /* The color plane is the one this device was registered for */
+
+          planefill         = *fill;
+          planefill.planeno = fb->plane;
+          ret = fb->vtable->fillrect(fb->vtable, &planefill);
+        }
+        break;
+
+      case FBIO_COPYRECT:  /* Copy an image into a rectangle in hardware */
+        {
+          FAR const struct fb_copyrect_s *copy =
+            (FAR const struct fb_copyrect_s *)((uintptr_t)arg);
+          struct fb_copyrect_s planecopy;
+
+          DEBUGASSERT(copy != NULL && fb->vtable != NULL);
+          if (fb->vtable->copyrect == NULL)
+            {
+              ret = -ENOSYS;
+              break;
+            }
+
+          planecopy         = *copy;
+          planecopy.planeno = fb->plane;
+          ret = fb->vtable->copyrect(fb->vtable, &planecopy);
+        }
+        break;
+#endif
+
       default:
         gerr("ERROR: Unsupported IOCTL command: %d\n", cmd);
         ret = -ENOTTY;
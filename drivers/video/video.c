@@ -49,6 +49,7 @@
 
 #include <nuttx/arch.h>
 #include <nuttx/board.h>
+#include <nuttx/clock.h>
 #include <nuttx/kmalloc.h>
 
 #include <arch/board/board.h>
@@ -70,6 +71,10 @@
 
 #define VIDEO_REMAINING_CAPNUM_INFINITY (-1)
 
+/* Alignment of driver allocated buffers (V4L2_MEMORY_MMAP) */
+
+#define VIDEO_MMAP_ALIGN        (32)
+
 /* Debug option */
 
 #ifdef CONFIG_DEBUG_VIDEO_ERROR
@@ -143,6 +148,10 @@ struct video_type_inf_s
   int32_t              remaining_capnum;
   video_wait_dma_t     wait_dma;
   video_framebuff_t    bufinf;
+  uint32_t             sizeimage;  /* Image size of the current format */
+  uint32_t             sequence;   /* Frames captured or dropped */
+  uint32_t             frames;     /* Frames captured into buffers */
+  uint32_t             dropped;    /* Frames dropped */
 };
 
 typedef struct video_type_inf_s video_type_inf_t;
@@ -165,6 +174,17 @@ struct video_mng_s
   video_type_inf_t   still_inf;
   video_fmtlist_t    video_fmtlist;
   video_fmtlist_t    still_fmtlist;
+
+  /* Driver allocated buffers (V4L2_MEMORY_MMAP).  They belong to one
+   * buffer type at a time.
+   */
+
+  FAR uint8_t        *mmap_base;
+  uint32_t           mmap_bufsize;
+  uint16_t           mmap_count;
+  uint16_t           mmap_type;    /* enum #v4l2_buf_type */
+
+  struct timespec    frame_start;  /* Time of the last vertical sync */
 };
 
 typedef struct video_mng_s video_mng_t;
@@ -207,6 +227,8 @@ static int video_reqbufs(FAR struct video_mng_s *vmng,
                          FAR struct v4l2_requestbuffers *reqbufs);
 static int video_qbuf(FAR struct video_mng_s *vmng,
                       FAR struct v4l2_buffer *buf);
+static int video_querybuf(FAR struct video_mng_s *vmng,
+                          FAR struct v4l2_buffer *buf);
 static int video_dqbuf(FAR struct video_mng_s *vmng,
                        FAR struct v4l2_buffer *buf);
 static int video_cancel_dqbuf(FAR struct video_mng_s *vmng,
@@ -221,6 +243,8 @@ static int video_s_parm(FAR struct video_mng_s *priv,
                         FAR struct v4l2_streamparm *parm);
 static int video_streamon(FAR struct video_mng_s *vmng,
                           FAR enum v4l2_buf_type *type);
+static int video_g_framestat(FAR struct video_mng_s *vmng,
+                             FAR struct v4l2_framestat *stat);
 static int video_streamoff(FAR struct video_mng_s *vmng,
                            FAR enum v4l2_buf_type *type);
 static int video_do_halfpush(bool enable);
@@ -475,6 +499,13 @@ static void cleanup_resources(FAR video_mng_t *vmng)
   cleanup_streamresources(&vmng->video_inf);
   cleanup_streamresources(&vmng->still_inf);
 
+  if (vmng->mmap_base != NULL)
+    {
+      kumm_free(vmng->mmap_base);
+      vmng->mmap_base  = NULL;
+      vmng->mmap_count = 0;
+    }
+
   return;
 }
 
@@ -644,6 +675,62 @@ static int video_close(FAR struct file *filep)
   return ret;
 }
 
+static int video_mmap_alloc(FAR struct video_mng_s         *vmng,
+                            FAR video_type_inf_t           *type_inf,
+                            FAR struct v4l2_requestbuffers *reqbufs)
+{
+  uint32_t bufsize;
+
+  if (vmng->mmap_base != NULL)
+    {
+      /* The buffers of the other type are still in use */
+
+      if (vmng->mmap_type != reqbufs->type)
+        {
+          return -EBUSY;
+        }
+
+      kumm_free(vmng->mmap_base);
+      vmng->mmap_base  = NULL;
+      vmng->mmap_count = 0;
+    }
+
+  if (reqbufs->count == 0)
+    {
+      return OK;
+    }
+
+  /* The buffer size follows the current format */
+
+  bufsize = (type_inf->sizeimage + VIDEO_MMAP_ALIGN - 1) &
+            ~(VIDEO_MMAP_ALIGN - 1);
+  if (bufsize == 0)
+    {
+      return -EINVAL;
+    }
+
+  vmng->mmap_base = (FAR uint8_t *)kumm_memalign(VIDEO_MMAP_ALIGN,
+                                                 bufsize * reqbufs->count);
+  if (vmng->mmap_base == NULL)
+    {
+      return -ENOMEM;
+    }
+
+  vmng->mmap_bufsize = bufsize;
+  vmng->mmap_count   = reqbufs->count;
+  vmng->mmap_type    = reqbufs->type;
+
+  return OK;
+}
+
+static bool is_mmap_buffer(FAR struct video_mng_s *vmng,
+                           FAR struct v4l2_buffer *buf)
+{
+  return ((vmng->mmap_base != NULL) &&
+          (buf->type == vmng->mmap_type) &&
+          (buf->index < vmng->mmap_count));
+}
+
 static int video_reqbufs(FAR struct video_mng_s         *vmng,
                          FAR struct v4l2_requestbuffers *reqbufs)
 {
@@ -680,9 +767,39 @@ static int video_reqbufs(FAR struct video_mng_s         *vmng,
 
   leave_critical_section(flags);
 
+  if ((ret == OK) && (reqbufs->memory == V4L2_MEMORY_MMAP))
+    {
+      /* Allocate the buffers outside of the critical section */
+
+      ret = video_mmap_alloc(vmng, type_inf, reqbufs);
+    }
+
   return ret;
 }
 
+static int video_querybuf(FAR struct video_mng_s *vmng,
+                          FAR struct v4l2_buffer *buf)
+{
+  if ((vmng == NULL) || (buf == NULL))
+    {
+      return -EINVAL;
+    }
+
+  if (!is_mmap_buffer(vmng, buf))
+    {
+      return -EINVAL;
+    }
+
+  buf->memory    = V4L2_MEMORY_MMAP;
+  buf->flags     = 0;
+  buf->bytesused = 0;
+  buf->m.userptr = 0;
+  buf->m.offset  = buf->index * vmng->mmap_bufsize;
+  buf->length    = vmng->mmap_bufsize;
+
+  return OK;
+}
+
 static int video_qbuf(FAR struct video_mng_s *vmng,
                       FAR struct v4l2_buffer *buf)
 {
@@ -703,7 +820,13 @@ static int video_qbuf(FAR struct video_mng_s *vmng,
       return -EINVAL;
     }
 
-  if (!is_bufsize_sufficient(vmng, buf->length))
+  if ((buf->memory == V4L2_MEMORY_MMAP) && !is_mmap_buffer(vmng, buf))
+    {
+      return -EINVAL;
+    }
+
+  if ((buf->memory != V4L2_MEMORY_MMAP) &&
+      !is_bufsize_sufficient(vmng, buf->length))
     {
       return -EINVAL;
     }
@@ -715,6 +838,15 @@ static int video_qbuf(FAR struct video_mng_s *vmng,
     }
 
   memcpy(&container->buf, buf, sizeof(struct v4l2_buffer));
+
+  if (buf->memory == V4L2_MEMORY_MMAP)
+    {
+      /* The image is captured directly into the driver allocated buffer */
+
+      container->buf.m.userptr = (unsigned long)
+        (vmng->mmap_base + buf->index * vmng->mmap_bufsize);
+      container->buf.length    = vmng->mmap_bufsize;
+    }
   video_framebuff_queue_container(&type_inf->bufinf, container);
 
   video_lock(&type_inf->lock_state);
@@ -825,6 +957,14 @@ static int video_dqbuf(FAR struct video_mng_s *vmng,
 
   memcpy(buf, &container->buf, sizeof(struct v4l2_buffer));
 
+  if (buf->memory == V4L2_MEMORY_MMAP)
+    {
+      /* Report the mmap() offset rather than the kernel address */
+
+      buf->m.userptr = 0;
+      buf->m.offset  = buf->index * vmng->mmap_bufsize;
+    }
+
   video_framebuff_free_container(&type_inf->bufinf, container);
 
   return OK;
@@ -1093,6 +1233,8 @@ static int video_try_fmt(FAR struct v4l2_format *fmt)
 static int video_s_fmt(FAR struct video_mng_s *priv,
                        FAR struct v4l2_format *fmt)
 {
+  FAR video_type_inf_t *type_inf;
+  uint32_t sizeimage;
   int ret;
 
   if ((g_video_sensctrl_ops == NULL) ||
@@ -1114,6 +1256,32 @@ static int video_s_fmt(FAR struct video_mng_s *priv,
     }
 
   ret = g_video_sensctrl_ops->set_format(fmt);
+  if (ret != OK)
+    {
+      return ret;
+    }
+
+  /* Remember the image size to size driver allocated buffers.  Without a
+   * size from the user, assume 2 bytes per pixel, which also bounds JPEG.
+   */
+
+  type_inf = get_video_type_inf(priv, fmt->type);
+  if (type_inf != NULL)
+    {
+      sizeimage = fmt->fmt.pix.sizeimage;
+      if (sizeimage == 0)
+        {
+          sizeimage = (uint32_t)fmt->fmt.pix.width *
+                      fmt->fmt.pix.height * 2;
+          if (fmt->fmt.pix.pixelformat == V4L2_PIX_FMT_JPEG_WITH_SUBIMG)
+            {
+              sizeimage += (uint32_t)fmt->fmt.pix.subimg_width *
+                           fmt->fmt.pix.subimg_height * 2;
+            }
+        }
+
+      type_inf->sizeimage = sizeimage;
+    }
 
   return ret;
 }
@@ -1182,6 +1350,10 @@ static int video_streamon(FAR struct video_mng_s *vmng,
     }
   else
     {
+      type_inf->sequence = 0;
+      type_inf->frames   = 0;
+      type_inf->dropped  = 0;
+
       next_video_state = estimate_next_video_state
                           (vmng, CAUSE_VIDEO_START);
       change_video_state(vmng, next_video_state);
@@ -1192,6 +1364,31 @@ static int video_streamon(FAR struct video_mng_s *vmng,
   return ret;
 }
 
+static int video_g_framestat(FAR struct video_mng_s *vmng,
+                             FAR struct v4l2_framestat *stat)
+{
+  FAR video_type_inf_t *type_inf;
+  irqstate_t           flags;
+
+  if ((vmng == NULL) || (stat == NULL))
+    {
+      return -EINVAL;
+    }
+
+  type_inf = get_video_type_inf(vmng, stat->type);
+  if (type_inf == NULL)
+    {
+      return -EINVAL;
+    }
+
+  flags = enter_critical_section();
+  stat->frames  = type_inf->frames;
+  stat->dropped = type_inf->dropped;
+  leave_critical_section(flags);
+
+  return OK;
+}
+
 static int video_streamoff(FAR struct video_mng_s *vmng,
                            FAR enum v4l2_buf_type *type)
 {
@@ -1684,6 +1881,33 @@ static int video_ioctl(FAR struct file *filep, int cmd, unsigned long arg)
 
         break;
 
+      case VIDIOC_QUERYBUF:
+        ret = video_querybuf(priv, (FAR struct v4l2_buffer *)arg);
+
+        break;
+
+      case VIDIOC_G_FRAMESTAT:
+        ret = video_g_framestat(priv, (FAR struct v4l2_framestat *)arg);
+
+        break;
+
+      case FIOC_MMAP:
+
+        /* Return the base of the driver allocated buffers.  mmap() adds
+         * the offset reported by VIDIOC_QUERYBUF.
+         */
+
+        if (priv->mmap_base == NULL)
+          {
+            ret = -ENODEV;
+          }
+        else
+          {
+            *(FAR void **)((uintptr_t)arg) = priv->mmap_base;
+          }
+
+        break;
+
       case VIDIOC_CANCEL_DQBUF:
         ret = video_cancel_dqbuf(priv, (FAR enum v4l2_buf_type)arg);
 
@@ -2010,7 +2234,16 @@ int video_common_notify_dma_done(uint8_t  err_code,
     }
 
   type_inf->bufinf.vbuf_dma->buf.bytesused = datasize;
-  video_framebuff_dma_done(&type_inf->bufinf);
+  type_inf->bufinf.vbuf_dma->buf.sequence  = (uint16_t)type_inf->sequence++;
+  type_inf->bufinf.vbuf_dma->buf.timestamp.tv_sec
+    = vmng->frame_start.tv_sec;
+  type_inf->bufinf.vbuf_dma->buf.timestamp.tv_usec
+    = vmng->frame_start.tv_nsec / NSEC_PER_USEC;
+  type_inf->frames++;
+
+  /* In RING mode, the oldest frame may be about to be overwritten */
+
+  type_inf->dropped += video_framebuff_dma_done(&type_inf->bufinf);
 
   if (is_sem_waited(&type_inf->wait_dma.dqbuf_wait_flg))
     {
@@ -2059,3 +2292,33 @@ int video_common_notify_dma_done(uint8_t  err_code,
 
   return OK;
 }
+
+/* Callback function which device driver call at the start of each frame.
+ * This function should be called in interrupt handler or
+ * in critical section.
+ */
+
+int video_common_notify_vsync(FAR void *priv)
+{
+  FAR video_mng_t *vmng = (FAR video_mng_t *)priv;
+
+  if (vmng == NULL)
+    {
+      return -EINVAL;
+    }
+
+  clock_systimespec(&vmng->frame_start);
+
+  /* A video frame that starts while streaming but without a buffer to
+   * capture it into is lost.  Still capture pauses video on purpose.
+   */
+
+  if ((vmng->video_inf.state == VIDEO_STATE_STREAMON) &&
+      !is_taking_still_picture(vmng))
+    {
+      vmng->video_inf.sequence++;
+      vmng->video_inf.dropped++;
+    }
+
+  return OK;
+}
@@ -242,18 +242,25 @@ vbuf_container_t *video_framebuff_get_dma_container(video_framebuff_t *fbuf)
   return ret;
 }
 
-void video_framebuff_dma_done(video_framebuff_t *fbuf)
+int video_framebuff_dma_done(video_framebuff_t *fbuf)
 {
+  int dropped = 0;
+
   fbuf->vbuf_dma = NULL;
   if (fbuf->vbuf_next_dma)
     {
       fbuf->vbuf_next_dma = fbuf->vbuf_next_dma->next;
       if (fbuf->vbuf_next_dma == fbuf->vbuf_top)  /* RING mode case. */
         {
+          /* The oldest frame will be overwritten by the next DMA */
+
           fbuf->vbuf_top  = fbuf->vbuf_top->next;
           fbuf->vbuf_tail = fbuf->vbuf_tail->next;
+          dropped = 1;
         }
     }
+
+  return dropped;
 }
 
 void video_framebuff_change_mode(video_framebuff_t  *fbuf,
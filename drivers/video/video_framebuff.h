@@ -82,7 +82,7 @@ vbuf_container_t *video_framebuff_get_dma_container
                        (video_framebuff_t *fbuf);
 vbuf_container_t *video_framebuff_pop_curr_container
                        (video_framebuff_t *fbuf);
-void              video_framebuff_dma_done
+int               video_framebuff_dma_done
                        (video_framebuff_t *fbuf);
 void              video_framebuff_change_mode
                        (video_framebuff_t *fbuf, enum v4l2_buf_mode mode);
@@ -50,6 +50,8 @@
 #include <errno.h>
 #include <debug.h>
 
+#include <nuttx/irq.h>
+#include <nuttx/semaphore.h>
 #include <nuttx/wireless/bluetooth/bt_core.h>
 #include <nuttx/wireless/bluetooth/bt_hci.h>
 #include <nuttx/wireless/bluetooth/bt_driver.h>
@@ -61,241 +63,375 @@
  * Private Functions
  ****************************************************************************/
 
-static ssize_t btuart_read(FAR struct btuart_upperhalf_s *upper,
-                           FAR uint8_t *buffer, size_t buflen,
-                           size_t minread)
-{
-  FAR const struct btuart_lowerhalf_s *lower;
-  ssize_t nread;
-  ssize_t ntotal = 0;
+/****************************************************************************
+ * Name: btuart_rxdeliver
+ *
+ * Description:
+ *   Pass a complete packet to the stack and get ready for the next one.
+ *
+ ****************************************************************************/
 
-  wlinfo("buflen %lu minread %lu\n",
-         (unsigned long)buflen, (unsigned long)minread);
+static void btuart_rxdeliver(FAR struct btuart_upperhalf_s *upper)
+{
+  FAR struct bt_buf_s *buf = upper->rxbuf;
 
-  DEBUGASSERT(upper != NULL && upper->lower != NULL);
-  lower = upper->lower;
-  DEBUGASSERT(lower->read != NULL);
+  upper->rxbuf    = NULL;
+  upper->rxtype   = 0;
+  upper->rxhdrlen = 0;
 
-  while (buflen > 0)
+  if (buf != NULL)
     {
-      nread = lower->read(lower, buffer, buflen);
-      if (nread == 0)
-        {
-          wlwarn("Got zero bytes from UART\n");
-          if (ntotal < minread)
-            {
-              continue;
-            }
-
-          break;
-        }
-      else if (nread < 0)
-        {
-          wlwarn("Returned error %d\n", nread);
-          return nread;
-        }
-
-      wlinfo("read %ld remaining %lu\n",
-             (long)nread, (unsigned long)(buflen - nread));
-
-      buflen -= nread;
-      ntotal += nread;
-      buffer += nread;
+      wlinfo("Full packet received\n");
+      BT_DUMP("Received",  buf->data, buf->len);
+      bt_hci_receive(buf);
     }
-
-  return ntotal;
 }
 
-static FAR struct bt_buf_s *btuart_evt_recv(FAR struct btuart_upperhalf_s *upper,
-                                            FAR unsigned int *hdrlen)
+/****************************************************************************
+ * Name: btuart_rxheader
+ *
+ * Description:
+ *   The HCI header of a packet is complete.  Allocate a buffer for the
+ *   packet and copy the header into it.  If no buffer is available, or the
+ *   payload does not fit, the payload is discarded.
+ *
+ ****************************************************************************/
+
+static void btuart_rxheader(FAR struct btuart_upperhalf_s *upper)
 {
   FAR struct bt_buf_s *buf;
-  struct bt_hci_evt_hdr_s hdr;
-  ssize_t nread;
+  unsigned int hdrlen;
 
-  /* We can ignore the return value since we pass buflen == minread */
+  if (upper->rxtype == H4_EVT)
+    {
+      buf    = bt_buf_alloc(BT_EVT, NULL, 0);
+      hdrlen = upper->rxhdr[1];
+    }
+  else
+    {
+      buf    = bt_buf_alloc(BT_ACL_IN, NULL, 0);
+      hdrlen = upper->rxhdr[2] | ((unsigned int)upper->rxhdr[3] << 8);
+    }
 
-  nread = btuart_read(upper, (FAR uint8_t *)&hdr,
-                      sizeof(struct bt_hci_evt_hdr_s),
-                      sizeof(struct bt_hci_evt_hdr_s));
+  wlinfo("hdrlen %u\n", hdrlen);
 
-  if (nread != sizeof(struct bt_hci_evt_hdr_s))
+  if (buf == NULL)
     {
-      wlerr("ERROR: btuart_read returned %ld\n", (long)nread);
-      return NULL;
+      wlerr("ERROR: No available %s buffers!\n",
+            upper->rxtype == H4_EVT ? "event" : "ACL");
     }
-
-  buf = bt_buf_alloc(BT_EVT, NULL, 0);
-  if (buf != NULL)
+  else if (upper->rxhdrlen + hdrlen > bt_buf_tailroom(buf))
     {
-      memcpy(bt_buf_extend(buf, sizeof(struct bt_hci_evt_hdr_s)), &hdr,
-             sizeof(struct bt_hci_evt_hdr_s));
+      wlerr("ERROR: Not enough space in buffer\n");
+      bt_buf_release(buf);
+      buf = NULL;
     }
   else
     {
-      wlerr("ERROR: No available event buffers!\n");
+      memcpy(bt_buf_extend(buf, upper->rxhdrlen), upper->rxhdr,
+             upper->rxhdrlen);
     }
 
-  *hdrlen = (int)hdr.len;
+  /* With no buffer, the payload is received and discarded */
 
-  wlinfo("hdrlen %u\n", hdr.len);
-  return buf;
+  upper->rxbuf       = buf;
+  upper->rxremaining = hdrlen;
+
+  if (hdrlen == 0)
+    {
+      btuart_rxdeliver(upper);
+    }
 }
 
-static FAR struct bt_buf_s *btuart_acl_recv(FAR struct btuart_upperhalf_s *upper,
-                                            FAR unsigned int *hdrlen)
+/****************************************************************************
+ * Name: btuart_rxparse
+ *
+ * Description:
+ *   Parse a chunk of received data in place.  The chunk may hold the ends
+ *   and beginnings of several packets.
+ *
+ ****************************************************************************/
+
+static void btuart_rxparse(FAR struct btuart_upperhalf_s *upper,
+                           FAR const uint8_t *data, size_t len)
 {
+  FAR const struct btuart_lowerhalf_s *lower = upper->lower;
   FAR struct bt_buf_s *buf;
-  struct bt_hci_acl_hdr_s hdr;
-  ssize_t nread;
+  size_t ncopy;
+  ssize_t ndrained;
+  uint8_t hdrsize;
+
+  while (len > 0)
+    {
+      /* Beginning of a new packet.  The first byte is the packet type. */
+
+      if (upper->rxtype == 0)
+        {
+          if (*data != H4_EVT && *data != H4_ACL)
+            {
+              /* Lost synchronization.  Discard the received data. */
 
-  /* We can ignore the return value since we pass buflen == minread */
+              wlerr("ERROR: Unknown H4 type %u\n", *data);
+              ndrained = lower->rxdrain(lower);
+              wlwarn("WARNING: Discarded %ld bytes\n",
+                     (long)(len + ndrained));
+              return;
+            }
 
-  nread = btuart_read(upper, (FAR uint8_t *)&hdr,
-                      sizeof(struct bt_hci_acl_hdr_s),
-                      sizeof(struct bt_hci_acl_hdr_s));
+          upper->rxtype   = *data++;
+          upper->rxhdrlen = 0;
+          len--;
+          continue;
+        }
 
-  if (nread != sizeof(struct bt_hci_acl_hdr_s))
-    {
-      wlerr("ERROR: btuart_read returned %ld\n", (long)nread);
-      return NULL;
-    }
+      /* Collect the HCI header */
 
-  buf = bt_buf_alloc(BT_ACL_IN, NULL, 0);
-  if (buf != NULL)
-    {
-      memcpy(bt_buf_extend(buf, sizeof(struct bt_hci_acl_hdr_s)), &hdr,
-             sizeof(struct bt_hci_acl_hdr_s));
-    }
-  else
-    {
-      wlerr("ERROR: No available ACL buffers!\n");
-    }
+      hdrsize = upper->rxtype == H4_EVT ?
+                sizeof(struct bt_hci_evt_hdr_s) :
+                sizeof(struct bt_hci_acl_hdr_s);
+
+      if (upper->rxhdrlen < hdrsize)
+        {
+          ncopy = hdrsize - upper->rxhdrlen;
+          if (ncopy > len)
+            {
+              ncopy = len;
+            }
+
+          memcpy(&upper->rxhdr[upper->rxhdrlen], data, ncopy);
+          upper->rxhdrlen += ncopy;
+          data            += ncopy;
+          len             -= ncopy;
+
+          if (upper->rxhdrlen == hdrsize)
+            {
+              btuart_rxheader(upper);
+            }
+
+          continue;
+        }
+
+      /* Copy the payload into the packet buffer */
+
+      ncopy = upper->rxremaining;
+      if (ncopy > len)
+        {
+          ncopy = len;
+        }
+
+      buf = upper->rxbuf;
+      if (buf != NULL)
+        {
+          memcpy(bt_buf_extend(buf, ncopy), data, ncopy);
+        }
 
-  *hdrlen = BT_LE162HOST(hdr.len);
+      upper->rxremaining -= ncopy;
+      data               += ncopy;
+      len                -= ncopy;
 
-  wlinfo("hdrlen %u\n", *hdrlen);
-  return buf;
+      if (upper->rxremaining == 0)
+        {
+          btuart_rxdeliver(upper);
+        }
+    }
 }
 
+/****************************************************************************
+ * Name: btuart_rxwork
+ *
+ * Description:
+ *   Read all available data from the lower half and pass every complete
+ *   packet to the stack.  Incomplete packets are kept until the next Rx
+ *   callback.
+ *
+ ****************************************************************************/
+
 static void btuart_rxwork(FAR void *arg)
 {
   FAR struct btuart_upperhalf_s *upper;
   FAR const struct btuart_lowerhalf_s *lower;
-  static FAR struct bt_buf_s *buf;
-  static unsigned int hdrlen;
-  static int remaining;
+  FAR struct bt_buf_s *buf;
+  irqstate_t flags;
   ssize_t nread;
-  uint8_t type;
+  bool full;
 
   upper = (FAR struct btuart_upperhalf_s *)arg;
   DEBUGASSERT(upper != NULL && upper->lower != NULL);
   lower = upper->lower;
+  DEBUGASSERT(lower->read != NULL);
 
-  /* Beginning of a new packet.  Read the first byte to get the packet type. */
+  for (; ; )
+    {
+      upper->rxpending = false;
+      buf = upper->rxbuf;
 
-  buf    = NULL;
-  hdrlen = 0;
+      if (buf != NULL && upper->rxhdrlen > 0 && upper->rxremaining > 0)
+        {
+          /* The header is complete.  Read the payload straight into the
+           * packet buffer.
+           */
 
-  nread = btuart_read(upper, &type, 1, 0);
-  if (nread != 1)
-    {
-      wlwarn("WARNING: Unable to read H4 packet type: %ld\n",
-             (long)nread);
-      goto errout_with_busy;
-    }
+          nread = lower->read(lower, bt_buf_tail(buf), upper->rxremaining);
+          full  = (nread == upper->rxremaining);
+          if (nread > 0)
+            {
+              wlinfo("Received %ld bytes\n", (long)nread);
+
+              buf->len           += nread;
+              upper->rxremaining -= nread;
+              if (upper->rxremaining == 0)
+                {
+                  btuart_rxdeliver(upper);
+                }
+            }
+        }
+      else
+        {
+          /* Read a chunk and parse it in place */
 
-  switch (type)
-    {
-      case H4_EVT:
-        buf = btuart_evt_recv(upper, &hdrlen);
-        break;
+          nread = lower->read(lower, upper->rxbuffer,
+                              CONFIG_BLUETOOTH_UART_RXBUFSIZE);
+          full  = (nread == CONFIG_BLUETOOTH_UART_RXBUFSIZE);
+          if (nread > 0)
+            {
+              btuart_rxparse(upper, upper->rxbuffer, nread);
+            }
+        }
 
-      case H4_ACL:
-        buf = btuart_acl_recv(upper, &hdrlen);
-        break;
+      if (nread < 0)
+        {
+          wlwarn("Returned error %d\n", nread);
+        }
 
-      default:
-        wlerr("ERROR: Unknown H4 type %u\n", type);
-        goto errout_with_busy;
-    }
+      /* A full read probably left more data behind.  Otherwise continue
+       * only if the lower half reported new data in the meantime.
+       */
 
-  if (buf == NULL)
-    {
-      /* Failed to allocate a buffer.  Drain the Rx data and fail the read. */
+      if (!full)
+        {
+          flags = enter_critical_section();
+          if (!upper->rxpending)
+            {
+              upper->busy = false;
+              leave_critical_section(flags);
+              return;
+            }
 
-      nread = lower->rxdrain(lower);
-      wlwarn("WARNING: Discarded %ld bytes\n", (long)nread);
-      goto errout_with_busy;
-    }
-  else if ((hdrlen - 1) > bt_buf_tailroom(buf))
-    {
-      wlerr("ERROR: Not enough space in buffer\n");
-      goto errout_with_buf;
+          leave_critical_section(flags);
+        }
     }
+}
+
+static void btuart_rxcallback(FAR const struct btuart_lowerhalf_s *lower,
+                              FAR void *arg)
+{
+  FAR struct btuart_upperhalf_s *upper;
+  irqstate_t flags;
+  int ret;
+
+  DEBUGASSERT(lower != NULL && arg != NULL);
+  upper = (FAR struct btuart_upperhalf_s *)arg;
 
-  remaining = hdrlen;
-  wlinfo("Need to get %u bytes\n", remaining);
+  flags = enter_critical_section();
+  if (upper->busy)
+    {
+      /* Let the running work pick up the new data */
 
-  while (remaining > 0)
+      upper->rxpending = true;
+    }
+  else
     {
-      nread = btuart_read(upper, bt_buf_tail(buf), remaining, 0);
-      if (nread < 0)
+      upper->busy = true;
+      ret = work_queue(HPWORK, &upper->work, btuart_rxwork, arg, 0);
+      if (ret < 0)
         {
-          wlerr("ERROR: Read returned error %d\n", nread);
-          goto errout_with_buf;
+          upper->busy = false;
+          wlerr("ERROR: work_queue failed: %d\n", ret);
         }
+    }
 
-      wlinfo("Received %ld bytes\n", (long)nread);
+  leave_critical_section(flags);
+}
 
-      buf->len  += nread;
-      remaining -= nread;
-    }
+/****************************************************************************
+ * Name: btuart_write
+ *
+ * Description:
+ *   Write the whole buffer to the lower half.
+ *
+ ****************************************************************************/
 
-  wlinfo("Full packet received\n");
+static int btuart_write(FAR const struct btuart_lowerhalf_s *lower,
+                        FAR const uint8_t *buffer, size_t buflen)
+{
+  ssize_t nwritten;
 
-  /* Drain any un-read bytes from the Rx buffer */
+  nwritten = lower->write(lower, buffer, buflen);
+  if (nwritten == buflen)
+    {
+      return OK;
+    }
 
-  nread = lower->rxdrain(lower);
-  if (nread > 0)
+  if (nwritten < 0)
     {
-      wlwarn("WARNING: Discarded %ld bytes\n", (long)nread);
+      return (int)nwritten;
     }
 
-  /* Pass buffer to the stack */
+  return -EIO;
+}
+
+/****************************************************************************
+ * Name: btuart_txflush
+ *
+ * Description:
+ *   Write the collected ACL packets.
+ *
+ * Assumptions:
+ *   The caller holds txlock.
+ *
+ ****************************************************************************/
 
-  BT_DUMP("Received",  buf->data, buf->len);
-  upper->busy = false;
-  bt_hci_receive(buf);
-  return;
+#if CONFIG_BLUETOOTH_UART_TXBUFSIZE > 0
+static int btuart_txflush(FAR struct btuart_upperhalf_s *upper)
+{
+  int ret = OK;
 
-errout_with_buf:
-  bt_buf_release(buf);
+  if (upper->txlen > 0)
+    {
+      ret = btuart_write(upper->lower, upper->txbuffer, upper->txlen);
+      upper->txlen = 0;
+    }
 
-errout_with_busy:
-  upper->busy = false;
-  return;
+  return ret;
 }
+#endif
 
-static void btuart_rxcallback(FAR const struct btuart_lowerhalf_s *lower,
-                              FAR void *arg)
+/****************************************************************************
+ * Name: btuart_txwork
+ *
+ * Description:
+ *   Write the collected ACL packets once the sender has yielded.
+ *
+ ****************************************************************************/
+
+#if CONFIG_BLUETOOTH_UART_TXBUFSIZE > 0
+static void btuart_txwork(FAR void *arg)
 {
   FAR struct btuart_upperhalf_s *upper;
+  int ret;
 
-  DEBUGASSERT(lower != NULL && arg != NULL);
   upper = (FAR struct btuart_upperhalf_s *)arg;
 
-  if (!upper->busy)
+  nxsem_wait_uninterruptible(&upper->txlock);
+  ret = btuart_txflush(upper);
+  nxsem_post(&upper->txlock);
+
+  if (ret < 0)
     {
-      upper->busy = true;
-      int ret = work_queue(HPWORK, &upper->work, btuart_rxwork, arg, 0);
-      if (ret < 0)
-        {
-          upper->busy = false;
-          wlerr("ERROR: work_queue failed: %d\n", ret);
-        }
+      wlerr("ERROR: Failed to write ACL data: %d\n", ret);
     }
 }
+#endif
 
 /****************************************************************************
  * Public Functions
@@ -306,7 +442,7 @@ int btuart_send(FAR const struct bt_driver_s *dev, FAR struct bt_buf_s *buf)
   FAR struct btuart_upperhalf_s *upper;
   FAR const struct btuart_lowerhalf_s *lower;
   FAR uint8_t *type;
-  ssize_t nwritten;
+  int ret;
 
   upper = (FAR struct btuart_upperhalf_s *)dev;
   DEBUGASSERT(upper != NULL && upper->lower != NULL);
@@ -341,18 +477,47 @@ int btuart_send(FAR const struct bt_driver_s *dev, FAR struct bt_buf_s *buf)
 
   BT_DUMP("Sending",  buf->data, buf->len);
 
-  nwritten = lower->write(lower, buf->data, buf->len);
-  if (nwritten == buf->len)
+#if CONFIG_BLUETOOTH_UART_TXBUFSIZE > 0
+  nxsem_wait_uninterruptible(&upper->txlock);
+
+  if (buf->type == BT_ACL_OUT && buf->len <= CONFIG_BLUETOOTH_UART_TXBUFSIZE)
     {
-      return OK;
-    }
+      /* Append the packet to the collected ACL packets.  They are written
+       * when the buffer is full or when the sender yields to the work
+       * queue.
+       */
 
-  if (nwritten < 0)
+      ret = OK;
+      if (upper->txlen + buf->len > CONFIG_BLUETOOTH_UART_TXBUFSIZE)
+        {
+          ret = btuart_txflush(upper);
+        }
+
+      memcpy(&upper->txbuffer[upper->txlen], buf->data, buf->len);
+      upper->txlen += buf->len;
+
+      if (work_available(&upper->txwork))
+        {
+          work_queue(HPWORK, &upper->txwork, btuart_txwork, upper, 0);
+        }
+    }
+  else
     {
-      return (int)nwritten;
+      /* Keep the packet order: write the collected packets first */
+
+      ret = btuart_txflush(upper);
+      if (ret >= 0)
+        {
+          ret = btuart_write(lower, buf->data, buf->len);
+        }
     }
 
-  return -EIO;
+  nxsem_post(&upper->txlock);
+#else
+  ret = btuart_write(lower, buf->data, buf->len);
+#endif
+
+  return ret;
 }
 
 int btuart_open(FAR const struct bt_driver_s *dev)
@@ -374,6 +539,24 @@ int btuart_open(FAR const struct bt_driver_s *dev)
 
   lower->rxdrain(lower);
 
+  /* Start with no partial packet */
+
+  if (upper->rxbuf != NULL)
+    {
+      bt_buf_release(upper->rxbuf);
+      upper->rxbuf = NULL;
+    }
+
+  upper->rxtype      = 0;
+  upper->rxhdrlen    = 0;
+  upper->rxremaining = 0;
+  upper->rxpending   = false;
+
+#if CONFIG_BLUETOOTH_UART_TXBUFSIZE > 0
+  nxsem_init(&upper->txlock, 0, 1);
+  upper->txlen = 0;
+#endif
+
   /* Attach the Rx event handler */
 
   lower->rxattach(lower, btuart_rxcallback, upper);
@@ -45,7 +45,9 @@
 
 #include <nuttx/config.h>
 
+#include <stdint.h>
 #include <stdbool.h>
+#include <semaphore.h>
 #include <nuttx/wqueue.h>
 #include <nuttx/wireless/bluetooth/bt_driver.h>
 
@@ -55,6 +57,18 @@
 
 #define H4_HEADER_SIZE  1
 
+/* The largest HCI packet header (ACL) */
+
+#define H4_MAXHDR_SIZE  4
+
+#ifndef CONFIG_BLUETOOTH_UART_RXBUFSIZE
+#  define CONFIG_BLUETOOTH_UART_RXBUFSIZE 256
+#endif
+
+#ifndef CONFIG_BLUETOOTH_UART_TXBUFSIZE
+#  define CONFIG_BLUETOOTH_UART_TXBUFSIZE 0
+#endif
+
 #define H4_CMD           0x01
 #define H4_ACL           0x02
 #define H4_SCO           0x03
@@ -90,6 +104,32 @@ struct btuart_upperhalf_s
 
   struct work_s work;
   volatile bool busy;
+  volatile bool rxpending;      /* More Rx data arrived while busy */
+
+  /* H4 receiver state.  A packet may span several Rx callbacks. */
+
+  FAR struct bt_buf_s *rxbuf;   /* Packet being received */
+  uint8_t rxtype;               /* H4 packet type; 0 while waiting for one */
+  uint8_t rxhdrlen;             /* Number of HCI header bytes received */
+  uint8_t rxhdr[H4_MAXHDR_SIZE]; /* The HCI header */
+  uint16_t rxremaining;         /* Payload bytes still to be received */
+
+  /* Rx data is read from the lower half in chunks of up to this size and
+   * parsed in place.
+   */
+
+  uint8_t rxbuffer[CONFIG_BLUETOOTH_UART_RXBUFSIZE];
+
+#if CONFIG_BLUETOOTH_UART_TXBUFSIZE > 0
+  /* Outgoing ACL packets are collected here and written to the UART in
+   * one write.
+   */
+
+  sem_t txlock;                 /* Serializes senders and the Tx work */
+  struct work_s txwork;         /* Writes the collected packets */
+  uint16_t txlen;               /* Number of bytes in txbuffer */
+  uint8_t txbuffer[CONFIG_BLUETOOTH_UART_TXBUFSIZE];
+#endif
 };
 
 /****************************************************************************
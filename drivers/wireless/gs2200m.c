@@ -160,7 +160,8 @@ struct pkt_dat_s
   FAR char           *msg[NRESPMSG];
   uint16_t           remain; /* bulk data length to be read */
   uint16_t           len;    /* bulk data length */
-  FAR uint8_t        *data;  /* bulk data */
+  FAR uint8_t        *data;  /* bulk data (points into frame) */
+  FAR uint8_t        *frame; /* received SPI frame holding the bulk data */
 };
 
 struct pkt_ctx_s
@@ -169,6 +170,7 @@ struct pkt_ctx_s
   enum pkt_state_e state;
   FAR uint8_t      *ptr;
   FAR uint8_t      *head;
+  FAR uint8_t      *end;
   char             cid;
   uint16_t         dlen;
 };
@@ -194,7 +196,6 @@ struct gs2200m_dev_s
   uint16_t             pkt_q_cnt[16];
   uint16_t             valid_cid_bits;
   uint16_t             aip_cid_bits;
-  uint8_t              tx_buff[MAX_PKT_LEN];
   struct net_driver_s  net_dev;
   uint8_t              op_mode;
   FAR const struct gs2200m_lower_s *lower;
@@ -447,18 +448,6 @@ static char _notif_q_pop(FAR struct gs2200m_dev_s *dev)
   return cid;
 }
 
-/****************************************************************************
- * Name: _push_data_to_pkt
- ****************************************************************************/
-
-static void _push_data_to_pkt(struct pkt_dat_s *pkt, uint8_t data)
-{
-  ASSERT(pkt->len < MAX_PKT_LEN);
-
-  pkt->data[pkt->len++] = data;
-  pkt->remain = pkt->len;
-}
-
 /****************************************************************************
  * Name: _release_pkt_dat
  ****************************************************************************/
@@ -472,13 +461,15 @@ static void _release_pkt_dat(struct pkt_dat_s *pkt_dat)
       kmm_free(pkt_dat->msg[i]);
     }
 
-  if (pkt_dat->len)
+  if (pkt_dat->frame)
     {
-      kmm_free(pkt_dat->data);
+      kmm_free(pkt_dat->frame);
     }
 
-  pkt_dat->n   = 0;
-  pkt_dat->len = 0;
+  pkt_dat->n     = 0;
+  pkt_dat->len   = 0;
+  pkt_dat->data  = NULL;
+  pkt_dat->frame = NULL;
 }
 
 /****************************************************************************
@@ -854,8 +845,6 @@ static void _read_data(FAR struct gs2200m_dev_s *dev,
 {
   uint8_t req = 0xf5; /* idle character */
 
-  memset(buff, 0, len);
-
   SPI_SELECT(dev->spi, SPIDEV_WIRELESS(0), true);
   SPI_EXCHANGE(dev->spi, &req, buff, len);
   SPI_SELECT(dev->spi, SPIDEV_WIRELESS(0), false);
@@ -919,15 +908,21 @@ retry:
 }
 
 /****************************************************************************
- * Name: gs2200m_hal_write
+ * Name: gs2200m_hal_writev
  * NOTE: See Figure 13,14 Transferring data from MCU to GS node
+ *
+ * The data is given as a prefix (e.g. a bulk data command) and a payload
+ * which are sent back-to-back in one transfer, so that the payload can be
+ * sent directly from the caller's buffer.
  ****************************************************************************/
 
-enum spi_status_e gs2200m_hal_write(FAR struct gs2200m_dev_s *dev,
-                                    const void *data,
-                                    uint16_t txlen)
+static enum spi_status_e gs2200m_hal_writev(FAR struct gs2200m_dev_s *dev,
+                                            FAR const void *prefix,
+                                            uint16_t prefixlen,
+                                            FAR const void *data,
+                                            uint16_t datalen)
 {
-  uint8_t *tx = (uint8_t *)data;
+  uint16_t txlen = prefixlen + datalen;
   uint8_t  hdr[8];
   uint8_t  res[8];
   int n = 0;
@@ -1016,11 +1011,30 @@ retry:
 
   /* 7. Send actual data */
 
-  _write_data(dev, tx, txlen);
+  SPI_SELECT(dev->spi, SPIDEV_WIRELESS(0), true);
+  SPI_SNDBLOCK(dev->spi, prefix, prefixlen);
+
+  if (0 < datalen)
+    {
+      SPI_SNDBLOCK(dev->spi, data, datalen);
+    }
+
+  SPI_SELECT(dev->spi, SPIDEV_WIRELESS(0), false);
 
   return SPI_OK;
 }
 
+/****************************************************************************
+ * Name: gs2200m_hal_write
+ ****************************************************************************/
+
+enum spi_status_e gs2200m_hal_write(FAR struct gs2200m_dev_s *dev,
+                                    const void *data,
+                                    uint16_t txlen)
+{
+  return gs2200m_hal_writev(dev, data, txlen, NULL, 0);
+}
+
 /****************************************************************************
  * Name: gs2200m_hal_read
  ****************************************************************************/
@@ -1233,6 +1247,42 @@ static void _parse_pkt_in_s2(FAR struct pkt_ctx_s *pkt_ctx,
     }
 }
 
+/****************************************************************************
+ * Name: _set_bulk_data
+ *
+ * Let pkt_dat refer to the bulk data which follows the current position
+ * in the received frame, then skip over it.  The data is not copied: the
+ * frame is handed over to pkt_dat in gs2200m_recv_pkt().
+ ****************************************************************************/
+
+static void _set_bulk_data(FAR struct pkt_ctx_s *pkt_ctx,
+                           FAR struct pkt_dat_s *pkt_dat,
+                           enum pkt_type_e type)
+{
+  FAR uint8_t *data = pkt_ctx->ptr + 1;
+  uint16_t avail = (data < pkt_ctx->end) ? pkt_ctx->end - data : 0;
+
+  pkt_dat->data   = data;
+  pkt_dat->len    = MIN(pkt_ctx->dlen, avail);
+  pkt_dat->remain = pkt_dat->len;
+
+  /* Skip the data (NOTE: ptr is incremented in _parse_pkt()) */
+
+  pkt_ctx->ptr += pkt_dat->len;
+  pkt_ctx->dlen -= pkt_dat->len;
+
+  if (0 == pkt_ctx->dlen)
+    {
+      pkt_ctx->state = PKT_START;
+      pkt_ctx->type  = type;
+    }
+  else
+    {
+      wlerr("*** error: bulk data truncated (%d bytes missing) \n",
+            pkt_ctx->dlen);
+    }
+}
+
 /****************************************************************************
  * Name: _parse_pkt_in_s3 (BULK data for TCP)
  ****************************************************************************/
@@ -1262,22 +1312,9 @@ static void _parse_pkt_in_s3(FAR struct pkt_ctx_s *pkt_ctx,
 
       wlinfo("dlen=%d \n", pkt_ctx->dlen);
 
-      /* Allocate memory for the packet */
+      /* Refer to the data in the frame */
 
-      pkt_dat->data = kmm_calloc(pkt_ctx->dlen, 1);
-      ASSERT(pkt_dat->data);
-    }
-  else
-    {
-      _push_data_to_pkt(pkt_dat, *(pkt_ctx->ptr));
-
-      pkt_ctx->dlen--;
-
-      if (0 == pkt_ctx->dlen)
-        {
-          pkt_ctx->state = PKT_START;
-          pkt_ctx->type  = TYPE_BULK_DATA_TCP;
-        }
+      _set_bulk_data(pkt_ctx, pkt_dat, TYPE_BULK_DATA_TCP);
     }
 }
 
@@ -1329,22 +1366,9 @@ static void _parse_pkt_in_s4(FAR struct pkt_ctx_s *pkt_ctx,
 
       wlinfo("dlen=%d \n", pkt_ctx->dlen);
 
-      /* Allocate memory for the packet */
+      /* Refer to the data in the frame */
 
-      pkt_dat->data = kmm_calloc(pkt_ctx->dlen, 1);
-      ASSERT(pkt_dat->data);
-    }
-  else
-    {
-      _push_data_to_pkt(pkt_dat, *(pkt_ctx->ptr));
-
-      pkt_ctx->dlen--;
-
-      if (0 == pkt_ctx->dlen)
-        {
-          pkt_ctx->state = PKT_START;
-          pkt_ctx->type  = TYPE_BULK_DATA_UDP;
-        }
+      _set_bulk_data(pkt_ctx, pkt_dat, TYPE_BULK_DATA_UDP);
     }
 }
 
@@ -1362,6 +1386,7 @@ static enum pkt_type_e _parse_pkt(FAR uint8_t *p, uint16_t len,
   pkt_ctx.type  = TYPE_UNMATCH;
   pkt_ctx.state = PKT_START;
   pkt_ctx.head  = NULL;
+  pkt_ctx.end   = p + len;
   pkt_ctx.cid   = 'z';
   pkt_ctx.dlen  = 0;
 
@@ -1410,7 +1435,9 @@ static enum pkt_type_e gs2200m_recv_pkt(FAR struct gs2200m_dev_s *dev,
   uint16_t len;
   uint8_t *p;
 
-  p = (uint8_t *)kmm_calloc(MAX_PKT_LEN, 1);
+  /* NOTE: one extra byte to terminate the frame for sscanf() */
+
+  p = (uint8_t *)kmm_malloc(MAX_PKT_LEN + 1);
   ASSERT(p);
 
   s = gs2200m_hal_read(dev, p, &len);
@@ -1421,6 +1448,9 @@ static enum pkt_type_e gs2200m_recv_pkt(FAR struct gs2200m_dev_s *dev,
       goto errout;
     }
 
+  ASSERT(len <= MAX_PKT_LEN);
+  p[len] = '\0';
+
   wlinfo("+++ len=%d pkt_dat=%p \n", len, pkt_dat);
 
   /* Parse the received packet */
@@ -1435,10 +1465,23 @@ static enum pkt_type_e gs2200m_recv_pkt(FAR struct gs2200m_dev_s *dev,
   if (pkt_dat)
     {
       pkt_dat->type = t;
+
+      /* If bulk data was found, hand the frame over to pkt_dat */
+
+      if (pkt_dat->data)
+        {
+          pkt_dat->frame = p;
+          p = NULL;
+        }
     }
 
 errout:
-  kmm_free(p);
+
+  if (p)
+    {
+      kmm_free(p);
+    }
+
   return t;
 }
 
@@ -1873,7 +1916,6 @@ static enum pkt_type_e gs2200m_send_bulk(FAR struct gs2200m_dev_s *dev,
 {
   enum pkt_type_e   r;
   enum spi_status_e s;
-  int  bulk_hdr_size;
   char digits[5];
   char cmd[32];
 
@@ -1913,13 +1955,9 @@ static enum pkt_type_e gs2200m_send_bulk(FAR struct gs2200m_dev_s *dev,
                digits);
     }
 
-  bulk_hdr_size = strlen(cmd);
-  memcpy(dev->tx_buff, cmd, bulk_hdr_size);
-  memcpy(dev->tx_buff + bulk_hdr_size, msg->buf, msg->len);
-
-  /* Send the bulk data */
+  /* Send the bulk data directly from msg->buf */
 
-  s = gs2200m_hal_write(dev, (char *)dev->tx_buff, msg->len + bulk_hdr_size);
+  s = gs2200m_hal_writev(dev, cmd, strlen(cmd), msg->buf, msg->len);
 
   if (s == SPI_TIMEOUT)
     {
@@ -267,9 +267,13 @@ int mrf24j40_txnotify(FAR struct ieee802154_radio_s *radio, bool gts)
           work_queue(HPWORK, &dev->gts_pollwork, mrf24j40_dopoll_gts, dev, 0);
         }
     }
-  else
+  else if (!dev->csma_busy)
     {
-      /* Is our single work structure available?  It may not be if there are
+      /* If a CSMA transaction is in flight, there is nothing to do:  The
+       * Tx completion polls for the next frame directly so that queued
+       * frames go out back-to-back without a trip through the work queue.
+       *
+       * Is our single work structure available?  It may not be if there are
        * pending interrupt actions and we will have to ignore the Tx
        * availability action.
        */
@@ -69,6 +69,16 @@
 #  define AIO_HAVE_PSOCK
 #endif
 
+/* The low priority work queue is boosted to the priority of the waiting
+ * task.  The dedicated AIO work queues run at a fixed priority.
+ */
+
+#undef AIO_HAVE_PRIOBOOST
+
+#if defined(CONFIG_PRIORITY_INHERITANCE) && !defined(CONFIG_FS_AIO_WORKQUEUE)
+#  define AIO_HAVE_PRIOBOOST
+#endif
+
 /****************************************************************************
  * Public Types
  ****************************************************************************/
@@ -92,6 +102,9 @@ struct aio_container_s
     FAR void *ptr;                 /* Generic pointer to FAR data */
   } u;
   struct work_s aioc_work;         /* Used to defer I/O to the work thread */
+#ifdef CONFIG_FS_AIO_WORKQUEUE
+  FAR struct kwork_wqueue_s *aioc_wqueue; /* The work queue used for the I/O */
+#endif
   pid_t aioc_pid;                  /* ID of the waiting task */
 #ifdef CONFIG_PRIORITY_INHERITANCE
   uint8_t aioc_prio;               /* Priority of the waiting task */
@@ -234,7 +247,9 @@ FAR struct aiocb *aioc_decant(FAR struct aio_container_s *aioc);
  * Name: aio_queue
  *
  * Description:
- *   Schedule the asynchronous I/O on the low priority work queue
+ *   Schedule the asynchronous I/O on the low priority work queue or, if
+ *   CONFIG_FS_AIO_WORKQUEUE is selected, on the AIO work queue of the
+ *   device
  *
  * Input Parameters:
  *   arg - Worker argument.  In this case, a pointer to an instance of
@@ -248,6 +263,24 @@ FAR struct aiocb *aioc_decant(FAR struct aio_container_s *aioc);
 
 int aio_queue(FAR struct aio_container_s *aioc, worker_t worker);
 
+/****************************************************************************
+ * Name: aio_cancelwork
+ *
+ * Description:
+ *   Remove the asynchronous I/O from its work queue if it has not yet been
+ *   started.
+ *
+ * Input Parameters:
+ *   aioc - Pointer to the AIO control block container
+ *
+ * Returned Value:
+ *   Zero (OK) if the I/O was removed from the work queue.  -ENOENT if the
+ *   I/O has already been started.
+ *
+ ****************************************************************************/
+
+int aio_cancelwork(FAR struct aio_container_s *aioc);
+
 /****************************************************************************
  * Name: aio_signal
  *
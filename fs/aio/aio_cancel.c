@@ -138,7 +138,7 @@ int aio_cancel(int fildes, FAR struct aiocb *aiocbp)
                * first case.
                */
 
-              status = work_cancel(LPWORK, &aioc->aioc_work);
+              status = aio_cancelwork(aioc);
               if (status >= 0)
                 {
                   /* Remove the container from the list of pending transfers */
@@ -193,7 +193,7 @@ int aio_cancel(int fildes, FAR struct aiocb *aiocbp)
                * first case.
                */
 
-              status = work_cancel(LPWORK, &aioc->aioc_work);
+              status = aio_cancelwork(aioc);
               if (status >= 0)
                 {
                   /* Remove the container from the list of pending transfers */
@@ -50,15 +50,82 @@
 
 #ifdef CONFIG_FS_AIO
 
+/****************************************************************************
+ * Private Data
+ ****************************************************************************/
+
+#ifdef CONFIG_FS_AIO_WORKQUEUE
+/* The AIO work queues.  Each has a single worker thread and is created when
+ * it is first needed.
+ */
+
+static FAR struct kwork_wqueue_s *g_aio_wqueue[CONFIG_FS_AIO_NQUEUES];
+#endif
+
 /****************************************************************************
  * Private Functions
  ****************************************************************************/
 
+/****************************************************************************
+ * Name: aio_wqueue
+ *
+ * Description:
+ *   Select the work queue for an asynchronous I/O.  The I/O on one device
+ *   (the inode of a driver or of a mountpoint, or a socket) always uses the
+ *   same work queue so that it is processed in order.  Different devices
+ *   are spread over the work queues so that their I/O runs in parallel.
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_FS_AIO_WORKQUEUE
+static FAR struct kwork_wqueue_s *
+aio_wqueue(FAR struct aio_container_s *aioc)
+{
+  FAR struct kwork_wqueue_s *wqueue;
+  uintptr_t key;
+  int ndx;
+
+#ifdef AIO_HAVE_PSOCK
+  if (aioc->aioc_aiocbp->aio_fildes >= CONFIG_NFILE_DESCRIPTORS)
+    {
+      key = (uintptr_t)aioc->u.aioc_psock;
+    }
+  else
+#endif
+    {
+      key = (uintptr_t)aioc->u.aioc_filep->f_inode;
+    }
+
+  /* Hash the address.  The low order bits are zero due to alignment. */
+
+  key ^= key >> 12;
+  ndx  = (key >> 4) % CONFIG_FS_AIO_NQUEUES;
+
+  aio_lock();
+  wqueue = g_aio_wqueue[ndx];
+  if (wqueue == NULL)
+    {
+      wqueue = work_queue_create("aio", CONFIG_FS_AIO_PRIORITY,
+                                 CONFIG_FS_AIO_STACKSIZE, 1, 0);
+      g_aio_wqueue[ndx] = wqueue;
+    }
+
+  aio_unlock();
+  return wqueue;
+}
+#endif
+
+/****************************************************************************
+ * Public Functions
+ ****************************************************************************/
+
 /****************************************************************************
  * Name: aio_queue
  *
  * Description:
- *   Schedule the asynchronous I/O on the low priority work queue
+ *   Schedule the asynchronous I/O on the low priority work queue or, if
+ *   CONFIG_FS_AIO_WORKQUEUE is selected, on the AIO work queue of the
+ *   device
  *
  * Input Parameters:
  *   arg - Worker argument.  In this case, a pointer to an instance of
@@ -74,7 +141,7 @@ int aio_queue(FAR struct aio_container_s *aioc, worker_t worker)
 {
   int ret;
 
-#ifdef CONFIG_PRIORITY_INHERITANCE
+#ifdef AIO_HAVE_PRIOBOOST
   /* Prohibit context switches until we complete the queuing */
 
   sched_lock();
@@ -86,15 +153,30 @@ int aio_queue(FAR struct aio_container_s *aioc, worker_t worker)
   lpwork_boostpriority(aioc->aioc_prio);
 #endif
 
+#ifdef CONFIG_FS_AIO_WORKQUEUE
+  /* Schedule the work on the work queue of the device */
+
+  aioc->aioc_wqueue = aio_wqueue(aioc);
+  if (aioc->aioc_wqueue == NULL)
+    {
+      ret = -ENOMEM;
+    }
+  else
+    {
+      ret = work_queue_wq(aioc->aioc_wqueue, &aioc->aioc_work, worker,
+                          aioc, 0);
+    }
+#else
   /* Schedule the work on the low priority worker thread */
 
   ret = work_queue(LPWORK, &aioc->aioc_work, worker, aioc, 0);
+#endif
   if (ret < 0)
     {
       FAR struct aiocb *aiocbp = aioc->aioc_aiocbp;
       DEBUGASSERT(aiocbp);
 
-#ifdef CONFIG_PRIORITY_INHERITANCE
+#ifdef AIO_HAVE_PRIOBOOST
       lpwork_restorepriority(aioc->aioc_prio);
 #endif
       aiocbp->aio_result = ret;
@@ -102,7 +184,7 @@ int aio_queue(FAR struct aio_container_s *aioc, worker_t worker)
       ret = ERROR;
     }
 
-#ifdef CONFIG_PRIORITY_INHERITANCE
+#ifdef AIO_HAVE_PRIOBOOST
   /* Now the low-priority work queue might run at its new priority */
 
   sched_unlock();
@@ -110,4 +192,29 @@ int aio_queue(FAR struct aio_container_s *aioc, worker_t worker)
   return ret;
 }
 
+/****************************************************************************
+ * Name: aio_cancelwork
+ *
+ * Description:
+ *   Remove the asynchronous I/O from its work queue if it has not yet been
+ *   started.
+ *
+ * Input Parameters:
+ *   aioc - Pointer to the AIO control block container
+ *
+ * Returned Value:
+ *   Zero (OK) if the I/O was removed from the work queue.  -ENOENT if the
+ *   I/O has already been started.
+ *
+ ****************************************************************************/
+
+int aio_cancelwork(FAR struct aio_container_s *aioc)
+{
+#ifdef CONFIG_FS_AIO_WORKQUEUE
+  return work_cancel_wq(aioc->aioc_wqueue, &aioc->aioc_work);
+#else
+  return work_cancel(LPWORK, &aioc->aioc_work);
+#endif
+}
+
 #endif /* CONFIG_FS_AIO */
@@ -77,7 +77,7 @@ static void aio_read_worker(FAR void *arg)
   FAR struct aio_container_s *aioc = (FAR struct aio_container_s *)arg;
   FAR struct aiocb *aiocbp;
   pid_t pid;
-#ifdef CONFIG_PRIORITY_INHERITANCE
+#ifdef AIO_HAVE_PRIOBOOST
   uint8_t prio;
 #endif
   ssize_t nread = 0;
@@ -89,7 +89,7 @@ static void aio_read_worker(FAR void *arg)
 
   DEBUGASSERT(aioc && aioc->aioc_aiocbp);
   pid    = aioc->aioc_pid;
-#ifdef CONFIG_PRIORITY_INHERITANCE
+#ifdef AIO_HAVE_PRIOBOOST
   prio   = aioc->aioc_prio;
 #endif
   aiocbp = aioc_decant(aioc);
@@ -139,7 +139,7 @@ static void aio_read_worker(FAR void *arg)
 
   aio_signal(pid, aiocbp);
 
-#ifdef CONFIG_PRIORITY_INHERITANCE
+#ifdef AIO_HAVE_PRIOBOOST
   /* Restore the low priority worker thread default priority */
 
   lpwork_restorepriority(prio);
@@ -77,7 +77,7 @@ static void aio_write_worker(FAR void *arg)
   FAR struct aio_container_s *aioc = (FAR struct aio_container_s *)arg;
   FAR struct aiocb *aiocbp;
   pid_t pid;
-#ifdef CONFIG_PRIORITY_INHERITANCE
+#ifdef AIO_HAVE_PRIOBOOST
   uint8_t prio;
 #endif
   ssize_t nwritten = 0;
@@ -90,7 +90,7 @@ static void aio_write_worker(FAR void *arg)
 
   DEBUGASSERT(aioc && aioc->aioc_aiocbp);
   pid    = aioc->aioc_pid;
-#ifdef CONFIG_PRIORITY_INHERITANCE
+#ifdef AIO_HAVE_PRIOBOOST
   prio   = aioc->aioc_prio;
 #endif
   aiocbp = aioc_decant(aioc);
@@ -166,7 +166,7 @@ errout:
 
   aio_signal(pid, aiocbp);
 
-#ifdef CONFIG_PRIORITY_INHERITANCE
+#ifdef AIO_HAVE_PRIOBOOST
   /* Restore the low priority worker thread default priority */
 
   lpwork_restorepriority(prio);
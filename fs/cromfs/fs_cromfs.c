@@ -53,6 +53,7 @@
 #include <debug.h>
 
 #include <nuttx/kmalloc.h>
+#include <nuttx/semaphore.h>
 #include <nuttx/fs/fs.h>
 #include <nuttx/fs/dirent.h>
 #include <nuttx/fs/ioctl.h>
@@ -61,6 +62,22 @@
 
 #if !defined(CONFIG_DISABLE_MOUNTPOINT) && defined(CONFIG_FS_CROMFS)
 
+/****************************************************************************
+ * Pre-processor Definitions
+ ****************************************************************************/
+
+#ifndef CONFIG_FS_CROMFS_CACHE_NBLOCKS
+#  define CONFIG_FS_CROMFS_CACHE_NBLOCKS 0
+#endif
+
+/* If there is a shared cache of decompressed blocks, then the open file
+ * does not need its own decompression buffer.
+ */
+
+#if CONFIG_FS_CROMFS_CACHE_NBLOCKS > 0
+#  define CROMFS_SHARED_CACHE 1
+#endif
+
 /****************************************************************************
  * Private Types
  ****************************************************************************/
@@ -70,11 +87,32 @@
 struct cromfs_file_s
 {
   FAR const struct cromfs_node_s *ff_node;  /* The open file node */
+  FAR const struct lzf_header_s *ff_curhdr; /* Header of the last block found */
+  uint32_t ff_curoffs;                      /* File offset of that block */
+#ifdef CONFIG_FS_CROMFS_INDEX
+  FAR uint32_t *ff_index;                   /* Volume offset of each block
+                                             * header (NULL if none) */
+#endif
+#ifndef CROMFS_SHARED_CACHE
   uint32_t ff_offset;                       /* Cached block offset (zero means none) */
   uint16_t ff_ulen;                         /* Length of decompressed data in cache */
   FAR uint8_t *ff_buffer;                   /* Cached, decompressed data */
+#endif
 };
 
+#ifdef CROMFS_SHARED_CACHE
+/* This structure describes one decompressed block in the shared cache */
+
+struct cromfs_cacheblk_s
+{
+  uint32_t cb_offset;                       /* Volume offset of compressed data
+                                             * (zero means unused) */
+  uint32_t cb_lastuse;                      /* Used to select the LRU block */
+  uint16_t cb_ulen;                         /* Length of decompressed data */
+  FAR uint8_t *cb_buffer;                   /* Decompressed data */
+};
+#endif
+
 /* This is the form of the callback from cromfs_foreach_node(): */
 
 typedef CODE int (*cromfs_foreach_t)(FAR const struct cromfs_volume_s *fs,
@@ -114,6 +152,27 @@ static int      cromfs_comparenode(FAR const struct cromfs_volume_s *fs,
 static int      cromfs_findnode(FAR const struct cromfs_volume_s *fs,
                                 FAR const struct cromfs_node_s **node,
                                 FAR const char *relpath);
+static uint32_t cromfs_blkinfo(FAR const struct lzf_header_s *hdr,
+                               FAR uint16_t *ulen, FAR uint16_t *clen);
+#ifdef CONFIG_FS_CROMFS_INDEX
+static void     cromfs_mkindex(FAR const struct cromfs_volume_s *fs,
+                               FAR struct cromfs_file_s *ff);
+#endif
+static FAR const struct lzf_header_s *
+                cromfs_findblock(FAR const struct cromfs_volume_s *fs,
+                                 FAR struct cromfs_file_s *ff, off_t fpos,
+                                 FAR uint32_t *blkoffs, FAR uint16_t *ulen,
+                                 FAR uint16_t *clen);
+static int      cromfs_decompress(FAR const struct cromfs_volume_s *fs,
+                                  FAR struct cromfs_file_s *ff,
+                                  FAR const struct lzf_header_s *hdr,
+                                  uint16_t ulen, uint16_t clen,
+                                  unsigned int copyoffs,
+                                  unsigned int copysize, FAR uint8_t *dest);
+static int      cromfs_allocfile(FAR const struct cromfs_volume_s *fs,
+                                 FAR const struct cromfs_node_s *node,
+                                 FAR struct cromfs_file_s **ffp);
+static void     cromfs_freefile(FAR struct cromfs_file_s *ff);
 
 /* Common file system methods */
 
@@ -193,6 +252,15 @@ const struct mountpt_operations cromfs_operations =
 
 extern const struct cromfs_volume_s g_cromfs_image;
 
+#ifdef CROMFS_SHARED_CACHE
+/* Cache of recently decompressed blocks, shared by all open files */
+
+static struct cromfs_cacheblk_s
+  g_cromfs_cache[CONFIG_FS_CROMFS_CACHE_NBLOCKS];
+static sem_t g_cromfs_cachesem = SEM_INITIALIZER(1);
+static uint32_t g_cromfs_cacheclock;
+#endif
+
 /****************************************************************************
  * Private Functions
  ****************************************************************************/
@@ -477,6 +545,381 @@ static int cromfs_findnode(FAR const struct cromfs_volume_s *fs,
     }
 }
 
+/****************************************************************************
+ * Name: cromfs_blkinfo
+ *
+ * Description:
+ *   Get the uncompressed and compressed lengths of a data block.  Returns
+ *   the size of the block in the image, including its header.
+ *
+ ****************************************************************************/
+
+static uint32_t cromfs_blkinfo(FAR const struct lzf_header_s *hdr,
+                               FAR uint16_t *ulen, FAR uint16_t *clen)
+{
+  if (hdr->lzf_type == LZF_TYPE0_HDR)
+    {
+      FAR const struct lzf_type0_header_s *hdr0 =
+        (FAR const struct lzf_type0_header_s *)hdr;
+
+      *ulen = (uint16_t)hdr0->lzf_len[0] << 8 |
+              (uint16_t)hdr0->lzf_len[1];
+      *clen = *ulen;
+      return (uint32_t)*ulen + LZF_TYPE0_HDR_SIZE;
+    }
+  else
+    {
+      FAR const struct lzf_type1_header_s *hdr1 =
+        (FAR const struct lzf_type1_header_s *)hdr;
+
+      *ulen = (uint16_t)hdr1->lzf_ulen[0] << 8 |
+              (uint16_t)hdr1->lzf_ulen[1];
+      *clen = (uint16_t)hdr1->lzf_clen[0] << 8 |
+              (uint16_t)hdr1->lzf_clen[1];
+      return (uint32_t)*clen + LZF_TYPE1_HDR_SIZE;
+    }
+}
+
+/****************************************************************************
+ * Name: cromfs_mkindex
+ *
+ * Description:
+ *   Build the index of block headers for an open file.  The index is only
+ *   usable if every block except the last holds cv_bsize bytes of
+ *   uncompressed data (as generated by tools/gencromfs); otherwise no
+ *   index is built and blocks are found by following the block headers.
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_FS_CROMFS_INDEX
+static void cromfs_mkindex(FAR const struct cromfs_volume_s *fs,
+                           FAR struct cromfs_file_s *ff)
+{
+  FAR const struct lzf_header_s *hdr;
+  FAR uint32_t *index;
+  uint32_t nblocks;
+  uint32_t fpos;
+  uint32_t i;
+  uint16_t ulen;
+  uint16_t clen;
+
+  nblocks = (ff->ff_node->cn_size + fs->cv_bsize - 1) / fs->cv_bsize;
+  if (nblocks < 2)
+    {
+      /* Nothing to be gained */
+
+      return;
+    }
+
+  index = (FAR uint32_t *)kmm_malloc(nblocks * sizeof(uint32_t));
+  if (index == NULL)
+    {
+      return;
+    }
+
+  hdr  = (FAR const struct lzf_header_s *)
+         cromfs_offset2addr(fs, ff->ff_node->u.cn_blocks);
+  fpos = 0;
+
+  for (i = 0; i < nblocks; i++)
+    {
+      uint32_t blksize;
+
+      index[i] = cromfs_addr2offset(fs, hdr);
+      blksize  = cromfs_blkinfo(hdr, &ulen, &clen);
+      fpos    += ulen;
+
+      if (i < nblocks - 1 && ulen != fs->cv_bsize)
+        {
+          fwarn("WARNING: Irregular block size %u, no index\n", ulen);
+          kmm_free(index);
+          return;
+        }
+
+      hdr = (FAR const struct lzf_header_s *)
+            ((FAR const uint8_t *)hdr + blksize);
+    }
+
+  DEBUGASSERT(fpos == ff->ff_node->cn_size);
+  ff->ff_index = index;
+}
+#endif
+
+/****************************************************************************
+ * Name: cromfs_findblock
+ *
+ * Description:
+ *   Find the data block containing the file offset 'fpos' which must lie
+ *   within the file.  Returns the block header and the file offset of the
+ *   start of the block.
+ *
+ ****************************************************************************/
+
+static FAR const struct lzf_header_s *
+cromfs_findblock(FAR const struct cromfs_volume_s *fs,
+                 FAR struct cromfs_file_s *ff, off_t fpos,
+                 FAR uint32_t *blkoffs, FAR uint16_t *ulen,
+                 FAR uint16_t *clen)
+{
+  FAR const struct lzf_header_s *hdr;
+  uint32_t offset;
+  uint32_t blksize;
+
+  DEBUGASSERT(fpos < ff->ff_node->cn_size);
+
+#ifdef CONFIG_FS_CROMFS_INDEX
+  /* With an index, the block can be found directly */
+
+  if (ff->ff_index != NULL)
+    {
+      uint32_t blkno = fpos / fs->cv_bsize;
+
+      hdr      = (FAR const struct lzf_header_s *)
+                 cromfs_offset2addr(fs, ff->ff_index[blkno]);
+      *blkoffs = blkno * fs->cv_bsize;
+      cromfs_blkinfo(hdr, ulen, clen);
+      return hdr;
+    }
+#endif
+
+  /* Otherwise, follow the block headers.  Start with the block found last
+   * time unless the offset lies before it.  Sequential reads then do not
+   * need to search at all.
+   */
+
+  if (ff->ff_curhdr != NULL && fpos >= ff->ff_curoffs)
+    {
+      hdr    = ff->ff_curhdr;
+      offset = ff->ff_curoffs;
+    }
+  else
+    {
+      hdr    = (FAR const struct lzf_header_s *)
+               cromfs_offset2addr(fs, ff->ff_node->u.cn_blocks);
+      offset = 0;
+    }
+
+  for (; ; )
+    {
+      blksize = cromfs_blkinfo(hdr, ulen, clen);
+      if (fpos < offset + *ulen)
+        {
+          break;
+        }
+
+      offset += *ulen;
+      hdr     = (FAR const struct lzf_header_s *)
+                ((FAR const uint8_t *)hdr + blksize);
+    }
+
+  ff->ff_curhdr  = hdr;
+  ff->ff_curoffs = offset;
+  *blkoffs       = offset;
+  return hdr;
+}
+
+/****************************************************************************
+ * Name: cromfs_decompress
+ *
+ * Description:
+ *   Copy 'copysize' bytes of the decompressed data of a compressed block,
+ *   starting at 'copyoffs', into 'dest'.  A whole block is decompressed
+ *   directly into 'dest' unless it is already cached.  Otherwise the block
+ *   is decompressed into the cache first.
+ *
+ * Returned Value:
+ *   Zero (OK) on success; -ENOMEM if a cache buffer could not be allocated.
+ *
+ ****************************************************************************/
+
+static int cromfs_decompress(FAR const struct cromfs_volume_s *fs,
+                             FAR struct cromfs_file_s *ff,
+                             FAR const struct lzf_header_s *hdr,
+                             uint16_t ulen, uint16_t clen,
+                             unsigned int copyoffs, unsigned int copysize,
+                             FAR uint8_t *dest)
+{
+  FAR const uint8_t *src;
+  uint32_t voloffs;
+  bool whole;
+#ifdef CROMFS_SHARED_CACHE
+  FAR struct cromfs_cacheblk_s *cb;
+  FAR struct cromfs_cacheblk_s *victim;
+  int i;
+#endif
+
+  DEBUGASSERT((copyoffs + copysize) <= fs->cv_bsize);
+
+  src     = (FAR const uint8_t *)hdr + LZF_TYPE1_HDR_SIZE;
+  voloffs = cromfs_addr2offset(fs, src);
+  whole   = (copyoffs == 0 && copysize == ulen);
+
+#ifdef CROMFS_SHARED_CACHE
+  nxsem_wait_uninterruptible(&g_cromfs_cachesem);
+
+  /* Look for the block in the cache, remembering the least recently used
+   * block in case it is not there.
+   */
+
+  victim = &g_cromfs_cache[0];
+  for (i = 0; i < CONFIG_FS_CROMFS_CACHE_NBLOCKS; i++)
+    {
+      cb = &g_cromfs_cache[i];
+      if (cb->cb_offset == voloffs)
+        {
+          DEBUGASSERT(cb->cb_ulen >= (copyoffs + copysize));
+          memcpy(dest, &cb->cb_buffer[copyoffs], copysize);
+          cb->cb_lastuse = ++g_cromfs_cacheclock;
+          nxsem_post(&g_cromfs_cachesem);
+          return OK;
+        }
+
+      if (cb->cb_offset == 0 ||
+          (victim->cb_offset != 0 && cb->cb_lastuse < victim->cb_lastuse))
+        {
+          victim = cb;
+        }
+    }
+
+  /* Not cached.  A whole block is decompressed straight into the user
+   * buffer:  A reader asking for whole blocks is most likely streaming and
+   * will not return to this one.
+   */
+
+  if (whole)
+    {
+      nxsem_post(&g_cromfs_cachesem);
+      lzf_decompress(src, clen, dest, fs->cv_bsize);
+      return OK;
+    }
+
+  /* Otherwise, replace the least recently used block */
+
+  if (victim->cb_buffer == NULL)
+    {
+      victim->cb_buffer = (FAR uint8_t *)kmm_malloc(fs->cv_bsize);
+    }
+
+  if (victim->cb_buffer == NULL)
+    {
+      nxsem_post(&g_cromfs_cachesem);
+      ferr("ERROR: Failed to allocate cache buffer\n");
+      return -ENOMEM;
+    }
+
+  victim->cb_ulen    = lzf_decompress(src, clen, victim->cb_buffer,
+                                      fs->cv_bsize);
+  victim->cb_offset  = voloffs;
+  victim->cb_lastuse = ++g_cromfs_cacheclock;
+
+  finfo("voloffs=%lu ulen=%u clen=%u copyoffs=%u copysize=%u\n",
+        (unsigned long)voloffs, ulen, clen, copyoffs, copysize);
+  DEBUGASSERT(victim->cb_ulen >= (copyoffs + copysize));
+
+  memcpy(dest, &victim->cb_buffer[copyoffs], copysize);
+  nxsem_post(&g_cromfs_cachesem);
+  return OK;
+#else
+  if (voloffs == ff->ff_offset)
+    {
+      /* The block is already in our intermediate decompression buffer */
+
+      DEBUGASSERT(ff->ff_ulen >= (copyoffs + copysize));
+      memcpy(dest, &ff->ff_buffer[copyoffs], copysize);
+    }
+  else if (whole)
+    {
+      /* Decompress directly into the user buffer */
+
+      lzf_decompress(src, clen, dest, fs->cv_bsize);
+    }
+  else
+    {
+      /* Decompress into our intermediate decompression buffer, then copy
+       * to the user buffer.
+       */
+
+      ff->ff_ulen   = lzf_decompress(src, clen, ff->ff_buffer,
+                                     fs->cv_bsize);
+      ff->ff_offset = voloffs;
+
+      finfo("voloffs=%lu ulen=%u clen=%u copyoffs=%u copysize=%u\n",
+            (unsigned long)voloffs, ulen, clen, copyoffs, copysize);
+      DEBUGASSERT(ff->ff_ulen >= (copyoffs + copysize));
+
+      memcpy(dest, &ff->ff_buffer[copyoffs], copysize);
+    }
+
+  return OK;
+#endif
+}
+
+/****************************************************************************
+ * Name: cromfs_allocfile
+ *
+ * Description:
+ *   Allocate and initialize the open file state for a regular file.
+ *
+ ****************************************************************************/
+
+static int cromfs_allocfile(FAR const struct cromfs_volume_s *fs,
+                            FAR const struct cromfs_node_s *node,
+                            FAR struct cromfs_file_s **ffp)
+{
+  FAR struct cromfs_file_s *ff;
+
+  ff = (FAR struct cromfs_file_s *)kmm_zalloc(sizeof(struct cromfs_file_s));
+  if (ff == NULL)
+    {
+      return -ENOMEM;
+    }
+
+#ifndef CROMFS_SHARED_CACHE
+  /* Create a file buffer to support partial sector accesses */
+
+  ff->ff_buffer = (FAR uint8_t *)kmm_malloc(fs->cv_bsize);
+  if (ff->ff_buffer == NULL)
+    {
+      kmm_free(ff);
+      return -ENOMEM;
+    }
+#endif
+
+  /* Save the node in the open file instance */
+
+  ff->ff_node = node;
+
+#ifdef CONFIG_FS_CROMFS_INDEX
+  /* Index the file's data blocks.  The file can still be read without the
+   * index, so failures are not reported.
+   */
+
+  cromfs_mkindex(fs, ff);
+#endif
+
+  *ffp = ff;
+  return OK;
+}
+
+/****************************************************************************
+ * Name: cromfs_freefile
+ ****************************************************************************/
+
+static void cromfs_freefile(FAR struct cromfs_file_s *ff)
+{
+#ifdef CONFIG_FS_CROMFS_INDEX
+  if (ff->ff_index != NULL)
+    {
+      kmm_free(ff->ff_index);
+    }
+#endif
+
+#ifndef CROMFS_SHARED_CACHE
+  kmm_free(ff->ff_buffer);
+#endif
+  kmm_free(ff);
+}
+
 /****************************************************************************
  * Name: cromfs_open
  ****************************************************************************/
@@ -539,25 +982,12 @@ static int cromfs_open(FAR struct file *filep, FAR const char *relpath,
    * file.
    */
 
-  ff = (FAR struct cromfs_file_s *)kmm_zalloc(sizeof(struct cromfs_file_s));
-  if (ff == NULL)
-    {
-      return -ENOMEM;
-    }
-
-  /* Create a file buffer to support partial sector accesses */
-
-  ff->ff_buffer = (FAR uint8_t *)kmm_malloc(fs->cv_bsize);
-  if (!ff->ff_buffer)
+  ret = cromfs_allocfile(fs, node, &ff);
+  if (ret < 0)
     {
-      kmm_free(ff);
-      return -ENOMEM;
+      return ret;
     }
 
-  /* Save the node in the open file instance */
-
-  ff->ff_node = node;
-
   /* Save the index as the open-specific state in filep->f_priv */
 
   filep->f_priv = (FAR void *)ff;
@@ -578,12 +1008,11 @@ static int cromfs_close(FAR struct file *filep)
   /* Get the open file instance from the file structure */
 
   ff = filep->f_priv;
-  DEBUGASSERT(ff->ff_node != NULL && ff->ff_buffer != NULL);
+  DEBUGASSERT(ff->ff_node != NULL);
 
   /* Free all resources consumed by the opened file */
 
-  kmm_free(ff->ff_buffer);
-  kmm_free(ff);
+  cromfs_freefile(ff);
 
   return OK;
 }
@@ -598,8 +1027,7 @@ static ssize_t cromfs_read(FAR struct file *filep, FAR char *buffer,
   FAR struct inode *inode;
   FAR const struct cromfs_volume_s *fs;
   FAR struct cromfs_file_s *ff;
-  FAR struct lzf_header_s *currhdr;
-  FAR struct lzf_header_s *nexthdr;
+  FAR const struct lzf_header_s *currhdr;
   FAR uint8_t *dest;
   FAR const uint8_t *src;
   off_t fpos;
@@ -609,6 +1037,7 @@ static ssize_t cromfs_read(FAR struct file *filep, FAR char *buffer,
   uint16_t clen;
   unsigned int copysize;
   unsigned int copyoffs;
+  int ret;
 
   finfo("Read %d bytes from offset %d\n", buflen, filep->f_pos);
   DEBUGASSERT(filep->f_priv != NULL && filep->f_inode != NULL);
@@ -624,11 +1053,11 @@ static ssize_t cromfs_read(FAR struct file *filep, FAR char *buffer,
   /* Get the open file instance from the file structure */
 
   ff = (FAR struct cromfs_file_s *)filep->f_priv;
-  DEBUGASSERT(ff->ff_node != NULL && ff->ff_buffer != NULL);
+  DEBUGASSERT(ff->ff_node != NULL);
 
   /* Check for a read past the end of the file */
 
-  if (filep->f_pos > ff->ff_node->cn_size)
+  if (filep->f_pos >= ff->ff_node->cn_size)
     {
       /* Start read position is past the end of file.  Return the end-of-
        * file indication.
@@ -645,64 +1074,25 @@ static ssize_t cromfs_read(FAR struct file *filep, FAR char *buffer,
       buflen = ff->ff_node->cn_size - filep->f_pos;
     }
 
-  /* Find the compressed block containing the current offset, f_pos */
+  /* Copy the data one block at a time */
 
   dest      = (FAR uint8_t *)buffer;
   remaining = buflen;
   fpos      = filep->f_pos;
-  blkoffs   = 0;
-  ulen      = 0;
-  nexthdr   = (FAR struct lzf_header_s *)
-               cromfs_offset2addr(fs, ff->ff_node->u.cn_blocks);
-
-  /* Look until we find the compressed block containing the start of the
-   * requested data.
-   */
 
   while (remaining > 0)
     {
-      /* Search for the next block containing the fpos file offset.  This is
-       * real search on the first time through but the remaining blocks should
-       * be contiguous so that the logic should not loop.
-       *
-       */
-
-      do
-        {
-          uint32_t blksize;
-
-          /* Go to the next block */
+      /* Find the block containing the fpos file offset */
 
-          currhdr  = nexthdr;
-          blkoffs += ulen;
+      currhdr  = cromfs_findblock(fs, ff, fpos, &blkoffs, &ulen, &clen);
+      copyoffs = fpos - blkoffs;
+      DEBUGASSERT(ulen > copyoffs);
+      copysize = ulen - copyoffs;
 
-          if (currhdr->lzf_type == LZF_TYPE0_HDR)
-            {
-              FAR struct lzf_type0_header_s *hdr0 =
-                (FAR struct lzf_type0_header_s *)currhdr;
-
-              ulen    = (uint16_t)hdr0->lzf_len[0] << 8 |
-                        (uint16_t)hdr0->lzf_len[1];
-              blksize = (uint32_t)ulen + LZF_TYPE0_HDR_SIZE;
-            }
-          else
-            {
-              FAR struct lzf_type1_header_s * hdr1 =
-                (FAR struct lzf_type1_header_s *)currhdr;
-
-              ulen    = (uint16_t)hdr1->lzf_ulen[0] << 8 |
-                        (uint16_t)hdr1->lzf_ulen[1];
-              clen    = (uint16_t)hdr1->lzf_clen[0] << 8 |
-                        (uint16_t)hdr1->lzf_clen[1];
-              blksize = (uint32_t)clen + LZF_TYPE1_HDR_SIZE;
-            }
-
-          nexthdr  = (FAR struct lzf_header_s *)
-                     ((FAR uint8_t *)currhdr + blksize);
+      if (copysize > remaining)  /* Clip to the size really needed */
+        {
+          copysize = remaining;
         }
-      while (fpos >= (blkoffs + ulen));
-
-      /* Check if we need to decompress the next block into the user buffer. */
 
       if (currhdr->lzf_type == LZF_TYPE0_HDR)
         {
@@ -710,15 +1100,6 @@ static ssize_t cromfs_read(FAR struct file *filep, FAR char *buffer,
            * user buffer.
            */
 
-          copyoffs = (blkoffs >= filep->f_pos) ? 0 : filep->f_pos - blkoffs;
-          DEBUGASSERT(ulen > copyoffs);
-          copysize = ulen - copyoffs;
-
-          if (copysize > remaining)  /* Clip to the size really needed */
-            {
-              copysize = remaining;
-            }
-
           src = (FAR const uint8_t *)currhdr + LZF_TYPE0_HDR_SIZE;
           memcpy(dest, &src[copyoffs], copysize);
 
@@ -727,81 +1108,20 @@ static ssize_t cromfs_read(FAR struct file *filep, FAR char *buffer,
         }
       else
         {
-          /* If the source of the data is at the beginning of the compressed
-           * data buffer and if the uncompressed data would not overrun the
-           * buffer, then we can decompress directly into the user buffer.
-           */
+          /* Decompress the block, or get it from the cache */
 
-          if (filep->f_pos <= blkoffs && ulen <= remaining)
+          ret = cromfs_decompress(fs, ff, currhdr, ulen, clen, copyoffs,
+                                  copysize, dest);
+          if (ret < 0)
             {
-              uint32_t voloffs;
+              /* Return what was read so far, if anything */
 
-              copyoffs = 0;
-              copysize = ulen;
-
-              /* Get the address and offset in the CROMFS image to obtain
-               * the data.  Check if we already have this offset in the
-               * cache.
-               */
-
-              src     = (FAR const uint8_t *)currhdr + LZF_TYPE1_HDR_SIZE;
-              voloffs = cromfs_addr2offset(fs, src);
-              if (voloffs != ff->ff_offset)
+              if (remaining < buflen)
                 {
-                  unsigned int decomplen;
-
-                  decomplen = lzf_decompress(src, clen, dest, fs->cv_bsize);
-
-                  ff->ff_offset = voloffs;
-                  ff->ff_ulen   = decomplen;
+                  break;
                 }
 
-              finfo("voloffs=%lu blkoffs=%lu ulen=%u ff_offset=%u copysize=%u\n",
-                    (unsigned long)voloffs, (unsigned long)blkoffs, ulen,
-                    ff->ff_offset, copysize);
-              DEBUGASSERT(ff->ff_ulen >= copysize);
-            }
-          else
-            {
-              uint32_t voloffs;
-
-              /* No, we will need to decompress into the our intermediate
-               * decompression buffer.
-               */
-
-              copyoffs = (blkoffs >= filep->f_pos) ? 0 : filep->f_pos - blkoffs;
-              DEBUGASSERT(ulen > copyoffs);
-              copysize = ulen - copyoffs;
-
-              if (copysize > remaining)  /* Clip to the size really needed */
-                {
-                  copysize = remaining;
-                }
-
-              DEBUGASSERT((copyoffs + copysize) <=  fs->cv_bsize);
-
-              src = (FAR const uint8_t *)currhdr + LZF_TYPE1_HDR_SIZE;
-              voloffs = cromfs_addr2offset(fs, src);
-              if (voloffs != ff->ff_offset)
-                {
-                  unsigned int decomplen;
-
-                  decomplen = lzf_decompress(src, clen, ff->ff_buffer,
-                                             fs->cv_bsize);
-
-                  ff->ff_offset = voloffs;
-                  ff->ff_ulen   = decomplen;
-                }
-
-              finfo("voloffs=%lu blkoffs=%lu ulen=%u clen=%u ff_offset=%u "
-                    "copyoffs=%u copysize=%u\n",
-                    (unsigned long)voloffs, (unsigned long)blkoffs, ulen,
-                    clen, ff->ff_offset, copyoffs, copysize);
-              DEBUGASSERT(ff->ff_ulen >= (copyoffs + copysize));
-
-              /* Then copy to user buffer */
-
-              memcpy(dest, &ff->ff_buffer[copyoffs], copysize);
+              return ret;
             }
         }
 
@@ -815,7 +1135,7 @@ static ssize_t cromfs_read(FAR struct file *filep, FAR char *buffer,
   /* Update the file pointer */
 
   filep->f_pos = fpos;
-  return buflen;
+  return buflen - remaining;
 }
 
 /****************************************************************************
@@ -824,9 +1144,36 @@ static ssize_t cromfs_read(FAR struct file *filep, FAR char *buffer,
 
 static int cromfs_ioctl(FAR struct file *filep, int cmd, unsigned long arg)
 {
+  FAR const struct cromfs_volume_s *fs;
+  FAR const struct lzf_header_s *hdr;
+  FAR struct cromfs_file_s *ff;
+  FAR void **ppv = (FAR void**)arg;
+  uint16_t ulen;
+  uint16_t clen;
+
   finfo("cmd: %d arg: %08lx\n", cmd, arg);
+  DEBUGASSERT(filep->f_priv != NULL && filep->f_inode != NULL);
+
+  fs = filep->f_inode->i_private;
+  ff = (FAR struct cromfs_file_s *)filep->f_priv;
+  DEBUGASSERT(fs != NULL && ff->ff_node != NULL);
+
+  /* A file held in a single, uncompressed block can be accessed in place
+   * in the image, just like a ROMFS file.
+   */
 
-  /* No IOCTL commands yet supported */
+  if (cmd == FIOC_MMAP && ppv != NULL && ff->ff_node->cn_size > 0)
+    {
+      hdr = (FAR const struct lzf_header_s *)
+            cromfs_offset2addr(fs, ff->ff_node->u.cn_blocks);
+      cromfs_blkinfo(hdr, &ulen, &clen);
+
+      if (hdr->lzf_type == LZF_TYPE0_HDR && ulen == ff->ff_node->cn_size)
+        {
+          *ppv = (FAR void *)((FAR const uint8_t *)hdr + LZF_TYPE0_HDR_SIZE);
+          return OK;
+        }
+    }
 
   return -ENOTTY;
 }
@@ -844,6 +1191,7 @@ static int cromfs_dup(FAR const struct file *oldp, FAR struct file *newp)
   FAR struct cromfs_volume_s *fs;
   FAR struct cromfs_file_s *oldff;
   FAR struct cromfs_file_s *newff;
+  int ret;
 
   finfo("Dup %p->%p\n", oldp, newp);
   DEBUGASSERT(oldp->f_priv != NULL && oldp->f_inode != NULL &&
@@ -857,31 +1205,18 @@ static int cromfs_dup(FAR const struct file *oldp, FAR struct file *newp)
   /* Get the open file instance from the file structure */
 
   oldff = oldp->f_priv;
-  DEBUGASSERT(oldff->ff_node != NULL && oldff->ff_buffer != NULL);
+  DEBUGASSERT(oldff->ff_node != NULL);
 
   /* Allocate and initialize an new open file instance referring to the
    * same node.
    */
 
-  newff = (FAR struct cromfs_file_s *)kmm_zalloc(sizeof(struct cromfs_file_s));
-  if (newff == NULL)
-    {
-      return -ENOMEM;
-    }
-
-  /* Create a file buffer to support partial sector accesses */
-
-  newff->ff_buffer = (FAR uint8_t *)kmm_malloc(fs->cv_bsize);
-  if (newff->ff_buffer == NULL)
+  ret = cromfs_allocfile(fs, oldff->ff_node, &newff);
+  if (ret < 0)
     {
-      kmm_free(newff);
-      return -ENOMEM;
+      return ret;
     }
 
-  /* Save the node in the open file instance */
-
-  newff->ff_node = oldff->ff_node;
-
   /* Copy the index from the old to the new file structure */
 
   newp->f_priv = newff;
@@ -914,7 +1249,7 @@ static int cromfs_fstat(FAR const struct file *filep, FAR struct stat *buf)
    */
 
   ff              = filep->f_priv;
-  DEBUGASSERT(ff->ff_node != NULL && ff->ff_buffer != NULL);
+  DEBUGASSERT(ff->ff_node != NULL);
 
   inode           = filep->f_inode;
   fs              = inode->i_private;
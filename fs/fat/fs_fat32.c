@@ -63,6 +63,7 @@
 #include <nuttx/fs/fs.h>
 #include <nuttx/fs/fat.h>
 #include <nuttx/fs/dirent.h>
+#include <nuttx/fs/ioctl.h>
 
 #include "inode/inode.h"
 #include "fs_fat32.h"
@@ -81,6 +82,9 @@ static ssize_t fat_write(FAR struct file *filep, FAR const char *buffer,
 static off_t   fat_seek(FAR struct file *filep, off_t offset, int whence);
 static int     fat_ioctl(FAR struct file *filep, int cmd,
                  unsigned long arg);
+static int     fat_extent(FAR struct fat_mountpt_s *fs,
+                 FAR struct fat_file_s *ff,
+                 FAR struct file_extent_s *extent);
 
 static int     fat_sync(FAR struct file *filep);
 static int     fat_dup(FAR const struct file *oldp, FAR struct file *newp);
@@ -377,6 +381,9 @@ static int fat_open(FAR struct file *filep, FAR const char *relpath,
       off_t offset = fat_seek(filep, ff->ff_size, SEEK_SET);
       if (offset < 0)
         {
+#ifdef CONFIG_FAT_EXTENTCACHE
+          fat_extentfree(ff);
+#endif
           kmm_free(ff);
           return (int)offset;
         }
@@ -465,6 +472,12 @@ static int fat_close(FAR struct file *filep)
       fat_io_free(ff->ff_buffer, fs->fs_hwsectorsize);
     }
 
+#ifdef CONFIG_FAT_EXTENTCACHE
+  /* Free the map of the cluster chain */
+
+  fat_extentfree(ff);
+#endif
+
   /* Then free the file structure itself. */
 
   kmm_free(ff);
@@ -493,6 +506,9 @@ static ssize_t fat_read(FAR struct file *filep, FAR char *buffer,
 #ifndef CONFIG_FAT_FORCE_INDIRECT
   unsigned int nsectors;
   bool force_indirect = false;
+#ifdef CONFIG_FAT_EXTENTCACHE
+  unsigned int nclusters;
+#endif
 #endif
 
   /* Sanity checks */
@@ -612,12 +628,17 @@ fat_read_restart:
            *
            * Limit the number of sectors that we read on this time
            * through the loop to the remaining contiguous sectors
-           * in this cluster
+           * in this cluster (or, with the extent map, in the following
+           * clusters that are contiguous on the media).
            */
 
           if (nsectors > ff->ff_sectorsincluster)
             {
+#ifdef CONFIG_FAT_EXTENTCACHE
+              nsectors = fat_extentcontig(fs, ff, filep->f_pos, nsectors);
+#else
               nsectors = ff->ff_sectorsincluster;
+#endif
             }
 
           /* We are not sure of the state of the file buffer so
@@ -651,7 +672,27 @@ fat_read_restart:
               goto errout_with_semaphore;
             }
 
-          ff->ff_sectorsincluster -= nsectors;
+#ifdef CONFIG_FAT_EXTENTCACHE
+          if (nsectors > ff->ff_sectorsincluster)
+            {
+              /* The transfer continued into the following clusters.  The
+               * last of them is now the current cluster.
+               */
+
+              nclusters = (nsectors - ff->ff_sectorsincluster +
+                           fs->fs_fatsecperclus - 1) / fs->fs_fatsecperclus;
+
+              ff->ff_currentcluster   += nclusters;
+              ff->ff_sectorsincluster  = ff->ff_sectorsincluster +
+                                          nclusters * fs->fs_fatsecperclus -
+                                          nsectors;
+            }
+          else
+#endif
+            {
+              ff->ff_sectorsincluster -= nsectors;
+            }
+
           ff->ff_currentsector    += nsectors;
           bytesread                = nsectors * fs->fs_hwsectorsize;
         }
@@ -1026,6 +1067,9 @@ static off_t fat_seek(FAR struct file *filep, off_t offset, int whence)
   int32_t cluster;
   off_t position;
   unsigned int clustersize;
+#ifdef CONFIG_FAT_EXTENTCACHE
+  uint32_t clusterndx;
+#endif
   int ret;
 
   /* Sanity checks */
@@ -1151,6 +1195,25 @@ static off_t fat_seek(FAR struct file *filep, off_t offset, int whence)
        */
 
       clustersize = fs->fs_fatsecperclus * fs->fs_hwsectorsize;
+
+#ifdef CONFIG_FAT_EXTENTCACHE
+      /* Use the extent map to skip directly to the cluster containing the
+       * requested position or, if the chain is shorter, to the last
+       * cluster of the chain.
+       */
+
+      cluster = fat_extentseek(fs, ff, position / clustersize, &clusterndx,
+                               NULL);
+      if (cluster < 0)
+        {
+          ret = cluster;
+          goto errout_with_semaphore;
+        }
+
+      filep->f_pos += (off_t)clusterndx * clustersize;
+      position     -= (off_t)clusterndx * clustersize;
+#endif
+
       for (; ; )
         {
           /* Skip over clusters prior to the one containing
@@ -1265,6 +1328,81 @@ errout_with_semaphore:
   return ret;
 }
 
+/****************************************************************************
+ * Name: fat_extent
+ *
+ * Description:
+ *   Find the run of adjacent clusters that holds the file data at
+ *   extent->fe_offset.  The offset must be sector aligned.  Called with
+ *   the file system semaphore held.
+ *
+ ****************************************************************************/
+
+static int fat_extent(FAR struct fat_mountpt_s *fs,
+                      FAR struct fat_file_s *ff,
+                      FAR struct file_extent_s *extent)
+{
+  off_t clustersize = fs->fs_fatsecperclus * fs->fs_hwsectorsize;
+  off_t offset      = extent->fe_offset;
+  off_t maxlength;
+  off_t length;
+  off_t cluster;
+  off_t next;
+  off_t skip;
+
+  if (offset < 0 || offset >= ff->ff_size)
+    {
+      return -ENXIO;
+    }
+
+  if ((offset & SEC_NDXMASK(fs)) != 0)
+    {
+      return -EINVAL;
+    }
+
+  /* Follow the cluster chain to the cluster that holds the offset */
+
+  cluster = ff->ff_startcluster;
+  for (skip = offset / clustersize; skip > 0; skip--)
+    {
+      cluster = fat_getcluster(fs, cluster);
+      if (cluster < 2 || cluster >= fs->fs_nclusters)
+        {
+          return -EINVAL;
+        }
+    }
+
+  /* Then extend the run for as long as the next cluster is adjacent */
+
+  maxlength = ff->ff_size - offset;
+  if (extent->fe_length > 0 && extent->fe_length < maxlength)
+    {
+      maxlength = extent->fe_length;
+    }
+
+  extent->fe_blkdrv   = fs->fs_blkdriver;
+  extent->fe_sectsize = fs->fs_hwsectorsize;
+  extent->fe_sector   = fat_cluster2sector(fs, cluster) +
+                        SEC_NSECTORS(fs, offset % clustersize);
+  extent->fe_mem      = NULL;
+
+  length = clustersize - offset % clustersize;
+  while (length < maxlength)
+    {
+      next = fat_getcluster(fs, cluster);
+      if (next != cluster + 1)
+        {
+          break;
+        }
+
+      cluster = next;
+      length += clustersize;
+    }
+
+  extent->fe_length = length < maxlength ? length : maxlength;
+  return OK;
+}
+
 /****************************************************************************
  * Name: fat_ioctl
  ****************************************************************************/
@@ -1305,6 +1443,13 @@ static int fat_ioctl(FAR struct file *filep, int cmd, unsigned long arg)
       return ret;
     }
 
+  if (cmd == FIOC_EXTENT && arg != 0)
+    {
+      ret = fat_extent(fs, ff, (FAR struct file_extent_s *)arg);
+      fat_semgive(fs);
+      return ret;
+    }
+
   /* ioctl calls are just passed through to the contained block driver */
 
   fat_semgive(fs);
@@ -1409,8 +1554,18 @@ static int fat_sync(FAR struct file *filep)
 
       fs->fs_dirty = true;
       ret          = fat_updatefsinfo(fs);
+      if (ret < 0)
+        {
+          goto errout_with_semaphore;
+        }
     }
 
+#ifdef CONFIG_FAT_SECTORCACHE
+  /* Write back everything that is held in the sector cache */
+
+  ret = fat_cacheflush(fs);
+#endif
+
 errout_with_semaphore:
   fat_semgive(fs);
   return ret;
@@ -1513,6 +1668,10 @@ static int fat_dup(FAR const struct file *oldp, FAR struct file *newp)
   newff->ff_startcluster     = oldff->ff_startcluster;     /* Start cluster of file on media */
   newff->ff_currentsector    = oldff->ff_currentsector;    /* Current sector */
   newff->ff_cachesector      = 0;                          /* Sector in file buffer */
+#ifdef CONFIG_FAT_EXTENTCACHE
+  newff->ff_nextents         = 0;                          /* Cluster chain map */
+  newff->ff_extents          = NULL;
+#endif
 
   /* Attach the private date to the struct file instance */
 
@@ -1808,6 +1967,12 @@ static int fat_truncate(FAR struct file *filep, off_t length)
           ff->ff_size = length;
           ret = OK;
         }
+
+#ifdef CONFIG_FAT_EXTENTCACHE
+      /* Clusters were removed from the chain */
+
+      fat_extentinvalidate(ff);
+#endif
     }
   else
     {
@@ -2171,6 +2336,13 @@ static int fat_unbind(FAR void *handle, FAR struct inode **blkdriver,
         }
     }
 
+#ifdef CONFIG_FAT_SECTORCACHE
+  /* Write back and release the sector cache */
+
+  fat_cacheflush(fs);
+  fat_cacheuninitialize(fs);
+#endif
+
   /* Unmount ... close the block driver */
 
   if (fs->fs_blkdriver)
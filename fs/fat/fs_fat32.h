@@ -52,6 +52,10 @@
 #include <nuttx/fs/dirent.h>
 #include <nuttx/semaphore.h>
 
+#ifdef CONFIG_FAT_SECTORCACHE
+#  include <nuttx/wqueue.h>
+#endif
+
 /****************************************************************************
  * Pre-processor Definitions
  ****************************************************************************/
@@ -863,6 +867,19 @@
 #  define fat_io_free(m,s) kmm_free(m)
 #endif
 
+/****************************************************************************
+ * Sector cache definitions
+ ****************************************************************************/
+
+/* Dirty sectors in the sector cache are written back by a timer only if the
+ * low priority work queue is available.
+ */
+
+#if defined(CONFIG_FAT_SECTORCACHE) && defined(CONFIG_SCHED_LPWORK) && \
+    CONFIG_FAT_SECTORCACHE_FLUSHMS > 0
+#  define FAT_CACHE_TIMER 1
+#endif
+
 /****************************************************************************
  * Public Types
  ****************************************************************************/
@@ -873,6 +890,18 @@
  */
 
 struct fat_file_s;
+
+#ifdef CONFIG_FAT_SECTORCACHE
+/* This structure describes one sector held in the sector cache */
+
+struct fat_cachesector_s
+{
+  off_t    cs_sector;              /* The sector number or -1 if unused */
+  uint32_t cs_age;                 /* Time stamp of the last access (LRU) */
+  bool     cs_dirty;               /* true: Must be written back */
+  uint8_t *cs_buffer;              /* The sector data */
+};
+#endif
 struct fat_mountpt_s
 {
   struct inode      *fs_blkdriver; /* The block driver inode that hosts the FAT32 fs */
@@ -901,8 +930,32 @@ struct fat_mountpt_s
   uint8_t  fs_fatsecperclus;       /* MBR: Sectors per allocation unit: 2**n, n=0..7 */
   uint8_t *fs_buffer;              /* This is an allocated buffer to hold one sector
                                     * from the device */
+#ifdef CONFIG_FAT_SECTORCACHE
+  struct fat_cachesector_s *fs_cache; /* Sector cache entries */
+  uint8_t *fs_cachebuffer;         /* Sector cache data */
+  uint8_t *fs_cacheburst;          /* Multi-sector read-ahead/write-back buffer */
+  off_t    fs_cachelast;           /* Last sector read through the cache */
+  uint32_t fs_cacheclock;          /* Source of cache time stamps */
+#ifdef FAT_CACHE_TIMER
+  bool     fs_cachepending;        /* true: Write-back work is scheduled */
+  struct work_s fs_cachework;      /* Supports timed write-back */
+#endif
+#endif
 };
 
+#ifdef CONFIG_FAT_EXTENTCACHE
+/* This structure describes one run of clusters that are contiguous on the
+ * media in the cluster chain of an open file.
+ */
+
+struct fat_extent_s
+{
+  uint32_t fe_index;               /* Index of the first cluster in the file */
+  uint32_t fe_cluster;             /* Number of the first cluster */
+  uint32_t fe_nclusters;           /* Number of contiguous clusters */
+};
+#endif
+
 /* This structure represents on open file under the mountpoint.  An instance
  * of this structure is retained as struct file specific information on each
  * opened file.
@@ -922,6 +975,10 @@ struct fat_file_s
   off_t    ff_currentsector;       /* Current sector being operated on */
   off_t    ff_cachesector;         /* Current sector in the file buffer */
   uint8_t *ff_buffer;              /* File buffer (for partial sector accesses) */
+#ifdef CONFIG_FAT_EXTENTCACHE
+  uint16_t ff_nextents;            /* Number of valid entries in ff_extents */
+  struct fat_extent_s *ff_extents; /* Map of the start of the cluster chain */
+#endif
 };
 
 /* This structure holds the sequence of directory entries used by one
@@ -1044,6 +1101,23 @@ EXTERN int    fat_hwread(struct fat_mountpt_s *fs, uint8_t *buffer,
                          off_t sector, unsigned int nsectors);
 EXTERN int    fat_hwwrite(struct fat_mountpt_s *fs, uint8_t *buffer,
                           off_t sector, unsigned int nsectors);
+EXTERN int    fat_devread(struct fat_mountpt_s *fs, uint8_t *buffer,
+                          off_t sector, unsigned int nsectors);
+EXTERN int    fat_devwrite(struct fat_mountpt_s *fs, uint8_t *buffer,
+                           off_t sector, unsigned int nsectors);
+
+/* Sector cache between the FAT logic and the block driver */
+
+#ifdef CONFIG_FAT_SECTORCACHE
+EXTERN int    fat_cacheinitialize(struct fat_mountpt_s *fs);
+EXTERN void   fat_cacheuninitialize(struct fat_mountpt_s *fs);
+EXTERN int    fat_cacheread(struct fat_mountpt_s *fs, uint8_t *buffer,
+                            off_t sector, unsigned int nsectors);
+EXTERN int    fat_cachewrite(struct fat_mountpt_s *fs, uint8_t *buffer,
+                             off_t sector, unsigned int nsectors);
+EXTERN int    fat_cacheflush(struct fat_mountpt_s *fs);
+EXTERN void   fat_cacheinvalidate(struct fat_mountpt_s *fs);
+#endif
 
 /* Cluster / cluster chain access helpers */
 
@@ -1056,6 +1130,19 @@ EXTERN int32_t fat_extendchain(struct fat_mountpt_s *fs, uint32_t cluster);
 
 #define fat_createchain(fs) fat_extendchain(fs, 0)
 
+/* Per-file map of contiguous runs in the cluster chain */
+
+#ifdef CONFIG_FAT_EXTENTCACHE
+EXTERN int32_t fat_extentseek(struct fat_mountpt_s *fs,
+                              struct fat_file_s *ff, uint32_t index,
+                              uint32_t *found, uint32_t *ncontig);
+EXTERN unsigned int fat_extentcontig(struct fat_mountpt_s *fs,
+                                     struct fat_file_s *ff, off_t position,
+                                     unsigned int nsectors);
+EXTERN void   fat_extentinvalidate(struct fat_file_s *ff);
+EXTERN void   fat_extentfree(struct fat_file_s *ff);
+#endif
+
 /* Help for traversing directory trees and accessing directory entries */
 
 EXTERN int    fat_nextdirentry(struct fat_mountpt_s *fs, struct fs_fatdir_s *dir);
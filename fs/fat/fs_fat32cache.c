@@ -0,0 +1,664 @@
+/****************************************************************************
+ * fs/fat/fs_fat32cache.c
+ *
+ *   Copyright (C) 2020 Gregory Nutt. All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in
+ *    the documentation and/or other materials provided with the
+ *    distribution.
+ * 3. Neither the name NuttX nor the names of its contributors may be
+ *    used to endorse or promote products derived from this software
+ *    without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+ * FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE
+ * COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+ * INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,
+ * BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS
+ * OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED
+ * AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ * LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN
+ * ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ *
+ ****************************************************************************/
+
+/****************************************************************************
+ * Included Files
+ ****************************************************************************/
+
+#include <nuttx/config.h>
+
+#include <sys/types.h>
+#include <stdint.h>
+#include <stdbool.h>
+#include <string.h>
+#include <assert.h>
+#include <errno.h>
+#include <debug.h>
+
+#include <nuttx/kmalloc.h>
+#include <nuttx/clock.h>
+#include <nuttx/signal.h>
+#include <nuttx/wqueue.h>
+
+#include "fs_fat32.h"
+
+#ifdef CONFIG_FAT_SECTORCACHE
+
+/****************************************************************************
+ * Pre-processor Definitions
+ ****************************************************************************/
+
+#ifndef CONFIG_FAT_SECTORCACHE_READAHEAD
+#  define CONFIG_FAT_SECTORCACHE_READAHEAD 0
+#endif
+
+#define FAT_CACHE_NSECTORS CONFIG_FAT_SECTORCACHE_NSECTORS
+
+/* The maximum number of sectors moved in one block driver request by read-
+ * ahead or by write-back.  No more than half of the cache is filled by one
+ * read-ahead so that the requested sector cannot be evicted by its own
+ * read-ahead.
+ */
+
+#define FAT_CACHE_NBURST \
+  MIN(CONFIG_FAT_SECTORCACHE_READAHEAD + 1, FAT_CACHE_NSECTORS / 2)
+
+/****************************************************************************
+ * Private Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: fat_cachefind
+ *
+ * Description:
+ *   Return the cache entry that holds the specified sector or NULL if the
+ *   sector is not cached.
+ *
+ ****************************************************************************/
+
+static FAR struct fat_cachesector_s *
+fat_cachefind(FAR struct fat_mountpt_s *fs, off_t sector)
+{
+  int i;
+
+  for (i = 0; i < FAT_CACHE_NSECTORS; i++)
+    {
+      if (fs->fs_cache[i].cs_sector == sector)
+        {
+          return &fs->fs_cache[i];
+        }
+    }
+
+  return NULL;
+}
+
+/****************************************************************************
+ * Name: fat_cachetouch
+ *
+ * Description:
+ *   Mark a cache entry as the most recently used.
+ *
+ ****************************************************************************/
+
+static inline void fat_cachetouch(FAR struct fat_mountpt_s *fs,
+                                  FAR struct fat_cachesector_s *cs)
+{
+  cs->cs_age = ++fs->fs_cacheclock;
+}
+
+/****************************************************************************
+ * Name: fat_cachewriteback
+ *
+ * Description:
+ *   Write a dirty cache entry back to the media.  If burst is true, dirty
+ *   sectors that follow it on the media are written in the same block
+ *   driver request.  That uses the burst buffer, so burst must be false
+ *   while a read-ahead is in progress.
+ *
+ ****************************************************************************/
+
+static int fat_cachewriteback(FAR struct fat_mountpt_s *fs,
+                              FAR struct fat_cachesector_s *cs, bool burst)
+{
+  FAR struct fat_cachesector_s *next;
+  FAR struct fat_cachesector_s *run[FAT_CACHE_NBURST];
+  unsigned int nrun;
+  unsigned int i;
+  int ret;
+
+  /* Collect the run of consecutive dirty sectors */
+
+  run[0] = cs;
+  nrun   = 1;
+
+  if (burst && fs->fs_cacheburst != NULL)
+    {
+      while (nrun < FAT_CACHE_NBURST &&
+             (next = fat_cachefind(fs, cs->cs_sector + nrun)) != NULL &&
+             next->cs_dirty)
+        {
+          run[nrun++] = next;
+        }
+    }
+
+  if (nrun == 1)
+    {
+      ret = fat_devwrite(fs, cs->cs_buffer, cs->cs_sector, 1);
+    }
+  else
+    {
+      for (i = 0; i < nrun; i++)
+        {
+          memcpy(&fs->fs_cacheburst[i * fs->fs_hwsectorsize],
+                 run[i]->cs_buffer, fs->fs_hwsectorsize);
+        }
+
+      ret = fat_devwrite(fs, fs->fs_cacheburst, cs->cs_sector, nrun);
+    }
+
+  if (ret < 0)
+    {
+      ferr("ERROR: Failed to write back sector %ld: %d\n",
+           (long)cs->cs_sector, ret);
+      return ret;
+    }
+
+  for (i = 0; i < nrun; i++)
+    {
+      run[i]->cs_dirty = false;
+    }
+
+  return OK;
+}
+
+/****************************************************************************
+ * Name: fat_cachealloc
+ *
+ * Description:
+ *   Assign a cache entry to the specified sector, which must not already be
+ *   cached.  An unused entry is taken if there is one; otherwise the least
+ *   recently used entry is evicted, writing it back first if it is dirty.
+ *   The content of the returned entry is undefined.
+ *
+ ****************************************************************************/
+
+static int fat_cachealloc(FAR struct fat_mountpt_s *fs, off_t sector,
+                          FAR struct fat_cachesector_s **entry)
+{
+  FAR struct fat_cachesector_s *victim = NULL;
+  FAR struct fat_cachesector_s *cs;
+  int ret;
+  int i;
+
+  for (i = 0; i < FAT_CACHE_NSECTORS; i++)
+    {
+      cs = &fs->fs_cache[i];
+      if (cs->cs_sector < 0)
+        {
+          victim = cs;
+          break;
+        }
+
+      /* Compare the ages modulo 2**32 so that wrap-around is harmless */
+
+      if (victim == NULL || (int32_t)(cs->cs_age - victim->cs_age) < 0)
+        {
+          victim = cs;
+        }
+    }
+
+  if (victim->cs_dirty)
+    {
+      ret = fat_cachewriteback(fs, victim, false);
+      if (ret < 0)
+        {
+          return ret;
+        }
+    }
+
+  victim->cs_sector = sector;
+  victim->cs_dirty  = false;
+  fat_cachetouch(fs, victim);
+
+  *entry = victim;
+  return OK;
+}
+
+/****************************************************************************
+ * Name: fat_cachereadahead
+ *
+ * Description:
+ *   Read the specified sector and the sectors that follow it into the cache
+ *   in one block driver request.  Sectors that are already cached are not
+ *   replaced since the cached copy may be newer than the media.
+ *
+ ****************************************************************************/
+
+static int fat_cachereadahead(FAR struct fat_mountpt_s *fs, off_t sector,
+                              unsigned int nsectors,
+                              FAR struct fat_cachesector_s **entry)
+{
+  FAR struct fat_cachesector_s *cs;
+  unsigned int i;
+  int ret;
+
+  ret = fat_devread(fs, fs->fs_cacheburst, sector, nsectors);
+  if (ret < 0)
+    {
+      return ret;
+    }
+
+  /* Cache the read-ahead sectors first so that the requested sector ends up
+   * as the most recently used.
+   */
+
+  for (i = 1; i < nsectors; i++)
+    {
+      if (fat_cachefind(fs, sector + i) == NULL)
+        {
+          if (fat_cachealloc(fs, sector + i, &cs) < 0)
+            {
+              break;
+            }
+
+          memcpy(cs->cs_buffer, &fs->fs_cacheburst[i * fs->fs_hwsectorsize],
+                 fs->fs_hwsectorsize);
+        }
+    }
+
+  ret = fat_cachealloc(fs, sector, &cs);
+  if (ret < 0)
+    {
+      return ret;
+    }
+
+  memcpy(cs->cs_buffer, fs->fs_cacheburst, fs->fs_hwsectorsize);
+  *entry = cs;
+  return OK;
+}
+
+/****************************************************************************
+ * Name: fat_cacheworker
+ *
+ * Description:
+ *   Write back the dirty sectors when the write-back delay expires.
+ *
+ ****************************************************************************/
+
+#ifdef FAT_CACHE_TIMER
+static void fat_cacheworker(FAR void *arg)
+{
+  FAR struct fat_mountpt_s *fs = (FAR struct fat_mountpt_s *)arg;
+
+  fat_semtake(fs);
+  if (fs->fs_cache != NULL)
+    {
+      fat_cacheflush(fs);
+    }
+
+  fs->fs_cachepending = false;
+  fat_semgive(fs);
+}
+#endif
+
+/****************************************************************************
+ * Name: fat_cacheschedule
+ *
+ * Description:
+ *   Start the write-back delay if it is not already running.
+ *
+ ****************************************************************************/
+
+#ifdef FAT_CACHE_TIMER
+static void fat_cacheschedule(FAR struct fat_mountpt_s *fs)
+{
+  if (!fs->fs_cachepending &&
+      work_queue(LPWORK, &fs->fs_cachework, fat_cacheworker, fs,
+                 MSEC2TICK(CONFIG_FAT_SECTORCACHE_FLUSHMS)) == OK)
+    {
+      fs->fs_cachepending = true;
+    }
+}
+#else
+#  define fat_cacheschedule(fs)
+#endif
+
+/****************************************************************************
+ * Public Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: fat_cacheinitialize
+ *
+ * Description:
+ *   Allocate the sector cache of a mountpoint.  Called from fat_mount()
+ *   once the hardware sector size is known.
+ *
+ ****************************************************************************/
+
+int fat_cacheinitialize(FAR struct fat_mountpt_s *fs)
+{
+  int i;
+
+  fs->fs_cache = (FAR struct fat_cachesector_s *)
+    kmm_zalloc(FAT_CACHE_NSECTORS * sizeof(struct fat_cachesector_s));
+  if (fs->fs_cache == NULL)
+    {
+      return -ENOMEM;
+    }
+
+  fs->fs_cachebuffer = (FAR uint8_t *)
+    fat_io_alloc(FAT_CACHE_NSECTORS * fs->fs_hwsectorsize);
+  if (fs->fs_cachebuffer == NULL)
+    {
+      kmm_free(fs->fs_cache);
+      fs->fs_cache = NULL;
+      return -ENOMEM;
+    }
+
+  /* Read-ahead and write-back bursts are simply not done if there is no
+   * memory for the burst buffer.
+   */
+
+  if (FAT_CACHE_NBURST > 1)
+    {
+      fs->fs_cacheburst = (FAR uint8_t *)
+        fat_io_alloc(FAT_CACHE_NBURST * fs->fs_hwsectorsize);
+    }
+
+  for (i = 0; i < FAT_CACHE_NSECTORS; i++)
+    {
+      fs->fs_cache[i].cs_sector = -1;
+      fs->fs_cache[i].cs_buffer =
+        &fs->fs_cachebuffer[i * fs->fs_hwsectorsize];
+    }
+
+  fs->fs_cachelast = -1;
+  return OK;
+}
+
+/****************************************************************************
+ * Name: fat_cacheuninitialize
+ *
+ * Description:
+ *   Release the sector cache of a mountpoint.  Dirty sectors are discarded;
+ *   fat_cacheflush() must be called first to keep them.  The caller must
+ *   hold the mountpoint semaphore.
+ *
+ ****************************************************************************/
+
+void fat_cacheuninitialize(FAR struct fat_mountpt_s *fs)
+{
+#ifdef FAT_CACHE_TIMER
+  /* Make sure that the write-back work is no longer using the mountpoint */
+
+  while (fs->fs_cachepending)
+    {
+      if (work_cancel(LPWORK, &fs->fs_cachework) == OK)
+        {
+          fs->fs_cachepending = false;
+          break;
+        }
+
+      /* The work is already running and waiting for the semaphore */
+
+      fat_semgive(fs);
+      nxsig_usleep(USEC_PER_TICK);
+      fat_semtake(fs);
+    }
+#endif
+
+  if (fs->fs_cacheburst != NULL)
+    {
+      fat_io_free(fs->fs_cacheburst,
+                  FAT_CACHE_NBURST * fs->fs_hwsectorsize);
+      fs->fs_cacheburst = NULL;
+    }
+
+  if (fs->fs_cachebuffer != NULL)
+    {
+      fat_io_free(fs->fs_cachebuffer,
+                  FAT_CACHE_NSECTORS * fs->fs_hwsectorsize);
+      fs->fs_cachebuffer = NULL;
+    }
+
+  if (fs->fs_cache != NULL)
+    {
+      kmm_free(fs->fs_cache);
+      fs->fs_cache = NULL;
+    }
+}
+
+/****************************************************************************
+ * Name: fat_cacheread
+ *
+ * Description:
+ *   Read sectors through the sector cache.  Single sector reads, which are
+ *   used for FAT, directory and partial file sectors, are served from the
+ *   cache; a miss that continues a sequential access pattern reads ahead.
+ *   Multi-sector reads go directly to the user buffer and are only patched
+ *   with any newer, dirty sectors from the cache.
+ *
+ ****************************************************************************/
+
+int fat_cacheread(FAR struct fat_mountpt_s *fs, FAR uint8_t *buffer,
+                  off_t sector, unsigned int nsectors)
+{
+  FAR struct fat_cachesector_s *cs;
+  unsigned int nburst;
+  int ret;
+  int i;
+
+  if (nsectors > 1)
+    {
+      ret = fat_devread(fs, buffer, sector, nsectors);
+      if (ret < 0)
+        {
+          return ret;
+        }
+
+      for (i = 0; i < FAT_CACHE_NSECTORS; i++)
+        {
+          cs = &fs->fs_cache[i];
+          if (cs->cs_dirty && cs->cs_sector >= sector &&
+              cs->cs_sector < sector + nsectors)
+            {
+              memcpy(&buffer[(cs->cs_sector - sector) * fs->fs_hwsectorsize],
+                     cs->cs_buffer, fs->fs_hwsectorsize);
+            }
+        }
+
+      return OK;
+    }
+
+  cs = fat_cachefind(fs, sector);
+  if (cs != NULL)
+    {
+      fat_cachetouch(fs, cs);
+    }
+  else
+    {
+      /* Read ahead only if this continues a sequential access */
+
+      nburst = 1;
+      if (fs->fs_cacheburst != NULL && sector == fs->fs_cachelast + 1)
+        {
+          nburst = FAT_CACHE_NBURST;
+          if (sector + nburst > fs->fs_hwnsectors)
+            {
+              nburst = fs->fs_hwnsectors - sector;
+            }
+        }
+
+      if (nburst > 1)
+        {
+          ret = fat_cachereadahead(fs, sector, nburst, &cs);
+        }
+      else
+        {
+          ret = fat_cachealloc(fs, sector, &cs);
+          if (ret >= 0)
+            {
+              ret = fat_devread(fs, cs->cs_buffer, sector, 1);
+              if (ret < 0)
+                {
+                  cs->cs_sector = -1;
+                }
+            }
+        }
+
+      if (ret < 0)
+        {
+          return ret;
+        }
+    }
+
+  memcpy(buffer, cs->cs_buffer, fs->fs_hwsectorsize);
+  fs->fs_cachelast = sector;
+  return OK;
+}
+
+/****************************************************************************
+ * Name: fat_cachewrite
+ *
+ * Description:
+ *   Write sectors through the sector cache.  Single sector writes are held
+ *   in the cache until they are evicted, flushed by fat_cacheflush(), or
+ *   the write-back delay expires.  Multi-sector writes go directly to the
+ *   media and update any cached copies.
+ *
+ ****************************************************************************/
+
+int fat_cachewrite(FAR struct fat_mountpt_s *fs, FAR uint8_t *buffer,
+                   off_t sector, unsigned int nsectors)
+{
+  FAR struct fat_cachesector_s *cs;
+  int ret;
+  int i;
+
+  if (nsectors > 1)
+    {
+      ret = fat_devwrite(fs, buffer, sector, nsectors);
+      if (ret < 0)
+        {
+          return ret;
+        }
+
+      for (i = 0; i < FAT_CACHE_NSECTORS; i++)
+        {
+          cs = &fs->fs_cache[i];
+          if (cs->cs_sector >= sector && cs->cs_sector < sector + nsectors)
+            {
+              memcpy(cs->cs_buffer,
+                     &buffer[(cs->cs_sector - sector) * fs->fs_hwsectorsize],
+                     fs->fs_hwsectorsize);
+              cs->cs_dirty = false;
+            }
+        }
+
+      return OK;
+    }
+
+  cs = fat_cachefind(fs, sector);
+  if (cs != NULL)
+    {
+      fat_cachetouch(fs, cs);
+    }
+  else
+    {
+      ret = fat_cachealloc(fs, sector, &cs);
+      if (ret < 0)
+        {
+          return ret;
+        }
+    }
+
+  memcpy(cs->cs_buffer, buffer, fs->fs_hwsectorsize);
+  cs->cs_dirty = true;
+  fat_cacheschedule(fs);
+  return OK;
+}
+
+/****************************************************************************
+ * Name: fat_cacheflush
+ *
+ * Description:
+ *   Write back all dirty sectors in ascending sector order.
+ *
+ ****************************************************************************/
+
+int fat_cacheflush(FAR struct fat_mountpt_s *fs)
+{
+  FAR struct fat_cachesector_s *first;
+  FAR struct fat_cachesector_s *cs;
+  int ret;
+  int i;
+
+  if (fs->fs_cache == NULL)
+    {
+      return OK;
+    }
+
+  for (; ; )
+    {
+      first = NULL;
+      for (i = 0; i < FAT_CACHE_NSECTORS; i++)
+        {
+          cs = &fs->fs_cache[i];
+          if (cs->cs_dirty &&
+              (first == NULL || cs->cs_sector < first->cs_sector))
+            {
+              first = cs;
+            }
+        }
+
+      if (first == NULL)
+        {
+          return OK;
+        }
+
+      ret = fat_cachewriteback(fs, first, true);
+      if (ret < 0)
+        {
+          return ret;
+        }
+    }
+}
+
+/****************************************************************************
+ * Name: fat_cacheinvalidate
+ *
+ * Description:
+ *   Discard the content of the sector cache, including dirty sectors.  Used
+ *   when the media has been removed or changed.
+ *
+ ****************************************************************************/
+
+void fat_cacheinvalidate(FAR struct fat_mountpt_s *fs)
+{
+  int i;
+
+  if (fs->fs_cache != NULL)
+    {
+      for (i = 0; i < FAT_CACHE_NSECTORS; i++)
+        {
+          fs->fs_cache[i].cs_sector = -1;
+          fs->fs_cache[i].cs_dirty  = false;
+        }
+    }
+
+  fs->fs_cachelast = -1;
+}
+
+#endif /* CONFIG_FAT_SECTORCACHE */
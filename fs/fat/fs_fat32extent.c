@@ -0,0 +1,321 @@
+/****************************************************************************
+ * fs/fat/fs_fat32extent.c
+ *
+ *   Copyright (C) 2020 Gregory Nutt. All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in
+ *    the documentation and/or other materials provided with the
+ *    distribution.
+ * 3. Neither the name NuttX nor the names of its contributors may be
+ *    used to endorse or promote products derived from this software
+ *    without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+ * FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE
+ * COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+ * INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,
+ * BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS
+ * OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED
+ * AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ * LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN
+ * ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ *
+ ****************************************************************************/
+
+/****************************************************************************
+ * Included Files
+ ****************************************************************************/
+
+#include <nuttx/config.h>
+
+#include <sys/types.h>
+#include <stdint.h>
+#include <stdbool.h>
+#include <assert.h>
+#include <errno.h>
+#include <debug.h>
+
+#include <nuttx/kmalloc.h>
+
+#include "fs_fat32.h"
+
+#ifdef CONFIG_FAT_EXTENTCACHE
+
+/****************************************************************************
+ * Private Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: fat_extentsearch
+ *
+ * Description:
+ *   Binary search for the last extent that starts at or before the file
+ *   cluster index.  The map must not be empty.
+ *
+ ****************************************************************************/
+
+static FAR struct fat_extent_s *fat_extentsearch(FAR struct fat_file_s *ff,
+                                                 uint32_t index)
+{
+  FAR struct fat_extent_s *extents = ff->ff_extents;
+  int low  = 0;
+  int high = ff->ff_nextents - 1;
+  int mid;
+
+  /* The first extent always starts at index zero */
+
+  while (low < high)
+    {
+      mid = (low + high + 1) >> 1;
+      if (extents[mid].fe_index <= index)
+        {
+          low = mid;
+        }
+      else
+        {
+          high = mid - 1;
+        }
+    }
+
+  return &extents[low];
+}
+
+/****************************************************************************
+ * Public Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: fat_extentseek
+ *
+ * Description:
+ *   Find a cluster in the cluster chain of an open file.  The map of the
+ *   chain is built lazily:  Only the part of the chain beyond the mapped
+ *   extents is followed through the FAT, and the runs of contiguous
+ *   clusters found on the way are added to the map.  Once the map is full,
+ *   the chain beyond it is followed without being recorded.
+ *
+ * Input Parameters:
+ *   fs      - The mountpoint
+ *   ff      - The open file.  The file must have a cluster chain.
+ *   index   - The index of the requested cluster within the file
+ *   found   - Returns the index of the returned cluster.  This is less than
+ *             index if the chain ends before the requested cluster.
+ *   ncontig - If not NULL, returns the number of clusters, starting with
+ *             the returned cluster, that are known to be contiguous on the
+ *             media.
+ *
+ * Returned Value:
+ *   The cluster number on success; a negated errno value on failure.
+ *
+ ****************************************************************************/
+
+int32_t fat_extentseek(FAR struct fat_mountpt_s *fs,
+                       FAR struct fat_file_s *ff, uint32_t index,
+                       FAR uint32_t *found, FAR uint32_t *ncontig)
+{
+  FAR struct fat_extent_s *fe = NULL;
+  off_t next;
+  uint32_t cluster;
+  uint32_t ndx;
+
+  DEBUGASSERT(ff->ff_startcluster != 0);
+
+  /* Allocate the map on first use.  Without it, the chain is simply
+   * followed from the start.
+   */
+
+  if (ff->ff_extents == NULL)
+    {
+      ff->ff_extents = (FAR struct fat_extent_s *)
+        kmm_malloc(CONFIG_FAT_EXTENTCACHE_NEXTENTS *
+                   sizeof(struct fat_extent_s));
+      ff->ff_nextents = 0;
+    }
+
+  if (ff->ff_extents != NULL)
+    {
+      if (ff->ff_nextents == 0)
+        {
+          ff->ff_extents[0].fe_index     = 0;
+          ff->ff_extents[0].fe_cluster   = ff->ff_startcluster;
+          ff->ff_extents[0].fe_nclusters = 1;
+          ff->ff_nextents                = 1;
+        }
+
+      fe = fat_extentsearch(ff, index);
+      if (index < fe->fe_index + fe->fe_nclusters)
+        {
+          /* The cluster is in the map */
+
+          *found = index;
+          if (ncontig != NULL)
+            {
+              *ncontig = fe->fe_index + fe->fe_nclusters - index;
+            }
+
+          return fe->fe_cluster + (index - fe->fe_index);
+        }
+
+      /* Only the last extent can end before the requested index.  Continue
+       * from its last cluster.
+       */
+
+      ndx     = fe->fe_index + fe->fe_nclusters - 1;
+      cluster = fe->fe_cluster + fe->fe_nclusters - 1;
+    }
+  else
+    {
+      ndx     = 0;
+      cluster = ff->ff_startcluster;
+    }
+
+  while (ndx < index)
+    {
+      next = fat_getcluster(fs, cluster);
+      if (next < 0)
+        {
+          return next;
+        }
+
+      if (next < 2 || next >= fs->fs_nclusters)
+        {
+          /* End of the chain */
+
+          break;
+        }
+
+      ndx++;
+
+      /* Record the cluster as long as the map still describes the chain up
+       * to here.
+       */
+
+      if (fe != NULL)
+        {
+          if (next == cluster + 1)
+            {
+              fe->fe_nclusters++;
+            }
+          else if (ff->ff_nextents < CONFIG_FAT_EXTENTCACHE_NEXTENTS)
+            {
+              fe = &ff->ff_extents[ff->ff_nextents++];
+              fe->fe_index     = ndx;
+              fe->fe_cluster   = next;
+              fe->fe_nclusters = 1;
+            }
+          else
+            {
+              fe = NULL;
+            }
+        }
+
+      cluster = next;
+    }
+
+  *found = ndx;
+  if (ncontig != NULL)
+    {
+      *ncontig = 1;
+    }
+
+  return cluster;
+}
+
+/****************************************************************************
+ * Name: fat_extentcontig
+ *
+ * Description:
+ *   Return how many of the next nsectors sectors of an open file, starting
+ *   at the current sector, can be transferred in one block driver request
+ *   because they lie in clusters that are contiguous on the media.  The
+ *   result is never less than the number of sectors remaining in the
+ *   current cluster (or nsectors if that is smaller).
+ *
+ * Input Parameters:
+ *   fs       - The mountpoint
+ *   ff       - The open file
+ *   position - The file position of the current sector
+ *   nsectors - The number of sectors to be transferred
+ *
+ ****************************************************************************/
+
+unsigned int fat_extentcontig(FAR struct fat_mountpt_s *fs,
+                              FAR struct fat_file_s *ff, off_t position,
+                              unsigned int nsectors)
+{
+  off_t clustersize = fs->fs_fatsecperclus * fs->fs_hwsectorsize;
+  unsigned int maxsectors;
+  uint32_t index = position / clustersize;
+  uint32_t last;
+  uint32_t found;
+  uint32_t ncontig;
+  int32_t cluster;
+
+  if (nsectors <= ff->ff_sectorsincluster || ff->ff_startcluster == 0)
+    {
+      return MIN(nsectors, ff->ff_sectorsincluster);
+    }
+
+  /* Make sure that the map covers all clusters of the transfer */
+
+  last = (position + (off_t)nsectors * fs->fs_hwsectorsize - 1) /
+         clustersize;
+  if (fat_extentseek(fs, ff, last, &found, NULL) < 0)
+    {
+      return ff->ff_sectorsincluster;
+    }
+
+  cluster = fat_extentseek(fs, ff, index, &found, &ncontig);
+  if (cluster != ff->ff_currentcluster || found != index)
+    {
+      return ff->ff_sectorsincluster;
+    }
+
+  maxsectors = ff->ff_sectorsincluster +
+               (ncontig - 1) * fs->fs_fatsecperclus;
+  return MIN(nsectors, maxsectors);
+}
+
+/****************************************************************************
+ * Name: fat_extentinvalidate
+ *
+ * Description:
+ *   Discard the map when the cluster chain of the file is shortened.  Adding
+ *   clusters to the end of the chain does not invalidate the map.
+ *
+ ****************************************************************************/
+
+void fat_extentinvalidate(FAR struct fat_file_s *ff)
+{
+  ff->ff_nextents = 0;
+}
+
+/****************************************************************************
+ * Name: fat_extentfree
+ *
+ * Description:
+ *   Release the map when the file is closed.
+ *
+ ****************************************************************************/
+
+void fat_extentfree(FAR struct fat_file_s *ff)
+{
+  if (ff->ff_extents != NULL)
+    {
+      kmm_free(ff->ff_extents);
+      ff->ff_extents  = NULL;
+      ff->ff_nextents = 0;
+    }
+}
+
+#endif /* CONFIG_FAT_EXTENTCACHE */
@@ -543,6 +543,18 @@ int fat_mount(struct fat_mountpt_s *fs, bool writeable)
       goto errout;
     }
 
+#ifdef CONFIG_FAT_SECTORCACHE
+  /* Allocate the sector cache.  The cache is optional:  If it cannot be
+   * allocated, the volume is accessed without it.
+   */
+
+  ret = fat_cacheinitialize(fs);
+  if (ret < 0)
+    {
+      fwarn("WARNING: No sector cache: %d\n", ret);
+    }
+#endif
+
   /* Search FAT boot record on the drive.  First check the MBR at sector
    * zero.  This could be either the boot record or a partition that refers
    * to the boot record.
@@ -670,6 +682,9 @@ int fat_mount(struct fat_mountpt_s *fs, bool writeable)
   return OK;
 
 errout_with_buffer:
+#ifdef CONFIG_FAT_SECTORCACHE
+  fat_cacheuninitialize(fs);
+#endif
   fat_io_free(fs->fs_buffer, fs->fs_hwsectorsize);
   fs->fs_buffer = 0;
 
@@ -717,6 +732,12 @@ int fat_checkmount(struct fat_mountpt_s *fs)
       /* If we get here, the mount is NOT healthy */
 
       fs->fs_mounted = false;
+
+#ifdef CONFIG_FAT_SECTORCACHE
+      /* Whatever is cached belongs to the old media */
+
+      fat_cacheinvalidate(fs);
+#endif
     }
 
   return -ENODEV;
@@ -732,6 +753,49 @@ int fat_checkmount(struct fat_mountpt_s *fs)
 
 int fat_hwread(struct fat_mountpt_s *fs, uint8_t *buffer,  off_t sector,
                unsigned int nsectors)
+{
+#ifdef CONFIG_FAT_SECTORCACHE
+  if (fs && fs->fs_cache)
+    {
+      return fat_cacheread(fs, buffer, sector, nsectors);
+    }
+#endif
+
+  return fat_devread(fs, buffer, sector, nsectors);
+}
+
+/****************************************************************************
+ * Name: fat_hwwrite
+ *
+ * Description:
+ *   Write the sector buffer to the specified sector
+ *
+ ****************************************************************************/
+
+int fat_hwwrite(struct fat_mountpt_s *fs, uint8_t *buffer, off_t sector,
+                unsigned int nsectors)
+{
+#ifdef CONFIG_FAT_SECTORCACHE
+  if (fs && fs->fs_cache)
+    {
+      return fat_cachewrite(fs, buffer, sector, nsectors);
+    }
+#endif
+
+  return fat_devwrite(fs, buffer, sector, nsectors);
+}
+
+/****************************************************************************
+ * Name: fat_devread
+ *
+ * Description:
+ *   Read the specified sectors from the block driver, bypassing the sector
+ *   cache.
+ *
+ ****************************************************************************/
+
+int fat_devread(struct fat_mountpt_s *fs, uint8_t *buffer,  off_t sector,
+                unsigned int nsectors)
 {
   int ret = -ENODEV;
   if (fs && fs->fs_blkdriver)
@@ -756,15 +820,16 @@ int fat_hwread(struct fat_mountpt_s *fs, uint8_t *buffer,  off_t sector,
 }
 
 /****************************************************************************
- * Name: fat_hwwrite
+ * Name: fat_devwrite
  *
  * Description:
- *   Write the sector buffer to the specified sector
+ *   Write the specified sectors to the block driver, bypassing the sector
+ *   cache.
  *
  ****************************************************************************/
 
-int fat_hwwrite(struct fat_mountpt_s *fs, uint8_t *buffer, off_t sector,
-                unsigned int nsectors)
+int fat_devwrite(struct fat_mountpt_s *fs, uint8_t *buffer, off_t sector,
+                 unsigned int nsectors)
 {
   int ret = -ENODEV;
   if (fs && fs->fs_blkdriver)
@@ -41,8 +41,11 @@
 #include <nuttx/config.h>
 
 #include <errno.h>
+#include <fcntl.h>
+#include <queue.h>
 #include <string.h>
 
+#include <nuttx/clock.h>
 #include <nuttx/kmalloc.h>
 #include <nuttx/fs/hostfs.h>
 #include <nuttx/fs/hostfs_rpmsg.h>
@@ -55,10 +58,43 @@
  * Private Types
  ****************************************************************************/
 
+/* The read-ahead of one open file */
+
+struct hostfs_rpmsg_ra_s
+{
+  sq_entry_t            node;
+  int                   fd;
+  unsigned int          gen;    /* The invalidation generation of the data */
+  size_t                pos;    /* The next byte to return from buf */
+  size_t                len;    /* The number of valid bytes in buf */
+  char                  buf[CONFIG_FS_HOSTFS_RPMSG_READAHEAD];
+};
+
+/* One cached stat result */
+
+struct hostfs_rpmsg_attr_s
+{
+  FAR char              *path;
+  unsigned int          gen;
+  unsigned int          attrgen;
+  clock_t               time;
+  struct stat           buf;
+};
+
 struct hostfs_rpmsg_s
 {
   struct rpmsg_endpoint ept;
   FAR const char        *cpuname;
+  sem_t                 lock;   /* Protects the read-ahead list and attrs */
+  unsigned int          gen;    /* Bumped by the server invalidations */
+#if CONFIG_FS_HOSTFS_RPMSG_READAHEAD > 0
+  sq_queue_t            ra;
+#endif
+#if CONFIG_FS_HOSTFS_RPMSG_ATTRCACHE > 0
+  unsigned int          attrgen; /* Bumped by the local modifications */
+  unsigned int          attrnext;
+  struct hostfs_rpmsg_attr_s attr[CONFIG_FS_HOSTFS_RPMSG_ATTRCACHE];
+#endif
 };
 
 struct hostfs_rpmsg_cookie_s
@@ -68,6 +104,19 @@ struct hostfs_rpmsg_cookie_s
   FAR void  *data;
 };
 
+/* The cookie shared by all the requests of a pipelined read or write.  The
+ * server handles the requests in order, so the responses come back in
+ * order too and the data of each response directly follows the previous.
+ */
+
+struct hostfs_rpmsg_pipe_s
+{
+  sem_t        sem;
+  FAR char     *buf;    /* Where the next read response is copied */
+  unsigned int head;    /* The number of responses received */
+  int          result[CONFIG_FS_HOSTFS_RPMSG_PIPELINE];
+};
+
 /****************************************************************************
  * Private Function Prototypes
  ****************************************************************************/
@@ -75,9 +124,12 @@ struct hostfs_rpmsg_cookie_s
 static int hostfs_rpmsg_default_handler(FAR struct rpmsg_endpoint *ept,
                                         FAR void *data, size_t len,
                                         uint32_t src, FAR void *priv);
-static int hostfs_rpmsg_read_handler(FAR struct rpmsg_endpoint *ept,
+static int hostfs_rpmsg_pipe_handler(FAR struct rpmsg_endpoint *ept,
                                      FAR void *data, size_t len,
                                      uint32_t src, FAR void *priv);
+static int hostfs_rpmsg_invalidate_handler(FAR struct rpmsg_endpoint *ept,
+                                           FAR void *data, size_t len,
+                                           uint32_t src, FAR void *priv);
 static int hostfs_rpmsg_readdir_handler(FAR struct rpmsg_endpoint *ept,
                                         FAR void *data, size_t len,
                                         uint32_t src, FAR void *priv);
@@ -108,8 +160,8 @@ static const rpmsg_ept_cb g_hostfs_rpmsg_handler[] =
 {
   [HOSTFS_RPMSG_OPEN]      = hostfs_rpmsg_default_handler,
   [HOSTFS_RPMSG_CLOSE]     = hostfs_rpmsg_default_handler,
-  [HOSTFS_RPMSG_READ]      = hostfs_rpmsg_read_handler,
-  [HOSTFS_RPMSG_WRITE]     = hostfs_rpmsg_default_handler,
+  [HOSTFS_RPMSG_READ]      = hostfs_rpmsg_pipe_handler,
+  [HOSTFS_RPMSG_WRITE]     = hostfs_rpmsg_pipe_handler,
   [HOSTFS_RPMSG_LSEEK]     = hostfs_rpmsg_default_handler,
   [HOSTFS_RPMSG_IOCTL]     = hostfs_rpmsg_default_handler,
   [HOSTFS_RPMSG_SYNC]      = hostfs_rpmsg_default_handler,
@@ -126,6 +178,7 @@ static const rpmsg_ept_cb g_hostfs_rpmsg_handler[] =
   [HOSTFS_RPMSG_RMDIR]     = hostfs_rpmsg_default_handler,
   [HOSTFS_RPMSG_RENAME]    = hostfs_rpmsg_default_handler,
   [HOSTFS_RPMSG_STAT]      = hostfs_rpmsg_stat_handler,
+  [HOSTFS_RPMSG_INVALIDATE] = hostfs_rpmsg_invalidate_handler,
 };
 
 /****************************************************************************
@@ -151,26 +204,42 @@ static int hostfs_rpmsg_default_handler(FAR struct rpmsg_endpoint *ept,
   return 0;
 }
 
-static int hostfs_rpmsg_read_handler(FAR struct rpmsg_endpoint *ept,
+static int hostfs_rpmsg_pipe_handler(FAR struct rpmsg_endpoint *ept,
                                      FAR void *data, size_t len,
                                      uint32_t src, FAR void *priv)
 {
   FAR struct hostfs_rpmsg_header_s *header = data;
-  FAR struct hostfs_rpmsg_cookie_s *cookie =
-      (struct hostfs_rpmsg_cookie_s *)(uintptr_t)header->cookie;
+  FAR struct hostfs_rpmsg_pipe_s *pipe =
+      (struct hostfs_rpmsg_pipe_s *)(uintptr_t)header->cookie;
   FAR struct hostfs_rpmsg_read_s *rsp = data;
+  int result = header->result;
 
-  cookie->result = header->result;
-  if (cookie->result > 0)
+  pipe->result[pipe->head++ % CONFIG_FS_HOSTFS_RPMSG_PIPELINE] = result;
+  if (header->command == HOSTFS_RPMSG_READ && result > 0)
     {
-      memcpy(cookie->data, rsp->buf, B2C(cookie->result));
+      memcpy(pipe->buf, rsp->buf, B2C(result));
+      pipe->buf += B2C(result);
     }
 
-  nxsem_post(&cookie->sem);
+  nxsem_post(&pipe->sem);
 
   return 0;
 }
 
+static int hostfs_rpmsg_invalidate_handler(FAR struct rpmsg_endpoint *ept,
+                                           FAR void *data, size_t len,
+                                           uint32_t src, FAR void *priv_)
+{
+  FAR struct hostfs_rpmsg_s *priv = priv_;
+
+  /* Another client modified the file system: the cached data is checked
+   * against the generation before each use.
+   */
+
+  priv->gen++;
+  return 0;
+}
+
 static int hostfs_rpmsg_readdir_handler(FAR struct rpmsg_endpoint *ept,
                                         FAR void *data, size_t len,
                                         uint32_t src, FAR void *priv)
@@ -338,6 +407,272 @@ fail:
   return ret;
 }
 
+static ssize_t hostfs_rpmsg_transfer(uint32_t command, int fd,
+                                     FAR char *buf, size_t count)
+{
+  FAR struct hostfs_rpmsg_s *priv = &g_hostfs_rpmsg;
+  struct hostfs_rpmsg_pipe_s pipe;
+  size_t asked[CONFIG_FS_HOSTFS_RPMSG_PIPELINE];
+  size_t requested = 0;
+  size_t done = 0;
+  unsigned int sent = 0;
+  unsigned int acked = 0;
+  bool stop = false;
+  int ret = 0;
+
+  memset(&pipe, 0, sizeof(pipe));
+  nxsem_init(&pipe.sem, 0, 0);
+  nxsem_setprotocol(&pipe.sem, SEM_PRIO_NONE);
+  pipe.buf = buf;
+
+  for (; ; )
+    {
+      /* Keep the pipeline full, one request per rpmsg buffer */
+
+      while (!stop && sent - acked < CONFIG_FS_HOSTFS_RPMSG_PIPELINE &&
+             requested < count)
+        {
+          FAR struct hostfs_rpmsg_read_s *msg;
+          uint32_t space;
+          size_t len;
+          int err;
+
+          msg = rpmsg_get_tx_payload_buffer(&priv->ept, &space, true);
+          if (!msg)
+            {
+              ret  = -ENOMEM;
+              stop = true;
+              break;
+            }
+
+          space -= sizeof(*msg);
+          if (space > count - requested)
+            {
+              space = count - requested;
+            }
+
+          msg->header.command = command;
+          msg->header.result  = -ENXIO;
+          msg->header.cookie  = (uintptr_t)&pipe;
+          msg->fd             = fd;
+          msg->count          = C2B(space);
+
+          len = sizeof(*msg);
+          if (command == HOSTFS_RPMSG_WRITE)
+            {
+              memcpy(msg->buf, buf + requested, space);
+              len += space;
+            }
+
+          err = rpmsg_send_nocopy(&priv->ept, msg, len);
+          if (err < 0)
+            {
+              ret  = err;
+              stop = true;
+              break;
+            }
+
+          asked[sent++ % CONFIG_FS_HOSTFS_RPMSG_PIPELINE] = space;
+          requested += space;
+        }
+
+      if (sent == acked)
+        {
+          break;
+        }
+
+      /* Retire the oldest request */
+
+      nxsem_wait_uninterruptible(&pipe.sem);
+
+      if (pipe.result[acked % CONFIG_FS_HOSTFS_RPMSG_PIPELINE] < 0)
+        {
+          ret  = pipe.result[acked % CONFIG_FS_HOSTFS_RPMSG_PIPELINE];
+          stop = true;
+        }
+      else
+        {
+          size_t got =
+            B2C(pipe.result[acked % CONFIG_FS_HOSTFS_RPMSG_PIPELINE]);
+          size_t want = asked[acked % CONFIG_FS_HOSTFS_RPMSG_PIPELINE];
+
+          done += got;
+          if (got < want)
+            {
+              /* The server may clip a read to its own buffer size, the
+               * requests in flight then simply continue from where this
+               * one stopped and the rest is asked again.  A short write or
+               * an empty read (end of file) ends the transfer.
+               */
+
+              requested -= want - got;
+              if (got == 0 || command == HOSTFS_RPMSG_WRITE)
+                {
+                  stop = true;
+                }
+            }
+        }
+
+      acked++;
+    }
+
+  nxsem_destroy(&pipe.sem);
+  return done ? done : ret;
+}
+
+#if CONFIG_FS_HOSTFS_RPMSG_READAHEAD > 0
+static FAR struct hostfs_rpmsg_ra_s *hostfs_rpmsg_ra_find(int fd,
+                                                          bool alloc)
+{
+  FAR struct hostfs_rpmsg_s *priv = &g_hostfs_rpmsg;
+  FAR struct hostfs_rpmsg_ra_s *ra;
+
+  nxsem_wait_uninterruptible(&priv->lock);
+
+  for (ra = (FAR struct hostfs_rpmsg_ra_s *)sq_peek(&priv->ra);
+       ra != NULL;
+       ra = (FAR struct hostfs_rpmsg_ra_s *)sq_next(&ra->node))
+    {
+      if (ra->fd == fd)
+        {
+          break;
+        }
+    }
+
+  if (ra == NULL && alloc)
+    {
+      ra = kmm_zalloc(sizeof(*ra));
+      if (ra != NULL)
+        {
+          ra->fd = fd;
+          sq_addfirst(&ra->node, &priv->ra);
+        }
+    }
+
+  nxsem_post(&priv->lock);
+  return ra;
+}
+
+/* Drop the read-ahead of fd, moving the server file position back to the
+ * first byte not returned to the caller.
+ */
+
+static int hostfs_rpmsg_ra_drop(int fd)
+{
+  FAR struct hostfs_rpmsg_ra_s *ra;
+  int ret = 0;
+
+  ra = hostfs_rpmsg_ra_find(fd, false);
+  if (ra != NULL && ra->pos < ra->len)
+    {
+      struct hostfs_rpmsg_lseek_s msg =
+      {
+        .fd     = fd,
+        .offset = -(int32_t)C2B(ra->len - ra->pos),
+        .whence = SEEK_CUR,
+      };
+
+      ra->pos = 0;
+      ra->len = 0;
+
+      ret = hostfs_rpmsg_send_recv(HOSTFS_RPMSG_LSEEK, true,
+              (struct hostfs_rpmsg_header_s *)&msg, sizeof(msg), NULL);
+    }
+
+  return ret < 0 ? ret : 0;
+}
+
+static void hostfs_rpmsg_ra_free(int fd)
+{
+  FAR struct hostfs_rpmsg_s *priv = &g_hostfs_rpmsg;
+  FAR struct hostfs_rpmsg_ra_s *ra;
+
+  ra = hostfs_rpmsg_ra_find(fd, false);
+  if (ra != NULL)
+    {
+      nxsem_wait_uninterruptible(&priv->lock);
+      sq_rem(&ra->node, &priv->ra);
+      nxsem_post(&priv->lock);
+      kmm_free(ra);
+    }
+}
+#else
+#  define hostfs_rpmsg_ra_drop(fd) 0
+#  define hostfs_rpmsg_ra_free(fd)
+#endif
+
+#if CONFIG_FS_HOSTFS_RPMSG_ATTRCACHE > 0
+static bool hostfs_rpmsg_attr_get(FAR const char *path,
+                                  FAR struct stat *buf)
+{
+  FAR struct hostfs_rpmsg_s *priv = &g_hostfs_rpmsg;
+  FAR struct hostfs_rpmsg_attr_s *attr;
+  clock_t now = clock_systimer();
+  bool found = false;
+  int i;
+
+  nxsem_wait_uninterruptible(&priv->lock);
+
+  for (i = 0; i < CONFIG_FS_HOSTFS_RPMSG_ATTRCACHE; i++)
+    {
+      attr = &priv->attr[i];
+      if (attr->path != NULL && attr->gen == priv->gen &&
+          attr->attrgen == priv->attrgen &&
+          now - attr->time < MSEC2TICK(CONFIG_FS_HOSTFS_RPMSG_ATTRCACHE_MSEC)
+          && strcmp(attr->path, path) == 0)
+        {
+          memcpy(buf, &attr->buf, sizeof(*buf));
+          found = true;
+          break;
+        }
+    }
+
+  nxsem_post(&priv->lock);
+  return found;
+}
+
+static void hostfs_rpmsg_attr_put(FAR const char *path, unsigned int gen,
+                                  unsigned int attrgen,
+                                  FAR const struct stat *buf)
+{
+  FAR struct hostfs_rpmsg_s *priv = &g_hostfs_rpmsg;
+  FAR struct hostfs_rpmsg_attr_s *attr;
+  FAR char *copy;
+
+  copy = kmm_malloc(strlen(path) + 1);
+  if (copy == NULL)
+    {
+      return;
+    }
+
+  strcpy(copy, path);
+
+  nxsem_wait_uninterruptible(&priv->lock);
+
+  attr = &priv->attr[priv->attrnext++ % CONFIG_FS_HOSTFS_RPMSG_ATTRCACHE];
+  kmm_free(attr->path);
+
+  attr->path    = copy;
+  attr->gen     = gen;
+  attr->attrgen = attrgen;
+  attr->time    = clock_systimer();
+  memcpy(&attr->buf, buf, sizeof(*buf));
+
+  nxsem_post(&priv->lock);
+}
+
+/* Called after a local modification has completed, a stat result fetched
+ * concurrently with the modification is not entered by the put.
+ */
+
+static void hostfs_rpmsg_attr_flush(void)
+{
+  g_hostfs_rpmsg.attrgen++;
+}
+#else
+#  define hostfs_rpmsg_attr_flush()
+#endif
+
 /****************************************************************************
  * Public Functions
  ****************************************************************************/
@@ -348,6 +683,7 @@ int host_open(FAR const char *pathname, int flags, int mode)
   FAR struct hostfs_rpmsg_open_s *msg;
   uint32_t space;
   size_t len;
+  int ret;
 
   len  = sizeof(*msg);
   len += B2C(strlen(pathname) + 1);
@@ -364,8 +700,15 @@ int host_open(FAR const char *pathname, int flags, int mode)
   msg->mode  = mode;
   cstr2bstr(msg->pathname, pathname);
 
-  return hostfs_rpmsg_send_recv(HOSTFS_RPMSG_OPEN, false,
+  ret = hostfs_rpmsg_send_recv(HOSTFS_RPMSG_OPEN, false,
           (struct hostfs_rpmsg_header_s *)msg, len, NULL);
+
+  if (flags & (O_CREAT | O_TRUNC))
+    {
+      hostfs_rpmsg_attr_flush();
+    }
+
+  return ret;
 }
 
 int host_close(int fd)
@@ -375,76 +718,105 @@ int host_close(int fd)
     .fd = fd,
   };
 
+  hostfs_rpmsg_ra_free(fd);
+
   return hostfs_rpmsg_send_recv(HOSTFS_RPMSG_CLOSE, true,
           (struct hostfs_rpmsg_header_s *)&msg, sizeof(msg), NULL);
 }
 
 ssize_t host_read(int fd, FAR void *buf, size_t count)
 {
+#if CONFIG_FS_HOSTFS_RPMSG_READAHEAD > 0
+  FAR struct hostfs_rpmsg_s *priv = &g_hostfs_rpmsg;
+  FAR struct hostfs_rpmsg_ra_s *ra;
+  unsigned int gen;
   size_t read = 0;
-  int ret = 0;
+  size_t n;
+  ssize_t ret;
 
-  while (read < count)
+  ra = hostfs_rpmsg_ra_find(fd, false);
+  if (ra != NULL && ra->pos < ra->len)
     {
-      struct hostfs_rpmsg_read_s msg =
-      {
-        .fd    = fd,
-        .count = C2B(count - read),
-      };
+      if (ra->gen != priv->gen)
+        {
+          /* The file may have changed under the read-ahead */
 
-      ret = hostfs_rpmsg_send_recv(HOSTFS_RPMSG_READ, true,
-              (FAR struct hostfs_rpmsg_header_s *)&msg, sizeof(msg), buf);
-      if (ret <= 0)
+          ret = hostfs_rpmsg_ra_drop(fd);
+          if (ret < 0)
+            {
+              return ret;
+            }
+        }
+      else
         {
-          break;
+          read = ra->len - ra->pos;
+          if (read > count)
+            {
+              read = count;
+            }
+
+          memcpy(buf, ra->buf + ra->pos, read);
+          ra->pos += read;
+          if (read == count)
+            {
+              return read;
+            }
         }
-
-      read += B2C(ret);
-      buf  += B2C(ret);
     }
 
-  return read ? read : ret;
-}
+  /* Large reads go directly to the caller's buffer, small ones refill the
+   * read-ahead.
+   */
 
-ssize_t host_write(int fd, FAR const void *buf, size_t count)
-{
-  FAR struct hostfs_rpmsg_s *priv = &g_hostfs_rpmsg;
-  size_t written = 0;
-  int ret = 0;
+  if (count - read >= CONFIG_FS_HOSTFS_RPMSG_READAHEAD ||
+      (ra == NULL && (ra = hostfs_rpmsg_ra_find(fd, true)) == NULL))
+    {
+      ret = hostfs_rpmsg_transfer(HOSTFS_RPMSG_READ, fd,
+                                  (FAR char *)buf + read, count - read);
+      return read ? read + (ret > 0 ? ret : 0) : ret;
+    }
 
-  while (written < count)
+  gen = priv->gen;
+  ret = hostfs_rpmsg_transfer(HOSTFS_RPMSG_READ, fd, ra->buf,
+                              CONFIG_FS_HOSTFS_RPMSG_READAHEAD);
+  if (ret <= 0)
     {
-      FAR struct hostfs_rpmsg_write_s *msg;
-      uint32_t space;
+      return read ? read : ret;
+    }
 
-      msg = rpmsg_get_tx_payload_buffer(&priv->ept, &space, true);
-      if (!msg)
-        {
-          ret = -ENOMEM;
-          break;
-        }
+  ra->gen = gen;
+  ra->len = ret;
 
-      space -= sizeof(*msg);
-      if (space > count - written)
-        {
-          space = count - written;
-        }
+  n = count - read;
+  if (n > (size_t)ret)
+    {
+      n = ret;
+    }
 
-      msg->fd    = fd;
-      msg->count = C2B(space);
-      memcpy(msg->buf, buf + written, space);
+  memcpy((FAR char *)buf + read, ra->buf, n);
+  ra->pos = n;
 
-      ret = hostfs_rpmsg_send_recv(HOSTFS_RPMSG_WRITE, false,
-                (struct hostfs_rpmsg_header_s *)msg, sizeof(*msg) + space, NULL);
-      if (ret <= 0)
-        {
-          break;
-        }
+  return read + n;
+#else
+  return hostfs_rpmsg_transfer(HOSTFS_RPMSG_READ, fd, buf, count);
+#endif
+}
+
+ssize_t host_write(int fd, FAR const void *buf, size_t count)
+{
+  ssize_t ret;
 
-      written += B2C(ret);
+  ret = hostfs_rpmsg_ra_drop(fd);
+  if (ret < 0)
+    {
+      return ret;
     }
 
-  return written ? written : ret;
+  ret = hostfs_rpmsg_transfer(HOSTFS_RPMSG_WRITE, fd,
+                              (FAR char *)buf, count);
+
+  hostfs_rpmsg_attr_flush();
+  return ret;
 }
 
 off_t host_lseek(int fd, off_t offset, int whence)
@@ -452,12 +824,31 @@ off_t host_lseek(int fd, off_t offset, int whence)
   struct hostfs_rpmsg_lseek_s msg =
   {
     .fd     = fd,
-    .offset = C2B(offset),
     .whence = whence,
   };
 
   int ret;
 
+#if CONFIG_FS_HOSTFS_RPMSG_READAHEAD > 0
+  FAR struct hostfs_rpmsg_ra_s *ra;
+
+  /* The server position is ahead by the unread read-ahead */
+
+  ra = hostfs_rpmsg_ra_find(fd, false);
+  if (ra != NULL)
+    {
+      if (whence == SEEK_CUR)
+        {
+          offset -= (off_t)(ra->len - ra->pos);
+        }
+
+      ra->pos = 0;
+      ra->len = 0;
+    }
+#endif
+
+  msg.offset = C2B(offset);
+
   ret = hostfs_rpmsg_send_recv(HOSTFS_RPMSG_LSEEK, true,
           (struct hostfs_rpmsg_header_s *)&msg, sizeof(msg), NULL);
 
@@ -473,6 +864,14 @@ int host_ioctl(int fd, int request, unsigned long arg)
     .arg     = arg,
   };
 
+  int ret;
+
+  ret = hostfs_rpmsg_ra_drop(fd);
+  if (ret < 0)
+    {
+      return ret;
+    }
+
   return hostfs_rpmsg_send_recv(HOSTFS_RPMSG_IOCTL, true,
           (struct hostfs_rpmsg_header_s *)&msg, sizeof(msg), NULL);
 }
@@ -495,6 +894,14 @@ int host_dup(int fd)
     .fd = fd,
   };
 
+  int ret;
+
+  ret = hostfs_rpmsg_ra_drop(fd);
+  if (ret < 0)
+    {
+      return ret;
+    }
+
   return hostfs_rpmsg_send_recv(HOSTFS_RPMSG_DUP, true,
           (struct hostfs_rpmsg_header_s *)&msg, sizeof(msg), NULL);
 }
@@ -518,8 +925,19 @@ int host_ftruncate(int fd, off_t length)
     .length = length,
   };
 
-  return hostfs_rpmsg_send_recv(HOSTFS_RPMSG_FTRUNCATE, true,
+  int ret;
+
+  ret = hostfs_rpmsg_ra_drop(fd);
+  if (ret < 0)
+    {
+      return ret;
+    }
+
+  ret = hostfs_rpmsg_send_recv(HOSTFS_RPMSG_FTRUNCATE, true,
           (struct hostfs_rpmsg_header_s *)&msg, sizeof(msg), NULL);
+
+  hostfs_rpmsg_attr_flush();
+  return ret;
 }
 
 FAR void *host_opendir(FAR const char *name)
@@ -612,6 +1030,7 @@ int host_unlink(FAR const char *pathname)
   struct hostfs_rpmsg_unlink_s *msg;
   uint32_t space;
   size_t len;
+  int ret;
 
   len  = sizeof(*msg);
   len += B2C(strlen(pathname) + 1);
@@ -626,8 +1045,11 @@ int host_unlink(FAR const char *pathname)
 
   cstr2bstr(msg->pathname, pathname);
 
-  return hostfs_rpmsg_send_recv(HOSTFS_RPMSG_UNLINK, false,
+  ret = hostfs_rpmsg_send_recv(HOSTFS_RPMSG_UNLINK, false,
           (struct hostfs_rpmsg_header_s *)msg, len, NULL);
+
+  hostfs_rpmsg_attr_flush();
+  return ret;
 }
 
 int host_mkdir(FAR const char *pathname, mode_t mode)
@@ -636,6 +1058,7 @@ int host_mkdir(FAR const char *pathname, mode_t mode)
   struct hostfs_rpmsg_mkdir_s *msg;
   uint32_t space;
   size_t len;
+  int ret;
 
   len  = sizeof(*msg);
   len += B2C(strlen(pathname) + 1);
@@ -649,8 +1072,11 @@ int host_mkdir(FAR const char *pathname, mode_t mode)
   msg->mode = mode;
   cstr2bstr(msg->pathname, pathname);
 
-  return hostfs_rpmsg_send_recv(HOSTFS_RPMSG_MKDIR, false,
+  ret = hostfs_rpmsg_send_recv(HOSTFS_RPMSG_MKDIR, false,
           (struct hostfs_rpmsg_header_s *)msg, len, NULL);
+
+  hostfs_rpmsg_attr_flush();
+  return ret;
 }
 
 int host_rmdir(FAR const char *pathname)
@@ -659,6 +1085,7 @@ int host_rmdir(FAR const char *pathname)
   struct hostfs_rpmsg_rmdir_s *msg;
   uint32_t space;
   size_t len;
+  int ret;
 
   len  = sizeof(*msg);
   len += B2C(strlen(pathname) + 1);
@@ -673,8 +1100,11 @@ int host_rmdir(FAR const char *pathname)
 
   cstr2bstr(msg->pathname, pathname);
 
-  return hostfs_rpmsg_send_recv(HOSTFS_RPMSG_RMDIR, false,
+  ret = hostfs_rpmsg_send_recv(HOSTFS_RPMSG_RMDIR, false,
           (struct hostfs_rpmsg_header_s *)msg, len, NULL);
+
+  hostfs_rpmsg_attr_flush();
+  return ret;
 }
 
 int host_rename(FAR const char *oldpath, FAR const char *newpath)
@@ -684,6 +1114,7 @@ int host_rename(FAR const char *oldpath, FAR const char *newpath)
   size_t len;
   size_t oldlen;
   uint32_t space;
+  int ret;
 
   len     = sizeof(*msg);
   oldlen  = B2C((strlen(oldpath) + 1 + 0x7) & ~0x7);
@@ -700,8 +1131,11 @@ int host_rename(FAR const char *oldpath, FAR const char *newpath)
   cstr2bstr(msg->pathname, oldpath);
   cstr2bstr(msg->pathname + oldlen, newpath);
 
-  return hostfs_rpmsg_send_recv(HOSTFS_RPMSG_RENAME, false,
+  ret = hostfs_rpmsg_send_recv(HOSTFS_RPMSG_RENAME, false,
           (struct hostfs_rpmsg_header_s *)msg, len, NULL);
+
+  hostfs_rpmsg_attr_flush();
+  return ret;
 }
 
 int host_stat(FAR const char *path, FAR struct stat *buf)
@@ -710,6 +1144,16 @@ int host_stat(FAR const char *path, FAR struct stat *buf)
   FAR struct hostfs_rpmsg_stat_s *msg;
   uint32_t space;
   size_t len;
+#if CONFIG_FS_HOSTFS_RPMSG_ATTRCACHE > 0
+  unsigned int attrgen = priv->attrgen;
+  unsigned int gen = priv->gen;
+  int ret;
+
+  if (hostfs_rpmsg_attr_get(path, buf))
+    {
+      return 0;
+    }
+#endif
 
   len  = sizeof(*msg);
   len += B2C(strlen(path) + 1);
@@ -724,8 +1168,19 @@ int host_stat(FAR const char *path, FAR struct stat *buf)
 
   cstr2bstr(msg->pathname, path);
 
+#if CONFIG_FS_HOSTFS_RPMSG_ATTRCACHE > 0
+  ret = hostfs_rpmsg_send_recv(HOSTFS_RPMSG_STAT, false,
+          (struct hostfs_rpmsg_header_s *)msg, len, buf);
+  if (ret >= 0)
+    {
+      hostfs_rpmsg_attr_put(path, gen, attrgen, buf);
+    }
+
+  return ret;
+#else
   return hostfs_rpmsg_send_recv(HOSTFS_RPMSG_STAT, false,
           (struct hostfs_rpmsg_header_s *)msg, len, buf);
+#endif
 }
 
 int hostfs_rpmsg_init(FAR const char *cpuname)
@@ -733,6 +1188,7 @@ int hostfs_rpmsg_init(FAR const char *cpuname)
   struct hostfs_rpmsg_s *priv = &g_hostfs_rpmsg;
 
   priv->cpuname = cpuname;
+  nxsem_init(&priv->lock, 0, 1);
 
   return rpmsg_register_callback(priv,
                                  hostfs_rpmsg_device_created,
@@ -74,6 +74,7 @@
 #define HOSTFS_RPMSG_RMDIR          18
 #define HOSTFS_RPMSG_RENAME         19
 #define HOSTFS_RPMSG_STAT           20
+#define HOSTFS_RPMSG_INVALIDATE     21
 
 /****************************************************************************
  * Public Types
@@ -198,4 +199,10 @@ begin_packed_struct struct hostfs_rpmsg_stat_s
   char                         pathname[0];
 } end_packed_struct;
 
+/* Sent unsolicited by the server to the other clients after a modification,
+ * no response is expected.
+ */
+
+#define hostfs_rpmsg_invalidate_s hostfs_rpmsg_header_s
+
 #endif /* __FS_HOSTFS_HOSTFS_RPMSG_H */
@@ -45,6 +45,7 @@
 #include <string.h>
 #include <fcntl.h>
 #include <errno.h>
+#include <queue.h>
 
 #include <nuttx/kmalloc.h>
 #include <nuttx/fs/fs.h>
@@ -59,6 +60,7 @@
 
 struct hostfs_rpmsg_server_s
 {
+  sq_entry_t            node;
   struct rpmsg_endpoint ept;
   struct file           files[CONFIG_NFILE_DESCRIPTORS];
   void                  *dirs[CONFIG_NFILE_DESCRIPTORS];
@@ -142,6 +144,11 @@ static int  hostfs_rpmsg_ept_cb(FAR struct rpmsg_endpoint *ept,
  * Private Data
  ****************************************************************************/
 
+/* All the connected clients, to be told about the modifications */
+
+static sq_queue_t g_hostfs_rpmsg_servers;
+static sem_t g_hostfs_rpmsg_servers_sem = SEM_INITIALIZER(1);
+
 static const rpmsg_ept_cb g_hostfs_rpmsg_handler[] =
 {
   [HOSTFS_RPMSG_OPEN]      = hostfs_rpmsg_open_handler,
@@ -170,6 +177,36 @@ static const rpmsg_ept_cb g_hostfs_rpmsg_handler[] =
  * Private Functions
  ****************************************************************************/
 
+/* Tell the clients other than priv that their cached attributes and data
+ * may be stale.  A client whose tx buffers are all busy misses the message,
+ * its attribute cache then still expires on the timeout.
+ */
+
+static void hostfs_rpmsg_invalidate(FAR struct hostfs_rpmsg_server_s *priv)
+{
+  FAR struct hostfs_rpmsg_server_s *server;
+
+  nxsem_wait_uninterruptible(&g_hostfs_rpmsg_servers_sem);
+
+  for (server = (FAR struct hostfs_rpmsg_server_s *)
+                sq_peek(&g_hostfs_rpmsg_servers);
+       server != NULL;
+       server = (FAR struct hostfs_rpmsg_server_s *)sq_next(&server->node))
+    {
+      struct hostfs_rpmsg_invalidate_s msg =
+      {
+        .command = HOSTFS_RPMSG_INVALIDATE,
+      };
+
+      if (server != priv)
+        {
+          rpmsg_trysend(&server->ept, &msg, sizeof(msg));
+        }
+    }
+
+  nxsem_post(&g_hostfs_rpmsg_servers_sem);
+}
+
 static int hostfs_rpmsg_open_handler(FAR struct rpmsg_endpoint *ept,
                                      FAR void *data, size_t len,
                                      uint32_t src, FAR void *priv_)
@@ -197,6 +234,11 @@ static int hostfs_rpmsg_open_handler(FAR struct rpmsg_endpoint *ept,
 
   nxsem_post(&priv->sem);
 
+  if (ret >= 0 && (msg->flags & (O_CREAT | O_TRUNC)))
+    {
+      hostfs_rpmsg_invalidate(priv);
+    }
+
   msg->header.result = ret;
   return rpmsg_send(ept, msg, sizeof(*msg));
 }
@@ -266,6 +308,11 @@ static int hostfs_rpmsg_write_handler(FAR struct rpmsg_endpoint *ept,
       ret = file_write(&priv->files[msg->fd], msg->buf, msg->count);
     }
 
+  if (ret > 0)
+    {
+      hostfs_rpmsg_invalidate(priv);
+    }
+
   msg->header.result = ret;
   return rpmsg_send(ept, msg, sizeof(*msg));
 }
@@ -384,6 +431,11 @@ static int hostfs_rpmsg_ftruncate_handler(FAR struct rpmsg_endpoint *ept,
       ret = file_truncate(&priv->files[msg->fd], msg->length);
     }
 
+  if (ret >= 0)
+    {
+      hostfs_rpmsg_invalidate(priv);
+    }
+
   msg->header.result = ret;
   return rpmsg_send(ept, msg, sizeof(*msg));
 }
@@ -508,6 +560,11 @@ static int hostfs_rpmsg_unlink_handler(FAR struct rpmsg_endpoint *ept,
   int ret;
 
   ret = unlink(msg->pathname);
+  if (ret == 0)
+    {
+      hostfs_rpmsg_invalidate(priv);
+    }
+
   msg->header.result = ret ? get_errno(ret) : 0;
   return rpmsg_send(ept, msg, sizeof(*msg));
 }
@@ -520,6 +577,11 @@ static int hostfs_rpmsg_mkdir_handler(FAR struct rpmsg_endpoint *ept,
   int ret;
 
   ret = mkdir(msg->pathname, msg->mode);
+  if (ret == 0)
+    {
+      hostfs_rpmsg_invalidate(priv);
+    }
+
   msg->header.result = ret ? get_errno(ret) : 0;
   return rpmsg_send(ept, msg, sizeof(*msg));
 }
@@ -532,6 +594,11 @@ static int hostfs_rpmsg_rmdir_handler(FAR struct rpmsg_endpoint *ept,
   int ret;
 
   ret = rmdir(msg->pathname);
+  if (ret == 0)
+    {
+      hostfs_rpmsg_invalidate(priv);
+    }
+
   msg->header.result = ret ? get_errno(ret) : 0;
   return rpmsg_send(ept, msg, sizeof(*msg));
 }
@@ -549,6 +616,11 @@ static int hostfs_rpmsg_rename_handler(FAR struct rpmsg_endpoint *ept,
   newpath = msg->pathname + oldlen;
 
   ret = rename(msg->pathname, newpath);
+  if (ret == 0)
+    {
+      hostfs_rpmsg_invalidate(priv);
+    }
+
   msg->header.result = ret ? get_errno(ret) : 0;
   return rpmsg_send(ept, msg, sizeof(*msg));
 }
@@ -593,7 +665,12 @@ static void hostfs_rpmsg_ns_bind(FAR struct rpmsg_device *rdev,
     {
       nxsem_destroy(&priv->sem);
       kmm_free(priv);
+      return;
     }
+
+  nxsem_wait_uninterruptible(&g_hostfs_rpmsg_servers_sem);
+  sq_addlast(&priv->node, &g_hostfs_rpmsg_servers);
+  nxsem_post(&g_hostfs_rpmsg_servers_sem);
 }
 
 static void hostfs_rpmsg_ns_unbind(FAR struct rpmsg_endpoint *ept)
@@ -601,6 +678,10 @@ static void hostfs_rpmsg_ns_unbind(FAR struct rpmsg_endpoint *ept)
   FAR struct hostfs_rpmsg_server_s *priv = ept->priv;
   int i;
 
+  nxsem_wait_uninterruptible(&g_hostfs_rpmsg_servers_sem);
+  sq_rem(&priv->node, &g_hostfs_rpmsg_servers);
+  nxsem_post(&g_hostfs_rpmsg_servers_sem);
+
   for (i = 0; i < CONFIG_NFILE_DESCRIPTORS; i++)
     {
       if (priv->files[i].f_inode)
@@ -119,8 +119,8 @@ int file_detach(int fd, FAR struct file *filep)
   /* If the file was properly opened, there should be an inode assigned */
 
   _files_semtake(list);
-  parent = &list->fl_files[fd];
-  if (parent->f_inode == NULL)
+  parent = files_fget(list, fd);
+  if (parent == NULL || parent->f_inode == NULL)
     {
       /* File is not open */
 
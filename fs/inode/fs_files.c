@@ -49,9 +49,18 @@
 #include <nuttx/fs/fs.h>
 #include <nuttx/kmalloc.h>
 #include <nuttx/semaphore.h>
+#include <nuttx/spinlock.h>
 
 #include "inode/inode.h"
 
+/****************************************************************************
+ * Pre-processor Definitions
+ ****************************************************************************/
+
+#ifndef SP_DMB
+#  define SP_DMB()
+#endif
+
 /****************************************************************************
  * Private Functions
  ****************************************************************************/
@@ -71,6 +80,50 @@ static void _files_semtake(FAR struct filelist *list)
 
 #define _files_semgive(list) nxsem_post(&list->fl_sem)
 
+/****************************************************************************
+ * Name: _files_extend
+ *
+ * Description:
+ *   Allocate the row of the file list that holds descriptor 'fd'
+ *
+ * Assumuptions:
+ *   Caller holds the list semaphore.
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_FS_FILELIST_DYNAMIC
+static int _files_extend(FAR struct filelist *list, int fd)
+{
+  FAR struct file *files;
+  int row;
+
+  if (fd < 0 || fd >= CONFIG_NFILE_DESCRIPTORS)
+    {
+      return -EBADF;
+    }
+
+  row = fd / CONFIG_FS_FILELIST_ROWSIZE;
+  if (list->fl_rows[row] == NULL)
+    {
+      files = (FAR struct file *)
+        kmm_zalloc(CONFIG_FS_FILELIST_ROWSIZE * sizeof(struct file));
+      if (files == NULL)
+        {
+          return -ENOMEM;
+        }
+
+      /* Publish the row only after it has been initialized.  Readers look
+       * rows up without the list semaphore.
+       */
+
+      SP_DMB();
+      list->fl_rows[row] = files;
+    }
+
+  return OK;
+}
+#endif
+
 /****************************************************************************
  * Name: _files_close
  *
@@ -156,6 +209,7 @@ void files_initlist(FAR struct filelist *list)
 
 void files_releaselist(FAR struct filelist *list)
 {
+  FAR struct file *filep;
   int i;
 
   DEBUGASSERT(list);
@@ -167,14 +221,53 @@ void files_releaselist(FAR struct filelist *list)
 
   for (i = 0; i < CONFIG_NFILE_DESCRIPTORS; i++)
     {
-      _files_close(&list->fl_files[i]);
+      filep = files_fget(list, i);
+      if (filep != NULL)
+        {
+          _files_close(filep);
+        }
     }
 
+#ifdef CONFIG_FS_FILELIST_DYNAMIC
+  /* Free the rows of the file list */
+
+  for (i = 0; i < FILELIST_NROWS; i++)
+    {
+      if (list->fl_rows[i] != NULL)
+        {
+          kmm_free(list->fl_rows[i]);
+          list->fl_rows[i] = NULL;
+        }
+    }
+#endif
+
   /* Destroy the semaphore */
 
   nxsem_destroy(&list->fl_sem);
 }
 
+/****************************************************************************
+ * Name: files_extend
+ *
+ * Description:
+ *   Make sure that the file list has a struct file for descriptor 'fd'.
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_FS_FILELIST_DYNAMIC
+int files_extend(FAR struct filelist *list, int fd)
+{
+  int ret;
+
+  DEBUGASSERT(list != NULL);
+
+  _files_semtake(list);
+  ret = _files_extend(list, fd);
+  _files_semgive(list);
+  return ret;
+}
+#endif
+
 /****************************************************************************
  * Name: file_dup2
  *
@@ -306,6 +399,7 @@ errout_with_sem:
 int files_allocate(FAR struct inode *inode, int oflags, off_t pos, int minfd)
 {
   FAR struct filelist *list;
+  FAR struct file *filep;
   int i;
 
   /* Get the file descriptor list.  It should not be NULL in this context. */
@@ -316,12 +410,27 @@ int files_allocate(FAR struct inode *inode, int oflags, off_t pos, int minfd)
   _files_semtake(list);
   for (i = minfd; i < CONFIG_NFILE_DESCRIPTORS; i++)
     {
-      if (!list->fl_files[i].f_inode)
+      filep = files_fget(list, i);
+#ifdef CONFIG_FS_FILELIST_DYNAMIC
+      if (filep == NULL)
         {
-          list->fl_files[i].f_oflags = oflags;
-          list->fl_files[i].f_pos    = pos;
-          list->fl_files[i].f_inode  = inode;
-          list->fl_files[i].f_priv   = NULL;
+          /* All descriptors of the allocated rows are in use */
+
+          if (_files_extend(list, i) < 0)
+            {
+              break;
+            }
+
+          filep = files_fget(list, i);
+        }
+#endif
+
+      if (!filep->f_inode)
+        {
+          filep->f_oflags = oflags;
+          filep->f_pos    = pos;
+          filep->f_inode  = inode;
+          filep->f_priv   = NULL;
           _files_semgive(list);
           return i;
         }
@@ -345,6 +454,7 @@ int files_allocate(FAR struct inode *inode, int oflags, off_t pos, int minfd)
 int files_close(int fd)
 {
   FAR struct filelist *list;
+  FAR struct file     *filep;
   int                  ret;
 
   /* Get the thread-specific file list.  It should never be NULL in this
@@ -356,7 +466,13 @@ int files_close(int fd)
 
   /* If the file was properly opened, there should be an inode assigned */
 
-  if (fd < 0 || fd >= CONFIG_NFILE_DESCRIPTORS || !list->fl_files[fd].f_inode)
+  if (fd < 0 || fd >= CONFIG_NFILE_DESCRIPTORS)
+    {
+      return -EBADF;
+    }
+
+  filep = files_fget(list, fd);
+  if (filep == NULL || !filep->f_inode)
     {
       return -EBADF;
     }
@@ -364,7 +480,7 @@ int files_close(int fd)
   /* Perform the protected close operation */
 
   _files_semtake(list);
-  ret = _files_close(&list->fl_files[fd]);
+  ret = _files_close(filep);
   _files_semgive(list);
   return ret;
 }
@@ -381,16 +497,18 @@ int files_close(int fd)
 void files_release(int fd)
 {
   FAR struct filelist *list;
+  FAR struct file *filep;
 
   list = sched_getfiles();
   DEBUGASSERT(list);
 
-  if (fd >= 0 && fd < CONFIG_NFILE_DESCRIPTORS)
+  if (fd >= 0 && fd < CONFIG_NFILE_DESCRIPTORS &&
+      (filep = files_fget(list, fd)) != NULL)
     {
       _files_semtake(list);
-      list->fl_files[fd].f_oflags  = 0;
-      list->fl_files[fd].f_pos     = 0;
-      list->fl_files[fd].f_inode = NULL;
+      filep->f_oflags  = 0;
+      filep->f_pos     = 0;
+      filep->f_inode = NULL;
       _files_semgive(list);
     }
 }
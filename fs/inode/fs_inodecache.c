@@ -0,0 +1,232 @@
+/****************************************************************************
+ * fs/inode/fs_inodecache.c
+ *
+ *   Copyright (C) 2020 Gregory Nutt. All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in
+ *    the documentation and/or other materials provided with the
+ *    distribution.
+ * 3. Neither the name NuttX nor the names of its contributors may be
+ *    used to endorse or promote products derived from this software
+ *    without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+ * FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE
+ * COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+ * INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,
+ * BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS
+ * OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED
+ * AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ * LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN
+ * ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ *
+ ****************************************************************************/
+
+/****************************************************************************
+ * Included Files
+ ****************************************************************************/
+
+#include <nuttx/config.h>
+
+#include <stdbool.h>
+#include <stdint.h>
+#include <string.h>
+
+#include <nuttx/fs/fs.h>
+
+#include "inode/inode.h"
+
+#ifdef CONFIG_FS_INODECACHE
+
+/****************************************************************************
+ * Pre-processor Definitions
+ ****************************************************************************/
+
+/* Offset value meaning that relpath is NULL */
+
+#define INODECACHE_NOREL  UINT16_MAX
+
+/****************************************************************************
+ * Private Types
+ ****************************************************************************/
+
+/* One cached result of inode_search().  The output path and relpath point
+ * into the searched path and are saved as offsets.
+ */
+
+struct inode_cache_s
+{
+  FAR struct inode *node;    /* The inode found, NULL if the entry is free */
+  FAR struct inode *peer;    /* Node to the "left" of the inode */
+  FAR struct inode *parent;  /* Node "above" the inode */
+  uint32_t hash;             /* Hash of the full path */
+  uint16_t pathoff;          /* Offset of the output path */
+  uint16_t reloff;           /* Offset of relpath or INODECACHE_NOREL */
+  char path[CONFIG_FS_INODECACHE_PATHLEN];
+};
+
+/****************************************************************************
+ * Private Data
+ ****************************************************************************/
+
+static struct inode_cache_s g_inode_cache[CONFIG_FS_INODECACHE_NENTRIES];
+
+/****************************************************************************
+ * Private Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: inode_cachehash
+ *
+ * Description:
+ *   Return the FNV-1a hash of a path and its length.  Zero is returned for
+ *   the length if the path is too long to be cached.
+ *
+ ****************************************************************************/
+
+static uint32_t inode_cachehash(FAR const char *path, FAR size_t *len)
+{
+  uint32_t hash = 2166136261u;
+  size_t i;
+
+  for (i = 0; path[i] != '\0'; i++)
+    {
+      if (i >= CONFIG_FS_INODECACHE_PATHLEN - 1)
+        {
+          *len = 0;
+          return 0;
+        }
+
+      hash = (hash ^ (uint8_t)path[i]) * 16777619u;
+    }
+
+  *len = i;
+  return hash;
+}
+
+/****************************************************************************
+ * Public Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: inode_cachelookup
+ *
+ * Description:
+ *   Look up desc->path in the cache and, on a hit, fill in the result of
+ *   the search as inode_search() would.
+ *
+ * Returned Value:
+ *   true if the path was found in the cache.
+ *
+ * Assumptions:
+ *   The caller holds the g_inode_sem semaphore
+ *
+ ****************************************************************************/
+
+bool inode_cachelookup(FAR struct inode_search_s *desc)
+{
+  FAR struct inode_cache_s *entry;
+  FAR const char *path = desc->path;
+  uint32_t hash;
+  size_t len;
+
+  hash = inode_cachehash(path, &len);
+  if (len == 0)
+    {
+      return false;
+    }
+
+  entry = &g_inode_cache[hash % CONFIG_FS_INODECACHE_NENTRIES];
+  if (entry->node == NULL || entry->hash != hash ||
+      strcmp(entry->path, path) != 0)
+    {
+      return false;
+    }
+
+  desc->path    = path + entry->pathoff;
+  desc->node    = entry->node;
+  desc->peer    = entry->peer;
+  desc->parent  = entry->parent;
+  desc->relpath = entry->reloff == INODECACHE_NOREL ?
+                  NULL : path + entry->reloff;
+  return true;
+}
+
+/****************************************************************************
+ * Name: inode_cacheadd
+ *
+ * Description:
+ *   Record the result of a successful search of 'path', replacing whatever
+ *   entry the path maps to.
+ *
+ * Assumptions:
+ *   The caller holds the g_inode_sem semaphore
+ *
+ ****************************************************************************/
+
+void inode_cacheadd(FAR const char *path,
+                    FAR const struct inode_search_s *desc)
+{
+  FAR struct inode_cache_s *entry;
+  uint32_t hash;
+  size_t len;
+
+  hash = inode_cachehash(path, &len);
+  if (len == 0)
+    {
+      return;
+    }
+
+  /* The output pointers must lie within the searched path */
+
+  if (desc->path < path || desc->path > path + len ||
+      (desc->relpath != NULL &&
+       (desc->relpath < path || desc->relpath > path + len)))
+    {
+      return;
+    }
+
+  entry          = &g_inode_cache[hash % CONFIG_FS_INODECACHE_NENTRIES];
+  entry->node    = desc->node;
+  entry->peer    = desc->peer;
+  entry->parent  = desc->parent;
+  entry->hash    = hash;
+  entry->pathoff = desc->path - path;
+  entry->reloff  = desc->relpath == NULL ?
+                   INODECACHE_NOREL : desc->relpath - path;
+  memcpy(entry->path, path, len + 1);
+}
+
+/****************************************************************************
+ * Name: inode_cacheflush
+ *
+ * Description:
+ *   Discard all cached lookups.  This is called whenever a node is added to
+ *   or removed from the inode tree.
+ *
+ * Assumptions:
+ *   The caller holds the g_inode_sem semaphore
+ *
+ ****************************************************************************/
+
+void inode_cacheflush(void)
+{
+  int i;
+
+  for (i = 0; i < CONFIG_FS_INODECACHE_NENTRIES; i++)
+    {
+      g_inode_cache[i].node = NULL;
+    }
+}
+
+#endif /* CONFIG_FS_INODECACHE */
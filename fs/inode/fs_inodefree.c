@@ -46,6 +46,7 @@
 #include <nuttx/fs/fs.h>
 
 #include "inode/inode.h"
+#include "shm/shm.h"
 
 /****************************************************************************
  * Public Functions
@@ -88,6 +89,15 @@ void inode_free(FAR struct inode *node)
         }
 #endif
 
+#ifdef CONFIG_FS_SHM
+      /* If the inode is a shared memory object, then free its memory */
+
+      if (INODE_IS_SHM(node))
+        {
+          shm_release(node);
+        }
+#endif
+
       kmm_free(node);
     }
 }
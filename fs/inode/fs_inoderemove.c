@@ -91,6 +91,10 @@ FAR struct inode *inode_unlink(FAR const char *path)
       node = desc.node;
       DEBUGASSERT(node != NULL);
 
+      /* The tree is changing.  Forget any cached path lookups. */
+
+      inode_cacheflush();
+
       /* If peer is non-null, then remove the node from the right of
        * of that peer node.
        */
@@ -108,6 +108,10 @@ static void inode_insert(FAR struct inode *node,
                          FAR struct inode *peer,
                          FAR struct inode *parent)
 {
+  /* The tree is changing.  Forget any cached path lookups. */
+
+  inode_cacheflush();
+
   /* If peer is non-null, then new node simply goes to the right
    * of that peer node.
    */
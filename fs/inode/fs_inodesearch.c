@@ -461,6 +461,9 @@ static int _inode_search(FAR struct inode_search_s *desc)
 
 int inode_search(FAR struct inode_search_s *desc)
 {
+#ifdef CONFIG_FS_INODECACHE
+  FAR const char *path;
+#endif
   int ret;
 
   /* Perform the common _inode_search() logic.  This does everything except
@@ -473,8 +476,34 @@ int inode_search(FAR struct inode_search_s *desc)
   desc->linktgt = NULL;
 #endif
 
+  /* Has this path been looked up recently? */
+
+  if (inode_cachelookup(desc))
+    {
+      return OK;
+    }
+
+#ifdef CONFIG_FS_INODECACHE
+  path = desc->path;
+#endif
+
   ret = _inode_search(desc);
 
+#ifdef CONFIG_FS_INODECACHE
+  /* Remember the result unless the search passed through a soft link.  A
+   * terminal soft link depends on 'nofollow' and is not cached either.
+   */
+
+  if (ret >= 0
+#ifdef CONFIG_PSEUDOFS_SOFTLINKS
+      && desc->linktgt == NULL && !INODE_IS_SOFTLINK(desc->node)
+#endif
+     )
+    {
+      inode_cacheadd(path, desc);
+    }
+#endif
+
 #ifdef CONFIG_PSEUDOFS_SOFTLINKS
   if (ret >= 0)
     {
@@ -226,6 +226,58 @@ void inode_semgive(void);
 
 int inode_search(FAR struct inode_search_s *desc);
 
+/****************************************************************************
+ * Name: inode_cachelookup, inode_cacheadd, and inode_cacheflush
+ *
+ * Description:
+ *   The path lookup cache remembers the result of recent successful
+ *   inode_search() calls by full path.  inode_cachelookup() fills in 'desc'
+ *   and returns true on a hit.  inode_cacheadd() records the result of a
+ *   search of 'path'.  inode_cacheflush() forgets all results; it must be
+ *   called whenever the inode tree is modified.
+ *
+ * Assumptions:
+ *   The caller holds the g_inode_sem semaphore
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_FS_INODECACHE
+bool inode_cachelookup(FAR struct inode_search_s *desc);
+void inode_cacheadd(FAR const char *path,
+                    FAR const struct inode_search_s *desc);
+void inode_cacheflush(void);
+#else
+#  define inode_cachelookup(d)  (false)
+#  define inode_cacheadd(p,d)
+#  define inode_cacheflush()
+#endif
+
+/****************************************************************************
+ * Name: dcache_lookup and dcache_add
+ *
+ * Description:
+ *   dcache_lookup() looks up a path in a mountpoint in the directory entry
+ *   cache.  On a hit, it returns true with *result set to OK and the cached
+ *   attributes in 'buf' (which may be NULL), or with *result set to -ENOENT
+ *   if the path is known not to exist.  On a miss, it returns false.
+ *
+ *   dcache_add() records the outcome of the lookup performed by the file
+ *   system after a miss:  The attributes of the path, or NULL if it does not
+ *   exist.  'gen' must be the generation returned by dcache_lookup(); the
+ *   result is discarded if anything was invalidated in the meantime.
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_FS_DCACHE
+bool dcache_lookup(FAR struct inode *mountpt, FAR const char *relpath,
+                   FAR struct stat *buf, FAR int *result, FAR uint32_t *gen);
+void dcache_add(FAR struct inode *mountpt, FAR const char *relpath,
+                FAR const struct stat *buf, uint32_t gen);
+#else
+#  define dcache_lookup(m,r,b,s,g)  (*(g) = 0, false)
+#  define dcache_add(m,r,b,g)       ((void)(g))
+#endif
+
 /****************************************************************************
  * Name: inode_find
  *
@@ -52,6 +52,7 @@
 
 #include <errno.h>
 #include <fcntl.h>
+#include <stdlib.h>
 #include <string.h>
 
 #include <nuttx/fs/dirent.h>
@@ -65,6 +66,25 @@
 #include "lfs.h"
 #include "lfs_util.h"
 
+/****************************************************************************
+ * Pre-processor Definitions
+ ****************************************************************************/
+
+/* Mount options (comma separated in the mount data string) */
+
+#define LITTLEFS_FORMAT_NONE  0  /* Mount only */
+#define LITTLEFS_FORMAT_FORCE 1  /* -o forceformat */
+#define LITTLEFS_FORMAT_AUTO  2  /* -o autoformat */
+
+/* A file may be read without holding the mountpoint semaphore if it has no
+ * pending writes.  In that state lfs_file_read() only touches the file's
+ * own cache and the block device.
+ */
+
+#define LITTLEFS_CANREAD_UNLOCKED(f) \
+  (((f)->flags & (LFS_F_DIRTY | LFS_F_WRITING)) == 0 && \
+   ((f)->flags & 3) != LFS_O_WRONLY)
+
 /****************************************************************************
  * Private Types
  ****************************************************************************/
@@ -76,13 +96,25 @@
 
 struct littlefs_mountpt_s
 {
-  sem_t                 sem;
+  sem_t                 sem;    /* Protects the littlefs state */
+  sem_t                 devsem; /* Serializes access to the driver */
   FAR struct inode     *drv;
   struct mtd_geometry_s geo;
   struct lfs_config_s   cfg;
   lfs_t                 lfs;
 };
 
+/* This structure represents one open file.  The per-file semaphore
+ * serializes users of the same struct file and is always taken before the
+ * mountpoint semaphore.
+ */
+
+struct littlefs_file_s
+{
+  struct lfs_file_s     file;
+  sem_t                 sem;
+};
+
 /****************************************************************************
  * Private Function Prototypes
  ****************************************************************************/
@@ -249,7 +281,7 @@ static int littlefs_open(FAR struct file *filep, FAR const char *relpath,
                          int oflags, mode_t mode)
 {
   FAR struct littlefs_mountpt_s *fs;
-  FAR struct lfs_file_s *priv;
+  FAR struct littlefs_file_s *priv;
   FAR struct inode *inode;
   int ret;
 
@@ -268,6 +300,8 @@ static int littlefs_open(FAR struct file *filep, FAR const char *relpath,
       return -ENOMEM;
     }
 
+  nxsem_init(&priv->sem, 0, 1);
+
   /* Take the semaphore */
 
   littlefs_semtake(fs);
@@ -275,7 +309,7 @@ static int littlefs_open(FAR struct file *filep, FAR const char *relpath,
   /* Try to open the file */
 
   oflags = littlefs_convert_oflags(oflags);
-  ret = lfs_file_open(&fs->lfs, priv, relpath, oflags);
+  ret = lfs_file_open(&fs->lfs, &priv->file, relpath, oflags);
   if (ret < 0)
     {
       /* Error opening file */
@@ -289,7 +323,7 @@ static int littlefs_open(FAR struct file *filep, FAR const char *relpath,
 
   if (oflags & LFS_O_APPEND)
     {
-      ret = lfs_file_seek(&fs->lfs, priv, 0, LFS_SEEK_END);
+      ret = lfs_file_seek(&fs->lfs, &priv->file, 0, LFS_SEEK_END);
       if (ret >= 0)
         {
           filep->f_pos = ret;
@@ -308,9 +342,10 @@ static int littlefs_open(FAR struct file *filep, FAR const char *relpath,
   return OK;
 
 errout_with_file:
-  lfs_file_close(&fs->lfs, priv);
+  lfs_file_close(&fs->lfs, &priv->file);
 errout:
   littlefs_semgive(fs);
+  nxsem_destroy(&priv->sem);
   kmm_free(priv);
   return ret;
 }
@@ -322,7 +357,7 @@ errout:
 static int littlefs_close(FAR struct file *filep)
 {
   FAR struct littlefs_mountpt_s *fs;
-  FAR struct lfs_file_s *priv;
+  FAR struct littlefs_file_s *priv;
   FAR struct inode *inode;
 
   /* Recover our private data from the struct file instance */
@@ -334,11 +369,12 @@ static int littlefs_close(FAR struct file *filep)
   /* Close the file */
 
   littlefs_semtake(fs);
-  lfs_file_close(&fs->lfs, priv);
+  lfs_file_close(&fs->lfs, &priv->file);
   littlefs_semgive(fs);
 
   /* Now free the pointer */
 
+  nxsem_destroy(&priv->sem);
   kmm_free(priv);
   return OK;
 }
@@ -351,7 +387,7 @@ static ssize_t littlefs_read(FAR struct file *filep, FAR char *buffer,
                              size_t buflen)
 {
   FAR struct littlefs_mountpt_s *fs;
-  FAR struct lfs_file_s *priv;
+  FAR struct littlefs_file_s *priv;
   FAR struct inode *inode;
   ssize_t ret;
 
@@ -361,16 +397,31 @@ static ssize_t littlefs_read(FAR struct file *filep, FAR char *buffer,
   inode = filep->f_inode;
   fs    = inode->i_private;
 
-  /* Call LFS to perform the read */
+  /* Call LFS to perform the read.  Reads of files with no pending writes
+   * only need the per-file lock, so readers of different files do not
+   * serialize on the mountpoint.
+   */
 
+  nxsem_wait_uninterruptible(&priv->sem);
   littlefs_semtake(fs);
-  ret = lfs_file_read(&fs->lfs, priv, buffer, buflen);
+
+  if (LITTLEFS_CANREAD_UNLOCKED(&priv->file))
+    {
+      littlefs_semgive(fs);
+      ret = lfs_file_read(&fs->lfs, &priv->file, buffer, buflen);
+    }
+  else
+    {
+      ret = lfs_file_read(&fs->lfs, &priv->file, buffer, buflen);
+      littlefs_semgive(fs);
+    }
+
   if (ret > 0)
     {
       filep->f_pos += ret;
     }
 
-  littlefs_semgive(fs);
+  nxsem_post(&priv->sem);
 
   return ret;
 }
@@ -383,7 +434,7 @@ static ssize_t littlefs_write(FAR struct file *filep, const char *buffer,
                               size_t buflen)
 {
   FAR struct littlefs_mountpt_s *fs;
-  FAR struct lfs_file_s *priv;
+  FAR struct littlefs_file_s *priv;
   FAR struct inode *inode;
   ssize_t ret;
 
@@ -395,14 +446,16 @@ static ssize_t littlefs_write(FAR struct file *filep, const char *buffer,
 
   /* Call LFS to perform the write */
 
+  nxsem_wait_uninterruptible(&priv->sem);
   littlefs_semtake(fs);
-  ret = lfs_file_write(&fs->lfs, priv, buffer, buflen);
+  ret = lfs_file_write(&fs->lfs, &priv->file, buffer, buflen);
   if (ret > 0)
     {
       filep->f_pos += ret;
     }
 
   littlefs_semgive(fs);
+  nxsem_post(&priv->sem);
 
   return ret;
 }
@@ -414,7 +467,7 @@ static ssize_t littlefs_write(FAR struct file *filep, const char *buffer,
 static off_t littlefs_seek(FAR struct file *filep, off_t offset, int whence)
 {
   FAR struct littlefs_mountpt_s *fs;
-  FAR struct lfs_file_s *priv;
+  FAR struct littlefs_file_s *priv;
   FAR struct inode *inode;
   off_t ret;
 
@@ -426,14 +479,16 @@ static off_t littlefs_seek(FAR struct file *filep, off_t offset, int whence)
 
   /* Call LFS to perform the seek */
 
+  nxsem_wait_uninterruptible(&priv->sem);
   littlefs_semtake(fs);
-  ret = lfs_file_seek(&fs->lfs, priv, offset, whence);
+  ret = lfs_file_seek(&fs->lfs, &priv->file, offset, whence);
   if (ret >= 0)
     {
       filep->f_pos = ret;
     }
 
   littlefs_semgive(fs);
+  nxsem_post(&priv->sem);
 
   return ret;
 }
@@ -475,7 +530,7 @@ static int littlefs_ioctl(FAR struct file *filep, int cmd, unsigned long arg)
 static int littlefs_sync(FAR struct file *filep)
 {
   FAR struct littlefs_mountpt_s *fs;
-  FAR struct lfs_file_s *priv;
+  FAR struct littlefs_file_s *priv;
   FAR struct inode *inode;
   int ret;
 
@@ -485,9 +540,11 @@ static int littlefs_sync(FAR struct file *filep)
   inode = filep->f_inode;
   fs    = inode->i_private;
 
+  nxsem_wait_uninterruptible(&priv->sem);
   littlefs_semtake(fs);
-  ret = lfs_file_sync(&fs->lfs, priv);
+  ret = lfs_file_sync(&fs->lfs, &priv->file);
   littlefs_semgive(fs);
+  nxsem_post(&priv->sem);
 
   return ret;
 }
@@ -516,7 +573,7 @@ static int littlefs_dup(FAR const struct file *oldp, FAR struct file *newp)
 static int littlefs_fstat(FAR const struct file *filep, FAR struct stat *buf)
 {
   FAR struct littlefs_mountpt_s *fs;
-  FAR struct lfs_file_s *priv;
+  FAR struct littlefs_file_s *priv;
   FAR struct inode *inode;
 
   memset(buf, 0, sizeof(*buf));
@@ -529,9 +586,11 @@ static int littlefs_fstat(FAR const struct file *filep, FAR struct stat *buf)
 
   /* Call LFS to get file size */
 
+  nxsem_wait_uninterruptible(&priv->sem);
   littlefs_semtake(fs);
-  buf->st_size = lfs_file_size(&fs->lfs, priv);
+  buf->st_size = lfs_file_size(&fs->lfs, &priv->file);
   littlefs_semgive(fs);
+  nxsem_post(&priv->sem);
 
   if (buf->st_size < 0)
     {
@@ -557,7 +616,7 @@ static int littlefs_fstat(FAR const struct file *filep, FAR struct stat *buf)
 static int littlefs_truncate(FAR struct file *filep, off_t length)
 {
   FAR struct littlefs_mountpt_s *fs;
-  FAR struct lfs_file_s *priv;
+  FAR struct littlefs_file_s *priv;
   FAR struct inode *inode;
   int ret;
 
@@ -569,9 +628,11 @@ static int littlefs_truncate(FAR struct file *filep, off_t length)
 
   /* Call LFS to perform the truncate */
 
+  nxsem_wait_uninterruptible(&priv->sem);
   littlefs_semtake(fs);
-  ret = lfs_file_truncate(&fs->lfs, priv, length);
+  ret = lfs_file_truncate(&fs->lfs, &priv->file, length);
   littlefs_semgive(fs);
+  nxsem_post(&priv->sem);
 
   return ret;
 }
@@ -756,18 +817,34 @@ static int littlefs_read_block(FAR const struct lfs_config_s *c,
   FAR struct inode *drv = fs->drv;
   int ret;
 
-  block = (block * c->block_size + off) / geo->blocksize;
-  size  = size / geo->blocksize;
+  nxsem_wait_uninterruptible(&fs->devsem);
 
-  if (INODE_IS_MTD(drv))
+  if (INODE_IS_MTD(drv) && drv->u.i_mtd->read != NULL)
     {
-      ret = MTD_BREAD(drv->u.i_mtd, block, size, buffer);
+      /* Read the whole extent in one transfer straight into the caller's
+       * buffer rather than one MTD block at a time.
+       */
+
+      ret = MTD_READ(drv->u.i_mtd, (off_t)block * c->block_size + off,
+                     size, buffer);
     }
   else
     {
-      ret = drv->u.i_bops->read(drv, buffer, block, size);
+      block = (block * c->block_size + off) / geo->blocksize;
+      size  = size / geo->blocksize;
+
+      if (INODE_IS_MTD(drv))
+        {
+          ret = MTD_BREAD(drv->u.i_mtd, block, size, buffer);
+        }
+      else
+        {
+          ret = drv->u.i_bops->read(drv, buffer, block, size);
+        }
     }
 
+  nxsem_post(&fs->devsem);
+
   return ret >= 0 ? OK : ret;
 }
 
@@ -787,6 +864,8 @@ static int littlefs_write_block(FAR const struct lfs_config_s *c,
   block = (block * c->block_size + off) / geo->blocksize;
   size  = size / geo->blocksize;
 
+  nxsem_wait_uninterruptible(&fs->devsem);
+
   if (INODE_IS_MTD(drv))
     {
       ret = MTD_BWRITE(drv->u.i_mtd, block, size, buffer);
@@ -796,6 +875,8 @@ static int littlefs_write_block(FAR const struct lfs_config_s *c,
       ret = drv->u.i_bops->write(drv, buffer, block, size);
     }
 
+  nxsem_post(&fs->devsem);
+
   return ret >= 0 ? OK : ret;
 }
 
@@ -816,7 +897,10 @@ static int littlefs_erase_block(FAR const struct lfs_config_s *c,
       size_t size = c->block_size / geo->erasesize;
 
       block = block * c->block_size / geo->erasesize;
+
+      nxsem_wait_uninterruptible(&fs->devsem);
       ret = MTD_ERASE(drv->u.i_mtd, block, size);
+      nxsem_post(&fs->devsem);
     }
 
   return ret >= 0 ? OK : ret;
@@ -832,6 +916,8 @@ static int littlefs_sync_block(FAR const struct lfs_config_s *c)
   FAR struct inode *drv = fs->drv;
   int ret;
 
+  nxsem_wait_uninterruptible(&fs->devsem);
+
   if (INODE_IS_MTD(drv))
     {
       ret = MTD_IOCTL(drv->u.i_mtd, BIOC_FLUSH, 0);
@@ -841,9 +927,128 @@ static int littlefs_sync_block(FAR const struct lfs_config_s *c)
       ret = drv->u.i_bops->ioctl(drv, BIOC_FLUSH, 0);
     }
 
+  nxsem_post(&fs->devsem);
+
   return ret == -ENOTTY ? OK : ret;
 }
 
+/****************************************************************************
+ * Name: littlefs_getopt
+ *
+ * Description: Match one "name=value" mount option.  Returns 1 if the
+ *   option matched, 0 if it did not, or -EINVAL if the value is malformed.
+ *
+ ****************************************************************************/
+
+static int littlefs_getopt(FAR const char *opt, size_t len,
+                           FAR const char *name, FAR lfs_size_t *value)
+{
+  size_t namelen = strlen(name);
+  FAR char *end;
+
+  if (len <= namelen + 1 || strncmp(opt, name, namelen) != 0 ||
+      opt[namelen] != '=')
+    {
+      return 0;
+    }
+
+  *value = strtoul(&opt[namelen + 1], &end, 0);
+  return end == opt + len ? 1 : -EINVAL;
+}
+
+/****************************************************************************
+ * Name: littlefs_parseopts
+ *
+ * Description: Parse the comma separated mount options:
+ *
+ *   forceformat    Format the device before mounting
+ *   autoformat     Format the device if it does not hold a valid filesystem
+ *   read_size=N    Size of the read cache
+ *   prog_size=N    Size of the program cache (and of each file's cache)
+ *   cache=N        Sets both read_size and prog_size
+ *   lookahead=N    Number of blocks tracked by the block allocator
+ *
+ *   Values are in bytes (blocks for lookahead) and override the defaults
+ *   derived from the device geometry.
+ *
+ ****************************************************************************/
+
+static int littlefs_parseopts(FAR struct littlefs_mountpt_s *fs,
+                              FAR const char *data, FAR int *format)
+{
+  FAR struct lfs_config_s *cfg = &fs->cfg;
+  FAR const char *opt = data;
+  lfs_size_t value;
+  size_t len;
+  int ret;
+
+  *format = LITTLEFS_FORMAT_NONE;
+
+  while (opt != NULL && *opt != '\0')
+    {
+      len = strcspn(opt, ",");
+
+      if (len == 11 && strncmp(opt, "forceformat", len) == 0)
+        {
+          *format = LITTLEFS_FORMAT_FORCE;
+        }
+      else if (len == 10 && strncmp(opt, "autoformat", len) == 0)
+        {
+          *format = LITTLEFS_FORMAT_AUTO;
+        }
+      else if ((ret = littlefs_getopt(opt, len, "cache", &value)) != 0)
+        {
+          cfg->read_size = value;
+          cfg->prog_size = value;
+        }
+      else if ((ret = littlefs_getopt(opt, len, "read_size", &value)) != 0)
+        {
+          cfg->read_size = value;
+        }
+      else if ((ret = littlefs_getopt(opt, len, "prog_size", &value)) != 0)
+        {
+          cfg->prog_size = value;
+        }
+      else if ((ret = littlefs_getopt(opt, len, "lookahead", &value)) != 0)
+        {
+          cfg->lookahead = value;
+        }
+      else
+        {
+          ret = -EINVAL;
+        }
+
+      if (ret < 0)
+        {
+          ferr("ERROR: Bad littlefs mount option: %.*s\n", (int)len, opt);
+          return ret;
+        }
+
+      opt += len;
+      if (*opt == ',')
+        {
+          opt++;
+        }
+    }
+
+  /* The caches must be whole device blocks, the program cache a multiple
+   * of the read cache and an erase block a multiple of the program cache.
+   */
+
+  if (cfg->read_size == 0 || cfg->read_size % fs->geo.blocksize != 0 ||
+      cfg->prog_size == 0 || cfg->prog_size % cfg->read_size != 0 ||
+      cfg->block_size % cfg->prog_size != 0 ||
+      cfg->lookahead == 0 || cfg->lookahead % 32 != 0)
+    {
+      ferr("ERROR: Bad littlefs geometry: read %u prog %u lookahead %u\n",
+           (unsigned)cfg->read_size, (unsigned)cfg->prog_size,
+           (unsigned)cfg->lookahead);
+      return -EINVAL;
+    }
+
+  return OK;
+}
+
 /****************************************************************************
  * Name: littlefs_bind
  ****************************************************************************/
@@ -852,6 +1057,7 @@ static int littlefs_bind(FAR struct inode *driver, FAR const void *data,
                          FAR void **handle)
 {
   FAR struct littlefs_mountpt_s *fs;
+  int format;
   int ret;
 
   /* Open the block driver */
@@ -881,6 +1087,7 @@ static int littlefs_bind(FAR struct inode *driver, FAR const void *data,
 
   fs->drv = driver; /* Save the driver reference */
   nxsem_init(&fs->sem, 0, 0); /* Initialize the access control semaphore */
+  nxsem_init(&fs->devsem, 0, 1);
 
   if (INODE_IS_MTD(driver))
     {
@@ -936,13 +1143,21 @@ static int littlefs_bind(FAR struct inode *driver, FAR const void *data,
       fs->cfg.lookahead = 32 * fs->cfg.read_size;
     }
 
+  /* Apply any tuning given in the mount options */
+
+  ret = littlefs_parseopts(fs, data, &format);
+  if (ret < 0)
+    {
+      goto errout_with_fs;
+    }
+
   /* Then get information about the littlefs filesystem on the devices
    * managed by this driver.
    */
 
   /* Force format the device if -o forceformat */
 
-  if (data && strcmp(data, "forceformat") == 0)
+  if (format == LITTLEFS_FORMAT_FORCE)
     {
       ret = lfs_format(&fs->lfs, &fs->cfg);
       if (ret < 0)
@@ -956,8 +1171,7 @@ static int littlefs_bind(FAR struct inode *driver, FAR const void *data,
     {
       /* Auto format the device if -o autoformat */
 
-      if (ret != LFS_ERR_CORRUPT ||
-          !data || strcmp(data, "autoformat"))
+      if (ret != LFS_ERR_CORRUPT || format != LITTLEFS_FORMAT_AUTO)
         {
           goto errout_with_fs;
         }
@@ -982,6 +1196,7 @@ static int littlefs_bind(FAR struct inode *driver, FAR const void *data,
   return OK;
 
 errout_with_fs:
+  nxsem_destroy(&fs->devsem);
   nxsem_destroy(&fs->sem);
   kmm_free(fs);
 errout_with_block:
@@ -1036,6 +1251,7 @@ static int littlefs_unbind(FAR void *handle, FAR struct inode **driver,
 
       /* Release the mountpoint private data */
 
+      nxsem_destroy(&fs->devsem);
       nxsem_destroy(&fs->sem);
       kmm_free(fs);
     }
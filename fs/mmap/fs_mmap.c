@@ -60,7 +60,7 @@
  *
  * Description:
  *   NuttX operates in a flat open address space.  Therefore, it generally
- *   does not require mmap() functionality.  There are two exceptions:
+ *   does not require mmap() functionality.  There are three exceptions:
  *
  *   1. mmap() is the API that is used to support direct access to random
  *     access media under the following very restrictive conditions:
@@ -78,6 +78,10 @@
  *      support simulation of memory mapped files by copying files whole
  *      into RAM.
  *
+ *   3. If CONFIG_FS_SHM is defined in the configuration, then mmap() of a
+ *      shared memory object opened with shm_open() returns the memory of
+ *      the object.  All tasks share that memory; nothing is copied.
+ *
  * Input Parameters:
  *   start   A hint at where to map the memory -- ignored.  The address
  *           of the underlying media is fixed and cannot be re-mapped without
@@ -208,7 +212,8 @@ FAR void *mmap(FAR void *start, size_t length, int prot, int flags,
        * do much better in the KERNEL build using the MMU.
        */
 
-      return rammap(fd, length, offset);
+      return rammap(fd, length, offset,
+                    (prot & PROT_WRITE) != 0 && (flags & MAP_SHARED) != 0);
 #else
       /* Error out.  The errno value was already set by ioctl() */
 
@@ -0,0 +1,166 @@
+/****************************************************************************
+ * fs/mmap/fs_msync.c
+ *
+ *   Copyright (C) 2020 Gregory Nutt. All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in
+ *    the documentation and/or other materials provided with the
+ *    distribution.
+ * 3. Neither the name NuttX nor the names of its contributors may be
+ *    used to endorse or promote products derived from this software
+ *    without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+ * FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE
+ * COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+ * INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,
+ * BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS
+ * OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED
+ * AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ * LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN
+ * ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ *
+ ****************************************************************************/
+
+/****************************************************************************
+ * Included Files
+ ****************************************************************************/
+
+#include <nuttx/config.h>
+
+#include <sys/types.h>
+#include <sys/mman.h>
+
+#include <stdint.h>
+#include <errno.h>
+#include <debug.h>
+
+#include <nuttx/cancelpt.h>
+
+#include "inode/inode.h"
+#include "fs_rammap.h"
+
+#ifdef CONFIG_FS_RAMMAP
+
+/****************************************************************************
+ * Public Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: msync
+ *
+ * Description:
+ *   Write the modified part of a shared, writable mapping back to the
+ *   file.  The memory image of the mapping is written as is: without an
+ *   MMU there is no way to know which parts were modified.
+ *
+ *   Only mappings that were copied into RAM (see CONFIG_FS_RAMMAP) and
+ *   that were created with PROT_WRITE and MAP_SHARED while
+ *   CONFIG_FS_RAMMAP_WRITEBACK is selected are written back.  Other
+ *   mappings are read-only images or are on the media itself (XIP), so
+ *   there is nothing to do for them.
+ *
+ *   The write back is always performed before msync() returns, even if
+ *   MS_ASYNC is specified.  MS_INVALIDATE has no effect:  Each mapping has
+ *   its own memory copy of the file.
+ *
+ * Input Parameters:
+ *   addr  The start of the range to synchronize
+ *   len   The length of the range
+ *   flags MS_ASYNC or MS_SYNC, optionally with MS_INVALIDATE
+ *
+ * Returned Value:
+ *   On success, msync() returns 0, on failure -1, and errno is set
+ *   appropriately:
+ *
+ *     EINVAL
+ *       Both MS_ASYNC and MS_SYNC are specified, or an unknown flag.
+ *
+ *   Or any error reported by the file system when writing.
+ *
+ ****************************************************************************/
+
+int msync(FAR void *addr, size_t len, int flags)
+{
+  FAR struct fs_rammap_s *curr;
+  uintptr_t start = (uintptr_t)addr;
+  uintptr_t end;
+  int errcode;
+  int ret;
+
+  if ((flags & ~(MS_ASYNC | MS_SYNC | MS_INVALIDATE)) != 0 ||
+      (flags & (MS_ASYNC | MS_SYNC)) == (MS_ASYNC | MS_SYNC))
+    {
+      errcode = EINVAL;
+      goto errout;
+    }
+
+  /* msync() is a cancellation point */
+
+  enter_cancellation_point();
+
+  rammap_initialize();
+  ret = nxsem_wait(&g_rammaps.exclsem);
+  if (ret < 0)
+    {
+      errcode = -ret;
+      goto errout_with_cancelpt;
+    }
+
+  /* Write back the part of each region that lies within the range */
+
+  for (curr = g_rammaps.head; curr; curr = curr->flink)
+    {
+      uintptr_t rstart = (uintptr_t)curr->addr;
+      uintptr_t rend   = rstart + curr->length;
+
+      end = start + len;
+      if (start < rend && end > rstart)
+        {
+          if (start < rstart)
+            {
+              start = rstart;
+            }
+
+          if (end > rend)
+            {
+              end = rend;
+            }
+
+          ret = rammap_writeback(curr, (FAR void *)start, end - start);
+          if (ret < 0)
+            {
+              errcode = -ret;
+              goto errout_with_semaphore;
+            }
+
+          start = (uintptr_t)addr;
+        }
+    }
+
+  nxsem_post(&g_rammaps.exclsem);
+  leave_cancellation_point();
+  return OK;
+
+errout_with_semaphore:
+  nxsem_post(&g_rammaps.exclsem);
+
+errout_with_cancelpt:
+  leave_cancellation_point();
+
+errout:
+  set_errno(errcode);
+  return ERROR;
+}
+
+#endif /* CONFIG_FS_RAMMAP */
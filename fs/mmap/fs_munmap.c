@@ -123,7 +123,7 @@ int munmap(FAR void *start, size_t length)
   ret = nxsem_wait(&g_rammaps.exclsem);
   if (ret < 0)
     {
-      errcode = ret;
+      errcode = -ret;
       goto errout;
     }
 
@@ -144,6 +144,15 @@ int munmap(FAR void *start, size_t length)
 
   if (!curr)
     {
+#ifdef CONFIG_FS_SHM
+      /* Mappings of shared memory objects refer to the memory of the
+       * object itself and are not tracked.  There is nothing to unmap.
+       */
+
+      nxsem_post(&g_rammaps.exclsem);
+      return OK;
+#endif
+
       ferr("ERROR: Region not found\n");
       errcode = EINVAL;
       goto errout_with_semaphore;
@@ -170,6 +179,15 @@ int munmap(FAR void *start, size_t length)
 
   length = curr->length - offset;
 
+  /* Write back the part of a shared, writable mapping that is going away */
+
+  ret = rammap_writeback(curr, start, length);
+  if (ret < 0)
+    {
+      errcode = -ret;
+      goto errout_with_semaphore;
+    }
+
   /* Are we unmapping the entire region (offset == 0)? */
 
   if (length >= curr->length)
@@ -185,6 +203,15 @@ int munmap(FAR void *start, size_t length)
           g_rammaps.head = curr->flink;
         }
 
+#ifdef CONFIG_FS_RAMMAP_WRITEBACK
+      /* Release the reference to the file */
+
+      if (curr->writeback)
+        {
+          file_close(&curr->file);
+        }
+#endif
+
       /* Then free the region */
 
       kumm_free(curr);
@@ -196,9 +223,21 @@ int munmap(FAR void *start, size_t length)
 
   else
     {
-      newaddr = kumm_realloc(curr->addr, sizeof(struct fs_rammap_s) + length);
-      DEBUGASSERT(newaddr == (FAR void *)(curr->addr));
-      curr->length = length;
+      /* Keep the first 'offset' bytes.  The region was allocated together
+       * with its descriptor, so it is the descriptor that is reallocated.
+       */
+
+      newaddr = kumm_realloc(curr, sizeof(struct fs_rammap_s) + offset);
+      DEBUGASSERT(newaddr == (FAR void *)curr);
+      UNUSED(newaddr);
+
+      curr->length = offset;
+#ifdef CONFIG_FS_RAMMAP_WRITEBACK
+      if (curr->filelen > offset)
+        {
+          curr->filelen = offset;
+        }
+#endif
     }
 
   nxsem_post(&g_rammaps.exclsem);
@@ -44,6 +44,7 @@
 
 #include <string.h>
 #include <unistd.h>
+#include <fcntl.h>
 #include <errno.h>
 #include <debug.h>
 
@@ -115,7 +116,7 @@ void rammap_initialize(void)
  *
  ****************************************************************************/
 
-FAR void *rammap(int fd, size_t length, off_t offset)
+FAR void *rammap(int fd, size_t length, off_t offset, bool shared)
 {
   FAR struct fs_rammap_s *map;
   FAR uint8_t *alloc;
@@ -156,6 +157,39 @@ FAR void *rammap(int fd, size_t length, off_t offset)
   map->length = length;
   map->offset = offset;
 
+#ifdef CONFIG_FS_RAMMAP_WRITEBACK
+  /* A shared, writable mapping keeps its own reference to the file so that
+   * the memory image can be written back after the descriptor is closed.
+   */
+
+  if (shared)
+    {
+      FAR struct file *filep;
+
+      ret = fs_getfilep(fd, &filep);
+      if (ret < 0)
+        {
+          errcode = -ret;
+          goto errout_with_region;
+        }
+
+      if ((filep->f_oflags & O_WROK) == 0)
+        {
+          errcode = EACCES;
+          goto errout_with_region;
+        }
+
+      ret = file_dup2(filep, &map->file);
+      if (ret < 0)
+        {
+          errcode = -ret;
+          goto errout_with_region;
+        }
+
+      map->writeback = true;
+    }
+#endif
+
   /* Seek to the specified file offset */
 
   fpos = lseek(fd, offset,  SEEK_SET);
@@ -167,7 +201,7 @@ FAR void *rammap(int fd, size_t length, off_t offset)
 
       ferr("ERROR: Seek to position %d failed\n", (int)offset);
       errcode = EINVAL;
-      goto errout_with_region;
+      goto errout_with_file;
     }
 
   /* Read the file data into the memory region */
@@ -190,7 +224,7 @@ FAR void *rammap(int fd, size_t length, off_t offset)
                    (int)offset, (int)nread);
 
               errcode = (int)-nread;
-              goto errout_with_region;
+              goto errout_with_file;
             }
         }
 
@@ -207,8 +241,13 @@ FAR void *rammap(int fd, size_t length, off_t offset)
       length   -= nread;
     }
 
-  /* Zero any memory beyond the amount read from the file */
+  /* Zero any memory beyond the amount read from the file.  That part is
+   * not written back.
+   */
 
+#ifdef CONFIG_FS_RAMMAP_WRITEBACK
+  map->filelen = map->length - length;
+#endif
   memset(rdbuffer, 0, length);
 
   /* Add the buffer to the list of regions */
@@ -218,7 +257,7 @@ FAR void *rammap(int fd, size_t length, off_t offset)
   if (ret < 0)
     {
       errcode = -ret;
-      goto errout_with_region;
+      goto errout_with_file;
     }
 
   map->flink  = g_rammaps.head;
@@ -227,6 +266,14 @@ FAR void *rammap(int fd, size_t length, off_t offset)
   nxsem_post(&g_rammaps.exclsem);
   return map->addr;
 
+errout_with_file:
+#ifdef CONFIG_FS_RAMMAP_WRITEBACK
+  if (map->writeback)
+    {
+      file_close(&map->file);
+    }
+#endif
+
 errout_with_region:
   kumm_free(alloc);
 
@@ -235,4 +282,81 @@ errout:
   return MAP_FAILED;
 }
 
+/****************************************************************************
+ * Name: rammap_writeback
+ *
+ * Description:
+ *   Write part of the memory copy of a shared, writable mapping back to
+ *   the file.  Nothing is done for other mappings.
+ *
+ * Input Parameters:
+ *   map     The mapping
+ *   addr    The start of the part of the mapping to write back
+ *   length  The length of the part to write back
+ *
+ * Returned Value:
+ *   Zero (OK) on success; a negated errno value on failure.
+ *
+ * Assumptions:
+ *   The caller holds g_rammaps.exclsem.
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_FS_RAMMAP_WRITEBACK
+int rammap_writeback(FAR struct fs_rammap_s *map, FAR void *addr,
+                     size_t length)
+{
+  FAR const uint8_t *wrbuffer = (FAR const uint8_t *)addr;
+  ssize_t nwritten;
+  size_t start;
+
+  if (!map->writeback)
+    {
+      return OK;
+    }
+
+  /* Only the part of the region that was read from the file is written
+   * back.  The file is not extended.
+   */
+
+  start = wrbuffer - (FAR const uint8_t *)map->addr;
+  if (start >= map->filelen)
+    {
+      return OK;
+    }
+
+  if (length > map->filelen - start)
+    {
+      length = map->filelen - start;
+    }
+
+  while (length > 0)
+    {
+      nwritten = file_pwrite(&map->file, wrbuffer, length,
+                             map->offset + start);
+      if (nwritten < 0)
+        {
+          if (nwritten == -EINTR)
+            {
+              continue;
+            }
+
+          ferr("ERROR: Write back failed: offset=%d errno=%d\n",
+               (int)(map->offset + start), (int)nwritten);
+          return (int)nwritten;
+        }
+      else if (nwritten == 0)
+        {
+          return -EIO;
+        }
+
+      wrbuffer += nwritten;
+      start    += nwritten;
+      length   -= nwritten;
+    }
+
+  return OK;
+}
+#endif
+
 #endif /* CONFIG_FS_RAMMAP */
@@ -45,6 +45,9 @@
 #include <nuttx/config.h>
 
 #include <sys/types.h>
+#include <stdbool.h>
+
+#include <nuttx/fs/fs.h>
 #include <nuttx/semaphore.h>
 
 #ifdef CONFIG_FS_RAMMAP
@@ -65,8 +68,9 @@
  * - All of the file must be present in memory.  This limits the size of
  *   files that may be memory mapped (especially on MCUs with no significant
  *   RAM resources).
- * - All mapped files are read-only.  You can write to the in-memory image,
- *   but the file contents will not change.
+ * - All mapped files are read-only unless CONFIG_FS_RAMMAP_WRITEBACK is
+ *   selected.  You can write to the in-memory image, but the file contents
+ *   will not change until msync() or munmap() writes the image back.
  * - There are not access privileges.
  */
 
@@ -76,6 +80,11 @@ struct fs_rammap_s
   FAR void           *addr;        /* Start of allocated memory */
   size_t              length;      /* Length of region */
   off_t               offset;      /* File offset */
+#ifdef CONFIG_FS_RAMMAP_WRITEBACK
+  bool                writeback;   /* True: Changes are written to 'file' */
+  size_t              filelen;     /* Length of region backed by the file */
+  struct file         file;        /* Reference to the mapped file */
+#endif
 };
 
 /* This structure defines all "mapped" files */
@@ -126,11 +135,15 @@ void rammap_initialize(void);
  *   length  The length of the mapping.  For exception #1 above, this length
  *           ignored:  The entire underlying media is always accessible.
  *   offset  The offset into the file to map
+ *   shared  True if the mapping was created with MAP_SHARED and PROT_WRITE
+ *           so that changes must be written back to the file
  *
  * Returned Value:
  *   On success, rammmap() returns a pointer to the mapped area. On error, the
  *   value MAP_FAILED is returned, and errno is set  appropriately.
  *
+ *     EACCES
+ *      A shared, writable mapping of a file not opened for writing.
  *     EBADF
  *      'fd' is not a valid file descriptor.
  *     EINVAL
@@ -140,7 +153,34 @@ void rammap_initialize(void);
  *
  ****************************************************************************/
 
-FAR void *rammap(int fd, size_t length, off_t offset);
+FAR void *rammap(int fd, size_t length, off_t offset, bool shared);
+
+/****************************************************************************
+ * Name: rammap_writeback
+ *
+ * Description:
+ *   Write part of the memory copy of a shared, writable mapping back to
+ *   the file.  Nothing is done for other mappings.
+ *
+ * Input Parameters:
+ *   map     The mapping
+ *   addr    The start of the part of the mapping to write back
+ *   length  The length of the part to write back
+ *
+ * Returned Value:
+ *   Zero (OK) on success; a negated errno value on failure.
+ *
+ * Assumptions:
+ *   The caller holds g_rammaps.exclsem.
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_FS_RAMMAP_WRITEBACK
+int rammap_writeback(FAR struct fs_rammap_s *map, FAR void *addr,
+                     size_t length);
+#else
+#  define rammap_writeback(map, addr, length) (OK)
+#endif
 
 #endif /* CONFIG_FS_RAMMAP */
 #endif /* __FS_MMAP_RAMMAP_H */
@@ -102,6 +102,7 @@ struct fsmap_t
 {
   FAR const char                      *fs_filesystemtype;
   FAR const struct mountpt_operations *fs_mops;
+  bool                                 fs_dcache; /* Lookups may be cached */
 };
 
 /****************************************************************************
@@ -127,18 +128,18 @@ extern const struct mountpt_operations littlefs_operations;
 static const struct fsmap_t g_bdfsmap[] =
 {
 #ifdef CONFIG_FS_FAT
-    { "vfat", &fat_operations },
+    { "vfat", &fat_operations, true },
 #endif
 #ifdef CONFIG_FS_ROMFS
-    { "romfs", &romfs_operations },
+    { "romfs", &romfs_operations, true },
 #endif
 #ifdef CONFIG_FS_SMARTFS
-    { "smartfs", &smartfs_operations },
+    { "smartfs", &smartfs_operations, true },
 #endif
 #ifdef CONFIG_FS_LITTLEFS
-    { "littlefs", &littlefs_operations },
+    { "littlefs", &littlefs_operations, true },
 #endif
-    { NULL,   NULL },
+    { NULL,   NULL, false },
 };
 #endif /* BDFS_SUPPORT */
 
@@ -158,15 +159,15 @@ extern const struct mountpt_operations littlefs_operations;
 static const struct fsmap_t g_mdfsmap[] =
 {
 #ifdef CONFIG_FS_ROMFS
-    { "romfs", &romfs_operations },
+    { "romfs", &romfs_operations, true },
 #endif
 #ifdef CONFIG_FS_SPIFFS
-    { "spiffs", &spiffs_operations },
+    { "spiffs", &spiffs_operations, true },
 #endif
 #ifdef CONFIG_FS_LITTLEFS
-    { "littlefs", &littlefs_operations },
+    { "littlefs", &littlefs_operations, true },
 #endif
-    { NULL,   NULL },
+    { NULL,   NULL, false },
 };
 #endif /* MDFS_SUPPORT */
 
@@ -204,33 +205,33 @@ extern const struct mountpt_operations unionfs_operations;
 static const struct fsmap_t g_nonbdfsmap[] =
 {
 #ifdef CONFIG_FS_NXFFS
-    { "nxffs", &nxffs_operations },
+    { "nxffs", &nxffs_operations, true },
 #endif
 #ifdef CONFIG_FS_TMPFS
-    { "tmpfs", &tmpfs_operations },
+    { "tmpfs", &tmpfs_operations, true },
 #endif
 #ifdef CONFIG_NFS
-    { "nfs", &nfs_operations },
+    { "nfs", &nfs_operations, false },
 #endif
 #ifdef CONFIG_FS_BINFS
-    { "binfs", &binfs_operations },
+    { "binfs", &binfs_operations, false },
 #endif
 #ifdef CONFIG_FS_PROCFS
-    { "procfs", &procfs_operations },
+    { "procfs", &procfs_operations, false },
 #endif
 #ifdef CONFIG_FS_USERFS
-    { "userfs", &userfs_operations },
+    { "userfs", &userfs_operations, false },
 #endif
 #ifdef CONFIG_FS_HOSTFS
-    { "hostfs", &hostfs_operations },
+    { "hostfs", &hostfs_operations, false },
 #endif
 #ifdef CONFIG_FS_CROMFS
-    { "cromfs", &cromfs_operations },
+    { "cromfs", &cromfs_operations, true },
 #endif
 #ifdef CONFIG_FS_UNIONFS
-    { "unionfs", &unionfs_operations },
+    { "unionfs", &unionfs_operations, false },
 #endif
-    { NULL, NULL },
+    { NULL, NULL, false },
 };
 #endif /* NODFS_SUPPORT */
 
@@ -247,7 +248,7 @@ static const struct fsmap_t g_nonbdfsmap[] =
  ****************************************************************************/
 
 #if defined(BDFS_SUPPORT) || defined(MDFS_SUPPORT) || defined(NODFS_SUPPORT)
-static FAR const struct mountpt_operations *
+static FAR const struct fsmap_t *
 mount_findfs(FAR const struct fsmap_t *fstab, FAR const char *filesystemtype)
 {
   FAR const struct fsmap_t *fsmap;
@@ -256,7 +257,7 @@ mount_findfs(FAR const struct fsmap_t *fstab, FAR const char *filesystemtype)
     {
       if (strcmp(filesystemtype, fsmap->fs_filesystemtype) == 0)
         {
-          return fsmap->fs_mops;
+          return fsmap;
         }
     }
 
@@ -301,6 +302,7 @@ int mount(FAR const char *source, FAR const char *target,
   FAR struct inode *drvr_inode = NULL;
 #endif
   FAR struct inode *mountpt_inode;
+  FAR const struct fsmap_t *fsmap;
   FAR const struct mountpt_operations *mops;
 #ifndef CONFIG_DISABLE_PSEUDOFS_OPERATIONS
   struct inode_search_s desc;
@@ -321,8 +323,8 @@ int mount(FAR const char *source, FAR const char *target,
     {
       /* Find the block based file system */
 
-      mops = mount_findfs(g_bdfsmap, filesystemtype);
-      if (mops == NULL)
+      fsmap = mount_findfs(g_bdfsmap, filesystemtype);
+      if (fsmap == NULL)
         {
           ferr("ERROR: Failed to find block based file system %s\n",
                filesystemtype);
@@ -338,8 +340,8 @@ int mount(FAR const char *source, FAR const char *target,
     {
       /* Find the MTD based file system */
 
-      mops = mount_findfs(g_mdfsmap, filesystemtype);
-      if (mops == NULL)
+      fsmap = mount_findfs(g_mdfsmap, filesystemtype);
+      if (fsmap == NULL)
         {
           ferr("ERROR: Failed to find MTD based file system %s\n",
                filesystemtype);
@@ -351,7 +353,7 @@ int mount(FAR const char *source, FAR const char *target,
   else
 #endif /* MDFS_SUPPORT */
 #ifdef NODFS_SUPPORT
-  if ((mops = mount_findfs(g_nonbdfsmap, filesystemtype)) != NULL)
+  if ((fsmap = mount_findfs(g_nonbdfsmap, filesystemtype)) != NULL)
     {
     }
   else
@@ -363,6 +365,8 @@ int mount(FAR const char *source, FAR const char *target,
       goto errout;
     }
 
+  mops = fsmap->fs_mops;
+
   inode_semtake();
 
 #ifndef CONFIG_DISABLE_PSEUDOFS_OPERATIONS
@@ -479,6 +483,14 @@ int mount(FAR const char *source, FAR const char *target,
 
   INODE_SET_MOUNTPT(mountpt_inode);
 
+#ifdef CONFIG_FS_DCACHE
+  mountpt_inode->i_flags &= ~FSNODEFLAG_DCACHE;
+  if (fsmap->fs_dcache)
+    {
+      mountpt_inode->i_flags |= FSNODEFLAG_DCACHE;
+    }
+#endif
+
   mountpt_inode->u.i_mops  = mops;
 #ifdef CONFIG_FILE_MODE
   mountpt_inode->i_mode    = mode;
@@ -143,11 +143,13 @@ int umount2(FAR const char *target, unsigned int flags)
       goto errout_with_semaphore;
     }
 
-  /* Successfully unbound.  Convert the mountpoint inode to regular
-   * pseudo-file inode.
+  /* Successfully unbound.  Forget any cached lookups in the volume and
+   * convert the mountpoint inode to regular pseudo-file inode.
    */
 
-  mountpt_inode->i_flags  &= ~FSNODEFLAG_TYPE_MASK;
+  dcache_flush(mountpt_inode, false);
+
+  mountpt_inode->i_flags  &= ~(FSNODEFLAG_TYPE_MASK | FSNODEFLAG_DCACHE);
   mountpt_inode->i_private = NULL;
   mountpt_inode->u.i_mops  = NULL;
 
@@ -135,6 +135,12 @@ EXTERN int nfs_finddir(FAR struct nfsmount *nmp, FAR const char *relpath,
               FAR struct nfs_fattr *attributes, FAR char *filename);
 EXTERN void nfs_attrupdate(FAR struct nfsnode *np,
               FAR struct nfs_fattr *attributes);
+#if CONFIG_NFS_LOOKUP_NENTRIES > 0
+EXTERN void nfs_lookup_invalidate(FAR struct nfsmount *nmp,
+              FAR struct nfsnode *np);
+#else
+#  define nfs_lookup_invalidate(nmp,np)
+#endif
 
 #undef EXTERN
 #if defined(__cplusplus)
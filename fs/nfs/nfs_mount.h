@@ -49,6 +49,8 @@
  ****************************************************************************/
 
 #include <sys/socket.h>
+#include <time.h>
+
 #include <nuttx/semaphore.h>
 
 #include "rpc.h"
@@ -57,10 +59,36 @@
  * Pre-processor Definitions
  ****************************************************************************/
 
+#ifndef CONFIG_NFS_LOOKUP_NENTRIES
+#  define CONFIG_NFS_LOOKUP_NENTRIES 0
+#endif
+
+#ifndef CONFIG_NFS_LOOKUP_TIMEO
+#  define CONFIG_NFS_LOOKUP_TIMEO 3
+#endif
+
+#ifndef CONFIG_NFS_LOOKUP_PATHLEN
+#  define CONFIG_NFS_LOOKUP_PATHLEN 48
+#endif
+
 /****************************************************************************
  * Public Types
  ****************************************************************************/
 
+#if CONFIG_NFS_LOOKUP_NENTRIES > 0
+/* One entry of the lookup cache:  The file handle and attributes of a path
+ * relative to the mountpoint.
+ */
+
+struct nfs_lookup_s
+{
+  clock_t            stamp;                   /* Time the entry was added */
+  struct file_handle fhandle;                 /* File handle of the path */
+  struct nfs_fattr   attributes;              /* Attributes of the path */
+  char               path[CONFIG_NFS_LOOKUP_PATHLEN]; /* Empty if unused */
+};
+#endif
+
 /* Mount structure. One mount structure is allocated for each NFS mount. This
  * structure holds NFS specific information for mount.
  */
@@ -84,6 +112,10 @@ struct nfsmount
   uint16_t         nm_wsize;                  /* Max size of write RPC */
   uint16_t         nm_readdirsize;            /* Size of a readdir RPC */
   uint16_t         nm_buflen;                 /* Size of I/O buffer */
+#if CONFIG_NFS_LOOKUP_NENTRIES > 0
+  uint8_t          nm_lookupnext;             /* Next lookup entry to replace */
+  struct nfs_lookup_s nm_lookup[CONFIG_NFS_LOOKUP_NENTRIES]; /* Lookup cache */
+#endif
 
   /* Set aside memory on the stack to hold the largest call message.  NOTE
    * that for the case of the write call message, it is the reply message that
@@ -105,6 +137,7 @@ struct nfsmount
     struct rpc_call_fs      fsstat;
     struct rpc_call_setattr setattr;
     struct rpc_call_fs      fs;
+    struct rpc_call_commit  commit;
     struct rpc_reply_write  write;
   } nm_msgbuffer;
 
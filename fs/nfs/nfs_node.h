@@ -58,6 +58,8 @@
 
 #define NFSNODE_OPEN           (1 << 0) /* File is still open */
 #define NFSNODE_MODIFIED       (1 << 1) /* Might have a modified buffer */
+#define NFSNODE_DIRTY          (1 << 2) /* Buffer holds unwritten data */
+#define NFSNODE_UNSTABLE       (1 << 3) /* Written data needs a COMMIT */
 
 /****************************************************************************
  * Public Types
@@ -79,6 +81,12 @@ struct nfsnode
   time_t             n_ctime;       /* File creation time */
   nfsfh_t            n_fhandle;     /* NFS File Handle */
   uint64_t           n_size;        /* Current size of file */
+#ifdef CONFIG_NFS_IOCACHE
+  FAR uint8_t       *n_buffer;      /* Read-ahead/write-behind buffer */
+  uint64_t           n_bufpos;      /* File offset of the buffered data */
+  uint32_t           n_buflen;      /* Number of bytes in n_buffer */
+  uint8_t            n_verf[NFSX_V3WRITEVERF]; /* Verifier of UNSTABLE writes */
+#endif
 };
 
 #endif /* __FS_NFS_NFS_NODE_H */
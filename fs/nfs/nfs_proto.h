@@ -481,6 +481,19 @@ struct WRITE3resok
   uint8_t            verf[NFSX_V3WRITEVERF];
 };
 
+struct COMMIT3args
+{
+  struct file_handle fhandle;     /* Variable length */
+  uint64_t           offset;
+  uint32_t           count;
+};
+
+struct COMMIT3resok
+{
+  struct wcc_data    file_wcc;
+  uint8_t            verf[NFSX_V3WRITEVERF];
+};
+
 struct REMOVE3args
 {
   struct diropargs3  object;
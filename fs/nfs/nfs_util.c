@@ -52,6 +52,7 @@
 #include <assert.h>
 #include <debug.h>
 
+#include <nuttx/clock.h>
 #include <nuttx/fs/dirent.h>
 
 #include "rpc.h"
@@ -359,6 +360,119 @@ int nfs_lookup(struct nfsmount *nmp, FAR const char *filename,
   return OK;
 }
 
+/****************************************************************************
+ * Name: nfs_lookup_find
+ *
+ * Description:
+ *   Look up 'relpath' in the lookup cache.  Returns true with the file
+ *   handle and the attributes of the path if an entry is found that has not
+ *   yet expired.
+ *
+ ****************************************************************************/
+
+#if CONFIG_NFS_LOOKUP_NENTRIES > 0
+static bool nfs_lookup_find(FAR struct nfsmount *nmp,
+                            FAR const char *relpath,
+                            FAR struct file_handle *fhandle,
+                            FAR struct nfs_fattr *attributes)
+{
+  FAR struct nfs_lookup_s *entry;
+  clock_t now = clock_systimer();
+  int i;
+
+  for (i = 0; i < CONFIG_NFS_LOOKUP_NENTRIES; i++)
+    {
+      entry = &nmp->nm_lookup[i];
+      if (entry->path[0] == '\0' || strcmp(entry->path, relpath) != 0)
+        {
+          continue;
+        }
+
+      if (now - entry->stamp >= SEC2TICK(CONFIG_NFS_LOOKUP_TIMEO))
+        {
+          /* The entry has expired */
+
+          entry->path[0] = '\0';
+          return false;
+        }
+
+      memcpy(fhandle, &entry->fhandle, sizeof(struct file_handle));
+      if (attributes != NULL)
+        {
+          memcpy(attributes, &entry->attributes, sizeof(struct nfs_fattr));
+        }
+
+      return true;
+    }
+
+  return false;
+}
+
+/****************************************************************************
+ * Name: nfs_lookup_add
+ *
+ * Description:
+ *   Add the file handle and the attributes of 'relpath' to the lookup
+ *   cache, replacing the oldest entry.
+ *
+ ****************************************************************************/
+
+static void nfs_lookup_add(FAR struct nfsmount *nmp,
+                           FAR const char *relpath,
+                           FAR const struct file_handle *fhandle,
+                           FAR const struct nfs_fattr *attributes)
+{
+  FAR struct nfs_lookup_s *entry;
+
+  if (strlen(relpath) >= CONFIG_NFS_LOOKUP_PATHLEN)
+    {
+      return;
+    }
+
+  entry = &nmp->nm_lookup[nmp->nm_lookupnext];
+  if (++nmp->nm_lookupnext >= CONFIG_NFS_LOOKUP_NENTRIES)
+    {
+      nmp->nm_lookupnext = 0;
+    }
+
+  entry->stamp = clock_systimer();
+  memcpy(&entry->fhandle, fhandle, sizeof(struct file_handle));
+  memcpy(&entry->attributes, attributes, sizeof(struct nfs_fattr));
+  strcpy(entry->path, relpath);
+}
+#endif
+
+/****************************************************************************
+ * Name: nfs_lookup_invalidate
+ *
+ * Description:
+ *   Discard the lookup cache entries with the file handle of 'np', or all
+ *   entries if 'np' is NULL.  Called when the attributes of a file change
+ *   or when the name space changes.
+ *
+ ****************************************************************************/
+
+#if CONFIG_NFS_LOOKUP_NENTRIES > 0
+void nfs_lookup_invalidate(FAR struct nfsmount *nmp,
+                           FAR struct nfsnode *np)
+{
+  FAR struct nfs_lookup_s *entry;
+  int i;
+
+  for (i = 0; i < CONFIG_NFS_LOOKUP_NENTRIES; i++)
+    {
+      entry = &nmp->nm_lookup[i];
+      if (np == NULL ||
+          (entry->fhandle.length == np->n_fhsize &&
+           memcmp(&entry->fhandle.handle, &np->n_fhandle,
+                  np->n_fhsize) == 0))
+        {
+          entry->path[0] = '\0';
+        }
+    }
+}
+#endif
+
 /****************************************************************************
  * Name: nfs_findnode
  *
@@ -408,6 +522,18 @@ int nfs_findnode(struct nfsmount *nmp, FAR const char *relpath,
       return OK;
     }
 
+#if CONFIG_NFS_LOOKUP_NENTRIES > 0
+  /* Check if the path was looked up recently.  The attributes of the
+   * directory are not cached.
+   */
+
+  if (dir_attributes == NULL &&
+      nfs_lookup_find(nmp, relpath, fhandle, obj_attributes))
+    {
+      return OK;
+    }
+#endif
+
   /* This is not the root directory. Loop until the directory entry corresponding
    * to the path is found.
    */
@@ -447,6 +573,9 @@ int nfs_findnode(struct nfsmount *nmp, FAR const char *relpath,
            * directory entry is in fhandle, obj_attributes, and dir_attributes.
            */
 
+#if CONFIG_NFS_LOOKUP_NENTRIES > 0
+          nfs_lookup_add(nmp, relpath, fhandle, obj_attributes);
+#endif
           return OK;
         }
 
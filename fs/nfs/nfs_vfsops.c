@@ -142,6 +142,22 @@ static int     nfs_filetruncate(FAR struct nfsmount *nmp,
 static int     nfs_fileopen(FAR struct nfsmount *nmp,
                    FAR struct nfsnode *np, FAR const char *relpath,
                    int oflags, mode_t mode);
+static int     nfs_fileread(FAR struct nfsmount *nmp,
+                   FAR struct nfsnode *np, uint64_t offset,
+                   FAR uint8_t *buffer, size_t buflen, FAR size_t *nread);
+static int     nfs_filewrite(FAR struct nfsmount *nmp,
+                   FAR struct nfsnode *np, uint64_t offset,
+                   FAR const uint8_t *buffer, size_t buflen,
+                   FAR size_t *nwritten);
+#ifdef CONFIG_NFS_IOCACHE
+static size_t  nfs_iosize(FAR struct nfsmount *nmp);
+static int     nfs_filecommit(FAR struct nfsmount *nmp,
+                   FAR struct nfsnode *np);
+static int     nfs_fileflush(FAR struct nfsmount *nmp,
+                   FAR struct nfsnode *np);
+static int     nfs_filesync(FAR struct nfsmount *nmp,
+                   FAR struct nfsnode *np);
+#endif
 
 static int     nfs_open(FAR struct file *filep, const char *relpath,
                    int oflags, mode_t mode);
@@ -149,6 +165,9 @@ static int     nfs_close(FAR struct file *filep);
 static ssize_t nfs_read(FAR struct file *filep, char *buffer, size_t buflen);
 static ssize_t nfs_write(FAR struct file *filep, const char *buffer,
                    size_t buflen);
+#ifdef CONFIG_NFS_IOCACHE
+static int     nfs_sync(FAR struct file *filep);
+#endif
 static int     nfs_dup(FAR const struct file *oldp, FAR struct file *newp);
 static int     nfs_fstat(FAR const struct file *filep, FAR struct stat *buf);
 static int     nfs_truncate(FAR struct file *filep, off_t length);
@@ -193,7 +212,11 @@ const struct mountpt_operations nfs_operations =
   NULL,                         /* seek */
   NULL,                         /* ioctl */
 
+#ifdef CONFIG_NFS_IOCACHE
+  nfs_sync,                     /* sync */
+#else
   NULL,                         /* sync */
+#endif
   nfs_dup,                      /* dup */
   nfs_fstat,                    /* fstat */
   nfs_truncate,                 /* truncate */
@@ -340,6 +363,10 @@ static int nfs_filecreate(FAR struct nfsmount *nmp, FAR struct nfsnode *np,
       reqlen += 2*sizeof(uint32_t);
     }
 
+  /* The directory changes, so cached lookups may become stale */
+
+  nfs_lookup_invalidate(nmp, NULL);
+
   /* Send the NFS request.  Note there is special logic here to handle version 3
    * exclusive open semantics.
    */
@@ -451,6 +478,10 @@ static int nfs_filetruncate(FAR struct nfsmount *nmp,
   *ptr++  = nfs_false;                        /* No guard value */
   reqlen += 9 * sizeof(uint32_t);
 
+  /* The attributes of the file change, so a cached lookup is stale */
+
+  nfs_lookup_invalidate(nmp, np);
+
   /* Perform the SETATTR RPC */
 
   nfs_statistics(NFSPROC_SETATTR);
@@ -566,6 +597,503 @@ static int nfs_fileopen(FAR struct nfsmount *nmp, FAR struct nfsnode *np,
   return OK;
 }
 
+/****************************************************************************
+ * Name: nfs_iosize
+ *
+ * Description:
+ *   Return the size of the read-ahead and write-behind buffer: the largest
+ *   transfer that fits in a single READ or WRITE RPC.
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_NFS_IOCACHE
+static size_t nfs_iosize(FAR struct nfsmount *nmp)
+{
+  return MIN(nmp->nm_rsize, nmp->nm_wsize);
+}
+#endif
+
+/****************************************************************************
+ * Name: nfs_fileread
+ *
+ * Description:
+ *   Read 'buflen' bytes at 'offset' of the file with READ RPCs of up to the
+ *   negotiated read size.  Fewer bytes are read at the end of the file.
+ *
+ * Returned Value:
+ *   0 on success with the number of bytes read in 'nread'; a positive
+ *   errno value on failure.
+ *
+ ****************************************************************************/
+
+static int nfs_fileread(FAR struct nfsmount *nmp, FAR struct nfsnode *np,
+                        uint64_t offset, FAR uint8_t *buffer, size_t buflen,
+                        FAR size_t *nread)
+{
+  FAR uint32_t *ptr;
+  size_t        bytesread;
+  size_t        readsize;
+  size_t        reqlen;
+  ssize_t       tmp;
+  uint32_t      eof;
+  int           error;
+
+  /* Loop until we fill the buffer (or hit the end of the file) */
+
+  for (bytesread = 0; bytesread < buflen; )
+    {
+      /* Make sure that the attempted read size does not exceed the RPC
+       * maximum.
+       */
+
+      readsize = buflen - bytesread;
+      if (readsize > nmp->nm_rsize)
+        {
+          readsize = nmp->nm_rsize;
+        }
+
+      /* Make sure that the attempted read size does not exceed the IO
+       * buffer size.
+       */
+
+      tmp = SIZEOF_rpc_reply_read(readsize);
+      if (tmp > nmp->nm_buflen)
+        {
+          readsize -= (tmp - nmp->nm_buflen);
+        }
+
+      /* Initialize the request */
+
+      ptr     = (FAR uint32_t *)&nmp->nm_msgbuffer.read.read;
+      reqlen  = 0;
+
+      /* Copy the variable length, file handle */
+
+      *ptr++  = txdr_unsigned((uint32_t)np->n_fhsize);
+      reqlen += sizeof(uint32_t);
+
+      memcpy(ptr, &np->n_fhandle, np->n_fhsize);
+      reqlen += (int)np->n_fhsize;
+      ptr    += uint32_increment((int)np->n_fhsize);
+
+      /* Copy the file offset */
+
+      txdr_hyper(offset + bytesread, ptr);
+      ptr += 2;
+      reqlen += 2*sizeof(uint32_t);
+
+      /* Set the readsize */
+
+      *ptr = txdr_unsigned(readsize);
+      reqlen += sizeof(uint32_t);
+
+      /* Perform the read */
+
+      finfo("Reading %d bytes\n", readsize);
+      nfs_statistics(NFSPROC_READ);
+      error = nfs_request(nmp, NFSPROC_READ,
+                          (FAR void *)&nmp->nm_msgbuffer.read, reqlen,
+                          (FAR void *)nmp->nm_iobuffer, nmp->nm_buflen);
+      if (error)
+        {
+          ferr("ERROR: nfs_request failed: %d\n", error);
+          return error;
+        }
+
+      /* The read was successful.  Get a pointer to the beginning of the NFS
+       * response data.
+       */
+
+      ptr = (FAR uint32_t *)&((FAR struct rpc_reply_read *)
+              nmp->nm_iobuffer)->read;
+
+      /* Check if attributes are included in the responses */
+
+      tmp = *ptr++;
+      if (tmp != 0)
+        {
+          /* Yes... just skip over the attributes for now */
+
+          ptr += uint32_increment(sizeof(struct nfs_fattr));
+        }
+
+      /* This is followed by the count of data read.  Isn't this
+       * the same as the length that is included in the read data?
+       *
+       * Just skip over if for now.
+       */
+
+      ptr++;
+
+      /* Next comes an EOF indication. */
+
+      eof = *ptr++;
+
+      /* Then the length of the read data followed by the read data itself */
+
+      tmp = fxdr_unsigned(uint32_t, *ptr);
+      ptr++;
+
+      if (tmp > readsize)
+        {
+          ferr("ERROR: Server returned %d bytes for %d\n", tmp, readsize);
+          return EIO;
+        }
+
+      /* Copy the read data into the buffer */
+
+      memcpy(buffer + bytesread, ptr, tmp);
+      bytesread += tmp;
+
+      /* Check if we hit the end of file */
+
+      if (eof != 0 || tmp == 0)
+        {
+          break;
+        }
+    }
+
+  *nread = bytesread;
+  return OK;
+}
+
+/****************************************************************************
+ * Name: nfs_filewrite
+ *
+ * Description:
+ *   Write 'buflen' bytes at 'offset' of the file with WRITE RPCs of up to
+ *   the negotiated write size.  With CONFIG_NFS_IOCACHE, the data is
+ *   written UNSTABLE and must be committed later by nfs_filecommit().
+ *
+ * Returned Value:
+ *   0 on success with the number of bytes written in 'nwritten'; a
+ *   positive errno value on failure.
+ *
+ ****************************************************************************/
+
+static int nfs_filewrite(FAR struct nfsmount *nmp, FAR struct nfsnode *np,
+                         uint64_t offset, FAR const uint8_t *buffer,
+                         size_t buflen, FAR size_t *nwritten)
+{
+  FAR uint32_t *ptr;
+  ssize_t       writesize;
+  ssize_t       bufsize;
+  size_t        byteswritten;
+  size_t        reqlen;
+  uint32_t      committed;
+  uint32_t      tmp;
+  int           error;
+#ifdef CONFIG_NFS_IOCACHE
+  uint32_t      stable = NFSV3WRITE_UNSTABLE;
+#else
+  uint32_t      stable = NFSV3WRITE_FILESYNC;
+#endif
+
+  /* The attributes of the file change, so a cached lookup is stale */
+
+  nfs_lookup_invalidate(nmp, np);
+
+  /* Now loop until we send the entire buffer */
+
+  for (byteswritten = 0; byteswritten < buflen; )
+    {
+      /* Make sure that the attempted write size does not exceed the RPC
+       * maximum.
+       */
+
+      writesize = buflen - byteswritten;
+      if (writesize > nmp->nm_wsize)
+        {
+          writesize = nmp->nm_wsize;
+        }
+
+      /* Make sure that the attempted write size does not exceed the IO
+       * buffer size.
+       */
+
+      bufsize = SIZEOF_rpc_call_write(writesize);
+      if (bufsize > nmp->nm_buflen)
+        {
+          writesize -= (bufsize - nmp->nm_buflen);
+        }
+
+      /* Initialize the request.  Here we need an offset pointer to the write
+       * arguments, skipping over the RPC header.  Write is unique among the
+       * RPC calls in that the entry RPC calls messasge lies in the I/O
+       * buffer.
+       */
+
+      ptr     = (FAR uint32_t *)&((FAR struct rpc_call_write *)
+                  nmp->nm_iobuffer)->write;
+      reqlen  = 0;
+
+      /* Copy the variable length, file handle */
+
+      *ptr++  = txdr_unsigned((uint32_t)np->n_fhsize);
+      reqlen += sizeof(uint32_t);
+
+      memcpy(ptr, &np->n_fhandle, np->n_fhsize);
+      reqlen += (int)np->n_fhsize;
+      ptr    += uint32_increment((int)np->n_fhsize);
+
+      /* Copy the file offset */
+
+      txdr_hyper(offset + byteswritten, ptr);
+      ptr    += 2;
+      reqlen += 2*sizeof(uint32_t);
+
+      /* Copy the count and stable values */
+
+      *ptr++  = txdr_unsigned(writesize);
+      *ptr++  = txdr_unsigned(stable);
+      reqlen += 2*sizeof(uint32_t);
+
+      /* Copy a chunk of the data into the I/O buffer */
+
+      *ptr++  = txdr_unsigned(writesize);
+      reqlen += sizeof(uint32_t);
+      memcpy(ptr, buffer + byteswritten, writesize);
+      reqlen += uint32_alignup(writesize);
+
+      /* Perform the write */
+
+      nfs_statistics(NFSPROC_WRITE);
+      error = nfs_request(nmp, NFSPROC_WRITE,
+                          (FAR void *)nmp->nm_iobuffer, reqlen,
+                          (FAR void *)&nmp->nm_msgbuffer.write,
+                          sizeof(struct rpc_reply_write));
+      if (error)
+        {
+          ferr("ERROR: nfs_request failed: %d\n", error);
+          return error;
+        }
+
+      /* Get a pointer to the WRITE reply data */
+
+      ptr = (FAR uint32_t *)&nmp->nm_msgbuffer.write.write;
+
+      /* Parse file_wcc.  First, check if WCC attributes follow. */
+
+      tmp = *ptr++;
+      if (tmp != 0)
+        {
+          /* Yes.. WCC attributes follow.  But we just skip over them. */
+
+          ptr += uint32_increment(sizeof(struct wcc_attr));
+        }
+
+      /* Check if normal file attributes follow */
+
+      tmp = *ptr++;
+      if (tmp != 0)
+        {
+          /* Yes.. Update the cached file status in the file structure. */
+
+          nfs_attrupdate(np, (FAR struct nfs_fattr *)ptr);
+          ptr += uint32_increment(sizeof(struct nfs_fattr));
+        }
+
+      /* Get the count of bytes actually written */
+
+      tmp = fxdr_unsigned(uint32_t, *ptr);
+      ptr++;
+
+      if (tmp < 1 || tmp > writesize)
+        {
+          return EIO;
+        }
+
+      writesize = tmp;
+
+      /* Get the committment level obtained by this RPC */
+
+      committed = fxdr_unsigned(uint32_t, *ptr);
+      ptr++;
+
+#ifdef CONFIG_NFS_IOCACHE
+      /* Remember the write verifier of data that must still be committed.
+       * If it changes, the server has restarted and may have lost data
+       * that was written before.
+       */
+
+      if (committed != NFSV3WRITE_FILESYNC)
+        {
+          if ((np->n_flags & NFSNODE_UNSTABLE) == 0)
+            {
+              memcpy(np->n_verf, ptr, NFSX_V3WRITEVERF);
+              np->n_flags |= NFSNODE_UNSTABLE;
+            }
+          else if (memcmp(np->n_verf, ptr, NFSX_V3WRITEVERF) != 0)
+            {
+              ferr("ERROR: Write verifier changed\n");
+              return EIO;
+            }
+        }
+#else
+      UNUSED(committed);
+#endif
+
+      byteswritten += writesize;
+    }
+
+  *nwritten = byteswritten;
+  return OK;
+}
+
+#ifdef CONFIG_NFS_IOCACHE
+/****************************************************************************
+ * Name: nfs_filecommit
+ *
+ * Description:
+ *   Commit all data of the file that was written UNSTABLE with a single
+ *   COMMIT RPC.
+ *
+ * Returned Value:
+ *   0 on success; a positive errno value on failure.
+ *
+ ****************************************************************************/
+
+static int nfs_filecommit(FAR struct nfsmount *nmp, FAR struct nfsnode *np)
+{
+  FAR uint32_t *ptr;
+  size_t        reqlen;
+  uint32_t      tmp;
+  int           error;
+
+  if ((np->n_flags & NFSNODE_UNSTABLE) == 0)
+    {
+      return OK;
+    }
+
+  /* Initialize the request */
+
+  ptr     = (FAR uint32_t *)&nmp->nm_msgbuffer.commit.commit;
+  reqlen  = 0;
+
+  /* Copy the variable length, file handle */
+
+  *ptr++  = txdr_unsigned((uint32_t)np->n_fhsize);
+  reqlen += sizeof(uint32_t);
+
+  memcpy(ptr, &np->n_fhandle, np->n_fhsize);
+  reqlen += (int)np->n_fhsize;
+  ptr    += uint32_increment((int)np->n_fhsize);
+
+  /* An offset and a count of zero commit the whole file */
+
+  txdr_hyper((uint64_t)0, ptr);
+  ptr    += 2;
+  reqlen += 2*sizeof(uint32_t);
+
+  *ptr    = 0;
+  reqlen += sizeof(uint32_t);
+
+  /* Perform the commit */
+
+  nfs_statistics(NFSPROC_COMMIT);
+  error = nfs_request(nmp, NFSPROC_COMMIT,
+                      (FAR void *)&nmp->nm_msgbuffer.commit, reqlen,
+                      (FAR void *)nmp->nm_iobuffer, nmp->nm_buflen);
+  if (error)
+    {
+      ferr("ERROR: nfs_request failed: %d\n", error);
+      return error;
+    }
+
+  np->n_flags &= ~NFSNODE_UNSTABLE;
+
+  /* Parse file_wcc */
+
+  ptr = (FAR uint32_t *)&((FAR struct rpc_reply_commit *)
+          nmp->nm_iobuffer)->commit;
+
+  tmp = *ptr++;
+  if (tmp != 0)
+    {
+      ptr += uint32_increment(sizeof(struct wcc_attr));
+    }
+
+  tmp = *ptr++;
+  if (tmp != 0)
+    {
+      nfs_attrupdate(np, (FAR struct nfs_fattr *)ptr);
+      ptr += uint32_increment(sizeof(struct nfs_fattr));
+    }
+
+  /* The data was committed only if the server has not restarted since it
+   * was written.
+   */
+
+  if (memcmp(np->n_verf, ptr, NFSX_V3WRITEVERF) != 0)
+    {
+      ferr("ERROR: Write verifier changed\n");
+      return EIO;
+    }
+
+  return OK;
+}
+
+/****************************************************************************
+ * Name: nfs_fileflush
+ *
+ * Description:
+ *   Write the data gathered in the write-behind buffer.  The buffer then
+ *   holds a clean copy of that data.
+ *
+ * Returned Value:
+ *   0 on success; a positive errno value on failure.
+ *
+ ****************************************************************************/
+
+static int nfs_fileflush(FAR struct nfsmount *nmp, FAR struct nfsnode *np)
+{
+  size_t nwritten;
+  int error;
+
+  if ((np->n_flags & NFSNODE_DIRTY) == 0)
+    {
+      return OK;
+    }
+
+  np->n_flags &= ~NFSNODE_DIRTY;
+  error = nfs_filewrite(nmp, np, np->n_bufpos, np->n_buffer, np->n_buflen,
+                        &nwritten);
+  if (error != OK)
+    {
+      /* The data is lost */
+
+      np->n_buflen = 0;
+    }
+
+  return error;
+}
+
+/****************************************************************************
+ * Name: nfs_filesync
+ *
+ * Description:
+ *   Write the data in the write-behind buffer and commit all data of the
+ *   file.
+ *
+ * Returned Value:
+ *   0 on success; a positive errno value on failure.
+ *
+ ****************************************************************************/
+
+static int nfs_filesync(FAR struct nfsmount *nmp, FAR struct nfsnode *np)
+{
+  int error;
+
+  error = nfs_fileflush(nmp, np);
+  if (error == OK)
+    {
+      error = nfs_filecommit(nmp, np);
+    }
+
+  return error;
+}
+#endif /* CONFIG_NFS_IOCACHE */
+
 /****************************************************************************
  * Name: nfs_open
  *
@@ -664,6 +1192,14 @@ static int nfs_open(FAR struct file *filep, FAR const char *relpath,
 
   np->n_crefs = 1;
 
+#ifdef CONFIG_NFS_IOCACHE
+  /* Allocate the read-ahead and write-behind buffer.  Without it, the file
+   * is accessed unbuffered.
+   */
+
+  np->n_buffer = (FAR uint8_t *)kmm_malloc(nfs_iosize(nmp));
+#endif
+
   /* Attach the private data to the struct file instance */
 
   filep->f_priv = np;
@@ -771,10 +1307,21 @@ static int nfs_close(FAR struct file *filep)
                   nmp->nm_head = np->n_next;
                 }
 
-              /* Then deallocate the file structure and return success */
+#ifdef CONFIG_NFS_IOCACHE
+              /* Write and commit any data still held by the client */
 
-              kmm_free(np);
+              ret = -nfs_filesync(nmp, np);
+              if (np->n_buffer != NULL)
+                {
+                  kmm_free(np->n_buffer);
+                }
+#else
               ret = OK;
+#endif
+
+              /* Then deallocate the file structure and return */
+
+              kmm_free(np);
               break;
             }
         }
@@ -798,12 +1345,13 @@ static ssize_t nfs_read(FAR struct file *filep, char *buffer, size_t buflen)
 {
   FAR struct nfsmount       *nmp;
   FAR struct nfsnode        *np;
-  ssize_t                    readsize;
-  ssize_t                    tmp;
-  ssize_t                    bytesread;
-  size_t                     reqlen;
-  FAR uint32_t              *ptr;
+  size_t                     bytesread;
   int                        error = 0;
+#ifdef CONFIG_NFS_IOCACHE
+  uint64_t                   pos;
+  size_t                     nread;
+  size_t                     iosize;
+#endif
 
   finfo("Read %d bytes from offset %d\n", buflen, filep->f_pos);
 
@@ -828,125 +1376,81 @@ static ssize_t nfs_read(FAR struct file *filep, char *buffer, size_t buflen)
       goto errout_with_semaphore;
     }
 
+#ifdef CONFIG_NFS_IOCACHE
+  /* Pending write-behind data must reach the server before it is read */
+
+  error = nfs_fileflush(nmp, np);
+  if (error != OK)
+    {
+      ferr("ERROR: nfs_fileflush failed: %d\n", error);
+      goto errout_with_semaphore;
+    }
+#endif
+
   /* Get the number of bytes left in the file and truncate read count so that
    * it does not exceed the number of bytes left in the file.
    */
 
-  tmp = np->n_size - filep->f_pos;
-  if (buflen > tmp)
+  if ((uint64_t)filep->f_pos >= np->n_size)
     {
-      buflen = tmp;
+      buflen = 0;
+    }
+  else if (buflen > np->n_size - filep->f_pos)
+    {
+      buflen = np->n_size - filep->f_pos;
       finfo("Read size truncated to %d\n", buflen);
     }
 
-  /* Now loop until we fill the user buffer (or hit the end of the file) */
+#ifdef CONFIG_NFS_IOCACHE
+  /* Small reads are served from the read-ahead buffer, which is refilled
+   * with one full sized READ RPC whenever the requested data is not in it.
+   */
 
-  for (bytesread = 0; bytesread < buflen; )
+  iosize = nfs_iosize(nmp);
+  if (np->n_buffer != NULL && buflen < iosize)
     {
-      /* Make sure that the attempted read size does not exceed the RPC maximum */
-
-      readsize = buflen - bytesread;
-      if (readsize > nmp->nm_rsize)
+      for (bytesread = 0; bytesread < buflen; bytesread += nread)
         {
-          readsize = nmp->nm_rsize;
-        }
-
-      /* Make sure that the attempted read size does not exceed the IO buffer size */
-
-      tmp = SIZEOF_rpc_reply_read(readsize);
-      if (tmp > nmp->nm_buflen)
-        {
-          readsize -= (tmp - nmp->nm_buflen);
-        }
-
-      /* Initialize the request */
-
-      ptr     = (FAR uint32_t *)&nmp->nm_msgbuffer.read.read;
-      reqlen  = 0;
-
-      /* Copy the variable length, file handle */
-
-      *ptr++  = txdr_unsigned((uint32_t)np->n_fhsize);
-      reqlen += sizeof(uint32_t);
-
-      memcpy(ptr, &np->n_fhandle, np->n_fhsize);
-      reqlen += (int)np->n_fhsize;
-      ptr    += uint32_increment((int)np->n_fhsize);
-
-      /* Copy the file offset */
-
-      txdr_hyper((uint64_t)filep->f_pos, ptr);
-      ptr += 2;
-      reqlen += 2*sizeof(uint32_t);
-
-      /* Set the readsize */
+          pos = filep->f_pos + bytesread;
+          if (pos < np->n_bufpos || pos >= np->n_bufpos + np->n_buflen)
+            {
+              np->n_buflen = 0;
+              error = nfs_fileread(nmp, np, pos, np->n_buffer, iosize,
+                                   &nread);
+              if (error != OK)
+                {
+                  goto errout_with_semaphore;
+                }
 
-      *ptr = txdr_unsigned(readsize);
-      reqlen += sizeof(uint32_t);
+              if (nread == 0)
+                {
+                  break;
+                }
 
-      /* Perform the read */
+              np->n_bufpos = pos;
+              np->n_buflen = nread;
+            }
 
-      finfo("Reading %d bytes\n", readsize);
-      nfs_statistics(NFSPROC_READ);
-      error = nfs_request(nmp, NFSPROC_READ,
-                          (FAR void *)&nmp->nm_msgbuffer.read, reqlen,
-                          (FAR void *)nmp->nm_iobuffer, nmp->nm_buflen);
-      if (error)
-        {
-          ferr("ERROR: nfs_request failed: %d\n", error);
-          goto errout_with_semaphore;
+          nread = MIN(buflen - bytesread,
+                      np->n_bufpos + np->n_buflen - pos);
+          memcpy(buffer + bytesread, np->n_buffer + (pos - np->n_bufpos),
+                 nread);
         }
-
-      /* The read was successful.  Get a pointer to the beginning of the NFS
-       * response data.
-       */
-
-      ptr = (FAR uint32_t *)&((FAR struct rpc_reply_read *)nmp->nm_iobuffer)->read;
-
-      /* Check if attributes are included in the responses */
-
-      tmp = *ptr++;
-      if (*ptr != 0)
+    }
+  else
+#endif
+    {
+      error = nfs_fileread(nmp, np, filep->f_pos, (FAR uint8_t *)buffer,
+                           buflen, &bytesread);
+      if (error != OK)
         {
-          /* Yes... just skip over the attributes for now */
-
-          ptr += uint32_increment(sizeof(struct nfs_fattr));
+          goto errout_with_semaphore;
         }
+    }
 
-      /* This is followed by the count of data read.  Isn't this
-       * the same as the length that is included in the read data?
-       *
-       * Just skip over if for now.
-       */
-
-      ptr++;
-
-      /* Next comes an EOF indication.  Save that in tmp for now. */
-
-      tmp = *ptr++;
-
-      /* Then the length of the read data followed by the read data itself */
-
-      readsize = fxdr_unsigned(uint32_t, *ptr);
-      ptr++;
-
-      /* Copy the read data into the user buffer */
-
-      memcpy(buffer, ptr, readsize);
-
-      /* Update the read state data */
-
-      filep->f_pos += readsize;
-      bytesread    += readsize;
-      buffer       += readsize;
-
-      /* Check if we hit the end of file */
+  /* Update the read state data */
 
-      if (tmp != 0)
-        {
-          break;
-        }
-    }
+  filep->f_pos += bytesread;
 
   finfo("Read %d bytes\n", bytesread);
   nfs_semgive(nmp);
@@ -971,15 +1475,11 @@ static ssize_t nfs_write(FAR struct file *filep, const char *buffer,
 {
   struct nfsmount       *nmp;
   struct nfsnode        *np;
-  ssize_t                writesize;
-  ssize_t                bufsize;
-  ssize_t                byteswritten;
-  size_t                 reqlen;
-  FAR uint32_t          *ptr;
-  uint32_t               tmp;
-  int                    commit = 0;
-  int                    committed = NFSV3WRITE_FILESYNC;
+  size_t                 byteswritten;
   int                    error;
+#ifdef CONFIG_NFS_IOCACHE
+  uint64_t               pos;
+#endif
 
   finfo("Write %d bytes to offset %d\n", buflen, filep->f_pos);
 
@@ -1012,146 +1512,121 @@ static ssize_t nfs_write(FAR struct file *filep, const char *buffer,
       goto errout_with_semaphore;
     }
 
-  /* Now loop until we send the entire user buffer */
-
-  writesize = 0;
-  for (byteswritten = 0; byteswritten < buflen; )
+#ifdef CONFIG_NFS_IOCACHE
+  pos = filep->f_pos;
+  if (np->n_buffer != NULL && buflen < nfs_iosize(nmp))
     {
-      /* Make sure that the attempted write size does not exceed the RPC
-       * maximum.
+      /* Small writes are gathered in the write-behind buffer as long as
+       * they are contiguous.  Otherwise the gathered data is written first
+       * and the buffer restarts at this write.
        */
 
-      writesize = buflen;
-      if (writesize > nmp->nm_wsize)
+      if ((np->n_flags & NFSNODE_DIRTY) == 0 ||
+          pos != np->n_bufpos + np->n_buflen ||
+          np->n_buflen + buflen > nfs_iosize(nmp))
         {
-          writesize = nmp->nm_wsize;
-        }
-
-      /* Make sure that the attempted read size does not exceed the IO
-       * buffer size.
-       */
+          error = nfs_fileflush(nmp, np);
+          if (error != OK)
+            {
+              goto errout_with_semaphore;
+            }
 
-      bufsize = SIZEOF_rpc_call_write(writesize);
-      if (bufsize > nmp->nm_buflen)
-        {
-          writesize -= (bufsize - nmp->nm_buflen);
+          np->n_bufpos = pos;
+          np->n_buflen = 0;
         }
 
-      /* Initialize the request.  Here we need an offset pointer to the write
-       * arguments, skipping over the RPC header.  Write is unique among the
-       * RPC calls in that the entry RPC calls messasge lies in the I/O buffer
+      memcpy(np->n_buffer + np->n_buflen, buffer, buflen);
+      np->n_buflen += buflen;
+      np->n_flags  |= NFSNODE_DIRTY;
+      byteswritten  = buflen;
+    }
+  else
+    {
+      /* Large writes go directly to the server.  Any buffered data is
+       * written first and the buffer is invalidated.
        */
 
-      ptr     = (FAR uint32_t *)&((FAR struct rpc_call_write *)
-                  nmp->nm_iobuffer)->write;
-      reqlen  = 0;
-
-      /* Copy the variable length, file handle */
-
-      *ptr++  = txdr_unsigned((uint32_t)np->n_fhsize);
-      reqlen += sizeof(uint32_t);
-
-      memcpy(ptr, &np->n_fhandle, np->n_fhsize);
-      reqlen += (int)np->n_fhsize;
-      ptr    += uint32_increment((int)np->n_fhsize);
-
-      /* Copy the file offset */
-
-      txdr_hyper((uint64_t)filep->f_pos, ptr);
-      ptr    += 2;
-      reqlen += 2*sizeof(uint32_t);
-
-      /* Copy the count and stable values */
-
-      *ptr++  = txdr_unsigned(buflen);
-      *ptr++  = txdr_unsigned(committed);
-      reqlen += 2*sizeof(uint32_t);
-
-      /* Copy a chunk of the user data into the I/O buffer */
-
-      *ptr++  = txdr_unsigned(buflen);
-      reqlen += sizeof(uint32_t);
-      memcpy(ptr, buffer, writesize);
-      reqlen += uint32_alignup(writesize);
-
-      /* Perform the write */
-
-      nfs_statistics(NFSPROC_WRITE);
-      error = nfs_request(nmp, NFSPROC_WRITE,
-                          (FAR void *)nmp->nm_iobuffer, reqlen,
-                          (FAR void *)&nmp->nm_msgbuffer.write,
-                          sizeof(struct rpc_reply_write));
-      if (error)
+      error = nfs_fileflush(nmp, np);
+      np->n_buflen = 0;
+      if (error != OK)
         {
-          ferr("ERROR: nfs_request failed: %d\n", error);
           goto errout_with_semaphore;
         }
 
-      /* Get a pointer to the WRITE reply data */
-
-      ptr = (FAR uint32_t *)&nmp->nm_msgbuffer.write.write;
-
-      /* Parse file_wcc.  First, check if WCC attributes follow. */
-
-      tmp = *ptr++;
-      if (tmp != 0)
+      error = nfs_filewrite(nmp, np, pos, (FAR const uint8_t *)buffer,
+                            buflen, &byteswritten);
+      if (error != OK)
         {
-          /* Yes.. WCC attributes follow.  But we just skip over them. */
-
-          ptr += uint32_increment(sizeof(struct wcc_attr));
+          goto errout_with_semaphore;
         }
+    }
+#else
+  error = nfs_filewrite(nmp, np, filep->f_pos, (FAR const uint8_t *)buffer,
+                        buflen, &byteswritten);
+  if (error != OK)
+    {
+      goto errout_with_semaphore;
+    }
+#endif
 
-      /* Check if normal file attributes follow */
+  /* Update the write state data */
 
-      tmp = *ptr++;
-      if (tmp != 0)
-        {
-          /* Yes.. Update the cached file status in the file structure. */
+  filep->f_pos += byteswritten;
+  if ((uint64_t)filep->f_pos > np->n_size)
+    {
+      np->n_size = filep->f_pos;
+    }
 
-          nfs_attrupdate(np, (FAR struct nfs_fattr *)ptr);
-          ptr += uint32_increment(sizeof(struct nfs_fattr));
-        }
+  nfs_semgive(nmp);
+  return byteswritten;
 
-      /* Get the count of bytes actually written */
+errout_with_semaphore:
+  nfs_semgive(nmp);
+  return -error;
+}
 
-      tmp = fxdr_unsigned(uint32_t, *ptr);
-      ptr++;
+#ifdef CONFIG_NFS_IOCACHE
+/****************************************************************************
+ * Name: nfs_sync
+ *
+ * Description:
+ *   Write the data gathered in the write-behind buffer and commit all
+ *   unstable data of the file on the server.
+ *
+ ****************************************************************************/
 
-      if (tmp < 1 || tmp > writesize)
-        {
-          error = EIO;
-          goto errout_with_semaphore;
-        }
+static int nfs_sync(FAR struct file *filep)
+{
+  FAR struct nfsmount *nmp;
+  FAR struct nfsnode *np;
+  int error;
 
-      writesize = tmp;
+  DEBUGASSERT(filep->f_priv != NULL && filep->f_inode != NULL);
 
-      /* Determine the lowest committment level obtained by any of the RPCs. */
+  /* Recover our private data from the struct file instance */
 
-      commit = *ptr++;
-      if (committed == NFSV3WRITE_FILESYNC)
-        {
-          committed = commit;
-        }
-      else if (committed == NFSV3WRITE_DATASYNC &&
-               commit == NFSV3WRITE_UNSTABLE)
-        {
-          committed = commit;
-        }
+  nmp = (FAR struct nfsmount *)filep->f_inode->i_private;
+  np  = (FAR struct nfsnode *)filep->f_priv;
 
-      /* Update the read state data */
+  DEBUGASSERT(nmp != NULL);
 
-      filep->f_pos += writesize;
-      byteswritten += writesize;
-      buffer       += writesize;
+  /* Make sure that the mount is still healthy */
+
+  nfs_semtake(nmp);
+  error = nfs_checkmount(nmp);
+  if (error != OK)
+    {
+      ferr("ERROR: nfs_checkmount failed: %d\n", error);
+      goto errout_with_semaphore;
     }
 
-  nfs_semgive(nmp);
-  return writesize;
+  error = nfs_filesync(nmp, np);
 
 errout_with_semaphore:
   nfs_semgive(nmp);
   return -error;
 }
+#endif
 
 /****************************************************************************
  * Name: nfs_dup
@@ -1322,6 +1797,17 @@ static int nfs_truncate(FAR struct file *filep, off_t length)
       goto errout_with_semaphore;
     }
 
+#ifdef CONFIG_NFS_IOCACHE
+  /* Write any gathered data first and drop the buffered data */
+
+  error = nfs_fileflush(nmp, np);
+  np->n_buflen = 0;
+  if (error != OK)
+    {
+      goto errout_with_semaphore;
+    }
+#endif
+
   /* Then perform the SETATTR RPC to set the new file size */
 
   error = nfs_filetruncate(nmp, np, length);
@@ -2332,6 +2818,10 @@ static int nfs_remove(struct inode *mountpt, const char *relpath)
   memcpy(ptr, filename, namelen);
   reqlen += uint32_alignup(namelen);
 
+  /* The directory changes, so cached lookups may become stale */
+
+  nfs_lookup_invalidate(nmp, NULL);
+
   /* Perform the REMOVE RPC call */
 
   nfs_statistics(NFSPROC_REMOVE);
@@ -2455,6 +2945,10 @@ static int nfs_mkdir(struct inode *mountpt, const char *relpath, mode_t mode)
   *ptr++  = HTONL(NFSV3SATTRTIME_DONTCHANGE); /* Don't change mtime */
   reqlen += 2*sizeof(uint32_t);
 
+  /* The directory changes, so cached lookups may become stale */
+
+  nfs_lookup_invalidate(nmp, NULL);
+
   /* Perform the MKDIR RPC */
 
   nfs_statistics(NFSPROC_MKDIR);
@@ -2544,6 +3038,10 @@ static int nfs_rmdir(struct inode *mountpt, const char *relpath)
   memcpy(ptr, dirname, namelen);
   reqlen += uint32_alignup(namelen);
 
+  /* The directory changes, so cached lookups may become stale */
+
+  nfs_lookup_invalidate(nmp, NULL);
+
   /* Perform the RMDIR RPC */
 
   nfs_statistics(NFSPROC_RMDIR);
@@ -2661,6 +3159,10 @@ static int nfs_rename(struct inode *mountpt, const char *oldrelpath,
   memcpy(ptr, to_name, namelen);
   reqlen += uint32_alignup(namelen);
 
+  /* The directory changes, so cached lookups may become stale */
+
+  nfs_lookup_invalidate(nmp, NULL);
+
   /* Perform the RENAME RPC */
 
   nfs_statistics(NFSPROC_RENAME);
@@ -336,6 +336,12 @@ struct rpc_call_fs
   struct FS3args fs;
 };
 
+struct rpc_call_commit
+{
+  struct rpc_call_header ch;
+  struct COMMIT3args commit;
+};
+
 /* Generic RPC reply headers */
 
 struct rpc_reply_header
@@ -473,6 +479,13 @@ struct rpc_reply_setattr
   struct SETATTR3resok setattr;
 };
 
+struct rpc_reply_commit
+{
+  struct rpc_reply_header rh;
+  uint32_t status;
+  struct COMMIT3resok commit;
+};
+
 struct  rpcclnt
 {
   nfsfh_t  rc_fh;             /* File handle of the root directory */
@@ -284,6 +284,18 @@ struct nxffs_wrfile_s
   uint32_t                  crc;        /* Accumulated data block CRC */
 };
 
+/* One entry in the in-RAM inode index:  The hash of an inode name and the
+ * FLASH offset of the inode header that was last seen with that name.
+ */
+
+#ifdef CONFIG_NXFFS_INDEX
+struct nxffs_ixentry_s
+{
+  uint32_t                  hash;      /* Hash of the inode name */
+  off_t                     hoffset;   /* FLASH offset to the inode header */
+};
+#endif
+
 /* This structure represents the overall state of on NXFFS instance. */
 
 struct nxffs_volume_s
@@ -302,6 +314,13 @@ struct nxffs_volume_s
   FAR struct nxffs_ofile_s *ofiles;    /* A singly-linked list of open files */
   FAR uint8_t              *cache;     /* On cached erase block for general I/O */
   FAR uint8_t              *pack;      /* A full erase block to support packing */
+#ifdef CONFIG_NXFFS_INDEX
+  FAR struct nxffs_ixentry_s *index;   /* In-RAM index of valid inodes */
+  uint16_t                  ixcount;   /* Number of entries in use */
+  uint16_t                  ixalloc;   /* Number of entries allocated */
+  bool                      ixfull;    /* Index holds every valid inode */
+  bool                      ixnomem;   /* An index entry could not be added */
+#endif
 };
 
 /* This structure describes the state of the blocks on the NXFFS volume */
@@ -667,6 +686,108 @@ int nxffs_findinode(FAR struct nxffs_volume_s *volume, FAR const char *name,
 off_t nxffs_inodeend(FAR struct nxffs_volume_s *volume,
                      FAR struct nxffs_entry_s *entry);
 
+/****************************************************************************
+ * Name: nxffs_rdentry
+ *
+ * Description:
+ *   Read and verify the inode entry at exactly this offset.
+ *
+ * Input Parameters:
+ *   volume - Describes the current volume.
+ *   offset - The byte offset from the beginning of FLASH where the inode
+ *     header is expected.
+ *   entry  - A memory location to return the expanded inode header
+ *     information.
+ *
+ * Returned Value:
+ *   Zero on success.  Otherwise, a negated errno value is returned
+ *   indicating the nature of the failure.
+ *
+ * Defined in nxffs_inode.c
+ *
+ ****************************************************************************/
+
+int nxffs_rdentry(FAR struct nxffs_volume_s *volume, off_t offset,
+                  FAR struct nxffs_entry_s *entry);
+
+/****************************************************************************
+ * Name: nxffs_indexflush, nxffs_indexadd, nxffs_indexremove and
+ *       nxffs_indexdone
+ *
+ * Description:
+ *   Maintain the in-RAM index of valid inodes.  nxffs_indexflush() empties
+ *   the index, nxffs_indexadd() and nxffs_indexremove() record the inode
+ *   header written at or deleted from 'hoffset', and nxffs_indexdone()
+ *   marks the index as holding every valid inode after a full scan of the
+ *   volume.
+ *
+ * Defined in nxffs_index.c
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_NXFFS_INDEX
+void nxffs_indexflush(FAR struct nxffs_volume_s *volume);
+void nxffs_indexadd(FAR struct nxffs_volume_s *volume, FAR const char *name,
+                    off_t hoffset);
+void nxffs_indexremove(FAR struct nxffs_volume_s *volume, off_t hoffset);
+void nxffs_indexdone(FAR struct nxffs_volume_s *volume);
+#else
+#  define nxffs_indexflush(v)
+#  define nxffs_indexadd(v,n,o)
+#  define nxffs_indexremove(v,o)
+#  define nxffs_indexdone(v)
+#endif
+
+/****************************************************************************
+ * Name: nxffs_indexfind
+ *
+ * Description:
+ *   Look up an inode by name in the in-RAM index, verifying the candidate
+ *   inode headers on FLASH.
+ *
+ * Input Parameters:
+ *   volume - Describes the NXFFS volume
+ *   name   - The name of the inode to find
+ *   entry  - The location to return information about the inode.
+ *
+ * Returned Value:
+ *   Zero is returned if the inode was found.  -ENOENT is returned if the
+ *   index is complete and holds no such inode.  -EAGAIN is returned if the
+ *   index is incomplete and the volume must be searched.  Other negated
+ *   errno values indicate the nature of a failure.
+ *
+ * Defined in nxffs_index.c
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_NXFFS_INDEX
+int nxffs_indexfind(FAR struct nxffs_volume_s *volume, FAR const char *name,
+                    FAR struct nxffs_entry_s *entry);
+#endif
+
+/****************************************************************************
+ * Name: nxffs_indexbuild
+ *
+ * Description:
+ *   Rebuild the in-RAM index by scanning every inode on the volume.
+ *
+ * Input Parameters:
+ *   volume - Describes the NXFFS volume
+ *
+ * Returned Value:
+ *   None.  On failure the index is left incomplete and lookups fall back to
+ *   searching the volume.
+ *
+ * Defined in nxffs_index.c
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_NXFFS_INDEX
+void nxffs_indexbuild(FAR struct nxffs_volume_s *volume);
+#else
+#  define nxffs_indexbuild(v)
+#endif
+
 /****************************************************************************
  * Name: nxffs_verifyblock
  *
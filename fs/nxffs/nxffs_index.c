@@ -0,0 +1,247 @@
+/****************************************************************************
+ * fs/nxffs/nxffs_index.c
+ *
+ *   Copyright (C) 2020 Gregory Nutt. All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in
+ *    the documentation and/or other materials provided with the
+ *    distribution.
+ * 3. Neither the name NuttX nor the names of its contributors may be
+ *    used to endorse or promote products derived from this software
+ *    without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+ * FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE
+ * COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+ * INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,
+ * BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS
+ * OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED
+ * AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ * LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN
+ * ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ *
+ ****************************************************************************/
+
+/****************************************************************************
+ * Included Files
+ ****************************************************************************/
+
+#include <nuttx/config.h>
+
+#include <string.h>
+#include <errno.h>
+#include <debug.h>
+
+#include <nuttx/kmalloc.h>
+
+#include "nxffs.h"
+
+/****************************************************************************
+ * Pre-processor Definitions
+ ****************************************************************************/
+
+/* The index grows by this number of entries at a time */
+
+#define NXFFS_INDEX_INCR 16
+
+/****************************************************************************
+ * Private Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: nxffs_indexhash
+ *
+ * Description:
+ *   Return the 32-bit FNV-1a hash of an inode name.
+ *
+ ****************************************************************************/
+
+static uint32_t nxffs_indexhash(FAR const char *name)
+{
+  uint32_t hash = 2166136261u;
+
+  while (*name != '\0')
+    {
+      hash ^= (uint8_t)*name++;
+      hash *= 16777619u;
+    }
+
+  return hash;
+}
+
+/****************************************************************************
+ * Name: nxffs_indexdelete
+ *
+ * Description:
+ *   Remove the index entry at position 'ndx'.  The order of the entries is
+ *   not significant so the last entry is moved into the hole.
+ *
+ ****************************************************************************/
+
+static void nxffs_indexdelete(FAR struct nxffs_volume_s *volume, int ndx)
+{
+  volume->ixcount--;
+  volume->index[ndx] = volume->index[volume->ixcount];
+}
+
+/****************************************************************************
+ * Public Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: nxffs_indexflush
+ ****************************************************************************/
+
+void nxffs_indexflush(FAR struct nxffs_volume_s *volume)
+{
+  volume->ixcount    = 0;
+  volume->ixfull     = false;
+  volume->ixnomem    = false;
+}
+
+/****************************************************************************
+ * Name: nxffs_indexadd
+ ****************************************************************************/
+
+void nxffs_indexadd(FAR struct nxffs_volume_s *volume, FAR const char *name,
+                    off_t hoffset)
+{
+  FAR struct nxffs_ixentry_s *index;
+
+  if (volume->ixcount >= volume->ixalloc)
+    {
+      index = (FAR struct nxffs_ixentry_s *)
+        kmm_realloc(volume->index, (volume->ixalloc + NXFFS_INDEX_INCR) *
+                    sizeof(struct nxffs_ixentry_s));
+      if (index == NULL)
+        {
+          /* The index can no longer be trusted to hold every inode */
+
+          fwarn("WARNING: Failed to grow the inode index\n");
+          volume->ixfull     = false;
+          volume->ixnomem    = true;
+          return;
+        }
+
+      volume->index    = index;
+      volume->ixalloc += NXFFS_INDEX_INCR;
+    }
+
+  volume->index[volume->ixcount].hash    = nxffs_indexhash(name);
+  volume->index[volume->ixcount].hoffset = hoffset;
+  volume->ixcount++;
+}
+
+/****************************************************************************
+ * Name: nxffs_indexremove
+ ****************************************************************************/
+
+void nxffs_indexremove(FAR struct nxffs_volume_s *volume, off_t hoffset)
+{
+  int i;
+
+  for (i = 0; i < volume->ixcount; i++)
+    {
+      if (volume->index[i].hoffset == hoffset)
+        {
+          nxffs_indexdelete(volume, i);
+          return;
+        }
+    }
+}
+
+/****************************************************************************
+ * Name: nxffs_indexdone
+ ****************************************************************************/
+
+void nxffs_indexdone(FAR struct nxffs_volume_s *volume)
+{
+  volume->ixfull = !volume->ixnomem;
+  finfo("Inode index: %d entries, complete: %d\n",
+        volume->ixcount, volume->ixfull);
+}
+
+/****************************************************************************
+ * Name: nxffs_indexfind
+ ****************************************************************************/
+
+int nxffs_indexfind(FAR struct nxffs_volume_s *volume, FAR const char *name,
+                    FAR struct nxffs_entry_s *entry)
+{
+  uint32_t hash = nxffs_indexhash(name);
+  int ret;
+  int i;
+
+  for (i = 0; i < volume->ixcount; )
+    {
+      if (volume->index[i].hash != hash)
+        {
+          i++;
+          continue;
+        }
+
+      /* Verify the candidate against the inode header on FLASH */
+
+      ret = nxffs_rdentry(volume, volume->index[i].hoffset, entry);
+      if (ret == OK)
+        {
+          if (strcmp(name, entry->name) == 0)
+            {
+              return OK;
+            }
+
+          /* A different inode with the same hash */
+
+          nxffs_freeentry(entry);
+          i++;
+        }
+      else if (ret == -ENOMEM)
+        {
+          return ret;
+        }
+      else
+        {
+          /* The inode is no longer valid at this offset.  Drop the entry. */
+
+          nxffs_indexdelete(volume, i);
+        }
+    }
+
+  return volume->ixfull ? -ENOENT : -EAGAIN;
+}
+
+/****************************************************************************
+ * Name: nxffs_indexbuild
+ ****************************************************************************/
+
+void nxffs_indexbuild(FAR struct nxffs_volume_s *volume)
+{
+  struct nxffs_entry_s entry;
+  off_t offset;
+  int ret;
+
+  nxffs_indexflush(volume);
+
+  offset = volume->inoffset;
+  while ((ret = nxffs_nextentry(volume, offset, &entry)) == OK)
+    {
+      nxffs_indexadd(volume, entry.name, entry.hoffset);
+      offset = nxffs_inodeend(volume, &entry);
+      nxffs_freeentry(&entry);
+    }
+
+  if (ret == -ENOENT)
+    {
+      nxffs_indexdone(volume);
+    }
+}
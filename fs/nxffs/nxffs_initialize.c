@@ -367,7 +367,11 @@ int nxffs_limits(FAR struct nxffs_volume_s *volume)
       return ret;
     }
 
-  /* Then find the first valid inode in or beyond the first valid block */
+  /* Then find the first valid inode in or beyond the first valid block.
+   * Every valid inode is visited below, so rebuild the inode index too.
+   */
+
+  nxffs_indexflush(volume);
 
   offset = block * volume->geo.blocksize;
   ret = nxffs_nextentry(volume, offset, &entry);
@@ -402,6 +406,7 @@ int nxffs_limits(FAR struct nxffs_volume_s *volume)
 
       /* Discard this entry and set the next offset. */
 
+      nxffs_indexadd(volume, entry.name, entry.hoffset);
       offset = nxffs_inodeend(volume, &entry);
       nxffs_freeentry(&entry);
     }
@@ -414,6 +419,7 @@ int nxffs_limits(FAR struct nxffs_volume_s *volume)
         {
           /* Discard the entry and guess the next offset. */
 
+          nxffs_indexadd(volume, entry.name, entry.hoffset);
           offset = nxffs_inodeend(volume, &entry);
           nxffs_freeentry(&entry);
         }
@@ -449,6 +455,7 @@ int nxffs_limits(FAR struct nxffs_volume_s *volume)
                   finfo("No inodes, inoffset: %d\n", volume->inoffset);
                 }
 
+              nxffs_indexdone(volume);
               return OK;
             }
 
@@ -482,6 +489,7 @@ int nxffs_limits(FAR struct nxffs_volume_s *volume)
                   finfo("First inode at offset %d\n", volume->inoffset);
                 }
 
+              nxffs_indexdone(volume);
               return OK;
             }
         }
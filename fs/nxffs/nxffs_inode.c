@@ -53,14 +53,15 @@
 #include "nxffs.h"
 
 /****************************************************************************
- * Private Functions
+ * Public Functions
  ****************************************************************************/
 
 /****************************************************************************
  * Name: nxffs_rdentry
  *
  * Description:
- *   Read the inode entry at this offset.  Called only from nxffs_nextentry().
+ *   Read the inode entry at this offset.  Called from nxffs_nextentry() and,
+ *   to verify index hits, from nxffs_indexfind().
  *
  * Input Parameters:
  *   volume - Describes the current volume.
@@ -75,8 +76,8 @@
  *
  ****************************************************************************/
 
-static int nxffs_rdentry(FAR struct nxffs_volume_s *volume, off_t offset,
-                         FAR struct nxffs_entry_s *entry)
+int nxffs_rdentry(FAR struct nxffs_volume_s *volume, off_t offset,
+                  FAR struct nxffs_entry_s *entry)
 {
   struct nxffs_inode_s inode;
   uint32_t ecrc;
@@ -197,10 +198,6 @@ errout:
   return ret;
 }
 
-/****************************************************************************
- * Public Functions
- ****************************************************************************/
-
 /****************************************************************************
  * Name: nxffs_freeentry
  *
@@ -378,6 +375,18 @@ int nxffs_findinode(FAR struct nxffs_volume_s *volume, FAR const char *name,
   off_t offset;
   int ret;
 
+#ifdef CONFIG_NXFFS_INDEX
+  /* Try the in-RAM index first.  Only search the volume if the index does
+   * not hold every valid inode.
+   */
+
+  ret = nxffs_indexfind(volume, name, entry);
+  if (ret != -EAGAIN)
+    {
+      return ret;
+    }
+#endif
+
   /* Start with the first valid inode that was discovered when the volume
    * was created (or modified after the last file system re-packing).
    */
@@ -1268,6 +1268,10 @@ int nxffs_wrinode(FAR struct nxffs_volume_s *volume,
       ferr("ERROR: Failed to write inode header block %d: %d\n",
            volume->ioblock, -ret);
     }
+  else
+    {
+      nxffs_indexadd(volume, entry->name, entry->hoffset);
+    }
 
   /* The volume is now available for other writers */
 
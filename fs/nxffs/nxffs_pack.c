@@ -1401,6 +1401,12 @@ int nxffs_pack(FAR struct nxffs_volume_s *volume)
 
 start_pack:
 
+  /* Inodes move while the volume is packed.  Search the volume until the
+   * index is rebuilt at the end.
+   */
+
+  nxffs_indexflush(volume);
+
   pack.ioblock     = nxffs_getblock(volume, iooffset);
   pack.iooffset    = nxffs_getoffset(volume, iooffset, pack.ioblock);
   volume->froffset = iooffset;
@@ -1607,5 +1613,6 @@ start_pack:
 errout_with_pack:
   nxffs_freeentry(&pack.src.entry);
   nxffs_freeentry(&pack.dest.entry);
+  nxffs_indexbuild(volume);
   return ret;
 }
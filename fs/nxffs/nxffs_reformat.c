@@ -290,6 +290,11 @@ int nxffs_reformat(FAR struct nxffs_volume_s *volume)
       return ret;
     }
 
+  /* There are no inodes left to index */
+
+  nxffs_indexflush(volume);
+  nxffs_indexdone(volume);
+
   /* Check for bad blocks */
 
   ret = nxffs_badblocks(volume);
@@ -82,9 +82,17 @@ extern const struct procfs_operations cpuload_operations;
 extern const struct procfs_operations critmon_operations;
 extern const struct procfs_operations meminfo_operations;
 extern const struct procfs_operations iobinfo_operations;
+extern const struct procfs_operations kbench_operations;
+extern const struct procfs_operations latency_operations;
+extern const struct procfs_operations metrics_operations;
+extern const struct procfs_operations mempool_operations;
+extern const struct procfs_operations memdump_operations;
+extern const struct procfs_operations mmbench_operations;
 extern const struct procfs_operations module_operations;
+extern const struct procfs_operations profile_operations;
 extern const struct procfs_operations uptime_operations;
 extern const struct procfs_operations version_operations;
+extern const struct procfs_operations wdog_operations;
 
 /* This is not good.  These are implemented in other sub-systems.  Having to
  * deal with them here is not a good coupling. What is really needed is a
@@ -144,10 +152,38 @@ static const struct procfs_entry_s g_procfs_entries[] =
   { "iobinfo",       &iobinfo_operations,         PROCFS_FILE_TYPE   },
 #endif
 
+#if defined(CONFIG_SCHED_BENCHMARK) && !defined(CONFIG_FS_PROCFS_EXCLUDE_KBENCH)
+  { "kbench",        &kbench_operations,          PROCFS_FILE_TYPE   },
+#endif
+
+#if defined(CONFIG_SCHED_LATENCY)
+  { "latency",       &latency_operations,         PROCFS_FILE_TYPE   },
+#endif
+
+#ifndef CONFIG_FS_PROCFS_EXCLUDE_MEMPOOL
+  { "mempool",       &mempool_operations,         PROCFS_FILE_TYPE   },
+#endif
+
+#if defined(CONFIG_MM_HEAP_PROFILE) && !defined(CONFIG_FS_PROCFS_EXCLUDE_MEMDUMP)
+  { "memdump",       &memdump_operations,         PROCFS_FILE_TYPE   },
+#endif
+
+#ifndef CONFIG_FS_PROCFS_EXCLUDE_METRICS
+  { "metrics.bin",   &metrics_operations,         PROCFS_FILE_TYPE   },
+#endif
+
+#if defined(CONFIG_MM_BENCHMARK) && !defined(CONFIG_FS_PROCFS_EXCLUDE_MMBENCH)
+  { "mmbench",       &mmbench_operations,         PROCFS_FILE_TYPE   },
+#endif
+
 #if defined(CONFIG_MODULE) && !defined(CONFIG_FS_PROCFS_EXCLUDE_MODULE)
   { "modules",       &module_operations,          PROCFS_FILE_TYPE   },
 #endif
 
+#if defined(CONFIG_SCHED_PROFILE)
+  { "profile",       &profile_operations,         PROCFS_FILE_TYPE   },
+#endif
+
 #ifndef CONFIG_FS_PROCFS_EXCLUDE_BLOCKS
   { "fs/blocks",     &mount_procfsoperations,     PROCFS_FILE_TYPE   },
 #endif
@@ -189,6 +225,10 @@ static const struct procfs_entry_s g_procfs_entries[] =
 #if !defined(CONFIG_FS_PROCFS_EXCLUDE_VERSION)
   { "version",       &version_operations,         PROCFS_FILE_TYPE   },
 #endif
+
+#if !defined(CONFIG_FS_PROCFS_EXCLUDE_WDOG)
+  { "wdog",          &wdog_operations,            PROCFS_FILE_TYPE   },
+#endif
 };
 
 #ifdef CONFIG_FS_PROCFS_REGISTER
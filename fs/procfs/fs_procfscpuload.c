@@ -66,10 +66,21 @@
  * Pre-processor Definitions
  ****************************************************************************/
 /* Determines the size of an intermediate buffer that must be large enough
- * to handle the longest line generated by this logic.
+ * to handle the longest line generated by this logic.  With the cycle
+ * accounting, one additional line is generated for each CPU.
  */
 
-#define CPULOAD_LINELEN 16
+#ifdef CONFIG_SMP
+#  define CPULOAD_NCPUS CONFIG_SMP_NCPUS
+#else
+#  define CPULOAD_NCPUS 1
+#endif
+
+#ifdef CONFIG_SCHED_CPULOAD_CYCLES
+#  define CPULOAD_LINELEN (16 + 40 * CPULOAD_NCPUS)
+#else
+#  define CPULOAD_LINELEN 16
+#endif
 
 /****************************************************************************
  * Private Types
@@ -195,6 +206,28 @@ static int cpuload_close(FAR struct file *filep)
   return OK;
 }
 
+/****************************************************************************
+ * Name: cpuload_permille
+ *
+ * Description:
+ *   Return part / total in units of 0.1%.  The cycle counts may be too
+ *   large to be multiplied by 1000 in 32 bits.
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_SCHED_CPULOAD_CYCLES
+static uint32_t cpuload_permille(uint32_t part, uint32_t total)
+{
+  while (total > UINT32_MAX / 1000)
+    {
+      part  >>= 1;
+      total >>= 1;
+    }
+
+  return total > 0 ? (1000 * part) / total : 0;
+}
+#endif
+
 /****************************************************************************
  * Name: cpuload_read
  ****************************************************************************/
@@ -223,6 +256,47 @@ static ssize_t cpuload_read(FAR struct file *filep, FAR char *buffer,
 
   if (filep->f_pos == 0)
     {
+#ifdef CONFIG_SCHED_CPULOAD_CYCLES
+      struct cpuload_cpu_s cpuload[CPULOAD_NCPUS];
+      uint32_t total = 0;
+      uint32_t idle  = 0;
+      uint32_t busy;
+      uint32_t irq;
+      int cpu;
+
+      /* Sample the accounting of all CPUs.  The total load is the share of
+       * the time that was not spent in the IDLE threads.
+       */
+
+      for (cpu = 0; cpu < CPULOAD_NCPUS; cpu++)
+        {
+          DEBUGVERIFY(clock_cpuload_cpu(cpu, &cpuload[cpu]));
+          total += cpuload[cpu].total;
+          idle  += cpuload[cpu].idle;
+        }
+
+      busy     = total > 0 ? 1000 - cpuload_permille(idle, total) : 0;
+      linesize = snprintf(attr->line, CPULOAD_LINELEN, "%3d.%01d%%\n",
+                          busy / 10, busy % 10);
+
+      /* Then the time that each CPU spent outside of its IDLE thread and
+       * the part of that time that was spent in interrupt handlers.
+       */
+
+      for (cpu = 0; cpu < CPULOAD_NCPUS; cpu++)
+        {
+          busy = cpuload[cpu].total > 0 ?
+                 1000 - cpuload_permille(cpuload[cpu].idle,
+                                         cpuload[cpu].total) : 0;
+          irq  = cpuload_permille(cpuload[cpu].irq, cpuload[cpu].total);
+
+          linesize += snprintf(&attr->line[linesize],
+                               CPULOAD_LINELEN - linesize,
+                               "cpu%d busy %3d.%01d%% irq %3d.%01d%%\n",
+                               cpu, busy / 10, busy % 10,
+                               irq / 10, irq % 10);
+        }
+#else
       struct cpuload_s cpuload;
       uint32_t intpart;
       uint32_t fracpart;
@@ -254,6 +328,7 @@ static ssize_t cpuload_read(FAR struct file *filep, FAR char *buffer,
 
       linesize = snprintf(attr->line, CPULOAD_LINELEN, "%3d.%01d%%\n",
                           intpart, fracpart);
+#endif
 
       /* Save the linesize in case we are re-entered with f_pos > 0 */
 
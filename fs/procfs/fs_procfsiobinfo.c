@@ -150,6 +150,9 @@ static FAR const char *g_iob_user_names[] =
 #ifdef CONFIG_NET_IPFORWARD
   "ipforward",
 #endif
+#ifdef CONFIG_NETDEV_RXQUEUE
+  "rxqueue",
+#endif
 #ifdef CONFIG_WIRELESS_IEEE802154
   "rad802154",
 #endif
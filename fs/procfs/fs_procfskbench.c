@@ -0,0 +1,362 @@
+/****************************************************************************
+ * fs/procfs/fs_procfskbench.c
+ *
+ *   Copyright (C) 2020 Gregory Nutt. All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in
+ *    the documentation and/or other materials provided with the
+ *    distribution.
+ * 3. Neither the name NuttX nor the names of its contributors may be
+ *    used to endorse or promote products derived from this software
+ *    without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+ * FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE
+ * COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+ * INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,
+ * BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS
+ * OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED
+ * AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ * LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN
+ * ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ *
+ ****************************************************************************/
+
+/****************************************************************************
+ * Included Files
+ ****************************************************************************/
+
+#include <nuttx/config.h>
+
+#include <sys/types.h>
+#include <sys/stat.h>
+
+#include <stdint.h>
+#include <stdbool.h>
+#include <stdio.h>
+#include <string.h>
+#include <fcntl.h>
+#include <assert.h>
+#include <errno.h>
+#include <debug.h>
+
+#include <nuttx/kmalloc.h>
+#include <nuttx/kbench.h>
+#include <nuttx/fs/fs.h>
+#include <nuttx/fs/procfs.h>
+
+#if !defined(CONFIG_DISABLE_MOUNTPOINT) && defined(CONFIG_FS_PROCFS) && \
+    defined(CONFIG_SCHED_BENCHMARK) && \
+    !defined(CONFIG_FS_PROCFS_EXCLUDE_KBENCH)
+
+/****************************************************************************
+ * Pre-processor Definitions
+ ****************************************************************************/
+
+/* Determines the size of an intermediate buffer that must be large enough
+ * to handle the longest line generated by this logic.
+ */
+
+#define KBENCH_LINELEN 80
+
+/****************************************************************************
+ * Private Types
+ ****************************************************************************/
+
+/* This structure describes one open "file" */
+
+struct kbench_file_s
+{
+  struct procfs_file_s base;      /* Base open file structure */
+  char line[KBENCH_LINELEN];     /* Pre-allocated buffer for formatted lines */
+
+  /* The results of each benchmark, collected when the file is opened */
+
+  struct kbench_result_s result[KBENCH_NTESTS];
+  int ret[KBENCH_NTESTS];
+};
+
+/* This structure holds the state of one read operation */
+
+struct kbench_readstate_s
+{
+  FAR struct kbench_file_s *bench;    /* The open file */
+  FAR char *buffer;                    /* Remaining user buffer */
+  size_t buflen;                       /* Remaining size of the buffer */
+  size_t totalsize;                    /* Number of bytes returned */
+  off_t offset;                        /* Offset into the generated text */
+};
+
+/****************************************************************************
+ * Private Function Prototypes
+ ****************************************************************************/
+
+/* File system methods */
+
+static int     kbench_open(FAR struct file *filep, FAR const char *relpath,
+                 int oflags, mode_t mode);
+static int     kbench_close(FAR struct file *filep);
+static ssize_t kbench_read(FAR struct file *filep, FAR char *buffer,
+                 size_t buflen);
+static int     kbench_dup(FAR const struct file *oldp,
+                 FAR struct file *newp);
+static int     kbench_stat(FAR const char *relpath, FAR struct stat *buf);
+
+/****************************************************************************
+ * Public Data
+ ****************************************************************************/
+
+/* See fs_mount.c -- this structure is explicitly externed there.
+ * We use the old-fashioned kind of initializers so that this will compile
+ * with any compiler.
+ */
+
+const struct procfs_operations kbench_operations =
+{
+  kbench_open,   /* open */
+  kbench_close,  /* close */
+  kbench_read,   /* read */
+  NULL,           /* write */
+  kbench_dup,    /* dup */
+  NULL,           /* opendir */
+  NULL,           /* closedir */
+  NULL,           /* readdir */
+  NULL,           /* rewinddir */
+  kbench_stat    /* stat */
+};
+
+/****************************************************************************
+ * Private Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: kbench_copyline
+ *
+ * Description:
+ *   Copy the formatted line into the user buffer, honoring the file offset.
+ *
+ ****************************************************************************/
+
+static void kbench_copyline(FAR struct kbench_readstate_s *state,
+                             size_t linesize)
+{
+  size_t copysize;
+
+  if (state->totalsize < state->buflen)
+    {
+      copysize = procfs_memcpy(state->bench->line, linesize,
+                               state->buffer,
+                               state->buflen - state->totalsize,
+                               &state->offset);
+      state->buffer    += copysize;
+      state->totalsize += copysize;
+    }
+}
+
+/****************************************************************************
+ * Name: kbench_open
+ ****************************************************************************/
+
+static int kbench_open(FAR struct file *filep, FAR const char *relpath,
+                        int oflags, mode_t mode)
+{
+  FAR struct kbench_file_s *procfile;
+  int i;
+
+  finfo("Open '%s'\n", relpath);
+
+  /* PROCFS is read-only.  Any attempt to open with any kind of write
+   * access is not permitted.
+   *
+   * REVISIT:  Write-able proc files could be quite useful.
+   */
+
+  if ((oflags & O_WRONLY) != 0 || (oflags & O_RDONLY) == 0)
+    {
+      ferr("ERROR: Only O_RDONLY supported\n");
+      return -EACCES;
+    }
+
+  /* "kbench" is the only acceptable value for the relpath */
+
+  if (strcmp(relpath, "kbench") != 0)
+    {
+      ferr("ERROR: relpath is '%s'\n", relpath);
+      return -ENOENT;
+    }
+
+  /* Allocate a container to hold the file attributes */
+
+  procfile = (FAR struct kbench_file_s *)
+    kmm_zalloc(sizeof(struct kbench_file_s));
+  if (!procfile)
+    {
+      ferr("ERROR: Failed to allocate file attributes\n");
+      return -ENOMEM;
+    }
+
+  /* Run every benchmark now so that the report does not change while it
+   * is being read.
+   */
+
+  for (i = 0; i < KBENCH_NTESTS; i++)
+    {
+      procfile->ret[i] = kbench_run(i, &procfile->result[i]);
+    }
+
+  /* Save the attributes as the open-specific state in filep->f_priv */
+
+  filep->f_priv = (FAR void *)procfile;
+  return OK;
+}
+
+/****************************************************************************
+ * Name: kbench_close
+ ****************************************************************************/
+
+static int kbench_close(FAR struct file *filep)
+{
+  FAR struct kbench_file_s *procfile;
+
+  /* Recover our private data from the struct file instance */
+
+  procfile = (FAR struct kbench_file_s *)filep->f_priv;
+  DEBUGASSERT(procfile);
+
+  /* Release the file attributes structure */
+
+  kmm_free(procfile);
+  filep->f_priv = NULL;
+  return OK;
+}
+
+/****************************************************************************
+ * Name: kbench_read
+ ****************************************************************************/
+
+static ssize_t kbench_read(FAR struct file *filep, FAR char *buffer,
+                            size_t buflen)
+{
+  struct kbench_readstate_s state;
+  size_t linesize;
+  int i;
+
+  finfo("buffer=%p buflen=%d\n", buffer, (int)buflen);
+
+  DEBUGASSERT(filep != NULL && buffer != NULL && buflen > 0);
+
+  /* Recover our private data from the struct file instance */
+
+  state.bench     = (FAR struct kbench_file_s *)filep->f_priv;
+  state.buffer    = buffer;
+  state.buflen    = buflen;
+  state.totalsize = 0;
+  state.offset    = filep->f_pos;
+  DEBUGASSERT(state.bench);
+
+  /* The report is meant to be parsed by scripts:  A header line, then one
+   * comma-separated line per benchmark.  The status is zero or a negated
+   * errno value; -ENOSYS means that the benchmark is not configured.
+   */
+
+  linesize = snprintf(state.bench->line, KBENCH_LINELEN,
+                      "test,status,count,min_ns,avg_ns,max_ns,kib_s\n");
+  kbench_copyline(&state, linesize);
+
+  for (i = 0; i < KBENCH_NTESTS; i++)
+    {
+      FAR struct kbench_result_s *result = &state.bench->result[i];
+
+      linesize = snprintf(state.bench->line, KBENCH_LINELEN,
+                          "%s,%d,%lu,%lu,%lu,%lu,%lu\n", kbench_name(i),
+                          state.bench->ret[i],
+                          (unsigned long)result->kr_count,
+                          (unsigned long)result->kr_min,
+                          (unsigned long)result->kr_avg,
+                          (unsigned long)result->kr_max,
+                          (unsigned long)result->kr_kbps);
+      kbench_copyline(&state, linesize);
+    }
+
+  /* Update the file offset */
+
+  filep->f_pos += state.totalsize;
+  return state.totalsize;
+}
+
+/****************************************************************************
+ * Name: kbench_dup
+ *
+ * Description:
+ *   Duplicate open file data in the new file structure.
+ *
+ ****************************************************************************/
+
+static int kbench_dup(FAR const struct file *oldp, FAR struct file *newp)
+{
+  FAR struct kbench_file_s *oldattr;
+  FAR struct kbench_file_s *newattr;
+
+  finfo("Dup %p->%p\n", oldp, newp);
+
+  /* Recover our private data from the old struct file instance */
+
+  oldattr = (FAR struct kbench_file_s *)oldp->f_priv;
+  DEBUGASSERT(oldattr);
+
+  /* Allocate a new container to hold the task and attribute selection */
+
+  newattr = (FAR struct kbench_file_s *)
+    kmm_malloc(sizeof(struct kbench_file_s));
+  if (!newattr)
+    {
+      ferr("ERROR: Failed to allocate file attributes\n");
+      return -ENOMEM;
+    }
+
+  /* The copy the file attributes from the old attributes to the new */
+
+  memcpy(newattr, oldattr, sizeof(struct kbench_file_s));
+
+  /* Save the new attributes in the new file structure */
+
+  newp->f_priv = (FAR void *)newattr;
+  return OK;
+}
+
+/****************************************************************************
+ * Name: kbench_stat
+ *
+ * Description: Return information about a file or directory
+ *
+ ****************************************************************************/
+
+static int kbench_stat(FAR const char *relpath, FAR struct stat *buf)
+{
+  /* "kbench" is the only acceptable value for the relpath */
+
+  if (strcmp(relpath, "kbench") != 0)
+    {
+      ferr("ERROR: relpath is '%s'\n", relpath);
+      return -ENOENT;
+    }
+
+  /* "kbench" is the name for a read-only file */
+
+  memset(buf, 0, sizeof(struct stat));
+  buf->st_mode = S_IFREG | S_IROTH | S_IRGRP | S_IRUSR;
+  return OK;
+}
+
+#endif /* !CONFIG_DISABLE_MOUNTPOINT && CONFIG_FS_PROCFS &&
+        * CONFIG_SCHED_BENCHMARK && !CONFIG_FS_PROCFS_EXCLUDE_KBENCH */
@@ -0,0 +1,626 @@
+/****************************************************************************
+ * fs/procfs/fs_procfslatency.c
+ *
+ *   Copyright (C) 2020 Gregory Nutt. All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in
+ *    the documentation and/or other materials provided with the
+ *    distribution.
+ * 3. Neither the name NuttX nor the names of its contributors may be
+ *    used to endorse or promote products derived from this software
+ *    without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+ * FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE
+ * COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+ * INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,
+ * BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS
+ * OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED
+ * AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ * LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN
+ * ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ *
+ ****************************************************************************/
+
+/****************************************************************************
+ * Included Files
+ ****************************************************************************/
+
+#include <nuttx/config.h>
+
+#include <sys/types.h>
+#include <sys/stat.h>
+
+#include <stdint.h>
+#include <stdbool.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include <fcntl.h>
+#include <assert.h>
+#include <errno.h>
+#include <debug.h>
+
+#include <nuttx/irq.h>
+#include <nuttx/arch.h>
+#include <nuttx/clock.h>
+#include <nuttx/sched.h>
+#include <nuttx/kmalloc.h>
+#include <nuttx/fs/fs.h>
+#include <nuttx/fs/procfs.h>
+
+#if !defined(CONFIG_DISABLE_MOUNTPOINT) && defined(CONFIG_FS_PROCFS) && \
+     defined(CONFIG_SCHED_LATENCY)
+
+/****************************************************************************
+ * Pre-processor Definitions
+ ****************************************************************************/
+
+/* Determines the size of an intermediate buffer that must be large enough
+ * to handle the longest line generated by this logic.
+ */
+
+#define LATENCY_LINELEN 80
+
+/* The longest command that may be written to the file */
+
+#define LATENCY_CMDLEN  32
+
+/****************************************************************************
+ * Private Types
+ ****************************************************************************/
+
+/* This structure describes one open "file" */
+
+struct latency_file_s
+{
+  struct procfs_file_s base;      /* Base open file structure */
+  unsigned int npids;             /* Number of valid entries in pid[] */
+  pid_t pid[CONFIG_MAX_TASKS];    /* Snapshot of all active thread IDs */
+  char line[LATENCY_LINELEN];     /* Pre-allocated buffer for formatted lines */
+};
+
+/* This structure holds the state of one read operation */
+
+struct latency_readstate_s
+{
+  FAR struct latency_file_s *latfile;  /* The open file */
+  FAR char *buffer;                    /* Remaining user buffer */
+  size_t buflen;                       /* Remaining size of the buffer */
+  size_t totalsize;                    /* Number of bytes returned */
+  off_t offset;                        /* Offset into the generated text */
+};
+
+/****************************************************************************
+ * Private Function Prototypes
+ ****************************************************************************/
+
+/* File system methods */
+
+static int     latency_open(FAR struct file *filep, FAR const char *relpath,
+                 int oflags, mode_t mode);
+static int     latency_close(FAR struct file *filep);
+static ssize_t latency_read(FAR struct file *filep, FAR char *buffer,
+                 size_t buflen);
+static ssize_t latency_write(FAR struct file *filep, FAR const char *buffer,
+                 size_t buflen);
+static int     latency_dup(FAR const struct file *oldp,
+                 FAR struct file *newp);
+static int     latency_stat(FAR const char *relpath, FAR struct stat *buf);
+
+/****************************************************************************
+ * Private Data
+ ****************************************************************************/
+
+static FAR const char *g_latency_source[LATENCY_NSOURCES] =
+{
+  "task",         /* LATENCY_SOURCE_TASK */
+  "irq"           /* LATENCY_SOURCE_IRQ */
+};
+
+/****************************************************************************
+ * Public Data
+ ****************************************************************************/
+
+/* See fs_mount.c -- this structure is explicitly externed there.
+ * We use the old-fashioned kind of initializers so that this will compile
+ * with any compiler.
+ */
+
+const struct procfs_operations latency_operations =
+{
+  latency_open,   /* open */
+  latency_close,  /* close */
+  latency_read,   /* read */
+  latency_write,  /* write */
+  latency_dup,    /* dup */
+  NULL,           /* opendir */
+  NULL,           /* closedir */
+  NULL,           /* readdir */
+  NULL,           /* rewinddir */
+  latency_stat    /* stat */
+};
+
+/****************************************************************************
+ * Private Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: latency_copyline
+ *
+ * Description:
+ *   Copy the formatted line into the user buffer, honoring the file offset.
+ *
+ ****************************************************************************/
+
+static void latency_copyline(FAR struct latency_readstate_s *state,
+                             size_t linesize)
+{
+  size_t copysize;
+
+  if (state->totalsize < state->buflen)
+    {
+      copysize = procfs_memcpy(state->latfile->line, linesize,
+                               state->buffer,
+                               state->buflen - state->totalsize,
+                               &state->offset);
+      state->buffer    += copysize;
+      state->totalsize += copysize;
+    }
+}
+
+/****************************************************************************
+ * Name: latency_bound
+ *
+ * Description:
+ *   Return the largest latency held in a histogram bucket.
+ *
+ ****************************************************************************/
+
+static uint32_t latency_bound(int ndx)
+{
+  return ndx >= LATENCY_NBUCKETS - 1 ? UINT32_MAX :
+         ((uint32_t)1 << (ndx + 1)) - 1;
+}
+
+/****************************************************************************
+ * Name: latency_percentile
+ *
+ * Description:
+ *   Return an upper bound of the given percentile (in tenths of a percent)
+ *   of the latencies in a histogram, in microseconds.
+ *
+ ****************************************************************************/
+
+static unsigned long
+latency_percentile(FAR const struct latency_hist_s *hist, uint32_t permille)
+{
+  uint64_t target;
+  uint64_t sum;
+  uint32_t bound;
+  int ndx;
+
+  /* The sample that must be reached, rounded up */
+
+  target = ((uint64_t)hist->count * permille + 999) / 1000;
+  sum    = 0;
+
+  for (ndx = 0; ndx < LATENCY_NBUCKETS - 1; ndx++)
+    {
+      sum += hist->bucket[ndx];
+      if (sum >= target)
+        {
+          break;
+        }
+    }
+
+  /* No sample is larger than the maximum */
+
+  bound = latency_bound(ndx);
+  if (bound > hist->max)
+    {
+      bound = hist->max;
+    }
+
+  return sched_latency_usec(bound);
+}
+
+/****************************************************************************
+ * Name: latency_summary
+ *
+ * Description:
+ *   Generate one summary line for a histogram.
+ *
+ ****************************************************************************/
+
+static void latency_summary(FAR struct latency_readstate_s *state,
+                            size_t linesize,
+                            FAR const struct latency_hist_s *hist)
+{
+  FAR char *line = state->latfile->line;
+
+  linesize += snprintf(&line[linesize], LATENCY_LINELEN - linesize,
+                       "%9lu%9lu%9lu%9lu%9lu\n",
+                       (unsigned long)hist->count,
+                       latency_percentile(hist, 500),
+                       latency_percentile(hist, 900),
+                       latency_percentile(hist, 990),
+                       (unsigned long)sched_latency_usec(hist->max));
+
+  latency_copyline(state, linesize);
+}
+
+/****************************************************************************
+ * Name: latency_histogram
+ *
+ * Description:
+ *   Generate one line for each non-empty bucket of a histogram.
+ *
+ ****************************************************************************/
+
+static void latency_histogram(FAR struct latency_readstate_s *state,
+                              FAR const struct latency_hist_s *hist)
+{
+  struct timespec ts;
+  size_t linesize;
+  int ndx;
+
+  for (ndx = 0; ndx < LATENCY_NBUCKETS; ndx++)
+    {
+      if (hist->bucket[ndx] == 0)
+        {
+          continue;
+        }
+
+      up_critmon_convert(latency_bound(ndx), &ts);
+
+      linesize = snprintf(state->latfile->line, LATENCY_LINELEN,
+                          "  <= %7lu.%03lu us%12lu\n",
+                          (unsigned long)ts.tv_sec * USEC_PER_SEC +
+                          (unsigned long)ts.tv_nsec / NSEC_PER_USEC,
+                          (unsigned long)(ts.tv_nsec % NSEC_PER_USEC),
+                          (unsigned long)hist->bucket[ndx]);
+
+      latency_copyline(state, linesize);
+    }
+}
+
+/****************************************************************************
+ * Name: latency_enum
+ *
+ * Description:
+ *   sched_foreach() callback that takes a snapshot of the active threads.
+ *
+ ****************************************************************************/
+
+static void latency_enum(FAR struct tcb_s *tcb, FAR void *arg)
+{
+  FAR struct latency_file_s *latfile = (FAR struct latency_file_s *)arg;
+
+  DEBUGASSERT(latfile->npids < CONFIG_MAX_TASKS);
+  latfile->pid[latfile->npids++] = tcb->pid;
+}
+
+/****************************************************************************
+ * Name: latency_open
+ ****************************************************************************/
+
+static int latency_open(FAR struct file *filep, FAR const char *relpath,
+                        int oflags, mode_t mode)
+{
+  FAR struct latency_file_s *latfile;
+
+  finfo("Open '%s'\n", relpath);
+
+  /* "latency" is the only acceptable value for the relpath.  It may be
+   * opened for reading (the histograms) and for writing (commands).
+   */
+
+  if (strcmp(relpath, "latency") != 0)
+    {
+      ferr("ERROR: relpath is '%s'\n", relpath);
+      return -ENOENT;
+    }
+
+  /* Allocate a container to hold the file attributes */
+
+  latfile = (FAR struct latency_file_s *)
+    kmm_zalloc(sizeof(struct latency_file_s));
+  if (!latfile)
+    {
+      ferr("ERROR: Failed to allocate file attributes\n");
+      return -ENOMEM;
+    }
+
+  /* Save the attributes as the open-specific state in filep->f_priv */
+
+  filep->f_priv = (FAR void *)latfile;
+  return OK;
+}
+
+/****************************************************************************
+ * Name: latency_close
+ ****************************************************************************/
+
+static int latency_close(FAR struct file *filep)
+{
+  FAR struct latency_file_s *latfile;
+
+  /* Recover our private data from the struct file instance */
+
+  latfile = (FAR struct latency_file_s *)filep->f_priv;
+  DEBUGASSERT(latfile);
+
+  /* Release the file attributes structure */
+
+  kmm_free(latfile);
+  filep->f_priv = NULL;
+  return OK;
+}
+
+/****************************************************************************
+ * Name: latency_read
+ ****************************************************************************/
+
+static ssize_t latency_read(FAR struct file *filep, FAR char *buffer,
+                            size_t buflen)
+{
+  struct latency_readstate_s state;
+  struct latency_trigger_s trigger;
+  struct latency_hist_s hist;
+  FAR struct tcb_s *tcb;
+  irqstate_t flags;
+  size_t linesize;
+  uint8_t priority;
+  unsigned int i;
+  int group;
+  int source;
+
+  finfo("buffer=%p buflen=%d\n", buffer, (int)buflen);
+
+  DEBUGASSERT(filep != NULL && buffer != NULL && buflen > 0);
+
+  /* Recover our private data from the struct file instance */
+
+  state.latfile   = (FAR struct latency_file_s *)filep->f_priv;
+  state.buffer    = buffer;
+  state.buflen    = buflen;
+  state.totalsize = 0;
+  state.offset    = filep->f_pos;
+  DEBUGASSERT(state.latfile);
+
+  /* The state of the threshold trigger */
+
+  flags = enter_critical_section();
+  memcpy(&trigger, &g_latency_trigger, sizeof(struct latency_trigger_s));
+  leave_critical_section(flags);
+
+  linesize = snprintf(state.latfile->line, LATENCY_LINELEN,
+                      "Threshold: %lu us%s\n",
+                      trigger.threshold == 0 ? 0ul :
+                      (unsigned long)sched_latency_usec(trigger.threshold),
+                      trigger.stop ? " stop" : "");
+
+  latency_copyline(&state, linesize);
+
+  if (trigger.count > 0)
+    {
+      linesize = snprintf(state.latfile->line, LATENCY_LINELEN,
+                          "Triggered: %lu, last PID %d PRI %u %lu us%s\n",
+                          (unsigned long)trigger.count, (int)trigger.pid,
+                          trigger.priority,
+                          (unsigned long)sched_latency_usec(trigger.latency),
+                          trigger.stopped ? " (stopped)" : "");
+
+      latency_copyline(&state, linesize);
+    }
+
+  /* The summary and the histogram of each priority group and source */
+
+  linesize = snprintf(state.latfile->line, LATENCY_LINELEN,
+                      "\n%-16s%9s%9s%9s%9s%9s\n", "PRIORITY SOURCE",
+                      "COUNT", "P50(us)", "P90(us)", "P99(us)", "MAX(us)");
+
+  latency_copyline(&state, linesize);
+
+  for (group = 0; group < LATENCY_NGROUPS; group++)
+    {
+      for (source = 0; source < LATENCY_NSOURCES; source++)
+        {
+          flags = enter_critical_section();
+          memcpy(&hist, &g_latency_hist[group][source],
+                 sizeof(struct latency_hist_s));
+          leave_critical_section(flags);
+
+          if (hist.count == 0)
+            {
+              continue;
+            }
+
+          linesize = snprintf(state.latfile->line, LATENCY_LINELEN,
+                              "%3d-%-3d  %-6s ",
+                              group * CONFIG_SCHED_LATENCY_PRIOGROUP,
+                              (group + 1) * CONFIG_SCHED_LATENCY_PRIOGROUP -
+                              1, g_latency_source[source]);
+
+          latency_summary(&state, linesize, &hist);
+          latency_histogram(&state, &hist);
+        }
+    }
+
+  /* The summary of each thread */
+
+  linesize = snprintf(state.latfile->line, LATENCY_LINELEN,
+                      "\n%-16s%9s%9s%9s%9s%9s\n", "PID   PRI",
+                      "COUNT", "P50(us)", "P90(us)", "P99(us)", "MAX(us)");
+
+  latency_copyline(&state, linesize);
+
+  state.latfile->npids = 0;
+  sched_foreach(latency_enum, state.latfile);
+
+  for (i = 0; i < state.latfile->npids; i++)
+    {
+      /* The thread may have exited since the snapshot was taken */
+
+      flags = enter_critical_section();
+      tcb   = sched_gettcb(state.latfile->pid[i]);
+      if (tcb != NULL)
+        {
+          memcpy(&hist, &tcb->lat_hist, sizeof(struct latency_hist_s));
+          priority = tcb->sched_priority;
+        }
+
+      leave_critical_section(flags);
+
+      if (tcb == NULL || hist.count == 0)
+        {
+          continue;
+        }
+
+      linesize = snprintf(state.latfile->line, LATENCY_LINELEN,
+                          "%5d %3u      ", (int)state.latfile->pid[i],
+                          priority);
+
+      latency_summary(&state, linesize, &hist);
+    }
+
+  /* Update the file offset */
+
+  filep->f_pos += state.totalsize;
+  return state.totalsize;
+}
+
+/****************************************************************************
+ * Name: latency_write
+ *
+ * Description:
+ *   Accepts the commands:
+ *
+ *     reset                    - Clear all histograms and the trigger
+ *     threshold <usec> [stop]  - Set the threshold trigger.  Zero disables
+ *
+ ****************************************************************************/
+
+static ssize_t latency_write(FAR struct file *filep, FAR const char *buffer,
+                             size_t buflen)
+{
+  char cmd[LATENCY_CMDLEN];
+  FAR char *endptr;
+  unsigned long usec;
+  size_t len;
+
+  DEBUGASSERT(filep != NULL && buffer != NULL);
+
+  /* Get a NUL-terminated copy of the command */
+
+  len = buflen < LATENCY_CMDLEN ? buflen : LATENCY_CMDLEN - 1;
+  memcpy(cmd, buffer, len);
+  cmd[len] = '\0';
+
+  if (strncmp(cmd, "reset", 5) == 0)
+    {
+      sched_latency_reset();
+    }
+  else if (strncmp(cmd, "threshold", 9) == 0)
+    {
+      usec = strtoul(&cmd[9], &endptr, 10);
+      if (endptr == &cmd[9])
+        {
+          return -EINVAL;
+        }
+
+      while (*endptr == ' ')
+        {
+          endptr++;
+        }
+
+      sched_latency_threshold((uint32_t)usec,
+                              strncmp(endptr, "stop", 4) == 0);
+    }
+  else
+    {
+      ferr("ERROR: Unrecognized command: %s\n", cmd);
+      return -EINVAL;
+    }
+
+  return buflen;
+}
+
+/****************************************************************************
+ * Name: latency_dup
+ *
+ * Description:
+ *   Duplicate open file data in the new file structure.
+ *
+ ****************************************************************************/
+
+static int latency_dup(FAR const struct file *oldp, FAR struct file *newp)
+{
+  FAR struct latency_file_s *oldattr;
+  FAR struct latency_file_s *newattr;
+
+  finfo("Dup %p->%p\n", oldp, newp);
+
+  /* Recover our private data from the old struct file instance */
+
+  oldattr = (FAR struct latency_file_s *)oldp->f_priv;
+  DEBUGASSERT(oldattr);
+
+  /* Allocate a new container to hold the task and attribute selection */
+
+  newattr = (FAR struct latency_file_s *)
+    kmm_malloc(sizeof(struct latency_file_s));
+  if (!newattr)
+    {
+      ferr("ERROR: Failed to allocate file attributes\n");
+      return -ENOMEM;
+    }
+
+  /* The copy the file attributes from the old attributes to the new */
+
+  memcpy(newattr, oldattr, sizeof(struct latency_file_s));
+
+  /* Save the new attributes in the new file structure */
+
+  newp->f_priv = (FAR void *)newattr;
+  return OK;
+}
+
+/****************************************************************************
+ * Name: latency_stat
+ *
+ * Description: Return information about a file or directory
+ *
+ ****************************************************************************/
+
+static int latency_stat(FAR const char *relpath, FAR struct stat *buf)
+{
+  /* "latency" is the only acceptable value for the relpath */
+
+  if (strcmp(relpath, "latency") != 0)
+    {
+      ferr("ERROR: relpath is '%s'\n", relpath);
+      return -ENOENT;
+    }
+
+  /* "latency" is the name for a read/write file */
+
+  memset(buf, 0, sizeof(struct stat));
+  buf->st_mode = S_IFREG | S_IROTH | S_IRGRP | S_IRUSR | S_IWUSR;
+  return OK;
+}
+
+#endif /* !CONFIG_DISABLE_MOUNTPOINT && CONFIG_FS_PROCFS &&
+        * CONFIG_SCHED_LATENCY */
@@ -0,0 +1,368 @@
+/****************************************************************************
+ * fs/procfs/fs_procfsmemdump.c
+ *
+ *   Copyright (C) 2020 Gregory Nutt. All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in
+ *    the documentation and/or other materials provided with the
+ *    distribution.
+ * 3. Neither the name NuttX nor the names of its contributors may be
+ *    used to endorse or promote products derived from this software
+ *    without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+ * FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE
+ * COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+ * INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,
+ * BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS
+ * OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED
+ * AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ * LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN
+ * ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ *
+ ****************************************************************************/
+
+/****************************************************************************
+ * Included Files
+ ****************************************************************************/
+
+#include <nuttx/config.h>
+
+#include <sys/types.h>
+#include <sys/stat.h>
+
+#include <stdint.h>
+#include <stdbool.h>
+#include <stdio.h>
+#include <string.h>
+#include <fcntl.h>
+#include <assert.h>
+#include <errno.h>
+#include <debug.h>
+
+#include <nuttx/kmalloc.h>
+#include <nuttx/mm/mm.h>
+#include <nuttx/fs/fs.h>
+#include <nuttx/fs/procfs.h>
+
+#if !defined(CONFIG_DISABLE_MOUNTPOINT) && defined(CONFIG_FS_PROCFS) && \
+    defined(CONFIG_MM_HEAP_PROFILE) && \
+    !defined(CONFIG_FS_PROCFS_EXCLUDE_MEMDUMP)
+
+/****************************************************************************
+ * Pre-processor Definitions
+ ****************************************************************************/
+
+/* Determines the size of an intermediate buffer that must be large enough
+ * to handle the longest line generated by this logic.
+ */
+
+#define MEMDUMP_LINELEN 128
+
+/****************************************************************************
+ * Private Types
+ ****************************************************************************/
+
+/* This structure describes one open "file" */
+
+struct memdump_file_s
+{
+  struct procfs_file_s base;      /* Base open file structure */
+  char line[MEMDUMP_LINELEN];     /* Pre-allocated buffer for formatted lines */
+};
+
+/* This structure holds the state of one read operation */
+
+struct memdump_readstate_s
+{
+  FAR struct memdump_file_s *dumpfile; /* The open file */
+  FAR char *buffer;                    /* Remaining user buffer */
+  size_t buflen;                       /* Remaining size of the buffer */
+  size_t totalsize;                    /* Number of bytes returned */
+  off_t offset;                        /* Offset into the generated text */
+};
+
+/****************************************************************************
+ * Private Function Prototypes
+ ****************************************************************************/
+
+/* File system methods */
+
+static int     memdump_open(FAR struct file *filep, FAR const char *relpath,
+                 int oflags, mode_t mode);
+static int     memdump_close(FAR struct file *filep);
+static ssize_t memdump_read(FAR struct file *filep, FAR char *buffer,
+                 size_t buflen);
+static int     memdump_dup(FAR const struct file *oldp,
+                 FAR struct file *newp);
+static int     memdump_stat(FAR const char *relpath, FAR struct stat *buf);
+
+/****************************************************************************
+ * Public Data
+ ****************************************************************************/
+
+/* See fs_mount.c -- this structure is explicitly externed there.
+ * We use the old-fashioned kind of initializers so that this will compile
+ * with any compiler.
+ */
+
+const struct procfs_operations memdump_operations =
+{
+  memdump_open,   /* open */
+  memdump_close,  /* close */
+  memdump_read,   /* read */
+  NULL,           /* write */
+  memdump_dup,    /* dup */
+  NULL,           /* opendir */
+  NULL,           /* closedir */
+  NULL,           /* readdir */
+  NULL,           /* rewinddir */
+  memdump_stat    /* stat */
+};
+
+/****************************************************************************
+ * Private Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: memdump_copyline
+ *
+ * Description:
+ *   Copy the formatted line into the user buffer, honoring the file offset.
+ *
+ ****************************************************************************/
+
+static void memdump_copyline(FAR struct memdump_readstate_s *state,
+                             size_t linesize)
+{
+  size_t copysize;
+
+  if (state->totalsize < state->buflen)
+    {
+      copysize = procfs_memcpy(state->dumpfile->line, linesize,
+                               state->buffer,
+                               state->buflen - state->totalsize,
+                               &state->offset);
+      state->buffer    += copysize;
+      state->totalsize += copysize;
+    }
+}
+
+/****************************************************************************
+ * Name: memdump_readnode
+ *
+ * Description:
+ *   mm_memdump() callback that generates the line for one allocated chunk.
+ *   This runs with the heap semaphore held so it must not allocate memory.
+ *
+ ****************************************************************************/
+
+static void memdump_readnode(FAR struct mm_allocnode_s *node, FAR void *arg)
+{
+  FAR struct memdump_readstate_s *state = arg;
+  size_t linesize;
+  int i;
+
+  linesize = snprintf(state->dumpfile->line, MEMDUMP_LINELEN,
+                      "%p %8lu %5d",
+                      (FAR char *)node + SIZEOF_MM_ALLOCNODE,
+                      (unsigned long)(node->size - SIZEOF_MM_ALLOCNODE),
+                      (int)node->pid);
+
+  for (i = 0; i < MM_BACKTRACE_DEPTH; i++)
+    {
+      linesize += snprintf(&state->dumpfile->line[linesize],
+                           MEMDUMP_LINELEN - linesize, " %p",
+                           node->backtrace[i]);
+    }
+
+  linesize += snprintf(&state->dumpfile->line[linesize],
+                       MEMDUMP_LINELEN - linesize, "\n");
+
+  memdump_copyline(state, linesize);
+}
+
+/****************************************************************************
+ * Name: memdump_open
+ ****************************************************************************/
+
+static int memdump_open(FAR struct file *filep, FAR const char *relpath,
+                        int oflags, mode_t mode)
+{
+  FAR struct memdump_file_s *procfile;
+
+  finfo("Open '%s'\n", relpath);
+
+  /* PROCFS is read-only.  Any attempt to open with any kind of write
+   * access is not permitted.
+   *
+   * REVISIT:  Write-able proc files could be quite useful.
+   */
+
+  if ((oflags & O_WRONLY) != 0 || (oflags & O_RDONLY) == 0)
+    {
+      ferr("ERROR: Only O_RDONLY supported\n");
+      return -EACCES;
+    }
+
+  /* "memdump" is the only acceptable value for the relpath */
+
+  if (strcmp(relpath, "memdump") != 0)
+    {
+      ferr("ERROR: relpath is '%s'\n", relpath);
+      return -ENOENT;
+    }
+
+  /* Allocate a container to hold the file attributes */
+
+  procfile = (FAR struct memdump_file_s *)
+    kmm_zalloc(sizeof(struct memdump_file_s));
+  if (!procfile)
+    {
+      ferr("ERROR: Failed to allocate file attributes\n");
+      return -ENOMEM;
+    }
+
+  /* Save the attributes as the open-specific state in filep->f_priv */
+
+  filep->f_priv = (FAR void *)procfile;
+  return OK;
+}
+
+/****************************************************************************
+ * Name: memdump_close
+ ****************************************************************************/
+
+static int memdump_close(FAR struct file *filep)
+{
+  FAR struct memdump_file_s *procfile;
+
+  /* Recover our private data from the struct file instance */
+
+  procfile = (FAR struct memdump_file_s *)filep->f_priv;
+  DEBUGASSERT(procfile);
+
+  /* Release the file attributes structure */
+
+  kmm_free(procfile);
+  filep->f_priv = NULL;
+  return OK;
+}
+
+/****************************************************************************
+ * Name: memdump_read
+ ****************************************************************************/
+
+static ssize_t memdump_read(FAR struct file *filep, FAR char *buffer,
+                            size_t buflen)
+{
+  struct memdump_readstate_s state;
+  size_t linesize;
+
+  finfo("buffer=%p buflen=%d\n", buffer, (int)buflen);
+
+  DEBUGASSERT(filep != NULL && buffer != NULL && buflen > 0);
+
+  /* Recover our private data from the struct file instance */
+
+  state.dumpfile  = (FAR struct memdump_file_s *)filep->f_priv;
+  state.buffer    = buffer;
+  state.buflen    = buflen;
+  state.totalsize = 0;
+  state.offset    = filep->f_pos;
+  DEBUGASSERT(state.dumpfile);
+
+  /* The first line is the headers */
+
+  linesize = snprintf(state.dumpfile->line, MEMDUMP_LINELEN,
+                      "%-10s %8s %5s %s\n",
+                      "ADDRESS", "SIZE", "PID", "BACKTRACE");
+
+  memdump_copyline(&state, linesize);
+
+  /* Then one line for each allocated chunk in the user heap */
+
+  mm_memdump(&g_mmheap, memdump_readnode, &state);
+
+  /* Update the file offset */
+
+  filep->f_pos += state.totalsize;
+  return state.totalsize;
+}
+
+/****************************************************************************
+ * Name: memdump_dup
+ *
+ * Description:
+ *   Duplicate open file data in the new file structure.
+ *
+ ****************************************************************************/
+
+static int memdump_dup(FAR const struct file *oldp, FAR struct file *newp)
+{
+  FAR struct memdump_file_s *oldattr;
+  FAR struct memdump_file_s *newattr;
+
+  finfo("Dup %p->%p\n", oldp, newp);
+
+  /* Recover our private data from the old struct file instance */
+
+  oldattr = (FAR struct memdump_file_s *)oldp->f_priv;
+  DEBUGASSERT(oldattr);
+
+  /* Allocate a new container to hold the task and attribute selection */
+
+  newattr = (FAR struct memdump_file_s *)
+    kmm_malloc(sizeof(struct memdump_file_s));
+  if (!newattr)
+    {
+      ferr("ERROR: Failed to allocate file attributes\n");
+      return -ENOMEM;
+    }
+
+  /* The copy the file attributes from the old attributes to the new */
+
+  memcpy(newattr, oldattr, sizeof(struct memdump_file_s));
+
+  /* Save the new attributes in the new file structure */
+
+  newp->f_priv = (FAR void *)newattr;
+  return OK;
+}
+
+/****************************************************************************
+ * Name: memdump_stat
+ *
+ * Description: Return information about a file or directory
+ *
+ ****************************************************************************/
+
+static int memdump_stat(FAR const char *relpath, FAR struct stat *buf)
+{
+  /* "memdump" is the only acceptable value for the relpath */
+
+  if (strcmp(relpath, "memdump") != 0)
+    {
+      ferr("ERROR: relpath is '%s'\n", relpath);
+      return -ENOENT;
+    }
+
+  /* "memdump" is the name for a read-only file */
+
+  memset(buf, 0, sizeof(struct stat));
+  buf->st_mode = S_IFREG | S_IROTH | S_IRGRP | S_IRUSR;
+  return OK;
+}
+
+#endif /* !CONFIG_DISABLE_MOUNTPOINT && CONFIG_FS_PROCFS &&
+        * CONFIG_MM_HEAP_PROFILE && !CONFIG_FS_PROCFS_EXCLUDE_MEMDUMP */
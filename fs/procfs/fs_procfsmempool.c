@@ -0,0 +1,364 @@
+/****************************************************************************
+ * fs/procfs/fs_procfsmempool.c
+ *
+ *   Copyright (C) 2020 Gregory Nutt. All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in
+ *    the documentation and/or other materials provided with the
+ *    distribution.
+ * 3. Neither the name NuttX nor the names of its contributors may be
+ *    used to endorse or promote products derived from this software
+ *    without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+ * FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE
+ * COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+ * INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,
+ * BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS
+ * OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED
+ * AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ * LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN
+ * ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ *
+ ****************************************************************************/
+
+/****************************************************************************
+ * Included Files
+ ****************************************************************************/
+
+#include <nuttx/config.h>
+
+#include <sys/types.h>
+#include <sys/stat.h>
+
+#include <stdint.h>
+#include <stdbool.h>
+#include <stdio.h>
+#include <string.h>
+#include <fcntl.h>
+#include <assert.h>
+#include <errno.h>
+#include <debug.h>
+
+#include <nuttx/kmalloc.h>
+#include <nuttx/mm/mempool.h>
+#include <nuttx/fs/fs.h>
+#include <nuttx/fs/procfs.h>
+
+#if !defined(CONFIG_DISABLE_MOUNTPOINT) && defined(CONFIG_FS_PROCFS) && \
+    !defined(CONFIG_FS_PROCFS_EXCLUDE_MEMPOOL)
+
+/****************************************************************************
+ * Pre-processor Definitions
+ ****************************************************************************/
+
+/* Determines the size of an intermediate buffer that must be large enough
+ * to handle the longest line generated by this logic.
+ */
+
+#define MEMPOOL_LINELEN 96
+
+/****************************************************************************
+ * Private Types
+ ****************************************************************************/
+
+/* This structure describes one open "file" */
+
+struct mempool_file_s
+{
+  struct procfs_file_s base;      /* Base open file structure */
+  char line[MEMPOOL_LINELEN];     /* Pre-allocated buffer for formatted lines */
+};
+
+/* This structure holds the state of one read operation */
+
+struct mempool_readstate_s
+{
+  FAR struct mempool_file_s *poolfile; /* The open file */
+  FAR char *buffer;                    /* Remaining user buffer */
+  size_t buflen;                       /* Remaining size of the buffer */
+  size_t totalsize;                    /* Number of bytes returned */
+  off_t offset;                        /* Offset into the generated text */
+};
+
+/****************************************************************************
+ * Private Function Prototypes
+ ****************************************************************************/
+
+/* File system methods */
+
+static int     mempool_open(FAR struct file *filep, FAR const char *relpath,
+                 int oflags, mode_t mode);
+static int     mempool_close(FAR struct file *filep);
+static ssize_t mempool_read(FAR struct file *filep, FAR char *buffer,
+                 size_t buflen);
+static int     mempool_dup(FAR const struct file *oldp,
+                 FAR struct file *newp);
+static int     mempool_stat(FAR const char *relpath, FAR struct stat *buf);
+
+/****************************************************************************
+ * Public Data
+ ****************************************************************************/
+
+/* See fs_mount.c -- this structure is explicitly externed there.
+ * We use the old-fashioned kind of initializers so that this will compile
+ * with any compiler.
+ */
+
+const struct procfs_operations mempool_operations =
+{
+  mempool_open,   /* open */
+  mempool_close,  /* close */
+  mempool_read,   /* read */
+  NULL,           /* write */
+  mempool_dup,    /* dup */
+  NULL,           /* opendir */
+  NULL,           /* closedir */
+  NULL,           /* readdir */
+  NULL,           /* rewinddir */
+  mempool_stat    /* stat */
+};
+
+/****************************************************************************
+ * Private Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: mempool_copyline
+ *
+ * Description:
+ *   Copy the formatted line into the user buffer, honoring the file offset.
+ *
+ ****************************************************************************/
+
+static void mempool_copyline(FAR struct mempool_readstate_s *state,
+                             size_t linesize)
+{
+  size_t copysize;
+
+  if (state->totalsize < state->buflen)
+    {
+      copysize = procfs_memcpy(state->poolfile->line, linesize,
+                               state->buffer,
+                               state->buflen - state->totalsize,
+                               &state->offset);
+      state->buffer    += copysize;
+      state->totalsize += copysize;
+    }
+}
+
+/****************************************************************************
+ * Name: mempool_readpool
+ *
+ * Description:
+ *   mempool_foreach() callback that generates the line for one pool.
+ *
+ ****************************************************************************/
+
+static void mempool_readpool(FAR struct mempool_s *pool, FAR void *arg)
+{
+  FAR struct mempool_readstate_s *state = arg;
+  struct mempoolinfo_s info;
+  size_t linesize;
+
+  mempool_info(pool, &info);
+
+  linesize = snprintf(state->poolfile->line, MEMPOOL_LINELEN,
+                      "%-12s%6lu%6lu%6lu%6lu%6lu%6lu%8lu%8lu\n",
+                      pool->name, (unsigned long)info.bsize,
+                      (unsigned long)info.ninitial,
+                      (unsigned long)info.nreserve,
+                      (unsigned long)info.nfree,
+                      (unsigned long)info.nused,
+                      (unsigned long)info.nheap,
+                      (unsigned long)info.nmaxused,
+                      (unsigned long)info.nfail);
+
+  mempool_copyline(state, linesize);
+}
+
+/****************************************************************************
+ * Name: mempool_open
+ ****************************************************************************/
+
+static int mempool_open(FAR struct file *filep, FAR const char *relpath,
+                        int oflags, mode_t mode)
+{
+  FAR struct mempool_file_s *procfile;
+
+  finfo("Open '%s'\n", relpath);
+
+  /* PROCFS is read-only.  Any attempt to open with any kind of write
+   * access is not permitted.
+   *
+   * REVISIT:  Write-able proc files could be quite useful.
+   */
+
+  if ((oflags & O_WRONLY) != 0 || (oflags & O_RDONLY) == 0)
+    {
+      ferr("ERROR: Only O_RDONLY supported\n");
+      return -EACCES;
+    }
+
+  /* "mempool" is the only acceptable value for the relpath */
+
+  if (strcmp(relpath, "mempool") != 0)
+    {
+      ferr("ERROR: relpath is '%s'\n", relpath);
+      return -ENOENT;
+    }
+
+  /* Allocate a container to hold the file attributes */
+
+  procfile = (FAR struct mempool_file_s *)
+    kmm_zalloc(sizeof(struct mempool_file_s));
+  if (!procfile)
+    {
+      ferr("ERROR: Failed to allocate file attributes\n");
+      return -ENOMEM;
+    }
+
+  /* Save the attributes as the open-specific state in filep->f_priv */
+
+  filep->f_priv = (FAR void *)procfile;
+  return OK;
+}
+
+/****************************************************************************
+ * Name: mempool_close
+ ****************************************************************************/
+
+static int mempool_close(FAR struct file *filep)
+{
+  FAR struct mempool_file_s *procfile;
+
+  /* Recover our private data from the struct file instance */
+
+  procfile = (FAR struct mempool_file_s *)filep->f_priv;
+  DEBUGASSERT(procfile);
+
+  /* Release the file attributes structure */
+
+  kmm_free(procfile);
+  filep->f_priv = NULL;
+  return OK;
+}
+
+/****************************************************************************
+ * Name: mempool_read
+ ****************************************************************************/
+
+static ssize_t mempool_read(FAR struct file *filep, FAR char *buffer,
+                            size_t buflen)
+{
+  struct mempool_readstate_s state;
+  size_t linesize;
+
+  finfo("buffer=%p buflen=%d\n", buffer, (int)buflen);
+
+  DEBUGASSERT(filep != NULL && buffer != NULL && buflen > 0);
+
+  /* Recover our private data from the struct file instance */
+
+  state.poolfile  = (FAR struct mempool_file_s *)filep->f_priv;
+  state.buffer    = buffer;
+  state.buflen    = buflen;
+  state.totalsize = 0;
+  state.offset    = filep->f_pos;
+  DEBUGASSERT(state.poolfile);
+
+  /* The first line is the headers */
+
+  linesize = snprintf(state.poolfile->line, MEMPOOL_LINELEN,
+                      "%-12s%6s%6s%6s%6s%6s%6s%8s%8s\n",
+                      "NAME", "BSIZE", "INIT", "RSRV", "FREE", "USED",
+                      "HEAP", "MAXUSED", "FAIL");
+
+  mempool_copyline(&state, linesize);
+
+  /* Then one line for each pool */
+
+  mempool_foreach(mempool_readpool, &state);
+
+  /* Update the file offset */
+
+  filep->f_pos += state.totalsize;
+  return state.totalsize;
+}
+
+/****************************************************************************
+ * Name: mempool_dup
+ *
+ * Description:
+ *   Duplicate open file data in the new file structure.
+ *
+ ****************************************************************************/
+
+static int mempool_dup(FAR const struct file *oldp, FAR struct file *newp)
+{
+  FAR struct mempool_file_s *oldattr;
+  FAR struct mempool_file_s *newattr;
+
+  finfo("Dup %p->%p\n", oldp, newp);
+
+  /* Recover our private data from the old struct file instance */
+
+  oldattr = (FAR struct mempool_file_s *)oldp->f_priv;
+  DEBUGASSERT(oldattr);
+
+  /* Allocate a new container to hold the task and attribute selection */
+
+  newattr = (FAR struct mempool_file_s *)
+    kmm_malloc(sizeof(struct mempool_file_s));
+  if (!newattr)
+    {
+      ferr("ERROR: Failed to allocate file attributes\n");
+      return -ENOMEM;
+    }
+
+  /* The copy the file attributes from the old attributes to the new */
+
+  memcpy(newattr, oldattr, sizeof(struct mempool_file_s));
+
+  /* Save the new attributes in the new file structure */
+
+  newp->f_priv = (FAR void *)newattr;
+  return OK;
+}
+
+/****************************************************************************
+ * Name: mempool_stat
+ *
+ * Description: Return information about a file or directory
+ *
+ ****************************************************************************/
+
+static int mempool_stat(FAR const char *relpath, FAR struct stat *buf)
+{
+  /* "mempool" is the only acceptable value for the relpath */
+
+  if (strcmp(relpath, "mempool") != 0)
+    {
+      ferr("ERROR: relpath is '%s'\n", relpath);
+      return -ENOENT;
+    }
+
+  /* "mempool" is the name for a read-only file */
+
+  memset(buf, 0, sizeof(struct stat));
+  buf->st_mode = S_IFREG | S_IROTH | S_IRGRP | S_IRUSR;
+  return OK;
+}
+
+#endif /* !CONFIG_DISABLE_MOUNTPOINT && CONFIG_FS_PROCFS &&
+        * !CONFIG_FS_PROCFS_EXCLUDE_MEMPOOL */
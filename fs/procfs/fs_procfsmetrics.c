@@ -0,0 +1,509 @@
+/****************************************************************************
+ * fs/procfs/fs_procfsmetrics.c
+ *
+ *   Copyright (C) 2020 Gregory Nutt. All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in
+ *    the documentation and/or other materials provided with the
+ *    distribution.
+ * 3. Neither the name NuttX nor the names of its contributors may be
+ *    used to endorse or promote products derived from this software
+ *    without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+ * FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE
+ * COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+ * INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,
+ * BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS
+ * OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED
+ * AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ * LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN
+ * ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ *
+ ****************************************************************************/
+
+/****************************************************************************
+ * Included Files
+ ****************************************************************************/
+
+#include <nuttx/config.h>
+
+#include <sys/types.h>
+#include <sys/stat.h>
+
+#include <stdint.h>
+#include <stdbool.h>
+#include <string.h>
+#include <sched.h>
+#include <fcntl.h>
+#include <assert.h>
+#include <errno.h>
+#include <debug.h>
+
+#include <nuttx/arch.h>
+#include <nuttx/clock.h>
+#include <nuttx/irq.h>
+#include <nuttx/sched.h>
+#include <nuttx/kmalloc.h>
+#include <nuttx/fs/fs.h>
+#include <nuttx/fs/procfs.h>
+
+#ifdef CONFIG_MM_IOB
+#  include <nuttx/mm/iob.h>
+#endif
+
+#if defined(CONFIG_NET) && defined(CONFIG_NET_STATISTICS)
+#  include <nuttx/net/netstats.h>
+#endif
+
+#if !defined(CONFIG_DISABLE_MOUNTPOINT) && defined(CONFIG_FS_PROCFS) && \
+    !defined(CONFIG_FS_PROCFS_EXCLUDE_METRICS)
+
+/****************************************************************************
+ * Private Types
+ ****************************************************************************/
+
+/* This structure describes one open "file".  The snapshot lives in the
+ * open file so that a reader sees one consistent sample even if it uses
+ * several read() calls.
+ */
+
+struct metrics_file_s
+{
+  struct procfs_file_s base;                /* Base open file structure */
+  struct procfs_metrics_s hdr;              /* Snapshot header */
+  struct procfs_metrics_task_s task[CONFIG_MAX_TASKS];
+  pid_t pid[CONFIG_MAX_TASKS];              /* Threads found by the scan */
+  uint16_t npids;                           /* Number of valid pid[] */
+};
+
+/****************************************************************************
+ * Private Function Prototypes
+ ****************************************************************************/
+
+/* File system methods */
+
+static int     metrics_open(FAR struct file *filep, FAR const char *relpath,
+                 int oflags, mode_t mode);
+static int     metrics_close(FAR struct file *filep);
+static ssize_t metrics_read(FAR struct file *filep, FAR char *buffer,
+                 size_t buflen);
+static int     metrics_dup(FAR const struct file *oldp,
+                 FAR struct file *newp);
+static int     metrics_stat(FAR const char *relpath, FAR struct stat *buf);
+
+/****************************************************************************
+ * Public Data
+ ****************************************************************************/
+
+/* See fs_mount.c -- this structure is explicitly externed there.
+ * We use the old-fashioned kind of initializers so that this will compile
+ * with any compiler.
+ */
+
+const struct procfs_operations metrics_operations =
+{
+  metrics_open,   /* open */
+  metrics_close,  /* close */
+  metrics_read,   /* read */
+  NULL,           /* write */
+  metrics_dup,    /* dup */
+  NULL,           /* opendir */
+  NULL,           /* closedir */
+  NULL,           /* readdir */
+  NULL,           /* rewinddir */
+  metrics_stat    /* stat */
+};
+
+/****************************************************************************
+ * Private Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: metrics_heap
+ ****************************************************************************/
+
+static void metrics_heap(FAR struct procfs_metrics_heap_s *heap,
+                         FAR const struct mallinfo *mem)
+{
+  heap->arena    = mem->arena;
+  heap->ordblks  = mem->ordblks;
+  heap->mxordblk = mem->mxordblk;
+  heap->uordblks = mem->uordblks;
+  heap->fordblks = mem->fordblks;
+}
+
+/****************************************************************************
+ * Name: metrics_enum
+ *
+ * Description:
+ *   sched_foreach() callback that takes a snapshot of the active threads.
+ *
+ ****************************************************************************/
+
+static void metrics_enum(FAR struct tcb_s *tcb, FAR void *arg)
+{
+  FAR struct metrics_file_s *metfile = (FAR struct metrics_file_s *)arg;
+
+  DEBUGASSERT(metfile->npids < CONFIG_MAX_TASKS);
+  metfile->pid[metfile->npids++] = tcb->pid;
+}
+
+/****************************************************************************
+ * Name: metrics_tasks
+ *
+ * Description:
+ *   Fill in one record for each thread found by sched_foreach().
+ *
+ ****************************************************************************/
+
+static void metrics_tasks(FAR struct metrics_file_s *metfile)
+{
+  FAR struct procfs_metrics_task_s *task;
+  FAR struct tcb_s *tcb;
+#ifdef CONFIG_SCHED_CPULOAD
+  struct cpuload_s cpuload;
+#endif
+  int ntasks = 0;
+  int i;
+
+  metfile->npids = 0;
+  sched_foreach(metrics_enum, metfile);
+
+  /* Keep the threads from exiting while their stacks are examined */
+
+  sched_lock();
+  for (i = 0; i < metfile->npids; i++)
+    {
+      /* The thread may have exited since the snapshot was taken */
+
+      tcb = sched_gettcb(metfile->pid[i]);
+      if (tcb == NULL)
+        {
+          continue;
+        }
+
+      task            = &metfile->task[ntasks++];
+      task->pid       = tcb->pid;
+      task->priority  = tcb->sched_priority;
+      task->state     = tcb->task_state;
+      task->stacksize = tcb->adj_stack_size;
+#ifdef CONFIG_STACK_COLORATION
+      task->stackused = up_check_tcbstack(tcb);
+#else
+      task->stackused = 0;
+#endif
+
+#ifdef CONFIG_SCHED_CPULOAD
+      if (clock_cpuload(tcb->pid, &cpuload) == OK)
+        {
+          task->cpuload         = cpuload.active;
+          metfile->hdr.cputotal = cpuload.total;
+        }
+      else
+        {
+          task->cpuload         = 0;
+        }
+#else
+      task->cpuload   = 0;
+#endif
+    }
+
+  sched_unlock();
+  metfile->hdr.ntasks = ntasks;
+}
+
+/****************************************************************************
+ * Name: metrics_snapshot
+ *
+ * Description:
+ *   Sample everything into the open file.
+ *
+ ****************************************************************************/
+
+static void metrics_snapshot(FAR struct metrics_file_s *metfile)
+{
+  FAR struct procfs_metrics_s *hdr = &metfile->hdr;
+  struct mallinfo mem;
+#if defined(CONFIG_MM_IOB) && !defined(CONFIG_FS_PROCFS_EXCLUDE_IOBINFO)
+  FAR struct iob_userstats_s *userstats;
+#endif
+
+  memset(hdr, 0, sizeof(struct procfs_metrics_s));
+  hdr->magic    = PROCFS_METRICS_MAGIC;
+  hdr->version  = PROCFS_METRICS_VERSION;
+  hdr->hdrsize  = sizeof(struct procfs_metrics_s);
+  hdr->tasksize = sizeof(struct procfs_metrics_task_s);
+  hdr->systime  = clock_systimer();
+
+  /* Per-thread CPU load and stack usage */
+
+  metrics_tasks(metfile);
+
+#ifdef CONFIG_SCHED_CPULOAD
+  hdr->flags   |= PROCFS_METRICS_CPULOAD;
+#endif
+#ifdef CONFIG_STACK_COLORATION
+  hdr->flags   |= PROCFS_METRICS_STACK;
+#endif
+
+  /* Heap statistics */
+
+#ifdef CONFIG_MM_KERNEL_HEAP
+#ifdef CONFIG_CAN_PASS_STRUCTS
+  mem = kmm_mallinfo();
+#else
+  kmm_mallinfo(&mem);
+#endif
+  metrics_heap(&hdr->kheap, &mem);
+  hdr->flags   |= PROCFS_METRICS_KHEAP;
+#endif
+
+#if !defined(CONFIG_BUILD_KERNEL)
+#ifdef CONFIG_CAN_PASS_STRUCTS
+  mem = kumm_mallinfo();
+#else
+  kumm_mallinfo(&mem);
+#endif
+  metrics_heap(&hdr->uheap, &mem);
+  hdr->flags   |= PROCFS_METRICS_UHEAP;
+#endif
+
+  /* IOB statistics */
+
+#ifdef CONFIG_MM_IOB
+  hdr->iob.navail  = iob_navail(false);
+  hdr->iob.nqavail = iob_qentry_navail();
+#ifndef CONFIG_FS_PROCFS_EXCLUDE_IOBINFO
+  userstats         = iob_getuserstats(IOBUSER_GLOBAL);
+  hdr->iob.consumed = userstats->totalconsumed;
+  hdr->iob.produced = userstats->totalproduced;
+#endif
+  hdr->flags   |= PROCFS_METRICS_IOB;
+#endif
+
+  /* Network counters */
+
+#if defined(CONFIG_NET) && defined(CONFIG_NET_STATISTICS)
+#ifdef CONFIG_NET_IPv4
+  hdr->net.ipv4_recv  = g_netstats.ipv4.recv;
+  hdr->net.ipv4_sent  = g_netstats.ipv4.sent;
+  hdr->net.ipv4_drop  = g_netstats.ipv4.drop;
+#endif
+#ifdef CONFIG_NET_IPv6
+  hdr->net.ipv6_recv  = g_netstats.ipv6.recv;
+  hdr->net.ipv6_sent  = g_netstats.ipv6.sent;
+  hdr->net.ipv6_drop  = g_netstats.ipv6.drop;
+#endif
+#ifdef CONFIG_NET_TCP
+  hdr->net.tcp_recv   = g_netstats.tcp.recv;
+  hdr->net.tcp_sent   = g_netstats.tcp.sent;
+  hdr->net.tcp_drop   = g_netstats.tcp.drop;
+  hdr->net.tcp_rexmit = g_netstats.tcp.rexmit;
+#endif
+#ifdef CONFIG_NET_UDP
+  hdr->net.udp_recv   = g_netstats.udp.recv;
+  hdr->net.udp_sent   = g_netstats.udp.sent;
+  hdr->net.udp_drop   = g_netstats.udp.drop;
+#endif
+  hdr->flags   |= PROCFS_METRICS_NET;
+#endif
+}
+
+/****************************************************************************
+ * Name: metrics_open
+ ****************************************************************************/
+
+static int metrics_open(FAR struct file *filep, FAR const char *relpath,
+                        int oflags, mode_t mode)
+{
+  FAR struct metrics_file_s *metfile;
+
+  finfo("Open '%s'\n", relpath);
+
+  /* PROCFS is read-only.  Any attempt to open with any kind of write
+   * access is not permitted.
+   */
+
+  if ((oflags & O_WRONLY) != 0 || (oflags & O_RDONLY) == 0)
+    {
+      ferr("ERROR: Only O_RDONLY supported\n");
+      return -EACCES;
+    }
+
+  /* "metrics.bin" is the only acceptable value for the relpath */
+
+  if (strcmp(relpath, "metrics.bin") != 0)
+    {
+      ferr("ERROR: relpath is '%s'\n", relpath);
+      return -ENOENT;
+    }
+
+  /* Allocate a container to hold the file attributes */
+
+  metfile = (FAR struct metrics_file_s *)
+    kmm_zalloc(sizeof(struct metrics_file_s));
+  if (!metfile)
+    {
+      ferr("ERROR: Failed to allocate file attributes\n");
+      return -ENOMEM;
+    }
+
+  /* Save the attributes as the open-specific state in filep->f_priv */
+
+  filep->f_priv = (FAR void *)metfile;
+  return OK;
+}
+
+/****************************************************************************
+ * Name: metrics_close
+ ****************************************************************************/
+
+static int metrics_close(FAR struct file *filep)
+{
+  FAR struct metrics_file_s *metfile;
+
+  /* Recover our private data from the struct file instance */
+
+  metfile = (FAR struct metrics_file_s *)filep->f_priv;
+  DEBUGASSERT(metfile);
+
+  /* Release the file attributes structure */
+
+  kmm_free(metfile);
+  filep->f_priv = NULL;
+  return OK;
+}
+
+/****************************************************************************
+ * Name: metrics_read
+ *
+ * Description:
+ *   A read at file offset zero takes a new snapshot.  A poller can then
+ *   simply lseek() back to the start and read again, without reopening
+ *   the file and without any text formatting.
+ *
+ ****************************************************************************/
+
+static ssize_t metrics_read(FAR struct file *filep, FAR char *buffer,
+                            size_t buflen)
+{
+  FAR struct metrics_file_s *metfile;
+  size_t copysize;
+  size_t totalsize;
+  off_t offset;
+
+  finfo("buffer=%p buflen=%d\n", buffer, (int)buflen);
+
+  DEBUGASSERT(filep != NULL && buffer != NULL && buflen > 0);
+  offset = filep->f_pos;
+
+  /* Recover our private data from the struct file instance */
+
+  metfile = (FAR struct metrics_file_s *)filep->f_priv;
+  DEBUGASSERT(metfile);
+
+  if (offset == 0)
+    {
+      metrics_snapshot(metfile);
+    }
+
+  /* The header, then the task records */
+
+  copysize  = procfs_memcpy((FAR const char *)&metfile->hdr,
+                            sizeof(struct procfs_metrics_s),
+                            buffer, buflen, &offset);
+  totalsize = copysize;
+
+  if (totalsize < buflen)
+    {
+      copysize   = procfs_memcpy((FAR const char *)metfile->task,
+                                 metfile->hdr.ntasks *
+                                 sizeof(struct procfs_metrics_task_s),
+                                 &buffer[totalsize], buflen - totalsize,
+                                 &offset);
+      totalsize += copysize;
+    }
+
+  /* Update the file offset */
+
+  filep->f_pos += totalsize;
+  return totalsize;
+}
+
+/****************************************************************************
+ * Name: metrics_dup
+ *
+ * Description:
+ *   Duplicate open file data in the new file structure.
+ *
+ ****************************************************************************/
+
+static int metrics_dup(FAR const struct file *oldp, FAR struct file *newp)
+{
+  FAR struct metrics_file_s *oldattr;
+  FAR struct metrics_file_s *newattr;
+
+  finfo("Dup %p->%p\n", oldp, newp);
+
+  /* Recover our private data from the old struct file instance */
+
+  oldattr = (FAR struct metrics_file_s *)oldp->f_priv;
+  DEBUGASSERT(oldattr);
+
+  /* Allocate a new container to hold the task and attribute selection */
+
+  newattr = (FAR struct metrics_file_s *)
+    kmm_malloc(sizeof(struct metrics_file_s));
+  if (!newattr)
+    {
+      ferr("ERROR: Failed to allocate file attributes\n");
+      return -ENOMEM;
+    }
+
+  /* The copy the file attributes from the old attributes to the new */
+
+  memcpy(newattr, oldattr, sizeof(struct metrics_file_s));
+
+  /* Save the new attributes in the new file structure */
+
+  newp->f_priv = (FAR void *)newattr;
+  return OK;
+}
+
+/****************************************************************************
+ * Name: metrics_stat
+ *
+ * Description: Return information about a file or directory
+ *
+ ****************************************************************************/
+
+static int metrics_stat(FAR const char *relpath, FAR struct stat *buf)
+{
+  /* "metrics.bin" is the only acceptable value for the relpath */
+
+  if (strcmp(relpath, "metrics.bin") != 0)
+    {
+      ferr("ERROR: relpath is '%s'\n", relpath);
+      return -ENOENT;
+    }
+
+  /* "metrics.bin" is the name for a read-only file */
+
+  memset(buf, 0, sizeof(struct stat));
+  buf->st_mode = S_IFREG | S_IROTH | S_IRGRP | S_IRUSR;
+  return OK;
+}
+
+#endif /* !CONFIG_DISABLE_MOUNTPOINT && CONFIG_FS_PROCFS &&
+        * !CONFIG_FS_PROCFS_EXCLUDE_METRICS */
@@ -0,0 +1,390 @@
+/****************************************************************************
+ * fs/procfs/fs_procfsmmbench.c
+ *
+ *   Copyright (C) 2020 Gregory Nutt. All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in
+ *    the documentation and/or other materials provided with the
+ *    distribution.
+ * 3. Neither the name NuttX nor the names of its contributors may be
+ *    used to endorse or promote products derived from this software
+ *    without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+ * FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE
+ * COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+ * INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,
+ * BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS
+ * OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED
+ * AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ * LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN
+ * ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ *
+ ****************************************************************************/
+
+/****************************************************************************
+ * Included Files
+ ****************************************************************************/
+
+#include <nuttx/config.h>
+
+#include <sys/types.h>
+#include <sys/stat.h>
+
+#include <stdint.h>
+#include <stdbool.h>
+#include <stdio.h>
+#include <string.h>
+#include <fcntl.h>
+#include <assert.h>
+#include <errno.h>
+#include <debug.h>
+
+#include <nuttx/kmalloc.h>
+#include <nuttx/mm/mm.h>
+#include <nuttx/mm/benchmark.h>
+#include <nuttx/fs/fs.h>
+#include <nuttx/fs/procfs.h>
+
+#if !defined(CONFIG_DISABLE_MOUNTPOINT) && defined(CONFIG_FS_PROCFS) && \
+    defined(CONFIG_MM_BENCHMARK) && !defined(CONFIG_FS_PROCFS_EXCLUDE_MMBENCH)
+
+/****************************************************************************
+ * Pre-processor Definitions
+ ****************************************************************************/
+
+/* Determines the size of an intermediate buffer that must be large enough
+ * to handle the longest line generated by this logic.
+ */
+
+#define MMBENCH_LINELEN 64
+
+/****************************************************************************
+ * Private Types
+ ****************************************************************************/
+
+/* This structure describes one open "file" */
+
+struct mmbench_file_s
+{
+  struct procfs_file_s base;      /* Base open file structure */
+  char line[MMBENCH_LINELEN];     /* Pre-allocated buffer for formatted lines */
+
+  /* The results of each trace, collected when the file is opened */
+
+  struct mm_benchresult_s result[MM_BENCH_NTRACES];
+  int ret[MM_BENCH_NTRACES];
+};
+
+/* This structure holds the state of one read operation */
+
+struct mmbench_readstate_s
+{
+  FAR struct mmbench_file_s *bench;    /* The open file */
+  FAR char *buffer;                    /* Remaining user buffer */
+  size_t buflen;                       /* Remaining size of the buffer */
+  size_t totalsize;                    /* Number of bytes returned */
+  off_t offset;                        /* Offset into the generated text */
+};
+
+/****************************************************************************
+ * Private Function Prototypes
+ ****************************************************************************/
+
+/* File system methods */
+
+static int     mmbench_open(FAR struct file *filep, FAR const char *relpath,
+                 int oflags, mode_t mode);
+static int     mmbench_close(FAR struct file *filep);
+static ssize_t mmbench_read(FAR struct file *filep, FAR char *buffer,
+                 size_t buflen);
+static int     mmbench_dup(FAR const struct file *oldp,
+                 FAR struct file *newp);
+static int     mmbench_stat(FAR const char *relpath, FAR struct stat *buf);
+
+/****************************************************************************
+ * Public Data
+ ****************************************************************************/
+
+/* See fs_mount.c -- this structure is explicitly externed there.
+ * We use the old-fashioned kind of initializers so that this will compile
+ * with any compiler.
+ */
+
+const struct procfs_operations mmbench_operations =
+{
+  mmbench_open,   /* open */
+  mmbench_close,  /* close */
+  mmbench_read,   /* read */
+  NULL,           /* write */
+  mmbench_dup,    /* dup */
+  NULL,           /* opendir */
+  NULL,           /* closedir */
+  NULL,           /* readdir */
+  NULL,           /* rewinddir */
+  mmbench_stat    /* stat */
+};
+
+/****************************************************************************
+ * Private Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: mmbench_copyline
+ *
+ * Description:
+ *   Copy the formatted line into the user buffer, honoring the file offset.
+ *
+ ****************************************************************************/
+
+static void mmbench_copyline(FAR struct mmbench_readstate_s *state,
+                             size_t linesize)
+{
+  size_t copysize;
+
+  if (state->totalsize < state->buflen)
+    {
+      copysize = procfs_memcpy(state->bench->line, linesize,
+                               state->buffer,
+                               state->buflen - state->totalsize,
+                               &state->offset);
+      state->buffer    += copysize;
+      state->totalsize += copysize;
+    }
+}
+
+/****************************************************************************
+ * Name: mmbench_open
+ ****************************************************************************/
+
+static int mmbench_open(FAR struct file *filep, FAR const char *relpath,
+                        int oflags, mode_t mode)
+{
+  FAR struct mmbench_file_s *procfile;
+  int i;
+
+  finfo("Open '%s'\n", relpath);
+
+  /* PROCFS is read-only.  Any attempt to open with any kind of write
+   * access is not permitted.
+   *
+   * REVISIT:  Write-able proc files could be quite useful.
+   */
+
+  if ((oflags & O_WRONLY) != 0 || (oflags & O_RDONLY) == 0)
+    {
+      ferr("ERROR: Only O_RDONLY supported\n");
+      return -EACCES;
+    }
+
+  /* "mmbench" is the only acceptable value for the relpath */
+
+  if (strcmp(relpath, "mmbench") != 0)
+    {
+      ferr("ERROR: relpath is '%s'\n", relpath);
+      return -ENOENT;
+    }
+
+  /* Allocate a container to hold the file attributes */
+
+  procfile = (FAR struct mmbench_file_s *)
+    kmm_zalloc(sizeof(struct mmbench_file_s));
+  if (!procfile)
+    {
+      ferr("ERROR: Failed to allocate file attributes\n");
+      return -ENOMEM;
+    }
+
+  /* Run every trace on the user heap now so that the report does not
+   * change while it is being read.
+   */
+
+  for (i = 0; i < MM_BENCH_NTRACES; i++)
+    {
+      procfile->ret[i] = mm_benchmark(&g_mmheap, i, &procfile->result[i]);
+    }
+
+  /* Save the attributes as the open-specific state in filep->f_priv */
+
+  filep->f_priv = (FAR void *)procfile;
+  return OK;
+}
+
+/****************************************************************************
+ * Name: mmbench_close
+ ****************************************************************************/
+
+static int mmbench_close(FAR struct file *filep)
+{
+  FAR struct mmbench_file_s *procfile;
+
+  /* Recover our private data from the struct file instance */
+
+  procfile = (FAR struct mmbench_file_s *)filep->f_priv;
+  DEBUGASSERT(procfile);
+
+  /* Release the file attributes structure */
+
+  kmm_free(procfile);
+  filep->f_priv = NULL;
+  return OK;
+}
+
+/****************************************************************************
+ * Name: mmbench_read
+ ****************************************************************************/
+
+static ssize_t mmbench_read(FAR struct file *filep, FAR char *buffer,
+                            size_t buflen)
+{
+  struct mmbench_readstate_s state;
+  size_t linesize;
+  int op;
+  int i;
+
+  finfo("buffer=%p buflen=%d\n", buffer, (int)buflen);
+
+  DEBUGASSERT(filep != NULL && buffer != NULL && buflen > 0);
+
+  /* Recover our private data from the struct file instance */
+
+  state.bench  = (FAR struct mmbench_file_s *)filep->f_priv;
+  state.buffer    = buffer;
+  state.buflen    = buflen;
+  state.totalsize = 0;
+  state.offset    = filep->f_pos;
+  DEBUGASSERT(state.bench);
+
+  /* The first line is the headers */
+
+  linesize = snprintf(state.bench->line, MMBENCH_LINELEN,
+                      "%-8s %-7s %6s %8s %8s %8s\n",
+                      "TRACE", "OP", "COUNT", "P50(ns)", "P99(ns)",
+                      "MAX(ns)");
+
+  mmbench_copyline(&state, linesize);
+
+  /* Then the latency of each operation used by a trace, followed by the
+   * fragmentation of the heap and the number of failed allocations.
+   */
+
+  for (i = 0; i < MM_BENCH_NTRACES; i++)
+    {
+      FAR struct mm_benchresult_s *result = &state.bench->result[i];
+
+      if (state.bench->ret[i] < 0)
+        {
+          linesize = snprintf(state.bench->line, MMBENCH_LINELEN,
+                              "%-8s error %d\n", mm_benchname(i),
+                              state.bench->ret[i]);
+          mmbench_copyline(&state, linesize);
+          continue;
+        }
+
+      for (op = 0; op < MM_BENCHOP_NOPS; op++)
+        {
+          FAR struct mm_benchstat_s *stat = &result->br_stat[op];
+
+          if (stat->bs_nops > 0)
+            {
+              linesize = snprintf(state.bench->line, MMBENCH_LINELEN,
+                                  "%-8s %-7s %6lu %8lu %8lu %8lu\n",
+                                  mm_benchname(i), mm_benchopname(op),
+                                  (unsigned long)stat->bs_nops,
+                                  (unsigned long)stat->bs_p50,
+                                  (unsigned long)stat->bs_p99,
+                                  (unsigned long)stat->bs_max);
+              mmbench_copyline(&state, linesize);
+            }
+        }
+
+      linesize = snprintf(state.bench->line, MMBENCH_LINELEN,
+                          "%-8s frag %u.%u%% failed %lu\n",
+                          mm_benchname(i), result->br_frag / 10,
+                          result->br_frag % 10,
+                          (unsigned long)result->br_nfail);
+      mmbench_copyline(&state, linesize);
+    }
+
+  /* Update the file offset */
+
+  filep->f_pos += state.totalsize;
+  return state.totalsize;
+}
+
+/****************************************************************************
+ * Name: mmbench_dup
+ *
+ * Description:
+ *   Duplicate open file data in the new file structure.
+ *
+ ****************************************************************************/
+
+static int mmbench_dup(FAR const struct file *oldp, FAR struct file *newp)
+{
+  FAR struct mmbench_file_s *oldattr;
+  FAR struct mmbench_file_s *newattr;
+
+  finfo("Dup %p->%p\n", oldp, newp);
+
+  /* Recover our private data from the old struct file instance */
+
+  oldattr = (FAR struct mmbench_file_s *)oldp->f_priv;
+  DEBUGASSERT(oldattr);
+
+  /* Allocate a new container to hold the task and attribute selection */
+
+  newattr = (FAR struct mmbench_file_s *)
+    kmm_malloc(sizeof(struct mmbench_file_s));
+  if (!newattr)
+    {
+      ferr("ERROR: Failed to allocate file attributes\n");
+      return -ENOMEM;
+    }
+
+  /* The copy the file attributes from the old attributes to the new */
+
+  memcpy(newattr, oldattr, sizeof(struct mmbench_file_s));
+
+  /* Save the new attributes in the new file structure */
+
+  newp->f_priv = (FAR void *)newattr;
+  return OK;
+}
+
+/****************************************************************************
+ * Name: mmbench_stat
+ *
+ * Description: Return information about a file or directory
+ *
+ ****************************************************************************/
+
+static int mmbench_stat(FAR const char *relpath, FAR struct stat *buf)
+{
+  /* "mmbench" is the only acceptable value for the relpath */
+
+  if (strcmp(relpath, "mmbench") != 0)
+    {
+      ferr("ERROR: relpath is '%s'\n", relpath);
+      return -ENOENT;
+    }
+
+  /* "mmbench" is the name for a read-only file */
+
+  memset(buf, 0, sizeof(struct stat));
+  buf->st_mode = S_IFREG | S_IROTH | S_IRGRP | S_IRUSR;
+  return OK;
+}
+
+#endif /* !CONFIG_DISABLE_MOUNTPOINT && CONFIG_FS_PROCFS &&
+        * CONFIG_MM_BENCHMARK && !CONFIG_FS_PROCFS_EXCLUDE_MMBENCH */
@@ -62,6 +62,7 @@
 #include <nuttx/sched.h>
 #include <nuttx/kmalloc.h>
 #include <nuttx/environ.h>
+#include <nuttx/mm/mm.h>
 #include <nuttx/fs/fs.h>
 #include <nuttx/fs/procfs.h>
 #include <nuttx/fs/dirent.h>
@@ -115,6 +116,9 @@ enum proc_node_e
   PROC_CRITMON,                       /* Critical section monitor */
 #endif
   PROC_STACK,                         /* Task stack info */
+#ifdef CONFIG_MM_HEAP_PROFILE
+  PROC_HEAP,                          /* Task heap usage */
+#endif
   PROC_GROUP,                         /* Group directory */
   PROC_GROUP_STATUS,                  /* Task group status */
   PROC_GROUP_FD                       /* Group file descriptors */
@@ -170,9 +174,9 @@ struct proc_envinfo_s
  * Private Data
  ****************************************************************************/
 
-static FAR const char *g_policy[4] =
+static FAR const char *g_policy[5] =
 {
-  "SCHED_FIFO", "SCHED_RR", "SCHED_SPORADIC", "SCHED_OTHER"
+  "SCHED_FIFO", "SCHED_RR", "SCHED_SPORADIC", "SCHED_OTHER", "SCHED_DEADLINE"
 };
 
 /****************************************************************************
@@ -202,6 +206,11 @@ static ssize_t proc_critmon(FAR struct proc_file_s *procfile,
 static ssize_t proc_stack(FAR struct proc_file_s *procfile,
                  FAR struct tcb_s *tcb, FAR char *buffer, size_t buflen,
                  off_t offset);
+#ifdef CONFIG_MM_HEAP_PROFILE
+static ssize_t proc_heap(FAR struct proc_file_s *procfile,
+                 FAR struct tcb_s *tcb, FAR char *buffer, size_t buflen,
+                 off_t offset);
+#endif
 static ssize_t proc_groupstatus(FAR struct proc_file_s *procfile,
                  FAR struct tcb_s *tcb, FAR char *buffer, size_t buflen,
                  off_t offset);
@@ -299,6 +308,13 @@ static const struct proc_node_s g_stack =
   "stack",        "stack",   (uint8_t)PROC_STACK,        DTYPE_FILE        /* Task stack info */
 };
 
+#ifdef CONFIG_MM_HEAP_PROFILE
+static const struct proc_node_s g_heap =
+{
+  "heap",         "heap",    (uint8_t)PROC_HEAP,         DTYPE_FILE        /* Task heap usage */
+};
+#endif
+
 static const struct proc_node_s g_group =
 {
   "group",        "group",   (uint8_t)PROC_GROUP,        DTYPE_DIRECTORY   /* Group directory */
@@ -335,6 +351,9 @@ static FAR const struct proc_node_s * const g_nodeinfo[] =
   &g_critmon,      /* Critical section Monitor */
 #endif
   &g_stack,        /* Task stack info */
+#ifdef CONFIG_MM_HEAP_PROFILE
+  &g_heap,         /* Task heap usage */
+#endif
   &g_group,        /* Group directory */
   &g_groupstatus,  /* Task group status */
   &g_groupfd       /* Group file descriptors */
@@ -358,6 +377,9 @@ static const struct proc_node_s * const g_level0info[] =
   &g_critmon,      /* Critical section monitor */
 #endif
   &g_stack,        /* Task stack info */
+#ifdef CONFIG_MM_HEAP_PROFILE
+  &g_heap,         /* Task heap usage */
+#endif
   &g_group,        /* Group directory */
 };
 #define PROC_NLEVEL0NODES (sizeof(g_level0info)/sizeof(FAR const struct proc_node_s * const))
@@ -912,6 +934,74 @@ static ssize_t proc_stack(FAR struct proc_file_s *procfile,
   return totalsize;
 }
 
+/****************************************************************************
+ * Name: proc_heap
+ ****************************************************************************/
+
+#ifdef CONFIG_MM_HEAP_PROFILE
+static ssize_t proc_heap(FAR struct proc_file_s *procfile,
+                         FAR struct tcb_s *tcb, FAR char *buffer,
+                         size_t buflen, off_t offset)
+{
+  struct mm_taskstats_s stats;
+  size_t remaining;
+  size_t linesize;
+  size_t copysize;
+  size_t totalsize;
+
+  remaining = buflen;
+  totalsize = 0;
+
+  /* Get the heap usage of the task.  Nothing is recorded if the task has
+   * never allocated any memory.
+   */
+
+  mm_taskinfo(&g_mmheap, tcb->pid, &stats);
+
+  /* Show the number of allocated chunks */
+
+  linesize   = snprintf(procfile->line, STATUS_LINELEN, "%-12s%lu\n",
+                        "Chunks:", (unsigned long)stats.nchunks);
+  copysize   = procfs_memcpy(procfile->line, linesize, buffer, remaining, &offset);
+
+  totalsize += copysize;
+  buffer    += copysize;
+  remaining -= copysize;
+
+  if (totalsize >= buflen)
+    {
+      return totalsize;
+    }
+
+  /* Show the number of bytes currently allocated */
+
+  linesize   = snprintf(procfile->line, STATUS_LINELEN, "%-12s%lu\n",
+                        "Live:", (unsigned long)stats.live);
+  copysize   = procfs_memcpy(procfile->line, linesize, buffer, remaining, &offset);
+
+  totalsize += copysize;
+  buffer    += copysize;
+  remaining -= copysize;
+
+  if (totalsize >= buflen)
+    {
+      return totalsize;
+    }
+
+  /* Show the peak number of bytes allocated */
+
+  linesize   = snprintf(procfile->line, STATUS_LINELEN, "%-12s%lu\n",
+                        "Peak:", (unsigned long)stats.peak);
+  copysize   = procfs_memcpy(procfile->line, linesize, buffer, remaining, &offset);
+
+  totalsize += copysize;
+  buffer    += copysize;
+  remaining -= copysize;
+
+  return totalsize;
+}
+#endif
+
 /****************************************************************************
  * Name: proc_groupstatus
  ****************************************************************************/
@@ -1091,13 +1181,12 @@ static ssize_t proc_groupfd(FAR struct proc_file_s *procfile,
 
   /* Examine each open file descriptor */
 
-  for (i = 0, file = group->tg_filelist.fl_files;
-       i < CONFIG_NFILE_DESCRIPTORS;
-       i++, file++)
+  for (i = 0; i < CONFIG_NFILE_DESCRIPTORS; i++)
     {
       /* Is there an inode associated with the file descriptor? */
 
-      if (file->f_inode)
+      file = files_fget(&group->tg_filelist, i);
+      if (file != NULL && file->f_inode)
         {
           linesize   = snprintf(procfile->line, STATUS_LINELEN,
                                 "%3d %8ld %04x\n", i, (long)file->f_pos,
@@ -1447,6 +1536,12 @@ static ssize_t proc_read(FAR struct file *filep, FAR char *buffer,
       ret = proc_stack(procfile, tcb, buffer, buflen, filep->f_pos);
       break;
 
+#ifdef CONFIG_MM_HEAP_PROFILE
+    case PROC_HEAP: /* Task heap usage */
+      ret = proc_heap(procfile, tcb, buffer, buflen, filep->f_pos);
+      break;
+#endif
+
     case PROC_GROUP_STATUS: /* Task group status */
       ret = proc_groupstatus(procfile, tcb, buffer, buflen, filep->f_pos);
       break;
@@ -0,0 +1,433 @@
+/****************************************************************************
+ * fs/procfs/fs_procfsprofile.c
+ *
+ *   Copyright (C) 2020 Gregory Nutt. All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in
+ *    the documentation and/or other materials provided with the
+ *    distribution.
+ * 3. Neither the name NuttX nor the names of its contributors may be
+ *    used to endorse or promote products derived from this software
+ *    without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+ * FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE
+ * COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+ * INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,
+ * BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS
+ * OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED
+ * AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ * LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN
+ * ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ *
+ ****************************************************************************/
+
+/****************************************************************************
+ * Included Files
+ ****************************************************************************/
+
+#include <nuttx/config.h>
+
+#include <sys/types.h>
+#include <sys/stat.h>
+
+#include <stdint.h>
+#include <stdbool.h>
+#include <stdio.h>
+#include <string.h>
+#include <fcntl.h>
+#include <assert.h>
+#include <errno.h>
+#include <debug.h>
+
+#include <nuttx/sched.h>
+#include <nuttx/kmalloc.h>
+#include <nuttx/fs/fs.h>
+#include <nuttx/fs/procfs.h>
+
+#if !defined(CONFIG_DISABLE_MOUNTPOINT) && defined(CONFIG_FS_PROCFS) && \
+     defined(CONFIG_SCHED_PROFILE)
+
+/****************************************************************************
+ * Pre-processor Definitions
+ ****************************************************************************/
+
+/* Determines the size of an intermediate buffer that must be large enough
+ * to handle the longest line generated by this logic.
+ */
+
+#define PROFILE_LINELEN 48
+
+/* The longest command that may be written to the file */
+
+#define PROFILE_CMDLEN  16
+
+/****************************************************************************
+ * Private Types
+ ****************************************************************************/
+
+/* This structure describes one open "file" */
+
+struct profile_file_s
+{
+  struct procfs_file_s base;      /* Base open file structure */
+  char line[PROFILE_LINELEN];     /* Pre-allocated buffer for formatted lines */
+};
+
+/* This structure holds the state of one read operation */
+
+struct profile_readstate_s
+{
+  FAR struct profile_file_s *proffile; /* The open file */
+  FAR char *buffer;                    /* Remaining user buffer */
+  size_t buflen;                       /* Remaining size of the buffer */
+  size_t totalsize;                    /* Number of bytes returned */
+  off_t offset;                        /* Offset into the generated text */
+};
+
+/****************************************************************************
+ * Private Function Prototypes
+ ****************************************************************************/
+
+/* File system methods */
+
+static int     profile_open(FAR struct file *filep, FAR const char *relpath,
+                 int oflags, mode_t mode);
+static int     profile_close(FAR struct file *filep);
+static ssize_t profile_read(FAR struct file *filep, FAR char *buffer,
+                 size_t buflen);
+static ssize_t profile_write(FAR struct file *filep, FAR const char *buffer,
+                 size_t buflen);
+static int     profile_dup(FAR const struct file *oldp,
+                 FAR struct file *newp);
+static int     profile_stat(FAR const char *relpath, FAR struct stat *buf);
+
+/****************************************************************************
+ * Public Data
+ ****************************************************************************/
+
+/* See fs_mount.c -- this structure is explicitly externed there.
+ * We use the old-fashioned kind of initializers so that this will compile
+ * with any compiler.
+ */
+
+const struct procfs_operations profile_operations =
+{
+  profile_open,   /* open */
+  profile_close,  /* close */
+  profile_read,   /* read */
+  profile_write,  /* write */
+  profile_dup,    /* dup */
+  NULL,           /* opendir */
+  NULL,           /* closedir */
+  NULL,           /* readdir */
+  NULL,           /* rewinddir */
+  profile_stat    /* stat */
+};
+
+/****************************************************************************
+ * Private Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: profile_copyline
+ *
+ * Description:
+ *   Copy the formatted line into the user buffer, honoring the file offset.
+ *
+ ****************************************************************************/
+
+static void profile_copyline(FAR struct profile_readstate_s *state,
+                             size_t linesize)
+{
+  size_t copysize;
+
+  if (state->totalsize < state->buflen)
+    {
+      copysize = procfs_memcpy(state->proffile->line, linesize,
+                               state->buffer,
+                               state->buflen - state->totalsize,
+                               &state->offset);
+      state->buffer    += copysize;
+      state->totalsize += copysize;
+    }
+}
+
+/****************************************************************************
+ * Name: profile_histogram
+ *
+ * Description:
+ *   Generate one line for each non-empty bucket of a histogram:  The name
+ *   of the histogram, the start address of the bucket, and the count.
+ *
+ ****************************************************************************/
+
+static void profile_histogram(FAR struct profile_readstate_s *state,
+                              FAR const struct profile_info_s *info,
+                              FAR const char *name, bool caller)
+{
+  uint32_t count;
+  size_t linesize;
+  int ndx;
+
+  for (ndx = 0;
+       ndx < CONFIG_SCHED_PROFILE_NBUCKETS &&
+       state->totalsize < state->buflen;
+       ndx++)
+    {
+      count = sched_profile_count(ndx, caller);
+      if (count == 0)
+        {
+          continue;
+        }
+
+      linesize = snprintf(state->proffile->line, PROFILE_LINELEN,
+                          "%s 0x%08lx %lu\n", name,
+                          (unsigned long)(info->start +
+                                          ((uintptr_t)ndx << info->shift)),
+                          (unsigned long)count);
+
+      profile_copyline(state, linesize);
+    }
+}
+
+/****************************************************************************
+ * Name: profile_open
+ ****************************************************************************/
+
+static int profile_open(FAR struct file *filep, FAR const char *relpath,
+                        int oflags, mode_t mode)
+{
+  FAR struct profile_file_s *proffile;
+
+  finfo("Open '%s'\n", relpath);
+
+  /* "profile" is the only acceptable value for the relpath.  It may be
+   * opened for reading (the histograms) and for writing (commands).
+   */
+
+  if (strcmp(relpath, "profile") != 0)
+    {
+      ferr("ERROR: relpath is '%s'\n", relpath);
+      return -ENOENT;
+    }
+
+  /* Allocate a container to hold the file attributes */
+
+  proffile = (FAR struct profile_file_s *)
+    kmm_zalloc(sizeof(struct profile_file_s));
+  if (!proffile)
+    {
+      ferr("ERROR: Failed to allocate file attributes\n");
+      return -ENOMEM;
+    }
+
+  /* Save the attributes as the open-specific state in filep->f_priv */
+
+  filep->f_priv = (FAR void *)proffile;
+  return OK;
+}
+
+/****************************************************************************
+ * Name: profile_close
+ ****************************************************************************/
+
+static int profile_close(FAR struct file *filep)
+{
+  FAR struct profile_file_s *proffile;
+
+  /* Recover our private data from the struct file instance */
+
+  proffile = (FAR struct profile_file_s *)filep->f_priv;
+  DEBUGASSERT(proffile);
+
+  /* Release the file attributes structure */
+
+  kmm_free(proffile);
+  filep->f_priv = NULL;
+  return OK;
+}
+
+/****************************************************************************
+ * Name: profile_read
+ *
+ * Description:
+ *   The histograms keep changing while samples are being taken.  Write
+ *   "stop" first to get a consistent result in more than one read.
+ *
+ ****************************************************************************/
+
+static ssize_t profile_read(FAR struct file *filep, FAR char *buffer,
+                            size_t buflen)
+{
+  struct profile_readstate_s state;
+  struct profile_info_s info;
+  size_t linesize;
+
+  finfo("buffer=%p buflen=%d\n", buffer, (int)buflen);
+
+  DEBUGASSERT(filep != NULL && buffer != NULL && buflen > 0);
+
+  /* Recover our private data from the struct file instance */
+
+  state.proffile  = (FAR struct profile_file_s *)filep->f_priv;
+  state.buffer    = buffer;
+  state.buflen    = buflen;
+  state.totalsize = 0;
+  state.offset    = filep->f_pos;
+  DEBUGASSERT(state.proffile);
+
+  /* The layout of the histograms and the totals */
+
+  sched_profile_info(&info);
+
+  linesize = snprintf(state.proffile->line, PROFILE_LINELEN,
+                      "state %s\nstart 0x%08lx\nshift %u\n",
+                      info.running ? "running" : "stopped",
+                      (unsigned long)info.start, info.shift);
+
+  profile_copyline(&state, linesize);
+
+  linesize = snprintf(state.proffile->line, PROFILE_LINELEN,
+                      "samples %lu\noutside %lu\n",
+                      (unsigned long)info.nsamples,
+                      (unsigned long)info.noutside);
+
+  profile_copyline(&state, linesize);
+
+  /* Then the non-empty buckets of each histogram */
+
+  profile_histogram(&state, &info, "pc", false);
+#ifdef CONFIG_SCHED_PROFILE_CALLER
+  profile_histogram(&state, &info, "caller", true);
+#endif
+
+  /* Update the file offset */
+
+  filep->f_pos += state.totalsize;
+  return state.totalsize;
+}
+
+/****************************************************************************
+ * Name: profile_write
+ *
+ * Description:
+ *   Accepts the commands:
+ *
+ *     start - Start taking samples
+ *     stop  - Stop taking samples
+ *     reset - Discard all samples
+ *
+ ****************************************************************************/
+
+static ssize_t profile_write(FAR struct file *filep, FAR const char *buffer,
+                             size_t buflen)
+{
+  char cmd[PROFILE_CMDLEN];
+  size_t len;
+
+  DEBUGASSERT(filep != NULL && buffer != NULL);
+
+  /* Get a NUL-terminated copy of the command */
+
+  len = buflen < PROFILE_CMDLEN ? buflen : PROFILE_CMDLEN - 1;
+  memcpy(cmd, buffer, len);
+  cmd[len] = '\0';
+
+  if (strncmp(cmd, "start", 5) == 0)
+    {
+      sched_profile_start();
+    }
+  else if (strncmp(cmd, "stop", 4) == 0)
+    {
+      sched_profile_stop();
+    }
+  else if (strncmp(cmd, "reset", 5) == 0)
+    {
+      sched_profile_reset();
+    }
+  else
+    {
+      ferr("ERROR: Unrecognized command: %s\n", cmd);
+      return -EINVAL;
+    }
+
+  return buflen;
+}
+
+/****************************************************************************
+ * Name: profile_dup
+ *
+ * Description:
+ *   Duplicate open file data in the new file structure.
+ *
+ ****************************************************************************/
+
+static int profile_dup(FAR const struct file *oldp, FAR struct file *newp)
+{
+  FAR struct profile_file_s *oldattr;
+  FAR struct profile_file_s *newattr;
+
+  finfo("Dup %p->%p\n", oldp, newp);
+
+  /* Recover our private data from the old struct file instance */
+
+  oldattr = (FAR struct profile_file_s *)oldp->f_priv;
+  DEBUGASSERT(oldattr);
+
+  /* Allocate a new container to hold the task and attribute selection */
+
+  newattr = (FAR struct profile_file_s *)
+    kmm_malloc(sizeof(struct profile_file_s));
+  if (!newattr)
+    {
+      ferr("ERROR: Failed to allocate file attributes\n");
+      return -ENOMEM;
+    }
+
+  /* The copy the file attributes from the old attributes to the new */
+
+  memcpy(newattr, oldattr, sizeof(struct profile_file_s));
+
+  /* Save the new attributes in the new file structure */
+
+  newp->f_priv = (FAR void *)newattr;
+  return OK;
+}
+
+/****************************************************************************
+ * Name: profile_stat
+ *
+ * Description: Return information about a file or directory
+ *
+ ****************************************************************************/
+
+static int profile_stat(FAR const char *relpath, FAR struct stat *buf)
+{
+  /* "profile" is the only acceptable value for the relpath */
+
+  if (strcmp(relpath, "profile") != 0)
+    {
+      ferr("ERROR: relpath is '%s'\n", relpath);
+      return -ENOENT;
+    }
+
+  /* "profile" is the name for a read/write file */
+
+  memset(buf, 0, sizeof(struct stat));
+  buf->st_mode = S_IFREG | S_IROTH | S_IRGRP | S_IRUSR | S_IWUSR;
+  return OK;
+}
+
+#endif /* !CONFIG_DISABLE_MOUNTPOINT && CONFIG_FS_PROCFS &&
+        * CONFIG_SCHED_PROFILE */
@@ -1021,6 +1021,18 @@ static int romfs_bind(FAR struct inode *blkdriver, FAR const void *data,
       goto errout_with_buffer;
     }
 
+#ifdef CONFIG_FS_ROMFS_INDEX
+  /* Index all directory entries.  Without the index, lookups just search
+   * the directories.
+   */
+
+  ret = romfs_buildindex(rm);
+  if (ret < 0)
+    {
+      fwarn("WARNING: romfs_buildindex failed: %d\n", ret);
+    }
+#endif
+
   /* Mounted! */
 
   *handle = (FAR void *)rm;
@@ -1111,6 +1123,10 @@ static int romfs_unbind(FAR void *handle, FAR struct inode **blkdriver,
           kmm_free(rm->rm_buffer);
         }
 
+#ifdef CONFIG_FS_ROMFS_INDEX
+      romfs_freeindex(rm);
+#endif
+
       nxsem_destroy(&rm->rm_sem);
       kmm_free(rm);
       return OK;
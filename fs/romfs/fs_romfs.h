@@ -125,6 +125,10 @@
 
 #define ROMF_MAX_LINKS 64
 
+/* The path lookup index is kept at most half full */
+
+#define ROMFS_INDEX_MINSLOTS 64
+
 /****************************************************************************
  * Public Types
  ****************************************************************************/
@@ -134,6 +138,19 @@
  * mounted with a fat32 filesystem.
  */
 
+#ifdef CONFIG_FS_ROMFS_INDEX
+/* One slot of the path lookup index.  A slot with rh_offset == 0 is unused
+ * (offset zero holds the volume header).
+ */
+
+struct romfs_hashent_s
+{
+  uint32_t rh_hash;                 /* Hash of the directory and the name */
+  uint32_t rh_dir;                  /* Offset of the directory's first entry */
+  uint32_t rh_offset;               /* Offset of the file header */
+};
+#endif
+
 struct romfs_file_s;
 struct romfs_mountpt_s
 {
@@ -149,6 +166,11 @@ struct romfs_mountpt_s
   uint32_t rm_cachesector;          /* Current sector in the rm_buffer */
   uint8_t *rm_xipbase;              /* Base address of directly accessible media */
   uint8_t *rm_buffer;               /* Device sector buffer, allocated if rm_xipbase==0 */
+#ifdef CONFIG_FS_ROMFS_INDEX
+  FAR struct romfs_hashent_s *rm_index; /* Path lookup index, NULL if none */
+  uint32_t rm_nslots;               /* Number of slots in rm_index */
+  uint32_t rm_nentries;             /* Number of used slots in rm_index */
+#endif
 };
 
 /* This structure represents on open file under the mountpoint.  An instance
@@ -223,6 +245,10 @@ int  romfs_parsefilename(FAR struct romfs_mountpt_s *rm, uint32_t offset,
        FAR char *pname);
 int  romfs_datastart(FAR struct romfs_mountpt_s *rm, uint32_t offset,
        FAR uint32_t *start);
+#ifdef CONFIG_FS_ROMFS_INDEX
+int  romfs_buildindex(FAR struct romfs_mountpt_s *rm);
+void romfs_freeindex(FAR struct romfs_mountpt_s *rm);
+#endif
 
 #undef EXTERN
 #if defined(__cplusplus)
@@ -256,6 +256,150 @@ static int romfs_followhardlinks(struct romfs_mountpt_s *rm, uint32_t offset,
   return -ELOOP;
 }
 
+/****************************************************************************
+ * Name: romfs_hashname
+ *
+ * Description:
+ *   Return the index hash of the entry 'name' in the directory whose first
+ *   entry is at offset 'dir'.
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_FS_ROMFS_INDEX
+static uint32_t romfs_hashname(uint32_t dir, const char *name, int namelen)
+{
+  uint32_t hash = 2166136261u ^ dir;
+  int i;
+
+  /* FNV-1a */
+
+  for (i = 0; i < namelen; i++)
+    {
+      hash ^= (uint8_t)name[i];
+      hash *= 16777619u;
+    }
+
+  return hash;
+}
+
+/****************************************************************************
+ * Name: romfs_insertindex
+ *
+ * Description:
+ *   Insert an entry into an index table with a free slot.
+ *
+ ****************************************************************************/
+
+static void romfs_insertindex(struct romfs_hashent_s *index,
+                              uint32_t nslots,
+                              const struct romfs_hashent_s *entry)
+{
+  uint32_t slot;
+
+  for (slot = entry->rh_hash & (nslots - 1);
+       index[slot].rh_offset != 0;
+       slot = (slot + 1) & (nslots - 1));
+
+  index[slot] = *entry;
+}
+
+/****************************************************************************
+ * Name: romfs_addindex
+ *
+ * Description:
+ *   Add the file header at 'offset' in the directory 'dir' to the index,
+ *   growing the index as needed.
+ *
+ ****************************************************************************/
+
+static int romfs_addindex(struct romfs_mountpt_s *rm, uint32_t dir,
+                          uint32_t offset, const char *name)
+{
+  struct romfs_hashent_s entry;
+  struct romfs_hashent_s *index;
+  uint32_t nslots;
+  uint32_t i;
+
+  if ((rm->rm_nentries + 1) * 2 > rm->rm_nslots)
+    {
+      nslots = rm->rm_nslots ? rm->rm_nslots * 2 : ROMFS_INDEX_MINSLOTS;
+      index  = (struct romfs_hashent_s *)
+        kmm_zalloc(nslots * sizeof(struct romfs_hashent_s));
+      if (!index)
+        {
+          return -ENOMEM;
+        }
+
+      for (i = 0; i < rm->rm_nslots; i++)
+        {
+          if (rm->rm_index[i].rh_offset != 0)
+            {
+              romfs_insertindex(index, nslots, &rm->rm_index[i]);
+            }
+        }
+
+      if (rm->rm_index)
+        {
+          kmm_free(rm->rm_index);
+        }
+
+      rm->rm_index  = index;
+      rm->rm_nslots = nslots;
+    }
+
+  entry.rh_hash   = romfs_hashname(dir, name, strlen(name));
+  entry.rh_dir    = dir;
+  entry.rh_offset = offset;
+
+  romfs_insertindex(rm->rm_index, rm->rm_nslots, &entry);
+  rm->rm_nentries++;
+  return OK;
+}
+
+/****************************************************************************
+ * Name: romfs_searchindex
+ *
+ * Description:
+ *   This is part of the romfs_finddirentry log.  Find entryname in the
+ *   directory beginning at dirinfo->fr_firstoffset using the index.  Each
+ *   candidate is verified against the file header in the image.
+ *
+ ****************************************************************************/
+
+static int romfs_searchindex(struct romfs_mountpt_s *rm,
+                             const char *entryname, int entrylen,
+                             struct romfs_dirinfo_s *dirinfo)
+{
+  struct romfs_hashent_s *entry;
+  uint32_t dir = dirinfo->rd_dir.fr_firstoffset;
+  uint32_t hash;
+  uint32_t slot;
+  int ret;
+
+  hash = romfs_hashname(dir, entryname, entrylen);
+
+  for (slot = hash & (rm->rm_nslots - 1);
+       rm->rm_index[slot].rh_offset != 0;
+       slot = (slot + 1) & (rm->rm_nslots - 1))
+    {
+      entry = &rm->rm_index[slot];
+      if (entry->rh_hash == hash && entry->rh_dir == dir)
+        {
+          ret = romfs_checkentry(rm, entry->rh_offset, entryname, entrylen,
+                                 dirinfo);
+          if (ret != -ENOENT)
+            {
+              return ret;
+            }
+        }
+    }
+
+  /* The index holds every entry, so there is nothing with that name */
+
+  return -ENOENT;
+}
+#endif
+
 /****************************************************************************
  * Name: romfs_searchdir
  *
@@ -274,6 +418,13 @@ static inline int romfs_searchdir(struct romfs_mountpt_s *rm,
   int16_t  ndx;
   int      ret;
 
+#ifdef CONFIG_FS_ROMFS_INDEX
+  if (rm->rm_index)
+    {
+      return romfs_searchindex(rm, entryname, entrylen, dirinfo);
+    }
+#endif
+
   /* Then loop through the current directory until the directory
    * with the matching name is found.  Or until all of the entries
    * the directory have been examined.
@@ -974,3 +1125,142 @@ int romfs_datastart(struct romfs_mountpt_s *rm, uint32_t offset,
 
   return -EINVAL; /* Won't get here */
 }
+
+/****************************************************************************
+ * Name: romfs_buildindex
+ *
+ * Description:
+ *   Walk all directories of the file system and add every directory entry
+ *   to the path lookup index.  This is called as part of the ROMFS mount
+ *   operation.
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_FS_ROMFS_INDEX
+int romfs_buildindex(struct romfs_mountpt_s *rm)
+{
+  char      name[NAME_MAX + 1];
+  uint32_t *dirs;
+  uint32_t *newdirs;
+  uint32_t  maxentries;
+  uint32_t  maxdirs;
+  uint32_t  ndirs;
+  uint32_t  offset;
+  uint32_t  next;
+  uint32_t  info;
+  uint32_t  dir;
+  uint32_t  i;
+  int16_t   ndx;
+  int       ret = OK;
+
+  /* Each file header takes at least 32 bytes.  More entries can only be
+   * found in a corrupted image with a loop.
+   */
+
+  maxentries = rm->rm_volsize / 32;
+
+  /* The directories still to be walked, beginning with the root */
+
+  maxdirs = 16;
+  dirs    = (uint32_t *)kmm_malloc(maxdirs * sizeof(uint32_t));
+  if (!dirs)
+    {
+      return -ENOMEM;
+    }
+
+  dirs[0] = rm->rm_rootoffset;
+  ndirs   = 1;
+
+  for (i = 0; i < ndirs && ret >= 0; i++)
+    {
+      dir    = dirs[i];
+      offset = dir;
+
+      while (offset != 0)
+        {
+          if (rm->rm_nentries >= maxentries)
+            {
+              ret = -EINVAL;
+              break;
+            }
+
+          /* Get the raw header:  Hard links (including "." and "..") are
+           * indexed, but not followed.
+           */
+
+          ndx = romfs_devcacheread(rm, offset);
+          if (ndx < 0)
+            {
+              ret = ndx;
+              break;
+            }
+
+          next = romfs_devread32(rm, ndx + ROMFS_FHDR_NEXT);
+          info = romfs_devread32(rm, ndx + ROMFS_FHDR_INFO);
+
+          ret = romfs_parsefilename(rm, offset, name);
+          if (ret >= 0)
+            {
+              ret = romfs_addindex(rm, dir, offset, name);
+            }
+
+          if (ret < 0)
+            {
+              break;
+            }
+
+          /* Walk sub-directories later */
+
+          if (IS_DIRECTORY(next) && info != 0)
+            {
+              if (ndirs >= maxdirs)
+                {
+                  newdirs = (uint32_t *)
+                    kmm_realloc(dirs, 2 * maxdirs * sizeof(uint32_t));
+                  if (!newdirs)
+                    {
+                      ret = -ENOMEM;
+                      break;
+                    }
+
+                  dirs     = newdirs;
+                  maxdirs *= 2;
+                }
+
+              dirs[ndirs++] = info;
+            }
+
+          offset = next & RFNEXT_OFFSETMASK;
+        }
+    }
+
+  kmm_free(dirs);
+
+  if (ret < 0)
+    {
+      romfs_freeindex(rm);
+    }
+
+  return ret;
+}
+
+/****************************************************************************
+ * Name: romfs_freeindex
+ *
+ * Description:
+ *   Free the path lookup index.  Lookups then search the directories.
+ *
+ ****************************************************************************/
+
+void romfs_freeindex(struct romfs_mountpt_s *rm)
+{
+  if (rm->rm_index)
+    {
+      kmm_free(rm->rm_index);
+    }
+
+  rm->rm_index    = NULL;
+  rm->rm_nslots   = 0;
+  rm->rm_nentries = 0;
+}
+#endif
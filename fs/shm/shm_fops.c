@@ -0,0 +1,267 @@
+/****************************************************************************
+ * fs/shm/shm_fops.c
+ *
+ *   Copyright (C) 2020 Gregory Nutt. All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in
+ *    the documentation and/or other materials provided with the
+ *    distribution.
+ * 3. Neither the name NuttX nor the names of its contributors may be
+ *    used to endorse or promote products derived from this software
+ *    without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+ * FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE
+ * COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+ * INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,
+ * BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS
+ * OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED
+ * AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ * LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN
+ * ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ *
+ ****************************************************************************/
+
+/****************************************************************************
+ * Included Files
+ ****************************************************************************/
+
+#include <nuttx/config.h>
+
+#include <sys/types.h>
+#include <stdint.h>
+#include <string.h>
+#include <errno.h>
+#include <assert.h>
+
+#include <nuttx/kmalloc.h>
+#include <nuttx/fs/fs.h>
+#include <nuttx/fs/ioctl.h>
+
+#include "inode/inode.h"
+#include "shm/shm.h"
+
+/****************************************************************************
+ * Pre-processor Definitions
+ ****************************************************************************/
+
+#ifndef MIN
+#  define MIN(a,b) ((a) < (b) ? (a) : (b))
+#endif
+
+/****************************************************************************
+ * Private Function Prototypes
+ ****************************************************************************/
+
+static ssize_t shm_read(FAR struct file *filep, FAR char *buffer,
+                        size_t buflen);
+static ssize_t shm_write(FAR struct file *filep, FAR const char *buffer,
+                         size_t buflen);
+static int     shm_ioctl(FAR struct file *filep, int cmd,
+                         unsigned long arg);
+
+/****************************************************************************
+ * Public Data
+ ****************************************************************************/
+
+const struct file_operations g_shm_operations =
+{
+  NULL,         /* open */
+  NULL,         /* close */
+  shm_read,     /* read */
+  shm_write,    /* write */
+  NULL,         /* seek */
+  shm_ioctl,    /* ioctl */
+  NULL          /* poll */
+#ifndef CONFIG_DISABLE_PSEUDOFS_OPERATIONS
+  , NULL        /* unlink */
+#endif
+};
+
+/****************************************************************************
+ * Private Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: shm_truncate
+ *
+ * Description:
+ *   Set the size of the shared memory object.  New memory is zeroed.  Once
+ *   the object has been mapped, its memory cannot move, so it may then only
+ *   be shrunk.
+ *
+ ****************************************************************************/
+
+static int shm_truncate(FAR struct shm_object_s *object, off_t length)
+{
+  FAR void *paddr;
+
+  if (length < 0)
+    {
+      return -EINVAL;
+    }
+
+  if ((size_t)length <= object->length && object->paddr != NULL)
+    {
+      /* Keep the memory, only the size of the object changes */
+
+      object->length = length;
+      return OK;
+    }
+
+  if (object->mapped)
+    {
+      return -EBUSY;
+    }
+
+  paddr = kumm_realloc(object->paddr, length > 0 ? length : 1);
+  if (paddr == NULL)
+    {
+      return -ENOMEM;
+    }
+
+  if ((size_t)length > object->length)
+    {
+      memset((FAR uint8_t *)paddr + object->length, 0,
+             length - object->length);
+    }
+
+  object->paddr  = paddr;
+  object->length = length;
+  return OK;
+}
+
+/****************************************************************************
+ * Name: shm_read
+ ****************************************************************************/
+
+static ssize_t shm_read(FAR struct file *filep, FAR char *buffer,
+                        size_t buflen)
+{
+  FAR struct shm_object_s *object = filep->f_inode->i_private;
+  ssize_t nread = 0;
+
+  inode_semtake();
+  if (filep->f_pos < object->length)
+    {
+      nread = MIN(buflen, object->length - filep->f_pos);
+      memcpy(buffer, (FAR uint8_t *)object->paddr + filep->f_pos, nread);
+      filep->f_pos += nread;
+    }
+
+  inode_semgive();
+  return nread;
+}
+
+/****************************************************************************
+ * Name: shm_write
+ ****************************************************************************/
+
+static ssize_t shm_write(FAR struct file *filep, FAR const char *buffer,
+                         size_t buflen)
+{
+  FAR struct shm_object_s *object = filep->f_inode->i_private;
+  ssize_t nwritten = 0;
+
+  /* Writes do not extend the object; use ftruncate() to size it */
+
+  inode_semtake();
+  if (filep->f_pos >= object->length)
+    {
+      nwritten = buflen > 0 ? -EFBIG : 0;
+    }
+  else
+    {
+      nwritten = MIN(buflen, object->length - filep->f_pos);
+      memcpy((FAR uint8_t *)object->paddr + filep->f_pos, buffer, nwritten);
+      filep->f_pos += nwritten;
+    }
+
+  inode_semgive();
+  return nwritten;
+}
+
+/****************************************************************************
+ * Name: shm_ioctl
+ ****************************************************************************/
+
+static int shm_ioctl(FAR struct file *filep, int cmd, unsigned long arg)
+{
+  FAR struct shm_object_s *object = filep->f_inode->i_private;
+  int ret;
+
+  inode_semtake();
+  switch (cmd)
+    {
+      /* Return the address of the memory.  There is nothing to map in a
+       * flat address space; all mappings of the object share the same
+       * memory.
+       */
+
+      case FIOC_MMAP:
+        {
+          FAR void **ppv = (FAR void **)((uintptr_t)arg);
+
+          if (ppv == NULL || object->paddr == NULL)
+            {
+              ret = -EINVAL;
+              break;
+            }
+
+          object->mapped = true;
+          *ppv = object->paddr;
+          ret  = OK;
+        }
+        break;
+
+      case FIOC_TRUNCATE:
+        ret = shm_truncate(object, (off_t)arg);
+        break;
+
+      default:
+        ret = -ENOTTY;
+        break;
+    }
+
+  inode_semgive();
+  return ret;
+}
+
+/****************************************************************************
+ * Public Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: shm_release
+ *
+ * Description:
+ *   Free the shared memory object of the inode.  Called by inode_free()
+ *   when the last reference to an unlinked object is released.
+ *
+ ****************************************************************************/
+
+void shm_release(FAR struct inode *inode)
+{
+  FAR struct shm_object_s *object = inode->i_private;
+
+  if (object != NULL)
+    {
+      if (object->paddr != NULL)
+        {
+          kumm_free(object->paddr);
+        }
+
+      kmm_free(object);
+      inode->i_private = NULL;
+    }
+}
@@ -0,0 +1,240 @@
+/****************************************************************************
+ * fs/shm/shm_open.c
+ *
+ *   Copyright (C) 2020 Gregory Nutt. All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in
+ *    the documentation and/or other materials provided with the
+ *    distribution.
+ * 3. Neither the name NuttX nor the names of its contributors may be
+ *    used to endorse or promote products derived from this software
+ *    without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+ * FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE
+ * COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+ * INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,
+ * BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS
+ * OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED
+ * AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ * LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN
+ * ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ *
+ ****************************************************************************/
+
+/****************************************************************************
+ * Included Files
+ ****************************************************************************/
+
+#include <nuttx/config.h>
+
+#include <sys/types.h>
+#include <sys/mman.h>
+#include <stdio.h>
+#include <fcntl.h>
+#include <sched.h>
+#include <errno.h>
+#include <assert.h>
+
+#include <nuttx/kmalloc.h>
+#include <nuttx/fs/fs.h>
+#include <nuttx/fs/ioctl.h>
+
+#include "inode/inode.h"
+#include "shm/shm.h"
+
+/****************************************************************************
+ * Public Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: shm_open
+ *
+ * Description:
+ *   Establish a connection between a shared memory object and a file
+ *   descriptor.  A new object has a size of zero; ftruncate() sets the size
+ *   and mmap() then returns the address of the memory of the object.
+ *   Because NuttX runs in a flat address space, every task that maps the
+ *   object gets the same address and no data is copied.
+ *
+ *   The object persists until it is removed with shm_unlink() and the last
+ *   file descriptor referring to it is closed.  Mappings of the object must
+ *   not be used after that.
+ *
+ * Input Parameters:
+ *   name  - The name of the shared memory object.  A leading '/' is
+ *     ignored.
+ *   oflag - O_RDONLY or O_RDWR, optionally with O_CREAT, O_EXCL and
+ *     O_TRUNC.
+ *   mode  - The permissions of a new object.
+ *
+ * Returned Value:
+ *   A non-negative file descriptor on success.  Otherwise, -1 (ERROR) is
+ *   returned and the errno variable is set appropriately.
+ *
+ ****************************************************************************/
+
+int shm_open(FAR const char *name, int oflag, mode_t mode)
+{
+  FAR struct shm_object_s *object;
+  FAR struct file *filep;
+  FAR struct inode *inode;
+  struct inode_search_s desc;
+  char fullpath[MAX_SHMPATH];
+  int errcode;
+  int ret;
+  int fd;
+
+  /* Make sure that a valid name is supplied */
+
+  if (name != NULL)
+    {
+      while (*name == '/')
+        {
+          name++;
+        }
+    }
+
+  if (name == NULL || *name == '\0' || (oflag & O_RDOK) == 0)
+    {
+      set_errno(EINVAL);
+      return ERROR;
+    }
+
+  /* The check for the existence of the object and its creation must be
+   * atomic with respect to other tasks executing shm_open().
+   */
+
+  sched_lock();
+
+  /* Get the full path to the shared memory object */
+
+  snprintf(fullpath, MAX_SHMPATH, CONFIG_FS_SHMPATH "/%s", name);
+
+  /* Get the inode for this object.  This should succeed if the object has
+   * already been created.  In this case, inode_find() will have incremented
+   * the reference count on the inode.
+   */
+
+  SETUP_SEARCH(&desc, fullpath, false);
+
+  ret = inode_find(&desc);
+  if (ret >= 0)
+    {
+      /* Something exists at this path.  Get the search results */
+
+      inode = desc.node;
+      DEBUGASSERT(inode != NULL);
+
+      /* Verify that the inode is a shared memory object */
+
+      if (!INODE_IS_SHM(inode))
+        {
+          errcode = ENXIO;
+          goto errout_with_inode;
+        }
+
+      /* It exists.  Check if the caller wanted to create a new object */
+
+      if ((oflag & (O_CREAT | O_EXCL)) == (O_CREAT | O_EXCL))
+        {
+          errcode = EEXIST;
+          goto errout_with_inode;
+        }
+    }
+  else
+    {
+      /* The object does not exist.  Were we asked to create it? */
+
+      if ((oflag & O_CREAT) == 0)
+        {
+          errcode = ENOENT;
+          goto errout_with_search;
+        }
+
+      object = (FAR struct shm_object_s *)
+        kmm_zalloc(sizeof(struct shm_object_s));
+      if (object == NULL)
+        {
+          errcode = ENOMEM;
+          goto errout_with_search;
+        }
+
+      /* Create an inode in the pseudo-filesystem at this path */
+
+      inode_semtake();
+      ret = inode_reserve(fullpath, &inode);
+      inode_semgive();
+
+      if (ret < 0)
+        {
+          kmm_free(object);
+          errcode = -ret;
+          goto errout_with_search;
+        }
+
+      /* The inode takes the ownership of the object.  The reference count
+       * is held by the file descriptor.
+       */
+
+      INODE_SET_SHM(inode);
+      inode->u.i_ops   = &g_shm_operations;
+      inode->i_private = object;
+      inode->i_crefs   = 1;
+#ifdef CONFIG_FILE_MODE
+      inode->i_mode    = mode;
+#else
+      UNUSED(mode);
+#endif
+    }
+
+  /* Associate the inode with a file structure */
+
+  fd = files_allocate(inode, oflag & O_RDWR, 0, 0);
+  if (fd < 0)
+    {
+      errcode = EMFILE;
+      goto errout_with_inode;
+    }
+
+  /* Truncate an existing object, if so requested */
+
+  if ((oflag & (O_TRUNC | O_WROK)) == (O_TRUNC | O_WROK))
+    {
+      ret = fs_getfilep(fd, &filep);
+      if (ret >= 0)
+        {
+          ret = inode->u.i_ops->ioctl(filep, FIOC_TRUNCATE, 0);
+        }
+
+      if (ret < 0)
+        {
+          files_release(fd);
+          errcode = -ret;
+          goto errout_with_inode;
+        }
+    }
+
+  RELEASE_SEARCH(&desc);
+  sched_unlock();
+  return fd;
+
+errout_with_inode:
+  inode_release(inode);
+
+errout_with_search:
+  RELEASE_SEARCH(&desc);
+  sched_unlock();
+  set_errno(errcode);
+  return ERROR;
+}
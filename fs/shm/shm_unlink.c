@@ -0,0 +1,166 @@
+/****************************************************************************
+ * fs/shm/shm_unlink.c
+ *
+ *   Copyright (C) 2020 Gregory Nutt. All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in
+ *    the documentation and/or other materials provided with the
+ *    distribution.
+ * 3. Neither the name NuttX nor the names of its contributors may be
+ *    used to endorse or promote products derived from this software
+ *    without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+ * FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE
+ * COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+ * INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,
+ * BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS
+ * OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED
+ * AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ * LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN
+ * ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ *
+ ****************************************************************************/
+
+/****************************************************************************
+ * Included Files
+ ****************************************************************************/
+
+#include <nuttx/config.h>
+
+#include <sys/mman.h>
+#include <stdio.h>
+#include <sched.h>
+#include <errno.h>
+#include <assert.h>
+
+#include <nuttx/fs/fs.h>
+
+#include "inode/inode.h"
+#include "shm/shm.h"
+
+/****************************************************************************
+ * Public Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: shm_unlink
+ *
+ * Description:
+ *   Remove the name of the shared memory object.  If the object is still
+ *   open, its memory is freed when the last file descriptor referring to it
+ *   is closed.
+ *
+ * Input Parameters:
+ *   name - The name of the shared memory object
+ *
+ * Returned Value:
+ *  0 (OK), or -1 (ERROR) if unsuccessful.
+ *
+ ****************************************************************************/
+
+int shm_unlink(FAR const char *name)
+{
+  FAR struct inode *inode;
+  struct inode_search_s desc;
+  char fullpath[MAX_SHMPATH];
+  int errcode;
+  int ret;
+
+  /* Make sure that a valid name is supplied */
+
+  if (name != NULL)
+    {
+      while (*name == '/')
+        {
+          name++;
+        }
+    }
+
+  if (name == NULL || *name == '\0')
+    {
+      set_errno(EINVAL);
+      return ERROR;
+    }
+
+  /* Get the full path to the shared memory object */
+
+  snprintf(fullpath, MAX_SHMPATH, CONFIG_FS_SHMPATH "/%s", name);
+
+  /* Get the inode for this object. */
+
+  SETUP_SEARCH(&desc, fullpath, false);
+
+  sched_lock();
+  ret = inode_find(&desc);
+  if (ret < 0)
+    {
+      /* There is no inode that includes in this path */
+
+      errcode = -ret;
+      goto errout_with_search;
+    }
+
+  /* Get the search results */
+
+  inode = desc.node;
+  DEBUGASSERT(inode != NULL);
+
+  /* Verify that what we found is, indeed, a shared memory object */
+
+  if (!INODE_IS_SHM(inode))
+    {
+      errcode = ENXIO;
+      goto errout_with_inode;
+    }
+
+  /* Refuse to unlink the inode if it has children.  I.e., if it is
+   * functioning as a directory and the directory is not empty.
+   */
+
+  inode_semtake();
+  if (inode->i_child != NULL)
+    {
+      errcode = ENOTEMPTY;
+      goto errout_with_semaphore;
+    }
+
+  /* Remove the old inode from the tree.  Because we hold a reference count
+   * on the inode, it will not be deleted now.  This will set the
+   * FSNODEFLAG_DELETED bit in the inode flags.
+   */
+
+  ret = inode_remove(fullpath);
+  DEBUGASSERT(ret >= 0 || ret == -EBUSY);
+  UNUSED(ret);
+
+  /* Release our reference.  The object is freed now if it is not open. */
+
+  inode_semgive();
+  inode_release(inode);
+  RELEASE_SEARCH(&desc);
+  sched_unlock();
+  return OK;
+
+errout_with_semaphore:
+  inode_semgive();
+
+errout_with_inode:
+  inode_release(inode);
+
+errout_with_search:
+  RELEASE_SEARCH(&desc);
+  set_errno(errcode);
+  sched_unlock();
+  return ERROR;
+}
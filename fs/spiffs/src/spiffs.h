@@ -64,6 +64,16 @@ extern "C"
  * Pre-processor Definitions
  ****************************************************************************/
 
+/* Configuration */
+
+#ifndef CONFIG_SPIFFS_CACHE_WRPAGES
+#  define CONFIG_SPIFFS_CACHE_WRPAGES   0
+#endif
+
+#ifndef CONFIG_SPIFFS_NDXCACHE_SIZE
+#  define CONFIG_SPIFFS_NDXCACHE_SIZE   0
+#endif
+
 /* Flags on open file/directory options */
 
 #define SFO_FLAG_UNLINKED               (1 << 0)
@@ -117,6 +127,17 @@ struct spiffs_sem_s
   uint16_t count;                   /* Number of counts held */
 };
 
+/* Object index cache entry.  Maps an object index page (object ID and
+ * span index) to its last known physical page.
+ */
+
+struct spiffs_ndxcache_s
+{
+  int16_t objid;                    /* Object ID (with SPIFFS_OBJID_NDXFLAG) */
+  int16_t spndx;                    /* Object index span index */
+  int16_t pgndx;                    /* Page index, zero if unused */
+};
+
 /* spiffs SPI configuration struct */
 
 /* This structure represents the current state of an SPIFFS volume */
@@ -148,9 +169,13 @@ struct spiffs_s
   uint32_t stats_gc_runs;
 #endif
   uint32_t cache_size;              /* Cache size */
-#ifdef CONFIG_SPIFFS_CACHEDBG
   uint32_t cache_hits;              /* Number of cache hits */
   uint32_t cache_misses;            /* Number of cache misses */
+  uint32_t cache_evictions;         /* Number of cache pages evicted */
+  uint32_t ndx_hits;                /* Index pages found in the index cache */
+  uint32_t ndx_misses;              /* Index pages found by lookup scan */
+#if CONFIG_SPIFFS_NDXCACHE_SIZE > 0
+  struct spiffs_ndxcache_s ndxcache[CONFIG_SPIFFS_NDXCACHE_SIZE];
 #endif
   int16_t free_blkndx;              /* Cursor for free blocks, block index */
   int16_t lu_blkndx;                /* Cursor when searching, block index */
@@ -46,6 +46,7 @@
 #include <nuttx/config.h>
 
 #include <string.h>
+#include <errno.h>
 #include <debug.h>
 
 #include <nuttx/mtd/mtd.h>
@@ -59,6 +60,45 @@
  * Private Functions
  ****************************************************************************/
 
+/****************************************************************************
+ * Name: spiffs_cache_partition
+ *
+ * Description:
+ *   Returns the range of cache page indices that may hold read or write
+ *   cache pages.  If no pages are reserved for write caching, then both
+ *   types of cache pages share the whole cache.
+ *
+ * Input Parameters:
+ *   cache - A reference to the cache
+ *   wr    - True:  Return the write partition, False:  The read partition
+ *   first - The location to return the first cache page index
+ *   last  - The location to return the cache page index after the last
+ *
+ * Returned Value:
+ *   None
+ *
+ ****************************************************************************/
+
+static void spiffs_cache_partition(FAR struct spiffs_cache_s *cache,
+                                   bool wr, FAR int *first, FAR int *last)
+{
+  if (cache->cpage_wrcount == 0)
+    {
+      *first = 0;
+      *last  = cache->cpage_count;
+    }
+  else if (wr)
+    {
+      *first = 0;
+      *last  = cache->cpage_wrcount;
+    }
+  else
+    {
+      *first = cache->cpage_wrcount;
+      *last  = cache->cpage_count;
+    }
+}
+
 /****************************************************************************
  * Name: spiffs_cache_page_get
  *
@@ -79,19 +119,22 @@ FAR static FAR struct spiffs_cache_page_s *
 {
   FAR struct spiffs_cache_s *cache;
   FAR struct spiffs_cache_page_s *cp;
+  int first;
+  int last;
   int i;
 
   cache = spiffs_get_cache(fs);
-  if ((cache->cpage_use_map & cache->cpage_use_mask) == 0)
+  if (cache->cpage_nused == 0)
     {
       return 0;
     }
 
-  for (i = 0; i < cache->cpage_count; i++)
+  spiffs_cache_partition(cache, false, &first, &last);
+  for (i = first; i < last; i++)
     {
       cp = spiffs_get_cache_page_hdr(fs, cache, i);
 
-      if ((cache->cpage_use_map & (1 << i)) != 0 &&
+      if ((cp->flags & SPIFFS_CACHE_FLAG_INUSE) != 0 &&
           (cp->flags & SPIFFS_CACHE_FLAG_TYPE_WR) == 0 &&
            cp->pgndx == pgndx)
         {
@@ -130,7 +173,7 @@ static int spiffs_cache_page_free(FAR struct spiffs_s *fs, int cpndx,
   cache = spiffs_get_cache(fs);
   cp    = spiffs_get_cache_page_hdr(fs, cache, cpndx);
 
-  if (cache->cpage_use_map & (1 << cpndx))
+  if ((cp->flags & SPIFFS_CACHE_FLAG_INUSE) != 0)
     {
       if (write_back &&
           (cp->flags & SPIFFS_CACHE_FLAG_TYPE_WR) == 0 &&
@@ -158,7 +201,7 @@ static int spiffs_cache_page_free(FAR struct spiffs_s *fs, int cpndx,
                            cpndx, cp->pgndx);
         }
 
-      cache->cpage_use_map &= ~(1 << cpndx);
+      cache->cpage_nused--;
       cp->flags = 0;
     }
 
@@ -169,12 +212,13 @@ static int spiffs_cache_page_free(FAR struct spiffs_s *fs, int cpndx,
  * Name: spiffs_cache_page_remove_oldest
  *
  * Description:
- *   Removes the oldest accessed cached page
+ *   Removes the oldest accessed read cache page from the read or write
+ *   partition of the cache.  Nothing is removed if the partition still has
+ *   a free cache page.
  *
  * Input Parameters:
- *   fs         - A reference to the SPIFFS volume object instance
- *   cpndx      - Cache page index
- *   write_back - True:  Write dirty pages back to hardware
+ *   fs - A reference to the SPIFFS volume object instance
+ *   wr - True:  Make room in the write partition
  *
  * Returned Value:
  *   Zero (OK) is returned on success; A negated errno value is returned on
@@ -182,35 +226,41 @@ static int spiffs_cache_page_free(FAR struct spiffs_s *fs, int cpndx,
  *
  ****************************************************************************/
 
-static int spiffs_cache_page_remove_oldest(FAR struct spiffs_s *fs,
-                                           uint8_t flag_mask, uint8_t flags)
+static int spiffs_cache_page_remove_oldest(FAR struct spiffs_s *fs, bool wr)
 {
   FAR struct spiffs_cache_s *cache = spiffs_get_cache(fs);
+  FAR struct spiffs_cache_page_s *cp;
   uint32_t oldest_val = 0;
   int cpndx = -1;
+  int first;
+  int last;
   int ret = OK;
   int i;
 
   /* Don't remove any cache pages unless there are no free cache pages */
 
-  if ((cache->cpage_use_map & cache->cpage_use_mask) != cache->cpage_use_mask)
+  spiffs_cache_partition(cache, wr, &first, &last);
+  for (i = first; i < last; i++)
     {
-      /* At least one free cpage */
+      cp = spiffs_get_cache_page_hdr(fs, cache, i);
+      if ((cp->flags & SPIFFS_CACHE_FLAG_INUSE) == 0)
+        {
+          /* At least one free cpage */
 
-      return OK;
+          return OK;
+        }
     }
 
-  /* All busy, scan through all to find the cache page which has oldest
-   * access time.
+  /* All busy, scan through all to find the read cache page which has the
+   * oldest access time.  Write cache pages belong to open files and are
+   * never evicted here.
    */
 
-  for (i = 0; i < cache->cpage_count; i++)
+  for (i = first; i < last; i++)
     {
-      FAR struct spiffs_cache_page_s *cp;
-
       cp = spiffs_get_cache_page_hdr(fs, cache, i);
       if ((cache->last_access - cp->last_access) > oldest_val &&
-          (cp->flags & flag_mask) == flags)
+          (cp->flags & SPIFFS_CACHE_FLAG_TYPE_WR) == 0)
         {
           oldest_val = cache->last_access - cp->last_access;
           cpndx = i;
@@ -221,6 +271,7 @@ static int spiffs_cache_page_remove_oldest(FAR struct spiffs_s *fs,
 
   if (cpndx >= 0)
     {
+      fs->cache_evictions++;
       ret = spiffs_cache_page_free(fs, cpndx, true);
     }
 
@@ -232,12 +283,12 @@ static int spiffs_cache_page_remove_oldest(FAR struct spiffs_s *fs,
  *
  * Description:
  *   Allocates a new cached page and returns it, or null if all cache pages
- *   are busy.
+ *   in the partition are busy.
  *
  * Input Parameters:
- *   fs         - A reference to the SPIFFS volume object instance
- *   cpndx      - Cache page index
- *   write_back - True:  Write dirty pages back to hardware
+ *   fs    - A reference to the SPIFFS volume object instance
+ *   flags - The initial cache page flags.  SPIFFS_CACHE_FLAG_TYPE_WR
+ *           selects the write partition.
  *
  * Returned Value:
  *   A reference to the allocated cache page.  NULL is returned if we were
@@ -246,15 +297,17 @@ static int spiffs_cache_page_remove_oldest(FAR struct spiffs_s *fs,
  ****************************************************************************/
 
 static FAR struct spiffs_cache_page_s *
-  spiffs_cache_page_allocate(FAR struct spiffs_s *fs)
+  spiffs_cache_page_allocate(FAR struct spiffs_s *fs, uint8_t flags)
 {
   FAR struct spiffs_cache_s *cache;
+  int first;
+  int last;
   int i;
 
   /* Check if any cache pages are available */
 
   cache = spiffs_get_cache(fs);
-  if (cache->cpage_use_map == 0xffffffff)
+  if (cache->cpage_nused >= cache->cpage_count)
     {
       /* No.. Out of cache memory */
 
@@ -263,17 +316,20 @@ static FAR struct spiffs_cache_page_s *
 
   /* Search for a free cache page */
 
-  for (i = 0; i < cache->cpage_count; i++)
+  spiffs_cache_partition(cache, (flags & SPIFFS_CACHE_FLAG_TYPE_WR) != 0,
+                         &first, &last);
+  for (i = first; i < last; i++)
     {
-      if ((cache->cpage_use_map & (1 << i)) == 0)
-        {
-          FAR struct spiffs_cache_page_s *cp;
+      FAR struct spiffs_cache_page_s *cp;
 
+      cp = spiffs_get_cache_page_hdr(fs, cache, i);
+      if ((cp->flags & SPIFFS_CACHE_FLAG_INUSE) == 0)
+        {
           /* We found one */
 
-          cp                    = spiffs_get_cache_page_hdr(fs, cache, i);
-          cache->cpage_use_map |= (1 << i);
-          cp->last_access       = cache->last_access;
+          cache->cpage_nused++;
+          cp->flags       = flags | SPIFFS_CACHE_FLAG_INUSE;
+          cp->last_access = cache->last_access;
           return cp;
         }
     }
@@ -306,7 +362,6 @@ void spiffs_cache_initialize(FAR struct spiffs_s *fs)
 {
   FAR struct spiffs_cache_s *cp;
   struct spiffs_cache_s cache;
-  uint32_t cache_mask = 0;
   uint32_t sz;
   int i;
   int cache_entries;
@@ -325,10 +380,9 @@ void spiffs_cache_initialize(FAR struct spiffs_s *fs)
       return;
     }
 
-  for (i = 0; i < cache_entries; i++)
+  if (cache_entries > UINT16_MAX)
     {
-      cache_mask <<= 1;
-      cache_mask |= 1;
+      cache_entries = UINT16_MAX;
     }
 
   memset(&cache, 0, sizeof(struct spiffs_cache_s));
@@ -336,18 +390,26 @@ void spiffs_cache_initialize(FAR struct spiffs_s *fs)
   cache.cpages         = (FAR uint8_t *)
     ((FAR uint8_t *)fs->cache + sizeof(struct spiffs_cache_s));
 
-  cache.cpage_use_map  = 0xffffffff;
-  cache.cpage_use_mask = cache_mask;
+  /* Reserve the write partition, but always leave at least one page for
+   * read caching.  Otherwise, read and write cache pages share the cache.
+   */
+
+  if (CONFIG_SPIFFS_CACHE_WRPAGES < cache_entries)
+    {
+      cache.cpage_wrcount = CONFIG_SPIFFS_CACHE_WRPAGES;
+    }
+
   memcpy(fs->cache, &cache, sizeof(struct spiffs_cache_s));
 
   cp = spiffs_get_cache(fs);
   memset(cp->cpages, 0, cp->cpage_count * SPIFFS_CACHE_PAGE_SIZE(fs));
 
-  cp->cpage_use_map &= ~(cp->cpage_use_mask);
   for (i = 0; i < cache.cpage_count; i++)
     {
       spiffs_get_cache_page_hdr(fs, cp, i)->cpndx = i;
     }
+
+  spiffs_ndxcache_clear(fs);
 }
 
 /****************************************************************************
@@ -414,9 +476,7 @@ ssize_t spiffs_cache_read(FAR struct spiffs_s *fs, uint8_t op, int16_t objid,
 
       /* We've already got a cache page */
 
-#ifdef CONFIG_SPIFFS_CACHEDBG
       fs->cache_hits++;
-#endif
 
       cp->last_access = cache->last_access;
       mem             = spiffs_get_cache_page(fs, cache, cp->cpndx);
@@ -436,27 +496,22 @@ ssize_t spiffs_cache_read(FAR struct spiffs_s *fs, uint8_t op, int16_t objid,
         }
       else
         {
-#ifdef CONFIG_SPIFFS_CACHEDBG
           fs->cache_misses++;
-#endif
 
           /* This operation will always free one cache page (unless all
            * already free), the result code stems from the write operation
            * of the possibly freed cache page
            */
 
-          ret = spiffs_cache_page_remove_oldest(fs,
-                                                SPIFFS_CACHE_FLAG_TYPE_WR,
-                                                0);
+          ret = spiffs_cache_page_remove_oldest(fs, false);
 
           /* Allocate a new cache page */
 
-          cp = spiffs_cache_page_allocate(fs);
+          cp = spiffs_cache_page_allocate(fs, SPIFFS_CACHE_FLAG_WRTHRU);
           if (cp != NULL)
             {
               FAR uint8_t *mem;
 
-              cp->flags = SPIFFS_CACHE_FLAG_WRTHRU;
               cp->pgndx = SPIFFS_PADDR_TO_PAGE(fs, addr);
 
               spiffs_cacheinfo("Allocated cache page %d for pgndx %04x\n",
@@ -597,26 +652,29 @@ FAR struct spiffs_cache_page_s *
                                 FAR struct spiffs_file_s *fobj)
 {
   FAR struct spiffs_cache_s *cache = spiffs_get_cache(fs);
+  int first;
+  int last;
   int i;
 
-  if ((cache->cpage_use_map & cache->cpage_use_mask) == 0)
+  if (cache->cpage_nused == 0)
     {
       /* All cache pages free, no cache page can be assigned to the ID */
 
       return NULL;
     }
 
-  /* Look at each cache index */
+  /* Look at each cache index in the write partition */
 
-  for (i = 0; i < cache->cpage_count; i++)
+  spiffs_cache_partition(cache, true, &first, &last);
+  for (i = first; i < last; i++)
     {
       FAR struct spiffs_cache_page_s *cp;
 
       /* Is this page available?  Is is writable?  Do the object IDs match? */
 
       cp = spiffs_get_cache_page_hdr(fs, cache, i);
-      if ((cache->cpage_use_map & (1 << i)) &&
-          (cp->flags & SPIFFS_CACHE_FLAG_TYPE_WR) &&
+      if ((cp->flags & SPIFFS_CACHE_FLAG_INUSE) != 0 &&
+          (cp->flags & SPIFFS_CACHE_FLAG_TYPE_WR) != 0 &&
            cp->objid == fobj->objid)
         {
           /* Yes... return the cache page reference */
@@ -657,9 +715,9 @@ FAR struct spiffs_cache_page_s *
    * existing cache page with same object ID
    */
 
-  spiffs_cache_page_remove_oldest(fs, SPIFFS_CACHE_FLAG_TYPE_WR, 0);
+  spiffs_cache_page_remove_oldest(fs, true);
 
-  cp = spiffs_cache_page_allocate(fs);
+  cp = spiffs_cache_page_allocate(fs, SPIFFS_CACHE_FLAG_TYPE_WR);
   if (cp == NULL)
     {
       /* could not get cache page */
@@ -667,8 +725,7 @@ FAR struct spiffs_cache_page_s *
       return NULL;
     }
 
-  cp->flags        = SPIFFS_CACHE_FLAG_TYPE_WR;
-  cp->objid         = fobj->objid;
+  cp->objid        = fobj->objid;
   fobj->cache_page = cp;
 
   spiffs_cacheinfo("Allocated cache page %d for objid=%d\n",
@@ -721,3 +778,88 @@ void spiffs_cache_page_release(FAR struct spiffs_s *fs,
       cp->objid = 0;
     }
 }
+
+#if CONFIG_SPIFFS_NDXCACHE_SIZE > 0
+/****************************************************************************
+ * Name: spiffs_ndxcache_clear
+ *
+ * Description:
+ *   Forget all object index page locations held in the index cache
+ *
+ * Input Parameters:
+ *   fs - A reference to the SPIFFS volume object instance
+ *
+ * Returned Value:
+ *   None
+ *
+ ****************************************************************************/
+
+void spiffs_ndxcache_clear(FAR struct spiffs_s *fs)
+{
+  memset(fs->ndxcache, 0, sizeof(fs->ndxcache));
+}
+
+/****************************************************************************
+ * Name: spiffs_ndxcache_get
+ *
+ * Description:
+ *   Look up the last known page index of an object index page.  The result
+ *   is only a hint:  The index page may have been moved or deleted since it
+ *   was cached, so the caller must verify the page header before using it.
+ *
+ * Input Parameters:
+ *   fs    - A reference to the SPIFFS volume object instance
+ *   objid - The object ID of the index page (with SPIFFS_OBJID_NDXFLAG)
+ *   spndx - The span index of the index page
+ *   pgndx - The location to return the page index
+ *
+ * Returned Value:
+ *   Zero (OK) is returned if the index page is in the cache;  -ENOENT is
+ *   returned otherwise.
+ *
+ ****************************************************************************/
+
+int spiffs_ndxcache_get(FAR struct spiffs_s *fs, int16_t objid,
+                        int16_t spndx, FAR int16_t *pgndx)
+{
+  FAR struct spiffs_ndxcache_s *entry;
+
+  entry = &fs->ndxcache[SPIFFS_NDXCACHE_HASH(objid, spndx)];
+  if (entry->objid == objid && entry->spndx == spndx && entry->pgndx != 0)
+    {
+      *pgndx = entry->pgndx;
+      return OK;
+    }
+
+  return -ENOENT;
+}
+
+/****************************************************************************
+ * Name: spiffs_ndxcache_put
+ *
+ * Description:
+ *   Remember the page index of an object index page, replacing whatever
+ *   entry previously occupied the same index cache slot.
+ *
+ * Input Parameters:
+ *   fs    - A reference to the SPIFFS volume object instance
+ *   objid - The object ID of the index page (with SPIFFS_OBJID_NDXFLAG)
+ *   spndx - The span index of the index page
+ *   pgndx - The page index of the index page
+ *
+ * Returned Value:
+ *   None
+ *
+ ****************************************************************************/
+
+void spiffs_ndxcache_put(FAR struct spiffs_s *fs, int16_t objid,
+                         int16_t spndx, int16_t pgndx)
+{
+  FAR struct spiffs_ndxcache_s *entry;
+
+  entry        = &fs->ndxcache[SPIFFS_NDXCACHE_HASH(objid, spndx)];
+  entry->objid = objid;
+  entry->spndx = spndx;
+  entry->pgndx = pgndx;
+}
+#endif /* CONFIG_SPIFFS_NDXCACHE_SIZE > 0 */
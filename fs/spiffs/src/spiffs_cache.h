@@ -58,11 +58,18 @@ extern "C"
 #define SPIFFS_CACHE_FLAG_OBJLU       (1 << 2)
 #define SPIFFS_CACHE_FLAG_OBJNDX      (1 << 3)
 #define SPIFFS_CACHE_FLAG_DATA        (1 << 4)
+#define SPIFFS_CACHE_FLAG_INUSE       (1 << 5)
 #define SPIFFS_CACHE_FLAG_TYPE_WR     (1 << 7)
 
 #define SPIFFS_CACHE_PAGE_SIZE(fs) \
   (sizeof(struct spiffs_cache_page_s) + SPIFFS_GEO_PAGE_SIZE(fs))
 
+/* Object index cache slot for an object ID / span index pair */
+
+#define SPIFFS_NDXCACHE_HASH(objid, spndx) \
+  ((((uint16_t)(objid) * 31) + (uint16_t)(spndx)) % \
+   CONFIG_SPIFFS_NDXCACHE_SIZE)
+
 #define spiffs_get_cache(fs) \
   ((FAR struct spiffs_cache_s *)((fs)->cache))
 
@@ -99,7 +106,7 @@ extern "C"
 struct spiffs_cache_page_s
 {
   uint8_t flags;             /* Cache flags */
-  uint8_t cpndx;             /* Cache page index */
+  uint16_t cpndx;            /* Cache page index */
   uint32_t last_access;      /* Last access of this cache page */
   union
     {
@@ -121,11 +128,11 @@ struct spiffs_cache_page_s
 
 struct spiffs_cache_s
 {
-  uint8_t cpage_count;
-  uint32_t last_access;
-  uint32_t cpage_use_map;
-  uint32_t cpage_use_mask;
-  FAR uint8_t *cpages;
+  uint16_t cpage_count;      /* Total number of cache pages */
+  uint16_t cpage_wrcount;    /* Pages reserved for write caching (0=shared) */
+  uint16_t cpage_nused;      /* Number of cache pages in use */
+  uint32_t last_access;      /* Access counter */
+  FAR uint8_t *cpages;       /* Cache page headers and data */
 };
 
 /****************************************************************************
@@ -275,6 +282,72 @@ FAR struct spiffs_cache_page_s *
 void spiffs_cache_page_release(FAR struct spiffs_s *fs,
                                FAR struct spiffs_cache_page_s *cp);
 
+#if CONFIG_SPIFFS_NDXCACHE_SIZE > 0
+/****************************************************************************
+ * Name: spiffs_ndxcache_clear
+ *
+ * Description:
+ *   Forget all object index page locations held in the index cache
+ *
+ * Input Parameters:
+ *   fs - A reference to the SPIFFS volume object instance
+ *
+ * Returned Value:
+ *   None
+ *
+ ****************************************************************************/
+
+void spiffs_ndxcache_clear(FAR struct spiffs_s *fs);
+
+/****************************************************************************
+ * Name: spiffs_ndxcache_get
+ *
+ * Description:
+ *   Look up the last known page index of an object index page.  The result
+ *   is only a hint:  The index page may have been moved or deleted since it
+ *   was cached, so the caller must verify the page header before using it.
+ *
+ * Input Parameters:
+ *   fs    - A reference to the SPIFFS volume object instance
+ *   objid - The object ID of the index page (with SPIFFS_OBJID_NDXFLAG)
+ *   spndx - The span index of the index page
+ *   pgndx - The location to return the page index
+ *
+ * Returned Value:
+ *   Zero (OK) is returned if the index page is in the cache;  -ENOENT is
+ *   returned otherwise.
+ *
+ ****************************************************************************/
+
+int spiffs_ndxcache_get(FAR struct spiffs_s *fs, int16_t objid,
+                        int16_t spndx, FAR int16_t *pgndx);
+
+/****************************************************************************
+ * Name: spiffs_ndxcache_put
+ *
+ * Description:
+ *   Remember the page index of an object index page, replacing whatever
+ *   entry previously occupied the same index cache slot.
+ *
+ * Input Parameters:
+ *   fs    - A reference to the SPIFFS volume object instance
+ *   objid - The object ID of the index page (with SPIFFS_OBJID_NDXFLAG)
+ *   spndx - The span index of the index page
+ *   pgndx - The page index of the index page
+ *
+ * Returned Value:
+ *   None
+ *
+ ****************************************************************************/
+
+void spiffs_ndxcache_put(FAR struct spiffs_s *fs, int16_t objid,
+                         int16_t spndx, int16_t pgndx);
+#else
+#  define spiffs_ndxcache_clear(fs)
+#  define spiffs_ndxcache_get(fs,o,s,p)   (-ENOENT)
+#  define spiffs_ndxcache_put(fs,o,s,p)
+#endif
+
 #if defined(__cplusplus)
 }
 #endif
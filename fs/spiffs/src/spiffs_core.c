@@ -966,9 +966,41 @@ int spiffs_objlu_find_id_and_span(FAR struct spiffs_s *fs, int16_t objid,
                                   FAR int16_t *pgndx)
 {
   int16_t blkndx;
+  int16_t hint;
   int entry;
   int ret;
 
+  /* Object index pages are looked up over and over while a file is being
+   * accessed.  Try the object index cache first, but only trust it if the
+   * page header still matches.
+   */
+
+  if ((objid & SPIFFS_OBJID_NDXFLAG) != 0)
+    {
+      if (spiffs_ndxcache_get(fs, objid, spndx, &hint) >= 0)
+        {
+          blkndx = SPIFFS_BLOCK_FOR_PAGE(fs, hint);
+          entry  = SPIFFS_OBJ_LOOKUP_ENTRY_FOR_PAGE(fs, hint);
+
+          ret = spiffs_objlu_find_id_and_span_callback(fs, objid, blkndx,
+                                                       entry,
+                                                       exclusion_pgndx ?
+                                                       &exclusion_pgndx : 0,
+                                                       &spndx);
+          if (ret < 0)
+            {
+              return ret;
+            }
+          else if (ret == OK)
+            {
+              fs->ndx_hits++;
+              goto found;
+            }
+        }
+
+      fs->ndx_misses++;
+    }
+
   ret = spiffs_foreach_objlu(fs, fs->lu_blkndx, fs->lu_entry,
                              SPIFFS_VIS_CHECK_ID, objid,
                              spiffs_objlu_find_id_and_span_callback,
@@ -984,7 +1016,14 @@ int spiffs_objlu_find_id_and_span(FAR struct spiffs_s *fs, int16_t objid,
       ferr("ERROR: spiffs_foreach_objlu() failed: %d\n", ret);
       return ret;
     }
+  else if ((objid & SPIFFS_OBJID_NDXFLAG) != 0)
+    {
+      spiffs_ndxcache_put(fs, objid, spndx,
+                          SPIFFS_OBJ_LOOKUP_ENTRY_TO_PGNDX(fs, blkndx,
+                                                           entry));
+    }
 
+found:
   if (pgndx != NULL)
     {
       *pgndx = SPIFFS_OBJ_LOOKUP_ENTRY_TO_PGNDX(fs, blkndx, entry);
@@ -60,6 +60,7 @@
 #include <nuttx/fs/fs.h>
 #include <nuttx/fs/dirent.h>
 #include <nuttx/fs/ioctl.h>
+#include <nuttx/fs/spiffs.h>
 
 #include "spiffs.h"
 #include "spiffs_core.h"
@@ -1007,6 +1008,10 @@ static int spiffs_ioctl(FAR struct file *filep, int cmd, unsigned long arg)
                   blkndx++;
                 }
             }
+
+          /* Any index page locations that we remember are now stale */
+
+          spiffs_ndxcache_clear(fs);
         }
         break;
 
@@ -1034,6 +1039,42 @@ static int spiffs_ioctl(FAR struct file *filep, int cmd, unsigned long arg)
         break;
 #endif
 
+      /* Return cache statistics.
+       * IN:  A pointer to writable struct spiffs_cachestats_s
+       * OUT: The cache statistics
+       */
+
+      case FIOC_CACHESTATS:
+        {
+          FAR struct spiffs_cachestats_s *stats =
+            (FAR struct spiffs_cachestats_s *)((uintptr_t)arg);
+
+          if (stats == NULL)
+            {
+              ret = -EINVAL;
+              break;
+            }
+
+          memset(stats, 0, sizeof(struct spiffs_cachestats_s));
+          stats->hits      = fs->cache_hits;
+          stats->misses    = fs->cache_misses;
+          stats->evictions = fs->cache_evictions;
+          stats->ndxhits   = fs->ndx_hits;
+          stats->ndxmisses = fs->ndx_misses;
+
+          if (fs->cache != NULL)
+            {
+              FAR struct spiffs_cache_s *cache = spiffs_get_cache(fs);
+
+              stats->npages   = cache->cpage_count;
+              stats->nwrpages = cache->cpage_wrcount;
+              stats->nused    = cache->cpage_nused;
+            }
+
+          ret = OK;
+        }
+        break;
+
       default:
 
         /* Pass through to the contained MTD driver */
@@ -1389,9 +1430,13 @@ static int spiffs_bind(FAR struct inode *mtdinode, FAR const void *data,
   addrmask   = (sizeof(FAR void *) - 1);
   cache_size = (CONFIG_SPIFFS_CACHE_SIZE + addrmask) & ~addrmask;
 
-  /* Don't let the cache size exceed the maximum that is needed */
+  /* Don't let the cache size exceed the maximum that is needed:  One
+   * cache page for each page of the volume.
+   */
 
-  cache_max  = SPIFFS_GEO_PAGE_SIZE(fs) << 5;
+  cache_max  = sizeof(struct spiffs_cache_s) +
+               (size_t)MIN(fs->total_pages, UINT16_MAX) *
+               SPIFFS_CACHE_PAGE_SIZE(fs);
   if (cache_size > cache_max)
     {
       cache_size = cache_max;
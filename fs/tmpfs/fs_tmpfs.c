@@ -95,6 +95,11 @@ static int  tmpfs_realloc_directory(FAR struct tmpfs_directory_s **tdo,
               unsigned int nentries);
 static int  tmpfs_realloc_file(FAR struct tmpfs_file_s **tfo,
               size_t newsize);
+static void tmpfs_read_file(FAR struct tmpfs_file_s *tfo, off_t offset,
+                            FAR char *buffer, size_t nbytes);
+static ssize_t tmpfs_write_file(FAR struct tmpfs_file_s *tfo, off_t offset,
+                                FAR const char *buffer, size_t nbytes);
+static void tmpfs_free_file(FAR struct tmpfs_file_s *tfo);
 static void tmpfs_release_lockedobject(FAR struct tmpfs_object_s *to);
 static void tmpfs_release_lockedfile(FAR struct tmpfs_file_s *tfo);
 static int  tmpfs_find_dirent(FAR struct tmpfs_directory_s *tdo,
@@ -363,6 +368,85 @@ static int tmpfs_realloc_directory(FAR struct tmpfs_directory_s **tdo,
  * Name: tmpfs_realloc_file
  ****************************************************************************/
 
+#ifdef TMPFS_CHUNKED
+static int tmpfs_realloc_file(FAR struct tmpfs_file_s **tfo,
+                              size_t newsize)
+{
+  FAR struct tmpfs_file_s *tfop = *tfo;
+  FAR uint8_t **chunks;
+  unsigned int nchunks;
+  unsigned int i;
+
+  nchunks = TMPFS_NCHUNKS(newsize);
+
+  /* If the file is shrinking, free the chunks beyond the new end of the
+   * file.  The data beyond the new end of file in the last chunk is cleared
+   * so that it reads back as zero if the file grows again.  Growing the
+   * file never allocates chunks; unwritten chunks are holes.
+   */
+
+  if (newsize < tfop->tfo_size)
+    {
+      for (i = nchunks; i < tfop->tfo_nchunks; i++)
+        {
+          if (tfop->tfo_chunks[i] != NULL)
+            {
+              kmm_free(tfop->tfo_chunks[i]);
+              tfop->tfo_alloc -= CONFIG_FS_TMPFS_CHUNKSIZE;
+            }
+        }
+
+      if (nchunks > 0 && TMPFS_CHUNKOFF(newsize) != 0 &&
+          tfop->tfo_chunks[nchunks - 1] != NULL)
+        {
+          memset(&tfop->tfo_chunks[nchunks - 1][TMPFS_CHUNKOFF(newsize)], 0,
+                 CONFIG_FS_TMPFS_CHUNKSIZE - TMPFS_CHUNKOFF(newsize));
+        }
+    }
+
+  /* Resize the chunk table */
+
+  if (nchunks != tfop->tfo_nchunks)
+    {
+      if (nchunks == 0)
+        {
+          kmm_free(tfop->tfo_chunks);
+          chunks = NULL;
+        }
+      else
+        {
+          chunks = (FAR uint8_t **)
+            kmm_realloc(tfop->tfo_chunks, nchunks * sizeof(FAR uint8_t *));
+          if (chunks == NULL)
+            {
+              /* Failing to shrink the table is harmless; the old, larger
+               * table is kept.
+               */
+
+              if (nchunks > tfop->tfo_nchunks)
+                {
+                  return -ENOMEM;
+                }
+
+              chunks = tfop->tfo_chunks;
+            }
+
+          for (i = tfop->tfo_nchunks; i < nchunks; i++)
+            {
+              chunks[i] = NULL;
+            }
+        }
+
+      tfop->tfo_alloc  -= tfop->tfo_nchunks * sizeof(FAR uint8_t *);
+      tfop->tfo_alloc  += nchunks * sizeof(FAR uint8_t *);
+      tfop->tfo_chunks  = chunks;
+      tfop->tfo_nchunks = nchunks;
+    }
+
+  tfop->tfo_size = newsize;
+  return OK;
+}
+#else
 static int tmpfs_realloc_file(FAR struct tmpfs_file_s **tfo,
                               size_t newsize)
 {
@@ -427,6 +511,142 @@ static int tmpfs_realloc_file(FAR struct tmpfs_file_s **tfo,
   *tfo              = newtfo;
   return OK;
 }
+#endif
+
+/****************************************************************************
+ * Name: tmpfs_read_file
+ *
+ * Description:
+ *   Copy file data into a user buffer.  The caller must hold the file lock
+ *   and assure that the range lies within the file.
+ *
+ ****************************************************************************/
+
+static void tmpfs_read_file(FAR struct tmpfs_file_s *tfo, off_t offset,
+                            FAR char *buffer, size_t nbytes)
+{
+#ifdef TMPFS_CHUNKED
+  FAR uint8_t *chunk;
+  size_t chunkoff;
+  size_t ncopy;
+
+  while (nbytes > 0)
+    {
+      chunk    = tfo->tfo_chunks[TMPFS_CHUNK(offset)];
+      chunkoff = TMPFS_CHUNKOFF(offset);
+      ncopy    = CONFIG_FS_TMPFS_CHUNKSIZE - chunkoff;
+
+      if (ncopy > nbytes)
+        {
+          ncopy = nbytes;
+        }
+
+      /* Holes read as zero */
+
+      if (chunk == NULL)
+        {
+          memset(buffer, 0, ncopy);
+        }
+      else
+        {
+          memcpy(buffer, &chunk[chunkoff], ncopy);
+        }
+
+      buffer += ncopy;
+      offset += ncopy;
+      nbytes -= ncopy;
+    }
+#else
+  memcpy(buffer, &tfo->tfo_data[offset], nbytes);
+#endif
+}
+
+/****************************************************************************
+ * Name: tmpfs_write_file
+ *
+ * Description:
+ *   Copy user data into the file.  The caller must hold the file lock and
+ *   must already have extended the file to include the range.  Returns the
+ *   number of bytes written, which is less than requested only if a chunk
+ *   could not be allocated.
+ *
+ ****************************************************************************/
+
+static ssize_t tmpfs_write_file(FAR struct tmpfs_file_s *tfo, off_t offset,
+                                FAR const char *buffer, size_t nbytes)
+{
+#ifdef TMPFS_CHUNKED
+  FAR uint8_t **chunk;
+  size_t chunkoff;
+  size_t ncopy;
+  ssize_t nwritten = 0;
+
+  while (nbytes > 0)
+    {
+      chunk    = &tfo->tfo_chunks[TMPFS_CHUNK(offset)];
+      chunkoff = TMPFS_CHUNKOFF(offset);
+      ncopy    = CONFIG_FS_TMPFS_CHUNKSIZE - chunkoff;
+
+      if (ncopy > nbytes)
+        {
+          ncopy = nbytes;
+        }
+
+      /* Fill the hole.  The new chunk is zeroed so that any part of it
+       * that is not written reads back as zero.
+       */
+
+      if (*chunk == NULL)
+        {
+          *chunk = (FAR uint8_t *)kmm_zalloc(CONFIG_FS_TMPFS_CHUNKSIZE);
+          if (*chunk == NULL)
+            {
+              break;
+            }
+
+          tfo->tfo_alloc += CONFIG_FS_TMPFS_CHUNKSIZE;
+        }
+
+      memcpy(&(*chunk)[chunkoff], buffer, ncopy);
+
+      buffer   += ncopy;
+      offset   += ncopy;
+      nbytes   -= ncopy;
+      nwritten += ncopy;
+    }
+
+  return nwritten;
+#else
+  memcpy(&tfo->tfo_data[offset], buffer, nbytes);
+  return nbytes;
+#endif
+}
+
+/****************************************************************************
+ * Name: tmpfs_free_file
+ ****************************************************************************/
+
+static void tmpfs_free_file(FAR struct tmpfs_file_s *tfo)
+{
+#ifdef TMPFS_CHUNKED
+  unsigned int i;
+
+  for (i = 0; i < tfo->tfo_nchunks; i++)
+    {
+      if (tfo->tfo_chunks[i] != NULL)
+        {
+          kmm_free(tfo->tfo_chunks[i]);
+        }
+    }
+
+  if (tfo->tfo_chunks != NULL)
+    {
+      kmm_free(tfo->tfo_chunks);
+    }
+#endif
+
+  kmm_free(tfo);
+}
 
 /****************************************************************************
  * Name: tmpfs_release_lockedobject
@@ -464,7 +684,7 @@ static void tmpfs_release_lockedfile(FAR struct tmpfs_file_s *tfo)
   if (tfo->tfo_refs == 1 && (tfo->tfo_flags & TFO_FLAG_UNLINKED) != 0)
     {
       nxsem_destroy(&tfo->tfo_exclsem.ts_sem);
-      kmm_free(tfo);
+      tmpfs_free_file(tfo);
     }
 
   /* Otherwise, just decrement the reference count on the file object */
@@ -630,6 +850,10 @@ static FAR struct tmpfs_file_s *tmpfs_alloc_file(void)
   tfo->tfo_refs  = 1;
   tfo->tfo_flags = 0;
   tfo->tfo_size  = 0;
+#ifdef TMPFS_CHUNKED
+  tfo->tfo_nchunks = 0;
+  tfo->tfo_chunks  = NULL;
+#endif
 
   tfo->tfo_exclsem.ts_holder = getpid();
   tfo->tfo_exclsem.ts_count  = 1;
@@ -746,7 +970,7 @@ static int tmpfs_create_file(FAR struct tmpfs_s *fs,
 
 errout_with_file:
   nxsem_destroy(&newtfo->tfo_exclsem.ts_sem);
-  kmm_free(newtfo);
+  tmpfs_free_file(newtfo);
 
 errout_with_parent:
   parent->tdo_refs--;
@@ -1268,7 +1492,15 @@ static int tmpfs_free_callout(FAR struct tmpfs_directory_s *tdo,
   /* Free the object now */
 
   nxsem_destroy(&to->to_exclsem.ts_sem);
-  kmm_free(to);
+  if (to->to_type == TMPFS_REGULAR)
+    {
+      tmpfs_free_file((FAR struct tmpfs_file_s *)to);
+    }
+  else
+    {
+      kmm_free(to);
+    }
+
   return TMPFS_DELETED;
 }
 
@@ -1535,7 +1767,7 @@ static int tmpfs_close(FAR struct file *filep)
        * have any other references.
        */
 
-      kmm_free(tfo);
+      tmpfs_free_file(tfo);
       return OK;
     }
 
@@ -1575,7 +1807,11 @@ static ssize_t tmpfs_read(FAR struct file *filep, FAR char *buffer,
   nread    = buflen;
   endpos   = startpos + buflen;
 
-  if (endpos > tfo->tfo_size)
+  if (startpos >= tfo->tfo_size)
+    {
+      nread  = 0;
+    }
+  else if (endpos > tfo->tfo_size)
     {
       endpos = tfo->tfo_size;
       nread  = endpos - startpos;
@@ -1583,7 +1819,7 @@ static ssize_t tmpfs_read(FAR struct file *filep, FAR char *buffer,
 
   /* Copy data from the memory object to the user buffer */
 
-  memcpy(buffer, &tfo->tfo_data[startpos], nread);
+  tmpfs_read_file(tfo, startpos, buffer, nread);
   filep->f_pos += nread;
 
   /* Release the lock on the file */
@@ -1601,6 +1837,7 @@ static ssize_t tmpfs_write(FAR struct file *filep, FAR const char *buffer,
 {
   FAR struct tmpfs_file_s *tfo;
   ssize_t nwritten;
+  size_t oldsize;
   off_t startpos;
   off_t endpos;
   int ret;
@@ -1622,6 +1859,7 @@ static ssize_t tmpfs_write(FAR struct file *filep, FAR const char *buffer,
   startpos = filep->f_pos;
   nwritten = buflen;
   endpos   = startpos + buflen;
+  oldsize  = tfo->tfo_size;
 
   if (endpos > tfo->tfo_size)
     {
@@ -1636,9 +1874,30 @@ static ssize_t tmpfs_write(FAR struct file *filep, FAR const char *buffer,
       filep->f_priv = tfo;
     }
 
-  /* Copy data from the memory object to the user buffer */
+  /* Copy data from the user buffer to the memory object */
+
+  nwritten = tmpfs_write_file(tfo, startpos, buffer, buflen);
+  if ((size_t)nwritten < buflen)
+    {
+      /* Out of memory part way through.  Trim the file back to the data
+       * that was actually written.
+       */
+
+      endpos = startpos + nwritten;
+      if (endpos < tfo->tfo_size)
+        {
+          tmpfs_realloc_file(&tfo, oldsize > (size_t)endpos ?
+                                   oldsize : (size_t)endpos);
+          filep->f_priv = tfo;
+        }
+
+      if (nwritten == 0)
+        {
+          ret = -ENOMEM;
+          goto errout_with_lock;
+        }
+    }
 
-  memcpy(&tfo->tfo_data[startpos], buffer, nwritten);
   filep->f_pos += nwritten;
 
   /* Release the lock on the file */
@@ -1729,16 +1988,95 @@ static int tmpfs_ioctl(FAR struct file *filep, int cmd, unsigned long arg)
 
   DEBUGASSERT(tfo != NULL);
 
-  /* Only one ioctl command is supported */
+  if (cmd == FIOC_EXTENT && arg != 0)
+    {
+#ifdef TMPFS_CHUNKED
+      FAR struct file_extent_s *extent = (FAR struct file_extent_s *)arg;
+      off_t offset = extent->fe_offset;
+      FAR uint8_t *chunk = NULL;
+      off_t maxlength;
+      off_t length;
+
+      /* Each chunk is contiguous in memory.  Holes have no memory yet. */
+
+      tmpfs_lock_file(tfo);
+      if (offset >= 0 && offset < tfo->tfo_size)
+        {
+          chunk = tfo->tfo_chunks[TMPFS_CHUNK(offset)];
+        }
+
+      if (chunk == NULL)
+        {
+          tmpfs_unlock_file(tfo);
+          return -ENXIO;
+        }
+
+      maxlength = tfo->tfo_size - offset;
+      if (extent->fe_length > 0 && extent->fe_length < maxlength)
+        {
+          maxlength = extent->fe_length;
+        }
+
+      length = CONFIG_FS_TMPFS_CHUNKSIZE - TMPFS_CHUNKOFF(offset);
+
+      extent->fe_blkdrv   = NULL;
+      extent->fe_sector   = 0;
+      extent->fe_sectsize = 0;
+      extent->fe_mem      = chunk + TMPFS_CHUNKOFF(offset);
+      extent->fe_length   = length < maxlength ? length : maxlength;
+
+      tmpfs_unlock_file(tfo);
+      return OK;
+#else
+      /* Unchunked file data moves when the file grows */
+
+      return -ENOTTY;
+#endif
+    }
 
   if (cmd == FIOC_MMAP && ppv != NULL)
     {
+#ifdef TMPFS_CHUNKED
+      int ret = OK;
+
+      /* Only a file held in a single chunk is contiguous in memory.
+       * Larger files must be copied by rammap().
+       */
+
+      tmpfs_lock_file(tfo);
+      if (tfo->tfo_nchunks != 1)
+        {
+          ret = -ENOTTY;
+        }
+      else if (tfo->tfo_chunks[0] == NULL)
+        {
+          tfo->tfo_chunks[0] =
+            (FAR uint8_t *)kmm_zalloc(CONFIG_FS_TMPFS_CHUNKSIZE);
+          if (tfo->tfo_chunks[0] == NULL)
+            {
+              ret = -ENOMEM;
+            }
+          else
+            {
+              tfo->tfo_alloc += CONFIG_FS_TMPFS_CHUNKSIZE;
+            }
+        }
+
+      if (ret >= 0)
+        {
+          *ppv = (FAR void *)tfo->tfo_chunks[0];
+        }
+
+      tmpfs_unlock_file(tfo);
+      return ret;
+#else
       /* Return the address on the media corresponding to the start of
        * the file.
        */
 
       *ppv = (FAR void *)tfo->tfo_data;
       return OK;
+#endif
     }
 
   ferr("ERROR: Invalid cmd: %d\n", cmd);
@@ -1850,14 +2188,17 @@ static int tmpfs_truncate(FAR struct file *filep, off_t length)
 
       filep->f_priv = tfo;
 
+#ifndef TMPFS_CHUNKED
       /* If the size has increased, then we need to zero the newly added
-       * memory.
+       * memory.  Chunked files are extended with holes that already read
+       * as zero.
        */
 
       if (length > oldsize)
         {
           memset(&tfo->tfo_data[oldsize], 0, length - oldsize);
         }
+#endif
 
       ret = OK;
     }
@@ -2268,7 +2609,7 @@ static int tmpfs_unlink(FAR struct inode *mountpt, FAR const char *relpath)
   else
     {
       nxsem_destroy(&tfo->tfo_exclsem.ts_sem);
-      kmm_free(tfo);
+      tmpfs_free_file(tfo);
     }
 
   /* Release the reference and lock on the parent directory */
@@ -58,6 +58,18 @@
 
 #define TFO_FLAG_UNLINKED (1 << 0)  /* Bit 0: File is unlinked */
 
+/* File data chunk helpers.  If CONFIG_FS_TMPFS_CHUNKSIZE is zero, file data
+ * is held in one contiguous allocation that follows the file object.
+ */
+
+#if CONFIG_FS_TMPFS_CHUNKSIZE > 0
+#  define TMPFS_CHUNKED 1
+#  define TMPFS_CHUNK(o)     ((o) / CONFIG_FS_TMPFS_CHUNKSIZE)
+#  define TMPFS_CHUNKOFF(o)  ((o) % CONFIG_FS_TMPFS_CHUNKSIZE)
+#  define TMPFS_NCHUNKS(n) \
+     (((n) + CONFIG_FS_TMPFS_CHUNKSIZE - 1) / CONFIG_FS_TMPFS_CHUNKSIZE)
+#endif
+
 /****************************************************************************
  * Public Types
  ****************************************************************************/
@@ -154,10 +166,19 @@ struct tmpfs_file_s
 
   uint8_t  tfo_flags;    /* See TFO_FLAG_* definitions */
   size_t   tfo_size;     /* Valid file size */
+#ifdef TMPFS_CHUNKED
+  unsigned int tfo_nchunks;     /* Number of entries in tfo_chunks[] */
+  FAR uint8_t **tfo_chunks;     /* Data chunks.  NULL entries are holes */
+#else
   uint8_t  tfo_data[1];  /* File data starts here */
+#endif
 };
 
-#define SIZEOF_TMPFS_FILE(n) (sizeof(struct tmpfs_file_s) + (n) - 1)
+#ifdef TMPFS_CHUNKED
+#  define SIZEOF_TMPFS_FILE(n) (sizeof(struct tmpfs_file_s))
+#else
+#  define SIZEOF_TMPFS_FILE(n) (sizeof(struct tmpfs_file_s) + (n) - 1)
+#endif
 
 /* This structure represents one instance of a TMPFS file system */
 
@@ -0,0 +1,355 @@
+/****************************************************************************
+ * fs/vfs/fs_dcache.c
+ *
+ *   Copyright (C) 2020 Gregory Nutt. All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in
+ *    the documentation and/or other materials provided with the
+ *    distribution.
+ * 3. Neither the name NuttX nor the names of its contributors may be
+ *    used to endorse or promote products derived from this software
+ *    without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+ * FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE
+ * COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+ * INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,
+ * BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS
+ * OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED
+ * AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ * LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN
+ * ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ *
+ ****************************************************************************/
+
+/****************************************************************************
+ * Included Files
+ ****************************************************************************/
+
+#include <nuttx/config.h>
+
+#include <sys/stat.h>
+#include <stdbool.h>
+#include <stdint.h>
+#include <string.h>
+#include <errno.h>
+
+#include <nuttx/semaphore.h>
+#include <nuttx/fs/fs.h>
+
+#include "inode/inode.h"
+
+#ifdef CONFIG_FS_DCACHE
+
+/****************************************************************************
+ * Private Types
+ ****************************************************************************/
+
+/* One cached result of a mountpoint lookup.  A negative entry records that
+ * the relative path does not exist.
+ */
+
+struct dcache_entry_s
+{
+  FAR struct inode *de_mountpt;  /* The mountpoint, NULL if the entry is free */
+  uint32_t de_hash;              /* Hash of the mountpoint and relative path */
+  bool de_negative;              /* True: The path does not exist */
+  struct stat de_stat;           /* Attributes of the path (if it exists) */
+  char de_path[CONFIG_FS_DCACHE_PATHLEN];
+};
+
+/****************************************************************************
+ * Private Data
+ ****************************************************************************/
+
+static struct dcache_entry_s g_dcache[CONFIG_FS_DCACHE_NENTRIES];
+static sem_t g_dcache_sem = SEM_INITIALIZER(1);
+
+/* Incremented by every invalidation.  A lookup result obtained from the
+ * file system is only added if nothing was invalidated in the meantime.
+ */
+
+static uint32_t g_dcache_gen;
+
+/****************************************************************************
+ * Private Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: dcache_hash
+ *
+ * Description:
+ *   Return the FNV-1a hash of a mountpoint and relative path and the length
+ *   of the path.  Zero is returned for the length if the path is too long
+ *   to be cached.
+ *
+ ****************************************************************************/
+
+static uint32_t dcache_hash(FAR struct inode *mountpt,
+                            FAR const char *relpath, FAR size_t *len)
+{
+  uintptr_t key = (uintptr_t)mountpt;
+  uint32_t hash = 2166136261u;
+  size_t i;
+
+  for (i = 0; i < sizeof(uintptr_t); i++)
+    {
+      hash  = (hash ^ (uint8_t)key) * 16777619u;
+      key >>= 8;
+    }
+
+  for (i = 0; relpath[i] != '\0'; i++)
+    {
+      if (i >= CONFIG_FS_DCACHE_PATHLEN - 1)
+        {
+          *len = 0;
+          return 0;
+        }
+
+      hash = (hash ^ (uint8_t)relpath[i]) * 16777619u;
+    }
+
+  *len = i;
+  return hash;
+}
+
+/****************************************************************************
+ * Name: dcache_find
+ *
+ * Description:
+ *   Return the entry holding 'relpath' in 'mountpt' or NULL.  The caller
+ *   holds g_dcache_sem.
+ *
+ ****************************************************************************/
+
+static FAR struct dcache_entry_s *dcache_find(FAR struct inode *mountpt,
+                                              FAR const char *relpath)
+{
+  FAR struct dcache_entry_s *entry;
+  uint32_t hash;
+  size_t len;
+
+  hash = dcache_hash(mountpt, relpath, &len);
+  if (len == 0)
+    {
+      return NULL;
+    }
+
+  entry = &g_dcache[hash % CONFIG_FS_DCACHE_NENTRIES];
+  if (entry->de_mountpt != mountpt || entry->de_hash != hash ||
+      strcmp(entry->de_path, relpath) != 0)
+    {
+      return NULL;
+    }
+
+  return entry;
+}
+
+/****************************************************************************
+ * Public Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: dcache_lookup
+ *
+ * Description:
+ *   Look up 'relpath' in the mountpoint 'mountpt'.  On a hit, *result is
+ *   set to OK and 'buf' receives the cached attributes, or *result is set
+ *   to -ENOENT if the path is known not to exist.  On a miss, *gen
+ *   receives the generation to pass to dcache_add() with the result
+ *   obtained from the file system.
+ *
+ * Returned Value:
+ *   true if the path was found in the cache.
+ *
+ ****************************************************************************/
+
+bool dcache_lookup(FAR struct inode *mountpt, FAR const char *relpath,
+                   FAR struct stat *buf, FAR int *result, FAR uint32_t *gen)
+{
+  FAR struct dcache_entry_s *entry;
+  bool hit = false;
+
+  if ((mountpt->i_flags & FSNODEFLAG_DCACHE) == 0)
+    {
+      *gen = 0;
+      return false;
+    }
+
+  nxsem_wait_uninterruptible(&g_dcache_sem);
+
+  entry = dcache_find(mountpt, relpath);
+  if (entry != NULL)
+    {
+      if (entry->de_negative)
+        {
+          *result = -ENOENT;
+        }
+      else
+        {
+          if (buf != NULL)
+            {
+              memcpy(buf, &entry->de_stat, sizeof(struct stat));
+            }
+
+          *result = OK;
+        }
+
+      hit = true;
+    }
+
+  *gen = g_dcache_gen;
+  nxsem_post(&g_dcache_sem);
+  return hit;
+}
+
+/****************************************************************************
+ * Name: dcache_add
+ *
+ * Description:
+ *   Record the attributes of 'relpath' in 'mountpt', or that it does not
+ *   exist if 'buf' is NULL.  Nothing is recorded if anything was
+ *   invalidated since the dcache_lookup() that returned 'gen'.
+ *
+ ****************************************************************************/
+
+void dcache_add(FAR struct inode *mountpt, FAR const char *relpath,
+                FAR const struct stat *buf, uint32_t gen)
+{
+  FAR struct dcache_entry_s *entry;
+  uint32_t hash;
+  size_t len;
+
+  if ((mountpt->i_flags & FSNODEFLAG_DCACHE) == 0)
+    {
+      return;
+    }
+
+  hash = dcache_hash(mountpt, relpath, &len);
+  if (len == 0)
+    {
+      return;
+    }
+
+  nxsem_wait_uninterruptible(&g_dcache_sem);
+
+  if (gen == g_dcache_gen)
+    {
+      entry              = &g_dcache[hash % CONFIG_FS_DCACHE_NENTRIES];
+      entry->de_mountpt  = mountpt;
+      entry->de_hash     = hash;
+      entry->de_negative = (buf == NULL);
+
+      if (buf != NULL)
+        {
+          memcpy(&entry->de_stat, buf, sizeof(struct stat));
+        }
+
+      memcpy(entry->de_path, relpath, len + 1);
+    }
+
+  nxsem_post(&g_dcache_sem);
+}
+
+/****************************************************************************
+ * Name: dcache_invalidate
+ *
+ * Description:
+ *   Forget 'relpath' in 'mountpt' and its parent directory, whose
+ *   attributes may also have changed.
+ *
+ ****************************************************************************/
+
+void dcache_invalidate(FAR struct inode *mountpt, FAR const char *relpath)
+{
+  FAR struct dcache_entry_s *entry;
+  FAR const char *slash;
+  char parent[CONFIG_FS_DCACHE_PATHLEN];
+  size_t len;
+
+  if ((mountpt->i_flags & FSNODEFLAG_DCACHE) == 0)
+    {
+      return;
+    }
+
+  nxsem_wait_uninterruptible(&g_dcache_sem);
+
+  g_dcache_gen++;
+
+  entry = dcache_find(mountpt, relpath);
+  if (entry != NULL)
+    {
+      entry->de_mountpt = NULL;
+    }
+
+  /* The parent is the path up to the final '/', or the root of the
+   * mountpoint.
+   */
+
+  slash = strrchr(relpath, '/');
+  len   = slash != NULL ? slash - relpath : 0;
+
+  if (len < CONFIG_FS_DCACHE_PATHLEN)
+    {
+      memcpy(parent, relpath, len);
+      parent[len] = '\0';
+
+      entry = dcache_find(mountpt, parent);
+      if (entry != NULL)
+        {
+          entry->de_mountpt = NULL;
+        }
+    }
+
+  nxsem_post(&g_dcache_sem);
+}
+
+/****************************************************************************
+ * Name: dcache_flush
+ *
+ * Description:
+ *   Forget everything cached for 'mountpt'.  If 'files' is true, only the
+ *   attributes of regular files are forgotten; directories and negative
+ *   entries are unaffected by writing to a file.
+ *
+ ****************************************************************************/
+
+void dcache_flush(FAR struct inode *mountpt, bool files)
+{
+  FAR struct dcache_entry_s *entry;
+  int i;
+
+  if ((mountpt->i_flags & FSNODEFLAG_DCACHE) == 0)
+    {
+      return;
+    }
+
+  nxsem_wait_uninterruptible(&g_dcache_sem);
+
+  g_dcache_gen++;
+
+  for (i = 0; i < CONFIG_FS_DCACHE_NENTRIES; i++)
+    {
+      entry = &g_dcache[i];
+      if (entry->de_mountpt == mountpt &&
+          (!files ||
+           (!entry->de_negative && !S_ISDIR(entry->de_stat.st_mode))))
+        {
+          entry->de_mountpt = NULL;
+        }
+    }
+
+  nxsem_post(&g_dcache_sem);
+}
+
+#endif /* CONFIG_FS_DCACHE */
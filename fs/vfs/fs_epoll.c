@@ -42,194 +42,715 @@
 #include <sys/epoll.h>
 
 #include <stdint.h>
+#include <stdbool.h>
 #include <poll.h>
+#include <fcntl.h>
+#include <assert.h>
 #include <errno.h>
-#include <string.h>
 #include <debug.h>
 
+#include <nuttx/irq.h>
+#include <nuttx/clock.h>
 #include <nuttx/kmalloc.h>
+#include <nuttx/semaphore.h>
+#include <nuttx/cancelpt.h>
+#include <nuttx/fs/fs.h>
+#include <nuttx/net/net.h>
+
+#include "inode/inode.h"
 
 /****************************************************************************
- * Public Functions
+ * Pre-processor Definitions
  ****************************************************************************/
 
+/* The poll events that are reported in addition to the requested events */
+
+#define EPOLL_ALWAYS  (POLLERR | POLLHUP)
+
+/* The epoll flags that are not poll events */
+
+#define EPOLL_FLAGS   (EPOLLET | EPOLLONESHOT)
+
 /****************************************************************************
- * Name: epoll_create
+ * Private Types
+ ****************************************************************************/
+
+/* This describes one file descriptor registered with an epoll instance.
+ * The poll of the descriptor is set up once when it is added and stays set
+ * up until it is removed, so the driver updates pfd.revents and posts the
+ * semaphore of the epoll instance whenever an event occurs.
+ */
+
+struct epoll_item_s
+{
+  FAR struct epoll_item_s *flink; /* Supports a singly linked list */
+  struct pollfd pfd;              /* Persistent poll set-up */
+  epoll_data_t data;              /* User data returned by epoll_wait() */
+  uint32_t events;                /* Requested events and EPOLL_FLAGS */
+  bool armed;                     /* True: The poll is set up */
+};
+
+/* This is the state of one epoll instance.  It is the private data of the
+ * unnamed inode behind the epoll file descriptor.
+ */
+
+struct epoll_head_s
+{
+  sem_t lock;                     /* Serializes access to the item list */
+  sem_t sem;                      /* Posted by drivers on events */
+  int crefs;                      /* Number of open file descriptors */
+  int nitems;                     /* Number of registered descriptors */
+  FAR struct epoll_item_s *head;  /* List of registered descriptors */
+};
+
+/****************************************************************************
+ * Private Function Prototypes
+ ****************************************************************************/
+
+static int epoll_open(FAR struct file *filep);
+static int epoll_close_file(FAR struct file *filep);
+
+/****************************************************************************
+ * Private Data
+ ****************************************************************************/
+
+static const struct file_operations g_epoll_ops =
+{
+  epoll_open,       /* open */
+  epoll_close_file, /* close */
+  NULL,             /* read */
+  NULL,             /* write */
+  NULL,             /* seek */
+  NULL,             /* ioctl */
+  NULL              /* poll */
+#ifndef CONFIG_DISABLE_PSEUDOFS_OPERATIONS
+  , NULL            /* unlink */
+#endif
+};
+
+/****************************************************************************
+ * Private Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: epoll_head
  *
  * Description:
+ *   Return the epoll instance associated with an epoll file descriptor.
  *
- * Input Parameters:
+ ****************************************************************************/
+
+static FAR struct epoll_head_s *epoll_head(int epfd)
+{
+  FAR struct file *filep;
+
+  if (fs_getfilep(epfd, &filep) < 0 || filep->f_inode == NULL ||
+      filep->f_inode->u.i_ops != &g_epoll_ops)
+    {
+      return NULL;
+    }
+
+  return (FAR struct epoll_head_s *)filep->f_inode->i_private;
+}
+
+/****************************************************************************
+ * Name: epoll_pollsetup
+ *
+ * Description:
+ *   Set up or tear down the persistent poll of one registered descriptor.
+ *
+ ****************************************************************************/
+
+static int epoll_pollsetup(FAR struct epoll_head_s *eph,
+                           FAR struct epoll_item_s *epi, bool setup)
+{
+  int ret = OK;
+
+  if (setup == epi->armed)
+    {
+      return OK;
+    }
+
+  if (setup)
+    {
+      epi->pfd.events  = (epi->pfd.events & POLLMASK) |
+                         ((epi->events | EPOLL_ALWAYS) & ~POLLMASK);
+      epi->pfd.revents = 0;
+      epi->pfd.sem     = &eph->sem;
+      epi->pfd.priv    = NULL;
+    }
+
+  switch (epi->pfd.events & POLLMASK)
+    {
+      case POLLFILE:
+        {
+          FAR struct file *filep = (FAR struct file *)epi->pfd.ptr;
+
+          /* The descriptor may have been closed without being removed */
+
+          if (filep->f_inode != NULL || setup)
+            {
+              ret = file_poll(filep, &epi->pfd, setup);
+            }
+        }
+        break;
+
+#ifdef CONFIG_NET
+      case POLLSOCK:
+        ret = psock_poll((FAR struct socket *)epi->pfd.ptr, &epi->pfd,
+                         setup);
+        break;
+#endif
+
+      default:
+        ret = -EINVAL;
+        break;
+    }
+
+  if (ret >= 0 || !setup)
+    {
+      epi->armed = setup;
+    }
+
+  return ret;
+}
+
+/****************************************************************************
+ * Name: epoll_find
+ *
+ * Description:
+ *   Find a registered descriptor.
+ *
+ ****************************************************************************/
+
+static FAR struct epoll_item_s *epoll_find(FAR struct epoll_head_s *eph,
+                                           int fd,
+                                           FAR struct epoll_item_s **prev)
+{
+  FAR struct epoll_item_s *epi;
+
+  *prev = NULL;
+  for (epi = eph->head; epi != NULL; epi = epi->flink)
+    {
+      if (epi->pfd.fd == fd)
+        {
+          return epi;
+        }
+
+      *prev = epi;
+    }
+
+  return NULL;
+}
+
+/****************************************************************************
+ * Name: epoll_collect
+ *
+ * Description:
+ *   Move the events posted by drivers into the caller's buffer.  Level-
+ *   triggered descriptors are set up again so that the driver re-evaluates
+ *   their state; one-shot descriptors are disabled until EPOLL_CTL_MOD.
  *
  * Returned Value:
+ *   The number of events returned.
  *
  ****************************************************************************/
 
-int epoll_create(int size)
+static int epoll_collect(FAR struct epoll_head_s *eph,
+                         FAR struct epoll_event *evs, int maxevents)
 {
-  FAR struct epoll_head *eph =
-    (FAR struct epoll_head *)kmm_malloc(sizeof(struct epoll_head));
+  FAR struct epoll_item_s *epi;
+  irqstate_t flags;
+  pollevent_t revents;
+  int nevents = 0;
 
-  eph->size = size;
-  eph->occupied = 0;
-  eph->evs = kmm_malloc(sizeof(struct epoll_event) * eph->size);
+  for (epi = eph->head; epi != NULL && nevents < maxevents;
+       epi = epi->flink)
+    {
+      if (!epi->armed || epi->pfd.revents == 0)
+        {
+          continue;
+        }
 
-  /* REVISIT: This will not work on machines where:
-   * sizeof(struct epoll_head *) > sizeof(int)
-   */
+      /* Take the events atomically with respect to the driver */
+
+      flags = enter_critical_section();
+      revents = epi->pfd.revents;
+      epi->pfd.revents = 0;
+      leave_critical_section(flags);
 
-  return (int)((intptr_t)eph);
+      revents &= ~POLLMASK;
+      if (revents == 0)
+        {
+          continue;
+        }
+
+      evs[nevents].events = revents;
+      evs[nevents].data   = epi->data;
+      nevents++;
+
+      if ((epi->events & EPOLLONESHOT) != 0)
+        {
+          epoll_pollsetup(eph, epi, false);
+        }
+      else if ((epi->events & EPOLLET) == 0)
+        {
+          /* Re-arm so that a descriptor that is still ready is reported
+           * again by the next epoll_wait().
+           */
+
+          epoll_pollsetup(eph, epi, false);
+          epoll_pollsetup(eph, epi, true);
+        }
+    }
+
+  return nevents;
 }
 
 /****************************************************************************
- * Name: epoll_close
+ * Name: epoll_free
+ *
+ * Description:
+ *   Tear down and free all registered descriptors and the epoll instance.
+ *
+ ****************************************************************************/
+
+static void epoll_free(FAR struct epoll_head_s *eph)
+{
+  FAR struct epoll_item_s *epi;
+
+  while ((epi = eph->head) != NULL)
+    {
+      eph->head = epi->flink;
+      epoll_pollsetup(eph, epi, false);
+      kmm_free(epi);
+    }
+
+  nxsem_destroy(&eph->sem);
+  nxsem_destroy(&eph->lock);
+  kmm_free(eph);
+}
+
+/****************************************************************************
+ * Name: epoll_open
+ *
+ * Description:
+ *   Called when the epoll file descriptor is duplicated.
+ *
+ ****************************************************************************/
+
+static int epoll_open(FAR struct file *filep)
+{
+  FAR struct epoll_head_s *eph =
+    (FAR struct epoll_head_s *)filep->f_inode->i_private;
+
+  nxsem_wait_uninterruptible(&eph->lock);
+  eph->crefs++;
+  nxsem_post(&eph->lock);
+  return OK;
+}
+
+/****************************************************************************
+ * Name: epoll_close_file
+ *
+ * Description:
+ *   Called when an epoll file descriptor is closed.  The epoll instance is
+ *   freed when the last descriptor referring to it is closed.  The unnamed
+ *   inode is freed by inode_release().
+ *
+ ****************************************************************************/
+
+static int epoll_close_file(FAR struct file *filep)
+{
+  FAR struct epoll_head_s *eph =
+    (FAR struct epoll_head_s *)filep->f_inode->i_private;
+
+  nxsem_wait_uninterruptible(&eph->lock);
+  if (--eph->crefs > 0)
+    {
+      nxsem_post(&eph->lock);
+      return OK;
+    }
+
+  epoll_free(eph);
+  return OK;
+}
+
+/****************************************************************************
+ * Public Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: epoll_create
  *
  * Description:
+ *   Create an epoll instance and return a file descriptor referring to it.
+ *   The descriptor is closed with close() (or epoll_close()).
  *
  * Input Parameters:
+ *   size - Ignored, but must be greater than zero.  The number of
+ *          registered descriptors grows as needed.
  *
  * Returned Value:
+ *   A file descriptor on success.  -1 (ERROR) on failure with errno set:
+ *
+ *   EINVAL - size is not positive
+ *   ENOMEM - Out of memory
+ *   EMFILE - Too many open file descriptors
  *
  ****************************************************************************/
 
-void epoll_close(int epfd)
+int epoll_create(int size)
 {
-  /* REVISIT: This will not work on machines where:
-   * sizeof(struct epoll_head *) > sizeof(int)
+  FAR struct epoll_head_s *eph;
+  FAR struct inode *inode;
+  int errcode;
+  int fd;
+
+  if (size <= 0)
+    {
+      errcode = EINVAL;
+      goto errout;
+    }
+
+  eph = (FAR struct epoll_head_s *)kmm_zalloc(sizeof(struct epoll_head_s));
+  if (eph == NULL)
+    {
+      errcode = ENOMEM;
+      goto errout;
+    }
+
+  nxsem_init(&eph->lock, 0, 1);
+  nxsem_init(&eph->sem, 0, 0);
+  nxsem_setprotocol(&eph->sem, SEM_PRIO_NONE);
+  eph->crefs = 1;
+
+  /* The epoll instance is an unnamed inode that is not in the inode tree.
+   * It is marked as deleted so that inode_release() frees it when the last
+   * file descriptor referring to it is closed.
    */
 
-  FAR struct epoll_head *eph = (FAR struct epoll_head *)((intptr_t)epfd);
+  inode = (FAR struct inode *)kmm_zalloc(FSNODE_SIZE(0));
+  if (inode == NULL)
+    {
+      errcode = ENOMEM;
+      goto errout_with_eph;
+    }
 
-  kmm_free(eph->evs);
+  INODE_SET_DRIVER(inode);
+  inode->i_flags  |= FSNODEFLAG_DELETED;
+  inode->i_crefs   = 1;
+  inode->u.i_ops   = &g_epoll_ops;
+  inode->i_private = eph;
+
+  fd = files_allocate(inode, O_RDOK, 0, 0);
+  if (fd < 0)
+    {
+      errcode = EMFILE;
+      kmm_free(inode);
+      goto errout_with_eph;
+    }
+
+  return fd;
+
+errout_with_eph:
+  nxsem_destroy(&eph->sem);
+  nxsem_destroy(&eph->lock);
   kmm_free(eph);
+
+errout:
+  set_errno(errcode);
+  return ERROR;
+}
+
+/****************************************************************************
+ * Name: epoll_close
+ *
+ * Description:
+ *   Close an epoll file descriptor.  Equivalent to close(epfd).
+ *
+ ****************************************************************************/
+
+void epoll_close(int epfd)
+{
+  close(epfd);
 }
 
 /****************************************************************************
  * Name: epoll_ctl
  *
  * Description:
+ *   Add, modify or remove a descriptor in the interest list of an epoll
+ *   instance.  A descriptor must be removed before it is closed.
  *
  * Input Parameters:
+ *   epfd - The epoll file descriptor
+ *   op   - EPOLL_CTL_ADD, EPOLL_CTL_MOD or EPOLL_CTL_DEL
+ *   fd   - The file or socket descriptor
+ *   ev   - The requested events, EPOLLET and/or EPOLLONESHOT, and the user
+ *          data to be returned by epoll_wait().  Not used by EPOLL_CTL_DEL.
  *
  * Returned Value:
+ *   Zero (OK) on success.  -1 (ERROR) on failure with errno set:
+ *
+ *   EBADF  - epfd or fd is not a valid descriptor
+ *   EINVAL - epfd is not an epoll descriptor, fd is epfd, or op is invalid
+ *   EEXIST - fd is already registered (EPOLL_CTL_ADD)
+ *   ENOENT - fd is not registered (EPOLL_CTL_MOD, EPOLL_CTL_DEL)
+ *   ENOMEM - Out of memory
  *
  ****************************************************************************/
 
-int epoll_ctl(int epfd, int op, int fd, struct epoll_event *ev)
+int epoll_ctl(int epfd, int op, int fd, FAR struct epoll_event *ev)
 {
-  /* REVISIT: This will not work on machines where:
-   * sizeof(struct epoll_head *) > sizeof(int)
-   */
+  FAR struct epoll_head_s *eph;
+  FAR struct epoll_item_s *epi;
+  FAR struct epoll_item_s *prev;
+  int ret;
+
+  eph = epoll_head(epfd);
+  if (eph == NULL)
+    {
+      set_errno(EBADF);
+      return ERROR;
+    }
+
+  if (fd == epfd || (op != EPOLL_CTL_DEL && ev == NULL))
+    {
+      set_errno(EINVAL);
+      return ERROR;
+    }
 
-  FAR struct epoll_head *eph = (FAR struct epoll_head *)((intptr_t)epfd);
+  ret = nxsem_wait(&eph->lock);
+  if (ret < 0)
+    {
+      set_errno(-ret);
+      return ERROR;
+    }
+
+  epi = epoll_find(eph, fd, &prev);
 
   switch (op)
     {
       case EPOLL_CTL_ADD:
-        finfo("%08x CTL ADD(%d): fd=%d ev=%08x\n",
-              epfd, eph->occupied, fd, ev->events);
+        {
+          FAR struct file *filep;
 
-        eph->evs[eph->occupied].events = ev->events | POLLERR | POLLHUP;
-        eph->evs[eph->occupied++].data.fd = fd;
-        return 0;
+          finfo("%d CTL ADD(%d): fd=%d ev=%08x\n",
+                epfd, eph->nitems, fd, ev->events);
 
-      case EPOLL_CTL_DEL:
-        {
-          int i;
+          if (epi != NULL)
+            {
+              ret = -EEXIST;
+              break;
+            }
 
-          for (i = 0; i < eph->occupied; i++)
+          epi = (FAR struct epoll_item_s *)
+            kmm_zalloc(sizeof(struct epoll_item_s));
+          if (epi == NULL)
             {
-              if (eph->evs[i].data.fd == fd)
-                {
-                  if (i != eph->occupied - 1)
-                    {
-                      memmove(&eph->evs[i], &eph->evs[i + 1],
-                              eph->occupied - i);
-                    }
-
-                  eph->occupied--;
-                  return 0;
-                }
+              ret = -ENOMEM;
+              break;
             }
 
-          return -ENOENT;
-        }
+          /* Hold the file or socket structure so that the descriptor need
+           * not be looked up again on each event.
+           */
 
-      case EPOLL_CTL_MOD:
-        {
-          int i;
+          epi->pfd.fd = fd;
+          if ((unsigned int)fd < CONFIG_NFILE_DESCRIPTORS)
+            {
+              ret = fs_getfilep(fd, &filep);
+              epi->pfd.ptr    = filep;
+              epi->pfd.events = POLLFILE;
+            }
+#ifdef CONFIG_NET
+          else if ((epi->pfd.ptr = sockfd_socket(fd)) != NULL)
+            {
+              epi->pfd.events = POLLSOCK;
+            }
+#endif
+          else
+            {
+              ret = -EBADF;
+            }
 
-          finfo("%08x CTL MOD(%d): fd=%d ev=%08x\n",
-                epfd, eph->occupied, fd, ev->events);
+          if (ret >= 0)
+            {
+              epi->events = ev->events;
+              epi->data   = ev->data;
+              ret = epoll_pollsetup(eph, epi, true);
+            }
 
-          for (i = 0; i < eph->occupied; i++)
+          if (ret < 0)
             {
-              if (eph->evs[i].data.fd == fd)
-                {
-                  eph->evs[i].events = ev->events | POLLERR | POLLHUP;
-                  return 0;
-                }
+              kmm_free(epi);
+              break;
             }
 
-          return -ENOENT;
+          epi->flink = eph->head;
+          eph->head  = epi;
+          eph->nitems++;
         }
+        break;
+
+      case EPOLL_CTL_MOD:
+        finfo("%d CTL MOD(%d): fd=%d ev=%08x\n",
+              epfd, eph->nitems, fd, ev->events);
+
+        if (epi == NULL)
+          {
+            ret = -ENOENT;
+            break;
+          }
+
+        /* Set up the poll again with the new events.  This also re-enables
+         * a one-shot descriptor.
+         */
+
+        epoll_pollsetup(eph, epi, false);
+        epi->events = ev->events;
+        epi->data   = ev->data;
+        ret = epoll_pollsetup(eph, epi, true);
+        break;
+
+      case EPOLL_CTL_DEL:
+        finfo("%d CTL DEL(%d): fd=%d\n", epfd, eph->nitems, fd);
+
+        if (epi == NULL)
+          {
+            ret = -ENOENT;
+            break;
+          }
+
+        if (prev != NULL)
+          {
+            prev->flink = epi->flink;
+          }
+        else
+          {
+            eph->head = epi->flink;
+          }
+
+        eph->nitems--;
+        epoll_pollsetup(eph, epi, false);
+        kmm_free(epi);
+        ret = OK;
+        break;
+
+      default:
+        ret = -EINVAL;
+        break;
     }
 
-  return -EINVAL;
+  nxsem_post(&eph->lock);
+
+  if (ret < 0)
+    {
+      set_errno(-ret);
+      return ERROR;
+    }
+
+  return OK;
 }
 
 /****************************************************************************
  * Name: epoll_wait
  *
  * Description:
+ *   Wait for events on the descriptors registered with an epoll instance.
+ *   The descriptors are not polled again on each call:  Their poll is set
+ *   up once by epoll_ctl() and the drivers post events as they occur.
  *
  * Input Parameters:
+ *   epfd      - The epoll file descriptor
+ *   evs       - The location to return the ready events
+ *   maxevents - The maximum number of events to return
+ *   timeout   - The maximum time to wait in milliseconds.  Zero returns
+ *               immediately; a negative value waits indefinitely.
  *
  * Returned Value:
+ *   The number of events returned; zero on a timeout.  -1 (ERROR) on
+ *   failure with errno set:
+ *
+ *   EBADF  - epfd is not a valid epoll descriptor
+ *   EINVAL - maxevents is not positive
+ *   EINTR  - The wait was interrupted by a signal
  *
  ****************************************************************************/
 
 int epoll_wait(int epfd, FAR struct epoll_event *evs, int maxevents,
                int timeout)
 {
-  /* REVISIT: This will not work on machines where:
-   * sizeof(struct epoll_head *) > sizeof(int)
-   */
+  FAR struct epoll_head_s *eph;
+  clock_t start;
+  int ret;
 
-  FAR struct epoll_head *eph = (FAR struct epoll_head *)((intptr_t)epfd);
-  int counter;
-  int rc;
-  int i;
+  /* epoll_wait() is a cancellation point */
 
-  rc = poll((FAR struct pollfd *)eph->evs, eph->occupied, timeout);
+  enter_cancellation_point();
 
-  if (rc <= 0)
+  eph = epoll_head(epfd);
+  if (eph == NULL)
     {
-      if (rc < 0)
+      ret = -EBADF;
+      goto errout;
+    }
+
+  if (evs == NULL || maxevents <= 0)
+    {
+      ret = -EINVAL;
+      goto errout;
+    }
+
+  start = clock_systimer();
+  for (; ; )
+    {
+      /* Discard stale wake-ups; the events themselves are in the items */
+
+      while (nxsem_trywait(&eph->sem) == OK);
+
+      ret = nxsem_wait(&eph->lock);
+      if (ret < 0)
         {
-          ferr("ERROR: %08x poll fail: %d for %d, %d msecs\n",
-               epfd, rc, eph->occupied, timeout);
+          goto errout;
+        }
 
-          for (i = 0; i < eph->occupied; i++)
-            {
-              ferr("  %02d: fd=%d\n", i, eph->evs[i].data.fd);
-            }
+      ret = epoll_collect(eph, evs, maxevents);
+      nxsem_post(&eph->lock);
+
+      if (ret > 0 || timeout == 0)
+        {
+          break;
         }
 
-      return rc;
-    }
+      /* Wait for a driver to post an event */
 
-  /* Iterate over non NULL event fds */
+      if (timeout < 0)
+        {
+          ret = nxsem_wait(&eph->sem);
+        }
+      else
+        {
+          ret = nxsem_tickwait(&eph->sem, start, MSEC2TICK(timeout));
+        }
 
-  for (i = 0, counter = 0; i < rc && counter < eph->size; counter++)
-    {
-      if (eph->evs[counter].revents != 0)
+      if (ret == -ETIMEDOUT)
         {
-          evs[i].data.fd = eph->evs[counter].data.fd;
-          evs[i].events  = eph->evs[counter].revents;
-          i += 1;
+          ret = 0;
+          break;
+        }
+      else if (ret < 0)
+        {
+          goto errout;
         }
     }
 
-  return i;
-}
+  leave_cancellation_point();
+  return ret;
 
+errout:
+  leave_cancellation_point();
+  set_errno(-ret);
+  return ERROR;
+}
@@ -0,0 +1,574 @@
+/****************************************************************************
+ * fs/vfs/fs_eventfd.c
+ *
+ *   Copyright (C) 2020 Gregory Nutt. All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in
+ *    the documentation and/or other materials provided with the
+ *    distribution.
+ * 3. Neither the name NuttX nor the names of its contributors may be
+ *    used to endorse or promote products derived from this software
+ *    without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+ * FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE
+ * COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+ * INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,
+ * BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS
+ * OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED
+ * AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ * LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN
+ * ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ *
+ ****************************************************************************/
+
+/****************************************************************************
+ * Included Files
+ ****************************************************************************/
+
+#include <nuttx/config.h>
+
+#include <sys/eventfd.h>
+
+#include <stdint.h>
+#include <stdbool.h>
+#include <string.h>
+#include <poll.h>
+#include <fcntl.h>
+#include <assert.h>
+#include <errno.h>
+#include <debug.h>
+
+#include <nuttx/irq.h>
+#include <nuttx/kmalloc.h>
+#include <nuttx/semaphore.h>
+#include <nuttx/fs/fs.h>
+#include <nuttx/fs/eventfd.h>
+
+#include "inode/inode.h"
+
+#ifdef CONFIG_EVENT_FD
+
+/****************************************************************************
+ * Pre-processor Definitions
+ ****************************************************************************/
+
+/* The largest value that the counter can hold */
+
+#define EVENTFD_MAX  (UINT64_MAX - 1)
+
+/****************************************************************************
+ * Private Types
+ ****************************************************************************/
+
+/* This is the state of one event object.  It is the private data of the
+ * unnamed inode behind the event file descriptor.  All fields are protected
+ * by a critical section so that eventfd_signal() can be called from
+ * interrupt handlers.
+ */
+
+struct eventfd_priv_s
+{
+  eventfd_t counter;              /* The event counter */
+  sem_t rdsem;                    /* Readers wait here for a non-zero count */
+  sem_t wrsem;                    /* Writers wait here for counter space */
+  int crefs;                      /* Open descriptors and eventfd_get() refs */
+  bool semaphore;                 /* True: EFD_SEMAPHORE read semantics */
+
+  /* The poll waiters */
+
+  FAR struct pollfd *fds[CONFIG_EVENT_FD_NPOLLWAITERS];
+};
+
+/****************************************************************************
+ * Private Function Prototypes
+ ****************************************************************************/
+
+static int eventfd_open(FAR struct file *filep);
+static int eventfd_close(FAR struct file *filep);
+static ssize_t eventfd_read_file(FAR struct file *filep, FAR char *buffer,
+                                 size_t buflen);
+static ssize_t eventfd_write_file(FAR struct file *filep,
+                                  FAR const char *buffer, size_t buflen);
+static int eventfd_poll(FAR struct file *filep, FAR struct pollfd *fds,
+                        bool setup);
+
+/****************************************************************************
+ * Private Data
+ ****************************************************************************/
+
+static const struct file_operations g_eventfd_ops =
+{
+  eventfd_open,       /* open */
+  eventfd_close,      /* close */
+  eventfd_read_file,  /* read */
+  eventfd_write_file, /* write */
+  NULL,               /* seek */
+  NULL,               /* ioctl */
+  eventfd_poll        /* poll */
+#ifndef CONFIG_DISABLE_PSEUDOFS_OPERATIONS
+  , NULL              /* unlink */
+#endif
+};
+
+/****************************************************************************
+ * Private Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: eventfd_pollnotify
+ *
+ * Description:
+ *   Report events to the poll waiters.  Called from within a critical
+ *   section.
+ *
+ ****************************************************************************/
+
+static void eventfd_pollnotify(FAR struct eventfd_priv_s *dev,
+                               pollevent_t eventset)
+{
+  FAR struct pollfd *fds;
+  int i;
+
+  for (i = 0; i < CONFIG_EVENT_FD_NPOLLWAITERS; i++)
+    {
+      fds = dev->fds[i];
+      if (fds != NULL)
+        {
+          fds->revents |= eventset & fds->events;
+          if (fds->revents != 0)
+            {
+              nxsem_post(fds->sem);
+            }
+        }
+    }
+}
+
+/****************************************************************************
+ * Name: eventfd_wakeall
+ *
+ * Description:
+ *   Wake up all tasks waiting on a semaphore.  Each re-checks the counter.
+ *
+ ****************************************************************************/
+
+static void eventfd_wakeall(FAR sem_t *sem)
+{
+  int sval;
+
+  while (nxsem_getvalue(sem, &sval) == 0 && sval < 0)
+    {
+      nxsem_post(sem);
+    }
+}
+
+/****************************************************************************
+ * Name: eventfd_add
+ *
+ * Description:
+ *   Add value to the counter and notify the readers.  Called from within a
+ *   critical section after checking that the counter does not overflow.
+ *
+ ****************************************************************************/
+
+static void eventfd_add(FAR struct eventfd_priv_s *dev, eventfd_t value)
+{
+  if (value > 0)
+    {
+      dev->counter += value;
+      eventfd_wakeall(&dev->rdsem);
+      eventfd_pollnotify(dev, POLLIN);
+    }
+}
+
+/****************************************************************************
+ * Name: eventfd_release
+ *
+ * Description:
+ *   Drop a reference and free the event object with the last one.
+ *
+ ****************************************************************************/
+
+static void eventfd_release(FAR struct eventfd_priv_s *dev)
+{
+  irqstate_t flags;
+  int crefs;
+
+  flags = enter_critical_section();
+  crefs = --dev->crefs;
+  leave_critical_section(flags);
+
+  if (crefs <= 0)
+    {
+      nxsem_destroy(&dev->rdsem);
+      nxsem_destroy(&dev->wrsem);
+      kmm_free(dev);
+    }
+}
+
+/****************************************************************************
+ * Name: eventfd_open
+ *
+ * Description:
+ *   Called when the event file descriptor is duplicated.
+ *
+ ****************************************************************************/
+
+static int eventfd_open(FAR struct file *filep)
+{
+  FAR struct eventfd_priv_s *dev = filep->f_inode->i_private;
+  irqstate_t flags;
+
+  flags = enter_critical_section();
+  dev->crefs++;
+  leave_critical_section(flags);
+  return OK;
+}
+
+/****************************************************************************
+ * Name: eventfd_close
+ *
+ * Description:
+ *   Called when an event file descriptor is closed.  The unnamed inode is
+ *   freed by inode_release().
+ *
+ ****************************************************************************/
+
+static int eventfd_close(FAR struct file *filep)
+{
+  eventfd_release(filep->f_inode->i_private);
+  return OK;
+}
+
+/****************************************************************************
+ * Name: eventfd_read_file
+ ****************************************************************************/
+
+static ssize_t eventfd_read_file(FAR struct file *filep, FAR char *buffer,
+                                 size_t buflen)
+{
+  FAR struct eventfd_priv_s *dev = filep->f_inode->i_private;
+  irqstate_t flags;
+  eventfd_t value;
+  int ret;
+
+  if (buflen < sizeof(eventfd_t))
+    {
+      return -EINVAL;
+    }
+
+  flags = enter_critical_section();
+  while (dev->counter == 0)
+    {
+      if ((filep->f_oflags & O_NONBLOCK) != 0)
+        {
+          leave_critical_section(flags);
+          return -EAGAIN;
+        }
+
+      ret = nxsem_wait(&dev->rdsem);
+      if (ret < 0)
+        {
+          leave_critical_section(flags);
+          return ret;
+        }
+    }
+
+  if (dev->semaphore)
+    {
+      value = 1;
+      dev->counter--;
+    }
+  else
+    {
+      value = dev->counter;
+      dev->counter = 0;
+    }
+
+  eventfd_wakeall(&dev->wrsem);
+  eventfd_pollnotify(dev, POLLOUT);
+  leave_critical_section(flags);
+
+  memcpy(buffer, &value, sizeof(eventfd_t));
+  return sizeof(eventfd_t);
+}
+
+/****************************************************************************
+ * Name: eventfd_write_file
+ ****************************************************************************/
+
+static ssize_t eventfd_write_file(FAR struct file *filep,
+                                  FAR const char *buffer, size_t buflen)
+{
+  FAR struct eventfd_priv_s *dev = filep->f_inode->i_private;
+  irqstate_t flags;
+  eventfd_t value;
+  int ret;
+
+  if (buflen < sizeof(eventfd_t))
+    {
+      return -EINVAL;
+    }
+
+  memcpy(&value, buffer, sizeof(eventfd_t));
+  if (value > EVENTFD_MAX)
+    {
+      return -EINVAL;
+    }
+
+  flags = enter_critical_section();
+  while (EVENTFD_MAX - dev->counter < value)
+    {
+      if ((filep->f_oflags & O_NONBLOCK) != 0)
+        {
+          leave_critical_section(flags);
+          return -EAGAIN;
+        }
+
+      ret = nxsem_wait(&dev->wrsem);
+      if (ret < 0)
+        {
+          leave_critical_section(flags);
+          return ret;
+        }
+    }
+
+  eventfd_add(dev, value);
+  leave_critical_section(flags);
+  return sizeof(eventfd_t);
+}
+
+/****************************************************************************
+ * Name: eventfd_poll
+ ****************************************************************************/
+
+static int eventfd_poll(FAR struct file *filep, FAR struct pollfd *fds,
+                        bool setup)
+{
+  FAR struct eventfd_priv_s *dev = filep->f_inode->i_private;
+  FAR struct pollfd **slot;
+  pollevent_t eventset;
+  irqstate_t flags;
+  int ret = OK;
+  int i;
+
+  flags = enter_critical_section();
+  if (setup)
+    {
+      for (i = 0; i < CONFIG_EVENT_FD_NPOLLWAITERS; i++)
+        {
+          if (dev->fds[i] == NULL)
+            {
+              dev->fds[i] = fds;
+              fds->priv   = &dev->fds[i];
+              break;
+            }
+        }
+
+      if (i >= CONFIG_EVENT_FD_NPOLLWAITERS)
+        {
+          fds->priv = NULL;
+          ret       = -EBUSY;
+          goto errout;
+        }
+
+      /* Report the events that are already pending */
+
+      eventset = 0;
+      if (dev->counter > 0)
+        {
+          eventset |= POLLIN;
+        }
+
+      if (dev->counter < EVENTFD_MAX)
+        {
+          eventset |= POLLOUT;
+        }
+
+      if (eventset != 0)
+        {
+          eventfd_pollnotify(dev, eventset);
+        }
+    }
+  else
+    {
+      slot = (FAR struct pollfd **)fds->priv;
+      if (slot != NULL)
+        {
+          *slot     = NULL;
+          fds->priv = NULL;
+        }
+    }
+
+errout:
+  leave_critical_section(flags);
+  return ret;
+}
+
+/****************************************************************************
+ * Public Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: eventfd
+ *
+ * Description:
+ *   Create an event file descriptor.  See include/sys/eventfd.h.
+ *
+ ****************************************************************************/
+
+int eventfd(unsigned int initval, int flags)
+{
+  FAR struct eventfd_priv_s *dev;
+  FAR struct inode *inode;
+  int errcode;
+  int fd;
+
+  if ((flags & ~(EFD_SEMAPHORE | EFD_NONBLOCK | EFD_CLOEXEC)) != 0)
+    {
+      errcode = EINVAL;
+      goto errout;
+    }
+
+  dev = (FAR struct eventfd_priv_s *)
+    kmm_zalloc(sizeof(struct eventfd_priv_s));
+  if (dev == NULL)
+    {
+      errcode = ENOMEM;
+      goto errout;
+    }
+
+  /* The semaphores are used for signaling and, hence, should not have
+   * priority inheritance enabled.
+   */
+
+  nxsem_init(&dev->rdsem, 0, 0);
+  nxsem_setprotocol(&dev->rdsem, SEM_PRIO_NONE);
+  nxsem_init(&dev->wrsem, 0, 0);
+  nxsem_setprotocol(&dev->wrsem, SEM_PRIO_NONE);
+
+  dev->counter   = initval;
+  dev->crefs     = 1;
+  dev->semaphore = (flags & EFD_SEMAPHORE) != 0;
+
+  /* Like an epoll instance, the event object is an unnamed inode that is
+   * not in the inode tree and is freed by inode_release() with the last
+   * file descriptor.
+   */
+
+  inode = (FAR struct inode *)kmm_zalloc(FSNODE_SIZE(0));
+  if (inode == NULL)
+    {
+      errcode = ENOMEM;
+      goto errout_with_dev;
+    }
+
+  INODE_SET_DRIVER(inode);
+  inode->i_flags  |= FSNODEFLAG_DELETED;
+  inode->i_crefs   = 1;
+  inode->u.i_ops   = &g_eventfd_ops;
+  inode->i_private = dev;
+
+  fd = files_allocate(inode, O_RDWR | (flags & EFD_NONBLOCK), 0, 0);
+  if (fd < 0)
+    {
+      errcode = EMFILE;
+      kmm_free(inode);
+      goto errout_with_dev;
+    }
+
+  return fd;
+
+errout_with_dev:
+  nxsem_destroy(&dev->rdsem);
+  nxsem_destroy(&dev->wrsem);
+  kmm_free(dev);
+
+errout:
+  set_errno(errcode);
+  return ERROR;
+}
+
+/****************************************************************************
+ * Name: eventfd_get
+ *
+ * Description:
+ *   Take a reference to the event object behind an event file descriptor.
+ *
+ ****************************************************************************/
+
+FAR struct eventfd_priv_s *eventfd_get(int fd)
+{
+  FAR struct eventfd_priv_s *dev;
+  FAR struct file *filep;
+  irqstate_t flags;
+
+  if (fs_getfilep(fd, &filep) < 0 || filep->f_inode == NULL ||
+      filep->f_inode->u.i_ops != &g_eventfd_ops)
+    {
+      return NULL;
+    }
+
+  dev = (FAR struct eventfd_priv_s *)filep->f_inode->i_private;
+
+  flags = enter_critical_section();
+  dev->crefs++;
+  leave_critical_section(flags);
+  return dev;
+}
+
+/****************************************************************************
+ * Name: eventfd_put
+ *
+ * Description:
+ *   Release a reference taken with eventfd_get().
+ *
+ ****************************************************************************/
+
+void eventfd_put(FAR struct eventfd_priv_s *dev)
+{
+  DEBUGASSERT(dev != NULL);
+  eventfd_release(dev);
+}
+
+/****************************************************************************
+ * Name: eventfd_signal
+ *
+ * Description:
+ *   Add value to the counter of an event object.  May be called from
+ *   interrupt handlers.
+ *
+ ****************************************************************************/
+
+int eventfd_signal(FAR struct eventfd_priv_s *dev, eventfd_t value)
+{
+  irqstate_t flags;
+  int ret = OK;
+
+  DEBUGASSERT(dev != NULL);
+
+  flags = enter_critical_section();
+  if (EVENTFD_MAX - dev->counter < value)
+    {
+      ret = -EAGAIN;
+    }
+  else
+    {
+      eventfd_add(dev, value);
+    }
+
+  leave_critical_section(flags);
+  return ret;
+}
+
+#endif /* CONFIG_EVENT_FD */
@@ -224,7 +224,15 @@ FAR struct file_struct *fs_fdopen(int fd, int oflags, FAR struct tcb_s *tcb)
 
           nxsem_init(&stream->fs_sem, 0, 1);
 
-#if CONFIG_STDIO_BUFFER_SIZE > 0
+#if defined(CONFIG_STDIO_LAZY_BUFFER)
+          /* The IO buffer is allocated by the C library on first use */
+
+          stream->fs_flags  |= __FS_FLAG_LAZY;
+
+#  ifdef CONFIG_STDIO_LINEBUFFER
+          stream->fs_flags  |= __FS_FLAG_LBF; /* Line buffering */
+#  endif
+#elif CONFIG_STDIO_BUFFER_SIZE > 0
           /* Allocate the IO buffer at the appropriate privilege level for
            * the group.
            */
@@ -269,7 +277,8 @@ FAR struct file_struct *fs_fdopen(int fd, int oflags, FAR struct tcb_s *tcb)
 
   errcode = ENFILE;
 
-#if !defined(CONFIG_STDIO_DISABLE_BUFFERING) && CONFIG_STDIO_BUFFER_SIZE > 0
+#if !defined(CONFIG_STDIO_DISABLE_BUFFERING) && \
+    !defined(CONFIG_STDIO_LAZY_BUFFER) && CONFIG_STDIO_BUFFER_SIZE > 0
 errout_with_sem:
 #endif
   nxsem_post(&slist->sl_sem);
@@ -0,0 +1,243 @@
+/****************************************************************************
+ * fs/vfs/fs_ioring.c
+ *
+ *   Copyright (C) 2020 Gregory Nutt. All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in
+ *    the documentation and/or other materials provided with the
+ *    distribution.
+ * 3. Neither the name NuttX nor the names of its contributors may be
+ *    used to endorse or promote products derived from this software
+ *    without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+ * FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE
+ * COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+ * INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,
+ * BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS
+ * OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED
+ * AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ * LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN
+ * ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ *
+ ****************************************************************************/
+
+/****************************************************************************
+ * Included Files
+ ****************************************************************************/
+
+#include <nuttx/config.h>
+
+#include <sys/types.h>
+#include <sys/ioring.h>
+#include <unistd.h>
+#include <errno.h>
+
+#include <nuttx/cancelpt.h>
+#include <nuttx/fs/fs.h>
+#include <nuttx/net/net.h>
+
+#include "inode/inode.h"
+
+#ifdef CONFIG_FS_IORING
+
+/****************************************************************************
+ * Private Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: ioring_file
+ *
+ * Description:
+ *   Return the file structure of a descriptor for the positional and sync
+ *   operations, which are not supported on sockets.
+ *
+ ****************************************************************************/
+
+static int ioring_file(int fd, FAR struct file **filep)
+{
+#ifdef CONFIG_NET
+  if ((unsigned int)fd >= CONFIG_NFILE_DESCRIPTORS &&
+      sockfd_socket(fd) != NULL)
+    {
+      return -ESPIPE;
+    }
+#endif
+
+  return fs_getfilep(fd, filep);
+}
+
+/****************************************************************************
+ * Name: ioring_perform
+ *
+ * Description:
+ *   Perform the operation of one submission entry.
+ *
+ * Returned Value:
+ *   The result of the operation or a negated errno value.
+ *
+ ****************************************************************************/
+
+static ssize_t ioring_perform(FAR const struct io_sqe_s *sqe)
+{
+  FAR struct file *filep;
+  ssize_t ret;
+
+  switch (sqe->opcode)
+    {
+      case IORING_OP_NOP:
+        return OK;
+
+      case IORING_OP_READ:
+        if (sqe->off < 0)
+          {
+            return nx_read(sqe->fd, sqe->buf, sqe->len);
+          }
+
+        ret = ioring_file(sqe->fd, &filep);
+        if (ret < 0)
+          {
+            return ret;
+          }
+
+        return file_pread(filep, sqe->buf, sqe->len, sqe->off);
+
+      case IORING_OP_WRITE:
+        if (sqe->off < 0)
+          {
+            return nx_write(sqe->fd, sqe->buf, sqe->len);
+          }
+
+        ret = ioring_file(sqe->fd, &filep);
+        if (ret < 0)
+          {
+            return ret;
+          }
+
+        return file_pwrite(filep, sqe->buf, sqe->len, sqe->off);
+
+#ifndef CONFIG_DISABLE_MOUNTPOINT
+      case IORING_OP_FSYNC:
+        ret = ioring_file(sqe->fd, &filep);
+        if (ret < 0)
+          {
+            return ret;
+          }
+
+        return file_fsync(filep);
+#endif
+
+#ifdef CONFIG_NET
+      case IORING_OP_SEND:
+        return nx_send(sqe->fd, sqe->buf, sqe->len, sqe->msgflags);
+
+      case IORING_OP_RECV:
+        return nx_recv(sqe->fd, sqe->buf, sqe->len, sqe->msgflags);
+#endif
+
+      default:
+        return -ENOSYS;
+    }
+}
+
+/****************************************************************************
+ * Public Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: io_ring_enter
+ *
+ * Description:
+ *   Perform up to 'to_submit' queued operations of the ring in one call.
+ *   Each operation is performed to completion, in order, and its result is
+ *   posted to the completion queue before the next one is started.  The
+ *   call stops early if the submission queue is empty or the completion
+ *   queue is full.
+ *
+ * Input Parameters:
+ *   ring      - The ring in caller memory
+ *   to_submit - The maximum number of submission entries to consume
+ *
+ * Returned Value:
+ *   The number of submission entries consumed.  On failure, -1 (ERROR) is
+ *   returned and the errno variable is set appropriately.
+ *
+ ****************************************************************************/
+
+int io_ring_enter(FAR struct io_ring_s *ring, unsigned int to_submit)
+{
+  FAR struct io_sqe_s *sqe;
+  FAR struct io_cqe_s *cqe;
+  uint32_t sqhead;
+  uint32_t cqtail;
+  bool cancel = false;
+  ssize_t res;
+  int nsubmitted = 0;
+
+  /* The ring must be valid.  The masks must be one less than a power of
+   * two.
+   */
+
+  if (ring == NULL || ring->sq == NULL || ring->cq == NULL ||
+      (ring->sq_mask & (ring->sq_mask + 1)) != 0 ||
+      (ring->cq_mask & (ring->cq_mask + 1)) != 0)
+    {
+      set_errno(EINVAL);
+      return ERROR;
+    }
+
+  /* io_ring_enter() is a cancellation point */
+
+  enter_cancellation_point();
+
+  /* The indices are read once and published after each entry, so the
+   * caller may continue to fill the submission queue and to reap the
+   * completion queue meanwhile.
+   */
+
+  sqhead = ring->sq_head;
+  cqtail = ring->cq_tail;
+
+  while ((unsigned int)nsubmitted < to_submit &&
+         sqhead != ring->sq_tail &&
+         cqtail - ring->cq_head <= ring->cq_mask)
+    {
+      sqe = &ring->sq[sqhead & ring->sq_mask];
+
+      /* Perform the operation unless a linked entry before it failed */
+
+      res = cancel ? -ECANCELED : ioring_perform(sqe);
+
+      /* Post the completion unless it is suppressed */
+
+      if (res < 0 || (sqe->flags & IOSQE_CQE_SKIP) == 0)
+        {
+          cqe            = &ring->cq[cqtail & ring->cq_mask];
+          cqe->user_data = sqe->user_data;
+          cqe->res       = res;
+          ring->cq_tail  = ++cqtail;
+        }
+
+      /* A failure cancels the remainder of a chain of linked entries */
+
+      cancel = res < 0 && (sqe->flags & IOSQE_IO_LINK) != 0;
+
+      ring->sq_head = ++sqhead;
+      nsubmitted++;
+    }
+
+  leave_cancellation_point();
+  return nsubmitted;
+}
+
+#endif /* CONFIG_FS_IORING */
@@ -126,6 +126,8 @@ int mkdir(const char *pathname, mode_t mode)
               errcode = -ret;
               goto errout_with_inode;
             }
+
+          dcache_invalidate(inode, desc.relpath);
         }
       else
         {
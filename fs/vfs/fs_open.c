@@ -232,7 +232,33 @@ int nx_vopen(FAR const char *path, int oflags, va_list ap)
 #ifndef CONFIG_DISABLE_MOUNTPOINT
       if (INODE_IS_MOUNTPT(inode))
         {
+          uint32_t gen = 0;
+
+          /* A path that is known not to exist cannot be opened unless it
+           * is being created.
+           */
+
+          if ((oflags & O_CREAT) == 0 &&
+              dcache_lookup(inode, desc.relpath, NULL, &ret, &gen) &&
+              ret < 0)
+            {
+              goto errout_with_fd;
+            }
+
           ret = inode->u.i_mops->open(filep, desc.relpath, oflags, mode);
+
+          /* Remember that the path does not exist, or forget the path if
+           * it may have been created or truncated.
+           */
+
+          if (ret == -ENOENT && (oflags & O_CREAT) == 0)
+            {
+              dcache_add(inode, desc.relpath, NULL, gen);
+            }
+          else if (ret >= 0 && (oflags & (O_WROK | O_CREAT)) != 0)
+            {
+              dcache_invalidate(inode, desc.relpath);
+            }
         }
       else
 #endif
@@ -469,6 +469,12 @@ next_subdir:
        */
 
       ret = oldinode->u.i_mops->rename(oldinode, oldrelpath, newrelpath);
+
+      /* The paths of everything below a renamed directory change too, so
+       * forget everything cached for the volume.
+       */
+
+      dcache_flush(oldinode, false);
     }
 
 errout_with_newinode:
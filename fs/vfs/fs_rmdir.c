@@ -126,6 +126,8 @@ int rmdir(FAR const char *pathname)
               errcode = -ret;
               goto errout_with_inode;
             }
+
+          dcache_invalidate(inode, desc.relpath);
         }
       else
         {
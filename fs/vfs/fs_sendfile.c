@@ -41,6 +41,8 @@
 #include <nuttx/config.h>
 
 #include <sys/sendfile.h>
+#include <sys/stat.h>
+#include <sys/ioctl.h>
 #include <stdbool.h>
 #include <stdlib.h>
 #include <unistd.h>
@@ -48,9 +50,120 @@
 #include <assert.h>
 
 #include <nuttx/sched.h>
+#include <nuttx/fs/fs.h>
+#include <nuttx/fs/ioctl.h>
 #include <nuttx/net/net.h>
 
-#ifdef CONFIG_NET_SENDFILE
+#ifdef CONFIG_FS_SENDFILE
+
+/****************************************************************************
+ * Private Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: file_sendmapped
+ *
+ * Description:
+ *   Copy from a file whose content is directly addressable (via FIOC_MMAP,
+ *   as with XIP romfs and tmpfs) to any writable file or driver.  The
+ *   destination write() method is fed straight from the source memory so
+ *   that no intermediate buffer is needed.
+ *
+ * Returned Value:
+ *   The number of bytes written on success; a negated errno value on
+ *   failure.  -ENOSYS means that the source cannot be mapped and that the
+ *   caller should fall back to the buffered copy.
+ *
+ ****************************************************************************/
+
+static ssize_t file_sendmapped(FAR struct file *outfile,
+                               FAR struct file *infile,
+                               FAR off_t *offset, size_t count)
+{
+  FAR const uint8_t *src;
+  FAR void *addr = NULL;
+  struct stat buf;
+  size_t ntransferred;
+  ssize_t nwritten;
+  off_t pos;
+  int ret;
+
+  /* Is the source content directly addressable? */
+
+  if (infile->f_inode == NULL ||
+      !INODE_IS_MOUNTPT(infile->f_inode) ||
+      file_ioctl(infile, FIOC_MMAP, (unsigned long)((uintptr_t)&addr)) < 0 ||
+      addr == NULL)
+    {
+      return -ENOSYS;
+    }
+
+  /* Clip the transfer to the end of the source file */
+
+  ret = file_fstat(infile, &buf);
+  if (ret < 0)
+    {
+      return -ENOSYS;
+    }
+
+  pos = offset != NULL ? *offset : infile->f_pos;
+  if (pos < 0)
+    {
+      return -EINVAL;
+    }
+
+  if (pos >= buf.st_size)
+    {
+      return 0;
+    }
+
+  if (count > buf.st_size - pos)
+    {
+      count = buf.st_size - pos;
+    }
+
+  /* Write directly from the source memory.  A short write (as from a pipe
+   * or a serial driver) just continues from where it stopped.
+   */
+
+  src = (FAR const uint8_t *)addr + pos;
+  for (ntransferred = 0; ntransferred < count; ntransferred += nwritten)
+    {
+      nwritten = file_write(outfile, src + ntransferred,
+                            count - ntransferred);
+      if (nwritten <= 0)
+        {
+          /* Report a failure only if nothing was transferred.  EINTR
+           * stops the copy like any other error.
+           */
+
+          if (ntransferred == 0)
+            {
+              return nwritten < 0 ? nwritten : -EIO;
+            }
+
+          break;
+        }
+    }
+
+  /* Update the offset or the source file position */
+
+  pos += ntransferred;
+  if (offset != NULL)
+    {
+      *offset = pos;
+    }
+  else
+    {
+      ret = file_seek(infile, pos, SEEK_SET);
+      if (ret < 0)
+        {
+          return ret;
+        }
+    }
+
+  return ntransferred;
+}
 
 /****************************************************************************
  * Public Functions
@@ -68,6 +181,10 @@
  *   performance than simple reds() and writes(). The data is read directly
  *   into the net buffer and the whole tcp window is filled if possible.
  *
+ *   If the source file content is directly addressable (XIP romfs or
+ *   tmpfs), the destination file or driver (a pipe, a serial or USB CDC/ACM
+ *   device, another file) is written directly from the source memory.
+ *
  *   NOTE: This interface is *not* specified in POSIX.1-2001, or other
  *   standards.  The implementation here is very similar to the Linux
  *   sendfile interface.  Other UNIX systems implement sendfile() with
@@ -103,6 +220,10 @@
 
 ssize_t sendfile(int outfd, int infd, off_t *offset, size_t count)
 {
+  FAR struct file *outfile;
+  FAR struct file *infile;
+  ssize_t ret;
+
 #ifdef CONFIG_NET_SENDFILE
   /* Check the destination file descriptor:  Is it a (probable) file
    * descriptor?  Check the source file:  Is it a normal file?
@@ -112,7 +233,6 @@ ssize_t sendfile(int outfd, int infd, off_t *offset, size_t count)
       (unsigned int)infd < CONFIG_NFILE_DESCRIPTORS)
     {
       FAR struct file *filep;
-      int ret;
 
       /* This appears to be a file-to-socket transfer.  Get the file
        * structure.
@@ -141,12 +261,29 @@ ssize_t sendfile(int outfd, int infd, off_t *offset, size_t count)
     }
 #endif
 
-  /* No... then this is probably a file-to-file transfer.  The generic
-   * lib_sendfile() can handle that case.
+  /* No... then this is probably a file-to-file transfer.  Copy straight
+   * from the source memory if possible.
    */
 
+  if (fs_getfilep(outfd, &outfile) >= 0 && fs_getfilep(infd, &infile) >= 0)
+    {
+      ret = file_sendmapped(outfile, infile, offset, count);
+      if (ret != -ENOSYS)
+        {
+          if (ret < 0)
+            {
+              set_errno(-ret);
+              return ERROR;
+            }
+
+          return ret;
+        }
+    }
+
+  /* Otherwise, the generic lib_sendfile() can handle that case. */
+
   return lib_sendfile(outfd, infd, offset, count);
 }
 
-#endif /* CONFIG_NET_SENDFILE */
+#endif /* CONFIG_FS_SENDFILE */
 
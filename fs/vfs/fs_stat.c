@@ -46,6 +46,7 @@
 #include <errno.h>
 
 #include "inode/inode.h"
+#include "shm/shm.h"
 
 /****************************************************************************
  * Pre-processor Definitions
@@ -145,9 +146,21 @@ int stat_recursive(FAR const char *path, FAR struct stat *buf)
 
       if (inode->u.i_mops && inode->u.i_mops->stat)
         {
-          /* Perform the stat() operation */
+          uint32_t gen;
 
-          ret = inode->u.i_mops->stat(inode, desc.relpath, buf);
+          /* Check for a cached result first.  Otherwise, perform the
+           * stat() operation and cache its outcome.
+           */
+
+          if (!dcache_lookup(inode, desc.relpath, buf, &ret, &gen))
+            {
+              ret = inode->u.i_mops->stat(inode, desc.relpath, buf);
+              if (ret >= 0 || ret == -ENOENT)
+                {
+                  dcache_add(inode, desc.relpath, ret >= 0 ? buf : NULL,
+                             gen);
+                }
+            }
         }
     }
   else
@@ -292,7 +305,10 @@ int inode_stat(FAR struct inode *inode, FAR struct stat *buf)
 #if defined(CONFIG_FS_SHM)
       if (INODE_IS_SHM(inode))
         {
+          FAR struct shm_object_s *object = inode->i_private;
+
           buf->st_mode = S_IFSHM;
+          buf->st_size = object != NULL ? object->length : 0;
         }
       else
 #endif
@@ -0,0 +1,650 @@
+/****************************************************************************
+ * fs/vfs/fs_timerfd.c
+ *
+ *   Copyright (C) 2020 Gregory Nutt. All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in
+ *    the documentation and/or other materials provided with the
+ *    distribution.
+ * 3. Neither the name NuttX nor the names of its contributors may be
+ *    used to endorse or promote products derived from this software
+ *    without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+ * FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE
+ * COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+ * INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,
+ * BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS
+ * OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED
+ * AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ * LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN
+ * ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ *
+ ****************************************************************************/
+
+/****************************************************************************
+ * Included Files
+ ****************************************************************************/
+
+#include <nuttx/config.h>
+
+#include <sys/timerfd.h>
+
+#include <stdint.h>
+#include <stdbool.h>
+#include <string.h>
+#include <poll.h>
+#include <fcntl.h>
+#include <time.h>
+#include <assert.h>
+#include <errno.h>
+#include <debug.h>
+
+#include <nuttx/irq.h>
+#include <nuttx/clock.h>
+#include <nuttx/kmalloc.h>
+#include <nuttx/semaphore.h>
+#include <nuttx/wdog.h>
+#include <nuttx/fs/fs.h>
+
+#include "inode/inode.h"
+
+#ifdef CONFIG_TIMER_FD
+
+/****************************************************************************
+ * Private Types
+ ****************************************************************************/
+
+/* This is the state of one timer object.  It is the private data of the
+ * unnamed inode behind the timer file descriptor.  All fields are protected
+ * by a critical section since the timer expires in the watchdog interrupt.
+ */
+
+struct timerfd_priv_s
+{
+  timerfd_t counter;              /* Expirations since the last read() */
+  WDOG_ID wdog;                   /* The watchdog that provides the timing */
+  int32_t interval;               /* Ticks between periodic expirations */
+  clockid_t clockid;              /* The clock of TFD_TIMER_ABSTIME */
+  sem_t rdsem;                    /* Readers wait here for an expiration */
+  int crefs;                      /* Open descriptors */
+
+  /* The poll waiters */
+
+  FAR struct pollfd *fds[CONFIG_TIMER_FD_NPOLLWAITERS];
+};
+
+/****************************************************************************
+ * Private Function Prototypes
+ ****************************************************************************/
+
+static int timerfd_open(FAR struct file *filep);
+static int timerfd_close(FAR struct file *filep);
+static ssize_t timerfd_read(FAR struct file *filep, FAR char *buffer,
+                            size_t buflen);
+static int timerfd_poll(FAR struct file *filep, FAR struct pollfd *fds,
+                        bool setup);
+
+/****************************************************************************
+ * Private Data
+ ****************************************************************************/
+
+static const struct file_operations g_timerfd_ops =
+{
+  timerfd_open,       /* open */
+  timerfd_close,      /* close */
+  timerfd_read,       /* read */
+  NULL,               /* write */
+  NULL,               /* seek */
+  NULL,               /* ioctl */
+  timerfd_poll        /* poll */
+#ifndef CONFIG_DISABLE_PSEUDOFS_OPERATIONS
+  , NULL              /* unlink */
+#endif
+};
+
+/****************************************************************************
+ * Private Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: timerfd_pollnotify
+ *
+ * Description:
+ *   Report events to the poll waiters.  Called from within a critical
+ *   section.
+ *
+ ****************************************************************************/
+
+static void timerfd_pollnotify(FAR struct timerfd_priv_s *dev,
+                               pollevent_t eventset)
+{
+  FAR struct pollfd *fds;
+  int i;
+
+  for (i = 0; i < CONFIG_TIMER_FD_NPOLLWAITERS; i++)
+    {
+      fds = dev->fds[i];
+      if (fds != NULL)
+        {
+          fds->revents |= eventset & fds->events;
+          if (fds->revents != 0)
+            {
+              nxsem_post(fds->sem);
+            }
+        }
+    }
+}
+
+/****************************************************************************
+ * Name: timerfd_expire
+ *
+ * Description:
+ *   Count one expiration and wake up the readers.  Called from within a
+ *   critical section.
+ *
+ ****************************************************************************/
+
+static void timerfd_expire(FAR struct timerfd_priv_s *dev)
+{
+  int sval;
+
+  if (dev->counter < UINT64_MAX)
+    {
+      dev->counter++;
+    }
+
+  while (nxsem_getvalue(&dev->rdsem, &sval) == 0 && sval < 0)
+    {
+      nxsem_post(&dev->rdsem);
+    }
+
+  timerfd_pollnotify(dev, POLLIN);
+}
+
+/****************************************************************************
+ * Name: timerfd_timeout
+ *
+ * Description:
+ *   The watchdog expired.  Restart it for a periodic timer.
+ *
+ ****************************************************************************/
+
+static void timerfd_timeout(int argc, wdparm_t arg)
+{
+  FAR struct timerfd_priv_s *dev = (FAR struct timerfd_priv_s *)arg;
+
+  timerfd_expire(dev);
+
+  if (dev->interval > 0)
+    {
+      wd_start(dev->wdog, dev->interval, (wdentry_t)timerfd_timeout,
+               1, (wdparm_t)dev);
+    }
+}
+
+/****************************************************************************
+ * Name: timerfd_ts2ticks
+ *
+ * Description:
+ *   Convert a time interval to ticks, rounding up so that the timer never
+ *   expires early.
+ *
+ ****************************************************************************/
+
+static int32_t timerfd_ts2ticks(FAR const struct timespec *ts)
+{
+  int64_t ticks;
+
+  ticks = (int64_t)ts->tv_sec * TICK_PER_SEC +
+          (ts->tv_nsec + NSEC_PER_TICK - 1) / NSEC_PER_TICK;
+
+  return ticks > INT32_MAX ? INT32_MAX : (int32_t)ticks;
+}
+
+/****************************************************************************
+ * Name: timerfd_ticks2ts
+ ****************************************************************************/
+
+static void timerfd_ticks2ts(int32_t ticks, FAR struct timespec *ts)
+{
+  ts->tv_sec  = ticks / TICK_PER_SEC;
+  ts->tv_nsec = (ticks % TICK_PER_SEC) * NSEC_PER_TICK;
+}
+
+/****************************************************************************
+ * Name: timerfd_getdev
+ *
+ * Description:
+ *   Get the timer object behind a timer file descriptor.
+ *
+ ****************************************************************************/
+
+static int timerfd_getdev(int fd, FAR struct timerfd_priv_s **dev)
+{
+  FAR struct file *filep;
+  int ret;
+
+  ret = fs_getfilep(fd, &filep);
+  if (ret < 0)
+    {
+      return ret;
+    }
+
+  if (filep->f_inode == NULL || filep->f_inode->u.i_ops != &g_timerfd_ops)
+    {
+      return -EINVAL;
+    }
+
+  *dev = (FAR struct timerfd_priv_s *)filep->f_inode->i_private;
+  return OK;
+}
+
+/****************************************************************************
+ * Name: timerfd_getvalue
+ *
+ * Description:
+ *   Return the time until the next expiration and the interval.  Called
+ *   from within a critical section.
+ *
+ ****************************************************************************/
+
+static void timerfd_getvalue(FAR struct timerfd_priv_s *dev,
+                             FAR struct itimerspec *value)
+{
+  timerfd_ticks2ts(wd_gettime(dev->wdog), &value->it_value);
+  timerfd_ticks2ts(dev->interval, &value->it_interval);
+}
+
+/****************************************************************************
+ * Name: timerfd_open
+ *
+ * Description:
+ *   Called when the timer file descriptor is duplicated.
+ *
+ ****************************************************************************/
+
+static int timerfd_open(FAR struct file *filep)
+{
+  FAR struct timerfd_priv_s *dev = filep->f_inode->i_private;
+  irqstate_t flags;
+
+  flags = enter_critical_section();
+  dev->crefs++;
+  leave_critical_section(flags);
+  return OK;
+}
+
+/****************************************************************************
+ * Name: timerfd_close
+ *
+ * Description:
+ *   Called when a timer file descriptor is closed.  The unnamed inode is
+ *   freed by inode_release().
+ *
+ ****************************************************************************/
+
+static int timerfd_close(FAR struct file *filep)
+{
+  FAR struct timerfd_priv_s *dev = filep->f_inode->i_private;
+  irqstate_t flags;
+  int crefs;
+
+  flags = enter_critical_section();
+  crefs = --dev->crefs;
+  leave_critical_section(flags);
+
+  if (crefs <= 0)
+    {
+      wd_delete(dev->wdog);
+      nxsem_destroy(&dev->rdsem);
+      kmm_free(dev);
+    }
+
+  return OK;
+}
+
+/****************************************************************************
+ * Name: timerfd_read
+ ****************************************************************************/
+
+static ssize_t timerfd_read(FAR struct file *filep, FAR char *buffer,
+                            size_t buflen)
+{
+  FAR struct timerfd_priv_s *dev = filep->f_inode->i_private;
+  irqstate_t flags;
+  timerfd_t value;
+  int ret;
+
+  if (buflen < sizeof(timerfd_t))
+    {
+      return -EINVAL;
+    }
+
+  flags = enter_critical_section();
+  while (dev->counter == 0)
+    {
+      if ((filep->f_oflags & O_NONBLOCK) != 0)
+        {
+          leave_critical_section(flags);
+          return -EAGAIN;
+        }
+
+      ret = nxsem_wait(&dev->rdsem);
+      if (ret < 0)
+        {
+          leave_critical_section(flags);
+          return ret;
+        }
+    }
+
+  value = dev->counter;
+  dev->counter = 0;
+  leave_critical_section(flags);
+
+  memcpy(buffer, &value, sizeof(timerfd_t));
+  return sizeof(timerfd_t);
+}
+
+/****************************************************************************
+ * Name: timerfd_poll
+ ****************************************************************************/
+
+static int timerfd_poll(FAR struct file *filep, FAR struct pollfd *fds,
+                        bool setup)
+{
+  FAR struct timerfd_priv_s *dev = filep->f_inode->i_private;
+  FAR struct pollfd **slot;
+  irqstate_t flags;
+  int ret = OK;
+  int i;
+
+  flags = enter_critical_section();
+  if (setup)
+    {
+      for (i = 0; i < CONFIG_TIMER_FD_NPOLLWAITERS; i++)
+        {
+          if (dev->fds[i] == NULL)
+            {
+              dev->fds[i] = fds;
+              fds->priv   = &dev->fds[i];
+              break;
+            }
+        }
+
+      if (i >= CONFIG_TIMER_FD_NPOLLWAITERS)
+        {
+          fds->priv = NULL;
+          ret       = -EBUSY;
+          goto errout;
+        }
+
+      /* Report an expiration that is already pending */
+
+      if (dev->counter > 0)
+        {
+          timerfd_pollnotify(dev, POLLIN);
+        }
+    }
+  else
+    {
+      slot = (FAR struct pollfd **)fds->priv;
+      if (slot != NULL)
+        {
+          *slot     = NULL;
+          fds->priv = NULL;
+        }
+    }
+
+errout:
+  leave_critical_section(flags);
+  return ret;
+}
+
+/****************************************************************************
+ * Public Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: timerfd_create
+ *
+ * Description:
+ *   Create a timer file descriptor.  See include/sys/timerfd.h.
+ *
+ ****************************************************************************/
+
+int timerfd_create(int clockid, int flags)
+{
+  FAR struct timerfd_priv_s *dev;
+  FAR struct inode *inode;
+  int errcode;
+  int fd;
+
+  if ((flags & ~(TFD_NONBLOCK | TFD_CLOEXEC)) != 0)
+    {
+      errcode = EINVAL;
+      goto errout;
+    }
+
+#ifdef CONFIG_CLOCK_MONOTONIC
+  if (clockid != CLOCK_REALTIME && clockid != CLOCK_MONOTONIC)
+#else
+  if (clockid != CLOCK_REALTIME)
+#endif
+    {
+      errcode = EINVAL;
+      goto errout;
+    }
+
+  dev = (FAR struct timerfd_priv_s *)
+    kmm_zalloc(sizeof(struct timerfd_priv_s));
+  if (dev == NULL)
+    {
+      errcode = ENOMEM;
+      goto errout;
+    }
+
+  dev->wdog = wd_create();
+  if (dev->wdog == NULL)
+    {
+      errcode = ENOMEM;
+      goto errout_with_dev;
+    }
+
+  /* The semaphore is used for signaling and, hence, should not have
+   * priority inheritance enabled.
+   */
+
+  nxsem_init(&dev->rdsem, 0, 0);
+  nxsem_setprotocol(&dev->rdsem, SEM_PRIO_NONE);
+
+  dev->clockid = clockid;
+  dev->crefs   = 1;
+
+  /* Like an event file descriptor, the timer object is an unnamed inode
+   * that is not in the inode tree and is freed by inode_release() with the
+   * last file descriptor.
+   */
+
+  inode = (FAR struct inode *)kmm_zalloc(FSNODE_SIZE(0));
+  if (inode == NULL)
+    {
+      errcode = ENOMEM;
+      goto errout_with_wdog;
+    }
+
+  INODE_SET_DRIVER(inode);
+  inode->i_flags  |= FSNODEFLAG_DELETED;
+  inode->i_crefs   = 1;
+  inode->u.i_ops   = &g_timerfd_ops;
+  inode->i_private = dev;
+
+  fd = files_allocate(inode, O_RDONLY | (flags & TFD_NONBLOCK), 0, 0);
+  if (fd < 0)
+    {
+      errcode = EMFILE;
+      kmm_free(inode);
+      goto errout_with_wdog;
+    }
+
+  return fd;
+
+errout_with_wdog:
+  nxsem_destroy(&dev->rdsem);
+  wd_delete(dev->wdog);
+
+errout_with_dev:
+  kmm_free(dev);
+
+errout:
+  set_errno(errcode);
+  return ERROR;
+}
+
+/****************************************************************************
+ * Name: timerfd_settime
+ *
+ * Description:
+ *   Arm or disarm the timer of a timer file descriptor.  See
+ *   include/sys/timerfd.h.
+ *
+ ****************************************************************************/
+
+int timerfd_settime(int fd, int flags,
+                    FAR const struct itimerspec *new_value,
+                    FAR struct itimerspec *old_value)
+{
+  FAR struct timerfd_priv_s *dev;
+  struct timespec now;
+  irqstate_t intflags;
+  int32_t delay;
+  int ret;
+
+  ret = timerfd_getdev(fd, &dev);
+  if (ret < 0)
+    {
+      set_errno(-ret);
+      return ERROR;
+    }
+
+  if (new_value == NULL || (flags & ~TFD_TIMER_ABSTIME) != 0 ||
+      new_value->it_value.tv_nsec < 0 ||
+      new_value->it_value.tv_nsec >= NSEC_PER_SEC ||
+      new_value->it_interval.tv_nsec < 0 ||
+      new_value->it_interval.tv_nsec >= NSEC_PER_SEC)
+    {
+      set_errno(EINVAL);
+      return ERROR;
+    }
+
+  intflags = enter_critical_section();
+
+  if (old_value != NULL)
+    {
+      timerfd_getvalue(dev, old_value);
+    }
+
+  /* Disarm the timer and forget the expirations of the previous setting */
+
+  wd_cancel(dev->wdog);
+  dev->counter  = 0;
+  dev->interval = timerfd_ts2ticks(&new_value->it_interval);
+
+  if (new_value->it_value.tv_sec <= 0 && new_value->it_value.tv_nsec <= 0)
+    {
+      dev->interval = 0;
+      goto out;
+    }
+
+  if ((flags & TFD_TIMER_ABSTIME) != 0)
+    {
+      clock_gettime(dev->clockid, &now);
+
+      if (new_value->it_value.tv_sec < now.tv_sec ||
+          (new_value->it_value.tv_sec == now.tv_sec &&
+           new_value->it_value.tv_nsec <= now.tv_nsec))
+        {
+          delay = 0;
+        }
+      else
+        {
+          now.tv_sec  = new_value->it_value.tv_sec - now.tv_sec;
+          now.tv_nsec = new_value->it_value.tv_nsec - now.tv_nsec;
+          if (now.tv_nsec < 0)
+            {
+              now.tv_sec--;
+              now.tv_nsec += NSEC_PER_SEC;
+            }
+
+          delay = timerfd_ts2ticks(&now);
+        }
+    }
+  else
+    {
+      delay = timerfd_ts2ticks(&new_value->it_value);
+    }
+
+  /* A time in the past expires at once */
+
+  if (delay <= 0)
+    {
+      timerfd_expire(dev);
+      delay = dev->interval;
+    }
+
+  if (delay > 0)
+    {
+      wd_start(dev->wdog, delay, (wdentry_t)timerfd_timeout,
+               1, (wdparm_t)dev);
+    }
+
+out:
+  leave_critical_section(intflags);
+  return OK;
+}
+
+/****************************************************************************
+ * Name: timerfd_gettime
+ *
+ * Description:
+ *   Return the time until the next expiration and the interval of the
+ *   timer of a timer file descriptor.  See include/sys/timerfd.h.
+ *
+ ****************************************************************************/
+
+int timerfd_gettime(int fd, FAR struct itimerspec *curr_value)
+{
+  FAR struct timerfd_priv_s *dev;
+  irqstate_t flags;
+  int ret;
+
+  ret = timerfd_getdev(fd, &dev);
+  if (ret < 0)
+    {
+      set_errno(-ret);
+      return ERROR;
+    }
+
+  if (curr_value == NULL)
+    {
+      set_errno(EINVAL);
+      return ERROR;
+    }
+
+  flags = enter_critical_section();
+  timerfd_getvalue(dev, curr_value);
+  leave_critical_section(flags);
+  return OK;
+}
+
+#endif /* CONFIG_TIMER_FD */
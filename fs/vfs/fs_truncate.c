@@ -45,6 +45,7 @@
 #include <assert.h>
 
 #include <nuttx/fs/fs.h>
+#include <nuttx/fs/ioctl.h>
 
 #include "inode/inode.h"
 
@@ -67,6 +68,7 @@
 int file_truncate(FAR struct file *filep, off_t length)
 {
   struct inode *inode;
+  int ret;
 
   /* Was this file opened for write access? */
 
@@ -76,12 +78,23 @@ int file_truncate(FAR struct file *filep, off_t length)
       return -EBADF;
     }
 
+  inode = filep->f_inode;
+
+#ifdef CONFIG_FS_SHM
+  /* Shared memory objects are sized with the FIOC_TRUNCATE ioctl */
+
+  if (inode != NULL && INODE_IS_SHM(inode))
+    {
+      return inode->u.i_ops->ioctl(filep, FIOC_TRUNCATE,
+                                   (unsigned long)length);
+    }
+#endif
+
   /* Is this inode a registered mountpoint? Does it support the
    * truncate operations may be relevant to device drivers but only
    * the mountpoint operations vtable contains a truncate method.
    */
 
-  inode = filep->f_inode;
   if (inode == NULL || !INODE_IS_MOUNTPT(inode) || inode->u.i_mops == NULL)
     {
       fwarn("WARNING:  Not a (regular) file on a mounted file system.\n");
@@ -110,7 +123,9 @@ int file_truncate(FAR struct file *filep, off_t length)
 
   /* Yes, then tell the file system to truncate this file */
 
-  return inode->u.i_mops->truncate(filep, length);
+  ret = inode->u.i_mops->truncate(filep, length);
+  dcache_flush(inode, true);
+  return ret;
 }
 
 /****************************************************************************
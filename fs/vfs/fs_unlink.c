@@ -125,6 +125,8 @@ int unlink(FAR const char *pathname)
               errcode = -ret;
               goto errout_with_inode;
             }
+
+          dcache_invalidate(inode, desc.relpath);
         }
       else
         {
@@ -107,6 +107,23 @@ ssize_t file_write(FAR struct file *filep, FAR const void *buf, size_t nbytes)
 
   /* Yes, then let the driver perform the write */
 
+#ifdef CONFIG_FS_DCACHE
+  if (INODE_IS_MOUNTPT(inode))
+    {
+      ssize_t ret;
+
+      /* Writing changes the size and times of the file.  The file's path
+       * is not known here, so forget the attributes of all files in the
+       * volume.  This must follow the write so that no stat() that
+       * overlaps the write can cache the old attributes.
+       */
+
+      ret = inode->u.i_ops->write(filep, buf, nbytes);
+      dcache_flush(inode, true);
+      return ret;
+    }
+#endif
+
   return inode->u.i_ops->write(filep, buf, nbytes);
 }
 
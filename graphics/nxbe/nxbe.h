@@ -80,6 +80,14 @@
 #define NXBE_STATE_CLRMODAL(nxbe) \
   do { (nxbe)->flags &= ~NXBE_STATE_MODAL; } while (0)
 
+/* Fills and bitmap copies may be handed to a framebuffer driver that
+ * accelerates them in hardware.
+ */
+
+#if defined(CONFIG_FB_ACCEL) && !defined(CONFIG_NX_LCDDRIVER)
+#  define NXBE_FBACCEL 1
+#endif
+
 /****************************************************************************
  * Public Types
  ****************************************************************************/
@@ -190,6 +198,13 @@ struct nxbe_plane_s
   /* Framebuffer plane info describing destination video plane */
 
   NX_PLANEINFOTYPE pinfo;
+
+#ifdef NXBE_FBACCEL
+  /* Driver that accelerates 2D operations on this plane, or NULL */
+
+  FAR NX_DRIVERTYPE *accel;
+  uint8_t planeno;
+#endif
 };
 
 /* Clipping *****************************************************************/
@@ -63,6 +63,43 @@ struct nx_bitmap_s
  * Private Functions
  ****************************************************************************/
 
+/****************************************************************************
+ * Name: bitmap_accelcopy
+ *
+ * Description:
+ *  Copy the part of the source image that maps onto a rectangle in device
+ *  coordinates with the framebuffer driver's hardware 2D engine.
+ *
+ ****************************************************************************/
+
+#ifdef NXBE_FBACCEL
+static int bitmap_accelcopy(FAR struct nx_bitmap_s *bminfo,
+                            FAR struct nxbe_plane_s *plane,
+                            FAR const struct nxgl_rect_s *rect)
+{
+  struct fb_copyrect_s copy;
+
+  if (plane->accel == NULL || plane->accel->copyrect == NULL ||
+      bminfo->stride > UINT16_MAX)
+    {
+      return -ENOSYS;
+    }
+
+  copy.planeno   = plane->planeno;
+  copy.x         = rect->pt1.x;
+  copy.y         = rect->pt1.y;
+  copy.w         = rect->pt2.x - rect->pt1.x + 1;
+  copy.h         = rect->pt2.y - rect->pt1.y + 1;
+  copy.src       = (FAR const uint8_t *)bminfo->src +
+                   (rect->pt1.y - bminfo->origin.y) * bminfo->stride +
+                   (rect->pt1.x - bminfo->origin.x) *
+                   (plane->pinfo.bpp >> 3);
+  copy.srcstride = bminfo->stride;
+
+  return plane->accel->copyrect(plane->accel, &copy);
+}
+#endif
+
 /****************************************************************************
  * Name: bitmap_clipcopy
  *
@@ -78,10 +115,19 @@ static void bitmap_clipcopy(FAR struct nxbe_clipops_s *cops,
 {
   struct nx_bitmap_s *bminfo = (struct nx_bitmap_s *)cops;
 
-  /* Copy the rectangular region to the graphics device. */
+#ifdef NXBE_FBACCEL
+  /* Let the hardware copy the image if it can, otherwise fall back to the
+   * software rasterizer.
+   */
 
-  plane->dev.copyrectangle(&plane->pinfo, rect, bminfo->src,
-                           &bminfo->origin, bminfo->stride);
+  if (bitmap_accelcopy(bminfo, plane, rect) < 0)
+#endif
+    {
+      /* Copy the rectangular region to the graphics device. */
+
+      plane->dev.copyrectangle(&plane->pinfo, rect, bminfo->src,
+                               &bminfo->origin, bminfo->stride);
+    }
 
 #ifdef CONFIG_NX_UPDATE
   /* Notify external logic that the display has been updated */
@@ -125,6 +125,21 @@ int nxbe_configure(FAR NX_DRIVERTYPE *dev, FAR struct nxbe_state_s *be)
           return ret;
         }
 
+#ifdef NXBE_FBACCEL
+      /* Remember the driver if it can accelerate fills or copies.  Packed
+       * pixel formats are always rendered in software.
+       */
+
+      be->plane[i].planeno = i;
+      be->plane[i].accel   = NULL;
+
+      if ((dev->fillrect != NULL || dev->copyrect != NULL) &&
+          be->plane[i].pinfo.bpp >= 8)
+        {
+          be->plane[i].accel = dev;
+        }
+#endif
+
       /* Select rasterizers to match the BPP reported for this plane.
        * NOTE that there are configuration options to eliminate support
        * for unused BPP values.  If the unused BPP values are not suppressed
@@ -41,6 +41,7 @@
 #include <nuttx/config.h>
 
 #include <assert.h>
+#include <errno.h>
 
 #include <nuttx/nx/nxglib.h>
 #include <nuttx/nx/nx.h>
@@ -61,6 +62,38 @@ struct nxbe_fill_s
  * Private Functions
  ****************************************************************************/
 
+/****************************************************************************
+ * Name: nxbe_accelfill
+ *
+ * Description:
+ *  Fill a rectangle in device coordinates with the framebuffer driver's
+ *  hardware 2D engine.
+ *
+ ****************************************************************************/
+
+#ifdef NXBE_FBACCEL
+static int nxbe_accelfill(FAR struct nxbe_plane_s *plane,
+                          FAR const struct nxgl_rect_s *rect,
+                          nxgl_mxpixel_t color)
+{
+  struct fb_fillrect_s fill;
+
+  if (plane->accel == NULL || plane->accel->fillrect == NULL)
+    {
+      return -ENOSYS;
+    }
+
+  fill.planeno = plane->planeno;
+  fill.x       = rect->pt1.x;
+  fill.y       = rect->pt1.y;
+  fill.w       = rect->pt2.x - rect->pt1.x + 1;
+  fill.h       = rect->pt2.y - rect->pt1.y + 1;
+  fill.color   = color;
+
+  return plane->accel->fillrect(plane->accel, &fill);
+}
+#endif
+
 /****************************************************************************
  * Name: nxbe_clipfill
  *
@@ -76,9 +109,18 @@ static void nxbe_clipfill(FAR struct nxbe_clipops_s *cops,
 {
   struct nxbe_fill_s *fillinfo = (struct nxbe_fill_s *)cops;
 
-  /* Draw the rectangle to the graphics device. */
+#ifdef NXBE_FBACCEL
+  /* Let the hardware fill the rectangle if it can, otherwise fall back to
+   * the software rasterizer.
+   */
 
-  plane->dev.fillrectangle(&plane->pinfo, rect, fillinfo->color);
+  if (nxbe_accelfill(plane, rect, fillinfo->color) < 0)
+#endif
+    {
+      /* Draw the rectangle to the graphics device. */
+
+      plane->dev.fillrectangle(&plane->pinfo, rect, fillinfo->color);
+    }
 
 #ifdef CONFIG_NX_UPDATE
   /* Notify external logic that the display has been updated */
@@ -143,30 +143,16 @@
 
 #elif NXGLIB_BITSPERPIXEL == 24
 
+/* Runs are filled and copied a word at a time, see the inline functions
+ * below.
+ */
+
 #  define NXGL_MEMSET(dest,value,width) \
-   { \
-     FAR uint8_t *_ptr  = (FAR uint8_t*)(dest); \
-     nxgl_coord_t _npix = (width); \
-     while (_npix--) \
-       { \
-         *_ptr++ = (value); \
-         *_ptr++ = (value) >> 8; \
-         *_ptr++ = (value) >> 16; \
-       } \
-   }
+     nxgl_pixset24((FAR uint8_t *)(dest), (value), (width))
 
 #  define NXGL_MEMCPY(dest,src,width) \
-   { \
-     FAR uint8_t *_dptr = (FAR uint8_t*)(dest); \
-     FAR uint8_t *_sptr = (FAR uint8_t*)(src); \
-     nxgl_coord_t _npix = (width); \
-     while (_npix--) \
-       { \
-         *_dptr++ = *_sptr++; \
-         *_dptr++ = *_sptr++; \
-         *_dptr++ = *_sptr++; \
-       } \
-   }
+     nxgl_pixcopy((FAR uint8_t *)(dest), (FAR const uint8_t *)(src), \
+                  NXGL_SCALEX(width))
 
 #ifdef CONFIG_NX_ANTIALIASING
 
@@ -185,28 +171,29 @@
    }
 
 #endif /* CONFIG_NX_ANTIALIASING */
-#else /* NXGLIB_BITSPERPIXEL == 16 || NXGLIB_BITSPERPIXEL == 32 */
+#else /* NXGLIB_BITSPERPIXEL == 8, 16 or 32 */
+
+/* The pixel value replicated to fill a 32-bit word */
+
+#  if NXGLIB_BITSPERPIXEL == 8
+#    define NXGL_WIDEPIXEL(p)      ((uint32_t)(uint8_t)(p) * 0x01010101)
+#  elif NXGLIB_BITSPERPIXEL == 16
+#    define NXGL_WIDEPIXEL(p)      ((uint32_t)(uint16_t)(p) * 0x00010001)
+#  else
+#    define NXGL_WIDEPIXEL(p)      ((uint32_t)(p))
+#  endif
+
+/* Runs are filled and copied a word at a time, see the inline functions
+ * below.
+ */
 
 #  define NXGL_MEMSET(dest,value,width) \
-   { \
-     FAR NXGL_PIXEL_T *_ptr = (FAR NXGL_PIXEL_T*)(dest); \
-     nxgl_coord_t     _npix = (width); \
-     while (_npix--) \
-       { \
-         *_ptr++ = (value); \
-       } \
-   }
+     nxgl_pixset((FAR uint8_t *)(dest), NXGL_WIDEPIXEL(value), \
+                 NXGL_SCALEX(width))
 
 #  define NXGL_MEMCPY(dest,src,width) \
-   { \
-     FAR NXGL_PIXEL_T *_dptr = (FAR NXGL_PIXEL_T*)(dest); \
-     FAR NXGL_PIXEL_T *_sptr = (FAR NXGL_PIXEL_T*)(src); \
-     nxgl_coord_t      _npix = (width); \
-     while (_npix--) \
-       { \
-         *_dptr++ = *_sptr++; \
-       } \
-   }
+     nxgl_pixcopy((FAR uint8_t *)(dest), (FAR const uint8_t *)(src), \
+                  NXGL_SCALEX(width))
 
 #ifdef CONFIG_NX_ANTIALIASING
 
@@ -225,6 +212,201 @@
 #define _NXGL_FUNCNAME(a,b) a ## b
 #define NXGL_FUNCNAME(a,b)  _NXGL_FUNCNAME(a,b)
 
+/****************************************************************************
+ * Inline Functions
+ ****************************************************************************/
+
+#if NXGLIB_BITSPERPIXEL >= 8
+/****************************************************************************
+ * Name: nxgl_pixcopy
+ *
+ * Description:
+ *   Copy nbytes of pixel data.  Once the destination is word aligned the
+ *   bulk of the run is moved four words per iteration.  The source must be
+ *   aligned the same way unless the CPU handles unaligned word loads.
+ *   Overlapping runs, as produced by horizontal moves, are copied from the
+ *   end so that the source is read before it is overwritten.
+ *
+ ****************************************************************************/
+
+static inline void nxgl_pixcopy(FAR uint8_t *dest, FAR const uint8_t *src,
+                                size_t nbytes)
+{
+  FAR uint32_t *wdest;
+  FAR const uint32_t *wsrc;
+
+  if (dest > src && dest < src + nbytes)
+    {
+      dest += nbytes;
+      src  += nbytes;
+
+      while (nbytes-- > 0)
+        {
+          *--dest = *--src;
+        }
+
+      return;
+    }
+
+  while (((uintptr_t)dest & 3) != 0 && nbytes > 0)
+    {
+      *dest++ = *src++;
+      nbytes--;
+    }
+
+#ifndef __ARM_FEATURE_UNALIGNED
+  if (((uintptr_t)src & 3) == 0)
+#endif
+    {
+      wdest = (FAR uint32_t *)dest;
+      wsrc  = (FAR const uint32_t *)src;
+
+      while (nbytes >= 16)
+        {
+          wdest[0] = wsrc[0];
+          wdest[1] = wsrc[1];
+          wdest[2] = wsrc[2];
+          wdest[3] = wsrc[3];
+          wdest   += 4;
+          wsrc    += 4;
+          nbytes  -= 16;
+        }
+
+      while (nbytes >= 4)
+        {
+          *wdest++ = *wsrc++;
+          nbytes  -= 4;
+        }
+
+      dest = (FAR uint8_t *)wdest;
+      src  = (FAR const uint8_t *)wsrc;
+    }
+
+  while (nbytes-- > 0)
+    {
+      *dest++ = *src++;
+    }
+}
+#endif
+
+#if NXGLIB_BITSPERPIXEL == 8 || NXGLIB_BITSPERPIXEL == 16 || \
+    NXGLIB_BITSPERPIXEL == 32
+/****************************************************************************
+ * Name: nxgl_pixset
+ *
+ * Description:
+ *   Fill nbytes with a pixel value that has been replicated across a
+ *   32-bit word.  Pixels are written one at a time until the destination
+ *   is word aligned; the rest of the run is written four words per
+ *   iteration.
+ *
+ ****************************************************************************/
+
+static inline void nxgl_pixset(FAR uint8_t *dest, uint32_t wide,
+                               size_t nbytes)
+{
+  FAR uint32_t *wdest;
+
+  while (((uintptr_t)dest & 3) != 0 && nbytes > 0)
+    {
+      *(FAR NXGL_PIXEL_T *)dest = (NXGL_PIXEL_T)wide;
+      dest   += sizeof(NXGL_PIXEL_T);
+      nbytes -= sizeof(NXGL_PIXEL_T);
+    }
+
+  wdest = (FAR uint32_t *)dest;
+
+  while (nbytes >= 16)
+    {
+      wdest[0] = wide;
+      wdest[1] = wide;
+      wdest[2] = wide;
+      wdest[3] = wide;
+      wdest   += 4;
+      nbytes  -= 16;
+    }
+
+  while (nbytes >= 4)
+    {
+      *wdest++ = wide;
+      nbytes  -= 4;
+    }
+
+  dest = (FAR uint8_t *)wdest;
+
+  while (nbytes > 0)
+    {
+      *(FAR NXGL_PIXEL_T *)dest = (NXGL_PIXEL_T)wide;
+      dest   += sizeof(NXGL_PIXEL_T);
+      nbytes -= sizeof(NXGL_PIXEL_T);
+    }
+}
+#endif
+
+#if NXGLIB_BITSPERPIXEL == 24
+/****************************************************************************
+ * Name: nxgl_pixset24
+ *
+ * Description:
+ *   Fill a run of packed 24-bit pixels, least significant byte first.
+ *   Four pixels occupy exactly three words, so once the destination is
+ *   word aligned the run is written as a repeating three word pattern.
+ *
+ ****************************************************************************/
+
+static inline void nxgl_pixset24(FAR uint8_t *dest, uint32_t color,
+                                 nxgl_coord_t npixels)
+{
+  uint8_t b0 = color;
+  uint8_t b1 = color >> 8;
+  uint8_t b2 = color >> 16;
+
+#ifndef CONFIG_ENDIAN_BIG
+  FAR uint32_t *wdest;
+  uint32_t w0;
+  uint32_t w1;
+  uint32_t w2;
+
+  /* A pixel is three bytes, so alignment is reached within three pixels */
+
+  while (((uintptr_t)dest & 3) != 0 && npixels > 0)
+    {
+      *dest++ = b0;
+      *dest++ = b1;
+      *dest++ = b2;
+      npixels--;
+    }
+
+  w0 = (uint32_t)b0 | (uint32_t)b1 << 8 | (uint32_t)b2 << 16 |
+       (uint32_t)b0 << 24;
+  w1 = (uint32_t)b1 | (uint32_t)b2 << 8 | (uint32_t)b0 << 16 |
+       (uint32_t)b1 << 24;
+  w2 = (uint32_t)b2 | (uint32_t)b0 << 8 | (uint32_t)b1 << 16 |
+       (uint32_t)b2 << 24;
+
+  wdest = (FAR uint32_t *)dest;
+
+  while (npixels >= 4)
+    {
+      wdest[0] = w0;
+      wdest[1] = w1;
+      wdest[2] = w2;
+      wdest   += 3;
+      npixels -= 4;
+    }
+
+  dest = (FAR uint8_t *)wdest;
+#endif
+
+  while (npixels-- > 0)
+    {
+      *dest++ = b0;
+      *dest++ = b1;
+      *dest++ = b2;
+    }
+}
+#endif
+
 /****************************************************************************
  * Public Data
  ****************************************************************************/
@@ -0,0 +1,593 @@
+/****************************************************************************
+ * graphics/vnc/server/vnc_hextile.c
+ *
+ *   Copyright (C) 2020 Gregory Nutt. All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in
+ *    the documentation and/or other materials provided with the
+ *    distribution.
+ * 3. Neither the name NuttX nor the names of its contributors may be
+ *    used to endorse or promote products derived from this software
+ *    without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+ * FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE
+ * COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+ * INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,
+ * BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS
+ * OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED
+ * AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ * LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN
+ * ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ *
+ ****************************************************************************/
+
+/****************************************************************************
+ * Included Files
+ ****************************************************************************/
+
+#include <nuttx/config.h>
+
+#include <stdint.h>
+#include <string.h>
+#include <assert.h>
+#include <errno.h>
+
+#if defined(CONFIG_VNCSERVER_DEBUG) && !defined(CONFIG_DEBUG_GRAPHICS)
+#  undef  CONFIG_DEBUG_ERROR
+#  undef  CONFIG_DEBUG_WARN
+#  undef  CONFIG_DEBUG_INFO
+#  undef  CONFIG_DEBUG_GRAPHICS_ERROR
+#  undef  CONFIG_DEBUG_GRAPHICS_WARN
+#  undef  CONFIG_DEBUG_GRAPHICS_INFO
+#  define CONFIG_DEBUG_ERROR          1
+#  define CONFIG_DEBUG_WARN           1
+#  define CONFIG_DEBUG_INFO           1
+#  define CONFIG_DEBUG_GRAPHICS       1
+#  define CONFIG_DEBUG_GRAPHICS_ERROR 1
+#  define CONFIG_DEBUG_GRAPHICS_WARN  1
+#  define CONFIG_DEBUG_GRAPHICS_INFO  1
+#endif
+#include <debug.h>
+
+#include "vnc_server.h"
+
+/****************************************************************************
+ * Pre-processor Definitions
+ ****************************************************************************/
+
+/* The largest encoded tile:  The subencoding byte, the background and
+ * foreground pixels, and the number of sub-rectangles may be written
+ * before the encoder discovers that the tile is better sent raw.
+ */
+
+#define HEXTILE_MAXTILE(b) \
+  (2 + (RFB_TILESIZE * RFB_TILESIZE + 2) * (b))
+
+/* Access a pixel of the local framebuffer relative to the tile origin */
+
+#define HEXTILE_PIXEL(t,x,y) \
+  ((t)[(y) * CONFIG_VNCSERVER_SCREENWIDTH + (x)])
+
+/****************************************************************************
+ * Private Types
+ ****************************************************************************/
+
+/* State that persists from tile to tile within one Hextile rectangle */
+
+struct vnc_hextile_s
+{
+  FAR struct vnc_session_s *session;
+  unsigned int bytesperpixel;  /* Remote bytes per pixel */
+  bool bigendian;              /* True: Remote expects big-endian pixels */
+  bool bgvalid;                /* True: Background carries over */
+  bool fgvalid;                /* True: Foreground carries over */
+  lfb_color_t bg;              /* Background of the previous tile */
+  lfb_color_t fg;              /* Foreground of the previous tile */
+
+  union
+  {
+    vnc_convert8_t bpp8;
+    vnc_convert16_t bpp16;
+    vnc_convert32_t bpp32;
+  } convert;
+};
+
+/****************************************************************************
+ * Private Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: vnc_hextile_putpixel
+ *
+ * Description:
+ *   Convert one local pixel to the remote color format and store it.
+ *
+ * Input Parameters:
+ *   state - The Hextile encoder state.
+ *   dest  - The location to store the remote pixel.
+ *   color - The pixel in the local framebuffer color format.
+ *
+ * Returned Value:
+ *   The location following the stored pixel.
+ *
+ ****************************************************************************/
+
+static FAR uint8_t *vnc_hextile_putpixel(FAR struct vnc_hextile_s *state,
+                                         FAR uint8_t *dest,
+                                         lfb_color_t color)
+{
+  uint32_t pixel;
+
+  if (state->bytesperpixel == 1)
+    {
+      *dest = state->convert.bpp8(color);
+    }
+  else if (state->bytesperpixel == 2)
+    {
+      pixel = state->convert.bpp16(color);
+      if (state->bigendian)
+        {
+          rfb_putbe16(dest, pixel);
+        }
+      else
+        {
+          rfb_putle16(dest, pixel);
+        }
+    }
+  else /* bytesperpixel == 4 */
+    {
+      pixel = state->convert.bpp32(color);
+      if (state->bigendian)
+        {
+          rfb_putbe32(dest, pixel);
+        }
+      else
+        {
+          rfb_putle32(dest, pixel);
+        }
+    }
+
+  return dest + state->bytesperpixel;
+}
+
+/****************************************************************************
+ * Name: vnc_hextile_tile
+ *
+ * Description:
+ *   Encode one tile.  Tiles with one or two colors are sent as a background
+ *   with foreground sub-rectangles; tiles with more colors use colored
+ *   sub-rectangles.  Sub-rectangles are found greedily by extending each
+ *   uncovered run of pixels downward as far as possible.  If the encoding
+ *   becomes larger than the raw pixel data, the tile is sent raw instead.
+ *
+ * Input Parameters:
+ *   state  - The Hextile encoder state.
+ *   dest   - The location to store the encoded tile.
+ *   row,col      - The upper left X/Y (pixel/row) position of the tile
+ *   width,height - The width (pixels) and height (rows of the tile)
+ *
+ * Returned Value:
+ *   The size of the encoded tile in bytes.
+ *
+ ****************************************************************************/
+
+static size_t vnc_hextile_tile(FAR struct vnc_hextile_s *state,
+                               FAR uint8_t *dest,
+                               nxgl_coord_t row, nxgl_coord_t col,
+                               nxgl_coord_t height, nxgl_coord_t width)
+{
+  FAR const lfb_color_t *tile;
+  FAR uint8_t *start = dest;
+  FAR uint8_t *subenc;
+  FAR uint8_t *nsubrects;
+  uint16_t covered[RFB_TILESIZE];
+  lfb_color_t color;
+  lfb_color_t bg;
+  lfb_color_t fg;
+  unsigned int ncolors;
+  unsigned int nbg;
+  unsigned int nfg;
+  unsigned int nrects;
+  size_t rawsize;
+  size_t rectsize;
+  uint16_t mask;
+  int x;
+  int y;
+  int w;
+  int h;
+  int i;
+
+  tile = (FAR const lfb_color_t *)
+    (state->session->fb + RFB_STRIDE * row + RFB_BYTESPERPIXEL * col);
+
+  /* Count the colors in the tile, giving up on the count at three */
+
+  bg      = tile[0];
+  fg      = bg;
+  ncolors = 1;
+  nbg     = 0;
+  nfg     = 0;
+
+  for (y = 0; y < height && ncolors < 3; y++)
+    {
+      for (x = 0; x < width && ncolors < 3; x++)
+        {
+          color = HEXTILE_PIXEL(tile, x, y);
+          if (color == bg)
+            {
+              nbg++;
+            }
+          else if (ncolors == 1)
+            {
+              fg      = color;
+              ncolors = 2;
+              nfg     = 1;
+            }
+          else if (color == fg)
+            {
+              nfg++;
+            }
+          else
+            {
+              ncolors = 3;
+            }
+        }
+    }
+
+  /* With two colors, let the more common one be the background so that
+   * the sub-rectangles cover fewer pixels.
+   */
+
+  if (ncolors == 2 && nfg > nbg)
+    {
+      color = bg;
+      bg    = fg;
+      fg    = color;
+    }
+
+  subenc  = dest++;
+  *subenc = 0;
+
+  if (!state->bgvalid || bg != state->bg)
+    {
+      *subenc       |= RFB_SUBENCODING_BACK;
+      dest           = vnc_hextile_putpixel(state, dest, bg);
+      state->bg      = bg;
+      state->bgvalid = true;
+    }
+
+  if (ncolors == 1)
+    {
+      /* A solid tile is just the background */
+
+      return (size_t)(dest - start);
+    }
+
+  if (ncolors == 2)
+    {
+      if (!state->fgvalid || fg != state->fg)
+        {
+          *subenc       |= RFB_SUBENCODING_FORE;
+          dest           = vnc_hextile_putpixel(state, dest, fg);
+          state->fg      = fg;
+          state->fgvalid = true;
+        }
+
+      rectsize = 2;
+    }
+  else
+    {
+      /* The foreground does not carry over a colored tile */
+
+      *subenc       |= RFB_SUBENCODING_COLORED;
+      state->fgvalid = false;
+      rectsize       = 2 + state->bytesperpixel;
+    }
+
+  *subenc   |= RFB_SUBENCODING_ANY;
+  nsubrects  = dest++;
+  nrects     = 0;
+  rawsize    = 1 + width * height * state->bytesperpixel;
+
+  memset(covered, 0, sizeof(covered));
+
+  for (y = 0; y < height; y++)
+    {
+      for (x = 0; x < width; x++)
+        {
+          color = HEXTILE_PIXEL(tile, x, y);
+          if (color == bg || (covered[y] & (1 << x)) != 0)
+            {
+              continue;
+            }
+
+          /* Give up if the sub-rectangles would not be smaller than the
+           * raw tile.
+           */
+
+          if (++nrects > 255 || (size_t)(dest - start) + rectsize > rawsize)
+            {
+              goto raw;
+            }
+
+          /* Extend the sub-rectangle right, then down */
+
+          w = 1;
+          while (x + w < width && HEXTILE_PIXEL(tile, x + w, y) == color &&
+                 (covered[y] & (1 << (x + w))) == 0)
+            {
+              w++;
+            }
+
+          mask = (uint16_t)(((1 << w) - 1) << x);
+          for (h = 1; y + h < height; h++)
+            {
+              if ((covered[y + h] & mask) != 0)
+                {
+                  break;
+                }
+
+              for (i = 0; i < w; i++)
+                {
+                  if (HEXTILE_PIXEL(tile, x + i, y + h) != color)
+                    {
+                      break;
+                    }
+                }
+
+              if (i < w)
+                {
+                  break;
+                }
+            }
+
+          for (i = 0; i < h; i++)
+            {
+              covered[y + i] |= mask;
+            }
+
+          if (ncolors > 2)
+            {
+              dest = vnc_hextile_putpixel(state, dest, color);
+            }
+
+          *dest++ = (uint8_t)((x << 4) | y);
+          *dest++ = (uint8_t)(((w - 1) << 4) | (h - 1));
+          x      += w - 1;
+        }
+    }
+
+  *nsubrects = (uint8_t)nrects;
+  return (size_t)(dest - start);
+
+raw:
+
+  /* Send the tile as raw pixels.  Neither the background nor the
+   * foreground carry over a raw tile.
+   */
+
+  dest           = start;
+  *dest++        = RFB_SUBENCODING_RAW;
+  state->bgvalid = false;
+  state->fgvalid = false;
+
+  for (y = 0; y < height; y++)
+    {
+      for (x = 0; x < width; x++)
+        {
+          dest = vnc_hextile_putpixel(state, dest,
+                                      HEXTILE_PIXEL(tile, x, y));
+        }
+    }
+
+  return (size_t)(dest - start);
+}
+
+/****************************************************************************
+ * Name: vnc_hextile_flush
+ *
+ * Description:
+ *   Send the content of the update buffer.
+ *
+ * Input Parameters:
+ *   session - An instance of the session structure.
+ *   size    - The number of bytes in the update buffer.
+ *
+ * Returned Value:
+ *   Zero (OK) on success; A negated errno value is returned on failure.
+ *
+ ****************************************************************************/
+
+static int vnc_hextile_flush(FAR struct vnc_session_s *session, size_t size)
+{
+  FAR const uint8_t *src = session->outbuf;
+  ssize_t nsent;
+
+  /* Send until all of the bytes are out.  This may loop for the case where
+   * TCP write buffering is enabled and there are a limited number of IOBs
+   * available.
+   */
+
+  while (size > 0)
+    {
+      nsent = psock_send(&session->connect, src, size, 0);
+      if (nsent < 0)
+        {
+          gerr("ERROR: Send Hextile FrameBufferUpdate failed: %d\n",
+               (int)nsent);
+          return (int)nsent;
+        }
+
+      DEBUGASSERT(nsent <= size);
+      src  += nsent;
+      size -= nsent;
+    }
+
+  return OK;
+}
+
+/****************************************************************************
+ * Public Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: vnc_hextile
+ *
+ * Description:
+ *  Send the framebuffer update using the Hextile encoding.  Each 16x16
+ *  tile is sent as a background color, a background color with
+ *  sub-rectangles, or as raw pixel data, whichever is the smallest.
+ *
+ * Input Parameters:
+ *   session - An instance of the session structure.
+ *   rect  - Describes the rectangle in the local framebuffer.
+ *
+ * Returned Value:
+ *   Zero is returned if Hextile coding was not performed (but no error was
+ *   encountered).  Otherwise, the size of the framebuffer update message
+ *   is returned on success or a negated errno value is returned on failure
+ *   that indicates the nature of the failure.  A failure is only
+ *   returned in cases of a network failure and unexpected internal failures.
+ *
+ ****************************************************************************/
+
+int vnc_hextile(FAR struct vnc_session_s *session,
+                FAR struct nxgl_rect_s *rect)
+{
+  FAR struct rfb_framebufferupdate_s *update;
+  struct vnc_hextile_s state;
+  nxgl_coord_t width;
+  nxgl_coord_t height;
+  nxgl_coord_t x;
+  nxgl_coord_t y;
+  size_t maxtile;
+  size_t total;
+  size_t size;
+  int ret;
+
+  /* Check if the client supports the Hextile encoding */
+
+  if (!session->hextile)
+    {
+      return 0;
+    }
+
+  /* Set up characteristics of the client pixel format to use on this
+   * update.  The whole rectangle is one message so, unlike the RAW
+   * encoding, a SetPixelFormat received asynchronously takes effect with
+   * the next update.
+   */
+
+  memset(&state, 0, sizeof(struct vnc_hextile_s));
+  state.session       = session;
+  state.bytesperpixel = (session->bpp + 7) >> 3;
+  state.bigendian     = session->bigendian;
+
+  switch (session->colorfmt)
+    {
+      case FB_FMT_RGB8_222:
+        state.convert.bpp8 = vnc_convert_rgb8_222;
+        break;
+
+      case FB_FMT_RGB8_332:
+        state.convert.bpp8 = vnc_convert_rgb8_332;
+        break;
+
+      case FB_FMT_RGB16_555:
+        state.convert.bpp16 = vnc_convert_rgb16_555;
+        break;
+
+      case FB_FMT_RGB16_565:
+        state.convert.bpp16 = vnc_convert_rgb16_565;
+        break;
+
+      case FB_FMT_RGB32:
+        state.convert.bpp32 = vnc_convert_rgb32_888;
+        break;
+
+      default:
+        gerr("ERROR: Unrecognized color format: %d\n", session->colorfmt);
+        return -EINVAL;
+    }
+
+  /* The update buffer must be able to hold the header and at least one
+   * worst case tile.
+   */
+
+  maxtile = HEXTILE_MAXTILE(state.bytesperpixel);
+  size    = SIZEOF_RFB_FRAMEBUFFERUPDATE_S(SIZEOF_RFB_RECTANGE_S(0));
+
+  if (size + maxtile > VNCSERVER_UPDATE_BUFSIZE)
+    {
+      return 0;
+    }
+
+  /* Format the FrameBuffer Update with a single Hextile encoded
+   * rectangle.
+   */
+
+  DEBUGASSERT(rect->pt1.x <= rect->pt2.x && rect->pt1.y <= rect->pt2.y);
+
+  update          = (FAR struct rfb_framebufferupdate_s *)session->outbuf;
+  update->msgtype = RFB_FBUPDATE_MSG;
+  update->padding = 0;
+  rfb_putbe16(update->nrect, 1);
+
+  rfb_putbe16(update->rect[0].xpos, rect->pt1.x);
+  rfb_putbe16(update->rect[0].ypos, rect->pt1.y);
+  rfb_putbe16(update->rect[0].width, rect->pt2.x - rect->pt1.x + 1);
+  rfb_putbe16(update->rect[0].height, rect->pt2.y - rect->pt1.y + 1);
+  rfb_putbe32(update->rect[0].encoding, RFB_ENCODING_HEXTILE);
+
+  /* Encode the tiles left-to-right, top-to-bottom, sending the buffer
+   * whenever it cannot hold another tile.
+   */
+
+  total = 0;
+
+  for (y = rect->pt1.y; y <= rect->pt2.y; y += RFB_TILESIZE)
+    {
+      height = MIN(rect->pt2.y - y + 1, RFB_TILESIZE);
+
+      for (x = rect->pt1.x; x <= rect->pt2.x; x += RFB_TILESIZE)
+        {
+          width = MIN(rect->pt2.x - x + 1, RFB_TILESIZE);
+
+          if (size + maxtile > VNCSERVER_UPDATE_BUFSIZE)
+            {
+              ret = vnc_hextile_flush(session, size);
+              if (ret < 0)
+                {
+                  return ret;
+                }
+
+              total += size;
+              size   = 0;
+            }
+
+          size += vnc_hextile_tile(&state, &session->outbuf[size],
+                                   y, x, height, width);
+        }
+    }
+
+  ret = vnc_hextile_flush(session, size);
+  if (ret < 0)
+    {
+      return ret;
+    }
+
+  updinfo("Sent {(%d, %d),(%d, %d)}\n",
+          rect->pt1.x, rect->pt1.y, rect->pt2.x, rect->pt2.y);
+  return (int)(total + size);
+}
@@ -529,6 +529,9 @@ int vnc_client_pixelformat(FAR struct vnc_session_s *session,
       return -ENOSYS;
     }
 
+  /* Content already sent in the old format must be re-sent */
+
+  vnc_invalidate_tiles(session, NULL);
   session->change = true;
   return OK;
 }
@@ -301,6 +301,15 @@ int vnc_receiver(FAR struct vnc_session_s *session)
                   rect.pt2.x = rect.pt1.x + rfb_getbe16(update->width);
                   rect.pt2.y = rect.pt1.y + rfb_getbe16(update->height);
 
+                  /* A non-incremental request means that the client wants
+                   * the full content of the region, changed or not.
+                   */
+
+                  if (!update->incremental)
+                    {
+                      vnc_invalidate_tiles(session, &rect);
+                    }
+
                   ret = vnc_update_rectangle(session, &rect, false);
                   if (ret < 0)
                     {
@@ -470,6 +479,9 @@ int vnc_client_encodings(FAR struct vnc_session_s *session,
   /* Assume that there are no common encodings (other than RAW) */
 
   session->rre = false;
+#ifdef CONFIG_VNCSERVER_HEXTILE
+  session->hextile = false;
+#endif
 
   /* Loop for each client supported encoding */
 
@@ -486,6 +498,12 @@ int vnc_client_encodings(FAR struct vnc_session_s *session,
         {
           session->rre = true;
         }
+#ifdef CONFIG_VNCSERVER_HEXTILE
+      else if (encoding == RFB_ENCODING_HEXTILE)
+        {
+          session->hextile = true;
+        }
+#endif
     }
 
   session->change = true;
@@ -166,6 +166,18 @@
 #define RFB_STRIDE          (RFB_BYTESPERPIXEL * CONFIG_VNCSERVER_SCREENWIDTH)
 #define RFB_SIZE            (RFB_STRIDE * CONFIG_VNCSERVER_SCREENHEIGHT)
 
+/* The local framebuffer is divided into 16x16 tiles (the Hextile tile size)
+ * for change detection.
+ */
+
+#define RFB_TILESHIFT       4
+#define RFB_TILESIZE        (1 << RFB_TILESHIFT)
+#define RFB_HTILES \
+  ((CONFIG_VNCSERVER_SCREENWIDTH + RFB_TILESIZE - 1) >> RFB_TILESHIFT)
+#define RFB_VTILES \
+  ((CONFIG_VNCSERVER_SCREENHEIGHT + RFB_TILESIZE - 1) >> RFB_TILESHIFT)
+#define RFB_NTILES          (RFB_HTILES * RFB_VTILES)
+
 /* RFB Port Number */
 
 #define RFB_PORT_BASE       5900
@@ -251,6 +263,9 @@ struct vnc_session_s
   volatile uint8_t bpp;        /* Remote bits per pixel */
   volatile bool bigendian;     /* True: Remote expect data in big-endian format */
   volatile bool rre;           /* True: Remote supports RRE encoding */
+#ifdef CONFIG_VNCSERVER_HEXTILE
+  volatile bool hextile;       /* True: Remote supports Hextile encoding */
+#endif
   FAR uint8_t *fb;             /* Allocated local frame buffer */
 
   /* VNC client input support */
@@ -271,6 +286,14 @@ struct vnc_session_s
   sem_t freesem;
   sem_t queuesem;
 
+#ifdef CONFIG_VNCSERVER_TILEHASH
+  /* Hash of each local framebuffer tile as last sent to the client.  Zero
+   * means that the tile content is not known to the client.
+   */
+
+  uint32_t tilehash[RFB_NTILES];
+#endif
+
   /* I/O buffers for misc network send/receive */
 
   uint8_t inbuf[CONFIG_VNCSERVER_INBUFFER_SIZE];
@@ -459,6 +482,32 @@ int vnc_update_rectangle(FAR struct vnc_session_s *session,
                          FAR const struct nxgl_rect_s *rect,
                          bool change);
 
+/****************************************************************************
+ * Name: vnc_invalidate_tiles
+ *
+ * Description:
+ *  Forget the hashes of all tiles that intersect the rectangle so that the
+ *  next update of that region is sent in full.  This is necessary when the
+ *  client no longer has valid content for the region, for example, when it
+ *  sends a non-incremental FramebufferUpdateRequest.
+ *
+ * Input Parameters:
+ *   session - An instance of the session structure.
+ *   rect    - The rectanglular region to be invalidated.  NULL invalidates
+ *             the whole display.
+ *
+ * Returned Value:
+ *   None
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_VNCSERVER_TILEHASH
+void vnc_invalidate_tiles(FAR struct vnc_session_s *session,
+                          FAR const struct nxgl_rect_s *rect);
+#else
+#  define vnc_invalidate_tiles(s,r)
+#endif
+
 /****************************************************************************
  * Name: vnc_receiver
  *
@@ -498,6 +547,32 @@ int vnc_receiver(FAR struct vnc_session_s *session);
 
 int vnc_rre(FAR struct vnc_session_s *session, FAR struct nxgl_rect_s *rect);
 
+/****************************************************************************
+ * Name: vnc_hextile
+ *
+ * Description:
+ *  Send the framebuffer update using the Hextile encoding.  Each 16x16
+ *  tile is sent as a background color, a background color with
+ *  sub-rectangles, or as raw pixel data, whichever is the smallest.
+ *
+ * Input Parameters:
+ *   session - An instance of the session structure.
+ *   rect  - Describes the rectangle in the local framebuffer.
+ *
+ * Returned Value:
+ *   Zero is returned if Hextile coding was not performed (but no error was
+ *   encountered).  Otherwise, the size of the framebuffer update message
+ *   is returned on success or a negated errno value is returned on failure
+ *   that indicates the nature of the failure.  A failure is only
+ *   returned in cases of a network failure and unexpected internal failures.
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_VNCSERVER_HEXTILE
+int vnc_hextile(FAR struct vnc_session_s *session,
+                FAR struct nxgl_rect_s *rect);
+#endif
+
 /****************************************************************************
  * Name: vnc_raw
  *
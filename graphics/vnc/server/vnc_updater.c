@@ -343,6 +343,188 @@ static void vnc_add_queue(FAR struct vnc_session_s *session,
   sched_unlock();
 }
 
+/****************************************************************************
+ * Name: vnc_send_rectangle
+ *
+ * Description:
+ *  Send one rectangular region of the local framebuffer to the client using
+ *  the most compact encoding that the client supports.
+ *
+ * Input Parameters:
+ *   session - A reference to the VNC session structure.
+ *   rect    - The rectangle to be sent.
+ *
+ * Returned Value:
+ *   A non-negative value on success; a negated errno value is returned on
+ *   any failure.
+ *
+ ****************************************************************************/
+
+static int vnc_send_rectangle(FAR struct vnc_session_s *session,
+                              FAR struct nxgl_rect_s *rect)
+{
+  int ret;
+
+  /* Attempt to use RRE encoding */
+
+  ret = vnc_rre(session, rect);
+
+#ifdef CONFIG_VNCSERVER_HEXTILE
+  if (ret == 0)
+    {
+      /* Then Hextile encoding */
+
+      ret = vnc_hextile(session, rect);
+    }
+#endif
+
+  if (ret == 0)
+    {
+      /* Perform the framebuffer update using the default RAW encoding */
+
+      ret = vnc_raw(session, rect);
+    }
+
+  return ret;
+}
+
+/****************************************************************************
+ * Name: vnc_tile_hash
+ *
+ * Description:
+ *  Calculate the FNV-1a hash of one tile of the local framebuffer.
+ *
+ * Input Parameters:
+ *   session - A reference to the VNC session structure.
+ *   tile    - The rectangle covered by the tile.
+ *
+ * Returned Value:
+ *   The non-zero hash value.
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_VNCSERVER_TILEHASH
+static uint32_t vnc_tile_hash(FAR struct vnc_session_s *session,
+                              FAR const struct nxgl_rect_s *tile)
+{
+  FAR const lfb_color_t *src;
+  nxgl_coord_t x;
+  nxgl_coord_t y;
+  uint32_t hash = 2166136261u;
+
+  for (y = tile->pt1.y; y <= tile->pt2.y; y++)
+    {
+      src = (FAR const lfb_color_t *)
+        (session->fb + RFB_STRIDE * y + RFB_BYTESPERPIXEL * tile->pt1.x);
+
+      for (x = tile->pt1.x; x <= tile->pt2.x; x++)
+        {
+          hash = (hash ^ *src++) * 16777619u;
+        }
+    }
+
+  /* Zero is reserved to mark tiles unknown to the client */
+
+  return hash != 0 ? hash : 1;
+}
+#endif
+
+/****************************************************************************
+ * Name: vnc_send_changes
+ *
+ * Description:
+ *  Send only those tiles of the rectangle whose content differs from what
+ *  was last sent to the client.  Each horizontal run of changed tiles is
+ *  sent as one rectangle.  Changed tiles are always sent whole, even when
+ *  the rectangle only partially overlaps them, because the hash recorded
+ *  for the tile covers all of its content.
+ *
+ * Input Parameters:
+ *   session - A reference to the VNC session structure.
+ *   rect    - The rectangle to be updated.
+ *
+ * Returned Value:
+ *   A non-negative value on success; a negated errno value is returned on
+ *   any failure.
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_VNCSERVER_TILEHASH
+static int vnc_send_changes(FAR struct vnc_session_s *session,
+                            FAR const struct nxgl_rect_s *rect)
+{
+  struct nxgl_rect_s tile;
+  struct nxgl_rect_s run;
+  FAR uint32_t *tilehash;
+  uint32_t hash;
+  bool inrun;
+  int col;
+  int row;
+  int ret;
+
+  for (row = rect->pt1.y >> RFB_TILESHIFT;
+       row <= rect->pt2.y >> RFB_TILESHIFT;
+       row++)
+    {
+      tile.pt1.y = row << RFB_TILESHIFT;
+      tile.pt2.y = MIN(tile.pt1.y + RFB_TILESIZE,
+                       CONFIG_VNCSERVER_SCREENHEIGHT) - 1;
+      inrun      = false;
+
+      for (col = rect->pt1.x >> RFB_TILESHIFT;
+           col <= rect->pt2.x >> RFB_TILESHIFT;
+           col++)
+        {
+          tile.pt1.x = col << RFB_TILESHIFT;
+          tile.pt2.x = MIN(tile.pt1.x + RFB_TILESIZE,
+                           CONFIG_VNCSERVER_SCREENWIDTH) - 1;
+
+          tilehash   = &session->tilehash[row * RFB_HTILES + col];
+          hash       = vnc_tile_hash(session, &tile);
+
+          if (hash != *tilehash)
+            {
+              /* Changed.. start or extend the run of changed tiles */
+
+              *tilehash = hash;
+              if (!inrun)
+                {
+                  nxgl_rectcopy(&run, &tile);
+                  inrun = true;
+                }
+              else
+                {
+                  run.pt2.x = tile.pt2.x;
+                }
+            }
+          else if (inrun)
+            {
+              /* Unchanged.. send the run that just ended */
+
+              ret = vnc_send_rectangle(session, &run);
+              if (ret < 0)
+                {
+                  return ret;
+                }
+
+              inrun = false;
+            }
+        }
+
+      if (inrun)
+        {
+          ret = vnc_send_rectangle(session, &run);
+          if (ret < 0)
+            {
+              return ret;
+            }
+        }
+    }
+
+  return OK;
+}
+#endif
+
 /****************************************************************************
  * Name: vnc_updater
  *
@@ -386,15 +568,13 @@ static FAR void *vnc_updater(FAR void *arg)
               srcrect->rect.pt1.x, srcrect->rect.pt1.y,
               srcrect->rect.pt2.x, srcrect->rect.pt2.y);
 
-      /* Attempt to use RRE encoding */
-
-      ret = vnc_rre(session, &srcrect->rect);
-      if (ret == 0)
-        {
-          /* Perform the framebuffer update using the default RAW encoding */
+      /* Send the rectangle, or just the parts of it that changed */
 
-          ret = vnc_raw(session, &srcrect->rect);
-        }
+#ifdef CONFIG_VNCSERVER_TILEHASH
+      ret = vnc_send_changes(session, &srcrect->rect);
+#else
+      ret = vnc_send_rectangle(session, &srcrect->rect);
+#endif
 
       /* Release the update structure */
 
@@ -629,3 +809,54 @@ int vnc_update_rectangle(FAR struct vnc_session_s *session,
 
   return OK;
 }
+
+/****************************************************************************
+ * Name: vnc_invalidate_tiles
+ *
+ * Description:
+ *  Forget the hashes of all tiles that intersect the rectangle so that the
+ *  next update of that region is sent in full.
+ *
+ * Input Parameters:
+ *   session - An instance of the session structure.
+ *   rect    - The rectanglular region to be invalidated.  NULL invalidates
+ *             the whole display.
+ *
+ * Returned Value:
+ *   None
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_VNCSERVER_TILEHASH
+void vnc_invalidate_tiles(FAR struct vnc_session_s *session,
+                          FAR const struct nxgl_rect_s *rect)
+{
+  struct nxgl_rect_s intersection;
+  int col;
+  int row;
+
+  if (rect == NULL)
+    {
+      memset(session->tilehash, 0, sizeof(session->tilehash));
+      return;
+    }
+
+  nxgl_rectintersect(&intersection, rect, &g_wholescreen);
+  if (nxgl_nullrect(&intersection))
+    {
+      return;
+    }
+
+  for (row = intersection.pt1.y >> RFB_TILESHIFT;
+       row <= intersection.pt2.y >> RFB_TILESHIFT;
+       row++)
+    {
+      for (col = intersection.pt1.x >> RFB_TILESHIFT;
+           col <= intersection.pt2.x >> RFB_TILESHIFT;
+           col++)
+        {
+          session->tilehash[row * RFB_HTILES + col] = 0;
+        }
+    }
+}
+#endif
@@ -372,6 +372,155 @@ struct foc_data_s
   float vab_mod_scale;       /* Voltage alpha-beta modulation scale */
 };
 
+/* Fixed point PI controller.
+ *
+ * The error and the output are q15.  The gains are q15 values scaled by
+ * 2^-shift, i.e. the real gain is kp * 2^shift / 32768.  The integral part
+ * is kept with the full product precision.
+ */
+
+struct pi_q15_s
+{
+  int32_t integ;               /* Integral part, q30 scaled by 2^-shift */
+  int16_t kp;                  /* Proportional gain */
+  int16_t ki;                  /* Integral gain */
+  int16_t min;                 /* Output lower limit */
+  int16_t max;                 /* Output upper limit */
+  uint8_t shift;               /* Gain scaling */
+};
+
+/* Fixed point FOC data.
+ *
+ * Currents are q15 fractions of the full scale current and voltages are
+ * q15 fractions of the base (DC bus) voltage, so the inverse Park output
+ * is already the modulation voltage.  The whole pipeline from phase
+ * currents to duty cycles runs in one call, foc_q15_process().
+ */
+
+struct foc_q15_s
+{
+  struct pi_q15_s id_pi;       /* d-axis current PI controller */
+  struct pi_q15_s iq_pi;       /* q-axis current PI controller */
+  int16_t i_alpha;             /* Current in alpha-beta frame */
+  int16_t i_beta;
+  int16_t i_d;                 /* Current in dq frame */
+  int16_t i_q;
+  int16_t i_d_ref;             /* Current dq reference */
+  int16_t i_q_ref;
+  int16_t v_d;                 /* Voltage in dq frame */
+  int16_t v_q;
+  int16_t v_alpha;             /* Modulation voltage in alpha-beta frame */
+  int16_t v_beta;
+  int16_t vdq_max;             /* Maximum dq voltage magnitude */
+  int16_t d_min;               /* Duty cycle min */
+  int16_t d_max;               /* Duty cycle max */
+  int16_t duty[3];             /* Duty cycles for phases U, V and W */
+  uint8_t sector;              /* Current space vector sector */
+};
+
+/* FIR filters.
+ *
+ * The coefficients are stored in time-reversed order: coeffs[0] multiplies
+ * the oldest sample of the window and coeffs[ntaps-1] the newest.  The
+ * caller provides a state buffer of (ntaps + blocksize - 1) samples, where
+ * blocksize is the largest number of samples passed in one call.  q15 and
+ * q31 filters accumulate in 64 bits and saturate the output.
+ */
+
+struct fir_f32_s
+{
+  FAR const float   *coeffs;   /* Filter coefficients */
+  FAR float         *state;    /* Filter history and working buffer */
+  uint16_t          ntaps;     /* Number of filter taps */
+  uint16_t          blocksize; /* Maximum number of samples per call */
+};
+
+struct fir_q15_s
+{
+  FAR const int16_t *coeffs;   /* Filter coefficients (q15) */
+  FAR int16_t       *state;    /* Filter history and working buffer */
+  uint16_t          ntaps;     /* Number of filter taps */
+  uint16_t          blocksize; /* Maximum number of samples per call */
+};
+
+struct fir_q31_s
+{
+  FAR const int32_t *coeffs;   /* Filter coefficients (q31) */
+  FAR int32_t       *state;    /* Filter history and working buffer */
+  uint16_t          ntaps;     /* Number of filter taps */
+  uint16_t          blocksize; /* Maximum number of samples per call */
+};
+
+/* Cascades of biquad IIR sections.
+ *
+ * Each section has five coefficients {b0, b1, b2, a1, a2} and computes
+ *   y(n) = b0*x(n) + b1*x(n-1) + b2*x(n-2) - a1*y(n-1) - a2*y(n-2)
+ *
+ * The float cascade uses the transposed direct form II and needs two
+ * state values per section.  The fixed point cascades use direct form I
+ * with four state values per section.  Their coefficients are stored
+ * divided by 2^postshift so that a1 (up to 2.0) fits the q format; the
+ * shift is applied back to the accumulator.
+ */
+
+struct biquad_f32_s
+{
+  FAR const float   *coeffs;   /* 5 coefficients per section */
+  FAR float         *state;    /* 2 state values per section */
+  uint8_t           nstages;   /* Number of sections */
+};
+
+struct biquad_q15_s
+{
+  FAR const int16_t *coeffs;   /* 5 coefficients per section (q15) */
+  FAR int16_t       *state;    /* 4 state values per section */
+  uint8_t           nstages;   /* Number of sections */
+  uint8_t           postshift; /* Coefficient scaling */
+};
+
+struct biquad_q31_s
+{
+  FAR const int32_t *coeffs;   /* 5 coefficients per section (q31) */
+  FAR int32_t       *state;    /* 4 state values per section */
+  uint8_t           nstages;   /* Number of sections */
+  uint8_t           postshift; /* Coefficient scaling */
+};
+
+/* Real FFT of n points (a power of two, at least 4), computed in place
+ * as a complex FFT of n/2 points followed by a split step.  The caller
+ * provides a twiddle table of n values that is filled by the init
+ * function.
+ *
+ * The result holds bins 0..n/2 as n values: buf[0] is the DC term,
+ * buf[1] the (real) Nyquist term, and buf[2k], buf[2k+1] are the real and
+ * imaginary parts of bin k.  The q15 transform scales its result by 1/n
+ * to avoid overflow.
+ */
+
+struct rfft_f32_s
+{
+  FAR float         *twiddle;  /* n/2 complex twiddle factors */
+  uint16_t          n;         /* Transform length */
+};
+
+struct rfft_q15_s
+{
+  FAR int16_t       *twiddle;  /* n/2 complex twiddle factors (q15) */
+  uint16_t          n;         /* Transform length */
+};
+
+/* Window functions.  The windows are periodic, as used for spectral
+ * analysis.
+ */
+
+enum window_type_e
+{
+  WINDOW_RECT = 0,             /* Rectangular (no window) */
+  WINDOW_HANN,                 /* Hann */
+  WINDOW_HAMMING,              /* Hamming */
+  WINDOW_BLACKMAN              /* Blackman */
+};
+
 /****************************************************************************
  * Public Functions
  ****************************************************************************/
@@ -489,6 +638,73 @@ void motor_phy_params_init(FAR struct motor_phy_params_s *phy, uint8_t poles,
 void motor_phy_params_temp_set(FAR struct motor_phy_params_s *phy,
                                float res_alpha, float res_temp_ref);
 
+/* Fixed point FOC */
+
+void sin_cos_q15(uint16_t angle, FAR int16_t *psin, FAR int16_t *pcos);
+
+void pi_q15_init(FAR struct pi_q15_s *pi, int16_t kp, int16_t ki,
+                 uint8_t shift);
+void pi_q15_saturation_set(FAR struct pi_q15_s *pi, int16_t min,
+                           int16_t max);
+void pi_q15_reset(FAR struct pi_q15_s *pi);
+int16_t pi_q15(FAR struct pi_q15_s *pi, int16_t err);
+
+void foc_q15_init(FAR struct foc_q15_s *foc, int16_t id_kp, int16_t id_ki,
+                  int16_t iq_kp, int16_t iq_ki, uint8_t shift);
+void foc_q15_vdq_max_set(FAR struct foc_q15_s *foc, int16_t max);
+void foc_q15_duty_set(FAR struct foc_q15_s *foc, int16_t min, int16_t max);
+void foc_q15_idq_ref_set(FAR struct foc_q15_s *foc, int16_t d, int16_t q);
+void foc_q15_process(FAR struct foc_q15_s *foc, int16_t i_a, int16_t i_b,
+                     int16_t angle_sin, int16_t angle_cos);
+
+/* FIR filters */
+
+void fir_f32_init(FAR struct fir_f32_s *fir, FAR const float *coeffs,
+                  FAR float *state, uint16_t ntaps, uint16_t blocksize);
+void fir_f32(FAR struct fir_f32_s *fir, FAR const float *in,
+             FAR float *out, uint16_t nsamples);
+void fir_q15_init(FAR struct fir_q15_s *fir, FAR const int16_t *coeffs,
+                  FAR int16_t *state, uint16_t ntaps, uint16_t blocksize);
+void fir_q15(FAR struct fir_q15_s *fir, FAR const int16_t *in,
+             FAR int16_t *out, uint16_t nsamples);
+void fir_q31_init(FAR struct fir_q31_s *fir, FAR const int32_t *coeffs,
+                  FAR int32_t *state, uint16_t ntaps, uint16_t blocksize);
+void fir_q31(FAR struct fir_q31_s *fir, FAR const int32_t *in,
+             FAR int32_t *out, uint16_t nsamples);
+
+/* Biquad IIR cascades */
+
+void biquad_f32_init(FAR struct biquad_f32_s *bq, uint8_t nstages,
+                     FAR const float *coeffs, FAR float *state);
+void biquad_f32(FAR struct biquad_f32_s *bq, FAR const float *in,
+                FAR float *out, uint16_t nsamples);
+void biquad_q15_init(FAR struct biquad_q15_s *bq, uint8_t nstages,
+                     FAR const int16_t *coeffs, FAR int16_t *state,
+                     uint8_t postshift);
+void biquad_q15(FAR struct biquad_q15_s *bq, FAR const int16_t *in,
+                FAR int16_t *out, uint16_t nsamples);
+void biquad_q31_init(FAR struct biquad_q31_s *bq, uint8_t nstages,
+                     FAR const int32_t *coeffs, FAR int32_t *state,
+                     uint8_t postshift);
+void biquad_q31(FAR struct biquad_q31_s *bq, FAR const int32_t *in,
+                FAR int32_t *out, uint16_t nsamples);
+
+/* Real FFT */
+
+int rfft_f32_init(FAR struct rfft_f32_s *fft, FAR float *twiddle,
+                  uint16_t n);
+void rfft_f32(FAR const struct rfft_f32_s *fft, FAR float *buf);
+int rfft_q15_init(FAR struct rfft_q15_s *fft, FAR int16_t *twiddle,
+                  uint16_t n);
+void rfft_q15(FAR const struct rfft_q15_s *fft, FAR int16_t *buf);
+
+/* Window functions */
+
+void window_init_f32(FAR float *w, uint16_t n, enum window_type_e type);
+void window_init_q15(FAR int16_t *w, uint16_t n, enum window_type_e type);
+void window_apply_f32(FAR const float *w, FAR float *buf, uint16_t n);
+void window_apply_q15(FAR const int16_t *w, FAR int16_t *buf, uint16_t n);
+
 #undef EXTERN
 #if defined(__cplusplus)
 }
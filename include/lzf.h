@@ -31,6 +31,15 @@
 #ifndef __INCLUDE_LZF_H
 #define __INCLUDE_LZF_H 1
 
+/****************************************************************************
+ * Included Files
+ ****************************************************************************/
+
+#include <nuttx/config.h>
+
+#include <sys/types.h>
+#include <stdint.h>
+
 /****************************************************************************
  * Pre-processor Definitions
  ****************************************************************************/
@@ -76,7 +85,10 @@ struct lzf_type1_header_s   /* Compressed data header */
 
 /* LZF hash table */
 
-#if LZF_USE_OFFSETS
+#if defined(CONFIG_LIBC_LZF_OFFSETS)
+# define LZF_HSLOT_BIAS ((const uint8_t *)in_data)
+  typedef uint16_t lzf_hslot_t;
+#elif LZF_USE_OFFSETS
 # define LZF_HSLOT_BIAS ((const uint8_t *)in_data)
   typedef unsigned int lzf_hslot_t;
 #else
@@ -86,6 +98,33 @@ struct lzf_type1_header_s   /* Compressed data header */
 
 typedef lzf_hslot_t lzf_state_t[1 << HLOG];
 
+/* Streaming compressor.  Data written to the stream is gathered into
+ * blocks of up to 'blocksize' bytes.  Each block is compressed into one
+ * self-contained ZV block (or stored, if it does not compress) and passed
+ * to the output callback, so the result can be read back with
+ * lzf_decompress() one block at a time.  The hash table is reused for
+ * every block.
+ */
+
+typedef CODE int (*lzf_output_t)(FAR void *arg, FAR const void *buf,
+                                 size_t len);
+
+struct lzf_stream_s
+{
+  lzf_state_t htab;            /* Hash table reused for every block */
+  lzf_output_t output;         /* Receives each finished block */
+  FAR void *arg;               /* Argument passed to output */
+  FAR uint8_t *inbuf;          /* Input block, after the header space */
+  FAR uint8_t *outbuf;         /* Output block, after the header space */
+  uint16_t blocksize;          /* Maximum uncompressed block size */
+  uint16_t nbuffered;          /* Bytes gathered in inbuf */
+};
+
+/* Sizes of the buffers that must be provided to lzf_stream_init() */
+
+#define LZF_STREAM_INBUF_SIZE(bs)  (LZF_TYPE0_HDR_SIZE + (bs))
+#define LZF_STREAM_OUTBUF_SIZE(bs) (LZF_TYPE1_HDR_SIZE + (bs))
+
 /****************************************************************************
  * Public Function Prototypes
  ****************************************************************************/
@@ -150,4 +189,51 @@ unsigned int lzf_decompress(FAR const void *const in_data,
                             unsigned int in_len, FAR void *out_data,
                             unsigned int out_len);
 
+/****************************************************************************
+ * Name: lzf_stream_init
+ *
+ * Description:
+ *   Initialize a streaming compressor.  inbuf and outbuf must hold
+ *   LZF_STREAM_INBUF_SIZE(blocksize) and LZF_STREAM_OUTBUF_SIZE(blocksize)
+ *   bytes.  blocksize may be at most 65535, the limit of the block header.
+ *
+ * Returned Value:
+ *   Zero (OK) on success; a negated errno value on failure.
+ *
+ ****************************************************************************/
+
+int lzf_stream_init(FAR struct lzf_stream_s *stream, FAR void *inbuf,
+                    FAR void *outbuf, size_t blocksize,
+                    lzf_output_t output, FAR void *arg);
+
+/****************************************************************************
+ * Name: lzf_stream_write
+ *
+ * Description:
+ *   Add len bytes to the stream, compressing and emitting each block that
+ *   fills up.
+ *
+ * Returned Value:
+ *   The number of bytes consumed, which is len on success; a negated errno
+ *   value if the output callback failed before any byte was consumed.
+ *
+ ****************************************************************************/
+
+ssize_t lzf_stream_write(FAR struct lzf_stream_s *stream,
+                         FAR const void *data, size_t len);
+
+/****************************************************************************
+ * Name: lzf_stream_flush
+ *
+ * Description:
+ *   Compress and emit any partial block.
+ *
+ * Returned Value:
+ *   Zero (OK) on success; the negated errno value returned by the output
+ *   callback on failure.
+ *
+ ****************************************************************************/
+
+int lzf_stream_flush(FAR struct lzf_stream_s *stream);
+
 #endif /* __INCLUDE_LZF_H */
@@ -69,4 +69,8 @@
 #define TCP_KEEPCNT   (__SO_PROTOCOL + 3) /* Number of keepalives before death
                                            * Argument: max retry count */
 
+/* Hold back partial segments until the option is cleared again */
+
+#define TCP_CORK      (__SO_PROTOCOL + 4) /* Argument: int, 0 or 1 */
+
 #endif /* __INCLUDE_NETINET_TCP_H */
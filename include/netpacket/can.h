@@ -0,0 +1,117 @@
+/****************************************************************************
+ * include/netpacket/can.h
+ *
+ *   Copyright (C) 2020 Gregory Nutt. All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in
+ *    the documentation and/or other materials provided with the
+ *    distribution.
+ * 3. Neither the name NuttX nor the names of its contributors may be
+ *    used to endorse or promote products derived from this software
+ *    without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+ * FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE
+ * COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+ * INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,
+ * BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS
+ * OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED
+ * AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ * LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN
+ * ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ *
+ ****************************************************************************/
+
+#ifndef __INCLUDE_NETPACKET_CAN_H
+#define __INCLUDE_NETPACKET_CAN_H  1
+
+/****************************************************************************
+ * Included Files
+ ****************************************************************************/
+
+#include <nuttx/config.h>
+#include <sys/socket.h>
+#include <stdint.h>
+
+/****************************************************************************
+ * Pre-processor Definitions
+ ****************************************************************************/
+
+/* Protocols of the PF_CAN family */
+
+#define CAN_RAW           1           /* Raw CAN frames */
+
+/* Flags in the can_id field of struct can_frame and struct can_filter */
+
+#define CAN_EFF_FLAG      0x80000000  /* Extended frame format (29-bit ID) */
+#define CAN_RTR_FLAG      0x40000000  /* Remote transmission request */
+#define CAN_ERR_FLAG      0x20000000  /* Error report */
+
+#define CAN_SFF_MASK      0x000007ff  /* Standard frame format ID bits */
+#define CAN_EFF_MASK      0x1fffffff  /* Extended frame format ID bits */
+#define CAN_ERR_MASK      0x1fffffff  /* Error report bits */
+
+/* In a filter: match the frames that do NOT match the ID under the mask */
+
+#define CAN_INV_FILTER    0x20000000
+
+#define CAN_MAX_DLEN      8
+
+/* CAN_RAW socket options at the SOL_CAN_RAW level */
+
+#define CAN_RAW_FILTER    (__SO_PROTOCOL + 0) /* Set the receive filters
+                                               * Argument: struct can_filter[] */
+#define CAN_RAW_LOOPBACK  (__SO_PROTOCOL + 1) /* Receive frames sent by other
+                                               * sockets.  Argument: int */
+
+/****************************************************************************
+ * Public Types
+ ****************************************************************************/
+
+typedef uint32_t canid_t;
+
+/* A CAN frame as read from and written to a CAN_RAW socket */
+
+struct can_frame
+{
+  canid_t  can_id;                    /* ID and CAN_*_FLAG flags */
+  uint8_t  can_dlc;                   /* Number of data bytes (0-8) */
+  uint8_t  pad[3];
+  uint8_t  data[CAN_MAX_DLEN];
+};
+
+/* A received frame matches a filter if
+ *
+ *   (received can_id & can_mask) == (can_id & can_mask)
+ *
+ * CAN_EFF_FLAG and CAN_RTR_FLAG may be included in can_mask to select the
+ * frame format.  A socket without filters receives every frame.
+ */
+
+struct can_filter
+{
+  canid_t  can_id;
+  canid_t  can_mask;
+};
+
+/* CAN socket address.  can_ifindex selects a CAN device by the order in
+ * which it was registered, starting at 1.  Zero binds to all devices.
+ */
+
+struct sockaddr_can
+{
+  sa_family_t can_family;             /* AF_CAN */
+  int16_t     can_ifindex;            /* CAN device index */
+};
+
+#endif /* __INCLUDE_NETPACKET_CAN_H */
@@ -45,12 +45,68 @@
  ****************************************************************************/
 
 #include <nuttx/config.h>
+#include <sys/socket.h>
 #include <stdint.h>
 
+/****************************************************************************
+ * Pre-processor Definitions
+ ****************************************************************************/
+
+/* Packet socket options at the SOL_PACKET level */
+
+#define PACKET_RX_RING    (__SO_PROTOCOL + 0) /* Receive frames into a ring
+                                               * Argument: struct tpacket_req */
+
+/* Values of the tp_status word at the beginning of each ring frame.  The
+ * kernel only writes frames whose status is TP_STATUS_KERNEL; the
+ * application hands a frame back by writing TP_STATUS_KERNEL to it when it
+ * is done with the data.
+ */
+
+#define TP_STATUS_KERNEL  0          /* Frame is free for the kernel */
+#define TP_STATUS_USER    (1 << 0)   /* Frame holds data for the user */
+#define TP_STATUS_COPY    (1 << 1)   /* Data was truncated to tp_snaplen */
+#define TP_STATUS_LOSING  (1 << 2)   /* Frames were dropped before this one */
+
+/* Each frame starts with a struct tpacket_hdr.  The captured data follows
+ * at offset tp_mac, which is TPACKET_HDRLEN.
+ */
+
+#define TPACKET_ALIGNMENT 16
+#define TPACKET_ALIGN(x)  (((x) + TPACKET_ALIGNMENT - 1) & \
+                           ~(TPACKET_ALIGNMENT - 1))
+#define TPACKET_HDRLEN    TPACKET_ALIGN(sizeof(struct tpacket_hdr))
+
 /****************************************************************************
  * Public Types
  ****************************************************************************/
 
+/* Header at the beginning of each PACKET_RX_RING frame */
+
+struct tpacket_hdr
+{
+  volatile uint32_t tp_status;  /* See TP_STATUS_* definitions */
+  uint32_t tp_len;              /* Length of the frame as received */
+  uint32_t tp_snaplen;          /* Number of bytes stored in the frame */
+  uint16_t tp_mac;              /* Offset to the link layer header */
+  uint16_t tp_net;              /* Offset to the network layer header */
+  uint32_t tp_sec;              /* Time of reception (CLOCK_REALTIME) */
+  uint32_t tp_usec;
+};
+
+/* Argument of PACKET_RX_RING.  There is no mmap() of kernel memory here:
+ * the application provides the ring memory, tp_frame_size * tp_frame_nr
+ * bytes at tp_addr, and must keep it valid until the ring is removed by
+ * setting a NULL tp_addr or the socket is closed.
+ */
+
+struct tpacket_req
+{
+  FAR void *tp_addr;            /* Ring memory, NULL to remove the ring */
+  uint32_t  tp_frame_size;      /* Size of each frame, TPACKET_ALIGNMENT multiple */
+  uint32_t  tp_frame_nr;        /* Number of frames in the ring */
+};
+
 struct sockaddr_ll
 {
   uint16_t sll_family;
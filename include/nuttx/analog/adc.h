@@ -79,6 +79,10 @@
 #  define CONFIG_ADC_NPOLLWAITERS 2
 #endif
 
+#if defined(CONFIG_ADC_SAMPLERING) && !defined(CONFIG_ADC_RINGSIZE)
+#  define CONFIG_ADC_RINGSIZE 1024
+#endif
+
 #define ADC_RESET(dev)         ((dev)->ad_ops->ao_reset((dev)))
 #define ADC_SETUP(dev)         ((dev)->ad_ops->ao_setup((dev)))
 #define ADC_SHUTDOWN(dev)      ((dev)->ad_ops->ao_shutdown((dev)))
@@ -106,6 +110,30 @@ struct adc_callback_s
    */
 
   CODE int (*au_receive)(FAR struct adc_dev_s *dev, uint8_t ch, int32_t data);
+
+#ifdef CONFIG_ADC_SAMPLERING
+  /* This method is called from the lower half when a block of samples is
+   * available, typically on DMA completion.  The samples are queued in the
+   * sample ring with one notification for the whole block.
+   *
+   * Input Parameters:
+   *   dev      - The ADC device structure that was previously registered by
+   *              adc_register()
+   *   chlist   - The channels of the conversion sequence
+   *   nchans   - The number of channels in chlist
+   *   data     - The samples in conversion order: sample i was converted on
+   *              channel chlist[i % nchans]
+   *   nsamples - The number of samples in data
+   *
+   * Returned Value:
+   *   Zero on success; -ENOMEM if samples were dropped because the ring was
+   *   full.
+   */
+
+  CODE int (*au_receive_block)(FAR struct adc_dev_s *dev,
+                               FAR const uint8_t *chlist, uint8_t nchans,
+                               FAR const uint16_t *data, size_t nsamples);
+#endif
 };
 
 /* This describes on ADC message */
@@ -116,6 +144,35 @@ begin_packed_struct struct adc_msg_s
   int32_t      am_data;                  /* ADC convert result (4 bytes) */
 } end_packed_struct;
 
+#ifdef CONFIG_ADC_SAMPLERING
+/* This describes one sample received by au_receive_block().  read() returns
+ * samples from the sample ring in this form.
+ */
+
+struct adc_sample_s
+{
+  uint8_t      as_channel;               /* The 8-bit ADC Channel */
+  uint8_t      as_reserved;
+  uint16_t     as_data;                  /* ADC convert result */
+};
+
+/* The sample ring.  It is allocated from user memory, so that applications
+ * can process the samples in place after mapping it with mmap().  The driver
+ * only advances ar_head and the application only advances ar_tail (read()
+ * advances ar_tail too).  One slot is always kept free, so the ring is empty
+ * when ar_head == ar_tail.
+ */
+
+struct adc_ring_s
+{
+  volatile uint32_t ar_head;             /* Producer index (driver) */
+  volatile uint32_t ar_tail;             /* Consumer index (application) */
+  uint32_t     ar_nsamples;              /* Number of sample slots */
+  volatile uint32_t ar_overrun;          /* Samples dropped, ring was full */
+  struct adc_sample_s ar_samples[];      /* Sample slots */
+};
+#endif
+
 /* This describes a FIFO of ADC messages */
 
 struct adc_fifo_s
@@ -190,6 +247,9 @@ struct adc_dev_s
   sem_t                       ad_closesem;   /* Locks out new opens while close is in progress */
   sem_t                       ad_recvsem;    /* Used to wakeup user waiting for space in ad_recv.buffer */
   struct adc_fifo_s           ad_recv;       /* Describes receive FIFO */
+#ifdef CONFIG_ADC_SAMPLERING
+  FAR struct adc_ring_s      *ad_ring;       /* Samples received in blocks */
+#endif
 
   /* The following is a list of poll structures of threads waiting for
    * driver events. The 'struct pollfd' reference for each open is also
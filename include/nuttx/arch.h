@@ -1982,6 +1982,32 @@ char up_romgetc(FAR const char *ptr);
 #  define up_romgetc(ptr) (*ptr)
 #endif
 
+/****************************************************************************
+ * Name: up_chksum
+ *
+ * Description:
+ *   Add the 16-bit, one's complement sum of the big-endian 16-bit words in
+ *   the buffer to sum.  If len is odd, the final byte is treated as the
+ *   high byte of a word padded with zero.  This is the inner loop of the
+ *   Internet checksum (see RFC1071 and net/utils/net_chksum.c) and is used
+ *   in place of the generic C loop if CONFIG_ARCH_HAVE_CHKSUM is selected.
+ *
+ *   This function must be provided via the architecture-specific logic.
+ *
+ * Input Parameters:
+ *   sum  - Partial sum carried over from a previous call (host order).
+ *   data - Beginning of the data.  No alignment is required.
+ *   len  - Length of the data in bytes.
+ *
+ * Returned Value:
+ *   The updated sum in host byte order.
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_ARCH_HAVE_CHKSUM
+uint16_t up_chksum(uint16_t sum, FAR const uint8_t *data, uint16_t len);
+#endif
+
 /****************************************************************************
  * Name: up_mdelay and up_udelay
  *
@@ -2128,6 +2154,27 @@ size_t  up_check_intstack_remain(void);
 #endif
 #endif
 
+/****************************************************************************
+ * Name: up_stackguard
+ *
+ * Description:
+ *   Move the stack overflow guard to the bottom of the stack of the thread
+ *   that is about to run.  Called by sched_resume_scheduler() on every
+ *   context switch.
+ *
+ * Input Parameters:
+ *   tcb - The TCB of the thread that is about to run.
+ *
+ * Returned Value:
+ *   None
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_ARCH_STACKGUARD
+struct tcb_s;
+void up_stackguard(FAR struct tcb_s *tcb);
+#endif
+
 /****************************************************************************
  * Name: up_rtc_initialize
  *
@@ -2403,11 +2450,33 @@ void arch_sporadic_resume(FAR struct tcb_s *tcb);
  *   units.
  ********************************************************************************/
 
-#ifdef CONFIG_SCHED_CRITMONITOR
+#if defined(CONFIG_SCHED_CRITMONITOR) || defined(CONFIG_SCHED_LATENCY) || \
+    defined(CONFIG_SCHED_IRQMONITOR_TIMING) || \
+    defined(CONFIG_SCHED_CPULOAD_CYCLES)
 uint32_t up_critmon_gettime(void);
 void up_critmon_convert(uint32_t elapsed, FAR struct timespec *ts);
 #endif
 
+/********************************************************************************
+ * Name: up_profile_pc and up_profile_text
+ *
+ * Description:
+ *   Support for the sampling profiler (CONFIG_SCHED_PROFILE).  The first
+ *   interface is called from an interrupt handler and returns the program
+ *   counter of the context that the interrupt preempted.  If the return
+ *   address (link register) of that context is available, it is returned in
+ *   caller; otherwise caller is left unchanged.
+ *
+ *   The second interface returns the address range of the code section
+ *   covered by the profile histograms.
+ *
+ ********************************************************************************/
+
+#ifdef CONFIG_SCHED_PROFILE
+uintptr_t up_profile_pc(FAR uintptr_t *caller);
+void up_profile_text(FAR uintptr_t *start, FAR uintptr_t *end);
+#endif
+
 #undef EXTERN
 #if defined(__cplusplus)
 }
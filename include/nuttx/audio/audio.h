@@ -105,6 +105,40 @@
  * AUDIOIOC_STOP - Stop Audio streaming
  *
  *   ioctl argument:  None
+ *
+ * The following are available with CONFIG_AUDIO_LOWLATENCY.  They replace
+ * the per-buffer ALLOCBUFFER/ENQUEUEBUFFER/message queue protocol with one
+ * ring of equally sized periods that is shared between the application and
+ * the lower half driver.  The ring may be mapped with mmap().  A period is
+ * owned either by the application or by the lower half; periods are handed
+ * to the lower half in ring order and come back in the same order.  poll()
+ * reports POLLIN and POLLOUT while the application owns at least one
+ * period.
+ *
+ * AUDIOIOC_ALLOCRING - Allocate the period ring.  All periods are initially
+ *                    owned by the application.
+ *
+ *   ioctl argument:  Pointer to the audio_ring_desc_s structure that gives
+ *                    the number and size of the periods and receives the
+ *                    address of the ring.
+ *
+ * AUDIOIOC_FREERING - Free the period ring.  No period may be owned by the
+ *                    lower half.
+ *
+ *   ioctl argument:  None
+ *
+ * AUDIOIOC_COMMITRING - Hand the next periods (filled with samples for
+ *                    playback, empty for capture) to the lower half.
+ *
+ *   ioctl argument:  The number of periods
+ *
+ * AUDIOIOC_GETPOSITION - Get the hardware position in the ring.
+ *
+ *   ioctl argument:  Pointer to the audio_position_s structure to receive
+ *                    the position.  Lower half drivers may also handle
+ *                    this command: the argument is then a pointer to an
+ *                    apb_samp_t that receives the number of bytes of the
+ *                    oldest enqueued buffer already processed by hardware.
  */
 
 #define AUDIOIOC_GETCAPS            _AUDIOIOC(1)
@@ -124,6 +158,10 @@
 #define AUDIOIOC_UNREGISTERMQ       _AUDIOIOC(15)
 #define AUDIOIOC_HWRESET            _AUDIOIOC(16)
 #define AUDIOIOC_SETBUFFERINFO      _AUDIOIOC(17)
+#define AUDIOIOC_ALLOCRING          _AUDIOIOC(18)
+#define AUDIOIOC_FREERING           _AUDIOIOC(19)
+#define AUDIOIOC_COMMITRING         _AUDIOIOC(20)
+#define AUDIOIOC_GETPOSITION        _AUDIOIOC(21)
 
 /* Audio Device Types *******************************************************/
 /* The NuttX audio interface support different types of audio devices for
@@ -470,6 +508,31 @@ struct audio_buf_desc_s
   } u;
 };
 
+/* Structure for allocating the low-latency period ring via the
+ * AUDIOIOC_ALLOCRING ioctl.
+ */
+
+#ifdef CONFIG_AUDIO_LOWLATENCY
+struct audio_ring_desc_s
+{
+#ifdef CONFIG_AUDIO_MULTI_SESSION
+  FAR void            *session;           /* Associated channel */
+#endif
+  uint16_t            nperiods;           /* Number of periods in the ring */
+  apb_samp_t          periodbytes;        /* Size of each period in bytes */
+  FAR uint8_t         *base;              /* Returned address of the ring */
+};
+
+/* Structure returned by the AUDIOIOC_GETPOSITION ioctl */
+
+struct audio_position_s
+{
+  uint32_t            nperiods;           /* Periods completed so far */
+  uint32_t            nbytes;             /* Bytes processed by the hardware */
+  uint16_t            nqueued;            /* Periods owned by the lower half */
+};
+#endif
+
 /* Typedef for lower-level to upper-level callback for buffer dequeuing */
 
 #ifdef CONFIG_AUDIO_MULTI_SESSION
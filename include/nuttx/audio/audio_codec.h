@@ -0,0 +1,174 @@
+/****************************************************************************
+ * include/nuttx/audio/audio_codec.h
+ *
+ *   Copyright (C) 2020 Gregory Nutt. All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in
+ *    the documentation and/or other materials provided with the
+ *    distribution.
+ * 3. Neither the name NuttX nor the names of its contributors may be
+ *    used to endorse or promote products derived from this software
+ *    without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+ * FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE
+ * COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+ * INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,
+ * BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS
+ * OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED
+ * AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ * LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN
+ * ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ *
+ ****************************************************************************/
+
+#ifndef __INCLUDE_NUTTX_AUDIO_AUDIO_CODEC_H
+#define __INCLUDE_NUTTX_AUDIO_AUDIO_CODEC_H
+
+/****************************************************************************
+ * Included Files
+ ****************************************************************************/
+
+#include <nuttx/config.h>
+
+#include <sys/types.h>
+#include <stdint.h>
+#include <stdbool.h>
+
+#ifdef CONFIG_AUDIO_CODEC
+#include <nuttx/audio/audio.h>
+
+/****************************************************************************
+ * Public Types
+ ****************************************************************************/
+
+/* The format of the PCM side of a codec */
+
+struct audio_codec_pcm_s
+{
+  uint32_t samplerate;         /* Samples per second */
+  uint8_t  channels;           /* 1 = mono, 2 = stereo */
+  uint8_t  bpsamp;             /* Bits per sample */
+};
+
+/* One conversion step.  'in' and 'out' point straight into the audio
+ * pipeline buffers: the codec reads the compressed (or PCM) data where the
+ * application put it and writes its output where the lower half will play
+ * it, so no intermediate copies are made by the stage.
+ */
+
+struct audio_codec_xfer_s
+{
+  FAR const uint8_t *in;       /* Input data */
+  size_t inlen;                /* Bytes available at 'in' */
+  FAR uint8_t *out;            /* Output space */
+  size_t outlen;               /* Bytes available at 'out' */
+  bool final;                  /* No input follows 'in': drain the codec */
+
+  /* Returned by the codec */
+
+  size_t consumed;             /* Bytes of input used */
+  size_t produced;             /* Bytes of output written */
+  struct audio_codec_pcm_s pcm; /* Decoders: the format of the output */
+};
+
+struct audio_codec_s;
+
+/* The codec operations.  All of them are called on the thread of the
+ * codec stage, never from interrupt handlers, so they may block.  A codec
+ * that runs on another core (a DSP or an ASMP worker reached through ICC
+ * or rpmsg) passes the buffer addresses to the remote side in process()
+ * and waits for its reply there.
+ */
+
+struct audio_codec_ops_s
+{
+  /* Prepare for a new stream.  Encoders are given the PCM format that they
+   * will receive; decoders learn it from the stream and report it from
+   * process().
+   */
+
+  CODE int (*open)(FAR struct audio_codec_s *codec,
+                   FAR const struct audio_codec_pcm_s *pcm);
+
+  /* Convert as much input as fits into the output space.  A codec must
+   * make progress whenever it can: input that it cannot convert yet (a
+   * partial frame at the end of a buffer) is consumed and kept internally.
+   * Returning with nothing consumed and nothing produced therefore means
+   * that more input or more output space is needed, or, with 'final' set,
+   * that the codec is drained.  Returns OK or a negated errno value.
+   */
+
+  CODE int (*process)(FAR struct audio_codec_s *codec,
+                      FAR struct audio_codec_xfer_s *xfer);
+
+  /* Discard the stream state */
+
+  CODE void (*close)(FAR struct audio_codec_s *codec);
+};
+
+/* A codec plugged into a codec stage */
+
+struct audio_codec_s
+{
+  FAR const struct audio_codec_ops_s *ops;
+  uint8_t format;              /* The compressed format, AUDIO_FMT_* */
+  bool encoder;                /* True: PCM in, compressed out (capture) */
+  FAR void *priv;              /* Codec private data */
+};
+
+/****************************************************************************
+ * Public Function Prototypes
+ ****************************************************************************/
+
+#ifdef __cplusplus
+#define EXTERN extern "C"
+extern "C"
+{
+#else
+#define EXTERN extern
+#endif
+
+/****************************************************************************
+ * Name: audio_codec_initialize
+ *
+ * Description:
+ *   Put a codec stage in front of a lower half audio device.  The returned
+ *   lower half is registered with audio_register() like any other.
+ *
+ *   A decoder stage accepts buffers of compressed data, decodes them on
+ *   its own thread directly into the buffers of 'lower' and plays them.
+ *   The lower half is configured from the PCM format reported by the
+ *   decoder.  An encoder stage records PCM from 'lower' and encodes it
+ *   into the buffers that the application enqueues.
+ *
+ * Input Parameters:
+ *   lower - The lower half that plays or records PCM
+ *   codec - The codec to run.  It must stay valid while the stage exists.
+ *
+ * Returned Value:
+ *   The new lower half on success; NULL on failure.
+ *
+ ****************************************************************************/
+
+FAR struct audio_lowerhalf_s *
+  audio_codec_initialize(FAR struct audio_lowerhalf_s *lower,
+                         FAR struct audio_codec_s *codec);
+
+#undef EXTERN
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* CONFIG_AUDIO_CODEC */
+#endif /* __INCLUDE_NUTTX_AUDIO_AUDIO_CODEC_H */
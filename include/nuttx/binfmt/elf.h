@@ -114,6 +114,23 @@ struct elf_loadinfo_s
   FAR Elf32_Shdr    *shdr;       /* Buffered ELF section headers */
   uint8_t           *iobuffer;   /* File I/O buffer */
 
+  /* Execute-in-place.  If the file system can map the ELF file into
+   * memory, xipbase is the address of the mapped file and read-only
+   * sections are used in place.
+   */
+
+#ifdef CONFIG_ELF_XIP
+  FAR const uint8_t *xipbase;    /* Memory mapped ELF file, NULL if none */
+#endif
+
+  /* Read cache for small reads */
+
+#if CONFIG_ELF_READCACHE_SIZE > 0
+  FAR uint8_t       *rdcache;    /* Read cache buffer */
+  off_t              rdcachepos; /* File offset of rdcache[0] */
+  size_t             rdcachelen; /* Number of valid bytes in rdcache[] */
+#endif
+
   /* Constructors and destructors */
 
 #ifdef CONFIG_BINFMT_CONSTRUCTORS
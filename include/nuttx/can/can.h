@@ -45,6 +45,7 @@
 #include <nuttx/compiler.h>
 
 #include <sys/types.h>
+#include <sys/time.h>
 #include <stdint.h>
 #include <stdbool.h>
 
@@ -87,6 +88,10 @@
  *   support is needed for this feature.
  * CONFIG_CAN_TXREADY_HIPRI or CONFIG_CAN_TXREADY_LOPRI - Selects which work queue
  *   will be used for the can_txready() processing.
+ * CONFIG_CAN_TIMESTAMP - Add the time of reception to each received message.
+ * CONFIG_CAN_NRDFILTERS - The number of ID filters that may be attached to each
+ *   open file with CANIOC_ADD_RDFILTER.  Zero disables per-reader filtering.
+ *   Default: 0
  */
 
 /* Default configuration settings that may be overridden in the NuttX configuration
@@ -101,6 +106,10 @@
 #  define CONFIG_CAN_FIFOSIZE 255
 #endif
 
+#if !defined(CONFIG_CAN_NRDFILTERS)
+#  define CONFIG_CAN_NRDFILTERS 0
+#endif
+
 #if !defined(CONFIG_CAN_NPENDINGRTR)
 #  define CONFIG_CAN_NPENDINGRTR 4
 #elif CONFIG_CAN_NPENDINGRTR > 255
@@ -116,6 +125,26 @@
  *   Description:  Send the remote transmission request and wait for the response.
  *   Argument:     A reference to struct canioc_rtr_s
  *
+ * CANIOC_ADD_RDFILTER:
+ *   Description:    Add an ID filter to this open file.  Once a filter is added,
+ *                   only received messages that match one of the filters of the
+ *                   file are queued for it.  Other readers are not affected.
+ *                   Error reports are always queued.
+ *   Argument:       A reference to struct canioc_rdfilter_s
+ *   Returned Value: A non-negative filter ID is returned on success.
+ *                   Otherwise -1 (ERROR) is returned with the errno
+ *                   variable set to indicate the nature of the error.
+ *   Dependencies:   Requires CONFIG_CAN_NRDFILTERS > 0
+ *
+ * CANIOC_DEL_RDFILTER:
+ *   Description:    Remove an ID filter from this open file.
+ *   Argument:       The filter index previously returned by the
+ *                   CANIOC_ADD_RDFILTER command
+ *   Returned Value: Zero (OK) is returned on success.  Otherwise -1 (ERROR)
+ *                   is returned with the errno variable set to indicate the
+ *                   nature of the error.
+ *   Dependencies:   Requires CONFIG_CAN_NRDFILTERS > 0
+ *
  * Ioctl commands that may or may not be supported by the lower half CAN driver.
  *
  * CANIOC_ADD_STDFILTER:
@@ -209,9 +238,11 @@
 #define CANIOC_GET_CONNMODES      _CANIOC(8)
 #define CANIOC_SET_CONNMODES      _CANIOC(9)
 #define CANIOC_BUSOFF_RECOVERY    _CANIOC(10)
+#define CANIOC_ADD_RDFILTER       _CANIOC(11)
+#define CANIOC_DEL_RDFILTER       _CANIOC(12)
 
 #define CAN_FIRST                 0x0001         /* First common command */
-#define CAN_NCMDS                 10             /* Ten common commands */
+#define CAN_NCMDS                 12             /* Twelve common commands */
 
 /* User defined ioctl commands are also supported. These will be forwarded
  * by the upper-half CAN driver to the lower-half CAN driver via the co_ioctl()
@@ -413,6 +444,10 @@
  *               Bit 7:      Unused
  *   Bytes 5-12: CAN data    Size determined by DLC
  *
+ * If CONFIG_CAN_TIMESTAMP is selected, the header ends with the time of reception
+ * (CLOCK_MONOTONIC if enabled) as a struct timeval.  It is ignored on
+ * transmission.
+ *
  * NOTE: The error indication if valid only on message reports received from the
  * CAN driver; it is ignored on transmission.  When the error bit is set, the
  * message ID is an encoded set of error indications (see CAN_ERROR_* definitions).
@@ -436,6 +471,9 @@ begin_packed_struct struct can_hdr_s
 #endif
   uint8_t      ch_extid  : 1; /* Extended ID indication */
   uint8_t      ch_unused : 1; /* Unused */
+#ifdef CONFIG_CAN_TIMESTAMP
+  struct timeval ch_ts;       /* Time of reception */
+#endif
 } end_packed_struct;
 
 #else
@@ -448,6 +486,9 @@ begin_packed_struct struct can_hdr_s
   uint8_t      ch_error  : 1; /* 1=ch_id is an error report */
 #endif
   uint8_t      ch_unused : 2; /* Unused */
+#ifdef CONFIG_CAN_TIMESTAMP
+  struct timeval ch_ts;       /* Time of reception */
+#endif
 } end_packed_struct;
 #endif
 
@@ -557,11 +598,27 @@ struct can_ops_s
  * The common logic will initialize all semaphores.
  */
 
+#if CONFIG_CAN_NRDFILTERS > 0
+/* An ID filter attached to one reader by CANIOC_ADD_RDFILTER */
+
+struct can_rdfilter_s
+{
+  uint32_t             rf_id;            /* ID to match under rf_mask */
+  uint32_t             rf_mask;          /* Bits of the ID that must match */
+  bool                 rf_extid;         /* Match extended IDs */
+  bool                 rf_inuse;         /* This filter is assigned */
+};
+#endif
+
 struct can_reader_s
 {
   struct list_node     list;
   sem_t                read_sem;
   FAR struct file     *filep;
+#if CONFIG_CAN_NRDFILTERS > 0
+  uint8_t              nrdfilters;       /* Number of filters in use */
+  struct can_rdfilter_s rdfilters[CONFIG_CAN_NRDFILTERS];
+#endif
   struct can_rxfifo_s  fifo;             /* Describes receive FIFO */
 };
 
@@ -587,6 +644,10 @@ struct can_dev_s
   FAR void            *cd_priv;          /* Used by the arch-specific logic */
 
   FAR struct pollfd   *cd_fds[CONFIG_CAN_NPOLLWAITERS];
+#ifdef CONFIG_NET_CAN
+  FAR struct can_dev_s *cd_next;         /* Next registered CAN device */
+  int16_t              cd_ifindex;       /* CAN socket device index (1..n) */
+#endif
 };
 
 /* Structures used with ioctl calls */
@@ -598,6 +659,17 @@ struct canioc_rtr_s
   FAR struct can_msg_s *ci_msg;          /* The location to return the RTR response */
 };
 
+/* CANIOC_ADD_RDFILTER: */
+
+struct canioc_rdfilter_s
+{
+  uint32_t              rf_id;           /* 11- or 29-bit ID to match */
+  uint32_t              rf_mask;         /* Bits of the ID that must match.  A
+                                          * mask of zero matches all IDs */
+  uint8_t               rf_extid;        /* 1=Match extended IDs, 0=standard IDs.
+                                          * Ignored without CONFIG_CAN_EXTID */
+};
+
 /* CANIOC_GET_BITTIMING/CANIOC_SET_BITTIMING: */
 /* Bit time = Tquanta * (Sync_Seg + Prop_Seq + Phase_Seg1 + Phase_Seg2)
  *          = Tquanta * (TSEG1 + TSEG2 + 1)
@@ -833,6 +905,64 @@ int can_txdone(FAR struct can_dev_s *dev);
 int can_txready(FAR struct can_dev_s *dev);
 #endif
 
+/************************************************************************************
+ * Name: can_lookup
+ *
+ * Description:
+ *   Return the CAN device with the given CAN socket device index.  Devices are
+ *   numbered from 1 in the order in which they were registered.
+ *
+ * Returned Value:
+ *   The CAN device or NULL if there is no such device.
+ *
+ ************************************************************************************/
+
+#ifdef CONFIG_NET_CAN
+FAR struct can_dev_s *can_lookup(int ifindex);
+#endif
+
+/************************************************************************************
+ * Name: can_devopen and can_devclose
+ *
+ * Description:
+ *   Take or release a reference to a CAN device on behalf of a CAN socket.  The
+ *   hardware is initialized by the first reference, whether it is taken by an
+ *   open() of the character device or by a socket, and shut down when the last
+ *   reference is released.
+ *
+ * Returned Value:
+ *   OK on success; a negated errno on failure.
+ *
+ ************************************************************************************/
+
+#ifdef CONFIG_NET_CAN
+int can_devopen(FAR struct can_dev_s *dev);
+int can_devclose(FAR struct can_dev_s *dev);
+#endif
+
+/************************************************************************************
+ * Name: can_devwrite
+ *
+ * Description:
+ *   Queue CAN messages for transmission on behalf of a CAN socket.  This is the
+ *   same as a write() to the character device.
+ *
+ * Input Parameters:
+ *   dev      - The specific CAN device
+ *   buffer   - One or more struct can_msg_s
+ *   buflen   - The size of the buffer in bytes
+ *   nonblock - True: Do not wait for space in the TX FIFO
+ *
+ * Returned Value:
+ *   The number of bytes queued; a negated errno on failure.
+ *
+ ************************************************************************************/
+
+#ifdef CONFIG_NET_CAN
+ssize_t can_devwrite(FAR struct can_dev_s *dev, FAR const char *buffer,
+                     size_t buflen, bool nonblock);
+#endif
+
 #undef EXTERN
 #if defined(__cplusplus)
 }
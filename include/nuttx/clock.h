@@ -228,6 +228,19 @@ struct cpuload_s
 };
 #endif
 
+/* This structure is used to report the cycle accounting of one CPU.  The
+ * units are those of up_critmon_gettime().
+ */
+
+#ifdef CONFIG_SCHED_CPULOAD_CYCLES
+struct cpuload_cpu_s
+{
+  uint32_t total;            /* Time accounted on this CPU */
+  uint32_t idle;             /* Time spent in the IDLE thread of this CPU */
+  uint32_t irq;              /* Time spent in interrupt handlers */
+};
+#endif
+
 /* This non-standard type used to hold relative clock ticks that may take
  * negative values.  Because of its non-portable nature the type sclock_t
  * should be used only within the OS proper and not by portable applications.
@@ -239,6 +252,21 @@ typedef int64_t sclock_t;
 typedef int32_t sclock_t;
 #endif
 
+/* The time page lets clock_gettime() read the time without a system call or
+ * a critical section.  It is written by the timer interrupt and by
+ * clock_settime() and read under the sequence count: tp_seq is odd while
+ * an update is in progress and changes with every update.
+ */
+
+#ifdef CONFIG_CLOCK_TIMEPAGE
+struct clock_timepage_s
+{
+  volatile uint32_t tp_seq;            /* Sequence count */
+  struct timespec   tp_monotonic;      /* Time since power up */
+  struct timespec   tp_basetime;       /* CLOCK_REALTIME - CLOCK_MONOTONIC */
+};
+#endif
+
 /****************************************************************************
  * Public Data
  ****************************************************************************/
@@ -266,6 +294,21 @@ EXTERN volatile clock_t g_system_timer;
 #endif
 #endif
 
+/* The time page.  It lives in the user-space data so that it is readable
+ * from user space; in the PROTECTED build the kernel accesses it through
+ * the us_timepage pointer of struct userspace_s.
+ */
+
+#ifdef CONFIG_CLOCK_TIMEPAGE
+EXTERN struct clock_timepage_s g_clock_timepage;
+
+#if defined(CONFIG_BUILD_PROTECTED) && defined(__KERNEL__)
+#  define CLOCK_TIMEPAGE (USERSPACE->us_timepage)
+#else
+#  define CLOCK_TIMEPAGE (&g_clock_timepage)
+#endif
+#endif
+
 /****************************************************************************
  * Public Function Prototypes
  ****************************************************************************/
@@ -371,6 +414,22 @@ void clock_synchronize(void);
 void clock_resynchronize(FAR struct timespec *rtc_diff);
 #endif
 
+/****************************************************************************
+ * Name: clock_timepage_update
+ *
+ * Description:
+ *   Rewrite the time page from the system timer and the base time.  Called
+ *   whenever either is changed other than by the periodic tick.
+ *
+ * Assumptions:
+ *   Called from within a critical section.
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_CLOCK_TIMEPAGE
+void clock_timepage_update(void);
+#endif
+
 /****************************************************************************
  * Name: clock_systimer
  *
@@ -442,6 +501,26 @@ int clock_systimespec(FAR struct timespec *ts);
 int clock_cpuload(int pid, FAR struct cpuload_s *cpuload);
 #endif
 
+/****************************************************************************
+ * Name:  clock_cpuload_cpu
+ *
+ * Description:
+ *   Return the total, IDLE and interrupt time accounted on one CPU by the
+ *   cycle-accurate CPU load accounting.
+ *
+ * Input Parameters:
+ *   cpu - The index of the CPU of interest.
+ *   cpuload - The location to return the CPU load
+ *
+ * Returned Value:
+ *   OK (0) on success; -EINVAL if 'cpu' is not a valid CPU index.
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_SCHED_CPULOAD_CYCLES
+int clock_cpuload_cpu(int cpu, FAR struct cpuload_cpu_s *cpuload);
+#endif
+
 /****************************************************************************
  * Name:  sched_oneshot_extclk
  *
@@ -42,6 +42,7 @@
  ****************************************************************************/
 
 #include <nuttx/config.h>
+#include <stddef.h>
 #include <stdint.h>
 
 /****************************************************************************
@@ -49,14 +50,41 @@
  ****************************************************************************/
 
 #define AES128_KEY_SIZE    16
+#define AES192_KEY_SIZE    24
+#define AES256_KEY_SIZE    32
+
+#define AES_BLOCKSIZE      16
+#define AES_MAXROUNDS      14
 
 /****************************************************************************
  * Public Types
  ****************************************************************************/
 
+/* Expanded key schedule.  The round keys are kept as 32-bit little-endian
+ * column words.  The decryption round keys are only used by the table
+ * driven implementation.
+ */
+
 struct aes_state_s
 {
-  uint8_t expanded_key[176];
+  uint32_t erk[4 * (AES_MAXROUNDS + 1)];  /* Encryption round keys */
+#ifndef CONFIG_CRYPTO_SW_AES_CONSTTIME
+  uint32_t drk[4 * (AES_MAXROUNDS + 1)];  /* Decryption round keys */
+#endif
+  int nrounds;                            /* 10, 12 or 14 */
+};
+
+/* AES-GCM context:  The AES key schedule plus the precomputed GHASH key */
+
+struct aes_gcm_s
+{
+  struct aes_state_s aes;
+#ifndef CONFIG_CRYPTO_SW_AES_CONSTTIME
+  uint64_t hl[16];                        /* 4-bit GHASH multiplication */
+  uint64_t hh[16];                        /* table (low and high halves) */
+#else
+  uint64_t h[2];                          /* GHASH key H (high, low) */
+#endif
 };
 
 /****************************************************************************
@@ -118,14 +146,12 @@ void aes_decrypt(FAR uint8_t *state, FAR const uint8_t *key);
  *
  * Input Parameters:
  *  state  an AES context that can be used for AES operations
- *  key    a pointer to a 16-byte buffer holding the AES-128 key
- *  len    length of the key, must be 16
- *
- * TODO: Support other key lengths of 24 (AES-192) and 32 (AES-256)
+ *  key    a pointer to a buffer holding the AES key
+ *  len    length of the key: 16 (AES-128), 24 (AES-192) or 32 (AES-256)
  *
  * Returned Value:
  *   0 if OK
- *   -EINVAL if len is not 16
+ *   -EINVAL if len is not a valid AES key length
  *
  ****************************************************************************/
 
@@ -164,6 +190,79 @@ void aes_encipher(FAR struct aes_state_s *state, FAR uint8_t *blocks,
 void aes_decipher(FAR struct aes_state_s *state, FAR uint8_t *blocks,
                   int nblk);
 
+/****************************************************************************
+ * Name: aes_cbc
+ *
+ * Description:
+ *   Encrypt or decrypt len bytes in CBC mode.  len must be a multiple of
+ *   16.  iv holds the 16-byte initialization vector on entry and the
+ *   chaining value for a following call on return.  out and in may be the
+ *   same buffer.
+ *
+ * Returned Value:
+ *   None
+ *
+ ****************************************************************************/
+
+void aes_cbc(FAR struct aes_state_s *state, FAR uint8_t *out,
+             FAR const uint8_t *in, size_t len, FAR uint8_t *iv,
+             int encrypt);
+
+/****************************************************************************
+ * Name: aes_ctr
+ *
+ * Description:
+ *   Encrypt or decrypt len bytes in CTR mode.  ctr holds the 16-byte
+ *   initial counter block on entry; it is incremented as a 128-bit
+ *   big-endian number for each block.  Only the last call in a sequence
+ *   may use a length that is not a multiple of 16.  out and in may be the
+ *   same buffer.
+ *
+ * Returned Value:
+ *   None
+ *
+ ****************************************************************************/
+
+void aes_ctr(FAR struct aes_state_s *state, FAR uint8_t *out,
+             FAR const uint8_t *in, size_t len, FAR uint8_t *ctr);
+
+/****************************************************************************
+ * Name: aes_gcm_setkey
+ *
+ * Description:
+ *   Expand the AES key and precompute the GHASH key for AES-GCM.
+ *
+ * Returned Value:
+ *   0 if OK
+ *   -EINVAL if len is not a valid AES key length
+ *
+ ****************************************************************************/
+
+int aes_gcm_setkey(FAR struct aes_gcm_s *gcm, FAR const uint8_t *key,
+                   int len);
+
+/****************************************************************************
+ * Name: aes_gcm_crypt
+ *
+ * Description:
+ *   Authenticated encryption or decryption with AES-GCM (NIST SP 800-38D).
+ *   When encrypting, taglen bytes of the authentication tag are written to
+ *   tag.  When decrypting, tag holds the expected tag; the output is
+ *   cleared if it does not match.
+ *
+ * Returned Value:
+ *   0 if OK
+ *   -EINVAL if ivlen or taglen is invalid
+ *   -EBADMSG if the tag of a decrypted message does not match
+ *
+ ****************************************************************************/
+
+int aes_gcm_crypt(FAR struct aes_gcm_s *gcm, int encrypt,
+                  FAR const uint8_t *iv, size_t ivlen,
+                  FAR const uint8_t *aad, size_t aadlen,
+                  FAR const uint8_t *in, FAR uint8_t *out, size_t len,
+                  FAR uint8_t *tag, size_t taglen);
+
 #ifdef  __cplusplus
 }
 #endif /* __cplusplus */
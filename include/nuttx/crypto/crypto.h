@@ -41,6 +41,7 @@
  ****************************************************************************/
 
 #include <nuttx/config.h>
+#include <stdint.h>
 #include <debug.h>
 
 /****************************************************************************
@@ -65,12 +66,47 @@
 #define CYPHER_ENCRYPT 1
 #define CYPHER_DECRYPT 0
 
+#if defined(CONFIG_CRYPTO_AES)
+/* Capabilities of a registered AES engine */
+
+#  define AES_ENGINE_MODE(m)     (1 << ((m) & AES_MODE_MASK))
+#  define AES_ENGINE_KEYSIZE(n)  (1 << ((n) >> 3)) /* 16, 24 or 32 bytes */
+#endif
+
+/****************************************************************************
+ * Public Types
+ ****************************************************************************/
+
+#ifndef __ASSEMBLY__
+
+#if defined(CONFIG_CRYPTO_AES)
+/* An AES engine, typically a hardware crypto block, registered with
+ * crypto_aesregister().  crypto_aescypher() hands each request to the
+ * first engine that supports its mode and key size.  An engine may still
+ * decline a request (e.g. because of the buffer alignment) by returning
+ * -ENOTSUP; the request then goes to the next engine or to aes_cypher().
+ */
+
+struct aes_engine_s
+{
+  FAR struct aes_engine_s *flink;  /* Used by crypto_aesregister() */
+  FAR const char *name;            /* Name of the engine */
+  uint32_t modes;                  /* Set of AES_ENGINE_MODE() */
+  uint32_t keysizes;               /* Set of AES_ENGINE_KEYSIZE() */
+
+  /* Same as aes_cypher() */
+
+  CODE int (*cypher)(FAR struct aes_engine_s *engine, FAR void *out,
+                     FAR const void *in, uint32_t size, FAR const void *iv,
+                     FAR const void *key, uint32_t keysize, int mode,
+                     int encrypt);
+};
+#endif
+
 /*******************************************************************************
  * Public Data
  ******************************************************************************/
 
-#ifndef __ASSEMBLY__
-
 #undef EXTERN
 #if defined(__cplusplus)
 #define EXTERN extern "C"
@@ -90,12 +126,32 @@ int up_cryptoinitialize(void);
 int aes_cypher(FAR void *out, FAR const void *in, uint32_t size,
                FAR const void *iv, FAR const void *key, uint32_t keysize,
                int mode, int encrypt);
+
+/* Register or unregister an AES engine.  An engine must not be
+ * unregistered while it may still be processing a request.
+ */
+
+int crypto_aesregister(FAR struct aes_engine_s *engine);
+int crypto_aesunregister(FAR struct aes_engine_s *engine);
+
+/* Same as aes_cypher(), but dispatched to the registered AES engines
+ * first.  aes_cypher() (the architecture's AES driver or the software
+ * library) handles the requests that no engine accepts.
+ */
+
+int crypto_aescypher(FAR void *out, FAR const void *in, uint32_t size,
+                     FAR const void *iv, FAR const void *key,
+                     uint32_t keysize, int mode, int encrypt);
 #endif
 
 #if defined(CONFIG_CRYPTO_ALGTEST)
 int crypto_test(void);
 #endif
 
+#if defined(CONFIG_CRYPTO_BENCHMARK)
+int crypto_benchmark(void);
+#endif
+
 #undef EXTERN
 #if defined(__cplusplus)
 }
@@ -53,7 +53,11 @@
 #define CRYPTO_AES_ECB          1
 #define CRYPTO_AES_CBC          2
 #define CRYPTO_AES_CTR          3
-#define CRYPTO_ALGORITHM_MAX    1
+#define CRYPTO_SHA1             4
+#define CRYPTO_SHA2_256         5
+#define CRYPTO_SHA1_HMAC        6
+#define CRYPTO_SHA2_256_HMAC    7
+#define CRYPTO_ALGORITHM_MAX    7
 
 #define CRYPTO_FLAG_HARDWARE    0x01000000 /* hardware accelerated */
 #define CRYPTO_FLAG_SOFTWARE    0x02000000 /* software implementation */
@@ -65,13 +69,15 @@
 #define CIOCGSESSION            101
 #define CIOCFSESSION            102
 #define CIOCCRYPT               103
+#define CIOCASYNCCRYPT          104 /* Submit a struct crypt_batch */
+#define CIOCASYNCFETCH          105 /* Fetch completions (struct crypt_batch) */
 
 typedef char* caddr_t;
 
 struct session_op
 {
-  uint32_t cipher;    /* ie. CRYPTO_AES_EBC */
-  uint32_t mac;
+  uint32_t cipher;    /* ie. CRYPTO_AES_EBC, or 0 for none */
+  uint32_t mac;       /* ie. CRYPTO_SHA2_256_HMAC, or 0 for none */
 
   uint32_t keylen;    /* cipher key */
   caddr_t key;
@@ -81,6 +87,11 @@ struct session_op
   uint32_t ses;       /* returns: session # */
 };
 
+/* If the session has both a cipher and a MAC, the MAC is computed over the
+ * ciphertext:  dst on COP_ENCRYPT and src on COP_DECRYPT.  Without a cipher
+ * it is computed over src.
+ */
+
 struct crypt_op
 {
   uint32_t ses;
@@ -92,4 +103,30 @@ struct crypt_op
   caddr_t iv;
 };
 
+/* An asynchronous request:  The operation is performed in the background
+ * directly on the caller's src and dst buffers, which must remain valid
+ * until the completion has been fetched.  src and dst may be the same
+ * buffer.
+ */
+
+struct crypt_aop
+{
+  struct crypt_op op;  /* The operation, as for CIOCCRYPT */
+  FAR void *opaque;    /* Caller's tag, returned with the completion */
+  int status;          /* Returns: OK or a negated errno value */
+};
+
+/* Argument of CIOCASYNCCRYPT and CIOCASYNCFETCH.  On CIOCASYNCCRYPT, count
+ * requests are submitted and count returns the number that were accepted.
+ * On CIOCASYNCFETCH, up to count completions are returned in aops and
+ * count returns their number.  poll() reports POLLIN when completions can
+ * be fetched and POLLOUT when more requests can be submitted.
+ */
+
+struct crypt_batch
+{
+  unsigned count;
+  FAR struct crypt_aop *aops;
+};
+
 #endif /* __INCLUDE_NUTTX_CRYPTO_CRYPTODEV_H */
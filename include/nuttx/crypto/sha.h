@@ -0,0 +1,161 @@
+/****************************************************************************
+ * include/nuttx/crypto/sha.h
+ *
+ *   Copyright (C) 2020 Gregory Nutt. All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in
+ *    the documentation and/or other materials provided with the
+ *    distribution.
+ * 3. Neither the name NuttX nor the names of its contributors may be
+ *    used to endorse or promote products derived from this software
+ *    without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+ * FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE
+ * COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+ * INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,
+ * BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS
+ * OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED
+ * AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ * LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN
+ * ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ *
+ ****************************************************************************/
+
+#ifndef __INCLUDE_NUTTX_CRYPTO_SHA_H
+#define __INCLUDE_NUTTX_CRYPTO_SHA_H
+
+/****************************************************************************
+ * Included Files
+ ****************************************************************************/
+
+#include <nuttx/config.h>
+
+#include <stddef.h>
+#include <stdint.h>
+
+/****************************************************************************
+ * Pre-processor Definitions
+ ****************************************************************************/
+
+#define SHA1_BLOCKSIZE      64
+#define SHA1_DIGESTSIZE     20
+#define SHA256_BLOCKSIZE    64
+#define SHA256_DIGESTSIZE   32
+
+/* HMAC algorithms */
+
+#define HMAC_SHA1           1
+#define HMAC_SHA256         2
+
+#define HMAC_MAXDIGESTSIZE  SHA256_DIGESTSIZE
+
+/****************************************************************************
+ * Public Types
+ ****************************************************************************/
+
+struct sha1_ctx_s
+{
+  uint32_t state[5];
+  uint64_t count;                   /* Number of bytes hashed */
+  uint8_t buffer[SHA1_BLOCKSIZE];   /* Partial block */
+};
+
+struct sha256_ctx_s
+{
+  uint32_t state[8];
+  uint64_t count;                   /* Number of bytes hashed */
+  uint8_t buffer[SHA256_BLOCKSIZE]; /* Partial block */
+};
+
+union hmac_hash_u
+{
+#ifdef CONFIG_CRYPTO_SHA1
+  struct sha1_ctx_s sha1;
+#endif
+#ifdef CONFIG_CRYPTO_SHA256
+  struct sha256_ctx_s sha256;
+#endif
+};
+
+struct hmac_ctx_s
+{
+  int alg;                          /* HMAC_SHA1 or HMAC_SHA256 */
+  union hmac_hash_u inner;          /* Hash keyed with K ^ ipad */
+  union hmac_hash_u outer;          /* Hash keyed with K ^ opad */
+};
+
+/****************************************************************************
+ * Public Function Prototypes
+ ****************************************************************************/
+
+#ifdef __cplusplus
+extern "C"
+{
+#endif
+
+#ifdef CONFIG_CRYPTO_SHA1
+/* SHA-1 (FIPS 180-4).  sha1() hashes a whole message at once. */
+
+void sha1_init(FAR struct sha1_ctx_s *ctx);
+void sha1_update(FAR struct sha1_ctx_s *ctx, FAR const void *data,
+                 size_t len);
+void sha1_final(FAR struct sha1_ctx_s *ctx, FAR uint8_t *digest);
+void sha1(FAR uint8_t *digest, FAR const void *data, size_t len);
+
+#ifdef CONFIG_ARCH_HAVE_SHA1
+/* Architecture-specific SHA-1 compression of nblocks 64-byte blocks, e.g.
+ * with a hash accelerator.  It replaces the software implementation.
+ */
+
+void up_sha1_blocks(FAR uint32_t *state, FAR const uint8_t *data,
+                    size_t nblocks);
+#endif
+#endif
+
+#ifdef CONFIG_CRYPTO_SHA256
+/* SHA-256 (FIPS 180-4).  sha256() hashes a whole message at once. */
+
+void sha256_init(FAR struct sha256_ctx_s *ctx);
+void sha256_update(FAR struct sha256_ctx_s *ctx, FAR const void *data,
+                   size_t len);
+void sha256_final(FAR struct sha256_ctx_s *ctx, FAR uint8_t *digest);
+void sha256(FAR uint8_t *digest, FAR const void *data, size_t len);
+
+#ifdef CONFIG_ARCH_HAVE_SHA256
+/* Architecture-specific SHA-256 compression of nblocks 64-byte blocks */
+
+void up_sha256_blocks(FAR uint32_t *state, FAR const uint8_t *data,
+                      size_t nblocks);
+#endif
+#endif
+
+#ifdef CONFIG_CRYPTO_HMAC
+/* HMAC (RFC 2104) with SHA-1 or SHA-256.  hmac_final() and hmac() return
+ * the length of the digest, or -EINVAL if the algorithm is not available.
+ */
+
+int hmac_init(FAR struct hmac_ctx_s *ctx, int alg, FAR const void *key,
+              size_t keylen);
+void hmac_update(FAR struct hmac_ctx_s *ctx, FAR const void *data,
+                 size_t len);
+int hmac_final(FAR struct hmac_ctx_s *ctx, FAR uint8_t *digest);
+int hmac(int alg, FAR const void *key, size_t keylen, FAR const void *data,
+         size_t len, FAR uint8_t *digest);
+#endif
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* __INCLUDE_NUTTX_CRYPTO_SHA_H */
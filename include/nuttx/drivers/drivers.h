@@ -45,6 +45,22 @@
 #include <sys/types.h>
 #include <stdbool.h>
 
+/****************************************************************************
+ * Public Types
+ ****************************************************************************/
+
+#ifdef CONFIG_DEV_PIPE_SPLICE
+/* Argument of the PIPEIOC_SPLICEIN and PIPEIOC_SPLICEOUT ioctl commands.
+ * Data is moved between the pipe and the file open on ps_fd.
+ */
+
+struct pipe_splice_s
+{
+  int    ps_fd;           /* The other end of the transfer */
+  size_t ps_len;          /* Maximum number of bytes to move */
+};
+#endif
+
 /****************************************************************************
  * Public Function Prototypes
  ****************************************************************************/
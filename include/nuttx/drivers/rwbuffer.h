@@ -54,6 +54,22 @@
  * Pre-processor Definitions
  ****************************************************************************/
 
+/* Configuration ************************************************************/
+
+#ifndef CONFIG_DRVR_WRSEGMENTS
+#  define CONFIG_DRVR_WRSEGMENTS 1
+#endif
+
+#ifdef CONFIG_DRVR_WRDOUBLEBUFFER
+#  define RWB_NWRBUFFERS 2
+#else
+#  define RWB_NWRBUFFERS 1
+#endif
+
+#ifndef CONFIG_DRVR_RHENTRIES
+#  define CONFIG_DRVR_RHENTRIES 1
+#endif
+
 /****************************************************************************
  * Public Types
  ****************************************************************************/
@@ -68,6 +84,40 @@ typedef CODE ssize_t (*rwbreload_t)(FAR void *dev, FAR uint8_t *buffer,
 typedef CODE ssize_t (*rwbflush_t)(FAR void *dev, FAR const uint8_t *buffer,
                                    off_t startblock, size_t nblocks);
 
+/* One run of contiguous blocks in a write buffer */
+
+#ifdef CONFIG_DRVR_WRITEBUFFER
+struct rwb_wrseg_s
+{
+  off_t         blockstart;      /* First block in the segment */
+  uint16_t      nblocks;         /* Number of blocks in the segment */
+};
+
+/* A write buffer.  The segments are sorted by block number, never overlap
+ * and are never adjacent.  The data of the segments is packed in the
+ * buffer in the same order.
+ */
+
+struct rwb_wrbuffer_s
+{
+  uint8_t      *buffer;          /* Allocated buffer memory */
+  uint16_t      nblocks;         /* Total number of blocks buffered */
+  uint8_t       nsegs;           /* Number of segments in use */
+  struct rwb_wrseg_s segs[CONFIG_DRVR_WRSEGMENTS];
+};
+#endif
+
+/* A read-ahead buffer */
+
+#ifdef CONFIG_DRVR_READAHEAD
+struct rwb_rhbuffer_s
+{
+  uint8_t      *buffer;          /* Buffer memory */
+  uint16_t      nblocks;         /* Number of blocks in the buffer */
+  off_t         blockstart;      /* First block in the buffer */
+};
+#endif
+
 /* This structure holds the state of the buffers.  In typical usage,
  * an instance of this structure is declared within each block driver
  * status structure like:
@@ -138,20 +188,24 @@ struct rwbuffer_s
 
 #ifdef CONFIG_DRVR_WRITEBUFFER
   sem_t         wrsem;           /* Enforces exclusive access to the write buffer */
+  sem_t         wrflushsem;      /* Held while a write buffer is written to the media */
   struct work_s work;            /* Delayed work to flush buffer after a delay with no activity */
-  uint8_t      *wrbuffer;        /* Allocated write buffer */
-  uint16_t      wrnblocks;       /* Number of blocks in write buffer */
-  off_t         wrblockstart;    /* First block in write buffer */
-  off_t         wrexpectedblock; /* Next block expected */
+#ifdef CONFIG_DRVR_WRDOUBLEBUFFER
+  struct work_s flushwork;       /* Work to write the full buffer to the media */
+#endif
+  uint8_t       wrcur;           /* Index of the buffer being filled */
+  struct rwb_wrbuffer_s wrbuf[RWB_NWRBUFFERS];
 #endif
 
   /* This is the state of the read-ahead buffering */
 
 #ifdef CONFIG_DRVR_READAHEAD
-  sem_t         rhsem;           /* Enforces exclusive access to the write buffer */
-  uint8_t      *rhbuffer;        /* Allocated read-ahead buffer */
-  uint16_t      rhnblocks;       /* Number of blocks in read-ahead buffer */
-  off_t         rhblockstart;    /* First block in read-ahead buffer */
+  sem_t         rhsem;           /* Enforces exclusive access to the read-ahead buffers */
+  uint8_t      *rhbuffer;        /* Allocated memory for all read-ahead buffers */
+
+  /* The read-ahead buffers, most recently used first */
+
+  struct rwb_rhbuffer_s rhbuf[CONFIG_DRVR_RHENTRIES];
 #endif
 };
 
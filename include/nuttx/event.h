@@ -0,0 +1,214 @@
+/****************************************************************************
+ * include/nuttx/event.h
+ *
+ *   Copyright (C) 2020 Gregory Nutt. All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in
+ *    the documentation and/or other materials provided with the
+ *    distribution.
+ * 3. Neither the name NuttX nor the names of its contributors may be
+ *    used to endorse or promote products derived from this software
+ *    without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+ * FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE
+ * COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+ * INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,
+ * BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS
+ * OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED
+ * AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ * LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN
+ * ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ *
+ ****************************************************************************/
+
+#ifndef __INCLUDE_NUTTX_EVENT_H
+#define __INCLUDE_NUTTX_EVENT_H
+
+/****************************************************************************
+ * Included Files
+ ****************************************************************************/
+
+#include <nuttx/config.h>
+
+#include <stdint.h>
+#include <queue.h>
+
+#ifdef CONFIG_SCHED_EVENTS
+
+/****************************************************************************
+ * Pre-processor Definitions
+ ****************************************************************************/
+
+/* nxevent_wait() and nxevent_tickwait() flags */
+
+#define NXEVENT_WAIT_ALL    (1 << 0) /* Wait for all events, not any event */
+#define NXEVENT_WAIT_RESET  (1 << 1) /* Clear the awaited events on return */
+
+/* Initializer for a statically allocated event group */
+
+#define NXEVENT_INITIALIZER(e)  {(e), {NULL, NULL}}
+
+/****************************************************************************
+ * Public Types
+ ****************************************************************************/
+
+/* A set of event bits */
+
+typedef uint32_t nxevent_mask_t;
+
+/* An event group.  Any number of tasks may wait for any or all of a set of
+ * events.  A task waiting in nxevent_wait() is woken up exactly once, by
+ * the nxevent_post() that satisfies its condition, instead of once for
+ * each event as with one semaphore per event.
+ */
+
+struct nxevent_s
+{
+  volatile nxevent_mask_t events; /* The events that are set */
+  dq_queue_t waitlist;            /* The waiting tasks */
+};
+
+/****************************************************************************
+ * Public Function Prototypes
+ ****************************************************************************/
+
+#undef EXTERN
+#if defined(__cplusplus)
+#define EXTERN extern "C"
+extern "C"
+{
+#else
+#define EXTERN extern
+#endif
+
+/****************************************************************************
+ * Name: nxevent_init
+ *
+ * Description:
+ *   Initialize an event group.
+ *
+ * Input Parameters:
+ *   event  - The event group to initialize
+ *   events - The initial set of events
+ *
+ * Returned Value:
+ *   Zero (OK) is always returned.
+ *
+ ****************************************************************************/
+
+int nxevent_init(FAR struct nxevent_s *event, nxevent_mask_t events);
+
+/****************************************************************************
+ * Name: nxevent_destroy
+ *
+ * Description:
+ *   Destroy an event group.  No task may be waiting on it.
+ *
+ * Returned Value:
+ *   Zero (OK) on success.  -EBUSY if a task is waiting.
+ *
+ ****************************************************************************/
+
+int nxevent_destroy(FAR struct nxevent_s *event);
+
+/****************************************************************************
+ * Name: nxevent_post
+ *
+ * Description:
+ *   Set events and wake up the waiting tasks whose condition is now met,
+ *   in the order in which they started waiting.  A waiter that specified
+ *   NXEVENT_WAIT_RESET consumes its events before the next waiter is
+ *   checked.  This function may be called from interrupt handlers.
+ *
+ * Input Parameters:
+ *   event  - The event group
+ *   events - The events to set
+ *
+ * Returned Value:
+ *   Zero (OK) is always returned.
+ *
+ ****************************************************************************/
+
+int nxevent_post(FAR struct nxevent_s *event, nxevent_mask_t events);
+
+/****************************************************************************
+ * Name: nxevent_clear
+ *
+ * Description:
+ *   Clear events.  This function may be called from interrupt handlers.
+ *
+ * Input Parameters:
+ *   event  - The event group
+ *   events - The events to clear
+ *
+ * Returned Value:
+ *   The set of events before they were cleared.
+ *
+ ****************************************************************************/
+
+nxevent_mask_t nxevent_clear(FAR struct nxevent_s *event,
+                             nxevent_mask_t events);
+
+/****************************************************************************
+ * Name: nxevent_wait
+ *
+ * Description:
+ *   Wait until any (or, with NXEVENT_WAIT_ALL, all) of the given events are
+ *   set.  With NXEVENT_WAIT_RESET, the awaited events are cleared
+ *   atomically with the wakeup.
+ *
+ * Input Parameters:
+ *   event  - The event group
+ *   events - The events to wait for
+ *   eflags - NXEVENT_WAIT_ALL and NXEVENT_WAIT_RESET
+ *   result - Location to return the set of events when the condition was
+ *            met, before any were cleared.  May be NULL.
+ *
+ * Returned Value:
+ *   Zero (OK) on success.  A negated errno value on failure:
+ *
+ *   EINTR - The wait was interrupted by a signal
+ *
+ ****************************************************************************/
+
+int nxevent_wait(FAR struct nxevent_s *event, nxevent_mask_t events,
+                 int eflags, FAR nxevent_mask_t *result);
+
+/****************************************************************************
+ * Name: nxevent_tickwait
+ *
+ * Description:
+ *   Like nxevent_wait(), but give up after delay clock ticks.  A delay of
+ *   zero only polls the events.
+ *
+ * Returned Value:
+ *   Zero (OK) on success.  A negated errno value on failure:
+ *
+ *   EAGAIN    - delay is zero and the condition is not met
+ *   ETIMEDOUT - The condition was not met within delay ticks
+ *   EINTR     - The wait was interrupted by a signal
+ *
+ ****************************************************************************/
+
+int nxevent_tickwait(FAR struct nxevent_s *event, nxevent_mask_t events,
+                     int eflags, uint32_t delay,
+                     FAR nxevent_mask_t *result);
+
+#undef EXTERN
+#if defined(__cplusplus)
+}
+#endif
+
+#endif /* CONFIG_SCHED_EVENTS */
+#endif /* __INCLUDE_NUTTX_EVENT_H */
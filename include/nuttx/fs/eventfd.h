@@ -0,0 +1,125 @@
+/****************************************************************************
+ * include/nuttx/fs/eventfd.h
+ *
+ *   Copyright (C) 2020 Gregory Nutt. All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in
+ *    the documentation and/or other materials provided with the
+ *    distribution.
+ * 3. Neither the name NuttX nor the names of its contributors may be
+ *    used to endorse or promote products derived from this software
+ *    without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+ * FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE
+ * COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+ * INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,
+ * BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS
+ * OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED
+ * AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ * LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN
+ * ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ *
+ ****************************************************************************/
+
+#ifndef __INCLUDE_NUTTX_FS_EVENTFD_H
+#define __INCLUDE_NUTTX_FS_EVENTFD_H
+
+/****************************************************************************
+ * Included Files
+ ****************************************************************************/
+
+#include <nuttx/config.h>
+
+#include <sys/eventfd.h>
+
+#ifdef CONFIG_EVENT_FD
+
+/****************************************************************************
+ * Public Types
+ ****************************************************************************/
+
+/* The opaque state of an event file descriptor */
+
+struct eventfd_priv_s;
+
+/****************************************************************************
+ * Public Function Prototypes
+ ****************************************************************************/
+
+#undef EXTERN
+#if defined(__cplusplus)
+#define EXTERN extern "C"
+extern "C"
+{
+#else
+#define EXTERN extern
+#endif
+
+/****************************************************************************
+ * Name: eventfd_get
+ *
+ * Description:
+ *   Take a reference to the event object behind an event file descriptor,
+ *   typically one passed to a driver with an IOCTL command.  The object
+ *   stays valid after the descriptor is closed until eventfd_put() is
+ *   called.
+ *
+ * Input Parameters:
+ *   fd - An event file descriptor of the calling task
+ *
+ * Returned Value:
+ *   The event object, or NULL if fd is not an event file descriptor.
+ *
+ ****************************************************************************/
+
+FAR struct eventfd_priv_s *eventfd_get(int fd);
+
+/****************************************************************************
+ * Name: eventfd_put
+ *
+ * Description:
+ *   Release a reference taken with eventfd_get().
+ *
+ ****************************************************************************/
+
+void eventfd_put(FAR struct eventfd_priv_s *dev);
+
+/****************************************************************************
+ * Name: eventfd_signal
+ *
+ * Description:
+ *   Add value to the counter of an event object and wake up the readers
+ *   and pollers.  This never blocks and may be called from interrupt
+ *   handlers, so one event loop polling the descriptor can replace a
+ *   thread per event source.
+ *
+ * Input Parameters:
+ *   dev   - The event object from eventfd_get()
+ *   value - The value to add
+ *
+ * Returned Value:
+ *   Zero (OK) on success.  -EAGAIN if the counter would overflow, in which
+ *   case it is left unchanged.
+ *
+ ****************************************************************************/
+
+int eventfd_signal(FAR struct eventfd_priv_s *dev, eventfd_t value);
+
+#undef EXTERN
+#if defined(__cplusplus)
+}
+#endif
+
+#endif /* CONFIG_EVENT_FD */
+#endif /* __INCLUDE_NUTTX_FS_EVENTFD_H */
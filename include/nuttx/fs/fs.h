@@ -117,11 +117,32 @@
 #define __FS_FLAG_ERROR (1 << 1) /* Error detected by any operation */
 #define __FS_FLAG_LBF   (1 << 2) /* Line buffered */
 #define __FS_FLAG_UBF   (1 << 3) /* Buffer allocated by caller of setvbuf */
+#define __FS_FLAG_LAZY  (1 << 4) /* Buffer to be allocated on first use */
+
+/* File list rows.  With CONFIG_FS_FILELIST_DYNAMIC, the file list is
+ * allocated in rows of CONFIG_FS_FILELIST_ROWSIZE file structures as file
+ * descriptors are needed.  A row never moves and is not freed until the
+ * list is released, so a struct file may be looked up without locking the
+ * list.  files_fget() returns NULL if the row of 'fd' does not exist yet.
+ */
+
+#ifdef CONFIG_FS_FILELIST_DYNAMIC
+#  define FILELIST_NROWS \
+     ((CONFIG_NFILE_DESCRIPTORS + CONFIG_FS_FILELIST_ROWSIZE - 1) / \
+      CONFIG_FS_FILELIST_ROWSIZE)
+#  define files_fget(l,fd) \
+     ((l)->fl_rows[(fd) / CONFIG_FS_FILELIST_ROWSIZE] == NULL ? NULL : \
+      &(l)->fl_rows[(fd) / CONFIG_FS_FILELIST_ROWSIZE] \
+                   [(fd) % CONFIG_FS_FILELIST_ROWSIZE])
+#else
+#  define files_fget(l,fd) (&(l)->fl_files[fd])
+#endif
 
 /* Inode i_flags values:
  *
  *   Bit 0-3: Inode type (Bit 3 indicates internal OS types)
  *   Bit 4:   Set if inode has been unlinked and is pending removal.
+ *   Bit 5:   Set if lookups in a mountpoint may be cached.
  */
 
 #define FSNODEFLAG_TYPE_MASK       0x0000000f /* Isolates type field      */
@@ -135,6 +156,7 @@
 #define   FSNODEFLAG_TYPE_MTD      0x0000000b /*   Named MTD driver       */
 #define   FSNODEFLAG_TYPE_SOFTLINK 0x0000000c /*   Soft link              */
 #define FSNODEFLAG_DELETED         0x00000010 /* Unlinked                 */
+#define FSNODEFLAG_DCACHE          0x00000020 /* Lookups may be cached    */
 
 #define INODE_IS_TYPE(i,t) \
   (((i)->i_flags & FSNODEFLAG_TYPE_MASK) == (t))
@@ -258,6 +280,25 @@ struct geometry
   size_t geo_sectorsize;   /* Size of one sector */
 };
 
+/* This structure is used with the FIOC_EXTENT ioctl command to find where
+ * the data of a file is stored: in a run of consecutive sectors of a block
+ * driver, or in memory.  Data so found can be accessed without going
+ * through the file system, e.g. by the loop device.  It stays valid only
+ * while the file is open and is neither truncated nor rewritten in place
+ * by the file system.
+ */
+
+struct file_extent_s
+{
+  off_t fe_offset;             /* IN:  Byte offset into the file */
+  off_t fe_length;             /* IN:  Bytes wanted, or 0 for all.
+                                * OUT: Bytes stored contiguously */
+  FAR struct inode *fe_blkdrv; /* OUT: Block driver, NULL if in memory */
+  size_t fe_sector;            /* OUT: First sector on fe_blkdrv */
+  size_t fe_sectsize;          /* OUT: Sector size of fe_blkdrv */
+  FAR uint8_t *fe_mem;         /* OUT: Address of the data in memory */
+};
+
 /* This structure is provided by block devices when they register with the
  * system.  It is used by file systems to perform filesystem transfers.  It
  * differs from the normal driver vtable in several ways -- most notably in
@@ -426,7 +467,11 @@ struct file
 struct filelist
 {
   sem_t   fl_sem;               /* Manage access to the file list */
+#ifdef CONFIG_FS_FILELIST_DYNAMIC
+  FAR struct file *fl_rows[FILELIST_NROWS]; /* Rows of the file list */
+#else
   struct file fl_files[CONFIG_NFILE_DESCRIPTORS];
+#endif
 };
 
 /* The following structure defines the list of files used for standard C I/O.
@@ -711,6 +756,28 @@ void files_initlist(FAR struct filelist *list);
 
 void files_releaselist(FAR struct filelist *list);
 
+/****************************************************************************
+ * Name: files_extend
+ *
+ * Description:
+ *   Make sure that the file list has a struct file for descriptor 'fd'.
+ *   This is needed only before files_fget() of a descriptor that may not
+ *   have been allocated yet, as when a specific descriptor is the target
+ *   of dup2().
+ *
+ * Returned Value:
+ *   Zero (OK) on success; -EBADF if 'fd' is out of range or -ENOMEM if
+ *   the row could not be allocated.
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_FS_FILELIST_DYNAMIC
+int files_extend(FAR struct filelist *list, int fd);
+#else
+#  define files_extend(l,fd) \
+     ((unsigned int)(fd) < CONFIG_NFILE_DESCRIPTORS ? OK : -EBADF)
+#endif
+
 /****************************************************************************
  * Name: file_dup2
  *
@@ -974,7 +1041,7 @@ int lib_flushall(FAR struct streamlist *list);
  *
  ****************************************************************************/
 
-#ifdef CONFIG_NET_SENDFILE
+#ifdef CONFIG_FS_SENDFILE
 ssize_t lib_sendfile(int outfd, int infd, off_t *offset, size_t count);
 #endif
 
@@ -1301,6 +1368,34 @@ int file_fstat(FAR struct file *filep, FAR struct stat *buf);
 
 int fdesc_poll(int fd, FAR struct pollfd *fds, bool setup);
 
+/****************************************************************************
+ * Name: dcache_invalidate and dcache_flush
+ *
+ * Description:
+ *   The VFS caches the attributes of recently looked up paths in
+ *   mountpoints, and the paths recently found not to exist.  The VFS
+ *   invalidates these itself when a path is created, removed, renamed or
+ *   written through it.  A file system that changes its contents by other
+ *   means must call dcache_invalidate() for each path that it creates,
+ *   removes or modifies, or dcache_flush() to discard everything cached for
+ *   the mountpoint.  If 'files' is true, dcache_flush() discards only the
+ *   attributes of regular files.
+ *
+ * Input Parameters:
+ *   mountpt - The mountpoint inode
+ *   relpath - The path relative to the mountpoint
+ *   files   - Discard only regular file attributes
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_FS_DCACHE
+void dcache_invalidate(FAR struct inode *mountpt, FAR const char *relpath);
+void dcache_flush(FAR struct inode *mountpt, bool files);
+#else
+#  define dcache_invalidate(m,r)
+#  define dcache_flush(m,f)
+#endif
+
 #undef EXTERN
 #if defined(__cplusplus)
 }
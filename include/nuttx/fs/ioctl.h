@@ -171,6 +171,20 @@
                                            * OUT: Instance number is returned on
                                            *      success.
                                            */
+#define FIOC_CACHESTATS _FIOC(0x000b)     /* IN:  Pointer to a file system
+                                           *      specific statistics structure
+                                           * OUT: Cache statistics
+                                           */
+#define FIOC_TRUNCATE   _FIOC(0x000c)     /* IN:  The new length of the file
+                                           *      (off_t)
+                                           * OUT: None
+                                           */
+#define FIOC_EXTENT     _FIOC(0x000d)     /* IN:  Pointer to a struct
+                                           *      file_extent_s holding an
+                                           *      offset into the file
+                                           * OUT: Where the contiguous data
+                                           *      at that offset is stored
+                                           */
 
 /* NuttX file system ioctl definitions **************************************/
 
@@ -388,6 +402,35 @@
                                              *       (default)
                                              *     1=fre when empty
                                              * OUT: None */
+#define PIPEIOC_SETSIZE   _PIPEIOC(0x0002)  /* Resize the ring buffer
+                                             * IN: unsigned long integer
+                                             *     New size in bytes
+                                             * OUT: None */
+#define PIPEIOC_GETSIZE   _PIPEIOC(0x0003)  /* Get the ring buffer size
+                                             * IN: Pointer to int
+                                             * OUT: Size in bytes */
+#define PIPEIOC_RDLOWAT   _PIPEIOC(0x0004)  /* Set read low watermark
+                                             * IN: unsigned long integer
+                                             *     Bytes that must be
+                                             *     buffered before readers
+                                             *     are woken (default 1)
+                                             * OUT: None */
+#define PIPEIOC_WRLOWAT   _PIPEIOC(0x0005)  /* Set write low watermark
+                                             * IN: unsigned long integer
+                                             *     Bytes that must be free
+                                             *     before writers are
+                                             *     woken (default 1)
+                                             * OUT: None */
+#define PIPEIOC_SPLICEIN  _PIPEIOC(0x0006)  /* Move data from a file into
+                                             * the pipe
+                                             * IN: Pointer to struct
+                                             *     pipe_splice_s
+                                             * OUT: Bytes moved */
+#define PIPEIOC_SPLICEOUT _PIPEIOC(0x0007)  /* Move data from the pipe to
+                                             * a file
+                                             * IN: Pointer to struct
+                                             *     pipe_splice_s
+                                             * OUT: Bytes moved */
 
 /* RTC driver ioctl definitions *********************************************/
 
@@ -133,6 +133,85 @@ struct procfs_dir_priv_s
   FAR const struct procfs_entry_s *procfsentry; /* Pointer to procfs handler entry */
 };
 
+/* Binary metrics snapshot **************************************************/
+
+/* /proc/metrics.bin returns one struct procfs_metrics_s header followed by
+ * 'ntasks' records of struct procfs_metrics_task_s, all in native byte
+ * order.  New fields are only ever appended, so readers should use
+ * 'hdrsize' and 'tasksize' to step through the snapshot and must check
+ * 'flags' before trusting a section.
+ */
+
+#define PROCFS_METRICS_MAGIC    0x544d584e  /* "NXMT" in little-endian */
+#define PROCFS_METRICS_VERSION  1
+
+#define PROCFS_METRICS_CPULOAD  (1 << 0)    /* Task CPU load is valid */
+#define PROCFS_METRICS_STACK    (1 << 1)    /* Task stack usage is valid */
+#define PROCFS_METRICS_KHEAP    (1 << 2)    /* Kernel heap is valid */
+#define PROCFS_METRICS_UHEAP    (1 << 3)    /* User heap is valid */
+#define PROCFS_METRICS_IOB      (1 << 4)    /* IOB statistics are valid */
+#define PROCFS_METRICS_NET      (1 << 5)    /* Network counters are valid */
+
+struct procfs_metrics_heap_s
+{
+  uint32_t arena;               /* Total size of the heap */
+  uint32_t ordblks;             /* Number of free chunks */
+  uint32_t mxordblk;            /* Largest free chunk */
+  uint32_t uordblks;            /* Total allocated space */
+  uint32_t fordblks;            /* Total free space */
+};
+
+struct procfs_metrics_iob_s
+{
+  uint32_t navail;              /* Free IOBs */
+  uint32_t nqavail;             /* Free IOB queue containers */
+  uint32_t consumed;            /* Total IOBs consumed (if iobinfo) */
+  uint32_t produced;            /* Total IOBs produced (if iobinfo) */
+};
+
+struct procfs_metrics_net_s
+{
+  uint32_t ipv4_recv;           /* IPv4 packets received */
+  uint32_t ipv4_sent;           /* IPv4 packets sent */
+  uint32_t ipv4_drop;           /* IPv4 packets dropped */
+  uint32_t ipv6_recv;           /* IPv6 packets received */
+  uint32_t ipv6_sent;           /* IPv6 packets sent */
+  uint32_t ipv6_drop;           /* IPv6 packets dropped */
+  uint32_t tcp_recv;            /* TCP segments received */
+  uint32_t tcp_sent;            /* TCP segments sent */
+  uint32_t tcp_drop;            /* TCP segments dropped */
+  uint32_t tcp_rexmit;          /* TCP segments retransmitted */
+  uint32_t udp_recv;            /* UDP datagrams received */
+  uint32_t udp_sent;            /* UDP datagrams sent */
+  uint32_t udp_drop;            /* UDP datagrams dropped */
+};
+
+struct procfs_metrics_s
+{
+  uint32_t magic;               /* PROCFS_METRICS_MAGIC */
+  uint16_t version;             /* PROCFS_METRICS_VERSION */
+  uint16_t hdrsize;             /* Size of this header in bytes */
+  uint16_t tasksize;            /* Size of each task record in bytes */
+  uint16_t ntasks;              /* Number of task records that follow */
+  uint32_t flags;               /* See PROCFS_METRICS_* definitions */
+  uint32_t systime;             /* System time in clock ticks */
+  uint32_t cputotal;            /* Ticks in the CPU load sample interval */
+  struct procfs_metrics_heap_s kheap;
+  struct procfs_metrics_heap_s uheap;
+  struct procfs_metrics_iob_s  iob;
+  struct procfs_metrics_net_s  net;
+};
+
+struct procfs_metrics_task_s
+{
+  int16_t  pid;                 /* Task/thread ID */
+  uint8_t  priority;            /* Current priority */
+  uint8_t  state;               /* enum tstate_e */
+  uint32_t cpuload;             /* Active ticks in the sample interval */
+  uint32_t stacksize;           /* Stack size in bytes */
+  uint32_t stackused;           /* Stack high-water mark in bytes */
+};
+
 /****************************************************************************
  * Public Function Prototypes
  ****************************************************************************/
@@ -184,6 +184,35 @@
 #  define I2C_RESET(d) ((d)->ops->reset(d))
 #endif
 
+/****************************************************************************
+ * Name: I2C_BATCH
+ *
+ * Description:
+ *   Perform a list of register operations, possibly on several devices of
+ *   the same bus, as one serialized sequence.  Each operation writes
+ *   'wlength' bytes (normally a register address) and then, if 'rlength'
+ *   is non-zero, reads 'rlength' bytes after a repeated START.  Every
+ *   operation ends with a STOP.  Lower halves that provide the batch
+ *   method run the whole list without waking the caller per operation;
+ *   otherwise it is performed with one I2C_TRANSFER() per operation.
+ *
+ * Input Parameters:
+ *   dev   - Device-specific state data
+ *   ops   - The operations, run in order
+ *   count - The number of operations
+ *
+ * Returned Value:
+ *   The number of leading operations known to have completed (a lower half
+ *   may only report whole runs of operations on one device).  Operations
+ *   after a failing one are not attempted; if none completed, a negated
+ *   errno value is returned.
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_I2C_BATCH
+#  define I2C_BATCH(d,o,c) i2c_batch(d,o,c)
+#endif
+
 /****************************************************************************
  * Public Types
  ****************************************************************************/
@@ -192,6 +221,7 @@
 
 struct i2c_master_s;
 struct i2c_msg_s;
+struct i2c_batchop_s;
 struct i2c_ops_s
 {
   CODE int (*transfer)(FAR struct i2c_master_s *dev,
@@ -199,6 +229,10 @@ struct i2c_ops_s
 #ifdef CONFIG_I2C_RESET
   CODE int (*reset)(FAR struct i2c_master_s *dev);
 #endif
+#ifdef CONFIG_I2C_BATCH
+  CODE int (*batch)(FAR struct i2c_master_s *dev,
+                    FAR const struct i2c_batchop_s *ops, int count);
+#endif
 };
 
 /* This structure contains the full state of I2C as needed for a specific
@@ -227,6 +261,21 @@ struct i2c_msg_s
   ssize_t length;             /* Length of the buffer in bytes */
 };
 
+#ifdef CONFIG_I2C_BATCH
+/* One write-then-read register operation of an I2C_BATCH() list */
+
+struct i2c_batchop_s
+{
+  uint32_t frequency;         /* I2C frequency */
+  uint16_t addr;              /* Slave address (7- or 10-bit) */
+  uint16_t flags;             /* I2C_M_TEN or 0 */
+  FAR const uint8_t *wbuffer; /* Bytes written first */
+  FAR uint8_t *rbuffer;       /* Bytes read after a repeated START */
+  uint16_t wlength;           /* Length of wbuffer (at least 1) */
+  uint16_t rlength;           /* Length of rbuffer, or 0 for a write only */
+};
+#endif
+
 /* I2C private data.  This structure only defines the initial fields of the
  * structure visible to the I2C client.  The specific implementation may
  * add additional, device specific fields after the vtable.
@@ -311,6 +360,19 @@ int i2c_writeread(FAR struct i2c_master_s *dev,
                   FAR const uint8_t *wbuffer, int wbuflen,
                   FAR uint8_t *rbuffer, int rbuflen);
 
+/****************************************************************************
+ * Name: i2c_batch
+ *
+ * Description:
+ *   Perform a list of register operations.  See I2C_BATCH().
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_I2C_BATCH
+int i2c_batch(FAR struct i2c_master_s *dev,
+              FAR const struct i2c_batchop_s *ops, int count);
+#endif
+
 /****************************************************************************
  * Name: i2c_write
  *
@@ -57,6 +57,22 @@
 #define OSINIT_OS_READY()        (g_nx_initstate >= OSINIT_OSREADY)
 #define OSINIT_OS_INITIALIZING() (g_nx_initstate  < OSINIT_OSREADY)
 
+/* Boot initcall dependencies:  The bit for the initcall at index 'n' in the
+ * array passed to boot_initcalls().
+ */
+
+#define BOOT_INITCALL_DEP(n)     ((uint32_t)1 << (n))
+#define BOOT_INITCALL_MAX        32
+
+/* Boot profiling is a no-op unless CONFIG_BOOT_PROFILE is selected */
+
+#ifndef CONFIG_BOOT_PROFILE
+#  define boot_time()            0
+#  define boot_record(n,s,e)     ((void)(s))
+#  define boot_mark(n)
+#  define boot_report()
+#endif
+
 /****************************************************************************
  * Public Types
  ****************************************************************************/
@@ -83,6 +99,18 @@ enum nx_initstate_e
                           * active. */
 };
 
+/* One initializer run by boot_initcalls().  'depends' holds the
+ * BOOT_INITCALL_DEP() bits of the initcalls in the same array that must
+ * complete before this one is started.
+ */
+
+struct boot_initcall_s
+{
+  FAR const char *name;          /* Name used in the boot profile */
+  CODE int (*func)(void);        /* The initializer */
+  uint32_t depends;              /* Initcalls that must complete first */
+};
+
 /****************************************************************************
  * Public Data
  ****************************************************************************/
@@ -115,6 +143,70 @@ int CONFIG_USER_ENTRYPOINT(int argc, char *argv[]);
 
 void nx_start(void) noreturn_function;
 
+/* Functions contained in nx_initcall.c *************************************/
+
+/****************************************************************************
+ * Name: boot_initcalls
+ *
+ * Description:
+ *   Run a set of initializers.  Initializers whose dependencies have
+ *   completed run in parallel on up to CONFIG_BOOT_INIT_NTHREADS kernel
+ *   threads in addition to the caller.  With CONFIG_BOOT_INIT_NTHREADS=0,
+ *   they run one after another on the caller's thread, in dependency
+ *   order.  A failing initializer does not stop the others, including
+ *   those that depend on it.
+ *
+ * Input Parameters:
+ *   calls  - The initializers
+ *   ncalls - The number of initializers, at most BOOT_INITCALL_MAX
+ *
+ * Returned Value:
+ *   Zero (OK) if all initializers succeeded; otherwise, the first negative
+ *   value returned by an initializer, or -EINVAL if the dependencies can
+ *   not be satisfied.
+ *
+ ****************************************************************************/
+
+int boot_initcalls(FAR const struct boot_initcall_s *calls, int ncalls);
+
+/* Functions contained in nx_bootprof.c *************************************/
+
+#ifdef CONFIG_BOOT_PROFILE
+/****************************************************************************
+ * Name: boot_time
+ *
+ * Description:
+ *   Return the time since power-up in microseconds.
+ *
+ ****************************************************************************/
+
+uint32_t boot_time(void);
+
+/****************************************************************************
+ * Name: boot_record and boot_mark
+ *
+ * Description:
+ *   Add an entry to the boot profile:  boot_record() adds a phase that
+ *   started at 'start' (from boot_time()) and took 'elapsed' microseconds;
+ *   boot_mark() adds a point in time.  'name' must remain valid.  Entries
+ *   beyond CONFIG_BOOT_PROFILE_NMARKS are dropped.
+ *
+ ****************************************************************************/
+
+void boot_record(FAR const char *name, uint32_t start, uint32_t elapsed);
+void boot_mark(FAR const char *name);
+
+/****************************************************************************
+ * Name: boot_report
+ *
+ * Description:
+ *   Write the boot profile to the syslog.
+ *
+ ****************************************************************************/
+
+void boot_report(void);
+#endif
+
 #undef EXTERN
 #ifdef __cplusplus
 }
@@ -46,6 +46,8 @@
 #ifndef __ASSEMBLY__
 # include <stdint.h>
 # include <assert.h>
+
+# include <nuttx/spinlock.h>
 #endif
 
 /****************************************************************************
@@ -240,9 +242,16 @@ void leave_critical_section(irqstate_t flags);
  *
  * Description:
  *   If SMP and SPINLOCK_IRQ are enabled:
- *     Disable local interrupts and take the global spinlock (g_irq_spin)
- *     if the call counter (g_irq_spin_count[cpu]) equals to 0. Then the
- *     counter on the CPU is increment to allow nested call.
+ *     If the argument lock is not specified (i.e. NULL), disable local
+ *     interrupts and take the global spinlock (g_irq_spin) if the call
+ *     counter (g_irq_spin_count[cpu]) equals to 0. Then the counter on the
+ *     CPU is increment to allow nested call.
+ *
+ *     If the argument lock is specified, disable local interrupts and take
+ *     the lock spinlock.  Such per-object locks do not nest and serialize
+ *     only against other users of the same object, so unrelated hot paths
+ *     on other CPUs are not stalled as they are by the global critical
+ *     section.
  *
  *     NOTE: This API is very simple to protect data (e.g. H/W register
  *     or internal data structure) in SMP mode. But do not use this API
@@ -252,7 +261,7 @@ void leave_critical_section(irqstate_t flags);
  *     This function is equivalent to enter_critical_section().
  *
  * Input Parameters:
- *   None
+ *   lock - Caller specific spinlock, or NULL for the global spinlock.
  *
  * Returned Value:
  *   An opaque, architecture-specific value that represents the state of
@@ -262,9 +271,9 @@ void leave_critical_section(irqstate_t flags);
 
 #if defined(CONFIG_SMP) && defined(CONFIG_SPINLOCK_IRQ) && \
     defined(CONFIG_ARCH_GLOBAL_IRQDISABLE)
-irqstate_t spin_lock_irqsave(void);
+irqstate_t spin_lock_irqsave(FAR spinlock_t *lock);
 #else
-#  define spin_lock_irqsave() enter_critical_section()
+#  define spin_lock_irqsave(l) ((void)(l), enter_critical_section())
 #endif
 
 /****************************************************************************
@@ -272,17 +281,22 @@ irqstate_t spin_lock_irqsave(void);
  *
  * Description:
  *   If SMP and SPINLOCK_IRQ are enabled:
- *     Decrement the call counter (g_irq_spin_count[cpu]) and if it
- *     decrements to zero then release the spinlock (g_irq_spin) and
+ *     If the argument lock is not specified (i.e. NULL), decrement the call
+ *     counter (g_irq_spin_count[cpu]) and if it decrements to zero then
+ *     release the spinlock (g_irq_spin) and restore the interrupt state as
+ *     it was prior to the previous call to spin_lock_irqsave(NULL).
+ *
+ *     If the argument lock is specified, release the lock spinlock and
  *     restore the interrupt state as it was prior to the previous call to
- *     spin_lock_irqsave().
+ *     spin_lock_irqsave(lock).
  *
  *   If SMP and SPINLOCK_IRQ are not enabled:
  *     This function is equivalent to leave_critical_section().
  *
  * Input Parameters:
+ *   lock  - Caller specific spinlock, or NULL for the global spinlock.
  *   flags - The architecture-specific value that represents the state of
- *           the interrupts prior to the call to spin_lock_irqsave();
+ *           the interrupts prior to the call to spin_lock_irqsave(lock);
  *
  * Returned Value:
  *   None
@@ -291,9 +305,10 @@ irqstate_t spin_lock_irqsave(void);
 
 #if defined(CONFIG_SMP) && defined(CONFIG_SPINLOCK_IRQ) && \
     defined(CONFIG_ARCH_GLOBAL_IRQDISABLE)
-void spin_unlock_irqrestore(irqstate_t flags);
+void spin_unlock_irqrestore(FAR spinlock_t *lock, irqstate_t flags);
 #else
-#  define spin_unlock_irqrestore(f) leave_critical_section(f)
+#  define spin_unlock_irqrestore(l, f) \
+     do { (void)(l); leave_critical_section(f); } while (0)
 #endif
 
 #undef EXTERN
@@ -0,0 +1,136 @@
+/****************************************************************************
+ * include/nuttx/kbench.h
+ *
+ *   Copyright (C) 2020 Gregory Nutt. All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in
+ *    the documentation and/or other materials provided with the
+ *    distribution.
+ * 3. Neither the name NuttX nor the names of its contributors may be
+ *    used to endorse or promote products derived from this software
+ *    without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+ * FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE
+ * COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+ * INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,
+ * BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS
+ * OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED
+ * AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ * LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN
+ * ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ *
+ ****************************************************************************/
+
+#ifndef __INCLUDE_NUTTX_KBENCH_H
+#define __INCLUDE_NUTTX_KBENCH_H
+
+/****************************************************************************
+ * Included Files
+ ****************************************************************************/
+
+#include <nuttx/config.h>
+
+#include <stdint.h>
+
+#ifdef CONFIG_SCHED_BENCHMARK
+
+/****************************************************************************
+ * Public Types
+ ****************************************************************************/
+
+/* The micro-benchmarks run by kbench_run() */
+
+enum kbench_test_e
+{
+  KBENCH_CTXSW = 0,         /* sched_yield() between two threads, one CPU */
+  KBENCH_SEMPINGPONG,       /* Semaphore round trip, threads on one CPU */
+  KBENCH_SEMPINGPONG_XCPU,  /* Semaphore round trip across two CPUs */
+  KBENCH_MUTEX,             /* Uncontended mutex lock and unlock */
+  KBENCH_MUTEX_CONTENDED,   /* Mutex lock that has to wait for the owner */
+  KBENCH_MQUEUE,            /* mq_send() and mq_receive() of one message */
+  KBENCH_MALLOC,            /* kmm_malloc() and kmm_free() of one block */
+  KBENCH_TIMER,             /* Jitter of a periodic watchdog timer */
+  KBENCH_PIPE,              /* Pipe throughput between two threads */
+  KBENCH_LOCAL,             /* Local stream socket throughput */
+  KBENCH_UDP,               /* UDP loopback throughput */
+  KBENCH_TCP,               /* TCP loopback throughput */
+  KBENCH_NTESTS
+};
+
+/* The result of one benchmark.  Every benchmark times a number of
+ * operations.  The throughput benchmarks time the transfer of each chunk
+ * of data and also report the throughput of the whole transfer.
+ */
+
+struct kbench_result_s
+{
+  uint32_t kr_count;        /* Number of operations timed */
+  uint32_t kr_min;          /* Shortest operation (ns) */
+  uint32_t kr_avg;          /* Average operation (ns) */
+  uint32_t kr_max;          /* Longest operation (ns) */
+  uint32_t kr_kbps;         /* Throughput (KiB/s), zero if not applicable */
+};
+
+/****************************************************************************
+ * Public Function Prototypes
+ ****************************************************************************/
+
+#ifdef __cplusplus
+#define EXTERN extern "C"
+extern "C"
+{
+#else
+#define EXTERN extern
+#endif
+
+/****************************************************************************
+ * Name: kbench_run
+ *
+ * Description:
+ *   Run one micro-benchmark of a kernel primitive.  The helper threads of
+ *   a benchmark run at CONFIG_SCHED_BENCHMARK_PRIORITY; they are pinned to
+ *   one CPU or to two different CPUs in SMP configurations, as the
+ *   benchmark requires.
+ *
+ *   Only one benchmark may run at a time; concurrent callers wait.
+ *
+ * Input Parameters:
+ *   test   - The benchmark to run
+ *   result - Location to return the result
+ *
+ * Returned Value:
+ *   Zero (OK) on success; a negated errno value on failure.  -ENOSYS is
+ *   returned if the primitive under test is not part of the configuration.
+ *
+ ****************************************************************************/
+
+int kbench_run(enum kbench_test_e test, FAR struct kbench_result_s *result);
+
+/****************************************************************************
+ * Name: kbench_name
+ *
+ * Description:
+ *   Return a short name for a benchmark, for reports.
+ *
+ ****************************************************************************/
+
+FAR const char *kbench_name(enum kbench_test_e test);
+
+#undef EXTERN
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* CONFIG_SCHED_BENCHMARK */
+#endif /* __INCLUDE_NUTTX_KBENCH_H */
@@ -82,6 +82,22 @@ struct lcd_planeinfo_s
   int (*putrun)(fb_coord_t row, fb_coord_t col, FAR const uint8_t *buffer,
                 size_t npixels);
 
+  /* This method can be used to write a rectangular area to the LCD in a
+   * single transfer.  It is optional and may be NULL, in which case the
+   * area is written one putrun() per row:
+   *
+   *  row_start - Starting row to write to (range: 0 <= row_start < yres)
+   *  row_end   - Ending row to write to (range: row_start <= row_end < yres)
+   *  col_start - Starting column (range: 0 <= col_start < xres)
+   *  col_end   - Ending column (range: col_start <= col_end < xres)
+   *  buffer    - The first pixel of the area to be written to the LCD
+   *  stride    - The distance between rows in the buffer in bytes
+   */
+
+  int (*putarea)(fb_coord_t row_start, fb_coord_t row_end,
+                 fb_coord_t col_start, fb_coord_t col_end,
+                 FAR const uint8_t *buffer, fb_coord_t stride);
+
   /* This method can be used to read a partial raster line from the LCD:
    *
    *  row     - Starting row to read from (range: 0 <= row < yres)
@@ -83,6 +83,8 @@
 #include <nuttx/config.h>
 #include <nuttx/compiler.h>
 
+#include <stddef.h>
+
 /****************************************************************************
  * Pre-processor Definitions
  ****************************************************************************/
@@ -343,6 +345,14 @@ double      atan2 (double y, double x);
 long double atan2l(long double y, long double x);
 #endif
 
+#ifdef CONFIG_LIBM_FAST
+void        sincosf(float x, FAR float *s, FAR float *c);
+void        sincosf_array(FAR const float *x, FAR float *s, FAR float *c,
+                          size_t n);
+void        atan2f_array(FAR const float *y, FAR const float *x,
+                         FAR float *r, size_t n);
+#endif
+
 float       sinhf (float x);
 #ifdef CONFIG_HAVE_DOUBLE
 double      sinh  (double x);
@@ -43,6 +43,7 @@
 #include <nuttx/config.h>
 
 #include <sys/types.h>
+#include <stdbool.h>
 #include <elf32.h>
 
 #include <nuttx/arch.h>
@@ -214,6 +215,17 @@ struct mod_loadinfo_s
   uint16_t          strtabidx;   /* String table section index */
   uint16_t          buflen;      /* size of iobuffer[] */
   int               filfd;       /* Descriptor for the file being loaded */
+
+  /* Prelink cache of the resolved values of the imported symbols */
+
+#ifdef CONFIG_MODLIB_PRELINK
+  FAR const char   *filename;    /* Path to the module file */
+  FAR Elf32_Word   *prelink;     /* Resolved value of each symbol */
+  uint32_t          nprelink;    /* Number of entries in prelink[] */
+  uint32_t          prelinkhash; /* Hash of the module symbols */
+  bool              prelinked;   /* prelink[] was read from the cache */
+  bool              modimports;  /* Symbols were imported from modules */
+#endif
 };
 
 /****************************************************************************
@@ -0,0 +1,150 @@
+/****************************************************************************
+ * include/nuttx/mm/benchmark.h
+ *
+ *   Copyright (C) 2020 Gregory Nutt. All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in
+ *    the documentation and/or other materials provided with the
+ *    distribution.
+ * 3. Neither the name NuttX nor the names of its contributors may be
+ *    used to endorse or promote products derived from this software
+ *    without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+ * FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE
+ * COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+ * INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,
+ * BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS
+ * OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED
+ * AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ * LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN
+ * ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ *
+ ****************************************************************************/
+#ifndef __INCLUDE_NUTTX_MM_BENCHMARK_H
+#define __INCLUDE_NUTTX_MM_BENCHMARK_H
+
+/****************************************************************************
+ * Included Files
+ ****************************************************************************/
+
+#include <nuttx/config.h>
+
+#include <stdint.h>
+
+#include <nuttx/mm/mm.h>
+
+#ifdef CONFIG_MM_BENCHMARK
+
+/****************************************************************************
+ * Public Types
+ ****************************************************************************/
+
+/* The synthetic allocation traces run by mm_benchmark() */
+
+enum mm_benchtrace_e
+{
+  MM_BENCH_FIXED = 0,       /* Random malloc/free of one block size */
+  MM_BENCH_POWERLAW,        /* Random malloc/free, power-law block sizes */
+  MM_BENCH_PRODCONS,        /* Allocated by one thread, freed by another */
+  MM_BENCH_REALLOC,         /* Buffers grown in steps with realloc */
+  MM_BENCH_NTRACES
+};
+
+/* The operations that are timed */
+
+enum mm_benchop_e
+{
+  MM_BENCHOP_MALLOC = 0,
+  MM_BENCHOP_FREE,
+  MM_BENCHOP_REALLOC,
+  MM_BENCHOP_NOPS
+};
+
+/* Latency of one kind of operation.  All times are in nanoseconds. */
+
+struct mm_benchstat_s
+{
+  uint32_t bs_nops;         /* Number of operations timed */
+  uint32_t bs_p50;          /* Median latency */
+  uint32_t bs_p99;          /* 99th percentile latency */
+  uint32_t bs_max;          /* Worst case latency */
+};
+
+/* The result of one trace */
+
+struct mm_benchresult_s
+{
+  struct mm_benchstat_s br_stat[MM_BENCHOP_NOPS];
+  uint32_t br_nfail;        /* Number of allocations that failed */
+  uint16_t br_frag;         /* Fragmentation at the end of the trace */
+};
+
+/****************************************************************************
+ * Public Function Prototypes
+ ****************************************************************************/
+
+#ifdef __cplusplus
+#define EXTERN extern "C"
+extern "C"
+{
+#else
+#define EXTERN extern
+#endif
+
+/****************************************************************************
+ * Name: mm_benchmark
+ *
+ * Description:
+ *   Run one synthetic allocation trace on a heap and report the latency
+ *   of each kind of operation and the fragmentation of the heap.  The
+ *   trace is deterministic so that runs before and after a change to the
+ *   allocator may be compared.
+ *
+ *   The fragmentation is measured while the working set of the trace is
+ *   still allocated.  It is 1 - (largest free chunk / total free memory),
+ *   in thousandths:  Zero means that all free memory is contiguous.
+ *
+ *   Only one trace may run at a time; concurrent callers wait.
+ *
+ * Input Parameters:
+ *   heap   - The heap to exercise
+ *   trace  - The trace to run
+ *   result - Location to return the result
+ *
+ * Returned Value:
+ *   Zero (OK) on success; a negated errno value on failure.
+ *
+ ****************************************************************************/
+
+int mm_benchmark(FAR struct mm_heap_s *heap, enum mm_benchtrace_e trace,
+                 FAR struct mm_benchresult_s *result);
+
+/****************************************************************************
+ * Name: mm_benchname
+ *
+ * Description:
+ *   Return a short name for a trace or an operation, for reports.
+ *
+ ****************************************************************************/
+
+FAR const char *mm_benchname(enum mm_benchtrace_e trace);
+FAR const char *mm_benchopname(enum mm_benchop_e op);
+
+#undef EXTERN
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* CONFIG_MM_BENCHMARK */
+#endif /* __INCLUDE_NUTTX_MM_BENCHMARK_H */
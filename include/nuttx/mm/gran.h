@@ -75,10 +75,11 @@ typedef FAR void *GRAN_HANDLE;
 
 struct graninfo_s
 {
-  uint8_t   log2gran;  /* Log base 2 of the size of one granule */
-  uint16_t  ngranules; /* The total number of (aligned) granules in the heap */
-  uint16_t  nfree;     /* The number of free granules */
-  uint16_t  mxfree;    /* The longest sequence of free granules */
+  uint8_t   log2gran;   /* Log base 2 of the size of one granule */
+  uint16_t  ngranules;  /* The total number of (aligned) granules in the heap */
+  uint16_t  nfree;      /* The number of free granules */
+  uint16_t  mxfree;     /* The longest sequence of free granules */
+  uint16_t  nfragments; /* The number of separate sequences of free granules */
 };
 
 /****************************************************************************
@@ -124,10 +125,6 @@ extern "C"
  *   The actual memory allocates will be 64 byte (wasting 17 bytes) and
  *   will be aligned at least to (1 << log2align).
  *
- *   NOTE: The current implementation also restricts the maximum allocation
- *   size to 32 granules.  That restriction could be eliminated with some
- *   additional coding effort.
- *
  * Input Parameters:
  *   heapstart - Start of the granule allocation heap
  *   heapsize  - Size of heap in bytes
@@ -196,9 +193,8 @@ void gran_reserve(GRAN_HANDLE handle, uintptr_t start, size_t size);
  * Description:
  *   Allocate memory from the granule heap.
  *
- *   NOTE: The current implementation also restricts the maximum allocation
- *   size to 32 granules.  That restriction could be eliminated with some
- *   additional coding effort.
+ *   The search starts where the last allocation of the same power of two
+ *   size ended ("next fit") and wraps around to the beginning of the heap.
  *
  * Input Parameters:
  *   handle - The handle previously returned by gran_initialize
@@ -233,15 +229,16 @@ void gran_free(GRAN_HANDLE handle, FAR void *memory, size_t size);
  * Name: gran_info
  *
  * Description:
- *   Return information about the granule heap.
+ *   Return information about the granule heap.  If mxfree is much smaller
+ *   than nfree, or nfragments is large, then the heap is fragmented and
+ *   large allocations may fail even though there is enough free memory.
  *
  * Input Parameters:
  *   handle - The handle previously returned by gran_initialize
  *   info   - Memory location to return the gran allocator info.
  *
  * Returned Value:
- *   Zero (OK) is returned on success; a negated errno value is return on
- *   any failure.
+ *   None
  *
  ****************************************************************************/
 
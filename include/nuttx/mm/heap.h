@@ -0,0 +1,164 @@
+/****************************************************************************
+ * include/nuttx/mm/heap.h
+ *
+ *   Copyright (C) 2020 Gregory Nutt. All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in
+ *    the documentation and/or other materials provided with the
+ *    distribution.
+ * 3. Neither the name NuttX nor the names of its contributors may be
+ *    used to endorse or promote products derived from this software
+ *    without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+ * FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE
+ * COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+ * INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,
+ * BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS
+ * OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED
+ * AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ * LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN
+ * ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ *
+ ****************************************************************************/
+
+#ifndef __INCLUDE_NUTTX_MM_HEAP_H
+#define __INCLUDE_NUTTX_MM_HEAP_H
+
+/****************************************************************************
+ * Included Files
+ ****************************************************************************/
+
+#include <nuttx/config.h>
+
+#include <sys/types.h>
+
+#include <nuttx/mm/mm.h>
+
+#ifdef CONFIG_MM_NAMED_HEAPS
+
+/****************************************************************************
+ * Pre-processor Definitions
+ ****************************************************************************/
+
+/* Allocation policies that may be passed to heap_malloc() in place of the
+ * ID of a specific heap.
+ *
+ * HEAP_DEFAULT - Allocate from the standard user heap.
+ * HEAP_LOCAL   - Allocate from a heap with affinity to the calling CPU.  If
+ *                there is no such heap or it is exhausted, fall back to
+ *                the other named heaps and finally to the user heap.
+ */
+
+#define HEAP_DEFAULT  (-1)
+#define HEAP_LOCAL    (-2)
+
+/****************************************************************************
+ * Public Function Prototypes
+ ****************************************************************************/
+
+#ifdef __cplusplus
+#define EXTERN extern "C"
+extern "C"
+{
+#else
+#define EXTERN extern
+#endif
+
+/****************************************************************************
+ * Name: heap_register
+ *
+ * Description:
+ *   Initialize a heap on the memory region and register it under a name
+ *   so that it can be selected with heap_malloc().  This is normally
+ *   called once during the platform heap set-up.
+ *
+ * Input Parameters:
+ *   name     - The name of the heap.  The string is not copied.
+ *   heap     - The heap structure.  It is initialized by this function.
+ *   start    - Start of the memory region managed by the heap
+ *   size     - Size of the memory region
+ *   affinity - The set of CPUs that the memory is nearest to.  Used by
+ *              the HEAP_LOCAL policy.
+ *
+ * Returned Value:
+ *   The non-negative ID of the heap on success; a negated errno value on
+ *   failure.
+ *
+ ****************************************************************************/
+
+int heap_register(FAR const char *name, FAR struct mm_heap_s *heap,
+                  FAR void *start, size_t size, cpu_set_t affinity);
+
+/****************************************************************************
+ * Name: heap_find
+ *
+ * Description:
+ *   Look up a named heap.
+ *
+ * Input Parameters:
+ *   name - The name that was given to heap_register()
+ *
+ * Returned Value:
+ *   The non-negative ID of the heap on success; -ENOENT if there is no
+ *   heap with that name.
+ *
+ ****************************************************************************/
+
+int heap_find(FAR const char *name);
+
+/****************************************************************************
+ * Name: heap_malloc and heap_memalign
+ *
+ * Description:
+ *   Allocate memory from a named heap or according to a policy.  A heap
+ *   ID returned by heap_register() or heap_find() selects exactly that
+ *   heap.  HEAP_DEFAULT and HEAP_LOCAL select a placement policy.
+ *
+ * Input Parameters:
+ *   heapid    - The heap ID or policy
+ *   alignment - The required alignment (heap_memalign() only)
+ *   size      - The size of the allocation
+ *
+ * Returned Value:
+ *   The allocated memory or NULL on failure.
+ *
+ ****************************************************************************/
+
+FAR void *heap_malloc(int heapid, size_t size);
+FAR void *heap_memalign(int heapid, size_t alignment, size_t size);
+
+/****************************************************************************
+ * Name: heap_free
+ *
+ * Description:
+ *   Free memory allocated with heap_malloc() or heap_memalign().  The heap
+ *   is found from the address of the memory.
+ *
+ * Input Parameters:
+ *   mem - The memory to free
+ *
+ * Returned Value:
+ *   None
+ *
+ ****************************************************************************/
+
+void heap_free(FAR void *mem);
+
+#undef EXTERN
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* CONFIG_MM_NAMED_HEAPS */
+#endif /* __INCLUDE_NUTTX_MM_HEAP_H */
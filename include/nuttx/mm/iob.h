@@ -84,10 +84,52 @@
 #  error CONFIG_IOB_NBUFFERS <= CONFIG_IOB_THROTTLE
 #endif
 
+/* Larger I/O buffer classes.  Class zero is the pool of CONFIG_IOB_BUFSIZE
+ * buffers; the optional MTU and jumbo classes hold a whole frame in one
+ * buffer.
+ */
+
+#define IOB_CLASS_SMALL  0  /* CONFIG_IOB_BUFSIZE, shares g_iob_sem */
+#ifdef CONFIG_IOB_LARGE
+#  define IOB_CLASS_MTU  1  /* CONFIG_IOB_MTU_BUFSIZE */
+#  define IOB_CLASS_JUMBO 2 /* CONFIG_IOB_JUMBO_BUFSIZE */
+#  define IOB_NCLASSES   3
+
+#  ifndef CONFIG_IOB_NMTU
+#    define CONFIG_IOB_NMTU 0
+#  endif
+
+#  ifndef CONFIG_IOB_MTU_BUFSIZE
+#    define CONFIG_IOB_MTU_BUFSIZE 1536
+#  endif
+
+#  ifndef CONFIG_IOB_NJUMBO
+#    define CONFIG_IOB_NJUMBO 0
+#  endif
+
+#  ifndef CONFIG_IOB_JUMBO_BUFSIZE
+#    define CONFIG_IOB_JUMBO_BUFSIZE 9018
+#  endif
+
+#  if CONFIG_IOB_MTU_BUFSIZE <= CONFIG_IOB_BUFSIZE
+#    error CONFIG_IOB_MTU_BUFSIZE must be larger than CONFIG_IOB_BUFSIZE
+#  endif
+
+#  if CONFIG_IOB_JUMBO_BUFSIZE <= CONFIG_IOB_MTU_BUFSIZE
+#    error CONFIG_IOB_JUMBO_BUFSIZE must be larger than CONFIG_IOB_MTU_BUFSIZE
+#  endif
+#endif
+
 /* IOB helpers */
 
+#ifdef CONFIG_IOB_LARGE
+#  define IOB_BUFSIZE(p) ((p)->io_bufsize)
+#else
+#  define IOB_BUFSIZE(p) CONFIG_IOB_BUFSIZE
+#endif
+
 #define IOB_DATA(p)      (&(p)->io_data[(p)->io_offset])
-#define IOB_FREESPACE(p) (CONFIG_IOB_BUFSIZE - (p)->io_len - (p)->io_offset)
+#define IOB_FREESPACE(p) (IOB_BUFSIZE(p) - (p)->io_len - (p)->io_offset)
 
 #if CONFIG_IOB_NCHAINS > 0
 /* Queue helpers */
@@ -113,7 +155,7 @@ struct iob_s
 
   /* Payload */
 
-#if CONFIG_IOB_BUFSIZE < 256
+#if CONFIG_IOB_BUFSIZE < 256 && !defined(CONFIG_IOB_LARGE)
   uint8_t  io_len;      /* Length of the data in the entry */
   uint8_t  io_offset;   /* Data begins at this offset */
 #else
@@ -122,7 +164,13 @@ struct iob_s
 #endif
   uint16_t io_pktlen;   /* Total length of the packet */
 
+#ifdef CONFIG_IOB_LARGE
+  uint8_t  io_class;    /* Size class the buffer belongs to */
+  uint16_t io_bufsize;  /* Size of the io_data buffer */
+  FAR uint8_t *io_data; /* Payload storage, reserved at initialization */
+#else
   uint8_t  io_data[CONFIG_IOB_BUFSIZE];
+#endif
 };
 
 #if CONFIG_IOB_NCHAINS > 0
@@ -202,6 +250,9 @@ enum iob_user_e
 #ifdef CONFIG_NET_IPFORWARD
   IOBUSER_NET_IPFORWARD,
 #endif
+#ifdef CONFIG_NETDEV_RXQUEUE
+  IOBUSER_NET_RXQUEUE,
+#endif
 #ifdef CONFIG_WIRELESS_IEEE802154
   IOBUSER_WIRELESS_RAD802154,
 #endif
@@ -265,6 +316,71 @@ FAR struct iob_s *iob_alloc(bool throttled, enum iob_user_e consumerid);
 
 FAR struct iob_s *iob_tryalloc(bool throttled, enum iob_user_e consumerid);
 
+/****************************************************************************
+ * Name: iob_alloc_size
+ *
+ * Description:
+ *   Allocate an I/O buffer suitable for holding 'size' bytes.  If
+ *   CONFIG_IOB_LARGE is enabled and 'size' exceeds CONFIG_IOB_BUFSIZE, the
+ *   smallest larger class that can hold 'size' is preferred, then any
+ *   larger class with a free buffer.  Otherwise, or if no larger buffer is
+ *   free, this behaves like iob_alloc() and the caller must chain buffers as
+ *   usual.  Use IOB_BUFSIZE() to find the capacity of the buffer returned.
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_IOB_LARGE
+FAR struct iob_s *iob_alloc_size(unsigned int size, bool throttled,
+                                 enum iob_user_e consumerid);
+#else
+#  define iob_alloc_size(s,t,c) iob_alloc(t,c)
+#endif
+
+/****************************************************************************
+ * Name: iob_tryalloc_size
+ *
+ * Description:
+ *   Try to allocate an I/O buffer suitable for holding 'size' bytes without
+ *   waiting.  The class is selected as for iob_alloc_size().
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_IOB_LARGE
+FAR struct iob_s *iob_tryalloc_size(unsigned int size, bool throttled,
+                                    enum iob_user_e consumerid);
+#else
+#  define iob_tryalloc_size(s,t,c) iob_tryalloc(t,c)
+#endif
+
+/****************************************************************************
+ * Name: iob_tryalloc_batch
+ *
+ * Description:
+ *   Try to allocate a chain of 'n' I/O buffers with a single critical
+ *   section and a single adjustment of the IOB counting semaphores.  The
+ *   allocation is all-or-nothing:  NULL is returned without waiting if
+ *   fewer than 'n' buffers are available.  The buffers are linked through
+ *   io_flink and each is in the same state as returned by iob_tryalloc().
+ *
+ ****************************************************************************/
+
+FAR struct iob_s *iob_tryalloc_batch(int n, bool throttled,
+                                     enum iob_user_e consumerid);
+
+/****************************************************************************
+ * Name: iob_alloc_batch
+ *
+ * Description:
+ *   Allocate a chain of 'n' I/O buffers.  The batch is taken in one step
+ *   with iob_tryalloc_batch() when possible; otherwise the buffers are
+ *   allocated one at a time, waiting as iob_alloc() does.  NULL is returned
+ *   (and no buffers are held) if the chain could not be completed.
+ *
+ ****************************************************************************/
+
+FAR struct iob_s *iob_alloc_batch(int n, bool throttled,
+                                  enum iob_user_e consumerid);
+
 /****************************************************************************
  * Name: iob_navail
  *
@@ -362,6 +478,19 @@ int iob_notifier_teardown(int key);
 
 void iob_free_chain(FAR struct iob_s *iob, enum iob_user_e producerid);
 
+/****************************************************************************
+ * Name: iob_free_batch
+ *
+ * Description:
+ *   Free an entire buffer chain, returning all of its I/O buffers to the
+ *   free list with a single critical section.  Buffers needed by waiting
+ *   tasks are handed over through the committed list first; the remainder
+ *   are spliced onto the free list with one semaphore count adjustment.
+ *
+ ****************************************************************************/
+
+void iob_free_batch(FAR struct iob_s *iob, enum iob_user_e producerid);
+
 /****************************************************************************
  * Name: iob_add_queue
  *
@@ -489,11 +618,14 @@ int iob_clone(FAR struct iob_s *iob1, FAR struct iob_s *iob2, bool throttled,
  * Name: iob_concat
  *
  * Description:
- *   Concatenate iob_s chain iob2 to iob1.
+ *   Concatenate iob_s chain iob2 to iob1.  Leading buffers of iob2 whose
+ *   data fits in the free space of the last buffer of iob1 are copied into
+ *   it and freed.
  *
  ****************************************************************************/
 
-void iob_concat(FAR struct iob_s *iob1, FAR struct iob_s *iob2);
+void iob_concat(FAR struct iob_s *iob1, FAR struct iob_s *iob2,
+                enum iob_user_e producerid);
 
 /****************************************************************************
  * Name: iob_trimhead
@@ -0,0 +1,206 @@
+/****************************************************************************
+ * include/nuttx/mm/mempool.h
+ *
+ *   Copyright (C) 2020 Gregory Nutt. All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in
+ *    the documentation and/or other materials provided with the
+ *    distribution.
+ * 3. Neither the name NuttX nor the names of its contributors may be
+ *    used to endorse or promote products derived from this software
+ *    without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+ * FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE
+ * COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+ * INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,
+ * BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS
+ * OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED
+ * AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ * LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN
+ * ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ *
+ ****************************************************************************/
+
+#ifndef __INCLUDE_NUTTX_MM_MEMPOOL_H
+#define __INCLUDE_NUTTX_MM_MEMPOOL_H
+
+/****************************************************************************
+ * Included Files
+ ****************************************************************************/
+
+#include <nuttx/config.h>
+
+#include <sys/types.h>
+#include <stdbool.h>
+#include <queue.h>
+
+#include <nuttx/spinlock.h>
+
+/****************************************************************************
+ * Public Types
+ ****************************************************************************/
+
+/* This structure describes one pool of fixed-size blocks.  The first group
+ * of fields must be set up by the owner of the pool before the pool is
+ * passed to mempool_initialize().  The remaining fields are private to the
+ * mempool logic.
+ *
+ * The first sizeof(sq_entry_t) bytes of each free block are used to link it
+ * into the free list.  The blocks are otherwise untouched by the pool.
+ */
+
+struct mempool_s
+{
+  /* Configuration provided by the owner of the pool */
+
+  size_t bsize;                 /* Size of one block in bytes */
+  size_t ninitial;              /* Number of pre-allocated blocks */
+  size_t nreserve;              /* Pre-allocated blocks reserved for interrupt
+                                 * handlers */
+  bool expand;                  /* True: Fall back to the kernel heap when no
+                                 * unreserved block is available */
+  FAR void *ibase;              /* Storage for the pre-allocated blocks.  If
+                                 * NULL, this is allocated from the kernel
+                                 * heap by mempool_initialize() */
+
+  /* Private data */
+
+  FAR const char *name;         /* Name of the pool (for procfs) */
+  FAR struct mempool_s *flink;  /* Supports a list of all pools */
+  FAR char *iend;               /* End of the pre-allocated blocks */
+  spinlock_t lock;              /* Protects the free list and the counts */
+  sq_queue_t freelist;          /* List of free, pre-allocated blocks */
+  size_t nfree;                 /* Number of blocks in freelist */
+  size_t nused;                 /* Number of blocks in use */
+  size_t nheap;                 /* Number of in-use blocks from the heap */
+  size_t nmaxused;              /* Peak value of nused */
+  size_t nfail;                 /* Number of failed allocations */
+};
+
+/* This structure is returned by mempool_info() */
+
+struct mempoolinfo_s
+{
+  size_t bsize;                 /* Size of one block in bytes */
+  size_t ninitial;              /* Number of pre-allocated blocks */
+  size_t nreserve;              /* Number of reserved blocks */
+  size_t nfree;                 /* Number of free, pre-allocated blocks */
+  size_t nused;                 /* Number of blocks in use */
+  size_t nheap;                 /* Number of in-use blocks from the heap */
+  size_t nmaxused;              /* Peak number of blocks in use */
+  size_t nfail;                 /* Number of failed allocations */
+};
+
+/* Callback used by mempool_foreach() */
+
+typedef CODE void (*mempool_handler_t)(FAR struct mempool_s *pool,
+                                       FAR void *arg);
+
+/****************************************************************************
+ * Public Function Prototypes
+ ****************************************************************************/
+
+#ifdef __cplusplus
+#define EXTERN extern "C"
+extern "C"
+{
+#else
+#define EXTERN extern
+#endif
+
+/****************************************************************************
+ * Name: mempool_initialize
+ *
+ * Description:
+ *   Initialize a pool of fixed-size blocks.  The caller must have set up
+ *   the bsize, ninitial, nreserve, expand and ibase fields of the pool
+ *   structure.  The pool is added to the list of pools reported by procfs.
+ *
+ * Input Parameters:
+ *   pool - The pool to be initialized
+ *   name - The name of the pool.  This string must persist for the
+ *          lifetime of the pool.
+ *
+ * Returned Value:
+ *   Zero (OK) is returned on success; a negated errno value is returned on
+ *   any failure.
+ *
+ ****************************************************************************/
+
+int mempool_initialize(FAR struct mempool_s *pool, FAR const char *name);
+
+/****************************************************************************
+ * Name: mempool_alloc
+ *
+ * Description:
+ *   Allocate one block from the pool.  Interrupt handlers may take blocks
+ *   from the reserve; normal tasks may only take unreserved blocks and may
+ *   fall back to the kernel heap if the pool was configured to expand.
+ *
+ * Input Parameters:
+ *   pool - The pool to allocate from
+ *
+ * Returned Value:
+ *   The allocated block or NULL if no block is available.
+ *
+ ****************************************************************************/
+
+FAR void *mempool_alloc(FAR struct mempool_s *pool);
+
+/****************************************************************************
+ * Name: mempool_free
+ *
+ * Description:
+ *   Return a block to the pool it was allocated from.  This may be called
+ *   from interrupt handlers.
+ *
+ * Input Parameters:
+ *   pool - The pool that the block was allocated from
+ *   blk  - The block to be freed
+ *
+ * Returned Value:
+ *   None
+ *
+ ****************************************************************************/
+
+void mempool_free(FAR struct mempool_s *pool, FAR void *blk);
+
+/****************************************************************************
+ * Name: mempool_info
+ *
+ * Description:
+ *   Return a snapshot of the pool statistics.
+ *
+ ****************************************************************************/
+
+void mempool_info(FAR struct mempool_s *pool,
+                  FAR struct mempoolinfo_s *info);
+
+/****************************************************************************
+ * Name: mempool_foreach
+ *
+ * Description:
+ *   Call the handler for every initialized pool, in the order in which
+ *   they were initialized.
+ *
+ ****************************************************************************/
+
+void mempool_foreach(mempool_handler_t handler, FAR void *arg);
+
+#undef EXTERN
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* __INCLUDE_NUTTX_MM_MEMPOOL_H */
@@ -162,6 +162,96 @@
 #define MM_MAX_CHUNK     (1 << MM_MAX_SHIFT)
 #define MM_NNODES        (MM_MAX_SHIFT - MM_MIN_SHIFT + 1)
 
+/* Two-level segregated fit (TLSF) index.  When CONFIG_MM_TLSF is selected,
+ * each power-of-two size class (the first level) is further divided into
+ * MM_SL_COUNT equally sized sub-bins (the second level).  Each bin has its
+ * own free list and a bitmap records which bins are non-empty so that the
+ * best-fitting, non-empty bin can be located with a couple of bit-scan
+ * operations, independent of the number of free chunks.
+ */
+
+#ifdef CONFIG_MM_TLSF
+#  define MM_SL_SHIFT    CONFIG_MM_TLSF_SLBITS
+#else
+#  define MM_SL_SHIFT    0
+#endif
+
+#define MM_SL_COUNT      (1 << MM_SL_SHIFT)
+#define MM_SL_MASK       (MM_SL_COUNT - 1)
+#define MM_NBINS         (MM_NNODES << MM_SL_SHIFT)
+
+/* Per-CPU cache of small chunks.  If CONFIG_MM_PERCPU_CACHE is selected,
+ * then each CPU keeps a few recently freed chunks of each small size class
+ * (up to MM_CACHE_MAXCHUNK bytes, including the allocation node header).
+ */
+
+#ifdef CONFIG_MM_PERCPU_CACHE
+#  define MM_CACHE_MAXCHUNK \
+     MM_ALIGN_UP(CONFIG_MM_CACHE_MAXSIZE + SIZEOF_MM_ALLOCNODE)
+#  define MM_CACHE_NCLASSES (MM_CACHE_MAXCHUNK >> MM_MIN_SHIFT)
+#  define MM_CACHE_BATCH    ((CONFIG_MM_CACHE_DEPTH + 1) / 2)
+#  ifdef CONFIG_SMP
+#    define MM_CACHE_NCPUS  CONFIG_SMP_NCPUS
+#  else
+#    define MM_CACHE_NCPUS  1
+#  endif
+#endif
+
+/* Heap profiling.  If CONFIG_MM_HEAP_PROFILE is selected, then each
+ * allocated chunk records the PID of the allocating task and the return
+ * addresses of the first MM_BACKTRACE_DEPTH callers.  Per-task allocation
+ * statistics are kept in a small table in the heap structure indexed by
+ * a hash of the PID in the same way as the g_pidhash[] table.
+ */
+
+#ifdef CONFIG_MM_HEAP_PROFILE
+#  define MM_BACKTRACE_DEPTH CONFIG_MM_BACKTRACE_DEPTH
+#  define MM_PIDHASH(pid)    ((pid) & (CONFIG_MAX_TASKS - 1))
+
+/* MM_BACKTRACE() records the callers in an allocated node.  It must be
+ * expanded in the allocator function itself.  The first level is available
+ * on all architectures supported by GCC; deeper levels generally require
+ * that the code be built with frame pointers and are NULL otherwise.
+ */
+
+#  ifdef __GNUC__
+#    define MM_CALLER(n)     __builtin_return_address(n)
+#  else
+#    define MM_CALLER(n)     NULL
+#  endif
+
+#  define MM_BT(node, n)     ((node)->backtrace[n] = MM_CALLER(n))
+
+#  if MM_BACKTRACE_DEPTH < 2
+#    define MM_BACKTRACE(node) MM_BT(node, 0)
+#  elif MM_BACKTRACE_DEPTH == 2
+#    define MM_BACKTRACE(node) (MM_BT(node, 0), MM_BT(node, 1))
+#  elif MM_BACKTRACE_DEPTH == 3
+#    define MM_BACKTRACE(node) \
+       (MM_BT(node, 0), MM_BT(node, 1), MM_BT(node, 2))
+#  else
+#    define MM_BACKTRACE(node) \
+       (MM_BT(node, 0), MM_BT(node, 1), MM_BT(node, 2), MM_BT(node, 3))
+#  endif
+
+#  define MM_PROFILE_ALLOC(heap, node) \
+     do \
+       { \
+         MM_BACKTRACE(node); \
+         mm_profile_alloc(heap, node); \
+       } \
+     while (0)
+#  define MM_PROFILE_FREE(heap, node) mm_profile_free(heap, node)
+
+/* The guard nodes at the ends of each region are not owned by any task */
+
+#  define MM_PROFILE_GUARD(node)      ((node)->pid = -1)
+#else
+#  define MM_PROFILE_ALLOC(heap, node)
+#  define MM_PROFILE_FREE(heap, node)
+#  define MM_PROFILE_GUARD(node)
+#endif
+
 #define MM_GRAN_MASK     (MM_MIN_CHUNK-1)
 #define MM_ALIGN_UP(a)   (((a) + MM_GRAN_MASK) & ~MM_GRAN_MASK)
 #define MM_ALIGN_DOWN(a) ((a) & ~MM_GRAN_MASK)
@@ -201,18 +291,41 @@ struct mm_allocnode_s
 {
   mmsize_t size;           /* Size of this chunk */
   mmsize_t preceding;      /* Size of the preceding chunk */
+#ifdef CONFIG_MM_HEAP_PROFILE
+  pid_t pid;               /* PID of the allocating task */
+
+  /* Return addresses of the callers of the allocator */
+
+  FAR void *backtrace[MM_BACKTRACE_DEPTH];
+#endif
 };
 
-/* What is the size of the allocnode? */
+/* What is the size of the allocnode?  SIZEOF_MM_NODEHDR is the size of
+ * the size/preceding pair that is common to allocated and free nodes.
+ */
 
 #ifdef CONFIG_MM_SMALL
-# define SIZEOF_MM_ALLOCNODE   B2C(4)
+# define SIZEOF_MM_NODEHDR     B2C(4)
 #else
-# define SIZEOF_MM_ALLOCNODE   B2C(8)
+# define SIZEOF_MM_NODEHDR     B2C(8)
 #endif
 
-#define CHECK_ALLOCNODE_SIZE \
+#ifdef CONFIG_MM_HEAP_PROFILE
+/* The profiling information must not change the 8-byte alignment of the
+ * allocated memory.  Free nodes do not carry the profiling information.
+ */
+
+# define SIZEOF_MM_ALLOCNODE \
+    ((sizeof(struct mm_allocnode_s) + 7) & ~(size_t)7)
+
+# define CHECK_ALLOCNODE_SIZE \
+  DEBUGASSERT(sizeof(struct mm_allocnode_s) <= SIZEOF_MM_ALLOCNODE)
+#else
+# define SIZEOF_MM_ALLOCNODE   SIZEOF_MM_NODEHDR
+
+# define CHECK_ALLOCNODE_SIZE \
   DEBUGASSERT(sizeof(struct mm_allocnode_s) == SIZEOF_MM_ALLOCNODE)
+#endif
 
 /* This describes a free chunk */
 
@@ -227,11 +340,49 @@ struct mm_freenode_s
 /* What is the size of the freenode? */
 
 #define MM_PTR_SIZE sizeof(FAR struct mm_freenode_s *)
-#define SIZEOF_MM_FREENODE (SIZEOF_MM_ALLOCNODE + 2*MM_PTR_SIZE)
+#define SIZEOF_MM_FREENODE (SIZEOF_MM_NODEHDR + 2*MM_PTR_SIZE)
 
 #define CHECK_FREENODE_SIZE \
   DEBUGASSERT(sizeof(struct mm_freenode_s) == SIZEOF_MM_FREENODE)
 
+#ifdef CONFIG_MM_PERCPU_CACHE
+/* This describes the cache of small chunks of one CPU.  The chunks in the
+ * cache are still marked as allocated in the heap.  They are linked
+ * together through the first pointer of their payload.
+ */
+
+struct mm_cache_s
+{
+  FAR void *mc_head[MM_CACHE_NCLASSES];  /* Cached chunks of each class */
+  uint8_t mc_count[MM_CACHE_NCLASSES];   /* Number of chunks in each list */
+};
+#endif
+
+#ifdef CONFIG_MM_HEAP_PROFILE
+/* This describes the heap usage of one task */
+
+struct mm_taskstats_s
+{
+  pid_t pid;               /* The task that these statistics belong to */
+  size_t nchunks;          /* Number of chunks currently allocated */
+  size_t live;             /* Number of bytes currently allocated */
+  size_t peak;             /* Peak value of 'live' */
+};
+#endif
+
+#ifdef CONFIG_MM_MOVABLE
+/* This describes one movable allocation.  The owner refers to the memory
+ * only through the handle and must lock it with mm_mvlock() while
+ * accessing it.  mm_compact() may move the memory while it is unlocked.
+ */
+
+struct mm_mvhandle_s
+{
+  FAR void *mh_mem;        /* Current address of the memory, NULL if unused */
+  uint16_t mh_lock;        /* Lock count, the memory is movable if zero */
+};
+#endif
+
 /* This describes one heap (possibly with multiple regions) */
 
 struct mm_heap_s
@@ -257,14 +408,58 @@ struct mm_heap_s
   int mm_nregions;
 #endif
 
+#ifdef CONFIG_MM_TLSF
+  /* Each bin of the two-level index has its own, unordered, NULL-terminated
+   * free list.  mm_flbitmap has one bit per first-level size class which
+   * is set if any of its sub-bins is non-empty; mm_slbitmap[] has one bit
+   * per non-empty sub-bin.
+   */
+
+  uint32_t mm_flbitmap;
+  uint16_t mm_slbitmap[MM_NNODES];
+  struct mm_freenode_s mm_nodelist[MM_NBINS];
+#else
   /* All free nodes are maintained in a doubly linked list.  This
    * array provides some hooks into the list at various points to
    * speed searches for free nodes.
    */
 
   struct mm_freenode_s mm_nodelist[MM_NNODES];
+#endif
+
+#ifdef CONFIG_MM_PERCPU_CACHE
+  /* Small chunk caches, one per CPU.  Each is accessed only by its own CPU
+   * with local interrupts disabled.
+   */
+
+  struct mm_cache_s mm_cache[MM_CACHE_NCPUS];
+#endif
+
+#ifdef CONFIG_MM_HEAP_PROFILE
+  /* Per-task allocation statistics, indexed with MM_PIDHASH() */
+
+  struct mm_taskstats_s mm_taskstats[CONFIG_MAX_TASKS];
+#endif
+
+#ifdef CONFIG_MM_MOVABLE
+  /* Handles of the movable allocations.  mm_mvnext is where the next
+   * compaction step continues and mm_mvdirty is set whenever a chunk is
+   * freed and cleared when a compaction pass finds nothing to move.
+   */
+
+  struct mm_mvhandle_s mm_mvhandles[CONFIG_MM_MOVABLE_NHANDLES];
+  int mm_mvnext;
+  bool mm_mvdirty;
+#endif
 };
 
+#ifdef CONFIG_MM_HEAP_PROFILE
+/* This is the type of the callback used by mm_memdump() */
+
+typedef CODE void (*mm_dumphandler_t)(FAR struct mm_allocnode_s *node,
+                                      FAR void *arg);
+#endif
+
 /****************************************************************************
  * Public Data
  ****************************************************************************/
@@ -489,6 +684,36 @@ void umm_extend(FAR void *mem, size_t size, int region);
 void kmm_extend(FAR void *mem, size_t size, int region);
 #endif
 
+/* Functions contained in mm_movable.c **************************************/
+
+#ifdef CONFIG_MM_MOVABLE
+FAR struct mm_mvhandle_s *mm_mvalloc(FAR struct mm_heap_s *heap,
+                                     size_t size);
+void mm_mvfree(FAR struct mm_heap_s *heap,
+               FAR struct mm_mvhandle_s *handle);
+FAR void *mm_mvlock(FAR struct mm_heap_s *heap,
+                    FAR struct mm_mvhandle_s *handle);
+void mm_mvunlock(FAR struct mm_heap_s *heap,
+                 FAR struct mm_mvhandle_s *handle);
+#endif
+
+/* Functions contained in mm_compact.c **************************************/
+
+#ifdef CONFIG_MM_MOVABLE
+size_t mm_compact(FAR struct mm_heap_s *heap, size_t maxbytes);
+#endif
+
+/* Functions contained in umm_movable.c *************************************/
+
+#ifdef CONFIG_MM_MOVABLE
+FAR struct mm_mvhandle_s *umm_mvalloc(size_t size);
+void umm_mvfree(FAR struct mm_mvhandle_s *handle);
+FAR void *umm_mvlock(FAR struct mm_mvhandle_s *handle);
+void umm_mvunlock(FAR struct mm_mvhandle_s *handle);
+size_t umm_compact(size_t maxbytes);
+bool umm_needcompact(void);
+#endif
+
 /* Functions contained in mm_mallinfo.c *************************************/
 
 struct mallinfo; /* Forward reference */
@@ -509,11 +734,48 @@ int kmm_mallinfo(struct mallinfo *info);
 void mm_shrinkchunk(FAR struct mm_heap_s *heap,
                     FAR struct mm_allocnode_s *node, size_t size);
 
+/* Functions contained in mm_malloc.c ***************************************/
+
+FAR struct mm_allocnode_s *mm_mallocchunk(FAR struct mm_heap_s *heap,
+                                          size_t alignsize);
+
+/* Functions contained in mm_free.c *****************************************/
+
+void mm_freechunk(FAR struct mm_heap_s *heap,
+                  FAR struct mm_allocnode_s *chunk);
+
+/* Functions contained in mm_cache.c ****************************************/
+
+#ifdef CONFIG_MM_PERCPU_CACHE
+FAR void *mm_cache_alloc(FAR struct mm_heap_s *heap, size_t alignsize);
+void mm_cache_free(FAR struct mm_heap_s *heap,
+                   FAR struct mm_allocnode_s *node);
+void mm_cache_flush(FAR struct mm_heap_s *heap);
+#endif
+
 /* Functions contained in mm_addfreechunk.c *********************************/
 
 void mm_addfreechunk(FAR struct mm_heap_s *heap,
                      FAR struct mm_freenode_s *node);
 
+/* Functions contained in mm_delfreechunk.c *********************************/
+
+void mm_delfreechunk(FAR struct mm_heap_s *heap,
+                     FAR struct mm_freenode_s *node);
+
+/* Functions contained in mm_profile.c **************************************/
+
+#ifdef CONFIG_MM_HEAP_PROFILE
+void mm_profile_alloc(FAR struct mm_heap_s *heap,
+                      FAR struct mm_allocnode_s *node);
+void mm_profile_free(FAR struct mm_heap_s *heap,
+                     FAR struct mm_allocnode_s *node);
+int mm_taskinfo(FAR struct mm_heap_s *heap, pid_t pid,
+                FAR struct mm_taskstats_s *info);
+void mm_memdump(FAR struct mm_heap_s *heap, mm_dumphandler_t handler,
+                FAR void *arg);
+#endif
+
 /* Functions contained in mm_size2ndx.c.c ***********************************/
 
 int mm_size2ndx(size_t size);
@@ -117,6 +117,10 @@ struct mqueue_inode_s
   pid_t ntpid;                /* Notification: Receiving Task's PID */
   struct sigevent ntevent;    /* Notification description */
   struct sigwork_s ntwork;    /* Notification work */
+#ifdef CONFIG_MQ_LOAN
+  FAR uint8_t *slab;          /* Per-queue message slots */
+  sq_queue_t slabfree;        /* Free message slots in the slab */
+#endif
 };
 
 /* This describes the message queue descriptor that is held in the
@@ -295,6 +299,94 @@ ssize_t nxmq_timedreceive(mqd_t mqdes, FAR char *msg, size_t msglen,
                           FAR unsigned int *prio,
                           FAR const struct timespec *abstime);
 
+#ifdef CONFIG_MQ_LOAN
+/****************************************************************************
+ * Name: nxmq_loan_msg
+ *
+ * Description:
+ *   Borrow a free message slot from the message queue's slab.  The caller
+ *   builds the message in place in the returned buffer, which holds up to
+ *   mq_msgsize bytes, and then either queues it with nxmq_send_loan() or
+ *   gives it back with nxmq_return_loan().  If no slot is free, the caller
+ *   blocks unless O_NONBLOCK is set for the message queue.
+ *
+ * Input Parameters:
+ *   mqdes - Message queue descriptor
+ *   msg   - The location to return the message buffer
+ *
+ * Returned Value:
+ *   Zero (OK) is returned on success.  A negated errno value is returned on
+ *   failure (EINVAL, EPERM, EAGAIN, EINTR or ECANCELED).
+ *
+ ****************************************************************************/
+
+int nxmq_loan_msg(mqd_t mqdes, FAR char **msg);
+
+/****************************************************************************
+ * Name: nxmq_send_loan
+ *
+ * Description:
+ *   Queue a message that was built in place in a buffer obtained from
+ *   nxmq_loan_msg().  The payload is not copied.  The message slot was
+ *   reserved by the loan, so this never blocks.
+ *
+ * Input Parameters:
+ *   mqdes  - Message queue descriptor
+ *   msg    - The loaned message buffer
+ *   msglen - The length of the message in bytes
+ *   prio   - The priority of the message
+ *
+ * Returned Value:
+ *   Zero (OK) is returned on success.  A negated errno value is returned on
+ *   failure (EINVAL, EPERM or EMSGSIZE); the loan is kept in that case.
+ *
+ ****************************************************************************/
+
+int nxmq_send_loan(mqd_t mqdes, FAR char *msg, size_t msglen,
+                   unsigned int prio);
+
+/****************************************************************************
+ * Name: nxmq_receive_loan
+ *
+ * Description:
+ *   Remove the oldest of the highest priority messages from the message
+ *   queue like nxmq_receive() does, but return a pointer to the message
+ *   in place instead of copying it out.  The caller must hand the buffer
+ *   back with nxmq_return_loan() when it has finished with it.
+ *
+ * Input Parameters:
+ *   mqdes - Message queue descriptor
+ *   msg   - The location to return the message buffer
+ *   prio  - If not NULL, the location to store message priority.
+ *
+ * Returned Value:
+ *   The length of the message is returned on success.  A negated errno
+ *   value is returned on failure (see mq_receive()).
+ *
+ ****************************************************************************/
+
+ssize_t nxmq_receive_loan(mqd_t mqdes, FAR char **msg,
+                          FAR unsigned int *prio);
+
+/****************************************************************************
+ * Name: nxmq_return_loan
+ *
+ * Description:
+ *   Give a message buffer obtained from nxmq_loan_msg() or
+ *   nxmq_receive_loan() back to the message queue.
+ *
+ * Input Parameters:
+ *   mqdes - Message queue descriptor
+ *   msg   - The loaned message buffer
+ *
+ * Returned Value:
+ *   None
+ *
+ ****************************************************************************/
+
+void nxmq_return_loan(mqd_t mqdes, FAR char *msg);
+#endif
+
 /****************************************************************************
  * Name: nxmq_free_msgq
  *
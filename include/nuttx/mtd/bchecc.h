@@ -0,0 +1,138 @@
+/****************************************************************************
+ * include/nuttx/mtd/bchecc.h
+ *
+ *   Copyright (C) 2020 Gregory Nutt. All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in
+ *    the documentation and/or other materials provided with the
+ *    distribution.
+ * 3. Neither the name NuttX nor the names of its contributors may be
+ *    used to endorse or promote products derived from this software
+ *    without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+ * FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE
+ * COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+ * INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,
+ * BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS
+ * OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED
+ * AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ * LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN
+ * ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ *
+ ****************************************************************************/
+
+#ifndef __INCLUDE_NUTTX_MTD_BCHECC_H
+#define __INCLUDE_NUTTX_MTD_BCHECC_H
+
+/****************************************************************************
+ * Included Files
+ ****************************************************************************/
+
+#include <nuttx/config.h>
+
+#include <sys/types.h>
+#include <stdint.h>
+
+#ifdef CONFIG_MTD_NAND_SWECC_BCH
+
+/****************************************************************************
+ * Pre-processor Definitions
+ ****************************************************************************/
+
+/* Each 512 byte sector is protected by a binary BCH code over GF(2^13)
+ * that corrects up to CONFIG_MTD_NAND_BCH_STRENGTH bit errors.  It needs
+ * 13 ECC bits per correctable bit.
+ */
+
+#define BCHECC_SECTORSIZE  512
+#define BCHECC_M           13
+#define BCHECC_T           CONFIG_MTD_NAND_BCH_STRENGTH
+#define BCHECC_ECCBYTES    ((BCHECC_M * BCHECC_T + 7) / 8)
+
+/****************************************************************************
+ * Public Function Prototypes
+ ****************************************************************************/
+
+#ifndef __ASSEMBLY__
+
+#ifdef __cplusplus
+#define EXTERN extern "C"
+extern "C"
+{
+#else
+#define EXTERN extern
+#endif
+
+/****************************************************************************
+ * Name: bchecc_initialize
+ *
+ * Description:
+ *   Build the generator polynomial and the encoder tables.  This must be
+ *   called once before any other BCH function.
+ *
+ ****************************************************************************/
+
+void bchecc_initialize(void);
+
+/****************************************************************************
+ * Name: bchecc_compute512x
+ *
+ * Description:
+ *   Computes BCHECC_ECCBYTES bytes of BCH code for each 512 byte sector of
+ *   a data block whose size is a multiple of 512 bytes.  The code of an
+ *   erased (all 0xff) sector is all 0xff.
+ *
+ * Input Parameters:
+ *   data - Data to compute code for
+ *   size - Data size in bytes
+ *   code - Codes buffer
+ *
+ * Returned Value:
+ *   None
+ *
+ ****************************************************************************/
+
+void bchecc_compute512x(FAR const uint8_t *data, size_t size,
+                        FAR uint8_t *code);
+
+/****************************************************************************
+ * Name: bchecc_verify512x
+ *
+ * Description:
+ *   Verifies and corrects a data block whose size is a multiple of 512
+ *   bytes using the BCH codes computed by bchecc_compute512x().
+ *
+ * Input Parameters:
+ *   data - Data buffer to verify
+ *   size - Size of the data in bytes
+ *   code - Original codes
+ *
+ * Returned Value:
+ *   The number of bit errors corrected (zero if the data is correct) is
+ *   returned on success.  -EBADMSG is returned if any sector has more bit
+ *   errors than can be corrected.
+ *
+ ****************************************************************************/
+
+int bchecc_verify512x(FAR uint8_t *data, size_t size,
+                      FAR const uint8_t *code);
+
+#undef EXTERN
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* __ASSEMBLY__ */
+#endif /* CONFIG_MTD_NAND_SWECC_BCH */
+#endif /* __INCLUDE_NUTTX_MTD_BCHECC_H */
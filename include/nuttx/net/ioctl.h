@@ -116,6 +116,7 @@
 /* TUN/TAP driver ***********************************************************/
 
 #define TUNSETIFF        _SIOC(0x0028)  /* Set TUN/TAP interface */
+#define TUNSETOFFLOAD    _SIOC(0x0040)  /* Set TUN_F_* read/write format */
 
 /* Telnet driver ************************************************************/
 
@@ -584,6 +584,30 @@ FAR struct socket *sockfd_socket(int sockfd);
 int psock_socket(int domain, int type, int protocol,
                  FAR struct socket *psock);
 
+/****************************************************************************
+ * Name: psock_socketpair
+ *
+ * Description:
+ *   psock_socketpair() creates an unnamed pair of connected sockets and
+ *   returns them in the two socket structures.  Only Unix domain stream
+ *   sockets are supported.
+ *
+ * Input Parameters:
+ *   domain   (see sys/socket.h)
+ *   type     (see sys/socket.h)
+ *   protocol (see sys/socket.h)
+ *   psock0   The first socket structure of the pair
+ *   psock1   The second socket structure of the pair
+ *
+ * Returned Value:
+ *   Returns zero (OK) on success.  On failure, it returns a negated errno
+ *   value to indicate the nature of the error.
+ *
+ ****************************************************************************/
+
+int psock_socketpair(int domain, int type, int protocol,
+                     FAR struct socket *psock0, FAR struct socket *psock1);
+
 /****************************************************************************
  * Name: net_close
  *
@@ -999,6 +1023,42 @@ ssize_t psock_recvfrom(FAR struct socket *psock, FAR void *buf, size_t len,
 #define psock_recv(psock,buf,len,flags) \
   psock_recvfrom(psock,buf,len,flags,NULL,0)
 
+/****************************************************************************
+ * Name: psock_recvfrom_iob and psock_sendto_iob
+ *
+ * Description:
+ *   Zero-copy variants of psock_recvfrom() and psock_sendto() for TCP and
+ *   UDP sockets.  Data is exchanged as I/O buffer chains:
+ *
+ *   - psock_recvfrom_iob() detaches the next TCP read-ahead chain or UDP
+ *     datagram and returns it in *iob.  The caller owns the chain and must
+ *     release it with iob_free_chain().  Requires read-ahead buffering.
+ *   - psock_sendto_iob() links the caller's chain into a write buffer.  On
+ *     success the network owns the chain; on failure it remains with the
+ *     caller.  Requires write buffering.
+ *
+ *   Both return the number of bytes transferred or a negated errno value.
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_NET_ZEROCOPY
+struct iob_s; /* Forward reference */
+
+ssize_t psock_recvfrom_iob(FAR struct socket *psock, FAR struct iob_s **iob,
+                           int flags, FAR struct sockaddr *from,
+                           FAR socklen_t *fromlen);
+
+#define psock_recv_iob(psock,iob,flags) \
+  psock_recvfrom_iob(psock,iob,flags,NULL,0)
+
+ssize_t psock_sendto_iob(FAR struct socket *psock, FAR struct iob_s *iob,
+                         int flags, FAR const struct sockaddr *to,
+                         socklen_t tolen);
+
+#define psock_send_iob(psock,iob,flags) \
+  psock_sendto_iob(psock,iob,flags,NULL,0)
+#endif
+
 /****************************************************************************
  * Name: nx_recvfrom
  *
@@ -1035,6 +1095,33 @@ ssize_t nx_recvfrom(int sockfd, FAR void *buf, size_t len, int flags,
 
 #define nx_recv(psock,buf,len,flags) nx_recvfrom(psock,buf,len,flags,NULL,0)
 
+/****************************************************************************
+ * Name: psock_sendmsg and psock_recvmsg
+ *
+ * Description:
+ *   Internal versions of sendmsg() and recvmsg() that operate on the
+ *   internal socket structure.  A message with several I/O vectors is
+ *   gathered into (or scattered from) one transfer so that a datagram is
+ *   never split.  No ancillary (control) data is supported.
+ *
+ * Input Parameters:
+ *   psock - A pointer to a NuttX-specific, internal socket structure
+ *   msg   - The message header describing the data and peer address
+ *   flags - Send or receive flags
+ *
+ * Returned Value:
+ *   On success, returns the number of bytes transferred.  On failure, a
+ *   negated errno value is returned.
+ *
+ ****************************************************************************/
+
+struct msghdr; /* Forward reference */
+
+ssize_t psock_sendmsg(FAR struct socket *psock, FAR struct msghdr *msg,
+                      int flags);
+ssize_t psock_recvmsg(FAR struct socket *psock, FAR struct msghdr *msg,
+                      int flags);
+
 /****************************************************************************
  * Name: psock_getsockopt
  *
@@ -52,7 +52,7 @@
 #include <sys/ioctl.h>
 #include <stdint.h>
 
-#ifdef CONFIG_NET_MCASTGROUP
+#if defined(CONFIG_NET_MCASTGROUP) || defined(CONFIG_NET_TCP_TXREADY)
 #  include <queue.h>
 #endif
 
@@ -71,6 +71,15 @@
 #  include <nuttx/net/mld.h>
 #endif
 
+#ifdef CONFIG_NETDEV_LOCK
+#  include <sys/types.h>
+#  include <semaphore.h>
+#endif
+
+#ifdef CONFIG_NETDEV_RXQUEUE
+#  include <nuttx/wqueue.h>
+#endif
+
 /****************************************************************************
  * Pre-processor Definitions
  ****************************************************************************/
@@ -95,6 +104,32 @@
 #  define RADIO_MAX_ADDRLEN CONFIG_PKTRADIO_ADDRLEN
 #endif
 
+/* Offload features that a driver may advertise in d_features
+ * (CONFIG_NETDEV_OFFLOAD).
+ *
+ *   NETDEV_FEATURE_TXCSUM - The device computes and inserts the IPv4
+ *     header, TCP and UDP checksums of outgoing packets.  The stack leaves
+ *     these checksum fields zero.
+ *   NETDEV_FEATURE_RXCSUM - The device verifies these checksums on
+ *     incoming packets and drops bad packets itself.  The stack does not
+ *     check them again.
+ *   NETDEV_FEATURE_TSO - The device splits outgoing TCP packets that are
+ *     larger than the device packet size into segments carrying d_tsomss
+ *     bytes of payload each.  TCP may then hand the device up to d_tsomax
+ *     bytes of payload in one packet, so d_buf must be large enough for
+ *     that plus headers.  Only used together with NETDEV_FEATURE_TXCSUM.
+ */
+
+#define NETDEV_FEATURE_TXCSUM  (1 << 0)
+#define NETDEV_FEATURE_RXCSUM  (1 << 1)
+#define NETDEV_FEATURE_TSO     (1 << 2)
+
+#ifdef CONFIG_NETDEV_OFFLOAD
+#  define NETDEV_HAS_FEATURE(dev,f) (((dev)->d_features & (f)) == (f))
+#else
+#  define NETDEV_HAS_FEATURE(dev,f) (0)
+#endif
+
 /* Helper macros for network device statistics */
 
 #ifdef CONFIG_NETDEV_STATISTICS
@@ -196,6 +231,31 @@ struct netdev_statistics_s
 };
 #endif
 
+#ifdef CONFIG_NETDEV_RXQUEUE
+/* Frames received by the driver and waiting to be passed to the network.
+ * This is a single-producer, single-consumer ring:  Only the driver
+ * advances rq_head and only the RX worker advances rq_tail, so neither
+ * side needs a lock.  See netdev_rxqueue().
+ */
+
+struct iob_s;             /* Forward reference */
+struct net_driver_s;      /* Forward reference */
+
+struct netdev_rxqueue_s
+{
+  FAR struct iob_s *volatile rq_ring[CONFIG_NETDEV_RXQUEUE_DEPTH];
+  volatile uint16_t rq_head;    /* Next slot filled by the driver */
+  volatile uint16_t rq_tail;    /* Next slot drained by the network */
+  struct work_s rq_work;        /* Drains the ring on the RX worker */
+
+  /* Driver dispatch of one frame in d_buf (ipv4_input(), arp_arpin(),
+   * ..., and transmission of any reply).
+   */
+
+  CODE void (*rq_input)(FAR struct net_driver_s *dev);
+};
+#endif
+
 #if defined(CONFIG_NET_6LOWPAN) || defined(CONFIG_NET_BLUETOOTH) || \
     defined(CONFIG_NET_IEEE802154)
 /* This structure is used to represent addresses of varying length.  This
@@ -255,6 +315,16 @@ struct net_driver_s
 
   uint16_t d_pktsize;           /* Maximum packet size */
 
+#ifdef CONFIG_NETDEV_OFFLOAD
+  /* Offload features.  See NETDEV_FEATURE_* definitions above. */
+
+  uint8_t d_features;           /* Set of NETDEV_FEATURE_* */
+  uint16_t d_tsomax;            /* TSO: Max TCP payload per packet */
+  uint16_t d_tsomss;            /* TSO: Payload per segment.  Only
+                                 * meaningful if d_len exceeds the
+                                 * device packet size */
+#endif
+
   /* Link layer address */
 
   union
@@ -343,6 +413,16 @@ struct net_driver_s
 
   uint16_t d_sndlen;
 
+#ifdef CONFIG_NET_CHKSUM_COPY
+  /* d_sndsum holds the raw checksum (see chksum()) of the d_sndsumlen bytes
+   * at d_appdata, computed while they were copied in.  It is only valid
+   * while d_sndsumlen == d_sndlen; a zero d_sndsumlen marks it invalid.
+   */
+
+  uint16_t d_sndsum;
+  uint16_t d_sndsumlen;
+#endif
+
   /* Multicast group support */
 
 #ifdef CONFIG_NET_IGMP
@@ -399,6 +479,28 @@ struct net_driver_s
                  unsigned long arg);
 #endif
 
+#ifdef CONFIG_NET_TCP_TXREADY
+  /* TCP connections bound to this device that have TX work pending.  See
+   * tcp_txready().
+   */
+
+  dq_queue_t d_tcptxq;
+#endif
+
+#ifdef CONFIG_NETDEV_LOCK
+  /* Per-device, re-entrant driver lock.  See netdev_lock(). */
+
+  sem_t    d_lock;              /* Serializes driver I/O */
+  pid_t    d_lockholder;        /* Thread holding d_lock */
+  uint16_t d_lockcount;         /* Re-entrant lock count */
+#endif
+
+#ifdef CONFIG_NETDEV_RXQUEUE
+  /* Received frames waiting for the RX worker.  See netdev_rxqueue(). */
+
+  struct netdev_rxqueue_s d_rxq;
+#endif
+
   /* Drivers may attached device-specific, private information */
 
   void *d_private;
@@ -609,6 +711,87 @@ int devif_loopback(FAR struct net_driver_s *dev);
 int netdev_carrier_on(FAR struct net_driver_s *dev);
 int netdev_carrier_off(FAR struct net_driver_s *dev);
 
+/****************************************************************************
+ * Name: netdev_lock and netdev_unlock
+ *
+ * Description:
+ *   Take or release the per-device driver lock.  Drivers should hold this
+ *   lock, rather than the global network lock, while they work on their
+ *   own hardware and packet buffer state (interrupt work, TX completion,
+ *   descriptor recovery).  The network lock then only needs to be taken
+ *   around the calls into the network stack (devif_poll(), devif_timer(),
+ *   ipv4_input(), ...).  This way RX/TX work on one interface does not
+ *   stall behind socket operations or another interface.
+ *
+ *   The lock is re-entrant.  Lock ordering:  the device lock must always
+ *   be taken BEFORE the network lock.  Driver callbacks invoked by the
+ *   stack with the network lock held (d_ifup, d_txavail, d_ioctl, ...)
+ *   must therefore not take the device lock directly; they should defer
+ *   such work to a work queue, as the drivers already do.
+ *
+ *   If CONFIG_NETDEV_LOCK is not selected these fall back to the global
+ *   network lock so that drivers written this way still work.
+ *
+ * Input Parameters:
+ *   dev - The network device to be locked or unlocked.
+ *
+ * Returned Value:
+ *   netdev_lock() returns zero (OK) on success; a negated errno value is
+ *   returned on failure (probably -ECANCELED).
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_NETDEV_LOCK
+int netdev_lock(FAR struct net_driver_s *dev);
+void netdev_unlock(FAR struct net_driver_s *dev);
+#else
+#  define netdev_lock(dev)   net_lock()
+#  define netdev_unlock(dev) net_unlock()
+#endif
+
+/****************************************************************************
+ * Name: netdev_rxqueue_init, netdev_rxqueue and netdev_rxqueue_flush
+ *
+ * Description:
+ *   Batched receive.  Instead of dispatching each frame from its interrupt
+ *   work, a driver copies received frames into I/O buffer chains and
+ *   hands them to netdev_rxqueue(), which may be called from the interrupt
+ *   handler itself.  The frames are passed to the network in batches of up
+ *   to CONFIG_NETDEV_RXQUEUE_BUDGET frames on the RX worker thread, with
+ *   the device lock and the network lock taken once per batch.  For each
+ *   frame, the worker copies it into d_buf, sets d_len and calls the
+ *   'input' function given to netdev_rxqueue_init(), which dispatches the
+ *   frame and sends any reply just as the driver's receive logic would.
+ *
+ *   With CONFIG_NETDEV_RXQUEUE_GRO, consecutive in-order TCP segments of
+ *   the same connection in a batch are merged into one segment when the
+ *   result still fits in d_buf.  This is only done for Ethernet devices
+ *   that verify checksums (NETDEV_FEATURE_RXCSUM), since the checksums of
+ *   the merged segment are not recomputed.
+ *
+ *   netdev_rxqueue_init() must be called before the device is brought up.
+ *   netdev_rxqueue_flush() discards any queued frames; call it when the
+ *   device is brought down.
+ *
+ * Input Parameters:
+ *   dev   - The network device
+ *   input - Driver function that dispatches the frame in d_buf
+ *   iob   - The received frame, starting with the link layer header.  The
+ *           chain belongs to the network after the call, even on failure.
+ *
+ * Returned Value:
+ *   netdev_rxqueue() returns zero (OK) if the frame was queued and -ENOBUFS
+ *   if the ring was full and the frame was dropped.
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_NETDEV_RXQUEUE
+void netdev_rxqueue_init(FAR struct net_driver_s *dev,
+                         CODE void (*input)(FAR struct net_driver_s *dev));
+int netdev_rxqueue(FAR struct net_driver_s *dev, FAR struct iob_s *iob);
+void netdev_rxqueue_flush(FAR struct net_driver_s *dev);
+#endif
+
 /****************************************************************************
  * Name: net_ioctl_arglen
  *
@@ -76,8 +76,12 @@
 #define TCP_OPT_END       0   /* End of TCP options list */
 #define TCP_OPT_NOOP      1   /* "No-operation" TCP option */
 #define TCP_OPT_MSS       2   /* Maximum segment size TCP option */
+#define TCP_OPT_WS        3   /* Window scale TCP option (RFC 7323) */
 
 #define TCP_OPT_MSS_LEN   4   /* Length of TCP MSS option. */
+#define TCP_OPT_WS_LEN    3   /* Length of TCP window scale option. */
+
+#define TCP_WS_MAXSHIFT   14  /* Largest window scale shift count allowed */
 
 /* The TCP states used in the struct tcp_conn_s tcpstateflags field */
 
@@ -44,6 +44,9 @@
  ****************************************************************************/
 
 #include <nuttx/config.h>
+
+#include <stdint.h>
+
 #include <nuttx/net/ioctl.h>
 
 #ifdef CONFIG_NET_TUN
@@ -59,10 +62,64 @@
 #define IFF_MASK         0x7f
 #define IFF_NO_PI        0x80
 
+/* TUNSETOFFLOAD flags.  These select the format of the data exchanged with
+ * read() and write() on an interface created with TUNSETIFF:
+ *
+ *   TUN_F_MULTIPKT - A single read() or write() carries as many frames as
+ *     fit in the buffer.  Each frame is preceded by a uint16_t holding its
+ *     length in host byte order (not counting the offload header) and is
+ *     padded so that the next length is 16-bit aligned (TUN_PKTALIGN).  A
+ *     partial write() means that the frames past the returned count were
+ *     not consumed.
+ *   TUN_F_VNET_HDR - Each frame is preceded by a struct tun_vnet_hdr_s
+ *     (after the length, if TUN_F_MULTIPKT is also selected).
+ */
+
+#define TUN_F_MULTIPKT   0x01
+#define TUN_F_VNET_HDR   0x02
+
+#define TUN_PKTALIGN(n)  (((n) + 1) & ~1)
+
+/* struct tun_vnet_hdr_s flags and GSO types.  The values are those of the
+ * virtio-net header.
+ *
+ *   TUN_VNET_HDR_F_NEEDS_CSUM - Written frames only:  The driver computes
+ *     the Internet checksum from csum_start to the end of the frame and
+ *     stores it at csum_start + csum_offset.  That field must hold the
+ *     pseudo-header checksum.  Both offsets must be even.
+ *   TUN_VNET_HDR_F_DATA_VALID - The checksums of the frame are known to be
+ *     correct.  The driver sets this on every frame that it returns, and
+ *     the network does not verify the checksums of written frames that
+ *     carry it (CONFIG_NETDEV_OFFLOAD).
+ *
+ * The driver never returns GSO frames, and written frames may not exceed
+ * CONFIG_NET_TUN_PKTSIZE whatever their gso_type.
+ */
+
+#define TUN_VNET_HDR_F_NEEDS_CSUM  0x01
+#define TUN_VNET_HDR_F_DATA_VALID  0x02
+
+#define TUN_VNET_HDR_GSO_NONE      0x00
+#define TUN_VNET_HDR_GSO_TCPV4     0x01
+#define TUN_VNET_HDR_GSO_UDP       0x03
+#define TUN_VNET_HDR_GSO_TCPV6     0x04
+
 /****************************************************************************
  * Public Type Definitions
  ****************************************************************************/
 
+/* Per-frame offload header selected with TUN_F_VNET_HDR */
+
+struct tun_vnet_hdr_s
+{
+  uint8_t  flags;            /* See TUN_VNET_HDR_F_* */
+  uint8_t  gso_type;         /* See TUN_VNET_HDR_GSO_* */
+  uint16_t hdr_len;          /* Length of the headers to replicate (GSO) */
+  uint16_t gso_size;         /* Payload per segment (GSO) */
+  uint16_t csum_start;       /* Checksummed region starts here */
+  uint16_t csum_offset;      /* Checksum is stored at csum_start + this */
+};
+
 /****************************************************************************
  * Public Data
  ****************************************************************************/
@@ -72,6 +72,9 @@
 
 #include <nuttx/config.h>
 
+#include <sys/types.h>
+#include <stdint.h>
+#include <stdbool.h>
 #include <queue.h>
 
 #ifdef CONFIG_PM
@@ -291,6 +294,38 @@ struct pm_user_governor_state_s
   enum pm_state_e state;
 };
 
+#ifdef CONFIG_PM_QOS
+/* The classes of PM QoS constraints */
+
+enum pm_qos_class_e
+{
+  PM_QOS_LATENCY = 0,  /* Maximum wakeup latency (microseconds) */
+  PM_QOS_THROUGHPUT    /* Minimum sustained throughput (KiB/s) */
+};
+
+/* One PM QoS constraint.  The structure is provided by the requester and
+ * must remain valid until the request has been removed.
+ */
+
+struct pm_qos_request_s
+{
+  FAR struct pm_qos_request_s *flink; /* Supports a singly linked list */
+  uint8_t domain;                     /* The PM domain constrained */
+  uint8_t qclass;                     /* See enum pm_qos_class_e */
+  bool active;                        /* The constraint is in effect */
+  uint32_t value;                     /* Latency (us) or throughput (KiB/s) */
+  clock_t expiry;                     /* Time when it lapses; 0: never */
+};
+
+/* What the platform can still do in one power state */
+
+struct pm_qos_state_s
+{
+  uint32_t latency;                   /* Wakeup latency (us) */
+  uint32_t throughput;                /* Sustainable throughput (KiB/s) */
+};
+#endif
+
 /****************************************************************************
  * Public Data
  ****************************************************************************/
@@ -539,6 +574,97 @@ int pm_changestate(int domain, enum pm_state_e newstate);
 
 enum pm_state_e pm_querystate(int domain);
 
+#ifdef CONFIG_PM_QOS
+/****************************************************************************
+ * Name: pm_qos_add
+ *
+ * Description:
+ *   Add a quality of service constraint to a PM domain.  As long as the
+ *   constraint is in effect, pm_checkstate() does not recommend a power
+ *   state whose wakeup latency is above a PM_QOS_LATENCY value, or whose
+ *   sustainable throughput is below a PM_QOS_THROUGHPUT value.
+ *
+ * Input Parameters:
+ *   req     - The request structure, provided by the caller
+ *   domain  - The domain of the constraint
+ *   qclass  - PM_QOS_LATENCY or PM_QOS_THROUGHPUT
+ *   value   - The maximum latency (us) or minimum throughput (KiB/s)
+ *   timeout - The constraint lapses after this many milliseconds.  Zero
+ *             means that it stays in effect until pm_qos_remove().
+ *
+ *     As an example, an I2S driver might require a latency below 100 us
+ *     for the next 20 ms each time that it queues an audio buffer.
+ *
+ * Returned Value:
+ *   None.
+ *
+ * Assumptions:
+ *   This function may be called from an interrupt handler.
+ *
+ ****************************************************************************/
+
+void pm_qos_add(FAR struct pm_qos_request_s *req, int domain,
+                enum pm_qos_class_e qclass, uint32_t value,
+                uint32_t timeout);
+
+/****************************************************************************
+ * Name: pm_qos_update
+ *
+ * Description:
+ *   Change the value and the timeout of a constraint previously added with
+ *   pm_qos_add().  A constraint that has lapsed is put in effect again.
+ *
+ * Assumptions:
+ *   This function may be called from an interrupt handler.
+ *
+ ****************************************************************************/
+
+void pm_qos_update(FAR struct pm_qos_request_s *req, uint32_t value,
+                   uint32_t timeout);
+
+/****************************************************************************
+ * Name: pm_qos_remove
+ *
+ * Description:
+ *   Remove a constraint.  The request structure may then be reused.
+ *
+ * Assumptions:
+ *   This function may be called from an interrupt handler.
+ *
+ ****************************************************************************/
+
+void pm_qos_remove(FAR struct pm_qos_request_s *req);
+
+/****************************************************************************
+ * Name: pm_qos_setstates
+ *
+ * Description:
+ *   Called by platform logic to describe the wakeup latency and the
+ *   sustainable throughput of each power state of a domain.  Without it,
+ *   the latencies from the configuration are used and only PM_SLEEP is
+ *   assumed to stop all transfers.
+ *
+ * Input Parameters:
+ *   domain - The PM domain
+ *   states - PM_COUNT descriptions, indexed by enum pm_state_e.  The array
+ *            must remain valid.
+ *
+ ****************************************************************************/
+
+void pm_qos_setstates(int domain, FAR const struct pm_qos_state_s *states);
+
+/****************************************************************************
+ * Name: pm_qos_limit
+ *
+ * Description:
+ *   Return the lowest power state that satisfies all constraints in effect
+ *   in the domain.  pm_checkstate() never recommends a lower power state.
+ *
+ ****************************************************************************/
+
+enum pm_state_e pm_qos_limit(int domain);
+#endif
+
 #undef EXTERN
 #ifdef __cplusplus
 }
@@ -0,0 +1,651 @@
+/****************************************************************************
+ * include/nuttx/ringbuf.h
+ *
+ *   Copyright (C) 2020 Gregory Nutt. All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in
+ *    the documentation and/or other materials provided with the
+ *    distribution.
+ * 3. Neither the name NuttX nor the names of its contributors may be
+ *    used to endorse or promote products derived from this software
+ *    without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+ * FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE
+ * COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+ * INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,
+ * BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS
+ * OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED
+ * AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ * LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN
+ * ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ *
+ ****************************************************************************/
+
+#ifndef __INCLUDE_NUTTX_RINGBUF_H
+#define __INCLUDE_NUTTX_RINGBUF_H
+
+/****************************************************************************
+ * Included Files
+ ****************************************************************************/
+
+#include <nuttx/config.h>
+
+#include <sys/types.h>
+#include <stdint.h>
+#include <stdbool.h>
+#include <string.h>
+#include <poll.h>
+#include <errno.h>
+
+#include <nuttx/semaphore.h>
+
+/****************************************************************************
+ * Pre-processor Definitions
+ ****************************************************************************/
+
+/* Static initializer for a byte ring over 'b' of 's' bytes */
+
+#define RINGBUF_INITIALIZER(b,s)  { (FAR uint8_t *)(b), (s), 0, 0 }
+
+/* Orders the buffer accesses against the index that publishes them.  This
+ * is a DMB on ARMv7 and a compiler barrier on single core parts without
+ * one.
+ */
+
+#define RINGBUF_BARRIER()         __atomic_thread_fence(__ATOMIC_SEQ_CST)
+
+/* The storage needed for each element of an MPMC ring of 'e' byte
+ * elements:  a sequence number followed by the element.
+ */
+
+#define RINGBUF_MPMC_CELLSIZE(e) \
+  ((sizeof(uint32_t) + (e) + sizeof(uintptr_t) - 1) & ~(sizeof(uintptr_t) - 1))
+
+/****************************************************************************
+ * Public Types
+ ****************************************************************************/
+
+/* A single-producer, single-consumer byte ring.
+ *
+ * The producer only writes rb_head and the consumer only writes rb_tail,
+ * so one writer and one reader need no lock between them, even when one of
+ * them is an interrupt handler.  Several writers or several readers must
+ * still serialize among themselves.  One byte of the buffer is never used
+ * so that a full ring can be told apart from an empty one; the buffer may
+ * be of any size.
+ */
+
+struct ringbuf_s
+{
+  FAR uint8_t *rb_buffer;      /* Ring storage (may be NULL until allocated) */
+  size_t rb_size;              /* Size of rb_buffer in bytes */
+  volatile size_t rb_head;     /* Index of the next byte written */
+  volatile size_t rb_tail;     /* Index of the next byte read */
+};
+
+/* A multi-producer, multi-consumer ring of fixed size elements.
+ *
+ * Each cell carries a sequence number that tells producers and consumers
+ * whether it is free or full for the current lap (D. Vyukov's bounded MPMC
+ * queue).  Positions are claimed with a compare-and-exchange, so any
+ * number of threads and interrupt handlers may use the ring without a
+ * lock.  The number of elements must be a power of two.
+ */
+
+struct ringbuf_mpmc_s
+{
+  FAR uint8_t *rm_cells;       /* nelem cells of RINGBUF_MPMC_CELLSIZE() */
+  size_t rm_elemsize;          /* Size of one element in bytes */
+  size_t rm_cellsize;          /* Size of one cell in bytes */
+  uint32_t rm_mask;            /* nelem - 1 */
+  uint32_t rm_enqpos;          /* Next position to be claimed by a producer */
+  uint32_t rm_deqpos;          /* Next position to be claimed by a consumer */
+};
+
+/****************************************************************************
+ * Inline Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: ringbuf_init
+ *
+ * Description:
+ *   Initialize an empty byte ring over 'size' bytes at 'buffer'.  At most
+ *   size - 1 bytes may be held.
+ *
+ ****************************************************************************/
+
+static inline void ringbuf_init(FAR struct ringbuf_s *rb, FAR void *buffer,
+                                size_t size)
+{
+  rb->rb_buffer = (FAR uint8_t *)buffer;
+  rb->rb_size   = size;
+  rb->rb_head   = 0;
+  rb->rb_tail   = 0;
+}
+
+/****************************************************************************
+ * Name: ringbuf_reset
+ *
+ * Description:
+ *   Discard everything in the ring.  Neither side may be active.
+ *
+ ****************************************************************************/
+
+static inline void ringbuf_reset(FAR struct ringbuf_s *rb)
+{
+  rb->rb_head = 0;
+  rb->rb_tail = 0;
+}
+
+/****************************************************************************
+ * Name: ringbuf_used, ringbuf_space, ringbuf_is_empty and ringbuf_is_full
+ *
+ * Description:
+ *   Return the number of bytes held, the number of bytes that may still be
+ *   written, and whether the ring is empty or full.  The answer may be
+ *   stale by the time it is used if the other side is active; it is exact
+ *   for the side's own view (bytes held for the consumer, space for the
+ *   producer) in that it can only grow.
+ *
+ ****************************************************************************/
+
+static inline size_t ringbuf_used(FAR const struct ringbuf_s *rb)
+{
+  size_t head = rb->rb_head;
+  size_t tail = rb->rb_tail;
+
+  return head >= tail ? head - tail : rb->rb_size + head - tail;
+}
+
+static inline size_t ringbuf_space(FAR const struct ringbuf_s *rb)
+{
+  return rb->rb_size - ringbuf_used(rb) - 1;
+}
+
+static inline bool ringbuf_is_empty(FAR const struct ringbuf_s *rb)
+{
+  return rb->rb_head == rb->rb_tail;
+}
+
+static inline bool ringbuf_is_full(FAR const struct ringbuf_s *rb)
+{
+  return ringbuf_space(rb) == 0;
+}
+
+/****************************************************************************
+ * Name: ringbuf_rdseg
+ *
+ * Description:
+ *   Consumer side.  Return the number of bytes that may be read in one
+ *   contiguous segment and, in 'ptr', where that segment starts.  The
+ *   bytes are consumed with ringbuf_rdcommit().
+ *
+ ****************************************************************************/
+
+static inline size_t ringbuf_rdseg(FAR struct ringbuf_s *rb,
+                                   FAR uint8_t **ptr)
+{
+  size_t head = rb->rb_head;
+  size_t tail = rb->rb_tail;
+
+  /* Do not read the data before the index that published it */
+
+  RINGBUF_BARRIER();
+
+  *ptr = &rb->rb_buffer[tail];
+  return head >= tail ? head - tail : rb->rb_size - tail;
+}
+
+/****************************************************************************
+ * Name: ringbuf_rdcommit
+ *
+ * Description:
+ *   Consumer side.  Release 'n' bytes of the current read segment to the
+ *   producer.
+ *
+ ****************************************************************************/
+
+static inline void ringbuf_rdcommit(FAR struct ringbuf_s *rb, size_t n)
+{
+  size_t tail = rb->rb_tail + n;
+
+  if (tail >= rb->rb_size)
+    {
+      tail -= rb->rb_size;
+    }
+
+  /* Finish reading the data before the producer may overwrite it */
+
+  RINGBUF_BARRIER();
+  rb->rb_tail = tail;
+}
+
+/****************************************************************************
+ * Name: ringbuf_wrseg
+ *
+ * Description:
+ *   Producer side.  Return the number of bytes that may be written in one
+ *   contiguous segment and, in 'ptr', where that segment starts.  The
+ *   bytes are published with ringbuf_wrcommit().
+ *
+ ****************************************************************************/
+
+static inline size_t ringbuf_wrseg(FAR struct ringbuf_s *rb,
+                                   FAR uint8_t **ptr)
+{
+  size_t head = rb->rb_head;
+  size_t tail = rb->rb_tail;
+
+  /* Do not write over data before the consumer has released it */
+
+  RINGBUF_BARRIER();
+
+  *ptr = &rb->rb_buffer[head];
+  if (head < tail)
+    {
+      return tail - head - 1;
+    }
+  else if (tail == 0)
+    {
+      return rb->rb_size - head - 1;
+    }
+
+  return rb->rb_size - head;
+}
+
+/****************************************************************************
+ * Name: ringbuf_wrcommit
+ *
+ * Description:
+ *   Producer side.  Publish 'n' bytes of the current write segment to the
+ *   consumer.
+ *
+ ****************************************************************************/
+
+static inline void ringbuf_wrcommit(FAR struct ringbuf_s *rb, size_t n)
+{
+  size_t head = rb->rb_head + n;
+
+  if (head >= rb->rb_size)
+    {
+      head -= rb->rb_size;
+    }
+
+  /* The data must be visible before the index that publishes it */
+
+  RINGBUF_BARRIER();
+  rb->rb_head = head;
+}
+
+/****************************************************************************
+ * Name: ringbuf_write
+ *
+ * Description:
+ *   Producer side.  Copy up to 'len' bytes into the ring, stopping when it
+ *   becomes full.  At most two memcpy() calls are needed, one on each side
+ *   of the wrap point.  Returns the number of bytes written.
+ *
+ ****************************************************************************/
+
+static inline size_t ringbuf_write(FAR struct ringbuf_s *rb,
+                                   FAR const void *data, size_t len)
+{
+  FAR const uint8_t *src = (FAR const uint8_t *)data;
+  FAR uint8_t *ptr;
+  size_t nwritten = 0;
+  size_t n;
+
+  while (nwritten < len && (n = ringbuf_wrseg(rb, &ptr)) > 0)
+    {
+      if (n > len - nwritten)
+        {
+          n = len - nwritten;
+        }
+
+      memcpy(ptr, &src[nwritten], n);
+      ringbuf_wrcommit(rb, n);
+      nwritten += n;
+    }
+
+  return nwritten;
+}
+
+/****************************************************************************
+ * Name: ringbuf_read
+ *
+ * Description:
+ *   Consumer side.  Copy up to 'len' bytes out of the ring.  Returns the
+ *   number of bytes read.
+ *
+ ****************************************************************************/
+
+static inline size_t ringbuf_read(FAR struct ringbuf_s *rb, FAR void *data,
+                                  size_t len)
+{
+  FAR uint8_t *dest = (FAR uint8_t *)data;
+  FAR uint8_t *ptr;
+  size_t nread = 0;
+  size_t n;
+
+  while (nread < len && (n = ringbuf_rdseg(rb, &ptr)) > 0)
+    {
+      if (n > len - nread)
+        {
+          n = len - nread;
+        }
+
+      memcpy(&dest[nread], ptr, n);
+      ringbuf_rdcommit(rb, n);
+      nread += n;
+    }
+
+  return nread;
+}
+
+/****************************************************************************
+ * Name: ringbuf_pollevents
+ *
+ * Description:
+ *   Return POLLIN if the ring holds data and POLLOUT if it has space.
+ *
+ ****************************************************************************/
+
+static inline pollevent_t ringbuf_pollevents(FAR const struct ringbuf_s *rb)
+{
+  pollevent_t eventset = 0;
+  size_t used = ringbuf_used(rb);
+
+  if (used > 0)
+    {
+      eventset |= POLLIN;
+    }
+
+  if (used < rb->rb_size - 1)
+    {
+      eventset |= POLLOUT;
+    }
+
+  return eventset;
+}
+
+/****************************************************************************
+ * Name: ringbuf_notify
+ *
+ * Description:
+ *   Post a wakeup semaphore used with ringbuf_write_wait() or
+ *   ringbuf_read_wait(), unless a wakeup is already pending.  The semaphore
+ *   count never exceeds one, so a waiter that finds the ring not ready
+ *   just before the other side posts still sees the post.
+ *
+ ****************************************************************************/
+
+static inline void ringbuf_notify(FAR sem_t *sem)
+{
+  int sval;
+
+  if (_SEM_GETVALUE(sem, &sval) == 0 && sval <= 0)
+    {
+      _SEM_POST(sem);
+    }
+}
+
+/****************************************************************************
+ * Name: ringbuf_write_wait
+ *
+ * Description:
+ *   Producer side.  Write all 'len' bytes, waiting on 'spacesem' whenever
+ *   the ring is full and posting 'datasem' after each write.  The consumer
+ *   must ringbuf_notify(spacesem) after it frees space.  Semaphores
+ *   interfaces appropriate for the build context are used, so this works
+ *   both in the OS and in applications.
+ *
+ * Returned Value:
+ *   The number of bytes written.  If the wait fails before anything was
+ *   written, a negated errno value is returned.
+ *
+ ****************************************************************************/
+
+static inline ssize_t ringbuf_write_wait(FAR struct ringbuf_s *rb,
+                                         FAR sem_t *spacesem,
+                                         FAR sem_t *datasem,
+                                         FAR const void *data, size_t len)
+{
+  FAR const uint8_t *src = (FAR const uint8_t *)data;
+  size_t nwritten = 0;
+  size_t n;
+  int ret;
+
+  while (nwritten < len)
+    {
+      n = ringbuf_write(rb, &src[nwritten], len - nwritten);
+      if (n > 0)
+        {
+          nwritten += n;
+          ringbuf_notify(datasem);
+          continue;
+        }
+
+      ret = _SEM_WAIT(spacesem);
+      if (ret < 0)
+        {
+          return nwritten > 0 ? (ssize_t)nwritten : _SEM_ERRVAL(ret);
+        }
+    }
+
+  return nwritten;
+}
+
+/****************************************************************************
+ * Name: ringbuf_read_wait
+ *
+ * Description:
+ *   Consumer side.  Wait on 'datasem' until the ring holds data, then read
+ *   up to 'len' bytes and post 'spacesem'.  The producer must
+ *   ringbuf_notify(datasem) after it adds data.
+ *
+ * Returned Value:
+ *   The number of bytes read (at least one).  If the wait fails, a negated
+ *   errno value is returned.
+ *
+ ****************************************************************************/
+
+static inline ssize_t ringbuf_read_wait(FAR struct ringbuf_s *rb,
+                                        FAR sem_t *datasem,
+                                        FAR sem_t *spacesem,
+                                        FAR void *data, size_t len)
+{
+  size_t n;
+  int ret;
+
+  while ((n = ringbuf_read(rb, data, len)) == 0 && len > 0)
+    {
+      ret = _SEM_WAIT(datasem);
+      if (ret < 0)
+        {
+          return _SEM_ERRVAL(ret);
+        }
+    }
+
+  ringbuf_notify(spacesem);
+  return n;
+}
+
+/****************************************************************************
+ * Name: ringbuf_mpmc_init
+ *
+ * Description:
+ *   Initialize an empty MPMC ring of 'nelem' elements of 'elemsize' bytes.
+ *   'cells' must provide nelem * RINGBUF_MPMC_CELLSIZE(elemsize) bytes.
+ *
+ * Returned Value:
+ *   Zero (OK) on success; -EINVAL if nelem is not a power of two.
+ *
+ ****************************************************************************/
+
+static inline int ringbuf_mpmc_init(FAR struct ringbuf_mpmc_s *rm,
+                                    FAR void *cells, size_t elemsize,
+                                    uint32_t nelem)
+{
+  uint32_t i;
+
+  if (nelem < 2 || (nelem & (nelem - 1)) != 0)
+    {
+      return -EINVAL;
+    }
+
+  rm->rm_cells    = (FAR uint8_t *)cells;
+  rm->rm_elemsize = elemsize;
+  rm->rm_cellsize = RINGBUF_MPMC_CELLSIZE(elemsize);
+  rm->rm_mask     = nelem - 1;
+  rm->rm_enqpos   = 0;
+  rm->rm_deqpos   = 0;
+
+  for (i = 0; i < nelem; i++)
+    {
+      *(FAR uint32_t *)&rm->rm_cells[i * rm->rm_cellsize] = i;
+    }
+
+  return OK;
+}
+
+/****************************************************************************
+ * Name: ringbuf_mpmc_cell
+ ****************************************************************************/
+
+static inline FAR uint32_t *ringbuf_mpmc_cell(FAR struct ringbuf_mpmc_s *rm,
+                                              uint32_t pos)
+{
+  return (FAR uint32_t *)&rm->rm_cells[(pos & rm->rm_mask) *
+                                       rm->rm_cellsize];
+}
+
+/****************************************************************************
+ * Name: ringbuf_mpmc_put
+ *
+ * Description:
+ *   Add up to 'n' elements from 'data' to the ring.  Each element is
+ *   claimed and published on its own, so elements from concurrent
+ *   producers may interleave.  Returns the number of elements added, which
+ *   is less than 'n' only if the ring became full.
+ *
+ ****************************************************************************/
+
+static inline size_t ringbuf_mpmc_put(FAR struct ringbuf_mpmc_s *rm,
+                                      FAR const void *data, size_t n)
+{
+  FAR const uint8_t *src = (FAR const uint8_t *)data;
+  FAR uint32_t *cell;
+  uint32_t pos;
+  int32_t dif;
+  size_t i;
+
+  for (i = 0; i < n; i++)
+    {
+      pos = __atomic_load_n(&rm->rm_enqpos, __ATOMIC_RELAXED);
+      for (; ; )
+        {
+          cell = ringbuf_mpmc_cell(rm, pos);
+          dif  = (int32_t)(__atomic_load_n(cell, __ATOMIC_ACQUIRE) - pos);
+          if (dif == 0)
+            {
+              /* The cell is free for this lap.  Claim the position; on
+               * failure pos is reloaded and the cell is looked up again.
+               */
+
+              if (__atomic_compare_exchange_n(&rm->rm_enqpos, &pos, pos + 1,
+                                              true, __ATOMIC_RELAXED,
+                                              __ATOMIC_RELAXED))
+                {
+                  break;
+                }
+            }
+          else if (dif < 0)
+            {
+              /* The consumers have not emptied the cell yet:  full */
+
+              return i;
+            }
+          else
+            {
+              pos = __atomic_load_n(&rm->rm_enqpos, __ATOMIC_RELAXED);
+            }
+        }
+
+      memcpy(cell + 1, &src[i * rm->rm_elemsize], rm->rm_elemsize);
+      __atomic_store_n(cell, pos + 1, __ATOMIC_RELEASE);
+    }
+
+  return n;
+}
+
+/****************************************************************************
+ * Name: ringbuf_mpmc_get
+ *
+ * Description:
+ *   Remove up to 'n' elements from the ring into 'data'.  Returns the
+ *   number of elements removed, which is less than 'n' only if the ring
+ *   became empty.
+ *
+ ****************************************************************************/
+
+static inline size_t ringbuf_mpmc_get(FAR struct ringbuf_mpmc_s *rm,
+                                      FAR void *data, size_t n)
+{
+  FAR uint8_t *dest = (FAR uint8_t *)data;
+  FAR uint32_t *cell;
+  uint32_t pos;
+  int32_t dif;
+  size_t i;
+
+  for (i = 0; i < n; i++)
+    {
+      pos = __atomic_load_n(&rm->rm_deqpos, __ATOMIC_RELAXED);
+      for (; ; )
+        {
+          cell = ringbuf_mpmc_cell(rm, pos);
+          dif  = (int32_t)(__atomic_load_n(cell, __ATOMIC_ACQUIRE) -
+                           (pos + 1));
+          if (dif == 0)
+            {
+              if (__atomic_compare_exchange_n(&rm->rm_deqpos, &pos, pos + 1,
+                                              true, __ATOMIC_RELAXED,
+                                              __ATOMIC_RELAXED))
+                {
+                  break;
+                }
+            }
+          else if (dif < 0)
+            {
+              /* No producer has filled the cell yet:  empty */
+
+              return i;
+            }
+          else
+            {
+              pos = __atomic_load_n(&rm->rm_deqpos, __ATOMIC_RELAXED);
+            }
+        }
+
+      memcpy(&dest[i * rm->rm_elemsize], cell + 1, rm->rm_elemsize);
+
+      /* Hand the cell back to the producers for the next lap */
+
+      __atomic_store_n(cell, pos + rm->rm_mask + 1, __ATOMIC_RELEASE);
+    }
+
+  return n;
+}
+
+#endif /* __INCLUDE_NUTTX_RINGBUF_H */
@@ -111,16 +111,18 @@
 #define TCB_FLAG_NONCANCELABLE     (1 << 2) /* Bit 2: Pthread is non-cancelable */
 #define TCB_FLAG_CANCEL_DEFERRED   (1 << 3) /* Bit 3: Deferred (vs asynch) cancellation type */
 #define TCB_FLAG_CANCEL_PENDING    (1 << 4) /* Bit 4: Pthread cancel is pending */
-#define TCB_FLAG_POLICY_SHIFT      (5) /* Bit 5-6: Scheduling policy */
-#define TCB_FLAG_POLICY_MASK       (3 << TCB_FLAG_POLICY_SHIFT)
+#define TCB_FLAG_POLICY_SHIFT      (5) /* Bit 5-7: Scheduling policy */
+#define TCB_FLAG_POLICY_MASK       (7 << TCB_FLAG_POLICY_SHIFT)
 #  define TCB_FLAG_SCHED_FIFO      (0 << TCB_FLAG_POLICY_SHIFT) /* FIFO scheding policy */
 #  define TCB_FLAG_SCHED_RR        (1 << TCB_FLAG_POLICY_SHIFT) /* Round robin scheding policy */
 #  define TCB_FLAG_SCHED_SPORADIC  (2 << TCB_FLAG_POLICY_SHIFT) /* Sporadic scheding policy */
 #  define TCB_FLAG_SCHED_OTHER     (3 << TCB_FLAG_POLICY_SHIFT) /* Other scheding policy */
-#define TCB_FLAG_CPU_LOCKED        (1 << 7) /* Bit 7: Locked to this CPU */
-#define TCB_FLAG_SIGNAL_ACTION     (1 << 8) /* Bit 8: In a signal handler */
-#define TCB_FLAG_EXIT_PROCESSING   (1 << 9) /* Bit 9: Exitting */
-                                            /* Bits 10-15: Available */
+#  define TCB_FLAG_SCHED_DEADLINE  (4 << TCB_FLAG_POLICY_SHIFT) /* Deadline scheding policy */
+#define TCB_FLAG_CPU_LOCKED        (1 << 8) /* Bit 8: Locked to this CPU */
+#define TCB_FLAG_SIGNAL_ACTION     (1 << 9) /* Bit 9: In a signal handler */
+#define TCB_FLAG_EXIT_PROCESSING   (1 << 10) /* Bit 10: Exitting */
+#define TCB_FLAG_COND_MORPHED      (1 << 11) /* Bit 11: Cond wait morphed */
+                                            /* Bits 12-15: Available */
 
 /* Values for struct task_group tg_flags */
 
@@ -147,6 +149,22 @@
 #define SPORADIC_FLAG_REPLENISH    (1 << 2)  /* Bit 2: Replenishment cycle */
                                              /* Bits 3-7: Available */
 
+/* Scheduler latency tracer.  Latencies are collected in log2 histograms:
+ * Bucket n holds the latencies of 2^n up to 2^(n+1)-1 time units (as
+ * returned by up_critmon_gettime()).  Bucket zero also holds latencies of
+ * zero.
+ */
+
+#ifdef CONFIG_SCHED_LATENCY
+#  define LATENCY_NBUCKETS         32
+#  define LATENCY_NGROUPS \
+     ((256 + CONFIG_SCHED_LATENCY_PRIOGROUP - 1) / CONFIG_SCHED_LATENCY_PRIOGROUP)
+
+#  define LATENCY_SOURCE_TASK      0  /* Woken up by a task */
+#  define LATENCY_SOURCE_IRQ       1  /* Woken up from an interrupt handler */
+#  define LATENCY_NSOURCES         2
+#endif
+
 /* Most internal nxsched_* interfaces are not available in the user space in
  * PROTECTED and KERNEL builds.  In that context, the application semaphore
  * interfaces must be used.  The differences between the two sets of
@@ -318,6 +336,25 @@ struct sporadic_s
 
 #endif /* CONFIG_SCHED_SPORADIC */
 
+/* struct deadline_s *************************************************************/
+
+#ifdef CONFIG_SCHED_DEADLINE
+
+/* This structure holds the reservation of a SCHED_DEADLINE thread.  The
+ * remaining budget of the current period is kept in the TCB timeslice.
+ */
+
+struct deadline_s
+{
+  uint32_t  runtime;                /* Budget per period (ticks)                */
+  uint32_t  deadline;               /* Relative deadline (ticks)                */
+  uint32_t  period;                 /* Reservation period (ticks)               */
+  uint32_t  util;                   /* Bandwidth: runtime/period (ppm)          */
+  clock_t   absdeadline;            /* Current absolute deadline                */
+};
+
+#endif /* CONFIG_SCHED_DEADLINE */
+
 /* struct child_status_s *********************************************************/
 
 /* This structure is used to maintain information about child tasks.  pthreads
@@ -530,6 +567,10 @@ struct task_group_s
 
   sq_queue_t tg_sigactionq;         /* List of actions for signals              */
   sq_queue_t tg_sigpendingq;        /* List of pending signals                  */
+#if CONFIG_SIG_GROUP_NPENDING > 0
+  FAR void *tg_sigpendpool;         /* Reserved pending signal allocation       */
+  sq_queue_t tg_sigpendfree;        /* Free reserved pending signals            */
+#endif
 #ifdef CONFIG_SIG_DEFAULT
   sigset_t tg_sigdefault;           /* Set of signals set to the default action */
 #endif
@@ -537,8 +578,7 @@ struct task_group_s
 #ifndef CONFIG_DISABLE_ENVIRON
   /* Environment variables ******************************************************/
 
-  size_t     tg_envsize;            /* Size of environment string allocation    */
-  FAR char  *tg_envp;               /* Allocated environment strings            */
+  FAR struct environ_s *tg_env;     /* Environment, shared copy-on-write      */
 #endif
 
 #ifndef CONFIG_DISABLE_POSIX_TIMERS
@@ -599,6 +639,53 @@ struct task_group_s
 #endif
 };
 
+#ifdef CONFIG_SCHED_LATENCY
+/* struct latency_hist_s *********************************************************/
+
+/* A log2 histogram of the time from when a thread was woken up until it
+ * actually ran.
+ */
+
+struct latency_hist_s
+{
+  uint32_t count;                        /* Number of samples                   */
+  uint32_t max;                          /* Maximum latency                     */
+  uint32_t bucket[LATENCY_NBUCKETS];     /* log2 histogram of latencies         */
+};
+
+/* struct latency_trigger_s ******************************************************/
+
+/* Describes the latency threshold trigger */
+
+struct latency_trigger_s
+{
+  uint32_t threshold;                    /* Trigger threshold.  Zero: Disabled  */
+  bool stop;                             /* Stop tracing when triggered         */
+  bool stopped;                          /* Tracing stopped by the trigger      */
+  uint8_t priority;                      /* Priority of the last trigger        */
+  pid_t pid;                             /* Thread that caused the last trigger */
+  uint32_t latency;                      /* Latency of the last trigger         */
+  uint32_t count;                        /* Number of times triggered           */
+};
+#endif
+
+#ifdef CONFIG_SCHED_PROFILE
+/* struct profile_info_s *******************************************************/
+
+/* Describes the histograms of the sampling profiler.  Bucket n counts the
+ * samples at addresses start + (n << shift) up to the next bucket.
+ */
+
+struct profile_info_s
+{
+  uintptr_t start;                       /* Address of the first bucket         */
+  uint8_t shift;                         /* log2 of the bytes per bucket        */
+  bool running;                          /* True: Samples are being taken       */
+  uint32_t nsamples;                     /* Number of samples, all CPUs         */
+  uint32_t noutside;                     /* Samples outside of the text section */
+};
+#endif
+
 /* struct tcb_s ******************************************************************/
 
 /* This is the common part of the task control block (TCB).  The TCB is the heart
@@ -631,6 +718,7 @@ struct tcb_s
   uint8_t  pend_reprios[CONFIG_SEM_NNESTPRIO];
 #endif
   uint8_t  base_priority;                /* "Normal" priority of the thread     */
+  FAR struct semholder_s *holdsems;      /* List of semaphores held             */
 #endif
 
   uint8_t  task_state;                   /* Current state of the thread         */
@@ -640,6 +728,9 @@ struct tcb_s
 #endif
   uint16_t flags;                        /* Misc. general status flags          */
   int16_t  lockcount;                    /* 0=preemptable (not-locked)          */
+#ifdef CONFIG_SMP
+  int16_t  glockcount;                   /* Nested sched_lock_global() count    */
+#endif
 #ifdef CONFIG_IRQCOUNT
   int16_t  irqcount;                     /* 0=Not in critical section           */
 #endif
@@ -647,13 +738,17 @@ struct tcb_s
   int16_t  cpcount;                      /* Nested cancellation point count     */
 #endif
 
-#if CONFIG_RR_INTERVAL > 0 || defined(CONFIG_SCHED_SPORADIC)
-  int32_t  timeslice;                    /* RR timeslice OR Sporadic budget     */
-                                         /* interval remaining                  */
+#if CONFIG_RR_INTERVAL > 0 || defined(CONFIG_SCHED_SPORADIC) || \
+    defined(CONFIG_SCHED_DEADLINE)
+  int32_t  timeslice;                    /* RR timeslice OR Sporadic/Deadline   */
+                                         /* budget interval remaining           */
 #endif
 #ifdef CONFIG_SCHED_SPORADIC
   FAR struct sporadic_s *sporadic;       /* Sporadic scheduling parameters      */
 #endif
+#ifdef CONFIG_SCHED_DEADLINE
+  struct deadline_s deadline;            /* Deadline scheduling parameters      */
+#endif
 
   WDOG_ID waitdog;                       /* All timed waits use this timer      */
 
@@ -666,6 +761,10 @@ struct tcb_s
                                          /* Need to deallocate stack            */
   FAR void *adj_stack_ptr;               /* Adjusted stack_alloc_ptr for HW     */
                                          /* The initial stack pointer value     */
+#ifdef CONFIG_STACK_COLORATION_INCREMENTAL
+  uintptr_t stack_hwm;                   /* Deepest stack address found used    */
+                                         /* Zero: Not yet known                 */
+#endif
 
   /* External Module Support ****************************************************/
 
@@ -706,6 +805,14 @@ struct tcb_s
   uint32_t crit_max;                     /* Max time in critical section        */
 #endif
 
+  /* Scheduler latency tracer support *******************************************/
+
+#ifdef CONFIG_SCHED_LATENCY
+  uint32_t lat_start;                    /* Wake-up time.  Zero: Not woken up   */
+  uint8_t  lat_source;                   /* Source of the wake-up               */
+  struct latency_hist_s lat_hist;        /* Wake-up to run latency histogram    */
+#endif
+
   /* Library related fields *****************************************************/
 
   int pterrno;                           /* Current per-thread errno            */
@@ -823,6 +930,16 @@ EXTERN uint32_t g_crit_max[1];
 #endif
 #endif /* CONFIG_SCHED_CRITMONITOR */
 
+#ifdef CONFIG_SCHED_LATENCY
+/* Latency histograms for each priority group and wake-up source and the
+ * state of the latency threshold trigger.
+ */
+
+EXTERN struct latency_hist_s
+  g_latency_hist[LATENCY_NGROUPS][LATENCY_NSOURCES];
+EXTERN struct latency_trigger_s g_latency_trigger;
+#endif
+
 /********************************************************************************
  * Public Function Prototypes
  ********************************************************************************/
@@ -1188,6 +1305,156 @@ int nxsched_setaffinity(pid_t pid, size_t cpusetsize,
                         FAR const cpu_set_t *mask);
 #endif
 
+/****************************************************************************
+ * Name: sched_lock_global and sched_unlock_global
+ *
+ * Description:
+ *   In the SMP case, sched_lock() only disables pre-emption on the calling
+ *   CPU.  sched_lock_global() also keeps the other CPUs from starting any
+ *   new task until the matching sched_unlock_global().  This stalls task
+ *   switching system-wide and is meant only for the rare logic that relies
+ *   on it.  In the single CPU case, these are the same as sched_lock() and
+ *   sched_unlock().
+ *
+ *   This is a non-standard, internal OS function and is not intended for
+ *   use by application logic.
+ *
+ * Input Parameters:
+ *   None
+ *
+ * Returned Value:
+ *   OK on success; ERROR on failure
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_SMP
+int sched_lock_global(void);
+int sched_unlock_global(void);
+#else
+#  define sched_lock_global()   sched_lock()
+#  define sched_unlock_global() sched_unlock()
+#endif
+
+/****************************************************************************
+ * Name: sched_latency_reset
+ *
+ * Description:
+ *   Clear all scheduler latency histograms, clear the threshold trigger
+ *   state, and restart tracing if it was stopped by the trigger.
+ *
+ * Input Parameters:
+ *   None
+ *
+ * Returned Value:
+ *   None
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_SCHED_LATENCY
+void sched_latency_reset(void);
+#endif
+
+/****************************************************************************
+ * Name: sched_latency_threshold
+ *
+ * Description:
+ *   Set the latency threshold trigger.  Each time that a thread runs later
+ *   than the threshold after it was woken up, the thread and its latency are
+ *   recorded in g_latency_trigger.  Optionally, tracing stops on the first
+ *   trigger so that the histograms show the state leading up to it.
+ *
+ * Input Parameters:
+ *   usec - The threshold in microseconds.  Zero disables the trigger.
+ *   stop - True: Stop tracing when the threshold is exceeded.
+ *
+ * Returned Value:
+ *   None
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_SCHED_LATENCY
+void sched_latency_threshold(uint32_t usec, bool stop);
+#endif
+
+/****************************************************************************
+ * Name: sched_latency_usec
+ *
+ * Description:
+ *   Convert a latency in time units of up_critmon_gettime() into
+ *   microseconds.
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_SCHED_LATENCY
+uint32_t sched_latency_usec(uint32_t elapsed);
+#endif
+
+/****************************************************************************
+ * Name: sched_profile_start, sched_profile_stop, and sched_profile_reset
+ *
+ * Description:
+ *   Control the sampling profiler:  Start or stop taking samples, or
+ *   discard the samples taken.
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_SCHED_PROFILE
+void sched_profile_start(void);
+void sched_profile_stop(void);
+void sched_profile_reset(void);
+#endif
+
+/****************************************************************************
+ * Name: sched_profile_tick
+ *
+ * Description:
+ *   Take one profile sample of the context preempted by the current
+ *   interrupt, as returned by up_profile_pc().  This is called on each
+ *   system timer tick.  In a tickless configuration, or for a different
+ *   sample rate, it may instead be called from any periodic timer interrupt.
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_SCHED_PROFILE
+void sched_profile_tick(void);
+#endif
+
+/****************************************************************************
+ * Name: sched_profile_sample
+ *
+ * Description:
+ *   Add one profile sample.  This takes no locks, so it may also be called
+ *   from a high priority interrupt handler that runs outside of the OS
+ *   critical sections (CONFIG_ARCH_HIPRI_INTERRUPT).  Such a timer handler
+ *   also samples code that runs with interrupts disabled and normal
+ *   interrupt handlers.
+ *
+ * Input Parameters:
+ *   pc     - The sampled program counter
+ *   caller - The return address at that point, or zero if not known
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_SCHED_PROFILE
+void sched_profile_sample(uintptr_t pc, uintptr_t caller);
+#endif
+
+/****************************************************************************
+ * Name: sched_profile_info and sched_profile_count
+ *
+ * Description:
+ *   Return the layout and totals of the profile histograms, and the number
+ *   of samples in one bucket of the program counter histogram or, if caller
+ *   is true, of the return address histogram.  The counts of all CPUs are
+ *   added together.
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_SCHED_PROFILE
+void sched_profile_info(FAR struct profile_info_s *info);
+uint32_t sched_profile_count(int ndx, bool caller);
+#endif
+
 #undef EXTERN
 #if defined(__cplusplus)
 }
@@ -66,6 +66,16 @@
 #  define CONFIG_SCHED_NOTE_BUFSIZE 2048
 #endif
 
+/* Binary note stream (see note_stream_start()) */
+
+#define NOTE_STREAM_MAGIC0      'N'
+#define NOTE_STREAM_MAGIC1      'X'
+#define NOTE_STREAM_MAGIC2      'N'
+#define NOTE_STREAM_MAGIC3      'T'
+#define NOTE_STREAM_VERSION     1
+
+#define NOTE_STREAM_FLAG_SMP    (1 << 0) /* Notes include nc_cpu */
+
 /****************************************************************************
  * Public Types
  ****************************************************************************/
@@ -234,6 +244,22 @@ struct note_spinlock_s
   uint8_t nsp_value;            /* Value of spinlock */
 };
 #endif /* CONFIG_SCHED_INSTRUMENTATION_SPINLOCKS */
+
+/* The binary note stream starts with this header.  It is followed by the
+ * notes exactly as they are held in the note buffer; each note begins with
+ * its length, nc_length.  Multi-byte values are little endian.  Host tools
+ * use the header to convert the stream into a standard trace format.
+ */
+
+struct note_streamhdr_s
+{
+  uint8_t nsh_magic[4];         /* NOTE_STREAM_MAGIC0-3 */
+  uint8_t nsh_version;          /* NOTE_STREAM_VERSION */
+  uint8_t nsh_flags;            /* See NOTE_STREAM_FLAG_* definitions */
+  uint8_t nsh_ncpus;            /* Number of CPUs */
+  uint8_t nsh_namesize;         /* CONFIG_TASK_NAME_SIZE */
+  uint8_t nsh_usecpertick[4];   /* Microseconds per nc_systime tick */
+};
 #endif /* CONFIG_SCHED_INSTRUMENTATION_BUFFER */
 
 /****************************************************************************
@@ -369,6 +395,32 @@ ssize_t sched_note_size(void);
 int note_register(void);
 #endif
 
+/****************************************************************************
+ * Name: note_stream_start
+ *
+ * Description:
+ *   Start a kernel thread that continuously drains the note buffers and
+ *   writes the notes as a binary stream to a character device, such as a
+ *   USB CDC/ACM serial port or an RPMSG UART.  The stream begins with a
+ *   struct note_streamhdr_s.
+ *
+ *   This is normally called by board bring-up logic once the device is
+ *   available.
+ *
+ * Input Parameters:
+ *   devpath - The path to the character device
+ *
+ * Returned Value:
+ *   Zero (OK) is returned on success.  Otherwise, a negated errno value is
+ *   returned.
+ *
+ ****************************************************************************/
+
+#if defined(CONFIG_SCHED_INSTRUMENTATION_BUFFER) && \
+    defined(CONFIG_DRIVER_NOTE_STREAM)
+int note_stream_start(FAR const char *devpath);
+#endif
+
 #else /* CONFIG_SCHED_INSTRUMENTATION */
 
 #  define sched_note_start(t)
@@ -42,6 +42,8 @@
 
 #include <nuttx/config.h>
 
+#include <stdbool.h>
+#include <limits.h>
 #include <errno.h>
 #include <semaphore.h>
 
@@ -81,7 +83,7 @@
 #  define _SEM_TRYWAIT(s)       nxsem_trywait(s)
 #  define _SEM_TIMEDWAIT(s,t)   nxsem_timedwait(s,t)
 #  define _SEM_POST(s)          nxsem_post(s)
-#  define _SEM_GETVALUE(s)      nxsem_getvalue(s)
+#  define _SEM_GETVALUE(s,v)    nxsem_getvalue(s,v)
 #  define _SEM_GETPROTOCOL(s,p) nxsem_getprotocol(s,p)
 #  define _SEM_SETPROTOCOL(s,p) nxsem_setprotocol(s,p)
 #  define _SEM_ERRNO(r)         (-(r))
@@ -100,6 +102,19 @@
 #  define _SEM_ERRVAL(r)        (-errno)
 #endif
 
+/* The uncontended fast path may be used only for semaphores that do not
+ * participate in priority inheritance; otherwise, the holder list must be
+ * maintained by the OS.
+ */
+
+#ifdef CONFIG_SEM_FASTPATH
+#  ifdef CONFIG_PRIORITY_INHERITANCE
+#    define NXSEM_FASTPATH(s) (((s)->flags & PRIOINHERIT_FLAGS_DISABLE) != 0)
+#  else
+#    define NXSEM_FASTPATH(s) true
+#  endif
+#endif
+
 /****************************************************************************
  * Public Type Definitions
  ****************************************************************************/
@@ -632,6 +647,96 @@ nxsem_tickwait_uninterruptible(FAR sem_t *sem, clock_t start, uint32_t delay)
   return ret;
 }
 
+/****************************************************************************
+ * Name: nxsem_fastwait
+ *
+ * Description:
+ *   Try to take a count from an uncontended semaphore with a single atomic
+ *   compare-and-exchange on the count.  No critical section is entered and
+ *   the OS is not called so this may be used from user space in PROTECTED
+ *   and KERNEL builds.  The caller must fall back to the normal wait
+ *   interface if this fails.
+ *
+ * Input Parameters:
+ *   sem - Semaphore descriptor
+ *
+ * Returned Value:
+ *   True is returned if a count was taken.  False is returned if no count
+ *   is available, if priority inheritance is enabled for the semaphore, or
+ *   if CONFIG_SEM_FASTPATH is not selected.
+ *
+ ****************************************************************************/
+
+static inline bool nxsem_fastwait(FAR sem_t *sem)
+{
+#ifdef CONFIG_SEM_FASTPATH
+  int16_t count;
+
+  if (NXSEM_FASTPATH(sem))
+    {
+      count = sem->semcount;
+      while (count > 0)
+        {
+          /* On failure, the current value is returned in count */
+
+          if (__atomic_compare_exchange_n(&sem->semcount, &count,
+                                          (int16_t)(count - 1), false,
+                                          __ATOMIC_ACQUIRE,
+                                          __ATOMIC_RELAXED))
+            {
+              return true;
+            }
+        }
+    }
+#endif
+
+  return false;
+}
+
+/****************************************************************************
+ * Name: nxsem_fastpost
+ *
+ * Description:
+ *   Try to release a count to a semaphore that has no waiters with a single
+ *   atomic compare-and-exchange on the count.  Like nxsem_fastwait(), this
+ *   does not call into the OS.  The caller must fall back to the normal
+ *   post interface if this fails.
+ *
+ * Input Parameters:
+ *   sem - Semaphore descriptor
+ *
+ * Returned Value:
+ *   True is returned if the count was released.  False is returned if
+ *   there are waiters to be awakened, if the count is at SEM_VALUE_MAX, if
+ *   priority inheritance is enabled for the semaphore, or if
+ *   CONFIG_SEM_FASTPATH is not selected.
+ *
+ ****************************************************************************/
+
+static inline bool nxsem_fastpost(FAR sem_t *sem)
+{
+#ifdef CONFIG_SEM_FASTPATH
+  int16_t count;
+
+  if (NXSEM_FASTPATH(sem))
+    {
+      count = sem->semcount;
+      while (count >= 0 && count < SEM_VALUE_MAX)
+        {
+          if (__atomic_compare_exchange_n(&sem->semcount, &count,
+                                          (int16_t)(count + 1), false,
+                                          __ATOMIC_RELEASE,
+                                          __ATOMIC_RELAXED))
+            {
+              return true;
+            }
+        }
+    }
+#endif
+
+  return false;
+}
+
 #undef EXTERN
 #ifdef __cplusplus
 }
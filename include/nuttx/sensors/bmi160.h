@@ -149,6 +149,32 @@ int bmi160_register(FAR const char *devpath, FAR struct i2c_master_s *dev);
 int bmi160_register(FAR const char *devpath, FAR struct spi_dev_s *dev);
 #  endif
 
+/****************************************************************************
+ * Name: bmi160_register_sensor
+ *
+ * Description:
+ *   Register the BMI160 with the common sensor upper half as
+ *   /dev/sensor/accel<devno> and /dev/sensor/gyro<devno>.  Samples are
+ *   batched in the BMI160 FIFO.
+ *
+ * Input Parameters:
+ *   devno - The number appended to the device names
+ *   dev   - An instance of the SPI or I2C interface to use to communicate
+ *           with BMI160
+ *
+ * Returned Value:
+ *   Zero (OK) on success; a negated errno value on failure.
+ *
+ ****************************************************************************/
+
+#  ifdef CONFIG_SENSORS_BMI160_UPPER
+#    ifdef CONFIG_SENSORS_BMI160_I2C
+int bmi160_register_sensor(int devno, FAR struct i2c_master_s *dev);
+#    else /* CONFIG_BMI160_SPI */
+int bmi160_register_sensor(int devno, FAR struct spi_dev_s *dev);
+#    endif
+#  endif
+
 #else /* CONFIG_SENSORS_BMI160_SCU */
 
 #  ifdef CONFIG_SENSORS_BMI160_I2C
@@ -227,4 +227,14 @@
 #define SNIOC_SET_RESOLUTION       _SNIOC(0x0065) /* Arg: uint8_t value */
 #define SNIOC_SET_RANGE            _SNIOC(0x0066) /* Arg: uint8_t value */
 
+/* IOCTL commands of the common sensor upper half (nuttx/sensors/sensor.h) */
+
+/* SNIOC_SET_INTERVAL */                          /* Arg: unsigned long value (microseconds) */
+#define SNIOC_ACTIVATE             _SNIOC(0x0067) /* Arg: bool value */
+#define SNIOC_BATCH                _SNIOC(0x0068) /* Arg: unsigned long value (microseconds) */
+#define SNIOC_SET_WATERMARK        _SNIOC(0x0069) /* Arg: unsigned long value (samples) */
+#define SNIOC_SET_BUFFER_NUMBER    _SNIOC(0x006a) /* Arg: unsigned long value (samples) */
+#define SNIOC_GET_INFO             _SNIOC(0x006b) /* Arg: struct sensor_info_s* */
+#define SNIOC_FLUSH                _SNIOC(0x006c) /* Arg: None */
+
 #endif /* __INCLUDE_NUTTX_SENSORS_IOCTL_H */
@@ -0,0 +1,284 @@
+/****************************************************************************
+ * include/nuttx/sensors/sensor.h
+ *
+ *   Copyright (C) 2020 Gregory Nutt. All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in
+ *    the documentation and/or other materials provided with the
+ *    distribution.
+ * 3. Neither the name NuttX nor the names of its contributors may be
+ *    used to endorse or promote products derived from this software
+ *    without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+ * FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE
+ * COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+ * INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,
+ * BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS
+ * OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED
+ * AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ * LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN
+ * ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ *
+ ****************************************************************************/
+
+#ifndef __INCLUDE_NUTTX_SENSORS_SENSOR_H
+#define __INCLUDE_NUTTX_SENSORS_SENSOR_H
+
+/****************************************************************************
+ * Included Files
+ ****************************************************************************/
+
+#include <nuttx/config.h>
+
+#include <sys/types.h>
+#include <stdbool.h>
+#include <stdint.h>
+#include <time.h>
+
+#include <nuttx/clock.h>
+#include <nuttx/sensors/ioctl.h>
+
+#ifdef CONFIG_SENSORS_UPPER
+
+/****************************************************************************
+ * Pre-processor Definitions
+ ****************************************************************************/
+
+/* Sensor types.  Each type has its own device name and sample format; the
+ * upper half registers a sensor of type T as /dev/sensor/<name><devno>.
+ */
+
+#define SENSOR_TYPE_ACCELEROMETER         1  /* accel:  sensor_event_accel */
+#define SENSOR_TYPE_MAGNETIC_FIELD        2  /* mag:    sensor_event_mag */
+#define SENSOR_TYPE_GYROSCOPE             3  /* gyro:   sensor_event_gyro */
+#define SENSOR_TYPE_LIGHT                 4  /* light:  sensor_event_light */
+#define SENSOR_TYPE_BAROMETER             5  /* baro:   sensor_event_baro */
+#define SENSOR_TYPE_PROXIMITY             6  /* prox:   sensor_event_prox */
+#define SENSOR_TYPE_RELATIVE_HUMIDITY     7  /* humi:   sensor_event_humi */
+#define SENSOR_TYPE_AMBIENT_TEMPERATURE   8  /* temp:   sensor_event_temp */
+#define SENSOR_TYPE_COUNT                 9
+
+/****************************************************************************
+ * Public Types
+ ****************************************************************************/
+
+/* Samples.  Every sample starts with the time it was taken, in
+ * microseconds of the monotonic clock (see sensor_get_timestamp()).
+ */
+
+struct sensor_event_accel     /* Type: Accelerometer */
+{
+  uint64_t timestamp;         /* Units is microseconds */
+  float x;                    /* Axis X in m/s^2 */
+  float y;                    /* Axis Y in m/s^2 */
+  float z;                    /* Axis Z in m/s^2 */
+  float temperature;          /* Temperature in degrees celsius */
+};
+
+struct sensor_event_gyro      /* Type: Gyroscope */
+{
+  uint64_t timestamp;         /* Units is microseconds */
+  float x;                    /* Axis X in rad/s */
+  float y;                    /* Axis Y in rad/s */
+  float z;                    /* Axis Z in rad/s */
+  float temperature;          /* Temperature in degrees celsius */
+};
+
+struct sensor_event_mag       /* Type: Magnetic Field */
+{
+  uint64_t timestamp;         /* Units is microseconds */
+  float x;                    /* Axis X in Gauss or micro Tesla (uT) */
+  float y;                    /* Axis Y in Gauss or micro Tesla (uT) */
+  float z;                    /* Axis Z in Gauss or micro Tesla (uT) */
+  float temperature;          /* Temperature in degrees celsius */
+};
+
+struct sensor_event_baro      /* Type: Barometer */
+{
+  uint64_t timestamp;         /* Units is microseconds */
+  float pressure;             /* pressure measurement in millibar or hpa */
+  float temperature;          /* Temperature in degrees celsius */
+};
+
+struct sensor_event_light     /* Type: Light */
+{
+  uint64_t timestamp;         /* Units is microseconds */
+  float light;                /* in SI lux units */
+};
+
+struct sensor_event_prox      /* Type: Proximity */
+{
+  uint64_t timestamp;         /* Units is microseconds */
+  float proximity;            /* distance to the nearest object in cm */
+};
+
+struct sensor_event_humi      /* Type: Relative Humidity */
+{
+  uint64_t timestamp;         /* Units is microseconds */
+  float humidity;             /* in percent */
+};
+
+struct sensor_event_temp      /* Type: Ambient Temperature */
+{
+  uint64_t timestamp;         /* Units is microseconds */
+  float temperature;          /* Temperature in degrees celsius */
+};
+
+/* Returned by SNIOC_GET_INFO */
+
+struct sensor_info_s
+{
+  int type;                   /* SENSOR_TYPE_* */
+  size_t esize;               /* Size of one sample */
+  unsigned long interval;     /* Sampling period in microseconds */
+  unsigned long latency;      /* Batch latency in microseconds */
+  unsigned long watermark;    /* Samples that wake up a reader */
+  unsigned long buffer_number; /* Depth of the ring buffer in samples */
+  unsigned long batch_number; /* Samples the hardware FIFO holds */
+  unsigned long lost;         /* Samples dropped because the ring was full */
+};
+
+/* Called by the lower half to queue 'bytes' of whole samples.  May be
+ * called from interrupt handlers.
+ */
+
+typedef CODE void (*sensor_push_event_t)(FAR void *priv,
+                                         FAR const void *data,
+                                         size_t bytes);
+
+/* The lower half operations.  All are called with the upper half lock
+ * held and may sleep.
+ */
+
+struct sensor_lowerhalf_s;
+struct sensor_ops_s
+{
+  /* Start or stop sampling */
+
+  CODE int (*activate)(FAR struct sensor_lowerhalf_s *lower, bool enable);
+
+  /* Set the sampling period in microseconds.  The lower half rounds it to
+   * a rate the hardware supports and returns that in *period_us.
+   */
+
+  CODE int (*set_interval)(FAR struct sensor_lowerhalf_s *lower,
+                           FAR unsigned long *period_us);
+
+  /* Set the longest time, in microseconds, that a sample may wait in the
+   * hardware FIFO before it is pushed.  Zero pushes every sample as soon
+   * as it is taken.  Optional; only for hardware with a FIFO
+   * (batch_number > 0).  The value used is returned in *latency_us.
+   */
+
+  CODE int (*batch)(FAR struct sensor_lowerhalf_s *lower,
+                    FAR unsigned long *latency_us);
+
+  /* Push everything now waiting in the hardware FIFO.  Optional. */
+
+  CODE int (*flush)(FAR struct sensor_lowerhalf_s *lower);
+
+  /* Driver specific ioctl commands.  Optional. */
+
+  CODE int (*control)(FAR struct sensor_lowerhalf_s *lower,
+                      int cmd, unsigned long arg);
+};
+
+/* The lower half instance, provided to sensor_register() */
+
+struct sensor_lowerhalf_s
+{
+  int type;                   /* SENSOR_TYPE_* */
+
+  /* Initial depth of the ring buffer in samples, or 0 for
+   * CONFIG_SENSORS_UPPER_NBUFFER.
+   */
+
+  unsigned long buffer_number;
+  unsigned long batch_number; /* Samples the hardware FIFO holds, or 0 */
+  FAR const struct sensor_ops_s *ops;
+
+  /* Set by sensor_register() */
+
+  sensor_push_event_t push_event;
+  FAR void *priv;
+};
+
+/****************************************************************************
+ * Inline Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: sensor_get_timestamp
+ *
+ * Description:
+ *   Return the current time in microseconds for sample timestamps.
+ *
+ ****************************************************************************/
+
+static inline uint64_t sensor_get_timestamp(void)
+{
+  struct timespec ts;
+
+  clock_systimespec(&ts);
+  return (uint64_t)ts.tv_sec * USEC_PER_SEC + ts.tv_nsec / NSEC_PER_USEC;
+}
+
+/****************************************************************************
+ * Public Function Prototypes
+ ****************************************************************************/
+
+#ifdef __cplusplus
+#define EXTERN extern "C"
+extern "C"
+{
+#else
+#define EXTERN extern
+#endif
+
+/****************************************************************************
+ * Name: sensor_register
+ *
+ * Description:
+ *   Register a sensor lower half with the common upper half as
+ *   /dev/sensor/<type name><devno>.  Applications then read whole,
+ *   timestamped samples from a ring buffer and may poll() for them.
+ *
+ * Input Parameters:
+ *   lower - The lower half instance
+ *   devno - The number appended to the device name
+ *
+ * Returned Value:
+ *   Zero (OK) on success; a negated errno value on failure.
+ *
+ ****************************************************************************/
+
+int sensor_register(FAR struct sensor_lowerhalf_s *lower, int devno);
+
+/****************************************************************************
+ * Name: sensor_unregister
+ *
+ * Description:
+ *   Undo sensor_register().
+ *
+ ****************************************************************************/
+
+void sensor_unregister(FAR struct sensor_lowerhalf_s *lower, int devno);
+
+#undef EXTERN
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* CONFIG_SENSORS_UPPER */
+#endif /* __INCLUDE_NUTTX_SENSORS_SENSOR_H */
@@ -121,6 +121,14 @@
   ((dev)->ops->dmarxfree ? (dev)->ops->dmarxfree(dev) : -ENOSYS)
 #endif
 
+#ifdef CONFIG_SERIAL_RXDMA_CIRCULAR
+/* Events reported to uart_recvchars_circular() */
+
+#define UART_RXDMA_HALF    0  /* DMA filled up to the middle of the RX buffer */
+#define UART_RXDMA_FULL    1  /* DMA wrapped to the start of the RX buffer */
+#define UART_RXDMA_IDLE    2  /* The line went idle part way through */
+#endif
+
 #ifdef CONFIG_SERIAL_IFLOWCONTROL
 #  define uart_rxflowcontrol(dev,n,u) \
     (dev->ops->rxflowcontrol && dev->ops->rxflowcontrol(dev,n,u))
@@ -305,6 +313,15 @@ struct uart_dev_s
 #endif
 #endif
 
+#ifdef CONFIG_SERIAL_THRESHOLDS
+  /* Wake-up thresholds */
+
+  uint8_t              rxmin;        /* Bytes a blocking read waits for (VMIN) */
+  volatile int16_t     rxwant;       /* Bytes that wake a waiting reader */
+  int16_t              txlowat;      /* Free bytes that wake a waiting writer */
+  clock_t              rxtimeout;    /* Inter-character read timeout (ticks) */
+#endif
+
   /* Semaphores */
 
   sem_t                closesem;     /* Locks out new open while close is in progress */
@@ -495,6 +512,22 @@ void uart_recvchars_dma(FAR uart_dev_t *dev);
 void uart_recvchars_done(FAR uart_dev_t *dev);
 #endif
 
+/************************************************************************************
+ * Name: uart_recvchars_circular
+ *
+ * Description:
+ *   Called by a lower half whose RX DMA runs continuously over the whole RX
+ *   buffer, on a half-transfer, full-transfer or idle-line event.  'pos' is the
+ *   index in the RX buffer that the DMA will write next.  The head index is moved
+ *   up to 'pos' and any waiting readers are woken.  The lower half must not call
+ *   uart_recvchars_dma() in this mode and its dmarxfree() method may be a no-op.
+ *
+ ************************************************************************************/
+
+#ifdef CONFIG_SERIAL_RXDMA_CIRCULAR
+void uart_recvchars_circular(FAR uart_dev_t *dev, size_t pos, int event);
+#endif
+
 /************************************************************************************
  * Name: uart_reset_sem
  *
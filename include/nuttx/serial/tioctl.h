@@ -210,6 +210,13 @@
 
 #define SER_SWAP_ENABLED   (1 << 0) /* Enable/disable RX/TX swap */
 
+/* Wake-up thresholds (CONFIG_SERIAL_THRESHOLDS) */
+
+#define TIOCSRXTIMEOUT  _TIOC(0x0037)  /* Set RX inter-character timeout: int usec */
+#define TIOCGRXTIMEOUT  _TIOC(0x0038)  /* Get RX inter-character timeout: FAR int* */
+#define TIOCSTXLOWAT    _TIOC(0x0039)  /* Set TX low-water mark: int bytes */
+#define TIOCGTXLOWAT    _TIOC(0x003a)  /* Get TX low-water mark: FAR int* */
+
 /********************************************************************************************
  * Public Type Definitions
  ********************************************************************************************/
@@ -62,6 +62,8 @@
  *   output that selects between command and data.
  * CONFIG_SPI_HWFEATURES - Include an interface method to support special,
  *   hardware-specific SPI features.
+ * CONFIG_SPI_ASYNC - Include the optional submit method for queued,
+ *   asynchronous transactions.
  */
 
 /* Access macros ************************************************************/
@@ -447,6 +449,37 @@
 #  define SPI_TRIGGER(d) \
   (((d)->ops->trigger) ? ((d)->ops->trigger(d)) : -ENOSYS)
 
+/****************************************************************************
+ * Name: SPI_SUBMIT
+ *
+ * Description:
+ *   Queue a transaction to run without the caller holding the bus.  The
+ *   driver takes the bus lock itself, applies the transaction's frequency,
+ *   mode and word size, runs every segment in order, deselects the device,
+ *   releases the bus and then calls xact->callback from a work queue.
+ *   The transaction and the segment list must remain valid until then.
+ *   Optional.
+ *
+ * Input Parameters:
+ *   dev  - Device-specific state data
+ *   xact - The transaction to queue
+ *
+ * Returned Value:
+ *   OK if the transaction was queued; -ENOSYS if the driver does not
+ *   support it; another negated errno value on failure.
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_SPI_ASYNC
+#  define SPI_SUBMIT(d,x) \
+  (((d)->ops->submit) ? ((d)->ops->submit(d,x)) : -ENOSYS)
+
+/* Segment flags */
+
+#  define SPI_SEG_CMD       (1 << 0) /* Command segment (CONFIG_SPI_CMDDATA) */
+#  define SPI_SEG_CSCHANGE  (1 << 1) /* Deselect after this segment */
+#endif
+
 /* SPI Device Macros ********************************************************/
 
 /* This builds a SPI devid from its type and index */
@@ -547,6 +580,40 @@ enum spi_mode_e
 typedef uint8_t spi_hwfeatures_t;
 #endif
 
+#ifdef CONFIG_SPI_ASYNC
+/* One part of an asynchronous transaction.  The device stays selected
+ * from one segment to the next as long as devid is unchanged and
+ * SPI_SEG_CSCHANGE is not set.
+ */
+
+struct spi_segment_s
+{
+  uint32_t         devid;    /* Device selected during this segment */
+  uint8_t          flags;    /* See SPI_SEG_* definitions */
+  FAR const void  *txbuffer; /* Words to send, or NULL to send dummy words */
+  FAR void        *rxbuffer; /* Received words, or NULL to discard them */
+  size_t           nwords;   /* Length of the segment in words */
+};
+
+/* An asynchronous transaction queued with SPI_SUBMIT() */
+
+struct spi_transaction_s;
+typedef CODE void (*spi_complete_t)(FAR struct spi_transaction_s *xact,
+                                    int result);
+
+struct spi_transaction_s
+{
+  FAR struct spi_transaction_s *flink; /* Owned by the driver while queued */
+  FAR const struct spi_segment_s *segs; /* Segments, run in order */
+  unsigned int     nsegs;    /* Number of segments */
+  uint32_t         frequency; /* Bus settings for the transaction */
+  enum spi_mode_e  mode;
+  uint8_t          nbits;
+  spi_complete_t   callback; /* Called on a work queue when done */
+  FAR void        *arg;      /* For the caller's use */
+};
+#endif
+
 /* The SPI vtable */
 
 struct spi_dev_s;
@@ -587,6 +654,10 @@ struct spi_ops_s
 #endif
   CODE int      (*registercallback)(FAR struct spi_dev_s *dev,
                   spi_mediachange_t callback, void *arg);
+#ifdef CONFIG_SPI_ASYNC
+  CODE int      (*submit)(FAR struct spi_dev_s *dev,
+                  FAR struct spi_transaction_s *xact);
+#endif
 };
 
 /* SPI private data.  This structure only defines the initial fields of the
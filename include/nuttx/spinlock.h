@@ -45,6 +45,14 @@
 #include <sys/types.h>
 #include <stdint.h>
 
+#if !defined(CONFIG_SPINLOCK) && defined(CONFIG_ARCH_HAVE_TESTSET)
+/* spinlock_t is still needed for the fallback definitions at the end of
+ * this file.
+ */
+
+#  include <arch/spinlock.h>
+#endif
+
 #ifdef CONFIG_SPINLOCK
 
 /* The architecture specific spinlock.h header file must also provide the
@@ -342,5 +350,26 @@ void spin_clrbit(FAR volatile cpu_set_t *set, unsigned int cpu,
                  FAR volatile spinlock_t *orlock);
 #endif
 
+#else /* CONFIG_SPINLOCK */
+
+/* Without spinlock support, kernel objects may still embed a spinlock_t
+ * that is only ever passed to spin_lock_irqsave() and
+ * spin_unlock_irqrestore().  Those reduce to the critical section and
+ * never touch the lock.
+ */
+
+#ifndef CONFIG_ARCH_HAVE_TESTSET
+typedef uint8_t spinlock_t;
+
+#  define SP_UNLOCKED 0
+#  define SP_LOCKED   1
+#endif
+
+#if !defined(SP_SECTION)
+#  define SP_SECTION
+#endif
+
+#define spin_initialize(l,s) do { *(l) = (s); } while (0)
+
 #endif /* CONFIG_SPINLOCK */
 #endif /* __INCLUDE_NUTTX_SPINLOCK_H */
@@ -42,6 +42,8 @@
 
 #include <nuttx/config.h>
 
+#include <stdint.h>
+
 /****************************************************************************
  * Pre-processor Definitions
  ****************************************************************************/
@@ -118,6 +120,37 @@ FAR const struct symtab_s *
 symtab_findorderedbyname(FAR const struct symtab_s *symtab,
                          FAR const char *name, int nsyms);
 
+/****************************************************************************
+ * Name: symtab_findhashedbyname
+ *
+ * Description:
+ *   Find the symbol in the symbol table with the matching name.
+ *   This version assumes that the table is a hash table generated by
+ *   'mksymtab -h'.  nsyms is the size of the table, which is a power of
+ *   two.  Such tables have unused entries with NULL names and may only be
+ *   searched with this function.
+ *
+ * Returned Value:
+ *   A reference to the symbol table entry if an entry with the matching
+ *   name is found; NULL is returned if the entry is not found.
+ *
+ ****************************************************************************/
+
+FAR const struct symtab_s *
+symtab_findhashedbyname(FAR const struct symtab_s *symtab,
+                        FAR const char *name, int nsyms);
+
+/****************************************************************************
+ * Name: symtab_hashname
+ *
+ * Description:
+ *   Return the hash of a symbol name used to place symbols in hashed
+ *   symbol tables.
+ *
+ ****************************************************************************/
+
+uint32_t symtab_hashname(FAR const char *name);
+
 /****************************************************************************
  * Name: symtab_findbyvalue
  *
@@ -0,0 +1,229 @@
+/****************************************************************************
+ * include/nuttx/timers/hrtimer.h
+ *
+ *   Copyright (C) 2020 Gregory Nutt. All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in
+ *    the documentation and/or other materials provided with the
+ *    distribution.
+ * 3. Neither the name NuttX nor the names of its contributors may be
+ *    used to endorse or promote products derived from this software
+ *    without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+ * FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE
+ * COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+ * INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,
+ * BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS
+ * OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED
+ * AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ * LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN
+ * ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ *
+ ****************************************************************************/
+
+#ifndef __INCLUDE_NUTTX_TIMERS_HRTIMER_H
+#define __INCLUDE_NUTTX_TIMERS_HRTIMER_H
+
+/****************************************************************************
+ * Included Files
+ ****************************************************************************/
+
+#include <nuttx/config.h>
+
+#include <stdint.h>
+#include <stdbool.h>
+#include <time.h>
+
+#include <nuttx/timers/oneshot.h>
+
+#ifdef CONFIG_HRTIMER
+
+/****************************************************************************
+ * Pre-processor Definitions
+ ****************************************************************************/
+
+/* Values for the flags argument of hrtimer_init() */
+
+#define HRTIMER_FLAG_THREAD  0x01 /* Run the callback on the hrtimer thread */
+
+/****************************************************************************
+ * Public Types
+ ****************************************************************************/
+
+/* This describes the callback function that will be invoked when a high
+ * resolution timer expires.  Unless HRTIMER_FLAG_THREAD was selected, the
+ * callback runs in the context of the oneshot timer interrupt with
+ * interrupts disabled.  A periodic timer has already been re-armed when
+ * its callback runs, so the callback may cancel or restart the timer.
+ */
+
+struct hrtimer_s;
+typedef CODE void (*hrtimer_callback_t)(FAR struct hrtimer_s *timer,
+                                        FAR void *arg);
+
+/* This structure represents one high resolution timer.  It is provided by
+ * the caller and must stay valid until the timer expires or is cancelled.
+ */
+
+struct hrtimer_s
+{
+  FAR struct hrtimer_s *flink;  /* Link in the list of active timers */
+  struct timespec expiry;       /* Expiration time (hrtimer_gettime() base) */
+  struct timespec period;       /* Reload time; zero for a one-shot timer */
+  hrtimer_callback_t callback;  /* Function to call on expiration */
+  FAR void *arg;                /* Argument for the callback */
+  uint8_t flags;                /* See HRTIMER_FLAG_* definitions */
+  bool active;                  /* True: The timer is in the active list */
+#ifdef CONFIG_HRTIMER_THREAD
+  bool queued;                  /* True: The callback is queued */
+  FAR struct hrtimer_s *qlink;  /* Link in the callback queue */
+#endif
+  uint32_t overrun;             /* Periods missed before the last callback */
+};
+
+/****************************************************************************
+ * Public Function Prototypes
+ ****************************************************************************/
+
+#undef EXTERN
+#if defined(__cplusplus)
+#define EXTERN extern "C"
+extern "C"
+{
+#else
+#define EXTERN extern
+#endif
+
+/****************************************************************************
+ * Name: hrtimer_initialize
+ *
+ * Description:
+ *   Bind the high resolution timers to a oneshot timer.  All high
+ *   resolution timers are multiplexed over this one timer, so it must not
+ *   be used for anything else (in particular, not for CONFIG_ALARM_ARCH).
+ *   The lower half must implement the current() method.
+ *
+ * Input Parameters:
+ *   lower - An instance of the oneshot timer lower half.
+ *
+ * Returned Value:
+ *   Zero (OK) is returned on success; a negated errno value is returned
+ *   on failure.
+ *
+ ****************************************************************************/
+
+int hrtimer_initialize(FAR struct oneshot_lowerhalf_s *lower);
+
+/****************************************************************************
+ * Name: hrtimer_gettime
+ *
+ * Description:
+ *   Return the current time of the high resolution time base.
+ *
+ * Input Parameters:
+ *   ts - The location in which to return the time.
+ *
+ * Returned Value:
+ *   Zero (OK) is returned on success; -ENODEV is returned if
+ *   hrtimer_initialize() has not been called.
+ *
+ ****************************************************************************/
+
+int hrtimer_gettime(FAR struct timespec *ts);
+
+/****************************************************************************
+ * Name: hrtimer_init
+ *
+ * Description:
+ *   Initialize a high resolution timer.  The timer is not started.
+ *
+ * Input Parameters:
+ *   timer    - The timer to initialize.
+ *   callback - The function to call when the timer expires.
+ *   arg      - The argument passed to the callback.
+ *   flags    - See HRTIMER_FLAG_* definitions.
+ *
+ * Returned Value:
+ *   None
+ *
+ ****************************************************************************/
+
+void hrtimer_init(FAR struct hrtimer_s *timer, hrtimer_callback_t callback,
+                  FAR void *arg, uint8_t flags);
+
+/****************************************************************************
+ * Name: hrtimer_start
+ *
+ * Description:
+ *   Start, or restart, a high resolution timer.
+ *
+ * Input Parameters:
+ *   timer  - The timer to start.
+ *   delay  - The time until the first expiration.
+ *   period - The time between later expirations.  NULL or zero selects a
+ *            one-shot timer.
+ *
+ * Returned Value:
+ *   Zero (OK) is returned on success; a negated errno value is returned
+ *   on failure.  -ENODEV is returned if hrtimer_initialize() has not been
+ *   called; callers may fall back to a watchdog timer in that case.
+ *
+ ****************************************************************************/
+
+int hrtimer_start(FAR struct hrtimer_s *timer,
+                  FAR const struct timespec *delay,
+                  FAR const struct timespec *period);
+
+/****************************************************************************
+ * Name: hrtimer_cancel
+ *
+ * Description:
+ *   Stop a high resolution timer and discard any queued callback.  It is
+ *   not an error to cancel a timer that is not running.
+ *
+ * Input Parameters:
+ *   timer - The timer to stop.
+ *
+ * Returned Value:
+ *   Zero (OK) is always returned.
+ *
+ ****************************************************************************/
+
+int hrtimer_cancel(FAR struct hrtimer_s *timer);
+
+/****************************************************************************
+ * Name: hrtimer_remaining
+ *
+ * Description:
+ *   Return the time until the next expiration of a high resolution timer.
+ *
+ * Input Parameters:
+ *   timer - The timer to query.
+ *   ts    - The location in which to return the remaining time.
+ *
+ * Returned Value:
+ *   Zero (OK) is returned on success; -EINVAL is returned if the timer is
+ *   not running.
+ *
+ ****************************************************************************/
+
+int hrtimer_remaining(FAR struct hrtimer_s *timer, FAR struct timespec *ts);
+
+#undef EXTERN
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* CONFIG_HRTIMER */
+#endif /* __INCLUDE_NUTTX_TIMERS_HRTIMER_H */
@@ -115,12 +115,33 @@
  *   and return immediately.
  *
  *   ioctl argument:  None
+ *
+ * PWMIOC_SETSTREAMRATE - Set the rate at which duty cycle frames written to
+ *   the driver are applied to the output (CONFIG_PWM_STREAM only).  While
+ *   the output is started with a non-zero rate, each frame replaces the
+ *   duty cycle(s) of the characteristics in turn.  A frame holds one ub16_t
+ *   duty cycle per channel (see PWM_STREAM_FRAMESIZE); all channels of a
+ *   frame are updated together.  When no frame is queued, the last duty
+ *   cycle is held.  Frames are queued with write(), which blocks while the
+ *   queue is full unless the driver was opened with O_NONBLOCK.
+ *
+ *   ioctl argument:  The number of frames per second.  Zero stops
+ *   streaming and discards the queued frames.
  */
 
 #define PWMIOC_SETCHARACTERISTICS _PWMIOC(1)
 #define PWMIOC_GETCHARACTERISTICS _PWMIOC(2)
 #define PWMIOC_START              _PWMIOC(3)
 #define PWMIOC_STOP               _PWMIOC(4)
+#define PWMIOC_SETSTREAMRATE      _PWMIOC(5)
+
+/* The size of one frame of streamed duty cycles */
+
+#ifdef CONFIG_PWM_MULTICHAN
+#  define PWM_STREAM_FRAMESIZE (CONFIG_PWM_NCHANNELS * sizeof(ub16_t))
+#else
+#  define PWM_STREAM_FRAMESIZE sizeof(ub16_t)
+#endif
 
 /****************************************************************************
  * Public Types
@@ -51,7 +51,7 @@
  ****************************************************************************/
 /* Configuration ************************************************************/
 
-#ifndef CONFIG_TLS_LOG2_MAXSTACK
+#if defined(CONFIG_TLS_ALIGNED) && !defined(CONFIG_TLS_LOG2_MAXSTACK)
 #  error CONFIG_TLS_LOG2_MAXSTACK is not defined
 #endif
 
@@ -68,19 +68,22 @@
 
 /* TLS Definitions **********************************************************/
 
-#define TLS_STACK_ALIGN   (1L << CONFIG_TLS_LOG2_MAXSTACK)
-#define TLS_STACK_MASK    (TLS_STACK_ALIGN - 1)
-#define TLS_MAXSTACK      (TLS_STACK_ALIGN)
-#define TLS_INFO(sp)      ((FAR struct tls_info_s *)((sp) & ~TLS_STACK_MASK))
+#ifdef CONFIG_TLS_ALIGNED
+#  define TLS_STACK_ALIGN (1L << CONFIG_TLS_LOG2_MAXSTACK)
+#  define TLS_STACK_MASK  (TLS_STACK_ALIGN - 1)
+#  define TLS_MAXSTACK    (TLS_STACK_ALIGN)
+#  define TLS_INFO(sp)    ((FAR struct tls_info_s *)((sp) & ~TLS_STACK_MASK))
+#endif
 
 /****************************************************************************
  * Public Types
  ****************************************************************************/
-/* When TLS is enabled, up_createstack() will align allocated stacks to the
- * TLS_STACK_ALIGN value.  An instance of the following structure will be
- * implicitly positioned at the "lower" end of the stack.  Assuming a
- * "push down" stack, this is at the "far" end of the stack (and can be
- * clobbered if the stack overflows).
+/* When TLS is enabled, an instance of the following structure will be
+ * implicitly positioned at the "lower" end of the stack.  With
+ * CONFIG_TLS_ALIGNED, up_createstack() also aligns allocated stacks to the
+ * TLS_STACK_ALIGN value so that the structure can be found from the stack
+ * pointer.  Assuming a "push down" stack, this is at the "far" end of the
+ * stack (and can be clobbered if the stack overflows).
  *
  * If an MCU has a "push up" then that TLS structure will lie at the top
  * of the stack and stack allocation and initialization logic must take
@@ -93,8 +96,27 @@
 struct tls_info_s
 {
   uintptr_t tl_elem[CONFIG_TLS_NELEM]; /* TLS elements */
+#ifdef CONFIG_TLS_GETPID
+  pid_t tl_pid;                        /* Cached ID of the owning thread */
+#endif
 };
 
+/****************************************************************************
+ * Public Data
+ ****************************************************************************/
+
+#ifdef CONFIG_TLS_CURRENT
+/* The TLS information of the thread running on each CPU.  This is updated
+ * by sched_resume_scheduler() on every context switch.
+ */
+
+#  ifdef CONFIG_SMP
+extern FAR struct tls_info_s *g_tls_current[CONFIG_SMP_NCPUS];
+#  else
+extern FAR struct tls_info_s *g_tls_current[1];
+#  endif
+#endif
+
 /****************************************************************************
  * Public Function Prototypes
  ****************************************************************************/
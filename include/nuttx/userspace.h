@@ -88,6 +88,7 @@
  ****************************************************************************/
 
 struct mm_heaps_s; /* Forward reference */
+struct clock_timepage_s; /* Forward reference */
 
  /* Every user-space blob starts with a header that provides information about
  * the blob.  The form of that header is provided by struct userspace_s.  An
@@ -131,6 +132,12 @@ struct userspace_s
 #ifdef CONFIG_LIB_USRWORK
   CODE int (*work_usrstart)(void);
 #endif
+
+  /* The clock time page */
+
+#ifdef CONFIG_CLOCK_TIMEPAGE
+  FAR struct clock_timepage_s *us_timepage;
+#endif
 };
 
 /****************************************************************************
@@ -288,6 +288,15 @@
 #endif
 #endif /* CONFIG_FB_OVERLAY */
 
+#ifdef CONFIG_FB_ACCEL
+#  define FBIO_FILLRECT       _FBIOC(0x0012)  /* Fill a rectangle with a color
+                                               * Argument: read-only struct
+                                               *           fb_fillrect_s */
+#  define FBIO_COPYRECT       _FBIOC(0x0013)  /* Copy an image into a rectangle
+                                               * Argument: read-only struct
+                                               *           fb_copyrect_s */
+#endif
+
 /****************************************************************************
  * Public Types
  ****************************************************************************/
@@ -472,6 +481,34 @@ struct fb_setcursor_s
 };
 #endif
 
+#ifdef CONFIG_FB_ACCEL
+/* The following describe 2D operations that a hardware accelerator may
+ * perform on the framebuffer memory of a color plane.  Coordinates and
+ * sizes are in pixels; the source stride is in bytes.
+ */
+
+struct fb_fillrect_s
+{
+  uint8_t    planeno;     /* Color plane to be filled */
+  fb_coord_t x;           /* X position of the upper left corner */
+  fb_coord_t y;           /* Y position of the upper left corner */
+  fb_coord_t w;           /* Width of the rectangle in pixels */
+  fb_coord_t h;           /* Height of the rectangle in rows */
+  uint32_t   color;       /* Fill color in the pixel format of the plane */
+};
+
+struct fb_copyrect_s
+{
+  uint8_t    planeno;     /* Destination color plane */
+  fb_coord_t x;           /* X position of the upper left corner */
+  fb_coord_t y;           /* Y position of the upper left corner */
+  fb_coord_t w;           /* Width of the rectangle in pixels */
+  fb_coord_t h;           /* Height of the rectangle in rows */
+  FAR const void *src;    /* First source pixel, same format as the plane */
+  fb_coord_t srcstride;   /* Length of a source line in bytes */
+};
+#endif
+
 /* The framebuffer "object" is accessed through within the OS via
  * the following vtable:
  */
@@ -574,6 +611,19 @@ struct fb_vtable_s
                FAR const struct fb_overlayblend_s *blend);
 # endif
 #endif
+
+#ifdef CONFIG_FB_ACCEL
+  /* The following are provided only if the video hardware can accelerate
+   * 2D operations.  Either may be NULL.  A method returns only after the
+   * framebuffer memory has been updated; a negated errno value tells the
+   * caller to fall back to software rendering.
+   */
+
+  int (*fillrect)(FAR struct fb_vtable_s *vtable,
+                  FAR const struct fb_fillrect_s *fill);
+  int (*copyrect)(FAR struct fb_vtable_s *vtable,
+                  FAR const struct fb_copyrect_s *copy);
+#endif
 };
 
 /****************************************************************************
@@ -656,6 +706,33 @@ FAR struct fb_vtable_s *up_fbgetvplane(int display, int vplane);
 
 void up_fbuninitialize(int display);
 
+/****************************************************************************
+ * Name: up_fbaccel_fillrect and up_fbaccel_copyrect
+ *
+ * Description:
+ *   Architecture-specific 2D acceleration for framebuffer memory that is
+ *   managed by common code, such as the LCD framebuffer front end.  These
+ *   are provided by architectures that select ARCH_HAVE_FBACCEL.
+ *
+ * Input Parameters:
+ *   pinfo - Describes the framebuffer memory of the color plane.
+ *   fill  - The rectangle and color to be filled.
+ *   copy  - The destination rectangle and the source image.
+ *
+ * Returned Value:
+ *   Zero (OK) is returned when the framebuffer memory has been updated; a
+ *   negated errno value is returned if the operation cannot be accelerated
+ *   and must be performed in software.
+ *
+ ****************************************************************************/
+
+#if defined(CONFIG_FB_ACCEL) && defined(CONFIG_ARCH_HAVE_FBACCEL)
+int up_fbaccel_fillrect(FAR const struct fb_planeinfo_s *pinfo,
+                        FAR const struct fb_fillrect_s *fill);
+int up_fbaccel_copyrect(FAR const struct fb_planeinfo_s *pinfo,
+                        FAR const struct fb_copyrect_s *copy);
+#endif
+
 /****************************************************************************
  * Name: fb_register
  *
@@ -42,6 +42,7 @@
 
 #include <stdint.h>
 #include <sys/ioctl.h>
+#include <sys/time.h>
 #include "video_controls.h"
 
 #ifdef __cplusplus
@@ -187,6 +188,20 @@ extern "C"
 
 #define V4SIOC_S_EXT_CTRLS_SCENE      _VIDIOC(0x001a)
 
+/* Query the offset and length of a driver allocated buffer
+ *  (V4L2_MEMORY_MMAP).  The offset is passed to mmap() to get the address
+ *  of the buffer.
+ *  Address pointing to struct #v4l2_buffer
+ */
+
+#define VIDIOC_QUERYBUF               _VIDIOC(0x001b)
+
+/* Get the frame statistics of a stream
+ *  Address pointing to struct #v4l2_framestat
+ */
+
+#define VIDIOC_G_FRAMESTAT            _VIDIOC(0x001c)
+
 #define VIDEO_HSIZE_QVGA        (320)   /* QVGA    horizontal size */
 #define VIDEO_VSIZE_QVGA        (240)   /* QVGA    vertical   size */
 #define VIDEO_HSIZE_VGA         (640)   /* VGA     horizontal size */
@@ -268,7 +283,10 @@ enum v4l2_buf_type
   V4L2_BUF_TYPE_STILL_CAPTURE        = 0x81  /* single-planar still capture stream */
 };
 
-/* Memory I/O method. Currently, support only V4L2_MEMORY_USERPTR. */
+/* Memory I/O method. Currently, support only V4L2_MEMORY_USERPTR and
+ * V4L2_MEMORY_MMAP.  With V4L2_MEMORY_MMAP, the driver allocates the
+ * buffers on VIDIOC_REQBUFS, sized by the sizeimage of the current format.
+ */
 
 enum v4l2_memory
 {
@@ -294,7 +312,14 @@ enum v4l2_field
   V4L2_FIELD_INTERLACED_BT = 9, /* both fields interlaced, top field */
 };
 
-/* Buffer mode */
+/* Buffer mode.
+ *  In both modes, a frame that arrives when no buffer can take it is
+ *  dropped and counted in v4l2_framestat.dropped.
+ *  RING: Capture never stops while buffers are queued.  When all of them
+ *        hold frames, the oldest frame is overwritten (drop oldest).
+ *  FIFO: Capture pauses while all queued buffers hold frames, and resumes
+ *        when one is dequeued (drop newest).
+ */
 
 enum v4l2_buf_mode
 {
@@ -345,9 +370,10 @@ struct v4l2_plane
 typedef struct v4l2_plane v4l2_plane_t;
 
 /* struct v4l2_buffer
- * Parameter of ioctl(VIDIOC_QBUF) and ioctl(VIDIOC_DQBUF).
- * Currently, support only index, type, bytesused, memory,
- * m.userptr, and length.
+ * Parameter of ioctl(VIDIOC_QBUF), ioctl(VIDIOC_DQBUF) and
+ * ioctl(VIDIOC_QUERYBUF).
+ * Currently, support only index, type, bytesused, timestamp, sequence,
+ * memory, m.userptr, m.offset, and length.
  */
 
 struct v4l2_buffer
@@ -357,8 +383,10 @@ struct v4l2_buffer
   uint32_t             bytesused; /* Driver sets the image size */
   uint16_t             flags;     /* buffer flags. */
   uint16_t             field;     /* the field order of the image */
+  struct timeval       timestamp; /* Start of the frame (system time) */
   struct v4l2_timecode timecode;  /* frame timecode */
-  uint16_t             sequence;  /* frame sequence number */
+  uint16_t             sequence;  /* frame sequence number.  Gaps show
+                                   * dropped frames */
   uint16_t             memory;    /* enum #v4l2_memory */
   union
   {
@@ -372,6 +400,20 @@ struct v4l2_buffer
 
 typedef struct v4l2_buffer v4l2_buffer_t;
 
+/* struct v4l2_framestat
+ * Parameter of ioctl(VIDIOC_G_FRAMESTAT).
+ * The counters restart on VIDIOC_STREAMON.
+ */
+
+struct v4l2_framestat
+{
+  uint16_t type;     /* enum #v4l2_buf_type */
+  uint32_t frames;   /* Number of frames captured into buffers */
+  uint32_t dropped;  /* Number of frames dropped */
+};
+
+typedef struct v4l2_framestat v4l2_framestat_t;
+
 struct v4l2_fmtdesc
 {
   uint16_t index;                           /* Format number      */
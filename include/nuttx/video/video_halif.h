@@ -120,6 +120,15 @@ int video_common_notify_dma_done(uint8_t  err_code,
                                  uint32_t datasize,
                                  FAR void *priv);
 
+/* Callback function which device driver call at the start of each frame
+ * (vertical sync), also while DMA is stopped.  It timestamps the frame and
+ * counts frames that arrive when no buffer is available.
+ * This function should be called in interrupt handler or
+ * in critical section.
+ */
+
+int video_common_notify_vsync(FAR void *priv);
+
 #undef EXTERN
 #ifdef __cplusplus
 }
@@ -43,6 +43,7 @@
 
 #include <nuttx/config.h>
 
+#include <sys/types.h>
 #include <stdint.h>
 #include <queue.h>
 
@@ -147,12 +148,28 @@ struct wdog_s
   uint8_t            flags;      /* See WDOGF_* definitions above */
   uint8_t            argc;       /* The number of parameters to pass */
   wdparm_t           parm[CONFIG_MAX_WDOGPARMS];
+#ifdef CONFIG_WDOG_TIMERWHEEL
+  FAR struct wdog_s *prev;       /* Supports doubly linked wheel buckets */
+  clock_t            expire;     /* Absolute expiration time in ticks */
+  uint8_t            bucket;     /* Index of the wheel bucket */
+#endif
 };
 
 /* Watchdog 'handle' */
 
 typedef FAR struct wdog_s *WDOG_ID;
 
+/* This structure is returned by wd_info() */
+
+struct wdinfo_s
+{
+  unsigned int nactive;          /* Number of active watchdogs */
+#ifdef CONFIG_WDOG_TIMERWHEEL
+  unsigned int nlevel[CONFIG_WDOG_TIMERWHEEL_LEVELS]; /* Active watchdogs
+                                                       * per wheel level */
+#endif
+};
+
 /****************************************************************************
  * Public Data
  ****************************************************************************/
@@ -283,6 +300,23 @@ int wd_cancel(WDOG_ID wdog);
 
 int wd_gettime(WDOG_ID wdog);
 
+/****************************************************************************
+ * Name: wd_info
+ *
+ * Description:
+ *   Return a snapshot of the number of active watchdogs.  This walks all
+ *   active watchdogs and is intended for diagnostics only.
+ *
+ * Input Parameters:
+ *   info - Location to return the watchdog counts
+ *
+ * Returned Value:
+ *   None
+ *
+ ****************************************************************************/
+
+void wd_info(FAR struct wdinfo_s *info);
+
 #undef EXTERN
 #ifdef __cplusplus
 }
@@ -444,6 +444,74 @@ int work_cancel(int qid, FAR struct work_s *work);
 
 int work_signal(int qid);
 
+/****************************************************************************
+ * Name: work_queue_create
+ *
+ * Description:
+ *   Create a new, named kernel-mode work queue with its own pool of worker
+ *   threads.  This lets a driver keep slow work off of the shared high and
+ *   low priority work queues.  On SMP the worker threads may be bound to a
+ *   set of CPUs, e.g. to create one work queue per CPU.
+ *
+ * Input Parameters:
+ *   name      - Name of the worker threads
+ *   priority  - Priority of the worker threads
+ *   stacksize - Stack size of each worker thread
+ *   nthreads  - Number of worker threads (at least one)
+ *   affinity  - CPUs that the worker threads may run on.  Zero means any
+ *               CPU.  Ignored if CONFIG_SMP is not enabled.
+ *
+ * Returned Value:
+ *   A reference to the new work queue on success; NULL on failure.
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_SCHED_WORKQUEUE
+struct kwork_wqueue_s; /* Forward reference */
+
+FAR struct kwork_wqueue_s *work_queue_create(FAR const char *name,
+                                             int priority, int stacksize,
+                                             int nthreads,
+                                             cpu_set_t affinity);
+#endif
+
+/****************************************************************************
+ * Name: work_queue_free
+ *
+ * Description:
+ *   Stop the worker threads of a work queue created by work_queue_create()
+ *   and free the work queue.  Work that is still queued is discarded; the
+ *   caller must have cancelled any work that it still cares about.
+ *
+ * Input Parameters:
+ *   wqueue - The work queue to be freed.
+ *
+ * Returned Value:
+ *   Zero on success, a negated errno on failure
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_SCHED_WORKQUEUE
+int work_queue_free(FAR struct kwork_wqueue_s *wqueue);
+#endif
+
+/****************************************************************************
+ * Name: work_queue_wq and work_cancel_wq
+ *
+ * Description:
+ *   Same as work_queue() and work_cancel(), but operate on a work queue
+ *   created by work_queue_create() instead of a work queue ID.
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_SCHED_WORKQUEUE
+int work_queue_wq(FAR struct kwork_wqueue_s *wqueue,
+                  FAR struct work_s *work, worker_t worker,
+                  FAR void *arg, clock_t delay);
+int work_cancel_wq(FAR struct kwork_wqueue_s *wqueue,
+                   FAR struct work_s *work);
+#endif
+
 /****************************************************************************
  * Name: work_available
  *
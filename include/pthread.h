@@ -275,9 +275,11 @@ typedef int pthread_condattr_t;
 #define __PTHREAD_CONDATTR_T_DEFINED 1
 #endif
 
+struct pthread_mutex_s; /* Forward reference */
 struct pthread_cond_s
 {
   sem_t sem;
+  FAR struct pthread_mutex_s *mutex; /* Mutex used by the waiters */
 };
 
 #ifndef __PTHREAD_COND_T_DEFINED
@@ -285,7 +287,7 @@ typedef struct pthread_cond_s pthread_cond_t;
 #define __PTHREAD_COND_T_DEFINED 1
 #endif
 
-#define PTHREAD_COND_INITIALIZER {SEM_INITIALIZER(0)}
+#define PTHREAD_COND_INITIALIZER {SEM_INITIALIZER(0), NULL}
 
 struct pthread_mutexattr_s
 {
@@ -382,11 +384,11 @@ typedef bool pthread_once_t;
 
 struct pthread_rwlock_s
 {
-  pthread_mutex_t lock;
-  pthread_cond_t  cv;
-  unsigned int num_readers;
-  unsigned int num_writers;
-  bool write_in_progress;
+  pthread_mutex_t lock;       /* Protects the slow paths */
+  pthread_cond_t  cv;         /* Signals changes of state to waiters */
+  pthread_mutex_t wrlock;     /* Held by the writer, queues the others */
+  volatile uint32_t state;    /* Reader count and writer bits */
+  unsigned int num_writers;   /* Writers waiting for or holding the lock */
 };
 
 typedef struct pthread_rwlock_s pthread_rwlock_t;
@@ -395,7 +397,8 @@ typedef int pthread_rwlockattr_t;
 
 #define PTHREAD_RWLOCK_INITIALIZER  {PTHREAD_MUTEX_INITIALIZER, \
                                      PTHREAD_COND_INITIALIZER, \
-                                     0, 0, false}
+                                     PTHREAD_MUTEX_INITIALIZER, \
+                                     0, 0}
 
 #ifdef CONFIG_PTHREAD_SPINLOCKS
 #ifndef __PTHREAD_SPINLOCK_T_DEFINED
@@ -66,19 +66,22 @@
 
 #ifdef CONFIG_PRIORITY_INHERITANCE
 struct tcb_s; /* Forward reference */
+struct sem_s; /* Forward reference */
 struct semholder_s
 {
 #if CONFIG_SEM_PREALLOCHOLDERS > 0
-  struct semholder_s *flink;     /* Implements singly linked list */
+  struct semholder_s *flink;     /* List of holders of the semaphore */
 #endif
+  FAR struct semholder_s *tlink; /* List of semaphores held by htcb */
+  FAR struct sem_s *sem;         /* Semaphore that is held */
   FAR struct tcb_s *htcb;        /* Holder TCB */
   int16_t counts;                /* Number of counts owned by this holder */
 };
 
 #if CONFIG_SEM_PREALLOCHOLDERS > 0
-#  define SEMHOLDER_INITIALIZER {NULL, NULL, 0}
+#  define SEMHOLDER_INITIALIZER {NULL, NULL, NULL, NULL, 0}
 #else
-#  define SEMHOLDER_INITIALIZER {NULL, 0}
+#  define SEMHOLDER_INITIALIZER {NULL, NULL, NULL, 0}
 #endif
 #endif /* CONFIG_PRIORITY_INHERITANCE */
 
@@ -96,6 +99,7 @@ struct sem_s
   uint8_t flags;                 /* See PRIOINHERIT_FLAGS_* definitions */
 # if CONFIG_SEM_PREALLOCHOLDERS > 0
   FAR struct semholder_s *hhead; /* List of holders of semaphore counts */
+  struct semholder_s holder;     /* Built-in slot for the first holder */
 # else
   struct semholder_s holder[2];  /* Slot for old and new holder */
 # endif
@@ -109,7 +113,7 @@ typedef struct sem_s sem_t;
 #ifdef CONFIG_PRIORITY_INHERITANCE
 # if CONFIG_SEM_PREALLOCHOLDERS > 0
 #  define SEM_INITIALIZER(c) \
-    {(c), 0, NULL}               /* semcount, flags, hhead */
+    {(c), 0, NULL, SEMHOLDER_INITIALIZER} /* semcount, flags, hhead, holder */
 # else
 #  define SEM_INITIALIZER(c) \
     {(c), 0, {SEMHOLDER_INITIALIZER, SEMHOLDER_INITIALIZER}} /* semcount, flags, holder[2] */
@@ -277,6 +277,10 @@ int      mkstemp(FAR char *path_template);
 
 void     qsort(FAR void *base, size_t nel, size_t width,
                CODE int (*compar)(FAR const void *, FAR const void *));
+void     qsort_r(FAR void *base, size_t nel, size_t width,
+                 CODE int (*compar)(FAR const void *, FAR const void *,
+                                    FAR void *),
+                 FAR void *arg);
 
 /* Binary search */
 
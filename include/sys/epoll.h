@@ -40,6 +40,9 @@
  * Included Files
  ****************************************************************************/
 
+#include <nuttx/config.h>
+
+#include <stdint.h>
 #include <poll.h>
 
 /****************************************************************************
@@ -50,6 +53,13 @@
 #define EPOLL_CTL_DEL 2 /* Remove a file descriptor from the interface.  */
 #define EPOLL_CTL_MOD 3 /* Change file descriptor epoll_event structure.  */
 
+/* Input flags in addition to the poll events.  These are not reported in
+ * the events returned by epoll_wait().
+ */
+
+#define EPOLLONESHOT  (1u << 30) /* Disable the fd after one event */
+#define EPOLLET       (1u << 31) /* Edge-triggered notification */
+
 /****************************************************************************
  * Public Types
  ****************************************************************************/
@@ -78,33 +88,40 @@ enum EPOLL_EVENTS
 
 typedef union poll_data
 {
+  FAR void    *ptr;      /* User data pointer */
   int          fd;       /* The descriptor being polled */
+  uint32_t     u32;      /* User data value */
 } epoll_data_t;
 
 struct epoll_event
 {
-  epoll_data_t data;
-  FAR sem_t   *sem;      /* Pointer to semaphore used to post output event */
-  pollevent_t  events;   /* The input event flags */
-  pollevent_t  revents;  /* The output event flags */
-  FAR void    *priv;     /* For use by drivers */
-};
-
-struct epoll_head
-{
-  int size;
-  int occupied;
-  FAR struct epoll_event *evs;
+  uint32_t     events;   /* Requested events on input, ready events on output */
+  epoll_data_t data;     /* Returned unmodified by epoll_wait() */
 };
 
 /****************************************************************************
  * Public Function Prototypes
  ****************************************************************************/
 
+#undef EXTERN
+#if defined(__cplusplus)
+#define EXTERN extern "C"
+extern "C"
+{
+#else
+#define EXTERN extern
+#endif
+
 int epoll_create(int size);
-int epoll_ctl(int epfd, int op, int fd, struct epoll_event *ev);
-int epoll_wait(int epfd, struct epoll_event *evs, int maxevents, int timeout);
+int epoll_ctl(int epfd, int op, int fd, FAR struct epoll_event *ev);
+int epoll_wait(int epfd, FAR struct epoll_event *evs, int maxevents,
+               int timeout);
 
 void epoll_close(int epfd);
 
+#undef EXTERN
+#if defined(__cplusplus)
+}
+#endif
+
 #endif /* __INCLUDE_SYS_EPOLL_H */
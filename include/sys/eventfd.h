@@ -0,0 +1,134 @@
+/****************************************************************************
+ * include/sys/eventfd.h
+ *
+ *   Copyright (C) 2020 Gregory Nutt. All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in
+ *    the documentation and/or other materials provided with the
+ *    distribution.
+ * 3. Neither the name NuttX nor the names of its contributors may be
+ *    used to endorse or promote products derived from this software
+ *    without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+ * FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE
+ * COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+ * INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,
+ * BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS
+ * OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED
+ * AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ * LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN
+ * ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ *
+ ****************************************************************************/
+
+#ifndef __INCLUDE_SYS_EVENTFD_H
+#define __INCLUDE_SYS_EVENTFD_H
+
+/****************************************************************************
+ * Included Files
+ ****************************************************************************/
+
+#include <nuttx/config.h>
+
+#include <sys/types.h>
+#include <stdint.h>
+#include <fcntl.h>
+
+#ifdef CONFIG_EVENT_FD
+
+/****************************************************************************
+ * Pre-processor Definitions
+ ****************************************************************************/
+
+/* eventfd() flags */
+
+#define EFD_SEMAPHORE  (1 << 2)    /* read() returns 1 and decrements by 1 */
+#define EFD_NONBLOCK   O_NONBLOCK  /* read() and write() do not block */
+#define EFD_CLOEXEC    0           /* Accepted, close-on-exec is not supported */
+
+/****************************************************************************
+ * Public Type Definitions
+ ****************************************************************************/
+
+/* The type of the eventfd counter */
+
+typedef uint64_t eventfd_t;
+
+/****************************************************************************
+ * Public Function Prototypes
+ ****************************************************************************/
+
+#undef EXTERN
+#if defined(__cplusplus)
+#define EXTERN extern "C"
+extern "C"
+{
+#else
+#define EXTERN extern
+#endif
+
+/****************************************************************************
+ * Name: eventfd
+ *
+ * Description:
+ *   Create an event file descriptor.  The descriptor holds a 64-bit counter
+ *   with the initial value initval.  write() adds the 8-byte value written
+ *   to the counter; read() returns the counter and resets it to zero, or,
+ *   with EFD_SEMAPHORE, returns one and decrements it by one.  read()
+ *   blocks while the counter is zero and write() blocks while the sum would
+ *   exceed 0xfffffffffffffffe.
+ *
+ *   The descriptor is readable (POLLIN) while the counter is non-zero and
+ *   writable (POLLOUT) while at least one can be added, so it works with
+ *   poll(), select() and epoll.  Drivers signal it with eventfd_signal(),
+ *   which may be called from interrupt handlers; see
+ *   include/nuttx/fs/eventfd.h.
+ *
+ * Input Parameters:
+ *   initval - The initial counter value
+ *   flags   - EFD_SEMAPHORE, EFD_NONBLOCK and EFD_CLOEXEC
+ *
+ * Returned Value:
+ *   A file descriptor on success.  -1 (ERROR) on failure with errno set:
+ *
+ *   EINVAL - Unsupported flags
+ *   ENOMEM - Out of memory
+ *   EMFILE - Too many open file descriptors
+ *
+ ****************************************************************************/
+
+int eventfd(unsigned int initval, int flags);
+
+/****************************************************************************
+ * Name: eventfd_read and eventfd_write
+ *
+ * Description:
+ *   Read or write the 8-byte counter value of an event file descriptor.
+ *
+ * Returned Value:
+ *   Zero (OK) on success.  -1 (ERROR) on failure with errno set as by
+ *   read() or write().
+ *
+ ****************************************************************************/
+
+int eventfd_read(int fd, FAR eventfd_t *value);
+int eventfd_write(int fd, eventfd_t value);
+
+#undef EXTERN
+#if defined(__cplusplus)
+}
+#endif
+
+#endif /* CONFIG_EVENT_FD */
+#endif /* __INCLUDE_SYS_EVENTFD_H */
@@ -0,0 +1,169 @@
+/****************************************************************************
+ * include/sys/ioring.h
+ *
+ *   Copyright (C) 2020 Gregory Nutt. All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in
+ *    the documentation and/or other materials provided with the
+ *    distribution.
+ * 3. Neither the name NuttX nor the names of its contributors may be
+ *    used to endorse or promote products derived from this software
+ *    without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+ * FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE
+ * COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+ * INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,
+ * BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS
+ * OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED
+ * AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ * LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN
+ * ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ *
+ ****************************************************************************/
+
+#ifndef __INCLUDE_SYS_IORING_H
+#define __INCLUDE_SYS_IORING_H
+
+/****************************************************************************
+ * Included Files
+ ****************************************************************************/
+
+#include <nuttx/config.h>
+
+#include <sys/types.h>
+#include <stdint.h>
+
+#ifdef CONFIG_FS_IORING
+
+/****************************************************************************
+ * Pre-processor Definitions
+ ****************************************************************************/
+
+/* Submission queue entry operations (io_sqe_s::opcode) */
+
+#define IORING_OP_NOP        0  /* Do nothing, complete with res = 0 */
+#define IORING_OP_READ       1  /* read() or, if off >= 0, pread() */
+#define IORING_OP_WRITE      2  /* write() or, if off >= 0, pwrite() */
+#define IORING_OP_FSYNC      3  /* fsync() */
+#define IORING_OP_SEND       4  /* send() with msgflags */
+#define IORING_OP_RECV       5  /* recv() with msgflags */
+
+/* Submission queue entry flags (io_sqe_s::flags) */
+
+#define IOSQE_IO_LINK        (1 << 0) /* Next entry runs only if this succeeds */
+#define IOSQE_CQE_SKIP       (1 << 1) /* No completion unless this fails */
+
+/* Ring helpers.  The producer of a queue advances its tail, the consumer
+ * advances its head.  The indices run freely and are masked on access.
+ */
+
+#define IORING_SQ_SPACE(r) \
+  ((r)->sq_mask + 1 - ((r)->sq_tail - (r)->sq_head))
+#define IORING_SQ_ENTRY(r) (&(r)->sq[(r)->sq_tail & (r)->sq_mask])
+
+#define IORING_CQ_READY(r) ((r)->cq_tail - (r)->cq_head)
+#define IORING_CQ_ENTRY(r) (&(r)->cq[(r)->cq_head & (r)->cq_mask])
+
+/****************************************************************************
+ * Public Types
+ ****************************************************************************/
+
+/* Submission queue entry, filled in by the user */
+
+struct io_sqe_s
+{
+  uint8_t   opcode;     /* IORING_OP_* */
+  uint8_t   flags;      /* IOSQE_* */
+  uint16_t  msgflags;   /* MSG_* flags for IORING_OP_SEND/RECV */
+  int       fd;         /* File or socket descriptor */
+  off_t     off;        /* File offset or -1 for the current position */
+  FAR void *buf;        /* I/O buffer */
+  size_t    len;        /* Size of the I/O buffer */
+  uintptr_t user_data;  /* Returned unchanged in the completion */
+};
+
+/* Completion queue entry, filled in by io_ring_enter() */
+
+struct io_cqe_s
+{
+  uintptr_t user_data;  /* user_data of the submission */
+  ssize_t   res;        /* Result of the operation or a negated errno */
+};
+
+/* The ring and both queues are in caller memory.  The number of entries in
+ * each queue must be a power of two; sq_mask and cq_mask hold that number
+ * minus one.
+ */
+
+struct io_ring_s
+{
+  volatile uint32_t sq_head;    /* Advanced by io_ring_enter() */
+  volatile uint32_t sq_tail;    /* Advanced by the user */
+  volatile uint32_t cq_head;    /* Advanced by the user */
+  volatile uint32_t cq_tail;    /* Advanced by io_ring_enter() */
+  uint32_t sq_mask;             /* Number of submission entries - 1 */
+  uint32_t cq_mask;             /* Number of completion entries - 1 */
+  FAR struct io_sqe_s *sq;      /* Submission queue */
+  FAR struct io_cqe_s *cq;      /* Completion queue */
+};
+
+/****************************************************************************
+ * Public Function Prototypes
+ ****************************************************************************/
+
+#undef EXTERN
+#if defined(__cplusplus)
+#define EXTERN extern "C"
+extern "C"
+{
+#else
+#define EXTERN extern
+#endif
+
+/****************************************************************************
+ * Name: io_ring_enter
+ *
+ * Description:
+ *   Perform up to 'to_submit' queued operations of the ring in one call.
+ *   Each operation is performed to completion, in order, and its result is
+ *   posted to the completion queue before the next one is started.  The
+ *   call stops early if the submission queue is empty or the completion
+ *   queue is full.  Completions can then be reaped directly from the ring
+ *   without further calls.
+ *
+ *   The entry following an IOSQE_IO_LINK entry that fails completes with
+ *   -ECANCELED without being performed; the same applies to the rest of a
+ *   chain of linked entries.
+ *
+ * Input Parameters:
+ *   ring      - The ring in caller memory
+ *   to_submit - The maximum number of submission entries to consume
+ *
+ * Returned Value:
+ *   The number of submission entries consumed.  On failure, -1 (ERROR) is
+ *   returned and the errno variable is set appropriately:
+ *
+ *   EINVAL - The ring is not valid
+ *
+ ****************************************************************************/
+
+int io_ring_enter(FAR struct io_ring_s *ring, unsigned int to_submit);
+
+#undef EXTERN
+#if defined(__cplusplus)
+}
+#endif
+
+#endif /* CONFIG_FS_IORING */
+#endif /* __INCLUDE_SYS_IORING_H */
@@ -70,19 +70,26 @@
 #define SYS__exit                      (CONFIG_SYS_RESERVED + 0)
 #define SYS_exit                       (CONFIG_SYS_RESERVED + 1)
 #define SYS_get_errno                  (CONFIG_SYS_RESERVED + 2)
-#define SYS_getpid                     (CONFIG_SYS_RESERVED + 3)
-#define SYS_sched_getparam             (CONFIG_SYS_RESERVED + 4)
-#define SYS_sched_getscheduler         (CONFIG_SYS_RESERVED + 5)
-#define SYS_sched_lock                 (CONFIG_SYS_RESERVED + 6)
-#define SYS_sched_lockcount            (CONFIG_SYS_RESERVED + 7)
-#define SYS_sched_rr_get_interval      (CONFIG_SYS_RESERVED + 8)
-#define SYS_sched_setparam             (CONFIG_SYS_RESERVED + 9)
-#define SYS_sched_setscheduler         (CONFIG_SYS_RESERVED + 10)
-#define SYS_sched_unlock               (CONFIG_SYS_RESERVED + 11)
-#define SYS_sched_yield                (CONFIG_SYS_RESERVED + 12)
-#define SYS_set_errno                  (CONFIG_SYS_RESERVED + 13)
-#define SYS_uname                      (CONFIG_SYS_RESERVED + 14)
-#define __SYS_uid                      (CONFIG_SYS_RESERVED + 15)
+#define SYS_sched_getparam             (CONFIG_SYS_RESERVED + 3)
+#define SYS_sched_getscheduler         (CONFIG_SYS_RESERVED + 4)
+#define SYS_sched_lock                 (CONFIG_SYS_RESERVED + 5)
+#define SYS_sched_lockcount            (CONFIG_SYS_RESERVED + 6)
+#define SYS_sched_rr_get_interval      (CONFIG_SYS_RESERVED + 7)
+#define SYS_sched_setparam             (CONFIG_SYS_RESERVED + 8)
+#define SYS_sched_setscheduler         (CONFIG_SYS_RESERVED + 9)
+#define SYS_sched_unlock               (CONFIG_SYS_RESERVED + 10)
+#define SYS_sched_yield                (CONFIG_SYS_RESERVED + 11)
+#define SYS_set_errno                  (CONFIG_SYS_RESERVED + 12)
+#define SYS_uname                      (CONFIG_SYS_RESERVED + 13)
+
+/* getpid() is not a system call if the PID is cached in the TLS data */
+
+#ifdef CONFIG_TLS_GETPID
+#  define __SYS_uid                    (CONFIG_SYS_RESERVED + 14)
+#else
+#  define SYS_getpid                   (CONFIG_SYS_RESERVED + 14)
+#  define __SYS_uid                    (CONFIG_SYS_RESERVED + 15)
+#endif
 
 /* User identity */
 
@@ -253,13 +260,22 @@
 
 #define SYS_clock                      (__SYS_clock + 0)
 #define SYS_clock_getres               (__SYS_clock + 1)
-#define SYS_clock_gettime              (__SYS_clock + 2)
-#define SYS_clock_settime              (__SYS_clock + 3)
+#define SYS_clock_settime              (__SYS_clock + 2)
+
+/* clock_gettime() is not a system call if the time page is enabled */
+
+#ifdef CONFIG_CLOCK_TIMEPAGE
+#  define __SYS_adjtime                (__SYS_clock + 3)
+#else
+#  define SYS_clock_gettime            (__SYS_clock + 3)
+#  define __SYS_adjtime                (__SYS_clock + 4)
+#endif
+
 #ifdef CONFIG_CLOCK_TIMEKEEPING
-#  define SYS_adjtime                  (__SYS_clock + 4)
-#  define __SYS_timers                 (__SYS_clock + 5)
+#  define SYS_adjtime                  (__SYS_adjtime + 0)
+#  define __SYS_timers                 (__SYS_adjtime + 1)
 #else
-#  define __SYS_timers                 (__SYS_clock + 4)
+#  define __SYS_timers                 __SYS_adjtime
 #endif
 
 /* The following are defined only if POSIX timers are supported */
@@ -313,7 +329,30 @@
 #define SYS_select                   (__SYS_poll + 1)
 #define SYS_ppoll                    (__SYS_poll + 2)
 #define SYS_pselect                  (__SYS_poll + 3)
-#define __SYS_ifindex                (__SYS_poll + 4)
+#define __SYS_ioring                 (__SYS_poll + 4)
+
+#ifdef CONFIG_FS_IORING
+#  define SYS_io_ring_enter          __SYS_ioring
+#  define __SYS_eventfd              (__SYS_ioring + 1)
+#else
+#  define __SYS_eventfd              __SYS_ioring
+#endif
+
+#ifdef CONFIG_EVENT_FD
+#  define SYS_eventfd                __SYS_eventfd
+#  define __SYS_timerfd              (__SYS_eventfd + 1)
+#else
+#  define __SYS_timerfd              __SYS_eventfd
+#endif
+
+#ifdef CONFIG_TIMER_FD
+#  define SYS_timerfd_create         __SYS_timerfd
+#  define SYS_timerfd_settime        (__SYS_timerfd + 1)
+#  define SYS_timerfd_gettime        (__SYS_timerfd + 2)
+#  define __SYS_ifindex              (__SYS_timerfd + 3)
+#else
+#  define __SYS_ifindex              __SYS_timerfd
+#endif
 
 #ifdef CONFIG_NETDEV_IFINDEX
 #  define SYS_if_indextoname         __SYS_ifindex
@@ -360,7 +399,8 @@
 
 #ifdef CONFIG_FS_RAMMAP
 #  define SYS_munmap                   (__SYS_filedesc + 16)
-#  define __SYS_link                   (__SYS_filedesc + 17)
+#  define SYS_msync                    (__SYS_filedesc + 17)
+#  define __SYS_link                   (__SYS_filedesc + 18)
 #else
 #  define __SYS_link                   (__SYS_filedesc + 16)
 #endif
@@ -395,8 +435,8 @@
 #  define __SYS_sendfile               (__SYS_fs_fdopen + 0)
 #endif
 
-#if defined(CONFIG_NET_SENDFILE)
-#  define SYS_sendfile,                __SYS_sendfile
+#if defined(CONFIG_FS_SENDFILE)
+#  define SYS_sendfile                 __SYS_sendfile
 #  define __SYS_mountpoint             (__SYS_sendfile + 1)
 #else
 #  define __SYS_mountpoint             __SYS_sendfile
@@ -428,9 +468,17 @@
 #  define SYS_shmat                    (__SYS_shm + 1)
 #  define SYS_shmctl                   (__SYS_shm + 2)
 #  define SYS_shmdt                    (__SYS_shm + 3)
-#  define __SYS_pthread                (__SYS_shm + 4)
+#  define __SYS_posix_shm              (__SYS_shm + 4)
+#else
+#  define __SYS_posix_shm              __SYS_shm
+#endif
+
+#ifdef CONFIG_FS_SHM
+#  define SYS_shm_open                 (__SYS_posix_shm + 0)
+#  define SYS_shm_unlink               (__SYS_posix_shm + 1)
+#  define __SYS_pthread                (__SYS_posix_shm + 2)
 #else
-#  define __SYS_pthread                __SYS_shm
+#  define __SYS_pthread                __SYS_posix_shm
 #endif
 
 /* The following are defined if pthreads are enabled */
@@ -548,7 +596,12 @@
 #  define SYS_send                     (__SYS_network + 9)
 #  define SYS_sendto                   (__SYS_network + 10)
 #  define SYS_setsockopt               (__SYS_network + 11)
-#  define SYS_socket                   (__SYS_network + 12)
+#  define SYS_recvmsg                  (__SYS_network + 12)
+#  define SYS_sendmsg                  (__SYS_network + 13)
+#  define SYS_recvmmsg                 (__SYS_network + 14)
+#  define SYS_sendmmsg                 (__SYS_network + 15)
+#  define SYS_socketpair               (__SYS_network + 16)
+#  define SYS_socket                   (__SYS_network + 17)
 #else
 #  define SYS_socket                    __SYS_network
 #endif
@@ -624,6 +677,15 @@ EXTERN const uintptr_t g_stublookup[SYS_nsyscalls];
 
 EXTERN const uint8_t g_funcnparms[SYS_nsyscalls];
 
+#ifdef CONFIG_SYSCALL_FASTPATH
+/* Given the system call number, the corresponding entry in this table is
+ * non-zero if the stub may be called directly from the system call
+ * exception handler without a full context save.
+ */
+
+EXTERN const uint8_t g_stubfast[SYS_nsyscalls];
+#endif
+
 /****************************************************************************
  * Public Functions
  ****************************************************************************/
@@ -0,0 +1,139 @@
+/****************************************************************************
+ * include/sys/timerfd.h
+ *
+ *   Copyright (C) 2020 Gregory Nutt. All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in
+ *    the documentation and/or other materials provided with the
+ *    distribution.
+ * 3. Neither the name NuttX nor the names of its contributors may be
+ *    used to endorse or promote products derived from this software
+ *    without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+ * FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE
+ * COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+ * INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,
+ * BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS
+ * OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED
+ * AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ * LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN
+ * ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ *
+ ****************************************************************************/
+
+#ifndef __INCLUDE_SYS_TIMERFD_H
+#define __INCLUDE_SYS_TIMERFD_H
+
+/****************************************************************************
+ * Included Files
+ ****************************************************************************/
+
+#include <nuttx/config.h>
+
+#include <sys/types.h>
+#include <stdint.h>
+#include <fcntl.h>
+#include <time.h>
+
+#ifdef CONFIG_TIMER_FD
+
+/****************************************************************************
+ * Pre-processor Definitions
+ ****************************************************************************/
+
+/* timerfd_create() flags */
+
+#define TFD_NONBLOCK       O_NONBLOCK  /* read() does not block */
+#define TFD_CLOEXEC        0           /* Accepted, close-on-exec is not supported */
+
+/* timerfd_settime() flags */
+
+#define TFD_TIMER_ABSTIME  TIMER_ABSTIME
+
+/****************************************************************************
+ * Public Type Definitions
+ ****************************************************************************/
+
+/* The type of the expiration count returned by read() */
+
+typedef uint64_t timerfd_t;
+
+/****************************************************************************
+ * Public Function Prototypes
+ ****************************************************************************/
+
+#undef EXTERN
+#if defined(__cplusplus)
+#define EXTERN extern "C"
+extern "C"
+{
+#else
+#define EXTERN extern
+#endif
+
+/****************************************************************************
+ * Name: timerfd_create
+ *
+ * Description:
+ *   Create a timer file descriptor.  The timer is armed and disarmed with
+ *   timerfd_settime().  read() returns the 8-byte number of expirations
+ *   since the last read() and blocks while there were none, so an overrun
+ *   of a periodic timer is reported as a count rather than lost.
+ *
+ *   The descriptor is readable (POLLIN) while the expiration count is
+ *   non-zero, so it works with poll(), select() and epoll.
+ *
+ * Input Parameters:
+ *   clockid - CLOCK_REALTIME or CLOCK_MONOTONIC
+ *   flags   - TFD_NONBLOCK and TFD_CLOEXEC
+ *
+ * Returned Value:
+ *   A file descriptor on success.  -1 (ERROR) on failure with errno set:
+ *
+ *   EINVAL - Unsupported clock or flags
+ *   ENOMEM - Out of memory
+ *   EMFILE - Too many open file descriptors
+ *
+ ****************************************************************************/
+
+int timerfd_create(int clockid, int flags);
+
+/****************************************************************************
+ * Name: timerfd_settime and timerfd_gettime
+ *
+ * Description:
+ *   Arm, disarm and query the timer of a timer file descriptor, with the
+ *   semantics of timer_settime() and timer_gettime().  Arming the timer
+ *   resets the expiration count.
+ *
+ * Returned Value:
+ *   Zero (OK) on success.  -1 (ERROR) on failure with errno set:
+ *
+ *   EBADF  - fd is not a valid file descriptor
+ *   EINVAL - fd is not a timer file descriptor or new_value is invalid
+ *
+ ****************************************************************************/
+
+int timerfd_settime(int fd, int flags,
+                    FAR const struct itimerspec *new_value,
+                    FAR struct itimerspec *old_value);
+int timerfd_gettime(int fd, FAR struct itimerspec *curr_value);
+
+#undef EXTERN
+#if defined(__cplusplus)
+}
+#endif
+
+#endif /* CONFIG_TIMER_FD */
+#endif /* __INCLUDE_SYS_TIMERFD_H */
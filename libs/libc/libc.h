@@ -121,6 +121,22 @@
 
 #define LIB_BUFLEN_UNKNOWN INT_MAX
 
+/* Helpers for the word-at-a-time string functions.  LIB_HASZERO() is
+ * non-zero if any byte of the 32-bit word 'x' is zero.  The lowest set
+ * 0x80 bit marks the first zero byte; higher ones may be false positives,
+ * so callers finish the word a byte at a time.  LIB_BYTEMASK() replicates
+ * the byte 'c' into all four bytes of a word.
+ *
+ * Aligned word reads never cross a page or MPU region boundary, so
+ * reading the rest of the word that holds a terminating NUL is safe.
+ */
+
+#define LIB_UNALIGNED(p)    (((uintptr_t)(p) & (sizeof(uint32_t) - 1)) != 0)
+#define LIB_COALIGNED(p, q) ((((uintptr_t)(p) ^ (uintptr_t)(q)) & \
+                              (sizeof(uint32_t) - 1)) == 0)
+#define LIB_HASZERO(x)      (((x) - 0x01010101u) & ~(x) & 0x80808080u)
+#define LIB_BYTEMASK(c)     ((uint32_t)(uint8_t)(c) * 0x01010101u)
+
 /****************************************************************************
  * Public Types
  ****************************************************************************/
@@ -185,6 +201,14 @@ int lib_rdflush(FAR FILE *stream);
 
 int lib_wrflush(FAR FILE *stream);
 
+/* Defined in lib_lazybuffer.c */
+
+#ifdef CONFIG_STDIO_LAZY_BUFFER
+void lib_lazybuffer(FAR FILE *stream);
+#else
+#  define lib_lazybuffer(s)
+#endif
+
 /* Defined in lib_sem.c */
 
 #ifndef CONFIG_STDIO_DISABLE_BUFFERING
@@ -222,6 +246,14 @@ double lib_expi(size_t n);
 float lib_sqrtapprox(float x);
 #endif
 
+/* Defined in lib_libsinf.c */
+
+#ifdef CONFIG_LIBM_FAST
+int32_t lib_rempio2f(float x, FAR float *r);
+float lib_sinf_poly(float r);
+float lib_cosf_poly(float r);
+#endif
+
 /* Defined in lib_parsehostfile.c */
 
 #ifdef CONFIG_NETDB_HOSTFILE
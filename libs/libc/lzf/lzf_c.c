@@ -74,7 +74,7 @@
 #endif
 
 #define MAX_LIT     (1 <<  5)
-#define MAX_OFF     (1 << HLOG)
+#define MAX_OFF     (1 << 13)     /* Set by the 13-bit offset field */
 #define MAX_REF     ((1 << 8) + (1 << 3))
 
 #if __GNUC__ >= 3
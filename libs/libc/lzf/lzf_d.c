@@ -34,6 +34,14 @@
 
 #ifdef CONFIG_LIBC_LZF
 
+/****************************************************************************
+ * Pre-processor Definitions
+ ****************************************************************************/
+
+/* Copies shorter than this are done octet by octet inline */
+
+#define LZF_COPY_MIN 16
+
 /****************************************************************************
  * Public Functions
  ****************************************************************************/
@@ -92,109 +100,26 @@ unsigned int lzf_decompress (FAR const void *const in_data,
 #ifdef lzf_movsb
           lzf_movsb(op, ip, ctrl);
 #else
-          switch (ctrl)
+          if (ctrl >= LZF_COPY_MIN)
             {
-              case 32:
-                *op++ = *ip++;
-
-              case 31:
-                *op++ = *ip++;
-
-              case 30:
-                *op++ = *ip++;
-
-              case 29:
-                *op++ = *ip++;
-
-              case 28:
-                *op++ = *ip++;
-
-              case 27:
-                *op++ = *ip++;
-
-              case 26:
-                *op++ = *ip++;
-
-              case 25:
-                *op++ = *ip++;
-
-              case 24:
-                *op++ = *ip++;
-
-              case 23:
-                *op++ = *ip++;
-
-              case 22:
-                *op++ = *ip++;
-
-              case 21:
-                *op++ = *ip++;
-
-              case 20:
-                *op++ = *ip++;
-
-              case 19:
-                *op++ = *ip++;
-
-              case 18:
-                *op++ = *ip++;
-
-              case 17:
-                *op++ = *ip++;
-
-              case 16:
-                *op++ = *ip++;
-
-              case 15:
-                *op++ = *ip++;
-
-              case 14:
-                *op++ = *ip++;
-
-              case 13:
-                *op++ = *ip++;
-
-              case 12:
-                *op++ = *ip++;
-
-              case 11:
-                *op++ = *ip++;
-
-              case 10:
-                *op++ = *ip++;
-
-              case 9:
-                *op++ = *ip++;
-
-              case 8:
-                *op++ = *ip++;
-
-              case 7:
-                *op++ = *ip++;
-
-              case 6:
-                *op++ = *ip++;
-
-              case 5:
-                *op++ = *ip++;
-
-              case 4:
-                *op++ = *ip++;
-
-              case 3:
-                *op++ = *ip++;
-
-              case 2:
-                *op++ = *ip++;
-
-              case 1:
-                *op++ = *ip++;
+              memcpy(op, ip, ctrl);
+              op += ctrl;
+              ip += ctrl;
+            }
+          else
+            {
+              do
+                {
+                  *op++ = *ip++;
+                }
+              while (--ctrl);
             }
 #endif
         }
       else /* back reference */
         {
           unsigned int len = ctrl >> 5;
+          size_t dist;
 
           FAR uint8_t *ref = op - ((ctrl & 0x1f) << 8) - 1;
 
@@ -231,67 +156,63 @@ unsigned int lzf_decompress (FAR const void *const in_data,
               return 0;
             }
 
-#ifdef lzf_movsb
           len += 2;
+
+#ifdef lzf_movsb
           lzf_movsb(op, ref, len);
 #else
-          switch (len)
+          dist = op - ref;
+          if (len < LZF_COPY_MIN)
             {
-              default:
-                len += 2;
-
-                if (op >= ref + len)
-                  {
-                    /* Disjunct areas */
-
-                    memcpy (op, ref, len);
-                    op += len;
-                  }
-                else
-                  {
-                    /* Overlapping, use octet by octet copying */
-
-                    do
-                      {
-                        *op++ = *ref++;
-                      }
-                    while (--len);
-                  }
-
-                break;
-
-              case 9:
-                *op++ = *ref++;
-
-              case 8:
-                *op++ = *ref++;
-
-              case 7:
-                *op++ = *ref++;
-
-              case 6:
-                *op++ = *ref++;
+              /* Too short for a call to pay off */
 
-              case 5:
-                *op++ = *ref++;
-
-              case 4:
-                *op++ = *ref++;
+              do
+                {
+                  *op++ = *ref++;
+                }
+              while (--len);
+            }
+          else if (dist >= len)
+            {
+              /* Disjunct areas */
 
-              case 3:
-                *op++ = *ref++;
+              memcpy(op, ref, len);
+              op += len;
+            }
+          else if (dist == 1)
+            {
+              /* A run of a single octet */
 
-              case 2:
-                *op++ = *ref++;
+              memset(op, *ref, len);
+              op += len;
+            }
+          else if (dist >= sizeof(uint32_t))
+            {
+              /* Overlapping, but each word only reads octets that are
+               * already in place.
+               */
 
-              case 1:
-                *op++ = *ref++;
+              for (; len >= sizeof(uint32_t); len -= sizeof(uint32_t))
+                {
+                  memcpy(op, ref, sizeof(uint32_t));
+                  op  += sizeof(uint32_t);
+                  ref += sizeof(uint32_t);
+                }
 
-              case 0:
-                /* Two octets more */
+              while (len-- > 0)
+                {
+                  *op++ = *ref++;
+                }
+            }
+          else
+            {
+              /* Short overlapping pattern, use octet by octet copying */
 
-                *op++ = *ref++;
-                *op++ = *ref++;
+              do
+                {
+                  *op++ = *ref++;
+                }
+              while (--len);
             }
 #endif
         }
@@ -0,0 +1,164 @@
+/****************************************************************************
+ * libs/libc/lzf/lzf_stream.c
+ *
+ *   Copyright (C) 2020 Gregory Nutt. All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in
+ *    the documentation and/or other materials provided with the
+ *    distribution.
+ * 3. Neither the name NuttX nor the names of its contributors may be
+ *    used to endorse or promote products derived from this software
+ *    without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+ * FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE
+ * COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+ * INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,
+ * BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS
+ * OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED
+ * AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ * LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN
+ * ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ *
+ ****************************************************************************/
+
+/****************************************************************************
+ * Included Files
+ ****************************************************************************/
+
+#include "lzf/lzf.h"
+
+#ifdef CONFIG_LIBC_LZF
+
+/****************************************************************************
+ * Private Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: lzf_stream_block
+ *
+ * Description:
+ *   Compress the gathered input and pass the resulting block to the output
+ *   callback.
+ *
+ ****************************************************************************/
+
+static int lzf_stream_block(FAR struct lzf_stream_s *stream)
+{
+  FAR struct lzf_header_s *header;
+  size_t len;
+  int ret;
+
+  /* Ask for at least one byte of saving; lzf_compress() stores the block
+   * uncompressed if it cannot get it.
+   */
+
+  len = lzf_compress(stream->inbuf, stream->nbuffered, stream->outbuf,
+                     stream->nbuffered - 1, stream->htab, &header);
+
+  ret = stream->output(stream->arg, header, len);
+  if (ret < 0)
+    {
+      return ret;
+    }
+
+  stream->nbuffered = 0;
+  return OK;
+}
+
+/****************************************************************************
+ * Public Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: lzf_stream_init
+ ****************************************************************************/
+
+int lzf_stream_init(FAR struct lzf_stream_s *stream, FAR void *inbuf,
+                    FAR void *outbuf, size_t blocksize,
+                    lzf_output_t output, FAR void *arg)
+{
+  if (stream == NULL || inbuf == NULL || outbuf == NULL ||
+      output == NULL || blocksize == 0 || blocksize > UINT16_MAX)
+    {
+      return -EINVAL;
+    }
+
+  stream->output    = output;
+  stream->arg       = arg;
+  stream->inbuf     = (FAR uint8_t *)inbuf + LZF_TYPE0_HDR_SIZE;
+  stream->outbuf    = (FAR uint8_t *)outbuf + LZF_TYPE1_HDR_SIZE;
+  stream->blocksize = blocksize;
+  stream->nbuffered = 0;
+  return OK;
+}
+
+/****************************************************************************
+ * Name: lzf_stream_write
+ ****************************************************************************/
+
+ssize_t lzf_stream_write(FAR struct lzf_stream_s *stream,
+                         FAR const void *data, size_t len)
+{
+  FAR const uint8_t *src = data;
+  size_t ncopy;
+  size_t total = 0;
+  int ret;
+
+  while (len > 0)
+    {
+      ncopy = stream->blocksize - stream->nbuffered;
+      if (ncopy > len)
+        {
+          ncopy = len;
+        }
+
+      memcpy(stream->inbuf + stream->nbuffered, src, ncopy);
+      stream->nbuffered += ncopy;
+      src   += ncopy;
+      len   -= ncopy;
+      total += ncopy;
+
+      if (stream->nbuffered == stream->blocksize)
+        {
+          ret = lzf_stream_block(stream);
+          if (ret < 0)
+            {
+              /* The full block stays buffered and is retried by the next
+               * write or flush.  Report the error only if nothing was
+               * consumed by this call.
+               */
+
+              return total > 0 ? total : ret;
+            }
+        }
+    }
+
+  return total;
+}
+
+/****************************************************************************
+ * Name: lzf_stream_flush
+ ****************************************************************************/
+
+int lzf_stream_flush(FAR struct lzf_stream_s *stream)
+{
+  if (stream->nbuffered == 0)
+    {
+      return OK;
+    }
+
+  return lzf_stream_block(stream);
+}
+
+#endif /* CONFIG_LIBC_LZF */
@@ -29,6 +29,8 @@
  * Included Files
  ****************************************************************************/
 
+#include <nuttx/config.h>
+
 #include <math.h>
 
 /****************************************************************************
@@ -65,3 +67,24 @@ float atan2f(float y, float x)
       return 0;
     }
 }
+
+/****************************************************************************
+ * Name: atan2f_array
+ *
+ * Description:
+ *   Compute atan2f(y[i], x[i]) for n pairs of values.
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_LIBM_FAST
+void atan2f_array(FAR const float *y, FAR const float *x, FAR float *r,
+                  size_t n)
+{
+  size_t i;
+
+  for (i = 0; i < n; i++)
+    {
+      r[i] = atan2f(y[i], x[i]);
+    }
+}
+#endif
@@ -29,15 +29,67 @@
  * Included Files
  ****************************************************************************/
 
+#include <nuttx/config.h>
+
 #include <math.h>
 #include <stddef.h>
 #include <stdint.h>
 
+/****************************************************************************
+ * Pre-processor Definitions
+ ****************************************************************************/
+
+#ifdef CONFIG_LIBM_FAST
+#  define TAN_3PI_8     2.414213562F
+#  define TAN_PI_8      0.414213562F
+#endif
+
 /****************************************************************************
  * Public Functions
  ****************************************************************************/
 
+#ifdef CONFIG_LIBM_FAST
+float atanf(float x)
+{
+  float a = fabsf(x);
+  float y;
+  float z;
+
+  if (isnan(x))
+    {
+      return x;
+    }
+
+  /* Reduce |x| to [0, tan(pi/8)] using
+   *   atan(a) = pi/2 - atan(1/a) and atan(a) = pi/4 + atan((a-1)/(a+1))
+   */
+
+  if (a > TAN_3PI_8)
+    {
+      y = M_PI_2_F;
+      a = -1.0F / a;
+    }
+  else if (a > TAN_PI_8)
+    {
+      y = (float)M_PI_4;
+      a = (a - 1.0F) / (a + 1.0F);
+    }
+  else
+    {
+      y = 0.0F;
+    }
+
+  /* Minimax polynomial, relative error below 2 ulp (Cephes) */
+
+  z  = a * a;
+  y += (((8.05374449538e-2F * z - 1.38776856032e-1F) * z +
+         1.99777106478e-1F) * z - 3.33329491539e-1F) * z * a + a;
+
+  return x < 0.0F ? -y : y;
+}
+#else
 float atanf(float x)
 {
   return asinf(x / sqrtf(x * x + 1.0F));
 }
+#endif
@@ -29,13 +29,47 @@
  * Included Files
  ****************************************************************************/
 
+#include <nuttx/config.h>
+
+#include <stdint.h>
 #include <math.h>
 
+#include "libc.h"
+
 /****************************************************************************
  * Public Functions
  ****************************************************************************/
 
+#ifdef CONFIG_LIBM_FAST
+float cosf(float x)
+{
+  int32_t n;
+  float r;
+
+  if (isnan(x) || isinf_f(x))
+    {
+      return NAN_F;
+    }
+
+  n = lib_rempio2f(x, &r);
+  switch (n & 3)
+    {
+      case 0:
+        return lib_cosf_poly(r);
+
+      case 1:
+        return -lib_sinf_poly(r);
+
+      case 2:
+        return -lib_cosf_poly(r);
+
+      default:
+        return lib_sinf_poly(r);
+    }
+}
+#else
 float cosf(float x)
 {
   return sinf(x + M_PI_2_F);
 }
+#endif
@@ -29,15 +29,36 @@
  * Included Files
  ****************************************************************************/
 
+#include <nuttx/config.h>
+
 #include <sys/types.h>
+#include <stdint.h>
 #include <math.h>
 
 #include "libc.h"
 
+/****************************************************************************
+ * Pre-processor Definitions
+ ****************************************************************************/
+
+#ifdef CONFIG_LIBM_FAST
+/* ln(2) split so that n * LN2_HI is exact */
+
+#  define LN2_HI        0.693359375F
+#  define LN2_LO        -2.12194440e-4F
+
+/* Results above FLT_MAX / below the smallest subnormal */
+
+#  define EXPF_MAX_X    88.72283905F
+#  define EXPF_MIN_X    -103.97207708F
+#endif
+
 /****************************************************************************
  * Private Data
  ****************************************************************************/
 
+#ifndef CONFIG_LIBM_FAST
+
 static float _flt_inv_fact[] =
 {
   1.0 / 1.0,                    /* 1/0! */
@@ -52,11 +73,74 @@ static float _flt_inv_fact[] =
   1.0 / 362880.0,               /* 1/9! */
   1.0 / 3628800.0,              /* 1/10! */
 };
+#endif
 
 /****************************************************************************
  * Public Functions
  ****************************************************************************/
 
+#ifdef CONFIG_LIBM_FAST
+float expf(float x)
+{
+  union
+  {
+    float f;
+    uint32_t i;
+  } scale;
+
+  int32_t n;
+  float r;
+  float p;
+
+  if (isnan(x))
+    {
+      return x;
+    }
+
+  if (x > EXPF_MAX_X)
+    {
+      return INFINITY_F;
+    }
+
+  if (x < EXPF_MIN_X)
+    {
+      return 0.0F;
+    }
+
+  /* x = n * ln(2) + r with |r| <= ln(2) / 2, so exp(x) = 2^n * exp(r) */
+
+  n = (int32_t)(x * (float)M_LOG2E + (x < 0.0F ? -0.5F : 0.5F));
+  r = x - (float)n * LN2_HI - (float)n * LN2_LO;
+
+  /* Minimax polynomial for exp(r), relative error below 1 ulp (Cephes) */
+
+  p = 1.9875691500e-4F;
+  p = p * r + 1.3981999507e-3F;
+  p = p * r + 8.3334519073e-3F;
+  p = p * r + 4.1665795894e-2F;
+  p = p * r + 1.6666665459e-1F;
+  p = p * r + 5.0000001201e-1F;
+  p = p * r * r + r + 1.0F;
+
+  /* Scale by 2^n through the exponent field.  n can fall just outside the
+   * normal exponent range at both ends, so scale in two steps there.
+   */
+
+  if (n > 127)
+    {
+      p *= 2.0F;
+      n--;
+    }
+  else if (n < -126)
+    {
+      p *= 1.17549435e-38F;   /* 2^-126 */
+      n += 126;
+    }
+
+  scale.i = (uint32_t)(n + 127) << 23;
+  return p * scale.f;
+}
+#else
 float expf(float x)
 {
   size_t int_part;
@@ -110,3 +194,4 @@ float expf(float x)
       return value;
     }
 }
+#endif
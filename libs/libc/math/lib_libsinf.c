@@ -0,0 +1,123 @@
+/****************************************************************************
+ * libs/libc/math/lib_libsinf.c
+ *
+ *   Copyright (C) 2020 Gregory Nutt. All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in
+ *    the documentation and/or other materials provided with the
+ *    distribution.
+ * 3. Neither the name NuttX nor the names of its contributors may be
+ *    used to endorse or promote products derived from this software
+ *    without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+ * FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE
+ * COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+ * INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,
+ * BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS
+ * OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED
+ * AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ * LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN
+ * ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ *
+ ****************************************************************************/
+
+/****************************************************************************
+ * Included Files
+ ****************************************************************************/
+
+#include <nuttx/config.h>
+
+#include <stdint.h>
+#include <math.h>
+
+#include "libc.h"
+
+#ifdef CONFIG_LIBM_FAST
+
+/****************************************************************************
+ * Pre-processor Definitions
+ ****************************************************************************/
+
+/* pi/2 split in three parts (Cody-Waite).  The first two have few enough
+ * significant bits that n * part is exact for |n| < 2^15.
+ */
+
+#define PIO2_1   1.5703125F
+#define PIO2_2   4.837512969970703125e-4F
+#define PIO2_3   7.54978995489188216e-8F
+
+/* Above this the three-part reduction loses too many bits and x is first
+ * folded into [-2*pi, 2*pi] with fmodf().
+ */
+
+#define PIO2_MAX 8192.0F
+
+/****************************************************************************
+ * Public Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: lib_rempio2f
+ *
+ * Description:
+ *   Reduce x to r = x - n * pi/2 with |r| <= pi/4 and return n.  The
+ *   reduction is accurate for |x| up to PIO2_MAX; beyond that the result
+ *   is only as good as fmodf().  x must be finite.
+ *
+ ****************************************************************************/
+
+int32_t lib_rempio2f(float x, FAR float *r)
+{
+  int32_t n;
+  float fn;
+
+  if (fabsf(x) > PIO2_MAX)
+    {
+      x = fmodf(x, 2 * M_PI_F);
+    }
+
+  n  = (int32_t)(x * (float)M_2_PI + (x < 0.0F ? -0.5F : 0.5F));
+  fn = (float)n;
+
+  *r = ((x - fn * PIO2_1) - fn * PIO2_2) - fn * PIO2_3;
+  return n;
+}
+
+/****************************************************************************
+ * Name: lib_sinf_poly, lib_cosf_poly
+ *
+ * Description:
+ *   Minimax polynomials for sin(r) and cos(r) on [-pi/4, pi/4], with an
+ *   error below 1 ulp (coefficients from the Cephes library).
+ *
+ ****************************************************************************/
+
+float lib_sinf_poly(float r)
+{
+  float z = r * r;
+
+  return r + r * z * ((-1.9515295891e-4F * z + 8.3321608736e-3F) * z -
+                      1.6666654611e-1F);
+}
+
+float lib_cosf_poly(float r)
+{
+  float z = r * r;
+
+  return 1.0F - 0.5F * z +
+         z * z * ((2.443315711809948e-5F * z - 1.388731625493765e-3F) * z +
+                  4.166664568298827e-2F);
+}
+
+#endif /* CONFIG_LIBM_FAST */
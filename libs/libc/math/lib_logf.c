@@ -29,13 +29,26 @@
  * Included Files
  ****************************************************************************/
 
+#include <nuttx/config.h>
+
+#include <stdint.h>
 #include <math.h>
 #include <float.h>
+#include <errno.h>
+
+#include "libc.h"
 
 /****************************************************************************
  * Pre-processor Definitions
  ****************************************************************************/
 
+#ifdef CONFIG_LIBM_FAST
+/* ln(2) split so that e * LN2_HI is exact */
+
+#  define LN2_HI        0.693359375F
+#  define LN2_LO        -2.12194440e-4F
+#endif
+
 #define FLT_MAX_EXP_X   88.0F
 
 /* To avoid looping forever in particular corner cases, every LOGF_MAX_ITER
@@ -54,6 +67,78 @@
  * Name: logf
  ****************************************************************************/
 
+#ifdef CONFIG_LIBM_FAST
+float logf(float x)
+{
+  union
+  {
+    float f;
+    uint32_t i;
+  } u;
+
+  int32_t e;
+  float z;
+  float p;
+  float y;
+
+  if (isnan(x))
+    {
+      return x;
+    }
+
+  if (x < 0.0F)
+    {
+      set_errno(EDOM);
+      return NAN_F;
+    }
+
+  if (x == 0.0F)
+    {
+      set_errno(ERANGE);
+      return -INFINITY_F;
+    }
+
+  if (isinf_f(x))
+    {
+      return x;
+    }
+
+  /* Split x = 2^e * m with m in [sqrt(2)/2, sqrt(2)) */
+
+  u.f = x;
+  e   = 0;
+  if (u.i < 0x00800000)
+    {
+      u.f *= 16777216.0F;       /* 2^24: normalize subnormals */
+      e    = -24;
+    }
+
+  e  += (int32_t)(u.i >> 23) - 126;
+  u.i = (u.i & 0x007fffff) | 0x3f000000;
+  if (u.f < (float)(M_SQRT2 / 2))
+    {
+      u.f += u.f;
+      e--;
+    }
+
+  /* log(m) = z - z^2 / 2 + z^3 * P(z) with z = m - 1 (Cephes) */
+
+  z = u.f - 1.0F;
+  p = 7.0376836292e-2F;
+  p = p * z - 1.1514610310e-1F;
+  p = p * z + 1.1676998740e-1F;
+  p = p * z - 1.2420140846e-1F;
+  p = p * z + 1.4249322787e-1F;
+  p = p * z - 1.6668057665e-1F;
+  p = p * z + 2.0000714765e-1F;
+  p = p * z - 2.4999993993e-1F;
+  p = p * z + 3.3333331174e-1F;
+
+  y = z * z;
+  y = z * y * p + (float)e * LN2_LO - 0.5F * y;
+  return z + y + (float)e * LN2_HI;
+}
+#else
 float logf(float x)
 {
   float y;
@@ -112,3 +197,4 @@ float logf(float x)
 
   return y;
 }
+#endif
@@ -0,0 +1,135 @@
+/****************************************************************************
+ * libs/libc/math/lib_sincosf.c
+ *
+ *   Copyright (C) 2020 Gregory Nutt. All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in
+ *    the documentation and/or other materials provided with the
+ *    distribution.
+ * 3. Neither the name NuttX nor the names of its contributors may be
+ *    used to endorse or promote products derived from this software
+ *    without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+ * FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE
+ * COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+ * INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,
+ * BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS
+ * OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED
+ * AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ * LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN
+ * ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ *
+ ****************************************************************************/
+
+/****************************************************************************
+ * Included Files
+ ****************************************************************************/
+
+#include <nuttx/config.h>
+
+#include <stdint.h>
+#include <math.h>
+
+#include "libc.h"
+
+#ifdef CONFIG_LIBM_FAST
+
+/****************************************************************************
+ * Public Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: sincosf
+ *
+ * Description:
+ *   Compute sin(x) and cos(x) together, sharing the argument reduction.
+ *
+ ****************************************************************************/
+
+void sincosf(float x, FAR float *s, FAR float *c)
+{
+  int32_t n;
+  float sr;
+  float cr;
+  float r;
+
+  if (isnan(x) || isinf_f(x))
+    {
+      *s = NAN_F;
+      *c = NAN_F;
+      return;
+    }
+
+  n  = lib_rempio2f(x, &r);
+  sr = lib_sinf_poly(r);
+  cr = lib_cosf_poly(r);
+
+  switch (n & 3)
+    {
+      case 0:
+        *s = sr;
+        *c = cr;
+        break;
+
+      case 1:
+        *s = cr;
+        *c = -sr;
+        break;
+
+      case 2:
+        *s = -sr;
+        *c = -cr;
+        break;
+
+      default:
+        *s = -cr;
+        *c = sr;
+        break;
+    }
+}
+
+/****************************************************************************
+ * Name: sincosf_array
+ *
+ * Description:
+ *   Compute sin() and cos() of n values.  The loop body has no calls into
+ *   the rest of libm, so the compiler can keep the coefficients in FPU
+ *   registers across iterations.  s or c may be NULL if that result is not
+ *   needed.
+ *
+ ****************************************************************************/
+
+void sincosf_array(FAR const float *x, FAR float *s, FAR float *c, size_t n)
+{
+  float sv;
+  float cv;
+  size_t i;
+
+  for (i = 0; i < n; i++)
+    {
+      sincosf(x[i], &sv, &cv);
+
+      if (s != NULL)
+        {
+          s[i] = sv;
+        }
+
+      if (c != NULL)
+        {
+          c[i] = cv;
+        }
+    }
+}
+
+#endif /* CONFIG_LIBM_FAST */
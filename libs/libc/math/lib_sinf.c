@@ -29,9 +29,16 @@
  * Included Files
  ****************************************************************************/
 
+#include <nuttx/config.h>
+
 #include <sys/types.h>
+#include <stdint.h>
 #include <math.h>
 
+#include "libc.h"
+
+#ifndef CONFIG_LIBM_FAST
+
 /****************************************************************************
  * Private Data
  ****************************************************************************/
@@ -46,10 +53,42 @@ static float _flt_inv_fact[] =
   1.0 / 39916800.0,             /* 1 / 11! */
 };
 
+#endif
+
 /****************************************************************************
  * Public Functions
  ****************************************************************************/
 
+#ifdef CONFIG_LIBM_FAST
+float sinf(float x)
+{
+  int32_t n;
+  float r;
+
+  if (isnan(x) || isinf_f(x))
+    {
+      return NAN_F;
+    }
+
+  /* Reduce x to r in [-pi/4, pi/4] and pick the polynomial by quadrant */
+
+  n = lib_rempio2f(x, &r);
+  switch (n & 3)
+    {
+      case 0:
+        return lib_sinf_poly(r);
+
+      case 1:
+        return lib_cosf_poly(r);
+
+      case 2:
+        return -lib_sinf_poly(r);
+
+      default:
+        return -lib_cosf_poly(r);
+    }
+}
+#else
 float sinf(float x)
 {
   float x_squared;
@@ -102,3 +141,4 @@ float sinf(float x)
 
   return sin_x;
 }
+#endif
@@ -1,8 +1,7 @@
 /****************************************************************************
- * libc/net/lib_sendmsg.c
+ * libs/libc/misc/lib_eventfd.c
  *
- *   Copyright (C) 2007, 2008, 2012, 2018 Gregory Nutt. All rights reserved.
- *   Author: Gregory Nutt <gnutt@nuttx.org>
+ *   Copyright (C) 2020 Gregory Nutt. All rights reserved.
  *
  * Redistribution and use in source and binary forms, with or without
  * modification, are permitted provided that the following conditions
@@ -39,51 +38,47 @@
 
 #include <nuttx/config.h>
 
-#ifdef CONFIG_NET
+#include <sys/eventfd.h>
+#include <unistd.h>
 
-#include <sys/types.h>
-#include <sys/socket.h>
-#include <errno.h>
+#ifdef CONFIG_EVENT_FD
 
 /****************************************************************************
  * Public Functions
  ****************************************************************************/
 
 /****************************************************************************
- * Function: sendmsg
+ * Name: eventfd_read
  *
  * Description:
- *   The sendmsg() call is identical to sendto() with a NULL from parameter.
- *
- * Parameters:
- *   sockfd   Socket descriptor of socket
- *   buf      Buffer to send data
- *   len      Length of buffer
- *   flags    Receive flags
+ *   Read the counter value of an event file descriptor.
  *
  * Returned Value:
- *  (see sendto)
- *
- * Assumptions:
+ *   0 is returned on success; otherwise, -1 is returned with errno set
+ *   appropriately.
  *
  ****************************************************************************/
 
-ssize_t sendmsg(int sockfd, FAR struct msghdr *msg, int flags)
+int eventfd_read(int fd, FAR eventfd_t *value)
 {
-  FAR void *buf           = msg->msg_iov->iov_base;
-  FAR struct sockaddr *to = msg->msg_name;
-  socklen_t tolen         = msg->msg_namelen;
-  size_t len              = msg->msg_iov->iov_len;
+  return read(fd, value, sizeof(eventfd_t)) < 0 ? ERROR : OK;
+}
+
+/****************************************************************************
+ * Name: eventfd_write
+ *
+ * Description:
+ *   Add a value to the counter of an event file descriptor.
+ *
+ * Returned Value:
+ *   0 is returned on success; otherwise, -1 is returned with errno set
+ *   appropriately.
+ *
+ ****************************************************************************/
 
-  if (msg->msg_iovlen == 1)
-    {
-      return sendto(sockfd, buf, len, flags, to, tolen);
-    }
-  else
-    {
-      set_errno(ENOTSUP);
-      return ERROR;
-    }
+int eventfd_write(int fd, eventfd_t value)
+{
+  return write(fd, &value, sizeof(eventfd_t)) < 0 ? ERROR : OK;
 }
 
-#endif /* CONFIG_NET */
+#endif /* CONFIG_EVENT_FD */
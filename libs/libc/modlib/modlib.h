@@ -205,4 +205,49 @@ int modlib_reallocbuffer(FAR struct mod_loadinfo_s *loadinfo, size_t increment);
 
 int modlib_freebuffers(FAR struct mod_loadinfo_s *loadinfo);
 
+/****************************************************************************
+ * Name: modlib_prelink_load
+ *
+ * Description:
+ *   Allocate the prelink value table of the module and, if a valid prelink
+ *   cache file exists for the module, the base code symbol table, and the
+ *   module file, fill it from the file.
+ *
+ * Returned Value:
+ *   0 (OK) is returned on success and a negated errno is returned on
+ *   failure.  A missing or stale cache file is not an error.
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_MODLIB_PRELINK
+int modlib_prelink_load(FAR struct mod_loadinfo_s *loadinfo);
+
+/****************************************************************************
+ * Name: modlib_prelink_save
+ *
+ * Description:
+ *   Write the values of the imported symbols resolved by modlib_bind() to
+ *   the prelink cache file of the module.  Failures are silently ignored.
+ *
+ ****************************************************************************/
+
+void modlib_prelink_save(FAR struct mod_loadinfo_s *loadinfo);
+
+/****************************************************************************
+ * Name: modlib_prelink_get and modlib_prelink_put
+ *
+ * Description:
+ *   modlib_prelink_get() sets the value of an imported symbol from the
+ *   prelink cache and returns true if the cache holds it.
+ *   modlib_prelink_put() records the value of a resolved imported symbol
+ *   to be saved by modlib_prelink_save().
+ *
+ ****************************************************************************/
+
+bool modlib_prelink_get(FAR struct mod_loadinfo_s *loadinfo, int symidx,
+                        FAR Elf32_Sym *sym);
+void modlib_prelink_put(FAR struct mod_loadinfo_s *loadinfo, int symidx,
+                        FAR const Elf32_Sym *sym);
+#endif
+
 #endif /* __LIBC_MODLIB_MODLIB_H */
@@ -55,16 +55,17 @@
  * Private Types
  ****************************************************************************/
 
-/* REVISIT:  This naming breaks the NuttX coding standard, but is consistent
- * with legacy naming of other ELF32 types.
+/* A cache of symbol table entries with their resolved values.  The cache
+ * is direct-mapped on the symbol table index and is shared by all of the
+ * relocation sections of a module, so each imported symbol name is read
+ * and resolved only once per module.
  */
 
-typedef struct
+struct mod_symcache_s
 {
-  dq_entry_t      entry;
-  Elf32_Sym       sym;
-  int             idx;
-} Elf32_SymCache;
+  int             idx;         /* Symbol table index, -1 if empty */
+  Elf32_Sym       sym;         /* Symbol with the resolved st_value */
+};
 
 /****************************************************************************
  * Private Functions
@@ -122,22 +123,20 @@ static inline int modlib_readrels(FAR struct mod_loadinfo_s *loadinfo,
  ****************************************************************************/
 
 static int modlib_relocate(FAR struct module_s *modp,
-                           FAR struct mod_loadinfo_s *loadinfo, int relidx)
+                           FAR struct mod_loadinfo_s *loadinfo, int relidx,
+                           FAR struct mod_symcache_s *symcache)
 
 {
   FAR Elf32_Shdr *relsec = &loadinfo->shdr[relidx];
   FAR Elf32_Shdr *dstsec = &loadinfo->shdr[relsec->sh_info];
   FAR Elf32_Rel  *rels;
   FAR Elf32_Rel  *rel;
-  FAR Elf32_SymCache *cache;
+  FAR struct mod_symcache_s *cache;
   FAR Elf32_Sym  *sym;
-  FAR dq_entry_t *e;
-  dq_queue_t      q;
   uintptr_t       addr;
   int             symidx;
   int             ret;
   int             i;
-  int             j;
 
   rels = lib_malloc(CONFIG_MODLIB_RELOCATION_BUFFERCOUNT * sizeof(Elf32_Rel));
   if (!rels)
@@ -146,8 +145,6 @@ static int modlib_relocate(FAR struct module_s *modp,
       return -ENOMEM;
     }
 
-  dq_init(&q);
-
   /* Examine each relocation in the section.  'relsec' is the section
    * containing the relations.  'dstsec' is the section containing the data
    * to be relocated.
@@ -155,7 +152,7 @@ static int modlib_relocate(FAR struct module_s *modp,
 
   ret = OK;
 
-  for (i = j = 0; i < relsec->sh_size / sizeof(Elf32_Rel); i++)
+  for (i = 0; i < relsec->sh_size / sizeof(Elf32_Rel); i++)
     {
       /* Read the relocation entry into memory */
 
@@ -178,44 +175,16 @@ static int modlib_relocate(FAR struct module_s *modp,
 
       symidx = ELF32_R_SYM(rel->r_info);
 
-      /* First try the cache */
-
-      sym = NULL;
-      for (e = dq_peek(&q); e; e = dq_next(e))
-        {
-          cache = (FAR Elf32_SymCache *)e;
-          if (cache->idx == symidx)
-            {
-              dq_rem(&cache->entry, &q);
-              dq_addfirst(&cache->entry, &q);
-              sym = &cache->sym;
-              break;
-            }
-        }
-
-      /* If the symbol was not found in the cache, we will need to read the
-       * symbol from the file.
+      /* First try the cache.  If the symbol is not there, we will need to
+       * read the symbol from the file and resolve its value.
        */
 
-      if (sym == NULL)
-        {
-          if (j < CONFIG_MODLIB_SYMBOL_CACHECOUNT)
-            {
-              cache = lib_malloc(sizeof(Elf32_SymCache));
-              if (!cache)
-                {
-                  berr("Failed to allocate memory for elf symbols\n");
-                  ret = -ENOMEM;
-                  break;
-                }
-              j++;
-            }
-          else
-            {
-              cache = (FAR Elf32_SymCache *)dq_remlast(&q);
-            }
+      cache = &symcache[symidx % CONFIG_MODLIB_SYMBOL_CACHECOUNT];
+      sym   = &cache->sym;
 
-          sym = &cache->sym;
+      if (cache->idx != symidx)
+        {
+          cache->idx = -1;
 
           /* Read the symbol table entry into memory */
 
@@ -224,13 +193,24 @@ static int modlib_relocate(FAR struct module_s *modp,
             {
               berr("ERROR: Section %d reloc %d: Failed to read symbol[%d]: %d\n",
                    relidx, i, symidx, ret);
-              lib_free(cache);
               break;
             }
 
-          /* Get the value of the symbol (in sym.st_value) */
+          /* Get the value of the symbol (in sym.st_value), from the prelink
+           * cache if possible.
+           */
+
+#ifdef CONFIG_MODLIB_PRELINK
+          if (modlib_prelink_get(loadinfo, symidx, sym))
+            {
+              ret = OK;
+            }
+          else
+#endif
+            {
+              ret = modlib_symvalue(modp, loadinfo, sym);
+            }
 
-          ret = modlib_symvalue(modp, loadinfo, sym);
           if (ret < 0)
             {
               /* The special error -ESRCH is returned only in one condition:  The
@@ -252,13 +232,14 @@ static int modlib_relocate(FAR struct module_s *modp,
                 {
                   berr("ERROR: Section %d reloc %d: Failed to get value of symbol[%d]: %d\n",
                       relidx, i, symidx, ret);
-                  lib_free(cache);
                   break;
                 }
             }
 
+#ifdef CONFIG_MODLIB_PRELINK
+          modlib_prelink_put(loadinfo, symidx, sym);
+#endif
           cache->idx = symidx;
-          dq_addfirst(&cache->entry, &q);
         }
 
       if (sym->st_shndx == SHN_UNDEF && sym->st_name == 0)
@@ -289,17 +270,12 @@ static int modlib_relocate(FAR struct module_s *modp,
     }
 
   lib_free(rels);
-  while ((e = dq_peek(&q)))
-    {
-      dq_rem(e, &q);
-      lib_free(e);
-    }
-
   return ret;
 }
 
 static int modlib_relocateadd(FAR struct module_s *modp,
-                           FAR struct mod_loadinfo_s *loadinfo, int relidx)
+                           FAR struct mod_loadinfo_s *loadinfo, int relidx,
+                           FAR struct mod_symcache_s *symcache)
 {
   berr("ERROR: Not implemented\n");
   return -ENOSYS;
@@ -328,6 +304,7 @@ static int modlib_relocateadd(FAR struct module_s *modp,
 
 int modlib_bind(FAR struct module_s *modp, FAR struct mod_loadinfo_s *loadinfo)
 {
+  FAR struct mod_symcache_s *symcache;
   int ret;
   int i;
 
@@ -350,6 +327,34 @@ int modlib_bind(FAR struct module_s *modp, FAR struct mod_loadinfo_s *loadinfo)
       return -ENOMEM;
     }
 
+  /* Allocate the symbol cache shared by all relocation sections */
+
+  symcache = (FAR struct mod_symcache_s *)
+    lib_malloc(CONFIG_MODLIB_SYMBOL_CACHECOUNT *
+               sizeof(struct mod_symcache_s));
+  if (symcache == NULL)
+    {
+      berr("ERROR: Failed to allocate memory for elf symbols\n");
+      return -ENOMEM;
+    }
+
+  for (i = 0; i < CONFIG_MODLIB_SYMBOL_CACHECOUNT; i++)
+    {
+      symcache[i].idx = -1;
+    }
+
+#ifdef CONFIG_MODLIB_PRELINK
+  /* Get the prelinked symbol values, if any */
+
+  ret = modlib_prelink_load(loadinfo);
+  if (ret < 0)
+    {
+      berr("ERROR: modlib_prelink_load failed: %d\n", ret);
+      lib_free(symcache);
+      return ret;
+    }
+#endif
+
   /* Process relocations in every allocated section */
 
   for (i = 1; i < loadinfo->ehdr.e_shnum; i++)
@@ -375,11 +380,11 @@ int modlib_bind(FAR struct module_s *modp, FAR struct mod_loadinfo_s *loadinfo)
 
       if (loadinfo->shdr[i].sh_type == SHT_REL)
         {
-          ret = modlib_relocate(modp, loadinfo, i);
+          ret = modlib_relocate(modp, loadinfo, i, symcache);
         }
       else if (loadinfo->shdr[i].sh_type == SHT_RELA)
         {
-          ret = modlib_relocateadd(modp, loadinfo, i);
+          ret = modlib_relocateadd(modp, loadinfo, i, symcache);
         }
 
       if (ret < 0)
@@ -388,6 +393,17 @@ int modlib_bind(FAR struct module_s *modp, FAR struct mod_loadinfo_s *loadinfo)
         }
     }
 
+  lib_free(symcache);
+
+#ifdef CONFIG_MODLIB_PRELINK
+  /* Save the resolved symbol values for the next time */
+
+  if (ret >= 0)
+    {
+      modlib_prelink_save(loadinfo);
+    }
+#endif
+
   /* Ensure that the I and D caches are coherent before starting the newly
    * loaded module by cleaning the D cache (i.e., flushing the D cache
    * contents to memory and invalidating the I cache).
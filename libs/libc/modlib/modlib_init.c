@@ -147,6 +147,9 @@ int modlib_initialize(FAR const char *filename,
   /* Clear the load info structure */
 
   memset(loadinfo, 0, sizeof(struct mod_loadinfo_s));
+#ifdef CONFIG_MODLIB_PRELINK
+  loadinfo->filename = filename;
+#endif
 
   /* Get the length of the file. */
 
@@ -0,0 +1,425 @@
+/****************************************************************************
+ * libs/libc/modlib/modlib_prelink.c
+ *
+ *   Copyright (C) 2020 Gregory Nutt. All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in
+ *    the documentation and/or other materials provided with the
+ *    distribution.
+ * 3. Neither the name NuttX nor the names of its contributors may be
+ *    used to endorse or promote products derived from this software
+ *    without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+ * FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE
+ * COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+ * INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,
+ * BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS
+ * OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED
+ * AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ * LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN
+ * ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ *
+ ****************************************************************************/
+
+/****************************************************************************
+ * Included Files
+ ****************************************************************************/
+
+#include <nuttx/config.h>
+
+#include <stdint.h>
+#include <stdbool.h>
+#include <stdio.h>
+#include <string.h>
+#include <unistd.h>
+#include <fcntl.h>
+#include <limits.h>
+#include <debug.h>
+#include <errno.h>
+
+#include <nuttx/fs/fs.h>
+#include <nuttx/symtab.h>
+#include <nuttx/lib/modlib.h>
+
+#include "libc.h"
+#include "modlib/modlib.h"
+
+#ifdef CONFIG_MODLIB_PRELINK
+
+/****************************************************************************
+ * Pre-processor Definitions
+ ****************************************************************************/
+
+#define PRELINK_MAGIC    0x4b4e4c50   /* "PLNK" */
+#define PRELINK_SUFFIX   ".prl"
+
+#define FNV_OFFSET_BASIS 2166136261u
+#define FNV_PRIME        16777619u
+
+/****************************************************************************
+ * Private Types
+ ****************************************************************************/
+
+/* The prelink cache file is this header followed by the resolved value of
+ * each entry of the module's symbol table.  Only the values of named,
+ * undefined symbols are meaningful.
+ */
+
+struct mod_prelinkhdr_s
+{
+  uint32_t magic;                /* PRELINK_MAGIC */
+  uint32_t filelen;              /* Length of the module file */
+  uint32_t modhash;              /* Hash of the module headers and symbols */
+  uint32_t symhash;              /* Hash of the base code symbol table */
+  uint32_t nsyms;                /* Number of values that follow */
+};
+
+/****************************************************************************
+ * Private Data
+ ****************************************************************************/
+
+/* The hash of the base code symbol table, computed once */
+
+static FAR const struct symtab_s *g_prelink_symtab;
+static int g_prelink_nsymbols;
+static uint32_t g_prelink_symhash;
+
+/****************************************************************************
+ * Private Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: modlib_hash
+ *
+ * Description:
+ *   Accumulate 'len' bytes at 'buf' into an FNV-1a hash.
+ *
+ ****************************************************************************/
+
+static uint32_t modlib_hash(uint32_t hash, FAR const void *buf, size_t len)
+{
+  FAR const uint8_t *ptr = buf;
+
+  while (len-- > 0)
+    {
+      hash ^= *ptr++;
+      hash *= FNV_PRIME;
+    }
+
+  return hash;
+}
+
+/****************************************************************************
+ * Name: modlib_symtabhash
+ *
+ * Description:
+ *   Return the hash of the names and values of the base code symbol table.
+ *   A different kernel image gives a different hash and invalidates all of
+ *   the prelink cache files.
+ *
+ ****************************************************************************/
+
+static uint32_t modlib_symtabhash(void)
+{
+  FAR const struct symtab_s *symtab;
+  uint32_t hash;
+  int nsymbols;
+  int i;
+
+  modlib_getsymtab(&symtab, &nsymbols);
+  if (symtab == g_prelink_symtab && nsymbols == g_prelink_nsymbols &&
+      g_prelink_symhash != 0)
+    {
+      return g_prelink_symhash;
+    }
+
+  hash = modlib_hash(FNV_OFFSET_BASIS, &nsymbols, sizeof(int));
+  for (i = 0; symtab != NULL && i < nsymbols; i++)
+    {
+      /* Hashed symbol tables have unused entries with no name */
+
+      if (symtab[i].sym_name != NULL)
+        {
+          hash = modlib_hash(hash, symtab[i].sym_name,
+                             strlen(symtab[i].sym_name) + 1);
+        }
+
+      hash = modlib_hash(hash, &symtab[i].sym_value, sizeof(FAR void *));
+    }
+
+  g_prelink_symtab   = symtab;
+  g_prelink_nsymbols = nsymbols;
+  g_prelink_symhash  = hash;
+  return hash;
+}
+
+/****************************************************************************
+ * Name: modlib_modhash
+ *
+ * Description:
+ *   Return the hash of the module's ELF header, the load-independent
+ *   fields of its section headers, and its symbol table.
+ *
+ ****************************************************************************/
+
+static int modlib_modhash(FAR struct mod_loadinfo_s *loadinfo,
+                          FAR uint32_t *modhash)
+{
+  FAR Elf32_Shdr *symtab = &loadinfo->shdr[loadinfo->symtabidx];
+  uint8_t buffer[64];
+  uint32_t hash;
+  size_t nbytes;
+  off_t offset;
+  int ret;
+  int i;
+
+  hash = modlib_hash(FNV_OFFSET_BASIS, &loadinfo->ehdr, sizeof(Elf32_Ehdr));
+
+  /* sh_addr is changed by modlib_load() and must not be included */
+
+  for (i = 0; i < loadinfo->ehdr.e_shnum; i++)
+    {
+      FAR Elf32_Shdr *shdr = &loadinfo->shdr[i];
+
+      hash = modlib_hash(hash, &shdr->sh_name, sizeof(Elf32_Word));
+      hash = modlib_hash(hash, &shdr->sh_type, sizeof(Elf32_Word));
+      hash = modlib_hash(hash, &shdr->sh_offset, sizeof(Elf32_Off));
+      hash = modlib_hash(hash, &shdr->sh_size, sizeof(Elf32_Word));
+      hash = modlib_hash(hash, &shdr->sh_link, sizeof(Elf32_Word));
+      hash = modlib_hash(hash, &shdr->sh_info, sizeof(Elf32_Word));
+    }
+
+  for (offset = 0; offset < symtab->sh_size; offset += nbytes)
+    {
+      nbytes = symtab->sh_size - offset;
+      if (nbytes > sizeof(buffer))
+        {
+          nbytes = sizeof(buffer);
+        }
+
+      ret = modlib_read(loadinfo, buffer, nbytes,
+                        symtab->sh_offset + offset);
+      if (ret < 0)
+        {
+          return ret;
+        }
+
+      hash = modlib_hash(hash, buffer, nbytes);
+    }
+
+  *modhash = hash;
+  return OK;
+}
+
+/****************************************************************************
+ * Name: modlib_prelinkpath
+ *
+ * Description:
+ *   Return the path to the prelink cache file of the module in an allocated
+ *   buffer, or NULL on failure.
+ *
+ ****************************************************************************/
+
+static FAR char *modlib_prelinkpath(FAR struct mod_loadinfo_s *loadinfo)
+{
+  FAR const char *name;
+  FAR char *path;
+
+  if (loadinfo->filename == NULL)
+    {
+      return NULL;
+    }
+
+  name = strrchr(loadinfo->filename, '/');
+  name = name != NULL ? name + 1 : loadinfo->filename;
+
+  path = lib_malloc(PATH_MAX);
+  if (path != NULL)
+    {
+      snprintf(path, PATH_MAX, "%s/%s" PRELINK_SUFFIX,
+               CONFIG_MODLIB_PRELINK_PATH, name);
+    }
+
+  return path;
+}
+
+/****************************************************************************
+ * Public Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: modlib_prelink_load
+ ****************************************************************************/
+
+int modlib_prelink_load(FAR struct mod_loadinfo_s *loadinfo)
+{
+  struct mod_prelinkhdr_s hdr;
+  FAR char *path;
+  size_t size;
+  ssize_t nbytes;
+  int ret;
+  int fd;
+
+  loadinfo->nprelink  = loadinfo->shdr[loadinfo->symtabidx].sh_size /
+                        sizeof(Elf32_Sym);
+  loadinfo->prelinked = false;
+  size                = loadinfo->nprelink * sizeof(Elf32_Word);
+
+  ret = modlib_modhash(loadinfo, &loadinfo->prelinkhash);
+  if (ret < 0)
+    {
+      return ret;
+    }
+
+  loadinfo->prelink = lib_zalloc(size);
+  if (loadinfo->prelink == NULL)
+    {
+      return -ENOMEM;
+    }
+
+  /* Try to read the cached values.  Any problem just means that the
+   * symbols will be resolved from scratch.
+   */
+
+  path = modlib_prelinkpath(loadinfo);
+  if (path == NULL)
+    {
+      return OK;
+    }
+
+  fd = _NX_OPEN(path, O_RDONLY);
+  lib_free(path);
+
+  if (fd < 0)
+    {
+      return OK;
+    }
+
+  nbytes = _NX_READ(fd, &hdr, sizeof(hdr));
+  if (nbytes == sizeof(hdr) && hdr.magic == PRELINK_MAGIC &&
+      hdr.filelen == loadinfo->filelen &&
+      hdr.modhash == loadinfo->prelinkhash &&
+      hdr.symhash == modlib_symtabhash() &&
+      hdr.nsyms == loadinfo->nprelink)
+    {
+      nbytes = _NX_READ(fd, loadinfo->prelink, size);
+      if (nbytes == size)
+        {
+          binfo("Using prelinked symbol values\n");
+          loadinfo->prelinked = true;
+        }
+      else
+        {
+          memset(loadinfo->prelink, 0, size);
+        }
+    }
+
+  close(fd);
+  return OK;
+}
+
+/****************************************************************************
+ * Name: modlib_prelink_save
+ ****************************************************************************/
+
+void modlib_prelink_save(FAR struct mod_loadinfo_s *loadinfo)
+{
+  struct mod_prelinkhdr_s hdr;
+  FAR char *path;
+  size_t size;
+  ssize_t nbytes;
+  int fd;
+
+  /* Nothing to do if the cached values were used or if some symbols were
+   * imported from other modules, whose addresses may differ next time.
+   */
+
+  if (loadinfo->prelink == NULL || loadinfo->prelinked ||
+      loadinfo->modimports)
+    {
+      return;
+    }
+
+  path = modlib_prelinkpath(loadinfo);
+  if (path == NULL)
+    {
+      return;
+    }
+
+  fd = _NX_OPEN(path, O_WRONLY | O_CREAT | O_TRUNC, 0644);
+  if (fd < 0)
+    {
+      binfo("Cannot create %s\n", path);
+      lib_free(path);
+      return;
+    }
+
+  hdr.magic   = PRELINK_MAGIC;
+  hdr.filelen = loadinfo->filelen;
+  hdr.modhash = loadinfo->prelinkhash;
+  hdr.symhash = modlib_symtabhash();
+  hdr.nsyms   = loadinfo->nprelink;
+  size        = loadinfo->nprelink * sizeof(Elf32_Word);
+
+  nbytes = _NX_WRITE(fd, &hdr, sizeof(hdr));
+  if (nbytes == sizeof(hdr))
+    {
+      nbytes = _NX_WRITE(fd, loadinfo->prelink, size);
+    }
+
+  close(fd);
+
+  /* Don't leave a truncated file behind */
+
+  if (nbytes != size)
+    {
+      unlink(path);
+    }
+
+  lib_free(path);
+}
+
+/****************************************************************************
+ * Name: modlib_prelink_get
+ ****************************************************************************/
+
+bool modlib_prelink_get(FAR struct mod_loadinfo_s *loadinfo, int symidx,
+                        FAR Elf32_Sym *sym)
+{
+  if (loadinfo->prelinked && sym->st_shndx == SHN_UNDEF &&
+      sym->st_name != 0 && symidx < loadinfo->nprelink)
+    {
+      sym->st_value = loadinfo->prelink[symidx];
+      return true;
+    }
+
+  return false;
+}
+
+/****************************************************************************
+ * Name: modlib_prelink_put
+ ****************************************************************************/
+
+void modlib_prelink_put(FAR struct mod_loadinfo_s *loadinfo, int symidx,
+                        FAR const Elf32_Sym *sym)
+{
+  if (loadinfo->prelink != NULL && !loadinfo->prelinked &&
+      sym->st_shndx == SHN_UNDEF && sym->st_name != 0 &&
+      symidx < loadinfo->nprelink)
+    {
+      loadinfo->prelink[symidx] = sym->st_value;
+    }
+}
+
+#endif /* CONFIG_MODLIB_PRELINK */
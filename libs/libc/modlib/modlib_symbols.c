@@ -384,6 +384,12 @@ int modlib_symvalue(FAR struct module_s *modp,
           }
 
         symbol = exportinfo.symbol;
+#ifdef CONFIG_MODLIB_PRELINK
+        if (symbol != NULL)
+          {
+            loadinfo->modimports = true;
+          }
+#endif
 
         /* If the symbol is not exported by any module, then check if the
          * base code exports a symbol of this name.
@@ -392,7 +398,10 @@ int modlib_symvalue(FAR struct module_s *modp,
         if (symbol == NULL)
           {
             modlib_getsymtab(&symbol, &nsymbols);
-#ifdef CONFIG_SYMTAB_ORDEREDBYNAME
+#if defined(CONFIG_SYMTAB_HASHED)
+            symbol = symtab_findhashedbyname(symbol, exportinfo.name,
+                                             nsymbols);
+#elif defined(CONFIG_SYMTAB_ORDEREDBYNAME)
             symbol = symtab_findorderedbyname(symbol, exportinfo.name,
                                               nsymbols);
 #else
@@ -110,5 +110,13 @@ int modlib_freebuffers(struct mod_loadinfo_s *loadinfo)
       loadinfo->buflen    = 0;
     }
 
+#ifdef CONFIG_MODLIB_PRELINK
+  if (loadinfo->prelink != NULL)
+    {
+      lib_free((FAR void *)loadinfo->prelink);
+      loadinfo->prelink   = NULL;
+    }
+#endif
+
   return OK;
 }
@@ -45,6 +45,7 @@
 
 #include <nuttx/config.h>
 
+#include <stdint.h>
 #include <stdbool.h>
 
 #include <sys/socket.h>
@@ -78,6 +79,14 @@
 #  define CONFIG_NETDB_DNSCLIENT_LIFESEC 3600
 #endif
 
+#ifndef CONFIG_NETDB_DNSCLIENT_NEGATIVE_LIFESEC
+#  define CONFIG_NETDB_DNSCLIENT_NEGATIVE_LIFESEC 60
+#endif
+
+#ifndef CONFIG_NETDB_DNSCLIENT_MAXSERVERS
+#  define CONFIG_NETDB_DNSCLIENT_MAXSERVERS 3
+#endif
+
 #ifndef CONFIG_NETDB_RESOLVCONF_PATH
 #  define CONFIG_NETDB_RESOLVCONF_PATH "/etc/resolv.conf"
 #endif
@@ -209,7 +218,9 @@ int dns_query(int sd, FAR const char *hostname, FAR union dns_addr_u *addr,
  * Input Parameters:
  *   hostname - The hostname string to be cached.
  *   addr     - The IP addresses associated with the hostname.
- *   naddr    - The count of the IP addresses.
+ *   naddr    - The count of the IP addresses.  Zero saves a negative
+ *     answer:  The hostname does not exist or has no addresses.
+ *   ttl      - The time to live of the answer in seconds.
  *
  * Returned Value:
  *   None
@@ -218,7 +229,8 @@ int dns_query(int sd, FAR const char *hostname, FAR union dns_addr_u *addr,
 
 #if CONFIG_NETDB_DNSCLIENT_ENTRIES > 0
 void dns_save_answer(FAR const char *hostname,
-                     FAR const union dns_addr_u *addr, int naddr);
+                     FAR const union dns_addr_u *addr, int naddr,
+                     uint32_t ttl);
 #endif
 
 /****************************************************************************
@@ -239,7 +251,8 @@ void dns_save_answer(FAR const char *hostname,
  *   If the host name was successfully found in the DNS name resolution
  *   cache, zero (OK) will be returned.  Otherwise, some negated errno
  *   value will be returned, typically -ENOENT meaning that the hostname
- *   was not found in the cache.
+ *   was not found in the cache or -EADDRNOTAVAIL meaning that the cache
+ *   holds a negative answer for the hostname.
  *
  ****************************************************************************/
 
@@ -74,11 +74,10 @@
 
 struct dns_cache_s
 {
-#if CONFIG_NETDB_DNSCLIENT_LIFESEC > 0
-  time_t            ctime;      /* Creation time */
-#endif
+  time_t            expire;     /* Expiration time */
   char              name[CONFIG_NETDB_DNSCLIENT_NAMESIZE];
-  uint8_t           naddr;      /* How many addresses per name */
+  uint8_t           naddr;      /* How many addresses per name, zero for a
+                                 * negative answer */
   union dns_addr_u  addr[CONFIG_NETDB_DNSCLIENT_MAXIP]; /* Resolved address */
 };
 
@@ -97,6 +96,26 @@ static struct dns_cache_s g_dns_cache[CONFIG_NETDB_DNSCLIENT_ENTRIES];
  * Private Functions
  ****************************************************************************/
 
+/****************************************************************************
+ * Name: dns_cache_now
+ *
+ * Description:
+ *   Return the current time in seconds, using CLOCK_MONOTONIC if possible.
+ *
+ ****************************************************************************/
+
+static time_t dns_cache_now(void)
+{
+  struct timespec now;
+
+  if (clock_gettime(DNS_CLOCK, &now) < 0)
+    {
+      return 0;
+    }
+
+  return (time_t)now.tv_sec;
+}
+
 /****************************************************************************
  * Public Functions
  ****************************************************************************/
@@ -110,7 +129,9 @@ static struct dns_cache_s g_dns_cache[CONFIG_NETDB_DNSCLIENT_ENTRIES];
  * Input Parameters:
  *   hostname - The hostname string to be cached.
  *   addr     - The IP addresses associated with the hostname.
- *   naddr    - The count of the IP addresses.
+ *   naddr    - The count of the IP addresses.  Zero saves a negative
+ *     answer:  The hostname does not exist or has no addresses.
+ *   ttl      - The time to live of the answer in seconds.
  *
  * Returned Value:
  *   None
@@ -118,22 +139,61 @@ static struct dns_cache_s g_dns_cache[CONFIG_NETDB_DNSCLIENT_ENTRIES];
  ****************************************************************************/
 
 void dns_save_answer(FAR const char *hostname,
-                     FAR const union dns_addr_u *addr, int naddr)
+                     FAR const union dns_addr_u *addr, int naddr,
+                     uint32_t ttl)
 {
   FAR struct dns_cache_s *entry;
-#if CONFIG_NETDB_DNSCLIENT_LIFESEC > 0
-  struct timespec now;
-#endif
+  time_t now;
   int next;
   int ndx;
 
   naddr = MIN(naddr, CONFIG_NETDB_DNSCLIENT_MAXIP);
-  DEBUGASSERT(naddr >= 1 && naddr <= UCHAR_MAX);
+  DEBUGASSERT(naddr >= 0 && naddr <= UCHAR_MAX);
+
+  /* Negative answers live for a fixed time, if they are cached at all.
+   * Positive answers live for their TTL, limited by the configured life.
+   */
+
+  if (naddr == 0)
+    {
+      ttl = CONFIG_NETDB_DNSCLIENT_NEGATIVE_LIFESEC;
+    }
+#if CONFIG_NETDB_DNSCLIENT_LIFESEC > 0
+  else if (ttl > CONFIG_NETDB_DNSCLIENT_LIFESEC)
+    {
+      ttl = CONFIG_NETDB_DNSCLIENT_LIFESEC;
+    }
+#endif
+
+  if (ttl == 0)
+    {
+      return;
+    }
+
+  now = dns_cache_now();
 
   /* Get exclusive access to the DNS cache */
 
   dns_semtake();
 
+  /* Invalidate any older answer for the same hostname */
+
+  for (ndx = g_dns_tail; ndx != g_dns_head; ndx = next)
+    {
+      next = ndx + 1;
+      if (next >= CONFIG_NETDB_DNSCLIENT_ENTRIES)
+        {
+          next = 0;
+        }
+
+      entry = &g_dns_cache[ndx];
+      if (strncmp(hostname, entry->name,
+                  CONFIG_NETDB_DNSCLIENT_NAMESIZE) == 0)
+        {
+          entry->name[0] = '\0';
+        }
+    }
+
   /* Get the index to the new head of the list */
 
   ndx  = g_dns_head;
@@ -160,14 +220,8 @@ void dns_save_answer(FAR const char *hostname,
 
   /* Save the answer in the cache */
 
-  entry = &g_dns_cache[ndx];
-
-#if CONFIG_NETDB_DNSCLIENT_LIFESEC > 0
-  /* Get the current time, using CLOCK_MONOTONIC if possible */
-
-  clock_gettime(DNS_CLOCK, &now);
-  entry->ctime = (time_t)now.tv_sec;
-#endif
+  entry         = &g_dns_cache[ndx];
+  entry->expire = now + (time_t)ttl;
 
   strncpy(entry->name, hostname, CONFIG_NETDB_DNSCLIENT_NAMESIZE);
   memcpy(&entry->addr, addr, naddr * sizeof(*addr));
@@ -197,7 +251,8 @@ void dns_save_answer(FAR const char *hostname,
  *   If the host name was successfully found in the DNS name resolution
  *   cache, zero (OK) will be returned.  Otherwise, some negated errno
  *   value will be returned, typically -ENOENT meaning that the hostname
- *   was not found in the cache.
+ *   was not found in the cache or -EADDRNOTAVAIL meaning that the cache
+ *   holds a negative answer for the hostname.
  *
  ****************************************************************************/
 
@@ -205,11 +260,7 @@ int dns_find_answer(FAR const char *hostname, FAR union dns_addr_u *addr,
                     FAR int *naddr)
 {
   FAR struct dns_cache_s *entry;
-#if CONFIG_NETDB_DNSCLIENT_LIFESEC > 0
-  struct timespec now;
-  uint32_t elapsed;
-  int ret;
-#endif
+  time_t now;
   int next;
   int ndx;
 
@@ -221,16 +272,12 @@ int dns_find_answer(FAR const char *hostname, FAR union dns_addr_u *addr,
       return -EAGAIN;
     }
 
+  now = dns_cache_now();
+
   /* Get exclusive access to the DNS cache */
 
   dns_semtake();
 
-#if CONFIG_NETDB_DNSCLIENT_LIFESEC > 0
-  /* Get the current time, using CLOCK_MONOTONIC if possible */
-
-  ret = clock_gettime(DNS_CLOCK, &now);
-#endif
-
   for (ndx = g_dns_tail; ndx != g_dns_head; ndx = next)
     {
       entry = &g_dns_cache[ndx];
@@ -245,54 +292,56 @@ int dns_find_answer(FAR const char *hostname, FAR union dns_addr_u *addr,
           next = 0;
         }
 
-#if CONFIG_NETDB_DNSCLIENT_LIFESEC > 0
-      /* Check if this entry has expired
-       * REVISIT: Does not this calculation assume that the sizeof(time_t)
-       * is equal to the sizeof(uint32_t)?
+      /* Check if this entry has expired.  The entries do not expire in
+       * order, so only an expired entry at the tail can be discarded.
        */
 
-      elapsed = (uint32_t)now.tv_sec - (uint32_t)entry->ctime;
-      if (ret >= 0 && elapsed > CONFIG_NETDB_DNSCLIENT_LIFESEC)
+      if ((int32_t)((uint32_t)now - (uint32_t)entry->expire) >= 0)
         {
-          /* This entry has expired.  Increment the tail index to exclude
-           * this entry on future traversals.
-           */
+          if (ndx == g_dns_tail)
+            {
+              g_dns_tail = next;
+            }
 
-          g_dns_tail = next;
+          continue;
         }
-      else
-#endif
+
+      /* The entry has not expired, check for a name match.  Notice that
+       * because the names are truncated to CONFIG_NETDB_DNSCLIENT_NAMESIZE,
+       * this has the possibility of aliasing two names and returning
+       * the wrong entry from the cache.
+       */
+
+      if (strncmp(hostname, entry->name,
+                  CONFIG_NETDB_DNSCLIENT_NAMESIZE) == 0)
         {
-          /* The entry has not expired, check for a name match.  Notice that
-           * because the names are truncated to CONFIG_NETDB_DNSCLIENT_NAMESIZE,
-           * this has the possibility of aliasing two names and returning
-           * the wrong entry from the cache.
+          /* We have a match.  A negative answer means that the name
+           * servers have no address for this hostname.
            */
 
-          if (strncmp(hostname, entry->name, CONFIG_NETDB_DNSCLIENT_NAMESIZE) == 0)
+          if (entry->naddr == 0)
             {
-              /* We have a match.  Return the resolved host address */
+              dns_semgive();
+              return -EADDRNOTAVAIL;
+            }
 
-              /* Make sure that the address will fit in the caller-provided
-               * buffer.
-               */
+          /* Make sure that the address will fit in the caller-provided
+           * buffer.
+           */
 
-              *naddr = MIN(*naddr, entry->naddr);
+          *naddr = MIN(*naddr, entry->naddr);
 
-              /* Return the address information */
+          /* Return the address information */
 
-              memcpy(addr, &entry->addr, *naddr * sizeof(*addr));
+          memcpy(addr, &entry->addr, *naddr * sizeof(*addr));
 
-              dns_semgive();
-              return OK;
-            }
+          dns_semgive();
+          return OK;
         }
     }
 
-  ret = -ENOENT;
-
   dns_semgive();
-  return ret;
+  return -ENOENT;
 }
 
 #endif /* CONFIG_NETDB_DNSCLIENT_ENTRIES > 0 */
@@ -48,6 +48,7 @@
 
 #include <nuttx/config.h>
 
+#include <sys/random.h>
 #include <string.h>
 #include <time.h>
 #include <errno.h>
@@ -79,17 +80,29 @@
 #define SEND_BUFFER_SIZE (16 + CONFIG_NETDB_DNSCLIENT_NAMESIZE + 2)
 #define RECV_BUFFER_SIZE CONFIG_NETDB_DNSCLIENT_MAXRESPONSE
 
+/* The record types that are queried:  A for IPv4 and AAAA for IPv6 */
+
+#if defined(CONFIG_NET_IPv4) && defined(CONFIG_NET_IPv6)
+#  define DNS_NTYPES 2
+#else
+#  define DNS_NTYPES 1
+#endif
+
+/* The maximum number of queries that are outstanding at the same time */
+
+#define DNS_MAX_QUERIES (CONFIG_NETDB_DNSCLIENT_MAXSERVERS * DNS_NTYPES)
+
 /****************************************************************************
  * Private Types
  ****************************************************************************/
 
+/* The name servers that are queried */
+
 struct dns_query_s
 {
-  int sd;                         /* DNS server socket */
   int result;                     /* Explanation of the failure */
-  FAR const char *hostname;       /* Hostname to lookup */
-  FAR union dns_addr_u *addr;     /* Location to return host address */
-  FAR int *naddr;                 /* Number of returned addresses */
+  int nserver;                    /* Number of name servers */
+  union dns_addr_u server[CONFIG_NETDB_DNSCLIENT_MAXSERVERS];
 };
 
 /* Query info to check response against. */
@@ -108,11 +121,29 @@ struct dns_query_info_s
   in_port_t srv_port;                            /* DNS server port */
   uint16_t id;                                   /* Query ID */
   uint16_t rectype;                              /* Queried record type */
+  uint8_t type;                                  /* Index in g_dns_rectype */
+  bool pending;                                  /* Waiting for an answer */
   uint16_t qnamelen;                             /* Queried hostname length */
   char qname[CONFIG_NETDB_DNSCLIENT_NAMESIZE+2]; /* Queried hostname in encoded
                                                   * format + NUL */
 };
 
+/****************************************************************************
+ * Private Data
+ ****************************************************************************/
+
+/* The record types that are queried for each hostname */
+
+static const uint16_t g_dns_rectype[DNS_NTYPES] =
+{
+#ifdef CONFIG_NET_IPv4
+  DNS_RECTYPE_A,
+#endif
+#ifdef CONFIG_NET_IPv6
+  DNS_RECTYPE_AAAA,
+#endif
+};
+
 /****************************************************************************
  * Private Functions
  ****************************************************************************/
@@ -189,10 +220,17 @@ static FAR uint8_t *dns_parse_name(FAR uint8_t *query, FAR uint8_t *queryend)
 
 static inline uint16_t dns_alloc_id(void)
 {
+#ifdef CONFIG_CRYPTO_RANDOM_POOL_FAST
+  uint16_t id;
+
+  getrandom(&id, sizeof(id));
+  return id;
+#else
   struct timespec ts;
 
   clock_gettime(CLOCK_REALTIME, &ts);
   return (uint32_t)ts.tv_nsec + ((uint32_t)ts.tv_nsec >> 16);
+#endif
 }
 
 /****************************************************************************
@@ -331,21 +369,81 @@ static int dns_send_query(int sd, FAR const char *name,
   return OK;
 }
 
+/****************************************************************************
+ * Name: dns_match_query
+ *
+ * Description:
+ *   Check if a response from the address 'from' with the ID 'id' answers
+ *   the query 'qinfo'.
+ *
+ ****************************************************************************/
+
+static bool dns_match_query(FAR const union dns_addr_u *from, uint16_t id,
+                            FAR const struct dns_query_info_s *qinfo)
+{
+  if (id != qinfo->id)
+    {
+      return false;
+    }
+
+#ifdef CONFIG_NET_IPv4
+  /* Check for an IPv4 address */
+
+  if (from->addr.sa_family == AF_INET)
+    {
+      return memcmp(&from->ipv4.sin_addr, &qinfo->u.srv_ipv4,
+                    sizeof(from->ipv4.sin_addr)) == 0 &&
+             from->ipv4.sin_port == qinfo->srv_port;
+    }
+#endif
+
+#ifdef CONFIG_NET_IPv6
+  /* Check for an IPv6 address */
+
+  if (from->addr.sa_family == AF_INET6)
+    {
+      return memcmp(&from->ipv6.sin6_addr, &qinfo->u.srv_ipv6,
+                    sizeof(from->ipv6.sin6_addr)) == 0 &&
+             from->ipv6.sin6_port == qinfo->srv_port;
+    }
+#endif
+
+  return false;
+}
+
 /****************************************************************************
  * Name: dns_recv_response
  *
  * Description:
- *   Called when new UDP data arrives
+ *   Called when new UDP data arrives.  The response is matched against the
+ *   outstanding queries by the address of the name server and the ID.
+ *
+ * Input Parameters:
+ *   sd      - The socket to receive from.
+ *   addr    - The location to return the IP addresses.
+ *   naddr   - On entry, the count of addresses backing up the 'addr'
+ *     pointer.  On return, the count of the returned addresses.
+ *   queries - The outstanding queries.
+ *   nqueries - The number of outstanding queries.
+ *   ndx     - The location to return the index of the query that was
+ *     answered, or -1 if the response did not match any query.
+ *   ttl     - The location to return the smallest time to live of the
+ *     returned addresses.
  *
  * Returned Value:
  *   Returns number of valid IP address responses.  Negated errno value is
- *   returned in all other cases.
+ *   returned in all other cases:  -ENOENT if the name server reported that
+ *   the hostname does not exist and -EADDRNOTAVAIL if the hostname has no
+ *   record of the queried type.
  *
  ****************************************************************************/
 
 static int dns_recv_response(int sd, FAR union dns_addr_u *addr, int *naddr,
-                             FAR struct dns_query_info_s *qinfo)
+                             FAR struct dns_query_info_s *queries,
+                             int nqueries, FAR int *ndx,
+                             FAR uint32_t *ttl)
 {
+  FAR struct dns_query_info_s *qinfo;
   FAR uint8_t *nameptr;
   FAR uint8_t *namestart;
   FAR uint8_t *endofbuffer;
@@ -357,9 +455,13 @@ static int dns_recv_response(int sd, FAR union dns_addr_u *addr, int *naddr,
   uint16_t nanswers;
   union dns_addr_u recvaddr;
   socklen_t raddrlen;
+  uint32_t rttl;
   int naddr_read;
   int errcode;
   int ret;
+  int i;
+
+  *ndx = -1;
 
   /* Receive the response */
 
@@ -373,53 +475,6 @@ static int dns_recv_response(int sd, FAR union dns_addr_u *addr, int *naddr,
       return errcode;
     }
 
-#ifdef CONFIG_NET_IPv4
-  /* Check for an IPv4 address */
-
-  if (recvaddr.addr.sa_family == AF_INET)
-    {
-      if (memcmp(&recvaddr.ipv4.sin_addr, &qinfo->u.srv_ipv4,
-                 sizeof(recvaddr.ipv4.sin_addr)) != 0)
-        {
-          /* Not response from DNS server. */
-
-          nerr("ERROR: DNS packet from wrong address\n");
-          return -EBADMSG;
-        }
-
-      if (recvaddr.ipv4.sin_port != qinfo->srv_port)
-        {
-          /* Not response from DNS server. */
-
-          nerr("ERROR: DNS packet from wrong port\n");
-          return -EBADMSG;
-        }
-    }
-#endif
-#ifdef CONFIG_NET_IPv6
-  /* Check for an IPv6 address */
-
-  if (recvaddr.addr.sa_family == AF_INET6)
-    {
-      if (memcmp(&recvaddr.ipv6.sin6_addr, &qinfo->u.srv_ipv6,
-                 sizeof(recvaddr.ipv6.sin6_addr)) != 0)
-        {
-          /* Not response from DNS server. */
-
-          nerr("ERROR: DNS packet from wrong address\n");
-          return -EBADMSG;
-        }
-
-      if (recvaddr.ipv6.sin6_port != qinfo->srv_port)
-        {
-          /* Not response from DNS server. */
-
-          nerr("ERROR: DNS packet from wrong port\n");
-          return -EBADMSG;
-        }
-    }
-#endif
-
   if (ret < sizeof(*hdr))
     {
       /* DNS header can't fit in received data */
@@ -438,23 +493,43 @@ static int dns_recv_response(int sd, FAR union dns_addr_u *addr, int *naddr,
         htons(hdr->numquestions), htons(hdr->numanswers),
         htons(hdr->numauthrr), htons(hdr->numextrarr));
 
-  /* Check for error */
+  /* Find the query that is answered by matching the address of the name
+   * server and the ID.
+   */
 
-  if ((hdr->flags2 & DNS_FLAG2_ERR_MASK) != 0)
+  for (i = 0; i < nqueries; i++)
     {
-      nerr("ERROR: DNS reported error: flags2=%02x\n", hdr->flags2);
-      return -EPROTO;
+      if (dns_match_query(&recvaddr, hdr->id, &queries[i]))
+        {
+          break;
+        }
     }
 
-  /* Check for matching ID. */
-
-  if (hdr->id != qinfo->id)
+  if (i >= nqueries)
     {
-      nerr("ERROR: DNS wrong response ID (expected %d, got %d)\n",
-           htons(qinfo->id), htons(hdr->id));
+      nerr("ERROR: DNS packet from wrong address or with wrong ID %d\n",
+           htons(hdr->id));
       return -EBADMSG;
     }
 
+  qinfo = &queries[i];
+  *ndx  = i;
+
+  /* Check for error.  A name error means that the hostname does not
+   * exist.
+   */
+
+  if ((hdr->flags2 & DNS_FLAG2_ERR_MASK) == DNS_FLAG2_ERR_NAME)
+    {
+      ninfo("DNS reported that the name does not exist\n");
+      return -ENOENT;
+    }
+  else if ((hdr->flags2 & DNS_FLAG2_ERR_MASK) != 0)
+    {
+      nerr("ERROR: DNS reported error: flags2=%02x\n", hdr->flags2);
+      return -EPROTO;
+    }
+
   /* We only care about the question(s) and the answers. The authrr
    * and the extrarr are simply discarded.
    */
@@ -541,6 +616,7 @@ static int dns_recv_response(int sd, FAR union dns_addr_u *addr, int *naddr,
 
   ret = OK;
   naddr_read = 0;
+  *ttl = UINT32_MAX;
 
   for (; nanswers > 0; nanswers--)
     {
@@ -553,12 +629,11 @@ static int dns_recv_response(int sd, FAR union dns_addr_u *addr, int *naddr,
           break;
         }
 
-      ans = (FAR struct dns_answer_s *)nameptr;
+      ans  = (FAR struct dns_answer_s *)nameptr;
+      rttl = ((uint32_t)htons(ans->ttl[0]) << 16) | htons(ans->ttl[1]);
 
       ninfo("Answer: type=%04x, class=%04x, ttl=%06x, length=%04x \n",
-            htons(ans->type), htons(ans->class),
-            (htons(ans->ttl[0]) << 16) | htons(ans->ttl[1]),
-            htons(ans->len));
+            htons(ans->type), htons(ans->class), rttl, htons(ans->len));
 
       /* Check for IPv4/6 address type and Internet class. Others are
        * discarded.
@@ -587,6 +662,7 @@ static int dns_recv_response(int sd, FAR union dns_addr_u *addr, int *naddr,
               inaddr->sin_port         = 0;
               inaddr->sin_addr.s_addr  = ans->u.ipv4.s_addr;
 
+              *ttl = MIN(*ttl, rttl);
               naddr_read++;
               if (naddr_read >= *naddr)
                 {
@@ -624,6 +700,7 @@ static int dns_recv_response(int sd, FAR union dns_addr_u *addr, int *naddr,
               inaddr->sin6_port        = 0;
               memcpy(inaddr->sin6_addr.s6_addr, ans->u.ipv6.s6_addr, 16);
 
+              *ttl = MIN(*ttl, rttl);
               naddr_read++;
               if (naddr_read >= *naddr)
                 {
@@ -660,8 +737,8 @@ static int dns_recv_response(int sd, FAR union dns_addr_u *addr, int *naddr,
  * Name: dns_query_callback
  *
  * Description:
- *   Using the DNS information and this DNS server address, look up the
- *   hostname.
+ *   Collect this DNS server address so that it can be queried in parallel
+ *   with the other name servers.
  *
  * Input Parameters:
  *   arg      - Query arguements
@@ -669,9 +746,8 @@ static int dns_recv_response(int sd, FAR union dns_addr_u *addr, int *naddr,
  *   addrlen  - Length of the DNS name server address.
  *
  * Returned Value:
- *   Returns one (1) if the query was successful.  Zero is returned in all
- *   other cases.  The result field of the query structure is set to a
- *   negated errno value indicate the reason for the last failure (only).
+ *   Returns one (1) to stop the traversal when no more name servers can be
+ *   collected.  Zero is returned in all other cases.
  *
  ****************************************************************************/
 
@@ -679,196 +755,66 @@ static int dns_query_callback(FAR void *arg, FAR struct sockaddr *addr,
                               FAR socklen_t addrlen)
 {
   FAR struct dns_query_s *query = (FAR struct dns_query_s *)arg;
-  FAR struct dns_query_info_s qinfo;
-  int retries;
-  int ret;
 
-  /* Loop while receive timeout errors occur and there are remaining
-   * retries.
-  */
+#ifdef CONFIG_NET_IPv4
+  /* Is this an IPv4 address? */
 
-  for (retries = 0; retries < CONFIG_NETDB_DNSCLIENT_RETRIES; retries++)
+  if (addr->sa_family == AF_INET)
     {
-#ifdef CONFIG_NET_IPv4
-      /* Is this an IPv4 address? */
+      /* Yes.. verify the address size */
 
-      if (addr->sa_family == AF_INET)
+      if (addrlen < sizeof(struct sockaddr_in))
         {
-          /* Yes.. verify the address size */
-
-          if (addrlen < sizeof(struct sockaddr_in))
-            {
-              /* Return zero to skip this address and try the next
-               * nameserver address in resolv.conf.
-               */
-
-              nerr("ERROR: Invalid IPv4 address size: %d\n", addrlen);
-              query->result = -EINVAL;
-              return 0;
-            }
+          /* Return zero to skip this address and try the next
+           * nameserver address in resolv.conf.
+           */
 
-          /* Send the IPv4 query */
-
-          ret = dns_send_query(query->sd, query->hostname,
-                               (FAR union dns_addr_u *)addr,
-                               DNS_RECTYPE_A, &qinfo);
-          if (ret < 0)
-            {
-              /* Return zero to skip this address and try the next
-               * nameserver address in resolv.conf.
-               */
-
-              nerr("ERROR: IPv4 dns_send_query failed: %d\n", ret);
-              query->result = ret;
-              return 0;
-            }
-
-          /* Obtain the IPv4 response */
-
-          ret = dns_recv_response(query->sd, query->addr, query->naddr,
-                                  &qinfo);
-          if (ret >= 0)
-            {
-              /* IPv4 response received successfully */
-
-#if CONFIG_NETDB_DNSCLIENT_ENTRIES > 0
-              /* Save the answer in the DNS cache */
-
-              dns_save_answer(query->hostname, query->addr,
-                              *query->naddr);
-#endif
-              /* Return 1 to indicate to (1) stop the traversal, and (2)
-               * indicate that the address was found.
-               */
-
-              return 1;
-            }
-
-          /* Handle errors */
-
-          nerr("ERROR: IPv4 dns_recv_response failed: %d\n", ret);
-
-          if (ret == -EADDRNOTAVAIL)
-            {
-              /* The IPv4 address is not available.  Return zero to
-               * continue the tranversal with the next nameserver
-               * address in resolv.conf.
-               */
-
-              query->result = -EADDRNOTAVAIL;
-              return 0;
-            }
-          else if (ret != -EAGAIN)
-            {
-              /* Some failure other than receive timeout occurred.  Return
-               * zero to skip this address and try the next nameserver
-               * address in resolv.conf.
-               */
-
-              query->result = ret;
-              return 0;
-            }
+          nerr("ERROR: Invalid IPv4 address size: %d\n", addrlen);
+          query->result = -EINVAL;
+          return 0;
         }
-      else
-#endif /* CONFIG_NET_IPv4 */
-
-#ifdef CONFIG_NET_IPv6
-      /* Is this an IPv6 address? */
-
-      if (addr->sa_family == AF_INET6)
-        {
-          /* Yes.. verify the address size */
-
-          if (addrlen < sizeof(struct sockaddr_in6))
-            {
-              /* Return zero to skip this address and try the next
-               * nameserver address in resolv.conf.
-               */
 
-              nerr("ERROR: Invalid IPv6 address size: %d\n", addrlen);
-              query->result = -EINVAL;
-              return 0;
-            }
-
-          /* Send the IPv6 query */
-
-          ret = dns_send_query(query->sd, query->hostname,
-                              (FAR union dns_addr_u *)addr,
-                               DNS_RECTYPE_AAAA, &qinfo);
-          if (ret < 0)
-            {
-              /* Return zero to skip this address and try the next
-               * nameserver address in resolv.conf.
-               */
-
-              nerr("ERROR: IPv6 dns_send_query failed: %d\n", ret);
-              query->result = ret;
-              return 0;
-            }
-
-          /* Obtain the IPv6 response */
-
-          ret = dns_recv_response(query->sd, query->addr, query->naddr,
-                                  &qinfo);
-          if (ret >= 0)
-            {
-              /* IPv6 response received successfully */
-
-#if CONFIG_NETDB_DNSCLIENT_ENTRIES > 0
-              /* Save the answer in the DNS cache */
-
-              dns_save_answer(query->hostname, query->addr, *query->naddr);
+      memcpy(&query->server[query->nserver], addr,
+             sizeof(struct sockaddr_in));
+    }
+  else
 #endif
-              /* Return 1 to indicate to (1) stop the traversal, and (2)
-               * indicate that the address was found.
-               */
-
-              return 1;
-            }
 
-          /* Handle errors */
-
-          nerr("ERROR: IPv6 dns_recv_response failed: %d\n", ret);
+#ifdef CONFIG_NET_IPv6
+  /* Is this an IPv6 address? */
 
-          if (ret == -EADDRNOTAVAIL)
-            {
-              /* The IPv6 address is not available.  Return zero to
-               * continue the tranversal with the next nameserver
-               * address in resolv.conf.
-               */
+  if (addr->sa_family == AF_INET6)
+    {
+      /* Yes.. verify the address size */
 
-              query->result = -EADDRNOTAVAIL;
-              return 0;
-            }
-          else if (ret != -EAGAIN)
-            {
-              /* Some failure other than receive timeout occurred.  Return
-               * zero to skip this address and try the next nameserver
-               * address in resolv.conf.
-               */
+      if (addrlen < sizeof(struct sockaddr_in6))
+        {
+          /* Return zero to skip this address and try the next
+           * nameserver address in resolv.conf.
+           */
 
-              query->result = ret;
-              return 0;
-            }
+          nerr("ERROR: Invalid IPv6 address size: %d\n", addrlen);
+          query->result = -EINVAL;
+          return 0;
         }
-      else
+
+      memcpy(&query->server[query->nserver], addr,
+             sizeof(struct sockaddr_in6));
+    }
+  else
 #endif
-        {
-           /* Unsupported address family. Return zero to continue the
-            * tranversal with the next nameserver address in resolv.conf.
-            */
+    {
+      /* Unsupported address family. Return zero to continue the
+       * tranversal with the next nameserver address in resolv.conf.
+       */
 
-           return 0;
-        }
+      return 0;
     }
 
-  /* We tried and could not communicate with this nameserver. Perhaps it
-   * is down?  Return zero to continue with the next address in the
-   * resolv.conf file.
-   */
+  /* Stop the traversal if there is no space for more name servers */
 
-  query->result = -ETIMEDOUT;
-  return 0;
+  query->nserver++;
+  return query->nserver >= CONFIG_NETDB_DNSCLIENT_MAXSERVERS ? 1 : 0;
 }
 
 /****************************************************************************
@@ -882,6 +828,12 @@ static int dns_query_callback(FAR void *arg, FAR struct sockaddr *addr,
  *   Using the DNS resolver socket (sd), look up the 'hostname', and
  *   return its IP address in 'ipaddr'
  *
+ *   The queries for all record types are sent to all of the configured
+ *   name servers at once (up to CONFIG_NETDB_DNSCLIENT_MAXSERVERS) and the
+ *   first valid answer for each record type is used.  The answer is saved
+ *   in the DNS cache for its time to live.  If the hostname does not
+ *   exist, that is saved in the DNS cache too.
+ *
  * Input Parameters:
  *   sd       - The socket descriptor previously initialized by dsn_bind().
  *   hostname - The hostname string to be resolved.
@@ -900,34 +852,224 @@ int dns_query(int sd, FAR const char *hostname, FAR union dns_addr_u *addr,
               FAR int *naddr)
 {
   FAR struct dns_query_s query;
+  struct dns_query_info_s qinfo[DNS_MAX_QUERIES];
+  union dns_addr_u answer[DNS_NTYPES][CONFIG_NETDB_DNSCLIENT_MAXIP];
+  union dns_addr_u recvaddr[CONFIG_NETDB_DNSCLIENT_MAXIP];
+  int nanswer[DNS_NTYPES];
+  bool done[DNS_NTYPES];
+  uint32_t minttl;
+  uint32_t ttl;
+  bool answered;
+  bool finished;
+  bool pending;
+  int retries;
+  int nqinfo;
+  int ndx;
   int ret;
+  int i;
+  int j;
+  int t;
 
-  /* Set up the query info structure */
-
-  query.sd       = sd;
-  query.result   = -EADDRNOTAVAIL;
-  query.hostname = hostname;
-  query.addr     = addr;
-  query.naddr    = naddr;
-
-  /* Perform the query. dns_foreach_nameserver() will return:
+  /* Collect the name servers. dns_foreach_nameserver() will return:
    *
-   *  1 - The query was successful.
-   *  0 - Look up failed
+   *  1 - All name servers that fit were collected.
+   *  0 - All name servers were traversed.
    * <0 - Some other failure (?, shouldn't happen)
    */
 
+  query.result  = -EADDRNOTAVAIL;
+  query.nserver = 0;
+
   ret = dns_foreach_nameserver(dns_query_callback, &query);
-  if (ret > 0)
+  if (ret < 0)
+    {
+      return ret;
+    }
+  else if (query.nserver == 0)
+    {
+      return query.result;
+    }
+
+  for (t = 0; t < DNS_NTYPES; t++)
+    {
+      nanswer[t] = 0;
+      done[t]    = false;
+    }
+
+  minttl = UINT32_MAX;
+
+  /* Loop while receive timeout errors occur and there are remaining
+   * retries.  Stop as soon as any of the record types was answered.
+   */
+
+  for (retries = 0; retries < CONFIG_NETDB_DNSCLIENT_RETRIES; retries++)
     {
-      /* The lookup was successful */
+      /* Send the query of each unanswered record type to all of the name
+       * servers.
+       */
+
+      nqinfo = 0;
+      for (t = 0; t < DNS_NTYPES; t++)
+        {
+          if (done[t])
+            {
+              continue;
+            }
+
+          for (i = 0; i < query.nserver; i++)
+            {
+              ret = dns_send_query(sd, hostname, &query.server[i],
+                                   g_dns_rectype[t], &qinfo[nqinfo]);
+              if (ret < 0)
+                {
+                  /* Skip this name server and try the next one */
+
+                  nerr("ERROR: dns_send_query failed: %d\n", ret);
+                  query.result = ret;
+                  continue;
+                }
+
+              qinfo[nqinfo].type    = t;
+              qinfo[nqinfo].pending = true;
+              nqinfo++;
+            }
+        }
+
+      /* Collect the responses until every query is answered or the receive
+       * times out.
+       */
 
       ret = OK;
+      for (; ; )
+        {
+          pending = false;
+          for (i = 0; i < nqinfo; i++)
+            {
+              if (qinfo[i].pending && !done[qinfo[i].type])
+                {
+                  pending = true;
+                  break;
+                }
+            }
+
+          if (!pending)
+            {
+              break;
+            }
+
+          t   = 0;
+          j   = CONFIG_NETDB_DNSCLIENT_MAXIP;
+          ret = dns_recv_response(sd, recvaddr, &j, qinfo, nqinfo, &ndx,
+                                  &ttl);
+          if (ndx >= 0)
+            {
+              t = qinfo[ndx].type;
+              qinfo[ndx].pending = false;
+            }
+
+          if (ret > 0 && !done[t])
+            {
+              /* The first valid answer for this record type wins */
+
+              memcpy(answer[t], recvaddr, j * sizeof(union dns_addr_u));
+              nanswer[t] = j;
+              done[t]    = true;
+              minttl     = MIN(minttl, ttl);
+            }
+          else if (ret == -ENOENT)
+            {
+              /* The hostname does not exist.  There is no need to ask
+               * for the other record types either.
+               */
+
+              for (t = 0; t < DNS_NTYPES; t++)
+                {
+                  done[t] = true;
+                }
+            }
+          else if (ret == -EADDRNOTAVAIL && ndx >= 0)
+            {
+              /* The hostname has no record of this type */
+
+              done[t] = true;
+            }
+          else if (ret == -EAGAIN)
+            {
+              /* Receive timeout.  Try again, if retries remain. */
+
+              break;
+            }
+          else if (ret < 0)
+            {
+              /* Some failure other than receive timeout occurred.  An
+               * unrelated or malformed response from a name server is
+               * ignored; the other name servers may still answer.
+               */
+
+              nerr("ERROR: dns_recv_response failed: %d\n", ret);
+              if (ndx >= 0)
+                {
+                  query.result = ret;
+                }
+            }
+        }
+
+      /* Stop if any record type has been answered or every name server
+       * has given up.
+       */
+
+      answered = false;
+      for (t = 0; t < DNS_NTYPES; t++)
+        {
+          answered |= done[t];
+        }
+
+      if (answered || ret != -EAGAIN)
+        {
+          break;
+        }
+
+      query.result = -ETIMEDOUT;
+    }
+
+  /* Return the addresses of all record types, up to the space available */
+
+  j = 0;
+  for (t = 0; t < DNS_NTYPES; t++)
+    {
+      for (i = 0; i < nanswer[t] && j < *naddr; i++)
+        {
+          addr[j++] = answer[t][i];
+        }
     }
-  else if (ret == 0)
+
+  if (j > 0)
     {
-      ret = query.result;
+      *naddr = j;
+
+#if CONFIG_NETDB_DNSCLIENT_ENTRIES > 0
+      /* Save the answer in the DNS cache */
+
+      dns_save_answer(hostname, addr, j, minttl);
+#endif
+      return OK;
+    }
+
+  finished = true;
+  for (t = 0; t < DNS_NTYPES; t++)
+    {
+      finished &= done[t];
+    }
+
+  if (finished)
+    {
+      /* Every record type was answered, but without any address */
+
+#if CONFIG_NETDB_DNSCLIENT_ENTRIES > 0
+      dns_save_answer(hostname, NULL, 0, 0);
+#endif
+      return -EADDRNOTAVAIL;
     }
 
-  return ret;
+  return query.result;
 }
@@ -852,11 +852,17 @@ int gethostbyname_r(FAR const char *name, FAR struct hostent *host,
 
       return OK;
     }
-#endif
 
-  /* Try to get the host address using the DNS name server */
+  /* Try to get the host address using the DNS name server, unless the
+   * cache remembers that the hostname has no address.
+   */
+
+  if (ret != -EADDRNOTAVAIL)
+#endif
+    {
+      ret = lib_dns_lookup(name, host, buf, buflen);
+    }
 
-  ret = lib_dns_lookup(name, host, buf, buflen);
   if (ret >= 0)
     {
       if (result)
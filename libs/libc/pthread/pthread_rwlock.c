@@ -44,6 +44,8 @@
 #include <errno.h>
 #include <debug.h>
 
+#include "pthread/pthread_rwlock.h"
+
 /****************************************************************************
  * Public Functions
  ****************************************************************************/
@@ -58,9 +60,8 @@ int pthread_rwlock_init(FAR pthread_rwlock_t *lock,
       return -ENOSYS;
     }
 
-  lock->num_readers       = 0;
-  lock->num_writers       = 0;
-  lock->write_in_progress = false;
+  lock->state       = 0;
+  lock->num_writers = 0;
 
   err = pthread_cond_init(&lock->cv, NULL);
   if (err != 0)
@@ -75,6 +76,18 @@ int pthread_rwlock_init(FAR pthread_rwlock_t *lock,
       return err;
     }
 
+  /* The default mutex protocol is priority inheritance, so a writer that
+   * waits for wrlock boosts the writer holding it.
+   */
+
+  err = pthread_mutex_init(&lock->wrlock, NULL);
+  if (err != 0)
+    {
+      pthread_mutex_destroy(&lock->lock);
+      pthread_cond_destroy(&lock->cv);
+      return err;
+    }
+
   return err;
 }
 
@@ -82,39 +95,72 @@ int pthread_rwlock_destroy(FAR pthread_rwlock_t *lock)
 {
   int cond_err  = pthread_cond_destroy(&lock->cv);
   int mutex_err = pthread_mutex_destroy(&lock->lock);
+  int wr_err    = pthread_mutex_destroy(&lock->wrlock);
 
   if (mutex_err)
     {
       return mutex_err;
     }
 
+  if (wr_err)
+    {
+      return wr_err;
+    }
+
   return cond_err;
 }
 
 int pthread_rwlock_unlock(FAR pthread_rwlock_t *rw_lock)
 {
+  uint32_t state;
   int err;
 
+#ifdef CONFIG_PTHREAD_RWLOCK_FASTPATH
+  /* A reader drops its count with a single atomic decrement.  Writers never
+   * hold the lock while the count is non-zero.  Only the last reader out,
+   * with a writer waiting, needs the mutex to wake the writer up.
+   */
+
+  if ((rwlock_state(rw_lock) & RWLOCK_RDMASK) > 0)
+    {
+      state = rwlock_rddec(rw_lock);
+      if ((state & RWLOCK_RDMASK) != 1 || (state & RWLOCK_WRITER) == 0)
+        {
+          return OK;
+        }
+
+      err = pthread_mutex_lock(&rw_lock->lock);
+      if (err != 0)
+        {
+          return err;
+        }
+
+      err = pthread_cond_broadcast(&rw_lock->cv);
+      pthread_mutex_unlock(&rw_lock->lock);
+      return err;
+    }
+#endif
+
   err = pthread_mutex_lock(&rw_lock->lock);
   if (err != 0)
     {
       return err;
     }
 
-  if (rw_lock->num_readers > 0)
+  state = rwlock_state(rw_lock);
+  if ((state & RWLOCK_RDMASK) > 0)
     {
-      rw_lock->num_readers--;
-
-      if (rw_lock->num_readers == 0)
+      rwlock_rddec(rw_lock);
+      if ((state & RWLOCK_RDMASK) == 1)
         {
           err = pthread_cond_broadcast(&rw_lock->cv);
         }
     }
-  else if (rw_lock->write_in_progress)
+  else if ((state & RWLOCK_WRLOCKED) != 0)
     {
-      rw_lock->write_in_progress = false;
-
+      rwlock_clrbits(rw_lock, RWLOCK_WRLOCKED);
       err = pthread_cond_broadcast(&rw_lock->cv);
+      pthread_mutex_unlock(&rw_lock->wrlock);
     }
   else
     {
@@ -0,0 +1,153 @@
+/****************************************************************************
+ * libs/libc/pthread/pthread_rwlock.h
+ *
+ *   Copyright (C) 2017 Mark Schulte. All rights reserved.
+ *   Author: Mark Schulte <mark@mjs.pw>
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in
+ *    the documentation and/or other materials provided with the
+ *    distribution.
+ * 3. Neither the name NuttX nor the names of its contributors may be
+ *    used to endorse or promote products derived from this software
+ *    without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+ * FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE
+ * COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+ * INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,
+ * BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS
+ * OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED
+ * AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ * LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN
+ * ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ *
+ ****************************************************************************/
+
+#ifndef __LIBS_LIBC_PTHREAD_PTHREAD_RWLOCK_H
+#define __LIBS_LIBC_PTHREAD_PTHREAD_RWLOCK_H
+
+/****************************************************************************
+ * Included Files
+ ****************************************************************************/
+
+#include <nuttx/config.h>
+
+#include <stdint.h>
+#include <stdbool.h>
+#include <pthread.h>
+
+/****************************************************************************
+ * Pre-processor Definitions
+ ****************************************************************************/
+
+/* Layout of pthread_rwlock_t state */
+
+#define RWLOCK_WRLOCKED   0x80000000u  /* A writer holds the lock */
+#define RWLOCK_WRWAITING  0x40000000u  /* Writers are waiting for the lock */
+#define RWLOCK_WRITER     (RWLOCK_WRLOCKED | RWLOCK_WRWAITING)
+#define RWLOCK_RDMASK     0x3fffffffu  /* Number of readers holding it */
+
+/****************************************************************************
+ * Inline Functions
+ ****************************************************************************/
+
+/* With the fast path, readers change the state without holding the mutex,
+ * so every update is atomic.  Without it, the state is only accessed with
+ * the mutex held.  The update helpers return the previous state.
+ */
+
+static inline uint32_t rwlock_state(FAR pthread_rwlock_t *rw_lock)
+{
+#ifdef CONFIG_PTHREAD_RWLOCK_FASTPATH
+  return __atomic_load_n(&rw_lock->state, __ATOMIC_ACQUIRE);
+#else
+  return rw_lock->state;
+#endif
+}
+
+static inline uint32_t rwlock_rdinc(FAR pthread_rwlock_t *rw_lock)
+{
+#ifdef CONFIG_PTHREAD_RWLOCK_FASTPATH
+  return __atomic_fetch_add(&rw_lock->state, 1, __ATOMIC_ACQ_REL);
+#else
+  return rw_lock->state++;
+#endif
+}
+
+static inline uint32_t rwlock_rddec(FAR pthread_rwlock_t *rw_lock)
+{
+#ifdef CONFIG_PTHREAD_RWLOCK_FASTPATH
+  return __atomic_fetch_sub(&rw_lock->state, 1, __ATOMIC_ACQ_REL);
+#else
+  return rw_lock->state--;
+#endif
+}
+
+static inline uint32_t rwlock_setbits(FAR pthread_rwlock_t *rw_lock,
+                                      uint32_t bits)
+{
+#ifdef CONFIG_PTHREAD_RWLOCK_FASTPATH
+  return __atomic_fetch_or(&rw_lock->state, bits, __ATOMIC_ACQ_REL);
+#else
+  uint32_t state = rw_lock->state;
+
+  rw_lock->state = state | bits;
+  return state;
+#endif
+}
+
+static inline uint32_t rwlock_clrbits(FAR pthread_rwlock_t *rw_lock,
+                                      uint32_t bits)
+{
+#ifdef CONFIG_PTHREAD_RWLOCK_FASTPATH
+  return __atomic_fetch_and(&rw_lock->state, ~bits, __ATOMIC_ACQ_REL);
+#else
+  uint32_t state = rw_lock->state;
+
+  rw_lock->state = state & ~bits;
+  return state;
+#endif
+}
+
+/****************************************************************************
+ * Name: rwlock_fastrdlock
+ *
+ * Description:
+ *   Take a read lock with one compare-and-exchange if no writer holds or
+ *   waits for the lock.  Returns false if the slow path must be used.
+ *
+ ****************************************************************************/
+
+static inline bool rwlock_fastrdlock(FAR pthread_rwlock_t *rw_lock)
+{
+#ifdef CONFIG_PTHREAD_RWLOCK_FASTPATH
+  uint32_t state = __atomic_load_n(&rw_lock->state, __ATOMIC_RELAXED);
+
+  while ((state & RWLOCK_WRITER) == 0 &&
+         (state & RWLOCK_RDMASK) != RWLOCK_RDMASK)
+    {
+      /* On failure, the current state is returned in state */
+
+      if (__atomic_compare_exchange_n(&rw_lock->state, &state, state + 1,
+                                      false, __ATOMIC_ACQUIRE,
+                                      __ATOMIC_RELAXED))
+        {
+          return true;
+        }
+    }
+#endif
+
+  return false;
+}
+
+#endif /* __LIBS_LIBC_PTHREAD_PTHREAD_RWLOCK_H */
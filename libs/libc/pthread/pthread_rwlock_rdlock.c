@@ -44,6 +44,8 @@
 #include <errno.h>
 #include <debug.h>
 
+#include "pthread/pthread_rwlock.h"
+
 /****************************************************************************
  * Private Functions
  ****************************************************************************/
@@ -59,19 +61,24 @@ static void rdlock_cleanup(FAR void *arg)
 
 static int tryrdlock(FAR pthread_rwlock_t *rw_lock)
 {
+  uint32_t state = rwlock_state(rw_lock);
   int err;
 
-  if (rw_lock->num_writers > 0 || rw_lock->write_in_progress)
+  /* Readers wait while a writer holds the lock and also while writers are
+   * waiting for it, so that a stream of readers cannot starve writers.
+   */
+
+  if ((state & RWLOCK_WRITER) != 0)
     {
       err = EBUSY;
     }
-  else if (rw_lock->num_readers == UINT_MAX)
+  else if ((state & RWLOCK_RDMASK) == RWLOCK_RDMASK)
     {
       err = EAGAIN;
     }
   else
     {
-      rw_lock->num_readers++;
+      rwlock_rdinc(rw_lock);
       err = OK;
     }
 
@@ -100,7 +107,14 @@ static int tryrdlock(FAR pthread_rwlock_t *rw_lock)
 
 int pthread_rwlock_tryrdlock(FAR pthread_rwlock_t *rw_lock)
 {
-  int err = pthread_mutex_trylock(&rw_lock->lock);
+  int err;
+
+  if (rwlock_fastrdlock(rw_lock))
+    {
+      return OK;
+    }
+
+  err = pthread_mutex_trylock(&rw_lock->lock);
 
   if (err != 0)
     {
@@ -116,7 +130,16 @@ int pthread_rwlock_tryrdlock(FAR pthread_rwlock_t *rw_lock)
 int pthread_rwlock_timedrdlock(FAR pthread_rwlock_t *rw_lock,
                                FAR const struct timespec *ts)
 {
-  int err = pthread_mutex_lock(&rw_lock->lock);
+  int err;
+
+  /* Uncontended readers never touch the mutex */
+
+  if (rwlock_fastrdlock(rw_lock))
+    {
+      return OK;
+    }
+
+  err = pthread_mutex_lock(&rw_lock->lock);
 
   if (err != 0)
     {
@@ -40,20 +40,43 @@
 #include <nuttx/config.h>
 
 #include <stdint.h>
+#include <stdbool.h>
 #include <pthread.h>
 #include <errno.h>
 #include <debug.h>
 
+#include "pthread/pthread_rwlock.h"
+
 /****************************************************************************
  * Private Functions
  ****************************************************************************/
 
+/****************************************************************************
+ * Name: wrlock_leave
+ *
+ * Description:
+ *   A writer stops waiting for the lock, either because it now holds it or
+ *   because it gave up.  Readers are admitted again once no writer is
+ *   waiting.  Called with the mutex held.
+ *
+ ****************************************************************************/
+
+static void wrlock_leave(FAR pthread_rwlock_t *rw_lock)
+{
+  if (--rw_lock->num_writers == 0)
+    {
+      rwlock_clrbits(rw_lock, RWLOCK_WRWAITING);
+    }
+}
+
 #ifdef CONFIG_PTHREAD_CLEANUP
 static void wrlock_cleanup(FAR void *arg)
 {
   FAR pthread_rwlock_t *rw_lock = (FAR pthread_rwlock_t *)arg;
 
-  rw_lock->num_writers--;
+  wrlock_leave(rw_lock);
+  pthread_cond_broadcast(&rw_lock->cv);
+  pthread_mutex_unlock(&rw_lock->wrlock);
   pthread_mutex_unlock(&rw_lock->lock);
 }
 #endif
@@ -80,20 +103,37 @@ static void wrlock_cleanup(FAR void *arg)
 
 int pthread_rwlock_trywrlock(FAR pthread_rwlock_t *rw_lock)
 {
-  int err = pthread_mutex_trylock(&rw_lock->lock);
+  uint32_t state;
+  int err;
 
+  err = pthread_mutex_trylock(&rw_lock->wrlock);
   if (err != 0)
     {
       return err;
     }
 
-  if (rw_lock->num_readers > 0 || rw_lock->write_in_progress)
+  err = pthread_mutex_trylock(&rw_lock->lock);
+  if (err != 0)
     {
-      err = EBUSY;
+      pthread_mutex_unlock(&rw_lock->wrlock);
+      return err;
     }
-  else
+
+  /* Claim the lock first so that no reader can get in on the fast path
+   * after the reader count has been checked.
+   */
+
+  state = rwlock_setbits(rw_lock, RWLOCK_WRLOCKED);
+  if ((state & RWLOCK_RDMASK) > 0)
     {
-      rw_lock->write_in_progress = true;
+      /* Readers hold the lock.  Let go again and release any reader that
+       * saw the lock claimed in the meantime.
+       */
+
+      rwlock_clrbits(rw_lock, RWLOCK_WRLOCKED);
+      pthread_cond_broadcast(&rw_lock->cv);
+      pthread_mutex_unlock(&rw_lock->wrlock);
+      err = EBUSY;
     }
 
   pthread_mutex_unlock(&rw_lock->lock);
@@ -103,6 +143,7 @@ int pthread_rwlock_trywrlock(FAR pthread_rwlock_t *rw_lock)
 int pthread_rwlock_timedwrlock(FAR pthread_rwlock_t *rw_lock,
                                FAR const struct timespec *ts)
 {
+  bool owner = false;
   int err = pthread_mutex_lock(&rw_lock->lock);
 
   if (err != 0)
@@ -116,12 +157,36 @@ int pthread_rwlock_timedwrlock(FAR pthread_rwlock_t *rw_lock,
       goto exit_with_mutex;
     }
 
+  /* Announce the writer.  From here on, new readers wait and the lock
+   * drains to the writers.
+   */
+
   rw_lock->num_writers++;
+  rwlock_setbits(rw_lock, RWLOCK_WRWAITING);
+  pthread_mutex_unlock(&rw_lock->lock);
+
+  /* Writers queue on wrlock.  It is held for as long as the write lock is
+   * held, so its priority inheritance boosts the current writer.
+   */
+
+  if (ts != NULL)
+    {
+      err = pthread_mutex_timedlock(&rw_lock->wrlock, ts);
+    }
+  else
+    {
+      err = pthread_mutex_lock(&rw_lock->wrlock);
+    }
+
+  owner = (err == 0);
+  pthread_mutex_lock(&rw_lock->lock);
+
+  /* Then wait for the readers to drain */
 
 #ifdef CONFIG_PTHREAD_CLEANUP
   pthread_cleanup_push(&wrlock_cleanup, rw_lock);
 #endif
-  while (rw_lock->write_in_progress || rw_lock->num_readers > 0)
+  while (err == 0 && (rwlock_state(rw_lock) & RWLOCK_RDMASK) > 0)
     {
       if (ts != NULL)
         {
@@ -131,11 +196,6 @@ int pthread_rwlock_timedwrlock(FAR pthread_rwlock_t *rw_lock,
         {
           err = pthread_cond_wait(&rw_lock->cv, &rw_lock->lock);
         }
-
-      if (err != 0)
-        {
-          break;
-        }
     }
 #ifdef CONFIG_PTHREAD_CLEANUP
   pthread_cleanup_pop(0);
@@ -143,16 +203,23 @@ int pthread_rwlock_timedwrlock(FAR pthread_rwlock_t *rw_lock,
 
   if (err == 0)
     {
-      rw_lock->write_in_progress = true;
+      /* Set the lock before the waiting bit can be cleared */
+
+      rwlock_setbits(rw_lock, RWLOCK_WRLOCKED);
+      wrlock_leave(rw_lock);
     }
   else
     {
       /* In case of error, notify any blocked readers. */
 
+      wrlock_leave(rw_lock);
       pthread_cond_broadcast(&rw_lock->cv);
-    }
 
-  rw_lock->num_writers--;
+      if (owner)
+        {
+          pthread_mutex_unlock(&rw_lock->wrlock);
+        }
+    }
 
 exit_with_mutex:
   pthread_mutex_unlock(&rw_lock->lock);
@@ -92,6 +92,8 @@ int nxsem_init(FAR sem_t *sem, int pshared, unsigned int value)
       sem->flags            = 0;
 #  if CONFIG_SEM_PREALLOCHOLDERS > 0
       sem->hhead            = NULL;
+      sem->holder.htcb      = NULL;
+      sem->holder.counts    = 0;
 #  else
       sem->holder[0].htcb   = NULL;
       sem->holder[0].counts = 0;
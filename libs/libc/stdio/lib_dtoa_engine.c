@@ -54,9 +54,13 @@
 #define SUBSTITUTE(a) PASTE(a)
 #define MIN_MANT      (SUBSTITUTE(DBL_DIG))
 #define MAX_MANT      (10.0 * MIN_MANT)
-#define MIN_MANT_INT  ((uint64_t)MIN_MANT)
 #define MIN_MANT_EXP  DBL_DIG
 
+/* Mantissa digits are produced in chunks that fit in 32 bits */
+
+#define CHUNK_DIGITS  8
+#define CHUNK_DIV     100000000
+
 #define MAX(a, b)     ((a) > (b) ? (a) : (b))
 #define MIN(a, b)     ((a) < (b) ? (a) : (b))
 
@@ -148,18 +152,34 @@ int __dtoa_engine(double_t x, FAR struct dtoa_s *dtoa, int max_digits,
           exp++;
         }
 
-      /* Now convert mantissa to decimal. */
+      /* Now convert the mantissa to decimal.  It has MIN_MANT_EXP + 1
+       * digits, which are split into chunks of eight with one 64-bit
+       * division per chunk.  The digits within a chunk only need 32-bit
+       * arithmetic.
+       */
 
       uint64_t mant = (uint64_t) x;
-      uint64_t decimal = MIN_MANT_INT;
+      char digits[MIN_MANT_EXP + 1];
+      uint32_t chunk;
+      int j;
+
+      for (i = MIN_MANT_EXP + 1; i > 0; )
+        {
+          uint64_t upper = mant / CHUNK_DIV;
 
-      /* Compute digits */
+          chunk = (uint32_t)(mant - upper * CHUNK_DIV);
+          mant  = upper;
+
+          for (j = 0; j < CHUNK_DIGITS && i > 0; j++)
+            {
+              digits[--i] = chunk % 10 + '0';
+              chunk      /= 10;
+            }
+        }
 
       for (i = 0; i < max_digits; i++)
         {
-          dtoa->digits[i] = mant / decimal + '0';
-          mant %= decimal;
-          decimal /= 10;
+          dtoa->digits[i] = digits[i];
         }
     }
 
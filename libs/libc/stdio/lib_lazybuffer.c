@@ -0,0 +1,92 @@
+/****************************************************************************
+ * libs/libc/stdio/lib_lazybuffer.c
+ *
+ *   Copyright (C) 2020 Gregory Nutt. All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in
+ *    the documentation and/or other materials provided with the
+ *    distribution.
+ * 3. Neither the name NuttX nor the names of its contributors may be
+ *    used to endorse or promote products derived from this software
+ *    without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+ * FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE
+ * COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+ * INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,
+ * BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS
+ * OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED
+ * AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ * LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN
+ * ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ *
+ ****************************************************************************/
+
+/****************************************************************************
+ * Included Files
+ ****************************************************************************/
+
+#include <nuttx/config.h>
+
+#include <stdio.h>
+
+#include "libc.h"
+
+#ifdef CONFIG_STDIO_LAZY_BUFFER
+
+/****************************************************************************
+ * Public Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: lib_lazybuffer
+ *
+ * Description:
+ *   Allocate the I/O buffer of a stream on its first use.  fs_fdopen()
+ *   defers the allocation so that tasks that never use the standard
+ *   streams do not pay for their buffers.  If the allocation fails, the
+ *   stream simply stays unbuffered.
+ *
+ ****************************************************************************/
+
+void lib_lazybuffer(FAR FILE *stream)
+{
+  FAR unsigned char *buffer;
+
+  if ((stream->fs_flags & __FS_FLAG_LAZY) == 0)
+    {
+      return;
+    }
+
+  lib_take_semaphore(stream);
+
+  /* Check again now that we have exclusive access to the stream */
+
+  if ((stream->fs_flags & __FS_FLAG_LAZY) != 0)
+    {
+      stream->fs_flags &= ~__FS_FLAG_LAZY;
+
+      buffer = (FAR unsigned char *)lib_malloc(CONFIG_STDIO_BUFFER_SIZE);
+      if (buffer != NULL)
+        {
+          stream->fs_bufstart = buffer;
+          stream->fs_bufend   = &buffer[CONFIG_STDIO_BUFFER_SIZE];
+          stream->fs_bufpos   = buffer;
+          stream->fs_bufread  = buffer;
+        }
+    }
+
+  lib_give_semaphore(stream);
+}
+
+#endif /* CONFIG_STDIO_LAZY_BUFFER */
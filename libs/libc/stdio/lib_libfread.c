@@ -102,6 +102,7 @@ ssize_t lib_fread(FAR void *ptr, size_t count, FAR FILE *stream)
 #ifndef CONFIG_STDIO_DISABLE_BUFFERING
       /* Is there an I/O buffer? */
 
+      lib_lazybuffer(stream);
       if (stream->fs_bufstart != NULL)
         {
           /* If the buffer is currently being used for write access, then
@@ -122,12 +123,21 @@ ssize_t lib_fread(FAR void *ptr, size_t count, FAR FILE *stream)
             {
               /* Is there readable data in the buffer? */
 
-              while (remaining > 0 && stream->fs_bufpos < stream->fs_bufread)
+              if (stream->fs_bufpos < stream->fs_bufread)
                 {
-                  /* Yes, copy a byte into the user buffer */
+                  /* Yes, copy as much as is needed into the user buffer */
 
-                  *dest++ = *stream->fs_bufpos++;
-                  remaining--;
+                  size_t gulp_size = stream->fs_bufread - stream->fs_bufpos;
+
+                  if (gulp_size > remaining)
+                    {
+                      gulp_size = remaining;
+                    }
+
+                  memcpy(dest, stream->fs_bufpos, gulp_size);
+                  dest              += gulp_size;
+                  stream->fs_bufpos += gulp_size;
+                  remaining         -= gulp_size;
                 }
 
               /* The buffer is empty OR we have already supplied the number of
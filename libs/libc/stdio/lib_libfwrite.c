@@ -43,6 +43,7 @@
 #include <stdbool.h>
 #include <stdio.h>
 #include <unistd.h>
+#include <string.h>
 #include <fcntl.h>
 #include <errno.h>
 
@@ -64,7 +65,6 @@ ssize_t lib_fwrite(FAR const void *ptr, size_t count, FAR FILE *stream)
   FAR const unsigned char *start = ptr;
   FAR const unsigned char *src   = ptr;
   ssize_t ret = ERROR;
-  unsigned char *dest;
 
   /* Make sure that writing to this stream is allowed */
 
@@ -84,6 +84,7 @@ ssize_t lib_fwrite(FAR const void *ptr, size_t count, FAR FILE *stream)
 
   /* If there is no I/O buffer, then output data immediately */
 
+  lib_lazybuffer(stream);
   if (stream->fs_bufstart == NULL)
    {
      ret = _NX_WRITE(stream->fs_fd, ptr, count);
@@ -120,6 +121,38 @@ ssize_t lib_fwrite(FAR const void *ptr, size_t count, FAR FILE *stream)
 
       size_t gulp_size = stream->fs_bufend - stream->fs_bufpos;
 
+      /* If the buffer is empty and the remaining data would fill it
+       * anyway, write the data directly rather than staging it through
+       * the buffer.
+       */
+
+      if (stream->fs_bufpos == stream->fs_bufstart && count >= gulp_size)
+        {
+          ssize_t nwritten = _NX_WRITE(stream->fs_fd, src, count);
+          if (nwritten <= 0)
+            {
+#if defined(CONFIG_BUILD_FLAT) || defined(__KERNEL__)
+              if (nwritten < 0)
+                {
+                  _NX_SETERRNO((int)-nwritten);
+                }
+#endif
+
+              /* Report an error only if nothing at all was written */
+
+              if (nwritten < 0 && src == start)
+                {
+                  goto errout_with_semaphore;
+                }
+
+              break;
+            }
+
+          src   += nwritten;
+          count -= nwritten;
+          continue;
+        }
+
       /* Will the user data fit into the amount of buffer space
        * that we have left?
        */
@@ -139,16 +172,13 @@ ssize_t lib_fwrite(FAR const void *ptr, size_t count, FAR FILE *stream)
 
       /* Transfer the data into the buffer */
 
-      for (dest = stream->fs_bufpos; gulp_size > 0; gulp_size--)
-        {
-          *dest++ = *src++;
-        }
-
-      stream->fs_bufpos = dest;
+      memcpy(stream->fs_bufpos, src, gulp_size);
+      src               += gulp_size;
+      stream->fs_bufpos += gulp_size;
 
       /* Is the buffer full? */
 
-      if (dest >= stream->fs_bufend)
+      if (stream->fs_bufpos >= stream->fs_bufend)
         {
           /* Flush the buffered data to the IO stream */
 
@@ -73,7 +73,26 @@
 #  undef putc
 #endif
 
-#define putc(c,stream)  (total_len++, (stream)->put(stream, c))
+#if CONFIG_LIBC_PRINTF_BUFSIZE > 0
+/* Collect the output in a local buffer and hand it to the stream in
+ * blocks rather than making an indirect call for each character.
+ */
+
+#  define putc(c,stream) \
+  do \
+    { \
+      total_len++; \
+      outbuf[outlen++] = (c); \
+      if (outlen >= CONFIG_LIBC_PRINTF_BUFSIZE) \
+        { \
+          vsprintf_flush(stream, outbuf, outlen); \
+          outlen = 0; \
+        } \
+    } \
+  while (0)
+#else
+#  define putc(c,stream)  (total_len++, (stream)->put(stream, c))
+#endif
 
 /* Order is relevant here and matches order in format string */
 
@@ -144,9 +163,38 @@ struct arg
  static const char g_nullstring[] = "(null)";
 
 /****************************************************************************
- * Public Functions
+ * Private Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: vsprintf_flush
+ *
+ * Description:
+ *   Pass a block of formatted output to the stream, with one call if the
+ *   stream supports block writes.
+ *
  ****************************************************************************/
 
+#if CONFIG_LIBC_PRINTF_BUFSIZE > 0
+static void vsprintf_flush(FAR struct lib_outstream_s *stream,
+                           FAR const char *buffer, int buflen)
+{
+  int i;
+
+  if (stream->puts != NULL)
+    {
+      stream->puts(stream, buffer, buflen);
+    }
+  else
+    {
+      for (i = 0; i < buflen; i++)
+        {
+          stream->put(stream, buffer[i]);
+        }
+    }
+}
+#endif
+
 static int vsprintf_internal(FAR struct lib_outstream_s *stream,
                              FAR struct arg *arglist, int numargs,
                              FAR const IPTR char *fmt, va_list ap)
@@ -174,6 +222,10 @@ static int vsprintf_internal(FAR struct lib_outstream_s *stream,
   size_t size;
   unsigned char len;
   int total_len = 0;
+#if CONFIG_LIBC_PRINTF_BUFSIZE > 0
+  char outbuf[CONFIG_LIBC_PRINTF_BUFSIZE];
+  int outlen = 0;
+#endif
 
 #ifdef CONFIG_LIBC_NUMBERED_ARGS
 
@@ -210,6 +262,54 @@ static int vsprintf_internal(FAR struct lib_outstream_s *stream,
 #endif
         }
 
+#ifdef CONFIG_LIBC_PRINTF_OPTSPEED
+      /* Fast paths for plain %d, %i, %u, %x and %s, which make up most
+       * format strings.  Any flag, width, precision or length modifier
+       * takes the general path below.
+       */
+
+#  ifdef CONFIG_LIBC_NUMBERED_ARGS
+      if (stream != NULL)
+#  endif
+        {
+          if (c == 's')
+            {
+              pnt = va_arg(ap, FAR char *);
+              if (pnt == NULL)
+                {
+                  pnt = g_nullstring;
+                }
+
+              while (*pnt != '\0')
+                {
+                  putc(*pnt++, stream);
+                }
+
+              continue;
+            }
+          else if (c == 'd' || c == 'i' || c == 'u' || c == 'x')
+            {
+              unsigned int x = va_arg(ap, unsigned int);
+
+              if ((c == 'd' || c == 'i') && (int)x < 0)
+                {
+                  putc('-', stream);
+                  x = -x;
+                }
+
+              c = __ultoa_invert(x, (FAR char *)buf, c == 'x' ? 16 : 10) -
+                  (FAR char *)buf;
+
+              while (c)
+                {
+                  putc(buf[--c], stream);
+                }
+
+              continue;
+            }
+        }
+#endif
+
       flags = 0;
       width = 0;
       prec  = 0;
@@ -1225,6 +1325,13 @@ tail:
 
 ret:
 
+#if CONFIG_LIBC_PRINTF_BUFSIZE > 0
+  if (stream != NULL && outlen > 0)
+    {
+      vsprintf_flush(stream, outbuf, outlen);
+    }
+#endif
+
   return total_len;
 }
 
@@ -38,6 +38,7 @@
  ****************************************************************************/
 
 #include <assert.h>
+#include <string.h>
 
 #include "libc.h"
 
@@ -68,6 +69,32 @@ static void memoutstream_putc(FAR struct lib_outstream_s *this, int ch)
     }
 }
 
+/****************************************************************************
+ * Name: memoutstream_puts
+ ****************************************************************************/
+
+static void memoutstream_puts(FAR struct lib_outstream_s *this,
+                              FAR const char *buffer, size_t buflen)
+{
+  FAR struct lib_memoutstream_s *mthis =
+    (FAR struct lib_memoutstream_s *)this;
+  size_t remaining;
+
+  DEBUGASSERT(this);
+
+  /* Copy as much as fits; the rest is discarded just as by putc */
+
+  remaining = mthis->buflen - this->nput;
+  if (buflen > remaining)
+    {
+      buflen = remaining;
+    }
+
+  memcpy(&mthis->buffer[this->nput], buffer, buflen);
+  this->nput += buflen;
+  mthis->buffer[this->nput] = '\0';
+}
+
 /****************************************************************************
  * Public Functions
  ****************************************************************************/
@@ -93,6 +120,7 @@ void lib_memoutstream(FAR struct lib_memoutstream_s *outstream,
                       FAR char *bufstart, int buflen)
 {
   outstream->public.put   = memoutstream_putc;
+  outstream->public.puts  = memoutstream_puts;
   outstream->public.flush = lib_noflush;
   outstream->public.nput  = 0;          /* Will be buffer index */
   outstream->buffer       = bufstart;   /* Start of buffer */
@@ -53,6 +53,13 @@ static void nulloutstream_putc(FAR struct lib_outstream_s *this, int ch)
   this->nput++;
 }
 
+static void nulloutstream_puts(FAR struct lib_outstream_s *this,
+                               FAR const char *buffer, size_t buflen)
+{
+  DEBUGASSERT(this);
+  this->nput += buflen;
+}
+
 /****************************************************************************
  * Public Functions
  ****************************************************************************/
@@ -76,6 +83,7 @@ static void nulloutstream_putc(FAR struct lib_outstream_s *this, int ch)
 void lib_nulloutstream(FAR struct lib_outstream_s *nulloutstream)
 {
   nulloutstream->put   = nulloutstream_putc;
+  nulloutstream->puts  = nulloutstream_puts;
   nulloutstream->flush = lib_noflush;
   nulloutstream->nput  = 0;
 }
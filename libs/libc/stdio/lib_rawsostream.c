@@ -88,6 +88,42 @@ static void rawoutstream_putc(FAR struct lib_outstream_s *this, int ch)
   while (errcode == EINTR);
 }
 
+/****************************************************************************
+ * Name: rawoutstream_puts
+ ****************************************************************************/
+
+static void rawoutstream_puts(FAR struct lib_outstream_s *this,
+                              FAR const char *buffer, size_t buflen)
+{
+  FAR struct lib_rawoutstream_s *rthis =
+    (FAR struct lib_rawoutstream_s *)this;
+  ssize_t nwritten;
+  int errcode;
+
+  DEBUGASSERT(this && rthis->fd >= 0);
+
+  /* Write the whole block, resuming after partial writes and EINTR */
+
+  while (buflen > 0)
+    {
+      nwritten = _NX_WRITE(rthis->fd, buffer, buflen);
+      if (nwritten > 0)
+        {
+          this->nput += nwritten;
+          buffer     += nwritten;
+          buflen     -= nwritten;
+        }
+      else
+        {
+          errcode = _NX_GETERRNO(nwritten);
+          if (nwritten == 0 || errcode != EINTR)
+            {
+              break;
+            }
+        }
+    }
+}
+
 /****************************************************************************
  * Public Functions
  ****************************************************************************/
@@ -112,6 +148,7 @@ static void rawoutstream_putc(FAR struct lib_outstream_s *this, int ch)
 void lib_rawoutstream(FAR struct lib_rawoutstream_s *outstream, int fd)
 {
   outstream->public.put   = rawoutstream_putc;
+  outstream->public.puts  = rawoutstream_puts;
   outstream->public.flush = lib_noflush;
   outstream->public.nput  = 0;
   outstream->fd           = fd;
@@ -171,7 +171,8 @@ int setvbuf(FAR FILE *stream, FAR char *buffer, int mode, size_t size)
    * successful.
    */
 
-  flags = stream->fs_flags & ~(__FS_FLAG_LBF | __FS_FLAG_UBF);
+  flags = stream->fs_flags & ~(__FS_FLAG_LBF | __FS_FLAG_UBF |
+                               __FS_FLAG_LAZY);
 
   /* Allocate a new buffer if one is needed or reuse the existing buffer it
    * is appropriate to do so.
@@ -38,6 +38,7 @@
  ****************************************************************************/
 
 #include <fcntl.h>
+#include <string.h>
 #include <assert.h>
 #include <errno.h>
 
@@ -78,6 +79,42 @@ static void stdoutstream_putc(FAR struct lib_outstream_s *this, int ch)
   while (get_errno() == EINTR);
 }
 
+/****************************************************************************
+ * Name: stdoutstream_puts
+ ****************************************************************************/
+
+static void stdoutstream_puts(FAR struct lib_outstream_s *this,
+                              FAR const char *buffer, size_t buflen)
+{
+  FAR struct lib_stdoutstream_s *sthis =
+    (FAR struct lib_stdoutstream_s *)this;
+  ssize_t result;
+
+  DEBUGASSERT(this && sthis->stream);
+
+  /* Write the block with one lib_fwrite() and apply the newline flush of
+   * fputc() once for the whole block.
+   */
+
+  do
+    {
+      result = lib_fwrite(buffer, buflen, sthis->stream);
+      if (result >= 0)
+        {
+          this->nput += result;
+
+          if ((sthis->stream->fs_flags & __FS_FLAG_LBF) != 0 &&
+              memchr(buffer, '\n', result) != NULL)
+            {
+              lib_fflush(sthis->stream, true);
+            }
+
+          return;
+        }
+    }
+  while (get_errno() == EINTR);
+}
+
 /****************************************************************************
  * Name: stdoutstream_flush
  ****************************************************************************/
@@ -118,7 +155,8 @@ void lib_stdoutstream(FAR struct lib_stdoutstream_s *outstream,
 {
   /* Select the put operation */
 
-  outstream->public.put = stdoutstream_putc;
+  outstream->public.put  = stdoutstream_putc;
+  outstream->public.puts = stdoutstream_puts;
 
   /* Select the correct flush operation.  This flush is only called when
    * a newline is encountered in the output stream.  However, we do not
@@ -128,6 +166,7 @@ void lib_stdoutstream(FAR struct lib_stdoutstream_s *outstream,
    */
 
 #ifndef CONFIG_STDIO_DISABLE_BUFFERING
+  lib_lazybuffer(stream);
   if (stream->fs_bufstart != NULL && (stream->fs_oflags & O_BINARY) == 0)
     {
       outstream->public.flush = stdoutstream_flush;
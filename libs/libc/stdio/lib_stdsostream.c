@@ -141,6 +141,7 @@ void lib_stdsostream(FAR struct lib_stdsostream_s *outstream,
    */
 
 #ifndef CONFIG_STDIO_DISABLE_BUFFERING
+  lib_lazybuffer(stream);
   if (stream->fs_bufstart != NULL && (stream->fs_oflags & O_BINARY) == 0)
     {
       outstream->public.flush = stdsostream_flush;
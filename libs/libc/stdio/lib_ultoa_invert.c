@@ -37,8 +37,89 @@
  * Included Files
  ****************************************************************************/
 
+#include <limits.h>
+
 #include "lib_ultoa_invert.h"
 
+/****************************************************************************
+ * Private Data
+ ****************************************************************************/
+
+#ifdef CONFIG_LIBC_PRINTF_OPTSPEED
+/* The decimal digit pairs "00" to "99" */
+
+static const char g_digitpairs[201] =
+{
+  "00010203040506070809"
+  "10111213141516171819"
+  "20212223242526272829"
+  "30313233343536373839"
+  "40414243444546474849"
+  "50515253545556575859"
+  "60616263646566676869"
+  "70717273747576777879"
+  "80818283848586878889"
+  "90919293949596979899"
+};
+#endif
+
+/****************************************************************************
+ * Private Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: ultoa_invert_dec
+ *
+ * Description:
+ *   Convert to decimal, least significant digit first, taking two digits
+ *   per division.  Values that fit in an unsigned long are converted with
+ *   native width divisions even when long long support is enabled.
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_LIBC_PRINTF_OPTSPEED
+#ifdef CONFIG_LIBC_LONG_LONG
+static FAR char *ultoa_invert_dec(unsigned long long val, FAR char *str)
+#else
+static FAR char *ultoa_invert_dec(unsigned long val, FAR char *str)
+#endif
+{
+  unsigned long lval;
+  unsigned int v;
+
+#ifdef CONFIG_LIBC_LONG_LONG
+  while (val > ULONG_MAX)
+    {
+      v      = val % 100;
+      val    = val / 100;
+      *str++ = g_digitpairs[2 * v + 1];
+      *str++ = g_digitpairs[2 * v];
+    }
+#endif
+
+  lval = (unsigned long)val;
+  while (lval >= 100)
+    {
+      v      = lval % 100;
+      lval   = lval / 100;
+      *str++ = g_digitpairs[2 * v + 1];
+      *str++ = g_digitpairs[2 * v];
+    }
+
+  if (lval >= 10)
+    {
+      *str++ = g_digitpairs[2 * lval + 1];
+      *str++ = g_digitpairs[2 * lval];
+    }
+  else
+    {
+      *str++ = '0' + lval;
+    }
+
+  return str;
+}
+#endif
+
 /****************************************************************************
  * Public Functions
  ****************************************************************************/
@@ -56,6 +137,32 @@ FAR char *__ultoa_invert(unsigned long val, FAR char *str, int base)
       upper = 1;
       base &= ~XTOA_UPPER;
     }
+
+#ifdef CONFIG_LIBC_PRINTF_OPTSPEED
+  if (base == 10)
+    {
+      return ultoa_invert_dec(val, str);
+    }
+
+  /* Octal and hexadecimal need only shifts and masks */
+
+  if (base == 8 || base == 16)
+    {
+      FAR const char *digits = upper ? "0123456789ABCDEF" :
+                                       "0123456789abcdef";
+      int shift = base == 16 ? 4 : 3;
+
+      do
+        {
+          *str++ = digits[val & (base - 1)];
+          val  >>= shift;
+        }
+      while (val);
+
+      return str;
+    }
+#endif
+
   do
     {
       int v;
@@ -47,251 +47,432 @@
 #include <nuttx/config.h>
 
 #include <sys/types.h>
+#include <stdint.h>
 #include <stdlib.h>
 
 /****************************************************************************
  * Pre-processor Definitions
  ****************************************************************************/
 
-#define min(a, b)  (a) < (b) ? a : b
-
-#define swapcode(TYPE, parmi, parmj, n) \
-  { \
-    long i = (n) / sizeof (TYPE); \
-    register TYPE *pi = (TYPE *)(parmi); \
-    register TYPE *pj = (TYPE *)(parmj); \
-    do { \
-      register TYPE  t = *pi; \
-      *pi++ = *pj; \
-      *pj++ = t; \
-    } while (--i > 0); \
-  }
-
-#define SWAPINIT(a, width) \
-  swaptype = ((FAR char *)a - (FAR char *)0) % sizeof(long) || \
-  width % sizeof(long) ? 2 : width == sizeof(long)? 0 : 1;
-
-#define swap(a, b) \
-  if (swaptype == 0) \
-    { \
-      long t = *(long *)(a); \
-      *(long *)(a) = *(long *)(b); \
-      *(long *)(b) = t; \
-    } \
-  else \
-    { \
-      swapfunc(a, b, width, swaptype); \
-    }
+/* Partitions of this many elements or fewer are finished by insertion
+ * sort.
+ */
+
+#define QSORT_INSERTION_MAX 12
+
+/* Above this many elements the pivot is the median of three medians */
+
+#define QSORT_NINTHER_MIN   40
 
-#define vecswap(a, b, n) if ((n) > 0) swapfunc(a, b, n, swaptype)
+/* How elements are exchanged */
+
+#define SWAP_WORD           0  /* One aligned 32-bit word */
+#define SWAP_DWORD          1  /* One aligned 64-bit value */
+#define SWAP_WORDS          2  /* Several aligned 32-bit words */
+#define SWAP_BYTES          3  /* Anything else */
 
 /****************************************************************************
- * Private Function Prototypes
+ * Private Types
  ****************************************************************************/
 
-static inline void swapfunc(FAR char *a, FAR char *b, int n, int swaptype);
-static inline FAR char *med3(FAR char *a, FAR char *b, FAR char *c,
-                             CODE int (*compar)(FAR const void *,
-                             FAR const void *));
+/* The invariant state of one sort */
+
+struct qsort_s
+{
+  size_t width;
+  int swaptype;
+  CODE int (*compar)(FAR const void *, FAR const void *);
+  CODE int (*compar_r)(FAR const void *, FAR const void *, FAR void *);
+  FAR void *arg;
+};
 
 /****************************************************************************
  * Private Functions
  ****************************************************************************/
 
-static inline void swapfunc(FAR char *a, FAR char *b, int n, int swaptype)
+/****************************************************************************
+ * Name: qsort_cmp
+ ****************************************************************************/
+
+static inline int qsort_cmp(FAR const struct qsort_s *qs, FAR const char *a,
+                            FAR const char *b)
 {
-  if (swaptype <= 1)
+  if (qs->compar_r != NULL)
     {
-      swapcode(long, a, b, n)
+      return qs->compar_r(a, b, qs->arg);
     }
-  else
+
+  return qs->compar(a, b);
+}
+
+/****************************************************************************
+ * Name: qsort_swap
+ ****************************************************************************/
+
+static inline void qsort_swap(FAR const struct qsort_s *qs, FAR char *a,
+                              FAR char *b)
+{
+  size_t n;
+
+  switch (qs->swaptype)
     {
-      swapcode(char, a, b, n)
+      case SWAP_WORD:
+        {
+          uint32_t t = *(FAR uint32_t *)a;
+          *(FAR uint32_t *)a = *(FAR uint32_t *)b;
+          *(FAR uint32_t *)b = t;
+        }
+        break;
+
+      case SWAP_DWORD:
+        {
+          uint64_t t = *(FAR uint64_t *)a;
+          *(FAR uint64_t *)a = *(FAR uint64_t *)b;
+          *(FAR uint64_t *)b = t;
+        }
+        break;
+
+      case SWAP_WORDS:
+        {
+          FAR uint32_t *pa = (FAR uint32_t *)a;
+          FAR uint32_t *pb = (FAR uint32_t *)b;
+
+          for (n = qs->width / sizeof(uint32_t); n > 0; n--)
+            {
+              uint32_t t = *pa;
+              *pa++ = *pb;
+              *pb++ = t;
+            }
+        }
+        break;
+
+      default:
+        for (n = qs->width; n > 0; n--)
+          {
+            char t = *a;
+            *a++ = *b;
+            *b++ = t;
+          }
+        break;
     }
 }
 
-static inline FAR char *med3(FAR char *a, FAR char *b, FAR char *c,
-                             CODE int (*compar)(FAR const void *,
-                             FAR const void *))
+/****************************************************************************
+ * Name: med3
+ ****************************************************************************/
+
+static inline FAR char *med3(FAR const struct qsort_s *qs, FAR char *a,
+                             FAR char *b, FAR char *c)
 {
-  return compar(a, b) < 0 ?
-         (compar(b, c) < 0 ? b : (compar(a, c) < 0 ? c : a)) :
-         (compar(b, c) > 0 ? b : (compar(a, c) < 0 ? a : c));
+  return qsort_cmp(qs, a, b) < 0 ?
+         (qsort_cmp(qs, b, c) < 0 ? b : (qsort_cmp(qs, a, c) < 0 ? c : a)) :
+         (qsort_cmp(qs, b, c) > 0 ? b : (qsort_cmp(qs, a, c) < 0 ? a : c));
 }
 
 /****************************************************************************
- * Public Function
+ * Name: insertion_sort
  ****************************************************************************/
 
+static void insertion_sort(FAR const struct qsort_s *qs, FAR char *base,
+                           size_t nel)
+{
+  size_t width = qs->width;
+  FAR char *end = base + nel * width;
+  FAR char *pm;
+  FAR char *pl;
+
+  for (pm = base + width; pm < end; pm += width)
+    {
+      for (pl = pm; pl > base && qsort_cmp(qs, pl - width, pl) > 0;
+           pl -= width)
+        {
+          qsort_swap(qs, pl, pl - width);
+        }
+    }
+}
+
 /****************************************************************************
- * Name: qsort
+ * Name: heap_sort
  *
  * Description:
- *   The qsort() function will sort an array of 'nel' objects, the initial
- *   element of which is pointed to by 'base'. The size of each object, in
- *   bytes, is specified by the 'width" argument. If the 'nel' argument has
- *   the value zero, the comparison function pointed to by 'compar' will not
- *   be called and no rearrangement will take place.
+ *   Sort a partition that quicksort failed to split evenly.  This bounds
+ *   the worst case at O(n log n).
  *
- *   The application will ensure that the comparison function pointed to by
- *   'compar' does not alter the contents of the array. The implementation
- *   may reorder elements of the array between calls to the comparison
- *   function, but will not alter the contents of any individual element.
- *
- *   When the same objects (consisting of 'width" bytes, irrespective of
- *   their current positions in the array) are passed more than once to
- *   the comparison function, the results will be consistent with one
- *   another. That is, they will define a total ordering on the array.
- *
- *   The contents of the array will be sorted in ascending order according
- *   to a comparison function. The 'compar' argument is a pointer to the
- *   comparison function, which is called with two arguments that point to
- *   the elements being compared. The application will ensure that the
- *   function returns an integer less than, equal to, or greater than 0,
- *   if the first argument is considered respectively less than, equal to,
- *   or greater than the second. If two members compare as equal, their
- *   order in the sorted array is unspecified.
- *
- *   (Based on description from OpenGroup.org).
- *
- * Returned Value:
- *   The qsort() function will not return a value.
+ ****************************************************************************/
+
+static void heap_sort(FAR const struct qsort_s *qs, FAR char *base,
+                      size_t nel)
+{
+  size_t width = qs->width;
+  size_t start;
+  size_t root;
+  size_t child;
+  size_t end;
+
+  /* Build a max-heap, then repeatedly move the top to the end */
+
+  for (start = nel / 2, end = nel; end > 1; )
+    {
+      if (start > 0)
+        {
+          start--;
+        }
+      else
+        {
+          end--;
+          qsort_swap(qs, base, base + end * width);
+        }
+
+      /* Sift the element at 'start' down into the heap of 'end' elements */
+
+      for (root = start; (child = 2 * root + 1) < end; root = child)
+        {
+          if (child + 1 < end &&
+              qsort_cmp(qs, base + child * width,
+                        base + (child + 1) * width) < 0)
+            {
+              child++;
+            }
+
+          if (qsort_cmp(qs, base + root * width,
+                        base + child * width) >= 0)
+            {
+              break;
+            }
+
+          qsort_swap(qs, base + root * width, base + child * width);
+        }
+    }
+}
+
+/****************************************************************************
+ * Name: intro_sort
  *
- * Notes from the original BSD version:
- *   Qsort routine from Bentley & McIlroy's "Engineering a Sort Function".
+ * Description:
+ *   Quicksort with a median-of-three (or ninther) pivot and a Hoare
+ *   partition, which splits runs of equal elements evenly.  The smaller
+ *   side is sorted recursively and the larger one iteratively, so the
+ *   stack depth is O(log n).  Once 'depth' splits have been made the
+ *   partition is passed to heap sort, and small partitions are finished by
+ *   insertion sort.
  *
  ****************************************************************************/
 
-void qsort(FAR void *base, size_t nel, size_t width,
-           CODE int(*compar)(FAR const void *, FAR const void *))
+static void intro_sort(FAR const struct qsort_s *qs, FAR char *base,
+                       size_t nel, int depth)
 {
-  FAR char *pa;
-  FAR char *pb;
-  FAR char *pc;
-  FAR char *pd;
+  size_t width = qs->width;
   FAR char *pl;
   FAR char *pm;
   FAR char *pn;
-  int swaptype;
-  int swap_cnt;
-  int d;
-  int r;
-
-loop:
-  SWAPINIT(base, width);
-  swap_cnt = 0;
+  FAR char *pi;
+  FAR char *pj;
+  size_t nleft;
+  size_t nright;
+  size_t d;
 
-  if (nel < 7)
+  while (nel > QSORT_INSERTION_MAX)
     {
-      for (pm = (FAR char *)base + width;
-           pm < (FAR char *)base + nel * width;
-           pm += width)
+      if (depth-- <= 0)
         {
-          for (pl = pm;
-               pl > (FAR char *)base && compar(pl - width, pl) > 0;
-               pl -= width)
-            {
-              swap(pl, pl - width);
-            }
+          heap_sort(qs, base, nel);
+          return;
         }
 
-      return;
-  }
+      /* Select the pivot and move it to the first position */
 
-  pm = (FAR char *)base + (nel / 2) * width;
-  if (nel > 7)
-    {
       pl = base;
-      pn = (FAR char *)base + (nel - 1) * width;
-      if (nel > 40)
+      pm = base + (nel / 2) * width;
+      pn = base + (nel - 1) * width;
+
+      if (nel > QSORT_NINTHER_MIN)
         {
           d  = (nel / 8) * width;
-          pl = med3(pl, pl + d, pl + 2 * d, compar);
-          pm = med3(pm - d, pm, pm + d, compar);
-          pn = med3(pn - 2 * d, pn - d, pn, compar);
+          pl = med3(qs, pl, pl + d, pl + 2 * d);
+          pm = med3(qs, pm - d, pm, pm + d);
+          pn = med3(qs, pn - 2 * d, pn - d, pn);
         }
 
-      pm = med3(pl, pm, pn, compar);
-    }
+      pm = med3(qs, pl, pm, pn);
+      qsort_swap(qs, base, pm);
 
-  swap(base, pm);
-  pa = pb = (FAR char *)base + width;
+      /* Partition the rest around it.  Both scans stop on elements equal
+       * to the pivot.
+       */
 
-  pc = pd = (FAR char *)base + (nel - 1) * width;
-  for (; ; )
-    {
-      while (pb <= pc && (r = compar(pb, base)) <= 0)
+      pi = base + width;
+      pj = base + (nel - 1) * width;
+
+      for (; ; )
         {
-          if (r == 0)
+          while (pi <= pj && qsort_cmp(qs, pi, base) < 0)
             {
-              swap_cnt = 1;
-              swap(pa, pb);
-              pa += width;
+              pi += width;
             }
 
-          pb += width;
-        }
+          while (pi <= pj && qsort_cmp(qs, pj, base) > 0)
+            {
+              pj -= width;
+            }
 
-      while (pb <= pc && (r = compar(pc, base)) >= 0)
-        {
-          if (r == 0)
+          if (pi >= pj)
             {
-              swap_cnt = 1;
-              swap(pc, pd);
-              pd -= width;
+              break;
             }
 
-          pc -= width;
+          qsort_swap(qs, pi, pj);
+          pi += width;
+          pj -= width;
         }
 
-      if (pb > pc)
-        {
-          break;
-        }
+      /* Put the pivot between the two partitions */
 
-      swap(pb, pc);
-      swap_cnt = 1;
-      pb      += width;
-      pc      -= width;
-    }
+      qsort_swap(qs, base, pj);
 
-  if (swap_cnt == 0)
-    {
-      /* Switch to insertion sort */
+      nleft  = (pj - base) / width;
+      nright = nel - nleft - 1;
 
-      for (pm = (FAR char *)base + width;
-           pm < (FAR char *)base + nel * width;
-           pm += width)
+      if (nleft < nright)
         {
-          for (pl = pm;
-               pl > (FAR char *)base && compar(pl - width, pl) > 0;
-               pl -= width)
-            {
-              swap(pl, pl - width);
-            }
+          intro_sort(qs, base, nleft, depth);
+          base = pj + width;
+          nel  = nright;
+        }
+      else
+        {
+          intro_sort(qs, pj + width, nright, depth);
+          nel  = nleft;
         }
-
-      return;
     }
 
-  pn = (FAR char *)base + nel * width;
-  r  = min(pa - (FAR char *)base, pb - pa);
-  vecswap(base, pb - r, r);
+  insertion_sort(qs, base, nel);
+}
 
-  r  = min(pd - pc, pn - pd - width);
-  vecswap(pb, pn - r, r);
+/****************************************************************************
+ * Name: qsort_internal
+ ****************************************************************************/
+
+static void qsort_internal(FAR struct qsort_s *qs, FAR void *base,
+                           size_t nel)
+{
+  int depth;
+  size_t n;
 
-  if ((r = pb - pa) > width)
+  if (nel < 2 || qs->width == 0)
     {
-      qsort(base, r / width, width, compar);
+      return;
     }
 
-  if ((r = pd - pc) > width)
+  /* Choose the cheapest way to exchange two elements */
+
+  if (((uintptr_t)base | qs->width) % sizeof(uint32_t) != 0)
+    {
+      qs->swaptype = SWAP_BYTES;
+    }
+  else if (qs->width == sizeof(uint32_t))
     {
-      /* Iterate rather than recurse to save stack space */
+      qs->swaptype = SWAP_WORD;
+    }
+  else if (qs->width == sizeof(uint64_t) &&
+           ((uintptr_t)base % sizeof(uint64_t)) == 0)
+    {
+      qs->swaptype = SWAP_DWORD;
+    }
+  else
+    {
+      qs->swaptype = SWAP_WORDS;
+    }
 
-      base = pn - r;
-      nel = r / width;
-      goto loop;
+  /* Allow 2 * log2(nel) partitioning steps before falling back to heap
+   * sort.
+   */
+
+  for (depth = 0, n = nel; n > 1; n >>= 1)
+    {
+      depth += 2;
     }
+
+  intro_sort(qs, base, nel, depth);
+}
+
+/****************************************************************************
+ * Public Function
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: qsort
+ *
+ * Description:
+ *   The qsort() function will sort an array of 'nel' objects, the initial
+ *   element of which is pointed to by 'base'. The size of each object, in
+ *   bytes, is specified by the 'width" argument. If the 'nel' argument has
+ *   the value zero, the comparison function pointed to by 'compar' will not
+ *   be called and no rearrangement will take place.
+ *
+ *   The application will ensure that the comparison function pointed to by
+ *   'compar' does not alter the contents of the array. The implementation
+ *   may reorder elements of the array between calls to the comparison
+ *   function, but will not alter the contents of any individual element.
+ *
+ *   When the same objects (consisting of 'width" bytes, irrespective of
+ *   their current positions in the array) are passed more than once to
+ *   the comparison function, the results will be consistent with one
+ *   another. That is, they will define a total ordering on the array.
+ *
+ *   The contents of the array will be sorted in ascending order according
+ *   to a comparison function. The 'compar' argument is a pointer to the
+ *   comparison function, which is called with two arguments that point to
+ *   the elements being compared. The application will ensure that the
+ *   function returns an integer less than, equal to, or greater than 0,
+ *   if the first argument is considered respectively less than, equal to,
+ *   or greater than the second. If two members compare as equal, their
+ *   order in the sorted array is unspecified.
+ *
+ *   (Based on description from OpenGroup.org).
+ *
+ * Returned Value:
+ *   The qsort() function will not return a value.
+ *
+ * Notes:
+ *   This is an introsort: quicksort as in Bentley & McIlroy's "Engineering
+ *   a Sort Function", falling back to heap sort when partitioning goes
+ *   badly, so the worst case is O(n log n).
+ *
+ ****************************************************************************/
+
+void qsort(FAR void *base, size_t nel, size_t width,
+           CODE int(*compar)(FAR const void *, FAR const void *))
+{
+  struct qsort_s qs;
+
+  qs.width    = width;
+  qs.compar   = compar;
+  qs.compar_r = NULL;
+  qs.arg      = NULL;
+
+  qsort_internal(&qs, base, nel);
+}
+
+/****************************************************************************
+ * Name: qsort_r
+ *
+ * Description:
+ *   Like qsort(), except that 'arg' is passed to 'compar' as its third
+ *   argument.  This follows the GNU C library form of qsort_r().
+ *
+ ****************************************************************************/
+
+void qsort_r(FAR void *base, size_t nel, size_t width,
+             CODE int (*compar)(FAR const void *, FAR const void *,
+                                FAR void *),
+             FAR void *arg)
+{
+  struct qsort_s qs;
+
+  qs.width    = width;
+  qs.compar   = NULL;
+  qs.compar_r = compar;
+  qs.arg      = arg;
+
+  qsort_internal(&qs, base, nel);
 }
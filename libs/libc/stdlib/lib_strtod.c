@@ -40,6 +40,7 @@
 #include <nuttx/config.h>
 #include <nuttx/compiler.h>
 
+#include <stdint.h>
 #include <stdlib.h>
 #include <ctype.h>
 #include <errno.h>
@@ -65,6 +66,27 @@
 #  define __DBL_MAX_EXP__ (1024)
 #endif
 
+/* Mantissas up to this value and powers of ten up to g_pow10[] are exact
+ * in a double, so their product or quotient is correctly rounded.
+ */
+
+#define EXACT_MANT_MAX  ((uint64_t)1 << 53)
+#define EXACT_EXP_MAX   22
+
+/* Digits beyond what fits in the 64-bit mantissa only adjust the exponent */
+
+#define MANT_DIGIT_MAX  ((UINT64_MAX - 9) / 10)
+
+/****************************************************************************
+ * Private Data
+ ****************************************************************************/
+
+static const double g_pow10[EXACT_EXP_MAX + 1] =
+{
+  1e0, 1e1, 1e2, 1e3, 1e4, 1e5, 1e6, 1e7, 1e8, 1e9, 1e10, 1e11, 1e12, 1e13,
+  1e14, 1e15, 1e16, 1e17, 1e18, 1e19, 1e20, 1e21, 1e22
+};
+
 /****************************************************************************
  * Private Functions
  ****************************************************************************/
@@ -90,6 +112,7 @@ static inline int is_real(double x)
 double strtod(FAR const char *str, FAR char **endptr)
 {
   double number;
+  uint64_t mant;
   int exponent;
   int negative;
   FAR char *p = (FAR char *) str;
@@ -121,16 +144,28 @@ double strtod(FAR const char *str, FAR char **endptr)
       break;
     }
 
-  number       = 0.;
+  mant         = 0;
   exponent     = 0;
   num_digits   = 0;
   num_decimals = 0;
 
   /* Process string of digits */
 
+  /* Accumulate the significant digits in an integer so that no rounding
+   * happens before the final scaling.
+   */
+
   while (isdigit(*p))
     {
-      number = number * 10. + (*p - '0');
+      if (mant <= MANT_DIGIT_MAX)
+        {
+          mant = mant * 10 + (*p - '0');
+        }
+      else
+        {
+          exponent++;
+        }
+
       p++;
       num_digits++;
     }
@@ -143,10 +178,14 @@ double strtod(FAR const char *str, FAR char **endptr)
 
       while (isdigit(*p))
         {
-          number = number * 10. + (*p - '0');
+          if (mant <= MANT_DIGIT_MAX)
+            {
+              mant = mant * 10 + (*p - '0');
+              num_decimals++;
+            }
+
           p++;
           num_digits++;
-          num_decimals++;
         }
 
       exponent -= num_decimals;
@@ -159,6 +198,8 @@ double strtod(FAR const char *str, FAR char **endptr)
       goto errout;
     }
 
+  number = (double)mant;
+
   /* Correct for sign */
 
   if (negative)
@@ -212,7 +253,27 @@ double strtod(FAR const char *str, FAR char **endptr)
       goto errout;
     }
 
-  /* Scale the result */
+  /* When both the mantissa and the power of ten are exact, a single
+   * multiplication or division gives the correctly rounded result.
+   */
+
+  if (mant <= EXACT_MANT_MAX &&
+      exponent >= -EXACT_EXP_MAX && exponent <= EXACT_EXP_MAX)
+    {
+      if (exponent < 0)
+        {
+          n       = -exponent;
+          number /= g_pow10[n];
+        }
+      else
+        {
+          number *= g_pow10[exponent];
+        }
+
+      goto errout;
+    }
+
+  /* Otherwise scale the result by squaring powers of ten */
 
   p10 = 10.;
   n = exponent;
@@ -44,6 +44,7 @@
 #include <nuttx/config.h>
 #include <nuttx/compiler.h>
 
+#include <stdint.h>
 #include <stdlib.h>
 #include <ctype.h>
 #include <errno.h>
@@ -67,6 +68,27 @@
 #  define __FLT_MAX_EXP__ (128)
 #endif
 
+/* Mantissas up to this value and powers of ten up to g_pow10[] are exact
+ * in a float, so their product or quotient is correctly rounded.  This
+ * keeps the common short inputs on the single precision FPU.
+ */
+
+#define EXACT_MANT_MAX  ((uint64_t)1 << 24)
+#define EXACT_EXP_MAX   10
+
+/* Digits beyond what fits in the 64-bit mantissa only adjust the exponent */
+
+#define MANT_DIGIT_MAX  ((UINT64_MAX - 9) / 10)
+
+/****************************************************************************
+ * Private Data
+ ****************************************************************************/
+
+static const float g_pow10[EXACT_EXP_MAX + 1] =
+{
+  1e0f, 1e1f, 1e2f, 1e3f, 1e4f, 1e5f, 1e6f, 1e7f, 1e8f, 1e9f, 1e10f
+};
+
 /****************************************************************************
  * Private Functions
  ****************************************************************************/
@@ -92,6 +114,7 @@ static inline int is_real(float x)
 float strtof(FAR const char *str, FAR char **endptr)
 {
   float number;
+  uint64_t mant;
   int exponent;
   int negative;
   FAR char *p = (FAR char *) str;
@@ -123,16 +146,28 @@ float strtof(FAR const char *str, FAR char **endptr)
       break;
     }
 
-  number       = 0.0F;
+  mant         = 0;
   exponent     = 0;
   num_digits   = 0;
   num_decimals = 0;
 
   /* Process string of digits */
 
+  /* Accumulate the significant digits in an integer so that no rounding
+   * happens before the final scaling.
+   */
+
   while (isdigit(*p))
     {
-      number = number * 10.0F + (float)(*p - '0');
+      if (mant <= MANT_DIGIT_MAX)
+        {
+          mant = mant * 10 + (*p - '0');
+        }
+      else
+        {
+          exponent++;
+        }
+
       p++;
       num_digits++;
     }
@@ -145,10 +180,14 @@ float strtof(FAR const char *str, FAR char **endptr)
 
       while (isdigit(*p))
         {
-          number = number * 10.0F + (float)(*p - '0');
+          if (mant <= MANT_DIGIT_MAX)
+            {
+              mant = mant * 10 + (*p - '0');
+              num_decimals++;
+            }
+
           p++;
           num_digits++;
-          num_decimals++;
         }
 
       exponent -= num_decimals;
@@ -161,6 +200,8 @@ float strtof(FAR const char *str, FAR char **endptr)
       goto errout;
     }
 
+  number = (float)mant;
+
   /* Correct for sign */
 
   if (negative)
@@ -214,7 +255,27 @@ float strtof(FAR const char *str, FAR char **endptr)
       goto errout;
     }
 
-  /* Scale the result */
+  /* When both the mantissa and the power of ten are exact, a single
+   * multiplication or division gives the correctly rounded result.
+   */
+
+  if (mant <= EXACT_MANT_MAX &&
+      exponent >= -EXACT_EXP_MAX && exponent <= EXACT_EXP_MAX)
+    {
+      if (exponent < 0)
+        {
+          n       = -exponent;
+          number /= g_pow10[n];
+        }
+      else
+        {
+          number *= g_pow10[exponent];
+        }
+
+      goto errout;
+    }
+
+  /* Otherwise scale the result by squaring powers of ten */
 
   p10 = 10.0F;
   n = exponent;
@@ -39,6 +39,7 @@
 
 #include <nuttx/config.h>
 #include <sys/types.h>
+#include <stdint.h>
 #include <string.h>
 
 /****************************************************************************
@@ -51,6 +52,37 @@ int memcmp(FAR const void *s1, FAR const void *s2, size_t n)
   unsigned char *p1 = (unsigned char *)s1;
   unsigned char *p2 = (unsigned char *)s2;
 
+#ifdef CONFIG_MEMCMP_OPTSPEED
+  /* If both buffers have the same word alignment, skip over the equal
+   * words.  The first differing word, if any, is then compared by bytes
+   * below so that the result follows the byte order.
+   */
+
+  if (n >= 2 * sizeof(uint32_t) &&
+      (((uintptr_t)p1 ^ (uintptr_t)p2) & (sizeof(uint32_t) - 1)) == 0)
+    {
+      while (((uintptr_t)p1 & (sizeof(uint32_t) - 1)) != 0)
+        {
+          if (*p1 != *p2)
+            {
+              return *p1 < *p2 ? -1 : 1;
+            }
+
+          p1++;
+          p2++;
+          n--;
+        }
+
+      while (n >= sizeof(uint32_t) &&
+             *(FAR const uint32_t *)p1 == *(FAR const uint32_t *)p2)
+        {
+          p1 += sizeof(uint32_t);
+          p2 += sizeof(uint32_t);
+          n  -= sizeof(uint32_t);
+        }
+    }
+#endif
+
   while (n-- > 0)
     {
       if (*p1 < *p2)
@@ -39,6 +39,7 @@
 
 #include <nuttx/config.h>
 #include <sys/types.h>
+#include <stdint.h>
 #include <string.h>
 
 /****************************************************************************
@@ -54,6 +55,49 @@ FAR void *memcpy(FAR void *dest, FAR const void *src, size_t n)
 {
   FAR unsigned char *pout = (FAR unsigned char *)dest;
   FAR unsigned char *pin  = (FAR unsigned char *)src;
+
+#ifdef CONFIG_MEMCPY_OPTSPEED
+  /* If the source and the destination have the same word alignment, copy
+   * the bulk of the data a word at a time, four words per iteration.
+   */
+
+  if (n >= 2 * sizeof(uint32_t) &&
+      (((uintptr_t)pout ^ (uintptr_t)pin) & (sizeof(uint32_t) - 1)) == 0)
+    {
+      FAR uint32_t *wout;
+      FAR const uint32_t *win;
+
+      while (((uintptr_t)pout & (sizeof(uint32_t) - 1)) != 0)
+        {
+          *pout++ = *pin++;
+          n--;
+        }
+
+      wout = (FAR uint32_t *)pout;
+      win  = (FAR const uint32_t *)pin;
+
+      while (n >= 4 * sizeof(uint32_t))
+        {
+          wout[0] = win[0];
+          wout[1] = win[1];
+          wout[2] = win[2];
+          wout[3] = win[3];
+          wout   += 4;
+          win    += 4;
+          n      -= 4 * sizeof(uint32_t);
+        }
+
+      while (n >= sizeof(uint32_t))
+        {
+          *wout++ = *win++;
+          n      -= sizeof(uint32_t);
+        }
+
+      pout = (FAR unsigned char *)wout;
+      pin  = (FAR unsigned char *)win;
+    }
+#endif
+
   while (n-- > 0) *pout++ = *pin++;
   return dest;
 }
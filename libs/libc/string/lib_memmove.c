@@ -39,8 +39,18 @@
 
 #include <nuttx/config.h>
 #include <sys/types.h>
+#include <stdint.h>
 #include <string.h>
 
+/****************************************************************************
+ * Pre-processor Definitions
+ ****************************************************************************/
+
+/* True if both pointers have the same word alignment */
+
+#define MEMMOVE_COALIGNED(a, b) \
+  ((((uintptr_t)(a) ^ (uintptr_t)(b)) & (sizeof(uint32_t) - 1)) == 0)
+
 /****************************************************************************
  * Public Functions
  ****************************************************************************/
@@ -56,6 +66,29 @@ FAR void *memmove(FAR void *dest, FAR const void *src, size_t count)
       tmp = (FAR char *) dest;
       s   = (FAR char *) src;
 
+#ifdef CONFIG_MEMMOVE_OPTSPEED
+      /* Copy words upward.  Each word is read before it is written, so
+       * this is safe for any overlap with dest below src.
+       */
+
+      if (count >= 2 * sizeof(uint32_t) && MEMMOVE_COALIGNED(tmp, s))
+        {
+          while (((uintptr_t)tmp & (sizeof(uint32_t) - 1)) != 0)
+            {
+              *tmp++ = *s++;
+              count--;
+            }
+
+          while (count >= sizeof(uint32_t))
+            {
+              *(FAR uint32_t *)tmp = *(FAR const uint32_t *)s;
+              tmp   += sizeof(uint32_t);
+              s     += sizeof(uint32_t);
+              count -= sizeof(uint32_t);
+            }
+        }
+#endif
+
       while (count--)
         {
           *tmp++ = *s++;
@@ -66,6 +99,27 @@ FAR void *memmove(FAR void *dest, FAR const void *src, size_t count)
       tmp = (FAR char *) dest + count;
       s   = (FAR char *) src + count;
 
+#ifdef CONFIG_MEMMOVE_OPTSPEED
+      /* Copy words downward from the end */
+
+      if (count >= 2 * sizeof(uint32_t) && MEMMOVE_COALIGNED(tmp, s))
+        {
+          while (((uintptr_t)tmp & (sizeof(uint32_t) - 1)) != 0)
+            {
+              *--tmp = *--s;
+              count--;
+            }
+
+          while (count >= sizeof(uint32_t))
+            {
+              tmp   -= sizeof(uint32_t);
+              s     -= sizeof(uint32_t);
+              count -= sizeof(uint32_t);
+              *(FAR uint32_t *)tmp = *(FAR const uint32_t *)s;
+            }
+        }
+#endif
+
       while (count--)
         {
           *--tmp = *--s;
@@ -107,7 +107,17 @@ FAR void *memset(FAR void *s, int c, size_t n)
             }
 
 #ifndef CONFIG_MEMSET_64BIT
-          /* Loop while there are at least 32-bits left to be written */
+          /* Write four words per iteration, then single words */
+
+          while (n >= 16)
+            {
+              ((FAR uint32_t *)addr)[0] = val32;
+              ((FAR uint32_t *)addr)[1] = val32;
+              ((FAR uint32_t *)addr)[2] = val32;
+              ((FAR uint32_t *)addr)[3] = val32;
+              addr += 16;
+              n    -= 16;
+            }
 
           while (n >= 4)
             {
@@ -39,8 +39,11 @@
 
 #include <nuttx/config.h>
 
+#include <stdint.h>
 #include <string.h>
 
+#include "libc.h"
+
 /****************************************************************************
  * Public Functions
  ****************************************************************************/
@@ -64,6 +67,35 @@ FAR char *strchr(FAR const char *s, int c)
 {
   if (s)
     {
+#ifdef CONFIG_STRING_OPTSPEED
+      uint32_t mask = LIB_BYTEMASK(c);
+      FAR const uint32_t *ws;
+      uint32_t w;
+
+      /* Skip the words that hold neither 'c' nor the NUL.  The byte loop
+       * below then finds which one stopped the scan.
+       */
+
+      for (; LIB_UNALIGNED(s); s++)
+        {
+          if (*s == c || !*s)
+            {
+              return *s == c ? (FAR char *)s : NULL;
+            }
+        }
+
+      for (ws = (FAR const uint32_t *)s; ; ws++)
+        {
+          w = *ws;
+          if (LIB_HASZERO(w) || LIB_HASZERO(w ^ mask))
+            {
+              break;
+            }
+        }
+
+      s = (FAR const char *)ws;
+#endif
+
       for (; ; s++)
         {
           if (*s == c)
@@ -39,8 +39,11 @@
 
 #include <nuttx/config.h>
 
+#include <stdint.h>
 #include <string.h>
 
+#include "libc.h"
+
 /****************************************************************************
  * Public Functions
  ****************************************************************************/
@@ -49,6 +52,37 @@
 int strcmp(FAR const char *cs, FAR const char *ct)
 {
   register signed char result;
+
+#ifdef CONFIG_STRING_OPTSPEED
+  /* With the same alignment, compare a word at a time until the words
+   * differ or hold the terminating NUL.
+   */
+
+  if (LIB_COALIGNED(cs, ct))
+    {
+      while (LIB_UNALIGNED(cs) && *cs == *ct && *cs != '\0')
+        {
+          cs++;
+          ct++;
+        }
+
+      if (!LIB_UNALIGNED(cs))
+        {
+          FAR const uint32_t *w1 = (FAR const uint32_t *)cs;
+          FAR const uint32_t *w2 = (FAR const uint32_t *)ct;
+
+          while (*w1 == *w2 && !LIB_HASZERO(*w1))
+            {
+              w1++;
+              w2++;
+            }
+
+          cs = (FAR const char *)w1;
+          ct = (FAR const char *)w2;
+        }
+    }
+#endif
+
   for (; ; )
     {
       if ((result = *cs - *ct++) != 0 || !*cs++)
@@ -39,8 +39,11 @@
 
 #include <nuttx/config.h>
 
+#include <stdint.h>
 #include <string.h>
 
+#include "libc.h"
+
 /****************************************************************************
  * Public Functions
  ****************************************************************************/
@@ -61,6 +64,38 @@
 FAR char *strcpy(FAR char *dest, FAR const char *src)
 {
   char *tmp = dest;
+
+#ifdef CONFIG_STRING_OPTSPEED
+  /* With the same alignment, copy whole words until the word holding the
+   * NUL, which is then copied a byte at a time below.
+   */
+
+  if (LIB_COALIGNED(dest, src))
+    {
+      FAR uint32_t *wd;
+      FAR const uint32_t *ws;
+
+      for (; LIB_UNALIGNED(src); src++, dest++)
+        {
+          if ((*dest = *src) == '\0')
+            {
+              return tmp;
+            }
+        }
+
+      wd = (FAR uint32_t *)dest;
+      ws = (FAR const uint32_t *)src;
+
+      while (!LIB_HASZERO(*ws))
+        {
+          *wd++ = *ws++;
+        }
+
+      dest = (FAR char *)wd;
+      src  = (FAR const char *)ws;
+    }
+#endif
+
   while ((*dest++ = *src++) != '\0');
   return tmp;
 }
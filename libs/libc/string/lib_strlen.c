@@ -39,8 +39,11 @@
 
 #include <nuttx/config.h>
 #include <sys/types.h>
+#include <stdint.h>
 #include <string.h>
 
+#include "libc.h"
+
 /****************************************************************************
  * Public Functions
  ****************************************************************************/
@@ -48,8 +51,26 @@
 #ifndef CONFIG_LIBC_ARCH_STRLEN
 size_t strlen(const char *s)
 {
-  const char *sc;
-  for (sc = s; *sc != '\0'; ++sc);
+  const char *sc = s;
+
+#ifdef CONFIG_STRING_OPTSPEED
+  FAR const uint32_t *ws;
+
+  /* Reach a word boundary, then skip the words without a NUL */
+
+  for (; LIB_UNALIGNED(sc); ++sc)
+    {
+      if (*sc == '\0')
+        {
+          return sc - s;
+        }
+    }
+
+  for (ws = (FAR const uint32_t *)sc; !LIB_HASZERO(*ws); ws++);
+  sc = (FAR const char *)ws;
+#endif
+
+  for (; *sc != '\0'; ++sc);
   return sc - s;
 }
 #endif
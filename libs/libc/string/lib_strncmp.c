@@ -39,8 +39,11 @@
 
 #include <nuttx/config.h>
 #include <sys/types.h>
+#include <stdint.h>
 #include <string.h>
 
+#include "libc.h"
+
 /****************************************************************************
  * Public Functions
  ****************************************************************************/
@@ -49,6 +52,39 @@
 int strncmp(const char *cs, const char *ct, size_t nb)
 {
   int result = 0;
+
+#ifdef CONFIG_STRING_OPTSPEED
+  /* With the same alignment, compare a word at a time while at least a
+   * word remains and the words are equal and hold no NUL.
+   */
+
+  if (LIB_COALIGNED(cs, ct))
+    {
+      while (nb > 0 && LIB_UNALIGNED(cs) && *cs == *ct && *cs != '\0')
+        {
+          cs++;
+          ct++;
+          nb--;
+        }
+
+      if (!LIB_UNALIGNED(cs))
+        {
+          FAR const uint32_t *w1 = (FAR const uint32_t *)cs;
+          FAR const uint32_t *w2 = (FAR const uint32_t *)ct;
+
+          while (nb >= sizeof(uint32_t) && *w1 == *w2 && !LIB_HASZERO(*w1))
+            {
+              w1++;
+              w2++;
+              nb -= sizeof(uint32_t);
+            }
+
+          cs = (FAR const char *)w1;
+          ct = (FAR const char *)w2;
+        }
+    }
+#endif
+
   for (; nb > 0; nb--)
     {
       if ((result = (int)*cs - (int)*ct++) != 0 || !*cs++)
@@ -0,0 +1,125 @@
+/****************************************************************************
+ * libs/libc/symtab/symtab_findhashedbyname.c
+ *
+ *   Copyright (C) 2020 Gregory Nutt. All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in
+ *    the documentation and/or other materials provided with the
+ *    distribution.
+ * 3. Neither the name NuttX nor the names of its contributors may be
+ *    used to endorse or promote products derived from this software
+ *    without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+ * FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE
+ * COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+ * INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,
+ * BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS
+ * OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED
+ * AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ * LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN
+ * ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ *
+ ****************************************************************************/
+
+/****************************************************************************
+ * Included Files
+ ****************************************************************************/
+
+#include <nuttx/config.h>
+
+#include <stdint.h>
+#include <string.h>
+#include <assert.h>
+
+#include <nuttx/symtab.h>
+
+/****************************************************************************
+ * Public Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: symtab_hashname
+ *
+ * Description:
+ *   Return the 32-bit FNV-1a hash of a symbol name.  tools/mksymtab uses
+ *   the same hash to place the symbols when it generates a hashed table.
+ *
+ ****************************************************************************/
+
+uint32_t symtab_hashname(FAR const char *name)
+{
+  uint32_t hash = 2166136261u;
+
+  while (*name != '\0')
+    {
+      hash ^= (uint8_t)*name++;
+      hash *= 16777619u;
+    }
+
+  return hash;
+}
+
+/****************************************************************************
+ * Name: symtab_findhashedbyname
+ *
+ * Description:
+ *   Find the symbol in the symbol table with the matching name.
+ *   This version assumes that the table was generated by 'mksymtab -h':
+ *   nsyms is a power of two and each symbol is stored at the slot given by
+ *   its name hash, or at the following slots if that one was taken.  Unused
+ *   slots have a NULL name.  Symbols that are configured out have an empty
+ *   name so that the slots of the other symbols do not depend on the
+ *   configuration.
+ *
+ *   The lookup normally costs one hash and one string comparison.
+ *
+ * Returned Value:
+ *   A reference to the symbol table entry if an entry with the matching
+ *   name is found; NULL is returned if the entry is not found.
+ *
+ ****************************************************************************/
+
+FAR const struct symtab_s *
+symtab_findhashedbyname(FAR const struct symtab_s *symtab,
+                        FAR const char *name, int nsyms)
+{
+  uint32_t mask;
+  uint32_t slot;
+  int i;
+
+  DEBUGASSERT(symtab != NULL && name != NULL);
+  DEBUGASSERT((nsyms & (nsyms - 1)) == 0);
+
+  mask = (uint32_t)nsyms - 1;
+  slot = symtab_hashname(name) & mask;
+
+  for (i = 0; i < nsyms; i++)
+    {
+      FAR const struct symtab_s *symbol = &symtab[slot];
+
+      if (symbol->sym_name == NULL)
+        {
+          break;
+        }
+
+      if (strcmp(name, symbol->sym_name) == 0)
+        {
+          return symbol;
+        }
+
+      slot = (slot + 1) & mask;
+    }
+
+  return NULL;
+}
@@ -0,0 +1,146 @@
+/****************************************************************************
+ * libs/libc/time/lib_clock_gettime.c
+ *
+ *   Copyright (C) 2020 Gregory Nutt. All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in
+ *    the documentation and/or other materials provided with the
+ *    distribution.
+ * 3. Neither the name NuttX nor the names of its contributors may be
+ *    used to endorse or promote products derived from this software
+ *    without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+ * FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE
+ * COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+ * INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,
+ * BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS
+ * OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED
+ * AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ * LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN
+ * ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ *
+ ****************************************************************************/
+
+/****************************************************************************
+ * Included Files
+ ****************************************************************************/
+
+#include <nuttx/config.h>
+
+#include <stdint.h>
+#include <time.h>
+#include <errno.h>
+
+#include <nuttx/clock.h>
+#include <nuttx/spinlock.h>
+#include <nuttx/userspace.h>
+
+#ifdef CONFIG_CLOCK_TIMEPAGE
+
+/****************************************************************************
+ * Pre-processor Definitions
+ ****************************************************************************/
+
+/* SP_DMB() is provided only with CONFIG_SPINLOCK.  On a single CPU it is
+ * enough that the compiler does not reorder the accesses.
+ */
+
+#ifndef SP_DMB
+#  define SP_DMB() __asm__ __volatile__ ("" ::: "memory")
+#endif
+
+/****************************************************************************
+ * Public Data
+ ****************************************************************************/
+
+/* The time page is user data.  The kernel half of a PROTECTED build
+ * reaches the user copy through struct userspace_s instead.
+ */
+
+#if !defined(CONFIG_BUILD_PROTECTED) || !defined(__KERNEL__)
+struct clock_timepage_s g_clock_timepage;
+#endif
+
+/****************************************************************************
+ * Public Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: clock_gettime
+ *
+ * Description:
+ *   Clock Functions based on POSIX APIs.
+ *
+ *   The time is read from the time page that the timer interrupt keeps up
+ *   to date, so no system call is needed.  The copy is retried if an update
+ *   was in progress or completed while it was being taken.
+ *
+ ****************************************************************************/
+
+int clock_gettime(clockid_t clock_id, FAR struct timespec *tp)
+{
+  FAR struct clock_timepage_s *page = CLOCK_TIMEPAGE;
+  struct timespec mono;
+  struct timespec base;
+  uint32_t seq;
+
+  if (tp == NULL)
+    {
+      set_errno(EINVAL);
+      return ERROR;
+    }
+
+#ifdef CONFIG_CLOCK_MONOTONIC
+  if (clock_id != CLOCK_MONOTONIC && clock_id != CLOCK_REALTIME)
+#else
+  if (clock_id != CLOCK_REALTIME)
+#endif
+    {
+      set_errno(EINVAL);
+      return ERROR;
+    }
+
+  do
+    {
+      seq = page->tp_seq;
+      SP_DMB();
+
+      mono.tv_sec  = page->tp_monotonic.tv_sec;
+      mono.tv_nsec = page->tp_monotonic.tv_nsec;
+      base.tv_sec  = page->tp_basetime.tv_sec;
+      base.tv_nsec = page->tp_basetime.tv_nsec;
+
+      SP_DMB();
+    }
+  while ((seq & 1) != 0 || seq != page->tp_seq);
+
+  if (clock_id == CLOCK_REALTIME)
+    {
+      /* Add the base time to the time since power up */
+
+      mono.tv_sec  += base.tv_sec;
+      mono.tv_nsec += base.tv_nsec;
+      if (mono.tv_nsec >= NSEC_PER_SEC)
+        {
+          mono.tv_nsec -= NSEC_PER_SEC;
+          mono.tv_sec++;
+        }
+    }
+
+  tp->tv_sec  = mono.tv_sec;
+  tp->tv_nsec = mono.tv_nsec;
+  return OK;
+}
+
+#endif /* CONFIG_CLOCK_TIMEPAGE */
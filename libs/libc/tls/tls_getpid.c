@@ -1,8 +1,7 @@
 /****************************************************************************
- * libc/net/lib_recvmsg.c
+ * libs/libc/tls/tls_getpid.c
  *
- *   Copyright (C) 2007, 2008, 2012, 2008 Gregory Nutt. All rights reserved.
- *   Author: Gregory Nutt <gnutt@nuttx.org>
+ *   Copyright (C) 2020 Gregory Nutt. All rights reserved.
  *
  * Redistribution and use in source and binary forms, with or without
  * modification, are permitted provided that the following conditions
@@ -39,51 +38,39 @@
 
 #include <nuttx/config.h>
 
-#ifdef CONFIG_NET
+#include <unistd.h>
 
-#include <sys/types.h>
-#include <sys/socket.h>
-#include <errno.h>
+#include <nuttx/arch.h>
+#include <nuttx/tls.h>
+#include <arch/tls.h>
+
+/* The kernel keeps its own getpid() in sched/task/task_getpid.c */
+
+#if defined(CONFIG_TLS_GETPID) && !defined(__KERNEL__)
 
 /****************************************************************************
  * Public Functions
  ****************************************************************************/
 
 /****************************************************************************
- * Function: recvmsg
+ * Name: getpid
  *
  * Description:
- *   The recvmsg() call is identical to recvfrom() with a NULL from parameter.
+ *   Get the ID of the currently executing thread.  The OS records the ID
+ *   in the TLS data when the thread is activated, so this does not require
+ *   a system call.
  *
- * Parameters:
- *   sockfd   Socket descriptor of socket
- *   buf      Buffer to receive data
- *   len      Length of buffer
- *   flags    Receive flags
+ * Input parameters:
+ *   None
  *
  * Returned Value:
- *  (see recvfrom)
- *
- * Assumptions:
+ *   The ID of the currently executing thread.
  *
  ****************************************************************************/
 
-ssize_t recvmsg(int sockfd, FAR struct msghdr *msg, int flags)
+pid_t getpid(void)
 {
-  FAR void *buf             = msg->msg_iov->iov_base;
-  FAR struct sockaddr *from = msg->msg_name;
-  FAR socklen_t *fromlen    = (FAR socklen_t *)&msg->msg_namelen;
-  size_t len                = msg->msg_iov->iov_len;
-
-  if (msg->msg_iovlen == 1)
-    {
-      return recvfrom(sockfd, buf, len, flags, from, fromlen);
-    }
-  else
-    {
-      set_errno(ENOTSUP);
-      return ERROR;
-    }
+  return up_tls_info()->tl_pid;
 }
 
-#endif /* CONFIG_NET */
+#endif /* CONFIG_TLS_GETPID && !__KERNEL__ */
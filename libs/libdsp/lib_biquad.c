@@ -0,0 +1,380 @@
+/****************************************************************************
+ * libs/libdsp/lib_biquad.c
+ *
+ *   Copyright (C) 2020 Gregory Nutt. All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in
+ *    the documentation and/or other materials provided with the
+ *    distribution.
+ * 3. Neither the name NuttX nor the names of its contributors may be
+ *    used to endorse or promote products derived from this software
+ *    without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+ * FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE
+ * COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+ * INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,
+ * BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS
+ * OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED
+ * AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ * LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN
+ * ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ *
+ ****************************************************************************/
+
+/****************************************************************************
+ * Included Files
+ ****************************************************************************/
+
+#include <dsp.h>
+
+/****************************************************************************
+ * Private Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: sat_q15
+ ****************************************************************************/
+
+static inline int16_t sat_q15(int64_t val)
+{
+  if (val > INT16_MAX)
+    {
+      return INT16_MAX;
+    }
+  else if (val < INT16_MIN)
+    {
+      return INT16_MIN;
+    }
+
+  return (int16_t)val;
+}
+
+/****************************************************************************
+ * Name: sat_q31
+ ****************************************************************************/
+
+static inline int32_t sat_q31(int64_t val)
+{
+  if (val > INT32_MAX)
+    {
+      return INT32_MAX;
+    }
+  else if (val < INT32_MIN)
+    {
+      return INT32_MIN;
+    }
+
+  return (int32_t)val;
+}
+
+/****************************************************************************
+ * Public Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: biquad_f32_init
+ *
+ * Description:
+ *   Initialize a float biquad cascade and clear its state
+ *
+ * Input Parameters:
+ *   bq      - pointer to the biquad cascade structure
+ *   nstages - number of second order sections
+ *   coeffs  - {b0, b1, b2, a1, a2} for each section
+ *   state   - buffer of 2 * nstages values
+ *
+ * Returned Value:
+ *   None
+ *
+ ****************************************************************************/
+
+void biquad_f32_init(FAR struct biquad_f32_s *bq, uint8_t nstages,
+                     FAR const float *coeffs, FAR float *state)
+{
+  DEBUGASSERT(bq != NULL && coeffs != NULL && state != NULL);
+
+  bq->coeffs  = coeffs;
+  bq->state   = state;
+  bq->nstages = nstages;
+
+  memset(state, 0, 2 * nstages * sizeof(float));
+}
+
+/****************************************************************************
+ * Name: biquad_f32
+ *
+ * Description:
+ *   Filter a block of float samples through the cascade.  Each section
+ *   processes the whole block with its coefficients and state held in
+ *   registers.
+ *
+ * Input Parameters:
+ *   bq       - pointer to the biquad cascade structure
+ *   in       - input samples
+ *   out      - output samples (may be the same buffer as in)
+ *   nsamples - number of samples
+ *
+ * Returned Value:
+ *   None
+ *
+ ****************************************************************************/
+
+void biquad_f32(FAR struct biquad_f32_s *bq, FAR const float *in,
+                FAR float *out, uint16_t nsamples)
+{
+  FAR const float *coeffs = bq->coeffs;
+  FAR float *state = bq->state;
+  FAR const float *src = in;
+  float b0;
+  float b1;
+  float b2;
+  float a1;
+  float a2;
+  float d1;
+  float d2;
+  float x;
+  float y;
+  int stage;
+  int n;
+
+  for (stage = 0; stage < bq->nstages; stage++)
+    {
+      b0 = coeffs[0];
+      b1 = coeffs[1];
+      b2 = coeffs[2];
+      a1 = coeffs[3];
+      a2 = coeffs[4];
+      d1 = state[0];
+      d2 = state[1];
+
+      for (n = 0; n < nsamples; n++)
+        {
+          x      = src[n];
+          y      = b0 * x + d1;
+          d1     = b1 * x - a1 * y + d2;
+          d2     = b2 * x - a2 * y;
+          out[n] = y;
+        }
+
+      state[0] = d1;
+      state[1] = d2;
+
+      /* The next section filters the output of this one */
+
+      src     = out;
+      coeffs += 5;
+      state  += 2;
+    }
+}
+
+/****************************************************************************
+ * Name: biquad_q15_init
+ *
+ * Description:
+ *   Initialize a q15 biquad cascade and clear its state
+ *
+ * Input Parameters:
+ *   bq        - pointer to the biquad cascade structure
+ *   nstages   - number of second order sections
+ *   coeffs    - {b0, b1, b2, a1, a2} / 2^postshift for each section
+ *   state     - buffer of 4 * nstages values
+ *   postshift - coefficient scaling
+ *
+ * Returned Value:
+ *   None
+ *
+ ****************************************************************************/
+
+void biquad_q15_init(FAR struct biquad_q15_s *bq, uint8_t nstages,
+                     FAR const int16_t *coeffs, FAR int16_t *state,
+                     uint8_t postshift)
+{
+  DEBUGASSERT(bq != NULL && coeffs != NULL && state != NULL);
+  DEBUGASSERT(postshift < 15);
+
+  bq->coeffs    = coeffs;
+  bq->state     = state;
+  bq->nstages   = nstages;
+  bq->postshift = postshift;
+
+  memset(state, 0, 4 * nstages * sizeof(int16_t));
+}
+
+/****************************************************************************
+ * Name: biquad_q15
+ *
+ * Description:
+ *   Filter a block of q15 samples through the cascade
+ *
+ * Input Parameters:
+ *   bq       - pointer to the biquad cascade structure
+ *   in       - input samples
+ *   out      - output samples (may be the same buffer as in)
+ *   nsamples - number of samples
+ *
+ * Returned Value:
+ *   None
+ *
+ ****************************************************************************/
+
+void biquad_q15(FAR struct biquad_q15_s *bq, FAR const int16_t *in,
+                FAR int16_t *out, uint16_t nsamples)
+{
+  FAR const int16_t *coeffs = bq->coeffs;
+  FAR int16_t *state = bq->state;
+  FAR const int16_t *src = in;
+  int shift = 15 - bq->postshift;
+  int16_t x1;
+  int16_t x2;
+  int16_t y1;
+  int16_t y2;
+  int16_t x;
+  int64_t acc;
+  int stage;
+  int n;
+
+  for (stage = 0; stage < bq->nstages; stage++)
+    {
+      x1 = state[0];
+      x2 = state[1];
+      y1 = state[2];
+      y2 = state[3];
+
+      for (n = 0; n < nsamples; n++)
+        {
+          x   = src[n];
+          acc = (int32_t)coeffs[0] * x +
+                (int32_t)coeffs[1] * x1 +
+                (int32_t)coeffs[2] * x2 -
+                (int32_t)coeffs[3] * y1 -
+                (int32_t)coeffs[4] * y2;
+
+          x2     = x1;
+          x1     = x;
+          y2     = y1;
+          y1     = sat_q15(acc >> shift);
+          out[n] = y1;
+        }
+
+      state[0] = x1;
+      state[1] = x2;
+      state[2] = y1;
+      state[3] = y2;
+
+      src     = out;
+      coeffs += 5;
+      state  += 4;
+    }
+}
+
+/****************************************************************************
+ * Name: biquad_q31_init
+ *
+ * Description:
+ *   Initialize a q31 biquad cascade and clear its state
+ *
+ * Input Parameters:
+ *   bq        - pointer to the biquad cascade structure
+ *   nstages   - number of second order sections
+ *   coeffs    - {b0, b1, b2, a1, a2} / 2^postshift for each section
+ *   state     - buffer of 4 * nstages values
+ *   postshift - coefficient scaling
+ *
+ * Returned Value:
+ *   None
+ *
+ ****************************************************************************/
+
+void biquad_q31_init(FAR struct biquad_q31_s *bq, uint8_t nstages,
+                     FAR const int32_t *coeffs, FAR int32_t *state,
+                     uint8_t postshift)
+{
+  DEBUGASSERT(bq != NULL && coeffs != NULL && state != NULL);
+  DEBUGASSERT(postshift < 31);
+
+  bq->coeffs    = coeffs;
+  bq->state     = state;
+  bq->nstages   = nstages;
+  bq->postshift = postshift;
+
+  memset(state, 0, 4 * nstages * sizeof(int32_t));
+}
+
+/****************************************************************************
+ * Name: biquad_q31
+ *
+ * Description:
+ *   Filter a block of q31 samples through the cascade.  The products are
+ *   accumulated in 64 bits.
+ *
+ * Input Parameters:
+ *   bq       - pointer to the biquad cascade structure
+ *   in       - input samples
+ *   out      - output samples (may be the same buffer as in)
+ *   nsamples - number of samples
+ *
+ * Returned Value:
+ *   None
+ *
+ ****************************************************************************/
+
+void biquad_q31(FAR struct biquad_q31_s *bq, FAR const int32_t *in,
+                FAR int32_t *out, uint16_t nsamples)
+{
+  FAR const int32_t *coeffs = bq->coeffs;
+  FAR int32_t *state = bq->state;
+  FAR const int32_t *src = in;
+  int shift = 31 - bq->postshift;
+  int32_t x1;
+  int32_t x2;
+  int32_t y1;
+  int32_t y2;
+  int32_t x;
+  int64_t acc;
+  int stage;
+  int n;
+
+  for (stage = 0; stage < bq->nstages; stage++)
+    {
+      x1 = state[0];
+      x2 = state[1];
+      y1 = state[2];
+      y2 = state[3];
+
+      for (n = 0; n < nsamples; n++)
+        {
+          x   = src[n];
+          acc = (int64_t)coeffs[0] * x +
+                (int64_t)coeffs[1] * x1 +
+                (int64_t)coeffs[2] * x2 -
+                (int64_t)coeffs[3] * y1 -
+                (int64_t)coeffs[4] * y2;
+
+          x2     = x1;
+          x1     = x;
+          y2     = y1;
+          y1     = sat_q31(acc >> shift);
+          out[n] = y1;
+        }
+
+      state[0] = x1;
+      state[1] = x2;
+      state[2] = y1;
+      state[3] = y2;
+
+      src     = out;
+      coeffs += 5;
+      state  += 4;
+    }
+}
@@ -0,0 +1,439 @@
+/****************************************************************************
+ * libs/libdsp/lib_fft.c
+ *
+ *   Copyright (C) 2020 Gregory Nutt. All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in
+ *    the documentation and/or other materials provided with the
+ *    distribution.
+ * 3. Neither the name NuttX nor the names of its contributors may be
+ *    used to endorse or promote products derived from this software
+ *    without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+ * FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE
+ * COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+ * INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,
+ * BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS
+ * OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED
+ * AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ * LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN
+ * ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ *
+ ****************************************************************************/
+
+/****************************************************************************
+ * Included Files
+ ****************************************************************************/
+
+#include <dsp.h>
+#include <errno.h>
+
+/****************************************************************************
+ * Private Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: fft_bitrev_f32
+ *
+ * Description:
+ *   Reorder m complex float values into bit-reversed order
+ *
+ ****************************************************************************/
+
+static void fft_bitrev_f32(FAR float *buf, int m)
+{
+  float tmp;
+  int i;
+  int j = 0;
+  int k;
+
+  for (i = 0; i < m - 1; i++)
+    {
+      if (i < j)
+        {
+          tmp            = buf[2 * i];
+          buf[2 * i]     = buf[2 * j];
+          buf[2 * j]     = tmp;
+          tmp            = buf[2 * i + 1];
+          buf[2 * i + 1] = buf[2 * j + 1];
+          buf[2 * j + 1] = tmp;
+        }
+
+      for (k = m >> 1; k <= j; k >>= 1)
+        {
+          j -= k;
+        }
+
+      j += k;
+    }
+}
+
+/****************************************************************************
+ * Name: fft_bitrev_q15
+ *
+ * Description:
+ *   Reorder m complex q15 values into bit-reversed order.  Each complex
+ *   value is moved as one 32-bit word.
+ *
+ ****************************************************************************/
+
+static void fft_bitrev_q15(FAR int16_t *buf, int m)
+{
+  FAR uint32_t *cbuf = (FAR uint32_t *)buf;
+  uint32_t tmp;
+  int i;
+  int j = 0;
+  int k;
+
+  for (i = 0; i < m - 1; i++)
+    {
+      if (i < j)
+        {
+          tmp     = cbuf[i];
+          cbuf[i] = cbuf[j];
+          cbuf[j] = tmp;
+        }
+
+      for (k = m >> 1; k <= j; k >>= 1)
+        {
+          j -= k;
+        }
+
+      j += k;
+    }
+}
+
+/****************************************************************************
+ * Name: cfft_f32
+ *
+ * Description:
+ *   In-place radix-2 complex FFT of m = n/2 points.  tw holds W_n^k for
+ *   k = 0..n/2-1, so stage 'len' uses every (n/len)-th entry.
+ *
+ ****************************************************************************/
+
+static void cfft_f32(FAR float *buf, FAR const float *tw, int n)
+{
+  int m = n >> 1;
+  int half;
+  int len;
+  int step;
+  int i;
+  int j;
+  FAR float *a;
+  FAR float *b;
+  float wr;
+  float wi;
+  float tr;
+  float ti;
+
+  fft_bitrev_f32(buf, m);
+
+  for (len = 2; len <= m; len <<= 1)
+    {
+      half = len >> 1;
+      step = n / len;
+
+      for (j = 0; j < half; j++)
+        {
+          wr = tw[2 * j * step];
+          wi = tw[2 * j * step + 1];
+
+          for (i = j; i < m; i += len)
+            {
+              a = &buf[2 * i];
+              b = &buf[2 * (i + half)];
+
+              tr   = wr * b[0] - wi * b[1];
+              ti   = wr * b[1] + wi * b[0];
+              b[0] = a[0] - tr;
+              b[1] = a[1] - ti;
+              a[0] = a[0] + tr;
+              a[1] = a[1] + ti;
+            }
+        }
+    }
+}
+
+/****************************************************************************
+ * Name: cfft_q15
+ *
+ * Description:
+ *   In-place radix-2 complex q15 FFT of m = n/2 points.  Every stage
+ *   halves its outputs, so the result is scaled by 1/m.
+ *
+ ****************************************************************************/
+
+static void cfft_q15(FAR int16_t *buf, FAR const int16_t *tw, int n)
+{
+  int m = n >> 1;
+  int half;
+  int len;
+  int step;
+  int i;
+  int j;
+  FAR int16_t *a;
+  FAR int16_t *b;
+  int32_t wr;
+  int32_t wi;
+  int32_t tr;
+  int32_t ti;
+
+  fft_bitrev_q15(buf, m);
+
+  for (len = 2; len <= m; len <<= 1)
+    {
+      half = len >> 1;
+      step = n / len;
+
+      for (j = 0; j < half; j++)
+        {
+          wr = tw[2 * j * step];
+          wi = tw[2 * j * step + 1];
+
+          for (i = j; i < m; i += len)
+            {
+              a = &buf[2 * i];
+              b = &buf[2 * (i + half)];
+
+              tr   = (wr * b[0] - wi * b[1]) >> 15;
+              ti   = (wr * b[1] + wi * b[0]) >> 15;
+              b[0] = (int16_t)((a[0] - tr) >> 1);
+              b[1] = (int16_t)((a[1] - ti) >> 1);
+              a[0] = (int16_t)((a[0] + tr) >> 1);
+              a[1] = (int16_t)((a[1] + ti) >> 1);
+            }
+        }
+    }
+}
+
+/****************************************************************************
+ * Public Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: rfft_f32_init
+ *
+ * Description:
+ *   Initialize a float real FFT and compute its twiddle factors
+ *
+ * Input Parameters:
+ *   fft     - pointer to the FFT structure
+ *   twiddle - buffer of n floats for the twiddle factors
+ *   n       - transform length, a power of two of at least 4
+ *
+ * Returned Value:
+ *   Zero on success; -EINVAL if n is not supported.
+ *
+ ****************************************************************************/
+
+int rfft_f32_init(FAR struct rfft_f32_s *fft, FAR float *twiddle,
+                  uint16_t n)
+{
+  float phase;
+  int k;
+
+  DEBUGASSERT(fft != NULL && twiddle != NULL);
+
+  if (n < 4 || (n & (n - 1)) != 0)
+    {
+      return -EINVAL;
+    }
+
+  for (k = 0; k < n / 2; k++)
+    {
+      phase              = 2.0f * M_PI_F * k / n;
+      twiddle[2 * k]     = cosf(phase);
+      twiddle[2 * k + 1] = -sinf(phase);
+    }
+
+  fft->twiddle = twiddle;
+  fft->n       = n;
+  return OK;
+}
+
+/****************************************************************************
+ * Name: rfft_f32
+ *
+ * Description:
+ *   In-place forward FFT of n real float samples.  See include/dsp.h for
+ *   the layout of the result.
+ *
+ * Input Parameters:
+ *   fft - pointer to the FFT structure
+ *   buf - n samples in, n/2 + 1 packed bins out
+ *
+ * Returned Value:
+ *   None
+ *
+ ****************************************************************************/
+
+void rfft_f32(FAR const struct rfft_f32_s *fft, FAR float *buf)
+{
+  FAR const float *tw = fft->twiddle;
+  int m = fft->n >> 1;
+  float fr;
+  float fi;
+  float gr;
+  float gi;
+  float tr;
+  float ti;
+  float zr;
+  float zi;
+  int k;
+
+  /* Treat the even and odd samples as the real and imaginary parts of an
+   * n/2 point complex sequence.
+   */
+
+  cfft_f32(buf, tw, fft->n);
+
+  /* Bins 0 and n/2 are both real */
+
+  zr     = buf[0];
+  zi     = buf[1];
+  buf[0] = zr + zi;
+  buf[1] = zr - zi;
+
+  /* Split the spectrum: with F and G the transforms of the even and odd
+   * samples, X(k) = F(k) + W^k G(k) and X(m-k) = conj(F(k) - W^k G(k)).
+   */
+
+  for (k = 1; k <= m / 2; k++)
+    {
+      FAR float *a = &buf[2 * k];
+      FAR float *b = &buf[2 * (m - k)];
+
+      fr = 0.5f * (a[0] + b[0]);
+      fi = 0.5f * (a[1] - b[1]);
+      gr = 0.5f * (a[1] + b[1]);
+      gi = 0.5f * (b[0] - a[0]);
+
+      tr = tw[2 * k] * gr - tw[2 * k + 1] * gi;
+      ti = tw[2 * k] * gi + tw[2 * k + 1] * gr;
+
+      a[0] = fr + tr;
+      a[1] = fi + ti;
+
+      if (k != m - k)
+        {
+          b[0] = fr - tr;
+          b[1] = ti - fi;
+        }
+    }
+}
+
+/****************************************************************************
+ * Name: rfft_q15_init
+ *
+ * Description:
+ *   Initialize a q15 real FFT and compute its twiddle factors
+ *
+ * Input Parameters:
+ *   fft     - pointer to the FFT structure
+ *   twiddle - buffer of n values for the twiddle factors
+ *   n       - transform length, a power of two of at least 4
+ *
+ * Returned Value:
+ *   Zero on success; -EINVAL if n is not supported.
+ *
+ ****************************************************************************/
+
+int rfft_q15_init(FAR struct rfft_q15_s *fft, FAR int16_t *twiddle,
+                  uint16_t n)
+{
+  float phase;
+  int k;
+
+  DEBUGASSERT(fft != NULL && twiddle != NULL);
+
+  if (n < 4 || (n & (n - 1)) != 0)
+    {
+      return -EINVAL;
+    }
+
+  for (k = 0; k < n / 2; k++)
+    {
+      phase              = 2.0f * M_PI_F * k / n;
+      twiddle[2 * k]     = (int16_t)lroundf(cosf(phase) * 32767.0f);
+      twiddle[2 * k + 1] = (int16_t)lroundf(-sinf(phase) * 32767.0f);
+    }
+
+  fft->twiddle = twiddle;
+  fft->n       = n;
+  return OK;
+}
+
+/****************************************************************************
+ * Name: rfft_q15
+ *
+ * Description:
+ *   In-place forward FFT of n real q15 samples.  The result is scaled by
+ *   1/n.
+ *
+ * Input Parameters:
+ *   fft - pointer to the FFT structure
+ *   buf - n samples in, n/2 + 1 packed bins out
+ *
+ * Returned Value:
+ *   None
+ *
+ ****************************************************************************/
+
+void rfft_q15(FAR const struct rfft_q15_s *fft, FAR int16_t *buf)
+{
+  FAR const int16_t *tw = fft->twiddle;
+  int m = fft->n >> 1;
+  int32_t fr;
+  int32_t fi;
+  int32_t gr;
+  int32_t gi;
+  int32_t tr;
+  int32_t ti;
+  int32_t zr;
+  int32_t zi;
+  int k;
+
+  cfft_q15(buf, tw, fft->n);
+
+  zr     = buf[0];
+  zi     = buf[1];
+  buf[0] = (int16_t)((zr + zi) >> 1);
+  buf[1] = (int16_t)((zr - zi) >> 1);
+
+  /* As for rfft_f32(), with one more halving to stay in range */
+
+  for (k = 1; k <= m / 2; k++)
+    {
+      FAR int16_t *a = &buf[2 * k];
+      FAR int16_t *b = &buf[2 * (m - k)];
+
+      fr = (a[0] + b[0]) >> 1;
+      fi = (a[1] - b[1]) >> 1;
+      gr = (a[1] + b[1]) >> 1;
+      gi = (b[0] - a[0]) >> 1;
+
+      tr = (tw[2 * k] * gr - tw[2 * k + 1] * gi) >> 15;
+      ti = (tw[2 * k] * gi + tw[2 * k + 1] * gr) >> 15;
+
+      a[0] = (int16_t)((fr + tr) >> 1);
+      a[1] = (int16_t)((fi + ti) >> 1);
+
+      if (k != m - k)
+        {
+          b[0] = (int16_t)((fr - tr) >> 1);
+          b[1] = (int16_t)((ti - fi) >> 1);
+        }
+    }
+}
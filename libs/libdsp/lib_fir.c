@@ -0,0 +1,401 @@
+/****************************************************************************
+ * libs/libdsp/lib_fir.c
+ *
+ *   Copyright (C) 2020 Gregory Nutt. All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in
+ *    the documentation and/or other materials provided with the
+ *    distribution.
+ * 3. Neither the name NuttX nor the names of its contributors may be
+ *    used to endorse or promote products derived from this software
+ *    without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+ * FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE
+ * COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+ * INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,
+ * BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS
+ * OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED
+ * AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ * LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN
+ * ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ *
+ ****************************************************************************/
+
+/****************************************************************************
+ * Included Files
+ ****************************************************************************/
+
+#include <dsp.h>
+
+/****************************************************************************
+ * Private Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: sat_q15
+ ****************************************************************************/
+
+static inline int16_t sat_q15(int64_t val)
+{
+  if (val > INT16_MAX)
+    {
+      return INT16_MAX;
+    }
+  else if (val < INT16_MIN)
+    {
+      return INT16_MIN;
+    }
+
+  return (int16_t)val;
+}
+
+/****************************************************************************
+ * Name: sat_q31
+ ****************************************************************************/
+
+static inline int32_t sat_q31(int64_t val)
+{
+  if (val > INT32_MAX)
+    {
+      return INT32_MAX;
+    }
+  else if (val < INT32_MIN)
+    {
+      return INT32_MIN;
+    }
+
+  return (int32_t)val;
+}
+
+#ifdef __ARM_FEATURE_DSP
+/****************************************************************************
+ * Name: dot2_q15
+ *
+ * Description:
+ *   acc += x[0]*c[0] + x[1]*c[1] with one SMLALD.  The sample pointer may
+ *   be unaligned, which ARMv7E-M word loads handle.
+ *
+ ****************************************************************************/
+
+static inline int64_t dot2_q15(FAR const int16_t *x, FAR const int16_t *c,
+                               int64_t acc)
+{
+  uint32_t xv;
+  uint32_t cv;
+
+  memcpy(&xv, x, sizeof(uint32_t));
+  memcpy(&cv, c, sizeof(uint32_t));
+
+  __asm__ ("smlald %Q0, %R0, %1, %2" : "+r"(acc) : "r"(xv), "r"(cv));
+  return acc;
+}
+#endif
+
+/****************************************************************************
+ * Public Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: fir_f32_init
+ *
+ * Description:
+ *   Initialize a float FIR filter and clear its history
+ *
+ * Input Parameters:
+ *   fir       - pointer to the FIR filter structure
+ *   coeffs    - filter coefficients in time-reversed order
+ *   state     - buffer of (ntaps + blocksize - 1) samples
+ *   ntaps     - number of filter taps
+ *   blocksize - maximum number of samples processed per call
+ *
+ * Returned Value:
+ *   None
+ *
+ ****************************************************************************/
+
+void fir_f32_init(FAR struct fir_f32_s *fir, FAR const float *coeffs,
+                  FAR float *state, uint16_t ntaps, uint16_t blocksize)
+{
+  DEBUGASSERT(fir != NULL && coeffs != NULL && state != NULL);
+  DEBUGASSERT(ntaps > 0 && blocksize > 0);
+
+  fir->coeffs    = coeffs;
+  fir->state     = state;
+  fir->ntaps     = ntaps;
+  fir->blocksize = blocksize;
+
+  memset(state, 0, (ntaps + blocksize - 1) * sizeof(float));
+}
+
+/****************************************************************************
+ * Name: fir_f32
+ *
+ * Description:
+ *   Filter a block of float samples.  Four outputs are computed together
+ *   so that each coefficient and sample is loaded once per four
+ *   multiply-accumulates.
+ *
+ * Input Parameters:
+ *   fir      - pointer to the FIR filter structure
+ *   in       - input samples
+ *   out      - output samples (may be the same buffer as in)
+ *   nsamples - number of samples, at most the filter block size
+ *
+ * Returned Value:
+ *   None
+ *
+ ****************************************************************************/
+
+void fir_f32(FAR struct fir_f32_s *fir, FAR const float *in,
+             FAR float *out, uint16_t nsamples)
+{
+  FAR const float *coeffs = fir->coeffs;
+  FAR float *state = fir->state;
+  uint16_t ntaps = fir->ntaps;
+  FAR const float *x;
+  float acc0;
+  float acc1;
+  float acc2;
+  float acc3;
+  float x0;
+  float x1;
+  float x2;
+  float x3;
+  float c;
+  int n;
+  int k;
+
+  DEBUGASSERT(nsamples <= fir->blocksize);
+
+  /* Append the new samples to the history */
+
+  memcpy(&state[ntaps - 1], in, nsamples * sizeof(float));
+
+  for (n = 0; n + 3 < nsamples; n += 4)
+    {
+      x    = &state[n];
+      acc0 = 0.0f;
+      acc1 = 0.0f;
+      acc2 = 0.0f;
+      acc3 = 0.0f;
+      x0   = x[0];
+      x1   = x[1];
+      x2   = x[2];
+
+      for (k = 0; k < ntaps; k++)
+        {
+          c     = coeffs[k];
+          x3    = x[k + 3];
+          acc0 += c * x0;
+          acc1 += c * x1;
+          acc2 += c * x2;
+          acc3 += c * x3;
+          x0    = x1;
+          x1    = x2;
+          x2    = x3;
+        }
+
+      out[n]     = acc0;
+      out[n + 1] = acc1;
+      out[n + 2] = acc2;
+      out[n + 3] = acc3;
+    }
+
+  for (; n < nsamples; n++)
+    {
+      x    = &state[n];
+      acc0 = 0.0f;
+
+      for (k = 0; k < ntaps; k++)
+        {
+          acc0 += coeffs[k] * x[k];
+        }
+
+      out[n] = acc0;
+    }
+
+  /* Keep the last ntaps - 1 samples for the next block */
+
+  memmove(state, &state[nsamples], (ntaps - 1) * sizeof(float));
+}
+
+/****************************************************************************
+ * Name: fir_q15_init
+ *
+ * Description:
+ *   Initialize a q15 FIR filter and clear its history
+ *
+ * Input Parameters:
+ *   fir       - pointer to the FIR filter structure
+ *   coeffs    - filter coefficients in time-reversed order
+ *   state     - buffer of (ntaps + blocksize - 1) samples
+ *   ntaps     - number of filter taps
+ *   blocksize - maximum number of samples processed per call
+ *
+ * Returned Value:
+ *   None
+ *
+ ****************************************************************************/
+
+void fir_q15_init(FAR struct fir_q15_s *fir, FAR const int16_t *coeffs,
+                  FAR int16_t *state, uint16_t ntaps, uint16_t blocksize)
+{
+  DEBUGASSERT(fir != NULL && coeffs != NULL && state != NULL);
+  DEBUGASSERT(ntaps > 0 && blocksize > 0);
+
+  fir->coeffs    = coeffs;
+  fir->state     = state;
+  fir->ntaps     = ntaps;
+  fir->blocksize = blocksize;
+
+  memset(state, 0, (ntaps + blocksize - 1) * sizeof(int16_t));
+}
+
+/****************************************************************************
+ * Name: fir_q15
+ *
+ * Description:
+ *   Filter a block of q15 samples.  With the ARMv7E-M DSP extension two
+ *   taps are processed per SMLALD instruction.
+ *
+ * Input Parameters:
+ *   fir      - pointer to the FIR filter structure
+ *   in       - input samples
+ *   out      - output samples (may be the same buffer as in)
+ *   nsamples - number of samples, at most the filter block size
+ *
+ * Returned Value:
+ *   None
+ *
+ ****************************************************************************/
+
+void fir_q15(FAR struct fir_q15_s *fir, FAR const int16_t *in,
+             FAR int16_t *out, uint16_t nsamples)
+{
+  FAR const int16_t *coeffs = fir->coeffs;
+  FAR int16_t *state = fir->state;
+  uint16_t ntaps = fir->ntaps;
+  FAR const int16_t *x;
+  int64_t acc;
+  int n;
+  int k;
+
+  DEBUGASSERT(nsamples <= fir->blocksize);
+
+  memcpy(&state[ntaps - 1], in, nsamples * sizeof(int16_t));
+
+  for (n = 0; n < nsamples; n++)
+    {
+      x   = &state[n];
+      acc = 0;
+      k   = 0;
+
+#ifdef __ARM_FEATURE_DSP
+      for (; k + 1 < ntaps; k += 2)
+        {
+          acc = dot2_q15(&x[k], &coeffs[k], acc);
+        }
+#endif
+
+      for (; k < ntaps; k++)
+        {
+          acc += (int32_t)x[k] * coeffs[k];
+        }
+
+      out[n] = sat_q15(acc >> 15);
+    }
+
+  memmove(state, &state[nsamples], (ntaps - 1) * sizeof(int16_t));
+}
+
+/****************************************************************************
+ * Name: fir_q31_init
+ *
+ * Description:
+ *   Initialize a q31 FIR filter and clear its history
+ *
+ * Input Parameters:
+ *   fir       - pointer to the FIR filter structure
+ *   coeffs    - filter coefficients in time-reversed order
+ *   state     - buffer of (ntaps + blocksize - 1) samples
+ *   ntaps     - number of filter taps
+ *   blocksize - maximum number of samples processed per call
+ *
+ * Returned Value:
+ *   None
+ *
+ ****************************************************************************/
+
+void fir_q31_init(FAR struct fir_q31_s *fir, FAR const int32_t *coeffs,
+                  FAR int32_t *state, uint16_t ntaps, uint16_t blocksize)
+{
+  DEBUGASSERT(fir != NULL && coeffs != NULL && state != NULL);
+  DEBUGASSERT(ntaps > 0 && blocksize > 0);
+
+  fir->coeffs    = coeffs;
+  fir->state     = state;
+  fir->ntaps     = ntaps;
+  fir->blocksize = blocksize;
+
+  memset(state, 0, (ntaps + blocksize - 1) * sizeof(int32_t));
+}
+
+/****************************************************************************
+ * Name: fir_q31
+ *
+ * Description:
+ *   Filter a block of q31 samples.  The products are accumulated in 64
+ *   bits (SMLAL on ARMv7-M).
+ *
+ * Input Parameters:
+ *   fir      - pointer to the FIR filter structure
+ *   in       - input samples
+ *   out      - output samples (may be the same buffer as in)
+ *   nsamples - number of samples, at most the filter block size
+ *
+ * Returned Value:
+ *   None
+ *
+ ****************************************************************************/
+
+void fir_q31(FAR struct fir_q31_s *fir, FAR const int32_t *in,
+             FAR int32_t *out, uint16_t nsamples)
+{
+  FAR const int32_t *coeffs = fir->coeffs;
+  FAR int32_t *state = fir->state;
+  uint16_t ntaps = fir->ntaps;
+  FAR const int32_t *x;
+  int64_t acc;
+  int n;
+  int k;
+
+  DEBUGASSERT(nsamples <= fir->blocksize);
+
+  memcpy(&state[ntaps - 1], in, nsamples * sizeof(int32_t));
+
+  for (n = 0; n < nsamples; n++)
+    {
+      x   = &state[n];
+      acc = 0;
+
+      for (k = 0; k < ntaps; k++)
+        {
+          acc += (int64_t)x[k] * coeffs[k];
+        }
+
+      out[n] = sat_q31(acc >> 31);
+    }
+
+  memmove(state, &state[nsamples], (ntaps - 1) * sizeof(int32_t));
+}
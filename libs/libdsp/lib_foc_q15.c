@@ -0,0 +1,633 @@
+/****************************************************************************
+ * libs/libdsp/lib_foc_q15.c
+ *
+ *   Copyright (C) 2020 Gregory Nutt. All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in
+ *    the documentation and/or other materials provided with the
+ *    distribution.
+ * 3. Neither the name NuttX nor the names of its contributors may be
+ *    used to endorse or promote products derived from this software
+ *    without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+ * FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE
+ * COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+ * INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,
+ * BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS
+ * OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED
+ * AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ * LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN
+ * ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ *
+ ****************************************************************************/
+
+/****************************************************************************
+ * Included Files
+ ****************************************************************************/
+
+#include <dsp.h>
+
+/****************************************************************************
+ * Pre-processor Definitions
+ ****************************************************************************/
+
+#define Q15_ONE              32768
+#define Q15_SQRT3_BY_TWO     28378   /* sqrt(3)/2 */
+#define Q15_ONE_BY_SQRT3     18919   /* 1/sqrt(3) */
+
+/****************************************************************************
+ * Private Data
+ ****************************************************************************/
+
+/* sin(k * PI / 128) for the first quadrant, q15 */
+
+static const int16_t g_sin_q15[65] =
+{
+  0, 804, 1608, 2411, 3212, 4011, 4808, 5602,
+  6393, 7180, 7962, 8740, 9512, 10279, 11039, 11793,
+  12540, 13279, 14010, 14733, 15447, 16151, 16846, 17531,
+  18205, 18868, 19520, 20160, 20788, 21403, 22006, 22595,
+  23170, 23732, 24279, 24812, 25330, 25833, 26320, 26791,
+  27246, 27684, 28106, 28511, 28899, 29269, 29622, 29957,
+  30274, 30572, 30853, 31114, 31357, 31581, 31786, 31972,
+  32138, 32286, 32413, 32522, 32610, 32679, 32729, 32758,
+  32767
+};
+
+/****************************************************************************
+ * Private Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: sat_q15
+ ****************************************************************************/
+
+static inline int16_t sat_q15(int32_t val)
+{
+  if (val > INT16_MAX)
+    {
+      return INT16_MAX;
+    }
+  else if (val < INT16_MIN)
+    {
+      return INT16_MIN;
+    }
+
+  return (int16_t)val;
+}
+
+/****************************************************************************
+ * Name: sin_q15_lookup
+ *
+ * Description:
+ *   Return sin(k * PI / 128) for k = 0..256
+ *
+ ****************************************************************************/
+
+static inline int32_t sin_q15_lookup(int k)
+{
+  if (k <= 64)
+    {
+      return g_sin_q15[k];
+    }
+  else if (k <= 128)
+    {
+      return g_sin_q15[128 - k];
+    }
+  else if (k <= 192)
+    {
+      return -g_sin_q15[k - 128];
+    }
+
+  return -g_sin_q15[256 - k];
+}
+
+/****************************************************************************
+ * Name: sin_q15
+ *
+ * Description:
+ *   Sine of a 16-bit angle (65536 = 2*PI) with linear interpolation
+ *
+ ****************************************************************************/
+
+static inline int16_t sin_q15(uint16_t angle)
+{
+  int k = angle >> 8;
+  int32_t frac = angle & 0xff;
+  int32_t a = sin_q15_lookup(k);
+  int32_t b = sin_q15_lookup(k + 1);
+
+  return (int16_t)(a + (((b - a) * frac) >> 8));
+}
+
+/****************************************************************************
+ * Name: isqrt
+ *
+ * Description:
+ *   Integer square root
+ *
+ ****************************************************************************/
+
+static inline uint32_t isqrt(uint32_t x)
+{
+  uint32_t res = 0;
+  uint32_t bit = 1ul << 30;
+
+  while (bit > x)
+    {
+      bit >>= 2;
+    }
+
+  while (bit != 0)
+    {
+      if (x >= res + bit)
+        {
+          x  -= res + bit;
+          res = (res >> 1) + bit;
+        }
+      else
+        {
+          res >>= 1;
+        }
+
+      bit >>= 2;
+    }
+
+  return res;
+}
+
+/****************************************************************************
+ * Name: pi_q15_run
+ *
+ * Description:
+ *   One step of the PI controller with integral anti-windup
+ *
+ ****************************************************************************/
+
+static inline int16_t pi_q15_run(FAR struct pi_q15_s *pi, int16_t err)
+{
+  int shift = 15 - pi->shift;
+  int32_t imin = (int32_t)pi->min << shift;
+  int32_t imax = (int32_t)pi->max << shift;
+  int32_t out;
+
+  /* Integrate and clamp the integral part to the output range */
+
+  pi->integ += (int32_t)pi->ki * err;
+  if (pi->integ > imax)
+    {
+      pi->integ = imax;
+    }
+  else if (pi->integ < imin)
+    {
+      pi->integ = imin;
+    }
+
+  out = ((int32_t)pi->kp * err + pi->integ) >> shift;
+  if (out > pi->max)
+    {
+      out = pi->max;
+    }
+  else if (out < pi->min)
+    {
+      out = pi->min;
+    }
+
+  return (int16_t)out;
+}
+
+/****************************************************************************
+ * Public Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: sin_cos_q15
+ *
+ * Description:
+ *   Get sine and cosine of a 16-bit angle (65536 = 2*PI) from a table
+ *
+ * Input Parameters:
+ *   angle - (in) angle
+ *   psin  - (out) sine, q15
+ *   pcos  - (out) cosine, q15
+ *
+ * Returned Value:
+ *   None
+ *
+ ****************************************************************************/
+
+void sin_cos_q15(uint16_t angle, FAR int16_t *psin, FAR int16_t *pcos)
+{
+  *psin = sin_q15(angle);
+  *pcos = sin_q15((uint16_t)(angle + 16384));
+}
+
+/****************************************************************************
+ * Name: pi_q15_init
+ *
+ * Description:
+ *   Initialize fixed point PI controller
+ *
+ * Input Parameters:
+ *   pi    - (out) pointer to the PI controller data
+ *   kp    - (in) proportional gain, scaled by 2^-shift
+ *   ki    - (in) integral gain, scaled by 2^-shift
+ *   shift - (in) gain scaling, 0..15
+ *
+ * Returned Value:
+ *   None
+ *
+ ****************************************************************************/
+
+void pi_q15_init(FAR struct pi_q15_s *pi, int16_t kp, int16_t ki,
+                 uint8_t shift)
+{
+  DEBUGASSERT(pi != NULL);
+  DEBUGASSERT(shift <= 15);
+
+  pi->integ = 0;
+  pi->kp    = kp;
+  pi->ki    = ki;
+  pi->min   = INT16_MIN;
+  pi->max   = INT16_MAX;
+  pi->shift = shift;
+}
+
+/****************************************************************************
+ * Name: pi_q15_saturation_set
+ *
+ * Description:
+ *   Set fixed point PI controller output limits
+ *
+ * Input Parameters:
+ *   pi  - (in/out) pointer to the PI controller data
+ *   min - (in) lower limit
+ *   max - (in) upper limit
+ *
+ * Returned Value:
+ *   None
+ *
+ ****************************************************************************/
+
+void pi_q15_saturation_set(FAR struct pi_q15_s *pi, int16_t min,
+                           int16_t max)
+{
+  DEBUGASSERT(pi != NULL);
+  DEBUGASSERT(min <= max);
+
+  pi->min = min;
+  pi->max = max;
+}
+
+/****************************************************************************
+ * Name: pi_q15_reset
+ *
+ * Description:
+ *   Reset fixed point PI controller integral part
+ *
+ * Input Parameters:
+ *   pi - (in/out) pointer to the PI controller data
+ *
+ * Returned Value:
+ *   None
+ *
+ ****************************************************************************/
+
+void pi_q15_reset(FAR struct pi_q15_s *pi)
+{
+  DEBUGASSERT(pi != NULL);
+
+  pi->integ = 0;
+}
+
+/****************************************************************************
+ * Name: pi_q15
+ *
+ * Description:
+ *   Fixed point PI controller
+ *
+ * Input Parameters:
+ *   pi  - (in/out) pointer to the PI controller data
+ *   err - (in) current error, q15
+ *
+ * Returned Value:
+ *   Controller output, q15
+ *
+ ****************************************************************************/
+
+int16_t pi_q15(FAR struct pi_q15_s *pi, int16_t err)
+{
+  DEBUGASSERT(pi != NULL);
+
+  return pi_q15_run(pi, err);
+}
+
+/****************************************************************************
+ * Name: foc_q15_init
+ *
+ * Description:
+ *   Initialize fixed point FOC controller
+ *
+ * Input Parameters:
+ *   foc   - (out) pointer to the FOC data
+ *   id_kp - (in) KP for d current, scaled by 2^-shift
+ *   id_ki - (in) KI for d current, scaled by 2^-shift
+ *   iq_kp - (in) KP for q current, scaled by 2^-shift
+ *   iq_ki - (in) KI for q current, scaled by 2^-shift
+ *   shift - (in) gain scaling, 0..15
+ *
+ * Returned Value:
+ *   None
+ *
+ ****************************************************************************/
+
+void foc_q15_init(FAR struct foc_q15_s *foc, int16_t id_kp, int16_t id_ki,
+                  int16_t iq_kp, int16_t iq_ki, uint8_t shift)
+{
+  DEBUGASSERT(foc != NULL);
+
+  memset(foc, 0, sizeof(struct foc_q15_s));
+
+  pi_q15_init(&foc->id_pi, id_kp, id_ki, shift);
+  pi_q15_init(&foc->iq_pi, iq_kp, iq_ki, shift);
+
+  /* No output until the limits are set */
+
+  foc_q15_vdq_max_set(foc, 0);
+  foc_q15_duty_set(foc, 0, INT16_MAX);
+}
+
+/****************************************************************************
+ * Name: foc_q15_vdq_max_set
+ *
+ * Description:
+ *   Set maximum dq voltage vector magnitude (fraction of the base voltage)
+ *
+ * Input Parameters:
+ *   foc - (in/out) pointer to the FOC data
+ *   max - (in) maximum dq voltage magnitude, q15
+ *
+ * Returned Value:
+ *   None
+ *
+ ****************************************************************************/
+
+void foc_q15_vdq_max_set(FAR struct foc_q15_s *foc, int16_t max)
+{
+  DEBUGASSERT(foc != NULL);
+  DEBUGASSERT(max >= 0);
+
+  foc->vdq_max = max;
+
+  /* Update regulators saturation */
+
+  pi_q15_saturation_set(&foc->id_pi, -max, max);
+  pi_q15_saturation_set(&foc->iq_pi, -max, max);
+}
+
+/****************************************************************************
+ * Name: foc_q15_duty_set
+ *
+ * Description:
+ *   Set duty cycle limits
+ *
+ * Input Parameters:
+ *   foc - (in/out) pointer to the FOC data
+ *   min - (in) minimum duty cycle, q15
+ *   max - (in) maximum duty cycle, q15
+ *
+ * Returned Value:
+ *   None
+ *
+ ****************************************************************************/
+
+void foc_q15_duty_set(FAR struct foc_q15_s *foc, int16_t min, int16_t max)
+{
+  DEBUGASSERT(foc != NULL);
+  DEBUGASSERT(min <= max);
+
+  foc->d_min = min;
+  foc->d_max = max;
+}
+
+/****************************************************************************
+ * Name: foc_q15_idq_ref_set
+ *
+ * Description:
+ *   Set dq reference current vector
+ *
+ * Input Parameters:
+ *   foc - (in/out) pointer to the FOC data
+ *   d   - (in) reference d current, q15
+ *   q   - (in) reference q current, q15
+ *
+ * Returned Value:
+ *   None
+ *
+ ****************************************************************************/
+
+void foc_q15_idq_ref_set(FAR struct foc_q15_s *foc, int16_t d, int16_t q)
+{
+  DEBUGASSERT(foc != NULL);
+
+  foc->i_d_ref = d;
+  foc->i_q_ref = q;
+}
+
+/****************************************************************************
+ * Name: foc_q15_process
+ *
+ * Description:
+ *   Run one fixed point FOC step: Clarke and Park transforms, the two
+ *   current PI controllers, dq voltage limiting, inverse Park transform
+ *   and space vector modulation.  The stages are inlined into this one
+ *   function so that a PWM interrupt pays for a single call and no float
+ *   conversions.  The result is left in foc->duty[].
+ *
+ * Input Parameters:
+ *   foc       - (in/out) pointer to the FOC data
+ *   i_a       - (in) phase A current, q15
+ *   i_b       - (in) phase B current, q15
+ *   angle_sin - (in) sine of the electrical angle, q15
+ *   angle_cos - (in) cosine of the electrical angle, q15
+ *
+ * Returned Value:
+ *   None
+ *
+ ****************************************************************************/
+
+void foc_q15_process(FAR struct foc_q15_s *foc, int16_t i_a, int16_t i_b,
+                     int16_t angle_sin, int16_t angle_cos)
+{
+  int32_t s = angle_sin;
+  int32_t c = angle_cos;
+  int32_t alpha;
+  int32_t beta;
+  int32_t d;
+  int32_t q;
+  int32_t mag;
+  int32_t i;
+  int32_t j;
+  int32_t k;
+  int32_t t1;
+  int32_t t2;
+  int32_t t0;
+  int32_t du;
+  int32_t dv;
+  int32_t dw;
+
+  DEBUGASSERT(foc != NULL);
+
+  /* Clarke transform (abc current -> alpha-beta current) */
+
+  alpha = i_a;
+  beta  = sat_q15(((i_a + 2 * (int32_t)i_b) * Q15_ONE_BY_SQRT3) >> 15);
+
+  foc->i_alpha = (int16_t)alpha;
+  foc->i_beta  = (int16_t)beta;
+
+  /* Park transform (alpha-beta current -> dq current) */
+
+  foc->i_d = sat_q15((c * alpha + s * beta) >> 15);
+  foc->i_q = sat_q15((c * beta - s * alpha) >> 15);
+
+  /* Current control (dq current -> dq voltage) */
+
+  d = pi_q15_run(&foc->id_pi, sat_q15((int32_t)foc->i_d_ref - foc->i_d));
+  q = pi_q15_run(&foc->iq_pi, sat_q15((int32_t)foc->i_q_ref - foc->i_q));
+
+  /* Saturate the dq voltage vector magnitude */
+
+  mag = (int32_t)isqrt((uint32_t)(d * d) + (uint32_t)(q * q));
+  if (mag > foc->vdq_max)
+    {
+      d = d * foc->vdq_max / mag;
+      q = q * foc->vdq_max / mag;
+    }
+
+  foc->v_d = (int16_t)d;
+  foc->v_q = (int16_t)q;
+
+  /* Inverse Park transform (dq voltage -> alpha-beta voltage) */
+
+  alpha = sat_q15((c * d - s * q) >> 15);
+  beta  = sat_q15((c * q + s * d) >> 15);
+
+  foc->v_alpha = (int16_t)alpha;
+  foc->v_beta  = (int16_t)beta;
+
+  /* Space vector modulation, as in svm3(): get the auxiliary i,j,k frame,
+   * the sector and the active vector times.
+   */
+
+  i = (Q15_SQRT3_BY_TWO * alpha - Q15_ONE / 2 * beta) >> 15;
+  j = beta;
+  k = -j - i;
+
+  if (k <= 0)
+    {
+      if (i <= 0)
+        {
+          foc->sector = 2;
+          t1 = -k;
+          t2 = -i;
+        }
+      else if (j <= 0)
+        {
+          foc->sector = 6;
+          t1 = -j;
+          t2 = -k;
+        }
+      else
+        {
+          foc->sector = 1;
+          t1 = i;
+          t2 = j;
+        }
+    }
+  else
+    {
+      if (i > 0)
+        {
+          foc->sector = 5;
+          t1 = k;
+          t2 = i;
+        }
+      else if (j <= 0)
+        {
+          foc->sector = 4;
+          t1 = -i;
+          t2 = -j;
+        }
+      else
+        {
+          foc->sector = 3;
+          t1 = j;
+          t2 = k;
+        }
+    }
+
+  /* Half of the null vector time goes to each end of the PWM period */
+
+  t0 = (Q15_ONE - t1 - t2) / 2;
+
+  switch (foc->sector)
+    {
+      case 1:
+        du = t1 + t2 + t0;
+        dv = t2 + t0;
+        dw = t0;
+        break;
+
+      case 2:
+        du = t1 + t0;
+        dv = t1 + t2 + t0;
+        dw = t0;
+        break;
+
+      case 3:
+        du = t0;
+        dv = t1 + t2 + t0;
+        dw = t2 + t0;
+        break;
+
+      case 4:
+        du = t0;
+        dv = t1 + t0;
+        dw = t1 + t2 + t0;
+        break;
+
+      case 5:
+        du = t2 + t0;
+        dv = t0;
+        dw = t1 + t2 + t0;
+        break;
+
+      case 6:
+      default:
+        du = t1 + t2 + t0;
+        dv = t0;
+        dw = t1 + t0;
+        break;
+    }
+
+  /* Saturate output duty cycles */
+
+  foc->duty[0] = (int16_t)(du < foc->d_min ? foc->d_min :
+                           du > foc->d_max ? foc->d_max : du);
+  foc->duty[1] = (int16_t)(dv < foc->d_min ? foc->d_min :
+                           dv > foc->d_max ? foc->d_max : dv);
+  foc->duty[2] = (int16_t)(dw < foc->d_min ? foc->d_min :
+                           dw > foc->d_max ? foc->d_max : dw);
+}
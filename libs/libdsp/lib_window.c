@@ -0,0 +1,193 @@
+/****************************************************************************
+ * libs/libdsp/lib_window.c
+ *
+ *   Copyright (C) 2020 Gregory Nutt. All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in
+ *    the documentation and/or other materials provided with the
+ *    distribution.
+ * 3. Neither the name NuttX nor the names of its contributors may be
+ *    used to endorse or promote products derived from this software
+ *    without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+ * FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE
+ * COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+ * INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,
+ * BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS
+ * OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED
+ * AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ * LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN
+ * ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ *
+ ****************************************************************************/
+
+/****************************************************************************
+ * Included Files
+ ****************************************************************************/
+
+#include <dsp.h>
+
+/****************************************************************************
+ * Private Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: window_value
+ *
+ * Description:
+ *   Return sample i of a periodic window of length n
+ *
+ ****************************************************************************/
+
+static float window_value(int i, uint16_t n, enum window_type_e type)
+{
+  float phase = 2.0f * M_PI_F * i / n;
+
+  switch (type)
+    {
+      case WINDOW_HANN:
+        return 0.5f - 0.5f * cosf(phase);
+
+      case WINDOW_HAMMING:
+        return 0.54f - 0.46f * cosf(phase);
+
+      case WINDOW_BLACKMAN:
+        return 0.42f - 0.5f * cosf(phase) + 0.08f * cosf(2.0f * phase);
+
+      case WINDOW_RECT:
+      default:
+        return 1.0f;
+    }
+}
+
+/****************************************************************************
+ * Public Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: window_init_f32
+ *
+ * Description:
+ *   Fill a buffer with a float window
+ *
+ * Input Parameters:
+ *   w    - buffer of n values
+ *   n    - window length
+ *   type - window type
+ *
+ * Returned Value:
+ *   None
+ *
+ ****************************************************************************/
+
+void window_init_f32(FAR float *w, uint16_t n, enum window_type_e type)
+{
+  int i;
+
+  DEBUGASSERT(w != NULL);
+
+  for (i = 0; i < n; i++)
+    {
+      w[i] = window_value(i, n, type);
+    }
+}
+
+/****************************************************************************
+ * Name: window_init_q15
+ *
+ * Description:
+ *   Fill a buffer with a q15 window.  1.0 is stored as 32767.
+ *
+ * Input Parameters:
+ *   w    - buffer of n values
+ *   n    - window length
+ *   type - window type
+ *
+ * Returned Value:
+ *   None
+ *
+ ****************************************************************************/
+
+void window_init_q15(FAR int16_t *w, uint16_t n, enum window_type_e type)
+{
+  int i;
+
+  DEBUGASSERT(w != NULL);
+
+  for (i = 0; i < n; i++)
+    {
+      w[i] = (int16_t)lroundf(window_value(i, n, type) * 32767.0f);
+    }
+}
+
+/****************************************************************************
+ * Name: window_apply_f32
+ *
+ * Description:
+ *   Multiply a block of float samples by a window, in place
+ *
+ * Input Parameters:
+ *   w   - window values
+ *   buf - samples
+ *   n   - number of samples
+ *
+ * Returned Value:
+ *   None
+ *
+ ****************************************************************************/
+
+void window_apply_f32(FAR const float *w, FAR float *buf, uint16_t n)
+{
+  int i;
+
+  for (i = 0; i + 3 < n; i += 4)
+    {
+      buf[i]     *= w[i];
+      buf[i + 1] *= w[i + 1];
+      buf[i + 2] *= w[i + 2];
+      buf[i + 3] *= w[i + 3];
+    }
+
+  for (; i < n; i++)
+    {
+      buf[i] *= w[i];
+    }
+}
+
+/****************************************************************************
+ * Name: window_apply_q15
+ *
+ * Description:
+ *   Multiply a block of q15 samples by a q15 window, in place.  The
+ *   window values never exceed 1.0, so the products cannot overflow.
+ *
+ * Input Parameters:
+ *   w   - window values
+ *   buf - samples
+ *   n   - number of samples
+ *
+ * Returned Value:
+ *   None
+ *
+ ****************************************************************************/
+
+void window_apply_q15(FAR const int16_t *w, FAR int16_t *buf, uint16_t n)
+{
+  int i;
+
+  for (i = 0; i < n; i++)
+    {
+      buf[i] = (int16_t)(((int32_t)buf[i] * w[i]) >> 15);
+    }
+}
@@ -50,6 +50,30 @@
 
 #include "nxcontext.h"
 
+/****************************************************************************
+ * Pre-processor Definitions
+ ****************************************************************************/
+
+#ifndef CONFIG_NXFONTS_CACHE_SIZE
+#  define CONFIG_NXFONTS_CACHE_SIZE 0
+#endif
+
+/* The range of character codes pre-rendered in the atlas */
+
+#define NXFONTS_ATLAS_FIRST  0x20
+#define NXFONTS_ATLAS_LAST   0x7e
+#define NXFONTS_ATLAS_NCHARS (NXFONTS_ATLAS_LAST - NXFONTS_ATLAS_FIRST + 1)
+
+/* Glyphs in the atlas are aligned like the memory returned by malloc() */
+
+#define NXFONTS_ALIGN_MASK   (sizeof(uintptr_t) - 1)
+#define NXFONTS_ALIGN_UP(n)  (((n) + NXFONTS_ALIGN_MASK) & ~NXFONTS_ALIGN_MASK)
+
+/* The size of the memory holding a glyph */
+
+#define NXFONTS_GLYPHSIZE(g) \
+  SIZEOF_NXFONTS_GLYPH_S((size_t)(g)->stride * (g)->height)
+
 /****************************************************************************
  * Private Types
  ****************************************************************************/
@@ -81,6 +105,14 @@ struct nxfonts_fcache_s
 
   FAR struct nxfonts_glyph_s *head;    /* Head of the list of glyphs */
   FAR struct nxfonts_glyph_s *tail;    /* Tail of the list of glyphs */
+
+#ifdef CONFIG_NXFONTS_CACHE_ATLAS
+  /* Pre-rendered glyphs of the printable ASCII characters.  NULL if the
+   * atlas could not be allocated.
+   */
+
+  FAR struct nxfonts_glyph_s **atlas;
+#endif
 };
 
 /****************************************************************************
@@ -92,6 +124,12 @@ struct nxfonts_fcache_s
 static FAR struct nxfonts_fcache_s *g_fcaches;
 static sem_t g_cachesem = SEM_INITIALIZER(1);
 
+#if CONFIG_NXFONTS_CACHE_SIZE > 0
+/* Memory used by the glyphs of all font caches.  Protected by g_cachesem. */
+
+static size_t g_cachebytes;
+#endif
+
 /****************************************************************************
  * Private Functions
  ****************************************************************************/
@@ -234,6 +272,26 @@ static inline void nxf_removeglyph(FAR struct nxfonts_fcache_s *priv,
   priv->nglyphs--;
 }
 
+/****************************************************************************
+ * Name: nxf_freeglyph
+ *
+ * Description:
+ *   Free the memory of a glyph that has been removed from the font cache.
+ *
+ ****************************************************************************/
+
+static void nxf_freeglyph(FAR struct nxfonts_glyph_s *glyph)
+{
+#if CONFIG_NXFONTS_CACHE_SIZE > 0
+  nxf_list_lock();
+  DEBUGASSERT(g_cachebytes >= NXFONTS_GLYPHSIZE(glyph));
+  g_cachebytes -= NXFONTS_GLYPHSIZE(glyph);
+  nxf_list_unlock();
+#endif
+
+  lib_free(glyph);
+}
+
 /****************************************************************************
  * Name: nxf_addglyph
  *
@@ -332,7 +390,7 @@ static FAR struct nxfonts_glyph_s *
            */
 
           nxf_removeglyph(priv, glyph, prev);
-          lib_free(glyph);
+          nxf_freeglyph(glyph);
           return NULL;
         }
     }
@@ -504,6 +562,103 @@ static inline void nxf_fillglyph(FAR struct nxfonts_fcache_s *priv,
     }
 }
 
+/****************************************************************************
+ * Name: nxf_bmsize
+ *
+ * Description:
+ *   Return the size of the bitmap memory of the glyph for 'fbm'.
+ *
+ ****************************************************************************/
+
+static size_t nxf_bmsize(FAR struct nxfonts_fcache_s *priv,
+                         FAR const struct nx_fontbitmap_s *fbm)
+{
+  unsigned int width  = fbm->metric.width + fbm->metric.xoffset;
+  unsigned int height = fbm->metric.height + fbm->metric.yoffset;
+
+  return (size_t)((width * priv->bpp + 7) >> 3) * height;
+}
+
+/****************************************************************************
+ * Name: nxf_drawglyph
+ *
+ * Description:
+ *   Render the bitmap font into the glyph memory.
+ *
+ ****************************************************************************/
+
+static int nxf_drawglyph(FAR struct nxfonts_fcache_s *priv,
+                         FAR struct nxfonts_glyph_s *glyph,
+                         FAR const struct nx_fontbitmap_s *fbm, uint8_t ch)
+{
+  /* Save the character code, dimensions, and physcial width of the glyph */
+
+  glyph->code   = ch;
+  glyph->width  = fbm->metric.width + fbm->metric.xoffset;
+  glyph->height = fbm->metric.height + fbm->metric.yoffset;
+  glyph->stride = (glyph->width * priv->bpp + 7) >> 3;
+
+  /* Initialize the glyph memory to the background color. */
+
+  nxf_fillglyph(priv, glyph);
+
+  /* Then render the glyph into the allocated, initialized memory */
+
+  return priv->renderer((FAR nxgl_mxpixel_t *)glyph->bitmap,
+                        glyph->height, glyph->width, glyph->stride,
+                        fbm, priv->fgcolor);
+}
+
+/****************************************************************************
+ * Name: nxf_reserve and nxf_unreserve
+ *
+ * Description:
+ *   Account the memory of a new glyph against the global limit.  If the
+ *   limit would be exceeded, the least recently used glyphs of this font
+ *   cache are freed first.  A font cache may always hold one glyph.
+ *
+ * Assumptions:
+ *   The caller holds the font cache semaphore.
+ *
+ ****************************************************************************/
+
+#if CONFIG_NXFONTS_CACHE_SIZE > 0
+static void nxf_reserve(FAR struct nxfonts_fcache_s *priv, size_t size)
+{
+  FAR struct nxfonts_glyph_s *glyph;
+  FAR struct nxfonts_glyph_s *prev;
+
+  nxf_list_lock();
+
+  while (g_cachebytes + size > CONFIG_NXFONTS_CACHE_SIZE &&
+         priv->tail != NULL)
+    {
+      /* The least recently used glyph is at the tail of the list */
+
+      for (prev = NULL, glyph = priv->head;
+           glyph != priv->tail;
+           prev = glyph, glyph = glyph->flink);
+
+      nxf_removeglyph(priv, glyph, prev);
+      g_cachebytes -= NXFONTS_GLYPHSIZE(glyph);
+      lib_free(glyph);
+    }
+
+  g_cachebytes += size;
+  nxf_list_unlock();
+}
+
+static void nxf_unreserve(size_t size)
+{
+  nxf_list_lock();
+  g_cachebytes -= size;
+  nxf_list_unlock();
+}
+#else
+#  define nxf_reserve(p,s)
+#  define nxf_unreserve(s)
+#endif
+
 /****************************************************************************
  * Name: nxf_renderglyph
  *
@@ -521,54 +676,30 @@ static inline FAR struct nxfonts_glyph_s *
                   FAR const struct nx_fontbitmap_s *fbm, uint8_t ch)
 {
   FAR struct nxfonts_glyph_s *glyph = NULL;
-  size_t bmsize;
-  unsigned int height;
-  unsigned int width;
-  unsigned int stride;
+  size_t size;
   int ret;
 
   ginfo("fcache=%p fbm=%p ch=%c (%02x)\n",
         priv, fbm, (ch >= 32 && ch < 128) ? ch : '.', ch);
 
-  /* Get the size of the glyph */
-
-  width  = fbm->metric.width + fbm->metric.xoffset;
-  height = fbm->metric.height + fbm->metric.yoffset;
-
-  /* Get the physical width of the glyph in bytes */
-
-  stride = (width * priv->bpp + 7) >> 3;
-
   /* Allocate the glyph (always succeeds) */
 
-  bmsize = stride * height;
-  glyph  = (FAR struct nxfonts_glyph_s *)
-    lib_malloc(SIZEOF_NXFONTS_GLYPH_S(bmsize));
+  size = SIZEOF_NXFONTS_GLYPH_S(nxf_bmsize(priv, fbm));
+  nxf_reserve(priv, size);
 
+  glyph = (FAR struct nxfonts_glyph_s *)lib_malloc(size);
   if (glyph != NULL)
     {
-      /* Save the character code, dimensions, and physcial width of the glyph */
+      /* Render the glyph into the allocated memory */
 
-      glyph->code   = ch;
-      glyph->width  = width;
-      glyph->height = height;
-      glyph->stride = stride;
-
-      /* Initialize the glyph memory to the background color. */
-
-      nxf_fillglyph(priv, glyph);
-
-      /* Then render the glyph into the allocated, initialized memory */
-
-      ret = priv->renderer((FAR nxgl_mxpixel_t *)glyph->bitmap,
-                           glyph->height, glyph->width, glyph->stride,
-                           fbm, priv->fgcolor);
+      ret = nxf_drawglyph(priv, glyph, fbm, ch);
       if (ret < 0)
         {
           /* Actually, the renderer never returns a failure */
 
           gerr("ERROR: nxf_renderglyph: Renderer failed\n");
           lib_free(glyph);
+          nxf_unreserve(size);
           return NULL;
         }
 
@@ -576,10 +707,79 @@ static inline FAR struct nxfonts_glyph_s *
 
       nxf_addglyph(priv, glyph);
     }
+  else
+    {
+      nxf_unreserve(size);
+    }
 
   return glyph;
 }
 
+/****************************************************************************
+ * Name: nxf_renderatlas
+ *
+ * Description:
+ *   Render the glyphs of all printable ASCII characters of the font into a
+ *   single allocation.  The allocation begins with the table of the
+ *   glyphs, indexed by character code.
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_NXFONTS_CACHE_ATLAS
+static void nxf_renderatlas(FAR struct nxfonts_fcache_s *priv)
+{
+  FAR const struct nx_fontbitmap_s *fbm;
+  FAR struct nxfonts_glyph_s *glyph;
+  FAR uint8_t *mem;
+  size_t size;
+  int ch;
+
+  /* Get the size of the table and of all glyphs */
+
+  size = NXFONTS_ALIGN_UP(NXFONTS_ATLAS_NCHARS *
+                          sizeof(FAR struct nxfonts_glyph_s *));
+
+  for (ch = NXFONTS_ATLAS_FIRST; ch <= NXFONTS_ATLAS_LAST; ch++)
+    {
+      fbm = nxf_getbitmap(priv->font, ch);
+      if (fbm != NULL)
+        {
+          size += NXFONTS_ALIGN_UP(
+                    SIZEOF_NXFONTS_GLYPH_S(nxf_bmsize(priv, fbm)));
+        }
+    }
+
+  mem = (FAR uint8_t *)lib_zalloc(size);
+  if (mem == NULL)
+    {
+      /* Not fatal.  All glyphs will go through the glyph cache. */
+
+      gwarn("WARNING: Failed to allocate %lu byte atlas\n",
+            (unsigned long)size);
+      return;
+    }
+
+  priv->atlas = (FAR struct nxfonts_glyph_s **)mem;
+  mem += NXFONTS_ALIGN_UP(NXFONTS_ATLAS_NCHARS *
+                          sizeof(FAR struct nxfonts_glyph_s *));
+
+  /* Then render each glyph.  Characters without a glyph remain NULL. */
+
+  for (ch = NXFONTS_ATLAS_FIRST; ch <= NXFONTS_ATLAS_LAST; ch++)
+    {
+      fbm = nxf_getbitmap(priv->font, ch);
+      if (fbm != NULL)
+        {
+          glyph = (FAR struct nxfonts_glyph_s *)mem;
+          nxf_drawglyph(priv, glyph, fbm, ch);
+
+          priv->atlas[ch - NXFONTS_ATLAS_FIRST] = glyph;
+          mem += NXFONTS_ALIGN_UP(NXFONTS_GLYPHSIZE(glyph));
+        }
+    }
+}
+#endif
+
 /****************************************************************************
  * Name: nxf_findcache
  *
@@ -756,6 +956,12 @@ FCACHE nxf_cache_connect(enum nx_fontid_e fontid,
 
       _SEM_INIT(&priv->fsem, 0, 1);
 
+#ifdef CONFIG_NXFONTS_CACHE_ATLAS
+      /* Pre-render the printable characters */
+
+      nxf_renderatlas(priv);
+#endif
+
       /* Add the new font cache to the list of font caches */
 
       priv->flink = g_fcaches;
@@ -847,8 +1053,15 @@ void nxf_cache_disconnect(FCACHE fhandle)
       for (glyph = priv->head; glyph != NULL; glyph = next)
         {
           next = glyph->flink;
-          lib_free(glyph);
+          nxf_freeglyph(glyph);
+        }
+
+#ifdef CONFIG_NXFONTS_CACHE_ATLAS
+      if (priv->atlas != NULL)
+        {
+          lib_free(priv->atlas);
         }
+#endif
 
       /* Destroy the serializing semaphore... while we are holding it? */
 
@@ -917,6 +1130,18 @@ FAR const struct nxfonts_glyph_s *nxf_cache_getglyph(FCACHE fhandle, uint8_t ch)
 
   ginfo("ch=%c (%02x)\n", (ch >= 32 && ch < 128) ? ch : '.', ch);
 
+#ifdef CONFIG_NXFONTS_CACHE_ATLAS
+  /* The atlas never changes once the font cache has been created, so the
+   * printable characters need neither the semaphore nor a search.
+   */
+
+  if (priv->atlas != NULL &&
+      ch >= NXFONTS_ATLAS_FIRST && ch <= NXFONTS_ATLAS_LAST)
+    {
+      return priv->atlas[ch - NXFONTS_ATLAS_FIRST];
+    }
+#endif
+
   /* Get exclusive access to the font cache */
 
   nxf_cache_lock(priv);
@@ -83,6 +83,30 @@
 #endif
 #endif /* CONFIG_DEBUG_FEATURES && CONFIG_IOB_DEBUG */
 
+/* Free notifications are sent each time the number of available IOBs
+ * reaches a multiple of IOB_DIVIDER.
+ */
+
+#ifdef CONFIG_IOB_NOTIFIER
+#  if !defined(CONFIG_IOB_NOTIFIER_DIV) || CONFIG_IOB_NOTIFIER_DIV < 2
+#    define IOB_DIVIDER 1
+#  elif CONFIG_IOB_NOTIFIER_DIV < 4
+#    define IOB_DIVIDER 2
+#  elif CONFIG_IOB_NOTIFIER_DIV < 8
+#    define IOB_DIVIDER 4
+#  elif CONFIG_IOB_NOTIFIER_DIV < 16
+#    define IOB_DIVIDER 8
+#  elif CONFIG_IOB_NOTIFIER_DIV < 32
+#    define IOB_DIVIDER 16
+#  elif CONFIG_IOB_NOTIFIER_DIV < 64
+#    define IOB_DIVIDER 32
+#  else
+#    define IOB_DIVIDER 64
+#  endif
+
+#  define IOB_MASK      (IOB_DIVIDER - 1)
+#endif
+
 /****************************************************************************
  * Public Data
  ****************************************************************************/
@@ -115,6 +139,21 @@ extern sem_t g_throttle_sem;  /* Counts available I/O buffers when throttled */
 extern sem_t g_qentry_sem;    /* Counts free I/O buffer queue containers */
 #endif
 
+#ifdef CONFIG_IOB_LARGE
+/* Free lists of the larger I/O buffer classes.  These buffers are not
+ * counted by g_iob_sem and are never waited for.
+ */
+
+struct iob_class_s
+{
+  FAR struct iob_s *ic_freelist;  /* Free buffers of this class */
+  uint16_t ic_bufsize;            /* Payload size of each buffer */
+  uint16_t ic_nfree;              /* Number of buffers in ic_freelist */
+};
+
+extern struct iob_class_s g_iob_classes[IOB_NCLASSES];
+#endif
+
 /****************************************************************************
  * Public Function Prototypes
  ****************************************************************************/
@@ -218,5 +257,46 @@ void iob_stats_onalloc(enum iob_user_e consumerid);
 void iob_stats_onfree(enum iob_user_e producerid);
 #endif
 
+/****************************************************************************
+ * Name: iob_class_initialize
+ *
+ * Description:
+ *   Set up the storage and free lists of the larger I/O buffer classes.
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_IOB_LARGE
+void iob_class_initialize(void);
+#endif
+
+/****************************************************************************
+ * Name: iob_tryalloc_large
+ *
+ * Description:
+ *   Try to allocate a buffer from the larger I/O buffer classes for 'size'
+ *   bytes:  The smallest class that holds 'size' is taken if it has a free
+ *   buffer, else the largest class with a free buffer.  NULL is returned if
+ *   all of the larger classes are exhausted.  Never waits.
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_IOB_LARGE
+FAR struct iob_s *iob_tryalloc_large(unsigned int size,
+                                     enum iob_user_e consumerid);
+#endif
+
+/****************************************************************************
+ * Name: iob_free_large
+ *
+ * Description:
+ *   Return a buffer of one of the larger classes to the free list of its
+ *   class.
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_IOB_LARGE
+void iob_free_large(FAR struct iob_s *iob, enum iob_user_e producerid);
+#endif
+
 #endif /* CONFIG_MM_IOB */
 #endif /* __MM_IOB_IOB_H */
@@ -0,0 +1,211 @@
+/****************************************************************************
+ * mm/iob/iob_alloc_batch.c
+ *
+ *   Copyright (C) 2020 Gregory Nutt. All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in
+ *    the documentation and/or other materials provided with the
+ *    distribution.
+ * 3. Neither the name NuttX nor the names of its contributors may be
+ *    used to endorse or promote products derived from this software
+ *    without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+ * FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE
+ * COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+ * INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,
+ * BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS
+ * OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED
+ * AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ * LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN
+ * ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ *
+ ****************************************************************************/
+
+/****************************************************************************
+ * Included Files
+ ****************************************************************************/
+
+#include <nuttx/config.h>
+
+#include <stdbool.h>
+#include <assert.h>
+
+#include <nuttx/irq.h>
+#include <nuttx/arch.h>
+#include <nuttx/sched.h>
+#include <nuttx/mm/iob.h>
+
+#include "iob.h"
+
+/****************************************************************************
+ * Public Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: iob_tryalloc_batch
+ *
+ * Description:
+ *   Try to allocate a chain of 'n' I/O buffers with a single critical
+ *   section and a single adjustment of the IOB counting semaphores.  The
+ *   allocation is all-or-nothing:  NULL is returned without waiting if
+ *   fewer than 'n' buffers are available.
+ *
+ ****************************************************************************/
+
+FAR struct iob_s *iob_tryalloc_batch(int n, bool throttled,
+                                     enum iob_user_e consumerid)
+{
+  FAR struct iob_s *head;
+  FAR struct iob_s *iob;
+  irqstate_t flags;
+  int i;
+
+  DEBUGASSERT(n > 0);
+
+  /* We don't know what context we are called from so we use extreme measures
+   * to protect the free list:  We disable interrupts very briefly.
+   */
+
+  flags = enter_critical_section();
+
+  /* The IOB semaphore count is exactly the length of the free list whenever
+   * it is non-negative, so it tells us up front whether the whole batch can
+   * be satisfied.
+   */
+
+  if (g_iob_sem.semcount < n
+#if CONFIG_IOB_THROTTLE > 0
+      || (throttled && g_throttle_sem.semcount < n)
+#endif
+     )
+    {
+      leave_critical_section(flags);
+      return NULL;
+    }
+
+  /* Detach the first 'n' I/O buffers from the head of the free list */
+
+  head = g_iob_freelist;
+  iob  = head;
+
+  for (i = 1; i < n; i++)
+    {
+      DEBUGASSERT(iob != NULL);
+      iob = iob->io_flink;
+    }
+
+  DEBUGASSERT(iob != NULL);
+  g_iob_freelist = iob->io_flink;
+  iob->io_flink  = NULL;
+
+  /* Take all 'n' semaphore counts at once.  As in iob_tryalloc(), we cannot
+   * use nxsem_wait() because this function may be called from an interrupt
+   * handler, but we know that the buffers are there.
+   */
+
+  g_iob_sem.semcount -= n;
+  DEBUGASSERT(g_iob_sem.semcount >= 0);
+
+#if CONFIG_IOB_THROTTLE > 0
+  g_throttle_sem.semcount -= n;
+  DEBUGASSERT(g_throttle_sem.semcount >= -CONFIG_IOB_THROTTLE);
+#endif
+
+#if !defined(CONFIG_DISABLE_MOUNTPOINT) && defined(CONFIG_FS_PROCFS) && \
+    defined(CONFIG_MM_IOB) && !defined(CONFIG_FS_PROCFS_EXCLUDE_IOBINFO)
+  for (i = 0; i < n; i++)
+    {
+      iob_stats_onalloc(consumerid);
+    }
+#endif
+
+  leave_critical_section(flags);
+
+  /* Put each I/O buffer in a known state.  The links are preserved so that
+   * the batch is returned as a chain.
+   */
+
+  for (iob = head; iob != NULL; iob = iob->io_flink)
+    {
+      iob->io_len    = 0;    /* Length of the data in the entry */
+      iob->io_offset = 0;    /* Offset to the beginning of data */
+      iob->io_pktlen = 0;    /* Total length of the packet */
+    }
+
+  return head;
+}
+
+/****************************************************************************
+ * Name: iob_alloc_batch
+ *
+ * Description:
+ *   Allocate a chain of 'n' I/O buffers.  The batch is taken in one step
+ *   with iob_tryalloc_batch() when possible; otherwise the buffers are
+ *   allocated one at a time, waiting as iob_alloc() does.  NULL is returned
+ *   (and no buffers are held) if the chain could not be completed.
+ *
+ ****************************************************************************/
+
+FAR struct iob_s *iob_alloc_batch(int n, bool throttled,
+                                  enum iob_user_e consumerid)
+{
+  FAR struct iob_s *head;
+  FAR struct iob_s *tail;
+  FAR struct iob_s *iob;
+  int i;
+
+  /* Try the fast path first */
+
+  head = iob_tryalloc_batch(n, throttled, consumerid);
+  if (head != NULL)
+    {
+      return head;
+    }
+
+  /* Fall back to allocating the buffers one at a time.  iob_alloc() will
+   * not wait if we are in an interrupt handler or on the IDLE thread.
+   */
+
+  tail = NULL;
+  for (i = 0; i < n; i++)
+    {
+      iob = iob_alloc(throttled, consumerid);
+      if (iob == NULL)
+        {
+          /* Return the partial chain so that we do not hold buffers that
+           * some other allocation may be waiting for.
+           */
+
+          if (head != NULL)
+            {
+              iob_free_batch(head, consumerid);
+            }
+
+          return NULL;
+        }
+
+      if (tail == NULL)
+        {
+          head = iob;
+        }
+      else
+        {
+          tail->io_flink = iob;
+        }
+
+      tail = iob;
+    }
+
+  return head;
+}
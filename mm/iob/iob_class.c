@@ -0,0 +1,265 @@
+/****************************************************************************
+ * mm/iob/iob_class.c
+ *
+ *   Copyright (C) 2020 Gregory Nutt. All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in
+ *    the documentation and/or other materials provided with the
+ *    distribution.
+ * 3. Neither the name NuttX nor the names of its contributors may be
+ *    used to endorse or promote products derived from this software
+ *    without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+ * FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE
+ * COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+ * INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,
+ * BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS
+ * OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED
+ * AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ * LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN
+ * ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ *
+ ****************************************************************************/
+
+/****************************************************************************
+ * Included Files
+ ****************************************************************************/
+
+#include <nuttx/config.h>
+
+#include <stdint.h>
+#include <assert.h>
+
+#include <nuttx/irq.h>
+#include <nuttx/mm/iob.h>
+
+#include "iob.h"
+
+#ifdef CONFIG_IOB_LARGE
+
+/****************************************************************************
+ * Private Data
+ ****************************************************************************/
+
+/* Pre-allocated buffers and payload storage of the larger classes */
+
+#if CONFIG_IOB_NMTU > 0
+static struct iob_s g_iob_mtupool[CONFIG_IOB_NMTU];
+static uint8_t g_iob_mtudata[CONFIG_IOB_NMTU][CONFIG_IOB_MTU_BUFSIZE];
+#endif
+
+#if CONFIG_IOB_NJUMBO > 0
+static struct iob_s g_iob_jumbopool[CONFIG_IOB_NJUMBO];
+static uint8_t g_iob_jumbodata[CONFIG_IOB_NJUMBO][CONFIG_IOB_JUMBO_BUFSIZE];
+#endif
+
+/****************************************************************************
+ * Public Data
+ ****************************************************************************/
+
+/* Free lists of the larger classes.  The IOB_CLASS_SMALL entry is unused:
+ * small buffers live on g_iob_freelist.
+ */
+
+struct iob_class_s g_iob_classes[IOB_NCLASSES];
+
+/****************************************************************************
+ * Private Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: iob_class_addpool
+ *
+ * Description:
+ *   Add 'nbuffers' buffers of one class to the free list of the class.
+ *
+ ****************************************************************************/
+
+static void iob_class_addpool(int ioclass, FAR struct iob_s *pool,
+                              FAR uint8_t *data, int nbuffers)
+{
+  FAR struct iob_class_s *ic = &g_iob_classes[ioclass];
+  int i;
+
+  for (i = 0; i < nbuffers; i++)
+    {
+      FAR struct iob_s *iob = &pool[i];
+
+      iob->io_class   = ioclass;
+      iob->io_bufsize = ic->ic_bufsize;
+      iob->io_data    = &data[i * ic->ic_bufsize];
+
+      iob->io_flink   = ic->ic_freelist;
+      ic->ic_freelist = iob;
+    }
+
+  ic->ic_nfree = nbuffers;
+}
+
+/****************************************************************************
+ * Name: iob_tryalloc_class
+ *
+ * Description:
+ *   Take a buffer from the free list of one of the larger classes.
+ *
+ ****************************************************************************/
+
+static FAR struct iob_s *iob_tryalloc_class(int ioclass,
+                                            enum iob_user_e consumerid)
+{
+  FAR struct iob_class_s *ic = &g_iob_classes[ioclass];
+  FAR struct iob_s *iob;
+  irqstate_t flags;
+
+  flags = enter_critical_section();
+
+  iob = ic->ic_freelist;
+  if (iob != NULL)
+    {
+      ic->ic_freelist = iob->io_flink;
+      ic->ic_nfree--;
+
+#if !defined(CONFIG_DISABLE_MOUNTPOINT) && defined(CONFIG_FS_PROCFS) && \
+    defined(CONFIG_MM_IOB) && !defined(CONFIG_FS_PROCFS_EXCLUDE_IOBINFO)
+      iob_stats_onalloc(consumerid);
+#endif
+    }
+
+  leave_critical_section(flags);
+
+  if (iob != NULL)
+    {
+      /* Put the I/O buffer in a known state */
+
+      iob->io_flink  = NULL; /* Not in a chain */
+      iob->io_len    = 0;    /* Length of the data in the entry */
+      iob->io_offset = 0;    /* Offset to the beginning of data */
+      iob->io_pktlen = 0;    /* Total length of the packet */
+    }
+
+  return iob;
+}
+
+/****************************************************************************
+ * Public Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: iob_class_initialize
+ *
+ * Description:
+ *   Set up the storage and free lists of the larger I/O buffer classes.
+ *
+ ****************************************************************************/
+
+void iob_class_initialize(void)
+{
+  g_iob_classes[IOB_CLASS_SMALL].ic_bufsize = CONFIG_IOB_BUFSIZE;
+  g_iob_classes[IOB_CLASS_MTU].ic_bufsize   = CONFIG_IOB_MTU_BUFSIZE;
+  g_iob_classes[IOB_CLASS_JUMBO].ic_bufsize = CONFIG_IOB_JUMBO_BUFSIZE;
+
+#if CONFIG_IOB_NMTU > 0
+  iob_class_addpool(IOB_CLASS_MTU, g_iob_mtupool, &g_iob_mtudata[0][0],
+                    CONFIG_IOB_NMTU);
+#endif
+
+#if CONFIG_IOB_NJUMBO > 0
+  iob_class_addpool(IOB_CLASS_JUMBO, g_iob_jumbopool,
+                    &g_iob_jumbodata[0][0], CONFIG_IOB_NJUMBO);
+#endif
+}
+
+/****************************************************************************
+ * Name: iob_tryalloc_large
+ *
+ * Description:
+ *   Try to allocate a buffer from the larger I/O buffer classes for 'size'
+ *   bytes:  The smallest class that holds 'size' is taken if it has a free
+ *   buffer, else the largest class with a free buffer.  NULL is returned if
+ *   all of the larger classes are exhausted.  Never waits.
+ *
+ ****************************************************************************/
+
+FAR struct iob_s *iob_tryalloc_large(unsigned int size,
+                                     enum iob_user_e consumerid)
+{
+  FAR struct iob_s *iob;
+  int ioclass;
+
+  /* First, the smallest class that holds all of the data in one buffer */
+
+  for (ioclass = IOB_CLASS_MTU; ioclass < IOB_NCLASSES; ioclass++)
+    {
+      if (g_iob_classes[ioclass].ic_bufsize >= size)
+        {
+          iob = iob_tryalloc_class(ioclass, consumerid);
+          if (iob != NULL)
+            {
+              return iob;
+            }
+        }
+    }
+
+  /* Then the largest class that still has a free buffer.  The data will
+   * need to be chained, but into fewer buffers than with small ones.
+   */
+
+  for (ioclass = IOB_NCLASSES - 1; ioclass > IOB_CLASS_SMALL; ioclass--)
+    {
+      if (g_iob_classes[ioclass].ic_bufsize < size)
+        {
+          iob = iob_tryalloc_class(ioclass, consumerid);
+          if (iob != NULL)
+            {
+              return iob;
+            }
+        }
+    }
+
+  return NULL;
+}
+
+/****************************************************************************
+ * Name: iob_free_large
+ *
+ * Description:
+ *   Return a buffer of one of the larger classes to the free list of its
+ *   class.
+ *
+ ****************************************************************************/
+
+void iob_free_large(FAR struct iob_s *iob, enum iob_user_e producerid)
+{
+  FAR struct iob_class_s *ic;
+  irqstate_t flags;
+
+  DEBUGASSERT(iob->io_class > IOB_CLASS_SMALL &&
+              iob->io_class < IOB_NCLASSES);
+  ic = &g_iob_classes[iob->io_class];
+
+  flags = enter_critical_section();
+
+  iob->io_flink   = ic->ic_freelist;
+  ic->ic_freelist = iob;
+  ic->ic_nfree++;
+
+#if !defined(CONFIG_DISABLE_MOUNTPOINT) && defined(CONFIG_FS_PROCFS) && \
+    defined(CONFIG_MM_IOB) && !defined(CONFIG_FS_PROCFS_EXCLUDE_IOBINFO)
+  iob_stats_onfree(producerid);
+#endif
+
+  leave_critical_section(flags);
+}
+
+#endif /* CONFIG_IOB_LARGE */
@@ -53,11 +53,15 @@
  * Name: iob_concat
  *
  * Description:
- *   Concatenate iob_s chain iob2 to iob1.
+ *   Concatenate iob_s chain iob2 to iob1.  Leading buffers of iob2 whose
+ *   data fits in the free space of the last buffer of iob1 are copied into
+ *   it and freed.  This lets a buffer of a larger class absorb a run of
+ *   small buffers instead of extending the chain.
  *
  ****************************************************************************/
 
-void iob_concat(FAR struct iob_s *iob1, FAR struct iob_s *iob2)
+void iob_concat(FAR struct iob_s *iob1, FAR struct iob_s *iob2,
+                enum iob_user_e producerid)
 {
   /* Combine the total packet size */
 
@@ -71,7 +75,20 @@ void iob_concat(FAR struct iob_s *iob1, FAR struct iob_s *iob2)
       iob1 = iob1->io_flink;
     }
 
-  /* Then connect iob2 buffer chain to the end of the iob1 chain */
+  /* Pack whole buffers from the head of iob2 into the tail of iob1 */
+
+  while (iob2 != NULL && iob2->io_len <= IOB_FREESPACE(iob1))
+    {
+      memcpy(&iob1->io_data[iob1->io_offset + iob1->io_len],
+             IOB_DATA(iob2), iob2->io_len);
+      iob1->io_len += iob2->io_len;
+
+      iob2 = iob_free(iob2, producerid);
+    }
+
+  /* Then connect the rest of the iob2 buffer chain to the end of the iob1
+   * chain
+   */
 
   iob1->io_flink = iob2;
 }
@@ -77,10 +77,11 @@ int iob_contig(FAR struct iob_s *iob, unsigned int len,
 
   /* We can't make more contiguous space that the size of one I/O buffer.
    * If you get this assertion and really need that much contiguous data,
-   * then you will need to increase CONFIG_IOB_BUFSIZE.
+   * then you will need to increase CONFIG_IOB_BUFSIZE or start the chain
+   * with a buffer of a larger class.
    */
 
-  DEBUGASSERT(len <= CONFIG_IOB_BUFSIZE);
+  DEBUGASSERT(len <= IOB_BUFSIZE(iob));
 
   /* Check if there is already sufficient, contiguous space at the beginning
    * of the packet
@@ -142,7 +143,7 @@ int iob_contig(FAR struct iob_s *iob, unsigned int len,
 
       /* This should always succeed because we know that:
        *
-       *   pktlen >= CONFIG_IOB_BUFSIZE >= len
+       *   pktlen >= IOB_BUFSIZE(iob) >= len
        */
 
       return 0;
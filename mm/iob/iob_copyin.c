@@ -50,9 +50,64 @@
 #include "iob.h"
 
 /****************************************************************************
- * Public Functions
+ * Private Functions
  ****************************************************************************/
 
+/****************************************************************************
+ * Name: iob_copyin_alloc
+ *
+ * Description:
+ *  Allocate the next buffer when iob_copyin_internal() extends the chain
+ *  by 'len' more bytes.  One buffer of a larger class is preferred if the
+ *  rest of the copy will not fit in a small one.  Otherwise all of the
+ *  small buffers needed for the rest of the copy are taken in one batch and
+ *  handed out from 'spare'.  Each new buffer starts at offset zero and will
+ *  be filled completely, so the batch is consumed exactly.  Failing that,
+ *  buffers are allocated one at a time.
+ *
+ ****************************************************************************/
+
+static FAR struct iob_s *iob_copyin_alloc(FAR struct iob_s **spare,
+                                          unsigned int len, bool throttled,
+                                          bool can_block,
+                                          enum iob_user_e consumerid)
+{
+  FAR struct iob_s *iob;
+
+#ifdef CONFIG_IOB_LARGE
+  if (*spare == NULL && len > CONFIG_IOB_BUFSIZE)
+    {
+      iob = iob_tryalloc_large(len, consumerid);
+      if (iob != NULL)
+        {
+          return iob;
+        }
+    }
+#endif
+
+  if (*spare == NULL)
+    {
+      *spare = iob_tryalloc_batch((len + CONFIG_IOB_BUFSIZE - 1) /
+                                  CONFIG_IOB_BUFSIZE,
+                                  throttled, consumerid);
+    }
+
+  if (*spare != NULL)
+    {
+      iob           = *spare;
+      *spare        = iob->io_flink;
+      iob->io_flink = NULL;
+      return iob;
+    }
+
+  if (can_block)
+    {
+      return iob_alloc(throttled, consumerid);
+    }
+
+  return iob_tryalloc(throttled, consumerid);
+}
+
 /****************************************************************************
  * Name: iob_copyin_internal
  *
@@ -71,6 +126,7 @@ static int iob_copyin_internal(FAR struct iob_s *iob, FAR const uint8_t *src,
                                enum iob_user_e consumerid)
 {
   FAR struct iob_s *head = iob;
+  FAR struct iob_s *spare = NULL;
   FAR struct iob_s *next;
   FAR uint8_t *dest;
   unsigned int ncopy;
@@ -135,7 +191,7 @@ static int iob_copyin_internal(FAR struct iob_s *iob, FAR const uint8_t *src,
 
               /* Yes.. We can extend this buffer to the up to the very end. */
 
-              maxlen = CONFIG_IOB_BUFSIZE - iob->io_offset;
+              maxlen = IOB_BUFSIZE(iob) - iob->io_offset;
 
               /* This is the new buffer length that we need.  Of course,
                * clipped to the maximum possible size in this buffer.
@@ -188,15 +244,8 @@ static int iob_copyin_internal(FAR struct iob_s *iob, FAR const uint8_t *src,
            * Copy as many bytes as possible. Block if we're allowed.
            */
 
-          if (can_block)
-            {
-              next = iob_alloc(throttled, consumerid);
-            }
-          else
-            {
-              next = iob_tryalloc(throttled, consumerid);
-            }
-
+          next = iob_copyin_alloc(&spare, len, throttled, can_block,
+                                  consumerid);
           if (next == NULL)
             {
               ioberr("ERROR: Failed to allocate I/O buffer\n");
@@ -213,6 +262,7 @@ static int iob_copyin_internal(FAR struct iob_s *iob, FAR const uint8_t *src,
       offset = 0;
     }
 
+  DEBUGASSERT(spare == NULL);
   return total;
 }
 
@@ -49,30 +49,6 @@
 
 #include "iob.h"
 
-/****************************************************************************
- * Pre-processor Definitions
- ****************************************************************************/
-
-#ifdef CONFIG_IOB_NOTIFIER
-#  if !defined(CONFIG_IOB_NOTIFIER_DIV) || CONFIG_IOB_NOTIFIER_DIV < 2
-#    define IOB_DIVIDER 1
-#  elif CONFIG_IOB_NOTIFIER_DIV < 4
-#    define IOB_DIVIDER 2
-#  elif CONFIG_IOB_NOTIFIER_DIV < 8
-#    define IOB_DIVIDER 4
-#  elif CONFIG_IOB_NOTIFIER_DIV < 16
-#    define IOB_DIVIDER 8
-#  elif CONFIG_IOB_NOTIFIER_DIV < 32
-#    define IOB_DIVIDER 16
-#  elif CONFIG_IOB_NOTIFIER_DIV < 64
-#    define IOB_DIVIDER 32
-#  else
-#    define IOB_DIVIDER 64
-#  endif
-#endif
-
-#define IOB_MASK      (IOB_DIVIDER - 1)
-
 /****************************************************************************
  * Public Functions
  ****************************************************************************/
@@ -128,6 +104,16 @@ FAR struct iob_s *iob_free(FAR struct iob_s *iob,
               next, next->io_pktlen, next->io_len);
     }
 
+#ifdef CONFIG_IOB_LARGE
+  /* Buffers of the larger classes go back to their own free list */
+
+  if (iob->io_class != IOB_CLASS_SMALL)
+    {
+      iob_free_large(iob, producerid);
+      return next;
+    }
+#endif
+
   /* Free the I/O buffer by adding it to the head of the free or the
    * committed list. We don't know what context we are called from so
    * we use extreme measures to protect the free list:  We disable
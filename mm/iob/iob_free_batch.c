@@ -0,0 +1,208 @@
+/****************************************************************************
+ * mm/iob/iob_free_batch.c
+ *
+ *   Copyright (C) 2020 Gregory Nutt. All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in
+ *    the documentation and/or other materials provided with the
+ *    distribution.
+ * 3. Neither the name NuttX nor the names of its contributors may be
+ *    used to endorse or promote products derived from this software
+ *    without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+ * FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE
+ * COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+ * INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,
+ * BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS
+ * OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED
+ * AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ * LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN
+ * ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ *
+ ****************************************************************************/
+
+/****************************************************************************
+ * Included Files
+ ****************************************************************************/
+
+#include <nuttx/config.h>
+
+#include <stdbool.h>
+#include <assert.h>
+#include <debug.h>
+
+#include <nuttx/irq.h>
+#include <nuttx/arch.h>
+#include <nuttx/mm/iob.h>
+
+#include "iob.h"
+
+/****************************************************************************
+ * Public Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: iob_free_batch
+ *
+ * Description:
+ *   Free an entire buffer chain, returning all of its I/O buffers to the
+ *   free list with a single critical section.  Buffers needed by waiting
+ *   tasks are handed over through the committed list first; the remainder
+ *   are spliced onto the free list with one semaphore count adjustment.
+ *
+ ****************************************************************************/
+
+void iob_free_batch(FAR struct iob_s *iob, enum iob_user_e producerid)
+{
+  FAR struct iob_s *next;
+  FAR struct iob_s *tail;
+#ifdef CONFIG_IOB_LARGE
+  FAR struct iob_s **link;
+#endif
+  irqstate_t flags;
+  int16_t nfree = 0;
+#ifdef CONFIG_IOB_NOTIFIER
+  int16_t navail;
+  int16_t prev;
+#endif
+
+  if (iob == NULL)
+    {
+      return;
+    }
+
+  iobinfo("iob=%p io_pktlen=%u\n", iob, iob->io_pktlen);
+
+  /* We don't know what context we are called from so we use extreme
+   * measures to protect the free list:  We disable interrupts very briefly.
+   */
+
+  flags = enter_critical_section();
+
+#ifdef CONFIG_IOB_LARGE
+  /* Return any buffers of the larger classes to their own free lists,
+   * leaving only small buffers in the chain.
+   */
+
+  for (link = &iob; *link != NULL; )
+    {
+      next = *link;
+      if (next->io_class != IOB_CLASS_SMALL)
+        {
+          *link = next->io_flink;
+          iob_free_large(next, producerid);
+        }
+      else
+        {
+          link = &next->io_flink;
+        }
+    }
+#endif
+
+  /* While tasks are waiting for an IOB, each buffer must be reserved for
+   * one of them on the committed list and the waiter woken, exactly as
+   * iob_free() does.
+   */
+
+  while (iob != NULL && g_iob_sem.semcount < 0)
+    {
+      next            = iob->io_flink;
+      iob->io_flink   = g_iob_committed;
+      g_iob_committed = iob;
+
+      nxsem_post(&g_iob_sem);
+#if CONFIG_IOB_THROTTLE > 0
+      nxsem_post(&g_throttle_sem);
+#endif
+
+#if !defined(CONFIG_DISABLE_MOUNTPOINT) && defined(CONFIG_FS_PROCFS) && \
+    defined(CONFIG_MM_IOB) && !defined(CONFIG_FS_PROCFS_EXCLUDE_IOBINFO)
+      iob_stats_onfree(producerid);
+#endif
+
+      nfree++;
+      iob = next;
+    }
+
+  if (iob != NULL)
+    {
+      int16_t nremain = 1;
+#if !defined(CONFIG_DISABLE_MOUNTPOINT) && defined(CONFIG_FS_PROCFS) && \
+    defined(CONFIG_MM_IOB) && !defined(CONFIG_FS_PROCFS_EXCLUDE_IOBINFO)
+      int16_t i;
+#endif
+
+      /* Nobody is waiting on g_iob_sem so the rest of the chain can go
+       * straight onto the free list.  Find its tail and length.
+       */
+
+      for (tail = iob; tail->io_flink != NULL; tail = tail->io_flink)
+        {
+          nremain++;
+        }
+
+      tail->io_flink = g_iob_freelist;
+      g_iob_freelist = iob;
+
+      /* With no waiters a post is just an increment, so the count can be
+       * adjusted once for the whole remainder.
+       */
+
+      g_iob_sem.semcount += nremain;
+      DEBUGASSERT(g_iob_sem.semcount <= CONFIG_IOB_NBUFFERS);
+
+      nfree += nremain;
+
+#if !defined(CONFIG_DISABLE_MOUNTPOINT) && defined(CONFIG_FS_PROCFS) && \
+    defined(CONFIG_MM_IOB) && !defined(CONFIG_FS_PROCFS_EXCLUDE_IOBINFO)
+      for (i = 0; i < nremain; i++)
+        {
+          iob_stats_onfree(producerid);
+        }
+#endif
+
+#if CONFIG_IOB_THROTTLE > 0
+      /* The throttle semaphore may still have waiters; wake them one at a
+       * time and then account for the rest in a single step.
+       */
+
+      while (nremain > 0 && g_throttle_sem.semcount < 0)
+        {
+          nxsem_post(&g_throttle_sem);
+          nremain--;
+        }
+
+      g_throttle_sem.semcount += nremain;
+      DEBUGASSERT(g_throttle_sem.semcount <=
+                  (CONFIG_IOB_NBUFFERS - CONFIG_IOB_THROTTLE));
+#endif
+    }
+
+#ifdef CONFIG_IOB_NOTIFIER
+  /* Signal the notifier once if the number of available IOBs reached a
+   * multiple of IOB_DIVIDER anywhere within this batch.
+   */
+
+  navail = iob_navail(false);
+  prev   = navail > nfree ? navail - nfree : 0;
+  if (navail > 0 && (navail & ~IOB_MASK) > (prev & ~IOB_MASK))
+    {
+      iob_notifier_signal();
+    }
+#else
+  UNUSED(nfree);
+#endif
+
+  leave_critical_section(flags);
+}
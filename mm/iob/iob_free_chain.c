@@ -59,12 +59,9 @@
 
 void iob_free_chain(FAR struct iob_s *iob, enum iob_user_e producerid)
 {
-  FAR struct iob_s *next;
+  /* Return the whole chain with one critical section and one adjustment
+   * of the IOB counts.
+   */
 
-  /* Free each IOB in the chain -- one at a time to keep the count straight */
-
-  for (; iob; iob = next)
-    {
-      next = iob_free(iob, producerid);
-    }
+  iob_free_batch(iob, producerid);
 }
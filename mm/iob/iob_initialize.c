@@ -60,6 +60,9 @@
 /* This is a pool of pre-allocated I/O buffers */
 
 static struct iob_s        g_iob_pool[CONFIG_IOB_NBUFFERS];
+#ifdef CONFIG_IOB_LARGE
+static uint8_t g_iob_data[CONFIG_IOB_NBUFFERS][CONFIG_IOB_BUFSIZE];
+#endif
 #if CONFIG_IOB_NCHAINS > 0
 static struct iob_qentry_s g_iob_qpool[CONFIG_IOB_NCHAINS];
 #endif
@@ -123,6 +126,14 @@ void iob_initialize(void)
         {
           FAR struct iob_s *iob = &g_iob_pool[i];
 
+#ifdef CONFIG_IOB_LARGE
+          /* Small buffers keep their payload in a separate array */
+
+          iob->io_class   = IOB_CLASS_SMALL;
+          iob->io_bufsize = CONFIG_IOB_BUFSIZE;
+          iob->io_data    = g_iob_data[i];
+#endif
+
           /* Add the pre-allocate I/O buffer to the head of the free list */
 
           iob->io_flink  = g_iob_freelist;
@@ -131,6 +142,12 @@ void iob_initialize(void)
 
       g_iob_committed = NULL;
 
+#ifdef CONFIG_IOB_LARGE
+      /* Set up the MTU and jumbo buffer classes */
+
+      iob_class_initialize();
+#endif
+
       nxsem_init(&g_iob_sem, 0, CONFIG_IOB_NBUFFERS);
 #if CONFIG_IOB_THROTTLE > 0
       nxsem_init(&g_throttle_sem, 0, CONFIG_IOB_NBUFFERS - CONFIG_IOB_THROTTLE);
@@ -70,6 +70,8 @@
 FAR struct iob_s *iob_trimhead(FAR struct iob_s *iob, unsigned int trimlen,
                                enum iob_user_e producerid)
 {
+  FAR struct iob_s *head = iob;
+  FAR struct iob_s *last = NULL;
   uint16_t pktlen;
 
   iobinfo("iob=%p trimlen=%d\n", iob, trimlen);
@@ -112,11 +114,13 @@ FAR struct iob_s *iob_trimhead(FAR struct iob_s *iob, unsigned int trimlen,
                   break;
                 }
 
-              /* Free this entry and set the next I/O buffer as the head */
+              /* Mark this entry to be freed and set the next I/O buffer as
+               * the head.
+               */
 
               iobinfo("iob=%p: Freeing\n", iob);
-              iob_free(iob, producerid);
-              iob = next;
+              last = iob;
+              iob  = next;
             }
           else
             {
@@ -131,6 +135,16 @@ FAR struct iob_s *iob_trimhead(FAR struct iob_s *iob, unsigned int trimlen,
             }
         }
 
+      /* Free all of the emptied entries at the front of the chain in one
+       * batch.
+       */
+
+      if (last != NULL)
+        {
+          last->io_flink = NULL;
+          iob_free_batch(head, producerid);
+        }
+
       /* Adjust the pktlen by the number of bytes removed from the head
        * of the I/O buffer chain.
        */
@@ -0,0 +1,332 @@
+/****************************************************************************
+ * mm/mempool/mempool.c
+ *
+ *   Copyright (C) 2020 Gregory Nutt. All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in
+ *    the documentation and/or other materials provided with the
+ *    distribution.
+ * 3. Neither the name NuttX nor the names of its contributors may be
+ *    used to endorse or promote products derived from this software
+ *    without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+ * FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE
+ * COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+ * INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,
+ * BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS
+ * OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED
+ * AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ * LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN
+ * ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ *
+ ****************************************************************************/
+
+/****************************************************************************
+ * Included Files
+ ****************************************************************************/
+
+#include <nuttx/config.h>
+
+#include <assert.h>
+#include <errno.h>
+#include <queue.h>
+
+#include <nuttx/irq.h>
+#include <nuttx/arch.h>
+#include <nuttx/kmalloc.h>
+#include <nuttx/spinlock.h>
+#include <nuttx/mm/mempool.h>
+
+/****************************************************************************
+ * Private Data
+ ****************************************************************************/
+
+/* A list of all initialized pools, in order of initialization.  Pools are
+ * never removed from this list, so it may be traversed without locking.
+ */
+
+static FAR struct mempool_s *g_mempool_head;
+static FAR struct mempool_s *g_mempool_tail;
+
+/* Protects additions to the list of pools */
+
+static spinlock_t g_mempool_lock SP_SECTION = SP_UNLOCKED;
+
+/****************************************************************************
+ * Private Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: mempool_isprealloc
+ *
+ * Description:
+ *   Return true if the block lies in the pre-allocated storage of the pool.
+ *
+ ****************************************************************************/
+
+static inline bool mempool_isprealloc(FAR struct mempool_s *pool,
+                                      FAR void *blk)
+{
+  return (FAR char *)blk >= (FAR char *)pool->ibase &&
+         (FAR char *)blk < pool->iend;
+}
+
+/****************************************************************************
+ * Public Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: mempool_initialize
+ *
+ * Description:
+ *   Initialize a pool of fixed-size blocks.  The caller must have set up
+ *   the bsize, ninitial, nreserve, expand and ibase fields of the pool
+ *   structure.  The pool is added to the list of pools reported by procfs.
+ *
+ * Input Parameters:
+ *   pool - The pool to be initialized
+ *   name - The name of the pool.  This string must persist for the
+ *          lifetime of the pool.
+ *
+ * Returned Value:
+ *   Zero (OK) is returned on success; a negated errno value is returned on
+ *   any failure.
+ *
+ ****************************************************************************/
+
+int mempool_initialize(FAR struct mempool_s *pool, FAR const char *name)
+{
+  FAR char *blk;
+  irqstate_t flags;
+  size_t i;
+
+  DEBUGASSERT(pool != NULL && pool->bsize >= sizeof(sq_entry_t) &&
+              pool->nreserve <= pool->ninitial);
+
+  /* Allocate storage for the pre-allocated blocks if none was provided */
+
+  if (pool->ibase == NULL && pool->ninitial > 0)
+    {
+      pool->ibase = kmm_malloc(pool->bsize * pool->ninitial);
+      if (pool->ibase == NULL)
+        {
+          return -ENOMEM;
+        }
+    }
+
+  pool->name     = name;
+  pool->flink    = NULL;
+  pool->iend     = (FAR char *)pool->ibase + pool->bsize * pool->ninitial;
+  pool->nfree    = pool->ninitial;
+  pool->nused    = 0;
+  pool->nheap    = 0;
+  pool->nmaxused = 0;
+  pool->nfail    = 0;
+
+  spin_initialize(&pool->lock, SP_UNLOCKED);
+
+  /* Load the free list with all of the pre-allocated blocks */
+
+  sq_init(&pool->freelist);
+  for (i = 0, blk = pool->ibase; i < pool->ninitial; i++)
+    {
+      sq_addlast((FAR sq_entry_t *)blk, &pool->freelist);
+      blk += pool->bsize;
+    }
+
+  /* Add the pool to the end of the list of pools */
+
+  flags = spin_lock_irqsave(&g_mempool_lock);
+  if (g_mempool_tail == NULL)
+    {
+      g_mempool_head = pool;
+    }
+  else
+    {
+      g_mempool_tail->flink = pool;
+    }
+
+  g_mempool_tail = pool;
+  spin_unlock_irqrestore(&g_mempool_lock, flags);
+
+  return OK;
+}
+
+/****************************************************************************
+ * Name: mempool_alloc
+ *
+ * Description:
+ *   Allocate one block from the pool.  Interrupt handlers may take blocks
+ *   from the reserve; normal tasks may only take unreserved blocks and may
+ *   fall back to the kernel heap if the pool was configured to expand.
+ *
+ * Input Parameters:
+ *   pool - The pool to allocate from
+ *
+ * Returned Value:
+ *   The allocated block or NULL if no block is available.
+ *
+ ****************************************************************************/
+
+FAR void *mempool_alloc(FAR struct mempool_s *pool)
+{
+  FAR void *blk = NULL;
+  irqstate_t flags;
+  bool inirq = up_interrupt_context();
+
+  DEBUGASSERT(pool != NULL);
+
+  /* Take a pre-allocated block if we are in an interrupt handler -OR- if
+   * the number of free blocks exceeds the reserve.
+   */
+
+  flags = spin_lock_irqsave(&pool->lock);
+  if (pool->nfree > pool->nreserve || (inirq && pool->nfree > 0))
+    {
+      blk = sq_remfirst(&pool->freelist);
+      DEBUGASSERT(blk != NULL);
+      pool->nfree--;
+      goto out;
+    }
+
+  spin_unlock_irqrestore(&pool->lock, flags);
+
+  /* Otherwise, fall back to the kernel heap.  This is not possible from an
+   * interrupt handler.  We do not require that interrupts be disabled to
+   * do this.
+   */
+
+  if (pool->expand && !inirq)
+    {
+      blk = kmm_malloc(pool->bsize);
+    }
+
+  flags = spin_lock_irqsave(&pool->lock);
+  if (blk == NULL)
+    {
+      pool->nfail++;
+      spin_unlock_irqrestore(&pool->lock, flags);
+      return NULL;
+    }
+
+  pool->nheap++;
+
+out:
+  if (++pool->nused > pool->nmaxused)
+    {
+      pool->nmaxused = pool->nused;
+    }
+
+  spin_unlock_irqrestore(&pool->lock, flags);
+  return blk;
+}
+
+/****************************************************************************
+ * Name: mempool_free
+ *
+ * Description:
+ *   Return a block to the pool it was allocated from.  This may be called
+ *   from interrupt handlers.
+ *
+ * Input Parameters:
+ *   pool - The pool that the block was allocated from
+ *   blk  - The block to be freed
+ *
+ * Returned Value:
+ *   None
+ *
+ ****************************************************************************/
+
+void mempool_free(FAR struct mempool_s *pool, FAR void *blk)
+{
+  irqstate_t flags;
+
+  DEBUGASSERT(pool != NULL && blk != NULL);
+
+  flags = spin_lock_irqsave(&pool->lock);
+  DEBUGASSERT(pool->nused > 0);
+  pool->nused--;
+
+  if (mempool_isprealloc(pool, blk))
+    {
+      /* Put the block at the head of the free list so that recently used
+       * (and probably cached) memory is reused first.
+       */
+
+      sq_addfirst((FAR sq_entry_t *)blk, &pool->freelist);
+      pool->nfree++;
+      DEBUGASSERT(pool->nfree <= pool->ninitial);
+      spin_unlock_irqrestore(&pool->lock, flags);
+    }
+  else
+    {
+      /* The block was allocated from the heap.  sched_kfree() will defer
+       * the actual deallocation if this is called from an interrupt
+       * handler.
+       */
+
+      DEBUGASSERT(pool->nheap > 0);
+      pool->nheap--;
+      spin_unlock_irqrestore(&pool->lock, flags);
+      sched_kfree(blk);
+    }
+}
+
+/****************************************************************************
+ * Name: mempool_info
+ *
+ * Description:
+ *   Return a snapshot of the pool statistics.
+ *
+ ****************************************************************************/
+
+void mempool_info(FAR struct mempool_s *pool,
+                  FAR struct mempoolinfo_s *info)
+{
+  irqstate_t flags;
+
+  DEBUGASSERT(pool != NULL && info != NULL);
+
+  flags          = spin_lock_irqsave(&pool->lock);
+  info->bsize    = pool->bsize;
+  info->ninitial = pool->ninitial;
+  info->nreserve = pool->nreserve;
+  info->nfree    = pool->nfree;
+  info->nused    = pool->nused;
+  info->nheap    = pool->nheap;
+  info->nmaxused = pool->nmaxused;
+  info->nfail    = pool->nfail;
+  spin_unlock_irqrestore(&pool->lock, flags);
+}
+
+/****************************************************************************
+ * Name: mempool_foreach
+ *
+ * Description:
+ *   Call the handler for every initialized pool, in the order in which
+ *   they were initialized.
+ *
+ ****************************************************************************/
+
+void mempool_foreach(mempool_handler_t handler, FAR void *arg)
+{
+  FAR struct mempool_s *pool;
+
+  DEBUGASSERT(handler != NULL);
+
+  for (pool = g_mempool_head; pool != NULL; pool = pool->flink)
+    {
+      handler(pool, arg);
+    }
+}
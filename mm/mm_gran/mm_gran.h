@@ -59,6 +59,12 @@
 #define SIZEOF_GRAN_S(n) \
   (sizeof(struct gran_s) + sizeof(uint32_t) * (SIZEOF_GAT(n) - 1))
 
+/* One "next fit" search hint is kept for each power of two allocation
+ * size.  The number of granules is a uint16_t so 16 hints are sufficient.
+ */
+
+#define GRAN_NHINTS     16
+
 /* Debug */
 
 #ifdef CONFIG_CPP_HAVE_VARARGS
@@ -99,6 +105,11 @@ struct gran_s
   sem_t      exclsem;   /* For exclusive access to the GAT */
 #endif
   uintptr_t  heapstart; /* The aligned start of the granule heap */
+
+  /* Granule number at which to start the next search for each size */
+
+  uint16_t   hint[GRAN_NHINTS];
+
   uint32_t   gat[1];    /* Start of the granule allocation table */
 };
 
@@ -142,4 +153,45 @@ void gran_leave_critical(FAR struct gran_s *priv);
 void gran_mark_allocated(FAR struct gran_s *priv, uintptr_t alloc,
                          unsigned int ngranules);
 
+/****************************************************************************
+ * Name: gran_next_free
+ *
+ * Description:
+ *   Find the first free granule at or after 'granno'.  The GAT is scanned
+ *   a whole word at a time using ffs().
+ *
+ * Input Parameters:
+ *   priv   - The granule heap state structure.
+ *   granno - The granule number at which to start the search.
+ *
+ * Returned Value:
+ *   The number of the first free granule or priv->ngranules if there is no
+ *   free granule at or after 'granno'.
+ *
+ ****************************************************************************/
+
+unsigned int gran_next_free(FAR struct gran_s *priv, unsigned int granno);
+
+/****************************************************************************
+ * Name: gran_next_allocated
+ *
+ * Description:
+ *   Find the first allocated granule at or after 'granno' but before
+ *   'limit'.  The GAT is scanned a whole word at a time using ffs().
+ *
+ * Input Parameters:
+ *   priv   - The granule heap state structure.
+ *   granno - The granule number at which to start the search.
+ *   limit  - The granule number at which to stop the search.  This must
+ *            not exceed priv->ngranules.
+ *
+ * Returned Value:
+ *   The number of the first allocated granule or 'limit' if all of the
+ *   granules in the range are free.
+ *
+ ****************************************************************************/
+
+unsigned int gran_next_allocated(FAR struct gran_s *priv,
+                                 unsigned int granno, unsigned int limit);
+
 #endif /* __MM_MM_GRAN_MM_GRAN_H */
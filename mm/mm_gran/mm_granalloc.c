@@ -39,6 +39,7 @@
 
 #include <nuttx/config.h>
 
+#include <strings.h>
 #include <assert.h>
 
 #include <nuttx/mm/gran.h>
@@ -47,6 +48,65 @@
 
 #ifdef CONFIG_GRAN
 
+/****************************************************************************
+ * Private Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: gran_search
+ *
+ * Description:
+ *   Search for a free sequence of 'ngranules' granules that begins at or
+ *   after 'granno' but before 'limit'.
+ *
+ *   Each step finds the next free granule, then the next allocated granule
+ *   after that.  If the free sequence between them is too short, the
+ *   search resumes after the allocated granule, so each GAT entry is
+ *   examined only a few times regardless of the size of the allocation.
+ *
+ * Input Parameters:
+ *   priv      - The granule heap state structure.
+ *   granno    - The first granule number to consider.
+ *   limit     - The search ends when the candidate reaches this granule.
+ *   ngranules - The number of contiguous granules needed.
+ *
+ * Returned Value:
+ *   The number of the first granule of the free sequence or -1 if there is
+ *   no such sequence in the range.
+ *
+ ****************************************************************************/
+
+static int gran_search(FAR struct gran_s *priv, unsigned int granno,
+                       unsigned int limit, unsigned int ngranules)
+{
+  unsigned int endgran;
+
+  while (granno < limit && granno + ngranules <= priv->ngranules)
+    {
+      /* Find the next free granule */
+
+      granno = gran_next_free(priv, granno);
+      if (granno >= limit || granno + ngranules > priv->ngranules)
+        {
+          break;
+        }
+
+      /* Are the following granules also free? */
+
+      endgran = gran_next_allocated(priv, granno, granno + ngranules);
+      if (endgran == granno + ngranules)
+        {
+          return (int)granno;
+        }
+
+      /* No.. continue after the allocated granule */
+
+      granno = endgran + 1;
+    }
+
+  return -1;
+}
+
 /****************************************************************************
  * Public Functions
  ****************************************************************************/
@@ -57,9 +117,8 @@
  * Description:
  *   Allocate memory from the granule heap.
  *
- *   NOTE: The current implementation also restricts the maximum allocation
- *   size to 32 granules.  That restriction could be eliminated with some
- *   additional coding effort.
+ *   The search starts where the last allocation of the same power of two
+ *   size ended ("next fit") and wraps around to the beginning of the heap.
  *
  * Input Parameters:
  *   handle - The handle previously returned by gran_initialize
@@ -74,184 +133,58 @@
 FAR void *gran_alloc(GRAN_HANDLE handle, size_t size)
 {
   FAR struct gran_s *priv = (FAR struct gran_s *)handle;
-  unsigned int ngranules;
+  FAR void    *alloc = NULL;
   size_t       tmpmask;
-  uintptr_t    alloc;
-  uint32_t     curr;
-  uint32_t     next;
-  uint32_t     mask;
-  int          granidx;
-  int          gatidx;
-  int          bitidx;
-  int          shift;
+  unsigned int ngranules;
+  unsigned int start;
+  int          hintidx;
+  int          granno;
 
-  DEBUGASSERT(priv != NULL && size <= 32 * (1 << priv->log2gran));
+  DEBUGASSERT(priv != NULL);
 
   if (priv != NULL && size > 0)
     {
-      /* Get exclusive access to the GAT */
-
-      gran_enter_critical(priv);
-
       /* How many contiguous granules we we need to find? */
 
-      tmpmask   = (1 << priv->log2gran) - 1;
+      tmpmask = (1 << priv->log2gran) - 1;
+      if (size > ((size_t)priv->ngranules << priv->log2gran))
+        {
+          return NULL;
+        }
+
       ngranules = (size + tmpmask) >> priv->log2gran;
 
-      /* Then create mask for that number of granules */
+      /* Get exclusive access to the GAT */
 
-      DEBUGASSERT(ngranules <= 32);
-      mask = 0xffffffff >> (32 - ngranules);
+      gran_enter_critical(priv);
 
-      /* Now search the granule allocation table for that number of contiguous */
+      /* Start where the last allocation of this size ended */
 
-      alloc = priv->heapstart;
+      hintidx = fls((int)ngranules) - 1;
+      start   = priv->hint[hintidx];
 
-      for (granidx = 0; granidx < priv->ngranules; granidx += 32)
+      granno  = gran_search(priv, start, priv->ngranules, ngranules);
+      if (granno < 0 && start > 0)
         {
-          /* Get the GAT index associated with the granule table entry */
-
-          gatidx = granidx >> 5;
-          curr = priv->gat[gatidx];
-
-          /* Handle the case where there are no free granules in the entry */
-
-          if (curr == 0xffffffff)
-            {
-              alloc += (32 << priv->log2gran);
-              continue;
-            }
-
-          /* Get the next entry from the GAT to support a 64 bit shift */
-
-          if (granidx < priv->ngranules)
-            {
-              next = priv->gat[gatidx + 1];
-            }
-
-          /* Use all ones when are at the last entry in the GAT (meaning
-           * nothing can be allocated.
-           */
-
-          else
-            {
-              next = 0xffffffff;
-            }
-
-          /* Search through the allocations in the 'curr' GAT entry
-           * to see if we can satisfy the allocation starting in that
-           * entry.
-           *
-           * This loop continues until either all of the bits have been
-           * examined (bitidx >= 32), or until there are insufficient
-           * granules left to satisfy the allocation.
-           */
-
-          for (bitidx = 0;
-               bitidx < 32 && (granidx + bitidx + ngranules) <= priv->ngranules;
-              )
-            {
-              /* Break out if there are no further free bits in 'curr'.
-               * All of the zero bits might have gotten shifted out.
-               */
-
-              if (curr == 0xffffffff)
-                {
-                  break;
-                }
-
-              /* Check for the first zero bit in the lower or upper 16-bits.
-               * From the test above, we know that at least one of the 32-
-               * bits in 'curr' is zero.
-               */
-
-              else if ((curr & 0x0000ffff) == 0x0000ffff)
-                {
-                  /* Not in the lower 16 bits.  The first free bit must be
-                   * in the upper 16 bits.
-                   */
-
-                  shift = 16;
-                }
-
-              /* We know that the first free bit is now within the lower 16
-               * bits of 'curr'.  Is it in the upper or lower byte?
-               */
-
-              else if ((curr & 0x0000ff) == 0x000000ff)
-                {
-                  /* Not in the lower 8 bits.  The first free bit must be in
-                   * the upper 8 bits.
-                   */
-
-                  shift = 8;
-                }
-
-              /* We know that the first free bit is now within the lower 4
-               * bits of 'curr'.  Is it in the upper or lower nibble?
-               */
-
-              else if ((curr & 0x00000f) == 0x0000000f)
-                {
-                  /* Not in the lower 4 bits.  The first free bit must be in
-                   * the upper 4 bits.
-                   */
-
-                  shift = 4;
-                }
-
-              /* We know that the first free bit is now within the lower 4 bits
-               * of 'curr'.  Is it in the upper or lower pair?
-               */
-
-              else if ((curr & 0x000003) == 0x00000003)
-                {
-                  /* Not in the lower 2 bits.  The first free bit must be in
-                   * the upper 2 bits.
-                   */
-
-                  shift = 2;
-                }
-
-              /* We know that the first free bit is now within the lower 4 bits
-               * of 'curr'.  Check if we have the allocation at this bit position.
-               */
-
-              else if ((curr & mask) == 0)
-                {
-                  /* Yes.. mark these granules allocated */
-
-                  gran_mark_allocated(priv, alloc, ngranules);
-
-                  /* And return the allocation address */
-
-                  gran_leave_critical(priv);
-                  return (FAR void *)alloc;
-                }
-
-              /* The free allocation does not start at this position */
-
-              else
-                {
-                  shift = 1;
-                }
-
-              /* Set up for the next time through the loop.  Perform a 64
-               * bit shift to move to the next gran position and increment
-               * to the next candidate allocation address.
-               */
-
-              alloc  += (shift << priv->log2gran);
-              curr    = (curr >> shift) | (next << (32 - shift));
-              next  >>= shift;
-              bitidx += shift;
-            }
+          /* Then wrap around to the beginning of the heap */
+
+          granno = gran_search(priv, 0, start, ngranules);
+        }
+
+      if (granno >= 0)
+        {
+          /* Mark these granules allocated and update the hint */
+
+          alloc = (FAR void *)(priv->heapstart +
+                               ((uintptr_t)granno << priv->log2gran));
+          gran_mark_allocated(priv, (uintptr_t)alloc, ngranules);
+          priv->hint[hintidx] = granno + ngranules;
         }
 
       gran_leave_critical(priv);
     }
 
-  return NULL;
+  return alloc;
 }
 
 #endif /* CONFIG_GRAN */
@@ -39,6 +39,7 @@
 
 #include <nuttx/config.h>
 
+#include <strings.h>
 #include <assert.h>
 
 #include <nuttx/mm/gran.h>
@@ -74,10 +75,11 @@ void gran_free(GRAN_HANDLE handle, FAR void *memory, size_t size)
   unsigned int gatbit;
   unsigned int granmask;
   unsigned int ngranules;
-  unsigned int avail;
+  unsigned int nbits;
   uint32_t     gatmask;
+  int          hintidx;
 
-  DEBUGASSERT(priv != NULL && memory && size <= 32 * (1 << priv->log2gran));
+  DEBUGASSERT(priv != NULL && memory && size > 0);
 
   /* Get exclusive access to the GAT */
 
@@ -98,39 +100,41 @@ void gran_free(GRAN_HANDLE handle, FAR void *memory, size_t size)
 
   granmask =  (1 << priv->log2gran) - 1;
   ngranules = (size + granmask) >> priv->log2gran;
+  DEBUGASSERT(granno + ngranules <= priv->ngranules);
 
-  /* Clear bits in the GAT entry or entries */
+  /* Let the search for allocations of this size or smaller start here if
+   * this is before the place where it would otherwise start.
+   */
 
-  avail = 32 - gatbit;
-  if (ngranules > avail)
+  for (hintidx = fls((int)ngranules) - 1; hintidx >= 0; hintidx--)
     {
-      /* Clear bits in the first GAT entry */
-
-      gatmask = (0xffffffff << gatbit);
-      DEBUGASSERT((priv->gat[gatidx] & gatmask) == gatmask);
-
-      priv->gat[gatidx] &= ~gatmask;
-      ngranules -= avail;
-
-      /* Clear bits in the second GAT entry */
-
-      gatmask = 0xffffffff >> (32 - ngranules);
-      DEBUGASSERT((priv->gat[gatidx+1] & gatmask) == gatmask);
-
-      priv->gat[gatidx+1] &= ~gatmask;
+      if (granno < priv->hint[hintidx])
+        {
+          priv->hint[hintidx] = granno;
+        }
     }
 
-  /* Handle the case where where all of the granules came from one entry */
+  /* Clear bits in each GAT entry spanned by the allocation */
 
-  else
+  while (ngranules > 0)
     {
-      /* Clear bits in a single GAT entry */
+      nbits = 32 - gatbit;
+      if (nbits > ngranules)
+        {
+          nbits = ngranules;
+        }
 
-      gatmask   = 0xffffffff >> (32 - ngranules);
+      gatmask   = 0xffffffff >> (32 - nbits);
       gatmask <<= gatbit;
       DEBUGASSERT((priv->gat[gatidx] & gatmask) == gatmask);
 
       priv->gat[gatidx] &= ~gatmask;
+      ngranules -= nbits;
+
+      /* Any remaining granules start at bit 0 of the next entry */
+
+      gatidx++;
+      gatbit = 0;
     }
 
   gran_leave_critical(priv);
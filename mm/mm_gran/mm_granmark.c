@@ -73,51 +73,40 @@ void gran_mark_allocated(FAR struct gran_s *priv, uintptr_t alloc,
   unsigned int granno;
   unsigned int gatidx;
   unsigned int gatbit;
-  unsigned int avail;
+  unsigned int nbits;
   uint32_t     gatmask;
 
   /* Determine the granule number of the allocation */
 
   granno = (alloc - priv->heapstart) >> priv->log2gran;
+  DEBUGASSERT(granno + ngranules <= priv->ngranules);
 
   /* Determine the GAT table index associated with the allocation */
 
   gatidx = granno >> 5;
   gatbit = granno & 31;
 
-  /* Mark bits in the GAT entry or entries */
+  /* Mark bits in each GAT entry spanned by the allocation */
 
-  avail = 32 - gatbit;
-  if (ngranules > avail)
+  while (ngranules > 0)
     {
-      /* Mark bits in the first GAT entry */
+      nbits = 32 - gatbit;
+      if (nbits > ngranules)
+        {
+          nbits = ngranules;
+        }
 
-      gatmask = 0xffffffff << gatbit;
+      gatmask   = 0xffffffff >> (32 - nbits);
+      gatmask <<= gatbit;
       DEBUGASSERT((priv->gat[gatidx] & gatmask) == 0);
 
       priv->gat[gatidx] |= gatmask;
-      ngranules -= avail;
-
-      /* Mark bits in the second GAT entry */
-
-      gatmask = 0xffffffff >> (32 - ngranules);
-      DEBUGASSERT((priv->gat[gatidx+1] & gatmask) == 0);
+      ngranules -= nbits;
 
-      priv->gat[gatidx+1] |= gatmask;
-    }
-
-  /* Handle the case where where all of the granules come from one entry */
+      /* Any remaining granules start at bit 0 of the next entry */
 
-  else
-    {
-      /* Mark bits in a single GAT entry */
-
-      gatmask   = 0xffffffff >> (32 - ngranules);
-      gatmask <<= gatbit;
-      DEBUGASSERT((priv->gat[gatidx] & gatmask) == 0);
-
-      priv->gat[gatidx] |= gatmask;
-      return;
+      gatidx++;
+      gatbit = 0;
     }
 }
 
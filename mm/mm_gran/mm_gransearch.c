@@ -0,0 +1,152 @@
+/****************************************************************************
+ * mm/mm_gran/mm_gransearch.c
+ *
+ *   Copyright (C) 2020 Gregory Nutt. All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in
+ *    the documentation and/or other materials provided with the
+ *    distribution.
+ * 3. Neither the name NuttX nor the names of its contributors may be
+ *    used to endorse or promote products derived from this software
+ *    without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+ * FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE
+ * COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+ * INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,
+ * BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS
+ * OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED
+ * AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ * LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN
+ * ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ *
+ ****************************************************************************/
+
+/****************************************************************************
+ * Included Files
+ ****************************************************************************/
+
+#include <nuttx/config.h>
+
+#include <strings.h>
+#include <assert.h>
+
+#include <nuttx/mm/gran.h>
+
+#include "mm_gran/mm_gran.h"
+
+#ifdef CONFIG_GRAN
+
+/****************************************************************************
+ * Public Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: gran_next_free
+ *
+ * Description:
+ *   Find the first free granule at or after 'granno'.  The GAT is scanned
+ *   a whole word at a time using ffs().
+ *
+ * Input Parameters:
+ *   priv   - The granule heap state structure.
+ *   granno - The granule number at which to start the search.
+ *
+ * Returned Value:
+ *   The number of the first free granule or priv->ngranules if there is no
+ *   free granule at or after 'granno'.
+ *
+ ****************************************************************************/
+
+unsigned int gran_next_free(FAR struct gran_s *priv, unsigned int granno)
+{
+  unsigned int gatidx;
+  uint32_t     value;
+
+  while (granno < priv->ngranules)
+    {
+      /* Get the free bits of this GAT entry at or above 'granno' */
+
+      gatidx = granno >> 5;
+      value  = ~priv->gat[gatidx] & (0xffffffff << (granno & 31));
+
+      if (value != 0)
+        {
+          /* The lowest set bit is the first free granule.  The unused
+           * bits at the end of the last GAT entry are always zero, so
+           * clip the result to the size of the heap.
+           */
+
+          granno = (gatidx << 5) + ffs((int)value) - 1;
+          return granno < priv->ngranules ? granno : priv->ngranules;
+        }
+
+      /* All allocated, skip to the next GAT entry */
+
+      granno = (gatidx + 1) << 5;
+    }
+
+  return priv->ngranules;
+}
+
+/****************************************************************************
+ * Name: gran_next_allocated
+ *
+ * Description:
+ *   Find the first allocated granule at or after 'granno' but before
+ *   'limit'.  The GAT is scanned a whole word at a time using ffs().
+ *
+ * Input Parameters:
+ *   priv   - The granule heap state structure.
+ *   granno - The granule number at which to start the search.
+ *   limit  - The granule number at which to stop the search.  This must
+ *            not exceed priv->ngranules.
+ *
+ * Returned Value:
+ *   The number of the first allocated granule or 'limit' if all of the
+ *   granules in the range are free.
+ *
+ ****************************************************************************/
+
+unsigned int gran_next_allocated(FAR struct gran_s *priv,
+                                 unsigned int granno, unsigned int limit)
+{
+  unsigned int gatidx;
+  uint32_t     value;
+
+  DEBUGASSERT(limit <= priv->ngranules);
+
+  while (granno < limit)
+    {
+      /* Get the allocated bits of this GAT entry at or above 'granno' */
+
+      gatidx = granno >> 5;
+      value  = priv->gat[gatidx] & (0xffffffff << (granno & 31));
+
+      if (value != 0)
+        {
+          /* The lowest set bit is the first allocated granule */
+
+          granno = (gatidx << 5) + ffs((int)value) - 1;
+          return granno < limit ? granno : limit;
+        }
+
+      /* All free, skip to the next GAT entry */
+
+      granno = (gatidx + 1) << 5;
+    }
+
+  return limit;
+}
+
+#endif /* CONFIG_GRAN */
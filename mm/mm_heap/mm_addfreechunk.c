@@ -63,11 +63,23 @@ void mm_addfreechunk(FAR struct mm_heap_s *heap, FAR struct mm_freenode_s *node)
 
   int ndx = mm_size2ndx(node->size);
 
+#ifdef CONFIG_MM_TLSF
+  /* The bins of the two-level index are not ordered by size.  Just put the
+   * new node at the head of its bin and mark the bin as non-empty.
+   */
+
+  prev = &heap->mm_nodelist[ndx];
+  next = prev->flink;
+
+  heap->mm_flbitmap                     |= (1 << (ndx >> MM_SL_SHIFT));
+  heap->mm_slbitmap[ndx >> MM_SL_SHIFT] |= (1 << (ndx & MM_SL_MASK));
+#else
   /* Now put the new node int the next */
 
   for (prev = &heap->mm_nodelist[ndx], next = heap->mm_nodelist[ndx].flink;
        next && next->size && next->size < node->size;
        prev = next, next = next->flink);
+#endif
 
   /* Does it go in mid next or at the end? */
 
@@ -81,4 +93,10 @@ void mm_addfreechunk(FAR struct mm_heap_s *heap, FAR struct mm_freenode_s *node)
 
       next->blink = node;
     }
+
+#ifdef CONFIG_MM_MOVABLE
+  /* There may be something for mm_compact() to do now */
+
+  heap->mm_mvdirty = true;
+#endif
 }
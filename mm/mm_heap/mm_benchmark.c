@@ -0,0 +1,629 @@
+/****************************************************************************
+ * mm/mm_heap/mm_benchmark.c
+ *
+ *   Copyright (C) 2020 Gregory Nutt. All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in
+ *    the documentation and/or other materials provided with the
+ *    distribution.
+ * 3. Neither the name NuttX nor the names of its contributors may be
+ *    used to endorse or promote products derived from this software
+ *    without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+ * FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE
+ * COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+ * INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,
+ * BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS
+ * OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED
+ * AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ * LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN
+ * ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ *
+ ****************************************************************************/
+
+/****************************************************************************
+ * Included Files
+ ****************************************************************************/
+
+#include <nuttx/config.h>
+
+#include <sys/types.h>
+#include <stdint.h>
+#include <stdbool.h>
+#include <stdlib.h>
+#include <string.h>
+#include <strings.h>
+#include <sched.h>
+#include <time.h>
+#include <assert.h>
+#include <errno.h>
+
+#include <nuttx/arch.h>
+#include <nuttx/kthread.h>
+#include <nuttx/semaphore.h>
+#include <nuttx/mm/mm.h>
+#include <nuttx/mm/benchmark.h>
+
+#ifdef CONFIG_MM_BENCHMARK
+
+/****************************************************************************
+ * Pre-processor Definitions
+ ****************************************************************************/
+
+#ifndef CONFIG_MM_BENCHMARK_NOPS
+#  define CONFIG_MM_BENCHMARK_NOPS 1000
+#endif
+
+#ifndef CONFIG_MM_BENCHMARK_NLIVE
+#  define CONFIG_MM_BENCHMARK_NLIVE 64
+#endif
+
+#ifndef CONFIG_MM_BENCHMARK_STACKSIZE
+#  define CONFIG_MM_BENCHMARK_STACKSIZE 1024
+#endif
+
+#define BENCH_NOPS       CONFIG_MM_BENCHMARK_NOPS
+#define BENCH_NLIVE      CONFIG_MM_BENCHMARK_NLIVE
+
+/* Block sizes.  Power-law sizes are BENCH_MINSIZE << k plus up to the same
+ * again, where k = 0..BENCH_MAXSHIFT is taken with probability 2^-(k+1).
+ */
+
+#define BENCH_FIXEDSIZE  64
+#define BENCH_MINSIZE    16
+#define BENCH_MAXSHIFT   8
+
+/* The realloc trace grows BENCH_NGROW buffers in random steps and starts a
+ * buffer over when it would exceed BENCH_MAXGROW.  The other live slots
+ * hold a background of power-law allocations.
+ */
+
+#define BENCH_NGROW      (BENCH_NLIVE < 8 ? BENCH_NLIVE : 8)
+#define BENCH_MAXGROW    4096
+#define BENCH_MAXSTEP    256
+
+/* Every trace starts from the same seed so that runs are comparable */
+
+#define BENCH_SEED       0x2545f491
+
+/* Time stamps.  The critical section monitor timer is used when there is
+ * one; otherwise the system clock, which may be much coarser.
+ */
+
+#ifdef CONFIG_SCHED_CRITMONITOR
+#  define bench_gettime() up_critmon_gettime()
+#endif
+
+#ifdef CONFIG_CLOCK_MONOTONIC
+#  define BENCH_CLOCK    CLOCK_MONOTONIC
+#else
+#  define BENCH_CLOCK    CLOCK_REALTIME
+#endif
+
+/****************************************************************************
+ * Private Types
+ ****************************************************************************/
+
+struct mm_bench_s
+{
+  FAR struct mm_heap_s *heap;         /* The heap under test */
+  uint32_t seed;                      /* Pseudo-random number state */
+  uint32_t nfail;                     /* Failed allocations */
+  uint16_t frag;                      /* Fragmentation at end of trace */
+
+  /* Latency samples of each operation */
+
+  FAR uint32_t *samples[MM_BENCHOP_NOPS];
+  uint32_t nsamples[MM_BENCHOP_NOPS];
+
+  /* The working set of the trace.  The producer/consumer trace uses it as
+   * a ring of blocks in flight to the consumer.
+   */
+
+  FAR void *live[BENCH_NLIVE];
+  size_t size[BENCH_NLIVE];
+  unsigned int head;
+  unsigned int tail;
+  unsigned int count;
+
+  sem_t slots;                        /* Free slots in the ring */
+  sem_t items;                        /* Blocks in the ring */
+  sem_t done;                         /* The consumer has finished */
+};
+
+/****************************************************************************
+ * Private Data
+ ****************************************************************************/
+
+static struct mm_bench_s g_bench;
+static sem_t g_bench_lock = SEM_INITIALIZER(1);
+
+static FAR const char *g_bench_tracenames[MM_BENCH_NTRACES] =
+{
+  "fixed", "powerlaw", "prodcons", "realloc"
+};
+
+static FAR const char *g_bench_opnames[MM_BENCHOP_NOPS] =
+{
+  "malloc", "free", "realloc"
+};
+
+/****************************************************************************
+ * Private Functions
+ ****************************************************************************/
+
+#ifndef CONFIG_SCHED_CRITMONITOR
+static uint32_t bench_gettime(void)
+{
+  struct timespec ts;
+
+  clock_gettime(BENCH_CLOCK, &ts);
+  return (uint32_t)ts.tv_sec * 1000000000 + (uint32_t)ts.tv_nsec;
+}
+#endif
+
+static uint32_t bench_tons(uint32_t elapsed)
+{
+#ifdef CONFIG_SCHED_CRITMONITOR
+  struct timespec ts;
+
+  up_critmon_convert(elapsed, &ts);
+  return (uint32_t)ts.tv_sec * 1000000000 + (uint32_t)ts.tv_nsec;
+#else
+  return elapsed;
+#endif
+}
+
+static uint32_t bench_rand(void)
+{
+  uint32_t x = g_bench.seed;
+
+  x ^= x << 13;
+  x ^= x >> 17;
+  x ^= x << 5;
+
+  g_bench.seed = x;
+  return x;
+}
+
+static size_t bench_powerlaw(void)
+{
+  size_t base;
+  int shift;
+
+  shift = ffs(bench_rand() | (1 << BENCH_MAXSHIFT)) - 1;
+  base  = BENCH_MINSIZE << shift;
+  return base + bench_rand() % base;
+}
+
+static void bench_record(int op, uint32_t start)
+{
+  uint32_t elapsed = bench_gettime() - start;
+
+  if (g_bench.nsamples[op] < BENCH_NOPS)
+    {
+      g_bench.samples[op][g_bench.nsamples[op]++] = elapsed;
+    }
+}
+
+/* Timed heap operations */
+
+static FAR void *bench_malloc(size_t size)
+{
+  uint32_t start = bench_gettime();
+  FAR void *mem  = mm_malloc(g_bench.heap, size);
+
+  bench_record(MM_BENCHOP_MALLOC, start);
+  if (mem == NULL)
+    {
+      g_bench.nfail++;
+    }
+
+  return mem;
+}
+
+static void bench_free(FAR void *mem)
+{
+  uint32_t start = bench_gettime();
+
+  mm_free(g_bench.heap, mem);
+  bench_record(MM_BENCHOP_FREE, start);
+}
+
+static FAR void *bench_realloc(FAR void *oldmem, size_t size)
+{
+  uint32_t start = bench_gettime();
+  FAR void *mem  = mm_realloc(g_bench.heap, oldmem, size);
+
+  bench_record(MM_BENCHOP_REALLOC, start);
+  if (mem == NULL)
+    {
+      g_bench.nfail++;
+    }
+
+  return mem;
+}
+
+/* Fragmentation of the free memory in thousandths */
+
+static uint16_t bench_frag(void)
+{
+  struct mallinfo info;
+
+  mm_mallinfo(g_bench.heap, &info);
+  if (info.fordblks <= 0)
+    {
+      return 0;
+    }
+
+  return 1000 - (uint16_t)((uint64_t)info.mxordblk * 1000 / info.fordblks);
+}
+
+/* Toggle a random slot of the working set:  Free it if it holds a block,
+ * otherwise allocate one.
+ */
+
+static void bench_toggle(unsigned int first, bool powerlaw)
+{
+  unsigned int slot = first + bench_rand() % (BENCH_NLIVE - first);
+
+  if (g_bench.live[slot] != NULL)
+    {
+      bench_free(g_bench.live[slot]);
+      g_bench.live[slot] = NULL;
+    }
+  else
+    {
+      g_bench.live[slot] =
+        bench_malloc(powerlaw ? bench_powerlaw() : BENCH_FIXEDSIZE);
+    }
+}
+
+/* MM_BENCH_FIXED and MM_BENCH_POWERLAW */
+
+static void bench_random(bool powerlaw)
+{
+  int i;
+
+  for (i = 0; i < BENCH_NOPS; i++)
+    {
+      bench_toggle(0, powerlaw);
+    }
+
+  g_bench.frag = bench_frag();
+}
+
+/* MM_BENCH_REALLOC */
+
+static void bench_grow(void)
+{
+  unsigned int slot;
+  FAR void *mem;
+  size_t size;
+  int i;
+
+  for (i = 0; i < BENCH_NOPS; i++)
+    {
+      slot = bench_rand() % BENCH_NGROW;
+      size = g_bench.size[slot] + BENCH_MINSIZE +
+             bench_rand() % BENCH_MAXSTEP;
+
+      if (size > BENCH_MAXGROW)
+        {
+          if (g_bench.live[slot] != NULL)
+            {
+              bench_free(g_bench.live[slot]);
+              g_bench.live[slot] = NULL;
+            }
+
+          g_bench.size[slot] = 0;
+        }
+      else
+        {
+          mem = bench_realloc(g_bench.live[slot], size);
+          if (mem != NULL)
+            {
+              g_bench.live[slot] = mem;
+              g_bench.size[slot] = size;
+            }
+        }
+
+      /* Keep the background changing so that growth in place is not
+       * always possible.
+       */
+
+      if (BENCH_NGROW < BENCH_NLIVE && (i & 3) == 0)
+        {
+          bench_toggle(BENCH_NGROW, true);
+        }
+    }
+
+  g_bench.frag = bench_frag();
+}
+
+/* MM_BENCH_PRODCONS:  The consumer thread frees each block taken from the
+ * ring.  A NULL block ends the trace.
+ */
+
+static int bench_consumer(int argc, FAR char *argv[])
+{
+  FAR void *mem;
+
+  do
+    {
+      nxsem_wait_uninterruptible(&g_bench.items);
+
+      mem          = g_bench.live[g_bench.tail];
+      g_bench.tail = (g_bench.tail + 1) % BENCH_NLIVE;
+
+      nxsem_post(&g_bench.slots);
+
+      if (mem != NULL)
+        {
+          bench_free(mem);
+        }
+    }
+  while (mem != NULL);
+
+  nxsem_post(&g_bench.done);
+  return 0;
+}
+
+static void bench_put(FAR void *mem, bool threaded)
+{
+  if (threaded)
+    {
+      nxsem_wait_uninterruptible(&g_bench.slots);
+
+      g_bench.live[g_bench.head] = mem;
+      g_bench.head = (g_bench.head + 1) % BENCH_NLIVE;
+
+      nxsem_post(&g_bench.items);
+      return;
+    }
+
+  /* Without a consumer thread, free the whole ring each time it fills */
+
+  if (g_bench.count == BENCH_NLIVE || mem == NULL)
+    {
+      while (g_bench.count > 0)
+        {
+          bench_free(g_bench.live[g_bench.tail]);
+          g_bench.live[g_bench.tail] = NULL;
+          g_bench.tail = (g_bench.tail + 1) % BENCH_NLIVE;
+          g_bench.count--;
+        }
+    }
+
+  if (mem != NULL)
+    {
+      g_bench.live[g_bench.head] = mem;
+      g_bench.head = (g_bench.head + 1) % BENCH_NLIVE;
+      g_bench.count++;
+    }
+}
+
+static void bench_prodcons(void)
+{
+  FAR void *mem;
+  bool threaded;
+  pid_t pid;
+  int i;
+
+  nxsem_init(&g_bench.slots, 0, BENCH_NLIVE);
+  nxsem_init(&g_bench.items, 0, 0);
+  nxsem_init(&g_bench.done, 0, 0);
+  nxsem_setprotocol(&g_bench.slots, SEM_PRIO_NONE);
+  nxsem_setprotocol(&g_bench.items, SEM_PRIO_NONE);
+  nxsem_setprotocol(&g_bench.done, SEM_PRIO_NONE);
+
+  /* Start the consumer, if possible on another CPU.  If the thread cannot
+   * be created, the blocks are freed in batches by this thread.
+   */
+
+  pid = kthread_create("mm_bench", SCHED_PRIORITY_DEFAULT,
+                       CONFIG_MM_BENCHMARK_STACKSIZE, bench_consumer, NULL);
+  threaded = pid >= 0;
+
+#if defined(CONFIG_SMP) && CONFIG_SMP_NCPUS > 1
+  if (threaded)
+    {
+      cpu_set_t cpuset = ((1 << CONFIG_SMP_NCPUS) - 1) &
+                         ~(1 << up_cpu_index());
+
+      nxsched_setaffinity(pid, sizeof(cpu_set_t), &cpuset);
+    }
+#endif
+
+  for (i = 0; i < BENCH_NOPS; i++)
+    {
+      mem = bench_malloc(bench_powerlaw());
+      if (mem != NULL)
+        {
+          bench_put(mem, threaded);
+        }
+    }
+
+  g_bench.frag = bench_frag();
+  bench_put(NULL, threaded);
+
+  if (threaded)
+    {
+      nxsem_wait_uninterruptible(&g_bench.done);
+    }
+
+  nxsem_destroy(&g_bench.slots);
+  nxsem_destroy(&g_bench.items);
+  nxsem_destroy(&g_bench.done);
+}
+
+static int bench_compare(FAR const void *a, FAR const void *b)
+{
+  uint32_t x = *(FAR const uint32_t *)a;
+  uint32_t y = *(FAR const uint32_t *)b;
+
+  return x < y ? -1 : (x > y ? 1 : 0);
+}
+
+static void bench_stat(int op, FAR struct mm_benchstat_s *stat)
+{
+  FAR uint32_t *samples = g_bench.samples[op];
+  uint32_t n = g_bench.nsamples[op];
+
+  stat->bs_nops = n;
+  if (n > 0)
+    {
+      qsort(samples, n, sizeof(uint32_t), bench_compare);
+
+      stat->bs_p50 = bench_tons(samples[(n - 1) * 50 / 100]);
+      stat->bs_p99 = bench_tons(samples[(n - 1) * 99 / 100]);
+      stat->bs_max = bench_tons(samples[n - 1]);
+    }
+}
+
+/****************************************************************************
+ * Public Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: mm_benchmark
+ *
+ * Description:
+ *   Run one synthetic allocation trace on a heap and report the latency
+ *   of each kind of operation and the fragmentation of the heap.
+ *
+ ****************************************************************************/
+
+int mm_benchmark(FAR struct mm_heap_s *heap, enum mm_benchtrace_e trace,
+                 FAR struct mm_benchresult_s *result)
+{
+  int ret;
+  int op;
+  int i;
+
+  DEBUGASSERT(heap != NULL && result != NULL);
+
+  if ((unsigned int)trace >= MM_BENCH_NTRACES)
+    {
+      return -EINVAL;
+    }
+
+  ret = nxsem_wait_uninterruptible(&g_bench_lock);
+  if (ret < 0)
+    {
+      return ret;
+    }
+
+  memset(&g_bench, 0, sizeof(struct mm_bench_s));
+  g_bench.heap = heap;
+  g_bench.seed = BENCH_SEED;
+
+  /* The sample buffers are taken from the heap under test before the trace
+   * starts, so they are in the same place in every run.
+   */
+
+  for (op = 0; op < MM_BENCHOP_NOPS; op++)
+    {
+      g_bench.samples[op] = mm_malloc(heap, BENCH_NOPS * sizeof(uint32_t));
+      if (g_bench.samples[op] == NULL)
+        {
+          ret = -ENOMEM;
+          goto errout;
+        }
+    }
+
+  switch (trace)
+    {
+      case MM_BENCH_FIXED:
+        bench_random(false);
+        break;
+
+      case MM_BENCH_POWERLAW:
+        bench_random(true);
+        break;
+
+      case MM_BENCH_PRODCONS:
+        bench_prodcons();
+        break;
+
+      case MM_BENCH_REALLOC:
+        bench_grow();
+        break;
+
+      default:
+        break;
+    }
+
+  /* Release the working set (untimed) */
+
+  for (i = 0; i < BENCH_NLIVE; i++)
+    {
+      if (g_bench.live[i] != NULL)
+        {
+          mm_free(heap, g_bench.live[i]);
+        }
+    }
+
+  memset(result, 0, sizeof(struct mm_benchresult_s));
+  for (op = 0; op < MM_BENCHOP_NOPS; op++)
+    {
+      bench_stat(op, &result->br_stat[op]);
+    }
+
+  result->br_nfail = g_bench.nfail;
+  result->br_frag  = g_bench.frag;
+  ret = OK;
+
+errout:
+  for (op = 0; op < MM_BENCHOP_NOPS; op++)
+    {
+      if (g_bench.samples[op] != NULL)
+        {
+          mm_free(heap, g_bench.samples[op]);
+        }
+    }
+
+  nxsem_post(&g_bench_lock);
+  return ret;
+}
+
+/****************************************************************************
+ * Name: mm_benchname
+ *
+ * Description:
+ *   Return a short name for a trace or an operation, for reports.
+ *
+ ****************************************************************************/
+
+FAR const char *mm_benchname(enum mm_benchtrace_e trace)
+{
+  if ((unsigned int)trace >= MM_BENCH_NTRACES)
+    {
+      return "unknown";
+    }
+
+  return g_bench_tracenames[trace];
+}
+
+FAR const char *mm_benchopname(enum mm_benchop_e op)
+{
+  if ((unsigned int)op >= MM_BENCHOP_NOPS)
+    {
+      return "unknown";
+    }
+
+  return g_bench_opnames[op];
+}
+
+#endif /* CONFIG_MM_BENCHMARK */
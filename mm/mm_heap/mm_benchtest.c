@@ -0,0 +1,247 @@
+/****************************************************************************
+ * mm/mm_heap/mm_benchtest.c
+ * Host driver for the heap benchmark.  Like mm/iob/iob_test.c, this needs a
+ * custom build setup:  It is compiled with the host compiler against the
+ * headers of a configured tree (so that include/arch and
+ * include/nuttx/config.h exist) together with the core mm/mm_heap sources
+ * and mm_benchmark.c, for example:
+ *
+ *   gcc -nostdinc -idirafter `gcc -print-file-name=include` \
+ *       -isystem include -D__NuttX__ -DCONFIG_MM_BENCHMARK \
+ *       -DCONFIG_SCHED_CRITMONITOR mm/mm_heap/mm_benchtest.c \
+ *       mm/mm_heap/mm_benchmark.c mm/mm_heap/mm_initialize.c ... \
+ *       -o mmbench
+ *
+ * mm_sem.c is not needed:  This file provides the heap semaphore and the
+ * few other OS services used.  There is no second thread, so the
+ * producer/consumer trace frees its blocks in batches.
+ *
+ *   Copyright (C) 2020 Gregory Nutt. All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in
+ *    the documentation and/or other materials provided with the
+ *    distribution.
+ * 3. Neither the name NuttX nor the names of its contributors may be
+ *    used to endorse or promote products derived from this software
+ *    without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+ * FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE
+ * COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+ * INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,
+ * BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS
+ * OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED
+ * AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ * LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN
+ * ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ *
+ ****************************************************************************/
+
+/****************************************************************************
+ * Included Files
+ ****************************************************************************/
+
+#include <nuttx/config.h>
+
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <time.h>
+#include <errno.h>
+
+#include <nuttx/arch.h>
+#include <nuttx/semaphore.h>
+#include <nuttx/kthread.h>
+#include <nuttx/mm/mm.h>
+#include <nuttx/mm/benchmark.h>
+
+/****************************************************************************
+ * Pre-processor Definitions
+ ****************************************************************************/
+
+#define ARENA_SIZE  (1024 * 1024)
+
+/****************************************************************************
+ * Private Data
+ ****************************************************************************/
+
+static struct mm_heap_s g_heap;
+static uint64_t g_arena[ARENA_SIZE / sizeof(uint64_t)];
+
+/* Time stamp counts per microsecond */
+
+static uint32_t g_counts_per_us = 1;
+
+/****************************************************************************
+ * Private Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: calibrate
+ *
+ * Description:
+ *   Measure the rate of the time stamp counter against the host clock(),
+ *   which counts microseconds.
+ *
+ ****************************************************************************/
+
+static void calibrate(void)
+{
+#if defined(__x86_64__) || defined(__i386__)
+  uint32_t start;
+  clock_t end;
+
+  end   = clock() + 20000;
+  start = up_critmon_gettime();
+  while (clock() < end);
+
+  g_counts_per_us = (up_critmon_gettime() - start) / 20000;
+  if (g_counts_per_us == 0)
+    {
+      g_counts_per_us = 1;
+    }
+#endif
+}
+
+/****************************************************************************
+ * Public Functions
+ ****************************************************************************/
+
+/* Timer used for the latency measurements */
+
+uint32_t up_critmon_gettime(void)
+{
+#if defined(__x86_64__) || defined(__i386__)
+  return (uint32_t)__builtin_ia32_rdtsc();
+#else
+  return (uint32_t)clock();
+#endif
+}
+
+void up_critmon_convert(uint32_t elapsed, FAR struct timespec *ts)
+{
+  uint64_t nsec = (uint64_t)elapsed * 1000 / g_counts_per_us;
+
+  ts->tv_sec  = nsec / 1000000000;
+  ts->tv_nsec = nsec % 1000000000;
+}
+
+/* There is only one thread on the host */
+
+void mm_seminitialize(FAR struct mm_heap_s *heap)
+{
+}
+
+void mm_takesemaphore(FAR struct mm_heap_s *heap)
+{
+}
+
+int mm_trysemaphore(FAR struct mm_heap_s *heap)
+{
+  return OK;
+}
+
+void mm_givesemaphore(FAR struct mm_heap_s *heap)
+{
+}
+
+int nxsem_init(FAR sem_t *sem, int pshared, unsigned int value)
+{
+  return OK;
+}
+
+int nxsem_destroy(FAR sem_t *sem)
+{
+  return OK;
+}
+
+int nxsem_wait(FAR sem_t *sem)
+{
+  return OK;
+}
+
+int nxsem_post(FAR sem_t *sem)
+{
+  return OK;
+}
+
+int nxsem_setprotocol(FAR sem_t *sem, int protocol)
+{
+  return OK;
+}
+
+int kthread_create(FAR const char *name, int priority, int stack_size,
+                   main_t entry, FAR char * const argv[])
+{
+  return -ENOSYS;
+}
+
+void up_assert(FAR const uint8_t *filename, int linenum)
+{
+  printf("Assertion failed at %s:%d\n", filename, linenum);
+  exit(1);
+}
+
+/****************************************************************************
+ * Name: main
+ *
+ * Description:
+ *   Run each benchmark trace on a heap in a static arena and print the
+ *   results in the same format as /proc/mmbench.
+ *
+ ****************************************************************************/
+
+int main(int argc, char **argv)
+{
+  struct mm_benchresult_s result;
+  FAR struct mm_benchstat_s *stat;
+  int trace;
+  int ret;
+  int op;
+
+  calibrate();
+  mm_initialize(&g_heap, g_arena, sizeof(g_arena));
+
+  printf("%-8s %-7s %6s %8s %8s %8s\n",
+         "TRACE", "OP", "COUNT", "P50(ns)", "P99(ns)", "MAX(ns)");
+
+  for (trace = 0; trace < MM_BENCH_NTRACES; trace++)
+    {
+      ret = mm_benchmark(&g_heap, trace, &result);
+      if (ret < 0)
+        {
+          printf("%-8s error %d\n", mm_benchname(trace), ret);
+          continue;
+        }
+
+      for (op = 0; op < MM_BENCHOP_NOPS; op++)
+        {
+          stat = &result.br_stat[op];
+          if (stat->bs_nops > 0)
+            {
+              printf("%-8s %-7s %6lu %8lu %8lu %8lu\n",
+                     mm_benchname(trace), mm_benchopname(op),
+                     (unsigned long)stat->bs_nops,
+                     (unsigned long)stat->bs_p50,
+                     (unsigned long)stat->bs_p99,
+                     (unsigned long)stat->bs_max);
+            }
+        }
+
+      printf("%-8s frag %u.%u%% failed %lu\n",
+             mm_benchname(trace), result.br_frag / 10,
+             result.br_frag % 10, (unsigned long)result.br_nfail);
+    }
+
+  return 0;
+}
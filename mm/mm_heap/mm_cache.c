@@ -0,0 +1,295 @@
+/****************************************************************************
+ * mm/mm_heap/mm_cache.c
+ *
+ *   Copyright (C) 2020 Gregory Nutt. All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in
+ *    the documentation and/or other materials provided with the
+ *    distribution.
+ * 3. Neither the name NuttX nor the names of its contributors may be
+ *    used to endorse or promote products derived from this software
+ *    without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+ * FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE
+ * COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+ * INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,
+ * BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS
+ * OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED
+ * AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ * LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN
+ * ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ *
+ ****************************************************************************/
+
+/****************************************************************************
+ * Included Files
+ ****************************************************************************/
+
+#include <nuttx/config.h>
+
+#include <assert.h>
+
+#include <nuttx/arch.h>
+#include <nuttx/irq.h>
+#include <nuttx/mm/mm.h>
+
+#ifdef CONFIG_MM_PERCPU_CACHE
+
+/****************************************************************************
+ * Pre-processor Definitions
+ ****************************************************************************/
+
+/* Map a chunk size to its cache class and a chunk to its payload */
+
+#define MM_CACHE_NDX(s) (((s) >> MM_MIN_SHIFT) - 1)
+#define MM_CHUNK2MEM(n) \
+  ((FAR void *)((FAR char *)(n) + SIZEOF_MM_ALLOCNODE))
+#define MM_MEM2CHUNK(m) \
+  ((FAR struct mm_allocnode_s *)((FAR char *)(m) - SIZEOF_MM_ALLOCNODE))
+
+/* Cached chunks are linked through the first word of their payload */
+
+#define MM_CACHE_NEXT(m) (*(FAR void **)(m))
+
+/****************************************************************************
+ * Private Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: mm_cache_drain
+ *
+ * Description:
+ *   Return a list of cached chunks to the heap, taking the MM semaphore
+ *   only once for the whole list.
+ *
+ ****************************************************************************/
+
+static void mm_cache_drain(FAR struct mm_heap_s *heap, FAR void *list)
+{
+  FAR void *next;
+
+  if (list != NULL)
+    {
+      mm_takesemaphore(heap);
+
+      for (; list != NULL; list = next)
+        {
+          next = MM_CACHE_NEXT(list);
+          mm_freechunk(heap, MM_MEM2CHUNK(list));
+        }
+
+      mm_givesemaphore(heap);
+    }
+}
+
+/****************************************************************************
+ * Public Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: mm_cache_alloc
+ *
+ * Description:
+ *   Allocate a chunk of 'alignsize' bytes (including the allocation node
+ *   header) from the cache of the current CPU.  If the cache is empty, a
+ *   batch of MM_CACHE_BATCH chunks of that size is allocated from the heap
+ *   with a single acquisition of the MM semaphore; one is returned and the
+ *   remainder is kept in the cache.
+ *
+ * Returned Value:
+ *   The allocated memory or NULL if neither the cache nor the heap could
+ *   provide a chunk.
+ *
+ ****************************************************************************/
+
+FAR void *mm_cache_alloc(FAR struct mm_heap_s *heap, size_t alignsize)
+{
+  FAR struct mm_cache_s *cache;
+  FAR struct mm_allocnode_s *node;
+  FAR void *batch = NULL;
+  FAR void *ret;
+  irqstate_t flags;
+  int ndx = MM_CACHE_NDX(alignsize);
+  int count;
+
+  DEBUGASSERT(alignsize <= MM_CACHE_MAXCHUNK);
+
+  /* Disabling local interrupts is sufficient to get exclusive access to
+   * the cache of this CPU and it also keeps us from migrating to another
+   * CPU.
+   */
+
+  flags = up_irq_save();
+  cache = &heap->mm_cache[up_cpu_index()];
+  ret   = cache->mc_head[ndx];
+  if (ret != NULL)
+    {
+      cache->mc_head[ndx] = MM_CACHE_NEXT(ret);
+      cache->mc_count[ndx]--;
+      up_irq_restore(flags);
+      return ret;
+    }
+
+  up_irq_restore(flags);
+
+  /* The cache is empty.  Refill it with a batch of chunks. */
+
+  mm_takesemaphore(heap);
+
+  for (count = 0; count < MM_CACHE_BATCH; count++)
+    {
+      node = mm_mallocchunk(heap, alignsize);
+      if (node == NULL)
+        {
+          break;
+        }
+
+      ret = MM_CHUNK2MEM(node);
+      MM_CACHE_NEXT(ret) = batch;
+      batch = ret;
+    }
+
+  mm_givesemaphore(heap);
+
+  if (batch == NULL)
+    {
+      return NULL;
+    }
+
+  /* Keep one for the caller and put the rest into the cache of the CPU
+   * that we are running on now.  That may no longer be the same CPU and
+   * that CPU's cache may not be empty anymore.
+   */
+
+  ret   = batch;
+  batch = MM_CACHE_NEXT(batch);
+
+  flags = up_irq_save();
+  cache = &heap->mm_cache[up_cpu_index()];
+
+  while (batch != NULL && cache->mc_count[ndx] < CONFIG_MM_CACHE_DEPTH)
+    {
+      FAR void *next = MM_CACHE_NEXT(batch);
+
+      MM_CACHE_NEXT(batch) = cache->mc_head[ndx];
+      cache->mc_head[ndx]  = batch;
+      cache->mc_count[ndx]++;
+      batch                = next;
+    }
+
+  up_irq_restore(flags);
+
+  /* Return anything that did not fit back to the heap */
+
+  mm_cache_drain(heap, batch);
+  return ret;
+}
+
+/****************************************************************************
+ * Name: mm_cache_free
+ *
+ * Description:
+ *   Return a small allocated chunk to the cache of the current CPU.  If
+ *   that cache is full, then MM_CACHE_BATCH cached chunks are returned to
+ *   the heap together with this one under a single acquisition of the MM
+ *   semaphore.
+ *
+ ****************************************************************************/
+
+void mm_cache_free(FAR struct mm_heap_s *heap,
+                   FAR struct mm_allocnode_s *node)
+{
+  FAR struct mm_cache_s *cache;
+  FAR void *batch = NULL;
+  FAR void *mem = MM_CHUNK2MEM(node);
+  irqstate_t flags;
+  int ndx;
+  int count;
+
+  /* Sanity check against double-frees */
+
+  DEBUGASSERT(node->preceding & MM_ALLOC_BIT);
+  DEBUGASSERT(node->size >= MM_MIN_CHUNK && node->size <= MM_CACHE_MAXCHUNK);
+
+  ndx   = MM_CACHE_NDX(node->size);
+  flags = up_irq_save();
+  cache = &heap->mm_cache[up_cpu_index()];
+
+  if (cache->mc_count[ndx] >= CONFIG_MM_CACHE_DEPTH)
+    {
+      /* The cache is full.  Detach a batch of cached chunks so that they
+       * can be returned to the heap below.
+       */
+
+      for (count = 0; count < MM_CACHE_BATCH; count++)
+        {
+          FAR void *next = cache->mc_head[ndx];
+
+          cache->mc_head[ndx] = MM_CACHE_NEXT(next);
+          cache->mc_count[ndx]--;
+          MM_CACHE_NEXT(next) = batch;
+          batch               = next;
+        }
+    }
+
+  MM_CACHE_NEXT(mem)  = cache->mc_head[ndx];
+  cache->mc_head[ndx] = mem;
+  cache->mc_count[ndx]++;
+
+  up_irq_restore(flags);
+
+  mm_cache_drain(heap, batch);
+}
+
+/****************************************************************************
+ * Name: mm_cache_flush
+ *
+ * Description:
+ *   Return all chunks in the cache of the current CPU to the heap.  This is
+ *   done when an allocation from the heap fails since the cached chunks,
+ *   which appear allocated to the heap, may keep the adjacent free chunks
+ *   from being merged.
+ *
+ ****************************************************************************/
+
+void mm_cache_flush(FAR struct mm_heap_s *heap)
+{
+  FAR struct mm_cache_s *cache;
+  FAR void *batch = NULL;
+  irqstate_t flags;
+  int ndx;
+
+  flags = up_irq_save();
+  cache = &heap->mm_cache[up_cpu_index()];
+
+  for (ndx = 0; ndx < MM_CACHE_NCLASSES; ndx++)
+    {
+      while (cache->mc_head[ndx] != NULL)
+        {
+          FAR void *next = cache->mc_head[ndx];
+
+          cache->mc_head[ndx] = MM_CACHE_NEXT(next);
+          MM_CACHE_NEXT(next) = batch;
+          batch               = next;
+        }
+
+      cache->mc_count[ndx] = 0;
+    }
+
+  up_irq_restore(flags);
+
+  mm_cache_drain(heap, batch);
+}
+
+#endif /* CONFIG_MM_PERCPU_CACHE */
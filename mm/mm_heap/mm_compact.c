@@ -0,0 +1,202 @@
+/****************************************************************************
+ * mm/mm_heap/mm_compact.c
+ *
+ *   Copyright (C) 2020 Gregory Nutt. All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in
+ *    the documentation and/or other materials provided with the
+ *    distribution.
+ * 3. Neither the name NuttX nor the names of its contributors may be
+ *    used to endorse or promote products derived from this software
+ *    without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+ * FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE
+ * COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+ * INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,
+ * BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS
+ * OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED
+ * AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ * LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN
+ * ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ *
+ ****************************************************************************/
+
+/****************************************************************************
+ * Included Files
+ ****************************************************************************/
+
+#include <nuttx/config.h>
+
+#include <string.h>
+#include <assert.h>
+
+#include <nuttx/mm/mm.h>
+
+#ifdef CONFIG_MM_MOVABLE
+
+/****************************************************************************
+ * Private Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: mm_slidechunk
+ *
+ * Description:
+ *   If the chunk of a movable allocation is preceded by a free chunk, move
+ *   the allocation to the beginning of the free chunk.  The free space then
+ *   follows the allocation where it is merged with the next chunk if that
+ *   is also free.  The caller must hold the mm semaphore.
+ *
+ * Returned Value:
+ *   The number of bytes moved; zero if the chunk was not moved.
+ *
+ ****************************************************************************/
+
+static size_t mm_slidechunk(FAR struct mm_heap_s *heap,
+                            FAR struct mm_mvhandle_s *handle)
+{
+  FAR struct mm_allocnode_s *node;
+  FAR struct mm_allocnode_s *next;
+  FAR struct mm_freenode_s *prev;
+  FAR struct mm_freenode_s *freed;
+  mmsize_t preceding;
+  mmsize_t prevsize;
+  mmsize_t size;
+
+  node = (FAR struct mm_allocnode_s *)
+    ((FAR char *)handle->mh_mem - SIZEOF_MM_ALLOCNODE);
+  DEBUGASSERT(node->preceding & MM_ALLOC_BIT);
+
+  /* Is the preceding chunk free?  There is always a preceding chunk
+   * because the first chunk of each region is allocated.
+   */
+
+  prev = (FAR struct mm_freenode_s *)
+    ((FAR char *)node - (node->preceding & ~MM_ALLOC_BIT));
+  if ((prev->preceding & MM_ALLOC_BIT) != 0)
+    {
+      return 0;
+    }
+
+  /* Yes.. remove it from the free list and remember its header before it
+   * is overwritten.
+   */
+
+  mm_delfreechunk(heap, prev);
+
+  preceding = prev->preceding;
+  prevsize  = prev->size;
+  size      = node->size;
+  next      = (FAR struct mm_allocnode_s *)((FAR char *)node + size);
+
+  /* Move the header and the payload of the allocation down */
+
+  memmove(prev, node, size);
+
+  node            = (FAR struct mm_allocnode_s *)prev;
+  node->preceding = preceding | MM_ALLOC_BIT;
+
+  /* The free space now follows the allocation.  Merge it with the next
+   * chunk if that is free.  We can never index past the tail chunk because
+   * it is always allocated.
+   */
+
+  freed            = (FAR struct mm_freenode_s *)((FAR char *)node + size);
+  freed->size      = prevsize;
+  freed->preceding = size;
+
+  if ((next->preceding & MM_ALLOC_BIT) == 0)
+    {
+      mm_delfreechunk(heap, (FAR struct mm_freenode_s *)next);
+      freed->size += next->size;
+      next = (FAR struct mm_allocnode_s *)((FAR char *)next + next->size);
+    }
+
+  next->preceding = freed->size | (next->preceding & MM_ALLOC_BIT);
+  mm_addfreechunk(heap, freed);
+
+  /* Finally, tell the owner where the memory is now */
+
+  handle->mh_mem = (FAR char *)node + SIZEOF_MM_ALLOCNODE;
+  return size;
+}
+
+/****************************************************************************
+ * Public Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: mm_compact
+ *
+ * Description:
+ *   Perform one incremental step of heap compaction.  Unlocked movable
+ *   allocations are moved down into the free chunks that precede them so
+ *   that the free space collects into fewer, larger chunks.  Only movable
+ *   allocations are ever moved.
+ *
+ *   This never waits for the heap.  If the mm semaphore is not available
+ *   then nothing is done.  It is intended to be called repeatedly at low
+ *   priority, for example from the IDLE thread or the low priority work
+ *   queue.
+ *
+ * Input Parameters:
+ *   heap     - The heap to compact
+ *   maxbytes - Stop after about this many bytes were moved
+ *
+ * Returned Value:
+ *   The number of bytes moved.
+ *
+ ****************************************************************************/
+
+size_t mm_compact(FAR struct mm_heap_s *heap, size_t maxbytes)
+{
+  FAR struct mm_mvhandle_s *handle;
+  size_t moved = 0;
+  int i;
+
+  if (mm_trysemaphore(heap) < 0)
+    {
+      return 0;
+    }
+
+  /* Continue with the handle after the last one that was examined */
+
+  for (i = 0; i < CONFIG_MM_MOVABLE_NHANDLES && moved < maxbytes; i++)
+    {
+      handle = &heap->mm_mvhandles[heap->mm_mvnext];
+      if (handle->mh_mem != NULL && handle->mh_lock == 0)
+        {
+          moved += mm_slidechunk(heap, handle);
+        }
+
+      if (++heap->mm_mvnext >= CONFIG_MM_MOVABLE_NHANDLES)
+        {
+          heap->mm_mvnext = 0;
+        }
+    }
+
+  /* If a whole pass moved nothing, then there is nothing to do until some
+   * memory is freed again.
+   */
+
+  if (i >= CONFIG_MM_MOVABLE_NHANDLES && moved == 0)
+    {
+      heap->mm_mvdirty = false;
+    }
+
+  mm_givesemaphore(heap);
+  return moved;
+}
+
+#endif /* CONFIG_MM_MOVABLE */
@@ -115,6 +115,7 @@ void mm_extend(FAR struct mm_heap_s *heap, FAR void *mem, size_t size,
   newnode            = (FAR struct mm_allocnode_s *)(blockend - SIZEOF_MM_ALLOCNODE);
   newnode->size      = SIZEOF_MM_ALLOCNODE;
   newnode->preceding = oldnode->size | MM_ALLOC_BIT;
+  MM_PROFILE_GUARD(newnode);
 
   heap->mm_heapend[region] = newnode;
   mm_givesemaphore(heap);
@@ -49,39 +49,22 @@
  ****************************************************************************/
 
 /****************************************************************************
- * Name: mm_free
+ * Name: mm_freechunk
  *
  * Description:
- *   Returns a chunk of memory to the list of free nodes,  merging with
- *   adjacent free chunks if possible.
+ *   Returns an allocated chunk to the list of free nodes, merging with
+ *   adjacent free chunks if possible.  It is assumed that the caller holds
+ *   the mm semaphore.
  *
  ****************************************************************************/
 
-void mm_free(FAR struct mm_heap_s *heap, FAR void *mem)
+void mm_freechunk(FAR struct mm_heap_s *heap,
+                  FAR struct mm_allocnode_s *chunk)
 {
-  FAR struct mm_freenode_s *node;
+  FAR struct mm_freenode_s *node = (FAR struct mm_freenode_s *)chunk;
   FAR struct mm_freenode_s *prev;
   FAR struct mm_freenode_s *next;
 
-  minfo("Freeing %p\n", mem);
-
-  /* Protect against attempts to free a NULL reference */
-
-  if (!mem)
-    {
-      return;
-    }
-
-  /* We need to hold the MM semaphore while we muck with the
-   * nodelist.
-   */
-
-  mm_takesemaphore(heap);
-
-  /* Map the memory chunk into a free node */
-
-  node = (FAR struct mm_freenode_s *)((FAR char *)mem - SIZEOF_MM_ALLOCNODE);
-
   /* Sanity check against double-frees */
 
   DEBUGASSERT(node->preceding & MM_ALLOC_BIT);
@@ -107,12 +90,7 @@ void mm_free(FAR struct mm_heap_s *heap, FAR void *mem)
        * but there may not be a successor node.
        */
 
-      DEBUGASSERT(next->blink);
-      next->blink->flink = next->flink;
-      if (next->flink)
-        {
-          next->flink->blink = next->blink;
-        }
+      mm_delfreechunk(heap, next);
 
       /* Then merge the two chunks */
 
@@ -133,12 +111,7 @@ void mm_free(FAR struct mm_heap_s *heap, FAR void *mem)
        * not be a successor node.
        */
 
-      DEBUGASSERT(prev->blink);
-      prev->blink->flink = prev->flink;
-      if (prev->flink)
-        {
-          prev->flink->blink = prev->blink;
-        }
+      mm_delfreechunk(heap, prev);
 
       /* Then merge the two chunks */
 
@@ -150,5 +123,53 @@ void mm_free(FAR struct mm_heap_s *heap, FAR void *mem)
   /* Add the merged node to the nodelist */
 
   mm_addfreechunk(heap, node);
+}
+
+/****************************************************************************
+ * Name: mm_free
+ *
+ * Description:
+ *   Returns a chunk of memory to the list of free nodes,  merging with
+ *   adjacent free chunks if possible.
+ *
+ ****************************************************************************/
+
+void mm_free(FAR struct mm_heap_s *heap, FAR void *mem)
+{
+  FAR struct mm_allocnode_s *node;
+
+  minfo("Freeing %p\n", mem);
+
+  /* Protect against attempts to free a NULL reference */
+
+  if (!mem)
+    {
+      return;
+    }
+
+  /* Map the memory chunk into an allocated node */
+
+  node = (FAR struct mm_allocnode_s *)
+    ((FAR char *)mem - SIZEOF_MM_ALLOCNODE);
+
+#ifdef CONFIG_MM_PERCPU_CACHE
+  /* Small chunks are returned to the per-CPU cache if possible.  That does
+   * not require the MM semaphore.
+   */
+
+  if (node->size <= MM_CACHE_MAXCHUNK)
+    {
+      mm_cache_free(heap, node);
+      return;
+    }
+#endif
+
+  /* We need to hold the MM semaphore while we muck with the
+   * nodelist.
+   */
+
+  mm_takesemaphore(heap);
+  MM_PROFILE_FREE(heap, node);
+  mm_freechunk(heap, node);
   mm_givesemaphore(heap);
 }
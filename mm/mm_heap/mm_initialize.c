@@ -113,6 +113,7 @@ void mm_addregion(FAR struct mm_heap_s *heap, FAR void *heapstart,
   heap->mm_heapstart[IDX]            = (FAR struct mm_allocnode_s *)heapbase;
   heap->mm_heapstart[IDX]->size      = SIZEOF_MM_ALLOCNODE;
   heap->mm_heapstart[IDX]->preceding = MM_ALLOC_BIT;
+  MM_PROFILE_GUARD(heap->mm_heapstart[IDX]);
 
   node                        = (FAR struct mm_freenode_s *)(heapbase + SIZEOF_MM_ALLOCNODE);
   node->size                  = heapsize - 2*SIZEOF_MM_ALLOCNODE;
@@ -121,6 +122,7 @@ void mm_addregion(FAR struct mm_heap_s *heap, FAR void *heapstart,
   heap->mm_heapend[IDX]              = (FAR struct mm_allocnode_s *)(heapend - SIZEOF_MM_ALLOCNODE);
   heap->mm_heapend[IDX]->size        = SIZEOF_MM_ALLOCNODE;
   heap->mm_heapend[IDX]->preceding   = node->size | MM_ALLOC_BIT;
+  MM_PROFILE_GUARD(heap->mm_heapend[IDX]);
 
 #undef IDX
 
@@ -155,7 +157,9 @@ void mm_addregion(FAR struct mm_heap_s *heap, FAR void *heapstart,
 void mm_initialize(FAR struct mm_heap_s *heap, FAR void *heapstart,
                    size_t heapsize)
 {
+#ifndef CONFIG_MM_TLSF
   int i;
+#endif
 
   minfo("Heap: start=%p size=%u\n", heapstart, heapsize);
 
@@ -179,12 +183,40 @@ void mm_initialize(FAR struct mm_heap_s *heap, FAR void *heapstart,
 
   /* Initialize the node array */
 
+#ifdef CONFIG_MM_TLSF
+  /* Each bin is a separate, initially empty list */
+
+  heap->mm_flbitmap = 0;
+  memset(heap->mm_slbitmap, 0, sizeof(heap->mm_slbitmap));
+  memset(heap->mm_nodelist, 0, sizeof(struct mm_freenode_s) * MM_NBINS);
+#else
   memset(heap->mm_nodelist, 0, sizeof(struct mm_freenode_s) * MM_NNODES);
   for (i = 1; i < MM_NNODES; i++)
     {
       heap->mm_nodelist[i-1].flink = &heap->mm_nodelist[i];
       heap->mm_nodelist[i].blink   = &heap->mm_nodelist[i-1];
     }
+#endif
+
+#ifdef CONFIG_MM_PERCPU_CACHE
+  /* All of the per-CPU caches are initially empty */
+
+  memset(heap->mm_cache, 0, sizeof(heap->mm_cache));
+#endif
+
+#ifdef CONFIG_MM_HEAP_PROFILE
+  /* No task has allocated any memory yet */
+
+  memset(heap->mm_taskstats, 0, sizeof(heap->mm_taskstats));
+#endif
+
+#ifdef CONFIG_MM_MOVABLE
+  /* There are no movable allocations yet */
+
+  memset(heap->mm_mvhandles, 0, sizeof(heap->mm_mvhandles));
+  heap->mm_mvnext  = 0;
+  heap->mm_mvdirty = false;
+#endif
 
   /* Initialize the malloc semaphore to one (to support one-at-
    * a-time access to private data sets).
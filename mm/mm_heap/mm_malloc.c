@@ -43,6 +43,7 @@
 #include <assert.h>
 #include <debug.h>
 #include <string.h>
+#include <strings.h>
 
 #include <nuttx/mm/mm.h>
 
@@ -55,45 +56,136 @@
 #endif
 
 /****************************************************************************
- * Public Functions
+ * Private Functions
  ****************************************************************************/
 
 /****************************************************************************
- * Name: mm_malloc
+ * Name: mm_findfreechunk
  *
  * Description:
- *  Find the smallest chunk that satisfies the request. Take the memory from
- *  that chunk, save the remaining, smaller chunk (if any).
+ *   Locate a free chunk of at least 'size' bytes using the two-level index.
+ *   The request size is first rounded up to the next sub-bin boundary so
+ *   that every chunk in the selected bin (and in any larger bin) is
+ *   guaranteed to satisfy the request.  The first non-empty bin is then
+ *   found with a bit-scan of the second-level bitmap and, if that fails, of
+ *   the first-level bitmap.  Only requests of MM_MAX_CHUNK or more have to
+ *   search the (unordered) list of huge chunks or, as a last resort, the
+ *   list of chunks in the bin that holds the request size.
  *
- *  8-byte alignment of the allocated data is assured.
+ *   It is assumed that the caller holds the mm semaphore.
  *
  ****************************************************************************/
 
-FAR void *mm_malloc(FAR struct mm_heap_s *heap, size_t size)
+#ifdef CONFIG_MM_TLSF
+static FAR struct mm_freenode_s *
+mm_findfreechunk(FAR struct mm_heap_s *heap, size_t size)
 {
   FAR struct mm_freenode_s *node;
-  size_t alignsize;
-  void *ret = NULL;
+  unsigned int slmap;
+  unsigned int flmap;
+  size_t rounded;
   int ndx;
+  int fl;
+  int sl;
 
-  /* Ignore zero-length allocations */
+  /* Round the request up to the next sub-bin boundary */
 
-  if (size < 1)
+  rounded = size;
+  if (size < MM_MAX_CHUNK)
     {
-      return NULL;
+      fl       = fls((int)size) - 1;
+      rounded += (1 << (fl - MM_SL_SHIFT)) - 1;
     }
 
-  /* Adjust the size to account for (1) the size of the allocated node and
-   * (2) to make sure that it is an even multiple of our granule size.
+  ndx = mm_size2ndx(rounded);
+  fl  = ndx >> MM_SL_SHIFT;
+  sl  = ndx & MM_SL_MASK;
+
+  for (; ; )
+    {
+      /* Look for a non-empty sub-bin in the same size class */
+
+      slmap = heap->mm_slbitmap[fl] & (~0u << sl);
+      if (slmap == 0)
+        {
+          /* None.. look for the next larger, non-empty size class */
+
+          flmap = heap->mm_flbitmap & (~0u << (fl + 1));
+          if (flmap == 0)
+            {
+              break;
+            }
+
+          fl    = ffs((int)flmap) - 1;
+          slmap = heap->mm_slbitmap[fl];
+        }
+
+      /* Any chunk in this bin will do unless this is the bin of huge chunks
+       * (which are not sorted by size) or the first bin (which may also hold
+       * small remainder chunks).
+       */
+
+      sl = ffs((int)slmap) - 1;
+      for (node = heap->mm_nodelist[(fl << MM_SL_SHIFT) | sl].flink;
+           node && node->size < size;
+           node = node->flink);
+
+      if (node)
+        {
+          return node;
+        }
+
+      /* Try the next larger bin */
+
+      sl++;
+    }
+
+  /* There is no bin that is guaranteed to hold a large enough chunk.  The
+   * only chunks that might still fit are those in the bin that the
+   * un-rounded request maps to.  This is the only case where the search
+   * time depends on the number of free chunks but that occurs only when the
+   * heap is nearly exhausted.
    */
 
-  alignsize = MM_ALIGN_UP(size + SIZEOF_MM_ALLOCNODE);
-  DEBUGASSERT(alignsize >= size);  /* Check for integer overflow */
+  for (node = heap->mm_nodelist[mm_size2ndx(size)].flink;
+       node && node->size < size;
+       node = node->flink);
 
-  /* We need to hold the MM semaphore while we muck with the nodelist. */
+  return node;
+}
+#endif
 
-  mm_takesemaphore(heap);
+/****************************************************************************
+ * Public Functions
+ ****************************************************************************/
 
+/****************************************************************************
+ * Name: mm_mallocchunk
+ *
+ * Description:
+ *  Find the smallest chunk that satisfies the request. Take the memory from
+ *  that chunk, save the remaining, smaller chunk (if any).
+ *
+ *  'alignsize' is the size of the chunk including the allocation node
+ *  header and must be aligned to MM_MIN_CHUNK.  It is assumed that the
+ *  caller holds the mm semaphore.
+ *
+ * Returned Value:
+ *  The allocated chunk or NULL if no large enough chunk is available.
+ *
+ ****************************************************************************/
+
+FAR struct mm_allocnode_s *mm_mallocchunk(FAR struct mm_heap_s *heap,
+                                          size_t alignsize)
+{
+  FAR struct mm_freenode_s *node;
+#ifndef CONFIG_MM_TLSF
+  int ndx;
+#endif
+
+#ifdef CONFIG_MM_TLSF
+  node = mm_findfreechunk(heap, alignsize);
+#else
   /* Get the location in the node list to start the search. Special case
    * really big allocations
    */
@@ -117,6 +209,7 @@ FAR void *mm_malloc(FAR struct mm_heap_s *heap, size_t size)
   for (node = heap->mm_nodelist[ndx].flink;
        node && node->size < alignsize;
        node = node->flink);
+#endif
 
   /* If we found a node with non-zero size, then this is one to use. Since
    * the list is ordered, we know that is must be best fitting chunk
@@ -133,12 +226,7 @@ FAR void *mm_malloc(FAR struct mm_heap_s *heap, size_t size)
        * a successor node.
        */
 
-      DEBUGASSERT(node->blink);
-      node->blink->flink = node->flink;
-      if (node->flink)
-        {
-          node->flink->blink = node->blink;
-        }
+      mm_delfreechunk(heap, node);
 
       /* Check if we have to split the free node into one of the allocated
        * size and another smaller freenode.  In some cases, the remaining
@@ -180,10 +268,83 @@ FAR void *mm_malloc(FAR struct mm_heap_s *heap, size_t size)
       /* Handle the case of an exact size match */
 
       node->preceding |= MM_ALLOC_BIT;
-      ret = (void *)((FAR char *)node + SIZEOF_MM_ALLOCNODE);
     }
 
-  mm_givesemaphore(heap);
+  return (FAR struct mm_allocnode_s *)node;
+}
+
+/****************************************************************************
+ * Name: mm_malloc
+ *
+ * Description:
+ *  Find the smallest chunk that satisfies the request. Take the memory from
+ *  that chunk, save the remaining, smaller chunk (if any).
+ *
+ *  8-byte alignment of the allocated data is assured.
+ *
+ ****************************************************************************/
+
+FAR void *mm_malloc(FAR struct mm_heap_s *heap, size_t size)
+{
+  FAR struct mm_allocnode_s *node;
+  size_t alignsize;
+  void *ret = NULL;
+
+  /* Ignore zero-length allocations */
+
+  if (size < 1)
+    {
+      return NULL;
+    }
+
+  /* Adjust the size to account for (1) the size of the allocated node and
+   * (2) to make sure that it is an even multiple of our granule size.
+   */
+
+  alignsize = MM_ALIGN_UP(size + SIZEOF_MM_ALLOCNODE);
+  DEBUGASSERT(alignsize >= size);  /* Check for integer overflow */
+
+#ifdef CONFIG_MM_PERCPU_CACHE
+  /* Small allocations are satisfied from the per-CPU cache if possible.
+   * That does not require the MM semaphore.
+   */
+
+  if (alignsize <= MM_CACHE_MAXCHUNK)
+    {
+      ret = mm_cache_alloc(heap, alignsize);
+    }
+
+  if (ret == NULL)
+#endif
+    {
+      /* We need to hold the MM semaphore while we muck with the
+       * nodelist.
+       */
+
+      mm_takesemaphore(heap);
+
+      node = mm_mallocchunk(heap, alignsize);
+#ifdef CONFIG_MM_PERCPU_CACHE
+      if (node == NULL)
+        {
+          /* The cached chunks of this CPU might be what keeps the free
+           * chunks from being merged.  Return them to the heap and try
+           * again.
+           */
+
+          mm_cache_flush(heap);
+          node = mm_mallocchunk(heap, alignsize);
+        }
+#endif
+
+      if (node)
+        {
+          MM_PROFILE_ALLOC(heap, node);
+          ret = (void *)((FAR char *)node + SIZEOF_MM_ALLOCNODE);
+        }
+
+      mm_givesemaphore(heap);
+    }
 
 #ifdef CONFIG_MM_FILL_ALLOCATIONS
   if (ret)
@@ -112,6 +112,7 @@ FAR void *mm_memalign(FAR struct mm_heap_s *heap, size_t alignment,
    */
 
   node = (FAR struct mm_allocnode_s *)(rawchunk - SIZEOF_MM_ALLOCNODE);
+  MM_PROFILE_FREE(heap, node);
 
   /* Find the aligned subregion */
 
@@ -205,6 +206,7 @@ FAR void *mm_memalign(FAR struct mm_heap_s *heap, size_t alignment,
       mm_shrinkchunk(heap, node, size);
     }
 
+  MM_PROFILE_ALLOC(heap, node);
   mm_givesemaphore(heap);
   return (FAR void *)alignedchunk;
 }
@@ -0,0 +1,199 @@
+/****************************************************************************
+ * mm/mm_heap/mm_movable.c
+ *
+ *   Copyright (C) 2020 Gregory Nutt. All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in
+ *    the documentation and/or other materials provided with the
+ *    distribution.
+ * 3. Neither the name NuttX nor the names of its contributors may be
+ *    used to endorse or promote products derived from this software
+ *    without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+ * FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE
+ * COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+ * INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,
+ * BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS
+ * OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED
+ * AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ * LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN
+ * ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ *
+ ****************************************************************************/
+
+/****************************************************************************
+ * Included Files
+ ****************************************************************************/
+
+#include <nuttx/config.h>
+
+#include <assert.h>
+
+#include <nuttx/mm/mm.h>
+
+#ifdef CONFIG_MM_MOVABLE
+
+/****************************************************************************
+ * Public Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: mm_mvalloc
+ *
+ * Description:
+ *   Allocate a movable block of memory.  The memory is initially unlocked
+ *   and may be moved by mm_compact() until it is locked with mm_mvlock().
+ *
+ * Input Parameters:
+ *   heap - The heap to allocate from
+ *   size - The size of the memory block
+ *
+ * Returned Value:
+ *   The handle of the allocation or NULL if there is no free handle or
+ *   not enough memory.
+ *
+ ****************************************************************************/
+
+FAR struct mm_mvhandle_s *mm_mvalloc(FAR struct mm_heap_s *heap,
+                                     size_t size)
+{
+  FAR struct mm_mvhandle_s *handle = NULL;
+  int i;
+
+  mm_takesemaphore(heap);
+
+  /* Find an unused handle */
+
+  for (i = 0; i < CONFIG_MM_MOVABLE_NHANDLES; i++)
+    {
+      if (heap->mm_mvhandles[i].mh_mem == NULL)
+        {
+          /* Then allocate the memory.  The semaphore may be taken again
+           * by the same task.
+           */
+
+          FAR void *mem = mm_malloc(heap, size);
+          if (mem != NULL)
+            {
+              handle          = &heap->mm_mvhandles[i];
+              handle->mh_mem  = mem;
+              handle->mh_lock = 0;
+            }
+
+          break;
+        }
+    }
+
+  mm_givesemaphore(heap);
+  return handle;
+}
+
+/****************************************************************************
+ * Name: mm_mvfree
+ *
+ * Description:
+ *   Free a movable block of memory and its handle.  The memory must not be
+ *   locked.
+ *
+ * Input Parameters:
+ *   heap   - The heap that the memory was allocated from
+ *   handle - The handle returned by mm_mvalloc()
+ *
+ * Returned Value:
+ *   None
+ *
+ ****************************************************************************/
+
+void mm_mvfree(FAR struct mm_heap_s *heap, FAR struct mm_mvhandle_s *handle)
+{
+  if (handle != NULL)
+    {
+      mm_takesemaphore(heap);
+
+      DEBUGASSERT(handle->mh_mem != NULL && handle->mh_lock == 0);
+      mm_free(heap, handle->mh_mem);
+      handle->mh_mem = NULL;
+
+      mm_givesemaphore(heap);
+    }
+}
+
+/****************************************************************************
+ * Name: mm_mvlock
+ *
+ * Description:
+ *   Lock a movable block of memory in place.  The memory will not be moved
+ *   until the lock count is restored to zero with mm_mvunlock().  The
+ *   returned address must not be used after the memory is unlocked.
+ *
+ * Input Parameters:
+ *   heap   - The heap that the memory was allocated from
+ *   handle - The handle returned by mm_mvalloc()
+ *
+ * Returned Value:
+ *   The current address of the memory
+ *
+ ****************************************************************************/
+
+FAR void *mm_mvlock(FAR struct mm_heap_s *heap,
+                    FAR struct mm_mvhandle_s *handle)
+{
+  FAR void *mem;
+
+  DEBUGASSERT(handle != NULL && handle->mh_mem != NULL);
+
+  /* Taking the semaphore prevents mm_compact() from moving the memory
+   * while the lock count is incremented.
+   */
+
+  mm_takesemaphore(heap);
+
+  DEBUGASSERT(handle->mh_lock < UINT16_MAX);
+  handle->mh_lock++;
+  mem = handle->mh_mem;
+
+  mm_givesemaphore(heap);
+  return mem;
+}
+
+/****************************************************************************
+ * Name: mm_mvunlock
+ *
+ * Description:
+ *   Undo one mm_mvlock().  The memory may be moved once all locks have
+ *   been released.
+ *
+ * Input Parameters:
+ *   heap   - The heap that the memory was allocated from
+ *   handle - The handle returned by mm_mvalloc()
+ *
+ * Returned Value:
+ *   None
+ *
+ ****************************************************************************/
+
+void mm_mvunlock(FAR struct mm_heap_s *heap,
+                 FAR struct mm_mvhandle_s *handle)
+{
+  DEBUGASSERT(handle != NULL && handle->mh_mem != NULL);
+
+  mm_takesemaphore(heap);
+
+  DEBUGASSERT(handle->mh_lock > 0);
+  handle->mh_lock--;
+
+  mm_givesemaphore(heap);
+}
+
+#endif /* CONFIG_MM_MOVABLE */
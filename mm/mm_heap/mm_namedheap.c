@@ -0,0 +1,316 @@
+/****************************************************************************
+ * mm/mm_heap/mm_namedheap.c
+ *
+ *   Copyright (C) 2020 Gregory Nutt. All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in
+ *    the documentation and/or other materials provided with the
+ *    distribution.
+ * 3. Neither the name NuttX nor the names of its contributors may be
+ *    used to endorse or promote products derived from this software
+ *    without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+ * FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE
+ * COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+ * INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,
+ * BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS
+ * OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED
+ * AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ * LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN
+ * ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ *
+ ****************************************************************************/
+
+/****************************************************************************
+ * Included Files
+ ****************************************************************************/
+
+#include <nuttx/config.h>
+
+#include <string.h>
+#include <assert.h>
+#include <errno.h>
+
+#include <nuttx/arch.h>
+#include <nuttx/irq.h>
+#include <nuttx/kmalloc.h>
+#include <nuttx/mm/mm.h>
+#include <nuttx/mm/heap.h>
+
+#ifdef CONFIG_MM_NAMED_HEAPS
+
+/****************************************************************************
+ * Private Types
+ ****************************************************************************/
+
+/* This describes one registered heap */
+
+struct heap_entry_s
+{
+  FAR const char *name;         /* Name of the heap */
+  FAR struct mm_heap_s *heap;   /* The heap */
+  cpu_set_t affinity;           /* CPUs that the memory is nearest to */
+};
+
+/****************************************************************************
+ * Private Data
+ ****************************************************************************/
+
+/* The registered heaps.  Entries are only ever added, and g_nheaps is
+ * incremented only after the new entry is complete, so the table may be
+ * read without locking.
+ */
+
+static struct heap_entry_s g_heaps[CONFIG_MM_NHEAPS];
+static int g_nheaps;
+
+/****************************************************************************
+ * Private Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: heap_alloc
+ *
+ * Description:
+ *   Allocate from one heap.  'heap' is NULL for the standard user heap.
+ *
+ ****************************************************************************/
+
+static FAR void *heap_alloc(FAR struct mm_heap_s *heap, size_t alignment,
+                            size_t size)
+{
+  if (heap == NULL)
+    {
+      return alignment > 0 ? kumm_memalign(alignment, size) :
+                             kumm_malloc(size);
+    }
+
+  return alignment > 0 ? mm_memalign(heap, alignment, size) :
+                         mm_malloc(heap, size);
+}
+
+/****************************************************************************
+ * Name: heap_local
+ *
+ * Description:
+ *   Implement the HEAP_LOCAL policy:  Try the heaps with affinity to the
+ *   calling CPU, then the other named heaps and finally the user heap.
+ *
+ ****************************************************************************/
+
+static FAR void *heap_local(size_t alignment, size_t size)
+{
+  FAR void *mem;
+  int cpu = up_cpu_index();
+  int i;
+
+  for (i = 0; i < g_nheaps; i++)
+    {
+      if ((g_heaps[i].affinity & (1 << cpu)) != 0)
+        {
+          mem = heap_alloc(g_heaps[i].heap, alignment, size);
+          if (mem != NULL)
+            {
+              return mem;
+            }
+        }
+    }
+
+  for (i = 0; i < g_nheaps; i++)
+    {
+      if ((g_heaps[i].affinity & (1 << cpu)) == 0)
+        {
+          mem = heap_alloc(g_heaps[i].heap, alignment, size);
+          if (mem != NULL)
+            {
+              return mem;
+            }
+        }
+    }
+
+  return heap_alloc(NULL, alignment, size);
+}
+
+/****************************************************************************
+ * Name: heap_select
+ *
+ * Description:
+ *   Allocate according to the heap ID or policy.
+ *
+ ****************************************************************************/
+
+static FAR void *heap_select(int heapid, size_t alignment, size_t size)
+{
+  if (heapid == HEAP_DEFAULT)
+    {
+      return heap_alloc(NULL, alignment, size);
+    }
+  else if (heapid == HEAP_LOCAL)
+    {
+      return heap_local(alignment, size);
+    }
+  else if (heapid >= 0 && heapid < g_nheaps)
+    {
+      return heap_alloc(g_heaps[heapid].heap, alignment, size);
+    }
+
+  return NULL;
+}
+
+/****************************************************************************
+ * Public Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: heap_register
+ *
+ * Description:
+ *   Initialize a heap on the memory region and register it under a name
+ *   so that it can be selected with heap_malloc().  This is normally
+ *   called once during the platform heap set-up.
+ *
+ * Input Parameters:
+ *   name     - The name of the heap.  The string is not copied.
+ *   heap     - The heap structure.  It is initialized by this function.
+ *   start    - Start of the memory region managed by the heap
+ *   size     - Size of the memory region
+ *   affinity - The set of CPUs that the memory is nearest to.  Used by
+ *              the HEAP_LOCAL policy.
+ *
+ * Returned Value:
+ *   The non-negative ID of the heap on success; a negated errno value on
+ *   failure.
+ *
+ ****************************************************************************/
+
+int heap_register(FAR const char *name, FAR struct mm_heap_s *heap,
+                  FAR void *start, size_t size, cpu_set_t affinity)
+{
+  irqstate_t flags;
+  int heapid;
+
+  DEBUGASSERT(name != NULL && heap != NULL && start != NULL);
+
+  if (heap_find(name) >= 0)
+    {
+      return -EEXIST;
+    }
+
+  mm_initialize(heap, start, size);
+
+  flags = enter_critical_section();
+
+  heapid = g_nheaps;
+  if (heapid >= CONFIG_MM_NHEAPS)
+    {
+      leave_critical_section(flags);
+      return -ENOMEM;
+    }
+
+  g_heaps[heapid].name     = name;
+  g_heaps[heapid].heap     = heap;
+  g_heaps[heapid].affinity = affinity;
+  g_nheaps                 = heapid + 1;
+
+  leave_critical_section(flags);
+  return heapid;
+}
+
+/****************************************************************************
+ * Name: heap_find
+ *
+ * Description:
+ *   Look up a named heap.
+ *
+ * Input Parameters:
+ *   name - The name that was given to heap_register()
+ *
+ * Returned Value:
+ *   The non-negative ID of the heap on success; -ENOENT if there is no
+ *   heap with that name.
+ *
+ ****************************************************************************/
+
+int heap_find(FAR const char *name)
+{
+  int i;
+
+  for (i = 0; i < g_nheaps; i++)
+    {
+      if (strcmp(g_heaps[i].name, name) == 0)
+        {
+          return i;
+        }
+    }
+
+  return -ENOENT;
+}
+
+/****************************************************************************
+ * Name: heap_malloc
+ *
+ * Description:
+ *   Allocate memory from a named heap or according to a policy.
+ *
+ ****************************************************************************/
+
+FAR void *heap_malloc(int heapid, size_t size)
+{
+  return heap_select(heapid, 0, size);
+}
+
+/****************************************************************************
+ * Name: heap_memalign
+ *
+ * Description:
+ *   Allocate aligned memory from a named heap or according to a policy.
+ *
+ ****************************************************************************/
+
+FAR void *heap_memalign(int heapid, size_t alignment, size_t size)
+{
+  return heap_select(heapid, alignment, size);
+}
+
+/****************************************************************************
+ * Name: heap_free
+ *
+ * Description:
+ *   Free memory allocated with heap_malloc() or heap_memalign().  The heap
+ *   is found from the address of the memory.
+ *
+ ****************************************************************************/
+
+void heap_free(FAR void *mem)
+{
+  int i;
+
+  if (mem == NULL)
+    {
+      return;
+    }
+
+  for (i = 0; i < g_nheaps; i++)
+    {
+      if (mm_heapmember(g_heaps[i].heap, mem))
+        {
+          mm_free(g_heaps[i].heap, mem);
+          return;
+        }
+    }
+
+  kumm_free(mem);
+}
+
+#endif /* CONFIG_MM_NAMED_HEAPS */
@@ -0,0 +1,208 @@
+/****************************************************************************
+ * mm/mm_heap/mm_profile.c
+ *
+ *   Copyright (C) 2020 Gregory Nutt. All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in
+ *    the documentation and/or other materials provided with the
+ *    distribution.
+ * 3. Neither the name NuttX nor the names of its contributors may be
+ *    used to endorse or promote products derived from this software
+ *    without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+ * FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE
+ * COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+ * INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,
+ * BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS
+ * OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED
+ * AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ * LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN
+ * ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ *
+ ****************************************************************************/
+
+/****************************************************************************
+ * Included Files
+ ****************************************************************************/
+
+#include <nuttx/config.h>
+
+#include <unistd.h>
+#include <string.h>
+#include <assert.h>
+#include <errno.h>
+
+#include <nuttx/mm/mm.h>
+
+#ifdef CONFIG_MM_HEAP_PROFILE
+
+/****************************************************************************
+ * Public Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: mm_profile_alloc
+ *
+ * Description:
+ *   Charge a newly allocated chunk to the calling task.  The backtrace must
+ *   already have been recorded in the node by MM_BACKTRACE().  The caller
+ *   must hold the mm semaphore.
+ *
+ ****************************************************************************/
+
+void mm_profile_alloc(FAR struct mm_heap_s *heap,
+                      FAR struct mm_allocnode_s *node)
+{
+  FAR struct mm_taskstats_s *stats;
+  pid_t pid = getpid();
+
+  node->pid = pid;
+
+  /* If the slot belongs to a task that no longer exists, then take it
+   * over.  Chunks still owned by the old task will no longer be counted.
+   */
+
+  stats = &heap->mm_taskstats[MM_PIDHASH(pid)];
+  if (stats->pid != pid)
+    {
+      memset(stats, 0, sizeof(struct mm_taskstats_s));
+      stats->pid = pid;
+    }
+
+  stats->nchunks++;
+  stats->live += node->size;
+  if (stats->live > stats->peak)
+    {
+      stats->peak = stats->live;
+    }
+}
+
+/****************************************************************************
+ * Name: mm_profile_free
+ *
+ * Description:
+ *   Remove a chunk that is about to be freed (or resized) from the
+ *   statistics of the task that allocated it.  The caller must hold the mm
+ *   semaphore.
+ *
+ ****************************************************************************/
+
+void mm_profile_free(FAR struct mm_heap_s *heap,
+                     FAR struct mm_allocnode_s *node)
+{
+  FAR struct mm_taskstats_s *stats;
+
+  if (node->pid >= 0)
+    {
+      stats = &heap->mm_taskstats[MM_PIDHASH(node->pid)];
+      if (stats->pid == node->pid && stats->live >= node->size)
+        {
+          stats->nchunks--;
+          stats->live -= node->size;
+        }
+    }
+}
+
+/****************************************************************************
+ * Name: mm_taskinfo
+ *
+ * Description:
+ *   Return the heap usage statistics of one task.
+ *
+ * Input Parameters:
+ *   heap - The heap to examine
+ *   pid  - The task ID of interest
+ *   info - The location to return the statistics
+ *
+ * Returned Value:
+ *   Zero (OK) on success; -ENOENT if no allocations by the task have been
+ *   recorded in this heap.
+ *
+ ****************************************************************************/
+
+int mm_taskinfo(FAR struct mm_heap_s *heap, pid_t pid,
+                FAR struct mm_taskstats_s *info)
+{
+  FAR struct mm_taskstats_s *stats;
+  int ret = -ENOENT;
+
+  DEBUGASSERT(heap != NULL && info != NULL);
+
+  memset(info, 0, sizeof(struct mm_taskstats_s));
+  info->pid = pid;
+
+  mm_takesemaphore(heap);
+
+  stats = &heap->mm_taskstats[MM_PIDHASH(pid)];
+  if (stats->pid == pid)
+    {
+      memcpy(info, stats, sizeof(struct mm_taskstats_s));
+      ret = OK;
+    }
+
+  mm_givesemaphore(heap);
+  return ret;
+}
+
+/****************************************************************************
+ * Name: mm_memdump
+ *
+ * Description:
+ *   Call the handler for each allocated chunk in the heap.  The handler is
+ *   called with the mm semaphore held and so must not allocate or free
+ *   memory from this heap.
+ *
+ ****************************************************************************/
+
+void mm_memdump(FAR struct mm_heap_s *heap, mm_dumphandler_t handler,
+                FAR void *arg)
+{
+  FAR struct mm_allocnode_s *node;
+#if CONFIG_MM_REGIONS > 1
+  int region;
+#else
+# define region 0
+#endif
+
+  DEBUGASSERT(heap != NULL && handler != NULL);
+
+  /* Visit each region */
+
+#if CONFIG_MM_REGIONS > 1
+  for (region = 0; region < heap->mm_nregions; region++)
+#endif
+    {
+      /* Retake the semaphore for each region to reduce latencies */
+
+      mm_takesemaphore(heap);
+
+      for (node = heap->mm_heapstart[region];
+           node < heap->mm_heapend[region];
+           node = (FAR struct mm_allocnode_s *)
+                  ((FAR char *)node + node->size))
+        {
+          /* Skip free chunks and the guard node */
+
+          if ((node->preceding & MM_ALLOC_BIT) != 0 && node->pid >= 0)
+            {
+              handler(node, arg);
+            }
+        }
+
+      mm_givesemaphore(heap);
+    }
+#undef region
+}
+
+#endif /* CONFIG_MM_HEAP_PROFILE */
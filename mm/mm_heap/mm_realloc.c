@@ -125,7 +125,9 @@ FAR void *mm_realloc(FAR struct mm_heap_s *heap, FAR void *oldmem,
 
       if (newsize < oldsize)
         {
+          MM_PROFILE_FREE(heap, oldnode);
           mm_shrinkchunk(heap, oldnode, newsize);
+          MM_PROFILE_ALLOC(heap, oldnode);
         }
 
       /* Then return the original address */
@@ -159,6 +161,8 @@ FAR void *mm_realloc(FAR struct mm_heap_s *heap, FAR void *oldmem,
       size_t takeprev = 0;
       size_t takenext = 0;
 
+      MM_PROFILE_FREE(heap, oldnode);
+
       /* Check if we can extend into the previous chunk and if the
        * previous chunk is smaller than the next chunk.
        */
@@ -224,12 +228,7 @@ FAR void *mm_realloc(FAR struct mm_heap_s *heap, FAR void *oldmem,
            * there may not be a successor node.
            */
 
-          DEBUGASSERT(prev->blink);
-          prev->blink->flink = prev->flink;
-          if (prev->flink)
-            {
-              prev->flink->blink = prev->blink;
-            }
+          mm_delfreechunk(heap, prev);
 
           /* Extend the node into the previous free chunk */
 
@@ -291,12 +290,7 @@ FAR void *mm_realloc(FAR struct mm_heap_s *heap, FAR void *oldmem,
            * may not be a successor node.
            */
 
-          DEBUGASSERT(next->blink);
-          next->blink->flink = next->flink;
-          if (next->flink)
-            {
-              next->flink->blink = next->blink;
-            }
+          mm_delfreechunk(heap, next);
 
           /* Extend the node into the next chunk */
 
@@ -327,6 +321,7 @@ FAR void *mm_realloc(FAR struct mm_heap_s *heap, FAR void *oldmem,
             }
         }
 
+      MM_PROFILE_ALLOC(heap, oldnode);
       mm_givesemaphore(heap);
       return newmem;
     }
@@ -88,12 +88,7 @@ void  mm_shrinkchunk(FAR struct mm_heap_s *heap,
        * not be a successor node.
        */
 
-      DEBUGASSERT(next->blink);
-      next->blink->flink = next->flink;
-      if (next->flink)
-        {
-          next->flink->blink = next->blink;
-        }
+      mm_delfreechunk(heap, next);
 
       /* Create a new chunk that will hold both the next chunk and the
        * tailing memory from the aligned chunk.
@@ -39,6 +39,8 @@
 
 #include <nuttx/config.h>
 
+#include <strings.h>
+
 #include <nuttx/mm/mm.h>
 
 /****************************************************************************
@@ -51,8 +53,41 @@
  * Description:
  *    Convert the size to a nodelist index.
  *
+ *    If CONFIG_MM_TLSF is selected, the returned index selects one bin of
+ *    the two-level index:  The upper bits hold the first-level (power of
+ *    two) size class and the lower MM_SL_SHIFT bits hold the second-level
+ *    sub-bin within that class.  All chunks of MM_MAX_CHUNK or more share
+ *    the first sub-bin of the last size class; any remainder chunk smaller
+ *    than MM_MIN_CHUNK goes into the very first bin.
+ *
  ****************************************************************************/
 
+#ifdef CONFIG_MM_TLSF
+int mm_size2ndx(size_t size)
+{
+  int fl;
+  int sl;
+
+  if (size >= MM_MAX_CHUNK)
+    {
+      return (MM_NNODES - 1) << MM_SL_SHIFT;
+    }
+  else if (size < MM_MIN_CHUNK)
+    {
+      return 0;
+    }
+
+  /* The first level is given by the most significant bit of the size.  The
+   * next MM_SL_SHIFT bits below that select the sub-bin.  MM_MIN_SHIFT is
+   * never smaller than MM_SL_SHIFT so the shift is never negative.
+   */
+
+  fl = fls((int)size) - 1;
+  sl = (int)(size >> (fl - MM_SL_SHIFT)) & MM_SL_MASK;
+
+  return ((fl - MM_MIN_SHIFT) << MM_SL_SHIFT) | sl;
+}
+#else
 int mm_size2ndx(size_t size)
 {
   int ndx = 0;
@@ -71,3 +106,4 @@ int mm_size2ndx(size_t size)
 
   return ndx;
 }
+#endif
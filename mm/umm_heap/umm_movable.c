@@ -0,0 +1,115 @@
+/****************************************************************************
+ * mm/umm_heap/umm_movable.c
+ *
+ *   Copyright (C) 2020 Gregory Nutt. All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in
+ *    the documentation and/or other materials provided with the
+ *    distribution.
+ * 3. Neither the name NuttX nor the names of its contributors may be
+ *    used to endorse or promote products derived from this software
+ *    without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+ * FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE
+ * COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+ * INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,
+ * BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS
+ * OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED
+ * AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ * LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN
+ * ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ *
+ ****************************************************************************/
+
+/****************************************************************************
+ * Included Files
+ ****************************************************************************/
+
+#include <nuttx/config.h>
+
+#include <nuttx/mm/mm.h>
+
+#include "umm_heap/umm_heap.h"
+
+#ifdef CONFIG_MM_MOVABLE
+
+/****************************************************************************
+ * Public Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: umm_mvalloc, umm_mvfree, umm_mvlock and umm_mvunlock
+ *
+ * Description:
+ *   These are simple wrappers for the movable allocation interfaces that
+ *   operate on the user heap.  See mm_movable.c.
+ *
+ ****************************************************************************/
+
+FAR struct mm_mvhandle_s *umm_mvalloc(size_t size)
+{
+  return mm_mvalloc(USR_HEAP, size);
+}
+
+void umm_mvfree(FAR struct mm_mvhandle_s *handle)
+{
+  mm_mvfree(USR_HEAP, handle);
+}
+
+FAR void *umm_mvlock(FAR struct mm_mvhandle_s *handle)
+{
+  return mm_mvlock(USR_HEAP, handle);
+}
+
+void umm_mvunlock(FAR struct mm_mvhandle_s *handle)
+{
+  mm_mvunlock(USR_HEAP, handle);
+}
+
+/****************************************************************************
+ * Name: umm_compact
+ *
+ * Description:
+ *   Perform one incremental step of compaction of the user heap.  See
+ *   mm_compact().
+ *
+ * Input Parameters:
+ *   maxbytes - Stop after about this many bytes were moved
+ *
+ * Returned Value:
+ *   The number of bytes moved.
+ *
+ ****************************************************************************/
+
+size_t umm_compact(size_t maxbytes)
+{
+  return mm_compact(USR_HEAP, maxbytes);
+}
+
+/****************************************************************************
+ * Name: umm_needcompact
+ *
+ * Description:
+ *   Return true if memory was freed in the user heap since the last
+ *   compaction pass that found nothing to move.  This is only a hint and
+ *   is sampled without taking the heap semaphore.
+ *
+ ****************************************************************************/
+
+bool umm_needcompact(void)
+{
+  return (USR_HEAP)->mm_mvdirty;
+}
+
+#endif /* CONFIG_MM_MOVABLE */
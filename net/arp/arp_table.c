@@ -72,6 +72,27 @@
 
 #define ARP_MAXAGE_TICK SEC2TICK(10 * CONFIG_NET_ARP_MAXAGE)
 
+/* The ARP table is divided into sets selected by a hash of the IPv4
+ * address.  Only the ARP_NWAYS entries of one set are searched.
+ */
+
+#ifndef CONFIG_NET_ARPTAB_NSETS
+#  define CONFIG_NET_ARPTAB_NSETS 1
+#endif
+
+#if CONFIG_NET_ARPTAB_NSETS < 1 || \
+    (CONFIG_NET_ARPTAB_SIZE % CONFIG_NET_ARPTAB_NSETS) != 0
+#  error CONFIG_NET_ARPTAB_SIZE must be a multiple of CONFIG_NET_ARPTAB_NSETS
+#endif
+
+#define ARP_NWAYS       (CONFIG_NET_ARPTAB_SIZE / CONFIG_NET_ARPTAB_NSETS)
+
+#if CONFIG_NET_ARPTAB_NSETS > 1
+#  define ARP_SET(a)    (&g_arptable[arp_hash(a) * ARP_NWAYS])
+#else
+#  define ARP_SET(a)    (&g_arptable[0])
+#endif
+
 /****************************************************************************
  * Private Types
  ****************************************************************************/
@@ -140,6 +161,27 @@ static int arp_match(FAR struct net_driver_s *dev, FAR void *arg)
   return 1;
 }
 
+/****************************************************************************
+ * Name: arp_hash
+ *
+ * Description:
+ *   Select the ARP table set for an IPv4 address.  All four bytes are
+ *   folded together so that hosts on the same subnet spread evenly
+ *   regardless of byte order.
+ *
+ ****************************************************************************/
+
+#if CONFIG_NET_ARPTAB_NSETS > 1
+static inline unsigned int arp_hash(in_addr_t ipaddr)
+{
+  uint32_t hash = (uint32_t)ipaddr;
+
+  hash ^= hash >> 16;
+  hash ^= hash >> 8;
+  return (hash & 0xff) % CONFIG_NET_ARPTAB_NSETS;
+}
+#endif
+
 /****************************************************************************
  * Name: arp_return_old_entry
  *
@@ -195,33 +237,34 @@ arp_return_old_entry(FAR struct arp_entry_s *e1, FAR struct arp_entry_s *e2)
 
 int arp_update(in_addr_t ipaddr, FAR uint8_t *ethaddr)
 {
-  FAR struct arp_entry_s *tabptr = &g_arptable[0];
+  FAR struct arp_entry_s *set = ARP_SET(ipaddr);
+  FAR struct arp_entry_s *tabptr = &set[0];
   int i;
 
-  /* Walk through the ARP mapping table and try to find an entry to
+  /* Walk through the ARP mapping table set and try to find an entry to
    * update. If none is found, the IP -> MAC address mapping is
    * inserted in the ARP table.
    */
 
-  for (i = 0; i < CONFIG_NET_ARPTAB_SIZE; ++i)
+  for (i = 0; i < ARP_NWAYS; ++i)
     {
       /* Check if the source IP address of the incoming packet matches
        * the IP address in this ARP table entry.
        */
 
-      if (g_arptable[i].at_ipaddr != 0 &&
-          net_ipv4addr_cmp(ipaddr, g_arptable[i].at_ipaddr))
+      if (set[i].at_ipaddr != 0 &&
+          net_ipv4addr_cmp(ipaddr, set[i].at_ipaddr))
         {
           /* An old entry found, break. */
 
-          tabptr = &g_arptable[i];
+          tabptr = &set[i];
           break;
         }
       else
         {
           /* Record the oldest entry. */
 
-          tabptr = arp_return_old_entry(tabptr, &g_arptable[i]);
+          tabptr = arp_return_old_entry(tabptr, &set[i]);
         }
     }
 
@@ -281,14 +324,17 @@ void arp_hdr_update(FAR uint16_t *pipaddr, FAR uint8_t *ethaddr)
 
 FAR struct arp_entry_s *arp_lookup(in_addr_t ipaddr)
 {
+  FAR struct arp_entry_s *set = ARP_SET(ipaddr);
   FAR struct arp_entry_s *tabptr;
   int i;
 
-  /* Check if the IPv4 address is already in the ARP table. */
+  /* Check if the IPv4 address is already in its ARP table set.  Expired
+   * entries are simply ignored here and recycled by arp_update().
+   */
 
-  for (i = 0; i < CONFIG_NET_ARPTAB_SIZE; ++i)
+  for (i = 0; i < ARP_NWAYS; ++i)
     {
-      tabptr = &g_arptable[i];
+      tabptr = &set[i];
       if (net_ipv4addr_cmp(ipaddr, tabptr->at_ipaddr) &&
           clock_systimer() - tabptr->at_time <= ARP_MAXAGE_TICK)
         {
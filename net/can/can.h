@@ -0,0 +1,208 @@
+/****************************************************************************
+ * net/can/can.h
+ *
+ *   Copyright (C) 2020 Gregory Nutt. All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in
+ *    the documentation and/or other materials provided with the
+ *    distribution.
+ * 3. Neither the name NuttX nor the names of its contributors may be
+ *    used to endorse or promote products derived from this software
+ *    without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+ * FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE
+ * COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+ * INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,
+ * BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS
+ * OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED
+ * AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ * LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN
+ * ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ *
+ ****************************************************************************/
+
+#ifndef __NET_CAN_CAN_H
+#define __NET_CAN_CAN_H
+
+/****************************************************************************
+ * Included Files
+ ****************************************************************************/
+
+#include <nuttx/config.h>
+
+#include <sys/types.h>
+#include <stdint.h>
+#include <stdbool.h>
+#include <queue.h>
+#include <semaphore.h>
+#include <poll.h>
+
+#include <netpacket/can.h>
+
+#include "socket/socket.h"
+
+#ifdef CONFIG_NET_CAN
+
+/****************************************************************************
+ * Public Type Definitions
+ ****************************************************************************/
+
+/* A received frame and the index of the device that received it */
+
+struct can_rxframe_s
+{
+  struct can_frame frame;            /* The received frame */
+  int16_t ifindex;                   /* The device that received it */
+};
+
+/* This "connection" structure describes the underlying state of the socket.
+ * The receive queue and the poll waiters are accessed from the CAN
+ * interrupt handler and are protected by enter_critical_section().
+ */
+
+struct can_conn_s
+{
+  /* Common prologue of all connection structures. */
+
+  dq_entry_t node;                   /* Supports a doubly linked list */
+
+  /* CAN-specific content follows */
+
+  FAR struct can_dev_s *dev;         /* Bound device (NULL: All devices) */
+  uint8_t crefs;                     /* Reference counts on this instance */
+  bool bound;                        /* True: Frames are being received */
+  bool loopback;                     /* True: Receive frames sent locally */
+  uint8_t nfilters;                  /* Number of filters (0: Accept all) */
+  struct can_filter filters[CONFIG_NET_CAN_NFILTERS];
+
+  /* Received frames waiting for recvfrom() */
+
+  uint16_t rxhead;                   /* Index of the oldest frame */
+  uint16_t rxcount;                  /* Number of frames queued */
+  uint8_t nwaiters;                  /* Threads waiting in recvfrom() */
+  sem_t rxsem;                       /* Wakes up waiters when a frame arrives */
+  struct can_rxframe_s rxq[CONFIG_NET_CAN_RXQSIZE];
+
+  /* The poll waiters */
+
+  FAR struct pollfd *fds[CONFIG_NET_CAN_NPOLLWAITERS];
+};
+
+/****************************************************************************
+ * Public Data
+ ****************************************************************************/
+
+#ifdef __cplusplus
+#  define EXTERN extern "C"
+extern "C"
+{
+#else
+#  define EXTERN extern
+#endif
+
+EXTERN const struct sock_intf_s g_can_sockif;
+
+/****************************************************************************
+ * Public Function Prototypes
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: can_initialize()
+ *
+ * Description:
+ *   Initialize the CAN connection structures.  Called once and only from
+ *   the networking layer.
+ *
+ ****************************************************************************/
+
+void can_initialize(void);
+
+/****************************************************************************
+ * Name: can_alloc()
+ *
+ * Description:
+ *   Allocate a new, uninitialized CAN connection structure.  This is
+ *   normally something done by the implementation of the socket() API
+ *
+ ****************************************************************************/
+
+FAR struct can_conn_s *can_alloc(void);
+
+/****************************************************************************
+ * Name: can_free()
+ *
+ * Description:
+ *   Free a CAN connection structure that is no longer in use. This should
+ *   be done by the implementation of close().
+ *
+ ****************************************************************************/
+
+void can_free(FAR struct can_conn_s *conn);
+
+/****************************************************************************
+ * Name: can_nextconn()
+ *
+ * Description:
+ *   Traverse the list of allocated CAN connections
+ *
+ * Assumptions:
+ *   The caller is in a critical section.
+ *
+ ****************************************************************************/
+
+FAR struct can_conn_s *can_nextconn(FAR struct can_conn_s *conn);
+
+/****************************************************************************
+ * Name: can_deliver()
+ *
+ * Description:
+ *   Queue a frame to every bound CAN socket that accepts frames from the
+ *   device and whose filters match the frame.  Used both for received
+ *   frames and for the local loopback of transmitted frames.
+ *
+ * Input Parameters:
+ *   dev    - The device that received or sent the frame
+ *   frame  - The frame
+ *   sender - The socket that sent the frame (NULL for received frames)
+ *
+ * Returned Value:
+ *   OK if the frame was queued to at least one socket; -ENOENT otherwise.
+ *
+ ****************************************************************************/
+
+int can_deliver(FAR struct can_dev_s *dev, FAR const struct can_frame *frame,
+                FAR struct can_conn_s *sender);
+
+/****************************************************************************
+ * Name: can_setsockopt
+ *
+ * Description:
+ *   can_setsockopt() sets the SOL_CAN_RAW option specified by the 'option'
+ *   argument to the value pointed to by the 'value' argument for the
+ *   socket specified by the 'psock' argument.
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_NET_SOCKOPTS
+int can_setsockopt(FAR struct socket *psock, int option,
+                   FAR const void *value, socklen_t value_len);
+#endif
+
+#undef EXTERN
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* CONFIG_NET_CAN */
+#endif /* __NET_CAN_CAN_H */
@@ -0,0 +1,244 @@
+/****************************************************************************
+ * net/can/can_input.c
+ *
+ *   Copyright (C) 2020 Gregory Nutt. All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in
+ *    the documentation and/or other materials provided with the
+ *    distribution.
+ * 3. Neither the name NuttX nor the names of its contributors may be
+ *    used to endorse or promote products derived from this software
+ *    without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+ * FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE
+ * COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+ * INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,
+ * BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS
+ * OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED
+ * AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ * LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN
+ * ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ *
+ ****************************************************************************/
+
+/****************************************************************************
+ * Included Files
+ ****************************************************************************/
+
+#include <nuttx/config.h>
+
+#include <stdint.h>
+#include <stdbool.h>
+#include <string.h>
+#include <poll.h>
+#include <errno.h>
+#include <debug.h>
+
+#include <nuttx/irq.h>
+#include <nuttx/semaphore.h>
+#include <nuttx/can/can.h>
+#include <nuttx/net/can.h>
+
+#include "can/can.h"
+
+#ifdef CONFIG_NET_CAN
+
+/****************************************************************************
+ * Private Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: can_rxaccept
+ *
+ * Description:
+ *   Return true if the frame passes the filters of the socket.  A frame
+ *   passes if it matches any one filter.  CAN_INV_FILTER in the filter ID
+ *   inverts the sense of that filter.
+ *
+ ****************************************************************************/
+
+static bool can_rxaccept(FAR const struct can_conn_s *conn, canid_t id)
+{
+  FAR const struct can_filter *filter;
+  bool match;
+  int i;
+
+  if (conn->nfilters == 0)
+    {
+      return true;
+    }
+
+  for (i = 0; i < conn->nfilters; i++)
+    {
+      filter = &conn->filters[i];
+      match  = ((id ^ filter->can_id) & filter->can_mask &
+                ~CAN_INV_FILTER) == 0;
+
+      if ((filter->can_id & CAN_INV_FILTER) != 0)
+        {
+          match = !match;
+        }
+
+      if (match)
+        {
+          return true;
+        }
+    }
+
+  return false;
+}
+
+/****************************************************************************
+ * Name: can_notify
+ *
+ * Description:
+ *   Wake up the threads waiting in recvfrom() and poll() on the socket.
+ *
+ ****************************************************************************/
+
+static void can_notify(FAR struct can_conn_s *conn)
+{
+  FAR struct pollfd *fds;
+  int i;
+
+  while (conn->nwaiters > 0)
+    {
+      conn->nwaiters--;
+      nxsem_post(&conn->rxsem);
+    }
+
+  for (i = 0; i < CONFIG_NET_CAN_NPOLLWAITERS; i++)
+    {
+      fds = conn->fds[i];
+      if (fds != NULL && (fds->events & POLLIN) != 0)
+        {
+          fds->revents |= POLLIN;
+          nxsem_post(fds->sem);
+        }
+    }
+}
+
+/****************************************************************************
+ * Public Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: can_deliver()
+ *
+ * Description:
+ *   Queue a frame to every bound CAN socket that accepts frames from the
+ *   device and whose filters match the frame.
+ *
+ ****************************************************************************/
+
+int can_deliver(FAR struct can_dev_s *dev, FAR const struct can_frame *frame,
+                FAR struct can_conn_s *sender)
+{
+  FAR struct can_conn_s *conn;
+  FAR struct can_rxframe_s *rxframe;
+  irqstate_t flags;
+  int ret = -ENOENT;
+  int ndx;
+
+  flags = enter_critical_section();
+
+  for (conn = can_nextconn(NULL); conn != NULL; conn = can_nextconn(conn))
+    {
+      if (!conn->bound || conn == sender ||
+          (conn->dev != NULL && conn->dev != dev) ||
+          (sender != NULL && !conn->loopback) ||
+          !can_rxaccept(conn, frame->can_id))
+        {
+          continue;
+        }
+
+      /* Drop the frame if the receive queue of the socket is full */
+
+      if (conn->rxcount >= CONFIG_NET_CAN_RXQSIZE)
+        {
+          ninfo("Socket RX queue full, dropping ID %08x\n", frame->can_id);
+          continue;
+        }
+
+      ndx = conn->rxhead + conn->rxcount;
+      if (ndx >= CONFIG_NET_CAN_RXQSIZE)
+        {
+          ndx -= CONFIG_NET_CAN_RXQSIZE;
+        }
+
+      rxframe          = &conn->rxq[ndx];
+      rxframe->frame   = *frame;
+      rxframe->ifindex = dev->cd_ifindex;
+      conn->rxcount++;
+
+      can_notify(conn);
+      ret = OK;
+    }
+
+  leave_critical_section(flags);
+  return ret;
+}
+
+/****************************************************************************
+ * Name: can_input
+ *
+ * Description:
+ *   Handle a received CAN message.  The message is converted to a struct
+ *   can_frame once, then queued to each socket that accepts it.
+ *
+ ****************************************************************************/
+
+int can_input(FAR struct can_dev_s *dev, FAR const struct can_hdr_s *hdr,
+              FAR const uint8_t *data)
+{
+  struct can_frame frame;
+
+#ifdef CONFIG_CAN_ERRORS
+  /* Error reports are not delivered to CAN_RAW sockets */
+
+  if (hdr->ch_error)
+    {
+      return -ENOENT;
+    }
+#endif
+
+  frame.can_id = hdr->ch_id;
+#ifdef CONFIG_CAN_EXTID
+  if (hdr->ch_extid)
+    {
+      frame.can_id |= CAN_EFF_FLAG;
+    }
+#endif
+
+  if (hdr->ch_rtr)
+    {
+      frame.can_id |= CAN_RTR_FLAG;
+    }
+
+  /* A struct can_frame carries at most 8 bytes.  Larger CAN FD payloads
+   * are truncated.
+   */
+
+  frame.can_dlc = hdr->ch_dlc > CAN_MAX_DLEN ? CAN_MAX_DLEN : hdr->ch_dlc;
+  memset(frame.pad, 0, sizeof(frame.pad));
+  memset(frame.data, 0, sizeof(frame.data));
+  if (!hdr->ch_rtr)
+    {
+      memcpy(frame.data, data, frame.can_dlc);
+    }
+
+  return can_deliver(dev, &frame, NULL);
+}
+
+#endif /* CONFIG_NET_CAN */
@@ -0,0 +1,144 @@
+/****************************************************************************
+ * net/can/can_setsockopt.c
+ *
+ *   Copyright (C) 2020 Gregory Nutt. All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in
+ *    the documentation and/or other materials provided with the
+ *    distribution.
+ * 3. Neither the name NuttX nor the names of its contributors may be
+ *    used to endorse or promote products derived from this software
+ *    without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+ * FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE
+ * COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+ * INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,
+ * BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS
+ * OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED
+ * AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ * LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN
+ * ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ *
+ ****************************************************************************/
+
+/****************************************************************************
+ * Included Files
+ ****************************************************************************/
+
+#include <nuttx/config.h>
+
+#include <sys/socket.h>
+#include <stdint.h>
+#include <string.h>
+#include <errno.h>
+#include <assert.h>
+#include <debug.h>
+
+#include <netpacket/can.h>
+
+#include <nuttx/irq.h>
+#include <nuttx/net/net.h>
+
+#include "can/can.h"
+
+#if defined(CONFIG_NET_CAN) && defined(CONFIG_NET_SOCKOPTS)
+
+/****************************************************************************
+ * Public Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: can_setsockopt
+ *
+ * Description:
+ *   can_setsockopt() sets the SOL_CAN_RAW option specified by the 'option'
+ *   argument to the value pointed to by the 'value' argument for the
+ *   socket specified by the 'psock' argument.
+ *
+ *   See <netpacket/can.h> for the a complete list of values of CAN socket
+ *   options.
+ *
+ * Input Parameters:
+ *   psock     Socket structure of socket to operate on
+ *   option    identifies the option to set
+ *   value     Points to the argument value
+ *   value_len The length of the argument value
+ *
+ * Returned Value:
+ *   Returns zero (OK) on success.  On failure, it returns a negated errno
+ *   value to indicate the nature of the error.  See psock_setcockopt() for
+ *   the list of possible error values.
+ *
+ ****************************************************************************/
+
+int can_setsockopt(FAR struct socket *psock, int option,
+                   FAR const void *value, socklen_t value_len)
+{
+  FAR struct can_conn_s *conn;
+  irqstate_t flags;
+  int nfilters;
+
+  DEBUGASSERT(psock != NULL && psock->s_conn != NULL);
+  conn = (FAR struct can_conn_s *)psock->s_conn;
+
+  if (psock->s_domain != PF_CAN)
+    {
+      nerr("ERROR:  Not a CAN socket\n");
+      return -ENOPROTOOPT;
+    }
+
+  switch (option)
+    {
+      case CAN_RAW_FILTER:
+
+        /* The filters are replaced as a set.  An empty set accepts all
+         * frames.
+         */
+
+        if ((value == NULL && value_len > 0) ||
+            value_len % sizeof(struct can_filter) != 0)
+          {
+            return -EINVAL;
+          }
+
+        nfilters = value_len / sizeof(struct can_filter);
+        if (nfilters > CONFIG_NET_CAN_NFILTERS)
+          {
+            return -ENOSPC;
+          }
+
+        flags = enter_critical_section();
+        memcpy(conn->filters, value, value_len);
+        conn->nfilters = nfilters;
+        leave_critical_section(flags);
+        break;
+
+      case CAN_RAW_LOOPBACK:
+        if (value == NULL || value_len < sizeof(int))
+          {
+            return -EINVAL;
+          }
+
+        conn->loopback = *(FAR const int *)value != 0;
+        break;
+
+      default:
+        nerr("ERROR: Unrecognized CAN option: %d\n", option);
+        return -ENOPROTOOPT;
+    }
+
+  return OK;
+}
+
+#endif /* CONFIG_NET_CAN && CONFIG_NET_SOCKOPTS */
@@ -0,0 +1,737 @@
+/****************************************************************************
+ * net/can/can_sockif.c
+ *
+ *   Copyright (C) 2020 Gregory Nutt. All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in
+ *    the documentation and/or other materials provided with the
+ *    distribution.
+ * 3. Neither the name NuttX nor the names of its contributors may be
+ *    used to endorse or promote products derived from this software
+ *    without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+ * FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE
+ * COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+ * INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,
+ * BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS
+ * OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED
+ * AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ * LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN
+ * ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ *
+ ****************************************************************************/
+
+/****************************************************************************
+ * Included Files
+ ****************************************************************************/
+
+#include <nuttx/config.h>
+
+#include <sys/types.h>
+#include <sys/socket.h>
+#include <stdbool.h>
+#include <string.h>
+#include <poll.h>
+#include <assert.h>
+#include <errno.h>
+#include <debug.h>
+
+#include <nuttx/irq.h>
+#include <nuttx/clock.h>
+#include <nuttx/semaphore.h>
+#include <nuttx/can/can.h>
+#include <nuttx/net/net.h>
+
+#include "can/can.h"
+
+#ifdef CONFIG_NET_CAN
+
+/****************************************************************************
+ * Private Function Prototypes
+ ****************************************************************************/
+
+static int  can_setup(FAR struct socket *psock, int protocol);
+static sockcaps_t can_sockcaps(FAR struct socket *psock);
+static void can_addref(FAR struct socket *psock);
+static int  can_bind(FAR struct socket *psock,
+              FAR const struct sockaddr *addr, socklen_t addrlen);
+static int  can_getsockname(FAR struct socket *psock,
+              FAR struct sockaddr *addr, FAR socklen_t *addrlen);
+static int  can_getpeername(FAR struct socket *psock,
+              FAR struct sockaddr *addr, FAR socklen_t *addrlen);
+static int  can_listen(FAR struct socket *psock, int backlog);
+static int  can_connect(FAR struct socket *psock,
+              FAR const struct sockaddr *addr, socklen_t addrlen);
+static int  can_accept(FAR struct socket *psock, FAR struct sockaddr *addr,
+              FAR socklen_t *addrlen, FAR struct socket *newsock);
+static int  can_poll(FAR struct socket *psock, FAR struct pollfd *fds,
+              bool setup);
+static ssize_t can_send(FAR struct socket *psock,
+              FAR const void *buf, size_t len, int flags);
+static ssize_t can_sendto(FAR struct socket *psock, FAR const void *buf,
+              size_t len, int flags, FAR const struct sockaddr *to,
+              socklen_t tolen);
+static ssize_t can_recvfrom(FAR struct socket *psock, FAR void *buf,
+              size_t len, int flags, FAR struct sockaddr *from,
+              FAR socklen_t *fromlen);
+static int can_close(FAR struct socket *psock);
+
+/****************************************************************************
+ * Public Data
+ ****************************************************************************/
+
+const struct sock_intf_s g_can_sockif =
+{
+  can_setup,            /* si_setup */
+  can_sockcaps,         /* si_sockcaps */
+  can_addref,           /* si_addref */
+  can_bind,             /* si_bind */
+  can_getsockname,      /* si_getsockname */
+  can_getpeername,      /* si_getpeername */
+  can_listen,           /* si_listen */
+  can_connect,          /* si_connect */
+  can_accept,           /* si_accept */
+  can_poll,             /* si_poll */
+  can_send,             /* si_send */
+  can_sendto,           /* si_sendto */
+#ifdef CONFIG_NET_SENDFILE
+  NULL,                 /* si_sendfile */
+#endif
+  can_recvfrom,         /* si_recvfrom */
+  can_close             /* si_close */
+};
+
+/****************************************************************************
+ * Private Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: can_setup
+ *
+ * Description:
+ *   Called for socket() to verify that the provided socket type and
+ *   protocol are usable by this address family.  Perform any family-
+ *   specific socket fields.
+ *
+ * Input Parameters:
+ *   psock    - A pointer to a user allocated socket structure to be
+ *              initialized.
+ *   protocol - CAN socket protocol (see netpacket/can.h)
+ *
+ * Returned Value:
+ *   Zero (OK) is returned on success.  Otherwise, a negated errno value is
+ *   returned.
+ *
+ ****************************************************************************/
+
+static int can_setup(FAR struct socket *psock, int protocol)
+{
+  FAR struct can_conn_s *conn;
+
+  /* Only raw sockets of the CAN_RAW protocol are supported */
+
+  if (psock->s_domain != PF_CAN || psock->s_type != SOCK_RAW ||
+      (protocol != 0 && protocol != CAN_RAW))
+    {
+      return -EPROTONOSUPPORT;
+    }
+
+  /* Allocate the CAN socket connection structure and save it in the new
+   * socket instance.
+   */
+
+  conn = can_alloc();
+  if (conn == NULL)
+    {
+      /* Failed to reserve a connection structure */
+
+      return -ENOMEM;
+    }
+
+  /* Frames sent by other local sockets are received by default.  Set the
+   * reference count on the connection structure.  This reference count
+   * will be incremented only if the socket is dup'ed
+   */
+
+  conn->loopback = true;
+  conn->crefs    = 1;
+
+  /* Attach the connection instance to the socket */
+
+  psock->s_conn = conn;
+  return OK;
+}
+
+/****************************************************************************
+ * Name: can_sockcaps
+ *
+ * Description:
+ *   Return the bit encoded capabilities of this socket.
+ *
+ ****************************************************************************/
+
+static sockcaps_t can_sockcaps(FAR struct socket *psock)
+{
+  return 0;
+}
+
+/****************************************************************************
+ * Name: can_addref
+ *
+ * Description:
+ *   Increment the reference count on the underlying connection structure.
+ *
+ ****************************************************************************/
+
+static void can_addref(FAR struct socket *psock)
+{
+  FAR struct can_conn_s *conn;
+
+  DEBUGASSERT(psock != NULL && psock->s_conn != NULL);
+
+  conn = psock->s_conn;
+  DEBUGASSERT(conn->crefs > 0 && conn->crefs < 255);
+  conn->crefs++;
+}
+
+/****************************************************************************
+ * Name: can_bind
+ *
+ * Description:
+ *   Bind the socket to a CAN device and start receiving frames.  A device
+ *   index of zero receives from all CAN devices that are in use; such a
+ *   socket must name the device in each sendto().  Binding to a specific
+ *   device brings the device up if it is not already open.
+ *
+ * Input Parameters:
+ *   psock    Socket structure of the socket to bind
+ *   addr     Socket local address (struct sockaddr_can)
+ *   addrlen  Length of 'addr'
+ *
+ * Returned Value:
+ *   Zero (OK) is returned on success.  Otherwise, a negated errno value is
+ *   returned:
+ *
+ *   EINVAL
+ *     The address is not a valid CAN address.
+ *   ENODEV
+ *     There is no CAN device with that index.
+ *
+ ****************************************************************************/
+
+static int can_bind(FAR struct socket *psock,
+                    FAR const struct sockaddr *addr, socklen_t addrlen)
+{
+  FAR const struct sockaddr_can *canaddr;
+  FAR struct can_conn_s *conn;
+  FAR struct can_dev_s *dev = NULL;
+  irqstate_t flags;
+  int ret;
+
+  DEBUGASSERT(psock != NULL && psock->s_conn != NULL);
+
+  canaddr = (FAR const struct sockaddr_can *)addr;
+  if (canaddr == NULL || addrlen < sizeof(struct sockaddr_can) ||
+      canaddr->can_family != AF_CAN || canaddr->can_ifindex < 0)
+    {
+      return -EINVAL;
+    }
+
+  conn = (FAR struct can_conn_s *)psock->s_conn;
+
+  /* Take a reference to the new device before releasing the old one */
+
+  if (canaddr->can_ifindex > 0)
+    {
+      dev = can_lookup(canaddr->can_ifindex);
+      if (dev == NULL)
+        {
+          return -ENODEV;
+        }
+
+      ret = can_devopen(dev);
+      if (ret < 0)
+        {
+          return ret;
+        }
+    }
+
+  if (conn->dev != NULL)
+    {
+      can_devclose(conn->dev);
+    }
+
+  flags       = enter_critical_section();
+  conn->dev   = dev;
+  conn->bound = true;
+  leave_critical_section(flags);
+
+  psock->s_flags |= _SF_BOUND;
+  return OK;
+}
+
+/****************************************************************************
+ * Name: can_getsockname
+ *
+ * Description:
+ *   Return the CAN address to which the socket is bound.
+ *
+ ****************************************************************************/
+
+static int can_getsockname(FAR struct socket *psock,
+                           FAR struct sockaddr *addr,
+                           FAR socklen_t *addrlen)
+{
+  FAR struct sockaddr_can *canaddr;
+  FAR struct can_conn_s *conn;
+
+  DEBUGASSERT(psock != NULL && psock->s_conn != NULL && addr != NULL &&
+              addrlen != NULL);
+
+  if (*addrlen < sizeof(struct sockaddr_can))
+    {
+      return -EINVAL;
+    }
+
+  conn    = (FAR struct can_conn_s *)psock->s_conn;
+  canaddr = (FAR struct sockaddr_can *)addr;
+  memset(canaddr, 0, sizeof(struct sockaddr_can));
+
+  canaddr->can_family  = AF_CAN;
+  canaddr->can_ifindex = conn->dev != NULL ? conn->dev->cd_ifindex : 0;
+
+  *addrlen = sizeof(struct sockaddr_can);
+  return OK;
+}
+
+/****************************************************************************
+ * Name: can_getpeername, can_listen, can_connect, can_accept
+ *
+ * Description:
+ *   CAN_RAW sockets are connectionless and have no peer.
+ *
+ ****************************************************************************/
+
+static int can_getpeername(FAR struct socket *psock,
+                           FAR struct sockaddr *addr,
+                           FAR socklen_t *addrlen)
+{
+  return -EOPNOTSUPP;
+}
+
+static int can_listen(FAR struct socket *psock, int backlog)
+{
+  return -EOPNOTSUPP;
+}
+
+static int can_connect(FAR struct socket *psock,
+                       FAR const struct sockaddr *addr,
+                       socklen_t addrlen)
+{
+  return -EOPNOTSUPP;
+}
+
+static int can_accept(FAR struct socket *psock, FAR struct sockaddr *addr,
+                      FAR socklen_t *addrlen, FAR struct socket *newsock)
+{
+  return -EOPNOTSUPP;
+}
+
+/****************************************************************************
+ * Name: can_poll
+ *
+ * Description:
+ *   The standard poll() operation redirects operations on socket descriptors
+ *   to this function.  epoll() is built on poll() and needs nothing more.
+ *
+ * Input Parameters:
+ *   psock - An instance of the internal socket structure.
+ *   fds   - The structure describing the events to be monitored.
+ *   setup - true: Setup up the poll; false: Tear down the poll
+ *
+ * Returned Value:
+ *  0: Success; Negated errno on failure
+ *
+ ****************************************************************************/
+
+static int can_poll(FAR struct socket *psock, FAR struct pollfd *fds,
+                    bool setup)
+{
+  FAR struct can_conn_s *conn;
+  FAR struct pollfd **slot;
+  irqstate_t flags;
+  int ret = OK;
+  int i;
+
+  DEBUGASSERT(psock != NULL && psock->s_conn != NULL && fds != NULL);
+  conn = (FAR struct can_conn_s *)psock->s_conn;
+
+  flags = enter_critical_section();
+
+  if (setup)
+    {
+      /* Find an available slot for the poll structure reference */
+
+      for (i = 0; i < CONFIG_NET_CAN_NPOLLWAITERS; i++)
+        {
+          if (conn->fds[i] == NULL)
+            {
+              conn->fds[i] = fds;
+              fds->priv    = &conn->fds[i];
+              break;
+            }
+        }
+
+      if (i >= CONFIG_NET_CAN_NPOLLWAITERS)
+        {
+          fds->priv = NULL;
+          ret       = -EBUSY;
+          goto errout;
+        }
+
+      /* Frames are queued for transmission by the CAN driver, so the
+       * socket is always writable.
+       */
+
+      fds->revents |= (fds->events & POLLOUT);
+      if (conn->rxcount > 0)
+        {
+          fds->revents |= (fds->events & POLLIN);
+        }
+
+      if (fds->revents != 0)
+        {
+          nxsem_post(fds->sem);
+        }
+    }
+  else if (fds->priv != NULL)
+    {
+      /* Remove all memory of the poll setup */
+
+      slot      = (FAR struct pollfd **)fds->priv;
+      *slot     = NULL;
+      fds->priv = NULL;
+    }
+
+errout:
+  leave_critical_section(flags);
+  return ret;
+}
+
+/****************************************************************************
+ * Name: can_send
+ *
+ * Description:
+ *   Send a frame on the device to which the socket is bound.
+ *
+ ****************************************************************************/
+
+static ssize_t can_send(FAR struct socket *psock, FAR const void *buf,
+                        size_t len, int flags)
+{
+  return can_sendto(psock, buf, len, flags, NULL, 0);
+}
+
+/****************************************************************************
+ * Name: can_sendto
+ *
+ * Description:
+ *   Send one struct can_frame.  The frame is sent on the device named by
+ *   'to' or, if 'to' is NULL, on the device to which the socket is bound.
+ *   The frame is then looped back to the other CAN sockets on the device
+ *   that have CAN_RAW_LOOPBACK enabled.
+ *
+ * Input Parameters:
+ *   psock    A reference to the socket structure of the socket
+ *   buf      The struct can_frame to send
+ *   len      Length of data to send; must be sizeof(struct can_frame)
+ *   flags    Send flags.  MSG_DONTWAIT is supported.
+ *   to       Address of the device (may be NULL)
+ *   tolen    The length of the address structure
+ *
+ * Returned Value:
+ *   On success, returns the number of characters sent.  On  error, a negated
+ *   errno value is returned (see send() for the list of appropriate error
+ *   values.
+ *
+ ****************************************************************************/
+
+static ssize_t can_sendto(FAR struct socket *psock, FAR const void *buf,
+                          size_t len, int flags,
+                          FAR const struct sockaddr *to, socklen_t tolen)
+{
+  FAR const struct sockaddr_can *canaddr;
+  FAR const struct can_frame *frame;
+  FAR struct can_conn_s *conn;
+  FAR struct can_dev_s *dev;
+  struct can_msg_s msg;
+  bool nonblock;
+  ssize_t ret;
+
+  DEBUGASSERT(psock != NULL && psock->s_conn != NULL && buf != NULL);
+
+  conn  = (FAR struct can_conn_s *)psock->s_conn;
+  frame = (FAR const struct can_frame *)buf;
+
+  if (len != sizeof(struct can_frame) || frame->can_dlc > CAN_MAX_DLEN)
+    {
+      return -EINVAL;
+    }
+
+  /* Select the device */
+
+  dev = conn->dev;
+  if (to != NULL)
+    {
+      canaddr = (FAR const struct sockaddr_can *)to;
+      if (tolen < sizeof(struct sockaddr_can) ||
+          canaddr->can_family != AF_CAN)
+        {
+          return -EINVAL;
+        }
+
+      if (canaddr->can_ifindex != 0)
+        {
+          dev = can_lookup(canaddr->can_ifindex);
+          if (dev == NULL)
+            {
+              return -ENODEV;
+            }
+        }
+    }
+
+  if (dev == NULL)
+    {
+      return -EDESTADDRREQ;
+    }
+
+  /* Convert the frame to the message format of the CAN upper half */
+
+  memset(&msg, 0, sizeof(struct can_msg_s));
+  if ((frame->can_id & CAN_EFF_FLAG) != 0)
+    {
+#ifdef CONFIG_CAN_EXTID
+      msg.cm_hdr.ch_id    = frame->can_id & CAN_EFF_MASK;
+      msg.cm_hdr.ch_extid = 1;
+#else
+      return -EINVAL;
+#endif
+    }
+  else
+    {
+      msg.cm_hdr.ch_id    = frame->can_id & CAN_SFF_MASK;
+    }
+
+  msg.cm_hdr.ch_rtr = (frame->can_id & CAN_RTR_FLAG) != 0;
+  msg.cm_hdr.ch_dlc = frame->can_dlc;
+  memcpy(msg.cm_data, frame->data, frame->can_dlc);
+
+  /* Hold a reference to the device while the message is queued in case
+   * the socket is not bound to it.
+   */
+
+  ret = can_devopen(dev);
+  if (ret < 0)
+    {
+      return ret;
+    }
+
+  nonblock = _SS_ISNONBLOCK(psock->s_flags) || (flags & MSG_DONTWAIT) != 0;
+  ret      = can_devwrite(dev, (FAR const char *)&msg,
+                          CAN_MSGLEN(frame->can_dlc), nonblock);
+  can_devclose(dev);
+
+  if (ret < 0)
+    {
+      return ret;
+    }
+  else if (ret == 0)
+    {
+      return -EAGAIN;
+    }
+
+  /* Let the other local sockets see the frame */
+
+  can_deliver(dev, frame, conn);
+  return sizeof(struct can_frame);
+}
+
+/****************************************************************************
+ * Name: can_recvfrom
+ *
+ * Description:
+ *   Receive one struct can_frame.  Blocks until a frame is available unless
+ *   the socket is non-blocking or MSG_DONTWAIT is given.  recvmmsg() calls
+ *   this once for each message.
+ *
+ * Input Parameters:
+ *   psock    A pointer to a NuttX-specific, internal socket structure
+ *   buf      Buffer to receive the frame
+ *   len      Length of buffer; at least sizeof(struct can_frame)
+ *   flags    Receive flags.  MSG_DONTWAIT is supported.
+ *   from     Receives the address of the device (may be NULL)
+ *   fromlen  The length of the address structure
+ *
+ ****************************************************************************/
+
+static ssize_t can_recvfrom(FAR struct socket *psock, FAR void *buf,
+                            size_t len, int flags,
+                            FAR struct sockaddr *from,
+                            FAR socklen_t *fromlen)
+{
+  FAR struct can_rxframe_s *rxframe;
+  FAR struct sockaddr_can *canaddr;
+  FAR struct can_conn_s *conn;
+  irqstate_t irqflags;
+  int16_t ifindex;
+  int ret;
+#ifdef CONFIG_NET_SOCKOPTS
+  clock_t start = clock_systimer();
+#endif
+
+  DEBUGASSERT(psock != NULL && psock->s_conn != NULL && buf != NULL);
+
+  conn = (FAR struct can_conn_s *)psock->s_conn;
+
+  if (len < sizeof(struct can_frame))
+    {
+      return -EINVAL;
+    }
+
+  if (!conn->bound)
+    {
+      return -ENOTCONN;
+    }
+
+  irqflags = enter_critical_section();
+
+  while (conn->rxcount == 0)
+    {
+      if (_SS_ISNONBLOCK(psock->s_flags) || (flags & MSG_DONTWAIT) != 0)
+        {
+          ret = -EAGAIN;
+          goto errout;
+        }
+
+      conn->nwaiters++;
+
+#ifdef CONFIG_NET_SOCKOPTS
+      if (psock->s_rcvtimeo != 0)
+        {
+          ret = nxsem_tickwait(&conn->rxsem, start,
+                               DSEC2TICK(psock->s_rcvtimeo));
+          if (ret == -ETIMEDOUT)
+            {
+              ret = -EAGAIN;
+            }
+        }
+      else
+#endif
+        {
+          ret = nxsem_wait(&conn->rxsem);
+        }
+
+      if (ret < 0)
+        {
+          /* can_notify() did not post for us */
+
+          conn->nwaiters--;
+          goto errout;
+        }
+    }
+
+  /* Remove the oldest frame from the queue */
+
+  rxframe = &conn->rxq[conn->rxhead];
+  memcpy(buf, &rxframe->frame, sizeof(struct can_frame));
+  ifindex = rxframe->ifindex;
+
+  if (++conn->rxhead >= CONFIG_NET_CAN_RXQSIZE)
+    {
+      conn->rxhead = 0;
+    }
+
+  conn->rxcount--;
+  leave_critical_section(irqflags);
+
+  if (from != NULL && fromlen != NULL &&
+      *fromlen >= sizeof(struct sockaddr_can))
+    {
+      canaddr = (FAR struct sockaddr_can *)from;
+      memset(canaddr, 0, sizeof(struct sockaddr_can));
+      canaddr->can_family  = AF_CAN;
+      canaddr->can_ifindex = ifindex;
+      *fromlen             = sizeof(struct sockaddr_can);
+    }
+
+  return sizeof(struct can_frame);
+
+errout:
+  leave_critical_section(irqflags);
+  return ret;
+}
+
+/****************************************************************************
+ * Name: can_close
+ *
+ * Description:
+ *   Performs the close operation on a CAN socket instance.  The last close
+ *   releases the reference to the bound device.
+ *
+ * Input Parameters:
+ *   psock   Socket instance
+ *
+ * Returned Value:
+ *   0 on success; a negated errno value on failure.
+ *
+ ****************************************************************************/
+
+static int can_close(FAR struct socket *psock)
+{
+  FAR struct can_conn_s *conn = psock->s_conn;
+  irqstate_t flags;
+
+  /* Is this the last reference to the connection structure (there
+   * could be more if the socket was dup'ed).
+   */
+
+  if (conn->crefs <= 1)
+    {
+      /* Yes... stop receiving and release the device */
+
+      flags       = enter_critical_section();
+      conn->bound = false;
+      leave_critical_section(flags);
+
+      if (conn->dev != NULL)
+        {
+          can_devclose(conn->dev);
+        }
+
+      /* Free the connection structure */
+
+      conn->crefs = 0;
+      can_free(conn);
+    }
+  else
+    {
+      /* No.. Just decrement the reference count */
+
+      conn->crefs--;
+    }
+
+  return OK;
+}
+
+#endif /* CONFIG_NET_CAN */
@@ -97,6 +97,13 @@
  *                        up by the listen() command. (TCP only)
  *                   OUT: Not used
  *
+ *   UDP_READAHEAD    IN: A datagram was placed directly in the read-ahead
+ *                        queue of the UDP connection without passing
+ *                        through a device.  There is no packet in d_buf
+ *                        and the dev argument is NULL. (UDP only)
+ *                   OUT: Cleared (only) by the socket layer logic to
+ *                        indicate that the datagram was consumed.
+ *
  *   TCP_CLOSE        IN: The remote host has closed the connection, thus the
  *                        connection has gone away. (TCP only)
  *                   OUT: The socket layer signals that it wants to close the
@@ -192,6 +199,7 @@
 #define IEEE802154_POLL    TCP_POLL
 #define WPAN_POLL          TCP_POLL
 #define TCP_BACKLOG        (1 << 5)
+#define UDP_READAHEAD      TCP_BACKLOG
 #define TCP_CLOSE          (1 << 6)
 #define TCP_ABORT          (1 << 7)
 #define TCP_CONNECTED      (1 << 8)
@@ -241,6 +249,17 @@
 #  define DEVIF_IS_IPv6(dev) (0)
 #endif
 
+/* Forget the payload checksum saved by devif_send() or devif_iob_send().
+ * This must be done wherever a new packet may be built or received in
+ * d_buf without going through those functions.
+ */
+
+#ifdef CONFIG_NET_CHKSUM_COPY
+#  define DEVIF_SNDSUM_INVALIDATE(dev) do { (dev)->d_sndsumlen = 0; } while (0)
+#else
+#  define DEVIF_SNDSUM_INVALIDATE(dev)
+#endif
+
 /****************************************************************************
  * Public Type Definitions
  ****************************************************************************/
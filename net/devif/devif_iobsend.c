@@ -46,8 +46,79 @@
 #include <nuttx/mm/iob.h>
 #include <nuttx/net/netdev.h>
 
+#include "utils/utils.h"
+
 #ifdef CONFIG_MM_IOB
 
+/****************************************************************************
+ * Pre-processor Definitions
+ ****************************************************************************/
+
+#ifndef MIN
+#  define MIN(a,b) ((a) < (b) ? (a) : (b))
+#endif
+
+#define SWAP16(s) ((uint16_t)(((s) << 8) | ((s) >> 8)))
+
+/****************************************************************************
+ * Private Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: devif_iob_chksum_copyout
+ *
+ * Description:
+ *   Like iob_copyout(), but also returns the checksum of the copied data
+ *   (see chksum()).  I/O buffers may hold an odd number of bytes; a
+ *   segment starting at an odd position is summed with the bytes of the
+ *   running sum swapped, which is equivalent (RFC1071).
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_NET_CHKSUM_COPY
+static uint16_t devif_iob_chksum_copyout(FAR uint8_t *dest,
+                                         FAR const struct iob_s *iob,
+                                         unsigned int len,
+                                         unsigned int offset)
+{
+  unsigned int ncopy;
+  unsigned int pos = 0;
+  uint16_t sum = 0;
+
+  /* Skip to the I/O buffer containing the offset */
+
+  while (iob != NULL && offset >= iob->io_len)
+    {
+      offset -= iob->io_len;
+      iob     = iob->io_flink;
+    }
+
+  while (iob != NULL && pos < len)
+    {
+      ncopy = MIN(iob->io_len - offset, len - pos);
+
+      if ((pos & 1) != 0)
+        {
+          sum = SWAP16(sum);
+          sum = chksum_copy(sum, &dest[pos],
+                            &iob->io_data[iob->io_offset + offset], ncopy);
+          sum = SWAP16(sum);
+        }
+      else
+        {
+          sum = chksum_copy(sum, &dest[pos],
+                            &iob->io_data[iob->io_offset + offset], ncopy);
+        }
+
+      pos   += ncopy;
+      iob    = iob->io_flink;
+      offset = 0;
+    }
+
+  return sum;
+}
+#endif
+
 /****************************************************************************
  * Public Functions
  ****************************************************************************/
@@ -70,11 +141,24 @@
 void devif_iob_send(FAR struct net_driver_s *dev, FAR struct iob_s *iob,
                     unsigned int len, unsigned int offset)
 {
+#ifdef CONFIG_NETDEV_OFFLOAD
+  DEBUGASSERT(dev && len > 0 &&
+              (len < NETDEV_PKTSIZE(dev) ||
+               (NETDEV_HAS_FEATURE(dev, NETDEV_FEATURE_TSO) &&
+                len <= dev->d_tsomax)));
+#else
   DEBUGASSERT(dev && len > 0 && len < NETDEV_PKTSIZE(dev));
+#endif
 
   /* Copy the data from the I/O buffer chain to the device buffer */
 
+#ifdef CONFIG_NET_CHKSUM_COPY
+  dev->d_sndsum    = devif_iob_chksum_copyout(dev->d_appdata, iob, len,
+                                              offset);
+  dev->d_sndsumlen = len;
+#else
   iob_copyout(dev->d_appdata, iob, len, offset);
+#endif
   dev->d_sndlen = len;
 
 #ifdef CONFIG_NET_TCP_WRBUFFER_DUMP
@@ -45,6 +45,8 @@
 
 #include <nuttx/net/netdev.h>
 
+#include "devif/devif.h"
+
 #ifdef CONFIG_NET_PKT
 
 /****************************************************************************
@@ -108,6 +110,7 @@ void devif_pkt_send(FAR struct net_driver_s *dev, FAR const void *buf,
 
   dev->d_len    = len;
   dev->d_sndlen = len;
+  DEVIF_SNDSUM_INVALIDATE(dev);
 }
 
 #endif /* CONFIG_NET_PKT */
@@ -41,6 +41,7 @@
 #include <nuttx/config.h>
 #ifdef CONFIG_NET
 
+#include <stddef.h>
 #include <debug.h>
 
 #include <nuttx/clock.h>
@@ -512,7 +513,9 @@ static int devif_poll_udp_connections(FAR struct net_driver_s *dev,
  * Name: devif_poll_tcp_connections
  *
  * Description:
- *   Poll all UDP connections for available packets to send.
+ *   Poll TCP connections for available packets to send.  Either all
+ *   active connections or, with CONFIG_NET_TCP_TXREADY, only those on the
+ *   device's "TX ready" queue.
  *
  * Assumptions:
  *   This function is called from the MAC device driver with the network
@@ -524,6 +527,46 @@ static int devif_poll_udp_connections(FAR struct net_driver_s *dev,
 static inline int devif_poll_tcp_connections(FAR struct net_driver_s *dev,
                                              devif_poll_callback_t callback)
 {
+#ifdef CONFIG_NET_TCP_TXREADY
+  FAR struct tcp_conn_s *conn;
+  FAR dq_entry_t *entry;
+  FAR dq_entry_t *next;
+  int bstop = 0;
+
+  /* Visit only the connections on this device that have something to
+   * send.  The TCP timer still polls all connections.
+   */
+
+  for (entry = dev->d_tcptxq.head; !bstop && entry != NULL; entry = next)
+    {
+      next = entry->flink;
+      conn = (FAR struct tcp_conn_s *)
+        ((FAR uint8_t *)entry - offsetof(struct tcp_conn_s, txnode));
+
+      /* Perform the TCP TX poll */
+
+      tcp_poll(dev, conn);
+
+      /* Drop the connection from the queue if the poll produced nothing
+       * and no more TX work is expected.
+       */
+
+      if (dev->d_len == 0 && !tcp_txpending(conn))
+        {
+          tcp_txidle(conn);
+        }
+
+      /* Perform any necessary conversions on outgoing packets */
+
+      devif_packet_conversion(dev, DEVIF_TCP);
+
+      /* Call back into the driver */
+
+      bstop = callback(dev);
+    }
+
+  return bstop;
+#else
   FAR struct tcp_conn_s *conn  = NULL;
   int bstop = 0;
 
@@ -545,6 +588,7 @@ static inline int devif_poll_tcp_connections(FAR struct net_driver_s *dev,
     }
 
   return bstop;
+#endif
 }
 #else
 # define devif_poll_tcp_connections(dev, callback) (0)
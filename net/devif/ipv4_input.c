@@ -341,6 +341,10 @@ int ipv4_input(FAR struct net_driver_s *dev)
   g_netstats.ipv4.recv++;
 #endif
 
+  /* d_buf now holds a received packet, not application data */
+
+  DEVIF_SNDSUM_INVALIDATE(dev);
+
   /* Start of IP input header processing code.
    *
    * Check validity of the IP header.
@@ -519,7 +523,8 @@ int ipv4_input(FAR struct net_driver_s *dev)
         }
     }
 
-  if (ipv4_chksum(dev) != 0xffff)
+  if (!NETDEV_HAS_FEATURE(dev, NETDEV_FEATURE_RXCSUM) &&
+      ipv4_chksum(dev) != 0xffff)
     {
       /* Compute and check the IP header checksum. */
 
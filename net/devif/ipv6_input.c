@@ -289,6 +289,10 @@ int ipv6_input(FAR struct net_driver_s *dev)
   g_netstats.ipv6.recv++;
 #endif
 
+  /* d_buf now holds a received packet, not application data */
+
+  DEVIF_SNDSUM_INVALIDATE(dev);
+
   /* Start of IP input header processing code.
    *
    * Check validity of the IP header.
@@ -174,6 +174,7 @@ static void sendto_request(FAR struct net_driver_s *dev,
   /* The total size of the data (including the size of the ICMP header) */
 
   dev->d_sndlen += pstate->snd_buflen;
+  DEVIF_SNDSUM_INVALIDATE(dev);
 
   /* Initialize the IP header. */
 
@@ -139,6 +139,7 @@ void igmp_send(FAR struct net_driver_s *dev, FAR struct igmp_group_s *group,
   /* The total size of the data is the size of the IGMP header */
 
   dev->d_sndlen     = IGMP_HDRLEN;
+  DEVIF_SNDSUM_INVALIDATE(dev);
 
   /* Add the router alert option to the IPv4 header (RFC 2113) */
 
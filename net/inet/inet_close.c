@@ -220,6 +220,10 @@ end_wait:
 static inline void tcp_close_txnotify(FAR struct socket *psock,
                                       FAR struct tcp_conn_s *conn)
 {
+  /* Make sure that the next poll of the device visits this connection */
+
+  tcp_txready(conn);
+
 #ifdef CONFIG_NET_IPv4
 #ifdef CONFIG_NET_IPv6
   /* If both IPv4 and IPv6 support are enabled, then we will need to select
@@ -284,6 +288,14 @@ static inline int tcp_close_disconnect(FAR struct socket *psock)
   conn = (FAR struct tcp_conn_s *)psock->s_conn;
   DEBUGASSERT(conn != NULL);
 
+#ifdef CONFIG_NET_TCP_NAGLE
+  /* Release any data held back by TCP_CORK or MSG_MORE so that it is sent
+   * before the FIN.
+   */
+
+  conn->nagle &= ~(TCP_NAGLE_CORK | TCP_NAGLE_MORE);
+#endif
+
 #ifdef CONFIG_NET_SOLINGER
   /* SO_LINGER
    *   Lingers on a close() if data is present. This option controls the
@@ -0,0 +1,388 @@
+/****************************************************************************
+ * net/inet/inet_iob.c
+ *
+ *   Copyright (C) 2020 Gregory Nutt. All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in
+ *    the documentation and/or other materials provided with the
+ *    distribution.
+ * 3. Neither the name NuttX nor the names of its contributors may be
+ *    used to endorse or promote products derived from this software
+ *    without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+ * FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE
+ * COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+ * INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,
+ * BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS
+ * OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED
+ * AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ * LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN
+ * ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ *
+ ****************************************************************************/
+
+/****************************************************************************
+ * Included Files
+ ****************************************************************************/
+
+#include <nuttx/config.h>
+
+#include <sys/types.h>
+#include <sys/socket.h>
+#include <stdint.h>
+#include <string.h>
+#include <poll.h>
+#include <errno.h>
+#include <assert.h>
+#include <debug.h>
+
+#include <nuttx/clock.h>
+#include <nuttx/semaphore.h>
+#include <nuttx/mm/iob.h>
+#include <nuttx/net/net.h>
+
+#include "tcp/tcp.h"
+#include "udp/udp.h"
+#include "socket/socket.h"
+#include "inet/inet.h"
+
+#ifdef CONFIG_NET_ZEROCOPY
+
+/****************************************************************************
+ * Private Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: inet_tcp_dequeue
+ *
+ * Description:
+ *   Detach the I/O buffer chain at the head of the TCP read-ahead queue.
+ *
+ * Returned Value:
+ *   The number of bytes in the returned chain, zero on end-of-file,
+ *   -EAGAIN if no data is buffered yet, or another negated errno value on
+ *   failure.
+ *
+ * Assumptions:
+ *   The network is locked.
+ *
+ ****************************************************************************/
+
+#if defined(NET_TCP_HAVE_STACK) && defined(CONFIG_NET_TCP_READAHEAD)
+static ssize_t inet_tcp_dequeue(FAR struct socket *psock,
+                                FAR struct iob_s **iob)
+{
+  FAR struct tcp_conn_s *conn = (FAR struct tcp_conn_s *)psock->s_conn;
+  FAR struct iob_s *head;
+
+  /* There may be read-ahead data to be retrieved even after the socket has
+   * been disconnected.
+   */
+
+  head = iob_remove_queue(&conn->readahead);
+  if (head != NULL)
+    {
+      DEBUGASSERT(head->io_pktlen > 0);
+      ninfo("Received %d bytes\n", head->io_pktlen);
+
+      *iob = head;
+      return head->io_pktlen;
+    }
+
+  /* Nothing buffered.  A gracefully closed connection reports end-of-file;
+   * any other disconnection is an error.
+   */
+
+  if (!_SS_ISCONNECTED(psock->s_flags))
+    {
+      return _SS_ISCLOSED(psock->s_flags) ? 0 : -ENOTCONN;
+    }
+
+  return -EAGAIN;
+}
+#endif
+
+/****************************************************************************
+ * Name: inet_udp_dequeue
+ *
+ * Description:
+ *   Detach the datagram at the head of the UDP read-ahead queue.  The
+ *   source address that udp_callback() stored in front of the payload is
+ *   copied out to 'from' and trimmed from the chain.
+ *
+ * Returned Value:
+ *   The size of the datagram payload, -EAGAIN if no datagram is buffered
+ *   yet, or another negated errno value on failure.
+ *
+ * Assumptions:
+ *   The network is locked.
+ *
+ ****************************************************************************/
+
+#if defined(NET_UDP_HAVE_STACK) && defined(CONFIG_NET_UDP_READAHEAD)
+static ssize_t inet_udp_dequeue(FAR struct socket *psock,
+                                FAR struct iob_s **iob,
+                                FAR struct sockaddr *from,
+                                FAR socklen_t *fromlen)
+{
+  FAR struct udp_conn_s *conn = (FAR struct udp_conn_s *)psock->s_conn;
+  FAR struct iob_s *head;
+  uint8_t src_addr_size;
+
+  head = iob_remove_queue(&conn->readahead);
+  if (head == NULL)
+    {
+      return -EAGAIN;
+    }
+
+  if (iob_copyout(&src_addr_size, head, sizeof(uint8_t), 0) !=
+      sizeof(uint8_t))
+    {
+      iob_free_chain(head, IOBUSER_NET_UDP_READAHEAD);
+      return -EIO;
+    }
+
+  if (from != NULL && fromlen != NULL)
+    {
+      socklen_t len = *fromlen;
+
+      if (len > (socklen_t)src_addr_size)
+        {
+          len = src_addr_size;
+        }
+
+      *fromlen = iob_copyout((FAR uint8_t *)from, head, len,
+                             sizeof(uint8_t));
+    }
+
+  /* Leave only the payload in the chain */
+
+  head = iob_trimhead(head, sizeof(uint8_t) + src_addr_size,
+                      IOBUSER_NET_UDP_READAHEAD);
+  if (head == NULL)
+    {
+      return 0;
+    }
+
+  ninfo("Received %d bytes\n", head->io_pktlen);
+
+  *iob = head;
+  return head->io_pktlen;
+}
+#endif
+
+/****************************************************************************
+ * Name: inet_iob_wait
+ *
+ * Description:
+ *   Block until the socket becomes readable, honoring SO_RCVTIMEO.
+ *
+ * Returned Value:
+ *   Zero (OK) when the socket may have become readable; -EAGAIN on a
+ *   receive timeout; or another negated errno value on failure.
+ *
+ ****************************************************************************/
+
+static int inet_iob_wait(FAR struct socket *psock)
+{
+  struct pollfd fds;
+  sem_t sem;
+  int ret;
+
+  nxsem_init(&sem, 0, 0);
+  nxsem_setprotocol(&sem, SEM_PRIO_NONE);
+
+  memset(&fds, 0, sizeof(struct pollfd));
+  fds.events = POLLIN;
+  fds.sem    = &sem;
+
+  ret = psock_poll(psock, &fds, true);
+  if (ret >= 0)
+    {
+      /* Nothing to wait for if the socket is already readable */
+
+      if (fds.revents == 0)
+        {
+#ifdef CONFIG_NET_SOCKOPTS
+          if (psock->s_rcvtimeo != 0)
+            {
+              ret = nxsem_tickwait(&sem, clock_systimer(),
+                                   DSEC2TICK(psock->s_rcvtimeo));
+              if (ret == -ETIMEDOUT)
+                {
+                  ret = -EAGAIN;
+                }
+            }
+          else
+#endif
+            {
+              ret = nxsem_wait(&sem);
+            }
+        }
+
+      psock_poll(psock, &fds, false);
+    }
+
+  nxsem_destroy(&sem);
+  return ret;
+}
+
+/****************************************************************************
+ * Public Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: psock_recvfrom_iob
+ *
+ * Description:
+ *   Receive the next chunk of data from a TCP or UDP socket as an I/O
+ *   buffer chain without copying it.  For TCP the chain is the next
+ *   segment held in the read-ahead buffer; for UDP it is the payload of
+ *   the next datagram.  This is an internal OS interface for consumers
+ *   such as protocol bridges that can work directly on I/O buffers.
+ *
+ * Input Parameters:
+ *   psock    A pointer to a NuttX-specific, internal socket structure
+ *   iob      Location to return the I/O buffer chain.  The caller owns the
+ *            chain and must release it with iob_free_chain().
+ *   flags    Receive flags.  Only MSG_DONTWAIT is honored.
+ *   from     Address of source (may be NULL)
+ *   fromlen  The length of the address structure
+ *
+ * Returned Value:
+ *   On success, returns the number of bytes in the returned chain.  Zero
+ *   is returned (with *iob set to NULL) on end-of-file.  On failure, a
+ *   negated errno value is returned:  -EAGAIN if no data is available on
+ *   a non-blocking request or on a receive timeout, -EOPNOTSUPP for
+ *   sockets without read-ahead buffering.
+ *
+ ****************************************************************************/
+
+ssize_t psock_recvfrom_iob(FAR struct socket *psock, FAR struct iob_s **iob,
+                           int flags, FAR struct sockaddr *from,
+                           FAR socklen_t *fromlen)
+{
+  ssize_t ret;
+
+  DEBUGASSERT(iob != NULL);
+  *iob = NULL;
+
+  if (psock == NULL || psock->s_crefs <= 0)
+    {
+      return -EBADF;
+    }
+
+  if (psock->s_domain != PF_INET && psock->s_domain != PF_INET6)
+    {
+      return -EOPNOTSUPP;
+    }
+
+  for (; ; )
+    {
+      net_lock();
+      switch (psock->s_type)
+        {
+#if defined(NET_TCP_HAVE_STACK) && defined(CONFIG_NET_TCP_READAHEAD)
+          case SOCK_STREAM:
+            ret = inet_tcp_dequeue(psock, iob);
+            break;
+#endif
+
+#if defined(NET_UDP_HAVE_STACK) && defined(CONFIG_NET_UDP_READAHEAD)
+          case SOCK_DGRAM:
+            ret = inet_udp_dequeue(psock, iob, from, fromlen);
+            break;
+#endif
+
+          default:
+            ret = -EOPNOTSUPP;
+            break;
+        }
+
+      net_unlock();
+
+      if (ret != -EAGAIN || (flags & MSG_DONTWAIT) != 0 ||
+          _SS_ISNONBLOCK(psock->s_flags))
+        {
+          return ret;
+        }
+
+      /* Wait for data to arrive in the read-ahead buffers */
+
+      ret = inet_iob_wait(psock);
+      if (ret < 0)
+        {
+          return ret;
+        }
+    }
+}
+
+/****************************************************************************
+ * Name: psock_sendto_iob
+ *
+ * Description:
+ *   Send an I/O buffer chain on a TCP or UDP socket without copying it.
+ *   The chain is linked directly into a write buffer.  For UDP the chain
+ *   is sent as one datagram.
+ *
+ * Input Parameters:
+ *   psock    A pointer to a NuttX-specific, internal socket structure
+ *   iob      The I/O buffer chain holding the data to send
+ *   flags    Send flags
+ *   to       Address of recipient (ignored for TCP, NULL for a connected
+ *            UDP socket)
+ *   tolen    The length of the address structure
+ *
+ * Returned Value:
+ *   On success, returns the number of bytes queued and the network takes
+ *   ownership of the chain.  On failure, a negated errno value is
+ *   returned and the chain remains with the caller.  -EOPNOTSUPP is
+ *   returned for sockets without write buffering.
+ *
+ ****************************************************************************/
+
+ssize_t psock_sendto_iob(FAR struct socket *psock, FAR struct iob_s *iob,
+                         int flags, FAR const struct sockaddr *to,
+                         socklen_t tolen)
+{
+  DEBUGASSERT(iob != NULL);
+
+  if (psock == NULL || psock->s_crefs <= 0)
+    {
+      return -EBADF;
+    }
+
+  if (psock->s_domain != PF_INET && psock->s_domain != PF_INET6)
+    {
+      return -EOPNOTSUPP;
+    }
+
+  switch (psock->s_type)
+    {
+#if defined(NET_TCP_HAVE_STACK) && defined(CONFIG_NET_TCP_WRITE_BUFFERS)
+      case SOCK_STREAM:
+        return psock_tcp_send_iob(psock, iob);
+#endif
+
+#if defined(NET_UDP_HAVE_STACK) && defined(CONFIG_NET_UDP_WRITE_BUFFERS)
+      case SOCK_DGRAM:
+        return psock_udp_sendto_iob(psock, iob, flags, to, tolen);
+#endif
+
+      default:
+        return -EOPNOTSUPP;
+    }
+}
+
+#endif /* CONFIG_NET_ZEROCOPY */
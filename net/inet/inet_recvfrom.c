@@ -1042,6 +1042,23 @@ static uint16_t inet_udp_eventhandler(FAR struct net_driver_s *dev,
           flags &= ~UDP_NEWDATA;
         }
 
+#ifdef CONFIG_NET_UDP_LOCAL
+      /* A datagram from a socket on this host was placed directly in the
+       * read-ahead queue.
+       */
+
+      else if ((flags & UDP_READAHEAD) != 0)
+        {
+          inet_udp_readahead(pstate);
+          if (pstate->ir_recvlen >= 0)
+            {
+              ninfo("UDP done\n");
+              inet_udp_terminate(pstate, OK);
+              flags &= ~UDP_READAHEAD;
+            }
+        }
+#endif
+
 #ifdef CONFIG_NET_SOCKOPTS
       /* No data has been received -- this is some other event... probably a
        * poll -- check for a timeout.
@@ -1179,6 +1196,7 @@ static ssize_t inet_recvfrom_result(int result, struct inet_recvfrom_s *pstate)
  *   psock  Pointer to the socket structure for the SOCK_DRAM socket
  *   buf    Buffer to receive data
  *   len    Length of buffer
+ *   flags  Receive flags (MSG_DONTWAIT)
  *   from   INET address of source (may be NULL)
  *
  * Returned Value:
@@ -1190,8 +1208,10 @@ static ssize_t inet_recvfrom_result(int result, struct inet_recvfrom_s *pstate)
  ****************************************************************************/
 
 #ifdef NET_UDP_HAVE_STACK
-static ssize_t inet_udp_recvfrom(FAR struct socket *psock, FAR void *buf, size_t len,
-                                 FAR struct sockaddr *from, FAR socklen_t *fromlen)
+static ssize_t inet_udp_recvfrom(FAR struct socket *psock, FAR void *buf,
+                                 size_t len, int flags,
+                                 FAR struct sockaddr *from,
+                                 FAR socklen_t *fromlen)
 {
   FAR struct udp_conn_s *conn = (FAR struct udp_conn_s *)psock->s_conn;
   FAR struct net_driver_s *dev;
@@ -1231,7 +1251,7 @@ static ssize_t inet_udp_recvfrom(FAR struct socket *psock, FAR void *buf, size_t
 #ifdef CONFIG_NET_UDP_READAHEAD
   /* Handle non-blocking UDP sockets */
 
-  if (_SS_ISNONBLOCK(psock->s_flags))
+  if (_SS_ISNONBLOCK(psock->s_flags) || (flags & MSG_DONTWAIT) != 0)
     {
       /* Return the number of bytes read from the read-ahead buffer if
        * something was received (already in 'ret'); EAGAIN if not.
@@ -1270,6 +1290,9 @@ static ssize_t inet_udp_recvfrom(FAR struct socket *psock, FAR void *buf, size_t
           /* Set up the callback in the connection */
 
           state.ir_cb->flags   = (UDP_NEWDATA | UDP_POLL | NETDEV_DOWN);
+#ifdef CONFIG_NET_UDP_LOCAL
+          state.ir_cb->flags  |= UDP_READAHEAD;
+#endif
           state.ir_cb->priv    = (FAR void *)&state;
           state.ir_cb->event   = inet_udp_eventhandler;
 
@@ -1307,6 +1330,7 @@ static ssize_t inet_udp_recvfrom(FAR struct socket *psock, FAR void *buf, size_t
  *   psock  Pointer to the socket structure for the SOCK_DRAM socket
  *   buf    Buffer to receive data
  *   len    Length of buffer
+ *   flags  Receive flags (MSG_DONTWAIT)
  *   from   INET address of source (may be NULL)
  *
  * Returned Value:
@@ -1318,8 +1342,10 @@ static ssize_t inet_udp_recvfrom(FAR struct socket *psock, FAR void *buf, size_t
  ****************************************************************************/
 
 #ifdef NET_TCP_HAVE_STACK
-static ssize_t inet_tcp_recvfrom(FAR struct socket *psock, FAR void *buf, size_t len,
-                                 FAR struct sockaddr *from, FAR socklen_t *fromlen)
+static ssize_t inet_tcp_recvfrom(FAR struct socket *psock, FAR void *buf,
+                                 size_t len, int flags,
+                                 FAR struct sockaddr *from,
+                                 FAR socklen_t *fromlen)
 {
   struct inet_recvfrom_s state;
   int               ret;
@@ -1393,7 +1419,7 @@ static ssize_t inet_tcp_recvfrom(FAR struct socket *psock, FAR void *buf, size_t
 
   else
 #ifdef CONFIG_NET_TCP_READAHEAD
-  if (_SS_ISNONBLOCK(psock->s_flags))
+  if (_SS_ISNONBLOCK(psock->s_flags) || (flags & MSG_DONTWAIT) != 0)
     {
       /* Return the number of bytes read from the read-ahead buffer if
        * something was received (already in 'ret'); EAGAIN if not.
@@ -1560,7 +1586,7 @@ ssize_t inet_recvfrom(FAR struct socket *psock, FAR void *buf, size_t len,
     case SOCK_STREAM:
       {
 #ifdef NET_TCP_HAVE_STACK
-        ret = inet_tcp_recvfrom(psock, buf, len, from, fromlen);
+        ret = inet_tcp_recvfrom(psock, buf, len, flags, from, fromlen);
 #else
         ret = -ENOSYS;
 #endif
@@ -1572,7 +1598,7 @@ ssize_t inet_recvfrom(FAR struct socket *psock, FAR void *buf, size_t len,
     case SOCK_DGRAM:
       {
 #ifdef NET_UDP_HAVE_STACK
-        ret = inet_udp_recvfrom(psock, buf, len, from, fromlen);
+        ret = inet_udp_recvfrom(psock, buf, len, flags, from, fromlen);
 #else
         ret = -ENOSYS;
 #endif
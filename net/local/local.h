@@ -63,7 +63,7 @@
 #define HAVE_LOCAL_POLL 1
 #define LOCAL_ACCEPT_NPOLLWAITERS 2
 
-/* Packet format in FIFO:
+/* Packet format in FIFO (SOCK_DGRAM only, SOCK_STREAM data is not framed):
  *
  * 1. Sync bytes (7 at most)
  * 2. End/Start byte
@@ -74,6 +74,12 @@
 #define LOCAL_SYNC_BYTE   0x42     /* Byte in sync sequence */
 #define LOCAL_END_BYTE    0xbd     /* End of sync seqence */
 
+/* Name prefix of the FIFOs connecting a socketpair().  The FIFOs are
+ * unlinked as soon as both ends are opened.
+ */
+
+#define LOCAL_SOCKETPAIR_PATH "/dev/socketpair"
+
 /****************************************************************************
  * Public Type Definitions
  ****************************************************************************/
@@ -193,16 +199,8 @@ struct local_conn_s
 
     struct
     {
-      uint16_t lc_remaining;   /* (For binary compatibility with peer) */
       volatile int lc_result;  /* Result of the connection operation (client) */
     } client;
-
-    /* Fields common to connected peers (connected or accepted) */
-
-    struct
-    {
-      uint16_t lc_remaining;   /* Bytes remaining in the incoming stream */
-    } peer;
   } u;
 #endif /* CONFIG_NET_LOCAL_STREAM */
 };
@@ -374,11 +372,34 @@ int local_accept(FAR struct socket *psock, FAR struct sockaddr *addr,
                  FAR socklen_t *addrlen, FAR struct socket *newsock);
 #endif
 
+/****************************************************************************
+ * Name: local_socketpair
+ *
+ * Description:
+ *   Connect two new, unbound Unix domain stream sockets to each other.
+ *   This implements the local part of socketpair().
+ *
+ * Input Parameters:
+ *   psock0   The first socket of the pair
+ *   psock1   The second socket of the pair
+ *
+ * Returned Value:
+ *   Returns zero (OK) on success or a negated errno value on failure.
+ *
+ * Assumptions:
+ *   Network is NOT locked.
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_NET_LOCAL_STREAM
+int local_socketpair(FAR struct socket *psock0, FAR struct socket *psock1);
+#endif
+
 /****************************************************************************
  * Name: psock_local_send
  *
  * Description:
- *   Send a local packet as a stream.
+ *   Send data on a local stream.
  *
  * Input Parameters:
  *   psock    An instance of the internal socket structure.
@@ -429,6 +450,26 @@ ssize_t psock_local_sendto(FAR struct socket *psock, FAR const void *buf,
                            socklen_t tolen);
 #endif
 
+/****************************************************************************
+ * Name: local_fifo_write
+ *
+ * Description:
+ *   Write a data on the write-only FIFO.
+ *
+ * Input Parameters:
+ *   filep    File structure of write-only FIFO.
+ *   buf      Data to send
+ *   len      Length of data to send
+ *
+ * Returned Value:
+ *   Zero is returned on success; a negated errno value is returned on any
+ *   failure.
+ *
+ ****************************************************************************/
+
+int local_fifo_write(FAR struct file *filep, FAR const uint8_t *buf,
+                     size_t len);
+
 /****************************************************************************
  * Name: local_send_packet
  *
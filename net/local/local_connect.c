@@ -345,4 +345,114 @@ int psock_local_connect(FAR struct socket *psock,
   return -EADDRNOTAVAIL;
 }
 
+/****************************************************************************
+ * Name: local_socketpair
+ *
+ * Description:
+ *   Connect two new, unbound Unix domain stream sockets to each other.
+ *   The first socket takes the client role and the second one the server
+ *   role of an ordinary connection.  The FIFOs are unlinked as soon as both
+ *   sides have opened them so that nothing is left in the namespace; they
+ *   are freed when both peers are closed.
+ *
+ * Returned Value:
+ *   Returns zero (OK) on success or a negated errno value on failure.
+ *
+ ****************************************************************************/
+
+int local_socketpair(FAR struct socket *psock0, FAR struct socket *psock1)
+{
+  FAR struct local_conn_s *conn0;
+  FAR struct local_conn_s *conn1;
+  int ret;
+
+  DEBUGASSERT(psock0 && psock0->s_conn && psock1 && psock1->s_conn);
+  conn0 = (FAR struct local_conn_s *)psock0->s_conn;
+  conn1 = (FAR struct local_conn_s *)psock1->s_conn;
+
+  if (psock0->s_type != SOCK_STREAM || psock1->s_type != SOCK_STREAM)
+    {
+      return -EOPNOTSUPP;
+    }
+
+  /* Give both sides the same private FIFO name */
+
+  net_lock();
+  conn0->lc_instance_id = local_generate_instance_id();
+  net_unlock();
+
+  conn0->lc_proto = SOCK_STREAM;
+  conn0->lc_type  = LOCAL_TYPE_UNNAMED;
+  strncpy(conn0->lc_path, LOCAL_SOCKETPAIR_PATH, UNIX_PATH_MAX - 1);
+  conn0->lc_path[UNIX_PATH_MAX - 1] = '\0';
+
+  conn1->lc_proto = SOCK_STREAM;
+  conn1->lc_type  = LOCAL_TYPE_UNNAMED;
+  strncpy(conn1->lc_path, conn0->lc_path, UNIX_PATH_MAX);
+  conn1->lc_instance_id = conn0->lc_instance_id;
+
+  /* Create the FIFOs needed for the connection */
+
+  ret = local_create_fifos(conn0);
+  if (ret < 0)
+    {
+      nerr("ERROR: Failed to create FIFOs for %s: %d\n",
+           conn0->lc_path, ret);
+      return ret;
+    }
+
+  /* Open both write-only FIFOs first, so that opening the read-only FIFOs
+   * does not block.
+   */
+
+  ret = local_open_client_tx(conn0, false);
+  if (ret < 0)
+    {
+      goto errout_with_fifos;
+    }
+
+  ret = local_open_server_tx(conn1, false);
+  if (ret < 0)
+    {
+      goto errout_with_outfile0;
+    }
+
+  ret = local_open_client_rx(conn0, false);
+  if (ret < 0)
+    {
+      goto errout_with_outfile1;
+    }
+
+  ret = local_open_server_rx(conn1, false);
+  if (ret < 0)
+    {
+      goto errout_with_infile0;
+    }
+
+  /* Both sides are open.  Remove the FIFOs from the namespace. */
+
+  local_release_fifos(conn0);
+
+  conn0->lc_state = LOCAL_STATE_CONNECTED;
+  conn1->lc_state = LOCAL_STATE_CONNECTED;
+  return OK;
+
+errout_with_infile0:
+  file_close(&conn0->lc_infile);
+  conn0->lc_infile.f_inode = NULL;
+
+errout_with_outfile1:
+  file_close(&conn1->lc_outfile);
+  conn1->lc_outfile.f_inode = NULL;
+
+errout_with_outfile0:
+  file_close(&conn0->lc_outfile);
+  conn0->lc_outfile.f_inode = NULL;
+
+errout_with_fifos:
+  nerr("ERROR: Failed to open FIFOs for %s: %d\n", conn0->lc_path, ret);
+  local_release_fifos(conn0);
+  return ret;
+}
+
 #endif /* CONFIG_NET_LOCAL_STREAM */
@@ -58,7 +58,7 @@
  * Name: psock_local_send
  *
  * Description:
- *   Send a local packet as a stream.
+ *   Send data on a local stream.
  *
  * Input Parameters:
  *   psock    An instance of the internal socket structure.
@@ -93,11 +93,14 @@ ssize_t psock_local_send(FAR struct socket *psock, FAR const void *buf,
       return -ENOTCONN;
     }
 
-  /* Send the packet */
+  /* Send the data.  A stream has no message boundaries, so the data is
+   * written to the FIFO as is, without the packet framing used for
+   * datagrams.
+   */
 
-  ret = local_send_packet(&peer->lc_outfile, (FAR uint8_t *)buf, len);
+  ret = local_fifo_write(&peer->lc_outfile, (FAR const uint8_t *)buf, len);
 
-  /* If the send was successful, then the full packet will have been sent */
+  /* If the send was successful, then all of the data will have been sent */
 
   return ret < 0 ? ret : len;
 }
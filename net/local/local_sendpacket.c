@@ -69,7 +69,7 @@ static const uint8_t g_preamble[LOCAL_PREAMBLE_SIZE] =
 };
 
 /****************************************************************************
- * Private Functions
+ * Public Functions
  ****************************************************************************/
 
 /****************************************************************************
@@ -89,8 +89,8 @@ static const uint8_t g_preamble[LOCAL_PREAMBLE_SIZE] =
  *
  ****************************************************************************/
 
-static int local_fifo_write(FAR struct file *filep, FAR const uint8_t *buf,
-                            size_t len)
+int local_fifo_write(FAR struct file *filep, FAR const uint8_t *buf,
+                     size_t len)
 {
   ssize_t nwritten;
 
@@ -118,10 +118,6 @@ static int local_fifo_write(FAR struct file *filep, FAR const uint8_t *buf,
   return OK;
 }
 
-/****************************************************************************
- * Public Functions
- ****************************************************************************/
-
 /****************************************************************************
  * Name: local_send_packet
  *
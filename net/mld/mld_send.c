@@ -187,6 +187,7 @@ void mld_send(FAR struct net_driver_s *dev, FAR struct mld_group_s *group,
    */
 
   dev->d_sndlen  = RASIZE + mldsize;
+  DEVIF_SNDSUM_INVALIDATE(dev);
 
   /* Set up the IPv6 header */
 
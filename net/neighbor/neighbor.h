@@ -57,6 +57,32 @@
 
 #ifdef CONFIG_NET_IPv6
 
+/****************************************************************************
+ * Pre-processor Definitions
+ ****************************************************************************/
+
+/* The Neighbor Table is divided into sets selected by a hash of the IPv6
+ * address.  Only the NEIGHBOR_NWAYS entries of one set are searched.
+ */
+
+#ifndef CONFIG_NET_IPv6_NCONF_NSETS
+#  define CONFIG_NET_IPv6_NCONF_NSETS 1
+#endif
+
+#if CONFIG_NET_IPv6_NCONF_NSETS < 1 || \
+    (CONFIG_NET_IPv6_NCONF_ENTRIES % CONFIG_NET_IPv6_NCONF_NSETS) != 0
+#  error CONFIG_NET_IPv6_NCONF_ENTRIES must be a multiple of CONFIG_NET_IPv6_NCONF_NSETS
+#endif
+
+#define NEIGHBOR_NWAYS \
+  (CONFIG_NET_IPv6_NCONF_ENTRIES / CONFIG_NET_IPv6_NCONF_NSETS)
+
+#if CONFIG_NET_IPv6_NCONF_NSETS > 1
+#  define NEIGHBOR_SET(a) (&g_neighbors[neighbor_hash(a) * NEIGHBOR_NWAYS])
+#else
+#  define NEIGHBOR_SET(a) (&g_neighbors[0])
+#endif
+
 /****************************************************************************
  * Public Data
  ****************************************************************************/
@@ -73,6 +99,25 @@ extern struct neighbor_entry_s g_neighbors[CONFIG_NET_IPv6_NCONF_ENTRIES];
 
 struct net_driver_s; /* Forward reference */
 
+/****************************************************************************
+ * Name: neighbor_hash
+ *
+ * Description:
+ *   Select the Neighbor Table set for an IPv6 address.  The interface
+ *   identifier (the low 64 bits) is folded into a set index.
+ *
+ ****************************************************************************/
+
+#if CONFIG_NET_IPv6_NCONF_NSETS > 1
+static inline unsigned int neighbor_hash(const net_ipv6addr_t ipaddr)
+{
+  uint16_t hash = ipaddr[4] ^ ipaddr[5] ^ ipaddr[6] ^ ipaddr[7];
+
+  hash ^= hash >> 8;
+  return (hash & 0xff) % CONFIG_NET_IPv6_NCONF_NSETS;
+}
+#endif
+
 /****************************************************************************
  * Name: neighbor_findentry
  *
@@ -81,6 +81,7 @@
 void neighbor_add(FAR struct net_driver_s *dev, FAR net_ipv6addr_t ipaddr,
                   FAR uint8_t *addr)
 {
+  FAR struct neighbor_entry_s *set;
   uint8_t lltype;
   clock_t oldest_time;
   int     oldest_ndx;
@@ -88,29 +89,31 @@ void neighbor_add(FAR struct net_driver_s *dev, FAR net_ipv6addr_t ipaddr,
 
   DEBUGASSERT(dev != NULL && addr != NULL);
 
-  /* Find the matching entry, first unused entry, or the oldest used entry.
-   * The unused entry will have ne_time == 0 and should generate the oldest
-   * time.  REVISIT:  Could this fail on clock wraparound?  A more explicit
-   * check might be to compare ne_ipaddr with the IPv6 unspecified address.
+  /* Find the matching entry, first unused entry, or the oldest used entry
+   * within the set selected by the IPv6 address.  The unused entry will
+   * have ne_time == 0 and should generate the oldest time.  REVISIT:  Could
+   * this fail on clock wraparound?  A more explicit check might be to
+   * compare ne_ipaddr with the IPv6 unspecified address.
    */
 
-  oldest_time = g_neighbors[0].ne_time;
+  set         = NEIGHBOR_SET(ipaddr);
+  oldest_time = set[0].ne_time;
   oldest_ndx  = 0;
   lltype      = dev->d_lltype;
 
-  for (i = 0; i < CONFIG_NET_IPv6_NCONF_ENTRIES; ++i)
+  for (i = 0; i < NEIGHBOR_NWAYS; ++i)
     {
-      if (g_neighbors[i].ne_addr.na_lltype == lltype &&
-          net_ipv6addr_cmp(g_neighbors[i].ne_ipaddr, ipaddr))
+      if (set[i].ne_addr.na_lltype == lltype &&
+          net_ipv6addr_cmp(set[i].ne_ipaddr, ipaddr))
         {
           oldest_ndx = i;
           break;
         }
 
-      if ((int)(g_neighbors[i].ne_time - oldest_time) < 0)
+      if ((int)(set[i].ne_time - oldest_time) < 0)
         {
           oldest_ndx = i;
-          oldest_time = g_neighbors[i].ne_time;
+          oldest_time = set[i].ne_time;
         }
     }
 
@@ -118,16 +121,16 @@ void neighbor_add(FAR struct net_driver_s *dev, FAR net_ipv6addr_t ipaddr,
    * "oldest_ndx" variable).
    */
 
-  g_neighbors[oldest_ndx].ne_time = clock_systimer();
-  net_ipv6addr_copy(g_neighbors[oldest_ndx].ne_ipaddr, ipaddr);
+  set[oldest_ndx].ne_time = clock_systimer();
+  net_ipv6addr_copy(set[oldest_ndx].ne_ipaddr, ipaddr);
 
-  g_neighbors[oldest_ndx].ne_addr.na_lltype = lltype;
-  g_neighbors[oldest_ndx].ne_addr.na_llsize = netdev_lladdrsize(dev);
+  set[oldest_ndx].ne_addr.na_lltype = lltype;
+  set[oldest_ndx].ne_addr.na_llsize = netdev_lladdrsize(dev);
 
-  memcpy(&g_neighbors[oldest_ndx].ne_addr.u, addr,
-         g_neighbors[oldest_ndx].ne_addr.na_llsize);
+  memcpy(&set[oldest_ndx].ne_addr.u, addr,
+         set[oldest_ndx].ne_addr.na_llsize);
 
   /* Dump the contents of the new entry */
 
-  neighbor_dumpentry("Added entry", &g_neighbors[oldest_ndx]);
+  neighbor_dumpentry("Added entry", &set[oldest_ndx]);
 }
@@ -70,11 +70,12 @@
 
 FAR struct neighbor_entry_s *neighbor_findentry(const net_ipv6addr_t ipaddr)
 {
+  FAR struct neighbor_entry_s *set = NEIGHBOR_SET(ipaddr);
   int i;
 
-  for (i = 0; i < CONFIG_NET_IPv6_NCONF_ENTRIES; ++i)
+  for (i = 0; i < NEIGHBOR_NWAYS; ++i)
     {
-      FAR struct neighbor_entry_s *neighbor = &g_neighbors[i];
+      FAR struct neighbor_entry_s *neighbor = &set[i];
 
       if (net_ipv6addr_cmp(neighbor->ne_ipaddr, ipaddr))
         {
@@ -60,6 +60,7 @@
 #include "ieee802154/ieee802154.h"
 #include "local/local.h"
 #include "netlink/netlink.h"
+#include "can/can.h"
 #include "igmp/igmp.h"
 #include "route/route.h"
 #include "usrsock/usrsock.h"
@@ -164,6 +165,12 @@ void net_initialize(void)
   netlink_initialize();
 #endif
 
+#ifdef CONFIG_NET_CAN
+  /* Initialize the CAN socket support */
+
+  can_initialize();
+#endif
+
 #ifdef NET_TCP_HAVE_STACK
   /* Initialize the listening port structures */
 
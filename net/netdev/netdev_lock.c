@@ -0,0 +1,158 @@
+/****************************************************************************
+ * net/netdev/netdev_lock.c
+ *
+ *   Copyright (C) 2020 Gregory Nutt. All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in
+ *    the documentation and/or other materials provided with the
+ *    distribution.
+ * 3. Neither the name NuttX nor the names of its contributors may be
+ *    used to endorse or promote products derived from this software
+ *    without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+ * FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE
+ * COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+ * INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,
+ * BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS
+ * OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED
+ * AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ * LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN
+ * ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ *
+ ****************************************************************************/
+
+/****************************************************************************
+ * Included Files
+ ****************************************************************************/
+
+#include <nuttx/config.h>
+
+#include <unistd.h>
+#include <assert.h>
+
+#include <nuttx/irq.h>
+#include <nuttx/semaphore.h>
+#include <nuttx/net/netdev.h>
+
+#include "netdev/netdev.h"
+
+#ifdef CONFIG_NETDEV_LOCK
+
+/****************************************************************************
+ * Pre-processor Definitions
+ ****************************************************************************/
+
+#define NO_HOLDER (pid_t)-1
+
+/****************************************************************************
+ * Public Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: netdev_lock
+ *
+ * Description:
+ *   Take the per-device driver lock.  See include/nuttx/net/netdev.h.
+ *
+ * Input Parameters:
+ *   dev - The network device to be locked.
+ *
+ * Returned Value:
+ *   Zero (OK) is returned on success; a negated errno value is returned on
+ *   failure (probably -ECANCELED).
+ *
+ ****************************************************************************/
+
+int netdev_lock(FAR struct net_driver_s *dev)
+{
+#ifdef CONFIG_SMP
+  irqstate_t flags = enter_critical_section();
+#endif
+  pid_t me = getpid();
+  int ret = OK;
+
+  DEBUGASSERT(dev != NULL);
+
+  /* Does this thread already hold the device lock? */
+
+  if (dev->d_lockholder == me)
+    {
+      /* Yes.. just increment the reference count */
+
+      dev->d_lockcount++;
+    }
+  else
+    {
+      /* No.. take the semaphore (perhaps waiting) */
+
+      ret = nxsem_wait_uninterruptible(&dev->d_lock);
+      if (ret >= 0)
+        {
+          /* Now this thread holds the device lock */
+
+          dev->d_lockholder = me;
+          dev->d_lockcount  = 1;
+        }
+    }
+
+#ifdef CONFIG_SMP
+  leave_critical_section(flags);
+#endif
+  return ret;
+}
+
+/****************************************************************************
+ * Name: netdev_unlock
+ *
+ * Description:
+ *   Release the per-device driver lock.
+ *
+ * Input Parameters:
+ *   dev - The network device to be unlocked.
+ *
+ * Returned Value:
+ *   None
+ *
+ ****************************************************************************/
+
+void netdev_unlock(FAR struct net_driver_s *dev)
+{
+#ifdef CONFIG_SMP
+  irqstate_t flags = enter_critical_section();
+#endif
+
+  DEBUGASSERT(dev != NULL && dev->d_lockholder == getpid() &&
+              dev->d_lockcount > 0);
+
+  /* If the count would go to zero, then release the semaphore */
+
+  if (dev->d_lockcount == 1)
+    {
+      dev->d_lockholder = NO_HOLDER;
+      dev->d_lockcount  = 0;
+      nxsem_post(&dev->d_lock);
+    }
+  else
+    {
+      /* We still hold the lock. Just decrement the count */
+
+      dev->d_lockcount--;
+    }
+
+#ifdef CONFIG_SMP
+  leave_critical_section(flags);
+#endif
+}
+
+#endif /* CONFIG_NETDEV_LOCK */
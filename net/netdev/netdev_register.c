@@ -49,6 +49,7 @@
 
 #include <net/if.h>
 #include <net/ethernet.h>
+#include <nuttx/semaphore.h>
 #include <nuttx/net/netconfig.h>
 #include <nuttx/net/netdev.h>
 #include <nuttx/net/ethernet.h>
@@ -342,6 +343,20 @@ int netdev_register(FAR struct net_driver_s *dev, enum net_lltype_e lltype)
       dev->d_conncb = NULL;
       dev->d_devcb = NULL;
 
+#ifdef CONFIG_NET_TCP_TXREADY
+      /* No TCP connections are waiting to send on this device yet */
+
+      dq_init(&dev->d_tcptxq);
+#endif
+
+#ifdef CONFIG_NETDEV_LOCK
+      /* Initialize the per-device driver lock */
+
+      nxsem_init(&dev->d_lock, 0, 1);
+      dev->d_lockholder = (pid_t)-1;
+      dev->d_lockcount  = 0;
+#endif
+
       /* We need exclusive access for the following operations */
 
       net_lock();
@@ -0,0 +1,463 @@
+/****************************************************************************
+ * net/netdev/netdev_rxqueue.c
+ *
+ *   Copyright (C) 2020 Gregory Nutt. All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in
+ *    the documentation and/or other materials provided with the
+ *    distribution.
+ * 3. Neither the name NuttX nor the names of its contributors may be
+ *    used to endorse or promote products derived from this software
+ *    without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+ * FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE
+ * COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+ * INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,
+ * BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS
+ * OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED
+ * AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ * LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN
+ * ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ *
+ ****************************************************************************/
+
+/****************************************************************************
+ * Included Files
+ ****************************************************************************/
+
+#include <nuttx/config.h>
+
+#include <stdint.h>
+#include <stdbool.h>
+#include <string.h>
+#include <errno.h>
+#include <assert.h>
+#include <debug.h>
+
+#include <nuttx/spinlock.h>
+#include <nuttx/wqueue.h>
+#include <nuttx/mm/iob.h>
+#include <nuttx/net/net.h>
+#include <nuttx/net/netdev.h>
+
+#ifdef CONFIG_NETDEV_RXQUEUE_GRO
+#  include <nuttx/net/ethernet.h>
+#  include <nuttx/net/ip.h>
+#  include <nuttx/net/tcp.h>
+#endif
+
+#include "netdev/netdev.h"
+
+#ifdef CONFIG_NETDEV_RXQUEUE
+
+/****************************************************************************
+ * Pre-processor Definitions
+ ****************************************************************************/
+
+#if (CONFIG_NETDEV_RXQUEUE_DEPTH & (CONFIG_NETDEV_RXQUEUE_DEPTH - 1)) != 0
+#  error CONFIG_NETDEV_RXQUEUE_DEPTH must be a power of two
+#endif
+
+/* The ring slots and indices are volatile, which orders their accesses on
+ * a single CPU.  With SMP, a memory barrier is also needed between a slot
+ * and the index that publishes it.
+ */
+
+#ifndef SP_DMB
+#  define SP_DMB()
+#endif
+
+#define RXQ_MASK    (CONFIG_NETDEV_RXQUEUE_DEPTH - 1)
+#define RXQ_USED(q) ((uint16_t)((q)->rq_head - (q)->rq_tail))
+
+#ifdef CONFIG_NETDEV_RXQUEUE_HPWORK
+#  define RXQWORK HPWORK
+#else
+#  define RXQWORK LPWORK
+#endif
+
+#ifdef CONFIG_NETDEV_RXQUEUE_GRO
+/* The largest headers of a segment that can be merged:  Ethernet, IPv4
+ * without options and TCP with up to 40 bytes of options.
+ */
+
+#  define GRO_MAXHDR (ETH_HDRLEN + IPv4_HDRLEN + TCP_HDRLEN + 40)
+
+#  define GRO_IPHDR(p)  ((FAR struct ipv4_hdr_s *)&(p)[ETH_HDRLEN])
+#  define GRO_TCPHDR(p) \
+     ((FAR struct tcp_hdr_s *)&(p)[ETH_HDRLEN + IPv4_HDRLEN])
+#endif
+
+/****************************************************************************
+ * Private Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: netdev_gro_parse
+ *
+ * Description:
+ *   Check if the frame that starts with 'hdr' is a TCP/IPv4 segment that
+ *   could be merged with its neighbours:  No IP options or fragmentation,
+ *   only the ACK and PSH flags, and some payload.
+ *
+ * Input Parameters:
+ *   hdr    - The start of the frame
+ *   hdrlen - The number of valid bytes at 'hdr'
+ *   pktlen - The length of the whole frame
+ *   tcplen - Location to return the size of the TCP header
+ *
+ * Returned Value:
+ *   The size of the TCP payload, or zero if the segment cannot be merged.
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_NETDEV_RXQUEUE_GRO
+static uint16_t netdev_gro_parse(FAR const uint8_t *hdr, unsigned int hdrlen,
+                                 unsigned int pktlen, FAR uint16_t *tcplen)
+{
+  FAR const struct eth_hdr_s *eth = (FAR const struct eth_hdr_s *)hdr;
+  FAR const struct ipv4_hdr_s *ip = GRO_IPHDR(hdr);
+  FAR const struct tcp_hdr_s *tcp = GRO_TCPHDR(hdr);
+  uint16_t iplen;
+  uint16_t thlen;
+
+  if (hdrlen < ETH_HDRLEN + IPv4TCP_HDRLEN ||
+      eth->type != HTONS(ETHTYPE_IP) || ip->vhl != 0x45 ||
+      ip->proto != IP_PROTO_TCP ||
+      (((uint16_t)ip->ipoffset[0] << 8 | ip->ipoffset[1]) & 0x3fff) != 0)
+    {
+      return 0;
+    }
+
+  if ((tcp->flags & TCP_CTL & ~TCP_PSH) != TCP_ACK)
+    {
+      return 0;
+    }
+
+  iplen = (uint16_t)ip->len[0] << 8 | ip->len[1];
+  thlen = (tcp->tcpoffset >> 4) << 2;
+  if (thlen < TCP_HDRLEN || ETH_HDRLEN + IPv4_HDRLEN + thlen > hdrlen ||
+      iplen <= IPv4_HDRLEN + thlen || ETH_HDRLEN + iplen > pktlen)
+    {
+      return 0;
+    }
+
+  *tcplen = thlen;
+  return iplen - IPv4_HDRLEN - thlen;
+}
+#endif
+
+/****************************************************************************
+ * Name: netdev_gro_seqno
+ ****************************************************************************/
+
+#ifdef CONFIG_NETDEV_RXQUEUE_GRO
+static uint32_t netdev_gro_seqno(FAR const uint8_t *seqno)
+{
+  return (uint32_t)seqno[0] << 24 | (uint32_t)seqno[1] << 16 |
+         (uint32_t)seqno[2] << 8 | seqno[3];
+}
+#endif
+
+/****************************************************************************
+ * Name: netdev_gro_merge
+ *
+ * Description:
+ *   Append the payload of the TCP segments that follow the segment in
+ *   d_buf in the receive ring, as long as they continue the same
+ *   connection in sequence and the result fits in d_buf.  The merged
+ *   frames are removed from the ring.
+ *
+ * Input Parameters:
+ *   dev    - The network device
+ *   budget - The number of frames that may still be taken from the ring.
+ *            Decremented for each frame merged.
+ *
+ * Returned Value:
+ *   None
+ *
+ * Assumptions:
+ *   The network is locked.
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_NETDEV_RXQUEUE_GRO
+static void netdev_gro_merge(FAR struct net_driver_s *dev,
+                             FAR int *budget)
+{
+  FAR struct netdev_rxqueue_s *rxq = &dev->d_rxq;
+  FAR struct ipv4_hdr_s *ip = GRO_IPHDR(dev->d_buf);
+  FAR struct tcp_hdr_s *tcp = GRO_TCPHDR(dev->d_buf);
+  uint8_t hdr[GRO_MAXHDR];
+  uint16_t tcplen;
+  uint16_t paylen;
+  uint16_t iplen;
+  uint16_t first;
+
+  if (!NETDEV_HAS_FEATURE(dev, NETDEV_FEATURE_RXCSUM) ||
+      dev->d_lltype != NET_LL_ETHERNET)
+    {
+      return;
+    }
+
+  paylen = netdev_gro_parse(dev->d_buf, dev->d_len, dev->d_len, &tcplen);
+  if (paylen == 0)
+    {
+      return;
+    }
+
+  iplen = IPv4_HDRLEN + tcplen + paylen;
+  first = iplen;
+
+  /* A PSH ends the run of segments to be merged */
+
+  while ((tcp->flags & TCP_PSH) == 0 && *budget > 0 && RXQ_USED(rxq) > 0)
+    {
+      FAR struct tcp_hdr_s *ntcp = GRO_TCPHDR(hdr);
+      FAR struct ipv4_hdr_s *nip = GRO_IPHDR(hdr);
+      FAR struct iob_s *iob;
+      uint16_t ntcplen;
+      uint16_t npaylen;
+      int hdrlen;
+
+      SP_DMB();
+      iob    = rxq->rq_ring[rxq->rq_tail & RXQ_MASK];
+      hdrlen = iob_copyout(hdr, iob, sizeof(hdr), 0);
+
+      /* The next segment must belong to the same connection, follow the
+       * current one in sequence and carry the same ACK and options.
+       */
+
+      npaylen = netdev_gro_parse(hdr, hdrlen, iob->io_pktlen, &ntcplen);
+      if (npaylen == 0 || ntcplen != tcplen ||
+          ETH_HDRLEN + iplen + npaylen > dev->d_pktsize ||
+          nip->tos != ip->tos || nip->ttl != ip->ttl ||
+          memcmp(nip->srcipaddr, ip->srcipaddr, 8) != 0 ||
+          memcmp(&ntcp->srcport, &tcp->srcport, 4) != 0 ||
+          memcmp(ntcp->ackno, tcp->ackno, 4) != 0 ||
+          memcmp(&hdr[ETH_HDRLEN + IPv4TCP_HDRLEN],
+                 &dev->d_buf[ETH_HDRLEN + IPv4TCP_HDRLEN],
+                 tcplen - TCP_HDRLEN) != 0 ||
+          netdev_gro_seqno(ntcp->seqno) !=
+          netdev_gro_seqno(tcp->seqno) + iplen - IPv4_HDRLEN - tcplen)
+        {
+          break;
+        }
+
+      /* Append the payload and take the flags and window of the later
+       * segment.
+       */
+
+      iob_copyout(&dev->d_buf[ETH_HDRLEN + iplen], iob, npaylen,
+                  ETH_HDRLEN + IPv4_HDRLEN + ntcplen);
+      iplen      += npaylen;
+      tcp->flags  = ntcp->flags;
+      tcp->wnd[0] = ntcp->wnd[0];
+      tcp->wnd[1] = ntcp->wnd[1];
+
+      rxq->rq_tail++;
+      iob_free_chain(iob, IOBUSER_NET_RXQUEUE);
+      (*budget)--;
+    }
+
+  if (iplen != first)
+    {
+      ip->len[0] = iplen >> 8;
+      ip->len[1] = iplen & 0xff;
+      dev->d_len = ETH_HDRLEN + iplen;
+    }
+}
+#endif
+
+/****************************************************************************
+ * Name: netdev_rxqueue_work
+ *
+ * Description:
+ *   Pass up to CONFIG_NETDEV_RXQUEUE_BUDGET queued frames to the network.
+ *
+ * Input Parameters:
+ *   arg - The network device
+ *
+ * Returned Value:
+ *   None
+ *
+ * Assumptions:
+ *   Runs on the RX worker thread.
+ *
+ ****************************************************************************/
+
+static void netdev_rxqueue_work(FAR void *arg)
+{
+  FAR struct net_driver_s *dev = (FAR struct net_driver_s *)arg;
+  FAR struct netdev_rxqueue_s *rxq = &dev->d_rxq;
+  int budget = CONFIG_NETDEV_RXQUEUE_BUDGET;
+
+  netdev_lock(dev);
+  net_lock();
+
+  while (budget > 0 && RXQ_USED(rxq) > 0)
+    {
+      FAR struct iob_s *iob;
+
+      /* Read the slot only after seeing the head that published it */
+
+      SP_DMB();
+      iob = rxq->rq_ring[rxq->rq_tail & RXQ_MASK];
+      rxq->rq_tail++;
+      budget--;
+
+      if (iob->io_pktlen > dev->d_pktsize)
+        {
+          nwarn("WARNING: Dropped %u byte frame\n", iob->io_pktlen);
+          NETDEV_RXDROPPED(dev);
+          iob_free_chain(iob, IOBUSER_NET_RXQUEUE);
+          continue;
+        }
+
+      dev->d_len = iob_copyout(dev->d_buf, iob, iob->io_pktlen, 0);
+      iob_free_chain(iob, IOBUSER_NET_RXQUEUE);
+
+#ifdef CONFIG_NETDEV_RXQUEUE_GRO
+      netdev_gro_merge(dev, &budget);
+#endif
+
+      rxq->rq_input(dev);
+    }
+
+  net_unlock();
+  netdev_unlock(dev);
+
+  /* Let other work on this worker thread run before the next batch */
+
+  if (RXQ_USED(rxq) > 0 && work_available(&rxq->rq_work))
+    {
+      work_queue(RXQWORK, &rxq->rq_work, netdev_rxqueue_work, dev, 0);
+    }
+}
+
+/****************************************************************************
+ * Public Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: netdev_rxqueue_init
+ *
+ * Description:
+ *   Prepare the receive queue of a device.  See include/nuttx/net/netdev.h.
+ *
+ * Input Parameters:
+ *   dev   - The network device
+ *   input - Driver function that dispatches the frame in d_buf
+ *
+ * Returned Value:
+ *   None
+ *
+ ****************************************************************************/
+
+void netdev_rxqueue_init(FAR struct net_driver_s *dev,
+                         CODE void (*input)(FAR struct net_driver_s *dev))
+{
+  FAR struct netdev_rxqueue_s *rxq = &dev->d_rxq;
+
+  DEBUGASSERT(dev != NULL && input != NULL);
+
+  memset(rxq, 0, sizeof(struct netdev_rxqueue_s));
+  rxq->rq_input = input;
+}
+
+/****************************************************************************
+ * Name: netdev_rxqueue
+ *
+ * Description:
+ *   Queue a received frame for the network.  This may be called from the
+ *   driver's interrupt handler.  Only one context may queue frames for a
+ *   given device.
+ *
+ * Input Parameters:
+ *   dev - The network device that received the frame
+ *   iob - The frame, starting with the link layer header
+ *
+ * Returned Value:
+ *   Zero (OK) if the frame was queued; -ENOBUFS if the queue was full and
+ *   the frame was dropped.
+ *
+ ****************************************************************************/
+
+int netdev_rxqueue(FAR struct net_driver_s *dev, FAR struct iob_s *iob)
+{
+  FAR struct netdev_rxqueue_s *rxq = &dev->d_rxq;
+
+  DEBUGASSERT(dev != NULL && iob != NULL && rxq->rq_input != NULL);
+
+  if (RXQ_USED(rxq) >= CONFIG_NETDEV_RXQUEUE_DEPTH)
+    {
+      NETDEV_RXDROPPED(dev);
+      iob_free_chain(iob, IOBUSER_NET_RXQUEUE);
+      return -ENOBUFS;
+    }
+
+  /* Publish the slot before the new head */
+
+  rxq->rq_ring[rxq->rq_head & RXQ_MASK] = iob;
+  SP_DMB();
+  rxq->rq_head++;
+
+  /* Wake up the RX worker unless it is already scheduled.  A worker that
+   * is running has already been dequeued and will be scheduled again.
+   */
+
+  if (work_available(&rxq->rq_work))
+    {
+      work_queue(RXQWORK, &rxq->rq_work, netdev_rxqueue_work, dev, 0);
+    }
+
+  return OK;
+}
+
+/****************************************************************************
+ * Name: netdev_rxqueue_flush
+ *
+ * Description:
+ *   Discard all queued frames and cancel the RX worker.  The driver must
+ *   not queue frames concurrently.  This may be called with the network
+ *   locked, e.g. from the d_ifdown() method.
+ *
+ * Input Parameters:
+ *   dev - The network device
+ *
+ * Returned Value:
+ *   None
+ *
+ ****************************************************************************/
+
+void netdev_rxqueue_flush(FAR struct net_driver_s *dev)
+{
+  FAR struct netdev_rxqueue_s *rxq = &dev->d_rxq;
+
+  work_cancel(RXQWORK, &rxq->rq_work);
+
+  /* A worker that is already running drains with the network locked */
+
+  net_lock();
+  while (RXQ_USED(rxq) > 0)
+    {
+      iob_free_chain(rxq->rq_ring[rxq->rq_tail & RXQ_MASK],
+                     IOBUSER_NET_RXQUEUE);
+      rxq->rq_tail++;
+    }
+
+  net_unlock();
+}
+
+#endif /* CONFIG_NETDEV_RXQUEUE */
@@ -130,6 +130,15 @@ int netdev_unregister(FAR struct net_driver_s *dev)
 
   if (dev)
     {
+#ifdef CONFIG_NETDEV_RXQUEUE
+      /* Discard any received frames still waiting for the RX worker */
+
+      if (dev->d_rxq.rq_input != NULL)
+        {
+          netdev_rxqueue_flush(dev);
+        }
+#endif
+
       net_lock();
 
       /* Find the device in the list of known network devices */
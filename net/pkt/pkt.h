@@ -43,6 +43,8 @@
 #include <nuttx/config.h>
 
 #include <sys/types.h>
+#include <sys/socket.h>
+#include <stdbool.h>
 #include <queue.h>
 
 #ifdef CONFIG_NET_PKT
@@ -84,6 +86,16 @@ struct pkt_conn_s
   uint8_t    ifindex;
   uint16_t   proto;
   uint8_t    crefs;    /* Reference counts on this instance */
+
+#ifdef CONFIG_NET_PKT_RXRING
+  /* PACKET_RX_RING receive ring.  See include/netpacket/packet.h */
+
+  FAR uint8_t *ring;   /* Application-provided ring, NULL if none */
+  uint32_t   fsize;    /* Size of each ring frame */
+  uint32_t   nframes;  /* Number of frames in the ring */
+  uint32_t   head;     /* Index of the next frame to fill */
+  bool       losing;   /* A frame was dropped because the ring was full */
+#endif
 };
 
 /****************************************************************************
@@ -308,6 +320,117 @@ struct socket;
 ssize_t psock_pkt_send(FAR struct socket *psock, FAR const void *buf,
                        size_t len);
 
+/****************************************************************************
+ * Name: pkt_setsockopt
+ *
+ * Description:
+ *   pkt_setsockopt() sets the SOL_PACKET option specified by the 'option'
+ *   argument to the value pointed to by the 'value' argument for the
+ *   socket specified by the 'psock' argument.
+ *
+ *   See <netpacket/packet.h> for the a complete list of values of packet
+ *   socket options.
+ *
+ * Input Parameters:
+ *   psock     Socket structure of socket to operate on
+ *   option    identifies the option to set
+ *   value     Points to the argument value
+ *   value_len The length of the argument value
+ *
+ * Returned Value:
+ *   Returns zero (OK) on success.  On failure, it returns a negated errno
+ *   value to indicate the nature of the error.  See psock_setcockopt() for
+ *   the list of possible error values.
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_NET_PKT_RXRING
+int pkt_setsockopt(FAR struct socket *psock, int option,
+                   FAR const void *value, socklen_t value_len);
+#endif
+
+/****************************************************************************
+ * Name: pkt_ring_input
+ *
+ * Description:
+ *   Copy the frame in dev->d_buf into the next frame of the connection's
+ *   receive ring.
+ *
+ * Input Parameters:
+ *   dev  - The device driver structure containing the received packet
+ *   conn - The packet connection with a receive ring
+ *
+ * Returned Value:
+ *   OK if the frame was stored; -ENOBUFS if the next ring frame still
+ *   belongs to the application and the frame was dropped.
+ *
+ * Assumptions:
+ *   The network is locked.
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_NET_PKT_RXRING
+int pkt_ring_input(FAR struct net_driver_s *dev,
+                   FAR struct pkt_conn_s *conn);
+#endif
+
+/****************************************************************************
+ * Name: pkt_ring_readable
+ *
+ * Description:
+ *   Return true if the receive ring holds a frame that the application has
+ *   not handed back yet.
+ *
+ * Assumptions:
+ *   The network is locked.
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_NET_PKT_RXRING
+bool pkt_ring_readable(FAR struct pkt_conn_s *conn);
+#endif
+
+/****************************************************************************
+ * Name: pkt_pollsetup
+ *
+ * Description:
+ *   Setup to monitor events on one packet socket with a receive ring
+ *
+ * Input Parameters:
+ *   psock - The packet socket of interest
+ *   fds   - The structure describing the events to be monitored, OR NULL if
+ *           this is a request to stop monitoring events.
+ *
+ * Returned Value:
+ *  0: Success; Negated errno on failure
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_NET_PKT_RXRING
+struct pollfd; /* Forward reference */
+int pkt_pollsetup(FAR struct socket *psock, FAR struct pollfd *fds);
+#endif
+
+/****************************************************************************
+ * Name: pkt_pollteardown
+ *
+ * Description:
+ *   Teardown monitoring of events on a packet socket
+ *
+ * Input Parameters:
+ *   psock - The packet socket of interest
+ *   fds   - The structure describing the events to be monitored, OR NULL if
+ *           this is a request to stop monitoring events.
+ *
+ * Returned Value:
+ *  0: Success; Negated errno on failure
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_NET_PKT_RXRING
+int pkt_pollteardown(FAR struct socket *psock, FAR struct pollfd *fds);
+#endif
+
 #undef EXTERN
 #ifdef __cplusplus
 }
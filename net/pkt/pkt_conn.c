@@ -148,6 +148,9 @@ FAR struct pkt_conn_s *pkt_alloc(void)
       /* Make sure that the connection is marked as uninitialized */
 
       conn->ifindex = 0;
+#ifdef CONFIG_NET_PKT_RXRING
+      conn->ring    = NULL;
+#endif
 
       /* Enqueue the connection into the active list */
 
@@ -95,6 +95,26 @@ int pkt_input(struct net_driver_s *dev)
     {
       uint16_t flags;
 
+#ifdef CONFIG_NET_PKT_RXRING
+      /* With a receive ring the frame is copied straight into it and
+       * poll() waiters are woken up.  If the ring is full the frame is
+       * lost; holding it in the driver would not make room in the ring.
+       */
+
+      if (conn->ring != NULL)
+        {
+          if (pkt_ring_input(dev, conn) == OK)
+            {
+              dev->d_appdata = dev->d_buf;
+              dev->d_sndlen  = 0;
+
+              pkt_callback(dev, conn, PKT_NEWDATA);
+            }
+
+          return OK;
+        }
+#endif
+
       /* Setup for the application callback */
 
       dev->d_appdata = dev->d_buf;
@@ -0,0 +1,312 @@
+/****************************************************************************
+ * net/pkt/pkt_netpoll.c
+ *
+ *   Copyright (C) 2020 Gregory Nutt. All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in
+ *    the documentation and/or other materials provided with the
+ *    distribution.
+ * 3. Neither the name NuttX nor the names of its contributors may be
+ *    used to endorse or promote products derived from this software
+ *    without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+ * FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE
+ * COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+ * INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,
+ * BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS
+ * OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED
+ * AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ * LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN
+ * ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ *
+ ****************************************************************************/
+
+/****************************************************************************
+ * Included Files
+ ****************************************************************************/
+
+#include <nuttx/config.h>
+
+#include <stdint.h>
+#include <poll.h>
+#include <errno.h>
+#include <assert.h>
+#include <debug.h>
+
+#include <nuttx/kmalloc.h>
+#include <nuttx/semaphore.h>
+#include <nuttx/net/net.h>
+#include <nuttx/net/netdev.h>
+
+#include "devif/devif.h"
+#include "pkt/pkt.h"
+
+#ifdef CONFIG_NET_PKT_RXRING
+
+/****************************************************************************
+ * Private Types
+ ****************************************************************************/
+
+/* This is an allocated container that holds the poll-related information */
+
+struct pkt_poll_s
+{
+  FAR struct socket *psock;        /* Needed to check the receive ring */
+  FAR struct net_driver_s *dev;    /* Needed to free the callback structure */
+  struct pollfd *fds;              /* Needed to handle poll events */
+  FAR struct devif_callback_s *cb; /* Needed to teardown the poll */
+};
+
+/****************************************************************************
+ * Private Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: pkt_poll_eventhandler
+ *
+ * Description:
+ *   This function is called when a frame has been put in the receive ring
+ *   or the device goes down.
+ *
+ * Input Parameters:
+ *   dev      The structure of the network driver that caused the event
+ *   conn     The connection structure associated with the socket
+ *   flags    Set of events describing why the callback was invoked
+ *
+ * Returned Value:
+ *   The unmodified flags
+ *
+ * Assumptions:
+ *   This function must be called with the network locked.
+ *
+ ****************************************************************************/
+
+static uint16_t pkt_poll_eventhandler(FAR struct net_driver_s *dev,
+                                      FAR void *conn,
+                                      FAR void *pvpriv, uint16_t flags)
+{
+  FAR struct pkt_poll_s *info = (FAR struct pkt_poll_s *)pvpriv;
+
+  ninfo("flags: %04x\n", flags);
+
+  if (info != NULL)
+    {
+      pollevent_t eventset = 0;
+
+      /* Check for a frame in the receive ring */
+
+      if ((flags & PKT_NEWDATA) != 0 &&
+          pkt_ring_readable((FAR struct pkt_conn_s *)info->psock->s_conn))
+        {
+          eventset |= (POLLIN & info->fds->events);
+        }
+
+      /* Check for loss of the device */
+
+      if ((flags & NETDEV_DOWN) != 0)
+        {
+          eventset |= ((POLLHUP | POLLERR) & info->fds->events);
+        }
+
+      /* Awaken the caller of poll() is requested event occurred. */
+
+      if (eventset)
+        {
+          info->fds->revents |= eventset;
+          nxsem_post(info->fds->sem);
+        }
+    }
+
+  return flags;
+}
+
+/****************************************************************************
+ * Public Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: pkt_pollsetup
+ *
+ * Description:
+ *   Setup to monitor events on one packet socket with a receive ring
+ *
+ * Input Parameters:
+ *   psock - The packet socket of interest
+ *   fds   - The structure describing the events to be monitored, OR NULL if
+ *           this is a request to stop monitoring events.
+ *
+ * Returned Value:
+ *  0: Success; Negated errno on failure
+ *
+ ****************************************************************************/
+
+int pkt_pollsetup(FAR struct socket *psock, FAR struct pollfd *fds)
+{
+  FAR struct pkt_conn_s *conn = psock->s_conn;
+  FAR struct pkt_poll_s *info;
+  FAR struct devif_callback_s *cb;
+  int ret;
+
+  /* Sanity check */
+
+#ifdef CONFIG_DEBUG_FEATURES
+  if (conn == NULL || fds == NULL)
+    {
+      return -EINVAL;
+    }
+#endif
+
+  /* Allocate a container to hold the poll information */
+
+  info = (FAR struct pkt_poll_s *)kmm_malloc(sizeof(struct pkt_poll_s));
+  if (info == NULL)
+    {
+      return -ENOMEM;
+    }
+
+  net_lock();
+
+  /* Only the receive ring can be polled */
+
+  if (conn->ring == NULL)
+    {
+      ret = -ENOSYS;
+      goto errout_with_lock;
+    }
+
+  info->dev = pkt_find_device(conn);
+  if (info->dev == NULL)
+    {
+      ret = -ENODEV;
+      goto errout_with_lock;
+    }
+
+  /* Allocate a packet callback structure */
+
+  cb = pkt_callback_alloc(info->dev, conn);
+  if (cb == NULL)
+    {
+      ret = -EBUSY;
+      goto errout_with_lock;
+    }
+
+  /* Initialize the poll info container */
+
+  info->psock  = psock;
+  info->fds    = fds;
+  info->cb     = cb;
+
+  /* Initialize the callback structure.  Save the reference to the info
+   * structure as callback private data so that it will be available during
+   * callback processing.
+   */
+
+  cb->flags    = 0;
+  cb->priv     = (FAR void *)info;
+  cb->event    = pkt_poll_eventhandler;
+
+  if ((fds->events & POLLIN) != 0)
+    {
+      cb->flags |= PKT_NEWDATA;
+    }
+
+  if ((fds->events & (POLLHUP | POLLERR)) != 0)
+    {
+      cb->flags |= NETDEV_DOWN;
+    }
+
+  /* Save the reference in the poll info structure as fds private as well
+   * for use during poll teardown as well.
+   */
+
+  fds->priv = (FAR void *)info;
+
+  /* Check for frames that are already waiting in the ring */
+
+  if (pkt_ring_readable(conn))
+    {
+      fds->revents |= (POLLRDNORM & fds->events);
+    }
+
+  if (fds->revents != 0)
+    {
+      /* Yes.. then signal the poll logic */
+
+      nxsem_post(fds->sem);
+    }
+
+  net_unlock();
+  return OK;
+
+errout_with_lock:
+  kmm_free(info);
+  net_unlock();
+  return ret;
+}
+
+/****************************************************************************
+ * Name: pkt_pollteardown
+ *
+ * Description:
+ *   Teardown monitoring of events on a packet socket
+ *
+ * Input Parameters:
+ *   psock - The packet socket of interest
+ *   fds   - The structure describing the events to be monitored, OR NULL if
+ *           this is a request to stop monitoring events.
+ *
+ * Returned Value:
+ *  0: Success; Negated errno on failure
+ *
+ ****************************************************************************/
+
+int pkt_pollteardown(FAR struct socket *psock, FAR struct pollfd *fds)
+{
+  FAR struct pkt_conn_s *conn = psock->s_conn;
+  FAR struct pkt_poll_s *info;
+
+  /* Sanity check */
+
+#ifdef CONFIG_DEBUG_FEATURES
+  if (conn == NULL || fds->priv == NULL)
+    {
+      return -EINVAL;
+    }
+#endif
+
+  /* Recover the socket descriptor poll state info from the poll structure */
+
+  info = (FAR struct pkt_poll_s *)fds->priv;
+  DEBUGASSERT(info != NULL && info->fds != NULL && info->cb != NULL);
+  if (info != NULL)
+    {
+      /* Release the callback */
+
+      net_lock();
+      pkt_callback_free(info->dev, conn, info->cb);
+      net_unlock();
+
+      /* Release the poll/select data slot */
+
+      info->fds->priv = NULL;
+
+      /* Then free the poll info container */
+
+      kmm_free(info);
+    }
+
+  return OK;
+}
+
+#endif /* CONFIG_NET_PKT_RXRING */
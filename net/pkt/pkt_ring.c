@@ -0,0 +1,178 @@
+/****************************************************************************
+ * net/pkt/pkt_ring.c
+ *
+ *   Copyright (C) 2020 Gregory Nutt. All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in
+ *    the documentation and/or other materials provided with the
+ *    distribution.
+ * 3. Neither the name NuttX nor the names of its contributors may be
+ *    used to endorse or promote products derived from this software
+ *    without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+ * FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE
+ * COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+ * INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,
+ * BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS
+ * OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED
+ * AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ * LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN
+ * ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ *
+ ****************************************************************************/
+
+/****************************************************************************
+ * Included Files
+ ****************************************************************************/
+
+#include <nuttx/config.h>
+#if defined(CONFIG_NET) && defined(CONFIG_NET_PKT_RXRING)
+
+#include <string.h>
+#include <time.h>
+#include <errno.h>
+#include <debug.h>
+
+#include <netpacket/packet.h>
+
+#include <nuttx/clock.h>
+#include <nuttx/net/netdev.h>
+#include <nuttx/net/ethernet.h>
+
+#include "pkt/pkt.h"
+
+/****************************************************************************
+ * Pre-processor Definitions
+ ****************************************************************************/
+
+#define PKT_FRAME(c,n) \
+  ((FAR struct tpacket_hdr *)&(c)->ring[(size_t)(n) * (c)->fsize])
+
+/****************************************************************************
+ * Public Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: pkt_ring_input
+ *
+ * Description:
+ *   Copy the frame in dev->d_buf into the next frame of the connection's
+ *   receive ring.
+ *
+ * Input Parameters:
+ *   dev  - The device driver structure containing the received packet
+ *   conn - The packet connection with a receive ring
+ *
+ * Returned Value:
+ *   OK if the frame was stored; -ENOBUFS if the next ring frame still
+ *   belongs to the application and the frame was dropped.
+ *
+ * Assumptions:
+ *   The network is locked.
+ *
+ ****************************************************************************/
+
+int pkt_ring_input(FAR struct net_driver_s *dev,
+                   FAR struct pkt_conn_s *conn)
+{
+  FAR struct tpacket_hdr *hdr = PKT_FRAME(conn, conn->head);
+  struct timespec ts;
+  uint32_t snaplen;
+  uint32_t status;
+
+  /* Frames are handed out in order, so if the next one has not come back
+   * yet the ring is full.  Drop the frame and tell the application about
+   * it in the next one that is stored.
+   */
+
+  if (hdr->tp_status != TP_STATUS_KERNEL)
+    {
+      ninfo("Ring full, frame dropped\n");
+      conn->losing = true;
+      return -ENOBUFS;
+    }
+
+  snaplen = conn->fsize - TPACKET_HDRLEN;
+  status  = TP_STATUS_USER;
+
+  if (dev->d_len > snaplen)
+    {
+      status |= TP_STATUS_COPY;
+    }
+  else
+    {
+      snaplen = dev->d_len;
+    }
+
+  if (conn->losing)
+    {
+      status      |= TP_STATUS_LOSING;
+      conn->losing = false;
+    }
+
+  memcpy((FAR uint8_t *)hdr + TPACKET_HDRLEN, dev->d_buf, snaplen);
+
+  clock_gettime(CLOCK_REALTIME, &ts);
+
+  hdr->tp_len     = dev->d_len;
+  hdr->tp_snaplen = snaplen;
+  hdr->tp_mac     = TPACKET_HDRLEN;
+  hdr->tp_net     = TPACKET_HDRLEN + ETH_HDRLEN;
+  hdr->tp_sec     = ts.tv_sec;
+  hdr->tp_usec    = ts.tv_nsec / NSEC_PER_USEC;
+
+  /* The status word goes last:  Once it reads TP_STATUS_USER the
+   * application may use the frame.
+   */
+
+  hdr->tp_status  = status;
+
+  if (++conn->head >= conn->nframes)
+    {
+      conn->head = 0;
+    }
+
+  return OK;
+}
+
+/****************************************************************************
+ * Name: pkt_ring_readable
+ *
+ * Description:
+ *   Return true if the receive ring holds a frame that the application has
+ *   not handed back yet.
+ *
+ * Assumptions:
+ *   The network is locked.
+ *
+ ****************************************************************************/
+
+bool pkt_ring_readable(FAR struct pkt_conn_s *conn)
+{
+  uint32_t prev;
+
+  if (conn->ring == NULL)
+    {
+      return false;
+    }
+
+  /* The most recently filled frame is the last one that the application
+   * will get to, so if it is still outstanding there is something to read.
+   */
+
+  prev = conn->head > 0 ? conn->head - 1 : conn->nframes - 1;
+  return PKT_FRAME(conn, prev)->tp_status != TP_STATUS_KERNEL;
+}
+
+#endif /* CONFIG_NET && CONFIG_NET_PKT_RXRING */
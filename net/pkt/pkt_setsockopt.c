@@ -0,0 +1,148 @@
+/****************************************************************************
+ * net/pkt/pkt_setsockopt.c
+ *
+ *   Copyright (C) 2020 Gregory Nutt. All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in
+ *    the documentation and/or other materials provided with the
+ *    distribution.
+ * 3. Neither the name NuttX nor the names of its contributors may be
+ *    used to endorse or promote products derived from this software
+ *    without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+ * FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE
+ * COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+ * INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,
+ * BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS
+ * OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED
+ * AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ * LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN
+ * ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ *
+ ****************************************************************************/
+
+/****************************************************************************
+ * Included Files
+ ****************************************************************************/
+
+#include <nuttx/config.h>
+
+#include <stdint.h>
+#include <errno.h>
+#include <assert.h>
+#include <debug.h>
+
+#include <netpacket/packet.h>
+
+#include <nuttx/net/net.h>
+#include <nuttx/net/ethernet.h>
+
+#include "pkt/pkt.h"
+
+#ifdef CONFIG_NET_PKT_RXRING
+
+/****************************************************************************
+ * Public Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: pkt_setsockopt
+ *
+ * Description:
+ *   pkt_setsockopt() sets the SOL_PACKET option specified by the 'option'
+ *   argument to the value pointed to by the 'value' argument for the
+ *   socket specified by the 'psock' argument.
+ *
+ *   See <netpacket/packet.h> for the a complete list of values of packet
+ *   socket options.
+ *
+ * Input Parameters:
+ *   psock     Socket structure of socket to operate on
+ *   option    identifies the option to set
+ *   value     Points to the argument value
+ *   value_len The length of the argument value
+ *
+ * Returned Value:
+ *   Returns zero (OK) on success.  On failure, it returns a negated errno
+ *   value to indicate the nature of the error.  See psock_setcockopt() for
+ *   the list of possible error values.
+ *
+ ****************************************************************************/
+
+int pkt_setsockopt(FAR struct socket *psock, int option,
+                   FAR const void *value, socklen_t value_len)
+{
+  FAR struct pkt_conn_s *conn;
+  FAR const struct tpacket_req *req;
+  uint32_t i;
+
+  DEBUGASSERT(psock != NULL && psock->s_conn != NULL);
+  conn = (FAR struct pkt_conn_s *)psock->s_conn;
+
+  if (psock->s_domain != PF_PACKET)
+    {
+      nerr("ERROR:  Not a packet socket\n");
+      return -ENOPROTOOPT;
+    }
+
+  if (option != PACKET_RX_RING)
+    {
+      nerr("ERROR: Unrecognized packet option: %d\n", option);
+      return -ENOPROTOOPT;
+    }
+
+  if (value == NULL || value_len < sizeof(struct tpacket_req))
+    {
+      return -EINVAL;
+    }
+
+  req = (FAR const struct tpacket_req *)value;
+
+  /* A NULL address removes the ring.  Otherwise each frame must be able
+   * to hold the header and at least an Ethernet header, and the frames
+   * must stay aligned.
+   */
+
+  if (req->tp_addr != NULL &&
+      (req->tp_frame_nr == 0 ||
+       req->tp_frame_size < TPACKET_HDRLEN + ETH_HDRLEN ||
+       (req->tp_frame_size & (TPACKET_ALIGNMENT - 1)) != 0 ||
+       ((uintptr_t)req->tp_addr & (sizeof(uint32_t) - 1)) != 0))
+    {
+      return -EINVAL;
+    }
+
+  net_lock();
+
+  conn->ring      = req->tp_addr;
+  conn->fsize = req->tp_frame_size;
+  conn->nframes   = req->tp_frame_nr;
+  conn->head      = 0;
+  conn->losing    = false;
+
+  /* Give all of the frames to the kernel */
+
+  for (i = 0; conn->ring != NULL && i < conn->nframes; i++)
+    {
+      FAR struct tpacket_hdr *hdr = (FAR struct tpacket_hdr *)
+        &conn->ring[(size_t)i * conn->fsize];
+
+      hdr->tp_status = TP_STATUS_KERNEL;
+    }
+
+  net_unlock();
+  return OK;
+}
+
+#endif /* CONFIG_NET_PKT_RXRING */
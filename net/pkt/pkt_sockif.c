@@ -516,7 +516,20 @@ int pkt_listen(FAR struct socket *psock, int backlog)
 static int pkt_poll_local(FAR struct socket *psock, FAR struct pollfd *fds,
                           bool setup)
 {
+#ifdef CONFIG_NET_PKT_RXRING
+  /* Only sockets with a receive ring can be polled */
+
+  if (setup)
+    {
+      return pkt_pollsetup(psock, fds);
+    }
+  else
+    {
+      return pkt_pollteardown(psock, fds);
+    }
+#else
   return -ENOSYS;
+#endif
 }
 
 /****************************************************************************
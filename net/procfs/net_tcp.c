@@ -0,0 +1,293 @@
+/****************************************************************************
+ * net/procfs/net_tcp.c
+ *
+ *   Copyright (C) 2020 Gregory Nutt. All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in
+ *    the documentation and/or other materials provided with the
+ *    distribution.
+ * 3. Neither the name NuttX nor the names of its contributors may be
+ *    used to endorse or promote products derived from this software
+ *    without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+ * FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE
+ * COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+ * INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,
+ * BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS
+ * OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED
+ * AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ * LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN
+ * ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ *
+ ****************************************************************************/
+
+/* Output format, one block per active connection:
+ *
+ *     0. L: xxx.xxx.xxx.xxx nnnnn
+ *        R: xxx.xxx.xxx.xxx nnnnn  St: xx
+ *        Rx: segs/bytes Tx: segs/bytes Rexmit: nnnn
+ *        RTO: nnn Nrtx: nn Wnd: nnnnn Unacked: nnnnn
+ *        SRTT: msec Var: msec Cwnd: nnnnn Ssth: nnnnn
+ *
+ * The last line is only present if CONFIG_NET_TCP_CC is enabled.
+ */
+
+/****************************************************************************
+ * Included Files
+ ****************************************************************************/
+
+#include <nuttx/config.h>
+
+#include <sys/types.h>
+#include <stdio.h>
+#include <string.h>
+#include <debug.h>
+
+#include <arpa/inet.h>
+
+#include <nuttx/clock.h>
+#include <nuttx/net/net.h>
+
+#include "tcp/tcp.h"
+#include "procfs/procfs.h"
+
+#if !defined(CONFIG_DISABLE_MOUNTPOINT) && defined(CONFIG_FS_PROCFS) && \
+    !defined(CONFIG_FS_PROCFS_EXCLUDE_NET) && defined(CONFIG_NET_TCP_CONNSTATS)
+
+/****************************************************************************
+ * Pre-processor Definitions
+ ****************************************************************************/
+
+/* The number of lines generated for each connection */
+
+#ifdef CONFIG_NET_TCP_CC
+#  define TCP_NLINES 5
+#else
+#  define TCP_NLINES 4
+#endif
+
+/****************************************************************************
+ * Private Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: netprocfs_tcpconn
+ *
+ * Description:
+ *   Return the index'th active TCP connection or NULL if there are not
+ *   that many.  The caller must hold the network lock.
+ *
+ ****************************************************************************/
+
+static FAR struct tcp_conn_s *netprocfs_tcpconn(int index)
+{
+  FAR struct tcp_conn_s *conn = tcp_nextconn(NULL);
+
+  while (conn != NULL && index-- > 0)
+    {
+      conn = tcp_nextconn(conn);
+    }
+
+  return conn;
+}
+
+/****************************************************************************
+ * Name: netprocfs_tcpaddr
+ *
+ * Description:
+ *   Format one of the connection's IP addresses and a port number.
+ *
+ ****************************************************************************/
+
+static int netprocfs_tcpaddr(FAR struct tcp_conn_s *conn, bool local,
+                             FAR char *line, size_t len)
+{
+  char addr[INET6_ADDRSTRLEN];
+  uint16_t port = local ? conn->lport : conn->rport;
+
+#ifdef CONFIG_NET_IPv6
+#ifdef CONFIG_NET_IPv4
+  if (conn->domain == PF_INET6)
+#endif
+    {
+      inet_ntop(AF_INET6, local ? conn->u.ipv6.laddr : conn->u.ipv6.raddr,
+                addr, INET6_ADDRSTRLEN);
+    }
+#endif
+
+#ifdef CONFIG_NET_IPv4
+#ifdef CONFIG_NET_IPv6
+  else
+#endif
+    {
+      inet_ntop(AF_INET, local ? &conn->u.ipv4.laddr : &conn->u.ipv4.raddr,
+                addr, INET6_ADDRSTRLEN);
+    }
+#endif
+
+  return snprintf(line, len, "%s %u", addr, NTOHS(port));
+}
+
+/****************************************************************************
+ * Name: netprocfs_tcpline
+ *
+ * Description:
+ *   Generate the line selected by netfile->lineno.  Returns zero if there
+ *   is no connection for that line.
+ *
+ ****************************************************************************/
+
+static int netprocfs_tcpline(FAR struct netprocfs_file_s *netfile)
+{
+  FAR struct tcp_conn_s *conn;
+  FAR char *line = netfile->line;
+  int index = netfile->lineno / TCP_NLINES;
+  int len = 0;
+
+  net_lock();
+
+  conn = netprocfs_tcpconn(index);
+  if (conn == NULL)
+    {
+      goto errout;
+    }
+
+  switch (netfile->lineno % TCP_NLINES)
+    {
+      case 0:
+        len  = snprintf(line, NET_LINELEN, "%4d. L: ", index);
+        len += netprocfs_tcpaddr(conn, true, &line[len], NET_LINELEN - len);
+        len += snprintf(&line[len], NET_LINELEN - len, "\n");
+        break;
+
+      case 1:
+        len  = snprintf(line, NET_LINELEN, "      R: ");
+        len += netprocfs_tcpaddr(conn, false, &line[len], NET_LINELEN - len);
+        len += snprintf(&line[len], NET_LINELEN - len, "  St: %02x\n",
+                        conn->tcpstateflags);
+        break;
+
+      case 2:
+        len = snprintf(line, NET_LINELEN,
+                       "      Rx: %lu/%lu Tx: %lu/%lu Rexmit: %lu\n",
+                       (unsigned long)conn->stats.rxsegs,
+                       (unsigned long)conn->stats.rxbytes,
+                       (unsigned long)conn->stats.txsegs,
+                       (unsigned long)conn->stats.txbytes,
+                       (unsigned long)conn->stats.rexmit);
+        break;
+
+      case 3:
+        len = snprintf(line, NET_LINELEN,
+                       "      RTO: %u Nrtx: %u Wnd: %lu Unacked: %lu\n",
+                       conn->rto, conn->nrtx,
+                       (unsigned long)conn->winsize,
+                       (unsigned long)conn->unacked);
+        break;
+
+#ifdef CONFIG_NET_TCP_CC
+      case 4:
+        len = snprintf(line, NET_LINELEN,
+                       "      SRTT: %lu Var: %lu Cwnd: %lu Ssth: %lu\n",
+                       (unsigned long)TICK2MSEC(conn->srtt >> 3),
+                       (unsigned long)TICK2MSEC(conn->rttvar >> 2),
+                       (unsigned long)conn->cwnd,
+                       (unsigned long)conn->ssthresh);
+        break;
+#endif
+    }
+
+errout:
+  net_unlock();
+  return len < NET_LINELEN ? len : NET_LINELEN - 1;
+}
+
+/****************************************************************************
+ * Public Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: netprocfs_read_tcpstats
+ *
+ * Description:
+ *   Read and format the per-connection TCP statistics.
+ *
+ * Input Parameters:
+ *   priv - A reference to the network procfs file structure
+ *   buffer - The user-provided buffer into which network status will be
+ *            returned.
+ *   bulen  - The size in bytes of the user provided buffer.
+ *
+ * Returned Value:
+ *   Zero (OK) is returned on success; a negated errno value is returned
+ *   on failure.
+ *
+ ****************************************************************************/
+
+ssize_t netprocfs_read_tcpstats(FAR struct netprocfs_file_s *priv,
+                                FAR char *buffer, size_t buflen)
+{
+  size_t xfrsize;
+  ssize_t nreturned = 0;
+
+  /* This is netprocfs_read_linegen() except that the number of lines is
+   * not known in advance:  Lines are generated until one is empty, i.e.,
+   * until we run out of connections.
+   */
+
+  for (; ; )
+    {
+      /* Transfer any buffered line data first */
+
+      if (priv->linesize > 0)
+        {
+          xfrsize = priv->linesize;
+          if (xfrsize > buflen)
+            {
+              xfrsize = buflen;
+            }
+
+          memcpy(buffer, &priv->line[priv->offset], xfrsize);
+
+          buffer         += xfrsize;
+          buflen         -= xfrsize;
+
+          priv->linesize -= xfrsize;
+          priv->offset   += xfrsize;
+          nreturned      += xfrsize;
+        }
+
+      if (buflen == 0)
+        {
+          break;
+        }
+
+      /* Then generate the next line */
+
+      priv->linesize = netprocfs_tcpline(priv);
+      priv->offset   = 0;
+
+      if (priv->linesize == 0)
+        {
+          break;
+        }
+
+      priv->lineno++;
+    }
+
+  return nreturned;
+}
+
+#endif /* !CONFIG_DISABLE_MOUNTPOINT && CONFIG_FS_PROCFS &&
+        * !CONFIG_FS_PROCFS_EXCLUDE_NET && CONFIG_NET_TCP_CONNSTATS */
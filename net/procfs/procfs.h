@@ -54,6 +54,10 @@
 #  undef CONFIG_NET_ROUTE
 #endif
 
+#ifndef CONFIG_NET_TCP
+#  undef CONFIG_NET_TCP_CONNSTATS
+#endif
+
 /* Determines the size of an intermediate buffer that must be large enough
  * to handle the longest line generated by this logic.
  */
@@ -75,6 +79,9 @@ enum netprocfs_entry_e
   , NETPROCFS_SUBDIR_MLD             /* /proc/net/mld */
 #endif
 #endif
+#ifdef CONFIG_NET_TCP_CONNSTATS
+  , NETPROCFS_SUBDIR_TCP             /* /proc/net/tcp */
+#endif
 #ifdef CONFIG_NET_ROUTE
   , NETPROCFS_SUBDIR_ROUTE           /* /proc/net/route */
 #endif
@@ -87,7 +94,7 @@ struct netprocfs_file_s
 {
   struct procfs_file_s base;         /* Base open file structure */
   FAR struct net_driver_s *dev;      /* Current network device */
-  uint8_t lineno;                    /* Line number */
+  uint16_t lineno;                   /* Line number */
   uint8_t linesize;                  /* Number of valid characters in line[] */
   uint8_t offset;                    /* Offset to first valid character in line[] */
   uint8_t entry;                     /* See enum netprocfs_entry_e */
@@ -195,6 +202,29 @@ ssize_t netprocfs_read_mldstats(FAR struct netprocfs_file_s *priv,
                                 FAR char *buffer, size_t buflen);
 #endif
 
+/****************************************************************************
+ * Name: netprocfs_read_tcpstats
+ *
+ * Description:
+ *   Read and format the per-connection TCP statistics.
+ *
+ * Input Parameters:
+ *   priv - A reference to the network procfs file structure
+ *   buffer - The user-provided buffer into which network status will be
+ *            returned.
+ *   bulen  - The size in bytes of the user provided buffer.
+ *
+ * Returned Value:
+ *   Zero (OK) is returned on success; a negated errno value is returned
+ *   on failure.
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_NET_TCP_CONNSTATS
+ssize_t netprocfs_read_tcpstats(FAR struct netprocfs_file_s *priv,
+                                FAR char *buffer, size_t buflen);
+#endif
+
 /****************************************************************************
  * Name: netprocfs_read_routes
  *
@@ -96,10 +96,10 @@ int net_addroute_ipv4(in_addr_t target, in_addr_t netmask, in_addr_t router)
 
   net_lock();
 
-  /* Then add the new entry to the table */
+  /* Then add the new entry to the table, longest prefix first */
 
-  ramroute_ipv4_addlast((FAR struct net_route_ipv4_entry_s *)route,
-                        &g_ipv4_routes);
+  ramroute_ipv4_addsorted((FAR struct net_route_ipv4_entry_s *)route,
+                          &g_ipv4_routes);
   net_unlock();
   return OK;
 }
@@ -131,10 +131,10 @@ int net_addroute_ipv6(net_ipv6addr_t target, net_ipv6addr_t netmask,
 
   net_lock();
 
-  /* Then add the new entry to the table */
+  /* Then add the new entry to the table, longest prefix first */
 
-  ramroute_ipv6_addlast((FAR struct net_route_ipv6_entry_s *)route,
-                        &g_ipv6_routes);
+  ramroute_ipv6_addsorted((FAR struct net_route_ipv6_entry_s *)route,
+                          &g_ipv6_routes);
   net_unlock();
   return OK;
 }
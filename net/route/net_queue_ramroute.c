@@ -39,11 +39,59 @@
 
 #include <nuttx/config.h>
 
+#include <stdint.h>
+
 #include "route/ramroute.h"
 #include "route/route.h"
 
 #if defined(CONFIG_ROUTE_IPv4_RAMROUTE) || defined(CONFIG_ROUTE_IPv6_RAMROUTE)
 
+/****************************************************************************
+ * Private Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: ramroute_bitcount, ramroute_ipv4_prefixlen, ramroute_ipv6_prefixlen
+ *
+ * Description:
+ *   Return the number of bits set in an IPv4/IPv6 network mask.
+ *
+ ****************************************************************************/
+
+static unsigned int ramroute_bitcount(uint32_t value)
+{
+  unsigned int nbits = 0;
+
+  for (; value != 0; value &= value - 1)
+    {
+      nbits++;
+    }
+
+  return nbits;
+}
+
+#ifdef CONFIG_ROUTE_IPv4_RAMROUTE
+static unsigned int ramroute_ipv4_prefixlen(in_addr_t netmask)
+{
+  return ramroute_bitcount((uint32_t)netmask);
+}
+#endif
+
+#ifdef CONFIG_ROUTE_IPv6_RAMROUTE
+static unsigned int ramroute_ipv6_prefixlen(const net_ipv6addr_t netmask)
+{
+  unsigned int nbits = 0;
+  int i;
+
+  for (i = 0; i < 8; i++)
+    {
+      nbits += ramroute_bitcount(netmask[i]);
+    }
+
+  return nbits;
+}
+#endif
+
 /****************************************************************************
  * Public Functions
  ****************************************************************************/
@@ -99,6 +147,90 @@ void ramroute_ipv6_addlast(FAR struct net_route_ipv6_entry_s *entry,
 }
 #endif
 
+/****************************************************************************
+ * Name: ramroute_ipv4_addsorted/ramroute_ipv6_addsorted
+ *
+ * Description:
+ *   Add an entry to an IPv4/IPv6 routing table list that is kept sorted by
+ *   decreasing prefix length.  A linear search of the list then returns
+ *   the longest-prefix match first and can stop at the first hit.  Routes
+ *   with equal prefix lengths keep the order in which they were added.
+ *
+ * Input Parameters:
+ *   entry - A pointer to the new entry to add to the list
+ *   list - The list to be used.
+ *
+ * Returned Value:
+ *   None
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_ROUTE_IPv4_RAMROUTE
+void ramroute_ipv4_addsorted(FAR struct net_route_ipv4_entry_s *entry,
+                             FAR struct net_route_ipv4_queue_s *list)
+{
+  FAR struct net_route_ipv4_entry_s *prev = NULL;
+  FAR struct net_route_ipv4_entry_s *curr;
+  unsigned int prefixlen = ramroute_ipv4_prefixlen(entry->entry.netmask);
+
+  for (curr = list->head;
+       curr != NULL &&
+       ramroute_ipv4_prefixlen(curr->entry.netmask) >= prefixlen;
+       curr = curr->flink)
+    {
+      prev = curr;
+    }
+
+  if (curr == NULL)
+    {
+      ramroute_ipv4_addlast(entry, list);
+    }
+  else if (prev == NULL)
+    {
+      entry->flink = list->head;
+      list->head   = entry;
+    }
+  else
+    {
+      entry->flink = curr;
+      prev->flink  = entry;
+    }
+}
+#endif
+
+#ifdef CONFIG_ROUTE_IPv6_RAMROUTE
+void ramroute_ipv6_addsorted(FAR struct net_route_ipv6_entry_s *entry,
+                             FAR struct net_route_ipv6_queue_s *list)
+{
+  FAR struct net_route_ipv6_entry_s *prev = NULL;
+  FAR struct net_route_ipv6_entry_s *curr;
+  unsigned int prefixlen = ramroute_ipv6_prefixlen(entry->entry.netmask);
+
+  for (curr = list->head;
+       curr != NULL &&
+       ramroute_ipv6_prefixlen(curr->entry.netmask) >= prefixlen;
+       curr = curr->flink)
+    {
+      prev = curr;
+    }
+
+  if (curr == NULL)
+    {
+      ramroute_ipv6_addlast(entry, list);
+    }
+  else if (prev == NULL)
+    {
+      entry->flink = list->head;
+      list->head   = entry;
+    }
+  else
+    {
+      entry->flink = curr;
+      prev->flink  = entry;
+    }
+}
+#endif
+
 /****************************************************************************
  * Name: ramroute_ipv4_remfirst/ramroute_ipv6_remfirst
  *
@@ -57,7 +57,7 @@
  * Pre-processor defintions
  ****************************************************************************/
 
-#ifdef CONFIG_ROUTE_IPv6_CACHEROUTE
+#ifdef CONFIG_ROUTE_IPv4_CACHEROUTE
 #  define IPv4_ROUTER entry.router
 #else
 #  define IPv4_ROUTER router
@@ -122,8 +122,9 @@ static int net_ipv4_match(FAR struct net_route_ipv4_s *route, FAR void *arg)
   FAR struct route_ipv4_match_s *match = (FAR struct route_ipv4_match_s *)arg;
 
   /* To match, the masked target addresses must be the same.  In the event
-   * of multiple matches, only the first is returned.  There is not (yet) any
-   * concept for the precedence of networks.
+   * of multiple matches, only the first is returned.  In-memory routing
+   * tables are kept sorted by decreasing prefix length so that the first
+   * match is also the longest-prefix match.
    */
 
   if (net_ipv4addr_maskcmp(route->target, match->target, route->netmask))
@@ -165,8 +166,9 @@ static int net_ipv6_match(FAR struct net_route_ipv6_s *route, FAR void *arg)
   FAR struct route_ipv6_match_s *match = (FAR struct route_ipv6_match_s *)arg;
 
   /* To match, the masked target addresses must be the same.  In the event
-   * of multiple matches, only the first is returned.  There is not (yet) any
-   * concept for the precedence of networks.
+   * of multiple matches, only the first is returned.  In-memory routing
+   * tables are kept sorted by decreasing prefix length so that the first
+   * match is also the longest-prefix match.
    */
 
   if (net_ipv6addr_maskcmp(route->target, match->target, route->netmask))
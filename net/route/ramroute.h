@@ -214,6 +214,8 @@ void net_freeroute_ipv6(FAR struct net_route_ipv6_s *route);
 #ifdef CONFIG_ROUTE_IPv4_RAMROUTE
 void ramroute_ipv4_addlast(FAR struct net_route_ipv4_entry_s *entry,
                            FAR struct net_route_ipv4_queue_s *list);
+void ramroute_ipv4_addsorted(FAR struct net_route_ipv4_entry_s *entry,
+                             FAR struct net_route_ipv4_queue_s *list);
 FAR struct net_route_ipv4_entry_s *
   ramroute_ipv4_remfirst(struct net_route_ipv4_queue_s *list);
 FAR struct net_route_ipv4_entry_s *
@@ -224,6 +226,8 @@ FAR struct net_route_ipv4_entry_s *
 #ifdef CONFIG_ROUTE_IPv6_RAMROUTE
 void ramroute_ipv6_addlast(FAR struct net_route_ipv6_entry_s *entry,
                            FAR struct net_route_ipv6_queue_s *list);
+void ramroute_ipv6_addsorted(FAR struct net_route_ipv6_entry_s *entry,
+                             FAR struct net_route_ipv6_queue_s *list);
 FAR struct net_route_ipv6_entry_s *
   ramroute_ipv6_remfirst(struct net_route_ipv6_queue_s *list);
 FAR struct net_route_ipv6_entry_s *
@@ -60,6 +60,7 @@
 #include <nuttx/config.h>
 
 #include <string.h>
+#include <assert.h>
 #include <debug.h>
 
 #include <nuttx/mm/iob.h>
@@ -86,6 +87,13 @@
 #define UNCOMPRESS_MACBASED (1 << 8)
 #define UNCOMPRESS_ZEROPAD  (1 << 9)
 
+/* Maximum size of the IPHC encoding through the end of the destination
+ * address:  2 IPHC bytes, CID byte, 4 bytes of TF, next header, hop limit
+ * and two full 128-bit addresses.
+ */
+
+#define HC06_CACHE_MAXLEN   (2 + 1 + 4 + 1 + 1 + 16 + 16)
+
 /****************************************************************************
  * Private Types
  ****************************************************************************/
@@ -101,6 +109,26 @@ struct sixlowpan_addrcontext_s
   uint8_t prefix[8];
 };
 
+#ifdef CONFIG_NET_6LOWPAN_HC06_CACHE
+/* The IPHC encoding of the last IPv6 header compressed, together with
+ * every input that the encoding depends on.
+ */
+
+struct sixlowpan_hc06cache_s
+{
+  FAR struct radio_driver_s *radio; /* Radio that sent the packet (NULL: invalid) */
+  struct netdev_varaddr_s srcmac;   /* Radio MAC address at that time */
+  struct netdev_varaddr_s destmac;  /* L2 destination address */
+  uint8_t vtcflow[4];               /* Version, traffic class, flow label */
+  uint8_t proto;                    /* Next header */
+  uint8_t ttl;                      /* Hop limit */
+  net_ipv6addr_t srcipaddr;         /* IPv6 source address */
+  net_ipv6addr_t destipaddr;        /* IPv6 destination address */
+  uint8_t len;                      /* Length of the encoding in iphc[] */
+  uint8_t iphc[HC06_CACHE_MAXLEN];  /* IPHC bytes through the addresses */
+};
+#endif
+
 /****************************************************************************
  * Private Data
  ****************************************************************************/
@@ -124,6 +152,12 @@ static struct sixlowpan_addrcontext_s
 
 static FAR uint8_t *g_hc06ptr;
 
+#ifdef CONFIG_NET_6LOWPAN_HC06_CACHE
+/* Last IPHC header encoding */
+
+static struct sixlowpan_hc06cache_s g_hc06cache;
+#endif
+
 /* Constant Data ************************************************************/
 
 /* Uncompression of linklocal
@@ -557,6 +591,82 @@ static void uncompress_addr(FAR const struct netdev_varaddr_s *addr,
         ntohs(ipaddr[4]), ntohs(ipaddr[5]), ntohs(ipaddr[6]), ntohs(ipaddr[7]));
 }
 
+/****************************************************************************
+ * Name: hc06_cache_varaddr
+ *
+ * Description:
+ *   Return true if two variable length MAC addresses are the same.
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_NET_6LOWPAN_HC06_CACHE
+static bool hc06_cache_varaddr(FAR const struct netdev_varaddr_s *addr1,
+                               FAR const struct netdev_varaddr_s *addr2)
+{
+  return addr1->nv_addrlen == addr2->nv_addrlen &&
+         memcmp(addr1->nv_addr, addr2->nv_addr, addr1->nv_addrlen) == 0;
+}
+
+/****************************************************************************
+ * Name: hc06_cache_match
+ *
+ * Description:
+ *   Return true if the cached IPHC encoding was generated from the same
+ *   inputs and may be reused for this IPv6 header.
+ *
+ ****************************************************************************/
+
+static bool hc06_cache_match(FAR struct radio_driver_s *radio,
+                             FAR const struct ipv6_hdr_s *ipv6,
+                             FAR const struct netdev_varaddr_s *destmac)
+{
+  FAR struct sixlowpan_hc06cache_s *cache = &g_hc06cache;
+
+  return cache->radio == radio &&
+         cache->proto == ipv6->proto && cache->ttl == ipv6->ttl &&
+         memcmp(cache->vtcflow, &ipv6->vtc, 4) == 0 &&
+         net_ipv6addr_cmp(cache->destipaddr, ipv6->destipaddr) &&
+         net_ipv6addr_cmp(cache->srcipaddr, ipv6->srcipaddr) &&
+         hc06_cache_varaddr(&cache->destmac, destmac) &&
+         hc06_cache_varaddr(&cache->srcmac, &radio->r_dev.d_mac.radio);
+}
+
+/****************************************************************************
+ * Name: hc06_cache_save
+ *
+ * Description:
+ *   Save the IPHC encoding of the IPv6 header just compressed.
+ *
+ ****************************************************************************/
+
+static void hc06_cache_save(FAR struct radio_driver_s *radio,
+                            FAR const struct ipv6_hdr_s *ipv6,
+                            FAR const struct netdev_varaddr_s *destmac,
+                            uint8_t iphc0, uint8_t iphc1,
+                            FAR const uint8_t *iphc)
+{
+  FAR struct sixlowpan_hc06cache_s *cache = &g_hc06cache;
+  unsigned int len = g_hc06ptr - iphc;
+
+  DEBUGASSERT(len <= HC06_CACHE_MAXLEN);
+
+  cache->radio   = radio;
+  cache->proto   = ipv6->proto;
+  cache->ttl     = ipv6->ttl;
+  cache->len     = len;
+  cache->iphc[0] = iphc0;
+  cache->iphc[1] = iphc1;
+
+  memcpy(cache->vtcflow, &ipv6->vtc, 4);
+  net_ipv6addr_copy(cache->srcipaddr, ipv6->srcipaddr);
+  net_ipv6addr_copy(cache->destipaddr, ipv6->destipaddr);
+  memcpy(&cache->srcmac, &radio->r_dev.d_mac.radio,
+         sizeof(struct netdev_varaddr_s));
+  memcpy(&cache->destmac, destmac, sizeof(struct netdev_varaddr_s));
+  memcpy(&cache->iphc[2], &iphc[2], len - 2);
+}
+#endif /* CONFIG_NET_6LOWPAN_HC06_CACHE */
+
 /****************************************************************************
  * Public Functions
  ****************************************************************************/
@@ -586,6 +696,15 @@ void sixlowpan_hc06_initialize(void)
 #if CONFIG_NET_6LOWPAN_MAXADDRCONTEXT > 1
   int i;
 #endif
+#endif
+
+#ifdef CONFIG_NET_6LOWPAN_HC06_CACHE
+  /* The cached encoding depends on the address contexts */
+
+  g_hc06cache.radio = NULL;
+#endif
+
+#if CONFIG_NET_6LOWPAN_MAXADDRCONTEXT > 0
 
   /* Preinitialize any address contexts for better header compression
    * (Saves up to 13 bytes per 6lowpan packet).
@@ -718,6 +837,22 @@ int sixlowpan_compresshdr_hc06(FAR struct radio_driver_s *radio,
 
   ninfo("fptr=%p g_frame_hdrlen=%u iphc=%p\n", fptr, g_frame_hdrlen, iphc);
 
+#ifdef CONFIG_NET_6LOWPAN_HC06_CACHE
+  /* If this packet belongs to the same flow as the last one, then the IPHC
+   * encoding through the addresses is the same, too.  Only the next header
+   * compression remains to be done.
+   */
+
+  if (hc06_cache_match(radio, ipv6, destmac))
+    {
+      memcpy(iphc, g_hc06cache.iphc, g_hc06cache.len);
+      iphc0     = g_hc06cache.iphc[0];
+      iphc1     = g_hc06cache.iphc[1];
+      g_hc06ptr = iphc + g_hc06cache.len;
+      goto compress_nexthdr;
+    }
+#endif
+
   /* As we copy some bit-length fields, in the IPHC encoding bytes,
    * we sometimes use |=
    * If the field is 0, and the current bit value in memory is 1,
@@ -1000,6 +1135,11 @@ int sixlowpan_compresshdr_hc06(FAR struct radio_driver_s *radio,
         }
     }
 
+#ifdef CONFIG_NET_6LOWPAN_HC06_CACHE
+  hc06_cache_save(radio, ipv6, destmac, iphc0, iphc1, iphc);
+
+compress_nexthdr:
+#endif
   g_uncomp_hdrlen = IPv6_HDRLEN;
 
 #ifdef CONFIG_NET_UDP
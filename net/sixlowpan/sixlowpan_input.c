@@ -326,6 +326,7 @@ static int sixlowpan_frame_process(FAR struct radio_driver_s *radio,
         fragsize        = GETUINT16(fragptr, SIXLOWPAN_FRAG_DISPATCH_SIZE) & 0x07ff;
         fragtag         = GETUINT16(fragptr, SIXLOWPAN_FRAG_TAG);
         g_frame_hdrlen += SIXLOWPAN_FRAG1_HDR_LEN;
+        NETDEV_RXFRAGMENTS(&radio->r_dev);
 
         ninfo("FRAG1: fragsize=%d fragtag=%d fragoffset=%d\n",
               fragsize, fragtag, fragoffset);
@@ -362,6 +363,7 @@ static int sixlowpan_frame_process(FAR struct radio_driver_s *radio,
         if (reass == NULL)
           {
             nerr("ERROR: Failed to allocate a reassembly buffer\n");
+            NETDEV_RXDROPPED(&radio->r_dev);
             return -ENOMEM;
           }
 
@@ -385,6 +387,7 @@ static int sixlowpan_frame_process(FAR struct radio_driver_s *radio,
         fragtag         = GETUINT16(fragptr, SIXLOWPAN_FRAG_TAG);
         fragsize        = GETUINT16(fragptr, SIXLOWPAN_FRAG_DISPATCH_SIZE) & 0x07ff;
         g_frame_hdrlen += SIXLOWPAN_FRAGN_HDR_LEN;
+        NETDEV_RXFRAGMENTS(&radio->r_dev);
 
         /* Extract the source address from the 'metadata'. */
 
@@ -402,6 +405,7 @@ static int sixlowpan_frame_process(FAR struct radio_driver_s *radio,
           {
             nerr("ERROR: Failed to find a reassembly buffer for tag=%04x\n",
                  fragtag);
+            NETDEV_RXDROPPED(&radio->r_dev);
             return -ENOENT;
           }
 
@@ -589,6 +593,7 @@ static int sixlowpan_frame_process(FAR struct radio_driver_s *radio,
   return INPUT_PARTIAL;
 
 errout_with_reass:
+  NETDEV_RXDROPPED(&radio->r_dev);
   sixlowpan_reass_free(reass);
   return ret;
 }
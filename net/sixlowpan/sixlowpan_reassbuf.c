@@ -59,6 +59,14 @@
 
 #define NET_6LOWPAN_TIMEOUT SEC2TICK(CONFIG_NET_6LOWPAN_MAXAGE)
 
+/* Active reassembly buffers are hashed on the low order bits of the
+ * reassembly tag.  Senders increment the datagram tag for each fragmented
+ * packet so these bits distribute well.  Must be a power of two.
+ */
+
+#define REASS_HASH_SIZE     8
+#define REASS_HASH(t)       ((t) & (REASS_HASH_SIZE - 1))
+
 /****************************************************************************
  * Private Data
  ****************************************************************************/
@@ -70,9 +78,11 @@
 
 static FAR struct sixlowpan_reassbuf_s *g_free_reass;
 
-/* This is a list of active, allocated reassemby buffers */
+/* These are the lists of active, allocated reassemby buffers, indexed by
+ * the hash of the reassembly tag.
+ */
 
-static FAR struct sixlowpan_reassbuf_s *g_active_reass;
+static FAR struct sixlowpan_reassbuf_s *g_active_reass[REASS_HASH_SIZE];
 
 /* Pool of pre-allocated reassembly buffer stuctures */
 
@@ -114,6 +124,51 @@ static bool sixlowpan_compare_fragsrc(FAR struct sixlowpan_reassbuf_s *reass,
   return false;
 }
 
+/****************************************************************************
+ * Name: sixlowpan_reass_expired
+ *
+ * Description:
+ *   Check if a reassembly buffer is inactive or has timed out.
+ *
+ * Input Parameters:
+ *   reass - The reassembly buffer to check.
+ *
+ * Returned Value:
+ *   true if the reassembly buffer should be freed.
+ *
+ * Assumptions:
+ *   The network is locked.
+ *
+ ****************************************************************************/
+
+static bool sixlowpan_reass_expired(FAR struct sixlowpan_reassbuf_s *reass)
+{
+  clock_t elapsed;
+
+  /* Free any inactive reassembly buffers.  This is done because the life
+   * the reassembly buffer is not cerain.
+   */
+
+  if (!reass->rb_active)
+    {
+      return true;
+    }
+
+  /* Get the elpased time of the reassembly */
+
+  elapsed = clock_systimer() - reass->rb_time;
+
+  /* If the reassembly has expired, then free the reassembly buffer */
+
+  if (elapsed > NET_6LOWPAN_TIMEOUT)
+    {
+      nwarn("WARNING: Reassembly timed out\n");
+      return true;
+    }
+
+  return false;
+}
+
 /****************************************************************************
  * Name: sixlowpan_reass_expire
  *
@@ -135,35 +190,19 @@ static void sixlowpan_reass_expire(void)
 {
   FAR struct sixlowpan_reassbuf_s *reass;
   FAR struct sixlowpan_reassbuf_s *next;
-  clock_t elapsed;
+  int i;
 
   /* If reassembly timed out, cancel it */
 
-  for (reass = g_active_reass; reass != NULL; reass = next)
+  for (i = 0; i < REASS_HASH_SIZE; i++)
     {
-      /* Needed if 'reass' is freed */
-
-      next = reass->rb_flink;
-
-      /* Free any inactive reassembly buffers.  This is done because the life
-       * the reassembly buffer is not cerain.
-       */
-
-      if (!reass->rb_active)
-        {
-          sixlowpan_reass_free(reass);
-        }
-      else
+      for (reass = g_active_reass[i]; reass != NULL; reass = next)
         {
-          /* Get the elpased time of the reassembly */
-
-          elapsed = clock_systimer() - reass->rb_time;
-
-          /* If the reassembly has expired, then free the reassembly buffer */
+          /* Needed if 'reass' is freed */
 
-          if (elapsed > NET_6LOWPAN_TIMEOUT)
+          next = reass->rb_flink;
+          if (sixlowpan_reass_expired(reass))
             {
-              nwarn("WARNING: Reassembly timed out\n");
               sixlowpan_reass_free(reass);
             }
         }
@@ -189,12 +228,16 @@ static void sixlowpan_reass_expire(void)
 
 static void sixlowpan_remove_active(FAR struct sixlowpan_reassbuf_s *reass)
 {
+  FAR struct sixlowpan_reassbuf_s **head;
   FAR struct sixlowpan_reassbuf_s *curr;
   FAR struct sixlowpan_reassbuf_s *prev;
 
-  /* Find the reassembly buffer in the list of active reassembly buffers */
+  /* Find the reassembly buffer in the list of active reassembly buffers.
+   * Only that hash chain needs to be searched.
+   */
 
-  for (prev = NULL, curr = g_active_reass;
+  head = &g_active_reass[REASS_HASH(reass->rb_reasstag)];
+  for (prev = NULL, curr = *head;
        curr != NULL && curr != reass;
        prev = curr, curr = curr->rb_flink)
     {
@@ -208,7 +251,7 @@ static void sixlowpan_remove_active(FAR struct sixlowpan_reassbuf_s *reass)
 
       if (prev == NULL)
         {
-          g_active_reass = reass->rb_flink;
+          *head = reass->rb_flink;
         }
       else
         {
@@ -293,14 +336,20 @@ FAR struct sixlowpan_reassbuf_s *
   sixlowpan_reass_allocate(uint16_t reasstag,
                            FAR const struct netdev_varaddr_s *fragsrc)
 {
+  FAR struct sixlowpan_reassbuf_s **head;
   FAR struct sixlowpan_reassbuf_s *reass;
   uint8_t pool;
 
-  /* First, removed any expired or inactive reassembly buffers.  This might
-   * free up a pre-allocated buffer for this allocation.
+  /* If the free list is empty, first remove any expired or inactive
+   * reassembly buffers.  This might free up a pre-allocated buffer for this
+   * allocation.  There is no need to visit every buffer while pre-allocated
+   * buffers remain; stale buffers are also caught by sixlowpan_reass_find().
    */
 
-  sixlowpan_reass_expire();
+  if (g_free_reass == NULL)
+    {
+      sixlowpan_reass_expire();
+    }
 
   /* Now, try the free list first */
 
@@ -340,8 +389,9 @@ FAR struct sixlowpan_reassbuf_s *
 
       /* Add the reassembly buffer to the list of active reassembly buffers */
 
-      reass->rb_flink   = g_active_reass;
-      g_active_reass    = reass;
+      head              = &g_active_reass[REASS_HASH(reasstag)];
+      reass->rb_flink   = *head;
+      *head             = reass;
     }
 
   return reass;
@@ -371,19 +421,30 @@ FAR struct sixlowpan_reassbuf_s *
                        FAR const struct netdev_varaddr_s *fragsrc)
 {
   FAR struct sixlowpan_reassbuf_s *reass;
+  FAR struct sixlowpan_reassbuf_s *next;
 
-  /* First, removed any expired or inactive reassembly buffers (we don't want
-   * to return old reassembly buffer with the same tag)
+  /* Search for the matching reassembly buffer in the hash chain for this
+   * tag.
    */
 
-  sixlowpan_reass_expire();
+  for (reass = g_active_reass[REASS_HASH(reasstag)];
+       reass != NULL;
+       reass = next)
+    {
+      /* Needed if 'reass' is freed */
 
-  /* Now search for the matching reassembly buffer in the remainng, active
-   * reassembly buffers.
-   */
+      next = reass->rb_flink;
+
+      /* Remove any expired or inactive reassembly buffers that we encounter
+       * (we don't want to return old reassembly buffer with the same tag)
+       */
+
+      if (sixlowpan_reass_expired(reass))
+        {
+          sixlowpan_reass_free(reass);
+          continue;
+        }
 
-  for (reass = g_active_reass; reass != NULL; reass = reass->rb_flink)
-    {
       /* In order to be a match, it must have the same reassembly tag as
        * well as source address (different sources might use the same
        * reassembly tag).
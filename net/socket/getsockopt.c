@@ -261,14 +261,73 @@ static int psock_socketlevel_option(FAR struct socket *psock, int option,
         }
         break;
 
+#ifdef NET_TCP_HAVE_STACK
+      case SO_RCVBUF:     /* Gets receive buffer size */
+#ifdef CONFIG_NET_TCP_WRITE_BUFFERS
+      case SO_SNDBUF:     /* Gets send buffer size */
+#endif
+        {
+          FAR struct tcp_conn_s *conn;
+          uint32_t buffersize;
+
+          /* Verify that option is the size of an 'int'.  Should also check
+           * that 'value' is properly aligned for an 'int'
+           */
+
+          if (*value_len < sizeof(int))
+            {
+              return -EINVAL;
+            }
+
+          if (psock->s_type != SOCK_STREAM ||
+              (psock->s_domain != PF_INET && psock->s_domain != PF_INET6))
+            {
+              return -ENOPROTOOPT;
+            }
+
+          conn = (FAR struct tcp_conn_s *)psock->s_conn;
+          DEBUGASSERT(conn != NULL);
+
+#ifdef CONFIG_NET_TCP_WRITE_BUFFERS
+          if (option == SO_SNDBUF)
+            {
+              buffersize = conn->sndbufs;
+            }
+          else
+#endif
+            {
+              buffersize = conn->rcvbufs;
+            }
+
+          /* With no limit set, report the size of the whole I/O buffer
+           * pool, which is the most that could ever be buffered.
+           */
+
+#ifdef CONFIG_MM_IOB
+          if (buffersize == 0)
+            {
+              buffersize = CONFIG_IOB_NBUFFERS * CONFIG_IOB_BUFSIZE;
+            }
+#endif
+
+          *(FAR int *)value = (int)buffersize;
+          *value_len        = sizeof(int);
+        }
+        break;
+#endif
+
       /* The following are not yet implemented (return values other than {0,1) */
 
       case SO_ACCEPTCONN: /* Reports whether socket listening is enabled */
       case SO_ERROR:      /* Reports and clears error status. */
       case SO_LINGER:     /* Lingers on a close() if data is present */
+#ifndef NET_TCP_HAVE_STACK
       case SO_RCVBUF:     /* Sets receive buffer size */
-      case SO_RCVLOWAT:   /* Sets the minimum number of bytes to input */
+#endif
+#if !defined(NET_TCP_HAVE_STACK) || !defined(CONFIG_NET_TCP_WRITE_BUFFERS)
       case SO_SNDBUF:     /* Sets send buffer size */
+#endif
+      case SO_RCVLOWAT:   /* Sets the minimum number of bytes to input */
       case SO_SNDLOWAT:   /* Sets the minimum number of bytes to output */
 
       default:
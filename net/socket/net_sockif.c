@@ -48,6 +48,7 @@
 #include "inet/inet.h"
 #include "local/local.h"
 #include "netlink/netlink.h"
+#include "can/can.h"
 #include "pkt/pkt.h"
 #include "bluetooth/bluetooth.h"
 #include "ieee802154/ieee802154.h"
@@ -110,6 +111,12 @@ FAR const struct sock_intf_s *
       break;
 #endif
 
+#ifdef CONFIG_NET_CAN
+    case PF_CAN:
+      sockif = &g_can_sockif;
+      break;
+#endif
+
 #ifdef CONFIG_NET_PKT
     case PF_PACKET:
       sockif = &g_pkt_sockif;
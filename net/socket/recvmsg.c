@@ -0,0 +1,303 @@
+/****************************************************************************
+ * net/socket/recvmsg.c
+ *
+ *   Copyright (C) 2020 Gregory Nutt. All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in
+ *    the documentation and/or other materials provided with the
+ *    distribution.
+ * 3. Neither the name NuttX nor the names of its contributors may be
+ *    used to endorse or promote products derived from this software
+ *    without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+ * FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE
+ * COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+ * INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,
+ * BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS
+ * OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED
+ * AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ * LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN
+ * ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ *
+ ****************************************************************************/
+
+/****************************************************************************
+ * Included Files
+ ****************************************************************************/
+
+#include <nuttx/config.h>
+
+#include <sys/types.h>
+#include <sys/socket.h>
+#include <stdint.h>
+#include <string.h>
+#include <time.h>
+#include <errno.h>
+
+#include <nuttx/clock.h>
+#include <nuttx/cancelpt.h>
+#include <nuttx/kmalloc.h>
+#include <nuttx/net/net.h>
+
+#include "socket/socket.h"
+
+#ifdef CONFIG_NET
+
+/****************************************************************************
+ * Public Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: psock_recvmsg
+ *
+ * Description:
+ *   psock_recvmsg() receives data into the buffers described by a message
+ *   header.  This is an internal OS interface.  It is functionally
+ *   equivalent to recvmsg() except that it is not a cancellation point,
+ *   does not modify errno, and accepts the internal socket structure as an
+ *   input.
+ *
+ *   A message with more than one I/O vector is received into one buffer
+ *   and then scattered so that a datagram is never split.  No ancillary
+ *   data is returned (msg_controllen is set to zero).
+ *
+ * Input Parameters:
+ *   psock - A pointer to a NuttX-specific, internal socket structure
+ *   msg   - The message header describing the receive buffers
+ *   flags - Receive flags
+ *
+ * Returned Value:
+ *   On success, returns the number of bytes received.  On failure, a
+ *   negated errno value is returned (see psock_recvfrom()).
+ *
+ ****************************************************************************/
+
+ssize_t psock_recvmsg(FAR struct socket *psock, FAR struct msghdr *msg,
+                      int flags)
+{
+  FAR struct sockaddr *from;
+  FAR uint8_t *buf;
+  FAR uint8_t *ptr;
+  socklen_t fromlen;
+  size_t len;
+  size_t ncopy;
+  ssize_t ret;
+  unsigned long i;
+
+  if (msg == NULL || msg->msg_iov == NULL || msg->msg_iovlen < 1)
+    {
+      return -EINVAL;
+    }
+
+  from                = (FAR struct sockaddr *)msg->msg_name;
+  fromlen             = msg->msg_namelen;
+  msg->msg_flags      = 0;
+  msg->msg_controllen = 0;
+
+  if (msg->msg_iovlen == 1)
+    {
+      /* The common case needs no copy */
+
+      ret = psock_recvfrom(psock, msg->msg_iov->iov_base,
+                           msg->msg_iov->iov_len, flags, from,
+                           from != NULL ? &fromlen : NULL);
+    }
+  else
+    {
+      /* Receive into one buffer and scatter it over the vectors */
+
+      for (i = 0, len = 0; i < msg->msg_iovlen; i++)
+        {
+          len += msg->msg_iov[i].iov_len;
+        }
+
+      buf = (FAR uint8_t *)kmm_malloc(len > 0 ? len : 1);
+      if (buf == NULL)
+        {
+          return -ENOMEM;
+        }
+
+      ret = psock_recvfrom(psock, buf, len, flags, from,
+                           from != NULL ? &fromlen : NULL);
+
+      for (i = 0, ptr = buf, len = ret > 0 ? ret : 0;
+           i < msg->msg_iovlen && len > 0;
+           i++)
+        {
+          ncopy = msg->msg_iov[i].iov_len;
+          if (ncopy > len)
+            {
+              ncopy = len;
+            }
+
+          memcpy(msg->msg_iov[i].iov_base, ptr, ncopy);
+          ptr += ncopy;
+          len -= ncopy;
+        }
+
+      kmm_free(buf);
+    }
+
+  if (ret >= 0 && from != NULL)
+    {
+      msg->msg_namelen = fromlen;
+    }
+
+  return ret;
+}
+
+/****************************************************************************
+ * Name: recvmsg
+ *
+ * Description:
+ *   The recvmsg() call is identical to recvfrom() except that the receive
+ *   buffers and the source address are described by a message header.  The
+ *   data may be scattered over several I/O vectors.
+ *
+ * Input Parameters:
+ *   sockfd - Socket descriptor of socket
+ *   msg    - The message header describing the receive buffers
+ *   flags  - Receive flags
+ *
+ * Returned Value:
+ *   On success, returns the number of bytes received.  On error, -1 is
+ *   returned and errno is set appropriately (see recvfrom()).
+ *
+ ****************************************************************************/
+
+ssize_t recvmsg(int sockfd, FAR struct msghdr *msg, int flags)
+{
+  ssize_t ret;
+
+  /* recvmsg() is a cancellation point */
+
+  enter_cancellation_point();
+
+  ret = psock_recvmsg(sockfd_socket(sockfd), msg, flags);
+  if (ret < 0)
+    {
+      set_errno(-ret);
+      ret = ERROR;
+    }
+
+  leave_cancellation_point();
+  return ret;
+}
+
+/****************************************************************************
+ * Name: recvmmsg
+ *
+ * Description:
+ *   Receive several messages with one call.  For Internet sockets the
+ *   network is locked only once for the whole batch instead of once per
+ *   message.  The number of bytes received for each message is returned in
+ *   its msg_len field.
+ *
+ *   With MSG_WAITFORONE, only the first message may block; the rest of the
+ *   batch is taken from whatever is already queued.
+ *
+ * Input Parameters:
+ *   sockfd  - Socket descriptor of socket
+ *   msgvec  - The array of message headers to receive into
+ *   vlen    - The number of entries in msgvec
+ *   flags   - Receive flags
+ *   timeout - If not NULL, no further message is received after this
+ *             interval has expired.  As on Linux, the interval is checked
+ *             only after each message is received.
+ *
+ * Returned Value:
+ *   The number of messages received.  If no message was received, -1 is
+ *   returned and errno is set appropriately.
+ *
+ ****************************************************************************/
+
+int recvmmsg(int sockfd, FAR struct mmsghdr *msgvec, unsigned int vlen,
+             int flags, FAR struct timespec *timeout)
+{
+  FAR struct socket *psock;
+  unsigned int count = 0;
+  clock_t start = 0;
+  clock_t ticks = 0;
+  ssize_t ret = OK;
+  bool batch;
+
+  /* recvmmsg() is a cancellation point */
+
+  enter_cancellation_point();
+
+  psock = sockfd_socket(sockfd);
+  if (psock == NULL || psock->s_crefs <= 0)
+    {
+      ret = -EBADF;
+      goto errout;
+    }
+
+  if (timeout != NULL)
+    {
+      start = clock_systimer();
+      ticks = SEC2TICK(timeout->tv_sec) + NSEC2TICK(timeout->tv_nsec);
+    }
+
+  batch = _SS_CANBATCH(psock);
+  if (batch)
+    {
+      net_lock();
+    }
+
+  for (; count < vlen; count++)
+    {
+      ret = psock_recvmsg(psock, &msgvec[count].msg_hdr,
+                          flags & ~MSG_WAITFORONE);
+      if (ret < 0)
+        {
+          break;
+        }
+
+      msgvec[count].msg_len = ret;
+
+      if ((flags & MSG_WAITFORONE) != 0)
+        {
+          flags |= MSG_DONTWAIT;
+        }
+
+      if (timeout != NULL && clock_systimer() - start >= ticks)
+        {
+          count++;
+          break;
+        }
+    }
+
+  if (batch)
+    {
+      net_unlock();
+    }
+
+  if (count > 0)
+    {
+      leave_cancellation_point();
+      return count;
+    }
+
+errout:
+  if (ret < 0)
+    {
+      set_errno(-ret);
+      ret = ERROR;
+    }
+
+  leave_cancellation_point();
+  return ret;
+}
+
+#endif /* CONFIG_NET */
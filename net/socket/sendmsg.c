@@ -0,0 +1,251 @@
+/****************************************************************************
+ * net/socket/sendmsg.c
+ *
+ *   Copyright (C) 2020 Gregory Nutt. All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in
+ *    the documentation and/or other materials provided with the
+ *    distribution.
+ * 3. Neither the name NuttX nor the names of its contributors may be
+ *    used to endorse or promote products derived from this software
+ *    without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+ * FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE
+ * COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+ * INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,
+ * BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS
+ * OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED
+ * AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ * LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN
+ * ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ *
+ ****************************************************************************/
+
+/****************************************************************************
+ * Included Files
+ ****************************************************************************/
+
+#include <nuttx/config.h>
+
+#include <sys/types.h>
+#include <sys/socket.h>
+#include <stdint.h>
+#include <string.h>
+#include <errno.h>
+
+#include <nuttx/cancelpt.h>
+#include <nuttx/kmalloc.h>
+#include <nuttx/net/net.h>
+
+#include "socket/socket.h"
+
+#ifdef CONFIG_NET
+
+/****************************************************************************
+ * Public Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: psock_sendmsg
+ *
+ * Description:
+ *   psock_sendmsg() sends the data described by a message header.  This is
+ *   an internal OS interface.  It is functionally equivalent to sendmsg()
+ *   except that it is not a cancellation point, does not modify errno, and
+ *   accepts the internal socket structure as an input.
+ *
+ *   A message with more than one I/O vector is gathered into one buffer so
+ *   that it is sent as a single datagram.
+ *
+ * Input Parameters:
+ *   psock - A pointer to a NuttX-specific, internal socket structure
+ *   msg   - The message to send
+ *   flags - Send flags
+ *
+ * Returned Value:
+ *   On success, returns the number of bytes sent.  On failure, a negated
+ *   errno value is returned (see psock_sendto()).
+ *
+ ****************************************************************************/
+
+ssize_t psock_sendmsg(FAR struct socket *psock, FAR struct msghdr *msg,
+                      int flags)
+{
+  FAR const struct sockaddr *to;
+  FAR uint8_t *buf;
+  FAR uint8_t *ptr;
+  size_t len;
+  ssize_t ret;
+  unsigned long i;
+
+  if (msg == NULL || (msg->msg_iovlen > 0 && msg->msg_iov == NULL))
+    {
+      return -EINVAL;
+    }
+
+  to = (FAR const struct sockaddr *)msg->msg_name;
+
+  /* The common case needs no copy */
+
+  if (msg->msg_iovlen == 1)
+    {
+      return psock_sendto(psock, msg->msg_iov->iov_base,
+                          msg->msg_iov->iov_len, flags, to,
+                          msg->msg_namelen);
+    }
+
+  /* Gather the vectors into one buffer */
+
+  for (i = 0, len = 0; i < msg->msg_iovlen; i++)
+    {
+      len += msg->msg_iov[i].iov_len;
+    }
+
+  buf = (FAR uint8_t *)kmm_malloc(len > 0 ? len : 1);
+  if (buf == NULL)
+    {
+      return -ENOMEM;
+    }
+
+  for (i = 0, ptr = buf; i < msg->msg_iovlen; i++)
+    {
+      memcpy(ptr, msg->msg_iov[i].iov_base, msg->msg_iov[i].iov_len);
+      ptr += msg->msg_iov[i].iov_len;
+    }
+
+  ret = psock_sendto(psock, buf, len, flags, to, msg->msg_namelen);
+  kmm_free(buf);
+  return ret;
+}
+
+/****************************************************************************
+ * Name: sendmsg
+ *
+ * Description:
+ *   The sendmsg() call is identical to sendto() except that the data and
+ *   the destination address are described by a message header.  The data
+ *   may be scattered over several I/O vectors.
+ *
+ * Input Parameters:
+ *   sockfd - Socket descriptor of socket
+ *   msg    - The message to send
+ *   flags  - Send flags
+ *
+ * Returned Value:
+ *   On success, returns the number of bytes sent.  On error, -1 is
+ *   returned and errno is set appropriately (see sendto()).
+ *
+ ****************************************************************************/
+
+ssize_t sendmsg(int sockfd, FAR struct msghdr *msg, int flags)
+{
+  ssize_t ret;
+
+  /* sendmsg() is a cancellation point */
+
+  enter_cancellation_point();
+
+  ret = psock_sendmsg(sockfd_socket(sockfd), msg, flags);
+  if (ret < 0)
+    {
+      set_errno(-ret);
+      ret = ERROR;
+    }
+
+  leave_cancellation_point();
+  return ret;
+}
+
+/****************************************************************************
+ * Name: sendmmsg
+ *
+ * Description:
+ *   Send several messages with one call.  For Internet sockets the network
+ *   is locked only once for the whole batch instead of once per message.
+ *   The number of bytes sent for each message is returned in its msg_len
+ *   field.
+ *
+ * Input Parameters:
+ *   sockfd - Socket descriptor of socket
+ *   msgvec - The array of messages to send
+ *   vlen   - The number of entries in msgvec
+ *   flags  - Send flags
+ *
+ * Returned Value:
+ *   The number of messages sent.  This may be less than vlen if an error
+ *   occurred part way; the error is then reported by a subsequent call.
+ *   If no message could be sent, -1 is returned and errno is set
+ *   appropriately.
+ *
+ ****************************************************************************/
+
+int sendmmsg(int sockfd, FAR struct mmsghdr *msgvec, unsigned int vlen,
+             int flags)
+{
+  FAR struct socket *psock;
+  unsigned int count = 0;
+  ssize_t ret = OK;
+  bool batch;
+
+  /* sendmmsg() is a cancellation point */
+
+  enter_cancellation_point();
+
+  psock = sockfd_socket(sockfd);
+  if (psock == NULL || psock->s_crefs <= 0)
+    {
+      ret = -EBADF;
+      goto errout;
+    }
+
+  batch = _SS_CANBATCH(psock);
+  if (batch)
+    {
+      net_lock();
+    }
+
+  for (; count < vlen; count++)
+    {
+      ret = psock_sendmsg(psock, &msgvec[count].msg_hdr, flags);
+      if (ret < 0)
+        {
+          break;
+        }
+
+      msgvec[count].msg_len = ret;
+    }
+
+  if (batch)
+    {
+      net_unlock();
+    }
+
+  if (count > 0)
+    {
+      leave_cancellation_point();
+      return count;
+    }
+
+errout:
+  if (ret < 0)
+    {
+      set_errno(-ret);
+      ret = ERROR;
+    }
+
+  leave_cancellation_point();
+  return ret;
+}
+
+#endif /* CONFIG_NET */
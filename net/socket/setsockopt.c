@@ -55,6 +55,8 @@
 #include "inet/inet.h"
 #include "tcp/tcp.h"
 #include "udp/udp.h"
+#include "pkt/pkt.h"
+#include "can/can.h"
 #include "usrsock/usrsock.h"
 #include "utils/utils.h"
 
@@ -283,11 +285,72 @@ static int psock_socketlevel_option(FAR struct socket *psock, int option,
         }
         break;
 #endif
+
+#ifdef NET_TCP_HAVE_STACK
+      /* SO_RCVBUF and SO_SNDBUF are honored only by TCP.  The receive limit
+       * caps the advertised window and the send limit caps the amount of
+       * data held in the write buffers.
+       */
+
+      case SO_RCVBUF:     /* Sets receive buffer size */
+#ifdef CONFIG_NET_TCP_WRITE_BUFFERS
+      case SO_SNDBUF:     /* Sets send buffer size */
+#endif
+        {
+          FAR struct tcp_conn_s *conn;
+          int buffersize;
+
+          /* Verify that option is the size of an 'int'.  Should also check
+           * that 'value' is properly aligned for an 'int'
+           */
+
+          if (value_len != sizeof(int))
+            {
+              return -EINVAL;
+            }
+
+          buffersize = *(FAR int *)value;
+          if (buffersize < 0)
+            {
+              return -EINVAL;
+            }
+
+          if (psock->s_type != SOCK_STREAM ||
+              (psock->s_domain != PF_INET && psock->s_domain != PF_INET6))
+            {
+              return -ENOPROTOOPT;
+            }
+
+          net_lock();
+
+          conn = (FAR struct tcp_conn_s *)psock->s_conn;
+          DEBUGASSERT(conn != NULL);
+
+          if (option == SO_RCVBUF)
+            {
+              conn->rcvbufs = buffersize;
+            }
+#ifdef CONFIG_NET_TCP_WRITE_BUFFERS
+          else
+            {
+              conn->sndbufs = buffersize;
+            }
+#endif
+
+          net_unlock();
+        }
+        break;
+#endif
+
       /* The following are not yet implemented */
 
+#ifndef NET_TCP_HAVE_STACK
       case SO_RCVBUF:     /* Sets receive buffer size */
-      case SO_RCVLOWAT:   /* Sets the minimum number of bytes to input */
+#endif
+#if !defined(NET_TCP_HAVE_STACK) || !defined(CONFIG_NET_TCP_WRITE_BUFFERS)
       case SO_SNDBUF:     /* Sets send buffer size */
+#endif
+      case SO_RCVLOWAT:   /* Sets the minimum number of bytes to input */
       case SO_SNDLOWAT:   /* Sets the minimum number of bytes to output */
 
       /* There options are only valid when used with getopt */
@@ -400,6 +463,18 @@ int psock_setsockopt(FAR struct socket *psock, int level, int option,
         break;
 #endif
 
+#ifdef CONFIG_NET_PKT_RXRING
+      case SOL_PACKET: /* Packet socket options (see include/netpacket/packet.h) */
+        ret = pkt_setsockopt(psock, option, value, value_len);
+        break;
+#endif
+
+#ifdef CONFIG_NET_CAN
+      case SOL_CAN_RAW: /* CAN socket options (see include/netpacket/can.h) */
+        ret = can_setsockopt(psock, option, value, value_len);
+        break;
+#endif
+
       default:         /* The provided level is invalid */
         ret = -EINVAL;
         break;
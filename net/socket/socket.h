@@ -89,6 +89,14 @@
 #define _SS_ISCONNECTED(s)  (((s) & _SF_CONNECTED) != 0)
 #define _SS_ISCLOSED(s)     (((s) & _SF_CLOSED)    != 0)
 
+/* sendmmsg() and recvmmsg() hold the network lock across a whole batch.
+ * That is only safe for address families that release the lock while they
+ * wait (see net_lockedwait()).
+ */
+
+#define _SS_CANBATCH(p)     ((p)->s_domain == PF_INET || \
+                             (p)->s_domain == PF_INET6)
+
 /* This macro converts a socket option value into a bit setting */
 
 #define _SO_BIT(o)       (1 << (o))
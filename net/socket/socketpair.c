@@ -0,0 +1,238 @@
+/****************************************************************************
+ * net/socket/socketpair.c
+ *
+ *   Copyright (C) 2020 Gregory Nutt. All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in
+ *    the documentation and/or other materials provided with the
+ *    distribution.
+ * 3. Neither the name NuttX nor the names of its contributors may be
+ *    used to endorse or promote products derived from this software
+ *    without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+ * FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE
+ * COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+ * INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,
+ * BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS
+ * OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED
+ * AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ * LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN
+ * ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ *
+ ****************************************************************************/
+
+/****************************************************************************
+ * Included Files
+ ****************************************************************************/
+
+#include <nuttx/config.h>
+
+#include <sys/socket.h>
+#include <errno.h>
+#include <assert.h>
+#include <debug.h>
+
+#include "socket/socket.h"
+#include "local/local.h"
+
+#ifdef CONFIG_NET
+
+/****************************************************************************
+ * Public Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: psock_socketpair
+ *
+ * Description:
+ *   psock_socketpair() creates an unnamed pair of connected sockets and
+ *   returns them in the two socket structures.  Only Unix domain stream
+ *   sockets are supported.
+ *
+ * Input Parameters:
+ *   domain   (see sys/socket.h)
+ *   type     (see sys/socket.h)
+ *   protocol (see sys/socket.h)
+ *   psock0   The first socket structure of the pair
+ *   psock1   The second socket structure of the pair
+ *
+ * Returned Value:
+ *   Returns zero (OK) on success.  On failure, it returns a negated errno
+ *   value to indicate the nature of the error:
+ *
+ *   EAFNOSUPPORT
+ *     The specified address family is not supported on this machine.
+ *   EOPNOTSUPP
+ *     The specified protocol does not permit creation of socket pairs.
+ *
+ *   Or any error returned by psock_socket().
+ *
+ ****************************************************************************/
+
+int psock_socketpair(int domain, int type, int protocol,
+                     FAR struct socket *psock0, FAR struct socket *psock1)
+{
+#ifdef CONFIG_NET_LOCAL_STREAM
+  int ret;
+
+  if (domain != PF_LOCAL)
+    {
+      return -EOPNOTSUPP;
+    }
+
+  if (type != SOCK_STREAM)
+    {
+      return -EOPNOTSUPP;
+    }
+
+  /* Create the two sockets */
+
+  ret = psock_socket(domain, type, protocol, psock0);
+  if (ret < 0)
+    {
+      return ret;
+    }
+
+  ret = psock_socket(domain, type, protocol, psock1);
+  if (ret < 0)
+    {
+      goto errout_with_psock0;
+    }
+
+  /* And connect them to each other */
+
+  ret = local_socketpair(psock0, psock1);
+  if (ret < 0)
+    {
+      nerr("ERROR: local_socketpair() failed: %d\n", ret);
+      goto errout_with_psock1;
+    }
+
+  psock0->s_flags |= _SF_CONNECTED;
+  psock1->s_flags |= _SF_CONNECTED;
+  return OK;
+
+errout_with_psock1:
+  psock_close(psock1);
+
+errout_with_psock0:
+  psock_close(psock0);
+  return ret;
+#else
+  return domain == PF_LOCAL ? -EOPNOTSUPP : -EAFNOSUPPORT;
+#endif
+}
+
+/****************************************************************************
+ * Name: socketpair
+ *
+ * Description:
+ *   socketpair() creates an unnamed pair of connected sockets in the
+ *   specified domain, of the specified type, and using the optionally
+ *   specified protocol.  The descriptors used in referencing the new
+ *   sockets are returned in sv[0] and sv[1].
+ *
+ * Input Parameters:
+ *   domain   (see sys/socket.h)
+ *   type     (see sys/socket.h)
+ *   protocol (see sys/socket.h)
+ *   sv       The two new socket descriptors
+ *
+ * Returned Value:
+ *   Zero (OK) is returned on success.  On failure, -1 (ERROR) is returned
+ *   and errno is set appropriately:
+ *
+ *   EAFNOSUPPORT
+ *     The specified address family is not supported on this machine.
+ *   EOPNOTSUPP
+ *     The specified protocol does not permit creation of socket pairs.
+ *   ENFILE
+ *     Not enough free socket descriptors.
+ *   EFAULT
+ *     The address sv does not specify a valid part of the process
+ *     address space.
+ *
+ * Assumptions:
+ *
+ ****************************************************************************/
+
+int socketpair(int domain, int type, int protocol, int sv[2])
+{
+  FAR struct socket *psock0;
+  FAR struct socket *psock1;
+  int sockfd0;
+  int sockfd1;
+  int errcode;
+  int ret;
+
+  if (sv == NULL)
+    {
+      errcode = EFAULT;
+      goto errout;
+    }
+
+  /* Allocate the socket descriptors */
+
+  sockfd0 = sockfd_allocate(0);
+  if (sockfd0 < 0)
+    {
+      nerr("ERROR: Failed to allocate a socket descriptor\n");
+      errcode = ENFILE;
+      goto errout;
+    }
+
+  sockfd1 = sockfd_allocate(0);
+  if (sockfd1 < 0)
+    {
+      nerr("ERROR: Failed to allocate a socket descriptor\n");
+      errcode = ENFILE;
+      goto errout_with_sockfd0;
+    }
+
+  /* Get the underlying socket structures */
+
+  psock0 = sockfd_socket(sockfd0);
+  psock1 = sockfd_socket(sockfd1);
+  if (!psock0 || !psock1)
+    {
+      errcode = ENOSYS; /* should not happen */
+      goto errout_with_sockfd1;
+    }
+
+  /* Create and connect the socket pair */
+
+  ret = psock_socketpair(domain, type, protocol, psock0, psock1);
+  if (ret < 0)
+    {
+      nerr("ERROR: psock_socketpair() failed: %d\n", ret);
+      errcode = -ret;
+      goto errout_with_sockfd1;
+    }
+
+  sv[0] = sockfd0;
+  sv[1] = sockfd1;
+  return OK;
+
+errout_with_sockfd1:
+  sockfd_release(sockfd1);
+
+errout_with_sockfd0:
+  sockfd_release(sockfd0);
+
+errout:
+  set_errno(errcode);
+  return ERROR;
+}
+
+#endif /* CONFIG_NET */
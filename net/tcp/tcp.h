@@ -44,6 +44,7 @@
 
 #include <sys/types.h>
 #include <queue.h>
+#include <semaphore.h>
 
 #include <nuttx/clock.h>
 #include <nuttx/mm/iob.h>
@@ -67,6 +68,19 @@
 #  define HAVE_TCP_POLL
 #endif
 
+/* The largest amount of payload that may be handed to the device in one
+ * packet:  The MSS or, if the device does TCP segmentation offload, the
+ * device TSO limit.
+ */
+
+#ifdef CONFIG_NETDEV_OFFLOAD
+#  define TCP_SNDMSS(d,c) \
+     (NETDEV_HAS_FEATURE(d, NETDEV_FEATURE_TSO | NETDEV_FEATURE_TXCSUM) && \
+      (d)->d_tsomax > (c)->mss ? (d)->d_tsomax : (c)->mss)
+#else
+#  define TCP_SNDMSS(d,c) ((c)->mss)
+#endif
+
 /* Allocate a new TCP data callback */
 
 /* These macros allocate and free callback structures used for receiving
@@ -106,6 +120,34 @@
 #  endif
 #endif
 
+/* Hash a local port number (in network byte order) into one of the
+ * CONFIG_NET_TCP_HASHSIZE buckets.  Both bytes are folded in so that the
+ * result does not depend on the host byte order.
+ */
+
+#ifdef CONFIG_NET_TCP_HASH
+#  define TCP_PORTHASH(p) \
+     ((unsigned int)((p) ^ ((p) >> 8)) % CONFIG_NET_TCP_HASHSIZE)
+#endif
+
+/* Update one of the per-connection counters.  The caller holds the network
+ * lock, as all of the TCP state machine does.
+ */
+
+#ifdef CONFIG_NET_TCP_CONNSTATS
+#  define TCP_CONNSTATS(c,f,n) do { (c)->stats.f += (n); } while (0)
+#else
+#  define TCP_CONNSTATS(c,f,n)
+#endif
+
+/* Bits of tcp_conn_s::nagle that control the coalescing of small segments */
+
+#ifdef CONFIG_NET_TCP_NAGLE
+#  define TCP_NAGLE_NODELAY  (1 << 0) /* TCP_NODELAY: No Nagle delay */
+#  define TCP_NAGLE_CORK     (1 << 1) /* TCP_CORK: Hold partial segments */
+#  define TCP_NAGLE_MORE     (1 << 2) /* The last send() had MSG_MORE */
+#endif
+
 /****************************************************************************
  * Public Type Definitions
  ****************************************************************************/
@@ -123,6 +165,41 @@ struct net_driver_s;      /* Forward reference */
 struct devif_callback_s;  /* Forward reference */
 struct tcp_backlog_s;     /* Forward reference */
 struct tcp_hdr_s;         /* Forward reference */
+struct tcp_conn_s;        /* Forward reference */
+
+#ifdef CONFIG_NET_TCP_CONNSTATS
+/* Per-connection counters, shown in /proc/net/tcp */
+
+struct tcp_connstats_s
+{
+  uint32_t rxsegs;        /* Segments received */
+  uint32_t rxbytes;       /* Payload bytes received (including duplicates) */
+  uint32_t txsegs;        /* Segments sent (including retransmissions) */
+  uint32_t txbytes;       /* Payload bytes sent (including retransmissions) */
+  uint32_t rexmit;        /* Retransmissions */
+};
+#endif
+
+#ifdef CONFIG_NET_TCP_CC
+/* Congestion control algorithm interface.  See tcp_cc.c.
+ *
+ *   init       - Reset the algorithm state when the congestion window is
+ *                first opened.
+ *   cong_avoid - Grow cwnd when 'acked' new bytes are ACKed outside of
+ *                fast recovery.
+ *   ssthresh   - Return the new slow start threshold after a loss was
+ *                detected (by duplicate ACKs or by a retransmission
+ *                timeout).
+ */
+
+struct tcp_cc_ops_s
+{
+  FAR const char *name;
+  CODE void (*init)(FAR struct tcp_conn_s *conn);
+  CODE void (*cong_avoid)(FAR struct tcp_conn_s *conn, uint32_t acked);
+  CODE uint32_t (*ssthresh)(FAR struct tcp_conn_s *conn);
+};
+#endif
 
 struct tcp_conn_s
 {
@@ -179,9 +256,26 @@ struct tcp_conn_s
   uint16_t rport;         /* The remoteTCP port, in network byte order */
   uint16_t mss;           /* Current maximum segment size for the
                            * connection */
+#ifdef CONFIG_NET_TCP_WINDOW_SCALE
+  uint32_t winsize;       /* Current window size of the connection */
+  bool     wscale;        /* True: Both sides offered window scaling */
+  uint8_t  snd_scale;     /* Shift count applied to the peer's window */
+  uint8_t  rcv_scale;     /* Shift count applied to our advertised window */
+#else
   uint16_t winsize;       /* Current window size of the connection */
+#endif
+#ifdef CONFIG_NET_SOCKOPTS
+  uint32_t rcvbufs;       /* SO_RCVBUF: Receive buffer limit (0: no limit) */
+#ifdef CONFIG_NET_TCP_WRITE_BUFFERS
+  uint32_t sndbufs;       /* SO_SNDBUF: Send buffer limit (0: no limit) */
+  sem_t    snd_sem;       /* Wakes up a sender waiting for SO_SNDBUF space */
+#endif
+#endif
 #ifdef CONFIG_NET_TCP_WRITE_BUFFERS
   uint32_t unacked;       /* Number bytes sent but not yet ACKed */
+#ifdef CONFIG_NET_TCP_NAGLE
+  uint8_t  nagle;         /* Segment coalescing flags.  See TCP_NAGLE_* */
+#endif
 #else
   uint16_t unacked;       /* Number bytes sent but not yet ACKed */
 #endif
@@ -193,6 +287,19 @@ struct tcp_conn_s
 
   FAR struct net_driver_s *dev;
 
+  /* Connections in TIME_WAIT are also kept on a queue, oldest first, so
+   * that tcp_alloc() can recycle one in constant time.  See tcp_timewait().
+   */
+
+  dq_entry_t twnode;      /* Links the connection into the TIME_WAIT queue */
+  bool     twqueued;      /* True: The connection is on the TIME_WAIT queue */
+
+#ifdef CONFIG_NET_TCP_CONNSTATS
+  /* Per-connection counters.  See TCP_CONNSTATS() */
+
+  struct tcp_connstats_s stats;
+#endif
+
 #ifdef CONFIG_NET_TCP_READAHEAD
   /* Read-ahead buffering.
    *
@@ -222,6 +329,48 @@ struct tcp_conn_s
                            * segment (next greater sndseq) */
 #endif
 
+#ifdef CONFIG_NET_TCP_CC
+  /* Congestion control and RTT estimation.  See tcp_cc.c.
+   *
+   *   cc       - The congestion control algorithm, NULL until the
+   *              congestion window has been opened.
+   *   cwnd     - Congestion window in bytes.
+   *   ssthresh - Slow start threshold in bytes.
+   *   lastack  - The last cumulative ACK number seen.
+   *   recover  - The highest sequence number sent when fast recovery was
+   *              entered (RFC 6582).
+   *   dupacks  - The number of duplicate ACKs received in a row.
+   *   recovery - True while in fast recovery.
+   *   rtttime  - The time that the timed segment was sent.
+   *   rttseq   - ACKing this sequence number completes the RTT sample.
+   *   rttpend  - True while a segment is being timed.
+   *   srtt     - Smoothed RTT, in clock ticks scaled by 8.
+   *   rttvar   - RTT variation, in clock ticks scaled by 4.
+   *   wmax     - CUBIC: The window size just before the last reduction.
+   *   epoch    - CUBIC: The start of the current congestion avoidance
+   *              epoch, zero if none.
+   *   kmsec    - CUBIC: The time (msec) to grow back to wmax.
+   */
+
+  FAR const struct tcp_cc_ops_s *cc;
+  uint32_t   cwnd;
+  uint32_t   ssthresh;
+  uint32_t   lastack;
+  uint32_t   recover;
+  uint8_t    dupacks;
+  bool       recovery;
+  bool       rttpend;
+  clock_t    rtttime;
+  uint32_t   rttseq;
+  uint32_t   srtt;
+  uint32_t   rttvar;
+#ifdef CONFIG_NET_TCP_CC_CUBIC
+  uint32_t   wmax;
+  clock_t    epoch;
+  uint32_t   kmsec;
+#endif
+#endif
+
 #ifdef CONFIG_NET_TCPBACKLOG
   /* Listen backlog support
    *
@@ -270,6 +419,30 @@ struct tcp_conn_s
 
   FAR void *accept_private;
   int (*accept)(FAR struct tcp_conn_s *listener, FAR struct tcp_conn_s *conn);
+
+#ifdef CONFIG_NET_TCP_HASH
+  /* Hash chains.  See tcp_conn.c and tcp_listen.c
+   *
+   *   hnext - Next active connection with the same (lport, rport, raddr)
+   *     hash.
+   *   pnext - Next connection with the same local port hash.  A connection
+   *     is on this chain whenever lport is non-zero.
+   *   lnext - Next listener with the same local port hash.
+   *   hashed - True while the connection is on an hnext chain.
+   */
+
+  FAR struct tcp_conn_s *hnext;
+  FAR struct tcp_conn_s *pnext;
+  FAR struct tcp_conn_s *lnext;
+  bool hashed;
+#endif
+
+#ifdef CONFIG_NET_TCP_TXREADY
+  /* Link in dev->d_tcptxq while txdev is non-NULL.  See tcp_txready(). */
+
+  dq_entry_t txnode;
+  FAR struct net_driver_s *txdev;
+#endif
 };
 
 /* This structure supports TCP write buffering */
@@ -499,6 +672,70 @@ int tcp_remote_ipv6_device(FAR struct tcp_conn_s *conn);
 FAR struct tcp_conn_s *tcp_alloc_accept(FAR struct net_driver_s *dev,
                                         FAR struct tcp_hdr_s *tcp);
 
+/****************************************************************************
+ * Name: tcp_timewait
+ *
+ * Description:
+ *   Move a connection into the TIME_WAIT state.  The connection is also
+ *   queued, oldest first, so that tcp_alloc() can recycle the oldest
+ *   TIME_WAIT connection without searching for it.
+ *
+ * Assumptions:
+ *   This function is called from network logic with the network locked.
+ *
+ ****************************************************************************/
+
+void tcp_timewait(FAR struct tcp_conn_s *conn);
+
+/****************************************************************************
+ * Name: tcp_syncookie
+ *
+ * Description:
+ *   Compute the SYN cookie for the SYN in the device buffer.
+ *
+ * Input Parameters:
+ *   dev - The device driver structure holding the received SYN
+ *   tcp - The TCP header of the SYN
+ *   mss - Location to return the MSS encoded in the cookie
+ *
+ * Returned Value:
+ *   The cookie, to be used as our initial sequence number.
+ *
+ * Assumptions:
+ *   This function is called from network logic with the network locked.
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_NET_TCP_SYNCOOKIES
+uint32_t tcp_syncookie(FAR struct net_driver_s *dev,
+                       FAR struct tcp_hdr_s *tcp, FAR uint16_t *mss);
+#endif
+
+/****************************************************************************
+ * Name: tcp_syncookie_check
+ *
+ * Description:
+ *   Check whether the ACK in the device buffer acknowledges a SYNACK that
+ *   was sent with a SYN cookie.
+ *
+ * Input Parameters:
+ *   dev - The device driver structure holding the received ACK
+ *   tcp - The TCP header of the ACK
+ *   mss - Location to return the MSS encoded in the cookie
+ *
+ * Returned Value:
+ *   OK if the cookie is valid and recent; -EINVAL otherwise.
+ *
+ * Assumptions:
+ *   This function is called from network logic with the network locked.
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_NET_TCP_SYNCOOKIES
+int tcp_syncookie_check(FAR struct net_driver_s *dev,
+                        FAR struct tcp_hdr_s *tcp, FAR uint16_t *mss);
+#endif
+
 /****************************************************************************
  * Name: tcp_bind
  *
@@ -763,6 +1000,59 @@ void tcp_nextsequence(void);
 
 void tcp_poll(FAR struct net_driver_s *dev, FAR struct tcp_conn_s *conn);
 
+/****************************************************************************
+ * Name: tcp_txready and tcp_txidle
+ *
+ * Description:
+ *   tcp_txready() puts the connection on the "TX ready" queue of its
+ *   device so that the next devif_poll() on that device will poll it.
+ *   This should be called whenever the connection gets something to send.
+ *   It does nothing if the connection is not yet bound to a device.
+ *
+ *   tcp_txidle() removes the connection from that queue.
+ *
+ * Input Parameters:
+ *   conn - The TCP connection
+ *
+ * Returned Value:
+ *   None
+ *
+ * Assumptions:
+ *   Called from network stack logic with the network stack locked
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_NET_TCP_TXREADY
+void tcp_txready(FAR struct tcp_conn_s *conn);
+void tcp_txidle(FAR struct tcp_conn_s *conn);
+#else
+#  define tcp_txready(conn)
+#  define tcp_txidle(conn)
+#endif
+
+/****************************************************************************
+ * Name: tcp_txpending
+ *
+ * Description:
+ *   Return true if the connection may need further TX polls:  either it
+ *   has data in flight that will be followed by more, or it has buffered
+ *   write data.
+ *
+ * Input Parameters:
+ *   conn - The TCP connection
+ *
+ * Returned Value:
+ *   True if the connection should stay on the "TX ready" queue.
+ *
+ * Assumptions:
+ *   Called from network stack logic with the network stack locked
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_NET_TCP_TXREADY
+bool tcp_txpending(FAR struct tcp_conn_s *conn);
+#endif
+
 /****************************************************************************
  * Name: tcp_timer
  *
@@ -962,6 +1252,31 @@ void tcp_reset(FAR struct net_driver_s *dev);
 void tcp_ack(FAR struct net_driver_s *dev, FAR struct tcp_conn_s *conn,
              uint8_t ack);
 
+/****************************************************************************
+ * Name: tcp_synack_cookie
+ *
+ * Description:
+ *   Answer the SYN in the device buffer with a SYNACK that carries a SYN
+ *   cookie as its sequence number, without a connection structure.
+ *
+ * Input Parameters:
+ *   dev    - The device driver structure holding the received SYN
+ *   cookie - The initial sequence number to send
+ *   mss    - The MSS to offer, the one encoded in the cookie
+ *
+ * Returned Value:
+ *   None
+ *
+ * Assumptions:
+ *   Called from network stack logic with the network stack locked
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_NET_TCP_SYNCOOKIES
+void tcp_synack_cookie(FAR struct net_driver_s *dev, uint32_t cookie,
+                       uint16_t mss);
+#endif
+
 /****************************************************************************
  * Name: tcp_appsend
  *
@@ -1250,6 +1565,7 @@ int psock_tcp_accept(FAR struct socket *psock, FAR struct sockaddr *addr,
  *   psock    An instance of the internal socket structure.
  *   buf      Data to send
  *   len      Length of data to send
+ *   flags    Send flags
  *
  * Returned Value:
  *   On success, returns the number of characters sent.  On  error,
@@ -1298,7 +1614,30 @@ int psock_tcp_accept(FAR struct socket *psock, FAR struct sockaddr *addr,
 
 struct socket;
 ssize_t psock_tcp_send(FAR struct socket *psock, FAR const void *buf,
-                       size_t len);
+                       size_t len, int flags);
+
+/****************************************************************************
+ * Name: psock_tcp_send_iob
+ *
+ * Description:
+ *   Queue an I/O buffer chain for transmission on a connected TCP socket
+ *   without copying it.  On success the network takes ownership of the
+ *   chain; on failure it remains with the caller.
+ *
+ * Input Parameters:
+ *   psock    An instance of the internal socket structure.
+ *   iob      The I/O buffer chain holding the data to send.
+ *
+ * Returned Value:
+ *   On success, returns the number of bytes queued.  On failure, a negated
+ *   errno value is returned as for psock_tcp_send().
+ *
+ ****************************************************************************/
+
+#if defined(CONFIG_NET_ZEROCOPY) && defined(CONFIG_NET_TCP_WRITE_BUFFERS)
+struct iob_s;
+ssize_t psock_tcp_send_iob(FAR struct socket *psock, FAR struct iob_s *iob);
+#endif
 
 /****************************************************************************
  * Name: tcp_setsockopt
@@ -1372,17 +1711,130 @@ int tcp_getsockopt(FAR struct socket *psock, int option,
  * Name: tcp_get_recvwindow
  *
  * Description:
- *   Calculate the TCP receive window for the specified device.
+ *   Calculate the TCP receive window for the specified device and
+ *   connection.
+ *
+ * Input Parameters:
+ *   dev  - The device whose TCP receive window will be updated.
+ *   conn - The TCP connection that the window is advertised for.
+ *
+ * Returned Value:
+ *   The value to place in the 16-bit TCP window field, i.e. already scaled
+ *   down by the negotiated window scale shift count.
+ *
+ ****************************************************************************/
+
+uint16_t tcp_get_recvwindow(FAR struct net_driver_s *dev,
+                            FAR struct tcp_conn_s *conn);
+
+#ifdef CONFIG_NET_TCP_CC
+/****************************************************************************
+ * Name: tcp_cc_init
+ *
+ * Description:
+ *   Open the congestion window of a connection that is about to send its
+ *   first data, using the configured congestion control algorithm.
+ *
+ * Input Parameters:
+ *   conn - The TCP connection
+ *
+ * Returned Value:
+ *   None
+ *
+ * Assumptions:
+ *   The network is locked.
+ *
+ ****************************************************************************/
+
+void tcp_cc_init(FAR struct tcp_conn_s *conn);
+
+/****************************************************************************
+ * Name: tcp_cc_sndwnd
+ *
+ * Description:
+ *   Return the number of bytes that may be in flight, the smaller of the
+ *   congestion window and the peer's receive window.
+ *
+ ****************************************************************************/
+
+uint32_t tcp_cc_sndwnd(FAR struct tcp_conn_s *conn);
+
+/****************************************************************************
+ * Name: tcp_cc_ack
+ *
+ * Description:
+ *   Account for an incoming ACK.  New data ACKs grow the congestion window.
+ *   Duplicate ACKs are counted and the third one enters fast recovery
+ *   (RFC 5681 and RFC 6582).
  *
  * Input Parameters:
- *   dev - The device whose TCP receive window will be updated.
+ *   conn    - The TCP connection
+ *   ackno   - The cumulative ACK number in the segment
+ *   dupcand - True if the segment could be a duplicate ACK (it carries no
+ *             data and data is outstanding)
  *
  * Returned Value:
- *   The value of the TCP receive window to use.
+ *   True if the first unacknowledged segment should be retransmitted
+ *   now.
+ *
+ * Assumptions:
+ *   The network is locked.
+ *
+ ****************************************************************************/
+
+bool tcp_cc_ack(FAR struct tcp_conn_s *conn, uint32_t ackno, bool dupcand);
+
+/****************************************************************************
+ * Name: tcp_cc_timeout
+ *
+ * Description:
+ *   Collapse the congestion window after a retransmission timeout.
+ *
+ * Assumptions:
+ *   The network is locked.
+ *
+ ****************************************************************************/
+
+void tcp_cc_timeout(FAR struct tcp_conn_s *conn);
+
+/****************************************************************************
+ * Name: tcp_cc_rttstart
+ *
+ * Description:
+ *   Start timing a newly sent segment that ends at 'seqno', unless a
+ *   segment is already being timed.
+ *
+ ****************************************************************************/
+
+void tcp_cc_rttstart(FAR struct tcp_conn_s *conn, uint32_t seqno);
+
+/****************************************************************************
+ * Name: tcp_cc_rttsample
+ *
+ * Description:
+ *   Complete the RTT sample if 'ackno' covers the timed segment and update
+ *   SRTT, RTTVAR and the retransmission time-out (RFC 6298).
+ *
+ * Assumptions:
+ *   The network is locked.
  *
  ****************************************************************************/
 
-uint16_t tcp_get_recvwindow(FAR struct net_driver_s *dev);
+void tcp_cc_rttsample(FAR struct tcp_conn_s *conn, uint32_t ackno);
+
+/* Karn's algorithm: never time a segment that has been retransmitted */
+
+#  define tcp_cc_rttcancel(conn) do { (conn)->rttpend = false; } while (0)
+
+/* The built-in congestion control algorithms */
+
+#ifdef CONFIG_NET_TCP_CC_NEWRENO
+EXTERN const struct tcp_cc_ops_s g_tcp_cc_newreno;
+#endif
+#ifdef CONFIG_NET_TCP_CC_CUBIC
+EXTERN const struct tcp_cc_ops_s g_tcp_cc_cubic;
+#endif
+#endif /* CONFIG_NET_TCP_CC */
 
 /****************************************************************************
  * Name: psock_tcp_cansend
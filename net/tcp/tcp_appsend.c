@@ -159,7 +159,7 @@ void tcp_appsend(FAR struct net_driver_s *dev, FAR struct tcp_conn_s *conn,
   else
     {
 #ifdef CONFIG_NET_TCP_WRITE_BUFFERS
-      DEBUGASSERT(dev->d_sndlen <= conn->mss);
+      DEBUGASSERT(dev->d_sndlen <= TCP_SNDMSS(dev, conn));
 #else
       /* If d_sndlen > 0, the application has data to be sent. */
 
@@ -178,7 +178,7 @@ void tcp_appsend(FAR struct net_driver_s *dev, FAR struct tcp_conn_s *conn,
            * MSS (the minumum of the MSS and the available window).
            */
 
-          DEBUGASSERT(dev->d_sndlen <= conn->mss);
+          DEBUGASSERT(dev->d_sndlen <= TCP_SNDMSS(dev, conn));
         }
 
       conn->nrtx = 0;
@@ -254,6 +254,7 @@ void tcp_rexmit(FAR struct net_driver_s *dev, FAR struct tcp_conn_s *conn,
        * the IP and TCP headers.
        */
 
+      TCP_CONNSTATS(conn, txbytes, dev->d_sndlen);
       tcp_send(dev, conn, TCP_ACK | TCP_PSH, dev->d_sndlen + hdrlen);
     }
 
@@ -0,0 +1,410 @@
+/****************************************************************************
+ * net/tcp/tcp_cc.c
+ *
+ *   Copyright (C) 2020 Gregory Nutt. All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in
+ *    the documentation and/or other materials provided with the
+ *    distribution.
+ * 3. Neither the name NuttX nor the names of its contributors may be
+ *    used to endorse or promote products derived from this software
+ *    without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+ * FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE
+ * COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+ * INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,
+ * BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS
+ * OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED
+ * AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ * LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN
+ * ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ *
+ ****************************************************************************/
+
+/****************************************************************************
+ * Included Files
+ ****************************************************************************/
+
+#include <nuttx/config.h>
+
+#include <stdint.h>
+#include <stdbool.h>
+#include <debug.h>
+
+#include <nuttx/clock.h>
+#include <nuttx/net/netconfig.h>
+#include <nuttx/net/tcp.h>
+
+#include "tcp/tcp.h"
+
+#ifdef CONFIG_NET_TCP_CC
+
+/****************************************************************************
+ * Pre-processor Definitions
+ ****************************************************************************/
+
+/* The number of duplicate ACKs that triggers fast retransmit */
+
+#define TCP_DUPACK_THRESH 3
+
+/* The initial window (RFC 6928): min(10*MSS, max(2*MSS, 14600)) */
+
+#define TCP_INITIAL_CWND(mss) \
+  MIN(10 * (uint32_t)(mss), MAX(2 * (uint32_t)(mss), 14600))
+
+/* The largest congestion window that is useful: the largest window that
+ * the peer could ever advertise.
+ */
+
+#define TCP_MAX_CWND ((uint32_t)UINT16_MAX << TCP_WS_MAXSHIFT)
+
+/* Bounds on the retransmission time-out in half-second timer units.  RFC
+ * 6298 recommends a minimum of one second.
+ */
+
+#define TCP_RTO_MIN       2
+#define TCP_RTO_MAX       120
+
+/* Sequence number comparisons that survive wrap-around */
+
+#define TCP_SEQ_LT(a,b)   ((int32_t)((a) - (b)) < 0)
+#define TCP_SEQ_GT(a,b)   ((int32_t)((a) - (b)) > 0)
+
+/* The algorithm that new connections use */
+
+#if defined(CONFIG_NET_TCP_CC_CUBIC)
+#  define TCP_CC_DEFAULT  (&g_tcp_cc_cubic)
+#else
+#  define TCP_CC_DEFAULT  (&g_tcp_cc_newreno)
+#endif
+
+/****************************************************************************
+ * Public Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: tcp_cc_init
+ *
+ * Description:
+ *   Open the congestion window of a connection that is about to send its
+ *   first data, using the configured congestion control algorithm.
+ *
+ * Input Parameters:
+ *   conn - The TCP connection
+ *
+ * Returned Value:
+ *   None
+ *
+ * Assumptions:
+ *   The network is locked.
+ *
+ ****************************************************************************/
+
+void tcp_cc_init(FAR struct tcp_conn_s *conn)
+{
+  conn->cc       = TCP_CC_DEFAULT;
+  conn->cwnd     = TCP_INITIAL_CWND(conn->mss);
+  conn->ssthresh = UINT32_MAX;
+  conn->dupacks  = 0;
+  conn->recovery = false;
+
+  /* Nothing is in flight yet */
+
+  conn->lastack  = tcp_getsequence(conn->sndseq);
+  conn->recover  = conn->lastack;
+
+  if (conn->cc->init != NULL)
+    {
+      conn->cc->init(conn);
+    }
+
+  ninfo("%s: cwnd=%u\n", conn->cc->name, conn->cwnd);
+}
+
+/****************************************************************************
+ * Name: tcp_cc_sndwnd
+ *
+ * Description:
+ *   Return the number of bytes that may be in flight, the smaller of the
+ *   congestion window and the peer's receive window.
+ *
+ ****************************************************************************/
+
+uint32_t tcp_cc_sndwnd(FAR struct tcp_conn_s *conn)
+{
+  return MIN(conn->cwnd, (uint32_t)conn->winsize);
+}
+
+/****************************************************************************
+ * Name: tcp_cc_ack
+ *
+ * Description:
+ *   Account for an incoming ACK.  New data ACKs grow the congestion window.
+ *   Duplicate ACKs are counted and the third one enters fast recovery
+ *   (RFC 5681 and RFC 6582).
+ *
+ * Input Parameters:
+ *   conn    - The TCP connection
+ *   ackno   - The cumulative ACK number in the segment
+ *   dupcand - True if the segment could be a duplicate ACK (it carries no
+ *             data and data is outstanding)
+ *
+ * Returned Value:
+ *   True if the first unacknowledged segment should be retransmitted
+ *   now.
+ *
+ * Assumptions:
+ *   The network is locked.
+ *
+ ****************************************************************************/
+
+bool tcp_cc_ack(FAR struct tcp_conn_s *conn, uint32_t ackno, bool dupcand)
+{
+  uint32_t acked;
+
+  if (conn->cc == NULL)
+    {
+      return false;
+    }
+
+  if (ackno == conn->lastack)
+    {
+      if (!dupcand)
+        {
+          return false;
+        }
+
+      if (conn->dupacks < UINT8_MAX)
+        {
+          conn->dupacks++;
+        }
+
+      if (conn->recovery)
+        {
+          /* Each further duplicate ACK means that another segment has left
+           * the network.  Inflate the window so that new data can follow.
+           */
+
+          conn->cwnd += conn->mss;
+          return false;
+        }
+
+      /* Enter fast recovery on the third duplicate ACK, but only once per
+       * window of data (RFC 6582, 3.2 step 2).
+       */
+
+      if (conn->dupacks == TCP_DUPACK_THRESH &&
+          !TCP_SEQ_LT(ackno, conn->recover))
+        {
+          conn->ssthresh = conn->cc->ssthresh(conn);
+          conn->cwnd     = conn->ssthresh + TCP_DUPACK_THRESH * conn->mss;
+          conn->recover  = conn->sndseq_max;
+          conn->recovery = true;
+
+          ninfo("Fast retransmit: ackno=%u cwnd=%u ssthresh=%u\n",
+                ackno, conn->cwnd, conn->ssthresh);
+
+          tcp_cc_rttcancel(conn);
+          return true;
+        }
+
+      return false;
+    }
+
+  /* Ignore old, re-ordered ACKs */
+
+  if (!TCP_SEQ_GT(ackno, conn->lastack))
+    {
+      return false;
+    }
+
+  acked          = ackno - conn->lastack;
+  conn->lastack  = ackno;
+  conn->dupacks  = 0;
+
+  /* New data has been ACKed so the retransmission back-off is over */
+
+  conn->nrtx     = 0;
+
+  if (conn->recovery)
+    {
+      if (!TCP_SEQ_LT(ackno, conn->recover))
+        {
+          /* A full ACK.  Deflate the window and leave fast recovery. */
+
+          conn->cwnd     = conn->ssthresh;
+          conn->recovery = false;
+          return false;
+        }
+
+      /* A partial ACK.  The next segment was lost too; retransmit it.
+       * Deflate the window by the amount ACKed and add back one MSS
+       * (RFC 6582, 3.2 step 5).
+       */
+
+      conn->cwnd = conn->cwnd > acked ? conn->cwnd - acked : 0;
+      if (acked >= conn->mss)
+        {
+          conn->cwnd += conn->mss;
+        }
+
+      return true;
+    }
+
+  conn->cc->cong_avoid(conn, acked);
+  if (conn->cwnd > TCP_MAX_CWND)
+    {
+      conn->cwnd = TCP_MAX_CWND;
+    }
+
+  return false;
+}
+
+/****************************************************************************
+ * Name: tcp_cc_timeout
+ *
+ * Description:
+ *   Collapse the congestion window after a retransmission timeout.
+ *
+ * Assumptions:
+ *   The network is locked.
+ *
+ ****************************************************************************/
+
+void tcp_cc_timeout(FAR struct tcp_conn_s *conn)
+{
+  if (conn->cc == NULL)
+    {
+      return;
+    }
+
+  /* RFC 5681, 3.1: ssthresh from the flight size, the loss window is one
+   * segment.
+   */
+
+  conn->ssthresh = conn->cc->ssthresh(conn);
+  conn->cwnd     = conn->mss;
+  conn->dupacks  = 0;
+  conn->recovery = false;
+  conn->recover  = conn->sndseq_max;
+
+  tcp_cc_rttcancel(conn);
+
+  ninfo("RTO: cwnd=%u ssthresh=%u\n", conn->cwnd, conn->ssthresh);
+}
+
+/****************************************************************************
+ * Name: tcp_cc_rttstart
+ *
+ * Description:
+ *   Start timing a newly sent segment that ends at 'seqno', unless a
+ *   segment is already being timed.
+ *
+ ****************************************************************************/
+
+void tcp_cc_rttstart(FAR struct tcp_conn_s *conn, uint32_t seqno)
+{
+  if (!conn->rttpend)
+    {
+      conn->rttpend = true;
+      conn->rttseq  = seqno;
+      conn->rtttime = clock_systimer();
+    }
+}
+
+/****************************************************************************
+ * Name: tcp_cc_rttsample
+ *
+ * Description:
+ *   Complete the RTT sample if 'ackno' covers the timed segment and update
+ *   SRTT, RTTVAR and the retransmission time-out (RFC 6298).
+ *
+ * Assumptions:
+ *   The network is locked.
+ *
+ ****************************************************************************/
+
+void tcp_cc_rttsample(FAR struct tcp_conn_s *conn, uint32_t ackno)
+{
+  uint32_t rtt;
+  uint32_t rto;
+  int32_t err;
+
+  if (!conn->rttpend || TCP_SEQ_LT(ackno, conn->rttseq))
+    {
+      return;
+    }
+
+  conn->rttpend = false;
+
+  /* The sample, in clock ticks.  A sample of zero ticks is counted as one
+   * tick, the resolution of the clock.
+   */
+
+  rtt = (uint32_t)(clock_systimer() - conn->rtttime);
+  if (rtt == 0)
+    {
+      rtt = 1;
+    }
+
+  if (conn->srtt == 0)
+    {
+      /* The first sample:  SRTT = R, RTTVAR = R/2 */
+
+      conn->srtt   = rtt << 3;
+      conn->rttvar = rtt << 1;
+    }
+  else
+    {
+      /* RTTVAR = 3/4 RTTVAR + 1/4 |SRTT - R|
+       * SRTT   = 7/8 SRTT + 1/8 R
+       *
+       * srtt is kept scaled by 8 and rttvar by 4, so this is just adding
+       * the error terms.
+       */
+
+      err         = (int32_t)rtt - (int32_t)(conn->srtt >> 3);
+      conn->srtt += err;
+
+      if (err < 0)
+        {
+          err = -err;
+        }
+
+      conn->rttvar += err - (int32_t)(conn->rttvar >> 2);
+    }
+
+  /* RTO = SRTT + max(G, 4 * RTTVAR), converted to half-seconds (rounded
+   * up) and kept within the RFC 6298 bounds.
+   */
+
+  rto = (conn->srtt >> 3) + MAX(conn->rttvar, 1);
+  rto = (rto + TICK_PER_HSEC - 1) / TICK_PER_HSEC;
+
+  if (rto < TCP_RTO_MIN)
+    {
+      rto = TCP_RTO_MIN;
+    }
+  else if (rto > TCP_RTO_MAX)
+    {
+      rto = TCP_RTO_MAX;
+    }
+
+  conn->rto = rto;
+
+  ninfo("RTT: rtt=%u srtt=%u rttvar=%u rto=%u\n",
+        rtt, conn->srtt >> 3, conn->rttvar >> 2, rto);
+}
+
+#endif /* CONFIG_NET_TCP_CC */
@@ -0,0 +1,253 @@
+/****************************************************************************
+ * net/tcp/tcp_cc_cubic.c
+ *
+ *   Copyright (C) 2020 Gregory Nutt. All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in
+ *    the documentation and/or other materials provided with the
+ *    distribution.
+ * 3. Neither the name NuttX nor the names of its contributors may be
+ *    used to endorse or promote products derived from this software
+ *    without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+ * FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE
+ * COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+ * INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,
+ * BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS
+ * OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED
+ * AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ * LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN
+ * ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ *
+ ****************************************************************************/
+
+/****************************************************************************
+ * Included Files
+ ****************************************************************************/
+
+#include <nuttx/config.h>
+
+#include <stdint.h>
+
+#include <nuttx/clock.h>
+#include <nuttx/net/netconfig.h>
+
+#include "tcp/tcp.h"
+
+#ifdef CONFIG_NET_TCP_CC_CUBIC
+
+/****************************************************************************
+ * Pre-processor Definitions
+ ****************************************************************************/
+
+/* The multiplicative decrease factor, beta = 0.7 (RFC 8312, 4.5) */
+
+#define CUBIC_BETA_NUM    7
+#define CUBIC_BETA_DEN    10
+
+/* The scaling constant C = 0.4 (RFC 8312, 5) */
+
+#define CUBIC_C_NUM       4
+#define CUBIC_C_DEN       10
+
+/* Clamp |t - K| so that the cube cannot overflow.  The window is far past
+ * any useful size long before this.
+ */
+
+#define CUBIC_MAX_MSEC    30000
+
+/****************************************************************************
+ * Private Function Prototypes
+ ****************************************************************************/
+
+static void cubic_init(FAR struct tcp_conn_s *conn);
+static void cubic_cong_avoid(FAR struct tcp_conn_s *conn, uint32_t acked);
+static uint32_t cubic_ssthresh(FAR struct tcp_conn_s *conn);
+
+/****************************************************************************
+ * Public Data
+ ****************************************************************************/
+
+const struct tcp_cc_ops_s g_tcp_cc_cubic =
+{
+  "cubic",             /* name */
+  cubic_init,          /* init */
+  cubic_cong_avoid,    /* cong_avoid */
+  cubic_ssthresh       /* ssthresh */
+};
+
+/****************************************************************************
+ * Private Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: cubic_cbrt
+ *
+ * Description:
+ *   Integer cube root, rounded down.
+ *
+ ****************************************************************************/
+
+static uint32_t cubic_cbrt(uint64_t x)
+{
+  uint64_t root = 0;
+  uint64_t b;
+  int shift;
+
+  for (shift = 63; shift >= 0; shift -= 3)
+    {
+      root <<= 1;
+      b = 3 * root * (root + 1) + 1;
+      if ((x >> shift) >= b)
+        {
+          x -= b << shift;
+          root++;
+        }
+    }
+
+  return (uint32_t)root;
+}
+
+/****************************************************************************
+ * Name: cubic_init
+ ****************************************************************************/
+
+static void cubic_init(FAR struct tcp_conn_s *conn)
+{
+  conn->wmax  = 0;
+  conn->epoch = 0;
+  conn->kmsec = 0;
+}
+
+/****************************************************************************
+ * Name: cubic_cong_avoid
+ *
+ * Description:
+ *   Slow start below ssthresh.  Above it, grow toward the cubic function
+ *   W(t) = C * (t - K)^3 + Wmax, or toward the window that standard TCP
+ *   would have reached if that is larger (RFC 8312, 4.2).
+ *
+ ****************************************************************************/
+
+static void cubic_cong_avoid(FAR struct tcp_conn_s *conn, uint32_t acked)
+{
+  uint32_t mss = conn->mss;
+  uint32_t rttmsec;
+  uint32_t tmsec;
+  uint64_t target;
+  uint64_t west;
+  int64_t offset;
+  int32_t dmsec;
+  clock_t now;
+
+  if (conn->cwnd < conn->ssthresh)
+    {
+      conn->cwnd += MIN(acked, mss);
+      return;
+    }
+
+  now = clock_systimer();
+  rttmsec = TICK2MSEC(conn->srtt >> 3);
+
+  if (conn->epoch == 0)
+    {
+      /* A new congestion avoidance epoch.  K is the time to grow back to
+       * Wmax:  K = cbrt((Wmax - cwnd) / C) with the window in segments.
+       * In milliseconds that is cbrt((Wmax - cwnd) / mss * 10^9 / C).
+       */
+
+      conn->epoch = now != 0 ? now : 1;
+      if (conn->cwnd < conn->wmax)
+        {
+          conn->kmsec = cubic_cbrt((uint64_t)(conn->wmax - conn->cwnd) *
+                                   1000000000ull * CUBIC_C_DEN /
+                                   (CUBIC_C_NUM * mss));
+        }
+      else
+        {
+          conn->kmsec = 0;
+          conn->wmax  = conn->cwnd;
+        }
+    }
+
+  /* Evaluate W(t + RTT), where t is the time since the epoch began */
+
+  tmsec = TICK2MSEC(now - conn->epoch) + rttmsec;
+  dmsec = (int32_t)tmsec - (int32_t)conn->kmsec;
+  dmsec = MAX(MIN(dmsec, CUBIC_MAX_MSEC), -CUBIC_MAX_MSEC);
+
+  offset = (int64_t)dmsec * dmsec * dmsec * CUBIC_C_NUM * mss /
+           (CUBIC_C_DEN * 1000000000ll);
+  target = (int64_t)conn->wmax + offset > 0 ?
+           (uint64_t)((int64_t)conn->wmax + offset) : 0;
+
+  /* The TCP-friendly window that AIMD with the same beta would have:
+   * Wmax * beta + 3 * (1 - beta) / (1 + beta) * t / RTT segments.
+   */
+
+  if (rttmsec > 0)
+    {
+      west = (uint64_t)conn->wmax * CUBIC_BETA_NUM / CUBIC_BETA_DEN +
+             (uint64_t)3 * (CUBIC_BETA_DEN - CUBIC_BETA_NUM) * mss *
+             tmsec / ((CUBIC_BETA_DEN + CUBIC_BETA_NUM) * rttmsec);
+      if (west > target)
+        {
+          target = west;
+        }
+    }
+
+  /* Do not grow by more than half of the window per round trip */
+
+  target = MIN(target, (uint64_t)conn->cwnd + conn->cwnd / 2);
+
+  if (target > conn->cwnd)
+    {
+      conn->cwnd += (uint32_t)((target - conn->cwnd) * MIN(acked, mss) /
+                               conn->cwnd);
+    }
+  else
+    {
+      /* Very slow growth while at the plateau around Wmax */
+
+      conn->cwnd += MAX(mss * MIN(acked, mss) / (100 * conn->cwnd), 1);
+    }
+}
+
+/****************************************************************************
+ * Name: cubic_ssthresh
+ *
+ * Description:
+ *   Remember the window at the loss (reduced further if it did not grow
+ *   back to the previous Wmax, for fast convergence) and reduce it by beta.
+ *
+ ****************************************************************************/
+
+static uint32_t cubic_ssthresh(FAR struct tcp_conn_s *conn)
+{
+  if (conn->cwnd < conn->wmax)
+    {
+      conn->wmax = conn->cwnd / 20 * (CUBIC_BETA_DEN + CUBIC_BETA_NUM);
+    }
+  else
+    {
+      conn->wmax = conn->cwnd;
+    }
+
+  conn->epoch = 0;
+
+  return MAX(conn->cwnd / CUBIC_BETA_DEN * CUBIC_BETA_NUM,
+             2 * conn->mss);
+}
+
+#endif /* CONFIG_NET_TCP_CC_CUBIC */
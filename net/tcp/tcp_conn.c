@@ -44,6 +44,7 @@
 #include <nuttx/config.h>
 #if defined(CONFIG_NET) && defined(CONFIG_NET_TCP)
 
+#include <stddef.h>
 #include <stdint.h>
 #include <string.h>
 #include <assert.h>
@@ -54,7 +55,9 @@
 
 #include <arch/irq.h>
 
+#include <nuttx/nuttx.h>
 #include <nuttx/clock.h>
+#include <nuttx/semaphore.h>
 #include <nuttx/net/netconfig.h>
 #include <nuttx/net/net.h>
 #include <nuttx/net/netdev.h>
@@ -72,6 +75,16 @@
 #define IPv4BUF ((struct ipv4_hdr_s *)&dev->d_buf[NET_LL_HDRLEN(dev)])
 #define IPv6BUF ((struct ipv6_hdr_s *)&dev->d_buf[NET_LL_HDRLEN(dev)])
 
+/* Walk the candidates for an incoming segment: either one hash chain or
+ * the whole active list.
+ */
+
+#ifdef CONFIG_NET_TCP_HASH
+#  define TCP_ACTIVE_NEXT(c) ((c)->hnext)
+#else
+#  define TCP_ACTIVE_NEXT(c) ((FAR struct tcp_conn_s *)(c)->node.flink)
+#endif
+
 /****************************************************************************
  * Private Data
  ****************************************************************************/
@@ -88,14 +101,234 @@ static dq_queue_t g_free_tcp_connections;
 
 static dq_queue_t g_active_tcp_connections;
 
+/* The connections in TIME_WAIT, oldest first */
+
+static dq_queue_t g_tcp_timewait;
+
 /* Last port used by a TCP connection connection. */
 
 static uint16_t g_last_tcp_port;
 
+#ifdef CONFIG_NET_TCP_HASH
+/* Active connections hashed on (lport, rport, raddr) */
+
+static FAR struct tcp_conn_s *g_tcp_active_hash[CONFIG_NET_TCP_HASHSIZE];
+
+/* Connections with a local port, hashed on lport */
+
+static FAR struct tcp_conn_s *g_tcp_port_hash[CONFIG_NET_TCP_HASHSIZE];
+#endif
+
 /****************************************************************************
  * Private Functions
  ****************************************************************************/
 
+/****************************************************************************
+ * Name: tcp_hashkey
+ *
+ * Description:
+ *   Hash the fields of an incoming segment that must match an active
+ *   connection exactly.  The local address is not used because a
+ *   connection bound to INADDR_ANY matches any destination address.
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_NET_TCP_HASH
+static unsigned int tcp_hashkey(uint16_t lport, uint16_t rport,
+                                   uint32_t raddr)
+{
+  uint32_t key = (((uint32_t)lport << 16) | rport) ^ raddr;
+
+  key ^= key >> 16;
+  key ^= key >> 8;
+  return key % CONFIG_NET_TCP_HASHSIZE;
+}
+
+/****************************************************************************
+ * Name: tcp_ipv6_fold
+ *
+ * Description:
+ *   Fold an IPv6 address into 32 bits for tcp_hashkey().
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_NET_IPv6
+static uint32_t tcp_ipv6_fold(FAR const uint16_t *addr)
+{
+  uint32_t fold = 0;
+  int i;
+
+  for (i = 0; i < 8; i += 2)
+    {
+      fold ^= ((uint32_t)addr[i] << 16) | addr[i + 1];
+    }
+
+  return fold;
+}
+#endif
+
+/****************************************************************************
+ * Name: tcp_connhash
+ *
+ * Description:
+ *   Return the active hash bucket of a connection.
+ *
+ ****************************************************************************/
+
+static unsigned int tcp_connhash(FAR struct tcp_conn_s *conn)
+{
+#ifdef CONFIG_NET_IPv4
+#ifdef CONFIG_NET_IPv6
+  if (conn->domain == PF_INET)
+#endif
+    {
+      return tcp_hashkey(conn->lport, conn->rport, conn->u.ipv4.raddr);
+    }
+#endif /* CONFIG_NET_IPv4 */
+
+#ifdef CONFIG_NET_IPv6
+#ifdef CONFIG_NET_IPv4
+  else
+#endif
+    {
+      return tcp_hashkey(conn->lport, conn->rport,
+                            tcp_ipv6_fold(conn->u.ipv6.raddr));
+    }
+#endif /* CONFIG_NET_IPv6 */
+}
+
+/****************************************************************************
+ * Name: tcp_hash_insert and tcp_hash_remove
+ *
+ * Description:
+ *   Add a connection at the tail of a hash chain, or remove it.  New
+ *   entries go at the tail so that each chain keeps the same order as the
+ *   list that it replaces.
+ *
+ ****************************************************************************/
+
+static void tcp_hash_insert(FAR struct tcp_conn_s **head,
+                            FAR struct tcp_conn_s *conn, size_t linkoff)
+{
+  FAR struct tcp_conn_s **link = head;
+
+  while (*link != NULL)
+    {
+      link = (FAR struct tcp_conn_s **)((FAR uint8_t *)*link + linkoff);
+    }
+
+  *link = conn;
+  *(FAR struct tcp_conn_s **)((FAR uint8_t *)conn + linkoff) = NULL;
+}
+
+static void tcp_hash_remove(FAR struct tcp_conn_s **head,
+                            FAR struct tcp_conn_s *conn, size_t linkoff)
+{
+  FAR struct tcp_conn_s **link = head;
+
+  while (*link != NULL)
+    {
+      if (*link == conn)
+        {
+          *link = *(FAR struct tcp_conn_s **)((FAR uint8_t *)conn + linkoff);
+          return;
+        }
+
+      link = (FAR struct tcp_conn_s **)((FAR uint8_t *)*link + linkoff);
+    }
+}
+
+/****************************************************************************
+ * Name: tcp_active_hash and tcp_active_unhash
+ *
+ * Description:
+ *   Add a connection to, or remove it from, its active hash chain.
+ *
+ ****************************************************************************/
+
+static void tcp_active_hash(FAR struct tcp_conn_s *conn)
+{
+  tcp_hash_insert(&g_tcp_active_hash[tcp_connhash(conn)], conn,
+                  offsetof(struct tcp_conn_s, hnext));
+  conn->hashed = true;
+}
+
+static void tcp_active_unhash(FAR struct tcp_conn_s *conn)
+{
+  tcp_hash_remove(&g_tcp_active_hash[tcp_connhash(conn)], conn,
+                  offsetof(struct tcp_conn_s, hnext));
+  conn->hashed = false;
+}
+
+/****************************************************************************
+ * Name: tcp_active_add and tcp_active_remove
+ *
+ * Description:
+ *   Add a connection to, or remove it from, the active list and its hash
+ *   chain.
+ *
+ ****************************************************************************/
+
+static void tcp_active_add(FAR struct tcp_conn_s *conn)
+{
+  dq_addlast(&conn->node, &g_active_tcp_connections);
+  tcp_active_hash(conn);
+}
+
+static void tcp_active_remove(FAR struct tcp_conn_s *conn)
+{
+  dq_rem(&conn->node, &g_active_tcp_connections);
+  tcp_active_unhash(conn);
+}
+#else
+#  define tcp_active_add(c)    dq_addlast(&(c)->node, &g_active_tcp_connections)
+#  define tcp_active_remove(c) dq_rem(&(c)->node, &g_active_tcp_connections)
+#endif /* CONFIG_NET_TCP_HASH */
+
+/****************************************************************************
+ * Name: tcp_setlport
+ *
+ * Description:
+ *   Set (or clear, if zero) the local port of a connection, keeping the
+ *   local port hash chain in sync.  lport must only be changed here.
+ *
+ ****************************************************************************/
+
+static void tcp_setlport(FAR struct tcp_conn_s *conn, uint16_t lport)
+{
+#ifdef CONFIG_NET_TCP_HASH
+  bool hashed = conn->hashed;
+
+  /* The active hash also depends on lport (bind() of an active socket) */
+
+  if (hashed)
+    {
+      tcp_active_unhash(conn);
+    }
+
+  if (conn->lport != 0)
+    {
+      tcp_hash_remove(&g_tcp_port_hash[TCP_PORTHASH(conn->lport)], conn,
+                      offsetof(struct tcp_conn_s, pnext));
+    }
+#endif
+
+  conn->lport = lport;
+
+#ifdef CONFIG_NET_TCP_HASH
+  if (lport != 0)
+    {
+      tcp_hash_insert(&g_tcp_port_hash[TCP_PORTHASH(lport)], conn,
+                      offsetof(struct tcp_conn_s, pnext));
+    }
+
+  if (hashed)
+    {
+      tcp_active_hash(conn);
+    }
+#endif
+}
+
 /****************************************************************************
  * Name: tcp_ipv4_listener
  *
@@ -113,13 +346,21 @@ static inline FAR struct tcp_conn_s *tcp_ipv4_listener(in_addr_t ipaddr,
                                                        uint16_t portno)
 {
   FAR struct tcp_conn_s *conn;
+#ifndef CONFIG_NET_TCP_HASH
   int i;
+#endif
 
   /* Check if this port number is in use by any active UIP TCP connection */
 
+#ifdef CONFIG_NET_TCP_HASH
+  for (conn = g_tcp_port_hash[TCP_PORTHASH(portno)]; conn != NULL;
+       conn = conn->pnext)
+    {
+#else
   for (i = 0; i < CONFIG_NET_TCP_CONNS; i++)
     {
       conn = &g_tcp_connections[i];
+#endif
 
       /* Check if this connection is open and the local port assignment
        * matches the requested port number.
@@ -164,13 +405,21 @@ static inline FAR struct tcp_conn_s *
 tcp_ipv6_listener(const net_ipv6addr_t ipaddr, uint16_t portno)
 {
   FAR struct tcp_conn_s *conn;
+#ifndef CONFIG_NET_TCP_HASH
   int i;
+#endif
 
   /* Check if this port number is in use by any active UIP TCP connection */
 
+#ifdef CONFIG_NET_TCP_HASH
+  for (conn = g_tcp_port_hash[TCP_PORTHASH(portno)]; conn != NULL;
+       conn = conn->pnext)
+    {
+#else
   for (i = 0; i < CONFIG_NET_TCP_CONNS; i++)
     {
       conn = &g_tcp_connections[i];
+#endif
 
       /* Check if this connection is open and the local port assignment
        * matches the requested port number.
@@ -327,9 +576,14 @@ static inline FAR struct tcp_conn_s *
   in_addr_t srcipaddr;
   in_addr_t destipaddr;
 
-  conn       = (FAR struct tcp_conn_s *)g_active_tcp_connections.head;
   srcipaddr  = net_ip4addr_conv32(ip->srcipaddr);
   destipaddr = net_ip4addr_conv32(ip->destipaddr);
+#ifdef CONFIG_NET_TCP_HASH
+  conn       = g_tcp_active_hash[tcp_hashkey(tcp->destport,
+                                             tcp->srcport, srcipaddr)];
+#else
+  conn       = (FAR struct tcp_conn_s *)g_active_tcp_connections.head;
+#endif
 
   while (conn)
     {
@@ -364,9 +618,9 @@ static inline FAR struct tcp_conn_s *
           break;
         }
 
-      /* Look at the next active connection */
+      /* Look at the next candidate connection */
 
-      conn = (FAR struct tcp_conn_s *)conn->node.flink;
+      conn = TCP_ACTIVE_NEXT(conn);
     }
 
   return conn;
@@ -394,9 +648,15 @@ static inline FAR struct tcp_conn_s *
   net_ipv6addr_t *srcipaddr;
   net_ipv6addr_t *destipaddr;
 
-  conn       = (FAR struct tcp_conn_s *)g_active_tcp_connections.head;
   srcipaddr  = (net_ipv6addr_t *)ip->srcipaddr;
   destipaddr = (net_ipv6addr_t *)ip->destipaddr;
+#ifdef CONFIG_NET_TCP_HASH
+  conn       = g_tcp_active_hash[tcp_hashkey(tcp->destport,
+                                             tcp->srcport,
+                                             tcp_ipv6_fold(*srcipaddr))];
+#else
+  conn       = (FAR struct tcp_conn_s *)g_active_tcp_connections.head;
+#endif
 
   while (conn)
     {
@@ -431,9 +691,9 @@ static inline FAR struct tcp_conn_s *
           break;
         }
 
-      /* Look at the next active connection */
+      /* Look at the next candidate connection */
 
-      conn = (FAR struct tcp_conn_s *)conn->node.flink;
+      conn = TCP_ACTIVE_NEXT(conn);
     }
 
   return conn;
@@ -479,7 +739,7 @@ static inline int tcp_ipv4_bind(FAR struct tcp_conn_s *conn,
 
   /* Save the local address in the connection structure (network byte order). */
 
-  conn->lport = htons(port);
+  tcp_setlport(conn, htons(port));
   net_ipv4addr_copy(conn->u.ipv4.laddr, addr->sin_addr.s_addr);
 
   /* Find the device that can receive packets on the network associated with
@@ -495,7 +755,7 @@ static inline int tcp_ipv4_bind(FAR struct tcp_conn_s *conn,
 
       /* Back out the local address setting */
 
-      conn->lport = 0;
+      tcp_setlport(conn, 0);
       net_ipv4addr_copy(conn->u.ipv4.laddr, INADDR_ANY);
       return ret;
     }
@@ -546,7 +806,7 @@ static inline int tcp_ipv6_bind(FAR struct tcp_conn_s *conn,
 
   /* Save the local address in the connection structure (network byte order). */
 
-  conn->lport = htons(port);
+  tcp_setlport(conn, htons(port));
   net_ipv6addr_copy(conn->u.ipv6.laddr, addr->sin6_addr.in6_u.u6_addr16);
 
   /* Find the device that can receive packets on the network
@@ -562,7 +822,7 @@ static inline int tcp_ipv6_bind(FAR struct tcp_conn_s *conn,
 
       /* Back out the local address setting */
 
-      conn->lport = 0;
+      tcp_setlport(conn, 0);
       net_ipv6addr_copy(conn->u.ipv6.laddr, g_ipv6_unspecaddr);
       return ret;
     }
@@ -593,6 +853,7 @@ void tcp_initialize(void)
 
   dq_init(&g_free_tcp_connections);
   dq_init(&g_active_tcp_connections);
+  dq_init(&g_tcp_timewait);
 
   /* Now initialize each connection structure */
 
@@ -605,6 +866,11 @@ void tcp_initialize(void)
     }
 
   g_last_tcp_port = 1024;
+
+#ifdef CONFIG_NET_TCP_HASH
+  memset(g_tcp_active_hash, 0, sizeof(g_tcp_active_hash));
+  memset(g_tcp_port_hash, 0, sizeof(g_tcp_port_hash));
+#endif
 }
 
 /****************************************************************************
@@ -638,14 +904,34 @@ FAR struct tcp_conn_s *tcp_alloc(uint8_t domain)
 
   if (!conn)
     {
-      /* As a fall-back, check for connection structures which can be stalled.
+      FAR struct tcp_conn_s *tmp;
+      FAR dq_entry_t *node;
+
+      /* As a fall-back, recycle the oldest connection in TIME_WAIT.  The
+       * queue may also hold connections whose TIME_WAIT has already timed
+       * out; those are just dropped from the queue.
+       */
+
+      while ((node = dq_remfirst(&g_tcp_timewait)) != NULL)
+        {
+          tmp = container_of(node, struct tcp_conn_s, twnode);
+          tmp->twqueued = false;
+
+          if (tmp->tcpstateflags == TCP_TIME_WAIT)
+            {
+              conn = tmp;
+              break;
+            }
+        }
+
+      /* Otherwise, check for connection structures which can be stalled.
        *
        * Search the active connection list for the oldest connection
        * that is about to be closed anyway.
        */
 
-      FAR struct tcp_conn_s *tmp =
-        (FAR struct tcp_conn_s *)g_active_tcp_connections.head;
+      tmp = conn != NULL ? NULL :
+            (FAR struct tcp_conn_s *)g_active_tcp_connections.head;
 
       while (tmp)
         {
@@ -723,6 +1009,10 @@ FAR struct tcp_conn_s *tcp_alloc(uint8_t domain)
       conn->keepidle      = 2 * DSEC_PER_HOUR;
       conn->keepintvl     = 2 * DSEC_PER_SEC;
       conn->keepcnt       = 3;
+#endif
+#if defined(CONFIG_NET_SOCKOPTS) && defined(CONFIG_NET_TCP_WRITE_BUFFERS)
+      nxsem_init(&conn->snd_sem, 0, 0);
+      nxsem_setprotocol(&conn->snd_sem, SEM_PRIO_NONE);
 #endif
     }
 
@@ -772,9 +1062,28 @@ void tcp_free(FAR struct tcp_conn_s *conn)
     {
       /* Remove the connection from the active list */
 
-      dq_rem(&conn->node, &g_active_tcp_connections);
+      tcp_active_remove(conn);
+
+      if (conn->twqueued)
+        {
+          dq_rem(&conn->twnode, &g_tcp_timewait);
+          conn->twqueued = false;
+        }
+
+      /* Make sure that it is no longer on a device "TX ready" queue */
+
+      tcp_txidle(conn);
     }
 
+#ifdef CONFIG_NET_TCP_HASH
+  /* Release the local port.  A listener on the hash chains must not
+   * outlive its connection either.
+   */
+
+  tcp_setlport(conn, 0);
+  tcp_unlisten(conn);
+#endif
+
 #ifdef CONFIG_NET_TCP_READAHEAD
   /* Release any read-ahead buffers attached to the connection */
 
@@ -795,6 +1104,10 @@ void tcp_free(FAR struct tcp_conn_s *conn)
     {
       tcp_wrbuffer_release(wrbuffer);
     }
+
+#ifdef CONFIG_NET_SOCKOPTS
+  nxsem_destroy(&conn->snd_sem);
+#endif
 #endif
 
 #ifdef CONFIG_NET_TCPBACKLOG
@@ -1003,8 +1316,8 @@ FAR struct tcp_conn_s *tcp_alloc_accept(FAR struct net_driver_s *dev,
       conn->sa            = 0;
       conn->sv            = 4;
       conn->nrtx          = 0;
-      conn->lport         = tcp->destport;
       conn->rport         = tcp->srcport;
+      tcp_setlport(conn, tcp->destport);
       conn->tcpstateflags = TCP_SYN_RCVD;
 
       tcp_initsequence(conn->sndseq);
@@ -1037,12 +1350,37 @@ FAR struct tcp_conn_s *tcp_alloc_accept(FAR struct net_driver_s *dev,
        * Interrupts should already be disabled in this context.
        */
 
-      dq_addlast(&conn->node, &g_active_tcp_connections);
+      tcp_active_add(conn);
     }
 
   return conn;
 }
 
+/****************************************************************************
+ * Name: tcp_timewait
+ *
+ * Description:
+ *   Move a connection into the TIME_WAIT state.  The connection is also
+ *   queued, oldest first, so that tcp_alloc() can recycle the oldest
+ *   TIME_WAIT connection without searching for it.
+ *
+ * Assumptions:
+ *   This function is called from network logic with the network locked.
+ *
+ ****************************************************************************/
+
+void tcp_timewait(FAR struct tcp_conn_s *conn)
+{
+  conn->tcpstateflags = TCP_TIME_WAIT;
+  conn->timer         = 0;
+
+  if (!conn->twqueued)
+    {
+      dq_addlast(&conn->twnode, &g_tcp_timewait);
+      conn->twqueued = true;
+    }
+}
+
 /****************************************************************************
  * Name: tcp_bind
  *
@@ -1249,7 +1587,7 @@ int tcp_connect(FAR struct tcp_conn_s *conn, FAR const struct sockaddr *addr)
   conn->rto        = TCP_RTO;
   conn->sa         = 0;
   conn->sv         = 16;   /* Initial value of the RTT variance. */
-  conn->lport      = htons((uint16_t)port);
+  tcp_setlport(conn, htons((uint16_t)port));
 #ifdef CONFIG_NET_TCP_WRITE_BUFFERS
   conn->expired    = 0;
   conn->isn        = 0;
@@ -1272,7 +1610,7 @@ int tcp_connect(FAR struct tcp_conn_s *conn, FAR const struct sockaddr *addr)
 
   /* And, finally, put the connection structure into the active list. */
 
-  dq_addlast(&conn->node, &g_active_tcp_connections);
+  tcp_active_add(conn);
   ret = OK;
 
 errout_with_lock:
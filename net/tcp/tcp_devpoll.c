@@ -131,4 +131,109 @@ void tcp_poll(FAR struct net_driver_s *dev, FAR struct tcp_conn_s *conn)
     }
 }
 
+/****************************************************************************
+ * Name: tcp_txready
+ *
+ * Description:
+ *   Put the connection on the "TX ready" queue of its device so that the
+ *   next devif_poll() on that device will poll it.
+ *
+ * Input Parameters:
+ *   conn - The TCP connection
+ *
+ * Returned Value:
+ *   None
+ *
+ * Assumptions:
+ *   Called from network stack logic with the network stack locked
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_NET_TCP_TXREADY
+void tcp_txready(FAR struct tcp_conn_s *conn)
+{
+  FAR struct net_driver_s *dev = conn->dev;
+
+  /* Already queued on the right device?  Connections that are not yet
+   * bound to a device have nothing to send; the TCP timer takes care of
+   * them.
+   */
+
+  if (conn->txdev == dev || dev == NULL)
+    {
+      return;
+    }
+
+  tcp_txidle(conn);
+  dq_addlast(&conn->txnode, &dev->d_tcptxq);
+  conn->txdev = dev;
+}
+
+/****************************************************************************
+ * Name: tcp_txidle
+ *
+ * Description:
+ *   Remove the connection from the "TX ready" queue, if it is on one.
+ *
+ * Input Parameters:
+ *   conn - The TCP connection
+ *
+ * Returned Value:
+ *   None
+ *
+ * Assumptions:
+ *   Called from network stack logic with the network stack locked
+ *
+ ****************************************************************************/
+
+void tcp_txidle(FAR struct tcp_conn_s *conn)
+{
+  if (conn->txdev != NULL)
+    {
+      dq_rem(&conn->txnode, &conn->txdev->d_tcptxq);
+      conn->txdev = NULL;
+    }
+}
+
+/****************************************************************************
+ * Name: tcp_txpending
+ *
+ * Description:
+ *   Return true if the connection may need further TX polls.
+ *
+ * Input Parameters:
+ *   conn - The TCP connection
+ *
+ * Returned Value:
+ *   True if the connection should stay on the "TX ready" queue.
+ *
+ * Assumptions:
+ *   Called from network stack logic with the network stack locked
+ *
+ ****************************************************************************/
+
+bool tcp_txpending(FAR struct tcp_conn_s *conn)
+{
+  /* Un-ACKed data means that an ACK is expected, after which the sender
+   * will usually want to be polled again.
+   */
+
+  if (conn->unacked > 0)
+    {
+      return true;
+    }
+
+#ifdef CONFIG_NET_TCP_WRITE_BUFFERS
+  /* Buffered write data that has not been sent yet */
+
+  if (!sq_empty(&conn->write_q))
+    {
+      return true;
+    }
+#endif
+
+  return false;
+}
+#endif /* CONFIG_NET_TCP_TXREADY */
+
 #endif /* CONFIG_NET && CONFIG_NET_TCP */
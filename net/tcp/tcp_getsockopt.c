@@ -97,8 +97,9 @@
 int tcp_getsockopt(FAR struct socket *psock, int option,
                    FAR void *value, FAR socklen_t *value_len)
 {
-#ifdef CONFIG_NET_TCP_KEEPALIVE
-  /* Keep alive options are the only TCP protocol socket option currently
+#if defined(CONFIG_NET_TCP_KEEPALIVE) || defined(CONFIG_NET_TCP_NAGLE)
+  /* Keep alive options and the options that control the coalescing of
+   * small segments are the only TCP protocol socket options currently
    * supported.
    */
 
@@ -124,6 +125,7 @@ int tcp_getsockopt(FAR struct socket *psock, int option,
 
   switch (option)
     {
+#ifdef CONFIG_NET_TCP_KEEPALIVE
       /* Handle the SO_KEEPALIVE socket-level option.
        *
        * NOTE: SO_KEEPALIVE is not really a socket-level option; it is a
@@ -153,11 +155,32 @@ int tcp_getsockopt(FAR struct socket *psock, int option,
           }
         break;
 
+#endif /* CONFIG_NET_TCP_KEEPALIVE */
+
       case TCP_NODELAY:  /* Avoid coalescing of small segments. */
+#ifdef CONFIG_NET_TCP_NAGLE
+      case TCP_CORK:     /* Hold back partial segments */
+        if (*value_len < sizeof(int))
+          {
+            ret                = -EINVAL;
+          }
+        else
+          {
+            FAR int *enable    = (FAR int *)value;
+            uint8_t bit        = option == TCP_NODELAY ?
+                                 TCP_NAGLE_NODELAY : TCP_NAGLE_CORK;
+
+            *enable            = (conn->nagle & bit) != 0;
+            *value_len         = sizeof(int);
+            ret                = OK;
+          }
+#else
         nerr("ERROR: TCP_NODELAY not supported\n");
         ret = -ENOSYS;
+#endif
         break;
 
+#ifdef CONFIG_NET_TCP_KEEPALIVE
       case TCP_KEEPIDLE:  /* Start keepalives after this IDLE period */
         if (*value_len < sizeof(struct timeval))
           {
@@ -238,6 +261,7 @@ int tcp_getsockopt(FAR struct socket *psock, int option,
             ret              = OK;
           }
         break;
+#endif /* CONFIG_NET_TCP_KEEPALIVE */
 
       default:
         nerr("ERROR: Unrecognized TCP option: %d\n", option);
@@ -248,7 +272,7 @@ int tcp_getsockopt(FAR struct socket *psock, int option,
   return ret;
 #else
   return -ENOPROTOOPT;
-#endif /* CONFIG_NET_TCP_KEEPALIVE */
+#endif /* CONFIG_NET_TCP_KEEPALIVE || CONFIG_NET_TCP_NAGLE */
 }
 
 #endif /* CONFIG_NET_TCPPROTO_OPTIONS */
@@ -104,6 +104,9 @@ static void tcp_input(FAR struct net_driver_s *dev, uint8_t domain,
   uint8_t  opt;
   int      len;
   int      i;
+#ifdef CONFIG_NET_TCP_SYNCOOKIES
+  uint16_t mss;
+#endif
 
 #ifdef CONFIG_NET_STATISTICS
   /* Bump up the count of TCP packets received */
@@ -131,9 +134,12 @@ static void tcp_input(FAR struct net_driver_s *dev, uint8_t domain,
 
   hdrlen = tcpiplen + NET_LL_HDRLEN(dev);
 
-  /* Start of TCP input header processing code. */
+  /* Start of TCP input header processing code.  The checksum has already
+   * been verified if the device offloads that.
+   */
 
-  if (tcp_chksum(dev) != 0xffff)
+  if (!NETDEV_HAS_FEATURE(dev, NETDEV_FEATURE_RXCSUM) &&
+      tcp_chksum(dev) != 0xffff)
     {
       /* Compute and check the TCP checksum. */
 
@@ -223,6 +229,18 @@ static void tcp_input(FAR struct net_driver_s *dev, uint8_t domain,
 
           if (!conn)
             {
+#ifdef CONFIG_NET_TCP_SYNCOOKIES
+              /* All available connections are in use.  Answer with a SYN
+               * cookie; the connection is only allocated if the remote
+               * end completes the handshake (see below).
+               */
+
+              uint32_t cookie = tcp_syncookie(dev, tcp, &mss);
+
+              ninfo("No free TCP connections, sending SYN cookie\n");
+              tcp_synack_cookie(dev, cookie, mss);
+              return;
+#else
               /* Either (1) all available connections are in use, or (2)
                * there is no application in place to accept the connection.
                * We drop packet and hope that the remote end will retransmit
@@ -235,11 +253,12 @@ static void tcp_input(FAR struct net_driver_s *dev, uint8_t domain,
 #endif
               nerr("ERROR: No free TCP connections\n");
               goto drop;
+#endif
             }
 
           net_incr32(conn->rcvseq, 1);
 
-          /* Parse the TCP MSS option, if present. */
+          /* Parse the TCP MSS and window scale options, if present. */
 
           if ((tcp->tcpoffset & 0xf0) > 0x50)
             {
@@ -268,11 +287,23 @@ static void tcp_input(FAR struct net_driver_s *dev, uint8_t domain,
                       tmp16 = ((uint16_t)dev->d_buf[hdrlen + 2 + i] << 8) |
                                (uint16_t)dev->d_buf[hdrlen + 3 + i];
                       conn->mss = tmp16 > tcp_mss ? tcp_mss : tmp16;
+                      i += TCP_OPT_MSS_LEN;
+                    }
+#ifdef CONFIG_NET_TCP_WINDOW_SCALE
+                  else if (opt == TCP_OPT_WS &&
+                          dev->d_buf[hdrlen + 1 + i] == TCP_OPT_WS_LEN)
+                    {
+                      /* The peer offers window scaling.  Our SYNACK will
+                       * offer it too.
+                       */
 
-                      /* And we are done processing options. */
-
-                      break;
+                      tmp16 = dev->d_buf[hdrlen + 2 + i];
+                      conn->snd_scale = tmp16 > TCP_WS_MAXSHIFT ?
+                                        TCP_WS_MAXSHIFT : tmp16;
+                      conn->wscale    = true;
+                      i += TCP_OPT_WS_LEN;
                     }
+#endif
                   else
                     {
                       /* All other options have a length field, so that we
@@ -300,6 +331,42 @@ static void tcp_input(FAR struct net_driver_s *dev, uint8_t domain,
         }
     }
 
+#ifdef CONFIG_NET_TCP_SYNCOOKIES
+  /* A bare ACK to a listening port may complete a handshake that we
+   * answered with a SYN cookie.  If the cookie checks out, create the
+   * connection in the SYN_RCVD state as if the SYN had been seen normally,
+   * with our ISN being the cookie, and let the ACK establish it.
+   */
+
+  if ((tcp->flags & (TCP_SYN | TCP_RST | TCP_FIN | TCP_ACK)) == TCP_ACK &&
+#if defined(CONFIG_NET_IPv4) && defined(CONFIG_NET_IPv6)
+      tcp_islistener(tcp->destport, domain) &&
+#else
+      tcp_islistener(tcp->destport) &&
+#endif
+      tcp_syncookie_check(dev, tcp, &mss) == OK)
+    {
+      conn = tcp_alloc_accept(dev, tcp);
+      if (conn == NULL)
+        {
+#ifdef CONFIG_NET_STATISTICS
+          g_netstats.tcp.syndrop++;
+#endif
+          nerr("ERROR: No free TCP connections\n");
+          goto drop;
+        }
+
+      conn->crefs = 1;
+      tcp_setsequence(conn->sndseq, tcp_getsequence(tcp->ackno) - 1);
+      if (conn->mss > mss)
+        {
+          conn->mss = mss;
+        }
+
+      goto found;
+    }
+#endif
+
   nwarn("WARNING: SYN with no listener (or old packet) .. reset\n");
 
   /* This is (1) an old duplicate packet or (2) a SYN packet but with
@@ -323,10 +390,21 @@ reset:
 
 found:
 
+  TCP_CONNSTATS(conn, rxsegs, 1);
+
   /* Update the connection's window size */
 
   conn->winsize = ((uint16_t)tcp->wnd[0] << 8) + (uint16_t)tcp->wnd[1];
 
+#ifdef CONFIG_NET_TCP_WINDOW_SCALE
+  /* The window in a SYN or SYNACK is never scaled */
+
+  if ((tcp->flags & TCP_SYN) == 0)
+    {
+      conn->winsize <<= conn->snd_scale;
+    }
+#endif
+
   flags = 0;
 
   /* We do a very naive form of TCP reset processing; we just accept
@@ -397,6 +475,7 @@ found:
    */
 
   dev->d_len -= (len + iplen);
+  TCP_CONNSTATS(conn, rxbytes, dev->d_len);
 
 #ifdef CONFIG_NET_TCP_KEEPALIVE
   /* Check for a to KeepAlive probes.  These packets have these properties:
@@ -534,6 +613,13 @@ found:
             tcp_getsequence(conn->sndseq), ackseq, unackseq, conn->unacked);
       tcp_setsequence(conn->sndseq, ackseq);
 
+#ifdef CONFIG_NET_TCP_CC
+      /* Do RTT estimation when the timed segment is ACKed.  Retransmitted
+       * segments are never timed (Karn's algorithm).
+       */
+
+      tcp_cc_rttsample(conn, ackseq);
+#else
       /* Do RTT estimation, unless we have done retransmissions. */
 
       if (conn->nrtx == 0)
@@ -554,6 +640,7 @@ found:
           conn->sv += m;
           conn->rto = (conn->sa >> 3) + conn->sv;
         }
+#endif
 
       /* Set the acknowledged flag. */
 
@@ -655,7 +742,11 @@ found:
         if ((flags & TCP_ACKDATA) != 0 &&
             (tcp->flags & TCP_CTL) == (TCP_SYN | TCP_ACK))
           {
-            /* Parse the TCP MSS option, if present. */
+#ifdef CONFIG_NET_TCP_WINDOW_SCALE
+            conn->wscale = false;
+#endif
+
+            /* Parse the TCP MSS and window scale options, if present. */
 
             if ((tcp->tcpoffset & 0xf0) > 0x50)
               {
@@ -685,11 +776,23 @@ found:
                           (dev->d_buf[hdrlen + 2 + i] << 8) |
                           dev->d_buf[hdrlen + 3 + i];
                         conn->mss = tmp16 > tcp_mss ? tcp_mss : tmp16;
+                        i += TCP_OPT_MSS_LEN;
+                      }
+#ifdef CONFIG_NET_TCP_WINDOW_SCALE
+                    else if (opt == TCP_OPT_WS &&
+                              dev->d_buf[hdrlen + 1 + i] == TCP_OPT_WS_LEN)
+                      {
+                        /* The peer accepted the window scaling that we
+                         * offered in our SYN.
+                         */
 
-                        /* And we are done processing options. */
-
-                        break;
+                        tmp16 = dev->d_buf[hdrlen + 2 + i];
+                        conn->snd_scale = tmp16 > TCP_WS_MAXSHIFT ?
+                                          TCP_WS_MAXSHIFT : tmp16;
+                        conn->wscale    = true;
+                        i += TCP_OPT_WS_LEN;
                       }
+#endif
                     else
                       {
                         /* All other options have a length field, so that we
@@ -710,6 +813,18 @@ found:
                   }
               }
 
+#ifdef CONFIG_NET_TCP_WINDOW_SCALE
+            /* Scaling is used in neither direction unless both sides
+             * offered it.
+             */
+
+            if (!conn->wscale)
+              {
+                conn->snd_scale = 0;
+                conn->rcv_scale = 0;
+              }
+#endif
+
             conn->tcpstateflags = TCP_ESTABLISHED;
             memcpy(conn->rcvseq, tcp->seqno, 4);
 
@@ -945,8 +1060,7 @@ found:
           {
             if ((flags & TCP_ACKDATA) != 0 && conn->unacked == 0)
               {
-                conn->tcpstateflags = TCP_TIME_WAIT;
-                conn->timer         = 0;
+                tcp_timewait(conn);
                 ninfo("TCP state: TCP_TIME_WAIT\n");
               }
             else
@@ -983,8 +1097,7 @@ found:
 
         if ((tcp->flags & TCP_FIN) != 0)
           {
-            conn->tcpstateflags = TCP_TIME_WAIT;
-            conn->timer         = 0;
+            tcp_timewait(conn);
             ninfo("TCP state: TCP_TIME_WAIT\n");
 
             net_incr32(conn->rcvseq, 1);
@@ -1008,8 +1121,7 @@ found:
       case TCP_CLOSING:
         if ((flags & TCP_ACKDATA) != 0)
           {
-            conn->tcpstateflags = TCP_TIME_WAIT;
-            conn->timer        = 0;
+            tcp_timewait(conn);
             ninfo("TCP state: TCP_TIME_WAIT\n");
           }
 
@@ -46,6 +46,7 @@
 
 #include <stdint.h>
 #include <stdbool.h>
+#include <string.h>
 #include <debug.h>
 
 #include <nuttx/net/netconfig.h>
@@ -58,9 +59,18 @@
  * Private Data
  ****************************************************************************/
 
+#ifdef CONFIG_NET_TCP_HASH
+/* All listening connections, hashed on the local port.  g_tcp_nlisteners
+ * enforces the CONFIG_NET_MAX_LISTENPORTS limit.
+ */
+
+static FAR struct tcp_conn_s *g_tcp_listen_hash[CONFIG_NET_TCP_HASHSIZE];
+static int g_tcp_nlisteners;
+#else
 /* The tcp_listenports list all currently listening ports. */
 
 static FAR struct tcp_conn_s *tcp_listenports[CONFIG_NET_MAX_LISTENPORTS];
+#endif
 
 /****************************************************************************
  * Private Functions
@@ -83,6 +93,15 @@ FAR struct tcp_conn_s *tcp_findlistener(uint16_t portno, uint8_t domain)
 FAR struct tcp_conn_s *tcp_findlistener(uint16_t portno)
 #endif
 {
+#ifdef CONFIG_NET_TCP_HASH
+  FAR struct tcp_conn_s *conn;
+
+  /* Examine only the listeners whose local port hashes the same */
+
+  for (conn = g_tcp_listen_hash[TCP_PORTHASH(portno)]; conn != NULL;
+       conn = conn->lnext)
+    {
+#else
   int ndx;
 
   /* Examine each connection structure in each slot of the listener list */
@@ -94,6 +113,7 @@ FAR struct tcp_conn_s *tcp_findlistener(uint16_t portno)
        */
 
       FAR struct tcp_conn_s *conn = tcp_listenports[ndx];
+#endif
 #if defined(CONFIG_NET_IPv4) && defined(CONFIG_NET_IPv6)
       if (conn && conn->lport == portno && conn->domain == domain)
 #else
@@ -129,11 +149,16 @@ FAR struct tcp_conn_s *tcp_findlistener(uint16_t portno)
 
 void tcp_listen_initialize(void)
 {
+#ifdef CONFIG_NET_TCP_HASH
+  memset(g_tcp_listen_hash, 0, sizeof(g_tcp_listen_hash));
+  g_tcp_nlisteners = 0;
+#else
   int ndx;
   for (ndx = 0; ndx < CONFIG_NET_MAX_LISTENPORTS; ndx++)
     {
       tcp_listenports[ndx] = NULL;
     }
+#endif
 }
 
 /****************************************************************************
@@ -149,10 +174,33 @@ void tcp_listen_initialize(void)
 
 int tcp_unlisten(FAR struct tcp_conn_s *conn)
 {
+#ifdef CONFIG_NET_TCP_HASH
+  FAR struct tcp_conn_s **link;
+#endif
   int ndx;
   int ret = -EINVAL;
 
   net_lock();
+#ifdef CONFIG_NET_TCP_HASH
+  /* Search every chain:  This is rare and it does not depend on lport
+   * being unchanged since the connection started listening.
+   */
+
+  for (ndx = 0; ndx < CONFIG_NET_TCP_HASHSIZE && ret < 0; ndx++)
+    {
+      for (link = &g_tcp_listen_hash[ndx]; *link != NULL;
+           link = &(*link)->lnext)
+        {
+          if (*link == conn)
+            {
+              *link = conn->lnext;
+              g_tcp_nlisteners--;
+              ret = OK;
+              break;
+            }
+        }
+    }
+#else
   for (ndx = 0; ndx < CONFIG_NET_MAX_LISTENPORTS; ndx++)
     {
       if (tcp_listenports[ndx] == conn)
@@ -162,6 +210,7 @@ int tcp_unlisten(FAR struct tcp_conn_s *conn)
           break;
         }
     }
+#endif
 
   net_unlock();
   return ret;
@@ -180,7 +229,11 @@ int tcp_unlisten(FAR struct tcp_conn_s *conn)
 
 int tcp_listen(FAR struct tcp_conn_s *conn)
 {
+#ifdef CONFIG_NET_TCP_HASH
+  FAR struct tcp_conn_s **link;
+#else
   int ndx;
+#endif
   int ret;
 
   /* This must be done with network locked because the listener table
@@ -209,6 +262,23 @@ int tcp_listen(FAR struct tcp_conn_s *conn)
 
       ret = -ENOBUFS; /* Assume failure */
 
+#ifdef CONFIG_NET_TCP_HASH
+      if (g_tcp_nlisteners < CONFIG_NET_MAX_LISTENPORTS)
+        {
+          /* Add the listener at the tail of its chain */
+
+          link = &g_tcp_listen_hash[TCP_PORTHASH(conn->lport)];
+          while (*link != NULL)
+            {
+              link = &(*link)->lnext;
+            }
+
+          conn->lnext = NULL;
+          *link       = conn;
+          g_tcp_nlisteners++;
+          ret         = OK;
+        }
+#else
       /* Search all slots until an available slot is found */
 
       for (ndx = 0; ndx < CONFIG_NET_MAX_LISTENPORTS; ndx++)
@@ -224,6 +294,7 @@ int tcp_listen(FAR struct tcp_conn_s *conn)
               break;
             }
         }
+#endif
     }
 
   net_unlock();
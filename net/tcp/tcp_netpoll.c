@@ -264,6 +264,10 @@ static inline void tcp_poll_txnotify(FAR struct socket *psock)
 {
   FAR struct tcp_conn_s *conn = psock->s_conn;
 
+  /* Make sure that the next poll of the device visits this connection */
+
+  tcp_txready(conn);
+
 #ifdef CONFIG_NET_IPv4
 #ifdef CONFIG_NET_IPv6
   /* If both IPv4 and IPv6 support are enabled, then we will need to select
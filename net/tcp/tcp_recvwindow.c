@@ -52,6 +52,35 @@
 
 #include "tcp/tcp.h"
 
+/****************************************************************************
+ * Private Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: tcp_readahead_len
+ *
+ * Description:
+ *   Return the number of bytes currently held in the connection's read-
+ *   ahead buffers.
+ *
+ ****************************************************************************/
+
+#if defined(CONFIG_NET_SOCKOPTS) && defined(CONFIG_NET_TCP_READAHEAD)
+static uint32_t tcp_readahead_len(FAR struct tcp_conn_s *conn)
+{
+  FAR struct iob_qentry_s *qentry;
+  uint32_t len = 0;
+
+  for (qentry = conn->readahead.qh_head; qentry != NULL;
+       qentry = qentry->qe_flink)
+    {
+      len += qentry->qe_head->io_pktlen;
+    }
+
+  return len;
+}
+#endif
+
 /****************************************************************************
  * Public Functions
  ****************************************************************************/
@@ -60,21 +89,25 @@
  * Name: tcp_get_recvwindow
  *
  * Description:
- *   Calculate the TCP receive window for the specified device.
+ *   Calculate the TCP receive window for the specified device and
+ *   connection.
  *
  * Input Parameters:
- *   dev - The device whose TCP receive window will be updated.
+ *   dev  - The device whose TCP receive window will be updated.
+ *   conn - The TCP connection that the window is advertised for.
  *
  * Returned Value:
- *   The value of the TCP receive window to use.
+ *   The value to place in the 16-bit TCP window field, i.e. already scaled
+ *   down by the negotiated window scale shift count.
  *
  ****************************************************************************/
 
-uint16_t tcp_get_recvwindow(FAR struct net_driver_s *dev)
+uint16_t tcp_get_recvwindow(FAR struct net_driver_s *dev,
+                            FAR struct tcp_conn_s *conn)
 {
   uint16_t iplen;
   uint16_t mss;
-  uint16_t recvwndo;
+  uint32_t recvwndo;
 #ifdef CONFIG_NET_TCP_READAHEAD
   int  niob_avail;
   int  nqentry_avail;
@@ -139,8 +172,6 @@ uint16_t tcp_get_recvwindow(FAR struct net_driver_s *dev)
 
   if (nqentry_avail > 0 && niob_avail > 0)
     {
-      uint32_t rwnd;
-
       /* The optimal TCP window size is the amount of TCP data that we can
        * currently buffer via TCP read-ahead buffering plus MSS for the
        * device packet buffer.  This logic here assumes that all IOBs are
@@ -157,15 +188,7 @@ uint16_t tcp_get_recvwindow(FAR struct net_driver_s *dev)
        * buffering for this connection.
        */
 
-      rwnd = (niob_avail * CONFIG_IOB_BUFSIZE) + mss;
-      if (rwnd > UINT16_MAX)
-        {
-          rwnd = UINT16_MAX;
-        }
-
-      /* Save the new receive window size */
-
-      recvwndo = (uint16_t)rwnd;
+      recvwndo = (niob_avail * CONFIG_IOB_BUFSIZE) + mss;
     }
   else /* nqentry_avail == 0 || niob_avail == 0 */
 #endif
@@ -181,5 +204,36 @@ uint16_t tcp_get_recvwindow(FAR struct net_driver_s *dev)
       recvwndo = mss;
     }
 
-  return recvwndo;
+#ifdef CONFIG_NET_SOCKOPTS
+  /* Do not advertise more than the space left under SO_RCVBUF */
+
+  if (conn->rcvbufs > 0)
+    {
+      uint32_t avail = conn->rcvbufs;
+
+#ifdef CONFIG_NET_TCP_READAHEAD
+      uint32_t buffered = tcp_readahead_len(conn);
+
+      avail = avail > buffered ? avail - buffered : 0;
+#endif
+      if (recvwndo > avail)
+        {
+          recvwndo = avail;
+        }
+    }
+#endif
+
+#ifdef CONFIG_NET_TCP_WINDOW_SCALE
+  /* The window field of the SYN and SYNACK is never scaled.  After that,
+   * the window is scaled by our shift count if scaling was negotiated.
+   */
+
+  if ((conn->tcpstateflags & TCP_STATE_MASK) != TCP_SYN_RCVD &&
+      (conn->tcpstateflags & TCP_STATE_MASK) != TCP_SYN_SENT)
+    {
+      recvwndo >>= conn->rcv_scale;
+    }
+#endif
+
+  return recvwndo > UINT16_MAX ? UINT16_MAX : (uint16_t)recvwndo;
 }
@@ -153,7 +153,10 @@ static inline void tcp_ipv4_sendcomplete(FAR struct net_driver_s *dev,
   tcp->urgp[1]      = 0;
 
   tcp->tcpchksum    = 0;
-  tcp->tcpchksum    = ~tcp_ipv4_chksum(dev);
+  if (!NETDEV_HAS_FEATURE(dev, NETDEV_FEATURE_TXCSUM))
+    {
+      tcp->tcpchksum = ~tcp_ipv4_chksum(dev);
+    }
 
   /* Finish initializing the IP header and calculate the IP checksum */
 
@@ -165,10 +168,13 @@ static inline void tcp_ipv4_sendcomplete(FAR struct net_driver_s *dev,
   ipv4->ipid[0]     = g_ipid >> 8;
   ipv4->ipid[1]     = g_ipid & 0xff;
 
-  /* Calculate IP checksum. */
+  /* Calculate IP checksum (unless the device does it) */
 
   ipv4->ipchksum    = 0;
-  ipv4->ipchksum    = ~ipv4_chksum(dev);
+  if (!NETDEV_HAS_FEATURE(dev, NETDEV_FEATURE_TXCSUM))
+    {
+      ipv4->ipchksum = ~ipv4_chksum(dev);
+    }
 
   ninfo("IPv4 length: %d\n", ((int)ipv4->len[0] << 8) + ipv4->len[1]);
 
@@ -225,7 +231,10 @@ static inline void tcp_ipv6_sendcomplete(FAR struct net_driver_s *dev,
   tcp->urgp[1]     = 0;
 
   tcp->tcpchksum   = 0;
-  tcp->tcpchksum   = ~tcp_ipv6_chksum(dev);
+  if (!NETDEV_HAS_FEATURE(dev, NETDEV_FEATURE_TXCSUM))
+    {
+      tcp->tcpchksum = ~tcp_ipv6_chksum(dev);
+    }
 
   /* Finish initializing the IP header (no IPv6 checksum) */
 
@@ -287,6 +296,49 @@ static void tcp_sendcomplete(FAR struct net_driver_s *dev,
 #endif
 }
 
+/****************************************************************************
+ * Name: tcp_rcvscale
+ *
+ * Description:
+ *   Select the window scale shift count to offer to the peer.  This is the
+ *   smallest shift that lets the 16-bit window field cover all of the
+ *   receive buffering that the connection could ever use.
+ *
+ * Input Parameters:
+ *   conn - The TCP connection structure holding connection information
+ *
+ * Returned Value:
+ *   The shift count, 0 through TCP_WS_MAXSHIFT.
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_NET_TCP_WINDOW_SCALE
+static uint8_t tcp_rcvscale(FAR struct tcp_conn_s *conn)
+{
+  uint32_t bufsize = 0;
+  uint8_t shift = 0;
+
+#ifdef CONFIG_NET_TCP_READAHEAD
+  bufsize = (uint32_t)CONFIG_IOB_NBUFFERS * CONFIG_IOB_BUFSIZE;
+#endif
+
+#ifdef CONFIG_NET_SOCKOPTS
+  if (conn->rcvbufs > 0)
+    {
+      bufsize = conn->rcvbufs;
+    }
+#endif
+
+  while (shift < TCP_WS_MAXSHIFT &&
+         ((uint32_t)UINT16_MAX << shift) < bufsize)
+    {
+      shift++;
+    }
+
+  return shift;
+}
+#endif
+
 /****************************************************************************
  * Name: tcp_sendcommon
  *
@@ -360,7 +412,7 @@ static void tcp_sendcommon(FAR struct net_driver_s *dev,
     {
       /* Update the TCP received window based on I/O buffer availability */
 
-      uint16_t recvwndo = tcp_get_recvwindow(dev);
+      uint16_t recvwndo = tcp_get_recvwindow(dev, conn);
 
       /* Set the TCP Window */
 
@@ -370,6 +422,7 @@ static void tcp_sendcommon(FAR struct net_driver_s *dev,
 
   /* Finish the IP portion of the message and calculate checksums */
 
+  TCP_CONNSTATS(conn, txsegs, 1);
   tcp_sendcomplete(dev, tcp);
 }
 
@@ -617,9 +670,117 @@ void tcp_ack(FAR struct net_driver_s *dev, FAR struct tcp_conn_s *conn,
   tcp->optdata[3] = tcp_mss & 0xff;
   tcp->tcpoffset  = ((TCP_HDRLEN + TCP_OPT_MSS_LEN) / 4) << 4;
 
+#ifdef CONFIG_NET_TCP_WINDOW_SCALE
+  /* Offer window scaling in our SYN.  The SYNACK may only carry the option
+   * if the peer offered it in its SYN.
+   */
+
+  if (ack == TCP_SYN || conn->wscale)
+    {
+      FAR uint8_t *optdata = (FAR uint8_t *)tcp + TCP_HDRLEN +
+                             TCP_OPT_MSS_LEN;
+
+      conn->rcv_scale = tcp_rcvscale(conn);
+
+      optdata[0]      = TCP_OPT_NOOP;
+      optdata[1]      = TCP_OPT_WS;
+      optdata[2]      = TCP_OPT_WS_LEN;
+      optdata[3]      = conn->rcv_scale;
+      tcp->tcpoffset  = ((TCP_HDRLEN + TCP_OPT_MSS_LEN + 4) / 4) << 4;
+      dev->d_len     += 4;
+    }
+#endif
+
   /* Complete the common portions of the TCP message */
 
   tcp_sendcommon(dev, conn, tcp);
 }
 
+/****************************************************************************
+ * Name: tcp_synack_cookie
+ *
+ * Description:
+ *   Answer the SYN in the device buffer with a SYNACK that carries a SYN
+ *   cookie as its sequence number.  No connection structure is involved;
+ *   the response is built in place from the incoming SYN, as tcp_reset()
+ *   does.
+ *
+ * Input Parameters:
+ *   dev    - The device driver structure holding the received SYN
+ *   cookie - The initial sequence number to send
+ *   mss    - The MSS to offer, the one encoded in the cookie
+ *
+ * Returned Value:
+ *   None
+ *
+ * Assumptions:
+ *   Called with the network locked.
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_NET_TCP_SYNCOOKIES
+void tcp_synack_cookie(FAR struct net_driver_s *dev, uint32_t cookie,
+                       uint16_t mss)
+{
+  FAR struct tcp_hdr_s *tcp = tcp_header(dev);
+  uint16_t tmp16;
+
+  /* Acknowledge the SYN and send the cookie as our ISN */
+
+  tcp_setsequence(tcp->ackno, tcp_addsequence(tcp->seqno, 1));
+  tcp_setsequence(tcp->seqno, cookie);
+
+  tmp16           = tcp->srcport;
+  tcp->srcport    = tcp->destport;
+  tcp->destport   = tmp16;
+
+  /* Only the MSS option survives in the cookie, so that is all we offer.
+   * Advertise one segment of window until the connection exists.
+   */
+
+  tcp->flags      = TCP_SYN | TCP_ACK;
+  tcp->optdata[0] = TCP_OPT_MSS;
+  tcp->optdata[1] = TCP_OPT_MSS_LEN;
+  tcp->optdata[2] = mss >> 8;
+  tcp->optdata[3] = mss & 0xff;
+  tcp->tcpoffset  = ((TCP_HDRLEN + TCP_OPT_MSS_LEN) / 4) << 4;
+  tcp->wnd[0]     = mss >> 8;
+  tcp->wnd[1]     = mss & 0xff;
+  tcp->urgp[0]    = 0;
+  tcp->urgp[1]    = 0;
+
+  /* Set the packet length and swap IP addresses. */
+
+#ifdef CONFIG_NET_IPv6
+#ifdef CONFIG_NET_IPv4
+  if (IFF_IS_IPv6(dev->d_flags))
+#endif
+    {
+      FAR struct ipv6_hdr_s *ipv6 = IPv6BUF;
+
+      dev->d_len = IPv6TCP_HDRLEN + TCP_OPT_MSS_LEN;
+
+      net_ipv6addr_hdrcopy(ipv6->destipaddr, ipv6->srcipaddr);
+      net_ipv6addr_hdrcopy(ipv6->srcipaddr, dev->d_ipv6addr);
+    }
+#endif /* CONFIG_NET_IPv6 */
+
+#ifdef CONFIG_NET_IPv4
+#ifdef CONFIG_NET_IPv6
+  else
+#endif
+    {
+      FAR struct ipv4_hdr_s *ipv4 = IPv4BUF;
+
+      dev->d_len = IPv4TCP_HDRLEN + TCP_OPT_MSS_LEN;
+
+      net_ipv4addr_hdrcopy(ipv4->destipaddr, ipv4->srcipaddr);
+      net_ipv4addr_hdrcopy(ipv4->srcipaddr, &dev->d_ipaddr);
+    }
+#endif /* CONFIG_NET_IPv4 */
+
+  tcp_sendcomplete(dev, tcp);
+}
+#endif /* CONFIG_NET_TCP_SYNCOOKIES */
+
 #endif /* CONFIG_NET && CONFIG_NET_TCP */
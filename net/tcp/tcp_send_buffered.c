@@ -65,9 +65,11 @@
 #include <nuttx/clock.h>
 #include <nuttx/net/net.h>
 #include <nuttx/mm/iob.h>
+#include <nuttx/semaphore.h>
 #include <nuttx/net/netdev.h>
 #include <nuttx/net/arp.h>
 #include <nuttx/net/tcp.h>
+#include <nuttx/net/netstats.h>
 #include <nuttx/net/net.h>
 
 #include "netdev/netdev.h"
@@ -173,9 +175,22 @@ static void psock_insert_segment(FAR struct tcp_wrbuffer_s *wrb,
  *
  ****************************************************************************/
 
-#ifdef CONFIG_TCP_NOTIFIER
+#if defined(CONFIG_TCP_NOTIFIER) || defined(CONFIG_NET_SOCKOPTS)
 static void psock_writebuffer_notify(FAR struct tcp_conn_s *conn)
 {
+#ifdef CONFIG_NET_SOCKOPTS
+  int sval;
+
+  /* Wake up a sender that is waiting for SO_SNDBUF space */
+
+  if (conn->sndbufs > 0 &&
+      nxsem_getvalue(&conn->snd_sem, &sval) >= 0 && sval < 0)
+    {
+      nxsem_post(&conn->snd_sem);
+    }
+#endif
+
+#ifdef CONFIG_TCP_NOTIFIER
   /* Check if all write buffers have been sent and ACKed */
 
   if (sq_empty(&conn->write_q) && sq_empty(&conn->unacked_q))
@@ -184,11 +199,78 @@ static void psock_writebuffer_notify(FAR struct tcp_conn_s *conn)
 
       tcp_writebuffer_signal(conn);
     }
+#endif
 }
 #else
 #  define psock_writebuffer_notify(conn)
 #endif
 
+/****************************************************************************
+ * Name: psock_sndbuf_wait
+ *
+ * Description:
+ *   Wait until the data held in the write buffers drops below the SO_SNDBUF
+ *   limit of the connection.
+ *
+ * Input Parameters:
+ *   psock    The socket structure
+ *   conn     The connection structure associated with the socket
+ *
+ * Returned Value:
+ *   The number of bytes that may still be queued on success; a negated
+ *   errno value on failure.
+ *
+ * Assumptions:
+ *   The network is locked and conn->sndbufs is non-zero.
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_NET_SOCKOPTS
+static ssize_t psock_sndbuf_wait(FAR struct socket *psock,
+                                 FAR struct tcp_conn_s *conn)
+{
+  FAR sq_entry_t *entry;
+  uint32_t queued;
+  int ret;
+
+  for (; ; )
+    {
+      queued = 0;
+
+      for (entry = sq_peek(&conn->unacked_q); entry; entry = sq_next(entry))
+        {
+          queued += TCP_WBPKTLEN((FAR struct tcp_wrbuffer_s *)entry);
+        }
+
+      for (entry = sq_peek(&conn->write_q); entry; entry = sq_next(entry))
+        {
+          queued += TCP_WBPKTLEN((FAR struct tcp_wrbuffer_s *)entry);
+        }
+
+      if (queued < conn->sndbufs)
+        {
+          return conn->sndbufs - queued;
+        }
+
+      if (_SS_ISNONBLOCK(psock->s_flags))
+        {
+          return -EAGAIN;
+        }
+
+      ret = net_lockedwait(&conn->snd_sem);
+      if (ret < 0)
+        {
+          return ret;
+        }
+
+      if (!_SS_ISCONNECTED(psock->s_flags))
+        {
+          return -ENOTCONN;
+        }
+    }
+}
+#endif
+
 /****************************************************************************
  * Name: psock_lost_connection
  *
@@ -291,6 +373,174 @@ static inline void send_ipselect(FAR struct net_driver_s *dev,
 }
 #endif
 
+/****************************************************************************
+ * Name: psock_fast_retransmit
+ *
+ * Description:
+ *   Retransmit the oldest unacknowledged segment without waiting for the
+ *   retransmission timer.  Nothing is moved between the write queues and
+ *   the counts of sent and unacknowledged data are left alone: the data is
+ *   simply sent again from its original sequence number.
+ *
+ * Input Parameters:
+ *   dev      The structure of the network driver that caused the event
+ *   conn     The connection structure associated with the socket
+ *
+ * Returned Value:
+ *   None
+ *
+ * Assumptions:
+ *   The network is locked
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_NET_TCP_CC
+static void psock_fast_retransmit(FAR struct net_driver_s *dev,
+                                  FAR struct tcp_conn_s *conn)
+{
+  FAR struct tcp_wrbuffer_s *wrb;
+  uint32_t sndlen;
+
+  /* The oldest unACKed data is at the head of the unacked_q or, if none
+   * of the fully sent buffers are waiting, in the partially sent buffer at
+   * the head of the write_q.
+   */
+
+  wrb = (FAR struct tcp_wrbuffer_s *)sq_peek(&conn->unacked_q);
+  if (wrb == NULL)
+    {
+      wrb = (FAR struct tcp_wrbuffer_s *)sq_peek(&conn->write_q);
+      if (wrb == NULL || TCP_WBSENT(wrb) == 0)
+        {
+          return;
+        }
+    }
+
+  /* Is the outgoing packet available? */
+
+  if (dev->d_sndlen > 0)
+    {
+      return;
+    }
+
+  sndlen = MIN(TCP_WBSENT(wrb), conn->mss);
+
+  ninfo("FAST REXMIT: wrb=%p seqno=%u sndlen=%u\n",
+        wrb, TCP_WBSEQNO(wrb), sndlen);
+
+  tcp_setsequence(conn->sndseq, TCP_WBSEQNO(wrb));
+
+#ifdef NEED_IPDOMAIN_SUPPORT
+  send_ipselect(dev, conn);
+#endif
+
+  devif_iob_send(dev, TCP_WBIOB(wrb), sndlen, 0);
+
+#ifdef CONFIG_NETDEV_OFFLOAD
+  dev->d_tsomss = conn->mss;
+#endif
+
+#ifdef CONFIG_NET_STATISTICS
+  g_netstats.tcp.rexmit++;
+#endif
+  TCP_CONNSTATS(conn, rexmit, 1);
+}
+#endif
+
+/****************************************************************************
+ * Name: psock_coalesce
+ *
+ * Description:
+ *   Merge the write buffers that follow 'wrb' in the write queue into
+ *   'wrb' until it holds at least a full segment of unsent data.  Only
+ *   write buffers that have never been sent can be merged; the merged
+ *   write buffers are released.
+ *
+ * Input Parameters:
+ *   conn     The connection structure associated with the socket
+ *   wrb      The write buffer at the head of the write queue
+ *
+ * Returned Value:
+ *   None
+ *
+ * Assumptions:
+ *   The network is locked
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_NET_TCP_NAGLE
+static void psock_coalesce(FAR struct tcp_conn_s *conn,
+                           FAR struct tcp_wrbuffer_s *wrb)
+{
+  FAR struct tcp_wrbuffer_s *next;
+
+  if (TCP_WBNRTX(wrb) > 0)
+    {
+      return;
+    }
+
+  while (TCP_WBPKTLEN(wrb) - TCP_WBSENT(wrb) < conn->mss)
+    {
+      next = (FAR struct tcp_wrbuffer_s *)sq_next(&wrb->wb_node);
+      if (next == NULL || TCP_WBSEQNO(next) != (unsigned)-1)
+        {
+          break;
+        }
+
+      ninfo("COALESCE: wrb=%p pktlen=%u next=%p pktlen=%u\n",
+            wrb, TCP_WBPKTLEN(wrb), next, TCP_WBPKTLEN(next));
+
+      sq_remafter(&wrb->wb_node, &conn->write_q);
+      iob_concat(TCP_WBIOB(wrb), TCP_WBIOB(next),
+                 IOBUSER_NET_TCP_WRITEBUFFER);
+      TCP_WBIOB(next) = NULL;
+      tcp_wrbuffer_release(next);
+    }
+}
+
+/****************************************************************************
+ * Name: psock_nagle_hold
+ *
+ * Description:
+ *   Decide whether a segment of 'sndlen' bytes from the head of the write
+ *   queue should be held back to be sent later as part of a larger one.
+ *   Only a new segment that would carry the last of the queued data and
+ *   that is shorter than the MSS is held back:  Always while the socket
+ *   is corked or the last send() had MSG_MORE and, unless TCP_NODELAY is
+ *   set, also while earlier data is still un-ACKed (RFC 896).
+ *
+ * Input Parameters:
+ *   conn     The connection structure associated with the socket
+ *   wrb      The write buffer at the head of the write queue
+ *   sndlen   The size of the segment that could be sent now
+ *
+ * Returned Value:
+ *   True if the segment should not be sent yet.
+ *
+ * Assumptions:
+ *   The network is locked
+ *
+ ****************************************************************************/
+
+static bool psock_nagle_hold(FAR struct tcp_conn_s *conn,
+                             FAR struct tcp_wrbuffer_s *wrb, size_t sndlen)
+{
+  if (sndlen >= conn->mss || TCP_WBNRTX(wrb) > 0 ||
+      sndlen < TCP_WBPKTLEN(wrb) - TCP_WBSENT(wrb) ||
+      sq_next(&wrb->wb_node) != NULL)
+    {
+      return false;
+    }
+
+  if ((conn->nagle & (TCP_NAGLE_CORK | TCP_NAGLE_MORE)) != 0)
+    {
+      return true;
+    }
+
+  return (conn->nagle & TCP_NAGLE_NODELAY) == 0 && conn->unacked > 0;
+}
+#endif
+
 /****************************************************************************
  * Name: psock_send_eventhandler
  *
@@ -481,6 +731,20 @@ static uint16_t psock_send_eventhandler(FAR struct net_driver_s *dev,
           ninfo("ACK: wrb=%p seqno=%u pktlen=%u sent=%u\n",
                 wrb, TCP_WBSEQNO(wrb), TCP_WBPKTLEN(wrb), TCP_WBSENT(wrb));
         }
+
+#ifdef CONFIG_NET_TCP_CC
+      /* Let congestion control account for the ACK.  An ACK without data
+       * while data is outstanding may be a duplicate ACK; the third one
+       * (and any partial ACK in fast recovery) asks for the oldest
+       * unACKed segment to be retransmitted now.
+       */
+
+      if (tcp_cc_ack(conn, ackno,
+                     (flags & TCP_NEWDATA) == 0 && conn->unacked > 0))
+        {
+          psock_fast_retransmit(dev, conn);
+        }
+#endif
     }
 
   /* Check for a loss of connection */
@@ -516,6 +780,12 @@ static uint16_t psock_send_eventhandler(FAR struct net_driver_s *dev,
 
       ninfo("REXMIT: %04x\n", flags);
 
+#ifdef CONFIG_NET_TCP_CC
+      /* Collapse the congestion window to the loss window */
+
+      tcp_cc_timeout(conn);
+#endif
+
       /* If there is a partially sent write buffer at the head of the
        * write_q?  Has anything been sent from that write buffer?
        */
@@ -695,6 +965,9 @@ static uint16_t psock_send_eventhandler(FAR struct net_driver_s *dev,
       FAR struct tcp_wrbuffer_s *wrb;
       uint32_t predicted_seqno;
       size_t sndlen;
+#ifdef CONFIG_NET_TCP_CC
+      uint32_t sndwnd;
+#endif
 
       /* Peek at the head of the write queue (but don't remove anything
        * from the write queue yet).  We know from the above test that
@@ -704,16 +977,39 @@ static uint16_t psock_send_eventhandler(FAR struct net_driver_s *dev,
       wrb = (FAR struct tcp_wrbuffer_s *)sq_peek(&conn->write_q);
       DEBUGASSERT(wrb);
 
+#ifdef CONFIG_NET_TCP_NAGLE
+      /* Send the small writes that have queued up as full segments */
+
+      psock_coalesce(conn, wrb);
+#endif
+
+#ifdef CONFIG_NET_TCP_CC
+      /* Open the congestion window before the first data is sent.  After
+       * that, keep no more data in flight than the window allows.
+       */
+
+      if (conn->cc == NULL)
+        {
+          tcp_cc_init(conn);
+        }
+
+      sndwnd = tcp_cc_sndwnd(conn);
+      if (conn->unacked >= sndwnd)
+        {
+          return flags;
+        }
+#endif
+
       /* Get the amount of data that we can send in the next packet.
        * We will send either the remaining data in the buffer I/O
-       * buffer chain, or as much as will fit given the MSS and current
-       * window size.
+       * buffer chain, or as much as will fit given the MSS (or the TSO
+       * limit if the device segments for us) and current window size.
        */
 
       sndlen = TCP_WBPKTLEN(wrb) - TCP_WBSENT(wrb);
-      if (sndlen > conn->mss)
+      if (sndlen > TCP_SNDMSS(dev, conn))
         {
-          sndlen = conn->mss;
+          sndlen = TCP_SNDMSS(dev, conn);
         }
 
       if (sndlen > conn->winsize)
@@ -721,6 +1017,29 @@ static uint16_t psock_send_eventhandler(FAR struct net_driver_s *dev,
           sndlen = conn->winsize;
         }
 
+#ifdef CONFIG_NET_TCP_CC
+      if (sndlen > sndwnd - conn->unacked)
+        {
+          /* Wait for more of the window to open rather than send a runt
+           * segment, unless nothing is in flight.
+           */
+
+          if (sndwnd - conn->unacked < conn->mss && conn->unacked > 0)
+            {
+              return flags;
+            }
+
+          sndlen = sndwnd - conn->unacked;
+        }
+#endif
+
+#ifdef CONFIG_NET_TCP_NAGLE
+      if (psock_nagle_hold(conn, wrb, sndlen))
+        {
+          return flags;
+        }
+#endif
+
       ninfo("SEND: wrb=%p pktlen=%u sent=%u sndlen=%u mss=%u "
             "winsize=%u\n",
             wrb, TCP_WBPKTLEN(wrb), TCP_WBSENT(wrb), sndlen, conn->mss,
@@ -761,6 +1080,12 @@ static uint16_t psock_send_eventhandler(FAR struct net_driver_s *dev,
 
       devif_iob_send(dev, TCP_WBIOB(wrb), sndlen, TCP_WBSENT(wrb));
 
+#ifdef CONFIG_NETDEV_OFFLOAD
+      /* Tell a TSO device how to segment the packet if it is too large */
+
+      dev->d_tsomss = conn->mss;
+#endif
+
       /* Remember how much data we send out now so that we know
        * when everything has been acknowledged.  Just increment
        * the amount of data sent. This will be needed in sequence
@@ -778,6 +1103,15 @@ static uint16_t psock_send_eventhandler(FAR struct net_driver_s *dev,
           (tcp_getsequence(conn->sndseq) > predicted_seqno)) /* overflow */
         {
            conn->sndseq_max = predicted_seqno;
+
+#ifdef CONFIG_NET_TCP_CC
+          /* Time this segment if it is new data that has never been sent */
+
+          if (TCP_WBNRTX(wrb) == 0)
+            {
+              tcp_cc_rttstart(conn, predicted_seqno);
+            }
+#endif
         }
 
       ninfo("SEND: wrb=%p nrtx=%u unacked=%u sent=%u\n",
@@ -843,6 +1177,10 @@ static uint16_t psock_send_eventhandler(FAR struct net_driver_s *dev,
 static inline void send_txnotify(FAR struct socket *psock,
                                  FAR struct tcp_conn_s *conn)
 {
+  /* Make sure that the next poll of the device visits this connection */
+
+  tcp_txready(conn);
+
 #ifdef CONFIG_NET_IPv4
 #ifdef CONFIG_NET_IPv6
   /* If both IPv4 and IPv6 support are enabled, then we will need to select
@@ -872,66 +1210,20 @@ static inline void send_txnotify(FAR struct socket *psock,
 }
 
 /****************************************************************************
- * Public Functions
- ****************************************************************************/
-
-/****************************************************************************
- * Name: psock_tcp_send
+ * Name: tcp_send_internal
  *
  * Description:
- *   psock_tcp_send() call may be used only when the TCP socket is in a
- *   connected state (so that the intended recipient is known).
- *
- * Input Parameters:
- *   psock    An instance of the internal socket structure.
- *   buf      Data to send
- *   len      Length of data to send
- *
- * Returned Value:
- *   On success, returns the number of characters sent.  On  error,
- *   -1 is returned, and errno is set appropriately:
- *
- *   EAGAIN or EWOULDBLOCK
- *     The socket is marked non-blocking and the requested operation
- *     would block.
- *   EBADF
- *     An invalid descriptor was specified.
- *   ECONNRESET
- *     Connection reset by peer.
- *   EDESTADDRREQ
- *     The socket is not connection-mode, and no peer address is set.
- *   EFAULT
- *      An invalid user space address was specified for a parameter.
- *   EINTR
- *      A signal occurred before any data was transmitted.
- *   EINVAL
- *      Invalid argument passed.
- *   EISCONN
- *     The connection-mode socket was connected already but a recipient
- *     was specified. (Now either this error is returned, or the recipient
- *     specification is ignored.)
- *   EMSGSIZE
- *     The socket type requires that message be sent atomically, and the
- *     size of the message to be sent made this impossible.
- *   ENOBUFS
- *     The output queue for a network interface was full. This generally
- *     indicates that the interface has stopped sending, but may be
- *     caused by transient congestion.
- *   ENOMEM
- *     No memory available.
- *   ENOTCONN
- *     The socket is not connected, and no target has been given.
- *   ENOTSOCK
- *     The argument s is not a socket.
- *   EPIPE
- *     The local end has been shut down on a connection oriented socket.
- *     In this case the process will also receive a SIGPIPE unless
- *     MSG_NOSIGNAL is set.
+ *   Common logic of psock_tcp_send() and psock_tcp_send_iob().  Exactly
+ *   one of 'buf' and 'iob' is used:  If 'iob' is non-NULL, that chain is
+ *   linked into the write buffer instead of copying 'len' bytes from
+ *   'buf'.  The chain belongs to the network on success and remains with
+ *   the caller on failure.  'flags' holds the send() flags.
  *
  ****************************************************************************/
 
-ssize_t psock_tcp_send(FAR struct socket *psock, FAR const void *buf,
-                       size_t len)
+static ssize_t tcp_send_internal(FAR struct socket *psock,
+                                 FAR const void *buf, size_t len,
+                                 FAR struct iob_s *iob, int flags)
 {
   FAR struct tcp_conn_s *conn;
   FAR struct tcp_wrbuffer_s *wrb;
@@ -992,7 +1284,12 @@ ssize_t psock_tcp_send(FAR struct socket *psock, FAR const void *buf,
 
   /* Dump the incoming buffer */
 
-  BUF_DUMP("psock_tcp_send", buf, len);
+#ifdef CONFIG_NET_ZEROCOPY
+  if (iob == NULL)
+#endif
+    {
+      BUF_DUMP("psock_tcp_send", buf, len);
+    }
 
   /* Set the socket state to sending */
 
@@ -1005,6 +1302,30 @@ ssize_t psock_tcp_send(FAR struct socket *psock, FAR const void *buf,
        */
 
       net_lock();
+
+#ifdef CONFIG_NET_SOCKOPTS
+      /* Honor SO_SNDBUF:  Wait for space and queue no more than the limit
+       * permits.  A caller's I/O buffer chain cannot be split, so it is
+       * queued in its entirety once there is any space at all.
+       */
+
+      if (conn->sndbufs > 0)
+        {
+          ssize_t space = psock_sndbuf_wait(psock, conn);
+
+          if (space < 0)
+            {
+              ret = space;
+              goto errout_with_lock;
+            }
+
+          if (iob == NULL && len > (size_t)space)
+            {
+              len = space;
+            }
+        }
+#endif
+
       if (_SS_ISNONBLOCK(psock->s_flags))
         {
           wrb = tcp_wrbuffer_tryalloc();
@@ -1057,6 +1378,20 @@ ssize_t psock_tcp_send(FAR struct socket *psock, FAR const void *buf,
        * buffer space if the socket was opened non-blocking.
        */
 
+#ifdef CONFIG_NET_ZEROCOPY
+      if (iob != NULL)
+        {
+          /* No copy:  The caller's chain replaces the empty I/O buffer
+           * that came with the write buffer.
+           */
+
+          iob_free_chain(TCP_WBIOB(wrb), IOBUSER_NET_TCP_WRITEBUFFER);
+          TCP_WBIOB(wrb) = iob;
+          iob            = NULL;
+          result         = len;
+        }
+      else
+#endif
       if (_SS_ISNONBLOCK(psock->s_flags))
         {
           /* The return value from TCP_WBTRYCOPYIN is either OK or
@@ -1109,6 +1444,19 @@ ssize_t psock_tcp_send(FAR struct socket *psock, FAR const void *buf,
 
       TCP_WBDUMP("I/O buffer chain", wrb, TCP_WBPKTLEN(wrb), 0);
 
+#ifdef CONFIG_NET_TCP_NAGLE
+      /* MSG_MORE holds back a partial segment until the next send() */
+
+      if ((flags & MSG_MORE) != 0)
+        {
+          conn->nagle |= TCP_NAGLE_MORE;
+        }
+      else
+        {
+          conn->nagle &= ~TCP_NAGLE_MORE;
+        }
+#endif
+
       /* psock_send_eventhandler() will send data in FIFO order from the
        * conn->write_q
        */
@@ -1143,6 +1491,15 @@ ssize_t psock_tcp_send(FAR struct socket *psock, FAR const void *buf,
       goto errout;
     }
 
+#ifdef CONFIG_NET_ZEROCOPY
+  /* An empty chain was never queued */
+
+  if (iob != NULL)
+    {
+      iob_free_chain(iob, IOBUSER_NET_TCP_WRITEBUFFER);
+    }
+#endif
+
   /* Return the number of bytes actually sent */
 
   return result;
@@ -1157,6 +1514,100 @@ errout:
   return ret;
 }
 
+/****************************************************************************
+ * Public Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: psock_tcp_send
+ *
+ * Description:
+ *   psock_tcp_send() call may be used only when the TCP socket is in a
+ *   connected state (so that the intended recipient is known).
+ *
+ * Input Parameters:
+ *   psock    An instance of the internal socket structure.
+ *   buf      Data to send
+ *   len      Length of data to send
+ *   flags    Send flags.  MSG_MORE is honored with CONFIG_NET_TCP_NAGLE.
+ *
+ * Returned Value:
+ *   On success, returns the number of characters sent.  On  error,
+ *   -1 is returned, and errno is set appropriately:
+ *
+ *   EAGAIN or EWOULDBLOCK
+ *     The socket is marked non-blocking and the requested operation
+ *     would block.
+ *   EBADF
+ *     An invalid descriptor was specified.
+ *   ECONNRESET
+ *     Connection reset by peer.
+ *   EDESTADDRREQ
+ *     The socket is not connection-mode, and no peer address is set.
+ *   EFAULT
+ *      An invalid user space address was specified for a parameter.
+ *   EINTR
+ *      A signal occurred before any data was transmitted.
+ *   EINVAL
+ *      Invalid argument passed.
+ *   EISCONN
+ *     The connection-mode socket was connected already but a recipient
+ *     was specified. (Now either this error is returned, or the recipient
+ *     specification is ignored.)
+ *   EMSGSIZE
+ *     The socket type requires that message be sent atomically, and the
+ *     size of the message to be sent made this impossible.
+ *   ENOBUFS
+ *     The output queue for a network interface was full. This generally
+ *     indicates that the interface has stopped sending, but may be
+ *     caused by transient congestion.
+ *   ENOMEM
+ *     No memory available.
+ *   ENOTCONN
+ *     The socket is not connected, and no target has been given.
+ *   ENOTSOCK
+ *     The argument s is not a socket.
+ *   EPIPE
+ *     The local end has been shut down on a connection oriented socket.
+ *     In this case the process will also receive a SIGPIPE unless
+ *     MSG_NOSIGNAL is set.
+ *
+ ****************************************************************************/
+
+ssize_t psock_tcp_send(FAR struct socket *psock, FAR const void *buf,
+                       size_t len, int flags)
+{
+  return tcp_send_internal(psock, buf, len, NULL, flags);
+}
+
+/****************************************************************************
+ * Name: psock_tcp_send_iob
+ *
+ * Description:
+ *   Queue an I/O buffer chain for transmission on a connected TCP socket
+ *   without copying it.  The chain is linked directly into a write buffer.
+ *
+ * Input Parameters:
+ *   psock    An instance of the internal socket structure.
+ *   iob      The I/O buffer chain holding the data to send.  On success
+ *            the network takes ownership of the chain; on failure it
+ *            remains with the caller.
+ *
+ * Returned Value:
+ *   On success, returns the number of bytes queued (the io_pktlen of the
+ *   chain).  On failure, a negated errno value is returned as for
+ *   psock_tcp_send().
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_NET_ZEROCOPY
+ssize_t psock_tcp_send_iob(FAR struct socket *psock, FAR struct iob_s *iob)
+{
+  DEBUGASSERT(iob != NULL);
+  return tcp_send_internal(psock, NULL, iob->io_pktlen, iob, 0);
+}
+#endif
+
 /****************************************************************************
  * Name: psock_tcp_cansend
  *
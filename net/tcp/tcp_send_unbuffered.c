@@ -557,6 +557,10 @@ end_wait:
 static inline void send_txnotify(FAR struct socket *psock,
                                  FAR struct tcp_conn_s *conn)
 {
+  /* Make sure that the next poll of the device visits this connection */
+
+  tcp_txready(conn);
+
 #ifdef CONFIG_NET_IPv4
 #ifdef CONFIG_NET_IPv6
   /* If both IPv4 and IPv6 support are enabled, then we will need to select
@@ -600,6 +604,7 @@ static inline void send_txnotify(FAR struct socket *psock,
  *   psock    An instance of the internal socket structure.
  *   buf      Data to send
  *   len      Length of data to send
+ *   flags    Send flags (unused)
  *
  * Returned Value:
  *   On success, returns the number of characters sent.  On  error,
@@ -645,7 +650,7 @@ static inline void send_txnotify(FAR struct socket *psock,
  ****************************************************************************/
 
 ssize_t psock_tcp_send(FAR struct socket *psock,
-                       FAR const void *buf, size_t len)
+                       FAR const void *buf, size_t len, int flags)
 {
   FAR struct tcp_conn_s *conn;
   struct send_s state;
@@ -46,6 +46,7 @@
 #include <stdint.h>
 #include <debug.h>
 
+#include <nuttx/random.h>
 #include <nuttx/net/netconfig.h>
 #include <nuttx/net/netdev.h>
 
@@ -132,7 +133,8 @@ uint32_t tcp_addsequence(FAR uint8_t *seqno, uint16_t len)
  *
  * Description:
  *   Set the (initial) the TCP/IP sequence number when a TCP connection is
- *   established.
+ *   established.  With the per-CPU random generator, the initial sequence
+ *   number is random; otherwise it comes from a global counter.
  *
  * Assumptions:
  *   This function must be called with the network locked if seqno refers
@@ -142,7 +144,14 @@ uint32_t tcp_addsequence(FAR uint8_t *seqno, uint16_t len)
 
 void tcp_initsequence(FAR uint8_t *seqno)
 {
+#ifdef CONFIG_CRYPTO_RANDOM_POOL_FAST
+  uint32_t isn;
+
+  getrandom(&isn, sizeof(isn));
+  tcp_setsequence(seqno, isn);
+#else
   tcp_setsequence(seqno, g_tcpsequence);
+#endif
 }
 
 /****************************************************************************
@@ -51,6 +51,7 @@
 #include <nuttx/net/net.h>
 #include <nuttx/net/tcp.h>
 
+#include "netdev/netdev.h"
 #include "socket/socket.h"
 #include "utils/utils.h"
 #include "tcp/tcp.h"
@@ -88,8 +89,9 @@
 int tcp_setsockopt(FAR struct socket *psock, int option,
                    FAR const void *value, socklen_t value_len)
 {
-#ifdef CONFIG_NET_TCP_KEEPALIVE
-  /* Keep alive options are the only TCP protocol socket option currently
+#if defined(CONFIG_NET_TCP_KEEPALIVE) || defined(CONFIG_NET_TCP_NAGLE)
+  /* Keep alive options and the options that control the coalescing of
+   * small segments are the only TCP protocol socket options currently
    * supported.
    */
 
@@ -114,6 +116,7 @@ int tcp_setsockopt(FAR struct socket *psock, int option,
 
   switch (option)
     {
+#ifdef CONFIG_NET_TCP_KEEPALIVE
       /* Handle the SO_KEEPALIVE socket-level option.
        *
        * NOTE: SO_KEEPALIVE is not really a socket-level option; it is a
@@ -148,11 +151,53 @@ int tcp_setsockopt(FAR struct socket *psock, int option,
           }
         break;
 
+#endif /* CONFIG_NET_TCP_KEEPALIVE */
+
       case TCP_NODELAY: /* Avoid coalescing of small segments. */
+#ifdef CONFIG_NET_TCP_NAGLE
+      case TCP_CORK:    /* Hold back partial segments */
+        if (value_len != sizeof(int))
+          {
+            ret = -EDOM;
+          }
+        else
+          {
+            int enable = *(FAR int *)value;
+            uint8_t bit = option == TCP_NODELAY ? TCP_NAGLE_NODELAY :
+                                                  TCP_NAGLE_CORK;
+
+            net_lock();
+            if (enable != 0)
+              {
+                conn->nagle |= bit;
+              }
+            else
+              {
+                conn->nagle &= ~bit;
+              }
+
+            /* Setting TCP_NODELAY or removing the cork releases any data
+             * that has been held back.
+             */
+
+            if ((conn->nagle & TCP_NAGLE_CORK) == 0 &&
+                (option == TCP_CORK || enable != 0) &&
+                !sq_empty(&conn->write_q) && conn->dev != NULL)
+              {
+                tcp_txready(conn);
+                netdev_txnotify_dev(conn->dev);
+              }
+
+            net_unlock();
+            ret = OK;
+          }
+#else
         nerr("ERROR: TCP_NODELAY not supported\n");
         ret = -ENOSYS;
+#endif
         break;
 
+#ifdef CONFIG_NET_TCP_KEEPALIVE
       case TCP_KEEPIDLE:  /* Start keepalives after this IDLE period */
         if (value_len != sizeof(struct timeval))
           {
@@ -251,6 +296,7 @@ int tcp_setsockopt(FAR struct socket *psock, int option,
               }
           }
         break;
+#endif /* CONFIG_NET_TCP_KEEPALIVE */
 
       default:
         nerr("ERROR: Unrecognized TCP option: %d\n", option);
@@ -261,7 +307,7 @@ int tcp_setsockopt(FAR struct socket *psock, int option,
   return ret;
 #else
   return -ENOPROTOOPT;
-#endif /* CONFIG_NET_TCP_KEEPALIVE */
+#endif /* CONFIG_NET_TCP_KEEPALIVE || CONFIG_NET_TCP_NAGLE */
 }
 
 #endif /* CONFIG_NET_TCPPROTO_OPTIONS */
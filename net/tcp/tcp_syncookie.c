@@ -0,0 +1,342 @@
+/****************************************************************************
+ * net/tcp/tcp_syncookie.c
+ *
+ *   Copyright (C) 2020 Gregory Nutt. All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in
+ *    the documentation and/or other materials provided with the
+ *    distribution.
+ * 3. Neither the name NuttX nor the names of its contributors may be
+ *    used to endorse or promote products derived from this software
+ *    without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+ * FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE
+ * COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+ * INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,
+ * BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS
+ * OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED
+ * AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ * LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN
+ * ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ *
+ ****************************************************************************/
+
+/* A SYN cookie lets the listener answer a SYN without allocating a
+ * connection structure when all of them are in use.  Everything needed to
+ * create the connection later is encoded in the initial sequence number of
+ * the SYNACK and comes back, plus one, in the acknowledgement number of the
+ * peer's ACK:
+ *
+ *   Bits 27-31: A counter that advances every 64 seconds
+ *   Bits  3-26: A keyed hash of the addresses, ports, the peer's ISN and
+ *               the counter
+ *   Bits  0-2:  An index into g_syncookie_mss[]
+ *
+ * A cookie is accepted for one to two counter periods.  TCP options other
+ * than the MSS (i.e. window scaling) are lost for such connections.
+ */
+
+/****************************************************************************
+ * Included Files
+ ****************************************************************************/
+
+#include <nuttx/config.h>
+#if defined(CONFIG_NET) && defined(CONFIG_NET_TCP) && \
+    defined(CONFIG_NET_TCP_SYNCOOKIES)
+
+#include <stdint.h>
+#include <stdbool.h>
+#include <errno.h>
+#include <debug.h>
+
+#ifdef CONFIG_CRYPTO_RANDOM_POOL
+#  include <sys/random.h>
+#endif
+
+#include <nuttx/clock.h>
+#include <nuttx/net/netconfig.h>
+#include <nuttx/net/netdev.h>
+#include <nuttx/net/ip.h>
+#include <nuttx/net/tcp.h>
+
+#include "devif/devif.h"
+#include "tcp/tcp.h"
+
+/****************************************************************************
+ * Pre-processor Definitions
+ ****************************************************************************/
+
+#define IPv4BUF ((FAR struct ipv4_hdr_s *)&dev->d_buf[NET_LL_HDRLEN(dev)])
+#define IPv6BUF ((FAR struct ipv6_hdr_s *)&dev->d_buf[NET_LL_HDRLEN(dev)])
+
+#define COOKIE_PERIOD      SEC2TICK(64)
+#define COOKIE_COUNT_SHIFT 27
+#define COOKIE_COUNT_MASK  0x1f
+#define COOKIE_HASH_MASK   0x07fffff8
+#define COOKIE_MSS_MASK    0x00000007
+
+/****************************************************************************
+ * Private Data
+ ****************************************************************************/
+
+/* MSS values that can be encoded, smallest first */
+
+static const uint16_t g_syncookie_mss[] =
+{
+  536, 1220, 1440, 1460
+};
+
+#define NCOOKIE_MSS (sizeof(g_syncookie_mss) / sizeof(uint16_t))
+
+static uint32_t g_syncookie_secret[4];
+static bool g_syncookie_seeded;
+
+/****************************************************************************
+ * Private Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: tcp_syncookie_mix
+ *
+ * Description:
+ *   Mix one word into the running hash.
+ *
+ ****************************************************************************/
+
+static inline uint32_t tcp_syncookie_mix(uint32_t hash, uint32_t value)
+{
+  hash ^= value;
+  hash *= 0x9e3779b1;
+  return hash ^ (hash >> 15);
+}
+
+/****************************************************************************
+ * Name: tcp_syncookie_hash
+ *
+ * Description:
+ *   Compute the keyed hash part of the cookie for the segment in the device
+ *   buffer.
+ *
+ ****************************************************************************/
+
+static uint32_t tcp_syncookie_hash(FAR struct net_driver_s *dev,
+                                   FAR struct tcp_hdr_s *tcp,
+                                   uint32_t isn, uint32_t count)
+{
+  uint32_t hash;
+  int i;
+
+  if (!g_syncookie_seeded)
+    {
+#ifdef CONFIG_CRYPTO_RANDOM_POOL
+      getrandom(g_syncookie_secret, sizeof(g_syncookie_secret));
+#else
+      /* Without a random pool the best we have is the boot time and the
+       * device address, which makes the cookies guessable to an attacker
+       * who knows both.
+       */
+
+      g_syncookie_secret[0] = clock_systimer();
+      g_syncookie_secret[1] = (uint32_t)(uintptr_t)dev;
+      g_syncookie_secret[2] = tcp_getsequence(tcp->seqno);
+      g_syncookie_secret[3] = 0x5a3c96e1;
+#endif
+      g_syncookie_seeded = true;
+    }
+
+  hash = g_syncookie_secret[0];
+  for (i = 1; i < 4; i++)
+    {
+      hash = tcp_syncookie_mix(hash, g_syncookie_secret[i]);
+    }
+
+#ifdef CONFIG_NET_IPv6
+#ifdef CONFIG_NET_IPv4
+  if (IFF_IS_IPv6(dev->d_flags))
+#endif
+    {
+      FAR struct ipv6_hdr_s *ipv6 = IPv6BUF;
+
+      for (i = 0; i < 8; i += 2)
+        {
+          hash = tcp_syncookie_mix(hash,
+                   ((uint32_t)ipv6->srcipaddr[i] << 16) |
+                   ipv6->srcipaddr[i + 1]);
+          hash = tcp_syncookie_mix(hash,
+                   ((uint32_t)ipv6->destipaddr[i] << 16) |
+                   ipv6->destipaddr[i + 1]);
+        }
+    }
+#endif /* CONFIG_NET_IPv6 */
+
+#ifdef CONFIG_NET_IPv4
+#ifdef CONFIG_NET_IPv6
+  else
+#endif
+    {
+      FAR struct ipv4_hdr_s *ipv4 = IPv4BUF;
+
+      hash = tcp_syncookie_mix(hash,
+                               net_ip4addr_conv32(ipv4->srcipaddr));
+      hash = tcp_syncookie_mix(hash,
+                               net_ip4addr_conv32(ipv4->destipaddr));
+    }
+#endif /* CONFIG_NET_IPv4 */
+
+  hash = tcp_syncookie_mix(hash, ((uint32_t)tcp->srcport << 16) |
+                                 tcp->destport);
+  hash = tcp_syncookie_mix(hash, isn);
+  hash = tcp_syncookie_mix(hash, count);
+
+  hash ^= hash >> 16;
+  hash *= 0x85ebca6b;
+  hash ^= hash >> 13;
+  return hash;
+}
+
+/****************************************************************************
+ * Name: tcp_syncookie_peermss
+ *
+ * Description:
+ *   Return the MSS option of the SYN, or the default MSS if there is none.
+ *
+ ****************************************************************************/
+
+static uint16_t tcp_syncookie_peermss(FAR struct tcp_hdr_s *tcp)
+{
+  FAR uint8_t *opt = (FAR uint8_t *)tcp + TCP_HDRLEN;
+  int optlen = (((tcp->tcpoffset >> 4) << 2) - TCP_HDRLEN);
+  int i = 0;
+
+  while (i < optlen)
+    {
+      if (opt[i] == TCP_OPT_END)
+        {
+          break;
+        }
+      else if (opt[i] == TCP_OPT_NOOP)
+        {
+          i++;
+        }
+      else if (i + 1 >= optlen || opt[i + 1] == 0)
+        {
+          break;
+        }
+      else if (opt[i] == TCP_OPT_MSS && opt[i + 1] == TCP_OPT_MSS_LEN &&
+               i + TCP_OPT_MSS_LEN <= optlen)
+        {
+          return ((uint16_t)opt[i + 2] << 8) | opt[i + 3];
+        }
+      else
+        {
+          i += opt[i + 1];
+        }
+    }
+
+  return g_syncookie_mss[0];
+}
+
+/****************************************************************************
+ * Public Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: tcp_syncookie
+ *
+ * Description:
+ *   Compute the SYN cookie for the SYN in the device buffer.
+ *
+ * Input Parameters:
+ *   dev - The device driver structure holding the received SYN
+ *   tcp - The TCP header of the SYN
+ *   mss - Location to return the MSS encoded in the cookie
+ *
+ * Returned Value:
+ *   The cookie, to be used as our initial sequence number.
+ *
+ * Assumptions:
+ *   This function is called from network logic with the network locked.
+ *
+ ****************************************************************************/
+
+uint32_t tcp_syncookie(FAR struct net_driver_s *dev,
+                       FAR struct tcp_hdr_s *tcp, FAR uint16_t *mss)
+{
+  uint32_t count = (clock_systimer() / COOKIE_PERIOD) & COOKIE_COUNT_MASK;
+  uint16_t peermss = tcp_syncookie_peermss(tcp);
+  uint32_t index = NCOOKIE_MSS - 1;
+
+  /* Encode the largest MSS that the peer accepts */
+
+  while (index > 0 && g_syncookie_mss[index] > peermss)
+    {
+      index--;
+    }
+
+  *mss = g_syncookie_mss[index];
+
+  return (count << COOKIE_COUNT_SHIFT) |
+         (tcp_syncookie_hash(dev, tcp, tcp_getsequence(tcp->seqno), count) &
+          COOKIE_HASH_MASK) |
+         index;
+}
+
+/****************************************************************************
+ * Name: tcp_syncookie_check
+ *
+ * Description:
+ *   Check whether the ACK in the device buffer acknowledges a SYNACK that
+ *   was sent with a SYN cookie.
+ *
+ * Input Parameters:
+ *   dev - The device driver structure holding the received ACK
+ *   tcp - The TCP header of the ACK
+ *   mss - Location to return the MSS encoded in the cookie
+ *
+ * Returned Value:
+ *   OK if the cookie is valid and recent; -EINVAL otherwise.
+ *
+ * Assumptions:
+ *   This function is called from network logic with the network locked.
+ *
+ ****************************************************************************/
+
+int tcp_syncookie_check(FAR struct net_driver_s *dev,
+                        FAR struct tcp_hdr_s *tcp, FAR uint16_t *mss)
+{
+  uint32_t cookie = tcp_getsequence(tcp->ackno) - 1;
+  uint32_t isn = tcp_getsequence(tcp->seqno) - 1;
+  uint32_t count = cookie >> COOKIE_COUNT_SHIFT;
+  uint32_t now = (clock_systimer() / COOKIE_PERIOD) & COOKIE_COUNT_MASK;
+  uint32_t index = cookie & COOKIE_MSS_MASK;
+
+  /* The cookie must be from this period or the one before */
+
+  if (count != now && count != ((now - 1) & COOKIE_COUNT_MASK))
+    {
+      return -EINVAL;
+    }
+
+  if (index >= NCOOKIE_MSS ||
+      (cookie & COOKIE_HASH_MASK) !=
+      (tcp_syncookie_hash(dev, tcp, isn, count) & COOKIE_HASH_MASK))
+    {
+      return -EINVAL;
+    }
+
+  *mss = g_syncookie_mss[index];
+  return OK;
+}
+
+#endif /* CONFIG_NET && CONFIG_NET_TCP && CONFIG_NET_TCP_SYNCOOKIES */
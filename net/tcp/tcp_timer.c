@@ -86,6 +86,9 @@
 void tcp_timer(FAR struct net_driver_s *dev, FAR struct tcp_conn_s *conn,
                int hsec)
 {
+#ifdef CONFIG_NET_TCP_CC
+  unsigned int backoff;
+#endif
   uint16_t result;
   uint8_t hdrlen;
 
@@ -293,7 +296,15 @@ void tcp_timer(FAR struct net_driver_s *dev, FAR struct tcp_conn_s *conn,
 
               /* Exponential backoff. */
 
+#ifdef CONFIG_NET_TCP_CC
+              /* Back off from the measured RTO (RFC 6298, 5.5) */
+
+              backoff = (unsigned int)conn->rto <<
+                        (conn->nrtx > 4 ? 4: conn->nrtx);
+              conn->timer = backoff > UINT8_MAX ? UINT8_MAX : backoff;
+#else
               conn->timer = TCP_RTO << (conn->nrtx > 4 ? 4: conn->nrtx);
+#endif
               (conn->nrtx)++;
 
               /* Ok, so we need to retransmit. We do this differently
@@ -307,6 +318,7 @@ void tcp_timer(FAR struct net_driver_s *dev, FAR struct tcp_conn_s *conn,
 #ifdef CONFIG_NET_STATISTICS
               g_netstats.tcp.rexmit++;
 #endif
+              TCP_CONNSTATS(conn, rexmit, 1);
               switch (conn->tcpstateflags & TCP_STATE_MASK)
                 {
                   case TCP_SYN_RCVD:
@@ -57,6 +57,7 @@
 #include <nuttx/semaphore.h>
 #include <nuttx/net/net.h>
 #include <nuttx/mm/iob.h>
+#include <nuttx/mm/mempool.h>
 
 #include "utils/utils.h"
 #include "tcp/tcp.h"
@@ -75,9 +76,9 @@ struct wrbuffer_s
 
   sem_t sem;
 
-  /* This is the list of available write buffers */
+  /* This is the pool of available write buffers */
 
-  sq_queue_t freebuffers;
+  struct mempool_s pool;
 
   /* These are the pre-allocated write buffers */
 
@@ -109,14 +110,12 @@ static struct wrbuffer_s g_wrbuffer;
 
 void tcp_wrbuffer_initialize(void)
 {
-  int i;
-
-  sq_init(&g_wrbuffer.freebuffers);
-
-  for (i = 0; i < CONFIG_NET_TCP_NWRBCHAINS; i++)
-    {
-      sq_addfirst(&g_wrbuffer.buffers[i].wb_node, &g_wrbuffer.freebuffers);
-    }
+  g_wrbuffer.pool.bsize    = sizeof(struct tcp_wrbuffer_s);
+  g_wrbuffer.pool.ninitial = CONFIG_NET_TCP_NWRBCHAINS;
+  g_wrbuffer.pool.nreserve = 0;
+  g_wrbuffer.pool.expand   = false;
+  g_wrbuffer.pool.ibase    = g_wrbuffer.buffers;
+  mempool_initialize(&g_wrbuffer.pool, "tcp_wrbuffer");
 
   nxsem_init(&g_wrbuffer.sem, 0, CONFIG_NET_TCP_NWRBCHAINS);
 }
@@ -155,7 +154,7 @@ FAR struct tcp_wrbuffer_s *tcp_wrbuffer_alloc(void)
    * for us in the free list.
    */
 
-  wrb = (FAR struct tcp_wrbuffer_s *)sq_remfirst(&g_wrbuffer.freebuffers);
+  wrb = (FAR struct tcp_wrbuffer_s *)mempool_alloc(&g_wrbuffer.pool);
   DEBUGASSERT(wrb);
   memset(wrb, 0, sizeof(struct tcp_wrbuffer_s));
 
@@ -220,7 +219,7 @@ FAR struct tcp_wrbuffer_s *tcp_wrbuffer_tryalloc(void)
    * for us in the free list.
    */
 
-  wrb = (FAR struct tcp_wrbuffer_s *)sq_remfirst(&g_wrbuffer.freebuffers);
+  wrb = (FAR struct tcp_wrbuffer_s *)mempool_alloc(&g_wrbuffer.pool);
   DEBUGASSERT(wrb);
   memset(wrb, 0, sizeof(struct tcp_wrbuffer_s));
 
@@ -260,12 +259,12 @@ void tcp_wrbuffer_release(FAR struct tcp_wrbuffer_s *wrb)
 
   if (wrb->wb_iob != NULL)
     {
-      iob_free_chain(wrb->wb_iob, IOBUSER_NET_TCP_WRITEBUFFER);
+      iob_free_batch(wrb->wb_iob, IOBUSER_NET_TCP_WRITEBUFFER);
     }
 
   /* Then free the write buffer structure */
 
-  sq_addlast(&wrb->wb_node, &g_wrbuffer.freebuffers);
+  mempool_free(&g_wrbuffer.pool, wrb);
   nxsem_post(&g_wrbuffer.sem);
 }
 
@@ -151,6 +151,14 @@ struct udp_conn_s
   sq_queue_t write_q;             /* Write buffering for UDP packets */
   FAR struct net_driver_s *dev;   /* Last device */
 #endif
+
+#ifdef CONFIG_NET_UDP_HASH
+  /* Next connection with the same local port hash.  A connection is on
+   * a hash chain whenever lport is non-zero.  See udp_conn.c.
+   */
+
+  FAR struct udp_conn_s *pnext;
+#endif
 };
 
 /* This structure supports UDP write buffering.  It is simply a container
@@ -238,6 +246,25 @@ void udp_free(FAR struct udp_conn_s *conn);
 FAR struct udp_conn_s *udp_active(FAR struct net_driver_s *dev,
                                   FAR struct udp_hdr_s *udp);
 
+/****************************************************************************
+ * Name: udp_local_active
+ *
+ * Description:
+ *   Find the connection that would receive a datagram with the provided
+ *   IP and UDP headers.  Unlike udp_active(), the headers need not reside
+ *   in a device packet buffer.
+ *
+ * Assumptions:
+ *   Called from network stack logic with the network stack locked
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_NET_UDP_LOCAL
+FAR struct udp_conn_s *udp_local_active(uint8_t domain,
+                                        FAR const void *iphdr,
+                                        FAR const struct udp_hdr_s *udp);
+#endif
+
 /****************************************************************************
  * Name: udp_nextconn
  *
@@ -597,6 +624,28 @@ FAR struct net_driver_s *udp_find_raddr_device(FAR struct udp_conn_s *conn);
 uint16_t udp_callback(FAR struct net_driver_s *dev,
                       FAR struct udp_conn_s *conn, uint16_t flags);
 
+/****************************************************************************
+ * Name: udp_readahead_queue
+ *
+ * Description:
+ *   Add a datagram, preceded by the sender's socket address, to the UDP
+ *   read-ahead queue of a connection.
+ *
+ * Returned Value:
+ *   buflen if the datagram was buffered; zero if it was dropped.
+ *
+ * Assumptions:
+ *   Called from network stack logic with the network stack locked
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_NET_UDP_READAHEAD
+uint16_t udp_readahead_queue(FAR struct udp_conn_s *conn,
+                             FAR const void *src_addr,
+                             uint8_t src_addr_size,
+                             FAR const uint8_t *buffer, uint16_t buflen);
+#endif
+
 /****************************************************************************
  * Name: psock_udp_send
  *
@@ -637,6 +686,48 @@ ssize_t psock_udp_sendto(FAR struct socket *psock, FAR const void *buf,
                          size_t len, int flags, FAR const struct sockaddr *to,
                          socklen_t tolen);
 
+/****************************************************************************
+ * Name: udp_local_sendto
+ *
+ * Description:
+ *   If the destination of a datagram is a UDP socket on this host, place
+ *   the datagram directly in the read-ahead queue of that socket, without
+ *   building a packet and passing it through a network device.
+ *
+ * Input Parameters:
+ *   psock    A pointer to a NuttX-specific, internal socket structure
+ *   buf      Data to send
+ *   len      Length of data to send
+ *   to       Address of recipient (NULL for a connected socket)
+ *
+ * Returned Value:
+ *   The number of bytes sent if the datagram was delivered locally.
+ *   -ENOENT if the datagram must take the normal send path.
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_NET_UDP_LOCAL
+ssize_t udp_local_sendto(FAR struct socket *psock, FAR const void *buf,
+                         size_t len, FAR const struct sockaddr *to);
+#endif
+
+/****************************************************************************
+ * Name: psock_udp_sendto_iob
+ *
+ * Description:
+ *   Queue an I/O buffer chain as one UDP datagram without copying it.  On
+ *   success the network takes ownership of the chain; on failure it
+ *   remains with the caller.  Only available with UDP write buffering.
+ *
+ ****************************************************************************/
+
+#if defined(CONFIG_NET_ZEROCOPY) && defined(CONFIG_NET_UDP_WRITE_BUFFERS)
+struct iob_s;
+ssize_t psock_udp_sendto_iob(FAR struct socket *psock, FAR struct iob_s *iob,
+                             int flags, FAR const struct sockaddr *to,
+                             socklen_t tolen);
+#endif
+
 /****************************************************************************
  * Name: udp_pollsetup
  *
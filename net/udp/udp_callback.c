@@ -80,8 +80,6 @@ static uint16_t udp_datahandler(FAR struct net_driver_s *dev,
                                 FAR struct udp_conn_s *conn,
                                 FAR uint8_t *buffer, uint16_t buflen)
 {
-  FAR struct iob_s *iob;
-  int ret;
 #ifdef CONFIG_NET_IPv6
   FAR struct sockaddr_in6 src_addr6 =
   {
@@ -99,17 +97,6 @@ static uint16_t udp_datahandler(FAR struct net_driver_s *dev,
   FAR void  *src_addr;
   uint8_t src_addr_size;
 
-  /* Allocate on I/O buffer to start the chain (throttling as necessary).
-   * We will not wait for an I/O buffer to become available in this context.
-   */
-
-  iob = iob_tryalloc(true, IOBUSER_NET_UDP_READAHEAD);
-  if (iob == NULL)
-    {
-      nerr("ERROR: Failed to create new I/O buffer chain\n");
-      return 0;
-    }
-
 #ifdef CONFIG_NET_IPv6
 #ifdef CONFIG_NET_IPv4
   if (IFF_IS_IPv6(dev->d_flags))
@@ -173,77 +160,7 @@ static uint16_t udp_datahandler(FAR struct net_driver_s *dev,
     }
 #endif /* CONFIG_NET_IPv4 */
 
-  /* Copy the src address info into the I/O buffer chain.  We will not wait
-   * for an I/O buffer to become available in this context.  It there is
-   * any failure to allocated, the entire I/O buffer chain will be discarded.
-   */
-
-  ret = iob_trycopyin(iob, (FAR const uint8_t *)&src_addr_size,
-                      sizeof(uint8_t), 0, true, IOBUSER_NET_UDP_READAHEAD);
-  if (ret < 0)
-    {
-      /* On a failure, iob_trycopyin return a negated error value but does
-       * not free any I/O buffers.
-       */
-
-      nerr("ERROR: Failed to add data to the I/O buffer chain: %d\n", ret);
-      iob_free_chain(iob, IOBUSER_NET_UDP_READAHEAD);
-      return 0;
-    }
-
-  ret = iob_trycopyin(iob, (FAR const uint8_t *)src_addr, src_addr_size,
-                      sizeof(uint8_t), true, IOBUSER_NET_UDP_READAHEAD);
-  if (ret < 0)
-    {
-      /* On a failure, iob_trycopyin return a negated error value but does
-       * not free any I/O buffers.
-       */
-
-      nerr("ERROR: Failed to add data to the I/O buffer chain: %d\n", ret);
-      iob_free_chain(iob, IOBUSER_NET_UDP_READAHEAD);
-      return 0;
-    }
-
-  if (buflen > 0)
-    {
-      /* Copy the new appdata into the I/O buffer chain */
-
-      ret = iob_trycopyin(iob, buffer, buflen,
-                          src_addr_size + sizeof(uint8_t), true,
-                          IOBUSER_NET_UDP_READAHEAD);
-      if (ret < 0)
-        {
-          /* On a failure, iob_trycopyin return a negated error value but
-           * does not free any I/O buffers.
-           */
-
-          nerr("ERROR: Failed to add data to the I/O buffer chain: %d\n",
-               ret);
-          iob_free_chain(iob, IOBUSER_NET_UDP_READAHEAD);
-          return 0;
-        }
-    }
-
-  /* Add the new I/O buffer chain to the tail of the read-ahead queue */
-
-  ret = iob_tryadd_queue(iob, &conn->readahead);
-  if (ret < 0)
-    {
-      nerr("ERROR: Failed to queue the I/O buffer chain: %d\n", ret);
-      iob_free_chain(iob, IOBUSER_NET_UDP_READAHEAD);
-      return 0;
-    }
-
-#ifdef CONFIG_UDP_NOTIFIER
-  /* Provided notification(s) that additional UDP read-ahead data is
-   * available.
-   */
-
-  udp_readahead_signal(conn);
-#endif
-
-  ninfo("Buffered %d bytes\n", buflen);
-  return buflen;
+  return udp_readahead_queue(conn, src_addr, src_addr_size, buffer, buflen);
 }
 #endif /* CONFIG_NET_UDP_READAHEAD */
 
@@ -342,4 +259,122 @@ uint16_t udp_callback(FAR struct net_driver_s *dev,
   return flags;
 }
 
+/****************************************************************************
+ * Name: udp_readahead_queue
+ *
+ * Description:
+ *   Add a datagram to the UDP read-ahead queue of a connection.  The
+ *   datagram is preceded by the length and the content of the sender's
+ *   socket address, the format that recvfrom() expects.
+ *
+ * Input Parameters:
+ *   conn          - The UDP connection that receives the datagram
+ *   src_addr      - The socket address of the sender
+ *   src_addr_size - The size of the sender's address
+ *   buffer        - The datagram payload
+ *   buflen        - The size of the datagram payload
+ *
+ * Returned Value:
+ *   The number of payload bytes buffered:  buflen on success or zero if
+ *   the datagram could not be buffered.
+ *
+ * Assumptions:
+ *   The network is locked.
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_NET_UDP_READAHEAD
+uint16_t udp_readahead_queue(FAR struct udp_conn_s *conn,
+                             FAR const void *src_addr,
+                             uint8_t src_addr_size,
+                             FAR const uint8_t *buffer, uint16_t buflen)
+{
+  FAR struct iob_s *iob;
+  int ret;
+
+  /* Allocate on I/O buffer to start the chain (throttling as necessary).
+   * We will not wait for an I/O buffer to become available in this context.
+   */
+
+  iob = iob_tryalloc(true, IOBUSER_NET_UDP_READAHEAD);
+  if (iob == NULL)
+    {
+      nerr("ERROR: Failed to create new I/O buffer chain\n");
+      return 0;
+    }
+
+  /* Copy the src address info into the I/O buffer chain.  We will not wait
+   * for an I/O buffer to become available in this context.  It there is
+   * any failure to allocated, the entire I/O buffer chain will be discarded.
+   */
+
+  ret = iob_trycopyin(iob, (FAR const uint8_t *)&src_addr_size,
+                      sizeof(uint8_t), 0, true, IOBUSER_NET_UDP_READAHEAD);
+  if (ret < 0)
+    {
+      /* On a failure, iob_trycopyin return a negated error value but does
+       * not free any I/O buffers.
+       */
+
+      nerr("ERROR: Failed to add data to the I/O buffer chain: %d\n", ret);
+      iob_free_chain(iob, IOBUSER_NET_UDP_READAHEAD);
+      return 0;
+    }
+
+  ret = iob_trycopyin(iob, (FAR const uint8_t *)src_addr, src_addr_size,
+                      sizeof(uint8_t), true, IOBUSER_NET_UDP_READAHEAD);
+  if (ret < 0)
+    {
+      /* On a failure, iob_trycopyin return a negated error value but does
+       * not free any I/O buffers.
+       */
+
+      nerr("ERROR: Failed to add data to the I/O buffer chain: %d\n", ret);
+      iob_free_chain(iob, IOBUSER_NET_UDP_READAHEAD);
+      return 0;
+    }
+
+  if (buflen > 0)
+    {
+      /* Copy the new appdata into the I/O buffer chain */
+
+      ret = iob_trycopyin(iob, buffer, buflen,
+                          src_addr_size + sizeof(uint8_t), true,
+                          IOBUSER_NET_UDP_READAHEAD);
+      if (ret < 0)
+        {
+          /* On a failure, iob_trycopyin return a negated error value but
+           * does not free any I/O buffers.
+           */
+
+          nerr("ERROR: Failed to add data to the I/O buffer chain: %d\n",
+               ret);
+          iob_free_chain(iob, IOBUSER_NET_UDP_READAHEAD);
+          return 0;
+        }
+    }
+
+  /* Add the new I/O buffer chain to the tail of the read-ahead queue */
+
+  ret = iob_tryadd_queue(iob, &conn->readahead);
+  if (ret < 0)
+    {
+      nerr("ERROR: Failed to queue the I/O buffer chain: %d\n", ret);
+      iob_free_chain(iob, IOBUSER_NET_UDP_READAHEAD);
+      return 0;
+    }
+
+#ifdef CONFIG_UDP_NOTIFIER
+  /* Provided notification(s) that additional UDP read-ahead data is
+   * available.
+   */
+
+  udp_readahead_signal(conn);
+#endif
+
+  ninfo("Buffered %d bytes\n", buflen);
+  return buflen;
+}
+#endif /* CONFIG_NET_UDP_READAHEAD */
+
 #endif /* CONFIG_NET && CONFIG_NET_UDP */
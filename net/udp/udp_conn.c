@@ -73,6 +73,25 @@
 #define IPv4BUF ((struct ipv4_hdr_s *)&dev->d_buf[NET_LL_HDRLEN(dev)])
 #define IPv6BUF ((struct ipv6_hdr_s *)&dev->d_buf[NET_LL_HDRLEN(dev)])
 
+/* Hash a local port number (network byte order) into a bucket.  Both bytes
+ * are folded in so that the result does not depend on the host byte order.
+ */
+
+#ifdef CONFIG_NET_UDP_HASH
+#  define UDP_PORTHASH(p) \
+     ((unsigned int)((p) ^ ((p) >> 8)) % CONFIG_NET_UDP_HASHSIZE)
+#endif
+
+/* Walk the candidates for an incoming datagram: either the one hash chain
+ * for its destination port or the whole active list.
+ */
+
+#ifdef CONFIG_NET_UDP_HASH
+#  define UDP_ACTIVE_NEXT(c) ((c)->pnext)
+#else
+#  define UDP_ACTIVE_NEXT(c) ((FAR struct udp_conn_s *)(c)->node.flink)
+#endif
+
 /****************************************************************************
  * Private Data
  ****************************************************************************/
@@ -94,6 +113,14 @@ static dq_queue_t g_active_udp_connections;
 
 static uint16_t g_last_udp_port;
 
+#ifdef CONFIG_NET_UDP_HASH
+/* Connections with a local port, hashed on lport.  Incoming datagrams and
+ * port selection only need to look at one chain.
+ */
+
+static FAR struct udp_conn_s *g_udp_port_hash[CONFIG_NET_UDP_HASHSIZE];
+#endif
+
 /****************************************************************************
  * Private Functions
  ****************************************************************************/
@@ -113,6 +140,56 @@ static inline void _udp_semtake(FAR sem_t *sem)
 
 #define _udp_semgive(sem) nxsem_post(sem)
 
+/****************************************************************************
+ * Name: udp_setlport
+ *
+ * Description:
+ *   Set (or clear, if zero) the local port of a connection, keeping the
+ *   local port hash chains in sync.  Once a connection is allocated, lport
+ *   must only be changed here.
+ *
+ ****************************************************************************/
+
+static void udp_setlport(FAR struct udp_conn_s *conn, uint16_t lport)
+{
+#ifdef CONFIG_NET_UDP_HASH
+  FAR struct udp_conn_s **link;
+
+  net_lock();
+  if (conn->lport != 0)
+    {
+      for (link = &g_udp_port_hash[UDP_PORTHASH(conn->lport)];
+           *link != NULL; link = &(*link)->pnext)
+        {
+          if (*link == conn)
+            {
+              *link = conn->pnext;
+              break;
+            }
+        }
+    }
+
+  conn->lport = lport;
+
+  if (lport != 0)
+    {
+      /* Add at the tail so that the chain is in binding order */
+
+      for (link = &g_udp_port_hash[UDP_PORTHASH(lport)];
+           *link != NULL; link = &(*link)->pnext)
+        {
+        }
+
+      conn->pnext = NULL;
+      *link       = conn;
+    }
+
+  net_unlock();
+#else
+  conn->lport = lport;
+#endif
+}
+
 /****************************************************************************
  * Name: udp_find_conn()
  *
@@ -129,13 +206,21 @@ static FAR struct udp_conn_s *udp_find_conn(uint8_t domain,
                                             uint16_t portno)
 {
   FAR struct udp_conn_s *conn;
+#ifndef CONFIG_NET_UDP_HASH
   int i;
+#endif
 
   /* Now search each connection structure. */
 
+#ifdef CONFIG_NET_UDP_HASH
+  for (conn = g_udp_port_hash[UDP_PORTHASH(portno)]; conn != NULL;
+       conn = conn->pnext)
+    {
+#else
   for (i = 0; i < CONFIG_NET_UDP_CONNS; i++)
     {
       conn = &g_udp_connections[i];
+#endif
 
       /* If the port local port number assigned to the connections matches
        * AND the IP address of the connection matches, then return a
@@ -245,15 +330,19 @@ static uint16_t udp_select_port(uint8_t domain, FAR union ip_binding_u *u)
 
 #ifdef CONFIG_NET_IPv4
 static inline FAR struct udp_conn_s *
-  udp_ipv4_active(FAR struct net_driver_s *dev, FAR struct udp_hdr_s *udp)
+  udp_ipv4_active(FAR const struct ipv4_hdr_s *ip,
+                  FAR const struct udp_hdr_s *udp)
 {
 #ifdef CONFIG_NET_BROADCAST
   static const in_addr_t bcast = INADDR_BROADCAST;
 #endif
-  FAR struct ipv4_hdr_s *ip = IPv4BUF;
   FAR struct udp_conn_s *conn;
 
+#ifdef CONFIG_NET_UDP_HASH
+  conn = g_udp_port_hash[UDP_PORTHASH(udp->destport)];
+#else
   conn = (FAR struct udp_conn_s *)g_active_udp_connections.head;
+#endif
   while (conn)
     {
       /* If the local UDP port is non-zero, the connection is considered
@@ -364,9 +453,9 @@ static inline FAR struct udp_conn_s *
             }
         }
 
-      /* Look at the next active connection */
+      /* Look at the next candidate connection */
 
-      conn = (FAR struct udp_conn_s *)conn->node.flink;
+      conn = UDP_ACTIVE_NEXT(conn);
     }
 
   return conn;
@@ -387,12 +476,16 @@ static inline FAR struct udp_conn_s *
 
 #ifdef CONFIG_NET_IPv6
 static inline FAR struct udp_conn_s *
-  udp_ipv6_active(FAR struct net_driver_s *dev, FAR struct udp_hdr_s *udp)
+  udp_ipv6_active(FAR const struct ipv6_hdr_s *ip,
+                  FAR const struct udp_hdr_s *udp)
 {
-  FAR struct ipv6_hdr_s *ip = IPv6BUF;
   FAR struct udp_conn_s *conn;
 
+#ifdef CONFIG_NET_UDP_HASH
+  conn = g_udp_port_hash[UDP_PORTHASH(udp->destport)];
+#else
   conn = (FAR struct udp_conn_s *)g_active_udp_connections.head;
+#endif
   while (conn != NULL)
     {
       /* If the local UDP port is non-zero, the connection is considered
@@ -503,9 +596,9 @@ static inline FAR struct udp_conn_s *
             }
         }
 
-      /* Look at the next active connection */
+      /* Look at the next candidate connection */
 
-      conn = (FAR struct udp_conn_s *)conn->node.flink;
+      conn = UDP_ACTIVE_NEXT(conn);
     }
 
   return conn;
@@ -543,6 +636,10 @@ void udp_initialize(void)
       dq_addlast(&g_udp_connections[i].node, &g_free_udp_connections);
     }
 
+#ifdef CONFIG_NET_UDP_HASH
+  memset(g_udp_port_hash, 0, sizeof(g_udp_port_hash));
+#endif
+
   g_last_udp_port = 1024;
 }
 
@@ -611,7 +708,7 @@ void udp_free(FAR struct udp_conn_s *conn)
   DEBUGASSERT(conn->crefs == 0);
 
   _udp_semtake(&g_free_sem);
-  conn->lport = 0;
+  udp_setlport(conn, 0);
 
   /* Remove the connection from the active list */
 
@@ -659,7 +756,49 @@ FAR struct udp_conn_s *udp_active(FAR struct net_driver_s *dev,
   if (IFF_IS_IPv6(dev->d_flags))
 #endif
     {
-      return udp_ipv6_active(dev, udp);
+      return udp_ipv6_active(IPv6BUF, udp);
+    }
+#endif /* CONFIG_NET_IPv6 */
+
+#ifdef CONFIG_NET_IPv4
+#ifdef CONFIG_NET_IPv6
+  else
+#endif
+    {
+      return udp_ipv4_active(IPv4BUF, udp);
+    }
+#endif /* CONFIG_NET_IPv4 */
+}
+
+/****************************************************************************
+ * Name: udp_local_active
+ *
+ * Description:
+ *   Find the connection that would receive a datagram with the provided
+ *   IP and UDP headers if it were received by a network device.  Only the
+ *   addresses and the port numbers in the headers are used.
+ *
+ * Input Parameters:
+ *   domain - PF_INET if iphdr is an IPv4 header, PF_INET6 if IPv6
+ *   iphdr  - The IPv4 or IPv6 header of the datagram
+ *   udp    - The UDP header of the datagram
+ *
+ * Assumptions:
+ *   This function must be called with the network locked.
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_NET_UDP_LOCAL
+FAR struct udp_conn_s *
+  udp_local_active(uint8_t domain, FAR const void *iphdr,
+                   FAR const struct udp_hdr_s *udp)
+{
+#ifdef CONFIG_NET_IPv6
+#ifdef CONFIG_NET_IPv4
+  if (domain == PF_INET6)
+#endif
+    {
+      return udp_ipv6_active((FAR const struct ipv6_hdr_s *)iphdr, udp);
     }
 #endif /* CONFIG_NET_IPv6 */
 
@@ -668,10 +807,11 @@ FAR struct udp_conn_s *udp_active(FAR struct net_driver_s *dev,
   else
 #endif
     {
-      return udp_ipv4_active(dev, udp);
+      return udp_ipv4_active((FAR const struct ipv4_hdr_s *)iphdr, udp);
     }
 #endif /* CONFIG_NET_IPv4 */
 }
+#endif /* CONFIG_NET_UDP_LOCAL */
 
 /****************************************************************************
  * Name: udp_nextconn
@@ -762,7 +902,7 @@ int udp_bind(FAR struct udp_conn_s *conn, FAR const struct sockaddr *addr)
     {
       /* Yes.. Select any unused local port number */
 
-      conn->lport = htons(udp_select_port(conn->domain, &conn->u));
+      udp_setlport(conn, htons(udp_select_port(conn->domain, &conn->u)));
       ret         = OK;
     }
   else
@@ -777,7 +917,7 @@ int udp_bind(FAR struct udp_conn_s *conn, FAR const struct sockaddr *addr)
         {
           /* No.. then bind the socket to the port */
 
-          conn->lport = portno;
+          udp_setlport(conn, portno);
           ret         = OK;
         }
       else
@@ -830,7 +970,7 @@ int udp_connect(FAR struct udp_conn_s *conn, FAR const struct sockaddr *addr)
        * connection structure.
        */
 
-      conn->lport = htons(udp_select_port(conn->domain, &conn->u));
+      udp_setlport(conn, htons(udp_select_port(conn->domain, &conn->u)));
     }
 
   /* Is there a remote port (rport)? */
@@ -131,7 +131,13 @@ static int udp_input(FAR struct net_driver_s *dev, unsigned int iplen)
 
 #ifdef CONFIG_NET_UDP_CHECKSUMS
   chksum = udp->udpchksum;
-  if (chksum != 0)
+  if (NETDEV_HAS_FEATURE(dev, NETDEV_FEATURE_RXCSUM))
+    {
+      /* Already verified by the device */
+
+      chksum = 0;
+    }
+  else if (chksum != 0)
     {
 #ifdef CONFIG_NET_IPv6
 #ifdef CONFIG_NET_IPv4
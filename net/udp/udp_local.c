@@ -0,0 +1,345 @@
+/****************************************************************************
+ * net/udp/udp_local.c
+ *
+ *   Copyright (C) 2020 Gregory Nutt. All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in
+ *    the documentation and/or other materials provided with the
+ *    distribution.
+ * 3. Neither the name NuttX nor the names of its contributors may be
+ *    used to endorse or promote products derived from this software
+ *    without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+ * FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE
+ * COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+ * INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,
+ * BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS
+ * OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED
+ * AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ * LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN
+ * ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ *
+ ****************************************************************************/
+
+/****************************************************************************
+ * Included Files
+ ****************************************************************************/
+
+#include <nuttx/config.h>
+
+#include <sys/types.h>
+#include <sys/socket.h>
+#include <stdbool.h>
+#include <stdint.h>
+#include <assert.h>
+#include <errno.h>
+#include <debug.h>
+
+#include <netinet/in.h>
+
+#include <nuttx/net/net.h>
+#include <nuttx/net/netdev.h>
+#include <nuttx/net/netstats.h>
+#include <nuttx/net/ip.h>
+#include <nuttx/net/udp.h>
+
+#include "devif/devif.h"
+#include "netdev/netdev.h"
+#include "socket/socket.h"
+#include "inet/inet.h"
+#include "udp/udp.h"
+
+#ifdef CONFIG_NET_UDP_LOCAL
+
+/****************************************************************************
+ * Private Types
+ ****************************************************************************/
+
+/* The IP header used to look up the receiving connection */
+
+union udp_local_iphdr_u
+{
+#ifdef CONFIG_NET_IPv4
+  struct ipv4_hdr_s ipv4;
+#endif
+#ifdef CONFIG_NET_IPv6
+  struct ipv6_hdr_s ipv6;
+#endif
+};
+
+/* The address of the sender as it is saved in the read-ahead queue */
+
+union udp_local_from_u
+{
+#ifdef CONFIG_NET_IPv4
+  struct sockaddr_in in;
+#endif
+#ifdef CONFIG_NET_IPv6
+  struct sockaddr_in6 in6;
+#endif
+};
+
+/****************************************************************************
+ * Private Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: udp_local_ipv4 and udp_local_ipv6
+ *
+ * Description:
+ *   Set up the IP header and the sender's address for a datagram from conn
+ *   to a destination on this host.
+ *
+ * Returned Value:
+ *   The size of the sender's address if the destination address is
+ *   assigned to a network device on this host; zero otherwise.
+ *
+ * Assumptions:
+ *   The network is locked.
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_NET_IPv4
+static uint8_t udp_local_ipv4(FAR struct udp_conn_s *conn,
+                              FAR const struct sockaddr *to,
+                              FAR struct udp_hdr_s *udp,
+                              FAR struct ipv4_hdr_s *ipv4,
+                              FAR struct sockaddr_in *from)
+{
+  FAR struct net_driver_s *dev;
+  in_addr_t destipaddr;
+  in_addr_t srcipaddr;
+
+  if (to != NULL)
+    {
+      FAR const struct sockaddr_in *into =
+        (FAR const struct sockaddr_in *)to;
+
+      destipaddr    = into->sin_addr.s_addr;
+      udp->destport = into->sin_port;
+    }
+  else
+    {
+      destipaddr    = conn->u.ipv4.raddr;
+      udp->destport = conn->rport;
+    }
+
+  /* The destination must be the address of one of our devices */
+
+  dev = netdev_findby_lipv4addr(destipaddr);
+  if (dev == NULL || !net_ipv4addr_cmp(dev->d_ipaddr, destipaddr))
+    {
+      return 0;
+    }
+
+  /* The datagram would leave from the bound address or, if unbound, from
+   * the address of the device, i.e., the destination address.
+   */
+
+  if (net_ipv4addr_cmp(conn->u.ipv4.laddr, INADDR_ANY))
+    {
+      srcipaddr = destipaddr;
+    }
+  else
+    {
+      srcipaddr = conn->u.ipv4.laddr;
+    }
+
+  net_ipv4addr_hdrcopy(ipv4->destipaddr, &destipaddr);
+  net_ipv4addr_hdrcopy(ipv4->srcipaddr, &srcipaddr);
+
+  from->sin_family      = AF_INET;
+  from->sin_port        = conn->lport;
+  from->sin_addr.s_addr = srcipaddr;
+  return sizeof(struct sockaddr_in);
+}
+#endif /* CONFIG_NET_IPv4 */
+
+#ifdef CONFIG_NET_IPv6
+static uint8_t udp_local_ipv6(FAR struct udp_conn_s *conn,
+                              FAR const struct sockaddr *to,
+                              FAR struct udp_hdr_s *udp,
+                              FAR struct ipv6_hdr_s *ipv6,
+                              FAR struct sockaddr_in6 *from)
+{
+  FAR struct net_driver_s *dev;
+  FAR const uint16_t *destipaddr;
+  FAR const uint16_t *srcipaddr;
+
+  if (to != NULL)
+    {
+      FAR const struct sockaddr_in6 *into =
+        (FAR const struct sockaddr_in6 *)to;
+
+      destipaddr    = into->sin6_addr.s6_addr16;
+      udp->destport = into->sin6_port;
+    }
+  else
+    {
+      destipaddr    = conn->u.ipv6.raddr;
+      udp->destport = conn->rport;
+    }
+
+  /* The destination must be the address of one of our devices */
+
+  dev = netdev_findby_lipv6addr(destipaddr);
+  if (dev == NULL || !net_ipv6addr_cmp(dev->d_ipv6addr, destipaddr))
+    {
+      return 0;
+    }
+
+  /* The datagram would leave from the bound address or, if unbound, from
+   * the address of the device, i.e., the destination address.
+   */
+
+  if (net_ipv6addr_cmp(conn->u.ipv6.laddr, g_ipv6_unspecaddr))
+    {
+      srcipaddr = destipaddr;
+    }
+  else
+    {
+      srcipaddr = conn->u.ipv6.laddr;
+    }
+
+  net_ipv6addr_hdrcopy(ipv6->destipaddr, destipaddr);
+  net_ipv6addr_hdrcopy(ipv6->srcipaddr, srcipaddr);
+
+  from->sin6_family = AF_INET6;
+  from->sin6_port   = conn->lport;
+  net_ipv6addr_copy(from->sin6_addr.s6_addr16, srcipaddr);
+  return sizeof(struct sockaddr_in6);
+}
+#endif /* CONFIG_NET_IPv6 */
+
+/****************************************************************************
+ * Public Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: udp_local_sendto
+ *
+ * Description:
+ *   If the destination of a datagram is a UDP socket on this host, place
+ *   the datagram directly in the read-ahead queue of that socket, without
+ *   building a packet and passing it through a network device.
+ *
+ * Input Parameters:
+ *   psock    A pointer to a NuttX-specific, internal socket structure
+ *   buf      Data to send
+ *   len      Length of data to send
+ *   to       Address of recipient (NULL for a connected socket)
+ *
+ * Returned Value:
+ *   The number of bytes sent if the datagram was delivered locally.
+ *   -ENOENT if the datagram must take the normal send path.
+ *
+ ****************************************************************************/
+
+ssize_t udp_local_sendto(FAR struct socket *psock, FAR const void *buf,
+                         size_t len, FAR const struct sockaddr *to)
+{
+  FAR struct udp_conn_s *conn = (FAR struct udp_conn_s *)psock->s_conn;
+  FAR struct udp_conn_s *peer;
+  union udp_local_iphdr_u ip;
+  union udp_local_from_u from;
+  struct udp_hdr_s udp;
+  uint8_t fromlen;
+  ssize_t ret = -ENOENT;
+
+  DEBUGASSERT(conn != NULL);
+
+  /* Let the normal send path report misuse of the destination address and
+   * oversized datagrams.  A socket without a local port gets one on the
+   * normal path.
+   */
+
+  if ((to != NULL && _SS_ISCONNECTED(psock->s_flags)) ||
+      (to == NULL && !_SS_ISCONNECTED(psock->s_flags)) ||
+      len > UINT16_MAX || conn->lport == 0)
+    {
+      return -ENOENT;
+    }
+
+  net_lock();
+
+  udp.srcport = conn->lport;
+
+#ifdef CONFIG_NET_IPv4
+#ifdef CONFIG_NET_IPv6
+  if (conn->domain == PF_INET)
+#endif
+    {
+      fromlen = udp_local_ipv4(conn, to, &udp, &ip.ipv4, &from.in);
+    }
+#endif
+
+#ifdef CONFIG_NET_IPv6
+#ifdef CONFIG_NET_IPv4
+  else
+#endif
+    {
+      fromlen = udp_local_ipv6(conn, to, &udp, &ip.ipv6, &from.in6);
+    }
+#endif
+
+  if (fromlen == 0)
+    {
+      goto out;
+    }
+
+  /* Find the socket that would receive the datagram.  Mixing IPv4 and
+   * IPv6 sockets is left to the normal path.
+   */
+
+  peer = udp_local_active(conn->domain, &ip, &udp);
+  if (peer == NULL || peer->domain != conn->domain)
+    {
+      goto out;
+    }
+
+  ninfo("Local delivery of %u bytes to port %u\n",
+        (unsigned int)len, ntohs(udp.destport));
+
+  /* Place the datagram in the read-ahead queue.  As for any received
+   * datagram, it is dropped if there are no free I/O buffers.
+   */
+
+  if (udp_readahead_queue(peer, &from, fromlen, buf, len) < len)
+    {
+      nwarn("WARNING: Dropped %u bytes\n", (unsigned int)len);
+
+#ifdef CONFIG_NET_STATISTICS
+      g_netstats.udp.drop++;
+#endif
+    }
+  else
+    {
+#ifdef CONFIG_NET_STATISTICS
+      g_netstats.udp.sent++;
+      g_netstats.udp.recv++;
+#endif
+
+      /* Wake up any recvfrom() or poll() waiting on the receiving socket */
+
+      devif_conn_event(NULL, peer, UDP_READAHEAD, peer->list);
+    }
+
+  ret = len;
+
+out:
+  net_unlock();
+  return ret;
+}
+
+#endif /* CONFIG_NET_UDP_LOCAL */
@@ -115,7 +115,7 @@ static uint16_t udp_poll_eventhandler(FAR struct net_driver_s *dev,
 
       /* Check for data or connection availability events. */
 
-      if ((flags & UDP_NEWDATA) != 0)
+      if ((flags & (UDP_NEWDATA | UDP_READAHEAD)) != 0)
         {
           eventset |= (POLLIN & info->fds->events);
         }
@@ -355,7 +355,7 @@ int udp_pollsetup(FAR struct socket *psock, FAR struct pollfd *fds)
 
   if ((info->fds->events & POLLIN) != 0)
     {
-      cb->flags |= UDP_NEWDATA;
+      cb->flags |= (UDP_NEWDATA | UDP_READAHEAD);
     }
 
   if ((info->fds->events & (POLLHUP | POLLERR)) != 0)
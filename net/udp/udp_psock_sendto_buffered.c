@@ -532,40 +532,26 @@ static uint16_t sendto_eventhandler(FAR struct net_driver_s *dev,
 }
 
 /****************************************************************************
- * Public Functions
- ****************************************************************************/
-
-/****************************************************************************
- * Name: psock_udp_sendto
+ * Name: udp_sendto_internal
  *
  * Description:
- *   This function implements the UDP-specific logic of the standard
- *   sendto() socket operation.
- *
- * Input Parameters:
- *   psock    A pointer to a NuttX-specific, internal socket structure
- *   buf      Data to send
- *   len      Length of data to send
- *   flags    Send flags
- *   to       Address of recipient
- *   tolen    The length of the address structure
- *
- *   NOTE: All input parameters were verified by sendto() before this
- *   function was called.
- *
- * Returned Value:
- *   On success, returns the number of characters sent.  On  error,
- *   a negated errno value is returned.  See the description in
- *   net/socket/sendto.c for the list of appropriate return value.
+ *   Common logic of psock_udp_sendto() and psock_udp_sendto_iob().  If
+ *   'iob' is non-NULL, that chain is linked into the write buffer instead
+ *   of copying 'len' bytes from 'buf'.  The chain belongs to the network
+ *   on success and remains with the caller on failure.
  *
  ****************************************************************************/
 
-ssize_t psock_udp_sendto(FAR struct socket *psock, FAR const void *buf,
-                         size_t len, int flags, FAR const struct sockaddr *to,
-                         socklen_t tolen)
+static ssize_t udp_sendto_internal(FAR struct socket *psock,
+                                   FAR const void *buf, size_t len,
+                                   FAR const struct sockaddr *to,
+                                   socklen_t tolen, FAR struct iob_s *iob)
 {
   FAR struct udp_conn_s *conn;
   FAR struct udp_wrbuffer_s *wrb;
+#ifdef CONFIG_NET_ZEROCOPY
+  FAR struct iob_s *spare = NULL;
+#endif
   bool empty;
   int ret = OK;
 
@@ -581,7 +567,8 @@ ssize_t psock_udp_sendto(FAR struct socket *psock, FAR const void *buf,
        * already connected.
        */
 
-      return -EISCONN;
+      ret = -EISCONN;
+      goto errout;
     }
 
   /* Otherwise, if the socket is not connected, then a destination address
@@ -594,7 +581,8 @@ ssize_t psock_udp_sendto(FAR struct socket *psock, FAR const void *buf,
        * address is set.
        */
 
-      return -EDESTADDRREQ;
+      ret = -EDESTADDRREQ;
+      goto errout;
     }
 
   /* Get the underlying the UDP connection structure.  */
@@ -686,13 +674,19 @@ ssize_t psock_udp_sendto(FAR struct socket *psock, FAR const void *buf,
   if (ret < 0)
     {
       nerr("ERROR: Not reachable\n");
-      return -ENETUNREACH;
+      ret = -ENETUNREACH;
+      goto errout;
     }
 #endif /* CONFIG_NET_ARP_SEND || CONFIG_NET_ICMPv6_NEIGHBOR */
 
   /* Dump the incoming buffer */
 
-  BUF_DUMP("psock_udp_send", buf, len);
+#ifdef CONFIG_NET_ZEROCOPY
+  if (iob == NULL)
+#endif
+    {
+      BUF_DUMP("psock_udp_send", buf, len);
+    }
 
   /* Set the socket state to sending */
 
@@ -768,6 +762,20 @@ ssize_t psock_udp_sendto(FAR struct socket *psock, FAR const void *buf,
        * buffer space if the socket was opened non-blocking.
        */
 
+#ifdef CONFIG_NET_ZEROCOPY
+      if (iob != NULL)
+        {
+          /* No copy:  Swap in the caller's chain.  The empty I/O buffer
+           * that came with the write buffer is kept until the datagram is
+           * queued so that the chain can be handed back on a failure.
+           */
+
+          spare       = wrb->wb_iob;
+          wrb->wb_iob = iob;
+          iob         = NULL;
+        }
+      else
+#endif
       if (_SS_ISNONBLOCK(psock->s_flags))
         {
           ret = iob_trycopyin(wrb->wb_iob, (FAR uint8_t *)buf, len, 0, false,
@@ -822,6 +830,13 @@ ssize_t psock_udp_sendto(FAR struct socket *psock, FAR const void *buf,
             }
         }
 
+#ifdef CONFIG_NET_ZEROCOPY
+      if (spare != NULL)
+        {
+          iob_free(spare, IOBUSER_NET_UDP_WRITEBUFFER);
+        }
+#endif
+
       net_unlock();
     }
 
@@ -829,18 +844,124 @@ ssize_t psock_udp_sendto(FAR struct socket *psock, FAR const void *buf,
 
   psock->s_flags = _SS_SETSTATE(psock->s_flags, _SF_IDLE);
 
+#ifdef CONFIG_NET_ZEROCOPY
+  /* An empty chain was never queued */
+
+  if (iob != NULL)
+    {
+      iob_free_chain(iob, IOBUSER_NET_UDP_WRITEBUFFER);
+    }
+#endif
+
   /* Return the number of bytes that will be sent */
 
   return len;
 
 errout_with_wrb:
+#ifdef CONFIG_NET_ZEROCOPY
+  /* Hand the chain back to the caller */
+
+  if (spare != NULL)
+    {
+      wrb->wb_iob = spare;
+    }
+#endif
+
   udp_wrbuffer_release(wrb);
 
 errout_with_lock:
   net_unlock();
+
+errout:
   return ret;
 }
 
+/****************************************************************************
+ * Public Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: psock_udp_sendto
+ *
+ * Description:
+ *   This function implements the UDP-specific logic of the standard
+ *   sendto() socket operation.
+ *
+ * Input Parameters:
+ *   psock    A pointer to a NuttX-specific, internal socket structure
+ *   buf      Data to send
+ *   len      Length of data to send
+ *   flags    Send flags
+ *   to       Address of recipient
+ *   tolen    The length of the address structure
+ *
+ *   NOTE: All input parameters were verified by sendto() before this
+ *   function was called.
+ *
+ * Returned Value:
+ *   On success, returns the number of characters sent.  On  error,
+ *   a negated errno value is returned.  See the description in
+ *   net/socket/sendto.c for the list of appropriate return value.
+ *
+ ****************************************************************************/
+
+ssize_t psock_udp_sendto(FAR struct socket *psock, FAR const void *buf,
+                         size_t len, int flags, FAR const struct sockaddr *to,
+                         socklen_t tolen)
+{
+#ifdef CONFIG_NET_UDP_LOCAL
+  FAR struct udp_conn_s *conn = (FAR struct udp_conn_s *)psock->s_conn;
+  ssize_t ret;
+
+  /* Deliver datagrams for sockets on this host directly, unless earlier
+   * datagrams are still waiting in the write buffers.
+   */
+
+  if (sq_empty(&conn->write_q))
+    {
+      ret = udp_local_sendto(psock, buf, len, to);
+      if (ret != -ENOENT)
+        {
+          return ret;
+        }
+    }
+#endif
+
+  return udp_sendto_internal(psock, buf, len, to, tolen, NULL);
+}
+
+/****************************************************************************
+ * Name: psock_udp_sendto_iob
+ *
+ * Description:
+ *   Queue an I/O buffer chain as one UDP datagram without copying it.
+ *   The chain is linked directly into a write buffer.
+ *
+ * Input Parameters:
+ *   psock    A pointer to a NuttX-specific, internal socket structure
+ *   iob      The I/O buffer chain holding the datagram payload.  On
+ *            success the network takes ownership of the chain; on failure
+ *            it remains with the caller.
+ *   flags    Send flags
+ *   to       Address of recipient (NULL for a connected socket)
+ *   tolen    The length of the address structure
+ *
+ * Returned Value:
+ *   On success, returns the number of bytes queued.  On failure, a negated
+ *   errno value is returned as for psock_udp_sendto().
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_NET_ZEROCOPY
+ssize_t psock_udp_sendto_iob(FAR struct socket *psock, FAR struct iob_s *iob,
+                             int flags, FAR const struct sockaddr *to,
+                             socklen_t tolen)
+{
+  DEBUGASSERT(iob != NULL);
+  return udp_sendto_internal(psock, NULL, iob->io_pktlen, to, tolen, iob);
+}
+#endif
+
 /****************************************************************************
  * Name: psock_udp_cansend
  *
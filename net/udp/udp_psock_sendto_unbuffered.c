@@ -370,6 +370,16 @@ ssize_t psock_udp_sendto(FAR struct socket *psock, FAR const void *buf,
   conn = (FAR struct udp_conn_s *)psock->s_conn;
   DEBUGASSERT(conn);
 
+#ifdef CONFIG_NET_UDP_LOCAL
+  /* Deliver datagrams for sockets on this host directly */
+
+  ret = udp_local_sendto(psock, buf, len, to);
+  if (ret != -ENOENT)
+    {
+      return ret;
+    }
+#endif
+
 #if defined(CONFIG_NET_ARP_SEND) || defined(CONFIG_NET_ICMPv6_NEIGHBOR)
 #ifdef CONFIG_NET_ARP_SEND
   /* Assure the the IPv4 destination address maps to a valid MAC address in
@@ -161,10 +161,13 @@ void udp_send(FAR struct net_driver_s *dev, FAR struct udp_conn_s *conn)
           ipv4->len[0]      = (dev->d_len >> 8);
           ipv4->len[1]      = (dev->d_len & 0xff);
 
-          /* Calculate IP checksum. */
+          /* Calculate IP checksum (unless the device does it) */
 
           ipv4->ipchksum    = 0;
-          ipv4->ipchksum    = ~ipv4_chksum(dev);
+          if (!NETDEV_HAS_FEATURE(dev, NETDEV_FEATURE_TXCSUM))
+            {
+              ipv4->ipchksum = ~ipv4_chksum(dev);
+            }
 
 #ifdef CONFIG_NET_STATISTICS
           g_netstats.ipv4.sent++;
@@ -226,8 +229,13 @@ void udp_send(FAR struct net_driver_s *dev, FAR struct udp_conn_s *conn)
       udp->udpchksum   = 0;
 
 #ifdef CONFIG_NET_UDP_CHECKSUMS
-      /* Calculate UDP checksum. */
+      /* Calculate UDP checksum (unless the device does it) */
 
+      if (NETDEV_HAS_FEATURE(dev, NETDEV_FEATURE_TXCSUM))
+        {
+          /* Leave the checksum field zero for the device */
+        }
+      else
 #ifdef CONFIG_NET_IPv4
 #ifdef CONFIG_NET_IPv6
       if (conn->domain == PF_INET ||
@@ -248,7 +256,8 @@ void udp_send(FAR struct net_driver_s *dev, FAR struct udp_conn_s *conn)
         }
 #endif /* CONFIG_NET_IPv6 */
 
-      if (udp->udpchksum == 0)
+      if (udp->udpchksum == 0 &&
+          !NETDEV_HAS_FEATURE(dev, NETDEV_FEATURE_TXCSUM))
         {
           udp->udpchksum = 0xffff;
         }
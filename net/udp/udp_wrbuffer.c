@@ -56,6 +56,7 @@
 #include <nuttx/semaphore.h>
 #include <nuttx/net/net.h>
 #include <nuttx/mm/iob.h>
+#include <nuttx/mm/mempool.h>
 
 #include "utils/utils.h"
 #include "udp/udp.h"
@@ -72,9 +73,9 @@ struct wrbuffer_s
 
   sem_t sem;
 
-  /* This is the list of available write buffers */
+  /* This is the pool of available write buffers */
 
-  sq_queue_t freebuffers;
+  struct mempool_s pool;
 
   /* These are the pre-allocated write buffers */
 
@@ -106,14 +107,12 @@ static struct wrbuffer_s g_wrbuffer;
 
 void udp_wrbuffer_initialize(void)
 {
-  int i;
-
-  sq_init(&g_wrbuffer.freebuffers);
-
-  for (i = 0; i < CONFIG_NET_UDP_NWRBCHAINS; i++)
-    {
-      sq_addfirst(&g_wrbuffer.buffers[i].wb_node, &g_wrbuffer.freebuffers);
-    }
+  g_wrbuffer.pool.bsize    = sizeof(struct udp_wrbuffer_s);
+  g_wrbuffer.pool.ninitial = CONFIG_NET_UDP_NWRBCHAINS;
+  g_wrbuffer.pool.nreserve = 0;
+  g_wrbuffer.pool.expand   = false;
+  g_wrbuffer.pool.ibase    = g_wrbuffer.buffers;
+  mempool_initialize(&g_wrbuffer.pool, "udp_wrbuffer");
 
   nxsem_init(&g_wrbuffer.sem, 0, CONFIG_NET_UDP_NWRBCHAINS);
 }
@@ -152,7 +151,7 @@ FAR struct udp_wrbuffer_s *udp_wrbuffer_alloc(void)
    * for us in the free list.
    */
 
-  wrb = (FAR struct udp_wrbuffer_s *)sq_remfirst(&g_wrbuffer.freebuffers);
+  wrb = (FAR struct udp_wrbuffer_s *)mempool_alloc(&g_wrbuffer.pool);
   DEBUGASSERT(wrb);
   memset(wrb, 0, sizeof(struct udp_wrbuffer_s));
 
@@ -190,11 +189,11 @@ void udp_wrbuffer_release(FAR struct udp_wrbuffer_s *wrb)
    * buffer chain first, then the write buffer structure.
    */
 
-  iob_free_chain(wrb->wb_iob, IOBUSER_NET_UDP_WRITEBUFFER);
+  iob_free_batch(wrb->wb_iob, IOBUSER_NET_UDP_WRITEBUFFER);
 
   /* Then free the write buffer structure */
 
-  sq_addlast(&wrb->wb_node, &g_wrbuffer.freebuffers);
+  mempool_free(&g_wrbuffer.pool, wrb);
   nxsem_post(&g_wrbuffer.sem);
 }
 
@@ -49,6 +49,7 @@
 #include <errno.h>
 #include <assert.h>
 #include <debug.h>
+#include <queue.h>
 
 #include <arch/irq.h>
 
@@ -69,10 +70,29 @@
 #  define CONFIG_NET_USRSOCKDEV_NPOLLWAITERS 1
 #endif
 
+#ifndef CONFIG_NET_USRSOCK_NREQUESTS
+#  define CONFIG_NET_USRSOCK_NREQUESTS 1
+#endif
+
 /****************************************************************************
  * Private Types
  ****************************************************************************/
 
+/* One request passed to the daemon.  The request lives on the stack of the
+ * thread that issued it and stays linked in the device until the daemon
+ * acknowledges it (or the device is closed).
+ */
+
+struct usrsockdev_req_s
+{
+  FAR struct usrsockdev_req_s *flink; /* Supports a singly linked list */
+  FAR const struct iovec *iov;        /* Request buffers */
+  int     iovcnt;                     /* Number of request buffers */
+  size_t  pos;                        /* Reader position on request buffer */
+  uint8_t xid;                        /* Exchange id for which waiting ack */
+  sem_t   acksem;                     /* Request acknowledgment notification */
+};
+
 struct usrsockdev_s
 {
   sem_t   devsem;     /* Lock for device node */
@@ -80,13 +100,11 @@ struct usrsockdev_s
 
   struct
   {
-    FAR const struct iovec *iov; /* Pending request buffers */
-    int     iovcnt;              /* Number of request buffers */
-    size_t  pos;                 /* Reader position on request buffer */
-    sem_t   sem;                 /* Request semaphore (only one outstanding
-                                  * request) */
-    sem_t   acksem;              /* Request acknowledgment notification */
-    uint8_t ack_xid;             /* Exchange id for which waiting ack */
+    sq_queue_t readq;            /* Requests not yet fully read by daemon,
+                                  * the head is the one being read */
+    sq_queue_t ackq;             /* Requests read by daemon, waiting ack */
+    sem_t   sem;                 /* Request semaphore (limits requests in
+                                  * flight) */
     uint16_t nbusy;              /* Number of requests blocked from different
                                   * threads */
   } req;
@@ -340,6 +358,110 @@ static void usrsockdev_pollnotify(FAR struct usrsockdev_s *dev,
     }
 }
 
+/****************************************************************************
+ * Name: usrsockdev_req_unread
+ *
+ * Description:
+ *   Check if daemon has not yet read all of the request.
+ *
+ ****************************************************************************/
+
+static bool usrsockdev_req_unread(FAR struct usrsockdev_req_s *req)
+{
+  return iovec_get(NULL, 0, req->iov, req->iovcnt, req->pos) >= 0;
+}
+
+/****************************************************************************
+ * Name: usrsockdev_req_current
+ *
+ * Description:
+ *   Get the request that the daemon is currently reading.  Once the daemon
+ *   has read the head request to its end and issues a new read, the head is
+ *   moved to the acknowledgment queue and the next request becomes
+ *   current.  A single read never crosses a request boundary, so daemons
+ *   handling one request at a time keep working unchanged.
+ *
+ ****************************************************************************/
+
+static FAR struct usrsockdev_req_s *
+usrsockdev_req_current(FAR struct usrsockdev_s *dev, bool advance)
+{
+  FAR struct usrsockdev_req_s *req;
+
+  req = (FAR struct usrsockdev_req_s *)sq_peek(&dev->req.readq);
+  if (advance && req != NULL && req->flink != NULL &&
+      !usrsockdev_req_unread(req))
+    {
+      sq_remfirst(&dev->req.readq);
+      sq_addlast((FAR sq_entry_t *)req, &dev->req.ackq);
+
+      req = (FAR struct usrsockdev_req_s *)sq_peek(&dev->req.readq);
+    }
+
+  return req;
+}
+
+/****************************************************************************
+ * Name: usrsockdev_req_complete
+ *
+ * Description:
+ *   Find the request waiting for acknowledgment with matching exchange id,
+ *   unlink it and wake up the requesting thread.  Requests may complete in
+ *   any order.
+ *
+ ****************************************************************************/
+
+static void usrsockdev_req_complete(FAR struct usrsockdev_s *dev,
+                                    uint8_t xid)
+{
+  FAR sq_queue_t *queues[2];
+  FAR struct usrsockdev_req_s *req;
+  int i;
+
+  queues[0] = &dev->req.ackq;
+  queues[1] = &dev->req.readq;
+
+  for (i = 0; i < 2; i++)
+    {
+      for (req = (FAR struct usrsockdev_req_s *)sq_peek(queues[i]);
+           req != NULL;
+           req = req->flink)
+        {
+          if (req->xid == xid)
+            {
+              sq_rem((FAR sq_entry_t *)req, queues[i]);
+              nxsem_post(&req->acksem);
+              return;
+            }
+        }
+    }
+}
+
+/****************************************************************************
+ * Name: usrsockdev_req_abortall
+ *
+ * Description:
+ *   Unlink all pending requests and wake up the requesting threads.
+ *
+ ****************************************************************************/
+
+static void usrsockdev_req_abortall(FAR struct usrsockdev_s *dev)
+{
+  FAR struct usrsockdev_req_s *req;
+
+  while ((req = (FAR struct usrsockdev_req_s *)
+                sq_remfirst(&dev->req.readq)) != NULL)
+    {
+      nxsem_post(&req->acksem);
+    }
+
+  while ((req = (FAR struct usrsockdev_req_s *)
+                sq_remfirst(&dev->req.ackq)) != NULL)
+    {
+      nxsem_post(&req->acksem);
+    }
+}
+
 /****************************************************************************
  * Name: usrsockdev_read
  ****************************************************************************/
@@ -348,6 +470,7 @@ static ssize_t usrsockdev_read(FAR struct file *filep, FAR char *buffer,
                                size_t len)
 {
   FAR struct inode        *inode = filep->f_inode;
+  FAR struct usrsockdev_req_s *req;
   FAR struct usrsockdev_s *dev;
 
   if (len == 0)
@@ -371,14 +494,14 @@ static ssize_t usrsockdev_read(FAR struct file *filep, FAR char *buffer,
 
   /* Is request available? */
 
-  if (dev->req.iov)
+  req = usrsockdev_req_current(dev, true);
+  if (req)
     {
       ssize_t rlen;
 
       /* Copy request to user-space. */
 
-      rlen = iovec_get(buffer, len, dev->req.iov, dev->req.iovcnt,
-                       dev->req.pos);
+      rlen = iovec_get(buffer, len, req->iov, req->iovcnt, req->pos);
       if (rlen < 0)
         {
           /* Tried reading beyond buffer. */
@@ -387,7 +510,7 @@ static ssize_t usrsockdev_read(FAR struct file *filep, FAR char *buffer,
         }
       else
         {
-          dev->req.pos += rlen;
+          req->pos += rlen;
           len = rlen;
         }
     }
@@ -409,6 +532,7 @@ static ssize_t usrsockdev_read(FAR struct file *filep, FAR char *buffer,
 static off_t usrsockdev_seek(FAR struct file *filep, off_t offset, int whence)
 {
   FAR struct inode        *inode = filep->f_inode;
+  FAR struct usrsockdev_req_s *req;
   FAR struct usrsockdev_s *dev;
   off_t pos;
 
@@ -428,13 +552,14 @@ static off_t usrsockdev_seek(FAR struct file *filep, off_t offset, int whence)
 
   /* Is request available? */
 
-  if (dev->req.iov)
+  req = usrsockdev_req_current(dev, false);
+  if (req)
     {
       ssize_t rlen;
 
       if (whence == SEEK_CUR)
         {
-          pos = dev->req.pos + offset;
+          pos = req->pos + offset;
         }
       else if (whence == SEEK_SET)
         {
@@ -443,7 +568,7 @@ static off_t usrsockdev_seek(FAR struct file *filep, off_t offset, int whence)
 
       /* Copy request to user-space. */
 
-      rlen = iovec_get(NULL, 0, dev->req.iov, dev->req.iovcnt, pos);
+      rlen = iovec_get(NULL, 0, req->iov, req->iovcnt, pos);
       if (rlen < 0)
         {
           /* Tried seek beyond buffer. */
@@ -452,7 +577,7 @@ static off_t usrsockdev_seek(FAR struct file *filep, off_t offset, int whence)
         }
       else
         {
-          dev->req.pos = pos;
+          req->pos = pos;
         }
     }
   else
@@ -769,16 +894,11 @@ static ssize_t usrsockdev_handle_req_response(FAR struct usrsockdev_s *dev,
       goto unlock_out;
     }
 
-  if (dev->req.ack_xid == hdr->xid && dev->req.iov)
-    {
-      /* Signal that request was received and read by daemon and
-       * acknowledgment response was received.
-       */
-
-      dev->req.iov = NULL;
+  /* Signal that request was received and read by daemon and
+   * acknowledgment response was received.
+   */
 
-      nxsem_post(&dev->req.acksem);
-    }
+  usrsockdev_req_complete(dev, hdr->xid);
 
   ret = handle_response(dev, conn, buffer);
 
@@ -841,70 +961,88 @@ static ssize_t usrsockdev_write(FAR struct file *filep,
 
   usrsockdev_semtake(&dev->devsem);
 
-  if (!dev->datain_conn)
-    {
-      /* Start of message, buffer length should be at least size of common
-       * message header.
-       */
+  /* The daemon may batch several messages (and their data payloads) into
+   * a single write.  Process them in order until the buffer is exhausted.
+   */
 
-      if (len < sizeof(struct usrsock_message_common_s))
+  while (len > 0)
+    {
+      if (!dev->datain_conn)
         {
-          nwarn("message too short, %d < %d.\n", len,
-                sizeof(struct usrsock_message_common_s));
+          /* Start of message, buffer length should be at least size of
+           * common message header.
+           */
 
-          ret = -EINVAL;
-          goto errout;
-        }
+          if (len < sizeof(struct usrsock_message_common_s))
+            {
+              nwarn("message too short, %d < %d.\n", len,
+                    sizeof(struct usrsock_message_common_s));
 
-      /* Handle message. */
+              ret = -EINVAL;
+              break;
+            }
+
+          /* Handle message. */
+
+          ret = usrsockdev_handle_message(dev, buffer, len);
+          if (ret <= 0)
+            {
+              break;
+            }
 
-      ret = usrsockdev_handle_message(dev, buffer, len);
-      if (ret >= 0)
-        {
           buffer += ret;
           len -= ret;
-          ret = origlen - len;
         }
-    }
 
-  /* Data input handling. */
+      /* Data input handling. */
 
-  if (dev->datain_conn)
-    {
-      conn = dev->datain_conn;
+      if (dev->datain_conn)
+        {
+          conn = dev->datain_conn;
 
-      /* Copy data from user-space. */
+          /* Copy data from user-space. */
 
-      ret = iovec_put(conn->resp.datain.iov, conn->resp.datain.iovcnt,
-                      conn->resp.datain.pos, buffer, len);
-      if (ret < 0)
-        {
-          /* Tried writing beyond buffer. */
+          ret = iovec_put(conn->resp.datain.iov, conn->resp.datain.iovcnt,
+                          conn->resp.datain.pos, buffer, len);
+          if (ret < 0)
+            {
+              /* Tried writing beyond buffer. */
 
-          ret = -EINVAL;
-          conn->resp.result = -EINVAL;
-          conn->resp.datain.pos =
-              conn->resp.datain.total;
-        }
-      else
-        {
-          conn->resp.datain.pos += ret;
-          buffer += ret;
-          len -= ret;
-          ret = origlen - len;
-        }
+              ret = -EINVAL;
+              conn->resp.result = -EINVAL;
+              conn->resp.datain.pos =
+                  conn->resp.datain.total;
+            }
+          else
+            {
+              conn->resp.datain.pos += ret;
+              buffer += ret;
+              len -= ret;
+            }
 
-      if (conn->resp.datain.pos == conn->resp.datain.total)
-        {
-          dev->datain_conn = NULL;
+          if (conn->resp.datain.pos == conn->resp.datain.total)
+            {
+              dev->datain_conn = NULL;
 
-          /* Done with data response. */
+              /* Done with data response. */
 
-          usrsock_event(conn, USRSOCK_EVENT_REQ_COMPLETE);
+              usrsock_event(conn, USRSOCK_EVENT_REQ_COMPLETE);
+            }
+
+          if (ret < 0)
+            {
+              break;
+            }
         }
     }
 
-errout:
+  /* Report the messages consumed before any error. */
+
+  if (len < origlen)
+    {
+      ret = origlen - len;
+    }
+
   usrsockdev_semgive(&dev->devsem);
   return ret;
 }
@@ -1030,25 +1168,17 @@ static int usrsockdev_close(FAR struct file *filep)
 
       /* Wake-up pending requests. */
 
+      usrsockdev_req_abortall(dev);
+
       if (dev->req.nbusy == 0)
         {
           break;
         }
-
-      dev->req.iov = NULL;
-      nxsem_post(&dev->req.acksem);
     }
   while (true);
 
   net_unlock();
 
-  /* Check if request line is active */
-
-  if (dev->req.iov != NULL)
-    {
-      dev->req.iov = NULL;
-    }
-
   usrsockdev_semgive(&dev->devsem);
 
   return ret;
@@ -1062,6 +1192,7 @@ static int usrsockdev_poll(FAR struct file *filep, FAR struct pollfd *fds,
                            bool setup)
 {
   FAR struct inode *inode = filep->f_inode;
+  FAR struct usrsockdev_req_s *req;
   FAR struct usrsockdev_s *dev;
   pollevent_t eventset;
   int ret = OK;
@@ -1117,9 +1248,8 @@ static int usrsockdev_poll(FAR struct file *filep, FAR struct pollfd *fds,
 
       /* Notify the POLLIN event if pending request. */
 
-      if (dev->req.iov != NULL &&
-          !(iovec_get(NULL, 0, dev->req.iov,
-                      dev->req.iovcnt, dev->req.pos) < 0))
+      req = usrsockdev_req_current(dev, false);
+      if (req != NULL && (req->flink != NULL || usrsockdev_req_unread(req)))
         {
           eventset |= POLLIN;
         }
@@ -1166,6 +1296,7 @@ int usrsockdev_do_request(FAR struct usrsock_conn_s *conn,
 {
   FAR struct usrsockdev_s *dev = conn->dev;
   FAR struct usrsock_request_common_s *req_head = iov[0].iov_base;
+  struct usrsockdev_req_s req;
   int ret = OK;
 
   if (!dev)
@@ -1194,25 +1325,31 @@ int usrsockdev_do_request(FAR struct usrsock_conn_s *conn,
 
   ++dev->req.nbusy; /* net_lock held. */
 
-  /* Set outstanding request for daemon to handle. */
+  /* Queue outstanding request for daemon to handle. */
 
   net_lockedwait_uninterruptible(&dev->req.sem);
 
   if (usrsockdev_is_opened(dev))
     {
-      DEBUGASSERT(dev->req.iov == NULL);
-      dev->req.ack_xid = req_head->xid;
-      dev->req.iov = iov;
-      dev->req.pos = 0;
-      dev->req.iovcnt = iovcnt;
+      req.xid    = req_head->xid;
+      req.iov    = iov;
+      req.iovcnt = iovcnt;
+      req.pos    = 0;
+      nxsem_init(&req.acksem, 0, 0);
+      nxsem_setprotocol(&req.acksem, SEM_PRIO_NONE);
+
+      sq_addlast((FAR sq_entry_t *)&req, &dev->req.readq);
 
       /* Notify daemon of new request. */
 
       usrsockdev_pollnotify(dev, POLLIN);
 
-      /* Wait ack for request. */
+      /* Wait ack for request.  The request is unlinked by the daemon
+       * response or by close of the device.
+       */
 
-      net_lockedwait_uninterruptible(&dev->req.acksem);
+      net_lockedwait_uninterruptible(&req.acksem);
+      nxsem_destroy(&req.acksem);
     }
   else
     {
@@ -1221,7 +1358,7 @@ int usrsockdev_do_request(FAR struct usrsock_conn_s *conn,
       ret = -ESHUTDOWN;
     }
 
-  /* Free request line for next command. */
+  /* Free request slot for next command. */
 
   usrsockdev_semgive(&dev->req.sem);
 
@@ -1245,9 +1382,9 @@ void usrsockdev_register(void)
   g_usrsockdev.ocount = 0;
   g_usrsockdev.req.nbusy = 0;
   nxsem_init(&g_usrsockdev.devsem, 0, 1);
-  nxsem_init(&g_usrsockdev.req.sem, 0, 1);
-  nxsem_init(&g_usrsockdev.req.acksem, 0, 0);
-  nxsem_setprotocol(&g_usrsockdev.req.acksem, SEM_PRIO_NONE);
+  nxsem_init(&g_usrsockdev.req.sem, 0, CONFIG_NET_USRSOCK_NREQUESTS);
+  sq_init(&g_usrsockdev.req.readq);
+  sq_init(&g_usrsockdev.req.ackq);
 
   register_driver("/dev/usrsock", &g_usrsockdevops, 0666,
                   &g_usrsockdev);
@@ -42,8 +42,11 @@
 #ifdef CONFIG_NET
 
 #include <stdint.h>
+#include <string.h>
 #include <debug.h>
 
+#include <nuttx/arch.h>
+
 #include <nuttx/net/netconfig.h>
 #include <nuttx/net/netdev.h>
 #include <nuttx/net/ip.h>
@@ -58,6 +61,32 @@
 #define IPv4BUF   ((struct ipv4_hdr_s *)&dev->d_buf[NET_LL_HDRLEN(dev)])
 #define IPv6BUF   ((struct ipv6_hdr_s *)&dev->d_buf[NET_LL_HDRLEN(dev)])
 
+/* The big-endian 16-bit word at byte offset o of p */
+
+#define CHKSUM_WORD(p,o) (((uint32_t)(p)[o] << 8) + (p)[(o) + 1])
+
+/****************************************************************************
+ * Private Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: chksum_fold
+ *
+ * Description:
+ *   Fold the carries collected in the upper half of a 32-bit accumulator
+ *   back into the 16-bit one's complement sum.
+ *
+ ****************************************************************************/
+
+#if !defined(CONFIG_NET_ARCH_CHKSUM) && !defined(CONFIG_ARCH_HAVE_CHKSUM)
+static inline uint16_t chksum_fold(uint32_t acc)
+{
+  acc  = (acc >> 16) + (acc & 0xffff);
+  acc += acc >> 16;
+  return (uint16_t)acc;
+}
+#endif
+
 /****************************************************************************
  * Public Functions
  ****************************************************************************/
@@ -84,43 +113,132 @@
 #ifndef CONFIG_NET_ARCH_CHKSUM
 uint16_t chksum(uint16_t sum, FAR const uint8_t *data, uint16_t len)
 {
-  FAR const uint8_t *dataptr;
-  FAR const uint8_t *last_byte;
-  uint16_t t;
+#ifdef CONFIG_ARCH_HAVE_CHKSUM
+  /* Use the architecture-specific inner loop */
 
-  dataptr = data;
-  last_byte = data + len - 1;
+  return up_chksum(sum, data, len);
+#else
+  FAR const uint8_t *dataptr = data;
+  uint32_t acc = sum;
 
-  while (dataptr < last_byte)
+  /* Sum eight 16-bit words per iteration.  The carries are collected in
+   * the upper half of the 32-bit accumulator and folded back in at the end.
+   * len is at most 65535, so the accumulator cannot overflow.
+   */
+
+  while (len >= 16)
     {
-      /* At least two more bytes */
+      acc += CHKSUM_WORD(dataptr, 0);
+      acc += CHKSUM_WORD(dataptr, 2);
+      acc += CHKSUM_WORD(dataptr, 4);
+      acc += CHKSUM_WORD(dataptr, 6);
+      acc += CHKSUM_WORD(dataptr, 8);
+      acc += CHKSUM_WORD(dataptr, 10);
+      acc += CHKSUM_WORD(dataptr, 12);
+      acc += CHKSUM_WORD(dataptr, 14);
 
-      t = ((uint16_t)dataptr[0] << 8) + dataptr[1];
-      sum += t;
-      if (sum < t)
-        {
-          sum++; /* carry */
-        }
+      dataptr += 16;
+      len     -= 16;
+    }
 
+  while (len >= 2)
+    {
+      acc     += CHKSUM_WORD(dataptr, 0);
       dataptr += 2;
+      len     -= 2;
     }
 
-  if (dataptr == last_byte)
+  if (len > 0)
     {
-      t = (dataptr[0] << 8) + 0;
-      sum += t;
-      if (sum < t)
-        {
-          sum++; /* carry */
-        }
+      /* Pad the final odd byte with zero */
+
+      acc += (uint32_t)dataptr[0] << 8;
     }
 
   /* Return sum in host byte order. */
 
-  return sum;
+  return chksum_fold(acc);
+#endif
 }
 #endif /* CONFIG_NET_ARCH_CHKSUM */
 
+/****************************************************************************
+ * Name: chksum_copy
+ *
+ * Description:
+ *   Copy len bytes from src to dest and add them to the checksum in the
+ *   same pass.  The result is identical to memcpy() followed by
+ *   chksum(sum, dest, len).
+ *
+ * Input Parameters:
+ *   sum  - Partial calculations carried over from a previous call to
+ *          chksum().
+ *   dest - Destination of the copy.
+ *   src  - Source of the copy.
+ *   len  - Number of bytes to copy and include in the checksum.
+ *
+ * Returned Value:
+ *   The updated checksum value.
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_NET_CHKSUM_COPY
+uint16_t chksum_copy(uint16_t sum, FAR uint8_t *dest,
+                     FAR const uint8_t *src, uint16_t len)
+{
+#ifdef CONFIG_ARCH_HAVE_CHKSUM
+  /* The architecture sum is faster than a byte-wise copy loop.  The data
+   * is still in the cache after the copy.
+   */
+
+  memcpy(dest, src, len);
+  return up_chksum(sum, dest, len);
+#else
+  uint32_t acc = sum;
+
+  while (len >= 8)
+    {
+      dest[0] = src[0];
+      dest[1] = src[1];
+      dest[2] = src[2];
+      dest[3] = src[3];
+      dest[4] = src[4];
+      dest[5] = src[5];
+      dest[6] = src[6];
+      dest[7] = src[7];
+
+      acc += CHKSUM_WORD(src, 0);
+      acc += CHKSUM_WORD(src, 2);
+      acc += CHKSUM_WORD(src, 4);
+      acc += CHKSUM_WORD(src, 6);
+
+      dest += 8;
+      src  += 8;
+      len  -= 8;
+    }
+
+  while (len >= 2)
+    {
+      dest[0] = src[0];
+      dest[1] = src[1];
+      acc    += CHKSUM_WORD(src, 0);
+
+      dest   += 2;
+      src    += 2;
+      len    -= 2;
+    }
+
+  if (len > 0)
+    {
+      dest[0] = src[0];
+      acc    += (uint32_t)src[0] << 8;
+    }
+
+  return chksum_fold(acc);
+#endif
+}
+#endif /* CONFIG_NET_CHKSUM_COPY */
+
 /****************************************************************************
  * Name: net_chksum
  *
@@ -58,6 +58,61 @@
 #define IPv4BUF  ((struct ipv4_hdr_s *)&dev->d_buf[NET_LL_HDRLEN(dev)])
 #define IPv6BUF  ((struct ipv6_hdr_s *)&dev->d_buf[NET_LL_HDRLEN(dev)])
 
+/****************************************************************************
+ * Private Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: upperlayer_payload_chksum
+ *
+ * Description:
+ *   Add the upper layer header and payload at 'upper' to sum.  If the
+ *   payload was summed while it was copied in (CONFIG_NET_CHKSUM_COPY),
+ *   only the header is read here and the saved payload sum is added.
+ *
+ ****************************************************************************/
+
+#if !defined(CONFIG_NET_ARCH_CHKSUM) && \
+    (defined(CONFIG_NET_IPv4) || defined(CONFIG_NET_IPv6))
+static uint16_t upperlayer_payload_chksum(FAR struct net_driver_s *dev,
+                                          uint16_t sum,
+                                          FAR const uint8_t *upper,
+                                          uint16_t upperlen)
+{
+#ifdef CONFIG_NET_CHKSUM_COPY
+  uint16_t sndsumlen = dev->d_sndsumlen;
+  uintptr_t hdrlen;
+
+  /* The saved sum is used at most once */
+
+  dev->d_sndsumlen = 0;
+
+  /* It is only usable if it covers exactly the data following the upper
+   * layer header, and that data starts at an even offset.
+   */
+
+  if (sndsumlen != 0 && sndsumlen == dev->d_sndlen &&
+      dev->d_appdata >= upper)
+    {
+      hdrlen = dev->d_appdata - upper;
+      if ((hdrlen & 1) == 0 && hdrlen + sndsumlen == upperlen)
+        {
+          sum  = chksum(sum, upper, hdrlen);
+          sum += dev->d_sndsum;
+          if (sum < dev->d_sndsum)
+            {
+              sum++; /* carry */
+            }
+
+          return sum;
+        }
+    }
+#endif
+
+  return chksum(sum, upper, upperlen);
+}
+#endif
+
 /****************************************************************************
  * Public Functions
  ****************************************************************************/
@@ -118,7 +173,9 @@ uint16_t ipv4_upperlayer_chksum(FAR struct net_driver_s *dev, uint8_t proto)
 
   /* Sum IP payload data. */
 
-  sum = chksum(sum, &dev->d_buf[iphdrlen + NET_LL_HDRLEN(dev)], upperlen);
+  sum = upperlayer_payload_chksum(dev, sum,
+                                  &dev->d_buf[iphdrlen + NET_LL_HDRLEN(dev)],
+                                  upperlen);
   return (sum == 0) ? 0xffff : htons(sum);
 }
 #endif /* CONFIG_NET_ARCH_CHKSUM */
@@ -185,7 +242,9 @@ uint16_t ipv6_upperlayer_chksum(FAR struct net_driver_s *dev,
 
   /* Sum IP payload data. */
 
-  sum = chksum(sum, &dev->d_buf[NET_LL_HDRLEN(dev) + iplen], upperlen);
+  sum = upperlayer_payload_chksum(dev, sum,
+                                  &dev->d_buf[NET_LL_HDRLEN(dev) + iplen],
+                                  upperlen);
   return (sum == 0) ? 0xffff : htons(sum);
 }
 #endif /* CONFIG_NET_ARCH_CHKSUM */
@@ -238,6 +238,30 @@ void net_ipv6_pref2mask(uint8_t preflen, net_ipv6addr_t mask);
 uint16_t chksum(uint16_t sum, FAR const uint8_t *data, uint16_t len);
 #endif
 
+/****************************************************************************
+ * Name: chksum_copy
+ *
+ * Description:
+ *   Copy len bytes from src to dest and add them to the checksum in the
+ *   same pass.  Equivalent to memcpy() followed by chksum().
+ *
+ * Input Parameters:
+ *   sum  - Partial calculations carried over from a previous call to
+ *          chksum().
+ *   dest - Destination of the copy.
+ *   src  - Source of the copy.
+ *   len  - Number of bytes to copy and include in the checksum.
+ *
+ * Returned Value:
+ *   The updated checksum value.
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_NET_CHKSUM_COPY
+uint16_t chksum_copy(uint16_t sum, FAR uint8_t *dest,
+                     FAR const uint8_t *src, uint16_t len);
+#endif
+
 /****************************************************************************
  * Name: net_chksum
  *
@@ -0,0 +1,740 @@
+/****************************************************************************
+ * sched/bench/kbench.c
+ *
+ *   Copyright (C) 2020 Gregory Nutt. All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in
+ *    the documentation and/or other materials provided with the
+ *    distribution.
+ * 3. Neither the name NuttX nor the names of its contributors may be
+ *    used to endorse or promote products derived from this software
+ *    without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+ * FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE
+ * COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+ * INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,
+ * BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS
+ * OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED
+ * AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ * LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN
+ * ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ *
+ ****************************************************************************/
+
+/****************************************************************************
+ * Included Files
+ ****************************************************************************/
+
+#include <nuttx/config.h>
+
+#include <sys/types.h>
+#include <stdint.h>
+#include <stdbool.h>
+#include <string.h>
+#include <sched.h>
+#include <fcntl.h>
+#include <mqueue.h>
+#include <time.h>
+#include <assert.h>
+#include <errno.h>
+
+#include <nuttx/arch.h>
+#include <nuttx/clock.h>
+#include <nuttx/kmalloc.h>
+#include <nuttx/kthread.h>
+#include <nuttx/mqueue.h>
+#include <nuttx/semaphore.h>
+#include <nuttx/wdog.h>
+
+#include "sched/sched.h"
+#include "bench/kbench.h"
+
+#ifdef CONFIG_SCHED_BENCHMARK
+
+/****************************************************************************
+ * Pre-processor Definitions
+ ****************************************************************************/
+
+/* Time stamps.  The critical section monitor timer is used when there is
+ * one; otherwise the system clock, which may be much coarser.
+ */
+
+#ifdef CONFIG_CLOCK_MONOTONIC
+#  define KBENCH_CLOCK    CLOCK_MONOTONIC
+#else
+#  define KBENCH_CLOCK    CLOCK_REALTIME
+#endif
+
+/* Size of the blocks of the malloc benchmark and of the messages of the
+ * message queue benchmark.
+ */
+
+#define KBENCH_BLOCKSIZE  64
+#define KBENCH_MSGSIZE    16
+
+/* Nominal period of the timer benchmark (ns) */
+
+#define KBENCH_TIMERNS    (USEC_PER_TICK * 1000)
+
+/****************************************************************************
+ * Public Data
+ ****************************************************************************/
+
+struct kbench_s g_kbench;
+
+/****************************************************************************
+ * Private Data
+ ****************************************************************************/
+
+static sem_t g_kbench_lock = SEM_INITIALIZER(1);
+
+static FAR const char *g_kbench_names[KBENCH_NTESTS] =
+{
+  "ctxsw", "sem_pingpong", "sem_pingpong_xcpu", "mutex",
+  "mutex_contended", "mqueue", "malloc", "timer", "pipe", "local", "udp",
+  "tcp"
+};
+
+/****************************************************************************
+ * Private Functions
+ ****************************************************************************/
+
+static uint32_t kbench_tons(uint32_t elapsed)
+{
+#ifdef CONFIG_SCHED_CRITMONITOR
+  struct timespec ts;
+
+  up_critmon_convert(elapsed, &ts);
+  return (uint32_t)ts.tv_sec * 1000000000 + (uint32_t)ts.tv_nsec;
+#else
+  return elapsed;
+#endif
+}
+
+static void kbench_record(uint32_t ns)
+{
+  g_kbench.count++;
+  g_kbench.total += ns;
+
+  if (ns < g_kbench.min)
+    {
+      g_kbench.min = ns;
+    }
+
+  if (ns > g_kbench.max)
+    {
+      g_kbench.max = ns;
+    }
+}
+
+/****************************************************************************
+ * Name: kbench_ctxsw
+ *
+ * Description:
+ *   Two threads of the same priority on the same CPU yield to each other.
+ *   Each sample is one context switch:  From the time stamp taken by one
+ *   thread before sched_yield() to the return from sched_yield() in the
+ *   other.
+ *
+ ****************************************************************************/
+
+static int kbench_yield_main(int argc, FAR char *argv[])
+{
+  int i;
+
+  if (kbench_begin())
+    {
+      for (i = 0; i < KBENCH_NITER / 2; i++)
+        {
+          g_kbench.stamp = kbench_gettime();
+          sched_yield();
+
+          /* The last return from sched_yield() is caused by the exit of the
+           * other thread, which sets 'abort'.  It is not a sample.
+           */
+
+          if (!g_kbench.abort)
+            {
+              kbench_sample(g_kbench.stamp);
+            }
+        }
+
+      g_kbench.abort = true;
+    }
+
+  return kbench_end();
+}
+
+static int kbench_ctxsw(void)
+{
+  static const main_t entry[2] =
+  {
+    kbench_yield_main, kbench_yield_main
+  };
+
+  int cpu[2];
+
+  cpu[0] = this_cpu();
+  cpu[1] = cpu[0];
+
+  return kbench_threads(entry, cpu, 2);
+}
+
+/****************************************************************************
+ * Name: kbench_pingpong
+ *
+ * Description:
+ *   Two threads pass the control back and forth with two semaphores.  Each
+ *   sample is one round trip.
+ *
+ ****************************************************************************/
+
+static int kbench_ping_main(int argc, FAR char *argv[])
+{
+  uint32_t start;
+  int i;
+
+  if (kbench_begin())
+    {
+      for (i = 0; i < KBENCH_NITER; i++)
+        {
+          start = kbench_gettime();
+          nxsem_post(&g_kbench.sem[1]);
+          nxsem_wait_uninterruptible(&g_kbench.sem[0]);
+          kbench_sample(start);
+        }
+    }
+
+  return kbench_end();
+}
+
+static int kbench_pong_main(int argc, FAR char *argv[])
+{
+  int i;
+
+  if (kbench_begin())
+    {
+      for (i = 0; i < KBENCH_NITER; i++)
+        {
+          nxsem_wait_uninterruptible(&g_kbench.sem[1]);
+          nxsem_post(&g_kbench.sem[0]);
+        }
+    }
+
+  return kbench_end();
+}
+
+static int kbench_pingpong(bool xcpu)
+{
+  static const main_t entry[2] =
+  {
+    kbench_ping_main, kbench_pong_main
+  };
+
+  int cpu[2];
+  int ret;
+
+  cpu[0] = this_cpu();
+  cpu[1] = cpu[0];
+
+  if (xcpu)
+    {
+#if defined(CONFIG_SMP) && CONFIG_SMP_NCPUS > 1
+      cpu[1] = (cpu[0] + 1) % CONFIG_SMP_NCPUS;
+#else
+      return -ENOSYS;
+#endif
+    }
+
+  nxsem_init(&g_kbench.sem[0], 0, 0);
+  nxsem_init(&g_kbench.sem[1], 0, 0);
+  nxsem_setprotocol(&g_kbench.sem[0], SEM_PRIO_NONE);
+  nxsem_setprotocol(&g_kbench.sem[1], SEM_PRIO_NONE);
+
+  ret = kbench_threads(entry, cpu, 2);
+
+  nxsem_destroy(&g_kbench.sem[0]);
+  nxsem_destroy(&g_kbench.sem[1]);
+  return ret;
+}
+
+/****************************************************************************
+ * Name: kbench_mutex
+ *
+ * Description:
+ *   Lock and unlock a mutex, i.e. a semaphore with priority inheritance.
+ *   Without contention, each sample is one lock and unlock in the calling
+ *   thread.  With contention, two threads on the same CPU yield while they
+ *   hold the mutex, so that each lock has to wait for the other thread.
+ *   Each sample is then the time from the lock request to the ownership.
+ *
+ ****************************************************************************/
+
+static int kbench_lock_main(int argc, FAR char *argv[])
+{
+  uint32_t start;
+  int i;
+
+  if (kbench_begin())
+    {
+      for (i = 0; i < KBENCH_NITER / 2; i++)
+        {
+          start = kbench_gettime();
+          nxsem_wait_uninterruptible(&g_kbench.sem[0]);
+          kbench_sample(start);
+
+          sched_yield();
+          nxsem_post(&g_kbench.sem[0]);
+        }
+    }
+
+  return kbench_end();
+}
+
+static int kbench_mutex(bool contended)
+{
+  static const main_t entry[2] =
+  {
+    kbench_lock_main, kbench_lock_main
+  };
+
+  uint32_t start;
+  int cpu[2];
+  int ret = OK;
+  int i;
+
+  nxsem_init(&g_kbench.sem[0], 0, 1);
+
+  if (contended)
+    {
+      cpu[0] = this_cpu();
+      cpu[1] = cpu[0];
+
+      ret = kbench_threads(entry, cpu, 2);
+    }
+  else
+    {
+      for (i = 0; i < KBENCH_NITER; i++)
+        {
+          start = kbench_gettime();
+          nxsem_wait_uninterruptible(&g_kbench.sem[0]);
+          nxsem_post(&g_kbench.sem[0]);
+          kbench_sample(start);
+        }
+    }
+
+  nxsem_destroy(&g_kbench.sem[0]);
+  return ret;
+}
+
+/****************************************************************************
+ * Name: kbench_mqueue
+ *
+ * Description:
+ *   Send a message to a queue and receive it again in the calling thread.
+ *   Each sample is one send and receive.
+ *
+ ****************************************************************************/
+
+static int kbench_mqueue(void)
+{
+#ifndef CONFIG_DISABLE_MQUEUE
+  char msg[KBENCH_MSGSIZE];
+  struct mq_attr attr;
+  uint32_t start;
+  mqd_t mqdes;
+  ssize_t nrecvd;
+  int ret = OK;
+  int i;
+
+  memset(&attr, 0, sizeof(struct mq_attr));
+  attr.mq_maxmsg  = 1;
+  attr.mq_msgsize = KBENCH_MSGSIZE;
+
+  mqdes = mq_open("kbench", O_RDWR | O_CREAT, 0666, &attr);
+  if (mqdes == (mqd_t)ERROR)
+    {
+      return -get_errno();
+    }
+
+  memset(msg, 0x5a, KBENCH_MSGSIZE);
+
+  for (i = 0; i < KBENCH_NITER; i++)
+    {
+      start = kbench_gettime();
+      ret = nxmq_send(mqdes, msg, KBENCH_MSGSIZE, 0);
+      if (ret < 0)
+        {
+          break;
+        }
+
+      nrecvd = nxmq_receive(mqdes, msg, KBENCH_MSGSIZE, NULL);
+      if (nrecvd < 0)
+        {
+          ret = (int)nrecvd;
+          break;
+        }
+
+      kbench_sample(start);
+    }
+
+  mq_close(mqdes);
+  mq_unlink("kbench");
+  return ret;
+#else
+  return -ENOSYS;
+#endif
+}
+
+/****************************************************************************
+ * Name: kbench_malloc
+ *
+ * Description:
+ *   Allocate and free one block of the kernel heap.  Each sample is one
+ *   allocation and free.  See CONFIG_MM_BENCHMARK for the latency of more
+ *   realistic allocation patterns.
+ *
+ ****************************************************************************/
+
+static int kbench_malloc(void)
+{
+  FAR void *mem;
+  uint32_t start;
+  int i;
+
+  for (i = 0; i < KBENCH_NITER; i++)
+    {
+      start = kbench_gettime();
+      mem   = kmm_malloc(KBENCH_BLOCKSIZE);
+      if (mem == NULL)
+        {
+          return -ENOMEM;
+        }
+
+      kmm_free(mem);
+      kbench_sample(start);
+    }
+
+  return OK;
+}
+
+/****************************************************************************
+ * Name: kbench_timer
+ *
+ * Description:
+ *   Run a watchdog timer with a period of one tick.  Each sample is the
+ *   deviation of the time between two expirations from the period.
+ *
+ ****************************************************************************/
+
+static void kbench_timeout(int argc, wdparm_t arg)
+{
+  FAR struct wdog_s *wdog = (FAR struct wdog_s *)arg;
+  uint32_t now = kbench_gettime();
+  uint32_t ns;
+
+  /* The first expiration is only the reference for the next one */
+
+  if (g_kbench.iter++ > 0)
+    {
+      ns = kbench_tons(now - g_kbench.stamp);
+      kbench_record(ns > KBENCH_TIMERNS ? ns - KBENCH_TIMERNS :
+                                          KBENCH_TIMERNS - ns);
+    }
+
+  g_kbench.stamp = now;
+
+  if (g_kbench.iter <= KBENCH_NITER)
+    {
+      wd_start(wdog, 1, (wdentry_t)kbench_timeout, 1, (wdparm_t)wdog);
+    }
+  else
+    {
+      nxsem_post(&g_kbench.done);
+    }
+}
+
+static int kbench_timer(void)
+{
+  WDOG_ID wdog;
+  int ret;
+
+  wdog = wd_create();
+  if (wdog == NULL)
+    {
+      return -ENOMEM;
+    }
+
+  nxsem_init(&g_kbench.done, 0, 0);
+  nxsem_setprotocol(&g_kbench.done, SEM_PRIO_NONE);
+
+  ret = wd_start(wdog, 1, (wdentry_t)kbench_timeout, 1, (wdparm_t)wdog);
+  if (ret >= 0)
+    {
+      nxsem_wait_uninterruptible(&g_kbench.done);
+    }
+
+  nxsem_destroy(&g_kbench.done);
+  wd_delete(wdog);
+  return ret;
+}
+
+/****************************************************************************
+ * Public Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: kbench_gettime
+ ****************************************************************************/
+
+uint32_t kbench_gettime(void)
+{
+#ifdef CONFIG_SCHED_CRITMONITOR
+  return up_critmon_gettime();
+#else
+  struct timespec ts;
+
+  clock_gettime(KBENCH_CLOCK, &ts);
+  return (uint32_t)ts.tv_sec * 1000000000 + (uint32_t)ts.tv_nsec;
+#endif
+}
+
+/****************************************************************************
+ * Name: kbench_sample
+ ****************************************************************************/
+
+uint32_t kbench_sample(uint32_t start)
+{
+  uint32_t now = kbench_gettime();
+
+  kbench_record(kbench_tons(now - start));
+  return now;
+}
+
+/****************************************************************************
+ * Name: kbench_begin and kbench_end
+ ****************************************************************************/
+
+bool kbench_begin(void)
+{
+  nxsem_wait_uninterruptible(&g_kbench.start);
+  return !g_kbench.abort;
+}
+
+int kbench_end(void)
+{
+  nxsem_post(&g_kbench.done);
+  return 0;
+}
+
+/****************************************************************************
+ * Name: kbench_threads
+ ****************************************************************************/
+
+int kbench_threads(FAR const main_t *entry, FAR const int *cpu,
+                   int nthreads)
+{
+  pid_t pid;
+  int ret = OK;
+  int i;
+  int n;
+
+  DEBUGASSERT(nthreads <= KBENCH_NTHREADS);
+
+  g_kbench.abort = false;
+  nxsem_init(&g_kbench.start, 0, 0);
+  nxsem_init(&g_kbench.done, 0, 0);
+  nxsem_setprotocol(&g_kbench.start, SEM_PRIO_NONE);
+  nxsem_setprotocol(&g_kbench.done, SEM_PRIO_NONE);
+
+  for (n = 0; n < nthreads; n++)
+    {
+      pid = kthread_create("kbench", CONFIG_SCHED_BENCHMARK_PRIORITY,
+                           CONFIG_SCHED_BENCHMARK_STACKSIZE, entry[n],
+                           NULL);
+      if (pid < 0)
+        {
+          g_kbench.abort = true;
+          ret = pid;
+          break;
+        }
+
+#ifdef CONFIG_SMP
+      if (cpu[n] != KBENCH_ANYCPU)
+        {
+          cpu_set_t cpuset = 1 << cpu[n];
+
+          nxsched_setaffinity(pid, sizeof(cpu_set_t), &cpuset);
+        }
+#else
+      UNUSED(cpu);
+#endif
+    }
+
+  /* Release all threads at once, so that none of them starts before the
+   * others are ready to run.
+   */
+
+  sched_lock();
+  for (i = 0; i < n; i++)
+    {
+      nxsem_post(&g_kbench.start);
+    }
+
+  sched_unlock();
+
+  for (i = 0; i < n; i++)
+    {
+      nxsem_wait_uninterruptible(&g_kbench.done);
+    }
+
+  nxsem_destroy(&g_kbench.start);
+  nxsem_destroy(&g_kbench.done);
+  return ret;
+}
+
+/****************************************************************************
+ * Name: kbench_run
+ *
+ * Description:
+ *   Run one micro-benchmark of a kernel primitive.
+ *
+ ****************************************************************************/
+
+int kbench_run(enum kbench_test_e test, FAR struct kbench_result_s *result)
+{
+  struct timespec start;
+  struct timespec end;
+  ssize_t nbytes = 0;
+  uint64_t elapsed;
+  int ret;
+
+  DEBUGASSERT(result != NULL);
+
+  if ((unsigned int)test >= KBENCH_NTESTS)
+    {
+      return -EINVAL;
+    }
+
+  ret = nxsem_wait_uninterruptible(&g_kbench_lock);
+  if (ret < 0)
+    {
+      return ret;
+    }
+
+  memset(&g_kbench, 0, sizeof(struct kbench_s));
+  g_kbench.min = UINT32_MAX;
+
+  clock_gettime(KBENCH_CLOCK, &start);
+
+  switch (test)
+    {
+      case KBENCH_CTXSW:
+        ret = kbench_ctxsw();
+        break;
+
+      case KBENCH_SEMPINGPONG:
+      case KBENCH_SEMPINGPONG_XCPU:
+        ret = kbench_pingpong(test == KBENCH_SEMPINGPONG_XCPU);
+        break;
+
+      case KBENCH_MUTEX:
+      case KBENCH_MUTEX_CONTENDED:
+        ret = kbench_mutex(test == KBENCH_MUTEX_CONTENDED);
+        break;
+
+      case KBENCH_MQUEUE:
+        ret = kbench_mqueue();
+        break;
+
+      case KBENCH_MALLOC:
+        ret = kbench_malloc();
+        break;
+
+      case KBENCH_TIMER:
+        ret = kbench_timer();
+        break;
+
+      case KBENCH_PIPE:
+        nbytes = kbench_pipe();
+        break;
+
+      case KBENCH_LOCAL:
+        nbytes = kbench_local();
+        break;
+
+      case KBENCH_UDP:
+        nbytes = kbench_udp();
+        break;
+
+      case KBENCH_TCP:
+        nbytes = kbench_tcp();
+        break;
+
+      default:
+        break;
+    }
+
+  clock_gettime(KBENCH_CLOCK, &end);
+
+  if (nbytes < 0)
+    {
+      ret = (int)nbytes;
+    }
+
+  if (ret >= 0)
+    {
+      memset(result, 0, sizeof(struct kbench_result_s));
+      if (g_kbench.count > 0)
+        {
+          result->kr_count = g_kbench.count;
+          result->kr_min   = g_kbench.min;
+          result->kr_avg   = (uint32_t)(g_kbench.total / g_kbench.count);
+          result->kr_max   = g_kbench.max;
+        }
+
+      /* Throughput of the whole transfer in KiB/s */
+
+      elapsed = (uint64_t)(end.tv_sec - start.tv_sec) * 1000000000 +
+                end.tv_nsec - start.tv_nsec;
+      if (nbytes > 0 && elapsed > 0)
+        {
+          result->kr_kbps = (uint32_t)((uint64_t)nbytes * 1000000000 /
+                                       1024 / elapsed);
+        }
+    }
+
+  nxsem_post(&g_kbench_lock);
+  return ret;
+}
+
+/****************************************************************************
+ * Name: kbench_name
+ *
+ * Description:
+ *   Return a short name for a benchmark, for reports.
+ *
+ ****************************************************************************/
+
+FAR const char *kbench_name(enum kbench_test_e test)
+{
+  if ((unsigned int)test >= KBENCH_NTESTS)
+    {
+      return "unknown";
+    }
+
+  return g_kbench_names[test];
+}
+
+#endif /* CONFIG_SCHED_BENCHMARK */
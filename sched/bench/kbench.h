@@ -0,0 +1,210 @@
+/****************************************************************************
+ * sched/bench/kbench.h
+ *
+ *   Copyright (C) 2020 Gregory Nutt. All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in
+ *    the documentation and/or other materials provided with the
+ *    distribution.
+ * 3. Neither the name NuttX nor the names of its contributors may be
+ *    used to endorse or promote products derived from this software
+ *    without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+ * FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE
+ * COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+ * INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,
+ * BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS
+ * OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED
+ * AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ * LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN
+ * ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ *
+ ****************************************************************************/
+
+#ifndef __SCHED_BENCH_KBENCH_H
+#define __SCHED_BENCH_KBENCH_H
+
+/****************************************************************************
+ * Included Files
+ ****************************************************************************/
+
+#include <nuttx/config.h>
+
+#include <stdint.h>
+#include <stdbool.h>
+#include <semaphore.h>
+
+#include <nuttx/fs/fs.h>
+#include <nuttx/net/net.h>
+#include <nuttx/kbench.h>
+
+#ifdef CONFIG_SCHED_BENCHMARK
+
+/****************************************************************************
+ * Pre-processor Definitions
+ ****************************************************************************/
+
+#ifndef CONFIG_SCHED_BENCHMARK_NITER
+#  define CONFIG_SCHED_BENCHMARK_NITER 1000
+#endif
+
+#ifndef CONFIG_SCHED_BENCHMARK_XFERSIZE
+#  define CONFIG_SCHED_BENCHMARK_XFERSIZE 256
+#endif
+
+#ifndef CONFIG_SCHED_BENCHMARK_PRIORITY
+#  define CONFIG_SCHED_BENCHMARK_PRIORITY 200
+#endif
+
+#ifndef CONFIG_SCHED_BENCHMARK_STACKSIZE
+#  define CONFIG_SCHED_BENCHMARK_STACKSIZE 2048
+#endif
+
+#define KBENCH_NITER     CONFIG_SCHED_BENCHMARK_NITER
+#define KBENCH_XFERSIZE  (CONFIG_SCHED_BENCHMARK_XFERSIZE * 1024)
+
+/* Data is transferred in chunks of this size */
+
+#define KBENCH_CHUNK     1024
+
+/* A benchmark uses at most this many helper threads */
+
+#define KBENCH_NTHREADS  2
+
+/* Passed as the CPU of a helper thread that is not pinned */
+
+#define KBENCH_ANYCPU    (-1)
+
+/****************************************************************************
+ * Public Types
+ ****************************************************************************/
+
+/* The state of the running benchmark */
+
+struct kbench_s
+{
+  /* Statistics of the timed operations */
+
+  uint32_t count;                     /* Number of operations timed */
+  uint32_t min;                       /* Shortest operation (ns) */
+  uint32_t max;                       /* Longest operation (ns) */
+  uint64_t total;                     /* Sum of all operations (ns) */
+
+  volatile uint32_t stamp;            /* Time stamp passed between threads */
+  volatile uint32_t iter;             /* Iterations of the timer benchmark */
+  volatile bool abort;                /* Helper threads must quit at once */
+
+  sem_t start;                        /* Releases the helper threads */
+  sem_t done;                         /* Posted by each finished thread */
+  sem_t sem[2];                       /* Ping-pong semaphores, mutex */
+
+#if defined(CONFIG_PIPES) || defined(CONFIG_NET)
+  /* State of the throughput benchmarks */
+
+  int result[KBENCH_NTHREADS];        /* Result of each helper thread */
+  uint8_t buffer[KBENCH_NTHREADS][KBENCH_CHUNK];
+#endif
+#ifdef CONFIG_PIPES
+  FAR struct file *filep[2];          /* Read and write end of the pipe */
+#endif
+#ifdef CONFIG_NET
+  struct socket sock[3];              /* Sockets of the network benchmarks */
+#endif
+};
+
+/****************************************************************************
+ * Public Data
+ ****************************************************************************/
+
+extern struct kbench_s g_kbench;
+
+/****************************************************************************
+ * Public Function Prototypes
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: kbench_gettime
+ *
+ * Description:
+ *   Return a time stamp for kbench_sample().  The critical section monitor
+ *   timer is used when there is one; otherwise the system clock, which may
+ *   be much coarser.
+ *
+ ****************************************************************************/
+
+uint32_t kbench_gettime(void);
+
+/****************************************************************************
+ * Name: kbench_sample
+ *
+ * Description:
+ *   Account one operation that started at the time stamp 'start' and ended
+ *   now.  Returns the current time stamp.
+ *
+ ****************************************************************************/
+
+uint32_t kbench_sample(uint32_t start);
+
+/****************************************************************************
+ * Name: kbench_begin and kbench_end
+ *
+ * Description:
+ *   Called by a helper thread on entry and on exit.  kbench_begin() waits
+ *   until the thread is released and returns false if the benchmark has
+ *   been aborted meanwhile.  kbench_end() reports the end of the thread
+ *   and returns the thread's exit status.
+ *
+ ****************************************************************************/
+
+bool kbench_begin(void);
+int kbench_end(void);
+
+/****************************************************************************
+ * Name: kbench_threads
+ *
+ * Description:
+ *   Run the benchmark in helper threads and wait until all of them have
+ *   finished.  The threads are created suspended on g_kbench.start so that
+ *   they can be pinned to their CPU before they run.  Each thread must post
+ *   g_kbench.done when it has finished.
+ *
+ * Input Parameters:
+ *   entry    - The entry point of each thread
+ *   cpu      - The CPU of each thread or KBENCH_ANYCPU
+ *   nthreads - The number of threads
+ *
+ * Returned Value:
+ *   Zero (OK) on success; a negated errno value on failure.
+ *
+ ****************************************************************************/
+
+int kbench_threads(FAR const main_t *entry, FAR const int *cpu,
+                   int nthreads);
+
+/****************************************************************************
+ * Name: kbench_pipe, kbench_local, kbench_udp, kbench_tcp
+ *
+ * Description:
+ *   The throughput benchmarks.  They return the number of bytes
+ *   transferred or a negated errno value on failure.
+ *
+ ****************************************************************************/
+
+ssize_t kbench_pipe(void);
+ssize_t kbench_local(void);
+ssize_t kbench_udp(void);
+ssize_t kbench_tcp(void);
+
+#endif /* CONFIG_SCHED_BENCHMARK */
+#endif /* __SCHED_BENCH_KBENCH_H */
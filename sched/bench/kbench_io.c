@@ -0,0 +1,547 @@
+/****************************************************************************
+ * sched/bench/kbench_io.c
+ *
+ *   Copyright (C) 2020 Gregory Nutt. All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in
+ *    the documentation and/or other materials provided with the
+ *    distribution.
+ * 3. Neither the name NuttX nor the names of its contributors may be
+ *    used to endorse or promote products derived from this software
+ *    without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+ * FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE
+ * COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+ * INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,
+ * BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS
+ * OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED
+ * AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ * LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN
+ * ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ *
+ ****************************************************************************/
+
+/****************************************************************************
+ * Included Files
+ ****************************************************************************/
+
+#include <nuttx/config.h>
+
+#include <sys/types.h>
+#include <sys/socket.h>
+#include <sys/time.h>
+#include <stdint.h>
+#include <stdbool.h>
+#include <string.h>
+#include <unistd.h>
+#include <errno.h>
+
+#include <netinet/in.h>
+#include <arpa/inet.h>
+
+#include <nuttx/drivers/drivers.h>
+#include <nuttx/fs/fs.h>
+#include <nuttx/net/net.h>
+
+#include "bench/kbench.h"
+
+#ifdef CONFIG_SCHED_BENCHMARK
+
+/****************************************************************************
+ * Pre-processor Definitions
+ ****************************************************************************/
+
+#if defined(CONFIG_PIPES) && CONFIG_DEV_PIPE_SIZE > 0
+#  define KBENCH_HAVE_PIPE 1
+#endif
+
+#if defined(CONFIG_NET_LOCAL_STREAM)
+#  define KBENCH_HAVE_LOCAL 1
+#endif
+
+#if defined(CONFIG_NET_UDP) && defined(CONFIG_NET_IPv4) && \
+    defined(CONFIG_NET_LOOPBACK)
+#  define KBENCH_HAVE_UDP 1
+#endif
+
+#if defined(CONFIG_NET_TCP) && defined(CONFIG_NET_IPv4) && \
+    defined(CONFIG_NET_LOOPBACK)
+#  define KBENCH_HAVE_TCP 1
+#endif
+
+#if defined(KBENCH_HAVE_PIPE) || defined(KBENCH_HAVE_LOCAL) || \
+    defined(KBENCH_HAVE_TCP)
+#  define KBENCH_HAVE_STREAM 1
+#endif
+
+/* The loopback port of the UDP and TCP benchmarks */
+
+#define KBENCH_PORT      5471
+
+/* The size of the UDP datagrams.  Small enough to never be fragmented. */
+
+#define KBENCH_DGRAMSIZE 512
+
+/****************************************************************************
+ * Private Types
+ ****************************************************************************/
+
+/* Transfers of the stream benchmarks */
+
+typedef CODE ssize_t (*kbench_xfer_t)(FAR uint8_t *buffer, size_t len);
+typedef CODE int (*kbench_setup_t)(void);
+
+struct kbench_stream_s
+{
+  kbench_setup_t rxsetup;             /* Called by the receiver first */
+  kbench_setup_t txsetup;             /* Called by the sender first */
+  kbench_xfer_t recv;                 /* Receive one chunk */
+  kbench_xfer_t send;                 /* Send one chunk */
+};
+
+/****************************************************************************
+ * Private Data
+ ****************************************************************************/
+
+#ifdef KBENCH_HAVE_STREAM
+static FAR const struct kbench_stream_s *g_kbench_stream;
+#endif
+
+/****************************************************************************
+ * Private Functions
+ ****************************************************************************/
+
+#ifdef KBENCH_HAVE_STREAM
+
+/****************************************************************************
+ * Name: kbench_receiver and kbench_sender
+ *
+ * Description:
+ *   The helper threads of the stream benchmarks.  Each sample is the time
+ *   until one chunk has been received.
+ *
+ ****************************************************************************/
+
+static int kbench_receiver(int argc, FAR char *argv[])
+{
+  FAR const struct kbench_stream_s *stream = g_kbench_stream;
+  uint32_t start;
+  size_t nrecvd;
+  ssize_t n;
+  int ret = OK;
+
+  if (kbench_begin())
+    {
+      if (stream->rxsetup != NULL)
+        {
+          ret = stream->rxsetup();
+        }
+
+      for (nrecvd = 0; ret >= 0 && nrecvd < KBENCH_XFERSIZE; nrecvd += n)
+        {
+          start = kbench_gettime();
+          n = stream->recv(g_kbench.buffer[0], KBENCH_CHUNK);
+          if (n <= 0)
+            {
+              ret = n < 0 ? (int)n : -EPIPE;
+              break;
+            }
+
+          kbench_sample(start);
+        }
+
+      g_kbench.result[0] = ret;
+    }
+
+  return kbench_end();
+}
+
+static int kbench_sender(int argc, FAR char *argv[])
+{
+  FAR const struct kbench_stream_s *stream = g_kbench_stream;
+  size_t nsent;
+  ssize_t n;
+  int ret = OK;
+
+  if (kbench_begin())
+    {
+      if (stream->txsetup != NULL)
+        {
+          ret = stream->txsetup();
+        }
+
+      memset(g_kbench.buffer[1], 0x5a, KBENCH_CHUNK);
+
+      for (nsent = 0; ret >= 0 && nsent < KBENCH_XFERSIZE; nsent += n)
+        {
+          n = stream->send(g_kbench.buffer[1], KBENCH_CHUNK);
+          if (n <= 0)
+            {
+              ret = n < 0 ? (int)n : -EPIPE;
+              break;
+            }
+        }
+
+      g_kbench.result[1] = ret;
+    }
+
+  return kbench_end();
+}
+
+/****************************************************************************
+ * Name: kbench_stream
+ *
+ * Description:
+ *   Transfer KBENCH_XFERSIZE bytes from a sender to a receiver thread.
+ *
+ ****************************************************************************/
+
+static ssize_t kbench_stream(FAR const struct kbench_stream_s *stream)
+{
+  static const main_t entry[2] =
+  {
+    kbench_receiver, kbench_sender
+  };
+
+  static const int cpu[2] =
+  {
+    KBENCH_ANYCPU, KBENCH_ANYCPU
+  };
+
+  int ret;
+
+  g_kbench_stream = stream;
+
+  ret = kbench_threads(entry, cpu, 2);
+  if (ret >= 0)
+    {
+      ret = g_kbench.result[0] < 0 ? g_kbench.result[0] :
+                                     g_kbench.result[1];
+    }
+
+  return ret < 0 ? ret : KBENCH_XFERSIZE;
+}
+#endif /* KBENCH_HAVE_STREAM */
+
+/****************************************************************************
+ * Name: kbench_pipe_*
+ ****************************************************************************/
+
+#ifdef KBENCH_HAVE_PIPE
+static ssize_t kbench_pipe_recv(FAR uint8_t *buffer, size_t len)
+{
+  return file_read(g_kbench.filep[0], buffer, len);
+}
+
+static ssize_t kbench_pipe_send(FAR uint8_t *buffer, size_t len)
+{
+  return file_write(g_kbench.filep[1], buffer, len);
+}
+
+static const struct kbench_stream_s g_kbench_pipe =
+{
+  NULL, NULL, kbench_pipe_recv, kbench_pipe_send
+};
+#endif
+
+/****************************************************************************
+ * Name: kbench_local_*
+ ****************************************************************************/
+
+#ifdef KBENCH_HAVE_LOCAL
+static ssize_t kbench_local_recv(FAR uint8_t *buffer, size_t len)
+{
+  return psock_recv(&g_kbench.sock[0], buffer, len, 0);
+}
+
+static ssize_t kbench_local_send(FAR uint8_t *buffer, size_t len)
+{
+  return psock_send(&g_kbench.sock[1], buffer, len, 0);
+}
+
+static const struct kbench_stream_s g_kbench_local =
+{
+  NULL, NULL, kbench_local_recv, kbench_local_send
+};
+#endif
+
+/****************************************************************************
+ * Name: kbench_loopback
+ ****************************************************************************/
+
+#if defined(KBENCH_HAVE_UDP) || defined(KBENCH_HAVE_TCP)
+static void kbench_loopback(FAR struct sockaddr_in *addr)
+{
+  memset(addr, 0, sizeof(struct sockaddr_in));
+  addr->sin_family      = AF_INET;
+  addr->sin_port        = HTONS(KBENCH_PORT);
+  addr->sin_addr.s_addr = HTONL(INADDR_LOOPBACK);
+}
+#endif
+
+/****************************************************************************
+ * Name: kbench_tcp_*
+ *
+ * Description:
+ *   g_kbench.sock[0] is the listening socket, sock[1] is the client and
+ *   sock[2] is the accepted connection.
+ *
+ ****************************************************************************/
+
+#ifdef KBENCH_HAVE_TCP
+static int kbench_tcp_accept(void)
+{
+  return psock_accept(&g_kbench.sock[0], NULL, NULL, &g_kbench.sock[2]);
+}
+
+static int kbench_tcp_connect(void)
+{
+  struct sockaddr_in addr;
+
+  kbench_loopback(&addr);
+  return psock_connect(&g_kbench.sock[1], (FAR struct sockaddr *)&addr,
+                       sizeof(struct sockaddr_in));
+}
+
+static ssize_t kbench_tcp_recv(FAR uint8_t *buffer, size_t len)
+{
+  return psock_recv(&g_kbench.sock[2], buffer, len, 0);
+}
+
+static ssize_t kbench_tcp_send(FAR uint8_t *buffer, size_t len)
+{
+  return psock_send(&g_kbench.sock[1], buffer, len, 0);
+}
+
+static const struct kbench_stream_s g_kbench_tcp =
+{
+  kbench_tcp_accept, kbench_tcp_connect, kbench_tcp_recv, kbench_tcp_send
+};
+#endif
+
+/****************************************************************************
+ * Public Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: kbench_pipe
+ *
+ * Description:
+ *   Throughput of a pipe between two threads.
+ *
+ ****************************************************************************/
+
+ssize_t kbench_pipe(void)
+{
+#ifdef KBENCH_HAVE_PIPE
+  ssize_t ret;
+  int fd[2];
+
+  if (pipe2(fd, CONFIG_DEV_PIPE_SIZE) < 0)
+    {
+      return -get_errno();
+    }
+
+  ret = fs_getfilep(fd[0], &g_kbench.filep[0]);
+  if (ret >= 0)
+    {
+      ret = fs_getfilep(fd[1], &g_kbench.filep[1]);
+    }
+
+  if (ret >= 0)
+    {
+      ret = kbench_stream(&g_kbench_pipe);
+    }
+
+  close(fd[0]);
+  close(fd[1]);
+  return ret;
+#else
+  return -ENOSYS;
+#endif
+}
+
+/****************************************************************************
+ * Name: kbench_local
+ *
+ * Description:
+ *   Throughput of a pair of local stream sockets between two threads.
+ *
+ ****************************************************************************/
+
+ssize_t kbench_local(void)
+{
+#ifdef KBENCH_HAVE_LOCAL
+  ssize_t ret;
+
+  ret = psock_socketpair(PF_LOCAL, SOCK_STREAM, 0, &g_kbench.sock[0],
+                         &g_kbench.sock[1]);
+  if (ret < 0)
+    {
+      return ret;
+    }
+
+  ret = kbench_stream(&g_kbench_local);
+
+  psock_close(&g_kbench.sock[0]);
+  psock_close(&g_kbench.sock[1]);
+  return ret;
+#else
+  return -ENOSYS;
+#endif
+}
+
+/****************************************************************************
+ * Name: kbench_udp
+ *
+ * Description:
+ *   Throughput of UDP over the loopback device.  A single thread sends one
+ *   datagram and receives it before it sends the next one, so that no
+ *   datagram is dropped.  Each sample is one datagram.
+ *
+ ****************************************************************************/
+
+ssize_t kbench_udp(void)
+{
+#ifdef KBENCH_HAVE_UDP
+  struct sockaddr_in addr;
+#ifdef CONFIG_NET_SOCKOPTS
+  struct timeval tv;
+#endif
+  uint32_t start;
+  size_t nsent;
+  ssize_t ret;
+
+  ret = psock_socket(PF_INET, SOCK_DGRAM, 0, &g_kbench.sock[0]);
+  if (ret < 0)
+    {
+      return ret;
+    }
+
+  ret = psock_socket(PF_INET, SOCK_DGRAM, 0, &g_kbench.sock[1]);
+  if (ret < 0)
+    {
+      goto errout_with_rxsock;
+    }
+
+#ifdef CONFIG_NET_SOCKOPTS
+  /* Do not wait forever if a datagram is lost after all */
+
+  tv.tv_sec  = 1;
+  tv.tv_usec = 0;
+  psock_setsockopt(&g_kbench.sock[0], SOL_SOCKET, SO_RCVTIMEO, &tv,
+                   sizeof(struct timeval));
+#endif
+
+  kbench_loopback(&addr);
+  ret = psock_bind(&g_kbench.sock[0], (FAR struct sockaddr *)&addr,
+                   sizeof(struct sockaddr_in));
+  if (ret < 0)
+    {
+      goto errout_with_txsock;
+    }
+
+  memset(g_kbench.buffer[1], 0x5a, KBENCH_DGRAMSIZE);
+
+  for (nsent = 0; nsent < KBENCH_XFERSIZE; nsent += KBENCH_DGRAMSIZE)
+    {
+      start = kbench_gettime();
+      ret = psock_sendto(&g_kbench.sock[1], g_kbench.buffer[1],
+                         KBENCH_DGRAMSIZE, 0, (FAR struct sockaddr *)&addr,
+                         sizeof(struct sockaddr_in));
+      if (ret < 0)
+        {
+          goto errout_with_txsock;
+        }
+
+      ret = psock_recvfrom(&g_kbench.sock[0], g_kbench.buffer[0],
+                           KBENCH_DGRAMSIZE, 0, NULL, NULL);
+      if (ret < 0)
+        {
+          goto errout_with_txsock;
+        }
+
+      kbench_sample(start);
+    }
+
+  ret = nsent;
+
+errout_with_txsock:
+  psock_close(&g_kbench.sock[1]);
+
+errout_with_rxsock:
+  psock_close(&g_kbench.sock[0]);
+  return ret;
+#else
+  return -ENOSYS;
+#endif
+}
+
+/****************************************************************************
+ * Name: kbench_tcp
+ *
+ * Description:
+ *   Throughput of TCP over the loopback device between two threads.
+ *
+ ****************************************************************************/
+
+ssize_t kbench_tcp(void)
+{
+#ifdef KBENCH_HAVE_TCP
+  struct sockaddr_in addr;
+  ssize_t ret;
+
+  ret = psock_socket(PF_INET, SOCK_STREAM, 0, &g_kbench.sock[0]);
+  if (ret < 0)
+    {
+      return ret;
+    }
+
+  ret = psock_socket(PF_INET, SOCK_STREAM, 0, &g_kbench.sock[1]);
+  if (ret < 0)
+    {
+      goto errout_with_listener;
+    }
+
+  kbench_loopback(&addr);
+  ret = psock_bind(&g_kbench.sock[0], (FAR struct sockaddr *)&addr,
+                   sizeof(struct sockaddr_in));
+  if (ret >= 0)
+    {
+      ret = psock_listen(&g_kbench.sock[0], 1);
+    }
+
+  if (ret >= 0)
+    {
+      ret = kbench_stream(&g_kbench_tcp);
+
+      /* The connection exists only if the receiver has accepted it */
+
+      if (g_kbench.sock[2].s_conn != NULL)
+        {
+          psock_close(&g_kbench.sock[2]);
+        }
+    }
+
+  psock_close(&g_kbench.sock[1]);
+
+errout_with_listener:
+  psock_close(&g_kbench.sock[0]);
+  return ret;
+#else
+  return -ENOSYS;
+#endif
+}
+
+#endif /* CONFIG_SCHED_BENCHMARK */
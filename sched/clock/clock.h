@@ -101,4 +101,8 @@ int  clock_time2ticks(FAR const struct timespec *reltime,
                       FAR sclock_t *ticks);
 int  clock_ticks2time(sclock_t ticks, FAR struct timespec *reltime);
 
+#ifdef CONFIG_CLOCK_TIMEPAGE
+void clock_timepage_tick(void);
+#endif
+
 #endif /* __SCHED_CLOCK_CLOCK_H */
@@ -197,6 +197,10 @@ static void clock_inittime(void)
     }
 #endif /* !CONFIG_SCHED_TICKLESS */
 
+#ifdef CONFIG_CLOCK_TIMEPAGE
+  clock_timepage_update();
+#endif
+
 #else
   clock_inittimekeeping();
 #endif
@@ -399,6 +403,10 @@ void clock_resynchronize(FAR struct timespec *rtc_diff)
 
       g_system_timer += SEC2TICK(rtc_diff->tv_sec);
       g_system_timer += NSEC2TICK(rtc_diff->tv_nsec);
+
+#ifdef CONFIG_CLOCK_TIMEPAGE
+      clock_timepage_update();
+#endif
     }
 
 skip:
@@ -422,5 +430,11 @@ void clock_timer(void)
   /* Increment the per-tick system counter */
 
   g_system_timer++;
+
+#ifdef CONFIG_CLOCK_TIMEPAGE
+  /* Advance the user-readable copy of the time */
+
+  clock_timepage_tick();
+#endif
 }
 #endif
@@ -123,6 +123,12 @@ int clock_settime(clockid_t clock_id, FAR const struct timespec *tp)
         }
 #endif
 
+#ifdef CONFIG_CLOCK_TIMEPAGE
+      /* Publish the new base time to user space */
+
+      clock_timepage_update();
+#endif
+
       leave_critical_section(flags);
 
       sinfo("basetime=(%ld,%lu) bias=(%ld,%lu)\n",
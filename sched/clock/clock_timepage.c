@@ -0,0 +1,144 @@
+/****************************************************************************
+ * sched/clock/clock_timepage.c
+ *
+ *   Copyright (C) 2020 Gregory Nutt. All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in
+ *    the documentation and/or other materials provided with the
+ *    distribution.
+ * 3. Neither the name NuttX nor the names of its contributors may be
+ *    used to endorse or promote products derived from this software
+ *    without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+ * FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE
+ * COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+ * INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,
+ * BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS
+ * OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED
+ * AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ * LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN
+ * ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ *
+ ****************************************************************************/
+
+/****************************************************************************
+ * Included Files
+ ****************************************************************************/
+
+#include <nuttx/config.h>
+
+#include <stdint.h>
+#include <time.h>
+
+#include <nuttx/clock.h>
+#include <nuttx/spinlock.h>
+#include <nuttx/userspace.h>
+
+#include "clock/clock.h"
+
+#ifdef CONFIG_CLOCK_TIMEPAGE
+
+/****************************************************************************
+ * Pre-processor Definitions
+ ****************************************************************************/
+
+/* SP_DMB() is provided only with CONFIG_SPINLOCK.  On a single CPU it is
+ * enough that the compiler does not reorder the accesses.
+ */
+
+#ifndef SP_DMB
+#  define SP_DMB() __asm__ __volatile__ ("" ::: "memory")
+#endif
+
+/****************************************************************************
+ * Private Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: clock_timepage_begin/end
+ *
+ * Description:
+ *   Bracket an update of the time page.  The sequence count is odd while
+ *   the update is in progress so that readers retry.
+ *
+ ****************************************************************************/
+
+static inline void clock_timepage_begin(FAR struct clock_timepage_s *page)
+{
+  page->tp_seq++;
+  SP_DMB();
+}
+
+static inline void clock_timepage_end(FAR struct clock_timepage_s *page)
+{
+  SP_DMB();
+  page->tp_seq++;
+}
+
+/****************************************************************************
+ * Public Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: clock_timepage_update
+ *
+ * Description:
+ *   Rewrite the time page from the system timer and the base time.  Called
+ *   whenever either is changed other than by the periodic tick.
+ *
+ * Assumptions:
+ *   Called from within a critical section.
+ *
+ ****************************************************************************/
+
+void clock_timepage_update(void)
+{
+  FAR struct clock_timepage_s *page = CLOCK_TIMEPAGE;
+  struct timespec ts;
+
+  clock_systimespec(&ts);
+
+  clock_timepage_begin(page);
+  page->tp_monotonic.tv_sec  = ts.tv_sec;
+  page->tp_monotonic.tv_nsec = ts.tv_nsec;
+  page->tp_basetime.tv_sec   = g_basetime.tv_sec;
+  page->tp_basetime.tv_nsec  = g_basetime.tv_nsec;
+  clock_timepage_end(page);
+}
+
+/****************************************************************************
+ * Name: clock_timepage_tick
+ *
+ * Description:
+ *   Advance the time page by one system tick.  Called from clock_timer()
+ *   right after the system timer is incremented.
+ *
+ ****************************************************************************/
+
+void clock_timepage_tick(void)
+{
+  FAR struct clock_timepage_s *page = CLOCK_TIMEPAGE;
+
+  clock_timepage_begin(page);
+  page->tp_monotonic.tv_nsec += NSEC_PER_TICK;
+  if (page->tp_monotonic.tv_nsec >= NSEC_PER_SEC)
+    {
+      page->tp_monotonic.tv_nsec -= NSEC_PER_SEC;
+      page->tp_monotonic.tv_sec++;
+    }
+
+  clock_timepage_end(page);
+}
+
+#endif /* CONFIG_CLOCK_TIMEPAGE */
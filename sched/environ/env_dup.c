@@ -42,11 +42,9 @@
 #ifndef CONFIG_DISABLE_ENVIRON
 
 #include <sys/types.h>
+#include <stdint.h>
 #include <sched.h>
-#include <string.h>
-#include <errno.h>
-
-#include <nuttx/kmalloc.h>
+#include <assert.h>
 
 #include "sched/sched.h"
 #include "environ/environ.h"
@@ -59,13 +57,15 @@
  * Name: env_dup
  *
  * Description:
- *   Copy the internal environment structure of a task.  This is the action
- *   that is performed when a new task is created: The new task has a private,
- *   exact duplicate of the parent task's environment.
+ *   Inherit the environment of the parent task.  This is the action that is
+ *   performed when a new task is created: The new task shares the parent
+ *   task's environment until either of them modifies it.  In the kernel
+ *   build, where each task group has its own address space, the new task
+ *   receives a private, exact duplicate of the parent task's environment.
  *
  * Input Parameters:
- *   group - The child task group to receive the newly allocated copy of the
- *           parent task groups environment structure.
+ *   group - The child task group to receive the parent task group's
+ *           environment.
  *
  * Returned Value:
  *   zero on success
@@ -78,8 +78,7 @@
 int env_dup(FAR struct task_group_s *group)
 {
   FAR struct tcb_s *ptcb = this_task();
-  FAR char *envp = NULL;
-  size_t envlen;
+  FAR struct environ_s *env;
   int ret = OK;
 
   DEBUGASSERT(group != NULL && ptcb != NULL && ptcb->group != NULL);
@@ -92,44 +91,32 @@ int env_dup(FAR struct task_group_s *group)
 
   /* Does the parent task have an environment? */
 
-  if (ptcb->group != NULL && ptcb->group->tg_envp != NULL)
+  env = ptcb->group->tg_env;
+  if (env != NULL)
     {
-      /* Yes.. The parent task has an environment allocation. */
+      /* Yes.. Just take another reference to it.  It is copied when either
+       * task group modifies it.
+       */
 
-      envlen = ptcb->group->tg_envsize;
-      envp   = NULL;
+      DEBUGASSERT(env->ev_crefs < UINT16_MAX);
+      env->ev_crefs++;
+      group->tg_env = env;
 
-      /* A special case is that the parent has an "empty" environment
-       * allocation, i.e., there is an allocation in place but it
-       * contains no variable definitions and, hence, envlen == 0.
+#ifdef CONFIG_BUILD_KERNEL
+      /* The environment strings live in the address space of the parent.
+       * The child needs its own copy of them.
        */
 
-      if (envlen > 0)
+      ret = env_unshare(group);
+      if (ret < 0)
         {
-          /* There is an environment, duplicate it */
-
-          envp = (FAR char *)kumm_malloc(envlen);
-          if (envp == NULL)
-            {
-              /* The parent's environment can not be inherited due to a
-               * failure in the allocation of the child environment.
-               */
-
-              envlen = 0;
-              ret    = -ENOMEM;
-            }
-          else
-            {
-              /* Duplicate the parent environment. */
-
-              memcpy(envp, ptcb->group->tg_envp, envlen);
-            }
-        }
+          /* The parent's environment can not be inherited due to a
+           * failure in the allocation of the child environment.
+           */
 
-      /* Save the size and child environment allocation. */
-
-      group->tg_envsize = envlen;
-      group->tg_envp    = envp;
+          env_release(group);
+        }
+#endif
     }
 
   sched_unlock();
@@ -42,8 +42,12 @@
 #ifndef CONFIG_DISABLE_ENVIRON
 
 #include <stdbool.h>
+#include <stdint.h>
 #include <string.h>
 #include <sched.h>
+#include <assert.h>
+
+#include <nuttx/kmalloc.h>
 
 #include "environ/environ.h"
 
@@ -73,6 +77,80 @@ static bool env_cmpname(const char *pszname, const char *peqname)
   return false;
 }
 
+/****************************************************************************
+ * Name: env_hashname
+ *
+ * Description:
+ *   Hash the name of a variable.  The name ends with either '\0' (a name
+ *   being looked up) or '=' (a name=value string in the environment).
+ *
+ ****************************************************************************/
+
+static unsigned int env_hashname(FAR const char *name)
+{
+  unsigned int hash = 5381;
+
+  for (; *name != '\0' && *name != '='; name++)
+    {
+      hash = (hash * 33) ^ (unsigned char)*name;
+    }
+
+  return hash;
+}
+
+/****************************************************************************
+ * Name: env_buildhash
+ *
+ * Description:
+ *   Build the hash index of the environment.  The index is an open
+ *   addressing table with at least twice as many slots as there are
+ *   variables.  Nothing happens if the index cannot be allocated; lookups
+ *   then fall back to the linear search.
+ *
+ ****************************************************************************/
+
+static void env_buildhash(FAR struct environ_s *env)
+{
+  FAR char *ptr;
+  FAR char *end;
+  unsigned int nvars = 0;
+  unsigned int nslots;
+  unsigned int ndx;
+
+  /* Count the variables to size the index */
+
+  end = &env->ev_envp[env->ev_size];
+  for (ptr = env->ev_envp; ptr < end; ptr += (strlen(ptr) + 1))
+    {
+      nvars++;
+    }
+
+  for (nslots = ENV_HASH_MINSLOTS; nslots < 2 * nvars; nslots <<= 1);
+
+  env->ev_hash = (FAR uint16_t *)kmm_zalloc(nslots * sizeof(uint16_t));
+  if (env->ev_hash == NULL)
+    {
+      return;
+    }
+
+  env->ev_nslots = nslots;
+
+  /* Then enter the offset + 1 of each variable into the first free slot at
+   * or after the slot selected by the hash of its name.
+   */
+
+  for (ptr = env->ev_envp; ptr < end; ptr += (strlen(ptr) + 1))
+    {
+      ndx = env_hashname(ptr) & (nslots - 1);
+      while (env->ev_hash[ndx] != 0)
+        {
+          ndx = (ndx + 1) & (nslots - 1);
+        }
+
+      env->ev_hash[ndx] = (uint16_t)(ptr - env->ev_envp) + 1;
+    }
+}
+
 /****************************************************************************
  * Public Functions
  ****************************************************************************/
@@ -99,17 +177,53 @@ static bool env_cmpname(const char *pszname, const char *peqname)
 
 FAR char *env_findvar(FAR struct task_group_s *group, FAR const char *pname)
 {
+  FAR struct environ_s *env;
   FAR char *ptr;
   FAR char *end;
+  unsigned int ndx;
 
   /* Verify input parameters */
 
   DEBUGASSERT(group != NULL && pname != NULL);
 
+  env = group->tg_env;
+  if (env == NULL || env->ev_size == 0)
+    {
+      return NULL;
+    }
+
+  /* (Re-)build the hash index if it was discarded by a modification */
+
+  if (env->ev_hash == NULL && env->ev_size < ENV_HASH_MAXSIZE)
+    {
+      env_buildhash(env);
+    }
+
+  if (env->ev_hash != NULL)
+    {
+      /* Probe the slots from the one selected by the hash of the name up to
+       * the first empty slot.
+       */
+
+      ndx = env_hashname(pname) & (env->ev_nslots - 1);
+      while (env->ev_hash[ndx] != 0)
+        {
+          ptr = &env->ev_envp[env->ev_hash[ndx] - 1];
+          if (env_cmpname(pname, ptr))
+            {
+              return ptr;
+            }
+
+          ndx = (ndx + 1) & (env->ev_nslots - 1);
+        }
+
+      return NULL;
+    }
+
   /* Search for a name=value string with matching name */
 
-  end = &group->tg_envp[group->tg_envsize];
-  for (ptr = group->tg_envp;
+  end = &env->ev_envp[env->ev_size];
+  for (ptr = env->ev_envp;
        ptr < end && !env_cmpname(pname, ptr);
        ptr += (strlen(ptr) + 1));
 
@@ -85,10 +85,15 @@ int env_foreach(FAR struct task_group_s *group, env_foreach_t cb, FAR void *arg)
 
   DEBUGASSERT(group != NULL && cb != NULL);
 
-  /* Search for a name=value string with matching name */
+  if (group->tg_env == NULL)
+    {
+      return OK;
+    }
+
+  /* Visit each name=value string */
 
-  end = &group->tg_envp[group->tg_envsize];
-  for (ptr = group->tg_envp; ptr < end; ptr += (strlen(ptr) + 1))
+  end = &group->tg_env->ev_envp[group->tg_env->ev_size];
+  for (ptr = group->tg_env->ev_envp; ptr < end; ptr += (strlen(ptr) + 1))
     {
       /* Perform the callback */
 
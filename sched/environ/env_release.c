@@ -42,6 +42,7 @@
 #ifndef CONFIG_DISABLE_ENVIRON
 
 #include <sched.h>
+#include <assert.h>
 #include <errno.h>
 
 #include <nuttx/kmalloc.h>
@@ -56,10 +57,10 @@
  * Name: env_release
  *
  * Description:
- *   env_release() is called only from group_leave() when the last member of
- *   a task group exits.  The env_release() function clears the environment
- *   of all name-value pairs and sets the value of the external variable
- *   environ to NULL.
+ *   env_release() is called from group_leave() when the last member of a
+ *   task group exits and from clearenv().  The env_release() function
+ *   clears the environment of all name-value pairs and drops the task
+ *   group's reference to a possibly shared environment.
  *
  * Input Parameters:
  *   group - Identifies the task group containing the environment structure
@@ -75,23 +76,41 @@
 
 void env_release(FAR struct task_group_s *group)
 {
+  FAR struct environ_s *env;
+
   DEBUGASSERT(group != NULL);
 
-  /* Free any allocate environment strings */
+  /* The environment may be shared with other task groups */
 
-  if (group->tg_envp)
+  sched_lock();
+  env = group->tg_env;
+  if (env != NULL)
     {
-      /* Free the environment */
+      /* Free the environment when the last task group using it lets it go */
+
+      DEBUGASSERT(env->ev_crefs > 0);
+      if (--env->ev_crefs == 0)
+        {
+          if (env->ev_envp != NULL)
+            {
+              sched_ufree(env->ev_envp);
+            }
+
+          if (env->ev_hash != NULL)
+            {
+              sched_kfree(env->ev_hash);
+            }
 
-      sched_ufree(group->tg_envp);
+          sched_kfree(env);
+        }
     }
 
   /* In any event, make sure that all environment-related varialbles in the
    * task group structure are reset to initial values.
    */
 
-  group->tg_envsize = 0;
-  group->tg_envp = NULL;
+  group->tg_env = NULL;
+  sched_unlock();
 }
 
 #endif /* CONFIG_DISABLE_ENVIRON */
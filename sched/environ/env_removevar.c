@@ -43,6 +43,7 @@
 
 #include <string.h>
 #include <sched.h>
+#include <assert.h>
 
 #include "environ/environ.h"
 
@@ -73,18 +74,21 @@
 
 int env_removevar(FAR struct task_group_s *group, FAR char *pvar)
 {
+  FAR struct environ_s *env;
   FAR char *end;    /* Pointer to the end+1 of the environment */
   int alloc;        /* Size of the allocated environment */
   int ret = ERROR;
 
-  DEBUGASSERT(group != NULL && pvar != NULL);
+  DEBUGASSERT(group != NULL && group->tg_env != NULL && pvar != NULL);
+  env = group->tg_env;
+  DEBUGASSERT(env->ev_crefs == 1 && env->ev_hash == NULL);
 
   /* Verify that the pointer lies within the environment region */
 
-  alloc = group->tg_envsize;             /* Size of the allocated environment */
-  end   = &group->tg_envp[alloc];        /* Pointer to the end+1 of the environment */
+  alloc = env->ev_size;                  /* Size of the allocated environment */
+  end   = &env->ev_envp[alloc];        /* Pointer to the end+1 of the environment */
 
-  if (pvar >= group->tg_envp && pvar < end)
+  if (pvar >= env->ev_envp && pvar < end)
     {
       /* Set up for the removal */
 
@@ -107,7 +111,7 @@ int env_removevar(FAR struct task_group_s *group, FAR char *pvar)
        * caller may add more stuff to the environment.
        */
 
-      group->tg_envsize -= len;
+      env->ev_size -= len;
       ret = OK;
     }
 
@@ -83,8 +83,10 @@ int setenv(FAR const char *name, FAR const char *value, int overwrite)
 {
   FAR struct tcb_s *rtcb;
   FAR struct task_group_s *group;
+  FAR struct environ_s *env;
   FAR char *pvar;
   FAR char *newenvp;
+  size_t offset = 0;
   int newsize;
   int varlen;
   int ret = OK;
@@ -126,7 +128,8 @@ int setenv(FAR const char *name, FAR const char *value, int overwrite)
 
   /* Check if the variable already exists */
 
-  if (group->tg_envp && (pvar = env_findvar(group, name)) != NULL)
+  pvar = env_findvar(group, name);
+  if (pvar != NULL)
     {
       /* It does! Do we have permission to overwrite the existing value? */
 
@@ -138,12 +141,29 @@ int setenv(FAR const char *name, FAR const char *value, int overwrite)
           return OK;
         }
 
-      /* Yes.. just remove the name=value pair from the environment.  It will
-       * be added again below.  Note that we are responsible for reallocating
-       * the environment buffer; this will happen below.
+      offset = pvar - group->tg_env->ev_envp;
+    }
+
+  /* Get a private copy of the environment that we can modify.  The copy
+   * has the same layout as the shared environment.
+   */
+
+  ret = env_unshare(group);
+  if (ret < 0)
+    {
+      ret = -ret;
+      goto errout_with_lock;
+    }
+
+  env = group->tg_env;
+  if (pvar != NULL)
+    {
+      /* Remove the name=value pair from the environment.  It will be added
+       * again below.  Note that we are responsible for reallocating the
+       * environment buffer; this will happen below.
        */
 
-      env_removevar(group, pvar);
+      env_removevar(group, &env->ev_envp[offset]);
     }
 
   /* Get the size of the new name=value string.  The +2 is for the '=' and for
@@ -154,17 +174,17 @@ int setenv(FAR const char *name, FAR const char *value, int overwrite)
 
   /* Then allocate or reallocate the environment buffer */
 
-  if (group->tg_envp)
+  if (env->ev_envp)
     {
-      newsize = group->tg_envsize + varlen;
-      newenvp = (FAR char *)kumm_realloc(group->tg_envp, newsize);
+      newsize = env->ev_size + varlen;
+      newenvp = (FAR char *)kumm_realloc(env->ev_envp, newsize);
       if (!newenvp)
         {
           ret = ENOMEM;
           goto errout_with_lock;
         }
 
-      pvar = &newenvp[group->tg_envsize];
+      pvar = &newenvp[env->ev_size];
     }
   else
     {
@@ -181,8 +201,8 @@ int setenv(FAR const char *name, FAR const char *value, int overwrite)
 
   /* Save the new buffer and size */
 
-  group->tg_envp    = newenvp;
-  group->tg_envsize = newsize;
+  env->ev_envp = newenvp;
+  env->ev_size = newsize;
 
   /* Now, put the new name=value string into the environment buffer */
 
@@ -76,7 +76,9 @@ int unsetenv(FAR const char *name)
 {
   FAR struct tcb_s *rtcb = this_task();
   FAR struct task_group_s *group = rtcb->group;
+  FAR struct environ_s *env;
   FAR char *pvar;
+  size_t offset;
   FAR char *newenvp;
   int newsize;
   int ret = OK;
@@ -88,30 +90,44 @@ int unsetenv(FAR const char *name)
   sched_lock();
   if (group && (pvar = env_findvar(group, name)) != NULL)
     {
-      /* It does!  Remove the name=value pair from the environment. */
+      /* It does!  Get a private copy of the environment that we can
+       * modify.  The copy has the same layout as the shared environment.
+       */
 
-      env_removevar(group, pvar);
+      offset = pvar - group->tg_env->ev_envp;
+      ret    = env_unshare(group);
+      if (ret < 0)
+        {
+          sched_unlock();
+          set_errno(-ret);
+          return ERROR;
+        }
+
+      /* Remove the name=value pair from the environment. */
+
+      env = group->tg_env;
+      env_removevar(group, &env->ev_envp[offset]);
 
       /* Reallocate the new environment buffer */
 
-      newsize = group->tg_envsize;
+      newsize = env->ev_size;
       if (newsize <= 0)
         {
           /* Free the old environment (if there was one) */
 
-          if (group->tg_envp != NULL)
+          if (env->ev_envp != NULL)
             {
-              kumm_free(group->tg_envp);
-              group->tg_envp = NULL;
+              kumm_free(env->ev_envp);
+              env->ev_envp = NULL;
             }
 
-          group->tg_envsize = 0;
+          env->ev_size = 0;
         }
       else
         {
           /* Reallocate the environment to reclaim a little memory */
 
-          newenvp = (FAR char *)kumm_realloc(group->tg_envp, newsize);
+          newenvp = (FAR char *)kumm_realloc(env->ev_envp, newsize);
           if (newenvp == NULL)
             {
               set_errno(ENOMEM);
@@ -123,7 +139,7 @@ int unsetenv(FAR const char *name)
                * to reallocation).
                */
 
-              group->tg_envp = newenvp;
+              env->ev_envp = newenvp;
             }
         }
     }
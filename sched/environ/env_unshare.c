@@ -0,0 +1,140 @@
+/****************************************************************************
+ * sched/environ/env_unshare.c
+ *
+ *   Copyright (C) 2020 Gregory Nutt. All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in
+ *    the documentation and/or other materials provided with the
+ *    distribution.
+ * 3. Neither the name NuttX nor the names of its contributors may be
+ *    used to endorse or promote products derived from this software
+ *    without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+ * FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE
+ * COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+ * INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,
+ * BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS
+ * OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED
+ * AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ * LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN
+ * ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ *
+ ****************************************************************************/
+
+/****************************************************************************
+ * Included Files
+ ****************************************************************************/
+
+#include <nuttx/config.h>
+
+#ifndef CONFIG_DISABLE_ENVIRON
+
+#include <sched.h>
+#include <string.h>
+#include <assert.h>
+#include <errno.h>
+
+#include <nuttx/kmalloc.h>
+
+#include "environ/environ.h"
+
+/****************************************************************************
+ * Public Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: env_unshare
+ *
+ * Description:
+ *   Prepare the environment of the task group for modification:  If the
+ *   environment is shared with other task groups, replace it with a private
+ *   copy.  If the task group has no environment yet, allocate an empty
+ *   one.  The hash index is discarded; it is rebuilt by the next lookup.
+ *
+ * Input Parameters:
+ *   group - The task group whose environment is about to be modified.
+ *
+ * Returned Value:
+ *   Zero on success; -ENOMEM if the private copy could not be allocated.
+ *
+ * Assumptions:
+ *   - Not called from an interrupt handler
+ *   - Pre-emption is disabled by caller
+ *
+ ****************************************************************************/
+
+int env_unshare(FAR struct task_group_s *group)
+{
+  FAR struct environ_s *env;
+  FAR struct environ_s *newenv;
+
+  DEBUGASSERT(group != NULL);
+
+  env = group->tg_env;
+  if (env != NULL && env->ev_crefs == 1)
+    {
+      /* The environment is already private.  Only the hash index becomes
+       * stale when it is modified.
+       */
+
+      if (env->ev_hash != NULL)
+        {
+          kmm_free(env->ev_hash);
+          env->ev_hash   = NULL;
+          env->ev_nslots = 0;
+        }
+
+      return OK;
+    }
+
+  /* Allocate a private environment */
+
+  newenv = (FAR struct environ_s *)kmm_zalloc(sizeof(struct environ_s));
+  if (newenv == NULL)
+    {
+      return -ENOMEM;
+    }
+
+  newenv->ev_crefs = 1;
+
+  /* And copy the shared environment strings into it */
+
+  if (env != NULL && env->ev_size > 0)
+    {
+      newenv->ev_envp = (FAR char *)kumm_malloc(env->ev_size);
+      if (newenv->ev_envp == NULL)
+        {
+          kmm_free(newenv);
+          return -ENOMEM;
+        }
+
+      memcpy(newenv->ev_envp, env->ev_envp, env->ev_size);
+      newenv->ev_size = env->ev_size;
+    }
+
+  /* Drop the reference to the shared environment.  Other task groups still
+   * hold references, so it is not freed here.
+   */
+
+  if (env != NULL)
+    {
+      DEBUGASSERT(env->ev_crefs > 1);
+      env->ev_crefs--;
+    }
+
+  group->tg_env = newenv;
+  return OK;
+}
+
+#endif /* CONFIG_DISABLE_ENVIRON */
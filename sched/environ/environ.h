@@ -44,6 +44,8 @@
 #include <nuttx/config.h>
 #include <nuttx/sched.h>
 
+#include <stdint.h>
+
 /****************************************************************************
  * Pre-processor Definitions
  ****************************************************************************/
@@ -53,6 +55,35 @@
 #  define env_release(group) (0)
 #else
 
+/* Sizes of the hash index of the environment variables.  The index holds
+ * the offset (plus one) of each name=value string in a 16-bit slot, so it
+ * is not used for environments of 64KiB or more.
+ */
+
+#define ENV_HASH_MINSLOTS  8
+#define ENV_HASH_MAXSIZE   UINT16_MAX
+
+/****************************************************************************
+ * Public Types
+ ****************************************************************************/
+
+/* This structure describes the environment of a task group.  A new task
+ * group shares the environment of its parent; the environment is only
+ * copied when one of the sharing task groups modifies it (copy-on-write).
+ *
+ * The structure itself and the hash index are kernel data.  The strings
+ * must be in user memory because getenv() returns pointers into them.
+ */
+
+struct environ_s
+{
+  uint16_t      ev_crefs;  /* Number of task groups sharing the environment */
+  FAR uint16_t *ev_hash;   /* Hash index: offset + 1 of each variable */
+  unsigned int  ev_nslots; /* Number of slots in ev_hash (power of two) */
+  size_t        ev_size;   /* Size of the name=value strings in ev_envp */
+  FAR char     *ev_envp;   /* name=value strings, each NUL terminated */
+};
+
 /****************************************************************************
  * Public Data
  ****************************************************************************/
@@ -73,9 +104,11 @@ extern "C"
  * Name: env_dup
  *
  * Description:
- *   Copy the internal environment structure of a task.  This is the action
- *   that is performed when a new task is created: The new task has a private,
- *   exact duplicate of the parent task's environment.
+ *   Inherit the environment of the parent task.  This is the action that is
+ *   performed when a new task is created: The new task shares the parent
+ *   task's environment until either of them modifies it.  In the kernel
+ *   build, where each task group has its own address space, the new task
+ *   receives a private, exact duplicate of the parent task's environment.
  *
  * Input Parameters:
  *   group - The child task group to receive the newly allocated copy of the
@@ -95,10 +128,10 @@ int env_dup(FAR struct task_group_s *group);
  * Name: env_release
  *
  * Description:
- *   env_release() is called only from group_leave() when the last member of
- *   a task group exits.  The env_release() function clears the environment
- *   of all name-value pairs and sets the value of the external variable
- *   environ to NULL.
+ *   env_release() is called from group_leave() when the last member of a
+ *   task group exits and from clearenv().  The env_release() function
+ *   clears the environment of all name-value pairs and drops the task
+ *   group's reference to a possibly shared environment.
  *
  * Input Parameters:
  *   group - Identifies the task group containing the environment structure
@@ -114,6 +147,29 @@ int env_dup(FAR struct task_group_s *group);
 
 void env_release(FAR struct task_group_s *group);
 
+/****************************************************************************
+ * Name: env_unshare
+ *
+ * Description:
+ *   Prepare the environment of the task group for modification:  If the
+ *   environment is shared with other task groups, replace it with a private
+ *   copy.  If the task group has no environment yet, allocate an empty
+ *   one.  The hash index is discarded; it is rebuilt by the next lookup.
+ *
+ * Input Parameters:
+ *   group - The task group whose environment is about to be modified.
+ *
+ * Returned Value:
+ *   Zero on success; -ENOMEM if the private copy could not be allocated.
+ *
+ * Assumptions:
+ *   - Not called from an interrupt handler
+ *   - Pre-emption is disabled by caller
+ *
+ ****************************************************************************/
+
+int env_unshare(FAR struct task_group_s *group);
+
 /****************************************************************************
  * Name: env_findvar
  *
@@ -153,6 +209,7 @@ FAR char *env_findvar(FAR struct task_group_s *group, FAR const char *pname);
  * Assumptions:
  *   - Not called from an interrupt handler
  *   - Caller has pre-emption disabled
+ *   - Caller has called env_unshare()
  *   - Caller will reallocate the environment structure to the correct size
  *
  ****************************************************************************/
@@ -0,0 +1,91 @@
+/****************************************************************************
+ * sched/event/event.h
+ *
+ *   Copyright (C) 2020 Gregory Nutt. All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in
+ *    the documentation and/or other materials provided with the
+ *    distribution.
+ * 3. Neither the name NuttX nor the names of its contributors may be
+ *    used to endorse or promote products derived from this software
+ *    without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+ * FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE
+ * COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+ * INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,
+ * BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS
+ * OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED
+ * AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ * LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN
+ * ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ *
+ ****************************************************************************/
+
+#ifndef __SCHED_EVENT_EVENT_H
+#define __SCHED_EVENT_EVENT_H
+
+/****************************************************************************
+ * Included Files
+ ****************************************************************************/
+
+#include <nuttx/config.h>
+#include <nuttx/compiler.h>
+#include <nuttx/event.h>
+
+#include <stdbool.h>
+#include <semaphore.h>
+#include <queue.h>
+
+/****************************************************************************
+ * Public Types
+ ****************************************************************************/
+
+/* This describes one task waiting on an event group.  It lives on the
+ * stack of the waiting task.
+ */
+
+struct nxevent_wait_s
+{
+  dq_entry_t node;                /* Supports a doubly linked list */
+  nxevent_mask_t events;          /* The awaited events */
+  nxevent_mask_t result;          /* The events when the wait was satisfied */
+  uint8_t eflags;                 /* NXEVENT_WAIT_ALL and NXEVENT_WAIT_RESET */
+  bool done;                      /* True: Satisfied and removed from list */
+  sem_t sem;                      /* Posted when satisfied */
+};
+
+/****************************************************************************
+ * Inline Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: nxevent_match
+ *
+ * Description:
+ *   Return true if the set events satisfy a wait for events with eflags.
+ *
+ ****************************************************************************/
+
+static inline bool nxevent_match(nxevent_mask_t set, nxevent_mask_t events,
+                                 int eflags)
+{
+  if ((eflags & NXEVENT_WAIT_ALL) != 0)
+    {
+      return (set & events) == events;
+    }
+
+  return (set & events) != 0;
+}
+
+#endif /* __SCHED_EVENT_EVENT_H */
@@ -0,0 +1,137 @@
+/****************************************************************************
+ * sched/event/event_post.c
+ *
+ *   Copyright (C) 2020 Gregory Nutt. All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in
+ *    the documentation and/or other materials provided with the
+ *    distribution.
+ * 3. Neither the name NuttX nor the names of its contributors may be
+ *    used to endorse or promote products derived from this software
+ *    without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+ * FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE
+ * COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+ * INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,
+ * BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS
+ * OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED
+ * AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ * LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN
+ * ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ *
+ ****************************************************************************/
+
+/****************************************************************************
+ * Included Files
+ ****************************************************************************/
+
+#include <nuttx/config.h>
+
+#include <nuttx/irq.h>
+#include <nuttx/semaphore.h>
+#include <nuttx/event.h>
+
+#include "event/event.h"
+
+/****************************************************************************
+ * Public Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: nxevent_post
+ *
+ * Description:
+ *   Set events and wake up the waiting tasks whose condition is now met,
+ *   in the order in which they started waiting.  A waiter that specified
+ *   NXEVENT_WAIT_RESET consumes its events before the next waiter is
+ *   checked.  This function may be called from interrupt handlers.
+ *
+ * Input Parameters:
+ *   event  - The event group
+ *   events - The events to set
+ *
+ * Returned Value:
+ *   Zero (OK) is always returned.
+ *
+ ****************************************************************************/
+
+int nxevent_post(FAR struct nxevent_s *event, nxevent_mask_t events)
+{
+  FAR struct nxevent_wait_s *wait;
+  FAR dq_entry_t *next;
+  FAR dq_entry_t *node;
+  irqstate_t flags;
+
+  DEBUGASSERT(event != NULL);
+
+  flags = enter_critical_section();
+  event->events |= events;
+
+  for (node = dq_peek(&event->waitlist); node != NULL; node = next)
+    {
+      next = dq_next(node);
+      wait = (FAR struct nxevent_wait_s *)node;
+
+      if (nxevent_match(event->events, wait->events, wait->eflags))
+        {
+          wait->result = event->events;
+          if ((wait->eflags & NXEVENT_WAIT_RESET) != 0)
+            {
+              event->events &= ~wait->events;
+            }
+
+          /* The waiter is removed here so that a timeout racing with this
+           * wakeup still reports success.
+           */
+
+          dq_rem(node, &event->waitlist);
+          wait->done = true;
+          nxsem_post(&wait->sem);
+        }
+    }
+
+  leave_critical_section(flags);
+  return OK;
+}
+
+/****************************************************************************
+ * Name: nxevent_clear
+ *
+ * Description:
+ *   Clear events.  This function may be called from interrupt handlers.
+ *
+ * Input Parameters:
+ *   event  - The event group
+ *   events - The events to clear
+ *
+ * Returned Value:
+ *   The set of events before they were cleared.
+ *
+ ****************************************************************************/
+
+nxevent_mask_t nxevent_clear(FAR struct nxevent_s *event,
+                             nxevent_mask_t events)
+{
+  nxevent_mask_t old;
+  irqstate_t flags;
+
+  DEBUGASSERT(event != NULL);
+
+  flags = enter_critical_section();
+  old = event->events;
+  event->events = old & ~events;
+  leave_critical_section(flags);
+
+  return old;
+}
@@ -0,0 +1,203 @@
+/****************************************************************************
+ * sched/event/event_wait.c
+ *
+ *   Copyright (C) 2020 Gregory Nutt. All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in
+ *    the documentation and/or other materials provided with the
+ *    distribution.
+ * 3. Neither the name NuttX nor the names of its contributors may be
+ *    used to endorse or promote products derived from this software
+ *    without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+ * FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE
+ * COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+ * INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,
+ * BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS
+ * OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED
+ * AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ * LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN
+ * ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ *
+ ****************************************************************************/
+
+/****************************************************************************
+ * Included Files
+ ****************************************************************************/
+
+#include <nuttx/config.h>
+
+#include <stdbool.h>
+#include <assert.h>
+#include <errno.h>
+
+#include <nuttx/irq.h>
+#include <nuttx/arch.h>
+#include <nuttx/clock.h>
+#include <nuttx/semaphore.h>
+#include <nuttx/event.h>
+
+#include "event/event.h"
+
+/****************************************************************************
+ * Private Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: nxevent_dowait
+ *
+ * Description:
+ *   Common logic of nxevent_wait() and nxevent_tickwait().
+ *
+ ****************************************************************************/
+
+static int nxevent_dowait(FAR struct nxevent_s *event,
+                          nxevent_mask_t events, int eflags,
+                          bool timed, uint32_t delay,
+                          FAR nxevent_mask_t *result)
+{
+  struct nxevent_wait_s wait;
+  irqstate_t flags;
+  int ret;
+
+  DEBUGASSERT(event != NULL && events != 0 && !up_interrupt_context());
+
+  flags = enter_critical_section();
+
+  /* Is the condition already met? */
+
+  if (nxevent_match(event->events, events, eflags))
+    {
+      wait.result = event->events;
+      if ((eflags & NXEVENT_WAIT_RESET) != 0)
+        {
+          event->events &= ~events;
+        }
+
+      ret = OK;
+      goto out;
+    }
+
+  if (timed && delay == 0)
+    {
+      ret = -EAGAIN;
+      goto out;
+    }
+
+  /* Queue up and wait for nxevent_post() to satisfy the condition.  The
+   * semaphore is used for signaling and, hence, should not have priority
+   * inheritance enabled.
+   */
+
+  wait.events = events;
+  wait.eflags = eflags;
+  wait.done   = false;
+  nxsem_init(&wait.sem, 0, 0);
+  nxsem_setprotocol(&wait.sem, SEM_PRIO_NONE);
+
+  dq_addlast(&wait.node, &event->waitlist);
+
+  if (timed)
+    {
+      ret = nxsem_tickwait(&wait.sem, clock_systimer(), delay);
+    }
+  else
+    {
+      ret = nxsem_wait(&wait.sem);
+    }
+
+  /* The wait may have been satisfied just as it timed out or was
+   * interrupted.  Otherwise the waiter is still queued.
+   */
+
+  if (wait.done)
+    {
+      ret = OK;
+    }
+  else
+    {
+      dq_rem(&wait.node, &event->waitlist);
+      if (ret >= 0)
+        {
+          ret = -EINTR;
+        }
+    }
+
+  nxsem_destroy(&wait.sem);
+
+out:
+  leave_critical_section(flags);
+
+  if (ret == OK && result != NULL)
+    {
+      *result = wait.result;
+    }
+
+  return ret;
+}
+
+/****************************************************************************
+ * Public Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: nxevent_wait
+ *
+ * Description:
+ *   Wait until any (or, with NXEVENT_WAIT_ALL, all) of the given events are
+ *   set.  With NXEVENT_WAIT_RESET, the awaited events are cleared
+ *   atomically with the wakeup.
+ *
+ * Input Parameters:
+ *   event  - The event group
+ *   events - The events to wait for
+ *   eflags - NXEVENT_WAIT_ALL and NXEVENT_WAIT_RESET
+ *   result - Location to return the set of events when the condition was
+ *            met, before any were cleared.  May be NULL.
+ *
+ * Returned Value:
+ *   Zero (OK) on success.  A negated errno value on failure:
+ *
+ *   EINTR - The wait was interrupted by a signal
+ *
+ ****************************************************************************/
+
+int nxevent_wait(FAR struct nxevent_s *event, nxevent_mask_t events,
+                 int eflags, FAR nxevent_mask_t *result)
+{
+  return nxevent_dowait(event, events, eflags, false, 0, result);
+}
+
+/****************************************************************************
+ * Name: nxevent_tickwait
+ *
+ * Description:
+ *   Like nxevent_wait(), but give up after delay clock ticks.  A delay of
+ *   zero only polls the events.
+ *
+ * Returned Value:
+ *   Zero (OK) on success.  A negated errno value on failure:
+ *
+ *   EAGAIN    - delay is zero and the condition is not met
+ *   ETIMEDOUT - The condition was not met within delay ticks
+ *   EINTR     - The wait was interrupted by a signal
+ *
+ ****************************************************************************/
+
+int nxevent_tickwait(FAR struct nxevent_s *event, nxevent_mask_t events,
+                     int eflags, uint32_t delay,
+                     FAR nxevent_mask_t *result)
+{
+  return nxevent_dowait(event, events, eflags, true, delay, result);
+}
@@ -52,6 +52,7 @@
 #include "environ/environ.h"
 #include "sched/sched.h"
 #include "group/group.h"
+#include "signal/signal.h"
 
 /****************************************************************************
  * Pre-processor Definitions
@@ -225,6 +226,17 @@ int group_allocate(FAR struct task_tcb_s *tcb, uint8_t ttype)
       return -ENOMEM;
     }
 
+#if CONFIG_SIG_GROUP_NPENDING > 0
+  /* Reserve the pending signals for the exclusive use of the group */
+
+  ret = nxsig_alloc_grouppool(group);
+  if (ret < 0)
+    {
+      kmm_free(group);
+      return ret;
+    }
+#endif
+
 #if CONFIG_NFILE_STREAMS > 0 && (defined(CONFIG_BUILD_PROTECTED) || \
     defined(CONFIG_BUILD_KERNEL)) && defined(CONFIG_MM_KERNEL_HEAP)
   /* If this group is being created for a privileged thread, then all elements
@@ -249,6 +261,9 @@ int group_allocate(FAR struct task_tcb_s *tcb, uint8_t ttype)
 
   if (!group->tg_streamlist)
     {
+#if CONFIG_SIG_GROUP_NPENDING > 0
+      kmm_free(group->tg_sigpendpool);
+#endif
       kmm_free(group);
       return -ENOMEM;
     }
@@ -279,6 +294,9 @@ int group_allocate(FAR struct task_tcb_s *tcb, uint8_t ttype)
 #if CONFIG_NFILE_STREAMS > 0 && (defined(CONFIG_BUILD_PROTECTED) || \
     defined(CONFIG_BUILD_KERNEL)) && defined(CONFIG_MM_KERNEL_HEAP)
       group_free(group, group->tg_streamlist);
+#endif
+#if CONFIG_SIG_GROUP_NPENDING > 0
+      kmm_free(group->tg_sigpendpool);
 #endif
       kmm_free(group);
       tcb->cmn.group = NULL;
@@ -88,8 +88,9 @@ static inline void sched_dupfiles(FAR struct task_tcb_s *tcb)
   /* The parent task is the one at the head of the ready-to-run list */
 
   FAR struct tcb_s *rtcb = this_task();
-  FAR struct file *parent;
-  FAR struct file *child;
+  FAR struct filelist *parent;
+  FAR struct filelist *child;
+  FAR struct file *filep;
   int i;
 
   DEBUGASSERT(tcb && tcb->cmn.group && rtcb->group);
@@ -102,8 +103,8 @@ static inline void sched_dupfiles(FAR struct task_tcb_s *tcb)
 
   /* Get pointers to the parent and child task file lists */
 
-  parent = rtcb->group->tg_filelist.fl_files;
-  child  = tcb->cmn.group->tg_filelist.fl_files;
+  parent = &rtcb->group->tg_filelist;
+  child  = &tcb->cmn.group->tg_filelist;
 
   /* Check each file in the parent file list */
 
@@ -114,11 +115,13 @@ static inline void sched_dupfiles(FAR struct task_tcb_s *tcb)
        * i-node structure.
        */
 
-      if (parent[i].f_inode)
+      filep = files_fget(parent, i);
+      if (filep != NULL && filep->f_inode &&
+          files_extend(child, i) >= 0)
         {
           /* Yes... duplicate it for the child */
 
-          file_dup2(&parent[i], &child[i]);
+          file_dup2(filep, files_fget(child, i));
         }
     }
 }
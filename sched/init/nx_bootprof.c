@@ -0,0 +1,170 @@
+/****************************************************************************
+ * sched/init/nx_bootprof.c
+ *
+ *   Copyright (C) 2020 Gregory Nutt. All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in
+ *    the documentation and/or other materials provided with the
+ *    distribution.
+ * 3. Neither the name NuttX nor the names of its contributors may be
+ *    used to endorse or promote products derived from this software
+ *    without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+ * FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE
+ * COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+ * INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,
+ * BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS
+ * OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED
+ * AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ * LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN
+ * ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ *
+ ****************************************************************************/
+
+/****************************************************************************
+ * Included Files
+ ****************************************************************************/
+
+#include <nuttx/config.h>
+
+#include <stdint.h>
+#include <syslog.h>
+#include <time.h>
+
+#include <nuttx/clock.h>
+#include <nuttx/init.h>
+#include <nuttx/irq.h>
+
+#ifdef CONFIG_BOOT_PROFILE
+
+/****************************************************************************
+ * Private Types
+ ****************************************************************************/
+
+struct boot_mark_s
+{
+  FAR const char *name;          /* Name of the phase */
+  uint32_t start;                /* Start time in microseconds */
+  uint32_t elapsed;              /* Duration in microseconds, 0 for a mark */
+};
+
+/****************************************************************************
+ * Private Data
+ ****************************************************************************/
+
+static struct boot_mark_s g_boot_marks[CONFIG_BOOT_PROFILE_NMARKS];
+static int g_boot_nmarks;
+
+/****************************************************************************
+ * Public Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: boot_time
+ *
+ * Description:
+ *   Return the time since power-up in microseconds.
+ *
+ ****************************************************************************/
+
+uint32_t boot_time(void)
+{
+  struct timespec ts;
+
+  if (clock_systimespec(&ts) < 0)
+    {
+      return 0;
+    }
+
+  return (uint32_t)ts.tv_sec * USEC_PER_SEC +
+         (uint32_t)ts.tv_nsec / NSEC_PER_USEC;
+}
+
+/****************************************************************************
+ * Name: boot_record
+ *
+ * Description:
+ *   Add a phase that started at 'start' and took 'elapsed' microseconds to
+ *   the boot profile.  This may be called from several threads at once.
+ *
+ ****************************************************************************/
+
+void boot_record(FAR const char *name, uint32_t start, uint32_t elapsed)
+{
+  irqstate_t flags;
+
+  flags = enter_critical_section();
+  if (g_boot_nmarks < CONFIG_BOOT_PROFILE_NMARKS)
+    {
+      FAR struct boot_mark_s *mark = &g_boot_marks[g_boot_nmarks++];
+
+      mark->name    = name;
+      mark->start   = start;
+      mark->elapsed = elapsed;
+    }
+
+  leave_critical_section(flags);
+}
+
+/****************************************************************************
+ * Name: boot_mark
+ *
+ * Description:
+ *   Add the current time to the boot profile.
+ *
+ ****************************************************************************/
+
+void boot_mark(FAR const char *name)
+{
+  boot_record(name, boot_time(), 0);
+}
+
+/****************************************************************************
+ * Name: boot_report
+ *
+ * Description:
+ *   Write the boot profile to the syslog.
+ *
+ ****************************************************************************/
+
+void boot_report(void)
+{
+  int i;
+
+  syslog(LOG_INFO, "Boot profile (start/elapsed in usec):\n");
+
+  for (i = 0; i < g_boot_nmarks; i++)
+    {
+      FAR struct boot_mark_s *mark = &g_boot_marks[i];
+
+      if (mark->elapsed > 0)
+        {
+          syslog(LOG_INFO, "  %10lu %10lu %s\n", (unsigned long)mark->start,
+                 (unsigned long)mark->elapsed, mark->name);
+        }
+      else
+        {
+          syslog(LOG_INFO, "  %10lu %10s %s\n", (unsigned long)mark->start,
+                 "", mark->name);
+        }
+    }
+
+  if (g_boot_nmarks >= CONFIG_BOOT_PROFILE_NMARKS)
+    {
+      syslog(LOG_INFO, "  (profile full, increase "
+                       "CONFIG_BOOT_PROFILE_NMARKS)\n");
+    }
+}
+
+#endif /* CONFIG_BOOT_PROFILE */
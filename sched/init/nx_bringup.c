@@ -225,6 +225,29 @@ static inline void nx_workqueues(void)
 
 #endif /* CONFIG_SCHED_WORKQUEUE */
 
+/****************************************************************************
+ * Name: nx_board_late_initialize
+ *
+ * Description:
+ *   Perform the board-specific initialization and record its duration in
+ *   the boot profile.
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_BOARD_LATE_INITIALIZE
+static inline void nx_board_late_initialize(void)
+{
+#ifdef CONFIG_BOOT_PROFILE
+  uint32_t start = boot_time();
+
+  board_late_initialize();
+  boot_record("board_late_initialize", start, boot_time() - start);
+#else
+  board_late_initialize();
+#endif
+}
+#endif
+
 /****************************************************************************
  * Name: nx_start_application
  *
@@ -250,7 +273,7 @@ static inline void nx_start_application(void)
    * configured.
    */
 
-  board_late_initialize();
+  nx_board_late_initialize();
 #endif
 
   /* Start the application initialization task.  In a flat build, this is
@@ -261,6 +284,9 @@ static inline void nx_start_application(void)
 
   sinfo("Starting init thread\n");
 
+  boot_mark("init thread");
+  boot_report();
+
 #ifdef CONFIG_BUILD_PROTECTED
   DEBUGASSERT(USERSPACE->us_entrypoint != NULL);
   pid = nxtask_create("init", CONFIG_USERMAIN_PRIORITY,
@@ -286,7 +312,7 @@ static inline void nx_start_application(void)
    * configured.
    */
 
-  board_late_initialize();
+  nx_board_late_initialize();
 #endif
 
 #ifdef CONFIG_INIT_MOUNT
@@ -306,6 +332,9 @@ static inline void nx_start_application(void)
 
   sinfo("Starting init task: %s\n", CONFIG_USER_INITPATH);
 
+  boot_mark("init task");
+  boot_report();
+
   ret = exec(CONFIG_USER_INITPATH, NULL, CONFIG_INIT_SYMTAB,
              CONFIG_INIT_NEXPORTS);
   DEBUGASSERT(ret >= 0);
@@ -0,0 +1,294 @@
+/****************************************************************************
+ * sched/init/nx_initcall.c
+ *
+ *   Copyright (C) 2020 Gregory Nutt. All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in
+ *    the documentation and/or other materials provided with the
+ *    distribution.
+ * 3. Neither the name NuttX nor the names of its contributors may be
+ *    used to endorse or promote products derived from this software
+ *    without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+ * FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE
+ * COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+ * INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,
+ * BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS
+ * OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED
+ * AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ * LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN
+ * ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ *
+ ****************************************************************************/
+
+/****************************************************************************
+ * Included Files
+ ****************************************************************************/
+
+#include <nuttx/config.h>
+
+#include <stdint.h>
+#include <assert.h>
+#include <errno.h>
+#include <debug.h>
+
+#include <nuttx/init.h>
+#include <nuttx/kthread.h>
+#include <nuttx/semaphore.h>
+
+/****************************************************************************
+ * Private Types
+ ****************************************************************************/
+
+/* The state shared by the threads running one set of initcalls */
+
+struct boot_initstate_s
+{
+  FAR const struct boot_initcall_s *calls;
+  uint32_t all;                  /* Bits of all of the initcalls */
+  uint32_t started;              /* Bits of the started initcalls */
+  uint32_t done;                 /* Bits of the completed initcalls */
+  int nwaiting;                  /* Number of threads waiting for progress */
+  int result;                    /* First failure */
+  sem_t lock;                    /* Protects this structure */
+  sem_t progress;                /* Posted when an initcall completes */
+#if CONFIG_BOOT_INIT_NTHREADS > 0
+  sem_t exited;                  /* Posted when a worker thread exits */
+#endif
+};
+
+/****************************************************************************
+ * Private Data
+ ****************************************************************************/
+
+/* boot_initcalls() is only used during bring-up; one set of initcalls is
+ * run at a time.
+ */
+
+static struct boot_initstate_s g_initstate;
+
+/****************************************************************************
+ * Private Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: boot_initrun
+ *
+ * Description:
+ *   Run initcalls whose dependencies have completed until all have been
+ *   started.  Called on the caller's thread and on each worker thread.
+ *
+ ****************************************************************************/
+
+static void boot_initrun(FAR struct boot_initstate_s *state)
+{
+  FAR const struct boot_initcall_s *call;
+  uint32_t start;
+  uint32_t bit;
+  int ret;
+  int i;
+
+  nxsem_wait_uninterruptible(&state->lock);
+
+  while (state->started != state->all)
+    {
+      /* Find an initcall that is ready to run */
+
+      call = NULL;
+      for (i = 0; i < BOOT_INITCALL_MAX; i++)
+        {
+          bit = BOOT_INITCALL_DEP(i);
+          if ((state->all & bit) == 0)
+            {
+              break;
+            }
+
+          if ((state->started & bit) == 0 &&
+              (state->calls[i].depends & ~state->done) == 0)
+            {
+              call = &state->calls[i];
+              break;
+            }
+        }
+
+      if (call == NULL)
+        {
+          /* Nothing is ready.  If nothing is running either, the remaining
+           * dependencies can never be satisfied.
+           */
+
+          if (state->started == state->done)
+            {
+              serr("ERROR: Unsatisfiable initcall dependencies\n");
+              state->result  = -EINVAL;
+              state->started = state->all;
+              break;
+            }
+
+          state->nwaiting++;
+          nxsem_post(&state->lock);
+          nxsem_wait_uninterruptible(&state->progress);
+          nxsem_wait_uninterruptible(&state->lock);
+          continue;
+        }
+
+      /* Run it without holding the lock */
+
+      state->started |= bit;
+      nxsem_post(&state->lock);
+
+      sinfo("Starting %s\n", call->name);
+      start = boot_time();
+      ret   = call->func();
+      boot_record(call->name, start, boot_time() - start);
+
+      if (ret < 0)
+        {
+          serr("ERROR: %s failed: %d\n", call->name, ret);
+        }
+
+      /* Mark it done and wake up any threads waiting for it */
+
+      nxsem_wait_uninterruptible(&state->lock);
+      state->done |= bit;
+      if (ret < 0 && state->result == OK)
+        {
+          state->result = ret;
+        }
+
+      for (; state->nwaiting > 0; state->nwaiting--)
+        {
+          nxsem_post(&state->progress);
+        }
+    }
+
+  /* Wake up everyone so that they notice that all have been started */
+
+  for (; state->nwaiting > 0; state->nwaiting--)
+    {
+      nxsem_post(&state->progress);
+    }
+
+  nxsem_post(&state->lock);
+}
+
+/****************************************************************************
+ * Name: boot_initthread
+ *
+ * Description:
+ *   The body of a worker thread.
+ *
+ ****************************************************************************/
+
+#if CONFIG_BOOT_INIT_NTHREADS > 0
+static int boot_initthread(int argc, FAR char *argv[])
+{
+  boot_initrun(&g_initstate);
+  nxsem_post(&g_initstate.exited);
+  return OK;
+}
+#endif
+
+/****************************************************************************
+ * Public Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: boot_initcalls
+ *
+ * Description:
+ *   Run a set of initializers, in parallel where their dependencies allow.
+ *
+ * Input Parameters:
+ *   calls  - The initializers
+ *   ncalls - The number of initializers, at most BOOT_INITCALL_MAX
+ *
+ * Returned Value:
+ *   Zero (OK) if all initializers succeeded; otherwise, the first negative
+ *   value returned by an initializer, or -EINVAL if the dependencies can
+ *   not be satisfied.
+ *
+ ****************************************************************************/
+
+int boot_initcalls(FAR const struct boot_initcall_s *calls, int ncalls)
+{
+  FAR struct boot_initstate_s *state = &g_initstate;
+#if CONFIG_BOOT_INIT_NTHREADS > 0
+  int nthreads = 0;
+  int ret;
+  int i;
+#endif
+
+  DEBUGASSERT(calls != NULL && ncalls >= 0 && ncalls <= BOOT_INITCALL_MAX);
+
+  if (ncalls == 0)
+    {
+      return OK;
+    }
+
+  state->calls    = calls;
+  state->all      = ncalls < BOOT_INITCALL_MAX ?
+                    BOOT_INITCALL_DEP(ncalls) - 1 : UINT32_MAX;
+  state->started  = 0;
+  state->done     = 0;
+  state->nwaiting = 0;
+  state->result   = OK;
+
+  nxsem_init(&state->lock, 0, 1);
+  nxsem_init(&state->progress, 0, 0);
+  nxsem_setprotocol(&state->progress, SEM_PRIO_NONE);
+
+#if CONFIG_BOOT_INIT_NTHREADS > 0
+  nxsem_init(&state->exited, 0, 0);
+  nxsem_setprotocol(&state->exited, SEM_PRIO_NONE);
+
+  /* Start the worker threads.  There is no point in starting more threads
+   * than there are initcalls besides the one run by this thread.
+   */
+
+  for (i = 0; i < CONFIG_BOOT_INIT_NTHREADS && i < ncalls - 1; i++)
+    {
+      ret = kthread_create("bootinit", CONFIG_BOOT_INIT_PRIORITY,
+                           CONFIG_BOOT_INIT_STACKSIZE,
+                           (main_t)boot_initthread,
+                           (FAR char * const *)NULL);
+      if (ret < 0)
+        {
+          serr("ERROR: Failed to start initcall thread: %d\n", ret);
+          break;
+        }
+
+      nthreads++;
+    }
+#endif
+
+  /* Run initcalls on this thread too */
+
+  boot_initrun(state);
+
+#if CONFIG_BOOT_INIT_NTHREADS > 0
+  /* Wait for the worker threads to finish their last initcalls */
+
+  for (; nthreads > 0; nthreads--)
+    {
+      nxsem_wait_uninterruptible(&state->exited);
+    }
+
+  nxsem_destroy(&state->exited);
+#endif
+
+  nxsem_destroy(&state->progress);
+  nxsem_destroy(&state->lock);
+  return state->result;
+}
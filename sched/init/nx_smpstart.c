@@ -163,6 +163,14 @@ int nx_idle_task(int argc, FAR char *argv[])
         }
 #endif
 
+#ifdef CONFIG_SMP_LOADBALANCE
+      /* Start any ready-to-run task that was left waiting while this CPU
+       * became idle.
+       */
+
+      sched_loadbalance();
+#endif
+
       /* Perform any processor-specific idle state operations */
 
       up_idle();
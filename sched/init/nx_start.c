@@ -367,6 +367,68 @@ static FAR char *g_idleargv[CONFIG_SMP_NCPUS][2];
 static FAR char *g_idleargv[1][2];
 #endif
 
+#ifdef CONFIG_STACK_COLORATION_INCREMENTAL
+/* The PID hash table index of the next thread whose stack high-water mark
+ * will be updated by the IDLE loop.
+ */
+
+static int g_stackhwm_ndx;
+#endif
+
+/****************************************************************************
+ * Private Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: nx_stackhwm
+ *
+ * Description:
+ *   Update the stack high-water mark of the next thread.  Called from the
+ *   IDLE loop so that the marks are kept current and the checks done on
+ *   request only have to look at the stack used since the last pass.
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_STACK_COLORATION_INCREMENTAL
+static void nx_stackhwm(void)
+{
+  FAR struct tcb_s *tcb;
+#ifdef CONFIG_SMP
+  irqstate_t flags;
+#endif
+  int i;
+
+  /* Keep the thread from exiting while its stack is examined */
+
+#ifdef CONFIG_SMP
+  flags = enter_critical_section();
+#else
+  sched_lock();
+#endif
+
+  for (i = 0; i < CONFIG_MAX_TASKS; i++)
+    {
+      if (++g_stackhwm_ndx >= CONFIG_MAX_TASKS)
+        {
+          g_stackhwm_ndx = 0;
+        }
+
+      tcb = g_pidhash[g_stackhwm_ndx].tcb;
+      if (tcb != NULL)
+        {
+          up_check_tcbstack(tcb);
+          break;
+        }
+    }
+
+#ifdef CONFIG_SMP
+  leave_critical_section(flags);
+#else
+  sched_unlock();
+#endif
+}
+#endif
+
 /****************************************************************************
  * Public Functions
  ****************************************************************************/
@@ -553,7 +615,7 @@ void nx_start(void)
 #else
       tasklist = TLIST_HEAD(TSTATE_TASK_RUNNING);
 #endif
-      dq_addfirst((FAR dq_entry_t *)&g_idletcb[cpu], tasklist);
+      sched_addprioritized(&g_idletcb[cpu].cmn, tasklist);
 
       /* Mark the idle task as the running task */
 
@@ -728,6 +790,7 @@ void nx_start(void)
   /* Hardware resources are now available */
 
   g_nx_initstate = OSINIT_HARDWARE;
+  boot_mark("hardware ready");
 
   /* Setup for Multi-Tasking ************************************************/
 
@@ -824,6 +887,7 @@ void nx_start(void)
   /* The OS is fully initialized and we are beginning multi-tasking */
 
   g_nx_initstate = OSINIT_OSREADY;
+  boot_mark("os ready");
 
   /* Create initial tasks and bring-up the system */
 
@@ -869,6 +933,20 @@ void nx_start(void)
         }
 #endif
 
+#ifdef CONFIG_SMP_LOADBALANCE
+      /* Start any ready-to-run task that was left waiting while this CPU
+       * became idle.
+       */
+
+      sched_loadbalance();
+#endif
+
+#ifdef CONFIG_STACK_COLORATION_INCREMENTAL
+      /* Keep the stack high-water marks up to date */
+
+      nx_stackhwm();
+#endif
+
       /* Perform any processor-specific idle state operations */
 
       up_idle();
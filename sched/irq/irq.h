@@ -60,6 +60,15 @@
 #  error CONFIG_ARCH_NUSER_INTERRUPTS is not defined
 #endif
 
+/* Number of buckets in the log2 histogram of interrupt handler execution
+ * times.  Bucket n holds times of 2^n to 2^(n+1)-1 up_critmon_gettime()
+ * units.
+ */
+
+#ifdef CONFIG_SCHED_IRQMONITOR_TIMING
+#  define IRQ_NBUCKETS 32
+#endif
+
 /****************************************************************************
  * Public Types
  ****************************************************************************/
@@ -83,6 +92,15 @@ struct irq_info_s
   uint32_t lscount;  /* Number of interrupts on this IRQ (LS) */
 #endif
   uint32_t time;     /* Maximum execution time on this IRQ */
+#ifdef CONFIG_SMP
+  uint32_t cpucount[CONFIG_SMP_NCPUS]; /* Number of interrupts on each CPU */
+#endif
+#ifdef CONFIG_SCHED_IRQMONITOR_TIMING
+  uint32_t tmin;     /* Minimum execution time (up_critmon_gettime units) */
+  uint32_t tmax;     /* Maximum execution time (up_critmon_gettime units) */
+  uint64_t ttotal;   /* Sum of the execution times */
+  uint32_t hist[IRQ_NBUCKETS]; /* log2 histogram of the execution times */
+#endif
 #endif
 };
 
@@ -228,6 +246,22 @@ bool irq_cpu_locked(int cpu);
 int irq_foreach(irq_foreach_t callback, FAR void *arg);
 #endif
 
+/****************************************************************************
+ * Name: irq_monitor_reset
+ *
+ * Description:
+ *   Clear the interrupt count and the execution time statistics of one
+ *   interrupt and restart the measurement interval at 'start'.
+ *
+ * Assumptions:
+ *   Called from within a critical section.
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_SCHED_IRQMONITOR
+void irq_monitor_reset(FAR struct irq_info_s *info, clock_t start);
+#endif
+
 #ifdef CONFIG_IRQCHAIN
 void irqchain_initialize(void);
 bool is_irqchain(int ndx, xcpt_t isr);
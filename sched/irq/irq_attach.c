@@ -132,13 +132,7 @@ int irq_attach(int irq, xcpt_t isr, FAR void *arg)
       g_irqvector[ndx].handler = isr;
       g_irqvector[ndx].arg     = arg;
 #ifdef CONFIG_SCHED_IRQMONITOR
-      g_irqvector[ndx].start   = clock_systimer();
-#ifdef CONFIG_HAVE_LONG_LONG
-      g_irqvector[ndx].count   = 0;
-#else
-      g_irqvector[ndx].mscount = 0;
-      g_irqvector[ndx].lscount = 0;
-#endif
+      irq_monitor_reset(&g_irqvector[ndx], clock_systimer());
 #endif
 
       leave_critical_section(flags);
@@ -39,6 +39,8 @@
 
 #include <nuttx/config.h>
 
+#include <string.h>
+#include <strings.h>
 #include <debug.h>
 #include <nuttx/arch.h>
 #include <nuttx/irq.h>
@@ -75,6 +77,16 @@
      while (0)
 #endif
 
+/* INCR_CPUCOUNT - Increment the count of interrupts taken on this IRQ number
+ * by this CPU
+ */
+
+#if defined(CONFIG_SCHED_IRQMONITOR) && defined(CONFIG_SMP)
+#  define INCR_CPUCOUNT(ndx) g_irqvector[ndx].cpucount[this_cpu()]++
+#else
+#  define INCR_CPUCOUNT(ndx)
+#endif
+
 /* CALL_VECTOR - Call the interrupt service routine attached to this interrupt
  * request
  */
@@ -82,6 +94,16 @@
 #ifndef CONFIG_SCHED_IRQMONITOR
 #  define CALL_VECTOR(ndx, vector, irq, context, arg) \
      vector(irq, context, arg)
+#elif defined(CONFIG_SCHED_IRQMONITOR_TIMING)
+#  define CALL_VECTOR(ndx, vector, irq, context, arg) \
+     do \
+       { \
+         uint32_t start; \
+         start = up_critmon_gettime(); \
+         vector(irq, context, arg); \
+         irq_monitor_record(ndx, up_critmon_gettime() - start); \
+       } \
+     while (0)
 #elif defined(CONFIG_SCHED_CRITMONITOR)
 #  define CALL_VECTOR(ndx, vector, irq, context, arg) \
      do \
@@ -118,10 +140,98 @@
      while (0)
 #endif /* CONFIG_SCHED_IRQMONITOR */
 
+#ifdef CONFIG_ARCH_MINIMAL_VECTORTABLE
+#  define TAB_SIZE CONFIG_ARCH_NUSER_INTERRUPTS
+#else
+#  define TAB_SIZE NR_IRQS
+#endif
+
+/****************************************************************************
+ * Private Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: irq_monitor_record
+ *
+ * Description:
+ *   Add the execution time of one interrupt handler to the statistics of
+ *   its interrupt.
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_SCHED_IRQMONITOR_TIMING
+static inline void irq_monitor_record(unsigned int ndx, uint32_t elapsed)
+{
+  FAR struct irq_info_s *info;
+  int bucket;
+
+  /* Unexpected interrupts may have no entry in the table */
+
+  if (ndx >= TAB_SIZE)
+    {
+      return;
+    }
+
+  info = &g_irqvector[ndx];
+
+  if (elapsed < info->tmin)
+    {
+      info->tmin = elapsed;
+    }
+
+  if (elapsed > info->tmax)
+    {
+      info->tmax = elapsed;
+    }
+
+  info->ttotal += elapsed;
+
+  /* fls() returns zero for zero and 32 if the MS bit is set */
+
+  bucket = fls((int)elapsed) - 1;
+  info->hist[bucket < 0 ? 0 : bucket]++;
+}
+#endif
+
 /****************************************************************************
  * Public Functions
  ****************************************************************************/
 
+/****************************************************************************
+ * Name: irq_monitor_reset
+ *
+ * Description:
+ *   Clear the interrupt count and the execution time statistics of one
+ *   interrupt and restart the measurement interval at 'start'.
+ *
+ * Assumptions:
+ *   Called from within a critical section.
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_SCHED_IRQMONITOR
+void irq_monitor_reset(FAR struct irq_info_s *info, clock_t start)
+{
+  info->start   = start;
+#ifdef CONFIG_HAVE_LONG_LONG
+  info->count   = 0;
+#else
+  info->mscount = 0;
+  info->lscount = 0;
+#endif
+  info->time    = 0;
+#ifdef CONFIG_SMP
+  memset(info->cpucount, 0, sizeof(info->cpucount));
+#endif
+#ifdef CONFIG_SCHED_IRQMONITOR_TIMING
+  info->tmin    = UINT32_MAX;
+  info->tmax    = 0;
+  info->ttotal  = 0;
+  memset(info->hist, 0, sizeof(info->hist));
+#endif
+}
+#endif
+
 /****************************************************************************
  * Name: irq_dispatch
  *
@@ -152,6 +262,7 @@ void irq_dispatch(int irq, FAR void *context)
             }
 
           INCR_COUNT(ndx);
+          INCR_CPUCOUNT(ndx);
         }
 #else
       if (g_irqvector[ndx].handler)
@@ -161,6 +272,7 @@ void irq_dispatch(int irq, FAR void *context)
         }
 
       INCR_COUNT(ndx);
+      INCR_CPUCOUNT(ndx);
 #endif
     }
 #endif
@@ -173,9 +285,17 @@ void irq_dispatch(int irq, FAR void *context)
 
   /* Then dispatch to the interrupt handler */
 
+#ifdef CONFIG_SCHED_CPULOAD_CYCLES
+  sched_cpuload_irqenter();
+#endif
+
   CALL_VECTOR(ndx, vector, irq, context, arg);
   UNUSED(ndx);
 
+#ifdef CONFIG_SCHED_CPULOAD_CYCLES
+  sched_cpuload_irqleave();
+#endif
+
   /* Record the new "running" task.  g_running_tasks[] is only used by
    * assertion logic for reporting crashes.
    */
@@ -46,6 +46,8 @@
 #include <assert.h>
 #include <errno.h>
 
+#include <nuttx/arch.h>
+#include <nuttx/clock.h>
 #include <nuttx/kmalloc.h>
 #include <nuttx/fs/fs.h>
 #include <nuttx/fs/procfs.h>
@@ -72,15 +74,40 @@
  * may not be wide enough.
  */
 
-#define HDR_FMT "IRQ HANDLER  ARGUMENT    COUNT    RATE    TIME\n"
-#define IRQ_FMT "%3u %08lx %08lx %10lu %4lu.%03lu %4lu\n"
+#ifdef CONFIG_SCHED_IRQMONITOR_TIMING
+/* With CONFIG_SCHED_IRQMONITOR_TIMING, the maximum execution time is
+ * replaced by the minimum, average and maximum execution time in
+ * microseconds and the share of the CPU time spent in the handler:
+ *
+ *   IRQ HANDLER  ARGUMENT    COUNT    RATE        MIN     AVG     MAX   LOAD
+ *   DDD XXXXXXXX XXXXXXXX DDDDDDDDDD DDDD.DDD DDDDDDD DDDDDDD DDDDDDD DD.D%
+ *       HIST: <Nus:D <Nus:D ...
+ *
+ * In the SMP configuration, each interrupt is also followed by the number
+ * of interrupts handled by each CPU:
+ *
+ *       CPUS: D D ...
+ */
+
+#  define HDR_FMT "IRQ HANDLER  ARGUMENT    COUNT    RATE        MIN     " \
+                  "AVG     MAX   LOAD\n"
+#  define IRQ_FMT "%3u %08lx %08lx %10lu %4lu.%03lu %7lu %7lu %7lu " \
+                  "%3lu.%lu%%\n"
+#else
+#  define HDR_FMT "IRQ HANDLER  ARGUMENT    COUNT    RATE    TIME\n"
+#  define IRQ_FMT "%3u %08lx %08lx %10lu %4lu.%03lu %4lu\n"
+#endif
 
 /* Determines the size of an intermediate buffer that must be large enough
  * to handle the longest line generated by this logic (plus a couple of
  * bytes).
  */
 
-#define IRQ_LINELEN 50
+#ifdef CONFIG_SCHED_IRQMONITOR_TIMING
+#  define IRQ_LINELEN 80
+#else
+#  define IRQ_LINELEN 50
+#endif
 
 /****************************************************************************
  * Private Types
@@ -148,6 +175,52 @@ const struct procfs_operations irq_operations =
  * Private Functions
  ****************************************************************************/
 
+/****************************************************************************
+ * Name: irq_output
+ *
+ * Description:
+ *   Copy the formatted line to the user buffer.  Returns a non-zero value
+ *   if the user buffer is full.
+ *
+ ****************************************************************************/
+
+static int irq_output(FAR struct irq_file_s *irqfile, size_t linesize)
+{
+  size_t copysize;
+
+  copysize  = procfs_memcpy(irqfile->line, linesize, irqfile->buffer,
+                            irqfile->remaining, &irqfile->offset);
+
+  irqfile->ncopied   += copysize;
+  irqfile->buffer    += copysize;
+  irqfile->remaining -= copysize;
+
+  /* Return a non-zero value to stop the traversal if the user-provided
+   * buffer is full.
+   */
+
+  return irqfile->remaining > 0 ? 0 : 1;
+}
+
+/****************************************************************************
+ * Name: irq_nsec
+ *
+ * Description:
+ *   Convert an execution time in up_critmon_gettime() units to
+ *   nanoseconds.
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_SCHED_IRQMONITOR_TIMING
+static uint64_t irq_nsec(uint32_t elapsed)
+{
+  struct timespec ts;
+
+  up_critmon_convert(elapsed, &ts);
+  return (uint64_t)ts.tv_sec * NSEC_PER_SEC + ts.tv_nsec;
+}
+#endif
+
 /****************************************************************************
  * Name: irq_callback
  ****************************************************************************/
@@ -161,10 +234,17 @@ static int irq_callback(int irq, FAR struct irq_info_s *info,
   clock_t elapsed;
   clock_t now;
   size_t linesize;
-  size_t copysize;
   unsigned long intpart;
   unsigned long fracpart;
   unsigned long count;
+#ifdef CONFIG_SCHED_IRQMONITOR_TIMING
+  uint64_t busy;
+  uint32_t avg;
+  unsigned long load;
+#endif
+#if defined(CONFIG_SCHED_IRQMONITOR_TIMING) || defined(CONFIG_SMP)
+  int i;
+#endif
 
   DEBUGASSERT(irqfile != NULL);
 
@@ -173,14 +253,7 @@ static int irq_callback(int irq, FAR struct irq_info_s *info,
   flags = enter_critical_section();
   memcpy(&copy, info, sizeof(struct irq_info_s));
   now           = clock_systimer();
-  info->start   = now;
-#ifdef CONFIG_HAVE_LONG_LONG
-  info->count   = 0;
-#else
-  info->mscount = 0;
-  info->lscount = 0;
-#endif
-  info->time    = 0;
+  irq_monitor_reset(info, now);
   leave_critical_section(flags);
 
   /* Don't bother if count == 0.
@@ -247,6 +320,81 @@ static int irq_callback(int irq, FAR struct irq_info_s *info,
 #  error Missing logic
 #endif
 
+#ifdef CONFIG_SCHED_IRQMONITOR_TIMING
+  /* The share of the CPU time spent in the handler, in units of 0.1% */
+
+  avg  = (uint32_t)(copy.ttotal / copy.count);
+  busy = irq_nsec(avg) * copy.count;
+  load = (unsigned long)((busy * 1000) /
+                         ((uint64_t)elapsed * NSEC_PER_TICK));
+  if (load > 999)
+    {
+      load = 999;
+    }
+
+  /* Output information about this interrupt */
+
+  linesize = snprintf(irqfile->line, IRQ_LINELEN, IRQ_FMT,
+                      (unsigned int)irq,
+                      (unsigned long)((uintptr_t)copy.handler),
+                      (unsigned long)((uintptr_t)copy.arg),
+                      count, intpart, fracpart,
+                      (unsigned long)(irq_nsec(copy.tmin) / 1000),
+                      (unsigned long)(irq_nsec(avg) / 1000),
+                      (unsigned long)(irq_nsec(copy.tmax) / 1000),
+                      load / 10, load % 10);
+
+  if (irq_output(irqfile, linesize) != 0)
+    {
+      return 1;
+    }
+
+  /* Followed by the non-empty buckets of the execution time histogram.
+   * Each is shown as the upper bound of the bucket and the number of
+   * interrupts in it.
+   */
+
+  linesize = snprintf(irqfile->line, IRQ_LINELEN, "    HIST:");
+  if (irq_output(irqfile, linesize) != 0)
+    {
+      return 1;
+    }
+
+  for (i = 0; i < IRQ_NBUCKETS; i++)
+    {
+      uint64_t bound;
+
+      if (copy.hist[i] == 0)
+        {
+          continue;
+        }
+
+      bound = irq_nsec(i < 31 ? (uint32_t)2 << i : UINT32_MAX);
+      if (bound < 1000)
+        {
+          linesize = snprintf(irqfile->line, IRQ_LINELEN, " <%luns:%lu",
+                              (unsigned long)bound,
+                              (unsigned long)copy.hist[i]);
+        }
+      else
+        {
+          linesize = snprintf(irqfile->line, IRQ_LINELEN, " <%luus:%lu",
+                              (unsigned long)((bound + 999) / 1000),
+                              (unsigned long)copy.hist[i]);
+        }
+
+      if (irq_output(irqfile, linesize) != 0)
+        {
+          return 1;
+        }
+    }
+
+  linesize = snprintf(irqfile->line, IRQ_LINELEN, "\n");
+  if (irq_output(irqfile, linesize) != 0)
+    {
+      return 1;
+    }
+#else
   /* Output information about this interrupt */
 
   linesize = snprintf(irqfile->line, IRQ_LINELEN, IRQ_FMT,
@@ -256,25 +404,39 @@ static int irq_callback(int irq, FAR struct irq_info_s *info,
                       count, intpart, fracpart,
                       (unsigned long)copy.time / 1000);
 
-  copysize  = procfs_memcpy(irqfile->line, linesize, irqfile->buffer,
-                            irqfile->remaining, &irqfile->offset);
+  if (irq_output(irqfile, linesize) != 0)
+    {
+      return 1;
+    }
+#endif
 
-  irqfile->ncopied   += copysize;
-  irqfile->buffer    += copysize;
-  irqfile->remaining -= copysize;
+#ifdef CONFIG_SMP
+  /* And the number of interrupts handled by each CPU */
 
-  /* Return a non-zero value to stop the traversal if the user-provided
-   * buffer is full.
-   */
+  linesize = snprintf(irqfile->line, IRQ_LINELEN, "    CPUS:");
+  if (irq_output(irqfile, linesize) != 0)
+    {
+      return 1;
+    }
 
-  if (irqfile->remaining > 0)
+  for (i = 0; i < CONFIG_SMP_NCPUS; i++)
     {
-      return 0;
+      linesize = snprintf(irqfile->line, IRQ_LINELEN, " %lu",
+                          (unsigned long)copy.cpucount[i]);
+      if (irq_output(irqfile, linesize) != 0)
+        {
+          return 1;
+        }
     }
-  else
+
+  linesize = snprintf(irqfile->line, IRQ_LINELEN, "\n");
+  if (irq_output(irqfile, linesize) != 0)
     {
       return 1;
     }
+#endif
+
+  return 0;
 }
 
 /****************************************************************************
@@ -69,9 +69,13 @@ static volatile uint8_t g_irq_spin_count[CONFIG_SMP_NCPUS];
  *
  * Description:
  *   If SMP and SPINLOCK_IRQ are enabled:
- *     Disable local interrupts and take the global spinlock (g_irq_spin)
- *     if the call counter (g_irq_spin_count[cpu]) equals to 0. Then the
- *     counter on the CPU is increment to allow nested call.
+ *     If the argument lock is not specified (i.e. NULL), disable local
+ *     interrupts and take the global spinlock (g_irq_spin) if the call
+ *     counter (g_irq_spin_count[cpu]) equals to 0. Then the counter on the
+ *     CPU is increment to allow nested call.
+ *
+ *     If the argument lock is specified, disable local interrupts and take
+ *     the lock spinlock.  Such per-object locks do not nest.
  *
  *     NOTE: This API is very simple to protect data (e.g. H/W register
  *     or internal data structure) in SMP mode. But do not use this API
@@ -81,27 +85,35 @@ static volatile uint8_t g_irq_spin_count[CONFIG_SMP_NCPUS];
  *     This function is equivalent to enter_critical_section().
  *
  * Input Parameters:
- *   None
+ *   lock - Caller specific spinlock, or NULL for the global spinlock.
  *
  * Returned Value:
  *   An opaque, architecture-specific value that represents the state of
- *   the interrupts prior to the call to spin_lock_irqsave();
+ *   the interrupts prior to the call to spin_lock_irqsave(lock);
  *
  ****************************************************************************/
 
-irqstate_t spin_lock_irqsave(void)
+irqstate_t spin_lock_irqsave(FAR spinlock_t *lock)
 {
   irqstate_t ret;
   ret = up_irq_save();
 
-  int me = this_cpu();
-  if (0 == g_irq_spin_count[me])
+  if (NULL == lock)
+    {
+      int me = this_cpu();
+      if (0 == g_irq_spin_count[me])
+        {
+          spin_lock(&g_irq_spin);
+        }
+
+      g_irq_spin_count[me]++;
+      DEBUGASSERT(0 != g_irq_spin_count[me]);
+    }
+  else
     {
-      spin_lock(&g_irq_spin);
+      spin_lock(lock);
     }
 
-  g_irq_spin_count[me]++;
-  DEBUGASSERT(0 != g_irq_spin_count[me]);
   return ret;
 }
 
@@ -110,33 +122,45 @@ irqstate_t spin_lock_irqsave(void)
  *
  * Description:
  *   If SMP and SPINLOCK_IRQ are enabled:
- *     Decrement the call counter (g_irq_spin_count[cpu]) and if it
- *     decrements to zero then release the spinlock (g_irq_spin) and
+ *     If the argument lock is not specified (i.e. NULL), decrement the call
+ *     counter (g_irq_spin_count[cpu]) and if it decrements to zero then
+ *     release the spinlock (g_irq_spin) and restore the interrupt state as
+ *     it was prior to the previous call to spin_lock_irqsave(NULL).
+ *
+ *     If the argument lock is specified, release the lock spinlock and
  *     restore the interrupt state as it was prior to the previous call to
- *     spin_lock_irqsave().
+ *     spin_lock_irqsave(lock).
  *
  *   If SMP and SPINLOCK_IRQ are not enabled:
  *     This function is equivalent to leave_critical_section().
  *
  * Input Parameters:
+ *   lock  - Caller specific spinlock, or NULL for the global spinlock.
  *   flags - The architecture-specific value that represents the state of
- *           the interrupts prior to the call to spin_lock_irqsave();
+ *           the interrupts prior to the call to spin_lock_irqsave(lock);
  *
  * Returned Value:
  *   None
  *
  ****************************************************************************/
 
-void spin_unlock_irqrestore(irqstate_t flags)
+void spin_unlock_irqrestore(FAR spinlock_t *lock, irqstate_t flags)
 {
-  int me = this_cpu();
+  if (NULL == lock)
+    {
+      int me = this_cpu();
 
-  DEBUGASSERT(0 < g_irq_spin_count[me]);
-  g_irq_spin_count[me]--;
+      DEBUGASSERT(0 < g_irq_spin_count[me]);
+      g_irq_spin_count[me]--;
 
-  if (0 == g_irq_spin_count[me])
+      if (0 == g_irq_spin_count[me])
+        {
+          spin_unlock(&g_irq_spin);
+        }
+    }
+  else
     {
-      spin_unlock(&g_irq_spin);
+      spin_unlock(lock);
     }
 
   up_irq_restore(flags);
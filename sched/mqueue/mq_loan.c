@@ -0,0 +1,326 @@
+/****************************************************************************
+ * sched/mqueue/mq_loan.c
+ *
+ *   Copyright (C) 2020 Gregory Nutt. All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in
+ *    the documentation and/or other materials provided with the
+ *    distribution.
+ * 3. Neither the name NuttX nor the names of its contributors may be
+ *    used to endorse or promote products derived from this software
+ *    without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+ * FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE
+ * COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+ * INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,
+ * BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS
+ * OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED
+ * AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ * LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN
+ * ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ *
+ ****************************************************************************/
+
+/****************************************************************************
+ * Included Files
+ ****************************************************************************/
+
+#include <nuttx/config.h>
+
+#include <sys/types.h>
+#include <stddef.h>
+#include <fcntl.h>
+#include <mqueue.h>
+#include <assert.h>
+#include <errno.h>
+
+#include <nuttx/irq.h>
+#include <nuttx/arch.h>
+#include <nuttx/sched.h>
+#include <nuttx/cancelpt.h>
+#include <nuttx/mqueue.h>
+
+#include "sched/sched.h"
+#include "mqueue/mqueue.h"
+
+#ifdef CONFIG_MQ_LOAN
+
+/****************************************************************************
+ * Private Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: nxmq_loan_wait
+ *
+ * Description:
+ *   Take a free slot from the message queue's slab, waiting for one to be
+ *   returned if necessary.  Waiters share the not-full wait list with
+ *   nxmq_wait_send() and are woken by nxmq_wake_notfull().
+ *
+ * Assumptions:
+ * - Executes within a critical section established by the caller.
+ *
+ ****************************************************************************/
+
+static int nxmq_loan_wait(mqd_t mqdes, FAR struct mqueue_msg_s **mqmsg)
+{
+  FAR struct mqueue_inode_s *msgq = mqdes->msgq;
+  FAR struct tcb_s *rtcb;
+  int saved_errno;
+  int ret;
+
+  while (sq_empty(&msgq->slabfree))
+    {
+#ifdef CONFIG_CANCELLATION_POINTS
+      if (check_cancellation_point())
+        {
+          return -ECANCELED;
+        }
+#endif
+
+      if ((mqdes->oflags & O_NONBLOCK) != 0)
+        {
+          return -EAGAIN;
+        }
+
+      /* Block until a slot is returned.  The per-task errno is "borrowed"
+       * to communicate wake-up error conditions, as in nxmq_wait_send().
+       */
+
+      rtcb           = this_task();
+      rtcb->msgwaitq = msgq;
+      msgq->nwaitnotfull++;
+
+      saved_errno    = rtcb->pterrno;
+      rtcb->pterrno  = OK;
+
+      DEBUGASSERT(NULL != rtcb->flink);
+      up_block_task(rtcb, TSTATE_WAIT_MQNOTFULL);
+
+      ret            = rtcb->pterrno;
+      rtcb->pterrno  = saved_errno;
+
+      if (ret != OK)
+        {
+          return -ret;
+        }
+    }
+
+  *mqmsg = (FAR struct mqueue_msg_s *)sq_remfirst(&msgq->slabfree);
+  return OK;
+}
+
+/****************************************************************************
+ * Name: nxmq_loan_hdr
+ *
+ * Description:
+ *   Return the message structure that contains a loaned message buffer.
+ *
+ ****************************************************************************/
+
+static inline FAR struct mqueue_msg_s *nxmq_loan_hdr(FAR char *msg)
+{
+  return (FAR struct mqueue_msg_s *)
+    (msg - offsetof(struct mqueue_msg_s, mail));
+}
+
+/****************************************************************************
+ * Public Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: nxmq_loan_msg
+ *
+ * Description:
+ *   Borrow a free message slot from the message queue's slab.  The caller
+ *   builds the message in place in the returned buffer, which holds up to
+ *   mq_msgsize bytes, and then either queues it with nxmq_send_loan() or
+ *   gives it back with nxmq_return_loan().  If no slot is free, the caller
+ *   blocks unless O_NONBLOCK is set for the message queue.
+ *
+ * Input Parameters:
+ *   mqdes - Message queue descriptor
+ *   msg   - The location to return the message buffer
+ *
+ * Returned Value:
+ *   Zero (OK) is returned on success.  A negated errno value is returned on
+ *   failure (EINVAL, EPERM, EAGAIN, EINTR or ECANCELED).
+ *
+ ****************************************************************************/
+
+int nxmq_loan_msg(mqd_t mqdes, FAR char **msg)
+{
+  FAR struct mqueue_msg_s *mqmsg = NULL;
+  irqstate_t flags;
+  int ret;
+
+  DEBUGASSERT(up_interrupt_context() == false);
+
+  if (mqdes == NULL || msg == NULL || mqdes->msgq->slab == NULL)
+    {
+      return -EINVAL;
+    }
+
+  if ((mqdes->oflags & O_WROK) == 0)
+    {
+      return -EPERM;
+    }
+
+  sched_lock();
+  flags = enter_critical_section();
+  ret   = nxmq_loan_wait(mqdes, &mqmsg);
+  leave_critical_section(flags);
+  sched_unlock();
+
+  if (ret >= 0)
+    {
+      *msg = mqmsg->mail;
+    }
+
+  return ret;
+}
+
+/****************************************************************************
+ * Name: nxmq_send_loan
+ *
+ * Description:
+ *   Queue a message that was built in place in a buffer obtained from
+ *   nxmq_loan_msg().  The payload is not copied.  The message slot was
+ *   reserved by the loan, so this never blocks.
+ *
+ * Input Parameters:
+ *   mqdes  - Message queue descriptor
+ *   msg    - The loaned message buffer
+ *   msglen - The length of the message in bytes
+ *   prio   - The priority of the message
+ *
+ * Returned Value:
+ *   Zero (OK) is returned on success.  A negated errno value is returned on
+ *   failure (EINVAL, EPERM or EMSGSIZE); the loan is kept in that case.
+ *
+ ****************************************************************************/
+
+int nxmq_send_loan(mqd_t mqdes, FAR char *msg, size_t msglen,
+                   unsigned int prio)
+{
+  int ret;
+
+  ret = nxmq_verify_send(mqdes, msg, msglen, prio);
+  if (ret < 0)
+    {
+      return ret;
+    }
+
+  /* nxmq_do_send() sees that the payload is already in place and only
+   * links the message into the queue and wakes up any receiver.
+   */
+
+  return nxmq_do_send(mqdes, nxmq_loan_hdr(msg), msg, msglen, prio);
+}
+
+/****************************************************************************
+ * Name: nxmq_receive_loan
+ *
+ * Description:
+ *   Remove the oldest of the highest priority messages from the message
+ *   queue like nxmq_receive() does, but return a pointer to the message
+ *   in place instead of copying it out.  The caller must hand the buffer
+ *   back with nxmq_return_loan() when it has finished with it.
+ *
+ * Input Parameters:
+ *   mqdes - Message queue descriptor
+ *   msg   - The location to return the message buffer
+ *   prio  - If not NULL, the location to store message priority.
+ *
+ * Returned Value:
+ *   The length of the message is returned on success.  A negated errno
+ *   value is returned on failure (see mq_receive()).
+ *
+ ****************************************************************************/
+
+ssize_t nxmq_receive_loan(mqd_t mqdes, FAR char **msg,
+                          FAR unsigned int *prio)
+{
+  FAR struct mqueue_msg_s *mqmsg;
+  irqstate_t flags;
+  ssize_t ret;
+
+  DEBUGASSERT(up_interrupt_context() == false);
+
+  if (mqdes == NULL || msg == NULL)
+    {
+      return -EINVAL;
+    }
+
+  if ((mqdes->oflags & O_RDOK) == 0)
+    {
+      return -EPERM;
+    }
+
+  sched_lock();
+  flags = enter_critical_section();
+  ret   = nxmq_wait_receive(mqdes, &mqmsg);
+  leave_critical_section(flags);
+  sched_unlock();
+
+  if (ret >= 0)
+    {
+      DEBUGASSERT(mqmsg != NULL);
+
+      /* The slot stays in use until it is returned, so senders waiting
+       * for the queue to become non-full are not woken up yet.
+       */
+
+      *msg = mqmsg->mail;
+      if (prio)
+        {
+          *prio = mqmsg->priority;
+        }
+
+      ret = mqmsg->msglen;
+    }
+
+  return ret;
+}
+
+/****************************************************************************
+ * Name: nxmq_return_loan
+ *
+ * Description:
+ *   Give a message buffer obtained from nxmq_loan_msg() or
+ *   nxmq_receive_loan() back to the message queue.
+ *
+ * Input Parameters:
+ *   mqdes - Message queue descriptor
+ *   msg   - The loaned message buffer
+ *
+ * Returned Value:
+ *   None
+ *
+ ****************************************************************************/
+
+void nxmq_return_loan(mqd_t mqdes, FAR char *msg)
+{
+  FAR struct mqueue_inode_s *msgq;
+
+  DEBUGASSERT(mqdes != NULL && msg != NULL);
+
+  sched_lock();
+  msgq = mqdes->msgq;
+  nxmq_free_msg(msgq, nxmq_loan_hdr(msg));
+  nxmq_wake_notfull(msgq);
+  sched_unlock();
+}
+
+#endif /* CONFIG_MQ_LOAN */
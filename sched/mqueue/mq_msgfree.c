@@ -42,8 +42,7 @@
 #include <queue.h>
 
 #include <nuttx/irq.h>
-#include <nuttx/arch.h>
-#include <nuttx/kmalloc.h>
+#include <nuttx/mm/mempool.h>
 
 #include "mqueue/mqueue.h"
 
@@ -60,6 +59,7 @@
  *   allocated dynamically it will be deallocated.
  *
  * Input Parameters:
+ *   msgq  - The message queue that the message was allocated for
  *   mqmsg - message to free
  *
  * Returned Value:
@@ -67,51 +67,30 @@
  *
  ****************************************************************************/
 
-void nxmq_free_msg(FAR struct mqueue_msg_s *mqmsg)
+void nxmq_free_msg(FAR struct mqueue_inode_s *msgq,
+                   FAR struct mqueue_msg_s *mqmsg)
 {
+#ifdef CONFIG_MQ_LOAN
+  FAR uint8_t *slot = (FAR uint8_t *)mqmsg;
   irqstate_t flags;
 
-  /* If this is a generally available pre-allocated message,
-   * then just put it back in the free list.
-   */
-
-  if (mqmsg->type == MQ_ALLOC_FIXED)
-    {
-      /* Make sure we avoid concurrent access to the free
-       * list from interrupt handlers.
-       */
-
-      flags = enter_critical_section();
-      sq_addlast((FAR sq_entry_t *)mqmsg, &g_msgfree);
-      leave_critical_section(flags);
-    }
+  /* Messages taken from the queue's own slab go back to the slab */
 
-  /* If this is a message pre-allocated for interrupts,
-   * then put it back in the correct  free list.
-   */
-
-  else if (mqmsg->type == MQ_ALLOC_IRQ)
+  if (msgq->slab != NULL && slot >= msgq->slab &&
+      slot < msgq->slab + msgq->maxmsgs * MQ_SLOT_SIZE(msgq->maxmsgsize))
     {
-      /* Make sure we avoid concurrent access to the free
-       * list from interrupt handlers.
-       */
-
       flags = enter_critical_section();
-      sq_addlast((FAR sq_entry_t *)mqmsg, &g_msgfreeirq);
+      sq_addlast((FAR sq_entry_t *)mqmsg, &msgq->slabfree);
       leave_critical_section(flags);
+      return;
     }
+#endif
 
-  /* Otherwise, deallocate it.  Note:  interrupt handlers
-   * will never deallocate messages because they will not
-   * received them.
+  /* Return the message to the pool.  Pre-allocated messages are put back
+   * in the free list; dynamically allocated messages are deallocated.
+   * Note:  interrupt handlers will never deallocate messages because they
+   * will not received them.
    */
 
-  else if (mqmsg->type == MQ_ALLOC_DYN)
-    {
-      sched_kfree(mqmsg);
-    }
-  else
-    {
-      DEBUGPANIC();
-    }
+  mempool_free(&g_msgpool, mqmsg);
 }
@@ -109,6 +109,30 @@ FAR struct mqueue_inode_s *nxmq_alloc_msgq(mode_t mode,
         }
 
       msgq->ntpid = INVALID_PROCESS_ID;
+
+#ifdef CONFIG_MQ_LOAN
+      /* Carve the per-queue message slots out of a single allocation */
+
+      if (msgq->maxmsgs > 0)
+        {
+          size_t slotsize = MQ_SLOT_SIZE(msgq->maxmsgsize);
+          int i;
+
+          msgq->slab = (FAR uint8_t *)kmm_malloc(msgq->maxmsgs * slotsize);
+          if (msgq->slab == NULL)
+            {
+              sched_kfree(msgq);
+              return NULL;
+            }
+
+          sq_init(&msgq->slabfree);
+          for (i = 0; i < msgq->maxmsgs; i++)
+            {
+              sq_addlast((FAR sq_entry_t *)&msgq->slab[i * slotsize],
+                         &msgq->slabfree);
+            }
+        }
+#endif
     }
 
   return msgq;
@@ -78,10 +78,18 @@ void nxmq_free_msgq(FAR struct mqueue_inode_s *msgq)
       /* Deallocate the message structure. */
 
       next = curr->next;
-      nxmq_free_msg(curr);
+      nxmq_free_msg(msgq, curr);
       curr = next;
     }
 
+#ifdef CONFIG_MQ_LOAN
+  /* Release the message slab.  Any messages still on loan are lost with
+   * it.
+   */
+
+  kmm_free(msgq->slab);
+#endif
+
   /* Then deallocate the message queue itself */
 
   sched_kfree(msgq);
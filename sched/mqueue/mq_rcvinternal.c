@@ -262,8 +262,6 @@ int nxmq_wait_receive(mqd_t mqdes, FAR struct mqueue_msg_s **rcvmsg)
 ssize_t nxmq_do_receive(mqd_t mqdes, FAR struct mqueue_msg_s *mqmsg,
                         FAR char *ubuffer, unsigned int *prio)
 {
-  FAR struct tcb_s *btcb;
-  irqstate_t flags;
   FAR struct mqueue_inode_s *msgq;
   ssize_t rcvmsglen;
 
@@ -284,11 +282,39 @@ ssize_t nxmq_do_receive(mqd_t mqdes, FAR struct mqueue_msg_s *mqmsg,
 
   /* We are done with the message.  Deallocate it now. */
 
-  nxmq_free_msg(mqmsg);
+  msgq = mqdes->msgq;
+  nxmq_free_msg(msgq, mqmsg);
 
-  /* Check if any tasks are waiting for the MQ not full event. */
+  /* Wake up any task that is waiting for the MQ not full event. */
+
+  nxmq_wake_notfull(msgq);
+
+  /* Return the length of the message transferred to the user buffer */
+
+  return rcvmsglen;
+}
+
+/****************************************************************************
+ * Name: nxmq_wake_notfull
+ *
+ * Description:
+ *   Wake up the highest priority task waiting for the message queue to
+ *   become non-full, if there is one.  This is called whenever a message
+ *   is removed from the queue or a message slot is returned to it.
+ *
+ * Input Parameters:
+ *   msgq - The message queue
+ *
+ * Returned Value:
+ *   None
+ *
+ ****************************************************************************/
+
+void nxmq_wake_notfull(FAR struct mqueue_inode_s *msgq)
+{
+  FAR struct tcb_s *btcb;
+  irqstate_t flags;
 
-  msgq = mqdes->msgq;
   if (msgq->nwaitnotfull > 0)
     {
       /* Find the highest priority task that is waiting for
@@ -311,12 +337,9 @@ ssize_t nxmq_do_receive(mqd_t mqdes, FAR struct mqueue_msg_s *mqmsg,
 
       btcb->msgwaitq = NULL;
       msgq->nwaitnotfull--;
+      sched_latency_wakeup(btcb);
       up_unblock_task(btcb);
 
       leave_critical_section(flags);
     }
-
-  /* Return the length of the message transferred to the user buffer */
-
-  return rcvmsglen;
 }
@@ -53,6 +53,7 @@
 #include <nuttx/arch.h>
 #include <nuttx/sched.h>
 #include <nuttx/cancelpt.h>
+#include <nuttx/mm/mempool.h>
 
 #include "sched/sched.h"
 #include "mqueue/mqueue.h"
@@ -114,8 +115,8 @@ int nxmq_verify_send(mqd_t mqdes, FAR const char *msg, size_t msglen,
  *
  * Description:
  *   The nxmq_alloc_msg function will get a free message for use by the
- *   operating system.  The message will be allocated from the g_msgfree
- *   list.
+ *   operating system.  The message will be allocated from the queue's own
+ *   slab if it has a free slot, otherwise from g_msgpool.
  *
  *   If the list is empty AND the message is NOT being allocated from the
  *   interrupt level, then the message will be allocated.  If a message
@@ -123,12 +124,12 @@ int nxmq_verify_send(mqd_t mqdes, FAR const char *msg, size_t msglen,
  *   continue.
  *
  *   If the list is empty AND the message IS being allocated from the
- *   interrupt level.  This function will attempt to get a message from
- *   the g_msgfreeirq list.  If this is unsuccessful, the calling interrupt
- *   handler will be notified.
+ *   interrupt level.  This function will attempt to get one of the
+ *   messages reserved for interrupt handlers.  If this is unsuccessful,
+ *   the calling interrupt handler will be notified.
  *
  * Input Parameters:
- *   None
+ *   msgq - The message queue that the message will be sent to
  *
  * Returned Value:
  *   A reference to the allocated msg structure.  On a failure to allocate,
@@ -136,62 +137,32 @@ int nxmq_verify_send(mqd_t mqdes, FAR const char *msg, size_t msglen,
  *
  ****************************************************************************/
 
-FAR struct mqueue_msg_s *nxmq_alloc_msg(void)
+FAR struct mqueue_msg_s *nxmq_alloc_msg(FAR struct mqueue_inode_s *msgq)
 {
+#ifdef CONFIG_MQ_LOAN
   FAR struct mqueue_msg_s *mqmsg;
   irqstate_t flags;
 
-  /* If we were called from an interrupt handler, then try to get the message
-   * from generally available list of messages. If this fails, then try the
-   * list of messages reserved for interrupt handlers
+  /* The slab is normally large enough for every message that the queue
+   * can hold.  It only runs dry while slots are out on loan.
    */
 
-  if (up_interrupt_context())
-    {
-      /* Try the general free list */
-
-      mqmsg = (FAR struct mqueue_msg_s *)sq_remfirst(&g_msgfree);
-      if (mqmsg == NULL)
-        {
-          /* Try the free list reserved for interrupt handlers */
-
-          mqmsg = (FAR struct mqueue_msg_s *)sq_remfirst(&g_msgfreeirq);
-        }
-    }
-
-  /* We were not called from an interrupt handler. */
+  flags = enter_critical_section();
+  mqmsg = (FAR struct mqueue_msg_s *)sq_remfirst(&msgq->slabfree);
+  leave_critical_section(flags);
 
-  else
+  if (mqmsg != NULL)
     {
-      /* Try to get the message from the generally available free list.
-       * Disable interrupts -- we might be called from an interrupt handler.
-       */
-
-      flags = enter_critical_section();
-      mqmsg = (FAR struct mqueue_msg_s *)sq_remfirst(&g_msgfree);
-      leave_critical_section(flags);
-
-      /* If we cannot a message from the free list, then we will have to
-       * allocate one.
-       */
-
-      if (mqmsg == NULL)
-        {
-          mqmsg = (FAR struct mqueue_msg_s *)
-            kmm_malloc((sizeof (struct mqueue_msg_s)));
-
-          /* Check if we allocated the message */
-
-          if (mqmsg != NULL)
-            {
-              /* Yes... remember that this message was dynamically allocated */
-
-              mqmsg->type = MQ_ALLOC_DYN;
-            }
-        }
+      return mqmsg;
     }
+#endif
+
+  /* Interrupt handlers may use the messages reserved for interrupt
+   * handlers if the generally available messages are exhausted.  Normal
+   * tasks will allocate the message from the heap instead.
+   */
 
-  return mqmsg;
+  return (FAR struct mqueue_msg_s *)mempool_alloc(&g_msgpool);
 }
 
 /****************************************************************************
@@ -357,9 +328,14 @@ int nxmq_do_send(mqd_t mqdes, FAR struct mqueue_msg_s *mqmsg,
   mqmsg->priority = prio;
   mqmsg->msglen   = msglen;
 
-  /* Copy the message data into the message */
+  /* Copy the message data into the message, unless it was built in place
+   * in a loaned message.
+   */
 
-  memcpy((FAR void *)mqmsg->mail, (FAR const void *)msg, msglen);
+  if (msg != mqmsg->mail)
+    {
+      memcpy((FAR void *)mqmsg->mail, (FAR const void *)msg, msglen);
+    }
 
   /* Insert the new message in the message queue */
 
@@ -437,6 +413,7 @@ int nxmq_do_send(mqd_t mqdes, FAR struct mqueue_msg_s *mqmsg,
 
       btcb->msgwaitq = NULL;
       msgq->nwaitnotempty--;
+      sched_latency_wakeup(btcb);
       up_unblock_task(btcb);
     }
 
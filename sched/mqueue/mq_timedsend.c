@@ -180,7 +180,7 @@ int nxmq_timedsend(mqd_t mqdes, FAR const char *msg, size_t msglen,
 
   /* Pre-allocate a message structure */
 
-  mqmsg = nxmq_alloc_msg();
+  mqmsg = nxmq_alloc_msg(mqdes->msgq);
   if (mqmsg == NULL)
     {
       /* Failed to allocate the message. nxmq_alloc_msg() does not set the
@@ -326,7 +326,7 @@ errout_in_critical_section:
    */
 
 errout_with_mqmsg:
-  nxmq_free_msg(mqmsg);
+  nxmq_free_msg(mqdes->msgq, mqmsg);
   sched_unlock();
   return ret;
 }
@@ -46,6 +46,7 @@
 #include <nuttx/arch.h>
 #include <nuttx/mqueue.h>
 
+#include "sched/sched.h"
 #include "mqueue/mqueue.h"
 
 /****************************************************************************
@@ -118,6 +119,7 @@ void nxmq_wait_irq(FAR struct tcb_s *wtcb, int errcode)
 
       /* Restart the task. */
 
+      sched_latency_wakeup(wtcb);
       up_unblock_task(wtcb);
     }
 
@@ -46,11 +46,13 @@
 #include <sys/types.h>
 #include <stdint.h>
 #include <stdbool.h>
+#include <stddef.h>
 #include <limits.h>
 #include <mqueue.h>
 #include <sched.h>
 
 #include <nuttx/mqueue.h>
+#include <nuttx/mm/mempool.h>
 
 #if CONFIG_MQ_MAXMSGSIZE > 0
 
@@ -74,23 +76,25 @@
 
 #define NUM_INTERRUPT_MSGS   8
 
+/* The size of one message slot in a per-queue slab holding messages of up
+ * to 'n' bytes.
+ */
+
+#ifdef CONFIG_MQ_LOAN
+#  define MQ_SLOT_SIZE(n) \
+     ((offsetof(struct mqueue_msg_s, mail) + (n) + sizeof(uintptr_t) - 1) & \
+      ~(sizeof(uintptr_t) - 1))
+#endif
+
 /****************************************************************************
  * Public Type Definitions
  ****************************************************************************/
 
-enum mqalloc_e
-{
-  MQ_ALLOC_FIXED = 0,  /* Pre-allocated; never freed */
-  MQ_ALLOC_DYN,        /* Dynamically allocated; free when unused */
-  MQ_ALLOC_IRQ         /* Preallocated, reserved for interrupt handling */
-};
-
 /* This structure describes one buffered POSIX message. */
 
 struct mqueue_msg_s
 {
   FAR struct mqueue_msg_s *next;  /* Forward link to next message */
-  uint8_t type;                   /* (Used to manage allocations) */
   uint8_t priority;               /* priority of message */
 #if MQ_MAX_BYTES < 256
   uint8_t msglen;                 /* Message data length */
@@ -112,17 +116,12 @@ extern "C"
 #define EXTERN extern
 #endif
 
-/* The g_msgfree is a list of messages that are available for general use.
- * The number of messages in this list is a system configuration item.
- */
-
-EXTERN sq_queue_t  g_msgfree;
-
-/* The g_msgfreeInt is a list of messages that are reserved for use by
- * interrupt handlers.
+/* The g_msgpool is the pool of messages available for general use.  The
+ * number of pre-allocated messages is a system configuration item; an
+ * additional NUM_INTERRUPT_MSGS are reserved for use by interrupt handlers.
  */
 
-EXTERN sq_queue_t  g_msgfreeirq;
+EXTERN struct mempool_s g_msgpool;
 
 /* The g_desfree data structure is a list of message descriptors available
  * to the operating system for general use. The number of messages in the
@@ -142,7 +141,8 @@ struct task_group_s; /* Forward reference */
 
 void weak_function nxmq_initialize(void);
 void nxmq_alloc_desblock(void);
-void nxmq_free_msg(FAR struct mqueue_msg_s *mqmsg);
+void nxmq_free_msg(FAR struct mqueue_inode_s *msgq,
+                   FAR struct mqueue_msg_s *mqmsg);
 
 /* mq_waitirq.c ************************************************************/
 
@@ -154,12 +154,13 @@ int nxmq_verify_receive(mqd_t mqdes, FAR char *msg, size_t msglen);
 int nxmq_wait_receive(mqd_t mqdes, FAR struct mqueue_msg_s **rcvmsg);
 ssize_t nxmq_do_receive(mqd_t mqdes, FAR struct mqueue_msg_s *mqmsg,
                         FAR char *ubuffer, FAR unsigned int *prio);
+void nxmq_wake_notfull(FAR struct mqueue_inode_s *msgq);
 
 /* mq_sndinternal.c ********************************************************/
 
 int nxmq_verify_send(mqd_t mqdes, FAR const char *msg, size_t msglen,
                      unsigned int prio);
-FAR struct mqueue_msg_s *nxmq_alloc_msg(void);
+FAR struct mqueue_msg_s *nxmq_alloc_msg(FAR struct mqueue_inode_s *msgq);
 int nxmq_wait_send(mqd_t mqdes);
 int nxmq_do_send(mqd_t mqdes, FAR struct mqueue_msg_s *mqmsg,
                  FAR const char *msg, size_t msglen, unsigned int prio);
@@ -44,8 +44,85 @@
 #include <errno.h>
 #include <debug.h>
 
+#include <nuttx/irq.h>
+
+#include "sched/sched.h"
 #include "pthread/pthread.h"
 
+/****************************************************************************
+ * Private Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: pthread_cond_morph
+ *
+ * Description:
+ *   Move the threads waiting on the condition in pthread_cond_wait() onto
+ *   the wait list of the mutex (wait morphing).  Each one will be restarted
+ *   when it is given the mutex, rather than being restarted now only to
+ *   block on the mutex again.  This is only possible while the mutex is
+ *   held; timed waits are left alone.
+ *
+ * Input Parameters:
+ *   cond - The condition being broadcast
+ *
+ * Returned Value:
+ *   The number of waiting threads that were moved.
+ *
+ * Assumptions:
+ *   Interrupts are disabled.
+ *
+ ****************************************************************************/
+
+static int pthread_cond_morph(FAR pthread_cond_t *cond)
+{
+  FAR struct tcb_s *stcb;
+  FAR sem_t *msem;
+  int16_t count;
+  int nmorphed = 0;
+
+  for (stcb = (FAR struct tcb_s *)g_waitingforsemaphore.head;
+       stcb != NULL;
+       stcb = stcb->flink)
+    {
+      if (stcb->waitsem != &cond->sem || stcb->waitdog != NULL)
+        {
+          continue;
+        }
+
+      /* Take a count on the mutex semaphore for the waiter, but only if
+       * that leaves it waiting.  A fast path post may race with us.
+       */
+
+      msem  = &cond->mutex->sem;
+      count = msem->semcount;
+      if (count > 0)
+        {
+          break;
+        }
+
+#ifdef CONFIG_SEM_FASTPATH
+      if (!__atomic_compare_exchange_n(&msem->semcount, &count,
+                                       (int16_t)(count - 1), false,
+                                       __ATOMIC_ACQUIRE, __ATOMIC_RELAXED))
+        {
+          break;
+        }
+#else
+      msem->semcount = count - 1;
+#endif
+
+      /* The waiter no longer waits on the condition, but on the mutex */
+
+      cond->sem.semcount++;
+      stcb->waitsem = msem;
+      stcb->flags  |= TCB_FLAG_COND_MORPHED;
+      nmorphed++;
+    }
+
+  return nmorphed;
+}
+
 /****************************************************************************
  * Public Functions
  ****************************************************************************/
@@ -68,6 +145,7 @@
 
 int pthread_cond_broadcast(FAR pthread_cond_t *cond)
 {
+  irqstate_t flags;
   int ret = OK;
   int sval;
 
@@ -85,6 +163,7 @@ int pthread_cond_broadcast(FAR pthread_cond_t *cond)
        */
 
       sched_lock();
+      flags = enter_critical_section();
 
       /* Get the current value of the semaphore */
 
@@ -94,7 +173,25 @@ int pthread_cond_broadcast(FAR pthread_cond_t *cond)
         }
       else
         {
-          /* Loop until all of the waiting threads have been restarted. */
+          /* Restart the highest priority waiting thread.  It will contend
+           * for the mutex; the others are moved onto the mutex wait list
+           * so that they run one at a time as the mutex is passed on.
+           */
+
+          if (sval < 0)
+            {
+              ret = pthread_sem_give((FAR sem_t *)&cond->sem);
+              sval++;
+            }
+
+          if (sval < 0 && cond->mutex != NULL)
+            {
+              sval += pthread_cond_morph(cond);
+            }
+
+          /* Loop until all of the other waiting threads have been
+           * restarted.
+           */
 
           while (sval < 0)
             {
@@ -115,6 +212,7 @@ int pthread_cond_broadcast(FAR pthread_cond_t *cond)
 
       /* Now we can let the restarted threads run */
 
+      leave_critical_section(flags);
       sched_unlock();
     }
 
@@ -45,8 +45,10 @@
 #include <errno.h>
 #include <debug.h>
 
+#include <nuttx/irq.h>
 #include <nuttx/cancelpt.h>
 
+#include "sched/sched.h"
 #include "pthread/pthread.h"
 
 /****************************************************************************
@@ -71,6 +73,9 @@
 
 int pthread_cond_wait(FAR pthread_cond_t *cond, FAR pthread_mutex_t *mutex)
 {
+  FAR struct tcb_s *rtcb = this_task();
+  irqstate_t flags;
+  bool morphed;
   int status;
   int ret;
 
@@ -100,12 +105,34 @@ int pthread_cond_wait(FAR pthread_cond_t *cond, FAR pthread_mutex_t *mutex)
       sinfo("Give up mutex / take cond\n");
 
       sched_lock();
-      mutex->pid = -1;
+      mutex->pid  = -1;
+      cond->mutex = mutex;
       ret = pthread_mutex_give(mutex);
 
-      /* Take the semaphore */
+      /* Take the semaphore.  pthread_cond_broadcast() may move the wait
+       * onto the mutex, in which case the mutex is already held when the
+       * wait ends.  An interrupted wait on the mutex is not restarted on
+       * the condition:  The broadcast has already been received.
+       */
+
+      do
+        {
+          status = -nxsem_wait((FAR sem_t *)&cond->sem);
+        }
+      while ((status == EINTR || status == ECANCELED) &&
+             (rtcb->flags & TCB_FLAG_COND_MORPHED) == 0);
+
+      flags        = enter_critical_section();
+      morphed      = (rtcb->flags & TCB_FLAG_COND_MORPHED) != 0;
+      rtcb->flags &= ~TCB_FLAG_COND_MORPHED;
+      leave_critical_section(flags);
+
+      if (morphed && status != OK)
+        {
+          morphed = false;
+          status  = OK;
+        }
 
-      status = pthread_sem_take((FAR sem_t *)&cond->sem, NULL, false);
       if (ret == OK)
         {
           /* Report the first failure that occurs */
@@ -124,7 +151,15 @@ int pthread_cond_wait(FAR pthread_cond_t *cond, FAR pthread_mutex_t *mutex)
 
       sinfo("Reacquire mutex...\n");
 
-      status = pthread_mutex_take(mutex, NULL, false);
+      if (morphed)
+        {
+          status = pthread_mutex_taken(mutex);
+        }
+      else
+        {
+          status = pthread_mutex_take(mutex, NULL, false);
+        }
+
       if (ret == OK)
         {
           /* Report the first failure that occurs */
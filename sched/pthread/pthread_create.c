@@ -485,6 +485,16 @@ int pthread_create(FAR pthread_t *thread, FAR const pthread_attr_t *attr,
         break;
 #endif
 
+#ifdef CONFIG_SCHED_DEADLINE
+      case SCHED_DEADLINE:
+        {
+          /* Deadline reservations are not inherited by new threads */
+
+          ptcb->cmn.flags  |= TCB_FLAG_SCHED_FIFO;
+        }
+        break;
+#endif
+
 #if 0 /* Not supported */
       case SCHED_OTHER:
         ptcb->cmn.flags    |= TCB_FLAG_SCHED_OTHER;
@@ -106,7 +106,7 @@ int pthread_key_create(FAR pthread_key_t *key,
    * avoid concurrent modification of the group keyset.
    */
 
-  flags = spin_lock_irqsave();
+  flags = spin_lock_irqsave(NULL);
   for (candidate = 0; candidate < PTHREAD_KEYS_MAX; candidate++)
     {
       /* Is this candidate key available? */
@@ -121,7 +121,7 @@ int pthread_key_create(FAR pthread_key_t *key,
         }
     }
 
-  spin_unlock_irqrestore(flags);
+  spin_unlock_irqrestore(NULL, flags);
 
   /* Check if found a valid key. */
 
@@ -87,11 +87,11 @@ int pthread_key_delete(pthread_key_t key)
        */
 
       mask  = (1 << key);
-      flags = spin_lock_irqsave();
+      flags = spin_lock_irqsave(NULL);
 
       DEBUGASSERT((group->tg_keyset & mask) != 0);
       group->tg_keyset &= ~mask;
-      spin_unlock_irqrestore(flags);
+      spin_unlock_irqrestore(NULL, flags);
 
       ret = OK;
     }
@@ -231,6 +231,48 @@ int pthread_mutex_take(FAR struct pthread_mutex_s *mutex,
   return ret;
 }
 
+/****************************************************************************
+ * Name: pthread_mutex_taken
+ *
+ * Description:
+ *   Complete taking a mutex whose semaphore count was given to the calling
+ *   thread by someone else:  A pthread_cond_broadcast() that moved the
+ *   condition wait onto the mutex.
+ *
+ * Input Parameters:
+ *  mutex - The mutex that is now held
+ *
+ * Returned Value:
+ *   0 on success or an errno value on failure.
+ *
+ ****************************************************************************/
+
+int pthread_mutex_taken(FAR struct pthread_mutex_s *mutex)
+{
+  int ret = OK;
+
+  DEBUGASSERT(mutex != NULL);
+
+  sched_lock();
+
+  /* Check if the holder of the mutex has terminated without releasing it */
+
+  if ((mutex->flags & _PTHREAD_MFLAGS_INCONSISTENT) != 0)
+    {
+      ret = EOWNERDEAD;
+    }
+
+  /* Add the mutex to the list of mutexes held by this task */
+
+  else
+    {
+      pthread_mutex_add(mutex);
+    }
+
+  sched_unlock();
+  return ret;
+}
+
 /****************************************************************************
  * Name: pthread_mutex_trytake
  *
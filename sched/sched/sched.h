@@ -119,6 +119,22 @@
 #  define TLIST_BLOCKED(s)       __TLIST_HEAD(s)
 #endif
 
+/* A SCHED_DEADLINE TCB is ordered before any SCHED_DEADLINE TCB of the same
+ * priority that has a later absolute deadline.
+ */
+
+#ifdef CONFIG_SCHED_DEADLINE
+#  define sched_isdeadline(t) \
+     (((t)->flags & TCB_FLAG_POLICY_MASK) == TCB_FLAG_SCHED_DEADLINE)
+#  define sched_deadline_before(t1,t2) \
+     (sched_isdeadline(t1) && sched_isdeadline(t2) && \
+      (sclock_t)((t1)->deadline.absdeadline - \
+                 (t2)->deadline.absdeadline) < 0)
+#else
+#  define sched_isdeadline(t)          (false)
+#  define sched_deadline_before(t1,t2) (false)
+#endif
+
 /****************************************************************************
  * Public Type Definitions
  ****************************************************************************/
@@ -153,6 +169,26 @@ struct tasklist_s
   uint8_t attr;                   /* List attribute flags */
 };
 
+#ifdef CONFIG_SCHED_PRIOBITMAP
+/* This structure indexes a prioritized task list by priority.  Bit 'n' of
+ * 'bitmap' is set if the list holds at least one TCB of priority 'n' and
+ * tail[n] then points to the last TCB of that priority in the list.  Bit
+ * 'g' of 'group' is set if any bit of bitmap[g] is set.
+ */
+
+#define PRIOINDEX_NWORDS         ((SCHED_PRIORITY_MAX + 32) / 32)
+
+struct prioindex_s
+{
+  uint8_t group;                     /* Non-empty words of bitmap[] */
+  uint32_t bitmap[PRIOINDEX_NWORDS]; /* Priorities present in the list */
+
+  /* The last TCB of each priority in the list */
+
+  FAR struct tcb_s *tail[SCHED_PRIORITY_MAX + 1];
+};
+#endif
+
 /****************************************************************************
  * Public Data
  ****************************************************************************/
@@ -346,38 +382,30 @@ extern volatile uint32_t g_cpuload_total;
  * stopping the other CPUs): Even though pre-emption is disabled, other
  * threads will still be executing on the other CPUS.
  *
- * There are additional rules for this multi-CPU case:
+ * sched_lock() therefore disables pre-emption on the calling CPU only:
+ *
+ * 1. Pre-emption is disabled on a CPU if the TCB at the head of its
+ *    g_assignedtasks[cpu] list has 'lockcount' > 0 (sched_islocked_cpu()).
+ *    No global state is modified and no lock is taken.
+ * 2. A task that would pre-empt the task running on such a CPU is placed
+ *    in the g_pendingtasks list instead.  The decision is deferred until
+ *    that CPU calls sched_unlock(), which releases the pending tasks.  The
+ *    other CPUs keep switching tasks as usual.
  *
- * 1. There is a global lock count 'g_cpu_lockset' that includes a bit for
- *    each CPU: If the bit is '1', then the corresponding CPU has the
- *    scheduler locked; if '0', then the CPU does not have the scheduler
- *    locked.
- * 2. Scheduling logic would set the bit associated with the cpu in
- *    'g_cpu_lockset' when the TCB at the head of the g_assignedtasks[cpu]
- *    list transitions has 'lockcount' > 0. This might happen when sched_lock()
- *    is called, or after a context switch that changes the TCB at the
- *    head of the g_assignedtasks[cpu] list.
- * 3. Similarly, the cpu bit in the global 'g_cpu_lockset' would be cleared
- *    when the TCB at the head of the g_assignedtasks[cpu] list has
- *    'lockcount' == 0. This might happen when sched_unlock() is called, or
- *    after a context switch that changes the TCB at the head of the
- *    g_assignedtasks[cpu] list.
- * 4. Modification of the global 'g_cpu_lockset' must be protected by a
- *    spinlock, 'g_cpu_schedlock'. That spinlock would be taken when
- *    sched_lock() is called, and released when sched_unlock() is called.
- *    This assures that the scheduler does enforce the critical section.
- *    NOTE: Because of this spinlock, there should never be more than one
- *    bit set in 'g_cpu_lockset'; attempts to set additional bits should
- *    be cause the CPU to block on the spinlock.  However, additional bits
- *    could get set in 'g_cpu_lockset' due to the context switches on the
- *    various CPUs.
- * 5. Each the time the head of a g_assignedtasks[] list changes and the
- *    scheduler modifies 'g_cpu_lockset', it must also set 'g_cpu_schedlock'
- *    depending on the new state of 'g_cpu_lockset'.
- * 5. Logic that currently uses the currently running tasks lockcount
- *    instead uses the global 'g_cpu_schedlock'. A value of SP_UNLOCKED
- *    means that no CPU has pre-emption disabled; SP_LOCKED means that at
- *    least one CPU has pre-emption disabled.
+ * sched_lock_global() keeps the system-wide semantics for the few callers
+ * that need them:  No CPU starts a new task while it is held.
+ *
+ * 3. There is a global lock set 'g_cpu_lockset' that includes a bit for
+ *    each CPU: If the bit is '1', then the task running on that CPU holds
+ *    the global lock ('glockcount' > 0).
+ * 4. Scheduling logic sets or clears the bit of a CPU when
+ *    sched_lock_global() or sched_unlock_global() changes 'glockcount'
+ *    between zero and non-zero, and each time the head of the
+ *    g_assignedtasks[cpu] list changes.
+ * 5. Modification of 'g_cpu_lockset' is protected by 'g_cpu_locksetlock'
+ *    and the spinlock 'g_cpu_schedlock' is locked whenever any bit is set.
+ *    A value of SP_UNLOCKED means that no CPU holds the global lock
+ *    (sched_islocked_global()).
  */
 
 extern volatile spinlock_t g_cpu_schedlock SP_SECTION;
@@ -410,6 +438,12 @@ extern volatile int16_t g_global_lockcount;
 bool sched_addreadytorun(FAR struct tcb_s *rtrtcb);
 bool sched_removereadytorun(FAR struct tcb_s *rtrtcb);
 bool sched_addprioritized(FAR struct tcb_s *tcb, DSEG dq_queue_t *list);
+#ifdef CONFIG_SCHED_PRIOBITMAP
+void sched_removeprioritized(FAR struct tcb_s *tcb, DSEG dq_queue_t *list);
+#else
+#  define sched_removeprioritized(tcb,list) \
+     dq_rem((FAR dq_entry_t *)(tcb), (list))
+#endif
 void sched_mergeprioritized(FAR dq_queue_t *list1, FAR dq_queue_t *list2,
                             uint8_t task_state);
 bool sched_mergepending(void);
@@ -417,6 +451,16 @@ void sched_addblocked(FAR struct tcb_s *btcb, tstate_t task_state);
 void sched_removeblocked(FAR struct tcb_s *btcb);
 int  nxsched_setpriority(FAR struct tcb_s *tcb, int sched_priority);
 
+/* Priority bitmap task list index */
+
+#ifdef CONFIG_SCHED_PRIOBITMAP
+FAR struct prioindex_s *sched_prioindex(DSEG dq_queue_t *list);
+FAR struct tcb_s *sched_prioindex_prev(FAR struct prioindex_s *index,
+                                       uint8_t sched_priority);
+void sched_prioindex_add(FAR struct prioindex_s *index,
+                         FAR struct tcb_s *tcb);
+#endif
+
 /* Priority inheritance support */
 
 #ifdef CONFIG_PRIORITY_INHERITANCE
@@ -457,6 +501,19 @@ uint32_t sched_sporadic_process(FAR struct tcb_s *tcb, uint32_t ticks,
 void sched_sporadic_lowpriority(FAR struct tcb_s *tcb);
 #endif
 
+#ifdef CONFIG_SCHED_DEADLINE
+struct sched_param; /* Forward reference */
+int  sched_deadline_admit(FAR struct tcb_s *tcb,
+                          FAR const struct sched_param *param);
+void sched_deadline_stop(FAR struct tcb_s *tcb);
+void sched_deadline_wakeup(FAR struct tcb_s *tcb);
+void sched_deadline_replenish(FAR struct tcb_s *tcb);
+uint32_t sched_deadline_process(FAR struct tcb_s *tcb, uint32_t ticks,
+                                bool noswitches);
+void sched_deadline_getparam(FAR struct tcb_s *tcb,
+                             FAR struct sched_param *param);
+#endif
+
 #ifdef CONFIG_SIG_SIGSTOP_ACTION
 void sched_suspend(FAR struct tcb_s *tcb);
 void sched_continue(FAR struct tcb_s *tcb);
@@ -467,12 +524,17 @@ void sched_continue(FAR struct tcb_s *tcb);
 FAR struct tcb_s *this_task(void);
 #endif
 
-int  sched_cpu_select(cpu_set_t affinity);
+int  sched_cpu_select(cpu_set_t affinity, int prefer);
 int  sched_cpu_pause(FAR struct tcb_s *tcb);
 
 irqstate_t sched_tasklist_lock(void);
 void sched_tasklist_unlock(irqstate_t lock);
 
+#ifdef CONFIG_SMP_LOADBALANCE
+FAR struct tcb_s *sched_unbalanced(void);
+void sched_loadbalance(void);
+#endif
+
 #if defined(CONFIG_ARCH_HAVE_FETCHADD) && !defined(CONFIG_ARCH_GLOBAL_IRQDISABLE)
 #  define sched_islocked_global() \
      (spin_islocked(&g_cpu_schedlock) || g_global_lockcount > 0)
@@ -481,20 +543,29 @@ void sched_tasklist_unlock(irqstate_t lock);
      spin_islocked(&g_cpu_schedlock)
 #endif
 
-#  define sched_islocked_tcb(tcb) sched_islocked_global()
+/* True if pre-emption is disabled on the CPU */
+
+#  define sched_islocked_cpu(cpu) (current_task(cpu)->lockcount > 0)
 
 #else
-#  define sched_cpu_select(a)     (0)
+#  define sched_cpu_select(a,p)   (0)
 #  define sched_cpu_pause(t)      (-38)  /* -ENOSYS */
-#  define sched_islocked_tcb(tcb) ((tcb)->lockcount > 0)
 #endif
 
+#define sched_islocked_tcb(tcb)   ((tcb)->lockcount > 0)
+
 #if defined(CONFIG_SCHED_CPULOAD) && !defined(CONFIG_SCHED_CPULOAD_EXTCLK)
 /* CPU load measurement support */
 
 void weak_function nxsched_process_cpuload(void);
 #endif
 
+#ifdef CONFIG_SCHED_CPULOAD_CYCLES
+void sched_cpuload_suspend(FAR struct tcb_s *tcb);
+void sched_cpuload_irqenter(void);
+void sched_cpuload_irqleave(void);
+#endif
+
 /* Critical section monitor */
 
 #ifdef CONFIG_SCHED_CRITMONITOR
@@ -504,6 +575,15 @@ void sched_critmon_resume(FAR struct tcb_s *tcb);
 void sched_critmon_suspend(FAR struct tcb_s *tcb);
 #endif
 
+/* Scheduler latency tracer */
+
+#ifdef CONFIG_SCHED_LATENCY
+void sched_latency_wakeup(FAR struct tcb_s *tcb);
+void sched_latency_resume(FAR struct tcb_s *tcb);
+#else
+#  define sched_latency_wakeup(tcb)
+#endif
+
 /* TCB operations */
 
 bool sched_verifytcb(FAR struct tcb_s *tcb);
@@ -80,6 +80,9 @@ bool sched_addprioritized(FAR struct tcb_s *tcb, DSEG dq_queue_t *list)
 {
   FAR struct tcb_s *next;
   FAR struct tcb_s *prev;
+#ifdef CONFIG_SCHED_PRIOBITMAP
+  FAR struct prioindex_s *index;
+#endif
   uint8_t sched_priority = tcb->sched_priority;
   bool ret = false;
 
@@ -87,13 +90,44 @@ bool sched_addprioritized(FAR struct tcb_s *tcb, DSEG dq_queue_t *list)
 
   DEBUGASSERT(sched_priority >= SCHED_PRIORITY_MIN);
 
-  /* Search the list to find the location to insert the new Tcb.
-   * Each is list is maintained in descending sched_priority order.
+#ifdef CONFIG_SCHED_PRIOBITMAP
+  /* If the list is indexed, the new TCB goes just after the last TCB of
+   * the same or the next higher priority.
    */
 
-  for (next = (FAR struct tcb_s *)list->head;
-       (next && sched_priority <= next->sched_priority);
-       next = next->flink);
+  index = sched_prioindex(list);
+  if (index != NULL)
+    {
+      prev = sched_prioindex_prev(index, sched_priority);
+
+#ifdef CONFIG_SCHED_DEADLINE
+      /* A deadline TCB goes before the deadline TCBs of the same priority
+       * that have later deadlines.
+       */
+
+      while (prev != NULL && prev->sched_priority == sched_priority &&
+             sched_deadline_before(tcb, prev))
+        {
+          prev = prev->blink;
+        }
+#endif
+
+      next = prev ? prev->flink : (FAR struct tcb_s *)list->head;
+    }
+  else
+#endif
+    {
+      /* Search the list to find the location to insert the new Tcb.
+       * Each is list is maintained in descending sched_priority order.
+       * Deadline TCBs of the same priority are in deadline order.
+       */
+
+      for (next = (FAR struct tcb_s *)list->head;
+           (next && (sched_priority < next->sched_priority ||
+                     (sched_priority == next->sched_priority &&
+                      !sched_deadline_before(tcb, next))));
+           next = next->flink);
+    }
 
   /* Add the tcb to the spot found in the list.  Check if the tcb
    * goes at the end of the list. NOTE:  This could only happen if list
@@ -151,6 +185,16 @@ bool sched_addprioritized(FAR struct tcb_s *tcb, DSEG dq_queue_t *list)
         }
     }
 
+#ifdef CONFIG_SCHED_PRIOBITMAP
+  /* The index only records the last TCB of each priority */
+
+  if (index != NULL &&
+      (tcb->flink == NULL || tcb->flink->sched_priority != sched_priority))
+    {
+      sched_prioindex_add(index, tcb);
+    }
+#endif
+
   return ret;
 }
 
@@ -91,7 +91,9 @@ bool sched_addreadytorun(FAR struct tcb_s *btcb)
    * also disabled.
    */
 
-  if (rtcb->lockcount > 0 && rtcb->sched_priority < btcb->sched_priority)
+  if (rtcb->lockcount > 0 &&
+      (rtcb->sched_priority < btcb->sched_priority ||
+       sched_deadline_before(btcb, rtcb)))
     {
       /* Yes.  Preemption would occur!  Add the new ready-to-run task to the
        * g_pendingtasks task list for now.
@@ -167,6 +169,9 @@ bool sched_addreadytorun(FAR struct tcb_s *btcb)
 bool sched_addreadytorun(FAR struct tcb_s *btcb)
 {
   FAR struct tcb_s *rtcb;
+#ifdef CONFIG_SMP_LOADBALANCE
+  FAR struct tcb_s *pushtcb = NULL;
+#endif
   FAR dq_queue_t *tasklist;
   bool switched;
   bool doswitch;
@@ -192,7 +197,7 @@ bool sched_addreadytorun(FAR struct tcb_s *btcb)
        * (possibly its IDLE task).
        */
 
-      cpu = sched_cpu_select(btcb->affinity);
+      cpu = sched_cpu_select(btcb->affinity, btcb->cpu);
     }
 
   /* Get the task currently running on the CPU (may be the IDLE task) */
@@ -229,7 +234,8 @@ bool sched_addreadytorun(FAR struct tcb_s *btcb)
 
   /* If the selected state is TSTATE_TASK_RUNNING, then we would like to
    * start running the task.  Be we cannot do that if pre-emption is
-   * disabled.  If the selected state is TSTATE_TASK_READYTORUN, then it
+   * disabled on the selected CPU or globally.  If the selected state is
+   * TSTATE_TASK_READYTORUN and the global scheduler lock is held, then it
    * should also go to the pending task list so that it will have a chance
    * to be restarted when the scheduler is unlocked.
    *
@@ -241,11 +247,13 @@ bool sched_addreadytorun(FAR struct tcb_s *btcb)
    */
 
   me = this_cpu();
-  if ((sched_islocked_global() || irq_cpu_locked(me)) &&
+  if ((sched_islocked_global() || irq_cpu_locked(me) ||
+       (task_state == TSTATE_TASK_RUNNING && sched_islocked_cpu(cpu))) &&
       task_state != TSTATE_TASK_ASSIGNED)
     {
       /* Add the new ready-to-run task to the g_pendingtasks task list for
-       * now.
+       * now.  If it was held back by the pre-emption lock of the selected
+       * CPU, then that CPU releases it in sched_unlock().
        */
 
       sched_addprioritized(btcb, (FAR dq_queue_t *)&g_pendingtasks);
@@ -278,6 +286,22 @@ bool sched_addreadytorun(FAR struct tcb_s *btcb)
           sched_tasklist_unlock(lock);
           DEBUGVERIFY(up_cpu_pause(cpu));
           lock = sched_tasklist_lock();
+
+          /* That CPU may have disabled pre-emption before it was paused.
+           * sched_lock() does not take any global lock, so check again now
+           * that the CPU is stopped.
+           */
+
+          if (task_state == TSTATE_TASK_RUNNING && sched_islocked_cpu(cpu))
+            {
+              DEBUGVERIFY(up_cpu_resume(cpu));
+
+              sched_addprioritized(btcb, (FAR dq_queue_t *)&g_pendingtasks);
+              btcb->task_state = TSTATE_TASK_PENDING;
+
+              sched_tasklist_unlock(lock);
+              return false;
+            }
         }
 
       /* Add the task to the list corresponding to the selected state
@@ -307,12 +331,12 @@ bool sched_addreadytorun(FAR struct tcb_s *btcb)
           btcb->cpu        = cpu;
           btcb->task_state = TSTATE_TASK_RUNNING;
 
-          /* Adjust global pre-emption controls.  If the lockcount is
-           * greater than zero, then this task/this CPU holds the scheduler
-           * lock.
+          /* Adjust global pre-emption controls.  If the glockcount is
+           * greater than zero, then this task/this CPU holds the global
+           * scheduler lock.
            */
 
-          if (btcb->lockcount > 0)
+          if (btcb->glockcount > 0)
             {
               spin_setbit(&g_cpu_lockset, cpu, &g_cpu_locksetlock,
                           &g_cpu_schedlock);
@@ -382,26 +406,42 @@ bool sched_addreadytorun(FAR struct tcb_s *btcb)
             {
               /* Remove the task from the assigned task list */
 
-              dq_rem((FAR dq_entry_t *)next, tasklist);
+              sched_removeprioritized(next, tasklist);
 
-              /* Add the task to the g_readytorun or to the g_pendingtasks
-               * list.  NOTE: That the above operations may cause the
-               * scheduler to become locked.  It may be assigned to a
-               * different CPU the next time that it runs.
+#ifdef CONFIG_SMP_LOADBALANCE
+              /* If the task was running on another, paused CPU, then its
+               * context has already been saved.  Place it like a task that
+               * is being started once this CPU is done with this list.
+               * Another CPU may be idle or running a lower priority task.
                */
 
-              if (sched_islocked_global())
+              if (cpu != me)
                 {
-                  next->task_state = TSTATE_TASK_PENDING;
-                  tasklist         = (FAR dq_queue_t *)&g_pendingtasks;
+                  next->task_state = TSTATE_TASK_INVALID;
+                  pushtcb          = next;
                 }
               else
+#endif
                 {
-                  next->task_state = TSTATE_TASK_READYTORUN;
-                  tasklist         = (FAR dq_queue_t *)&g_readytorun;
+                  /* Add the task to the g_readytorun or to the
+                   * g_pendingtasks list.  NOTE: That the above operations
+                   * may cause the scheduler to become locked.  It may be
+                   * assigned to a different CPU the next time that it runs.
+                   */
+
+                  if (sched_islocked_global())
+                    {
+                      next->task_state = TSTATE_TASK_PENDING;
+                      tasklist         = (FAR dq_queue_t *)&g_pendingtasks;
+                    }
+                  else
+                    {
+                      next->task_state = TSTATE_TASK_READYTORUN;
+                      tasklist         = (FAR dq_queue_t *)&g_readytorun;
+                    }
+
+                  sched_addprioritized(next, tasklist);
                 }
-
-              sched_addprioritized(next, tasklist);
             }
 
           doswitch = true;
@@ -435,6 +475,18 @@ bool sched_addreadytorun(FAR struct tcb_s *btcb)
   /* Unlock the tasklists */
 
   sched_tasklist_unlock(lock);
+
+#ifdef CONFIG_SMP_LOADBALANCE
+  /* Now place the task that was preempted, if any.  This may in turn
+   * preempt a lower priority task on this CPU.
+   */
+
+  if (pushtcb != NULL)
+    {
+      doswitch |= sched_addreadytorun(pushtcb);
+    }
+#endif
+
   return doswitch;
 }
 
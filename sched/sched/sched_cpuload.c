@@ -42,6 +42,7 @@
 #include <errno.h>
 #include <assert.h>
 
+#include <nuttx/arch.h>
 #include <nuttx/clock.h>
 #include <nuttx/irq.h>
 
@@ -68,10 +69,11 @@
 
 /* When g_cpuload_total exceeds the following time constant, the load and
  * the counts will be scaled back by two.  In the CONFIG_SMP, g_cpuload_total
- * will be incremented multiple times per tick.
+ * will be incremented multiple times per tick.  With the cycle accounting,
+ * the time constant is compared with the number of sample intervals.
  */
 
-#ifdef CONFIG_SMP
+#if defined(CONFIG_SMP) && !defined(CONFIG_SCHED_CPULOAD_CYCLES)
 #  define CPULOAD_TIMECONSTANT \
      (CONFIG_SMP_NCPUS * \
       CONFIG_SCHED_CPULOAD_TIMECONSTANT * \
@@ -82,10 +84,56 @@
       CPULOAD_TICKSPERSEC)
 #endif
 
+/* With the cycle accounting, the counts are also scaled back as soon as
+ * the time accounted on all CPUs exceeds this value so that the 32-bit
+ * counts cannot overflow.
+ */
+
+#define CPULOAD_CYCLES_MAX (UINT32_MAX / 2)
+
+#ifdef CONFIG_SMP
+#  define CPULOAD_NCPUS CONFIG_SMP_NCPUS
+#else
+#  define CPULOAD_NCPUS 1
+#endif
+
+/****************************************************************************
+ * Private Types
+ ****************************************************************************/
+
+/* This structure holds the cycle accounting state of one CPU.  It is only
+ * modified by its own CPU with interrupts disabled, except when the counts
+ * are scaled back.
+ */
+
+#ifdef CONFIG_SCHED_CPULOAD_CYCLES
+struct cpuload_cycles_s
+{
+  uint32_t start;              /* Time of the last accounting point */
+  uint32_t total;              /* Time accounted on this CPU */
+  uint32_t irq;                /* Time spent in interrupt handlers */
+  uint8_t nest;                /* Interrupt handler nesting level */
+};
+#endif
+
 /****************************************************************************
  * Private Data
  ****************************************************************************/
 
+#ifdef CONFIG_SCHED_CPULOAD_CYCLES
+/* The cycle accounting state of each CPU */
+
+static struct cpuload_cycles_s g_cpuload_cycles[CPULOAD_NCPUS];
+
+/* The number of sample intervals since the counts were last scaled back */
+
+static uint32_t g_cpuload_nticks;
+#endif
+
+/****************************************************************************
+ * Public Data
+ ****************************************************************************/
+
 /* This is the total number of clock tick counts.  Essentially the
  * 'denominator' for all CPU load calculations.
  *
@@ -147,6 +195,92 @@ static inline void nxsched_cpu_process_cpuload(int cpu)
   g_cpuload_total++;
 }
 
+/****************************************************************************
+ * Name: nxsched_cpuload_elapsed
+ *
+ * Description:
+ *   Return the time since the last accounting point of a CPU and start a
+ *   new accounting interval.
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_SCHED_CPULOAD_CYCLES
+static inline uint32_t
+nxsched_cpuload_elapsed(FAR struct cpuload_cycles_s *cycles)
+{
+  uint32_t now     = up_critmon_gettime();
+  uint32_t elapsed = now - cycles->start;
+
+  cycles->start  = now;
+  cycles->total += elapsed;
+  return elapsed;
+}
+
+/****************************************************************************
+ * Name: nxsched_cpuload_charge
+ *
+ * Description:
+ *   Add the elapsed time to the count of a thread.
+ *
+ ****************************************************************************/
+
+static inline void nxsched_cpuload_charge(FAR struct tcb_s *tcb,
+                                          uint32_t elapsed)
+{
+  int hash_index = PIDHASH(tcb->pid);
+
+  /* The thread may already have been released when it exits */
+
+  if (g_pidhash[hash_index].pid == tcb->pid)
+    {
+      g_pidhash[hash_index].ticks += elapsed;
+    }
+}
+
+/****************************************************************************
+ * Name: nxsched_cpuload_cycles
+ *
+ * Description:
+ *   Scale the counts back when the time constant has elapsed or when the
+ *   time accounted on all CPUs becomes too large.
+ *
+ * Assumptions/Limitations:
+ *   Called from the timer interrupt handler with interrupts disabled.  In
+ *   the SMP configuration, the other CPUs may account time concurrently.
+ *   Such a count may escape being scaled back once, which is an error of
+ *   at most one accounting interval.
+ *
+ ****************************************************************************/
+
+static void nxsched_cpuload_cycles(void)
+{
+  uint32_t total = 0;
+  int i;
+
+  for (i = 0; i < CPULOAD_NCPUS; i++)
+    {
+      total += g_cpuload_cycles[i].total;
+    }
+
+  if (++g_cpuload_nticks > CPULOAD_TIMECONSTANT ||
+      total > CPULOAD_CYCLES_MAX)
+    {
+      for (i = 0; i < CONFIG_MAX_TASKS; i++)
+        {
+          g_pidhash[i].ticks >>= 1;
+        }
+
+      for (i = 0; i < CPULOAD_NCPUS; i++)
+        {
+          g_cpuload_cycles[i].total >>= 1;
+          g_cpuload_cycles[i].irq   >>= 1;
+        }
+
+      g_cpuload_nticks = 0;
+    }
+}
+#endif /* CONFIG_SCHED_CPULOAD_CYCLES */
+
 /****************************************************************************
  * Public Functions
  ****************************************************************************/
@@ -174,6 +308,21 @@ static inline void nxsched_cpu_process_cpuload(int cpu)
 
 void weak_function nxsched_process_cpuload(void)
 {
+#ifdef CONFIG_SCHED_CPULOAD_CYCLES
+  /* The time has already been charged at the context switches and the
+   * interrupts.  The sample interval only drives the time constant.
+   */
+
+#ifdef CONFIG_SMP
+  irqstate_t flags = enter_critical_section();
+#endif
+
+  nxsched_cpuload_cycles();
+
+#ifdef CONFIG_SMP
+  leave_critical_section(flags);
+#endif
+#else
   int i;
 
 #ifdef CONFIG_SMP
@@ -220,7 +369,80 @@ void weak_function nxsched_process_cpuload(void)
 #ifdef CONFIG_SMP
   leave_critical_section(flags);
 #endif
+#endif /* CONFIG_SCHED_CPULOAD_CYCLES */
+}
+
+/****************************************************************************
+ * Name: sched_cpuload_suspend
+ *
+ * Description:
+ *   Charge the time since the last accounting point to a thread that is
+ *   being suspended.
+ *
+ * Input Parameters:
+ *   tcb - The TCB of the thread that is being suspended.
+ *
+ * Returned Value:
+ *   None
+ *
+ * Assumptions/Limitations:
+ *   Called with interrupts disabled on the CPU that ran the thread.
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_SCHED_CPULOAD_CYCLES
+void sched_cpuload_suspend(FAR struct tcb_s *tcb)
+{
+  FAR struct cpuload_cycles_s *cycles = &g_cpuload_cycles[this_cpu()];
+
+  /* A context switch performed by an interrupt handler is accounted as
+   * interrupt time when the handler returns.
+   */
+
+  if (cycles->nest == 0)
+    {
+      nxsched_cpuload_charge(tcb, nxsched_cpuload_elapsed(cycles));
+    }
+}
+
+/****************************************************************************
+ * Name: sched_cpuload_irqenter and sched_cpuload_irqleave
+ *
+ * Description:
+ *   Called by irq_dispatch() before and after the interrupt handler.  The
+ *   time before the handler is charged to the interrupted thread (or to
+ *   the interrupted handler if interrupts are nested), the time in the
+ *   handler is charged to the interrupts of the CPU.
+ *
+ * Assumptions/Limitations:
+ *   Called from interrupt handling logic with interrupts disabled.
+ *
+ ****************************************************************************/
+
+void sched_cpuload_irqenter(void)
+{
+  int cpu = this_cpu();
+  FAR struct cpuload_cycles_s *cycles = &g_cpuload_cycles[cpu];
+  uint32_t elapsed = nxsched_cpuload_elapsed(cycles);
+
+  if (cycles->nest++ > 0)
+    {
+      cycles->irq += elapsed;
+    }
+  else
+    {
+      nxsched_cpuload_charge(current_task(cpu), elapsed);
+    }
+}
+
+void sched_cpuload_irqleave(void)
+{
+  FAR struct cpuload_cycles_s *cycles = &g_cpuload_cycles[this_cpu()];
+
+  cycles->irq += nxsched_cpuload_elapsed(cycles);
+  cycles->nest--;
 }
+#endif /* CONFIG_SCHED_CPULOAD_CYCLES */
 
 /****************************************************************************
  * Name:  clock_cpuload
@@ -271,7 +493,19 @@ int clock_cpuload(int pid, FAR struct cpuload_s *cpuload)
 
   if (g_pidhash[hash_index].tcb && g_pidhash[hash_index].pid == pid)
     {
+#ifdef CONFIG_SCHED_CPULOAD_CYCLES
+      int i;
+
+      /* The total is the time accounted on all CPUs */
+
+      cpuload->total = 0;
+      for (i = 0; i < CPULOAD_NCPUS; i++)
+        {
+          cpuload->total += g_cpuload_cycles[i].total;
+        }
+#else
       cpuload->total  = g_cpuload_total;
+#endif
       cpuload->active = g_pidhash[hash_index].ticks;
       ret = OK;
     }
@@ -280,4 +514,44 @@ int clock_cpuload(int pid, FAR struct cpuload_s *cpuload)
   return ret;
 }
 
+/****************************************************************************
+ * Name:  clock_cpuload_cpu
+ *
+ * Description:
+ *   Return the cycle accounting of one CPU.
+ *
+ * Input Parameters:
+ *   cpu - The index of the CPU of interest.
+ *   cpuload - The location to return the CPU load
+ *
+ * Returned Value:
+ *   OK (0) on success; -EINVAL if 'cpu' is not a valid CPU index.
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_SCHED_CPULOAD_CYCLES
+int clock_cpuload_cpu(int cpu, FAR struct cpuload_cpu_s *cpuload)
+{
+  irqstate_t flags;
+
+  DEBUGASSERT(cpuload);
+
+  if (cpu < 0 || cpu >= CPULOAD_NCPUS)
+    {
+      return -EINVAL;
+    }
+
+  /* The IDLE thread of each CPU has the PID that is equal to the CPU
+   * index.
+   */
+
+  flags = enter_critical_section();
+  cpuload->total = g_cpuload_cycles[cpu].total;
+  cpuload->irq   = g_cpuload_cycles[cpu].irq;
+  cpuload->idle  = g_pidhash[PIDHASH(cpu)].ticks;
+  leave_critical_section(flags);
+  return OK;
+}
+#endif
+
 #endif /* CONFIG_SCHED_CPULOAD */
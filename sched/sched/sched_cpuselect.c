@@ -63,10 +63,19 @@
  *
  * Description:
  *   Return the index to the CPU with the lowest priority running task,
- *   possbily its IDLE task.
+ *   possbily its IDLE task.  If several CPUs qualify, the 'prefer' CPU is
+ *   selected so that a thread returns to the CPU whose cache may still
+ *   hold its working set.
+ *
+ *   CPUs with pre-emption disabled are passed over unless one of them runs
+ *   a task of lower priority than any other CPU.  A thread that would
+ *   pre-empt such a CPU is then deferred until the CPU re-enables
+ *   pre-emption, instead of starting on a CPU running a higher priority
+ *   task.
  *
  * Input Parameters:
  *   affinity - The set of CPUs on which the thread is permitted to run.
+ *   prefer   - The CPU that the thread last ran on.
  *
  * Returned Value:
  *   Index of the CPU with the lowest priority running task
@@ -76,9 +85,11 @@
  *
  ****************************************************************************/
 
-int sched_cpu_select(cpu_set_t affinity)
+int sched_cpu_select(cpu_set_t affinity, int prefer)
 {
-  uint8_t minprio;
+  int lockedprio;
+  int lockedcpu;
+  int minprio;
   int cpu;
   int i;
 
@@ -86,8 +97,10 @@ int sched_cpu_select(cpu_set_t affinity)
    * (possibly its IDLE task).
    */
 
-  minprio = SCHED_PRIORITY_MAX;
-  cpu     = IMPOSSIBLE_CPU;
+  minprio    = SCHED_PRIORITY_MAX + 1;
+  cpu        = IMPOSSIBLE_CPU;
+  lockedprio = SCHED_PRIORITY_MAX + 1;
+  lockedcpu  = IMPOSSIBLE_CPU;
 
   for (i = 0; i < CONFIG_SMP_NCPUS; i++)
     {
@@ -97,28 +110,38 @@ int sched_cpu_select(cpu_set_t affinity)
         {
           FAR struct tcb_s *rtcb = (FAR struct tcb_s *)g_assignedtasks[i].head;
 
-          /* If this thread is executing its IDLE task, the use it.  The
-           * IDLE task is always the last task in the assigned task list.
+          /* The IDLE task is always the last task in the assigned task
+           * list.  It should always be assigned to this CPU and have a
+           * priority of zero.
            */
 
-          if (rtcb->flink == NULL)
-            {
-              /* The IDLE task should always be assigned to this CPU and have
-               * a priority of zero.
-               */
+          DEBUGASSERT(rtcb->flink != NULL || rtcb->sched_priority == 0);
 
-              DEBUGASSERT(rtcb->sched_priority == 0);
-              return i;
+          if (rtcb->lockcount > 0)
+            {
+              /* Pre-emption is disabled on this CPU */
+
+              if (rtcb->sched_priority < lockedprio ||
+                  (rtcb->sched_priority == lockedprio && i == prefer))
+                {
+                  lockedprio = rtcb->sched_priority;
+                  lockedcpu  = i;
+                }
             }
-          else if (rtcb->sched_priority < minprio)
+          else if (rtcb->sched_priority < minprio ||
+                   (rtcb->sched_priority == minprio && i == prefer))
             {
-              DEBUGASSERT(rtcb->sched_priority > 0);
               minprio = rtcb->sched_priority;
               cpu = i;
             }
         }
     }
 
+  if (lockedprio < minprio)
+    {
+      cpu = lockedcpu;
+    }
+
   DEBUGASSERT(cpu != IMPOSSIBLE_CPU);
   return cpu;
 }
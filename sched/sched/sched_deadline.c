@@ -0,0 +1,417 @@
+/****************************************************************************
+ * sched/sched/sched_deadline.c
+ *
+ *   Copyright (C) 2020 Gregory Nutt. All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in
+ *    the documentation and/or other materials provided with the
+ *    distribution.
+ * 3. Neither the name NuttX nor the names of its contributors may be
+ *    used to endorse or promote products derived from this software
+ *    without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+ * FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE
+ * COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+ * INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,
+ * BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS
+ * OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED
+ * AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ * LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN
+ * ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ *
+ ****************************************************************************/
+
+/****************************************************************************
+ * Included Files
+ ****************************************************************************/
+
+#include <nuttx/config.h>
+
+#include <stdint.h>
+#include <stdbool.h>
+#include <sched.h>
+#include <assert.h>
+#include <errno.h>
+
+#include <nuttx/sched.h>
+#include <nuttx/arch.h>
+#include <nuttx/clock.h>
+
+#include "clock/clock.h"
+#include "sched/sched.h"
+
+#ifdef CONFIG_SCHED_DEADLINE
+
+/****************************************************************************
+ * Pre-processor Definitions
+ ****************************************************************************/
+
+#ifndef MIN
+#  define MIN(a,b) (((a) < (b)) ? (a) : (b))
+#endif
+
+/* Bandwidth is represented in parts per million of one CPU */
+
+#define DEADLINE_UTIL_ONE  1000000
+
+#ifdef CONFIG_SMP
+#  define DEADLINE_NCPUS   CONFIG_SMP_NCPUS
+#else
+#  define DEADLINE_NCPUS   1
+#endif
+
+#define DEADLINE_UTIL_MAX \
+  ((uint32_t)CONFIG_SCHED_DEADLINE_MAXUTIL * (DEADLINE_UTIL_ONE / 100) * \
+   DEADLINE_NCPUS)
+
+/****************************************************************************
+ * Private Data
+ ****************************************************************************/
+
+/* This is the total bandwidth of all admitted SCHED_DEADLINE threads */
+
+static uint32_t g_deadline_util;
+
+/****************************************************************************
+ * Private Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: deadline_util
+ *
+ * Description:
+ *   Return the ratio runtime/period in DEADLINE_UTIL_ONE units, rounded up
+ *   so that admission control errs on the safe side.
+ *
+ * Input Parameters:
+ *   runtime - The execution time in ticks.  Must not exceed period.
+ *   period  - The period in ticks.  Must be non-zero.
+ *
+ * Returned Value:
+ *   The bandwidth in parts per million.
+ *
+ ****************************************************************************/
+
+static uint32_t deadline_util(uint32_t runtime, uint32_t period)
+{
+#ifdef CONFIG_HAVE_LONG_LONG
+  return (uint32_t)(((uint64_t)runtime * DEADLINE_UTIL_ONE + period - 1) /
+                    period);
+#else
+  /* Scale both values down until the product cannot overflow */
+
+  while (runtime > UINT32_MAX / DEADLINE_UTIL_ONE)
+    {
+      runtime >>= 1;
+      period  >>= 1;
+    }
+
+  return (runtime * DEADLINE_UTIL_ONE + period - 1) / period;
+#endif
+}
+
+/****************************************************************************
+ * Public Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: sched_deadline_admit
+ *
+ * Description:
+ *   Validate the SCHED_DEADLINE parameters, perform admission control and,
+ *   if the reservation is accepted, start its first period now.  If the
+ *   thread already uses SCHED_DEADLINE, its current reservation is replaced.
+ *   The caller is responsible for setting the TCB scheduling policy.
+ *
+ * Input Parameters:
+ *   tcb   - TCB of the thread
+ *   param - The requested sched_dl_runtime, sched_dl_deadline and
+ *           sched_dl_period.  A zero period is the same as the deadline.
+ *
+ * Returned Value:
+ *   Zero (OK) on success or a negated errno value on failure:
+ *
+ *   EINVAL - The parameters do not satisfy
+ *            0 < runtime <= deadline <= period
+ *   EBUSY  - The reservation would exceed CONFIG_SCHED_DEADLINE_MAXUTIL
+ *
+ * Assumptions:
+ *   Called within a critical section.
+ *
+ ****************************************************************************/
+
+int sched_deadline_admit(FAR struct tcb_s *tcb,
+                         FAR const struct sched_param *param)
+{
+  FAR struct deadline_s *dl;
+  sclock_t runtime;
+  sclock_t deadline;
+  sclock_t period;
+  uint32_t oldutil = 0;
+  uint32_t util;
+
+  DEBUGASSERT(tcb != NULL && param != NULL);
+  dl = &tcb->deadline;
+
+  /* Convert timespec values to system clock ticks */
+
+  clock_time2ticks(&param->sched_dl_runtime, &runtime);
+  clock_time2ticks(&param->sched_dl_deadline, &deadline);
+  clock_time2ticks(&param->sched_dl_period, &period);
+
+  if (period <= 0)
+    {
+      period = deadline;
+    }
+
+  if (runtime < 1 || deadline < runtime || period < deadline ||
+      period > INT32_MAX)
+    {
+      return -EINVAL;
+    }
+
+  /* Admission control:  The new total bandwidth must not exceed the limit.
+   * The bandwidth of any reservation being replaced is given back first.
+   */
+
+  util = deadline_util((uint32_t)runtime, (uint32_t)period);
+  if ((tcb->flags & TCB_FLAG_POLICY_MASK) == TCB_FLAG_SCHED_DEADLINE)
+    {
+      oldutil = dl->util;
+    }
+
+  if (g_deadline_util - oldutil + util > DEADLINE_UTIL_MAX)
+    {
+      return -EBUSY;
+    }
+
+  g_deadline_util = g_deadline_util - oldutil + util;
+
+  /* Save the reservation and start the first period now */
+
+  dl->runtime     = (uint32_t)runtime;
+  dl->deadline    = (uint32_t)deadline;
+  dl->period      = (uint32_t)period;
+  dl->util        = util;
+  dl->absdeadline = clock_systimer() + dl->deadline;
+  tcb->timeslice  = dl->runtime;
+
+  return OK;
+}
+
+/****************************************************************************
+ * Name: sched_deadline_stop
+ *
+ * Description:
+ *   Release the bandwidth reserved by a SCHED_DEADLINE thread.  Called when
+ *   the thread changes to another policy or exits.
+ *
+ * Input Parameters:
+ *   tcb - TCB of the thread
+ *
+ * Returned Value:
+ *   None
+ *
+ * Assumptions:
+ *   Called within a critical section.
+ *
+ ****************************************************************************/
+
+void sched_deadline_stop(FAR struct tcb_s *tcb)
+{
+  DEBUGASSERT(tcb != NULL && g_deadline_util >= tcb->deadline.util);
+
+  g_deadline_util    -= tcb->deadline.util;
+  tcb->deadline.util  = 0;
+}
+
+/****************************************************************************
+ * Name: sched_deadline_wakeup
+ *
+ * Description:
+ *   Called when a SCHED_DEADLINE thread becomes ready to run.  If the
+ *   remaining budget could not be consumed before the current deadline
+ *   without exceeding the reserved bandwidth (or the deadline has already
+ *   passed), a new period is started now.  This is the wake-up rule of a
+ *   constant bandwidth server and is what makes a periodic thread that
+ *   sleeps until its next activation receive a fresh deadline.
+ *
+ * Input Parameters:
+ *   tcb - TCB of the thread that is being unblocked
+ *
+ * Returned Value:
+ *   None
+ *
+ * Assumptions:
+ *   Called within a critical section before the TCB is added to the
+ *   ready-to-run list.
+ *
+ ****************************************************************************/
+
+void sched_deadline_wakeup(FAR struct tcb_s *tcb)
+{
+  FAR struct deadline_s *dl = &tcb->deadline;
+  clock_t now = clock_systimer();
+  sclock_t left;
+
+  /* The budget may have been exhausted while pre-emption was locked */
+
+  if (tcb->timeslice <= 0)
+    {
+      dl->absdeadline += dl->period;
+      tcb->timeslice   = dl->runtime;
+    }
+
+  left = (sclock_t)(dl->absdeadline - now);
+  if (left <= 0 || tcb->timeslice > left ||
+      deadline_util(tcb->timeslice, (uint32_t)left) > dl->util)
+    {
+      dl->absdeadline = now + dl->deadline;
+      tcb->timeslice  = dl->runtime;
+    }
+}
+
+/****************************************************************************
+ * Name: sched_deadline_replenish
+ *
+ * Description:
+ *   The SCHED_DEADLINE thread has exhausted the budget of its current
+ *   period.  Replenish the budget and postpone the deadline by one period
+ *   so that the thread cannot consume bandwidth reserved by other threads,
+ *   then re-sort the thread among the ready threads of its priority.
+ *
+ * Input Parameters:
+ *   tcb - TCB of the thread
+ *
+ * Returned Value:
+ *   None
+ *
+ * Assumptions:
+ *   Interrupts are disabled; pre-emption is not locked.
+ *
+ ****************************************************************************/
+
+void sched_deadline_replenish(FAR struct tcb_s *tcb)
+{
+  FAR struct deadline_s *dl = &tcb->deadline;
+
+  dl->absdeadline += dl->period;
+  tcb->timeslice   = dl->runtime;
+
+  /* Resetting the priority to its current value re-inserts the thread
+   * into the ready-to-run list according to its new deadline.
+   */
+
+  if (tcb->task_state >= FIRST_READY_TO_RUN_STATE &&
+      tcb->task_state <= LAST_READY_TO_RUN_STATE &&
+      tcb->flink != NULL &&
+      tcb->flink->sched_priority >= tcb->sched_priority)
+    {
+      up_reprioritize_rtr(tcb, tcb->sched_priority);
+    }
+}
+
+/****************************************************************************
+ * Name: sched_deadline_process
+ *
+ * Description:
+ *   Charge the elapsed time to the budget of the currently executing
+ *   SCHED_DEADLINE thread and handle budget exhaustion.
+ *
+ * Input Parameters:
+ *   tcb - The TCB of the currently executing task
+ *   ticks - The number of ticks that have elapsed on the interval timer.
+ *   noswitches - True: Can't do context switches now.
+ *
+ * Returned Value:
+ *   The number of ticks remaining until the budget is exhausted.  Zero is
+ *   returned if the budget is exhausted but pre-emption is locked; the
+ *   deadline is then postponed by sched_unlock().  The value one is
+ *   returned if a context switch may be needed now but cannot be performed
+ *   because noswitches == true.
+ *
+ * Assumptions:
+ *   - Interrupts are disabled
+ *   - The task associated with TCB uses the SCHED_DEADLINE policy
+ *
+ ****************************************************************************/
+
+uint32_t sched_deadline_process(FAR struct tcb_s *tcb, uint32_t ticks,
+                                bool noswitches)
+{
+  int decr;
+
+  DEBUGASSERT(tcb != NULL);
+
+  /* Charge the elapsed time to the budget.  Any excess is ignored */
+
+  if (tcb->timeslice > 0)
+    {
+      decr = MIN(tcb->timeslice, ticks);
+      tcb->timeslice -= decr;
+    }
+
+  if (tcb->timeslice > 0 || sched_islocked_tcb(tcb))
+    {
+      return tcb->timeslice > 0 ? tcb->timeslice : 0;
+    }
+
+  if (noswitches)
+    {
+      return 1;
+    }
+
+  sched_deadline_replenish(tcb);
+  return tcb->deadline.runtime;
+}
+
+/****************************************************************************
+ * Name: sched_deadline_getparam
+ *
+ * Description:
+ *   Return the SCHED_DEADLINE parameters of a thread.  These are zero if
+ *   the thread does not use the SCHED_DEADLINE policy.
+ *
+ * Input Parameters:
+ *   tcb   - TCB of the thread
+ *   param - Location to return the parameters
+ *
+ * Returned Value:
+ *   None
+ *
+ ****************************************************************************/
+
+void sched_deadline_getparam(FAR struct tcb_s *tcb,
+                             FAR struct sched_param *param)
+{
+  FAR struct deadline_s *dl = &tcb->deadline;
+
+  if ((tcb->flags & TCB_FLAG_POLICY_MASK) == TCB_FLAG_SCHED_DEADLINE)
+    {
+      clock_ticks2time((sclock_t)dl->runtime, &param->sched_dl_runtime);
+      clock_ticks2time((sclock_t)dl->deadline, &param->sched_dl_deadline);
+      clock_ticks2time((sclock_t)dl->period, &param->sched_dl_period);
+    }
+  else
+    {
+      param->sched_dl_runtime.tv_sec   = 0;
+      param->sched_dl_runtime.tv_nsec  = 0;
+      param->sched_dl_deadline.tv_sec  = 0;
+      param->sched_dl_deadline.tv_nsec = 0;
+      param->sched_dl_period.tv_sec    = 0;
+      param->sched_dl_period.tv_nsec   = 0;
+    }
+}
+
+#endif /* CONFIG_SCHED_DEADLINE */
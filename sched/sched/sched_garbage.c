@@ -202,6 +202,28 @@ static inline bool nxsched_have_kgarbage(void)
 #  define nxsched_have_kgarbage() false
 #endif
 
+/****************************************************************************
+ * Name: nxsched_compact
+ *
+ * Description:
+ *   Perform one incremental step of compaction of the user heap.
+ *
+ * Input Parameters:
+ *   None
+ *
+ * Returned Value:
+ *   None
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_MM_MOVABLE
+#  define nxsched_compact()      umm_compact(CONFIG_MM_COMPACT_STEP)
+#  define nxsched_have_compact() umm_needcompact()
+#else
+#  define nxsched_compact()
+#  define nxsched_have_compact() false
+#endif
+
 /****************************************************************************
  * Public Functions
  ****************************************************************************/
@@ -238,6 +260,10 @@ void sched_garbage_collection(void)
 
   nxsched_kucleanup();
 
+  /* Then move movable allocations to reduce fragmentation */
+
+  nxsched_compact();
+
   /* Handle the architecure-specific garbage collection */
 
   up_sched_garbage_collection();
@@ -269,5 +295,5 @@ void sched_garbage_collection(void)
 bool sched_have_garbage(void)
 {
   return (nxsched_have_kgarbage() || nxsched_have_kugarbage() ||
-          up_sched_have_garbage());
+          nxsched_have_compact() || up_sched_have_garbage());
 }
@@ -99,6 +99,10 @@ int nxsched_getparam (pid_t pid, FAR struct sched_param *param)
       /* Return the priority if the calling task. */
 
       param->sched_priority = (int)rtcb->sched_priority;
+
+#ifdef CONFIG_SCHED_DEADLINE
+      sched_deadline_getparam(rtcb, param);
+#endif
     }
 
   /* This PID is not for the calling task, we will have to look it up */
@@ -149,6 +153,12 @@ int nxsched_getparam (pid_t pid, FAR struct sched_param *param)
               param->sched_ss_init_budget.tv_nsec = 0;
             }
 #endif
+
+#ifdef CONFIG_SCHED_DEADLINE
+          /* Return parameters associated with SCHED_DEADLINE */
+
+          sched_deadline_getparam(tcb, param);
+#endif
         }
 
       sched_unlock();
@@ -0,0 +1,293 @@
+/****************************************************************************
+ * sched/sched/sched_latency.c
+ *
+ *   Copyright (C) 2020 Gregory Nutt. All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in
+ *    the documentation and/or other materials provided with the
+ *    distribution.
+ * 3. Neither the name NuttX nor the names of its contributors may be
+ *    used to endorse or promote products derived from this software
+ *    without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+ * FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE
+ * COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+ * INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,
+ * BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS
+ * OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED
+ * AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ * LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN
+ * ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ *
+ ****************************************************************************/
+
+/****************************************************************************
+ * Included Files
+ ****************************************************************************/
+
+#include <nuttx/config.h>
+
+#include <sys/types.h>
+#include <stdbool.h>
+#include <string.h>
+#include <strings.h>
+#include <sched.h>
+#include <time.h>
+
+#include <nuttx/arch.h>
+#include <nuttx/clock.h>
+#include <nuttx/irq.h>
+
+#include "sched/sched.h"
+
+#ifdef CONFIG_SCHED_LATENCY
+
+/****************************************************************************
+ * Public Data
+ ****************************************************************************/
+
+/* Latency histograms for each priority group and wake-up source */
+
+struct latency_hist_s g_latency_hist[LATENCY_NGROUPS][LATENCY_NSOURCES];
+
+/* The state of the latency threshold trigger */
+
+struct latency_trigger_s g_latency_trigger;
+
+/****************************************************************************
+ * Private Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: sched_latency_record
+ *
+ * Description:
+ *   Add one latency sample to a histogram.
+ *
+ ****************************************************************************/
+
+static inline void sched_latency_record(FAR struct latency_hist_s *hist,
+                                        uint32_t elapsed)
+{
+  int ndx = fls((int)elapsed) - 1;
+
+  /* fls() returns zero for zero and 32 if the MS bit is set */
+
+  hist->bucket[ndx < 0 ? 0 : ndx]++;
+  hist->count++;
+
+  if (elapsed > hist->max)
+    {
+      hist->max = elapsed;
+    }
+}
+
+/****************************************************************************
+ * Name: sched_latency_clear
+ *
+ * Description:
+ *   sched_foreach() callback that clears the latency histogram of a thread.
+ *
+ ****************************************************************************/
+
+static void sched_latency_clear(FAR struct tcb_s *tcb, FAR void *arg)
+{
+  memset(&tcb->lat_hist, 0, sizeof(struct latency_hist_s));
+}
+
+/****************************************************************************
+ * Public Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: sched_latency_wakeup
+ *
+ * Description:
+ *   Called just before a blocked thread is made ready-to-run.  Saves the
+ *   wake-up time and whether the thread was woken from an interrupt handler
+ *   or by another task.
+ *
+ * Assumptions:
+ *   - Called within a critical section.
+ *   - Might be called from an interrupt handler
+ *
+ ****************************************************************************/
+
+void sched_latency_wakeup(FAR struct tcb_s *tcb)
+{
+  /* Zero means that the timer is not ready.  Nothing will be recorded in
+   * that case.
+   */
+
+  tcb->lat_start  = up_critmon_gettime();
+  tcb->lat_source = up_interrupt_context() ? LATENCY_SOURCE_IRQ :
+                                             LATENCY_SOURCE_TASK;
+}
+
+/****************************************************************************
+ * Name: sched_latency_resume
+ *
+ * Description:
+ *   Called when a thread resumes execution.  If the thread was woken up,
+ *   records the time from the wake-up until now in the latency histograms.
+ *
+ * Assumptions:
+ *   - Called within a critical section.
+ *   - Might be called from an interrupt handler
+ *
+ ****************************************************************************/
+
+void sched_latency_resume(FAR struct tcb_s *tcb)
+{
+  FAR struct latency_trigger_s *trigger = &g_latency_trigger;
+  uint32_t elapsed;
+  int group;
+
+  if (tcb->lat_start == 0)
+    {
+      /* The thread was pre-empted, not woken up */
+
+      return;
+    }
+
+  elapsed        = up_critmon_gettime() - tcb->lat_start;
+  tcb->lat_start = 0;
+
+  if (trigger->stopped)
+    {
+      return;
+    }
+
+  /* Add the sample to the thread's histogram and to the histogram of its
+   * priority group.
+   */
+
+  group = tcb->sched_priority / CONFIG_SCHED_LATENCY_PRIOGROUP;
+
+  sched_latency_record(&tcb->lat_hist, elapsed);
+  sched_latency_record(&g_latency_hist[group][tcb->lat_source], elapsed);
+
+  /* Check the threshold trigger */
+
+  if (trigger->threshold != 0 && elapsed > trigger->threshold)
+    {
+      trigger->priority = tcb->sched_priority;
+      trigger->pid      = tcb->pid;
+      trigger->latency  = elapsed;
+      trigger->count++;
+
+      if (trigger->stop)
+        {
+          trigger->stopped = true;
+        }
+    }
+}
+
+/****************************************************************************
+ * Name: sched_latency_reset
+ *
+ * Description:
+ *   Clear all scheduler latency histograms, clear the threshold trigger
+ *   state, and restart tracing if it was stopped by the trigger.
+ *
+ ****************************************************************************/
+
+void sched_latency_reset(void)
+{
+  irqstate_t flags;
+
+  flags = enter_critical_section();
+
+  memset(g_latency_hist, 0, sizeof(g_latency_hist));
+  sched_foreach(sched_latency_clear, NULL);
+
+  g_latency_trigger.stopped  = false;
+  g_latency_trigger.priority = 0;
+  g_latency_trigger.pid      = 0;
+  g_latency_trigger.latency  = 0;
+  g_latency_trigger.count    = 0;
+
+  leave_critical_section(flags);
+}
+
+/****************************************************************************
+ * Name: sched_latency_threshold
+ *
+ * Description:
+ *   Set the latency threshold trigger.
+ *
+ ****************************************************************************/
+
+void sched_latency_threshold(uint32_t usec, bool stop)
+{
+  irqstate_t flags;
+  uint32_t threshold;
+  uint32_t lower;
+  uint32_t upper;
+
+  /* Nothing is assumed about the units of up_critmon_gettime(), so find
+   * the largest elapsed time that does not exceed usec by bisection.
+   */
+
+  threshold = 0;
+  if (usec > 0)
+    {
+      lower = 0;
+      upper = UINT32_MAX;
+
+      while (lower < upper)
+        {
+          uint32_t mid = lower + (upper - lower) / 2 + 1;
+
+          if (sched_latency_usec(mid) <= usec)
+            {
+              lower = mid;
+            }
+          else
+            {
+              upper = mid - 1;
+            }
+        }
+
+      /* A threshold of zero would disable the trigger */
+
+      threshold = lower > 0 ? lower : 1;
+    }
+
+  flags = enter_critical_section();
+  g_latency_trigger.threshold = threshold;
+  g_latency_trigger.stop      = stop;
+  g_latency_trigger.stopped   = false;
+  leave_critical_section(flags);
+}
+
+/****************************************************************************
+ * Name: sched_latency_usec
+ *
+ * Description:
+ *   Convert a latency in time units of up_critmon_gettime() into
+ *   microseconds.
+ *
+ ****************************************************************************/
+
+uint32_t sched_latency_usec(uint32_t elapsed)
+{
+  struct timespec ts;
+
+  up_critmon_convert(elapsed, &ts);
+  return (uint32_t)ts.tv_sec * USEC_PER_SEC +
+         (uint32_t)ts.tv_nsec / NSEC_PER_USEC;
+}
+
+#endif /* CONFIG_SCHED_LATENCY */
@@ -0,0 +1,166 @@
+/****************************************************************************
+ * sched/sched/sched_loadbalance.c
+ *
+ *   Copyright (C) 2020 Gregory Nutt. All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in
+ *    the documentation and/or other materials provided with the
+ *    distribution.
+ * 3. Neither the name NuttX nor the names of its contributors may be
+ *    used to endorse or promote products derived from this software
+ *    without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+ * FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE
+ * COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+ * INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,
+ * BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS
+ * OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED
+ * AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ * LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN
+ * ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ *
+ ****************************************************************************/
+
+/****************************************************************************
+ * Included Files
+ ****************************************************************************/
+
+#include <nuttx/config.h>
+
+#include <stdbool.h>
+#include <sched.h>
+#include <queue.h>
+#include <assert.h>
+
+#include <nuttx/arch.h>
+#include <nuttx/irq.h>
+#include <nuttx/spinlock.h>
+
+#include "irq/irq.h"
+#include "sched/sched.h"
+
+#ifdef CONFIG_SMP_LOADBALANCE
+
+/****************************************************************************
+ * Public Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: sched_unbalanced
+ *
+ * Description:
+ *   Find the highest priority task in the g_readytorun list that has a
+ *   higher priority than the task running on one of the CPUs in its
+ *   affinity mask.
+ *
+ * Input Parameters:
+ *   None
+ *
+ * Returned Value:
+ *   The TCB of that task or NULL if every ready-to-run task is waiting for
+ *   a CPU of its own.
+ *
+ * Assumptions:
+ *   The caller holds the tasklist lock.
+ *
+ ****************************************************************************/
+
+FAR struct tcb_s *sched_unbalanced(void)
+{
+  FAR struct tcb_s *tcb;
+  uint8_t minprio = SCHED_PRIORITY_MAX;
+  int cpu;
+
+  /* Get the lowest priority that is running on any CPU */
+
+  for (cpu = 0; cpu < CONFIG_SMP_NCPUS; cpu++)
+    {
+      if (current_task(cpu)->sched_priority < minprio)
+        {
+          minprio = current_task(cpu)->sched_priority;
+        }
+    }
+
+  /* The list is prioritized so the search can stop at the first task that
+   * would not preempt any running task.
+   */
+
+  for (tcb = (FAR struct tcb_s *)g_readytorun.head;
+       tcb != NULL && tcb->sched_priority > minprio;
+       tcb = tcb->flink)
+    {
+      cpu = sched_cpu_select(tcb->affinity, tcb->cpu);
+      if (current_task(cpu)->sched_priority < tcb->sched_priority &&
+          !sched_islocked_cpu(cpu))
+        {
+          return tcb;
+        }
+    }
+
+  return NULL;
+}
+
+/****************************************************************************
+ * Name: sched_loadbalance
+ *
+ * Description:
+ *   Start any ready-to-run task that has a higher priority than the task
+ *   running on one of the CPUs in its affinity mask.  This is called from
+ *   the IDLE tasks and, periodically, from the system timer.  A CPU may be
+ *   left idle by sched_removereadytorun() if the scheduler or the IRQ lock
+ *   was held by another CPU when its running task was suspended.
+ *
+ * Input Parameters:
+ *   None
+ *
+ * Returned Value:
+ *   None
+ *
+ ****************************************************************************/
+
+void sched_loadbalance(void)
+{
+  irqstate_t flags;
+  irqstate_t lock;
+  bool unbalanced;
+
+  /* There is nothing to do if no task is waiting for a CPU */
+
+  if (g_readytorun.head == NULL)
+    {
+      return;
+    }
+
+  flags = enter_critical_section();
+
+  if (!sched_islocked_global() && !irq_cpu_locked(this_cpu()))
+    {
+      lock       = sched_tasklist_lock();
+      unbalanced = (sched_unbalanced() != NULL);
+      sched_tasklist_unlock(lock);
+
+      /* sched_mergepending() starts the tasks.  The architecture logic
+       * performs the context switch if this CPU is one of them.
+       */
+
+      if (unbalanced)
+        {
+          up_release_pending();
+        }
+    }
+
+  leave_critical_section(flags);
+}
+
+#endif /* CONFIG_SMP_LOADBALANCE */
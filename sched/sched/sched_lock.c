@@ -78,38 +78,30 @@
  * stopping the other CPUs): Even though pre-emption is disabled, other
  * threads will still be executing on the other CPUS.
  *
- * There are additional rules for this multi-CPU case:
+ * sched_lock() therefore disables pre-emption on the calling CPU only:
  *
- * 1. There is a global lock count 'g_cpu_lockset' that includes a bit for
- *    each CPU: If the bit is '1', then the corresponding CPU has the
- *    scheduler locked; if '0', then the CPU does not have the scheduler
- *    locked.
- * 2. Scheduling logic would set the bit associated with the cpu in
- *    'g_cpu_lockset' when the TCB at the head of the g_assignedtasks[cpu]
- *    list transitions has 'lockcount' > 0. This might happen when sched_lock()
- *    is called, or after a context switch that changes the TCB at the
- *    head of the g_assignedtasks[cpu] list.
- * 3. Similarly, the cpu bit in the global 'g_cpu_lockset' would be cleared
- *    when the TCB at the head of the g_assignedtasks[cpu] list has
- *    'lockcount' == 0. This might happen when sched_unlock() is called, or
- *    after a context switch that changes the TCB at the head of the
- *    g_assignedtasks[cpu] list.
- * 4. Modification of the global 'g_cpu_lockset' must be protected by a
- *    spinlock, 'g_cpu_schedlock'. That spinlock would be taken when
- *    sched_lock() is called, and released when sched_unlock() is called.
- *    This assures that the scheduler does enforce the critical section.
- *    NOTE: Because of this spinlock, there should never be more than one
- *    bit set in 'g_cpu_lockset'; attempts to set additional bits should
- *    be cause the CPU to block on the spinlock.  However, additional bits
- *    could get set in 'g_cpu_lockset' due to the context switches on the
- *    various CPUs.
- * 5. Each the time the head of a g_assignedtasks[] list changes and the
- *    scheduler modifies 'g_cpu_lockset', it must also set 'g_cpu_schedlock'
- *    depending on the new state of 'g_cpu_lockset'.
- * 5. Logic that currently uses the currently running tasks lockcount
- *    instead uses the global 'g_cpu_schedlock'. A value of SP_UNLOCKED
- *    means that no CPU has pre-emption disabled; SP_LOCKED means that at
- *    least one CPU has pre-emption disabled.
+ * 1. Pre-emption is disabled on a CPU if the TCB at the head of its
+ *    g_assignedtasks[cpu] list has 'lockcount' > 0 (sched_islocked_cpu()).
+ *    No global state is modified and no lock is taken.
+ * 2. A task that would pre-empt the task running on such a CPU is placed
+ *    in the g_pendingtasks list instead.  The decision is deferred until
+ *    that CPU calls sched_unlock(), which releases the pending tasks.  The
+ *    other CPUs keep switching tasks as usual.
+ *
+ * sched_lock_global() keeps the system-wide semantics for the few callers
+ * that need them:  No CPU starts a new task while it is held.
+ *
+ * 3. There is a global lock set 'g_cpu_lockset' that includes a bit for
+ *    each CPU: If the bit is '1', then the task running on that CPU holds
+ *    the global lock ('glockcount' > 0).
+ * 4. Scheduling logic sets or clears the bit of a CPU when
+ *    sched_lock_global() or sched_unlock_global() changes 'glockcount'
+ *    between zero and non-zero, and each time the head of the
+ *    g_assignedtasks[cpu] list changes.
+ * 5. Modification of 'g_cpu_lockset' is protected by 'g_cpu_locksetlock'
+ *    and the spinlock 'g_cpu_schedlock' is locked whenever any bit is set.
+ *    A value of SP_UNLOCKED means that no CPU holds the global lock
+ *    (sched_islocked_global()).
  */
 
 volatile spinlock_t g_cpu_schedlock SP_SECTION = SP_UNLOCKED;
@@ -138,9 +130,10 @@ volatile int16_t g_global_lockcount;
  * Description:
  *   This function disables context switching by disabling addition of
  *   new tasks to the g_readytorun task list.  The task that calls this
- *   function will be the only task that is allowed to run until it
- *   either calls  sched_unlock() (the appropriate number of times) or
- *   until it blocks itself.
+ *   function will be the only task that is allowed to run (on this CPU)
+ *   until it either calls  sched_unlock() (the appropriate number of
+ *   times) or until it blocks itself.  In the SMP case, the other CPUs
+ *   keep switching tasks; see sched_lock_global().
  *
  * Input Parameters:
  *   None
@@ -153,6 +146,85 @@ volatile int16_t g_global_lockcount;
 #ifdef CONFIG_SMP
 
 int sched_lock(void)
+{
+  FAR struct tcb_s *rtcb;
+  irqstate_t flags;
+
+  /* Only the task running on this CPU is affected.  Disabling local
+   * interrupts keeps this CPU from being paused, and so keeps another CPU
+   * from switching the running task, while the lockcount is sampled and
+   * incremented.  A CPU that wants to start a task here checks the
+   * lockcount again after pausing this CPU.  NOTE we cannot use
+   * this_task() because it calls sched_lock().
+   */
+
+  flags = up_irq_save();
+  rtcb  = current_task(this_cpu());
+
+  /* Check for some special cases:  (1) rtcb may be NULL only during early
+   * boot-up phases, and (2) sched_lock() should have no effect if called
+   * from the interrupt level.
+   */
+
+  if (rtcb == NULL || up_interrupt_context())
+    {
+      up_irq_restore(flags);
+    }
+  else
+    {
+      /* Catch attempts to increment the lockcount beyond the range of the
+       * integer type.
+       */
+
+      DEBUGASSERT(rtcb->lockcount < MAX_LOCK_COUNT);
+
+      /* A counter is used to support locking.  This allows nested lock
+       * operations on this thread.
+       */
+
+      rtcb->lockcount++;
+      up_irq_restore(flags);
+
+#if defined(CONFIG_SCHED_INSTRUMENTATION_PREEMPTION) || \
+    defined(CONFIG_SCHED_CRITMONITOR)
+      /* Check if we just acquired the lock */
+
+      if (rtcb->lockcount == 1)
+        {
+          /* Note that we have pre-emption locked */
+
+#ifdef CONFIG_SCHED_CRITMONITOR
+          sched_critmon_preemption(rtcb, true);
+#endif
+#ifdef CONFIG_SCHED_INSTRUMENTATION_PREEMPTION
+          sched_note_premption(rtcb, true);
+#endif
+        }
+#endif
+    }
+
+  return OK;
+}
+
+/****************************************************************************
+ * Name:  sched_lock_global
+ *
+ * Description:
+ *   This function disables pre-emption on the calling CPU, like
+ *   sched_lock(), and also keeps all other CPUs from starting new tasks
+ *   until sched_unlock_global() is called (the appropriate number of
+ *   times).  Tasks that become ready-to-run in the meantime are held in
+ *   the g_pendingtasks list.
+ *
+ * Input Parameters:
+ *   None
+ *
+ * Returned Value:
+ *   OK on success; ERROR on failure
+ *
+ ****************************************************************************/
+
+int sched_lock_global(void)
 {
   FAR struct tcb_s *rtcb;
 #if defined(CONFIG_ARCH_GLOBAL_IRQDISABLE)
@@ -208,14 +280,15 @@ int sched_lock(void)
        * integer type.
        */
 
-      DEBUGASSERT(rtcb->lockcount < MAX_LOCK_COUNT);
+      DEBUGASSERT(rtcb->lockcount < MAX_LOCK_COUNT &&
+                  rtcb->glockcount < MAX_LOCK_COUNT);
 
-      /* We must hold the lock on this CPU before we increment the lockcount
-       * for the first time. Holding the lock is sufficient to lockout context
-       * switching.
+      /* We must hold the lock on this CPU before we increment the
+       * glockcount for the first time. Holding the lock is sufficient to
+       * lockout context switching on all CPUs.
        */
 
-      if (rtcb->lockcount == 0)
+      if (rtcb->glockcount == 0)
         {
           /* We don't have the scheduler locked.  But logic running on a
            * different CPU may have the scheduler locked.  It is not
@@ -228,7 +301,7 @@ int sched_lock(void)
         }
       else
         {
-          /* If this thread already has the scheduler locked, then
+          /* If this thread already holds the global lock, then
            * g_cpu_schedlock() should indicate that the scheduler is locked
            * and g_cpu_lockset should include the bit setting for this CPU.
            */
@@ -237,10 +310,12 @@ int sched_lock(void)
                       (g_cpu_lockset & (1 << this_cpu())) != 0);
         }
 
-      /* A counter is used to support locking.  This allows nested lock
-       * operations on this thread (on any CPU)
+      /* Counters are used to support locking.  This allows nested lock
+       * operations on this thread (on any CPU).  The global lock also
+       * disables pre-emption on this CPU.
        */
 
+      rtcb->glockcount++;
       rtcb->lockcount++;
 
 #if defined(CONFIG_ARCH_GLOBAL_IRQDISABLE)
@@ -88,11 +88,37 @@
 bool sched_mergepending(void)
 {
   FAR struct tcb_s *ptcb;
-  FAR struct tcb_s *pnext;
   FAR struct tcb_s *rtcb;
+#ifndef CONFIG_SCHED_PRIOBITMAP
+  FAR struct tcb_s *pnext;
   FAR struct tcb_s *rprev;
+#endif
   bool ret = false;
 
+#ifdef CONFIG_SCHED_PRIOBITMAP
+  /* Both lists are indexed so each pending TCB can simply be moved to its
+   * place in the ready-to-run list.
+   */
+
+  while ((ptcb = (FAR struct tcb_s *)g_pendingtasks.head) != NULL)
+    {
+      sched_removeprioritized(ptcb, (FAR dq_queue_t *)&g_pendingtasks);
+
+      rtcb = this_task();
+      if (sched_addprioritized(ptcb, (FAR dq_queue_t *)&g_readytorun))
+        {
+          /* ptcb is now at the head of the ready-to-run list */
+
+          rtcb->task_state = TSTATE_TASK_READYTORUN;
+          ptcb->task_state = TSTATE_TASK_RUNNING;
+          ret              = true;
+        }
+      else
+        {
+          ptcb->task_state = TSTATE_TASK_READYTORUN;
+        }
+    }
+#else
   /* Initialize the inner search loop */
 
   rtcb = this_task();
@@ -111,11 +137,13 @@ bool sched_mergepending(void)
 
       /* Search the ready-to-run list to find the location to insert the
        * new ptcb. Each is list is maintained in ascending sched_priority
-       * order.
+       * order.  Deadline TCBs of the same priority are in deadline order.
        */
 
       for (;
-           (rtcb && ptcb->sched_priority <= rtcb->sched_priority);
+           (rtcb && (ptcb->sched_priority < rtcb->sched_priority ||
+                     (ptcb->sched_priority == rtcb->sched_priority &&
+                      !sched_deadline_before(ptcb, rtcb))));
            rtcb = rtcb->flink);
 
       /* Add the ptcb to the spot found in the list.  Check if the
@@ -161,6 +189,7 @@ bool sched_mergepending(void)
 
   g_pendingtasks.head = NULL;
   g_pendingtasks.tail = NULL;
+#endif
 
   return ret;
 }
@@ -205,8 +234,8 @@ bool sched_mergepending(void)
 
   /* Remove and process every TCB in the g_pendingtasks list.
    *
-   * Do nothing if (1) pre-emption is still disabled (by any CPU), or (2) if
-   * some CPU other than this one is in a critical section.
+   * Do nothing if (1) the global scheduler lock is held (by any CPU), or
+   * (2) if some CPU other than this one is in a critical section.
    */
 
   me = this_cpu();
@@ -222,7 +251,7 @@ bool sched_mergepending(void)
           goto errout_with_lock;
         }
 
-      cpu  = sched_cpu_select(ALL_CPUS /* ptcb->affinity */);
+      cpu  = sched_cpu_select(ALL_CPUS /* ptcb->affinity */, ptcb->cpu);
       rtcb = current_task(cpu);
 
       /* Loop while there is a higher priority task in the pending task list
@@ -238,7 +267,8 @@ bool sched_mergepending(void)
         {
           /* Remove the task from the pending task list */
 
-          tcb = (FAR struct tcb_s *)dq_remfirst((FAR dq_queue_t *)&g_pendingtasks);
+          tcb = ptcb;
+          sched_removeprioritized(tcb, (FAR dq_queue_t *)&g_pendingtasks);
 
           /* Add the pending task to the correct ready-to-run list. */
 
@@ -246,6 +276,16 @@ bool sched_mergepending(void)
           ret |= sched_addreadytorun(tcb);
           lock = sched_tasklist_lock();
 
+          /* The task is pended again if pre-emption is disabled on the CPU
+           * that it would run on.  That CPU releases the pending tasks in
+           * sched_unlock().
+           */
+
+          if (tcb->task_state == TSTATE_TASK_PENDING)
+            {
+              goto errout_with_lock;
+            }
+
           /* This operation could cause the scheduler to become locked.
            * Check if that happened.
            */
@@ -278,7 +318,7 @@ bool sched_mergepending(void)
               goto errout_with_lock;
             }
 
-          cpu  = sched_cpu_select(ALL_CPUS /* ptcb->affinity */);
+          cpu  = sched_cpu_select(ALL_CPUS /* ptcb->affinity */, ptcb->cpu);
           rtcb = current_task(cpu);
         }
 
@@ -293,6 +333,29 @@ bool sched_mergepending(void)
 
 errout_with_lock:
 
+#ifdef CONFIG_SMP_LOADBALANCE
+  /* Start any ready-to-run task that has a higher priority than the task
+   * running on one of the CPUs that it may run on.  Such tasks are left in
+   * the g_readytorun list if a CPU suspends its running task while the
+   * scheduler or the IRQ lock is held.
+   *
+   * Stop if the task running on this CPU has been preempted:  Its context
+   * is not saved until the caller switches to the new task so it must not
+   * be started on another CPU.
+   */
+
+  while (!ret && !sched_islocked_global() && !irq_cpu_locked(me) &&
+         (tcb = sched_unbalanced()) != NULL)
+    {
+      sched_removeprioritized(tcb, (FAR dq_queue_t *)&g_readytorun);
+      tcb->task_state = TSTATE_TASK_INVALID;
+
+      sched_tasklist_unlock(lock);
+      ret |= sched_addreadytorun(tcb);
+      lock = sched_tasklist_lock();
+    }
+#endif
+
   /* Unlock the tasklist */
 
   sched_tasklist_unlock(lock);
@@ -91,6 +91,24 @@ void sched_mergeprioritized(FAR dq_queue_t *list1, FAR dq_queue_t *list2,
 
   DEBUGASSERT(list1 != NULL && list2 != NULL);
 
+#ifdef CONFIG_SCHED_PRIOBITMAP
+  /* If either list is indexed, move the TCBs one at a time so that the
+   * indices stay valid.  Each move is done in constant time.
+   */
+
+  if (sched_prioindex(list1) != NULL || sched_prioindex(list2) != NULL)
+    {
+      while ((tmp = (FAR struct tcb_s *)dq_peek(list1)) != NULL)
+        {
+          sched_removeprioritized(tmp, list1);
+          tmp->task_state = task_state;
+          sched_addprioritized(tmp, list2);
+        }
+
+      goto ret_with_lock;
+    }
+#endif
+
   /* Get a private copy of list1, clearing list1.  We do this early so that
    * we can be assured that the list is stationary before we start any
    * operations on it.
@@ -39,6 +39,7 @@
 
 #include <nuttx/config.h>
 
+#include <stddef.h>
 #include <stdint.h>
 #include <string.h>
 #include <assert.h>
@@ -57,10 +58,22 @@
  * Pre-processor Definitions
  ****************************************************************************/
 
+/* Memory barriers are only needed if other CPUs consume the notes */
+
+#ifndef SP_DMB
+#  define SP_DMB()
+#endif
+
 /****************************************************************************
  * Private Types
  ****************************************************************************/
 
+/* One circular note buffer.  In SMP mode there is one buffer per CPU.  Each
+ * buffer has a single producer, the CPU that owns it, so notes are added
+ * with local interrupts disabled but without any lock.  ni_head is only
+ * modified by the producer and ni_tail is only modified by the consumer.
+ */
+
 struct note_info_s
 {
   volatile unsigned int ni_head;
@@ -92,9 +105,15 @@ static void note_add(FAR const uint8_t *note, uint8_t notelen);
  * Private Data
  ****************************************************************************/
 
-static struct note_info_s g_note_info;
-
 #ifdef CONFIG_SMP
+static struct note_info_s g_note_info[CONFIG_SMP_NCPUS];
+#else
+static struct note_info_s g_note_info[1];
+#endif
+
+#if defined(CONFIG_SCHED_NOTE_GET) && defined(CONFIG_SMP)
+/* Serializes the consumers of the note buffers */
+
 static volatile spinlock_t g_note_lock;
 #endif
 
@@ -209,18 +228,17 @@ void note_spincommon(FAR struct tcb_s *tcb, FAR volatile spinlock_t *spinlock,
  *   Length of data currently in circular buffer.
  *
  * Input Parameters:
- *   None
+ *   info - The circular buffer
  *
  * Returned Value:
  *   Length of data currently in circular buffer.
  *
  ****************************************************************************/
 
-#if defined(CONFIG_SCHED_NOTE_GET) || defined(CONFIG_DEBUG_ASSERTIONS)
-static unsigned int note_length(void)
+static unsigned int note_length(FAR struct note_info_s *info)
 {
-  unsigned int head = g_note_info.ni_head;
-  unsigned int tail = g_note_info.ni_tail;
+  unsigned int head = info->ni_head;
+  unsigned int tail = info->ni_tail;
 
   if (tail > head)
     {
@@ -229,7 +247,6 @@ static unsigned int note_length(void)
 
   return head - tail;
 }
-#endif
 
 /****************************************************************************
  * Name: note_remove
@@ -238,17 +255,18 @@ static unsigned int note_length(void)
  *   Remove the variable length note from the tail of the circular buffer
  *
  * Input Parameters:
- *   None
+ *   info - The circular buffer
  *
  * Returned Value:
  *   None
  *
  * Assumptions:
- *   We are within a critical section.
+ *   Called by the consumer of the buffer or, if there is no consumer, by
+ *   its producer.
  *
  ****************************************************************************/
 
-static void note_remove(void)
+static void note_remove(FAR struct note_info_s *info)
 {
   FAR struct note_common_s *note;
   unsigned int tail;
@@ -256,41 +274,47 @@ static void note_remove(void)
 
   /* Get the tail index of the circular buffer */
 
-  tail = g_note_info.ni_tail;
+  tail = info->ni_tail;
   DEBUGASSERT(tail < CONFIG_SCHED_NOTE_BUFSIZE);
 
   /* Get the length of the note at the tail index */
 
-  note   = (FAR struct note_common_s *)&g_note_info.ni_buffer[tail];
+  note   = (FAR struct note_common_s *)&info->ni_buffer[tail];
   length = note->nc_length;
-  DEBUGASSERT(length <= note_length());
+  DEBUGASSERT(length <= note_length(info));
 
   /* Increment the tail index to remove the entire note from the circular
    * buffer.
    */
 
-  g_note_info.ni_tail = note_next(tail, length);
+  info->ni_tail = note_next(tail, length);
 }
 
 /****************************************************************************
  * Name: note_add
  *
  * Description:
- *   Add the variable length note to the head of the circular buffer
+ *   Add the variable length note to the head of the circular buffer of the
+ *   current CPU.
+ *
+ *   If there is a consumer of the notes (CONFIG_SCHED_NOTE_GET), only the
+ *   consumer may remove notes, so a note that does not fit into the buffer
+ *   is discarded.  Otherwise, the oldest notes are overwritten so that the
+ *   buffer always holds the most recent history.
  *
  * Input Parameters:
- *   None
+ *   note    - The note to add
+ *   notelen - The length of the note
  *
  * Returned Value:
  *   None
  *
- * Assumptions:
- *   We are within a critical section.
- *
  ****************************************************************************/
 
 static void note_add(FAR const uint8_t *note, uint8_t notelen)
 {
+  FAR struct note_info_s *info;
+  irqstate_t flags;
   unsigned int head;
   unsigned int next;
 
@@ -305,47 +329,135 @@ static void note_add(FAR const uint8_t *note, uint8_t notelen)
     }
 #endif
 
-#ifdef CONFIG_SMP
-  irqstate_t flags = up_irq_save();
-  spin_lock_wo_note(&g_note_lock);
+  DEBUGASSERT(note != NULL && notelen < CONFIG_SCHED_NOTE_BUFSIZE);
+
+  /* Disabling local interrupts is sufficient:  No other CPU adds notes to
+   * this CPU's buffer.
+   */
+
+  flags = up_irq_save();
+  info  = &g_note_info[this_cpu()];
+
+#ifdef CONFIG_SCHED_NOTE_GET
+  /* Discard the note if there is no space for it */
+
+  if (note_length(info) + notelen >= CONFIG_SCHED_NOTE_BUFSIZE)
+    {
+      up_irq_restore(flags);
+      return;
+    }
 #endif
 
   /* Get the index to the head of the circular buffer */
 
-  DEBUGASSERT(note != NULL && notelen < CONFIG_SCHED_NOTE_BUFSIZE);
-  head = g_note_info.ni_head;
+  head = info->ni_head;
 
   /* Loop until all bytes have been transferred to the circular buffer */
 
   while (notelen > 0)
     {
+#ifndef CONFIG_SCHED_NOTE_GET
       /* Get the next head index.  Would it collide with the current tail
        * index?
        */
 
       next = note_next(head, 1);
-      if (next == g_note_info.ni_tail)
+      if (next == info->ni_tail)
         {
           /* Yes, then remove the note at the tail index */
 
-          note_remove();
+          note_remove(info);
         }
+#else
+      next = note_next(head, 1);
+#endif
 
       /* Save the next byte at the head index */
 
-      g_note_info.ni_buffer[head] = *note++;
+      info->ni_buffer[head] = *note++;
 
       head = next;
       notelen--;
     }
 
-  g_note_info.ni_head = head;
+  /* The note must be complete in memory before the consumer can see the
+   * new head index.
+   */
+
+  SP_DMB();
+  info->ni_head = head;
 
-#ifdef CONFIG_SMP
-  spin_unlock_wo_note(&g_note_lock);
   up_irq_restore(flags);
+}
+
+/****************************************************************************
+ * Name: note_oldest
+ *
+ * Description:
+ *   Return the circular buffer that holds the oldest note.  In SMP mode the
+ *   notes of the CPUs are merged in time order.
+ *
+ * Input Parameters:
+ *   None
+ *
+ * Returned Value:
+ *   The circular buffer holding the oldest note or NULL if all buffers are
+ *   empty.
+ *
+ * Assumptions:
+ *   The caller holds g_note_lock.
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_SCHED_NOTE_GET
+static FAR struct note_info_s *note_oldest(void)
+{
+#ifdef CONFIG_SMP
+  FAR struct note_info_s *oldest = NULL;
+  FAR struct note_info_s *info;
+  uint32_t oldtime = 0;
+  uint32_t systime;
+  unsigned int ndx;
+  int shift;
+  int cpu;
+
+  for (cpu = 0; cpu < CONFIG_SMP_NCPUS; cpu++)
+    {
+      info = &g_note_info[cpu];
+      if (note_length(info) == 0)
+        {
+          continue;
+        }
+
+      /* Get the time stamp of the note at the tail, which may wrap around
+       * the end of the buffer.
+       */
+
+      SP_DMB();
+
+      ndx     = note_next(info->ni_tail,
+                          offsetof(struct note_common_s, nc_systime));
+      systime = 0;
+
+      for (shift = 0; shift < 32; shift += 8)
+        {
+          systime |= (uint32_t)info->ni_buffer[ndx] << shift;
+          ndx      = note_next(ndx, 1);
+        }
+
+      if (oldest == NULL || (int32_t)(systime - oldtime) < 0)
+        {
+          oldest  = info;
+          oldtime = systime;
+        }
+    }
+
+  return oldest;
+#else
+  return note_length(&g_note_info[0]) > 0 ? &g_note_info[0] : NULL;
 #endif
 }
+#endif
 
 /****************************************************************************
  * Public Functions
@@ -611,34 +723,44 @@ void sched_note_spinabort(FAR struct tcb_s *tcb, FAR volatile void *spinlock)
 ssize_t sched_note_get(FAR uint8_t *buffer, size_t buflen)
 {
   FAR struct note_common_s *note;
+  FAR struct note_info_s *info;
   irqstate_t flags;
   unsigned int remaining;
   unsigned int tail;
   ssize_t notelen;
-  size_t circlen;
 
   DEBUGASSERT(buffer != NULL);
-  flags = enter_critical_section();
 
-  /* Verify that the circular buffer is not empty */
+  /* Only the consumers need to be serialized.  This does not generate any
+   * notes itself and does not block the producers.
+   */
 
-  circlen = note_length();
-  if (circlen <= 0)
+  flags = up_irq_save();
+#ifdef CONFIG_SMP
+  spin_lock_wo_note(&g_note_lock);
+#endif
+
+  /* Find the buffer with the oldest note */
+
+  info = note_oldest();
+  if (info == NULL)
     {
       notelen = 0;
-      goto errout_with_csection;
+      goto errout_with_lock;
     }
 
+  SP_DMB();
+
   /* Get the index to the tail of the circular buffer */
 
-  tail    = g_note_info.ni_tail;
+  tail    = info->ni_tail;
   DEBUGASSERT(tail < CONFIG_SCHED_NOTE_BUFSIZE);
 
   /* Get the length of the note at the tail index */
 
-  note    = (FAR struct note_common_s *)&g_note_info.ni_buffer[tail];
+  note    = (FAR struct note_common_s *)&info->ni_buffer[tail];
   notelen = note->nc_length;
-  DEBUGASSERT(notelen <= circlen);
+  DEBUGASSERT(notelen <= note_length(info));
 
   /* Is the user buffer large enough to hold the note? */
 
@@ -646,12 +768,12 @@ ssize_t sched_note_get(FAR uint8_t *buffer, size_t buflen)
     {
       /* Remove the large note so that we do not get constipated. */
 
-      note_remove();
+      note_remove(info);
 
       /* and return an error */
 
       notelen = -EFBIG;
-      goto errout_with_csection;
+      goto errout_with_lock;
     }
 
   /* Loop until the note has been transferred to the user buffer */
@@ -661,7 +783,7 @@ ssize_t sched_note_get(FAR uint8_t *buffer, size_t buflen)
     {
       /* Copy the next byte at the tail index */
 
-      *buffer++ = g_note_info.ni_buffer[tail];
+      *buffer++ = info->ni_buffer[tail];
 
       /* Adjust indices and counts */
 
@@ -669,10 +791,16 @@ ssize_t sched_note_get(FAR uint8_t *buffer, size_t buflen)
       remaining--;
     }
 
-  g_note_info.ni_tail = tail;
+  /* The note must be copied before the producer may reuse the space */
+
+  SP_DMB();
+  info->ni_tail = tail;
 
-errout_with_csection:
-  leave_critical_section(flags);
+errout_with_lock:
+#ifdef CONFIG_SMP
+  spin_unlock_wo_note(&g_note_lock);
+#endif
+  up_irq_restore(flags);
   return notelen;
 }
 #endif
@@ -681,14 +809,15 @@ errout_with_csection:
  * Name: sched_note_size
  *
  * Description:
- *   Return the size of the next note at the tail of the circular buffer.
+ *   Return the size of the next note
  *
  * Input Parameters:
- *   None.
+ *   None
  *
  * Returned Value:
- *   Zero is returned if the circular buffer is empty.  Otherwise, the size
- *   of the next note is returned.
+ *   On success, the positive, non-zero length of the next note is returned.
+ *   Zero is returned if the circular buffer is empty.  A negated errno value
+ *   is returned in the event of any failure.
  *
  ****************************************************************************/
 
@@ -696,35 +825,38 @@ errout_with_csection:
 ssize_t sched_note_size(void)
 {
   FAR struct note_common_s *note;
+  FAR struct note_info_s *info;
   irqstate_t flags;
-  unsigned int tail;
   ssize_t notelen;
-  size_t circlen;
 
-  flags = enter_critical_section();
+  flags = up_irq_save();
+#ifdef CONFIG_SMP
+  spin_lock_wo_note(&g_note_lock);
+#endif
 
-  /* Verify that the circular buffer is not empty */
+  /* Find the buffer with the oldest note */
 
-  circlen = note_length();
-  if (circlen <= 0)
+  info = note_oldest();
+  if (info == NULL)
     {
       notelen = 0;
-      goto errout_with_csection;
     }
+  else
+    {
+      /* Get the length of the note at the tail index */
 
-  /* Get the index to the tail of the circular buffer */
-
-  tail = g_note_info.ni_tail;
-  DEBUGASSERT(tail < CONFIG_SCHED_NOTE_BUFSIZE);
-
-  /* Get the length of the note at the tail index */
+      SP_DMB();
 
-  note    = (FAR struct note_common_s *)&g_note_info.ni_buffer[tail];
-  notelen = note->nc_length;
-  DEBUGASSERT(notelen <= circlen);
+      DEBUGASSERT(info->ni_tail < CONFIG_SCHED_NOTE_BUFSIZE);
+      note    = (FAR struct note_common_s *)&info->ni_buffer[info->ni_tail];
+      notelen = note->nc_length;
+      DEBUGASSERT(notelen <= note_length(info));
+    }
 
-errout_with_csection:
-  leave_critical_section(flags);
+#ifdef CONFIG_SMP
+  spin_unlock_wo_note(&g_note_lock);
+#endif
+  up_irq_restore(flags);
   return notelen;
 }
 #endif
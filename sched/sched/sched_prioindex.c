@@ -0,0 +1,227 @@
+/****************************************************************************
+ * sched/sched/sched_prioindex.c
+ *
+ *   Copyright (C) 2020 Gregory Nutt. All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in
+ *    the documentation and/or other materials provided with the
+ *    distribution.
+ * 3. Neither the name NuttX nor the names of its contributors may be
+ *    used to endorse or promote products derived from this software
+ *    without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+ * FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE
+ * COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+ * INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,
+ * BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS
+ * OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED
+ * AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ * LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN
+ * ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ *
+ ****************************************************************************/
+
+/****************************************************************************
+ * Included Files
+ ****************************************************************************/
+
+#include <nuttx/config.h>
+
+#include <stdint.h>
+#include <strings.h>
+#include <queue.h>
+#include <assert.h>
+
+#include "sched/sched.h"
+
+#ifdef CONFIG_SCHED_PRIOBITMAP
+
+/****************************************************************************
+ * Private Data
+ ****************************************************************************/
+
+/* These are the indices of the prioritized lists that hold the most TCBs.
+ * The other prioritized lists are short and are still searched.
+ */
+
+static struct prioindex_s g_readytorun_index;
+static struct prioindex_s g_pendingtasks_index;
+static struct prioindex_s g_waitingforsemaphore_index;
+
+/****************************************************************************
+ * Public Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: sched_prioindex
+ *
+ * Description:
+ *   Return the priority index of a prioritized task list.
+ *
+ * Input Parameters:
+ *   list - Points to the prioritized task list
+ *
+ * Returned Value:
+ *   The index of the list or NULL if the list is not indexed.
+ *
+ ****************************************************************************/
+
+FAR struct prioindex_s *sched_prioindex(DSEG dq_queue_t *list)
+{
+  if (list == (FAR dq_queue_t *)&g_readytorun)
+    {
+      return &g_readytorun_index;
+    }
+  else if (list == (FAR dq_queue_t *)&g_pendingtasks)
+    {
+      return &g_pendingtasks_index;
+    }
+  else if (list == (FAR dq_queue_t *)&g_waitingforsemaphore)
+    {
+      return &g_waitingforsemaphore_index;
+    }
+
+  return NULL;
+}
+
+/****************************************************************************
+ * Name: sched_prioindex_prev
+ *
+ * Description:
+ *   Find the TCB after which a TCB of priority 'sched_priority' must be
+ *   inserted into an indexed list:  That is the last TCB of the same
+ *   priority or, if there is none, the last TCB of the next higher
+ *   priority that is present in the list.
+ *
+ * Input Parameters:
+ *   index - The index of the prioritized list
+ *   sched_priority - The priority of the TCB to be inserted
+ *
+ * Returned Value:
+ *   The TCB to insert after or NULL if the TCB goes at the head of the
+ *   list.
+ *
+ ****************************************************************************/
+
+FAR struct tcb_s *sched_prioindex_prev(FAR struct prioindex_s *index,
+                                       uint8_t sched_priority)
+{
+  uint32_t bits;
+  int word = sched_priority >> 5;
+  int bit  = sched_priority & 31;
+
+  /* Look for the same or a higher priority in the same bitmap word... */
+
+  bits = index->bitmap[word] & ~(((uint32_t)1 << bit) - 1);
+  if (bits == 0)
+    {
+      /* ...then for the first non-empty word above it. */
+
+      bits = index->group & ~((2u << word) - 1);
+      if (bits == 0)
+        {
+          return NULL;
+        }
+
+      word = ffs(bits) - 1;
+      bits = index->bitmap[word];
+    }
+
+  return index->tail[(word << 5) + ffs(bits) - 1];
+}
+
+/****************************************************************************
+ * Name: sched_prioindex_add
+ *
+ * Description:
+ *   Record that 'tcb' has just been inserted into an indexed list as the
+ *   last TCB of its priority.
+ *
+ * Input Parameters:
+ *   index - The index of the prioritized list
+ *   tcb - The TCB that was inserted
+ *
+ * Returned Value:
+ *   None
+ *
+ ****************************************************************************/
+
+void sched_prioindex_add(FAR struct prioindex_s *index,
+                         FAR struct tcb_s *tcb)
+{
+  uint8_t sched_priority = tcb->sched_priority;
+  int word = sched_priority >> 5;
+
+  index->tail[sched_priority] = tcb;
+  index->bitmap[word] |= (uint32_t)1 << (sched_priority & 31);
+  index->group |= 1 << word;
+}
+
+/****************************************************************************
+ * Name: sched_removeprioritized
+ *
+ * Description:
+ *   This function removes a TCB from a prioritized TCB list, keeping the
+ *   priority index of the list, if any, up to date.
+ *
+ * Input Parameters:
+ *   tcb - Points to the TCB to remove from the prioritized list
+ *   list - Points to the prioritized list that holds tcb
+ *
+ * Returned Value:
+ *   None
+ *
+ * Assumptions:
+ * - The caller has established a critical section before
+ *   calling this function.
+ * - The priority of the TCB has not been changed since it was added to
+ *   the list.
+ *
+ ****************************************************************************/
+
+void sched_removeprioritized(FAR struct tcb_s *tcb, DSEG dq_queue_t *list)
+{
+  FAR struct prioindex_s *index = sched_prioindex(list);
+  uint8_t sched_priority = tcb->sched_priority;
+
+  if (index != NULL && index->tail[sched_priority] == tcb)
+    {
+      FAR struct tcb_s *prev = tcb->blink;
+      int word;
+
+      if (prev != NULL && prev->sched_priority == sched_priority)
+        {
+          /* The previous TCB is now the last of this priority */
+
+          index->tail[sched_priority] = prev;
+        }
+      else
+        {
+          /* This was the only TCB of this priority */
+
+          word = sched_priority >> 5;
+          index->tail[sched_priority] = NULL;
+          index->bitmap[word] &= ~((uint32_t)1 << (sched_priority & 31));
+
+          if (index->bitmap[word] == 0)
+            {
+              index->group &= ~(1 << word);
+            }
+        }
+    }
+
+  dq_rem((FAR dq_entry_t *)tcb, list);
+}
+
+#endif /* CONFIG_SCHED_PRIOBITMAP */
@@ -54,6 +54,16 @@
 #include "wdog/wdog.h"
 #include "clock/clock.h"
 
+/****************************************************************************
+ * Private Data
+ ****************************************************************************/
+
+#if defined(CONFIG_SMP_LOADBALANCE) && CONFIG_SMP_LOADBALANCE_INTERVAL > 0
+/* The number of ticks since the last load balancing check */
+
+static unsigned int g_loadbalance_ticks;
+#endif
+
 /****************************************************************************
  * Private Functions
  ****************************************************************************/
@@ -73,7 +83,8 @@
  *
  ****************************************************************************/
 
-#if CONFIG_RR_INTERVAL > 0 || defined(CONFIG_SCHED_SPORADIC)
+#if CONFIG_RR_INTERVAL > 0 || defined(CONFIG_SCHED_SPORADIC) || \
+    defined(CONFIG_SCHED_DEADLINE)
 static inline void nxsched_cpu_scheduler(int cpu)
 {
   FAR struct tcb_s *rtcb = current_task(cpu);
@@ -103,6 +114,17 @@ static inline void nxsched_cpu_scheduler(int cpu)
       sched_sporadic_process(rtcb, 1, false);
     }
 #endif
+
+#ifdef CONFIG_SCHED_DEADLINE
+  /* Check if the currently executing task uses deadline scheduling. */
+
+  if ((rtcb->flags & TCB_FLAG_POLICY_MASK) == TCB_FLAG_SCHED_DEADLINE)
+    {
+      /* Yes, charge the tick to its budget */
+
+      sched_deadline_process(rtcb, 1, false);
+    }
+#endif
 }
 #endif
 
@@ -121,7 +143,8 @@ static inline void nxsched_cpu_scheduler(int cpu)
  *
  ****************************************************************************/
 
-#if CONFIG_RR_INTERVAL > 0 || defined(CONFIG_SCHED_SPORADIC)
+#if CONFIG_RR_INTERVAL > 0 || defined(CONFIG_SCHED_SPORADIC) || \
+    defined(CONFIG_SCHED_DEADLINE)
 static inline void nxsched_process_scheduler(void)
 {
 #ifdef CONFIG_SMP
@@ -157,6 +180,34 @@ static inline void nxsched_process_scheduler(void)
 #  define nxsched_process_scheduler()
 #endif
 
+/****************************************************************************
+ * Name:  nxsched_process_loadbalance
+ *
+ * Description:
+ *   Periodically start any ready-to-run task that has a higher priority
+ *   than the task running on one of the CPUs in its affinity mask.
+ *
+ * Input Parameters:
+ *   None
+ *
+ * Returned Value:
+ *   None
+ *
+ ****************************************************************************/
+
+#if defined(CONFIG_SMP_LOADBALANCE) && CONFIG_SMP_LOADBALANCE_INTERVAL > 0
+static inline void nxsched_process_loadbalance(void)
+{
+  if (++g_loadbalance_ticks >= CONFIG_SMP_LOADBALANCE_INTERVAL)
+    {
+      g_loadbalance_ticks = 0;
+      sched_loadbalance();
+    }
+}
+#else
+#  define nxsched_process_loadbalance()
+#endif
+
 /****************************************************************************
  * Public Functions
  ****************************************************************************/
@@ -217,12 +268,22 @@ void nxsched_process_timer(void)
     }
 #endif
 
+#ifdef CONFIG_SCHED_PROFILE
+  /* Sample the interrupted context for the profiler */
+
+  sched_profile_tick();
+#endif
+
   /* Check if the currently executing task has exceeded its
    * timeslice.
    */
 
   nxsched_process_scheduler();
 
+  /* Check if any CPU should be running a ready-to-run task instead */
+
+  nxsched_process_loadbalance();
+
   /* Process watchdogs */
 
   wd_timer();
@@ -0,0 +1,309 @@
+/****************************************************************************
+ * sched/sched/sched_profile.c
+ *
+ *   Copyright (C) 2020 Gregory Nutt. All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in
+ *    the documentation and/or other materials provided with the
+ *    distribution.
+ * 3. Neither the name NuttX nor the names of its contributors may be
+ *    used to endorse or promote products derived from this software
+ *    without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+ * FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE
+ * COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+ * INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,
+ * BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS
+ * OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED
+ * AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ * LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN
+ * ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ *
+ ****************************************************************************/
+
+/****************************************************************************
+ * Included Files
+ ****************************************************************************/
+
+#include <nuttx/config.h>
+
+#include <sys/types.h>
+#include <stdint.h>
+#include <stdbool.h>
+#include <string.h>
+#include <sched.h>
+
+#include <nuttx/arch.h>
+#include <nuttx/irq.h>
+
+#include "sched/sched.h"
+
+#ifdef CONFIG_SCHED_PROFILE
+
+/****************************************************************************
+ * Pre-processor Definitions
+ ****************************************************************************/
+
+#ifdef CONFIG_SMP
+#  define PROFILE_NCPUS CONFIG_SMP_NCPUS
+#else
+#  define PROFILE_NCPUS 1
+#endif
+
+/****************************************************************************
+ * Private Types
+ ****************************************************************************/
+
+/* The samples taken on one CPU.  Each CPU only updates its own histogram so
+ * that no locking is needed when a sample is taken.
+ */
+
+struct profile_cpu_s
+{
+  uint32_t nsamples;                      /* Number of samples taken */
+  uint32_t noutside;                      /* Samples outside of the text */
+  uint32_t pc[CONFIG_SCHED_PROFILE_NBUCKETS];
+#ifdef CONFIG_SCHED_PROFILE_CALLER
+  uint32_t caller[CONFIG_SCHED_PROFILE_NBUCKETS];
+#endif
+};
+
+/****************************************************************************
+ * Private Data
+ ****************************************************************************/
+
+static struct profile_cpu_s g_profile[PROFILE_NCPUS];
+
+/* The text section covered by the histograms */
+
+static uintptr_t g_profile_start;
+static uintptr_t g_profile_end;
+static uint8_t g_profile_shift;
+static volatile bool g_profile_running;
+
+/****************************************************************************
+ * Private Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: sched_profile_ndx
+ *
+ * Description:
+ *   Return the histogram bucket of an address or -1 if the address is not
+ *   in the text section.
+ *
+ ****************************************************************************/
+
+static inline int sched_profile_ndx(uintptr_t addr)
+{
+  if (addr < g_profile_start || addr >= g_profile_end)
+    {
+      return -1;
+    }
+
+  return (int)((addr - g_profile_start) >> g_profile_shift);
+}
+
+/****************************************************************************
+ * Public Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: sched_profile_start
+ *
+ * Description:
+ *   Start taking samples.  Samples are added to those already taken.
+ *
+ ****************************************************************************/
+
+void sched_profile_start(void)
+{
+  uintptr_t size;
+  uint8_t shift;
+
+  if (g_profile_end == 0)
+    {
+      /* Find the smallest power-of-two bucket size that lets the buckets
+       * cover the whole text section.
+       */
+
+      up_profile_text(&g_profile_start, &g_profile_end);
+
+      size = g_profile_end - g_profile_start;
+      for (shift = 1;
+           (size >> shift) >= CONFIG_SCHED_PROFILE_NBUCKETS;
+           shift++);
+
+      g_profile_shift = shift;
+    }
+
+  g_profile_running = true;
+}
+
+/****************************************************************************
+ * Name: sched_profile_stop
+ *
+ * Description:
+ *   Stop taking samples.  The samples taken are kept.
+ *
+ ****************************************************************************/
+
+void sched_profile_stop(void)
+{
+  g_profile_running = false;
+}
+
+/****************************************************************************
+ * Name: sched_profile_reset
+ *
+ * Description:
+ *   Discard all samples.
+ *
+ ****************************************************************************/
+
+void sched_profile_reset(void)
+{
+  irqstate_t flags;
+
+  flags = enter_critical_section();
+  memset(g_profile, 0, sizeof(g_profile));
+  leave_critical_section(flags);
+}
+
+/****************************************************************************
+ * Name: sched_profile_sample
+ *
+ * Description:
+ *   Add one sample to the histograms of this CPU.
+ *
+ * Assumptions:
+ *   May be called from any interrupt handler, including one that runs
+ *   outside of the OS critical sections.
+ *
+ ****************************************************************************/
+
+void sched_profile_sample(uintptr_t pc, uintptr_t caller)
+{
+  FAR struct profile_cpu_s *prof;
+  int ndx;
+
+  if (!g_profile_running)
+    {
+      return;
+    }
+
+  prof = &g_profile[this_cpu()];
+  prof->nsamples++;
+
+  ndx = sched_profile_ndx(pc);
+  if (ndx < 0)
+    {
+      prof->noutside++;
+      return;
+    }
+
+  prof->pc[ndx]++;
+
+#ifdef CONFIG_SCHED_PROFILE_CALLER
+  /* Clear the Thumb bit, if any, of the return address */
+
+  ndx = sched_profile_ndx(caller & ~(uintptr_t)1);
+  if (ndx >= 0)
+    {
+      prof->caller[ndx]++;
+    }
+#endif
+}
+
+/****************************************************************************
+ * Name: sched_profile_tick
+ *
+ * Description:
+ *   Sample the context interrupted by the current interrupt.
+ *
+ ****************************************************************************/
+
+void sched_profile_tick(void)
+{
+  uintptr_t caller = 0;
+  uintptr_t pc;
+
+  if (g_profile_running)
+    {
+      pc = up_profile_pc(&caller);
+      sched_profile_sample(pc, caller);
+    }
+}
+
+/****************************************************************************
+ * Name: sched_profile_info
+ *
+ * Description:
+ *   Return the layout of the histograms and the sample totals of all CPUs.
+ *
+ ****************************************************************************/
+
+void sched_profile_info(FAR struct profile_info_s *info)
+{
+  int cpu;
+
+  info->start    = g_profile_start;
+  info->shift    = g_profile_shift;
+  info->running  = g_profile_running;
+  info->nsamples = 0;
+  info->noutside = 0;
+
+  for (cpu = 0; cpu < PROFILE_NCPUS; cpu++)
+    {
+      info->nsamples += g_profile[cpu].nsamples;
+      info->noutside += g_profile[cpu].noutside;
+    }
+}
+
+/****************************************************************************
+ * Name: sched_profile_count
+ *
+ * Description:
+ *   Return the number of samples of all CPUs in one histogram bucket.
+ *
+ * Input Parameters:
+ *   ndx    - The bucket index, 0 .. CONFIG_SCHED_PROFILE_NBUCKETS - 1
+ *   caller - True: Return the count of the return address histogram
+ *
+ ****************************************************************************/
+
+uint32_t sched_profile_count(int ndx, bool caller)
+{
+  uint32_t count = 0;
+  int cpu;
+
+  DEBUGASSERT(ndx >= 0 && ndx < CONFIG_SCHED_PROFILE_NBUCKETS);
+
+  for (cpu = 0; cpu < PROFILE_NCPUS; cpu++)
+    {
+#ifdef CONFIG_SCHED_PROFILE_CALLER
+      if (caller)
+        {
+          count += g_profile[cpu].caller[ndx];
+          continue;
+        }
+#endif
+
+      count += g_profile[cpu].pc[ndx];
+    }
+
+  return count;
+}
+
+#endif /* CONFIG_SCHED_PROFILE */
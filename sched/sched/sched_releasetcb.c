@@ -49,6 +49,7 @@
 
 #include "sched/sched.h"
 #include "group/group.h"
+#include "task/task.h"
 #include "timer/timer.h"
 
 /****************************************************************************
@@ -77,10 +78,13 @@ static void nxsched_releasepid(pid_t pid)
 #ifdef CONFIG_SCHED_CPULOAD
   /* Decrement the total CPU load count held by this thread from the
    * total for all threads.  Then we can reset the count on this
-   * defunct thread to zero.
+   * defunct thread to zero.  The total of the cycle accounting is the
+   * time accounted on the CPUs, which does not change.
    */
 
+#ifndef CONFIG_SCHED_CPULOAD_CYCLES
   g_cpuload_total          -= g_pidhash[hash_ndx].ticks;
+#endif
   g_pidhash[hash_ndx].ticks = 0;
 #endif
 }
@@ -143,6 +147,15 @@ int sched_releasetcb(FAR struct tcb_s *tcb, uint8_t ttype)
           nxsched_releasepid(tcb->pid);
         }
 
+#ifdef HAVE_TASK_POOL
+      /* A pooled TCB keeps its stack */
+
+      if (nxtask_pool_member(tcb))
+        {
+          tcb->stack_alloc_ptr = NULL;
+        }
+#endif
+
       /* Delete the thread's stack if one has been allocated */
 
       if (tcb->stack_alloc_ptr)
@@ -199,7 +212,16 @@ int sched_releasetcb(FAR struct tcb_s *tcb, uint8_t ttype)
 
       /* And, finally, release the TCB itself */
 
-      sched_kfree(tcb);
+#ifdef HAVE_TASK_POOL
+      if (nxtask_pool_member(tcb))
+        {
+          nxtask_pool_free(tcb);
+        }
+      else
+#endif
+        {
+          sched_kfree(tcb);
+        }
     }
 
   return ret;
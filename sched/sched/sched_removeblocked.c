@@ -80,11 +80,22 @@ void sched_removeblocked(FAR struct tcb_s *btcb)
    * with this state
    */
 
-  dq_rem((FAR dq_entry_t *)btcb, TLIST_BLOCKED(task_state));
+  sched_removeprioritized(btcb, TLIST_BLOCKED(task_state));
 
   /* Make sure the TCB's state corresponds to not being in
    * any list
    */
 
   btcb->task_state = TSTATE_TASK_INVALID;
+
+#ifdef CONFIG_SCHED_DEADLINE
+  /* Start a new period if the thread cannot use the rest of its current
+   * budget before its deadline.
+   */
+
+  if (sched_isdeadline(btcb))
+    {
+      sched_deadline_wakeup(btcb);
+    }
+#endif
 }
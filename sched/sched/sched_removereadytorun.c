@@ -101,7 +101,7 @@ bool sched_removereadytorun(FAR struct tcb_s *rtcb)
    * is always the g_readytorun list.
    */
 
-  dq_rem((FAR dq_entry_t *)rtcb, (FAR dq_queue_t *)&g_readytorun);
+  sched_removeprioritized(rtcb, (FAR dq_queue_t *)&g_readytorun);
 
   /* Since the TCB is not in any list, it is now invalid */
 
@@ -198,7 +198,7 @@ bool sched_removereadytorun(FAR struct tcb_s *rtcb)
        * or the g_assignedtasks[cpu] list.
        */
 
-      dq_rem((FAR dq_entry_t *)rtcb, tasklist);
+      sched_removeprioritized(rtcb, tasklist);
 
       /* Which task will go at the head of the list?  It will be either the
        * next tcb in the assigned task list (nxttcb) or a TCB in the
@@ -237,8 +237,8 @@ bool sched_removereadytorun(FAR struct tcb_s *rtcb)
            * list and add to the head of the g_assignedtasks[cpu] list.
            */
 
-          tmptcb = (FAR struct tcb_s *)
-            dq_remfirst((FAR dq_queue_t *)&g_readytorun);
+          tmptcb = (FAR struct tcb_s *)g_readytorun.head;
+          sched_removeprioritized(tmptcb, (FAR dq_queue_t *)&g_readytorun);
 
           dq_addfirst((FAR dq_entry_t *)tmptcb, tasklist);
 
@@ -246,11 +246,12 @@ bool sched_removereadytorun(FAR struct tcb_s *rtcb)
           nxttcb = tmptcb;
         }
 
-      /* Will pre-emption be disabled after the switch?  If the lockcount is
-       * greater than zero, then this task/this CPU holds the scheduler lock.
+      /* Will the global lock be held after the switch?  If the glockcount
+       * is greater than zero, then this task/this CPU holds the global
+       * scheduler lock.
        */
 
-      if (nxttcb->lockcount > 0)
+      if (nxttcb->glockcount > 0)
         {
           /* Yes... make sure that scheduling logic knows about this */
 
@@ -328,7 +329,7 @@ bool sched_removereadytorun(FAR struct tcb_s *rtcb)
        * g_assignedtasks[cpu] list.
        */
 
-      dq_rem((FAR dq_entry_t *)rtcb, tasklist);
+      sched_removeprioritized(rtcb, tasklist);
     }
 
   /* Since the TCB is no longer in any list, it is now invalid */
@@ -44,12 +44,27 @@
 #include <nuttx/sched.h>
 #include <nuttx/clock.h>
 #include <nuttx/sched_note.h>
+#include <nuttx/tls.h>
 
 #include "irq/irq.h"
 #include "sched/sched.h"
 
 #if CONFIG_RR_INTERVAL > 0 || defined(CONFIG_SCHED_RESUMESCHEDULER)
 
+/****************************************************************************
+ * Public Data
+ ****************************************************************************/
+
+#ifdef CONFIG_TLS_CURRENT
+/* The TLS information of the thread running on each CPU */
+
+#  ifdef CONFIG_SMP
+FAR struct tls_info_s *g_tls_current[CONFIG_SMP_NCPUS];
+#  else
+FAR struct tls_info_s *g_tls_current[1];
+#  endif
+#endif
+
 /****************************************************************************
  * Public Functions
  ****************************************************************************/
@@ -95,11 +110,26 @@ void sched_resume_scheduler(FAR struct tcb_s *tcb)
     }
 #endif
 
+#ifdef CONFIG_TLS_CURRENT
+  /* The TLS information sits at the bottom of the stack allocation */
+
+  g_tls_current[this_cpu()] = (FAR struct tls_info_s *)tcb->stack_alloc_ptr;
+#endif
+
+#ifdef CONFIG_ARCH_STACKGUARD
+  /* Protect the bottom of the stack of the thread against overflow */
+
+  up_stackguard(tcb);
+#endif
+
   /* Indicate the task has been resumed */
 
 #ifdef CONFIG_SCHED_CRITMONITOR
   sched_critmon_resume(tcb);
 #endif
+#ifdef CONFIG_SCHED_LATENCY
+  sched_latency_resume(tcb);
+#endif
 #ifdef CONFIG_SCHED_INSTRUMENTATION
   sched_note_resume(tcb);
 #endif
@@ -219,6 +219,24 @@ int nxsched_setparam(pid_t pid, FAR const struct sched_param *param)
     }
 #endif
 
+#ifdef CONFIG_SCHED_DEADLINE
+  /* Replace the reservation of a SCHED_DEADLINE thread */
+
+  if ((tcb->flags & TCB_FLAG_POLICY_MASK) == TCB_FLAG_SCHED_DEADLINE)
+    {
+      irqstate_t flags;
+
+      flags = enter_critical_section();
+      ret = sched_deadline_admit(tcb, param);
+      leave_critical_section(flags);
+
+      if (ret < 0)
+        {
+          goto errout_with_lock;
+        }
+    }
+#endif
+
   /* Then perform the reprioritization */
 
   ret = nxsched_reprioritize(tcb, param->sched_priority);
@@ -165,9 +165,19 @@ static inline void nxsched_running_setpriority(FAR struct tcb_s *tcb,
 
   else
     {
+#if defined(CONFIG_SCHED_PRIOBITMAP) && !defined(CONFIG_SMP)
+      /* The task stays at the head of the g_readytorun list, but the
+       * priority index of the list must follow the change.
+       */
+
+      sched_removeprioritized(tcb, (FAR dq_queue_t *)&g_readytorun);
+      tcb->sched_priority = (uint8_t)sched_priority;
+      sched_addprioritized(tcb, (FAR dq_queue_t *)&g_readytorun);
+#else
       /* Change the task priority */
 
       tcb->sched_priority = (uint8_t)sched_priority;
+#endif
     }
 }
 
@@ -203,7 +213,7 @@ static void nxsched_readytorun_setpriority(FAR struct tcb_s *tcb,
 
   if (tcb->task_state == TSTATE_TASK_READYTORUN)
     {
-      cpu = sched_cpu_select(tcb->affinity);
+      cpu = sched_cpu_select(tcb->affinity, tcb->cpu);
     }
 
   /* CASE 2b.  The task is ready to run, and assigned to a CPU.  An increase
@@ -298,7 +308,7 @@ static inline void nxsched_blocked_setpriority(FAR struct tcb_s *tcb,
     {
       /* Remove the TCB from the prioritized task list */
 
-      dq_rem((FAR dq_entry_t *)tcb, tasklist);
+      sched_removeprioritized(tcb, tasklist);
 
       /* Change the task priority */
 
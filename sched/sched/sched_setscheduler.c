@@ -77,7 +77,8 @@
  * Input Parameters:
  *   pid - the task ID of the task to modify.  If pid is zero, the calling
  *      task is modified.
- *   policy - Scheduling policy requested (either SCHED_FIFO or SCHED_RR)
+ *   policy - Scheduling policy requested (SCHED_FIFO, SCHED_RR,
+ *      SCHED_SPORADIC or SCHED_DEADLINE)
  *   param - A structure whose member sched_priority is the new priority.
  *      The range of valid priority numbers is from SCHED_PRIORITY_MIN
  *      through SCHED_PRIORITY_MAX.
@@ -88,6 +89,7 @@
  *
  *   EINVAL The scheduling policy is not one of the recognized policies.
  *   ESRCH  The task whose ID is pid could not be found.
+ *   EBUSY  A SCHED_DEADLINE reservation failed admission control.
  *
  ****************************************************************************/
 
@@ -106,6 +108,9 @@ int nxsched_setscheduler(pid_t pid, int policy,
 #endif
 #ifdef CONFIG_SCHED_SPORADIC
       && policy != SCHED_SPORADIC
+#endif
+#ifdef CONFIG_SCHED_DEADLINE
+      && policy != SCHED_DEADLINE
 #endif
      )
     {
@@ -136,6 +141,28 @@ int nxsched_setscheduler(pid_t pid, int policy,
   /* Further, disable timer interrupts while we set up scheduling policy. */
 
   flags = enter_critical_section();
+
+#ifdef CONFIG_SCHED_DEADLINE
+  if (policy == SCHED_DEADLINE)
+    {
+      /* Admit the reservation first so that a rejected request leaves the
+       * current policy in place.
+       */
+
+      ret = sched_deadline_admit(tcb, param);
+      if (ret < 0)
+        {
+          goto errout_with_irq;
+        }
+    }
+  else if ((tcb->flags & TCB_FLAG_POLICY_MASK) == TCB_FLAG_SCHED_DEADLINE)
+    {
+      /* Release the bandwidth of the current reservation */
+
+      sched_deadline_stop(tcb);
+    }
+#endif
+
   tcb->flags &= ~TCB_FLAG_POLICY_MASK;
   switch (policy)
     {
@@ -157,7 +184,8 @@ int nxsched_setscheduler(pid_t pid, int policy,
           /* Save the FIFO scheduling parameters */
 
           tcb->flags       |= TCB_FLAG_SCHED_FIFO;
-#if CONFIG_RR_INTERVAL > 0 || defined(CONFIG_SCHED_SPORADIC)
+#if CONFIG_RR_INTERVAL > 0 || defined(CONFIG_SCHED_SPORADIC) || \
+    defined(CONFIG_SCHED_DEADLINE)
           tcb->timeslice    = 0;
 #endif
         }
@@ -274,6 +302,16 @@ int nxsched_setscheduler(pid_t pid, int policy,
         break;
 #endif
 
+#ifdef CONFIG_SCHED_DEADLINE
+      case SCHED_DEADLINE:
+        {
+          /* The reservation was admitted above */
+
+          tcb->flags |= TCB_FLAG_SCHED_DEADLINE;
+        }
+        break;
+#endif
+
 #if 0 /* Not supported */
       case SCHED_OTHER:
         tcb->flags    |= TCB_FLAG_SCHED_OTHER;
@@ -289,7 +327,7 @@ int nxsched_setscheduler(pid_t pid, int policy,
   sched_unlock();
   return ret;
 
-#ifdef CONFIG_SCHED_SPORADIC
+#if defined(CONFIG_SCHED_SPORADIC) || defined(CONFIG_SCHED_DEADLINE)
 errout_with_irq:
   leave_critical_section(flags);
   sched_unlock();
@@ -312,7 +350,8 @@ errout_with_irq:
  * Input Parameters:
  *   pid - the task ID of the task to modify.  If pid is zero, the calling
  *      task is modified.
- *   policy - Scheduling policy requested (either SCHED_FIFO or SCHED_RR)
+ *   policy - Scheduling policy requested (SCHED_FIFO, SCHED_RR,
+ *      SCHED_SPORADIC or SCHED_DEADLINE)
  *   param - A structure whose member sched_priority is the new priority.
  *      The range of valid priority numbers is from SCHED_PRIORITY_MIN
  *      through SCHED_PRIORITY_MAX.
@@ -323,6 +362,7 @@ errout_with_irq:
  *
  *   EINVAL The scheduling policy is not one of the recognized policies.
  *   ESRCH  The task whose ID is pid could not be found.
+ *   EBUSY  A SCHED_DEADLINE reservation failed admission control.
  *
  ****************************************************************************/
 
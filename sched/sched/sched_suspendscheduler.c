@@ -88,6 +88,9 @@ void sched_suspend_scheduler(FAR struct tcb_s *tcb)
 #ifdef CONFIG_SCHED_CRITMONITOR
   sched_critmon_suspend(tcb);
 #endif
+#ifdef CONFIG_SCHED_CPULOAD_CYCLES
+  sched_cpuload_suspend(tcb);
+#endif
 #ifdef CONFIG_SCHED_INSTRUMENTATION
   sched_note_suspend(tcb);
 #endif
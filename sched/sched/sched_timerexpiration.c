@@ -117,11 +117,13 @@ uint32_t g_oneshot_maxticks = UINT32_MAX;
  * Private Function Prototypes
  ****************************************************************************/
 
-#if CONFIG_RR_INTERVAL > 0 || defined(CONFIG_SCHED_SPORADIC)
+#if CONFIG_RR_INTERVAL > 0 || defined(CONFIG_SCHED_SPORADIC) || \
+    defined(CONFIG_SCHED_DEADLINE)
 static uint32_t nxsched_cpu_scheduler(int cpu, uint32_t ticks,
                                       bool noswitches);
 #endif
-#if CONFIG_RR_INTERVAL > 0 || defined(CONFIG_SCHED_SPORADIC)
+#if CONFIG_RR_INTERVAL > 0 || defined(CONFIG_SCHED_SPORADIC) || \
+    defined(CONFIG_SCHED_DEADLINE)
 static uint32_t nxsched_process_scheduler(uint32_t ticks, bool noswitches);
 #endif
 static unsigned int nxsched_timer_process(unsigned int ticks,
@@ -183,7 +185,8 @@ static struct timespec g_sched_time;
  *
  ****************************************************************************/
 
-#if CONFIG_RR_INTERVAL > 0 || defined(CONFIG_SCHED_SPORADIC)
+#if CONFIG_RR_INTERVAL > 0 || defined(CONFIG_SCHED_SPORADIC) || \
+    defined(CONFIG_SCHED_DEADLINE)
 static uint32_t nxsched_cpu_scheduler(int cpu, uint32_t ticks,
                                       bool noswitches)
 {
@@ -231,6 +234,17 @@ static uint32_t nxsched_cpu_scheduler(int cpu, uint32_t ticks,
     }
 #endif
 
+#ifdef CONFIG_SCHED_DEADLINE
+  /* Check if the currently executing task uses deadline scheduling. */
+
+  if ((rtcb->flags & TCB_FLAG_POLICY_MASK) == TCB_FLAG_SCHED_DEADLINE)
+    {
+      /* Yes, charge the elapsed time to its budget */
+
+      ret = sched_deadline_process(rtcb, ticks, noswitches);
+    }
+#endif
+
   /* If a context switch occurred, then need to return delay remaining for
    * the new task at the head of the ready to run list.
    */
@@ -285,7 +299,8 @@ static uint32_t nxsched_cpu_scheduler(int cpu, uint32_t ticks,
  *
  ****************************************************************************/
 
-#if CONFIG_RR_INTERVAL > 0 || defined(CONFIG_SCHED_SPORADIC)
+#if CONFIG_RR_INTERVAL > 0 || defined(CONFIG_SCHED_SPORADIC) || \
+    defined(CONFIG_SCHED_DEADLINE)
 static uint32_t nxsched_process_scheduler(uint32_t ticks, bool noswitches)
 {
 #ifdef CONFIG_SMP
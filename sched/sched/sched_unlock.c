@@ -115,19 +115,11 @@ int sched_unlock(void)
           /* Set the lock count to zero */
 
           rtcb->lockcount = 0;
-
-          /* The lockcount has decremented to zero and we need to perform
-           * release our hold on the lock.
-           */
-
-          DEBUGASSERT(g_cpu_schedlock == SP_LOCKED &&
-                      (g_cpu_lockset & (1 << cpu)) != 0);
-
-          spin_clrbit(&g_cpu_lockset, cpu, &g_cpu_locksetlock,
-                      &g_cpu_schedlock);
+          DEBUGASSERT(rtcb->glockcount == 0);
 
           /* Release any ready-to-run tasks that have collected in
-           * g_pendingtasks.
+           * g_pendingtasks.  This includes the tasks that were deferred
+           * because they would have pre-empted this CPU.
            *
            * NOTE: This operation has a very high likelihood of causing
            * this task to be switched out!
@@ -135,7 +127,7 @@ int sched_unlock(void)
 
           /* In the SMP case, the tasks remains pend(1) if we are
            * in a critical section, i.e., g_cpu_irqlock is locked by other
-           * CPUs, or (2) other CPUs still have pre-emption disabled, i.e.,
+           * CPUs, or (2) other CPUs hold the global scheduler lock, i.e.,
            * g_cpu_schedlock is locked.  In those cases, the release of the
            * pending tasks must be deferred until those conditions are met.
            *
@@ -220,6 +212,28 @@ int sched_unlock(void)
 #endif
             }
 #endif
+
+#ifdef CONFIG_SCHED_DEADLINE
+          /* If (1) the task that was running uses deadline scheduling and
+           * (2) its budget has already been exhausted, but (3) its deadline
+           * could not be postponed because pre-emption was disabled, then
+           * postpone the deadline now.  This may also swap the task out if
+           * another deadline task now has the earlier deadline.
+           */
+
+          if ((rtcb->flags & TCB_FLAG_POLICY_MASK) ==
+              TCB_FLAG_SCHED_DEADLINE && rtcb->timeslice <= 0)
+            {
+              sched_deadline_replenish(rtcb);
+
+#ifdef CONFIG_SCHED_TICKLESS
+              if (rtcb == current_task(cpu))
+                {
+                  sched_timer_reassess();
+                }
+#endif
+            }
+#endif
         }
 
       leave_critical_section(flags);
@@ -228,6 +242,54 @@ int sched_unlock(void)
   return OK;
 }
 
+/****************************************************************************
+ * Name:  sched_unlock_global
+ *
+ * Description:
+ *   This function undoes one sched_lock_global().  When the last global
+ *   lock of this thread is released, the other CPUs may start new tasks
+ *   again.  Pre-emption on this CPU is then re-enabled as by
+ *   sched_unlock().
+ *
+ ****************************************************************************/
+
+int sched_unlock_global(void)
+{
+  FAR struct tcb_s *rtcb;
+  irqstate_t flags;
+  int cpu;
+
+  cpu  = this_cpu();
+  rtcb = current_task(cpu);
+
+  if (rtcb != NULL && !up_interrupt_context())
+    {
+      flags = enter_critical_section();
+
+      DEBUGASSERT(rtcb->glockcount > 0 &&
+                  rtcb->glockcount <= rtcb->lockcount);
+
+      if (rtcb->glockcount > 0 && --rtcb->glockcount == 0)
+        {
+          /* Release our hold on the global lock */
+
+          DEBUGASSERT(g_cpu_schedlock == SP_LOCKED &&
+                      (g_cpu_lockset & (1 << cpu)) != 0);
+
+          spin_clrbit(&g_cpu_lockset, cpu, &g_cpu_locksetlock,
+                      &g_cpu_schedlock);
+        }
+
+      leave_critical_section(flags);
+    }
+
+  /* sched_unlock() releases the pending tasks once pre-emption is enabled
+   * on this CPU.
+   */
+
+  return sched_unlock();
+}
+
 #else /* CONFIG_SMP */
 
 int sched_unlock(void)
@@ -351,6 +413,28 @@ int sched_unlock(void)
 #endif
             }
 #endif
+
+#ifdef CONFIG_SCHED_DEADLINE
+          /* If (1) the task that was running uses deadline scheduling and
+           * (2) its budget has already been exhausted, but (3) its deadline
+           * could not be postponed because pre-emption was disabled, then
+           * postpone the deadline now.  This may also swap the task out if
+           * another deadline task now has the earlier deadline.
+           */
+
+          if ((rtcb->flags & TCB_FLAG_POLICY_MASK) ==
+              TCB_FLAG_SCHED_DEADLINE && rtcb->timeslice <= 0)
+            {
+              sched_deadline_replenish(rtcb);
+
+#ifdef CONFIG_SCHED_TICKLESS
+              if (rtcb == this_task())
+                {
+                  sched_timer_reassess();
+                }
+#endif
+            }
+#endif
         }
 
       leave_critical_section(flags);
@@ -60,6 +60,15 @@
 #  define CONFIG_SEM_PREALLOCHOLDERS 0
 #endif
 
+/* Boosts are only passed along a chain of holders when the priority to
+ * restore is recomputed from the held semaphores (no nesting records).
+ */
+
+#if !defined(CONFIG_SEM_PIDEPTH) || CONFIG_SEM_NNESTPRIO > 0
+#  undef CONFIG_SEM_PIDEPTH
+#  define CONFIG_SEM_PIDEPTH 0
+#endif
+
 /****************************************************************************
  * Private Type Declarations
  ****************************************************************************/
@@ -92,37 +101,53 @@ static inline FAR struct semholder_s *nxsem_allocholder(sem_t *sem)
    */
 
 #if CONFIG_SEM_PREALLOCHOLDERS > 0
-  pholder = g_freeholders;
+  if (sem->holder.htcb == NULL)
+    {
+      pholder          = &sem->holder;
+    }
+  else
+    {
+      /* Otherwise, take a holder from the free list */
+
+      pholder          = g_freeholders;
+      if (pholder != NULL)
+        {
+          g_freeholders = pholder->flink;
+        }
+    }
+
   if (pholder != NULL)
     {
-      /* Remove the holder from the free list an put it into the semaphore's
-       * holder list
-       */
+      /* Put the holder into the semaphore's holder list */
 
-      g_freeholders    = pholder->flink;
       pholder->flink   = sem->hhead;
       sem->hhead       = pholder;
-
-      /* Make sure the initial count is zero */
-
-      pholder->counts  = 0;
     }
 #else
   if (sem->holder[0].htcb == NULL)
     {
       pholder          = &sem->holder[0];
-      pholder->counts  = 0;
     }
   else if (sem->holder[1].htcb == NULL)
     {
       pholder          = &sem->holder[1];
-      pholder->counts  = 0;
+    }
+  else
+    {
+      pholder          = NULL;
     }
 #endif
+
+  if (pholder != NULL)
+    {
+      /* Make sure the initial count is zero */
+
+      pholder->sem     = sem;
+      pholder->counts  = 0;
+    }
   else
     {
       serr("ERROR: Insufficient pre-allocated holders\n");
-      pholder          = NULL;
     }
 
   DEBUGASSERT(pholder != NULL);
@@ -139,6 +164,15 @@ static FAR struct semholder_s *nxsem_findholder(sem_t *sem,
   FAR struct semholder_s *pholder;
 
 #if CONFIG_SEM_PREALLOCHOLDERS > 0
+  /* The built-in holder is checked first so that a mutex is found without
+   * walking the list.
+   */
+
+  if (sem->holder.htcb == htcb)
+    {
+      return &sem->holder;
+    }
+
   /* Try to find the holder in the list of holders associated with this
    * semaphore
    */
@@ -195,16 +229,37 @@ nxsem_findorallocateholder(sem_t *sem, FAR struct tcb_s *htcb)
  * Name: nxsem_freeholder
  ****************************************************************************/
 
-static inline void nxsem_freeholder(sem_t *sem,
-                                    FAR struct semholder_s *pholder)
+static void nxsem_freeholder(sem_t *sem, FAR struct semholder_s *pholder)
 {
-#if CONFIG_SEM_PREALLOCHOLDERS > 0
   FAR struct semholder_s *curr;
   FAR struct semholder_s *prev;
-#endif
+
+  /* Remove the holder from the list of semaphores held by the thread.  The
+   * holder TCB is cleared before calling here if the TCB is stale.
+   */
+
+  if (pholder->htcb != NULL)
+    {
+      for (prev = NULL, curr = pholder->htcb->holdsems;
+           curr && curr != pholder;
+           prev = curr, curr = curr->tlink);
+
+      if (curr != NULL)
+        {
+          if (prev != NULL)
+            {
+              prev->tlink = pholder->tlink;
+            }
+          else
+            {
+              pholder->htcb->holdsems = pholder->tlink;
+            }
+        }
+    }
 
   /* Release the holder and counts */
 
+  pholder->tlink  = NULL;
   pholder->htcb   = NULL;
   pholder->counts = 0;
 
@@ -228,10 +283,13 @@ static inline void nxsem_freeholder(sem_t *sem,
           sem->hhead = pholder->flink;
         }
 
-      /* And put it in the free list */
+      /* And put it in the free list, unless it is the built-in holder */
 
-      pholder->flink = g_freeholders;
-      g_freeholders  = pholder;
+      if (pholder != &sem->holder)
+        {
+          pholder->flink = g_freeholders;
+          g_freeholders  = pholder;
+        }
     }
 #endif
 }
@@ -311,13 +369,88 @@ static int nxsem_foreachholder(FAR sem_t *sem, holderhandler_t handler,
  * Name: nxsem_recoverholders
  ****************************************************************************/
 
-#if CONFIG_SEM_PREALLOCHOLDERS > 0
 static int nxsem_recoverholders(FAR struct semholder_s *pholder,
                                 FAR sem_t *sem, FAR void *arg)
 {
   nxsem_freeholder(sem, pholder);
   return 0;
 }
+
+/****************************************************************************
+ * Name: nxsem_soleholder
+ *
+ * Description:
+ *   Return the TCB of the only holder of the semaphore, or NULL if there is
+ *   no holder or more than one.
+ *
+ ****************************************************************************/
+
+#if CONFIG_SEM_PIDEPTH > 0
+static FAR struct tcb_s *nxsem_soleholder(FAR sem_t *sem)
+{
+#if CONFIG_SEM_PREALLOCHOLDERS > 0
+  if (sem->hhead != NULL && sem->hhead->flink == NULL)
+    {
+      return sem->hhead->htcb;
+    }
+#else
+  if (sem->holder[0].htcb == NULL)
+    {
+      return sem->holder[1].htcb;
+    }
+  else if (sem->holder[1].htcb == NULL)
+    {
+      return sem->holder[0].htcb;
+    }
+#endif
+
+  return NULL;
+}
+#endif
+
+/****************************************************************************
+ * Name: nxsem_holderprio
+ *
+ * Description:
+ *   Return the priority that the holder thread still needs:  Its base
+ *   priority or the priority of the highest priority thread waiting on any
+ *   semaphore that it holds counts on, whichever is higher.  stcb is not
+ *   counted as a waiter; it received the count or gave up waiting.
+ *
+ ****************************************************************************/
+
+#if CONFIG_SEM_NNESTPRIO == 0
+static int nxsem_holderprio(FAR struct tcb_s *htcb, FAR struct tcb_s *stcb)
+{
+  FAR struct semholder_s *pholder;
+  FAR struct tcb_s *wtcb;
+  int priority = htcb->base_priority;
+
+  for (pholder = htcb->holdsems; pholder != NULL; pholder = pholder->tlink)
+    {
+      if (pholder->counts <= 0)
+        {
+          continue;
+        }
+
+      /* The waiting list is prioritized so the search can stop at the
+       * first waiter that would not raise the priority.
+       */
+
+      for (wtcb = (FAR struct tcb_s *)g_waitingforsemaphore.head;
+           wtcb != NULL && wtcb->sched_priority > priority;
+           wtcb = wtcb->flink)
+        {
+          if (wtcb != stcb && wtcb->waitsem == pholder->sem)
+            {
+              priority = wtcb->sched_priority;
+              break;
+            }
+        }
+    }
+
+  return priority;
+}
 #endif
 
 /****************************************************************************
@@ -342,6 +475,7 @@ static int nxsem_boostholderprio(FAR struct semholder_s *pholder,
       serr("ERROR: TCB 0x%08x is a stale handle, counts lost\n", htcb);
       DEBUGPANIC();
 #endif
+      pholder->htcb = NULL;
       nxsem_freeholder(sem, pholder);
     }
 
@@ -486,9 +620,9 @@ static int nxsem_restoreholderprio(FAR struct tcb_s *htcb,
                                    FAR sem_t *sem, FAR void *arg)
 {
   FAR struct semholder_s *pholder = 0;
-#if CONFIG_SEM_NNESTPRIO > 0
   FAR struct tcb_s *stcb = (FAR struct tcb_s *)arg;
   int rpriority;
+#if CONFIG_SEM_NNESTPRIO > 0
   int i;
   int j;
 #endif
@@ -506,6 +640,7 @@ static int nxsem_restoreholderprio(FAR struct tcb_s *htcb,
       pholder = nxsem_findholder(sem, htcb);
       if (pholder != NULL)
         {
+          pholder->htcb = NULL;
           nxsem_freeholder(sem, pholder);
         }
     }
@@ -614,12 +749,20 @@ static int nxsem_restoreholderprio(FAR struct tcb_s *htcb,
             }
         }
 #else
-      /* There is no alternative restore priorities, drop the priority
-       * of the holder thread all the way back to the threads "base"
-       * priority.
+      /* There is no record of the nested boosts.  If the holder runs above
+       * the thread that received the count, then the boost came from some
+       * other semaphore and it is kept.  Otherwise, find the priority that
+       * the holder still needs from its list of held semaphores.
        */
 
-      nxsched_reprioritize(htcb, htcb->base_priority);
+      if (stcb == NULL || htcb->sched_priority <= stcb->sched_priority)
+        {
+          rpriority = nxsem_holderprio(htcb, stcb);
+          if (rpriority != htcb->sched_priority)
+            {
+              nxsched_setpriority(htcb, rpriority);
+            }
+        }
 #endif
     }
 
@@ -908,24 +1051,16 @@ void nxsem_destroyholder(FAR sem_t *sem)
    */
 
 #if CONFIG_SEM_PREALLOCHOLDERS > 0
-  if (sem->hhead != NULL)
-    {
-      /* There may be an issue if there are multiple holders of
-       * the semaphore.
-       */
-
-      DEBUGASSERT(sem->hhead->flink == NULL);
-      nxsem_foreachholder(sem, nxsem_recoverholders, NULL);
-    }
-
-#else
   /* There may be an issue if there are multiple holders of the semaphore. */
 
+  DEBUGASSERT(sem->hhead == NULL || sem->hhead->flink == NULL);
+#else
   DEBUGASSERT(sem->holder[0].htcb == NULL || sem->holder[1].htcb == NULL);
-
-  sem->holder[0].htcb = NULL;
-  sem->holder[1].htcb = NULL;
 #endif
+
+  /* Freeing the holders also removes them from the holder threads' lists */
+
+  nxsem_foreachholder(sem, nxsem_recoverholders, NULL);
 }
 
 /****************************************************************************
@@ -963,11 +1098,19 @@ void nxsem_addholder_tcb(FAR struct tcb_s *htcb, FAR sem_t *sem)
       pholder = nxsem_findorallocateholder(sem, htcb);
       if (pholder != NULL)
         {
-          /* Then set the holder and increment the number of counts held by this
-           * holder
+          /* A new holder is also added to the list of semaphores held by
+           * the thread.
            */
 
-          pholder->htcb = htcb;
+          if (pholder->htcb == NULL)
+            {
+              pholder->htcb  = htcb;
+              pholder->tlink = htcb->holdsems;
+              htcb->holdsems = pholder;
+            }
+
+          /* Then increment the number of counts held by this holder */
+
           pholder->counts++;
         }
     }
@@ -1014,6 +1157,10 @@ void nxsem_addholder(FAR sem_t *sem)
 void nxsem_boostpriority(FAR sem_t *sem)
 {
   FAR struct tcb_s *rtcb = this_task();
+#if CONFIG_SEM_PIDEPTH > 0
+  FAR struct tcb_s *htcb;
+  int depth;
+#endif
 
   /* Boost the priority of every thread holding counts on this semaphore
    * that are lower in priority than the new thread that is waiting for a
@@ -1021,6 +1168,33 @@ void nxsem_boostpriority(FAR sem_t *sem)
    */
 
   nxsem_foreachholder(sem, nxsem_boostholderprio, rtcb);
+
+#if CONFIG_SEM_PIDEPTH > 0
+  /* If the only holder is itself waiting for another semaphore, pass the
+   * boost on to the holder of that semaphore, and so on.  The walk stops
+   * at the first holder that already runs at the boosted priority and
+   * after CONFIG_SEM_PIDEPTH links (which also ends a deadlock cycle).
+   */
+
+  for (depth = 0; depth < CONFIG_SEM_PIDEPTH; depth++)
+    {
+      htcb = nxsem_soleholder(sem);
+      if (htcb == NULL || htcb->task_state != TSTATE_WAIT_SEM ||
+          htcb->waitsem == NULL)
+        {
+          break;
+        }
+
+      sem  = htcb->waitsem;
+      htcb = nxsem_soleholder(sem);
+      if (htcb == NULL || htcb->sched_priority >= rtcb->sched_priority)
+        {
+          break;
+        }
+
+      nxsem_foreachholder(sem, nxsem_boostholderprio, rtcb);
+    }
+#endif
 }
 
 /****************************************************************************
@@ -1148,6 +1322,35 @@ void nxsem_canceled(FAR struct tcb_s *stcb, FAR sem_t *sem)
   nxsem_foreachholder(sem, nxsem_restoreholderprioall, stcb);
 }
 
+/****************************************************************************
+ * Name: nxsem_release_all
+ *
+ * Description:
+ *   Called from nxsem_recover() when a thread exits or is deleted.  Free
+ *   the holder containers of every semaphore that the thread still holds
+ *   counts on.  The counts themselves are not returned.
+ *
+ * Input Parameters:
+ *   htcb - The TCB of the exiting thread
+ *
+ * Returned Value:
+ *   None
+ *
+ * Assumptions:
+ *   Interrupts are disabled.
+ *
+ ****************************************************************************/
+
+void nxsem_release_all(FAR struct tcb_s *htcb)
+{
+  FAR struct semholder_s *pholder;
+
+  while ((pholder = htcb->holdsems) != NULL)
+    {
+      nxsem_freeholder(pholder->sem, pholder);
+    }
+}
+
 /****************************************************************************
  * Name: sem_enumholders
  *
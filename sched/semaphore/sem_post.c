@@ -93,6 +93,15 @@ int nxsem_post(FAR sem_t *sem)
 
   if (sem != NULL)
     {
+      /* If there are no waiters, just release the count without entering
+       * the critical section.
+       */
+
+      if (nxsem_fastpost(sem))
+        {
+          return OK;
+        }
+
       /* The following operations must be performed with interrupts
        * disabled because sem_post() may be called from an interrupt
        * handler.
@@ -162,6 +171,7 @@ int nxsem_post(FAR sem_t *sem)
 
               /* Restart the waiting task. */
 
+              sched_latency_wakeup(stcb);
               up_unblock_task(stcb);
             }
 #if 0 /* REVISIT:  This can fire on IOB throttle semaphore */
@@ -53,16 +53,14 @@
  * Name: nxsem_recover
  *
  * Description:
- *   This function is called from nxtask_recover() when a task is deleted via
- *   task_delete() or via pthread_cancel().  It current only checks on the
+ *   This function is called from nxtask_recover() when a task exits or is
+ *   deleted via task_delete() or via pthread_cancel().  It checks on the
  *   case where a task is waiting for semaphore at the time that is was
- *   killed.
+ *   killed and, with priority inheritance, frees the holder containers of
+ *   the semaphores that the task holds.
  *
- *   REVISIT:  A more complete implementation would release counts on all
- *   semaphores held by the thread.  That would, however, require some
- *   significant extension to the semaphore data structures because given
- *   only the task, there is not mechanism to traverse all of the semaphores
- *   with counts held by the task.
+ *   REVISIT:  A more complete implementation would also release the counts
+ *   on all semaphores held by the thread.
  *
  * Input Parameters:
  *   tcb - The TCB of the terminated task or thread
@@ -121,5 +119,8 @@ void nxsem_recover(FAR struct tcb_s *tcb)
       tcb->waitsem = NULL;
     }
 
+  /* Forget the thread as a holder so that no holder refers to a stale TCB */
+
+  nxsem_release_all(tcb);
   leave_critical_section(flags);
 }
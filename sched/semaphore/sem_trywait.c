@@ -89,6 +89,13 @@ int nxsem_trywait(FAR sem_t *sem)
 
   if (sem != NULL)
     {
+      /* Take an uncontended count without entering the critical section */
+
+      if (nxsem_fastwait(sem))
+        {
+          return OK;
+        }
+
       /* The following operations must be performed with interrupts disabled
        * because sem_post() may be called from an interrupt handler.
        */
@@ -92,6 +92,13 @@ int nxsem_wait(FAR sem_t *sem)
 
   DEBUGASSERT(sem != NULL && up_interrupt_context() == false);
 
+  /* Take an uncontended count without entering the critical section */
+
+  if (sem != NULL && nxsem_fastwait(sem))
+    {
+      return OK;
+    }
+
   /* The following operations must be performed with interrupts
    * disabled because nxsem_post() may be called from an interrupt
    * handler.
@@ -45,6 +45,7 @@
 #include <nuttx/irq.h>
 #include <nuttx/arch.h>
 
+#include "sched/sched.h"
 #include "semaphore/semaphore.h"
 
 /****************************************************************************
@@ -121,6 +122,7 @@ void nxsem_wait_irq(FAR struct tcb_s *wtcb, int errcode)
 
       /* Restart the task. */
 
+      sched_latency_wakeup(wtcb);
       up_unblock_task(wtcb);
     }
 
@@ -94,6 +94,7 @@ void nxsem_boostpriority(FAR sem_t *sem);
 void nxsem_releaseholder(FAR sem_t *sem);
 void nxsem_restorebaseprio(FAR struct tcb_s *stcb, FAR sem_t *sem);
 void nxsem_canceled(FAR struct tcb_s *stcb, FAR sem_t *sem);
+void nxsem_release_all(FAR struct tcb_s *htcb);
 #else
 #  define nxsem_initholders()
 #  define nxsem_destroyholder(sem)
@@ -103,6 +104,7 @@ void nxsem_canceled(FAR struct tcb_s *stcb, FAR sem_t *sem);
 #  define nxsem_releaseholder(sem)
 #  define nxsem_restorebaseprio(stcb,sem)
 #  define nxsem_canceled(stcb,sem)
+#  define nxsem_release_all(htcb)
 #endif
 
 #undef EXTERN
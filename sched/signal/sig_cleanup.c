@@ -39,6 +39,7 @@
 
 #include <nuttx/config.h>
 #include <nuttx/arch.h>
+#include <nuttx/kmalloc.h>
 
 #include "signal/signal.h"
 
@@ -107,6 +108,18 @@ void nxsig_release(FAR struct task_group_s *group)
 
   while ((sigpend = (FAR sigpendq_t *)sq_remfirst(&group->tg_sigpendingq)) != NULL)
     {
-      nxsig_release_pendingsignal(sigpend);
+      nxsig_release_pendingsignal(group, sigpend);
     }
+
+#if CONFIG_SIG_GROUP_NPENDING > 0
+  /* Free the pending signals reserved for the group.  All of them are now
+   * back on the group free list.
+   */
+
+  if (group->tg_sigpendpool != NULL)
+    {
+      sched_kfree(group->tg_sigpendpool);
+      group->tg_sigpendpool = NULL;
+    }
+#endif
 }
@@ -580,9 +580,9 @@ _sa_handler_t nxsig_default(FAR struct tcb_s *tcb, int signo, bool defaction)
         {
           /* sigaddset() is not atomic (but neither is sigaction()) */
 
-          flags = spin_lock_irqsave();
+          flags = spin_lock_irqsave(NULL);
           sigaddset(&group->tg_sigdefault, signo);
-          spin_unlock_irqrestore(flags);
+          spin_unlock_irqrestore(NULL, flags);
         }
     }
 
@@ -592,9 +592,9 @@ _sa_handler_t nxsig_default(FAR struct tcb_s *tcb, int signo, bool defaction)
        * atomic (but neither is sigaction()).
        */
 
-      flags = spin_lock_irqsave();
+      flags = spin_lock_irqsave(NULL);
       sigdelset(&group->tg_sigdefault, signo);
-      spin_unlock_irqrestore(flags);
+      spin_unlock_irqrestore(NULL, flags);
     }
 
   return handler;
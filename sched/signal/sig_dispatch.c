@@ -91,6 +91,35 @@ static int nxsig_queue_action(FAR struct tcb_s *stcb, siginfo_t *info)
 
   if ((sigact) && (sigact->act.sa_u._sa_sigaction))
     {
+      /* A timer expiration that is already queued for the same timer and
+       * not yet delivered is not queued again:  Only a single instance of
+       * a timer signal may be pending at a time.  This also keeps a fast,
+       * periodic timer from exhausting the pending action pool.
+       */
+
+      if (info->si_code == SI_TIMER)
+        {
+          flags = enter_critical_section();
+          for (sigq = (FAR sigq_t *)stcb->sigpendactionq.head;
+               sigq != NULL;
+               sigq = sigq->flink)
+            {
+              if (sigq->info.si_signo == info->si_signo &&
+                  sigq->info.si_code == SI_TIMER &&
+                  sigq->info.si_value.sival_ptr == info->si_value.sival_ptr)
+                {
+                  break;
+                }
+            }
+
+          leave_critical_section(flags);
+          if (sigq != NULL)
+            {
+              sched_unlock();
+              return OK;
+            }
+        }
+
       /* Allocate a new element for the signal queue.  NOTE:
        * nxsig_alloc_pendingsigaction will force a system crash if it is
        * unable to allocate memory for the signal data.
@@ -125,15 +154,32 @@ static int nxsig_queue_action(FAR struct tcb_s *stcb, siginfo_t *info)
  * Name: nxsig_alloc_pendingsignal
  *
  * Description:
- *   Allocate a pending signal list entry
+ *   Allocate a pending signal list entry.  The entries reserved for the
+ *   receiving task group are used first.
  *
  ****************************************************************************/
 
-static FAR sigpendq_t *nxsig_alloc_pendingsignal(void)
+static FAR sigpendq_t *
+nxsig_alloc_pendingsignal(FAR struct task_group_s *group)
 {
   FAR sigpendq_t *sigpend;
   irqstate_t      flags;
 
+#if CONFIG_SIG_GROUP_NPENDING > 0
+  /* Try the free list reserved for the group.  This is safe from
+   * interrupt handlers as well.
+   */
+
+  flags = enter_critical_section();
+  sigpend = (FAR sigpendq_t *)sq_remfirst(&group->tg_sigpendfree);
+  leave_critical_section(flags);
+
+  if (sigpend != NULL)
+    {
+      return sigpend;
+    }
+#endif
+
   /* Check if we were called from an interrupt handler. */
 
   if (up_interrupt_context())
@@ -254,7 +300,7 @@ static void nxsig_add_pendingsignal(FAR struct tcb_s *stcb,
     {
       /* Allocate a new pending signal entry */
 
-      sigpend = nxsig_alloc_pendingsignal();
+      sigpend = nxsig_alloc_pendingsignal(group);
       if (sigpend != NULL)
         {
           /* Put the signal information into the allocated structure */
@@ -309,6 +355,30 @@ int nxsig_tcbdispatch(FAR struct tcb_s *stcb, siginfo_t *info)
 
   DEBUGASSERT(stcb != NULL && info != NULL);
 
+  /************************ ACCEPTED SIGNAL HANDLING ***********************/
+
+  /* Check if the task is waiting for this signal in sigwaitinfo() or
+   * sigtimedwait().  If so, then hand the signal information directly to
+   * the waiter and unblock it.  The signal is accepted by the waiter, so
+   * no signal action is queued and no pending signal entry is needed.
+   * This must be performed in a critical section because signals can be
+   * queued from the interrupt level.
+   */
+
+  flags = enter_critical_section();
+  if (stcb->task_state == TSTATE_WAIT_SIG &&
+      sigismember(&stcb->sigwaitmask, info->si_signo))
+    {
+      memcpy(&stcb->sigunbinfo, info, sizeof(siginfo_t));
+      stcb->sigwaitmask = NULL_SIGNAL_SET;
+      sched_latency_wakeup(stcb);
+      up_unblock_task(stcb);
+      leave_critical_section(flags);
+      return OK;
+    }
+
+  leave_critical_section(flags);
+
   /************************* MASKED SIGNAL HANDLING ************************/
 
   /* Check if the signal is masked -- if it is, it will be added to the list
@@ -317,30 +387,7 @@ int nxsig_tcbdispatch(FAR struct tcb_s *stcb, siginfo_t *info)
 
   if (sigismember(&stcb->sigprocmask, info->si_signo))
     {
-      /* Check if the task is waiting for this pending signal.  If so, then
-       * unblock it.  This must be performed in a critical section because
-       * signals can be queued * from the interrupt level.
-       */
-
-      flags = enter_critical_section();
-      if (stcb->task_state == TSTATE_WAIT_SIG &&
-          sigismember(&stcb->sigwaitmask, info->si_signo))
-        {
-          memcpy(&stcb->sigunbinfo, info, sizeof(siginfo_t));
-          stcb->sigwaitmask = NULL_SIGNAL_SET;
-          up_unblock_task(stcb);
-          leave_critical_section(flags);
-        }
-
-      /* Its not one we are waiting for... Add it to the list of pending
-       * signals.
-       */
-
-      else
-        {
-          leave_critical_section(flags);
-          nxsig_add_pendingsignal(stcb, info);
-        }
+      nxsig_add_pendingsignal(stcb, info);
     }
 
   /************************ UNMASKED SIGNAL HANDLING ***********************/
@@ -371,6 +418,7 @@ int nxsig_tcbdispatch(FAR struct tcb_s *stcb, siginfo_t *info)
         {
           memcpy(&stcb->sigunbinfo, info, sizeof(siginfo_t));
           stcb->sigwaitmask = NULL_SIGNAL_SET;
+          sched_latency_wakeup(stcb);
           up_unblock_task(stcb);
         }
 
@@ -43,8 +43,10 @@
 #include <stdint.h>
 #include <queue.h>
 #include <assert.h>
+#include <errno.h>
 
 #include <nuttx/kmalloc.h>
+#include <nuttx/sched.h>
 
 #include "signal/signal.h"
 
@@ -58,17 +60,20 @@
 
 sq_queue_t  g_sigfreeaction;
 
-/* The g_sigpendingaction data structure is a list of available pending
- * signal action structures.
+/* The g_sigpendingaction pool holds the available pending signal action
+ * structures.  NUM_PENDING_INT_ACTIONS of these are reserved for use by
+ * interrupt handlers.  Normal tasks fall back to the kernel heap when the
+ * unreserved structures are exhausted.
  */
 
-sq_queue_t  g_sigpendingaction;
-
-/* The g_sigpendingirqaction is a list of available pending signal actions
- * that are reserved for use by interrupt handlers.
- */
-
-sq_queue_t  g_sigpendingirqaction;
+struct mempool_s g_sigpendingaction =
+{
+  sizeof(sigq_t),                                  /* bsize */
+  NUM_PENDING_ACTIONS + NUM_PENDING_INT_ACTIONS,   /* ninitial */
+  NUM_PENDING_INT_ACTIONS,                         /* nreserve */
+  true,                                            /* expand */
+  NULL                                             /* ibase */
+};
 
 /* The g_sigpendingsignal data structure is a list of available pending
  * signal structures.
@@ -93,18 +98,6 @@ sq_queue_t  g_sigpendingirqsignal;
 
 static sigactq_t  *g_sigactionalloc;
 
-/* g_sigpendingactionalloc is a pointer to the start of the allocated
- * blocks of pending signal actions.
- */
-
-static sigq_t     *g_sigpendingactionalloc;
-
-/* g_sigpendingirqactionalloc is a pointer to the start of the allocated
- * block of pending signal actions.
- */
-
-static sigq_t     *g_sigpendingirqactionalloc;
-
 /* g_sigpendingsignalalloc is a pointer to the start of the allocated
  * blocks of pending signals.
  */
@@ -121,8 +114,6 @@ static sigpendq_t *g_sigpendingirqsignalalloc;
  * Private Function Prototypes
  ****************************************************************************/
 
-static sigq_t     *nxsig_alloc_block(sq_queue_t *siglist, uint16_t nsigs,
-                                     uint8_t sigtype);
 static sigpendq_t *nxsig_alloc_pendingsignalblock(sq_queue_t *siglist,
                                                   uint16_t nsigs, uint8_t sigtype);
 
@@ -130,38 +121,6 @@ static sigpendq_t *nxsig_alloc_pendingsignalblock(sq_queue_t *siglist,
  * Private Functions
  ****************************************************************************/
 
-/****************************************************************************
- * Name: nxsig_alloc_block
- *
- * Description:
- *   Allocate a block of pending signal actions and place them
- *   on the free list.
- *
- ****************************************************************************/
-
-static FAR sigq_t *nxsig_alloc_block(sq_queue_t *siglist, uint16_t nsigs,
-                                     uint8_t sigtype)
-{
-  FAR sigq_t *sigqalloc;
-  FAR sigq_t *sigq;
-  int i;
-
-  /* Allocate a block of pending signal actions. */
-
-  sigqalloc = (FAR sigq_t *)kmm_malloc((sizeof(sigq_t)) * nsigs);
-  if (sigqalloc != NULL)
-    {
-      sigq = sigqalloc;
-      for (i = 0; i < nsigs; i++)
-        {
-          sigq->type = sigtype;
-          sq_addlast((FAR sq_entry_t *)sigq++, siglist);
-        }
-    }
-
-  return sigqalloc;
-}
-
 /****************************************************************************
  * Name: nxsig_alloc_pendingsignalblock
  *
@@ -210,27 +169,19 @@ static sigpendq_t *nxsig_alloc_pendingsignalblock(sq_queue_t *siglist,
 
 void nxsig_initialize(void)
 {
+  int ret;
+
   /* Initialize free lists */
 
   sq_init(&g_sigfreeaction);
-  sq_init(&g_sigpendingaction);
-  sq_init(&g_sigpendingirqaction);
   sq_init(&g_sigpendingsignal);
   sq_init(&g_sigpendingirqsignal);
 
   /* Add a block of signal structures to each list */
 
-  g_sigpendingactionalloc =
-    nxsig_alloc_block(&g_sigpendingaction,
-                      NUM_PENDING_ACTIONS,
-                      SIG_ALLOC_FIXED);
-  DEBUGASSERT(g_sigpendingactionalloc != NULL);
-
-  g_sigpendingirqactionalloc =
-    nxsig_alloc_block(&g_sigpendingirqaction,
-                      NUM_PENDING_INT_ACTIONS,
-                      SIG_ALLOC_IRQ);
-  DEBUGASSERT(g_sigpendingirqactionalloc != NULL);
+  ret = mempool_initialize(&g_sigpendingaction, "sigaction");
+  DEBUGASSERT(ret == OK);
+  UNUSED(ret);
 
   nxsig_alloc_actionblock();
 
@@ -275,3 +226,28 @@ void nxsig_alloc_actionblock(void)
         }
     }
 }
+
+/****************************************************************************
+ * Name: nxsig_alloc_grouppool
+ *
+ * Description:
+ *   Allocate the block of pending signal structures reserved for a new
+ *   task group and place them on the group's free list.
+ *
+ * Returned Value:
+ *   Zero (OK) on success; -ENOMEM if the block could not be allocated.
+ *
+ ****************************************************************************/
+
+#if CONFIG_SIG_GROUP_NPENDING > 0
+int nxsig_alloc_grouppool(FAR struct task_group_s *group)
+{
+  sq_init(&group->tg_sigpendfree);
+  group->tg_sigpendpool =
+    nxsig_alloc_pendingsignalblock(&group->tg_sigpendfree,
+                                   CONFIG_SIG_GROUP_NPENDING,
+                                   SIG_ALLOC_GROUP);
+
+  return group->tg_sigpendpool != NULL ? OK : -ENOMEM;
+}
+#endif
@@ -65,7 +65,8 @@
  *
  ****************************************************************************/
 
-void nxsig_release_pendingsignal(FAR sigpendq_t *sigpend)
+void nxsig_release_pendingsignal(FAR struct task_group_s *group,
+                                 FAR sigpendq_t *sigpend)
 {
   irqstate_t flags;
 
@@ -99,6 +100,21 @@ void nxsig_release_pendingsignal(FAR sigpendq_t *sigpend)
       leave_critical_section(flags);
     }
 
+#if CONFIG_SIG_GROUP_NPENDING > 0
+  /* If this is one reserved for the task group, then return it to the
+   * group's free list.
+   */
+
+  else if (sigpend->type == SIG_ALLOC_GROUP)
+    {
+      DEBUGASSERT(group != NULL);
+
+      flags = enter_critical_section();
+      sq_addlast((FAR sq_entry_t *)sigpend, &group->tg_sigpendfree);
+      leave_critical_section(flags);
+    }
+#endif
+
   /* Otherwise, deallocate it.  Note:  interrupt handlers
    * will never deallocate signals because they will not
    * receive them.
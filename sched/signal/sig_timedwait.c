@@ -54,6 +54,7 @@
 #include <nuttx/wdog.h>
 #include <nuttx/signal.h>
 #include <nuttx/cancelpt.h>
+#include <nuttx/timers/hrtimer.h>
 
 #include "sched/sched.h"
 #include "signal/signal.h"
@@ -135,6 +136,7 @@ static void nxsig_timeout(int argc, wdparm_t itcb)
       u.wtcb->sigunbinfo.si_pid             = 0;  /* Not applicable */
       u.wtcb->sigunbinfo.si_status          = OK;
 #endif
+      sched_latency_wakeup(u.wtcb);
       up_unblock_task(u.wtcb);
     }
 
@@ -143,6 +145,72 @@ static void nxsig_timeout(int argc, wdparm_t itcb)
 #endif
 }
 
+/****************************************************************************
+ * Name: nxsig_hrtimeout
+ *
+ * Description:
+ *   A high resolution timeout elapsed while waiting for signals to be
+ *   queued.
+ *
+ * Assumptions:
+ *   This function executes in the context of the oneshot timer interrupt.
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_HRTIMER
+static void nxsig_hrtimeout(FAR struct hrtimer_s *timer, FAR void *arg)
+{
+  union wdparm_u wdparm;
+
+  wdparm.pvarg = arg;
+  nxsig_timeout(1, wdparm.pvarg);
+}
+#endif
+
+/****************************************************************************
+ * Name: nxsig_hrwait
+ *
+ * Description:
+ *   Wait for a signal or for a timeout measured by a high resolution timer,
+ *   so that the wait is not rounded up to whole system ticks.
+ *
+ * Returned Value:
+ *   Zero (OK) is returned after the wait; a negated errno value is returned
+ *   without waiting if no high resolution timer is available.
+ *
+ * Assumptions:
+ *   Called in a critical section.
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_HRTIMER
+static int nxsig_hrwait(FAR struct tcb_s *rtcb,
+                        FAR const struct timespec *timeout)
+{
+  struct hrtimer_s hrtimer;
+  int ret;
+
+  hrtimer_init(&hrtimer, nxsig_hrtimeout, rtcb, 0);
+  ret = hrtimer_start(&hrtimer, timeout, NULL);
+  if (ret < 0)
+    {
+      return ret;
+    }
+
+  /* Now wait for either the signal or the timer, but first, make sure this
+   * is not the idle task, descheduling that isn't going to end well.
+   */
+
+  DEBUGASSERT(NULL != rtcb->flink);
+  up_block_task(rtcb, TSTATE_WAIT_SIG);
+
+  /* We no longer need the timer */
+
+  hrtimer_cancel(&hrtimer);
+  return OK;
+}
+#endif
+
 /****************************************************************************
  * Public Functions
  ****************************************************************************/
@@ -188,6 +256,7 @@ void nxsig_wait_irq(FAR struct tcb_s *wtcb, int errcode)
       wtcb->sigunbinfo.si_pid             = 0;  /* Not applicable */
       wtcb->sigunbinfo.si_status          = OK;
 #endif
+      sched_latency_wakeup(wtcb);
       up_unblock_task(wtcb);
     }
 
@@ -285,7 +354,7 @@ int nxsig_timedwait(FAR const sigset_t *set, FAR struct siginfo *info,
 
       /* Then dispose of the pending signal structure properly */
 
-      nxsig_release_pendingsignal(sigpend);
+      nxsig_release_pendingsignal(rtcb->group, sigpend);
       leave_critical_section(flags);
     }
 
@@ -316,6 +385,13 @@ int nxsig_timedwait(FAR const sigset_t *set, FAR struct siginfo *info,
 
       /* Check if we should wait for the timeout */
 
+#ifdef CONFIG_HRTIMER
+      if (timeout != NULL && nxsig_hrwait(rtcb, timeout) >= 0)
+        {
+          /* The timeout was measured by a high resolution timer */
+        }
+      else
+#endif
       if (timeout != NULL)
         {
           /* Convert the timespec to system clock ticks, making sure that
@@ -118,7 +118,7 @@ bool nxsig_unmask_pendingsignal(void)
 
               /* Then remove it from the pending signal list */
 
-              nxsig_release_pendingsignal(pendingsig);
+              nxsig_release_pendingsignal(rtcb->group, pendingsig);
             }
         }
     }
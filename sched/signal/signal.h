@@ -49,6 +49,7 @@
 #include <sched.h>
 
 #include <nuttx/kmalloc.h>
+#include <nuttx/mm/mempool.h>
 
 /****************************************************************************
  * Pre-processor Definitions
@@ -74,7 +75,8 @@ enum sigalloc_e
 {
   SIG_ALLOC_FIXED = 0,  /* pre-allocated; never freed */
   SIG_ALLOC_DYN,        /* dynamically allocated; free when unused */
-  SIG_ALLOC_IRQ         /* Preallocated, reserved for interrupt handling */
+  SIG_ALLOC_IRQ,        /* Preallocated, reserved for interrupt handling */
+  SIG_ALLOC_GROUP       /* Preallocated, reserved for one task group */
 };
 
 /* The following defines the sigaction queue entry */
@@ -115,7 +117,6 @@ struct sigq_s
   sigset_t  mask;                /* Additional signals to mask while the
                                   * the signal-catching function executes */
   siginfo_t info;                /* Signal information */
-  uint8_t   type;                /* (Used to manage allocations) */
 };
 typedef struct sigq_s sigq_t;
 
@@ -129,17 +130,12 @@ typedef struct sigq_s sigq_t;
 
 extern sq_queue_t  g_sigfreeaction;
 
-/* The g_sigpendingaction data structure is a list of available pending
- * signal action structures.
+/* The g_sigpendingaction pool holds the available pending signal action
+ * structures.  NUM_PENDING_INT_ACTIONS of these are reserved for use by
+ * interrupt handlers.
  */
 
-extern sq_queue_t  g_sigpendingaction;
-
-/* The g_sigpendingirqaction is a list of available pending signal actions
- * that are reserved for use by interrupt handlers.
- */
-
-extern sq_queue_t  g_sigpendingirqaction;
+extern struct mempool_s g_sigpendingaction;
 
 /* The g_sigpendingsignal data structure is a list of available pending
  * signal structures.
@@ -166,6 +162,9 @@ struct task_group_s;
 
 void weak_function nxsig_initialize(void);
 void               nxsig_alloc_actionblock(void);
+#if CONFIG_SIG_GROUP_NPENDING > 0
+int                nxsig_alloc_grouppool(FAR struct task_group_s *group);
+#endif
 
 /* sig_action.c */
 
@@ -208,7 +207,9 @@ void               nxsig_deliver(FAR struct tcb_s *stcb);
 FAR sigactq_t     *nxsig_find_action(FAR struct task_group_s *group, int signo);
 int                nxsig_lowest(FAR sigset_t *set);
 void               nxsig_release_pendingsigaction(FAR sigq_t *sigq);
-void               nxsig_release_pendingsignal(FAR sigpendq_t *sigpend);
+void               nxsig_release_pendingsignal(
+                     FAR struct task_group_s *group,
+                     FAR sigpendq_t *sigpend);
 FAR sigpendq_t    *nxsig_remove_pendingsignal(FAR struct tcb_s *stcb, int signo);
 bool               nxsig_unmask_pendingsignal(void);
 
@@ -52,6 +52,12 @@
  * Pre-processor Definitions
  ****************************************************************************/
 
+/* Is there a pool of preallocated TCBs and stacks? */
+
+#if defined(CONFIG_TASK_POOL_NTCBS) && CONFIG_TASK_POOL_NTCBS > 0
+#  define HAVE_TASK_POOL 1
+#endif
+
 /****************************************************************************
  * Public Type Definitions
  ****************************************************************************/
@@ -73,6 +79,14 @@ int  nxtask_schedsetup(FAR struct task_tcb_s *tcb, int priority,
 int  nxtask_argsetup(FAR struct task_tcb_s *tcb, FAR const char *name,
        FAR char * const argv[]);
 
+/* Preallocated TCBs and stacks */
+
+#ifdef HAVE_TASK_POOL
+FAR struct task_tcb_s *nxtask_pool_alloc(size_t stack_size);
+bool nxtask_pool_member(FAR struct tcb_s *tcb);
+void nxtask_pool_free(FAR struct tcb_s *tcb);
+#endif
+
 /* Task exit */
 
 int  nxtask_exit(void);
@@ -45,6 +45,7 @@
 #include <nuttx/irq.h>
 #include <nuttx/arch.h>
 #include <nuttx/sched_note.h>
+#include <nuttx/tls.h>
 
 /****************************************************************************
  * Public Functions
@@ -69,6 +70,21 @@ int task_activate(FAR struct tcb_s *tcb)
 {
   irqstate_t flags = enter_critical_section();
 
+#ifdef CONFIG_TLS_GETPID
+  /* Record the thread ID in the TLS data so that getpid() need not enter
+   * the kernel.  vfork() creates the stack only after the ID is assigned,
+   * so this is the first point where both are known on every path.
+   */
+
+  if (tcb->stack_alloc_ptr != NULL)
+    {
+      FAR struct tls_info_s *info =
+        (FAR struct tls_info_s *)tcb->stack_alloc_ptr;
+
+      info->tl_pid = tcb->pid;
+    }
+#endif
+
 #ifdef CONFIG_SCHED_INSTRUMENTATION
 
   /* Check if this is really a re-start */
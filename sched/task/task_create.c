@@ -91,13 +91,21 @@ static int nxthread_create(FAR const char *name, uint8_t ttype,
   pid_t pid;
   int ret;
 
-  /* Allocate a TCB for the new task. */
+  /* Allocate a TCB for the new task.  Try the pool of preallocated TCBs
+   * and stacks first.
+   */
 
-  tcb = (FAR struct task_tcb_s *)kmm_zalloc(sizeof(struct task_tcb_s));
-  if (!tcb)
+#ifdef HAVE_TASK_POOL
+  tcb = nxtask_pool_alloc(stack_size);
+  if (tcb == NULL)
+#endif
     {
-      serr("ERROR: Failed to allocate TCB\n");
-      return -ENOMEM;
+      tcb = (FAR struct task_tcb_s *)kmm_zalloc(sizeof(struct task_tcb_s));
+      if (!tcb)
+        {
+          serr("ERROR: Failed to allocate TCB\n");
+          return -ENOMEM;
+        }
     }
 
   /* Allocate a new task group with privileges appropriate for the parent
@@ -126,12 +134,15 @@ static int nxthread_create(FAR const char *name, uint8_t ttype,
         }
     }
 
-  /* Allocate the stack for the TCB */
+  /* Allocate the stack for the TCB, unless it came with the TCB */
 
-  ret = up_create_stack((FAR struct tcb_s *)tcb, stack_size, ttype);
-  if (ret < OK)
+  if (tcb->cmn.stack_alloc_ptr == NULL)
     {
-      goto errout_with_tcb;
+      ret = up_create_stack((FAR struct tcb_s *)tcb, stack_size, ttype);
+      if (ret < OK)
+        {
+          goto errout_with_tcb;
+        }
     }
 
   /* Initialize the task control block */
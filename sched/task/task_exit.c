@@ -138,8 +138,11 @@ int nxtask_exit(void)
   rtcb->lockcount++;
 
 #ifdef CONFIG_SMP
-  /* Make sure that the system knows about the locked state */
+  /* Make sure that the system knows about the locked state.  Task
+   * switching is disabled on all CPUs until the list is consistent again.
+   */
 
+  rtcb->glockcount++;
   spin_setbit(&g_cpu_lockset, this_cpu(), &g_cpu_locksetlock,
               &g_cpu_schedlock);
 #endif
@@ -161,7 +164,8 @@ int nxtask_exit(void)
   rtcb->lockcount--;
 
 #ifdef CONFIG_SMP
-  if (rtcb->lockcount == 0)
+  rtcb->glockcount--;
+  if (rtcb->glockcount == 0)
     {
       /* Make sure that the system knows about the unlocked state */
 
@@ -0,0 +1,162 @@
+/****************************************************************************
+ * sched/task/task_pool.c
+ *
+ *   Copyright (C) 2020 Gregory Nutt. All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in
+ *    the documentation and/or other materials provided with the
+ *    distribution.
+ * 3. Neither the name NuttX nor the names of its contributors may be
+ *    used to endorse or promote products derived from this software
+ *    without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+ * FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE
+ * COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+ * INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,
+ * BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS
+ * OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED
+ * AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ * LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN
+ * ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ *
+ ****************************************************************************/
+
+/****************************************************************************
+ * Included Files
+ ****************************************************************************/
+
+#include <nuttx/config.h>
+
+#include <stdint.h>
+#include <stdbool.h>
+#include <string.h>
+
+#include <nuttx/arch.h>
+#include <nuttx/irq.h>
+#include <nuttx/sched.h>
+
+#include "task/task.h"
+
+#ifdef HAVE_TASK_POOL
+
+/****************************************************************************
+ * Pre-processor Definitions
+ ****************************************************************************/
+
+#define TASK_POOL_STACKWORDS  ((CONFIG_TASK_POOL_STACKSIZE + 3) / 4)
+
+/****************************************************************************
+ * Private Data
+ ****************************************************************************/
+
+/* The preallocated TCBs and their stacks.  A pooled TCB keeps its stack for
+ * its whole life, so neither is ever returned to the heap.
+ */
+
+static struct task_tcb_s g_task_pooltcb[CONFIG_TASK_POOL_NTCBS];
+static uint32_t
+  g_task_poolstack[CONFIG_TASK_POOL_NTCBS][TASK_POOL_STACKWORDS]
+  aligned_data(8);
+static bool g_task_poolused[CONFIG_TASK_POOL_NTCBS];
+
+/****************************************************************************
+ * Public Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: nxtask_pool_alloc
+ *
+ * Description:
+ *   Take a zeroed TCB with its stack already attached from the pool of
+ *   preallocated TCBs.
+ *
+ * Input Parameters:
+ *   stack_size - The stack size needed by the new task
+ *
+ * Returned Value:
+ *   The TCB, or NULL if the pool is empty or its stacks are too small.  The
+ *   caller then allocates the TCB and the stack from the heap.
+ *
+ ****************************************************************************/
+
+FAR struct task_tcb_s *nxtask_pool_alloc(size_t stack_size)
+{
+  FAR struct task_tcb_s *tcb = NULL;
+  irqstate_t flags;
+  int i;
+
+  if (stack_size > CONFIG_TASK_POOL_STACKSIZE)
+    {
+      return NULL;
+    }
+
+  flags = enter_critical_section();
+  for (i = 0; i < CONFIG_TASK_POOL_NTCBS; i++)
+    {
+      if (!g_task_poolused[i])
+        {
+          g_task_poolused[i] = true;
+          tcb = &g_task_pooltcb[i];
+          break;
+        }
+    }
+
+  leave_critical_section(flags);
+
+  if (tcb != NULL)
+    {
+      memset(tcb, 0, sizeof(struct task_tcb_s));
+      up_use_stack((FAR struct tcb_s *)tcb, g_task_poolstack[i],
+                   sizeof(g_task_poolstack[i]));
+    }
+
+  return tcb;
+}
+
+/****************************************************************************
+ * Name: nxtask_pool_member
+ *
+ * Description:
+ *   Return true if the TCB was taken from the pool.
+ *
+ ****************************************************************************/
+
+bool nxtask_pool_member(FAR struct tcb_s *tcb)
+{
+  return (uintptr_t)tcb >= (uintptr_t)&g_task_pooltcb[0] &&
+         (uintptr_t)tcb < (uintptr_t)&g_task_pooltcb[CONFIG_TASK_POOL_NTCBS];
+}
+
+/****************************************************************************
+ * Name: nxtask_pool_free
+ *
+ * Description:
+ *   Return a pooled TCB and its stack to the pool.  May be called with
+ *   interrupts disabled and from the exiting task itself, like
+ *   sched_kfree().
+ *
+ ****************************************************************************/
+
+void nxtask_pool_free(FAR struct tcb_s *tcb)
+{
+  irqstate_t flags;
+
+  DEBUGASSERT(nxtask_pool_member(tcb));
+
+  flags = enter_critical_section();
+  g_task_poolused[(FAR struct task_tcb_s *)tcb - g_task_pooltcb] = false;
+  leave_critical_section(flags);
+}
+
+#endif /* HAVE_TASK_POOL */
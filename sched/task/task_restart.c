@@ -155,7 +155,7 @@ int task_restart(pid_t pid)
   tasklist = TLIST_HEAD(tcb->cmn.task_state);
 #endif
 
-  dq_rem((FAR dq_entry_t *)tcb, tasklist);
+  sched_removeprioritized((FAR struct tcb_s *)tcb, tasklist);
   tcb->cmn.task_state = TSTATE_TASK_INVALID;
 
   /* Deallocate anything left in the TCB's signal queues */
@@ -173,6 +173,7 @@ int task_restart(pid_t pid)
 
   tcb->cmn.lockcount = 0;
 #ifdef CONFIG_SMP
+  tcb->cmn.glockcount = 0;
   tcb->cmn.irqcount  = 0;
 #endif
 
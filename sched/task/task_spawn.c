@@ -83,8 +83,7 @@
  *       value.
  *     - POSIX_SPAWN_SETSCHEDULER: Set the new tasks scheduler priority to
  *       the sched_policy value.
- *
- *     NOTE: POSIX_SPAWN_SETSIGMASK is handled in nxtask_spawn_proxy().
+ *     - POSIX_SPAWN_SETSIGMASK: Set the new task's signal mask.
  *
  *   argv - argv[] is the argument list for the new task.  argv[] is an
  *     array of pointers to null-terminated strings. The list is terminated
@@ -207,14 +206,11 @@ static int nxtask_spawn_proxy(int argc, FAR char *argv[])
 {
   int ret;
 
-  /* Perform file actions and/or set a custom signal mask.  We get here only
-   * if the file_actions parameter to task_spawn[p] was non-NULL and/or the
-   * option to change the signal mask was selected.
+  /* Perform file actions.  We get here only if the file_actions parameter
+   * to task_spawn[p] was non-NULL.
    */
 
-  DEBUGASSERT(g_spawn_parms.file_actions ||
-              (g_spawn_parms.attr &&
-               (g_spawn_parms.attr->flags & POSIX_SPAWN_SETSIGMASK) != 0));
+  DEBUGASSERT(g_spawn_parms.file_actions != NULL);
 
   /* Set the attributes and perform the file actions as appropriate */
 
@@ -338,13 +334,12 @@ int task_spawn(FAR pid_t *pid, FAR const char *name, main_t entry,
   sinfo("pid=%p name=%s entry=%p file_actions=%p attr=%p argv=%p\n",
         pid, name, entry, file_actions, attr, argv);
 
-  /* If there are no file actions to be performed and there is no change to
-   * the signal mask, then start the new child task directly from the parent
-   * task.
+  /* If there are no file actions to be performed, then start the new child
+   * task directly from the parent task.  A change of the signal mask is
+   * applied to the new task before it first runs.
    */
 
-  if ((file_actions == NULL || *file_actions == NULL) &&
-      (attr == NULL || (attr->flags & POSIX_SPAWN_SETSIGMASK) == 0))
+  if (file_actions == NULL || *file_actions == NULL)
     {
       return nxtask_spawn_exec(pid, name, entry, attr, argv);
     }
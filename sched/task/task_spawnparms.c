@@ -187,6 +187,9 @@ void spawn_semtake(FAR sem_t *sem)
  *   pid - The pid of the new task.
  *   attr - The attributes to use
  *
+ *   The signal mask (POSIX_SPAWN_SETSIGMASK) is set directly in the TCB of
+ *   the new task, so no proxy task is needed for it.
+ *
  * Returned Value:
  *   Errors are not reported by this function.  This is not because errors
  *   cannot occur, but rather that the new task has already been started
@@ -206,6 +209,19 @@ int spawn_execattrs(pid_t pid, FAR const posix_spawnattr_t *attr)
 
   DEBUGASSERT(attr);
 
+  /* Set the signal mask of the new task.  It has not yet run so there can
+   * be no pending signals to be unmasked.
+   */
+
+  if ((attr->flags & POSIX_SPAWN_SETSIGMASK) != 0)
+    {
+      FAR struct tcb_s *tcb = sched_gettcb(pid);
+      if (tcb != NULL)
+        {
+          tcb->sigprocmask = attr->sigmask;
+        }
+    }
+
   /* Now set the attributes.  Note that we ignore all of the return values
    * here because we have already successfully started the task.  If we
    * return an error value, then we would also have to stop the task.
@@ -48,12 +48,14 @@
 #include <nuttx/compiler.h>
 #include <nuttx/signal.h>
 #include <nuttx/wdog.h>
+#include <nuttx/timers/hrtimer.h>
 
 /****************************************************************************
  * Pre-processor Definitions
  ****************************************************************************/
 
 #define PT_FLAGS_PREALLOCATED 0x01 /* Timer comes from a pool of preallocated timers */
+#define PT_FLAGS_EVQUEUED     0x02 /* Callback queued to the timer thread */
 
 /****************************************************************************
  * Public Types
@@ -71,8 +73,16 @@ struct posix_timer_s
   int              pt_delay;       /* If non-zero, used to reset repetitive timers */
   int              pt_last;        /* Last value used to set watchdog */
   WDOG_ID          pt_wdog;        /* The watchdog that provides the timing */
+#ifdef CONFIG_HRTIMER
+  struct hrtimer_s pt_hrtimer;     /* Sub-tick timer, if available */
+#endif
   struct sigevent  pt_event;       /* Notification information */
   struct sigwork_s pt_work;
+#ifdef CONFIG_SIG_EVTHREAD_TIMER
+  FAR struct posix_timer_s *pt_evnext; /* Link in the timer thread queue */
+  int              pt_overrun;     /* Expirations while the callback queued */
+  int              pt_lastoverrun; /* Overruns of the last callback */
+#endif
 };
 
 /****************************************************************************
@@ -100,4 +110,16 @@ void weak_function timer_initialize(void);
 void weak_function timer_deleteall(pid_t pid);
 int timer_release(FAR struct posix_timer_s *timer);
 
+#ifdef CONFIG_HRTIMER
+void timer_hrtimeout(FAR struct hrtimer_s *hrtimer, FAR void *arg);
+#endif
+
+#ifdef CONFIG_SIG_EVTHREAD_TIMER
+int timer_evstart(void);
+void timer_evnotify(FAR struct posix_timer_s *timer);
+void timer_evcancel(FAR struct posix_timer_s *timer);
+#else
+#  define timer_evcancel(timer)
+#endif
+
 #endif /* __SCHED_TIMER_TIMER_H */
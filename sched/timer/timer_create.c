@@ -180,6 +180,20 @@ int timer_create(clockid_t clockid, FAR struct sigevent *evp,
       return ERROR;
     }
 
+#ifdef CONFIG_SIG_EVTHREAD_TIMER
+  /* SIGEV_THREAD callbacks run on the timer thread */
+
+  if (evp != NULL && evp->sigev_notify == SIGEV_THREAD)
+    {
+      int errcode = timer_evstart();
+      if (errcode < 0)
+        {
+          set_errno(-errcode);
+          return ERROR;
+        }
+    }
+#endif
+
   /* Allocate a watchdog to provide the underling CLOCK_REALTIME timer */
 
   wdog = wd_create();
@@ -205,6 +219,13 @@ int timer_create(clockid_t clockid, FAR struct sigevent *evp,
   ret->pt_owner = getpid();
   ret->pt_delay = 0;
   ret->pt_wdog  = wdog;
+#ifdef CONFIG_HRTIMER
+  hrtimer_init(&ret->pt_hrtimer, timer_hrtimeout, ret, 0);
+#endif
+#ifdef CONFIG_SIG_EVTHREAD_TIMER
+  ret->pt_overrun     = 0;
+  ret->pt_lastoverrun = 0;
+#endif
 
   /* Was a struct sigevent provided? */
 
@@ -42,6 +42,9 @@
 #include <time.h>
 #include <errno.h>
 
+#include <nuttx/irq.h>
+#include <nuttx/sched.h>
+
 #include "timer/timer.h"
 
 #ifndef CONFIG_DISABLE_POSIX_TIMERS
@@ -77,7 +80,42 @@
 
 int timer_delete(timer_t timerid)
 {
-  int ret = timer_release((FAR struct posix_timer_s *)timerid);
+  FAR struct posix_timer_s *timer = (FAR struct posix_timer_s *)timerid;
+  irqstate_t flags;
+  int ret;
+
+  if (timer == NULL)
+    {
+      set_errno(EINVAL);
+      return ERROR;
+    }
+
+  /* Disarm the timer and drop a callback not yet started.  A callback in
+   * progress holds its own reference and frees the timer when it returns.
+   */
+
+  flags = enter_critical_section();
+  wd_cancel(timer->pt_wdog);
+#ifdef CONFIG_HRTIMER
+  hrtimer_cancel(&timer->pt_hrtimer);
+#endif
+  timer_evcancel(timer);
+
+  if (timer->pt_crefs > 1)
+    {
+      /* Make sure that timer_deleteall() does not release the remaining
+       * reference too.
+       */
+
+      timer->pt_crefs--;
+      timer->pt_owner = INVALID_PROCESS_ID;
+      leave_critical_section(flags);
+      return OK;
+    }
+
+  leave_critical_section(flags);
+
+  ret = timer_release(timer);
   if (ret < 0)
     {
       set_errno(-ret);
@@ -0,0 +1,274 @@
+/****************************************************************************
+ * sched/timer/timer_evthread.c
+ *
+ *   Copyright (C) 2020 Gregory Nutt. All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in
+ *    the documentation and/or other materials provided with the
+ *    distribution.
+ * 3. Neither the name NuttX nor the names of its contributors may be
+ *    used to endorse or promote products derived from this software
+ *    without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+ * FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE
+ * COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+ * INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,
+ * BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS
+ * OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED
+ * AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ * LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN
+ * ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ *
+ ****************************************************************************/
+
+/****************************************************************************
+ * Included Files
+ ****************************************************************************/
+
+#include <nuttx/config.h>
+
+#include <sys/types.h>
+#include <stdbool.h>
+#include <limits.h>
+#include <assert.h>
+#include <debug.h>
+
+#include <nuttx/irq.h>
+#include <nuttx/kthread.h>
+#include <nuttx/semaphore.h>
+
+#include "timer/timer.h"
+
+#ifdef CONFIG_SIG_EVTHREAD_TIMER
+
+/****************************************************************************
+ * Private Data
+ ****************************************************************************/
+
+/* The timers whose callback is due, in expiration order.  Protected by a
+ * critical section since the timers expire in the watchdog interrupt.
+ */
+
+static FAR struct posix_timer_s *g_timer_evhead;
+static FAR struct posix_timer_s *g_timer_evtail;
+static sem_t g_timer_evsem = SEM_INITIALIZER(0);
+static bool g_timer_evstarted;
+
+/****************************************************************************
+ * Private Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: timer_evthread
+ *
+ * Description:
+ *   Run the callbacks of the expired SIGEV_THREAD timers.
+ *
+ ****************************************************************************/
+
+static int timer_evthread(int argc, FAR char *argv[])
+{
+  FAR struct posix_timer_s *timer;
+  irqstate_t flags;
+
+  for (; ; )
+    {
+      nxsem_wait_uninterruptible(&g_timer_evsem);
+
+      flags = enter_critical_section();
+      timer = g_timer_evhead;
+      if (timer == NULL)
+        {
+          leave_critical_section(flags);
+          continue;
+        }
+
+      g_timer_evhead = timer->pt_evnext;
+      if (g_timer_evhead == NULL)
+        {
+          g_timer_evtail = NULL;
+        }
+
+      /* From here on a new expiration queues the timer again */
+
+      timer->pt_flags      &= ~PT_FLAGS_EVQUEUED;
+      timer->pt_lastoverrun = timer->pt_overrun;
+      timer->pt_overrun     = 0;
+      leave_critical_section(flags);
+
+#ifdef CONFIG_CAN_PASS_STRUCTS
+      timer->pt_event.sigev_notify_function(timer->pt_event.sigev_value);
+#else
+      timer->pt_event.sigev_notify_function(
+        timer->pt_event.sigev_value.sival_ptr);
+#endif
+
+      /* Drop the reference taken by timer_evnotify().  The timer is freed
+       * here if it was deleted while the callback was pending.
+       */
+
+      flags = enter_critical_section();
+      if (timer->pt_crefs > 1)
+        {
+          timer->pt_crefs--;
+          leave_critical_section(flags);
+        }
+      else
+        {
+          leave_critical_section(flags);
+          timer_release(timer);
+        }
+    }
+
+  return OK;
+}
+
+/****************************************************************************
+ * Public Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: timer_evstart
+ *
+ * Description:
+ *   Start the timer thread if it is not running yet.
+ *
+ * Returned Value:
+ *   Zero (OK) on success; a negated errno value on failure.
+ *
+ ****************************************************************************/
+
+int timer_evstart(void)
+{
+  int ret = OK;
+
+  sched_lock();
+  if (!g_timer_evstarted)
+    {
+      ret = kthread_create("timer_evthread",
+                           CONFIG_SIG_EVTHREAD_TIMER_PRIORITY,
+                           CONFIG_SIG_EVTHREAD_TIMER_STACKSIZE,
+                           (main_t)timer_evthread, NULL);
+      if (ret >= 0)
+        {
+          g_timer_evstarted = true;
+          ret = OK;
+        }
+    }
+
+  sched_unlock();
+  return ret;
+}
+
+/****************************************************************************
+ * Name: timer_evnotify
+ *
+ * Description:
+ *   Queue the callback of an expired SIGEV_THREAD timer.  If the callback
+ *   is still queued from a previous expiration, only count the overrun.
+ *
+ * Assumptions:
+ *   Called from the watchdog timer interrupt.
+ *
+ ****************************************************************************/
+
+void timer_evnotify(FAR struct posix_timer_s *timer)
+{
+  irqstate_t flags;
+
+  flags = enter_critical_section();
+  if ((timer->pt_flags & PT_FLAGS_EVQUEUED) != 0)
+    {
+      if (timer->pt_overrun < DELAYTIMER_MAX)
+        {
+          timer->pt_overrun++;
+        }
+    }
+  else
+    {
+      timer->pt_flags |= PT_FLAGS_EVQUEUED;
+      timer->pt_crefs++;
+      timer->pt_evnext = NULL;
+
+      if (g_timer_evtail != NULL)
+        {
+          g_timer_evtail->pt_evnext = timer;
+        }
+      else
+        {
+          g_timer_evhead = timer;
+        }
+
+      g_timer_evtail = timer;
+      nxsem_post(&g_timer_evsem);
+    }
+
+  leave_critical_section(flags);
+}
+
+/****************************************************************************
+ * Name: timer_evcancel
+ *
+ * Description:
+ *   Remove a timer from the queue of the timer thread if its callback has
+ *   not started yet.  A callback that is already running completes.
+ *
+ ****************************************************************************/
+
+void timer_evcancel(FAR struct posix_timer_s *timer)
+{
+  FAR struct posix_timer_s *prev = NULL;
+  FAR struct posix_timer_s *curr;
+  irqstate_t flags;
+
+  flags = enter_critical_section();
+  if ((timer->pt_flags & PT_FLAGS_EVQUEUED) != 0)
+    {
+      for (curr = g_timer_evhead; curr != NULL; curr = curr->pt_evnext)
+        {
+          if (curr == timer)
+            {
+              break;
+            }
+
+          prev = curr;
+        }
+
+      DEBUGASSERT(curr != NULL);
+
+      if (prev != NULL)
+        {
+          prev->pt_evnext = timer->pt_evnext;
+        }
+      else
+        {
+          g_timer_evhead = timer->pt_evnext;
+        }
+
+      if (g_timer_evtail == timer)
+        {
+          g_timer_evtail = prev;
+        }
+
+      /* The semaphore count stays, the thread finds the queue empty */
+
+      timer->pt_flags  &= ~PT_FLAGS_EVQUEUED;
+      timer->pt_overrun = 0;
+      timer->pt_crefs--;
+    }
+
+  leave_critical_section(flags);
+}
+
+#endif /* CONFIG_SIG_EVTHREAD_TIMER */
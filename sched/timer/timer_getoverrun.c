@@ -90,8 +90,24 @@
 
 int timer_getoverrun(timer_t timerid)
 {
+#ifdef CONFIG_SIG_EVTHREAD_TIMER
+  FAR struct posix_timer_s *timer = (FAR struct posix_timer_s *)timerid;
+
+  if (timer == NULL)
+    {
+      set_errno(EINVAL);
+      return ERROR;
+    }
+
+  /* Overruns are only counted for the SIGEV_THREAD callbacks, the signals
+   * of the other timers are queued for each expiration.
+   */
+
+  return timer->pt_lastoverrun;
+#else
   set_errno(ENOSYS);
   return ERROR;
+#endif
 }
 
 #endif /* CONFIG_DISABLE_POSIX_TIMERS */
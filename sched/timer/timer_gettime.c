@@ -94,6 +94,16 @@ int timer_gettime(timer_t timerid, FAR struct itimerspec *value)
       return ERROR;
     }
 
+#ifdef CONFIG_HRTIMER
+  /* If the high resolution timer is running, return its exact times */
+
+  if (hrtimer_remaining(&timer->pt_hrtimer, &value->it_value) >= 0)
+    {
+      value->it_interval = timer->pt_hrtimer.period;
+      return OK;
+    }
+#endif
+
   /* Get the number of ticks before the underlying watchdog expires */
 
   ticks = wd_gettime(timer->pt_wdog);
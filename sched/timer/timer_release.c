@@ -139,6 +139,9 @@ int timer_release(FAR struct posix_timer_s *timer)
    */
 
   wd_delete(timer->pt_wdog);
+#ifdef CONFIG_HRTIMER
+  hrtimer_cancel(&timer->pt_hrtimer);
+#endif
 
   /* Cancel any pending notification */
 
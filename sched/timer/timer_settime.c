@@ -85,6 +85,14 @@ static void timer_timeout(int argc, wdparm_t itimer);
 
 static inline void timer_signotify(FAR struct posix_timer_s *timer)
 {
+#ifdef CONFIG_SIG_EVTHREAD_TIMER
+  if (timer->pt_event.sigev_notify == SIGEV_THREAD)
+    {
+      timer_evnotify(timer);
+      return;
+    }
+#endif
+
   DEBUGVERIFY(nxsig_notification(timer->pt_owner, &timer->pt_event,
                                  SI_TIMER, &timer->pt_work));
 }
@@ -197,10 +205,82 @@ static void timer_timeout(int argc, wdparm_t itimer)
 #endif
 }
 
+/****************************************************************************
+ * Name: timer_hrstart
+ *
+ * Description:
+ *   Start the high resolution timer of a POSIX timer.
+ *
+ * Returned Value:
+ *   Zero (OK) is returned if the timer was started.  A negated errno value
+ *   is returned if no high resolution timer is available; the watchdog is
+ *   used then.
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_HRTIMER
+static int timer_hrstart(FAR struct posix_timer_s *timer, int flags,
+                         FAR const struct itimerspec *value)
+{
+  struct timespec delay;
+
+  if ((flags & TIMER_ABSTIME) != 0)
+    {
+      /* Calculate the delay until the absolute time.  An absolute time in
+       * the past gives a zero delay:  The notification is made at once.
+       */
+
+      clock_gettime(CLOCK_REALTIME, &delay);
+      clock_timespec_subtract(&value->it_value, &delay, &delay);
+    }
+  else
+    {
+      delay = value->it_value;
+    }
+
+  return hrtimer_start(&timer->pt_hrtimer, &delay, &value->it_interval);
+}
+#endif
+
 /****************************************************************************
  * Public Functions
  ****************************************************************************/
 
+/****************************************************************************
+ * Name: timer_hrtimeout
+ *
+ * Description:
+ *   The high resolution timer of a POSIX timer expired.  A periodic timer
+ *   has already been re-armed by the hrtimer logic.
+ *
+ * Input Parameters:
+ *   hrtimer - The high resolution timer that expired
+ *   arg     - A reference to the POSIX timer
+ *
+ * Returned Value:
+ *   None
+ *
+ * Assumptions:
+ *   This function executes in the context of the oneshot timer interrupt.
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_HRTIMER
+void timer_hrtimeout(FAR struct hrtimer_s *hrtimer, FAR void *arg)
+{
+  FAR struct posix_timer_s *timer = (FAR struct posix_timer_s *)arg;
+
+  /* Send the specified signal to the specified task.   Increment the
+   * reference count on the timer first so that will not be deleted until
+   * after the signal handler returns.
+   */
+
+  timer->pt_crefs++;
+  timer_signotify(timer);
+  timer_release(timer);
+}
+#endif
+
 /****************************************************************************
  * Name: timer_settime
  *
@@ -284,14 +364,25 @@ int timer_settime(timer_t timerid, int flags,
 
   if (ovalue)
     {
-      /* Get the number of ticks before the underlying watchdog expires */
+#ifdef CONFIG_HRTIMER
+      if (hrtimer_remaining(&timer->pt_hrtimer, &ovalue->it_value) >= 0)
+        {
+          ovalue->it_interval = timer->pt_hrtimer.period;
+        }
+      else
+#endif
+        {
+          /* Get the number of ticks before the underlying watchdog
+           * expires
+           */
 
-      delay = wd_gettime(timer->pt_wdog);
+          delay = wd_gettime(timer->pt_wdog);
 
-      /* Convert that to a struct timespec and return it */
+          /* Convert that to a struct timespec and return it */
 
-      clock_ticks2time(delay, &ovalue->it_value);
-      clock_ticks2time(timer->pt_last, &ovalue->it_interval);
+          clock_ticks2time(delay, &ovalue->it_value);
+          clock_ticks2time(timer->pt_last, &ovalue->it_interval);
+        }
     }
 
   /* Disarm the timer (in case the timer was already armed when timer_settime()
@@ -299,10 +390,14 @@ int timer_settime(timer_t timerid, int flags,
    */
 
   wd_cancel(timer->pt_wdog);
+#ifdef CONFIG_HRTIMER
+  hrtimer_cancel(&timer->pt_hrtimer);
+#endif
 
   /* Cancel any pending notification */
 
   nxsig_cancel_notification(&timer->pt_work);
+  timer_evcancel(timer);
 
   /* If the it_value member of value is zero, the timer will not be re-armed */
 
@@ -332,6 +427,18 @@ int timer_settime(timer_t timerid, int flags,
 
   intflags = enter_critical_section();
 
+#ifdef CONFIG_HRTIMER
+  /* Prefer the high resolution timer so that the expirations are not
+   * rounded up to whole system ticks.
+   */
+
+  if (timer_hrstart(timer, flags, value) >= 0)
+    {
+      leave_critical_section(intflags);
+      return OK;
+    }
+#endif
+
   /* Check if abstime is selected */
 
   if ((flags & TIMER_ABSTIME) != 0)
@@ -56,100 +56,133 @@
  ****************************************************************************/
 
 /****************************************************************************
- * Name: wd_cancel
+ * Name: wd_remove
  *
  * Description:
- *   This function cancels a currently running watchdog timer. Watchdog
- *   timers may be canceled from the interrupt level.
+ *   Remove an active watchdog from the active watchdog list and mark it
+ *   inactive.  This is the common logic of wd_cancel() and wd_start().
  *
  * Input Parameters:
- *   wdog - ID of the watchdog to cancel.
+ *   wdog - The active watchdog to remove.
  *
  * Returned Value:
- *   Zero (OK) is returned on success;  A negated errno value is returned to
- *   indicate the nature of any failure.
+ *   None
+ *
+ * Assumptions:
+ *   The caller holds wd_lock() and has verified that the watchdog is
+ *   active.
  *
  ****************************************************************************/
 
-int wd_cancel(WDOG_ID wdog)
+void wd_remove(FAR struct wdog_s *wdog)
 {
+#ifdef CONFIG_WDOG_TIMERWHEEL
+  /* Remove the watchdog from its wheel bucket.  If the bucket became empty
+   * then the next timer event may have moved; reassess the interval timer.
+   */
+
+  if (wd_wheel_remove(wdog))
+    {
+      sched_timer_reassess();
+    }
+#else
   FAR struct wdog_s *curr;
   FAR struct wdog_s *prev;
-  irqstate_t flags;
-  int ret = -EINVAL;
 
-  /* Prohibit timer interactions with the timer queue until the
-   * cancellation is complete
+  /* Search the g_wdactivelist for the target FCB.  We can't use sq_rem
+   * to do this because there are additional operations that need to be
+   * done.
    */
 
-  flags = enter_critical_section();
+  prev = NULL;
+  curr = (FAR struct wdog_s *)g_wdactivelist.head;
 
-  /* Make sure that the watchdog is initialized (non-NULL) and is still
-   * active.
+  while ((curr) && (curr != wdog))
+    {
+      prev = curr;
+      curr = curr->next;
+    }
+
+  /* Check if the watchdog was found in the list.  If not, then an OS
+   * error has occurred because the watchdog is marked active!
    */
 
-  if (wdog != NULL && WDOG_ISACTIVE(wdog))
-    {
-      /* Search the g_wdactivelist for the target FCB.  We can't use sq_rem
-       * to do this because there are additional operations that need to be
-       * done.
-       */
+  DEBUGASSERT(curr);
 
-      prev = NULL;
-      curr = (FAR struct wdog_s *)g_wdactivelist.head;
+  /* If there is a watchdog in the timer queue after the one that
+   * is being canceled, then it inherits the remaining ticks.
+   */
 
-      while ((curr) && (curr != wdog))
-        {
-          prev = curr;
-          curr = curr->next;
-        }
+  if (curr->next)
+    {
+      curr->next->lag += curr->lag;
+    }
 
-      /* Check if the watchdog was found in the list.  If not, then an OS
-       * error has occurred because the watchdog is marked active!
-       */
+  /* Now, remove the watchdog from the timer queue */
 
-      DEBUGASSERT(curr);
+  if (prev)
+    {
+      /* Remove the watchdog from mid- or end-of-queue */
 
-      /* If there is a watchdog in the timer queue after the one that
-       * is being canceled, then it inherits the remaining ticks.
-       */
+      sq_remafter((FAR sq_entry_t *)prev, &g_wdactivelist);
+    }
+  else
+    {
+      /* Remove the watchdog at the head of the queue */
 
-      if (curr->next)
-        {
-          curr->next->lag += curr->lag;
-        }
+      sq_remfirst(&g_wdactivelist);
 
-      /* Now, remove the watchdog from the timer queue */
+      /* Reassess the interval timer that will generate the next
+       * interval event.
+       */
 
-      if (prev)
-        {
-          /* Remove the watchdog from mid- or end-of-queue */
+      sched_timer_reassess();
+    }
+#endif
 
-          sq_remafter((FAR sq_entry_t *)prev, &g_wdactivelist);
-        }
-      else
-        {
-          /* Remove the watchdog at the head of the queue */
+  /* Mark the watchdog inactive */
 
-          sq_remfirst(&g_wdactivelist);
+  wdog->next = NULL;
+  WDOG_CLRACTIVE(wdog);
+}
 
-          /* Reassess the interval timer that will generate the next
-           * interval event.
-           */
+/****************************************************************************
+ * Name: wd_cancel
+ *
+ * Description:
+ *   This function cancels a currently running watchdog timer. Watchdog
+ *   timers may be canceled from the interrupt level.
+ *
+ * Input Parameters:
+ *   wdog - ID of the watchdog to cancel.
+ *
+ * Returned Value:
+ *   Zero (OK) is returned on success;  A negated errno value is returned to
+ *   indicate the nature of any failure.
+ *
+ ****************************************************************************/
 
-          sched_timer_reassess();
-        }
+int wd_cancel(WDOG_ID wdog)
+{
+  irqstate_t flags;
+  int ret = -EINVAL;
 
-      /* Mark the watchdog inactive */
+  /* Prohibit timer interactions with the timer queue until the
+   * cancellation is complete
+   */
 
-      wdog->next = NULL;
-      WDOG_CLRACTIVE(wdog);
+  flags = wd_lock();
 
-      /* Return success */
+  /* Make sure that the watchdog is initialized (non-NULL) and is still
+   * active.
+   */
 
+  if (wdog != NULL && WDOG_ISACTIVE(wdog))
+    {
+      wd_remove(wdog);
       ret = OK;
     }
 
-  leave_critical_section(flags);
+  wd_unlock(flags);
   return ret;
 }
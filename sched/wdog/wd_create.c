@@ -44,8 +44,7 @@
 
 #include <nuttx/irq.h>
 #include <nuttx/wdog.h>
-#include <nuttx/wdog.h>
-#include <nuttx/kmalloc.h>
+#include <nuttx/mm/mempool.h>
 
 #include "wdog/wdog.h"
 
@@ -72,73 +71,22 @@
 WDOG_ID wd_create (void)
 {
   FAR struct wdog_s *wdog;
-  irqstate_t flags;
 
-  /* These actions must be atomic with respect to other tasks and also with
-   * respect to interrupt handlers that may be allocating or freeing watchdog
-   * timers.
+  /* Take a watchdog from the pool.  Interrupt handlers may use the reserved
+   * watchdogs; normal tasks fall back to the kernel heap when there are
+   * not enough unreserved, pre-allocated watchdog timers.
    */
 
-  flags = enter_critical_section();
-
-  /* If we are in an interrupt handler -OR- if the number of pre-allocated
-   * timer structures exceeds the reserve, then take the next timer from
-   * the head of the free list.
-   */
-
-  if (g_wdnfree > CONFIG_WDOG_INTRESERVE || up_interrupt_context())
-    {
-      /* Remove the watchdog timer from the free list */
-
-      wdog = (FAR struct wdog_s *)sq_remfirst(&g_wdfreelist);
-
-      /* Did we get one? */
-
-      if (wdog != NULL)
-        {
-          /* Yes.. decrement the count of free, pre-allocated timers (all
-           * with interrupts disabled).
-           */
-
-          DEBUGASSERT(g_wdnfree > 0);
-          g_wdnfree--;
+  wdog = (FAR struct wdog_s *)mempool_alloc(&g_wdpool);
 
-          /* Clear the forward link and all flags */
+  /* Did we get one? */
 
-          wdog->next  = NULL;
-          wdog->flags = 0;
-        }
-      else
-        {
-          /* We didn't get one... The count should then be exactly zero */
-
-          DEBUGASSERT(g_wdnfree == 0);
-        }
-
-      leave_critical_section(flags);
-    }
-
-  /* We are in a normal tasking context AND there are not enough unreserved,
-   * pre-allocated watchdog timers.  We need to allocate one from the kernel
-   * heap.
-   */
-
-  else
+  if (wdog != NULL)
     {
-      /* We do not require that interrupts be disabled to do this. */
-
-      leave_critical_section(flags);
-      wdog = (FAR struct wdog_s *)kmm_malloc(sizeof(struct wdog_s));
-
-      /* Did we get one? */
-
-      if (wdog)
-        {
-          /* Yes.. Clear the forward link and set the allocated flag */
+      /* Yes.. Clear the forward link and all flags */
 
-          wdog->next  = NULL;
-          wdog->flags = WDOGF_ALLOCED;
-        }
+      wdog->next  = NULL;
+      wdog->flags = 0;
     }
 
   return (WDOG_ID)wdog;
@@ -71,7 +71,17 @@ int wd_gettime(WDOG_ID wdog)
 
   /* Verify the wdog */
 
-  flags = enter_critical_section();
+  flags = wd_lock();
+#ifdef CONFIG_WDOG_TIMERWHEEL
+  if (wdog != NULL && WDOG_ISACTIVE(wdog))
+    {
+      /* The expiration time is kept in absolute ticks */
+
+      int delay = (int)(wdog->expire - g_wdtickbase) - wd_elapse();
+      wd_unlock(flags);
+      return delay;
+    }
+#else
   if (wdog != NULL && WDOG_ISACTIVE(wdog))
     {
       /* Traverse the watchdog list accumulating lag times until we find the
@@ -89,12 +99,13 @@ int wd_gettime(WDOG_ID wdog)
           if (curr == wdog)
             {
               delay -= wd_elapse();
-              leave_critical_section(flags);
+              wd_unlock(flags);
               return delay;
             }
         }
     }
+#endif
 
-  leave_critical_section(flags);
+  wd_unlock(flags);
   return 0;
 }
@@ -0,0 +1,107 @@
+/****************************************************************************
+ * sched/wdog/wd_info.c
+ *
+ *   Copyright (C) 2020 Gregory Nutt. All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in
+ *    the documentation and/or other materials provided with the
+ *    distribution.
+ * 3. Neither the name NuttX nor the names of its contributors may be
+ *    used to endorse or promote products derived from this software
+ *    without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+ * FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE
+ * COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+ * INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,
+ * BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS
+ * OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED
+ * AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ * LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN
+ * ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ *
+ ****************************************************************************/
+
+/****************************************************************************
+ * Included Files
+ ****************************************************************************/
+
+#include <nuttx/config.h>
+
+#include <string.h>
+#include <assert.h>
+
+#include <nuttx/irq.h>
+#include <nuttx/wdog.h>
+
+#include "wdog/wdog.h"
+
+/****************************************************************************
+ * Public Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: wd_info
+ *
+ * Description:
+ *   Return a snapshot of the number of active watchdogs.  This walks all
+ *   active watchdogs and is intended for diagnostics only.
+ *
+ * Input Parameters:
+ *   info - Location to return the watchdog counts
+ *
+ * Returned Value:
+ *   None
+ *
+ ****************************************************************************/
+
+void wd_info(FAR struct wdinfo_s *info)
+{
+  FAR struct wdog_s *curr;
+  irqstate_t flags;
+#ifdef CONFIG_WDOG_TIMERWHEEL
+  int level;
+  int slot;
+#endif
+
+  DEBUGASSERT(info != NULL);
+  memset(info, 0, sizeof(struct wdinfo_s));
+
+  flags = wd_lock();
+
+#ifdef CONFIG_WDOG_TIMERWHEEL
+  for (level = 0; level < CONFIG_WDOG_TIMERWHEEL_LEVELS; level++)
+    {
+      for (slot = 0; slot < 32; slot++)
+        {
+          for (curr = g_wdwheel[level][slot];
+               curr != NULL;
+               curr = curr->next)
+            {
+              info->nlevel[level]++;
+            }
+        }
+
+      info->nactive += info->nlevel[level];
+    }
+#else
+  for (curr = (FAR struct wdog_s *)g_wdactivelist.head;
+       curr != NULL;
+       curr = curr->next)
+    {
+      info->nactive++;
+    }
+#endif
+
+  wd_unlock(flags);
+}
@@ -43,15 +43,33 @@
 
 #include "wdog/wdog.h"
 
+/****************************************************************************
+ * Private Data
+ ****************************************************************************/
+
+/* Storage for the pre-allocated watchdogs.  The number of watchdogs in the
+ * pool is a configuration item.
+ */
+
+static struct wdog_s g_wdstorage[CONFIG_PREALLOC_WDOGS];
+
 /****************************************************************************
  * Public Data
  ****************************************************************************/
 
-/* The g_wdfreelist data structure is a singly linked list of watchdogs
- * available to the system for delayed function use.
+/* g_wdpool is the pool of watchdog structures available to the system for
+ * delayed function use.  CONFIG_WDOG_INTRESERVE of the pre-allocated
+ * watchdogs are reserved for use by interrupt handlers.
  */
 
-sq_queue_t g_wdfreelist;
+struct mempool_s g_wdpool =
+{
+  sizeof(struct wdog_s),       /* bsize */
+  CONFIG_PREALLOC_WDOGS,       /* ninitial */
+  CONFIG_WDOG_INTRESERVE,      /* nreserve */
+  true,                        /* expand */
+  g_wdstorage                  /* ibase */
+};
 
 /* The g_wdactivelist data structure is a singly linked list ordered by
  * watchdog expiration time. When watchdog timers expire,the functions on
@@ -60,31 +78,20 @@ sq_queue_t g_wdfreelist;
 
 sq_queue_t g_wdactivelist;
 
-/* This is the number of free, pre-allocated watchdog structures in the
- * g_wdfreelist.  This value is used to enforce a reserve for interrupt
- * handlers.
- */
+/* Protects g_wdactivelist in the tick-based case (see wd_lock()) */
 
-uint16_t g_wdnfree;
+#ifndef CONFIG_SCHED_TICKLESS
+spinlock_t g_wdspinlock SP_SECTION = SP_UNLOCKED;
+#endif
 
 /* This is wdog tickbase, for wd_gettime() may called many times
  * between 2 times of wd_timer(), we use it to update wd_gettime().
  */
 
-#ifdef CONFIG_SCHED_TICKLESS
+#if defined(CONFIG_SCHED_TICKLESS) || defined(CONFIG_WDOG_TIMERWHEEL)
 clock_t g_wdtickbase;
 #endif
 
-/****************************************************************************
- * Private Data
- ****************************************************************************/
-
-/* g_wdpool is a list of pre-allocated watchdogs. The number of watchdogs
- * in the pool is a configuration item.
- */
-
-static struct wdog_s g_wdpool[CONFIG_PREALLOC_WDOGS];
-
 /****************************************************************************
  * Public Functions
  ****************************************************************************/
@@ -110,24 +117,13 @@ static struct wdog_s g_wdpool[CONFIG_PREALLOC_WDOGS];
 
 void wd_initialize(void)
 {
-  FAR struct wdog_s *wdog = g_wdpool;
-  int i;
-
-  /* Initialize watchdog lists */
+  /* Initialize the list of active watchdogs */
 
-  sq_init(&g_wdfreelist);
   sq_init(&g_wdactivelist);
 
-  /* The g_wdfreelist must be loaded at initialization time to hold the
-   * configured number of watchdogs.
+  /* Load the pool with the configured number of watchdogs.  This cannot
+   * fail because the storage is provided statically.
    */
 
-  for (i = 0; i < CONFIG_PREALLOC_WDOGS; i++)
-    {
-      sq_addlast((FAR sq_entry_t *)wdog++, &g_wdfreelist);
-    }
-
-  /* All watchdogs are free */
-
-  g_wdnfree = CONFIG_PREALLOC_WDOGS;
+  mempool_initialize(&g_wdpool, "wdog");
 }
@@ -71,6 +71,7 @@
  * Private Functions
  ****************************************************************************/
 
+#ifndef CONFIG_WDOG_TIMERWHEEL
 /****************************************************************************
  * Name: wd_expiration
  *
@@ -89,60 +90,91 @@
 static inline void wd_expiration(void)
 {
   FAR struct wdog_s *wdog;
+#ifdef CONFIG_PIC
+  FAR void *picbase;
+#endif
+  wdentry_t func;
+#if CONFIG_MAX_WDOGPARMS > 0
+  wdparm_t parm[CONFIG_MAX_WDOGPARMS];
+  int argc;
+  int i;
+#endif
+  irqstate_t flags;
 
-  /* Check if the watchdog at the head of the list is ready to run */
+  /* Process the watchdog at the head of the list as well as any other
+   * watchdogs that became ready to run at this time.  The watchdog lock is
+   * not held while the watchdog function runs; that function may restart
+   * or cancel watchdogs.
+   */
 
-  if (((FAR struct wdog_s *)g_wdactivelist.head)->lag <= 0)
+  for (; ; )
     {
-      /* Process the watchdog at the head of the list as well as any
-       * other watchdogs that became ready to run at this time
+      flags = wd_lock();
+
+      /* Check if the watchdog at the head of the list is ready to run */
+
+      wdog = (FAR struct wdog_s *)g_wdactivelist.head;
+      if (wdog == NULL || wdog->lag > 0)
+        {
+          wd_unlock(flags);
+          break;
+        }
+
+      /* Remove the watchdog from the head of the list */
+
+      sq_remfirst(&g_wdactivelist);
+
+      /* If there is another watchdog behind this one, update its
+       * its lag (this shouldn't be necessary).
        */
 
-      while (g_wdactivelist.head &&
-             ((FAR struct wdog_s *)g_wdactivelist.head)->lag <= 0)
+      if (g_wdactivelist.head)
         {
-          /* Remove the watchdog from the head of the list */
+          ((FAR struct wdog_s *)g_wdactivelist.head)->lag += wdog->lag;
+        }
 
-          wdog = (FAR struct wdog_s *)sq_remfirst(&g_wdactivelist);
+      /* Indicate that the watchdog is no longer active. */
 
-          /* If there is another watchdog behind this one, update its
-           * its lag (this shouldn't be necessary).
-           */
+      WDOG_CLRACTIVE(wdog);
 
-          if (g_wdactivelist.head)
-            {
-              ((FAR struct wdog_s *)g_wdactivelist.head)->lag += wdog->lag;
-            }
+      /* Capture the watchdog function and its parameters while the lock is
+       * held.  The watchdog may be restarted as soon as it is released.
+       */
 
-          /* Indicate that the watchdog is no longer active. */
+      func    = wdog->func;
+#ifdef CONFIG_PIC
+      picbase = wdog->picbase;
+#endif
+#if CONFIG_MAX_WDOGPARMS > 0
+      argc    = wdog->argc;
+      for (i = 0; i < CONFIG_MAX_WDOGPARMS; i++)
+        {
+          parm[i] = wdog->parm[i];
+        }
+#endif
 
-          WDOG_CLRACTIVE(wdog);
+      wd_unlock(flags);
 
-          /* Execute the watchdog function */
+      /* Execute the watchdog function */
 
-          up_setpicbase(wdog->picbase);
+      up_setpicbase(picbase);
 
 #if CONFIG_MAX_WDOGPARMS == 0
-          wdog->func(0);
+      func(0);
 #elif CONFIG_MAX_WDOGPARMS == 1
-          wdog->func((int)wdog->argc,
-                     wdog->parm[0]);
+      func(argc, parm[0]);
 #elif CONFIG_MAX_WDOGPARMS == 2
-          wdog->func((int)wdog->argc,
-                     wdog->parm[0], wdog->parm[1]);
+      func(argc, parm[0], parm[1]);
 #elif CONFIG_MAX_WDOGPARMS == 3
-          wdog->func((int)wdog->argc,
-                     wdog->parm[0], wdog->parm[1], wdog->parm[2]);
+      func(argc, parm[0], parm[1], parm[2]);
 #elif CONFIG_MAX_WDOGPARMS == 4
-          wdog->func((int)wdog->argc,
-                     wdog->parm[0], wdog->parm[1], wdog->parm[2],
-                     wdog->parm[3]);
+      func(argc, parm[0], parm[1], parm[2], parm[3]);
 #else
 #  error Missing support
 #endif
-        }
     }
 }
+#endif /* !CONFIG_WDOG_TIMERWHEEL */
 
 /****************************************************************************
  * Public Functions
@@ -205,10 +237,10 @@ int wd_start(WDOG_ID wdog, int32_t delay, wdentry_t wdentry,  int argc, ...)
    * the critical section is established.
    */
 
-  flags = enter_critical_section();
+  flags = wd_lock();
   if (WDOG_ISACTIVE(wdog))
     {
-      wd_cancel(wdog);
+      wd_remove(wdog);
     }
 
   /* Save the data in the watchdog structure */
@@ -253,6 +285,12 @@ int wd_start(WDOG_ID wdog, int32_t delay, wdentry_t wdentry,  int argc, ...)
   sched_timer_cancel();
 #endif
 
+#ifdef CONFIG_WDOG_TIMERWHEEL
+  /* Add the watchdog to the timer wheel and mark it as active. */
+
+  wd_wheel_insert(wdog, delay);
+  WDOG_SETACTIVE(wdog);
+#else
   /* Do the easy case first -- when the watchdog timer queue is empty. */
 
   if (g_wdactivelist.head == NULL)
@@ -347,6 +385,7 @@ int wd_start(WDOG_ID wdog, int32_t delay, wdentry_t wdentry,  int argc, ...)
 
   wdog->lag = delay;
   WDOG_SETACTIVE(wdog);
+#endif /* CONFIG_WDOG_TIMERWHEEL */
 
 #ifdef CONFIG_SCHED_TICKLESS
   /* Resume the interval timer that will generate the next interval event.
@@ -357,7 +396,7 @@ int wd_start(WDOG_ID wdog, int32_t delay, wdentry_t wdentry,  int argc, ...)
   sched_timer_resume();
 #endif
 
-  leave_critical_section(flags);
+  wd_unlock(flags);
   return OK;
 }
 
@@ -386,6 +425,7 @@ int wd_start(WDOG_ID wdog, int32_t delay, wdentry_t wdentry,  int argc, ...)
  *
  ****************************************************************************/
 
+#ifndef CONFIG_WDOG_TIMERWHEEL
 #ifdef CONFIG_SCHED_TICKLESS
 unsigned int wd_timer(int ticks)
 {
@@ -393,6 +433,7 @@ unsigned int wd_timer(int ticks)
 #ifdef CONFIG_SMP
   irqstate_t flags;
 #endif
+  irqstate_t lflags;
   unsigned int ret;
   int decr;
 
@@ -411,6 +452,7 @@ unsigned int wd_timer(int ticks)
 
   /* Check if there are any active watchdogs to process */
 
+  lflags = wd_lock();
   while (g_wdactivelist.head != NULL && ticks > 0)
     {
       /* Get the watchdog at the head of the list */
@@ -437,7 +479,9 @@ unsigned int wd_timer(int ticks)
 
       /* Check if the watchdog at the head of the list is ready to run */
 
+      wd_unlock(lflags);
       wd_expiration();
+      lflags = wd_lock();
     }
 
   /* Update clock tickbase */
@@ -448,6 +492,7 @@ unsigned int wd_timer(int ticks)
 
   ret = g_wdactivelist.head ?
           ((FAR struct wdog_s *)g_wdactivelist.head)->lag : 0;
+  wd_unlock(lflags);
 
 #ifdef CONFIG_SMP
   leave_critical_section(flags);
@@ -461,6 +506,8 @@ unsigned int wd_timer(int ticks)
 #else
 void wd_timer(void)
 {
+  FAR struct wdog_s *wdog;
+  irqstate_t lflags;
 #ifdef CONFIG_SMP
   irqstate_t flags;
 
@@ -478,14 +525,21 @@ void wd_timer(void)
 
   /* Check if there are any active watchdogs to process */
 
-  if (g_wdactivelist.head)
+  lflags = wd_lock();
+  wdog   = (FAR struct wdog_s *)g_wdactivelist.head;
+  if (wdog != NULL)
     {
       /* There are.  Decrement the lag counter */
 
-      --(((FAR struct wdog_s *)g_wdactivelist.head)->lag);
+      wdog->lag--;
+    }
 
-      /* Check if the watchdog at the head of the list is ready to run */
+  wd_unlock(lflags);
+
+  /* Check if the watchdog at the head of the list is ready to run */
 
+  if (wdog != NULL)
+    {
       wd_expiration();
     }
 
@@ -494,3 +548,4 @@ void wd_timer(void)
 #endif
 }
 #endif /* CONFIG_SCHED_TICKLESS */
+#endif /* !CONFIG_WDOG_TIMERWHEEL */
@@ -0,0 +1,569 @@
+/****************************************************************************
+ * sched/wdog/wd_wheel.c
+ *
+ *   Copyright (C) 2020 Gregory Nutt. All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in
+ *    the documentation and/or other materials provided with the
+ *    distribution.
+ * 3. Neither the name NuttX nor the names of its contributors may be
+ *    used to endorse or promote products derived from this software
+ *    without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+ * FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE
+ * COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+ * INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,
+ * BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS
+ * OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED
+ * AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ * LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN
+ * ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ *
+ ****************************************************************************/
+
+/****************************************************************************
+ * Included Files
+ ****************************************************************************/
+
+#include <nuttx/config.h>
+
+#include <sys/types.h>
+#include <stdint.h>
+#include <stdbool.h>
+#include <strings.h>
+#include <limits.h>
+#include <assert.h>
+
+#include <nuttx/irq.h>
+#include <nuttx/arch.h>
+#include <nuttx/wdog.h>
+
+#include "sched/sched.h"
+#include "wdog/wdog.h"
+
+#ifdef CONFIG_WDOG_TIMERWHEEL
+
+/****************************************************************************
+ * Pre-processor Definitions
+ ****************************************************************************/
+
+/* Each level of the wheel has 32 buckets so that the non-empty buckets of
+ * a level can be tracked in one 32-bit bitmap.  A watchdog is kept in
+ * level n when it expires between 32^n and 32^(n+1) - 1 ticks from
+ * g_wdtickbase.  When the time reaches the start of a bucket of level n > 0,
+ * the watchdogs of that bucket are re-inserted ("cascaded") into the lower
+ * levels.  All watchdogs in the current bucket of level 0 are due.
+ */
+
+#define WHEEL_SHIFT       5
+#define WHEEL_SLOTS       (1 << WHEEL_SHIFT)
+#define WHEEL_MASK        (WHEEL_SLOTS - 1)
+#define WHEEL_LEVELS      CONFIG_WDOG_TIMERWHEEL_LEVELS
+
+/* The number of ticks covered by the wheel.  Longer delays are parked in
+ * the top level and cascaded again.
+ */
+
+#define WHEEL_RANGE       ((clock_t)1 << (WHEEL_SHIFT * WHEEL_LEVELS))
+
+#define WHEEL_LEVEL(b)    ((b) >> WHEEL_SHIFT)
+#define WHEEL_SLOT(b)     ((b) & WHEEL_MASK)
+
+/****************************************************************************
+ * Public Data
+ ****************************************************************************/
+
+/* The buckets of the timer wheel and a bitmap of the non-empty buckets of
+ * each level.
+ */
+
+FAR struct wdog_s *g_wdwheel[CONFIG_WDOG_TIMERWHEEL_LEVELS][32];
+uint32_t g_wdwheelmap[CONFIG_WDOG_TIMERWHEEL_LEVELS];
+
+/****************************************************************************
+ * Private Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: wd_wheel_isempty
+ *
+ * Description:
+ *   Return true if there are no watchdogs in the wheel.
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_SCHED_TICKLESS
+static bool wd_wheel_isempty(void)
+{
+  int level;
+
+  for (level = 0; level < WHEEL_LEVELS; level++)
+    {
+      if (g_wdwheelmap[level] != 0)
+        {
+          return false;
+        }
+    }
+
+  return true;
+}
+#endif
+
+/****************************************************************************
+ * Name: wd_wheel_link
+ *
+ * Description:
+ *   Add a watchdog to the bucket selected by its expiration time relative
+ *   to g_wdtickbase.
+ *
+ ****************************************************************************/
+
+static void wd_wheel_link(FAR struct wdog_s *wdog)
+{
+  clock_t when  = wdog->expire;
+  clock_t delta = when - g_wdtickbase;
+  int level;
+  int slot;
+
+  /* Park delays beyond the range of the wheel in the last bucket of the
+   * top level.  The watchdog is re-inserted when that bucket is cascaded.
+   */
+
+  if (delta >= WHEEL_RANGE)
+    {
+      delta = WHEEL_RANGE - 1;
+      when  = g_wdtickbase + delta;
+    }
+
+  for (level = 0;
+       level < WHEEL_LEVELS - 1 &&
+       delta >= ((clock_t)1 << (WHEEL_SHIFT * (level + 1)));
+       level++);
+
+  slot = (when >> (WHEEL_SHIFT * level)) & WHEEL_MASK;
+
+  /* Add the watchdog at the head of the bucket */
+
+  wdog->prev = NULL;
+  wdog->next = g_wdwheel[level][slot];
+  if (wdog->next != NULL)
+    {
+      wdog->next->prev = wdog;
+    }
+
+  g_wdwheel[level][slot] = wdog;
+  g_wdwheelmap[level]   |= (uint32_t)1 << slot;
+  wdog->bucket           = (level << WHEEL_SHIFT) | slot;
+}
+
+/****************************************************************************
+ * Name: wd_wheel_next
+ *
+ * Description:
+ *   Return the number of ticks from g_wdtickbase to the next bucket that
+ *   must be processed, either because its watchdogs expire (level 0) or
+ *   because they must be cascaded (higher levels).  The current bucket of
+ *   level 0 is not considered.  Zero is returned if the wheel is empty.
+ *
+ ****************************************************************************/
+
+static clock_t wd_wheel_next(void)
+{
+  clock_t next = 0;
+  clock_t delta;
+  clock_t index;
+  uint32_t map;
+  int shift;
+  int start;
+  int level;
+
+  for (level = 0; level < WHEEL_LEVELS; level++)
+    {
+      map = g_wdwheelmap[level];
+      if (map == 0)
+        {
+          continue;
+        }
+
+      /* Rotate the bitmap so that bit 0 corresponds to the bucket after
+       * the current one.  The bucket is then ffs() buckets away.
+       */
+
+      shift = WHEEL_SHIFT * level;
+      index = g_wdtickbase >> shift;
+      start = (int)((index + 1) & WHEEL_MASK);
+      map   = (map >> start) | (map << ((WHEEL_SLOTS - start) & WHEEL_MASK));
+
+      delta = ((index + ffs(map)) << shift) - g_wdtickbase;
+      if (next == 0 || delta < next)
+        {
+          next = delta;
+        }
+    }
+
+  return next;
+}
+
+/****************************************************************************
+ * Name: wd_wheel_cascade
+ *
+ * Description:
+ *   Re-insert the watchdogs of the buckets of the higher levels that start
+ *   at g_wdtickbase.  Watchdogs that expire now end up in the current bucket
+ *   of level 0.
+ *
+ ****************************************************************************/
+
+static void wd_wheel_cascade(void)
+{
+  FAR struct wdog_s *wdog;
+  FAR struct wdog_s *next;
+  int shift;
+  int level;
+  int slot;
+
+  /* Work from the top down: a watchdog cascaded from one level may land in
+   * a bucket of the next level that starts now as well.
+   */
+
+  for (level = WHEEL_LEVELS - 1; level > 0; level--)
+    {
+      shift = WHEEL_SHIFT * level;
+      if ((g_wdtickbase & (((clock_t)1 << shift) - 1)) != 0)
+        {
+          continue;
+        }
+
+      slot = (g_wdtickbase >> shift) & WHEEL_MASK;
+      wdog = g_wdwheel[level][slot];
+      if (wdog == NULL)
+        {
+          continue;
+        }
+
+      g_wdwheel[level][slot] = NULL;
+      g_wdwheelmap[level]   &= ~((uint32_t)1 << slot);
+
+      for (; wdog != NULL; wdog = next)
+        {
+          next = wdog->next;
+          wd_wheel_link(wdog);
+        }
+    }
+}
+
+/****************************************************************************
+ * Name: wd_wheel_expire
+ *
+ * Description:
+ *   Remove one watchdog from the current bucket of level 0 and execute it.
+ *   The watchdog lock is released while the watchdog function runs; that
+ *   function may restart or cancel watchdogs.
+ *
+ * Returned Value:
+ *   True if a watchdog was taken from the bucket; false if the bucket is
+ *   empty.
+ *
+ * Assumptions:
+ *   Called with wd_lock() held.  The lock is held again on return, but
+ *   *flags may have been updated.
+ *
+ ****************************************************************************/
+
+static bool wd_wheel_expire(FAR irqstate_t *flags)
+{
+  FAR struct wdog_s *wdog;
+#ifdef CONFIG_PIC
+  FAR void *picbase;
+#endif
+  wdentry_t func;
+#if CONFIG_MAX_WDOGPARMS > 0
+  wdparm_t parm[CONFIG_MAX_WDOGPARMS];
+  int argc;
+  int i;
+#endif
+
+  wdog = g_wdwheel[0][g_wdtickbase & WHEEL_MASK];
+  if (wdog == NULL)
+    {
+      return false;
+    }
+
+  /* Remove the watchdog from the bucket.  With a single level, long delays
+   * are parked in level 0 and are simply moved on.
+   */
+
+  wd_wheel_remove(wdog);
+  if (wdog->expire != g_wdtickbase)
+    {
+      wd_wheel_link(wdog);
+      return true;
+    }
+
+  /* Indicate that the watchdog is no longer active */
+
+  WDOG_CLRACTIVE(wdog);
+
+  /* Capture the watchdog function and its parameters while the lock is
+   * held.  The watchdog may be restarted as soon as it is released.
+   */
+
+  func    = wdog->func;
+#ifdef CONFIG_PIC
+  picbase = wdog->picbase;
+#endif
+#if CONFIG_MAX_WDOGPARMS > 0
+  argc    = wdog->argc;
+  for (i = 0; i < CONFIG_MAX_WDOGPARMS; i++)
+    {
+      parm[i] = wdog->parm[i];
+    }
+#endif
+
+  wd_unlock(*flags);
+
+  /* Execute the watchdog function */
+
+  up_setpicbase(picbase);
+
+#if CONFIG_MAX_WDOGPARMS == 0
+  func(0);
+#elif CONFIG_MAX_WDOGPARMS == 1
+  func(argc, parm[0]);
+#elif CONFIG_MAX_WDOGPARMS == 2
+  func(argc, parm[0], parm[1]);
+#elif CONFIG_MAX_WDOGPARMS == 3
+  func(argc, parm[0], parm[1], parm[2]);
+#elif CONFIG_MAX_WDOGPARMS == 4
+  func(argc, parm[0], parm[1], parm[2], parm[3]);
+#else
+#  error Missing support
+#endif
+
+  *flags = wd_lock();
+  return true;
+}
+
+/****************************************************************************
+ * Name: wd_wheel_advance
+ *
+ * Description:
+ *   Advance the wheel by the given number of ticks, executing the
+ *   watchdogs that expire on the way.  Empty stretches of time are skipped
+ *   in one step.
+ *
+ * Returned Value:
+ *   The number of ticks until the next bucket must be processed, or zero if
+ *   there are no active watchdogs.
+ *
+ ****************************************************************************/
+
+static clock_t wd_wheel_advance(clock_t ticks)
+{
+  irqstate_t flags;
+  clock_t next;
+
+  flags = wd_lock();
+  for (; ; )
+    {
+      /* Execute everything that is due at the current time first.  This
+       * also completes the work of an outer call if a watchdog function
+       * causes wd_timer() to be re-entered.
+       */
+
+      if (wd_wheel_expire(&flags))
+        {
+          continue;
+        }
+
+      next = wd_wheel_next();
+      if (next == 0 || next > ticks)
+        {
+          g_wdtickbase += ticks;
+          break;
+        }
+
+      g_wdtickbase += next;
+      ticks        -= next;
+      wd_wheel_cascade();
+    }
+
+  next = wd_wheel_next();
+  wd_unlock(flags);
+  return next;
+}
+
+/****************************************************************************
+ * Public Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: wd_wheel_insert
+ *
+ * Description:
+ *   Add a watchdog to the timer wheel so that it expires after the given
+ *   number of ticks.
+ *
+ * Input Parameters:
+ *   wdog  - The inactive watchdog to add.
+ *   delay - The delay in ticks (at least one).
+ *
+ * Returned Value:
+ *   None
+ *
+ * Assumptions:
+ *   The caller holds wd_lock().
+ *
+ ****************************************************************************/
+
+void wd_wheel_insert(FAR struct wdog_s *wdog, int32_t delay)
+{
+  DEBUGASSERT(delay > 0);
+
+#ifdef CONFIG_SCHED_TICKLESS
+  /* If no watchdog is active, nothing depends on the wheel time.  Re-sync
+   * it with the system timer, as the list-based logic does.
+   */
+
+  if (wd_wheel_isempty())
+    {
+      g_wdtickbase = clock_systimer();
+    }
+#endif
+
+  wdog->expire = g_wdtickbase + delay;
+  wd_wheel_link(wdog);
+}
+
+/****************************************************************************
+ * Name: wd_wheel_remove
+ *
+ * Description:
+ *   Remove a watchdog from the timer wheel.
+ *
+ * Input Parameters:
+ *   wdog - The active watchdog to remove.
+ *
+ * Returned Value:
+ *   True if the bucket of the watchdog became empty, i.e., the time of the
+ *   next timer event may have changed.
+ *
+ * Assumptions:
+ *   The caller holds wd_lock().
+ *
+ ****************************************************************************/
+
+bool wd_wheel_remove(FAR struct wdog_s *wdog)
+{
+  int level = WHEEL_LEVEL(wdog->bucket);
+  int slot  = WHEEL_SLOT(wdog->bucket);
+
+  DEBUGASSERT(level < WHEEL_LEVELS);
+
+  if (wdog->prev != NULL)
+    {
+      wdog->prev->next = wdog->next;
+    }
+  else
+    {
+      DEBUGASSERT(g_wdwheel[level][slot] == wdog);
+      g_wdwheel[level][slot] = wdog->next;
+    }
+
+  if (wdog->next != NULL)
+    {
+      wdog->next->prev = wdog->prev;
+    }
+
+  wdog->next = NULL;
+  wdog->prev = NULL;
+
+  if (g_wdwheel[level][slot] == NULL)
+    {
+      g_wdwheelmap[level] &= ~((uint32_t)1 << slot);
+      return true;
+    }
+
+  return false;
+}
+
+/****************************************************************************
+ * Name: wd_timer
+ *
+ * Description:
+ *   This function is called from the timer interrupt handler to determine
+ *   if it is time to execute a watchdog function.  If so, the watchdog
+ *   function will be executed in the context of the timer interrupt
+ *   handler.
+ *
+ * Input Parameters:
+ *   ticks - If CONFIG_SCHED_TICKLESS is defined then the number of ticks
+ *     in the interval that just expired is provided.  Otherwise,
+ *     this function is called on each timer interrupt and a value of one
+ *     is implicit.
+ *
+ * Returned Value:
+ *   If CONFIG_SCHED_TICKLESS is defined then the number of ticks for the
+ *   next delay is provided (zero if no delay).  Otherwise, this function
+ *   has no returned value.
+ *
+ * Assumptions:
+ *   Called from interrupt handler logic with interrupts disabled.
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_SCHED_TICKLESS
+unsigned int wd_timer(int ticks)
+#else
+void wd_timer(void)
+#endif
+{
+#ifdef CONFIG_SMP
+  irqstate_t flags;
+#endif
+#ifdef CONFIG_SCHED_TICKLESS
+  clock_t next;
+#endif
+
+#ifdef CONFIG_SMP
+  /* We are in an interrupt handler as, as a consequence, interrupts are
+   * disabled.  But in the SMP case, interrupts MAY be disabled only on
+   * the local CPU since most architectures do not permit disabling
+   * interrupts on other CPUS.
+   *
+   * Hence, we must follow rules for critical sections even here in the
+   * SMP case.
+   */
+
+  flags = enter_critical_section();
+#endif
+
+#ifdef CONFIG_SCHED_TICKLESS
+  next = wd_wheel_advance(ticks > 0 ? ticks : 0);
+#else
+  wd_wheel_advance(1);
+#endif
+
+#ifdef CONFIG_SMP
+  leave_critical_section(flags);
+#endif
+
+#ifdef CONFIG_SCHED_TICKLESS
+  /* Return the delay for the next wheel event */
+
+  return next > UINT_MAX ? UINT_MAX : (unsigned int)next;
+#endif
+}
+
+#endif /* CONFIG_WDOG_TIMERWHEEL */
@@ -47,7 +47,10 @@
 
 #include <nuttx/compiler.h>
 #include <nuttx/clock.h>
+#include <nuttx/irq.h>
+#include <nuttx/spinlock.h>
 #include <nuttx/wdog.h>
+#include <nuttx/mm/mempool.h>
 
 /****************************************************************************
  * Pre-processor Definitions
@@ -70,6 +73,27 @@
 #  define wd_elapse() (0)
 #endif
 
+/****************************************************************************
+ * Name: wd_lock and wd_unlock
+ *
+ * Description:
+ *   Protect the active watchdog list.  In the tick-based case this is the
+ *   watchdog spinlock, so watchdog operations on one CPU do not stall
+ *   unrelated critical sections on the others.  In the tickless case,
+ *   wd_start() and wd_cancel() reprogram the interval timer which may call
+ *   back into wd_timer() on the same CPU, so the nestable critical section
+ *   is used instead.
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_SCHED_TICKLESS
+#  define wd_lock()      enter_critical_section()
+#  define wd_unlock(f)   leave_critical_section(f)
+#else
+#  define wd_lock()      spin_lock_irqsave(&g_wdspinlock)
+#  define wd_unlock(f)   spin_unlock_irqrestore(&g_wdspinlock, f)
+#endif
+
 /****************************************************************************
  * Public Data
  ****************************************************************************/
@@ -82,11 +106,13 @@ extern "C"
 #define EXTERN extern
 #endif
 
-/* The g_wdfreelist data structure is a singly linked list of watchdogs
- * available to the system for delayed function use.
+/* g_wdpool is the pool of watchdog structures available to the system for
+ * delayed function use.  A few pre-allocated watchdogs are reserved for
+ * interrupt handlers; normal tasks fall back to the kernel heap when the
+ * unreserved watchdogs are exhausted.
  */
 
-extern sq_queue_t g_wdfreelist;
+extern struct mempool_s g_wdpool;
 
 /* The g_wdactivelist data structure is a singly linked list ordered by
  * watchdog expiration time. When watchdog timers expire,the functions on
@@ -95,21 +121,31 @@ extern sq_queue_t g_wdfreelist;
 
 extern sq_queue_t g_wdactivelist;
 
-/* This is the number of free, pre-allocated watchdog structures in the
- * g_wdfreelist.  This value is used to enforce a reserve for interrupt
- * handlers.
- */
+/* Protects g_wdactivelist in the tick-based case (see wd_lock()) */
 
-extern uint16_t g_wdnfree;
+#ifndef CONFIG_SCHED_TICKLESS
+extern spinlock_t g_wdspinlock;
+#endif
 
 /* This is wdog tickbase, for wd_gettime() may called many times
- * between 2 times of wd_timer(), we use it to update wd_gettime().
+ * between 2 times of wd_timer(), we use it to update wd_gettime().  The
+ * timer wheel also uses it as the time up to which the wheel has been
+ * processed.
  */
 
-#ifdef CONFIG_SCHED_TICKLESS
+#if defined(CONFIG_SCHED_TICKLESS) || defined(CONFIG_WDOG_TIMERWHEEL)
 extern clock_t g_wdtickbase;
 #endif
 
+#ifdef CONFIG_WDOG_TIMERWHEEL
+/* The buckets of the timer wheel and a bitmap of the non-empty buckets of
+ * each level.
+ */
+
+extern FAR struct wdog_s *g_wdwheel[CONFIG_WDOG_TIMERWHEEL_LEVELS][32];
+extern uint32_t g_wdwheelmap[CONFIG_WDOG_TIMERWHEEL_LEVELS];
+#endif
+
 /****************************************************************************
  * Public Function Prototypes
  ****************************************************************************/
@@ -135,6 +171,72 @@ extern clock_t g_wdtickbase;
 
 void weak_function wd_initialize(void);
 
+/****************************************************************************
+ * Name: wd_remove
+ *
+ * Description:
+ *   Remove an active watchdog from the active watchdog list and mark it
+ *   inactive.  This is the common logic of wd_cancel() and wd_start().
+ *
+ * Input Parameters:
+ *   wdog - The active watchdog to remove.
+ *
+ * Returned Value:
+ *   None
+ *
+ * Assumptions:
+ *   The caller holds wd_lock() and has verified that the watchdog is
+ *   active.
+ *
+ ****************************************************************************/
+
+void wd_remove(FAR struct wdog_s *wdog);
+
+/****************************************************************************
+ * Name: wd_wheel_insert
+ *
+ * Description:
+ *   Add a watchdog to the timer wheel so that it expires after the given
+ *   number of ticks.
+ *
+ * Input Parameters:
+ *   wdog  - The inactive watchdog to add.
+ *   delay - The delay in ticks (at least one).
+ *
+ * Returned Value:
+ *   None
+ *
+ * Assumptions:
+ *   The caller holds wd_lock().
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_WDOG_TIMERWHEEL
+void wd_wheel_insert(FAR struct wdog_s *wdog, int32_t delay);
+#endif
+
+/****************************************************************************
+ * Name: wd_wheel_remove
+ *
+ * Description:
+ *   Remove a watchdog from the timer wheel.
+ *
+ * Input Parameters:
+ *   wdog - The active watchdog to remove.
+ *
+ * Returned Value:
+ *   True if the bucket of the watchdog became empty, i.e., the time of the
+ *   next timer event may have changed.
+ *
+ * Assumptions:
+ *   The caller holds wd_lock().
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_WDOG_TIMERWHEEL
+bool wd_wheel_remove(FAR struct wdog_s *wdog);
+#endif
+
 /****************************************************************************
  * Name: wd_timer
  *
@@ -162,4 +162,30 @@ int work_cancel(int qid, FAR struct work_s *work)
     }
 }
 
+/****************************************************************************
+ * Name: work_cancel_wq
+ *
+ * Description:
+ *   Cancel work previously queued on a work queue created by
+ *   work_queue_create().  See work_cancel() for the full description.
+ *
+ * Input Parameters:
+ *   wqueue - The work queue
+ *   work   - The previously queue work structure to cancel
+ *
+ * Returned Value:
+ *   Zero (OK) on success, a negated errno on failure.  This error may be
+ *   reported:
+ *
+ *   -ENOENT - There is no such work queued.
+ *
+ ****************************************************************************/
+
+int work_cancel_wq(FAR struct kwork_wqueue_s *wqueue,
+                   FAR struct work_s *work)
+{
+  DEBUGASSERT(wqueue != NULL);
+  return work_qcancel(wqueue, work);
+}
+
 #endif /* CONFIG_SCHED_WORKQUEUE */
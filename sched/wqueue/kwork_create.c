@@ -0,0 +1,301 @@
+/****************************************************************************
+ * sched/wqueue/kwork_create.c
+ *
+ *   Copyright (C) 2020 Gregory Nutt. All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in
+ *    the documentation and/or other materials provided with the
+ *    distribution.
+ * 3. Neither the name NuttX nor the names of its contributors may be
+ *    used to endorse or promote products derived from this software
+ *    without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+ * FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE
+ * COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+ * INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,
+ * BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS
+ * OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED
+ * AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ * LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN
+ * ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ *
+ ****************************************************************************/
+
+/****************************************************************************
+ * Included Files
+ ****************************************************************************/
+
+#include <nuttx/config.h>
+
+#include <sys/types.h>
+#include <unistd.h>
+#include <sched.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <signal.h>
+#include <assert.h>
+#include <errno.h>
+#include <queue.h>
+#include <debug.h>
+
+#include <nuttx/irq.h>
+#include <nuttx/sched.h>
+#include <nuttx/signal.h>
+#include <nuttx/semaphore.h>
+#include <nuttx/wqueue.h>
+#include <nuttx/kthread.h>
+#include <nuttx/kmalloc.h>
+
+#include "wqueue/wqueue.h"
+
+#ifdef CONFIG_SCHED_WORKQUEUE
+
+/****************************************************************************
+ * Private Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: work_thread
+ *
+ * Description:
+ *   This is the worker thread of a work queue created by
+ *   work_queue_create().  Unlike the high and low priority worker threads,
+ *   it does not perform garbage collection.
+ *
+ * Input Parameters:
+ *   argc, argv - argv[1] holds the address of the work queue
+ *
+ * Returned Value:
+ *   Zero when the work queue is freed.
+ *
+ ****************************************************************************/
+
+static int work_thread(int argc, char *argv[])
+{
+  FAR struct kwork_wqueue_s *wqueue;
+  pid_t me = getpid();
+  int wndx;
+
+  DEBUGASSERT(argc > 1);
+  wqueue = (FAR struct kwork_wqueue_s *)
+    ((uintptr_t)strtoul(argv[1], NULL, 0));
+
+  /* Find out thread index by search the workers of the work queue */
+
+  for (wndx = 0; wndx < wqueue->nthreads; wndx++)
+    {
+      if (wqueue->worker[wndx].pid == me)
+        {
+          break;
+        }
+    }
+
+  DEBUGASSERT(wndx < wqueue->nthreads);
+
+  /* Process work until the work queue is freed */
+
+  while (!wqueue->exit)
+    {
+      work_process(wqueue, wndx);
+    }
+
+  /* Let work_queue_free() know that this thread is done with the work
+   * queue.  The work queue may be freed as soon as this completes.
+   */
+
+  nxsem_post(wqueue->exsem);
+  return OK;
+}
+
+/****************************************************************************
+ * Public Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: work_queue_create
+ *
+ * Description:
+ *   Create a new, named kernel-mode work queue with its own pool of worker
+ *   threads.  This lets a driver keep slow work off of the shared high and
+ *   low priority work queues.  On SMP the worker threads may be bound to a
+ *   set of CPUs, e.g. to create one work queue per CPU.
+ *
+ * Input Parameters:
+ *   name      - Name of the worker threads
+ *   priority  - Priority of the worker threads
+ *   stacksize - Stack size of each worker thread
+ *   nthreads  - Number of worker threads (at least one)
+ *   affinity  - CPUs that the worker threads may run on.  Zero means any
+ *               CPU.  Ignored if CONFIG_SMP is not enabled.
+ *
+ * Returned Value:
+ *   A reference to the new work queue on success; NULL on failure.
+ *
+ ****************************************************************************/
+
+FAR struct kwork_wqueue_s *work_queue_create(FAR const char *name,
+                                             int priority, int stacksize,
+                                             int nthreads,
+                                             cpu_set_t affinity)
+{
+  FAR struct kwork_wqueue_s *wqueue;
+  FAR char *argv[2];
+  char arg1[16];
+  pid_t pid;
+  int wndx;
+
+  if (name == NULL || nthreads < 1 || nthreads > UINT8_MAX)
+    {
+      return NULL;
+    }
+
+  /* Allocate the work queue with one kworker_s per worker thread */
+
+  wqueue = (FAR struct kwork_wqueue_s *)
+    kmm_zalloc(sizeof(struct kwork_wqueue_s) +
+               (nthreads - 1) * sizeof(struct kworker_s));
+  if (wqueue == NULL)
+    {
+      return NULL;
+    }
+
+  dq_init(&wqueue->q);
+  wqueue->nthreads = nthreads;
+
+  /* The worker threads find their work queue from their argument */
+
+  snprintf(arg1, sizeof(arg1), "0x%lx", (unsigned long)(uintptr_t)wqueue);
+  argv[0] = arg1;
+  argv[1] = NULL;
+
+  /* Don't permit any of the threads to run until we have fully initialized
+   * the work queue.
+   */
+
+  sched_lock();
+
+  sinfo("Starting %d worker thread(s) for '%s'\n", nthreads, name);
+
+  for (wndx = 0; wndx < nthreads; wndx++)
+    {
+      pid = kthread_create(name, priority, stacksize,
+                           (main_t)work_thread,
+                           (FAR char * const *)argv);
+
+      DEBUGASSERT(pid > 0);
+      if (pid < 0)
+        {
+          serr("ERROR: kthread_create %d failed: %d\n", wndx, (int)pid);
+          break;
+        }
+
+#ifdef CONFIG_SMP
+      if (affinity != 0)
+        {
+          int ret = nxsched_setaffinity(pid, sizeof(cpu_set_t), &affinity);
+          DEBUGASSERT(ret >= 0);
+          UNUSED(ret);
+        }
+#endif
+
+      wqueue->worker[wndx].pid  = pid;
+      wqueue->worker[wndx].busy = true;
+    }
+
+  if (wndx < nthreads)
+    {
+      /* Stop the threads that were started, then give up */
+
+      wqueue->nthreads = wndx;
+      sched_unlock();
+
+      work_queue_free(wqueue);
+      return NULL;
+    }
+
+  sched_unlock();
+  return wqueue;
+}
+
+/****************************************************************************
+ * Name: work_queue_free
+ *
+ * Description:
+ *   Stop the worker threads of a work queue created by work_queue_create()
+ *   and free the work queue.  Work that is still queued is discarded; the
+ *   caller must have cancelled any work that it still cares about.
+ *
+ * Input Parameters:
+ *   wqueue - The work queue to be freed.
+ *
+ * Returned Value:
+ *   Zero on success, a negated errno on failure
+ *
+ ****************************************************************************/
+
+int work_queue_free(FAR struct kwork_wqueue_s *wqueue)
+{
+  irqstate_t flags;
+  sem_t exsem;
+  int wndx;
+
+  if (wqueue == NULL
+#ifdef CONFIG_SCHED_HPWORK
+      || wqueue == (FAR struct kwork_wqueue_s *)&g_hpwork
+#endif
+#ifdef CONFIG_SCHED_LPWORK
+      || wqueue == (FAR struct kwork_wqueue_s *)&g_lpwork
+#endif
+     )
+    {
+      return -EINVAL;
+    }
+
+  /* This semaphore is used for signaling and, hence, should not have
+   * priority inheritance enabled.
+   */
+
+  nxsem_init(&exsem, 0, 0);
+  nxsem_setprotocol(&exsem, SEM_PRIO_NONE);
+
+  /* Tell every worker thread to exit.  This must be done in a critical
+   * section so that no worker can check the exit flag and then wait for a
+   * signal that was already sent.
+   */
+
+  flags = enter_critical_section();
+  wqueue->exsem = &exsem;
+  wqueue->exit  = true;
+
+  for (wndx = 0; wndx < wqueue->nthreads; wndx++)
+    {
+      nxsig_kill(wqueue->worker[wndx].pid, SIGWORK);
+    }
+
+  leave_critical_section(flags);
+
+  /* Wait for all of the worker threads to exit */
+
+  for (wndx = 0; wndx < wqueue->nthreads; wndx++)
+    {
+      nxsem_wait_uninterruptible(&exsem);
+    }
+
+  nxsem_destroy(&exsem);
+  kmm_free(wqueue);
+  return OK;
+}
+
+#endif /* CONFIG_SCHED_WORKQUEUE */
@@ -188,6 +188,7 @@ int work_hpstart(void)
    */
 
   sched_lock();
+  g_hpwork.nthreads = CONFIG_SCHED_HPNTHREADS;
 
   /* Start the high-priority, kernel mode worker thread(s) */
 
@@ -184,6 +184,7 @@ int work_lpstart(void)
    */
 
   sched_lock();
+  g_lpwork.nthreads = CONFIG_SCHED_LPNTHREADS;
 
   /* Start the low-priority, kernel mode worker thread(s) */
 
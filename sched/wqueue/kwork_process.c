@@ -106,9 +106,6 @@ void work_process(FAR struct kwork_wqueue_s *wqueue, int wndx)
   irqstate_t flags;
   FAR void *arg;
   clock_t elapsed;
-  clock_t remaining;
-  clock_t stick;
-  clock_t ctick;
   clock_t next;
 
   /* Then process queued work.  We need to keep interrupts disabled while
@@ -118,13 +115,12 @@ void work_process(FAR struct kwork_wqueue_s *wqueue, int wndx)
   next  = WORK_DELAY_MAX;
   flags = enter_critical_section();
 
-  /* Get the time that we started processing the queue in clock ticks. */
-
-  stick = clock_systimer();
-
   /* And check each entry in the work queue.  Since we have disabled
    * interrupts we know:  (1) we will not be suspended unless we do
    * so ourselves, and (2) there will be no changes to the work queue
+   *
+   * The work queue is sorted by expiration time (see work_qqueue()), so
+   * only the ready work at the head of the queue needs to be examined.
    */
 
   work = (FAR struct work_s *)wqueue->q.head;
@@ -136,88 +132,63 @@ void work_process(FAR struct kwork_wqueue_s *wqueue, int wndx)
        * zero.  Therefore a delay of zero will always execute immediately.
        */
 
-      ctick   = clock_systimer();
-      elapsed = ctick - work->qtime;
-      if (elapsed >= work->delay)
+      elapsed = clock_systimer() - work->qtime;
+      if (elapsed < work->delay)
         {
-          /* Remove the ready-to-execute work from the list */
-
-          dq_rem((struct dq_entry_s *)work, &wqueue->q);
-
-          /* Extract the work description from the entry (in case the work
-           * instance by the re-used after it has been de-queued).
+          /* This one is not ready and neither is any work after it.
+           * Schedule to wake up when it is ready.
            */
 
-          worker = work->worker;
+          next = work->delay - elapsed;
+          break;
+        }
 
-          /* Check for a race condition where the work may be nullified
-           * before it is removed from the queue.
-           */
+      /* Remove the ready-to-execute work from the list */
 
-          if (worker != NULL)
-            {
-              /* Extract the work argument (before re-enabling interrupts) */
+      dq_rem((struct dq_entry_s *)work, &wqueue->q);
 
-              arg = work->arg;
+      /* Extract the work description from the entry (in case the work
+       * instance by the re-used after it has been de-queued).
+       */
 
-              /* Mark the work as no longer being queued */
+      worker = work->worker;
 
-              work->worker = NULL;
+      /* Check for a race condition where the work may be nullified
+       * before it is removed from the queue.
+       */
 
-              /* Do the work.  Re-enable interrupts while the work is being
-               * performed... we don't have any idea how long this will take!
-               */
+      if (worker != NULL)
+        {
+          /* Extract the work argument (before re-enabling interrupts) */
 
-              leave_critical_section(flags);
-              worker(arg);
+          arg = work->arg;
 
-              /* Now, unfortunately, since we re-enabled interrupts we don't
-               * know the state of the work list and we will have to start
-               * back at the head of the list.
-               */
+          /* Mark the work as no longer being queued */
 
-              flags = enter_critical_section();
-              work  = (FAR struct work_s *)wqueue->q.head;
-            }
-          else
-            {
-              /* Cancelled.. Just move to the next work in the list with
-               * interrupts still disabled.
-               */
+          work->worker = NULL;
 
-              work = (FAR struct work_s *)work->dq.flink;
-            }
-        }
-      else /* elapsed < work->delay */
-        {
-          /* This one is not ready.
-           *
-           * NOTE that elapsed is relative to the current time,
-           * not the time of beginning of this queue processing pass.
-           * So it may need an adjustment.
+          /* Do the work.  Re-enable interrupts while the work is being
+           * performed... we don't have any idea how long this will take!
            */
 
-          elapsed += (ctick - stick);
-          if (elapsed > work->delay)
-            {
-              /* The delay has expired while we are processing */
+          leave_critical_section(flags);
+          worker(arg);
 
-              elapsed = work->delay;
-            }
-
-          /* Will it be ready before the next scheduled wakeup interval? */
-
-          remaining = work->delay - elapsed;
-          if (remaining < next)
-            {
-              /* Yes.. Then schedule to wake up when the work is ready */
-
-              next = remaining;
-            }
+          /* Now, unfortunately, since we re-enabled interrupts we don't
+           * know the state of the work list and we will have to start
+           * back at the head of the list.
+           */
 
-          /* Then try the next in the list. */
+          flags = enter_critical_section();
+          work  = (FAR struct work_s *)wqueue->q.head;
+        }
+      else
+        {
+          /* Cancelled.. Just move to the next work in the list with
+           * interrupts still disabled.
+           */
 
-          work = (FAR struct work_s *)work->dq.flink;
+          work = (FAR struct work_s *)wqueue->q.head;
         }
     }
 
@@ -230,6 +201,18 @@ void work_process(FAR struct kwork_wqueue_s *wqueue, int wndx)
    * over the queue again.
    */
 
+  if (wqueue->exit)
+    {
+      /* The work queue is being freed.  Don't wait; return so that the
+       * worker thread can exit.  The exit flag is set and the workers are
+       * signalled inside of the critical section, so this check cannot miss
+       * the wake-up.
+       */
+
+      leave_critical_section(flags);
+      return;
+    }
+
   if (wndx > 0 || next == WORK_DELAY_MAX)
     {
       sigset_t set;
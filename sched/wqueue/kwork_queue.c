@@ -53,10 +53,33 @@
 
 #ifdef CONFIG_SCHED_WORKQUEUE
 
+/****************************************************************************
+ * Pre-processor Definitions
+ ****************************************************************************/
+
+#ifndef CONFIG_SCHED_WORKSLACK
+#  define CONFIG_SCHED_WORKSLACK 0
+#endif
+
 /****************************************************************************
  * Private Functions
  ****************************************************************************/
 
+/****************************************************************************
+ * Name: work_remaining
+ *
+ * Description:
+ *   Return the number of clock ticks until the work becomes due, or zero if
+ *   it is already due.
+ *
+ ****************************************************************************/
+
+static inline clock_t work_remaining(FAR struct work_s *work, clock_t ctick)
+{
+  clock_t elapsed = ctick - work->qtime;
+  return elapsed >= work->delay ? 0 : work->delay - elapsed;
+}
+
 /****************************************************************************
  * Name: work_qqueue
  *
@@ -90,7 +113,10 @@ static void work_qqueue(FAR struct kwork_wqueue_s *wqueue,
                         FAR struct work_s *work, worker_t worker,
                         FAR void *arg, clock_t delay)
 {
+  FAR struct work_s *next;
   irqstate_t flags;
+  clock_t remaining;
+  clock_t ctick;
 
   DEBUGASSERT(work != NULL && worker != NULL);
 
@@ -104,8 +130,8 @@ static void work_qqueue(FAR struct kwork_wqueue_s *wqueue,
 
   if (work->worker != NULL)
     {
-      /* Remove the entry from the work queue.  It will re requeued at the
-       * end of the work queue.
+      /* Remove the entry from the work queue.  It will be requeued
+       * according to its new expiration time.
        */
 
       dq_rem((FAR dq_entry_t *)work, &wqueue->q);
@@ -117,11 +143,50 @@ static void work_qqueue(FAR struct kwork_wqueue_s *wqueue,
   work->arg    = arg;              /* Callback argument */
   work->delay  = delay;            /* Delay until work performed */
 
-  /* Now, time-tag that entry and put it in the work queue */
+  /* Now, time-tag that entry */
+
+  ctick        = clock_systimer();
+  work->qtime  = ctick;            /* Time work queued */
+
+#if CONFIG_SCHED_WORKSLACK > 1
+  /* Round the expiration time up to the next multiple of the slack so that
+   * delayed work expiring within the same window becomes due together.
+   */
 
-  work->qtime  = clock_systimer(); /* Time work queued */
+  if (delay > 0)
+    {
+      clock_t rem = (ctick + delay) % CONFIG_SCHED_WORKSLACK;
+
+      if (rem != 0)
+        {
+          work->delay += CONFIG_SCHED_WORKSLACK - rem;
+        }
+    }
+#endif
+
+  /* Keep the work queue sorted by expiration time so that the worker only
+   * has to look at the head of the queue.  Work is added after any other
+   * work with the same expiration time so that immediate work is performed
+   * in FIFO order.
+   */
+
+  remaining = work->delay;
+  next      = (FAR struct work_s *)wqueue->q.head;
+
+  while (next != NULL && work_remaining(next, ctick) <= remaining)
+    {
+      next = (FAR struct work_s *)next->dq.flink;
+    }
 
-  dq_addlast((FAR dq_entry_t *)work, &wqueue->q);
+  if (next != NULL)
+    {
+      dq_addbefore((FAR dq_entry_t *)next, (FAR dq_entry_t *)work,
+                   &wqueue->q);
+    }
+  else
+    {
+      dq_addlast((FAR dq_entry_t *)work, &wqueue->q);
+    }
 
   leave_critical_section(flags);
 }
@@ -189,4 +254,36 @@ int work_queue(int qid, FAR struct work_s *work, worker_t worker,
     }
 }
 
+/****************************************************************************
+ * Name: work_queue_wq
+ *
+ * Description:
+ *   Queue work to be performed on a work queue created by
+ *   work_queue_create().  See work_queue() for the full description.
+ *
+ * Input Parameters:
+ *   wqueue - The work queue
+ *   work   - The work structure to queue
+ *   worker - The worker callback to be invoked.  The callback will invoked
+ *            on the worker thread of execution.
+ *   arg    - The argument that will be passed to the worker callback when
+ *            it is invoked.
+ *   delay  - Delay (in clock ticks) from the time queue until the worker
+ *            is invoked. Zero means to perform the work immediately.
+ *
+ * Returned Value:
+ *   Zero on success, a negated errno on failure
+ *
+ ****************************************************************************/
+
+int work_queue_wq(FAR struct kwork_wqueue_s *wqueue,
+                  FAR struct work_s *work, worker_t worker,
+                  FAR void *arg, clock_t delay)
+{
+  DEBUGASSERT(wqueue != NULL);
+
+  work_qqueue(wqueue, work, worker, arg, delay);
+  return work_signal_wq(wqueue);
+}
+
 #endif /* CONFIG_SCHED_WORKQUEUE */
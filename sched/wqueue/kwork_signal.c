@@ -54,56 +54,31 @@
  ****************************************************************************/
 
 /****************************************************************************
- * Name: work_signal
+ * Name: work_signal_wq
  *
  * Description:
- *   Signal the worker thread to process the work queue now.  This function
- *   is used internally by the work logic but could also be used by the
- *   user to force an immediate re-assessment of pending work.
+ *   Signal an idle worker thread of the work queue to process the work
+ *   queue now.
  *
  * Input Parameters:
- *   qid    - The work queue ID
+ *   wqueue - Describes the work queue to be signalled
  *
  * Returned Value:
  *   Zero (OK) on success, a negated errno value on failure
  *
  ****************************************************************************/
 
-int work_signal(int qid)
+int work_signal_wq(FAR struct kwork_wqueue_s *wqueue)
 {
-  FAR struct kwork_wqueue_s *work;
-  int threads;
   int i;
 
-  /* Get the process ID of the worker thread */
-
-#ifdef CONFIG_SCHED_HPWORK
-  if (qid == HPWORK)
-    {
-      work = (FAR struct kwork_wqueue_s *)&g_hpwork;
-      threads = CONFIG_SCHED_HPNTHREADS;
-    }
-  else
-#endif
-#ifdef CONFIG_SCHED_LPWORK
-  if (qid == LPWORK)
-    {
-      work = (FAR struct kwork_wqueue_s *)&g_lpwork;
-      threads = CONFIG_SCHED_LPNTHREADS;
-    }
-  else
-#endif
-    {
-      return -EINVAL;
-    }
-
   /* Find an IDLE worker thread */
 
-  for (i = 0; i < threads; i++)
+  for (i = 0; i < wqueue->nthreads; i++)
     {
       /* Is this worker thread busy? */
 
-      if (!work->worker[i].busy)
+      if (!wqueue->worker[i].busy)
         {
           /* No.. select this thread */
 
@@ -113,14 +88,51 @@ int work_signal(int qid)
 
   /* If all of the IDLE threads are busy, then just return successfully */
 
-  if (i >= threads)
+  if (i >= wqueue->nthreads)
     {
       return OK;
     }
 
   /* Otherwise, signal the first IDLE thread found */
 
-  return nxsig_kill(work->worker[i].pid, SIGWORK);
+  return nxsig_kill(wqueue->worker[i].pid, SIGWORK);
+}
+
+/****************************************************************************
+ * Name: work_signal
+ *
+ * Description:
+ *   Signal the worker thread to process the work queue now.  This function
+ *   is used internally by the work logic but could also be used by the
+ *   user to force an immediate re-assessment of pending work.
+ *
+ * Input Parameters:
+ *   qid    - The work queue ID
+ *
+ * Returned Value:
+ *   Zero (OK) on success, a negated errno value on failure
+ *
+ ****************************************************************************/
+
+int work_signal(int qid)
+{
+#ifdef CONFIG_SCHED_HPWORK
+  if (qid == HPWORK)
+    {
+      return work_signal_wq((FAR struct kwork_wqueue_s *)&g_hpwork);
+    }
+  else
+#endif
+#ifdef CONFIG_SCHED_LPWORK
+  if (qid == LPWORK)
+    {
+      return work_signal_wq((FAR struct kwork_wqueue_s *)&g_lpwork);
+    }
+  else
+#endif
+    {
+      return -EINVAL;
+    }
 }
 
 #endif /* CONFIG_SCHED_WORKQUEUE */
@@ -47,6 +47,7 @@
 #include <queue.h>
 
 #include <nuttx/clock.h>
+#include <nuttx/semaphore.h>
 
 #ifdef CONFIG_SCHED_WORKQUEUE
 
@@ -71,11 +72,17 @@ struct kworker_s
   volatile bool     busy;   /* True: Worker is not available */
 };
 
-/* This structure defines the state of one kernel-mode work queue */
+/* This structure defines the state of one kernel-mode work queue.  Work
+ * queues created by work_queue_create() are allocated with nthreads
+ * entries in worker[].
+ */
 
 struct kwork_wqueue_s
 {
   struct dq_queue_s q;         /* The queue of pending work */
+  uint8_t           nthreads;  /* Number of worker threads */
+  volatile bool     exit;      /* True: Worker threads should exit */
+  FAR sem_t        *exsem;     /* Posted by each exiting worker thread */
   struct kworker_s  worker[1]; /* Describes a worker thread */
 };
 
@@ -87,6 +94,9 @@ struct kwork_wqueue_s
 struct hp_wqueue_s
 {
   struct dq_queue_s q;         /* The queue of pending work */
+  uint8_t           nthreads;  /* Number of worker threads */
+  volatile bool     exit;      /* Not used */
+  FAR sem_t        *exsem;     /* Not used */
 
   /* Describes each thread in the high priority queue's thread pool */
 
@@ -101,7 +111,10 @@ struct hp_wqueue_s
 #ifdef CONFIG_SCHED_LPWORK
 struct lp_wqueue_s
 {
-  struct dq_queue_s q;      /* The queue of pending work */
+  struct dq_queue_s q;         /* The queue of pending work */
+  uint8_t           nthreads;  /* Number of worker threads */
+  volatile bool     exit;      /* Not used */
+  FAR sem_t        *exsem;     /* Not used */
 
   /* Describes each thread in the low priority queue's thread pool */
 
@@ -167,6 +180,23 @@ int work_hpstart(void);
 int work_lpstart(void);
 #endif
 
+/****************************************************************************
+ * Name: work_signal_wq
+ *
+ * Description:
+ *   Signal an idle worker thread of the work queue to process the work
+ *   queue now.
+ *
+ * Input Parameters:
+ *   wqueue - Describes the work queue to be signalled
+ *
+ * Returned Value:
+ *   Zero (OK) on success, a negated errno value on failure
+ *
+ ****************************************************************************/
+
+int work_signal_wq(FAR struct kwork_wqueue_s *wqueue);
+
 /****************************************************************************
  * Name: work_process
  *
@@ -0,0 +1,69 @@
+/****************************************************************************
+ * syscall/syscall_fastlookup.c
+ *
+ *   Copyright (C) 2020 Gregory Nutt. All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in
+ *    the documentation and/or other materials provided with the
+ *    distribution.
+ * 3. Neither the name NuttX nor the names of its contributors may be
+ *    used to endorse or promote products derived from this software
+ *    without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+ * FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE
+ * COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+ * INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,
+ * BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS
+ * OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED
+ * AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ * LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN
+ * ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ *
+ ****************************************************************************/
+
+/****************************************************************************
+ * Included Files
+ ****************************************************************************/
+
+#include <nuttx/config.h>
+#include <syscall.h>
+
+#if defined(CONFIG_LIB_SYSCALL) && defined(CONFIG_SYSCALL_FASTPATH)
+
+#include "syscall_fast.h"
+
+/****************************************************************************
+ * Public Data
+ ****************************************************************************/
+
+/* Fast path lookup table.  This table is indexed by the system call numbers
+ * and is generated from the "fast" qualifier on the return type in
+ * syscall.csv.  A non-zero entry means that the stub never blocks or
+ * switches context so that the SVC handler may call it directly.
+ */
+
+const uint8_t g_stubfast[SYS_nsyscalls] =
+{
+#  undef SYSCALL_LOOKUP1
+#  define SYSCALL_LOOKUP1(f,n,p) p##_FAST
+#  undef SYSCALL_LOOKUP
+#  define SYSCALL_LOOKUP(f,n,p)  , p##_FAST
+#  include "syscall_lookup.h"
+};
+
+/****************************************************************************
+ * Public Functions
+ ****************************************************************************/
+
+#endif /* CONFIG_LIB_SYSCALL && CONFIG_SYSCALL_FASTPATH */
@@ -51,6 +51,9 @@
 #include <sys/ioctl.h>
 #include <sys/time.h>
 #include <sys/select.h>
+#include <sys/ioring.h>
+#include <sys/eventfd.h>
+#include <sys/timerfd.h>
 #include <sys/mman.h>
 #include <sys/stat.h>
 #include <sys/statfs.h>
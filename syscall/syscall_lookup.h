@@ -46,7 +46,6 @@
 SYSCALL_LOOKUP1(_exit,                     1, STUB__exit)
 SYSCALL_LOOKUP(exit,                       1, STUB_exit)
 SYSCALL_LOOKUP(get_errno,                  0, STUB_get_errno)
-SYSCALL_LOOKUP(getpid,                     0, STUB_getpid)
 SYSCALL_LOOKUP(sched_getparam,             2, STUB_sched_getparam)
 SYSCALL_LOOKUP(sched_getscheduler,         1, STUB_sched_getscheduler)
 SYSCALL_LOOKUP(sched_lock,                 0, STUB_sched_lock)
@@ -59,6 +58,12 @@ SYSCALL_LOOKUP(sched_yield,                0, STUB_sched_yield)
 SYSCALL_LOOKUP(set_errno,                  1, STUB_set_errno)
 SYSCALL_LOOKUP(uname,                      1, STUB_uname)
 
+/* getpid() is not a system call if the PID is cached in the TLS data */
+
+#ifndef CONFIG_TLS_GETPID
+SYSCALL_LOOKUP(getpid,                     0, STUB_getpid)
+#endif
+
 /* User identity */
 
 #ifdef CONFIG_SCHED_USER_IDENTITY
@@ -176,8 +181,10 @@ SYSCALL_LOOKUP(up_assert,                  2, STUB_up_assert)
 
   SYSCALL_LOOKUP(syscall_clock,            0, STUB_clock)
   SYSCALL_LOOKUP(clock_getres,             2, STUB_clock_getres)
-  SYSCALL_LOOKUP(clock_gettime,            2, STUB_clock_gettime)
   SYSCALL_LOOKUP(clock_settime,            2, STUB_clock_settime)
+#ifndef CONFIG_CLOCK_TIMEPAGE
+  SYSCALL_LOOKUP(clock_gettime,            2, STUB_clock_gettime)
+#endif
 #ifdef CONFIG_CLOCK_TIMEKEEPING
   SYSCALL_LOOKUP(adjtime,                  2, STUB_adjtime)
 #endif
@@ -222,6 +229,17 @@ SYSCALL_LOOKUP(up_assert,                  2, STUB_up_assert)
   SYSCALL_LOOKUP(select,                   5, STUB_select)
   SYSCALL_LOOKUP(ppoll,                    4, STUB_ppoll)
   SYSCALL_LOOKUP(pselect,                  6, STUB_pselect)
+#ifdef CONFIG_FS_IORING
+  SYSCALL_LOOKUP(io_ring_enter,            2, STUB_io_ring_enter)
+#endif
+#ifdef CONFIG_EVENT_FD
+  SYSCALL_LOOKUP(eventfd,                  2, STUB_eventfd)
+#endif
+#ifdef CONFIG_TIMER_FD
+  SYSCALL_LOOKUP(timerfd_create,           2, STUB_timerfd_create)
+  SYSCALL_LOOKUP(timerfd_settime,          4, STUB_timerfd_settime)
+  SYSCALL_LOOKUP(timerfd_gettime,          2, STUB_timerfd_gettime)
+#endif
 #ifdef CONFIG_NETDEV_IFINDEX
   SYSCALL_LOOKUP(if_indextoname,           2, STUB_if_indextoname)
   SYSCALL_LOOKUP(if_nametoindex,           1, STUB_if_nametoindex)
@@ -257,6 +275,7 @@ SYSCALL_LOOKUP(up_assert,                  2, STUB_up_assert)
 
 #if defined(CONFIG_FS_RAMMAP)
   SYSCALL_LOOKUP(munmap,                   2, STUB_munmap)
+  SYSCALL_LOOKUP(msync,                    3, STUB_msync)
 #endif
 
 #if defined(CONFIG_PSEUDOFS_SOFTLINKS)
@@ -277,8 +296,8 @@ SYSCALL_LOOKUP(up_assert,                  2, STUB_up_assert)
   SYSCALL_LOOKUP(sched_getstreams,         0, STUB_sched_getstreams)
 #endif
 
-#if defined(CONFIG_NET_SENDFILE)
-  SYSCALL_LOOKUP(sendfile,                 4, STUB_fs_sendifile)
+#if defined(CONFIG_FS_SENDFILE)
+  SYSCALL_LOOKUP(sendfile,                 4, STUB_sendfile)
 #endif
 
 #if !defined(CONFIG_DISABLE_MOUNTPOINT)
@@ -303,6 +322,11 @@ SYSCALL_LOOKUP(up_assert,                  2, STUB_up_assert)
   SYSCALL_LOOKUP(shmdt,                    1, STUB_shmdt)
 #endif
 
+#ifdef CONFIG_FS_SHM
+  SYSCALL_LOOKUP(shm_open,                 3, STUB_shm_open)
+  SYSCALL_LOOKUP(shm_unlink,               1, STUB_shm_unlink)
+#endif
+
 /* The following are defined if pthreads are enabled */
 
 #ifndef CONFIG_DISABLE_PTHREAD
@@ -390,6 +414,11 @@ SYSCALL_LOOKUP(up_assert,                  2, STUB_up_assert)
   SYSCALL_LOOKUP(send,                     4, STUB_send)
   SYSCALL_LOOKUP(sendto,                   6, STUB_sendto)
   SYSCALL_LOOKUP(setsockopt,               5, STUB_setsockopt)
+  SYSCALL_LOOKUP(recvmsg,                  3, STUB_recvmsg)
+  SYSCALL_LOOKUP(sendmsg,                  3, STUB_sendmsg)
+  SYSCALL_LOOKUP(recvmmsg,                 5, STUB_recvmmsg)
+  SYSCALL_LOOKUP(sendmmsg,                 4, STUB_sendmmsg)
+  SYSCALL_LOOKUP(socketpair,               4, STUB_socketpair)
   SYSCALL_LOOKUP(socket,                   3, STUB_socket)
 #endif
 
@@ -230,6 +230,21 @@ uintptr_t STUB_aio_write(int nbr, uintptr_t parm1);
 uintptr_t STUB_aio_fsync(int nbr, uintptr_t parm1, uintptr_t parm2);
 uintptr_t STUB_aio_cancel(int nbr, uintptr_t parm1, uintptr_t parm2);
 
+/* Submission/completion rings */
+
+uintptr_t STUB_io_ring_enter(int nbr, uintptr_t parm1, uintptr_t parm2);
+
+/* Event file descriptors */
+
+uintptr_t STUB_eventfd(int nbr, uintptr_t parm1, uintptr_t parm2);
+
+/* Timer file descriptors */
+
+uintptr_t STUB_timerfd_create(int nbr, uintptr_t parm1, uintptr_t parm2);
+uintptr_t STUB_timerfd_settime(int nbr, uintptr_t parm1, uintptr_t parm2,
+            uintptr_t parm3, uintptr_t parm4);
+uintptr_t STUB_timerfd_gettime(int nbr, uintptr_t parm1, uintptr_t parm2);
+
 /* Network interface indices */
 
 uintptr_t STUB_if_indextoname(int nbr, uintptr_t parm1, uintptr_t parm2);
@@ -257,6 +272,8 @@ uintptr_t STUB_mmap(int nbr, uintptr_t parm1, uintptr_t parm2,
             uintptr_t parm3, uintptr_t parm4, uintptr_t parm5,
             uintptr_t parm6);
 uintptr_t STUB_munmap(int nbr, uintptr_t parm1, uintptr_t parm2);
+uintptr_t STUB_msync(int nbr, uintptr_t parm1, uintptr_t parm2,
+            uintptr_t parm3);
 uintptr_t STUB_open(int nbr, uintptr_t parm1, uintptr_t parm2,
             uintptr_t parm3, uintptr_t parm4, uintptr_t parm5,
             uintptr_t parm6);
@@ -282,7 +299,8 @@ uintptr_t STUB_fs_fdopen(int nbr, uintptr_t parm1, uintptr_t parm2,
             uintptr_t parm3);
 uintptr_t STUB_sched_getstreams(int nbr);
 
-ssize_t sendfile(int outfd, int infd, FAR off_t *offset, size_t count);
+uintptr_t STUB_sendfile(int nbr, uintptr_t parm1, uintptr_t parm2,
+            uintptr_t parm3, uintptr_t parm4);
 
 uintptr_t STUB_fsync(int nbr, uintptr_t parm1);
 uintptr_t STUB_ftruncate(int nbr, uintptr_t parm1, uintptr_t parm2);
@@ -303,6 +321,9 @@ uintptr_t STUB_shmat(int nbr, uintptr_t parm1, uintptr_t parm2,
 uintptr_t STUB_shmctl(int nbr, uintptr_t parm1, uintptr_t parm2,
             uintptr_t parm3);
 uintptr_t STUB_shmdt(int nbr, uintptr_t parm1);
+uintptr_t STUB_shm_open(int nbr, uintptr_t parm1, uintptr_t parm2,
+            uintptr_t parm3);
+uintptr_t STUB_shm_unlink(int nbr, uintptr_t parm1);
 
 /* The following are defined if pthreads are enabled */
 
@@ -413,6 +434,16 @@ uintptr_t STUB_sendto(int nbr, uintptr_t parm1, uintptr_t parm2,
             uintptr_t parm6);
 uintptr_t STUB_setsockopt(int nbr, uintptr_t parm1, uintptr_t parm2,
             uintptr_t parm3, uintptr_t parm4, uintptr_t parm5);
+uintptr_t STUB_recvmsg(int nbr, uintptr_t parm1, uintptr_t parm2,
+            uintptr_t parm3);
+uintptr_t STUB_sendmsg(int nbr, uintptr_t parm1, uintptr_t parm2,
+            uintptr_t parm3);
+uintptr_t STUB_recvmmsg(int nbr, uintptr_t parm1, uintptr_t parm2,
+            uintptr_t parm3, uintptr_t parm4, uintptr_t parm5);
+uintptr_t STUB_sendmmsg(int nbr, uintptr_t parm1, uintptr_t parm2,
+            uintptr_t parm3, uintptr_t parm4);
+uintptr_t STUB_socketpair(int nbr, uintptr_t parm1, uintptr_t parm2,
+            uintptr_t parm3, uintptr_t parm4);
 uintptr_t STUB_socket(int nbr, uintptr_t parm1, uintptr_t parm2,
             uintptr_t parm3);
 
@@ -38,6 +38,7 @@
  ****************************************************************************/
 
 #include <stdbool.h>
+#include <stdint.h>
 #include <stdio.h>
 #include <stdlib.h>
 #include <string.h>
@@ -51,6 +52,7 @@
  ****************************************************************************/
 
 #define MAX_HEADER_FILES 500
+#define MAX_SYMBOLS      4096
 #define SYMTAB_NAME      "g_symtab"
 #define NSYMBOLS_NAME    "g_nsymbols"
 
@@ -58,6 +60,12 @@
  * Private Types
  ****************************************************************************/
 
+struct symbol_s
+{
+  char *name;                    /* Symbol name */
+  char *cond;                    /* Conditional compilation, NULL if none */
+};
+
 /****************************************************************************
  * Private Data
  ****************************************************************************/
@@ -65,13 +73,16 @@
 static const char *g_hdrfiles[MAX_HEADER_FILES];
 static int nhdrfiles;
 
+static struct symbol_s g_symbols[MAX_SYMBOLS];
+static int nsyms;
+
 /****************************************************************************
  * Private Functions
  ****************************************************************************/
 
 static void show_usage(const char *progname)
 {
-  fprintf(stderr, "USAGE: %s [-d] <cvs-file> <symtab-file> [<symtab-name> [<nsymbols-name>]]\n\n",
+  fprintf(stderr, "USAGE: %s [-d] [-h] <cvs-file> <symtab-file> [<symtab-name> [<nsymbols-name>]]\n\n",
           progname);
   fprintf(stderr, "Where:\n\n");
   fprintf(stderr, "  <cvs-file>      : The path to the input CSV file (required)\n");
@@ -81,6 +92,8 @@ static void show_usage(const char *progname)
   fprintf(stderr, "  <nsymbols-name> : Optional name for the symbol table variable\n");
   fprintf(stderr, "                    Default: \"%s\"\n", NSYMBOLS_NAME);
   fprintf(stderr, "  -d              : Enable debug output\n");
+  fprintf(stderr, "  -h              : Generate a hash table for\n");
+  fprintf(stderr, "                    symtab_findhashedbyname()\n");
   exit(EXIT_FAILURE);
 }
 
@@ -117,6 +130,106 @@ static void add_hdrfile(const char *hdrfile)
     }
 }
 
+static void add_symbol(const char *name, const char *cond)
+{
+  if (nsyms >= MAX_SYMBOLS)
+    {
+      fprintf(stderr, "ERROR:  Too many symbols.  Increase MAX_SYMBOLS\n");
+      exit(EXIT_FAILURE);
+    }
+
+  g_symbols[nsyms].name = strdup(name);
+  g_symbols[nsyms].cond = (cond && strlen(cond) > 0) ? strdup(cond) : NULL;
+  nsyms++;
+}
+
+/* This must be the same hash as symtab_hashname() in libs/libc/symtab */
+
+static uint32_t hash_name(const char *name)
+{
+  uint32_t hash = 2166136261u;
+
+  while (*name != '\0')
+    {
+      hash ^= (uint8_t)*name++;
+      hash *= 16777619u;
+    }
+
+  return hash;
+}
+
+/* Output the symbols as an open-addressed hash table with a power of two
+ * size and a load factor of at most one half.  Unused slots have a NULL
+ * name.  Symbols that are configured out are replaced with an entry with
+ * an empty name so that the slot of every symbol is the same in all
+ * configurations.
+ */
+
+static void output_hashed(FILE *outstream, const char *symtab,
+                          const char *nsymbols_name)
+{
+  struct symbol_s **slots;
+  uint32_t tabsize;
+  uint32_t slot;
+  int i;
+
+  tabsize = 2;
+  while (tabsize < 2 * (uint32_t)nsyms)
+    {
+      tabsize <<= 1;
+    }
+
+  slots = calloc(tabsize, sizeof(struct symbol_s *));
+  if (!slots)
+    {
+      fprintf(stderr, "ERROR:  Failed to allocate the hash table\n");
+      exit(EXIT_FAILURE);
+    }
+
+  for (i = 0; i < nsyms; i++)
+    {
+      slot = hash_name(g_symbols[i].name) & (tabsize - 1);
+      while (slots[slot] != NULL)
+        {
+          slot = (slot + 1) & (tabsize - 1);
+        }
+
+      slots[slot] = &g_symbols[i];
+    }
+
+  fprintf(outstream, "\nconst struct symtab_s %s[] =\n", symtab);
+  fprintf(outstream, "{\n");
+
+  for (slot = 0; slot < tabsize; slot++)
+    {
+      struct symbol_s *sym = slots[slot];
+
+      if (sym == NULL)
+        {
+          fprintf(outstream, "  { NULL, NULL },\n");
+        }
+      else if (sym->cond != NULL)
+        {
+          fprintf(outstream, "#if %s\n", sym->cond);
+          fprintf(outstream, "  { \"%s\", (FAR const void *)%s },\n",
+                  sym->name, sym->name);
+          fprintf(outstream, "#else\n");
+          fprintf(outstream, "  { \"\", NULL },\n");
+          fprintf(outstream, "#endif\n");
+        }
+      else
+        {
+          fprintf(outstream, "  { \"%s\", (FAR const void *)%s },\n",
+                  sym->name, sym->name);
+        }
+    }
+
+  fprintf(outstream, "};\n\n");
+  fprintf(outstream, "int %s = %lu;\n", nsymbols_name,
+          (unsigned long)tabsize);
+  free(slots);
+}
+
 /****************************************************************************
  * Public Functions
  ****************************************************************************/
@@ -131,6 +244,7 @@ int main(int argc, char **argv, char **envp)
   char *finalterm;
   char *ptr;
   bool cond;
+  bool hashed;
   FILE *instream;
   FILE *outstream;
   int ch;
@@ -141,8 +255,9 @@ int main(int argc, char **argv, char **envp)
   symtab   = SYMTAB_NAME;
   nsymbols = NSYMBOLS_NAME;
   g_debug  = false;
+  hashed   = false;
 
-  while ((ch = getopt(argc, argv, ":d")) > 0)
+  while ((ch = getopt(argc, argv, ":dh")) > 0)
     {
       switch (ch)
         {
@@ -150,6 +265,10 @@ int main(int argc, char **argv, char **envp)
             g_debug = true;
             break;
 
+          case 'h' :
+            hashed = true;
+            break;
+
           case '?' :
             fprintf(stderr, "Unrecognized option: %c\n", optopt);
             show_usage(argv[0]);
@@ -234,6 +353,13 @@ int main(int argc, char **argv, char **envp)
       /* Add the header file to the list of header files we need to include */
 
       add_hdrfile(g_parm[HEADER_INDEX]);
+
+      /* A hash table needs all of the symbols before it can be output */
+
+      if (hashed)
+        {
+          add_symbol(g_parm[NAME_INDEX], g_parm[COND_INDEX]);
+        }
     }
 
   /* Back to the beginning */
@@ -256,6 +382,14 @@ int main(int argc, char **argv, char **envp)
 
   /* Now the symbol table itself */
 
+  if (hashed)
+    {
+      output_hashed(outstream, symtab, nsymbols);
+      fclose(instream);
+      fclose(outstream);
+      return EXIT_SUCCESS;
+    }
+
   fprintf(outstream, "\nconst struct symtab_s %s[] =\n", symtab);
   fprintf(outstream, "{\n");
 
@@ -56,6 +56,8 @@
 
 static bool g_inline;
 static FILE *g_stubstream;
+static FILE *g_faststream;
+static bool g_fast;
 
 /****************************************************************************
  * Private Functions
@@ -564,12 +566,55 @@ static void generate_stub(int nparms)
   stub_close(stream);
 }
 
+static void check_fast(void)
+{
+  char *rettype = g_parm[RETTYPE_INDEX];
+
+  /* A return type of the form "fast <type>" marks a system call whose stub
+   * never blocks or switches context and so may be dispatched directly from
+   * the software interrupt handler.  Strip the qualifier so that the rest of
+   * the generation logic sees only the real return type.
+   */
+
+  g_fast = false;
+  if (strncmp(rettype, "fast ", 5) == 0)
+    {
+      memmove(rettype, &rettype[5], strlen(&rettype[5]) + 1);
+      g_fast = true;
+    }
+}
+
+static FILE *open_fast(void)
+{
+  FILE *stream;
+
+  stream = fopen("syscall_fast.h", "w");
+  if (stream == NULL)
+    {
+      fprintf(stderr, "Failed to open syscall_fast.h: %s\n",
+              strerror(errno));
+      exit(16);
+    }
+
+  fprintf(stream, "/* Autogenerated fast system call header file */\n\n");
+  fprintf(stream, "#ifndef __SYSCALL_FAST_H\n");
+  fprintf(stream, "#define __SYSCALL_FAST_H\n\n");
+  return stream;
+}
+
+static void generate_fast(void)
+{
+  fprintf(g_faststream, "#define STUB_%s_FAST %d\n",
+          g_parm[NAME_INDEX], g_fast ? 1 : 0);
+}
+
 static void show_usage(const char *progname)
 {
-  fprintf(stderr, "USAGE: %s [-p|s|i] <CSV file>\n\n", progname);
+  fprintf(stderr, "USAGE: %s [-p|s|f|i] <CSV file>\n\n", progname);
   fprintf(stderr, "Where:\n\n");
   fprintf(stderr, "\t-p : Generate proxies\n");
   fprintf(stderr, "\t-s : Generate stubs\n");
+  fprintf(stderr, "\t-f : Generate the fast system call header\n");
   fprintf(stderr, "\t-i : Generate proxies as static inline functions\n");
   fprintf(stderr, "\t-d : Enable debug output\n");
   exit(1);
@@ -583,6 +628,7 @@ int main(int argc, char **argv, char **envp)
 {
   char *csvpath;
   bool proxies = false;
+  bool fast = false;
   FILE *stream;
   char *ptr;
   int ch;
@@ -592,7 +638,7 @@ int main(int argc, char **argv, char **envp)
   g_debug = false;
   g_inline = false;
 
-  while ((ch = getopt(argc, argv, ":dps")) > 0)
+  while ((ch = getopt(argc, argv, ":dpsf")) > 0)
     {
       switch (ch)
         {
@@ -602,10 +648,17 @@ int main(int argc, char **argv, char **envp)
 
           case 'p' :
             proxies = true;
+            fast = false;
             break;
 
           case 's' :
             proxies = false;
+            fast = false;
+            break;
+
+          case 'f' :
+            proxies = false;
+            fast = true;
             break;
 
           case 'i' :
@@ -648,6 +701,11 @@ int main(int argc, char **argv, char **envp)
       exit(3);
     }
 
+  if (fast)
+    {
+      g_faststream = open_fast();
+    }
+
   /* Process each line in the CVS file */
 
   while ((ptr = read_line(stream)) != NULL)
@@ -661,7 +719,13 @@ int main(int argc, char **argv, char **envp)
           exit(8);
         }
 
-      if (proxies)
+      check_fast();
+
+      if (fast)
+        {
+          generate_fast();
+        }
+      else if (proxies)
         {
           generate_proxy(nargs - PARM1_INDEX);
         }
@@ -677,6 +741,12 @@ int main(int argc, char **argv, char **envp)
         }
     }
 
+  if (g_faststream != NULL)
+    {
+      fprintf(g_faststream, "\n#endif /* __SYSCALL_FAST_H */\n");
+      fclose(g_faststream);
+    }
+
   /* Close the CSV file */
 
   fclose(stream);
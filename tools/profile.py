@@ -0,0 +1,175 @@
+#!/usr/bin/env python
+############################################################################
+# tools/profile.py
+#
+#   Copyright (C) 2020 Gregory Nutt. All rights reserved.
+#
+# Redistribution and use in source and binary forms, with or without
+# modification, are permitted provided that the following conditions
+# are met:
+#
+# 1. Redistributions of source code must retain the above copyright
+#    notice, this list of conditions and the following disclaimer.
+# 2. Redistributions in binary form must reproduce the above copyright
+#    notice, this list of conditions and the following disclaimer in
+#    the documentation and/or other materials provided with the
+#    distribution.
+# 3. Neither the name NuttX nor the names of its contributors may be
+#    used to endorse or promote products derived from this software
+#    without specific prior written permission.
+#
+# THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+# "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+# LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+# FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE
+# COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+# INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,
+# BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS
+# OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED
+# AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+# LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN
+# ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+# POSSIBILITY OF SUCH DAMAGE.
+#
+############################################################################
+
+"""Map the histogram of the NuttX sampling profiler onto functions.
+
+Capture the contents of /proc/profile on the target, for example:
+
+  nsh> echo start > /proc/profile
+  ... run the workload ...
+  nsh> echo stop > /proc/profile
+  nsh> cat /proc/profile
+
+Save the output on the host and run:
+
+  tools/profile.py --nm arm-none-eabi-nm nuttx profile.txt
+
+Each bucket is attributed to the function that contains its start address,
+so with buckets larger than a small function the attribution is approximate.
+
+With --ramfuncs BYTES, the hottest functions that fit into BYTES of RAM are
+printed instead as input section patterns for the .ramfunc output section
+of a linker script (CONFIG_ARCH_RAMFUNCS).  That requires the code to be
+compiled with -ffunction-sections.
+"""
+
+import argparse
+import bisect
+import subprocess
+import sys
+
+def read_symbols(nm, elf):
+    """Return the sorted addresses, names and sizes of the text symbols."""
+    out = subprocess.check_output([nm, '-n', '-S', '--defined-only', elf])
+    addrs = []
+    names = []
+    sizes = {}
+    for line in out.decode('ascii', 'replace').splitlines():
+        fields = line.split()
+
+        # The size is missing for symbols without one
+
+        if len(fields) == 3:
+            fields.insert(1, '0')
+
+        if len(fields) < 4 or fields[2] not in 'tTwW':
+            continue
+
+        # Clear the Thumb bit of function symbols
+
+        addrs.append(int(fields[0], 16) & ~1)
+        names.append(fields[3])
+        sizes[fields[3]] = int(fields[1], 16)
+
+    return addrs, names, sizes
+
+def read_profile(path):
+    """Return the header values and the histograms of a profile dump."""
+    header = {}
+    hists = {}
+    with open(path) as f:
+        for line in f:
+            fields = line.split()
+            if len(fields) == 2:
+                header[fields[0]] = fields[1]
+            elif len(fields) == 3:
+                hist = hists.setdefault(fields[0], [])
+                hist.append((int(fields[1], 16), int(fields[2])))
+
+    return header, hists
+
+def rank(hist, addrs, names):
+    """Return the functions of one histogram by decreasing sample count."""
+    funcs = {}
+    for addr, count in hist:
+        ndx = bisect.bisect_right(addrs, addr) - 1
+        name = names[ndx] if ndx >= 0 else '0x%08x' % addr
+        funcs[name] = funcs.get(name, 0) + count
+
+    return sorted(funcs.items(), key=lambda item: item[1], reverse=True)
+
+def report(title, hist, addrs, names, total, limit):
+    """Print the functions of one histogram by decreasing sample count."""
+    print('%-40s %10s %7s' % (title, 'SAMPLES', '%'))
+    ranked = rank(hist, addrs, names)
+    for name, count in ranked[:limit]:
+        print('%-40s %10d %6.2f%%' %
+              (name, count, 100.0 * count / total if total else 0.0))
+
+    print('')
+
+def ramfuncs(hist, addrs, names, sizes, total, budget):
+    """Print the hottest functions that fit into budget bytes."""
+    used = 0
+    covered = 0
+    lines = []
+    for name, count in rank(hist, addrs, names):
+        size = sizes.get(name, 0)
+        if size == 0 or used + size > budget:
+            continue
+
+        used += size
+        covered += count
+        lines.append('*(.text.%s)' % name)
+
+    print('/* %d functions in %d bytes, %.2f%% of %d samples */' %
+          (len(lines), used, 100.0 * covered / total if total else 0.0,
+           total))
+    print('\n'.join(lines))
+
+def main():
+    parser = argparse.ArgumentParser(description=__doc__.splitlines()[0])
+    parser.add_argument('elf', help='the nuttx ELF file')
+    parser.add_argument('profile', help='the saved contents of /proc/profile')
+    parser.add_argument('--nm', default='arm-none-eabi-nm',
+                        help='the nm program of the toolchain')
+    parser.add_argument('--limit', type=int, default=40,
+                        help='the number of functions to show')
+    parser.add_argument('--ramfuncs', type=int, metavar='BYTES',
+                        help='print the hottest functions that fit into '
+                        'BYTES as linker script input sections')
+    args = parser.parse_args()
+
+    addrs, names, sizes = read_symbols(args.nm, args.elf)
+    header, hists = read_profile(args.profile)
+
+    total = int(header.get('samples', '0'))
+    if args.ramfuncs is not None:
+        ramfuncs(hists.get('pc', []), addrs, names, sizes, total,
+                 args.ramfuncs)
+        return 0
+
+    print('%d samples, %s outside of the text section, %d bytes per bucket\n' %
+          (total, header.get('outside', '0'),
+           1 << int(header.get('shift', '0'))))
+
+    report('FUNCTION', hists.get('pc', []), addrs, names, total, args.limit)
+    if 'caller' in hists:
+        report('CALLER', hists['caller'], addrs, names, total, args.limit)
+
+    return 0
+
+if __name__ == '__main__':
+    sys.exit(main())
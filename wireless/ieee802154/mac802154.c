@@ -1080,31 +1080,42 @@ static void mac802154_rxframe_worker(FAR void *arg)
     (FAR struct ieee802154_privmac_s *)arg;
   FAR struct ieee802154_data_ind_s *ind;
   FAR struct iob_s *iob;
+  sq_queue_t rxqueue;
   uint16_t *frame_ctrl;
   bool panid_comp;
   uint8_t ftype;
 
+  sq_init(&rxqueue);
+
   while (1)
     {
-      /* Get exclusive access to the driver structure.  We don't care about
-       * any signals so if we see one, just go back to trying to get access
-       * again.
-       */
+      if (sq_empty(&rxqueue))
+        {
+          /* Get exclusive access to the driver structure.  We don't care
+           * about any signals so if we see one, just go back to trying to
+           * get access again.
+           */
 
-      mac802154_lock(priv, false);
+          mac802154_lock(priv, false);
 
-      /* Pop the data indication from the head of the frame list for
-       * processing.   Note: dataind_queue contains ieee802154_primitive_s
-       * which is safe to cast directly to a data indication.
-       */
+          /* Take all of the frames received so far at once so that the
+           * MAC is locked once per batch rather than once per frame.
+           */
 
-      ind = (FAR struct ieee802154_data_ind_s *)
-              sq_remfirst(&priv->dataind_queue);
+          rxqueue = priv->dataind_queue;
+          sq_init(&priv->dataind_queue);
 
-      /* Once we pop off the indication, we don't need to keep the mac locked */
+          /* Once we take the frames, we don't need to keep the mac locked */
 
-      mac802154_unlock(priv)
+          mac802154_unlock(priv)
+        }
+
+      /* Pop the data indication from the head of the batch for processing.
+       * Note: dataind_queue contains ieee802154_primitive_s which is safe to
+       * cast directly to a data indication.
+       */
 
+      ind = (FAR struct ieee802154_data_ind_s *)sq_remfirst(&rxqueue);
       if (ind == NULL)
         {
           return;